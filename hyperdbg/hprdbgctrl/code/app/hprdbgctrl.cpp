@@ -16,20 +16,23 @@ using namespace std;
 //
 // Global Variables
 //
-extern HANDLE     g_DeviceHandle;
-extern HANDLE     g_IsDriverLoadedSuccessfully;
-extern BOOLEAN    g_IsVmxOffProcessStart;
-extern Callback   g_MessageHandler;
-extern TCHAR      g_DriverLocation[MAX_PATH];
-extern LIST_ENTRY g_EventTrace;
-extern BOOLEAN    g_LogOpened;
-extern BOOLEAN    g_BreakPrintingOutput;
-extern BOOLEAN    g_IsConnectedToRemoteDebugger;
-extern BOOLEAN    g_OutputSourcesInitialized;
-extern BOOLEAN    g_IsSerialConnectedToRemoteDebugger;
-extern BOOLEAN    g_IsDebuggerModulesLoaded;
-extern BOOLEAN    g_IsReversingMachineModulesLoaded;
-extern LIST_ENTRY g_OutputSources;
+extern HANDLE          g_DeviceHandle;
+extern HANDLE          g_IsDriverLoadedSuccessfully;
+extern BOOLEAN         g_IsVmxOffProcessStart;
+extern HANDLE          g_IrpBasedBufferThread;
+extern Callback        g_MessageHandler;
+extern EventCallback   g_EventCallback;
+extern TCHAR           g_DriverLocation[MAX_PATH];
+extern LIST_ENTRY      g_EventTrace;
+extern BOOLEAN         g_LogOpened;
+extern BOOLEAN         g_BreakPrintingOutput;
+extern BOOLEAN         g_IsConnectedToRemoteDebugger;
+extern BOOLEAN         g_OutputSourcesInitialized;
+extern BOOLEAN         g_IsSerialConnectedToRemoteDebugger;
+extern BOOLEAN         g_IsDebuggerModulesLoaded;
+extern BOOLEAN         g_IsReversingMachineModulesLoaded;
+extern LIST_ENTRY      g_OutputSources;
+extern volatile LONG64 g_KernelStressReceivedMessages;
 
 /**
  * @brief Set the function callback that will be called if any message
@@ -43,6 +46,18 @@ HyperDbgSetTextMessageCallback(Callback handler)
     g_MessageHandler = handler;
 }
 
+/**
+ * @brief Set the function callback that will be called with the pausing
+ * packet once the debuggee is paused (e.g., an event is triggered)
+ *
+ * @param handler Function that handles the pausing packets
+ */
+VOID
+HyperDbgSetEventCallback(EventCallback handler)
+{
+    g_EventCallback = handler;
+}
+
 /**
  * @brief Show messages
  *
@@ -53,25 +68,52 @@ ShowMessages(const char * Fmt, ...)
 {
     va_list ArgList;
     va_list Args;
-    char    TempMessage[COMMUNICATION_BUFFER_SIZE + TCP_END_OF_BUFFER_CHARS_COUNT] = {0};
+    BOOLEAN IsConsoleOutput = FALSE;
+    char    TempMessage[COMMUNICATION_BUFFER_SIZE + TCP_END_OF_BUFFER_CHARS_COUNT];
+
+    //
+    // Bulk messages of events are held while interactive messages are shown
+    //
+    MessageLanesNotifyInteractiveMessage();
 
     if (g_MessageHandler == NULL && !g_IsConnectedToRemoteDebugger && !g_IsSerialConnectedToRemoteDebugger)
     {
-        va_start(Args, Fmt);
-        vprintf(Fmt, Args);
-        va_end(Args);
         if (!g_LogOpened)
         {
+            va_start(Args, Fmt);
+            vprintf(Fmt, Args);
+            va_end(Args);
+
             return;
         }
+
+        //
+        // The message is formatted once for both of the console and the log file
+        //
+        IsConsoleOutput = TRUE;
     }
 
     va_start(ArgList, Fmt);
     int sprintfresult = vsprintf_s(TempMessage, Fmt, ArgList);
     va_end(ArgList);
 
+    if (sprintfresult == -1 && IsConsoleOutput)
+    {
+        //
+        // Not formatted, at least show it in the console
+        //
+        va_start(Args, Fmt);
+        vprintf(Fmt, Args);
+        va_end(Args);
+    }
+
     if (sprintfresult != -1)
     {
+        if (IsConsoleOutput)
+        {
+            fwrite(TempMessage, 1, sprintfresult, stdout);
+        }
+
         if (g_IsConnectedToRemoteDebugger)
         {
             //
@@ -89,9 +131,10 @@ ShowMessages(const char * Fmt, ...)
         if (g_LogOpened)
         {
             //
-            // .logopen command executed
+            // .logopen command executed (the message is written to the
+            // file by the writer thread of the log file)
             //
-            LogopenSaveToFile(TempMessage);
+            LogopenSaveBufferToFile(TempMessage, sprintfresult);
         }
         if (g_MessageHandler != NULL)
         {
@@ -103,6 +146,388 @@ ShowMessages(const char * Fmt, ...)
     }
 }
 
+/**
+ * @brief Send a message of an event to the output sources of the event
+ *
+ * @param Message The message (null-terminated)
+ * @param MessageLength Length of the message
+ * @param TraceRecord The binary trace record of the message (or NULL)
+ * @param Timestamps The time-stamp counters of the message (or NULL)
+ *
+ * @return BOOLEAN whether an output source is found for the message
+ */
+static BOOLEAN
+ReadIrpBasedBufferForwardMessage(char *                       Message,
+                                 UINT32                       MessageLength,
+                                 PBINARY_TRACE_RECORD         TraceRecord,
+                                 PEVENT_FORWARDING_TIMESTAMPS Timestamps)
+{
+    PLIST_ENTRY TempList;
+
+    //
+    // Check if there are available output sources
+    //
+    if (!g_OutputSourcesInitialized)
+    {
+        return FALSE;
+    }
+
+    //
+    // Now, we should check whether the following flag matches
+    // with an output or not, also this is not where we want to
+    // check output resources
+    //
+    TempList = &g_EventTrace;
+    while (&g_EventTrace != TempList->Blink)
+    {
+        TempList = TempList->Blink;
+
+        PDEBUGGER_GENERAL_EVENT_DETAIL EventDetail = CONTAINING_RECORD(
+            TempList,
+            DEBUGGER_GENERAL_EVENT_DETAIL,
+            CommandsEventList);
+
+        if (EventDetail->HasCustomOutput)
+        {
+            //
+            // Send the event to output sources
+            //
+            if (!ForwardingPerformEventForwarding(EventDetail,
+                                                  Message,
+                                                  MessageLength,
+                                                  TraceRecord,
+                                                  Timestamps))
+            {
+                ShowMessages("err, there was an error transferring the "
+                             "message to the remote sources\n");
+            }
+
+            //
+            // Output source found
+            //
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Handle a message that is received from the kernel buffers
+ *
+ * @param OperationCode The operation code of the message
+ * @param Message The message (null-terminated)
+ * @param ReturnedLength Length of the operation code + message
+ * @param Timestamps The time-stamp counters of the message (or NULL)
+ */
+VOID
+ReadIrpBasedBufferHandleMessage(UINT32 OperationCode, char * Message, ULONG ReturnedLength, PEVENT_FORWARDING_TIMESTAMPS Timestamps)
+{
+    PBINARY_TRACE_RECORD BinaryTraceRecord;
+    const char *         BinaryTraceFormat;
+    CHAR                 BinaryTraceFormattedMessage[PacketChunkSize];
+    string               StackTraceFormattedMessage;
+
+    /*
+    ShowMessages("Returned Length : 0x%x \n", ReturnedLength);
+    ShowMessages("Operation Code : 0x%x \n", OperationCode);
+    */
+
+    switch (OperationCode)
+    {
+    case OPERATION_LOG_NON_IMMEDIATE_MESSAGE:
+
+        if (EventReplayIsRecording())
+        {
+            EventReplayRecordMessage(OperationCode, Message, ReturnedLength - sizeof(UINT32) + 1, NULL, Timestamps);
+        }
+
+        if (g_BreakPrintingOutput)
+        {
+            //
+            // means that the user asserts a CTRL+C or CTRL+BREAK Signal
+            // we shouldn't show or save anything in this case
+            //
+            return;
+        }
+
+        MessageLanesShowBulkMessage(Message);
+
+        break;
+    case OPERATION_LOG_INFO_MESSAGE:
+
+        if (g_BreakPrintingOutput)
+        {
+            //
+            // means that the user asserts a CTRL+C or CTRL+BREAK Signal
+            // we shouldn't show or save anything in this case
+            //
+            return;
+        }
+
+        ShowMessages("%s", Message);
+
+        break;
+    case OPERATION_LOG_ERROR_MESSAGE:
+        if (g_BreakPrintingOutput)
+        {
+            //
+            // means that the user asserts a CTRL+C or CTRL+BREAK Signal
+            // we shouldn't show or save anything in this case
+            //
+            return;
+        }
+
+        ShowMessages("%s", Message);
+
+        break;
+    case OPERATION_LOG_WARNING_MESSAGE:
+
+        if (g_BreakPrintingOutput)
+        {
+            //
+            // means that the user asserts a CTRL+C or CTRL+BREAK Signal
+            // we shouldn't show or save anything in this case
+            //
+            return;
+        }
+
+        ShowMessages("%s", Message);
+
+        break;
+
+    case OPERATION_COMMAND_FROM_DEBUGGER_CLOSE_AND_UNLOAD_VMM:
+
+        KdCloseConnection();
+
+        break;
+
+    case OPERATION_DEBUGGEE_USER_INPUT:
+
+        KdHandleUserInputInDebuggee((DEBUGGEE_USER_INPUT_PACKET *)(Message));
+
+        break;
+
+    case OPERATION_DEBUGGEE_REGISTER_EVENT:
+
+        KdRegisterEventInDebuggee(
+            (PDEBUGGER_GENERAL_EVENT_DETAIL)(Message),
+            ReturnedLength);
+
+        break;
+
+    case OPERATION_DEBUGGEE_ADD_ACTION_TO_EVENT:
+
+        KdAddActionToEventInDebuggee(
+            (PDEBUGGER_GENERAL_ACTION)(Message),
+            ReturnedLength);
+
+        break;
+
+    case OPERATION_DEBUGGEE_REGISTER_EVENTS_BATCH:
+
+        KdRegisterEventsBatchInDebuggee(
+            (PDEBUGGER_EVENTS_BATCH_REQUEST)(Message),
+            ReturnedLength);
+
+        break;
+
+    case OPERATION_DEBUGGEE_CLEAR_EVENTS:
+
+        KdSendModifyEventInDebuggee(
+            (PDEBUGGER_MODIFY_EVENTS)(Message));
+
+        break;
+
+    case OPERATION_HYPERVISOR_DRIVER_IS_SUCCESSFULLY_LOADED:
+
+        //
+        // Indicate that driver (Hypervisor) is loaded successfully
+        //
+        SetEvent(g_IsDriverLoadedSuccessfully);
+
+        break;
+
+    case OPERATION_HYPERVISOR_DRIVER_END_OF_IRPS:
+
+        //
+        // End of receiving messages (IRPs), nothing to do
+        //
+        break;
+
+    case OPERATION_COMMAND_FROM_DEBUGGER_RELOAD_SYMBOL:
+
+        //
+        // Pause debugger after getting the results
+        //
+        KdReloadSymbolsInDebuggee(TRUE,
+                                  ((PDEBUGGEE_SYMBOL_REQUEST_PACKET)(Message))->ProcessId);
+
+        break;
+
+    case OPERATION_NOTIFICATION_FROM_KERNEL_MODULE_LOAD:
+
+        //
+        // Send the symbol details of the new module to the debugger
+        //
+        SymbolSendLoadedKernelModuleToDebugger(
+            (PDEBUGGEE_KERNEL_MODULE_LOADED_PACKET)(Message));
+
+        break;
+
+    case OPERATION_NOTIFICATION_FROM_USER_DEBUGGER_PAUSE:
+
+        //
+        // handle pausing packet from user debugger
+        //
+        UdHandleUserDebuggerPausing(
+            (PDEBUGGEE_UD_PAUSED_PACKET)(Message));
+
+        break;
+
+    case OPERATION_LOG_BINARY_TRACE_RECORD:
+
+        //
+        // Format the binary trace record of printf (the format string is
+        // registered by the script engine once the script is compiled)
+        //
+        BinaryTraceRecord = (PBINARY_TRACE_RECORD)Message;
+
+        if (ReturnedLength - sizeof(UINT32) < sizeof(BINARY_TRACE_RECORD))
+        {
+            ShowMessages("err, invalid binary trace record\n");
+            break;
+        }
+
+        if (EventReplayIsRecording())
+        {
+            EventReplayRecordMessage(BinaryTraceRecord->Tag,
+                                     Message,
+                                     ReturnedLength - sizeof(UINT32),
+                                     BinaryTraceRecord,
+                                     Timestamps);
+        }
+
+        BinaryTraceFormat = ScriptEngineGetBinaryTraceFormat(BinaryTraceRecord->FormatId);
+
+        if (BinaryTraceFormat == NULL ||
+            !ScriptEngineFormatBinaryTraceRecord(BinaryTraceRecord,
+                                                 ReturnedLength - sizeof(UINT32),
+                                                 BinaryTraceFormat,
+                                                 BinaryTraceFormattedMessage,
+                                                 sizeof(BinaryTraceFormattedMessage)))
+        {
+            ShowMessages("err, unable to format the binary trace record (format id: %x)\n",
+                         BinaryTraceRecord->FormatId);
+            break;
+        }
+
+        if (g_BreakPrintingOutput)
+        {
+            //
+            // means that the user asserts a CTRL+C or CTRL+BREAK Signal
+            // we shouldn't show or save anything in this case
+            //
+            return;
+        }
+
+        //
+        // Handle it as a regular message of the event, binary output
+        // sources receive the values of the record instead of the message
+        //
+        if (!ReadIrpBasedBufferForwardMessage(BinaryTraceFormattedMessage,
+                                              (UINT32)(strlen(BinaryTraceFormattedMessage) + 1),
+                                              BinaryTraceRecord,
+                                              Timestamps))
+        {
+            MessageLanesShowBulkMessage(BinaryTraceFormattedMessage);
+        }
+
+        break;
+
+    case OPERATION_LOG_STRESS_TEST_MESSAGE:
+
+        //
+        // Messages of the stress test are only counted (not shown)
+        //
+        InterlockedIncrement64(&g_KernelStressReceivedMessages);
+
+        break;
+
+    case OPERATION_LOG_SCRIPT_STACK_TRACE_RECORD:
+
+        //
+        // Resolve the return addresses of the stack trace record (made
+        // by the stack function of the script engine) to symbols
+        //
+        if (!CallstackFormatScriptStackTraceRecord((PSCRIPT_STACK_TRACE_RECORD)Message,
+                                                   ReturnedLength - sizeof(UINT32),
+                                                   StackTraceFormattedMessage))
+        {
+            ShowMessages("err, invalid stack trace record\n");
+            break;
+        }
+
+        if (EventReplayIsRecording())
+        {
+            EventReplayRecordMessage(((PSCRIPT_STACK_TRACE_RECORD)Message)->Tag,
+                                     (CHAR *)StackTraceFormattedMessage.c_str(),
+                                     (UINT32)(StackTraceFormattedMessage.size() + 1),
+                                     NULL,
+                                     Timestamps);
+        }
+
+        if (g_BreakPrintingOutput)
+        {
+            //
+            // means that the user asserts a CTRL+C or CTRL+BREAK Signal
+            // we shouldn't show or save anything in this case
+            //
+            return;
+        }
+
+        if (!ReadIrpBasedBufferForwardMessage((CHAR *)StackTraceFormattedMessage.c_str(),
+                                              (UINT32)(StackTraceFormattedMessage.size() + 1),
+                                              NULL,
+                                              Timestamps))
+        {
+            MessageLanesShowBulkMessage(StackTraceFormattedMessage.c_str());
+        }
+
+        break;
+
+    default:
+
+        //
+        // Messages of events are recorded even if they're not shown
+        // (the operation code is the tag of the event)
+        //
+        if (EventReplayIsRecording())
+        {
+            EventReplayRecordMessage(OperationCode, Message, ReturnedLength - sizeof(UINT32) + 1, NULL, Timestamps);
+        }
+
+        if (g_BreakPrintingOutput)
+        {
+            //
+            // means that the user asserts a CTRL+C or CTRL+BREAK Signal
+            // we shouldn't show or save anything in this case
+            //
+            return;
+        }
+
+        //
+        // Show the message if the source not found
+        //
+        if (!ReadIrpBasedBufferForwardMessage(Message, ReturnedLength - sizeof(UINT32) + 1, NULL, Timestamps))
+        {
+            MessageLanesShowBulkMessage(Message);
+        }
+
+        break;
+    }
+}
+
 /**
  * @brief Read kernel buffers using IRP Pending
  *
@@ -111,17 +536,17 @@ ShowMessages(const char * Fmt, ...)
 void
 ReadIrpBasedBuffer()
 {
-    BOOL                   Status;
-    ULONG                  ReturnedLength;
-    REGISTER_NOTIFY_BUFFER RegisterEvent;
-    UINT32                 OperationCode;
-    DWORD                  ErrorNum;
-    HANDLE                 Handle;
-    BOOLEAN                OutputSourceFound;
-    PLIST_ENTRY            TempList;
+    BOOL                             Status;
+    ULONG                            ReturnedLength;
+    REGISTER_NOTIFY_BUFFER           RegisterEvent;
+    DWORD                            ErrorNum;
+    HANDLE                           Handle;
+    PUSERMODE_BATCHED_MESSAGE_HEADER MessageHeader;
+    EVENT_FORWARDING_TIMESTAMPS      Timestamps;
+    BOOLEAN                          MoreMessagesMightBeAvailable = FALSE;
 
     RegisterEvent.hEvent = NULL;
-    RegisterEvent.Type   = IRP_BASED;
+    RegisterEvent.Type   = IRP_BASED_BATCHED;
 
     //
     // Create another handle to be used in for reading kernel messages,
@@ -168,7 +593,7 @@ ReadIrpBasedBuffer()
     //
     // allocate buffer for transfering messages
     //
-    char * OutputBuffer = (char *)malloc(UsermodeBufferSize);
+    char * OutputBuffer = (char *)malloc(UsermodeBatchedBufferSize);
 
     try
     {
@@ -179,9 +604,12 @@ ReadIrpBasedBuffer()
                 //
                 // Clear the buffer
                 //
-                ZeroMemory(OutputBuffer, UsermodeBufferSize);
+                ZeroMemory(OutputBuffer, UsermodeBatchedBufferSize);
 
-                Sleep(DefaultSpeedOfReadingKernelMessages); // we're not trying to eat all of the CPU ;)
+                if (!MoreMessagesMightBeAvailable)
+                {
+                    Sleep(DefaultSpeedOfReadingKernelMessages); // we're not trying to eat all of the CPU ;)
+                }
 
                 Status = DeviceIoControl(
                     Handle,                    // Handle to device
@@ -190,11 +618,13 @@ ReadIrpBasedBuffer()
                     SIZEOF_REGISTER_EVENT * 2, // Length of input buffer in bytes. (x 2 is bcuz as the
                                                // driver is x64 and has 64 bit values)
                     OutputBuffer,              // Output Buffer from driver.
-                    UsermodeBufferSize,        // Length of output buffer in bytes.
+                    UsermodeBatchedBufferSize, // Length of output buffer in bytes.
                     &ReturnedLength,           // Bytes placed in buffer.
                     NULL                       // synchronous call
                 );
 
+                MoreMessagesMightBeAvailable = FALSE;
+
                 if (!Status)
                 {
                     //
@@ -210,249 +640,278 @@ ReadIrpBasedBuffer()
                 }
 
                 //
-                // Compute the received buffer's operation code
+                // Messages are received in batches, each message has the same layout
+                // as the buffer of non-batched reads (operation code + message)
                 //
-                OperationCode = 0;
-                memcpy(&OperationCode, OutputBuffer, sizeof(UINT32));
+                Timestamps.ReceivedTimestamp = __rdtsc();
 
-                /*
-        ShowMessages("Returned Length : 0x%x \n", ReturnedLength);
-        ShowMessages("Operation Code : 0x%x \n", OperationCode);
-                */
-
-                switch (OperationCode)
+                for (ULONG Offset = 0; Offset + sizeof(USERMODE_BATCHED_MESSAGE_HEADER) <= ReturnedLength;)
                 {
-                case OPERATION_LOG_NON_IMMEDIATE_MESSAGE:
-
-                    if (g_BreakPrintingOutput)
-                    {
-                        //
-                        // means that the user asserts a CTRL+C or CTRL+BREAK Signal
-                        // we shouldn't show or save anything in this case
-                        //
-                        continue;
-                    }
-
-                    ShowMessages("%s", OutputBuffer + sizeof(UINT32));
-
-                    break;
-                case OPERATION_LOG_INFO_MESSAGE:
-
-                    if (g_BreakPrintingOutput)
-                    {
-                        //
-                        // means that the user asserts a CTRL+C or CTRL+BREAK Signal
-                        // we shouldn't show or save anything in this case
-                        //
-                        continue;
-                    }
-
-                    ShowMessages("%s", OutputBuffer + sizeof(UINT32));
-
-                    break;
-                case OPERATION_LOG_ERROR_MESSAGE:
-                    if (g_BreakPrintingOutput)
-                    {
-                        //
-                        // means that the user asserts a CTRL+C or CTRL+BREAK Signal
-                        // we shouldn't show or save anything in this case
-                        //
-                        continue;
-                    }
+                    MessageHeader = (PUSERMODE_BATCHED_MESSAGE_HEADER)(OutputBuffer + Offset);
 
-                    ShowMessages("%s", OutputBuffer + sizeof(UINT32));
+                    Timestamps.TriggerTimestamp = MessageHeader->TriggerTimestamp;
+                    Timestamps.SavedTimestamp   = MessageHeader->Timestamp;
+                    Timestamps.ReadTimestamp    = MessageHeader->ReadTimestamp;
 
-                    break;
-                case OPERATION_LOG_WARNING_MESSAGE:
-
-                    if (g_BreakPrintingOutput)
-                    {
-                        //
-                        // means that the user asserts a CTRL+C or CTRL+BREAK Signal
-                        // we shouldn't show or save anything in this case
-                        //
-                        continue;
-                    }
-
-                    ShowMessages("%s", OutputBuffer + sizeof(UINT32));
-
-                    break;
-
-                case OPERATION_COMMAND_FROM_DEBUGGER_CLOSE_AND_UNLOAD_VMM:
-
-                    KdCloseConnection();
-
-                    break;
-
-                case OPERATION_DEBUGGEE_USER_INPUT:
-
-                    KdHandleUserInputInDebuggee((DEBUGGEE_USER_INPUT_PACKET *)(OutputBuffer + sizeof(UINT32)));
-
-                    break;
+                    ReadIrpBasedBufferHandleMessage(MessageHeader->OperationCode,
+                                                    (char *)MessageHeader + sizeof(USERMODE_BATCHED_MESSAGE_HEADER),
+                                                    MessageHeader->BufferLength + sizeof(UINT32),
+                                                    &Timestamps);
 
-                case OPERATION_DEBUGGEE_REGISTER_EVENT:
+                    Offset += USERMODE_BATCHED_MESSAGE_SIZE(MessageHeader->BufferLength);
+                }
 
-                    KdRegisterEventInDebuggee(
-                        (PDEBUGGER_GENERAL_EVENT_DETAIL)(OutputBuffer + sizeof(UINT32)),
-                        ReturnedLength);
+                //
+                // If the buffer is (almost) filled, there might be more messages, so
+                // we read again without waiting
+                //
+                MoreMessagesMightBeAvailable =
+                    ReturnedLength + USERMODE_BATCHED_MESSAGE_SIZE(PacketChunkSize) > UsermodeBatchedBufferSize;
+            }
+            else
+            {
+                //
+                // the thread should not work anymore
+                //
+                free(OutputBuffer);
 
-                    break;
+                //
+                // closeHandle
+                //
+                if (!CloseHandle(Handle))
+                {
+                    ShowMessages("err, closing handle 0x%x\n", GetLastError());
+                }
 
-                case OPERATION_DEBUGGEE_ADD_ACTION_TO_EVENT:
+                return;
+            }
+        }
+    }
+    catch (const std::exception &)
+    {
+        ShowMessages("err, exception occured in creating handle or parsing buffer\n");
+    }
 
-                    KdAddActionToEventInDebuggee(
-                        (PDEBUGGER_GENERAL_ACTION)(OutputBuffer + sizeof(UINT32)),
-                        ReturnedLength);
+    free(OutputBuffer);
 
-                    break;
+    //
+    // closeHandle
+    //
+    if (!CloseHandle(Handle))
+    {
+        ShowMessages("err, closing handle 0x%x\n", GetLastError());
+    };
+}
 
-                case OPERATION_DEBUGGEE_CLEAR_EVENTS:
+/**
+ * @brief Read kernel buffers that are mapped into the current process
+ * @details the messages are parsed in place (without copying them) and
+ * the read chunks are released to the kernel after each batch, the event
+ * is only signaled once new messages are available after reading all of
+ * the published messages, so the rings are read until the published
+ * sequence is not changed
+ *
+ * @return BOOLEAN FALSE if the buffers couldn't be mapped
+ */
+BOOLEAN
+ReadSharedMemoryBuffer()
+{
+    BOOL                        Status;
+    ULONG                       ReturnedLength;
+    PREGISTER_NOTIFY_BUFFER     RegisterEvent;
+    HANDLE                      Handle;
+    HANDLE                      Event;
+    PLOG_SHARED_BUFFERS         SharedBuffers;
+    PLOG_SHARED_BUFFERS_RELEASE Release;
+    PLOG_RING_INDEXES           Indexes;
+    PLOG_SHARED_NOTIFICATION    Notification;
+    LONG64                      Sequence;
+    PBUFFER_HEADER              Header;
+    PBUFFER_HEADER              OldestHeader;
+    INT32                       OldestRing;
+    BOOLEAN                     AnyMessageRead;
+    EVENT_FORWARDING_TIMESTAMPS Timestamps = {0};
+    BOOLEAN                     Result     = FALSE;
 
-                    KdSendModifyEventInDebuggee(
-                        (PDEBUGGER_MODIFY_EVENTS)(OutputBuffer + sizeof(UINT32)));
+    //
+    // Create another handle to be used in for reading kernel messages,
+    // closing this handle unmaps the buffers
+    //
+    Handle = CreateFileA(
+        "\\\\.\\HyperDbgDebuggerDevice",
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL, /// lpSecurityAttirbutes
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL); /// lpTemplateFile
 
-                    break;
+    if (Handle == INVALID_HANDLE_VALUE)
+    {
+        return FALSE;
+    }
 
-                case OPERATION_HYPERVISOR_DRIVER_IS_SUCCESSFULLY_LOADED:
+    Event         = CreateEvent(NULL, FALSE, FALSE, NULL);
+    SharedBuffers = (PLOG_SHARED_BUFFERS)malloc(SIZEOF_LOG_SHARED_BUFFERS);
+    Release       = (PLOG_SHARED_BUFFERS_RELEASE)malloc(SIZEOF_LOG_SHARED_BUFFERS_RELEASE);
 
-                    //
-                    // Indicate that driver (Hypervisor) is loaded successfully
-                    //
-                    SetEvent(g_IsDriverLoadedSuccessfully);
+    if (Event == NULL || SharedBuffers == NULL || Release == NULL)
+    {
+        goto Cleanup;
+    }
 
-                    break;
+    //
+    // The same buffer is used for registering the event and receiving
+    // the address of the buffers
+    //
+    ZeroMemory(SharedBuffers, SIZEOF_LOG_SHARED_BUFFERS);
 
-                case OPERATION_HYPERVISOR_DRIVER_END_OF_IRPS:
+    RegisterEvent         = (PREGISTER_NOTIFY_BUFFER)SharedBuffers;
+    RegisterEvent->hEvent = Event;
+    RegisterEvent->Type   = SHARED_MEMORY_BASED;
 
-                    //
-                    // End of receiving messages (IRPs), nothing to do
-                    //
-                    break;
+    Status = DeviceIoControl(
+        Handle,                    // Handle to device
+        IOCTL_REGISTER_EVENT,      // IO Control code
+        SharedBuffers,             // Input Buffer to driver.
+        SIZEOF_REGISTER_EVENT * 2, // Length of input buffer in bytes.
+        SharedBuffers,             // Output Buffer from driver.
+        SIZEOF_LOG_SHARED_BUFFERS, // Length of output buffer in bytes.
+        &ReturnedLength,           // Bytes placed in buffer.
+        NULL                       // synchronous call
+    );
 
-                case OPERATION_COMMAND_FROM_DEBUGGER_RELOAD_SYMBOL:
+    if (!Status || ReturnedLength != SIZEOF_LOG_SHARED_BUFFERS)
+    {
+        goto Cleanup;
+    }
 
-                    //
-                    // Pause debugger after getting the results
-                    //
-                    KdReloadSymbolsInDebuggee(TRUE,
-                                              ((PDEBUGGEE_SYMBOL_REQUEST_PACKET)(OutputBuffer + sizeof(UINT32)))->ProcessId);
+    Indexes               = (PLOG_RING_INDEXES)SharedBuffers->IndexesAddress;
+    Notification          = (PLOG_SHARED_NOTIFICATION)SharedBuffers->NotificationAddress;
+    Release->CountOfRings = SharedBuffers->CountOfRings;
 
-                    break;
+    while (!g_IsVmxOffProcessStart)
+    {
+        //
+        // Wait for new messages, the timeout is used for checking whether
+        // the thread should still work or not
+        //
+        WaitForSingleObject(Event, DefaultSpeedOfReadingKernelMessages);
 
-                case OPERATION_NOTIFICATION_FROM_USER_DEBUGGER_PAUSE:
+        do
+        {
+            //
+            // All of the messages up to this sequence are already published
+            //
+            Sequence = Notification->PublishedSequence;
 
-                    //
-                    // handle pausing packet from user debugger
-                    //
-                    UdHandleUserDebuggerPausing(
-                        (PDEBUGGEE_UD_PAUSED_PACKET)(OutputBuffer + sizeof(UINT32)));
+            //
+            // The send indexes might be changed by the kernel (e.g., flush command)
+            //
+            for (UINT32 i = 0; i < SharedBuffers->CountOfRings; i++)
+            {
+                Release->CurrentIndexToSend[i] = Indexes[i].CurrentIndexToSend;
+            }
 
-                    break;
+            AnyMessageRead = FALSE;
 
-                default:
+            while (TRUE)
+            {
+                //
+                // Find the oldest message, priority messages are handled first
+                //
+                OldestRing   = -1;
+                OldestHeader = NULL;
 
-                    if (g_BreakPrintingOutput)
+                for (UINT32 i = 0; i < SharedBuffers->CountOfRings; i++)
+                {
+                    if (Release->CurrentIndexToSend[i] == Indexes[i].CurrentIndexToWrite)
                     {
-                        //
-                        // means that the user asserts a CTRL+C or CTRL+BREAK Signal
-                        // we shouldn't show or save anything in this case
-                        //
                         continue;
                     }
 
-                    //
-                    // Set output source to not found
-                    //
-                    OutputSourceFound = FALSE;
-
-                    //
-                    // Check if there are available output sources
-                    //
-                    if (g_OutputSourcesInitialized)
-                    {
-                        //
-                        // Now, we should check whether the following flag matches
-                        // with an output or not, also this is not where we want to
-                        // check output resources
-                        //
-                        TempList = &g_EventTrace;
-                        while (&g_EventTrace != TempList->Blink)
-                        {
-                            TempList = TempList->Blink;
-
-                            PDEBUGGER_GENERAL_EVENT_DETAIL EventDetail = CONTAINING_RECORD(
-                                TempList,
-                                DEBUGGER_GENERAL_EVENT_DETAIL,
-                                CommandsEventList);
-
-                            if (EventDetail->HasCustomOutput)
-                            {
-                                //
-                                // Output source found
-                                //
-                                OutputSourceFound = TRUE;
-
-                                //
-                                // Send the event to output sources
-                                //
-                                if (!ForwardingPerformEventForwarding(
-                                        EventDetail,
-                                        OutputBuffer + sizeof(UINT32),
-                                        ReturnedLength - sizeof(UINT32) + 1))
-                                {
-                                    ShowMessages("err, there was an error transferring the "
-                                                 "message to the remote sources\n");
-                                }
-
-                                break;
-                            }
-                        }
-                    }
+                    Header = (PBUFFER_HEADER)(SharedBuffers->Rings[i].BufferAddress +
+                                              (Release->CurrentIndexToSend[i] & (SharedBuffers->Rings[i].PacketsCapacity - 1)) * SharedBuffers->ChunkSize);
 
-                    //
-                    // Show the message if the source not found
-                    //
-                    if (!OutputSourceFound)
+                    if (OldestHeader == NULL ||
+                        (SharedBuffers->Rings[i].IsPriority && !SharedBuffers->Rings[OldestRing].IsPriority) ||
+                        (SharedBuffers->Rings[i].IsPriority == SharedBuffers->Rings[OldestRing].IsPriority && Header->Timestamp < OldestHeader->Timestamp))
                     {
-                        ShowMessages("%s", OutputBuffer + sizeof(UINT32));
+                        OldestRing   = i;
+                        OldestHeader = Header;
                     }
+                }
 
+                if (OldestHeader == NULL)
+                {
                     break;
                 }
-            }
-            else
-            {
-                //
-                // the thread should not work anymore
-                //
-                free(OutputBuffer);
 
                 //
-                // closeHandle
+                // Messages are null-terminated, so they're used in place (there
+                // is no IOCTL, so the read time is not available)
                 //
-                if (!CloseHandle(Handle))
-                {
-                    ShowMessages("err, closing handle 0x%x\n", GetLastError());
-                }
+                Timestamps.TriggerTimestamp  = OldestHeader->TriggerTimestamp;
+                Timestamps.SavedTimestamp    = OldestHeader->Timestamp;
+                Timestamps.ReceivedTimestamp = __rdtsc();
 
-                return;
+                ReadIrpBasedBufferHandleMessage(OldestHeader->OpeationNumber,
+                                                (char *)OldestHeader + sizeof(BUFFER_HEADER),
+                                                OldestHeader->BufferLength + sizeof(UINT32),
+                                                &Timestamps);
+
+                Release->CurrentIndexToSend[OldestRing]++;
+                AnyMessageRead = TRUE;
             }
-        }
+
+            //
+            // Release the read chunks so the kernel can reuse them
+            //
+            if (AnyMessageRead)
+            {
+                DeviceIoControl(
+                    Handle,                            // Handle to device
+                    IOCTL_RELEASE_SHARED_MESSAGES,     // IO Control code
+                    Release,                           // Input Buffer to driver.
+                    SIZEOF_LOG_SHARED_BUFFERS_RELEASE, // Length of input buffer in bytes.
+                    NULL,                              // Output Buffer from driver.
+                    0,                                 // Length of output buffer in bytes.
+                    &ReturnedLength,                   // Bytes placed in buffer.
+                    NULL                               // synchronous call
+                );
+            }
+
+            //
+            // Tell the kernel that everything is read, the interlocked exchange
+            // orders reading the published sequence after saving the consumed
+            // sequence, so a message is either seen here or it signals the event
+            //
+            InterlockedExchange64(&Notification->ConsumedSequence, Sequence);
+
+        } while (Notification->PublishedSequence != Sequence && !g_IsVmxOffProcessStart);
     }
-    catch (const std::exception &)
+
+    //
+    // The thread should not work anymore, buffers are unmapped by
+    // closing the handle
+    //
+    Result = TRUE;
+
+Cleanup:
+    if (Event != NULL)
     {
-        ShowMessages("err, exception occured in creating handle or parsing buffer\n");
+        CloseHandle(Event);
     }
 
-    free(OutputBuffer);
+    free(SharedBuffers);
+    free(Release);
 
-    //
-    // closeHandle
-    //
     if (!CloseHandle(Handle))
     {
         ShowMessages("err, closing handle 0x%x\n", GetLastError());
-    };
+    }
+
+    return Result;
 }
 
 /**
@@ -469,7 +928,13 @@ IrpBasedBufferThread(void * data)
     // thread. When this function returns, the thread goes away.  See
     // MSDN for more details. Test Irp Based Notifications
     //
-    ReadIrpBasedBuffer();
+    // The message buffers are mapped into the process if possible, and
+    // otherwise they're read using IRP Pending
+    //
+    if (!ReadSharedMemoryBuffer())
+    {
+        ReadIrpBasedBuffer();
+    }
 
     return 0;
 }
@@ -493,6 +958,17 @@ HyperDbgInstallVmmDriver()
         return 1;
     }
 
+    //
+    // If the driver is already running (e.g., the vmm is unloaded without
+    // removing the driver), it's reused without reinstalling, the version
+    // of the driver is checked once its device is opened
+    //
+    if (ManageDriver(KERNEL_DEBUGGER_DRIVER_NAME, g_DriverLocation, DRIVER_FUNC_QUERY_RUNNING))
+    {
+        ShowMessages("the driver is already running, reusing the driver\n");
+        return 0;
+    }
+
     if (!ManageDriver(KERNEL_DEBUGGER_DRIVER_NAME, g_DriverLocation, DRIVER_FUNC_INSTALL))
     {
         ShowMessages("unable to install VMM driver\n");
@@ -634,6 +1110,108 @@ HyperDbgUninstallReversingMachineDriver()
     return HyperDbgUninstallDriver(KERNEL_REVERSING_MACHINE_DRIVER_NAME);
 }
 
+/**
+ * @brief Open the device of the VMM driver
+ * @details opening the device initializes the vmm and the debugger
+ *
+ * @return BOOLEAN whether the device is opened or not
+ */
+BOOLEAN
+HyperDbgOpenVmmDevice()
+{
+    DWORD ErrorNum;
+
+    g_DeviceHandle = CreateFileA(
+        "\\\\.\\HyperDbgDebuggerDevice",
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL, /// lpSecurityAttirbutes
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED,
+        NULL); /// lpTemplateFile
+
+    if (g_DeviceHandle == INVALID_HANDLE_VALUE)
+    {
+        ErrorNum = GetLastError();
+        if (ErrorNum == ERROR_ACCESS_DENIED)
+        {
+            ShowMessages("err, access denied\nare you sure you have administrator "
+                         "rights?\n");
+        }
+        else if (ErrorNum == ERROR_GEN_FAILURE)
+        {
+            ShowMessages("err, a device attached to the system is not functioning\n"
+                         "vmx feature might be disabled from BIOS or VBS/HVCI is active\n");
+        }
+        else
+        {
+            ShowMessages("err, CreateFile failed (%x)\n", ErrorNum);
+        }
+
+        g_DeviceHandle = NULL;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether the running VMM driver is built from the same
+ * version of HyperDbg or not
+ * @details the drivers of the previous versions don't know the IOCTL,
+ * so they're also not compatible
+ *
+ * @return BOOLEAN whether the driver is compatible or not
+ */
+BOOLEAN
+HyperDbgCheckVmmDriverVersion()
+{
+    BOOL                          Status;
+    ULONG                         ReturnedLength;
+    DEBUGGER_QUERY_DRIVER_VERSION Version = {0};
+
+    Status = DeviceIoControl(
+        g_DeviceHandle,                       // Handle to device
+        IOCTL_QUERY_DRIVER_VERSION,           // IO Control code
+        &Version,                             // Input Buffer to driver.
+        SIZEOF_DEBUGGER_QUERY_DRIVER_VERSION, // Input buffer length
+        &Version,                             // Output Buffer from driver.
+        SIZEOF_DEBUGGER_QUERY_DRIVER_VERSION, // Length of output buffer in
+                                              // bytes.
+        &ReturnedLength,                      // Bytes placed in buffer.
+        NULL                                  // synchronous call
+    );
+
+    if (!Status || Version.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        return FALSE;
+    }
+
+    return Version.VersionMajor == VERSION_MAJOR &&
+           Version.VersionMinor == VERSION_MINOR &&
+           Version.VersionPatch == VERSION_PATCH &&
+           Version.SizeOfRequestStructures == DEBUGGER_QUERY_DRIVER_VERSION_STRUCTURES_SIZE;
+}
+
+/**
+ * @brief Terminate the vmm and close the device of an incompatible
+ * VMM driver
+ * @details the thread of reading messages is not created yet, so the
+ * handle is closed immediately
+ *
+ * @return VOID
+ */
+VOID
+HyperDbgCloseIncompatibleVmmDevice()
+{
+    DeviceIoControl(g_DeviceHandle, IOCTL_TERMINATE_VMX, NULL, 0, NULL, 0, NULL, NULL);
+    DeviceIoControl(g_DeviceHandle, IOCTL_RETURN_IRP_PENDING_PACKETS_AND_DISALLOW_IOCTL, NULL, 0, NULL, 0, NULL, NULL);
+
+    CloseHandle(g_DeviceHandle);
+
+    g_DeviceHandle = NULL;
+}
+
 /**
  * @brief Load the VMM driver
  *
@@ -644,7 +1222,6 @@ HPRDBGCTRL_API int
 HyperDbgLoadVmm()
 {
     string CpuID;
-    DWORD  ErrorNum;
     DWORD  ThreadId;
 
     if (g_DeviceHandle)
@@ -688,35 +1265,38 @@ HyperDbgLoadVmm()
     //
     // Init entering vmx
     //
-    g_DeviceHandle = CreateFileA(
-        "\\\\.\\HyperDbgDebuggerDevice",
-        GENERIC_READ | GENERIC_WRITE,
-        FILE_SHARE_READ | FILE_SHARE_WRITE,
-        NULL, /// lpSecurityAttirbutes
-        OPEN_EXISTING,
-        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED,
-        NULL); /// lpTemplateFile
+    if (!HyperDbgOpenVmmDevice())
+    {
+        return 1;
+    }
 
-    if (g_DeviceHandle == INVALID_HANDLE_VALUE)
+    //
+    // The running driver might be from another version of HyperDbg (it's
+    // reused or its service is installed from another path), if so, it's
+    // reinstalled from the driver file
+    //
+    if (!HyperDbgCheckVmmDriverVersion())
     {
-        ErrorNum = GetLastError();
-        if (ErrorNum == ERROR_ACCESS_DENIED)
+        ShowMessages("the running driver is not compatible with this version of "
+                     "HyperDbg, reinstalling the driver...\n");
+
+        HyperDbgCloseIncompatibleVmmDevice();
+
+        if (HyperDbgStopVmmDriver() != 0 ||
+            HyperDbgUninstallVmmDriver() != 0 ||
+            HyperDbgInstallVmmDriver() != 0 ||
+            !HyperDbgOpenVmmDevice())
         {
-            ShowMessages("err, access denied\nare you sure you have administrator "
-                         "rights?\n");
+            ShowMessages("err, unable to reinstall the driver\n");
+            return 1;
         }
-        else if (ErrorNum == ERROR_GEN_FAILURE)
+
+        if (!HyperDbgCheckVmmDriverVersion())
         {
-            ShowMessages("err, a device attached to the system is not functioning\n"
-                         "vmx feature might be disabled from BIOS or VBS/HVCI is active\n");
+            ShowMessages("err, the driver is not compatible with this version of HyperDbg\n");
+            HyperDbgCloseIncompatibleVmmDevice();
+            return 1;
         }
-        else
-        {
-            ShowMessages("err, CreateFile failed (%x)\n", ErrorNum);
-        }
-
-        g_DeviceHandle = NULL;
-        return 1;
     }
 
     //
@@ -725,12 +1305,10 @@ HyperDbgLoadVmm()
     InitializeListHead(&g_EventTrace);
 
 #if !UseDbgPrintInsteadOfUsermodeMessageTracking
-    HANDLE Thread = CreateThread(NULL, 0, IrpBasedBufferThread, NULL, 0, &ThreadId);
-
-    // if (Thread)
-    // {
-    // ShowMessages("thread Created successfully\n");
-    // }
+    //
+    // The handle is kept to wait for the thread once the vmm is unloaded
+    //
+    g_IrpBasedBufferThread = CreateThread(NULL, 0, IrpBasedBufferThread, NULL, 0, &ThreadId);
 
 #endif
 
@@ -808,6 +1386,12 @@ HyperDbgUnloadVmm()
     //
     UdUninitializeUserDebugger();
 
+    //
+    // Stop exporting the counters (if any), the sampling thread uses the
+    // handle of the driver
+    //
+    CountersExportStop();
+
     //
     // Send IOCTL to mark complete all IRP Pending
     //
@@ -862,7 +1446,17 @@ HyperDbgUnloadVmm()
     //
     g_IsVmxOffProcessStart = TRUE;
 
-    Sleep(1000); // Wait so next thread can return from IRP Pending
+    //
+    // Wait so the thread of reading messages can return from IRP Pending
+    // (and close its handle)
+    //
+    if (g_IrpBasedBufferThread != NULL)
+    {
+        WaitForSingleObject(g_IrpBasedBufferThread, DefaultTimeoutOfWaitingForMessagesThread);
+        CloseHandle(g_IrpBasedBufferThread);
+
+        g_IrpBasedBufferThread = NULL;
+    }
 
     //
     // Send IRP_MJ_CLOSE to driver to terminate Vmxs
@@ -116,21 +116,58 @@ ReplaceAll(string & str, const string & from, const string & to)
 const vector<string>
 Split(const string & s, const char & c)
 {
-    string         buff {""};
     vector<string> v;
+    size_t         start = 0;
+    size_t         end;
 
-    for (auto n : s)
+    //
+    // The tokens are copied once from the target string (instead of
+    // appending the characters one by one)
+    //
+    while (start < s.size())
     {
-        if (n != c)
-            buff += n;
-        else if (n == c && !buff.empty())
-        {
-            v.push_back(buff);
-            buff.clear();
-        }
+        end = s.find(c, start);
+
+        if (end == string::npos)
+            end = s.size();
+
+        if (end != start)
+            v.emplace_back(s, start, end - start);
+
+        start = end + 1;
+    }
+
+    return v;
+}
+
+/**
+ * @brief split a string into views of its tokens
+ * @details the tokens are not copied, so the views are only valid
+ * as long as the target string is not changed
+ *
+ * @param s target string
+ * @param c splitter (delimiter)
+ * @return vector<std::string_view>
+ */
+vector<std::string_view>
+SplitView(std::string_view s, const char & c)
+{
+    vector<std::string_view> v;
+    size_t                   start = 0;
+    size_t                   end;
+
+    while (start < s.size())
+    {
+        end = s.find(c, start);
+
+        if (end == std::string_view::npos)
+            end = s.size();
+
+        if (end != start)
+            v.push_back(s.substr(start, end - start));
+
+        start = end + 1;
     }
-    if (!buff.empty())
-        v.push_back(buff);
 
     return v;
 }
@@ -41,7 +41,7 @@ CommandBcHelp()
  * @return VOID
  */
 VOID
-CommandBc(vector<string> SplittedCommand, string Command)
+CommandBc(vector<string> & SplittedCommand, string & Command)
 {
     UINT64                            BreakpointId;
     DEBUGGEE_BP_LIST_OR_MODIFY_PACKET Request = {0};
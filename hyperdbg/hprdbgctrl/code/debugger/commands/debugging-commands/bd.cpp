@@ -41,7 +41,7 @@ CommandBdHelp()
  * @return VOID
  */
 VOID
-CommandBd(vector<string> SplittedCommand, string Command)
+CommandBd(vector<string> & SplittedCommand, string & Command)
 {
     UINT64                            BreakpointId;
     DEBUGGEE_BP_LIST_OR_MODIFY_PACKET Request = {0};
@@ -37,7 +37,7 @@ CommandBlHelp()
  * @return VOID
  */
 VOID
-CommandBl(vector<string> SplittedCommand, string Command)
+CommandBl(vector<string> & SplittedCommand, string & Command)
 {
     DEBUGGEE_BP_LIST_OR_MODIFY_PACKET Request = {0};
 
@@ -31,7 +31,8 @@ CommandBpHelp()
         "of breakpoints use !epthook or !epthook2 instead. See "
         "documentation for more inforamtion.\n\n");
 
-    ShowMessages("syntax : \tbp [Address (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] [core CoreId (hex)]\n");
+    ShowMessages("syntax : \tbp [Address (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] [core CoreId (hex)] "
+                 "[if Condition (expression)]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : bp nt!ExAllocatePoolWithTag\n");
@@ -41,6 +42,12 @@ CommandBpHelp()
     ShowMessages("\t\te.g : bp fffff8077356f010 pid 0x4\n");
     ShowMessages("\t\te.g : bp fffff8077356f010 tid 0x1000\n");
     ShowMessages("\t\te.g : bp fffff8077356f010 pid 0x4 core 2\n");
+    ShowMessages("\t\te.g : bp nt!ExAllocatePoolWithTag if @rdx == 0x1000\n");
+    ShowMessages("\t\te.g : bp nt!ExAllocatePoolWithTag pid 0x4 if @r8 == 0x74736554 && poi(@rsp) > 0\n");
+
+    ShowMessages("\n");
+    ShowMessages("the condition is evaluated in the debuggee (vmx-root) on each hit, and the debuggee "
+                 "is only halted if the condition is not zero\n");
 }
 
 /**
@@ -51,7 +58,7 @@ CommandBpHelp()
  * @return VOID
  */
 VOID
-CommandBp(vector<string> SplittedCommand, string Command)
+CommandBp(vector<string> & SplittedCommand, string & Command)
 {
     BOOL IsNextCoreId = FALSE;
     BOOL IsNextPid    = FALSE;
@@ -68,8 +75,37 @@ CommandBp(vector<string> SplittedCommand, string Command)
     UINT64         Address   = NULL;
     vector<string> SplittedCommandCaseSensitive {Split(Command, ' ')};
     UINT32         IndexInCommandCaseSensitive = 0;
+    string         Condition;
+    PVOID          ConditionCodeBuffer = NULL;
+    UINT32         ConditionBufferSize = 0;
+
+    PDEBUGGEE_BP_PACKET BpPacket = NULL;
+
+    //
+    // Separate the condition (everything after 'if') from the other parameters
+    //
+    for (size_t i = 1; i < SplittedCommand.size(); i++)
+    {
+        if (!SplittedCommand.at(i).compare("if"))
+        {
+            for (size_t j = i + 1; j < SplittedCommandCaseSensitive.size(); j++)
+            {
+                Condition.append(SplittedCommandCaseSensitive.at(j));
+                Condition.append(" ");
+            }
+
+            SplittedCommand.resize(i);
+
+            if (Condition.empty())
+            {
+                ShowMessages("please specify a condition after 'if'\n\n");
+                CommandBpHelp();
+                return;
+            }
 
-    DEBUGGEE_BP_PACKET BpPacket = {0};
+            break;
+        }
+    }
 
     if (SplittedCommand.size() >= 9)
     {
@@ -200,16 +236,78 @@ CommandBp(vector<string> SplittedCommand, string Command)
         return;
     }
 
+    //
+    // Compile the condition (if any), the debuggee evaluates it to the value
+    // of the first 'formats' that is reached
+    //
+    if (!Condition.empty())
+    {
+        Condition.insert(0, "if (");
+        Condition.append(") { formats(1); } else { formats(0); }");
+
+        ConditionCodeBuffer = ScriptEngineParseWrapper((char *)Condition.c_str(), TRUE);
+
+        if (ConditionCodeBuffer == NULL)
+        {
+            //
+            // The error is already shown by the script engine
+            //
+            return;
+        }
+
+        ConditionBufferSize = ScriptEngineWrapperGetSize(ConditionCodeBuffer);
+
+        if (ConditionBufferSize > MAXIMUM_BREAKPOINT_CONDITION_BUFFER_SIZE)
+        {
+            ShowMessages("err, the condition is too large (maximum size of the compiled condition is 0x%x bytes)\n",
+                         MAXIMUM_BREAKPOINT_CONDITION_BUFFER_SIZE);
+            ScriptEngineWrapperRemoveSymbolBuffer(ConditionCodeBuffer);
+            return;
+        }
+    }
+
+    BpPacket = (PDEBUGGEE_BP_PACKET)malloc(sizeof(DEBUGGEE_BP_PACKET) + ConditionBufferSize);
+
+    if (BpPacket == NULL)
+    {
+        ShowMessages("err, unable to allocate memory for the breakpoint packet\n");
+
+        if (ConditionCodeBuffer != NULL)
+        {
+            ScriptEngineWrapperRemoveSymbolBuffer(ConditionCodeBuffer);
+        }
+        return;
+    }
+
+    RtlZeroMemory(BpPacket, sizeof(DEBUGGEE_BP_PACKET) + ConditionBufferSize);
+
     //
     // Set the details for the remote packet
     //
-    BpPacket.Address = Address;
-    BpPacket.Core    = CoreNumer;
-    BpPacket.Pid     = Pid;
-    BpPacket.Tid     = Tid;
+    BpPacket->Address = Address;
+    BpPacket->Core    = CoreNumer;
+    BpPacket->Pid     = Pid;
+    BpPacket->Tid     = Tid;
+
+    //
+    // Move the condition buffer at the bottom of the packet
+    //
+    if (ConditionCodeBuffer != NULL)
+    {
+        BpPacket->ConditionBufferSize    = ConditionBufferSize;
+        BpPacket->ConditionBufferPointer = ScriptEngineWrapperGetPointer(ConditionCodeBuffer);
+
+        memcpy((PVOID)((UINT64)BpPacket + sizeof(DEBUGGEE_BP_PACKET)),
+               (PVOID)ScriptEngineWrapperGetHead(ConditionCodeBuffer),
+               ConditionBufferSize);
+
+        ScriptEngineWrapperRemoveSymbolBuffer(ConditionCodeBuffer);
+    }
 
     //
     // Send the bp packet
     //
-    KdSendBpPacketToDebuggee(&BpPacket);
+    KdSendBpPacketToDebuggee(BpPacket);
+
+    free(BpPacket);
 }
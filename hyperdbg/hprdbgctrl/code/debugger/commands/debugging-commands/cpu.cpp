@@ -32,7 +32,7 @@ CommandCpuHelp()
  * @return VOID
  */
 VOID
-CommandCpu(vector<string> SplittedCommand, string Command)
+CommandCpu(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() != 1)
     {
@@ -41,8 +41,8 @@ CommandReadMemoryAndDisassemblerHelp()
     ShowMessages("syntax : \tdc [Address (hex)] [l Length (hex)] [pid ProcessId (hex)]\n");
     ShowMessages("syntax : \tdd [Address (hex)] [l Length (hex)] [pid ProcessId (hex)]\n");
     ShowMessages("syntax : \tdq [Address (hex)] [l Length (hex)] [pid ProcessId (hex)]\n");
-    ShowMessages("syntax : \tu [Address (hex)] [l Length (hex)] [pid ProcessId (hex)]\n");
-    ShowMessages("syntax : \tu2 [Address (hex)] [l Length (hex)] [pid ProcessId (hex)]\n");
+    ShowMessages("syntax : \tu [Address (hex)] [l Length (hex)] [pid ProcessId (hex)] [file FilePath (string)]\n");
+    ShowMessages("syntax : \tu2 [Address (hex)] [l Length (hex)] [pid ProcessId (hex)] [file FilePath (string)]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : db nt!Kd_DEFAULT_Mask\n");
@@ -56,6 +56,11 @@ CommandReadMemoryAndDisassemblerHelp()
     ShowMessages("\t\te.g : u nt!ExAllocatePoolWithTag+30\n");
     ShowMessages("\t\te.g : u fffff8077356f010\n");
     ShowMessages("\t\te.g : u fffff8077356f010+@rcx\n");
+    ShowMessages("\t\te.g : u fffff80773400000 l a00000 file c:\\disassembly\\nt.txt\n");
+
+    ShowMessages("\n");
+    ShowMessages("the 'file' option disassembles the whole range to the file (without showing it), "
+                 "this is used for large ranges (e.g., whole images)\n");
 }
 
 /**
@@ -66,7 +71,7 @@ CommandReadMemoryAndDisassemblerHelp()
  * @return VOID
  */
 VOID
-CommandReadMemoryAndDisassembler(vector<string> SplittedCommand, string Command)
+CommandReadMemoryAndDisassembler(vector<string> & SplittedCommand, string & Command)
 {
     UINT32         Pid             = 0;
     UINT32         Length          = 0;
@@ -74,6 +79,8 @@ CommandReadMemoryAndDisassembler(vector<string> SplittedCommand, string Command)
     BOOLEAN        IsNextProcessId = FALSE;
     BOOLEAN        IsFirstCommand  = TRUE;
     BOOLEAN        IsNextLength    = FALSE;
+    BOOLEAN        IsNextFilePath  = FALSE;
+    string         FilePath;
     vector<string> SplittedCommandCaseSensitive {Split(Command, ' ')};
     UINT32         IndexInCommandCaseSensitive = 0;
 
@@ -130,12 +137,25 @@ CommandReadMemoryAndDisassembler(vector<string> SplittedCommand, string Command)
             continue;
         }
 
+        if (IsNextFilePath == TRUE)
+        {
+            FilePath       = SplittedCommandCaseSensitive.at(IndexInCommandCaseSensitive - 1);
+            IsNextFilePath = FALSE;
+            continue;
+        }
+
         if (!Section.compare("l"))
         {
             IsNextLength = TRUE;
             continue;
         }
 
+        if (!Section.compare("file"))
+        {
+            IsNextFilePath = TRUE;
+            continue;
+        }
+
         if (!Section.compare("pid"))
         {
             IsNextProcessId = TRUE;
@@ -196,7 +216,7 @@ CommandReadMemoryAndDisassembler(vector<string> SplittedCommand, string Command)
         }
     }
 
-    if (IsNextLength || IsNextProcessId)
+    if (IsNextLength || IsNextProcessId || IsNextFilePath)
     {
         ShowMessages("incorrect use of '%s' command\n\n", FirstCommand.c_str());
         CommandReadMemoryAndDisassemblerHelp();
@@ -220,6 +240,29 @@ CommandReadMemoryAndDisassembler(vector<string> SplittedCommand, string Command)
         Pid = GetCurrentProcessId();
     }
 
+    if (!FilePath.empty())
+    {
+        //
+        // Only the disassemblers (!u or u or u2 !u2) are written to files
+        //
+        if (FirstCommand.find('u') == string::npos)
+        {
+            ShowMessages("err, the 'file' option is only used for disassembling\n");
+            return;
+        }
+
+        HyperDbgReadMemoryAndDisassembleToFile(
+            FirstCommand.find('2') != string::npos ? DEBUGGER_SHOW_COMMAND_DISASSEMBLE32 : DEBUGGER_SHOW_COMMAND_DISASSEMBLE64,
+            TargetAddress,
+            FirstCommand.front() == '!' ? DEBUGGER_READ_PHYSICAL_ADDRESS : DEBUGGER_READ_VIRTUAL_ADDRESS,
+            READ_FROM_KERNEL,
+            Pid,
+            Length,
+            FilePath);
+
+        return;
+    }
+
     if (!FirstCommand.compare("db"))
     {
         HyperDbgReadMemoryAndDisassemble(DEBUGGER_SHOW_COMMAND_DB,
@@ -36,12 +36,13 @@ CommandDtHelp()
                  "[bitfield Bitfield (yesno)] [native Native (yesno)] [decl Declaration (yesno)] "
                  "[def Definitions (yesno)] [func Functions (yesno)] [pragma Pragma (yesno)] "
                  "[prefix Prefix (string)] [suffix Suffix (string)] [inline Expantion (string)] "
-                 "[output FileName (string)]\n\n");
+                 "[list FieldName (string)] [count Count (hex)] [output FileName (string)]\n\n");
     ShowMessages("syntax : \t!dt [Module!SymbolName (string)] [AddressExpression (string)] "
                  "[padding Padding (yesno)] [offset Offset (yesno)] [bitfield Bitfield (yesno)] "
                  "[native Native (yesno)] [decl Declaration (yesno)] [def Definitions (yesno)] "
                  "[func Functions (yesno)] [pragma Pragma (yesno)] [prefix Prefix (string)] "
-                 "[suffix Suffix (string)] [inline Expantion (string)] [output FileName (string)]\n");
+                 "[suffix Suffix (string)] [inline Expantion (string)] [list FieldName (string)] "
+                 "[count Count (hex)] [output FileName (string)]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : dt nt!_EPROCESS\n");
@@ -52,6 +53,8 @@ CommandDtHelp()
     ShowMessages("\t\te.g : dt nt!_MY_STRUCT 7ff00040 pid 1420\n");
     ShowMessages("\t\te.g : dt nt!_EPROCESS $proc inline all\n");
     ShowMessages("\t\te.g : dt nt!_EPROCESS fffff8077356f010 inline no\n");
+    ShowMessages("\t\te.g : dt nt!_EPROCESS $proc list ActiveProcessLinks\n");
+    ShowMessages("\t\te.g : dt nt!_EPROCESS $proc list ActiveProcessLinks count 5\n");
 }
 
 /**
@@ -85,25 +88,33 @@ CommandStructHelp()
  * @param ExtraArgs
  * @param PdbexArgs
  * @param ProcessId
+ * @param ListFieldName The field that links the nodes if a list should be walked
+ * @param ListCount Maximum number of nodes of the list to show
  *
  * @return BOOLEAN
  */
 BOOLEAN
 CommandDtAndStructConvertHyperDbgArgsToPdbex(vector<string> ExtraArgs,
                                              std::string &  PdbexArgs,
-                                             UINT32 *       ProcessId)
+                                             UINT32 *       ProcessId,
+                                             std::string &  ListFieldName,
+                                             UINT32 *       ListCount)
 {
     UINT32  TargetProcessId     = NULL;
+    UINT32  TargetListCount     = DT_DEFAULT_LIST_NODES_COUNT;
     BOOLEAN NextItemIsYesNo     = FALSE;
     BOOLEAN NextItemIsString    = FALSE;
     BOOLEAN NextItemIsInline    = FALSE;
     BOOLEAN NextItemIsFileName  = FALSE;
     BOOLEAN NextItemIsProcessId = FALSE;
+    BOOLEAN NextItemIsListField = FALSE;
+    BOOLEAN NextItemIsListCount = FALSE;
 
     //
     // Clear the args
     //
-    PdbexArgs = "";
+    PdbexArgs     = "";
+    ListFieldName = "";
 
     //
     // Traverse through the extra arguments
@@ -136,6 +147,32 @@ CommandDtAndStructConvertHyperDbgArgsToPdbex(vector<string> ExtraArgs,
             continue;
         }
 
+        //
+        // Check for the field that links the nodes of the list
+        //
+        if (NextItemIsListField)
+        {
+            ListFieldName = Item;
+
+            NextItemIsListField = FALSE;
+            continue;
+        }
+
+        //
+        // Check for the count of nodes of the list
+        //
+        if (NextItemIsListCount)
+        {
+            if (!ConvertStringToUInt32(Item, &TargetListCount) || TargetListCount == 0)
+            {
+                ShowMessages("err, you should enter a valid count of nodes\n\n");
+                return FALSE;
+            }
+
+            NextItemIsListCount = FALSE;
+            continue;
+        }
+
         //
         // Check if we expect yes/no answers
         //
@@ -210,6 +247,14 @@ CommandDtAndStructConvertHyperDbgArgsToPdbex(vector<string> ExtraArgs,
         {
             NextItemIsProcessId = TRUE;
         }
+        else if (!Item.compare("list"))
+        {
+            NextItemIsListField = TRUE;
+        }
+        else if (!Item.compare("count"))
+        {
+            NextItemIsListCount = TRUE;
+        }
         else if (!Item.compare("output"))
         {
             NextItemIsFileName = TRUE;
@@ -283,16 +328,119 @@ CommandDtAndStructConvertHyperDbgArgsToPdbex(vector<string> ExtraArgs,
     //
     // Check if user enetered yes/no or string when expected or not
     //
-    if (NextItemIsYesNo || NextItemIsString || NextItemIsInline || NextItemIsFileName || NextItemIsProcessId)
+    if (NextItemIsYesNo || NextItemIsString || NextItemIsInline || NextItemIsFileName ||
+        NextItemIsProcessId || NextItemIsListField || NextItemIsListCount)
     {
         ShowMessages("err, incomplete argument\n\n");
         return FALSE;
     }
 
     //
-    // Set the process id
+    // Set the process id and the count of nodes
     //
     *ProcessId = TargetProcessId;
+    *ListCount = TargetListCount;
+
+    return TRUE;
+}
+
+/**
+ * @brief Walk a linked list and show each node based on the symbol
+ * structure
+ * @details each node is read once (including the field that links it
+ * to the next node), so the next node is found locally from the same
+ * buffer that is used for showing the node
+ *
+ * @param TypeName
+ * @param Address Address of the first node
+ * @param StructureSize
+ * @param ReadMem The request of reading memory (the address and the
+ * size are filled here)
+ * @param ListFieldName The field (LIST_ENTRY) that links the nodes
+ * @param ListCount Maximum number of nodes to show
+ * @param AdditionalParameters
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandDtShowListBasedOnSymbolTypes(const char *          TypeName,
+                                    UINT64                Address,
+                                    UINT64                StructureSize,
+                                    PDEBUGGER_READ_MEMORY ReadMem,
+                                    const char *          ListFieldName,
+                                    UINT32                ListCount,
+                                    const char *          AdditionalParameters)
+{
+    UINT32          ListFieldOffset = 0;
+    UINT32          ReturnedLength  = 0;
+    UINT64          NodeAddress     = Address;
+    UINT64          NextLink        = NULL;
+    unsigned char * NodeBuffer      = NULL;
+
+    //
+    // Get the offset of the field that links the nodes
+    //
+    if (!ScriptEngineGetFieldOffsetWrapper((CHAR *)TypeName, (CHAR *)ListFieldName, &ListFieldOffset) ||
+        ListFieldOffset + sizeof(UINT64) > StructureSize)
+    {
+        ShowMessages("err, couldn't resolve the field '%s' of '%s'\n", ListFieldName, TypeName);
+        return FALSE;
+    }
+
+    NodeBuffer = (unsigned char *)malloc((SIZE_T)StructureSize);
+
+    if (NodeBuffer == NULL)
+    {
+        ShowMessages("err, unable to allocate memory\n");
+        return FALSE;
+    }
+
+    ReadMem->Size = (UINT32)StructureSize;
+
+    for (UINT32 i = 0; i < ListCount; i++)
+    {
+        ZeroMemory(NodeBuffer, (SIZE_T)StructureSize);
+
+        ReadMem->Address = NodeAddress;
+
+        if (!HyperDbgReadMemory(ReadMem, NodeBuffer, &ReturnedLength))
+        {
+            break;
+        }
+
+        if (ReturnedLength != StructureSize)
+        {
+            ShowMessages("err, unable to read the node at %s\n", SeparateTo64BitValue(NodeAddress).c_str());
+            break;
+        }
+
+        ShowMessages("[%x] %s\n", i, SeparateTo64BitValue(NodeAddress).c_str());
+
+        ScriptEngineShowDataBasedOnSymbolTypesWrapper(TypeName,
+                                                      NodeAddress,
+                                                      FALSE,
+                                                      NodeBuffer,
+                                                      AdditionalParameters);
+        ShowMessages("\n");
+
+        //
+        // Find the next node from the (Flink of) the link field
+        //
+        NextLink = *(UINT64 *)(NodeBuffer + ListFieldOffset);
+
+        if (NextLink == NULL || NextLink - ListFieldOffset == Address)
+        {
+            //
+            // The end of the list, or the list is circular and we're back at
+            // the first node
+            //
+            break;
+        }
+
+        NodeAddress = NextLink - ListFieldOffset;
+    }
+
+    free(NodeBuffer);
 
     return TRUE;
 }
@@ -307,6 +455,9 @@ CommandDtAndStructConvertHyperDbgArgsToPdbex(vector<string> ExtraArgs,
  * @param TargetPid
  * @param IsPhysicalAddress
  * @param AdditionalParameters
+ * @param ListFieldName The field that links the nodes if a list should be
+ * walked (NULL or empty if it's not a list)
+ * @param ListCount Maximum number of nodes of the list to show
  *
  * @return BOOLEAN
  */
@@ -318,7 +469,9 @@ CommandDtShowDataBasedOnSymbolTypes(
     PVOID        BufferAddress,
     UINT32       TargetPid,
     BOOLEAN      IsPhysicalAddress,
-    const char * AdditionalParameters)
+    const char * AdditionalParameters,
+    const char * ListFieldName,
+    UINT32       ListCount)
 {
     UINT64                      StructureSize       = 0;
     BOOLEAN                     ResultOfFindingSize = FALSE;
@@ -393,6 +546,28 @@ CommandDtShowDataBasedOnSymbolTypes(
         //
         DtOptions.SizeOfTypeName = StructureSize;
 
+        //
+        // Walk the list if the field that links the nodes is specified
+        //
+        if (ListFieldName != NULL && ListFieldName[0] != '\0')
+        {
+            DEBUGGER_READ_MEMORY ReadMem = {0};
+
+            ReadMem.Pid         = TargetPid;
+            ReadMem.MemoryType  = IsPhysicalAddress ? DEBUGGER_READ_PHYSICAL_ADDRESS : DEBUGGER_READ_VIRTUAL_ADDRESS;
+            ReadMem.ReadingType = READ_FROM_KERNEL;
+            ReadMem.Style       = DEBUGGER_SHOW_COMMAND_DT;
+            ReadMem.DtDetails   = &DtOptions;
+
+            return CommandDtShowListBasedOnSymbolTypes(TypeName,
+                                                       Address,
+                                                       StructureSize,
+                                                       &ReadMem,
+                                                       ListFieldName,
+                                                       ListCount,
+                                                       AdditionalParameters);
+        }
+
         //
         // Read the memory
         //
@@ -404,6 +579,11 @@ CommandDtShowDataBasedOnSymbolTypes(
                                          StructureSize,
                                          &DtOptions);
     }
+    else if (ListFieldName != NULL && ListFieldName[0] != '\0')
+    {
+        ShowMessages("err, walking a list needs the address of the first node\n");
+        return FALSE;
+    }
     else
     {
         //
@@ -422,7 +602,7 @@ CommandDtShowDataBasedOnSymbolTypes(
  * @return VOID
  */
 VOID
-CommandDtAndStruct(vector<string> SplittedCommand, string Command)
+CommandDtAndStruct(vector<string> & SplittedCommand, string & Command)
 {
     std::string TempTypeNameHolder;
     std::string PdbexArgs                          = "";
@@ -431,6 +611,8 @@ CommandDtAndStruct(vector<string> SplittedCommand, string Command)
     PVOID       BufferAddressRetrievedFromDebuggee = NULL;
     UINT32      TargetPid                          = NULL;
     BOOLEAN     IsPhysicalAddress                  = FALSE;
+    std::string ListFieldName                      = "";
+    UINT32      ListCount                          = DT_DEFAULT_LIST_NODES_COUNT;
 
     //
     // Check if command is 'struct' or not
@@ -508,7 +690,9 @@ CommandDtAndStruct(vector<string> SplittedCommand, string Command)
                                             NULL,
                                             TargetPid,
                                             IsPhysicalAddress,
-                                            PDBEX_DEFAULT_CONFIGURATION);
+                                            PDBEX_DEFAULT_CONFIGURATION,
+                                            NULL,
+                                            NULL);
     }
     else
     {
@@ -545,7 +729,7 @@ CommandDtAndStruct(vector<string> SplittedCommand, string Command)
                 //
                 // Convert to pdbex args
                 //
-                if (!CommandDtAndStructConvertHyperDbgArgsToPdbex(TempSplittedCommand, PdbexArgs, &TargetPid))
+                if (!CommandDtAndStructConvertHyperDbgArgsToPdbex(TempSplittedCommand, PdbexArgs, &TargetPid, ListFieldName, &ListCount))
                 {
                     if (IsStruct)
                     {
@@ -568,7 +752,9 @@ CommandDtAndStruct(vector<string> SplittedCommand, string Command)
                                                     BufferAddressRetrievedFromDebuggee,
                                                     TargetPid,
                                                     IsPhysicalAddress,
-                                                    PdbexArgs.c_str());
+                                                    PdbexArgs.c_str(),
+                                                    ListFieldName.c_str(),
+                                                    ListCount);
             }
             else
             {
@@ -588,7 +774,9 @@ CommandDtAndStruct(vector<string> SplittedCommand, string Command)
                                                         BufferAddressRetrievedFromDebuggee,
                                                         TargetPid,
                                                         IsPhysicalAddress,
-                                                        PDBEX_DEFAULT_CONFIGURATION);
+                                                        PDBEX_DEFAULT_CONFIGURATION,
+                                                        NULL,
+                                                        NULL);
                 }
                 else
                 {
@@ -608,7 +796,7 @@ CommandDtAndStruct(vector<string> SplittedCommand, string Command)
                     //
                     // Convert to pdbex args
                     //
-                    if (!CommandDtAndStructConvertHyperDbgArgsToPdbex(TempSplittedCommand, PdbexArgs, &TargetPid))
+                    if (!CommandDtAndStructConvertHyperDbgArgsToPdbex(TempSplittedCommand, PdbexArgs, &TargetPid, ListFieldName, &ListCount))
                     {
                         if (IsStruct)
                         {
@@ -631,7 +819,9 @@ CommandDtAndStruct(vector<string> SplittedCommand, string Command)
                                                         BufferAddressRetrievedFromDebuggee,
                                                         TargetPid,
                                                         IsPhysicalAddress,
-                                                        PdbexArgs.c_str());
+                                                        PdbexArgs.c_str(),
+                                                        ListFieldName.c_str(),
+                                                        ListCount);
                 }
             }
         }
@@ -653,7 +843,9 @@ CommandDtAndStruct(vector<string> SplittedCommand, string Command)
                                                     BufferAddressRetrievedFromDebuggee,
                                                     TargetPid,
                                                     IsPhysicalAddress,
-                                                    PDBEX_DEFAULT_CONFIGURATION);
+                                                    PDBEX_DEFAULT_CONFIGURATION,
+                                                    NULL,
+                                                    NULL);
             }
             else
             {
@@ -673,7 +865,7 @@ CommandDtAndStruct(vector<string> SplittedCommand, string Command)
                 //
                 // Convert to pdbex args
                 //
-                if (!CommandDtAndStructConvertHyperDbgArgsToPdbex(TempSplittedCommand, PdbexArgs, &TargetPid))
+                if (!CommandDtAndStructConvertHyperDbgArgsToPdbex(TempSplittedCommand, PdbexArgs, &TargetPid, ListFieldName, &ListCount))
                 {
                     if (IsStruct)
                     {
@@ -696,7 +888,9 @@ CommandDtAndStruct(vector<string> SplittedCommand, string Command)
                                                     BufferAddressRetrievedFromDebuggee,
                                                     TargetPid,
                                                     IsPhysicalAddress,
-                                                    PdbexArgs.c_str());
+                                                    PdbexArgs.c_str(),
+                                                    ListFieldName.c_str(),
+                                                    ListCount);
             }
         }
     }
@@ -15,7 +15,10 @@
 // Global Variables
 //
 extern BOOLEAN                  g_IsSerialConnectedToRemoteDebuggee;
+extern BOOLEAN                  g_IsConnectedToRemoteDebuggee;
+extern BOOLEAN                  g_ExecutingScript;
 extern ACTIVE_DEBUGGING_PROCESS g_ActiveProcessDebuggingState;
+extern EDIT_MEMORY_BATCH_STATE  g_EditMemoryBatch;
 
 /**
  * @brief help of !e* and e* commands
@@ -56,7 +59,7 @@ CommandEditMemoryHelp()
  * @return VOID
  */
 VOID
-CommandEditMemory(vector<string> SplittedCommand, string Command)
+CommandEditMemory(vector<string> & SplittedCommand, string & Command)
 {
     BOOL                 Status;
     UINT64               Address;
@@ -308,6 +311,14 @@ CommandEditMemory(vector<string> SplittedCommand, string Command)
         return;
     }
 
+    //
+    // The edits of a script are gathered into a single patch request
+    //
+    if (CommandEditMemoryBatchAppend(&EditMemoryRequest, ValuesToEdit, Command))
+    {
+        return;
+    }
+
     //
     // Now it's time to put everything together in one structure
     //
@@ -409,3 +420,242 @@ CommandEditMemory(vector<string> SplittedCommand, string Command)
     //
     free(FinalBuffer);
 }
+
+/**
+ * @brief Start gathering the e* commands of a script into a single
+ * patch request
+ *
+ * @return BOOLEAN Returns TRUE if the gathering is started by this call
+ * (the caller should end it)
+ */
+BOOLEAN
+CommandEditMemoryBatchBegin()
+{
+    //
+    // The commands of a remote connection are sent to the remote computer
+    // one by one
+    //
+    if (g_EditMemoryBatch.IsBatching || g_IsConnectedToRemoteDebuggee ||
+        (!g_IsSerialConnectedToRemoteDebuggee && g_DeviceHandle == NULL))
+    {
+        return FALSE;
+    }
+
+    g_EditMemoryBatch.Request = (PDEBUGGER_PATCH_MEMORY_REQUEST)malloc(SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST + MaxSerialPatchMemoryBufferSize);
+
+    if (g_EditMemoryBatch.Request == NULL)
+    {
+        return FALSE;
+    }
+
+    RtlZeroMemory(g_EditMemoryBatch.Request, SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST);
+
+    g_EditMemoryBatch.Commands.clear();
+    g_EditMemoryBatch.IsBatching = TRUE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether the command can be gathered into the patch request
+ *
+ * @param Command
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandEditMemoryBatchIsBatchableCommand(const std::string & Command)
+{
+    std::string FirstCommand;
+
+    if (!g_EditMemoryBatch.IsBatching)
+    {
+        return FALSE;
+    }
+
+    FirstCommand = Command;
+    Trim(FirstCommand);
+
+    FirstCommand = FirstCommand.substr(0, FirstCommand.find_first_of(" \t\n"));
+
+    transform(FirstCommand.begin(), FirstCommand.end(), FirstCommand.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    if (!FirstCommand.empty() && FirstCommand.front() == '!')
+    {
+        FirstCommand.erase(0, 1);
+    }
+
+    return FirstCommand == "eb" ||
+           FirstCommand == "ed" ||
+           FirstCommand == "eq";
+}
+
+/**
+ * @brief Add an e* command to the patch request
+ * @details the request is sent first if the patch doesn't fit in it
+ * or if the patch is on another memory (type or process)
+ *
+ * @param EditMemoryRequest The parsed command
+ * @param Values The values of the command
+ * @param Command The command (for showing its errors)
+ *
+ * @return BOOLEAN Returns TRUE if the command is added to the request,
+ * otherwise the command should be sent separately
+ */
+BOOLEAN
+CommandEditMemoryBatchAppend(PDEBUGGER_EDIT_MEMORY EditMemoryRequest, const vector<UINT64> & Values, const string & Command)
+{
+    PDEBUGGER_PATCH_MEMORY_REQUEST PatchMemRequest = g_EditMemoryBatch.Request;
+    PDEBUGGER_PATCH_MEMORY_ENTRY   Patch;
+    UINT32                         LengthOfEachChunk;
+    UINT32                         Size;
+
+    if (!g_EditMemoryBatch.IsBatching || !g_ExecutingScript)
+    {
+        return FALSE;
+    }
+
+    if (EditMemoryRequest->ByteSize == EDIT_BYTE)
+    {
+        LengthOfEachChunk = 1;
+    }
+    else if (EditMemoryRequest->ByteSize == EDIT_DWORD)
+    {
+        LengthOfEachChunk = 4;
+    }
+    else
+    {
+        LengthOfEachChunk = 8;
+    }
+
+    Size = LengthOfEachChunk * (UINT32)Values.size();
+
+    if (DEBUGGER_PATCH_MEMORY_ENTRY_LENGTH(Size) > MaxSerialPatchMemoryBufferSize)
+    {
+        return FALSE;
+    }
+
+    if (PatchMemRequest->CountOfPatches != 0 &&
+        (PatchMemRequest->ProcessId != EditMemoryRequest->ProcessId ||
+         PatchMemRequest->MemoryType != EditMemoryRequest->MemoryType ||
+         PatchMemRequest->PatchesBufferSize + DEBUGGER_PATCH_MEMORY_ENTRY_LENGTH(Size) > MaxSerialPatchMemoryBufferSize))
+    {
+        CommandEditMemoryBatchFlush();
+    }
+
+    PatchMemRequest->ProcessId  = EditMemoryRequest->ProcessId;
+    PatchMemRequest->MemoryType = EditMemoryRequest->MemoryType;
+
+    Patch = (PDEBUGGER_PATCH_MEMORY_ENTRY)((UINT64)PatchMemRequest + SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST + PatchMemRequest->PatchesBufferSize);
+
+    Patch->Address  = EditMemoryRequest->Address;
+    Patch->Size     = Size;
+    Patch->Reserved = 0;
+
+    //
+    // The low bytes of each value are written (same as editing the memory)
+    //
+    for (size_t i = 0; i < Values.size(); i++)
+    {
+        memcpy((BYTE *)Patch + sizeof(DEBUGGER_PATCH_MEMORY_ENTRY) + (i * LengthOfEachChunk), &Values.at(i), LengthOfEachChunk);
+    }
+
+    PatchMemRequest->PatchesBufferSize += DEBUGGER_PATCH_MEMORY_ENTRY_LENGTH(Size);
+    PatchMemRequest->CountOfPatches++;
+
+    g_EditMemoryBatch.Commands.push_back(Command);
+
+    return TRUE;
+}
+
+/**
+ * @brief Send the gathered e* commands in a single patch request
+ * @details the kernel stops at the first patch that couldn't be applied,
+ * so the command of that patch is shown and the rest of the patches are
+ * sent again (each command is applied independently, same as running
+ * them one by one)
+ *
+ * @return BOOLEAN Whether all of the commands are applied or not
+ */
+BOOLEAN
+CommandEditMemoryBatchFlush()
+{
+    PDEBUGGER_PATCH_MEMORY_REQUEST PatchMemRequest = g_EditMemoryBatch.Request;
+    PDEBUGGER_PATCH_MEMORY_ENTRY   Patch;
+    BYTE *                         Stream;
+    UINT32                         Offset;
+    UINT32                         FailedCommand;
+    UINT32                         FirstCommand = 0;
+    BOOLEAN                        Result       = TRUE;
+
+    if (!g_EditMemoryBatch.IsBatching || PatchMemRequest->CountOfPatches == 0)
+    {
+        //
+        // Nothing to send
+        //
+        return TRUE;
+    }
+
+    Stream = (BYTE *)PatchMemRequest + SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST;
+
+    while (PatchMemRequest->CountOfPatches != 0 && !CommandPatchSendRequest(PatchMemRequest))
+    {
+        Result = FALSE;
+
+        //
+        // The request is not sent or it's not valid, so the rest of
+        // the patches can't be applied either
+        //
+        if (PatchMemRequest->KernelStatus == NULL ||
+            PatchMemRequest->KernelStatus == DEBUGGER_ERROR_EDIT_MEMORY_STATUS_INVALID_PARAMETER ||
+            PatchMemRequest->CountOfAppliedPatches >= PatchMemRequest->CountOfPatches)
+        {
+            break;
+        }
+
+        FailedCommand = FirstCommand + PatchMemRequest->CountOfAppliedPatches;
+
+        ShowMessages("err, couldn't apply '%s'\n", g_EditMemoryBatch.Commands.at(FailedCommand).c_str());
+
+        //
+        // Remove the applied patches and the failed patch from the stream
+        //
+        Offset = 0;
+
+        for (UINT32 i = 0; i <= PatchMemRequest->CountOfAppliedPatches; i++)
+        {
+            Patch = (PDEBUGGER_PATCH_MEMORY_ENTRY)(Stream + Offset);
+            Offset += DEBUGGER_PATCH_MEMORY_ENTRY_LENGTH(Patch->Size);
+        }
+
+        memmove(Stream, Stream + Offset, PatchMemRequest->PatchesBufferSize - Offset);
+
+        PatchMemRequest->PatchesBufferSize -= Offset;
+        PatchMemRequest->CountOfPatches -= PatchMemRequest->CountOfAppliedPatches + 1;
+
+        FirstCommand = FailedCommand + 1;
+    }
+
+    PatchMemRequest->CountOfPatches    = 0;
+    PatchMemRequest->PatchesBufferSize = 0;
+
+    g_EditMemoryBatch.Commands.clear();
+
+    return Result;
+}
+
+/**
+ * @brief Send the gathered e* commands and stop gathering the commands
+ *
+ * @return VOID
+ */
+VOID
+CommandEditMemoryBatchEnd()
+{
+    CommandEditMemoryBatchFlush();
+
+    g_EditMemoryBatch.IsBatching = FALSE;
+
+    free(g_EditMemoryBatch.Request);
+    g_EditMemoryBatch.Request = NULL;
+}
@@ -29,10 +29,17 @@ CommandEvalHelp()
     ShowMessages("? : evaluates and execute expressions in debuggee.\n\n");
 
     ShowMessages("syntax : \t? [Expression (string)]\n");
+    ShowMessages("syntax : \t? [benchmark] [Iterations (hex)]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : ? print(dq(poi(@rcx)));\n");
     ShowMessages("\t\te.g : ? json(dq(poi(@rcx)));\n");
+    ShowMessages("\t\te.g : ? benchmark\n");
+    ShowMessages("\t\te.g : ? benchmark 10000\n");
+
+    ShowMessages("\n");
+    ShowMessages("the 'benchmark' parses and runs a corpus of scripts locally (without the hypervisor) "
+                 "and shows the time of each script, each operator and the count of the allocations\n");
 }
 
 /**
@@ -193,7 +200,7 @@ ErrorMessage:
  * @return VOID
  */
 VOID
-CommandEval(vector<string> SplittedCommand, string Command)
+CommandEval(vector<string> & SplittedCommand, string & Command)
 {
     PVOID  CodeBuffer;
     UINT64 BufferAddress;
@@ -242,6 +249,28 @@ CommandEval(vector<string> SplittedCommand, string Command)
         return;
     }
 
+    //
+    // Check if it's a benchmark of the script engine or not
+    //
+    if (!Command.compare(0, 9, "benchmark") && (Command.size() == 9 || Command[9] == ' '))
+    {
+        UINT32 Iterations       = SCRIPT_ENGINE_BENCHMARK_DEFAULT_ITERATIONS;
+        string IterationsString = Command.substr(9);
+
+        Trim(IterationsString);
+
+        if (!IterationsString.empty() &&
+            (!ConvertStringToUInt32(IterationsString, &Iterations) || Iterations == 0))
+        {
+            ShowMessages("err, couldn't resolve error at '%s'\n", IterationsString.c_str());
+            return;
+        }
+
+        ScriptEngineWrapperBenchmark(Iterations);
+
+        return;
+    }
+
     if (g_IsSerialConnectedToRemoteDebuggee)
     {
         //
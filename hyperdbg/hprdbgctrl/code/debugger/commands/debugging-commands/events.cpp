@@ -14,6 +14,7 @@
 //
 // Global Variables
 //
+extern HANDLE     g_DeviceHandle;
 extern LIST_ENTRY g_EventTrace;
 extern BOOLEAN    g_EventTraceInitialized;
 extern BOOLEAN    g_BreakPrintingOutput;
@@ -23,6 +24,8 @@ extern BOOLEAN    g_IsSerialConnectedToRemoteDebuggee;
 extern BOOLEAN    g_IsSerialConnectedToRemoteDebugger;
 extern UINT64     g_EventTag;
 
+extern DEBUGGER_EVENTS_BATCH g_EventsBatch;
+
 /**
  * @brief help of events command
  *
@@ -36,14 +39,28 @@ CommandEventsHelp()
     ShowMessages("syntax : \tevents\n");
     ShowMessages("syntax : \tevents [e|d|c all|EventNumber (hex)]\n");
     ShowMessages("syntax : \tevents [sc State (on|off)]\n");
+    ShowMessages("syntax : \tevents [batch begin|commit|abort]\n");
+    ShowMessages("syntax : \tevents [stats] [reset]\n");
+    ShowMessages("syntax : \tevents [range add|remove EventNumber (hex) FromAddress (hex) ToAddress (hex)]\n");
 
     ShowMessages("e : enable\n");
     ShowMessages("d : disable\n");
     ShowMessages("c : clear\n");
 
+    ShowMessages("batch : queue the events (begin) and register all of them in one "
+                 "request (commit) or discard them (abort)\n");
+    ShowMessages("stats : show the hit statistics of the events (the most hit events "
+                 "first) and optionally reset them\n");
+    ShowMessages("range : add a range to a '!monitor' event or remove one of its ranges "
+                 "(a single event monitors all of its ranges)\n");
+
     ShowMessages("note : If you specify 'all' then e, d, or c will be applied to "
                  "all of the events.\n\n");
 
+    ShowMessages("note : the events of a batch are enabled once all of them are "
+                 "registered, if one of them is not registered then none of them "
+                 "are registered.\n\n");
+
     ShowMessages("\n");
     ShowMessages("\te.g : events \n");
     ShowMessages("\te.g : events e 12\n");
@@ -52,6 +69,12 @@ CommandEventsHelp()
     ShowMessages("\te.g : events c all\n");
     ShowMessages("\te.g : events sc on\n");
     ShowMessages("\te.g : events sc off\n");
+    ShowMessages("\te.g : events batch begin\n");
+    ShowMessages("\te.g : events batch commit\n");
+    ShowMessages("\te.g : events stats\n");
+    ShowMessages("\te.g : events stats reset\n");
+    ShowMessages("\te.g : events range add 1 fffff801deadc000 fffff801deadc100\n");
+    ShowMessages("\te.g : events range remove 1 fffff801deadc000 fffff801deadc100\n");
 }
 
 /**
@@ -62,21 +85,82 @@ CommandEventsHelp()
  * @return VOID
  */
 VOID
-CommandEvents(vector<string> SplittedCommand, string Command)
+CommandEvents(vector<string> & SplittedCommand, string & Command)
 {
     DEBUGGER_MODIFY_EVENTS_TYPE RequestedAction;
     UINT64                      RequestedTag;
+    UINT64                      RangeStart;
+    UINT64                      RangeEnd;
+
+    //
+    // The ranges of monitor events are added or removed by their addresses
+    //
+    if (SplittedCommand.size() >= 2 && !SplittedCommand.at(1).compare("range"))
+    {
+        if (SplittedCommand.size() != 6 ||
+            (SplittedCommand.at(2).compare("add") && SplittedCommand.at(2).compare("remove")))
+        {
+            ShowMessages("incorrect use of '%s'\n\n", SplittedCommand.at(0).c_str());
+            CommandEventsHelp();
+            return;
+        }
+
+        if (!ConvertStringToUInt64(SplittedCommand.at(3), &RequestedTag))
+        {
+            ShowMessages("please specify a correct hex value for tag id (event number)\n\n");
+            CommandEventsHelp();
+            return;
+        }
+
+        if (!SymbolConvertNameOrExprToAddress(SplittedCommand.at(4), &RangeStart) ||
+            !SymbolConvertNameOrExprToAddress(SplittedCommand.at(5), &RangeEnd))
+        {
+            ShowMessages("err, couldn't resolve the addresses of the range\n\n");
+            CommandEventsHelp();
+            return;
+        }
+
+        if (RangeStart >= RangeEnd)
+        {
+            ShowMessages("please choose the 'from' value first, then choose the 'to' value\n");
+            return;
+        }
+
+        RequestedAction = !SplittedCommand.at(2).compare("add") ? DEBUGGER_MODIFY_EVENTS_ADD_MONITOR_RANGE : DEBUGGER_MODIFY_EVENTS_REMOVE_MONITOR_RANGE;
+
+        CommandEventsModifyMonitorRange(RequestedTag + DebuggerEventTagStartSeed, RequestedAction, RangeStart, RangeEnd);
+
+        return;
+    }
 
     //
     // Validate the parameters (size)
     //
-    if (SplittedCommand.size() != 1 && SplittedCommand.size() != 3)
+    if (SplittedCommand.size() != 1 && SplittedCommand.size() != 3 &&
+        !(SplittedCommand.size() == 2 && !SplittedCommand.at(1).compare("stats")))
     {
         ShowMessages("incorrect use of '%s'\n\n", SplittedCommand.at(0).c_str());
         CommandEventsHelp();
         return;
     }
 
+    //
+    // The statistics of all of the events are queried at once
+    //
+    if (SplittedCommand.size() >= 2 && !SplittedCommand.at(1).compare("stats"))
+    {
+        if (SplittedCommand.size() == 3 && SplittedCommand.at(2).compare("reset"))
+        {
+            ShowMessages("incorrect use of '%s'\n\n", SplittedCommand.at(0).c_str());
+            CommandEventsHelp();
+            return;
+        }
+
+        CommandEventsShowStatistics(SplittedCommand.size() == 3);
+
+        return;
+    }
+
     if (SplittedCommand.size() == 1)
     {
         if (!g_EventTraceInitialized)
@@ -132,6 +216,44 @@ CommandEvents(vector<string> SplittedCommand, string Command)
         //
         return;
     }
+    else if (!SplittedCommand.at(1).compare("batch"))
+    {
+        if (!SplittedCommand.at(2).compare("begin"))
+        {
+            if (!DebuggerEventsBatchBegin())
+            {
+                ShowMessages("err, the events are already queued, use 'events batch commit' "
+                             "or 'events batch abort'\n");
+                return;
+            }
+
+            ShowMessages("the events are queued until 'events batch commit'\n");
+        }
+        else if (!SplittedCommand.at(2).compare("commit"))
+        {
+            if (!g_EventsBatch.IsActive)
+            {
+                ShowMessages("err, the events are not queued, use 'events batch begin'\n");
+                return;
+            }
+
+            DebuggerEventsBatchCommit();
+        }
+        else if (!SplittedCommand.at(2).compare("abort"))
+        {
+            DebuggerEventsBatchAbort();
+        }
+        else
+        {
+            ShowMessages("please specify 'begin', 'commit', or 'abort' for the batch of events\n\n");
+            CommandEventsHelp();
+        }
+
+        //
+        // No need to further continue
+        //
+        return;
+    }
     else
     {
         //
@@ -170,18 +292,19 @@ CommandEvents(vector<string> SplittedCommand, string Command)
     //
     // Perform event related tasks
     //
-    CommandEventsModifyAndQueryEvents(RequestedTag, RequestedAction);
+    CommandEventsModifyAndQueryEvents(RequestedTag, RequestedAction, NULL);
 }
 
 /**
  * @brief Check the kernel whether the event is enabled or disabled
  *
  * @param Tag the tag of the target event
+ * @param ScriptStatistics The cost of the scripts of the event
  * @return BOOLEAN if the event was enabled and false if event was
  * disabled
  */
 BOOLEAN
-CommandEventQueryEventState(UINT64 Tag)
+CommandEventQueryEventState(UINT64 Tag, PDEBUGGER_EVENT_SCRIPT_STATISTICS ScriptStatistics)
 {
     BOOLEAN IsEnabled;
 
@@ -193,7 +316,8 @@ CommandEventQueryEventState(UINT64 Tag)
         if (KdSendEventQueryAndModifyPacketToDebuggee(
                 Tag,
                 DEBUGGER_MODIFY_EVENTS_QUERY_STATE,
-                &IsEnabled))
+                &IsEnabled,
+                ScriptStatistics))
         {
             return IsEnabled;
         }
@@ -210,7 +334,8 @@ CommandEventQueryEventState(UINT64 Tag)
         //
         return CommandEventsModifyAndQueryEvents(
             Tag,
-            DEBUGGER_MODIFY_EVENTS_QUERY_STATE);
+            DEBUGGER_MODIFY_EVENTS_QUERY_STATE,
+            ScriptStatistics);
     }
     //
     // By default, disabled, even if there was an error
@@ -230,8 +355,9 @@ CommandEventsShowEvents()
     // It's an events without any argument so we have to show
     // all the currently active events
     //
-    PLIST_ENTRY TempList         = 0;
-    BOOLEAN     IsThereAnyEvents = FALSE;
+    PLIST_ENTRY                      TempList         = 0;
+    BOOLEAN                          IsThereAnyEvents = FALSE;
+    DEBUGGER_EVENT_SCRIPT_STATISTICS ScriptStatistics;
 
     TempList = &g_EventTrace;
     while (&g_EventTrace != TempList->Blink)
@@ -255,14 +381,31 @@ CommandEventsShowEvents()
             CommandMessage += "...";
         }
 
+        RtlZeroMemory(&ScriptStatistics, sizeof(DEBUGGER_EVENT_SCRIPT_STATISTICS));
+
         ShowMessages("%x\t(%s)\t    %s\n",
                      CommandDetail->Tag - DebuggerEventTagStartSeed,
                      // CommandDetail->IsEnabled ? "enabled" : "disabled",
-                     CommandEventQueryEventState(CommandDetail->Tag)
+                     CommandEventQueryEventState(CommandDetail->Tag, &ScriptStatistics)
                          ? "enabled"
                          : "disabled", /* Query is live now */
                      CommandMessage.c_str());
 
+        //
+        // Show the cost of the scripts of the event
+        //
+        if (ScriptStatistics.Invocations != 0)
+        {
+            ShowMessages("\t\t    script runs: %llx, total cycles: %llx, average cycles: %llx, "
+                         "max cycles: %llx, instructions: %llx, aborted runs: %llx\n",
+                         ScriptStatistics.Invocations,
+                         ScriptStatistics.TotalTsc,
+                         ScriptStatistics.TotalTsc / ScriptStatistics.Invocations,
+                         ScriptStatistics.MaximumTsc,
+                         ScriptStatistics.Instructions,
+                         ScriptStatistics.AbortedRuns);
+        }
+
         if (!IsThereAnyEvents)
         {
             IsThereAnyEvents = TRUE;
@@ -275,6 +418,157 @@ CommandEventsShowEvents()
     }
 }
 
+/**
+ * @brief Show the hit statistics of all of the events
+ * @details the statistics of all of the events are received in one query,
+ * the most hit events are shown first
+ *
+ * @param Reset Whether the counters are reset after querying or not
+ * @return VOID
+ */
+VOID
+CommandEventsShowStatistics(BOOLEAN Reset)
+{
+    BOOL                               Status;
+    ULONG                              ReturnedLength;
+    PDEBUGGER_QUERY_EVENTS_STATISTICS  StatisticsRequest;
+    PLIST_ENTRY                        TempList;
+    UINT32                             Count;
+    vector<PDEBUGGER_EVENT_STATISTICS> Entries;
+
+    if (!g_IsSerialConnectedToRemoteDebuggee)
+    {
+        AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+    }
+
+    StatisticsRequest = (PDEBUGGER_QUERY_EVENTS_STATISTICS)malloc(SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS);
+
+    if (StatisticsRequest == NULL)
+    {
+        ShowMessages("unable to allocate memory\n\n");
+        return;
+    }
+
+    RtlZeroMemory(StatisticsRequest, SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS);
+
+    StatisticsRequest->Reset = Reset;
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        //
+        // It's a remote debugger in Debugger Mode
+        //
+        if (!KdSendQueryEventsStatisticsPacketToDebuggee(StatisticsRequest))
+        {
+            ShowMessages("err, unable to get the statistics of the events\n");
+            free(StatisticsRequest);
+            return;
+        }
+    }
+    else
+    {
+        Status = DeviceIoControl(
+            g_DeviceHandle,                          // Handle to device
+            IOCTL_QUERY_EVENTS_STATISTICS,           // IO Control code
+            StatisticsRequest,                       // Input Buffer to driver.
+            SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS, // Input buffer length
+            StatisticsRequest,                       // Output Buffer from driver.
+            SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS, // Length of output buffer in
+                                                     // bytes.
+            &ReturnedLength,                         // Bytes placed in buffer.
+            NULL                                     // synchronous call
+        );
+
+        if (!Status)
+        {
+            ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+            free(StatisticsRequest);
+            return;
+        }
+    }
+
+    if (StatisticsRequest->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(StatisticsRequest->KernelStatus);
+        free(StatisticsRequest);
+        return;
+    }
+
+    Count = min(StatisticsRequest->CountOfEvents, MaximumEventsStatisticsToQuery);
+
+    if (Count == 0)
+    {
+        ShowMessages("no active/disabled events \n");
+        free(StatisticsRequest);
+        return;
+    }
+
+    //
+    // The most hit events are shown first
+    //
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        Entries.push_back(&StatisticsRequest->Events[i]);
+    }
+
+    std::sort(Entries.begin(), Entries.end(), [](PDEBUGGER_EVENT_STATISTICS A, PDEBUGGER_EVENT_STATISTICS B) {
+        return A->Hits > B->Hits;
+    });
+
+    ShowMessages("id   state      hits              condition passes  script cycles     last hit (tsc)    command\n");
+
+    for (auto Entry : Entries)
+    {
+        string CommandMessage;
+
+        //
+        // Find the command of the event
+        //
+        TempList = &g_EventTrace;
+        while (g_EventTraceInitialized && &g_EventTrace != TempList->Blink)
+        {
+            TempList = TempList->Blink;
+
+            PDEBUGGER_GENERAL_EVENT_DETAIL CommandDetail = CONTAINING_RECORD(TempList, DEBUGGER_GENERAL_EVENT_DETAIL, CommandsEventList);
+
+            if (CommandDetail->Tag == Entry->Tag)
+            {
+                CommandMessage = (char *)CommandDetail->CommandStringBuffer;
+                break;
+            }
+        }
+
+        ReplaceAll(CommandMessage, "\n", " ");
+
+        if (CommandMessage.length() > 40)
+        {
+            CommandMessage = CommandMessage.substr(0, 40);
+            CommandMessage += "...";
+        }
+
+        ShowMessages("%-4llx %-9s  %016llx  %016llx  %016llx  %016llx  %s\n",
+                     Entry->Tag - DebuggerEventTagStartSeed,
+                     Entry->IsEnabled ? "enabled" : "disabled",
+                     Entry->Hits,
+                     Entry->ConditionPasses,
+                     Entry->ScriptTsc,
+                     Entry->LastHitTsc,
+                     CommandMessage.c_str());
+    }
+
+    if (StatisticsRequest->TotalCountOfEvents > Count)
+    {
+        ShowMessages("only %x of %x events are shown\n", Count, StatisticsRequest->TotalCountOfEvents);
+    }
+
+    if (Reset)
+    {
+        ShowMessages("the statistics of the events are reset\n");
+    }
+
+    free(StatisticsRequest);
+}
+
 /**
  * @brief Disable a special event
  *
@@ -604,11 +898,13 @@ CommandEventsHandleModifiedEvent(
                 }
             }
         }
-        else if (ModifyEventRequest->TypeOfAction ==
-                 DEBUGGER_MODIFY_EVENTS_QUERY_STATE)
+        else if (ModifyEventRequest->TypeOfAction == DEBUGGER_MODIFY_EVENTS_QUERY_STATE ||
+                 ModifyEventRequest->TypeOfAction == DEBUGGER_MODIFY_EVENTS_ADD_MONITOR_RANGE ||
+                 ModifyEventRequest->TypeOfAction == DEBUGGER_MODIFY_EVENTS_REMOVE_MONITOR_RANGE)
         {
             //
-            // Nothing to show
+            // Nothing to show (the user-mode structures don't hold the
+            // ranges of the monitor events)
             //
         }
         else
@@ -637,11 +933,14 @@ CommandEventsHandleModifiedEvent(
  *
  * @param Tag the tag of the target event
  * @param TypeOfAction whether its a enable/disable/clear
+ * @param ScriptStatistics The cost of the scripts of the event (optional,
+ * only for query state)
  * @return BOOLEAN Shows whether the event is enabled or disabled
  */
 BOOLEAN
-CommandEventsModifyAndQueryEvents(UINT64                      Tag,
-                                  DEBUGGER_MODIFY_EVENTS_TYPE TypeOfAction)
+CommandEventsModifyAndQueryEvents(UINT64                            Tag,
+                                  DEBUGGER_MODIFY_EVENTS_TYPE       TypeOfAction,
+                                  PDEBUGGER_EVENT_SCRIPT_STATISTICS ScriptStatistics)
 {
     BOOLEAN                Status;
     ULONG                  ReturnedLength;
@@ -674,7 +973,7 @@ CommandEventsModifyAndQueryEvents(UINT64                      Tag,
         //
         // Remote debuggee Debugger Mode
         //
-        KdSendEventQueryAndModifyPacketToDebuggee(Tag, TypeOfAction, NULL);
+        KdSendEventQueryAndModifyPacketToDebuggee(Tag, TypeOfAction, NULL, NULL);
     }
     else
     {
@@ -721,6 +1020,11 @@ CommandEventsModifyAndQueryEvents(UINT64                      Tag,
 
         if (TypeOfAction == DEBUGGER_MODIFY_EVENTS_QUERY_STATE)
         {
+            if (ScriptStatistics != NULL)
+            {
+                *ScriptStatistics = ModifyEventRequest.ScriptStatistics;
+            }
+
             return ModifyEventRequest.IsEnabled;
         }
     }
@@ -731,3 +1035,91 @@ CommandEventsModifyAndQueryEvents(UINT64                      Tag,
     //
     return TRUE;
 }
+
+/**
+ * @brief Add or remove a range of a monitor event
+ * @details the pages of the range are hooked (or unhooked) in the kernel
+ *
+ * @param Tag the tag of the target event
+ * @param TypeOfAction whether the range is added or removed
+ * @param RangeStart Start of the range (virtual address)
+ * @param RangeEnd End of the range (virtual address, exclusive)
+ * @return BOOLEAN whether the range is modified or not
+ */
+BOOLEAN
+CommandEventsModifyMonitorRange(UINT64                      Tag,
+                                DEBUGGER_MODIFY_EVENTS_TYPE TypeOfAction,
+                                UINT64                      RangeStart,
+                                UINT64                      RangeEnd)
+{
+    BOOLEAN                Status;
+    ULONG                  ReturnedLength;
+    DEBUGGER_MODIFY_EVENTS ModifyEventRequest = {0};
+
+    if (!IsTagExist(Tag) || Tag == DEBUGGER_MODIFY_EVENTS_APPLY_TO_ALL_TAG)
+    {
+        ShowMessages("err, tag id is invalid\n");
+        return FALSE;
+    }
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        //
+        // Remote debuggee Debugger Mode
+        //
+        return KdSendModifyMonitorRangePacketToDebuggee(Tag, TypeOfAction, RangeStart, RangeEnd);
+    }
+
+    //
+    // Local debugging VMI-Mode
+    //
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    ModifyEventRequest.Tag          = Tag;
+    ModifyEventRequest.TypeOfAction = TypeOfAction;
+    ModifyEventRequest.RangeStart   = RangeStart;
+    ModifyEventRequest.RangeEnd     = RangeEnd;
+
+    Status = DeviceIoControl(g_DeviceHandle,                // Handle to device
+                             IOCTL_DEBUGGER_MODIFY_EVENTS,  // IO Control code
+                             &ModifyEventRequest,           // Input Buffer to driver.
+                             SIZEOF_DEBUGGER_MODIFY_EVENTS, // Input buffer length
+                             &ModifyEventRequest,           // Output Buffer from driver.
+                             SIZEOF_DEBUGGER_MODIFY_EVENTS, // Length of output
+                                                            // buffer in bytes.
+                             &ReturnedLength,               // Bytes placed in buffer.
+                             NULL                           // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        return FALSE;
+    }
+
+    if (ModifyEventRequest.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(ModifyEventRequest.KernelStatus);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Add or remove a range of a monitor event (used by the SDK)
+ *
+ * @param Tag The tag of the event (returned by registering the event)
+ * @param IsAdd Whether the range is added or removed
+ * @param StartAddress Start of the range (virtual address)
+ * @param EndAddress End of the range (virtual address, exclusive)
+ * @return BOOLEAN whether the range is modified or not
+ */
+BOOLEAN
+HyperDbgModifyMonitorRange(UINT64 Tag, BOOLEAN IsAdd, UINT64 StartAddress, UINT64 EndAddress)
+{
+    return CommandEventsModifyMonitorRange(Tag,
+                                           IsAdd ? DEBUGGER_MODIFY_EVENTS_ADD_MONITOR_RANGE : DEBUGGER_MODIFY_EVENTS_REMOVE_MONITOR_RANGE,
+                                           StartAddress,
+                                           EndAddress);
+}
@@ -14,7 +14,8 @@
 //
 // Global Variables
 //
-extern HANDLE g_DeviceHandle;
+extern HANDLE  g_DeviceHandle;
+extern BOOLEAN g_LogOpened;
 
 /**
  * @brief help of exit command
@@ -38,8 +39,11 @@ CommandExitHelp()
  * @return VOID
  */
 VOID
-CommandExit(vector<string> SplittedCommand, string Command)
+CommandExit(vector<string> & SplittedCommand, string & Command)
 {
+    UINT64 RecordsCount  = 0;
+    UINT64 FailedRecords = 0;
+
     if (SplittedCommand.size() != 1)
     {
         ShowMessages("incorrect use of 'exit'\n\n");
@@ -55,5 +59,27 @@ CommandExit(vector<string> SplittedCommand, string Command)
         HyperDbgUnloadVmm();
     }
 
+    //
+    // Show the remaining messages of events
+    //
+    MessageLanesUninitialize();
+
+    //
+    // Write the remaining records of the recording of events (if any)
+    //
+    if (EventReplayIsRecording())
+    {
+        EventReplayStopRecording(&RecordsCount, &FailedRecords);
+    }
+
+    //
+    // Write the buffered messages of the log file (if any)
+    //
+    if (g_LogOpened)
+    {
+        g_LogOpened = FALSE;
+        LogopenCloseFile();
+    }
+
     exit(0);
 }
@@ -106,7 +106,7 @@ CommandFlushRequestFlush()
  * @return VOID
  */
 VOID
-CommandFlush(vector<string> SplittedCommand, string Command)
+CommandFlush(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() != 1)
     {
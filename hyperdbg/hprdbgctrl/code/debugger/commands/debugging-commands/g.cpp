@@ -30,6 +30,79 @@ CommandGHelp()
     ShowMessages("g : continues debuggee or continues processing kernel messages.\n\n");
 
     ShowMessages("syntax : \tg \n");
+    ShowMessages("syntax : \tg [ThreadId (hex)]*\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : g\n");
+    ShowMessages("\t\te.g : g 1a4c 1f20 2b08\n");
+
+    ShowMessages("\n");
+    ShowMessages("continuing specific threads is only supported in the user debugger, "
+                 "all of the thread ids are sent in a single request\n");
+}
+
+/**
+ * @brief Continue a set of the paused threads of the user debugger
+ *
+ * @param SplittedCommand
+ * @return VOID
+ */
+VOID
+CommandGContinueThreads(vector<string> SplittedCommand)
+{
+    vector<DEBUGGER_UD_BATCH_COMMAND_ENTRY> Entries;
+    DEBUGGER_UD_BATCH_COMMAND_ENTRY         Entry;
+    UINT32                                  ThreadId;
+    UINT32                                  CountOfAppliedEntries;
+
+    if (!g_ActiveProcessDebuggingState.IsActive)
+    {
+        ShowMessages("err, continuing specific threads is only supported in the user debugger\n");
+        return;
+    }
+
+    for (size_t i = 1; i < SplittedCommand.size(); i++)
+    {
+        if (!ConvertStringToUInt32(SplittedCommand.at(i), &ThreadId))
+        {
+            ShowMessages("please specify a correct hex value for the thread id (%s)\n\n",
+                         SplittedCommand.at(i).c_str());
+            CommandGHelp();
+            return;
+        }
+
+        RtlZeroMemory(&Entry, sizeof(DEBUGGER_UD_BATCH_COMMAND_ENTRY));
+
+        Entry.TargetThreadId      = ThreadId;
+        Entry.UdAction.ActionType = DEBUGGER_UD_COMMAND_ACTION_TYPE_CONTINUE;
+
+        Entries.push_back(Entry);
+    }
+
+    CountOfAppliedEntries = UdSendBatchCommand(g_ActiveProcessDebuggingState.ProcessDebuggingToken,
+                                               Entries.data(),
+                                               (UINT32)Entries.size());
+
+    for (auto & Item : Entries)
+    {
+        if (Item.Result == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+        {
+            //
+            // The active thread is running
+            //
+            if (Item.TargetThreadId == g_ActiveProcessDebuggingState.ThreadId)
+            {
+                g_ActiveProcessDebuggingState.IsPaused = FALSE;
+            }
+        }
+        else if (Item.Result != 0)
+        {
+            ShowMessages("thread %x : ", Item.TargetThreadId);
+            ShowErrorMessage(Item.Result);
+        }
+    }
+
+    ShowMessages("%x of %x thread(s) are continued\n", CountOfAppliedEntries, (UINT32)Entries.size());
 }
 
 /**
@@ -90,12 +163,14 @@ CommandGRequest()
  * @return VOID
  */
 VOID
-CommandG(vector<string> SplittedCommand, string Command)
+CommandG(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() != 1)
     {
-        ShowMessages("incorrect use of 'g'\n\n");
-        CommandGHelp();
+        //
+        // Continue the specified threads of the user debugger
+        //
+        CommandGContinueThreads(SplittedCommand);
         return;
     }
 
@@ -0,0 +1,84 @@
+/**
+ * @file gi.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief gi command
+ * @details
+ * @version 0.4
+ * @date 2023-08-13
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+extern BOOLEAN g_IsDebuggeeRunning;
+
+/**
+ * @brief help of gi command
+ *
+ * @return VOID
+ */
+VOID
+CommandGiHelp()
+{
+    ShowMessages("gi : continues the debuggee and pauses it once a count of instructions "
+                 "are executed on the current core.\n\n");
+
+    ShowMessages("syntax : \tgi [Count (hex)]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : gi 1000\n");
+    ShowMessages("\t\te.g : gi 5f5e100\n");
+
+    ShowMessages("\n");
+    ShowMessages("the instructions of the guest (both user-mode and kernel-mode, including "
+                 "the interrupt handlers) are counted by the performance counter of the retired "
+                 "instructions and the last %x instructions are stepped one by one, other "
+                 "cores continue normally (kernel debugger only)\n",
+                 DEBUGGEE_INSTRUCTION_BUDGET_STEPPED_INSTRUCTIONS);
+}
+
+/**
+ * @brief handler of gi command
+ *
+ * @param SplittedCommand
+ * @param Command
+ * @return VOID
+ */
+VOID
+CommandGi(vector<string> & SplittedCommand, string & Command)
+{
+    UINT64 CountOfInstructions;
+
+    if (SplittedCommand.size() != 2)
+    {
+        ShowMessages("incorrect use of 'gi'\n\n");
+        CommandGiHelp();
+        return;
+    }
+
+    if (!ConvertStringToUInt64(SplittedCommand.at(1), &CountOfInstructions) || CountOfInstructions == 0)
+    {
+        ShowMessages("please specify a correct hex value for [count]\n\n");
+        CommandGiHelp();
+        return;
+    }
+
+    if (!g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, running a count of instructions is only supported in the Debugger Mode\n");
+        return;
+    }
+
+    if (g_IsDebuggeeRunning)
+    {
+        ShowMessages("err, the debuggee is already running\n");
+        return;
+    }
+
+    KdSendInstructionBudgetPacketToDebuggee(CountOfInstructions);
+}
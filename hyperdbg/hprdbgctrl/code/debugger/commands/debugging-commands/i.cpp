@@ -37,11 +37,19 @@ CommandIHelp()
     ShowMessages("syntax : \ti [Count (hex)]\n");
     ShowMessages("syntax : \tir\n");
     ShowMessages("syntax : \tir [Count (hex)]\n");
+    ShowMessages("syntax : \ti trace [Count (hex)] [Register (string)]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : i\n");
     ShowMessages("\t\te.g : ir\n");
     ShowMessages("\t\te.g : ir 1f\n");
+    ShowMessages("\t\te.g : i trace 186a0\n");
+    ShowMessages("\t\te.g : i trace 186a0 @rax\n");
+
+    ShowMessages("\n");
+    ShowMessages("the 'trace' performs all of the steps in the debuggee "
+                 "and shows the RIP after each step, optionally along with the value of "
+                 "the register\n");
 }
 
 /**
@@ -52,11 +60,25 @@ CommandIHelp()
  * @return VOID
  */
 VOID
-CommandI(vector<string> SplittedCommand, string Command)
+CommandI(vector<string> & SplittedCommand, string & Command)
 {
     UINT32                           StepCount;
     DEBUGGER_REMOTE_STEPPING_REQUEST RequestFormat;
 
+    //
+    // Check if the steps should be traced in the debuggee
+    //
+    if (SplittedCommand.size() >= 2 && !SplittedCommand.at(0).compare("i") && !SplittedCommand.at(1).compare("trace"))
+    {
+        if (!CommandTraceSteps(SplittedCommand, DEBUGGER_REMOTE_STEPPING_REQUEST_INSTRUMENTATION_STEP_IN))
+        {
+            ShowMessages("incorrect use of 'i'\n\n");
+            CommandIHelp();
+        }
+
+        return;
+    }
+
     //
     // Validate the commands
     //
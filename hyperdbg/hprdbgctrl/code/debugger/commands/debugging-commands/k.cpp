@@ -52,7 +52,7 @@ CommandKHelp()
  * @return VOID
  */
 VOID
-CommandK(vector<string> SplittedCommand, string Command)
+CommandK(vector<string> & SplittedCommand, string & Command)
 {
     UINT64         BaseAddress = NULL;  // Null base address means current RSP register
     UINT32         Length      = 0x100; // Default length
@@ -337,7 +337,7 @@ CommandLmShowKernelModeModule(const char * SearchModule)
  * @return VOID
  */
 VOID
-CommandLm(vector<string> SplittedCommand, string Command)
+CommandLm(vector<string> & SplittedCommand, string & Command)
 {
     BOOLEAN SetPid                = FALSE;
     BOOLEAN SetSearchFilter       = FALSE;
@@ -90,6 +90,50 @@ CommandLoadReversingMachineModule()
     return TRUE;
 }
 
+/**
+ * @brief show the duration of the phases of initializing the hypervisor
+ *
+ * @return VOID
+ */
+VOID
+CommandLoadShowVmmInitializationTimings()
+{
+    BOOL                                Status;
+    ULONG                               ReturnedLength;
+    DEBUGGER_VMM_INITIALIZATION_TIMINGS Timings = {0};
+
+    Status = DeviceIoControl(
+        g_DeviceHandle,                             // Handle to device
+        IOCTL_QUERY_VMM_INITIALIZATION_TIMINGS,     // IO Control code
+        &Timings,                                   // Input Buffer to driver.
+        SIZEOF_DEBUGGER_VMM_INITIALIZATION_TIMINGS, // Input buffer length
+        &Timings,                                   // Output Buffer from driver.
+        SIZEOF_DEBUGGER_VMM_INITIALIZATION_TIMINGS, // Length of output buffer in
+                                                    // bytes.
+        &ReturnedLength,                            // Bytes placed in buffer.
+        NULL                                        // synchronous call
+    );
+
+    if (!Status || Timings.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        //
+        // Not important, the timings are just not shown
+        //
+        return;
+    }
+
+    ShowMessages("vmm initialized on %d cores in %lld us\n", Timings.CountOfCores, Timings.Total);
+    ShowMessages("\tcompatibility checks   : %lld us\n", Timings.CompatibilityChecks);
+    ShowMessages("\tguest state allocation : %lld us\n", Timings.GuestStateAllocation);
+    ShowMessages("\tmemory mapper          : %lld us\n", Timings.MemoryMapper);
+    ShowMessages("\tept memory map (mtrrs) : %lld us\n", Timings.EptMemoryMap);
+    ShowMessages("\tpool manager           : %lld us\n", Timings.PoolManager);
+    ShowMessages("\tept page tables        : %lld us\n", Timings.EptPageTables);
+    ShowMessages("\tper-core regions       : %lld us (slowest core : %lld us)\n", Timings.PerCoreRegions, Timings.SlowestCoreRegions);
+    ShowMessages("\tinvalid msrs bitmap    : %lld us\n", Timings.InvalidMsrsBitmap);
+    ShowMessages("\tlaunching guests       : %lld us\n", Timings.GuestLaunch);
+}
+
 /**
  * @brief load vmm module
  *
@@ -163,6 +207,8 @@ CommandLoadVmmModule()
 
     ShowMessages("vmm module is running...\n");
 
+    CommandLoadShowVmmInitializationTimings();
+
     return TRUE;
 }
 
@@ -174,7 +220,7 @@ CommandLoadVmmModule()
  * @return VOID
  */
 VOID
-CommandLoad(vector<string> SplittedCommand, string Command)
+CommandLoad(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() != 2)
     {
@@ -14,8 +14,9 @@
 //
 // Global Variables
 //
-extern LIST_ENTRY g_OutputSources;
-extern BOOLEAN    g_OutputSourcesInitialized;
+extern LIST_ENTRY                         g_OutputSources;
+extern BOOLEAN                            g_OutputSourcesInitialized;
+extern EVENT_FORWARDING_LATENCY_HISTOGRAM g_EventForwardingLatency[EVENT_FORWARDING_LATENCY_STAGES_COUNT];
 
 /**
  * @brief help of output command
@@ -28,8 +29,17 @@ CommandOutputHelp()
     ShowMessages("output : creates an output instance that can be used in event "
                  "forwarding.\n\n");
 
-    ShowMessages("syntax : \toutput [create Name (string)] [file|namedpipe|tcp Address (string)]\n");
+    ShowMessages("syntax : \toutput [create Name (string)] [file|binary|namedpipe|sharedmemory|tcp Address (string)]\n");
     ShowMessages("syntax : \toutput [open|close Name (string)]\n");
+    ShowMessages("syntax : \toutput [policy Name (string)] [block|drop-oldest|sample]\n");
+    ShowMessages("syntax : \toutput [filter Name (string)] [prefix|regex Text (string)]\n");
+    ShowMessages("syntax : \toutput [filter Name (string)] [core CoreId (hex)]\n");
+    ShowMessages("syntax : \toutput [filter Name (string)] [sample|ratelimit Count (hex)]\n");
+    ShowMessages("syntax : \toutput [filter Name (string)] [mute|unmute|clear]\n");
+    ShowMessages("syntax : \toutput [status] [reset]\n");
+    ShowMessages("syntax : \toutput [record Path (string)]\n");
+    ShowMessages("syntax : \toutput [record stop]\n");
+    ShowMessages("syntax : \toutput [replay Name (string)] [recorded|max] [Path (string)]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : output create MyOutputName1 file "
@@ -37,8 +47,508 @@ CommandOutputHelp()
     ShowMessages("\t\te.g : output create MyOutputName2 tcp 192.168.1.10:8080\n");
     ShowMessages("\t\te.g : output create MyOutputName3 namedpipe "
                  "\\\\.\\Pipe\\HyperDbgOutput\n");
+    ShowMessages("\t\te.g : output create MyOutputName4 binary "
+                 "c:\\users\\sina\\desktop\\output.bin\n");
+    ShowMessages("\t\te.g : output create MyOutputName5 sharedmemory "
+                 "Local\\HyperDbgOutput\n");
     ShowMessages("\t\te.g : output open MyOutputName1\n");
     ShowMessages("\t\te.g : output close MyOutputName1\n");
+    ShowMessages("\t\te.g : output policy MyOutputName2 drop-oldest\n");
+    ShowMessages("\t\te.g : output filter MyOutputName1 prefix [syscall]\n");
+    ShowMessages("\t\te.g : output filter MyOutputName1 regex pid: (4|1c8)\n");
+    ShowMessages("\t\te.g : output filter MyOutputName4 core 2\n");
+    ShowMessages("\t\te.g : output filter MyOutputName2 sample 10\n");
+    ShowMessages("\t\te.g : output filter MyOutputName2 ratelimit 3e8\n");
+    ShowMessages("\t\te.g : output filter MyOutputName2 mute\n");
+    ShowMessages("\t\te.g : output status\n");
+    ShowMessages("\t\te.g : output status reset\n");
+    ShowMessages("\t\te.g : output record c:\\users\\sina\\desktop\\events.bin\n");
+    ShowMessages("\t\te.g : output record stop\n");
+    ShowMessages("\t\te.g : output replay MyOutputName2 max c:\\users\\sina\\desktop\\events.bin\n");
+
+    ShowMessages("\n");
+    ShowMessages("messages are queued and written to the output by a separate thread, "
+                 "the policy decides what happens once the queue of the output is full:\n");
+    ShowMessages("\tblock       : wait for the queued messages to be written (default)\n");
+    ShowMessages("\tdrop-oldest : drop the oldest queued message\n");
+    ShowMessages("\tsample      : once the queue is half full, only queue one of each %d messages\n",
+                 EVENT_FORWARDING_SAMPLING_RATE);
+
+    ShowMessages("\n");
+    ShowMessages("filters are checked before the message is queued: prefix (the message starts with "
+                 "the text), regex (the message contains a match of the pattern), core (only for binary "
+                 "trace records), sample (one of each Count messages), ratelimit (Count messages per "
+                 "second), a muted output doesn't receive any message and if all the outputs of an event "
+                 "are muted (or not opened), the messages of the event are not generated in the kernel\n");
+
+    ShowMessages("\n");
+    ShowMessages("status shows the latency (p50 and p99) of delivering the messages of events that are "
+                 "triggered in vmx-root to the outputs: kernel buffer (saved till read from the kernel "
+                 "buffer), ioctl drain (read from the kernel buffer till received by the debugger), "
+                 "forwarding queue (queued till written to the output) and end-to-end (the event is "
+                 "triggered till written to the output)\n");
+
+    ShowMessages("\n");
+    ShowMessages("binary outputs save the structured records of messages (tag, core, pid, tid, "
+                 "tsc and values of printf in the binary trace mode) in compressed blocks, "
+                 "the index of the blocks is written once the output is closed\n");
+
+    ShowMessages("\n");
+    ShowMessages("sharedmemory outputs copy the messages to a ring in a named file mapping "
+                 "(the header of the ring contains the head and tail indexes and the name "
+                 "of the event which is signaled for new messages), messages are dropped "
+                 "if the reader doesn't keep up\n");
+
+    ShowMessages("\n");
+    ShowMessages("record saves the messages of all the events with their time-stamp counters "
+                 "in the binary format (stop it before replaying the recording), replay forwards "
+                 "the recorded messages to an opened output in the recorded speed (the gaps between "
+                 "the messages are kept) or in the maximum speed, without a debuggee, press CTRL+C "
+                 "to stop the replay\n");
+}
+
+/**
+ * @brief Set a filter of an output source ('output filter')
+ *
+ * @param SplittedCommand
+ * @param SplittedCommandCaseSensitive
+ * @param Command
+ * @return VOID
+ */
+static VOID
+CommandOutputSetFilter(vector<string> & SplittedCommand, vector<string> & SplittedCommandCaseSensitive, string & Command)
+{
+    PDEBUGGER_EVENT_FORWARDING OutputSource = NULL;
+    PLIST_ENTRY                TempList     = 0;
+    std::regex *               Regex        = NULL;
+    string                     Text;
+    size_t                     TextPosition;
+    UINT32                     Value = 0;
+
+    if (SplittedCommand.size() < 4)
+    {
+        ShowMessages("incorrect use of 'output'\n\n");
+        CommandOutputHelp();
+        return;
+    }
+
+    if (g_OutputSourcesInitialized)
+    {
+        TempList = &g_OutputSources;
+
+        while (&g_OutputSources != TempList->Flink)
+        {
+            TempList = TempList->Flink;
+
+            PDEBUGGER_EVENT_FORWARDING CurrentOutputSourceDetails = CONTAINING_RECORD(
+                TempList,
+                DEBUGGER_EVENT_FORWARDING,
+                OutputSourcesList);
+
+            if (strcmp(CurrentOutputSourceDetails->Name,
+                       SplittedCommandCaseSensitive.at(2).c_str()) == 0)
+            {
+                OutputSource = CurrentOutputSourceDetails;
+                break;
+            }
+        }
+    }
+
+    if (OutputSource == NULL)
+    {
+        ShowMessages("err, the name you entered, not found\n");
+        return;
+    }
+
+    if (!SplittedCommand.at(3).compare("prefix") || !SplittedCommand.at(3).compare("regex"))
+    {
+        if (SplittedCommand.size() < 5)
+        {
+            ShowMessages("incorrect use of 'output'\n\n");
+            CommandOutputHelp();
+            return;
+        }
+
+        //
+        // The text is case-sensitive and might contain spaces
+        //
+        TextPosition = Command.find(SplittedCommandCaseSensitive.at(3),
+                                    Command.find(SplittedCommandCaseSensitive.at(2)) + SplittedCommandCaseSensitive.at(2).size());
+        Text         = Command.substr(TextPosition + SplittedCommandCaseSensitive.at(3).size() + 1);
+
+        if (!SplittedCommand.at(3).compare("prefix"))
+        {
+            if (Text.size() >= EVENT_FORWARDING_FILTER_MAXIMUM_PREFIX)
+            {
+                ShowMessages("err, the prefix cannot exceed form %d characters\n",
+                             EVENT_FORWARDING_FILTER_MAXIMUM_PREFIX);
+                return;
+            }
+        }
+        else
+        {
+            try
+            {
+                Regex = new std::regex(Text, std::regex::optimize);
+            }
+            catch (const std::regex_error & Error)
+            {
+                ShowMessages("err, invalid regular expression (%s)\n", Error.what());
+                return;
+            }
+        }
+    }
+    else if (!SplittedCommand.at(3).compare("core") ||
+             !SplittedCommand.at(3).compare("sample") ||
+             !SplittedCommand.at(3).compare("ratelimit"))
+    {
+        if (SplittedCommand.size() != 5 || !ConvertStringToUInt32(SplittedCommand.at(4), &Value))
+        {
+            ShowMessages("incorrect use of 'output'\n\n");
+            CommandOutputHelp();
+            return;
+        }
+    }
+    else if (SplittedCommand.size() != 4 ||
+             (SplittedCommand.at(3).compare("mute") &&
+              SplittedCommand.at(3).compare("unmute") &&
+              SplittedCommand.at(3).compare("clear")))
+    {
+        ShowMessages("incorrect filter near '%s'\n\n", SplittedCommand.at(3).c_str());
+        CommandOutputHelp();
+        return;
+    }
+
+    //
+    // Apply the filter while the messages are not checked
+    //
+    AcquireSRWLockExclusive(&OutputSource->FilterLock);
+
+    if (!SplittedCommand.at(3).compare("prefix"))
+    {
+        strcpy_s(OutputSource->Filter.Prefix, Text.c_str());
+    }
+    else if (!SplittedCommand.at(3).compare("regex"))
+    {
+        std::swap(OutputSource->Filter.Regex, Regex);
+    }
+    else if (!SplittedCommand.at(3).compare("core"))
+    {
+        OutputSource->Filter.CoreId = Value;
+    }
+    else if (!SplittedCommand.at(3).compare("sample"))
+    {
+        OutputSource->Filter.SampleRate    = Value;
+        OutputSource->Filter.SampleCounter = 0;
+    }
+    else if (!SplittedCommand.at(3).compare("ratelimit"))
+    {
+        OutputSource->Filter.RateLimit           = Value;
+        OutputSource->Filter.RateLimitTokens     = Value;
+        OutputSource->Filter.RateLimitRefillTime = GetTickCount64();
+    }
+    else if (!SplittedCommand.at(3).compare("mute"))
+    {
+        OutputSource->Filter.IsMuted = TRUE;
+    }
+    else if (!SplittedCommand.at(3).compare("unmute"))
+    {
+        OutputSource->Filter.IsMuted = FALSE;
+    }
+    else
+    {
+        //
+        // Remove all the filters
+        //
+        std::swap(OutputSource->Filter.Regex, Regex);
+
+        OutputSource->Filter.IsMuted    = FALSE;
+        OutputSource->Filter.CoreId     = EVENT_FORWARDING_FILTER_ANY_CORE;
+        OutputSource->Filter.SampleRate = 0;
+        OutputSource->Filter.RateLimit  = 0;
+        OutputSource->Filter.Prefix[0]  = '\0';
+    }
+
+    ReleaseSRWLockExclusive(&OutputSource->FilterLock);
+
+    //
+    // The previous regular expression (if any)
+    //
+    delete Regex;
+
+    //
+    // Events which only use muted sources don't generate their messages
+    //
+    if (!SplittedCommand.at(3).compare("mute") ||
+        !SplittedCommand.at(3).compare("unmute") ||
+        !SplittedCommand.at(3).compare("clear"))
+    {
+        ForwardingUpdateEventsOutputState();
+    }
+}
+
+/**
+ * @brief Get the frequency of the time-stamp counter
+ * @details the frequency is measured once (against the performance counter)
+ *
+ * @return UINT64 Count of cycles per second (zero if it's not measured)
+ */
+static UINT64
+CommandOutputGetTscFrequency()
+{
+    static UINT64 TscFrequency = 0;
+    LARGE_INTEGER Frequency;
+    LARGE_INTEGER StartCounter;
+    LARGE_INTEGER EndCounter;
+    UINT64        StartTsc;
+    UINT64        EndTsc;
+
+    if (TscFrequency != 0 || !QueryPerformanceFrequency(&Frequency))
+    {
+        return TscFrequency;
+    }
+
+    QueryPerformanceCounter(&StartCounter);
+    StartTsc = __rdtsc();
+
+    Sleep(100);
+
+    QueryPerformanceCounter(&EndCounter);
+    EndTsc = __rdtsc();
+
+    if (EndCounter.QuadPart > StartCounter.QuadPart)
+    {
+        TscFrequency = (UINT64)((double)(EndTsc - StartTsc) * Frequency.QuadPart / (EndCounter.QuadPart - StartCounter.QuadPart));
+    }
+
+    return TscFrequency;
+}
+
+/**
+ * @brief Show the latency of delivering the messages of events to the
+ * output sources ('output status')
+ *
+ * @param SplittedCommand
+ * @return VOID
+ */
+static VOID
+CommandOutputShowStatus(vector<string> & SplittedCommand)
+{
+    UINT64       TscFrequency;
+    UINT64       P50;
+    UINT64       P99;
+    const char * StageNames[EVENT_FORWARDING_LATENCY_STAGES_COUNT] = {"kernel buffer   ",
+                                                                      "ioctl drain     ",
+                                                                      "forwarding queue",
+                                                                      "end-to-end      "};
+
+    if (SplittedCommand.size() == 3 && !SplittedCommand.at(2).compare("reset"))
+    {
+        ForwardingResetLatency();
+        return;
+    }
+
+    if (SplittedCommand.size() != 2)
+    {
+        ShowMessages("incorrect use of 'output'\n\n");
+        CommandOutputHelp();
+        return;
+    }
+
+    TscFrequency = CommandOutputGetTscFrequency();
+
+    ShowMessages("stage              samples            p50 (us)      p99 (us)      p50 (cycles)      p99 (cycles)\n");
+
+    for (UINT32 i = 0; i < EVENT_FORWARDING_LATENCY_STAGES_COUNT; i++)
+    {
+        P50 = ForwardingGetLatencyPercentile((EVENT_FORWARDING_LATENCY_STAGE)i, 50);
+        P99 = ForwardingGetLatencyPercentile((EVENT_FORWARDING_LATENCY_STAGE)i, 99);
+
+        ShowMessages("%s   %-16llx   %-12.2f  %-12.2f  %-16llx  %llx\n",
+                     StageNames[i],
+                     g_EventForwardingLatency[i].Count,
+                     TscFrequency != 0 ? (double)P50 * 1000000 / TscFrequency : 0.0,
+                     TscFrequency != 0 ? (double)P99 * 1000000 / TscFrequency : 0.0,
+                     P50,
+                     P99);
+    }
+}
+
+/**
+ * @brief Start or stop recording the messages of events ('output record')
+ *
+ * @param SplittedCommand
+ * @param SplittedCommandCaseSensitive
+ * @param Command
+ * @return VOID
+ */
+static VOID
+CommandOutputRecord(vector<string> & SplittedCommand, vector<string> & SplittedCommandCaseSensitive, string & Command)
+{
+    string FilePath;
+    UINT64 RecordsCount  = 0;
+    UINT64 FailedRecords = 0;
+
+    if (SplittedCommand.size() == 3 && !SplittedCommand.at(2).compare("stop"))
+    {
+        if (!EventReplayIsRecording())
+        {
+            ShowMessages("err, the messages of events are not recorded\n");
+            return;
+        }
+
+        if (!EventReplayStopRecording(&RecordsCount, &FailedRecords))
+        {
+            ShowMessages("err, unable to write the recording completely\n");
+        }
+
+        ShowMessages("recording is stopped, recorded messages: %llx, failed messages: %llx\n",
+                     RecordsCount,
+                     FailedRecords);
+        return;
+    }
+
+    //
+    // The rest of the command is the path of the recording
+    //
+    FilePath = Command.substr(Command.find(SplittedCommandCaseSensitive.at(1)) + SplittedCommandCaseSensitive.at(1).size() + 1,
+                              Command.size());
+
+    if (EventReplayIsRecording())
+    {
+        ShowMessages("err, the messages of events are already recorded, use 'output record stop' first\n");
+        return;
+    }
+
+    if (!EventReplayStartRecording(FilePath))
+    {
+        ShowMessages("err, unable to create the recording at '%s'\n", FilePath.c_str());
+        return;
+    }
+
+    ShowMessages("recording the messages of events to '%s'\n", FilePath.c_str());
+}
+
+/**
+ * @brief Replay a recording of the messages of events to an output
+ * source ('output replay')
+ *
+ * @param SplittedCommand
+ * @param SplittedCommandCaseSensitive
+ * @param Command
+ * @return VOID
+ */
+static VOID
+CommandOutputReplay(vector<string> & SplittedCommand, vector<string> & SplittedCommandCaseSensitive, string & Command)
+{
+    PDEBUGGER_EVENT_FORWARDING OutputSource = NULL;
+    PLIST_ENTRY                TempList     = 0;
+    BOOLEAN                    RecordedSpeed;
+    string                     FilePath;
+    EVENT_REPLAY_RESULT        Result = {0};
+    BOOLEAN                    IsValid;
+
+    if (SplittedCommand.size() < 5)
+    {
+        ShowMessages("incorrect use of 'output'\n\n");
+        CommandOutputHelp();
+        return;
+    }
+
+    if (!SplittedCommand.at(3).compare("recorded"))
+    {
+        RecordedSpeed = TRUE;
+    }
+    else if (!SplittedCommand.at(3).compare("max"))
+    {
+        RecordedSpeed = FALSE;
+    }
+    else
+    {
+        ShowMessages("incorrect speed near '%s'\n\n", SplittedCommand.at(3).c_str());
+        CommandOutputHelp();
+        return;
+    }
+
+    if (g_OutputSourcesInitialized)
+    {
+        TempList = &g_OutputSources;
+
+        while (&g_OutputSources != TempList->Flink)
+        {
+            TempList = TempList->Flink;
+
+            PDEBUGGER_EVENT_FORWARDING CurrentOutputSourceDetails = CONTAINING_RECORD(
+                TempList,
+                DEBUGGER_EVENT_FORWARDING,
+                OutputSourcesList);
+
+            if (strcmp(CurrentOutputSourceDetails->Name,
+                       SplittedCommandCaseSensitive.at(2).c_str()) == 0)
+            {
+                OutputSource = CurrentOutputSourceDetails;
+                break;
+            }
+        }
+    }
+
+    if (OutputSource == NULL)
+    {
+        ShowMessages("err, the name you entered, not found\n");
+        return;
+    }
+
+    if (OutputSource->State != EVENT_FORWARDING_STATE_OPENED)
+    {
+        ShowMessages("err, the output should be opened before replaying\n");
+        return;
+    }
+
+    //
+    // The rest of the command is the path of the recording
+    //
+    FilePath = Command.substr(Command.find(SplittedCommandCaseSensitive.at(3)) + SplittedCommandCaseSensitive.at(3).size() + 1,
+                              Command.size());
+
+    //
+    // The latency of the outputs is measured for the replayed messages
+    //
+    ForwardingResetLatency();
+
+    IsValid = EventReplayPerform(FilePath, OutputSource->OutputUniqueTag, RecordedSpeed, CommandOutputGetTscFrequency(), &Result);
+
+    if (!IsValid && Result.RecordsCount == 0)
+    {
+        ShowMessages("err, unable to read the recording at '%s'\n", FilePath.c_str());
+        return;
+    }
+
+    if (!IsValid)
+    {
+        ShowMessages("err, the recording is corrupted, the replay is stopped at the corrupted block\n");
+    }
+
+    if (Result.IsInterrupted)
+    {
+        ShowMessages("the replay is interrupted\n");
+    }
+
+    ShowMessages("records: %llx, forwarded messages: %llx, skipped messages: %llx, forwarded bytes: %llx\n",
+                 Result.RecordsCount,
+                 Result.MessagesCount,
+                 Result.SkippedMessages,
+                 Result.BytesCount);
+
+    if (Result.ElapsedMicroseconds != 0)
+    {
+        ShowMessages("elapsed: %.3f ms, %.0f messages/s, %.2f MB/s\n",
+                     (double)Result.ElapsedMicroseconds / 1000,
+                     (double)Result.MessagesCount * 1000000 / Result.ElapsedMicroseconds,
+                     (double)Result.BytesCount / Result.ElapsedMicroseconds);
+    }
+
+    ShowMessages("dropped messages of the output: %llx (see 'output status' for the latency)\n",
+                 OutputSource->DroppedMessages);
 }
 
 /**
@@ -49,18 +559,19 @@ CommandOutputHelp()
  * @return VOID
  */
 VOID
-CommandOutput(vector<string> SplittedCommand, string Command)
+CommandOutput(vector<string> & SplittedCommand, string & Command)
 {
-    PDEBUGGER_EVENT_FORWARDING     EventForwardingObject;
-    DEBUGGER_EVENT_FORWARDING_TYPE Type;
-    DEBUGGER_OUTPUT_SOURCE_STATUS  Status;
-    string                         DetailsOfSource;
-    UINT32                         IndexToShowList;
-    PLIST_ENTRY                    TempList          = 0;
-    BOOLEAN                        OutputSourceFound = FALSE;
-    HANDLE                         SourceHandle      = INVALID_HANDLE_VALUE;
-    SOCKET                         Socket            = NULL;
-    vector<string>                 SplittedCommandCaseSensitive {Split(Command, ' ')};
+    PDEBUGGER_EVENT_FORWARDING       EventForwardingObject;
+    DEBUGGER_EVENT_FORWARDING_TYPE   Type;
+    DEBUGGER_EVENT_FORWARDING_POLICY Policy;
+    DEBUGGER_OUTPUT_SOURCE_STATUS    Status;
+    string                           DetailsOfSource;
+    UINT32                           IndexToShowList;
+    PLIST_ENTRY                      TempList          = 0;
+    BOOLEAN                          OutputSourceFound = FALSE;
+    HANDLE                           SourceHandle      = INVALID_HANDLE_VALUE;
+    SOCKET                           Socket            = NULL;
+    vector<string>                   SplittedCommandCaseSensitive {Split(Command, ' ')};
 
     //
     // Check if the user needs a list of outputs or not
@@ -85,8 +596,9 @@ CommandOutput(vector<string> SplittedCommand, string Command)
                 //
                 IndexToShowList++;
 
-                string TempStateString = "";
-                string TempTypeString  = "";
+                string TempStateString  = "";
+                string TempTypeString   = "";
+                string TempPolicyString = "";
 
                 if (CurrentOutputSourceDetails->State ==
                     EVENT_FORWARDING_STATE_NOT_OPENED)
@@ -116,8 +628,37 @@ CommandOutput(vector<string> SplittedCommand, string Command)
                 {
                     TempTypeString = "tcp      ";
                 }
+                else if (CurrentOutputSourceDetails->Type == EVENT_FORWARDING_BINARY_FILE)
+                {
+                    TempTypeString = "binary   ";
+                }
+                else if (CurrentOutputSourceDetails->Type == EVENT_FORWARDING_SHARED_MEMORY)
+                {
+                    TempTypeString = "sharedmem";
+                }
 
-                ShowMessages("%x  %s   %s\t%s\n", IndexToShowList, TempTypeString.c_str(), TempStateString.c_str(), CurrentOutputSourceDetails->Name);
+                if (CurrentOutputSourceDetails->Policy == EVENT_FORWARDING_POLICY_BLOCK)
+                {
+                    TempPolicyString = "block      ";
+                }
+                else if (CurrentOutputSourceDetails->Policy == EVENT_FORWARDING_POLICY_DROP_OLDEST)
+                {
+                    TempPolicyString = "drop-oldest";
+                }
+                else if (CurrentOutputSourceDetails->Policy == EVENT_FORWARDING_POLICY_SAMPLE)
+                {
+                    TempPolicyString = "sample     ";
+                }
+
+                ShowMessages("%x  %s   %s   %s   dropped: %llx   filtered: %llx%s\t%s\n",
+                             IndexToShowList,
+                             TempTypeString.c_str(),
+                             TempStateString.c_str(),
+                             TempPolicyString.c_str(),
+                             CurrentOutputSourceDetails->DroppedMessages,
+                             CurrentOutputSourceDetails->Filter.FilteredMessages,
+                             CurrentOutputSourceDetails->Filter.IsMuted ? " (muted)" : "",
+                             CurrentOutputSourceDetails->Name);
             }
         }
         else
@@ -128,6 +669,15 @@ CommandOutput(vector<string> SplittedCommand, string Command)
         return;
     }
 
+    //
+    // Check if the user needs the latency of messages or not
+    //
+    if (!SplittedCommand.at(1).compare("status"))
+    {
+        CommandOutputShowStatus(SplittedCommand);
+        return;
+    }
+
     if (SplittedCommand.size() <= 2)
     {
         ShowMessages("incorrect use of 'output'\n\n");
@@ -161,6 +711,14 @@ CommandOutput(vector<string> SplittedCommand, string Command)
         {
             Type = EVENT_FORWARDING_FILE;
         }
+        else if (!SplittedCommand.at(3).compare("binary"))
+        {
+            Type = EVENT_FORWARDING_BINARY_FILE;
+        }
+        else if (!SplittedCommand.at(3).compare("sharedmemory"))
+        {
+            Type = EVENT_FORWARDING_SHARED_MEMORY;
+        }
         else if (!SplittedCommand.at(3).compare("namedpipe"))
         {
             Type = EVENT_FORWARDING_NAMEDPIPE;
@@ -266,6 +824,11 @@ CommandOutput(vector<string> SplittedCommand, string Command)
 
         RtlZeroMemory(EventForwardingObject, sizeof(DEBUGGER_EVENT_FORWARDING));
 
+        //
+        // Messages of all the cores are accepted
+        //
+        EventForwardingObject->Filter.CoreId = EVENT_FORWARDING_FILTER_ANY_CORE;
+
         //
         // Set the state
         //
@@ -368,6 +931,11 @@ CommandOutput(vector<string> SplittedCommand, string Command)
                     return;
                 }
 
+                //
+                // The messages of the events of this source are generated again
+                //
+                ForwardingUpdateEventsOutputState();
+
                 //
                 // No need to search through the list anymore
                 //
@@ -381,6 +949,96 @@ CommandOutput(vector<string> SplittedCommand, string Command)
             return;
         }
     }
+    else if (!SplittedCommand.at(1).compare("policy"))
+    {
+        //
+        // It's a policy
+        //
+        if (SplittedCommand.size() != 4)
+        {
+            ShowMessages("incorrect use of 'output'\n\n");
+            CommandOutputHelp();
+            return;
+        }
+
+        if (!SplittedCommand.at(3).compare("block"))
+        {
+            Policy = EVENT_FORWARDING_POLICY_BLOCK;
+        }
+        else if (!SplittedCommand.at(3).compare("drop-oldest"))
+        {
+            Policy = EVENT_FORWARDING_POLICY_DROP_OLDEST;
+        }
+        else if (!SplittedCommand.at(3).compare("sample"))
+        {
+            Policy = EVENT_FORWARDING_POLICY_SAMPLE;
+        }
+        else
+        {
+            ShowMessages("incorrect policy near '%s'\n\n",
+                         SplittedCommand.at(3).c_str());
+            CommandOutputHelp();
+            return;
+        }
+
+        if (!g_OutputSourcesInitialized)
+        {
+            ShowMessages("err, the name you entered, not found\n");
+            return;
+        }
+
+        //
+        // Find the corresponding object and set its policy
+        //
+        TempList = &g_OutputSources;
+
+        while (&g_OutputSources != TempList->Flink)
+        {
+            TempList = TempList->Flink;
+
+            PDEBUGGER_EVENT_FORWARDING CurrentOutputSourceDetails = CONTAINING_RECORD(
+                TempList,
+                DEBUGGER_EVENT_FORWARDING,
+                OutputSourcesList);
+
+            if (strcmp(CurrentOutputSourceDetails->Name,
+                       SplittedCommandCaseSensitive.at(2).c_str()) == 0)
+            {
+                OutputSourceFound = TRUE;
+
+                CurrentOutputSourceDetails->Policy = Policy;
+
+                break;
+            }
+        }
+
+        if (!OutputSourceFound)
+        {
+            ShowMessages("err, the name you entered, not found\n");
+            return;
+        }
+    }
+    else if (!SplittedCommand.at(1).compare("filter"))
+    {
+        //
+        // It's a filter
+        //
+        CommandOutputSetFilter(SplittedCommand, SplittedCommandCaseSensitive, Command);
+    }
+    else if (!SplittedCommand.at(1).compare("record"))
+    {
+        //
+        // It's a record
+        //
+        CommandOutputRecord(SplittedCommand, SplittedCommandCaseSensitive, Command);
+    }
+    else if (!SplittedCommand.at(1).compare("replay"))
+    {
+        //
+        // It's a replay
+        //
+        CommandOutputReplay(SplittedCommand, SplittedCommandCaseSensitive, Command);
+    }
     else if (!SplittedCommand.at(1).compare("close"))
     {
         //
@@ -437,6 +1095,12 @@ CommandOutput(vector<string> SplittedCommand, string Command)
                     return;
                 }
 
+                //
+                // The events that only use the closed sources don't need to
+                // generate their messages anymore
+                //
+                ForwardingUpdateEventsOutputState();
+
                 //
                 // No need to search through the list anymore
                 //
@@ -49,7 +49,7 @@ CommandPHelp()
  * @return VOID
  */
 VOID
-CommandP(vector<string> SplittedCommand, string Command)
+CommandP(vector<string> & SplittedCommand, string & Command)
 {
     UINT32                           StepCount;
     DEBUGGER_REMOTE_STEPPING_REQUEST RequestFormat;
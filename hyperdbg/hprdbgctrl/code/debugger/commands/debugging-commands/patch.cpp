@@ -0,0 +1,328 @@
+/**
+ * @file patch.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief patch command
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN                  g_IsSerialConnectedToRemoteDebuggee;
+extern ACTIVE_DEBUGGING_PROCESS g_ActiveProcessDebuggingState;
+
+/**
+ * @brief help of the patch and !patch commands
+ *
+ * @return VOID
+ */
+VOID
+CommandPatchHelp()
+{
+    ShowMessages("patch !patch : applies a list of patches (addresses and bytes) from a file on the memory.\n\n");
+
+    ShowMessages("If you want to patch physical (address) memory then add '!' "
+                 "at the start of the command\n\n");
+
+    ShowMessages("syntax : \tpatch [FilePath (string)]\n");
+    ShowMessages("syntax : \t!patch [FilePath (string)]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : patch c:\\patches\\hotpatch.txt\n");
+    ShowMessages("\t\te.g : !patch \"c:\\patches\\hot patch.txt\"\n");
+
+    ShowMessages("\n");
+    ShowMessages("each line of the file contains an address followed by the bytes of the patch, "
+                 "empty lines and lines that start with '#' are ignored\n");
+    ShowMessages("\t\te.g : fffff8077356f010 90 90 90 90\n");
+    ShowMessages("\t\te.g : nt!Kd_DEFAULT_Mask ffffffff\n");
+}
+
+/**
+ * @brief Read the patches of a file
+ * @details the bytes of the patches are kept by their addresses, so they're
+ * sorted and the later patches of the same address overwrite the previous
+ * patches
+ *
+ * @param FilePath Path of the file of patches
+ * @param Bytes The bytes of the patches
+ *
+ * @return BOOLEAN Whether the file is read successfully or not
+ */
+BOOLEAN
+CommandPatchReadFile(const string & FilePath, std::map<UINT64, BYTE> & Bytes)
+{
+    string   Line;
+    UINT32   LineNumber = 0;
+    UINT64   Address;
+    UINT64   Offset;
+    UINT32   Value;
+    ifstream File(FilePath);
+
+    if (!File.is_open())
+    {
+        ShowMessages("err, unable to open the file of patches\n");
+        return FALSE;
+    }
+
+    while (std::getline(File, Line))
+    {
+        LineNumber++;
+
+        Trim(Line);
+
+        if (Line.empty() || Line.front() == '#')
+        {
+            continue;
+        }
+
+        vector<string> Tokens {Split(Line, ' ')};
+
+        if (Tokens.size() < 2 || !SymbolConvertNameOrExprToAddress(Tokens.at(0), &Address))
+        {
+            ShowMessages("err, couldn't resolve the address at line %d\n", LineNumber);
+            return FALSE;
+        }
+
+        Offset = 0;
+
+        for (size_t i = 1; i < Tokens.size(); i++)
+        {
+            //
+            // Each token is a run of bytes (two hex digits for each byte)
+            //
+            if (Tokens.at(i).size() % 2 != 0 || !IsHexNotation(Tokens.at(i)))
+            {
+                ShowMessages("err, invalid bytes at line %d ('%s')\n", LineNumber, Tokens.at(i).c_str());
+                return FALSE;
+            }
+
+            for (size_t j = 0; j < Tokens.at(i).size(); j += 2)
+            {
+                ConvertStringToUInt32(Tokens.at(i).substr(j, 2), &Value);
+
+                Bytes[Address + Offset] = (BYTE)Value;
+                Offset++;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Send a request of patching memory to the kernel and show its errors
+ *
+ * @param PatchMemRequest The request followed by the stream of patches
+ *
+ * @return BOOLEAN Whether all of the patches of the request are applied or not
+ */
+BOOLEAN
+CommandPatchSendRequest(PDEBUGGER_PATCH_MEMORY_REQUEST PatchMemRequest)
+{
+    BOOL                         Status;
+    PDEBUGGER_PATCH_MEMORY_ENTRY Patch;
+    UINT32                       Offset = 0;
+
+    PatchMemRequest->CountOfAppliedPatches = 0;
+    PatchMemRequest->KernelStatus          = NULL;
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        if (!KdSendPatchMemoryPacketToDebuggee(PatchMemRequest))
+        {
+            return FALSE;
+        }
+    }
+    else
+    {
+        AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+        Status = DeviceIoControl(
+            g_DeviceHandle,                                                            // Handle to device
+            IOCTL_DEBUGGER_PATCH_MEMORY,                                               // IO Control code
+            PatchMemRequest,                                                           // Input Buffer to driver.
+            SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST + PatchMemRequest->PatchesBufferSize, // Input buffer length
+            PatchMemRequest,                                                           // Output Buffer from driver.
+            SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST,                                      // Length of output buffer in bytes.
+            NULL,                                                                      // Bytes placed in buffer.
+            NULL                                                                       // synchronous call
+        );
+
+        if (!Status)
+        {
+            ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+            return FALSE;
+        }
+    }
+
+    if (PatchMemRequest->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        return TRUE;
+    }
+
+    //
+    // Find the patch that is not applied (the stream is not changed by the kernel)
+    //
+    if (PatchMemRequest->CountOfAppliedPatches < PatchMemRequest->CountOfPatches)
+    {
+        for (UINT32 i = 0; i < PatchMemRequest->CountOfAppliedPatches; i++)
+        {
+            Patch = (PDEBUGGER_PATCH_MEMORY_ENTRY)((UINT64)PatchMemRequest + SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST + Offset);
+            Offset += DEBUGGER_PATCH_MEMORY_ENTRY_LENGTH(Patch->Size);
+        }
+
+        Patch = (PDEBUGGER_PATCH_MEMORY_ENTRY)((UINT64)PatchMemRequest + SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST + Offset);
+
+        ShowMessages("err, couldn't apply the patch at %llx (size: %x)\n", Patch->Address, Patch->Size);
+    }
+
+    ShowErrorMessage(PatchMemRequest->KernelStatus);
+
+    return FALSE;
+}
+
+/**
+ * @brief patch and !patch commands handler
+ * @details the adjacent bytes are merged into a single patch, and the
+ * patches are sent in as few requests as possible (each request is a
+ * single packet in the debugger mode)
+ *
+ * @param SplittedCommand
+ * @param Command
+ * @return VOID
+ */
+VOID
+CommandPatch(vector<string> & SplittedCommand, string & Command)
+{
+    std::map<UINT64, BYTE>         Bytes;
+    string                         FilePath;
+    PDEBUGGER_PATCH_MEMORY_REQUEST PatchMemRequest;
+    PDEBUGGER_PATCH_MEMORY_ENTRY   Patch = NULL;
+    BYTE *                         Stream;
+    UINT32                         ProcId          = 0;
+    UINT32                         CountOfRequests = 0;
+    UINT64                         NextAddress     = NULL;
+
+    if (SplittedCommand.size() < 2)
+    {
+        ShowMessages("incorrect use of 'patch'\n\n");
+        CommandPatchHelp();
+        return;
+    }
+
+    //
+    // The rest of the command is the path of the file
+    //
+    FilePath = Command;
+    Trim(FilePath);
+    FilePath.erase(0, SplittedCommand.at(0).size());
+    Trim(FilePath);
+    ReplaceAll(FilePath, "\"", "");
+
+    if (!CommandPatchReadFile(FilePath, Bytes))
+    {
+        return;
+    }
+
+    if (Bytes.empty())
+    {
+        ShowMessages("err, there is no patch in the file\n");
+        return;
+    }
+
+    //
+    // By default if the user-debugger is active, we use this command
+    // on the memory layout of the debuggee process
+    //
+    if (g_ActiveProcessDebuggingState.IsActive)
+    {
+        ProcId = g_ActiveProcessDebuggingState.ProcessId;
+    }
+    else
+    {
+        ProcId = GetCurrentProcessId();
+    }
+
+    //
+    // The size of each request is limited to the size of a packet of
+    // the debugger mode (also used for the VMI mode)
+    //
+    PatchMemRequest = (PDEBUGGER_PATCH_MEMORY_REQUEST)malloc(SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST + MaxSerialPatchMemoryBufferSize);
+
+    if (PatchMemRequest == NULL)
+    {
+        ShowMessages("unable to allocate memory\n\n");
+        return;
+    }
+
+    RtlZeroMemory(PatchMemRequest, SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST);
+
+    PatchMemRequest->ProcessId  = ProcId;
+    PatchMemRequest->MemoryType = !SplittedCommand.at(0).compare("!patch") ? EDIT_PHYSICAL_MEMORY : EDIT_VIRTUAL_MEMORY;
+
+    Stream = (BYTE *)PatchMemRequest + SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST;
+
+    for (auto Iterator = Bytes.begin(); Iterator != Bytes.end(); Iterator++)
+    {
+        //
+        // Continue the current patch if the byte is adjacent to it, otherwise
+        // start a new patch (in a new request if this request is full)
+        //
+        if (Patch == NULL || Iterator->first != NextAddress ||
+            PatchMemRequest->PatchesBufferSize + DEBUGGER_PATCH_MEMORY_ENTRY_LENGTH(Patch->Size + 1) > MaxSerialPatchMemoryBufferSize)
+        {
+            if (Patch != NULL)
+            {
+                PatchMemRequest->PatchesBufferSize += DEBUGGER_PATCH_MEMORY_ENTRY_LENGTH(Patch->Size);
+            }
+
+            if (PatchMemRequest->PatchesBufferSize + DEBUGGER_PATCH_MEMORY_ENTRY_LENGTH(1) > MaxSerialPatchMemoryBufferSize)
+            {
+                CountOfRequests++;
+
+                if (!CommandPatchSendRequest(PatchMemRequest))
+                {
+                    free(PatchMemRequest);
+                    return;
+                }
+
+                PatchMemRequest->CountOfPatches    = 0;
+                PatchMemRequest->PatchesBufferSize = 0;
+            }
+
+            Patch = (PDEBUGGER_PATCH_MEMORY_ENTRY)(Stream + PatchMemRequest->PatchesBufferSize);
+
+            Patch->Address  = Iterator->first;
+            Patch->Size     = 0;
+            Patch->Reserved = 0;
+
+            PatchMemRequest->CountOfPatches++;
+        }
+
+        ((BYTE *)Patch + sizeof(DEBUGGER_PATCH_MEMORY_ENTRY))[Patch->Size] = Iterator->second;
+        Patch->Size++;
+
+        NextAddress = Iterator->first + 1;
+    }
+
+    //
+    // Send the last request
+    //
+    PatchMemRequest->PatchesBufferSize += DEBUGGER_PATCH_MEMORY_ENTRY_LENGTH(Patch->Size);
+
+    CountOfRequests++;
+
+    if (CommandPatchSendRequest(PatchMemRequest))
+    {
+        ShowMessages("%llx bytes are patched (%d request(s))\n", (UINT64)Bytes.size(), CountOfRequests);
+    }
+
+    free(PatchMemRequest);
+}
@@ -68,7 +68,7 @@ CommandPauseRequest()
  * @return VOID
  */
 VOID
-CommandPause(vector<string> SplittedCommand, string Command)
+CommandPause(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() != 1)
     {
@@ -11,6 +11,21 @@
  */
 #include "pch.h"
 
+/**
+ * @brief Names of the intentions of pools (indexed by POOL_ALLOCATION_INTENTION)
+ *
+ */
+static const CHAR * const g_PreallocPoolIntentionNames[NumberOfPoolIntentions] = {
+    "hooked pages",
+    "exec trampoline",
+    "2MB to 4KB split",
+    "detour hook details",
+    "breakpoint definitions",
+    "process/thread holder",
+    "hidden breakpoints set",
+    "snapshot page copies",
+};
+
 /**
  * @brief help of prealloc command
  *
@@ -22,10 +37,100 @@ CommandPreallocHelp()
     ShowMessages("prealloc : pre-allocates buffer for special purposes.\n\n");
 
     ShowMessages("syntax : \tprealloc  [Type (string)] [Count (hex)]\n");
+    ShowMessages("syntax : \tprealloc  [stats]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : prealloc monitor 10\n");
     ShowMessages("\t\te.g : prealloc thread-interception 8\n");
+    ShowMessages("\t\te.g : prealloc snapshot 100\n");
+    ShowMessages("\t\te.g : prealloc stats\n");
+}
+
+/**
+ * @brief Show the statistics of the pool manager and the nonpaged
+ * memory usage
+ * @details sizes are in bytes (hex), 'peak' is the maximum count of pools
+ * that were in use at the same time and 'misses' is the count of requests
+ * that didn't find any pre-allocated pool
+ *
+ * @return VOID
+ */
+VOID
+CommandPreallocShowStatistics()
+{
+    BOOL                             Status;
+    ULONG                            ReturnedLength;
+    UINT64                           TotalBytes            = 0;
+    DEBUGGER_POOL_MANAGER_STATISTICS PoolStatisticsRequest = {0};
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+
+    //
+    // Send IOCTL
+    //
+    Status = DeviceIoControl(
+        g_DeviceHandle,                          // Handle to device
+        IOCTL_QUERY_POOL_MANAGER_STATISTICS,     // IO Control code
+        &PoolStatisticsRequest,                  // Input Buffer to driver.
+        SIZEOF_DEBUGGER_POOL_MANAGER_STATISTICS, // Input buffer length
+        &PoolStatisticsRequest,                  // Output Buffer from driver.
+        SIZEOF_DEBUGGER_POOL_MANAGER_STATISTICS, // Length of output
+                                                 // buffer in bytes.
+        &ReturnedLength,                         // Bytes placed in buffer.
+        NULL                                     // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        return;
+    }
+
+    if (PoolStatisticsRequest.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(PoolStatisticsRequest.KernelStatus);
+        return;
+    }
+
+    ShowMessages("%-24s %8s %8s %8s %8s %12s %12s %10s %10s\n",
+                 "intention",
+                 "total",
+                 "busy",
+                 "free",
+                 "peak",
+                 "bytes",
+                 "busy bytes",
+                 "requests",
+                 "misses");
+
+    for (UINT32 i = 0; i < NumberOfPoolIntentions; i++)
+    {
+        PDEBUGGER_POOL_INTENTION_STATISTICS Intention = &PoolStatisticsRequest.Intentions[i];
+
+        ShowMessages("%-24s %8x %8x %8x %8x %12llx %12llx %10llx %10llx%s\n",
+                     g_PreallocPoolIntentionNames[i],
+                     Intention->TotalPools,
+                     Intention->BusyPools,
+                     Intention->FreePools,
+                     Intention->PeakBusyPools,
+                     Intention->Bytes,
+                     Intention->BusyBytes,
+                     Intention->Requests,
+                     Intention->Misses,
+                     Intention->Misses != 0 ? " (!)" : "");
+
+        TotalBytes += Intention->Bytes;
+    }
+
+    ShowMessages("\nnonpaged memory usage (bytes):\n");
+    ShowMessages("\tpool manager     : %llx\n", TotalBytes);
+    ShowMessages("\tept split tables : %llx\n", PoolStatisticsRequest.EptSplitTablesBytes);
+    ShowMessages("\thook pages       : %llx\n", PoolStatisticsRequest.HookPagesBytes);
+    ShowMessages("\thyperlog buffers : %llx\n", PoolStatisticsRequest.HyperlogBuffersBytes);
+    ShowMessages("\tscript buffers   : %llx\n", PoolStatisticsRequest.ScriptBuffersBytes);
+    ShowMessages("\tevent objects    : %llx\n", PoolStatisticsRequest.EventObjectsBytes);
+    ShowMessages("\ttotal            : %llx\n",
+                 TotalBytes + PoolStatisticsRequest.HyperlogBuffersBytes + PoolStatisticsRequest.ScriptBuffersBytes + PoolStatisticsRequest.EventObjectsBytes);
 }
 
 /**
@@ -36,13 +141,19 @@ CommandPreallocHelp()
  * @return VOID
  */
 VOID
-CommandPrealloc(vector<string> SplittedCommand, string Command)
+CommandPrealloc(vector<string> & SplittedCommand, string & Command)
 {
     BOOL                      Status;
     ULONG                     ReturnedLength;
     UINT64                    Count;
     DEBUGGER_PREALLOC_COMMAND PreallocRequest = {0};
 
+    if (SplittedCommand.size() == 2 && !SplittedCommand.at(1).compare("stats"))
+    {
+        CommandPreallocShowStatistics();
+        return;
+    }
+
     if (SplittedCommand.size() != 3)
     {
         ShowMessages("incorrect use of 'prealloc'\n\n");
@@ -61,6 +172,10 @@ CommandPrealloc(vector<string> SplittedCommand, string Command)
     {
         PreallocRequest.Type = DEBUGGER_PREALLOC_COMMAND_TYPE_THREAD_INTERCEPTION;
     }
+    else if (!SplittedCommand.at(1).compare("snapshot"))
+    {
+        PreallocRequest.Type = DEBUGGER_PREALLOC_COMMAND_TYPE_EPT_SNAPSHOT;
+    }
     else
     {
         //
@@ -43,7 +43,7 @@ CommandPrintHelp()
  * @return VOID
  */
 VOID
-CommandPrint(vector<string> SplittedCommand, string Command)
+CommandPrint(vector<string> & SplittedCommand, string & Command)
 {
     PVOID  CodeBuffer;
     UINT64 BufferAddress;
@@ -17,7 +17,9 @@
 //
 // Global Variables
 //
-extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+extern BOOLEAN                     g_IsSerialConnectedToRemoteDebuggee;
+extern BOOLEAN                     g_IsDebuggeeRunning;
+extern PDEBUGGEE_REGISTERS_CONTEXT g_KdRegistersReadBuffer;
 
 std::map<std::string, REGS_ENUM> RegistersMap = {
     {"rax", REGISTER_RAX},
@@ -176,6 +178,39 @@ ShowAllRegisters()
     RegState.RegisterID                         = DEBUGGEE_SHOW_ALL_REGISTERS;
     KdSendReadRegisterPacketToDebuggee(&RegState);
 }
+
+/**
+ * @brief Read all registers of the current core of the halted debuggee
+ * @details the registers are saved in the buffer without being shown
+ *
+ * @param Registers The buffer to save the registers
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+HyperDbgReadRegisters(PDEBUGGEE_REGISTERS_CONTEXT Registers)
+{
+    DEBUGGEE_REGISTER_READ_DESCRIPTION RegState = {0};
+    BOOLEAN                            Result;
+
+    if (!g_IsSerialConnectedToRemoteDebuggee || g_IsDebuggeeRunning)
+    {
+        return FALSE;
+    }
+
+    RegState.RegisterID = DEBUGGEE_SHOW_ALL_REGISTERS;
+
+    //
+    // The buffer is set to NULL once the registers are saved in it
+    //
+    g_KdRegistersReadBuffer = Registers;
+
+    Result = KdSendReadRegisterPacketToDebuggee(&RegState) && g_KdRegistersReadBuffer == NULL;
+
+    g_KdRegistersReadBuffer = NULL;
+
+    return Result;
+}
 /**
  * @brief handler of r command
  *
@@ -184,7 +219,7 @@ ShowAllRegisters()
  * @return VOID
  */
 VOID
-CommandR(std::vector<std::string> SplittedCommand, std::string Command)
+CommandR(std::vector<std::string> & SplittedCommand, std::string & Command)
 {
     //
     // Interpret here
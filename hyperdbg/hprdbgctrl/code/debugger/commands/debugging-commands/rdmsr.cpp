@@ -36,7 +36,7 @@ CommandRdmsrHelp()
  * @return VOID
  */
 VOID
-CommandRdmsr(vector<string> SplittedCommand, string Command)
+CommandRdmsr(vector<string> & SplittedCommand, string & Command)
 {
     BOOL                           Status;
     BOOL                           IsNextCoreId = FALSE;
@@ -39,6 +39,9 @@ CommandSearchMemoryHelp()
     ShowMessages("syntax : \tsd [StartAddress (hex)] [l Length (hex)] [BytePattern (hex)] [pid ProcessId (hex)]\n");
     ShowMessages("syntax : \tsq [StartAddress (hex)] [l Length (hex)] [BytePattern (hex)] [pid ProcessId (hex)]\n");
 
+    ShowMessages("\n");
+    ShowMessages("\t\t'??' in a value matches any byte and '|' separates multiple patterns (up to %d)\n", MaximumSearchPatterns);
+
     ShowMessages("\n");
     ShowMessages("\t\te.g : sb nt!ExAllocatePoolWithTag 90 85 95 l ffff \n");
     ShowMessages("\t\te.g : sb nt!ExAllocatePoolWithTag+5 90 85 95 l ffff \n");
@@ -49,6 +52,67 @@ CommandSearchMemoryHelp()
     ShowMessages("\t\te.g : !sq @rdx+r12 9090909090909090 l ffff\n");
     ShowMessages("\t\te.g : !sq 100000 9090909090909090 9090909090909090 "
                  "9090909090909090 l ffffff\n");
+    ShowMessages("\t\te.g : sb nt!ExAllocatePoolWithTag 48 89 ?? 24 l ffff \n");
+    ShowMessages("\t\te.g : sd fffff8077356f010 9042??80 l ffff \n");
+    ShowMessages("\t\te.g : sb fffff8077356f010 90 90 | cc cc | 0f 0b l ffff \n");
+}
+
+/**
+ * @brief Convert a value of s* commands to its value and mask
+ * @details the bytes of '??' are wildcards, and their mask is zero
+ *
+ * @param Section The value
+ * @param Value The converted value
+ * @param Mask The mask of the value
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandSearchConvertValue(string Section, UINT64 * Value, UINT64 * Mask)
+{
+    UINT64 ByteValue;
+    UINT32 ByteIndex;
+
+    *Mask = 0xffffffffffffffff;
+
+    if (Section.find('?') == string::npos)
+    {
+        return ConvertStringToUInt64(Section, Value);
+    }
+
+    if (Section.size() % 2 != 0)
+    {
+        Section.insert(0, "0");
+    }
+
+    *Value = 0;
+
+    for (size_t i = 0; i < Section.size(); i += 2)
+    {
+        string Byte = Section.substr(i, 2);
+
+        //
+        // The first characters are the most significant byte
+        //
+        ByteIndex = (UINT32)((Section.size() - i) / 2) - 1;
+
+        if (!Byte.compare("??"))
+        {
+            *Mask &= ~(0xffULL << (ByteIndex * 8));
+            continue;
+        }
+
+        if (Byte.find('?') != string::npos || !ConvertStringToUInt64(Byte, &ByteValue))
+        {
+            //
+            // Wildcards should cover the whole byte
+            //
+            return FALSE;
+        }
+
+        *Value |= ByteValue << (ByteIndex * 8);
+    }
+
+    return TRUE;
 }
 
 /**
@@ -61,64 +125,100 @@ CommandSearchMemoryHelp()
 VOID
 CommandSearchSendRequest(UINT64 * BufferToSendAsIoctl, UINT32 BufferToSendAsIoctlSize)
 {
-    BOOL    Status;
-    UINT64  CurrentValue;
-    PUINT64 ResultsBuffer = NULL;
+    BOOL                    Status;
+    UINT64                  CurrentValue   = NULL;
+    UINT64                  EndAddress     = NULL;
+    UINT32                  CountOfResults = 0;
+    UINT32                  ElementSize    = 0;
+    size_t                  Index          = 0;
+    PUINT64                 ResultsBuffer  = NULL;
+    PDEBUGGER_SEARCH_MEMORY SearchRequest  = (PDEBUGGER_SEARCH_MEMORY)BufferToSendAsIoctl;
 
     //
     // Allocate a buffer to store the results
     //
     ResultsBuffer = (PUINT64)malloc(MaximumSearchResults * sizeof(UINT64));
 
-    //
-    // Also it's better to Zero the memory; however it's not necessary
-    // as we zero the buffer in the search routines
-    //
-    ZeroMemory(ResultsBuffer, MaximumSearchResults * sizeof(UINT64));
-
-    //
-    // Fire the IOCTL
-    //
-    Status =
-        DeviceIoControl(g_DeviceHandle,               // Handle to device
-                        IOCTL_DEBUGGER_SEARCH_MEMORY, // IO Control code
-                        BufferToSendAsIoctl,          // Input Buffer to driver.
-                        BufferToSendAsIoctlSize,      // Input buffer length
-                        ResultsBuffer,                // Output Buffer from driver.
-                        MaximumSearchResults *
-                            sizeof(UINT64),           // Length of output buffer in bytes.
-                        NULL,                         // Bytes placed in buffer.
-                        NULL                          // synchronous call
-        );
-
-    if (!Status)
+    if (ResultsBuffer == NULL)
     {
-        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
-
-        free(ResultsBuffer);
+        ShowMessages("unable to allocate memory\n\n");
         return;
     }
 
+    ElementSize = SearchRequest->ByteSize == SEARCH_BYTE ? 1 : (SearchRequest->ByteSize == SEARCH_DWORD ? 4 : 8);
+    EndAddress  = SearchRequest->Address + SearchRequest->Length;
+
     //
-    // Show the results (if any)
+    // The results are received in batches of MaximumSearchResults, once a
+    // batch is full, the search is continued after the last result
     //
-    for (size_t i = 0; i < MaximumSearchResults; i++)
+    while (TRUE)
     {
-        CurrentValue = ResultsBuffer[i];
+        //
+        // Also it's better to Zero the memory; however it's not necessary
+        // as we zero the buffer in the search routines
+        //
+        ZeroMemory(ResultsBuffer, MaximumSearchResults * sizeof(UINT64));
 
-        if (CurrentValue == NULL)
+        //
+        // Fire the IOCTL
+        //
+        Status =
+            DeviceIoControl(g_DeviceHandle,               // Handle to device
+                            IOCTL_DEBUGGER_SEARCH_MEMORY, // IO Control code
+                            BufferToSendAsIoctl,          // Input Buffer to driver.
+                            BufferToSendAsIoctlSize,      // Input buffer length
+                            ResultsBuffer,                // Output Buffer from driver.
+                            MaximumSearchResults *
+                                sizeof(UINT64),           // Length of output buffer in bytes.
+                            NULL,                         // Bytes placed in buffer.
+                            NULL                          // synchronous call
+            );
+
+        if (!Status)
         {
-            //
-            // We ended up the buffer, nothing else to show,
-            // just check whether we found anything or not
-            //
-            if (i == 0)
+            ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+
+            free(ResultsBuffer);
+            return;
+        }
+
+        //
+        // Show the results (if any)
+        //
+        for (Index = 0; Index < MaximumSearchResults; Index++)
+        {
+            CurrentValue = ResultsBuffer[Index];
+
+            if (CurrentValue == NULL)
             {
-                ShowMessages("not found\n");
+                //
+                // We ended up the buffer, nothing else to show
+                //
+                break;
             }
+            ShowMessages("%llx\n", CurrentValue);
+            CountOfResults++;
+        }
+
+        if (Index != MaximumSearchResults || CurrentValue + ElementSize >= EndAddress)
+        {
             break;
         }
-        ShowMessages("%llx\n", CurrentValue);
+
+        //
+        // Continue from the next element after the last result
+        //
+        SearchRequest->Address = CurrentValue + ElementSize;
+        SearchRequest->Length  = EndAddress - SearchRequest->Address;
+    }
+
+    //
+    // Check whether we found anything or not
+    //
+    if (CountOfResults == 0)
+    {
+        ShowMessages("not found\n");
     }
 
     //
@@ -135,7 +235,7 @@ CommandSearchSendRequest(UINT64 * BufferToSendAsIoctl, UINT32 BufferToSendAsIoct
  * @return VOID
  */
 VOID
-CommandSearchMemory(vector<string> SplittedCommand, string Command)
+CommandSearchMemory(vector<string> & SplittedCommand, string & Command)
 {
     BOOL                   SetAddress          = FALSE;
     BOOL                   SetValue            = FALSE;
@@ -145,13 +245,18 @@ CommandSearchMemory(vector<string> SplittedCommand, string Command)
     BOOL                   NextIsLength        = FALSE;
     DEBUGGER_SEARCH_MEMORY SearchMemoryRequest = {0};
     UINT64                 Address;
-    UINT64                 Value         = 0;
-    UINT64                 Length        = 0;
-    UINT32                 ProcId        = 0;
-    UINT32                 CountOfValues = 0;
-    UINT32                 FinalSize     = 0;
-    UINT64 *               FinalBuffer   = NULL;
+    UINT64                 Value                  = 0;
+    UINT64                 Length                 = 0;
+    UINT32                 ProcId                 = 0;
+    UINT64                 Mask                   = 0;
+    UINT32                 CountOfValues          = 0;
+    UINT32                 FinalSize              = 0;
+    UINT64 *               FinalBuffer            = NULL;
+    UINT32                 ElementSize            = 0;
+    UINT32                 CountOfValuesInPattern = 0;
     vector<UINT64>         ValuesToEdit;
+    vector<UINT64>         MasksOfValues;
+    vector<UINT64>         PatternLengths;
     vector<string>         SplittedCommandCaseSensitive {Split(Command, ' ')};
     UINT32                 IndexInCommandCaseSensitive = 0;
 
@@ -304,6 +409,23 @@ CommandSearchMemory(vector<string> SplittedCommand, string Command)
 
         if (SetAddress)
         {
+            //
+            // Check if it's the start of another pattern
+            //
+            if (!Section.compare("|"))
+            {
+                if (CountOfValuesInPattern == 0)
+                {
+                    ShowMessages("please specify a pattern before '|'\n\n");
+                    CommandSearchMemoryHelp();
+                    return;
+                }
+
+                PatternLengths.push_back(CountOfValuesInPattern);
+                CountOfValuesInPattern = 0;
+                continue;
+            }
+
             //
             // Remove the hex notations
             //
@@ -344,7 +466,7 @@ CommandSearchMemory(vector<string> SplittedCommand, string Command)
             // Qword is checked by the following function, no need to double
             // check it above.
             //
-            if (!ConvertStringToUInt64(Section, &Value))
+            if (!CommandSearchConvertValue(Section, &Value, &Mask))
             {
                 ShowMessages("please specify a correct hex value to search in the "
                              "memory content\n\n");
@@ -357,11 +479,13 @@ CommandSearchMemory(vector<string> SplittedCommand, string Command)
                 // Add it to the list
                 //
                 ValuesToEdit.push_back(Value);
+                MasksOfValues.push_back(Mask);
 
                 //
                 // Keep track of values to modify
                 //
                 CountOfValues++;
+                CountOfValuesInPattern++;
 
                 if (!SetValue)
                 {
@@ -389,12 +513,47 @@ CommandSearchMemory(vector<string> SplittedCommand, string Command)
         ProcId = GetCurrentProcessId();
     }
 
+    //
+    // Add the last pattern
+    //
+    if (CountOfValuesInPattern != 0)
+    {
+        PatternLengths.push_back(CountOfValuesInPattern);
+    }
+    else if (!PatternLengths.empty())
+    {
+        ShowMessages("please specify a pattern after '|'\n\n");
+        CommandSearchMemoryHelp();
+        return;
+    }
+
+    //
+    // Check the limitations of patterns
+    //
+    ElementSize = SearchMemoryRequest.ByteSize == SEARCH_BYTE ? 1 : (SearchMemoryRequest.ByteSize == SEARCH_DWORD ? 4 : 8);
+
+    if (PatternLengths.size() > MaximumSearchPatterns)
+    {
+        ShowMessages("err, up to %d patterns can be searched at once\n", MaximumSearchPatterns);
+        return;
+    }
+
+    for (auto PatternLength : PatternLengths)
+    {
+        if (PatternLength * ElementSize > MaximumSearchPatternSize)
+        {
+            ShowMessages("err, each pattern should not be larger than 0x%x bytes\n", MaximumSearchPatternSize);
+            return;
+        }
+    }
+
     //
     // Fill the structure
     //
     SearchMemoryRequest.ProcessId       = ProcId;
     SearchMemoryRequest.Address         = Address;
     SearchMemoryRequest.CountOf64Chunks = CountOfValues;
+    SearchMemoryRequest.CountOfPatterns = (UINT32)PatternLengths.size();
 
     //
     // Check if address and value are set or not
@@ -434,7 +593,7 @@ CommandSearchMemory(vector<string> SplittedCommand, string Command)
     //
     // Now it's time to put everything together in one structure
     //
-    FinalSize = (CountOfValues * sizeof(UINT64)) + SIZEOF_DEBUGGER_SEARCH_MEMORY;
+    FinalSize = ((CountOfValues * 2 + SearchMemoryRequest.CountOfPatterns) * sizeof(UINT64)) + SIZEOF_DEBUGGER_SEARCH_MEMORY;
 
     //
     // Set the size
@@ -473,9 +632,11 @@ CommandSearchMemory(vector<string> SplittedCommand, string Command)
     memcpy(FinalBuffer, &SearchMemoryRequest, SIZEOF_DEBUGGER_SEARCH_MEMORY);
 
     //
-    // Put the values in 64 bit structures
+    // Put the values, their masks and the lengths of patterns in 64 bit structures
     //
     std::copy(ValuesToEdit.begin(), ValuesToEdit.end(), (UINT64 *)((UINT64)FinalBuffer + SIZEOF_DEBUGGER_SEARCH_MEMORY));
+    std::copy(MasksOfValues.begin(), MasksOfValues.end(), (UINT64 *)((UINT64)FinalBuffer + SIZEOF_DEBUGGER_SEARCH_MEMORY) + CountOfValues);
+    std::copy(PatternLengths.begin(), PatternLengths.end(), (UINT64 *)((UINT64)FinalBuffer + SIZEOF_DEBUGGER_SEARCH_MEMORY) + (CountOfValues * 2));
 
     //
     // Check if it's a connection in debugger mode
@@ -18,7 +18,15 @@ extern BOOLEAN g_AutoUnpause;
 extern BOOLEAN g_AutoFlush;
 extern BOOLEAN g_AddressConversion;
 extern BOOLEAN g_IsConnectedToRemoteDebuggee;
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+extern BOOLEAN g_IsDebuggeeRunning;
+extern BOOLEAN g_BinaryTraceMode;
+extern HANDLE  g_DeviceHandle;
 extern UINT32  g_DisassemblerSyntax;
+extern UINT32  g_LogPacketsCapacityPerCore;
+extern UINT32  g_LogMaximumPacketsCapacityPerCore;
+extern UINT32  g_RemoteConnectionFlushInterval;
+extern UINT32  g_RemoteConnectionMaximumBatchSize;
 
 /**
  * @brief help of settings command
@@ -44,6 +52,16 @@ CommandSettingsHelp()
     ShowMessages("\t\te.g : settings addressconversion off\n");
     ShowMessages("\t\te.g : settings autoflush on\n");
     ShowMessages("\t\te.g : settings autoflush off\n");
+    ShowMessages("\t\te.g : settings binarytrace on\n");
+    ShowMessages("\t\te.g : settings binarytrace off\n");
+    ShowMessages("\t\te.g : settings logcapacity\n");
+    ShowMessages("\t\te.g : settings logcapacity 400\n");
+    ShowMessages("\t\te.g : settings logmaxcapacity 1000\n");
+    ShowMessages("\t\te.g : settings remoteflushinterval 20\n");
+    ShowMessages("\t\te.g : settings remotebatchsize 8000\n");
+    ShowMessages("\t\te.g : settings haltwatchdog\n");
+    ShowMessages("\t\te.g : settings haltwatchdog 1388\n");
+    ShowMessages("\t\te.g : settings haltwatchdog 0\n");
     ShowMessages("\t\te.g : settings syntax intel\n");
     ShowMessages("\t\te.g : settings syntax att\n");
     ShowMessages("\t\te.g : settings syntax masm\n");
@@ -240,6 +258,68 @@ CommandSettingsLoadDefaultValuesFromConfigFile()
         }
     }
 
+    //
+    // Set the capacity of the message buffers
+    //
+    if (CommandSettingsGetValueFromConfigFile("LogCapacity", OptionValue))
+    {
+        if (!ConvertStringToUInt32(OptionValue, &g_LogPacketsCapacityPerCore))
+        {
+            //
+            // Sth is incorrect
+            //
+            g_LogPacketsCapacityPerCore = 0;
+            ShowMessages("err, incorrect log capacity settings\n");
+        }
+    }
+
+    //
+    // Set the maximum capacity of the message buffers
+    //
+    if (CommandSettingsGetValueFromConfigFile("LogMaxCapacity", OptionValue))
+    {
+        if (!ConvertStringToUInt32(OptionValue, &g_LogMaximumPacketsCapacityPerCore))
+        {
+            //
+            // Sth is incorrect
+            //
+            g_LogMaximumPacketsCapacityPerCore = 0;
+            ShowMessages("err, incorrect log maximum capacity settings\n");
+        }
+    }
+
+    //
+    // Set the flush interval of the results of the remote debuggee
+    //
+    if (CommandSettingsGetValueFromConfigFile("RemoteFlushInterval", OptionValue))
+    {
+        if (!ConvertStringToUInt32(OptionValue, &g_RemoteConnectionFlushInterval))
+        {
+            //
+            // Sth is incorrect
+            //
+            g_RemoteConnectionFlushInterval = REMOTE_CONNECTION_DEFAULT_FLUSH_INTERVAL;
+            ShowMessages("err, incorrect remote flush interval settings\n");
+        }
+    }
+
+    //
+    // Set the batch size of the results of the remote debuggee
+    //
+    if (CommandSettingsGetValueFromConfigFile("RemoteBatchSize", OptionValue))
+    {
+        if (!ConvertStringToUInt32(OptionValue, &g_RemoteConnectionMaximumBatchSize) ||
+            g_RemoteConnectionMaximumBatchSize == 0 ||
+            g_RemoteConnectionMaximumBatchSize > REMOTE_CONNECTION_MAXIMUM_FRAME_SIZE)
+        {
+            //
+            // Sth is incorrect
+            //
+            g_RemoteConnectionMaximumBatchSize = REMOTE_CONNECTION_DEFAULT_MAXIMUM_BATCH_SIZE;
+            ShowMessages("err, incorrect remote batch size settings\n");
+        }
+    }
+
     //
     // Set the address conversion
     //
@@ -391,6 +471,390 @@ CommandSettingsAutoFlush(vector<string> SplittedCommand)
     }
 }
 
+/**
+ * @brief set the binary trace mode (of printf) to enabled and disabled
+ * and query the status of this mode
+ *
+ * @param SplittedCommand
+ * @return VOID
+ */
+VOID
+CommandSettingsBinaryTrace(vector<string> SplittedCommand)
+{
+    BOOL                               Status;
+    ULONG                              ReturnedLength;
+    DEBUGGER_BINARY_TRACE_MODE_REQUEST BinaryTraceRequest = {0};
+
+    if (SplittedCommand.size() == 2)
+    {
+        //
+        // It's a query
+        //
+        if (g_BinaryTraceMode)
+        {
+            ShowMessages("binary trace is enabled\n");
+        }
+        else
+        {
+            ShowMessages("binary trace is disabled\n");
+        }
+    }
+    else if (SplittedCommand.size() == 3)
+    {
+        //
+        // The user tries to set a value as the binary trace mode
+        //
+        if (!SplittedCommand.at(2).compare("on"))
+        {
+            BinaryTraceRequest.IsEnabled = TRUE;
+        }
+        else if (!SplittedCommand.at(2).compare("off"))
+        {
+            BinaryTraceRequest.IsEnabled = FALSE;
+        }
+        else
+        {
+            //
+            // Sth is incorrect
+            //
+            ShowMessages("incorrect use of 'settings', please use 'help settings' "
+                         "for more details\n");
+            return;
+        }
+
+        if (g_IsSerialConnectedToRemoteDebuggee)
+        {
+            //
+            // Messages of the debugger-mode are formatted in the debuggee
+            //
+            ShowMessages("err, binary trace is not supported in the debugger mode\n");
+            return;
+        }
+
+        AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+
+        Status = DeviceIoControl(
+            g_DeviceHandle,                            // Handle to device
+            IOCTL_SET_BINARY_TRACE_MODE,               // IO Control code
+            &BinaryTraceRequest,                       // Input Buffer to driver.
+            SIZEOF_DEBUGGER_BINARY_TRACE_MODE_REQUEST, // Input buffer length
+            &BinaryTraceRequest,                       // Output Buffer from driver.
+            SIZEOF_DEBUGGER_BINARY_TRACE_MODE_REQUEST, // Length of output buffer in
+                                                       // bytes.
+            &ReturnedLength,                           // Bytes placed in buffer.
+            NULL                                       // synchronous call
+        );
+
+        if (!Status)
+        {
+            ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+            return;
+        }
+
+        if (BinaryTraceRequest.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+        {
+            ShowErrorMessage(BinaryTraceRequest.KernelStatus);
+            return;
+        }
+
+        g_BinaryTraceMode = BinaryTraceRequest.IsEnabled;
+
+        if (g_BinaryTraceMode)
+        {
+            ShowMessages("set binary trace to enabled\n");
+        }
+        else
+        {
+            ShowMessages("set binary trace to disabled\n");
+        }
+    }
+    else
+    {
+        //
+        // Sth is incorrect
+        //
+        ShowMessages("incorrect use of 'settings', please use 'help settings' "
+                     "for more details\n");
+        return;
+    }
+}
+
+/**
+ * @brief show the statistics of the message buffers of all cores
+ *
+ * @return VOID
+ */
+VOID
+CommandSettingsShowLogBuffersStatistics()
+{
+    BOOL                                   Status;
+    ULONG                                  ReturnedLength;
+    PDEBUGGER_QUERY_LOG_BUFFERS_STATISTICS StatisticsRequest;
+    const CHAR *                           BufferNames[] = {"vmx non-root", "vmx non-root (priority)", "vmx-root", "vmx-root (priority)"};
+
+    StatisticsRequest = (PDEBUGGER_QUERY_LOG_BUFFERS_STATISTICS)malloc(SIZEOF_DEBUGGER_QUERY_LOG_BUFFERS_STATISTICS);
+
+    if (StatisticsRequest == NULL)
+    {
+        return;
+    }
+
+    RtlZeroMemory(StatisticsRequest, SIZEOF_DEBUGGER_QUERY_LOG_BUFFERS_STATISTICS);
+
+    Status = DeviceIoControl(
+        g_DeviceHandle,                               // Handle to device
+        IOCTL_QUERY_LOG_BUFFERS_STATISTICS,           // IO Control code
+        StatisticsRequest,                            // Input Buffer to driver.
+        SIZEOF_DEBUGGER_QUERY_LOG_BUFFERS_STATISTICS, // Input buffer length
+        StatisticsRequest,                            // Output Buffer from driver.
+        SIZEOF_DEBUGGER_QUERY_LOG_BUFFERS_STATISTICS, // Length of output buffer in
+                                                      // bytes.
+        &ReturnedLength,                              // Bytes placed in buffer.
+        NULL                                          // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        free(StatisticsRequest);
+        return;
+    }
+
+    if (StatisticsRequest->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(StatisticsRequest->KernelStatus);
+        free(StatisticsRequest);
+        return;
+    }
+
+    //
+    // Each core has four buffers, the order is the same as the order of
+    // the buffers that are mapped into the user-mode
+    //
+    for (UINT32 i = 0; i < StatisticsRequest->CountOfBuffers; i++)
+    {
+        if (i % 4 == 0)
+        {
+            ShowMessages("core : %x\n", i / 4);
+        }
+
+        ShowMessages("\t%-24s capacity: %x, high water mark: %x, dropped: %llx, discarded: %llx\n",
+                     BufferNames[i % 4],
+                     StatisticsRequest->Buffers[i].PacketsCapacity,
+                     StatisticsRequest->Buffers[i].HighWaterMark,
+                     StatisticsRequest->Buffers[i].DroppedMessages,
+                     StatisticsRequest->Buffers[i].DiscardedMessages);
+    }
+
+    free(StatisticsRequest);
+}
+
+/**
+ * @brief set the capacity (or the maximum capacity) of the message buffers
+ * of each core and query the current capacities
+ * @details the capacities are applied once the driver is loaded again
+ *
+ * @param SplittedCommand
+ * @param IsMaximum
+ * @return VOID
+ */
+VOID
+CommandSettingsLogCapacity(vector<string> SplittedCommand, BOOLEAN IsMaximum)
+{
+    UINT32 Value = 0;
+
+    if (SplittedCommand.size() == 2)
+    {
+        //
+        // It's a query
+        //
+        if (g_LogPacketsCapacityPerCore == 0)
+        {
+            ShowMessages("log capacity : default\n");
+        }
+        else
+        {
+            ShowMessages("log capacity : %x\n", g_LogPacketsCapacityPerCore);
+        }
+
+        if (g_LogMaximumPacketsCapacityPerCore == 0)
+        {
+            ShowMessages("log maximum capacity : not grown\n");
+        }
+        else
+        {
+            ShowMessages("log maximum capacity : %x\n", g_LogMaximumPacketsCapacityPerCore);
+        }
+
+        //
+        // Show the current state of the buffers if the driver is loaded
+        //
+        if (g_DeviceHandle)
+        {
+            CommandSettingsShowLogBuffersStatistics();
+        }
+    }
+    else if (SplittedCommand.size() == 3)
+    {
+        if (!ConvertStringToUInt32(SplittedCommand.at(2), &Value))
+        {
+            ShowMessages("incorrect use of 'settings', please use 'help settings' "
+                         "for more details\n");
+            return;
+        }
+
+        if (IsMaximum)
+        {
+            g_LogMaximumPacketsCapacityPerCore = Value;
+            CommandSettingsSetValueFromConfigFile("LogMaxCapacity", SplittedCommand.at(2));
+            ShowMessages("set log maximum capacity to %x\n", Value);
+        }
+        else
+        {
+            g_LogPacketsCapacityPerCore = Value;
+            CommandSettingsSetValueFromConfigFile("LogCapacity", SplittedCommand.at(2));
+            ShowMessages("set log capacity to %x\n", Value);
+        }
+
+        if (g_DeviceHandle)
+        {
+            ShowMessages("the new capacity is applied once the driver is loaded again\n");
+        }
+    }
+    else
+    {
+        //
+        // Sth is incorrect
+        //
+        ShowMessages("incorrect use of 'settings', please use 'help settings' "
+                     "for more details\n");
+        return;
+    }
+}
+
+/**
+ * @brief set and query the flush interval and the batch size of
+ * the results that are sent to the remote debugger
+ *
+ * @param SplittedCommand
+ * @param IsBatchSize
+ * @return VOID
+ */
+VOID
+CommandSettingsRemoteCoalescing(vector<string> SplittedCommand, BOOLEAN IsBatchSize)
+{
+    UINT32 Value = 0;
+
+    if (SplittedCommand.size() == 2)
+    {
+        //
+        // It's a query
+        //
+        if (IsBatchSize)
+        {
+            ShowMessages("remote batch size : %x bytes\n", g_RemoteConnectionMaximumBatchSize);
+        }
+        else
+        {
+            ShowMessages("remote flush interval : %x milliseconds\n", g_RemoteConnectionFlushInterval);
+        }
+    }
+    else if (SplittedCommand.size() == 3)
+    {
+        if (!ConvertStringToUInt32(SplittedCommand.at(2), &Value) ||
+            (IsBatchSize && (Value == 0 || Value > REMOTE_CONNECTION_MAXIMUM_FRAME_SIZE)))
+        {
+            ShowMessages("incorrect use of 'settings', please use 'help settings' "
+                         "for more details\n");
+            return;
+        }
+
+        if (IsBatchSize)
+        {
+            g_RemoteConnectionMaximumBatchSize = Value;
+            CommandSettingsSetValueFromConfigFile("RemoteBatchSize", SplittedCommand.at(2));
+            ShowMessages("set remote batch size to %x bytes\n", Value);
+        }
+        else
+        {
+            g_RemoteConnectionFlushInterval = Value;
+            CommandSettingsSetValueFromConfigFile("RemoteFlushInterval", SplittedCommand.at(2));
+            ShowMessages("set remote flush interval to %x milliseconds\n", Value);
+        }
+    }
+    else
+    {
+        //
+        // Sth is incorrect
+        //
+        ShowMessages("incorrect use of 'settings', please use 'help settings' "
+                     "for more details\n");
+        return;
+    }
+}
+
+/**
+ * @brief set and query the watchdog that continues the halted debuggee
+ * if there is no command for the timeout (milliseconds)
+ * @details zero disables the watchdog
+ *
+ * @param SplittedCommand
+ * @return VOID
+ */
+VOID
+CommandSettingsHaltWatchdog(vector<string> SplittedCommand)
+{
+    DEBUGGER_HALT_WATCHDOG_REQUEST HaltWatchdogRequest = {0};
+
+    if (SplittedCommand.size() == 2)
+    {
+        HaltWatchdogRequest.IsQuery = TRUE;
+    }
+    else if (SplittedCommand.size() != 3 || !ConvertStringToUInt32(SplittedCommand.at(2), &HaltWatchdogRequest.Timeout))
+    {
+        ShowMessages("incorrect use of 'settings', please use 'help settings' "
+                     "for more details\n");
+        return;
+    }
+
+    //
+    // The watchdog runs in the debuggee while it's halted
+    //
+    if (!g_IsSerialConnectedToRemoteDebuggee || g_IsDebuggeeRunning)
+    {
+        ShowMessages("err, the halt watchdog is only supported in the Debugger Mode "
+                     "while the debuggee is paused\n");
+        return;
+    }
+
+    if (!KdSendHaltWatchdogPacketToDebuggee(&HaltWatchdogRequest))
+    {
+        return;
+    }
+
+    if (HaltWatchdogRequest.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(HaltWatchdogRequest.KernelStatus);
+        return;
+    }
+
+    if (HaltWatchdogRequest.Timeout == 0)
+    {
+        ShowMessages("halt watchdog : disabled\n");
+    }
+    else
+    {
+        ShowMessages("halt watchdog : %x milliseconds\n", HaltWatchdogRequest.Timeout);
+    }
+
+    ShowMessages("count of timeouts : %llx\n", HaltWatchdogRequest.CountOfTimeouts);
+
+    if (HaltWatchdogRequest.CountOfTimeouts != 0)
+    {
+        ShowMessages("time-stamp of the last timeout : %llx\n", HaltWatchdogRequest.LastTimeoutTsc);
+    }
+}
+
 /**
  * @brief set auto-unpause mode to enabled or disabled
  *
@@ -541,7 +1005,7 @@ CommandSettingsSyntax(vector<string> SplittedCommand)
  * @return VOID
  */
 VOID
-CommandSettings(vector<string> SplittedCommand, string Command)
+CommandSettings(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() <= 1)
     {
@@ -596,6 +1060,66 @@ CommandSettings(vector<string> SplittedCommand, string Command)
             CommandSettingsAutoFlush(SplittedCommand);
         }
     }
+    else if (!SplittedCommand.at(1).compare("binarytrace"))
+    {
+        //
+        // If it's a remote debugger then we send it to the remote debugger
+        //
+        if (g_IsConnectedToRemoteDebuggee)
+        {
+            RemoteConnectionSendCommand(Command.c_str(), Command.length() + 1);
+        }
+        else
+        {
+            //
+            // If it's a connection over serial or a local debugging then
+            // we handle it locally
+            //
+            CommandSettingsBinaryTrace(SplittedCommand);
+        }
+    }
+    else if (!SplittedCommand.at(1).compare("logcapacity") ||
+             !SplittedCommand.at(1).compare("logmaxcapacity"))
+    {
+        //
+        // If it's a remote debugger then we send it to the remote debugger
+        //
+        if (g_IsConnectedToRemoteDebuggee)
+        {
+            RemoteConnectionSendCommand(Command.c_str(), Command.length() + 1);
+        }
+        else
+        {
+            //
+            // If it's a connection over serial or a local debugging then
+            // we handle it locally
+            //
+            CommandSettingsLogCapacity(SplittedCommand, !SplittedCommand.at(1).compare("logmaxcapacity"));
+        }
+    }
+    else if (!SplittedCommand.at(1).compare("remoteflushinterval") ||
+             !SplittedCommand.at(1).compare("remotebatchsize"))
+    {
+        //
+        // The results are coalesced by the remote debuggee, so we send
+        // it to the remote debugger
+        //
+        if (g_IsConnectedToRemoteDebuggee)
+        {
+            RemoteConnectionSendCommand(Command.c_str(), Command.length() + 1);
+        }
+        else
+        {
+            CommandSettingsRemoteCoalescing(SplittedCommand, !SplittedCommand.at(1).compare("remotebatchsize"));
+        }
+    }
+    else if (!SplittedCommand.at(1).compare("haltwatchdog"))
+    {
+        //
+        // The watchdog is set in the debuggee of the Debugger Mode
+        //
+        CommandSettingsHaltWatchdog(SplittedCommand);
+    }
     else if (!SplittedCommand.at(1).compare("addressconversion"))
     {
         //
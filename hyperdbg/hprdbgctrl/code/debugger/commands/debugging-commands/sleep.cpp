@@ -34,7 +34,7 @@ CommandSleepHelp()
  * @return VOID
  */
 VOID
-CommandSleep(vector<string> SplittedCommand, string Command)
+CommandSleep(vector<string> & SplittedCommand, string & Command)
 {
     UINT32 MillisecondsTime = 0;
 
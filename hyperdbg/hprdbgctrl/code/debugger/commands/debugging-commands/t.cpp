@@ -18,6 +18,8 @@ extern BOOLEAN                  g_IsSerialConnectedToRemoteDebuggee;
 extern BOOLEAN                  g_IsInstrumentingInstructions;
 extern ACTIVE_DEBUGGING_PROCESS g_ActiveProcessDebuggingState;
 
+extern std::map<std::string, REGS_ENUM> RegistersMap;
+
 /**
  * @brief help of t command
  *
@@ -34,11 +36,75 @@ CommandTHelp()
     ShowMessages("syntax : \tt [Count (hex)]\n");
     ShowMessages("syntax : \ttr\n");
     ShowMessages("syntax : \ttr [Count (hex)]\n");
+    ShowMessages("syntax : \tt trace [Count (hex)] [Register (string)]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : t\n");
     ShowMessages("\t\te.g : tr\n");
     ShowMessages("\t\te.g : tr 1f\n");
+    ShowMessages("\t\te.g : t trace 186a0\n");
+    ShowMessages("\t\te.g : t trace 186a0 @rax\n");
+
+    ShowMessages("\n");
+    ShowMessages("the 'trace' performs all of the steps in the debuggee (kernel debugger only) "
+                 "and shows the RIP after each step, optionally along with the value of "
+                 "the register\n");
+}
+
+/**
+ * @brief Perform multiple steps in the debuggee and show the trace of them
+ * @details used by 't trace' and 'i trace' commands
+ *
+ * @param SplittedCommand
+ * @param StepType
+ *
+ * @return BOOLEAN Returns FALSE if the command is not valid
+ */
+BOOLEAN
+CommandTraceSteps(vector<string> SplittedCommand, DEBUGGER_REMOTE_STEPPING_REQUEST StepType)
+{
+    UINT32 StepCount;
+    UINT32 RecordedRegister = DEBUGGEE_STEP_TRACE_NO_REGISTER;
+    string RegisterName;
+
+    if (SplittedCommand.size() != 3 && SplittedCommand.size() != 4)
+    {
+        return FALSE;
+    }
+
+    if (!ConvertStringToUInt32(SplittedCommand.at(2), &StepCount) || StepCount == 0)
+    {
+        ShowMessages("please specify a correct hex value for [count]\n\n");
+        return FALSE;
+    }
+
+    if (SplittedCommand.size() == 4)
+    {
+        RegisterName = SplittedCommand.at(3);
+        ReplaceAll(RegisterName, "@", "");
+
+        if (RegistersMap.find(RegisterName) == RegistersMap.end())
+        {
+            ShowMessages("err, couldn't resolve register '%s'\n\n", SplittedCommand.at(3).c_str());
+            return FALSE;
+        }
+
+        RecordedRegister = RegistersMap[RegisterName];
+    }
+
+    if (!g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, tracing the steps is only supported in the Debugger Mode\n");
+        return TRUE;
+    }
+
+    //
+    // All of the steps are performed in the debuggee, the trace is shown
+    // once its chunks are received
+    //
+    KdSendStepAndTracePacketToDebuggee(StepType, StepCount, RecordedRegister);
+
+    return TRUE;
 }
 
 /**
@@ -49,11 +115,25 @@ CommandTHelp()
  * @return VOID
  */
 VOID
-CommandT(vector<string> SplittedCommand, string Command)
+CommandT(vector<string> & SplittedCommand, string & Command)
 {
     UINT32                           StepCount;
     DEBUGGER_REMOTE_STEPPING_REQUEST RequestFormat;
 
+    //
+    // Check if the steps should be traced in the debuggee
+    //
+    if (SplittedCommand.size() >= 2 && !SplittedCommand.at(0).compare("t") && !SplittedCommand.at(1).compare("trace"))
+    {
+        if (!CommandTraceSteps(SplittedCommand, DEBUGGER_REMOTE_STEPPING_REQUEST_STEP_IN))
+        {
+            ShowMessages("incorrect use of 't'\n\n");
+            CommandTHelp();
+        }
+
+        return;
+    }
+
     //
     // Validate the commands
     //
@@ -14,7 +14,20 @@
 //
 // Global Variables
 //
-extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+extern BOOLEAN         g_IsSerialConnectedToRemoteDebuggee;
+extern volatile LONG64 g_KernelStressReceivedMessages;
+
+/**
+ * @brief The state of a scenario of the stress test that is performed
+ * by a separate thread (while the hooks are changed)
+ *
+ */
+typedef struct _TEST_STRESS_IOCTL_THREAD_CONTEXT
+{
+    PDEBUGGER_PERFORM_KERNEL_STRESS StressRequest;
+    BOOLEAN                         Result;
+
+} TEST_STRESS_IOCTL_THREAD_CONTEXT, *PTEST_STRESS_IOCTL_THREAD_CONTEXT;
 
 /**
  * @brief help of test command
@@ -28,12 +41,38 @@ CommandTestHelp()
         "test : tests essential features of HyperDbg in current machine.\n");
 
     ShowMessages("syntax : \ttest [Task (string)]\n");
+    ShowMessages("syntax : \ttest [benchmark] [Iterations (hex)] [DummyEvents (hex)]\n");
+    ShowMessages("syntax : \ttest [scaling] [EventType (cpuid | msrread)] [Iterations (hex)]\n");
+    ShowMessages("syntax : \ttest [transport] [Count (hex)]\n");
+    ShowMessages("syntax : \ttest [stress] [Scenario (hook | churn | log | all)] [ThreadsPerCore (hex)] [Duration (hex)]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : test\n");
     ShowMessages("\t\te.g : test query\n");
     ShowMessages("\t\te.g : test breakpoint on\n");
     ShowMessages("\t\te.g : test breakpoint off\n");
+    ShowMessages("\t\te.g : test benchmark\n");
+    ShowMessages("\t\te.g : test benchmark 1000 20\n");
+    ShowMessages("\t\te.g : test scaling cpuid\n");
+    ShowMessages("\t\te.g : test scaling msrread 100\n");
+    ShowMessages("\t\te.g : test transport\n");
+    ShowMessages("\t\te.g : test transport 10\n");
+    ShowMessages("\t\te.g : test stress all\n");
+    ShowMessages("\t\te.g : test stress hook 4 2710\n");
+
+    ShowMessages("\n");
+    ShowMessages("the 'benchmark' measures the round-trip cycles of the instructions that cause "
+                 "vm-exits on each core, without events, with the dummy events (of each type), "
+                 "and with a trivial script, the results are shown in JSON format\n");
+    ShowMessages("the 'scaling' measures the cost of each vm-exit while 1, 10, 100 and 1000 "
+                 "non-matching events, or matching events with a condition, are registered\n");
+    ShowMessages("the 'transport' measures the throughput and the latency of the link of the debugger "
+                 "and the debuggee (in debugger mode) for different sizes of payloads\n");
+    ShowMessages("the 'stress' runs threads on each core for the duration (in milliseconds), 'hook' calls "
+                 "a hooked function ('!epthook'), 'churn' calls the function while its hook is added "
+                 "and removed continuously, and 'log' floods the messages from every core, the "
+                 "throughput, the worst-case cycles of each operation, the messages that are lost and "
+                 "the threads that are hung (deadlocked) are shown\n");
 }
 
 /**
@@ -91,17 +130,302 @@ CommandTestPerformKernelTestsIoctl()
     }
 }
 
+/**
+ * @brief Send an IOCTL to the kernel to run the benchmark
+ * @details the results of the cores are stored after the request
+ *
+ * @param BenchmarkRequest The request and the results (the buffer is
+ * TEST_CASE_MAXIMUM_BUFFERS_TO_COMMUNICATE bytes)
+ * @param Iterations Iterations of each operation
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandTestRunKernelBenchmark(PDEBUGGER_PERFORM_KERNEL_BENCHMARK BenchmarkRequest, UINT32 Iterations)
+{
+    BOOL  Status;
+    ULONG ReturnedLength;
+
+    RtlZeroMemory(BenchmarkRequest, TEST_CASE_MAXIMUM_BUFFERS_TO_COMMUNICATE);
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    BenchmarkRequest->Iterations   = Iterations;
+    BenchmarkRequest->TrappedMsr   = TEST_BENCHMARK_TRAPPED_MSR;
+    BenchmarkRequest->UntrappedMsr = TEST_BENCHMARK_UNTRAPPED_MSR;
+    BenchmarkRequest->IoPort       = TEST_BENCHMARK_IO_PORT;
+
+    Status = DeviceIoControl(
+        g_DeviceHandle,                           // Handle to device
+        IOCTL_PERFORM_KERNEL_SIDE_BENCHMARK,      // IO Control code
+        BenchmarkRequest,                         // Input Buffer to driver.
+        SIZEOF_DEBUGGER_PERFORM_KERNEL_BENCHMARK, // Input buffer length
+        BenchmarkRequest,                         // Output Buffer from driver.
+        TEST_CASE_MAXIMUM_BUFFERS_TO_COMMUNICATE, // Length of output buffer in
+                                                  // bytes.
+        &ReturnedLength,                          // Bytes placed in buffer.
+        NULL                                      // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        return FALSE;
+    }
+
+    if (BenchmarkRequest->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(BenchmarkRequest->KernelStatus);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Run the kernel-side benchmark and send the results to the
+ * test process
+ *
+ * @param PipeHandle Handle of the pipe of the test process
+ * @param Iterations Iterations of each operation
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandTestPerformKernelBenchmarkIoctl(HANDLE PipeHandle, UINT32 Iterations)
+{
+    PDEBUGGER_PERFORM_KERNEL_BENCHMARK BenchmarkRequest;
+    BOOLEAN                            Result;
+
+    BenchmarkRequest = (PDEBUGGER_PERFORM_KERNEL_BENCHMARK)malloc(TEST_CASE_MAXIMUM_BUFFERS_TO_COMMUNICATE);
+
+    if (BenchmarkRequest == NULL)
+    {
+        return FALSE;
+    }
+
+    Result = CommandTestRunKernelBenchmark(BenchmarkRequest, Iterations);
+
+    //
+    // The test process is waiting for the results, so they're always sent
+    // (the results are empty if the benchmark is failed)
+    //
+    if (!Result)
+    {
+        BenchmarkRequest->CoresCount = 0;
+    }
+
+    if (!NamedPipeServerSendMessageToClient(PipeHandle,
+                                            (char *)BenchmarkRequest,
+                                            SIZEOF_DEBUGGER_PERFORM_KERNEL_BENCHMARK +
+                                                BenchmarkRequest->CoresCount * sizeof(DEBUGGER_KERNEL_BENCHMARK_CORE_RESULT)))
+    {
+        Result = FALSE;
+    }
+
+    free(BenchmarkRequest);
+
+    return Result;
+}
+
+/**
+ * @brief Run a command (registering or clearing events) of the scaling benchmark
+ *
+ * @param Command The command
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandTestRunScalingCommand(string Command)
+{
+    return HyperDbgInterpreter(Command.data()) == 0;
+}
+
+/**
+ * @brief Measure the average round-trip cycles of an operation on all
+ * the cores
+ *
+ * @param BenchmarkRequest Buffer of the benchmark
+ * @param Operation The target operation
+ * @param Iterations Iterations of the operation
+ * @param Cycles Average cycles of the operation
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandTestMeasureScaling(PDEBUGGER_PERFORM_KERNEL_BENCHMARK  BenchmarkRequest,
+                          DEBUGGER_KERNEL_BENCHMARK_OPERATION Operation,
+                          UINT32                              Iterations,
+                          UINT64 *                            Cycles)
+{
+    PDEBUGGER_KERNEL_BENCHMARK_CORE_RESULT CoreResults;
+    UINT64                                 TotalCycles = 0;
+
+    if (!CommandTestRunKernelBenchmark(BenchmarkRequest, Iterations) || BenchmarkRequest->CoresCount == 0)
+    {
+        return FALSE;
+    }
+
+    CoreResults = (PDEBUGGER_KERNEL_BENCHMARK_CORE_RESULT)((CHAR *)BenchmarkRequest + SIZEOF_DEBUGGER_PERFORM_KERNEL_BENCHMARK);
+
+    for (UINT32 CoreId = 0; CoreId < BenchmarkRequest->CoresCount; CoreId++)
+    {
+        TotalCycles += CoreResults[CoreId].Cycles[Operation];
+    }
+
+    *Cycles = TotalCycles / BenchmarkRequest->CoresCount;
+
+    return TRUE;
+}
+
+/**
+ * @brief Measure the cost of dispatching the events based on the count
+ * of the registered events
+ * @details 1, 10, 100 and 1000 events are registered, first the events
+ * that don't match (other process or other MSRs), then the events that
+ * match but their condition is never true
+ *
+ * @param IsMsrRead Whether the events are '!msrread' (otherwise '!cpuid')
+ * @param Iterations Iterations of the measured instruction
+ *
+ * @return VOID
+ */
+VOID
+CommandTestEventsScaling(BOOLEAN IsMsrRead, UINT32 Iterations)
+{
+    PDEBUGGER_PERFORM_KERNEL_BENCHMARK  BenchmarkRequest;
+    DEBUGGER_KERNEL_BENCHMARK_OPERATION Operation        = IsMsrRead ? DEBUGGER_KERNEL_BENCHMARK_RDMSR_TRAPPED : DEBUGGER_KERNEL_BENCHMARK_CPUID;
+    UINT32                              EventsCounts[]   = {1, 10, 100, 1000};
+    UINT64                              NonMatchingCycles[_countof(EventsCounts)];
+    UINT64                              MatchingCycles[_countof(EventsCounts)];
+    UINT64                              BaselineCycles;
+    UINT32                              RegisteredEvents = 0;
+    BOOLEAN                             Result           = TRUE;
+    ostringstream                       Command;
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+
+    //
+    // All the events are cleared after the benchmark
+    //
+    if (IsTagExist(DEBUGGER_MODIFY_EVENTS_APPLY_TO_ALL_TAG))
+    {
+        ShowMessages("err, please clear the events ('events c all') before running the benchmark\n");
+        return;
+    }
+
+    BenchmarkRequest = (PDEBUGGER_PERFORM_KERNEL_BENCHMARK)malloc(TEST_CASE_MAXIMUM_BUFFERS_TO_COMMUNICATE);
+
+    if (BenchmarkRequest == NULL)
+    {
+        return;
+    }
+
+    if (!CommandTestMeasureScaling(BenchmarkRequest, Operation, Iterations, &BaselineCycles))
+    {
+        free(BenchmarkRequest);
+        return;
+    }
+
+    //
+    // The non-matching events, the events of other processes (the benchmark
+    // is running in the debugger's process), for '!msrread' the measured MSR
+    // is trapped by an event of another process and the rest of the events
+    // are for other MSRs
+    //
+    for (UINT32 i = 0; i < _countof(EventsCounts) && Result; i++)
+    {
+        for (; RegisteredEvents < EventsCounts[i] && Result; RegisteredEvents++)
+        {
+            Command.str("");
+
+            if (!IsMsrRead)
+            {
+                Command << "!cpuid pid 4 code { c3 }";
+            }
+            else if (RegisteredEvents == 0)
+            {
+                Command << "!msrread " << hex << TEST_BENCHMARK_TRAPPED_MSR << " pid 4 code { c3 }";
+            }
+            else
+            {
+                Command << "!msrread " << hex << 0x1000 + RegisteredEvents << " code { c3 }";
+            }
+
+            Result = CommandTestRunScalingCommand(Command.str());
+        }
+
+        Result = Result && CommandTestMeasureScaling(BenchmarkRequest, Operation, Iterations, &NonMatchingCycles[i]);
+    }
+
+    CommandTestRunScalingCommand("events c all");
+
+    //
+    // The matching events, their condition is never true (xor eax, eax; ret)
+    //
+    RegisteredEvents = 0;
+
+    for (UINT32 i = 0; i < _countof(EventsCounts) && Result; i++)
+    {
+        for (; RegisteredEvents < EventsCounts[i] && Result; RegisteredEvents++)
+        {
+            Command.str("");
+
+            if (!IsMsrRead)
+            {
+                Command << "!cpuid condition { 31 c0 c3 } code { c3 }";
+            }
+            else
+            {
+                Command << "!msrread " << hex << TEST_BENCHMARK_TRAPPED_MSR << " condition { 31 c0 c3 } code { c3 }";
+            }
+
+            Result = CommandTestRunScalingCommand(Command.str());
+        }
+
+        Result = Result && CommandTestMeasureScaling(BenchmarkRequest, Operation, Iterations, &MatchingCycles[i]);
+    }
+
+    CommandTestRunScalingCommand("events c all");
+
+    free(BenchmarkRequest);
+
+    if (!Result)
+    {
+        ShowMessages("err, the benchmark is failed\n");
+        return;
+    }
+
+    //
+    // Show the average cycles of each exit on all the cores
+    //
+    ShowMessages("average cycles of '%s' on all the cores (%x iterations)\n\n",
+                 IsMsrRead ? "rdmsr" : "cpuid",
+                 Iterations);
+    ShowMessages("events\tnon-matching\tmatching (with condition)\n");
+    ShowMessages("0\t%llx\t\t%llx\n", BaselineCycles, BaselineCycles);
+
+    for (UINT32 i = 0; i < _countof(EventsCounts); i++)
+    {
+        ShowMessages("%x\t%llx\t\t%llx\n", EventsCounts[i], NonMatchingCycles[i], MatchingCycles[i]);
+    }
+}
+
 /**
  * @brief perform test on the remote process
  *
  * @param KernelSideInformation Information from kernel
  * @param KernelSideInformationSize Information from kernel ()
+ * @param TestArguments Arguments that are passed to the test process
+ * (optional)
  *
  * @return BOOLEAN returns true if the results was true and false if the results
  * was not ok
  */
 BOOLEAN
-CommandTestPerformTest(PDEBUGGEE_KERNEL_AND_USER_TEST_INFORMATION KernelSideInformation, UINT32 KernelSideInformationSize)
+CommandTestPerformTest(PDEBUGGEE_KERNEL_AND_USER_TEST_INFORMATION KernelSideInformation,
+                       UINT32                                     KernelSideInformationSize,
+                       const CHAR *                               TestArguments)
 {
     BOOLEAN ResultOfTest = FALSE;
     HANDLE  PipeHandle;
@@ -123,6 +447,7 @@ CommandTestPerformTest(PDEBUGGEE_KERNEL_AND_USER_TEST_INFORMATION KernelSideInfo
     if (!CreateProcessAndOpenPipeConnection(
             KernelSideInformation,
             KernelSideInformationSize,
+            TestArguments,
             &PipeHandle,
             &ThreadHandle,
             &ProcessHandle))
@@ -167,6 +492,25 @@ WaitForResponse:
 
         goto WaitForResponse;
     }
+    else if (strncmp(Buffer, "perform-kernel-benchmark:", strlen("perform-kernel-benchmark:")) == 0)
+    {
+        //
+        // Perform the benchmark, the iterations are after the prefix
+        //
+        CommandTestPerformKernelBenchmarkIoctl(PipeHandle,
+                                               strtoul(&Buffer[strlen("perform-kernel-benchmark:")], NULL, 16));
+
+        goto WaitForResponse;
+    }
+    else if (strncmp(Buffer, "print:", strlen("print:")) == 0)
+    {
+        //
+        // Show the message (results) of the test process
+        //
+        ShowMessages("%s", &Buffer[strlen("print:")]);
+
+        goto WaitForResponse;
+    }
     else if (strcmp(Buffer, "success") == 0)
     {
         ResultOfTest = TRUE;
@@ -201,10 +545,13 @@ WaitForResponse:
 /**
  * @brief test command for VMI mode
  *
+ * @param TestArguments Arguments that are passed to the test process
+ * (optional)
+ *
  * @return VOID
  */
 VOID
-CommandTestInVmiMode()
+CommandTestInVmiMode(const CHAR * TestArguments)
 {
     BOOL  Status;
     ULONG ReturnedLength;
@@ -249,7 +596,7 @@ CommandTestInVmiMode()
     //
     // Means to check just one command
     //
-    if (CommandTestPerformTest(KernelSideTestInformationRequestArray, ReturnedLength))
+    if (CommandTestPerformTest(KernelSideTestInformationRequestArray, ReturnedLength, TestArguments))
     {
         ShowMessages("all the tests were successful :)\n");
     }
@@ -334,6 +681,456 @@ CommandTestSetBreakpointState(BOOLEAN State)
     }
 }
 
+/**
+ * @brief Measure the throughput and the latency of the link of the
+ * debugger and the debuggee
+ * @details payloads of different sizes are sent to the debuggee and
+ * received from the debuggee, both sides check the payloads
+ *
+ * @param CountOfPackets Count of the packets of each size and direction
+ *
+ * @return VOID
+ */
+VOID
+CommandTestTransport(UINT32 CountOfPackets)
+{
+    PDEBUGGEE_TRANSPORT_TEST_PACKET TransportTestPacket;
+    UINT8 *                         Payload;
+    UINT32                          PayloadSizes[] = {0, 0x40, 0x400, 0x1000, MaxSerialTransportTestPayloadSize};
+    UINT32                          SequenceNumber = 0;
+    UINT32                          Size;
+    BOOLEAN                         IsToDebuggee;
+    LARGE_INTEGER                   Frequency;
+    LARGE_INTEGER                   Start;
+    LARGE_INTEGER                   End;
+    double                          TotalTime;
+    vector<double>                  Latencies;
+
+    if (!g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, testing the transport is only possible when you connected "
+                     "in debugger mode\n");
+        return;
+    }
+
+    TransportTestPacket = (PDEBUGGEE_TRANSPORT_TEST_PACKET)malloc(sizeof(DEBUGGEE_TRANSPORT_TEST_PACKET) + MaxSerialTransportTestPayloadSize);
+
+    if (TransportTestPacket == NULL)
+    {
+        return;
+    }
+
+    Payload = (UINT8 *)TransportTestPacket + sizeof(DEBUGGEE_TRANSPORT_TEST_PACKET);
+
+    QueryPerformanceFrequency(&Frequency);
+
+    ShowMessages("direction\tsize\tMB/s\t\tpackets/s\tlatency (us) p50\tp90\tp99\tmax\n");
+
+    for (UINT32 SizeIndex = 0; SizeIndex < _countof(PayloadSizes); SizeIndex++)
+    {
+        Size = PayloadSizes[SizeIndex];
+
+        for (UINT32 Direction = 0; Direction < 2; Direction++)
+        {
+            IsToDebuggee = Direction == 0;
+
+            //
+            // Empty packets are the same in both of the directions
+            //
+            if (Size == 0 && !IsToDebuggee)
+            {
+                continue;
+            }
+
+            Latencies.clear();
+            TotalTime = 0;
+
+            for (UINT32 i = 0; i < CountOfPackets; i++)
+            {
+                TransportTestPacket->SequenceNumber = SequenceNumber++;
+                TransportTestPacket->PayloadLength  = IsToDebuggee ? Size : 0;
+                TransportTestPacket->ResponseLength = IsToDebuggee ? 0 : Size;
+                TransportTestPacket->KernelStatus   = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+                for (UINT32 j = 0; j < TransportTestPacket->PayloadLength; j++)
+                {
+                    Payload[j] = DEBUGGEE_TRANSPORT_TEST_PATTERN(TransportTestPacket->SequenceNumber, j);
+                }
+
+                QueryPerformanceCounter(&Start);
+
+                if (!KdSendTransportTestPacketToDebuggee(TransportTestPacket))
+                {
+                    free(TransportTestPacket);
+                    return;
+                }
+
+                QueryPerformanceCounter(&End);
+
+                if (TransportTestPacket->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+                {
+                    ShowErrorMessage(TransportTestPacket->KernelStatus);
+                    free(TransportTestPacket);
+                    return;
+                }
+
+                Latencies.push_back((double)(End.QuadPart - Start.QuadPart) * 1e6 / Frequency.QuadPart);
+                TotalTime += Latencies.back();
+            }
+
+            std::sort(Latencies.begin(), Latencies.end());
+
+            ShowMessages("%s\t%x\t%-10.3f\t%-10.1f\t%-10.1f\t%.1f\t%.1f\t%.1f\n",
+                         Size == 0 ? "round-trip" : (IsToDebuggee ? "to debuggee" : "to debugger"),
+                         Size,
+                         TotalTime != 0 ? (double)Size * CountOfPackets / TotalTime * 1e6 / (1024 * 1024) : 0,
+                         TotalTime != 0 ? CountOfPackets / TotalTime * 1e6 : 0,
+                         Latencies[Latencies.size() / 2],
+                         Latencies[Latencies.size() * 90 / 100],
+                         Latencies[Latencies.size() * 99 / 100],
+                         Latencies.back());
+        }
+    }
+
+    free(TransportTestPacket);
+}
+
+/**
+ * @brief Get a value of the kernel-side test information
+ *
+ * @param Tag Tag of the value
+ * @param Value The value
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandTestGetKernelInformation(const CHAR * Tag, UINT64 * Value)
+{
+    BOOL                                       Status;
+    ULONG                                      ReturnedLength;
+    PDEBUGGEE_KERNEL_AND_USER_TEST_INFORMATION KernelInformation;
+    BOOLEAN                                    Result = FALSE;
+
+    KernelInformation = (PDEBUGGEE_KERNEL_AND_USER_TEST_INFORMATION)malloc(TEST_CASE_MAXIMUM_BUFFERS_TO_COMMUNICATE);
+
+    if (KernelInformation == NULL)
+    {
+        return FALSE;
+    }
+
+    RtlZeroMemory(KernelInformation, TEST_CASE_MAXIMUM_BUFFERS_TO_COMMUNICATE);
+
+    Status = DeviceIoControl(
+        g_DeviceHandle,                                   // Handle to device
+        IOCTL_SEND_GET_KERNEL_SIDE_TEST_INFORMATION,      // IO Control code
+        KernelInformation,                                // Input Buffer to driver.
+        SIZEOF_DEBUGGEE_KERNEL_AND_USER_TEST_INFORMATION, // Input buffer length
+        KernelInformation,                                // Output Buffer from driver.
+        TEST_CASE_MAXIMUM_BUFFERS_TO_COMMUNICATE,         // Length of output buffer in
+                                                          // bytes.
+        &ReturnedLength,                                  // Bytes placed in buffer.
+        NULL                                              // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        free(KernelInformation);
+        return FALSE;
+    }
+
+    for (size_t i = 0; i < ReturnedLength / sizeof(DEBUGGEE_KERNEL_AND_USER_TEST_INFORMATION); i++)
+    {
+        if (!strcmp(KernelInformation[i].Tag, Tag))
+        {
+            *Value = KernelInformation[i].Value;
+            Result = TRUE;
+        }
+    }
+
+    free(KernelInformation);
+
+    return Result;
+}
+
+/**
+ * @brief Send an IOCTL to the kernel to run a scenario of the stress test
+ *
+ * @param StressRequest The request and the results
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandTestRunKernelStress(PDEBUGGER_PERFORM_KERNEL_STRESS StressRequest)
+{
+    BOOL  Status;
+    ULONG ReturnedLength;
+
+    Status = DeviceIoControl(
+        g_DeviceHandle,                        // Handle to device
+        IOCTL_PERFORM_KERNEL_SIDE_STRESS_TEST, // IO Control code
+        StressRequest,                         // Input Buffer to driver.
+        SIZEOF_DEBUGGER_PERFORM_KERNEL_STRESS, // Input buffer length
+        StressRequest,                         // Output Buffer from driver.
+        SIZEOF_DEBUGGER_PERFORM_KERNEL_STRESS, // Length of output buffer in
+                                               // bytes.
+        &ReturnedLength,                       // Bytes placed in buffer.
+        NULL                                   // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        return FALSE;
+    }
+
+    if (StressRequest->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(StressRequest->KernelStatus);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief The thread that runs a scenario of the stress test while the
+ * hooks are changed by the caller
+ *
+ * @param Parameter The context (TEST_STRESS_IOCTL_THREAD_CONTEXT)
+ *
+ * @return DWORD
+ */
+DWORD WINAPI
+CommandTestStressIoctlThread(LPVOID Parameter)
+{
+    PTEST_STRESS_IOCTL_THREAD_CONTEXT Context = (PTEST_STRESS_IOCTL_THREAD_CONTEXT)Parameter;
+
+    Context->Result = CommandTestRunKernelStress(Context->StressRequest);
+
+    return 0;
+}
+
+/**
+ * @brief Wait for the messages of the log flooding to be delivered
+ * @details waits till all the sent messages are received, or no message
+ * is received for a while
+ *
+ * @param SentMessages Count of the messages that are sent by the kernel
+ *
+ * @return UINT64 Count of the received messages
+ */
+UINT64
+CommandTestStressWaitForMessages(UINT64 SentMessages)
+{
+    UINT64 Received     = 0;
+    UINT64 LastReceived = 0;
+    UINT32 IdleTime     = 0;
+
+    for (UINT32 WaitTime = 0; WaitTime < TEST_STRESS_MAXIMUM_DRAIN_TIME && IdleTime < 1000; WaitTime += 100)
+    {
+        Received = (UINT64)g_KernelStressReceivedMessages;
+
+        if (Received >= SentMessages)
+        {
+            break;
+        }
+
+        IdleTime     = Received == LastReceived ? IdleTime + 100 : 0;
+        LastReceived = Received;
+
+        Sleep(100);
+    }
+
+    return (UINT64)g_KernelStressReceivedMessages;
+}
+
+/**
+ * @brief Perform a scenario of the stress test and show its results
+ *
+ * @param Scenario Name of the scenario (hook, churn or log)
+ * @param ThreadsPerCore Count of the threads of each core
+ * @param Duration Duration of the scenario (in milliseconds)
+ *
+ * @return BOOLEAN FALSE if the scenario is not performed or something
+ * is lost or hung
+ */
+BOOLEAN
+CommandTestStressScenario(const string & Scenario, UINT32 ThreadsPerCore, UINT32 Duration)
+{
+    DEBUGGER_PERFORM_KERNEL_STRESS   StressRequest = {0};
+    TEST_STRESS_IOCTL_THREAD_CONTEXT ThreadContext = {0};
+    UINT64                           TargetFunction;
+    UINT64                           HookChanges   = 0;
+    UINT64                           Received      = 0;
+    UINT64                           Lost          = 0;
+    HANDLE                           ThreadHandle;
+    BOOLEAN                          IsLogFlood    = !Scenario.compare("log");
+    BOOLEAN                          Result;
+    ostringstream                    HookCommand;
+    double                           Seconds;
+
+    StressRequest.Scenario       = IsLogFlood ? DEBUGGER_KERNEL_STRESS_LOG_FLOOD : DEBUGGER_KERNEL_STRESS_CALL_TARGET_FUNCTION;
+    StressRequest.ThreadsPerCore = ThreadsPerCore;
+    StressRequest.Duration       = Duration;
+
+    if (IsLogFlood)
+    {
+        InterlockedExchange64(&g_KernelStressReceivedMessages, 0);
+
+        Result = CommandTestRunKernelStress(&StressRequest);
+
+        if (Result)
+        {
+            Received = CommandTestStressWaitForMessages(StressRequest.Operations - StressRequest.FailedOperations);
+
+            if (Received < StressRequest.Operations - StressRequest.FailedOperations)
+            {
+                Lost = StressRequest.Operations - StressRequest.FailedOperations - Received;
+            }
+        }
+    }
+    else
+    {
+        if (!CommandTestGetKernelInformation("KernelStressTargetFunction", &TargetFunction))
+        {
+            ShowMessages("err, the target function of the stress test is not found\n");
+            return FALSE;
+        }
+
+        HookCommand << "!epthook " << hex << TargetFunction << " code { c3 }";
+
+        if (!Scenario.compare("hook"))
+        {
+            //
+            // The function is hooked during the whole scenario
+            //
+            Result = CommandTestRunScalingCommand(HookCommand.str()) &&
+                     CommandTestRunKernelStress(&StressRequest);
+        }
+        else
+        {
+            //
+            // The function is hooked and unhooked continuously while the
+            // threads call it
+            //
+            ThreadContext.StressRequest = &StressRequest;
+
+            ThreadHandle = CreateThread(NULL, 0, CommandTestStressIoctlThread, &ThreadContext, 0, NULL);
+
+            if (ThreadHandle == NULL)
+            {
+                ShowMessages("err, unable to create the thread of the stress test (%x)\n", GetLastError());
+                return FALSE;
+            }
+
+            while (WaitForSingleObject(ThreadHandle, 0) == WAIT_TIMEOUT)
+            {
+                CommandTestRunScalingCommand(HookCommand.str());
+                CommandTestRunScalingCommand("events c all");
+
+                HookChanges++;
+            }
+
+            CloseHandle(ThreadHandle);
+
+            Result = ThreadContext.Result;
+        }
+
+        CommandTestRunScalingCommand("events c all");
+    }
+
+    if (!Result)
+    {
+        ShowMessages("err, the '%s' scenario of the stress test is failed\n", Scenario.c_str());
+        return FALSE;
+    }
+
+    Seconds = (double)StressRequest.ElapsedTime / 10000000;
+
+    ShowMessages("scenario : %s, threads : %x, duration : %x ms\n", Scenario.c_str(), StressRequest.CountOfThreads, Duration);
+    ShowMessages("\toperations : %llx (%.1f per second)\n",
+                 StressRequest.Operations,
+                 Seconds != 0 ? (double)StressRequest.Operations / Seconds : 0);
+    ShowMessages("\tcycles of each operation : average %llx, worst-case %llx\n",
+                 StressRequest.Operations != 0 ? StressRequest.TotalCycles / StressRequest.Operations : 0,
+                 StressRequest.MaximumCycles);
+
+    if (IsLogFlood)
+    {
+        ShowMessages("\tmessages : sent %llx, dropped (buffers were full) %llx, received %llx, lost %llx\n",
+                     StressRequest.Operations - StressRequest.FailedOperations,
+                     StressRequest.FailedOperations,
+                     Received,
+                     Lost);
+    }
+    else if (HookChanges != 0)
+    {
+        ShowMessages("\thook changes : %llx\n", HookChanges);
+    }
+
+    ShowMessages("\thung threads : %x\n", StressRequest.HungThreads);
+
+    Result = StressRequest.HungThreads == 0 && Lost == 0;
+
+    ShowMessages("\tresult : %s\n\n", Result ? "passed" : "failed");
+
+    return Result;
+}
+
+/**
+ * @brief Perform the stress test
+ *
+ * @param Scenario Name of the scenario (hook, churn, log or all)
+ * @param ThreadsPerCore Count of the threads of each core
+ * @param Duration Duration of each scenario (in milliseconds)
+ *
+ * @return VOID
+ */
+VOID
+CommandTestStress(const string & Scenario, UINT32 ThreadsPerCore, UINT32 Duration)
+{
+    vector<string> Scenarios;
+    BOOLEAN        Result = TRUE;
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+
+    //
+    // All the events are cleared after the hooks are tested
+    //
+    if (Scenario.compare("log") && IsTagExist(DEBUGGER_MODIFY_EVENTS_APPLY_TO_ALL_TAG))
+    {
+        ShowMessages("err, please clear the events ('events c all') before running the stress test\n");
+        return;
+    }
+
+    if (!Scenario.compare("all"))
+    {
+        Scenarios = {"hook", "churn", "log"};
+    }
+    else
+    {
+        Scenarios = {Scenario};
+    }
+
+    for (auto & Item : Scenarios)
+    {
+        if (!CommandTestStressScenario(Item, ThreadsPerCore, Duration))
+        {
+            Result = FALSE;
+        }
+    }
+
+    if (Result)
+    {
+        ShowMessages("the stress test is passed :)\n");
+    }
+    else
+    {
+        ShowMessages("the stress test is failed :(\n");
+    }
+}
+
 /**
  * @brief test command handler
  *
@@ -342,14 +1139,129 @@ CommandTestSetBreakpointState(BOOLEAN State)
  * @return VOID
  */
 VOID
-CommandTest(vector<string> SplittedCommand, string Command)
+CommandTest(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() == 1)
     {
         //
         // For testing in vmi mode
         //
-        CommandTestInVmiMode();
+        CommandTestInVmiMode(NULL);
+    }
+    else if (SplittedCommand.size() <= 4 && !SplittedCommand.at(1).compare("benchmark"))
+    {
+        UINT32 Iterations  = TEST_BENCHMARK_DEFAULT_ITERATIONS;
+        UINT32 DummyEvents = TEST_BENCHMARK_DEFAULT_DUMMY_EVENTS;
+        CHAR   TestArguments[MAX_PATH];
+
+        if (SplittedCommand.size() >= 3 &&
+            (!ConvertStringToUInt32(SplittedCommand.at(2), &Iterations) ||
+             Iterations == 0 ||
+             Iterations > TEST_BENCHMARK_MAXIMUM_ITERATIONS))
+        {
+            ShowMessages("err, iterations should be between 1 and %x\n\n", TEST_BENCHMARK_MAXIMUM_ITERATIONS);
+            return;
+        }
+
+        if (SplittedCommand.size() == 4 && !ConvertStringToUInt32(SplittedCommand.at(3), &DummyEvents))
+        {
+            ShowMessages("err, couldn't resolve error at '%s'\n\n", SplittedCommand.at(3).c_str());
+            return;
+        }
+
+        if (g_IsSerialConnectedToRemoteDebuggee)
+        {
+            ShowMessages("err, the benchmark is only supported in VMI mode\n");
+            return;
+        }
+
+        //
+        // Run the benchmark mode of the test process
+        //
+        sprintf_s(TestArguments, sizeof(TestArguments), "benchmark %x %x", Iterations, DummyEvents);
+
+        CommandTestInVmiMode(TestArguments);
+    }
+    else if ((SplittedCommand.size() == 3 || SplittedCommand.size() == 4) && !SplittedCommand.at(1).compare("scaling"))
+    {
+        UINT32 Iterations = TEST_BENCHMARK_DEFAULT_ITERATIONS;
+
+        if (SplittedCommand.at(2).compare("cpuid") && SplittedCommand.at(2).compare("msrread"))
+        {
+            ShowMessages("err, couldn't resolve error at '%s'\n\n", SplittedCommand.at(2).c_str());
+            return;
+        }
+
+        if (SplittedCommand.size() == 4 &&
+            (!ConvertStringToUInt32(SplittedCommand.at(3), &Iterations) ||
+             Iterations == 0 ||
+             Iterations > TEST_BENCHMARK_MAXIMUM_ITERATIONS))
+        {
+            ShowMessages("err, iterations should be between 1 and %x\n\n", TEST_BENCHMARK_MAXIMUM_ITERATIONS);
+            return;
+        }
+
+        if (g_IsSerialConnectedToRemoteDebuggee)
+        {
+            ShowMessages("err, the benchmark is only supported in VMI mode\n");
+            return;
+        }
+
+        CommandTestEventsScaling(!SplittedCommand.at(2).compare("msrread"), Iterations);
+    }
+    else if (SplittedCommand.size() <= 3 && !SplittedCommand.at(1).compare("transport"))
+    {
+        UINT32 CountOfPackets = TEST_TRANSPORT_DEFAULT_PACKETS;
+
+        if (SplittedCommand.size() == 3 &&
+            (!ConvertStringToUInt32(SplittedCommand.at(2), &CountOfPackets) || CountOfPackets == 0))
+        {
+            ShowMessages("err, couldn't resolve error at '%s'\n\n", SplittedCommand.at(2).c_str());
+            return;
+        }
+
+        //
+        // Measure the link of the debugger and the debuggee
+        //
+        CommandTestTransport(CountOfPackets);
+    }
+    else if (SplittedCommand.size() >= 3 && SplittedCommand.size() <= 5 && !SplittedCommand.at(1).compare("stress"))
+    {
+        UINT32 ThreadsPerCore = TEST_STRESS_DEFAULT_THREADS_PER_CORE;
+        UINT32 Duration       = TEST_STRESS_DEFAULT_DURATION;
+
+        if (SplittedCommand.at(2).compare("hook") && SplittedCommand.at(2).compare("churn") &&
+            SplittedCommand.at(2).compare("log") && SplittedCommand.at(2).compare("all"))
+        {
+            ShowMessages("err, couldn't resolve error at '%s'\n\n", SplittedCommand.at(2).c_str());
+            return;
+        }
+
+        if (SplittedCommand.size() >= 4 &&
+            (!ConvertStringToUInt32(SplittedCommand.at(3), &ThreadsPerCore) ||
+             ThreadsPerCore == 0 ||
+             ThreadsPerCore > TEST_STRESS_MAXIMUM_THREADS_PER_CORE))
+        {
+            ShowMessages("err, threads of each core should be between 1 and %x\n\n", TEST_STRESS_MAXIMUM_THREADS_PER_CORE);
+            return;
+        }
+
+        if (SplittedCommand.size() == 5 &&
+            (!ConvertStringToUInt32(SplittedCommand.at(4), &Duration) ||
+             Duration == 0 ||
+             Duration > TEST_STRESS_MAXIMUM_DURATION))
+        {
+            ShowMessages("err, duration should be between 1 and %x milliseconds\n\n", TEST_STRESS_MAXIMUM_DURATION);
+            return;
+        }
+
+        if (g_IsSerialConnectedToRemoteDebuggee)
+        {
+            ShowMessages("err, the stress test is only supported in VMI mode\n");
+            return;
+        }
+
+        CommandTestStress(SplittedCommand.at(2), ThreadsPerCore, Duration);
     }
     else if (SplittedCommand.size() == 2 && !SplittedCommand.at(1).compare("query"))
     {
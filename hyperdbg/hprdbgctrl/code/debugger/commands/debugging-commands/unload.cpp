@@ -46,7 +46,7 @@ CommandUnloadHelp()
  * @return VOID
  */
 VOID
-CommandUnload(vector<string> SplittedCommand, string Command)
+CommandUnload(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() != 2 && SplittedCommand.size() != 3)
     {
@@ -38,7 +38,7 @@ CommandWrmsrHelp()
  * @return VOID
  */
 VOID
-CommandWrmsr(vector<string> SplittedCommand, string Command)
+CommandWrmsr(vector<string> & SplittedCommand, string & Command)
 {
     BOOL                           Status;
     BOOL                           IsNextCoreId = FALSE;
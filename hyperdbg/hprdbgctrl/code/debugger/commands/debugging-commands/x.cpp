@@ -37,7 +37,7 @@ CommandXHelp()
  * @return VOID
  */
 VOID
-CommandX(vector<string> SplittedCommand, string Command)
+CommandX(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() == 1)
     {
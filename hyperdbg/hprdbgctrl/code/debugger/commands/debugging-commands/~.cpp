@@ -43,7 +43,7 @@ CommandCoreHelp()
  * @return VOID
  */
 VOID
-CommandCore(vector<string> SplittedCommand, string Command)
+CommandCore(vector<string> & SplittedCommand, string & Command)
 {
     UINT32 TargetCore = 0;
 
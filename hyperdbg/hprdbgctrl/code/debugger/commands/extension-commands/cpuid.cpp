@@ -22,7 +22,7 @@ CommandCpuidHelp()
     ShowMessages("!cpuid : monitors execution of a special cpuid index or all "
                  "cpuids instructions.\n\n");
 
-    ShowMessages("syntax : \t!cpuid [Eax (hex)] [pid ProcessId (hex)] [core CoreId (hex)] "
+    ShowMessages("syntax : \t!cpuid [Eax (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] [core CoreId (hex)] "
                  "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [condition { Condition (hex) }] "
                  "[code { Code (hex) }]\n");
@@ -42,7 +42,7 @@ CommandCpuidHelp()
  * @return VOID
  */
 VOID
-CommandCpuid(vector<string> SplittedCommand, string Command)
+CommandCpuid(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
@@ -21,7 +21,7 @@ CommandCrwriteHelp()
 {
     ShowMessages("!crwrite : monitors modification of control registers (CR0 / CR4).\n\n");
 
-    ShowMessages("syntax : \t!crwrite [Cr (hex)] [mask Mask (hex)] [pid ProcessId (hex)] "
+    ShowMessages("syntax : \t!crwrite [Cr (hex)] [mask Mask (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] "
                  "[core CoreId (hex)] [imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
 
@@ -40,7 +40,7 @@ CommandCrwriteHelp()
  * @return VOID
  */
 VOID
-CommandCrwrite(vector<string> SplittedCommand, string Command)
+CommandCrwrite(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
@@ -0,0 +1,326 @@
+/**
+ * @file dirty.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief !dirty command
+ * @details
+ * @version 0.4
+ * @date 2023-08-03
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+extern HANDLE  g_DeviceHandle;
+
+/**
+ * @brief help of !dirty command
+ *
+ * @return VOID
+ */
+VOID
+CommandDirtyHelp()
+{
+    ShowMessages("!dirty : shows and clears the physical pages that are written since the last clear "
+                 "(based on page-modification logging).\n\n");
+
+    ShowMessages("syntax : \t!dirty\n");
+    ShowMessages("syntax : \t!dirty [enable | disable]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : !dirty enable\n");
+    ShowMessages("\t\te.g : !dirty\n");
+    ShowMessages("\t\te.g : !dirty disable\n");
+
+    ShowMessages("\n");
+    ShowMessages("each query starts a new round of tracking, so the pages that are shown "
+                 "are the pages that are written since the previous query (or enabling it)\n");
+}
+
+/**
+ * @brief Send the request of the dirty pages to the driver
+ *
+ * @param DirtyPagesRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandDirtySendRequest(PDEBUGGER_DIRTY_PAGES_REQUEST DirtyPagesRequest)
+{
+    BOOL  Status;
+    ULONG ReturnedLength;
+
+    Status = DeviceIoControl(
+        g_DeviceHandle,                      // Handle to device
+        IOCTL_DIRTY_PAGES,                   // IO Control code
+        DirtyPagesRequest,                   // Input Buffer to driver.
+        SIZEOF_DEBUGGER_DIRTY_PAGES_REQUEST, // Input buffer length
+        DirtyPagesRequest,                   // Output Buffer from driver.
+        SIZEOF_DEBUGGER_DIRTY_PAGES_REQUEST, // Length of output buffer in
+                                             // bytes.
+        &ReturnedLength,                     // Bytes placed in buffer.
+        NULL                                 // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        return FALSE;
+    }
+
+    if (DirtyPagesRequest->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(DirtyPagesRequest->KernelStatus);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Enable or disable tracking the dirty pages
+ *
+ * @param Enable
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandDirtySetTracking(BOOLEAN Enable)
+{
+    DEBUGGER_DIRTY_PAGES_REQUEST * DirtyPagesRequest;
+    BOOLEAN                        Result;
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    DirtyPagesRequest = (PDEBUGGER_DIRTY_PAGES_REQUEST)malloc(SIZEOF_DEBUGGER_DIRTY_PAGES_REQUEST);
+
+    if (DirtyPagesRequest == NULL)
+    {
+        return FALSE;
+    }
+
+    RtlZeroMemory(DirtyPagesRequest, SIZEOF_DEBUGGER_DIRTY_PAGES_REQUEST);
+
+    DirtyPagesRequest->Action = Enable ? DEBUGGER_DIRTY_PAGES_ACTION_ENABLE : DEBUGGER_DIRTY_PAGES_ACTION_DISABLE;
+
+    Result = CommandDirtySendRequest(DirtyPagesRequest);
+
+    free(DirtyPagesRequest);
+
+    return Result;
+}
+
+/**
+ * @brief Get and clear the bitmap of the dirty pages
+ * @details each bit of the bitmap represents a 4KB page (the first bit is
+ * the page at physical address zero), the bitmap is not cleared if it's
+ * smaller than the tracked physical memory
+ *
+ * @param Bitmap The buffer to save the bitmap (or NULL to query the size)
+ * @param BitmapSize Size of the buffer in bytes
+ * @param EndAddress The end of the tracked physical memory (exclusive)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandDirtyGetAndClear(UINT64 * Bitmap, UINT64 BitmapSize, UINT64 * EndAddress)
+{
+    DEBUGGER_DIRTY_PAGES_REQUEST * DirtyPagesRequest;
+    UINT64                         CountOfWords;
+    UINT64                         CopiedWords = 0;
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    DirtyPagesRequest = (PDEBUGGER_DIRTY_PAGES_REQUEST)malloc(SIZEOF_DEBUGGER_DIRTY_PAGES_REQUEST);
+
+    if (DirtyPagesRequest == NULL)
+    {
+        return FALSE;
+    }
+
+    RtlZeroMemory(DirtyPagesRequest, SIZEOF_DEBUGGER_DIRTY_PAGES_REQUEST);
+
+    //
+    // Query the size of the bitmap without clearing it
+    //
+    DirtyPagesRequest->Action = DEBUGGER_DIRTY_PAGES_ACTION_QUERY;
+
+    if (!CommandDirtySendRequest(DirtyPagesRequest))
+    {
+        free(DirtyPagesRequest);
+        return FALSE;
+    }
+
+    *EndAddress  = DirtyPagesRequest->EndAddress;
+    CountOfWords = DirtyPagesRequest->EndAddress / PAGE_SIZE / 64;
+
+    if (Bitmap == NULL || BitmapSize < CountOfWords * sizeof(UINT64))
+    {
+        free(DirtyPagesRequest);
+        return FALSE;
+    }
+
+    //
+    // The first chunk starts a new round, the other chunks are read from
+    // the bitmap of the same (previous) round
+    //
+    DirtyPagesRequest->Action = DEBUGGER_DIRTY_PAGES_ACTION_QUERY_AND_CLEAR;
+
+    while (CopiedWords < CountOfWords)
+    {
+        DirtyPagesRequest->StartAddress = CopiedWords * 64 * PAGE_SIZE;
+
+        if (!CommandDirtySendRequest(DirtyPagesRequest))
+        {
+            free(DirtyPagesRequest);
+            return FALSE;
+        }
+
+        UINT64 Words = min(CountOfWords - CopiedWords, (UINT64)DirtyPagesBitmapWordsToQuery);
+
+        memcpy(&Bitmap[CopiedWords], DirtyPagesRequest->Bitmap, Words * sizeof(UINT64));
+
+        CopiedWords += Words;
+        DirtyPagesRequest->Action = DEBUGGER_DIRTY_PAGES_ACTION_QUERY;
+    }
+
+    free(DirtyPagesRequest);
+
+    return TRUE;
+}
+
+/**
+ * @brief Show the ranges of the dirty pages
+ *
+ * @param Bitmap
+ * @param EndAddress
+ *
+ * @return VOID
+ */
+VOID
+CommandDirtyShowRanges(UINT64 * Bitmap, UINT64 EndAddress)
+{
+    UINT64 CountOfPages = EndAddress / PAGE_SIZE;
+    UINT64 DirtyPages   = 0;
+    UINT64 RangeStart   = 0;
+    BOOL   InRange      = FALSE;
+
+    for (UINT64 i = 0; i <= CountOfPages; i++)
+    {
+        BOOL IsDirty = i < CountOfPages && (Bitmap[i / 64] & (1ull << (i % 64)));
+
+        if (IsDirty && !InRange)
+        {
+            RangeStart = i;
+            InRange    = TRUE;
+        }
+        else if (!IsDirty && InRange)
+        {
+            ShowMessages("%016llx - %016llx (%llx pages)\n", RangeStart * PAGE_SIZE, (i * PAGE_SIZE) - 1, i - RangeStart);
+
+            DirtyPages += i - RangeStart;
+            InRange = FALSE;
+        }
+    }
+
+    ShowMessages("\ncount of dirty pages : %llx\n", DirtyPages);
+}
+
+/**
+ * @brief !dirty command handler
+ *
+ * @param SplittedCommand
+ * @param Command
+ * @return VOID
+ */
+VOID
+CommandDirty(vector<string> & SplittedCommand, string & Command)
+{
+    UINT64 * Bitmap;
+    UINT64   EndAddress = 0;
+
+    if (SplittedCommand.size() > 2 ||
+        (SplittedCommand.size() == 2 && SplittedCommand.at(1).compare("enable") && SplittedCommand.at(1).compare("disable")))
+    {
+        ShowMessages("incorrect use of '!dirty'\n\n");
+        CommandDirtyHelp();
+        return;
+    }
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, tracking the dirty pages is not supported in the debugger mode\n");
+        return;
+    }
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+
+    if (SplittedCommand.size() == 2)
+    {
+        BOOLEAN Enable = !SplittedCommand.at(1).compare("enable");
+
+        if (CommandDirtySetTracking(Enable))
+        {
+            ShowMessages("tracking the dirty pages is %s\n", Enable ? "enabled" : "disabled");
+        }
+
+        return;
+    }
+
+    //
+    // Query the size of the bitmap
+    //
+    if (!CommandDirtyGetAndClear(NULL, 0, &EndAddress) && EndAddress == 0)
+    {
+        return;
+    }
+
+    Bitmap = (UINT64 *)malloc((EndAddress / PAGE_SIZE) / 8);
+
+    if (Bitmap == NULL)
+    {
+        ShowMessages("err, unable to allocate the bitmap of the dirty pages\n");
+        return;
+    }
+
+    if (CommandDirtyGetAndClear(Bitmap, (EndAddress / PAGE_SIZE) / 8, &EndAddress))
+    {
+        CommandDirtyShowRanges(Bitmap, EndAddress);
+    }
+
+    free(Bitmap);
+}
+
+/**
+ * @brief Enable or disable tracking the dirty pages
+ *
+ * @param Enable
+ *
+ * @return bool
+ */
+bool
+HyperDbgSetDirtyPagesTracking(bool Enable)
+{
+    return CommandDirtySetTracking(Enable);
+}
+
+/**
+ * @brief Get and clear the bitmap of the dirty pages
+ * @details if the buffer is NULL or smaller than the bitmap, the size
+ * is returned in EndAddress (the bitmap needs EndAddress / 4096 / 8 bytes)
+ *
+ * @param Bitmap The buffer to save the bitmap (each bit is a 4KB page)
+ * @param BitmapSize Size of the buffer in bytes
+ * @param EndAddress The end of the tracked physical memory (exclusive)
+ *
+ * @return bool
+ */
+bool
+HyperDbgGetAndClearDirtyPages(unsigned long long * Bitmap, unsigned long long BitmapSize, unsigned long long * EndAddress)
+{
+    return CommandDirtyGetAndClear(Bitmap, BitmapSize, EndAddress);
+}
@@ -21,7 +21,7 @@ CommandDrHelp()
 {
     ShowMessages("!dr : monitors any access to debug registers.\n\n");
 
-    ShowMessages("syntax : \t!dr [pid ProcessId (hex)] [core CoreId (hex)] "
+    ShowMessages("syntax : \t!dr [pid ProcessId (hex)] [tid ThreadId (hex)] [core CoreId (hex)] "
                  "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
 
@@ -39,7 +39,7 @@ CommandDrHelp()
  * @return VOID
  */
 VOID
-CommandDr(vector<string> SplittedCommand, string Command)
+CommandDr(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
@@ -22,10 +22,10 @@ CommandEptHookHelp()
     ShowMessages("!epthook : puts a hidden-hook EPT (hidden breakpoints).\n\n");
 
     ShowMessages(
-        "syntax : \t!epthook [Address (hex)] [pid ProcessId (hex)] [core CoreId (hex)] "
+        "syntax : \t!epthook [Address (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] [core CoreId (hex)] "
         "[imm IsImmediate (yesno)] [buffer PreAllocatedBuffer (hex)] "
         "[script { Script (string) }] [condition { Condition (hex) }] "
-        "[code { Code (hex) }] \n");
+        "[code { Code (hex) }] [record Values (string)]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : !epthook nt!ExAllocatePoolWithTag\n");
@@ -33,6 +33,13 @@ CommandEptHookHelp()
     ShowMessages("\t\te.g : !epthook fffff801deadb000\n");
     ShowMessages("\t\te.g : !epthook fffff801deadb000 pid 400\n");
     ShowMessages("\t\te.g : !epthook fffff801deadb000 core 2 pid 400\n");
+    ShowMessages("\t\te.g : !epthook nt!ExAllocatePoolWithTag record rcx,rdx,[rsp+28]\n");
+
+    ShowMessages("\n");
+    ShowMessages("the 'record' (VMI Mode) records the registers or the 64-bit memory at [register+offset] "
+                 "(up to %x values, separated by comma) on each hit in the buffer of the core, without breaking "
+                 "or running scripts, the records are taken by '!records'\n",
+                 EventRecordMaximumValues);
 }
 
 /**
@@ -43,7 +50,7 @@ CommandEptHookHelp()
  * @return VOID
  */
 VOID
-CommandEptHook(vector<string> SplittedCommand, string Command)
+CommandEptHook(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
@@ -11,6 +11,12 @@
  */
 #include "pch.h"
 
+//
+// Global Variables
+//
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+extern HANDLE  g_DeviceHandle;
+
 /**
  * @brief help of !epthook2 command
  *
@@ -22,9 +28,10 @@ CommandEptHook2Help()
     ShowMessages("!epthook2 : puts a hidden-hook EPT (detours).\n\n");
 
     ShowMessages(
-        "syntax : \t!epthook2 [Address (hex)] [pid ProcessId (hex)] "
+        "syntax : \t!epthook2 [Address (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] "
         "[core CoreId (hex)] [imm IsImmediate (yesno)] [buffer PreAllocatedBuffer (hex)] "
         "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
+    ShowMessages("syntax : \t!epthook2 [list]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : !epthook2 nt!ExAllocatePoolWithTag\n");
@@ -32,6 +39,81 @@ CommandEptHook2Help()
     ShowMessages("\t\te.g : !epthook2 fffff801deadb000\n");
     ShowMessages("\t\te.g : !epthook2 fffff801deadb000 pid 400\n");
     ShowMessages("\t\te.g : !epthook2 fffff801deadb000 core 2 pid 400\n");
+    ShowMessages("\t\te.g : !epthook2 list\n");
+}
+
+/**
+ * @brief show the hidden hooks detour and their hit counts
+ *
+ * @return VOID
+ */
+VOID
+CommandEptHook2ListHooks()
+{
+    BOOL                              Status;
+    ULONG                             ReturnedLength;
+    PDEBUGGER_QUERY_EPT_HOOK2_DETOURS DetoursRequest;
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, listing the hit counts is not supported in the debugger mode\n");
+        return;
+    }
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+
+    DetoursRequest = (PDEBUGGER_QUERY_EPT_HOOK2_DETOURS)malloc(SIZEOF_DEBUGGER_QUERY_EPT_HOOK2_DETOURS);
+
+    if (DetoursRequest == NULL)
+    {
+        return;
+    }
+
+    RtlZeroMemory(DetoursRequest, SIZEOF_DEBUGGER_QUERY_EPT_HOOK2_DETOURS);
+
+    Status = DeviceIoControl(
+        g_DeviceHandle,                          // Handle to device
+        IOCTL_QUERY_EPT_HOOK2_DETOURS,           // IO Control code
+        DetoursRequest,                          // Input Buffer to driver.
+        SIZEOF_DEBUGGER_QUERY_EPT_HOOK2_DETOURS, // Input buffer length
+        DetoursRequest,                          // Output Buffer from driver.
+        SIZEOF_DEBUGGER_QUERY_EPT_HOOK2_DETOURS, // Length of output buffer in
+                                                 // bytes.
+        &ReturnedLength,                         // Bytes placed in buffer.
+        NULL                                     // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        free(DetoursRequest);
+        return;
+    }
+
+    if (DetoursRequest->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(DetoursRequest->KernelStatus);
+        free(DetoursRequest);
+        return;
+    }
+
+    if (DetoursRequest->CountOfHooks == 0)
+    {
+        ShowMessages("no hidden hook detour is applied\n");
+        free(DetoursRequest);
+        return;
+    }
+
+    ShowMessages("hooked function       hit count\n");
+
+    for (UINT32 i = 0; i < DetoursRequest->CountOfHooks; i++)
+    {
+        ShowMessages("%s    %llx\n",
+                     SeparateTo64BitValue(DetoursRequest->Hooks[i].HookedFunctionAddress).c_str(),
+                     DetoursRequest->Hooks[i].HitCount);
+    }
+
+    free(DetoursRequest);
 }
 
 /**
@@ -42,7 +124,7 @@ CommandEptHook2Help()
  * @return VOID
  */
 VOID
-CommandEptHook2(vector<string> SplittedCommand, string Command)
+CommandEptHook2(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
@@ -65,6 +147,15 @@ CommandEptHook2(vector<string> SplittedCommand, string Command)
         return;
     }
 
+    //
+    // Show the hit counts of the hooks
+    //
+    if (SplittedCommand.size() == 2 && !SplittedCommand.at(1).compare("list"))
+    {
+        CommandEptHook2ListHooks();
+        return;
+    }
+
     //
     // Interpret and fill the general event and action fields
     //
@@ -0,0 +1,141 @@
+/**
+ * @file eptsnapshot.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief !snapshot command
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+
+/**
+ * @brief help of !snapshot command
+ *
+ * @return VOID
+ */
+VOID
+CommandEptSnapshotHelp()
+{
+    ShowMessages("!snapshot : takes a snapshot of the memory and the registers of the halted debuggee, "
+                 "and restores it (copy-on-write of the written pages based on EPT).\n\n");
+
+    ShowMessages("syntax : \t!snapshot\n");
+    ShowMessages("syntax : \t!snapshot [take | restore | discard]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : !snapshot take\n");
+    ShowMessages("\t\te.g : !snapshot restore\n");
+    ShowMessages("\t\te.g : !snapshot\n");
+    ShowMessages("\t\te.g : !snapshot discard\n");
+
+    ShowMessages("\n");
+    ShowMessages("the pages are copied before their first write, so 'restore' only writes back "
+                 "the pages that are written since taking (or restoring) the snapshot, the registers "
+                 "are restored on the core that the snapshot is taken on, the copies are pre-allocated "
+                 "by 'prealloc snapshot [Count]'\n");
+}
+
+/**
+ * @brief !snapshot command handler
+ *
+ * @param SplittedCommand
+ * @param Command
+ * @return VOID
+ */
+VOID
+CommandEptSnapshot(vector<string> & SplittedCommand, string & Command)
+{
+    DEBUGGER_EPT_SNAPSHOT_REQUEST SnapshotRequest = {0};
+
+    if (SplittedCommand.size() > 2)
+    {
+        ShowMessages("incorrect use of '!snapshot'\n\n");
+        CommandEptSnapshotHelp();
+        return;
+    }
+
+    if (SplittedCommand.size() == 1)
+    {
+        SnapshotRequest.Action = DEBUGGER_EPT_SNAPSHOT_ACTION_QUERY;
+    }
+    else if (!SplittedCommand.at(1).compare("take"))
+    {
+        SnapshotRequest.Action = DEBUGGER_EPT_SNAPSHOT_ACTION_TAKE;
+    }
+    else if (!SplittedCommand.at(1).compare("restore"))
+    {
+        SnapshotRequest.Action = DEBUGGER_EPT_SNAPSHOT_ACTION_RESTORE;
+    }
+    else if (!SplittedCommand.at(1).compare("discard"))
+    {
+        SnapshotRequest.Action = DEBUGGER_EPT_SNAPSHOT_ACTION_DISCARD;
+    }
+    else
+    {
+        ShowMessages("incorrect use of '!snapshot'\n\n");
+        CommandEptSnapshotHelp();
+        return;
+    }
+
+    //
+    // The snapshot is taken and restored while all of the cores are halted
+    //
+    if (!g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, the snapshots are only supported in the Debugger Mode\n");
+        return;
+    }
+
+    if (!KdSendEptSnapshotPacketToDebuggee(&SnapshotRequest))
+    {
+        return;
+    }
+
+    if (SnapshotRequest.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(SnapshotRequest.KernelStatus);
+        return;
+    }
+
+    switch (SnapshotRequest.Action)
+    {
+    case DEBUGGER_EPT_SNAPSHOT_ACTION_TAKE:
+
+        ShowMessages("the snapshot is taken on core %x\n", SnapshotRequest.CoreId);
+        break;
+
+    case DEBUGGER_EPT_SNAPSHOT_ACTION_RESTORE:
+
+        ShowMessages("the snapshot is restored (%llx page(s) are written back)\n", SnapshotRequest.CountOfRestoredPages);
+        break;
+
+    case DEBUGGER_EPT_SNAPSHOT_ACTION_DISCARD:
+
+        ShowMessages("the snapshot is discarded\n");
+        break;
+
+    default:
+
+        if (!SnapshotRequest.IsTaken)
+        {
+            ShowMessages("no snapshot is taken\n");
+            break;
+        }
+
+        ShowMessages("the snapshot is taken on core %x\n"
+                     "written pages since the last restore : %llx\n"
+                     "count of restores : %llx\n",
+                     SnapshotRequest.CoreId,
+                     SnapshotRequest.CountOfCopiedPages,
+                     SnapshotRequest.CountOfRestores);
+        break;
+    }
+}
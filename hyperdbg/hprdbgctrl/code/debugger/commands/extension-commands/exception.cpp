@@ -23,7 +23,7 @@ CommandExceptionHelp()
                  "zero).\n\n");
 
     ShowMessages(
-        "syntax : \t!exception [IdtIndex (hex)] [pid ProcessId (hex)] "
+        "syntax : \t!exception [IdtIndex (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] "
         "[core CoreId (hex)] [imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
         "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
 
@@ -44,7 +44,7 @@ CommandExceptionHelp()
  * @return VOID
  */
 VOID
-CommandException(vector<string> SplittedCommand, string Command)
+CommandException(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
@@ -0,0 +1,229 @@
+/**
+ * @file exectrace.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief !exectrace command
+ * @details
+ * @version 0.2
+ * @date 2026-10-14
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief help of !exectrace command
+ *
+ * @return VOID
+ */
+VOID
+CommandExectraceHelp()
+{
+    ShowMessages("!exectrace : traces the first execution of each page of an address range "
+                 "using mode-based execution control (MBEC).\n\n");
+
+    ShowMessages("syntax : \t!exectrace [Mode (u|k)] [FromAddress (hex)] "
+                 "[ToAddress (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] [core CoreId (hex)] "
+                 "[imm IsImmediate (yesno)] [buffer PreAllocatedBuffer (hex)] "
+                 "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : !exectrace u 00007ff8349f0000 00007ff834a8ffff pid 1c0\n");
+    ShowMessages("\t\te.g : !exectrace k fffff801deadb000 fffff801deadffff\n");
+    ShowMessages("\t\te.g : !exectrace k nt!NtCreateFile nt!NtCreateFile+fff script { printf(\"page %%llx executed\\n\", $context); }\n");
+}
+
+/**
+ * @brief !exectrace command handler
+ *
+ * @param SplittedCommand
+ * @param Command
+ * @return VOID
+ */
+VOID
+CommandExectrace(vector<string> & SplittedCommand, string & Command)
+{
+    PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
+    PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
+    PDEBUGGER_GENERAL_ACTION           ActionCustomCode      = NULL;
+    PDEBUGGER_GENERAL_ACTION           ActionScript          = NULL;
+    UINT32                             EventLength;
+    UINT32                             ActionBreakToDebuggerLength = 0;
+    UINT32                             ActionCustomCodeLength      = 0;
+    UINT32                             ActionScriptLength          = 0;
+    UINT64                             OptionalParam1              = 0; // Set the 'from' target address
+    UINT64                             OptionalParam2              = 0; // Set the 'to' target address
+    UINT64                             TraceMode                   = DEBUGGER_EVENT_EXEC_TRACE_USER_MODE;
+    BOOLEAN                            SetFrom                     = FALSE;
+    BOOLEAN                            SetTo                       = FALSE;
+    BOOLEAN                            SetMode                     = FALSE;
+    vector<string>                     SplittedCommandCaseSensitive {Split(Command, ' ')};
+    UINT32                             IndexInCommandCaseSensitive = 0;
+    DEBUGGER_EVENT_PARSING_ERROR_CAUSE EventParsingErrorCause;
+
+    if (SplittedCommand.size() < 4)
+    {
+        ShowMessages("incorrect use of '!exectrace'\n");
+        CommandExectraceHelp();
+        return;
+    }
+
+    //
+    // Interpret and fill the general event and action fields
+    //
+    if (!InterpretGeneralEventAndActionsFields(
+            &SplittedCommand,
+            &SplittedCommandCaseSensitive,
+            PAGE_FIRST_EXECUTION,
+            &Event,
+            &EventLength,
+            &ActionBreakToDebugger,
+            &ActionBreakToDebuggerLength,
+            &ActionCustomCode,
+            &ActionCustomCodeLength,
+            &ActionScript,
+            &ActionScriptLength,
+            &EventParsingErrorCause))
+    {
+        return;
+    }
+
+    //
+    // Interpret command specific details (if any)
+    //
+    for (auto Section : SplittedCommand)
+    {
+        IndexInCommandCaseSensitive++;
+
+        if (!Section.compare("!exectrace"))
+        {
+            continue;
+        }
+        else if (!Section.compare("u") && !SetMode)
+        {
+            TraceMode = DEBUGGER_EVENT_EXEC_TRACE_USER_MODE;
+            SetMode   = TRUE;
+        }
+        else if (!Section.compare("k") && !SetMode)
+        {
+            TraceMode = DEBUGGER_EVENT_EXEC_TRACE_KERNEL_MODE;
+            SetMode   = TRUE;
+        }
+        else if (!SetFrom)
+        {
+            //
+            // It's probably address
+            //
+            if (!SymbolConvertNameOrExprToAddress(
+                    SplittedCommandCaseSensitive.at(IndexInCommandCaseSensitive - 1),
+                    &OptionalParam1))
+            {
+                //
+                // couldn't resolve or unkonwn parameter
+                //
+                ShowMessages("err, couldn't resolve error at '%s'\n\n",
+                             SplittedCommandCaseSensitive.at(IndexInCommandCaseSensitive - 1).c_str());
+                CommandExectraceHelp();
+
+                FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+                return;
+            }
+            SetFrom = TRUE;
+        }
+        else if (!SetTo)
+        {
+            if (!SymbolConvertNameOrExprToAddress(
+                    SplittedCommandCaseSensitive.at(IndexInCommandCaseSensitive - 1),
+                    &OptionalParam2))
+            {
+                //
+                // Couldn't resolve or unkonwn parameter
+                //
+                ShowMessages("err, couldn't resolve error at '%s'\n\n",
+                             SplittedCommandCaseSensitive.at(IndexInCommandCaseSensitive - 1).c_str());
+                CommandExectraceHelp();
+
+                FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+                return;
+            }
+            SetTo = TRUE;
+        }
+        else
+        {
+            //
+            // Unkonwn parameter
+            //
+            ShowMessages("unknown parameter '%s'\n\n", Section.c_str());
+            CommandExectraceHelp();
+
+            FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+            return;
+        }
+    }
+
+    //
+    // Check if user set the mode and the range of !exectrace or not
+    //
+    if (!SetMode || !SetTo)
+    {
+        ShowMessages("please specify the mode (u or k) and the range that you want to trace\n");
+
+        FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+        return;
+    }
+
+    //
+    // Check for invalid order of address
+    //
+    if (OptionalParam1 > OptionalParam2)
+    {
+        //
+        // 'from' is greater than 'to'
+        //
+        ShowMessages("please choose the 'from' value first, then choose the 'to' "
+                     "value\n");
+
+        FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+        return;
+    }
+
+    //
+    // Set the optional parameters, the 'to' address is inclusive here
+    // but the kernel expects the end of the range
+    //
+    Event->OptionalParam1 = OptionalParam1;
+    Event->OptionalParam2 = OptionalParam2 + 1;
+    Event->OptionalParam3 = TraceMode;
+
+    //
+    // Send the ioctl to the kernel for event registration
+    //
+    if (!SendEventToKernel(Event, EventLength))
+    {
+        //
+        // There was an error, probably the handle was not initialized
+        // we have to free the Action before exit, it is because, we
+        // already freed the Event and string buffers
+        //
+        FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+        return;
+    }
+
+    //
+    // Add the event to the kernel
+    //
+    if (!RegisterActionToEvent(Event,
+                               ActionBreakToDebugger,
+                               ActionBreakToDebuggerLength,
+                               ActionCustomCode,
+                               ActionCustomCodeLength,
+                               ActionScript,
+                               ActionScriptLength))
+    {
+        //
+        // There was an error
+        //
+        FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+        return;
+    }
+}
@@ -36,17 +36,21 @@ CommandHideHelp()
     ShowMessages("!hide : tries to make HyperDbg transparent from anti-debugging "
                  "and anti-hypervisor methods.\n\n");
 
-    ShowMessages("syntax : \t!hide\n");
-    ShowMessages("syntax : \t!hide [pid ProcessId (hex)]\n");
-    ShowMessages("syntax : \t!hide [name ProcessName (string)]\n");
+    ShowMessages("syntax : \t!hide [tsc]\n");
+    ShowMessages("syntax : \t!hide [tsc] [pid ProcessId (hex)]\n");
+    ShowMessages("syntax : \t!hide [tsc] [name ProcessName (string)]\n");
 
     ShowMessages("note : \tprocess names are case sensitive and you can use "
                  "this command multiple times.\n");
+    ShowMessages("note : \t'tsc' hides the time that is spent in the hypervisor by "
+                 "the TSC offset (on all processes) instead of intercepting rdtsc/rdtscp, "
+                 "it doesn't need '!measure' and is only applied on the first use of this command.\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : !hide\n");
     ShowMessages("\t\te.g : !hide pid b60 \n");
     ShowMessages("\t\te.g : !hide name procexp.exe\n");
+    ShowMessages("\t\te.g : !hide tsc name procexp.exe\n");
 }
 
 /**
@@ -57,7 +61,7 @@ CommandHideHelp()
  * @return VOID
  */
 VOID
-CommandHide(vector<string> SplittedCommand, string Command)
+CommandHide(vector<string> & SplittedCommand, string & Command)
 {
     BOOLEAN                                      Status;
     ULONG                                        ReturnedLength;
@@ -66,6 +70,26 @@ CommandHide(vector<string> SplittedCommand, string Command)
     DEBUGGER_HIDE_AND_TRANSPARENT_DEBUGGER_MODE  HideRequest        = {0};
     PDEBUGGER_HIDE_AND_TRANSPARENT_DEBUGGER_MODE FinalRequestBuffer = 0;
     size_t                                       RequestBufferSize  = 0;
+    BOOLEAN                                      UseTscOffsetting   = FALSE;
+
+    //
+    // Check whether the time of the hypervisor should be hidden by the TSC offset
+    //
+    if (SplittedCommand.size() >= 2 && !SplittedCommand.at(1).compare("tsc"))
+    {
+        UseTscOffsetting = TRUE;
+
+        SplittedCommand.erase(SplittedCommand.begin() + 1);
+
+        //
+        // Remove tsc from the command (the process name is read from the command)
+        //
+        Trim(Command);
+        Command.erase(0, 5);
+        Trim(Command);
+        Command.erase(0, 3);
+        Command = "!hide" + Command;
+    }
 
     if (SplittedCommand.size() <= 2 && SplittedCommand.size() != 1)
     {
@@ -154,8 +178,8 @@ CommandHide(vector<string> SplittedCommand, string Command)
     //
     // Check if the user used !measure or not
     //
-    if (!g_TransparentResultsMeasured || !g_CpuidAverage ||
-        !g_CpuidStandardDeviation || !g_CpuidMedian)
+    if (!UseTscOffsetting && (!g_TransparentResultsMeasured || !g_CpuidAverage ||
+                              !g_CpuidStandardDeviation || !g_CpuidMedian))
     {
         ShowMessages("the average, median and standard deviation is not measured. "
                      "Did you use '!measure' command?\n");
@@ -170,7 +194,8 @@ CommandHide(vector<string> SplittedCommand, string Command)
     //
     // We wanna hide the debugger and make transparent vm-exits
     //
-    HideRequest.IsHide = TRUE;
+    HideRequest.IsHide           = TRUE;
+    HideRequest.UseTscOffsetting = UseTscOffsetting;
 
     //
     // Set the measured times cpuid
@@ -1,7 +1,7 @@
 /**
  * @file interrupt.cpp
  * @author Sina Karvandi (sina@hyperdbg.org)
- * @brief !interrupt command
+ * @brief !interrupt and !interrupt2 commands
  * @details
  * @version 0.1
  * @date 2020-06-11
@@ -19,9 +19,10 @@
 VOID
 CommandInterruptHelp()
 {
-    ShowMessages("!interrupt : monitors the external interrupt (IDT >= 32).\n\n");
+    ShowMessages("!interrupt : monitors the external interrupt (IDT >= 32).\n");
+    ShowMessages("!interrupt2 : monitors the external interrupt at its entry in the IDT (IDT >= 32).\n\n");
 
-    ShowMessages("syntax : \t[IdtIndex (hex)] [pid ProcessId (hex)] "
+    ShowMessages("syntax : \t[IdtIndex (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] "
                  "[core CoreId (hex)] [imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
 
@@ -32,17 +33,23 @@ CommandInterruptHelp()
     ShowMessages("\t\te.g : !interrupt 0x2f\n");
     ShowMessages("\t\te.g : !interrupt 0x2f pid 400\n");
     ShowMessages("\t\te.g : !interrupt 0x2f core 2 pid 400\n");
+    ShowMessages("\t\te.g : !interrupt2 0xd1\n");
+
+    ShowMessages("\nthe '!interrupt' intercepts all the external interrupts of the cores (vm-exits), "
+                 "the '!interrupt2' hooks the handler of the vector in the IDT, so the other "
+                 "vectors are delivered without vm-exits, its events are triggered at the entry of "
+                 "the handler (the interrupted context is on the stack) and short-circuiting is not supported\n");
 }
 
 /**
- * @brief !interrupt command handler
+ * @brief !interrupt and !interrupt2 commands handler
  *
  * @param SplittedCommand
  * @param Command
  * @return VOID
  */
 VOID
-CommandInterrupt(vector<string> SplittedCommand, string Command)
+CommandInterrupt(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
@@ -84,7 +91,7 @@ CommandInterrupt(vector<string> SplittedCommand, string Command)
     //
     for (auto Section : SplittedCommand)
     {
-        if (!Section.compare("!interrupt"))
+        if (!Section.compare("!interrupt") || !Section.compare("!interrupt2"))
         {
             continue;
         }
@@ -159,6 +166,18 @@ CommandInterrupt(vector<string> SplittedCommand, string Command)
     //
     Event->OptionalParam1 = SpecialTarget;
 
+    //
+    // Set whether it's !interrupt or !interrupt2
+    //
+    if (!SplittedCommand.at(0).compare("!interrupt2"))
+    {
+        Event->OptionalParam2 = DEBUGGER_EVENT_INTERRUPT_IDT_ENTRY_HOOK;
+    }
+    else
+    {
+        Event->OptionalParam2 = DEBUGGER_EVENT_INTERRUPT_EXTERNAL_INTERRUPT_EXITING;
+    }
+
     //
     // Send the ioctl to the kernel for event registration
     //
@@ -22,7 +22,7 @@ CommandIoinHelp()
     ShowMessages("!ioin : detects the execution of IN (I/O instructions) "
                  "instructions.\n\n");
 
-    ShowMessages("syntax : \t!ioin [Port (hex)] [pid ProcessId (hex)] [core CoreId (hex)] "
+    ShowMessages("syntax : \t!ioin [Port (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] [core CoreId (hex)] "
                  "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] [script { Script (string) }] "
                  "[condition { Condition (hex) }] [code { Code (hex) }]\n");
 
@@ -41,7 +41,7 @@ CommandIoinHelp()
  * @return VOID
  */
 VOID
-CommandIoin(vector<string> SplittedCommand, string Command)
+CommandIoin(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
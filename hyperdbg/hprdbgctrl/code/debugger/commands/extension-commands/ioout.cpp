@@ -22,7 +22,7 @@ CommandIooutHelp()
     ShowMessages("!ioout : detects the execution of OUT (I/O instructions) "
                  "instructions.\n\n");
 
-    ShowMessages("syntax : \t!ioout [Port (hex)] [pid ProcessId (hex)] "
+    ShowMessages("syntax : \t!ioout [Port (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] "
                  "[core CoreId (hex)] [imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
 
@@ -41,7 +41,7 @@ CommandIooutHelp()
  * @return VOID
  */
 VOID
-CommandIoout(vector<string> SplittedCommand, string Command)
+CommandIoout(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
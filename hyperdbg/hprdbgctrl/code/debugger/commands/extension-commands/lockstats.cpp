@@ -0,0 +1,182 @@
+/**
+ * @file lockstats.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief !lockstats command
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+extern HANDLE  g_DeviceHandle;
+
+/**
+ * @brief help of !lockstats command
+ *
+ * @return VOID
+ */
+VOID
+CommandLockStatsHelp()
+{
+    ShowMessages("!lockstats : shows the most contended spinlocks of the debugger and the hypervisor.\n\n");
+
+    ShowMessages("syntax : \t!lockstats [count Count (hex)] [reset]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : !lockstats\n");
+    ShowMessages("\t\te.g : !lockstats count 5\n");
+    ShowMessages("\t\te.g : !lockstats reset\n");
+
+    ShowMessages("\n");
+    ShowMessages("the spinlocks are counted at each site that acquires them, and the sites "
+                 "are only counted if the drivers are compiled with "
+                 "'UseSpinlockContentionInstrumentation', 'reset' resets the counters "
+                 "after showing them\n");
+}
+
+/**
+ * @brief Show the contention of the spinlocks (the most contended first)
+ *
+ * @param ContentionRequest
+ * @param Count Maximum count of the sites to show
+ *
+ * @return VOID
+ */
+VOID
+CommandLockStatsShowSites(PDEBUGGER_SPINLOCK_CONTENTION_REQUEST ContentionRequest, UINT32 Count)
+{
+    vector<PSPINLOCK_CONTENTION_STATISTICS> Sites;
+
+    for (UINT32 i = 0; i < ContentionRequest->CountOfSites && i < MaximumSpinlockContentionSitesToQuery; i++)
+    {
+        Sites.push_back(&ContentionRequest->Sites[i]);
+    }
+
+    if (Sites.empty())
+    {
+        ShowMessages("no spinlock acquisition is recorded\n");
+        return;
+    }
+
+    sort(Sites.begin(), Sites.end(), [](PSPINLOCK_CONTENTION_STATISTICS A, PSPINLOCK_CONTENTION_STATISTICS B) {
+        return A->SpinCycles > B->SpinCycles;
+    });
+
+    ShowMessages("site                                     acquisitions      contended         spin cycles       maximum wait\n");
+
+    for (UINT32 i = 0; i < Sites.size() && i < Count; i++)
+    {
+        ShowMessages("%-40s %-17llx %-17llx %-17llx %llx\n",
+                     Sites[i]->Name,
+                     Sites[i]->Acquisitions,
+                     Sites[i]->ContendedAcquisitions,
+                     Sites[i]->SpinCycles,
+                     Sites[i]->MaximumWaitCycles);
+    }
+}
+
+/**
+ * @brief !lockstats command handler
+ *
+ * @param SplittedCommand
+ * @param Command
+ * @return VOID
+ */
+VOID
+CommandLockStats(vector<string> & SplittedCommand, string & Command)
+{
+    BOOL                                  Status;
+    ULONG                                 ReturnedLength;
+    PDEBUGGER_SPINLOCK_CONTENTION_REQUEST ContentionRequest;
+    UINT32                                Count = 10;
+    BOOLEAN                               Reset = FALSE;
+
+    for (size_t i = 1; i < SplittedCommand.size(); i++)
+    {
+        if (!SplittedCommand.at(i).compare("reset"))
+        {
+            Reset = TRUE;
+            continue;
+        }
+
+        if (!SplittedCommand.at(i).compare("count") && i + 1 < SplittedCommand.size() &&
+            ConvertStringToUInt32(SplittedCommand.at(i + 1), &Count) && Count != 0)
+        {
+            i++;
+            continue;
+        }
+
+        ShowMessages("err, couldn't resolve error at '%s'\n\n", SplittedCommand.at(i).c_str());
+        CommandLockStatsHelp();
+        return;
+    }
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, the contention of spinlocks is not supported in the debugger mode\n");
+        return;
+    }
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+
+    ContentionRequest = (PDEBUGGER_SPINLOCK_CONTENTION_REQUEST)malloc(SIZEOF_DEBUGGER_SPINLOCK_CONTENTION_REQUEST);
+
+    if (ContentionRequest == NULL)
+    {
+        return;
+    }
+
+    RtlZeroMemory(ContentionRequest, SIZEOF_DEBUGGER_SPINLOCK_CONTENTION_REQUEST);
+
+    ContentionRequest->Reset = Reset;
+
+    Status = DeviceIoControl(
+        g_DeviceHandle,                              // Handle to device
+        IOCTL_QUERY_SPINLOCK_CONTENTION,             // IO Control code
+        ContentionRequest,                           // Input Buffer to driver.
+        SIZEOF_DEBUGGER_SPINLOCK_CONTENTION_REQUEST, // Input buffer length
+        ContentionRequest,                           // Output Buffer from driver.
+        SIZEOF_DEBUGGER_SPINLOCK_CONTENTION_REQUEST, // Length of output buffer in
+                                                     // bytes.
+        &ReturnedLength,                             // Bytes placed in buffer.
+        NULL                                         // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        free(ContentionRequest);
+        return;
+    }
+
+    if (ContentionRequest->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(ContentionRequest->KernelStatus);
+        free(ContentionRequest);
+        return;
+    }
+
+    if (!ContentionRequest->IsInstrumentationEnabled)
+    {
+        ShowMessages("the contention of spinlocks is not counted, the drivers should be compiled "
+                     "with 'UseSpinlockContentionInstrumentation' set to TRUE\n");
+    }
+    else
+    {
+        CommandLockStatsShowSites(ContentionRequest, Count);
+
+        if (Reset)
+        {
+            ShowMessages("\nthe contention of spinlocks is reset\n");
+        }
+    }
+
+    free(ContentionRequest);
+}
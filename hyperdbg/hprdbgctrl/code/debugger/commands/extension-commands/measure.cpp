@@ -23,6 +23,8 @@ extern UINT64 g_RdtscStandardDeviation;
 extern UINT64 g_RdtscMedian;
 
 extern BOOLEAN g_TransparentResultsMeasured;
+extern BOOLEAN g_BreakPrintingOutput;
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
 
 /**
  * @brief help of !measure command
@@ -36,10 +38,245 @@ CommandMeasureHelp()
         "!measure : measures the arguments needs for the '!hide' command.\n\n");
 
     ShowMessages("syntax : \t!measure [default]\n");
+    ShowMessages("syntax : \t!measure [monitor] [interval Milliseconds (hex)] [threshold Percentage (hex)]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : !measure\n");
     ShowMessages("\t\te.g : !measure default\n");
+    ShowMessages("\t\te.g : !measure monitor\n");
+    ShowMessages("\t\te.g : !measure monitor interval 1f4 threshold a\n");
+
+    ShowMessages("\n");
+    ShowMessages("the 'monitor' continuously samples the vm-exits of each core (until CTRL+C is pressed) "
+                 "and estimates the percentage of the time of each core that is spent in vmx-root "
+                 "(the cost of the transitions to and from vmx-root is not included), the cores "
+                 "above the threshold are alerted\n");
+}
+
+/**
+ * @brief Query the sums of the counts and the cycles of each exit reason
+ * of all of the cores
+ *
+ * @param StatisticsRequest Buffer of the request
+ * @param CoresCount
+ * @param Counts Counts of each exit reason of each core
+ * @param Cycles Cycles of each exit reason of each core
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandMeasureMonitorSample(PDEBUGGER_VMEXIT_STATISTICS_REQUEST StatisticsRequest,
+                            UINT32                              CoresCount,
+                            vector<UINT64> &                    Counts,
+                            vector<UINT64> &                    Cycles)
+{
+    for (UINT32 CoreId = 0; CoreId < CoresCount; CoreId++)
+    {
+        RtlZeroMemory(StatisticsRequest, SIZEOF_DEBUGGER_VMEXIT_STATISTICS_REQUEST);
+
+        StatisticsRequest->Action = DEBUGGER_VMEXIT_STATISTICS_ACTION_QUERY;
+        StatisticsRequest->CoreId = CoreId;
+
+        if (!CommandVmexitStatsSendRequest(StatisticsRequest))
+        {
+            return FALSE;
+        }
+
+        for (UINT32 Reason = 0; Reason < MaximumVmexitStatisticsExitReasons; Reason++)
+        {
+            Counts[CoreId * MaximumVmexitStatisticsExitReasons + Reason] = StatisticsRequest->Reasons[Reason].Count;
+            Cycles[CoreId * MaximumVmexitStatisticsExitReasons + Reason] = StatisticsRequest->Reasons[Reason].TotalCycles;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Continuously show the overhead of the hypervisor on each core
+ * @details the differences of the statistics of vm-exits are shown in each
+ * interval till CTRL+C is pressed, the statistics are enabled during the
+ * monitoring (if they are not already enabled)
+ *
+ * @param Interval Interval of sampling (in milliseconds)
+ * @param Threshold Percentage of the time of a core in vmx-root that is alerted
+ *
+ * @return VOID
+ */
+VOID
+CommandMeasureMonitor(UINT32 Interval, UINT32 Threshold)
+{
+    PDEBUGGER_VMEXIT_STATISTICS_REQUEST StatisticsRequest;
+    SYSTEM_INFO                         SysInfo;
+    UINT32                              CoresCount;
+    BOOLEAN                             WasEnabled;
+    UINT64                              PreviousTsc;
+    UINT64                              CurrentTsc;
+    UINT64                              ElapsedTsc;
+    UINT64                              TotalCycles;
+    vector<UINT64>                      PreviousCounts;
+    vector<UINT64>                      PreviousCycles;
+    vector<UINT64>                      Counts;
+    vector<UINT64>                      Cycles;
+    vector<UINT64>                      ReasonCycles(MaximumVmexitStatisticsExitReasons);
+    vector<UINT32>                      Reasons;
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, the overhead monitor is not supported in the debugger mode\n");
+        return;
+    }
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+
+    GetSystemInfo(&SysInfo);
+    CoresCount = SysInfo.dwNumberOfProcessors;
+
+    StatisticsRequest = (PDEBUGGER_VMEXIT_STATISTICS_REQUEST)malloc(SIZEOF_DEBUGGER_VMEXIT_STATISTICS_REQUEST);
+
+    if (StatisticsRequest == NULL)
+    {
+        return;
+    }
+
+    //
+    // Enable the statistics of vm-exits (if they're not already enabled)
+    //
+    RtlZeroMemory(StatisticsRequest, SIZEOF_DEBUGGER_VMEXIT_STATISTICS_REQUEST);
+
+    StatisticsRequest->Action = DEBUGGER_VMEXIT_STATISTICS_ACTION_QUERY;
+    StatisticsRequest->CoreId = DEBUGGER_VMEXIT_STATISTICS_ALL_CORES;
+
+    if (!CommandVmexitStatsSendRequest(StatisticsRequest))
+    {
+        free(StatisticsRequest);
+        return;
+    }
+
+    WasEnabled = StatisticsRequest->IsEnabled;
+
+    if (!WasEnabled)
+    {
+        StatisticsRequest->Action = DEBUGGER_VMEXIT_STATISTICS_ACTION_ENABLE;
+
+        if (!CommandVmexitStatsSendRequest(StatisticsRequest))
+        {
+            free(StatisticsRequest);
+            return;
+        }
+    }
+
+    PreviousCounts.resize(CoresCount * MaximumVmexitStatisticsExitReasons);
+    PreviousCycles.resize(CoresCount * MaximumVmexitStatisticsExitReasons);
+    Counts.resize(CoresCount * MaximumVmexitStatisticsExitReasons);
+    Cycles.resize(CoresCount * MaximumVmexitStatisticsExitReasons);
+
+    ShowMessages("monitoring the overhead of the hypervisor (interval: %x ms, threshold: %d%%), "
+                 "press CTRL+C to stop\n\n",
+                 Interval,
+                 Threshold);
+
+    g_BreakPrintingOutput = FALSE;
+
+    PreviousTsc = __rdtsc();
+
+    if (!CommandMeasureMonitorSample(StatisticsRequest, CoresCount, PreviousCounts, PreviousCycles))
+    {
+        g_BreakPrintingOutput = TRUE;
+    }
+
+    while (!g_BreakPrintingOutput)
+    {
+        Sleep(Interval);
+
+        CurrentTsc = __rdtsc();
+
+        if (g_BreakPrintingOutput || !CommandMeasureMonitorSample(StatisticsRequest, CoresCount, Counts, Cycles))
+        {
+            break;
+        }
+
+        ElapsedTsc  = CurrentTsc - PreviousTsc;
+        TotalCycles = 0;
+
+        std::fill(ReasonCycles.begin(), ReasonCycles.end(), 0);
+
+        ShowMessages("core   exits/s           average cycles    vmx-root\n");
+
+        for (UINT32 CoreId = 0; CoreId < CoresCount; CoreId++)
+        {
+            UINT64 CoreExits  = 0;
+            UINT64 CoreCycles = 0;
+            double Percentage;
+
+            for (UINT32 Reason = 0; Reason < MaximumVmexitStatisticsExitReasons; Reason++)
+            {
+                UINT32 Index       = CoreId * MaximumVmexitStatisticsExitReasons + Reason;
+                UINT64 DeltaCycles = Cycles[Index] - PreviousCycles[Index];
+
+                CoreExits += Counts[Index] - PreviousCounts[Index];
+                CoreCycles += DeltaCycles;
+                ReasonCycles[Reason] += DeltaCycles;
+            }
+
+            TotalCycles += CoreCycles;
+            Percentage = ElapsedTsc != 0 ? (double)CoreCycles * 100 / ElapsedTsc : 0;
+
+            ShowMessages("%-6x %-17llx %-17llx %.2f%%%s\n",
+                         CoreId,
+                         CoreExits * 1000 / Interval,
+                         CoreExits != 0 ? CoreCycles / CoreExits : 0,
+                         Percentage,
+                         Percentage >= Threshold ? "  <-- above the threshold" : "");
+        }
+
+        //
+        // Show the most expensive exit reasons of this interval
+        //
+        Reasons.clear();
+
+        for (UINT32 Reason = 0; Reason < MaximumVmexitStatisticsExitReasons; Reason++)
+        {
+            if (ReasonCycles[Reason] != 0)
+            {
+                Reasons.push_back(Reason);
+            }
+        }
+
+        sort(Reasons.begin(), Reasons.end(), [&ReasonCycles](UINT32 A, UINT32 B) {
+            return ReasonCycles[A] > ReasonCycles[B];
+        });
+
+        ShowMessages("all cores : %.2f%% of the time is spent in vmx-root\n",
+                     ElapsedTsc != 0 ? (double)TotalCycles * 100 / ((double)ElapsedTsc * CoresCount) : 0);
+
+        ShowMessages("top reasons :");
+
+        for (size_t i = 0; i < Reasons.size() && i < MEASURE_MONITOR_TOP_REASONS; i++)
+        {
+            ShowMessages(" %s (%llx cycles)", CommandVmexitStatsGetReasonName(Reasons[i]), ReasonCycles[Reasons[i]]);
+        }
+
+        ShowMessages("\n\n");
+
+        PreviousTsc = CurrentTsc;
+        PreviousCounts.swap(Counts);
+        PreviousCycles.swap(Cycles);
+    }
+
+    //
+    // Restore the previous state of the statistics
+    //
+    if (!WasEnabled)
+    {
+        RtlZeroMemory(StatisticsRequest, SIZEOF_DEBUGGER_VMEXIT_STATISTICS_REQUEST);
+
+        StatisticsRequest->Action = DEBUGGER_VMEXIT_STATISTICS_ACTION_DISABLE;
+
+        CommandVmexitStatsSendRequest(StatisticsRequest);
+    }
+
+    free(StatisticsRequest);
 }
 
 /**
@@ -50,10 +287,39 @@ CommandMeasureHelp()
  * @return VOID
  */
 VOID
-CommandMeasure(vector<string> SplittedCommand, string Command)
+CommandMeasure(vector<string> & SplittedCommand, string & Command)
 {
     BOOLEAN DefaultMode = FALSE;
 
+    if (SplittedCommand.size() >= 2 && !SplittedCommand.at(1).compare("monitor"))
+    {
+        UINT32 Interval  = MEASURE_MONITOR_DEFAULT_INTERVAL;
+        UINT32 Threshold = MEASURE_MONITOR_DEFAULT_THRESHOLD;
+
+        for (size_t i = 2; i < SplittedCommand.size(); i += 2)
+        {
+            if (i + 1 < SplittedCommand.size() && !SplittedCommand.at(i).compare("interval") &&
+                ConvertStringToUInt32(SplittedCommand.at(i + 1), &Interval) && Interval != 0)
+            {
+                continue;
+            }
+
+            if (i + 1 < SplittedCommand.size() && !SplittedCommand.at(i).compare("threshold") &&
+                ConvertStringToUInt32(SplittedCommand.at(i + 1), &Threshold) && Threshold <= 100)
+            {
+                continue;
+            }
+
+            ShowMessages("err, couldn't resolve error at '%s'\n\n", SplittedCommand.at(i).c_str());
+            CommandMeasureHelp();
+            return;
+        }
+
+        CommandMeasureMonitor(Interval, Threshold);
+
+        return;
+    }
+
     if (SplittedCommand.size() >= 3)
     {
         ShowMessages("incorrect use of '!measure'\n\n");
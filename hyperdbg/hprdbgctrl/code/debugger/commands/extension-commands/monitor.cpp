@@ -11,6 +11,11 @@
  */
 #include "pch.h"
 
+//
+// Global Variables
+//
+extern DEBUGGER_EVENTS_BATCH g_EventsBatch;
+
 /**
  * @brief help of !monitor command
  *
@@ -22,10 +27,26 @@ CommandMonitorHelp()
     ShowMessages("!monitor : monitors address range for read and writes.\n\n");
 
     ShowMessages("syntax : \t!monitor [Mode (string)] [FromAddress (hex)] "
-                 "[ToAddress (hex)] [pid ProcessId (hex)] [core CoreId (hex)] "
+                 "[ToAddress (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] [core CoreId (hex)] "
+                 "[range FromAddress (hex) ToAddress (hex)]* [coalesce AccessCount (hex)] [window Milliseconds (hex)] [slots Count (hex)] "
                  "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
 
+    ShowMessages("\n");
+    ShowMessages("\t\tcoalesce and window summarize the accesses of each core into one trigger, the event is\n"
+                 "\t\ttriggered once the count of accesses is reached or on the first access after the time window\n"
+                 "\t\tis elapsed, the context of the event is a pointer to the summary of the accesses which has\n"
+                 "\t\tthe count of accesses, the lowest, the highest, and the last accessed address (each one 8 bytes)\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\teach range adds another range to the same event (the ranges should not overlap), the ranges\n"
+                 "\t\tcan be also added or removed later by using the 'events range' command\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\tslots reserves the ranges that are added or removed by the scripts (event_add_range and\n"
+                 "\t\tevent_remove_range functions) directly from vmx-root, each range of the slots might span\n"
+                 "\t\tup to two pages and it's translated by the address space of the process that runs the script\n");
+
     ShowMessages("\n");
     ShowMessages("\t\te.g : !monitor rw fffff801deadb000 fffff801deadbfff\n");
     ShowMessages("\t\te.g : !monitor rwx fffff801deadb000 fffff801deadbfff\n");
@@ -34,6 +55,10 @@ CommandMonitorHelp()
     ShowMessages("\t\te.g : !monitor w fffff801deadb000 fffff801deadbfff core 2 pid 400\n");
     ShowMessages("\t\te.g : !monitor x fffff801deadb000 fffff801deadbfff core 2 pid 400\n");
     ShowMessages("\t\te.g : !monitor wx fffff801deadb000 fffff801deadbfff core 2 pid 400\n");
+    ShowMessages("\t\te.g : !monitor rw fffff801deadb000 fffff801deadbfff coalesce 1000\n");
+    ShowMessages("\t\te.g : !monitor w fffff801deadb000 fffff801deadbfff coalesce 1000 window 64\n");
+    ShowMessages("\t\te.g : !monitor rw fffff801deadb000 fffff801deadb0ff range fffff801deadd000 fffff801deadd0ff\n");
+    ShowMessages("\t\te.g : !monitor w fffff801deadb000 fffff801deadb007 slots 100\n");
 }
 
 /**
@@ -44,7 +69,7 @@ CommandMonitorHelp()
  * @return VOID
  */
 VOID
-CommandMonitor(vector<string> SplittedCommand, string Command)
+CommandMonitor(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
@@ -55,11 +80,21 @@ CommandMonitor(vector<string> SplittedCommand, string Command)
     UINT32                             ActionCustomCodeLength      = 0;
     UINT32                             ActionScriptLength          = 0;
     UINT64                             TargetAddress;
-    UINT64                             OptionalParam1 = 0; // Set the 'from' target address
-    UINT64                             OptionalParam2 = 0; // Set the 'to' target address
-    BOOLEAN                            SetFrom        = FALSE;
-    BOOLEAN                            SetTo          = FALSE;
-    BOOLEAN                            SetMode        = FALSE;
+    UINT64                             OptionalParam1              = 0; // Set the 'from' target address
+    UINT64                             OptionalParam2              = 0; // Set the 'to' target address
+    BOOLEAN                            SetFrom                     = FALSE;
+    BOOLEAN                            SetTo                       = FALSE;
+    BOOLEAN                            SetMode                     = FALSE;
+    BOOLEAN                            NextIsCoalescingAccessCount = FALSE;
+    BOOLEAN                            NextIsCoalescingWindow      = FALSE;
+    UINT64                             CoalescingAccessCount       = 0;
+    UINT64                             CoalescingWindow            = 0;
+    UINT64                             RangeAddress;
+    BOOLEAN                            NextIsRangeFrom             = FALSE;
+    BOOLEAN                            NextIsRangeTo               = FALSE;
+    vector<pair<UINT64, UINT64>>       ExtraRanges;
+    BOOLEAN                            NextIsSlots                 = FALSE;
+    UINT32                             MonitorSlots                = 0;
     vector<string>                     SplittedCommandCaseSensitive {Split(Command, ' ')};
     UINT32                             IndexInCommandCaseSensitive = 0;
     DEBUGGER_EVENT_PARSING_ERROR_CAUSE EventParsingErrorCause;
@@ -106,6 +141,77 @@ CommandMonitor(vector<string> SplittedCommand, string Command)
         {
             continue;
         }
+        else if (NextIsCoalescingAccessCount || NextIsCoalescingWindow)
+        {
+            if (!ConvertStringToUInt64(Section, NextIsCoalescingAccessCount ? &CoalescingAccessCount : &CoalescingWindow))
+            {
+                ShowMessages("err, couldn't resolve error at '%s'\n\n", Section.c_str());
+                CommandMonitorHelp();
+
+                FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+                return;
+            }
+
+            NextIsCoalescingAccessCount = FALSE;
+            NextIsCoalescingWindow      = FALSE;
+        }
+        else if (NextIsSlots)
+        {
+            if (!ConvertStringToUInt32(Section, &MonitorSlots))
+            {
+                ShowMessages("err, couldn't resolve error at '%s'\n\n", Section.c_str());
+                CommandMonitorHelp();
+
+                FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+                return;
+            }
+
+            NextIsSlots = FALSE;
+        }
+        else if (NextIsRangeFrom || NextIsRangeTo)
+        {
+            if (!SymbolConvertNameOrExprToAddress(
+                    SplittedCommandCaseSensitive.at(IndexInCommandCaseSensitive - 1),
+                    &RangeAddress))
+            {
+                ShowMessages("err, couldn't resolve error at '%s'\n\n",
+                             SplittedCommandCaseSensitive.at(IndexInCommandCaseSensitive - 1).c_str());
+                CommandMonitorHelp();
+
+                FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+                return;
+            }
+
+            if (NextIsRangeFrom)
+            {
+                ExtraRanges.push_back({RangeAddress, 0});
+
+                NextIsRangeFrom = FALSE;
+                NextIsRangeTo   = TRUE;
+            }
+            else
+            {
+                ExtraRanges.back().second = RangeAddress;
+
+                NextIsRangeTo = FALSE;
+            }
+        }
+        else if (!Section.compare("range"))
+        {
+            NextIsRangeFrom = TRUE;
+        }
+        else if (!Section.compare("coalesce"))
+        {
+            NextIsCoalescingAccessCount = TRUE;
+        }
+        else if (!Section.compare("window"))
+        {
+            NextIsCoalescingWindow = TRUE;
+        }
+        else if (!Section.compare("slots"))
+        {
+            NextIsSlots = TRUE;
+        }
         else if (!Section.compare("r") && !SetMode)
         {
             Event->EventType = HIDDEN_HOOK_READ;
@@ -215,6 +321,51 @@ CommandMonitor(vector<string> SplittedCommand, string Command)
         return;
     }
 
+    //
+    // Check if the value of coalescing parameters is specified
+    //
+    if (NextIsCoalescingAccessCount || NextIsCoalescingWindow || NextIsSlots)
+    {
+        ShowMessages("please specify a value for 'coalesce', 'window', or 'slots'\n");
+
+        FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+        return;
+    }
+
+    //
+    // Check the extra ranges (if any)
+    //
+    if (NextIsRangeFrom || NextIsRangeTo)
+    {
+        ShowMessages("please specify both the 'from' and the 'to' values of the 'range'\n");
+
+        FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+        return;
+    }
+
+    for (auto & Range : ExtraRanges)
+    {
+        if (Range.first >= Range.second)
+        {
+            ShowMessages("please choose the 'from' value first, then choose the 'to' "
+                         "value of the 'range'\n");
+
+            FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+            return;
+        }
+    }
+
+    if (!ExtraRanges.empty() && g_EventsBatch.IsActive)
+    {
+        //
+        // The ranges are added once the event is registered
+        //
+        ShowMessages("err, the extra ranges cannot be used while the events are batched\n");
+
+        FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+        return;
+    }
+
     //
     // Check if user set the mode of !monitor or not
     //
@@ -231,6 +382,9 @@ CommandMonitor(vector<string> SplittedCommand, string Command)
     //
     Event->OptionalParam1 = OptionalParam1;
     Event->OptionalParam2 = OptionalParam2;
+    Event->OptionalParam3 = CoalescingAccessCount; // Count of coalesced accesses (if any)
+    Event->OptionalParam4 = CoalescingWindow;      // Time window of coalescing accesses in milliseconds (if any)
+    Event->MonitorSlots   = MonitorSlots;          // Count of the ranges that are added by the scripts (if any)
 
     //
     // Send the ioctl to the kernel for event registration
@@ -265,4 +419,16 @@ CommandMonitor(vector<string> SplittedCommand, string Command)
         FreeEventsAndActionsMemory(Event, ActionBreakToDebugger, ActionCustomCode, ActionScript);
         return;
     }
+
+    //
+    // Add the extra ranges to the registered event, the event remains
+    // with the ranges that are added successfully
+    //
+    for (auto & Range : ExtraRanges)
+    {
+        if (!CommandEventsModifyMonitorRange(Event->Tag, DEBUGGER_MODIFY_EVENTS_ADD_MONITOR_RANGE, Range.first, Range.second))
+        {
+            break;
+        }
+    }
 }
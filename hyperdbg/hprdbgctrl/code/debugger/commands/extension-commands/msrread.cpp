@@ -21,7 +21,7 @@ CommandMsrreadHelp()
 {
     ShowMessages("!msrread : detects the execution of rdmsr instructions.\n\n");
 
-    ShowMessages("syntax : \t!msrread [Msr (hex)] [pid ProcessId (hex)] "
+    ShowMessages("syntax : \t!msrread [Msr (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] "
                  "[core CoreId (hex)] [imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
 
@@ -40,7 +40,7 @@ CommandMsrreadHelp()
  * @return VOID
  */
 VOID
-CommandMsrread(vector<string> SplittedCommand, string Command)
+CommandMsrread(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
@@ -21,7 +21,7 @@ CommandMsrwriteHelp()
 {
     ShowMessages("!msrwrite : detects the execution of wrmsr instructions.\n\n");
 
-    ShowMessages("syntax : \t!msrwrite [Msr (hex)] [pid ProcessId (hex)] "
+    ShowMessages("syntax : \t!msrwrite [Msr (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] "
                  "[core CoreId (hex)] [imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
 
@@ -40,7 +40,7 @@ CommandMsrwriteHelp()
  * @return VOID
  */
 VOID
-CommandMsrwrite(vector<string> SplittedCommand, string Command)
+CommandMsrwrite(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
@@ -28,6 +28,7 @@ CommandPa2vaHelp()
     ShowMessages("!pa2va : converts virtual address to physical address.\n\n");
 
     ShowMessages("syntax : \t!pa2va [PhysicalAddress (hex)] [pid ProcessId (hex)]\n");
+    ShowMessages("syntax : \t!pa2va [PhysicalAddress (hex)] [all] [rebuild]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : !pa2va nt!ExAllocatePoolWithTag\n");
@@ -35,6 +36,105 @@ CommandPa2vaHelp()
     ShowMessages("\t\te.g : !pa2va @rax+5\n");
     ShowMessages("\t\te.g : !pa2va fffff801deadbeef\n");
     ShowMessages("\t\te.g : !pa2va fffff801deadbeef pid 0xc8\n");
+    ShowMessages("\t\te.g : !pa2va 1f4a000 all\n");
+    ShowMessages("\t\te.g : !pa2va 1f4a000 all rebuild\n");
+
+    ShowMessages("\nnote : 'all' shows the mappings of the physical address in all of the processes,\n"
+                 "the index of the mappings is rebuilt if it's older than ten seconds, or if 'rebuild' is specified\n");
+}
+
+/**
+ * @brief show the virtual addresses of all of the processes that map
+ * a physical address
+ *
+ * @param TargetPa
+ * @param Rebuild
+ * @return VOID
+ */
+VOID
+CommandPa2vaAllProcesses(UINT64 TargetPa, BOOLEAN Rebuild)
+{
+    BOOL                            Status;
+    ULONG                           ReturnedLength;
+    PDEBUGGER_QUERY_REVERSE_MAPPING ReverseMappingRequest;
+
+    //
+    // The index is built by walking the page-tables in the kernel
+    // so it's not available while the debuggee is halted
+    //
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, you cannot use 'all' in the debugger mode\n");
+        return;
+    }
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+
+    ReverseMappingRequest = (PDEBUGGER_QUERY_REVERSE_MAPPING)calloc(1, SIZEOF_DEBUGGER_QUERY_REVERSE_MAPPING);
+
+    if (ReverseMappingRequest == NULL)
+    {
+        ShowMessages("err, unable to allocate memory\n");
+        return;
+    }
+
+    ReverseMappingRequest->PhysicalAddress = TargetPa;
+    ReverseMappingRequest->Rebuild         = Rebuild;
+
+    //
+    // Send IOCTL
+    //
+    Status = DeviceIoControl(
+        g_DeviceHandle,                        // Handle to device
+        IOCTL_QUERY_REVERSE_MAPPING,           // IO Control code
+        ReverseMappingRequest,                 // Input Buffer to driver.
+        SIZEOF_DEBUGGER_QUERY_REVERSE_MAPPING, // Input buffer length
+        ReverseMappingRequest,                 // Output Buffer from driver.
+        SIZEOF_DEBUGGER_QUERY_REVERSE_MAPPING, // Length of output
+                                               // buffer in bytes.
+        &ReturnedLength,                       // Bytes placed in buffer.
+        NULL                                   // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        free(ReverseMappingRequest);
+        return;
+    }
+
+    if (ReverseMappingRequest->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        //
+        // Show the results
+        //
+        for (UINT32 i = 0; i < ReverseMappingRequest->CountOfMappings; i++)
+        {
+            ShowMessages("pid: %x\t%llx\n",
+                         ReverseMappingRequest->Mappings[i].ProcessId,
+                         ReverseMappingRequest->Mappings[i].VirtualAddress);
+        }
+
+        if (ReverseMappingRequest->CountOfMappings == 0)
+        {
+            ShowMessages("no virtual address maps this physical address\n");
+        }
+        else if (ReverseMappingRequest->CountOfMappings == MaximumReverseMappingsToQuery)
+        {
+            ShowMessages("only the first %d mappings are shown\n", MaximumReverseMappingsToQuery);
+        }
+
+        ShowMessages("(0x%x mappings are indexed)\n", ReverseMappingRequest->CountOfIndexedMappings);
+    }
+    else
+    {
+        //
+        // An err occurred, no results
+        //
+        ShowErrorMessage(ReverseMappingRequest->KernelStatus);
+    }
+
+    free(ReverseMappingRequest);
 }
 
 /**
@@ -45,7 +145,7 @@ CommandPa2vaHelp()
  * @return VOID
  */
 VOID
-CommandPa2va(vector<string> SplittedCommand, string Command)
+CommandPa2va(vector<string> & SplittedCommand, string & Command)
 {
     BOOL                              Status;
     ULONG                             ReturnedLength;
@@ -54,6 +154,30 @@ CommandPa2va(vector<string> SplittedCommand, string Command)
     DEBUGGER_VA2PA_AND_PA2VA_COMMANDS AddressDetails = {0};
     vector<string>                    SplittedCommandCaseSensitive {Split(Command, ' ')};
 
+    if (SplittedCommand.size() >= 3 && !SplittedCommand.at(2).compare("all"))
+    {
+        if (SplittedCommand.size() >= 5 ||
+            (SplittedCommand.size() == 4 && SplittedCommand.at(3).compare("rebuild")))
+        {
+            ShowMessages("incorrect use of '!pa2va'\n\n");
+            CommandPa2vaHelp();
+            return;
+        }
+
+        if (!SymbolConvertNameOrExprToAddress(SplittedCommandCaseSensitive.at(1), &TargetPa))
+        {
+            //
+            // Couldn't resolve or unkonwn parameter
+            //
+            ShowMessages("err, couldn't resolve error at '%s'\n",
+                         SplittedCommandCaseSensitive.at(1).c_str());
+            return;
+        }
+
+        CommandPa2vaAllProcesses(TargetPa, SplittedCommand.size() == 4);
+        return;
+    }
+
     if (SplittedCommand.size() == 1 || SplittedCommand.size() >= 5 ||
         SplittedCommand.size() == 3)
     {
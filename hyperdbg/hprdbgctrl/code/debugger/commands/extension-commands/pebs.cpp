@@ -0,0 +1,332 @@
+/**
+ * @file pebs.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief !pebs command
+ * @details
+ * @version 0.4
+ * @date 2023-08-11
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+extern HANDLE  g_DeviceHandle;
+
+/**
+ * @brief The default count of the (RIP, data address) pairs that are shown
+ *
+ */
+#define PEBS_DEFAULT_SHOWN_ENTRIES 20
+
+/**
+ * @brief help of !pebs command
+ *
+ * @return VOID
+ */
+VOID
+CommandPebsHelp()
+{
+    ShowMessages("!pebs : samples the loads and the stores of the guest to a range of addresses "
+                 "using PEBS (Precise Event Based Sampling) and shows the instructions and the "
+                 "addresses that are sampled the most.\n\n");
+
+    ShowMessages("syntax : \t!pebs [start] [loads] [stores] [user] [kernel] [range FromAddress (hex) ToAddress (hex)] "
+                 "[rate EventsPerSample (hex)] [latency Cycles (hex)]\n");
+    ShowMessages("syntax : \t!pebs [count Count (hex)]\n");
+    ShowMessages("syntax : \t!pebs [stop]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : !pebs start\n");
+    ShowMessages("\t\te.g : !pebs start loads stores range fffff801deadb000 fffff801deadbfff\n");
+    ShowMessages("\t\te.g : !pebs start stores user range 7ff6a0000000 7ff6a000ffff rate 100\n");
+    ShowMessages("\t\te.g : !pebs start loads kernel latency 40\n");
+    ShowMessages("\t\te.g : !pebs\n");
+    ShowMessages("\t\te.g : !pebs count 40\n");
+    ShowMessages("\t\te.g : !pebs stop\n");
+
+    ShowMessages("\n");
+    ShowMessages("the accesses are recorded by the processor without any vm-exit, a record is taken once in "
+                 "each 'rate' events (the default rate is %x, lower rates have more overhead), only the "
+                 "loads that take more than 'latency' cycles are sampled (the default latency is %x), the "
+                 "loads are sampled by default, both user-mode and kernel-mode are sampled if none of them "
+                 "is specified, the records out of the range are counted but not shown\n",
+                 PebsSamplingDefaultSampleAfterValue,
+                 PebsSamplingDefaultLatencyThreshold);
+}
+
+/**
+ * @brief Send the request of the PEBS sampling to the driver
+ *
+ * @param PebsRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandPebsSendRequest(PDEBUGGER_PEBS_SAMPLING_REQUEST PebsRequest)
+{
+    BOOL  Status;
+    ULONG ReturnedLength;
+
+    Status = DeviceIoControl(
+        g_DeviceHandle,                        // Handle to device
+        IOCTL_PEBS_SAMPLING,                   // IO Control code
+        PebsRequest,                           // Input Buffer to driver.
+        SIZEOF_DEBUGGER_PEBS_SAMPLING_REQUEST, // Input buffer length
+        PebsRequest,                           // Output Buffer from driver.
+        SIZEOF_DEBUGGER_PEBS_SAMPLING_REQUEST, // Length of output buffer in
+                                               // bytes.
+        &ReturnedLength,                       // Bytes placed in buffer.
+        NULL                                   // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        return FALSE;
+    }
+
+    if (PebsRequest->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(PebsRequest->KernelStatus);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Query the entries of all cores and show the pairs that are
+ * sampled the most
+ *
+ * @param PebsRequest
+ * @param Count Maximum count of the pairs to show
+ *
+ * @return VOID
+ */
+VOID
+CommandPebsShowEntries(PDEBUGGER_PEBS_SAMPLING_REQUEST PebsRequest, UINT32 Count)
+{
+    std::map<pair<UINT64, UINT64>, UINT64> Pairs;
+    UINT64                                 TotalRecords     = 0;
+    UINT64                                 TotalFilteredOut = 0;
+    UINT64                                 TotalDropped     = 0;
+    UINT32                                 CountOfCores     = 1;
+
+    for (UINT32 CoreId = 0; CoreId < CountOfCores; CoreId++)
+    {
+        PebsRequest->StartIndex = 0;
+
+        do
+        {
+            PebsRequest->Action = DEBUGGER_PEBS_SAMPLING_ACTION_QUERY;
+            PebsRequest->CoreId = CoreId;
+
+            if (!CommandPebsSendRequest(PebsRequest))
+            {
+                return;
+            }
+
+            for (UINT32 i = 0; i < PebsRequest->CountOfEntries; i++)
+            {
+                Pairs[{PebsRequest->Entries[i].Rip, PebsRequest->Entries[i].DataAddress}] += PebsRequest->Entries[i].Count;
+            }
+
+            PebsRequest->StartIndex = PebsRequest->NextIndex;
+
+        } while (PebsRequest->NextIndex < PebsRequest->TableCapacity);
+
+        CountOfCores = PebsRequest->CountOfCores;
+
+        TotalRecords += PebsRequest->CountOfRecords;
+        TotalFilteredOut += PebsRequest->CountOfFilteredOut;
+        TotalDropped += PebsRequest->CountOfDropped;
+    }
+
+    if (!PebsRequest->IsEnabled)
+    {
+        ShowMessages("the PEBS sampling is not started, use '!pebs start' to start it\n\n");
+    }
+
+    if (TotalRecords == 0)
+    {
+        ShowMessages("no access is sampled in the range (out of the range : %llx)\n", TotalFilteredOut);
+        return;
+    }
+
+    vector<pair<pair<UINT64, UINT64>, UINT64>> SortedPairs(Pairs.begin(), Pairs.end());
+
+    sort(SortedPairs.begin(), SortedPairs.end(), [](const pair<pair<UINT64, UINT64>, UINT64> & A, const pair<pair<UINT64, UINT64>, UINT64> & B) {
+        return A.second > B.second;
+    });
+
+    ShowMessages("records : %llx, out of the range : %llx, dropped : %llx\n\n",
+                 TotalRecords,
+                 TotalFilteredOut,
+                 TotalDropped);
+
+    ShowMessages("samples   percent   data address        instruction\n");
+
+    for (size_t i = 0; i < SortedPairs.size() && i < Count; i++)
+    {
+        UINT64      FunctionAddress;
+        std::string FunctionName;
+        UINT64      Rip         = SortedPairs[i].first.first;
+        UINT64      DataAddress = SortedPairs[i].first.second;
+
+        ShowMessages("%-8llx  %6.2f%%   %s   ",
+                     SortedPairs[i].second,
+                     (double)SortedPairs[i].second * 100 / TotalRecords,
+                     SeparateTo64BitValue(DataAddress).c_str());
+
+        if (SymbolQueryFunctionOfAddress(Rip, &FunctionAddress, FunctionName))
+        {
+            ShowMessages("%s+%llx (%s)\n", FunctionName.c_str(), Rip - FunctionAddress, SeparateTo64BitValue(Rip).c_str());
+        }
+        else
+        {
+            ShowMessages("%s\n", SeparateTo64BitValue(Rip).c_str());
+        }
+    }
+}
+
+/**
+ * @brief !pebs command handler
+ *
+ * @param SplittedCommand
+ * @param Command
+ * @return VOID
+ */
+VOID
+CommandPebs(vector<string> & SplittedCommand, string & Command)
+{
+    PDEBUGGER_PEBS_SAMPLING_REQUEST PebsRequest;
+    DEBUGGER_PEBS_SAMPLING_ACTION   Action           = DEBUGGER_PEBS_SAMPLING_ACTION_QUERY;
+    UINT32                          Count            = PEBS_DEFAULT_SHOWN_ENTRIES;
+    UINT32                          SampleAfterValue = 0;
+    UINT32                          LatencyThreshold = 0;
+    UINT64                          StartAddress     = 0;
+    UINT64                          EndAddress       = MAXUINT64;
+    BOOLEAN                         SampleLoads      = FALSE;
+    BOOLEAN                         SampleStores     = FALSE;
+    BOOLEAN                         SampleUserMode   = FALSE;
+    BOOLEAN                         SampleKernelMode = FALSE;
+
+    for (size_t i = 1; i < SplittedCommand.size(); i++)
+    {
+        if (i == 1 && !SplittedCommand.at(i).compare("start"))
+        {
+            Action = DEBUGGER_PEBS_SAMPLING_ACTION_START;
+        }
+        else if (i == 1 && SplittedCommand.size() == 2 && !SplittedCommand.at(i).compare("stop"))
+        {
+            Action = DEBUGGER_PEBS_SAMPLING_ACTION_STOP;
+        }
+        else if (Action == DEBUGGER_PEBS_SAMPLING_ACTION_START && !SplittedCommand.at(i).compare("loads"))
+        {
+            SampleLoads = TRUE;
+        }
+        else if (Action == DEBUGGER_PEBS_SAMPLING_ACTION_START && !SplittedCommand.at(i).compare("stores"))
+        {
+            SampleStores = TRUE;
+        }
+        else if (Action == DEBUGGER_PEBS_SAMPLING_ACTION_START && !SplittedCommand.at(i).compare("user"))
+        {
+            SampleUserMode = TRUE;
+        }
+        else if (Action == DEBUGGER_PEBS_SAMPLING_ACTION_START && !SplittedCommand.at(i).compare("kernel"))
+        {
+            SampleKernelMode = TRUE;
+        }
+        else if (Action == DEBUGGER_PEBS_SAMPLING_ACTION_START && !SplittedCommand.at(i).compare("range") &&
+                 i + 2 < SplittedCommand.size() &&
+                 SymbolConvertNameOrExprToAddress(SplittedCommand.at(i + 1), &StartAddress) &&
+                 SymbolConvertNameOrExprToAddress(SplittedCommand.at(i + 2), &EndAddress))
+        {
+            i += 2;
+        }
+        else if (Action == DEBUGGER_PEBS_SAMPLING_ACTION_START && !SplittedCommand.at(i).compare("rate") &&
+                 i + 1 < SplittedCommand.size() && ConvertStringToUInt32(SplittedCommand.at(i + 1), &SampleAfterValue) &&
+                 SampleAfterValue != 0)
+        {
+            i++;
+        }
+        else if (Action == DEBUGGER_PEBS_SAMPLING_ACTION_START && !SplittedCommand.at(i).compare("latency") &&
+                 i + 1 < SplittedCommand.size() && ConvertStringToUInt32(SplittedCommand.at(i + 1), &LatencyThreshold) &&
+                 LatencyThreshold != 0)
+        {
+            i++;
+        }
+        else if (Action == DEBUGGER_PEBS_SAMPLING_ACTION_QUERY && !SplittedCommand.at(i).compare("count") &&
+                 i + 1 < SplittedCommand.size() && ConvertStringToUInt32(SplittedCommand.at(i + 1), &Count))
+        {
+            i++;
+        }
+        else
+        {
+            ShowMessages("err, couldn't resolve error at '%s'\n\n", SplittedCommand.at(i).c_str());
+            CommandPebsHelp();
+            return;
+        }
+    }
+
+    if (StartAddress > EndAddress)
+    {
+        ShowMessages("err, please note that the 'to' address should be greater than the 'from' address\n");
+        return;
+    }
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, the PEBS sampling is not supported in the debugger mode\n");
+        return;
+    }
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+
+    PebsRequest = (PDEBUGGER_PEBS_SAMPLING_REQUEST)malloc(SIZEOF_DEBUGGER_PEBS_SAMPLING_REQUEST);
+
+    if (PebsRequest == NULL)
+    {
+        return;
+    }
+
+    RtlZeroMemory(PebsRequest, SIZEOF_DEBUGGER_PEBS_SAMPLING_REQUEST);
+
+    if (Action == DEBUGGER_PEBS_SAMPLING_ACTION_START)
+    {
+        PebsRequest->Action           = DEBUGGER_PEBS_SAMPLING_ACTION_START;
+        PebsRequest->SampleLoads      = SampleLoads || !SampleStores;
+        PebsRequest->SampleStores     = SampleStores;
+        PebsRequest->SampleUserMode   = SampleUserMode || !SampleKernelMode;
+        PebsRequest->SampleKernelMode = SampleKernelMode || !SampleUserMode;
+        PebsRequest->StartAddress     = StartAddress;
+        PebsRequest->EndAddress       = EndAddress;
+        PebsRequest->SampleAfterValue = SampleAfterValue;
+        PebsRequest->LatencyThreshold = LatencyThreshold;
+
+        if (CommandPebsSendRequest(PebsRequest))
+        {
+            ShowMessages("the PEBS sampling is started\n");
+        }
+    }
+    else if (Action == DEBUGGER_PEBS_SAMPLING_ACTION_STOP)
+    {
+        PebsRequest->Action = DEBUGGER_PEBS_SAMPLING_ACTION_STOP;
+
+        if (CommandPebsSendRequest(PebsRequest))
+        {
+            ShowMessages("the PEBS sampling is stopped\n");
+        }
+    }
+    else
+    {
+        CommandPebsShowEntries(PebsRequest, Count);
+    }
+
+    free(PebsRequest);
+}
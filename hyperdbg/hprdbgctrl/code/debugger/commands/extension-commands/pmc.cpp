@@ -21,7 +21,7 @@ CommandPmcHelp()
 {
     ShowMessages("!pmc : monitors execution of rdpmc instructions.\n\n");
 
-    ShowMessages("syntax : \t!pmc [pid ProcessId (hex)] [core CoreId (hex)] "
+    ShowMessages("syntax : \t!pmc [pid ProcessId (hex)] [tid ThreadId (hex)] [core CoreId (hex)] "
                  "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
 
@@ -39,7 +39,7 @@ CommandPmcHelp()
  * @return VOID
  */
 VOID
-CommandPmc(vector<string> SplittedCommand, string Command)
+CommandPmc(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
@@ -0,0 +1,364 @@
+/**
+ * @file profiler.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief !profiler command
+ * @details
+ * @version 0.4
+ * @date 2023-08-01
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+extern HANDLE  g_DeviceHandle;
+
+/**
+ * @brief The default TSC ticks between the samples of each core
+ *
+ */
+#define PROFILER_DEFAULT_INTERVAL 0x100000
+
+/**
+ * @brief The default count of the functions that are shown
+ *
+ */
+#define PROFILER_DEFAULT_SHOWN_FUNCTIONS 20
+
+/**
+ * @brief The aggregated samples of a single function (or address)
+ *
+ */
+typedef struct _PROFILER_FUNCTION_SAMPLES
+{
+    UINT64 SelfCount;      // Samples that are taken within the function
+    UINT64 InclusiveCount; // Samples that the function is within their stack
+
+} PROFILER_FUNCTION_SAMPLES, *PPROFILER_FUNCTION_SAMPLES;
+
+//
+// The samples that are aggregated from the last time that the profiler is started
+//
+static std::map<UINT64, PROFILER_FUNCTION_SAMPLES> g_ProfilerFunctions;
+static UINT64                                      g_ProfilerTotalSamples   = 0;
+static UINT64                                      g_ProfilerDroppedSamples = 0;
+
+/**
+ * @brief help of !profiler command
+ *
+ * @return VOID
+ */
+VOID
+CommandProfilerHelp()
+{
+    ShowMessages("!profiler : samples the guest's execution on all cores and shows the "
+                 "functions that are sampled the most.\n\n");
+
+    ShowMessages("syntax : \t!profiler [start] [interval TscTicks (hex)] [stack]\n");
+    ShowMessages("syntax : \t!profiler [count Count (hex)]\n");
+    ShowMessages("syntax : \t!profiler [stop]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : !profiler start\n");
+    ShowMessages("\t\te.g : !profiler start interval 200000\n");
+    ShowMessages("\t\te.g : !profiler start interval 200000 stack\n");
+    ShowMessages("\t\te.g : !profiler\n");
+    ShowMessages("\t\te.g : !profiler count 40\n");
+    ShowMessages("\t\te.g : !profiler stop\n");
+
+    ShowMessages("\n");
+    ShowMessages("each core is sampled once in each interval (the default interval is %x TSC ticks) "
+                 "using the VMX preemption timer, the 'stack' also takes the shallow stack of the samples "
+                 "to show the inclusive samples of the functions, the addresses are grouped by their symbols "
+                 "(use '.sym reload' to load them)\n",
+                 PROFILER_DEFAULT_INTERVAL);
+}
+
+/**
+ * @brief Send the request of the sampling profiler to the driver
+ *
+ * @param ProfilerRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandProfilerSendRequest(PDEBUGGER_SAMPLING_PROFILER_REQUEST ProfilerRequest)
+{
+    BOOL  Status;
+    ULONG ReturnedLength;
+
+    Status = DeviceIoControl(
+        g_DeviceHandle,                            // Handle to device
+        IOCTL_SAMPLING_PROFILER,                   // IO Control code
+        ProfilerRequest,                           // Input Buffer to driver.
+        SIZEOF_DEBUGGER_SAMPLING_PROFILER_REQUEST, // Input buffer length
+        ProfilerRequest,                           // Output Buffer from driver.
+        SIZEOF_DEBUGGER_SAMPLING_PROFILER_REQUEST, // Length of output buffer in
+                                                   // bytes.
+        &ReturnedLength,                           // Bytes placed in buffer.
+        NULL                                       // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        return FALSE;
+    }
+
+    if (ProfilerRequest->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(ProfilerRequest->KernelStatus);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the address that the samples of an address are grouped by
+ *
+ * @param Address
+ *
+ * @return UINT64 The start of the function or the address itself (if no
+ * symbol is found)
+ */
+UINT64
+CommandProfilerGetGroupAddress(UINT64 Address)
+{
+    UINT64      FunctionAddress;
+    std::string FunctionName;
+
+    if (SymbolQueryFunctionOfAddress(Address, &FunctionAddress, FunctionName))
+    {
+        return FunctionAddress;
+    }
+
+    return Address;
+}
+
+/**
+ * @brief Aggregate the samples of a query into the functions
+ *
+ * @param ProfilerRequest
+ *
+ * @return VOID
+ */
+VOID
+CommandProfilerAggregateSamples(PDEBUGGER_SAMPLING_PROFILER_REQUEST ProfilerRequest)
+{
+    for (UINT32 i = 0; i < ProfilerRequest->CountOfSamples; i++)
+    {
+        PSAMPLING_PROFILER_SAMPLE Sample = &ProfilerRequest->Samples[i];
+        vector<UINT64>            VisitedFunctions;
+        UINT64                    Function = CommandProfilerGetGroupAddress(Sample->Rip);
+
+        g_ProfilerFunctions[Function].SelfCount++;
+        VisitedFunctions.push_back(Function);
+
+        //
+        // The recursive functions are counted once in each sample
+        //
+        for (UINT32 j = 0; j < Sample->CountOfStackFrames && j < SamplingProfilerMaximumStackFrames; j++)
+        {
+            Function = CommandProfilerGetGroupAddress(Sample->StackFrames[j]);
+
+            if (find(VisitedFunctions.begin(), VisitedFunctions.end(), Function) == VisitedFunctions.end())
+            {
+                VisitedFunctions.push_back(Function);
+            }
+        }
+
+        for (auto VisitedFunction : VisitedFunctions)
+        {
+            g_ProfilerFunctions[VisitedFunction].InclusiveCount++;
+        }
+
+        g_ProfilerTotalSamples++;
+    }
+
+    g_ProfilerDroppedSamples += ProfilerRequest->DroppedSamples;
+}
+
+/**
+ * @brief Show the functions that are sampled the most
+ *
+ * @param Count Maximum count of the functions to show
+ *
+ * @return VOID
+ */
+VOID
+CommandProfilerShowFunctions(UINT32 Count)
+{
+    vector<pair<UINT64, PROFILER_FUNCTION_SAMPLES>> Functions(g_ProfilerFunctions.begin(), g_ProfilerFunctions.end());
+
+    if (g_ProfilerTotalSamples == 0)
+    {
+        ShowMessages("no sample is taken\n");
+        return;
+    }
+
+    sort(Functions.begin(), Functions.end(), [](const pair<UINT64, PROFILER_FUNCTION_SAMPLES> & A, const pair<UINT64, PROFILER_FUNCTION_SAMPLES> & B) {
+        return A.second.SelfCount > B.second.SelfCount;
+    });
+
+    ShowMessages("samples : %llx, dropped samples : %llx\n\n", g_ProfilerTotalSamples, g_ProfilerDroppedSamples);
+
+    ShowMessages("self      inclusive  function\n");
+
+    for (size_t i = 0; i < Functions.size() && i < Count; i++)
+    {
+        UINT64      FunctionAddress;
+        std::string FunctionName;
+
+        ShowMessages("%6.2f%%   %6.2f%%    ",
+                     (double)Functions[i].second.SelfCount * 100 / g_ProfilerTotalSamples,
+                     (double)Functions[i].second.InclusiveCount * 100 / g_ProfilerTotalSamples);
+
+        if (SymbolQueryFunctionOfAddress(Functions[i].first, &FunctionAddress, FunctionName))
+        {
+            ShowMessages("%s (%s)\n", FunctionName.c_str(), SeparateTo64BitValue(Functions[i].first).c_str());
+        }
+        else
+        {
+            ShowMessages("%s\n", SeparateTo64BitValue(Functions[i].first).c_str());
+        }
+    }
+}
+
+/**
+ * @brief !profiler command handler
+ *
+ * @param SplittedCommand
+ * @param Command
+ * @return VOID
+ */
+VOID
+CommandProfiler(vector<string> & SplittedCommand, string & Command)
+{
+    PDEBUGGER_SAMPLING_PROFILER_REQUEST ProfilerRequest;
+    DEBUGGER_SAMPLING_PROFILER_ACTION   Action       = DEBUGGER_SAMPLING_PROFILER_ACTION_QUERY;
+    UINT64                              Interval     = PROFILER_DEFAULT_INTERVAL;
+    UINT32                              Count        = PROFILER_DEFAULT_SHOWN_FUNCTIONS;
+    BOOLEAN                             CaptureStack = FALSE;
+
+    for (size_t i = 1; i < SplittedCommand.size(); i++)
+    {
+        if (i == 1 && !SplittedCommand.at(i).compare("start"))
+        {
+            Action = DEBUGGER_SAMPLING_PROFILER_ACTION_START;
+        }
+        else if (i == 1 && SplittedCommand.size() == 2 && !SplittedCommand.at(i).compare("stop"))
+        {
+            Action = DEBUGGER_SAMPLING_PROFILER_ACTION_STOP;
+        }
+        else if (Action == DEBUGGER_SAMPLING_PROFILER_ACTION_START && !SplittedCommand.at(i).compare("stack"))
+        {
+            CaptureStack = TRUE;
+        }
+        else if (Action == DEBUGGER_SAMPLING_PROFILER_ACTION_START && !SplittedCommand.at(i).compare("interval") &&
+                 i + 1 < SplittedCommand.size() && ConvertStringToUInt64(SplittedCommand.at(i + 1), &Interval) && Interval != 0)
+        {
+            i++;
+        }
+        else if (Action == DEBUGGER_SAMPLING_PROFILER_ACTION_QUERY && !SplittedCommand.at(i).compare("count") &&
+                 i + 1 < SplittedCommand.size() && ConvertStringToUInt32(SplittedCommand.at(i + 1), &Count))
+        {
+            i++;
+        }
+        else
+        {
+            ShowMessages("err, couldn't resolve error at '%s'\n\n", SplittedCommand.at(i).c_str());
+            CommandProfilerHelp();
+            return;
+        }
+    }
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, the sampling profiler is not supported in the debugger mode\n");
+        return;
+    }
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+
+    ProfilerRequest = (PDEBUGGER_SAMPLING_PROFILER_REQUEST)malloc(SIZEOF_DEBUGGER_SAMPLING_PROFILER_REQUEST);
+
+    if (ProfilerRequest == NULL)
+    {
+        return;
+    }
+
+    RtlZeroMemory(ProfilerRequest, SIZEOF_DEBUGGER_SAMPLING_PROFILER_REQUEST);
+
+    if (Action == DEBUGGER_SAMPLING_PROFILER_ACTION_START)
+    {
+        //
+        // Discard the samples of the previous profiling
+        //
+        do
+        {
+            ProfilerRequest->Action = DEBUGGER_SAMPLING_PROFILER_ACTION_QUERY;
+
+            if (!CommandProfilerSendRequest(ProfilerRequest))
+            {
+                free(ProfilerRequest);
+                return;
+            }
+
+        } while (ProfilerRequest->CountOfSamples != 0);
+
+        g_ProfilerFunctions.clear();
+        g_ProfilerTotalSamples   = 0;
+        g_ProfilerDroppedSamples = 0;
+
+        ProfilerRequest->Action       = DEBUGGER_SAMPLING_PROFILER_ACTION_START;
+        ProfilerRequest->Interval     = Interval;
+        ProfilerRequest->CaptureStack = CaptureStack;
+
+        if (CommandProfilerSendRequest(ProfilerRequest))
+        {
+            ShowMessages("the sampling profiler is started\n");
+        }
+    }
+    else if (Action == DEBUGGER_SAMPLING_PROFILER_ACTION_STOP)
+    {
+        ProfilerRequest->Action = DEBUGGER_SAMPLING_PROFILER_ACTION_STOP;
+
+        if (CommandProfilerSendRequest(ProfilerRequest))
+        {
+            ShowMessages("the sampling profiler is stopped\n");
+        }
+    }
+    else
+    {
+        //
+        // Take all of the samples that are taken until now
+        //
+        do
+        {
+            ProfilerRequest->Action = DEBUGGER_SAMPLING_PROFILER_ACTION_QUERY;
+
+            if (!CommandProfilerSendRequest(ProfilerRequest))
+            {
+                free(ProfilerRequest);
+                return;
+            }
+
+            CommandProfilerAggregateSamples(ProfilerRequest);
+
+        } while (ProfilerRequest->CountOfSamples != 0);
+
+        if (!ProfilerRequest->IsEnabled)
+        {
+            ShowMessages("the sampling profiler is not started, use '!profiler start' to start it\n\n");
+        }
+
+        CommandProfilerShowFunctions(Count);
+    }
+
+    free(ProfilerRequest);
+}
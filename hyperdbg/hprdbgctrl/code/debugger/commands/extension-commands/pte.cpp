@@ -88,7 +88,7 @@ CommandPteShowResults(UINT64 TargetVa, PDEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS
  * @return VOID
  */
 VOID
-CommandPte(vector<string> SplittedCommand, string Command)
+CommandPte(vector<string> & SplittedCommand, string & Command)
 {
     BOOL                                     Status;
     ULONG                                    ReturnedLength;
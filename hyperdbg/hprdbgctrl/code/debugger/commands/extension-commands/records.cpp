@@ -0,0 +1,208 @@
+/**
+ * @file records.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief !records command
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+extern HANDLE  g_DeviceHandle;
+
+/**
+ * @brief help of !records command
+ *
+ * @return VOID
+ */
+VOID
+CommandRecordsHelp()
+{
+    ShowMessages("!records : shows (or saves) the records of the hits of the events that use 'record'.\n\n");
+
+    ShowMessages("syntax : \t!records [FilePath (string)]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : !records\n");
+    ShowMessages("\t\te.g : !records c:\\users\\sina\\desktop\\hits.bin\n");
+
+    ShowMessages("\n");
+    ShowMessages("the records are taken from the buffers of all cores (each record is shown or saved once), "
+                 "if the file path is specified, the records are appended to the file in their binary format "
+                 "(DEBUGGER_EVENT_HIT_RECORD), the records that are not taken before the buffer of a core is "
+                 "full are dropped\n");
+    ShowMessages("e.g., '!epthook nt!ExAllocatePoolWithTag record rcx,rdx,[rsp+28]' records the tag, "
+                 "the core, the process, the thread, RIP and the values on each hit\n");
+}
+
+/**
+ * @brief Show a record of the hits
+ *
+ * @param Record
+ *
+ * @return VOID
+ */
+VOID
+CommandRecordsShowRecord(PDEBUGGER_EVENT_HIT_RECORD Record)
+{
+    ShowMessages("%016llx %llx core: %x, pid: %x, tid: %x, rip: %016llx",
+                 Record->Tsc,
+                 Record->Tag - DebuggerEventTagStartSeed,
+                 Record->CoreId,
+                 Record->ProcessId,
+                 Record->ThreadId,
+                 Record->Rip);
+
+    for (UINT32 i = 0; i < EventRecordMaximumValues; i++)
+    {
+        if (Record->ValidValues & (1 << i))
+        {
+            ShowMessages(" %llx", Record->Values[i]);
+        }
+        else if (Record->ValidValues >> i)
+        {
+            //
+            // The memory of the value is not accessible
+            //
+            ShowMessages(" ?");
+        }
+    }
+
+    ShowMessages("\n");
+}
+
+/**
+ * @brief !records command handler
+ *
+ * @param SplittedCommand
+ * @param Command
+ * @return VOID
+ */
+VOID
+CommandRecords(vector<string> & SplittedCommand, string & Command)
+{
+    BOOL                          Status;
+    ULONG                         ReturnedLength;
+    DWORD                         WrittenBytes;
+    HANDLE                        FileHandle     = INVALID_HANDLE_VALUE;
+    UINT64                        CountOfRecords = 0;
+    UINT64                        DroppedRecords = 0;
+    PDEBUGGER_QUERY_EVENT_RECORDS RecordsRequest;
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, recording the hits is only supported in the VMI Mode\n");
+        return;
+    }
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+
+    if (SplittedCommand.size() != 1)
+    {
+        //
+        // Trim the command and remove the '!records'
+        //
+        Trim(Command);
+        Command.erase(0, 8);
+        Trim(Command);
+
+        FileHandle = CreateFileA(Command.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+        if (FileHandle == INVALID_HANDLE_VALUE)
+        {
+            ShowMessages("err, unable to open the file (%x)\n", GetLastError());
+            return;
+        }
+    }
+
+    RecordsRequest = (PDEBUGGER_QUERY_EVENT_RECORDS)malloc(SIZEOF_DEBUGGER_QUERY_EVENT_RECORDS);
+
+    if (RecordsRequest == NULL)
+    {
+        if (FileHandle != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(FileHandle);
+        }
+
+        return;
+    }
+
+    //
+    // Take the records until the buffers of the cores are empty
+    //
+    do
+    {
+        RtlZeroMemory(RecordsRequest, SIZEOF_DEBUGGER_QUERY_EVENT_RECORDS);
+
+        Status = DeviceIoControl(
+            g_DeviceHandle,                      // Handle to device
+            IOCTL_QUERY_EVENT_RECORDS,           // IO Control code
+            RecordsRequest,                      // Input Buffer to driver.
+            SIZEOF_DEBUGGER_QUERY_EVENT_RECORDS, // Input buffer length
+            RecordsRequest,                      // Output Buffer from driver.
+            SIZEOF_DEBUGGER_QUERY_EVENT_RECORDS, // Length of output buffer in
+                                                 // bytes.
+            &ReturnedLength,                     // Bytes placed in buffer.
+            NULL                                 // synchronous call
+        );
+
+        if (!Status)
+        {
+            ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+            break;
+        }
+
+        if (RecordsRequest->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+        {
+            ShowErrorMessage(RecordsRequest->KernelStatus);
+            break;
+        }
+
+        //
+        // The records are taken core by core, the time-stamp counters are
+        // synchronized between the cores, so the records are merged into a
+        // single timeline
+        //
+        std::stable_sort(RecordsRequest->Records,
+                         RecordsRequest->Records + RecordsRequest->CountOfRecords,
+                         [](const DEBUGGER_EVENT_HIT_RECORD & A, const DEBUGGER_EVENT_HIT_RECORD & B) {
+                             return A.Tsc < B.Tsc;
+                         });
+
+        if (FileHandle != INVALID_HANDLE_VALUE)
+        {
+            WriteFile(FileHandle,
+                      RecordsRequest->Records,
+                      RecordsRequest->CountOfRecords * sizeof(DEBUGGER_EVENT_HIT_RECORD),
+                      &WrittenBytes,
+                      NULL);
+        }
+        else
+        {
+            for (UINT32 i = 0; i < RecordsRequest->CountOfRecords; i++)
+            {
+                CommandRecordsShowRecord(&RecordsRequest->Records[i]);
+            }
+        }
+
+        CountOfRecords += RecordsRequest->CountOfRecords;
+        DroppedRecords += RecordsRequest->DroppedRecords;
+
+    } while (RecordsRequest->CountOfRecords == MaximumEventRecordsToQuery);
+
+    ShowMessages("%llx record(s) are taken, %llx record(s) are dropped\n", CountOfRecords, DroppedRecords);
+
+    if (FileHandle != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(FileHandle);
+    }
+
+    free(RecordsRequest);
+}
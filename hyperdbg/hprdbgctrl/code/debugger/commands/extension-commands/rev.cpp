@@ -22,8 +22,13 @@ CommandRevHelp()
     ShowMessages("!rev : uses the reversing machine module in order to reconstruct the programmer/memory assumptions.\n\n");
 
     ShowMessages("syntax : \t!rev [config] [Path (string)]\n");
+    ShowMessages("syntax : \t!rev [coverage] [pid ProcessId (hex)] [bb]\n");
+    ShowMessages("syntax : \t!rev [coverage] [save] [Path (string)]\n");
     ShowMessages("\n");
     ShowMessages("\t\te.g : !rev pattern c:\\users\\sina\\reverse eng\\config.json\n");
+    ShowMessages("\t\te.g : !rev coverage pid 1c0\n");
+    ShowMessages("\t\te.g : !rev coverage pid 1c0 bb\n");
+    ShowMessages("\t\te.g : !rev coverage save c:\\users\\sina\\coverage.log\n");
 }
 
 /**
@@ -34,7 +39,7 @@ CommandRevHelp()
  * @return VOID
  */
 VOID
-CommandRev(vector<string> SplittedCommand, string Command)
+CommandRev(vector<string> & SplittedCommand, string & Command)
 {
     REVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST RevRequest = {0};
 
@@ -43,6 +48,8 @@ CommandRev(vector<string> SplittedCommand, string Command)
     UINT64  TargetPid = 0;
     BOOLEAN NextIsPid = FALSE;
 
+    UINT32 TargetProcessId = 0;
+
     UINT32  TargetSize = 0;
     BOOLEAN NextIsSize = FALSE;
 
@@ -53,6 +60,47 @@ CommandRev(vector<string> SplittedCommand, string Command)
     REVERSING_MACHINE_RECONSTRUCT_MEMORY_TYPE Type = REVERSING_MACHINE_RECONSTRUCT_MEMORY_TYPE_UNKNOWN;
     REVERSING_MACHINE_RECONSTRUCT_MEMORY_FORM Form = REVERSING_MACHINE_RECONSTRUCT_MEMORY_FORM_UNKNOWN;
 
+    //
+    // Check for the coverage of the reversing machine
+    //
+    if (SplittedCommand.size() >= 2 && !SplittedCommand.at(1).compare("coverage"))
+    {
+        if (SplittedCommand.size() >= 4 && !SplittedCommand.at(2).compare("save"))
+        {
+            //
+            // Remove '!rev coverage save' from the command, the path
+            // might contain spaces
+            //
+            Trim(Command);
+            Command.erase(0, SplittedCommand.at(0).size());
+            Trim(Command);
+            Command.erase(0, SplittedCommand.at(1).size());
+            Trim(Command);
+            Command.erase(0, SplittedCommand.at(2).size());
+            Trim(Command);
+
+            RevSaveCoverage(Command);
+            return;
+        }
+
+        if ((SplittedCommand.size() != 4 && SplittedCommand.size() != 5) ||
+            SplittedCommand.at(2).compare("pid") ||
+            !ConvertStringToUInt32(SplittedCommand.at(3), &TargetProcessId) ||
+            (SplittedCommand.size() == 5 && SplittedCommand.at(4).compare("bb")))
+        {
+            ShowMessages("incorrect use of the '%s'\n\n",
+                         SplittedCommand.at(0).c_str());
+            CommandRevHelp();
+            return;
+        }
+
+        RevRequest.ProcessId = TargetProcessId;
+        RevRequest.Mode      = REVERSING_MACHINE_RECONSTRUCT_MEMORY_MODE_USER_MODE;
+        RevRequest.Type      = REVERSING_MACHINE_RECONSTRUCT_MEMORY_TYPE_COVERAGE;
+        RevRequest.Form      = SplittedCommand.size() == 5 ? REVERSING_MACHINE_RECONSTRUCT_MEMORY_FORM_BASIC_BLOCK_COVERAGE
+                                                           : REVERSING_MACHINE_RECONSTRUCT_MEMORY_FORM_PAGE_COVERAGE;
+    }
+
     //
     // Send the request to the hypervisor (kernel)
     //
@@ -1,7 +1,7 @@
 /**
  * @file syscall-sysret.cpp
  * @author Sina Karvandi (sina@hyperdbg.org)
- * @brief !syscall and !sysret commands
+ * @brief !syscall, !syscall2, !syscall3 and !sysret, !sysret2 commands
  * @details
  * @version 0.1
  * @date 2020-05-27
@@ -23,11 +23,16 @@ CommandSyscallHelp()
                  "instructions (by accessing memory and checking for instructions).\n\n");
     ShowMessages("!syscall2 : monitors and hooks all execution of syscall "
                  "instructions (by emulating all #UDs).\n\n");
+    ShowMessages("!syscall3 : monitors and hooks all execution of syscall "
+                 "instructions (by a hidden hook on the entry of system calls).\n\n");
 
-    ShowMessages("syntax : \t!syscall [SyscallNumber (hex)] [pid ProcessId (hex)] "
+    ShowMessages("syntax : \t!syscall [SyscallNumber (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] "
                  "[core CoreId (hex)] [imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
-    ShowMessages("syntax : \t!syscall2 [SyscallNumber (hex)] [pid ProcessId (hex)] "
+    ShowMessages("syntax : \t!syscall2 [SyscallNumber (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] "
+                 "[core CoreId (hex)] [imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
+                 "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
+    ShowMessages("syntax : \t!syscall3 [SyscallNumber (hex)] [pid ProcessId (hex)] [tid ThreadId (hex)] "
                  "[core CoreId (hex)] [imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
 
@@ -39,6 +44,21 @@ CommandSyscallHelp()
     ShowMessages("\t\te.g : !syscall 0x55 pid 400\n");
     ShowMessages("\t\te.g : !syscall 0x55 core 2 pid 400\n");
     ShowMessages("\t\te.g : !syscall2 0x55 core 2 pid 400\n");
+    ShowMessages("\t\te.g : !syscall3 0x55 pid 400\n");
+    ShowMessages("\t\te.g : !syscall ratelimit 1000\n");
+    ShowMessages("\t\te.g : !syscall 0x55 lbr 10\n");
+    ShowMessages("\t\te.g : !syscall budget 1000 script { printf(\"%%llx\\n\", @rax); }\n");
+
+    ShowMessages("\n");
+    ShowMessages("the 'ratelimit' (hex) limits the triggers of the event per second on each core, "
+                 "the extra triggers are dropped until the budget is refilled\n");
+    ShowMessages("the 'lbr' (hex) shows the last branch records of the core (up to 20 branches) "
+                 "each time that the event is triggered\n");
+    ShowMessages("the 'budget' (hex) limits the instructions of each run of the script of the event, "
+                 "the script is aborted once it exceeds the budget\n");
+    ShowMessages("the '!syscall3' intercepts the system calls at the entry of system calls (LSTAR), "
+                 "there is a single vm-exit for each system call (without #UDs), "
+                 "short-circuiting returns to the caller without performing the system call\n");
 }
 
 /**
@@ -54,7 +74,7 @@ CommandSysretHelp()
     ShowMessages("!sysret2 : monitors and hooks all execution of sysret "
                  "instructions (by emulating all #UDs).\n\n");
 
-    ShowMessages("syntax : \t!sysret [pid ProcessId (hex)] [core CoreId (hex)] "
+    ShowMessages("syntax : \t!sysret [pid ProcessId (hex)] [tid ThreadId (hex)] [core CoreId (hex)] "
                  "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
 
@@ -68,14 +88,14 @@ CommandSysretHelp()
 }
 
 /**
- * @brief !syscall, !syscall2 and !sysret, !sysret2 commands handler
+ * @brief !syscall, !syscall2, !syscall3 and !sysret, !sysret2 commands handler
  *
  * @param SplittedCommand
  * @param Command
  * @return VOID
  */
 VOID
-CommandSyscallAndSysret(vector<string> SplittedCommand, string Command)
+CommandSyscallAndSysret(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
@@ -96,7 +116,7 @@ CommandSyscallAndSysret(vector<string> SplittedCommand, string Command)
     //
     //
     Cmd = SplittedCommand.at(0);
-    if (!Cmd.compare("!syscall") || !Cmd.compare("!syscall2"))
+    if (!Cmd.compare("!syscall") || !Cmd.compare("!syscall2") || !Cmd.compare("!syscall3"))
     {
         if (!InterpretGeneralEventAndActionsFields(
                 &SplittedCommand,
@@ -145,12 +165,13 @@ CommandSyscallAndSysret(vector<string> SplittedCommand, string Command)
     // and we don't wanna deal with dynamic mapping of rcx (user stack)
     // in vmx-root
     //
-    if (!Cmd.compare("!syscall") || !Cmd.compare("!syscall2"))
+    if (!Cmd.compare("!syscall") || !Cmd.compare("!syscall2") || !Cmd.compare("!syscall3"))
     {
         for (auto Section : SplittedCommand)
         {
             if (!Section.compare("!syscall") ||
                 !Section.compare("!syscall2") ||
+                !Section.compare("!syscall3") ||
                 !Section.compare("!sysret") ||
                 !Section.compare("!sysret2"))
             {
@@ -169,7 +190,7 @@ CommandSyscallAndSysret(vector<string> SplittedCommand, string Command)
                     //
                     ShowMessages("unknown parameter '%s'\n\n", Section.c_str());
 
-                    if (!Cmd.compare("!syscall") || !Cmd.compare("!syscall2"))
+                    if (!Cmd.compare("!syscall") || !Cmd.compare("!syscall2") || !Cmd.compare("!syscall3"))
                     {
                         CommandSyscallHelp();
                     }
@@ -193,7 +214,7 @@ CommandSyscallAndSysret(vector<string> SplittedCommand, string Command)
                 //
                 ShowMessages("unknown parameter '%s'\n\n", Section.c_str());
 
-                if (!Cmd.compare("!syscall") || !Cmd.compare("!syscall2"))
+                if (!Cmd.compare("!syscall") || !Cmd.compare("!syscall2") || !Cmd.compare("!syscall3"))
                 {
                     CommandSyscallHelp();
                 }
@@ -214,7 +235,7 @@ CommandSyscallAndSysret(vector<string> SplittedCommand, string Command)
     }
 
     //
-    // Set whether it's !syscall or !syscall2 or !sysret or !sysret2
+    // Set whether it's !syscall or !syscall2 or !syscall3 or !sysret or !sysret2
     //
     if (!Cmd.compare("!syscall2") || !Cmd.compare("!sysret2"))
     {
@@ -223,6 +244,13 @@ CommandSyscallAndSysret(vector<string> SplittedCommand, string Command)
         //
         Event->OptionalParam2 = DEBUGGER_EVENT_SYSCALL_SYSRET_HANDLE_ALL_UD;
     }
+    else if (!Cmd.compare("!syscall3"))
+    {
+        //
+        // It's a !syscall3
+        //
+        Event->OptionalParam2 = DEBUGGER_EVENT_SYSCALL_SYSRET_LSTAR_ENTRY_HOOK;
+    }
     else
     {
         //
@@ -21,7 +21,7 @@ CommandTscHelp()
 {
     ShowMessages("!tsc : monitors execution of rdtsc/rdtscp instructions.\n\n");
 
-    ShowMessages("syntax : \t!tsc [pid ProcessId (hex)] [core CoreId (hex)] "
+    ShowMessages("syntax : \t!tsc [pid ProcessId (hex)] [tid ThreadId (hex)] [core CoreId (hex)] "
                  "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [condition { Condition (hex) }] "
                  "[code { Code (hex) }]\n");
@@ -40,7 +40,7 @@ CommandTscHelp()
  * @return VOID
  */
 VOID
-CommandTsc(vector<string> SplittedCommand, string Command)
+CommandTsc(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
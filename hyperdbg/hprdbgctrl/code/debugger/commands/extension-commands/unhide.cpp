@@ -35,7 +35,7 @@ CommandUnhideHelp()
  * @return VOID
  */
 VOID
-CommandUnhide(vector<string> SplittedCommand, string Command)
+CommandUnhide(vector<string> & SplittedCommand, string & Command)
 {
     BOOLEAN                                     Status;
     ULONG                                       ReturnedLength;
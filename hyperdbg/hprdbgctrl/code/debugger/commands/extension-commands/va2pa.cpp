@@ -46,7 +46,7 @@ CommandVa2paHelp()
  * @return VOID
  */
 VOID
-CommandVa2pa(vector<string> SplittedCommand, string Command)
+CommandVa2pa(vector<string> & SplittedCommand, string & Command)
 {
     BOOL                              Status;
     ULONG                             ReturnedLength;
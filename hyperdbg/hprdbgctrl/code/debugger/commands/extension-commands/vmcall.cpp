@@ -21,7 +21,7 @@ CommandVmcallHelp()
 {
     ShowMessages("!vmcall : monitors execution of VMCALL instruction.\n\n");
 
-    ShowMessages("syntax : \t!vmcall [pid ProcessId (hex)] [core CoreId (hex)] "
+    ShowMessages("syntax : \t!vmcall [pid ProcessId (hex)] [tid ThreadId (hex)] [core CoreId (hex)] "
                  "[imm IsImmediate (yesno)] [sc EnableShortCircuiting (onoff)] [buffer PreAllocatedBuffer (hex)] "
                  "[script { Script (string) }] [condition { Condition (hex) }] [code { Code (hex) }]\n");
 
@@ -39,7 +39,7 @@ CommandVmcallHelp()
  * @return VOID
  */
 VOID
-CommandVmcall(vector<string> SplittedCommand, string Command)
+CommandVmcall(vector<string> & SplittedCommand, string & Command)
 {
     PDEBUGGER_GENERAL_EVENT_DETAIL     Event                 = NULL;
     PDEBUGGER_GENERAL_ACTION           ActionBreakToDebugger = NULL;
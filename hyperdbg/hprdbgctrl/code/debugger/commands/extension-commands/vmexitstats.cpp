@@ -0,0 +1,389 @@
+/**
+ * @file vmexitstats.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief !vmexitstats command
+ * @details
+ * @version 0.4
+ * @date 2023-07-28
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+extern HANDLE  g_DeviceHandle;
+
+/**
+ * @brief Names of the basic exit reasons
+ *
+ */
+static const char * VmexitStatisticsReasonNames[MaximumVmexitStatisticsExitReasons] = {
+    "exception or nmi",
+    "external interrupt",
+    "triple fault",
+    "init signal",
+    "startup ipi",
+    "io smi",
+    "smi",
+    "interrupt window",
+    "nmi window",
+    "task switch",
+    "cpuid",
+    "getsec",
+    "hlt",
+    "invd",
+    "invlpg",
+    "rdpmc",
+    "rdtsc",
+    "rsm",
+    "vmcall",
+    "vmclear",
+    "vmlaunch",
+    "vmptrld",
+    "vmptrst",
+    "vmread",
+    "vmresume",
+    "vmwrite",
+    "vmxoff",
+    "vmxon",
+    "mov cr",
+    "mov dr",
+    "io instruction",
+    "rdmsr",
+    "wrmsr",
+    "invalid guest state",
+    "msr loading",
+    "reserved",
+    "mwait",
+    "monitor trap flag",
+    "reserved",
+    "monitor",
+    "pause",
+    "machine check",
+    "reserved",
+    "tpr below threshold",
+    "apic access",
+    "virtualized eoi",
+    "gdtr idtr access",
+    "ldtr tr access",
+    "ept violation",
+    "ept misconfiguration",
+    "invept",
+    "rdtscp",
+    "preemption timer",
+    "invvpid",
+    "wbinvd",
+    "xsetbv",
+    "apic write",
+    "rdrand",
+    "invpcid",
+    "vmfunc",
+    "encls",
+    "rdseed",
+    "pml full",
+    "xsaves",
+    "xrstors",
+    "pconfig",
+    "spp event",
+    "umwait",
+    "tpause",
+    "loadiwkey",
+};
+
+/**
+ * @brief Get the name of a basic exit reason
+ *
+ * @param Reason
+ *
+ * @return const char *
+ */
+const char *
+CommandVmexitStatsGetReasonName(UINT32 Reason)
+{
+    return Reason < MaximumVmexitStatisticsExitReasons ? VmexitStatisticsReasonNames[Reason] : "unknown";
+}
+
+/**
+ * @brief help of !vmexitstats command
+ *
+ * @return VOID
+ */
+VOID
+CommandVmexitStatsHelp()
+{
+    ShowMessages("!vmexitstats : shows the count and the cycles of handling each exit reason.\n\n");
+
+    ShowMessages("syntax : \t!vmexitstats [core CoreId (hex)]\n");
+    ShowMessages("syntax : \t!vmexitstats [reason ExitReason (hex)] [core CoreId (hex)]\n");
+    ShowMessages("syntax : \t!vmexitstats [enable | disable | reset]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : !vmexitstats enable\n");
+    ShowMessages("\t\te.g : !vmexitstats\n");
+    ShowMessages("\t\te.g : !vmexitstats core 2\n");
+    ShowMessages("\t\te.g : !vmexitstats reason 30\n");
+    ShowMessages("\t\te.g : !vmexitstats reset\n");
+    ShowMessages("\t\te.g : !vmexitstats disable\n");
+
+    ShowMessages("\n");
+    ShowMessages("the statistics are not gathered unless they are enabled, the 'reason' "
+                 "shows the log2 histogram of the cycles of a single exit reason\n");
+}
+
+/**
+ * @brief Send the request of the statistics of vm-exits to the driver
+ *
+ * @param StatisticsRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandVmexitStatsSendRequest(PDEBUGGER_VMEXIT_STATISTICS_REQUEST StatisticsRequest)
+{
+    BOOL  Status;
+    ULONG ReturnedLength;
+
+    Status = DeviceIoControl(
+        g_DeviceHandle,                            // Handle to device
+        IOCTL_VMEXIT_STATISTICS,                   // IO Control code
+        StatisticsRequest,                         // Input Buffer to driver.
+        SIZEOF_DEBUGGER_VMEXIT_STATISTICS_REQUEST, // Input buffer length
+        StatisticsRequest,                         // Output Buffer from driver.
+        SIZEOF_DEBUGGER_VMEXIT_STATISTICS_REQUEST, // Length of output buffer in
+                                                   // bytes.
+        &ReturnedLength,                           // Bytes placed in buffer.
+        NULL                                       // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        return FALSE;
+    }
+
+    if (StatisticsRequest->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(StatisticsRequest->KernelStatus);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Show the statistics of all exit reasons (the most expensive first)
+ *
+ * @param StatisticsRequest
+ *
+ * @return VOID
+ */
+VOID
+CommandVmexitStatsShowReasons(PDEBUGGER_VMEXIT_STATISTICS_REQUEST StatisticsRequest)
+{
+    vector<UINT32> Reasons;
+
+    for (UINT32 i = 0; i < MaximumVmexitStatisticsExitReasons; i++)
+    {
+        if (StatisticsRequest->Reasons[i].Count != 0)
+        {
+            Reasons.push_back(i);
+        }
+    }
+
+    if (Reasons.empty())
+    {
+        ShowMessages("no vm-exit is recorded\n");
+        return;
+    }
+
+    sort(Reasons.begin(), Reasons.end(), [StatisticsRequest](UINT32 A, UINT32 B) {
+        return StatisticsRequest->Reasons[A].TotalCycles > StatisticsRequest->Reasons[B].TotalCycles;
+    });
+
+    ShowMessages("reason                      count             total cycles      average cycles    maximum cycles\n");
+
+    for (auto Reason : Reasons)
+    {
+        PVMEXIT_REASON_STATISTICS Statistics = &StatisticsRequest->Reasons[Reason];
+
+        ShowMessages("%02x %-24s %-17llx %-17llx %-17llx %llx\n",
+                     Reason,
+                     VmexitStatisticsReasonNames[Reason],
+                     Statistics->Count,
+                     Statistics->TotalCycles,
+                     Statistics->TotalCycles / Statistics->Count,
+                     Statistics->MaximumCycles);
+    }
+}
+
+/**
+ * @brief Show the histogram of the cycles of a single exit reason
+ *
+ * @param StatisticsRequest
+ * @param Reason
+ *
+ * @return VOID
+ */
+VOID
+CommandVmexitStatsShowHistogram(PDEBUGGER_VMEXIT_STATISTICS_REQUEST StatisticsRequest, UINT32 Reason)
+{
+    PVMEXIT_REASON_STATISTICS Statistics = &StatisticsRequest->Reasons[Reason];
+
+    ShowMessages("reason : %x (%s)\n", Reason, VmexitStatisticsReasonNames[Reason]);
+
+    if (Statistics->Count == 0)
+    {
+        ShowMessages("no vm-exit is recorded\n");
+        return;
+    }
+
+    ShowMessages("count : %llx, average cycles : %llx, maximum cycles : %llx\n\n",
+                 Statistics->Count,
+                 Statistics->TotalCycles / Statistics->Count,
+                 Statistics->MaximumCycles);
+
+    ShowMessages("cycles                               count\n");
+
+    for (UINT32 i = 0; i < VmexitStatisticsHistogramBuckets; i++)
+    {
+        if (Statistics->Histogram[i] == 0)
+        {
+            continue;
+        }
+
+        if (i == VmexitStatisticsHistogramBuckets - 1)
+        {
+            ShowMessages(">= %-32llx %llx\n", 1ull << i, Statistics->Histogram[i]);
+        }
+        else
+        {
+            ShowMessages("%-16llx - %-16llx %llx\n", i == 0 ? 0 : 1ull << i, (1ull << (i + 1)) - 1, Statistics->Histogram[i]);
+        }
+    }
+}
+
+/**
+ * @brief !vmexitstats command handler
+ *
+ * @param SplittedCommand
+ * @param Command
+ * @return VOID
+ */
+VOID
+CommandVmexitStats(vector<string> & SplittedCommand, string & Command)
+{
+    PDEBUGGER_VMEXIT_STATISTICS_REQUEST StatisticsRequest;
+    DEBUGGER_VMEXIT_STATISTICS_ACTION   Action     = DEBUGGER_VMEXIT_STATISTICS_ACTION_QUERY;
+    UINT32                              CoreId     = DEBUGGER_VMEXIT_STATISTICS_ALL_CORES;
+    UINT32                              Reason     = 0;
+    BOOLEAN                             ShowReason = FALSE;
+
+    if (SplittedCommand.size() == 2 && !SplittedCommand.at(1).compare("enable"))
+    {
+        Action = DEBUGGER_VMEXIT_STATISTICS_ACTION_ENABLE;
+    }
+    else if (SplittedCommand.size() == 2 && !SplittedCommand.at(1).compare("disable"))
+    {
+        Action = DEBUGGER_VMEXIT_STATISTICS_ACTION_DISABLE;
+    }
+    else if (SplittedCommand.size() == 2 && !SplittedCommand.at(1).compare("reset"))
+    {
+        Action = DEBUGGER_VMEXIT_STATISTICS_ACTION_RESET;
+    }
+    else
+    {
+        for (size_t i = 1; i < SplittedCommand.size(); i += 2)
+        {
+            if (i + 1 >= SplittedCommand.size())
+            {
+                ShowMessages("incorrect use of '!vmexitstats'\n\n");
+                CommandVmexitStatsHelp();
+                return;
+            }
+
+            if (!SplittedCommand.at(i).compare("core") && ConvertStringToUInt32(SplittedCommand.at(i + 1), &CoreId))
+            {
+                continue;
+            }
+
+            if (!SplittedCommand.at(i).compare("reason") && ConvertStringToUInt32(SplittedCommand.at(i + 1), &Reason) &&
+                Reason < MaximumVmexitStatisticsExitReasons)
+            {
+                ShowReason = TRUE;
+                continue;
+            }
+
+            ShowMessages("err, couldn't resolve error at '%s'\n\n", SplittedCommand.at(i).c_str());
+            CommandVmexitStatsHelp();
+            return;
+        }
+    }
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, the statistics of vm-exits are not supported in the debugger mode\n");
+        return;
+    }
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+
+    StatisticsRequest = (PDEBUGGER_VMEXIT_STATISTICS_REQUEST)malloc(SIZEOF_DEBUGGER_VMEXIT_STATISTICS_REQUEST);
+
+    if (StatisticsRequest == NULL)
+    {
+        return;
+    }
+
+    RtlZeroMemory(StatisticsRequest, SIZEOF_DEBUGGER_VMEXIT_STATISTICS_REQUEST);
+
+    StatisticsRequest->Action = Action;
+    StatisticsRequest->CoreId = CoreId;
+
+    if (!CommandVmexitStatsSendRequest(StatisticsRequest))
+    {
+        free(StatisticsRequest);
+        return;
+    }
+
+    switch (Action)
+    {
+    case DEBUGGER_VMEXIT_STATISTICS_ACTION_ENABLE:
+
+        ShowMessages("the statistics of vm-exits are enabled\n");
+        break;
+
+    case DEBUGGER_VMEXIT_STATISTICS_ACTION_DISABLE:
+
+        ShowMessages("the statistics of vm-exits are disabled\n");
+        break;
+
+    case DEBUGGER_VMEXIT_STATISTICS_ACTION_RESET:
+
+        ShowMessages("the statistics of vm-exits are reset\n");
+        break;
+
+    default:
+
+        if (!StatisticsRequest->IsEnabled)
+        {
+            ShowMessages("the statistics of vm-exits are not gathered, use '!vmexitstats enable' to enable them\n\n");
+        }
+
+        if (ShowReason)
+        {
+            CommandVmexitStatsShowHistogram(StatisticsRequest, Reason);
+        }
+        else
+        {
+            CommandVmexitStatsShowReasons(StatisticsRequest);
+        }
+
+        break;
+    }
+
+    free(StatisticsRequest);
+}
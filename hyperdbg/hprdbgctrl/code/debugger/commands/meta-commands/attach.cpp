@@ -41,7 +41,7 @@ CommandAttachHelp()
  * @return VOID
  */
 VOID
-CommandAttach(vector<string> SplittedCommand, string Command)
+CommandAttach(vector<string> & SplittedCommand, string & Command)
 {
     UINT64  TargetPid = 0;
     BOOLEAN NextIsPid = FALSE;
@@ -32,7 +32,7 @@ CommandClearScreenHelp()
  * @return VOID
  */
 VOID
-CommandClearScreen(vector<string> SplittedCommand, string Command)
+CommandClearScreen(vector<string> & SplittedCommand, string & Command)
 {
     system("cls");
 }
@@ -19,8 +19,6 @@ extern BOOLEAN g_IsConnectedToRemoteDebuggee;
 extern BOOLEAN g_IsConnectedToRemoteDebugger;
 extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
 extern BOOLEAN g_IsSerialConnectedToRemoteDebugger;
-extern string  g_ServerPort;
-extern string  g_ServerIp;
 
 /**
  * @brief help of .connect command
@@ -39,6 +37,10 @@ CommandConnectHelp()
     ShowMessages("\n");
     ShowMessages("\t\te.g : .connect local\n");
     ShowMessages("\t\te.g : .connect 192.168.1.5 50000\n");
+
+    ShowMessages("\n");
+    ShowMessages("connecting to another remote machine while the debugger is connected "
+                 "to a remote machine adds a new session (see '.session')\n");
 }
 
 /**
@@ -49,13 +51,13 @@ CommandConnectHelp()
  * @return VOID
  */
 VOID
-CommandConnect(vector<string> SplittedCommand, string Command)
+CommandConnect(vector<string> & SplittedCommand, string & Command)
 {
     string ip;
     string port;
 
-    if (g_IsConnectedToHyperDbgLocally || g_IsConnectedToRemoteDebuggee ||
-        g_IsConnectedToRemoteDebugger)
+    if (g_IsConnectedToHyperDbgLocally || g_IsConnectedToRemoteDebugger ||
+        (g_IsConnectedToRemoteDebuggee && (SplittedCommand.size() == 1 || SplittedCommand.at(1) == "local")))
     {
         ShowMessages("you're connected to a debugger, please use '.disconnect' "
                      "command\n");
@@ -120,8 +122,6 @@ CommandConnect(vector<string> SplittedCommand, string Command)
             //
             // connect to remote debugger
             //
-            g_ServerIp   = ip;
-            g_ServerPort = port;
             RemoteConnectionConnect(ip.c_str(), port.c_str());
         }
         else
@@ -129,8 +129,6 @@ CommandConnect(vector<string> SplittedCommand, string Command)
             //
             // connect to remote debugger (default port)
             //
-            g_ServerIp   = ip;
-            g_ServerPort = DEFAULT_PORT;
             RemoteConnectionConnect(ip.c_str(), DEFAULT_PORT);
         }
     }
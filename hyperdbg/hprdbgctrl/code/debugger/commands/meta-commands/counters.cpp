@@ -0,0 +1,121 @@
+/**
+ * @file counters.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief .counters command
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+extern HANDLE  g_DeviceHandle;
+
+/**
+ * @brief help of .counters command
+ *
+ * @return VOID
+ */
+VOID
+CommandCountersHelp()
+{
+    ShowMessages(".counters : exports the counters of the debugger and the hypervisor as an ETW provider.\n\n");
+
+    ShowMessages("syntax : \t.counters [start] [interval Milliseconds (hex)]\n");
+    ShowMessages("syntax : \t.counters [stop]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : .counters\n");
+    ShowMessages("\t\te.g : .counters start\n");
+    ShowMessages("\t\te.g : .counters start interval 1f4\n");
+    ShowMessages("\t\te.g : .counters stop\n");
+
+    ShowMessages("\n");
+    ShowMessages("the counters are published by the 'HyperDbg.Counters' provider "
+                 "{d05aaf0c-8611-5ece-8c25-aabed92aa38e}, each group is only queried if an ETW "
+                 "session enables its keyword:\n");
+    ShowMessages("\t0x1  : vm-exits by the exit reason (while '!vmexitstats' is enabled)\n");
+    ShowMessages("\t0x2  : hits of the events\n");
+    ShowMessages("\t0x4  : dropped and discarded messages of the message buffers\n");
+    ShowMessages("\t0x8  : pools and nonpaged memory usage\n");
+    ShowMessages("\t0x10 : bytes that are transferred over the connections\n");
+    ShowMessages("the counters are cumulative, the default interval is %x milliseconds\n",
+                 COUNTERS_EXPORT_DEFAULT_INTERVAL);
+}
+
+/**
+ * @brief .counters command handler
+ *
+ * @param SplittedCommand
+ * @param Command
+ * @return VOID
+ */
+VOID
+CommandCounters(vector<string> & SplittedCommand, string & Command)
+{
+    UINT32 Interval = COUNTERS_EXPORT_DEFAULT_INTERVAL;
+
+    if (SplittedCommand.size() == 1)
+    {
+        CountersExportShowStatus();
+        return;
+    }
+
+    if (!SplittedCommand.at(1).compare("stop"))
+    {
+        if (SplittedCommand.size() != 2)
+        {
+            ShowMessages("incorrect use of the '.counters'\n\n");
+            CommandCountersHelp();
+            return;
+        }
+
+        CountersExportStop();
+        ShowMessages("the counters are not exported anymore\n");
+        return;
+    }
+
+    if (SplittedCommand.at(1).compare("start"))
+    {
+        ShowMessages("err, couldn't resolve error at '%s'\n\n", SplittedCommand.at(1).c_str());
+        CommandCountersHelp();
+        return;
+    }
+
+    if (SplittedCommand.size() == 4 && !SplittedCommand.at(2).compare("interval"))
+    {
+        if (!ConvertStringToUInt32(SplittedCommand.at(3), &Interval) || Interval < COUNTERS_EXPORT_MINIMUM_INTERVAL)
+        {
+            ShowMessages("err, the interval should be at least %x milliseconds\n", COUNTERS_EXPORT_MINIMUM_INTERVAL);
+            return;
+        }
+    }
+    else if (SplittedCommand.size() != 2)
+    {
+        ShowMessages("incorrect use of the '.counters'\n\n");
+        CommandCountersHelp();
+        return;
+    }
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, exporting the counters is not supported in the debugger mode\n");
+        return;
+    }
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+
+    if (!CountersExportStart(Interval))
+    {
+        ShowMessages("err, unable to start exporting the counters (%x)\n", GetLastError());
+        return;
+    }
+
+    ShowMessages("the counters are exported every %x milliseconds\n", Interval);
+}
@@ -32,22 +32,39 @@ CommandDebugHelp()
         ".debug : debugs a target machine or makes this machine a debuggee.\n\n");
 
     ShowMessages(
-        "syntax : \t.debug [remote] [serial|namedpipe] [Baudrate (decimal)] [Address (string)]\n");
+        "syntax : \t.debug [remote] [serial|namedpipe] [Baudrate (decimal)] [Address (string)] "
+        "[bulk Address (string)]\n");
     ShowMessages(
-        "syntax : \t.debug [prepare] [serial] [Baudrate (decimal)] [Address (string)]\n");
+        "syntax : \t.debug [remote] [net] [DebuggeeIp (string)] [Port (decimal)]\n");
+    ShowMessages(
+        "syntax : \t.debug [prepare] [serial] [Baudrate (decimal)] [Address (string)] [bulk Address (string)]\n");
+    ShowMessages(
+        "syntax : \t.debug [prepare] [net] [PciAddress (bus:device.function)] [DebuggeeIp (string)] "
+        "[DebuggerIp (string)] [Port (decimal)]\n");
     ShowMessages("syntax : \t.debug [close]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : .debug remote serial 115200 com3\n");
+    ShowMessages("\t\te.g : .debug remote serial 115200 com3 bulk com4\n");
     ShowMessages("\t\te.g : .debug remote namedpipe \\\\.\\pipe\\HyperDbgPipe\n");
+    ShowMessages("\t\te.g : .debug remote namedpipe \\\\.\\pipe\\HyperDbgPipe bulk \\\\.\\pipe\\HyperDbgBulkPipe\n");
+    ShowMessages("\t\te.g : .debug remote net 192.168.1.20 50000\n");
     ShowMessages("\t\te.g : .debug prepare serial 115200 com1\n");
     ShowMessages("\t\te.g : .debug prepare serial 115200 com2\n");
+    ShowMessages("\t\te.g : .debug prepare serial 115200 com1 bulk com2\n");
+    ShowMessages("\t\te.g : .debug prepare net 02:01.0 192.168.1.20 192.168.1.10 50000\n");
     ShowMessages("\t\te.g : .debug close\n");
 
     ShowMessages(
         "\nvalid baud rates (decimal) : 110, 300, 600, 1200, 2400, 4800, 9600, "
-        "14400, 19200, 38400, 56000, 57600, 115200, 128000, 256000\n");
+        "14400, 19200, 38400, 56000, 57600, 115200, 128000, 230400, 256000, 460800, 921600\n");
     ShowMessages("valid COM ports : COM1, COM2, COM3, COM4 \n");
+    ShowMessages("\nthe bulk link is a second port (or pipe) with the same baud rate, the debuggee "
+                 "sends the memory and the messages of the events over it, so they don't delay "
+                 "the responses of the debuggee (e.g., pausing and stepping)\n");
+    ShowMessages("\nthe network adapter of the debuggee (Intel 8254x or 82574) is used "
+                 "only by HyperDbg, so it should be a separate adapter (with no driver) "
+                 "on the same network segment as the debugger\n");
 }
 
 /**
@@ -64,7 +81,8 @@ CommandDebugCheckBaudrate(DWORD Baudrate)
         Baudrate == CBR_9600 || Baudrate == CBR_14400 || Baudrate == CBR_19200 ||
         Baudrate == CBR_38400 || Baudrate == CBR_56000 || Baudrate == CBR_57600 ||
         Baudrate == CBR_115200 || Baudrate == CBR_128000 ||
-        Baudrate == CBR_256000)
+        Baudrate == CBR_230400 || Baudrate == CBR_256000 ||
+        Baudrate == CBR_460800 || Baudrate == CBR_921600)
     {
         return TRUE;
     }
@@ -104,6 +122,88 @@ CommandDebugCheckComPort(const string & ComPort, UINT32 * Port)
     return FALSE;
 }
 
+/**
+ * @brief Check if the bulk link (a second COM port) is valid or not
+ *
+ * @param Keyword Should be 'bulk'
+ * @param ComPort The second COM port
+ * @param Port Address of the COM port of the control link
+ * @param BulkLinkDetails
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandDebugCheckBulkLink(const string &        Keyword,
+                          const string &        ComPort,
+                          UINT32                Port,
+                          PKD_BULK_LINK_DETAILS BulkLinkDetails)
+{
+    if (Keyword.compare("bulk") ||
+        !CommandDebugCheckComPort(ComPort, &BulkLinkDetails->Port) ||
+        BulkLinkDetails->Port == Port)
+    {
+        return FALSE;
+    }
+
+    BulkLinkDetails->PortName = ComPort.c_str();
+
+    return TRUE;
+}
+
+/**
+ * @brief Check if the PCI address (bus:device.function) is valid or not
+ *
+ * @param PciAddress
+ * @param Address Bus << 8 | Device << 3 | Function
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandDebugCheckPciAddress(const string & PciAddress, UINT32 * Address)
+{
+    UINT32 Bus;
+    UINT32 Device;
+    UINT32 Function;
+    CHAR   Rest;
+
+    if (sscanf_s(PciAddress.c_str(), "%x:%x.%x%c", &Bus, &Device, &Function, &Rest, 1) != 3 ||
+        Bus > 0xff || Device > 0x1f || Function > 0x7)
+    {
+        return FALSE;
+    }
+
+    *Address = (Bus << 8) | (Device << 3) | Function;
+
+    return TRUE;
+}
+
+/**
+ * @brief Check if the UDP port is valid or not
+ *
+ * @param PortString
+ * @param Port
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandDebugCheckUdpPort(const string & PortString, UINT16 * Port)
+{
+    UINT32 Value;
+
+    if (!IsNumber(PortString))
+    {
+        return FALSE;
+    }
+
+    Value = stoi(PortString);
+
+    if (Value == 0 || Value > 0xffff)
+    {
+        return FALSE;
+    }
+
+    *Port = (UINT16)Value;
+
+    return TRUE;
+}
+
 /**
  * @brief .debug command handler
  *
@@ -112,10 +212,14 @@ CommandDebugCheckComPort(const string & ComPort, UINT32 * Port)
  * @return VOID
  */
 VOID
-CommandDebug(vector<string> SplittedCommand, string Command)
+CommandDebug(vector<string> & SplittedCommand, string & Command)
 {
-    UINT32 Baudrate;
-    UINT32 Port;
+    UINT32                        Baudrate;
+    UINT32                        Port;
+    KD_NETWORK_CONNECTION_DETAILS NetworkDetails  = {0};
+    KD_BULK_LINK_DETAILS          BulkLinkDetails = {0};
+    string                        BulkPipe;
+    size_t                        BulkPosition;
 
     if (SplittedCommand.size() == 2 && !SplittedCommand.at(1).compare("close"))
     {
@@ -152,7 +256,7 @@ CommandDebug(vector<string> SplittedCommand, string Command)
             //
             // Connect to a remote serial device
             //
-            if (SplittedCommand.size() != 5)
+            if (SplittedCommand.size() != 5 && SplittedCommand.size() != 7)
             {
                 ShowMessages("incorrect use of '.debug'\n\n");
                 CommandDebugHelp();
@@ -201,10 +305,27 @@ CommandDebug(vector<string> SplittedCommand, string Command)
                 return;
             }
 
+            //
+            // check if the bulk link is valid or not (if it's specified)
+            //
+            if (SplittedCommand.size() == 7 &&
+                !CommandDebugCheckBulkLink(SplittedCommand.at(5), SplittedCommand.at(6), Port, &BulkLinkDetails))
+            {
+                ShowMessages("err, COM port of the bulk link is invalid\n\n");
+                CommandDebugHelp();
+                return;
+            }
+
             //
             // Everything is okay, connect to the remote machine to send (debugger)
             //
-            KdPrepareAndConnectDebugPort(SplittedCommand.at(4).c_str(), Baudrate, Port, FALSE, FALSE);
+            KdPrepareAndConnectDebugPort(SplittedCommand.at(4).c_str(),
+                                         Baudrate,
+                                         Port,
+                                         FALSE,
+                                         FALSE,
+                                         NULL,
+                                         SplittedCommand.size() == 7 ? &BulkLinkDetails : NULL);
         }
         else if (!SplittedCommand.at(2).compare("namedpipe"))
         {
@@ -216,10 +337,63 @@ CommandDebug(vector<string> SplittedCommand, string Command)
                 Command.find(Delimiter) + Delimiter.size() + 1,
                 Command.size());
 
+            //
+            // The second pipe of the bulk link is specified after 'bulk'
+            //
+            BulkPosition = Token.find(" bulk ");
+
+            if (BulkPosition != string::npos)
+            {
+                BulkPipe = Token.substr(BulkPosition + strlen(" bulk "));
+                Token    = Token.substr(0, BulkPosition);
+
+                Trim(BulkPipe);
+                Trim(Token);
+
+                BulkLinkDetails.PortName = BulkPipe.c_str();
+            }
+
             //
             // Connect to a namedpipe (it's probably a Virtual Machine debugging)
             //
-            KdPrepareAndConnectDebugPort(Token.c_str(), NULL, NULL, FALSE, TRUE);
+            KdPrepareAndConnectDebugPort(Token.c_str(),
+                                         NULL,
+                                         NULL,
+                                         FALSE,
+                                         TRUE,
+                                         NULL,
+                                         BulkPosition != string::npos ? &BulkLinkDetails : NULL);
+        }
+        else if (!SplittedCommand.at(2).compare("net"))
+        {
+            //
+            // Connect to a remote debuggee over the network
+            //
+            if (SplittedCommand.size() != 5)
+            {
+                ShowMessages("incorrect use of '.debug'\n\n");
+                CommandDebugHelp();
+                return;
+            }
+
+            if (inet_pton(AF_INET, SplittedCommand.at(3).c_str(), &NetworkDetails.DebuggeeIpAddress) != 1)
+            {
+                ShowMessages("err, IP address is invalid\n\n");
+                CommandDebugHelp();
+                return;
+            }
+
+            if (!CommandDebugCheckUdpPort(SplittedCommand.at(4), &NetworkDetails.UdpPort))
+            {
+                ShowMessages("err, port is invalid\n\n");
+                CommandDebugHelp();
+                return;
+            }
+
+            //
+            // Everything is okay, connect to the remote machine to send (debugger)
+            //
+            KdPrepareAndConnectDebugPort(SplittedCommand.at(3).c_str(), NULL, NULL, FALSE, FALSE, &NetworkDetails, NULL);
         }
         else
         {
@@ -233,19 +407,19 @@ CommandDebug(vector<string> SplittedCommand, string Command)
     }
     else if (!SplittedCommand.at(1).compare("prepare"))
     {
-        if (SplittedCommand.size() != 5)
-        {
-            ShowMessages("incorrect use of '.debug'\n\n");
-            CommandDebugHelp();
-            return;
-        }
-
         //
         // in the case of 'prepare'
-        // currently we only support serial
+        // we support serial and network
         //
         if (!SplittedCommand.at(2).compare("serial"))
         {
+            if (SplittedCommand.size() != 5 && SplittedCommand.size() != 7)
+            {
+                ShowMessages("incorrect use of '.debug'\n\n");
+                CommandDebugHelp();
+                return;
+            }
+
             //
             // Set baudrate
             //
@@ -288,10 +462,63 @@ CommandDebug(vector<string> SplittedCommand, string Command)
                 return;
             }
 
+            //
+            // check if the bulk link is valid or not (if it's specified)
+            //
+            if (SplittedCommand.size() == 7 &&
+                !CommandDebugCheckBulkLink(SplittedCommand.at(5), SplittedCommand.at(6), Port, &BulkLinkDetails))
+            {
+                ShowMessages("err, COM port of the bulk link is invalid\n\n");
+                CommandDebugHelp();
+                return;
+            }
+
+            //
+            // Everything is okay, prepare to send (debuggee)
+            //
+            KdPrepareAndConnectDebugPort(SplittedCommand.at(4).c_str(),
+                                         Baudrate,
+                                         Port,
+                                         TRUE,
+                                         FALSE,
+                                         NULL,
+                                         SplittedCommand.size() == 7 ? &BulkLinkDetails : NULL);
+        }
+        else if (!SplittedCommand.at(2).compare("net"))
+        {
+            if (SplittedCommand.size() != 7)
+            {
+                ShowMessages("incorrect use of '.debug'\n\n");
+                CommandDebugHelp();
+                return;
+            }
+
+            if (!CommandDebugCheckPciAddress(SplittedCommand.at(3), &NetworkDetails.NetworkAdapterPciAddress))
+            {
+                ShowMessages("err, PCI address is invalid\n\n");
+                CommandDebugHelp();
+                return;
+            }
+
+            if (inet_pton(AF_INET, SplittedCommand.at(4).c_str(), &NetworkDetails.DebuggeeIpAddress) != 1 ||
+                inet_pton(AF_INET, SplittedCommand.at(5).c_str(), &NetworkDetails.DebuggerIpAddress) != 1)
+            {
+                ShowMessages("err, IP address is invalid\n\n");
+                CommandDebugHelp();
+                return;
+            }
+
+            if (!CommandDebugCheckUdpPort(SplittedCommand.at(6), &NetworkDetails.UdpPort))
+            {
+                ShowMessages("err, port is invalid\n\n");
+                CommandDebugHelp();
+                return;
+            }
+
             //
             // Everything is okay, prepare to send (debuggee)
             //
-            KdPrepareAndConnectDebugPort(SplittedCommand.at(4).c_str(), Baudrate, Port, TRUE, FALSE);
+            KdPrepareAndConnectDebugPort(NULL, NULL, NULL, TRUE, FALSE, &NetworkDetails, NULL);
         }
         else
         {
@@ -70,7 +70,7 @@ DetachFromProcess()
  * @return VOID
  */
 VOID
-CommandDetach(vector<string> SplittedCommand, string Command)
+CommandDetach(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() >= 2)
     {
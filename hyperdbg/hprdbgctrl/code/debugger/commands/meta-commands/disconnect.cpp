@@ -16,8 +16,8 @@
 //
 extern BOOLEAN g_IsConnectedToHyperDbgLocally;
 extern BOOLEAN g_IsConnectedToRemoteDebuggee;
-extern HANDLE  g_RemoteDebuggeeListeningThread;
-extern HANDLE  g_EndOfMessageReceivedEvent;
+extern string  g_ServerPort;
+extern string  g_ServerIp;
 
 /**
  * @brief help of .disconnect command
@@ -30,6 +30,9 @@ CommandDisconnectHelp()
     ShowMessages(".disconnect : disconnects from a debugging session (it won't "
                  "unload the modules).\n\n");
 
+    ShowMessages("if the debugger is connected to more than one remote debuggee, "
+                 "then the active session is closed (see '.session')\n\n");
+
     ShowMessages("syntax : \t.disconnect \n");
 }
 
@@ -41,7 +44,7 @@ CommandDisconnectHelp()
  * @return VOID
  */
 VOID
-CommandDisconnect(vector<string> SplittedCommand, string Command)
+CommandDisconnect(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() != 1)
     {
@@ -80,17 +83,19 @@ CommandDisconnect(vector<string> SplittedCommand, string Command)
     if (g_IsConnectedToRemoteDebuggee)
     {
         //
-        // We should kill the thread that was listening for the
-        // remote commands and close the connection
+        // We should stop the thread that was listening for the
+        // remote commands and close the connection, the remote
+        // debuggee stays connected if there are other sessions
         //
-        TerminateThread(g_RemoteDebuggeeListeningThread, 0);
-        CloseHandle(g_RemoteDebuggeeListeningThread);
-        CloseHandle(g_EndOfMessageReceivedEvent);
-        g_EndOfMessageReceivedEvent = NULL;
-
         RemoteConnectionCloseTheConnectionWithDebuggee();
 
-        g_IsConnectedToRemoteDebuggee = FALSE;
+        if (g_IsConnectedToRemoteDebuggee)
+        {
+            ShowMessages("disconnected successfully, switched to the session of %s:%s\n",
+                         g_ServerIp.c_str(),
+                         g_ServerPort.c_str());
+            return;
+        }
     }
 
     ShowMessages("disconnected successfully\n");
@@ -102,7 +102,7 @@ CommandFormatsShowResults(UINT64 U64Value)
  * @return VOID
  */
 VOID
-CommandFormats(vector<string> SplittedCommand, string Command)
+CommandFormats(vector<string> & SplittedCommand, string & Command)
 {
     UINT64  ConstantValue = 0;
     BOOLEAN HasError      = TRUE;
@@ -37,7 +37,7 @@ CommandKillHelp()
  * @return VOID
  */
 VOID
-CommandKill(vector<string> SplittedCommand, string Command)
+CommandKill(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() != 1)
     {
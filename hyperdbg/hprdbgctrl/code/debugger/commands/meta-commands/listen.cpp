@@ -35,11 +35,15 @@ CommandListenHelp()
                  "default port (%s)\n",
                  DEFAULT_PORT);
 
-    ShowMessages("syntax : \t.listen [Port (decimal)]\n");
+    ShowMessages("note : \tin the 'multi' mode, the first client controls the debugger "
+                 "and other clients are read-only (only the results are shown to them)\n");
+
+    ShowMessages("syntax : \t.listen [multi] [Port (decimal)]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : .listen\n");
     ShowMessages("\t\te.g : .listen 50000\n");
+    ShowMessages("\t\te.g : .listen multi 50000\n");
 }
 
 /**
@@ -50,9 +54,19 @@ CommandListenHelp()
  * @return VOID
  */
 VOID
-CommandListen(vector<string> SplittedCommand, string Command)
+CommandListen(vector<string> & SplittedCommand, string & Command)
 {
-    string port;
+    string  port;
+    BOOLEAN IsMultiClient = FALSE;
+
+    //
+    // Check for the multi-client mode
+    //
+    if (SplittedCommand.size() >= 2 && !SplittedCommand.at(1).compare("multi"))
+    {
+        IsMultiClient = TRUE;
+        SplittedCommand.erase(SplittedCommand.begin() + 1);
+    }
 
     if (SplittedCommand.size() >= 3)
     {
@@ -88,7 +102,7 @@ CommandListen(vector<string> SplittedCommand, string Command)
         // listen on default port
         //
         ShowMessages("listening on %s ...\n", DEFAULT_PORT);
-        RemoteConnectionListen(DEFAULT_PORT);
+        RemoteConnectionListen(DEFAULT_PORT, IsMultiClient);
 
         return;
     }
@@ -111,7 +125,7 @@ CommandListen(vector<string> SplittedCommand, string Command)
         // listen on the port
         //
         ShowMessages("listening on %s ...\n", port.c_str());
-        RemoteConnectionListen(port.c_str());
+        RemoteConnectionListen(port.c_str(), IsMultiClient);
     }
     else
     {
@@ -14,8 +14,7 @@
 //
 // Global Variables
 //
-extern BOOLEAN  g_LogOpened;
-extern ofstream g_LogOpenFile;
+extern BOOLEAN g_LogOpened;
 
 /**
  * @brief help .logclose command
@@ -38,7 +37,7 @@ CommandLogcloseHelp()
  * @return VOID
  */
 VOID
-CommandLogclose(vector<string> SplittedCommand, string Command)
+CommandLogclose(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() != 1)
     {
@@ -66,12 +65,12 @@ CommandLogclose(vector<string> SplittedCommand, string Command)
                  tm.tm_min,
                  tm.tm_sec);
     //
-    // close the file
+    // Globally indicate that file is no longer available
     //
-    g_LogOpenFile.close();
+    g_LogOpened = FALSE;
 
     //
-    // Globally indicate that file is no longer available
+    // Write the buffered messages and close the file
     //
-    g_LogOpened = FALSE;
+    LogopenCloseFile();
 }
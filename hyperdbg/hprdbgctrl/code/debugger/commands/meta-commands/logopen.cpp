@@ -16,8 +16,116 @@ using namespace std;
 //
 // Global Variables
 //
-extern BOOLEAN  g_LogOpened;
-extern ofstream g_LogOpenFile;
+extern BOOLEAN        g_LogOpened;
+extern LOGOPEN_WRITER g_LogOpenWriter;
+
+/**
+ * @brief The writer thread of the log file
+ * @details the active buffer is swapped and written to the file once
+ * it's half full or once the flush interval is passed
+ *
+ * @param Parameter
+ *
+ * @return DWORD
+ */
+static DWORD WINAPI
+LogopenWriterThread(LPVOID Parameter)
+{
+    CHAR *  Buffer;
+    UINT32  Length;
+    DWORD   WrittenBytes;
+    BOOLEAN IsStopping;
+
+    UNREFERENCED_PARAMETER(Parameter);
+
+    while (TRUE)
+    {
+        EnterCriticalSection(&g_LogOpenWriter.Lock);
+
+        if (g_LogOpenWriter.IsOpened && g_LogOpenWriter.ActiveLength < LOGOPEN_BUFFER_SIZE / 2)
+        {
+            SleepConditionVariableCS(&g_LogOpenWriter.BufferHalfFull, &g_LogOpenWriter.Lock, LOGOPEN_FLUSH_INTERVAL);
+        }
+
+        //
+        // Swap the buffers, the messages are appended to the other buffer
+        // while this buffer is being written
+        //
+        Buffer = g_LogOpenWriter.Buffers[g_LogOpenWriter.ActiveBuffer];
+        Length = g_LogOpenWriter.ActiveLength;
+
+        g_LogOpenWriter.ActiveBuffer ^= 1;
+        g_LogOpenWriter.ActiveLength = 0;
+
+        IsStopping = !g_LogOpenWriter.IsOpened;
+
+        WakeAllConditionVariable(&g_LogOpenWriter.BufferNotFull);
+
+        LeaveCriticalSection(&g_LogOpenWriter.Lock);
+
+        if (Length != 0)
+        {
+            WriteFile(g_LogOpenWriter.FileHandle, Buffer, Length, &WrittenBytes, NULL);
+        }
+
+        if (IsStopping)
+        {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Open the log file and start its writer thread
+ *
+ * @param FilePath
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+LogopenOpenFile(const char * FilePath)
+{
+    HANDLE FileHandle;
+
+    FileHandle = CreateFileA(FilePath, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        return FALSE;
+    }
+
+    //
+    // The lock is not deleted as messages might be saved (and rejected)
+    // after the log file is closed
+    //
+    if (!g_LogOpenWriter.IsLockInitialized)
+    {
+        InitializeCriticalSection(&g_LogOpenWriter.Lock);
+        InitializeConditionVariable(&g_LogOpenWriter.BufferHalfFull);
+        InitializeConditionVariable(&g_LogOpenWriter.BufferNotFull);
+
+        g_LogOpenWriter.IsLockInitialized = TRUE;
+    }
+
+    g_LogOpenWriter.FileHandle   = FileHandle;
+    g_LogOpenWriter.ActiveBuffer = 0;
+    g_LogOpenWriter.ActiveLength = 0;
+    g_LogOpenWriter.IsOpened     = TRUE;
+
+    g_LogOpenWriter.WriterThread = CreateThread(NULL, 0, LogopenWriterThread, NULL, 0, NULL);
+
+    if (g_LogOpenWriter.WriterThread == NULL)
+    {
+        g_LogOpenWriter.IsOpened = FALSE;
+        CloseHandle(FileHandle);
+
+        return FALSE;
+    }
+
+    return TRUE;
+}
 
 /**
  * @brief help of .logopen command
@@ -40,7 +148,7 @@ CommandLogopenHelp()
  * @return VOID
  */
 VOID
-CommandLogopen(vector<string> SplittedCommand, string Command)
+CommandLogopen(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() == 1)
     {
@@ -72,14 +180,9 @@ CommandLogopen(vector<string> SplittedCommand, string Command)
     Trim(Command);
 
     //
-    // Try to open it as file
+    // Try to open it as file and check if it's okay
     //
-    g_LogOpenFile.open(Command.c_str());
-
-    //
-    // Check if it's okay
-    //
-    if (g_LogOpenFile.is_open())
+    if (LogopenOpenFile(Command.c_str()))
     {
         //
         // Start intercepting logs
@@ -110,7 +213,59 @@ CommandLogopen(vector<string> SplittedCommand, string Command)
 }
 
 /**
- * @brief Append text to the file object
+ * @brief Append a buffer to the log file
+ * @details the buffer is copied to the active buffer of the log file
+ * and it's written by the writer thread, the caller only waits if
+ * the writer thread doesn't keep up
+ *
+ * @param Buffer
+ * @param Length
+ * @return VOID
+ */
+VOID
+LogopenSaveBufferToFile(const char * Buffer, UINT32 Length)
+{
+    UINT32 CopyLength;
+
+    if (!g_LogOpenWriter.IsLockInitialized)
+    {
+        return;
+    }
+
+    EnterCriticalSection(&g_LogOpenWriter.Lock);
+
+    while (Length != 0 && g_LogOpenWriter.IsOpened)
+    {
+        if (g_LogOpenWriter.ActiveLength == LOGOPEN_BUFFER_SIZE)
+        {
+            //
+            // Wait for the writer thread to swap the buffers
+            //
+            WakeConditionVariable(&g_LogOpenWriter.BufferHalfFull);
+            SleepConditionVariableCS(&g_LogOpenWriter.BufferNotFull, &g_LogOpenWriter.Lock, INFINITE);
+
+            continue;
+        }
+
+        CopyLength = min(Length, LOGOPEN_BUFFER_SIZE - g_LogOpenWriter.ActiveLength);
+
+        memcpy(&g_LogOpenWriter.Buffers[g_LogOpenWriter.ActiveBuffer][g_LogOpenWriter.ActiveLength], Buffer, CopyLength);
+
+        g_LogOpenWriter.ActiveLength += CopyLength;
+        Buffer += CopyLength;
+        Length -= CopyLength;
+    }
+
+    if (g_LogOpenWriter.ActiveLength >= LOGOPEN_BUFFER_SIZE / 2)
+    {
+        WakeConditionVariable(&g_LogOpenWriter.BufferHalfFull);
+    }
+
+    LeaveCriticalSection(&g_LogOpenWriter.Lock);
+}
+
+/**
+ * @brief Append text to the log file
  *
  * @param Text
  * @return VOID
@@ -118,5 +273,38 @@ CommandLogopen(vector<string> SplittedCommand, string Command)
 VOID
 LogopenSaveToFile(const char * Text)
 {
-    g_LogOpenFile << Text;
+    LogopenSaveBufferToFile(Text, (UINT32)strlen(Text));
+}
+
+/**
+ * @brief Write the buffered messages to the log file and close it
+ *
+ * @return VOID
+ */
+VOID
+LogopenCloseFile()
+{
+    if (!g_LogOpenWriter.IsLockInitialized || g_LogOpenWriter.WriterThread == NULL)
+    {
+        return;
+    }
+
+    EnterCriticalSection(&g_LogOpenWriter.Lock);
+
+    g_LogOpenWriter.IsOpened = FALSE;
+
+    WakeAllConditionVariable(&g_LogOpenWriter.BufferHalfFull);
+    WakeAllConditionVariable(&g_LogOpenWriter.BufferNotFull);
+
+    LeaveCriticalSection(&g_LogOpenWriter.Lock);
+
+    //
+    // The writer thread writes the remaining messages before exiting
+    //
+    WaitForSingleObject(g_LogOpenWriter.WriterThread, INFINITE);
+    CloseHandle(g_LogOpenWriter.WriterThread);
+    CloseHandle(g_LogOpenWriter.FileHandle);
+
+    g_LogOpenWriter.WriterThread = NULL;
+    g_LogOpenWriter.FileHandle   = NULL;
 }
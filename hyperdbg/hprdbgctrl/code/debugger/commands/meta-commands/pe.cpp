@@ -40,7 +40,7 @@ CommandPeHelp()
  * @return VOID
  */
 VOID
-CommandPe(vector<string> SplittedCommand, string Command)
+CommandPe(vector<string> & SplittedCommand, string & Command)
 {
     BOOLEAN Is32Bit = FALSE;
     wstring Filepath;
@@ -53,7 +53,7 @@ CommandProcessHelp()
  * @return VOID
  */
 VOID
-CommandProcess(vector<string> SplittedCommand, string Command)
+CommandProcess(vector<string> & SplittedCommand, string & Command)
 {
     UINT32                               TargetProcessId            = 0;
     UINT64                               TargetProcess              = 0;
@@ -140,13 +140,10 @@ CommandProcess(vector<string> SplittedCommand, string Command)
                 else
                 {
                     //
-                    // Send the packet to show list of process
+                    // Show list of process (it's only queried once in each
+                    // halt of the debuggee)
                     //
-                    KdSendSwitchProcessPacketToDebuggee(DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_GET_PROCESS_LIST,
-                                                        NULL,
-                                                        NULL,
-                                                        FALSE,
-                                                        &ProcessListNeededItems);
+                    KdObjectCacheShowProcessList(&ProcessListNeededItems);
                 }
             }
             else
@@ -41,7 +41,7 @@ CommandRestartHelp()
  * @return VOID
  */
 VOID
-CommandRestart(vector<string> SplittedCommand, string Command)
+CommandRestart(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() != 1)
     {
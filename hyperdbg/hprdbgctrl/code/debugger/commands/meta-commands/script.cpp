@@ -113,10 +113,12 @@ VOID
 HyperDbgScriptReadFileAndExecuteCommand(std::vector<std::string> & PathAndArgs)
 {
     std::string Line;
-    BOOLEAN     IsOpened         = FALSE;
-    bool        Reset            = false;
-    string      CommandToExecute = "";
-    string      PathOfScriptFile = "";
+    BOOLEAN     IsOpened            = FALSE;
+    BOOLEAN     IsBatchStarted      = FALSE;
+    BOOLEAN     IsEditsBatchStarted = FALSE;
+    bool        Reset               = false;
+    string      CommandToExecute    = "";
+    string      PathOfScriptFile    = "";
 
     //
     // Parse the script file,
@@ -136,6 +138,17 @@ HyperDbgScriptReadFileAndExecuteCommand(std::vector<std::string> & PathAndArgs)
         //
         g_ExecutingScript = TRUE;
 
+        //
+        // Gather the requests that query the halted debuggee into
+        // batches, so they don't need separate round-trips
+        //
+        IsBatchStarted = KdBatchRequestsBegin();
+
+        //
+        // Gather the consecutive e* commands into a single patch request
+        //
+        IsEditsBatchStarted = CommandEditMemoryBatchBegin();
+
         //
         // Reset multiline command
         //
@@ -181,6 +194,20 @@ HyperDbgScriptReadFileAndExecuteCommand(std::vector<std::string> & PathAndArgs)
                 CommandToExecute += Line;
             }
 
+            //
+            // The gathered requests are sent before running a command
+            // that is not gathered into the batch
+            //
+            if (!KdBatchRequestsIsBatchableCommand(CommandToExecute))
+            {
+                KdBatchRequestsFlush();
+            }
+
+            if (!CommandEditMemoryBatchIsBatchableCommand(CommandToExecute))
+            {
+                CommandEditMemoryBatchFlush();
+            }
+
             //
             // Run the command
             //
@@ -197,6 +224,16 @@ HyperDbgScriptReadFileAndExecuteCommand(std::vector<std::string> & PathAndArgs)
         //
         if (!CommandToExecute.empty())
         {
+            if (!KdBatchRequestsIsBatchableCommand(CommandToExecute))
+            {
+                KdBatchRequestsFlush();
+            }
+
+            if (!CommandEditMemoryBatchIsBatchableCommand(CommandToExecute))
+            {
+                CommandEditMemoryBatchFlush();
+            }
+
             CommandScriptRunCommand(CommandToExecute, PathAndArgs);
 
             //
@@ -205,6 +242,19 @@ HyperDbgScriptReadFileAndExecuteCommand(std::vector<std::string> & PathAndArgs)
             CommandToExecute.clear();
         }
 
+        //
+        // Send the remaining requests of the batch
+        //
+        if (IsEditsBatchStarted)
+        {
+            CommandEditMemoryBatchEnd();
+        }
+
+        if (IsBatchStarted)
+        {
+            KdBatchRequestsEnd();
+        }
+
         //
         // Indicate that script is finished
         //
@@ -263,7 +313,7 @@ HyperDbgScriptReadFileAndExecuteCommandline(int argc, char * argv[])
  * @return VOID
  */
 VOID
-CommandScript(vector<string> SplittedCommand, string Command)
+CommandScript(vector<string> & SplittedCommand, string & Command)
 {
     vector<string> PathAndArgs;
 
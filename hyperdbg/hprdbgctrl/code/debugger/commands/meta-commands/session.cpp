@@ -0,0 +1,90 @@
+/**
+ * @file session.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief .session command
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_IsConnectedToRemoteDebuggee;
+extern string  g_ServerPort;
+extern string  g_ServerIp;
+
+/**
+ * @brief help of .session command
+ *
+ * @return VOID
+ */
+VOID
+CommandSessionHelp()
+{
+    ShowMessages(".session : shows and switches between the remote machines (debuggees) "
+                 "that the debugger is connected to ('vmi mode').\n\n");
+
+    ShowMessages("syntax : \t.session\n");
+    ShowMessages("syntax : \t.session [Id (hex)]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : .session\n");
+    ShowMessages("\t\te.g : .session 1\n");
+
+    ShowMessages("\n");
+    ShowMessages("the commands are sent to the active session (marked by '*'), and the "
+                 "messages of the other sessions are shown with the id of their session\n");
+}
+
+/**
+ * @brief .session command handler
+ *
+ * @param SplittedCommand
+ * @param Command
+ * @return VOID
+ */
+VOID
+CommandSession(vector<string> & SplittedCommand, string & Command)
+{
+    UINT32 Id;
+
+    if (SplittedCommand.size() > 2)
+    {
+        ShowMessages("incorrect use of '.session'\n\n");
+        CommandSessionHelp();
+        return;
+    }
+
+    if (!g_IsConnectedToRemoteDebuggee)
+    {
+        ShowMessages("you're not connected to any remote debuggee, use '.connect' "
+                     "to connect to a remote machine\n");
+        return;
+    }
+
+    if (SplittedCommand.size() == 1)
+    {
+        RemoteConnectionShowSessions();
+        return;
+    }
+
+    if (!ConvertStringToUInt32(SplittedCommand.at(1), &Id))
+    {
+        ShowMessages("please specify a correct hex value for the id of the session\n\n");
+        CommandSessionHelp();
+        return;
+    }
+
+    if (!RemoteConnectionSwitchSession(Id))
+    {
+        ShowMessages("err, session %x is not found, use '.session' to see the sessions\n", Id);
+        return;
+    }
+
+    ShowMessages("switched to session %x (%s:%s)\n", Id, g_ServerIp.c_str(), g_ServerPort.c_str());
+}
@@ -0,0 +1,579 @@
+/**
+ * @file snapshot.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief .snapshot command
+ * @details the first checkpoint copies all of the physical RAM and the
+ * next checkpoints only save the pages that are dirtied (based on PML)
+ * since the previous checkpoint, the pages are copied while the guest
+ * is running, the pages that are written meanwhile are dirtied again
+ * and saved in the next checkpoint
+ * @version 0.4
+ * @date 2023-08-04
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+extern HANDLE  g_DeviceHandle;
+
+//
+// The state of the snapshot session
+//
+static vector<SNAPSHOT_CHECKPOINT> SnapshotCheckpoints;
+static vector<UINT64>              SnapshotRamBitmap;     // The pages that are backed by RAM
+static vector<UINT64>              SnapshotPendingBitmap; // The dirty pages that are not saved yet
+static vector<UINT64>              SnapshotPageLocations; // The checkpoint (high part) and the slot (low part) of the latest copy of each page
+static UINT64                      SnapshotEndAddress = 0;
+
+/**
+ * @brief help of .snapshot command
+ *
+ * @return VOID
+ */
+VOID
+CommandSnapshotHelp()
+{
+    ShowMessages(".snapshot : takes incremental snapshots (checkpoints) of the physical memory.\n\n");
+
+    ShowMessages("syntax : \t.snapshot take [FilePath (string)]\n");
+    ShowMessages("syntax : \t.snapshot [diff | list | close]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : .snapshot take c:\\snapshots\\memory.snap\n");
+    ShowMessages("\t\te.g : .snapshot take\n");
+    ShowMessages("\t\te.g : .snapshot diff\n");
+    ShowMessages("\t\te.g : .snapshot list\n");
+    ShowMessages("\t\te.g : .snapshot close\n");
+
+    ShowMessages("\n");
+    ShowMessages("the first 'take' saves all of the RAM and the next ones only save the pages "
+                 "that are written since the previous checkpoint (by default to 'FilePath.n'), "
+                 "'diff' shows the pages that are changed since the last checkpoint\n");
+}
+
+/**
+ * @brief Read the physical memory
+ * @details the unreadable parts are zeroed
+ *
+ * @param Address
+ * @param Buffer
+ * @param Size
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+SnapshotReadPhysicalMemory(UINT64 Address, BYTE * Buffer, UINT32 Size)
+{
+    DEBUGGER_READ_MEMORY ReadMem = {0};
+    BOOL                 Status;
+    ULONG                ReturnedLength;
+
+    //
+    // The physical address zero is not read by the driver
+    //
+    if (Address == 0)
+    {
+        RtlZeroMemory(Buffer, PAGE_SIZE);
+
+        Address += PAGE_SIZE;
+        Buffer += PAGE_SIZE;
+        Size -= PAGE_SIZE;
+
+        if (Size == 0)
+        {
+            return TRUE;
+        }
+    }
+
+    ReadMem.Address     = Address;
+    ReadMem.Pid         = GetCurrentProcessId();
+    ReadMem.Size        = Size;
+    ReadMem.MemoryType  = DEBUGGER_READ_PHYSICAL_ADDRESS;
+    ReadMem.ReadingType = READ_FROM_KERNEL;
+
+    Status = DeviceIoControl(g_DeviceHandle,              // Handle to device
+                             IOCTL_DEBUGGER_READ_MEMORY,  // IO Control code
+                             &ReadMem,                    // Input Buffer to driver.
+                             SIZEOF_DEBUGGER_READ_MEMORY, // Input buffer length
+                             Buffer,                      // Output Buffer from driver.
+                             Size,                        // Length of output buffer in bytes.
+                             &ReturnedLength,             // Bytes placed in buffer.
+                             NULL                         // synchronous call
+    );
+
+    if (!Status)
+    {
+        RtlZeroMemory(Buffer, Size);
+        return FALSE;
+    }
+
+    if (ReturnedLength < Size)
+    {
+        RtlZeroMemory(Buffer + ReturnedLength, Size - ReturnedLength);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Build the bitmap of the pages that are backed by RAM
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+SnapshotBuildRamBitmap()
+{
+    DEBUGGER_QUERY_PHYSICAL_RAM_RANGES RamRangesRequest = {0};
+    BOOL                               Status;
+    ULONG                              ReturnedLength;
+
+    Status = DeviceIoControl(g_DeviceHandle,                            // Handle to device
+                             IOCTL_QUERY_PHYSICAL_RAM_RANGES,           // IO Control code
+                             &RamRangesRequest,                         // Input Buffer to driver.
+                             SIZEOF_DEBUGGER_QUERY_PHYSICAL_RAM_RANGES, // Input buffer length
+                             &RamRangesRequest,                         // Output Buffer from driver.
+                             SIZEOF_DEBUGGER_QUERY_PHYSICAL_RAM_RANGES, // Length of output buffer in bytes.
+                             &ReturnedLength,                           // Bytes placed in buffer.
+                             NULL                                       // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        return FALSE;
+    }
+
+    if (RamRangesRequest.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(RamRangesRequest.KernelStatus);
+        return FALSE;
+    }
+
+    if (RamRangesRequest.CountOfRanges == 0)
+    {
+        ShowMessages("err, the physical memory map is not available\n");
+        return FALSE;
+    }
+
+    SnapshotRamBitmap.assign(SnapshotEndAddress / PAGE_SIZE / 64, 0);
+
+    for (UINT32 i = 0; i < RamRangesRequest.CountOfRanges; i++)
+    {
+        UINT64 FirstPage = RamRangesRequest.Ranges[i].BaseAddress / PAGE_SIZE;
+        UINT64 EndPage   = min((RamRangesRequest.Ranges[i].BaseAddress + RamRangesRequest.Ranges[i].Size) / PAGE_SIZE,
+                             SnapshotEndAddress / PAGE_SIZE);
+
+        for (UINT64 Page = FirstPage; Page < EndPage; Page++)
+        {
+            SnapshotRamBitmap[Page / 64] |= 1ull << (Page % 64);
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Get a pointer to the latest copy of a page
+ *
+ * @param Page The page number
+ *
+ * @return BYTE *
+ */
+static BYTE *
+SnapshotGetLatestCopyOfPage(UINT64 Page)
+{
+    UINT64                Location   = SnapshotPageLocations[Page];
+    PSNAPSHOT_CHECKPOINT  Checkpoint = &SnapshotCheckpoints[Location >> 32];
+    PSNAPSHOT_FILE_HEADER Header     = (PSNAPSHOT_FILE_HEADER)Checkpoint->View;
+
+    return (BYTE *)Checkpoint->View + Header->PagesOffset + ((Location & MAXUINT32) * PAGE_SIZE);
+}
+
+/**
+ * @brief Move the dirty pages since the previous round to the pending bitmap
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+SnapshotCollectDirtyPages()
+{
+    vector<UINT64> DirtyBitmap(SnapshotPendingBitmap.size(), 0);
+    UINT64         EndAddress = 0;
+
+    if (!CommandDirtyGetAndClear(DirtyBitmap.data(), DirtyBitmap.size() * sizeof(UINT64), &EndAddress))
+    {
+        return FALSE;
+    }
+
+    for (size_t i = 0; i < SnapshotPendingBitmap.size(); i++)
+    {
+        SnapshotPendingBitmap[i] |= DirtyBitmap[i] & SnapshotRamBitmap[i];
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Close the files of the checkpoints and stop tracking the dirty pages
+ *
+ * @return VOID
+ */
+static VOID
+SnapshotClose()
+{
+    for (auto & Checkpoint : SnapshotCheckpoints)
+    {
+        UnmapViewOfFile(Checkpoint.View);
+        CloseHandle(Checkpoint.MappingHandle);
+        CloseHandle(Checkpoint.FileHandle);
+    }
+
+    SnapshotCheckpoints.clear();
+    SnapshotRamBitmap.clear();
+    SnapshotPendingBitmap.clear();
+    SnapshotPageLocations.clear();
+    SnapshotEndAddress = 0;
+
+    CommandDirtySetTracking(FALSE);
+}
+
+/**
+ * @brief Save the pages of a bitmap to a new (memory-mapped) file of a checkpoint
+ *
+ * @param Path
+ * @param PagesBitmap The pages to save
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+SnapshotSaveCheckpoint(const string & Path, const vector<UINT64> & PagesBitmap)
+{
+    SNAPSHOT_CHECKPOINT   Checkpoint   = {};
+    PSNAPSHOT_FILE_HEADER Header       = NULL;
+    UINT64                CountOfPages = 0;
+    UINT64                BitmapSize   = PagesBitmap.size() * sizeof(UINT64);
+    UINT64                PagesOffset  = (sizeof(SNAPSHOT_FILE_HEADER) + BitmapSize + PAGE_SIZE - 1) & ~((UINT64)PAGE_SIZE - 1);
+    UINT64                FileSize;
+    UINT64                UnreadablePages = 0;
+    UINT32                CheckpointIndex = (UINT32)SnapshotCheckpoints.size();
+    UINT64                Slot            = 0;
+    UINT64                Page            = 0;
+    UINT64                CountOfAllPages = PagesBitmap.size() * 64;
+
+    for (auto Word : PagesBitmap)
+    {
+        for (; Word != 0; Word &= Word - 1)
+        {
+            CountOfPages++;
+        }
+    }
+
+    FileSize = PagesOffset + (CountOfPages * PAGE_SIZE);
+
+    Checkpoint.Path         = Path;
+    Checkpoint.CountOfPages = CountOfPages;
+    Checkpoint.FileHandle   = CreateFileA(Path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (Checkpoint.FileHandle == INVALID_HANDLE_VALUE)
+    {
+        ShowMessages("err, unable to create the file of the checkpoint (%x)\n", GetLastError());
+        return FALSE;
+    }
+
+    Checkpoint.MappingHandle = CreateFileMappingA(Checkpoint.FileHandle, NULL, PAGE_READWRITE, (DWORD)(FileSize >> 32), (DWORD)(FileSize & MAXUINT32), NULL);
+
+    if (Checkpoint.MappingHandle == NULL)
+    {
+        ShowMessages("err, unable to map the file of the checkpoint (%x)\n", GetLastError());
+        CloseHandle(Checkpoint.FileHandle);
+        return FALSE;
+    }
+
+    Checkpoint.View = MapViewOfFile(Checkpoint.MappingHandle, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, 0);
+
+    if (Checkpoint.View == NULL)
+    {
+        ShowMessages("err, unable to map the file of the checkpoint (%x)\n", GetLastError());
+        CloseHandle(Checkpoint.MappingHandle);
+        CloseHandle(Checkpoint.FileHandle);
+        return FALSE;
+    }
+
+    Header                  = (PSNAPSHOT_FILE_HEADER)Checkpoint.View;
+    Header->Magic           = SNAPSHOT_FILE_MAGIC;
+    Header->Version         = SNAPSHOT_FILE_VERSION;
+    Header->CheckpointIndex = CheckpointIndex;
+    Header->EndAddress      = SnapshotEndAddress;
+    Header->CountOfPages    = CountOfPages;
+    Header->BitmapOffset    = sizeof(SNAPSHOT_FILE_HEADER);
+    Header->PagesOffset     = PagesOffset;
+
+    memcpy((BYTE *)Checkpoint.View + Header->BitmapOffset, PagesBitmap.data(), BitmapSize);
+
+    //
+    // The consecutive pages are read together, the slots of the pages
+    // in the file are also consecutive
+    //
+    while (Page < CountOfAllPages)
+    {
+        UINT64 RunLength = 0;
+
+        if (!(PagesBitmap[Page / 64] & (1ull << (Page % 64))))
+        {
+            Page++;
+            continue;
+        }
+
+        while (Page + RunLength < CountOfAllPages &&
+               (PagesBitmap[(Page + RunLength) / 64] & (1ull << ((Page + RunLength) % 64))) &&
+               RunLength < SNAPSHOT_READ_CHUNK_SIZE / PAGE_SIZE)
+        {
+            SnapshotPageLocations[Page + RunLength] = ((UINT64)CheckpointIndex << 32) | (Slot + RunLength);
+            RunLength++;
+        }
+
+        if (!SnapshotReadPhysicalMemory(Page * PAGE_SIZE,
+                                        (BYTE *)Checkpoint.View + PagesOffset + (Slot * PAGE_SIZE),
+                                        (UINT32)(RunLength * PAGE_SIZE)))
+        {
+            UnreadablePages += RunLength;
+        }
+
+        Page += RunLength;
+        Slot += RunLength;
+    }
+
+    SnapshotCheckpoints.push_back(Checkpoint);
+
+    ShowMessages("checkpoint %x is saved to '%s' (%llx pages)\n", CheckpointIndex, Path.c_str(), CountOfPages);
+
+    if (UnreadablePages != 0)
+    {
+        ShowMessages("warning, some of the pages are not (fully) readable and are saved as zero "
+                     "(around %llx pages)\n",
+                     UnreadablePages);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Take a (full or incremental) checkpoint
+ *
+ * @param Path The file of the checkpoint (empty for the default path)
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+SnapshotTake(string Path)
+{
+    vector<UINT64> PagesBitmap;
+
+    if (SnapshotCheckpoints.empty())
+    {
+        if (Path.empty())
+        {
+            ShowMessages("err, please specify the file of the first checkpoint\n");
+            return FALSE;
+        }
+
+        //
+        // The dirty pages are tracked before copying the memory, so the
+        // pages that are written meanwhile are saved in the next checkpoint
+        //
+        if (!CommandDirtySetTracking(TRUE))
+        {
+            return FALSE;
+        }
+
+        CommandDirtyGetAndClear(NULL, 0, &SnapshotEndAddress);
+
+        SnapshotPendingBitmap.assign(SnapshotEndAddress / PAGE_SIZE / 64, 0);
+        SnapshotPageLocations.assign(SnapshotEndAddress / PAGE_SIZE, 0);
+
+        if (SnapshotEndAddress == 0 || !SnapshotBuildRamBitmap() || !SnapshotCollectDirtyPages())
+        {
+            SnapshotClose();
+            return FALSE;
+        }
+
+        //
+        // The full checkpoint has all of the RAM
+        //
+        SnapshotPendingBitmap.assign(SnapshotPendingBitmap.size(), 0);
+
+        if (!SnapshotSaveCheckpoint(Path, SnapshotRamBitmap))
+        {
+            SnapshotClose();
+            return FALSE;
+        }
+
+        return TRUE;
+    }
+
+    if (Path.empty())
+    {
+        Path = SnapshotCheckpoints.front().Path + "." + std::to_string(SnapshotCheckpoints.size());
+    }
+
+    if (!SnapshotCollectDirtyPages())
+    {
+        return FALSE;
+    }
+
+    PagesBitmap = SnapshotPendingBitmap;
+
+    if (!SnapshotSaveCheckpoint(Path, PagesBitmap))
+    {
+        return FALSE;
+    }
+
+    SnapshotPendingBitmap.assign(SnapshotPendingBitmap.size(), 0);
+
+    return TRUE;
+}
+
+/**
+ * @brief Show the pages that are changed since the last checkpoint
+ * @details the dirty pages are kept to be saved in the next checkpoint
+ *
+ * @return VOID
+ */
+static VOID
+SnapshotDiff()
+{
+    BYTE   Buffer[PAGE_SIZE];
+    UINT64 CountOfAllPages = SnapshotPendingBitmap.size() * 64;
+    UINT64 DirtyPages      = 0;
+    UINT64 ChangedPages    = 0;
+    UINT64 RangeStart      = 0;
+    BOOL   InRange         = FALSE;
+
+    if (!SnapshotCollectDirtyPages())
+    {
+        return;
+    }
+
+    for (UINT64 Page = 0; Page <= CountOfAllPages; Page++)
+    {
+        BOOL IsChanged = FALSE;
+
+        if (Page < CountOfAllPages && (SnapshotPendingBitmap[Page / 64] & (1ull << (Page % 64))))
+        {
+            DirtyPages++;
+
+            SnapshotReadPhysicalMemory(Page * PAGE_SIZE, Buffer, PAGE_SIZE);
+
+            IsChanged = memcmp(Buffer, SnapshotGetLatestCopyOfPage(Page), PAGE_SIZE) != 0;
+        }
+
+        if (IsChanged && !InRange)
+        {
+            RangeStart = Page;
+            InRange    = TRUE;
+        }
+        else if (!IsChanged && InRange)
+        {
+            ShowMessages("%016llx - %016llx (%llx pages)\n", RangeStart * PAGE_SIZE, (Page * PAGE_SIZE) - 1, Page - RangeStart);
+
+            ChangedPages += Page - RangeStart;
+            InRange = FALSE;
+        }
+    }
+
+    ShowMessages("\ncount of changed pages : %llx (dirty pages : %llx)\n", ChangedPages, DirtyPages);
+}
+
+/**
+ * @brief Show the files of the checkpoints
+ *
+ * @return VOID
+ */
+static VOID
+SnapshotList()
+{
+    for (size_t i = 0; i < SnapshotCheckpoints.size(); i++)
+    {
+        ShowMessages("%x  %-10llx pages  %s\n", (UINT32)i, SnapshotCheckpoints[i].CountOfPages, SnapshotCheckpoints[i].Path.c_str());
+    }
+}
+
+/**
+ * @brief .snapshot command handler
+ *
+ * @param SplittedCommand
+ * @param Command
+ * @return VOID
+ */
+VOID
+CommandSnapshot(vector<string> & SplittedCommand, string & Command)
+{
+    string Path;
+
+    if (SplittedCommand.size() == 1 ||
+        (SplittedCommand.at(1).compare("take") && SplittedCommand.size() != 2))
+    {
+        ShowMessages("incorrect use of '.snapshot'\n\n");
+        CommandSnapshotHelp();
+        return;
+    }
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, the snapshots are not supported in the debugger mode\n");
+        return;
+    }
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
+
+    if (!SplittedCommand.at(1).compare("take"))
+    {
+        //
+        // The path might contain spaces
+        //
+        if (SplittedCommand.size() > 2)
+        {
+            Trim(Command);
+            Command.erase(0, SplittedCommand.at(0).size());
+            Trim(Command);
+            Command.erase(0, SplittedCommand.at(1).size());
+            Trim(Command);
+
+            Path = Command;
+        }
+
+        SnapshotTake(Path);
+        return;
+    }
+
+    if (SnapshotCheckpoints.empty())
+    {
+        ShowMessages("err, there is no checkpoint, use '.snapshot take' to take the first one\n");
+        return;
+    }
+
+    if (!SplittedCommand.at(1).compare("diff"))
+    {
+        SnapshotDiff();
+    }
+    else if (!SplittedCommand.at(1).compare("list"))
+    {
+        SnapshotList();
+    }
+    else if (!SplittedCommand.at(1).compare("close"))
+    {
+        SnapshotClose();
+        ShowMessages("the checkpoints are closed\n");
+    }
+    else
+    {
+        ShowMessages("err, couldn't resolve error at '%s'\n\n", SplittedCommand.at(1).c_str());
+        CommandSnapshotHelp();
+    }
+}
@@ -42,7 +42,7 @@ CommandStartHelp()
  * @return VOID
  */
 VOID
-CommandStart(vector<string> SplittedCommand, string Command)
+CommandStart(vector<string> & SplittedCommand, string & Command)
 {
     vector<string> PathAndArgs;
     string         Arguments = "";
@@ -47,7 +47,7 @@ CommandStatusHelp()
  * @return VOID
  */
 VOID
-CommandStatus(vector<string> SplittedCommand, string Command)
+CommandStatus(vector<string> & SplittedCommand, string & Command)
 {
     if (SplittedCommand.size() != 1)
     {
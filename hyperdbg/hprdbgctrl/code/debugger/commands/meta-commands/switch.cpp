@@ -46,7 +46,7 @@ CommandSwitchHelp()
  * @return VOID
  */
 VOID
-CommandSwitch(vector<string> SplittedCommand, string Command)
+CommandSwitch(vector<string> & SplittedCommand, string & Command)
 {
     UINT32 PidOrTid = NULL;
 
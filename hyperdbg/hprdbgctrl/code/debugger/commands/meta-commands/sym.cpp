@@ -51,7 +51,7 @@ CommandSymHelp()
  * @return VOID
  */
 VOID
-CommandSym(vector<string> SplittedCommand, string Command)
+CommandSym(vector<string> & SplittedCommand, string & Command)
 {
     UINT64 BaseAddress   = NULL;
     UINT32 UserProcessId = NULL;
@@ -41,7 +41,7 @@ CommandSympathHelp()
  * @return VOID
  */
 VOID
-CommandSympath(vector<string> SplittedCommand, string Command)
+CommandSympath(vector<string> & SplittedCommand, string & Command)
 {
     string SymbolServer = "";
     string Token;
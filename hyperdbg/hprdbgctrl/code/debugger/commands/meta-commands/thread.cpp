@@ -91,13 +91,10 @@ CommandThreadListThreads(UINT64 Eprocess)
         else
         {
             //
-            // Send the packet to list threads
+            // List threads (they're only queried once in each halt of
+            // the debuggee)
             //
-            KdSendSwitchThreadPacketToDebuggee(DEBUGGEE_DETAILS_AND_SWITCH_THREAD_GET_THREAD_LIST,
-                                               NULL,
-                                               NULL,
-                                               FALSE,
-                                               &ThreadListNeededItems);
+            KdObjectCacheShowThreadList(&ThreadListNeededItems);
         }
 
         return TRUE;
@@ -116,7 +113,7 @@ CommandThreadListThreads(UINT64 Eprocess)
  * @return VOID
  */
 VOID
-CommandThread(vector<string> SplittedCommand, string Command)
+CommandThread(vector<string> & SplittedCommand, string & Command)
 {
     UINT32  TargetThreadId = 0;
     UINT64  TargetThread   = 0;
@@ -0,0 +1,343 @@
+/**
+ * @file binary-output.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Binary (structured) format of output sources
+ * @details the records of events are accumulated in blocks, each block
+ * is compressed and appended to the file, once the output is closed the
+ * index of the blocks is appended to the file
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Create the context of writing a binary output file and
+ * write the header of the file
+ *
+ * @param FileHandle Handle of the file
+ *
+ * @return PBINARY_OUTPUT_CONTEXT NULL if it's not possible to write the file
+ */
+PBINARY_OUTPUT_CONTEXT
+BinaryOutputCreate(HANDLE FileHandle)
+{
+    PBINARY_OUTPUT_CONTEXT    Context = new BINARY_OUTPUT_CONTEXT();
+    BINARY_OUTPUT_FILE_HEADER Header  = {0};
+
+    Context->FileHandle        = FileHandle;
+    Context->Compressor        = NULL;
+    Context->FileOffset        = 0;
+    Context->BlockRecordsCount = 0;
+    Context->BlockFirstTsc     = 0;
+    Context->BlockLastTsc      = 0;
+
+    Context->Block.reserve(BINARY_OUTPUT_BLOCK_SIZE + PacketChunkSize);
+
+    //
+    // Blocks are stored without compression if the compressor is not
+    // available
+    //
+    if (CreateCompressor(COMPRESS_ALGORITHM_XPRESS_HUFF, NULL, &Context->Compressor))
+    {
+        Header.CompressionAlgorithm = COMPRESS_ALGORITHM_XPRESS_HUFF;
+    }
+    else
+    {
+        Context->Compressor = NULL;
+    }
+
+    Header.Magic   = BINARY_OUTPUT_FILE_MAGIC;
+    Header.Version = BINARY_OUTPUT_FILE_VERSION;
+
+    if (!ForwardingWriteToFile(FileHandle, (CHAR *)&Header, sizeof(BINARY_OUTPUT_FILE_HEADER)))
+    {
+        if (Context->Compressor != NULL)
+        {
+            CloseCompressor(Context->Compressor);
+        }
+
+        delete Context;
+        return NULL;
+    }
+
+    Context->FileOffset = sizeof(BINARY_OUTPUT_FILE_HEADER);
+
+    return Context;
+}
+
+/**
+ * @brief Make a record of the binary output file from a message of an event
+ * @details if the binary trace record of the message is available, the
+ * values of printf are saved instead of the (formatted) message
+ *
+ * @param Record The record (and its payload) is built in this buffer
+ * @param Tag Tag of the event
+ * @param Message The message (might be null-terminated)
+ * @param MessageLength Length of the message
+ * @param TraceRecord The binary trace record of the message (or NULL)
+ *
+ * @return VOID
+ */
+VOID
+BinaryOutputBuildRecord(std::vector<CHAR> &  Record,
+                        UINT64               Tag,
+                        CHAR *               Message,
+                        UINT32               MessageLength,
+                        PBINARY_TRACE_RECORD TraceRecord)
+{
+    PBINARY_OUTPUT_RECORD  Header;
+    PBINARY_TRACE_ARGUMENT Arguments;
+    UINT32                 PayloadLength;
+
+    if (TraceRecord != NULL)
+    {
+        PayloadLength = TraceRecord->ArgumentsCount * sizeof(UINT64);
+    }
+    else
+    {
+        //
+        // The null-terminator is not saved
+        //
+        PayloadLength = (UINT32)strnlen(Message, MessageLength);
+    }
+
+    Record.assign(sizeof(BINARY_OUTPUT_RECORD) + PayloadLength, 0);
+
+    Header         = (PBINARY_OUTPUT_RECORD)Record.data();
+    Header->Length = (UINT32)Record.size();
+    Header->Tag    = Tag;
+
+    if (TraceRecord != NULL)
+    {
+        Arguments = (PBINARY_TRACE_ARGUMENT)((CHAR *)TraceRecord + sizeof(BINARY_TRACE_RECORD));
+
+        Header->Type           = BINARY_OUTPUT_RECORD_TYPE_TRACE;
+        Header->ArgumentsCount = (UINT16)TraceRecord->ArgumentsCount;
+        Header->Tag            = TraceRecord->Tag;
+        Header->Tsc            = TraceRecord->Tsc;
+        Header->CoreId         = TraceRecord->CoreId;
+        Header->ProcessId      = TraceRecord->ProcessId;
+        Header->ThreadId       = TraceRecord->ThreadId;
+        Header->FormatId       = TraceRecord->FormatId;
+
+        for (UINT32 i = 0; i < TraceRecord->ArgumentsCount; i++)
+        {
+            ((UINT64 *)(Record.data() + sizeof(BINARY_OUTPUT_RECORD)))[i] = Arguments[i].Value;
+        }
+    }
+    else
+    {
+        Header->Type = BINARY_OUTPUT_RECORD_TYPE_TEXT;
+
+        memcpy(Record.data() + sizeof(BINARY_OUTPUT_RECORD), Message, PayloadLength);
+    }
+}
+
+/**
+ * @brief Compress the current block and append it to the file
+ *
+ * @param Context
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+BinaryOutputFlushBlock(PBINARY_OUTPUT_CONTEXT Context)
+{
+    BINARY_OUTPUT_BLOCK_HEADER BlockHeader    = {0};
+    BINARY_OUTPUT_INDEX_ENTRY  IndexEntry     = {0};
+    SIZE_T                     CompressedSize = 0;
+    CHAR *                     BlockData      = Context->Block.data();
+    BOOLEAN                    Result;
+
+    if (Context->BlockRecordsCount == 0)
+    {
+        return TRUE;
+    }
+
+    BlockHeader.Magic            = BINARY_OUTPUT_BLOCK_MAGIC;
+    BlockHeader.RecordsCount     = Context->BlockRecordsCount;
+    BlockHeader.UncompressedSize = (UINT32)Context->Block.size();
+    BlockHeader.CompressedSize   = BlockHeader.UncompressedSize;
+    BlockHeader.FirstTsc         = Context->BlockFirstTsc;
+    BlockHeader.LastTsc          = Context->BlockLastTsc;
+
+    if (Context->Compressor != NULL)
+    {
+        Context->CompressedBlock.resize(Context->Block.size());
+
+        //
+        // The block is stored without compression if it's not compressible
+        // (the compressed data doesn't fit in the size of the block)
+        //
+        if (Compress(Context->Compressor,
+                     Context->Block.data(),
+                     Context->Block.size(),
+                     Context->CompressedBlock.data(),
+                     Context->CompressedBlock.size(),
+                     &CompressedSize) &&
+            CompressedSize < Context->Block.size())
+        {
+            BlockHeader.CompressedSize = (UINT32)CompressedSize;
+            BlockData                  = Context->CompressedBlock.data();
+        }
+    }
+
+    Result = ForwardingWriteToFile(Context->FileHandle, (CHAR *)&BlockHeader, sizeof(BINARY_OUTPUT_BLOCK_HEADER)) &&
+             ForwardingWriteToFile(Context->FileHandle, BlockData, BlockHeader.CompressedSize);
+
+    if (Result)
+    {
+        IndexEntry.Offset       = Context->FileOffset;
+        IndexEntry.RecordsCount = BlockHeader.RecordsCount;
+        IndexEntry.FirstTsc     = BlockHeader.FirstTsc;
+        IndexEntry.LastTsc      = BlockHeader.LastTsc;
+
+        Context->Index.push_back(IndexEntry);
+        Context->FileOffset += sizeof(BINARY_OUTPUT_BLOCK_HEADER) + BlockHeader.CompressedSize;
+    }
+
+    Context->Block.clear();
+    Context->BlockRecordsCount = 0;
+
+    return Result;
+}
+
+/**
+ * @brief Append a record to the current block
+ *
+ * @param Context
+ * @param Record
+ *
+ * @return VOID
+ */
+static VOID
+BinaryOutputAppendRecord(PBINARY_OUTPUT_CONTEXT Context, PBINARY_OUTPUT_RECORD Record)
+{
+    if (Context->BlockRecordsCount == 0)
+    {
+        Context->BlockFirstTsc = 0;
+        Context->BlockLastTsc  = 0;
+    }
+
+    //
+    // Records without the time-stamp counter (text records) are not
+    // considered in the range of the block
+    //
+    if (Record->Tsc != 0)
+    {
+        if (Context->BlockFirstTsc == 0)
+        {
+            Context->BlockFirstTsc = Record->Tsc;
+        }
+
+        Context->BlockLastTsc = Record->Tsc;
+    }
+
+    Context->Block.insert(Context->Block.end(), (CHAR *)Record, (CHAR *)Record + Record->Length);
+    Context->BlockRecordsCount++;
+}
+
+/**
+ * @brief Write a record (which is built by BinaryOutputBuildRecord)
+ * to the binary output file
+ * @details the format string of trace records is written once before
+ * the first record of each format
+ *
+ * @param Context
+ * @param Message The record
+ * @param MessageLength Length of the record
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+BinaryOutputWriteMessage(PBINARY_OUTPUT_CONTEXT Context, CHAR * Message, UINT32 MessageLength)
+{
+    PBINARY_OUTPUT_RECORD Record = (PBINARY_OUTPUT_RECORD)Message;
+    std::vector<CHAR>     FormatRecord;
+    const char *          Format;
+    UINT32                FormatLength;
+
+    if (MessageLength < sizeof(BINARY_OUTPUT_RECORD) || Record->Length != MessageLength)
+    {
+        return FALSE;
+    }
+
+    if ((Record->Type == BINARY_OUTPUT_RECORD_TYPE_TRACE || Record->Type == BINARY_OUTPUT_RECORD_TYPE_RAW) &&
+        Context->WrittenFormats.find(Record->FormatId) == Context->WrittenFormats.end())
+    {
+        Format = ScriptEngineGetBinaryTraceFormat(Record->FormatId);
+
+        if (Format != NULL)
+        {
+            FormatLength = (UINT32)strlen(Format);
+
+            FormatRecord.assign(sizeof(BINARY_OUTPUT_RECORD) + FormatLength, 0);
+
+            ((PBINARY_OUTPUT_RECORD)FormatRecord.data())->Type     = BINARY_OUTPUT_RECORD_TYPE_FORMAT;
+            ((PBINARY_OUTPUT_RECORD)FormatRecord.data())->Length   = (UINT32)FormatRecord.size();
+            ((PBINARY_OUTPUT_RECORD)FormatRecord.data())->Tag      = Record->Tag;
+            ((PBINARY_OUTPUT_RECORD)FormatRecord.data())->FormatId = Record->FormatId;
+
+            memcpy(FormatRecord.data() + sizeof(BINARY_OUTPUT_RECORD), Format, FormatLength);
+
+            BinaryOutputAppendRecord(Context, (PBINARY_OUTPUT_RECORD)FormatRecord.data());
+
+            Context->WrittenFormats[Record->FormatId] = TRUE;
+        }
+    }
+
+    BinaryOutputAppendRecord(Context, Record);
+
+    if (Context->Block.size() >= BINARY_OUTPUT_BLOCK_SIZE)
+    {
+        return BinaryOutputFlushBlock(Context);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Write the remaining records, the index and the footer of the
+ * binary output file and free the context
+ * @details the handle of the file is not closed
+ *
+ * @param Context
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+BinaryOutputClose(PBINARY_OUTPUT_CONTEXT Context)
+{
+    BINARY_OUTPUT_FILE_FOOTER Footer = {0};
+    BOOLEAN                   Result;
+
+    Result = BinaryOutputFlushBlock(Context);
+
+    Footer.IndexOffset = Context->FileOffset;
+    Footer.BlocksCount = (UINT32)Context->Index.size();
+    Footer.Magic       = BINARY_OUTPUT_FILE_MAGIC;
+
+    if (!Context->Index.empty() &&
+        !ForwardingWriteToFile(Context->FileHandle,
+                               (CHAR *)Context->Index.data(),
+                               (UINT32)(Context->Index.size() * sizeof(BINARY_OUTPUT_INDEX_ENTRY))))
+    {
+        Result = FALSE;
+    }
+    else if (!ForwardingWriteToFile(Context->FileHandle, (CHAR *)&Footer, sizeof(BINARY_OUTPUT_FILE_FOOTER)))
+    {
+        Result = FALSE;
+    }
+
+    if (Context->Compressor != NULL)
+    {
+        CloseCompressor(Context->Compressor);
+    }
+
+    delete Context;
+
+    return Result;
+}
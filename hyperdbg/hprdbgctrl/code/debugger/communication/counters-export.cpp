@@ -0,0 +1,446 @@
+/**
+ * @file counters-export.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Exporting the counters of the debugger and the hypervisor
+ * @details the counters (vm-exits, hits of the events, message buffers, pools
+ * and transport) are periodically queried by a sampling thread and published
+ * as the events of a TraceLogging (ETW) provider, so they can be collected by
+ * the ETW sessions (e.g., the monitoring agents, WPR or PerfView) along with
+ * the counters of the workload, each group of counters is only queried if a
+ * session enables its keyword, so no IOCTL is sent while nothing listens
+ *
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern HANDLE g_DeviceHandle;
+
+/**
+ * @brief The ETW provider of the counters ('HyperDbg.Counters')
+ * {d05aaf0c-8611-5ece-8c25-aabed92aa38e}
+ *
+ */
+TRACELOGGING_DEFINE_PROVIDER(g_CountersExportProvider,
+                             "HyperDbg.Counters",
+                             (0xd05aaf0c, 0x8611, 0x5ece, 0x8c, 0x25, 0xaa, 0xbe, 0xd9, 0x2a, 0xa3, 0x8e));
+
+/**
+ * @brief The state of exporting the counters
+ *
+ */
+static COUNTERS_EXPORT_STATE g_CountersExport = {0};
+
+/**
+ * @brief Send a query of the counters to the driver
+ *
+ * @param IoctlCode
+ * @param Buffer The request (used as both input and output)
+ * @param Length Length of the request
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CountersExportQuery(DWORD IoctlCode, PVOID Buffer, UINT32 Length)
+{
+    ULONG ReturnedLength;
+
+    if (g_DeviceHandle == NULL)
+    {
+        return FALSE;
+    }
+
+    return DeviceIoControl(g_DeviceHandle, IoctlCode, Buffer, Length, Buffer, Length, &ReturnedLength, NULL);
+}
+
+/**
+ * @brief Publish the counters of the vm-exits (by the exit reason)
+ * @details the counters are only gathered while the statistics of vm-exits
+ * are enabled ('!vmexitstats enable')
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CountersExportVmexits()
+{
+    PDEBUGGER_VMEXIT_STATISTICS_REQUEST Request = g_CountersExport.VmexitStatistics;
+
+    RtlZeroMemory(Request, SIZEOF_DEBUGGER_VMEXIT_STATISTICS_REQUEST);
+
+    Request->Action = DEBUGGER_VMEXIT_STATISTICS_ACTION_QUERY;
+    Request->CoreId = DEBUGGER_VMEXIT_STATISTICS_ALL_CORES;
+
+    if (!CountersExportQuery(IOCTL_VMEXIT_STATISTICS, Request, SIZEOF_DEBUGGER_VMEXIT_STATISTICS_REQUEST) ||
+        Request->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        return FALSE;
+    }
+
+    if (!Request->IsEnabled)
+    {
+        return TRUE;
+    }
+
+    for (UINT32 i = 0; i < MaximumVmexitStatisticsExitReasons; i++)
+    {
+        if (Request->Reasons[i].Count == 0)
+        {
+            continue;
+        }
+
+        TraceLoggingWrite(g_CountersExportProvider,
+                          "VmexitReason",
+                          TraceLoggingLevel(WINEVENT_LEVEL_INFO),
+                          TraceLoggingKeyword(COUNTERS_EXPORT_KEYWORD_VMEXITS),
+                          TraceLoggingUInt32(i, "ExitReason"),
+                          TraceLoggingUInt64(Request->Reasons[i].Count, "Count"),
+                          TraceLoggingUInt64(Request->Reasons[i].TotalCycles, "TotalCycles"),
+                          TraceLoggingUInt64(Request->Reasons[i].MaximumCycles, "MaximumCycles"));
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Publish the hits of the events
+ * @details the counters are not reset, so the 'events stats' command
+ * shows the same counters
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CountersExportEvents()
+{
+    PDEBUGGER_QUERY_EVENTS_STATISTICS Request = g_CountersExport.EventsStatistics;
+
+    RtlZeroMemory(Request, SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS_HEADER);
+
+    if (!CountersExportQuery(IOCTL_QUERY_EVENTS_STATISTICS, Request, SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS) ||
+        Request->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < Request->CountOfEvents && i < MaximumEventsStatisticsToQuery; i++)
+    {
+        TraceLoggingWrite(g_CountersExportProvider,
+                          "EventHits",
+                          TraceLoggingLevel(WINEVENT_LEVEL_INFO),
+                          TraceLoggingKeyword(COUNTERS_EXPORT_KEYWORD_EVENTS),
+                          TraceLoggingUInt64(Request->Events[i].Tag - DebuggerEventTagStartSeed, "EventId"),
+                          TraceLoggingUInt64(Request->Events[i].Hits, "Hits"),
+                          TraceLoggingUInt64(Request->Events[i].ConditionPasses, "ConditionPasses"),
+                          TraceLoggingUInt64(Request->Events[i].ScriptTsc, "ScriptCycles"),
+                          TraceLoggingBoolean(Request->Events[i].IsEnabled, "IsEnabled"));
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Publish the counters of the message buffers (the counters of
+ * all of the buffers are summed up)
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CountersExportLogBuffers()
+{
+    PDEBUGGER_QUERY_LOG_BUFFERS_STATISTICS Request           = g_CountersExport.LogBuffersStatistics;
+    UINT64                                 DroppedMessages   = 0;
+    UINT64                                 DiscardedMessages = 0;
+    UINT32                                 HighWaterMark     = 0;
+
+    RtlZeroMemory(Request, SIZEOF_DEBUGGER_QUERY_LOG_BUFFERS_STATISTICS);
+
+    if (!CountersExportQuery(IOCTL_QUERY_LOG_BUFFERS_STATISTICS, Request, SIZEOF_DEBUGGER_QUERY_LOG_BUFFERS_STATISTICS) ||
+        Request->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < Request->CountOfBuffers && i < MaximumLogSharedRings; i++)
+    {
+        DroppedMessages += Request->Buffers[i].DroppedMessages;
+        DiscardedMessages += Request->Buffers[i].DiscardedMessages;
+        HighWaterMark = max(HighWaterMark, Request->Buffers[i].HighWaterMark);
+    }
+
+    TraceLoggingWrite(g_CountersExportProvider,
+                      "LogBuffers",
+                      TraceLoggingLevel(WINEVENT_LEVEL_INFO),
+                      TraceLoggingKeyword(COUNTERS_EXPORT_KEYWORD_LOGS),
+                      TraceLoggingUInt64(DroppedMessages, "DroppedMessages"),
+                      TraceLoggingUInt64(DiscardedMessages, "DiscardedMessages"),
+                      TraceLoggingUInt32(HighWaterMark, "HighWaterMark"));
+
+    return TRUE;
+}
+
+/**
+ * @brief Publish the counters of the pools and the nonpaged memory usage
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CountersExportPools()
+{
+    PDEBUGGER_POOL_MANAGER_STATISTICS Request          = g_CountersExport.PoolManagerStatistics;
+    UINT64                            PoolManagerBytes = 0;
+
+    RtlZeroMemory(Request, SIZEOF_DEBUGGER_POOL_MANAGER_STATISTICS);
+
+    if (!CountersExportQuery(IOCTL_QUERY_POOL_MANAGER_STATISTICS, Request, SIZEOF_DEBUGGER_POOL_MANAGER_STATISTICS) ||
+        Request->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < NumberOfPoolIntentions; i++)
+    {
+        PDEBUGGER_POOL_INTENTION_STATISTICS Intention = &Request->Intentions[i];
+
+        TraceLoggingWrite(g_CountersExportProvider,
+                          "PoolIntention",
+                          TraceLoggingLevel(WINEVENT_LEVEL_INFO),
+                          TraceLoggingKeyword(COUNTERS_EXPORT_KEYWORD_POOLS),
+                          TraceLoggingUInt32(i, "Intention"),
+                          TraceLoggingUInt32(Intention->BusyPools, "BusyPools"),
+                          TraceLoggingUInt32(Intention->FreePools, "FreePools"),
+                          TraceLoggingUInt64(Intention->Requests, "Requests"),
+                          TraceLoggingUInt64(Intention->Misses, "Misses"));
+
+        PoolManagerBytes += Intention->Bytes;
+    }
+
+    TraceLoggingWrite(g_CountersExportProvider,
+                      "Pools",
+                      TraceLoggingLevel(WINEVENT_LEVEL_INFO),
+                      TraceLoggingKeyword(COUNTERS_EXPORT_KEYWORD_POOLS),
+                      TraceLoggingUInt64(PoolManagerBytes, "PoolManagerBytes"),
+                      TraceLoggingUInt64(Request->EptSplitTablesBytes, "EptSplitTablesBytes"),
+                      TraceLoggingUInt64(Request->HookPagesBytes, "HookPagesBytes"),
+                      TraceLoggingUInt64(Request->HyperlogBuffersBytes, "HyperlogBuffersBytes"),
+                      TraceLoggingUInt64(Request->ScriptBuffersBytes, "ScriptBuffersBytes"),
+                      TraceLoggingUInt64(Request->EventObjectsBytes, "EventObjectsBytes"));
+
+    return TRUE;
+}
+
+/**
+ * @brief Publish the count of bytes that are transferred over the
+ * connections (serial, named pipe and TCP/UDP)
+ *
+ * @return VOID
+ */
+static VOID
+CountersExportTransport()
+{
+    UINT64 SentBytes;
+    UINT64 ReceivedBytes;
+
+    TransportQueryTransferredBytes(&SentBytes, &ReceivedBytes);
+
+    TraceLoggingWrite(g_CountersExportProvider,
+                      "Transport",
+                      TraceLoggingLevel(WINEVENT_LEVEL_INFO),
+                      TraceLoggingKeyword(COUNTERS_EXPORT_KEYWORD_TRANSPORT),
+                      TraceLoggingUInt64(SentBytes, "SentBytes"),
+                      TraceLoggingUInt64(ReceivedBytes, "ReceivedBytes"));
+}
+
+/**
+ * @brief The thread of sampling the counters
+ *
+ * @param Param
+ *
+ * @return DWORD
+ */
+static DWORD WINAPI
+CountersExportSamplingThread(LPVOID Param)
+{
+    BOOLEAN IsPublished;
+    BOOLEAN IsFailed;
+
+    UNREFERENCED_PARAMETER(Param);
+
+    while (WaitForSingleObject(g_CountersExport.StopEvent, g_CountersExport.Interval) == WAIT_TIMEOUT)
+    {
+        IsPublished = FALSE;
+        IsFailed    = FALSE;
+
+        //
+        // The groups that no session listens to are not queried
+        //
+        if (TraceLoggingProviderEnabled(g_CountersExportProvider, WINEVENT_LEVEL_INFO, COUNTERS_EXPORT_KEYWORD_VMEXITS))
+        {
+            IsFailed |= !CountersExportVmexits();
+            IsPublished = TRUE;
+        }
+
+        if (TraceLoggingProviderEnabled(g_CountersExportProvider, WINEVENT_LEVEL_INFO, COUNTERS_EXPORT_KEYWORD_EVENTS))
+        {
+            IsFailed |= !CountersExportEvents();
+            IsPublished = TRUE;
+        }
+
+        if (TraceLoggingProviderEnabled(g_CountersExportProvider, WINEVENT_LEVEL_INFO, COUNTERS_EXPORT_KEYWORD_LOGS))
+        {
+            IsFailed |= !CountersExportLogBuffers();
+            IsPublished = TRUE;
+        }
+
+        if (TraceLoggingProviderEnabled(g_CountersExportProvider, WINEVENT_LEVEL_INFO, COUNTERS_EXPORT_KEYWORD_POOLS))
+        {
+            IsFailed |= !CountersExportPools();
+            IsPublished = TRUE;
+        }
+
+        if (TraceLoggingProviderEnabled(g_CountersExportProvider, WINEVENT_LEVEL_INFO, COUNTERS_EXPORT_KEYWORD_TRANSPORT))
+        {
+            CountersExportTransport();
+            IsPublished = TRUE;
+        }
+
+        if (IsPublished)
+        {
+            g_CountersExport.CountOfSamples++;
+        }
+
+        if (IsFailed)
+        {
+            g_CountersExport.CountOfFailures++;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Free the buffers and the handles of exporting the counters
+ *
+ * @return VOID
+ */
+static VOID
+CountersExportFreeState()
+{
+    if (g_CountersExport.StopEvent != NULL)
+    {
+        CloseHandle(g_CountersExport.StopEvent);
+    }
+
+    free(g_CountersExport.VmexitStatistics);
+    free(g_CountersExport.EventsStatistics);
+    free(g_CountersExport.LogBuffersStatistics);
+    free(g_CountersExport.PoolManagerStatistics);
+
+    RtlZeroMemory(&g_CountersExport, sizeof(COUNTERS_EXPORT_STATE));
+}
+
+/**
+ * @brief Start exporting the counters
+ * @details the provider is registered and the sampling thread is created
+ *
+ * @param Interval Interval of sampling (in milliseconds)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CountersExportStart(UINT32 Interval)
+{
+    if (g_CountersExport.IsRunning)
+    {
+        //
+        // Only the interval is changed (it's read on each sample)
+        //
+        g_CountersExport.Interval = Interval;
+        return TRUE;
+    }
+
+    g_CountersExport.Interval              = Interval;
+    g_CountersExport.VmexitStatistics      = (PDEBUGGER_VMEXIT_STATISTICS_REQUEST)malloc(SIZEOF_DEBUGGER_VMEXIT_STATISTICS_REQUEST);
+    g_CountersExport.EventsStatistics      = (PDEBUGGER_QUERY_EVENTS_STATISTICS)malloc(SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS);
+    g_CountersExport.LogBuffersStatistics  = (PDEBUGGER_QUERY_LOG_BUFFERS_STATISTICS)malloc(SIZEOF_DEBUGGER_QUERY_LOG_BUFFERS_STATISTICS);
+    g_CountersExport.PoolManagerStatistics = (PDEBUGGER_POOL_MANAGER_STATISTICS)malloc(SIZEOF_DEBUGGER_POOL_MANAGER_STATISTICS);
+    g_CountersExport.StopEvent             = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+    if (g_CountersExport.VmexitStatistics == NULL ||
+        g_CountersExport.EventsStatistics == NULL ||
+        g_CountersExport.LogBuffersStatistics == NULL ||
+        g_CountersExport.PoolManagerStatistics == NULL ||
+        g_CountersExport.StopEvent == NULL)
+    {
+        CountersExportFreeState();
+        return FALSE;
+    }
+
+    if (TraceLoggingRegister(g_CountersExportProvider) != ERROR_SUCCESS)
+    {
+        CountersExportFreeState();
+        return FALSE;
+    }
+
+    g_CountersExport.SamplingThread = CreateThread(NULL, 0, CountersExportSamplingThread, NULL, 0, NULL);
+
+    if (g_CountersExport.SamplingThread == NULL)
+    {
+        TraceLoggingUnregister(g_CountersExportProvider);
+        CountersExportFreeState();
+        return FALSE;
+    }
+
+    g_CountersExport.IsRunning = TRUE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Stop exporting the counters
+ * @details the provider is unregistered once the sampling thread is
+ * finished
+ *
+ * @return VOID
+ */
+VOID
+CountersExportStop()
+{
+    if (!g_CountersExport.IsRunning)
+    {
+        return;
+    }
+
+    SetEvent(g_CountersExport.StopEvent);
+    WaitForSingleObject(g_CountersExport.SamplingThread, INFINITE);
+    CloseHandle(g_CountersExport.SamplingThread);
+
+    TraceLoggingUnregister(g_CountersExportProvider);
+
+    CountersExportFreeState();
+}
+
+/**
+ * @brief Show the state of exporting the counters
+ *
+ * @return VOID
+ */
+VOID
+CountersExportShowStatus()
+{
+    if (!g_CountersExport.IsRunning)
+    {
+        ShowMessages("the counters are not exported\n");
+        return;
+    }
+
+    ShowMessages("the counters are exported by the 'HyperDbg.Counters' provider "
+                 "{d05aaf0c-8611-5ece-8c25-aabed92aa38e}\n");
+    ShowMessages("\tinterval (ms) : %x\n", g_CountersExport.Interval);
+    ShowMessages("\tsamples       : %llx\n", g_CountersExport.CountOfSamples);
+    ShowMessages("\tfailed queries: %llx\n", g_CountersExport.CountOfFailures);
+}
@@ -0,0 +1,568 @@
+/**
+ * @file event-replay.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Recording and replaying the messages of events
+ * @details the messages of events are recorded (with their time-stamp
+ * counters) in the binary output format, the recording is replayed through
+ * the forwarding of events to an output source, so the output sources and
+ * their consumers are measured without a debuggee
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_BreakPrintingOutput;
+
+/**
+ * @brief The state of recording the messages of events
+ *
+ */
+static EVENT_REPLAY_RECORDER g_EventReplayRecorder = {0};
+
+/**
+ * @brief Start recording the messages of events to a file
+ *
+ * @param FilePath Path of the recording
+ *
+ * @return BOOLEAN FALSE if it's already recording or the file can't be created
+ */
+BOOLEAN
+EventReplayStartRecording(const string & FilePath)
+{
+    HANDLE                 FileHandle;
+    PBINARY_OUTPUT_CONTEXT BinaryOutput;
+
+    if (g_EventReplayRecorder.IsRecording)
+    {
+        return FALSE;
+    }
+
+    if (!g_EventReplayRecorder.IsLockInitialized)
+    {
+        InitializeCriticalSection(&g_EventReplayRecorder.Lock);
+        g_EventReplayRecorder.IsLockInitialized = TRUE;
+    }
+
+    FileHandle = CreateFileA(FilePath.c_str(),
+                             GENERIC_WRITE,
+                             0,
+                             NULL,
+                             CREATE_ALWAYS,
+                             FILE_ATTRIBUTE_NORMAL,
+                             NULL);
+
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        return FALSE;
+    }
+
+    BinaryOutput = BinaryOutputCreate(FileHandle);
+
+    if (BinaryOutput == NULL)
+    {
+        CloseHandle(FileHandle);
+        return FALSE;
+    }
+
+    EnterCriticalSection(&g_EventReplayRecorder.Lock);
+
+    g_EventReplayRecorder.FileHandle    = FileHandle;
+    g_EventReplayRecorder.BinaryOutput  = BinaryOutput;
+    g_EventReplayRecorder.RecordsCount  = 0;
+    g_EventReplayRecorder.FailedRecords = 0;
+    g_EventReplayRecorder.IsRecording   = TRUE;
+
+    LeaveCriticalSection(&g_EventReplayRecorder.Lock);
+
+    return TRUE;
+}
+
+/**
+ * @brief Stop recording the messages of events
+ * @details the remaining records, the index and the footer are written
+ * to the recording
+ *
+ * @param RecordsCount Count of the recorded messages
+ * @param FailedRecords Count of the messages that are not written
+ *
+ * @return BOOLEAN FALSE if it's not recording or the recording is not
+ * completely written
+ */
+BOOLEAN
+EventReplayStopRecording(UINT64 * RecordsCount, UINT64 * FailedRecords)
+{
+    BOOLEAN Result;
+
+    if (!g_EventReplayRecorder.IsRecording)
+    {
+        return FALSE;
+    }
+
+    EnterCriticalSection(&g_EventReplayRecorder.Lock);
+
+    g_EventReplayRecorder.IsRecording = FALSE;
+
+    Result = BinaryOutputClose(g_EventReplayRecorder.BinaryOutput);
+    CloseHandle(g_EventReplayRecorder.FileHandle);
+
+    g_EventReplayRecorder.BinaryOutput = NULL;
+    g_EventReplayRecorder.FileHandle   = INVALID_HANDLE_VALUE;
+
+    *RecordsCount  = g_EventReplayRecorder.RecordsCount;
+    *FailedRecords = g_EventReplayRecorder.FailedRecords;
+
+    LeaveCriticalSection(&g_EventReplayRecorder.Lock);
+
+    return Result;
+}
+
+/**
+ * @brief Check whether the messages of events are recorded
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+EventReplayIsRecording()
+{
+    return g_EventReplayRecorder.IsRecording;
+}
+
+/**
+ * @brief Record a message of an event
+ * @details binary trace records are saved as they're received from the
+ * kernel (raw records), other messages are saved as text records, the
+ * time-stamp counter of text records is the time of triggering the event
+ * (or receiving the message if it's not available)
+ *
+ * @param Tag Tag of the event (or the operation code of the message)
+ * @param Message The message (ignored for binary trace records)
+ * @param MessageLength Length of the message (or the binary trace record)
+ * @param TraceRecord The binary trace record (or NULL)
+ * @param Timestamps The time-stamp counters of the message (or NULL)
+ *
+ * @return VOID
+ */
+VOID
+EventReplayRecordMessage(UINT64                       Tag,
+                         CHAR *                       Message,
+                         UINT32                       MessageLength,
+                         PBINARY_TRACE_RECORD         TraceRecord,
+                         PEVENT_FORWARDING_TIMESTAMPS Timestamps)
+{
+    std::vector<CHAR>     Record;
+    PBINARY_OUTPUT_RECORD Header;
+    UINT32                TraceRecordLength;
+
+    if (TraceRecord != NULL)
+    {
+        TraceRecordLength = sizeof(BINARY_TRACE_RECORD) + TraceRecord->ArgumentsCount * sizeof(BINARY_TRACE_ARGUMENT);
+
+        if (TraceRecordLength > MessageLength)
+        {
+            return;
+        }
+
+        Record.assign(sizeof(BINARY_OUTPUT_RECORD) + TraceRecordLength, 0);
+
+        Header                 = (PBINARY_OUTPUT_RECORD)Record.data();
+        Header->Type           = BINARY_OUTPUT_RECORD_TYPE_RAW;
+        Header->ArgumentsCount = (UINT16)TraceRecord->ArgumentsCount;
+        Header->Length         = (UINT32)Record.size();
+        Header->Tag            = TraceRecord->Tag;
+        Header->Tsc            = TraceRecord->Tsc;
+        Header->CoreId         = TraceRecord->CoreId;
+        Header->ProcessId      = TraceRecord->ProcessId;
+        Header->ThreadId       = TraceRecord->ThreadId;
+        Header->FormatId       = TraceRecord->FormatId;
+
+        memcpy(Record.data() + sizeof(BINARY_OUTPUT_RECORD), TraceRecord, TraceRecordLength);
+    }
+    else
+    {
+        BinaryOutputBuildRecord(Record, Tag, Message, MessageLength, NULL);
+
+        Header = (PBINARY_OUTPUT_RECORD)Record.data();
+
+        if (Timestamps != NULL && Timestamps->TriggerTimestamp != 0)
+        {
+            Header->Tsc = Timestamps->TriggerTimestamp;
+        }
+        else if (Timestamps != NULL && Timestamps->ReceivedTimestamp != 0)
+        {
+            Header->Tsc = Timestamps->ReceivedTimestamp;
+        }
+        else
+        {
+            Header->Tsc = __rdtsc();
+        }
+    }
+
+    EnterCriticalSection(&g_EventReplayRecorder.Lock);
+
+    //
+    // The recording might be stopped while the record is built
+    //
+    if (g_EventReplayRecorder.IsRecording)
+    {
+        if (BinaryOutputWriteMessage(g_EventReplayRecorder.BinaryOutput, Record.data(), (UINT32)Record.size()))
+        {
+            g_EventReplayRecorder.RecordsCount++;
+        }
+        else
+        {
+            g_EventReplayRecorder.FailedRecords++;
+        }
+    }
+
+    LeaveCriticalSection(&g_EventReplayRecorder.Lock);
+}
+
+/**
+ * @brief Read a part of the recording
+ *
+ * @param FileHandle
+ * @param Buffer
+ * @param Length
+ *
+ * @return BOOLEAN FALSE if the part is not completely read
+ */
+static BOOLEAN
+EventReplayReadFile(HANDLE FileHandle, PVOID Buffer, UINT32 Length)
+{
+    DWORD ReadBytes = 0;
+
+    return ReadFile(FileHandle, Buffer, Length, &ReadBytes, NULL) && ReadBytes == Length;
+}
+
+/**
+ * @brief Wait till the time of a record is reached (in the recorded speed)
+ * @details the time-stamp counters of the recording are assumed to have
+ * the same frequency as the time-stamp counter of this system
+ *
+ * @param TargetTsc The time-stamp counter that the record should be forwarded
+ * @param TscFrequency Count of cycles per second
+ *
+ * @return VOID
+ */
+static VOID
+EventReplayWaitForRecord(UINT64 TargetTsc, UINT64 TscFrequency)
+{
+    UINT64 CurrentTsc;
+
+    while ((CurrentTsc = __rdtsc()) < TargetTsc && !g_BreakPrintingOutput)
+    {
+        //
+        // Sleep for the long gaps, and spin for the short gaps (less than
+        // a millisecond) to keep the bursts of the recording
+        //
+        if (TscFrequency != 0 && TargetTsc - CurrentTsc > TscFrequency / 1000)
+        {
+            Sleep((DWORD)min((TargetTsc - CurrentTsc) * 1000 / TscFrequency, 100));
+        }
+        else
+        {
+            YieldProcessor();
+        }
+    }
+}
+
+/**
+ * @brief Forward the records of a block of the recording
+ *
+ * @param Block The (decompressed) records of the block
+ * @param BlockSize Size of the block
+ * @param EventDetail The event that its output source receives the messages
+ * @param Formats The format strings of the binary trace records
+ * @param RecordedSpeed Whether the records are forwarded in the recorded speed
+ * @param TscFrequency Count of cycles per second
+ * @param FirstRecordTsc The time-stamp counter of the first record (zero
+ * if no record with the time-stamp counter is forwarded)
+ * @param ReplayStartTsc The time-stamp counter of forwarding the first record
+ * @param Result The results of the replay
+ *
+ * @return BOOLEAN FALSE if the block is not valid
+ */
+static BOOLEAN
+EventReplayForwardBlock(CHAR *                         Block,
+                        UINT32                         BlockSize,
+                        PDEBUGGER_GENERAL_EVENT_DETAIL EventDetail,
+                        std::map<UINT32, string> &     Formats,
+                        BOOLEAN                        RecordedSpeed,
+                        UINT64                         TscFrequency,
+                        UINT64 *                       FirstRecordTsc,
+                        UINT64 *                       ReplayStartTsc,
+                        PEVENT_REPLAY_RESULT           Result)
+{
+    PBINARY_OUTPUT_RECORD       Record;
+    PBINARY_TRACE_RECORD        TraceRecord;
+    CHAR *                      Payload;
+    UINT32                      PayloadLength;
+    const char *                Format;
+    CHAR                        Message[PacketChunkSize];
+    UINT32                      MessageLength;
+    EVENT_FORWARDING_TIMESTAMPS Timestamps = {0};
+
+    for (UINT32 Offset = 0; Offset < BlockSize; Offset += Record->Length)
+    {
+        Record = (PBINARY_OUTPUT_RECORD)(Block + Offset);
+
+        if (BlockSize - Offset < sizeof(BINARY_OUTPUT_RECORD) ||
+            Record->Length < sizeof(BINARY_OUTPUT_RECORD) ||
+            Record->Length > BlockSize - Offset)
+        {
+            return FALSE;
+        }
+
+        Result->RecordsCount++;
+
+        Payload       = (CHAR *)Record + sizeof(BINARY_OUTPUT_RECORD);
+        PayloadLength = Record->Length - sizeof(BINARY_OUTPUT_RECORD);
+
+        if (Record->Type == BINARY_OUTPUT_RECORD_TYPE_FORMAT)
+        {
+            Formats[Record->FormatId] = string(Payload, PayloadLength);
+            continue;
+        }
+
+        //
+        // Make the message of the record
+        //
+        if (Record->Type == BINARY_OUTPUT_RECORD_TYPE_TEXT && PayloadLength < sizeof(Message))
+        {
+            memcpy(Message, Payload, PayloadLength);
+            Message[PayloadLength] = '\0';
+
+            TraceRecord   = NULL;
+            MessageLength = PayloadLength + 1;
+        }
+        else if (Record->Type == BINARY_OUTPUT_RECORD_TYPE_RAW && Formats.find(Record->FormatId) != Formats.end())
+        {
+            TraceRecord = (PBINARY_TRACE_RECORD)Payload;
+            Format      = Formats[Record->FormatId].c_str();
+
+            if (!ScriptEngineFormatBinaryTraceRecord(TraceRecord, PayloadLength, Format, Message, sizeof(Message)))
+            {
+                Result->SkippedMessages++;
+                continue;
+            }
+
+            MessageLength = (UINT32)strlen(Message) + 1;
+        }
+        else
+        {
+            //
+            // Trace records of binary outputs don't have the positions of
+            // their values in the format string, so they're not formatted
+            //
+            Result->SkippedMessages++;
+            continue;
+        }
+
+        //
+        // Keep the gaps between the records (records without the
+        // time-stamp counter are forwarded immediately)
+        //
+        if (Record->Tsc != 0)
+        {
+            if (*FirstRecordTsc == 0)
+            {
+                *FirstRecordTsc = Record->Tsc;
+                *ReplayStartTsc = __rdtsc();
+            }
+            else if (RecordedSpeed && Record->Tsc > *FirstRecordTsc)
+            {
+                EventReplayWaitForRecord(*ReplayStartTsc + (Record->Tsc - *FirstRecordTsc), TscFrequency);
+            }
+        }
+
+        if (g_BreakPrintingOutput)
+        {
+            Result->IsInterrupted = TRUE;
+            return TRUE;
+        }
+
+        //
+        // The message is considered triggered once it's forwarded (the
+        // latency of the forwarding queue and the outputs are measured)
+        //
+        Timestamps.TriggerTimestamp  = __rdtsc();
+        Timestamps.SavedTimestamp    = Timestamps.TriggerTimestamp;
+        Timestamps.ReceivedTimestamp = Timestamps.TriggerTimestamp;
+
+        EventDetail->Tag = Record->Tag;
+
+        ForwardingPerformEventForwarding(EventDetail, Message, MessageLength, TraceRecord, &Timestamps);
+
+        Result->MessagesCount++;
+        Result->BytesCount += MessageLength;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Replay a recording of the messages of events
+ * @details the messages are forwarded to the output source (through the
+ * same path as the messages of events), in the recorded speed (the gaps
+ * between the records are kept) or in the maximum speed, the blocks are
+ * walked from the header so recordings without the index are replayed too
+ *
+ * @param FilePath Path of the recording
+ * @param OutputSourceTag Tag of the output source that receives the messages
+ * @param RecordedSpeed Whether the records are forwarded in the recorded speed
+ * @param TscFrequency Count of cycles per second
+ * @param Result The results of the replay
+ *
+ * @return BOOLEAN FALSE if the recording is not valid
+ */
+BOOLEAN
+EventReplayPerform(const string &       FilePath,
+                   UINT64               OutputSourceTag,
+                   BOOLEAN              RecordedSpeed,
+                   UINT64               TscFrequency,
+                   PEVENT_REPLAY_RESULT Result)
+{
+    HANDLE                         FileHandle;
+    BINARY_OUTPUT_FILE_HEADER      FileHeader   = {0};
+    BINARY_OUTPUT_BLOCK_HEADER     BlockHeader  = {0};
+    DECOMPRESSOR_HANDLE            Decompressor = NULL;
+    PDEBUGGER_GENERAL_EVENT_DETAIL EventDetail;
+    std::vector<CHAR>              CompressedBlock;
+    std::vector<CHAR>              Block;
+    std::map<UINT32, string>       Formats;
+    SIZE_T                         DecompressedSize;
+    UINT64                         FirstRecordTsc = 0;
+    UINT64                         ReplayStartTsc = 0;
+    LARGE_INTEGER                  Frequency;
+    LARGE_INTEGER                  StartCounter;
+    LARGE_INTEGER                  EndCounter;
+    BOOLEAN                        IsValid = TRUE;
+
+    RtlZeroMemory(Result, sizeof(EVENT_REPLAY_RESULT));
+
+    FileHandle = CreateFileA(FilePath.c_str(),
+                             GENERIC_READ,
+                             FILE_SHARE_READ,
+                             NULL,
+                             OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                             NULL);
+
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        return FALSE;
+    }
+
+    if (!EventReplayReadFile(FileHandle, &FileHeader, sizeof(BINARY_OUTPUT_FILE_HEADER)) ||
+        FileHeader.Magic != BINARY_OUTPUT_FILE_MAGIC ||
+        FileHeader.Version != BINARY_OUTPUT_FILE_VERSION ||
+        (FileHeader.CompressionAlgorithm != 0 &&
+         !CreateDecompressor(FileHeader.CompressionAlgorithm, NULL, &Decompressor)))
+    {
+        CloseHandle(FileHandle);
+        return FALSE;
+    }
+
+    //
+    // The messages are forwarded as the messages of an event which only
+    // has the output source
+    //
+    EventDetail = (PDEBUGGER_GENERAL_EVENT_DETAIL)calloc(1, sizeof(DEBUGGER_GENERAL_EVENT_DETAIL));
+
+    if (EventDetail == NULL)
+    {
+        if (Decompressor != NULL)
+        {
+            CloseDecompressor(Decompressor);
+        }
+
+        CloseHandle(FileHandle);
+        return FALSE;
+    }
+
+    EventDetail->HasCustomOutput     = TRUE;
+    EventDetail->OutputSourceTags[0] = OutputSourceTag;
+
+    QueryPerformanceFrequency(&Frequency);
+    QueryPerformanceCounter(&StartCounter);
+
+    //
+    // The index and the footer are after the last block
+    //
+    while (!Result->IsInterrupted &&
+           EventReplayReadFile(FileHandle, &BlockHeader, sizeof(BINARY_OUTPUT_BLOCK_HEADER)) &&
+           BlockHeader.Magic == BINARY_OUTPUT_BLOCK_MAGIC)
+    {
+        if (BlockHeader.CompressedSize > EVENT_REPLAY_MAXIMUM_BLOCK_SIZE ||
+            BlockHeader.UncompressedSize > EVENT_REPLAY_MAXIMUM_BLOCK_SIZE ||
+            (BlockHeader.CompressedSize != BlockHeader.UncompressedSize && Decompressor == NULL))
+        {
+            IsValid = FALSE;
+            break;
+        }
+
+        CompressedBlock.resize(BlockHeader.CompressedSize);
+
+        if (!EventReplayReadFile(FileHandle, CompressedBlock.data(), BlockHeader.CompressedSize))
+        {
+            IsValid = FALSE;
+            break;
+        }
+
+        if (BlockHeader.CompressedSize != BlockHeader.UncompressedSize)
+        {
+            Block.resize(BlockHeader.UncompressedSize);
+
+            if (!Decompress(Decompressor,
+                            CompressedBlock.data(),
+                            CompressedBlock.size(),
+                            Block.data(),
+                            Block.size(),
+                            &DecompressedSize) ||
+                DecompressedSize != BlockHeader.UncompressedSize)
+            {
+                IsValid = FALSE;
+                break;
+            }
+        }
+        else
+        {
+            Block.swap(CompressedBlock);
+        }
+
+        if (!EventReplayForwardBlock(Block.data(),
+                                     BlockHeader.UncompressedSize,
+                                     EventDetail,
+                                     Formats,
+                                     RecordedSpeed,
+                                     TscFrequency,
+                                     &FirstRecordTsc,
+                                     &ReplayStartTsc,
+                                     Result))
+        {
+            IsValid = FALSE;
+            break;
+        }
+    }
+
+    QueryPerformanceCounter(&EndCounter);
+
+    Result->ElapsedMicroseconds = (UINT64)((EndCounter.QuadPart - StartCounter.QuadPart) * 1000000 / Frequency.QuadPart);
+
+    free(EventDetail);
+
+    if (Decompressor != NULL)
+    {
+        CloseDecompressor(Decompressor);
+    }
+
+    CloseHandle(FileHandle);
+
+    return IsValid;
+}
@@ -14,8 +14,14 @@
 //
 // Global Variables
 //
-extern UINT64     g_OutputSourceTag;
-extern LIST_ENTRY g_OutputSources;
+extern UINT64                             g_OutputSourceTag;
+extern LIST_ENTRY                         g_OutputSources;
+extern BOOLEAN                            g_OutputSourcesInitialized;
+extern LIST_ENTRY                         g_EventTrace;
+extern BOOLEAN                            g_EventTraceInitialized;
+extern HANDLE                             g_DeviceHandle;
+extern BOOLEAN                            g_IsSerialConnectedToRemoteDebuggee;
+extern EVENT_FORWARDING_LATENCY_HISTOGRAM g_EventForwardingLatency[EVENT_FORWARDING_LATENCY_STAGES_COUNT];
 
 /**
  * @brief Get the output source tag and increase the
@@ -54,6 +60,66 @@ ForwardingOpenOutputSource(PDEBUGGER_EVENT_FORWARDING SourceDescriptor)
         return DEBUGGER_OUTPUT_SOURCE_STATUS_ALREADY_OPENED;
     }
 
+    //
+    // Initialize the queue of messages and start the writer thread, so the
+    // messages are written without blocking the thread that receives them
+    //
+    InitializeCriticalSection(&SourceDescriptor->QueueLock);
+    InitializeConditionVariable(&SourceDescriptor->QueueNotEmpty);
+    InitializeConditionVariable(&SourceDescriptor->QueueNotFull);
+
+    SourceDescriptor->QueueHead        = 0;
+    SourceDescriptor->QueueCount       = 0;
+    SourceDescriptor->IsWriterStopping = FALSE;
+
+    //
+    // The header of binary files is written once the source is opened
+    //
+    if (SourceDescriptor->Type == EVENT_FORWARDING_BINARY_FILE)
+    {
+        SourceDescriptor->BinaryOutput = BinaryOutputCreate(SourceDescriptor->Handle);
+
+        if (SourceDescriptor->BinaryOutput == NULL)
+        {
+            DeleteCriticalSection(&SourceDescriptor->QueueLock);
+            return DEBUGGER_OUTPUT_SOURCE_STATUS_UNKNOWN_ERROR;
+        }
+    }
+
+    //
+    // The ring of shared memory outputs is mapped once the source is opened
+    //
+    if (SourceDescriptor->Type == EVENT_FORWARDING_SHARED_MEMORY)
+    {
+        SourceDescriptor->SharedMemoryOutput = SharedMemoryOutputOpen(SourceDescriptor->Handle);
+
+        if (SourceDescriptor->SharedMemoryOutput == NULL)
+        {
+            DeleteCriticalSection(&SourceDescriptor->QueueLock);
+            return DEBUGGER_OUTPUT_SOURCE_STATUS_UNKNOWN_ERROR;
+        }
+    }
+
+    SourceDescriptor->WriterThread = CreateThread(NULL, 0, ForwardingWriterThread, SourceDescriptor, 0, NULL);
+
+    if (SourceDescriptor->WriterThread == NULL)
+    {
+        if (SourceDescriptor->BinaryOutput != NULL)
+        {
+            BinaryOutputClose(SourceDescriptor->BinaryOutput);
+            SourceDescriptor->BinaryOutput = NULL;
+        }
+
+        if (SourceDescriptor->SharedMemoryOutput != NULL)
+        {
+            SharedMemoryOutputClose(SourceDescriptor->SharedMemoryOutput);
+            SourceDescriptor->SharedMemoryOutput = NULL;
+        }
+
+        DeleteCriticalSection(&SourceDescriptor->QueueLock);
+        return DEBUGGER_OUTPUT_SOURCE_STATUS_UNKNOWN_ERROR;
+    }
+
     //
     // Set the status to opened
     //
@@ -62,7 +128,8 @@ ForwardingOpenOutputSource(PDEBUGGER_EVENT_FORWARDING SourceDescriptor)
     //
     // Now, it's time to open the source based on its type
     //
-    if (SourceDescriptor->Type == EVENT_FORWARDING_FILE)
+    if (SourceDescriptor->Type == EVENT_FORWARDING_FILE ||
+        SourceDescriptor->Type == EVENT_FORWARDING_BINARY_FILE)
     {
         //
         // Nothing special to do here, file is opened with CreateFile
@@ -78,6 +145,13 @@ ForwardingOpenOutputSource(PDEBUGGER_EVENT_FORWARDING SourceDescriptor)
         //
         return DEBUGGER_OUTPUT_SOURCE_STATUS_SUCCESSFULLY_OPENED;
     }
+    else if (SourceDescriptor->Type == EVENT_FORWARDING_SHARED_MEMORY)
+    {
+        //
+        // Nothing special to do here, the ring is already mapped
+        //
+        return DEBUGGER_OUTPUT_SOURCE_STATUS_SUCCESSFULLY_OPENED;
+    }
     else if (SourceDescriptor->Type == EVENT_FORWARDING_TCP)
     {
         //
@@ -125,6 +199,23 @@ ForwardingCloseOutputSource(PDEBUGGER_EVENT_FORWARDING SourceDescriptor)
     //
     SourceDescriptor->State = EVENT_FORWARDING_CLOSED;
 
+    //
+    // Write the remaining messages and stop the writer thread, the lock is
+    // not deleted as the descriptor remains in the list of output sources
+    //
+    EnterCriticalSection(&SourceDescriptor->QueueLock);
+
+    SourceDescriptor->IsWriterStopping = TRUE;
+
+    WakeAllConditionVariable(&SourceDescriptor->QueueNotEmpty);
+    WakeAllConditionVariable(&SourceDescriptor->QueueNotFull);
+
+    LeaveCriticalSection(&SourceDescriptor->QueueLock);
+
+    WaitForSingleObject(SourceDescriptor->WriterThread, INFINITE);
+    CloseHandle(SourceDescriptor->WriterThread);
+    SourceDescriptor->WriterThread = NULL;
+
     //
     // Now, it's time to close the source based on its type
     //
@@ -140,6 +231,39 @@ ForwardingCloseOutputSource(PDEBUGGER_EVENT_FORWARDING SourceDescriptor)
         //
         return DEBUGGER_OUTPUT_SOURCE_STATUS_SUCCESSFULLY_CLOSED;
     }
+    else if (SourceDescriptor->Type == EVENT_FORWARDING_BINARY_FILE)
+    {
+        //
+        // Write the remaining records and the index of the blocks
+        //
+        BinaryOutputClose(SourceDescriptor->BinaryOutput);
+        SourceDescriptor->BinaryOutput = NULL;
+
+        //
+        // Close the hanlde
+        //
+        CloseHandle(SourceDescriptor->Handle);
+
+        //
+        // Return the status
+        //
+        return DEBUGGER_OUTPUT_SOURCE_STATUS_SUCCESSFULLY_CLOSED;
+    }
+    else if (SourceDescriptor->Type == EVENT_FORWARDING_SHARED_MEMORY)
+    {
+        //
+        // Unmap the ring and close the file mapping
+        //
+        SharedMemoryOutputClose(SourceDescriptor->SharedMemoryOutput);
+        SourceDescriptor->SharedMemoryOutput = NULL;
+
+        CloseHandle(SourceDescriptor->Handle);
+
+        //
+        // Return the status
+        //
+        return DEBUGGER_OUTPUT_SOURCE_STATUS_SUCCESSFULLY_CLOSED;
+    }
     else if (SourceDescriptor->Type == EVENT_FORWARDING_TCP)
     {
         //
@@ -211,6 +335,24 @@ ForwardingCreateOutputSource(DEBUGGER_EVENT_FORWARDING_TYPE SourceType,
         //
         return FileHandle;
     }
+    else if (SourceType == EVENT_FORWARDING_BINARY_FILE)
+    {
+        //
+        // Binary files are always created from the beginning, the records
+        // are appended to the file until the source is closed
+        //
+        HANDLE FileHandle = CreateFileA(Description.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+        return FileHandle;
+    }
+    else if (SourceType == EVENT_FORWARDING_SHARED_MEMORY)
+    {
+        //
+        // The handle might be INVALID_HANDLE_VALUE which will be
+        // checked by the caller
+        //
+        return SharedMemoryOutputCreateMapping(Description);
+    }
     else if (SourceType == EVENT_FORWARDING_NAMEDPIPE)
     {
         HANDLE PipeHandle = NamedPipeClientCreatePipe(Description.c_str());
@@ -281,20 +423,48 @@ ForwardingCreateOutputSource(DEBUGGER_EVENT_FORWARDING_TYPE SourceType,
  * @brief Send the event result to the corresponding sources
  * @param EventDetail Description saved about the event in the
  * user-mode
+ * @param Message The message
  * @param MessageLength Length of the message
+ * @param TraceRecord The binary trace record of the message (or NULL)
+ * @param Timestamps The time-stamp counters of the message (or NULL)
  * @details This function will not check whether the event has an
  * output source or not, the caller if this function should make
- * sure that the following event has valid output sources or not
+ * sure that the following event has valid output sources or not,
+ * binary files receive the structured record of the message instead
+ * of the message
  *
  * @return BOOLEAN whether sending results was successful or not
  */
 BOOLEAN
 ForwardingPerformEventForwarding(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetail,
                                  CHAR *                         Message,
-                                 UINT32                         MessageLength)
+                                 UINT32                         MessageLength,
+                                 PBINARY_TRACE_RECORD           TraceRecord,
+                                 PEVENT_FORWARDING_TIMESTAMPS   Timestamps)
 {
-    BOOLEAN     Result   = FALSE;
-    PLIST_ENTRY TempList = 0;
+    BOOLEAN           Result           = FALSE;
+    PLIST_ENTRY       TempList         = 0;
+    UINT64            TriggerTimestamp = 0;
+    std::vector<CHAR> BinaryRecord;
+
+    //
+    // Only the messages of events that are triggered in vmx-root have the
+    // time of triggering the event
+    //
+    if (Timestamps != NULL && Timestamps->TriggerTimestamp != 0)
+    {
+        TriggerTimestamp = Timestamps->TriggerTimestamp;
+
+        if (Timestamps->ReadTimestamp != 0)
+        {
+            ForwardingRecordLatency(EVENT_FORWARDING_LATENCY_STAGE_KERNEL_BUFFER, Timestamps->SavedTimestamp, Timestamps->ReadTimestamp);
+            ForwardingRecordLatency(EVENT_FORWARDING_LATENCY_STAGE_IOCTL_DRAIN, Timestamps->ReadTimestamp, Timestamps->ReceivedTimestamp);
+        }
+        else
+        {
+            ForwardingRecordLatency(EVENT_FORWARDING_LATENCY_STAGE_KERNEL_BUFFER, Timestamps->SavedTimestamp, Timestamps->ReceivedTimestamp);
+        }
+    }
 
     for (size_t i = 0; i < DebuggerOutputSourceMaximumRemoteSourceForSingleEvent;
          i++)
@@ -332,29 +502,30 @@ ForwardingPerformEventForwarding(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetail,
                 // not closed
                 //
                 if (CurrentOutputSourceDetails->State ==
-                    EVENT_FORWARDING_STATE_OPENED)
+                    EVENT_FORWARDING_STATE_OPENED &&
+                    !ForwardingIsMessageFiltered(CurrentOutputSourceDetails, Message, MessageLength, TraceRecord))
                 {
-                    switch (CurrentOutputSourceDetails->Type)
+                    //
+                    // The message is written by the writer thread of the source
+                    //
+                    if (CurrentOutputSourceDetails->Type == EVENT_FORWARDING_BINARY_FILE)
+                    {
+                        if (BinaryRecord.empty())
+                        {
+                            BinaryOutputBuildRecord(BinaryRecord, EventDetail->Tag, Message, MessageLength, TraceRecord);
+                        }
+
+                        Result = ForwardingQueueMessage(CurrentOutputSourceDetails,
+                                                        BinaryRecord.data(),
+                                                        (UINT32)BinaryRecord.size(),
+                                                        TriggerTimestamp);
+                    }
+                    else
                     {
-                    case EVENT_FORWARDING_NAMEDPIPE:
-                        Result = ForwardingSendToNamedPipe(
-                            CurrentOutputSourceDetails->Handle,
-                            Message,
-                            MessageLength);
-                        break;
-                    case EVENT_FORWARDING_FILE:
-                        Result = ForwardingWriteToFile(CurrentOutputSourceDetails->Handle,
-                                                       Message,
-                                                       MessageLength);
-                        break;
-                    case EVENT_FORWARDING_TCP:
-                        Result = ForwardingSendToTcpSocket(
-                            CurrentOutputSourceDetails->Socket,
-                            Message,
-                            MessageLength);
-                        break;
-                    default:
-                        break;
+                        Result = ForwardingQueueMessage(CurrentOutputSourceDetails,
+                                                        Message,
+                                                        MessageLength,
+                                                        TriggerTimestamp);
                     }
                 }
 
@@ -369,6 +540,619 @@ ForwardingPerformEventForwarding(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetail,
     return FALSE;
 }
 
+/**
+ * @brief Check whether a message is suppressed by the filters of the
+ * output source
+ * @param SourceDescriptor Descriptor of the source
+ * @param Message The message
+ * @param MessageLength Length of the message
+ * @param TraceRecord The binary trace record of the message (or NULL)
+ * @details the cheaper filters are evaluated first, the message is
+ * counted by the sampling and the rate limit only if it's accepted
+ * by the other filters
+ *
+ * @return BOOLEAN TRUE if the message should not be written to the source
+ */
+BOOLEAN
+ForwardingIsMessageFiltered(PDEBUGGER_EVENT_FORWARDING SourceDescriptor,
+                            CHAR *                     Message,
+                            UINT32                     MessageLength,
+                            PBINARY_TRACE_RECORD       TraceRecord)
+{
+    PDEBUGGER_EVENT_FORWARDING_FILTER Filter     = &SourceDescriptor->Filter;
+    BOOLEAN                           IsFiltered = FALSE;
+    ULONGLONG                         CurrentTime;
+    UINT64                            RefilledTokens;
+
+    AcquireSRWLockExclusive(&SourceDescriptor->FilterLock);
+
+    if (Filter->IsMuted)
+    {
+        IsFiltered = TRUE;
+    }
+    else if (Filter->CoreId != EVENT_FORWARDING_FILTER_ANY_CORE && TraceRecord != NULL &&
+             TraceRecord->CoreId != Filter->CoreId)
+    {
+        IsFiltered = TRUE;
+    }
+    else if (Filter->Prefix[0] != '\0' &&
+             strncmp(Message, Filter->Prefix, strnlen(Filter->Prefix, EVENT_FORWARDING_FILTER_MAXIMUM_PREFIX)) != 0)
+    {
+        IsFiltered = TRUE;
+    }
+    else if (Filter->Regex != NULL &&
+             !std::regex_search((const CHAR *)Message, (const CHAR *)Message + strnlen(Message, MessageLength), *Filter->Regex))
+    {
+        IsFiltered = TRUE;
+    }
+    else if (Filter->SampleRate > 1 && Filter->SampleCounter++ % Filter->SampleRate != 0)
+    {
+        IsFiltered = TRUE;
+    }
+    else if (Filter->RateLimit != 0)
+    {
+        //
+        // Token bucket, the tokens are refilled based on the elapsed time
+        //
+        CurrentTime    = GetTickCount64();
+        RefilledTokens = ((CurrentTime - Filter->RateLimitRefillTime) * Filter->RateLimit) / 1000;
+
+        if (RefilledTokens != 0)
+        {
+            Filter->RateLimitTokens     = (UINT32)min(Filter->RateLimitTokens + RefilledTokens, (UINT64)Filter->RateLimit);
+            Filter->RateLimitRefillTime = CurrentTime;
+        }
+
+        if (Filter->RateLimitTokens == 0)
+        {
+            IsFiltered = TRUE;
+        }
+        else
+        {
+            Filter->RateLimitTokens--;
+        }
+    }
+
+    if (IsFiltered)
+    {
+        Filter->FilteredMessages++;
+    }
+
+    ReleaseSRWLockExclusive(&SourceDescriptor->FilterLock);
+
+    return IsFiltered;
+}
+
+/**
+ * @brief Push the state of the output sources of the events down to the
+ * kernel
+ * @details the messages of an event are not generated (in the kernel) if
+ * none of its output sources is opened and not muted, it's only used in
+ * the VMI mode as the output sources are not used in the debugger mode
+ *
+ * @return VOID
+ */
+VOID
+ForwardingUpdateEventsOutputState()
+{
+    DEBUGGER_MODIFY_EVENTS ModifyEventRequest = {0};
+    PLIST_ENTRY            TempList           = 0;
+    PLIST_ENTRY            TempSourceList     = 0;
+    BOOLEAN                IsOutputEnabled;
+    ULONG                  ReturnedLength;
+
+    if (!g_EventTraceInitialized || !g_OutputSourcesInitialized || g_DeviceHandle == NULL ||
+        g_IsSerialConnectedToRemoteDebuggee)
+    {
+        return;
+    }
+
+    TempList = &g_EventTrace;
+
+    while (&g_EventTrace != TempList->Flink)
+    {
+        TempList = TempList->Flink;
+
+        PDEBUGGER_GENERAL_EVENT_DETAIL EventDetail = CONTAINING_RECORD(TempList,
+                                                                       DEBUGGER_GENERAL_EVENT_DETAIL,
+                                                                       CommandsEventList);
+
+        if (!EventDetail->HasCustomOutput)
+        {
+            continue;
+        }
+
+        IsOutputEnabled = FALSE;
+
+        for (size_t i = 0; i < DebuggerOutputSourceMaximumRemoteSourceForSingleEvent &&
+                           EventDetail->OutputSourceTags[i] != NULL && !IsOutputEnabled;
+             i++)
+        {
+            TempSourceList = &g_OutputSources;
+
+            while (&g_OutputSources != TempSourceList->Flink)
+            {
+                TempSourceList = TempSourceList->Flink;
+
+                PDEBUGGER_EVENT_FORWARDING CurrentOutputSourceDetails = CONTAINING_RECORD(TempSourceList,
+                                                                                          DEBUGGER_EVENT_FORWARDING,
+                                                                                          OutputSourcesList);
+
+                if (EventDetail->OutputSourceTags[i] == CurrentOutputSourceDetails->OutputUniqueTag)
+                {
+                    IsOutputEnabled = CurrentOutputSourceDetails->State == EVENT_FORWARDING_STATE_OPENED &&
+                                      !CurrentOutputSourceDetails->Filter.IsMuted;
+                    break;
+                }
+            }
+        }
+
+        ModifyEventRequest.Tag          = EventDetail->Tag;
+        ModifyEventRequest.TypeOfAction = DEBUGGER_MODIFY_EVENTS_SET_OUTPUT;
+        ModifyEventRequest.IsEnabled    = IsOutputEnabled;
+
+        if (!DeviceIoControl(g_DeviceHandle,                // Handle to device
+                             IOCTL_DEBUGGER_MODIFY_EVENTS,  // IO Control code
+                             &ModifyEventRequest,           // Input Buffer to driver.
+                             SIZEOF_DEBUGGER_MODIFY_EVENTS, // Input buffer length
+                             &ModifyEventRequest,           // Output Buffer from driver.
+                             SIZEOF_DEBUGGER_MODIFY_EVENTS, // Length of output
+                                                            // buffer in bytes.
+                             &ReturnedLength,               // Bytes placed in buffer.
+                             NULL                           // synchronous call
+                             ))
+        {
+            ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Queue a message to be written to the output source
+ * @param SourceDescriptor Descriptor of the source
+ * @param Message The message that should be queued
+ * @param MessageLength Length of the message
+ * @param TriggerTimestamp Time-stamp counter of triggering the event (or zero)
+ * @details once the queue is full, the policy of the source decides
+ * whether the caller is blocked or the messages are dropped
+ *
+ * @return BOOLEAN whether the message is handled based on the policy
+ * or not
+ */
+BOOLEAN
+ForwardingQueueMessage(PDEBUGGER_EVENT_FORWARDING SourceDescriptor,
+                       CHAR *                     Message,
+                       UINT32                     MessageLength,
+                       UINT64                     TriggerTimestamp)
+{
+    CHAR *  Buffer;
+    UINT32  Tail;
+    BOOLEAN IsStopping;
+    BOOLEAN IsDropped = FALSE;
+
+    Buffer = (CHAR *)malloc(MessageLength);
+
+    if (Buffer == NULL)
+    {
+        return FALSE;
+    }
+
+    memcpy(Buffer, Message, MessageLength);
+
+    EnterCriticalSection(&SourceDescriptor->QueueLock);
+
+    switch (SourceDescriptor->Policy)
+    {
+    case EVENT_FORWARDING_POLICY_BLOCK:
+
+        //
+        // Wait for the writer thread to write the queued messages
+        //
+        while (SourceDescriptor->QueueCount == EVENT_FORWARDING_QUEUE_MAXIMUM_MESSAGES &&
+               !SourceDescriptor->IsWriterStopping)
+        {
+            SleepConditionVariableCS(&SourceDescriptor->QueueNotFull, &SourceDescriptor->QueueLock, INFINITE);
+        }
+
+        break;
+
+    case EVENT_FORWARDING_POLICY_DROP_OLDEST:
+
+        if (SourceDescriptor->QueueCount == EVENT_FORWARDING_QUEUE_MAXIMUM_MESSAGES)
+        {
+            free(SourceDescriptor->Queue[SourceDescriptor->QueueHead].Buffer);
+
+            SourceDescriptor->QueueHead = (SourceDescriptor->QueueHead + 1) % EVENT_FORWARDING_QUEUE_MAXIMUM_MESSAGES;
+            SourceDescriptor->QueueCount--;
+            SourceDescriptor->DroppedMessages++;
+        }
+
+        break;
+
+    case EVENT_FORWARDING_POLICY_SAMPLE:
+
+        if (SourceDescriptor->QueueCount < EVENT_FORWARDING_QUEUE_MAXIMUM_MESSAGES / 2)
+        {
+            SourceDescriptor->SampledMessages = 0;
+        }
+        else if (SourceDescriptor->SampledMessages++ % EVENT_FORWARDING_SAMPLING_RATE != 0)
+        {
+            IsDropped = TRUE;
+        }
+
+        break;
+
+    default:
+        break;
+    }
+
+    IsStopping = SourceDescriptor->IsWriterStopping;
+
+    if (IsDropped || IsStopping || SourceDescriptor->QueueCount == EVENT_FORWARDING_QUEUE_MAXIMUM_MESSAGES)
+    {
+        SourceDescriptor->DroppedMessages++;
+
+        LeaveCriticalSection(&SourceDescriptor->QueueLock);
+
+        free(Buffer);
+
+        //
+        // Dropping messages is the expected behavior of the policy
+        //
+        return !IsStopping;
+    }
+
+    Tail = (SourceDescriptor->QueueHead + SourceDescriptor->QueueCount) % EVENT_FORWARDING_QUEUE_MAXIMUM_MESSAGES;
+
+    SourceDescriptor->Queue[Tail].Buffer           = Buffer;
+    SourceDescriptor->Queue[Tail].Length           = MessageLength;
+    SourceDescriptor->Queue[Tail].TriggerTimestamp = TriggerTimestamp;
+    SourceDescriptor->Queue[Tail].QueuedTimestamp  = __rdtsc();
+    SourceDescriptor->QueueCount++;
+
+    WakeConditionVariable(&SourceDescriptor->QueueNotEmpty);
+
+    LeaveCriticalSection(&SourceDescriptor->QueueLock);
+
+    return TRUE;
+}
+
+/**
+ * @brief Write a batch of messages to the output source
+ * @param SourceDescriptor Descriptor of the source
+ * @param Messages The messages that should be written
+ * @param MessagesCount Count of the messages
+ * @details messages of files are written with a single write and messages
+ * of tcp sockets are sent with a single send, messages of namedpipes are
+ * sent separately as each write is a separate message for the server,
+ * records of binary files are accumulated in the blocks of the file and
+ * the reader of shared memory rings is notified once for each batch
+ *
+ * @return UINT32 count of the messages that are written
+ */
+static UINT32
+ForwardingWriteBatch(PDEBUGGER_EVENT_FORWARDING         SourceDescriptor,
+                     PDEBUGGER_EVENT_FORWARDING_MESSAGE Messages,
+                     UINT32                             MessagesCount)
+{
+    WSABUF Buffers[EVENT_FORWARDING_MAXIMUM_MESSAGES_IN_BATCH];
+    DWORD  SentBytes    = 0;
+    UINT32 WrittenCount = 0;
+    UINT32 TotalLength  = 0;
+    UINT32 Offset       = 0;
+    CHAR * Buffer       = NULL;
+
+    switch (SourceDescriptor->Type)
+    {
+    case EVENT_FORWARDING_FILE:
+
+        if (MessagesCount == 1)
+        {
+            return ForwardingWriteToFile(SourceDescriptor->Handle, Messages[0].Buffer, Messages[0].Length) ? 1 : 0;
+        }
+
+        for (UINT32 i = 0; i < MessagesCount; i++)
+        {
+            TotalLength += Messages[i].Length;
+        }
+
+        Buffer = (CHAR *)malloc(TotalLength);
+
+        if (Buffer == NULL)
+        {
+            return 0;
+        }
+
+        for (UINT32 i = 0; i < MessagesCount; i++)
+        {
+            memcpy(Buffer + Offset, Messages[i].Buffer, Messages[i].Length);
+            Offset += Messages[i].Length;
+        }
+
+        if (!ForwardingWriteToFile(SourceDescriptor->Handle, Buffer, TotalLength))
+        {
+            MessagesCount = 0;
+        }
+
+        free(Buffer);
+
+        return MessagesCount;
+
+    case EVENT_FORWARDING_BINARY_FILE:
+
+        for (UINT32 i = 0; i < MessagesCount; i++)
+        {
+            if (!BinaryOutputWriteMessage(SourceDescriptor->BinaryOutput, Messages[i].Buffer, Messages[i].Length))
+            {
+                return i;
+            }
+        }
+
+        return MessagesCount;
+
+    case EVENT_FORWARDING_SHARED_MEMORY:
+
+        for (UINT32 i = 0; i < MessagesCount; i++)
+        {
+            if (SharedMemoryOutputWriteMessage(SourceDescriptor->SharedMemoryOutput, Messages[i].Buffer, Messages[i].Length))
+            {
+                WrittenCount++;
+            }
+        }
+
+        SharedMemoryOutputSignal(SourceDescriptor->SharedMemoryOutput);
+
+        return WrittenCount;
+
+    case EVENT_FORWARDING_NAMEDPIPE:
+
+        for (UINT32 i = 0; i < MessagesCount; i++)
+        {
+            if (!ForwardingSendToNamedPipe(SourceDescriptor->Handle, Messages[i].Buffer, Messages[i].Length))
+            {
+                return i;
+            }
+        }
+
+        return MessagesCount;
+
+    case EVENT_FORWARDING_TCP:
+
+        for (UINT32 i = 0; i < MessagesCount; i++)
+        {
+            Buffers[i].buf = Messages[i].Buffer;
+            Buffers[i].len = Messages[i].Length;
+        }
+
+        if (WSASend(SourceDescriptor->Socket, Buffers, MessagesCount, &SentBytes, 0, NULL, NULL) == SOCKET_ERROR)
+        {
+            return 0;
+        }
+
+        return MessagesCount;
+
+    default:
+        break;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief The writer thread of an output source
+ * @details the queued messages are written in batches until the source
+ * is closed, the remaining messages are written before closing
+ *
+ * @param Parameter Descriptor of the source
+ *
+ * @return DWORD
+ */
+DWORD WINAPI
+ForwardingWriterThread(LPVOID Parameter)
+{
+    PDEBUGGER_EVENT_FORWARDING        SourceDescriptor = (PDEBUGGER_EVENT_FORWARDING)Parameter;
+    DEBUGGER_EVENT_FORWARDING_MESSAGE Batch[EVENT_FORWARDING_MAXIMUM_MESSAGES_IN_BATCH];
+    UINT32                            BatchCount;
+    UINT32                            WrittenCount;
+    UINT64                            WrittenTimestamp;
+
+    while (TRUE)
+    {
+        EnterCriticalSection(&SourceDescriptor->QueueLock);
+
+        while (SourceDescriptor->QueueCount == 0 && !SourceDescriptor->IsWriterStopping)
+        {
+            SleepConditionVariableCS(&SourceDescriptor->QueueNotEmpty, &SourceDescriptor->QueueLock, INFINITE);
+        }
+
+        if (SourceDescriptor->QueueCount == 0)
+        {
+            //
+            // The source is closed and all the messages are written
+            //
+            LeaveCriticalSection(&SourceDescriptor->QueueLock);
+            break;
+        }
+
+        //
+        // Take a batch of messages from the queue
+        //
+        BatchCount = min(SourceDescriptor->QueueCount, (UINT32)EVENT_FORWARDING_MAXIMUM_MESSAGES_IN_BATCH);
+
+        for (UINT32 i = 0; i < BatchCount; i++)
+        {
+            Batch[i] = SourceDescriptor->Queue[(SourceDescriptor->QueueHead + i) % EVENT_FORWARDING_QUEUE_MAXIMUM_MESSAGES];
+        }
+
+        SourceDescriptor->QueueHead = (SourceDescriptor->QueueHead + BatchCount) % EVENT_FORWARDING_QUEUE_MAXIMUM_MESSAGES;
+        SourceDescriptor->QueueCount -= BatchCount;
+
+        WakeAllConditionVariable(&SourceDescriptor->QueueNotFull);
+
+        LeaveCriticalSection(&SourceDescriptor->QueueLock);
+
+        //
+        // Write the batch (without holding the lock)
+        //
+        WrittenCount     = ForwardingWriteBatch(SourceDescriptor, Batch, BatchCount);
+        WrittenTimestamp = __rdtsc();
+
+        for (UINT32 i = 0; i < BatchCount; i++)
+        {
+            //
+            // Messages of a batch are considered written once the batch is written
+            //
+            if (i < WrittenCount && Batch[i].TriggerTimestamp != 0)
+            {
+                ForwardingRecordLatency(EVENT_FORWARDING_LATENCY_STAGE_FORWARDING_QUEUE, Batch[i].QueuedTimestamp, WrittenTimestamp);
+                ForwardingRecordLatency(EVENT_FORWARDING_LATENCY_STAGE_END_TO_END, Batch[i].TriggerTimestamp, WrittenTimestamp);
+            }
+
+            free(Batch[i].Buffer);
+        }
+
+        if (WrittenCount != BatchCount)
+        {
+            EnterCriticalSection(&SourceDescriptor->QueueLock);
+            SourceDescriptor->DroppedMessages += BatchCount - WrittenCount;
+            LeaveCriticalSection(&SourceDescriptor->QueueLock);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Get the bucket of a latency in the histograms
+ *
+ * @param Cycles The latency
+ *
+ * @return UINT32
+ */
+static UINT32
+ForwardingGetLatencyBucket(UINT64 Cycles)
+{
+    ULONG MostSignificantBit;
+
+    if (Cycles < (1ull << EVENT_FORWARDING_LATENCY_SUB_BUCKETS_BITS))
+    {
+        return (UINT32)Cycles;
+    }
+
+    _BitScanReverse64(&MostSignificantBit, Cycles);
+
+    return ((MostSignificantBit - EVENT_FORWARDING_LATENCY_SUB_BUCKETS_BITS + 1) << EVENT_FORWARDING_LATENCY_SUB_BUCKETS_BITS) +
+           (UINT32)((Cycles >> (MostSignificantBit - EVENT_FORWARDING_LATENCY_SUB_BUCKETS_BITS)) &
+                    ((1ull << EVENT_FORWARDING_LATENCY_SUB_BUCKETS_BITS) - 1));
+}
+
+/**
+ * @brief Get the largest latency of a bucket of the histograms
+ *
+ * @param Bucket
+ *
+ * @return UINT64
+ */
+static UINT64
+ForwardingGetLatencyBucketLimit(UINT32 Bucket)
+{
+    UINT32 Shift;
+    UINT64 SubBucket;
+
+    if (Bucket < (1u << EVENT_FORWARDING_LATENCY_SUB_BUCKETS_BITS))
+    {
+        return Bucket;
+    }
+
+    Shift     = (Bucket >> EVENT_FORWARDING_LATENCY_SUB_BUCKETS_BITS) - 1;
+    SubBucket = (Bucket & ((1u << EVENT_FORWARDING_LATENCY_SUB_BUCKETS_BITS) - 1)) + (1ull << EVENT_FORWARDING_LATENCY_SUB_BUCKETS_BITS);
+
+    return ((SubBucket + 1) << Shift) - 1;
+}
+
+/**
+ * @brief Record the latency of a stage of delivering a message
+ * @details it's called by the thread of reading the kernel messages and
+ * the writer threads of the sources
+ *
+ * @param Stage The stage
+ * @param StartTimestamp Time-stamp counter of the start of the stage
+ * @param EndTimestamp Time-stamp counter of the end of the stage
+ *
+ * @return VOID
+ */
+VOID
+ForwardingRecordLatency(EVENT_FORWARDING_LATENCY_STAGE Stage, UINT64 StartTimestamp, UINT64 EndTimestamp)
+{
+    //
+    // Counters of different cores might be slightly different
+    //
+    UINT64 Cycles = EndTimestamp > StartTimestamp ? EndTimestamp - StartTimestamp : 0;
+
+    InterlockedIncrement64(&g_EventForwardingLatency[Stage].Buckets[ForwardingGetLatencyBucket(Cycles)]);
+    InterlockedIncrement64(&g_EventForwardingLatency[Stage].Count);
+}
+
+/**
+ * @brief Get a percentile of the latency of a stage of delivering messages
+ * @details the result is the upper limit of the bucket of the percentile
+ * (the error is less than 1/8 of the latency)
+ *
+ * @param Stage The stage
+ * @param Percentile The percentile (1 to 100)
+ *
+ * @return UINT64 The latency in cycles (zero if there is no sample)
+ */
+UINT64
+ForwardingGetLatencyPercentile(EVENT_FORWARDING_LATENCY_STAGE Stage, UINT32 Percentile)
+{
+    UINT64 Count = g_EventForwardingLatency[Stage].Count;
+    UINT64 Target;
+    UINT64 Accumulated = 0;
+
+    if (Count == 0)
+    {
+        return 0;
+    }
+
+    Target = (Count * Percentile + 99) / 100;
+
+    for (UINT32 i = 0; i < EVENT_FORWARDING_LATENCY_BUCKETS; i++)
+    {
+        Accumulated += g_EventForwardingLatency[Stage].Buckets[i];
+
+        if (Accumulated >= Target)
+        {
+            return ForwardingGetLatencyBucketLimit(i);
+        }
+    }
+
+    //
+    // Samples are added while the buckets are read
+    //
+    return ForwardingGetLatencyBucketLimit(EVENT_FORWARDING_LATENCY_BUCKETS - 1);
+}
+
+/**
+ * @brief Remove the samples of the latency of all stages
+ *
+ * @return VOID
+ */
+VOID
+ForwardingResetLatency()
+{
+    for (UINT32 i = 0; i < EVENT_FORWARDING_LATENCY_STAGES_COUNT; i++)
+    {
+        for (UINT32 j = 0; j < EVENT_FORWARDING_LATENCY_BUCKETS; j++)
+        {
+            InterlockedExchange64(&g_EventForwardingLatency[i].Buckets[j], 0);
+        }
+
+        InterlockedExchange64(&g_EventForwardingLatency[i].Count, 0);
+    }
+}
+
 /**
  * @brief Write the output results to the file
  * @param FileHandle Handle of the target file
@@ -0,0 +1,382 @@
+/**
+ * @file message-lanes.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Lanes of showing messages (interactive and bulk)
+ * @details bulk messages of events are queued and shown by a writer
+ * thread, so the results of commands are not stuck behind the trace
+ * data of events
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_BreakPrintingOutput;
+
+/**
+ * @brief The state of the lanes of showing messages
+ *
+ */
+static MESSAGE_LANES_STATE g_MessageLanes = {0};
+
+/**
+ * @brief Initialization of the lanes is performed once (by the first
+ * bulk message)
+ *
+ */
+static INIT_ONCE g_MessageLanesInitOnce = INIT_ONCE_STATIC_INIT;
+
+/**
+ * @brief Check whether the bulk messages should be held for the
+ * interactive messages
+ * @details should be called while the lock of the lanes is held
+ *
+ * @param HoldStart The tick count of the start of holding (zero if
+ * the bulk messages are not held)
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+MessageLanesShouldHoldBulk(ULONG64 * HoldStart)
+{
+    ULONG64 Now = GetTickCount64();
+
+    if (g_MessageLanes.InteractiveCommands == 0 &&
+        Now - g_MessageLanes.LastInteractiveMessage >= MESSAGE_LANES_INTERACTIVE_HOLD_INTERVAL)
+    {
+        *HoldStart = 0;
+        return FALSE;
+    }
+
+    //
+    // The bulk messages are not held if the queue is going to be full,
+    // or they are already held for the maximum time (they're shown till
+    // there is no interactive message)
+    //
+    if (g_MessageLanes.BulkQueueCount >= MESSAGE_LANES_BULK_QUEUE_SIZE / 2)
+    {
+        return FALSE;
+    }
+
+    if (*HoldStart == 0)
+    {
+        *HoldStart = Now;
+    }
+
+    return Now - *HoldStart < MESSAGE_LANES_MAXIMUM_HOLD_TIME;
+}
+
+/**
+ * @brief Show the bulk messages that are taken from the queue
+ * @details consecutive messages are shown together
+ *
+ * @param Batch The messages
+ * @param BatchCount Count of the messages
+ *
+ * @return VOID
+ */
+static VOID
+MessageLanesShowBatch(CHAR ** Batch, UINT32 BatchCount)
+{
+    CHAR   Chunk[PacketChunkSize];
+    UINT32 ChunkLength = 0;
+    UINT32 MessageLength;
+
+    for (UINT32 i = 0; i < BatchCount; i++)
+    {
+        //
+        // CTRL+C or CTRL+BREAK discards the queued messages
+        //
+        if (!g_BreakPrintingOutput)
+        {
+            MessageLength = (UINT32)strlen(Batch[i]);
+
+            if (ChunkLength != 0 && ChunkLength + MessageLength >= sizeof(Chunk))
+            {
+                Chunk[ChunkLength] = '\0';
+                ShowMessages("%s", Chunk);
+                ChunkLength = 0;
+            }
+
+            if (MessageLength >= sizeof(Chunk))
+            {
+                ShowMessages("%s", Batch[i]);
+            }
+            else
+            {
+                memcpy(Chunk + ChunkLength, Batch[i], MessageLength);
+                ChunkLength += MessageLength;
+            }
+        }
+
+        free(Batch[i]);
+    }
+
+    if (ChunkLength != 0)
+    {
+        Chunk[ChunkLength] = '\0';
+        ShowMessages("%s", Chunk);
+    }
+}
+
+/**
+ * @brief The writer thread of the bulk messages
+ *
+ * @param Parameter
+ *
+ * @return DWORD
+ */
+static DWORD WINAPI
+MessageLanesWriterThread(LPVOID Parameter)
+{
+    CHAR *  Batch[MESSAGE_LANES_BULK_BATCH_SIZE];
+    UINT32  BatchCount;
+    ULONG64 HoldStart = 0;
+
+    UNREFERENCED_PARAMETER(Parameter);
+
+    EnterCriticalSection(&g_MessageLanes.Lock);
+
+    while (TRUE)
+    {
+        while (g_MessageLanes.BulkQueueCount == 0 && !g_MessageLanes.IsStopping)
+        {
+            SleepConditionVariableCS(&g_MessageLanes.NotEmpty, &g_MessageLanes.Lock, INFINITE);
+        }
+
+        if (g_MessageLanes.BulkQueueCount == 0)
+        {
+            //
+            // Stopped and all the messages are shown
+            //
+            break;
+        }
+
+        if (!g_MessageLanes.IsStopping && MessageLanesShouldHoldBulk(&HoldStart))
+        {
+            LeaveCriticalSection(&g_MessageLanes.Lock);
+            Sleep(1);
+            EnterCriticalSection(&g_MessageLanes.Lock);
+
+            continue;
+        }
+
+        for (BatchCount = 0; BatchCount < MESSAGE_LANES_BULK_BATCH_SIZE && g_MessageLanes.BulkQueueCount != 0; BatchCount++)
+        {
+            Batch[BatchCount] = g_MessageLanes.BulkQueue[g_MessageLanes.BulkQueueHead];
+
+            g_MessageLanes.BulkQueueHead = (g_MessageLanes.BulkQueueHead + 1) % MESSAGE_LANES_BULK_QUEUE_SIZE;
+            g_MessageLanes.BulkQueueCount--;
+        }
+
+        g_MessageLanes.IsWriting = TRUE;
+        WakeAllConditionVariable(&g_MessageLanes.NotFull);
+
+        LeaveCriticalSection(&g_MessageLanes.Lock);
+
+        MessageLanesShowBatch(Batch, BatchCount);
+
+        EnterCriticalSection(&g_MessageLanes.Lock);
+
+        g_MessageLanes.IsWriting = FALSE;
+
+        if (g_MessageLanes.BulkQueueCount == 0)
+        {
+            WakeAllConditionVariable(&g_MessageLanes.Drained);
+        }
+    }
+
+    WakeAllConditionVariable(&g_MessageLanes.Drained);
+    LeaveCriticalSection(&g_MessageLanes.Lock);
+
+    return 0;
+}
+
+/**
+ * @brief Initialize the lanes and start the writer thread of the
+ * bulk messages
+ *
+ * @param InitOnce
+ * @param Parameter
+ * @param Context
+ *
+ * @return BOOL
+ */
+static BOOL CALLBACK
+MessageLanesInitialize(PINIT_ONCE InitOnce, PVOID Parameter, PVOID * Context)
+{
+    UNREFERENCED_PARAMETER(InitOnce);
+    UNREFERENCED_PARAMETER(Parameter);
+    UNREFERENCED_PARAMETER(Context);
+
+    InitializeCriticalSection(&g_MessageLanes.Lock);
+    InitializeConditionVariable(&g_MessageLanes.NotEmpty);
+    InitializeConditionVariable(&g_MessageLanes.NotFull);
+    InitializeConditionVariable(&g_MessageLanes.Drained);
+
+    g_MessageLanes.WriterThread = CreateThread(NULL,
+                                               0,
+                                               MessageLanesWriterThread,
+                                               NULL,
+                                               0,
+                                               &g_MessageLanes.WriterThreadId);
+
+    if (g_MessageLanes.WriterThread == NULL)
+    {
+        DeleteCriticalSection(&g_MessageLanes.Lock);
+        return FALSE;
+    }
+
+    g_MessageLanes.IsInitialized = TRUE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Show a bulk message (a message of an event)
+ * @details the message is copied to the queue of the bulk messages, if
+ * the queue is full, the caller waits for the writer
+ *
+ * @param Message The message (null-terminated)
+ *
+ * @return VOID
+ */
+VOID
+MessageLanesShowBulkMessage(const CHAR * Message)
+{
+    CHAR * MessageCopy;
+    SIZE_T MessageLength = strlen(Message) + 1;
+
+    //
+    // The messages are shown directly if the writer is not available
+    //
+    if (!InitOnceExecuteOnce(&g_MessageLanesInitOnce, MessageLanesInitialize, NULL, NULL) ||
+        (MessageCopy = (CHAR *)malloc(MessageLength)) == NULL)
+    {
+        ShowMessages("%s", Message);
+        return;
+    }
+
+    memcpy(MessageCopy, Message, MessageLength);
+
+    EnterCriticalSection(&g_MessageLanes.Lock);
+
+    while (g_MessageLanes.BulkQueueCount == MESSAGE_LANES_BULK_QUEUE_SIZE && !g_MessageLanes.IsStopping)
+    {
+        SleepConditionVariableCS(&g_MessageLanes.NotFull, &g_MessageLanes.Lock, INFINITE);
+    }
+
+    if (g_MessageLanes.IsStopping)
+    {
+        LeaveCriticalSection(&g_MessageLanes.Lock);
+
+        free(MessageCopy);
+        ShowMessages("%s", Message);
+
+        return;
+    }
+
+    g_MessageLanes.BulkQueue[(g_MessageLanes.BulkQueueHead + g_MessageLanes.BulkQueueCount) % MESSAGE_LANES_BULK_QUEUE_SIZE] = MessageCopy;
+    g_MessageLanes.BulkQueueCount++;
+
+    WakeConditionVariable(&g_MessageLanes.NotEmpty);
+
+    LeaveCriticalSection(&g_MessageLanes.Lock);
+}
+
+/**
+ * @brief Notify the lanes that an interactive message is shown
+ * @details called by ShowMessages, messages of the writer thread are
+ * the bulk messages
+ *
+ * @return VOID
+ */
+VOID
+MessageLanesNotifyInteractiveMessage()
+{
+    if (g_MessageLanes.IsInitialized && GetCurrentThreadId() != g_MessageLanes.WriterThreadId)
+    {
+        g_MessageLanes.LastInteractiveMessage = GetTickCount64();
+    }
+}
+
+/**
+ * @brief Start of executing an interactive command
+ * @details bulk messages are held (up to a limit) till the command
+ * is finished
+ *
+ * @return VOID
+ */
+VOID
+MessageLanesBeginInteractiveCommand()
+{
+    InterlockedIncrement(&g_MessageLanes.InteractiveCommands);
+}
+
+/**
+ * @brief End of executing an interactive command
+ *
+ * @return VOID
+ */
+VOID
+MessageLanesEndInteractiveCommand()
+{
+    InterlockedDecrement(&g_MessageLanes.InteractiveCommands);
+}
+
+/**
+ * @brief Wait till all the queued bulk messages are shown
+ *
+ * @return VOID
+ */
+VOID
+MessageLanesFlush()
+{
+    if (!g_MessageLanes.IsInitialized || GetCurrentThreadId() == g_MessageLanes.WriterThreadId)
+    {
+        return;
+    }
+
+    EnterCriticalSection(&g_MessageLanes.Lock);
+
+    while (g_MessageLanes.BulkQueueCount != 0 || g_MessageLanes.IsWriting)
+    {
+        SleepConditionVariableCS(&g_MessageLanes.Drained, &g_MessageLanes.Lock, INFINITE);
+    }
+
+    LeaveCriticalSection(&g_MessageLanes.Lock);
+}
+
+/**
+ * @brief Show the remaining bulk messages and stop the writer thread
+ *
+ * @return VOID
+ */
+VOID
+MessageLanesUninitialize()
+{
+    if (!g_MessageLanes.IsInitialized)
+    {
+        return;
+    }
+
+    EnterCriticalSection(&g_MessageLanes.Lock);
+
+    g_MessageLanes.IsStopping = TRUE;
+
+    WakeAllConditionVariable(&g_MessageLanes.NotEmpty);
+    WakeAllConditionVariable(&g_MessageLanes.NotFull);
+
+    LeaveCriticalSection(&g_MessageLanes.Lock);
+
+    WaitForSingleObject(g_MessageLanes.WriterThread, INFINITE);
+    CloseHandle(g_MessageLanes.WriterThread);
+
+    g_MessageLanes.WriterThread  = NULL;
+    g_MessageLanes.IsInitialized = FALSE;
+}
@@ -11,12 +11,6 @@
  */
 #include "pch.h"
 
-//
-// Global Variables
-//
-extern OVERLAPPED g_OverlappedIoStructureForReadDebugger;
-extern OVERLAPPED g_OverlappedIoStructureForWriteDebugger;
-
 ////////////////////////////////////////////////////////////////////////////
 //                                                                        //
 //                            Server Side                                 //
@@ -265,17 +259,8 @@ NamedPipeClientCreatePipeOverlappedIo(LPCSTR PipeName)
     else
     {
         //
-        // Create event for overlapped I/O (Read)
+        // The pipe is served by the I/O thread (overlapped I/O)
         //
-        g_OverlappedIoStructureForReadDebugger.hEvent =
-            CreateEvent(NULL, TRUE, FALSE, NULL);
-
-        //
-        // Create event for overlapped I/O (Write)
-        //
-        g_OverlappedIoStructureForWriteDebugger.hEvent =
-            CreateEvent(NULL, TRUE, FALSE, NULL);
-
         return hPipe;
     }
 }
@@ -14,32 +14,500 @@
 //
 // Global Variables
 //
-extern BYTE g_EndOfBufferCheckTcp[TCP_END_OF_BUFFER_CHARS_COUNT];
-
 extern BOOLEAN g_IsConnectedToHyperDbgLocally;
 extern BOOLEAN g_IsConnectedToRemoteDebuggee;
 extern BOOLEAN g_IsConnectedToRemoteDebugger;
 extern BOOLEAN g_BreakPrintingOutput;
-extern BOOLEAN g_IsEndOfMessageReceived;
+extern UINT32  g_RemoteConnectionFlushInterval;
+extern UINT32  g_RemoteConnectionMaximumBatchSize;
+extern string  g_ServerPort;
+extern string  g_ServerIp;
 
 extern SOCKET g_SeverSocket;
 extern SOCKET g_ServerListenSocket;
-extern SOCKET g_ClientConnectSocket;
 
-extern HANDLE g_RemoteDebuggeeListeningThread;
-extern HANDLE g_EndOfMessageReceivedEvent;
+extern TRANSPORT_CHANNEL           g_RemoteConnectionTransportChannel;
+extern REMOTE_CONNECTION_COALESCER g_RemoteConnectionCoalescer;
+extern REMOTE_CONNECTION_OBSERVER  g_RemoteConnectionObservers[REMOTE_CONNECTION_MAXIMUM_OBSERVERS];
+extern HANDLE                      g_RemoteConnectionAcceptThread;
+extern REMOTE_CONNECTION_SESSION   g_RemoteConnectionSessions[REMOTE_CONNECTION_MAXIMUM_SESSIONS];
+extern PREMOTE_CONNECTION_SESSION  g_RemoteConnectionActiveSession;
+extern SRWLOCK                     g_RemoteConnectionSessionsLock;
+
+/**
+ * @brief Disable the Nagle algorithm of the socket of the remote connection
+ * @details the results are coalesced by the debuggee and the commands
+ * are interactive, so delaying the small segments only adds latency
+ *
+ * @param Socket
+ * @return VOID
+ */
+static VOID
+RemoteConnectionDisableNagle(SOCKET Socket)
+{
+    BOOL NoDelay = TRUE;
+
+    setsockopt(Socket, IPPROTO_TCP, TCP_NODELAY, (const char *)&NoDelay, sizeof(NoDelay));
+}
+
+/**
+ * @brief Send a frame over the remote connection
+ *
+ * @param Channel
+ * @param Type Type of the frame
+ * @param Payload
+ * @param Length Length of the payload
+ * @return BOOLEAN
+ */
+static BOOLEAN
+RemoteConnectionSendFrame(PTRANSPORT_CHANNEL Channel, REMOTE_CONNECTION_FRAME_TYPE Type, const char * Payload, UINT32 Length)
+{
+    REMOTE_CONNECTION_FRAME_HEADER Header = {0};
+
+    Header.Length = Length;
+    Header.Type   = Type;
+
+    return TransportSend(Channel,
+                         (const CHAR *)&Header,
+                         sizeof(REMOTE_CONNECTION_FRAME_HEADER),
+                         Payload,
+                         Length,
+                         NULL,
+                         0);
+}
+
+/**
+ * @brief Receive exactly the specified count of bytes from the remote connection
+ *
+ * @param Channel
+ * @param Buffer
+ * @param Length
+ * @return BOOLEAN Returns FALSE if the connection is closed
+ */
+static BOOLEAN
+RemoteConnectionReceiveExact(PTRANSPORT_CHANNEL Channel, BYTE * Buffer, UINT32 Length)
+{
+    UINT32 ReceivedLength;
+
+    while (Length != 0)
+    {
+        if (!TransportReceive(Channel, Buffer, Length, &ReceivedLength))
+        {
+            return FALSE;
+        }
+
+        Buffer += ReceivedLength;
+        Length -= ReceivedLength;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Receive a frame from the remote connection
+ * @details the payload is null-terminated
+ *
+ * @param Channel
+ * @param Header
+ * @param Payload
+ * @return BOOLEAN Returns FALSE if the connection is closed or the
+ * frame is invalid
+ */
+static BOOLEAN
+RemoteConnectionReceiveFrame(PTRANSPORT_CHANNEL Channel, PREMOTE_CONNECTION_FRAME_HEADER Header, std::vector<CHAR> & Payload)
+{
+    if (!RemoteConnectionReceiveExact(Channel, (BYTE *)Header, sizeof(REMOTE_CONNECTION_FRAME_HEADER)) ||
+        Header->Length > REMOTE_CONNECTION_MAXIMUM_FRAME_SIZE)
+    {
+        return FALSE;
+    }
+
+    Payload.resize(Header->Length + 1);
+    Payload[Header->Length] = '\0';
+
+    return RemoteConnectionReceiveExact(Channel, (BYTE *)Payload.data(), Header->Length);
+}
+
+/**
+ * @brief Send the coalesced results to the debugger
+ * @details the lock of the coalescer should be held
+ *
+ * @param IsEndOfResults Whether the end of results frame should be sent
+ * after the results
+ * @return BOOLEAN
+ */
+static BOOLEAN
+RemoteConnectionFlushResults(BOOLEAN IsEndOfResults)
+{
+    REMOTE_CONNECTION_FRAME_HEADER Header    = {0};
+    REMOTE_CONNECTION_FRAME_HEADER EndHeader = {0};
+    BOOLEAN                        Result    = TRUE;
+    PREMOTE_CONNECTION_OBSERVER    Observer;
+
+    EndHeader.Type = REMOTE_CONNECTION_FRAME_END_OF_RESULTS;
+
+    if (!g_RemoteConnectionCoalescer.Results.empty())
+    {
+        Header.Length = (UINT32)g_RemoteConnectionCoalescer.Results.size();
+        Header.Type   = REMOTE_CONNECTION_FRAME_RESULTS;
+
+        //
+        // The results and the end of results are sent as a single buffer
+        //
+        Result = TransportSend(&g_RemoteConnectionTransportChannel,
+                               (const CHAR *)&Header,
+                               sizeof(REMOTE_CONNECTION_FRAME_HEADER),
+                               g_RemoteConnectionCoalescer.Results.data(),
+                               Header.Length,
+                               (const CHAR *)&EndHeader,
+                               IsEndOfResults ? sizeof(REMOTE_CONNECTION_FRAME_HEADER) : 0);
+
+        //
+        // The same results are sent to the read-only clients, so the
+        // messages are still read (from the kernel) and formatted once
+        //
+        for (UINT32 i = 0; i < REMOTE_CONNECTION_MAXIMUM_OBSERVERS; i++)
+        {
+            Observer = &g_RemoteConnectionObservers[i];
+
+            if (!Observer->IsOpened)
+            {
+                continue;
+            }
+
+            //
+            // A slow client doesn't block (or grow the memory of) the others
+            //
+            if (TransportGetQueuedBuffersCount(&Observer->Channel) >= REMOTE_CONNECTION_MAXIMUM_OBSERVER_QUEUED_FRAMES)
+            {
+                Observer->DroppedFrames++;
+                continue;
+            }
+
+            RemoteConnectionSendFrame(&Observer->Channel,
+                                      REMOTE_CONNECTION_FRAME_RESULTS,
+                                      g_RemoteConnectionCoalescer.Results.data(),
+                                      Header.Length);
+        }
+
+        g_RemoteConnectionCoalescer.Results.clear();
+    }
+    else if (IsEndOfResults)
+    {
+        Result = RemoteConnectionSendFrame(&g_RemoteConnectionTransportChannel, REMOTE_CONNECTION_FRAME_END_OF_RESULTS, NULL, 0);
+    }
+
+    return Result;
+}
+
+/**
+ * @brief The thread that sends the coalesced results once the flush
+ * interval is passed
+ *
+ * @param lpParam
+ * @return DWORD
+ */
+static DWORD WINAPI
+RemoteConnectionFlushThread(LPVOID lpParam)
+{
+    UNREFERENCED_PARAMETER(lpParam);
+
+    EnterCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
+    while (!g_RemoteConnectionCoalescer.IsStopping)
+    {
+        if (g_RemoteConnectionCoalescer.Results.empty())
+        {
+            SleepConditionVariableCS(&g_RemoteConnectionCoalescer.ResultsQueued,
+                                     &g_RemoteConnectionCoalescer.Lock,
+                                     INFINITE);
+            continue;
+        }
+
+        //
+        // Wait for more results to be coalesced
+        //
+        SleepConditionVariableCS(&g_RemoteConnectionCoalescer.ResultsQueued,
+                                 &g_RemoteConnectionCoalescer.Lock,
+                                 g_RemoteConnectionFlushInterval);
+
+        RemoteConnectionFlushResults(FALSE);
+    }
+
+    RemoteConnectionFlushResults(FALSE);
+
+    LeaveCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
+    return 0;
+}
+
+/**
+ * @brief Start coalescing the results of the remote debuggee
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+RemoteConnectionStartCoalescer()
+{
+    //
+    // The lock is not deleted as the results might be sent (and
+    // rejected) after the connection is closed
+    //
+    if (!g_RemoteConnectionCoalescer.IsLockInitialized)
+    {
+        InitializeCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+        InitializeConditionVariable(&g_RemoteConnectionCoalescer.ResultsQueued);
+
+        g_RemoteConnectionCoalescer.IsLockInitialized = TRUE;
+    }
+
+    g_RemoteConnectionCoalescer.IsStopping = FALSE;
+    g_RemoteConnectionCoalescer.Results.clear();
+
+    g_RemoteConnectionCoalescer.FlushThread = CreateThread(NULL, 0, RemoteConnectionFlushThread, NULL, 0, NULL);
+
+    return g_RemoteConnectionCoalescer.FlushThread != NULL;
+}
+
+/**
+ * @brief Send the remaining results and stop coalescing the results
+ *
+ * @return VOID
+ */
+static VOID
+RemoteConnectionStopCoalescer()
+{
+    if (g_RemoteConnectionCoalescer.FlushThread == NULL)
+    {
+        return;
+    }
+
+    EnterCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
+    g_RemoteConnectionCoalescer.IsStopping = TRUE;
+    WakeAllConditionVariable(&g_RemoteConnectionCoalescer.ResultsQueued);
+
+    LeaveCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
+    WaitForSingleObject(g_RemoteConnectionCoalescer.FlushThread, INFINITE);
+    CloseHandle(g_RemoteConnectionCoalescer.FlushThread);
+
+    g_RemoteConnectionCoalescer.FlushThread = NULL;
+}
+
+/**
+ * @brief The thread that serves a read-only client of the multi-client server
+ * @details the commands of the client are rejected, the client is
+ * closed by this thread once the connection is closed
+ *
+ * @param lpParam The observer
+ * @return DWORD
+ */
+static DWORD WINAPI
+RemoteConnectionObserverThread(LPVOID lpParam)
+{
+    PREMOTE_CONNECTION_OBSERVER    Observer    = (PREMOTE_CONNECTION_OBSERVER)lpParam;
+    REMOTE_CONNECTION_FRAME_HEADER FrameHeader = {0};
+    const char *                   Rejected    = "err, this is a read-only client, the commands are not executed\n";
+    std::vector<CHAR>              Command;
+
+    while (RemoteConnectionReceiveFrame(&Observer->Channel, &FrameHeader, Command))
+    {
+        if (FrameHeader.Type != REMOTE_CONNECTION_FRAME_COMMAND)
+        {
+            continue;
+        }
+
+        //
+        // The client waits for the end of results of each command
+        //
+        RemoteConnectionSendFrame(&Observer->Channel, REMOTE_CONNECTION_FRAME_RESULTS, Rejected, (UINT32)strlen(Rejected));
+        RemoteConnectionSendFrame(&Observer->Channel, REMOTE_CONNECTION_FRAME_END_OF_RESULTS, NULL, 0);
+    }
+
+    //
+    // Stop sending the results to the client
+    //
+    EnterCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+    Observer->IsOpened = FALSE;
+    LeaveCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
+    TransportCloseChannel(&Observer->Channel);
+    closesocket(Observer->Socket);
+
+    if (Observer->DroppedFrames != 0)
+    {
+        ShowMessages("read-only client disconnected (%llu frames of results were dropped)\n", Observer->DroppedFrames);
+    }
+    else
+    {
+        ShowMessages("read-only client disconnected\n");
+    }
+
+    EnterCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+    Observer->IsUsed = FALSE;
+    LeaveCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
+    return 0;
+}
+
+/**
+ * @brief The thread that accepts the read-only clients of the multi-client
+ * server till the listening socket is closed
+ *
+ * @param lpParam
+ * @return DWORD
+ */
+static DWORD WINAPI
+RemoteConnectionAcceptThread(LPVOID lpParam)
+{
+    PREMOTE_CONNECTION_OBSERVER Observer;
+    SOCKET                      ClientSocket;
+    const char *                Connected = "connected as a read-only client, the results of the commands of "
+                                            "the controlling client are shown\n";
+
+    UNREFERENCED_PARAMETER(lpParam);
+
+    while (CommunicationServerAcceptClient(g_ServerListenSocket, &ClientSocket) == 0)
+    {
+        Observer = NULL;
+
+        EnterCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
+        for (UINT32 i = 0; i < REMOTE_CONNECTION_MAXIMUM_OBSERVERS; i++)
+        {
+            if (!g_RemoteConnectionObservers[i].IsUsed)
+            {
+                Observer         = &g_RemoteConnectionObservers[i];
+                Observer->IsUsed = TRUE;
+                break;
+            }
+        }
+
+        LeaveCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
+        if (Observer == NULL)
+        {
+            ShowMessages("err, the maximum count of read-only clients (%d) is reached\n",
+                         REMOTE_CONNECTION_MAXIMUM_OBSERVERS);
+            closesocket(ClientSocket);
+            continue;
+        }
+
+        //
+        // Wait for the previous client of this slot to be completely closed
+        //
+        if (Observer->Thread != NULL)
+        {
+            WaitForSingleObject(Observer->Thread, INFINITE);
+            CloseHandle(Observer->Thread);
+            Observer->Thread = NULL;
+        }
+
+        RemoteConnectionDisableNagle(ClientSocket);
+
+        Observer->Socket        = ClientSocket;
+        Observer->DroppedFrames = 0;
+
+        if (!TransportOpenChannel(&Observer->Channel, (HANDLE)ClientSocket, TRUE, 0))
+        {
+            closesocket(ClientSocket);
+            Observer->IsUsed = FALSE;
+            continue;
+        }
+
+        RemoteConnectionSendFrame(&Observer->Channel, REMOTE_CONNECTION_FRAME_RESULTS, Connected, (UINT32)strlen(Connected));
+
+        EnterCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+        Observer->IsOpened = TRUE;
+        LeaveCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
+        Observer->Thread = CreateThread(NULL, 0, RemoteConnectionObserverThread, Observer, 0, NULL);
+
+        if (Observer->Thread == NULL)
+        {
+            EnterCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+            Observer->IsOpened = FALSE;
+            LeaveCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
+            TransportCloseChannel(&Observer->Channel);
+            closesocket(ClientSocket);
+
+            Observer->IsUsed = FALSE;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Stop accepting the read-only clients and close the connected
+ * read-only clients
+ *
+ * @return VOID
+ */
+static VOID
+RemoteConnectionCloseObservers()
+{
+    if (g_RemoteConnectionAcceptThread == NULL)
+    {
+        return;
+    }
+
+    //
+    // Closing the listening socket fails the pending accept
+    //
+    closesocket(g_ServerListenSocket);
+    g_ServerListenSocket = INVALID_SOCKET;
+
+    WaitForSingleObject(g_RemoteConnectionAcceptThread, INFINITE);
+    CloseHandle(g_RemoteConnectionAcceptThread);
+
+    g_RemoteConnectionAcceptThread = NULL;
+
+    //
+    // Shutting down the connections completes the pending receives, so the
+    // thread of each client closes the client
+    //
+    EnterCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
+    for (UINT32 i = 0; i < REMOTE_CONNECTION_MAXIMUM_OBSERVERS; i++)
+    {
+        if (g_RemoteConnectionObservers[i].IsOpened)
+        {
+            shutdown(g_RemoteConnectionObservers[i].Socket, SD_BOTH);
+        }
+    }
+
+    LeaveCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
+    for (UINT32 i = 0; i < REMOTE_CONNECTION_MAXIMUM_OBSERVERS; i++)
+    {
+        if (g_RemoteConnectionObservers[i].Thread != NULL)
+        {
+            WaitForSingleObject(g_RemoteConnectionObservers[i].Thread, INFINITE);
+            CloseHandle(g_RemoteConnectionObservers[i].Thread);
+
+            g_RemoteConnectionObservers[i].Thread = NULL;
+        }
+    }
+}
 
 /**
  * @brief Listen of a port and wait for a client connection
- * @details this routine is supposed to be called by .listen command
+ * @details this routine is supposed to be called by .listen command,
+ * in the multi-client mode, the first client controls the debugger and
+ * other clients only receive the results
  *
  * @param Port
+ * @param IsMultiClient Whether read-only clients are accepted
  * @return VOID
  */
 VOID
-RemoteConnectionListen(PCSTR Port)
+RemoteConnectionListen(PCSTR Port, BOOLEAN IsMultiClient)
 {
-    char recvbuf[COMMUNICATION_BUFFER_SIZE] = {0};
+    REMOTE_CONNECTION_FRAME_HEADER FrameHeader = {0};
+    std::vector<CHAR>              Command;
 
     //
     // Check if the debugger or debuggee is already active
@@ -54,6 +522,43 @@ RemoteConnectionListen(PCSTR Port)
     //
     CommunicationServerCreateServerAndWaitForClient(Port, &g_SeverSocket, &g_ServerListenSocket);
 
+    RemoteConnectionDisableNagle(g_SeverSocket);
+
+    //
+    // Serve the connection by the I/O thread, so the results (and the
+    // messages) are sent without blocking the execution of the commands
+    //
+    if (!TransportOpenChannel(&g_RemoteConnectionTransportChannel, (HANDLE)g_SeverSocket, TRUE, 0))
+    {
+        CommunicationServerShutdownAndCleanupConnection(g_SeverSocket,
+                                                        g_ServerListenSocket);
+        return;
+    }
+
+    //
+    // The results are coalesced and sent by the flush thread
+    //
+    if (!RemoteConnectionStartCoalescer())
+    {
+        TransportCloseChannel(&g_RemoteConnectionTransportChannel);
+        CommunicationServerShutdownAndCleanupConnection(g_SeverSocket,
+                                                        g_ServerListenSocket);
+        return;
+    }
+
+    //
+    // Accept the read-only clients after the controlling client
+    //
+    if (IsMultiClient)
+    {
+        g_RemoteConnectionAcceptThread = CreateThread(NULL, 0, RemoteConnectionAcceptThread, NULL, 0, NULL);
+
+        if (g_RemoteConnectionAcceptThread == NULL)
+        {
+            ShowMessages("err, unable to accept the read-only clients\n");
+        }
+    }
+
     //
     // Indicate that it's a remote debugger
     //
@@ -71,23 +576,29 @@ RemoteConnectionListen(PCSTR Port)
         // we don't send the results to the remote machine by using
         // this tools
         //
-        if (CommunicationServerReceiveMessage(g_SeverSocket, recvbuf, COMMUNICATION_BUFFER_SIZE) != 0)
+        if (!RemoteConnectionReceiveFrame(&g_RemoteConnectionTransportChannel, &FrameHeader, Command))
         {
             //
-            // Failed, break
+            // Failed (or the connection is closed), break
             //
             break;
         }
 
+        if (FrameHeader.Type != REMOTE_CONNECTION_FRAME_COMMAND)
+        {
+            continue;
+        }
+
         //
         // Execute the command
         //
-        int CommandExecutionResult = HyperDbgInterpreter(recvbuf);
+        int CommandExecutionResult = HyperDbgInterpreter(Command.data());
 
         //
-        // Send end of buffer
+        // Send the results (without waiting for the flush interval) and
+        // the end of results
         //
-        RemoteConnectionSendResultsToHost((const char *)g_EndOfBufferCheckTcp, sizeof(g_EndOfBufferCheckTcp));
+        RemoteConnectionSendEndOfResultsToHost();
 
         //
         // if the debugger encounters an exit state then the return will be 1
@@ -99,11 +610,6 @@ RemoteConnectionListen(PCSTR Port)
             //
             exit(0);
         }
-
-        //
-        // Zero the buffer for next command
-        //
-        RtlZeroMemory(recvbuf, COMMUNICATION_BUFFER_SIZE);
     }
 
     //
@@ -122,118 +628,214 @@ RemoteConnectionListen(PCSTR Port)
     ShowMessages("closing the conntection...\n");
 
     //
-    // Close the connection
+    // Close the connection (and the read-only clients)
     //
+    RemoteConnectionCloseObservers();
+    RemoteConnectionStopCoalescer();
+    TransportCloseChannel(&g_RemoteConnectionTransportChannel);
+
     CommunicationServerShutdownAndCleanupConnection(g_SeverSocket,
                                                     g_ServerListenSocket);
 }
 
+/**
+ * @brief Make a session the active session (the commands are sent to it)
+ * @details the lock of the sessions should be held
+ *
+ * @param Session The session or NULL if there is no session
+ * @return VOID
+ */
+static VOID
+RemoteConnectionActivateSession(PREMOTE_CONNECTION_SESSION Session)
+{
+    g_RemoteConnectionActiveSession = Session;
+
+    if (Session == NULL)
+    {
+        //
+        // Indicate that it's not a remote debuggee anymore
+        //
+        g_IsConnectedToRemoteDebuggee = FALSE;
+        return;
+    }
+
+    //
+    // The address of the active session is shown in the signature
+    //
+    g_ServerIp   = Session->Ip;
+    g_ServerPort = Session->Port;
+}
+
+/**
+ * @brief Make one of the remaining sessions the active session once the
+ * active session is closed
+ * @details the lock of the sessions should be held
+ *
+ * @return VOID
+ */
+static VOID
+RemoteConnectionActivateRemainingSession()
+{
+    for (UINT32 i = 0; i < REMOTE_CONNECTION_MAXIMUM_SESSIONS; i++)
+    {
+        if (g_RemoteConnectionSessions[i].IsUsed && g_RemoteConnectionSessions[i].IsConnected)
+        {
+            RemoteConnectionActivateSession(&g_RemoteConnectionSessions[i]);
+            return;
+        }
+    }
+
+    RemoteConnectionActivateSession(NULL);
+}
+
 /**
  * @brief A thread that listens for server (debuggee) messages
  * and show it by using ShowMessages wrapper
+ * @details each session has its own thread, the results are shown in
+ * the order that they're received
  *
- * @param lpParam
+ * @param lpParam The session
  * @return DWORD
  */
 DWORD WINAPI
 RemoteConnectionThreadListeningToDebuggee(LPVOID lpParam)
 {
-    char   recvbuf[COMMUNICATION_BUFFER_SIZE + TCP_END_OF_BUFFER_CHARS_COUNT] = {0};
-    UINT32 BuffLenReceived                                                    = 0;
+    PREMOTE_CONNECTION_SESSION     Session     = (PREMOTE_CONNECTION_SESSION)lpParam;
+    REMOTE_CONNECTION_FRAME_HEADER FrameHeader = {0};
+    std::vector<CHAR>              Results;
+    UINT32                         Length;
+    BOOLEAN                        IsAborted;
+    BOOLEAN                        IsActive;
 
-    while (g_IsConnectedToRemoteDebuggee)
+    while (Session->IsConnected)
     {
         //
-        // Receive message
+        // Receive frame
         //
-        if (CommunicationClientReceiveMessage(g_ClientConnectSocket, recvbuf, COMMUNICATION_BUFFER_SIZE, &BuffLenReceived) != 0)
+        if (!RemoteConnectionReceiveFrame(&Session->Channel, &FrameHeader, Results))
         {
             //
-            // Failed, break
+            // Failed (or the connection is closed), break
             //
             break;
         }
 
-        //
-        // Check if it's end of the buffer
-        //
-        for (size_t i = 0; i < BuffLenReceived; i++)
+        if (FrameHeader.Type == REMOTE_CONNECTION_FRAME_RESULTS)
         {
-            if (recvbuf[i] == g_EndOfBufferCheckTcp[0] &&
-                recvbuf[i + 1] == g_EndOfBufferCheckTcp[1] &&
-                recvbuf[i + 2] == g_EndOfBufferCheckTcp[2] &&
-                recvbuf[i + 3] == g_EndOfBufferCheckTcp[3])
-            {
-                g_IsEndOfMessageReceived = TRUE;
+            AcquireSRWLockExclusive(&g_RemoteConnectionSessionsLock);
 
+            if (Session == g_RemoteConnectionActiveSession)
+            {
                 //
-                // Cut the last string using \x00 \x00
+                // This is just because we want to show a correct signature
                 //
-                recvbuf[i]     = '\x00';
-                recvbuf[i + 1] = '\x00';
-                break;
+                if (g_BreakPrintingOutput)
+                {
+                    ReleaseSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+                    continue;
+                }
+            }
+            else
+            {
+                //
+                // The results of the other sessions (e.g., the triggered
+                // events) are shown with the id of their session
+                //
+                ShowMessages("[session %x (%s:%s)] ", Session->Id, Session->Ip.c_str(), Session->Port.c_str());
             }
-        }
 
-        //
-        // This is just because we want to show a correct signature
-        //
-        if (!g_BreakPrintingOutput)
-        {
             //
-            // Show message from remote debuggee
+            // Show messages from remote debuggee, the coalesced results
+            // are shown in chunks that fit in the buffer of messages
             //
-            ShowMessages("%s", recvbuf);
-        }
+            for (UINT32 Offset = 0; Offset < FrameHeader.Length; Offset += Length)
+            {
+                Length = min(FrameHeader.Length - Offset, (UINT32)PacketChunkSize);
 
-        //
-        // Show the signature
-        //
-        if (g_IsEndOfMessageReceived)
-        {
-            //
-            // it's not end of message anymore
-            //
-            g_IsEndOfMessageReceived = FALSE;
+                ShowMessages("%.*s", Length, Results.data() + Offset);
+            }
 
+            ReleaseSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+        }
+        else if (FrameHeader.Type == REMOTE_CONNECTION_FRAME_END_OF_RESULTS)
+        {
             //
-            // Trigger the event
+            // Trigger the event to show the signature
             //
-            SetEvent(g_EndOfMessageReceivedEvent);
+            SetEvent(Session->EndOfMessageReceivedEvent);
         }
+    }
 
-        //
-        // Clear the buffer
-        //
-        RtlZeroMemory(recvbuf, COMMUNICATION_BUFFER_SIZE);
+    AcquireSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+
+    //
+    // If the session is not connected, it's closed by the debugger
+    // ('.disconnect') and the connection is uninitialized there
+    //
+    IsAborted            = Session->IsConnected;
+    IsActive             = Session == g_RemoteConnectionActiveSession;
+    Session->IsConnected = FALSE;
+
+    ReleaseSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+
+    if (!IsAborted)
+    {
+        return 0;
     }
 
     //
     // The connection was aborted
     // Uinitialize every connections
     //
+    TransportCloseChannel(&Session->Channel);
 
-    //
-    // Indicate that debugger is not connected
-    //
-    g_IsConnectedToHyperDbgLocally = FALSE;
+    CommunicationClientShutdownConnection(Session->Socket);
+    CommunicationClientCleanup(Session->Socket);
 
     //
-    // Indicate that it's a remote debuggee
+    // The command that is sent to this session won't be finished
     //
-    g_IsConnectedToRemoteDebuggee = FALSE;
+    SetEvent(Session->EndOfMessageReceivedEvent);
 
-    //
-    // Show the signature
-    //
-    HyperDbgShowSignature();
+    AcquireSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+
+    Session->IsUsed = FALSE;
+
+    if (IsActive)
+    {
+        RemoteConnectionActivateRemainingSession();
+    }
+
+    ReleaseSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+
+    if (IsActive)
+    {
+        //
+        // Indicate that debugger is not connected
+        //
+        g_IsConnectedToHyperDbgLocally = FALSE;
+
+        //
+        // Show the signature
+        //
+        HyperDbgShowSignature();
+    }
+    else
+    {
+        ShowMessages("the connection of session %x (%s:%s) is closed\n",
+                     Session->Id,
+                     Session->Ip.c_str(),
+                     Session->Port.c_str());
+    }
 
     return 0;
 }
 
 /**
  * @brief Connect to a remote debuggee (guest) as a client (host)
- * @details this routine is supposed to be called by .connect command
+ * @details this routine is supposed to be called by .connect command,
+ * if the debugger is already connected to other remote debuggees, then
+ * a new session is added and it becomes the active session
  *
  * @param Ip
  * @param Port
@@ -242,90 +844,150 @@ RemoteConnectionThreadListeningToDebuggee(LPVOID lpParam)
 VOID
 RemoteConnectionConnect(PCSTR Ip, PCSTR Port)
 {
-    DWORD ThreadId;
+    PREMOTE_CONNECTION_SESSION Session = NULL;
+    SOCKET                     ClientConnectSocket;
+    DWORD                      ThreadId;
 
     //
-    // Check if the debugger or debuggee is already active
+    // Check if the debugger or debuggee is already active (other than
+    // the remote debuggees)
     //
-    if (IsConnectedToAnyInstanceOfDebuggerOrDebuggee())
+    if (!g_IsConnectedToRemoteDebuggee && IsConnectedToAnyInstanceOfDebuggerOrDebuggee())
     {
         return;
     }
 
+    //
+    // Find a free session
+    //
+    AcquireSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+
+    for (UINT32 i = 0; i < REMOTE_CONNECTION_MAXIMUM_SESSIONS; i++)
+    {
+        if (!g_RemoteConnectionSessions[i].IsUsed)
+        {
+            Session         = &g_RemoteConnectionSessions[i];
+            Session->IsUsed = TRUE;
+            Session->Id     = i;
+            break;
+        }
+    }
+
+    ReleaseSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+
+    if (Session == NULL)
+    {
+        ShowMessages("err, the maximum count of the sessions (%d) is reached, use "
+                     "'.disconnect' to disconnect from one of the remote machines\n",
+                     REMOTE_CONNECTION_MAXIMUM_SESSIONS);
+        return;
+    }
+
     //
     // Connect to server
     //
-    if (CommunicationClientConnectToServer(Ip, Port, &g_ClientConnectSocket) ==
+    if (CommunicationClientConnectToServer(Ip, Port, &ClientConnectSocket) ==
         1)
     {
         //
         // There was an error
         //
 
-        //
-        // Indicate that debugger is not connected
-        //
-        g_IsConnectedToHyperDbgLocally = FALSE;
-
-        //
-        // Indicate that it's not a remote  debuggee
-        //
-        g_IsConnectedToRemoteDebuggee = FALSE;
-
         //
         // Shutdown connection
         //
-        CommunicationClientShutdownConnection(g_ClientConnectSocket);
+        CommunicationClientShutdownConnection(ClientConnectSocket);
 
         //
         // Cleanup
         //
-        CommunicationClientCleanup(g_ClientConnectSocket);
+        CommunicationClientCleanup(ClientConnectSocket);
+
+        Session->IsUsed = FALSE;
+        return;
+    }
+
+    //
+    // Connection was successful
+    //
+    RemoteConnectionDisableNagle(ClientConnectSocket);
+
+    //
+    // Serve the connection by the I/O thread, so sending the commands
+    // doesn't wait for receiving the results
+    //
+    if (!TransportOpenChannel(&Session->Channel, (HANDLE)ClientConnectSocket, TRUE, 0))
+    {
+        CommunicationClientShutdownConnection(ClientConnectSocket);
+        CommunicationClientCleanup(ClientConnectSocket);
+
+        Session->IsUsed = FALSE;
+        return;
+    }
+
+    //
+    // The handle of the thread of the previous session in this slot is
+    // not needed anymore
+    //
+    if (Session->ListeningThread != NULL)
+    {
+        CloseHandle(Session->ListeningThread);
+        Session->ListeningThread = NULL;
+    }
+
+    //
+    // Create an event to show signature when the messages finished
+    //
+    if (Session->EndOfMessageReceivedEvent == NULL)
+    {
+        Session->EndOfMessageReceivedEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
     }
     else
     {
-        //
-        // Connection was successful
-        //
+        ResetEvent(Session->EndOfMessageReceivedEvent);
+    }
 
-        //
-        // Indicate that local debugger is not connected
-        //
-        g_IsConnectedToHyperDbgLocally = FALSE;
+    Session->Socket      = ClientConnectSocket;
+    Session->Ip          = Ip;
+    Session->Port        = Port;
+    Session->IsConnected = TRUE;
 
-        //
-        // Indicate that it's a remote debuggee
-        //
-        g_IsConnectedToRemoteDebuggee = TRUE;
+    //
+    // Indicate that local debugger is not connected
+    //
+    g_IsConnectedToHyperDbgLocally = FALSE;
 
-        //
-        // Create an event to show signature when the messages finished
-        //
-        if (g_EndOfMessageReceivedEvent == NULL)
-        {
-            g_EndOfMessageReceivedEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
-        }
+    //
+    // Indicate that it's a remote debuggee
+    //
+    g_IsConnectedToRemoteDebuggee = TRUE;
 
-        //
-        // Now, we should create a thread, which always listens to
-        // the remote debuggee for new messages
-        // Listen for upcoming messages
-        //
-        g_RemoteDebuggeeListeningThread = CreateThread(
-            NULL,
-            0,
-            RemoteConnectionThreadListeningToDebuggee,
-            NULL,
-            0,
-            &ThreadId);
+    AcquireSRWLockExclusive(&g_RemoteConnectionSessionsLock);
 
-        ShowMessages("connected to %s:%s\n", Ip, Port);
-    }
+    RemoteConnectionActivateSession(Session);
+
+    ReleaseSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+
+    //
+    // Now, we should create a thread, which always listens to
+    // the remote debuggee for new messages
+    // Listen for upcoming messages
+    //
+    Session->ListeningThread = CreateThread(
+        NULL,
+        0,
+        RemoteConnectionThreadListeningToDebuggee,
+        Session,
+        0,
+        &ThreadId);
+
+    ShowMessages("connected to %s:%s (session %x)\n", Ip, Port, Session->Id);
 }
 
 /**
  * @brief send the command as a client (debugger, host) to the
  * server (debuggee, guest)
+ * @details the command is sent to the active session
  *
  * @param sendbuf address of message buffer
  * @param len length of buffer
@@ -335,11 +997,17 @@ RemoteConnectionConnect(PCSTR Ip, PCSTR Port)
 int
 RemoteConnectionSendCommand(const char * sendbuf, int len)
 {
+    PREMOTE_CONNECTION_SESSION Session = g_RemoteConnectionActiveSession;
+
+    if (Session == NULL)
+    {
+        return 1;
+    }
+
     //
-    // Send Message
+    // Send Message (commands are never coalesced)
     //
-    if (CommunicationClientSendMessage(g_ClientConnectSocket, sendbuf, len) !=
-        0)
+    if (!RemoteConnectionSendFrame(&Session->Channel, REMOTE_CONNECTION_FRAME_COMMAND, sendbuf, len))
     {
         //
         // Failed
@@ -351,7 +1019,7 @@ RemoteConnectionSendCommand(const char * sendbuf, int len)
     // We wait for the debuggee to send the message
     //
     WaitForSingleObject(
-        g_EndOfMessageReceivedEvent,
+        Session->EndOfMessageReceivedEvent,
         INFINITE);
 
     //
@@ -372,22 +1040,69 @@ RemoteConnectionSendCommand(const char * sendbuf, int len)
 int
 RemoteConnectionSendResultsToHost(const char * sendbuf, int len)
 {
+    BOOLEAN Result = TRUE;
+
+    if (!g_RemoteConnectionCoalescer.IsLockInitialized)
+    {
+        return 1;
+    }
+
+    EnterCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
     //
-    // Send the message
+    // Send the previous results if the batch doesn't fit
     //
-    if (CommunicationServerSendMessage(g_SeverSocket, sendbuf, len) != 0)
+    if (g_RemoteConnectionCoalescer.Results.size() + len > g_RemoteConnectionMaximumBatchSize)
     {
-        //
-        // Failed
-        //
-        return 1;
+        Result = RemoteConnectionFlushResults(FALSE);
     }
 
-    return 0;
+    //
+    // Coalesce the message, it's sent by the flush thread (once the flush
+    // interval is passed) and then by the I/O thread
+    //
+    if (g_RemoteConnectionCoalescer.Results.empty())
+    {
+        WakeConditionVariable(&g_RemoteConnectionCoalescer.ResultsQueued);
+    }
+
+    g_RemoteConnectionCoalescer.Results.insert(g_RemoteConnectionCoalescer.Results.end(), sendbuf, sendbuf + len);
+
+    if (g_RemoteConnectionCoalescer.Results.size() >= g_RemoteConnectionMaximumBatchSize)
+    {
+        Result = RemoteConnectionFlushResults(FALSE);
+    }
+
+    LeaveCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
+    return Result ? 0 : 1;
+}
+
+/**
+ * @brief Send the coalesced results and the end of results (the command
+ * is executed) from deubggee (server, guest) to the debugger (client, host)
+ *
+ * @return int returning 0 means that there was no error in
+ * executing the function and 1 shows there was an error
+ */
+int
+RemoteConnectionSendEndOfResultsToHost()
+{
+    BOOLEAN Result;
+
+    EnterCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
+    Result = RemoteConnectionFlushResults(TRUE);
+
+    LeaveCriticalSection(&g_RemoteConnectionCoalescer.Lock);
+
+    return Result ? 0 : 1;
 }
 
 /**
  * @brief Close the connect from client side to the debuggee
+ * @details the active session is closed and one of the remaining
+ * sessions (if any) becomes the active session
  *
  * @return int returning 0 means that there was no error in
  * executing the function and 1 shows there was an error
@@ -395,8 +1110,107 @@ RemoteConnectionSendResultsToHost(const char * sendbuf, int len)
 int
 RemoteConnectionCloseTheConnectionWithDebuggee()
 {
-    CommunicationClientShutdownConnection(g_ClientConnectSocket);
-    CommunicationClientCleanup(g_ClientConnectSocket);
+    PREMOTE_CONNECTION_SESSION Session;
+
+    AcquireSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+
+    Session = g_RemoteConnectionActiveSession;
+
+    if (Session == NULL || !Session->IsConnected)
+    {
+        ReleaseSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+        return 1;
+    }
+
+    Session->IsConnected = FALSE;
+
+    ReleaseSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+
+    //
+    // Closing the channel stops the listening thread of the session
+    //
+    TransportCloseChannel(&Session->Channel);
+
+    WaitForSingleObject(Session->ListeningThread, INFINITE);
+    CloseHandle(Session->ListeningThread);
+    Session->ListeningThread = NULL;
+
+    CommunicationClientShutdownConnection(Session->Socket);
+    CommunicationClientCleanup(Session->Socket);
+
+    AcquireSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+
+    Session->IsUsed = FALSE;
+
+    RemoteConnectionActivateRemainingSession();
+
+    ReleaseSRWLockExclusive(&g_RemoteConnectionSessionsLock);
 
     return 0;
 }
+
+/**
+ * @brief Show the sessions of the remote debuggees
+ *
+ * @return VOID
+ */
+VOID
+RemoteConnectionShowSessions()
+{
+    BOOLEAN IsFound = FALSE;
+
+    AcquireSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+
+    for (UINT32 i = 0; i < REMOTE_CONNECTION_MAXIMUM_SESSIONS; i++)
+    {
+        if (!g_RemoteConnectionSessions[i].IsUsed || !g_RemoteConnectionSessions[i].IsConnected)
+        {
+            continue;
+        }
+
+        IsFound = TRUE;
+
+        ShowMessages("%s%x\t%s:%s\n",
+                     &g_RemoteConnectionSessions[i] == g_RemoteConnectionActiveSession ? "*" : " ",
+                     g_RemoteConnectionSessions[i].Id,
+                     g_RemoteConnectionSessions[i].Ip.c_str(),
+                     g_RemoteConnectionSessions[i].Port.c_str());
+    }
+
+    ReleaseSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+
+    if (!IsFound)
+    {
+        ShowMessages("you're not connected to any remote debuggee, use '.connect' "
+                     "to connect to a remote machine\n");
+    }
+}
+
+/**
+ * @brief Switch to another session of the remote debuggees
+ *
+ * @param Id The id of the session
+ * @return BOOLEAN Whether the session exists or not
+ */
+BOOLEAN
+RemoteConnectionSwitchSession(UINT32 Id)
+{
+    BOOLEAN Result = FALSE;
+
+    if (Id >= REMOTE_CONNECTION_MAXIMUM_SESSIONS)
+    {
+        return FALSE;
+    }
+
+    AcquireSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+
+    if (g_RemoteConnectionSessions[Id].IsUsed && g_RemoteConnectionSessions[Id].IsConnected)
+    {
+        RemoteConnectionActivateSession(&g_RemoteConnectionSessions[Id]);
+        Result = TRUE;
+    }
+
+    ReleaseSRWLockExclusive(&g_RemoteConnectionSessionsLock);
+
+    return Result;
+}
@@ -0,0 +1,221 @@
+/**
+ * @file shared-memory-output.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Shared memory (ring buffer) output sources
+ * @details messages are copied to a ring in a named file mapping which
+ * is read by a local process, the writer is never blocked by the reader
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Create the named file mapping of the ring and initialize
+ * the header of the ring
+ *
+ * @param Name Name of the file mapping
+ *
+ * @return HANDLE returns INVALID_HANDLE_VALUE if it's not possible to
+ * create the file mapping
+ */
+HANDLE
+SharedMemoryOutputCreateMapping(const string & Name)
+{
+    HANDLE                       MappingHandle;
+    PSHARED_MEMORY_OUTPUT_HEADER Header;
+    string                       EventName = Name + SHARED_MEMORY_OUTPUT_EVENT_SUFFIX;
+
+    if (EventName.size() >= MAX_PATH)
+    {
+        return INVALID_HANDLE_VALUE;
+    }
+
+    MappingHandle = CreateFileMappingA(INVALID_HANDLE_VALUE,
+                                       NULL,
+                                       PAGE_READWRITE,
+                                       0,
+                                       sizeof(SHARED_MEMORY_OUTPUT_HEADER) + SHARED_MEMORY_OUTPUT_RING_SIZE,
+                                       Name.c_str());
+
+    if (MappingHandle == NULL)
+    {
+        return INVALID_HANDLE_VALUE;
+    }
+
+    if (GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+        //
+        // The ring should not be shared with another output source
+        //
+        CloseHandle(MappingHandle);
+        return INVALID_HANDLE_VALUE;
+    }
+
+    Header = (PSHARED_MEMORY_OUTPUT_HEADER)MapViewOfFile(MappingHandle,
+                                                         FILE_MAP_WRITE,
+                                                         0,
+                                                         0,
+                                                         sizeof(SHARED_MEMORY_OUTPUT_HEADER));
+
+    if (Header == NULL)
+    {
+        CloseHandle(MappingHandle);
+        return INVALID_HANDLE_VALUE;
+    }
+
+    Header->Magic           = SHARED_MEMORY_OUTPUT_MAGIC;
+    Header->Version         = SHARED_MEMORY_OUTPUT_VERSION;
+    Header->RingSize        = SHARED_MEMORY_OUTPUT_RING_SIZE;
+    Header->Head            = 0;
+    Header->Tail            = 0;
+    Header->DroppedMessages = 0;
+
+    strcpy_s(Header->EventName, EventName.c_str());
+
+    UnmapViewOfFile(Header);
+
+    return MappingHandle;
+}
+
+/**
+ * @brief Map the ring and create the event of new messages
+ *
+ * @param MappingHandle Handle of the file mapping
+ *
+ * @return PSHARED_MEMORY_OUTPUT_CONTEXT NULL if it's not possible to
+ * map the ring
+ */
+PSHARED_MEMORY_OUTPUT_CONTEXT
+SharedMemoryOutputOpen(HANDLE MappingHandle)
+{
+    PSHARED_MEMORY_OUTPUT_CONTEXT Context;
+
+    Context = (PSHARED_MEMORY_OUTPUT_CONTEXT)malloc(sizeof(SHARED_MEMORY_OUTPUT_CONTEXT));
+
+    if (Context == NULL)
+    {
+        return NULL;
+    }
+
+    RtlZeroMemory(Context, sizeof(SHARED_MEMORY_OUTPUT_CONTEXT));
+
+    Context->MappingHandle = MappingHandle;
+    Context->Header        = (PSHARED_MEMORY_OUTPUT_HEADER)MapViewOfFile(MappingHandle, FILE_MAP_WRITE, 0, 0, 0);
+
+    if (Context->Header == NULL)
+    {
+        free(Context);
+        return NULL;
+    }
+
+    Context->Ring = (CHAR *)Context->Header + sizeof(SHARED_MEMORY_OUTPUT_HEADER);
+
+    //
+    // Auto-reset event, the reader waits on it once the ring is empty
+    //
+    Context->EventHandle = CreateEventA(NULL, FALSE, FALSE, Context->Header->EventName);
+
+    if (Context->EventHandle == NULL)
+    {
+        UnmapViewOfFile(Context->Header);
+        free(Context);
+        return NULL;
+    }
+
+    return Context;
+}
+
+/**
+ * @brief Copy a message to the ring
+ * @details the message is dropped if there is not enough free space
+ * in the ring (the reader doesn't keep up)
+ *
+ * @param Context
+ * @param Message The message
+ * @param MessageLength Length of the message
+ *
+ * @return BOOLEAN FALSE if the message is dropped
+ */
+BOOLEAN
+SharedMemoryOutputWriteMessage(PSHARED_MEMORY_OUTPUT_CONTEXT Context, CHAR * Message, UINT32 MessageLength)
+{
+    PSHARED_MEMORY_OUTPUT_HEADER Header = Context->Header;
+    UINT64                       Head   = Header->Head;
+    UINT64                       Tail   = Header->Tail;
+    UINT64                       Needed = (sizeof(UINT32) + (UINT64)MessageLength + 7) & ~7ull;
+    UINT64                       FreeSpace;
+    UINT32                       Offset;
+    UINT32                       Skip = 0;
+
+    FreeSpace = SHARED_MEMORY_OUTPUT_RING_SIZE - (Head - Tail);
+    Offset    = (UINT32)(Head % SHARED_MEMORY_OUTPUT_RING_SIZE);
+
+    //
+    // Messages are not split, if the message doesn't fit till the end of
+    // the ring, the rest of the ring is skipped
+    //
+    if (SHARED_MEMORY_OUTPUT_RING_SIZE - Offset < Needed)
+    {
+        Skip = SHARED_MEMORY_OUTPUT_RING_SIZE - Offset;
+    }
+
+    if (Needed > SHARED_MEMORY_OUTPUT_RING_SIZE || FreeSpace < Skip + Needed)
+    {
+        InterlockedIncrement64((volatile LONG64 *)&Header->DroppedMessages);
+        return FALSE;
+    }
+
+    if (Skip != 0)
+    {
+        *(UINT32 *)(Context->Ring + Offset) = SHARED_MEMORY_OUTPUT_WRAP_MARKER;
+        Offset                              = 0;
+    }
+
+    *(UINT32 *)(Context->Ring + Offset) = MessageLength;
+    memcpy(Context->Ring + Offset + sizeof(UINT32), Message, MessageLength);
+
+    //
+    // Publish the message once it's completely copied
+    //
+    InterlockedExchange64((volatile LONG64 *)&Header->Head, Head + Skip + Needed);
+
+    return TRUE;
+}
+
+/**
+ * @brief Notify the reader of the ring about the new messages
+ *
+ * @param Context
+ *
+ * @return VOID
+ */
+VOID
+SharedMemoryOutputSignal(PSHARED_MEMORY_OUTPUT_CONTEXT Context)
+{
+    SetEvent(Context->EventHandle);
+}
+
+/**
+ * @brief Unmap the ring and close the event of new messages
+ * @details the handle of the file mapping is not closed
+ *
+ * @param Context
+ *
+ * @return VOID
+ */
+VOID
+SharedMemoryOutputClose(PSHARED_MEMORY_OUTPUT_CONTEXT Context)
+{
+    //
+    // Wake up the reader for the last time
+    //
+    SetEvent(Context->EventHandle);
+
+    CloseHandle(Context->EventHandle);
+    UnmapViewOfFile(Context->Header);
+
+    free(Context);
+}
@@ -224,6 +224,107 @@ CommunicationClientCleanup(SOCKET ConnectSocket)
     return 0;
 }
 
+/**
+ * @brief Create a UDP socket that exchanges datagrams with the
+ * debuggee over the network
+ * @details the socket is bound to the port on all of the local
+ * addresses and only receives the datagrams of the debuggee
+ *
+ * @param Ip Address of the debuggee
+ * @param Port
+ * @param UdpSocketArg
+ * @return int
+ */
+int
+CommunicationClientCreateUdpSocket(PCSTR Ip, PCSTR Port, SOCKET * UdpSocketArg)
+{
+    WSADATA          wsaData;
+    SOCKET           UdpSocket = INVALID_SOCKET;
+    struct addrinfo *result = NULL, hints;
+    sockaddr_in      LocalAddress      = {0};
+    BOOL             ReportConnReset   = FALSE;
+    int              ReceiveBufferSize = NETWORK_CONNECTION_RECEIVE_BUFFER_SIZE;
+    DWORD            ReturnedBytes;
+    int              iResult;
+
+    //
+    // Initialize Winsock
+    //
+    iResult = WSAStartup(MAKEWORD(2, 2), &wsaData);
+    if (iResult != 0)
+    {
+        ShowMessages("err, WSAStartup failed (%x)\n", iResult);
+        return 1;
+    }
+
+    ZeroMemory(&hints, sizeof(hints));
+    hints.ai_family   = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_protocol = IPPROTO_UDP;
+
+    //
+    // Resolve the debuggee address and port
+    //
+    iResult = getaddrinfo(Ip, Port, &hints, &result);
+    if (iResult != 0)
+    {
+        ShowMessages("getaddrinfo failed (%x)\n", iResult);
+        WSACleanup();
+        return 1;
+    }
+
+    UdpSocket = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (UdpSocket == INVALID_SOCKET)
+    {
+        ShowMessages("socket failed with error: %ld\n", WSAGetLastError());
+        freeaddrinfo(result);
+        WSACleanup();
+        return 1;
+    }
+
+    //
+    // The debuggee sends large responses in bursts of datagrams, so
+    // they shouldn't be dropped before the I/O thread receives them
+    //
+    setsockopt(UdpSocket, SOL_SOCKET, SO_RCVBUF, (const char *)&ReceiveBufferSize, sizeof(ReceiveBufferSize));
+
+    //
+    // Don't fail the receives if the debuggee is not listening yet
+    //
+    WSAIoctl(UdpSocket,
+             SIO_UDP_CONNRESET,
+             &ReportConnReset,
+             sizeof(ReportConnReset),
+             NULL,
+             0,
+             &ReturnedBytes,
+             NULL,
+             NULL);
+
+    LocalAddress.sin_family      = AF_INET;
+    LocalAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+    LocalAddress.sin_port        = ((sockaddr_in *)result->ai_addr)->sin_port;
+
+    if (bind(UdpSocket, (sockaddr *)&LocalAddress, sizeof(LocalAddress)) == SOCKET_ERROR ||
+        connect(UdpSocket, result->ai_addr, (int)result->ai_addrlen) == SOCKET_ERROR)
+    {
+        ShowMessages("err, unable to bind the port (%x)\n", WSAGetLastError());
+        closesocket(UdpSocket);
+        freeaddrinfo(result);
+        WSACleanup();
+        return 1;
+    }
+
+    freeaddrinfo(result);
+
+    //
+    // Store the arguments
+    //
+    *UdpSocketArg = UdpSocket;
+
+    return 0;
+}
+
 //
 // int __cdecl main(int argc, char **argv) {
 //
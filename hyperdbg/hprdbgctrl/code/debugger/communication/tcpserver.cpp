@@ -20,7 +20,8 @@
 
 /**
  * @brief Create server and wait for a client to connect
- * @details this function only accepts one client not multiple clients
+ * @details this function only accepts one client, other clients are
+ * accepted by CommunicationServerAcceptClient
  *
  * @param Port
  * @param ClientSocketArg
@@ -135,6 +136,36 @@ CommunicationServerCreateServerAndWaitForClient(PCSTR    Port,
     return 0;
 }
 
+/**
+ * @brief Accept another client on the listening socket of the server
+ * @details used for the read-only clients of the multi-client server,
+ * fails once the listening socket is closed
+ *
+ * @param ListenSocket
+ * @param ClientSocketArg
+ * @return int
+ */
+int
+CommunicationServerAcceptClient(SOCKET ListenSocket, SOCKET * ClientSocketArg)
+{
+    SOCKET      ClientSocket;
+    sockaddr_in name    = {0};
+    int         addrlen = sizeof(name);
+
+    ClientSocket = accept(ListenSocket, (struct sockaddr *)&name, &addrlen);
+
+    if (ClientSocket == INVALID_SOCKET)
+    {
+        return 1;
+    }
+
+    ShowMessages("read-only client connected : %s:%d\n", inet_ntoa(name.sin_addr), ntohs(name.sin_port));
+
+    *ClientSocketArg = ClientSocket;
+
+    return 0;
+}
+
 /**
  * @brief listen and receive message as the server
  *
@@ -0,0 +1,546 @@
+/**
+ * @file transport.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Asynchronous transport of the connections
+ * @details The serial, named pipe, TCP and UDP connections of the debugger are
+ * associated with a single I/O completion port, a dedicated I/O thread keeps
+ * a receive operation pending for each connection and sends the queued
+ * buffers, so the commands, the messages that are streamed and the pause
+ * requests are not serialized behind each other's blocking I/O
+ *
+ * @version 0.4
+ * @date 2023-07-25
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern HANDLE          g_TransportCompletionPort;
+extern HANDLE          g_TransportIoThread;
+extern volatile UINT64 g_TransportSentBytes;
+extern volatile UINT64 g_TransportReceivedBytes;
+
+/**
+ * @brief Start a receive operation on the channel (if it's not already started)
+ * @details the lock of the channel should be held
+ *
+ * @param Channel
+ *
+ * @return VOID
+ */
+static VOID
+TransportStartReceive(PTRANSPORT_CHANNEL Channel)
+{
+    if (Channel->IsClosed || Channel->IsReceiving ||
+        Channel->ReceivedData.size() - Channel->ReceivedDataOffset >= TransportMaximumReceivedDataSize)
+    {
+        return;
+    }
+
+    RtlZeroMemory(&Channel->ReceiveOperation.Overlapped, sizeof(OVERLAPPED));
+
+    //
+    // The completion is queued to the completion port even if
+    // the data is already available
+    //
+    if (!ReadFile(Channel->Handle,
+                  Channel->ReceiveBlock,
+                  TransportReceiveBlockSize,
+                  NULL,
+                  &Channel->ReceiveOperation.Overlapped) &&
+        GetLastError() != ERROR_IO_PENDING)
+    {
+        Channel->IsClosed = TRUE;
+        WakeAllConditionVariable(&Channel->StateChanged);
+        return;
+    }
+
+    Channel->IsReceiving = TRUE;
+}
+
+/**
+ * @brief Start sending the first queued buffer of the channel (if
+ * it's not already being sent)
+ * @details the lock of the channel should be held
+ *
+ * @param Channel
+ *
+ * @return VOID
+ */
+static VOID
+TransportStartSend(PTRANSPORT_CHANNEL Channel)
+{
+    std::vector<BYTE> * Buffer;
+    DWORD               Length;
+
+    if (Channel->IsClosed || Channel->IsSending || Channel->SendQueue.empty())
+    {
+        return;
+    }
+
+    Buffer = &Channel->SendQueue.front();
+    Length = (DWORD)(Buffer->size() - Channel->SentLength);
+
+    //
+    // Each send operation of a UDP socket is a separate datagram
+    //
+    if (Channel->MaximumSendLength != 0 && Length > Channel->MaximumSendLength)
+    {
+        Length = Channel->MaximumSendLength;
+    }
+
+    RtlZeroMemory(&Channel->SendOperation.Overlapped, sizeof(OVERLAPPED));
+
+    if (!WriteFile(Channel->Handle,
+                   Buffer->data() + Channel->SentLength,
+                   Length,
+                   NULL,
+                   &Channel->SendOperation.Overlapped) &&
+        GetLastError() != ERROR_IO_PENDING)
+    {
+        Channel->IsClosed = TRUE;
+        WakeAllConditionVariable(&Channel->StateChanged);
+        return;
+    }
+
+    Channel->IsSending = TRUE;
+}
+
+/**
+ * @brief The I/O thread that handles the completions of all of the channels
+ *
+ * @param Param
+ *
+ * @return DWORD
+ */
+static DWORD WINAPI
+TransportIoThread(LPVOID Param)
+{
+    BOOL                 Status;
+    DWORD                TransferredBytes;
+    ULONG_PTR            CompletionKey;
+    LPOVERLAPPED         Overlapped;
+    PTRANSPORT_CHANNEL   Channel;
+    PTRANSPORT_OPERATION Operation;
+
+    UNREFERENCED_PARAMETER(Param);
+
+    while (TRUE)
+    {
+        Status = GetQueuedCompletionStatus(g_TransportCompletionPort,
+                                           &TransferredBytes,
+                                           &CompletionKey,
+                                           &Overlapped,
+                                           INFINITE);
+
+        if (Overlapped == NULL && (!Status || CompletionKey == 0))
+        {
+            //
+            // The completion port is closed
+            //
+            break;
+        }
+
+        Channel = (PTRANSPORT_CHANNEL)CompletionKey;
+
+        EnterCriticalSection(&Channel->Lock);
+
+        if (Overlapped != NULL)
+        {
+            Operation = CONTAINING_RECORD(Overlapped, TRANSPORT_OPERATION, Overlapped);
+
+            if (Operation->Type == TRANSPORT_OPERATION_RECEIVE)
+            {
+                Channel->IsReceiving = FALSE;
+
+                if (!Status || (TransferredBytes == 0 && Channel->IsSocket))
+                {
+                    //
+                    // The remote system closed the connection (or the
+                    // operation is canceled)
+                    //
+                    Channel->IsClosed = TRUE;
+                }
+                else
+                {
+                    Channel->ReceivedData.insert(Channel->ReceivedData.end(),
+                                                 Channel->ReceiveBlock,
+                                                 Channel->ReceiveBlock + TransferredBytes);
+
+                    g_TransportReceivedBytes += TransferredBytes;
+                }
+            }
+            else
+            {
+                Channel->IsSending = FALSE;
+
+                if (!Status)
+                {
+                    Channel->IsClosed = TRUE;
+                }
+                else
+                {
+                    Channel->SentLength += TransferredBytes;
+                    g_TransportSentBytes += TransferredBytes;
+
+                    if (Channel->SentLength >= Channel->SendQueue.front().size())
+                    {
+                        Channel->SendQueue.pop_front();
+                        Channel->SentLength = 0;
+                    }
+                }
+            }
+
+            WakeAllConditionVariable(&Channel->StateChanged);
+        }
+
+        //
+        // Start the next operations (completions without an overlapped
+        // structure are posted to start them)
+        //
+        TransportStartReceive(Channel);
+        TransportStartSend(Channel);
+
+        LeaveCriticalSection(&Channel->Lock);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Serve a connection by the I/O thread
+ * @details the handle should be opened for overlapped I/O
+ *
+ * @param Channel
+ * @param Handle The handle of the serial device, the named pipe or the socket
+ * @param IsSocket Whether the handle is a TCP socket
+ * @param MaximumSendLength Maximum length of each send operation (zero
+ * means no limit), buffers are split into datagrams of this length for
+ * UDP sockets
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TransportOpenChannel(PTRANSPORT_CHANNEL Channel, HANDLE Handle, BOOLEAN IsSocket, UINT32 MaximumSendLength)
+{
+    if (g_TransportCompletionPort == NULL)
+    {
+        g_TransportCompletionPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, NULL, 1);
+
+        if (g_TransportCompletionPort == NULL)
+        {
+            ShowMessages("err, unable to create the completion port (%x)\n",
+                         GetLastError());
+            return FALSE;
+        }
+
+        g_TransportIoThread = CreateThread(NULL, 0, TransportIoThread, NULL, 0, NULL);
+
+        if (g_TransportIoThread == NULL)
+        {
+            ShowMessages("err, unable to create the I/O thread (%x)\n",
+                         GetLastError());
+
+            CloseHandle(g_TransportCompletionPort);
+            g_TransportCompletionPort = NULL;
+            return FALSE;
+        }
+    }
+
+    if (!Channel->IsInitialized)
+    {
+        InitializeCriticalSection(&Channel->Lock);
+        InitializeConditionVariable(&Channel->StateChanged);
+
+        Channel->ReceiveOperation.Type = TRANSPORT_OPERATION_RECEIVE;
+        Channel->SendOperation.Type    = TRANSPORT_OPERATION_SEND;
+        Channel->IsInitialized         = TRUE;
+    }
+
+    EnterCriticalSection(&Channel->Lock);
+
+    Channel->Handle             = Handle;
+    Channel->IsSocket           = IsSocket;
+    Channel->MaximumSendLength  = MaximumSendLength;
+    Channel->IsClosed           = FALSE;
+    Channel->IsReceiving        = FALSE;
+    Channel->IsSending          = FALSE;
+    Channel->ReceivedDataOffset = 0;
+    Channel->SentLength         = 0;
+
+    Channel->ReceivedData.clear();
+    Channel->SendQueue.clear();
+
+    LeaveCriticalSection(&Channel->Lock);
+
+    if (CreateIoCompletionPort(Handle, g_TransportCompletionPort, (ULONG_PTR)Channel, 0) == NULL)
+    {
+        ShowMessages("err, unable to associate the connection with the completion port (%x)\n",
+                     GetLastError());
+        return FALSE;
+    }
+
+    EnterCriticalSection(&Channel->Lock);
+
+    Channel->IsOpened = TRUE;
+
+    //
+    // A receive operation is always pending on the channel
+    //
+    TransportStartReceive(Channel);
+
+    LeaveCriticalSection(&Channel->Lock);
+
+    return TRUE;
+}
+
+/**
+ * @brief Queue buffers to be sent over the channel
+ * @details the buffers are copied and sent as a whole, so the buffers
+ * that are queued by different threads are never mixed, the function
+ * returns without waiting for the buffers to be sent
+ *
+ * @param Channel
+ * @param Buffer1
+ * @param Length1
+ * @param Buffer2 (optional)
+ * @param Length2
+ * @param Buffer3 (optional)
+ * @param Length3
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TransportSend(PTRANSPORT_CHANNEL Channel,
+              const CHAR *       Buffer1,
+              UINT32             Length1,
+              const CHAR *       Buffer2,
+              UINT32             Length2,
+              const CHAR *       Buffer3,
+              UINT32             Length3)
+{
+    std::vector<BYTE> Buffer;
+
+    if (!Channel->IsOpened)
+    {
+        return FALSE;
+    }
+
+    Buffer.reserve(Length1 + Length2 + Length3);
+
+    Buffer.insert(Buffer.end(), (const BYTE *)Buffer1, (const BYTE *)Buffer1 + Length1);
+
+    if (Length2 != 0)
+    {
+        Buffer.insert(Buffer.end(), (const BYTE *)Buffer2, (const BYTE *)Buffer2 + Length2);
+    }
+
+    if (Length3 != 0)
+    {
+        Buffer.insert(Buffer.end(), (const BYTE *)Buffer3, (const BYTE *)Buffer3 + Length3);
+    }
+
+    EnterCriticalSection(&Channel->Lock);
+
+    if (Channel->IsClosed)
+    {
+        LeaveCriticalSection(&Channel->Lock);
+        return FALSE;
+    }
+
+    Channel->SendQueue.push_back(std::move(Buffer));
+
+    LeaveCriticalSection(&Channel->Lock);
+
+    //
+    // Wake up the I/O thread to send the buffer
+    //
+    PostQueuedCompletionStatus(g_TransportCompletionPort, 0, (ULONG_PTR)Channel, NULL);
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the count of the buffers that are queued and not sent yet
+ *
+ * @param Channel
+ *
+ * @return UINT32
+ */
+UINT32
+TransportGetQueuedBuffersCount(PTRANSPORT_CHANNEL Channel)
+{
+    UINT32 Count;
+
+    EnterCriticalSection(&Channel->Lock);
+
+    Count = (UINT32)Channel->SendQueue.size();
+
+    LeaveCriticalSection(&Channel->Lock);
+
+    return Count;
+}
+
+/**
+ * @brief Query the count of bytes that are transferred over all of the
+ * channels (since the debugger is started)
+ *
+ * @param SentBytes
+ * @param ReceivedBytes
+ *
+ * @return VOID
+ */
+VOID
+TransportQueryTransferredBytes(UINT64 * SentBytes, UINT64 * ReceivedBytes)
+{
+    *SentBytes     = g_TransportSentBytes;
+    *ReceivedBytes = g_TransportReceivedBytes;
+}
+
+/**
+ * @brief Read the data that is received over the channel
+ * @details waits until at least one byte is received (or the
+ * connection is closed)
+ *
+ * @param Channel
+ * @param Buffer
+ * @param MaximumLength
+ * @param ReceivedLength Count of bytes that are read
+ *
+ * @return BOOLEAN Returns FALSE if the connection is closed
+ */
+BOOLEAN
+TransportReceive(PTRANSPORT_CHANNEL Channel, BYTE * Buffer, UINT32 MaximumLength, UINT32 * ReceivedLength)
+{
+    UINT32  Length;
+    BOOLEAN IsReceivingStopped;
+
+    *ReceivedLength = 0;
+
+    if (!Channel->IsOpened)
+    {
+        return FALSE;
+    }
+
+    EnterCriticalSection(&Channel->Lock);
+
+    while (Channel->ReceivedData.size() == Channel->ReceivedDataOffset && !Channel->IsClosed)
+    {
+        SleepConditionVariableCS(&Channel->StateChanged, &Channel->Lock, INFINITE);
+    }
+
+    if (Channel->ReceivedData.size() == Channel->ReceivedDataOffset)
+    {
+        //
+        // The connection is closed and there is no data
+        //
+        LeaveCriticalSection(&Channel->Lock);
+        return FALSE;
+    }
+
+    Length = (UINT32)(Channel->ReceivedData.size() - Channel->ReceivedDataOffset);
+
+    if (Length > MaximumLength)
+    {
+        Length = MaximumLength;
+    }
+
+    memcpy(Buffer, Channel->ReceivedData.data() + Channel->ReceivedDataOffset, Length);
+
+    Channel->ReceivedDataOffset += Length;
+
+    //
+    // Remove the data that is read
+    //
+    if (Channel->ReceivedDataOffset == Channel->ReceivedData.size())
+    {
+        Channel->ReceivedData.clear();
+        Channel->ReceivedDataOffset = 0;
+    }
+    else if (Channel->ReceivedDataOffset >= TransportReceiveBlockSize)
+    {
+        Channel->ReceivedData.erase(Channel->ReceivedData.begin(),
+                                    Channel->ReceivedData.begin() + Channel->ReceivedDataOffset);
+        Channel->ReceivedDataOffset = 0;
+    }
+
+    IsReceivingStopped = !Channel->IsReceiving && !Channel->IsClosed;
+
+    LeaveCriticalSection(&Channel->Lock);
+
+    //
+    // Receiving is stopped if the received data was not read,
+    // so the I/O thread should start receiving again
+    //
+    if (IsReceivingStopped)
+    {
+        PostQueuedCompletionStatus(g_TransportCompletionPort, 0, (ULONG_PTR)Channel, NULL);
+    }
+
+    *ReceivedLength = Length;
+
+    return TRUE;
+}
+
+/**
+ * @brief Stop serving the connection by the I/O thread
+ * @details the queued buffers are sent before closing the channel,
+ * the caller closes the handle after this function
+ *
+ * @param Channel
+ *
+ * @return VOID
+ */
+VOID
+TransportCloseChannel(PTRANSPORT_CHANNEL Channel)
+{
+    ULONGLONG Deadline;
+
+    if (!Channel->IsOpened)
+    {
+        return;
+    }
+
+    EnterCriticalSection(&Channel->Lock);
+
+    //
+    // Wait for the queued buffers (e.g., the packet of closing the
+    // connection) to be sent
+    //
+    Deadline = GetTickCount64() + TransportCloseTimeout;
+
+    while (!Channel->IsClosed &&
+           (Channel->IsSending || !Channel->SendQueue.empty()) &&
+           GetTickCount64() < Deadline)
+    {
+        SleepConditionVariableCS(&Channel->StateChanged, &Channel->Lock, TransportCloseTimeout);
+    }
+
+    Channel->IsClosed = TRUE;
+
+    //
+    // Cancel the pending operations and wait for their completions
+    //
+    CancelIoEx(Channel->Handle, NULL);
+
+    while (Channel->IsReceiving || Channel->IsSending)
+    {
+        SleepConditionVariableCS(&Channel->StateChanged, &Channel->Lock, INFINITE);
+    }
+
+    Channel->IsOpened = FALSE;
+
+    Channel->ReceivedData.clear();
+    Channel->SendQueue.clear();
+
+    //
+    // Wake up the threads that are waiting to receive
+    //
+    WakeAllConditionVariable(&Channel->StateChanged);
+
+    LeaveCriticalSection(&Channel->Lock);
+}
@@ -26,6 +26,9 @@ extern BOOLEAN                  g_IsConnectedToRemoteDebugger;
 extern BOOLEAN                  g_IsSerialConnectedToRemoteDebuggee;
 extern BOOLEAN                  g_IsSerialConnectedToRemoteDebugger;
 extern ACTIVE_DEBUGGING_PROCESS g_ActiveProcessDebuggingState;
+extern DEBUGGER_EVENTS_BATCH    g_EventsBatch;
+
+extern std::map<std::string, REGS_ENUM> RegistersMap;
 
 /**
  * @brief shows the error message
@@ -369,6 +372,291 @@ ShowErrorMessage(UINT32 Error)
                      Error);
         break;
 
+    case DEBUGGER_ERROR_MODE_BASED_EXECUTION_TRACE_IS_NOT_AVAILABLE:
+        ShowMessages("err, mode-based execution control (MBEC) is either not supported "
+                     "on this processor or used by another feature (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_EXECUTION_TRACE_RANGE_IS_TOO_LARGE:
+        ShowMessages("err, the range exceeds the maximum count of traced pages (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_MONITOR_COALESCING_STATE:
+        ShowMessages("err, unable to allocate the buffers for coalescing the accesses (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_BUILD_REVERSE_MAPPING_INDEX:
+        ShowMessages("err, unable to build the index of the mappings of the physical addresses (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_BATCH_REQUEST:
+        ShowMessages("err, the request is not valid in a batch of requests (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_PREPARING_DEBUGGEE_NETWORK_ADAPTER_NOT_SUPPORTED:
+        ShowMessages("err, the network adapter is not found or it's not supported, "
+                     "only Intel 8254x and 82574 (e1000) adapters are supported (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_PREPARING_DEBUGGEE_DEBUGGER_NOT_REACHABLE:
+        ShowMessages("err, the debugger is not reachable over the network, "
+                     "both of the systems should be on the same network (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_STEP_TRACE_REQUEST:
+        ShowMessages("err, only step-in (t) and instrumentation step-in (i) "
+                     "with a non-zero count can be traced (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_VMEXIT_STATISTICS:
+        ShowMessages("err, unable to allocate the statistics of vm-exits (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_SAMPLING_PROFILER:
+        ShowMessages("err, unable to allocate the buffers of the sampling profiler (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_VMX_PREEMPTION_TIMER_IS_NOT_SUPPORTED:
+        ShowMessages("err, the processor doesn't support the VMX preemption timer (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_EVENT_RATE_LIMIT_STATE:
+        ShowMessages("err, unable to allocate the buffers for limiting the rate of the event (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_PML_IS_NOT_SUPPORTED:
+        ShowMessages("err, the processor doesn't support page-modification logging (PML) (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_DIRTY_PAGES_BITMAP:
+        ShowMessages("err, unable to allocate the bitmaps of the dirty pages (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_DIRTY_PAGES_TRACKING_IS_NOT_ENABLED:
+        ShowMessages("err, the tracking of dirty pages is not enabled (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INTEL_PT_IS_NOT_SUPPORTED:
+        ShowMessages("err, the processor doesn't support Intel PT (Processor Trace) in VMX operation (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_INTEL_PT_BUFFERS:
+        ShowMessages("err, unable to allocate the buffers of Intel PT (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INTEL_PT_IS_NOT_ENABLED:
+        ShowMessages("err, the trace of Intel PT is not enabled (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_INTEL_PT_CONFIGURATION:
+        ShowMessages("err, the configuration of Intel PT is not valid or not supported by the processor (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_LAST_BRANCH_RECORDS_ARE_NOT_SUPPORTED:
+        ShowMessages("err, the last branch records (LBR) are not supported by the processor (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_REVERSING_MACHINE_COVERAGE_IS_NOT_AVAILABLE:
+        ShowMessages("err, the coverage couldn't be started, either mode-based execution "
+                     "control (MBEC) is not supported, the reversing machine is already "
+                     "initialized, or the buffers couldn't be allocated (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_REVERSING_MACHINE_COVERAGE_IS_NOT_ENABLED:
+        ShowMessages("err, the coverage is not started (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_REVERSING_MACHINE_UNABLE_TO_ADD_TARGET:
+        ShowMessages("err, the process couldn't be added to the reversing machine, either "
+                     "it's already a target, the maximum count of the targets is reached, "
+                     "or the coverage is started (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_REVERSING_MACHINE_UNABLE_TO_MAP_RESULTS:
+        ShowMessages("err, the results of the process couldn't be mapped, either the "
+                     "process is not a target of the reversing machine, or the results "
+                     "are already mapped (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_PEBS_IS_NOT_SUPPORTED:
+        ShowMessages("err, the processor doesn't support PEBS (Precise Event Based Sampling) "
+                     "of the requested accesses in VMX operation (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_PEBS_CONFIGURATION:
+        ShowMessages("err, invalid configuration (events, modes, address range, sampling rate "
+                     "or latency) for the PEBS sampling (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_PEBS_BUFFERS:
+        ShowMessages("err, unable to allocate the buffers of the PEBS sampling (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INSTRUCTION_COUNTER_IS_NOT_AVAILABLE:
+        ShowMessages("err, the performance counter of the retired instructions is not "
+                     "supported in VMX operation, it's used by the PEBS sampling or the "
+                     "count is more than its width (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_INSTRUCTION_BUDGET:
+        ShowMessages("err, the count of the instructions should not be zero (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UD_THREAD_IS_NOT_PAUSED:
+        ShowMessages("err, the thread is not found or it's not paused (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UD_INVALID_ACTION_OR_REGISTER:
+        ShowMessages("err, invalid action or register for the thread (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UD_ACTIONS_OF_THREAD_ARE_FULL:
+        ShowMessages("err, there is no room for more actions of the thread, "
+                     "please wait for the previous actions to be applied (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_BREAKPOINT_INVALID_CONDITION:
+        ShowMessages("err, the condition of the breakpoint is invalid or too large (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_THREAD_ID:
+        ShowMessages("err, the thread id is invalid, make sure to enter the "
+                     "thread id in hex format, or if you want to use it in decimal "
+                     "format, add '0n' prefix to the number (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_BENCHMARK_PARAMETERS:
+        ShowMessages("err, the parameters of the benchmark are invalid, the iterations "
+                     "should be between 1 and %x (%x)\n",
+                     TEST_BENCHMARK_MAXIMUM_ITERATIONS,
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_TRANSPORT_TEST_PAYLOAD_MISMATCH:
+        ShowMessages("err, the payload of the transport test is corrupted or its length "
+                     "is invalid (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_STRESS_TEST_PARAMETERS:
+        ShowMessages("err, the parameters of the stress test are invalid, the threads of "
+                     "each core should be between 1 and %x and the duration should be "
+                     "between 1 and %x milliseconds (%x)\n",
+                     TEST_STRESS_MAXIMUM_THREADS_PER_CORE,
+                     TEST_STRESS_MAXIMUM_DURATION,
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_CREATE_STRESS_TEST_THREADS:
+        ShowMessages("err, unable to create the threads of the stress test (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_SYSCALL_ENTRY_IS_NOT_SUPPORTED:
+        ShowMessages("err, the entry of system calls (LSTAR) doesn't start with 'swapgs', "
+                     "use '!syscall' or '!syscall2' instead (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INTERRUPT_ENTRY_IS_NOT_SUPPORTED:
+        ShowMessages("err, the entry of the interrupt in the IDT is not present or "
+                     "it's shared with another hooked vector, use '!interrupt' instead (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_EVENTS_BATCH:
+        ShowMessages("err, the batch of events and actions is not valid (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_EVENT_STATISTICS:
+        ShowMessages("err, unable to allocate the buffers for the statistics of the event (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_EPT_SNAPSHOT_CONFLICTS_WITH_EPT_HOOKS:
+        ShowMessages("err, the snapshot cannot be used together with the EPT hooks or the "
+                     "reversing machine (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_EPT_SNAPSHOT_IS_NOT_TAKEN:
+        ShowMessages("err, there is no snapshot, take a snapshot first (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_EPT_SNAPSHOT_IS_ALREADY_TAKEN:
+        ShowMessages("err, a snapshot is already taken, discard it first (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_EPT_SNAPSHOT_IS_TAKEN_ON_ANOTHER_CORE:
+        ShowMessages("err, the snapshot is taken on another core, switch to that core "
+                     "to restore it (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_EPT_SNAPSHOT_PAGES_ARE_EXHAUSTED:
+        ShowMessages("err, some of the written pages are not copied as there were not enough "
+                     "pre-allocated pages (use 'prealloc snapshot'), discard the snapshot (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_EVENT_RECORDS:
+        ShowMessages("err, unable to allocate the buffers of the records of the hits (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_MONITOR_RANGE_IS_INVALID:
+        ShowMessages("err, the range is invalid, overlaps with another range of the event, "
+                     "or the event is not a monitor event (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_MONITOR_RANGE_NOT_FOUND:
+        ShowMessages("err, the range is not found in the ranges of the event (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_MONITOR_RANGES:
+        ShowMessages("err, unable to allocate the ranges of the monitor event (%x)\n",
+                     Error);
+        break;
+
     default:
         ShowMessages("err, error not found (%x)\n",
                      Error);
@@ -1685,100 +1973,459 @@ InterpretOutput(vector<string> * SplittedCommand,
 }
 
 /**
- * @brief Register the event to the kernel
+ * @brief Unpause the output of the debugger once an event is registered
+ * (if the auto-unpause mode is enabled)
  *
- * @param Event the event structure to send
- * @param EventBufferLength the buffer length of event
- * @return BOOLEAN if the request was successful then true
- * if the request was not successful then false
+ * @return VOID
  */
-BOOLEAN
-SendEventToKernel(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
-                  UINT32                         EventBufferLength)
+static VOID
+DebuggerAutoUnpauseAfterRegisteringEvent()
 {
-    BOOL                                  Status;
-    ULONG                                 ReturnedLength;
-    DEBUGGER_EVENT_AND_ACTION_REG_BUFFER  ReturnedBuffer = {0};
-    PDEBUGGER_EVENT_AND_ACTION_REG_BUFFER TempRegResult;
-
-    if (g_IsSerialConnectedToRemoteDebuggee)
+    //
+    // Check for auto-unpause mode
+    //
+    if (!g_IsSerialConnectedToRemoteDebuggee && !g_IsSerialConnectedToRemoteDebugger && g_BreakPrintingOutput && g_AutoUnpause)
     {
         //
-        // It's a debuggger, we should send the events buffer directly
-        // from here
+        // Allow debugger to show its contents
         //
 
         //
-        // Send the buffer from here
+        // Set the g_BreakPrintingOutput to FALSE
         //
-        TempRegResult = KdSendRegisterEventPacketToDebuggee(Event, EventBufferLength);
+        g_BreakPrintingOutput = FALSE;
 
         //
-        // Move the buffer to local buffer
+        // If it's a remote debugger then we send the remote debuggee a 'g'
         //
-        memcpy(&ReturnedBuffer, TempRegResult, sizeof(DEBUGGER_EVENT_AND_ACTION_REG_BUFFER));
+        if (g_IsConnectedToRemoteDebuggee)
+        {
+            RemoteConnectionSendCommand("g", strlen("g") + 1);
+        }
+
+        ShowMessages("\n");
     }
-    else
+}
+
+/**
+ * @brief Add an entry to the stream of entries of the batch of events
+ *
+ * @param Type Type of the entry
+ * @param Buffer The event or the action
+ * @param Length Length of the buffer
+ *
+ * @return VOID
+ */
+static VOID
+DebuggerEventsBatchAddEntry(DEBUGGER_EVENTS_BATCH_ENTRY_TYPE Type, PVOID Buffer, UINT32 Length)
+{
+    DEBUGGER_EVENTS_BATCH_ENTRY Entry = {0};
+    size_t                      Offset;
+
+    Entry.Type = Type;
+    Entry.Size = Length;
+
+    Offset = g_EventsBatch.Entries.size();
+
+    //
+    // The buffer is zero-padded to the alignment of the entries
+    //
+    g_EventsBatch.Entries.resize(Offset + DEBUGGER_EVENTS_BATCH_ENTRY_LENGTH(Length), 0);
+
+    memcpy(&g_EventsBatch.Entries[Offset], &Entry, sizeof(DEBUGGER_EVENTS_BATCH_ENTRY));
+    memcpy(&g_EventsBatch.Entries[Offset + sizeof(DEBUGGER_EVENTS_BATCH_ENTRY)], Buffer, Length);
+
+    g_EventsBatch.CountOfEntries++;
+}
+
+/**
+ * @brief Free the events of the batch of events that are not registered
+ *
+ * @return VOID
+ */
+static VOID
+DebuggerEventsBatchFreeEvents()
+{
+    for (auto Event : g_EventsBatch.Events)
     {
-        //
-        // It's either a debuggee or a local debugging instance
-        //
+        FreeEventsAndActionsMemory(Event, NULL, NULL, NULL);
+    }
 
-        AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+    g_EventsBatch.Events.clear();
+    g_EventsBatch.Entries.clear();
+    g_EventsBatch.CountOfEntries = 0;
+}
 
-        //
-        // Send IOCTL
-        //
+/**
+ * @brief Send the queued events and actions to the kernel in one request
+ * @details the events are added to the list of events if the kernel
+ * applies all of the entries, otherwise the events are freed
+ *
+ * @return BOOLEAN if all of the events are registered then true
+ * otherwise false
+ */
+static BOOLEAN
+DebuggerEventsBatchSend()
+{
+    BOOL                           Status;
+    ULONG                          ReturnedLength;
+    PDEBUGGER_EVENTS_BATCH_REQUEST EventsBatchRequest;
+    UINT32                         RequestLength;
+    BOOLEAN                        HasCustomOutput = FALSE;
+    BOOLEAN                        Result          = FALSE;
+
+    if (g_EventsBatch.CountOfEntries == 0)
+    {
+        return TRUE;
+    }
 
-        Status = DeviceIoControl(g_DeviceHandle,                               // Handle to device
-                                 IOCTL_DEBUGGER_REGISTER_EVENT,                // IO Control code
-                                 Event,                                        // Input Buffer to driver.
-                                 EventBufferLength,                            // Input buffer length
-                                 &ReturnedBuffer,                              // Output Buffer from driver.
-                                 sizeof(DEBUGGER_EVENT_AND_ACTION_REG_BUFFER), // Length
-                                                                               // of
-                                                                               // output
-                                                                               // buffer
-                                                                               // in
-                                                                               // bytes.
-                                 &ReturnedLength,                              // Bytes placed in buffer.
-                                 NULL                                          // synchronous call
+    if (!g_IsSerialConnectedToRemoteDebuggee && !g_DeviceHandle)
+    {
+        ShowMessages(ASSERT_MESSAGE_DRIVER_NOT_LOADED);
+        DebuggerEventsBatchFreeEvents();
+        return FALSE;
+    }
+
+    RequestLength      = SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST + (UINT32)g_EventsBatch.Entries.size();
+    EventsBatchRequest = (PDEBUGGER_EVENTS_BATCH_REQUEST)malloc(RequestLength);
+
+    if (EventsBatchRequest == NULL)
+    {
+        ShowMessages("unable to allocate memory\n\n");
+        DebuggerEventsBatchFreeEvents();
+        return FALSE;
+    }
+
+    RtlZeroMemory(EventsBatchRequest, SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST);
+
+    EventsBatchRequest->CountOfEntries    = g_EventsBatch.CountOfEntries;
+    EventsBatchRequest->EntriesBufferSize = (UINT32)g_EventsBatch.Entries.size();
+
+    memcpy((BYTE *)EventsBatchRequest + SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST,
+           g_EventsBatch.Entries.data(),
+           g_EventsBatch.Entries.size());
+
+    g_EventsBatch.CountOfRequests++;
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        Status = KdSendRegisterEventsBatchPacketToDebuggee(EventsBatchRequest);
+    }
+    else
+    {
+        Status = DeviceIoControl(g_DeviceHandle,                       // Handle to device
+                                 IOCTL_DEBUGGER_REGISTER_EVENTS_BATCH, // IO Control code
+                                 EventsBatchRequest,                   // Input Buffer to driver.
+                                 RequestLength,                        // Input buffer length
+                                 EventsBatchRequest,                   // Output Buffer from driver.
+                                 SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST, // Length of output buffer in bytes.
+                                 &ReturnedLength,                      // Bytes placed in buffer.
+                                 NULL                                  // synchronous call
         );
 
         if (!Status)
         {
             ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
-            return FALSE;
         }
     }
 
-    if (ReturnedBuffer.IsSuccessful && ReturnedBuffer.Error == 0)
+    if (Status && EventsBatchRequest->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
     {
         //
-        // Check for auto-unpause mode
+        // Now, we'll register the events as returned buffer shows that
+        // all of the events were successful
         //
-        if (!g_IsSerialConnectedToRemoteDebuggee && !g_IsSerialConnectedToRemoteDebugger && g_BreakPrintingOutput && g_AutoUnpause)
+        for (auto Event : g_EventsBatch.Events)
         {
-            //
-            // Allow debugger to show its contents
-            //
+            InsertHeadList(&g_EventTrace, &(Event->CommandsEventList));
 
-            //
-            // Set the g_BreakPrintingOutput to FALSE
-            //
-            g_BreakPrintingOutput = FALSE;
+            HasCustomOutput |= Event->HasCustomOutput;
+        }
 
-            //
-            // If it's a remote debugger then we send the remote debuggee a 'g'
-            //
-            if (g_IsConnectedToRemoteDebuggee)
-            {
-                RemoteConnectionSendCommand("g", strlen("g") + 1);
-            }
+        g_EventsBatch.Events.clear();
+        g_EventsBatch.Entries.clear();
+        g_EventsBatch.CountOfEntries = 0;
+
+        //
+        // Events don't generate the messages of muted (or not opened) output sources
+        //
+        if (HasCustomOutput)
+        {
+            ForwardingUpdateEventsOutputState();
+        }
+
+        DebuggerAutoUnpauseAfterRegisteringEvent();
+
+        Result = TRUE;
+    }
+    else if (Status)
+    {
+        ShowMessages("err, none of the events of the batch are registered (entry %d is not applied)\n",
+                     EventsBatchRequest->CountOfAppliedEntries);
+
+        ShowErrorMessage(EventsBatchRequest->KernelStatus);
+
+        DebuggerEventsBatchFreeEvents();
+    }
+    else
+    {
+        DebuggerEventsBatchFreeEvents();
+    }
+
+    free(EventsBatchRequest);
+
+    return Result;
+}
+
+/**
+ * @brief Queue an event (the pending event) and its actions in the batch
+ * of events
+ * @details the buffers of the actions are freed once they're queued, the
+ * queued events are sent once they don't fit in a single packet (in the
+ * debugger mode)
+ *
+ * @param Event the event instance buffer
+ * @param ActionBreakToDebugger the action of breaking into the debugger
+ * @param ActionBreakToDebuggerLength the action of breaking into the debugger (length)
+ * @param ActionCustomCode the action of custom code
+ * @param ActionCustomCodeLength the action of custom code (length)
+ * @param ActionScript the action of script buffer
+ * @param ActionScriptLength the action of script buffer (length)
+ *
+ * @return BOOLEAN if the event is queued then true otherwise false
+ */
+static BOOLEAN
+DebuggerEventsBatchQueue(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
+                         PDEBUGGER_GENERAL_ACTION       ActionBreakToDebugger,
+                         UINT32                         ActionBreakToDebuggerLength,
+                         PDEBUGGER_GENERAL_ACTION       ActionCustomCode,
+                         UINT32                         ActionCustomCodeLength,
+                         PDEBUGGER_GENERAL_ACTION       ActionScript,
+                         UINT32                         ActionScriptLength)
+{
+    UINT64 Length;
+
+    if (g_EventsBatch.PendingEvent != Event)
+    {
+        ShowMessages("err, the event is not queued in the batch of events\n");
+        return FALSE;
+    }
+
+    g_EventsBatch.PendingEvent = NULL;
+
+    Length = DEBUGGER_EVENTS_BATCH_ENTRY_LENGTH((UINT64)g_EventsBatch.PendingEventLength);
+
+    if (ActionBreakToDebugger != NULL)
+    {
+        Length += DEBUGGER_EVENTS_BATCH_ENTRY_LENGTH((UINT64)ActionBreakToDebuggerLength);
+    }
+
+    if (ActionCustomCode != NULL)
+    {
+        Length += DEBUGGER_EVENTS_BATCH_ENTRY_LENGTH((UINT64)ActionCustomCodeLength);
+    }
+
+    if (ActionScript != NULL)
+    {
+        Length += DEBUGGER_EVENTS_BATCH_ENTRY_LENGTH((UINT64)ActionScriptLength);
+    }
+
+    //
+    // In the debugger mode, each request is sent in a single packet
+    //
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        if (Length > MaxSerialEventsBatchBufferSize)
+        {
+            ShowMessages("err, the event and its actions don't fit in a batch of events\n");
+            return FALSE;
+        }
+
+        if (g_EventsBatch.Entries.size() + Length > MaxSerialEventsBatchBufferSize)
+        {
+            DebuggerEventsBatchSend();
+        }
+    }
+
+    DebuggerEventsBatchAddEntry(DEBUGGER_EVENTS_BATCH_ENTRY_EVENT, Event, g_EventsBatch.PendingEventLength);
+
+    if (ActionBreakToDebugger != NULL)
+    {
+        DebuggerEventsBatchAddEntry(DEBUGGER_EVENTS_BATCH_ENTRY_ACTION, ActionBreakToDebugger, ActionBreakToDebuggerLength);
+    }
+
+    if (ActionCustomCode != NULL)
+    {
+        DebuggerEventsBatchAddEntry(DEBUGGER_EVENTS_BATCH_ENTRY_ACTION, ActionCustomCode, ActionCustomCodeLength);
+    }
+
+    if (ActionScript != NULL)
+    {
+        DebuggerEventsBatchAddEntry(DEBUGGER_EVENTS_BATCH_ENTRY_ACTION, ActionScript, ActionScriptLength);
+    }
+
+    //
+    // The actions are copied to the stream, but the event detail is
+    // needed for the 'event' command's list
+    //
+    FreeEventsAndActionsMemory(NULL, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+
+    g_EventsBatch.Events.push_back(Event);
+
+    return TRUE;
+}
+
+/**
+ * @brief Start queueing the events and actions to register them at once
+ *
+ * @return BOOLEAN if the batch is started then true, false if there is
+ * already an active batch
+ */
+BOOLEAN
+DebuggerEventsBatchBegin()
+{
+    if (g_EventsBatch.IsActive)
+    {
+        return FALSE;
+    }
+
+    g_EventsBatch.IsActive           = TRUE;
+    g_EventsBatch.PendingEvent       = NULL;
+    g_EventsBatch.PendingEventLength = 0;
+    g_EventsBatch.CountOfEntries     = 0;
+    g_EventsBatch.CountOfRequests    = 0;
+
+    return TRUE;
+}
+
+/**
+ * @brief Register the queued events and actions and stop queueing them
+ * @details all of the events of each request are applied atomically,
+ * the events are only split into several requests in the debugger mode
+ * if they don't fit in a single packet
+ *
+ * @return BOOLEAN if all of the queued events are registered then true
+ * otherwise false
+ */
+BOOLEAN
+DebuggerEventsBatchCommit()
+{
+    BOOLEAN Result;
+
+    if (!g_EventsBatch.IsActive)
+    {
+        return FALSE;
+    }
+
+    g_EventsBatch.IsActive = FALSE;
+
+    Result = DebuggerEventsBatchSend();
+
+    if (Result)
+    {
+        ShowMessages("the batch of events is registered in %d request(s)\n", g_EventsBatch.CountOfRequests);
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Discard the queued events and actions and stop queueing them
+ *
+ * @return VOID
+ */
+VOID
+DebuggerEventsBatchAbort()
+{
+    g_EventsBatch.IsActive     = FALSE;
+    g_EventsBatch.PendingEvent = NULL;
+
+    DebuggerEventsBatchFreeEvents();
+}
+
+/**
+ * @brief Register the event to the kernel
+ *
+ * @param Event the event structure to send
+ * @param EventBufferLength the buffer length of event
+ * @return BOOLEAN if the request was successful then true
+ * if the request was not successful then false
+ */
+BOOLEAN
+SendEventToKernel(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
+                  UINT32                         EventBufferLength)
+{
+    BOOL                                  Status;
+    ULONG                                 ReturnedLength;
+    DEBUGGER_EVENT_AND_ACTION_REG_BUFFER  ReturnedBuffer = {0};
+    PDEBUGGER_EVENT_AND_ACTION_REG_BUFFER TempRegResult;
+
+    if (g_EventsBatch.IsActive)
+    {
+        //
+        // The event is queued along with its actions
+        //
+        g_EventsBatch.PendingEvent       = Event;
+        g_EventsBatch.PendingEventLength = EventBufferLength;
+
+        return TRUE;
+    }
 
-            ShowMessages("\n");
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        //
+        // It's a debuggger, we should send the events buffer directly
+        // from here
+        //
+
+        //
+        // Send the buffer from here
+        //
+        TempRegResult = KdSendRegisterEventPacketToDebuggee(Event, EventBufferLength);
+
+        //
+        // Move the buffer to local buffer
+        //
+        memcpy(&ReturnedBuffer, TempRegResult, sizeof(DEBUGGER_EVENT_AND_ACTION_REG_BUFFER));
+    }
+    else
+    {
+        //
+        // It's either a debuggee or a local debugging instance
+        //
+
+        AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+        //
+        // Send IOCTL
+        //
+
+        Status = DeviceIoControl(g_DeviceHandle,                               // Handle to device
+                                 IOCTL_DEBUGGER_REGISTER_EVENT,                // IO Control code
+                                 Event,                                        // Input Buffer to driver.
+                                 EventBufferLength,                            // Input buffer length
+                                 &ReturnedBuffer,                              // Output Buffer from driver.
+                                 sizeof(DEBUGGER_EVENT_AND_ACTION_REG_BUFFER), // Length
+                                                                               // of
+                                                                               // output
+                                                                               // buffer
+                                                                               // in
+                                                                               // bytes.
+                                 &ReturnedLength,                              // Bytes placed in buffer.
+                                 NULL                                          // synchronous call
+        );
+
+        if (!Status)
+        {
+            ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+            return FALSE;
         }
     }
+
+    if (ReturnedBuffer.IsSuccessful && ReturnedBuffer.Error == 0)
+    {
+        DebuggerAutoUnpauseAfterRegisteringEvent();
+    }
     else
     {
         //
@@ -1823,6 +2470,17 @@ RegisterActionToEvent(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
     DEBUGGER_EVENT_AND_ACTION_REG_BUFFER  ReturnedBuffer = {0};
     PDEBUGGER_EVENT_AND_ACTION_REG_BUFFER TempAddingResult;
 
+    if (g_EventsBatch.IsActive)
+    {
+        return DebuggerEventsBatchQueue(Event,
+                                        ActionBreakToDebugger,
+                                        ActionBreakToDebuggerLength,
+                                        ActionCustomCode,
+                                        ActionCustomCodeLength,
+                                        ActionScript,
+                                        ActionScriptLength);
+    }
+
     if (g_IsSerialConnectedToRemoteDebuggee)
     {
         //
@@ -1994,19 +2652,181 @@ RegisterActionToEvent(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
     //
     InsertHeadList(&g_EventTrace, &(Event->CommandsEventList));
 
+    //
+    // Events don't generate the messages of muted (or not opened) output sources
+    //
+    if (Event->HasCustomOutput)
+    {
+        ForwardingUpdateEventsOutputState();
+    }
+
     return TRUE;
 }
 
-/**
- * @brief Get the New Debugger Event Tag object and increase the
- * global variable for tag
- *
- * @return UINT64
- */
-UINT64
-GetNewDebuggerEventTag()
-{
-    return g_EventTag++;
+/**
+ * @brief Get the New Debugger Event Tag object and increase the
+ * global variable for tag
+ *
+ * @return UINT64
+ */
+UINT64
+GetNewDebuggerEventTag()
+{
+    return g_EventTag++;
+}
+
+/**
+ * @brief Register an event without interpreting a command (used by the SDK)
+ * @details the action is running the script if it's available, otherwise
+ * running the custom code if it's available, otherwise breaking to the
+ * debugger
+ *
+ * @param Registration The details of the event
+ *
+ * @return UINT64 The tag of the event or zero if it's not registered
+ */
+UINT64
+HyperDbgRegisterEvent(PHYPERDBG_EVENT_REGISTRATION Registration)
+{
+    PDEBUGGER_GENERAL_EVENT_DETAIL Event            = NULL;
+    PDEBUGGER_GENERAL_ACTION       ActionBreak      = NULL;
+    PDEBUGGER_GENERAL_ACTION       ActionCustomCode = NULL;
+    PDEBUGGER_GENERAL_ACTION       ActionScript     = NULL;
+    UINT32                         ActionLength     = 0;
+    PVOID                          CodeBuffer       = NULL;
+    UINT64                         Tag;
+    CHAR                           CommandString[64];
+
+    Event = (PDEBUGGER_GENERAL_EVENT_DETAIL)malloc(sizeof(DEBUGGER_GENERAL_EVENT_DETAIL));
+
+    if (Event == NULL)
+    {
+        return 0;
+    }
+
+    RtlZeroMemory(Event, sizeof(DEBUGGER_GENERAL_EVENT_DETAIL));
+
+    Event->IsEnabled             = TRUE;
+    Event->Tag                   = GetNewDebuggerEventTag();
+    Event->CreationTime          = time(0);
+    Event->EventType             = Registration->EventType;
+    Event->EventMode             = Registration->EventMode;
+    Event->CoreId                = Registration->CoreId;
+    Event->ProcessId             = Registration->ProcessId;
+    Event->ThreadId              = Registration->ThreadId;
+    Event->EnableShortCircuiting = Registration->EnableShortCircuiting;
+    Event->OptionalParam1        = Registration->OptionalParam1;
+    Event->OptionalParam2        = Registration->OptionalParam2;
+    Event->OptionalParam3        = Registration->OptionalParam3;
+    Event->OptionalParam4        = Registration->OptionalParam4;
+    Event->CountOfActions        = 1;
+
+    //
+    // The 'events' command shows the command of the event
+    //
+    sprintf_s(CommandString, sizeof(CommandString), "HyperDbgRegisterEvent (type: %x)", Registration->EventType);
+
+    Event->CommandStringBuffer = malloc(strlen(CommandString) + 1);
+
+    if (Event->CommandStringBuffer == NULL)
+    {
+        free(Event);
+        return 0;
+    }
+
+    strcpy_s((char *)Event->CommandStringBuffer, strlen(CommandString) + 1, CommandString);
+
+    if (Registration->Script != NULL)
+    {
+        CodeBuffer = ScriptEngineParseWrapper((char *)Registration->Script, TRUE);
+
+        if (CodeBuffer == NULL)
+        {
+            FreeEventsAndActionsMemory(Event, NULL, NULL, NULL);
+            return 0;
+        }
+
+        ActionLength = sizeof(DEBUGGER_GENERAL_ACTION) + ScriptEngineWrapperGetSize(CodeBuffer);
+        ActionScript = (PDEBUGGER_GENERAL_ACTION)malloc(ActionLength);
+
+        if (ActionScript != NULL)
+        {
+            RtlZeroMemory(ActionScript, ActionLength);
+
+            memcpy((PVOID)((UINT64)ActionScript + sizeof(DEBUGGER_GENERAL_ACTION)),
+                   (PVOID)ScriptEngineWrapperGetHead(CodeBuffer),
+                   ScriptEngineWrapperGetSize(CodeBuffer));
+
+            ActionScript->EventTag            = Event->Tag;
+            ActionScript->ActionType          = RUN_SCRIPT;
+            ActionScript->ScriptBufferSize    = ScriptEngineWrapperGetSize(CodeBuffer);
+            ActionScript->ScriptBufferPointer = ScriptEngineWrapperGetPointer(CodeBuffer);
+        }
+
+        ScriptEngineWrapperRemoveSymbolBuffer(CodeBuffer);
+    }
+    else if (Registration->CustomCode != NULL)
+    {
+        ActionLength     = sizeof(DEBUGGER_GENERAL_ACTION) + Registration->CustomCodeSize;
+        ActionCustomCode = (PDEBUGGER_GENERAL_ACTION)malloc(ActionLength);
+
+        if (ActionCustomCode != NULL)
+        {
+            RtlZeroMemory(ActionCustomCode, ActionLength);
+
+            memcpy((PVOID)((UINT64)ActionCustomCode + sizeof(DEBUGGER_GENERAL_ACTION)),
+                   Registration->CustomCode,
+                   Registration->CustomCodeSize);
+
+            ActionCustomCode->EventTag             = Event->Tag;
+            ActionCustomCode->ActionType           = RUN_CUSTOM_CODE;
+            ActionCustomCode->CustomCodeBufferSize = Registration->CustomCodeSize;
+        }
+    }
+    else
+    {
+        ActionLength = sizeof(DEBUGGER_GENERAL_ACTION);
+        ActionBreak  = (PDEBUGGER_GENERAL_ACTION)malloc(ActionLength);
+
+        if (ActionBreak != NULL)
+        {
+            RtlZeroMemory(ActionBreak, ActionLength);
+
+            ActionBreak->EventTag   = Event->Tag;
+            ActionBreak->ActionType = BREAK_TO_DEBUGGER;
+        }
+    }
+
+    if (ActionBreak == NULL && ActionCustomCode == NULL && ActionScript == NULL)
+    {
+        ShowMessages("err, allocation error\n");
+        FreeEventsAndActionsMemory(Event, NULL, NULL, NULL);
+        return 0;
+    }
+
+    //
+    // Check if list is initialized or not
+    //
+    if (!g_EventTraceInitialized)
+    {
+        InitializeListHead(&g_EventTrace);
+        g_EventTraceInitialized = TRUE;
+    }
+
+    //
+    // Send the event and its action to the kernel (the event is added to
+    // the list of events once its action is registered)
+    //
+    Tag = Event->Tag;
+
+    if (!SendEventToKernel(Event, sizeof(DEBUGGER_GENERAL_EVENT_DETAIL)) ||
+        !RegisterActionToEvent(Event, ActionBreak, ActionLength, ActionCustomCode, ActionLength, ActionScript, ActionLength))
+    {
+        FreeEventsAndActionsMemory(Event, ActionBreak, ActionCustomCode, ActionScript);
+        return 0;
+    }
+
+    return Tag;
 }
 
 /**
@@ -2045,6 +2865,74 @@ FreeEventsAndActionsMemory(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
     }
 }
 
+/**
+ * @brief Interpret the values that are recorded on each hit of the event
+ * @details values are separated by comma, each value is either a register
+ * (e.g., rcx) or 64-bit memory at a register plus a hex offset (e.g.,
+ * [rsp+8] or [rbp-10])
+ *
+ * @param Values the values of the 'record'
+ * @param RecordConfiguration the configuration to fill
+ * @return BOOLEAN TRUE if the values are valid
+ */
+BOOLEAN
+InterpretEventRecordValues(string                               Values,
+                           PDEBUGGER_EVENT_RECORD_CONFIGURATION RecordConfiguration)
+{
+    vector<string> SplittedValues = Split(Values, ',');
+
+    if (SplittedValues.size() == 0 || SplittedValues.size() > EventRecordMaximumValues)
+    {
+        return FALSE;
+    }
+
+    for (auto & Item : SplittedValues)
+    {
+        PDEBUGGER_EVENT_RECORD_VALUE Value = &RecordConfiguration->Values[RecordConfiguration->CountOfValues];
+        string                       Register;
+        UINT32                       Offset = 0;
+        size_t                       SignPosition;
+
+        if (Item.size() > 2 && Item.front() == '[' && Item.back() == ']')
+        {
+            Value->IsMemory = TRUE;
+            Register        = Item.substr(1, Item.size() - 2);
+
+            //
+            // Check for the offset from the register
+            //
+            SignPosition = Register.find_first_of("+-");
+
+            if (SignPosition != string::npos)
+            {
+                if (!ConvertStringToUInt32(Register.substr(SignPosition + 1), &Offset))
+                {
+                    return FALSE;
+                }
+
+                Value->Offset = Register.at(SignPosition) == '-' ? -(INT32)Offset : (INT32)Offset;
+                Register      = Register.substr(0, SignPosition);
+            }
+        }
+        else
+        {
+            Register = Item;
+        }
+
+        auto Iter = RegistersMap.find(Register);
+
+        if (Iter == RegistersMap.end())
+        {
+            return FALSE;
+        }
+
+        Value->Register = Iter->second;
+        RecordConfiguration->CountOfValues++;
+    }
+
+    return TRUE;
+}
+
 /**
  * @brief Interpret general event fields
  *
@@ -2107,14 +2995,24 @@ InterpretGeneralEventAndActionsFields(
     BOOLEAN                        HasCodeBuffer                    = FALSE;
     BOOLEAN                        HasScript                        = FALSE;
     BOOLEAN                        IsNextCommandPid                 = FALSE;
+    BOOLEAN                        IsNextCommandTid                 = FALSE;
     BOOLEAN                        IsNextCommandCoreId              = FALSE;
     BOOLEAN                        IsNextCommandBufferSize          = FALSE;
     BOOLEAN                        IsNextCommandImmediateMessaging  = FALSE;
     BOOLEAN                        IsNextCommandExecutionMode       = FALSE;
     BOOLEAN                        IsNextCommandSc                  = FALSE;
+    BOOLEAN                        IsNextCommandRateLimit           = FALSE;
+    BOOLEAN                        IsNextCommandLbr                 = FALSE;
+    BOOLEAN                        IsNextCommandRecord              = FALSE;
+    BOOLEAN                        IsNextCommandBudget              = FALSE;
     BOOLEAN                        ImmediateMessagePassing          = UseImmediateMessagingByDefaultOnEvents;
     UINT32                         CoreId;
     UINT32                         ProcessId;
+    UINT32                         ThreadId;
+    UINT32                         RateLimit;
+    UINT32                         LastBranchRecordsCount = 0;
+    DEBUGGER_EVENT_RECORD_CONFIGURATION RecordConfiguration = {0};
+    UINT32                         ScriptInstructionsBudget = 0;
     UINT32                         IndexOfValidSourceTags;
     UINT32                         RequestBuffer = 0;
     PLIST_ENTRY                    TempList;
@@ -2482,6 +3380,11 @@ InterpretGeneralEventAndActionsFields(
         TempEvent->ProcessId = DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES;
     }
 
+    //
+    // By default, the event is not limited to a special thread
+    //
+    TempEvent->ThreadId = DEBUGGER_EVENT_APPLY_TO_ALL_THREADS;
+
     //
     // Set the event type
     //
@@ -2794,6 +3697,121 @@ InterpretGeneralEventAndActionsFields(
             continue;
         }
 
+        if (IsNextCommandTid)
+        {
+            if (!Section.compare("all"))
+            {
+                TempEvent->ThreadId = DEBUGGER_EVENT_APPLY_TO_ALL_THREADS;
+            }
+            else if (!ConvertStringToUInt32(Section, &ThreadId))
+            {
+                ShowMessages("err, tid is invalid\n");
+                *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+
+                goto ReturnWithError;
+            }
+            else
+            {
+                //
+                // Set the specific thread id
+                //
+                TempEvent->ThreadId = ThreadId;
+            }
+
+            IsNextCommandTid = FALSE;
+
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            continue;
+        }
+
+        if (IsNextCommandRateLimit)
+        {
+            if (!ConvertStringToUInt32(Section, &RateLimit) || RateLimit == 0)
+            {
+                ShowMessages("err, rate limit is invalid\n");
+                *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+                goto ReturnWithError;
+            }
+            else
+            {
+                //
+                // Set the maximum triggers per second on each core
+                //
+                TempEvent->RateLimit = RateLimit;
+            }
+            IsNextCommandRateLimit = FALSE;
+
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            continue;
+        }
+
+        if (IsNextCommandLbr)
+        {
+            if (!ConvertStringToUInt32(Section, &LastBranchRecordsCount) ||
+                LastBranchRecordsCount == 0 ||
+                LastBranchRecordsCount > LastBranchRecordsMaximumCount)
+            {
+                ShowMessages("err, count of the last branch records is invalid (it should be between 1 and %x)\n",
+                             LastBranchRecordsMaximumCount);
+                *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+                goto ReturnWithError;
+            }
+            IsNextCommandLbr = FALSE;
+
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            continue;
+        }
+
+        if (IsNextCommandRecord)
+        {
+            if (!InterpretEventRecordValues(Section, &RecordConfiguration))
+            {
+                ShowMessages("err, values of the records are invalid (at most %x registers or [register+offset] "
+                             "memory values, separated by comma)\n",
+                             EventRecordMaximumValues);
+                *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+                goto ReturnWithError;
+            }
+            IsNextCommandRecord = FALSE;
+
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            continue;
+        }
+
+        if (IsNextCommandBudget)
+        {
+            if (!ConvertStringToUInt32(Section, &ScriptInstructionsBudget) || ScriptInstructionsBudget == 0)
+            {
+                ShowMessages("err, instruction budget of the script is invalid\n");
+                *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+                goto ReturnWithError;
+            }
+            IsNextCommandBudget = FALSE;
+
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            continue;
+        }
+
         if (IsNextCommandCoreId)
         {
             if (!ConvertStringToUInt32(Section, &CoreId))
@@ -2830,6 +3848,17 @@ InterpretGeneralEventAndActionsFields(
 
             continue;
         }
+        if (!Section.compare("tid"))
+        {
+            IsNextCommandTid = TRUE;
+
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            continue;
+        }
         if (!Section.compare("core"))
         {
             IsNextCommandCoreId = TRUE;
@@ -2887,6 +3916,54 @@ InterpretGeneralEventAndActionsFields(
             continue;
         }
 
+        if (!Section.compare("ratelimit"))
+        {
+            IsNextCommandRateLimit = TRUE;
+
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            continue;
+        }
+
+        if (!Section.compare("lbr"))
+        {
+            IsNextCommandLbr = TRUE;
+
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            continue;
+        }
+
+        if (!Section.compare("record"))
+        {
+            IsNextCommandRecord = TRUE;
+
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            continue;
+        }
+
+        if (!Section.compare("budget"))
+        {
+            IsNextCommandBudget = TRUE;
+
+            //
+            // Add index to remove it from the command
+            //
+            IndexesToRemove.push_back(Index);
+
+            continue;
+        }
+
         if (!Section.compare("buffer"))
         {
             IsNextCommandBufferSize = TRUE;
@@ -2919,6 +3996,14 @@ InterpretGeneralEventAndActionsFields(
         goto ReturnWithError;
     }
 
+    if (IsNextCommandTid)
+    {
+        ShowMessages("err, please specify a value for 'tid'\n");
+        *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+
+        goto ReturnWithError;
+    }
+
     if (IsNextCommandBufferSize)
     {
         ShowMessages("err, please specify a value for 'buffer'\n");
@@ -2951,6 +4036,115 @@ InterpretGeneralEventAndActionsFields(
         goto ReturnWithError;
     }
 
+    if (IsNextCommandRateLimit)
+    {
+        ShowMessages("err, please specify a value for 'ratelimit'\n");
+        *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+
+        goto ReturnWithError;
+    }
+
+    if (IsNextCommandLbr)
+    {
+        ShowMessages("err, please specify a value for 'lbr'\n");
+        *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+
+        goto ReturnWithError;
+    }
+
+    if (IsNextCommandRecord)
+    {
+        ShowMessages("err, please specify a value for 'record'\n");
+        *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+
+        goto ReturnWithError;
+    }
+
+    if (IsNextCommandBudget)
+    {
+        ShowMessages("err, please specify a value for 'budget'\n");
+        *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+
+        goto ReturnWithError;
+    }
+
+    //
+    // The instruction budget is only applied to the scripts
+    //
+    if (ScriptInstructionsBudget != 0)
+    {
+        if (TempActionScript == NULL)
+        {
+            ShowMessages("err, the instruction budget is only applied to the scripts of events\n");
+            *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+
+            goto ReturnWithError;
+        }
+
+        TempActionScript->ScriptInstructionsBudget = ScriptInstructionsBudget;
+    }
+
+    //
+    // Show the last branch records along with the first action, in vmi-mode
+    // it's not possible to break to the debugger, so showing the last branch
+    // records is the only action
+    //
+    if (LastBranchRecordsCount != 0)
+    {
+        if (TempActionBreak != NULL)
+        {
+            if (!g_IsSerialConnectedToRemoteDebuggee)
+            {
+                TempActionBreak->ActionType = SHOW_LAST_BRANCH_RECORDS;
+            }
+
+            TempActionBreak->LastBranchRecordsCount = LastBranchRecordsCount;
+        }
+        else if (TempActionCustomCode != NULL)
+        {
+            TempActionCustomCode->LastBranchRecordsCount = LastBranchRecordsCount;
+        }
+        else if (TempActionScript != NULL)
+        {
+            TempActionScript->LastBranchRecordsCount = LastBranchRecordsCount;
+        }
+    }
+
+    //
+    // Record the hits along with the first action, the records are taken
+    // from the buffers of the cores by '!records' which is only supported
+    // in vmi-mode, so recording the hits is the only action instead of
+    // breaking to the debugger
+    //
+    if (RecordConfiguration.CountOfValues != 0)
+    {
+        if (g_IsSerialConnectedToRemoteDebuggee)
+        {
+            ShowMessages("err, recording the hits is only supported in the VMI Mode\n");
+            *ReasonForErrorInParsing = DEBUGGER_EVENT_PARSING_ERROR_CAUSE_FORMAT_ERROR;
+
+            goto ReturnWithError;
+        }
+
+        if (TempActionBreak != NULL)
+        {
+            if (TempActionBreak->ActionType == BREAK_TO_DEBUGGER)
+            {
+                TempActionBreak->ActionType = RECORD_HITS;
+            }
+
+            TempActionBreak->RecordConfiguration = RecordConfiguration;
+        }
+        else if (TempActionCustomCode != NULL)
+        {
+            TempActionCustomCode->RecordConfiguration = RecordConfiguration;
+        }
+        else if (TempActionScript != NULL)
+        {
+            TempActionScript->RecordConfiguration = RecordConfiguration;
+        }
+    }
+
     //
     // Check to make sure that short-circuiting is not used in post-events
     //
@@ -2967,7 +4161,7 @@ InterpretGeneralEventAndActionsFields(
     //
     // It's not possible to break to debugger in vmi-mode
     //
-    if (!g_IsSerialConnectedToRemoteDebuggee && TempActionBreak != NULL)
+    if (!g_IsSerialConnectedToRemoteDebuggee && TempActionBreak != NULL && TempActionBreak->ActionType == BREAK_TO_DEBUGGER)
     {
         ShowMessages(
             "err, it's not possible to break to the debugger in VMI Mode. "
@@ -18,6 +18,7 @@ using namespace std;
 //
 extern ACTIVE_DEBUGGING_PROCESS g_ActiveProcessDebuggingState;
 extern CommandType              g_CommandsList;
+extern COMMANDS_LOOKUP_TABLE    g_CommandsLookupTable;
 
 extern BOOLEAN g_ShouldPreviousCommandBeContinued;
 extern BOOLEAN g_IsCommandListInitialized;
@@ -49,9 +50,10 @@ extern string g_ServerIp;
 int
 HyperDbgInterpreter(char * Command)
 {
-    BOOLEAN               HelpCommand       = FALSE;
-    UINT64                CommandAttributes = NULL;
-    CommandType::iterator Iterator;
+    BOOLEAN                  HelpCommand       = FALSE;
+    UINT64                   CommandAttributes = NULL;
+    PCOMMAND_DETAIL          CommandDetail;
+    vector<std::string_view> Tokens;
 
     //
     // Check if it's the first command and whether the mapping of command is
@@ -82,32 +84,35 @@ HyperDbgInterpreter(char * Command)
     InterpreterRemoveComments(Command);
 
     //
-    // Convert to string
+    // The command is split once, the tokens are views of the command, so
+    // nothing is copied for finding the command or sending it to the
+    // remote computer
     //
-    string CommandString(Command);
-
-    //
-    // Convert to lower case
-    //
-    transform(CommandString.begin(), CommandString.end(), CommandString.begin(), [](unsigned char c) { return std::tolower(c); });
-
-    vector<string> SplittedCommand {Split(CommandString, ' ')};
+    Tokens = SplitView(Command, ' ');
 
     //
     // Check if user entered an empty imput
     //
-    if (SplittedCommand.empty())
+    if (Tokens.empty())
     {
         ShowMessages("\n");
         return 0;
     }
 
-    string FirstCommand = SplittedCommand.front();
-
     //
-    // Read the command's attributes
+    // Read the command's attributes (the command is looked up once and
+    // the same entry is used for running the command)
     //
-    CommandAttributes = GetCommandAttributes(FirstCommand);
+    CommandDetail = InterpreterFindCommand(Tokens.front());
+
+    if (CommandDetail == NULL)
+    {
+        CommandAttributes = DEBUGGER_COMMAND_ATTRIBUTE_ABSOLUTE_LOCAL;
+    }
+    else
+    {
+        CommandAttributes = CommandDetail->CommandAttrib;
+    }
 
     //
     // Check if the command needs to be continued by pressing enter
@@ -182,71 +187,82 @@ HyperDbgInterpreter(char * Command)
     }
 
     //
-    // Detect whether it's a .help command or not
+    // Detect whether it's a .help command or not (the help commands
+    // are the only commands without a handler)
     //
-    if (!FirstCommand.compare(".help") || !FirstCommand.compare("help") ||
-        !FirstCommand.compare(".hh"))
+    if (CommandDetail != NULL && CommandDetail->CommandFunction == NULL)
     {
-        if (SplittedCommand.size() == 2)
+        if (Tokens.size() == 2)
         {
             //
             // Show that it's a help command
             //
-            HelpCommand  = TRUE;
-            FirstCommand = SplittedCommand.at(1);
+            HelpCommand   = TRUE;
+            CommandDetail = InterpreterFindCommand(Tokens.at(1));
         }
         else
         {
-            ShowMessages("incorrect use of '%s'\n", FirstCommand.c_str());
+            ShowMessages("incorrect use of '%.*s'\n", (int)Tokens.front().size(), Tokens.front().data());
             CommandHelpHelp();
             return 0;
         }
     }
 
-    //
-    // Start parsing commands
-    //
-    Iterator = g_CommandsList.find(FirstCommand);
-
-    if (Iterator == g_CommandsList.end())
+    if (CommandDetail == NULL)
     {
         //
         //  Command doesn't exist
         //
-        string         CaseSensitiveCommandString(Command);
-        vector<string> CaseSensitiveSplittedCommand {Split(CaseSensitiveCommandString, ' ')};
-
         if (!HelpCommand)
         {
-            ShowMessages("err, couldn't resolve command at '%s'\n", CaseSensitiveSplittedCommand.front().c_str());
+            ShowMessages("err, couldn't resolve command at '%.*s'\n", (int)Tokens.front().size(), Tokens.front().data());
         }
         else
         {
-            ShowMessages("err, couldn't find the help for the command at '%s'\n",
-                         CaseSensitiveSplittedCommand.at(1).c_str());
+            ShowMessages("err, couldn't find the help for the command at '%.*s'\n",
+                         (int)Tokens.at(1).size(),
+                         Tokens.at(1).data());
         }
     }
     else
     {
         if (HelpCommand)
         {
-            Iterator->second.CommandHelpFunction();
+            CommandDetail->CommandHelpFunction();
         }
         else
         {
             //
-            // Check if command is case-sensitive or not
+            // The tokens that are passed to the command are in lower case
             //
-            if ((Iterator->second.CommandAttrib &
-                 DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_CASE_SENSITIVE))
+            vector<string> SplittedCommand;
+
+            SplittedCommand.reserve(Tokens.size());
+
+            for (auto Token : Tokens)
             {
-                string CaseSensitiveCommandString(Command);
-                Iterator->second.CommandFunction(SplittedCommand, CaseSensitiveCommandString);
+                string & Section = SplittedCommand.emplace_back(Token);
+                transform(Section.begin(), Section.end(), Section.begin(), [](unsigned char c) { return std::tolower(c); });
             }
-            else
+
+            //
+            // Check if command is case-sensitive or not
+            //
+            string CommandString(Command);
+
+            if (!(CommandDetail->CommandAttrib & DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_CASE_SENSITIVE))
             {
-                Iterator->second.CommandFunction(SplittedCommand, CommandString);
+                transform(CommandString.begin(), CommandString.end(), CommandString.begin(), [](unsigned char c) { return std::tolower(c); });
             }
+
+            //
+            // Messages of events are held while the command is executed
+            //
+            MessageLanesBeginInteractiveCommand();
+
+            CommandDetail->CommandFunction(SplittedCommand, CommandString);
+
+            MessageLanesEndInteractiveCommand();
         }
     }
 
@@ -318,6 +334,176 @@ InterpreterRemoveComments(char * CommandText)
     }
 }
 
+/**
+ * @brief Hash a command for the lookup table of commands
+ * @details FNV-1a of the lower case characters of the command, the seed
+ * selects a different hash function for each bucket
+ *
+ * @param Command
+ * @param Seed
+ * @return UINT32
+ */
+static UINT32
+InterpreterHashCommand(std::string_view Command, UINT32 Seed)
+{
+    UINT32 Hash = 0x811c9dc5 ^ (Seed * 0x9e3779b9);
+
+    for (unsigned char c : Command)
+    {
+        Hash ^= (UINT32)std::tolower(c);
+        Hash *= 0x01000193;
+    }
+
+    //
+    // The lower bits are used as the index, so the upper bits are mixed
+    // into them
+    //
+    return Hash ^ (Hash >> 16);
+}
+
+/**
+ * @brief Build the perfect hash table of the commands
+ * @details the buckets with more commands are placed first, a seed is
+ * searched for each of them that puts its commands into free slots, the
+ * buckets with one command are then put directly into the remaining slots
+ *
+ * @return VOID
+ */
+VOID
+InterpreterBuildCommandsLookupTable()
+{
+    vector<vector<CommandType::pointer>> Buckets;
+    vector<UINT32>                       Order;
+    vector<UINT32>                       SlotsOfBucket;
+    UINT32                               CountOfSlots = 1;
+    UINT32                               FreeSlot     = 0;
+    UINT32                               Slot;
+    UINT32                               Seed;
+
+    //
+    // The table has at least twice the slots of the commands, so a seed
+    // is found in a few tries
+    //
+    while (CountOfSlots < 2 * g_CommandsList.size())
+    {
+        CountOfSlots <<= 1;
+    }
+
+    Buckets.resize(CountOfSlots);
+
+    for (auto & Entry : g_CommandsList)
+    {
+        Buckets[InterpreterHashCommand(Entry.first, 0) & (CountOfSlots - 1)].push_back(&Entry);
+    }
+
+    g_CommandsLookupTable.Seeds.assign(CountOfSlots, 0);
+    g_CommandsLookupTable.Slots.assign(CountOfSlots, NULL);
+
+    Order.resize(CountOfSlots);
+    std::iota(Order.begin(), Order.end(), 0);
+    std::stable_sort(Order.begin(), Order.end(), [&Buckets](UINT32 A, UINT32 B) { return Buckets[A].size() > Buckets[B].size(); });
+
+    for (UINT32 Bucket : Order)
+    {
+        if (Buckets[Bucket].empty())
+        {
+            break;
+        }
+
+        if (Buckets[Bucket].size() == 1)
+        {
+            //
+            // The slot is kept in the seed
+            //
+            while (g_CommandsLookupTable.Slots[FreeSlot] != NULL)
+            {
+                FreeSlot++;
+            }
+
+            g_CommandsLookupTable.Slots[FreeSlot] = Buckets[Bucket].front();
+            g_CommandsLookupTable.Seeds[Bucket]   = -(INT32)FreeSlot - 1;
+
+            continue;
+        }
+
+        for (Seed = 1;; Seed++)
+        {
+            SlotsOfBucket.clear();
+
+            for (auto Entry : Buckets[Bucket])
+            {
+                Slot = InterpreterHashCommand(Entry->first, Seed) & (CountOfSlots - 1);
+
+                if (g_CommandsLookupTable.Slots[Slot] != NULL ||
+                    std::find(SlotsOfBucket.begin(), SlotsOfBucket.end(), Slot) != SlotsOfBucket.end())
+                {
+                    break;
+                }
+
+                SlotsOfBucket.push_back(Slot);
+            }
+
+            if (SlotsOfBucket.size() == Buckets[Bucket].size())
+            {
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < SlotsOfBucket.size(); i++)
+        {
+            g_CommandsLookupTable.Slots[SlotsOfBucket[i]] = Buckets[Bucket][i];
+        }
+
+        g_CommandsLookupTable.Seeds[Bucket] = Seed;
+    }
+}
+
+/**
+ * @brief Find a command in the perfect hash table of the commands
+ * @details the command is compared case-insensitively, so it's not
+ * needed to be converted to lower case first
+ *
+ * @param Command The first token of the command
+ * @return PCOMMAND_DETAIL The details of the command or NULL if the command
+ * doesn't exist
+ */
+PCOMMAND_DETAIL
+InterpreterFindCommand(std::string_view Command)
+{
+    INT32                Seed;
+    UINT32               Slot;
+    CommandType::pointer Entry;
+    UINT32               Mask = (UINT32)g_CommandsLookupTable.Slots.size() - 1;
+
+    if (g_CommandsLookupTable.Slots.empty())
+    {
+        return NULL;
+    }
+
+    Seed = g_CommandsLookupTable.Seeds[InterpreterHashCommand(Command, 0) & Mask];
+
+    if (Seed < 0)
+    {
+        Slot = -Seed - 1;
+    }
+    else
+    {
+        Slot = InterpreterHashCommand(Command, Seed) & Mask;
+    }
+
+    Entry = g_CommandsLookupTable.Slots[Slot];
+
+    if (Entry == NULL || Entry->first.size() != Command.size() ||
+        !std::equal(Command.begin(), Command.end(), Entry->first.begin(), [](unsigned char A, unsigned char B) {
+            return std::tolower(A) == B;
+        }))
+    {
+        return NULL;
+    }
+
+    return &Entry->second;
+}
+
 /**
  * @brief Show signature of HyperDbg
  *
@@ -494,16 +680,16 @@ HyperDbgContinuePreviousCommand()
 UINT64
 GetCommandAttributes(const string & FirstCommand)
 {
-    CommandType::iterator Iterator;
+    PCOMMAND_DETAIL CommandDetail;
 
     //
     // Some commands should not be passed to the remote system
     // and instead should be handled in the current debugger
     //
 
-    Iterator = g_CommandsList.find(FirstCommand);
+    CommandDetail = InterpreterFindCommand(FirstCommand);
 
-    if (Iterator == g_CommandsList.end())
+    if (CommandDetail == NULL)
     {
         //
         // Command doesn't exist, if it's not exists then it's better to handle
@@ -513,7 +699,7 @@ GetCommandAttributes(const string & FirstCommand)
     }
     else
     {
-        return Iterator->second.CommandAttrib;
+        return CommandDetail->CommandAttrib;
     }
 
     return NULL;
@@ -532,6 +718,11 @@ InitializeDebugger()
     //
     InitializeCommandsDictionary();
 
+    //
+    // Build the table for finding the commands
+    //
+    InterpreterBuildCommandsLookupTable();
+
     //
     // Set the callback for symbol message handler
     //
@@ -594,6 +785,8 @@ InitializeCommandsDictionary()
     g_CommandsList["g"]  = {&CommandG, &CommandGHelp, DEBUGGER_COMMAND_G_ATTRIBUTES};
     g_CommandsList["go"] = {&CommandG, &CommandGHelp, DEBUGGER_COMMAND_G_ATTRIBUTES};
 
+    g_CommandsList["gi"] = {&CommandGi, &CommandGiHelp, DEBUGGER_COMMAND_GI_ATTRIBUTES};
+
     g_CommandsList[".attach"] = {&CommandAttach, &CommandAttachHelp, DEBUGGER_COMMAND_ATTACH_ATTRIBUTES};
     g_CommandsList["attach"]  = {&CommandAttach, &CommandAttachHelp, DEBUGGER_COMMAND_ATTACH_ATTRIBUTES};
 
@@ -631,6 +824,8 @@ InitializeCommandsDictionary()
     g_CommandsList[".disconnect"] = {&CommandDisconnect, &CommandDisconnectHelp, DEBUGGER_COMMAND_DISCONNECT_ATTRIBUTES};
     g_CommandsList["disconnect"]  = {&CommandDisconnect, &CommandDisconnectHelp, DEBUGGER_COMMAND_DISCONNECT_ATTRIBUTES};
 
+    g_CommandsList[".session"] = {&CommandSession, &CommandSessionHelp, DEBUGGER_COMMAND_SESSION_ATTRIBUTES};
+
     g_CommandsList[".debug"] = {&CommandDebug, &CommandDebugHelp, DEBUGGER_COMMAND_DEBUG_ATTRIBUTES};
     g_CommandsList["debug"]  = {&CommandDebug, &CommandDebugHelp, DEBUGGER_COMMAND_DEBUG_ATTRIBUTES};
 
@@ -663,6 +858,8 @@ InitializeCommandsDictionary()
 
     g_CommandsList[".logclose"] = {&CommandLogclose, &CommandLogcloseHelp, DEBUGGER_COMMAND_LOGCLOSE_ATTRIBUTES};
 
+    g_CommandsList[".counters"] = {&CommandCounters, &CommandCountersHelp, DEBUGGER_COMMAND_COUNTERS_ATTRIBUTES};
+
     g_CommandsList["test"] = {&CommandTest, &CommandTestHelp, DEBUGGER_COMMAND_TEST_ATTRIBUTES};
 
     g_CommandsList["cpu"] = {&CommandCpu, &CommandCpuHelp, DEBUGGER_COMMAND_CPU_ATTRIBUTES};
@@ -715,6 +912,8 @@ InitializeCommandsDictionary()
 
     g_CommandsList["!crwrite"] = {&CommandCrwrite, &CommandCrwriteHelp, DEBUGGER_COMMAND_CRWRITE_ATTRIBUTES};
 
+    g_CommandsList["!exectrace"] = {&CommandExectrace, &CommandExectraceHelp, DEBUGGER_COMMAND_EXECTRACE_ATTRIBUTES};
+
     g_CommandsList["!dr"] = {&CommandDr, &CommandDrHelp, DEBUGGER_COMMAND_DR_ATTRIBUTES};
 
     g_CommandsList["!ioin"] = {&CommandIoin, &CommandIoinHelp, DEBUGGER_COMMAND_IOIN_ATTRIBUTES};
@@ -723,10 +922,12 @@ InitializeCommandsDictionary()
 
     g_CommandsList["!exception"] = {&CommandException, &CommandExceptionHelp, DEBUGGER_COMMAND_EXCEPTION_ATTRIBUTES};
 
-    g_CommandsList["!interrupt"] = {&CommandInterrupt, &CommandInterruptHelp, DEBUGGER_COMMAND_INTERRUPT_ATTRIBUTES};
+    g_CommandsList["!interrupt"]  = {&CommandInterrupt, &CommandInterruptHelp, DEBUGGER_COMMAND_INTERRUPT_ATTRIBUTES};
+    g_CommandsList["!interrupt2"] = {&CommandInterrupt, &CommandInterruptHelp, DEBUGGER_COMMAND_INTERRUPT_ATTRIBUTES};
 
     g_CommandsList["!syscall"]  = {&CommandSyscallAndSysret, &CommandSyscallHelp, DEBUGGER_COMMAND_SYSCALL_ATTRIBUTES};
     g_CommandsList["!syscall2"] = {&CommandSyscallAndSysret, &CommandSyscallHelp, DEBUGGER_COMMAND_SYSCALL_ATTRIBUTES};
+    g_CommandsList["!syscall3"] = {&CommandSyscallAndSysret, &CommandSyscallHelp, DEBUGGER_COMMAND_SYSCALL_ATTRIBUTES};
 
     g_CommandsList["!sysret"]  = {&CommandSyscallAndSysret, &CommandSysretHelp, DEBUGGER_COMMAND_SYSRET_ATTRIBUTES};
     g_CommandsList["!sysret2"] = {&CommandSyscallAndSysret, &CommandSysretHelp, DEBUGGER_COMMAND_SYSRET_ATTRIBUTES};
@@ -737,6 +938,20 @@ InitializeCommandsDictionary()
 
     g_CommandsList["!measure"] = {&CommandMeasure, &CommandMeasureHelp, DEBUGGER_COMMAND_MEASURE_ATTRIBUTES};
 
+    g_CommandsList["!vmexitstats"] = {&CommandVmexitStats, &CommandVmexitStatsHelp, DEBUGGER_COMMAND_VMEXITSTATS_ATTRIBUTES};
+
+    g_CommandsList["!profiler"] = {&CommandProfiler, &CommandProfilerHelp, DEBUGGER_COMMAND_PROFILER_ATTRIBUTES};
+
+    g_CommandsList["!pebs"] = {&CommandPebs, &CommandPebsHelp, DEBUGGER_COMMAND_PEBS_ATTRIBUTES};
+
+    g_CommandsList["!dirty"] = {&CommandDirty, &CommandDirtyHelp, DEBUGGER_COMMAND_DIRTY_ATTRIBUTES};
+
+    g_CommandsList["!lockstats"] = {&CommandLockStats, &CommandLockStatsHelp, DEBUGGER_COMMAND_LOCKSTATS_ATTRIBUTES};
+
+    g_CommandsList["!snapshot"] = {&CommandEptSnapshot, &CommandEptSnapshotHelp, DEBUGGER_COMMAND_EPT_SNAPSHOT_ATTRIBUTES};
+
+    g_CommandsList["!records"] = {&CommandRecords, &CommandRecordsHelp, DEBUGGER_COMMAND_RECORDS_ATTRIBUTES};
+
     g_CommandsList["lm"] = {&CommandLm, &CommandLmHelp, DEBUGGER_COMMAND_LM_ATTRIBUTES};
 
     g_CommandsList["p"]  = {&CommandP, &CommandPHelp, DEBUGGER_COMMAND_P_ATTRIBUTES};
@@ -792,6 +1007,9 @@ InitializeCommandsDictionary()
     g_CommandsList["!ed"] = {&CommandEditMemory, &CommandEditMemoryHelp, DEBUGGER_COMMAND_E_ATTRIBUTES};
     g_CommandsList["!eq"] = {&CommandEditMemory, &CommandEditMemoryHelp, DEBUGGER_COMMAND_E_ATTRIBUTES};
 
+    g_CommandsList["patch"]  = {&CommandPatch, &CommandPatchHelp, DEBUGGER_COMMAND_PATCH_ATTRIBUTES};
+    g_CommandsList["!patch"] = {&CommandPatch, &CommandPatchHelp, DEBUGGER_COMMAND_PATCH_ATTRIBUTES};
+
     g_CommandsList["sb"]  = {&CommandSearchMemory, &CommandSearchMemoryHelp, DEBUGGER_COMMAND_S_ATTRIBUTES};
     g_CommandsList["sd"]  = {&CommandSearchMemory, &CommandSearchMemoryHelp, DEBUGGER_COMMAND_S_ATTRIBUTES};
     g_CommandsList["sq"]  = {&CommandSearchMemory, &CommandSearchMemoryHelp, DEBUGGER_COMMAND_S_ATTRIBUTES};
@@ -824,6 +1042,8 @@ InitializeCommandsDictionary()
 
     g_CommandsList[".pe"] = {&CommandPe, &CommandPeHelp, DEBUGGER_COMMAND_PE_ATTRIBUTES};
 
+    g_CommandsList[".snapshot"] = {&CommandSnapshot, &CommandSnapshotHelp, DEBUGGER_COMMAND_SNAPSHOT_ATTRIBUTES};
+
     g_CommandsList["!rev"] = {&CommandRev, &CommandRevHelp, DEBUGGER_COMMAND_REV_ATTRIBUTES};
     g_CommandsList["rev"]  = {&CommandRev, &CommandRevHelp, DEBUGGER_COMMAND_REV_ATTRIBUTES};
 
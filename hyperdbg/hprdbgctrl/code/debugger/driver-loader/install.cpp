@@ -11,6 +11,12 @@
  */
 #include "pch.h"
 
+//
+// Global Variables
+//
+extern UINT32 g_LogPacketsCapacityPerCore;
+extern UINT32 g_LogMaximumPacketsCapacityPerCore;
+
 BOOLEAN
 InstallDriver(SC_HANDLE SchSCManager, LPCTSTR DriverName, LPCTSTR ServiceExe);
 
@@ -23,6 +29,51 @@ StartDriver(SC_HANDLE SchSCManager, LPCTSTR DriverName);
 BOOLEAN
 StopDriver(SC_HANDLE SchSCManager, LPCTSTR DriverName);
 
+BOOLEAN
+IsDriverRunning(SC_HANDLE SchSCManager, LPCTSTR DriverName);
+
+/**
+ * @brief Save the capacity of the message buffers into the parameters of the driver
+ * @details the driver reads these values when it's loaded, zero means that the
+ * default capacity is used
+ *
+ * @param DriverName
+ * @return VOID
+ */
+VOID
+InstallDriverSetLogBufferParameters(LPCTSTR DriverName)
+{
+    HKEY  ParametersKey;
+    CHAR  ParametersKeyPath[MAX_PATH] = {0};
+    DWORD Value;
+
+    sprintf_s(ParametersKeyPath, MAX_PATH, "SYSTEM\\CurrentControlSet\\Services\\%s\\Parameters", DriverName);
+
+    if (RegCreateKeyExA(HKEY_LOCAL_MACHINE,
+                        ParametersKeyPath,
+                        0,
+                        NULL,
+                        REG_OPTION_NON_VOLATILE,
+                        KEY_SET_VALUE,
+                        NULL,
+                        &ParametersKey,
+                        NULL) != ERROR_SUCCESS)
+    {
+        //
+        // Not important, the driver uses the default capacities
+        //
+        return;
+    }
+
+    Value = g_LogPacketsCapacityPerCore;
+    RegSetValueExA(ParametersKey, "LogPacketsCapacityPerCore", 0, REG_DWORD, (const BYTE *)&Value, sizeof(DWORD));
+
+    Value = g_LogMaximumPacketsCapacityPerCore;
+    RegSetValueExA(ParametersKey, "LogMaximumPacketsCapacityPerCore", 0, REG_DWORD, (const BYTE *)&Value, sizeof(DWORD));
+
+    RegCloseKey(ParametersKey);
+}
+
 /**
  * @brief Install driver
  *
@@ -72,6 +123,7 @@ InstallDriver(SC_HANDLE SchSCManager, LPCTSTR DriverName, LPCTSTR ServiceExe)
             //
             // Ignore this error
             //
+            InstallDriverSetLogBufferParameters(DriverName);
             return TRUE;
         }
         else if (LastError == ERROR_SERVICE_MARKED_FOR_DELETE)
@@ -103,6 +155,8 @@ InstallDriver(SC_HANDLE SchSCManager, LPCTSTR DriverName, LPCTSTR ServiceExe)
         CloseServiceHandle(SchService);
     }
 
+    InstallDriverSetLogBufferParameters(DriverName);
+
     //
     // Indicate success
     //
@@ -194,6 +248,15 @@ ManageDriver(LPCTSTR DriverName, LPCTSTR ServiceName, UINT16 Function)
 
         break;
 
+    case DRIVER_FUNC_QUERY_RUNNING:
+
+        //
+        // Check whether the driver service is installed and running
+        //
+        Res = IsDriverRunning(schSCManager, DriverName);
+
+        break;
+
     default:
 
         ShowMessages("unknown ManageDriver() function \n");
@@ -427,6 +490,45 @@ StopDriver(SC_HANDLE SchSCManager, LPCTSTR DriverName)
     return Res;
 }
 
+/**
+ * @brief Check whether the driver is installed and running
+ * @details not finding the service is not an error, it means that
+ * the driver is not installed
+ *
+ * @param SC_HANDLE
+ * @param LPCTSTR
+ * @return BOOLEAN
+ */
+BOOLEAN
+IsDriverRunning(SC_HANDLE SchSCManager, LPCTSTR DriverName)
+{
+    BOOLEAN        Res = FALSE;
+    SC_HANDLE      SchService;
+    SERVICE_STATUS serviceStatus;
+
+    //
+    // Open the handle to the existing service
+    //
+    SchService = OpenService(SchSCManager, DriverName, SERVICE_QUERY_STATUS);
+
+    if (SchService == NULL)
+    {
+        return FALSE;
+    }
+
+    if (QueryServiceStatus(SchService, &serviceStatus) && serviceStatus.dwCurrentState == SERVICE_RUNNING)
+    {
+        Res = TRUE;
+    }
+
+    //
+    // Close the service object
+    //
+    CloseServiceHandle(SchService);
+
+    return Res;
+}
+
 /**
  * @brief Setup driver name
  *
@@ -0,0 +1,304 @@
+/**
+ * @file batch-requests.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Gathering requests to the halted debuggee into batches
+ * @details While a script is running, the requests that only query the
+ * state of the debuggee (e.g., 'r', '!pte', '!va2pa', and '!pa2va') are
+ * gathered into a batch, the batch is sent to the debuggee in a single
+ * packet and the debuggee performs all of the requests in the same halt
+ * and sends the results back in a single packet, so each request doesn't
+ * need a separate round-trip over serial
+ *
+ * @version 0.4
+ * @date 2023-07-24
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern KD_BATCH_REQUESTS_STATE g_KdBatchRequests;
+extern BYTE                    g_KdBatchRequestsBuffer[MaxSerialBatchRequestsSize];
+extern BOOLEAN                 g_IsSerialConnectedToRemoteDebuggee;
+extern DEBUGGER_SYNCRONIZATION_EVENTS_STATE
+    g_KernelSyncronizationObjectsHandleTable[DEBUGGER_MAXIMUM_SYNCRONIZATION_KERNEL_DEBUGGER_OBJECTS];
+
+/**
+ * @brief Start gathering the requests into a batch
+ *
+ * @return BOOLEAN Returns TRUE if the batch is started by this call
+ * (the caller should end it), and FALSE if the batch is already started
+ * or the debugger is not connected to a debuggee
+ */
+BOOLEAN
+KdBatchRequestsBegin()
+{
+    if (!g_IsSerialConnectedToRemoteDebuggee || g_KdBatchRequests.IsBatching)
+    {
+        return FALSE;
+    }
+
+    g_KdBatchRequests.CountOfRequests = 0;
+    g_KdBatchRequests.Length          = sizeof(DEBUGGEE_BATCH_REQUESTS_PACKET);
+    g_KdBatchRequests.ResultsLength   = sizeof(DEBUGGEE_BATCH_REQUESTS_PACKET);
+    g_KdBatchRequests.IsBatching      = TRUE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Send the gathered requests to the debuggee and wait
+ * until all of their results are received
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdBatchRequestsFlush()
+{
+    PDEBUGGEE_BATCH_REQUESTS_PACKET BatchPacket = (PDEBUGGEE_BATCH_REQUESTS_PACKET)g_KdBatchRequestsBuffer;
+    UINT32                          Length      = g_KdBatchRequests.Length;
+
+    if (!g_KdBatchRequests.IsBatching || g_KdBatchRequests.CountOfRequests == 0)
+    {
+        //
+        // Nothing to send
+        //
+        return TRUE;
+    }
+
+    BatchPacket->CountOfRequests = g_KdBatchRequests.CountOfRequests;
+    BatchPacket->KernelStatus    = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    //
+    // The batch is emptied before sending it, so sending the batch
+    // itself doesn't flush it again
+    //
+    g_KdBatchRequests.CountOfRequests = 0;
+    g_KdBatchRequests.Length          = sizeof(DEBUGGEE_BATCH_REQUESTS_PACKET);
+    g_KdBatchRequests.ResultsLength   = sizeof(DEBUGGEE_BATCH_REQUESTS_PACKET);
+
+    if (!KdCommandPacketAndBufferToDebuggee(
+            DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
+            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_BATCH_REQUESTS,
+            (CHAR *)g_KdBatchRequestsBuffer,
+            Length))
+    {
+        return FALSE;
+    }
+
+    //
+    // Wait until the results of the batch are received
+    //
+    DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_BATCH_RESULT);
+
+    return TRUE;
+}
+
+/**
+ * @brief Send the gathered requests and stop gathering the requests
+ *
+ * @return VOID
+ */
+VOID
+KdBatchRequestsEnd()
+{
+    KdBatchRequestsFlush();
+
+    g_KdBatchRequests.IsBatching = FALSE;
+}
+
+/**
+ * @brief Check whether the requests of the command can be
+ * gathered into the batch
+ * @details the results of these commands are only shown, so
+ * they can be shown once the results of the batch are received
+ *
+ * @param Command
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdBatchRequestsIsBatchableCommand(const std::string & Command)
+{
+    std::string FirstCommand;
+
+    if (!g_KdBatchRequests.IsBatching)
+    {
+        return FALSE;
+    }
+
+    FirstCommand = Command;
+    Trim(FirstCommand);
+
+    FirstCommand = FirstCommand.substr(0, FirstCommand.find_first_of(" \t\n"));
+
+    transform(FirstCommand.begin(), FirstCommand.end(), FirstCommand.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    //
+    // Setting a register (like 'r rax = 0') is sent as a script, so
+    // it flushes the batch before being sent
+    //
+    return FirstCommand == "r" ||
+           FirstCommand == "!pte" ||
+           FirstCommand == "!va2pa" ||
+           FirstCommand == "!pa2va";
+}
+
+/**
+ * @brief Add a request to the batch
+ * @details the batch is sent first if the request or its result
+ * doesn't fit in the batch
+ *
+ * @param RequestedAction
+ * @param Buffer
+ * @param BufferLength
+ * @param ResultLength Length of the result of the request
+ *
+ * @return BOOLEAN Returns TRUE if the request is added to the batch,
+ * otherwise the request should be sent separately
+ */
+BOOLEAN
+KdBatchRequestsAppend(DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION RequestedAction,
+                      CHAR *                                  Buffer,
+                      UINT32                                  BufferLength,
+                      UINT32                                  ResultLength)
+{
+    PDEBUGGEE_BATCH_REQUEST_ENTRY Entry;
+
+    if (!g_KdBatchRequests.IsBatching ||
+        sizeof(DEBUGGEE_BATCH_REQUESTS_PACKET) + sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY) + BufferLength > MaxSerialBatchRequestsSize ||
+        sizeof(DEBUGGEE_BATCH_REQUESTS_PACKET) + sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY) + ResultLength > MaxSerialBatchRequestsSize)
+    {
+        return FALSE;
+    }
+
+    //
+    // Send the gathered requests if this request doesn't fit in the batch
+    //
+    if (g_KdBatchRequests.Length + sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY) + BufferLength > MaxSerialBatchRequestsSize ||
+        g_KdBatchRequests.ResultsLength + sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY) + ResultLength > MaxSerialBatchRequestsSize)
+    {
+        if (!KdBatchRequestsFlush())
+        {
+            return FALSE;
+        }
+    }
+
+    if (g_KdBatchRequests.CountOfRequests == 0)
+    {
+        g_KdBatchRequests.FirstRequestId = g_KdBatchRequests.NextRequestId;
+    }
+
+    Entry = (PDEBUGGEE_BATCH_REQUEST_ENTRY)(g_KdBatchRequestsBuffer + g_KdBatchRequests.Length);
+
+    Entry->RequestId       = g_KdBatchRequests.NextRequestId++;
+    Entry->RequestedAction = RequestedAction;
+    Entry->Length          = BufferLength;
+    Entry->KernelStatus    = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    memcpy((CHAR *)Entry + sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY), Buffer, BufferLength);
+
+    g_KdBatchRequests.Length += sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY) + BufferLength;
+
+    g_KdBatchRequests.ResultsLength += sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY) + ResultLength;
+
+    g_KdBatchRequests.CountOfRequests++;
+
+    return TRUE;
+}
+
+/**
+ * @brief Show the results of a batch of requests
+ * @details the results are in the same order as the requests, each
+ * result is matched with its request by the id of the request
+ *
+ * @param BatchResults
+ * @param Length Length of the results (including the header)
+ *
+ * @return VOID
+ */
+VOID
+KdBatchRequestsShowResults(PDEBUGGEE_BATCH_REQUESTS_PACKET BatchResults, UINT32 Length)
+{
+    PDEBUGGEE_BATCH_REQUEST_ENTRY Result;
+    CHAR *                        Payload;
+    UINT32                        Offset = sizeof(DEBUGGEE_BATCH_REQUESTS_PACKET);
+
+    if (Length < sizeof(DEBUGGEE_BATCH_REQUESTS_PACKET))
+    {
+        ShowMessages("err, invalid results received for the batch of requests\n");
+        return;
+    }
+
+    for (UINT32 i = 0; i < BatchResults->CountOfRequests; i++)
+    {
+        Result = (PDEBUGGEE_BATCH_REQUEST_ENTRY)((CHAR *)BatchResults + Offset);
+
+        if (Offset + sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY) > Length ||
+            Result->Length > Length - Offset - sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY))
+        {
+            ShowMessages("err, invalid results received for the batch of requests\n");
+            return;
+        }
+
+        Payload = (CHAR *)Result + sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY);
+        Offset += sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY) + Result->Length;
+
+        if (Result->RequestId != g_KdBatchRequests.FirstRequestId + i)
+        {
+            ShowMessages("err, unexpected result received for the request %x of the batch\n",
+                         Result->RequestId);
+            continue;
+        }
+
+        if (Result->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+        {
+            ShowErrorMessage(Result->KernelStatus);
+            continue;
+        }
+
+        switch (Result->RequestedAction)
+        {
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_READING_REGISTERS:
+
+            if (Result->Length >= sizeof(DEBUGGEE_REGISTER_READ_DESCRIPTION))
+            {
+                KdShowResultOfReadingRegisters((PDEBUGGEE_REGISTER_READ_DESCRIPTION)Payload);
+            }
+
+            break;
+
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_PTE:
+
+            if (Result->Length >= sizeof(DEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS))
+            {
+                KdShowResultOfPte((PDEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS)Payload);
+            }
+
+            break;
+
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_VA2PA_AND_PA2VA:
+
+            if (Result->Length >= sizeof(DEBUGGER_VA2PA_AND_PA2VA_COMMANDS))
+            {
+                KdShowResultOfVa2paAndPa2va((PDEBUGGER_VA2PA_AND_PA2VA_COMMANDS)Payload);
+            }
+
+            break;
+
+        default:
+
+            ShowMessages("err, unknown result received for the request %x of the batch\n",
+                         Result->RequestId);
+            break;
+        }
+    }
+
+    if (BatchResults->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(BatchResults->KernelStatus);
+    }
+}
@@ -19,19 +19,22 @@ extern UINT32                g_SymbolTableSize;
 extern UINT32                g_SymbolTableCurrentIndex;
 extern HANDLE                g_SerialListeningThreadHandle;
 extern HANDLE                g_SerialRemoteComPortHandle;
+extern HANDLE                g_SerialRemoteComPortBulkHandle;
+extern HANDLE                g_SerialBulkListeningThreadHandle;
 extern HANDLE                g_DebuggeeStopCommandEventHandle;
 extern DEBUGGER_SYNCRONIZATION_EVENTS_STATE
                                             g_KernelSyncronizationObjectsHandleTable[DEBUGGER_MAXIMUM_SYNCRONIZATION_KERNEL_DEBUGGER_OBJECTS];
 extern BYTE                                 g_CurrentRunningInstruction[MAXIMUM_INSTR_SIZE];
 extern BOOLEAN                              g_IsConnectedToHyperDbgLocally;
-extern OVERLAPPED                           g_OverlappedIoStructureForReadDebugger;
-extern OVERLAPPED                           g_OverlappedIoStructureForWriteDebugger;
+extern TRANSPORT_CHANNEL                    g_KdTransportChannel;
+extern TRANSPORT_CHANNEL                    g_KdBulkTransportChannel;
 extern DEBUGGER_EVENT_AND_ACTION_REG_BUFFER g_DebuggeeResultOfRegisteringEvent;
 extern DEBUGGER_EVENT_AND_ACTION_REG_BUFFER
                g_DebuggeeResultOfAddingActionsToEvent;
 extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
 extern BOOLEAN g_IsSerialConnectedToRemoteDebugger;
 extern BOOLEAN g_IsDebuggerConntectedToNamedPipe;
+extern BOOLEAN g_IsDebuggerConnectedToNetwork;
 extern BOOLEAN g_IsDebuggeeRunning;
 extern BOOLEAN g_IsDebuggerModulesLoaded;
 extern BOOLEAN g_SerialConnectionAlreadyClosed;
@@ -39,53 +42,27 @@ extern BOOLEAN g_IgnoreNewLoggingMessages;
 extern BOOLEAN g_SharedEventStatus;
 extern BOOLEAN g_IsRunningInstruction32Bit;
 extern BOOLEAN g_IgnorePauseRequests;
-extern BYTE    g_EndOfBufferCheckSerial[4];
 extern ULONG   g_CurrentRemoteCore;
 
-/**
- * @brief compares the buffer with a string
- *
- * @param CurrentLoopIndex Number of previously read bytes
- * @param Buffer
- * @return BOOLEAN
- */
-BOOLEAN
-KdCheckForTheEndOfTheBuffer(PUINT32 CurrentLoopIndex, BYTE * Buffer)
-{
-    UINT32 ActualBufferLength;
-
-    ActualBufferLength = *CurrentLoopIndex;
-
-    //
-    // End of buffer is 4 character long
-    //
-    if (*CurrentLoopIndex <= 3)
-    {
-        return FALSE;
-    }
-
-    if (Buffer[ActualBufferLength] == SERIAL_END_OF_BUFFER_CHAR_4 &&
-        Buffer[ActualBufferLength - 1] == SERIAL_END_OF_BUFFER_CHAR_3 &&
-        Buffer[ActualBufferLength - 2] == SERIAL_END_OF_BUFFER_CHAR_2 &&
-        Buffer[ActualBufferLength - 3] == SERIAL_END_OF_BUFFER_CHAR_1)
-    {
-        //
-        // Clear the end character
-        //
-        Buffer[ActualBufferLength - 3] = NULL;
-        Buffer[ActualBufferLength - 2] = NULL;
-        Buffer[ActualBufferLength - 1] = NULL;
-        Buffer[ActualBufferLength]     = NULL;
-
-        //
-        // Set the new length
-        //
-        *CurrentLoopIndex = ActualBufferLength - 3;
-
-        return TRUE;
-    }
-    return FALSE;
-}
+extern KD_READ_MEMORY_STREAM      g_KdReadMemoryStream;
+extern KD_REGISTERS_CONTEXT_CACHE g_KdRegistersContextCache;
+extern KD_RECEIVING_LINK          g_KdControlReceivingLink;
+extern KD_RECEIVING_LINK          g_KdBulkReceivingLink;
+extern UINT32                     g_KdSerialSendSequenceNumber;
+extern BOOLEAN                    g_KdIsSse42Supported;
+extern BOOLEAN                    g_KdIsPeerCrc32cSupported;
+
+extern DEBUGGER_EVENT_SCRIPT_STATISTICS g_SharedEventScriptStatistics;
+extern DEBUGGEE_TRANSPORT_TEST_PACKET   g_KdTransportTestResult;
+extern DEBUGGER_PATCH_MEMORY_REQUEST    g_KdPatchMemoryResult;
+extern DEBUGGER_EPT_SNAPSHOT_REQUEST    g_KdEptSnapshotResult;
+extern DEBUGGER_HALT_WATCHDOG_REQUEST   g_KdHaltWatchdogResult;
+extern DEBUGGER_EVENTS_BATCH_REQUEST    g_KdEventsBatchResult;
+extern DEBUGGER_QUERY_EVENTS_STATISTICS g_KdEventsStatisticsResult;
+
+extern std::vector<KD_ASYNC_PAUSE_REQUEST> g_KdAsyncPauseRequests;
+extern HANDLE                              g_KdAsyncPauseWaitHandle;
+extern SRWLOCK                             g_KdAsyncPauseRequestsLock;
 
 /**
  * @brief compares the buffer with a string
@@ -128,6 +105,298 @@ KdComputeDataChecksum(PVOID Buffer, UINT32 Length)
     return CalculatedCheckSum;
 }
 
+/**
+ * @brief calculate the CRC32 of a buffer
+ * @details the result of a buffer can be passed as the Crc of the
+ * next buffer to compute the CRC32 of not appended buffers
+ *
+ * @param Crc CRC32 of the previous buffers (zero for the first buffer)
+ * @param Buffer
+ * @param Length
+ * @return UINT32
+ */
+UINT32
+KdComputeCrc32(UINT32 Crc, const BYTE * Buffer, UINT32 Length)
+{
+    //
+    // CRC32 (reflected 0xEDB88320 polynomial) of each nibble
+    //
+    static const UINT32 Crc32NibbleTable[16] = {
+        0x00000000,
+        0x1DB71064,
+        0x3B6E20C8,
+        0x26D930AC,
+        0x76DC4190,
+        0x6B6B51F4,
+        0x4DB26158,
+        0x5005713C,
+        0xEDB88320,
+        0xF00F9344,
+        0xD6D6A3E8,
+        0xCB61B38C,
+        0x9B64C2B0,
+        0x86D3D2D4,
+        0xA00AE278,
+        0xBDBDF21C};
+
+    Crc = ~Crc;
+
+    for (UINT32 i = 0; i < Length; i++)
+    {
+        Crc ^= Buffer[i];
+        Crc = (Crc >> 4) ^ Crc32NibbleTable[Crc & 0xf];
+        Crc = (Crc >> 4) ^ Crc32NibbleTable[Crc & 0xf];
+    }
+
+    return ~Crc;
+}
+
+/**
+ * @brief calculate the CRC32C of a buffer
+ * @details the crc32 instruction of SSE4.2 is used if it's supported
+ * by the processor, otherwise it's computed in software
+ *
+ * @param Crc CRC32C of the previous buffers (zero for the first buffer)
+ * @param Buffer
+ * @param Length
+ * @return UINT32
+ */
+UINT32
+KdComputeCrc32c(UINT32 Crc, const BYTE * Buffer, UINT32 Length)
+{
+    //
+    // CRC32C (reflected 0x82F63B78 polynomial) of each nibble
+    //
+    static const UINT32 Crc32cNibbleTable[16] = {
+        0x00000000,
+        0x105EC76F,
+        0x20BD8EDE,
+        0x30E349B1,
+        0x417B1DBC,
+        0x5125DAD3,
+        0x61C69362,
+        0x7198540D,
+        0x82F63B78,
+        0x92A8FC17,
+        0xA24BB5A6,
+        0xB21572C9,
+        0xC38D26C4,
+        0xD3D3E1AB,
+        0xE330A81A,
+        0xF36E6F75};
+
+    UINT64 Crc64 = (UINT32)~Crc;
+    UINT32 i     = 0;
+
+    if (g_KdIsSse42Supported)
+    {
+        for (; i + sizeof(UINT64) <= Length; i += sizeof(UINT64))
+        {
+            Crc64 = _mm_crc32_u64(Crc64, *(UINT64 UNALIGNED *)&Buffer[i]);
+        }
+
+        for (; i < Length; i++)
+        {
+            Crc64 = _mm_crc32_u8((UINT32)Crc64, Buffer[i]);
+        }
+
+        return ~(UINT32)Crc64;
+    }
+
+    Crc = (UINT32)Crc64;
+
+    for (; i < Length; i++)
+    {
+        Crc ^= Buffer[i];
+        Crc = (Crc >> 4) ^ Crc32cNibbleTable[Crc & 0xf];
+        Crc = (Crc >> 4) ^ Crc32cNibbleTable[Crc & 0xf];
+    }
+
+    return ~Crc;
+}
+
+/**
+ * @brief calculate the checksum of a buffer of a frame
+ *
+ * @param Flags flags of the frame (shows whether it's CRC32C or CRC32)
+ * @param Crc checksum of the previous buffers (zero for the first buffer)
+ * @param Buffer
+ * @param Length
+ * @return UINT32
+ */
+UINT32
+KdComputeFrameChecksum(UINT16 Flags, UINT32 Crc, const BYTE * Buffer, UINT32 Length)
+{
+    if (Flags & SERIAL_FRAME_FLAG_CRC32C)
+    {
+        return KdComputeCrc32c(Crc, Buffer, Length);
+    }
+
+    return KdComputeCrc32(Crc, Buffer, Length);
+}
+
+/**
+ * @brief get the flags of the frames that are sent to the remote system
+ * @details CRC32C is used once the remote system shows that it supports
+ * CRC32C, otherwise CRC32 is used for compatibility
+ *
+ * @return UINT16
+ */
+UINT16
+KdGetSendFlags()
+{
+    //
+    // Compressed frames are always accepted, but they are only sent by the debuggee
+    //
+    if (g_KdIsPeerCrc32cSupported)
+    {
+        return SERIAL_FRAME_FLAG_CRC32C_SUPPORTED | SERIAL_FRAME_FLAG_COMPRESSION_SUPPORTED | SERIAL_FRAME_FLAG_CRC32C;
+    }
+
+    return SERIAL_FRAME_FLAG_CRC32C_SUPPORTED | SERIAL_FRAME_FLAG_COMPRESSION_SUPPORTED;
+}
+
+/**
+ * @brief decompress a buffer in the LZ4 block format
+ * @details all of the offsets and lengths are checked, so corrupted
+ * buffers are not written out of the bounds
+ *
+ * @param Source
+ * @param SourceLength
+ * @param Destination
+ * @param DestinationLength length of the decompressed data
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdDecompressBuffer(const BYTE * Source, UINT32 SourceLength, BYTE * Destination, UINT32 DestinationLength)
+{
+    UINT32 Ip = 0;
+    UINT32 Op = 0;
+    UINT32 LiteralLength;
+    UINT32 MatchLength;
+    UINT32 Offset;
+    BYTE   Token;
+    BYTE   Extra;
+
+    while (Ip < SourceLength)
+    {
+        Token         = Source[Ip++];
+        LiteralLength = Token >> 4;
+
+        if (LiteralLength == 15)
+        {
+            do
+            {
+                if (Ip >= SourceLength)
+                {
+                    return FALSE;
+                }
+
+                Extra = Source[Ip++];
+                LiteralLength += Extra;
+
+            } while (Extra == 255);
+        }
+
+        if (LiteralLength > SourceLength - Ip || LiteralLength > DestinationLength - Op)
+        {
+            return FALSE;
+        }
+
+        memcpy(&Destination[Op], &Source[Ip], LiteralLength);
+        Ip += LiteralLength;
+        Op += LiteralLength;
+
+        //
+        // The last sequence only contains literals
+        //
+        if (Ip == SourceLength)
+        {
+            break;
+        }
+
+        if (SourceLength - Ip < sizeof(UINT16))
+        {
+            return FALSE;
+        }
+
+        Offset = Source[Ip] | (Source[Ip + 1] << 8);
+        Ip += sizeof(UINT16);
+
+        if (Offset == 0 || Offset > Op)
+        {
+            return FALSE;
+        }
+
+        MatchLength = Token & 0xf;
+
+        if (MatchLength == 15)
+        {
+            do
+            {
+                if (Ip >= SourceLength)
+                {
+                    return FALSE;
+                }
+
+                Extra = Source[Ip++];
+                MatchLength += Extra;
+
+            } while (Extra == 255);
+        }
+
+        MatchLength += SERIAL_COMPRESSION_MIN_MATCH;
+
+        if (MatchLength > DestinationLength - Op)
+        {
+            return FALSE;
+        }
+
+        //
+        // The match might overlap with the bytes that are being copied
+        //
+        for (UINT32 i = 0; i < MatchLength; i++, Op++)
+        {
+            Destination[Op] = Destination[Op - Offset];
+        }
+    }
+
+    return Op == DestinationLength;
+}
+
+/**
+ * @brief check whether the received header of the frame is valid
+ *
+ * @param Header
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdIsValidFrameHeader(PSERIAL_FRAME_HEADER Header)
+{
+    if (Header->Magic != SERIAL_FRAME_MAGIC || Header->Version != SERIAL_FRAME_VERSION)
+    {
+        return FALSE;
+    }
+
+    if (KdComputeFrameChecksum(Header->Flags,
+                               0,
+                               (const BYTE *)Header,
+                               FIELD_OFFSET(SERIAL_FRAME_HEADER, HeaderChecksum)) != Header->HeaderChecksum)
+    {
+        return FALSE;
+    }
+
+    //
+    // We already now that the maximum packet size is MaxSerialPacketSize
+    //
+    if (Header->Length > MaxSerialPacketSize)
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
 /**
  * @brief Interpret the packets from debuggee in the case of paused
  *
@@ -255,14 +524,17 @@ KdSendShortCircuitingEventToDebuggee(BOOLEAN IsEnabled)
  * @param Tag
  * @param TypeOfAction
  * @param IsEnabled If it's a query state then this argument can be used
+ * @param ScriptStatistics If it's a query state then the cost of the scripts
+ * of the event is copied to it (optional)
  *
  * @return BOOLEAN
  */
 BOOLEAN
 KdSendEventQueryAndModifyPacketToDebuggee(
-    UINT64                      Tag,
-    DEBUGGER_MODIFY_EVENTS_TYPE TypeOfAction,
-    BOOLEAN *                   IsEnabled)
+    UINT64                            Tag,
+    DEBUGGER_MODIFY_EVENTS_TYPE       TypeOfAction,
+    BOOLEAN *                         IsEnabled,
+    PDEBUGGER_EVENT_SCRIPT_STATISTICS ScriptStatistics)
 {
     DEBUGGER_MODIFY_EVENTS ModifyAndQueryEventPacket = {0};
 
@@ -297,8 +569,58 @@ KdSendEventQueryAndModifyPacketToDebuggee(
         // We should read the results to set IsEnabled variable
         //
         *IsEnabled = g_SharedEventStatus;
+
+        if (ScriptStatistics != NULL)
+        {
+            *ScriptStatistics = g_SharedEventScriptStatistics;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Sends a request to add or remove a range of a monitor event
+ * @param Tag
+ * @param TypeOfAction Adding or removing the range
+ * @param RangeStart Start of the range (virtual address)
+ * @param RangeEnd End of the range (virtual address, exclusive)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdSendModifyMonitorRangePacketToDebuggee(UINT64                      Tag,
+                                         DEBUGGER_MODIFY_EVENTS_TYPE TypeOfAction,
+                                         UINT64                      RangeStart,
+                                         UINT64                      RangeEnd)
+{
+    DEBUGGER_MODIFY_EVENTS ModifyEventPacket = {0};
+
+    //
+    // Fill the structure of packet
+    //
+    ModifyEventPacket.Tag          = Tag;
+    ModifyEventPacket.TypeOfAction = TypeOfAction;
+    ModifyEventPacket.RangeStart   = RangeStart;
+    ModifyEventPacket.RangeEnd     = RangeEnd;
+
+    //
+    // Send modify event packet
+    //
+    if (!KdCommandPacketAndBufferToDebuggee(
+            DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
+            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_QUERY_AND_MODIFY_EVENT,
+            (CHAR *)&ModifyEventPacket,
+            sizeof(DEBUGGER_MODIFY_EVENTS)))
+    {
+        return FALSE;
     }
 
+    //
+    // Wait until the result of modifying the event is received
+    //
+    DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_MODIFY_AND_QUERY_EVENT);
+
     return TRUE;
 }
 
@@ -484,6 +806,37 @@ KdSendSymbolReloadPacketToDebuggee(UINT32 ProcessId)
 BOOLEAN
 KdSendReadRegisterPacketToDebuggee(PDEBUGGEE_REGISTER_READ_DESCRIPTION RegDes)
 {
+    UINT32 ResultLength = sizeof(DEBUGGEE_REGISTER_READ_DESCRIPTION);
+
+    if (RegDes->RegisterID == DEBUGGEE_SHOW_ALL_REGISTERS)
+    {
+        ResultLength += sizeof(GUEST_REGS) + sizeof(GUEST_EXTRA_REGISTERS);
+
+        //
+        // The debuggee only sends the changed registers if we have
+        // the last registers of the current core
+        //
+        if (g_KdRegistersContextCache.CoreId == g_CurrentRemoteCore)
+        {
+            RegDes->BaseContextId = g_KdRegistersContextCache.ContextId;
+        }
+        else
+        {
+            RegDes->BaseContextId = 0;
+        }
+    }
+
+    //
+    // The result is shown once the results of the batch are received
+    //
+    if (KdBatchRequestsAppend(DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_READ_REGISTERS,
+                              (CHAR *)RegDes,
+                              sizeof(DEBUGGEE_REGISTER_READ_DESCRIPTION),
+                              ResultLength))
+    {
+        return TRUE;
+    }
+
     //
     // Send r command as read register packet
     //
@@ -505,53 +858,163 @@ KdSendReadRegisterPacketToDebuggee(PDEBUGGEE_REGISTER_READ_DESCRIPTION RegDes)
 }
 
 /**
- * @brief Send a Read memory packet to the debuggee
- * @param ReadMem
+ * @brief Update the last received registers of the current core by
+ * the result of reading all registers
+ * @details the result might contain only the changed registers
  *
- * @return BOOLEAN
+ * @param ReadRegisterResult
+ *
+ * @return PDEBUGGEE_REGISTERS_CONTEXT All of the registers, or NULL if
+ * the changed registers are not based on the last received registers
  */
-BOOLEAN
-KdSendReadMemoryPacketToDebuggee(PDEBUGGER_READ_MEMORY ReadMem)
+PDEBUGGEE_REGISTERS_CONTEXT
+KdUpdateRegistersContextCache(PDEBUGGEE_REGISTER_READ_DESCRIPTION ReadRegisterResult)
 {
-    PDEBUGGER_READ_MEMORY ActualBufferToSend = NULL;
-    UINT                  Size               = 0;
+    UINT64 * Words  = (UINT64 *)&g_KdRegistersContextCache.Registers;
+    UINT64 * Result = (UINT64 *)((CHAR *)ReadRegisterResult + sizeof(DEBUGGEE_REGISTER_READ_DESCRIPTION));
 
-    Size               = ReadMem->Size * sizeof(unsigned char) + sizeof(DEBUGGER_READ_MEMORY);
-    ActualBufferToSend = (PDEBUGGER_READ_MEMORY)malloc(Size);
-
-    if (ActualBufferToSend == NULL)
+    if (!ReadRegisterResult->IsDelta)
     {
-        return FALSE;
+        memcpy(&g_KdRegistersContextCache.Registers, Result, sizeof(DEBUGGEE_REGISTERS_CONTEXT));
+    }
+    else if (g_KdRegistersContextCache.ContextId == ReadRegisterResult->BaseContextId &&
+             g_KdRegistersContextCache.CoreId == g_CurrentRemoteCore)
+    {
+        for (UINT32 i = 0; i < DEBUGGEE_REGISTERS_CONTEXT_WORDS; i++)
+        {
+            if (ReadRegisterResult->ChangedRegisters & (1 << i))
+            {
+                Words[i] = *Result++;
+            }
+        }
+    }
+    else
+    {
+        //
+        // Request all of the registers next time
+        //
+        g_KdRegistersContextCache.ContextId = 0;
+        return NULL;
     }
 
-    RtlZeroMemory(ActualBufferToSend, Size);
+    g_KdRegistersContextCache.CoreId    = g_CurrentRemoteCore;
+    g_KdRegistersContextCache.ContextId = ReadRegisterResult->ContextId;
+
+    return &g_KdRegistersContextCache.Registers;
+}
+
+/**
+ * @brief Send a Read memory packet to the debuggee
+ * @details the debuggee sends the memory back as consecutive chunks
+ * for this single request, the chunks are written into the buffer
+ *
+ * @param ReadMem
+ * @param Buffer The memory is saved here (ReadMem->Size bytes)
+ * @param ReturnLength Count of bytes that are read
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdSendReadMemoryPacketToDebuggee(PDEBUGGER_READ_MEMORY ReadMem, unsigned char * Buffer, UINT32 * ReturnLength)
+{
+    *ReturnLength = 0;
 
-    memcpy(ActualBufferToSend, ReadMem, sizeof(DEBUGGER_READ_MEMORY));
+    g_KdReadMemoryStream.Buffer             = Buffer;
+    g_KdReadMemoryStream.Size               = ReadMem->Size;
+    g_KdReadMemoryStream.ReceivedLength     = 0;
+    g_KdReadMemoryStream.NextSequenceNumber = 0;
+    g_KdReadMemoryStream.KernelStatus       = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
 
     //
-    // Send u-d command as read memory packet
+    // Send u-d command as read memory packet, the debuggee reads the
+    // memory into its own buffer, so only the request is sent
     //
     if (!KdCommandPacketAndBufferToDebuggee(
             DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
             DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_READ_MEMORY,
-            (CHAR *)ActualBufferToSend,
-            Size))
+            (CHAR *)ReadMem,
+            sizeof(DEBUGGER_READ_MEMORY)))
     {
-        free(ActualBufferToSend);
+        g_KdReadMemoryStream.Buffer = NULL;
+        ReadMem->KernelStatus       = DEBUGGER_ERROR_INVALID_ADDRESS;
         return FALSE;
     }
 
     //
-    // Wait until the result of read registers received
+    // Wait until the last chunk of memory is received
     //
     DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_READ_MEMORY);
 
-    free(ActualBufferToSend);
+    g_KdReadMemoryStream.Buffer = NULL;
+
+    *ReturnLength = g_KdReadMemoryStream.ReceivedLength;
+
+    if (g_KdReadMemoryStream.ReceivedLength == 0)
+    {
+        ReadMem->KernelStatus = g_KdReadMemoryStream.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL ? g_KdReadMemoryStream.KernelStatus : DEBUGGER_ERROR_INVALID_ADDRESS;
+        return FALSE;
+    }
+
+    ReadMem->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
     return TRUE;
 }
 
 /**
- * @brief Send an Edit memory packet to the debuggee
+ * @brief Save a chunk of memory that is received from the debuggee
+ * @details the chunks are written straight into the buffer of the
+ * request based on their sequence numbers
+ *
+ * @param ReadMemoryPacket The received packet
+ * @param MemoryBuffer The memory of the chunk
+ *
+ * @return BOOLEAN Returns TRUE if it's the last chunk of the request
+ */
+BOOLEAN
+KdReceivedReadMemoryChunk(PDEBUGGER_READ_MEMORY ReadMemoryPacket, unsigned char * MemoryBuffer)
+{
+    UINT32 Offset = ReadMemoryPacket->SequenceNumber * MaxSerialReadMemoryChunkSize;
+
+    if (g_KdReadMemoryStream.Buffer == NULL)
+    {
+        //
+        // Not requested by this debugger (or the request is already completed)
+        //
+        return FALSE;
+    }
+
+    if (ReadMemoryPacket->SequenceNumber != g_KdReadMemoryStream.NextSequenceNumber)
+    {
+        //
+        // A chunk is lost, the memory after the lost chunk is not shown
+        //
+        ShowMessages("err, chunk %d of the memory is not received from the debuggee\n",
+                     g_KdReadMemoryStream.NextSequenceNumber);
+
+        g_KdReadMemoryStream.NextSequenceNumber = MAXUINT32;
+        return ReadMemoryPacket->IsLastChunk;
+    }
+
+    g_KdReadMemoryStream.NextSequenceNumber++;
+
+    if (ReadMemoryPacket->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        g_KdReadMemoryStream.KernelStatus = ReadMemoryPacket->KernelStatus;
+        return ReadMemoryPacket->IsLastChunk;
+    }
+
+    if (Offset < g_KdReadMemoryStream.Size &&
+        ReadMemoryPacket->ReturnLength <= g_KdReadMemoryStream.Size - Offset)
+    {
+        memcpy(g_KdReadMemoryStream.Buffer + Offset, MemoryBuffer, ReadMemoryPacket->ReturnLength);
+        g_KdReadMemoryStream.ReceivedLength = Offset + ReadMemoryPacket->ReturnLength;
+    }
+
+    return ReadMemoryPacket->IsLastChunk;
+}
+
+/**
+ * @brief Send an Edit memory packet to the debuggee
  * @param EditMem
  * @param Size
  *
@@ -580,6 +1043,168 @@ KdSendEditMemoryPacketToDebuggee(PDEBUGGER_EDIT_MEMORY EditMem, UINT32 Size)
     return TRUE;
 }
 
+/**
+ * @brief Send a patch memory packet to the debuggee
+ * @details the stream of patches (PatchesBufferSize bytes) should be
+ * located after the request, the request is filled with the result once
+ * it's received
+ *
+ * @param PatchMemRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdSendPatchMemoryPacketToDebuggee(PDEBUGGER_PATCH_MEMORY_REQUEST PatchMemRequest)
+{
+    //
+    // Send the request and all of its patches in one packet
+    //
+    if (!KdCommandPacketAndBufferToDebuggee(
+            DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
+            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_PATCH_MEMORY,
+            (CHAR *)PatchMemRequest,
+            SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST + PatchMemRequest->PatchesBufferSize))
+    {
+        return FALSE;
+    }
+
+    //
+    // Wait until the result of patching memory is received
+    //
+    DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_PATCH_MEMORY_RESULT);
+
+    memcpy(PatchMemRequest, &g_KdPatchMemoryResult, SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST);
+
+    return TRUE;
+}
+
+/**
+ * @brief Send a request of the snapshot of the memory to the debuggee
+ * @details the request is filled with the result once it's received
+ *
+ * @param SnapshotRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdSendEptSnapshotPacketToDebuggee(PDEBUGGER_EPT_SNAPSHOT_REQUEST SnapshotRequest)
+{
+    if (!KdCommandPacketAndBufferToDebuggee(
+            DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
+            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_EPT_SNAPSHOT,
+            (CHAR *)SnapshotRequest,
+            SIZEOF_DEBUGGER_EPT_SNAPSHOT_REQUEST))
+    {
+        return FALSE;
+    }
+
+    //
+    // Wait until the result of the snapshot is received
+    //
+    DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_EPT_SNAPSHOT_RESULT);
+
+    memcpy(SnapshotRequest, &g_KdEptSnapshotResult, SIZEOF_DEBUGGER_EPT_SNAPSHOT_REQUEST);
+
+    return TRUE;
+}
+
+/**
+ * @brief Send a request to set or query the watchdog of the halts to the
+ * debuggee
+ * @details the request is filled with the result once it's received
+ *
+ * @param HaltWatchdogRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdSendHaltWatchdogPacketToDebuggee(PDEBUGGER_HALT_WATCHDOG_REQUEST HaltWatchdogRequest)
+{
+    if (!KdCommandPacketAndBufferToDebuggee(
+            DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
+            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_HALT_WATCHDOG,
+            (CHAR *)HaltWatchdogRequest,
+            SIZEOF_DEBUGGER_HALT_WATCHDOG_REQUEST))
+    {
+        return FALSE;
+    }
+
+    //
+    // Wait until the result of the watchdog is received
+    //
+    DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_HALT_WATCHDOG_RESULT);
+
+    memcpy(HaltWatchdogRequest, &g_KdHaltWatchdogResult, SIZEOF_DEBUGGER_HALT_WATCHDOG_REQUEST);
+
+    return TRUE;
+}
+
+/**
+ * @brief Send a batch of events and actions to the debuggee
+ * @details the stream of entries is located after the request, the
+ * request is filled with the result once it's received
+ *
+ * @param EventsBatchRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdSendRegisterEventsBatchPacketToDebuggee(PDEBUGGER_EVENTS_BATCH_REQUEST EventsBatchRequest)
+{
+    //
+    // Send the request and all of its entries in one packet
+    //
+    if (!KdCommandPacketAndBufferToDebuggee(
+            DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
+            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_REGISTER_EVENTS_BATCH,
+            (CHAR *)EventsBatchRequest,
+            SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST + EventsBatchRequest->EntriesBufferSize))
+    {
+        return FALSE;
+    }
+
+    //
+    // Wait until the result of registering the batch is received
+    //
+    DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_REGISTER_EVENTS_BATCH_RESULT);
+
+    memcpy(EventsBatchRequest, &g_KdEventsBatchResult, SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST);
+
+    return TRUE;
+}
+
+/**
+ * @brief Send a request of querying the hit statistics of the events
+ * to the debuggee
+ * @details only the header of the request is sent, and only the filled
+ * entries are received
+ *
+ * @param StatisticsRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdSendQueryEventsStatisticsPacketToDebuggee(PDEBUGGER_QUERY_EVENTS_STATISTICS StatisticsRequest)
+{
+    if (!KdCommandPacketAndBufferToDebuggee(
+            DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
+            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_QUERY_EVENTS_STATISTICS,
+            (CHAR *)StatisticsRequest,
+            SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS_HEADER))
+    {
+        return FALSE;
+    }
+
+    //
+    // Wait until the result of the query is received
+    //
+    DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_QUERY_EVENTS_STATISTICS_RESULT);
+
+    memcpy(StatisticsRequest, &g_KdEventsStatisticsResult, SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS);
+
+    return TRUE;
+}
+
 /**
  * @brief Send a register event request to the debuggee
  * @details as this command uses one global variable to transfer the buffers
@@ -829,6 +1454,17 @@ KdSendSwitchThreadPacketToDebuggee(DEBUGGEE_DETAILS_AND_SWITCH_THREAD_TYPE Actio
 BOOLEAN
 KdSendPtePacketToDebuggee(PDEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS PtePacket)
 {
+    //
+    // The result is shown once the results of the batch are received
+    //
+    if (KdBatchRequestsAppend(DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_SYMBOL_QUERY_PTE,
+                              (CHAR *)PtePacket,
+                              sizeof(DEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS),
+                              sizeof(DEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS)))
+    {
+        return TRUE;
+    }
+
     //
     // Send 'bp' as a breakpoint packet
     //
@@ -858,6 +1494,17 @@ KdSendPtePacketToDebuggee(PDEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS PtePacket)
 BOOLEAN
 KdSendVa2paAndPa2vaPacketToDebuggee(PDEBUGGER_VA2PA_AND_PA2VA_COMMANDS Va2paAndPa2vaPacket)
 {
+    //
+    // The result is shown once the results of the batch are received
+    //
+    if (KdBatchRequestsAppend(DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_QUERY_PA2VA_AND_VA2PA,
+                              (CHAR *)Va2paAndPa2vaPacket,
+                              sizeof(DEBUGGER_VA2PA_AND_PA2VA_COMMANDS),
+                              sizeof(DEBUGGER_VA2PA_AND_PA2VA_COMMANDS)))
+    {
+        return TRUE;
+    }
+
     //
     // Send '!va2pa' or '!pa2va' as a query packet
     //
@@ -888,13 +1535,14 @@ BOOLEAN
 KdSendBpPacketToDebuggee(PDEBUGGEE_BP_PACKET BpPacket)
 {
     //
-    // Send 'bp' as a breakpoint packet
+    // Send 'bp' as a breakpoint packet (the condition buffer, if any, is
+    // located at the bottom of the packet)
     //
     if (!KdCommandPacketAndBufferToDebuggee(
             DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
             DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_BP,
             (CHAR *)BpPacket,
-            sizeof(DEBUGGEE_BP_PACKET)))
+            sizeof(DEBUGGEE_BP_PACKET) + BpPacket->ConditionBufferSize))
     {
         return FALSE;
     }
@@ -1150,6 +1798,177 @@ KdSendStepPacketToDebuggee(DEBUGGER_REMOTE_STEPPING_REQUEST StepRequestType)
     return TRUE;
 }
 
+/**
+ * @brief Sends a request to perform multiple steps (t or i) in the
+ * debuggee and record the trace of them
+ * @details the debuggee performs all of the steps without waiting for
+ * the debugger and sends the trace back in chunks, so each step doesn't
+ * need a separate round-trip
+ *
+ * @param StepRequestType
+ * @param CountOfSteps
+ * @param RecordedRegister REGS_ENUM or DEBUGGEE_STEP_TRACE_NO_REGISTER
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdSendStepAndTracePacketToDebuggee(DEBUGGER_REMOTE_STEPPING_REQUEST StepRequestType,
+                                   UINT32                           CountOfSteps,
+                                   UINT32                           RecordedRegister)
+{
+    DEBUGGEE_STEP_TRACE_PACKET StepTracePacket = {0};
+
+    StepTracePacket.StepType         = StepRequestType;
+    StepTracePacket.CountOfSteps     = CountOfSteps;
+    StepTracePacket.RecordedRegister = RecordedRegister;
+
+    //
+    // Send step and trace packet to the serial
+    //
+    if (!KdCommandPacketAndBufferToDebuggee(
+            DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
+            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_STEP_AND_TRACE,
+            (CHAR *)&StepTracePacket,
+            sizeof(DEBUGGEE_STEP_TRACE_PACKET)))
+    {
+        return FALSE;
+    }
+
+    //
+    // Wait until the debuggee is paused after the last step
+    // (the chunks of the trace are shown once they are received)
+    //
+    DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_IS_DEBUGGER_RUNNING);
+
+    return TRUE;
+}
+
+/**
+ * @brief Sends a request to run a count of instructions in the debuggee
+ * @details the debuggee is paused once the instructions are executed on
+ * the current core (or once anything else pauses it)
+ *
+ * @param CountOfInstructions
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdSendInstructionBudgetPacketToDebuggee(UINT64 CountOfInstructions)
+{
+    DEBUGGEE_INSTRUCTION_BUDGET_PACKET BudgetPacket = {0};
+
+    BudgetPacket.CountOfInstructions = CountOfInstructions;
+
+    //
+    // The debuggee is running (it can be paused by CTRL+C), it's set before
+    // sending the packet as the result might be received before the wait
+    //
+    g_IsDebuggeeRunning = TRUE;
+
+    //
+    // Send run instructions packet to the serial
+    //
+    if (!KdCommandPacketAndBufferToDebuggee(
+            DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
+            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_RUN_INSTRUCTIONS,
+            (CHAR *)&BudgetPacket,
+            sizeof(DEBUGGEE_INSTRUCTION_BUDGET_PACKET)))
+    {
+        g_IsDebuggeeRunning = FALSE;
+        return FALSE;
+    }
+
+    //
+    // Wait until the debuggee is paused again
+    //
+    KdTheRemoteSystemIsRunning();
+
+    return TRUE;
+}
+
+/**
+ * @brief Sends a packet of the transport test to the debuggee and waits
+ * for its result
+ * @details the payload (PayloadLength bytes) should be located after the
+ * header, the header is filled with the result once it's received
+ *
+ * @param TransportTestPacket
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdSendTransportTestPacketToDebuggee(PDEBUGGEE_TRANSPORT_TEST_PACKET TransportTestPacket)
+{
+    //
+    // Send the transport test packet to the serial
+    //
+    if (!KdCommandPacketAndBufferToDebuggee(
+            DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
+            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_TRANSPORT_TEST,
+            (CHAR *)TransportTestPacket,
+            sizeof(DEBUGGEE_TRANSPORT_TEST_PACKET) + TransportTestPacket->PayloadLength))
+    {
+        return FALSE;
+    }
+
+    //
+    // Wait until the result of the transport test is received
+    //
+    DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_TRANSPORT_TEST_RESULT);
+
+    memcpy(TransportTestPacket, &g_KdTransportTestResult, sizeof(DEBUGGEE_TRANSPORT_TEST_PACKET));
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the result of a packet of the transport test
+ * @details the result is saved to be used by the sender of the packet
+ *
+ * @param TransportTestPacket
+ * @param PacketLength Length of the result (including its header)
+ *
+ * @return VOID
+ */
+VOID
+KdCheckResultOfTransportTest(PDEBUGGEE_TRANSPORT_TEST_PACKET TransportTestPacket, UINT32 PacketLength)
+{
+    UINT8 * Payload = (UINT8 *)TransportTestPacket + sizeof(DEBUGGEE_TRANSPORT_TEST_PACKET);
+
+    if (PacketLength < sizeof(DEBUGGEE_TRANSPORT_TEST_PACKET))
+    {
+        RtlZeroMemory(&g_KdTransportTestResult, sizeof(DEBUGGEE_TRANSPORT_TEST_PACKET));
+        g_KdTransportTestResult.KernelStatus = DEBUGGER_ERROR_TRANSPORT_TEST_PAYLOAD_MISMATCH;
+
+        return;
+    }
+
+    memcpy(&g_KdTransportTestResult, TransportTestPacket, sizeof(DEBUGGEE_TRANSPORT_TEST_PACKET));
+
+    if (g_KdTransportTestResult.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        return;
+    }
+
+    //
+    // Check the payload of the debuggee
+    //
+    if (TransportTestPacket->ResponseLength != PacketLength - sizeof(DEBUGGEE_TRANSPORT_TEST_PACKET))
+    {
+        g_KdTransportTestResult.KernelStatus = DEBUGGER_ERROR_TRANSPORT_TEST_PAYLOAD_MISMATCH;
+        return;
+    }
+
+    for (UINT32 i = 0; i < TransportTestPacket->ResponseLength; i++)
+    {
+        if (Payload[i] != DEBUGGEE_TRANSPORT_TEST_PATTERN(TransportTestPacket->SequenceNumber, i))
+        {
+            g_KdTransportTestResult.KernelStatus = DEBUGGER_ERROR_TRANSPORT_TEST_PAYLOAD_MISMATCH;
+            break;
+        }
+    }
+}
+
 /**
  * @brief Sends a PAUSE packet to the debuggee
  *
@@ -1244,137 +2063,225 @@ KdGetWindowVersion(CHAR * BufferToSave)
 }
 
 /**
- * @brief Receive packet from the debugger
+ * @brief Read a block of the received data into the receive buffer
+ * @details the read returns as soon as any data is received by the
+ * I/O thread (in debugger)
  *
- * @param BufferToSave
- * @param LengthReceived
+ * @param Link The control link or the bulk link
  *
  * @return BOOLEAN
  */
 BOOLEAN
-KdReceivePacketFromDebuggee(CHAR *   BufferToSave,
-                            UINT32 * LengthReceived)
+KdReceiveBlockFromDebuggee(PKD_RECEIVING_LINK Link)
 {
-    BOOL   Status;             /* Status */
-    char   ReadData    = NULL; /* temperory Character */
-    DWORD  NoBytesRead = 0;    /* Bytes read by ReadFile() */
-    UINT32 Loop        = 0;
+    UINT32 NoBytesRead = 0;
 
-    //
-    // Read data and store in a buffer
-    //
-    do
+    if (!TransportReceive(Link->Channel,
+                          Link->ReceiveBuffer,
+                          KdSerialReceiveBufferSize,
+                          &NoBytesRead))
+    {
+        return FALSE;
+    }
+
+    Link->ReceiveBufferStart = 0;
+    Link->ReceiveBufferEnd   = NoBytesRead;
+
+    return TRUE;
+}
+
+/**
+ * @brief Receive the exact count of bytes from the remote system
+ * @details the debugger reads blocks of data and the rest of the data
+ * remains in the receive buffer for the next packet, while the debuggee
+ * reads exactly the requested count as the rest of the data belongs to
+ * the debuggee itself
+ *
+ * @param Link The link of the debugger (not used in debuggee)
+ * @param Buffer
+ * @param Length
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdReceiveBytesFromDebuggee(PKD_RECEIVING_LINK Link, BYTE * Buffer, UINT32 Length)
+{
+    UINT32 Loop        = 0;
+    UINT32 CopySize    = 0;
+    DWORD  NoBytesRead = 0; /* Bytes read by ReadFile() */
+
+    while (Loop < Length)
     {
         if (g_IsSerialConnectedToRemoteDebugger)
         {
             //
             // It's a debuggee
             //
-            Status = ReadFile(g_SerialRemoteComPortHandle, &ReadData, sizeof(ReadData), &NoBytesRead, NULL);
+            if (!ReadFile(g_SerialRemoteComPortHandle, Buffer + Loop, Length - Loop, &NoBytesRead, NULL) ||
+                NoBytesRead == 0)
+            {
+                return FALSE;
+            }
+
+            Loop += NoBytesRead;
+            continue;
         }
-        else
+
+        //
+        // It's a debugger
+        //
+        if (Link->ReceiveBufferStart == Link->ReceiveBufferEnd &&
+            !KdReceiveBlockFromDebuggee(Link))
         {
-            //
-            // It's a debugger
-            //
+            return FALSE;
+        }
 
-            //
-            // Try to read one byte in overlapped I/O (in debugger)
-            //
-            if (!ReadFile(g_SerialRemoteComPortHandle, &ReadData, sizeof(ReadData), NULL, &g_OverlappedIoStructureForReadDebugger))
-            {
-                DWORD e = GetLastError();
+        CopySize = Link->ReceiveBufferEnd - Link->ReceiveBufferStart;
 
-                if (e != ERROR_IO_PENDING)
-                {
-                    return FALSE;
-                }
-            }
+        if (CopySize > Length - Loop)
+        {
+            CopySize = Length - Loop;
+        }
 
-            //
-            // Wait till one packet becomes available
-            //
-            WaitForSingleObject(g_OverlappedIoStructureForReadDebugger.hEvent,
-                                INFINITE);
+        memcpy(Buffer + Loop, &Link->ReceiveBuffer[Link->ReceiveBufferStart], CopySize);
 
-            //
-            // Get the result
-            //
-            GetOverlappedResult(g_SerialRemoteComPortHandle,
-                                &g_OverlappedIoStructureForReadDebugger,
-                                &NoBytesRead,
-                                FALSE);
+        Link->ReceiveBufferStart += CopySize;
+        Loop += CopySize;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Receive packet from the debuggee (or from the debugger)
+ *
+ * @param Link The link of the debugger (not used in debuggee)
+ * @param BufferToSave
+ * @param LengthReceived
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdReceivePacketFromDebuggee(PKD_RECEIVING_LINK Link,
+                            CHAR *             BufferToSave,
+                            UINT32 *           LengthReceived)
+{
+    SERIAL_FRAME_HEADER Header        = {0};
+    UINT32              ReceivedBytes = 0;
+    UINT32              Length        = 0;
+    BYTE *              Payload       = NULL;
+
+    *LengthReceived = 0;
+
+    while (TRUE)
+    {
+        //
+        // Receive the header of the frame
+        //
+        if (!KdReceiveBytesFromDebuggee(Link,
+                                        (BYTE *)&Header + ReceivedBytes,
+                                        sizeof(SERIAL_FRAME_HEADER) - ReceivedBytes))
+        {
+            return FALSE;
+        }
 
+        if (!KdIsValidFrameHeader(&Header))
+        {
             //
-            // Reset event for next try
+            // Not a valid header, skip one byte and search for the
+            // next magic in the bytes that are already received
             //
-            ResetEvent(g_OverlappedIoStructureForReadDebugger.hEvent);
+            memmove(&Header, (BYTE *)&Header + 1, sizeof(SERIAL_FRAME_HEADER) - 1);
+            ReceivedBytes = sizeof(SERIAL_FRAME_HEADER) - 1;
+            continue;
         }
 
         //
-        // We already now that the maximum packet size is MaxSerialPacketSize
-        // Check to make sure that we don't pass the boundaries
+        // Receive exactly the length of the payload (compressed payloads
+        // are decompressed into the buffer)
         //
-        if (!(MaxSerialPacketSize > Loop))
+        Payload = (Header.Flags & SERIAL_FRAME_FLAG_COMPRESSED) ? Link->CompressedBuffer : (BYTE *)BufferToSave;
+        Length  = Header.Length;
+
+        if (!KdReceiveBytesFromDebuggee(Link, Payload, Header.Length))
         {
-            //
-            // Invalid buffer
-            //
-            ShowMessages("err, a buffer received in which exceeds the "
-                         "buffer limitation\n");
             return FALSE;
         }
 
-        BufferToSave[Loop] = ReadData;
+        ReceivedBytes = 0;
+
+        if (KdComputeFrameChecksum(Header.Flags, 0, Payload, Header.Length) != Header.PayloadChecksum)
+        {
+            //
+            // The payload is corrupted, wait for the next frame
+            //
+            ShowMessages("err, corrupted buffer received (sequence number: %x)\n",
+                         Header.SequenceNumber);
+            continue;
+        }
 
-        if (KdCheckForTheEndOfTheBuffer(&Loop, (BYTE *)BufferToSave))
+        if (!(Header.Flags & SERIAL_FRAME_FLAG_COMPRESSED))
         {
             break;
         }
 
-        Loop++;
+        //
+        // The payload starts with the length of the uncompressed data
+        //
+        if (Header.Length >= sizeof(UINT32))
+        {
+            Length = *(UINT32 *)Payload;
 
-    } while (NoBytesRead > 0);
+            if (Length <= MaxSerialPacketSize &&
+                KdDecompressBuffer(&Payload[sizeof(UINT32)],
+                                   Header.Length - sizeof(UINT32),
+                                   (BYTE *)BufferToSave,
+                                   Length))
+            {
+                break;
+            }
+        }
+
+        ShowMessages("err, invalid compressed buffer received (sequence number: %x)\n",
+                     Header.SequenceNumber);
+    }
+
+    //
+    // The remote system accepts CRC32C frames
+    //
+    if (Header.Flags & SERIAL_FRAME_FLAG_CRC32C_SUPPORTED)
+    {
+        g_KdIsPeerCrc32cSupported = TRUE;
+    }
 
     //
     // Set the length
     //
-    *LengthReceived = Loop;
+    *LengthReceived = Length;
 
     return TRUE;
 }
 
 /**
  * @brief Sends a special packet to the debuggee
+ * @details the buffer is written as is, frames are sent by
+ * KdSendFrameToDebuggee
  *
  * @param Buffer
  * @param Length
  * @return BOOLEAN
  */
 BOOLEAN
-KdSendPacketToDebuggee(const CHAR * Buffer, UINT32 Length, BOOLEAN SendEndOfBuffer)
+KdSendPacketToDebuggee(const CHAR * Buffer, UINT32 Length)
 {
     BOOL  Status;
-    DWORD BytesWritten  = 0;
-    DWORD LastErrorCode = 0;
+    DWORD BytesWritten = 0;
 
     //
     // Start getting debuggee messages again
     //
     g_IgnoreNewLoggingMessages = FALSE;
 
-    //
-    // Double check if buffer not pass the boundary
-    //
-    if (Length + SERIAL_END_OF_BUFFER_CHARS_COUNT > MaxSerialPacketSize)
-    {
-        ShowMessages("err, buffer is above the maximum buffer size that can be sent to debuggee (%d > %d), "
-                     "for more information, please visit https://docs.hyperdbg.org/tips-and-tricks/misc/increase-communication-buffer-size",
-                     Length + SERIAL_END_OF_BUFFER_CHARS_COUNT,
-                     MaxSerialPacketSize);
-        return FALSE;
-    }
-
     //
     // Check if the remote code's handle found or not
     //
@@ -1413,60 +2320,93 @@ KdSendPacketToDebuggee(const CHAR * Buffer, UINT32 Length, BOOLEAN SendEndOfBuff
     else
     {
         //
-        // It's a debugger
+        // It's a debugger, the buffer is queued and sent by the I/O thread
         //
-
-        if (WriteFile(g_SerialRemoteComPortHandle, Buffer, Length, NULL, &g_OverlappedIoStructureForWriteDebugger))
-        {
-            //
-            // Write Completed
-            //
-            goto Out;
-        }
-
-        LastErrorCode = GetLastError();
-        if (LastErrorCode != ERROR_IO_PENDING)
+        if (!TransportSend(&g_KdTransportChannel, Buffer, Length, NULL, 0, NULL, 0))
         {
-            //
-            // Error
-            //
-            // ShowMessages("err, on sending serial packets (%x)", LastErrorCode);
             return FALSE;
         }
+    }
 
-        //
-        // Wait until write completed
-        //
-        if (WaitForSingleObject(g_OverlappedIoStructureForWriteDebugger.hEvent,
-                                INFINITE) != WAIT_OBJECT_0)
-        {
-            // ShowMessages("err, on sending serial packets (signal error)");
-            return FALSE;
-        }
+    //
+    // All the bytes are sent
+    //
+    return TRUE;
+}
 
-        //
-        // Reset event
-        //
-        ResetEvent(g_OverlappedIoStructureForWriteDebugger.hEvent);
+/**
+ * @brief Sends a frame (header + 2 not appended buffers) to the debuggee
+ *
+ * @param Buffer1
+ * @param Length1
+ * @param Buffer2
+ * @param Length2
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdSendFrameToDebuggee(const CHAR * Buffer1, UINT32 Length1, const CHAR * Buffer2, UINT32 Length2)
+{
+    SERIAL_FRAME_HEADER Header = {0};
+
+    //
+    // Double check if buffer not pass the boundary
+    //
+    if (Length1 + Length2 > MaxSerialPacketSize)
+    {
+        ShowMessages("err, buffer is above the maximum buffer size that can be sent to debuggee (%d > %d), "
+                     "for more information, please visit https://docs.hyperdbg.org/tips-and-tricks/misc/increase-communication-buffer-size",
+                     Length1 + Length2,
+                     MaxSerialPacketSize);
+        return FALSE;
     }
 
-Out:
-    if (SendEndOfBuffer)
+    //
+    // Make the header of the frame
+    //
+    Header.Magic           = SERIAL_FRAME_MAGIC;
+    Header.Version         = SERIAL_FRAME_VERSION;
+    Header.Flags           = KdGetSendFlags();
+    Header.Length          = Length1 + Length2;
+    Header.SequenceNumber  = g_KdSerialSendSequenceNumber++;
+    Header.PayloadChecksum = KdComputeFrameChecksum(Header.Flags, 0, (const BYTE *)Buffer1, Length1);
+    Header.PayloadChecksum = KdComputeFrameChecksum(Header.Flags, Header.PayloadChecksum, (const BYTE *)Buffer2, Length2);
+    Header.HeaderChecksum  = KdComputeFrameChecksum(Header.Flags,
+                                                    0,
+                                                    (const BYTE *)&Header,
+                                                    FIELD_OFFSET(SERIAL_FRAME_HEADER, HeaderChecksum));
+
+    if (!g_IsSerialConnectedToRemoteDebugger)
     {
         //
-        // Send End of Buffer Packet
+        // It's a debugger, the whole frame is queued at once so the frames
+        // that are sent by different threads are not mixed
         //
-        if (!KdSendPacketToDebuggee((const CHAR *)g_EndOfBufferCheckSerial,
-                                    sizeof(g_EndOfBufferCheckSerial),
-                                    FALSE))
-        {
-            return FALSE;
-        }
+        g_IgnoreNewLoggingMessages = FALSE;
+
+        return TransportSend(&g_KdTransportChannel,
+                             (const CHAR *)&Header,
+                             sizeof(SERIAL_FRAME_HEADER),
+                             Buffer1,
+                             Length1,
+                             Buffer2,
+                             Length2);
+    }
+
+    if (!KdSendPacketToDebuggee((const CHAR *)&Header, sizeof(SERIAL_FRAME_HEADER)))
+    {
+        return FALSE;
+    }
+
+    if (Length1 != 0 && !KdSendPacketToDebuggee(Buffer1, Length1))
+    {
+        return FALSE;
+    }
+
+    if (Length2 != 0 && !KdSendPacketToDebuggee(Buffer2, Length2))
+    {
+        return FALSE;
     }
 
-    //
-    // All the bytes are sent
-    //
     return TRUE;
 }
 
@@ -1483,6 +2423,29 @@ KdCommandPacketToDebuggee(
 {
     DEBUGGER_REMOTE_PACKET Packet = {0};
 
+    //
+    // The gathered requests are sent before this request to keep
+    // the order of the requests
+    //
+    KdBatchRequestsFlush();
+
+    //
+    // The snapshot of the memory is no longer valid if the
+    // memory of the debuggee might be changed
+    //
+    if (!KdMemoryCacheIsReadOnlyAction(RequestedAction))
+    {
+        KdMemoryCacheInvalidate();
+    }
+
+    //
+    // Same for the processes and threads that are queried
+    //
+    if (!KdObjectCacheIsReadOnlyAction(RequestedAction))
+    {
+        KdObjectCacheInvalidate();
+    }
+
     //
     // There is no check for boundary here as it's fixed to
     // sizeof(DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION) + sizeof(DEBUGGER_REMOTE_PACKET)
@@ -1506,9 +2469,10 @@ KdCommandPacketToDebuggee(
         KdComputeDataChecksum((PVOID)((UINT64)&Packet + 1),
                               sizeof(DEBUGGER_REMOTE_PACKET) - sizeof(BYTE));
 
-    if (!KdSendPacketToDebuggee((const CHAR *)&Packet,
-                                sizeof(DEBUGGER_REMOTE_PACKET),
-                                TRUE))
+    if (!KdSendFrameToDebuggee((const CHAR *)&Packet,
+                               sizeof(DEBUGGER_REMOTE_PACKET),
+                               NULL,
+                               0))
     {
         return FALSE;
     }
@@ -1532,15 +2496,37 @@ KdCommandPacketAndBufferToDebuggee(
 {
     DEBUGGER_REMOTE_PACKET Packet = {0};
 
+    //
+    // The gathered requests are sent before this request to keep
+    // the order of the requests
+    //
+    KdBatchRequestsFlush();
+
+    //
+    // The snapshot of the memory is no longer valid if the
+    // memory of the debuggee might be changed
+    //
+    if (!KdMemoryCacheIsReadOnlyAction(RequestedAction))
+    {
+        KdMemoryCacheInvalidate();
+    }
+
+    //
+    // Same for the processes and threads that are queried
+    //
+    if (!KdObjectCacheIsReadOnlyAction(RequestedAction))
+    {
+        KdObjectCacheInvalidate();
+    }
+
     //
     // Check if buffer not pass the boundary
     //
-    if (sizeof(DEBUGGER_REMOTE_PACKET) + BufferLength + SERIAL_END_OF_BUFFER_CHARS_COUNT >
-        MaxSerialPacketSize)
+    if (sizeof(DEBUGGER_REMOTE_PACKET) + BufferLength > MaxSerialPacketSize)
     {
         ShowMessages("err, buffer is above the maximum buffer size that can be sent to debuggee (%d > %d), "
                      "for more information, please visit https://docs.hyperdbg.org/tips-and-tricks/misc/increase-communication-buffer-size",
-                     sizeof(DEBUGGER_REMOTE_PACKET) + BufferLength + SERIAL_END_OF_BUFFER_CHARS_COUNT,
+                     sizeof(DEBUGGER_REMOTE_PACKET) + BufferLength,
                      MaxSerialPacketSize);
 
         return FALSE;
@@ -1567,19 +2553,12 @@ KdCommandPacketAndBufferToDebuggee(
     Packet.Checksum += KdComputeDataChecksum((PVOID)Buffer, BufferLength);
 
     //
-    // Send the first buffer (without ending buffer indication)
-    //
-    if (!KdSendPacketToDebuggee((const CHAR *)&Packet,
-                                sizeof(DEBUGGER_REMOTE_PACKET),
-                                FALSE))
-    {
-        return FALSE;
-    }
-
-    //
-    // Send the second buffer (with ending buffer indication)
+    // Send the packet and the buffer in one frame
     //
-    if (!KdSendPacketToDebuggee((const CHAR *)Buffer, BufferLength, TRUE))
+    if (!KdSendFrameToDebuggee((const CHAR *)&Packet,
+                               sizeof(DEBUGGER_REMOTE_PACKET),
+                               Buffer,
+                               BufferLength))
     {
         return FALSE;
     }
@@ -1665,6 +2644,238 @@ KdBreakControlCheckAndContinueDebugger()
     }
 }
 
+/**
+ * @brief The callback of the registered wait once the debuggee is paused
+ * @details all of the requests that wait for the pause are completed
+ *
+ * @param Parameter
+ * @param TimerOrWaitFired
+ *
+ * @return VOID
+ */
+VOID CALLBACK
+KdAsyncPauseWaitCallback(PVOID Parameter, BOOLEAN TimerOrWaitFired)
+{
+    std::vector<KD_ASYNC_PAUSE_REQUEST> Requests;
+
+    UNREFERENCED_PARAMETER(Parameter);
+    UNREFERENCED_PARAMETER(TimerOrWaitFired);
+
+    AcquireSRWLockExclusive(&g_KdAsyncPauseRequestsLock);
+
+    Requests.swap(g_KdAsyncPauseRequests);
+
+    //
+    // The wait is only executed once, it's not waited for the callback
+    // (this callback) to be finished
+    //
+    UnregisterWait(g_KdAsyncPauseWaitHandle);
+    g_KdAsyncPauseWaitHandle = NULL;
+
+    ReleaseSRWLockExclusive(&g_KdAsyncPauseRequestsLock);
+
+    for (auto & Request : Requests)
+    {
+        if (Request.Callback != NULL)
+        {
+            Request.Callback(Request.Context);
+        }
+
+        SetEvent(Request.CompletionEvent);
+        CloseHandle(Request.CompletionEvent);
+    }
+}
+
+/**
+ * @brief Add a request that waits for the debuggee to be paused
+ * @details the thread pool waits for the synchronization object of the
+ * running debuggee instead of a blocked thread, it should be called after
+ * sending the request to the debuggee (the event remains signaled if the
+ * debuggee is paused before the wait)
+ *
+ * @param Callback Called once the debuggee is paused (optional)
+ * @param Context Parameter of the callback
+ *
+ * @return HANDLE The event that is signaled once the debuggee is paused
+ * (should be closed by the caller) or NULL if it's not successful
+ */
+HANDLE
+KdAddAsyncPauseRequest(DebuggeePausedCallback Callback, PVOID Context)
+{
+    KD_ASYNC_PAUSE_REQUEST                 Request         = {0};
+    HANDLE                                 CompletionEvent = NULL;
+    DEBUGGER_SYNCRONIZATION_EVENTS_STATE * SyncronizationObject;
+
+    SyncronizationObject = &g_KernelSyncronizationObjectsHandleTable[DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_IS_DEBUGGER_RUNNING];
+
+    Request.CompletionEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+    if (Request.CompletionEvent == NULL)
+    {
+        ShowMessages("err, unable to create the completion event (%x)\n", GetLastError());
+        return NULL;
+    }
+
+    //
+    // The caller has its own handle, so it can close the handle before the
+    // request is completed
+    //
+    if (!DuplicateHandle(GetCurrentProcess(),
+                         Request.CompletionEvent,
+                         GetCurrentProcess(),
+                         &CompletionEvent,
+                         0,
+                         FALSE,
+                         DUPLICATE_SAME_ACCESS))
+    {
+        ShowMessages("err, unable to duplicate the completion event (%x)\n", GetLastError());
+        CloseHandle(Request.CompletionEvent);
+        return NULL;
+    }
+
+    Request.Callback = Callback;
+    Request.Context  = Context;
+
+    AcquireSRWLockExclusive(&g_KdAsyncPauseRequestsLock);
+
+    if (g_KdAsyncPauseWaitHandle == NULL)
+    {
+        SyncronizationObject->IsOnWaitingState = TRUE;
+
+        if (!RegisterWaitForSingleObject(&g_KdAsyncPauseWaitHandle,
+                                         SyncronizationObject->EventHandle,
+                                         KdAsyncPauseWaitCallback,
+                                         NULL,
+                                         INFINITE,
+                                         WT_EXECUTEONLYONCE))
+        {
+            g_KdAsyncPauseWaitHandle               = NULL;
+            SyncronizationObject->IsOnWaitingState = FALSE;
+
+            ReleaseSRWLockExclusive(&g_KdAsyncPauseRequestsLock);
+
+            ShowMessages("err, unable to wait for the debuggee (%x)\n", GetLastError());
+            CloseHandle(Request.CompletionEvent);
+            CloseHandle(CompletionEvent);
+            return NULL;
+        }
+    }
+
+    g_KdAsyncPauseRequests.push_back(Request);
+
+    ReleaseSRWLockExclusive(&g_KdAsyncPauseRequestsLock);
+
+    return CompletionEvent;
+}
+
+/**
+ * @brief Check whether any request waits (asynchronously) for the
+ * debuggee to be paused
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdAreAsyncPauseRequestsPending()
+{
+    BOOLEAN Result;
+
+    AcquireSRWLockShared(&g_KdAsyncPauseRequestsLock);
+
+    Result = g_KdAsyncPauseWaitHandle != NULL;
+
+    ReleaseSRWLockShared(&g_KdAsyncPauseRequestsLock);
+
+    return Result;
+}
+
+/**
+ * @brief Continue the debuggee without waiting for it to be paused again
+ * (non-blocking version of 'g' in the debugger mode)
+ * @details the debuggee should not be continued or waited by the blocking
+ * functions (e.g., the interpreter) while the request is pending
+ *
+ * @param Callback Called once the debuggee is paused again (optional)
+ * @param Context Parameter of the callback
+ *
+ * @return HANDLE The event that is signaled once the debuggee is paused
+ * again (should be closed by the caller) or NULL if it's not continued
+ */
+HANDLE
+HyperDbgContinueDebuggeeAsync(DebuggeePausedCallback Callback, PVOID Context)
+{
+    if (!g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, the debugger is not connected to a debuggee\n");
+        return NULL;
+    }
+
+    if (g_IsDebuggeeRunning)
+    {
+        ShowMessages("err, the debuggee is already running\n");
+        return NULL;
+    }
+
+    //
+    // Set the debuggee to show that it's running
+    //
+    g_IsDebuggeeRunning = TRUE;
+
+    if (!KdSendContinuePacketToDebuggee())
+    {
+        g_IsDebuggeeRunning = FALSE;
+
+        ShowMessages("err, unable to continue the debuggee\n");
+        return NULL;
+    }
+
+    return KdAddAsyncPauseRequest(Callback, Context);
+}
+
+/**
+ * @brief Pause the debuggee without waiting for it to be paused (non-blocking
+ * version of CTRL+C in the debugger mode)
+ *
+ * @param Callback Called once the debuggee is paused (optional)
+ * @param Context Parameter of the callback
+ *
+ * @return HANDLE The event that is signaled once the debuggee is paused
+ * (should be closed by the caller) or NULL if the pause is not requested
+ */
+HANDLE
+HyperDbgPauseDebuggeeAsync(DebuggeePausedCallback Callback, PVOID Context)
+{
+    if (!g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, the debugger is not connected to a debuggee\n");
+        return NULL;
+    }
+
+    if (!g_IsDebuggeeRunning)
+    {
+        ShowMessages("err, the debuggee is already paused\n");
+        return NULL;
+    }
+
+    if (!KdSendPausePacketToDebuggee())
+    {
+        ShowMessages("err, unable to pause the debuggee\n");
+        return NULL;
+    }
+
+    return KdAddAsyncPauseRequest(Callback, Context);
+}
+
+/**
+ * @brief Check whether the debuggee is running or not (without waiting)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+HyperDbgIsDebuggeeRunning()
+{
+    return g_IsSerialConnectedToRemoteDebuggee && g_IsDebuggeeRunning;
+}
+
 /**
  * @brief wait for a event to be triggered and if the debuggee
  * is running it just halts the system
@@ -1690,11 +2901,16 @@ KdTheRemoteSystemIsRunning()
  * @details wait to connect to debuggee (this is debugger)
  *
  * @param SerialHandle
+ * @param BulkHandle The handle of the bulk link (optional)
+ * @param IsNamedPipe
+ * @param IsNetwork Whether the handle is a UDP socket
  * @return BOOLEAN
  */
 BOOLEAN
 KdPrepareSerialConnectionToRemoteSystem(HANDLE  SerialHandle,
-                                        BOOLEAN IsNamedPipe)
+                                        HANDLE  BulkHandle,
+                                        BOOLEAN IsNamedPipe,
+                                        BOOLEAN IsNetwork)
 {
 StartAgain:
 
@@ -1706,7 +2922,7 @@ StartAgain:
     //
     ShowMessages("waiting for debuggee to connect...\n");
 
-    if (!IsNamedPipe)
+    if (!IsNamedPipe && !IsNetwork)
     {
         //
         // Setting Receive Mask
@@ -1751,6 +2967,36 @@ StartAgain:
     //
     g_SerialConnectionAlreadyClosed = FALSE;
 
+    //
+    // Serve the connection by the I/O thread, so sending the commands
+    // and the pause requests doesn't wait for receiving the messages,
+    // the debuggee doesn't reassemble the fragmented IP packets so each
+    // datagram should fit in a single ethernet frame
+    //
+    if (!TransportOpenChannel(&g_KdTransportChannel,
+                              SerialHandle,
+                              FALSE,
+                              IsNetwork ? NETWORK_CONNECTION_MAXIMUM_DATAGRAM_SIZE : 0))
+    {
+        return FALSE;
+    }
+
+    //
+    // The bulk link is served by the same I/O thread and has its own
+    // listening thread, so the bulk data never waits for the control
+    // link (and vice versa)
+    //
+    if (BulkHandle != NULL)
+    {
+        if (!TransportOpenChannel(&g_KdBulkTransportChannel, BulkHandle, FALSE, 0))
+        {
+            return FALSE;
+        }
+
+        g_SerialBulkListeningThreadHandle =
+            CreateThread(NULL, 0, ListeningSerialBulkLinkDebuggerThread, NULL, 0, NULL);
+    }
+
     //
     // Create the listening thread in debugger
     //
@@ -1803,6 +3049,11 @@ StartAgain:
         //
         g_IsDebuggerConntectedToNamedPipe = IsNamedPipe;
 
+        //
+        // Is serial handle for a UDP socket
+        //
+        g_IsDebuggerConnectedToNetwork = IsNetwork;
+
         //
         // Now, the user can press ctrl+c to pause the debuggee
         //
@@ -1822,27 +3073,179 @@ StartAgain:
     return TRUE;
 }
 
+/**
+ * @brief Open and configure a COM port
+ * @details the debugger opens the port for overlapped I/O and its reads
+ * return as soon as any data is received, the debuggee opens the port
+ * for non-overlapped I/O
+ *
+ * @param PortName Name of the port
+ * @param Baudrate
+ * @param IsPreparing Whether it's the debuggee or not
+ * @return HANDLE The handle of the port or NULL if it can't be opened
+ */
+static HANDLE
+KdOpenSerialPort(const char * PortName, DWORD Baudrate, BOOLEAN IsPreparing)
+{
+    HANDLE       Comm         = NULL; /* Handle to the Serial port */
+    BOOL         Status;              /* Status */
+    DCB          SerialParams = {0};  /* Initializing DCB structure */
+    COMMTIMEOUTS Timeouts     = {0};  /* Initializing timeouts structure */
+    char         PortNo[20]   = {0};  /* contain friendly name */
+
+    //
+    // Append name to make a Windows understandable format
+    //
+    sprintf_s(PortNo, 20, "\\\\.\\%s", PortName);
+
+    //
+    // Open the serial com port (if it's the debugger (not debuggee)) then
+    // open with Overlapped I/O
+    //
+
+    if (IsPreparing)
+    {
+        //
+        // It's debuggee (Non-overlapped I/O)
+        //
+        Comm = CreateFile(PortNo,                       // Friendly name
+                          GENERIC_READ | GENERIC_WRITE, // Read/Write Access
+                          0,                            // No Sharing, ports cant be shared
+                          NULL,                         // No Security
+                          OPEN_EXISTING,                // Open existing port only
+                          0,                            // Non Overlapped I/O
+                          NULL);                        // Null for Comm Devices
+    }
+    else
+    {
+        //
+        // It's debugger (Overlapped I/O)
+        //
+        Comm = CreateFile(PortNo,                       // Friendly name
+                          GENERIC_READ | GENERIC_WRITE, // Read/Write Access
+                          0,                            // No Sharing, ports cant be shared
+                          NULL,                         // No Security
+                          OPEN_EXISTING,                // Open existing port only
+                          FILE_FLAG_OVERLAPPED,         // Overlapped I/O
+                          NULL);                        // Null for Comm Devices
+    }
+
+    if (Comm == INVALID_HANDLE_VALUE)
+    {
+        ShowMessages("err, port can't be opened\n");
+        return NULL;
+    }
+
+    //
+    // Purge the serial port
+    //
+    PurgeComm(Comm,
+              PURGE_RXCLEAR | PURGE_TXCLEAR | PURGE_RXABORT | PURGE_TXABORT);
+
+    //
+    // Setting the Parameters for the SerialPort
+    //
+    SerialParams.DCBlength = sizeof(SerialParams);
+
+    //
+    // retreives the current settings
+    //
+    Status = GetCommState(Comm, &SerialParams);
+
+    if (Status == FALSE)
+    {
+        CloseHandle(Comm);
+        ShowMessages("err, to Get the COM state\n");
+        return NULL;
+    }
+
+    SerialParams.BaudRate =
+        Baudrate;                       // BaudRate = 9600 (Based on user selection)
+    SerialParams.ByteSize = 8;          // ByteSize = 8
+    SerialParams.StopBits = ONESTOPBIT; // StopBits = 1
+    SerialParams.Parity   = NOPARITY;   // Parity = None
+    Status                = SetCommState(Comm, &SerialParams);
+
+    if (Status == FALSE)
+    {
+        CloseHandle(Comm);
+        ShowMessages("err, to Setting DCB Structure\n");
+        return NULL;
+    }
+
+    //
+    // Setting Timeouts (not use it anymore as we use special signature for
+    // ending buffer)
+    // (no need anymore as we use end buffer detection mechanism)
+    //
+
+    /*
+Timeouts.ReadIntervalTimeout = 50;
+Timeouts.ReadTotalTimeoutConstant = 50;
+Timeouts.ReadTotalTimeoutMultiplier = 10;
+Timeouts.WriteTotalTimeoutConstant = 50;
+Timeouts.WriteTotalTimeoutMultiplier = 10;
+
+if (SetCommTimeouts(Comm, &Timeouts) == FALSE) {
+  ShowMessages("err, to Setting Time outs (%x).\n", GetLastError());
+  return NULL;
+}
+*/
+
+    if (!IsPreparing)
+    {
+        //
+        // The debugger reads the data in blocks, so the reads should
+        // return as soon as any data is received
+        //
+        Timeouts.ReadIntervalTimeout        = MAXDWORD;
+        Timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+        Timeouts.ReadTotalTimeoutConstant   = MAXDWORD - 1;
+
+        if (SetCommTimeouts(Comm, &Timeouts) == FALSE)
+        {
+            CloseHandle(Comm);
+            ShowMessages("err, to Setting Time outs (%x)\n", GetLastError());
+            return NULL;
+        }
+    }
+
+    return Comm;
+}
+
 /**
  * @brief Prepare and initialize COM port
+ * @details if the network details are specified, the debugger and the
+ * debuggee are connected over the network, the debugger uses a UDP
+ * socket and the debuggee uses a dedicated network adapter directly
+ * from the kernel (so there is no port in the debuggee's user-mode)
  *
- * @param PortName
+ * @param PortName Name of the port, the pipe, or the address of the debuggee
  * @param Baudrate
  * @param Port
  * @param IsPreparing
  * @param IsNamedPipe
+ * @param NetworkDetails (optional)
+ * @param BulkLinkDetails (optional) the second port (or pipe) of the
+ * bulk data
  * @return BOOLEAN
  */
 BOOLEAN
-KdPrepareAndConnectDebugPort(const char * PortName, DWORD Baudrate, UINT32 Port, BOOLEAN IsPreparing, BOOLEAN IsNamedPipe)
+KdPrepareAndConnectDebugPort(const char *                   PortName,
+                             DWORD                          Baudrate,
+                             UINT32                         Port,
+                             BOOLEAN                        IsPreparing,
+                             BOOLEAN                        IsNamedPipe,
+                             PKD_NETWORK_CONNECTION_DETAILS NetworkDetails,
+                             PKD_BULK_LINK_DETAILS          BulkLinkDetails)
 {
-    HANDLE                     Comm;               /* Handle to the Serial port */
-    BOOL                       Status;             /* Status */
-    DCB                        SerialParams = {0}; /* Initializing DCB structure */
-    COMMTIMEOUTS               Timeouts     = {0}; /* Initializing timeouts structure */
-    char                       PortNo[20]   = {0}; /* contain friendly name */
+    HANDLE                     Comm     = NULL; /* Handle to the Serial port */
+    HANDLE                     BulkComm = NULL; /* Handle to the port of the bulk link */
+    SOCKET                     UdpSocket;
     BOOLEAN                    StatusIoctl;
     ULONG                      ReturnedLength;
     PDEBUGGER_PREPARE_DEBUGGEE DebuggeeRequest;
+    INT32                      CpuInfo[4] = {0};
 
     //
     // Check if the debugger or debuggee is already active
@@ -1858,122 +3261,63 @@ KdPrepareAndConnectDebugPort(const char * PortName, DWORD Baudrate, UINT32 Port,
         return FALSE;
     }
 
-    if (!IsNamedPipe)
+    if (BulkLinkDetails != NULL && NetworkDetails != NULL)
     {
-        //
-        // It's a serial
-        //
-
-        //
-        // Append name to make a Windows understandable format
-        //
-        sprintf_s(PortNo, 20, "\\\\.\\%s", PortName);
-
-        //
-        // Open the serial com port (if it's the debugger (not debuggee)) then
-        // open with Overlapped I/O
-        //
-
-        if (IsPreparing)
-        {
-            //
-            // It's debuggee (Non-overlapped I/O)
-            //
-            Comm = CreateFile(PortNo,                       // Friendly name
-                              GENERIC_READ | GENERIC_WRITE, // Read/Write Access
-                              0,                            // No Sharing, ports cant be shared
-                              NULL,                         // No Security
-                              OPEN_EXISTING,                // Open existing port only
-                              0,                            // Non Overlapped I/O
-                              NULL);                        // Null for Comm Devices
-        }
-        else
-        {
-            //
-            // It's debugger (Overlapped I/O)
-            //
-            Comm = CreateFile(PortNo,                       // Friendly name
-                              GENERIC_READ | GENERIC_WRITE, // Read/Write Access
-                              0,                            // No Sharing, ports cant be shared
-                              NULL,                         // No Security
-                              OPEN_EXISTING,                // Open existing port only
-                              FILE_FLAG_OVERLAPPED,         // Overlapped I/O
-                              NULL);                        // Null for Comm Devices
+        ShowMessages("err, the bulk link is only supported in the serial and named pipe connections\n");
+        return FALSE;
+    }
 
-            //
-            // Create event for overlapped I/O (Read)
-            //
-            g_OverlappedIoStructureForReadDebugger.hEvent =
-                CreateEvent(NULL, TRUE, FALSE, NULL);
+    //
+    // Remove the data of the previous connection
+    //
+    g_KdControlReceivingLink.ReceiveBufferStart = 0;
+    g_KdControlReceivingLink.ReceiveBufferEnd   = 0;
+    g_KdBulkReceivingLink.ReceiveBufferStart    = 0;
+    g_KdBulkReceivingLink.ReceiveBufferEnd      = 0;
 
-            //
-            // Create event for overlapped I/O (Write)
-            //
-            g_OverlappedIoStructureForWriteDebugger.hEvent =
-                CreateEvent(NULL, TRUE, FALSE, NULL);
-        }
+    //
+    // The registers of the previous connection are not valid
+    //
+    g_KdRegistersContextCache.ContextId = 0;
 
-        if (Comm == INVALID_HANDLE_VALUE)
-        {
-            ShowMessages("err, port can't be opened\n");
-            return FALSE;
-        }
+    //
+    // Check whether the crc32 instruction (SSE4.2) is supported, CRC32C is
+    // used once the remote system shows that it supports CRC32C frames
+    //
+    __cpuid(CpuInfo, 1);
 
-        //
-        // Purge the serial port
-        //
-        PurgeComm(Comm,
-                  PURGE_RXCLEAR | PURGE_TXCLEAR | PURGE_RXABORT | PURGE_TXABORT);
+    g_KdIsSse42Supported      = (CpuInfo[2] & (1 << 20)) ? TRUE : FALSE;
+    g_KdIsPeerCrc32cSupported = FALSE;
 
+    if (NetworkDetails != NULL)
+    {
         //
-        // Setting the Parameters for the SerialPort
+        // It's a network connection, the debuggee has no port in
+        // user-mode as the kernel uses the network adapter directly
         //
-        SerialParams.DCBlength = sizeof(SerialParams);
+        if (!IsPreparing)
+        {
+            if (CommunicationClientCreateUdpSocket(PortName,
+                                                   std::to_string(NetworkDetails->UdpPort).c_str(),
+                                                   &UdpSocket) != 0)
+            {
+                return FALSE;
+            }
 
+            Comm = (HANDLE)UdpSocket;
+        }
+    }
+    else if (!IsNamedPipe)
+    {
         //
-        // retreives the current settings
+        // It's a serial
         //
-        Status = GetCommState(Comm, &SerialParams);
-
-        if (Status == FALSE)
-        {
-            CloseHandle(Comm);
-            ShowMessages("err, to Get the COM state\n");
-            return FALSE;
-        }
-
-        SerialParams.BaudRate =
-            Baudrate;                       // BaudRate = 9600 (Based on user selection)
-        SerialParams.ByteSize = 8;          // ByteSize = 8
-        SerialParams.StopBits = ONESTOPBIT; // StopBits = 1
-        SerialParams.Parity   = NOPARITY;   // Parity = None
-        Status                = SetCommState(Comm, &SerialParams);
+        Comm = KdOpenSerialPort(PortName, Baudrate, IsPreparing);
 
-        if (Status == FALSE)
+        if (Comm == NULL)
         {
-            CloseHandle(Comm);
-            ShowMessages("err, to Setting DCB Structure\n");
             return FALSE;
         }
-
-        //
-        // Setting Timeouts (not use it anymore as we use special signature for
-        // ending buffer)
-        // (no need anymore as we use end buffer detection mechanism)
-        //
-
-        /*
-    Timeouts.ReadIntervalTimeout = 50;
-    Timeouts.ReadTotalTimeoutConstant = 50;
-    Timeouts.ReadTotalTimeoutMultiplier = 10;
-    Timeouts.WriteTotalTimeoutConstant = 50;
-    Timeouts.WriteTotalTimeoutMultiplier = 10;
-
-    if (SetCommTimeouts(Comm, &Timeouts) == FALSE) {
-      ShowMessages("err, to Setting Time outs (%x).\n", GetLastError());
-      return FALSE;
-    }
-    */
     }
     else
     {
@@ -1992,6 +3336,31 @@ KdPrepareAndConnectDebugPort(const char * PortName, DWORD Baudrate, UINT32 Port,
         }
     }
 
+    if (BulkLinkDetails != NULL)
+    {
+        //
+        // Open the bulk link, the debuggee only sends the bulk data (chunks
+        // of memory and messages of events) over it, so large transfers
+        // don't delay the responses of the control link
+        //
+        if (IsNamedPipe)
+        {
+            BulkComm = NamedPipeClientCreatePipeOverlappedIo(BulkLinkDetails->PortName);
+        }
+        else
+        {
+            BulkComm = KdOpenSerialPort(BulkLinkDetails->PortName, Baudrate, IsPreparing);
+        }
+
+        if (BulkComm == NULL)
+        {
+            CloseHandle(Comm);
+
+            ShowMessages("err, unable to open the bulk link\n");
+            return FALSE;
+        }
+    }
+
     if (IsPreparing)
     {
         //
@@ -2009,7 +3378,16 @@ KdPrepareAndConnectDebugPort(const char * PortName, DWORD Baudrate, UINT32 Port,
         //
         if (!CommandLoadVmmModule())
         {
-            CloseHandle(Comm);
+            if (Comm != NULL)
+            {
+                CloseHandle(Comm);
+            }
+
+            if (BulkComm != NULL)
+            {
+                CloseHandle(BulkComm);
+            }
+
             ShowMessages("failed to install or load the driver\n");
             return FALSE;
         }
@@ -2020,7 +3398,16 @@ KdPrepareAndConnectDebugPort(const char * PortName, DWORD Baudrate, UINT32 Port,
         //
         if (!g_DeviceHandle)
         {
-            CloseHandle(Comm);
+            if (Comm != NULL)
+            {
+                CloseHandle(Comm);
+            }
+
+            if (BulkComm != NULL)
+            {
+                CloseHandle(BulkComm);
+            }
+
             AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
         }
 
@@ -2032,7 +3419,16 @@ KdPrepareAndConnectDebugPort(const char * PortName, DWORD Baudrate, UINT32 Port,
 
         if (DebuggeeRequest == NULL)
         {
-            CloseHandle(Comm);
+            if (Comm != NULL)
+            {
+                CloseHandle(Comm);
+            }
+
+            if (BulkComm != NULL)
+            {
+                CloseHandle(BulkComm);
+            }
+
             ShowMessages("err, unable to allocate memory for request packet");
             return FALSE;
         }
@@ -2045,6 +3441,20 @@ KdPrepareAndConnectDebugPort(const char * PortName, DWORD Baudrate, UINT32 Port,
         DebuggeeRequest->PortAddress = Port;
         DebuggeeRequest->Baudrate    = Baudrate;
 
+        if (BulkLinkDetails != NULL)
+        {
+            DebuggeeRequest->BulkPortAddress = BulkLinkDetails->Port;
+        }
+
+        if (NetworkDetails != NULL)
+        {
+            DebuggeeRequest->IsNetwork                = TRUE;
+            DebuggeeRequest->NetworkAdapterPciAddress = NetworkDetails->NetworkAdapterPciAddress;
+            DebuggeeRequest->DebuggeeIpAddress        = NetworkDetails->DebuggeeIpAddress;
+            DebuggeeRequest->DebuggerIpAddress        = NetworkDetails->DebuggerIpAddress;
+            DebuggeeRequest->UdpPort                  = htons(NetworkDetails->UdpPort);
+        }
+
         //
         // Get base address of ntoskrnl
         //
@@ -2079,7 +3489,16 @@ KdPrepareAndConnectDebugPort(const char * PortName, DWORD Baudrate, UINT32 Port,
 
         if (!StatusIoctl)
         {
-            CloseHandle(Comm);
+            if (Comm != NULL)
+            {
+                CloseHandle(Comm);
+            }
+
+            if (BulkComm != NULL)
+            {
+                CloseHandle(BulkComm);
+            }
+
             ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
 
             //
@@ -2109,7 +3528,16 @@ KdPrepareAndConnectDebugPort(const char * PortName, DWORD Baudrate, UINT32 Port,
         }
         else
         {
-            CloseHandle(Comm);
+            if (Comm != NULL)
+            {
+                CloseHandle(Comm);
+            }
+
+            if (BulkComm != NULL)
+            {
+                CloseHandle(BulkComm);
+            }
+
             ShowErrorMessage(DebuggeeRequest->Result);
 
             //
@@ -2139,9 +3567,10 @@ KdPrepareAndConnectDebugPort(const char * PortName, DWORD Baudrate, UINT32 Port,
         g_IsSerialConnectedToRemoteDebugger = TRUE;
 
         //
-        // Set handle to serial device
+        // Set handle to serial device (and the port of the bulk link)
         //
-        g_SerialRemoteComPortHandle = Comm;
+        g_SerialRemoteComPortHandle     = Comm;
+        g_SerialRemoteComPortBulkHandle = BulkComm;
 
         //
         // Free the buffer
@@ -2155,16 +3584,19 @@ KdPrepareAndConnectDebugPort(const char * PortName, DWORD Baudrate, UINT32 Port,
         g_DebuggeeStopCommandEventHandle = CreateEvent(NULL, FALSE, FALSE, NULL);
 
         //
-        // Create a thread to listen for pauses from the remote debugger
+        // Create a thread to listen for pauses from the remote debugger,
+        // over the network, the kernel polls the adapter for the pauses
         //
-
-        g_SerialListeningThreadHandle = CreateThread(
-            NULL,
-            0,
-            ListeningSerialPauseDebuggeeThread,
-            NULL,
-            0,
-            NULL);
+        if (NetworkDetails == NULL)
+        {
+            g_SerialListeningThreadHandle = CreateThread(
+                NULL,
+                0,
+                ListeningSerialPauseDebuggeeThread,
+                NULL,
+                0,
+                NULL);
+        }
 
         //
         // Test should be removed
@@ -2201,13 +3633,14 @@ KdPrepareAndConnectDebugPort(const char * PortName, DWORD Baudrate, UINT32 Port,
         //
         // Save the handler
         //
-        g_SerialRemoteComPortHandle = Comm;
+        g_SerialRemoteComPortHandle     = Comm;
+        g_SerialRemoteComPortBulkHandle = BulkComm;
 
         //
         // If we are here, then it's a debugger (not debuggee)
         // let's prepare the debuggee
         //
-        KdPrepareSerialConnectionToRemoteSystem(Comm, IsNamedPipe);
+        KdPrepareSerialConnectionToRemoteSystem(Comm, BulkComm, IsNamedPipe, NetworkDetails != NULL);
     }
 
     //
@@ -2545,6 +3978,50 @@ KdAddActionToEventInDebuggee(PDEBUGGER_GENERAL_ACTION ActionAddingBuffer,
         TRUE);
 }
 
+/**
+ * @brief Register a batch of events and actions in the debuggee
+ * @param EventsBatchRequest
+ * @param Length
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdRegisterEventsBatchInDebuggee(PDEBUGGER_EVENTS_BATCH_REQUEST EventsBatchRequest,
+                                UINT32                         Length)
+{
+    BOOL  Status;
+    ULONG ReturnedLength;
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    Status =
+        DeviceIoControl(g_DeviceHandle,                       // Handle to device
+                        IOCTL_DEBUGGER_REGISTER_EVENTS_BATCH, // IO Control code
+                        EventsBatchRequest,                   // Input Buffer to driver.
+                        Length,                               // Input buffer length
+                        EventsBatchRequest,                   // Output Buffer from driver.
+                        SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST, // Length of output buffer in bytes.
+                        &ReturnedLength,                      // Bytes placed in buffer.
+                        NULL                                  // synchronous call
+        );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        return FALSE;
+    }
+
+    //
+    // Now that we registered the batch (with or without error), we
+    // should send the results back to the debugger
+    //
+    return KdSendGeneralBuffersFromDebuggeeToDebugger(
+        DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_REGISTERING_EVENTS_BATCH,
+        EventsBatchRequest,
+        SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST,
+        TRUE);
+}
+
 /**
  * @brief Modify event ioctl in the debuggee
  * @param ModifyEvent
@@ -2713,52 +4190,65 @@ KdSendUsermodePrints(CHAR * Input, UINT32 Length)
 }
 
 /**
- * @brief Send each packet of debugging information (PDB) to the debugger
- * @param SymbolDetailPacket
- * @param CurrentSymbolInfoIndex
+ * @brief Send the debugging information (PDB) of modules to the debugger
+ * @details the details are sent in batches, each packet contains as many
+ * symbol details as fits in a serial packet
+ *
+ * @param SymbolDetails
  * @param TotalSymbols
  *
  * @return VOID
  */
 VOID
-KdSendSymbolDetailPacket(PMODULE_SYMBOL_DETAIL SymbolDetailPacket, UINT32 CurrentSymbolInfoIndex, UINT32 TotalSymbols)
+KdSendSymbolDetailPackets(PMODULE_SYMBOL_DETAIL SymbolDetails, UINT32 TotalSymbols)
 {
     BOOLEAN                       Result;
-    ULONG                         ReturnedLength;
+    UINT32                        SymbolsCount;
+    UINT32                        RequestSize;
     PDEBUGGER_UPDATE_SYMBOL_TABLE UsermodeSymDetailRequest;
 
-    UsermodeSymDetailRequest =
-        (DEBUGGER_UPDATE_SYMBOL_TABLE *)malloc(sizeof(DEBUGGER_UPDATE_SYMBOL_TABLE));
+    UsermodeSymDetailRequest = (DEBUGGER_UPDATE_SYMBOL_TABLE *)malloc(sizeof(DEBUGGER_UPDATE_SYMBOL_TABLE) +
+                                                                      DEBUGGER_UPDATE_SYMBOL_TABLE_MAXIMUM_SYMBOLS_IN_PACKET * sizeof(MODULE_SYMBOL_DETAIL));
 
-    RtlZeroMemory(UsermodeSymDetailRequest, sizeof(DEBUGGER_UPDATE_SYMBOL_TABLE));
+    if (UsermodeSymDetailRequest == NULL)
+    {
+        ShowMessages("err, unable to allocate memory for symbol packets\n");
+        return;
+    }
 
-    //
-    // Set other parameters for the symbol details
-    //
-    UsermodeSymDetailRequest->CurrentSymbolIndex = CurrentSymbolInfoIndex;
-    UsermodeSymDetailRequest->TotalSymbols       = TotalSymbols;
+    for (UINT32 CurrentSymbolIndex = 0; CurrentSymbolIndex < TotalSymbols; CurrentSymbolIndex += SymbolsCount)
+    {
+        SymbolsCount = min(TotalSymbols - CurrentSymbolIndex, (UINT32)DEBUGGER_UPDATE_SYMBOL_TABLE_MAXIMUM_SYMBOLS_IN_PACKET);
+        RequestSize  = sizeof(DEBUGGER_UPDATE_SYMBOL_TABLE) + SymbolsCount * sizeof(MODULE_SYMBOL_DETAIL);
 
-    //
-    // Move the user message buffer at the bottom of the structure packet
-    //
-    memcpy((PVOID)((UINT64)&UsermodeSymDetailRequest->SymbolDetailPacket),
-           (PVOID)SymbolDetailPacket,
-           sizeof(MODULE_SYMBOL_DETAIL));
+        //
+        // Set other parameters for the symbol details
+        //
+        UsermodeSymDetailRequest->CurrentSymbolIndex = CurrentSymbolIndex;
+        UsermodeSymDetailRequest->TotalSymbols       = TotalSymbols;
+        UsermodeSymDetailRequest->SymbolsCount       = SymbolsCount;
 
-    //
-    // Send the symbol update buffer to the debugger
-    //
-    Result = KdSendGeneralBuffersFromDebuggeeToDebugger(
-        DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_UPDATE_SYMBOL_INFO,
-        UsermodeSymDetailRequest,
-        sizeof(DEBUGGER_UPDATE_SYMBOL_TABLE),
-        FALSE);
+        //
+        // Move the symbol details at the bottom of the structure packet
+        //
+        memcpy((PVOID)((UINT64)UsermodeSymDetailRequest + sizeof(DEBUGGER_UPDATE_SYMBOL_TABLE)),
+               (PVOID)&SymbolDetails[CurrentSymbolIndex],
+               SymbolsCount * sizeof(MODULE_SYMBOL_DETAIL));
 
-    if (!Result)
-    {
-        ShowMessages("err, sending symbol packets failed in debuggee");
-        free(UsermodeSymDetailRequest);
-        return;
+        //
+        // Send the symbol update buffer to the debugger
+        //
+        Result = KdSendGeneralBuffersFromDebuggeeToDebugger(
+            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_UPDATE_SYMBOL_INFO,
+            UsermodeSymDetailRequest,
+            RequestSize,
+            FALSE);
+
+        if (!Result)
+        {
+            ShowMessages("err, sending symbol packets failed in debuggee");
+            break;
+        }
     }
 
     free(UsermodeSymDetailRequest);
@@ -2783,14 +4273,10 @@ KdUninitializeConnection()
         g_SerialListeningThreadHandle = NULL;
     }
 
-    if (g_OverlappedIoStructureForReadDebugger.hEvent != NULL)
-    {
-        CloseHandle(g_OverlappedIoStructureForReadDebugger.hEvent);
-    }
-
-    if (g_OverlappedIoStructureForWriteDebugger.hEvent != NULL)
+    if (g_SerialBulkListeningThreadHandle != NULL)
     {
-        CloseHandle(g_OverlappedIoStructureForWriteDebugger.hEvent);
+        CloseHandle(g_SerialBulkListeningThreadHandle);
+        g_SerialBulkListeningThreadHandle = NULL;
     }
 
     if (g_DebuggeeStopCommandEventHandle != NULL)
@@ -2853,10 +4339,35 @@ KdUninitializeConnection()
     //
     if (g_SerialRemoteComPortHandle != NULL)
     {
-        CloseHandle(g_SerialRemoteComPortHandle);
+        //
+        // Stop serving the connection by the I/O thread (in debugger)
+        //
+        TransportCloseChannel(&g_KdTransportChannel);
+
+        if (g_IsDebuggerConnectedToNetwork)
+        {
+            CommunicationClientCleanup((SOCKET)g_SerialRemoteComPortHandle);
+        }
+        else
+        {
+            CloseHandle(g_SerialRemoteComPortHandle);
+        }
+
         g_SerialRemoteComPortHandle = NULL;
     }
 
+    if (g_SerialRemoteComPortBulkHandle != NULL)
+    {
+        //
+        // The listening thread of the bulk link returns once its
+        // channel is closed
+        //
+        TransportCloseChannel(&g_KdBulkTransportChannel);
+
+        CloseHandle(g_SerialRemoteComPortBulkHandle);
+        g_SerialRemoteComPortBulkHandle = NULL;
+    }
+
     //
     // Start getting debuggee messages on next try
     //
@@ -2866,4 +4377,9 @@ KdUninitializeConnection()
     // Is serial handle for a named pipe
     //
     g_IsDebuggerConntectedToNamedPipe = FALSE;
+
+    //
+    // Is serial handle for a UDP socket
+    //
+    g_IsDebuggerConnectedToNetwork = FALSE;
 }
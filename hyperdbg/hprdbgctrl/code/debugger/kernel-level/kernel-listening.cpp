@@ -18,13 +18,12 @@
 extern DEBUGGER_SYNCRONIZATION_EVENTS_STATE
                                             g_KernelSyncronizationObjectsHandleTable[DEBUGGER_MAXIMUM_SYNCRONIZATION_KERNEL_DEBUGGER_OBJECTS];
 extern BYTE                                 g_CurrentRunningInstruction[MAXIMUM_INSTR_SIZE];
-extern OVERLAPPED                           g_OverlappedIoStructureForReadDebugger;
-extern OVERLAPPED                           g_OverlappedIoStructureForWriteDebugger;
 extern HANDLE                               g_SerialRemoteComPortHandle;
 extern BOOLEAN                              g_IsSerialConnectedToRemoteDebuggee;
 extern BOOLEAN                              g_IsDebuggeeRunning;
 extern BOOLEAN                              g_IgnoreNewLoggingMessages;
 extern BOOLEAN                              g_SharedEventStatus;
+extern DEBUGGER_EVENT_SCRIPT_STATISTICS     g_SharedEventScriptStatistics;
 extern BOOLEAN                              g_IsRunningInstruction32Bit;
 extern ULONG                                g_CurrentRemoteCore;
 extern DEBUGGER_EVENT_AND_ACTION_REG_BUFFER g_DebuggeeResultOfRegisteringEvent;
@@ -32,15 +31,268 @@ extern DEBUGGER_EVENT_AND_ACTION_REG_BUFFER
               g_DebuggeeResultOfAddingActionsToEvent;
 extern UINT64 g_ResultOfEvaluatedExpression;
 extern UINT32 g_ErrorStateOfResultOfEvaluatedExpression;
+extern std::map<std::string, REGS_ENUM> RegistersMap;
+extern PDEBUGGEE_REGISTERS_CONTEXT g_KdRegistersReadBuffer;
+extern EventCallback g_EventCallback;
+extern DEBUGGER_PATCH_MEMORY_REQUEST g_KdPatchMemoryResult;
+extern DEBUGGER_EPT_SNAPSHOT_REQUEST g_KdEptSnapshotResult;
+extern DEBUGGER_HALT_WATCHDOG_REQUEST g_KdHaltWatchdogResult;
+extern DEBUGGER_EVENTS_BATCH_REQUEST g_KdEventsBatchResult;
+extern DEBUGGER_QUERY_EVENTS_STATISTICS g_KdEventsStatisticsResult;
+extern KD_RECEIVING_LINK g_KdControlReceivingLink;
+extern KD_RECEIVING_LINK g_KdBulkReceivingLink;
+
+/**
+ * @brief Show the result of reading registers of the debuggee
+ *
+ * @param ReadRegisterResult
+ *
+ * @return VOID
+ */
+VOID
+KdShowResultOfReadingRegisters(PDEBUGGEE_REGISTER_READ_DESCRIPTION ReadRegisterResult)
+{
+    PGUEST_REGS                 Regs;
+    PGUEST_EXTRA_REGISTERS      ExtraRegs;
+    PDEBUGGEE_REGISTERS_CONTEXT Context;
+    RFLAGS                      Rflags = {0};
+
+    if (ReadRegisterResult->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        //
+        // Show the result of reading registers like rax=0000000000018b01
+        //
+        if (ReadRegisterResult->RegisterID == DEBUGGEE_SHOW_ALL_REGISTERS)
+        {
+            //
+            // The result might contain only the changed registers
+            //
+            Context = KdUpdateRegistersContextCache(ReadRegisterResult);
+
+            if (Context == NULL)
+            {
+                ShowMessages("err, the changed registers are received for unknown registers, "
+                             "please try again\n");
+                return;
+            }
+
+            //
+            // The registers are requested by the SDK (HyperDbgReadRegisters)
+            //
+            if (g_KdRegistersReadBuffer != NULL)
+            {
+                memcpy(g_KdRegistersReadBuffer, Context, sizeof(DEBUGGEE_REGISTERS_CONTEXT));
+                g_KdRegistersReadBuffer = NULL;
+                return;
+            }
+
+            Regs      = &Context->Regs;
+            ExtraRegs = &Context->ExtraRegs;
+
+            Rflags.AsUInt = ExtraRegs->RFLAGS;
+
+            ShowMessages(
+                "RAX=%016llx RBX=%016llx RCX=%016llx\n"
+                "RDX=%016llx RSI=% 016llx RDI=%016llx\n"
+                "RIP=%016llx RSP=%016llx RBP=%016llx\n"
+                "R8=%016llx  R9=%016llx  R10=%016llx\n"
+                "R11=%016llx R12=%016llx R13=%016llx\n"
+                "R14=%016llx R15=%016llx IOPL=%02x\n"
+                "%s  %s  %s  %s\n%s  %s  %s  %s  \n"
+                "CS %04x SS %04x DS %04x ES %04x FS %04x GS %04x\n"
+                "RFLAGS=%016llx\n",
+                Regs->rax,
+                Regs->rbx,
+                Regs->rcx,
+                Regs->rdx,
+                Regs->rsi,
+                Regs->rdi,
+                ExtraRegs->RIP,
+                Regs->rsp,
+                Regs->rbp,
+                Regs->r8,
+                Regs->r9,
+                Regs->r10,
+                Regs->r11,
+                Regs->r12,
+                Regs->r13,
+                Regs->r14,
+                Regs->r15,
+                Rflags.IoPrivilegeLevel,
+                Rflags.OverflowFlag ? "OF 1" : "OF 0",
+                Rflags.DirectionFlag ? "DF 1" : "DF 0",
+                Rflags.InterruptEnableFlag ? "IF 1" : "IF 0",
+                Rflags.SignFlag ? "SF  1" : "SF  0",
+                Rflags.ZeroFlag ? "ZF 1" : "ZF 0",
+                Rflags.ParityFlag ? "PF 1" : "PF 0",
+                Rflags.CarryFlag ? "CF 1" : "CF 0",
+                Rflags.AuxiliaryCarryFlag ? "AXF 1" : "AXF 0",
+                ExtraRegs->CS,
+                ExtraRegs->SS,
+                ExtraRegs->DS,
+                ExtraRegs->ES,
+                ExtraRegs->FS,
+                ExtraRegs->GS,
+                ExtraRegs->RFLAGS);
+        }
+        else
+        {
+            ShowMessages("%s=%016llx\n",
+                         RegistersNames[ReadRegisterResult->RegisterID],
+                         ReadRegisterResult->Value);
+        }
+    }
+    else
+    {
+        ShowErrorMessage(ReadRegisterResult->KernelStatus);
+    }
+}
+
+/**
+ * @brief Show the result of '!pte' in the debuggee
+ *
+ * @param PteResult
+ *
+ * @return VOID
+ */
+VOID
+KdShowResultOfPte(PDEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS PteResult)
+{
+    if (PteResult->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        //
+        // Show the Page Tables result
+        //
+        CommandPteShowResults(PteResult->VirtualAddress, PteResult);
+    }
+    else
+    {
+        ShowErrorMessage(PteResult->KernelStatus);
+    }
+}
+
+/**
+ * @brief Show the result of '!va2pa' or '!pa2va' in the debuggee
+ *
+ * @param Va2paPa2vaResult
+ *
+ * @return VOID
+ */
+VOID
+KdShowResultOfVa2paAndPa2va(PDEBUGGER_VA2PA_AND_PA2VA_COMMANDS Va2paPa2vaResult)
+{
+    if (Va2paPa2vaResult->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        if (Va2paPa2vaResult->IsVirtual2Physical)
+        {
+            ShowMessages("%llx\n", Va2paPa2vaResult->PhysicalAddress);
+        }
+        else
+        {
+            ShowMessages("%llx\n", Va2paPa2vaResult->VirtualAddress);
+        }
+    }
+    else
+    {
+        ShowErrorMessage(Va2paPa2vaResult->KernelStatus);
+    }
+}
+
+/**
+ * @brief Show the result of running a count of instructions in the debuggee
+ *
+ * @param BudgetResult
+ *
+ * @return VOID
+ */
+VOID
+KdShowResultOfInstructionBudget(PDEBUGGEE_INSTRUCTION_BUDGET_PACKET BudgetResult)
+{
+    if (BudgetResult->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(BudgetResult->KernelStatus);
+        return;
+    }
+
+    ShowMessages("%llx instruction(s) executed (%llx counted, %llx stepped)%s\n",
+                 BudgetResult->CountOfCountedInstructions + BudgetResult->CountOfSteppedInstructions,
+                 BudgetResult->CountOfCountedInstructions,
+                 BudgetResult->CountOfSteppedInstructions,
+                 BudgetResult->IsInterrupted ? ", interrupted before running all of the instructions" : "");
+}
+
+/**
+ * @brief Show a chunk of the trace of the steps in the debuggee
+ *
+ * @param StepTraceResult
+ * @param Length Length of the chunk (including its header)
+ *
+ * @return VOID
+ */
+VOID
+KdShowResultOfStepTrace(PDEBUGGEE_STEP_TRACE_RESULT_PACKET StepTraceResult, UINT32 Length)
+{
+    std::string RegisterName = "value";
+    UINT32      CountOfWords = 1;
+    UINT64 *    Entries      = (UINT64 *)((CHAR *)StepTraceResult + sizeof(DEBUGGEE_STEP_TRACE_RESULT_PACKET));
+
+    if (StepTraceResult->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(StepTraceResult->KernelStatus);
+        return;
+    }
+
+    if (StepTraceResult->RecordedRegister != DEBUGGEE_STEP_TRACE_NO_REGISTER)
+    {
+        CountOfWords = 2;
+
+        for (auto & Register : RegistersMap)
+        {
+            if (Register.second == StepTraceResult->RecordedRegister)
+            {
+                RegisterName = Register.first;
+                break;
+            }
+        }
+    }
+
+    if (Length < sizeof(DEBUGGEE_STEP_TRACE_RESULT_PACKET) ||
+        StepTraceResult->CountOfEntries > (Length - sizeof(DEBUGGEE_STEP_TRACE_RESULT_PACKET)) / (CountOfWords * sizeof(UINT64)))
+    {
+        ShowMessages("err, invalid chunk (%x) received for the trace of the steps\n",
+                     StepTraceResult->SequenceNumber);
+        return;
+    }
+
+    for (UINT32 i = 0; i < StepTraceResult->CountOfEntries; i++)
+    {
+        if (CountOfWords == 1)
+        {
+            ShowMessages("%016llx\n", Entries[i]);
+        }
+        else
+        {
+            ShowMessages("%016llx    %s=%016llx\n",
+                         Entries[i * 2],
+                         RegisterName.c_str(),
+                         Entries[i * 2 + 1]);
+        }
+    }
+}
 
 /**
  * @brief Check if the remote debuggee needs to pause the system
  * and also process the debuggee's messages
+ * @details the packets of the bulk link are processed by a separate
+ * thread, as the debuggee only sends the bulk data over it, the
+ * connection is not closed once the bulk link is closed
+ *
+ * @param Link The control link or the bulk link
  *
  * @return BOOLEAN
  */
 BOOLEAN
-ListeningSerialPortInDebugger()
+ListeningSerialPortInDebugger(PKD_RECEIVING_LINK Link)
 {
     PDEBUGGER_PREPARE_DEBUGGEE                  InitPacket;
     PDEBUGGER_REMOTE_PACKET                     TheActualPacket;
@@ -63,14 +315,22 @@ ListeningSerialPortInDebugger()
     PDEBUGGEE_REGISTER_READ_DESCRIPTION         ReadRegisterPacket;
     PDEBUGGER_READ_MEMORY                       ReadMemoryPacket;
     PDEBUGGER_EDIT_MEMORY                       EditMemoryPacket;
+    PDEBUGGER_PATCH_MEMORY_REQUEST              PatchMemoryPacket;
+    PDEBUGGER_EPT_SNAPSHOT_REQUEST              EptSnapshotPacket;
+    PDEBUGGER_HALT_WATCHDOG_REQUEST             HaltWatchdogPacket;
+    PDEBUGGER_EVENTS_BATCH_REQUEST              EventsBatchPacket;
+    PDEBUGGER_QUERY_EVENTS_STATISTICS           EventsStatisticsPacket;
     PDEBUGGEE_BP_PACKET                         BpPacket;
     PDEBUGGER_SHORT_CIRCUITING_EVENT            ShortCircuitingPacket;
     PDEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS   PtePacket;
     PDEBUGGER_VA2PA_AND_PA2VA_COMMANDS          Va2paPa2vaPacket;
     PDEBUGGEE_BP_LIST_OR_MODIFY_PACKET          ListOrModifyBreakpointPacket;
-    PGUEST_REGS                                 Regs;
-    PGUEST_EXTRA_REGISTERS                      ExtraRegs;
+    PDEBUGGEE_BATCH_REQUESTS_PACKET             BatchRequestsPacket;
+    PDEBUGGEE_STEP_TRACE_RESULT_PACKET          StepTracePacket;
+    PDEBUGGEE_INSTRUCTION_BUDGET_PACKET         BudgetPacket;
+    PDEBUGGEE_TRANSPORT_TEST_PACKET             TransportTestPacket;
     unsigned char *                             MemoryBuffer;
+    string                                      StackTraceFormattedMessage;
     BOOLEAN                                     ShowSignatureWhenDisconnected = FALSE;
 
 StartAgain:
@@ -82,8 +342,17 @@ StartAgain:
     // Wait for handshake to complete or in other words
     // get the receive packet
     //
-    if (!KdReceivePacketFromDebuggee(BufferToReceive, &LengthReceived))
+    if (!KdReceivePacketFromDebuggee(Link, BufferToReceive, &LengthReceived))
     {
+        if (Link == &g_KdBulkReceivingLink)
+        {
+            //
+            // The bulk link is closed (the connection is closed by the
+            // control link)
+            //
+            return FALSE;
+        }
+
         if (LengthReceived == 0 && BufferToReceive[0] == NULL)
         {
             //
@@ -183,7 +452,28 @@ StartAgain:
             //
             if (!g_IgnoreNewLoggingMessages)
             {
-                ShowMessages("%s", MessagePacket->Message);
+                //
+                // Messages of events are shown by the bulk lane, so the
+                // results of commands are not stuck behind them, stack
+                // trace records are resolved to symbols in the debugger
+                //
+                if (MessagePacket->OperationCode == (OPERATION_LOG_SCRIPT_STACK_TRACE_RECORD))
+                {
+                    if (CallstackFormatScriptStackTraceRecord((PSCRIPT_STACK_TRACE_RECORD)MessagePacket->Message,
+                                                              sizeof(MessagePacket->Message),
+                                                              StackTraceFormattedMessage))
+                    {
+                        MessageLanesShowBulkMessage(StackTraceFormattedMessage.c_str());
+                    }
+                }
+                else if (OPERATION_LOG_IS_BULK_MESSAGE(MessagePacket->OperationCode))
+                {
+                    MessageLanesShowBulkMessage(MessagePacket->Message);
+                }
+                else
+                {
+                    ShowMessages("%s", MessagePacket->Message);
+                }
             }
 
             break;
@@ -195,6 +485,12 @@ StartAgain:
             //
             g_IgnoreNewLoggingMessages = TRUE;
 
+            //
+            // Messages of events that are received before the pause are
+            // shown before the details of the pause
+            //
+            MessageLanesFlush();
+
             PausePacket = (DEBUGGEE_KD_PAUSED_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
 
             //
@@ -202,6 +498,13 @@ StartAgain:
             //
             g_IsDebuggeeRunning = FALSE;
 
+            //
+            // The debuggee is halted again, so the memory snapshot and the
+            // objects of the previous halt are no longer valid
+            //
+            KdMemoryCacheInvalidate();
+            KdObjectCacheInvalidate();
+
             //
             // Set the current core
             //
@@ -215,6 +518,14 @@ StartAgain:
 
             g_IsRunningInstruction32Bit = PausePacket->Is32BitAddress;
 
+            //
+            // Pass the pausing packet to the SDK (without formatting)
+            //
+            if (g_EventCallback != NULL)
+            {
+                g_EventCallback(PausePacket);
+            }
+
             //
             // Show additional messages before showing assembly and pausing
             //
@@ -337,7 +648,8 @@ StartAgain:
                 CommandTrackHandleReceivedInstructions(&PausePacket->InstructionBytesOnRip[0],
                                                        MAXIMUM_INSTR_SIZE,
                                                        PausePacket->Is32BitAddress ? FALSE : TRUE,
-                                                       PausePacket->Rip);
+                                                       PausePacket->Rip,
+                                                       PausePacket->Tsc);
 
                 //
                 // Unpause the debugger to get commands
@@ -359,8 +671,14 @@ StartAgain:
             case DEBUGGEE_PAUSING_REASON_PAUSE:
 
                 //
-                // Nothing
+                // The debugger is already unpaused once CTRL+C is pressed, but
+                // the asynchronous requests (SDK) wait for the pause itself
                 //
+                if (KdAreAsyncPauseRequestsPending())
+                {
+                    DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_IS_DEBUGGER_RUNNING);
+                }
+
                 break;
 
             case DEBUGGEE_PAUSING_REASON_DEBUGGEE_CORE_SWITCHED:
@@ -426,6 +744,15 @@ StartAgain:
 
             ChangeProcessPacket = (DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
 
+            //
+            // The entries of the list of processes are interpreted by the
+            // object cache
+            //
+            if (ChangeProcessPacket->ActionType == DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_QUERY_PROCESS_LIST_ENTRIES)
+            {
+                KdObjectCacheReceivedQueryResult(ChangeProcessPacket, LengthReceived - sizeof(DEBUGGER_REMOTE_PACKET));
+            }
+
             if (ChangeProcessPacket->Result == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
             {
                 if (ChangeProcessPacket->ActionType == DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_GET_PROCESS_DETAILS)
@@ -482,6 +809,15 @@ StartAgain:
 
             ChangeThreadPacket = (DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
 
+            //
+            // The entries of the list of threads are interpreted by the
+            // object cache
+            //
+            if (ChangeThreadPacket->ActionType == DEBUGGEE_DETAILS_AND_SWITCH_THREAD_QUERY_THREAD_LIST_ENTRIES)
+            {
+                KdObjectCacheReceivedQueryResult(ChangeThreadPacket, LengthReceived - sizeof(DEBUGGER_REMOTE_PACKET));
+            }
+
             if (ChangeThreadPacket->Result == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
             {
                 if (ChangeThreadPacket->ActionType == DEBUGGEE_DETAILS_AND_SWITCH_THREAD_GET_THREAD_DETAILS)
@@ -552,7 +888,8 @@ StartAgain:
                 CallstackShowFrames(CallstackFramePacket,
                                     CallstackPacket->FrameCount,
                                     CallstackPacket->DisplayMethod,
-                                    CallstackPacket->Is32Bit);
+                                    CallstackPacket->Is32Bit,
+                                    CallstackPacket->IsUnwound);
             }
             else
             {
@@ -670,6 +1007,43 @@ StartAgain:
 
             break;
 
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_REGISTERING_EVENTS_BATCH:
+
+            EventsBatchPacket = (DEBUGGER_EVENTS_BATCH_REQUEST *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+            //
+            // Save the result, the errors are shown by the sender of the request
+            //
+            memcpy(&g_KdEventsBatchResult, EventsBatchPacket, SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST);
+
+            //
+            // Signal the event relating to receiving result of registering the batch
+            //
+            DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_REGISTER_EVENTS_BATCH_RESULT);
+
+            break;
+
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_QUERY_EVENTS_STATISTICS:
+
+            EventsStatisticsPacket = (DEBUGGER_QUERY_EVENTS_STATISTICS *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+            //
+            // Only the filled entries are received
+            //
+            RtlZeroMemory(&g_KdEventsStatisticsResult, SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS);
+
+            memcpy(&g_KdEventsStatisticsResult,
+                   EventsStatisticsPacket,
+                   SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS_HEADER +
+                       min(EventsStatisticsPacket->CountOfEvents, MaximumEventsStatisticsToQuery) * sizeof(DEBUGGER_EVENT_STATISTICS));
+
+            //
+            // Signal the event relating to receiving result of the query
+            //
+            DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_QUERY_EVENTS_STATISTICS_RESULT);
+
+            break;
+
         case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_QUERY_AND_MODIFY_EVENT:
 
             EventModifyAndQueryPacket = (DEBUGGER_MODIFY_EVENTS *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
@@ -689,7 +1063,8 @@ StartAgain:
                 //
                 // Set the global state
                 //
-                g_SharedEventStatus = EventModifyAndQueryPacket->IsEnabled;
+                g_SharedEventStatus           = EventModifyAndQueryPacket->IsEnabled;
+                g_SharedEventScriptStatistics = EventModifyAndQueryPacket->ScriptStatistics;
             }
             else
             {
@@ -738,74 +1113,10 @@ StartAgain:
 
             ReadRegisterPacket = (DEBUGGEE_REGISTER_READ_DESCRIPTION *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
 
-            if (ReadRegisterPacket->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
-            {
-                //
-                // Show the result of reading registers like rax=0000000000018b01
-                //
-                if (ReadRegisterPacket->RegisterID == DEBUGGEE_SHOW_ALL_REGISTERS)
-                {
-                    Regs      = (GUEST_REGS *)(((CHAR *)ReadRegisterPacket) + sizeof(DEBUGGEE_REGISTER_READ_DESCRIPTION));
-                    ExtraRegs = (GUEST_EXTRA_REGISTERS *)(((CHAR *)ReadRegisterPacket) + sizeof(DEBUGGEE_REGISTER_READ_DESCRIPTION) + sizeof(GUEST_REGS));
-
-                    RFLAGS Rflags = {0};
-                    Rflags.AsUInt = ExtraRegs->RFLAGS;
-
-                    ShowMessages(
-                        "RAX=%016llx RBX=%016llx RCX=%016llx\n"
-                        "RDX=%016llx RSI=% 016llx RDI=%016llx\n"
-                        "RIP=%016llx RSP=%016llx RBP=%016llx\n"
-                        "R8=%016llx  R9=%016llx  R10=%016llx\n"
-                        "R11=%016llx R12=%016llx R13=%016llx\n"
-                        "R14=%016llx R15=%016llx IOPL=%02x\n"
-                        "%s  %s  %s  %s\n%s  %s  %s  %s  \n"
-                        "CS %04x SS %04x DS %04x ES %04x FS %04x GS %04x\n"
-                        "RFLAGS=%016llx\n",
-                        Regs->rax,
-                        Regs->rbx,
-                        Regs->rcx,
-                        Regs->rdx,
-                        Regs->rsi,
-                        Regs->rdi,
-                        ExtraRegs->RIP,
-                        Regs->rsp,
-                        Regs->rbp,
-                        Regs->r8,
-                        Regs->r9,
-                        Regs->r10,
-                        Regs->r11,
-                        Regs->r12,
-                        Regs->r13,
-                        Regs->r14,
-                        Regs->r15,
-                        Rflags.IoPrivilegeLevel,
-                        Rflags.OverflowFlag ? "OF 1" : "OF 0",
-                        Rflags.DirectionFlag ? "DF 1" : "DF 0",
-                        Rflags.InterruptEnableFlag ? "IF 1" : "IF 0",
-                        Rflags.SignFlag ? "SF  1" : "SF  0",
-                        Rflags.ZeroFlag ? "ZF 1" : "ZF 0",
-                        Rflags.ParityFlag ? "PF 1" : "PF 0",
-                        Rflags.CarryFlag ? "CF 1" : "CF 0",
-                        Rflags.AuxiliaryCarryFlag ? "AXF 1" : "AXF 0",
-                        ExtraRegs->CS,
-                        ExtraRegs->SS,
-                        ExtraRegs->DS,
-                        ExtraRegs->ES,
-                        ExtraRegs->FS,
-                        ExtraRegs->GS,
-                        ExtraRegs->RFLAGS);
-                }
-                else
-                {
-                    ShowMessages("%s=%016llx\n",
-                                 RegistersNames[ReadRegisterPacket->RegisterID],
-                                 ReadRegisterPacket->Value);
-                }
-            }
-            else
-            {
-                ShowErrorMessage(ReadRegisterPacket->KernelStatus);
-            }
+            //
+            // Show the result of reading registers
+            //
+            KdShowResultOfReadingRegisters(ReadRegisterPacket);
 
             //
             // Signal the event relating to receiving result of reading registers
@@ -816,123 +1127,109 @@ StartAgain:
         case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_READING_MEMORY:
 
             ReadMemoryPacket = (DEBUGGER_READ_MEMORY *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+            MemoryBuffer     = (unsigned char *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET) + sizeof(DEBUGGER_READ_MEMORY));
 
-            if (ReadMemoryPacket->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+            //
+            // Save the chunk, the waiting thread shows the memory once
+            // the last chunk is received
+            //
+            if (KdReceivedReadMemoryChunk(ReadMemoryPacket, MemoryBuffer))
             {
                 //
-                // Show the result of reading memory like mem=0000000000018b01
+                // Signal the event relating to receiving result of reading memory
                 //
-                MemoryBuffer = (unsigned char *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET) + sizeof(DEBUGGER_READ_MEMORY));
-
-                switch (ReadMemoryPacket->Style)
-                {
-                case DEBUGGER_SHOW_COMMAND_DISASSEMBLE64:
-
-                    //
-                    // Show diassembles
-                    //
-                    HyperDbgDisassembler64(MemoryBuffer, ReadMemoryPacket->Address, ReadMemoryPacket->ReturnLength, 0, FALSE, NULL);
+                DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_READ_MEMORY);
+            }
 
-                    break;
+            break;
 
-                case DEBUGGER_SHOW_COMMAND_DISASSEMBLE32:
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_EDITING_MEMORY:
 
-                    //
-                    // Show diassembles
-                    //
-                    HyperDbgDisassembler32(MemoryBuffer, ReadMemoryPacket->Address, ReadMemoryPacket->ReturnLength, 0, FALSE, NULL);
+            EditMemoryPacket = (DEBUGGER_EDIT_MEMORY *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
 
-                    break;
+            if (EditMemoryPacket->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+            {
+                //
+                // Show the result of reading memory like mem=0000000000018b01
+                //
+            }
+            else
+            {
+                ShowErrorMessage(EditMemoryPacket->KernelStatus);
+            }
 
-                case DEBUGGER_SHOW_COMMAND_DB:
+            //
+            // Signal the event relating to receiving result of reading registers
+            //
+            DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_EDIT_MEMORY);
 
-                    ShowMemoryCommandDB(
-                        MemoryBuffer,
-                        ReadMemoryPacket->Size,
-                        ReadMemoryPacket->Address,
-                        ReadMemoryPacket->MemoryType,
-                        ReadMemoryPacket->ReturnLength);
+            break;
 
-                    break;
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_PATCHING_MEMORY:
 
-                case DEBUGGER_SHOW_COMMAND_DC:
+            PatchMemoryPacket = (DEBUGGER_PATCH_MEMORY_REQUEST *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
 
-                    ShowMemoryCommandDC(
-                        MemoryBuffer,
-                        ReadMemoryPacket->Size,
-                        ReadMemoryPacket->Address,
-                        ReadMemoryPacket->MemoryType,
-                        ReadMemoryPacket->ReturnLength);
+            //
+            // Save the result, the errors are shown by the sender of the request
+            //
+            memcpy(&g_KdPatchMemoryResult, PatchMemoryPacket, SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST);
 
-                    break;
+            //
+            // Signal the event relating to receiving result of patching memory
+            //
+            DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_PATCH_MEMORY_RESULT);
 
-                case DEBUGGER_SHOW_COMMAND_DD:
+            break;
 
-                    ShowMemoryCommandDD(
-                        MemoryBuffer,
-                        ReadMemoryPacket->Size,
-                        ReadMemoryPacket->Address,
-                        ReadMemoryPacket->MemoryType,
-                        ReadMemoryPacket->ReturnLength);
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_EPT_SNAPSHOT:
 
-                    break;
+            EptSnapshotPacket = (DEBUGGER_EPT_SNAPSHOT_REQUEST *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
 
-                case DEBUGGER_SHOW_COMMAND_DQ:
+            //
+            // Save the result, the errors are shown by the sender of the request
+            //
+            memcpy(&g_KdEptSnapshotResult, EptSnapshotPacket, SIZEOF_DEBUGGER_EPT_SNAPSHOT_REQUEST);
 
-                    ShowMemoryCommandDQ(
-                        MemoryBuffer,
-                        ReadMemoryPacket->Size,
-                        ReadMemoryPacket->Address,
-                        ReadMemoryPacket->MemoryType,
-                        ReadMemoryPacket->ReturnLength);
+            //
+            // Signal the event relating to receiving result of the snapshot
+            //
+            DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_EPT_SNAPSHOT_RESULT);
 
-                    break;
+            break;
 
-                case DEBUGGER_SHOW_COMMAND_DT:
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_HALT_WATCHDOG:
 
-                    //
-                    // Show the 'dt' command view
-                    //
-                    ScriptEngineShowDataBasedOnSymbolTypesWrapper(ReadMemoryPacket->DtDetails->TypeName,
-                                                                  ReadMemoryPacket->Address,
-                                                                  FALSE,
-                                                                  MemoryBuffer,
-                                                                  ReadMemoryPacket->DtDetails->AdditionalParameters);
+            HaltWatchdogPacket = (DEBUGGER_HALT_WATCHDOG_REQUEST *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
 
-                    break;
-                }
-            }
-            else
-            {
-                ShowErrorMessage(ReadMemoryPacket->KernelStatus);
-            }
+            //
+            // Save the result, the errors are shown by the sender of the request
+            //
+            memcpy(&g_KdHaltWatchdogResult, HaltWatchdogPacket, SIZEOF_DEBUGGER_HALT_WATCHDOG_REQUEST);
 
             //
-            // Signal the event relating to receiving result of reading registers
+            // Signal the event relating to receiving result of the watchdog
             //
-            DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_READ_MEMORY);
+            DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_HALT_WATCHDOG_RESULT);
 
             break;
 
-        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_EDITING_MEMORY:
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_CONTINUED_BY_HALT_WATCHDOG:
 
-            EditMemoryPacket = (DEBUGGER_EDIT_MEMORY *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+            HaltWatchdogPacket = (DEBUGGER_HALT_WATCHDOG_REQUEST *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
 
-            if (EditMemoryPacket->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
-            {
-                //
-                // Show the result of reading memory like mem=0000000000018b01
-                //
-            }
-            else
-            {
-                ShowErrorMessage(EditMemoryPacket->KernelStatus);
-            }
+            ShowMessages("\nthe debuggee is continued by the halt watchdog, no command is received "
+                         "for %x milliseconds (count of timeouts: %llx, time-stamp: %llx)\n",
+                         HaltWatchdogPacket->Timeout,
+                         HaltWatchdogPacket->CountOfTimeouts,
+                         HaltWatchdogPacket->LastTimeoutTsc);
 
             //
-            // Signal the event relating to receiving result of reading registers
+            // The debuggee is running (it can be paused by CTRL+C), and its
+            // messages are shown again
             //
-            DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_EDIT_MEMORY);
+            g_CurrentRemoteCore        = DEBUGGER_DEBUGGEE_IS_RUNNING_NO_CORE;
+            g_IsDebuggeeRunning        = TRUE;
+            g_IgnoreNewLoggingMessages = FALSE;
 
             break;
 
@@ -982,17 +1279,10 @@ StartAgain:
 
             PtePacket = (DEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
 
-            if (PtePacket->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
-            {
-                //
-                // Show the Page Tables result
-                //
-                CommandPteShowResults(PtePacket->VirtualAddress, PtePacket);
-            }
-            else
-            {
-                ShowErrorMessage(PtePacket->KernelStatus);
-            }
+            //
+            // Show the Page Tables result
+            //
+            KdShowResultOfPte(PtePacket);
 
             //
             // Signal the event relating to receiving result of PTE query
@@ -1005,26 +1295,90 @@ StartAgain:
 
             Va2paPa2vaPacket = (DEBUGGER_VA2PA_AND_PA2VA_COMMANDS *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
 
-            if (Va2paPa2vaPacket->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+            //
+            // Show the result of the conversion
+            //
+            KdShowResultOfVa2paAndPa2va(Va2paPa2vaPacket);
+
+            //
+            // Signal the event relating to receiving result of VA2PA or PA2VA queries
+            //
+            DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_VA2PA_AND_PA2VA_RESULT);
+
+            break;
+
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_BATCH_REQUESTS:
+
+            BatchRequestsPacket = (DEBUGGEE_BATCH_REQUESTS_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+            //
+            // Show the results in the same order as the requests
+            //
+            KdBatchRequestsShowResults(BatchRequestsPacket, LengthReceived - sizeof(DEBUGGER_REMOTE_PACKET));
+
+            //
+            // Signal the event relating to receiving result of the batch of requests
+            //
+            DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_BATCH_RESULT);
+
+            break;
+
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_STEP_TRACE:
+
+            StepTracePacket = (DEBUGGEE_STEP_TRACE_RESULT_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+            //
+            // Show the recorded steps of this chunk
+            //
+            KdShowResultOfStepTrace(StepTracePacket, LengthReceived - sizeof(DEBUGGER_REMOTE_PACKET));
+
+            if (StepTracePacket->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
             {
-                if (Va2paPa2vaPacket->IsVirtual2Physical)
-                {
-                    ShowMessages("%llx\n", Va2paPa2vaPacket->PhysicalAddress);
-                }
-                else
-                {
-                    ShowMessages("%llx\n", Va2paPa2vaPacket->VirtualAddress);
-                }
+                //
+                // The steps are not performed, so the debuggee won't be
+                // paused again, signal the event relating to the steps
+                //
+                DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_IS_DEBUGGER_RUNNING);
             }
-            else
+
+            break;
+
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_RUN_INSTRUCTIONS:
+
+            BudgetPacket = (DEBUGGEE_INSTRUCTION_BUDGET_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+            //
+            // Show the count of the executed instructions (the debuggee is
+            // paused after this packet)
+            //
+            KdShowResultOfInstructionBudget(BudgetPacket);
+
+            if (BudgetPacket->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
             {
-                ShowErrorMessage(Va2paPa2vaPacket->KernelStatus);
+                //
+                // The instructions are not run, so the debuggee is still
+                // paused, signal the event relating to running the debuggee
+                //
+                g_IsDebuggeeRunning = FALSE;
+
+                DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_IS_DEBUGGER_RUNNING);
             }
 
+            break;
+
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_TRANSPORT_TEST:
+
+            TransportTestPacket = (DEBUGGEE_TRANSPORT_TEST_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
             //
-            // Signal the event relating to receiving result of VA2PA or PA2VA queries
+            // Check the payload and save the result
             //
-            DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_VA2PA_AND_PA2VA_RESULT);
+            KdCheckResultOfTransportTest(TransportTestPacket, LengthReceived - sizeof(DEBUGGER_REMOTE_PACKET));
+
+            //
+            // Signal the event relating to receiving result of the transport test
+            //
+            DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_TRANSPORT_TEST_RESULT);
 
             break;
 
@@ -1057,7 +1411,16 @@ StartAgain:
             //
             // Perform updates for the symbol table
             //
-            SymbolBuildAndUpdateSymbolTable(&SymbolUpdatePacket->SymbolDetailPacket);
+            SymbolBuildAndUpdateSymbolTable(SymbolUpdatePacket);
+
+            break;
+
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_ADD_MODULE_SYMBOL_INFO:
+
+            //
+            // A new module is loaded in the debuggee, only load its symbols
+            //
+            SymbolAddModuleToSymbolTable((MODULE_SYMBOL_DETAIL *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET)));
 
             break;
 
@@ -1094,12 +1457,10 @@ ListeningSerialPortInDebuggee()
 {
 StartAgain:
 
-    BOOL Status;                                    /* Status */
+    BOOL Status;                                 /* Status */
     char SerialBuffer[MaxSerialPacketSize] = {
-        0};                                         /* Buffer to send and receive data */
-    DWORD                   EventMask       = 0;    /* Event mask to trigger */
-    char                    ReadData        = NULL; /* temperory Character */
-    DWORD                   NoBytesRead     = 0;    /* Bytes read by ReadFile() */
+        0};                                      /* Buffer to send and receive data */
+    DWORD                   EventMask       = 0; /* Event mask to trigger */
     UINT32                  Loop            = 0;
     PDEBUGGER_REMOTE_PACKET TheActualPacket = (PDEBUGGER_REMOTE_PACKET)SerialBuffer;
 
@@ -1132,45 +1493,13 @@ StartAgain:
     }
 
     //
-    // Read data and store in a buffer
+    // Read exactly one frame and store it in a buffer, because we used
+    // overlapped I/O on the other side, sometimes the debuggee might cancel
+    // the read so it returns, if it returns then we should restart reading
+    // again
     //
-    do
+    if (!KdReceivePacketFromDebuggee(&g_KdControlReceivingLink, SerialBuffer, &Loop))
     {
-        Status = ReadFile(g_SerialRemoteComPortHandle, &ReadData, sizeof(ReadData), &NoBytesRead, NULL);
-
-        //
-        // Check to make sure that we don't pass the boundaries
-        //
-        if (!(MaxSerialPacketSize > Loop))
-        {
-            //
-            // Invalid buffer
-            //
-            ShowMessages("err, a buffer received in debuggee which exceeds the "
-                         "buffer limitation\n");
-            goto StartAgain;
-        }
-
-        SerialBuffer[Loop] = ReadData;
-
-        if (KdCheckForTheEndOfTheBuffer(&Loop, (BYTE *)SerialBuffer))
-        {
-            break;
-        }
-
-        ++Loop;
-    } while (NoBytesRead > 0);
-
-    //
-    // Because we used overlapped I/O on the other side, sometimes
-    // the debuggee might cancel the read so it returns, if it returns
-    // then we should restart reading again
-    //
-    if (Loop == 1 && SerialBuffer[0] == NULL)
-    {
-        //
-        // Chunk data to cancel non async read
-        //
         goto StartAgain;
     }
 
@@ -1268,7 +1597,25 @@ ListeningSerialPauseDebuggerThread(PVOID Param)
     //
     // Create a listening thead in debugger
     //
-    ListeningSerialPortInDebugger();
+    ListeningSerialPortInDebugger(&g_KdControlReceivingLink);
+
+    return 0;
+}
+
+/**
+ * @brief Process the bulk data that the remote debuggee sends over
+ * the bulk link
+ *
+ * @param Param
+ * @return BOOLEAN
+ */
+DWORD WINAPI
+ListeningSerialBulkLinkDebuggerThread(PVOID Param)
+{
+    //
+    // Create a listening thead of the bulk link in debugger
+    //
+    ListeningSerialPortInDebugger(&g_KdBulkReceivingLink);
 
     return 0;
 }
@@ -0,0 +1,213 @@
+/**
+ * @file memory-cache.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Snapshot of the memory of the halted debuggee
+ * @details The memory that is read from the halted debuggee is cached by
+ * pages, so inspecting the same structures again is served locally, the
+ * cache is invalidated once anything that might change the memory is sent
+ * to the debuggee (e.g., continuing, stepping, or editing the memory)
+ *
+ * @version 0.4
+ * @date 2023-07-20
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern std::map<std::pair<UINT64, UINT64>, std::vector<BYTE>> g_KdMemoryCache;
+
+/**
+ * @brief Check whether the requested action doesn't change the memory
+ * of the debuggee
+ *
+ * @param RequestedAction
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdMemoryCacheIsReadOnlyAction(DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION RequestedAction)
+{
+    switch (RequestedAction)
+    {
+    case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_READ_MEMORY:
+    case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_READ_REGISTERS:
+    case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_CALLSTACK:
+    case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_SEARCH_QUERY:
+    case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_QUERY_PA2VA_AND_VA2PA:
+    case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_SYMBOL_QUERY_PTE:
+    case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_BATCH_REQUESTS:
+    case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_TRANSPORT_TEST:
+        return TRUE;
+
+    default:
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Remove all of the cached pages
+ *
+ * @return VOID
+ */
+VOID
+KdMemoryCacheInvalidate()
+{
+    g_KdMemoryCache.clear();
+}
+
+/**
+ * @brief Make the key of a cached page
+ *
+ * @param ReadMem The request of reading memory
+ * @param PageAddress
+ *
+ * @return std::pair<UINT64, UINT64>
+ */
+static std::pair<UINT64, UINT64>
+KdMemoryCacheGetKey(PDEBUGGER_READ_MEMORY ReadMem, UINT64 PageAddress)
+{
+    return std::make_pair(PageAddress, ((UINT64)ReadMem->MemoryType << 32) | ReadMem->Pid);
+}
+
+/**
+ * @brief Copy the requested memory from the cached pages
+ *
+ * @param ReadMem The request of reading memory
+ * @param Buffer The memory is saved here
+ *
+ * @return BOOLEAN Returns FALSE if any of the pages is not cached
+ */
+static BOOLEAN
+KdMemoryCacheLookup(PDEBUGGER_READ_MEMORY ReadMem, unsigned char * Buffer)
+{
+    UINT64 Address = ReadMem->Address;
+    UINT64 End     = ReadMem->Address + ReadMem->Size;
+    UINT64 PageAddress;
+    UINT32 Length;
+
+    while (Address < End)
+    {
+        PageAddress = Address & ~((UINT64)NORMAL_PAGE_SIZE - 1);
+        Length      = (UINT32)((End < PageAddress + NORMAL_PAGE_SIZE ? End : PageAddress + NORMAL_PAGE_SIZE) - Address);
+
+        auto Page = g_KdMemoryCache.find(KdMemoryCacheGetKey(ReadMem, PageAddress));
+
+        if (Page == g_KdMemoryCache.end())
+        {
+            return FALSE;
+        }
+
+        memcpy(Buffer + (Address - ReadMem->Address), Page->second.data() + (Address - PageAddress), Length);
+
+        Address += Length;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Save the pages that are completely read
+ *
+ * @param ReadMem The request of reading memory
+ * @param Address Address of the memory
+ * @param Buffer The memory
+ * @param Length Size of the memory
+ *
+ * @return VOID
+ */
+static VOID
+KdMemoryCacheInsert(PDEBUGGER_READ_MEMORY ReadMem, UINT64 Address, unsigned char * Buffer, UINT32 Length)
+{
+    UINT64 PageAddress = (Address + NORMAL_PAGE_SIZE - 1) & ~((UINT64)NORMAL_PAGE_SIZE - 1);
+
+    for (; PageAddress + NORMAL_PAGE_SIZE <= Address + Length; PageAddress += NORMAL_PAGE_SIZE)
+    {
+        if (g_KdMemoryCache.size() >= KdMemoryCacheMaximumPages)
+        {
+            KdMemoryCacheInvalidate();
+        }
+
+        g_KdMemoryCache[KdMemoryCacheGetKey(ReadMem, PageAddress)].assign(Buffer + (PageAddress - Address),
+                                                                          Buffer + (PageAddress - Address) + NORMAL_PAGE_SIZE);
+    }
+}
+
+/**
+ * @brief Read the memory of the halted debuggee by using the cached pages
+ * @details the missing pages are fetched along with the pages around them
+ * (aligned to KdMemoryCachePrefetchSize) by a single request
+ *
+ * @param ReadMem The request of reading memory
+ * @param Buffer The memory is saved here (ReadMem->Size bytes)
+ * @param ReturnLength Count of bytes that are read
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdMemoryCacheRead(PDEBUGGER_READ_MEMORY ReadMem, unsigned char * Buffer, UINT32 * ReturnLength)
+{
+    DEBUGGER_READ_MEMORY PrefetchRequest = {0};
+    unsigned char *      PrefetchBuffer  = NULL;
+    UINT32               PrefetchLength  = 0;
+    UINT64               PrefetchStart;
+    UINT64               PrefetchEnd;
+
+    if (KdMemoryCacheLookup(ReadMem, Buffer))
+    {
+        ReadMem->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+        *ReturnLength         = ReadMem->Size;
+
+        return TRUE;
+    }
+
+    //
+    // Fetch the pages around the requested memory
+    //
+    PrefetchStart = ReadMem->Address & ~((UINT64)KdMemoryCachePrefetchSize - 1);
+    PrefetchEnd   = (ReadMem->Address + ReadMem->Size + KdMemoryCachePrefetchSize - 1) & ~((UINT64)KdMemoryCachePrefetchSize - 1);
+
+    if (PrefetchEnd > PrefetchStart && PrefetchEnd - PrefetchStart <= MaxSerialReadMemorySize)
+    {
+        PrefetchBuffer = (unsigned char *)malloc((SIZE_T)(PrefetchEnd - PrefetchStart));
+    }
+
+    if (PrefetchBuffer != NULL)
+    {
+        memcpy(&PrefetchRequest, ReadMem, sizeof(DEBUGGER_READ_MEMORY));
+
+        PrefetchRequest.Address = PrefetchStart;
+        PrefetchRequest.Size    = (UINT32)(PrefetchEnd - PrefetchStart);
+
+        if (KdSendReadMemoryPacketToDebuggee(&PrefetchRequest, PrefetchBuffer, &PrefetchLength))
+        {
+            KdMemoryCacheInsert(ReadMem, PrefetchStart, PrefetchBuffer, PrefetchLength);
+        }
+
+        free(PrefetchBuffer);
+
+        if (KdMemoryCacheLookup(ReadMem, Buffer))
+        {
+            ReadMem->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+            *ReturnLength         = ReadMem->Size;
+
+            return TRUE;
+        }
+    }
+
+    //
+    // The pages around the memory are not available (e.g., they're not
+    // paged-in), so only the requested memory is read
+    //
+    if (!KdSendReadMemoryPacketToDebuggee(ReadMem, Buffer, ReturnLength))
+    {
+        return FALSE;
+    }
+
+    KdMemoryCacheInsert(ReadMem, ReadMem->Address, Buffer, *ReturnLength);
+
+    return TRUE;
+}
@@ -0,0 +1,286 @@
+/**
+ * @file object-cache.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Cache of the objects (processes and threads) of the halted debuggee
+ * @details The list of processes and threads are queried from the halted
+ * debuggee as entries (by pages), so showing the same list again is served
+ * locally, the cache is invalidated once the debuggee is continued or
+ * anything that might change the objects is sent to the debuggee
+ *
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern std::vector<DEBUGGEE_PROCESS_LIST_DETAILS_ENTRY>                  g_KdObjectCacheProcesses;
+extern BOOLEAN                                                           g_KdObjectCacheProcessesIsValid;
+extern std::map<UINT64, std::vector<DEBUGGEE_THREAD_LIST_DETAILS_ENTRY>> g_KdObjectCacheThreads;
+extern std::vector<BYTE>                                                 g_KdObjectCacheQueryResult;
+
+/**
+ * @brief Check whether the requested action doesn't change the objects
+ * of the debuggee
+ * @details the switch requests are only applied once the debuggee is
+ * continued
+ *
+ * @param RequestedAction
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdObjectCacheIsReadOnlyAction(DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION RequestedAction)
+{
+    switch (RequestedAction)
+    {
+    case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_CHANGE_PROCESS:
+    case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_CHANGE_THREAD:
+        return TRUE;
+
+    default:
+        return KdMemoryCacheIsReadOnlyAction(RequestedAction);
+    }
+}
+
+/**
+ * @brief Remove all of the cached objects
+ *
+ * @return VOID
+ */
+VOID
+KdObjectCacheInvalidate()
+{
+    g_KdObjectCacheProcesses.clear();
+    g_KdObjectCacheProcessesIsValid = FALSE;
+    g_KdObjectCacheThreads.clear();
+}
+
+/**
+ * @brief Save the result of querying the entries of the list of
+ * processes or threads
+ * @details called by the listening thread, the result is the packet
+ * followed by its entries
+ *
+ * @param Result The packet and the entries
+ * @param Length Size of the packet and the entries
+ *
+ * @return VOID
+ */
+VOID
+KdObjectCacheReceivedQueryResult(PVOID Result, UINT32 Length)
+{
+    g_KdObjectCacheQueryResult.assign((BYTE *)Result, (BYTE *)Result + Length);
+}
+
+/**
+ * @brief Query all of the entries of the process list from the debuggee
+ *
+ * @param SymDetailsForProcessList
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+KdObjectCacheQueryProcesses(PDEBUGGEE_PROCESS_LIST_NEEDED_DETAILS SymDetailsForProcessList)
+{
+    DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET       ProcessListPacket = {0};
+    PDEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET      ResultPacket;
+    PDEBUGGEE_PROCESS_LIST_DETAILS_ENTRY             Entries;
+    std::vector<DEBUGGEE_PROCESS_LIST_DETAILS_ENTRY> Processes;
+
+    ProcessListPacket.ActionType = DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_QUERY_PROCESS_LIST_ENTRIES;
+
+    memcpy(&ProcessListPacket.ProcessListSymDetails, SymDetailsForProcessList, sizeof(DEBUGGEE_PROCESS_LIST_NEEDED_DETAILS));
+
+    do
+    {
+        g_KdObjectCacheQueryResult.clear();
+
+        if (!KdCommandPacketAndBufferToDebuggee(
+                DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
+                DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_CHANGE_PROCESS,
+                (CHAR *)&ProcessListPacket,
+                sizeof(DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET)))
+        {
+            return FALSE;
+        }
+
+        //
+        // Wait until the entries are received
+        //
+        DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_PROCESS_SWITCHING_RESULT);
+
+        if (g_KdObjectCacheQueryResult.size() < sizeof(DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET))
+        {
+            return FALSE;
+        }
+
+        ResultPacket = (PDEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET)g_KdObjectCacheQueryResult.data();
+        Entries      = (PDEBUGGEE_PROCESS_LIST_DETAILS_ENTRY)(g_KdObjectCacheQueryResult.data() + sizeof(DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET));
+
+        if (ResultPacket->Result != DEBUGGER_OPERATION_WAS_SUCCESSFUL ||
+            ResultPacket->CountOfEntries > MaxSerialObjectListEntriesInPacket ||
+            g_KdObjectCacheQueryResult.size() < sizeof(DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET) +
+                                                    ResultPacket->CountOfEntries * sizeof(DEBUGGEE_PROCESS_LIST_DETAILS_ENTRY))
+        {
+            return FALSE;
+        }
+
+        Processes.insert(Processes.end(), Entries, Entries + ResultPacket->CountOfEntries);
+
+        //
+        // A full page means that there might be more processes
+        //
+        ProcessListPacket.StartIndex += ResultPacket->CountOfEntries;
+
+    } while (ResultPacket->CountOfEntries == MaxSerialObjectListEntriesInPacket);
+
+    g_KdObjectCacheProcesses        = std::move(Processes);
+    g_KdObjectCacheProcessesIsValid = TRUE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Query all of the entries of the thread list of a process from
+ * the debuggee
+ *
+ * @param SymDetailsForThreadList
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+KdObjectCacheQueryThreads(PDEBUGGEE_THREAD_LIST_NEEDED_DETAILS SymDetailsForThreadList)
+{
+    DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET       ThreadListPacket = {0};
+    PDEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET      ResultPacket;
+    PDEBUGGEE_THREAD_LIST_DETAILS_ENTRY             Entries;
+    std::vector<DEBUGGEE_THREAD_LIST_DETAILS_ENTRY> Threads;
+
+    ThreadListPacket.ActionType = DEBUGGEE_DETAILS_AND_SWITCH_THREAD_QUERY_THREAD_LIST_ENTRIES;
+
+    memcpy(&ThreadListPacket.ThreadListSymDetails, SymDetailsForThreadList, sizeof(DEBUGGEE_THREAD_LIST_NEEDED_DETAILS));
+
+    do
+    {
+        g_KdObjectCacheQueryResult.clear();
+
+        if (!KdCommandPacketAndBufferToDebuggee(
+                DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
+                DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_CHANGE_THREAD,
+                (CHAR *)&ThreadListPacket,
+                sizeof(DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET)))
+        {
+            return FALSE;
+        }
+
+        //
+        // Wait until the entries are received
+        //
+        DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_THREAD_SWITCHING_RESULT);
+
+        if (g_KdObjectCacheQueryResult.size() < sizeof(DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET))
+        {
+            return FALSE;
+        }
+
+        ResultPacket = (PDEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET)g_KdObjectCacheQueryResult.data();
+        Entries      = (PDEBUGGEE_THREAD_LIST_DETAILS_ENTRY)(g_KdObjectCacheQueryResult.data() + sizeof(DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET));
+
+        if (ResultPacket->Result != DEBUGGER_OPERATION_WAS_SUCCESSFUL ||
+            ResultPacket->CountOfEntries > MaxSerialObjectListEntriesInPacket ||
+            g_KdObjectCacheQueryResult.size() < sizeof(DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET) +
+                                                    ResultPacket->CountOfEntries * sizeof(DEBUGGEE_THREAD_LIST_DETAILS_ENTRY))
+        {
+            return FALSE;
+        }
+
+        Threads.insert(Threads.end(), Entries, Entries + ResultPacket->CountOfEntries);
+
+        //
+        // A full page means that there might be more threads
+        //
+        ThreadListPacket.StartIndex += ResultPacket->CountOfEntries;
+
+    } while (ResultPacket->CountOfEntries == MaxSerialObjectListEntriesInPacket);
+
+    //
+    // The threads are kept by the requested process (null means the
+    // current process)
+    //
+    g_KdObjectCacheThreads[SymDetailsForThreadList->Process] = std::move(Threads);
+
+    return TRUE;
+}
+
+/**
+ * @brief Show the list of processes of the halted debuggee
+ * @details the list is only queried once in each halt of the debuggee
+ *
+ * @param SymDetailsForProcessList
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdObjectCacheShowProcessList(PDEBUGGEE_PROCESS_LIST_NEEDED_DETAILS SymDetailsForProcessList)
+{
+    if (!g_KdObjectCacheProcessesIsValid && !KdObjectCacheQueryProcesses(SymDetailsForProcessList))
+    {
+        return FALSE;
+    }
+
+    for (auto & Process : g_KdObjectCacheProcesses)
+    {
+        ShowMessages("PROCESS\t%llx\n\tProcess Id: %04x\tDirBase (Kernel Cr3): %016llx\tImage: %s\n\n",
+                     Process.Eprocess,
+                     (UINT32)Process.Pid,
+                     Process.Cr3,
+                     Process.ImageFileName);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Show the list of threads of a process of the halted debuggee
+ * @details the list of each process is only queried once in each halt
+ * of the debuggee
+ *
+ * @param SymDetailsForThreadList
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdObjectCacheShowThreadList(PDEBUGGEE_THREAD_LIST_NEEDED_DETAILS SymDetailsForThreadList)
+{
+    auto Threads = g_KdObjectCacheThreads.find(SymDetailsForThreadList->Process);
+
+    if (Threads == g_KdObjectCacheThreads.end())
+    {
+        if (!KdObjectCacheQueryThreads(SymDetailsForThreadList))
+        {
+            return FALSE;
+        }
+
+        Threads = g_KdObjectCacheThreads.find(SymDetailsForThreadList->Process);
+    }
+
+    for (auto & Thread : Threads->second)
+    {
+        //
+        // All of the threads belong to the same process
+        //
+        if (&Thread == &Threads->second.front())
+        {
+            ShowMessages("PROCESS\t%llx\tIMAGE\t%s\n", Thread.Eprocess, Thread.ImageFileName);
+        }
+
+        ShowMessages("\tTHREAD\t%llx (%llx.%llx)\n", Thread.Ethread, Thread.Pid, Thread.Tid);
+    }
+
+    return TRUE;
+}
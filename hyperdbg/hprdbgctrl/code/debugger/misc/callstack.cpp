@@ -205,6 +205,8 @@ CallstackReturnAddressToCallingAddress(UCHAR * ReturnAddress, PUINT32 IndexOfCal
  * @param FrameCount
  * @param DisplayMethod
  * @param Is32Bit
+ * @param IsUnwound Whether the return addresses are found by unwinding the
+ * stack (only the marked frames are shown without the parameters)
  *
  * @return VOID
  */
@@ -212,13 +214,13 @@ VOID
 CallstackShowFrames(PDEBUGGER_SINGLE_CALLSTACK_FRAME  CallstackFrames,
                     UINT32                            FrameCount,
                     DEBUGGER_CALLSTACK_DISPLAY_METHOD DisplayMethod,
-                    BOOLEAN                           Is32Bit)
+                    BOOLEAN                           Is32Bit,
+                    BOOLEAN                           IsUnwound)
 {
-    UINT32                                                 CallLength;
-    UINT64                                                 TargetAddress;
-    UINT64                                                 UsedBaseAddress;
-    BOOLEAN                                                IsCall = FALSE;
-    std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION>::iterator Iterate;
+    UINT32  CallLength;
+    UINT64  TargetAddress;
+    UINT64  UsedBaseAddress;
+    BOOLEAN IsCall = FALSE;
 
     //
     // Print callstack frames
@@ -227,6 +229,16 @@ CallstackShowFrames(PDEBUGGER_SINGLE_CALLSTACK_FRAME  CallstackFrames,
     {
         IsCall = FALSE;
 
+        //
+        // The values that only look like return addresses are not shown
+        // once the stack is unwound
+        //
+        if (IsUnwound && DisplayMethod == DEBUGGER_CALLSTACK_DISPLAY_METHOD_WITHOUT_PARAMS &&
+            !CallstackFrames[i].IsUnwoundReturnAddress)
+        {
+            continue;
+        }
+
         if (CallstackFrames[i].IsValidAddress)
         {
             //
@@ -246,9 +258,11 @@ CallstackShowFrames(PDEBUGGER_SINGLE_CALLSTACK_FRAME  CallstackFrames,
             else
             {
                 //
-                // Check if we wanna show the stack params
+                // Check if we wanna show the stack params (the unwound return
+                // addresses of the interrupted frames are not after a call)
                 //
-                if (DisplayMethod == DEBUGGER_CALLSTACK_DISPLAY_METHOD_WITHOUT_PARAMS)
+                if (DisplayMethod == DEBUGGER_CALLSTACK_DISPLAY_METHOD_WITHOUT_PARAMS &&
+                    !CallstackFrames[i].IsUnwoundReturnAddress)
                 {
                     continue;
                 }
@@ -326,3 +340,61 @@ CallstackShowFrames(PDEBUGGER_SINGLE_CALLSTACK_FRAME  CallstackFrames,
         }
     }
 }
+
+/**
+ * @brief Format a stack trace record (the result of the stack function
+ * of the script engine)
+ * @details the return addresses are resolved to symbols here, the kernel
+ * only captures the raw addresses
+ *
+ * @param Record The record (followed by its return addresses)
+ * @param RecordLength Length of the record and its return addresses
+ * @param Result The formatted message
+ *
+ * @return BOOLEAN FALSE if the record is not valid
+ */
+BOOLEAN
+CallstackFormatScriptStackTraceRecord(PSCRIPT_STACK_TRACE_RECORD Record, UINT32 RecordLength, std::string & Result)
+{
+    UINT64 * ReturnAddresses = (UINT64 *)((CHAR *)Record + sizeof(SCRIPT_STACK_TRACE_RECORD));
+    UINT64   FunctionAddress;
+    string   FunctionName;
+    CHAR     Line[64];
+
+    if (RecordLength < sizeof(SCRIPT_STACK_TRACE_RECORD) ||
+        Record->FramesCount > MaximumScriptStackTraceFrames ||
+        RecordLength < sizeof(SCRIPT_STACK_TRACE_RECORD) + Record->FramesCount * sizeof(UINT64))
+    {
+        return FALSE;
+    }
+
+    sprintf_s(Line,
+              sizeof(Line),
+              "stack (core: %x, pid: %x, tid: %x):\n",
+              Record->CoreId,
+              Record->ProcessId,
+              Record->ThreadId);
+
+    Result = Line;
+
+    for (UINT32 i = 0; i < Record->FramesCount; i++)
+    {
+        sprintf_s(Line, sizeof(Line), "  [%02x] %s", i, SeparateTo64BitValue(ReturnAddresses[i]).c_str());
+        Result += Line;
+
+        //
+        // Show the name of the function if available
+        // Apply addressconversion of settings here
+        //
+        if (g_AddressConversion &&
+            SymbolQueryFunctionOfAddress(ReturnAddresses[i], &FunctionAddress, FunctionName))
+        {
+            sprintf_s(Line, sizeof(Line), "+0x%llx", ReturnAddresses[i] - FunctionAddress);
+            Result += " (" + FunctionName + Line + ")";
+        }
+
+        Result += "\n";
+    }
+
+    return TRUE;
+}
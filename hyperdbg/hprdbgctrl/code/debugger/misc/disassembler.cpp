@@ -40,9 +40,8 @@ all
 //
 // Global Variables
 //
-extern UINT32                                       g_DisassemblerSyntax;
-extern std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION> g_DisassemblerSymbolMap;
-extern BOOLEAN                                      g_AddressConversion;
+extern UINT32  g_DisassemblerSyntax;
+extern BOOLEAN g_AddressConversion;
 
 /**
  * @brief Defines the `ZydisSymbol` struct.
@@ -59,8 +58,424 @@ typedef struct ZydisSymbol_
     const char * name;
 } ZydisSymbol;
 
+/**
+ * @brief Maximum number of decoded instructions that are kept in the
+ * cache of decoded instructions
+ *
+ */
+#define DISASSEMBLER_DECODED_INSTRUCTIONS_CACHE_SIZE 0x400
+
+/**
+ * @brief A decoded instruction in the cache of decoded instructions
+ *
+ */
+typedef struct _DISASSEMBLER_DECODED_INSTRUCTION
+{
+    ZydisDecodedInstruction Instruction;
+    ZydisDecodedOperand     Operands[ZYDIS_MAX_OPERAND_COUNT];
+
+} DISASSEMBLER_DECODED_INSTRUCTION, *PDISASSEMBLER_DECODED_INSTRUCTION;
+
+/**
+ * @brief Size of each section of the buffer that is disassembled to a file
+ * by a separate thread
+ *
+ */
+#define DISASSEMBLER_FILE_SECTION_SIZE 0x40000
+
+/**
+ * @brief Maximum number of threads that disassemble a buffer to a file
+ *
+ */
+#define DISASSEMBLER_FILE_MAXIMUM_THREADS 0x20
+
+/**
+ * @brief A section of the buffer that is disassembled to a file
+ * @details the thread starts decoding from the start of the section and
+ * the decoding might go a few bytes beyond the limit of the section (the
+ * last instruction)
+ *
+ */
+typedef struct _DISASSEMBLER_FILE_SECTION
+{
+    ZydisDecoder *         Decoder;
+    const ZydisFormatter * Formatter;
+    unsigned char *        Buffer;      // The whole buffer
+    UINT64                 BaseAddress; // Address of the whole buffer
+    UINT64                 Size;        // Size of the whole buffer
+    UINT64                 Start;       // Offset of the start of the section
+    UINT64                 Limit;       // Offset of the end of the section
+    UINT64                 End;         // Offset after the last decoded instruction
+    std::vector<UINT64>    Offsets;     // Offset of each decoded instruction
+    std::vector<size_t>    TextOffsets; // Offset of the text of each decoded instruction
+    std::string            Text;
+
+} DISASSEMBLER_FILE_SECTION, *PDISASSEMBLER_FILE_SECTION;
+
 ZydisFormatterFunc default_print_address_absolute;
 
+//
+// The decoded instructions are keyed by the machine mode and the bytes of
+// the instruction, so querying the same instruction again (e.g., showing,
+// stepping, and checking for calls on the same stop) doesn't decode it again
+//
+static std::map<std::string, DISASSEMBLER_DECODED_INSTRUCTION> DisassemblerDecodedInstructionsCache;
+
+/**
+ * @brief Decode the first instruction of a buffer
+ * @details the decoded instruction is served from the cache of decoded
+ * instructions if the same bytes are decoded before
+ *
+ * @param BufferToDisassemble Bytes of assembly
+ * @param BuffLength Length of buffer
+ * @param Isx86_64 Whether it's an x86 or x64
+ *
+ * @return PDISASSEMBLER_DECODED_INSTRUCTION returns NULL if the instruction
+ * is not valid
+ */
+static PDISASSEMBLER_DECODED_INSTRUCTION
+DisassemblerDecodeInstruction(unsigned char * BufferToDisassemble,
+                              UINT64          BuffLength,
+                              BOOLEAN         Isx86_64)
+{
+    ZydisDecoder                     Decoder;
+    DISASSEMBLER_DECODED_INSTRUCTION Decoded;
+    UINT64                           KeyLength = min(BuffLength, (UINT64)ZYDIS_MAX_INSTRUCTION_LENGTH);
+    std::string                      Key;
+
+    //
+    // The instruction is not longer than ZYDIS_MAX_INSTRUCTION_LENGTH, so
+    // the bytes after it don't change the result of decoding
+    //
+    Key.reserve((SIZE_T)KeyLength + 1);
+    Key.push_back(Isx86_64 ? '\x40' : '\x20');
+    Key.append((const char *)BufferToDisassemble, (SIZE_T)KeyLength);
+
+    auto Entry = DisassemblerDecodedInstructionsCache.find(Key);
+
+    if (Entry != DisassemblerDecodedInstructionsCache.end())
+    {
+        return &Entry->second;
+    }
+
+    if (Isx86_64)
+    {
+        ZydisDecoderInit(&Decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
+    }
+    else
+    {
+        ZydisDecoderInit(&Decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
+    }
+
+    if (!ZYAN_SUCCESS(ZydisDecoderDecodeFull(&Decoder, BufferToDisassemble, BuffLength, &Decoded.Instruction, Decoded.Operands)))
+    {
+        return NULL;
+    }
+
+    //
+    // Keep the size of the cache bounded
+    //
+    if (DisassemblerDecodedInstructionsCache.size() >= DISASSEMBLER_DECODED_INSTRUCTIONS_CACHE_SIZE)
+    {
+        DisassemblerDecodedInstructionsCache.clear();
+    }
+
+    return &DisassemblerDecodedInstructionsCache.emplace(Key, Decoded).first->second;
+}
+
+/**
+ * @brief Check whether the jump is taken or not taken based on the mnemonic
+ * of the decoded instruction
+ * @details the implementation of this function derived from the
+ * table in this site : http://www.unixwiz.net/techtips/x86-jumps.html
+ *
+ * @param Mnemonic The mnemonic of the instruction
+ * @param Rflags The kernel's current RFLAG
+ *
+ * @return DEBUGGER_CONDITIONAL_JUMP_STATUS
+ */
+static DEBUGGER_CONDITIONAL_JUMP_STATUS
+DisassemblerIsConditionalJumpTakenBasedOnMnemonic(ZydisMnemonic Mnemonic, RFLAGS Rflags)
+{
+    switch (Mnemonic)
+    {
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JO:
+
+        //
+        // Jump if overflow (jo)
+        //
+        if (Rflags.OverflowFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNO:
+
+        //
+        // Jump if not overflow (jno)
+        //
+        if (!Rflags.OverflowFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JS:
+
+        //
+        // Jump if sign
+        //
+        if (Rflags.SignFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNS:
+
+        //
+        // Jump if not sign
+        //
+        if (!Rflags.SignFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JZ:
+
+        //
+        // Jump if equal (je),
+        // Jump if zero (jz)
+        //
+        if (Rflags.ZeroFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNZ:
+
+        //
+        // Jump if not equal (jne),
+        // Jump if not zero (jnz)
+        //
+        if (!Rflags.ZeroFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JB:
+
+        //
+        // Jump if below (jb),
+        // Jump if not above or equal (jnae),
+        // Jump if carry (jc)
+        //
+
+        //
+        // This jump is unsigned
+        //
+
+        if (Rflags.CarryFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNB:
+
+        //
+        // Jump if not below (jnb),
+        // Jump if above or equal (jae),
+        // Jump if not carry (jnc)
+        //
+
+        //
+        // This jump is unsigned
+        //
+
+        if (!Rflags.CarryFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JBE:
+
+        //
+        // Jump if below or equal (jbe),
+        // Jump if not above (jna)
+        //
+
+        //
+        // This jump is unsigned
+        //
+
+        if (Rflags.CarryFlag || Rflags.ZeroFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNBE:
+
+        //
+        // Jump if above (ja),
+        // Jump if not below or equal (jnbe)
+        //
+
+        //
+        // This jump is unsigned
+        //
+
+        if (!Rflags.CarryFlag && !Rflags.ZeroFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JL:
+
+        //
+        // Jump if less (jl),
+        // Jump if not greater or equal (jnge)
+        //
+
+        //
+        // This jump is signed
+        //
+
+        if (Rflags.SignFlag != Rflags.OverflowFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNL:
+
+        //
+        // Jump if greater or equal (jge),
+        // Jump if not less (jnl)
+        //
+
+        //
+        // This jump is signed
+        //
+
+        if (Rflags.SignFlag == Rflags.OverflowFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JLE:
+
+        //
+        // Jump if less or equal (jle),
+        // Jump if not greater (jng)
+        //
+
+        //
+        // This jump is signed
+        //
+
+        if (Rflags.ZeroFlag || Rflags.SignFlag != Rflags.OverflowFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNLE:
+
+        //
+        // Jump if greater (jg),
+        // Jump if not less or equal (jnle)
+        //
+
+        //
+        // This jump is signed
+        //
+
+        if (!Rflags.ZeroFlag && Rflags.SignFlag == Rflags.OverflowFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JP:
+
+        //
+        // Jump if parity (jp),
+        // Jump if parity even (jpe)
+        //
+
+        if (Rflags.ParityFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JNP:
+
+        //
+        // Jump if not parity (jnp),
+        // Jump if parity odd (jpo)
+        //
+
+        if (!Rflags.ParityFlag)
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
+        else
+            return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+
+        break;
+
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JCXZ:
+    case ZydisMnemonic::ZYDIS_MNEMONIC_JECXZ:
+
+        //
+        // Jump if %CX register is 0 (jcxz),
+        // Jump if% ECX register is 0 (jecxz)
+        //
+
+        //
+        // Actually this instruction are rarely used
+        // but if we want to support these instructions then we
+        // should read ecx and cx each time in the debuggee,
+        // so it's better to just ignore it as a non-conditional
+        // jump
+        //
+        return DEBUGGER_CONDITIONAL_JUMP_STATUS_NOT_CONDITIONAL_JUMP;
+
+    default:
+
+        //
+        // It's not a jump
+        //
+        return DEBUGGER_CONDITIONAL_JUMP_STATUS_NOT_CONDITIONAL_JUMP;
+        break;
+    }
+
+    return DEBUGGER_CONDITIONAL_JUMP_STATUS_ERROR;
+}
+
 /**
  * @brief Print addresses
  *
@@ -74,8 +489,8 @@ ZydisFormatterPrintAddressAbsolute(const ZydisFormatter *  formatter,
                                    ZydisFormatterBuffer *  buffer,
                                    ZydisFormatterContext * context)
 {
-    ZyanU64                                                address;
-    std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION>::iterator Iterate;
+    ZyanU64                     address;
+    PLOCAL_FUNCTION_DESCRIPTION FunctionDescription;
 
     ZYAN_CHECK(ZydisCalcAbsoluteAddress(context->instruction, context->operand, context->runtime_address, &address));
 
@@ -87,23 +502,66 @@ ZydisFormatterPrintAddressAbsolute(const ZydisFormatter *  formatter,
         //
         // Check to find the symbol of address
         //
-        Iterate = g_DisassemblerSymbolMap.find(address);
+        FunctionDescription = SymbolFindDisassemblerSymbol(address);
 
-        if (Iterate != g_DisassemblerSymbolMap.end())
+        if (FunctionDescription != NULL)
         {
             ZYAN_CHECK(ZydisFormatterBufferAppend(buffer, ZYDIS_TOKEN_SYMBOL));
             ZyanString * string;
             ZYAN_CHECK(ZydisFormatterBufferGetString(buffer, &string));
             return ZyanStringAppendFormat(string,
                                           "<%s (%s)>",
-                                          Iterate->second.ObjectName.c_str(),
-                                          SeparateTo64BitValue(Iterate->first).c_str());
+                                          SymbolGetDisassemblerSymbolName(FunctionDescription),
+                                          SeparateTo64BitValue(FunctionDescription->Address).c_str());
         }
     }
 
     return default_print_address_absolute(formatter, buffer, context);
 }
 
+/**
+ * @brief Initialize a formatter based on the syntax of the settings
+ * @details the absolute addresses are resolved to the symbols
+ *
+ * @param Formatter
+ *
+ * @return BOOLEAN Whether the syntax is valid or not
+ */
+static BOOLEAN
+DisassemblerInitFormatter(ZydisFormatter * Formatter)
+{
+    if (g_DisassemblerSyntax == 1)
+    {
+        ZydisFormatterInit(Formatter, ZYDIS_FORMATTER_STYLE_INTEL);
+    }
+    else if (g_DisassemblerSyntax == 2)
+    {
+        ZydisFormatterInit(Formatter, ZYDIS_FORMATTER_STYLE_ATT);
+    }
+    else if (g_DisassemblerSyntax == 3)
+    {
+        ZydisFormatterInit(Formatter, ZYDIS_FORMATTER_STYLE_INTEL_MASM);
+    }
+    else
+    {
+        ShowMessages("err, in selecting disassembler syntax\n");
+        return FALSE;
+    }
+
+    ZydisFormatterSetProperty(Formatter, ZYDIS_FORMATTER_PROP_FORCE_SEGMENT, ZYAN_TRUE);
+    ZydisFormatterSetProperty(Formatter, ZYDIS_FORMATTER_PROP_FORCE_SIZE, ZYAN_TRUE);
+
+    //
+    // Replace the `ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS` function that formats
+    // the absolute addresses
+    //
+    default_print_address_absolute =
+        (ZydisFormatterFunc)&ZydisFormatterPrintAddressAbsolute;
+    ZydisFormatterSetHook(Formatter, ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS, (const void **)&default_print_address_absolute);
+
+    return TRUE;
+}
+
 /**
  * @brief Disassemble a user-mode buffer
  *
@@ -130,35 +588,11 @@ DisassembleBuffer(ZydisDecoder * decoder,
     int            instr_decoded   = 0;
     UINT64         UsedBaseAddress = NULL;
 
-    if (g_DisassemblerSyntax == 1)
-    {
-        ZydisFormatterInit(&formatter, ZYDIS_FORMATTER_STYLE_INTEL);
-    }
-    else if (g_DisassemblerSyntax == 2)
+    if (!DisassemblerInitFormatter(&formatter))
     {
-        ZydisFormatterInit(&formatter, ZYDIS_FORMATTER_STYLE_ATT);
-    }
-    else if (g_DisassemblerSyntax == 3)
-    {
-        ZydisFormatterInit(&formatter, ZYDIS_FORMATTER_STYLE_INTEL_MASM);
-    }
-    else
-    {
-        ShowMessages("err, in selecting disassembler syntax\n");
         return;
     }
 
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SEGMENT, ZYAN_TRUE);
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SIZE, ZYAN_TRUE);
-
-    //
-    // Replace the `ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS` function that formats
-    // the absolute addresses
-    //
-    default_print_address_absolute =
-        (ZydisFormatterFunc)&ZydisFormatterPrintAddressAbsolute;
-    ZydisFormatterSetHook(&formatter, ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS, (const void **)&default_print_address_absolute);
-
     ZydisDecodedOperand     operands[ZYDIS_MAX_OPERAND_COUNT];
     ZydisDecodedInstruction instruction;
     char                    buffer[256];
@@ -216,15 +650,14 @@ DisassembleBuffer(ZydisDecoder * decoder,
         if (show_of_branch_is_taken)
         {
             //
-            // Get the result of conditional jump, we re-format the instruction
-            // here because the user might have changed the configuration of Zydis
-            // using the "settings" command so it's better to re-format with default
-            // configuration
+            // Get the result of conditional jump, it only depends on the mnemonic
+            // so the already decoded instruction is used (the configuration of the
+            // formatter that is changed by the "settings" command doesn't matter)
             //
             RFLAGS TempRflags = {0};
             TempRflags.AsUInt = rflags->AsUInt;
             DEBUGGER_CONDITIONAL_JUMP_STATUS ResultOfCondJmp =
-                HyperDbgIsConditionalJumpTaken(data, length, TempRflags, is_x86_64);
+                DisassemblerIsConditionalJumpTakenBasedOnMnemonic(instruction.mnemonic, TempRflags);
 
             if (ResultOfCondJmp == DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN)
             {
@@ -395,347 +828,349 @@ HyperDbgDisassembler32(unsigned char * BufferToDisassemble,
     return 0;
 }
 
-/**
- * @brief Check whether the jump is taken or not taken (in debugger)
- * @details the implementation of this function derived from the
- * table in this site : http://www.unixwiz.net/techtips/x86-jumps.html
- *
- * @param BufferToDisassemble Current Bytes of assembly
- * @param BuffLength Length of buffer
- * @param Rflags The kernel's current RFLAG
- * @param Isx86_64 Whether it's an x86 or x64
- *
- * @return DEBUGGER_NEXT_INSTRUCTION_FINDER_STATUS
- */
-DEBUGGER_CONDITIONAL_JUMP_STATUS
-HyperDbgIsConditionalJumpTaken(unsigned char * BufferToDisassemble,
-                               UINT64          BuffLength,
-                               RFLAGS          Rflags,
-                               BOOLEAN         Isx86_64)
-{
-    ZydisDecoder            decoder;
-    ZydisFormatter          formatter;
-    ZydisDecodedOperand     operands[ZYDIS_MAX_OPERAND_COUNT];
-    UINT64                  CurrentRip    = 0;
-    int                     instr_decoded = 0;
-    ZydisDecodedInstruction instruction;
-    char                    buffer[256];
-    UINT32                  MaximumInstrDecoded = 1;
-
-    if (ZydisGetVersion() != ZYDIS_VERSION)
-    {
-        ShowMessages("invalid Zydis version\n");
-        return DEBUGGER_CONDITIONAL_JUMP_STATUS_ERROR;
-    }
-
-    if (Isx86_64)
-    {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
-    }
-    else
-    {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
-    }
-
-    ZydisFormatterInit(&formatter, ZYDIS_FORMATTER_STYLE_INTEL);
-
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SEGMENT, ZYAN_TRUE);
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SIZE, ZYAN_TRUE);
-
-    //
-    // Replace the `ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS` function that
-    // formats the absolute addresses
-    //
-    default_print_address_absolute = (ZydisFormatterFunc)&ZydisFormatterPrintAddressAbsolute;
-    ZydisFormatterSetHook(&formatter, ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS, (const void **)&default_print_address_absolute);
-
-    while (ZYAN_SUCCESS(ZydisDecoderDecodeFull(&decoder, BufferToDisassemble, BuffLength, &instruction, operands)))
-    {
-        //
-        // We have to pass a `runtime_address` different to
-        // `ZYDIS_RUNTIME_ADDRESS_NONE` to enable printing of absolute addresses
-        //
-
-        // ZydisFormatterFormatInstruction(&formatter, &instruction, operands, instruction.operand_count_visible, &buffer[0], sizeof(buffer), (ZyanU64)CurrentRip, ZYAN_NULL);
-
-        switch (instruction.mnemonic)
-        {
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JO:
-
-            //
-            // Jump if overflow (jo)
-            //
-            if (Rflags.OverflowFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNO:
-
-            //
-            // Jump if not overflow (jno)
-            //
-            if (!Rflags.OverflowFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JS:
-
-            //
-            // Jump if sign
-            //
-            if (Rflags.SignFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNS:
-
-            //
-            // Jump if not sign
-            //
-            if (!Rflags.SignFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JZ:
-
-            //
-            // Jump if equal (je),
-            // Jump if zero (jz)
-            //
-            if (Rflags.ZeroFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNZ:
-
-            //
-            // Jump if not equal (jne),
-            // Jump if not zero (jnz)
-            //
-            if (!Rflags.ZeroFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JB:
-
-            //
-            // Jump if below (jb),
-            // Jump if not above or equal (jnae),
-            // Jump if carry (jc)
-            //
-
-            //
-            // This jump is unsigned
-            //
-
-            if (Rflags.CarryFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNB:
-
-            //
-            // Jump if not below (jnb),
-            // Jump if above or equal (jae),
-            // Jump if not carry (jnc)
-            //
+/**
+ * @brief Disassemble one instruction of a buffer to a text
+ * @details the format is the same as the format of DisassembleBuffer, the
+ * bytes that are not valid instructions are shown as data, the symbol names
+ * are only shown at the start of the objects, so the text of an instruction
+ * doesn't depend on the previous instructions
+ *
+ * @param Decoder
+ * @param Formatter
+ * @param Buffer The whole buffer
+ * @param Size Size of the whole buffer
+ * @param BaseAddress Address of the whole buffer
+ * @param Offset Offset of the instruction
+ * @param Text The text is appended here
+ *
+ * @return UINT32 Length of the instruction
+ */
+static UINT32
+DisassemblerFormatInstructionToText(ZydisDecoder *         Decoder,
+                                    const ZydisFormatter * Formatter,
+                                    unsigned char *        Buffer,
+                                    UINT64                 Size,
+                                    UINT64                 BaseAddress,
+                                    UINT64                 Offset,
+                                    std::string &          Text)
+{
+    ZydisDecodedInstruction     Instruction;
+    ZydisDecodedOperand         Operands[ZYDIS_MAX_OPERAND_COUNT];
+    PLOCAL_FUNCTION_DESCRIPTION FunctionDescription;
+    char                        Formatted[256];
+    char                        Temp[32];
+    UINT64                      Address = BaseAddress + Offset;
+    UINT32                      Length;
 
-            //
-            // This jump is unsigned
-            //
+    if (g_AddressConversion)
+    {
+        FunctionDescription = SymbolFindDisassemblerSymbol(Address);
 
-            if (!Rflags.CarryFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+        if (FunctionDescription != NULL)
+        {
+            Text.append(SymbolGetDisassemblerSymbolName(FunctionDescription));
+            Text.append(":\n");
+        }
+    }
 
-            break;
+    if (ZYAN_SUCCESS(ZydisDecoderDecodeFull(Decoder, &Buffer[Offset], Size - Offset, &Instruction, Operands)))
+    {
+        Length = Instruction.length;
 
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JBE:
+        ZydisFormatterFormatInstruction(Formatter, &Instruction, Operands, Instruction.operand_count_visible, &Formatted[0], sizeof(Formatted), Address, ZYAN_NULL);
+    }
+    else
+    {
+        //
+        // Continue decoding from the next byte
+        //
+        Length = 1;
 
-            //
-            // Jump if below or equal (jbe),
-            // Jump if not above (jna)
-            //
+        sprintf_s(Formatted, sizeof(Formatted), "db 0x%02x", Buffer[Offset]);
+    }
 
-            //
-            // This jump is unsigned
-            //
+    //
+    // Same as SeparateTo64BitValue
+    //
+    sprintf_s(Temp, sizeof(Temp), "%08llx`%08llx   ", Address >> 32, Address & 0xffffffff);
+    Text.append(Temp);
 
-            if (Rflags.CarryFlag || Rflags.ZeroFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+    for (UINT32 i = 0; i < Length; i++)
+    {
+        sprintf_s(Temp, sizeof(Temp), " %02X", Buffer[Offset + i]);
+        Text.append(Temp);
+    }
 
-            break;
+    if (Length < PaddingLength)
+    {
+        Text.append((PaddingLength - Length) * 3, ' ');
+    }
 
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNBE:
+    Text.push_back(' ');
+    Text.append(Formatted);
+    Text.push_back('\n');
 
-            //
-            // Jump if above (ja),
-            // Jump if not below or equal (jnbe)
-            //
+    return Length;
+}
 
-            //
-            // This jump is unsigned
-            //
+/**
+ * @brief The thread that disassembles a section of the buffer
+ *
+ * @param Parameter The section (DISASSEMBLER_FILE_SECTION)
+ *
+ * @return DWORD
+ */
+DWORD WINAPI
+DisassemblerFileSectionThread(LPVOID Parameter)
+{
+    PDISASSEMBLER_FILE_SECTION Section = (PDISASSEMBLER_FILE_SECTION)Parameter;
+    UINT64                     Offset  = Section->Start;
 
-            if (!Rflags.CarryFlag && !Rflags.ZeroFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+    while (Offset < Section->Limit)
+    {
+        Section->Offsets.push_back(Offset);
+        Section->TextOffsets.push_back(Section->Text.size());
+
+        Offset += DisassemblerFormatInstructionToText(Section->Decoder,
+                                                      Section->Formatter,
+                                                      Section->Buffer,
+                                                      Section->Size,
+                                                      Section->BaseAddress,
+                                                      Offset,
+                                                      Section->Text);
+    }
 
-            break;
+    Section->End = Offset;
 
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JL:
+    return 0;
+}
 
-            //
-            // Jump if less (jl),
-            // Jump if not greater or equal (jnge)
-            //
+/**
+ * @brief Write the disassembled section to the file
+ * @details the section is decoded from its start but the previous section
+ * might end in the middle of its instructions, in this case, the instructions
+ * are decoded again from the end of the previous section until they reach
+ * an instruction of the section (x86 instructions synchronize after a few
+ * instructions), so the result is the same as decoding the whole buffer
+ * sequentially
+ *
+ * @param Section
+ * @param NextOffset Offset after the last written instruction
+ * @param Output
+ * @param CountOfInstructions Count of the written instructions
+ *
+ * @return VOID
+ */
+static VOID
+DisassemblerWriteFileSection(PDISASSEMBLER_FILE_SECTION Section,
+                             UINT64 *                   NextOffset,
+                             std::ofstream &            Output,
+                             UINT64 *                   CountOfInstructions)
+{
+    std::string Text;
+    auto        Index = std::lower_bound(Section->Offsets.begin(), Section->Offsets.end(), *NextOffset);
 
+    while (Index == Section->Offsets.end() || *Index != *NextOffset)
+    {
+        if (*NextOffset >= Section->End)
+        {
             //
-            // This jump is signed
+            // The whole section is covered by the previous section
             //
+            Output.write(Text.data(), Text.size());
+            return;
+        }
 
-            if (Rflags.SignFlag != Rflags.OverflowFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
-
-            break;
-
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNL:
+        *NextOffset += DisassemblerFormatInstructionToText(Section->Decoder,
+                                                           Section->Formatter,
+                                                           Section->Buffer,
+                                                           Section->Size,
+                                                           Section->BaseAddress,
+                                                           *NextOffset,
+                                                           Text);
+        (*CountOfInstructions)++;
 
-            //
-            // Jump if greater or equal (jge),
-            // Jump if not less (jnl)
-            //
+        Index = std::lower_bound(Index, Section->Offsets.end(), *NextOffset);
+    }
 
-            //
-            // This jump is signed
-            //
+    Output.write(Text.data(), Text.size());
 
-            if (Rflags.SignFlag == Rflags.OverflowFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+    Output.write(Section->Text.data() + Section->TextOffsets[Index - Section->Offsets.begin()],
+                 Section->Text.size() - Section->TextOffsets[Index - Section->Offsets.begin()]);
 
-            break;
+    *CountOfInstructions += Section->Offsets.end() - Index;
+    *NextOffset = Section->End;
+}
 
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JLE:
+/**
+ * @brief Disassemble a buffer to a file
+ * @details the sections of the buffer are disassembled by several threads
+ * and the result is written in the order of the sections, so the size of
+ * the buffer is not limited by the size of the disassembled text
+ *
+ * @param BufferToDisassemble buffer to disassemble
+ * @param BaseAddress the base address of assembly
+ * @param Size size of buffer
+ * @param Isx86_64 Whether it's an x86 or x64
+ * @param FilePath Path of the output file
+ * @param CountOfInstructions Count of the disassembled instructions
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+HyperDbgDisassembleToFile(unsigned char * BufferToDisassemble,
+                          UINT64          BaseAddress,
+                          UINT64          Size,
+                          BOOLEAN         Isx86_64,
+                          const string &  FilePath,
+                          UINT64 *        CountOfInstructions)
+{
+    ZydisDecoder                           Decoder;
+    ZydisFormatter                         Formatter;
+    SYSTEM_INFO                            SystemInfo;
+    std::ofstream                          Output;
+    std::vector<HANDLE>                    Threads;
+    std::vector<DISASSEMBLER_FILE_SECTION> Sections;
+    UINT32                                 CountOfThreads;
+    UINT32                                 CountOfStartedSections;
+    UINT64                                 Start      = 0;
+    UINT64                                 NextOffset = 0;
+
+    *CountOfInstructions = 0;
 
-            //
-            // Jump if less or equal (jle),
-            // Jump if not greater (jng)
-            //
+    if (ZydisGetVersion() != ZYDIS_VERSION)
+    {
+        fputs("Invalid Zydis version\n", ZYAN_STDERR);
+        return FALSE;
+    }
 
-            //
-            // This jump is signed
-            //
+    if (Isx86_64)
+    {
+        ZydisDecoderInit(&Decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
+    }
+    else
+    {
+        ZydisDecoderInit(&Decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
+        BaseAddress = (UINT32)BaseAddress;
+    }
 
-            if (Rflags.ZeroFlag || Rflags.SignFlag != Rflags.OverflowFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+    //
+    // The formatter is shared between the threads (it's not changed by
+    // formatting the instructions)
+    //
+    if (!DisassemblerInitFormatter(&Formatter))
+    {
+        return FALSE;
+    }
 
-            break;
+    Output.open(FilePath, std::ios::out | std::ios::binary | std::ios::trunc);
 
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNLE:
+    if (!Output.is_open())
+    {
+        ShowMessages("err, unable to open the output file\n");
+        return FALSE;
+    }
 
-            //
-            // Jump if greater (jg),
-            // Jump if not less or equal (jnle)
-            //
+    GetSystemInfo(&SystemInfo);
 
-            //
-            // This jump is signed
-            //
+    CountOfThreads = min(max(SystemInfo.dwNumberOfProcessors, 1), DISASSEMBLER_FILE_MAXIMUM_THREADS);
 
-            if (!Rflags.ZeroFlag && Rflags.SignFlag == Rflags.OverflowFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+    Threads.resize(CountOfThreads);
+    Sections.resize(CountOfThreads);
 
-            break;
+    for (auto & Section : Sections)
+    {
+        Section.Decoder     = &Decoder;
+        Section.Formatter   = &Formatter;
+        Section.Buffer      = BufferToDisassemble;
+        Section.BaseAddress = BaseAddress;
+        Section.Size        = Size;
+    }
 
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JP:
+    while (Start < Size)
+    {
+        //
+        // Each thread disassembles one section in each round, so the text of
+        // only a few sections is kept in the memory
+        //
+        for (CountOfStartedSections = 0; CountOfStartedSections < CountOfThreads && Start < Size; CountOfStartedSections++)
+        {
+            PDISASSEMBLER_FILE_SECTION Section = &Sections[CountOfStartedSections];
 
-            //
-            // Jump if parity (jp),
-            // Jump if parity even (jpe)
-            //
+            Section->Start = Start;
+            Section->Limit = min(Start + DISASSEMBLER_FILE_SECTION_SIZE, Size);
+            Section->Offsets.clear();
+            Section->TextOffsets.clear();
+            Section->Text.clear();
 
-            if (Rflags.ParityFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+            Start = Section->Limit;
 
-            break;
+            Threads[CountOfStartedSections] = CreateThread(NULL, 0, DisassemblerFileSectionThread, Section, 0, NULL);
 
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JNP:
+            if (Threads[CountOfStartedSections] == NULL)
+            {
+                //
+                // Disassemble the section on the current thread
+                //
+                DisassemblerFileSectionThread(Section);
+            }
+        }
 
-            //
-            // Jump if not parity (jnp),
-            // Jump if parity odd (jpo)
-            //
+        for (UINT32 i = 0; i < CountOfStartedSections; i++)
+        {
+            if (Threads[i] != NULL)
+            {
+                WaitForSingleObject(Threads[i], INFINITE);
+                CloseHandle(Threads[i]);
+            }
 
-            if (!Rflags.ParityFlag)
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_TAKEN;
-            else
-                return DEBUGGER_CONDITIONAL_JUMP_STATUS_JUMP_IS_NOT_TAKEN;
+            DisassemblerWriteFileSection(&Sections[i], &NextOffset, Output, CountOfInstructions);
+        }
+    }
 
-            break;
+    Output.close();
 
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JCXZ:
-        case ZydisMnemonic::ZYDIS_MNEMONIC_JECXZ:
+    if (Output.fail())
+    {
+        ShowMessages("err, unable to write the output file\n");
+        return FALSE;
+    }
 
-            //
-            // Jump if %CX register is 0 (jcxz),
-            // Jump if% ECX register is 0 (jecxz)
-            //
+    return TRUE;
+}
 
-            //
-            // Actually this instruction are rarely used
-            // but if we want to support these instructions then we
-            // should read ecx and cx each time in the debuggee,
-            // so it's better to just ignore it as a non-conditional
-            // jump
-            //
-            return DEBUGGER_CONDITIONAL_JUMP_STATUS_NOT_CONDITIONAL_JUMP;
+/**
+ * @brief Check whether the jump is taken or not taken (in debugger)
+ *
+ * @param BufferToDisassemble Current Bytes of assembly
+ * @param BuffLength Length of buffer
+ * @param Rflags The kernel's current RFLAG
+ * @param Isx86_64 Whether it's an x86 or x64
+ *
+ * @return DEBUGGER_NEXT_INSTRUCTION_FINDER_STATUS
+ */
+DEBUGGER_CONDITIONAL_JUMP_STATUS
+HyperDbgIsConditionalJumpTaken(unsigned char * BufferToDisassemble,
+                               UINT64          BuffLength,
+                               RFLAGS          Rflags,
+                               BOOLEAN         Isx86_64)
+{
+    PDISASSEMBLER_DECODED_INSTRUCTION Decoded;
 
-        default:
+    if (ZydisGetVersion() != ZYDIS_VERSION)
+    {
+        ShowMessages("invalid Zydis version\n");
+        return DEBUGGER_CONDITIONAL_JUMP_STATUS_ERROR;
+    }
 
-            //
-            // It's not a jump
-            //
-            return DEBUGGER_CONDITIONAL_JUMP_STATUS_NOT_CONDITIONAL_JUMP;
-            break;
-        }
+    Decoded = DisassemblerDecodeInstruction(BufferToDisassemble, BuffLength, Isx86_64);
 
+    if (Decoded == NULL)
+    {
         return DEBUGGER_CONDITIONAL_JUMP_STATUS_ERROR;
     }
+
+    return DisassemblerIsConditionalJumpTakenBasedOnMnemonic(Decoded->Instruction.mnemonic, Rflags);
 }
 
 /**
@@ -755,14 +1190,7 @@ HyperDbgCheckWhetherTheCurrentInstructionIsCall(
     BOOLEAN         Isx86_64,
     PUINT32         CallLength)
 {
-    ZydisDecoder            decoder;
-    ZydisFormatter          formatter;
-    ZydisDecodedOperand     operands[ZYDIS_MAX_OPERAND_COUNT];
-    UINT64                  CurrentRip    = 0;
-    int                     instr_decoded = 0;
-    ZydisDecodedInstruction instruction;
-    char                    buffer[256];
-    UINT32                  MaximumInstrDecoded = 1;
+    PDISASSEMBLER_DECODED_INSTRUCTION Decoded;
 
     //
     // Default length
@@ -775,62 +1203,37 @@ HyperDbgCheckWhetherTheCurrentInstructionIsCall(
         return DEBUGGER_CONDITIONAL_JUMP_STATUS_ERROR;
     }
 
-    if (Isx86_64)
-    {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
-    }
-    else
+    Decoded = DisassemblerDecodeInstruction(BufferToDisassemble, BuffLength, Isx86_64);
+
+    if (Decoded == NULL)
     {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
+        return FALSE;
     }
 
-    ZydisFormatterInit(&formatter, ZYDIS_FORMATTER_STYLE_INTEL);
-
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SEGMENT, ZYAN_TRUE);
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SIZE, ZYAN_TRUE);
-
-    //
-    // Replace the `ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS` function that
-    // formats the absolute addresses
-    //
-    default_print_address_absolute =
-        (ZydisFormatterFunc)&ZydisFormatterPrintAddressAbsolute;
-    ZydisFormatterSetHook(&formatter, ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS, (const void **)&default_print_address_absolute);
-
-    while (ZYAN_SUCCESS(ZydisDecoderDecodeFull(&decoder, BufferToDisassemble, BuffLength, &instruction, operands)))
+    if (Decoded->Instruction.mnemonic == ZydisMnemonic::ZYDIS_MNEMONIC_CALL)
     {
         //
-        // We have to pass a `runtime_address` different to
-        // `ZYDIS_RUNTIME_ADDRESS_NONE` to enable printing of absolute addresses
+        // It's a call
         //
 
-        ZydisFormatterFormatInstruction(&formatter, &instruction, operands, instruction.operand_count_visible, &buffer[0], sizeof(buffer), (ZyanU64)CurrentRip, ZYAN_NULL);
-
-        if (instruction.mnemonic == ZydisMnemonic::ZYDIS_MNEMONIC_CALL)
-        {
-            //
-            // It's a call
-            //
-
-            //
-            // Log call
-            //
-            // ShowMessages("call length : 0x%x\n", instruction.length);
+        //
+        // Log call
+        //
+        // ShowMessages("call length : 0x%x\n", Decoded->Instruction.length);
 
-            //
-            // Set the length
-            //
-            *CallLength = instruction.length;
+        //
+        // Set the length
+        //
+        *CallLength = Decoded->Instruction.length;
 
-            return TRUE;
-        }
-        else
-        {
-            //
-            // It's not call
-            //
-            return FALSE;
-        }
+        return TRUE;
+    }
+    else
+    {
+        //
+        // It's not call
+        //
+        return FALSE;
     }
 }
 
@@ -850,14 +1253,7 @@ HyperDbgLengthDisassemblerEngine(
     UINT64          BuffLength,
     BOOLEAN         Isx86_64)
 {
-    ZydisDecoder            decoder;
-    ZydisFormatter          formatter;
-    ZydisDecodedOperand     operands[ZYDIS_MAX_OPERAND_COUNT];
-    UINT64                  CurrentRip    = 0;
-    int                     instr_decoded = 0;
-    ZydisDecodedInstruction instruction;
-    char                    buffer[256];
-    UINT32                  MaximumInstrDecoded = 1;
+    PDISASSEMBLER_DECODED_INSTRUCTION Decoded;
 
     if (ZydisGetVersion() != ZYDIS_VERSION)
     {
@@ -865,46 +1261,20 @@ HyperDbgLengthDisassemblerEngine(
         return DEBUGGER_CONDITIONAL_JUMP_STATUS_ERROR;
     }
 
-    if (Isx86_64)
-    {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
-    }
-    else
-    {
-        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
-    }
-
-    ZydisFormatterInit(&formatter, ZYDIS_FORMATTER_STYLE_INTEL);
-
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SEGMENT, ZYAN_TRUE);
-    ZydisFormatterSetProperty(&formatter, ZYDIS_FORMATTER_PROP_FORCE_SIZE, ZYAN_TRUE);
-
-    //
-    // Replace the `ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS` function that
-    // formats the absolute addresses
-    //
-    default_print_address_absolute =
-        (ZydisFormatterFunc)&ZydisFormatterPrintAddressAbsolute;
-    ZydisFormatterSetHook(&formatter, ZYDIS_FORMATTER_FUNC_PRINT_ADDRESS_ABS, (const void **)&default_print_address_absolute);
+    Decoded = DisassemblerDecodeInstruction(BufferToDisassemble, BuffLength, Isx86_64);
 
-    while (ZYAN_SUCCESS(ZydisDecoderDecodeFull(&decoder, BufferToDisassemble, BuffLength, &instruction, operands)))
+    if (Decoded == NULL)
     {
         //
-        // We have to pass a `runtime_address` different to
-        // `ZYDIS_RUNTIME_ADDRESS_NONE` to enable printing of absolute addresses
-        //
-        // ZydisFormatterFormatInstruction(&formatter, &instruction, operands, instruction.operand_count_visible, &buffer[0], sizeof(buffer), (ZyanU64)CurrentRip, ZYAN_NULL);
-
-        //
-        // Return len of buffer
+        // Error in disassembling buffer
         //
-        return instruction.length;
+        return 0;
     }
 
     //
-    // Error in disassembling buffer
+    // Return len of buffer
     //
-    return 0;
+    return Decoded->Instruction.length;
 }
 
 /**
@@ -920,8 +1290,8 @@ ZydisFormatterPrintAddressAbsoluteForTrackingInstructions(const ZydisFormatter *
                                                           ZydisFormatterBuffer *  buffer,
                                                           ZydisFormatterContext * context)
 {
-    ZyanU64                                                address;
-    std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION>::iterator Iterate;
+    ZyanU64                     address;
+    PLOCAL_FUNCTION_DESCRIPTION FunctionDescription;
 
     ZYAN_CHECK(ZydisCalcAbsoluteAddress(context->instruction, context->operand, context->runtime_address, &address));
 
@@ -933,9 +1303,9 @@ ZydisFormatterPrintAddressAbsoluteForTrackingInstructions(const ZydisFormatter *
         //
         // Check to find the symbol of address
         //
-        Iterate = g_DisassemblerSymbolMap.find(address);
+        FunctionDescription = SymbolFindDisassemblerSymbol(address);
 
-        if (Iterate != g_DisassemblerSymbolMap.end())
+        if (FunctionDescription != NULL)
         {
             ZYAN_CHECK(ZydisFormatterBufferAppend(buffer, ZYDIS_TOKEN_SYMBOL));
             ZyanString * string;
@@ -944,12 +1314,12 @@ ZydisFormatterPrintAddressAbsoluteForTrackingInstructions(const ZydisFormatter *
             //
             // Call the tracker callback (with function name)
             //
-            CommandTrackHandleReceivedCallInstructions(Iterate->second.ObjectName.c_str(), Iterate->first);
+            CommandTrackHandleReceivedCallInstructions(SymbolGetDisassemblerSymbolName(FunctionDescription), FunctionDescription->Address);
 
             return ZyanStringAppendFormat(string,
                                           "<%s (%s)>",
-                                          Iterate->second.ObjectName.c_str(),
-                                          SeparateTo64BitValue(Iterate->first).c_str());
+                                          SymbolGetDisassemblerSymbolName(FunctionDescription),
+                                          SeparateTo64BitValue(FunctionDescription->Address).c_str());
         }
     }
 
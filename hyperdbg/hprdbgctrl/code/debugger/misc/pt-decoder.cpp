@@ -0,0 +1,955 @@
+/**
+ * @file pt-decoder.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Decoding the trace of Intel PT (Processor Trace)
+ * @details the packets only contain the outcomes of the branches, so the
+ * control flow is reconstructed by walking the instructions (decoded by
+ * Zydis) from the synchronization points and following the packets at
+ * each branch, the 'call' and 'ret' instructions are passed to the
+ * handlers of the '!track' command to create the call tree
+ * @version 0.4
+ * @date 2023-08-05
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+#include "Zydis/Zydis.h"
+
+//
+// Global Variables
+//
+extern HANDLE  g_DeviceHandle;
+extern BOOLEAN g_IsInstrumentingInstructions;
+extern BOOLEAN g_AddressConversion;
+
+/**
+ * @brief Find the next PSB (synchronization) packet
+ *
+ * @param Decoder
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PtDecoderSyncForward(PPT_DECODER Decoder)
+{
+    static const UINT8 Psb[PT_DECODER_PSB_SIZE] = {0x02, 0x82, 0x02, 0x82, 0x02, 0x82, 0x02, 0x82, 0x02, 0x82, 0x02, 0x82, 0x02, 0x82, 0x02, 0x82};
+
+    for (UINT64 i = Decoder->Offset; i + PT_DECODER_PSB_SIZE <= Decoder->TraceSize; i++)
+    {
+        if (!memcmp(&Decoder->Trace[i], Psb, PT_DECODER_PSB_SIZE))
+        {
+            Decoder->Offset = i;
+            return TRUE;
+        }
+    }
+
+    Decoder->Offset = Decoder->TraceSize;
+
+    return FALSE;
+}
+
+/**
+ * @brief Queue the bits of a TNT packet
+ * @details the highest set bit of the payload is the stop bit and the
+ * bits below it are the branches (the oldest is the highest bit)
+ *
+ * @param Decoder
+ * @param Payload
+ *
+ * @return VOID
+ */
+static VOID
+PtDecoderQueueTnt(PPT_DECODER Decoder, UINT64 Payload)
+{
+    ULONG StopBit;
+
+    if (!_BitScanReverse64(&StopBit, Payload))
+    {
+        return;
+    }
+
+    Decoder->TntBits        = Payload & ((1ull << StopBit) - 1);
+    Decoder->CountOfTntBits = StopBit;
+}
+
+/**
+ * @brief Read the (compressed) IP of a TIP, TIP.PGE, TIP.PGD or FUP packet
+ *
+ * @param Decoder
+ * @param Header The header of the packet
+ * @param Event The event to save the IP
+ * @param Length The length of the packet
+ *
+ * @return BOOLEAN Whether the packet is valid or not
+ */
+static BOOLEAN
+PtDecoderReadIp(PPT_DECODER Decoder, UINT8 Header, PPT_DECODER_EVENT Event, PUINT32 Length)
+{
+    UINT32 IpBytes;
+    UINT64 Value = 0;
+
+    switch (Header >> 5)
+    {
+    case 0:
+        IpBytes = 0;
+        break;
+    case 1:
+        IpBytes = 2;
+        break;
+    case 2:
+        IpBytes = 4;
+        break;
+    case 3:
+    case 4:
+        IpBytes = 6;
+        break;
+    case 6:
+        IpBytes = 8;
+        break;
+    default:
+        return FALSE;
+    }
+
+    *Length = 1 + IpBytes;
+
+    if (Decoder->Offset + *Length > Decoder->TraceSize)
+    {
+        return FALSE;
+    }
+
+    memcpy(&Value, &Decoder->Trace[Decoder->Offset + 1], IpBytes);
+
+    switch (Header >> 5)
+    {
+    case 0:
+        //
+        // The IP is suppressed
+        //
+        Event->HasIp = FALSE;
+        return TRUE;
+
+    case 1:
+        Value = (Decoder->LastIp & ~0xffffull) | Value;
+        break;
+
+    case 2:
+        Value = (Decoder->LastIp & ~0xffffffffull) | Value;
+        break;
+
+    case 3:
+        //
+        // Sign-extended from bit 47
+        //
+        Value = (UINT64)(((INT64)(Value << 16)) >> 16);
+        break;
+
+    case 4:
+        Value = (Decoder->LastIp & ~0xffffffffffffull) | Value;
+        break;
+
+    default:
+        break;
+    }
+
+    Event->HasIp    = TRUE;
+    Event->Ip       = Value;
+    Decoder->LastIp = Value;
+
+    return TRUE;
+}
+
+/**
+ * @brief Parse the packets until the next event of the control flow
+ * @details the packets of timing, power and the other packets that don't
+ * change the control flow are skipped, the decoder is synchronized with
+ * the next PSB once an invalid packet is found
+ *
+ * @param Decoder
+ * @param Event
+ *
+ * @return BOOLEAN FALSE if there is no more events
+ */
+static BOOLEAN
+PtDecoderParseNextEvent(PPT_DECODER Decoder, PPT_DECODER_EVENT Event)
+{
+    while (TRUE)
+    {
+        UINT32 Length = 0;
+        UINT64 Payload;
+        UINT8  Header;
+
+        RtlZeroMemory(Event, sizeof(PT_DECODER_EVENT));
+
+        if (Decoder->CountOfTntBits != 0)
+        {
+            Decoder->CountOfTntBits--;
+
+            Event->Type  = PT_DECODER_EVENT_TNT;
+            Event->Taken = (Decoder->TntBits >> Decoder->CountOfTntBits) & 1;
+
+            return TRUE;
+        }
+
+        if (Decoder->Offset >= Decoder->TraceSize)
+        {
+            return FALSE;
+        }
+
+        Header = Decoder->Trace[Decoder->Offset];
+
+        if (Header == 0x00)
+        {
+            //
+            // PAD
+            //
+            Decoder->Offset++;
+            continue;
+        }
+        else if (Header == 0x02)
+        {
+            if (Decoder->Offset + 2 > Decoder->TraceSize)
+            {
+                return FALSE;
+            }
+
+            switch (Decoder->Trace[Decoder->Offset + 1])
+            {
+            case 0x82:
+                //
+                // PSB, the compressed IPs are not based on the previous IPs
+                //
+                Length          = PT_DECODER_PSB_SIZE;
+                Decoder->LastIp = 0;
+                Decoder->InPsb  = TRUE;
+                break;
+
+            case 0x23:
+                //
+                // PSBEND
+                //
+                Length         = 2;
+                Decoder->InPsb = FALSE;
+                break;
+
+            case 0xa3:
+                //
+                // Long TNT
+                //
+                Length = 8;
+
+                if (Decoder->Offset + Length > Decoder->TraceSize)
+                {
+                    return FALSE;
+                }
+
+                Payload = 0;
+                memcpy(&Payload, &Decoder->Trace[Decoder->Offset + 2], 6);
+
+                PtDecoderQueueTnt(Decoder, Payload);
+                break;
+
+            case 0xf3:
+                //
+                // OVF, the next FUP is the current IP
+                //
+                Decoder->Offset += 2;
+                Decoder->AfterOverflow = TRUE;
+
+                Event->Type = PT_DECODER_EVENT_OVF;
+                return TRUE;
+
+            case 0x83: // TraceStop
+            case 0x62: // EXSTOP
+            case 0xe2: // EXSTOP (IP)
+            case 0x33: // BEP
+            case 0xb3: // BEP (IP)
+                Length = 2;
+                break;
+
+            case 0x63: // BBP
+                Length = 3;
+                break;
+
+            case 0x03: // CBR
+            case 0x22: // PWRE
+            case 0x13: // CFE
+                Length = 4;
+                break;
+
+            case 0x73: // TMA
+            case 0xc8: // VMCS
+            case 0xa2: // PWRX
+                Length = 7;
+                break;
+
+            case 0x43: // PIP
+                Length = 8;
+                break;
+
+            case 0xc2: // MWAIT
+                Length = 10;
+                break;
+
+            case 0xc3: // MNT
+            case 0x53: // EVD
+                Length = 11;
+                break;
+
+            default:
+
+                if ((Decoder->Trace[Decoder->Offset + 1] & 0x1f) == 0x12)
+                {
+                    //
+                    // PTW (4 or 8 bytes of payload)
+                    //
+                    Length = ((Decoder->Trace[Decoder->Offset + 1] >> 5) & 0x3) == 0 ? 2 + 4 : 2 + 8;
+                }
+
+                break;
+            }
+        }
+        else if ((Header & 0x1) == 0)
+        {
+            //
+            // Short TNT
+            //
+            Length = 1;
+            PtDecoderQueueTnt(Decoder, Header >> 1);
+        }
+        else if ((Header & 0x3) == 0x3)
+        {
+            //
+            // CYC, the extended bytes of the payload have their lowest bit set
+            //
+            Decoder->Offset++;
+
+            if (Header & 0x4)
+            {
+                while (Decoder->Offset < Decoder->TraceSize && (Decoder->Trace[Decoder->Offset++] & 0x1))
+                {
+                }
+            }
+
+            continue;
+        }
+        else if (Header == 0x19)
+        {
+            //
+            // TSC
+            //
+            Length = 8;
+        }
+        else if (Header == 0x59)
+        {
+            //
+            // MTC
+            //
+            Length = 2;
+        }
+        else if (Header == 0x99)
+        {
+            //
+            // MODE, the MODE.Exec applies to the next IP
+            //
+            Length = 2;
+
+            if (Decoder->Offset + Length <= Decoder->TraceSize && (Decoder->Trace[Decoder->Offset + 1] >> 5) == 0)
+            {
+                Payload = Decoder->Trace[Decoder->Offset + 1];
+
+                Decoder->HasPendingMode     = TRUE;
+                Decoder->PendingModeIs32Bit = !(Payload & 0x1) && (Payload & 0x2); // !CS.L && CS.D
+            }
+        }
+        else if ((Header & 0x1f) == 0x01 || (Header & 0x1f) == 0x0d || (Header & 0x1f) == 0x11 || (Header & 0x1f) == 0x1d)
+        {
+            //
+            // TIP.PGD, TIP, TIP.PGE or FUP
+            //
+            if (!PtDecoderReadIp(Decoder, Header, Event, &Length))
+            {
+                Decoder->Statistics.CountOfDesyncs++;
+                Decoder->Offset++;
+                PtDecoderSyncForward(Decoder);
+                continue;
+            }
+
+            Decoder->Offset += Length;
+
+            switch (Header & 0x1f)
+            {
+            case 0x01:
+                Event->Type = PT_DECODER_EVENT_TIP_PGD;
+                break;
+            case 0x0d:
+                Event->Type = PT_DECODER_EVENT_TIP;
+                break;
+            case 0x11:
+                Event->Type = PT_DECODER_EVENT_TIP_PGE;
+                break;
+            default:
+                Event->Type = (Decoder->InPsb || Decoder->AfterOverflow) ? PT_DECODER_EVENT_SYNC : PT_DECODER_EVENT_FUP;
+                break;
+            }
+
+            if (Event->HasIp)
+            {
+                Event->HasMode = Decoder->HasPendingMode;
+                Event->Is32Bit = Decoder->PendingModeIs32Bit;
+
+                Decoder->HasPendingMode = FALSE;
+                Decoder->AfterOverflow  = FALSE;
+            }
+
+            return TRUE;
+        }
+
+        if (Length == 0 || Decoder->Offset + Length > Decoder->TraceSize)
+        {
+            //
+            // The packet is not valid (or it's truncated)
+            //
+            Decoder->Statistics.CountOfDesyncs++;
+            Decoder->Offset++;
+            PtDecoderSyncForward(Decoder);
+            continue;
+        }
+
+        Decoder->Offset += Length;
+    }
+}
+
+/**
+ * @brief Get the next event without removing it
+ *
+ * @param Decoder
+ * @param Event
+ *
+ * @return BOOLEAN FALSE if there is no more events
+ */
+static BOOLEAN
+PtDecoderPeekEvent(PPT_DECODER Decoder, PPT_DECODER_EVENT Event)
+{
+    if (!Decoder->HasPeekedEvent)
+    {
+        if (!PtDecoderParseNextEvent(Decoder, &Decoder->PeekedEvent))
+        {
+            return FALSE;
+        }
+
+        Decoder->HasPeekedEvent = TRUE;
+    }
+
+    *Event = Decoder->PeekedEvent;
+
+    return TRUE;
+}
+
+/**
+ * @brief Get and remove the next event
+ *
+ * @param Decoder
+ * @param Event
+ *
+ * @return BOOLEAN FALSE if there is no more events
+ */
+static BOOLEAN
+PtDecoderNextEvent(PPT_DECODER Decoder, PPT_DECODER_EVENT Event)
+{
+    if (!PtDecoderPeekEvent(Decoder, Event))
+    {
+        return FALSE;
+    }
+
+    Decoder->HasPeekedEvent = FALSE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Read the bytes of an instruction from the cached pages of the code
+ *
+ * @param Decoder
+ * @param Address
+ * @param Buffer The buffer to save the bytes (MAXIMUM_INSTR_SIZE bytes)
+ *
+ * @return UINT32 Count of the read bytes
+ */
+static UINT32
+PtDecoderReadInstruction(PPT_DECODER Decoder, UINT64 Address, UINT8 * Buffer)
+{
+    UINT32 ReadBytes = 0;
+
+    while (ReadBytes < MAXIMUM_INSTR_SIZE)
+    {
+        UINT64 CurrentAddress = Address + ReadBytes;
+        UINT64 PageAddress    = CurrentAddress & ~((UINT64)PAGE_SIZE - 1);
+        UINT64 PageOffset     = CurrentAddress - PageAddress;
+        UINT32 Count          = (UINT32)min(PAGE_SIZE - PageOffset, (UINT64)(MAXIMUM_INSTR_SIZE - ReadBytes));
+
+        auto Iterate = Decoder->Pages.find(PageAddress);
+
+        if (Iterate == Decoder->Pages.end())
+        {
+            DEBUGGER_READ_MEMORY ReadMem = {0};
+            std::vector<UINT8>   Page(PAGE_SIZE);
+            ULONG                ReturnedLength;
+            BOOL                 Status;
+
+            ReadMem.Address     = PageAddress;
+            ReadMem.Pid         = Decoder->Configuration.ProcessId;
+            ReadMem.Size        = PAGE_SIZE;
+            ReadMem.MemoryType  = DEBUGGER_READ_VIRTUAL_ADDRESS;
+            ReadMem.ReadingType = READ_FROM_KERNEL;
+
+            Status = DeviceIoControl(g_DeviceHandle,              // Handle to device
+                                     IOCTL_DEBUGGER_READ_MEMORY,  // IO Control code
+                                     &ReadMem,                    // Input Buffer to driver.
+                                     SIZEOF_DEBUGGER_READ_MEMORY, // Input buffer length
+                                     Page.data(),                 // Output Buffer from driver.
+                                     PAGE_SIZE,                   // Length of output buffer in bytes.
+                                     &ReturnedLength,             // Bytes placed in buffer.
+                                     NULL                         // synchronous call
+            );
+
+            if (!Status || ReturnedLength < PAGE_SIZE)
+            {
+                //
+                // The page is not readable, it's not read again
+                //
+                Page.clear();
+            }
+
+            Iterate = Decoder->Pages.emplace(PageAddress, std::move(Page)).first;
+        }
+
+        if (Iterate->second.empty())
+        {
+            break;
+        }
+
+        memcpy(&Buffer[ReadBytes], &Iterate->second[PageOffset], Count);
+        ReadBytes += Count;
+    }
+
+    return ReadBytes;
+}
+
+/**
+ * @brief Classify the instruction based on the packets that it needs
+ *
+ * @param Instruction
+ * @param Operands
+ * @param Ip The address of the instruction
+ * @param Target The target of the direct branches
+ *
+ * @return PT_DECODER_INSTRUCTION_CLASS
+ */
+static PT_DECODER_INSTRUCTION_CLASS
+PtDecoderClassifyInstruction(ZydisDecodedInstruction * Instruction, ZydisDecodedOperand * Operands, UINT64 Ip, PUINT64 Target)
+{
+    BOOLEAN IsRelative = Instruction->operand_count_visible != 0 &&
+                         Operands[0].type == ZYDIS_OPERAND_TYPE_IMMEDIATE &&
+                         Operands[0].imm.is_relative;
+
+    if (IsRelative && !ZYAN_SUCCESS(ZydisCalcAbsoluteAddress(Instruction, &Operands[0], Ip, (ZyanU64 *)Target)))
+    {
+        IsRelative = FALSE;
+    }
+
+    switch (Instruction->mnemonic)
+    {
+    case ZYDIS_MNEMONIC_SYSCALL:
+    case ZYDIS_MNEMONIC_SYSENTER:
+    case ZYDIS_MNEMONIC_SYSEXIT:
+    case ZYDIS_MNEMONIC_SYSRET:
+    case ZYDIS_MNEMONIC_INT:
+    case ZYDIS_MNEMONIC_INT1:
+    case ZYDIS_MNEMONIC_INT3:
+    case ZYDIS_MNEMONIC_INTO:
+    case ZYDIS_MNEMONIC_IRET:
+    case ZYDIS_MNEMONIC_IRETD:
+    case ZYDIS_MNEMONIC_IRETQ:
+
+        return PT_DECODER_INSTRUCTION_FAR_TRANSFER;
+
+    default:
+        break;
+    }
+
+    if (Instruction->meta.branch_type == ZYDIS_BRANCH_TYPE_FAR)
+    {
+        return PT_DECODER_INSTRUCTION_FAR_TRANSFER;
+    }
+
+    switch (Instruction->meta.category)
+    {
+    case ZYDIS_CATEGORY_COND_BR:
+
+        return IsRelative ? PT_DECODER_INSTRUCTION_COND_BRANCH : PT_DECODER_INSTRUCTION_OTHER;
+
+    case ZYDIS_CATEGORY_UNCOND_BR:
+
+        return IsRelative ? PT_DECODER_INSTRUCTION_DIRECT_JUMP : PT_DECODER_INSTRUCTION_INDIRECT_JUMP;
+
+    case ZYDIS_CATEGORY_CALL:
+
+        return IsRelative ? PT_DECODER_INSTRUCTION_DIRECT_CALL : PT_DECODER_INSTRUCTION_INDIRECT_CALL;
+
+    case ZYDIS_CATEGORY_RET:
+
+        return PT_DECODER_INSTRUCTION_RETURN;
+
+    default:
+
+        return PT_DECODER_INSTRUCTION_OTHER;
+    }
+}
+
+/**
+ * @brief Check whether the trace is enabled on the address or not
+ *
+ * @param Decoder
+ * @param Address
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PtDecoderIsAddressTraced(PPT_DECODER Decoder, UINT64 Address)
+{
+    BOOLEAN IsKernelAddress = (Address >> 63) != 0;
+
+    if (IsKernelAddress ? !Decoder->Configuration.TraceKernelMode : !Decoder->Configuration.TraceUserMode)
+    {
+        return FALSE;
+    }
+
+    if (Decoder->Configuration.CountOfAddressRanges == 0)
+    {
+        return TRUE;
+    }
+
+    for (UINT32 i = 0; i < Decoder->Configuration.CountOfAddressRanges; i++)
+    {
+        if (Address >= Decoder->Configuration.AddressRangesStart[i] && Address <= Decoder->Configuration.AddressRangesEnd[i])
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Pass a 'call' to the handler of the call tree
+ *
+ * @param Decoder
+ * @param Target The target of the call
+ *
+ * @return VOID
+ */
+static VOID
+PtDecoderReportCall(PPT_DECODER Decoder, UINT64 Target)
+{
+    PLOCAL_FUNCTION_DESCRIPTION FunctionDescription;
+
+    Decoder->Statistics.CountOfCalls++;
+
+    //
+    // Apply addressconversion of settings here
+    //
+    if (g_AddressConversion)
+    {
+        FunctionDescription = SymbolFindDisassemblerSymbol(Target);
+
+        if (FunctionDescription != NULL)
+        {
+            CommandTrackHandleReceivedCallInstructions(SymbolGetDisassemblerSymbolName(FunctionDescription), Target);
+            return;
+        }
+    }
+
+    CommandTrackHandleReceivedCallInstructions(NULL, Target);
+}
+
+/**
+ * @brief Pass a 'ret' to the handler of the call tree
+ *
+ * @param Decoder
+ * @param Ip The address of the 'ret' instruction
+ *
+ * @return VOID
+ */
+static VOID
+PtDecoderReportReturn(PPT_DECODER Decoder, UINT64 Ip)
+{
+    Decoder->Statistics.CountOfReturns++;
+
+    CommandTrackHandleReceivedRetInstructions(Ip);
+}
+
+/**
+ * @brief Follow an event that has the target IP
+ *
+ * @param Event
+ * @param Ip The current IP
+ * @param Is32Bit The execution mode
+ *
+ * @return BOOLEAN Whether the current IP is known or not
+ */
+static BOOLEAN
+PtDecoderFollowEvent(PPT_DECODER_EVENT Event, PUINT64 Ip, PBOOLEAN Is32Bit)
+{
+    if (Event->Type == PT_DECODER_EVENT_TNT || Event->Type == PT_DECODER_EVENT_TIP_PGD ||
+        Event->Type == PT_DECODER_EVENT_OVF || !Event->HasIp)
+    {
+        return FALSE;
+    }
+
+    *Ip = Event->Ip;
+
+    if (Event->HasMode)
+    {
+        *Is32Bit = Event->Is32Bit;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Decode the trace of a core and pass the 'call' and 'ret'
+ * instructions to the handlers of the call tree
+ * @details the instructions are read from the memory of the process of
+ * the configuration, so the code should not be changed after tracing
+ *
+ * @param Trace The trace of the core
+ * @param TraceSize Size of the trace
+ * @param Configuration The configuration of the trace
+ * @param Statistics The statistics of decoding
+ *
+ * @return BOOLEAN FALSE if the trace has no synchronization point
+ */
+BOOLEAN
+PtDecoderDecodeTrace(const UINT8 *             Trace,
+                     UINT64                    TraceSize,
+                     PPT_DECODER_CONFIGURATION Configuration,
+                     PPT_DECODER_STATISTICS    Statistics)
+{
+    PT_DECODER                   Decoder = {};
+    ZydisDecoder                 ZydisDecoder64;
+    ZydisDecoder                 ZydisDecoder32;
+    ZydisDecodedInstruction      Instruction;
+    ZydisDecodedOperand          Operands[ZYDIS_MAX_OPERAND_COUNT];
+    PT_DECODER_EVENT             Event;
+    PT_DECODER_INSTRUCTION_CLASS Class;
+    UINT8                        Buffer[MAXIMUM_INSTR_SIZE];
+    UINT32                       Length;
+    UINT64                       Ip                        = 0;
+    UINT64                       Target                    = 0;
+    UINT64                       InstructionsWithoutEvents = 0;
+    BOOLEAN                      IsIpValid                 = FALSE;
+    BOOLEAN                      Is32Bit                   = FALSE;
+    BOOLEAN                      IsFinished                = FALSE;
+
+    Decoder.Trace         = Trace;
+    Decoder.TraceSize     = TraceSize;
+    Decoder.Configuration = *Configuration;
+
+    ZydisDecoderInit(&ZydisDecoder64, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
+    ZydisDecoderInit(&ZydisDecoder32, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
+
+    if (!PtDecoderSyncForward(&Decoder))
+    {
+        *Statistics = Decoder.Statistics;
+        return FALSE;
+    }
+
+    while (!IsFinished && g_IsInstrumentingInstructions)
+    {
+        if (!IsIpValid)
+        {
+            //
+            // Skip the events until the current IP is known
+            //
+            if (!PtDecoderNextEvent(&Decoder, &Event))
+            {
+                break;
+            }
+
+            if (Event.Type != PT_DECODER_EVENT_FUP && PtDecoderFollowEvent(&Event, &Ip, &Is32Bit))
+            {
+                IsIpValid                 = TRUE;
+                InstructionsWithoutEvents = 0;
+            }
+
+            continue;
+        }
+
+        //
+        // Check the events that are bound to the current IP
+        //
+        if (PtDecoderPeekEvent(&Decoder, &Event))
+        {
+            if (Event.Type == PT_DECODER_EVENT_OVF)
+            {
+                PtDecoderNextEvent(&Decoder, &Event);
+                IsIpValid = FALSE;
+                continue;
+            }
+
+            if ((Event.Type == PT_DECODER_EVENT_FUP || Event.Type == PT_DECODER_EVENT_SYNC) && (!Event.HasIp || Event.Ip == Ip))
+            {
+                PtDecoderNextEvent(&Decoder, &Event);
+
+                if (Event.HasMode)
+                {
+                    Is32Bit = Event.Is32Bit;
+                }
+
+                //
+                // An asynchronous event (e.g., an interrupt) happened before
+                // executing the current instruction, its target (if any) is
+                // the next TIP or TIP.PGD
+                //
+                if (Event.Type == PT_DECODER_EVENT_FUP && PtDecoderPeekEvent(&Decoder, &Event) &&
+                    (Event.Type == PT_DECODER_EVENT_TIP || Event.Type == PT_DECODER_EVENT_TIP_PGD))
+                {
+                    PtDecoderNextEvent(&Decoder, &Event);
+                    IsIpValid = PtDecoderFollowEvent(&Event, &Ip, &Is32Bit);
+                }
+
+                InstructionsWithoutEvents = 0;
+                continue;
+            }
+        }
+
+        if (++InstructionsWithoutEvents > PT_DECODER_MAXIMUM_INSTRUCTIONS_WITHOUT_PACKETS)
+        {
+            Decoder.Statistics.CountOfDesyncs++;
+            IsIpValid = FALSE;
+            continue;
+        }
+
+        Length = PtDecoderReadInstruction(&Decoder, Ip, Buffer);
+
+        if (Length == 0 ||
+            !ZYAN_SUCCESS(ZydisDecoderDecodeFull(Is32Bit ? &ZydisDecoder32 : &ZydisDecoder64, Buffer, Length, &Instruction, Operands)))
+        {
+            //
+            // The code is not available, continue from the next event that
+            // has the IP
+            //
+            Decoder.Statistics.CountOfDesyncs++;
+            IsIpValid = FALSE;
+            continue;
+        }
+
+        Decoder.Statistics.CountOfInstructions++;
+
+        Class = PtDecoderClassifyInstruction(&Instruction, Operands, Ip, &Target);
+
+        switch (Class)
+        {
+        case PT_DECODER_INSTRUCTION_OTHER:
+
+            Ip += Instruction.length;
+
+            break;
+
+        case PT_DECODER_INSTRUCTION_COND_BRANCH:
+
+            if (!PtDecoderNextEvent(&Decoder, &Event))
+            {
+                IsFinished = TRUE;
+                break;
+            }
+
+            InstructionsWithoutEvents = 0;
+
+            if (Event.Type == PT_DECODER_EVENT_TNT)
+            {
+                Ip = Event.Taken ? Target : Ip + Instruction.length;
+            }
+            else
+            {
+                //
+                // A TIP.PGD means that the trace is disabled, the other events
+                // mean that the decoder is out of sync
+                //
+                if (Event.Type != PT_DECODER_EVENT_TIP_PGD)
+                {
+                    Decoder.Statistics.CountOfDesyncs++;
+                }
+
+                IsIpValid = PtDecoderFollowEvent(&Event, &Ip, &Is32Bit);
+            }
+
+            break;
+
+        case PT_DECODER_INSTRUCTION_DIRECT_CALL:
+        case PT_DECODER_INSTRUCTION_DIRECT_JUMP:
+
+            if (Class == PT_DECODER_INSTRUCTION_DIRECT_CALL)
+            {
+                PtDecoderReportCall(&Decoder, Target);
+            }
+
+            Ip = Target;
+
+            //
+            // The branch disables the trace if the target is not traced
+            // (e.g., it's not in the address ranges)
+            //
+            if (PtDecoderPeekEvent(&Decoder, &Event) && Event.Type == PT_DECODER_EVENT_TIP_PGD &&
+                (Event.HasIp ? Event.Ip == Target : !PtDecoderIsAddressTraced(&Decoder, Target)))
+            {
+                PtDecoderNextEvent(&Decoder, &Event);
+                IsIpValid = FALSE;
+            }
+
+            break;
+
+        case PT_DECODER_INSTRUCTION_INDIRECT_JUMP:
+        case PT_DECODER_INSTRUCTION_INDIRECT_CALL:
+        case PT_DECODER_INSTRUCTION_RETURN:
+        case PT_DECODER_INSTRUCTION_FAR_TRANSFER:
+
+            if (!PtDecoderNextEvent(&Decoder, &Event))
+            {
+                IsFinished = TRUE;
+                break;
+            }
+
+            InstructionsWithoutEvents = 0;
+
+            if (Event.Type == PT_DECODER_EVENT_TIP || Event.Type == PT_DECODER_EVENT_TIP_PGD)
+            {
+                if (Class == PT_DECODER_INSTRUCTION_INDIRECT_CALL && Event.HasIp)
+                {
+                    PtDecoderReportCall(&Decoder, Event.Ip);
+                }
+                else if (Class == PT_DECODER_INSTRUCTION_RETURN)
+                {
+                    PtDecoderReportReturn(&Decoder, Ip);
+                }
+            }
+            else
+            {
+                Decoder.Statistics.CountOfDesyncs++;
+            }
+
+            IsIpValid = PtDecoderFollowEvent(&Event, &Ip, &Is32Bit);
+
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    *Statistics = Decoder.Statistics;
+
+    return TRUE;
+}
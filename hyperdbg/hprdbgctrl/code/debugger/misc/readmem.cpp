@@ -18,79 +18,27 @@
 extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
 
 /**
- * @brief Read memory and disassembler
+ * @brief Show the memory or disassemble it based on the style
  *
  * @param Style style of show memory (as byte, dwrod, qword)
- * @param Address location of where to read the memory
+ * @param Address location of where the memory is read
  * @param MemoryType type of memory (phyical or virtual)
- * @param ReadingType read from kernel or vmx-root
- * @param Pid The target process id
- * @param Size size of memory to read
+ * @param OutputBuffer the memory
+ * @param Size size of the requested memory
+ * @param ReturnedLength size of the memory that is read
  * @param DtDetails Options for dt structure show details
  *
  * @return VOID
  */
 VOID
-HyperDbgReadMemoryAndDisassemble(DEBUGGER_SHOW_MEMORY_STYLE   Style,
-                                 UINT64                       Address,
-                                 DEBUGGER_READ_MEMORY_TYPE    MemoryType,
-                                 DEBUGGER_READ_READING_TYPE   ReadingType,
-                                 UINT32                       Pid,
-                                 UINT32                       Size,
-                                 PDEBUGGER_DT_COMMAND_OPTIONS DtDetails)
+HyperDbgShowMemoryOrDisassemble(DEBUGGER_SHOW_MEMORY_STYLE   Style,
+                                UINT64                       Address,
+                                DEBUGGER_READ_MEMORY_TYPE    MemoryType,
+                                unsigned char *              OutputBuffer,
+                                UINT32                       Size,
+                                UINT32                       ReturnedLength,
+                                PDEBUGGER_DT_COMMAND_OPTIONS DtDetails)
 {
-    BOOL                 Status;
-    ULONG                ReturnedLength;
-    DEBUGGER_READ_MEMORY ReadMem = {0};
-    UINT32               OperationCode;
-    CHAR                 Character;
-
-    ReadMem.Address     = Address;
-    ReadMem.Pid         = Pid;
-    ReadMem.Size        = Size;
-    ReadMem.MemoryType  = MemoryType;
-    ReadMem.ReadingType = ReadingType;
-    ReadMem.Style       = Style;
-    ReadMem.DtDetails   = DtDetails;
-
-    //
-    // send the request
-    //
-    if (g_IsSerialConnectedToRemoteDebuggee)
-    {
-        KdSendReadMemoryPacketToDebuggee(&ReadMem);
-        return;
-    }
-
-    //
-    // It's on VMI mode
-    //
-    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturn);
-
-    //
-    // allocate buffer for transfering messages
-    //
-    unsigned char * OutputBuffer = (unsigned char *)malloc(Size * sizeof(unsigned char));
-
-    ZeroMemory(OutputBuffer, Size * sizeof(unsigned char));
-
-    Status = DeviceIoControl(g_DeviceHandle,              // Handle to device
-                             IOCTL_DEBUGGER_READ_MEMORY,  // IO Control code
-                             &ReadMem,                    // Input Buffer to driver.
-                             SIZEOF_DEBUGGER_READ_MEMORY, // Input buffer length
-                             OutputBuffer,                // Output Buffer from driver.
-                             Size,                        // Length of output buffer in bytes.
-                             &ReturnedLength,             // Bytes placed in buffer.
-                             NULL                         // synchronous call
-    );
-
-    if (!Status)
-    {
-        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
-        free(OutputBuffer);
-        return;
-    }
-
     switch (Style)
     {
     case DEBUGGER_SHOW_COMMAND_DT:
@@ -159,6 +107,127 @@ HyperDbgReadMemoryAndDisassemble(DEBUGGER_SHOW_MEMORY_STYLE   Style,
 
         break;
     }
+}
+
+/**
+ * @brief Read memory into a buffer
+ * @details in the debugger mode, the memory is served from the snapshot
+ * of the halted debuggee if it's already fetched
+ *
+ * @param ReadMem The request of reading memory
+ * @param Buffer The memory is saved here (ReadMem->Size bytes)
+ * @param ReturnedLength Count of bytes that are read
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+HyperDbgReadMemory(PDEBUGGER_READ_MEMORY ReadMem, unsigned char * Buffer, UINT32 * ReturnedLength)
+{
+    BOOL Status;
+
+    //
+    // It's on VMI mode
+    //
+    if (!g_IsSerialConnectedToRemoteDebuggee)
+    {
+        AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+    }
+    else if (ReadMem->Size > MaxSerialReadMemorySize)
+    {
+        ShowMessages("err, the size of memory should not be greater than 0x%x bytes\n",
+                     MaxSerialReadMemorySize);
+        return FALSE;
+    }
+
+    //
+    // send the request
+    //
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        if (!KdMemoryCacheRead(ReadMem, Buffer, ReturnedLength))
+        {
+            ShowErrorMessage(ReadMem->KernelStatus);
+            return FALSE;
+        }
+    }
+    else
+    {
+        Status = DeviceIoControl(g_DeviceHandle,              // Handle to device
+                                 IOCTL_DEBUGGER_READ_MEMORY,  // IO Control code
+                                 ReadMem,                     // Input Buffer to driver.
+                                 SIZEOF_DEBUGGER_READ_MEMORY, // Input buffer length
+                                 Buffer,                      // Output Buffer from driver.
+                                 ReadMem->Size,               // Length of output buffer in bytes.
+                                 (LPDWORD)ReturnedLength,     // Bytes placed in buffer.
+                                 NULL                         // synchronous call
+        );
+
+        if (!Status)
+        {
+            ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Read memory and disassembler
+ *
+ * @param Style style of show memory (as byte, dwrod, qword)
+ * @param Address location of where to read the memory
+ * @param MemoryType type of memory (phyical or virtual)
+ * @param ReadingType read from kernel or vmx-root
+ * @param Pid The target process id
+ * @param Size size of memory to read
+ * @param DtDetails Options for dt structure show details
+ *
+ * @return VOID
+ */
+VOID
+HyperDbgReadMemoryAndDisassemble(DEBUGGER_SHOW_MEMORY_STYLE   Style,
+                                 UINT64                       Address,
+                                 DEBUGGER_READ_MEMORY_TYPE    MemoryType,
+                                 DEBUGGER_READ_READING_TYPE   ReadingType,
+                                 UINT32                       Pid,
+                                 UINT32                       Size,
+                                 PDEBUGGER_DT_COMMAND_OPTIONS DtDetails)
+{
+    UINT32               ReturnedLength = 0;
+    DEBUGGER_READ_MEMORY ReadMem        = {0};
+
+    ReadMem.Address     = Address;
+    ReadMem.Pid         = Pid;
+    ReadMem.Size        = Size;
+    ReadMem.MemoryType  = MemoryType;
+    ReadMem.ReadingType = ReadingType;
+    ReadMem.Style       = Style;
+    ReadMem.DtDetails   = DtDetails;
+
+    //
+    // allocate buffer for transfering messages
+    //
+    unsigned char * OutputBuffer = (unsigned char *)malloc(Size * sizeof(unsigned char));
+
+    if (OutputBuffer == NULL)
+    {
+        ShowMessages("err, unable to allocate memory\n");
+        return;
+    }
+
+    ZeroMemory(OutputBuffer, Size * sizeof(unsigned char));
+
+    //
+    // send the request
+    //
+    if (!HyperDbgReadMemory(&ReadMem, OutputBuffer, &ReturnedLength))
+    {
+        free(OutputBuffer);
+        return;
+    }
+
+    HyperDbgShowMemoryOrDisassemble(Style, Address, MemoryType, OutputBuffer, Size, ReturnedLength, DtDetails);
 
     //
     // free the buffer
@@ -168,6 +237,104 @@ HyperDbgReadMemoryAndDisassemble(DEBUGGER_SHOW_MEMORY_STYLE   Style,
     ShowMessages("\n");
 }
 
+/**
+ * @brief Read memory and disassemble it to a file
+ * @details the memory is read in large requests (each request is streamed
+ * in chunks in the debugger mode) and the whole range is disassembled at
+ * once, so the instructions are not cut at the boundaries of the requests
+ *
+ * @param Style style of disassembling (x64 or x86)
+ * @param Address location of where to read the memory
+ * @param MemoryType type of memory (phyical or virtual)
+ * @param ReadingType read from kernel or vmx-root
+ * @param Pid The target process id
+ * @param Size size of memory to read
+ * @param FilePath Path of the output file
+ *
+ * @return VOID
+ */
+VOID
+HyperDbgReadMemoryAndDisassembleToFile(DEBUGGER_SHOW_MEMORY_STYLE Style,
+                                       UINT64                     Address,
+                                       DEBUGGER_READ_MEMORY_TYPE  MemoryType,
+                                       DEBUGGER_READ_READING_TYPE ReadingType,
+                                       UINT32                     Pid,
+                                       UINT32                     Size,
+                                       const string &             FilePath)
+{
+    UINT32               ReturnedLength;
+    UINT64               TotalLength         = 0;
+    UINT64               CountOfInstructions = 0;
+    DEBUGGER_READ_MEMORY ReadMem             = {0};
+
+    //
+    // allocate buffer for the whole range
+    //
+    unsigned char * OutputBuffer = (unsigned char *)malloc(Size * sizeof(unsigned char));
+
+    if (OutputBuffer == NULL)
+    {
+        ShowMessages("err, unable to allocate memory\n");
+        return;
+    }
+
+    while (TotalLength < Size)
+    {
+        ReturnedLength = 0;
+
+        ReadMem.Address     = Address + TotalLength;
+        ReadMem.Pid         = Pid;
+        ReadMem.Size        = (UINT32)min(Size - TotalLength, MaxSerialReadMemorySize);
+        ReadMem.MemoryType  = MemoryType;
+        ReadMem.ReadingType = ReadingType;
+        ReadMem.Style       = Style;
+        ReadMem.DtDetails   = NULL;
+
+        if (!HyperDbgReadMemory(&ReadMem, &OutputBuffer[TotalLength], &ReturnedLength))
+        {
+            free(OutputBuffer);
+            return;
+        }
+
+        TotalLength += ReturnedLength;
+
+        if (ReturnedLength != ReadMem.Size)
+        {
+            //
+            // The rest of the range is not readable
+            //
+            break;
+        }
+    }
+
+    if (TotalLength == 0)
+    {
+        ShowMessages("err, invalid address\n");
+        free(OutputBuffer);
+        return;
+    }
+
+    if (HyperDbgDisassembleToFile(OutputBuffer,
+                                  Address,
+                                  TotalLength,
+                                  Style == DEBUGGER_SHOW_COMMAND_DISASSEMBLE64,
+                                  FilePath,
+                                  &CountOfInstructions))
+    {
+        ShowMessages("%llx instructions (%llx bytes) are disassembled to '%s'\n",
+                     CountOfInstructions,
+                     TotalLength,
+                     FilePath.c_str());
+
+        if (TotalLength != Size)
+        {
+            ShowMessages("the memory is not readable after %llx\n", Address + TotalLength);
+        }
+    }
+
+    free(OutputBuffer);
+}
+
 /**
  * @brief Show memory in bytes (DB)
  *
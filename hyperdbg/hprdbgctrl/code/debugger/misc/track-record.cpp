@@ -0,0 +1,537 @@
+/**
+ * @file track-record.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The binary records of the '!track' command
+ * @details while tracking, the 'call' and 'ret' instructions are only
+ * decoded (without formatting and without any symbol lookup) and they're
+ * written to a memory-mapped file as fixed-size records, the records are
+ * formatted (and symbolized) afterwards, either as the call tree or as
+ * the collapsed stacks (the input format of the flame graphs)
+ * @version 0.4
+ * @date 2023-08-07
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+#include "Zydis/Zydis.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_IsInstrumentingInstructions;
+extern BOOLEAN g_AddressConversion;
+
+//
+// Local (global) variables
+//
+static HANDLE                    TrackRecordFileHandle    = INVALID_HANDLE_VALUE;
+static HANDLE                    TrackRecordMappingHandle = NULL;
+static PTRACK_RECORD_FILE_HEADER TrackRecordHeader        = NULL;
+static UINT64                    TrackRecordCapacity      = 0;
+static UINT64                    TrackRecordCount         = 0;
+static TRACK_RECORD              TrackRecordPending       = {0};
+static BOOLEAN                   TrackRecordHasPending    = FALSE;
+static UINT32                    TrackRecordDepth         = 0;
+static ZydisDecoder              TrackRecordDecoder64;
+static ZydisDecoder              TrackRecordDecoder32;
+
+/**
+ * @brief Map the file of the records for writing
+ * @details the file is extended to the capacity (if it's smaller)
+ *
+ * @param Capacity Count of the records that the file can hold
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TrackRecordMapFile(UINT64 Capacity)
+{
+    UINT64 Size = sizeof(TRACK_RECORD_FILE_HEADER) + Capacity * sizeof(TRACK_RECORD);
+
+    TrackRecordMappingHandle = CreateFileMappingA(TrackRecordFileHandle,
+                                                  NULL,
+                                                  PAGE_READWRITE,
+                                                  (DWORD)(Size >> 32),
+                                                  (DWORD)Size,
+                                                  NULL);
+
+    if (TrackRecordMappingHandle == NULL)
+    {
+        return FALSE;
+    }
+
+    TrackRecordHeader = (PTRACK_RECORD_FILE_HEADER)MapViewOfFile(TrackRecordMappingHandle, FILE_MAP_WRITE, 0, 0, 0);
+
+    if (TrackRecordHeader == NULL)
+    {
+        CloseHandle(TrackRecordMappingHandle);
+        TrackRecordMappingHandle = NULL;
+        return FALSE;
+    }
+
+    TrackRecordCapacity = Capacity;
+
+    return TRUE;
+}
+
+/**
+ * @brief Unmap the file of the records
+ *
+ * @return VOID
+ */
+static VOID
+TrackRecordUnmapFile()
+{
+    if (TrackRecordHeader != NULL)
+    {
+        UnmapViewOfFile(TrackRecordHeader);
+        TrackRecordHeader = NULL;
+    }
+
+    if (TrackRecordMappingHandle != NULL)
+    {
+        CloseHandle(TrackRecordMappingHandle);
+        TrackRecordMappingHandle = NULL;
+    }
+}
+
+/**
+ * @brief Append a record to the file of the records
+ * @details the file is grown (and mapped again) once it's full
+ *
+ * @param Record
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TrackRecordAppend(PTRACK_RECORD Record)
+{
+    PTRACK_RECORD Records;
+
+    if (TrackRecordCount == TrackRecordCapacity)
+    {
+        TrackRecordUnmapFile();
+
+        if (!TrackRecordMapFile(TrackRecordCapacity + TRACK_RECORD_FILE_GROWTH_COUNT))
+        {
+            ShowMessages("err, unable to grow the file of the records (%x)\n", GetLastError());
+            return FALSE;
+        }
+    }
+
+    Records = (PTRACK_RECORD)((CHAR *)TrackRecordHeader + sizeof(TRACK_RECORD_FILE_HEADER));
+
+    Records[TrackRecordCount++]        = *Record;
+    TrackRecordHeader->CountOfRecords = TrackRecordCount;
+
+    return TRUE;
+}
+
+/**
+ * @brief Start recording the 'call' and 'ret' instructions to a file
+ *
+ * @param FilePath The path of the file of the records
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TrackRecordStart(const string & FilePath)
+{
+    TrackRecordFileHandle = CreateFileA(FilePath.c_str(),
+                                        GENERIC_READ | GENERIC_WRITE,
+                                        0,
+                                        NULL,
+                                        CREATE_ALWAYS,
+                                        FILE_ATTRIBUTE_NORMAL,
+                                        NULL);
+
+    if (TrackRecordFileHandle == INVALID_HANDLE_VALUE)
+    {
+        ShowMessages("err, unable to create the file of the records (%x)\n", GetLastError());
+        return FALSE;
+    }
+
+    if (!TrackRecordMapFile(TRACK_RECORD_FILE_GROWTH_COUNT))
+    {
+        ShowMessages("err, unable to map the file of the records (%x)\n", GetLastError());
+
+        CloseHandle(TrackRecordFileHandle);
+        TrackRecordFileHandle = INVALID_HANDLE_VALUE;
+        return FALSE;
+    }
+
+    TrackRecordHeader->Magic          = TRACK_RECORD_FILE_MAGIC;
+    TrackRecordHeader->Version        = TRACK_RECORD_FILE_VERSION;
+    TrackRecordHeader->CountOfRecords = 0;
+
+    TrackRecordCount      = 0;
+    TrackRecordHasPending = FALSE;
+    TrackRecordDepth      = 0;
+
+    ZydisDecoderInit(&TrackRecordDecoder64, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
+    ZydisDecoderInit(&TrackRecordDecoder32, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_STACK_WIDTH_32);
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether the instructions are recorded or not
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TrackRecordIsActive()
+{
+    return TrackRecordFileHandle != INVALID_HANDLE_VALUE;
+}
+
+/**
+ * @brief Record the stepped instruction if it's a 'call' or a 'ret'
+ * @details the target of the previous 'call' or 'ret' is the address of
+ * the current instruction, so the targets of the indirect branches are
+ * also recorded
+ *
+ * @param BufferToDisassemble
+ * @param BuffLength
+ * @param Isx86_64
+ * @param RipAddress
+ * @param Tsc The time-stamp counter of the debuggee
+ *
+ * @return VOID
+ */
+VOID
+TrackRecordHandleInstruction(unsigned char * BufferToDisassemble,
+                             UINT32          BuffLength,
+                             BOOLEAN         Isx86_64,
+                             UINT64          RipAddress,
+                             UINT64          Tsc)
+{
+    ZydisDecodedInstruction Instruction;
+    ZydisDecodedOperand     Operands[ZYDIS_MAX_OPERAND_COUNT];
+
+    if (TrackRecordHeader == NULL)
+    {
+        return;
+    }
+
+    //
+    // Complete the previous record
+    //
+    if (TrackRecordHasPending)
+    {
+        TrackRecordHasPending        = FALSE;
+        TrackRecordPending.ToAddress = RipAddress;
+
+        if (!TrackRecordAppend(&TrackRecordPending))
+        {
+            //
+            // Stop the tracking (like CTRL+C)
+            //
+            g_IsInstrumentingInstructions = FALSE;
+            return;
+        }
+    }
+
+    if (!ZYAN_SUCCESS(ZydisDecoderDecodeFull(Isx86_64 ? &TrackRecordDecoder64 : &TrackRecordDecoder32,
+                                             BufferToDisassemble,
+                                             BuffLength,
+                                             &Instruction,
+                                             Operands)))
+    {
+        return;
+    }
+
+    if (Instruction.mnemonic == ZydisMnemonic::ZYDIS_MNEMONIC_CALL)
+    {
+        TrackRecordPending.Type  = TRACK_RECORD_TYPE_CALL;
+        TrackRecordPending.Depth = TrackRecordDepth++;
+    }
+    else if (Instruction.mnemonic == ZydisMnemonic::ZYDIS_MNEMONIC_RET)
+    {
+        if (TrackRecordDepth != 0)
+        {
+            TrackRecordDepth--;
+        }
+
+        TrackRecordPending.Type  = TRACK_RECORD_TYPE_RET;
+        TrackRecordPending.Depth = TrackRecordDepth;
+    }
+    else
+    {
+        return;
+    }
+
+    TrackRecordPending.Tsc         = Tsc;
+    TrackRecordPending.FromAddress = RipAddress;
+    TrackRecordHasPending          = TRUE;
+}
+
+/**
+ * @brief Stop recording the instructions and close the file of the records
+ * @details the file is truncated to the recorded records, the last 'call'
+ * or 'ret' is not recorded if its target is not stepped
+ *
+ * @return VOID
+ */
+VOID
+TrackRecordStop()
+{
+    LARGE_INTEGER Size;
+
+    if (TrackRecordFileHandle == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    TrackRecordUnmapFile();
+
+    Size.QuadPart = sizeof(TRACK_RECORD_FILE_HEADER) + TrackRecordCount * sizeof(TRACK_RECORD);
+
+    if (!SetFilePointerEx(TrackRecordFileHandle, Size, NULL, FILE_BEGIN) || !SetEndOfFile(TrackRecordFileHandle))
+    {
+        ShowMessages("err, unable to truncate the file of the records (%x)\n", GetLastError());
+    }
+
+    CloseHandle(TrackRecordFileHandle);
+    TrackRecordFileHandle = INVALID_HANDLE_VALUE;
+
+    ShowMessages("%llx records are saved\n", TrackRecordCount);
+}
+
+/**
+ * @brief Map a file of the records for reading
+ *
+ * @param FilePath The path of the file of the records
+ * @param FileHandle The handle of the file
+ * @param MappingHandle The handle of the mapping
+ *
+ * @return PTRACK_RECORD_FILE_HEADER NULL if the file is not valid
+ */
+static PTRACK_RECORD_FILE_HEADER
+TrackRecordMapFileForReading(const string & FilePath, HANDLE * FileHandle, HANDLE * MappingHandle)
+{
+    PTRACK_RECORD_FILE_HEADER Header = NULL;
+    LARGE_INTEGER             Size;
+
+    *MappingHandle = NULL;
+    *FileHandle    = CreateFileA(FilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (*FileHandle == INVALID_HANDLE_VALUE)
+    {
+        ShowMessages("err, unable to open the file of the records (%x)\n", GetLastError());
+        return NULL;
+    }
+
+    if (GetFileSizeEx(*FileHandle, &Size) && Size.QuadPart >= sizeof(TRACK_RECORD_FILE_HEADER))
+    {
+        *MappingHandle = CreateFileMappingA(*FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+        if (*MappingHandle != NULL)
+        {
+            Header = (PTRACK_RECORD_FILE_HEADER)MapViewOfFile(*MappingHandle, FILE_MAP_READ, 0, 0, 0);
+        }
+    }
+
+    if (Header != NULL &&
+        (Header->Magic != TRACK_RECORD_FILE_MAGIC ||
+         Header->Version != TRACK_RECORD_FILE_VERSION ||
+         Header->CountOfRecords > (Size.QuadPart - sizeof(TRACK_RECORD_FILE_HEADER)) / sizeof(TRACK_RECORD)))
+    {
+        UnmapViewOfFile(Header);
+        Header = NULL;
+    }
+
+    if (Header == NULL)
+    {
+        ShowMessages("err, the file is not a valid file of the records\n");
+
+        if (*MappingHandle != NULL)
+        {
+            CloseHandle(*MappingHandle);
+        }
+
+        CloseHandle(*FileHandle);
+    }
+
+    return Header;
+}
+
+/**
+ * @brief Show the call tree of a file of the records
+ * @details the 'call' and 'ret' records are passed to the handlers of
+ * the '!track' command, so it's the same as the tree of tracking
+ *
+ * @param FilePath The path of the file of the records
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TrackRecordShowTree(const string & FilePath)
+{
+    PTRACK_RECORD_FILE_HEADER   Header;
+    PTRACK_RECORD               Records;
+    HANDLE                      FileHandle;
+    HANDLE                      MappingHandle;
+    PLOCAL_FUNCTION_DESCRIPTION FunctionDescription;
+
+    Header = TrackRecordMapFileForReading(FilePath, &FileHandle, &MappingHandle);
+
+    if (Header == NULL)
+    {
+        return FALSE;
+    }
+
+    Records = (PTRACK_RECORD)((CHAR *)Header + sizeof(TRACK_RECORD_FILE_HEADER));
+
+    //
+    // Indicate that we're instrumenting (for CTRL+C)
+    //
+    g_IsInstrumentingInstructions = TRUE;
+
+    for (UINT64 i = 0; i < Header->CountOfRecords && g_IsInstrumentingInstructions; i++)
+    {
+        if (Records[i].Type == TRACK_RECORD_TYPE_RET)
+        {
+            CommandTrackHandleReceivedRetInstructions(Records[i].FromAddress);
+            continue;
+        }
+
+        FunctionDescription = g_AddressConversion ? SymbolFindDisassemblerSymbol(Records[i].ToAddress) : NULL;
+
+        CommandTrackHandleReceivedCallInstructions(FunctionDescription != NULL ? SymbolGetDisassemblerSymbolName(FunctionDescription) : NULL,
+                                                   Records[i].ToAddress);
+    }
+
+    //
+    // We're not instrumenting instructions anymore
+    //
+    g_IsInstrumentingInstructions = FALSE;
+
+    UnmapViewOfFile(Header);
+    CloseHandle(MappingHandle);
+    CloseHandle(FileHandle);
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the name of the frame of an address for the collapsed stacks
+ *
+ * @param Address
+ *
+ * @return string
+ */
+static string
+TrackRecordGetFrameName(UINT64 Address)
+{
+    UINT64 FunctionAddress;
+    string FunctionName;
+
+    if (SymbolQueryFunctionOfAddress(Address, &FunctionAddress, FunctionName))
+    {
+        return FunctionName;
+    }
+
+    return SeparateTo64BitValue(Address);
+}
+
+/**
+ * @brief Convert a file of the records to the collapsed stacks
+ * @details each line is a stack (from the root to the leaf, separated
+ * by ';') and the count of the TSC cycles that are spent in the stack,
+ * which is the input format of the flame graphs
+ *
+ * @param FilePath The path of the file of the records
+ * @param OutputPath The path of the file of the collapsed stacks
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TrackRecordCollapseStacks(const string & FilePath, const string & OutputPath)
+{
+    PTRACK_RECORD_FILE_HEADER Header;
+    PTRACK_RECORD             Records;
+    HANDLE                    FileHandle;
+    HANDLE                    MappingHandle;
+    std::map<string, UINT64>  Stacks;
+    vector<string>            Frames;
+    string                    CurrentStack;
+    std::ofstream             Output;
+
+    Header = TrackRecordMapFileForReading(FilePath, &FileHandle, &MappingHandle);
+
+    if (Header == NULL)
+    {
+        return FALSE;
+    }
+
+    Records = (PTRACK_RECORD)((CHAR *)Header + sizeof(TRACK_RECORD_FILE_HEADER));
+
+    for (UINT64 i = 0; i < Header->CountOfRecords; i++)
+    {
+        //
+        // The first frame is the function that the tracking is started from
+        //
+        if (Frames.empty())
+        {
+            Frames.push_back(TrackRecordGetFrameName(Records[i].FromAddress));
+        }
+
+        if (Records[i].Type == TRACK_RECORD_TYPE_CALL)
+        {
+            Frames.push_back(TrackRecordGetFrameName(Records[i].ToAddress));
+        }
+        else
+        {
+            Frames.pop_back();
+
+            //
+            // Returning from the first frame, the caller becomes the first frame
+            //
+            if (Frames.empty())
+            {
+                Frames.push_back(TrackRecordGetFrameName(Records[i].ToAddress));
+            }
+        }
+
+        //
+        // The cycles until the next record are spent in the current stack
+        //
+        if (i + 1 < Header->CountOfRecords && Records[i + 1].Tsc > Records[i].Tsc)
+        {
+            CurrentStack.clear();
+
+            for (auto & Frame : Frames)
+            {
+                CurrentStack += CurrentStack.empty() ? Frame : ";" + Frame;
+            }
+
+            Stacks[CurrentStack] += Records[i + 1].Tsc - Records[i].Tsc;
+        }
+    }
+
+    UnmapViewOfFile(Header);
+    CloseHandle(MappingHandle);
+    CloseHandle(FileHandle);
+
+    Output.open(OutputPath.c_str());
+
+    if (!Output.is_open())
+    {
+        ShowMessages("err, unable to create the file of the collapsed stacks\n");
+        return FALSE;
+    }
+
+    for (auto & Stack : Stacks)
+    {
+        Output << Stack.first << " " << Stack.second << "\n";
+    }
+
+    Output.close();
+
+    ShowMessages("%llx stacks are saved\n", (UINT64)Stacks.size());
+
+    return TRUE;
+}
@@ -18,6 +18,8 @@
 extern UINT64 * g_ScriptGlobalVariables;
 extern UINT64 * g_ScriptLocalVariables;
 extern UINT64 * g_ScriptTempVariables;
+extern BYTE *   g_ScriptScratchArena;
+extern UINT32   g_ScriptScratchUsed;
 extern UINT64   g_CurrentExprEvalResult;
 extern BOOLEAN  g_CurrentExprEvalResultHasError;
 
@@ -35,6 +37,54 @@ typedef struct _ALLOCATED_MEMORY_FOR_SCRIPT_ENGINE_CASTING
 
 } ALLOCATED_MEMORY_FOR_SCRIPT_ENGINE_CASTING, *PALLOCATED_MEMORY_FOR_SCRIPT_ENGINE_CASTING;
 
+/**
+ * @brief Representative scripts of the benchmark of the script engine
+ * @details the registers are synthetic (see ScriptEngineWrapperBenchmark)
+ *
+ */
+static const CHAR * const g_ScriptEngineBenchmarkCorpus[] = {
+    "x = @rax;",
+    "x = @rax + @rbx * 2 - (@rdx >> 1) ^ 0xff;",
+    "$t0 = @rdx; $t1 = ($t0 << 3) | 1; x = $t1 % 7;",
+    "if (@rax == 1 && @rbx != 0) { x = 1; } else { x = 2; }",
+    "for (i = 0; i < 10; i++) { x = x + i; }",
+    "i = 0; while (i < 10) { i++; }",
+    "x = dq(@rsp); y = dd(@rsp + 8); z = db(@r15);",
+    "x = poi(@rsp + 10) + dw(@rsp);",
+    "x = strlen(@r15); y = wcslen(@r14);",
+    "if (memcmp(@r15, @r15, 5) == 0) { x = check_address(@rsp); }",
+};
+
+/**
+ * @brief Count of the heap allocations (debug builds)
+ *
+ */
+static volatile LONG64 g_ScriptEngineBenchmarkAllocations;
+
+/**
+ * @brief Compiled scripts (keyed by the hash of their source)
+ *
+ */
+static std::multimap<UINT64, SCRIPT_ENGINE_COMPILED_CACHE_ENTRY> g_ScriptEngineCompiledCache;
+
+/**
+ * @brief Version of the loaded symbols (increased once symbols are
+ * loaded or unloaded)
+ *
+ */
+static UINT64 g_ScriptEngineSymbolsVersion = 0;
+
+/**
+ * @brief Symbols are changed, scripts should be compiled again
+ *
+ * @return VOID
+ */
+static VOID
+ScriptEngineSymbolsChanged()
+{
+    g_ScriptEngineSymbolsVersion++;
+}
+
 //
 // *********************** Pdb parse wrapper ***********************
 //
@@ -65,6 +115,8 @@ ScriptEngineConvertNameToAddressWrapper(const char * FunctionOrVariableName, PBO
 UINT32
 ScriptEngineLoadFileSymbolWrapper(UINT64 BaseAddress, const char * PdbFileName)
 {
+    ScriptEngineSymbolsChanged();
+
     return ScriptEngineLoadFileSymbol(BaseAddress, PdbFileName);
 }
 
@@ -89,6 +141,8 @@ ScriptEngineSetTextMessageCallbackWrapper(PVOID Handler)
 UINT32
 ScriptEngineUnloadAllSymbolsWrapper()
 {
+    ScriptEngineSymbolsChanged();
+
     return ScriptEngineUnloadAllSymbols();
 }
 
@@ -101,6 +155,8 @@ ScriptEngineUnloadAllSymbolsWrapper()
 UINT32
 ScriptEngineUnloadModuleSymbolWrapper(char * ModuleName)
 {
+    ScriptEngineSymbolsChanged();
+
     return ScriptEngineUnloadModuleSymbol(ModuleName);
 }
 
@@ -193,6 +249,8 @@ ScriptEngineSymbolInitLoadWrapper(PMODULE_SYMBOL_DETAIL BufferToStoreDetails,
                                   const char *          SymbolPath,
                                   BOOLEAN               IsSilentLoad)
 {
+    ScriptEngineSymbolsChanged();
+
     return ScriptEngineSymbolInitLoad(BufferToStoreDetails, StoredLength, DownloadIfAvailable, SymbolPath, IsSilentLoad);
 }
 
@@ -252,8 +310,112 @@ ScriptEngineConvertFileToPdbFileAndGuidAndAgeDetailsWrapper(const char * LocalFi
 // *********************** Function links (wrapper) ***********************
 //
 
+/**
+ * @brief Hash of the source of a script (FNV-1a)
+ *
+ * @param Source
+ *
+ * @return UINT64
+ */
+static UINT64
+ScriptEngineCompiledCacheHash(const std::string & Source)
+{
+    UINT64 Hash = 0xcbf29ce484222325;
+
+    for (UCHAR Character : Source)
+    {
+        Hash ^= Character;
+        Hash *= 0x100000001b3;
+    }
+
+    return Hash;
+}
+
+/**
+ * @brief Remove all the compiled scripts from the cache
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineCompiledCacheFlush()
+{
+    for (auto & Item : g_ScriptEngineCompiledCache)
+    {
+        RemoveSymbolBuffer(Item.second.SymbolBuffer);
+    }
+
+    g_ScriptEngineCompiledCache.clear();
+}
+
+/**
+ * @brief Get a copy of a compiled script from the cache
+ * @details the entries which are compiled for a previous version of
+ * the symbols are removed
+ *
+ * @param Hash Hash of the source
+ * @param Source
+ *
+ * @return PSYMBOL_BUFFER NULL if the script is not in the cache
+ */
+static PSYMBOL_BUFFER
+ScriptEngineCompiledCacheLookup(UINT64 Hash, const std::string & Source)
+{
+    auto Range = g_ScriptEngineCompiledCache.equal_range(Hash);
+
+    for (auto Item = Range.first; Item != Range.second;)
+    {
+        if (Item->second.SymbolsVersion != g_ScriptEngineSymbolsVersion)
+        {
+            RemoveSymbolBuffer(Item->second.SymbolBuffer);
+            Item = g_ScriptEngineCompiledCache.erase(Item);
+            continue;
+        }
+
+        if (Item->second.Source == Source)
+        {
+            return ScriptEngineDuplicateSymbolBuffer(Item->second.SymbolBuffer);
+        }
+
+        Item++;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add a copy of a compiled script to the cache
+ *
+ * @param Hash Hash of the source
+ * @param Source
+ * @param SymbolBuffer The (successfully) compiled script
+ *
+ * @return VOID
+ */
+static VOID
+ScriptEngineCompiledCacheInsert(UINT64 Hash, const std::string & Source, PSYMBOL_BUFFER SymbolBuffer)
+{
+    SCRIPT_ENGINE_COMPILED_CACHE_ENTRY Entry;
+
+    if (g_ScriptEngineCompiledCache.size() >= SCRIPT_ENGINE_COMPILED_CACHE_MAX_ENTRIES)
+    {
+        ScriptEngineCompiledCacheFlush();
+    }
+
+    Entry.Source         = Source;
+    Entry.SymbolsVersion = g_ScriptEngineSymbolsVersion;
+    Entry.SymbolBuffer   = ScriptEngineDuplicateSymbolBuffer(SymbolBuffer);
+
+    if (Entry.SymbolBuffer != NULL)
+    {
+        g_ScriptEngineCompiledCache.insert({Hash, Entry});
+    }
+}
+
 /**
  * @brief ScriptEngineParse wrapper
+ * @details compiled scripts are cached, the same script (with the same
+ * loaded symbols) is not parsed again, the returned buffer is always
+ * owned by the caller
  *
  * @param Expr
  * @param ShowErrorMessageIfAny
@@ -264,6 +426,16 @@ PVOID
 ScriptEngineParseWrapper(char * Expr, BOOLEAN ShowErrorMessageIfAny)
 {
     PSYMBOL_BUFFER SymbolBuffer;
+    std::string    Source(Expr);
+    UINT64         Hash = ScriptEngineCompiledCacheHash(Source);
+
+    SymbolBuffer = ScriptEngineCompiledCacheLookup(Hash, Source);
+
+    if (SymbolBuffer != NULL)
+    {
+        return SymbolBuffer;
+    }
+
     SymbolBuffer = ScriptEngineParse(Expr);
 
     //
@@ -271,6 +443,12 @@ ScriptEngineParseWrapper(char * Expr, BOOLEAN ShowErrorMessageIfAny)
     //
     if (SymbolBuffer->Message == NULL)
     {
+        //
+        // Scripts with errors are not cached (the error message should
+        // be shown again)
+        //
+        ScriptEngineCompiledCacheInsert(Hash, Source, SymbolBuffer);
+
         return SymbolBuffer;
     }
     else
@@ -301,18 +479,14 @@ PrintSymbolBufferWrapper(PVOID SymbolBuffer)
 }
 
 /**
- * @brief test function
- * @param GuestRegs
- * @param Expr
+ * @brief Allocate the holders of the variables and the scratch memory
+ * of the scripts that are executed in user-mode
  *
  * @return VOID
  */
-VOID
-ScriptEngineEvalWrapper(PGUEST_REGS GuestRegs,
-                        string      Expr)
+static VOID
+ScriptEngineWrapperAllocateVariables()
 {
-    SCRIPT_ENGINE_VARIABLES_LIST VariablesList = {0};
-
     //
     // Allocate global variables holder
     //
@@ -344,6 +518,33 @@ ScriptEngineEvalWrapper(PGUEST_REGS GuestRegs,
         RtlZeroMemory(g_ScriptTempVariables, MAX_TEMP_COUNT * sizeof(UINT64));
     }
 
+    //
+    // Allocate the scratch memory holder, buffers of the scratch memory are
+    // only valid in a single script
+    //
+    if (!g_ScriptScratchArena)
+    {
+        g_ScriptScratchArena = (BYTE *)malloc(DebuggerScriptEngineScratchArenaSize);
+    }
+}
+
+/**
+ * @brief test function
+ * @param GuestRegs
+ * @param Expr
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineEvalWrapper(PGUEST_REGS GuestRegs,
+                        string      Expr)
+{
+    SCRIPT_ENGINE_VARIABLES_LIST VariablesList = {0};
+
+    ScriptEngineWrapperAllocateVariables();
+
+    g_ScriptScratchUsed = 0;
+
     //
     // Run Parser
     //
@@ -596,6 +797,206 @@ ScriptEngineWrapperTestParser(const string & Expr)
     free(AllocationsForCastings.Buff6);
 }
 
+#ifdef _DEBUG
+
+/**
+ * @brief The allocation hook of the benchmark of the script engine
+ *
+ * @return int
+ */
+static int
+ScriptEngineBenchmarkAllocationHook(int                   AllocationType,
+                                    void *                UserData,
+                                    size_t                Size,
+                                    int                   BlockType,
+                                    long                  RequestNumber,
+                                    const unsigned char * FileName,
+                                    int                   LineNumber)
+{
+    UNREFERENCED_PARAMETER(UserData);
+    UNREFERENCED_PARAMETER(Size);
+    UNREFERENCED_PARAMETER(BlockType);
+    UNREFERENCED_PARAMETER(RequestNumber);
+    UNREFERENCED_PARAMETER(FileName);
+    UNREFERENCED_PARAMETER(LineNumber);
+
+    if (AllocationType != _HOOK_FREE)
+    {
+        InterlockedIncrement64(&g_ScriptEngineBenchmarkAllocations);
+    }
+
+    return TRUE;
+}
+
+#endif // _DEBUG
+
+/**
+ * @brief Benchmark of parsing and executing the scripts in user-mode
+ * @details each script of the corpus is parsed and then executed for the
+ * iterations with the synthetic registers, the results are the time of
+ * parsing, the time of each run, the time of each operator and the count
+ * of the heap allocations (the allocations are only counted in the debug
+ * builds)
+ *
+ * @param Iterations Iterations of running each script
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineWrapperBenchmark(UINT32 Iterations)
+{
+    SCRIPT_ENGINE_VARIABLES_LIST VariablesList = {0};
+    ACTION_BUFFER                ActionBuffer  = {0};
+    SYMBOL                       ErrorSymbol   = {0};
+    GUEST_REGS                   GuestRegs     = {0};
+    PSYMBOL_BUFFER               CodeBuffer;
+    LARGE_INTEGER                Frequency;
+    LARGE_INTEGER                Start;
+    LARGE_INTEGER                End;
+    UINT64                       Operators;
+    LONG64                       ParseAllocations;
+    LONG64                       RunAllocations;
+    double                       ParseTime;
+    double                       RunTime;
+    double                       TotalRunTime   = 0;
+    UINT64                       TotalOperators = 0;
+    BOOLEAN                      HasError;
+    char                         Buffer[]  = "Hello world !";
+    wchar_t                      BufferW[] = L"A B C D E F G H I J K L M N O P Q R S T U V W X Y Z";
+    UINT64                       Stack[0x20];
+
+    ScriptEngineWrapperAllocateVariables();
+
+    VariablesList.TempList            = g_ScriptTempVariables;
+    VariablesList.GlobalVariablesList = g_ScriptGlobalVariables;
+    VariablesList.LocalVariablesList  = g_ScriptLocalVariables;
+
+    for (UINT32 i = 0; i < _countof(Stack); i++)
+    {
+        Stack[i] = (UINT64)&Stack[(i + 1) % _countof(Stack)];
+    }
+
+    GuestRegs.rax = 0x1;
+    GuestRegs.rbx = 0x4;
+    GuestRegs.rcx = 0x5;
+    GuestRegs.rdx = 0x3;
+    GuestRegs.rsp = (UINT64)Stack;
+    GuestRegs.r14 = (UINT64)BufferW;
+    GuestRegs.r15 = (UINT64)Buffer;
+
+    QueryPerformanceFrequency(&Frequency);
+
+#ifdef _DEBUG
+    _CRT_ALLOC_HOOK PreviousHook = _CrtSetAllocHook(ScriptEngineBenchmarkAllocationHook);
+
+    ShowMessages("benchmarking the script engine (%x iterations of each script)\n\n", Iterations);
+#else
+    ShowMessages("benchmarking the script engine (%x iterations of each script), "
+                 "allocations are only counted in the debug builds\n\n",
+                 Iterations);
+#endif // _DEBUG
+
+    for (UINT32 Index = 0; Index < _countof(g_ScriptEngineBenchmarkCorpus); Index++)
+    {
+        ShowMessages("[%d] %s\n", Index, g_ScriptEngineBenchmarkCorpus[Index]);
+
+        //
+        // Parse the script
+        //
+        g_ScriptEngineBenchmarkAllocations = 0;
+        CodeBuffer                         = NULL;
+
+        QueryPerformanceCounter(&Start);
+
+        for (UINT32 i = 0; i < SCRIPT_ENGINE_BENCHMARK_PARSE_ITERATIONS; i++)
+        {
+            if (CodeBuffer != NULL)
+            {
+                RemoveSymbolBuffer(CodeBuffer);
+            }
+
+            CodeBuffer = ScriptEngineParse((char *)g_ScriptEngineBenchmarkCorpus[Index]);
+        }
+
+        QueryPerformanceCounter(&End);
+
+        ParseAllocations = g_ScriptEngineBenchmarkAllocations;
+        ParseTime        = (double)(End.QuadPart - Start.QuadPart) * 1e9 / Frequency.QuadPart / SCRIPT_ENGINE_BENCHMARK_PARSE_ITERATIONS;
+
+        if (CodeBuffer->Message != NULL)
+        {
+            ShowMessages("    err, %s\n", CodeBuffer->Message);
+            RemoveSymbolBuffer(CodeBuffer);
+            continue;
+        }
+
+        //
+        // Run the script
+        //
+        g_ScriptEngineBenchmarkAllocations = 0;
+        Operators                          = 0;
+        HasError                           = FALSE;
+
+        QueryPerformanceCounter(&Start);
+
+        for (UINT32 j = 0; j < Iterations && !HasError; j++)
+        {
+            g_ScriptScratchUsed = 0;
+
+            for (int i = 0; i < CodeBuffer->Pointer;)
+            {
+                Operators++;
+
+                if (ScriptEngineExecute(&GuestRegs,
+                                        &ActionBuffer,
+                                        &VariablesList,
+                                        CodeBuffer,
+                                        &i,
+                                        &ErrorSymbol) == TRUE)
+                {
+                    HasError = TRUE;
+                    break;
+                }
+            }
+        }
+
+        QueryPerformanceCounter(&End);
+
+        RunAllocations = g_ScriptEngineBenchmarkAllocations;
+        RunTime        = (double)(End.QuadPart - Start.QuadPart) * 1e9 / Frequency.QuadPart;
+
+        RemoveSymbolBuffer(CodeBuffer);
+
+        if (HasError)
+        {
+            CHAR NameOfOperator[MAX_FUNCTION_NAME_LENGTH] = {0};
+
+            ScriptEngineGetOperatorName(&ErrorSymbol, NameOfOperator);
+            ShowMessages("    err, invalid returning address for operator: %s\n", NameOfOperator);
+            continue;
+        }
+
+        ShowMessages("    parse: %.1f ns (%.1f allocations), run: %.1f ns (%llu operators, %.2f ns per operator), "
+                     "allocations per run: %.2f\n",
+                     ParseTime,
+                     (double)ParseAllocations / SCRIPT_ENGINE_BENCHMARK_PARSE_ITERATIONS,
+                     RunTime / Iterations,
+                     Operators / Iterations,
+                     Operators != 0 ? RunTime / Operators : 0,
+                     (double)RunAllocations / Iterations);
+
+        TotalRunTime += RunTime;
+        TotalOperators += Operators;
+    }
+
+#ifdef _DEBUG
+    _CrtSetAllocHook(PreviousHook);
+#endif // _DEBUG
+
+    ShowMessages("\naverage time of each operator: %.2f ns\n",
+                 TotalOperators != 0 ? TotalRunTime / TotalOperators : 0);
+}
+
 /**
  * @brief In the local debugging (VMI mode) environment, this function computes the expressions
  * @details for example, if the user u ExAllocatePoolWithTag+0x10 this will evaluate the expr
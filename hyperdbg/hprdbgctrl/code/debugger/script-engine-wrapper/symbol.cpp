@@ -15,13 +15,15 @@
 //
 // Global Variables
 //
-extern PMODULE_SYMBOL_DETAIL                        g_SymbolTable;
-extern UINT32                                       g_SymbolTableSize;
-extern UINT32                                       g_SymbolTableCurrentIndex;
-extern BOOLEAN                                      g_IsExecutingSymbolLoadingRoutines;
-extern BOOLEAN                                      g_IsSerialConnectedToRemoteDebugger;
-extern BOOLEAN                                      g_AddressConversion;
-extern std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION> g_DisassemblerSymbolMap;
+extern PMODULE_SYMBOL_DETAIL                   g_SymbolTable;
+extern UINT32                                  g_SymbolTableSize;
+extern UINT32                                  g_SymbolTableCurrentIndex;
+extern UINT32                                  g_SymbolTableCapacity;
+extern BOOLEAN                                 g_IsExecutingSymbolLoadingRoutines;
+extern BOOLEAN                                 g_IsSerialConnectedToRemoteDebugger;
+extern BOOLEAN                                 g_AddressConversion;
+extern std::vector<LOCAL_FUNCTION_DESCRIPTION> g_DisassemblerSymbolMap;
+extern std::vector<CHAR>                       g_DisassemblerSymbolNames;
 
 using namespace std;
 
@@ -91,23 +93,27 @@ SymbolCreateDisassemblerMapCallback(UINT64       Address,
                                     char *       ObjectName,
                                     unsigned int ObjectSize)
 {
-    //
-    // It has a string, should not be initialized with zero
-    //
-    LOCAL_FUNCTION_DESCRIPTION LocalFunctionDescription = {};
-    string                     FinalModuleName          = "";
+    LOCAL_FUNCTION_DESCRIPTION LocalFunctionDescription = {0};
 
     if (ObjectSize == 0)
     {
         ObjectSize = DISASSEMBLY_MAXIMUM_DISTANCE_FROM_OBJECT_NAME;
     }
 
+    //
+    // Create the structure, the name is appended to the pool of names
+    //
+    LocalFunctionDescription.Address          = Address;
+    LocalFunctionDescription.ObjectSize       = ObjectSize;
+    LocalFunctionDescription.ObjectNameOffset = (UINT32)g_DisassemblerSymbolNames.size();
+
     //
     // Convert module name to string
     //
     if (ModuleName != NULL)
     {
-        FinalModuleName += std::string(ModuleName) + "!";
+        g_DisassemblerSymbolNames.insert(g_DisassemblerSymbolNames.end(), ModuleName, ModuleName + strlen(ModuleName));
+        g_DisassemblerSymbolNames.push_back('!');
     }
 
     //
@@ -115,19 +121,15 @@ SymbolCreateDisassemblerMapCallback(UINT64       Address,
     //
     if (ObjectName != NULL)
     {
-        FinalModuleName += std::string(ObjectName);
+        g_DisassemblerSymbolNames.insert(g_DisassemblerSymbolNames.end(), ObjectName, ObjectName + strlen(ObjectName));
     }
 
-    //
-    // Create the structure
-    //
-    LocalFunctionDescription.ObjectName = std::move(FinalModuleName);
-    LocalFunctionDescription.ObjectSize = ObjectSize;
+    g_DisassemblerSymbolNames.push_back('\0');
 
     //
-    // Add to disassembler map
+    // Add to disassembler map (it's sorted once all the symbols are added)
     //
-    g_DisassemblerSymbolMap[Address] = LocalFunctionDescription;
+    g_DisassemblerSymbolMap.push_back(LocalFunctionDescription);
 }
 
 /**
@@ -138,19 +140,112 @@ SymbolCreateDisassemblerMapCallback(UINT64       Address,
 BOOLEAN
 SymbolCreateDisassemblerSymbolMap()
 {
+    size_t SavedCount = 0;
+
     //
     // Clear the map table
     //
     g_DisassemblerSymbolMap.clear();
+    g_DisassemblerSymbolNames.clear();
 
     //
     // Get all the symbols in the callback
     //
     ScriptEngineCreateSymbolTableForDisassemblerWrapper(SymbolCreateDisassemblerMapCallback);
 
+    //
+    // Sort the entries by their addresses, the sort is stable so the entries
+    // of a same address remain in the order of their enumeration
+    //
+    std::stable_sort(g_DisassemblerSymbolMap.begin(),
+                     g_DisassemblerSymbolMap.end(),
+                     [](const LOCAL_FUNCTION_DESCRIPTION & First, const LOCAL_FUNCTION_DESCRIPTION & Second) {
+                         return First.Address < Second.Address;
+                     });
+
+    //
+    // Only keep the last enumerated entry of each address
+    //
+    for (size_t i = 0; i < g_DisassemblerSymbolMap.size(); i++)
+    {
+        if (i + 1 < g_DisassemblerSymbolMap.size() &&
+            g_DisassemblerSymbolMap[i + 1].Address == g_DisassemblerSymbolMap[i].Address)
+        {
+            continue;
+        }
+
+        g_DisassemblerSymbolMap[SavedCount++] = g_DisassemblerSymbolMap[i];
+    }
+
+    g_DisassemblerSymbolMap.resize(SavedCount);
+    g_DisassemblerSymbolMap.shrink_to_fit();
+    g_DisassemblerSymbolNames.shrink_to_fit();
+
     return TRUE;
 }
 
+/**
+ * @brief Find the nearest object that starts before (or at) the address
+ * @param Address
+ *
+ * @return PLOCAL_FUNCTION_DESCRIPTION The entry or NULL if the address is
+ * below the lowest entry in symbol table
+ */
+PLOCAL_FUNCTION_DESCRIPTION
+SymbolFindNearestDisassemblerSymbol(UINT64 Address)
+{
+    std::vector<LOCAL_FUNCTION_DESCRIPTION>::iterator Upper;
+
+    //
+    // Find the first entry after the address, the previous entry is the
+    // nearest object that starts before (or at) the address
+    //
+    Upper = std::upper_bound(g_DisassemblerSymbolMap.begin(),
+                             g_DisassemblerSymbolMap.end(),
+                             Address,
+                             [](UINT64 Address, const LOCAL_FUNCTION_DESCRIPTION & Entry) {
+                                 return Address < Entry.Address;
+                             });
+
+    if (Upper == g_DisassemblerSymbolMap.begin())
+    {
+        return NULL;
+    }
+
+    return &*std::prev(Upper);
+}
+
+/**
+ * @brief Find the object that starts exactly at the address
+ * @param Address
+ *
+ * @return PLOCAL_FUNCTION_DESCRIPTION The entry or NULL if not found
+ */
+PLOCAL_FUNCTION_DESCRIPTION
+SymbolFindDisassemblerSymbol(UINT64 Address)
+{
+    PLOCAL_FUNCTION_DESCRIPTION Entry = SymbolFindNearestDisassemblerSymbol(Address);
+
+    if (Entry == NULL || Entry->Address != Address)
+    {
+        return NULL;
+    }
+
+    return Entry;
+}
+
+/**
+ * @brief Get the name of an object of the symbol table for disassembler
+ * @param FunctionDescription
+ *
+ * @return const CHAR *
+ */
+const CHAR *
+SymbolGetDisassemblerSymbolName(PLOCAL_FUNCTION_DESCRIPTION FunctionDescription)
+{
+    return &g_DisassemblerSymbolNames[FunctionDescription->ObjectNameOffset];
+}
+
 /**
  * @brief shows the functions' name for the disassembler
  * @param Address
@@ -161,8 +256,8 @@ SymbolCreateDisassemblerSymbolMap()
 BOOLEAN
 SymbolShowFunctionNameBasedOnAddress(UINT64 Address, PUINT64 UsedBaseAddress)
 {
-    std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION>::iterator Low, Prev;
-    UINT64                                                 Pos = Address;
+    PLOCAL_FUNCTION_DESCRIPTION Prev;
+    UINT64                      Diff;
 
     //
     // Check if showing function (object) names is not prohibited
@@ -176,75 +271,67 @@ SymbolShowFunctionNameBasedOnAddress(UINT64 Address, PUINT64 UsedBaseAddress)
     //
     // Check if we already built the symbol map for disassembler or not
     //
-    if (!g_DisassemblerSymbolMap.empty())
+    if (g_DisassemblerSymbolMap.empty())
     {
-        Low = g_DisassemblerSymbolMap.lower_bound(Pos);
+        return FALSE;
+    }
 
-        if (Low == g_DisassemblerSymbolMap.end())
-        {
-            //
-            // Nothing found, maybe use rbegin()
-            //
-            return FALSE;
-        }
-        else if (Low == g_DisassemblerSymbolMap.begin() && Low->first > Address)
+    Prev = SymbolFindNearestDisassemblerSymbol(Address);
+
+    if (Prev == NULL)
+    {
+        //
+        // Nothing to do, address is below the lowest entry in symbol table
+        //
+        return FALSE;
+    }
+    else if (Prev->Address == Address)
+    {
+        if (*UsedBaseAddress != Address)
         {
-            //
-            // Nothing to do, address is below the lowest entry in symbol table
-            //
-            return FALSE;
+            ShowMessages("%s", SymbolGetDisassemblerSymbolName(Prev));
+            *UsedBaseAddress = Address;
+            return TRUE;
         }
-        else if (Low->first == Address)
-        {
-            if (*UsedBaseAddress != Address)
-            {
-                ShowMessages("%s", Low->second.ObjectName.c_str());
-                *UsedBaseAddress = Address;
-                return TRUE;
-            }
 
-            return FALSE;
-        }
-        else
-        {
-            Prev        = std::prev(Low);
-            UINT64 Diff = Address - Prev->first;
+        return FALSE;
+    }
 
-            //
-            // Check, so we have a threshold boundary to add +xx to the
-            // symbols function name, in otherwords, the maximum number of
-            // bytes that a function could contain (it's definitely not the
-            // best option to find start and end of function, it's an approximate
-            // and not always might be true)
-            //
-            if (Prev->second.ObjectSize >= Diff)
-            {
-                if (*UsedBaseAddress != Prev->first)
-                {
-                    ShowMessages("%s+0x%x", Prev->second.ObjectName.c_str(), Diff);
-                    *UsedBaseAddress = Prev->first;
-                    return TRUE;
-                }
+    Diff = Address - Prev->Address;
 
-                return FALSE;
-            }
-            else if (DISASSEMBLY_MAXIMUM_DISTANCE_FROM_OBJECT_NAME >= Diff)
-            {
-                //
-                // We add the logic of adding Name+X+X to show that a address is x bytes
-                // after the Object Name and not within the size of the function but x
-                // bytes from the above of the function
-                //
-                if (*UsedBaseAddress != Prev->first)
-                {
-                    ShowMessages("%s+0x%x+0x%x", Prev->second.ObjectName.c_str(), Diff, Diff - Prev->second.ObjectSize);
-                    *UsedBaseAddress = Prev->first;
-                    return TRUE;
-                }
+    //
+    // Check, so we have a threshold boundary to add +xx to the
+    // symbols function name, in otherwords, the maximum number of
+    // bytes that a function could contain (it's definitely not the
+    // best option to find start and end of function, it's an approximate
+    // and not always might be true)
+    //
+    if (Prev->ObjectSize >= Diff)
+    {
+        if (*UsedBaseAddress != Prev->Address)
+        {
+            ShowMessages("%s+0x%x", SymbolGetDisassemblerSymbolName(Prev), Diff);
+            *UsedBaseAddress = Prev->Address;
+            return TRUE;
+        }
 
-                return FALSE;
-            }
+        return FALSE;
+    }
+    else if (DISASSEMBLY_MAXIMUM_DISTANCE_FROM_OBJECT_NAME >= Diff)
+    {
+        //
+        // We add the logic of adding Name+X+X to show that a address is x bytes
+        // after the Object Name and not within the size of the function but x
+        // bytes from the above of the function
+        //
+        if (*UsedBaseAddress != Prev->Address)
+        {
+            ShowMessages("%s+0x%x+0x%x", SymbolGetDisassemblerSymbolName(Prev), Diff, Diff - Prev->ObjectSize);
+            *UsedBaseAddress = Prev->Address;
+            return TRUE;
         }
+
+        return FALSE;
     }
 
     //
@@ -253,6 +340,30 @@ SymbolShowFunctionNameBasedOnAddress(UINT64 Address, PUINT64 UsedBaseAddress)
     return FALSE;
 }
 
+/**
+ * @brief Find the function (object) that contains the address
+ * @param Address
+ * @param FunctionAddress The start address of the function
+ * @param FunctionName The name of the function
+ *
+ * @return BOOLEAN Whether the address is within the size of a function or not
+ */
+BOOLEAN
+SymbolQueryFunctionOfAddress(UINT64 Address, PUINT64 FunctionAddress, std::string & FunctionName)
+{
+    PLOCAL_FUNCTION_DESCRIPTION Entry = SymbolFindNearestDisassemblerSymbol(Address);
+
+    if (Entry == NULL || Address - Entry->Address > Entry->ObjectSize)
+    {
+        return FALSE;
+    }
+
+    *FunctionAddress = Entry->Address;
+    FunctionName     = SymbolGetDisassemblerSymbolName(Entry);
+
+    return TRUE;
+}
+
 /**
  * @brief Build and show symbol table details
  * @param BuildLocalSymTable Should this function call to build local symbol
@@ -436,6 +547,7 @@ SymbolDeleteSymTable()
         g_SymbolTable             = NULL;
         g_SymbolTableSize         = NULL;
         g_SymbolTableCurrentIndex = 0;
+        g_SymbolTableCapacity     = 0;
         return TRUE;
     }
     else
@@ -444,6 +556,129 @@ SymbolDeleteSymTable()
     }
 }
 
+/**
+ * @brief Get the root path of the system (e.g., c:\windows)
+ * @param SystemRootString The (lower-case) root path without system32
+ *
+ * @return BOOLEAN shows whether the operation was successful or not
+ */
+BOOLEAN
+SymbolGetSystemRoot(string & SystemRootString)
+{
+    char SystemRoot[MAX_PATH] = {0};
+
+    if (GetSystemDirectoryA(SystemRoot, MAX_PATH) == NULL)
+    {
+        ShowMessages("err, unable to get system directory (%x)\n",
+                     GetLastError());
+
+        return FALSE;
+    }
+
+    SystemRootString = SystemRoot;
+
+    //
+    // Convert root path to lower-case
+    //
+    transform(SystemRootString.begin(),
+              SystemRootString.end(),
+              SystemRootString.begin(),
+              [](unsigned char c) { return std::tolower(c); });
+
+    //
+    // Remove system32 from the root
+    //
+    Replace(SystemRootString, "\\system32", "");
+
+    return TRUE;
+}
+
+/**
+ * @brief Convert the (NT) path of a kernel module to a path that is
+ * accessible from the user-mode
+ *
+ * @param ModulePath The path of the module which is converted
+ * @param SystemRootString The root path of the system
+ *
+ * @return VOID
+ */
+VOID
+SymbolConvertKernelModulePath(string & ModulePath, const string & SystemRootString)
+{
+    if (ModulePath.rfind("\\SystemRoot\\", 0) == 0)
+    {
+        //
+        // Path starts with \SystemRoot\
+        // we should change it to the real system root
+        // path
+        //
+        Replace(ModulePath, "\\SystemRoot", SystemRootString);
+    }
+    else if (ModulePath.rfind("\\??\\", 0) == 0)
+    {
+        //
+        // Path starts with \??\ (e.g., \??\c:\driver.sys)
+        //
+        ModulePath.erase(0, strlen("\\??\\"));
+    }
+    else if (ModulePath.rfind("\\Device\\", 0) == 0)
+    {
+        //
+        // Path starts with a device name, it's accessible
+        // through the global root
+        //
+        ModulePath.insert(0, "\\\\?\\GLOBALROOT");
+    }
+}
+
+/**
+ * @brief Fill the symbol details of a module
+ *
+ * @param ModulePath The (user-mode accessible) path of the module
+ * @param BaseAddress The base address of the module
+ * @param IsUserMode Whether the module is a user-mode module or not
+ * @param ModuleSymbolDetail The (zeroed) structure to fill
+ *
+ * @return BOOLEAN shows whether the pdb details of the module are found or not
+ */
+BOOLEAN
+SymbolBuildModuleSymbolDetail(const char *          ModulePath,
+                              UINT64                BaseAddress,
+                              BOOLEAN               IsUserMode,
+                              PMODULE_SYMBOL_DETAIL ModuleSymbolDetail)
+{
+    char ModuleSymbolPath[MAX_PATH]                        = {0};
+    char ModuleSymbolGuidAndAge[MAXIMUM_GUID_AND_AGE_SIZE] = {0};
+
+    ModuleSymbolDetail->BaseAddress = BaseAddress;
+    ModuleSymbolDetail->IsUserMode  = IsUserMode;
+    strncpy(ModuleSymbolDetail->FilePath, ModulePath, MAX_PATH - 1);
+
+    //
+    // Read symbol signature details
+    //
+    if (!ScriptEngineConvertFileToPdbFileAndGuidAndAgeDetailsWrapper(ModulePath, ModuleSymbolPath, ModuleSymbolGuidAndAge))
+    {
+        ModuleSymbolDetail->IsSymbolDetailsFound = FALSE;
+        return FALSE;
+    }
+
+    ModuleSymbolDetail->IsSymbolDetailsFound = TRUE;
+    memcpy(ModuleSymbolDetail->ModuleSymbolGuidAndAge, ModuleSymbolGuidAndAge, MAXIMUM_GUID_AND_AGE_SIZE);
+    memcpy(ModuleSymbolDetail->ModuleSymbolPath, ModuleSymbolPath, MAX_PATH);
+
+    //
+    // Check if pdb file name is a real path or a module name
+    //
+    string ModuleSymbolPathString(ModuleSymbolPath);
+    if (ModuleSymbolPathString.find(":\\") != std::string::npos)
+        ModuleSymbolDetail->IsLocalSymbolPath = TRUE;
+    else
+        ModuleSymbolDetail->IsLocalSymbolPath = FALSE;
+
+    return TRUE;
+}
+
 /**
  * @brief make the initial packet required for symbol server
  * or reload packet
@@ -467,19 +702,16 @@ SymbolBuildSymbolTable(PMODULE_SYMBOL_DETAIL * BufferToStoreDetails,
     NTSTATUS                        NtStatus;
     BOOLEAN                         Status;
     ULONG                           ReturnedLength;
-    PMODULE_SYMBOL_DETAIL           ModuleSymDetailArray                              = NULL;
-    char                            SystemRoot[MAX_PATH]                              = {0};
-    char                            ModuleSymbolPath[MAX_PATH]                        = {0};
-    char                            TempPath[MAX_PATH]                                = {0};
-    char                            ModuleSymbolGuidAndAge[MAXIMUM_GUID_AND_AGE_SIZE] = {0};
-    BOOLEAN                         IsSymbolPdbDetailAvailable                        = FALSE;
-    BOOLEAN                         IsFreeUsermodeModulesBuffer                       = FALSE;
-    ULONG                           SysModuleInfoBufferSize                           = 0;
-    UINT32                          ModuleDetailsSize                                 = 0;
-    UINT32                          ModulesCount                                      = 0;
-    PUSERMODE_LOADED_MODULE_DETAILS ModuleDetailsRequest                              = NULL;
-    PUSERMODE_LOADED_MODULE_SYMBOLS Modules                                           = NULL;
-    USERMODE_LOADED_MODULE_DETAILS  ModuleCountRequest                                = {0};
+    string                          SystemRootString;
+    PMODULE_SYMBOL_DETAIL           ModuleSymDetailArray        = NULL;
+    char                            TempPath[MAX_PATH]          = {0};
+    BOOLEAN                         IsFreeUsermodeModulesBuffer = FALSE;
+    ULONG                           SysModuleInfoBufferSize     = 0;
+    UINT32                          ModuleDetailsSize           = 0;
+    UINT32                          ModulesCount                = 0;
+    PUSERMODE_LOADED_MODULE_DETAILS ModuleDetailsRequest        = NULL;
+    PUSERMODE_LOADED_MODULE_SYMBOLS Modules                     = NULL;
+    USERMODE_LOADED_MODULE_DETAILS  ModuleCountRequest          = {0};
 
     //
     // Check if we found an already built symbol table
@@ -489,29 +721,11 @@ SymbolBuildSymbolTable(PMODULE_SYMBOL_DETAIL * BufferToStoreDetails,
     //
     // Get system root
     //
-    if (GetSystemDirectoryA(SystemRoot, MAX_PATH) == NULL)
+    if (!SymbolGetSystemRoot(SystemRootString))
     {
-        ShowMessages("err, unable to get system directory (%x)\n",
-                     GetLastError());
-
         return FALSE;
     }
 
-    string SystemRootString(SystemRoot);
-
-    //
-    // Convert root path to lower-case
-    //
-    transform(SystemRootString.begin(),
-              SystemRootString.end(),
-              SystemRootString.begin(),
-              [](unsigned char c) { return std::tolower(c); });
-
-    //
-    // Remove system32 from the root
-    //
-    Replace(SystemRootString, "\\system32", "");
-
     //
     // *****************************************************************
     //              Get kernel-mode modules information
@@ -736,70 +950,16 @@ SymbolBuildSymbolTable(PMODULE_SYMBOL_DETAIL * BufferToStoreDetails,
                          Modules[i].FilePath);
                          */
 
-            //
-            // Read symbol signature details
-            //
-            RtlZeroMemory(ModuleSymbolPath, sizeof(ModuleSymbolPath));
-            RtlZeroMemory(TempPath, sizeof(TempPath));
-            RtlZeroMemory(ModuleSymbolGuidAndAge, sizeof(ModuleSymbolGuidAndAge));
-
             //
             // Convert symbol path from unicode to ascii
             //
+            RtlZeroMemory(TempPath, sizeof(TempPath));
             wcstombs(TempPath, Modules[i].FilePath, MAX_PATH);
 
-            if (ScriptEngineConvertFileToPdbFileAndGuidAndAgeDetailsWrapper(
-                    TempPath,
-                    ModuleSymbolPath,
-                    ModuleSymbolGuidAndAge))
-            {
-                IsSymbolPdbDetailAvailable = TRUE;
-
-                // ShowMessages("Hash : %s , Symbol path : %s\n", ModuleSymbolGuidAndAge, ModuleSymbolPath);
-            }
-            else
-            {
-                IsSymbolPdbDetailAvailable = FALSE;
-
-                // ShowMessages("err, unable to get module pdb details\n");
-            }
-
             //
             // Build the structure for this module
             //
-            ModuleSymDetailArray[i].BaseAddress = Modules[i].BaseAddress;
-            ModuleSymDetailArray[i].IsUserMode  = TRUE;
-            memcpy(ModuleSymDetailArray[i].FilePath, TempPath, strlen(TempPath));
-
-            if (IsSymbolPdbDetailAvailable)
-            {
-                ModuleSymDetailArray[i].IsSymbolDetailsFound = TRUE;
-                memcpy(ModuleSymDetailArray[i].ModuleSymbolGuidAndAge, ModuleSymbolGuidAndAge, MAXIMUM_GUID_AND_AGE_SIZE);
-                memcpy(ModuleSymDetailArray[i].ModuleSymbolPath, ModuleSymbolPath, MAX_PATH);
-
-                //
-                // Check if pdb file name is a real path or a module name
-                //
-                string ModuleSymbolPathString(ModuleSymbolPath);
-                if (ModuleSymbolPathString.find(":\\") != std::string::npos)
-                    ModuleSymDetailArray[i].IsLocalSymbolPath = TRUE;
-                else
-                    ModuleSymDetailArray[i].IsLocalSymbolPath = FALSE;
-            }
-            else
-            {
-                ModuleSymDetailArray[i].IsSymbolDetailsFound = FALSE;
-            }
-
-            //
-            // Check if it should be send to the remote debugger over serial
-            // and also make sure that we're connected to the remote debugger
-            // and this is a debuggee
-            //
-            if (SendOverSerial)
-            {
-                KdSendSymbolDetailPacket(&ModuleSymDetailArray[i], i, ModuleInfo->NumberOfModules + ModulesCount);
-            }
+            SymbolBuildModuleSymbolDetail(TempPath, Modules[i].BaseAddress, TRUE, &ModuleSymDetailArray[i]);
         }
     }
 
@@ -811,86 +971,32 @@ SymbolBuildSymbolTable(PMODULE_SYMBOL_DETAIL * BufferToStoreDetails,
 
     for (int i = 0; i < ModuleInfo->NumberOfModules; i++)
     {
-        UINT32 IndexInSymbolBuffer = ModulesCount + i;
-
-        auto PathName = ModuleInfo->Modules[i].FullPathName + ModuleInfo->Modules[i].OffsetToFileName;
-
-        //
-        // Read symbol signature details
-        //
-        RtlZeroMemory(ModuleSymbolPath, sizeof(ModuleSymbolPath));
-        RtlZeroMemory(ModuleSymbolGuidAndAge, sizeof(ModuleSymbolGuidAndAge));
-
         string ModuleFullPath((const char *)ModuleInfo->Modules[i].FullPathName);
 
-        if (ModuleFullPath.rfind("\\SystemRoot\\", 0) == 0)
-        {
-            //
-            // Path starts with \SystemRoot\
-            // we should change it to the real system root
-            // path
-            //
-            Replace(ModuleFullPath, "\\SystemRoot", SystemRootString);
-        }
-
-        if (ScriptEngineConvertFileToPdbFileAndGuidAndAgeDetailsWrapper(ModuleFullPath.c_str(), ModuleSymbolPath, ModuleSymbolGuidAndAge))
-        {
-            IsSymbolPdbDetailAvailable = TRUE;
-
-            //
-            // ShowMessages("Hash : %s , Symbol path : %s\n", ModuleSymbolGuidAndAge, ModuleSymbolPath);
-            //
-        }
-        else
-        {
-            IsSymbolPdbDetailAvailable = FALSE;
-
-            //
-            // ShowMessages("err, unable to get module pdb details\n");
-            //
-        }
-
         //
         // Build the structure for this module
         //
-        ModuleSymDetailArray[IndexInSymbolBuffer].BaseAddress = (UINT64)ModuleInfo->Modules[i].ImageBase;
-        memcpy(ModuleSymDetailArray[IndexInSymbolBuffer].FilePath, ModuleFullPath.c_str(), ModuleFullPath.size());
-
-        if (IsSymbolPdbDetailAvailable)
-        {
-            ModuleSymDetailArray[IndexInSymbolBuffer].IsSymbolDetailsFound = TRUE;
-            memcpy(ModuleSymDetailArray[IndexInSymbolBuffer].ModuleSymbolGuidAndAge, ModuleSymbolGuidAndAge, MAXIMUM_GUID_AND_AGE_SIZE);
-            memcpy(ModuleSymDetailArray[IndexInSymbolBuffer].ModuleSymbolPath, ModuleSymbolPath, MAX_PATH);
-
-            //
-            // Check if pdb file name is a real path or a module name
-            //
-            string ModuleSymbolPathString(ModuleSymbolPath);
-            if (ModuleSymbolPathString.find(":\\") != std::string::npos)
-                ModuleSymDetailArray[IndexInSymbolBuffer].IsLocalSymbolPath = TRUE;
-            else
-                ModuleSymDetailArray[IndexInSymbolBuffer].IsLocalSymbolPath = FALSE;
-        }
-        else
-        {
-            ModuleSymDetailArray[IndexInSymbolBuffer].IsSymbolDetailsFound = FALSE;
-        }
-
-        //
-        // Check if it should be send to the remote debugger over serial
-        // and also make sure that we're connected to the remote debugger
-        // and this is a debuggee
-        //
-        if (SendOverSerial)
-        {
-            KdSendSymbolDetailPacket(&ModuleSymDetailArray[IndexInSymbolBuffer], i, ModuleInfo->NumberOfModules + ModulesCount);
-        }
+        SymbolConvertKernelModulePath(ModuleFullPath, SystemRootString);
+        SymbolBuildModuleSymbolDetail(ModuleFullPath.c_str(),
+                                      (UINT64)ModuleInfo->Modules[i].ImageBase,
+                                      FALSE,
+                                      &ModuleSymDetailArray[ModulesCount + i]);
     }
 
     //
     // ----------------------------------------------------------------------------------
     //
 
+    //
+    // Check if it should be send to the remote debugger over serial
+    // and also make sure that we're connected to the remote debugger
+    // and this is a debuggee, the details are sent in batches
+    //
+    if (SendOverSerial)
+    {
+        KdSendSymbolDetailPackets(ModuleSymDetailArray, ModuleInfo->NumberOfModules + ModulesCount);
+    }
+
     //
     // Store the buffer and length of module symbols details
     //
@@ -907,64 +1013,105 @@ SymbolBuildSymbolTable(PMODULE_SYMBOL_DETAIL * BufferToStoreDetails,
     return TRUE;
 }
 
+/**
+ * @brief Make sure the symbol table has room for the needed count of symbol details
+ *
+ * @param NeededCapacity The minimum count of symbol details in the symbol table
+ *
+ * @return BOOLEAN shows whether the operation was successful or not
+ */
+static BOOLEAN
+SymbolReserveSymbolTable(UINT32 NeededCapacity)
+{
+    PMODULE_SYMBOL_DETAIL NewSymbolTable;
+    UINT32                NewCapacity;
+
+    if (g_SymbolTable != NULL && NeededCapacity <= g_SymbolTableCapacity)
+    {
+        return TRUE;
+    }
+
+    //
+    // Grow the buffer
+    //
+    NewCapacity = max(NeededCapacity, g_SymbolTableCapacity * 2);
+
+    NewSymbolTable = (PMODULE_SYMBOL_DETAIL)realloc(g_SymbolTable, NewCapacity * sizeof(MODULE_SYMBOL_DETAIL));
+
+    if (NewSymbolTable == NULL)
+    {
+        ShowMessages("err, unable to allocate memory for module list (%x)\n",
+                     GetLastError());
+        return FALSE;
+    }
+
+    //
+    // Make sure the new entries are zero
+    //
+    RtlZeroMemory(&NewSymbolTable[g_SymbolTableCurrentIndex],
+                  (NewCapacity - g_SymbolTableCurrentIndex) * sizeof(MODULE_SYMBOL_DETAIL));
+
+    g_SymbolTable         = NewSymbolTable;
+    g_SymbolTableCapacity = NewCapacity;
+
+    return TRUE;
+}
+
 /**
  * @brief Allocate (build) and update the symbol table whenever a debuggee is attached
  * on the debugger mode
+ * @details the symbol table grows as new symbol details are received
  *
- * @param SymbolDetail Pointer to a buffer that was received as the single
- * symbol info
+ * @param SymbolUpdatePacket Pointer to a buffer that was received as a batch
+ * of symbol details
  *
  * @return BOOLEAN shows whether the operation was successful or not
  */
 BOOLEAN
-SymbolBuildAndUpdateSymbolTable(PMODULE_SYMBOL_DETAIL SymbolDetail)
+SymbolBuildAndUpdateSymbolTable(PDEBUGGER_UPDATE_SYMBOL_TABLE SymbolUpdatePacket)
 {
+    UINT32 NeededCapacity = g_SymbolTableCurrentIndex + SymbolUpdatePacket->SymbolsCount;
+
     //
-    // Check to avoid overflow in symbol table
+    // Check if the packet is valid
     //
-    if (g_SymbolTableCurrentIndex >= MAXIMUM_SUPPORTED_SYMBOLS)
+    if (SymbolUpdatePacket->SymbolsCount == 0 ||
+        SymbolUpdatePacket->SymbolsCount > DEBUGGER_UPDATE_SYMBOL_TABLE_MAXIMUM_SYMBOLS_IN_PACKET)
     {
-        ShowMessages("err, the symbol table buffer is full, unable to add new symbol\n");
+        ShowMessages("err, the received symbol details are invalid\n");
         return FALSE;
     }
 
-    //
-    // Check if we found an already built symbol table
-    //
     if (g_SymbolTable == NULL)
     {
-        //
-        // Allocate Details buffer
-        //
-        g_SymbolTable = (PMODULE_SYMBOL_DETAIL)malloc(MAXIMUM_SUPPORTED_SYMBOLS * sizeof(MODULE_SYMBOL_DETAIL));
-
-        if (g_SymbolTable == NULL)
-        {
-            ShowMessages("err, unable to allocate memory for module list (%x)\n",
-                         GetLastError());
-            return FALSE;
-        }
-
         //
         // Reset the index
         //
         g_SymbolTableCurrentIndex = 0;
+        g_SymbolTableCapacity     = 0;
+        NeededCapacity            = SymbolUpdatePacket->SymbolsCount;
+    }
 
-        //
-        // Make sure buffer is zero
-        //
-        RtlZeroMemory(g_SymbolTable, MAXIMUM_SUPPORTED_SYMBOLS * sizeof(MODULE_SYMBOL_DETAIL));
+    //
+    // Check if we need a bigger buffer for the symbol table, the buffer
+    // grows at least to the total count of symbols of the debuggee
+    //
+    if (!SymbolReserveSymbolTable(max(NeededCapacity, SymbolUpdatePacket->TotalSymbols)))
+    {
+        return FALSE;
     }
 
     //
     // Move it to the new buffer
     //
-    memcpy(&g_SymbolTable[g_SymbolTableCurrentIndex], SymbolDetail, sizeof(MODULE_SYMBOL_DETAIL));
+    memcpy(&g_SymbolTable[g_SymbolTableCurrentIndex],
+           (PVOID)((UINT64)SymbolUpdatePacket + sizeof(DEBUGGER_UPDATE_SYMBOL_TABLE)),
+           SymbolUpdatePacket->SymbolsCount * sizeof(MODULE_SYMBOL_DETAIL));
 
     //
     // Add to index for future symbols
     //
-    g_SymbolTableCurrentIndex++;
+    g_SymbolTableCurrentIndex += SymbolUpdatePacket->SymbolsCount;
 
     //
     // Compute the (new) current size
@@ -974,6 +1121,134 @@ SymbolBuildAndUpdateSymbolTable(PMODULE_SYMBOL_DETAIL SymbolDetail)
     return TRUE;
 }
 
+/**
+ * @brief Add the symbol details of a newly loaded module to the symbol
+ * table and load its symbols
+ * @details only the symbols of this module are loaded, the rest of the
+ * symbol table remains untouched
+ *
+ * @param ModuleSymbolDetail The symbol details of the new module
+ *
+ * @return BOOLEAN shows whether the operation was successful or not
+ */
+BOOLEAN
+SymbolAddModuleToSymbolTable(PMODULE_SYMBOL_DETAIL ModuleSymbolDetail)
+{
+    string                SymbolServer;
+    PMODULE_SYMBOL_DETAIL TargetEntry = NULL;
+
+    //
+    // If there is no symbol table, the module is added once the
+    // symbol table is built ('.sym reload')
+    //
+    if (g_SymbolTable == NULL || g_SymbolTableSize == NULL ||
+        !CommandSettingsGetValueFromConfigFile("SymbolServer", SymbolServer))
+    {
+        return FALSE;
+    }
+
+    //
+    // A new module might be loaded at the base address of an unloaded module
+    //
+    for (UINT32 i = 0; i < g_SymbolTableCurrentIndex; i++)
+    {
+        if (g_SymbolTable[i].BaseAddress == ModuleSymbolDetail->BaseAddress)
+        {
+            if (strcmp(g_SymbolTable[i].ModuleSymbolGuidAndAge, ModuleSymbolDetail->ModuleSymbolGuidAndAge) == 0 &&
+                strcmp(g_SymbolTable[i].FilePath, ModuleSymbolDetail->FilePath) == 0)
+            {
+                //
+                // The same module, nothing to load
+                //
+                return TRUE;
+            }
+
+            TargetEntry = &g_SymbolTable[i];
+            break;
+        }
+    }
+
+    if (TargetEntry == NULL)
+    {
+        if (!SymbolReserveSymbolTable(g_SymbolTableCurrentIndex + 1))
+        {
+            return FALSE;
+        }
+
+        TargetEntry = &g_SymbolTable[g_SymbolTableCurrentIndex];
+
+        g_SymbolTableCurrentIndex++;
+        g_SymbolTableSize = g_SymbolTableCurrentIndex * sizeof(MODULE_SYMBOL_DETAIL);
+    }
+
+    memcpy(TargetEntry, ModuleSymbolDetail, sizeof(MODULE_SYMBOL_DETAIL));
+
+    //
+    // Load the symbols of this module (won't download at this point)
+    //
+    g_IsExecutingSymbolLoadingRoutines = TRUE;
+
+    ScriptEngineSymbolInitLoadWrapper(TargetEntry,
+                                      sizeof(MODULE_SYMBOL_DETAIL),
+                                      FALSE,
+                                      SymbolServer.c_str(),
+                                      TRUE);
+
+    //
+    // Update the symbol table for disassembler
+    //
+    if (TargetEntry->IsSymbolPDBAvaliable)
+    {
+        SymbolCreateDisassemblerSymbolMap();
+    }
+
+    g_IsExecutingSymbolLoadingRoutines = FALSE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Send the symbol details of a newly loaded kernel module to the
+ * debugger
+ * @details This function is called in the debuggee
+ *
+ * @param ModuleLoadedPacket The details of the module that comes from the kernel
+ *
+ * @return BOOLEAN shows whether the operation was successful or not
+ */
+BOOLEAN
+SymbolSendLoadedKernelModuleToDebugger(PDEBUGGEE_KERNEL_MODULE_LOADED_PACKET ModuleLoadedPacket)
+{
+    string               SystemRootString;
+    MODULE_SYMBOL_DETAIL ModuleSymbolDetail = {0};
+    char                 TempPath[MAX_PATH] = {0};
+
+    if (!SymbolGetSystemRoot(SystemRootString))
+    {
+        return FALSE;
+    }
+
+    //
+    // Convert the path from unicode to ascii
+    //
+    ModuleLoadedPacket->FilePath[MAX_PATH - 1] = L'\0';
+    wcstombs(TempPath, ModuleLoadedPacket->FilePath, MAX_PATH - 1);
+
+    string ModuleFullPath(TempPath);
+
+    SymbolConvertKernelModulePath(ModuleFullPath, SystemRootString);
+    SymbolBuildModuleSymbolDetail(ModuleFullPath.c_str(), ModuleLoadedPacket->BaseAddress, FALSE, &ModuleSymbolDetail);
+
+    //
+    // Send the details without pausing the debuggee
+    //
+    return KdSendGeneralBuffersFromDebuggeeToDebugger(
+        DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_ADD_MODULE_SYMBOL_INFO,
+        &ModuleSymbolDetail,
+        sizeof(MODULE_SYMBOL_DETAIL),
+        FALSE);
+}
+
 /**
  * @brief Update the symbol table from remote debuggee in debugger mode
  * @param ProcessId
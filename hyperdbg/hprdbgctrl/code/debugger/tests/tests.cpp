@@ -104,17 +104,20 @@ SetupTestName(_Inout_updates_bytes_all_(BufferLength) PCHAR TestLocation,
  *
  * @param KernelInformation Details from kernel to create lookup table
  * @param KernelInformationSize Size of KernelInformation
+ * @param TestArguments Arguments that are passed to the test process
+ * (optional)
  * @param ConnectionPipeHandle Pointer to receive Pipe Handle
  * @param ThreadHandle Pointer to receive Thread Handle
  * @param ProcessHandle Pointer to receive Process Handle
  * @return BOOLEAN
  */
 BOOLEAN
-CreateProcessAndOpenPipeConnection(PVOID   KernelInformation,
-                                   UINT32  KernelInformationSize,
-                                   PHANDLE ConnectionPipeHandle,
-                                   PHANDLE ThreadHandle,
-                                   PHANDLE ProcessHandle)
+CreateProcessAndOpenPipeConnection(PVOID        KernelInformation,
+                                   UINT32       KernelInformationSize,
+                                   const CHAR * TestArguments,
+                                   PHANDLE      ConnectionPipeHandle,
+                                   PHANDLE      ThreadHandle,
+                                   PHANDLE      ProcessHandle)
 {
     HANDLE              PipeHandle;
     BOOLEAN             SentMessageResult;
@@ -124,7 +127,7 @@ CreateProcessAndOpenPipeConnection(PVOID   KernelInformation,
     char                HandshakeBuffer[] = "Hello, Dear Test Process... Yes, I'm HyperDbg Debugger :)";
     PROCESS_INFORMATION ProcessInfo;
     STARTUPINFO         StartupInfo;
-    char                CmdArgs[] = TEST_PROCESS_NAME " im-hyperdbg";
+    char                CmdArgs[MAX_PATH];
 
     PipeHandle = NamedPipeServerCreatePipe("\\\\.\\Pipe\\HyperDbgTests",
                                            TEST_CASE_MAXIMUM_BUFFERS_TO_COMMUNICATE,
@@ -145,6 +148,18 @@ CreateProcessAndOpenPipeConnection(PVOID   KernelInformation,
 
     strcpy(BufferToSend, HandshakeBuffer);
 
+    //
+    // Set-up the arguments of the test process
+    //
+    if (TestArguments != NULL)
+    {
+        sprintf_s(CmdArgs, sizeof(CmdArgs), "%s im-hyperdbg %s", TEST_PROCESS_NAME, TestArguments);
+    }
+    else
+    {
+        sprintf_s(CmdArgs, sizeof(CmdArgs), "%s im-hyperdbg", TEST_PROCESS_NAME);
+    }
+
     //
     // Create the Test Process
     //
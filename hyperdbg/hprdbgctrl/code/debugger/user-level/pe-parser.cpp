@@ -64,144 +64,216 @@ PeHexDump(CHAR * Ptr, int Size, int SecAddress)
 }
 
 /**
- * @brief Show information about different sections of PE and the dump of sections
+ * @brief Map a PE file and validate its headers
+ * @details the view should be closed by PeCloseFileView (even if it fails)
+ *
  * @param AddressOfFile
- * @param SectionToShow
- * @param Is32Bit
+ * @param FileView
  *
  * @return BOOLEAN
  */
 BOOLEAN
-PeShowSectionInformationAndDump(const WCHAR * AddressOfFile, const CHAR * SectionToShow, BOOLEAN Is32Bit)
+PeOpenFileView(const WCHAR * AddressOfFile, PPE_FILE_VIEW FileView)
 {
-    int                     i      = 0;
-    BOOLEAN                 Result = FALSE;
-    HANDLE                  MapObjectHandle, FileHandle; // File Mapping Object
-    UINT32                  NumberOfSections;            // Number of sections
-    LPVOID                  BaseAddr;                    // Pointer to the base memory of mapped file
-    PIMAGE_DOS_HEADER       DosHeader;                   // Pointer to DOS Header
-    PIMAGE_NT_HEADERS32     NtHeader32 = NULL;           // Pointer to NT Header 32 bit
-    PIMAGE_NT_HEADERS64     NtHeader64 = NULL;           // Pointer to NT Header 64 bit
-    IMAGE_FILE_HEADER       Header;                      // Pointer to image file header of NT Header
-    IMAGE_OPTIONAL_HEADER32 OpHeader32;                  // Optional Header of PE files present in NT Header structure
-    IMAGE_OPTIONAL_HEADER64 OpHeader64;                  // Optional Header of PE files present in NT Header structure
-    PIMAGE_SECTION_HEADER   SecHeader;                   // Section Header or Section Table Header
+    LARGE_INTEGER FileSize;
+    UINT64        NtHeaderOffset;
+
+    RtlZeroMemory(FileView, sizeof(PE_FILE_VIEW));
 
     //
     // Open the EXE File
     //
-    FileHandle = CreateFileW(AddressOfFile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-    if (FileHandle == INVALID_HANDLE_VALUE)
+    FileView->FileHandle = CreateFileW(AddressOfFile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (FileView->FileHandle == INVALID_HANDLE_VALUE)
     {
-        ShowMessages("err, could not open the file specified\n");
+        FileView->FileHandle = NULL;
+
+        ShowMessages("err, unable to read the file (%x)\n", GetLastError());
         return FALSE;
-    };
+    }
+
+    if (!GetFileSizeEx(FileView->FileHandle, &FileSize) ||
+        FileSize.QuadPart < sizeof(IMAGE_DOS_HEADER))
+    {
+        ShowMessages("err, the selected file is not in a valid PE format\n");
+        return FALSE;
+    }
+
+    FileView->FileSize = FileSize.QuadPart;
 
     //
     // Mapping Given EXE file to Memory
     //
-    MapObjectHandle =
-        CreateFileMapping(FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    FileView->MapObjectHandle = CreateFileMapping(FileView->FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
 
-    if (MapObjectHandle == NULL)
+    if (FileView->MapObjectHandle == NULL)
     {
-        CloseHandle(FileHandle);
+        ShowMessages("err, unable to create file mappings (%x)\n", GetLastError());
         return FALSE;
     }
 
-    BaseAddr = MapViewOfFile(MapObjectHandle, FILE_MAP_READ, 0, 0, 0);
+    FileView->BaseAddress = MapViewOfFile(FileView->MapObjectHandle, FILE_MAP_READ, 0, 0, 0);
 
-    if (BaseAddr == NULL)
+    if (FileView->BaseAddress == NULL)
     {
-        CloseHandle(FileHandle);
+        ShowMessages("err, unable to create map view of file (%x)\n", GetLastError());
         return FALSE;
     }
 
-    //
-    // Get the DOS Header Base
-    //
-    DosHeader = (PIMAGE_DOS_HEADER)BaseAddr; // 0x04000000
-
     //
     // Check for Valid DOS file
     //
-    if (DosHeader->e_magic == IMAGE_DOS_SIGNATURE)
+    FileView->DosHeader = (PIMAGE_DOS_HEADER)FileView->BaseAddress;
+
+    if (FileView->DosHeader->e_magic != IMAGE_DOS_SIGNATURE)
     {
-        //
-        // Dump the Dos Header info
-        //
-        ShowMessages("\nValid Dos Exe File\n------------------\n");
-        ShowMessages("\nDumping DOS Header Info....\n---------------------------");
-        ShowMessages("\n%-36s%s ",
-                     "Magic number : ",
-                     DosHeader->e_magic == 0x5a4d ? "MZ" : "-");
-        ShowMessages("\n%-36s%#x", "Bytes on last page of file :", DosHeader->e_cblp);
-        ShowMessages("\n%-36s%#x", "Pages in file : ", DosHeader->e_cp);
-        ShowMessages("\n%-36s%#x", "Relocation : ", DosHeader->e_crlc);
-        ShowMessages("\n%-36s%#x",
-                     "Size of header in paragraphs : ",
-                     DosHeader->e_cparhdr);
-        ShowMessages("\n%-36s%#x",
-                     "Minimum extra paragraphs needed : ",
-                     DosHeader->e_minalloc);
-        ShowMessages("\n%-36s%#x",
-                     "Maximum extra paragraphs needed : ",
-                     DosHeader->e_maxalloc);
-        ShowMessages("\n%-36s%#x", "Initial (relative) SS value : ", DosHeader->e_ss);
-        ShowMessages("\n%-36s%#x", "Initial SP value : ", DosHeader->e_sp);
-        ShowMessages("\n%-36s%#x", "Checksum : ", DosHeader->e_csum);
-        ShowMessages("\n%-36s%#x", "Initial IP value : ", DosHeader->e_ip);
-        ShowMessages("\n%-36s%#x", "Initial (relative) CS value : ", DosHeader->e_cs);
-        ShowMessages("\n%-36s%#x",
-                     "File address of relocation table : ",
-                     DosHeader->e_lfarlc);
-        ShowMessages("\n%-36s%#x", "Overlay number : ", DosHeader->e_ovno);
-        ShowMessages("\n%-36s%#x", "OEM identifier : ", DosHeader->e_oemid);
-        ShowMessages("\n%-36s%#x",
-                     "OEM information(e_oemid specific) :",
-                     DosHeader->e_oeminfo);
-        ShowMessages("\n%-36s%#x", "RVA address of PE header : ", DosHeader->e_lfanew);
-        ShowMessages("\n==============================================================="
-                     "================\n");
+        ShowMessages("err, the selected file is not in a valid PE format\n");
+        return FALSE;
     }
-    else
+
+    //
+    // Offset of NT Header is found at 0x3c location in DOS header specified by
+    // e_lfanew, the headers should be inside the file
+    //
+    NtHeaderOffset = (UINT32)FileView->DosHeader->e_lfanew;
+
+    if (NtHeaderOffset + sizeof(IMAGE_NT_HEADERS64) > FileView->FileSize)
     {
-        ShowMessages("\nGiven File is not a valid DOS file\n");
-        Result = FALSE;
-        goto Finished;
+        ShowMessages("err, the selected file is not in a valid PE format\n");
+        return FALSE;
     }
 
+    FileView->NtHeader32 = (PIMAGE_NT_HEADERS32)((UINT64)FileView->BaseAddress + NtHeaderOffset);
+    FileView->NtHeader64 = (PIMAGE_NT_HEADERS64)((UINT64)FileView->BaseAddress + NtHeaderOffset);
+
     //
-    // Offset of NT Header is found at 0x3c location in DOS header specified by
-    // e_lfanew
-    // Get the Base of NT Header(PE Header) 	= DosHeader + RVA address of PE
-    // header
+    // Identify for valid PE file
     //
-    if (Is32Bit)
+    if (FileView->NtHeader32->Signature != IMAGE_NT_SIGNATURE)
     {
-        NtHeader32 = (PIMAGE_NT_HEADERS32)((UINT64)(DosHeader) + (DosHeader->e_lfanew));
+        ShowMessages("err, invalid image NT signature\n");
+        return FALSE;
     }
-    else
+
+    return TRUE;
+}
+
+/**
+ * @brief Unmap a PE file and close its handles
+ *
+ * @param FileView
+ *
+ * @return VOID
+ */
+VOID
+PeCloseFileView(PPE_FILE_VIEW FileView)
+{
+    if (FileView->BaseAddress != NULL)
     {
-        NtHeader64 = (PIMAGE_NT_HEADERS64)((UINT64)(DosHeader) + (DosHeader->e_lfanew));
+        UnmapViewOfFile(FileView->BaseAddress);
     }
 
+    if (FileView->MapObjectHandle != NULL)
+    {
+        CloseHandle(FileView->MapObjectHandle);
+    }
+
+    if (FileView->FileHandle != NULL)
+    {
+        CloseHandle(FileView->FileHandle);
+    }
+
+    RtlZeroMemory(FileView, sizeof(PE_FILE_VIEW));
+}
+
+/**
+ * @brief Show information about different sections of PE and the dump of sections
+ * @param AddressOfFile
+ * @param SectionToShow
+ * @param Is32Bit
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+PeShowSectionInformationAndDump(const WCHAR * AddressOfFile, const CHAR * SectionToShow, BOOLEAN Is32Bit)
+{
+    int                     i      = 0;
+    BOOLEAN                 Result = FALSE;
+    PE_FILE_VIEW            FileView;                    // The mapped file
+    UINT32                  NumberOfSections;            // Number of sections
+    PIMAGE_DOS_HEADER       DosHeader;                   // Pointer to DOS Header
+    PIMAGE_NT_HEADERS32     NtHeader32 = NULL;           // Pointer to NT Header 32 bit
+    PIMAGE_NT_HEADERS64     NtHeader64 = NULL;           // Pointer to NT Header 64 bit
+    IMAGE_FILE_HEADER       Header;                      // Pointer to image file header of NT Header
+    IMAGE_OPTIONAL_HEADER32 OpHeader32;                  // Optional Header of PE files present in NT Header structure
+    IMAGE_OPTIONAL_HEADER64 OpHeader64;                  // Optional Header of PE files present in NT Header structure
+    PIMAGE_SECTION_HEADER   SecHeader;                   // Section Header or Section Table Header
+
     //
-    // Identify for valid PE file
+    // Map the EXE File (the DOS and the NT headers are validated here)
     //
-    if (Is32Bit && NtHeader32->Signature == IMAGE_NT_SIGNATURE)
+    if (!PeOpenFileView(AddressOfFile, &FileView))
     {
-        ShowMessages("\nValid PE32 file \n-------------\n");
+        PeCloseFileView(&FileView);
+        return FALSE;
     }
-    else if (!Is32Bit && NtHeader64->Signature == IMAGE_NT_SIGNATURE)
+
+    //
+    // Get the DOS Header Base
+    //
+    DosHeader = FileView.DosHeader;
+
+    //
+    // Dump the Dos Header info
+    //
+    ShowMessages("\nValid Dos Exe File\n------------------\n");
+    ShowMessages("\nDumping DOS Header Info....\n---------------------------");
+    ShowMessages("\n%-36s%s ",
+                 "Magic number : ",
+                 DosHeader->e_magic == 0x5a4d ? "MZ" : "-");
+    ShowMessages("\n%-36s%#x", "Bytes on last page of file :", DosHeader->e_cblp);
+    ShowMessages("\n%-36s%#x", "Pages in file : ", DosHeader->e_cp);
+    ShowMessages("\n%-36s%#x", "Relocation : ", DosHeader->e_crlc);
+    ShowMessages("\n%-36s%#x",
+                 "Size of header in paragraphs : ",
+                 DosHeader->e_cparhdr);
+    ShowMessages("\n%-36s%#x",
+                 "Minimum extra paragraphs needed : ",
+                 DosHeader->e_minalloc);
+    ShowMessages("\n%-36s%#x",
+                 "Maximum extra paragraphs needed : ",
+                 DosHeader->e_maxalloc);
+    ShowMessages("\n%-36s%#x", "Initial (relative) SS value : ", DosHeader->e_ss);
+    ShowMessages("\n%-36s%#x", "Initial SP value : ", DosHeader->e_sp);
+    ShowMessages("\n%-36s%#x", "Checksum : ", DosHeader->e_csum);
+    ShowMessages("\n%-36s%#x", "Initial IP value : ", DosHeader->e_ip);
+    ShowMessages("\n%-36s%#x", "Initial (relative) CS value : ", DosHeader->e_cs);
+    ShowMessages("\n%-36s%#x",
+                 "File address of relocation table : ",
+                 DosHeader->e_lfarlc);
+    ShowMessages("\n%-36s%#x", "Overlay number : ", DosHeader->e_ovno);
+    ShowMessages("\n%-36s%#x", "OEM identifier : ", DosHeader->e_oemid);
+    ShowMessages("\n%-36s%#x",
+                 "OEM information(e_oemid specific) :",
+                 DosHeader->e_oeminfo);
+    ShowMessages("\n%-36s%#x", "RVA address of PE header : ", DosHeader->e_lfanew);
+    ShowMessages("\n==============================================================="
+                 "================\n");
+
+    //
+    // Get the Base of NT Header(PE Header) 	= DosHeader + RVA address of PE
+    // header
+    //
+    if (Is32Bit)
     {
-        ShowMessages("\nValid PE64 file \n-------------\n");
+        NtHeader32 = FileView.NtHeader32;
+        ShowMessages("\nValid PE32 file \n-------------\n");
     }
     else
     {
-        ShowMessages("err, the specified file is not a valid PE file");
-        Result = FALSE;
-        goto Finished;
+        NtHeader64 = FileView.NtHeader64;
+        ShowMessages("\nValid PE64 file \n-------------\n");
     }
 
     //
@@ -377,6 +449,15 @@ PeShowSectionInformationAndDump(const WCHAR * AddressOfFile, const CHAR * Sectio
         NumberOfSections = NtHeader64->FileHeader.NumberOfSections;
     }
 
+    //
+    // The section table should be inside the file
+    //
+    if ((UINT64)SecHeader - (UINT64)FileView.BaseAddress + (UINT64)NumberOfSections * sizeof(IMAGE_SECTION_HEADER) > FileView.FileSize)
+    {
+        ShowMessages("\nerr, the section table is not inside the file\n");
+        goto Finished;
+    }
+
     for (i = 0; i < NumberOfSections; i++, SecHeader++)
     {
         if (Is32Bit)
@@ -435,7 +516,8 @@ PeShowSectionInformationAndDump(const WCHAR * AddressOfFile, const CHAR * Sectio
         {
             if (!_strcmpi(SectionToShow, (const char *)SecHeader->Name))
             {
-                if (SecHeader->SizeOfRawData != 0)
+                if (SecHeader->SizeOfRawData != 0 &&
+                    (UINT64)SecHeader->PointerToRawData + SecHeader->SizeOfRawData <= FileView.FileSize)
                 {
                     if (Is32Bit)
                     {
@@ -466,8 +548,7 @@ Finished:
     //
     // Unmap and close the handles
     //
-    UnmapViewOfFile(BaseAddr);
-    CloseHandle(MapObjectHandle);
+    PeCloseFileView(&FileView);
 
     return Result;
 }
@@ -483,82 +564,21 @@ BOOLEAN
 PeIsPE32BitOr64Bit(const WCHAR * AddressOfFile, PBOOLEAN Is32Bit)
 {
     BOOLEAN                 Result = FALSE;
-    HANDLE                  MapObjectHandle, FileHandle; // File Mapping Object
-    LPVOID                  BaseAddr;                    // Pointer to the base memory of mapped file
-    PIMAGE_DOS_HEADER       DosHeader;                   // Pointer to DOS Header
-    PIMAGE_NT_HEADERS32     NtHeader32 = NULL;           // Pointer to NT Header 32 bit
-    IMAGE_OPTIONAL_HEADER32 OpHeader32;                  // Optional Header of PE files present in NT Header structure
-    IMAGE_FILE_HEADER       Header;                      // Pointer to image file header of NT Header
+    PE_FILE_VIEW            FileView;          // The mapped file
+    PIMAGE_NT_HEADERS32     NtHeader32 = NULL; // Pointer to NT Header 32 bit
+    IMAGE_OPTIONAL_HEADER32 OpHeader32;        // Optional Header of PE files present in NT Header structure
+    IMAGE_FILE_HEADER       Header;            // Pointer to image file header of NT Header
 
     //
-    // Open the EXE File
+    // Map the EXE File (the DOS and the NT headers are validated here)
     //
-    FileHandle = CreateFileW(AddressOfFile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-    if (FileHandle == INVALID_HANDLE_VALUE)
-    {
-        ShowMessages("err, unable to read the file (%x)\n", GetLastError());
-        return FALSE;
-    };
-
-    //
-    // Mapping Given EXE file to Memory
-    //
-    MapObjectHandle =
-        CreateFileMapping(FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
-
-    if (MapObjectHandle == NULL)
-    {
-        CloseHandle(FileHandle);
-
-        ShowMessages("err, unable to create file mappings (%x)\n", GetLastError());
-        return FALSE;
-    }
-
-    BaseAddr = MapViewOfFile(MapObjectHandle, FILE_MAP_READ, 0, 0, 0);
-
-    if (BaseAddr == NULL)
-    {
-        CloseHandle(FileHandle);
-
-        ShowMessages("err, unable to create map view of file (%x)\n", GetLastError());
-        return FALSE;
-    }
-
-    //
-    // Get the DOS Header Base
-    //
-    DosHeader = (PIMAGE_DOS_HEADER)BaseAddr; // 0x04000000
-
-    //
-    // Check for Valid DOS file
-    //
-    if (DosHeader->e_magic != IMAGE_DOS_SIGNATURE)
+    if (!PeOpenFileView(AddressOfFile, &FileView))
     {
         Result = FALSE;
-
-        ShowMessages("err, the selected file is not in a valid PE format\n");
         goto Finished;
     }
 
-    //
-    // Offset of NT Header is found at 0x3c location in DOS header specified by
-    // e_lfanew
-    // Get the Base of NT Header(PE Header) 	= DosHeader + RVA address of PE
-    // header
-    //
-
-    NtHeader32 = (PIMAGE_NT_HEADERS32)((UINT64)(DosHeader) + (DosHeader->e_lfanew));
-
-    //
-    // Identify for valid PE file
-    //
-    if (NtHeader32->Signature != IMAGE_NT_SIGNATURE)
-    {
-        Result = FALSE;
-
-        ShowMessages("err, invalid image NT signature\n");
-        goto Finished;
-    }
+    NtHeader32 = FileView.NtHeader32;
 
     //
     // Info about Optional Header
@@ -598,8 +618,7 @@ Finished:
     //
     // Unmap and close the handles
     //
-    UnmapViewOfFile(BaseAddr);
-    CloseHandle(MapObjectHandle);
+    PeCloseFileView(&FileView);
 
     return Result;
 }
@@ -825,6 +825,97 @@ UdSendCommand(UINT64                          ProcessDetailToken,
     }
 }
 
+/**
+ * @brief Send a batch of commands to the user debugger (in one request)
+ * @param ProcessDetailToken
+ * @param Entries the entries of the batch, the results are also stored here
+ * @param CountOfEntries
+ *
+ * @return UINT32 count of the applied entries
+ */
+UINT32
+UdSendBatchCommand(UINT64                           ProcessDetailToken,
+                   PDEBUGGER_UD_BATCH_COMMAND_ENTRY Entries,
+                   UINT32                           CountOfEntries)
+{
+    BOOL                              Status;
+    ULONG                             ReturnedLength;
+    UINT32                            SizeOfPacket;
+    PDEBUGGER_UD_BATCH_COMMAND_PACKET BatchPacket;
+    UINT32                            CountOfAppliedEntries;
+
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    if (CountOfEntries == 0 || CountOfEntries > DEBUGGER_UD_BATCH_COMMAND_MAXIMUM_ENTRIES)
+    {
+        ShowMessages("err, the count of the entries of the batch should be between 1 and %x\n",
+                     DEBUGGER_UD_BATCH_COMMAND_MAXIMUM_ENTRIES);
+        return 0;
+    }
+
+    SizeOfPacket = SIZEOF_DEBUGGER_UD_BATCH_COMMAND_PACKET + CountOfEntries * sizeof(DEBUGGER_UD_BATCH_COMMAND_ENTRY);
+
+    BatchPacket = (PDEBUGGER_UD_BATCH_COMMAND_PACKET)malloc(SizeOfPacket);
+
+    if (BatchPacket == NULL)
+    {
+        ShowMessages("err, unable to allocate memory for the batch of commands\n");
+        return 0;
+    }
+
+    RtlZeroMemory(BatchPacket, SizeOfPacket);
+
+    //
+    // Set to the details, the entries are after the header
+    //
+    BatchPacket->ProcessDebuggingDetailToken = ProcessDetailToken;
+    BatchPacket->CountOfEntries              = CountOfEntries;
+
+    memcpy((PVOID)((UINT64)BatchPacket + SIZEOF_DEBUGGER_UD_BATCH_COMMAND_PACKET),
+           Entries,
+           CountOfEntries * sizeof(DEBUGGER_UD_BATCH_COMMAND_ENTRY));
+
+    //
+    // Send IOCTL
+    //
+    Status = DeviceIoControl(g_DeviceHandle,                          // Handle to device
+                             IOCTL_SEND_USER_DEBUGGER_BATCH_COMMANDS, // IO Control code
+                             BatchPacket,                             // Input Buffer to driver.
+                             SizeOfPacket,                            // Input buffer length
+                             BatchPacket,                             // Output Buffer from driver.
+                             SizeOfPacket,                            // Length of output buffer in bytes.
+                             &ReturnedLength,                         // Bytes placed in buffer.
+                             NULL                                     // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+        free(BatchPacket);
+        return 0;
+    }
+
+    if (BatchPacket->Result != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowErrorMessage(BatchPacket->Result);
+        free(BatchPacket);
+        return 0;
+    }
+
+    //
+    // Copy the results of the entries
+    //
+    memcpy(Entries,
+           (PVOID)((UINT64)BatchPacket + SIZEOF_DEBUGGER_UD_BATCH_COMMAND_PACKET),
+           CountOfEntries * sizeof(DEBUGGER_UD_BATCH_COMMAND_ENTRY));
+
+    CountOfAppliedEntries = BatchPacket->CountOfAppliedEntries;
+
+    free(BatchPacket);
+
+    return CountOfAppliedEntries;
+}
+
 /**
  * @brief Continue the target user debugger
  * @param ProcessDetailToken
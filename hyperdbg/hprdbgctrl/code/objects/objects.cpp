@@ -147,6 +147,8 @@ ObjectShowProcessesOrThreadList(BOOLEAN                               IsProcess,
     PVOID                                      Entries                                     = NULL;
     PDEBUGGEE_PROCESS_LIST_DETAILS_ENTRY       ProcessEntries                              = NULL;
     PDEBUGGEE_THREAD_LIST_DETAILS_ENTRY        ThreadEntries                               = NULL;
+    UINT32                                     StartIndex                                  = 0;
+    UINT32                                     CountOfPageEntries                          = 0;
 
     //
     // Check if driver is loaded
@@ -229,31 +231,28 @@ ObjectShowProcessesOrThreadList(BOOLEAN                               IsProcess,
         else
         {
             //
-            // *** We should send another IOCTL and get the list of processes or threads ***
+            // *** We should send other IOCTLs and get the list of processes or threads page by page ***
             //
 
             //
-            // Add some spaces for new processes or threads as new objects might be available
-            //
-            QueryCountOfActiveThreadsOrProcessesRequest.Count = QueryCountOfActiveThreadsOrProcessesRequest.Count + 5;
-
-            //
-            // Allocate the storage for the pull details of threads and processes
+            // Allocate the storage for the details of a page of threads or processes
             //
             if (IsProcess)
             {
-                SizeOfBufferForThreadsAndProcessDetails =
-                    QueryCountOfActiveThreadsOrProcessesRequest.Count * sizeof(DEBUGGEE_PROCESS_LIST_DETAILS_ENTRY);
+                SizeOfBufferForThreadsAndProcessDetails = OBJECT_LIST_PAGE_ENTRIES_COUNT * sizeof(DEBUGGEE_PROCESS_LIST_DETAILS_ENTRY);
             }
             else
             {
-                SizeOfBufferForThreadsAndProcessDetails =
-                    QueryCountOfActiveThreadsOrProcessesRequest.Count * sizeof(DEBUGGEE_THREAD_LIST_DETAILS_ENTRY);
+                SizeOfBufferForThreadsAndProcessDetails = OBJECT_LIST_PAGE_ENTRIES_COUNT * sizeof(DEBUGGEE_THREAD_LIST_DETAILS_ENTRY);
             }
 
             Entries = (PVOID)malloc(SizeOfBufferForThreadsAndProcessDetails);
 
-            RtlZeroMemory(Entries, SizeOfBufferForThreadsAndProcessDetails);
+            if (Entries == NULL)
+            {
+                ShowMessages("err, unable to allocate memory for the list of processes or threads\n");
+                return FALSE;
+            }
 
             // ShowMessages("count of active processes/threads : %lld\n", QueryCountOfActiveThreadsOrProcessesRequest.Count);
 
@@ -266,50 +265,68 @@ ObjectShowProcessesOrThreadList(BOOLEAN                               IsProcess,
                 QueryCountOfActiveThreadsOrProcessesRequest.QueryType = DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_QUERY_THREAD_LIST;
             }
 
-            //
-            // Send the request to the kernel
-            //
-            Status = DeviceIoControl(
-                g_DeviceHandle,                                    // Handle to device
-                IOCTL_GET_LIST_OF_THREADS_AND_PROCESSES,           // IO Control code
-                &QueryCountOfActiveThreadsOrProcessesRequest,      // Input Buffer to driver.
-                SIZEOF_DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS, // Input buffer length
-                Entries,                                           // Output Buffer from driver.
-                SizeOfBufferForThreadsAndProcessDetails,           // Length of output buffer in bytes.
-                &ReturnedLength,                                   // Bytes placed in buffer.
-                NULL                                               // synchronous call
-            );
-
-            if (!Status)
-            {
-                ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
-                return FALSE;
-            }
+            ProcessEntries = (PDEBUGGEE_PROCESS_LIST_DETAILS_ENTRY)Entries;
+            ThreadEntries  = (PDEBUGGEE_THREAD_LIST_DETAILS_ENTRY)Entries;
 
-            if (IsProcess)
-            {
-                ProcessEntries = (PDEBUGGEE_PROCESS_LIST_DETAILS_ENTRY)Entries;
-            }
-            else
+            do
             {
-                ThreadEntries = (PDEBUGGEE_THREAD_LIST_DETAILS_ENTRY)Entries;
+                RtlZeroMemory(Entries, SizeOfBufferForThreadsAndProcessDetails);
 
-                ShowMessages("PROCESS\t%llx\tIMAGE\t%s\n",
-                             ThreadEntries->Eprocess,
-                             ThreadEntries->ImageFileName);
-            }
+                //
+                // Each page starts after the entries of the previous pages, so the list
+                // is not truncated if new objects are created after querying the count
+                //
+                QueryCountOfActiveThreadsOrProcessesRequest.StartIndex = StartIndex;
 
-            //
-            // Show list of active processes and threads
-            //
-            for (size_t i = 0; i < QueryCountOfActiveThreadsOrProcessesRequest.Count; i++)
-            {
                 //
-                // Details of process/thread should be shown
+                // Send the request to the kernel
                 //
-                if (IsProcess)
+                Status = DeviceIoControl(
+                    g_DeviceHandle,                                    // Handle to device
+                    IOCTL_GET_LIST_OF_THREADS_AND_PROCESSES,           // IO Control code
+                    &QueryCountOfActiveThreadsOrProcessesRequest,      // Input Buffer to driver.
+                    SIZEOF_DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS, // Input buffer length
+                    Entries,                                           // Output Buffer from driver.
+                    SizeOfBufferForThreadsAndProcessDetails,           // Length of output buffer in bytes.
+                    &ReturnedLength,                                   // Bytes placed in buffer.
+                    NULL                                               // synchronous call
+                );
+
+                if (!Status)
                 {
-                    if (ProcessEntries[i].Eprocess != NULL)
+                    ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+                    free(Entries);
+                    return FALSE;
+                }
+
+                //
+                // Count the entries of this page (the unused entries remain zero)
+                //
+                for (CountOfPageEntries = 0; CountOfPageEntries < OBJECT_LIST_PAGE_ENTRIES_COUNT; CountOfPageEntries++)
+                {
+                    if ((IsProcess && ProcessEntries[CountOfPageEntries].Eprocess == NULL) ||
+                        (!IsProcess && ThreadEntries[CountOfPageEntries].Ethread == NULL))
+                    {
+                        break;
+                    }
+                }
+
+                if (!IsProcess && StartIndex == 0 && CountOfPageEntries != 0)
+                {
+                    ShowMessages("PROCESS\t%llx\tIMAGE\t%s\n",
+                                 ThreadEntries->Eprocess,
+                                 ThreadEntries->ImageFileName);
+                }
+
+                //
+                // Show list of active processes and threads
+                //
+                for (size_t i = 0; i < CountOfPageEntries; i++)
+                {
+                    //
+                    // Details of process/thread should be shown
+                    //
+                    if (IsProcess)
                     {
                         ShowMessages("PROCESS\t%llx\n\tProcess Id: %04x\tDirBase (Kernel Cr3): %016llx\tImage: %s\n\n",
                                      ProcessEntries[i].Eprocess,
@@ -317,10 +334,7 @@ ObjectShowProcessesOrThreadList(BOOLEAN                               IsProcess,
                                      ProcessEntries[i].Cr3,
                                      ProcessEntries[i].ImageFileName);
                     }
-                }
-                else
-                {
-                    if (ThreadEntries[i].Ethread != NULL)
+                    else
                     {
                         ShowMessages("\tTHREAD\t%llx (%llx.%llx)\n",
                                      ThreadEntries[i].Ethread,
@@ -328,7 +342,12 @@ ObjectShowProcessesOrThreadList(BOOLEAN                               IsProcess,
                                      ThreadEntries[i].Tid);
                     }
                 }
-            }
+
+                StartIndex += CountOfPageEntries;
+
+            } while (CountOfPageEntries == OBJECT_LIST_PAGE_ENTRIES_COUNT);
+
+            free(Entries);
         }
 
         //
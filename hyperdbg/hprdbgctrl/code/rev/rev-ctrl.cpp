@@ -67,3 +67,224 @@ RevRequestService(REVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST * RevRequest)
 
     return FALSE;
 }
+
+/**
+ * @brief Query all of the records of the coverage of the reversing machine
+ *
+ * @param ProcessId The process that its coverage is recorded
+ * @param IsBasicBlockCoverage Whether the records are basic blocks or pages
+ * @param Records The records (sorted by the address, without duplicates)
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+RevQueryCoverage(UINT32 * ProcessId, BOOLEAN * IsBasicBlockCoverage, std::map<UINT64, UINT32> & Records)
+{
+    BOOLEAN                           Status;
+    ULONG                             ReturnedLength;
+    PREVERSING_MACHINE_QUERY_COVERAGE CoverageRequest;
+    UINT32                            StartIndex = 0;
+
+    CoverageRequest = (PREVERSING_MACHINE_QUERY_COVERAGE)malloc(SIZEOF_REVERSING_MACHINE_QUERY_COVERAGE);
+
+    if (CoverageRequest == NULL)
+    {
+        return FALSE;
+    }
+
+    do
+    {
+        RtlZeroMemory(CoverageRequest, SIZEOF_REVERSING_MACHINE_QUERY_COVERAGE);
+        CoverageRequest->StartIndex = StartIndex;
+
+        //
+        // Send the request to the kernel
+        //
+        Status = DeviceIoControl(
+            g_DeviceHandle,                          // Handle to device
+            IOCTL_QUERY_REV_MACHINE_COVERAGE,        // IO Control
+                                                     // code
+            CoverageRequest,                         // Input Buffer to driver.
+            SIZEOF_REVERSING_MACHINE_QUERY_COVERAGE, // Input buffer length
+            CoverageRequest,                         // Output Buffer from driver.
+            SIZEOF_REVERSING_MACHINE_QUERY_COVERAGE, // Length of output
+                                                     // buffer in bytes.
+            &ReturnedLength,                         // Bytes placed in buffer.
+            NULL                                     // synchronous call
+        );
+
+        if (!Status)
+        {
+            ShowMessages("ioctl failed with code 0x%x\n", GetLastError());
+            free(CoverageRequest);
+            return FALSE;
+        }
+
+        if (CoverageRequest->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+        {
+            ShowErrorMessage(CoverageRequest->KernelStatus);
+            free(CoverageRequest);
+            return FALSE;
+        }
+
+        for (UINT32 i = 0; i < CoverageRequest->CountOfRecords; i++)
+        {
+            //
+            // The records that are not written yet are zero
+            //
+            if (CoverageRequest->Records[i].Address == NULL)
+            {
+                continue;
+            }
+
+            UINT32 & Size = Records[CoverageRequest->Records[i].Address];
+            Size          = max(Size, CoverageRequest->Records[i].Size);
+        }
+
+        StartIndex += CoverageRequest->CountOfRecords;
+
+    } while (CoverageRequest->CountOfRecords != 0 && StartIndex < CoverageRequest->TotalCountOfRecords);
+
+    if (CoverageRequest->CountOfLostRecords != 0)
+    {
+        ShowMessages("warning, %d records are lost as the buffer of the coverage is full\n",
+                     CoverageRequest->CountOfLostRecords);
+    }
+
+    *ProcessId            = CoverageRequest->ProcessId;
+    *IsBasicBlockCoverage = CoverageRequest->IsBasicBlockCoverage;
+
+    free(CoverageRequest);
+
+    return TRUE;
+}
+
+/**
+ * @brief Save the coverage of the reversing machine as a drcov file
+ * @details the records are saved relative to the modules of the process
+ * (version 2 of the format of drcov), the records that are not in any
+ * module (e.g., JIT code) are not saved
+ *
+ * @param FilePath
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+RevSaveCoverage(const string & FilePath)
+{
+    UINT32                     ProcessId            = 0;
+    BOOLEAN                    IsBasicBlockCoverage = FALSE;
+    HANDLE                     ModulesSnapshot;
+    MODULEENTRY32              ModuleEntry;
+    std::map<UINT64, UINT32>   Records;
+    std::vector<MODULEENTRY32> Modules;
+    std::vector<UINT64>        BasicBlocks;
+    UINT32                     CountOfSkippedRecords = 0;
+    FILE *                     OutputFile;
+
+    //
+    // Check if debugger is loaded or not
+    //
+    AssertShowMessageReturnStmt(g_DeviceHandle, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    if (!RevQueryCoverage(&ProcessId, &IsBasicBlockCoverage, Records))
+    {
+        return FALSE;
+    }
+
+    //
+    // The modules are read from the process
+    //
+    ModulesSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, ProcessId);
+
+    if (ModulesSnapshot == INVALID_HANDLE_VALUE)
+    {
+        ShowMessages("err, unable to read the modules of the process (%x)\n", GetLastError());
+        return FALSE;
+    }
+
+    ModuleEntry.dwSize = sizeof(MODULEENTRY32);
+
+    if (Module32First(ModulesSnapshot, &ModuleEntry))
+    {
+        do
+        {
+            Modules.push_back(ModuleEntry);
+
+        } while (Module32Next(ModulesSnapshot, &ModuleEntry));
+    }
+
+    CloseHandle(ModulesSnapshot);
+
+    //
+    // Each entry of the table of the basic blocks is
+    // { UINT32 Start (module offset), UINT16 Size, UINT16 ModuleId }
+    //
+    for (auto & Record : Records)
+    {
+        BOOLEAN IsFound = FALSE;
+
+        for (size_t i = 0; i < Modules.size(); i++)
+        {
+            UINT64 Base = (UINT64)Modules[i].modBaseAddr;
+
+            if (Record.first >= Base && Record.first < Base + Modules[i].modBaseSize)
+            {
+                BasicBlocks.push_back((Record.first - Base) |
+                                      ((UINT64)(min(Record.second, MAXUINT16)) << 32) |
+                                      ((UINT64)i << 48));
+                IsFound = TRUE;
+                break;
+            }
+        }
+
+        if (!IsFound)
+        {
+            CountOfSkippedRecords++;
+        }
+    }
+
+    if (fopen_s(&OutputFile, FilePath.c_str(), "wb") != 0)
+    {
+        ShowMessages("err, unable to create the file '%s'\n", FilePath.c_str());
+        return FALSE;
+    }
+
+    fprintf(OutputFile, "DRCOV VERSION: 2\n");
+    fprintf(OutputFile, "DRCOV FLAVOR: hyperdbg\n");
+    fprintf(OutputFile, "Module Table: version 2, count %zu\n", Modules.size());
+    fprintf(OutputFile, "Columns: id, base, end, entry, checksum, timestamp, path\n");
+
+    for (size_t i = 0; i < Modules.size(); i++)
+    {
+        fprintf(OutputFile,
+                "%3zu, %#018llx, %#018llx, %#018llx, %#010x, %#010x, %s\n",
+                i,
+                (UINT64)Modules[i].modBaseAddr,
+                (UINT64)Modules[i].modBaseAddr + Modules[i].modBaseSize,
+                0ull,
+                0,
+                0,
+                Modules[i].szExePath);
+    }
+
+    fprintf(OutputFile, "BB Table: %zu bbs\n", BasicBlocks.size());
+    fwrite(BasicBlocks.data(), sizeof(UINT64), BasicBlocks.size(), OutputFile);
+
+    fclose(OutputFile);
+
+    ShowMessages("%zu %s of the process (%x) are saved in '%s'",
+                 BasicBlocks.size(),
+                 IsBasicBlockCoverage ? "basic blocks" : "pages",
+                 ProcessId,
+                 FilePath.c_str());
+
+    if (CountOfSkippedRecords != 0)
+    {
+        ShowMessages(", %d records are not in any module", CountOfSkippedRecords);
+    }
+
+    ShowMessages("\n");
+
+    return TRUE;
+}
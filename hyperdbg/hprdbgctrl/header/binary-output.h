@@ -0,0 +1,188 @@
+/**
+ * @file binary-output.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers of the binary (structured) format of output sources
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The magic of the binary output file ('HDBINOUT')
+ *
+ */
+#define BINARY_OUTPUT_FILE_MAGIC 0x54554f4e49424448
+
+/**
+ * @brief The magic of each block of the binary output file ('HDBK')
+ *
+ */
+#define BINARY_OUTPUT_BLOCK_MAGIC 0x4b424448
+
+/**
+ * @brief The version of the layout of the binary output file
+ *
+ */
+#define BINARY_OUTPUT_FILE_VERSION 1
+
+/**
+ * @brief The size of records after which the block is compressed
+ * and appended to the file
+ *
+ */
+#define BINARY_OUTPUT_BLOCK_SIZE 0x10000
+
+//////////////////////////////////////////////////
+//					Enums                       //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Types of the records of the binary output file
+ *
+ */
+typedef enum _BINARY_OUTPUT_RECORD_TYPE
+{
+    BINARY_OUTPUT_RECORD_TYPE_TRACE  = 1, // Values of printf (binary trace mode)
+    BINARY_OUTPUT_RECORD_TYPE_TEXT   = 2, // A message which is not a binary trace record
+    BINARY_OUTPUT_RECORD_TYPE_FORMAT = 3, // The format string of a FormatId
+    BINARY_OUTPUT_RECORD_TYPE_RAW    = 4, // A binary trace record as received from the kernel (recording of events)
+
+} BINARY_OUTPUT_RECORD_TYPE;
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The header of the binary output file
+ * @details the header is followed by the blocks, each block is a
+ * BINARY_OUTPUT_BLOCK_HEADER followed by its (compressed) records,
+ * once the output is closed, the index of the blocks and the footer
+ * are appended to the file
+ *
+ */
+typedef struct _BINARY_OUTPUT_FILE_HEADER
+{
+    UINT64 Magic;
+    UINT32 Version;
+    UINT32 CompressionAlgorithm; // COMPRESS_ALGORITHM_* or zero if not compressed
+
+} BINARY_OUTPUT_FILE_HEADER, *PBINARY_OUTPUT_FILE_HEADER;
+
+/**
+ * @brief The header of a block of records
+ * @details if CompressedSize is equal to UncompressedSize, then the
+ * records of the block are stored without compression
+ *
+ */
+typedef struct _BINARY_OUTPUT_BLOCK_HEADER
+{
+    UINT32 Magic;
+    UINT32 RecordsCount;
+    UINT32 UncompressedSize;
+    UINT32 CompressedSize;
+    UINT64 FirstTsc;
+    UINT64 LastTsc;
+
+} BINARY_OUTPUT_BLOCK_HEADER, *PBINARY_OUTPUT_BLOCK_HEADER;
+
+/**
+ * @brief A record in a block
+ * @details the record is followed by ArgumentsCount values (UINT64) of
+ * printf for trace records, or by the characters of the message (text
+ * records) or the format string (format records) which are not
+ * null-terminated, or by the BINARY_TRACE_RECORD and its arguments (raw
+ * records), the format record of each FormatId is written once before
+ * the first trace (or raw) record of the FormatId
+ *
+ */
+typedef struct _BINARY_OUTPUT_RECORD
+{
+    UINT16 Type; // BINARY_OUTPUT_RECORD_TYPE
+    UINT16 ArgumentsCount;
+    UINT32 Length; // Length of the record and its payload
+    UINT64 Tag;
+    UINT64 Tsc;
+    UINT32 CoreId;
+    UINT32 ProcessId;
+    UINT32 ThreadId;
+    UINT32 FormatId;
+
+} BINARY_OUTPUT_RECORD, *PBINARY_OUTPUT_RECORD;
+
+/**
+ * @brief An entry in the index of the blocks
+ *
+ */
+typedef struct _BINARY_OUTPUT_INDEX_ENTRY
+{
+    UINT64 Offset; // Offset of the BINARY_OUTPUT_BLOCK_HEADER in the file
+    UINT32 RecordsCount;
+    UINT32 Reserved;
+    UINT64 FirstTsc;
+    UINT64 LastTsc;
+
+} BINARY_OUTPUT_INDEX_ENTRY, *PBINARY_OUTPUT_INDEX_ENTRY;
+
+/**
+ * @brief The footer of the binary output file (the last part of the file)
+ * @details a file without the footer (e.g., the debugger is terminated)
+ * is still readable by walking the blocks from the header
+ *
+ */
+typedef struct _BINARY_OUTPUT_FILE_FOOTER
+{
+    UINT64 IndexOffset;
+    UINT32 BlocksCount;
+    UINT32 Reserved;
+    UINT64 Magic;
+
+} BINARY_OUTPUT_FILE_FOOTER, *PBINARY_OUTPUT_FILE_FOOTER;
+
+/**
+ * @brief The state of writing a binary output file (used by the writer
+ * thread of the output source)
+ *
+ */
+typedef struct _BINARY_OUTPUT_CONTEXT
+{
+    HANDLE                                 FileHandle;
+    COMPRESSOR_HANDLE                      Compressor;
+    UINT64                                 FileOffset;
+    UINT32                                 BlockRecordsCount;
+    UINT64                                 BlockFirstTsc;
+    UINT64                                 BlockLastTsc;
+    std::vector<CHAR>                      Block;
+    std::vector<CHAR>                      CompressedBlock;
+    std::vector<BINARY_OUTPUT_INDEX_ENTRY> Index;
+    std::map<UINT32, BOOLEAN>              WrittenFormats;
+
+} BINARY_OUTPUT_CONTEXT, *PBINARY_OUTPUT_CONTEXT;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+PBINARY_OUTPUT_CONTEXT
+BinaryOutputCreate(HANDLE FileHandle);
+
+VOID
+BinaryOutputBuildRecord(std::vector<CHAR> &  Record,
+                        UINT64               Tag,
+                        CHAR *               Message,
+                        UINT32               MessageLength,
+                        PBINARY_TRACE_RECORD TraceRecord);
+
+BOOLEAN
+BinaryOutputWriteMessage(PBINARY_OUTPUT_CONTEXT Context, CHAR * Message, UINT32 MessageLength);
+
+BOOLEAN
+BinaryOutputClose(PBINARY_OUTPUT_CONTEXT Context);
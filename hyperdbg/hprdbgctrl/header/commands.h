@@ -33,6 +33,12 @@ CommandSettingsSetValueFromConfigFile(std::string OptionName, std::string Option
 BOOLEAN
 CommandSettingsGetValueFromConfigFile(std::string OptionName, std::string & OptionValue);
 
+BOOLEAN
+CommandDirtySetTracking(BOOLEAN Enable);
+
+BOOLEAN
+CommandDirtyGetAndClear(UINT64 * Bitmap, UINT64 BitmapSize, UINT64 * EndAddress);
+
 //////////////////////////////////////////////////
 //                  Functions                   //
 //////////////////////////////////////////////////
@@ -64,6 +70,30 @@ ShowMemoryCommandDQ(unsigned char * OutputBuffer, UINT Size, UINT64 Address, DEB
 VOID
 CommandPteShowResults(UINT64 TargetVa, PDEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS PteRead);
 
+BOOLEAN
+CommandVmexitStatsSendRequest(PDEBUGGER_VMEXIT_STATISTICS_REQUEST StatisticsRequest);
+
+BOOLEAN
+CommandPatchSendRequest(PDEBUGGER_PATCH_MEMORY_REQUEST PatchMemRequest);
+
+BOOLEAN
+CommandEditMemoryBatchBegin();
+
+BOOLEAN
+CommandEditMemoryBatchIsBatchableCommand(const std::string & Command);
+
+BOOLEAN
+CommandEditMemoryBatchAppend(PDEBUGGER_EDIT_MEMORY EditMemoryRequest, const vector<UINT64> & Values, const string & Command);
+
+BOOLEAN
+CommandEditMemoryBatchFlush();
+
+VOID
+CommandEditMemoryBatchEnd();
+
+const char *
+CommandVmexitStatsGetReasonName(UINT32 Reason);
+
 DEBUGGER_CONDITIONAL_JUMP_STATUS
 HyperDbgIsConditionalJumpTaken(unsigned char * BufferToDisassemble,
                                UINT64          BuffLength,
@@ -86,6 +116,14 @@ HyperDbgDisassembler32(unsigned char * BufferToDisassemble,
                        BOOLEAN         ShowBranchIsTakenOrNot,
                        PRFLAGS         Rflags);
 
+BOOLEAN
+HyperDbgDisassembleToFile(unsigned char * BufferToDisassemble,
+                          UINT64          BaseAddress,
+                          UINT64          Size,
+                          BOOLEAN         Isx86_64,
+                          const string &  FilePath,
+                          UINT64 *        CountOfInstructions);
+
 UINT32
 HyperDbgLengthDisassemblerEngine(
     unsigned char * BufferToDisassemble,
@@ -107,6 +145,15 @@ HyperDbgCheckWhetherTheCurrentInstructionIsCallOrRet(
     BOOLEAN         Isx86_64,
     PBOOLEAN        IsRet);
 
+VOID
+HyperDbgShowMemoryOrDisassemble(DEBUGGER_SHOW_MEMORY_STYLE   Style,
+                                UINT64                       Address,
+                                DEBUGGER_READ_MEMORY_TYPE    MemoryType,
+                                unsigned char *              OutputBuffer,
+                                UINT32                       Size,
+                                UINT32                       ReturnedLength,
+                                PDEBUGGER_DT_COMMAND_OPTIONS DtDetails);
+
 VOID
 HyperDbgReadMemoryAndDisassemble(DEBUGGER_SHOW_MEMORY_STYLE   Style,
                                  UINT64                       Address,
@@ -116,6 +163,15 @@ HyperDbgReadMemoryAndDisassemble(DEBUGGER_SHOW_MEMORY_STYLE   Style,
                                  UINT32                       Size,
                                  PDEBUGGER_DT_COMMAND_OPTIONS DtDetails);
 
+VOID
+HyperDbgReadMemoryAndDisassembleToFile(DEBUGGER_SHOW_MEMORY_STYLE Style,
+                                       UINT64                     Address,
+                                       DEBUGGER_READ_MEMORY_TYPE  MemoryType,
+                                       DEBUGGER_READ_READING_TYPE ReadingType,
+                                       UINT32                     Pid,
+                                       UINT32                     Size,
+                                       const string &             FilePath);
+
 VOID
 InitializeCommandsDictionary();
 
@@ -130,7 +186,7 @@ InitializeDebugger();
  * @brief Command's function type
  *
  */
-typedef VOID (*CommandFuncType)(vector<string> SplittedCommand, string Command);
+typedef VOID (*CommandFuncType)(vector<string> & SplittedCommand, string & Command);
 
 /**
  * @brief Command's help function type
@@ -152,9 +208,26 @@ typedef struct _COMMAND_DETAIL
 
 /**
  * @brief Type saving commands and mapping to command string
+ * @details the commands are looked up for each line of the scripts, the
+ * order of commands is not used so a hash table is used
  *
  */
-typedef std::map<std::string, COMMAND_DETAIL> CommandType;
+typedef std::unordered_map<std::string, COMMAND_DETAIL> CommandType;
+
+/**
+ * @brief Perfect hash table of the commands
+ * @details the table is built once from the list of commands, the seed
+ * of each bucket places all of the commands of the bucket into distinct
+ * slots (negative seeds are the slots of buckets with a single command),
+ * so each lookup hashes the command at most twice and compares one key
+ *
+ */
+typedef struct _COMMANDS_LOOKUP_TABLE
+{
+    vector<INT32>                Seeds; // Seed of each bucket
+    vector<CommandType::pointer> Slots; // Command of each slot (or NULL)
+
+} COMMANDS_LOOKUP_TABLE, *PCOMMANDS_LOOKUP_TABLE;
 
 /**
  * @brief Different attributes of commands
@@ -194,6 +267,8 @@ typedef std::map<std::string, COMMAND_DETAIL> CommandType;
 
 #define DEBUGGER_COMMAND_G_ATTRIBUTES DEBUGGER_COMMAND_ATTRIBUTE_ABSOLUTE_LOCAL | DEBUGGER_COMMAND_ATTRIBUTE_REPEAT_ON_ENTER
 
+#define DEBUGGER_COMMAND_GI_ATTRIBUTES DEBUGGER_COMMAND_ATTRIBUTE_ABSOLUTE_LOCAL | DEBUGGER_COMMAND_ATTRIBUTE_REPEAT_ON_ENTER
+
 #define DEBUGGER_COMMAND_ATTACH_ATTRIBUTES DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_COMMAND_IN_DEBUGGER_MODE
 
 #define DEBUGGER_COMMAND_DETACH_ATTRIBUTES DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_COMMAND_IN_DEBUGGER_MODE
@@ -224,6 +299,9 @@ typedef std::map<std::string, COMMAND_DETAIL> CommandType;
 #define DEBUGGER_COMMAND_DISCONNECT_ATTRIBUTES \
     DEBUGGER_COMMAND_ATTRIBUTE_ABSOLUTE_LOCAL
 
+#define DEBUGGER_COMMAND_SESSION_ATTRIBUTES \
+    DEBUGGER_COMMAND_ATTRIBUTE_ABSOLUTE_LOCAL
+
 #define DEBUGGER_COMMAND_DEBUG_ATTRIBUTES \
     DEBUGGER_COMMAND_ATTRIBUTE_ABSOLUTE_LOCAL | DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_CASE_SENSITIVE
 
@@ -263,6 +341,8 @@ typedef std::map<std::string, COMMAND_DETAIL> CommandType;
 #define DEBUGGER_COMMAND_LOGCLOSE_ATTRIBUTES \
     DEBUGGER_COMMAND_ATTRIBUTE_ABSOLUTE_LOCAL
 
+#define DEBUGGER_COMMAND_COUNTERS_ATTRIBUTES NULL
+
 #define DEBUGGER_COMMAND_TEST_ATTRIBUTES DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_COMMAND_IN_DEBUGGER_MODE
 
 #define DEBUGGER_COMMAND_CPU_ATTRIBUTES NULL
@@ -303,6 +383,8 @@ typedef std::map<std::string, COMMAND_DETAIL> CommandType;
 
 #define DEBUGGER_COMMAND_CRWRITE_ATTRIBUTES DEBUGGER_COMMAND_ATTRIBUTE_EVENT
 
+#define DEBUGGER_COMMAND_EXECTRACE_ATTRIBUTES DEBUGGER_COMMAND_ATTRIBUTE_EVENT
+
 #define DEBUGGER_COMMAND_DR_ATTRIBUTES DEBUGGER_COMMAND_ATTRIBUTE_EVENT
 
 #define DEBUGGER_COMMAND_IOIN_ATTRIBUTES DEBUGGER_COMMAND_ATTRIBUTE_EVENT
@@ -323,6 +405,23 @@ typedef std::map<std::string, COMMAND_DETAIL> CommandType;
 
 #define DEBUGGER_COMMAND_MEASURE_ATTRIBUTES NULL
 
+#define DEBUGGER_COMMAND_VMEXITSTATS_ATTRIBUTES NULL
+
+#define DEBUGGER_COMMAND_PROFILER_ATTRIBUTES NULL
+
+#define DEBUGGER_COMMAND_PEBS_ATTRIBUTES NULL
+
+#define DEBUGGER_COMMAND_DIRTY_ATTRIBUTES NULL
+
+#define DEBUGGER_COMMAND_LOCKSTATS_ATTRIBUTES NULL
+
+#define DEBUGGER_COMMAND_EPT_SNAPSHOT_ATTRIBUTES \
+    DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_COMMAND_IN_DEBUGGER_MODE | DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_CASE_SENSITIVE
+
+#define DEBUGGER_COMMAND_SNAPSHOT_ATTRIBUTES NULL
+
+#define DEBUGGER_COMMAND_RECORDS_ATTRIBUTES DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_CASE_SENSITIVE
+
 #define DEBUGGER_COMMAND_LM_ATTRIBUTES NULL
 
 #define DEBUGGER_COMMAND_P_ATTRIBUTES \
@@ -340,6 +439,9 @@ typedef std::map<std::string, COMMAND_DETAIL> CommandType;
 #define DEBUGGER_COMMAND_E_ATTRIBUTES \
     DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_COMMAND_IN_DEBUGGER_MODE | DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_CASE_SENSITIVE
 
+#define DEBUGGER_COMMAND_PATCH_ATTRIBUTES \
+    DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_COMMAND_IN_DEBUGGER_MODE | DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_CASE_SENSITIVE
+
 #define DEBUGGER_COMMAND_S_ATTRIBUTES \
     DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_COMMAND_IN_DEBUGGER_MODE | DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_CASE_SENSITIVE
 
@@ -392,242 +494,283 @@ typedef std::map<std::string, COMMAND_DETAIL> CommandType;
 //////////////////////////////////////////////////
 
 VOID
-CommandTest(vector<string> SplittedCommand, string Command);
+CommandTest(vector<string> & SplittedCommand, string & Command);
+
+VOID
+CommandClearScreen(vector<string> & SplittedCommand, string & Command);
+
+VOID
+CommandReadMemoryAndDisassembler(vector<string> & SplittedCommand, string & Command);
+
+VOID
+CommandConnect(vector<string> & SplittedCommand, string & Command);
+
+VOID
+CommandConnect(vector<string> & SplittedCommand, string & Command);
+
+VOID
+CommandLoad(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandClearScreen(vector<string> SplittedCommand, string Command);
+CommandUnload(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandReadMemoryAndDisassembler(vector<string> SplittedCommand,
-                                 string         Command);
+CommandScript(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandConnect(vector<string> SplittedCommand, string Command);
+CommandCpu(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandConnect(vector<string> SplittedCommand, string Command);
+CommandExit(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandLoad(vector<string> SplittedCommand, string Command);
+CommandDisconnect(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandUnload(vector<string> SplittedCommand, string Command);
+CommandSession(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandScript(vector<string> SplittedCommand, string Command);
+CommandFormats(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandCpu(vector<string> SplittedCommand, string Command);
+CommandRdmsr(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandExit(vector<string> SplittedCommand, string Command);
+CommandWrmsr(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandDisconnect(vector<string> SplittedCommand, string Command);
+CommandPte(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandFormats(vector<string> SplittedCommand, string Command);
+CommandMonitor(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandRdmsr(vector<string> SplittedCommand, string Command);
+CommandSyscallAndSysret(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandWrmsr(vector<string> SplittedCommand, string Command);
+CommandEptHook(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandPte(vector<string> SplittedCommand, string Command);
+CommandEptHook2(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandMonitor(vector<string> SplittedCommand, string Command);
+CommandVmexitStats(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandSyscallAndSysret(vector<string> SplittedCommand, string Command);
+CommandProfiler(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandEptHook(vector<string> SplittedCommand, string Command);
+CommandPebs(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandEptHook2(vector<string> SplittedCommand, string Command);
+CommandDirty(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandCpuid(vector<string> SplittedCommand, string Command);
+CommandLockStats(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandMsrread(vector<string> SplittedCommand, string Command);
+CommandEptSnapshot(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandMsrwrite(vector<string> SplittedCommand, string Command);
+CommandSnapshot(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandTsc(vector<string> SplittedCommand, string Command);
+CommandRecords(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandPmc(vector<string> SplittedCommand, string Command);
+CommandCpuid(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandException(vector<string> SplittedCommand, string Command);
+CommandMsrread(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandCrwrite(vector<string> SplittedCommand, string Command);
+CommandMsrwrite(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandDr(vector<string> SplittedCommand, string Command);
+CommandTsc(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandInterrupt(vector<string> SplittedCommand, string Command);
+CommandPmc(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandIoin(vector<string> SplittedCommand, string Command);
+CommandException(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandIoout(vector<string> SplittedCommand, string Command);
+CommandCrwrite(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandVmcall(vector<string> SplittedCommand, string Command);
+CommandExectrace(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandHide(vector<string> SplittedCommand, string Command);
+CommandDr(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandUnhide(vector<string> SplittedCommand, string Command);
+CommandInterrupt(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandLogopen(vector<string> SplittedCommand, string Command);
+CommandIoin(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandLogclose(vector<string> SplittedCommand, string Command);
+CommandIoout(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandVa2pa(vector<string> SplittedCommand, string Command);
+CommandVmcall(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandPa2va(vector<string> SplittedCommand, string Command);
+CommandHide(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandEvents(vector<string> SplittedCommand, string Command);
+CommandUnhide(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandG(vector<string> SplittedCommand, string Command);
+CommandLogopen(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandLm(vector<string> SplittedCommand, string Command);
+CommandLogclose(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandSleep(vector<string> SplittedCommand, string Command);
+CommandCounters(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandEditMemory(vector<string> SplittedCommand, string Command);
+CommandVa2pa(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandSearchMemory(vector<string> SplittedCommand, string Command);
+CommandPa2va(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandMeasure(vector<string> SplittedCommand, string Command);
+CommandEvents(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandSettings(vector<string> SplittedCommand, string Command);
+CommandG(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandFlush(vector<string> SplittedCommand, string Command);
+CommandGi(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandPause(vector<string> SplittedCommand, string Command);
+CommandLm(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandListen(vector<string> SplittedCommand, string Command);
+CommandSleep(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandStatus(vector<string> SplittedCommand, string Command);
+CommandEditMemory(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandAttach(vector<string> SplittedCommand, string Command);
+CommandPatch(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandDetach(vector<string> SplittedCommand, string Command);
+CommandSearchMemory(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandStart(vector<string> SplittedCommand, string Command);
+CommandMeasure(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandRestart(vector<string> SplittedCommand, string Command);
+CommandSettings(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandSwitch(vector<string> SplittedCommand, string Command);
+CommandFlush(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandKill(vector<string> SplittedCommand, string Command);
+CommandPause(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandT(vector<string> SplittedCommand, string Command);
+CommandListen(vector<string> & SplittedCommand, string & Command);
+
+VOID
+CommandStatus(vector<string> & SplittedCommand, string & Command);
+
+VOID
+CommandAttach(vector<string> & SplittedCommand, string & Command);
+
+VOID
+CommandDetach(vector<string> & SplittedCommand, string & Command);
+
+VOID
+CommandStart(vector<string> & SplittedCommand, string & Command);
+
+VOID
+CommandRestart(vector<string> & SplittedCommand, string & Command);
+
+VOID
+CommandSwitch(vector<string> & SplittedCommand, string & Command);
+
+VOID
+CommandKill(vector<string> & SplittedCommand, string & Command);
+
+VOID
+CommandT(vector<string> & SplittedCommand, string & Command);
+
+BOOLEAN
+CommandTraceSteps(vector<string> SplittedCommand, DEBUGGER_REMOTE_STEPPING_REQUEST StepType);
 
 VOID
-CommandI(vector<string> SplittedCommand, string Command);
+CommandI(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandPrint(vector<string> SplittedCommand, string Command);
+CommandPrint(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandOutput(vector<string> SplittedCommand, string Command);
+CommandOutput(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandDebug(vector<string> SplittedCommand, string Command);
+CommandDebug(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandP(vector<string> SplittedCommand, string Command);
+CommandP(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandCore(vector<string> SplittedCommand, string Command);
+CommandCore(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandProcess(vector<string> SplittedCommand, string Command);
+CommandProcess(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandThread(vector<string> SplittedCommand, string Command);
+CommandThread(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandEval(vector<string> SplittedCommand, string Command);
+CommandEval(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandR(vector<string> SplittedCommand, string Command);
+CommandR(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandBp(vector<string> SplittedCommand, string Command);
+CommandBp(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandBl(vector<string> SplittedCommand, string Command);
+CommandBl(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandBe(vector<string> SplittedCommand, string Command);
+CommandBe(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandBd(vector<string> SplittedCommand, string Command);
+CommandBd(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandBc(vector<string> SplittedCommand, string Command);
+CommandBc(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandSympath(vector<string> SplittedCommand, string Command);
+CommandSympath(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandSym(vector<string> SplittedCommand, string Command);
+CommandSym(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandX(vector<string> SplittedCommand, string Command);
+CommandX(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandPrealloc(vector<string> SplittedCommand, string Command);
+CommandPrealloc(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandDtAndStruct(vector<string> SplittedCommand, string Command);
+CommandDtAndStruct(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandK(vector<string> SplittedCommand, string Command);
+CommandK(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandPe(vector<string> SplittedCommand, string Command);
+CommandPe(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandRev(vector<string> SplittedCommand, string Command);
+CommandRev(vector<string> & SplittedCommand, string & Command);
 
 VOID
-CommandTrack(vector<string> SplittedCommand, string Command);
+CommandTrack(vector<string> & SplittedCommand, string & Command);
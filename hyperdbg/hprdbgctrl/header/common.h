@@ -99,6 +99,9 @@ ReplaceAll(string & str, const string & from, const string & to);
 const vector<string>
 Split(const string & s, const char & c);
 
+vector<std::string_view>
+SplitView(std::string_view s, const char & c);
+
 BOOLEAN
 IsNumber(const string & str);
 
@@ -20,6 +20,164 @@
 #define COM3_PORT 0x03E8
 #define COM4_PORT 0x02E8
 
+//
+// High-speed baud rates (not defined by Windows)
+//
+#ifndef CBR_230400
+#    define CBR_230400 230400
+#endif
+
+#ifndef CBR_460800
+#    define CBR_460800 460800
+#endif
+
+#ifndef CBR_921600
+#    define CBR_921600 921600
+#endif
+
+//////////////////////////////////////////
+//			Network Constants            //
+//////////////////////////////////////////
+
+/**
+ * @brief Size of the receive buffer of the UDP socket of the debugger
+ *
+ */
+#define NETWORK_CONNECTION_RECEIVE_BUFFER_SIZE 4 * 1024 * 1024
+
+#ifndef SIO_UDP_CONNRESET
+#    define SIO_UDP_CONNRESET _WSAIOW(IOC_VENDOR, 12)
+#endif
+
+//////////////////////////////////////////
+//		Remote Connection Constants     //
+//////////////////////////////////////////
+
+/**
+ * @brief Default interval (in milliseconds) of sending the coalesced
+ * results of the remote debuggee
+ *
+ */
+#define REMOTE_CONNECTION_DEFAULT_FLUSH_INTERVAL 10
+
+/**
+ * @brief Default size of the coalesced results after which they're
+ * sent without waiting for the flush interval
+ *
+ */
+#define REMOTE_CONNECTION_DEFAULT_MAXIMUM_BATCH_SIZE 0x4000
+
+/**
+ * @brief Maximum length of the payload of each frame
+ *
+ */
+#define REMOTE_CONNECTION_MAXIMUM_FRAME_SIZE 0x100000
+
+/**
+ * @brief Maximum count of the read-only clients of the multi-client
+ * server ('.listen multi')
+ *
+ */
+#define REMOTE_CONNECTION_MAXIMUM_OBSERVERS 16
+
+/**
+ * @brief Maximum count of the frames that are queued (not sent yet) for
+ * a read-only client, the results are dropped for the slow clients
+ *
+ */
+#define REMOTE_CONNECTION_MAXIMUM_OBSERVER_QUEUED_FRAMES 256
+
+/**
+ * @brief Maximum count of the remote debuggees that the debugger is
+ * connected to at the same time ('.connect' and '.session')
+ *
+ */
+#define REMOTE_CONNECTION_MAXIMUM_SESSIONS 64
+
+//////////////////////////////////////////
+//		Remote Connection Structures    //
+//////////////////////////////////////////
+
+/**
+ * @brief Types of the frames of the remote connection
+ *
+ */
+typedef enum _REMOTE_CONNECTION_FRAME_TYPE
+{
+    REMOTE_CONNECTION_FRAME_COMMAND = 1,    // A command (debugger to debuggee)
+    REMOTE_CONNECTION_FRAME_RESULTS,        // Coalesced results (debuggee to debugger)
+    REMOTE_CONNECTION_FRAME_END_OF_RESULTS, // Execution of the command is finished
+
+} REMOTE_CONNECTION_FRAME_TYPE;
+
+/**
+ * @brief The header of each frame of the remote connection, the
+ * header is followed by Length bytes of payload
+ *
+ */
+typedef struct _REMOTE_CONNECTION_FRAME_HEADER
+{
+    UINT32 Length;
+    UINT32 Type; // REMOTE_CONNECTION_FRAME_TYPE
+
+} REMOTE_CONNECTION_FRAME_HEADER, *PREMOTE_CONNECTION_FRAME_HEADER;
+
+/**
+ * @brief The results of the remote debuggee that are not sent yet
+ *
+ */
+typedef struct _REMOTE_CONNECTION_COALESCER
+{
+    BOOLEAN            IsLockInitialized;
+    BOOLEAN            IsStopping;
+    HANDLE             FlushThread;
+    CRITICAL_SECTION   Lock;
+    CONDITION_VARIABLE ResultsQueued;
+    std::vector<CHAR>  Results;
+
+} REMOTE_CONNECTION_COALESCER, *PREMOTE_CONNECTION_COALESCER;
+
+/**
+ * @brief A read-only client of the multi-client server
+ * @details the results of the commands of the controlling client are
+ * also sent to the read-only clients, the commands of the read-only
+ * clients are not executed, the flags are changed while the lock of
+ * the coalescer is held
+ *
+ */
+typedef struct _REMOTE_CONNECTION_OBSERVER
+{
+    BOOLEAN           IsUsed;
+    BOOLEAN           IsOpened; // The results can be sent to the client
+    SOCKET            Socket;
+    HANDLE            Thread;
+    UINT64            DroppedFrames;
+    TRANSPORT_CHANNEL Channel;
+
+} REMOTE_CONNECTION_OBSERVER, *PREMOTE_CONNECTION_OBSERVER;
+
+/**
+ * @brief A connection of the debugger (client) to a remote debuggee
+ * @details each session has its own channel and its own thread that
+ * receives the results, the commands are sent to the active session and
+ * the results of the other sessions are shown with the id of the session,
+ * the flags are changed while the lock of the sessions is held
+ *
+ */
+typedef struct _REMOTE_CONNECTION_SESSION
+{
+    BOOLEAN           IsUsed;
+    BOOLEAN           IsConnected; // The listening thread is receiving the results
+    UINT32            Id;
+    SOCKET            Socket;
+    HANDLE            ListeningThread;
+    HANDLE            EndOfMessageReceivedEvent;
+    TRANSPORT_CHANNEL Channel;
+    std::string       Ip;
+    std::string       Port;
+
+} REMOTE_CONNECTION_SESSION, *PREMOTE_CONNECTION_SESSION;
+
 //////////////////////////////////////////
 //			   	Server 		            //
 //////////////////////////////////////////
@@ -29,6 +187,9 @@ CommunicationServerCreateServerAndWaitForClient(PCSTR    Port,
                                                 SOCKET * ClientSocketArg,
                                                 SOCKET * ListenSocketArg);
 
+int
+CommunicationServerAcceptClient(SOCKET ListenSocket, SOCKET * ClientSocketArg);
+
 int
 CommunicationServerReceiveMessage(SOCKET ClientSocket, char * recvbuf, int recvbuflen);
 
@@ -58,12 +219,15 @@ CommunicationClientReceiveMessage(SOCKET ConnectSocket, CHAR * RecvBuf, UINT32 M
 int
 CommunicationClientCleanup(SOCKET ConnectSocket);
 
+int
+CommunicationClientCreateUdpSocket(PCSTR Ip, PCSTR Port, SOCKET * UdpSocketArg);
+
 //////////////////////////////////////////
 //     Handle Remote Connection         //
 //////////////////////////////////////////
 
 VOID
-RemoteConnectionListen(PCSTR Port);
+RemoteConnectionListen(PCSTR Port, BOOLEAN IsMultiClient);
 
 VOID
 RemoteConnectionConnect(PCSTR Ip, PCSTR Port);
@@ -74,5 +238,14 @@ RemoteConnectionSendCommand(const char * sendbuf, int len);
 int
 RemoteConnectionSendResultsToHost(const char * sendbuf, int len);
 
+int
+RemoteConnectionSendEndOfResultsToHost();
+
 int
 RemoteConnectionCloseTheConnectionWithDebuggee();
+
+VOID
+RemoteConnectionShowSessions();
+
+BOOLEAN
+RemoteConnectionSwitchSession(UINT32 Id);
@@ -0,0 +1,77 @@
+/**
+ * @file counters-export.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers of exporting the counters of the debugger and the hypervisor
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The default interval of sampling the counters (in milliseconds)
+ *
+ */
+#define COUNTERS_EXPORT_DEFAULT_INTERVAL 1000
+
+/**
+ * @brief The minimum interval of sampling the counters (in milliseconds)
+ *
+ */
+#define COUNTERS_EXPORT_MINIMUM_INTERVAL 100
+
+/**
+ * @brief The keywords of the ETW provider of the counters, each group of
+ * counters is only queried if a session enables its keyword
+ *
+ */
+#define COUNTERS_EXPORT_KEYWORD_VMEXITS   0x1
+#define COUNTERS_EXPORT_KEYWORD_EVENTS    0x2
+#define COUNTERS_EXPORT_KEYWORD_LOGS      0x4
+#define COUNTERS_EXPORT_KEYWORD_POOLS     0x8
+#define COUNTERS_EXPORT_KEYWORD_TRANSPORT 0x10
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The state of exporting the counters
+ * @details the buffers of the requests are allocated once the export is
+ * started and they're only used by the sampling thread
+ *
+ */
+typedef struct _COUNTERS_EXPORT_STATE
+{
+    BOOLEAN                                IsRunning;
+    HANDLE                                 SamplingThread;
+    HANDLE                                 StopEvent;
+    UINT32                                 Interval;        // Interval of sampling (in milliseconds)
+    volatile UINT64                        CountOfSamples;  // Samples that at least one group of counters is published
+    volatile UINT64                        CountOfFailures; // Queries that are failed (e.g., the driver is unloaded)
+    PDEBUGGER_VMEXIT_STATISTICS_REQUEST    VmexitStatistics;
+    PDEBUGGER_QUERY_EVENTS_STATISTICS      EventsStatistics;
+    PDEBUGGER_QUERY_LOG_BUFFERS_STATISTICS LogBuffersStatistics;
+    PDEBUGGER_POOL_MANAGER_STATISTICS      PoolManagerStatistics;
+
+} COUNTERS_EXPORT_STATE, *PCOUNTERS_EXPORT_STATE;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+BOOLEAN
+CountersExportStart(UINT32 Interval);
+
+VOID
+CountersExportStop();
+
+VOID
+CountersExportShowStatus();
@@ -54,6 +54,13 @@
 #define DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_VA2PA_AND_PA2VA_RESULT              0x16
 #define DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_PTE_RESULT                          0x17
 #define DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_SHORT_CIRCUITING_EVENT_STATE        0x18
+#define DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_BATCH_RESULT                        0x19
+#define DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_TRANSPORT_TEST_RESULT               0x1a
+#define DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_PATCH_MEMORY_RESULT                 0x1b
+#define DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_REGISTER_EVENTS_BATCH_RESULT        0x1c
+#define DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_QUERY_EVENTS_STATISTICS_RESULT      0x1d
+#define DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_EPT_SNAPSHOT_RESULT                 0x1e
+#define DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_HALT_WATCHDOG_RESULT                0x1f
 
 //////////////////////////////////////////////////
 //               Event Details                  //
@@ -110,6 +117,84 @@ typedef struct _DEBUGGER_SYNCRONIZATION_EVENTS_STATE
     BOOLEAN IsOnWaitingState;
 } DEBUGGER_SYNCRONIZATION_EVENTS_STATE, *PDEBUGGER_SYNCRONIZATION_EVENTS_STATE;
 
+/**
+ * @brief The events and actions that are queued to be registered at
+ * once ('events batch' command)
+ * @details the event is queued along with its actions, as the event
+ * and its actions should be in the same request (packet)
+ *
+ */
+typedef struct _DEBUGGER_EVENTS_BATCH
+{
+    BOOLEAN                                     IsActive;
+    PDEBUGGER_GENERAL_EVENT_DETAIL              PendingEvent; // Queued once its actions are registered
+    UINT32                                      PendingEventLength;
+    UINT32                                      CountOfEntries;
+    UINT32                                      CountOfRequests;
+    std::vector<BYTE>                           Entries;
+    std::vector<PDEBUGGER_GENERAL_EVENT_DETAIL> Events; // Added to the list of events once they're registered
+
+} DEBUGGER_EVENTS_BATCH, *PDEBUGGER_EVENTS_BATCH;
+
+//////////////////////////////////////////////////
+//            	   Log File                     //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Size of each buffer of the log file ('.logopen' command)
+ *
+ */
+#define LOGOPEN_BUFFER_SIZE 0x100000
+
+/**
+ * @brief Interval (in milliseconds) of writing the buffered messages
+ * to the log file
+ *
+ */
+#define LOGOPEN_FLUSH_INTERVAL 1000
+
+/**
+ * @brief The state of the log file ('.logopen' command)
+ * @details messages are appended to the active buffer and the writer
+ * thread writes the buffer to the file once it's half full or once
+ * the flush interval is passed, while the other buffer is being
+ * filled
+ *
+ */
+typedef struct _LOGOPEN_WRITER
+{
+    HANDLE             FileHandle;
+    HANDLE             WriterThread;
+    BOOLEAN            IsLockInitialized;
+    BOOLEAN            IsOpened;
+    CRITICAL_SECTION   Lock;
+    CONDITION_VARIABLE BufferHalfFull;
+    CONDITION_VARIABLE BufferNotFull;
+    UINT32             ActiveBuffer;
+    UINT32             ActiveLength;
+    CHAR               Buffers[2][LOGOPEN_BUFFER_SIZE];
+
+} LOGOPEN_WRITER, *PLOGOPEN_WRITER;
+
+//////////////////////////////////////////////////
+//            	   Edit Memory                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The state of gathering the edits of memory of a script
+ * @details the consecutive e* commands of a script are applied as the
+ * patches of a single patch request (a single packet in the debugger
+ * mode), the patches are kept in the order of the commands
+ *
+ */
+typedef struct _EDIT_MEMORY_BATCH_STATE
+{
+    BOOLEAN                        IsBatching; // Whether the edits are gathered into a patch request
+    PDEBUGGER_PATCH_MEMORY_REQUEST Request;    // The request followed by the stream of patches
+    vector<string>                 Commands;   // The command of each patch of the request
+
+} EDIT_MEMORY_BATCH_STATE, *PEDIT_MEMORY_BATCH_STATE;
+
 //////////////////////////////////////////////////
 //				    Functions                   //
 //////////////////////////////////////////////////
@@ -117,6 +202,12 @@ typedef struct _DEBUGGER_SYNCRONIZATION_EVENTS_STATE
 VOID
 InterpreterRemoveComments(char * CommandText);
 
+VOID
+InterpreterBuildCommandsLookupTable();
+
+PCOMMAND_DETAIL
+InterpreterFindCommand(std::string_view Command);
+
 BOOLEAN
 ShowErrorMessage(UINT32 Error);
 
@@ -139,6 +230,10 @@ InterpretConditionsAndCodes(vector<string> * SplittedCommand,
                             PUINT64          BufferAddress,
                             PUINT32          BufferLength);
 
+BOOLEAN
+InterpretEventRecordValues(string                               Values,
+                           PDEBUGGER_EVENT_RECORD_CONFIGURATION RecordConfiguration);
+
 VOID
 FreeEventsAndActionsMemory(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
                            PDEBUGGER_GENERAL_ACTION       ActionBreakToDebugger,
@@ -180,29 +275,61 @@ VOID
 CallstackShowFrames(PDEBUGGER_SINGLE_CALLSTACK_FRAME  CallstackFrames,
                     UINT32                            FrameCount,
                     DEBUGGER_CALLSTACK_DISPLAY_METHOD DisplayMethod,
-                    BOOLEAN                           Is32Bit);
+                    BOOLEAN                           Is32Bit,
+                    BOOLEAN                           IsUnwound);
+
+BOOLEAN
+CallstackFormatScriptStackTraceRecord(PSCRIPT_STACK_TRACE_RECORD Record, UINT32 RecordLength, std::string & Result);
 
 UINT64
 GetNewDebuggerEventTag();
 
+BOOLEAN
+DebuggerEventsBatchBegin();
+
+BOOLEAN
+DebuggerEventsBatchCommit();
+
+VOID
+DebuggerEventsBatchAbort();
+
 DWORD WINAPI
 ListeningSerialPauseDebuggeeThread(PVOID Param);
 
 DWORD WINAPI
 ListeningSerialPauseDebuggerThread(PVOID Param);
 
+DWORD WINAPI
+ListeningSerialBulkLinkDebuggerThread(PVOID Param);
+
 VOID
 LogopenSaveToFile(const char * Text);
 
+VOID
+LogopenSaveBufferToFile(const char * Buffer, UINT32 Length);
+
+VOID
+LogopenCloseFile();
+
 BOOL
 BreakController(DWORD CtrlType);
 
 VOID
 CommandEventsShowEvents();
 
+VOID
+CommandEventsShowStatistics(BOOLEAN Reset);
+
+BOOLEAN
+CommandEventsModifyAndQueryEvents(UINT64                            Tag,
+                                  DEBUGGER_MODIFY_EVENTS_TYPE       TypeOfAction,
+                                  PDEBUGGER_EVENT_SCRIPT_STATISTICS ScriptStatistics);
+
 BOOLEAN
-CommandEventsModifyAndQueryEvents(UINT64                      Tag,
-                                  DEBUGGER_MODIFY_EVENTS_TYPE TypeOfAction);
+CommandEventsModifyMonitorRange(UINT64                      Tag,
+                                DEBUGGER_MODIFY_EVENTS_TYPE TypeOfAction,
+                                UINT64                      RangeStart,
+                                UINT64                      RangeEnd);
 
 VOID
 CommandEventsHandleModifiedEvent(
@@ -237,7 +364,8 @@ VOID
 CommandTrackHandleReceivedInstructions(unsigned char * BufferToDisassemble,
                                        UINT32          BuffLength,
                                        BOOLEAN         Isx86_64,
-                                       UINT64          RipAddress);
+                                       UINT64          RipAddress,
+                                       UINT64          Tsc);
 
 VOID
 CommandTrackHandleReceivedCallInstructions(const char * NameOfFunctionFromSymbols,
@@ -0,0 +1,88 @@
+/**
+ * @file event-replay.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers of recording and replaying the messages of events
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum size of a block of a recording (compressed or not)
+ * @details a block is flushed once it's larger than BINARY_OUTPUT_BLOCK_SIZE,
+ * so it's at most a record (and its format) larger than it
+ *
+ */
+#define EVENT_REPLAY_MAXIMUM_BLOCK_SIZE (BINARY_OUTPUT_BLOCK_SIZE + 4 * PacketChunkSize)
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The state of recording the messages of events
+ * @details the messages are recorded by the threads that read the messages
+ * from the kernel, the recording is written in the binary output format
+ *
+ */
+typedef struct _EVENT_REPLAY_RECORDER
+{
+    CRITICAL_SECTION       Lock;
+    BOOLEAN                IsLockInitialized;
+    volatile BOOLEAN       IsRecording;
+    HANDLE                 FileHandle;
+    PBINARY_OUTPUT_CONTEXT BinaryOutput;
+    UINT64                 RecordsCount;
+    UINT64                 FailedRecords; // Records that are not written to the file
+
+} EVENT_REPLAY_RECORDER, *PEVENT_REPLAY_RECORDER;
+
+/**
+ * @brief The results of replaying a recording
+ *
+ */
+typedef struct _EVENT_REPLAY_RESULT
+{
+    UINT64  RecordsCount;        // Count of the records in the recording (including the formats)
+    UINT64  MessagesCount;       // Count of the messages that are forwarded
+    UINT64  SkippedMessages;     // Messages that can't be forwarded (e.g., unknown formats)
+    UINT64  BytesCount;          // Size of the forwarded messages
+    UINT64  ElapsedMicroseconds; // Duration of the replay
+    BOOLEAN IsInterrupted;       // The replay is interrupted by CTRL+C
+
+} EVENT_REPLAY_RESULT, *PEVENT_REPLAY_RESULT;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+BOOLEAN
+EventReplayStartRecording(const string & FilePath);
+
+BOOLEAN
+EventReplayStopRecording(UINT64 * RecordsCount, UINT64 * FailedRecords);
+
+BOOLEAN
+EventReplayIsRecording();
+
+VOID
+EventReplayRecordMessage(UINT64                       Tag,
+                         CHAR *                       Message,
+                         UINT32                       MessageLength,
+                         PBINARY_TRACE_RECORD         TraceRecord,
+                         PEVENT_FORWARDING_TIMESTAMPS Timestamps);
+
+BOOLEAN
+EventReplayPerform(const string &       FilePath,
+                   UINT64               OutputSourceTag,
+                   BOOLEAN              RecordedSpeed,
+                   UINT64               TscFrequency,
+                   PEVENT_REPLAY_RESULT Result);
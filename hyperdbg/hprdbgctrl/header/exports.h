@@ -40,4 +40,22 @@ __declspec(dllexport) void HyperDbgSetTextMessageCallback(Callback handler);
 __declspec(dllexport) int HyperDbgScriptReadFileAndExecuteCommandline(int argc, char * argv[]);
 __declspec(dllexport) bool HyperDbgContinuePreviousCommand();
 __declspec(dllexport) bool HyperDbgCheckMultilineCommand(char * CurrentCommand, bool Reset);
+
+//
+// Structured (binary) interface
+//
+__declspec(dllexport) BOOLEAN HyperDbgReadMemory(PDEBUGGER_READ_MEMORY ReadMem, unsigned char * Buffer, UINT32 * ReturnedLength);
+__declspec(dllexport) BOOLEAN HyperDbgReadRegisters(PDEBUGGEE_REGISTERS_CONTEXT Registers);
+__declspec(dllexport) UINT64 HyperDbgRegisterEvent(PHYPERDBG_EVENT_REGISTRATION Registration);
+__declspec(dllexport) void HyperDbgSetEventCallback(EventCallback handler);
+__declspec(dllexport) BOOLEAN HyperDbgModifyMonitorRange(UINT64 Tag, BOOLEAN IsAdd, UINT64 StartAddress, UINT64 EndAddress);
+__declspec(dllexport) HANDLE HyperDbgContinueDebuggeeAsync(DebuggeePausedCallback Callback, PVOID Context);
+__declspec(dllexport) HANDLE HyperDbgPauseDebuggeeAsync(DebuggeePausedCallback Callback, PVOID Context);
+__declspec(dllexport) BOOLEAN HyperDbgIsDebuggeeRunning();
+
+//
+// Dirty pages
+//
+__declspec(dllexport) bool HyperDbgSetDirtyPagesTracking(bool Enable);
+__declspec(dllexport) bool HyperDbgGetAndClearDirtyPages(unsigned long long * Bitmap, unsigned long long BitmapSize, unsigned long long * EndAddress);
 }
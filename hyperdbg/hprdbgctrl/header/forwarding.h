@@ -21,6 +21,56 @@
  */
 #define MAXIMUM_CHARACTERS_FOR_EVENT_FORWARDING_NAME 50
 
+/**
+ * @brief maximum number of messages that are queued for a single
+ * output source
+ *
+ */
+#define EVENT_FORWARDING_QUEUE_MAXIMUM_MESSAGES 0x400
+
+/**
+ * @brief maximum number of messages that are written to an output
+ * source in a single write (send)
+ *
+ */
+#define EVENT_FORWARDING_MAXIMUM_MESSAGES_IN_BATCH 0x40
+
+/**
+ * @brief once the queue of an output source is half full, only one
+ * of each EVENT_FORWARDING_SAMPLING_RATE messages is queued in the
+ * sampling policy
+ *
+ */
+#define EVENT_FORWARDING_SAMPLING_RATE 8
+
+/**
+ * @brief maximum characters of the prefix filter of output sources
+ *
+ */
+#define EVENT_FORWARDING_FILTER_MAXIMUM_PREFIX 64
+
+/**
+ * @brief the core filter of output sources which accepts all the cores
+ *
+ */
+#define EVENT_FORWARDING_FILTER_ANY_CORE 0xffffffff
+
+/**
+ * @brief count of the sub-buckets of each power of two in the histograms
+ * of the latency of messages (log2)
+ *
+ */
+#define EVENT_FORWARDING_LATENCY_SUB_BUCKETS_BITS 3
+
+/**
+ * @brief count of the buckets of the histograms of the latency of messages
+ * @details values less than the count of sub-buckets have their own bucket,
+ * then each power of two (up to 2^63) is divided into the sub-buckets
+ *
+ */
+#define EVENT_FORWARDING_LATENCY_BUCKETS \
+    ((64 - EVENT_FORWARDING_LATENCY_SUB_BUCKETS_BITS + 1) << EVENT_FORWARDING_LATENCY_SUB_BUCKETS_BITS)
+
 /**
  * @brief event forwarding type
  *
@@ -29,7 +79,9 @@ typedef enum _DEBUGGER_EVENT_FORWARDING_TYPE
 {
     EVENT_FORWARDING_NAMEDPIPE,
     EVENT_FORWARDING_FILE,
-    EVENT_FORWARDING_TCP
+    EVENT_FORWARDING_TCP,
+    EVENT_FORWARDING_BINARY_FILE,
+    EVENT_FORWARDING_SHARED_MEMORY
 } DEBUGGER_EVENT_FORWARDING_TYPE;
 
 /**
@@ -43,6 +95,97 @@ typedef enum _DEBUGGER_EVENT_FORWARDING_STATE
     EVENT_FORWARDING_CLOSED
 } DEBUGGER_EVENT_FORWARDING_STATE;
 
+/**
+ * @brief event forwarding policies once the queue of the
+ * output source is full
+ *
+ */
+typedef enum _DEBUGGER_EVENT_FORWARDING_POLICY
+{
+    EVENT_FORWARDING_POLICY_BLOCK,
+    EVENT_FORWARDING_POLICY_DROP_OLDEST,
+    EVENT_FORWARDING_POLICY_SAMPLE
+} DEBUGGER_EVENT_FORWARDING_POLICY;
+
+/**
+ * @brief stages of delivering the messages of events to the output sources
+ * (for measuring the latency)
+ *
+ */
+typedef enum _EVENT_FORWARDING_LATENCY_STAGE
+{
+    EVENT_FORWARDING_LATENCY_STAGE_KERNEL_BUFFER,    // Saved in the kernel buffer till read from the buffer
+    EVENT_FORWARDING_LATENCY_STAGE_IOCTL_DRAIN,      // Read from the kernel buffer till received by the user-mode
+    EVENT_FORWARDING_LATENCY_STAGE_FORWARDING_QUEUE, // Queued for the output source till written to the source
+    EVENT_FORWARDING_LATENCY_STAGE_END_TO_END,       // Triggering the event till written to the source
+    EVENT_FORWARDING_LATENCY_STAGES_COUNT
+
+} EVENT_FORWARDING_LATENCY_STAGE;
+
+/**
+ * @brief time-stamp counters of a message of an event
+ * @details counters that are not available are zero (e.g., the messages
+ * that are directly read from the shared buffers are not read by IOCTLs)
+ *
+ */
+typedef struct _EVENT_FORWARDING_TIMESTAMPS
+{
+    UINT64 TriggerTimestamp;  // Triggering the event in vmx-root
+    UINT64 SavedTimestamp;    // Saving the message in the kernel buffer
+    UINT64 ReadTimestamp;     // Reading the message from the kernel buffer (IOCTL)
+    UINT64 ReceivedTimestamp; // Receiving the message in the user-mode
+
+} EVENT_FORWARDING_TIMESTAMPS, *PEVENT_FORWARDING_TIMESTAMPS;
+
+/**
+ * @brief histogram of the latency (in cycles) of a stage of delivering
+ * the messages
+ *
+ */
+typedef struct _EVENT_FORWARDING_LATENCY_HISTOGRAM
+{
+    volatile LONG64 Count;
+    volatile LONG64 Buckets[EVENT_FORWARDING_LATENCY_BUCKETS];
+
+} EVENT_FORWARDING_LATENCY_HISTOGRAM, *PEVENT_FORWARDING_LATENCY_HISTOGRAM;
+
+/**
+ * @brief a message that is queued for an output source
+ *
+ */
+typedef struct _DEBUGGER_EVENT_FORWARDING_MESSAGE
+{
+    CHAR * Buffer;
+    UINT32 Length;
+    UINT64 TriggerTimestamp; // Time-stamp counter of triggering the event (or zero)
+    UINT64 QueuedTimestamp;  // Time-stamp counter of queuing the message
+
+} DEBUGGER_EVENT_FORWARDING_MESSAGE, *PDEBUGGER_EVENT_FORWARDING_MESSAGE;
+
+/**
+ * @brief filters of the messages of an output source
+ * @details filters are evaluated (from the cheapest) before the message
+ * is queued, the core filter only applies to the binary trace records
+ * (the other messages don't have the core), once a source is muted the
+ * events that only use the muted (or not opened) sources don't generate
+ * their messages in the kernel
+ *
+ */
+typedef struct _DEBUGGER_EVENT_FORWARDING_FILTER
+{
+    BOOLEAN      IsMuted;
+    UINT32       CoreId;              // EVENT_FORWARDING_FILTER_ANY_CORE if not filtered
+    UINT32       SampleRate;          // Only one of each SampleRate messages is accepted (0 if not sampled)
+    UINT64       SampleCounter;
+    UINT32       RateLimit;           // Maximum messages per second (0 if not limited)
+    UINT32       RateLimitTokens;
+    ULONGLONG    RateLimitRefillTime; // Tick count of the last refill of the tokens
+    CHAR         Prefix[EVENT_FORWARDING_FILTER_MAXIMUM_PREFIX];
+    std::regex * Regex;               // NULL if not filtered
+    UINT64       FilteredMessages;
+
+} DEBUGGER_EVENT_FORWARDING_FILTER, *PDEBUGGER_EVENT_FORWARDING_FILTER;
+
 /**
  * @brief output source status
  *
@@ -68,11 +211,35 @@ typedef struct _DEBUGGER_EVENT_FORWARDING
     DEBUGGER_EVENT_FORWARDING_STATE State;
     HANDLE                          Handle;
     SOCKET                          Socket;
+    PBINARY_OUTPUT_CONTEXT          BinaryOutput;       // Only for binary files
+    PSHARED_MEMORY_OUTPUT_CONTEXT   SharedMemoryOutput; // Only for shared memory rings
     UINT64                          OutputUniqueTag;
     LIST_ENTRY
     OutputSourcesList; // Linked-list of output sources list
     CHAR Name[MAXIMUM_CHARACTERS_FOR_EVENT_FORWARDING_NAME];
 
+    //
+    // Queue of the messages which are written by the writer thread
+    //
+    DEBUGGER_EVENT_FORWARDING_POLICY  Policy;
+    HANDLE                            WriterThread;
+    BOOLEAN                           IsWriterStopping;
+    CRITICAL_SECTION                  QueueLock;
+    CONDITION_VARIABLE                QueueNotEmpty;
+    CONDITION_VARIABLE                QueueNotFull;
+    UINT32                            QueueHead;
+    UINT32                            QueueCount;
+    UINT64                            SampledMessages;
+    UINT64                            DroppedMessages;
+    DEBUGGER_EVENT_FORWARDING_MESSAGE Queue[EVENT_FORWARDING_QUEUE_MAXIMUM_MESSAGES];
+
+    //
+    // Filters of the messages (changed by the 'output' command while the
+    // messages are forwarded)
+    //
+    SRWLOCK                          FilterLock;
+    DEBUGGER_EVENT_FORWARDING_FILTER Filter;
+
 } DEBUGGER_EVENT_FORWARDING, *PDEBUGGER_EVENT_FORWARDING;
 
 //////////////////////////////////////////
@@ -96,7 +263,36 @@ ForwardingCreateOutputSource(DEBUGGER_EVENT_FORWARDING_TYPE SourceType,
 BOOLEAN
 ForwardingPerformEventForwarding(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetail,
                                  CHAR *                         Message,
-                                 UINT32                         MessageLength);
+                                 UINT32                         MessageLength,
+                                 PBINARY_TRACE_RECORD           TraceRecord,
+                                 PEVENT_FORWARDING_TIMESTAMPS   Timestamps);
+
+BOOLEAN
+ForwardingIsMessageFiltered(PDEBUGGER_EVENT_FORWARDING SourceDescriptor,
+                            CHAR *                     Message,
+                            UINT32                     MessageLength,
+                            PBINARY_TRACE_RECORD       TraceRecord);
+
+VOID
+ForwardingUpdateEventsOutputState();
+
+BOOLEAN
+ForwardingQueueMessage(PDEBUGGER_EVENT_FORWARDING SourceDescriptor,
+                       CHAR *                     Message,
+                       UINT32                     MessageLength,
+                       UINT64                     TriggerTimestamp);
+
+VOID
+ForwardingRecordLatency(EVENT_FORWARDING_LATENCY_STAGE Stage, UINT64 StartTimestamp, UINT64 EndTimestamp);
+
+UINT64
+ForwardingGetLatencyPercentile(EVENT_FORWARDING_LATENCY_STAGE Stage, UINT32 Percentile);
+
+VOID
+ForwardingResetLatency();
+
+DWORD WINAPI
+ForwardingWriterThread(LPVOID Parameter);
 
 BOOLEAN
 ForwardingWriteToFile(HANDLE FileHandle, CHAR * Message, UINT32 MessageLength);
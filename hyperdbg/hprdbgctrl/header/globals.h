@@ -50,15 +50,6 @@ UINT32 g_InterpreterCountOfOpenCurlyBrackets = 0;
 //		 Remote and Local Connection            //
 //////////////////////////////////////////////////
 
-/**
- * @brief the buffer that we set at the end of buffers for tcp connection
- */
-BYTE g_EndOfBufferCheckTcp[TCP_END_OF_BUFFER_CHARS_COUNT] = {
-    TCP_END_OF_BUFFER_CHAR_1,
-    TCP_END_OF_BUFFER_CHAR_2,
-    TCP_END_OF_BUFFER_CHAR_3,
-    TCP_END_OF_BUFFER_CHAR_4};
-
 /**
  * @brief Shows whether the user is allowed to use 'load' command
  * to load modules locally in VMI (virtual machine introspection) mode
@@ -81,12 +72,25 @@ BOOLEAN g_IsConnectedToRemoteDebuggee = FALSE;
 BOOLEAN g_IsConnectedToRemoteDebugger = FALSE;
 
 /**
- * @brief The socket object of host debugger (not debuggee)
- * it is because in HyperDbg, debuggee is server and debugger
- * is a client
+ * @brief The connections of host debugger (not debuggee) to the
+ * remote debuggees, it is because in HyperDbg, debuggee is server
+ * and debugger is a client
+ *
+ */
+REMOTE_CONNECTION_SESSION g_RemoteConnectionSessions[REMOTE_CONNECTION_MAXIMUM_SESSIONS];
+
+/**
+ * @brief The session that the commands are sent to
  *
  */
-SOCKET g_ClientConnectSocket = {0};
+PREMOTE_CONNECTION_SESSION g_RemoteConnectionActiveSession = NULL;
+
+/**
+ * @brief The lock of the sessions, it's also held while the results
+ * of a session are shown so the results of the sessions are not mixed
+ *
+ */
+SRWLOCK g_RemoteConnectionSessionsLock = SRWLOCK_INIT;
 
 /**
  * @brief The socket object of guest debuggee (not debugger)
@@ -97,51 +101,70 @@ SOCKET g_ClientConnectSocket = {0};
 SOCKET g_SeverSocket = {0};
 
 /**
- * @brief Server in debuggee needs an extra socket
+ * @brief The channel of the TCP connection (either the client or the
+ * server) which is served by the I/O thread
  *
  */
-SOCKET g_ServerListenSocket = {0};
+TRANSPORT_CHANNEL g_RemoteConnectionTransportChannel = {0};
 
 /**
- * @brief In debugger (not debuggee), we save the port of server
- * debuggee in this variable to use it later e.g, in signature
+ * @brief The results of the remote debuggee that are coalesced
+ * before sending them to the debugger
  *
  */
-string g_ServerPort = "";
+REMOTE_CONNECTION_COALESCER g_RemoteConnectionCoalescer;
 
 /**
- * @brief In debugger (not debuggee), we save the port of server
- * debuggee in this variable to use it later e.g, in signature
+ * @brief The read-only clients of the multi-client server ('.listen multi')
  *
  */
-string g_ServerIp = "";
+REMOTE_CONNECTION_OBSERVER g_RemoteConnectionObservers[REMOTE_CONNECTION_MAXIMUM_OBSERVERS];
 
 /**
- * @brief In debugger (not debuggee), we save the ip of server
- * debuggee in this variable to use it later e.g, in signature
+ * @brief The thread that accepts the read-only clients
  *
  */
-HANDLE g_RemoteDebuggeeListeningThread = NULL;
+HANDLE g_RemoteConnectionAcceptThread = NULL;
 
 /**
- * @brief Handle to show that if the debugger is loaded successfully
+ * @brief Interval (in milliseconds) of sending the coalesced results
+ * of the remote debuggee ('settings remoteflushinterval')
  *
  */
-HANDLE g_IsDriverLoadedSuccessfully = NULL;
+UINT32 g_RemoteConnectionFlushInterval = REMOTE_CONNECTION_DEFAULT_FLUSH_INTERVAL;
+
+/**
+ * @brief Size of the coalesced results after which they're sent
+ * without waiting ('settings remotebatchsize')
+ *
+ */
+UINT32 g_RemoteConnectionMaximumBatchSize = REMOTE_CONNECTION_DEFAULT_MAXIMUM_BATCH_SIZE;
+
+/**
+ * @brief Server in debuggee needs an extra socket
+ *
+ */
+SOCKET g_ServerListenSocket = {0};
 
 /**
- * @brief Handle to if the end of the message received (for showing
- * signature)
+ * @brief In debugger (not debuggee), we save the port of server
+ * debuggee in this variable to use it later e.g, in signature
  *
  */
-HANDLE g_EndOfMessageReceivedEvent = NULL;
+string g_ServerPort = "";
 
 /**
- * @brief variable to keep track if the end of the message received
- * (for showing signature)
+ * @brief In debugger (not debuggee), we save the port of server
+ * debuggee in this variable to use it later e.g, in signature
  *
  */
-BOOLEAN g_IsEndOfMessageReceived = FALSE;
+string g_ServerIp = "";
+
+/**
+ * @brief Handle to show that if the debugger is loaded successfully
+ *
+ */
+HANDLE g_IsDriverLoadedSuccessfully = NULL;
 
 /**
  * @brief In both debuggee and debugger we save the state of
@@ -180,13 +203,19 @@ DEBUGGER_SYNCRONIZATION_EVENTS_STATE g_UserSyncronizationObjectsHandleTable
 //////////////////////////////////////////////////
 
 /**
- * @brief the buffer that we set at the end of buffers for serial
+ * @brief Sequence number of the next frame that is sent over serial
  */
-BYTE g_EndOfBufferCheckSerial[SERIAL_END_OF_BUFFER_CHARS_COUNT] = {
-    SERIAL_END_OF_BUFFER_CHAR_1,
-    SERIAL_END_OF_BUFFER_CHAR_2,
-    SERIAL_END_OF_BUFFER_CHAR_3,
-    SERIAL_END_OF_BUFFER_CHAR_4};
+UINT32 g_KdSerialSendSequenceNumber = 0;
+
+/**
+ * @brief Whether the crc32 instruction (SSE4.2) is supported or not
+ */
+BOOLEAN g_KdIsSse42Supported = FALSE;
+
+/**
+ * @brief Whether the remote system accepts CRC32C frames or not
+ */
+BOOLEAN g_KdIsPeerCrc32cSupported = FALSE;
 
 /**
  * @brief In debugger (not debuggee), we save the handle
@@ -223,6 +252,15 @@ HANDLE g_SerialListeningThreadHandle = NULL;
  */
 HANDLE g_SerialRemoteComPortHandle = NULL;
 
+/**
+ * @brief In debuggee and debugger, we save the handle of the bulk
+ * link (second port or pipe) and (in debugger) the handle of the
+ * thread that listens to it here
+ *
+ */
+HANDLE g_SerialRemoteComPortBulkHandle   = NULL;
+HANDLE g_SerialBulkListeningThreadHandle = NULL;
+
 /**
  * @brief Shows if the debugger was connected to
  * remote debuggee over (A remote guest)
@@ -237,6 +275,137 @@ BOOLEAN g_IsSerialConnectedToRemoteDebuggee = FALSE;
  */
 BOOLEAN g_IsSerialConnectedToRemoteDebugger = FALSE;
 
+/**
+ * @brief The state of receiving the chunks of the memory that
+ * is read from the debuggee
+ *
+ */
+KD_READ_MEMORY_STREAM g_KdReadMemoryStream = {0};
+
+/**
+ * @brief The last registers of the current core of the debuggee
+ * that are received
+ *
+ */
+KD_REGISTERS_CONTEXT_CACHE g_KdRegistersContextCache = {0};
+
+/**
+ * @brief Pages of the memory of the halted debuggee that are already read
+ * @details the key is the address of the page and the type of memory and
+ * the process id of the request
+ *
+ */
+std::map<std::pair<UINT64, UINT64>, std::vector<BYTE>> g_KdMemoryCache;
+
+/**
+ * @brief Processes of the halted debuggee that are already queried
+ *
+ */
+std::vector<DEBUGGEE_PROCESS_LIST_DETAILS_ENTRY> g_KdObjectCacheProcesses;
+
+/**
+ * @brief Shows whether the processes of the halted debuggee are queried
+ * or not
+ *
+ */
+BOOLEAN g_KdObjectCacheProcessesIsValid = FALSE;
+
+/**
+ * @brief Threads of the halted debuggee that are already queried
+ * @details the key is the requested process (null for the current process)
+ *
+ */
+std::map<UINT64, std::vector<DEBUGGEE_THREAD_LIST_DETAILS_ENTRY>> g_KdObjectCacheThreads;
+
+/**
+ * @brief The last result of querying the entries of the list of
+ * processes or threads (the packet followed by the entries)
+ *
+ */
+std::vector<BYTE> g_KdObjectCacheQueryResult;
+
+/**
+ * @brief The state of gathering requests into a batch
+ *
+ */
+KD_BATCH_REQUESTS_STATE g_KdBatchRequests = {0};
+
+/**
+ * @brief The result of the last packet of the transport test
+ *
+ */
+DEBUGGEE_TRANSPORT_TEST_PACKET g_KdTransportTestResult = {0};
+
+/**
+ * @brief The result of the last request of patching memory
+ *
+ */
+DEBUGGER_PATCH_MEMORY_REQUEST g_KdPatchMemoryResult = {0};
+
+/**
+ * @brief The state of gathering the e* commands of a script into
+ * a single patch request
+ *
+ */
+EDIT_MEMORY_BATCH_STATE g_EditMemoryBatch;
+
+/**
+ * @brief The result of the last request of the snapshot of the memory
+ *
+ */
+DEBUGGER_EPT_SNAPSHOT_REQUEST g_KdEptSnapshotResult = {0};
+
+/**
+ * @brief The result of the last request of the watchdog of the halts
+ *
+ */
+DEBUGGER_HALT_WATCHDOG_REQUEST g_KdHaltWatchdogResult = {0};
+
+/**
+ * @brief The result of the last request of registering a batch of events
+ *
+ */
+DEBUGGER_EVENTS_BATCH_REQUEST g_KdEventsBatchResult = {0};
+
+/**
+ * @brief The result of the last query of the hit statistics of events
+ *
+ */
+DEBUGGER_QUERY_EVENTS_STATISTICS g_KdEventsStatisticsResult = {0};
+
+/**
+ * @brief The requests that wait for the debuggee to be paused without
+ * blocking the caller (SDK)
+ *
+ */
+std::vector<KD_ASYNC_PAUSE_REQUEST> g_KdAsyncPauseRequests;
+
+/**
+ * @brief The registered wait (thread pool) that waits for the debuggee
+ * to be paused instead of the blocked threads
+ *
+ */
+HANDLE g_KdAsyncPauseWaitHandle = NULL;
+
+/**
+ * @brief The lock of the requests that wait for the debuggee to be paused
+ *
+ */
+SRWLOCK g_KdAsyncPauseRequestsLock = SRWLOCK_INIT;
+
+/**
+ * @brief The events and actions that are queued to be registered
+ * at once ('events batch')
+ *
+ */
+DEBUGGER_EVENTS_BATCH g_EventsBatch;
+
+/**
+ * @brief The buffer that the requests of a batch are gathered into
+ *
+ */
+BYTE g_KdBatchRequestsBuffer[MaxSerialBatchRequestsSize] = {0};
+
 /**
  * @brief Shows if the debuggee is running or not
  *
@@ -263,6 +432,13 @@ ULONG g_CurrentRemoteCore = DEBUGGER_DEBUGGEE_IS_RUNNING_NO_CORE;
  */
 BOOLEAN g_IsDebuggerConntectedToNamedPipe = FALSE;
 
+/**
+ * @brief Shows if the debugger is connected to the
+ * debuggee over the network (UDP)
+ *
+ */
+BOOLEAN g_IsDebuggerConnectedToNetwork = FALSE;
+
 /**
  * @brief An event to make sure that the user won't give any command in debuggee
  * and all the commands are coming from just the debugger
@@ -284,13 +460,44 @@ DEBUGGER_EVENT_AND_ACTION_REG_BUFFER g_DebuggeeResultOfAddingActionsToEvent = {
     0};
 
 /**
- * @brief This is an OVERLAPPED structure for managing simultaneous
- * read and writes for debugger (in current design debuggee is not needed
- * to read and write simultaneously)
+ * @brief The channel of the serial (or named pipe) connection of the
+ * debugger which is served by the I/O thread (in current design debuggee
+ * is not needed to read and write simultaneously)
+ *
+ */
+TRANSPORT_CHANNEL g_KdTransportChannel = {0};
+
+/**
+ * @brief The channel of the bulk link of the serial (or named pipe)
+ * connection of the debugger, the debuggee only sends the bulk data
+ * over this link
+ *
+ */
+TRANSPORT_CHANNEL g_KdBulkTransportChannel = {0};
+
+/**
+ * @brief The links that the debugger receives the frames of the
+ * debuggee from
  *
  */
-OVERLAPPED g_OverlappedIoStructureForReadDebugger  = {0};
-OVERLAPPED g_OverlappedIoStructureForWriteDebugger = {0};
+KD_RECEIVING_LINK g_KdControlReceivingLink = {&g_KdTransportChannel};
+KD_RECEIVING_LINK g_KdBulkReceivingLink    = {&g_KdBulkTransportChannel};
+
+/**
+ * @brief The completion port and the thread that serve all of the
+ * transport channels
+ *
+ */
+HANDLE g_TransportCompletionPort = NULL;
+HANDLE g_TransportIoThread       = NULL;
+
+/**
+ * @brief Count of bytes that are sent and received over all of the
+ * transport channels (only changed by the I/O thread)
+ *
+ */
+volatile UINT64 g_TransportSentBytes     = 0;
+volatile UINT64 g_TransportReceivedBytes = 0;
 
 /**
  * @brief Shows whether the queried event is enabled or disabled
@@ -298,6 +505,12 @@ OVERLAPPED g_OverlappedIoStructureForWriteDebugger = {0};
  */
 BOOLEAN g_SharedEventStatus = FALSE;
 
+/**
+ * @brief The cost of the scripts of the queried event
+ *
+ */
+DEBUGGER_EVENT_SCRIPT_STATISTICS g_SharedEventScriptStatistics = {0};
+
 //////////////////////////////////////////////////
 //				 Global Variables               //
 //////////////////////////////////////////////////
@@ -315,6 +528,12 @@ BOOLEAN g_ShouldPreviousCommandBeContinued;
  */
 CommandType g_CommandsList;
 
+/**
+ * @brief Perfect hash table for finding the commands
+ *
+ */
+COMMANDS_LOOKUP_TABLE g_CommandsLookupTable;
+
 /**
  * @brief Holder of global variables for script engine
  *
@@ -333,6 +552,19 @@ UINT64 * g_ScriptLocalVariables;
  */
 UINT64 * g_ScriptTempVariables;
 
+/**
+ * @brief Holder of the scratch memory (buffers of the 'scratch'
+ * function) for script engine
+ *
+ */
+BYTE * g_ScriptScratchArena;
+
+/**
+ * @brief Allocated bytes of the scratch memory of script engine
+ *
+ */
+UINT32 g_ScriptScratchUsed;
+
 /**
  * @brief Is list of command initialized
  *
@@ -410,6 +642,13 @@ BOOLEAN g_OutputSourcesInitialized = FALSE;
  */
 LIST_ENTRY g_OutputSources = {0};
 
+/**
+ * @brief Histograms of the latency of delivering the messages of events
+ * to the output sources (for each stage)
+ *
+ */
+EVENT_FORWARDING_LATENCY_HISTOGRAM g_EventForwardingLatency[EVENT_FORWARDING_LATENCY_STAGES_COUNT] = {0};
+
 /**
  * @brief Holds the location driver to install it
  *
@@ -431,12 +670,33 @@ TCHAR g_TestLocation[MAX_PATH] = {0};
  */
 Callback g_MessageHandler = 0;
 
+/**
+ * @brief The handler of the pausing packets (e.g., triggered events)
+ * that is set by the SDK, the packets are passed without formatting
+ *
+ */
+EventCallback g_EventCallback = NULL;
+
+/**
+ * @brief The buffer that the result of reading all registers is saved
+ * in (instead of being shown) by HyperDbgReadRegisters
+ * @details it's set to NULL once the result is saved
+ *
+ */
+PDEBUGGEE_REGISTERS_CONTEXT g_KdRegistersReadBuffer = NULL;
+
 /**
  * @brief Shows whether the vmxoff process start or not
  *
  */
 BOOLEAN g_IsVmxOffProcessStart;
 
+/**
+ * @brief Handle of the thread that reads the messages of the kernel
+ *
+ */
+HANDLE g_IrpBasedBufferThread = NULL;
+
 /**
  * @brief Holds the global handle of device which is used
  * to send the request to the kernel by IOCTL, this
@@ -454,10 +714,10 @@ HANDLE g_DeviceHandle;
 BOOLEAN g_LogOpened = FALSE;
 
 /**
- * @brief The object of log file ('.logopen' command)
+ * @brief The buffered writer of log file ('.logopen' command)
  *
  */
-ofstream g_LogOpenFile;
+LOGOPEN_WRITER g_LogOpenWriter = {0};
 
 /**
  * @brief Shows whether the target is executing a script
@@ -474,6 +734,13 @@ BOOLEAN g_ExecutingScript = FALSE;
  */
 BOOLEAN g_BreakPrintingOutput = FALSE;
 
+/**
+ * @brief Count of the messages of the stress test (log flooding) that
+ * are received from the kernel
+ *
+ */
+volatile LONG64 g_KernelStressReceivedMessages = 0;
+
 /**
  * @brief Executing symbol reloading or downloading
  * routines
@@ -482,10 +749,16 @@ BOOLEAN g_BreakPrintingOutput = FALSE;
 BOOLEAN g_IsExecutingSymbolLoadingRoutines = FALSE;
 
 /**
- * @brief Symbol table for disassembler
+ * @brief Symbol table for disassembler (sorted by the address of objects)
  *
  */
-std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION> g_DisassemblerSymbolMap;
+std::vector<LOCAL_FUNCTION_DESCRIPTION> g_DisassemblerSymbolMap;
+
+/**
+ * @brief Pool of the names of objects in the symbol table for disassembler
+ *
+ */
+std::vector<CHAR> g_DisassemblerSymbolNames;
 
 /**
  * @brief Shows whether the user executed and mesaured '!measure'
@@ -561,6 +834,30 @@ BOOLEAN g_AddressConversion = TRUE;
  */
 BOOLEAN g_AutoFlush = FALSE;
 
+/**
+ * @brief Whether the results of printf are sent as binary trace
+ * records (formatted in the user-mode) or not
+ * @details it is disabled by default
+ *
+ */
+BOOLEAN g_BinaryTraceMode = FALSE;
+
+/**
+ * @brief Count of chunks of the message buffers of each core
+ * @details zero means that the driver uses the default capacity, it's
+ * passed to the driver when it's loaded
+ *
+ */
+UINT32 g_LogPacketsCapacityPerCore = 0;
+
+/**
+ * @brief Message buffers of each core are grown up to this count of chunks
+ * @details zero means that the buffers are not grown, it's passed to the
+ * driver when it's loaded
+ *
+ */
+UINT32 g_LogMaximumPacketsCapacityPerCore = 0;
+
 /**
  * @brief Shows the syntax used in !u !u2 u u2 commands
  * @details INTEL = 1, ATT = 2, MASM = 3
@@ -593,6 +890,13 @@ UINT32 g_SymbolTableSize = NULL;
  */
 UINT32 g_SymbolTableCurrentIndex = NULL;
 
+/**
+ * @brief The count of entries that the buffer of symbol
+ * table (received from the debuggee) can hold
+ *
+ */
+UINT32 g_SymbolTableCapacity = NULL;
+
 /**
  * @brief Result of the expression that is evaluated in the
  * debuggee
@@ -27,6 +27,9 @@ CommandConnectHelp();
 VOID
 CommandDisconnectHelp();
 
+VOID
+CommandSessionHelp();
+
 VOID
 CommandExitHelp();
 
@@ -93,6 +96,9 @@ CommandExceptionHelp();
 VOID
 CommandCrwriteHelp();
 
+VOID
+CommandExectraceHelp();
+
 VOID
 CommandDrHelp();
 
@@ -123,6 +129,9 @@ CommandLogopenHelp();
 VOID
 CommandLogcloseHelp();
 
+VOID
+CommandCountersHelp();
+
 VOID
 CommandVa2paHelp();
 
@@ -135,6 +144,9 @@ CommandEventsHelp();
 VOID
 CommandGHelp();
 
+VOID
+CommandGiHelp();
+
 VOID
 CommandClearScreenHelp();
 
@@ -144,12 +156,39 @@ CommandSleepHelp();
 VOID
 CommandEditMemoryHelp();
 
+VOID
+CommandPatchHelp();
+
 VOID
 CommandSearchMemoryHelp();
 
 VOID
 CommandMeasureHelp();
 
+VOID
+CommandVmexitStatsHelp();
+
+VOID
+CommandProfilerHelp();
+
+VOID
+CommandPebsHelp();
+
+VOID
+CommandDirtyHelp();
+
+VOID
+CommandLockStatsHelp();
+
+VOID
+CommandEptSnapshotHelp();
+
+VOID
+CommandSnapshotHelp();
+
+VOID
+CommandRecordsHelp();
+
 VOID
 CommandLmHelp();
 
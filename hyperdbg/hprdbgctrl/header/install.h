@@ -49,9 +49,10 @@ fnhprdbgctrl(void);
 ////
 //////////////////////////////////////////////////
 
-#define DRIVER_FUNC_INSTALL 0x01
-#define DRIVER_FUNC_STOP    0x02
-#define DRIVER_FUNC_REMOVE  0x03
+#define DRIVER_FUNC_INSTALL       0x01
+#define DRIVER_FUNC_STOP          0x02
+#define DRIVER_FUNC_REMOVE        0x03
+#define DRIVER_FUNC_QUERY_RUNNING 0x04
 
 BOOLEAN
 ManageDriver(_In_ LPCTSTR DriverName, _In_ LPCTSTR ServiceName, _In_ UINT16 Function);
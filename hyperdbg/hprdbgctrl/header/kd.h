@@ -35,6 +35,134 @@
         SetEvent(SyncronizationObject->EventHandle);                       \
     } while (FALSE);
 
+/**
+ * @brief Size of the memory around the requested memory that is
+ * fetched from the halted debuggee (power of two)
+ *
+ */
+#define KdMemoryCachePrefetchSize MaxSerialReadMemoryChunkSize
+
+/**
+ * @brief Maximum count of pages of the memory of the halted debuggee
+ * that are cached
+ *
+ */
+#define KdMemoryCacheMaximumPages 4096
+
+/**
+ * @brief Size of the buffer that the debugger receives the data
+ * of the debuggee into
+ *
+ */
+#define KdSerialReceiveBufferSize 16 * NORMAL_PAGE_SIZE
+
+//////////////////////////////////////////////////
+//		            Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The state of receiving the chunks of a read memory request
+ *
+ */
+typedef struct _KD_READ_MEMORY_STREAM
+{
+    unsigned char * Buffer;             // The chunks are saved here
+    UINT32          Size;               // Size of the buffer (size of the request)
+    UINT32          ReceivedLength;     // Count of bytes that are received
+    UINT32          NextSequenceNumber; // Sequence number of the next expected chunk
+    UINT32          KernelStatus;       // Status of the first failed chunk (if any)
+
+} KD_READ_MEMORY_STREAM, *PKD_READ_MEMORY_STREAM;
+
+/**
+ * @brief The last registers of a core of the debuggee that are
+ * received (for applying the changed registers)
+ *
+ */
+typedef struct _KD_REGISTERS_CONTEXT_CACHE
+{
+    ULONG                      CoreId;
+    UINT32                     ContextId; // Zero if there is no registers
+    DEBUGGEE_REGISTERS_CONTEXT Registers;
+
+} KD_REGISTERS_CONTEXT_CACHE, *PKD_REGISTERS_CONTEXT_CACHE;
+
+/**
+ * @brief Details of connecting the debugger and the debuggee
+ * over the network
+ *
+ */
+typedef struct _KD_NETWORK_CONNECTION_DETAILS
+{
+    UINT32 NetworkAdapterPciAddress; // Bus << 8 | Device << 3 | Function (only debuggee)
+    UINT32 DebuggeeIpAddress;        // Network byte order
+    UINT32 DebuggerIpAddress;        // Network byte order (only debuggee)
+    UINT16 UdpPort;
+
+} KD_NETWORK_CONNECTION_DETAILS, *PKD_NETWORK_CONNECTION_DETAILS;
+
+/**
+ * @brief Details of the bulk link of the serial (or named pipe)
+ * connection
+ * @details the bulk data of the debuggee (chunks of memory and messages
+ * of events) is sent over the bulk link, while the other packets remain
+ * on the control link
+ *
+ */
+typedef struct _KD_BULK_LINK_DETAILS
+{
+    const char * PortName; // Name of the second port (or the second pipe in debugger)
+    UINT32       Port;     // Address of the second port (only debuggee)
+
+} KD_BULK_LINK_DETAILS, *PKD_BULK_LINK_DETAILS;
+
+/**
+ * @brief A link that the debugger receives the frames of the debuggee from
+ * @details the data after the end of a frame remains in the receive
+ * buffer for the next frame (between ReceiveBufferStart and
+ * ReceiveBufferEnd)
+ *
+ */
+typedef struct _KD_RECEIVING_LINK
+{
+    PTRANSPORT_CHANNEL Channel;
+    UINT32             ReceiveBufferStart;
+    UINT32             ReceiveBufferEnd;
+    BYTE               ReceiveBuffer[KdSerialReceiveBufferSize];
+    BYTE               CompressedBuffer[MaxSerialPacketSize]; // Compressed frames are received into this buffer
+
+} KD_RECEIVING_LINK, *PKD_RECEIVING_LINK;
+
+/**
+ * @brief The state of gathering requests into a batch
+ * @details the requests of a batch are sent to the debuggee in a single
+ * packet and their results are received in a single packet
+ *
+ */
+typedef struct _KD_BATCH_REQUESTS_STATE
+{
+    BOOLEAN IsBatching;      // Whether the requests are gathered into a batch
+    UINT32  CountOfRequests; // Count of requests that are gathered
+    UINT32  Length;          // Length of the gathered requests (including the header)
+    UINT32  ResultsLength;   // Length of the results of the gathered requests (including the header)
+    UINT32  FirstRequestId;  // Id of the first request of the batch
+    UINT32  NextRequestId;   // Id of the next request
+
+} KD_BATCH_REQUESTS_STATE, *PKD_BATCH_REQUESTS_STATE;
+
+/**
+ * @brief A request that waits for the debuggee to be paused without
+ * blocking the caller
+ *
+ */
+typedef struct _KD_ASYNC_PAUSE_REQUEST
+{
+    HANDLE                 CompletionEvent; // Signaled once the debuggee is paused (closed after completion)
+    DebuggeePausedCallback Callback;        // Called once the debuggee is paused (optional)
+    PVOID                  Context;         // Parameter of the callback
+
+} KD_ASYNC_PAUSE_REQUEST, *PKD_ASYNC_PAUSE_REQUEST;
+
 //////////////////////////////////////////////////
 //		    Display Windows Details             //
 //////////////////////////////////////////////////
@@ -80,19 +208,33 @@ KdCommandPacketAndBufferToDebuggee(
 
 BOOLEAN
 KdPrepareSerialConnectionToRemoteSystem(HANDLE  SerialHandle,
-                                        BOOLEAN IsNamedPipe);
+                                        HANDLE  BulkHandle,
+                                        BOOLEAN IsNamedPipe,
+                                        BOOLEAN IsNetwork);
+
+BOOLEAN
+KdPrepareAndConnectDebugPort(const char *                   PortName,
+                             DWORD                          Baudrate,
+                             UINT32                         Port,
+                             BOOLEAN                        IsPreparing,
+                             BOOLEAN                        IsNamedPipe,
+                             PKD_NETWORK_CONNECTION_DETAILS NetworkDetails,
+                             PKD_BULK_LINK_DETAILS          BulkLinkDetails);
 
 BOOLEAN
-KdPrepareAndConnectDebugPort(const char * PortName, DWORD Baudrate, UINT32 Port, BOOLEAN IsPreparing, BOOLEAN IsNamedPipe);
+KdSendPacketToDebuggee(const CHAR * Buffer, UINT32 Length);
 
 BOOLEAN
-KdSendPacketToDebuggee(const CHAR * Buffer, UINT32 Length, BOOLEAN SendEndOfBuffer);
+KdSendFrameToDebuggee(const CHAR * Buffer1, UINT32 Length1, const CHAR * Buffer2, UINT32 Length2);
 
 BOOLEAN
-KdReceivePacketFromDebuggee(CHAR * BufferToSave, UINT32 * LengthReceived);
+KdReceiveBlockFromDebuggee(PKD_RECEIVING_LINK Link);
 
 BOOLEAN
-KdCheckForTheEndOfTheBuffer(PUINT32 CurrentLoopIndex, BYTE * Buffer);
+KdReceiveBytesFromDebuggee(PKD_RECEIVING_LINK Link, BYTE * Buffer, UINT32 Length);
+
+BOOLEAN
+KdReceivePacketFromDebuggee(PKD_RECEIVING_LINK Link, CHAR * BufferToSave, UINT32 * LengthReceived);
 
 BOOLEAN
 KdSendSwitchCorePacketToDebuggee(UINT32 NewCore);
@@ -102,9 +244,16 @@ KdSendShortCircuitingEventToDebuggee(BOOLEAN IsEnabled);
 
 BOOLEAN
 KdSendEventQueryAndModifyPacketToDebuggee(
-    UINT64                      Tag,
-    DEBUGGER_MODIFY_EVENTS_TYPE TypeOfAction,
-    BOOLEAN *                   IsEnabled);
+    UINT64                            Tag,
+    DEBUGGER_MODIFY_EVENTS_TYPE       TypeOfAction,
+    BOOLEAN *                         IsEnabled,
+    PDEBUGGER_EVENT_SCRIPT_STATISTICS ScriptStatistics);
+
+BOOLEAN
+KdSendModifyMonitorRangePacketToDebuggee(UINT64                      Tag,
+                                         DEBUGGER_MODIFY_EVENTS_TYPE TypeOfAction,
+                                         UINT64                      RangeStart,
+                                         UINT64                      RangeEnd);
 
 BOOLEAN
 KdSendFlushPacketToDebuggee();
@@ -124,7 +273,73 @@ KdSendSymbolReloadPacketToDebuggee(UINT32 ProcessId);
 BOOLEAN KdSendReadRegisterPacketToDebuggee(PDEBUGGEE_REGISTER_READ_DESCRIPTION);
 
 BOOLEAN
-KdSendReadMemoryPacketToDebuggee(PDEBUGGER_READ_MEMORY ReadMem);
+KdSendReadMemoryPacketToDebuggee(PDEBUGGER_READ_MEMORY ReadMem, unsigned char * Buffer, UINT32 * ReturnLength);
+
+BOOLEAN
+KdReceivedReadMemoryChunk(PDEBUGGER_READ_MEMORY ReadMemoryPacket, unsigned char * MemoryBuffer);
+
+BOOLEAN
+KdMemoryCacheIsReadOnlyAction(DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION RequestedAction);
+
+VOID
+KdMemoryCacheInvalidate();
+
+BOOLEAN
+KdMemoryCacheRead(PDEBUGGER_READ_MEMORY ReadMem, unsigned char * Buffer, UINT32 * ReturnLength);
+
+BOOLEAN
+KdObjectCacheIsReadOnlyAction(DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION RequestedAction);
+
+VOID
+KdObjectCacheInvalidate();
+
+VOID
+KdObjectCacheReceivedQueryResult(PVOID Result, UINT32 Length);
+
+BOOLEAN
+KdObjectCacheShowProcessList(PDEBUGGEE_PROCESS_LIST_NEEDED_DETAILS SymDetailsForProcessList);
+
+BOOLEAN
+KdObjectCacheShowThreadList(PDEBUGGEE_THREAD_LIST_NEEDED_DETAILS SymDetailsForThreadList);
+
+BOOLEAN
+KdBatchRequestsBegin();
+
+BOOLEAN
+KdBatchRequestsFlush();
+
+VOID
+KdBatchRequestsEnd();
+
+BOOLEAN
+KdBatchRequestsIsBatchableCommand(const std::string & Command);
+
+BOOLEAN
+KdBatchRequestsAppend(DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION RequestedAction,
+                      CHAR *                                  Buffer,
+                      UINT32                                  BufferLength,
+                      UINT32                                  ResultLength);
+
+VOID
+KdBatchRequestsShowResults(PDEBUGGEE_BATCH_REQUESTS_PACKET BatchResults, UINT32 Length);
+
+VOID
+KdShowResultOfReadingRegisters(PDEBUGGEE_REGISTER_READ_DESCRIPTION ReadRegisterResult);
+
+VOID
+KdShowResultOfStepTrace(PDEBUGGEE_STEP_TRACE_RESULT_PACKET StepTraceResult, UINT32 Length);
+
+VOID
+KdShowResultOfInstructionBudget(PDEBUGGEE_INSTRUCTION_BUDGET_PACKET BudgetResult);
+
+PDEBUGGEE_REGISTERS_CONTEXT
+KdUpdateRegistersContextCache(PDEBUGGEE_REGISTER_READ_DESCRIPTION ReadRegisterResult);
+
+VOID
+KdShowResultOfPte(PDEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS PteResult);
+
+VOID
+KdShowResultOfVa2paAndPa2va(PDEBUGGER_VA2PA_AND_PA2VA_COMMANDS Va2paPa2vaResult);
 
 BOOLEAN
 KdSendEditMemoryPacketToDebuggee(PDEBUGGER_EDIT_MEMORY EditMem, UINT32 Size);
@@ -176,9 +391,56 @@ KdSendSearchRequestPacketToDebuggee(UINT64 * SearchRequestBuffer, UINT32 SearchR
 BOOLEAN
 KdSendStepPacketToDebuggee(DEBUGGER_REMOTE_STEPPING_REQUEST StepRequestType);
 
+BOOLEAN
+KdSendStepAndTracePacketToDebuggee(DEBUGGER_REMOTE_STEPPING_REQUEST StepRequestType,
+                                   UINT32                           CountOfSteps,
+                                   UINT32                           RecordedRegister);
+
+BOOLEAN
+KdSendInstructionBudgetPacketToDebuggee(UINT64 CountOfInstructions);
+
+BOOLEAN
+KdSendTransportTestPacketToDebuggee(PDEBUGGEE_TRANSPORT_TEST_PACKET TransportTestPacket);
+
+VOID
+KdCheckResultOfTransportTest(PDEBUGGEE_TRANSPORT_TEST_PACKET TransportTestPacket, UINT32 PacketLength);
+
+BOOLEAN
+KdSendPatchMemoryPacketToDebuggee(PDEBUGGER_PATCH_MEMORY_REQUEST PatchMemRequest);
+
+BOOLEAN
+KdSendEptSnapshotPacketToDebuggee(PDEBUGGER_EPT_SNAPSHOT_REQUEST SnapshotRequest);
+
+BOOLEAN
+KdSendHaltWatchdogPacketToDebuggee(PDEBUGGER_HALT_WATCHDOG_REQUEST HaltWatchdogRequest);
+
+BOOLEAN
+KdSendRegisterEventsBatchPacketToDebuggee(PDEBUGGER_EVENTS_BATCH_REQUEST EventsBatchRequest);
+
+BOOLEAN
+KdSendQueryEventsStatisticsPacketToDebuggee(PDEBUGGER_QUERY_EVENTS_STATISTICS StatisticsRequest);
+
 BYTE
 KdComputeDataChecksum(PVOID Buffer, UINT32 Length);
 
+UINT32
+KdComputeCrc32(UINT32 Crc, const BYTE * Buffer, UINT32 Length);
+
+UINT32
+KdComputeCrc32c(UINT32 Crc, const BYTE * Buffer, UINT32 Length);
+
+UINT32
+KdComputeFrameChecksum(UINT16 Flags, UINT32 Crc, const BYTE * Buffer, UINT32 Length);
+
+UINT16
+KdGetSendFlags();
+
+BOOLEAN
+KdDecompressBuffer(const BYTE * Source, UINT32 SourceLength, BYTE * Destination, UINT32 DestinationLength);
+
+BOOLEAN
+KdIsValidFrameHeader(PSERIAL_FRAME_HEADER Header);
+
 BOOLEAN
 KdRegisterEventInDebuggee(PDEBUGGER_GENERAL_EVENT_DETAIL EventRegBuffer,
                           UINT32                         Length);
@@ -187,6 +449,10 @@ BOOLEAN
 KdAddActionToEventInDebuggee(PDEBUGGER_GENERAL_ACTION ActionAddingBuffer,
                              UINT32                   Length);
 
+BOOLEAN
+KdRegisterEventsBatchInDebuggee(PDEBUGGER_EVENTS_BATCH_REQUEST EventsBatchRequest,
+                                UINT32                         Length);
+
 BOOLEAN
 KdSendModifyEventInDebuggee(PDEBUGGER_MODIFY_EVENTS ModifyEvent);
 
@@ -210,9 +476,7 @@ VOID
 KdSendUsermodePrints(CHAR * Input, UINT32 Length);
 
 VOID
-KdSendSymbolDetailPacket(PMODULE_SYMBOL_DETAIL SymbolDetailPacket,
-                         UINT32                CurrentSymbolInfoIndex,
-                         UINT32                TotalSymbols);
+KdSendSymbolDetailPackets(PMODULE_SYMBOL_DETAIL SymbolDetails, UINT32 TotalSymbols);
 
 VOID
 KdHandleUserInputInDebuggee(DEBUGGEE_USER_INPUT_PACKET * Descriptor);
@@ -228,3 +492,6 @@ KdBreakControlCheckAndContinueDebugger();
 
 VOID
 KdSetStatusAndWaitForPause();
+
+BOOLEAN
+KdAreAsyncPauseRequestsPending();
@@ -0,0 +1,96 @@
+/**
+ * @file message-lanes.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers of the lanes of showing messages (interactive and bulk)
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum number of bulk messages that are queued to be shown
+ *
+ */
+#define MESSAGE_LANES_BULK_QUEUE_SIZE 0x1000
+
+/**
+ * @brief Maximum number of bulk messages that are taken from the queue
+ * by the writer at once
+ *
+ */
+#define MESSAGE_LANES_BULK_BATCH_SIZE 0x40
+
+/**
+ * @brief Bulk messages are held while interactive messages are shown
+ * in this interval (in milliseconds)
+ *
+ */
+#define MESSAGE_LANES_INTERACTIVE_HOLD_INTERVAL 20
+
+/**
+ * @brief Maximum time that bulk messages are held for interactive
+ * messages (in milliseconds)
+ *
+ */
+#define MESSAGE_LANES_MAXIMUM_HOLD_TIME 200
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The state of the lanes of showing messages
+ * @details interactive messages (results of commands, errors, etc.) are
+ * shown immediately, bulk messages of events are queued and shown by the
+ * writer thread, the writer holds the bulk messages (up to a limit) while
+ * an interactive command is executed or interactive messages are shown
+ *
+ */
+typedef struct _MESSAGE_LANES_STATE
+{
+    CRITICAL_SECTION   Lock;
+    CONDITION_VARIABLE NotEmpty;
+    CONDITION_VARIABLE NotFull;
+    CONDITION_VARIABLE Drained;
+    CHAR *             BulkQueue[MESSAGE_LANES_BULK_QUEUE_SIZE];
+    UINT32             BulkQueueHead;
+    UINT32             BulkQueueCount;
+    BOOLEAN            IsInitialized;
+    BOOLEAN            IsWriting; // The writer is showing the taken messages
+    BOOLEAN            IsStopping;
+    HANDLE             WriterThread;
+    DWORD              WriterThreadId;
+    volatile LONG      InteractiveCommands;    // Count of the interactive commands in execution
+    volatile ULONG64   LastInteractiveMessage; // Tick count of the last interactive message
+
+} MESSAGE_LANES_STATE, *PMESSAGE_LANES_STATE;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+VOID
+MessageLanesShowBulkMessage(const CHAR * Message);
+
+VOID
+MessageLanesNotifyInteractiveMessage();
+
+VOID
+MessageLanesBeginInteractiveCommand();
+
+VOID
+MessageLanesEndInteractiveCommand();
+
+VOID
+MessageLanesFlush();
+
+VOID
+MessageLanesUninitialize();
@@ -11,6 +11,17 @@
  */
 #pragma once
 
+//////////////////////////////////////////
+//				Constants 		     	//
+//////////////////////////////////////////
+
+/**
+ * @brief Count of the entries of each page of the list of processes
+ * or threads that is queried from the kernel
+ *
+ */
+#define OBJECT_LIST_PAGE_ENTRIES_COUNT 0x100
+
 //////////////////////////////////////////
 //				Functions 		     	//
 //////////////////////////////////////////
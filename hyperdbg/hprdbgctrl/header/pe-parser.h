@@ -11,10 +11,38 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//					 Structures                 //
+//////////////////////////////////////////////////
+
+/**
+ * @brief A read-only view of a mapped PE file
+ * @details the headers are validated against the size of the file when
+ * the view is opened
+ *
+ */
+typedef struct _PE_FILE_VIEW
+{
+    HANDLE              FileHandle;
+    HANDLE              MapObjectHandle;
+    PVOID               BaseAddress;
+    UINT64              FileSize;
+    PIMAGE_DOS_HEADER   DosHeader;
+    PIMAGE_NT_HEADERS32 NtHeader32; // the signature and the file header are the same for PE32 and PE32+
+    PIMAGE_NT_HEADERS64 NtHeader64;
+
+} PE_FILE_VIEW, *PPE_FILE_VIEW;
+
 //////////////////////////////////////////////////
 //					  Functions                 //
 //////////////////////////////////////////////////
 
+BOOLEAN
+PeOpenFileView(const WCHAR * AddressOfFile, PPE_FILE_VIEW FileView);
+
+VOID
+PeCloseFileView(PPE_FILE_VIEW FileView);
+
 BOOLEAN
 PeShowSectionInformationAndDump(const WCHAR * AddressOfFile, const CHAR * SectionToShow, BOOLEAN Is32Bit);
 
@@ -0,0 +1,149 @@
+/**
+ * @file pt-decoder.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief headers for decoding the trace of Intel PT (Processor Trace)
+ * @details
+ * @version 0.4
+ * @date 2023-08-05
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum count of the instructions that are walked without any
+ * packet before considering the decoder as out of sync
+ *
+ */
+#define PT_DECODER_MAXIMUM_INSTRUCTIONS_WITHOUT_PACKETS 0x100000
+
+/**
+ * @brief Size of the PSB (synchronization) packet
+ *
+ */
+#define PT_DECODER_PSB_SIZE 16
+
+//////////////////////////////////////////////////
+//					  Enums 					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The types of the events of the trace that are used for
+ * reconstructing the control flow
+ *
+ */
+typedef enum _PT_DECODER_EVENT_TYPE
+{
+    PT_DECODER_EVENT_TNT,     // A conditional branch (taken or not taken)
+    PT_DECODER_EVENT_TIP,     // Target of an indirect branch or a far transfer
+    PT_DECODER_EVENT_TIP_PGE, // The trace is enabled at the IP
+    PT_DECODER_EVENT_TIP_PGD, // The trace is disabled (by the last branch)
+    PT_DECODER_EVENT_FUP,     // Source of an asynchronous event (followed by its target)
+    PT_DECODER_EVENT_SYNC,    // The current IP after a PSB or an overflow
+    PT_DECODER_EVENT_OVF,     // Some of the packets are lost
+
+} PT_DECODER_EVENT_TYPE;
+
+/**
+ * @brief The classes of the instructions based on the packets that they
+ * need for being followed
+ *
+ */
+typedef enum _PT_DECODER_INSTRUCTION_CLASS
+{
+    PT_DECODER_INSTRUCTION_OTHER,         // Continues to the next instruction
+    PT_DECODER_INSTRUCTION_COND_BRANCH,   // Needs a TNT
+    PT_DECODER_INSTRUCTION_DIRECT_JUMP,   // The target is known
+    PT_DECODER_INSTRUCTION_DIRECT_CALL,   // The target is known
+    PT_DECODER_INSTRUCTION_INDIRECT_JUMP, // Needs a TIP
+    PT_DECODER_INSTRUCTION_INDIRECT_CALL, // Needs a TIP
+    PT_DECODER_INSTRUCTION_RETURN,        // Needs a TIP (returns are not compressed)
+    PT_DECODER_INSTRUCTION_FAR_TRANSFER,  // Needs a TIP
+
+} PT_DECODER_INSTRUCTION_CLASS;
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief An event of the trace
+ *
+ */
+typedef struct _PT_DECODER_EVENT
+{
+    PT_DECODER_EVENT_TYPE Type;
+    BOOLEAN               Taken;   // Only for TNT
+    BOOLEAN               HasIp;   // Whether the IP is suppressed or not
+    BOOLEAN               HasMode; // Whether the execution mode is changed or not
+    BOOLEAN               Is32Bit; // The execution mode (only if HasMode)
+    UINT64                Ip;
+
+} PT_DECODER_EVENT, *PPT_DECODER_EVENT;
+
+/**
+ * @brief The configuration of the trace that is used for decoding
+ *
+ */
+typedef struct _PT_DECODER_CONFIGURATION
+{
+    UINT32  ProcessId; // The process that is used for reading the instructions
+    BOOLEAN TraceUserMode;
+    BOOLEAN TraceKernelMode;
+    UINT32  CountOfAddressRanges;
+    UINT64  AddressRangesStart[IntelPtMaximumAddressRanges];
+    UINT64  AddressRangesEnd[IntelPtMaximumAddressRanges];
+
+} PT_DECODER_CONFIGURATION, *PPT_DECODER_CONFIGURATION;
+
+/**
+ * @brief The statistics of decoding a trace
+ *
+ */
+typedef struct _PT_DECODER_STATISTICS
+{
+    UINT64 CountOfInstructions;
+    UINT64 CountOfCalls;
+    UINT64 CountOfReturns;
+    UINT64 CountOfDesyncs;
+
+} PT_DECODER_STATISTICS, *PPT_DECODER_STATISTICS;
+
+/**
+ * @brief The state of the decoder of packets
+ *
+ */
+typedef struct _PT_DECODER
+{
+    const UINT8 *                        Trace;
+    UINT64                               TraceSize;
+    UINT64                               Offset;
+    UINT64                               LastIp;
+    UINT64                               TntBits;        // The pending bits (the oldest is the highest bit)
+    UINT32                               CountOfTntBits; // Count of the pending bits
+    BOOLEAN                              InPsb;
+    BOOLEAN                              AfterOverflow;
+    BOOLEAN                              HasPendingMode;
+    BOOLEAN                              PendingModeIs32Bit;
+    BOOLEAN                              HasPeekedEvent;
+    PT_DECODER_EVENT                     PeekedEvent;
+    PT_DECODER_CONFIGURATION             Configuration;
+    PT_DECODER_STATISTICS                Statistics;
+    std::map<UINT64, std::vector<UINT8>> Pages;          // The cached pages of the code (empty if not readable)
+
+} PT_DECODER, *PPT_DECODER;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+PtDecoderDecodeTrace(const UINT8 *             Trace,
+                     UINT64                    TraceSize,
+                     PPT_DECODER_CONFIGURATION Configuration,
+                     PPT_DECODER_STATISTICS    Statistics);
@@ -17,3 +17,6 @@
 
 BOOLEAN
 RevRequestService(REVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST * RevRequest);
+
+BOOLEAN
+RevSaveCoverage(const string & FilePath);
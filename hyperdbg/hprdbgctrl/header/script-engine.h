@@ -11,6 +11,50 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum number of compiled scripts in the cache of the
+ * script engine wrapper (the cache is emptied once it's full)
+ *
+ */
+#define SCRIPT_ENGINE_COMPILED_CACHE_MAX_ENTRIES 256
+
+/**
+ * @brief Default iterations of running each script in the benchmark
+ * of the script engine
+ *
+ */
+#define SCRIPT_ENGINE_BENCHMARK_DEFAULT_ITERATIONS 1000000
+
+/**
+ * @brief Iterations of parsing each script in the benchmark of the
+ * script engine
+ *
+ */
+#define SCRIPT_ENGINE_BENCHMARK_PARSE_ITERATIONS 0x100
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief A compiled script in the cache of the script engine wrapper
+ * @details the result of parsing a script depends on the loaded symbols,
+ * so the entries which are compiled for a previous version of the symbols
+ * are not used
+ *
+ */
+typedef struct _SCRIPT_ENGINE_COMPILED_CACHE_ENTRY
+{
+    std::string    Source;
+    UINT64         SymbolsVersion;
+    PSYMBOL_BUFFER SymbolBuffer;
+
+} SCRIPT_ENGINE_COMPILED_CACHE_ENTRY, *PSCRIPT_ENGINE_COMPILED_CACHE_ENTRY;
+
 //////////////////////////////////////////////////
 //    Pdb Parser Wrapper (from script-engine)   //
 //////////////////////////////////////////////////
@@ -74,12 +118,18 @@ ScriptEngineSymbolAbortLoadingWrapper();
 VOID
 ScriptEngineWrapperTestParser(const string & Expr);
 
+VOID
+ScriptEngineWrapperBenchmark(UINT32 Iterations);
+
 BOOLEAN
 ScriptAutomaticStatementsTestWrapper(const string & Expr, UINT64 ExpectationValue, BOOLEAN ExceptError);
 
 PVOID
 ScriptEngineParseWrapper(char * Expr, BOOLEAN ShowErrorMessageIfAny);
 
+VOID
+ScriptEngineCompiledCacheFlush();
+
 VOID
 PrintSymbolBufferWrapper(PVOID SymbolBuffer);
 
@@ -0,0 +1,108 @@
+/**
+ * @file shared-memory-output.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers of the shared memory (ring buffer) output sources
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The magic of the shared memory ring ('HDSHMRNG')
+ *
+ */
+#define SHARED_MEMORY_OUTPUT_MAGIC 0x474e524d48534448
+
+/**
+ * @brief The version of the layout of the shared memory ring
+ *
+ */
+#define SHARED_MEMORY_OUTPUT_VERSION 1
+
+/**
+ * @brief Size of the data of the shared memory ring (should be a power of 2)
+ *
+ */
+#define SHARED_MEMORY_OUTPUT_RING_SIZE 0x1000000
+
+/**
+ * @brief The suffix of the name of the event that is signaled once
+ * new messages are written to the ring (appended to the name of the
+ * file mapping)
+ *
+ */
+#define SHARED_MEMORY_OUTPUT_EVENT_SUFFIX "_Event"
+
+/**
+ * @brief The length of the messages which indicates the rest of the
+ * ring (till the end of the ring) is not used and the next message
+ * is at the start of the ring
+ *
+ */
+#define SHARED_MEMORY_OUTPUT_WRAP_MARKER 0xffffffff
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The header of the shared memory ring
+ * @details the header is followed by RingSize bytes of data, each message
+ * is a UINT32 length followed by the message and aligned to 8 bytes,
+ * Head and Tail are the count of the bytes that are written to and read
+ * from the ring (the offset in the ring is Head/Tail % RingSize), the
+ * writer only changes the Head and the reader only changes the Tail,
+ * messages are dropped if the reader doesn't keep up
+ *
+ */
+typedef struct _SHARED_MEMORY_OUTPUT_HEADER
+{
+    UINT64          Magic;
+    UINT32          Version;
+    UINT32          RingSize;
+    CHAR            EventName[MAX_PATH]; // Name of the event of new messages
+    volatile UINT64 Head;
+    volatile UINT64 Tail;
+    volatile UINT64 DroppedMessages;
+
+} SHARED_MEMORY_OUTPUT_HEADER, *PSHARED_MEMORY_OUTPUT_HEADER;
+
+/**
+ * @brief The state of a shared memory output source
+ *
+ */
+typedef struct _SHARED_MEMORY_OUTPUT_CONTEXT
+{
+    HANDLE                       MappingHandle;
+    HANDLE                       EventHandle;
+    PSHARED_MEMORY_OUTPUT_HEADER Header;
+    CHAR *                       Ring;
+
+} SHARED_MEMORY_OUTPUT_CONTEXT, *PSHARED_MEMORY_OUTPUT_CONTEXT;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+HANDLE
+SharedMemoryOutputCreateMapping(const string & Name);
+
+PSHARED_MEMORY_OUTPUT_CONTEXT
+SharedMemoryOutputOpen(HANDLE MappingHandle);
+
+BOOLEAN
+SharedMemoryOutputWriteMessage(PSHARED_MEMORY_OUTPUT_CONTEXT Context, CHAR * Message, UINT32 MessageLength);
+
+VOID
+SharedMemoryOutputSignal(PSHARED_MEMORY_OUTPUT_CONTEXT Context);
+
+VOID
+SharedMemoryOutputClose(PSHARED_MEMORY_OUTPUT_CONTEXT Context);
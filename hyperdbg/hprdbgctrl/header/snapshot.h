@@ -0,0 +1,73 @@
+/**
+ * @file snapshot.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief headers for the incremental snapshots of the physical memory
+ * @details
+ * @version 0.4
+ * @date 2023-08-04
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The magic of the files of the snapshots ('HDSN')
+ *
+ */
+#define SNAPSHOT_FILE_MAGIC 0x4e534448
+
+/**
+ * @brief The version of the format of the files of the snapshots
+ *
+ */
+#define SNAPSHOT_FILE_VERSION 1
+
+/**
+ * @brief Maximum size of the physical memory that is read in each request
+ *
+ */
+#define SNAPSHOT_READ_CHUNK_SIZE 0x10000
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The header of the files of the snapshots
+ * @details the header is followed by the bitmap of the stored pages (one
+ * bit for each 4KB page of the physical memory) and then the stored pages
+ * in the order of their physical addresses, so the n-th set bit of the
+ * bitmap is the n-th stored page
+ *
+ */
+typedef struct _SNAPSHOT_FILE_HEADER
+{
+    UINT32 Magic;
+    UINT32 Version;
+    UINT32 CheckpointIndex; // Zero for the full snapshot
+    UINT32 Reserved;
+    UINT64 EndAddress;      // End of the physical memory (exclusive)
+    UINT64 CountOfPages;    // Count of the stored pages
+    UINT64 BitmapOffset;    // Offset of the bitmap of the stored pages
+    UINT64 PagesOffset;     // Offset of the first stored page (page aligned)
+
+} SNAPSHOT_FILE_HEADER, *PSNAPSHOT_FILE_HEADER;
+
+/**
+ * @brief A (memory-mapped) file of a checkpoint
+ *
+ */
+typedef struct _SNAPSHOT_CHECKPOINT
+{
+    std::string Path;
+    HANDLE      FileHandle;
+    HANDLE      MappingHandle;
+    PVOID       View;
+    UINT64      CountOfPages;
+
+} SNAPSHOT_CHECKPOINT, *PSNAPSHOT_CHECKPOINT;
@@ -17,12 +17,15 @@
 
 /**
  * @brief Save the local function symbols' description
+ * @details entries are kept in a sorted array and their names are
+ * stored in a shared pool of names
  *
  */
 typedef struct _LOCAL_FUNCTION_DESCRIPTION
 {
-    std::string ObjectName;
-    UINT32      ObjectSize;
+    UINT64 Address;
+    UINT32 ObjectSize;
+    UINT32 ObjectNameOffset;
 
 } LOCAL_FUNCTION_DESCRIPTION, *PLOCAL_FUNCTION_DESCRIPTION;
 
@@ -32,6 +35,13 @@ typedef struct _LOCAL_FUNCTION_DESCRIPTION
 
 #define PDBEX_DEFAULT_CONFIGURATION "-j- -k- -e n -i"
 
+/**
+ * @brief Default maximum number of nodes that are shown by walking
+ * a linked list in the 'dt' command
+ *
+ */
+#define DT_DEFAULT_LIST_NODES_COUNT 0x20
+
 //////////////////////////////////////////////////
 //			 For symbol (pdb) parsing		    //
 //////////////////////////////////////////////////
@@ -42,6 +52,15 @@ SymbolBuildAndShowSymbolTable();
 BOOLEAN
 SymbolShowFunctionNameBasedOnAddress(UINT64 Address, PUINT64 UsedBaseAddress);
 
+PLOCAL_FUNCTION_DESCRIPTION
+SymbolFindDisassemblerSymbol(UINT64 Address);
+
+const CHAR *
+SymbolGetDisassemblerSymbolName(PLOCAL_FUNCTION_DESCRIPTION FunctionDescription);
+
+BOOLEAN
+SymbolQueryFunctionOfAddress(UINT64 Address, PUINT64 FunctionAddress, std::string & FunctionName);
+
 BOOLEAN
 SymbolLoadOrDownloadSymbols(BOOLEAN IsDownload, BOOLEAN SilentLoad);
 
@@ -58,7 +77,25 @@ SymbolBuildSymbolTable(PMODULE_SYMBOL_DETAIL * BufferToStoreDetails,
                        BOOLEAN                 SendOverSerial);
 
 BOOLEAN
-SymbolBuildAndUpdateSymbolTable(PMODULE_SYMBOL_DETAIL SymbolDetail);
+SymbolBuildAndUpdateSymbolTable(PDEBUGGER_UPDATE_SYMBOL_TABLE SymbolUpdatePacket);
+
+BOOLEAN
+SymbolGetSystemRoot(string & SystemRootString);
+
+VOID
+SymbolConvertKernelModulePath(string & ModulePath, const string & SystemRootString);
+
+BOOLEAN
+SymbolBuildModuleSymbolDetail(const char *          ModulePath,
+                              UINT64                BaseAddress,
+                              BOOLEAN               IsUserMode,
+                              PMODULE_SYMBOL_DETAIL ModuleSymbolDetail);
+
+BOOLEAN
+SymbolAddModuleToSymbolTable(PMODULE_SYMBOL_DETAIL ModuleSymbolDetail);
+
+BOOLEAN
+SymbolSendLoadedKernelModuleToDebugger(PDEBUGGEE_KERNEL_MODULE_LOADED_PACKET ModuleLoadedPacket);
 
 VOID
 SymbolInitialReload();
@@ -26,11 +26,12 @@
 //////////////////////////////////////////////////
 
 BOOLEAN
-CreateProcessAndOpenPipeConnection(PVOID   KernelInformation,
-                                   UINT32  KernelInformationSize,
-                                   PHANDLE ConnectionPipeHandle,
-                                   PHANDLE ThreadHandle,
-                                   PHANDLE ProcessHandle);
+CreateProcessAndOpenPipeConnection(PVOID        KernelInformation,
+                                   UINT32       KernelInformationSize,
+                                   const CHAR * TestArguments,
+                                   PHANDLE      ConnectionPipeHandle,
+                                   PHANDLE      ThreadHandle,
+                                   PHANDLE      ProcessHandle);
 VOID
 CloseProcessAndClosePipeConnection(HANDLE ConnectionPipeHandle,
                                    HANDLE ThreadHandle,
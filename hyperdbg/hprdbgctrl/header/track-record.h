@@ -0,0 +1,106 @@
+/**
+ * @file track-record.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief headers for the binary records of the '!track' command
+ * @details
+ * @version 0.4
+ * @date 2023-08-07
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The magic of the files of the records ('HDTR')
+ *
+ */
+#define TRACK_RECORD_FILE_MAGIC 0x52544448
+
+/**
+ * @brief The version of the format of the files of the records
+ *
+ */
+#define TRACK_RECORD_FILE_VERSION 1
+
+/**
+ * @brief Count of the records that the file is grown by each time that
+ * it's full
+ *
+ */
+#define TRACK_RECORD_FILE_GROWTH_COUNT 0x10000
+
+//////////////////////////////////////////////////
+//					  Enums 					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The types of the records
+ *
+ */
+typedef enum _TRACK_RECORD_TYPE
+{
+    TRACK_RECORD_TYPE_CALL,
+    TRACK_RECORD_TYPE_RET,
+
+} TRACK_RECORD_TYPE;
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The header of the files of the records
+ *
+ */
+typedef struct _TRACK_RECORD_FILE_HEADER
+{
+    UINT32 Magic;
+    UINT32 Version;
+    UINT64 CountOfRecords;
+
+} TRACK_RECORD_FILE_HEADER, *PTRACK_RECORD_FILE_HEADER;
+
+/**
+ * @brief A 'call' or a 'ret' that is recorded
+ *
+ */
+typedef struct _TRACK_RECORD
+{
+    UINT64 Tsc;         // The time-stamp counter of the debuggee once the instruction is stepped
+    UINT64 FromAddress; // The address of the 'call' or the 'ret'
+    UINT64 ToAddress;   // The address of the next instruction
+    UINT32 Depth;       // Depth of the call tree before the 'call' or after the 'ret'
+    UINT32 Type;        // TRACK_RECORD_TYPE
+
+} TRACK_RECORD, *PTRACK_RECORD;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+TrackRecordStart(const string & FilePath);
+
+BOOLEAN
+TrackRecordIsActive();
+
+VOID
+TrackRecordHandleInstruction(unsigned char * BufferToDisassemble,
+                             UINT32          BuffLength,
+                             BOOLEAN         Isx86_64,
+                             UINT64          RipAddress,
+                             UINT64          Tsc);
+
+VOID
+TrackRecordStop();
+
+BOOLEAN
+TrackRecordShowTree(const string & FilePath);
+
+BOOLEAN
+TrackRecordCollapseStacks(const string & FilePath, const string & OutputPath);
@@ -0,0 +1,128 @@
+/**
+ * @file transport.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Asynchronous transport of the connections (header)
+ * @details
+ * @version 0.4
+ * @date 2023-07-25
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//		            Definitions                 //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Size of the block that each receive operation reads
+ *
+ */
+#define TransportReceiveBlockSize 16 * NORMAL_PAGE_SIZE
+
+/**
+ * @brief Maximum size of the received data that is not read yet
+ * @details the I/O thread stops receiving until the data is read
+ *
+ */
+#define TransportMaximumReceivedDataSize 64 * NORMAL_PAGE_SIZE
+
+/**
+ * @brief Maximum time (in milliseconds) to wait for the queued buffers
+ * to be sent once a channel is closed
+ *
+ */
+#define TransportCloseTimeout 5000
+
+//////////////////////////////////////////////////
+//		            Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Type of the overlapped operations of the channels
+ *
+ */
+typedef enum _TRANSPORT_OPERATION_TYPE
+{
+    TRANSPORT_OPERATION_RECEIVE,
+    TRANSPORT_OPERATION_SEND,
+
+} TRANSPORT_OPERATION_TYPE;
+
+/**
+ * @brief An overlapped operation of a channel
+ *
+ */
+typedef struct _TRANSPORT_OPERATION
+{
+    OVERLAPPED               Overlapped;
+    TRANSPORT_OPERATION_TYPE Type;
+
+} TRANSPORT_OPERATION, *PTRANSPORT_OPERATION;
+
+/**
+ * @brief A connection (serial, named pipe, TCP or UDP socket) that is
+ * served by the I/O thread
+ * @details the senders only queue their buffers and the receivers
+ * only read the data that is already received by the I/O thread, so
+ * none of them waits for the other operations of the connection
+ *
+ */
+typedef struct _TRANSPORT_CHANNEL
+{
+    HANDLE             Handle;
+    BOOLEAN            IsSocket;          // Zero-length receives mean that the remote system closed the connection
+    UINT32             MaximumSendLength; // Maximum length of each send operation (zero means no limit)
+    BOOLEAN            IsInitialized;
+    BOOLEAN            IsOpened;
+    BOOLEAN            IsClosed;          // The connection is closed (or failed)
+    BOOLEAN            IsReceiving;       // A receive operation is pending
+    BOOLEAN            IsSending;         // A send operation is pending
+    CRITICAL_SECTION   Lock;
+    CONDITION_VARIABLE StateChanged; // Signaled once data is received, buffers are sent or the channel is closed
+
+    //
+    // Receive queue
+    //
+    TRANSPORT_OPERATION ReceiveOperation;
+    BYTE                ReceiveBlock[TransportReceiveBlockSize];
+    std::vector<BYTE>   ReceivedData;
+    UINT32              ReceivedDataOffset; // Data before this offset is already read
+
+    //
+    // Send queue
+    //
+    TRANSPORT_OPERATION          SendOperation;
+    std::list<std::vector<BYTE>> SendQueue;
+    UINT32                       SentLength; // Count of bytes of the first buffer of the queue that are sent
+
+} TRANSPORT_CHANNEL, *PTRANSPORT_CHANNEL;
+
+//////////////////////////////////////////////////
+//			    	 Functions                  //
+//////////////////////////////////////////////////
+
+BOOLEAN
+TransportOpenChannel(PTRANSPORT_CHANNEL Channel, HANDLE Handle, BOOLEAN IsSocket, UINT32 MaximumSendLength);
+
+BOOLEAN
+TransportSend(PTRANSPORT_CHANNEL Channel,
+              const CHAR *       Buffer1,
+              UINT32             Length1,
+              const CHAR *       Buffer2,
+              UINT32             Length2,
+              const CHAR *       Buffer3,
+              UINT32             Length3);
+
+UINT32
+TransportGetQueuedBuffersCount(PTRANSPORT_CHANNEL Channel);
+
+VOID
+TransportQueryTransferredBytes(UINT64 * SentBytes, UINT64 * ReceivedBytes);
+
+BOOLEAN
+TransportReceive(PTRANSPORT_CHANNEL Channel, BYTE * Buffer, UINT32 MaximumLength, UINT32 * ReceivedLength);
+
+VOID
+TransportCloseChannel(PTRANSPORT_CHANNEL Channel);
@@ -75,6 +75,11 @@ UdHandleUserDebuggerPausing(PDEBUGGEE_UD_PAUSED_PACKET PausePacket);
 VOID
 UdContinueDebuggee(UINT64 ProcessDetailToken);
 
+UINT32
+UdSendBatchCommand(UINT64                           ProcessDetailToken,
+                   PDEBUGGER_UD_BATCH_COMMAND_ENTRY Entries,
+                   UINT32                           CountOfEntries);
+
 VOID
 UdSendStepPacketToDebuggee(UINT64 ThreadDetailToken, UINT32 TargetThreadId, DEBUGGER_REMOTE_STEPPING_REQUEST StepType);
 
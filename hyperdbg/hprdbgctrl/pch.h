@@ -85,6 +85,12 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 
 #include <psapi.h>
 
+#include <compressapi.h>
+
+#include <TraceLoggingProvider.h>
+
+#include <winmeta.h>
+
 #include <time.h>
 
 #include <conio.h>
@@ -97,6 +103,8 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 
 #include <stdlib.h>
 
+#include <crtdbg.h>
+
 //
 // STL headers
 //
@@ -104,6 +112,8 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 
 #include <string>
 
+#include <string_view>
+
 #include <vector>
 
 #include <array>
@@ -122,6 +132,8 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 
 #include <map>
 
+#include <unordered_map>
+
 #include <numeric>
 
 #include <list>
@@ -134,6 +146,8 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 
 #include <cstring>
 
+#include <regex>
+
 //
 // Scope definitions
 //
@@ -196,8 +210,18 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 
 #include "header/namedpipe.h"
 
+#include "header/binary-output.h"
+
+#include "header/shared-memory-output.h"
+
 #include "header/forwarding.h"
 
+#include "header/event-replay.h"
+
+#include "header/message-lanes.h"
+
+#include "header/transport.h"
+
 #include "header/kd.h"
 
 #include "header/pe-parser.h"
@@ -208,6 +232,11 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 
 #include "header/rev-ctrl.h"
 
+#include "header/snapshot.h"
+#include "header/pt-decoder.h"
+#include "header/track-record.h"
+#include "header/counters-export.h"
+
 #pragma comment(lib, "ntdll.lib")
 
 //
@@ -229,4 +258,9 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 // for Windows 7
 //
 #pragma comment(lib, "Psapi.lib")
+
+//
+// For compressing the blocks of binary output sources
+//
+#pragma comment(lib, "Cabinet.lib")
 #pragma comment(lib, "Kernel32.lib")
@@ -27,13 +27,14 @@ SaveTheRegisters:
     push rax	
     
     mov rcx, rsp		    ; Fast call argument to PGUEST_REGS
-    mov rdx, [rsp +080h]    ; Fast call argument (second) - CalledFrom
+    mov rdx, [rsp +088h]    ; Fast call argument (second) - CalledFrom
     sub rdx, 5              ; as we used (call $ + 5) so we subtract it by 5 
+    mov r8, [rsp +080h]     ; Fast call argument (third) - HookRecord (pushed by the dispatcher of the trampoline)
     sub	rsp, 20h		; Free some space for Shadow Section
     call	EptHook2GeneralDetourEventHandler
     
     add	rsp, 20h		; Restore the state
-    mov  [rsp +080h], rax ; the return address of the above function is where we should continue
+    mov  [rsp +088h], rax ; the return address of the above function is where we should continue
     
 RestoreTheRegisters:
     pop rax
@@ -53,6 +54,7 @@ RestoreTheRegisters:
     pop r14
     pop r15
 
+    lea rsp, [rsp +08h] ; remove the HookRecord (without changing the flags)
     ret ; jump back to the trampoline
     
 AsmGeneralDetourHook ENDP 
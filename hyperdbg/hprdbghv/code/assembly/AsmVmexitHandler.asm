@@ -5,6 +5,40 @@ EXTERN VmxVmresume:PROC
 EXTERN VmxReturnStackPointerForVmxoff:PROC
 EXTERN VmxReturnInstructionPointerForVmxoff:PROC
 
+EXTERN g_VmexitFastPathCpuid:BYTE
+EXTERN g_VmexitFastPathTsc:BYTE
+EXTERN g_VmexitFastPathCr3:BYTE
+EXTERN g_VmexitFastPathCr3Filter:QWORD
+EXTERN g_SaveXmmRegistersOnVmexits:DWORD
+EXTERN g_VmcsPendingUpdatesCount:DWORD
+EXTERN g_EnlightenedVmcsIsActive:BYTE
+
+VMCS_EXIT_REASON                    EQU 04402h
+VMCS_VMEXIT_INSTRUCTION_LENGTH      EQU 0440Ch
+VMCS_EXIT_QUALIFICATION             EQU 06400h
+VMCS_GUEST_CR3                      EQU 06802h
+VMCS_GUEST_RIP                      EQU 0681Eh
+
+VMX_EXIT_REASON_EXECUTE_CPUID       EQU 0Ah
+VMX_EXIT_REASON_EXECUTE_RDTSC       EQU 10h
+VMX_EXIT_REASON_MOV_CR              EQU 1Ch
+VMX_EXIT_REASON_EXECUTE_RDTSCP      EQU 33h
+
+VMX_EXIT_QUALIFICATION_CONTROL_REGISTER_AND_ACCESS_TYPE EQU 03Fh     ; bits 3:0 (register) and 5:4 (access type)
+VMX_EXIT_QUALIFICATION_MOV_TO_CR3   EQU 03h
+VMX_EXIT_QUALIFICATION_REGISTER_RSP EQU 04h
+
+INVVPID_SINGLE_CONTEXT              EQU 01h
+VPID_TAG                            EQU 01h     ; same as VPID_TAG in Vpid.h
+
+VMEXIT_FAST_PATH_CR3_FILTER_MAXIMUM_ENTRIES EQU 8   ; same as VmexitFastPath.h
+CR3_PAGE_FRAME_MASK                 EQU 000ffffffffff000h
+
+CPUID_PROCESSOR_AND_PROCESSOR_FEATURE_IDENTIFIERS EQU 01h
+CPUID_HV_VENDOR_AND_MAX_FUNCTIONS   EQU 40000000h
+HYPERV_CPUID_INTERFACE              EQU 40000001h
+HYPERV_HYPERVISOR_PRESENT_BIT       EQU 80000000h
+
 .code _text
 
 ;------------------------------------------------------------------------
@@ -17,6 +51,219 @@ AsmVmexitHandler PROC
 
     pushfq
 
+    ; ------------ Fast-path of CPUID, RDTSC, RDTSCP and MOV to CR3 ------------
+    ;
+    ;   only r8, r9 and r10 are saved here, the results of the emulated
+    ;   instructions are directly put into the guest's rax, rbx, rcx and rdx
+    ;   if there is an event (or anything else) that needs the full path,
+    ;   then g_VmexitFastPath* is FALSE and we continue with the full path
+    ;   (the pending updates of VMCS controls are also applied by the full path)
+    ;   the fields of the enlightened VMCS (nested under Hyper-V) are not
+    ;   accessible by vmread, so the full path is always used in that case
+    ;
+    push r8
+    push r9
+    push r10
+
+    cmp dword ptr [g_VmcsPendingUpdatesCount], 0
+    jne FullPath
+
+    cmp byte ptr [g_EnlightenedVmcsIsActive], 0
+    jne FullPath
+
+    mov r8, VMCS_EXIT_REASON
+    vmread r9, r8
+    and r9d, 0ffffh
+
+    cmp r9d, VMX_EXIT_REASON_EXECUTE_CPUID
+    je FastPathCpuid
+
+    cmp r9d, VMX_EXIT_REASON_EXECUTE_RDTSC
+    je FastPathRdtsc
+
+    cmp r9d, VMX_EXIT_REASON_EXECUTE_RDTSCP
+    je FastPathRdtscp
+
+    cmp r9d, VMX_EXIT_REASON_MOV_CR
+    je FastPathMovToCr3
+
+    jmp FullPath
+
+FastPathCpuid:
+    cmp byte ptr [g_VmexitFastPathCpuid], 0
+    je FullPath
+
+    mov r8d, eax        ; save the leaf (cpuid zero-extends the results into the 64-bit registers)
+    cpuid
+
+    cmp r8d, CPUID_PROCESSOR_AND_PROCESSOR_FEATURE_IDENTIFIERS
+    je FastPathCpuidFeatures
+
+    cmp r8d, CPUID_HV_VENDOR_AND_MAX_FUNCTIONS
+    je FastPathCpuidVendor
+
+    cmp r8d, HYPERV_CPUID_INTERFACE
+    je FastPathCpuidInterface
+
+    jmp FastPathResumeToNextInstruction
+
+FastPathCpuidFeatures:
+    or ecx, HYPERV_HYPERVISOR_PRESENT_BIT       ; hypervisor present-bit (same as HvHandleCpuid)
+    jmp FastPathResumeToNextInstruction
+
+FastPathCpuidVendor:
+    mov eax, HYPERV_CPUID_INTERFACE
+    mov ebx, 65707948h  ; 'Hype'
+    mov ecx, 67624472h  ; 'rDbg'
+    xor edx, edx
+    jmp FastPathResumeToNextInstruction
+
+FastPathCpuidInterface:
+    mov eax, 30237648h  ; 'Hv#0' (not conforming to the Microsoft hypervisor interface)
+    xor ebx, ebx
+    xor ecx, ecx
+    xor edx, edx
+    jmp FastPathResumeToNextInstruction
+
+FastPathRdtsc:
+    cmp byte ptr [g_VmexitFastPathTsc], 0
+    je FullPath
+
+    rdtsc
+    jmp FastPathResumeToNextInstruction
+
+FastPathRdtscp:
+    cmp byte ptr [g_VmexitFastPathTsc], 0
+    je FullPath
+
+    rdtscp
+    jmp FastPathResumeToNextInstruction
+
+FastPathMovToCr3:
+    ;
+    ;   the mov-to-cr3s that neither load nor leave the address spaces in the
+    ;   filter are applied here (same as HvHandleControlRegisterAccess), the
+    ;   rest of them (and the mov-to-cr3s from rsp) are handled by the full path
+    ;
+    cmp byte ptr [g_VmexitFastPathCr3], 0
+    je FullPath
+
+    mov r8, VMCS_EXIT_QUALIFICATION
+    vmread r9, r8
+
+    mov r8d, r9d
+    and r8d, VMX_EXIT_QUALIFICATION_CONTROL_REGISTER_AND_ACCESS_TYPE
+    cmp r8d, VMX_EXIT_QUALIFICATION_MOV_TO_CR3
+    jne FullPath
+
+    shr r9d, 8
+    and r9d, 0fh        ; the source general-purpose register
+
+    cmp r9d, VMX_EXIT_QUALIFICATION_REGISTER_RSP
+    je FullPath
+
+    ;
+    ;   r8, r9 and r10 of the guest are on the stack
+    ;
+    xor r10, r10
+    cmp r9d, 0
+    cmove r10, rax
+    cmp r9d, 1
+    cmove r10, rcx
+    cmp r9d, 2
+    cmove r10, rdx
+    cmp r9d, 3
+    cmove r10, rbx
+    cmp r9d, 5
+    cmove r10, rbp
+    cmp r9d, 6
+    cmove r10, rsi
+    cmp r9d, 7
+    cmove r10, rdi
+    cmp r9d, 8
+    cmove r10, qword ptr [rsp+010h]
+    cmp r9d, 9
+    cmove r10, qword ptr [rsp+008h]
+    cmp r9d, 10
+    cmove r10, qword ptr [rsp+000h]
+    cmp r9d, 11
+    cmove r10, r11
+    cmp r9d, 12
+    cmove r10, r12
+    cmp r9d, 13
+    cmove r10, r13
+    cmp r9d, 14
+    cmove r10, r14
+    cmp r9d, 15
+    cmove r10, r15
+
+    btr r10, 63         ; the no-flush bit is not a part of the cr3
+
+    ;
+    ;   check the new cr3
+    ;
+    mov r8, CR3_PAGE_FRAME_MASK
+    mov r9, r10
+    and r9, r8
+
+    CR3_FILTER_INDEX = 0
+    REPT VMEXIT_FAST_PATH_CR3_FILTER_MAXIMUM_ENTRIES
+    cmp r9, qword ptr [g_VmexitFastPathCr3Filter + CR3_FILTER_INDEX * 8]
+    je FullPath
+    CR3_FILTER_INDEX = CR3_FILTER_INDEX + 1
+    ENDM
+
+    ;
+    ;   check the current cr3
+    ;
+    mov r8, VMCS_GUEST_CR3
+    vmread r9, r8
+    mov r8, CR3_PAGE_FRAME_MASK
+    and r9, r8
+
+    CR3_FILTER_INDEX = 0
+    REPT VMEXIT_FAST_PATH_CR3_FILTER_MAXIMUM_ENTRIES
+    cmp r9, qword ptr [g_VmexitFastPathCr3Filter + CR3_FILTER_INDEX * 8]
+    je FullPath
+    CR3_FILTER_INDEX = CR3_FILTER_INDEX + 1
+    ENDM
+
+    ;
+    ;   apply the new cr3 and invalidate the mappings of the VPID (the
+    ;   vm-exit won't flush them as we used VPID tags)
+    ;
+    mov r8, VMCS_GUEST_CR3
+    vmwrite r8, r10
+
+    push 0              ; linear address
+    push VPID_TAG       ; VPID
+    mov r8, INVVPID_SINGLE_CONTEXT
+    invvpid r8, oword ptr [rsp]
+    add rsp, 010h
+
+FastPathResumeToNextInstruction:
+    mov r8, VMCS_GUEST_RIP
+    vmread r9, r8
+    mov r8, VMCS_VMEXIT_INSTRUCTION_LENGTH
+    vmread r10, r8
+    add r9, r10
+    mov r8, VMCS_GUEST_RIP
+    vmwrite r8, r9
+
+    pop r10
+    pop r9
+    pop r8
+
+    popfq
+
+    sub rsp, 0100h      ; same as the full path
+    jmp VmxVmresume
+
+FullPath:
+    pop r10
+    pop r9
+    pop r8
+
     ; ------------ Save XMM Registers ------------
     ;
     ;   ;;;;;;;;;;;; 16 Byte * 16 Byte = 256 + 4  = 260 (0x106 == 0x110 but let's align it to have better performance) ;;;;;;;;;;;;
@@ -60,9 +307,53 @@ AsmVmexitHandler PROC
     push rax	
     
     mov rcx, rsp		; Fast call argument to PGUEST_REGS
+
+    ; ------------ Save Volatile XMM Registers (if needed) ------------
+    ;
+    ;   xmm6-xmm15 are non-volatile in the x64 calling convention, so they are preserved
+    ;   by the C handlers, xmm0-xmm5 and MxCsr are only saved if there is a requester
+    ;   (e.g., an event with custom code), the space is always reserved (below GUEST_REGS)
+    ;   so the layout of the registers remains the same, [rsp+068h] shows whether the
+    ;   registers are saved in this vm-exit or not
+    ;
+    sub     rsp, 070h
+    mov     qword ptr [rsp+068h], 0
+
+    cmp     dword ptr [g_SaveXmmRegistersOnVmexits], 0
+    je      SkipSaveXmmRegisters
+
+    movups  xmmword ptr [rsp+000h], xmm0    ; the stack might not be aligned
+    movups  xmmword ptr [rsp+010h], xmm1
+    movups  xmmword ptr [rsp+020h], xmm2
+    movups  xmmword ptr [rsp+030h], xmm3
+    movups  xmmword ptr [rsp+040h], xmm4
+    movups  xmmword ptr [rsp+050h], xmm5
+    stmxcsr dword ptr [rsp+060h]
+    mov     qword ptr [rsp+068h], 1
+
+SkipSaveXmmRegisters:
+    ; -----------------------------------------------------------------
+
     sub	rsp, 020h		; Free some space for Shadow Section
     call	VmxVmexitHandler
     add	rsp, 020h		; Restore the state
+
+    ; ------------ Restore Volatile XMM Registers (if saved) ------------
+    ;
+    cmp     qword ptr [rsp+068h], 0
+    je      SkipRestoreXmmRegisters
+
+    movups  xmm0, xmmword ptr [rsp+000h]
+    movups  xmm1, xmmword ptr [rsp+010h]
+    movups  xmm2, xmmword ptr [rsp+020h]
+    movups  xmm3, xmmword ptr [rsp+030h]
+    movups  xmm4, xmmword ptr [rsp+040h]
+    movups  xmm5, xmmword ptr [rsp+050h]
+    ldmxcsr dword ptr [rsp+060h]
+
+SkipRestoreXmmRegisters:
+    add     rsp, 070h
+    ; -------------------------------------------------------------------
     
     cmp	al, 1	; Check whether we have to turn off VMX or Not (the result is in RAX)
     je		AsmVmxoffHandler
@@ -15,15 +15,19 @@
  * @brief routines to broadcast virtualization and vmx initialization
  *  on all cores
  *
- * @return VOID
+ * @return BOOLEAN Returns true if the regions of all cores are allocated
  */
-VOID
+BOOLEAN
 BroadcastVmxVirtualizationAllCores()
 {
+    volatile LONG FailedCores = 0;
+
     //
-    // Broadcast to all cores
+    // Broadcast to all cores (the DPCs are finished once it returns)
     //
-    KeGenericCallDpc(DpcRoutinePerformVirtualization, NULL);
+    KeGenericCallDpc(DpcRoutinePerformVirtualization, (PVOID)&FailedCores);
+
+    return FailedCores == 0;
 }
 
 /**
@@ -178,6 +182,21 @@ BroadcastResetChangeAllMsrBitmapReadAllCores()
     KeGenericCallDpc(DpcRoutineResetMsrBitmapReadOnAllCores, NULL);
 }
 
+/**
+ * @brief routines for removing a single !msrread event
+ * @details other msrs (and other references to the same msr) are kept
+ * @param BitmapMask Bit mask of msr to release on msr bitmap
+ * @return VOID
+ */
+VOID
+BroadcastUnsetMsrBitmapReadAllCores(UINT64 BitmapMask)
+{
+    //
+    // Broadcast to all cores
+    //
+    KeGenericCallDpc(DpcRoutineUnsetMsrBitmapReadOnAllCores, BitmapMask);
+}
+
 /**
  * @brief routines for !msrwrite command which
  * @details causes vm-exit on all msr writes
@@ -205,6 +224,21 @@ BroadcastResetAllMsrBitmapWriteAllCores()
     KeGenericCallDpc(DpcRoutineResetMsrBitmapWriteOnAllCores, NULL);
 }
 
+/**
+ * @brief routines for removing a single !msrwrite event
+ * @details other msrs (and other references to the same msr) are kept
+ * @param BitmapMask Bit mask of msr to release on msr bitmap
+ * @return VOID
+ */
+VOID
+BroadcastUnsetMsrBitmapWriteAllCores(UINT64 BitmapMask)
+{
+    //
+    // Broadcast to all cores
+    //
+    KeGenericCallDpc(DpcRoutineUnsetMsrBitmapWriteOnAllCores, BitmapMask);
+}
+
 /**
  * @brief routines ONLY for disabling !tsc command
  * @return VOID
@@ -346,6 +380,38 @@ BroadcastDisableMovToControlRegistersExitingAllCores(PDEBUGGER_BROADCASTING_OPTI
     KeGenericCallDpc(DpcRoutineDisableMovControlRegisterExitingAllCores, BroadcastingOption);
 }
 
+/**
+ * @brief routines for adding a reference to a resource of the bitmap ownership
+ * @details the VMCS controls are changed only if the resource was not referenced
+ * @param BroadcastingOption The type (OptionalParam1), the index (OptionalParam2)
+ * and the mask (OptionalParam3) of the resource
+ * @return VOID
+ */
+VOID
+BroadcastAcquireBitmapOwnershipAllCores(PDEBUGGER_BROADCASTING_OPTIONS BroadcastingOption)
+{
+    //
+    // Broadcast to all cores
+    //
+    KeGenericCallDpc(DpcRoutineAcquireBitmapOwnershipAllCores, BroadcastingOption);
+}
+
+/**
+ * @brief routines for releasing a reference of a resource of the bitmap ownership
+ * @details the VMCS controls are changed only if the resource is not referenced anymore
+ * @param BroadcastingOption The type (OptionalParam1), the index (OptionalParam2)
+ * and the mask (OptionalParam3) of the resource
+ * @return VOID
+ */
+VOID
+BroadcastReleaseBitmapOwnershipAllCores(PDEBUGGER_BROADCASTING_OPTIONS BroadcastingOption)
+{
+    //
+    // Broadcast to all cores
+    //
+    KeGenericCallDpc(DpcRoutineReleaseBitmapOwnershipAllCores, BroadcastingOption);
+}
+
 /**
  * @brief routines for !dr
  * @details causes vm-exit on all accesses to debug registers
@@ -460,6 +526,28 @@ BroadcastRestoreToNormalEptpOnAllProcessors()
     KeGenericCallDpc(DpcRoutineRestoreToNormalEptp, 0x0);
 }
 
+/**
+ * @brief routines for enabling mode-based execution control (MBEC)
+ *
+ * @return VOID
+ */
+VOID
+BroadcastEnableModeBasedExecutionControlOnAllProcessors()
+{
+    KeGenericCallDpc(DpcRoutineEnableModeBasedExecutionControl, 0x0);
+}
+
+/**
+ * @brief routines for disabling mode-based execution control (MBEC)
+ *
+ * @return VOID
+ */
+VOID
+BroadcastDisableModeBasedExecutionControlOnAllProcessors()
+{
+    KeGenericCallDpc(DpcRoutineDisableModeBasedExecutionControl, 0x0);
+}
+
 /**
  * @brief routines for debugging threads (disable mov-to-cr3 exiting)
  *
@@ -514,3 +602,190 @@ BroadcastDisablePmlOnAllProcessors()
 {
     KeGenericCallDpc(DpcRoutineDisablePml, 0x0);
 }
+
+/**
+ * @brief routines for moving the entries of the PML buffers of all cores
+ * to a bitmap of the dirty pages
+ * @param BitmapIndex The index of the target bitmap
+ *
+ * @return VOID
+ */
+VOID
+BroadcastFlushPmlBuffersOnAllProcessors(UINT32 BitmapIndex)
+{
+    KeGenericCallDpc(DpcRoutineFlushPmlBuffer, (PVOID)(UINT64)BitmapIndex);
+}
+
+/**
+ * @brief routines for starting, stopping, pausing or resuming the trace
+ * of Intel PT on all cores
+ * @param Action The action of the cores (INTEL_PT_CORE_ACTION)
+ *
+ * @return VOID
+ */
+VOID
+BroadcastConfigureIntelPtOnAllProcessors(UINT32 Action)
+{
+    KeGenericCallDpc(DpcRoutineConfigureIntelPt, (PVOID)(UINT64)Action);
+}
+
+/**
+ * @brief routines for starting, stopping or draining the memory access
+ * sampling of PEBS on all cores
+ * @param Action The action of the cores (PEBS_SAMPLING_CORE_ACTION)
+ *
+ * @return VOID
+ */
+VOID
+BroadcastConfigurePebsSamplingOnAllProcessors(UINT32 Action)
+{
+    KeGenericCallDpc(DpcRoutineConfigurePebsSampling, (PVOID)(UINT64)Action);
+}
+
+/**
+ * @brief a broadcast that causes vm-exit on all execution of rdtsc/rdtscp on the target cores
+ * @details only the cores of the mask are changed
+ * @param CoreMask The mask of target cores (DEBUGGER_BROADCASTING_ALL_CORES_MASK
+ * for all cores)
+ * @return VOID
+ */
+VOID
+BroadcastEnableRdtscExitingOnCores(UINT64 CoreMask)
+{
+    //
+    // Broadcast to the target cores
+    //
+    DpcRoutineRunTaskOnCores(CoreMask, DpcRoutinePerformEnableRdtscExitingOnSingleCore, DpcRoutineEnableRdtscExitingAllCores, NULL);
+}
+
+/**
+ * @brief routines ONLY for disabling !tsc command on the target cores
+ * @details only the cores of the mask are changed
+ * @param CoreMask The mask of target cores (DEBUGGER_BROADCASTING_ALL_CORES_MASK
+ * for all cores)
+ * @return VOID
+ */
+VOID
+BroadcastDisableRdtscExitingForClearingEventsOnCores(UINT64 CoreMask)
+{
+    //
+    // Broadcast to the target cores
+    //
+    DpcRoutineRunTaskOnCores(CoreMask, DpcRoutinePerformDisableRdtscExitingForClearingTscEventsOnSingleCore, DpcRoutineDisableRdtscExitingForClearingTscEventsAllCores, NULL);
+}
+
+/**
+ * @brief routines for !pmc on the target cores
+ * @details only the cores of the mask are changed
+ * @param CoreMask The mask of target cores (DEBUGGER_BROADCASTING_ALL_CORES_MASK
+ * for all cores)
+ * @return VOID
+ */
+VOID
+BroadcastEnableRdpmcExitingOnCores(UINT64 CoreMask)
+{
+    //
+    // Broadcast to the target cores
+    //
+    DpcRoutineRunTaskOnCores(CoreMask, DpcRoutinePerformEnableRdpmcExitingOnSingleCore, DpcRoutineEnableRdpmcExitingAllCores, NULL);
+}
+
+/**
+ * @brief routines for disabling !pmc on the target cores
+ * @details only the cores of the mask are changed
+ * @param CoreMask The mask of target cores (DEBUGGER_BROADCASTING_ALL_CORES_MASK
+ * for all cores)
+ * @return VOID
+ */
+VOID
+BroadcastDisableRdpmcExitingOnCores(UINT64 CoreMask)
+{
+    //
+    // Broadcast to the target cores
+    //
+    DpcRoutineRunTaskOnCores(CoreMask, DpcRoutinePerformDisableRdpmcExitingOnSingleCore, DpcRoutineDisableRdpmcExitingAllCores, NULL);
+}
+
+/**
+ * @brief routines for disabling syscall hooks on the target cores
+ * @details only the cores of the mask are changed
+ * @param CoreMask The mask of target cores (DEBUGGER_BROADCASTING_ALL_CORES_MASK
+ * for all cores)
+ * @return VOID
+ */
+VOID
+BroadcastDisableEferSyscallEventsOnCores(UINT64 CoreMask)
+{
+    //
+    // Broadcast to the target cores
+    //
+    DpcRoutineRunTaskOnCores(CoreMask, DpcRoutinePerformDisableEferSyscallHookOnSingleCore, DpcRoutineDisableEferSyscallEvents, NULL);
+}
+
+/**
+ * @brief routines for !interrupt command on the target cores
+ * @details only the cores of the mask are changed
+ * @param CoreMask The mask of target cores (DEBUGGER_BROADCASTING_ALL_CORES_MASK
+ * for all cores)
+ * @return VOID
+ */
+VOID
+BroadcastSetExternalInterruptExitingOnCores(UINT64 CoreMask)
+{
+    //
+    // Broadcast to the target cores
+    //
+    DpcRoutineRunTaskOnCores(CoreMask, DpcRoutinePerformSetExternalInterruptExitingOnSingleCore, DpcRoutineSetEnableExternalInterruptExitingOnAllCores, NULL);
+}
+
+/**
+ * @brief routines for ONLY terminate !interrupt command on the target cores
+ * @details only the cores of the mask are changed
+ * @param CoreMask The mask of target cores (DEBUGGER_BROADCASTING_ALL_CORES_MASK
+ * for all cores)
+ * @return VOID
+ */
+VOID
+BroadcastUnsetExternalInterruptExitingOnlyOnClearingInterruptEventsOnCores(UINT64 CoreMask)
+{
+    //
+    // Broadcast to the target cores
+    //
+    DpcRoutineRunTaskOnCores(CoreMask, DpcRoutinePerformUnsetExternalInterruptExitingForClearingInterruptEventsOnSingleCore, DpcRoutineSetDisableExternalInterruptExitingOnlyOnClearingInterruptEventsOnAllCores, NULL);
+}
+
+/**
+ * @brief routines for adding a reference to a resource of the bitmap ownership on the target cores
+ * @details only the cores of the mask are changed
+ * @param CoreMask The mask of target cores (DEBUGGER_BROADCASTING_ALL_CORES_MASK
+ * for all cores)
+ * @param BroadcastingOption The type (OptionalParam1), the index (OptionalParam2)
+ * and the mask (OptionalParam3) of the resource
+ * @return VOID
+ */
+VOID
+BroadcastAcquireBitmapOwnershipOnCores(UINT64 CoreMask, PDEBUGGER_BROADCASTING_OPTIONS BroadcastingOption)
+{
+    //
+    // Broadcast to the target cores
+    //
+    DpcRoutineRunTaskOnCores(CoreMask, DpcRoutinePerformAcquireBitmapOwnership, DpcRoutineAcquireBitmapOwnershipAllCores, BroadcastingOption);
+}
+
+/**
+ * @brief routines for releasing a reference of a resource of the bitmap ownership on the target cores
+ * @details only the cores of the mask are changed
+ * @param CoreMask The mask of target cores (DEBUGGER_BROADCASTING_ALL_CORES_MASK
+ * for all cores)
+ * @param BroadcastingOption The type (OptionalParam1), the index (OptionalParam2)
+ * and the mask (OptionalParam3) of the resource
+ * @return VOID
+ */
+VOID
+BroadcastReleaseBitmapOwnershipOnCores(UINT64 CoreMask, PDEBUGGER_BROADCASTING_OPTIONS BroadcastingOption)
+{
+    //
+    // Broadcast to the target cores
+    //
+    DpcRoutineRunTaskOnCores(CoreMask, DpcRoutinePerformReleaseBitmapOwnership, DpcRoutineReleaseBitmapOwnershipAllCores, BroadcastingOption);
+}
@@ -115,6 +115,60 @@ DpcRoutineRunTaskOnSingleCore(UINT32 CoreNumber, PVOID Routine, PVOID DeferredCo
     return STATUS_SUCCESS;
 }
 
+/**
+ * @brief Run a task on the cores of a mask of cores
+ * @details only the target cores receive DPCs, if all of the cores are
+ * targeted, the all-cores routine is broadcasted instead (so the cores
+ * are configured in parallel)
+ *
+ * @param CoreMask The mask of target cores (or DEBUGGER_BROADCASTING_ALL_CORES_MASK)
+ * @param SingleCoreRoutine The routine that is designed for a single core
+ * (should release OneCoreLock)
+ * @param AllCoresRoutine The routine that is designed for KeGenericCallDpc
+ * @param DeferredContext an optional parameter to the routines
+ * @return NTSTATUS
+ */
+NTSTATUS
+DpcRoutineRunTaskOnCores(UINT64 CoreMask, PVOID SingleCoreRoutine, PVOID AllCoresRoutine, PVOID DeferredContext)
+{
+    UINT32   ProcessorCount;
+    UINT64   ActiveCoresMask;
+    NTSTATUS Status = STATUS_SUCCESS;
+
+    ProcessorCount = KeQueryActiveProcessorCount(0);
+
+    //
+    // The cores from the 64th core are only targeted by the all cores mask
+    //
+    ActiveCoresMask = ProcessorCount >= 64 ? DEBUGGER_BROADCASTING_ALL_CORES_MASK : (1ull << ProcessorCount) - 1;
+
+    if (CoreMask == DEBUGGER_BROADCASTING_ALL_CORES_MASK || (ProcessorCount < 64 && (CoreMask & ActiveCoresMask) == ActiveCoresMask))
+    {
+        //
+        // Broadcast to all cores
+        //
+        KeGenericCallDpc(AllCoresRoutine, DeferredContext);
+
+        return STATUS_SUCCESS;
+    }
+
+    //
+    // Run the task on the target cores, one by one
+    //
+    for (UINT32 CoreId = 0; CoreId < ProcessorCount && CoreId < 64; CoreId++)
+    {
+        if (CoreMask & (1ull << CoreId))
+        {
+            if (!NT_SUCCESS(DpcRoutineRunTaskOnSingleCore(CoreId, SingleCoreRoutine, DeferredContext)))
+            {
+                Status = STATUS_UNSUCCESSFUL;
+            }
+        }
+    }
+
+    return Status;
+}
+
 /**
  * @brief Broadcast VmxPerformVirtualizationOnSpecificCore
  *
@@ -130,7 +184,13 @@ DpcRoutinePerformVirtualization(KDPC * Dpc, PVOID DeferredContext, PVOID SystemA
     //
     // Allocates Vmx regions for all logical cores (Vmxon region and Vmcs region)
     //
-    VmxPerformVirtualizationOnSpecificCore();
+    if (!VmxPerformVirtualizationOnSpecificCore())
+    {
+        //
+        // Count of the cores that failed is in the context
+        //
+        InterlockedIncrement((volatile LONG *)DeferredContext);
+    }
 
     //
     // Wait for all DPCs to synchronize at this point
@@ -201,6 +261,62 @@ DpcRoutinePerformChangeMsrBitmapWriteOnSingleCore(KDPC * Dpc, PVOID DeferredCont
     SpinlockUnlock(&OneCoreLock);
 }
 
+/**
+ * @brief release a reference of msr bitmap read on a single core
+ *
+ * @param Dpc
+ * @param DeferredContext
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutinePerformUnsetMsrBitmapReadOnSingleCore(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(SystemArgument1);
+    UNREFERENCED_PARAMETER(SystemArgument2);
+
+    //
+    // unset msr bitmap (read)
+    //
+    AsmVmxVmcall(VMCALL_UNSET_MSR_BITMAP_READ, DeferredContext, 0, 0);
+
+    //
+    // As this function is designed for a single,
+    // we have to release the synchronization lock here
+    //
+    SpinlockUnlock(&OneCoreLock);
+}
+
+/**
+ * @brief release a reference of msr bitmap write on a single core
+ *
+ * @param Dpc
+ * @param DeferredContext
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutinePerformUnsetMsrBitmapWriteOnSingleCore(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(SystemArgument1);
+    UNREFERENCED_PARAMETER(SystemArgument2);
+
+    //
+    // unset msr bitmap (write)
+    //
+    AsmVmxVmcall(VMCALL_UNSET_MSR_BITMAP_WRITE, DeferredContext, 0, 0);
+
+    //
+    // As this function is designed for a single,
+    // we have to release the synchronization lock here
+    //
+    SpinlockUnlock(&OneCoreLock);
+}
+
 /**
  * @brief set rdtsc/rdtscp exiting
  *
@@ -230,6 +346,35 @@ DpcRoutinePerformEnableRdtscExitingOnSingleCore(KDPC * Dpc, PVOID DeferredContex
     SpinlockUnlock(&OneCoreLock);
 }
 
+/**
+ * @brief unset rdtsc/rdtscp exiting ONLY for clearing !tsc events on a single core
+ *
+ * @param Dpc
+ * @param DeferredContext
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutinePerformDisableRdtscExitingForClearingTscEventsOnSingleCore(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(DeferredContext);
+    UNREFERENCED_PARAMETER(SystemArgument1);
+    UNREFERENCED_PARAMETER(SystemArgument2);
+
+    //
+    // Disables rdtsc/rdtscp exiting ONLY for clearing events
+    //
+    AsmVmxVmcall(VMCALL_DISABLE_RDTSC_EXITING_ONLY_FOR_TSC_EVENTS, 0, 0, 0);
+
+    //
+    // As this function is designed for a single,
+    // we have to release the synchronization lock here
+    //
+    SpinlockUnlock(&OneCoreLock);
+}
+
 /**
  * @brief set rdpmc exiting
  *
@@ -259,6 +404,35 @@ DpcRoutinePerformEnableRdpmcExitingOnSingleCore(KDPC * Dpc, PVOID DeferredContex
     SpinlockUnlock(&OneCoreLock);
 }
 
+/**
+ * @brief unset rdpmc exiting on a single core
+ *
+ * @param Dpc
+ * @param DeferredContext
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutinePerformDisableRdpmcExitingOnSingleCore(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(DeferredContext);
+    UNREFERENCED_PARAMETER(SystemArgument1);
+    UNREFERENCED_PARAMETER(SystemArgument2);
+
+    //
+    // disable rdpmc exiting
+    //
+    AsmVmxVmcall(VMCALL_UNSET_RDPMC_EXITING, 0, 0, 0);
+
+    //
+    // As this function is designed for a single,
+    // we have to release the synchronization lock here
+    //
+    SpinlockUnlock(&OneCoreLock);
+}
+
 /**
  * @brief change exception bitmap on a single core
  *
@@ -317,6 +491,68 @@ DpcRoutinePerformEnableMovToDebugRegistersExiting(KDPC * Dpc, PVOID DeferredCont
     SpinlockUnlock(&OneCoreLock);
 }
 
+/**
+ * @brief Add a reference to a resource of the bitmap ownership on a single core
+ *
+ * @param Dpc
+ * @param BroadcastingOption The type, the index and the mask of the resource
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutinePerformAcquireBitmapOwnership(KDPC * Dpc, DEBUGGER_BROADCASTING_OPTIONS * BroadcastingOption, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(SystemArgument1);
+    UNREFERENCED_PARAMETER(SystemArgument2);
+
+    //
+    // add a reference to a resource from vmx-root
+    //
+    AsmVmxVmcall(VMCALL_ACQUIRE_BITMAP_OWNERSHIP,
+                 BroadcastingOption->OptionalParam1,
+                 BroadcastingOption->OptionalParam2,
+                 BroadcastingOption->OptionalParam3);
+
+    //
+    // As this function is designed for a single,
+    // we have to release the synchronization lock here
+    //
+    SpinlockUnlock(&OneCoreLock);
+}
+
+/**
+ * @brief Release a reference of a resource of the bitmap ownership on a single core
+ *
+ * @param Dpc
+ * @param BroadcastingOption The type, the index and the mask of the resource
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutinePerformReleaseBitmapOwnership(KDPC * Dpc, DEBUGGER_BROADCASTING_OPTIONS * BroadcastingOption, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(SystemArgument1);
+    UNREFERENCED_PARAMETER(SystemArgument2);
+
+    //
+    // release a reference of a resource from vmx-root
+    //
+    AsmVmxVmcall(VMCALL_RELEASE_BITMAP_OWNERSHIP,
+                 BroadcastingOption->OptionalParam1,
+                 BroadcastingOption->OptionalParam2,
+                 BroadcastingOption->OptionalParam3);
+
+    //
+    // As this function is designed for a single,
+    // we have to release the synchronization lock here
+    //
+    SpinlockUnlock(&OneCoreLock);
+}
+
 /**
  * @brief Set the Mov to Control Registers Exitings
  *
@@ -374,6 +610,35 @@ DpcRoutinePerformSetExternalInterruptExitingOnSingleCore(KDPC * Dpc, PVOID Defer
     SpinlockUnlock(&OneCoreLock);
 }
 
+/**
+ * @brief Disable external interrupt exiting ONLY for clearing !interrupt events on a single core
+ *
+ * @param Dpc
+ * @param DeferredContext
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutinePerformUnsetExternalInterruptExitingForClearingInterruptEventsOnSingleCore(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(DeferredContext);
+    UNREFERENCED_PARAMETER(SystemArgument1);
+    UNREFERENCED_PARAMETER(SystemArgument2);
+
+    //
+    // Disable external interrupt exiting only to clear !interrupt commands
+    //
+    AsmVmxVmcall(VMCALL_DISABLE_EXTERNAL_INTERRUPT_EXITING_ONLY_TO_CLEAR_INTERRUPT_COMMANDS, 0, 0, 0);
+
+    //
+    // As this function is designed for a single,
+    // we have to release the synchronization lock here
+    //
+    SpinlockUnlock(&OneCoreLock);
+}
+
 /**
  * @brief Enable syscall hook EFER on a single core
  *
@@ -403,6 +668,35 @@ DpcRoutinePerformEnableEferSyscallHookOnSingleCore(KDPC * Dpc, PVOID DeferredCon
     SpinlockUnlock(&OneCoreLock);
 }
 
+/**
+ * @brief Disable syscall hook EFER on a single core
+ *
+ * @param Dpc
+ * @param DeferredContext
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutinePerformDisableEferSyscallHookOnSingleCore(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(DeferredContext);
+    UNREFERENCED_PARAMETER(SystemArgument1);
+    UNREFERENCED_PARAMETER(SystemArgument2);
+
+    //
+    // Disable syscall hook EFER
+    //
+    AsmVmxVmcall(VMCALL_DISABLE_SYSCALL_HOOK_EFER, NULL, 0, 0);
+
+    //
+    // As this function is designed for a single,
+    // we have to release the synchronization lock here
+    //
+    SpinlockUnlock(&OneCoreLock);
+}
+
 /**
  * @brief change I/O bitmap on a single core
  *
@@ -524,6 +818,68 @@ DpcRoutineRestoreToNormalEptp(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArg
     KeSignalCallDpcDone(SystemArgument1);
 }
 
+/**
+ * @brief Broadcast to enable mode-based execution control (MBEC)
+ *
+ * @param Dpc
+ * @param DeferredContext
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutineEnableModeBasedExecutionControl(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(DeferredContext);
+
+    //
+    // Enable MBEC from vmx-root
+    //
+    AsmVmxVmcall(VMCALL_ENABLE_MODE_BASED_EXECUTION_CONTROL, 0, 0, 0);
+
+    //
+    // Wait for all DPCs to synchronize at this point
+    //
+    KeSignalCallDpcSynchronize(SystemArgument2);
+
+    //
+    // Mark the DPC as being complete
+    //
+    KeSignalCallDpcDone(SystemArgument1);
+}
+
+/**
+ * @brief Broadcast to disable mode-based execution control (MBEC)
+ *
+ * @param Dpc
+ * @param DeferredContext
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutineDisableModeBasedExecutionControl(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(DeferredContext);
+
+    //
+    // Disable MBEC from vmx-root
+    //
+    AsmVmxVmcall(VMCALL_DISABLE_MODE_BASED_EXECUTION_CONTROL, 0, 0, 0);
+
+    //
+    // Wait for all DPCs to synchronize at this point
+    //
+    KeSignalCallDpcSynchronize(SystemArgument2);
+
+    //
+    // Mark the DPC as being complete
+    //
+    KeSignalCallDpcDone(SystemArgument1);
+}
+
 /**
  * @brief Broadcast to disable mov-to-cr3 exitings
  *
@@ -679,6 +1035,97 @@ DpcRoutineDisablePml(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, P
     KeSignalCallDpcDone(SystemArgument1);
 }
 
+/**
+ * @brief Broadcast moving the entries of the PML buffer to a bitmap of
+ * the dirty pages on all cores
+ *
+ * @param Dpc
+ * @param DeferredContext The index of the target bitmap
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutineFlushPmlBuffer(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+
+    //
+    // Flush the PML buffer from vmx-root
+    //
+    AsmVmxVmcall(VMCALL_FLUSH_DIRTY_LOGGING_BUFFER, (UINT64)DeferredContext, 0, 0);
+
+    //
+    // Wait for all DPCs to synchronize at this point
+    //
+    KeSignalCallDpcSynchronize(SystemArgument2);
+
+    //
+    // Mark the DPC as being complete
+    //
+    KeSignalCallDpcDone(SystemArgument1);
+}
+
+/**
+ * @brief Start, stop, pause or resume the trace of Intel PT on all cores
+ *
+ * @param Dpc
+ * @param DeferredContext The action (INTEL_PT_CORE_ACTION)
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutineConfigureIntelPt(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+
+    //
+    // Configure the trace from vmx-root
+    //
+    AsmVmxVmcall(VMCALL_CONFIGURE_INTEL_PT, (UINT64)DeferredContext, 0, 0);
+
+    //
+    // Wait for all DPCs to synchronize at this point
+    //
+    KeSignalCallDpcSynchronize(SystemArgument2);
+
+    //
+    // Mark the DPC as being complete
+    //
+    KeSignalCallDpcDone(SystemArgument1);
+}
+
+/**
+ * @brief Start, stop or drain the memory access sampling of PEBS on all cores
+ *
+ * @param Dpc
+ * @param DeferredContext The action (PEBS_SAMPLING_CORE_ACTION)
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutineConfigurePebsSampling(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+
+    //
+    // Configure the sampling from vmx-root
+    //
+    AsmVmxVmcall(VMCALL_CONFIGURE_PEBS_SAMPLING, (UINT64)DeferredContext, 0, 0);
+
+    //
+    // Wait for all DPCs to synchronize at this point
+    //
+    KeSignalCallDpcSynchronize(SystemArgument2);
+
+    //
+    // Mark the DPC as being complete
+    //
+    KeSignalCallDpcDone(SystemArgument1);
+}
+
 /**
  * @brief Disable Msr Bitmaps on all cores (vm-exit on all msrs)
  *
@@ -740,6 +1187,36 @@ DpcRoutineResetMsrBitmapReadOnAllCores(KDPC * Dpc, PVOID DeferredContext, PVOID
     KeSignalCallDpcDone(SystemArgument1);
 }
 
+/**
+ * @brief Release a reference of Msr Bitmaps Read on all cores
+ *
+ * @param Dpc
+ * @param DeferredContext Msr index to be unmasked on msr bitmap
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutineUnsetMsrBitmapReadOnAllCores(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+
+    //
+    // Unset msr bitmaps from vmx-root
+    //
+    AsmVmxVmcall(VMCALL_UNSET_MSR_BITMAP_READ, DeferredContext, 0, 0);
+
+    //
+    // Wait for all DPCs to synchronize at this point
+    //
+    KeSignalCallDpcSynchronize(SystemArgument2);
+
+    //
+    // Mark the DPC as being complete
+    //
+    KeSignalCallDpcDone(SystemArgument1);
+}
+
 /**
  * @brief Disable Msr Bitmaps on all cores (vm-exit on all msrs)
  *
@@ -801,6 +1278,36 @@ DpcRoutineResetMsrBitmapWriteOnAllCores(KDPC * Dpc, PVOID DeferredContext, PVOID
     KeSignalCallDpcDone(SystemArgument1);
 }
 
+/**
+ * @brief Release a reference of Msr Bitmaps Write on all cores
+ *
+ * @param Dpc
+ * @param DeferredContext Msr index to be unmasked on msr bitmap
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutineUnsetMsrBitmapWriteOnAllCores(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+
+    //
+    // Unset msr bitmaps from vmx-root
+    //
+    AsmVmxVmcall(VMCALL_UNSET_MSR_BITMAP_WRITE, DeferredContext, 0, 0);
+
+    //
+    // Wait for all DPCs to synchronize at this point
+    //
+    KeSignalCallDpcSynchronize(SystemArgument2);
+
+    //
+    // Mark the DPC as being complete
+    //
+    KeSignalCallDpcDone(SystemArgument1);
+}
+
 /**
  * @brief Enables rdtsc/rdtscp exiting in primary cpu-based controls
  *
@@ -1146,6 +1653,103 @@ DpcRoutineEnableMovDebigRegisterExitingAllCores(KDPC * Dpc, PVOID DeferredContex
     KeSignalCallDpcDone(SystemArgument1);
 }
 
+/**
+ * @brief Add a reference to a resource of the bitmap ownership on all cores
+ *
+ * @param Dpc
+ * @param BroadcastingOption The type, the index and the mask of the resource
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutineAcquireBitmapOwnershipAllCores(KDPC * Dpc, DEBUGGER_BROADCASTING_OPTIONS * BroadcastingOption, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+
+    //
+    // add a reference to a resource from vmx-root
+    //
+    AsmVmxVmcall(VMCALL_ACQUIRE_BITMAP_OWNERSHIP,
+                 BroadcastingOption->OptionalParam1,
+                 BroadcastingOption->OptionalParam2,
+                 BroadcastingOption->OptionalParam3);
+
+    //
+    // Wait for all DPCs to synchronize at this point
+    //
+    KeSignalCallDpcSynchronize(SystemArgument2);
+
+    //
+    // Mark the DPC as being complete
+    //
+    KeSignalCallDpcDone(SystemArgument1);
+}
+
+/**
+ * @brief Release a reference of a resource of the bitmap ownership on all cores
+ *
+ * @param Dpc
+ * @param BroadcastingOption The type, the index and the mask of the resource
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutineReleaseBitmapOwnershipAllCores(KDPC * Dpc, DEBUGGER_BROADCASTING_OPTIONS * BroadcastingOption, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+
+    //
+    // release a reference of a resource from vmx-root
+    //
+    AsmVmxVmcall(VMCALL_RELEASE_BITMAP_OWNERSHIP,
+                 BroadcastingOption->OptionalParam1,
+                 BroadcastingOption->OptionalParam2,
+                 BroadcastingOption->OptionalParam3);
+
+    //
+    // Wait for all DPCs to synchronize at this point
+    //
+    KeSignalCallDpcSynchronize(SystemArgument2);
+
+    //
+    // Mark the DPC as being complete
+    //
+    KeSignalCallDpcDone(SystemArgument1);
+}
+
+/**
+ * @brief Re-apply the requests of the VMX preemption timer on all cores
+ *
+ * @param Dpc
+ * @param DeferredContext
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutineUpdateVmxPreemptionTimerAllCores(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(DeferredContext);
+
+    //
+    // update the timer from vmx-root
+    //
+    AsmVmxVmcall(VMCALL_UPDATE_VMX_PREEMPTION_TIMER, 0, 0, 0);
+
+    //
+    // Wait for all DPCs to synchronize at this point
+    //
+    KeSignalCallDpcSynchronize(SystemArgument2);
+
+    //
+    // Mark the DPC as being complete
+    //
+    KeSignalCallDpcDone(SystemArgument1);
+}
+
 /**
  * @brief Enables mov control registers exitings
  *
@@ -125,3 +125,42 @@ ApicSelfIpi(UINT32 Vector)
         XApicIcrWrite(APIC_DEST_SELF | APIC_DEST_PHYSICAL | APIC_DM_FIXED | Vector, 0);
     }
 }
+
+/**
+ * @brief Read the performance counter entry (LVT) of the local APIC
+ * of the current core
+ *
+ * @return UINT32
+ */
+UINT32
+ApicReadLvtPerformanceCounter()
+{
+    if (g_CompatibilityCheck.IsX2Apic)
+    {
+        return (UINT32)__readmsr(X2_MSR_BASE + TO_X2(APIC_LVTPC));
+    }
+    else
+    {
+        return *(volatile UINT32 *)((uintptr_t)g_ApicBase + APIC_LVTPC);
+    }
+}
+
+/**
+ * @brief Change the performance counter entry (LVT) of the local APIC
+ * of the current core
+ *
+ * @param Value
+ * @return VOID
+ */
+VOID
+ApicWriteLvtPerformanceCounter(UINT32 Value)
+{
+    if (g_CompatibilityCheck.IsX2Apic)
+    {
+        __writemsr(X2_MSR_BASE + TO_X2(APIC_LVTPC), Value);
+    }
+    else
+    {
+        *(volatile UINT32 *)((uintptr_t)g_ApicBase + APIC_LVTPC) = Value;
+    }
+}
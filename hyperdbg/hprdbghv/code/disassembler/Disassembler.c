@@ -279,9 +279,32 @@ DisassemblerLengthDisassembleEngine(PVOID Address, BOOLEAN Is32Bit)
     return NULL;
 }
 
+/**
+ * @brief Get the entry of an instruction in the cache of the lengths of
+ * instructions of the current core
+ * @details the cache is only used in vmx-root as the core might be
+ * changed in vmx non-root
+ *
+ * @param Address
+ *
+ * @return PINSTRUCTION_LENGTH_CACHE_ENTRY The entry or NULL if the cache is not usable
+ */
+static PINSTRUCTION_LENGTH_CACHE_ENTRY
+DisassemblerGetInstructionLengthCacheEntry(UINT64 Address)
+{
+    if (VmxGetCurrentExecutionMode() != VmxExecutionModeRoot)
+    {
+        return NULL;
+    }
+
+    return &g_GuestState[KeGetCurrentProcessorNumber()].InstructionLengthCache.Entries[Address & (INSTRUCTION_LENGTH_CACHE_ENTRIES - 1)];
+}
+
 /**
  * @brief Disassembler length disassembler engine
- * @details Should be called in VMX-root mode
+ * @details Should be called in VMX-root mode, the lengths are cached
+ * per core and the cached length is used as long as the bytes of the
+ * instruction are not changed
  *
  * @param Address
  * @param Is32Bit
@@ -291,8 +314,10 @@ DisassemblerLengthDisassembleEngine(PVOID Address, BOOLEAN Is32Bit)
 UINT32
 DisassemblerLengthDisassembleEngineInVmxRootOnTargetProcess(PVOID Address, BOOLEAN Is32Bit)
 {
-    BYTE   SafeMemoryToRead[MAXIMUM_INSTR_SIZE] = {0};
-    UINT64 SizeOfSafeBufferToRead               = 0;
+    BYTE                            SafeMemoryToRead[MAXIMUM_INSTR_SIZE] = {0};
+    UINT64                          SizeOfSafeBufferToRead               = 0;
+    UINT32                          Length                               = 0;
+    PINSTRUCTION_LENGTH_CACHE_ENTRY Entry                                = NULL;
 
     //
     // Read the maximum number of instruction that is valid to be read in the
@@ -307,7 +332,36 @@ DisassemblerLengthDisassembleEngineInVmxRootOnTargetProcess(PVOID Address, BOOLE
                                               SafeMemoryToRead,
                                               SizeOfSafeBufferToRead);
 
-    return DisassemblerLengthDisassembleEngine(SafeMemoryToRead, Is32Bit);
+    //
+    // Check whether the same instruction is decoded before
+    //
+    Entry = DisassemblerGetInstructionLengthCacheEntry((UINT64)Address);
+
+    if (Entry != NULL &&
+        Entry->Length != 0 &&
+        Entry->Address == (UINT64)Address &&
+        Entry->Is32Bit == Is32Bit &&
+        Entry->Length <= SizeOfSafeBufferToRead &&
+        RtlCompareMemory(Entry->Bytes, SafeMemoryToRead, Entry->Length) == Entry->Length)
+    {
+        return Entry->Length;
+    }
+
+    Length = DisassemblerLengthDisassembleEngine(SafeMemoryToRead, Is32Bit);
+
+    //
+    // Cache the length of the instruction
+    //
+    if (Entry != NULL && Length != 0 && Length <= MAXIMUM_INSTR_SIZE)
+    {
+        Entry->Address = (UINT64)Address;
+        Entry->Length  = (UINT8)Length;
+        Entry->Is32Bit = Is32Bit;
+
+        RtlCopyMemory(Entry->Bytes, SafeMemoryToRead, Length);
+    }
+
+    return Length;
 }
 
 /**
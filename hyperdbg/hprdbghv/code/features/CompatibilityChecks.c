@@ -126,6 +126,484 @@ CompatibilityCheckPml()
     }
 }
 
+/**
+ * @brief Check for VMX preemption timer support
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CompatibilityCheckPreemptionTimer()
+{
+    IA32_VMX_BASIC_REGISTER VmxBasicMsr = {0};
+    ULONG                   PinBasedControls;
+
+    VmxBasicMsr.AsUInt = __readmsr(IA32_VMX_BASIC);
+
+    PinBasedControls = HvAdjustControls(PIN_BASED_VM_EXECUTION_CONTROLS_ACTIVE_VMX_TIMER,
+                                        VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_PINBASED_CTLS : IA32_VMX_PINBASED_CTLS);
+
+    if (PinBasedControls & PIN_BASED_VM_EXECUTION_CONTROLS_ACTIVE_VMX_TIMER)
+    {
+        //
+        // The processor supports VMX preemption timer
+        //
+        return TRUE;
+    }
+    else
+    {
+        //
+        // Not supported
+        //
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Check for saving the VMX preemption timer on vm-exits
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CompatibilityCheckPreemptionTimerSaving()
+{
+    IA32_VMX_BASIC_REGISTER VmxBasicMsr = {0};
+    ULONG                   VmExitControls;
+
+    VmxBasicMsr.AsUInt = __readmsr(IA32_VMX_BASIC);
+
+    VmExitControls = HvAdjustControls(VM_EXIT_SAVE_VMX_PREEMPTION_TIMER,
+                                      VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_EXIT_CTLS : IA32_VMX_EXIT_CTLS);
+
+    return (VmExitControls & VM_EXIT_SAVE_VMX_PREEMPTION_TIMER) ? TRUE : FALSE;
+}
+
+/**
+ * @brief Get the rate of the VMX preemption timer
+ *
+ * @return UINT32 The timer counts down by 1 every time bit X of the TSC changes
+ */
+UINT32
+CompatibilityCheckGetPreemptionTimerRate()
+{
+    IA32_VMX_MISC_REGISTER VmxMiscMsr = {0};
+
+    VmxMiscMsr.AsUInt = __readmsr(IA32_VMX_MISC);
+
+    return (UINT32)VmxMiscMsr.PreemptionTimerTscRelationship;
+}
+
+/**
+ * @brief Check for Intel Processor Trace support in VMX non-root
+ * @details the trace is only used with the ToPA output and the guest's
+ * IA32_RTIT_CTL is loaded on vm-entries and cleared on vm-exits, so
+ * vmx-root is never traced
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CompatibilityCheckIntelPt()
+{
+    IA32_VMX_BASIC_REGISTER VmxBasicMsr = {0};
+    int                     Regs[4];
+    ULONG                   VmExitControls;
+    ULONG                   VmEntryControls;
+
+    CommonCpuidInstruction(0, 0, Regs);
+
+    if (Regs[0] < 0x14)
+    {
+        return FALSE;
+    }
+
+    //
+    // CPUID.(EAX=07H,ECX=0):EBX[25] indicates Intel PT support
+    //
+    CommonCpuidInstruction(7, 0, Regs);
+
+    if (!(Regs[1] & (1 << 25)))
+    {
+        return FALSE;
+    }
+
+    //
+    // CPUID.(EAX=14H,ECX=0):ECX[0] indicates ToPA output support
+    //
+    CommonCpuidInstruction(0x14, 0, Regs);
+
+    if (!(Regs[2] & 1))
+    {
+        return FALSE;
+    }
+
+    //
+    // IA32_VMX_MISC[14] indicates that Intel PT can be used in VMX operation
+    //
+    if (!(__readmsr(IA32_VMX_MISC) & (1ull << 14)))
+    {
+        return FALSE;
+    }
+
+    VmxBasicMsr.AsUInt = __readmsr(IA32_VMX_BASIC);
+
+    VmExitControls  = HvAdjustControls(VM_EXIT_CLEAR_IA32_RTIT_CTL,
+                                       VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_EXIT_CTLS : IA32_VMX_EXIT_CTLS);
+    VmEntryControls = HvAdjustControls(VM_ENTRY_LOAD_IA32_RTIT_CTL,
+                                       VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_ENTRY_CTLS : IA32_VMX_ENTRY_CTLS);
+
+    return (VmExitControls & VM_EXIT_CLEAR_IA32_RTIT_CTL) && (VmEntryControls & VM_ENTRY_LOAD_IA32_RTIT_CTL);
+}
+
+/**
+ * @brief Check for filtering the Intel Processor Trace by CR3
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CompatibilityCheckIntelPtCr3Filtering()
+{
+    int Regs[4];
+
+    //
+    // CPUID.(EAX=14H,ECX=0):EBX[0] indicates CR3 filtering support
+    //
+    CommonCpuidInstruction(0x14, 0, Regs);
+
+    return (Regs[1] & 1) ? TRUE : FALSE;
+}
+
+/**
+ * @brief Get the count of the address ranges of the Intel Processor Trace
+ *
+ * @return UINT32
+ */
+UINT32
+CompatibilityCheckGetIntelPtAddressRanges()
+{
+    int Regs[4];
+
+    //
+    // CPUID.(EAX=14H,ECX=0):EBX[2] indicates IP filtering support and
+    // CPUID.(EAX=14H,ECX=1):EAX[2:0] is the count of the address ranges
+    //
+    CommonCpuidInstruction(0x14, 0, Regs);
+
+    if (!(Regs[1] & (1 << 2)))
+    {
+        return 0;
+    }
+
+    CommonCpuidInstruction(0x14, 1, Regs);
+
+    return Regs[0] & 0x7;
+}
+
+/**
+ * @brief Check for architectural LBRs (Last Branch Records) support in
+ * VMX non-root
+ * @details the guest's IA32_LBR_CTL is loaded on vm-entries and cleared
+ * on vm-exits, so the branches of vmx-root are never recorded
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CompatibilityCheckArchLbr()
+{
+    IA32_VMX_BASIC_REGISTER VmxBasicMsr = {0};
+    int                     Regs[4];
+    ULONG                   VmExitControls;
+    ULONG                   VmEntryControls;
+
+    CommonCpuidInstruction(0, 0, Regs);
+
+    if (Regs[0] < 0x1c)
+    {
+        return FALSE;
+    }
+
+    //
+    // CPUID.(EAX=07H,ECX=0):EDX[19] indicates architectural LBRs support
+    //
+    CommonCpuidInstruction(7, 0, Regs);
+
+    if (!(Regs[3] & (1 << 19)))
+    {
+        return FALSE;
+    }
+
+    VmxBasicMsr.AsUInt = __readmsr(IA32_VMX_BASIC);
+
+    VmExitControls  = HvAdjustControls(VM_EXIT_CLEAR_IA32_LBR_CTL,
+                                       VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_EXIT_CTLS : IA32_VMX_EXIT_CTLS);
+    VmEntryControls = HvAdjustControls(VM_ENTRY_LOAD_IA32_LBR_CTL,
+                                       VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_ENTRY_CTLS : IA32_VMX_ENTRY_CTLS);
+
+    return (VmExitControls & VM_EXIT_CLEAR_IA32_LBR_CTL) && (VmEntryControls & VM_ENTRY_LOAD_IA32_LBR_CTL);
+}
+
+/**
+ * @brief Get the count of the entries of the LBR stack
+ * @details the depth of the architectural LBRs is enumerated by CPUID,
+ * the depth of the legacy (model-specific) LBRs is found by probing
+ * their MSRs, so it should be called before virtualizing the cores
+ *
+ * @param ArchLbr Whether the architectural LBRs are used or not
+ *
+ * @return UINT32
+ */
+UINT32
+CompatibilityCheckGetLbrDepth(BOOLEAN ArchLbr)
+{
+    int    Regs[4];
+    ULONG  Index;
+    UINT32 Depth = 0;
+
+    if (ArchLbr)
+    {
+        //
+        // CPUID.(EAX=1CH,ECX=0):EAX[7:0] is the bitmap of the supported
+        // depths, bit n indicates the depth of 8 * (n + 1)
+        //
+        CommonCpuidInstruction(0x1c, 0, Regs);
+
+        if (!_BitScanReverse(&Index, Regs[0] & 0xff))
+        {
+            return 0;
+        }
+
+        return 8 * (Index + 1);
+    }
+
+    //
+    // The top-of-stack MSR should be readable
+    //
+    __try
+    {
+        __readmsr(LBR_MSR_LASTBRANCH_TOS);
+    }
+    __except (EXCEPTION_EXECUTE_HANDLER)
+    {
+        return 0;
+    }
+
+    for (Depth = 0; Depth < LBR_LEGACY_MAXIMUM_DEPTH; Depth++)
+    {
+        __try
+        {
+            __readmsr(LBR_MSR_LASTBRANCH_FROM_IP(Depth));
+            __readmsr(LBR_MSR_LASTBRANCH_TO_IP(Depth));
+        }
+        __except (EXCEPTION_EXECUTE_HANDLER)
+        {
+            break;
+        }
+    }
+
+    //
+    // The top-of-stack is an index in a power of two entries
+    //
+    if (Depth == 0 || (Depth & (Depth - 1)) != 0)
+    {
+        return 0;
+    }
+
+    return Depth;
+}
+
+/**
+ * @brief Check whether IA32_PERF_GLOBAL_CTRL can be loaded on vm-entries
+ * and vm-exits or not
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CompatibilityCheckPerfGlobalCtrlLoading()
+{
+    IA32_VMX_BASIC_REGISTER VmxBasicMsr = {0};
+    ULONG                   VmExitControls;
+    ULONG                   VmEntryControls;
+
+    VmxBasicMsr.AsUInt = __readmsr(IA32_VMX_BASIC);
+
+    VmExitControls  = HvAdjustControls(VM_EXIT_LOAD_IA32_PERF_GLOBAL_CTRL,
+                                       VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_EXIT_CTLS : IA32_VMX_EXIT_CTLS);
+    VmEntryControls = HvAdjustControls(VM_ENTRY_LOAD_IA32_PERF_GLOBAL_CTRL,
+                                       VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_ENTRY_CTLS : IA32_VMX_ENTRY_CTLS);
+
+    return (VmExitControls & VM_EXIT_LOAD_IA32_PERF_GLOBAL_CTRL) && (VmEntryControls & VM_ENTRY_LOAD_IA32_PERF_GLOBAL_CTRL);
+}
+
+/**
+ * @brief Get the format of the PEBS (Precise Event Based Sampling) records
+ * @details the records should have the data addresses (format 1 and newer,
+ * the newer formats should be adaptive) and the guest's IA32_PERF_GLOBAL_CTRL
+ * should be loaded on vm-entries and vm-exits, so vmx-root is never sampled
+ *
+ * @return UINT32 The format of the records (zero if PEBS is not supported)
+ */
+UINT32
+CompatibilityCheckGetPebsRecordFormat()
+{
+    int    Regs[4];
+    UINT64 PerfCapabilities;
+    UINT32 Format;
+
+    //
+    // CPUID.01H:EDX[21] indicates the DS save area and CPUID.01H:ECX[15]
+    // indicates IA32_PERF_CAPABILITIES
+    //
+    CommonCpuidInstruction(1, 0, Regs);
+
+    if (!(Regs[3] & (1 << 21)) || !(Regs[2] & (1 << 15)))
+    {
+        return 0;
+    }
+
+    //
+    // CPUID.0AH:EAX[7:0] is the version of the architectural performance
+    // monitoring (IA32_PERF_GLOBAL_CTRL is available from the version 2) and
+    // CPUID.0AH:EAX[15:8] is the count of the general-purpose counters
+    //
+    CommonCpuidInstruction(0xa, 0, Regs);
+
+    if ((Regs[0] & 0xff) < 2 || ((Regs[0] >> 8) & 0xff) < 2)
+    {
+        return 0;
+    }
+
+    if (__readmsr(PEBS_MSR_MISC_ENABLE) & PEBS_MISC_ENABLE_PEBS_UNAVAILABLE)
+    {
+        return 0;
+    }
+
+    PerfCapabilities = __readmsr(PEBS_MSR_PERF_CAPABILITIES);
+    Format           = PEBS_PERF_CAPABILITIES_RECORD_FORMAT(PerfCapabilities);
+
+    if (Format == 0 || (Format >= PEBS_RECORD_FORMAT_ADAPTIVE && !(PerfCapabilities & PEBS_PERF_CAPABILITIES_BASELINE)))
+    {
+        return 0;
+    }
+
+    if (!CompatibilityCheckPerfGlobalCtrlLoading())
+    {
+        return 0;
+    }
+
+    return Format;
+}
+
+/**
+ * @brief Get the width of the fixed-function counters (for counting the
+ * retired instructions of the guest)
+ * @details the guest's IA32_PERF_GLOBAL_CTRL should be loaded on vm-entries
+ * and vm-exits, so the instructions of vmx-root are not counted
+ *
+ * @return UINT32 The width of the counters (zero if IA32_FIXED_CTR0 is not supported)
+ */
+UINT32
+CompatibilityCheckGetFixedCounterWidth()
+{
+    int Regs[4];
+
+    //
+    // CPUID.0AH:EDX[4:0] is the count of the fixed-function counters (from
+    // the version 2) and CPUID.0AH:EDX[12:5] is their width
+    //
+    CommonCpuidInstruction(0xa, 0, Regs);
+
+    if ((Regs[0] & 0xff) < 2 || (Regs[3] & 0x1f) < 1)
+    {
+        return 0;
+    }
+
+    if (!CompatibilityCheckPerfGlobalCtrlLoading())
+    {
+        return 0;
+    }
+
+    return (Regs[3] >> 5) & 0xff;
+}
+
+/**
+ * @brief Check for the full-width writes to the performance counters
+ * (IA32_A_PMCx)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CompatibilityCheckPmcFullWidthWrites()
+{
+    return (__readmsr(PEBS_MSR_PERF_CAPABILITIES) & PEBS_PERF_CAPABILITIES_FULL_WIDTH_WRITE) ? TRUE : FALSE;
+}
+
+/**
+ * @brief Get the version of the enlightened VMCS of Hyper-V
+ * @details the enlightened VMCS is used if HyperDbg is nested under Hyper-V
+ * and Hyper-V recommends using it
+ *
+ * @return UINT32 The version of the enlightened VMCS (zero if it's not used)
+ */
+UINT32
+CompatibilityCheckGetEnlightenedVmcsVersion()
+{
+    int Regs[4];
+
+    //
+    // CPUID.01H:ECX[31] indicates the presence of a hypervisor
+    //
+    CommonCpuidInstruction(CPUID_PROCESSOR_AND_PROCESSOR_FEATURE_IDENTIFIERS, 0, Regs);
+
+    if (!(Regs[2] & HYPERV_HYPERVISOR_PRESENT_BIT))
+    {
+        return 0;
+    }
+
+    CommonCpuidInstruction(HYPERV_CPUID_VENDOR_AND_MAX_FUNCTIONS, 0, Regs);
+
+    if ((UINT32)Regs[0] < HYPERV_CPUID_NESTED_FEATURES ||
+        (UINT32)Regs[1] != EVMCS_HYPERV_SIGNATURE_EBX ||
+        (UINT32)Regs[2] != EVMCS_HYPERV_SIGNATURE_ECX ||
+        (UINT32)Regs[3] != EVMCS_HYPERV_SIGNATURE_EDX)
+    {
+        return 0;
+    }
+
+    CommonCpuidInstruction(HYPERV_CPUID_ENLIGHTMENT_INFO, 0, Regs);
+
+    if (!(Regs[0] & HV_X64_ENLIGHTENED_VMCS_RECOMMENDED))
+    {
+        return 0;
+    }
+
+    //
+    // HYPERV_CPUID_NESTED_FEATURES.EAX[7:0] is the lowest and EAX[15:8] is
+    // the highest supported version of the enlightened VMCS
+    //
+    CommonCpuidInstruction(HYPERV_CPUID_NESTED_FEATURES, 0, Regs);
+
+    if ((Regs[0] & HV_X64_ENLIGHTENED_VMCS_VERSION) > EVMCS_VERSION ||
+        ((Regs[0] >> 8) & HV_X64_ENLIGHTENED_VMCS_VERSION) < EVMCS_VERSION)
+    {
+        return 0;
+    }
+
+    return EVMCS_VERSION;
+}
+
+/**
+ * @brief Check for the enlightened MSR bitmap of Hyper-V
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CompatibilityCheckEnlightenedMsrBitmap()
+{
+    int Regs[4];
+
+    CommonCpuidInstruction(HYPERV_CPUID_NESTED_FEATURES, 0, Regs);
+
+    return (Regs[0] & HV_X64_NESTED_MSR_BITMAP) ? TRUE : FALSE;
+}
+
 /**
  * @brief Checks for the compatiblity features based on current processor
  * @detail NOTE: NOT ALL OF THE CHECKS ARE PERFORMED HERE
@@ -154,6 +632,74 @@ CompatibilityCheckPerformChecks()
     //
     g_CompatibilityCheck.PmlSupport = CompatibilityCheckPml();
 
+    //
+    // Check VMX preemption timer support
+    //
+    g_CompatibilityCheck.PreemptionTimerSupport = CompatibilityCheckPreemptionTimer();
+
+    //
+    // Check saving the VMX preemption timer and get the rate of the timer
+    //
+    g_CompatibilityCheck.PreemptionTimerSavingSupport = CompatibilityCheckPreemptionTimerSaving();
+    g_CompatibilityCheck.PreemptionTimerRate          = CompatibilityCheckGetPreemptionTimerRate();
+
+    //
+    // Check Intel Processor Trace support and its filters
+    //
+    g_CompatibilityCheck.IntelPtSupport = CompatibilityCheckIntelPt();
+
+    if (g_CompatibilityCheck.IntelPtSupport)
+    {
+        g_CompatibilityCheck.IntelPtCr3FilteringSupport = CompatibilityCheckIntelPtCr3Filtering();
+        g_CompatibilityCheck.IntelPtAddressRanges       = CompatibilityCheckGetIntelPtAddressRanges();
+    }
+
+    //
+    // Check the architectural (or legacy) LBRs and the depth of their stack
+    //
+    g_CompatibilityCheck.ArchLbrSupport = CompatibilityCheckArchLbr();
+    g_CompatibilityCheck.LbrDepth       = CompatibilityCheckGetLbrDepth(g_CompatibilityCheck.ArchLbrSupport);
+
+    //
+    // Check PEBS and the format of its records
+    //
+    g_CompatibilityCheck.PebsRecordFormat = CompatibilityCheckGetPebsRecordFormat();
+
+    if (g_CompatibilityCheck.PebsRecordFormat != 0)
+    {
+        g_CompatibilityCheck.PmcFullWidthWritesSupport = CompatibilityCheckPmcFullWidthWrites();
+    }
+
+    //
+    // Check the fixed-function counter of the retired instructions
+    //
+    g_CompatibilityCheck.FixedCounterWidth = CompatibilityCheckGetFixedCounterWidth();
+
+#if UseEnlightenedVmcsWhenNestedUnderHyperV == TRUE
+
+    //
+    // Check the enlightened VMCS (nested under Hyper-V), the fields of PML,
+    // VMX preemption timer, IA32_RTIT_CTL, IA32_LBR_CTL and IA32_PERF_GLOBAL_CTRL
+    // are not in the enlightened VMCS, so their features are not available
+    //
+    g_CompatibilityCheck.EnlightenedVmcsVersion = CompatibilityCheckGetEnlightenedVmcsVersion();
+
+    if (g_CompatibilityCheck.EnlightenedVmcsVersion != 0)
+    {
+        g_CompatibilityCheck.EnlightenedMsrBitmapSupport = CompatibilityCheckEnlightenedMsrBitmap();
+
+        g_CompatibilityCheck.PmlSupport                   = FALSE;
+        g_CompatibilityCheck.PreemptionTimerSupport       = FALSE;
+        g_CompatibilityCheck.PreemptionTimerSavingSupport = FALSE;
+        g_CompatibilityCheck.IntelPtSupport               = FALSE;
+        g_CompatibilityCheck.ArchLbrSupport               = FALSE;
+        g_CompatibilityCheck.LbrDepth                     = CompatibilityCheckGetLbrDepth(FALSE);
+        g_CompatibilityCheck.PebsRecordFormat             = 0;
+        g_CompatibilityCheck.FixedCounterWidth            = 0;
+    }
+
+#endif
+
     //
     // Log for testing
     //
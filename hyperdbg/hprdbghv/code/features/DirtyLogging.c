@@ -1,8 +1,10 @@
 /**
  * @file DirtyLogging.c
  * @author Sina Karvandi (sina@hyperdbg.org)
- * @brief Implementation of memory hooks functions
- * @details
+ * @brief Implementation of the dirty logging (PML) mechanism
+ * @details the PML buffer of each core keeps the set of the pages that
+ * are recently written by that core, these sets are merged into a
+ * bitmap of the dirty pages once the buffers are full or flushed
  *
  * @version 0.2
  * @date 2023-02-05
@@ -70,6 +72,7 @@ DirtyLoggingInitialize()
                 if (g_GuestState[j].PmlBufferAddress != NULL)
                 {
                     ExFreePoolWithTag(g_GuestState[j].PmlBufferAddress, POOLTAG);
+                    g_GuestState[j].PmlBufferAddress = NULL;
                 }
             }
 
@@ -119,12 +122,12 @@ DirtyLoggingEnable(VIRTUAL_MACHINE_STATE * VCpu)
 
     // LogInfo("PML Buffer Address = %llx", PmlPhysAddr);
 
-    __vmx_vmwrite(VMCS_CTRL_PML_ADDRESS, PmlPhysAddr);
+    VmxVmwrite(VMCS_CTRL_PML_ADDRESS, PmlPhysAddr);
 
     //
     // Clear the PML index
     //
-    __vmx_vmwrite(VMCS_GUEST_PML_INDEX, PML_ENTITY_NUM - 1);
+    VmxVmwrite(VMCS_GUEST_PML_INDEX, PML_ENTITY_NUM - 1);
 
     //
     // If the "enable PML" VM-execution control is 1 and bit 6 of EPT pointer (EPTP)
@@ -138,6 +141,12 @@ DirtyLoggingEnable(VIRTUAL_MACHINE_STATE * VCpu)
     //
     HvSetPmlEnableFlag(TRUE);
 
+    //
+    // The dirty flags that are cached in the TLB are not logged again,
+    // so the cached translations are invalidated
+    //
+    EptInveptAllContexts();
+
     //
     // Initialization was successful
     //
@@ -158,12 +167,12 @@ DirtyLoggingDisable(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // Clear the address
     //
-    __vmx_vmwrite(VMCS_CTRL_PML_ADDRESS, NULL);
+    VmxVmwrite(VMCS_CTRL_PML_ADDRESS, NULL);
 
     //
     // Clear the PML index
     //
-    __vmx_vmwrite(VMCS_GUEST_PML_INDEX, 0x0);
+    VmxVmwrite(VMCS_GUEST_PML_INDEX, 0x0);
 
     //
     // Disable PML Enable bit
@@ -199,6 +208,7 @@ DirtyLoggingUninitialize()
         if (g_GuestState[i].PmlBufferAddress != NULL)
         {
             ExFreePoolWithTag(g_GuestState[i].PmlBufferAddress, POOLTAG);
+            g_GuestState[i].PmlBufferAddress = NULL;
         }
     }
 }
@@ -222,15 +232,123 @@ DirtyLoggingHandlePageModificationLog(VIRTUAL_MACHINE_STATE * VCpu)
     }
 }
 
+/**
+ * @brief Query the EPT page tables that are used by the cores
+ *
+ * @param EptPageTables The array to save the (non-null) page tables
+ *
+ * @return UINT32 Count of the page tables
+ */
+static UINT32
+DirtyLoggingQueryEptPageTables(PVMM_EPT_PAGE_TABLE EptPageTables[DIRTY_LOGGING_MAXIMUM_EPT_PAGE_TABLES])
+{
+    PVMM_EPT_PAGE_TABLE AllEptPageTables[DIRTY_LOGGING_MAXIMUM_EPT_PAGE_TABLES] = {
+        g_EptState->EptPageTable,
+        g_EptState->ModeBasedEptPageTable,
+        g_EptState->ExecuteOnlyEptPageTable,
+        g_EptState->UnhookedEptPageTable};
+    UINT32 Count = 0;
+
+    for (UINT32 i = 0; i < DIRTY_LOGGING_MAXIMUM_EPT_PAGE_TABLES; i++)
+    {
+        if (AllEptPageTables[i] != NULL)
+        {
+            EptPageTables[Count] = AllEptPageTables[i];
+            Count++;
+        }
+    }
+
+    return Count;
+}
+
+/**
+ * @brief Check whether a physical address is mapped by a 2MB page in
+ * any of the EPT page tables
+ *
+ * @param PhysicalAddress
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+DirtyLoggingIsMappedByLargePage(UINT64 PhysicalAddress)
+{
+    PVMM_EPT_PAGE_TABLE EptPageTables[DIRTY_LOGGING_MAXIMUM_EPT_PAGE_TABLES];
+    UINT32              Count = DirtyLoggingQueryEptPageTables(EptPageTables);
+
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        if (EptPageTables[i]->PML2[ADDRMASK_EPT_PML3_INDEX(PhysicalAddress)][ADDRMASK_EPT_PML2_INDEX(PhysicalAddress)].LargePage)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Mark a page as dirty in a bitmap of the dirty pages
+ * @details the dirty flag of a 2MB page is only set (and logged) once for
+ * all of its 4KB pages, so the entire 2MB page is marked as dirty
+ *
+ * @param Bitmap The bitmap of the dirty pages
+ * @param PhysicalAddress The guest-physical address of the write
+ *
+ * @return VOID
+ */
+static VOID
+DirtyLoggingMarkPageAsDirty(PUINT64 Bitmap, UINT64 PhysicalAddress)
+{
+    UINT64 PageNumber;
+
+    if (PhysicalAddress >= g_DirtyLoggingEndAddress)
+    {
+        return;
+    }
+
+    if (DirtyLoggingIsMappedByLargePage(PhysicalAddress))
+    {
+        //
+        // The end address is aligned to 2MB, so all of the words exist
+        //
+        PageNumber = LARGE_PAGE_ALIGN(PhysicalAddress) / PAGE_SIZE;
+
+        for (UINT64 i = 0; i < (SIZE_2_MB / PAGE_SIZE) / 64; i++)
+        {
+            InterlockedExchange64((volatile LONG64 *)&Bitmap[(PageNumber / 64) + i], (LONG64)MAXUINT64);
+        }
+    }
+    else
+    {
+        PageNumber = PhysicalAddress / PAGE_SIZE;
+
+        InterlockedBitTestAndSet64((volatile LONG64 *)&Bitmap[PageNumber / 64], PageNumber % 64);
+    }
+}
+
+/**
+ * @brief Move the entries of the PML buffer to a bitmap of the dirty pages
+ * @details should be called in vmx-root mode, the dirty flags of the
+ * logged pages are kept, so a page is only logged once in each round
+ *
+ * @param VCpu The virtual processor's state
+ * @param BitmapIndex The index of the target bitmap
+ *
+ * @return BOOLEAN Returns FALSE if the buffer was empty
+ */
 BOOLEAN
-DirtyLoggingFlushPmlBuffer(VIRTUAL_MACHINE_STATE * VCpu)
+DirtyLoggingFlushPmlBuffer(VIRTUAL_MACHINE_STATE * VCpu, UINT32 BitmapIndex)
 {
     UINT64 * PmlBuf;
-    UINT16   PmlIdx;
-    BOOLEAN  IsLargePage;
-    PVOID    PmlEntry;
+    UINT64   PmlIdx = 0;
+    PUINT64  Bitmap = NULL;
 
-    __vmx_vmread(VMCS_GUEST_PML_INDEX, &PmlIdx);
+    if (VCpu->PmlBufferAddress == NULL)
+    {
+        return FALSE;
+    }
+
+    VmxVmread(VMCS_GUEST_PML_INDEX, &PmlIdx);
 
     //
     // Do nothing if PML buffer is empty
@@ -250,71 +368,426 @@ DirtyLoggingFlushPmlBuffer(VIRTUAL_MACHINE_STATE * VCpu)
         PmlIdx++;
     }
 
+    //
+    // The entries are dropped if the dirty pages are not tracked
+    //
+    if (BitmapIndex < DIRTY_LOGGING_BITMAPS_COUNT)
+    {
+        Bitmap = g_DirtyLoggingBitmaps[BitmapIndex];
+    }
+
     PmlBuf = VCpu->PmlBufferAddress;
 
-    for (; PmlIdx < PML_ENTITY_NUM; PmlIdx++)
+    for (; Bitmap != NULL && PmlIdx < PML_ENTITY_NUM; PmlIdx++)
+    {
+        DirtyLoggingMarkPageAsDirty(Bitmap, PmlBuf[PmlIdx]);
+    }
+
+    //
+    // reset PML index
+    //
+    VmxVmwrite(VMCS_GUEST_PML_INDEX, PML_ENTITY_NUM - 1);
+
+    return TRUE;
+}
+
+/**
+ * @brief Handling vm-exits of PML
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+VOID
+DirtyLoggingHandleVmexits(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    //
+    // *** The guest-physical address of the access is written
+    // to the page-modification log and the buffer is full ***
+    //
+
+    //
+    // Flush the PML buffer to the bitmap of the current round
+    //
+    DirtyLoggingFlushPmlBuffer(VCpu, g_DirtyLoggingCurrentBitmap);
+
+    //
+    // Do not increment RIP
+    //
+    HvSuppressRipIncrement(VCpu);
+}
+
+/**
+ * @brief Query the end of the physical memory that is tracked by the
+ * bitmaps of the dirty pages
+ * @details if the physical memory map is not built, the entire identity
+ * map of EPT is tracked
+ *
+ * @return UINT64 The end address (aligned to 2MB)
+ */
+static UINT64
+DirtyLoggingQueryEndAddress()
+{
+    UINT64 EndAddress = 0;
+    UINT64 BaseAddress;
+    UINT64 Size;
+
+    for (UINT32 i = 0; PhysicalMemoryMapGetRange(i, &BaseAddress, &Size); i++)
     {
-        UINT64 AccessedPhysAddr;
+        EndAddress = max(EndAddress, BaseAddress + Size);
+    }
 
-        AccessedPhysAddr = PmlBuf[PmlIdx];
+    if (EndAddress == 0 || EndAddress > (UINT64)VMM_EPT_PML3E_COUNT * VMM_EPT_PML2E_COUNT * SIZE_2_MB)
+    {
+        EndAddress = (UINT64)VMM_EPT_PML3E_COUNT * VMM_EPT_PML2E_COUNT * SIZE_2_MB;
+    }
+
+    return (EndAddress + SIZE_2_MB - 1) & ~(SIZE_2_MB - 1);
+}
+
+/**
+ * @brief Clear the dirty flag of an EPT entry
+ * @details the processor sets the flag atomically, so the flag is
+ * also cleared atomically
+ *
+ * @param EptEntry The PML1 or the (2MB) PML2 entry
+ *
+ * @return VOID
+ */
+static VOID
+DirtyLoggingClearDirtyFlag(PVOID EptEntry)
+{
+    InterlockedAnd64((volatile LONG64 *)EptEntry, ~(LONG64)DIRTY_LOGGING_EPT_ENTRY_DIRTY_FLAG);
+}
+
+/**
+ * @brief Clear the dirty flags of a page in all of the EPT page tables
+ *
+ * @param PhysicalAddress
+ *
+ * @return VOID
+ */
+static VOID
+DirtyLoggingClearDirtyFlagsOfPage(UINT64 PhysicalAddress)
+{
+    PVMM_EPT_PAGE_TABLE EptPageTables[DIRTY_LOGGING_MAXIMUM_EPT_PAGE_TABLES];
+    UINT32              Count = DirtyLoggingQueryEptPageTables(EptPageTables);
+    BOOLEAN             IsLargePage;
+    PVOID               EptEntry;
 
-        PmlEntry = EptGetPml1OrPml2Entry(g_EptState->EptPageTable, AccessedPhysAddr, &IsLargePage);
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        EptEntry = EptGetPml1OrPml2Entry(EptPageTables[i], PhysicalAddress, &IsLargePage);
 
-        if (PmlEntry == NULL)
+        if (EptEntry != NULL)
         {
-            //
-            // Page PML entry is not valid
-            //
-            LogInfo("Err, null page");
-            continue;
+            DirtyLoggingClearDirtyFlag(EptEntry);
         }
+    }
+}
+
+/**
+ * @brief Clear the dirty flags of all of the tracked pages in all of
+ * the EPT page tables
+ *
+ * @return VOID
+ */
+static VOID
+DirtyLoggingClearAllDirtyFlags()
+{
+    PVMM_EPT_PAGE_TABLE EptPageTables[DIRTY_LOGGING_MAXIMUM_EPT_PAGE_TABLES];
+    UINT32              Count = DirtyLoggingQueryEptPageTables(EptPageTables);
+    PEPT_PML2_ENTRY     PML2;
+    PEPT_PML1_ENTRY     PML1;
 
-        if (IsLargePage)
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        //
+        // The dirty flags are tracked on the 2MB and 4KB entries
+        //
+        EptSplitAllPml3LargePages(EptPageTables[i]);
+
+        for (UINT64 j = 0; j < g_DirtyLoggingEndAddress / SIZE_2_MB; j++)
         {
-            ((PEPT_PML2_ENTRY)PmlEntry)->Dirty = FALSE;
+            PML2 = &EptPageTables[i]->PML2[j / VMM_EPT_PML2E_COUNT][j % VMM_EPT_PML2E_COUNT];
+
+            if (PML2->LargePage)
+            {
+                DirtyLoggingClearDirtyFlag(PML2);
+                continue;
+            }
+
+            PML1 = (PEPT_PML1_ENTRY)PhysicalAddressToVirtualAddress((PVOID)(((PEPT_PML2_POINTER)PML2)->PageFrameNumber * PAGE_SIZE));
+
+            if (PML1 == NULL)
+            {
+                continue;
+            }
+
+            for (UINT32 k = 0; k < VMM_EPT_PML1E_COUNT; k++)
+            {
+                DirtyLoggingClearDirtyFlag(&PML1[k]);
+            }
         }
-        else
+    }
+}
+
+/**
+ * @brief Free the bitmaps of the dirty pages
+ * @details PML should be disabled on all cores before freeing the bitmaps
+ *
+ * @return VOID
+ */
+VOID
+DirtyLoggingFreeBitmaps()
+{
+    g_DirtyLoggingEnabled = FALSE;
+
+    for (UINT32 i = 0; i < DIRTY_LOGGING_BITMAPS_COUNT; i++)
+    {
+        if (g_DirtyLoggingBitmaps[i] != NULL)
         {
-            ((PEPT_PML1_ENTRY)PmlEntry)->Dirty = FALSE;
+            ExFreePoolWithTag(g_DirtyLoggingBitmaps[i], POOLTAG);
+            g_DirtyLoggingBitmaps[i] = NULL;
         }
     }
 
+    g_DirtyLoggingEndAddress = 0;
+}
+
+/**
+ * @brief Start tracking the dirty pages on all cores
+ *
+ * @param DirtyPagesRequest
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+DirtyLoggingStart(PDEBUGGER_DIRTY_PAGES_REQUEST DirtyPagesRequest)
+{
+    UINT64 EndAddress;
+    SIZE_T BitmapSize;
+
+    if (g_DirtyLoggingEnabled)
+    {
+        return TRUE;
+    }
+
+    if (!g_CompatibilityCheck.PmlSupport)
+    {
+        DirtyPagesRequest->KernelStatus = DEBUGGER_ERROR_PML_IS_NOT_SUPPORTED;
+        return FALSE;
+    }
+
+    EndAddress = DirtyLoggingQueryEndAddress();
+    BitmapSize = (SIZE_T)(EndAddress / PAGE_SIZE / 8);
+
+    for (UINT32 i = 0; i < DIRTY_LOGGING_BITMAPS_COUNT; i++)
+    {
+        g_DirtyLoggingBitmaps[i] = ExAllocatePoolWithTag(NonPagedPool, BitmapSize, POOLTAG);
+
+        if (g_DirtyLoggingBitmaps[i] == NULL)
+        {
+            DirtyLoggingFreeBitmaps();
+
+            DirtyPagesRequest->KernelStatus = DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_DIRTY_PAGES_BITMAP;
+            return FALSE;
+        }
+
+        RtlZeroMemory(g_DirtyLoggingBitmaps[i], BitmapSize);
+    }
+
+    g_DirtyLoggingEndAddress    = EndAddress;
+    g_DirtyLoggingCurrentBitmap = 0;
+
     //
-    // reset PML index
+    // The pages that are already dirty are not logged, so all of the
+    // dirty flags are cleared before enabling PML (the cached flags are
+    // invalidated once PML is enabled on each core)
     //
-    __vmx_vmwrite(VMCS_GUEST_PML_INDEX, PML_ENTITY_NUM - 1);
+    DirtyLoggingClearAllDirtyFlags();
+
+    if (!DirtyLoggingInitialize())
+    {
+        DirtyLoggingFreeBitmaps();
+
+        DirtyPagesRequest->KernelStatus = DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_DIRTY_PAGES_BITMAP;
+        return FALSE;
+    }
+
+    g_DirtyLoggingEnabled = TRUE;
 
     return TRUE;
 }
 
 /**
- * @brief Handling vm-exits of PML
+ * @brief Stop tracking the dirty pages on all cores
  *
- * @param VCpu The virtual processor's state
+ * @return VOID
+ */
+static VOID
+DirtyLoggingStop()
+{
+    if (!g_DirtyLoggingEnabled)
+    {
+        return;
+    }
+
+    //
+    // None of the cores use the bitmaps once PML is disabled
+    //
+    DirtyLoggingUninitialize();
+
+    DirtyLoggingFreeBitmaps();
+}
+
+/**
+ * @brief Start a new round of tracking the dirty pages
+ * @details once the current bitmap is switched, the cores flush their
+ * PML buffers (the pages that are logged before the switch) into the
+ * bitmap of the previous round, then the dirty flags of the pages of the
+ * previous round are cleared and the cached translations are invalidated,
+ * so the writes after this point are logged in the new round
  *
  * @return VOID
  */
-VOID
-DirtyLoggingHandleVmexits(VIRTUAL_MACHINE_STATE * VCpu)
+static VOID
+DirtyLoggingStartNewRound()
 {
+    LONG    PreviousBitmap = g_DirtyLoggingCurrentBitmap;
+    LONG    CurrentBitmap  = (PreviousBitmap + 1) % DIRTY_LOGGING_BITMAPS_COUNT;
+    PUINT64 Bitmap         = g_DirtyLoggingBitmaps[PreviousBitmap];
+    UINT64  CountOfWords   = g_DirtyLoggingEndAddress / PAGE_SIZE / 64;
+    UINT64  Value;
+    ULONG   Index;
+
     //
-    // *** The guest-physical address of the access is written
-    // to the page-modification log and the buffer is full ***
+    // The bitmap of the round before the previous round is reused
     //
+    RtlZeroMemory(g_DirtyLoggingBitmaps[CurrentBitmap], CountOfWords * sizeof(UINT64));
+
+    InterlockedExchange(&g_DirtyLoggingCurrentBitmap, CurrentBitmap);
 
     //
-    // Test log
+    // Broadcast to all cores, after this point none of the cores write
+    // to the bitmap of the previous round
     //
-    LogInfo("Dirty Logging VM-exit");
-    // DirtyLoggingHandlePageModificationLog(VCpu);
+    BroadcastFlushPmlBuffersOnAllProcessors(PreviousBitmap);
+
+    for (UINT64 i = 0; i < CountOfWords; i++)
+    {
+        Value = Bitmap[i];
+
+        while (_BitScanForward64(&Index, Value))
+        {
+            Value &= ~(1ull << Index);
+
+            DirtyLoggingClearDirtyFlagsOfPage(((i * 64) + Index) * PAGE_SIZE);
+        }
+    }
 
     //
-    // Flush the PML buffer
+    // Broadcast to all cores to invalidate the cached dirty flags
     //
-    DirtyLoggingFlushPmlBuffer(VCpu);
+    KeGenericCallDpc(DpcRoutineInvalidateEptOnAllCores, NULL);
+}
+
+/**
+ * @brief Copy a chunk of the bitmap of the previous round to the request
+ *
+ * @param DirtyPagesRequest
+ * @param Clear Whether to start a new round before copying the bitmap
+ *
+ * @return VOID
+ */
+static VOID
+DirtyLoggingQuery(PDEBUGGER_DIRTY_PAGES_REQUEST DirtyPagesRequest, BOOLEAN Clear)
+{
+    UINT64 CountOfWords;
+    UINT64 FirstWord;
+    UINT64 CountToCopy;
+
+    if (!g_DirtyLoggingEnabled)
+    {
+        DirtyPagesRequest->KernelStatus = DEBUGGER_ERROR_DIRTY_PAGES_TRACKING_IS_NOT_ENABLED;
+        return;
+    }
+
+    if (Clear)
+    {
+        DirtyLoggingStartNewRound();
+    }
+
+    CountOfWords = g_DirtyLoggingEndAddress / PAGE_SIZE / 64;
+    FirstWord    = DirtyPagesRequest->StartAddress / PAGE_SIZE / 64;
 
     //
-    // Do not increment RIP
+    // Each word of the bitmap represents 64 pages
     //
-    HvSuppressRipIncrement(VCpu);
+    DirtyPagesRequest->StartAddress = FirstWord * 64 * PAGE_SIZE;
+
+    RtlZeroMemory(DirtyPagesRequest->Bitmap, sizeof(DirtyPagesRequest->Bitmap));
+
+    if (FirstWord < CountOfWords)
+    {
+        CountToCopy = min(CountOfWords - FirstWord, DirtyPagesBitmapWordsToQuery);
+
+        RtlCopyMemory(DirtyPagesRequest->Bitmap,
+                      &g_DirtyLoggingBitmaps[(g_DirtyLoggingCurrentBitmap + 1) % DIRTY_LOGGING_BITMAPS_COUNT][FirstWord],
+                      CountToCopy * sizeof(UINT64));
+    }
+}
+
+/**
+ * @brief Enable, disable or query (and clear) the dirty pages
+ * @details should be called from vmx non-root (PASSIVE_LEVEL)
+ *
+ * @param DirtyPagesRequest
+ *
+ * @return VOID
+ */
+VOID
+DirtyLoggingPerformAction(PDEBUGGER_DIRTY_PAGES_REQUEST DirtyPagesRequest)
+{
+    DirtyPagesRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    SpinlockLock(&g_DirtyLoggingLock);
+
+    switch (DirtyPagesRequest->Action)
+    {
+    case DEBUGGER_DIRTY_PAGES_ACTION_ENABLE:
+
+        DirtyLoggingStart(DirtyPagesRequest);
+
+        break;
+
+    case DEBUGGER_DIRTY_PAGES_ACTION_DISABLE:
+
+        DirtyLoggingStop();
+
+        break;
+
+    case DEBUGGER_DIRTY_PAGES_ACTION_QUERY:
+
+        DirtyLoggingQuery(DirtyPagesRequest, FALSE);
+
+        break;
+
+    case DEBUGGER_DIRTY_PAGES_ACTION_QUERY_AND_CLEAR:
+
+        DirtyLoggingQuery(DirtyPagesRequest, TRUE);
+
+        break;
+
+    default:
+
+        DirtyPagesRequest->KernelStatus = DEBUGGER_ERROR_INVALID_ACTION_TYPE;
+
+        break;
+    }
+
+    DirtyPagesRequest->EndAddress = g_DirtyLoggingEndAddress;
+    DirtyPagesRequest->IsEnabled  = g_DirtyLoggingEnabled;
+
+    SpinlockUnlock(&g_DirtyLoggingLock);
 }
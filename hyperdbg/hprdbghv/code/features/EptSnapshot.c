@@ -0,0 +1,468 @@
+/**
+ * @file EptSnapshot.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Implementation of the snapshots of the guest memory
+ * @details the write access of the RAM pages is removed from the EPT page
+ * table once the snapshot is taken, so the first write to each page causes
+ * an EPT violation that copies the page before the write (copy-on-write),
+ * restoring the snapshot writes the copies back and protects the pages again,
+ * thus, the cost of restoring only depends on the count of the written pages
+ *
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Remove (or give back) the write access of an EPT entry
+ * @details only the entries that are writable are protected, and only
+ * the entries that are protected by the snapshot are unprotected
+ *
+ * @param EptEntry The PML1 or the (2MB) PML2 entry
+ * @param Protect
+ *
+ * @return VOID
+ */
+static VOID
+EptSnapshotSetEntryProtection(PVOID EptEntry, BOOLEAN Protect)
+{
+    volatile LONG64 * Entry = (volatile LONG64 *)EptEntry;
+
+    if (Protect && (*Entry & EPT_SNAPSHOT_EPT_ENTRY_WRITE_ACCESS))
+    {
+        InterlockedOr64(Entry, EPT_SNAPSHOT_EPT_ENTRY_PROTECTED_FLAG);
+        InterlockedAnd64(Entry, ~(LONG64)EPT_SNAPSHOT_EPT_ENTRY_WRITE_ACCESS);
+    }
+    else if (!Protect && (*Entry & EPT_SNAPSHOT_EPT_ENTRY_PROTECTED_FLAG))
+    {
+        InterlockedOr64(Entry, EPT_SNAPSHOT_EPT_ENTRY_WRITE_ACCESS);
+        InterlockedAnd64(Entry, ~(LONG64)EPT_SNAPSHOT_EPT_ENTRY_PROTECTED_FLAG);
+    }
+}
+
+/**
+ * @brief Remove (or give back) the write access of all of the RAM pages
+ * in the EPT page table
+ * @details the 2MB ranges without RAM are skipped, the new PML1 entries of
+ * the pages that are split after taking the snapshot inherit the protection
+ * of their large page (even if they're not RAM), so they're unprotected too
+ *
+ * @param Protect
+ *
+ * @return VOID
+ */
+static VOID
+EptSnapshotSetProtectionOfAllPages(BOOLEAN Protect)
+{
+    PEPT_PML2_ENTRY PML2;
+    PEPT_PML1_ENTRY PML1;
+    UINT64          RangeStart;
+    UINT64          RangeEnd;
+
+    //
+    // The protection is applied to the 2MB and 4KB entries
+    //
+    EptSplitAllPml3LargePages(g_EptState->EptPageTable);
+
+    for (UINT64 i = 0; i < (UINT64)VMM_EPT_PML3E_COUNT * VMM_EPT_PML2E_COUNT; i++)
+    {
+        RangeStart = i * SIZE_2_MB;
+        RangeEnd   = RangeStart + SIZE_2_MB;
+
+        if (!PhysicalMemoryMapGetNextRange(&RangeStart, &RangeEnd))
+        {
+            continue;
+        }
+
+        PML2 = &g_EptState->EptPageTable->PML2[i / VMM_EPT_PML2E_COUNT][i % VMM_EPT_PML2E_COUNT];
+
+        if (PML2->LargePage)
+        {
+            EptSnapshotSetEntryProtection(PML2, Protect);
+            continue;
+        }
+
+        PML1 = (PEPT_PML1_ENTRY)PhysicalAddressToVirtualAddress((PVOID)(((PEPT_PML2_POINTER)PML2)->PageFrameNumber * PAGE_SIZE));
+
+        if (PML1 == NULL)
+        {
+            continue;
+        }
+
+        for (UINT32 j = 0; j < VMM_EPT_PML1E_COUNT; j++)
+        {
+            if (Protect && !PhysicalMemoryMapIsRam(i * SIZE_2_MB + j * PAGE_SIZE))
+            {
+                continue;
+            }
+
+            EptSnapshotSetEntryProtection(&PML1[j], Protect);
+        }
+    }
+}
+
+/**
+ * @brief Get a copy of a page, either a reused copy or a pre-allocated one
+ * @details should be called from vmx-root
+ *
+ * @return PEPT_SNAPSHOT_PAGE_COPY The copy or NULL if no copy is available
+ */
+static PEPT_SNAPSHOT_PAGE_COPY
+EptSnapshotRequestPageCopy()
+{
+    if (!IsListEmpty(&g_EptSnapshot.FreeCopiesList))
+    {
+        return CONTAINING_RECORD(RemoveHeadList(&g_EptSnapshot.FreeCopiesList), EPT_SNAPSHOT_PAGE_COPY, PageCopiesList);
+    }
+
+    return (PEPT_SNAPSHOT_PAGE_COPY)PoolManagerRequestPool(EPT_SNAPSHOT_PAGE_COPY, TRUE, sizeof(EPT_SNAPSHOT_PAGE_COPY));
+}
+
+/**
+ * @brief Handle the EPT violations of the pages that are protected by
+ * the snapshot
+ * @details the page is copied before the first write, then the write access
+ * is given back and the instruction is executed again, if the page or the
+ * split of its large page couldn't be allocated then the written page is
+ * not restorable (the snapshot is overflowed)
+ *
+ * @param VCpu The virtual processor's state
+ * @param ViolationQualification
+ * @param GuestPhysicalAddr
+ *
+ * @return BOOLEAN Returns TRUE if the violation is caused by the snapshot
+ */
+_Use_decl_annotations_
+BOOLEAN
+EptSnapshotHandleEptViolation(VIRTUAL_MACHINE_STATE *                VCpu,
+                              VMX_EXIT_QUALIFICATION_EPT_VIOLATION * ViolationQualification,
+                              UINT64                                 GuestPhysicalAddr)
+{
+    PVOID                   EptEntry;
+    BOOLEAN                 IsLargePage;
+    PVOID                   SplitBuffer;
+    PEPT_SNAPSHOT_PAGE_COPY PageCopy;
+    UINT64                  PageAddress = GuestPhysicalAddr & ~(PAGE_SIZE - 1);
+
+    if (!g_EptSnapshot.IsTaken || !ViolationQualification->WriteAccess)
+    {
+        return FALSE;
+    }
+
+    SpinlockLock(&g_EptSnapshot.Lock);
+
+    EptEntry = EptGetPml1OrPml2Entry(g_EptState->EptPageTable, GuestPhysicalAddr, &IsLargePage);
+
+    if (EptEntry == NULL)
+    {
+        SpinlockUnlock(&g_EptSnapshot.Lock);
+        return FALSE;
+    }
+
+    if (*(UINT64 *)EptEntry & EPT_SNAPSHOT_EPT_ENTRY_WRITE_ACCESS)
+    {
+        //
+        // The page is already copied by another core, this core has a
+        // stale entry in its cache
+        //
+        SpinlockUnlock(&g_EptSnapshot.Lock);
+        goto InvalidateAndRetry;
+    }
+
+    if (!(*(UINT64 *)EptEntry & EPT_SNAPSHOT_EPT_ENTRY_PROTECTED_FLAG))
+    {
+        //
+        // The page is not protected by the snapshot
+        //
+        SpinlockUnlock(&g_EptSnapshot.Lock);
+        return FALSE;
+    }
+
+    if (IsLargePage)
+    {
+        //
+        // Only the written 4KB page is copied, the new entries inherit the
+        // protection of the large page
+        //
+        SplitBuffer = PoolManagerRequestPool(SPLIT_2MB_PAGING_TO_4KB_PAGE, TRUE, sizeof(VMM_EPT_DYNAMIC_SPLIT));
+
+        if (SplitBuffer == NULL || !EptSplitLargePage(g_EptState->EptPageTable, SplitBuffer, GuestPhysicalAddr))
+        {
+            g_EptSnapshot.IsOverflowed = TRUE;
+
+            EptSnapshotSetEntryProtection(EptEntry, FALSE);
+
+            SpinlockUnlock(&g_EptSnapshot.Lock);
+            goto InvalidateAndRetry;
+        }
+
+        EptEntry = EptGetPml1Entry(g_EptState->EptPageTable, GuestPhysicalAddr);
+    }
+
+    if (PhysicalMemoryMapIsRam(PageAddress))
+    {
+        PageCopy = EptSnapshotRequestPageCopy();
+
+        if (PageCopy == NULL)
+        {
+            g_EptSnapshot.IsOverflowed = TRUE;
+        }
+        else
+        {
+            PageCopy->PhysicalAddress = PageAddress;
+            PageCopy->EntryAddress    = (PEPT_PML1_ENTRY)EptEntry;
+
+            MemoryMapperReadMemorySafeByPhysicalAddress(PageAddress, (UINT64)PageCopy->Content, PAGE_SIZE);
+
+            InsertHeadList(&g_EptSnapshot.CopiedPagesList, &PageCopy->PageCopiesList);
+            g_EptSnapshot.CountOfCopiedPages++;
+        }
+    }
+
+    EptSnapshotSetEntryProtection(EptEntry, FALSE);
+
+    SpinlockUnlock(&g_EptSnapshot.Lock);
+
+InvalidateAndRetry:
+
+    //
+    // The other cores invalidate their caches once they hit the stale
+    // entry, then the instruction is executed again
+    //
+    EptInveptSingleContext(g_EptState->EptPointer.AsUInt);
+
+    HvSuppressRipIncrement(VCpu);
+
+    return TRUE;
+}
+
+/**
+ * @brief Take the snapshot of the memory and the registers of the current core
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return UINT32 The status of taking the snapshot
+ */
+static UINT32
+EptSnapshotTake(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    if (g_EptSnapshot.IsTaken)
+    {
+        return DEBUGGER_ERROR_EPT_SNAPSHOT_IS_ALREADY_TAKEN;
+    }
+
+    //
+    // The hooks and the reversing machine change the entries (and the
+    // EPT page tables) that are protected by the snapshot
+    //
+    if (!IsListEmpty(&g_EptState->HookedPagesList) || g_ReversingMachineInitialized)
+    {
+        return DEBUGGER_ERROR_EPT_SNAPSHOT_CONFLICTS_WITH_EPT_HOOKS;
+    }
+
+    SpinlockLock(&g_EptSnapshot.Lock);
+
+    InitializeListHead(&g_EptSnapshot.CopiedPagesList);
+    InitializeListHead(&g_EptSnapshot.FreeCopiesList);
+
+    g_EptSnapshot.CoreId             = VCpu->CoreId;
+    g_EptSnapshot.Regs               = *VCpu->Regs;
+    g_EptSnapshot.Rip                = GetGuestRIP();
+    g_EptSnapshot.Rflags             = GetGuestRFlags();
+    g_EptSnapshot.CountOfCopiedPages = 0;
+    g_EptSnapshot.CountOfRestores    = 0;
+    g_EptSnapshot.IsOverflowed       = FALSE;
+
+    //
+    // The RSP might be changed by the debugger while the core is halted
+    //
+    VmxVmread(VMCS_GUEST_RSP, &g_EptSnapshot.Regs.rsp);
+
+    EptSnapshotSetProtectionOfAllPages(TRUE);
+
+    g_EptSnapshot.IsTaken = TRUE;
+
+    SpinlockUnlock(&g_EptSnapshot.Lock);
+
+    return DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+}
+
+/**
+ * @brief Restore the memory and the registers of the snapshot
+ * @details the copies are kept to be reused for the next round
+ *
+ * @param VCpu The virtual processor's state
+ * @param CountOfRestoredPages
+ *
+ * @return UINT32 The status of restoring the snapshot
+ */
+static UINT32
+EptSnapshotRestore(VIRTUAL_MACHINE_STATE * VCpu, UINT64 * CountOfRestoredPages)
+{
+    PEPT_SNAPSHOT_PAGE_COPY PageCopy;
+
+    if (!g_EptSnapshot.IsTaken)
+    {
+        return DEBUGGER_ERROR_EPT_SNAPSHOT_IS_NOT_TAKEN;
+    }
+
+    if (VCpu->CoreId != g_EptSnapshot.CoreId)
+    {
+        return DEBUGGER_ERROR_EPT_SNAPSHOT_IS_TAKEN_ON_ANOTHER_CORE;
+    }
+
+    if (g_EptSnapshot.IsOverflowed)
+    {
+        return DEBUGGER_ERROR_EPT_SNAPSHOT_PAGES_ARE_EXHAUSTED;
+    }
+
+    SpinlockLock(&g_EptSnapshot.Lock);
+
+    while (!IsListEmpty(&g_EptSnapshot.CopiedPagesList))
+    {
+        PageCopy = CONTAINING_RECORD(RemoveHeadList(&g_EptSnapshot.CopiedPagesList), EPT_SNAPSHOT_PAGE_COPY, PageCopiesList);
+
+        MemoryMapperWriteMemorySafeByPhysicalAddress(PageCopy->PhysicalAddress, (UINT64)PageCopy->Content, PAGE_SIZE);
+
+        EptSnapshotSetEntryProtection(PageCopy->EntryAddress, TRUE);
+
+        InsertHeadList(&g_EptSnapshot.FreeCopiesList, &PageCopy->PageCopiesList);
+        (*CountOfRestoredPages)++;
+    }
+
+    g_EptSnapshot.CountOfCopiedPages = 0;
+    g_EptSnapshot.CountOfRestores++;
+
+    //
+    // Restore the registers, the instruction of the snapshot is executed again
+    //
+    *VCpu->Regs = g_EptSnapshot.Regs;
+
+    SetGuestRSP(g_EptSnapshot.Regs.rsp);
+    SetGuestRIP(g_EptSnapshot.Rip);
+    SetGuestRFlags(g_EptSnapshot.Rflags);
+
+    HvSuppressRipIncrement(VCpu);
+
+    SpinlockUnlock(&g_EptSnapshot.Lock);
+
+    return DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+}
+
+/**
+ * @brief Discard the snapshot and give back the write access of the pages
+ *
+ * @return UINT32 The status of discarding the snapshot
+ */
+static UINT32
+EptSnapshotDiscard()
+{
+    PEPT_SNAPSHOT_PAGE_COPY PageCopy;
+
+    if (!g_EptSnapshot.IsTaken)
+    {
+        return DEBUGGER_ERROR_EPT_SNAPSHOT_IS_NOT_TAKEN;
+    }
+
+    SpinlockLock(&g_EptSnapshot.Lock);
+
+    while (!IsListEmpty(&g_EptSnapshot.CopiedPagesList))
+    {
+        PageCopy = CONTAINING_RECORD(RemoveHeadList(&g_EptSnapshot.CopiedPagesList), EPT_SNAPSHOT_PAGE_COPY, PageCopiesList);
+        PoolManagerFreePool((UINT64)PageCopy);
+    }
+
+    while (!IsListEmpty(&g_EptSnapshot.FreeCopiesList))
+    {
+        PageCopy = CONTAINING_RECORD(RemoveHeadList(&g_EptSnapshot.FreeCopiesList), EPT_SNAPSHOT_PAGE_COPY, PageCopiesList);
+        PoolManagerFreePool((UINT64)PageCopy);
+    }
+
+    EptSnapshotSetProtectionOfAllPages(FALSE);
+
+    g_EptSnapshot.IsTaken            = FALSE;
+    g_EptSnapshot.IsOverflowed       = FALSE;
+    g_EptSnapshot.CountOfCopiedPages = 0;
+
+    SpinlockUnlock(&g_EptSnapshot.Lock);
+
+    return DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+}
+
+/**
+ * @brief Request the copies of the pages (and the splits of the large
+ * pages) that are written after taking the snapshot
+ * @details should be called from vmx non-root, the pools are allocated
+ * once the pool manager is invoked at PASSIVE_LEVEL
+ *
+ * @param Count Count of the pages
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+EptSnapshotAllocatePageCopies(UINT32 Count)
+{
+    PoolManagerRequestAllocation(sizeof(EPT_SNAPSHOT_PAGE_COPY), Count, EPT_SNAPSHOT_PAGE_COPY);
+    PoolManagerRequestAllocation(sizeof(VMM_EPT_DYNAMIC_SPLIT), Count, SPLIT_2MB_PAGING_TO_4KB_PAGE);
+}
+
+/**
+ * @brief Perform the actions of the snapshot
+ * @details should be called from vmx-root while the other cores are
+ * halted, the caches of EPT on the other cores should be invalidated
+ * before continuing them
+ *
+ * @param SnapshotRequest
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+EptSnapshotPerformAction(PDEBUGGER_EPT_SNAPSHOT_REQUEST SnapshotRequest)
+{
+    VIRTUAL_MACHINE_STATE * VCpu = &g_GuestState[KeGetCurrentProcessorNumber()];
+
+    SnapshotRequest->CountOfRestoredPages = 0;
+
+    switch (SnapshotRequest->Action)
+    {
+    case DEBUGGER_EPT_SNAPSHOT_ACTION_TAKE:
+
+        SnapshotRequest->KernelStatus = EptSnapshotTake(VCpu);
+        break;
+
+    case DEBUGGER_EPT_SNAPSHOT_ACTION_RESTORE:
+
+        SnapshotRequest->KernelStatus = EptSnapshotRestore(VCpu, &SnapshotRequest->CountOfRestoredPages);
+        break;
+
+    case DEBUGGER_EPT_SNAPSHOT_ACTION_DISCARD:
+
+        SnapshotRequest->KernelStatus = EptSnapshotDiscard();
+        break;
+
+    case DEBUGGER_EPT_SNAPSHOT_ACTION_QUERY:
+
+        SnapshotRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+        break;
+
+    default:
+
+        SnapshotRequest->KernelStatus = DEBUGGER_ERROR_INVALID_ACTION_TYPE;
+        break;
+    }
+
+    if (SnapshotRequest->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL && SnapshotRequest->Action != DEBUGGER_EPT_SNAPSHOT_ACTION_QUERY)
+    {
+        EptInveptSingleContext(g_EptState->EptPointer.AsUInt);
+    }
+
+    SnapshotRequest->IsTaken            = g_EptSnapshot.IsTaken;
+    SnapshotRequest->CoreId             = g_EptSnapshot.CoreId;
+    SnapshotRequest->CountOfCopiedPages = g_EptSnapshot.CountOfCopiedPages;
+    SnapshotRequest->CountOfRestores    = g_EptSnapshot.CountOfRestores;
+}
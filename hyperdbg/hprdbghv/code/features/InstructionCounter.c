@@ -0,0 +1,358 @@
+/**
+ * @file InstructionCounter.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Counting the retired instructions of the guest
+ * @details IA32_FIXED_CTR0 (INST_RETIRED.ANY) is started from the negative
+ * of the requested count and overflows once the instructions are retired,
+ * the overflow is delivered as an NMI (LVT performance counter entry of the
+ * local APIC) which causes a vm-exit, the guest's IA32_PERF_GLOBAL_CTRL is
+ * loaded on vm-entries and cleared on vm-exits, so only vmx non-root is
+ * counted, the instructions that cause vm-exits are emulated (they're not
+ * retired in the guest) and are counted here
+ * @version 0.4
+ * @date 2023-08-13
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Get the mask of the width of the counter
+ *
+ * @return UINT64
+ */
+static UINT64
+InstructionCounterGetMask()
+{
+    if (g_CompatibilityCheck.FixedCounterWidth >= 64)
+    {
+        return MAXUINT64;
+    }
+
+    return (1ull << g_CompatibilityCheck.FixedCounterWidth) - 1;
+}
+
+/**
+ * @brief Intercept (or stop intercepting) the accesses of the guest to
+ * the MSRs of the counter
+ * @details should be called from vmx-root
+ *
+ * @param VCpu The virtual processor's state
+ * @param Intercept
+ *
+ * @return VOID
+ */
+static VOID
+InstructionCounterInterceptMsrs(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Intercept)
+{
+    const UINT32 Msrs[] = {
+        INSTRUCTION_COUNTER_MSR_FIXED_CTR0,
+        INSTRUCTION_COUNTER_MSR_FIXED_CTR_CTRL,
+        PEBS_MSR_PERF_GLOBAL_CTRL,
+        PEBS_MSR_PERF_GLOBAL_OVF_CTRL,
+    };
+
+    for (UINT32 i = 0; i < RTL_NUMBER_OF(Msrs); i++)
+    {
+        if (Intercept)
+        {
+            MsrHandlePerformMsrBitmapReadChange(VCpu, Msrs[i]);
+            MsrHandlePerformMsrBitmapWriteChange(VCpu, Msrs[i]);
+        }
+        else
+        {
+            MsrHandlePerformMsrBitmapReadUnset(VCpu, Msrs[i]);
+            MsrHandlePerformMsrBitmapWriteUnset(VCpu, Msrs[i]);
+        }
+    }
+}
+
+/**
+ * @brief Start counting the retired instructions of the guest on the
+ * current core
+ * @details should be called from vmx-root, the guest's performance
+ * counters are frozen until the counter is disarmed
+ *
+ * @param VCpu The virtual processor's state
+ * @param Count Count of the instructions that the counter overflows after them
+ *
+ * @return BOOLEAN Whether the counter is armed or not
+ */
+BOOLEAN
+InstructionCounterArm(VIRTUAL_MACHINE_STATE * VCpu, UINT64 Count)
+{
+    PINSTRUCTION_COUNTER_STATE State = &VCpu->InstructionCounter;
+    UINT64                     Mask  = InstructionCounterGetMask();
+
+    if (g_CompatibilityCheck.FixedCounterWidth == 0 || State->IsArmed || Count == 0 || Count > Mask)
+    {
+        return FALSE;
+    }
+
+    //
+    // The performance counters are already used by the PEBS sampling
+    //
+    if (g_PebsSamplingBuffers != NULL && g_PebsSamplingBuffers[VCpu->CoreId].IsEnabled)
+    {
+        return FALSE;
+    }
+
+    //
+    // The 'load IA32_PERF_GLOBAL_CTRL' controls are not set yet, so the
+    // MSRs still hold the guest's values
+    //
+    State->GuestPerfGlobalCtrl        = __readmsr(PEBS_MSR_PERF_GLOBAL_CTRL);
+    State->GuestFixedCtrCtrl          = __readmsr(INSTRUCTION_COUNTER_MSR_FIXED_CTR_CTRL);
+    State->GuestFixedCtr0             = __readmsr(INSTRUCTION_COUNTER_MSR_FIXED_CTR0);
+    State->GuestLvtPerformanceCounter = ApicReadLvtPerformanceCounter();
+
+    //
+    // Stop the counters before changing them
+    //
+    __writemsr(PEBS_MSR_PERF_GLOBAL_CTRL, 0);
+    __writemsr(PEBS_MSR_PERF_GLOBAL_OVF_CTRL, INSTRUCTION_COUNTER_GLOBAL_FIXED_CTR0);
+
+    State->ArmedCount = Count;
+    State->StartValue = (0 - Count) & Mask;
+
+    __writemsr(INSTRUCTION_COUNTER_MSR_FIXED_CTR0, State->StartValue);
+    __writemsr(INSTRUCTION_COUNTER_MSR_FIXED_CTR_CTRL,
+               (State->GuestFixedCtrCtrl & ~INSTRUCTION_COUNTER_FIXED_CTR_CTRL_MASK) |
+                   INSTRUCTION_COUNTER_FIXED_CTR_CTRL_OS | INSTRUCTION_COUNTER_FIXED_CTR_CTRL_USR | INSTRUCTION_COUNTER_FIXED_CTR_CTRL_PMI);
+
+    //
+    // The overflow is delivered as an NMI
+    //
+    ApicWriteLvtPerformanceCounter(APIC_DM_NMI);
+
+    //
+    // Only the counter of the retired instructions counts in vmx non-root,
+    // so no other overflow is delivered as an NMI
+    //
+    VmxVmwrite(VMCS_GUEST_PERF_GLOBAL_CTRL, INSTRUCTION_COUNTER_GLOBAL_FIXED_CTR0);
+    VmxVmwrite(VMCS_HOST_PERF_GLOBAL_CTRL, 0);
+
+    HvSetPerfGlobalCtrlControls(TRUE);
+
+    InstructionCounterInterceptMsrs(VCpu, TRUE);
+
+    State->IsArmed = TRUE;
+    InterlockedIncrement(&g_InstructionCounterArmedCores);
+
+    //
+    // The emulated instructions are counted by the full path of vm-exits and
+    // the overflow is checked on the expiration of the VMX preemption timer
+    //
+    VmexitFastPathUpdate();
+    CounterUpdatePreemptionTimer();
+
+    return TRUE;
+}
+
+/**
+ * @brief Stop counting the retired instructions of the guest on the
+ * current core
+ * @details should be called from vmx-root, the guest's values of the
+ * MSRs are restored
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return UINT64 Count of the instructions that are executed since the
+ * counter is armed (zero if the counter is not armed)
+ */
+UINT64
+InstructionCounterDisarm(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    PINSTRUCTION_COUNTER_STATE State = &VCpu->InstructionCounter;
+    UINT64                     Executed;
+
+    if (!State->IsArmed)
+    {
+        return 0;
+    }
+
+    HvSetPerfGlobalCtrlControls(FALSE);
+
+    __writemsr(PEBS_MSR_PERF_GLOBAL_CTRL, 0);
+
+    Executed = (__readmsr(INSTRUCTION_COUNTER_MSR_FIXED_CTR0) - State->StartValue) & InstructionCounterGetMask();
+
+    //
+    // IA32_PERF_GLOBAL_CTRL is restored last, so the guest's counters are
+    // started once all of their MSRs are restored
+    //
+    __writemsr(PEBS_MSR_PERF_GLOBAL_OVF_CTRL, INSTRUCTION_COUNTER_GLOBAL_FIXED_CTR0);
+    __writemsr(INSTRUCTION_COUNTER_MSR_FIXED_CTR_CTRL, State->GuestFixedCtrCtrl);
+    __writemsr(INSTRUCTION_COUNTER_MSR_FIXED_CTR0, State->GuestFixedCtr0);
+    ApicWriteLvtPerformanceCounter(State->GuestLvtPerformanceCounter);
+    __writemsr(PEBS_MSR_PERF_GLOBAL_CTRL, State->GuestPerfGlobalCtrl);
+
+    InstructionCounterInterceptMsrs(VCpu, FALSE);
+
+    State->IsArmed = FALSE;
+    InterlockedDecrement(&g_InstructionCounterArmedCores);
+
+    VmexitFastPathUpdate();
+    CounterUpdatePreemptionTimer();
+
+    return Executed;
+}
+
+/**
+ * @brief Check whether an NMI is because of the overflow of the counter
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+InstructionCounterCheckNmi(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    if (!VCpu->InstructionCounter.IsArmed)
+    {
+        return FALSE;
+    }
+
+    return (__readmsr(PEBS_MSR_PERF_GLOBAL_STATUS) & INSTRUCTION_COUNTER_GLOBAL_FIXED_CTR0) ? TRUE : FALSE;
+}
+
+/**
+ * @brief Count the emulated instruction of the vm-exit and check for the
+ * overflow of the counter
+ * @details should be called at the end of the vm-exits while the counter
+ * is armed (once the RIP is increased), the overflow is handled by the
+ * debugger, so the guest might be halted here
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+VOID
+InstructionCounterHandleVmexit(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    UINT64  Mask       = InstructionCounterGetMask();
+    BOOLEAN IsOverflow = FALSE;
+    UINT64  Value;
+    UINT64  Executed;
+
+    if (VCpu->IncrementRip)
+    {
+        //
+        // The instruction is emulated, so it's not retired in the guest
+        //
+        Value = (__readmsr(INSTRUCTION_COUNTER_MSR_FIXED_CTR0) + 1) & Mask;
+
+        __writemsr(INSTRUCTION_COUNTER_MSR_FIXED_CTR0, Value);
+
+        if (Value == 0)
+        {
+            IsOverflow = TRUE;
+        }
+    }
+
+    if (!IsOverflow && !InstructionCounterCheckNmi(VCpu))
+    {
+        return;
+    }
+
+    //
+    // The counter keeps counting after the overflow (skid), so the executed
+    // instructions might be more than the armed count
+    //
+    Executed = InstructionCounterDisarm(VCpu);
+
+    //
+    // The RIP is already increased
+    //
+    VmxVmread(VMCS_GUEST_RIP, &VCpu->LastVmexitRip);
+
+    DebuggingCallbackHandleInstructionCounterOverflow(VCpu->CoreId, Executed);
+}
+
+/**
+ * @brief Emulate reading the MSRs of the counter by the guest
+ *
+ * @param VCpu The virtual processor's state
+ * @param TargetMsr
+ * @param Value The value that the guest reads
+ *
+ * @return BOOLEAN Whether the MSR is emulated or not
+ */
+BOOLEAN
+InstructionCounterHandleRdmsr(VIRTUAL_MACHINE_STATE * VCpu, UINT32 TargetMsr, PUINT64 Value)
+{
+    PINSTRUCTION_COUNTER_STATE State = &VCpu->InstructionCounter;
+
+    if (!State->IsArmed)
+    {
+        return FALSE;
+    }
+
+    switch (TargetMsr)
+    {
+    case INSTRUCTION_COUNTER_MSR_FIXED_CTR0:
+        *Value = State->GuestFixedCtr0;
+        return TRUE;
+
+    case INSTRUCTION_COUNTER_MSR_FIXED_CTR_CTRL:
+        *Value = State->GuestFixedCtrCtrl;
+        return TRUE;
+
+    case PEBS_MSR_PERF_GLOBAL_CTRL:
+        *Value = State->GuestPerfGlobalCtrl;
+        return TRUE;
+
+    case PEBS_MSR_PERF_GLOBAL_OVF_CTRL:
+        *Value = 0;
+        return TRUE;
+
+    default:
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Emulate changing the MSRs of the counter by the guest
+ * @details the guest's value is only saved for its next reads (and for
+ * restoring once the counter is disarmed), the overflow of the counter is
+ * never cleared by the guest
+ *
+ * @param VCpu The virtual processor's state
+ * @param TargetMsr
+ * @param Value The value that the guest writes
+ *
+ * @return BOOLEAN Whether the MSR is emulated or not
+ */
+BOOLEAN
+InstructionCounterHandleWrmsr(VIRTUAL_MACHINE_STATE * VCpu, UINT32 TargetMsr, UINT64 Value)
+{
+    PINSTRUCTION_COUNTER_STATE State = &VCpu->InstructionCounter;
+
+    if (!State->IsArmed)
+    {
+        return FALSE;
+    }
+
+    switch (TargetMsr)
+    {
+    case INSTRUCTION_COUNTER_MSR_FIXED_CTR0:
+        State->GuestFixedCtr0 = Value;
+        return TRUE;
+
+    case INSTRUCTION_COUNTER_MSR_FIXED_CTR_CTRL:
+        State->GuestFixedCtrCtrl = Value;
+        return TRUE;
+
+    case PEBS_MSR_PERF_GLOBAL_CTRL:
+        State->GuestPerfGlobalCtrl = Value;
+        return TRUE;
+
+    case PEBS_MSR_PERF_GLOBAL_OVF_CTRL:
+        __writemsr(PEBS_MSR_PERF_GLOBAL_OVF_CTRL, Value & ~INSTRUCTION_COUNTER_GLOBAL_FIXED_CTR0);
+        return TRUE;
+
+    default:
+        return FALSE;
+    }
+}
@@ -0,0 +1,598 @@
+/**
+ * @file IntelPt.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tracing the guest with Intel PT (Processor Trace)
+ * @details the trace is configured from vmx-root on each core and the
+ * guest's IA32_RTIT_CTL is loaded on vm-entries and cleared on vm-exits,
+ * so only vmx non-root is traced, the packets are decoded in user-mode
+ * @version 0.4
+ * @date 2023-08-05
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Allocate a physically contiguous buffer that is aligned to its
+ * size from the NUMA node of the core
+ * @details the regions of the ToPA entries should be aligned to their sizes
+ *
+ * @param NumberOfBytes Size of the buffer (a power of two)
+ * @param CoreId The core that uses the buffer
+ *
+ * @return PVOID
+ */
+static PVOID
+IntelPtAllocateAlignedBufferOnCore(SIZE_T NumberOfBytes, UINT32 CoreId)
+{
+    PVOID            Result          = NULL;
+    PHYSICAL_ADDRESS LowestAddr      = {.QuadPart = 0};
+    PHYSICAL_ADDRESS MaxPhysicalAddr = {.QuadPart = MAXULONG64};
+    PHYSICAL_ADDRESS BoundaryAddr    = {.QuadPart = NumberOfBytes};
+    ULONG            PreferredNode   = CrsGetNodeOfCore(CoreId);
+
+    if (PreferredNode != MM_ANY_NODE_OK)
+    {
+        Result = MmAllocateContiguousNodeMemory(NumberOfBytes,
+                                                LowestAddr,
+                                                MaxPhysicalAddr,
+                                                BoundaryAddr,
+                                                PAGE_READWRITE,
+                                                PreferredNode);
+    }
+
+    if (Result == NULL)
+    {
+        Result = MmAllocateContiguousMemorySpecifyCache(NumberOfBytes,
+                                                        LowestAddr,
+                                                        MaxPhysicalAddr,
+                                                        BoundaryAddr,
+                                                        MmCached);
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Free the buffers of the trace of all cores
+ * @details should not be called while the trace is enabled
+ *
+ * @return VOID
+ */
+static VOID
+IntelPtFreeBuffers()
+{
+    ULONG ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    if (g_IntelPtBuffers == NULL)
+    {
+        return;
+    }
+
+    for (UINT32 i = 0; i < ProcessorsCount; i++)
+    {
+        if (g_IntelPtBuffers[i].Buffer != NULL)
+        {
+            MmFreeContiguousMemory(g_IntelPtBuffers[i].Buffer);
+        }
+
+        if (g_IntelPtBuffers[i].ToPaTable != NULL)
+        {
+            MmFreeContiguousMemory(g_IntelPtBuffers[i].ToPaTable);
+        }
+    }
+
+    ExFreePoolWithTag(g_IntelPtBuffers, POOLTAG);
+    g_IntelPtBuffers = NULL;
+}
+
+/**
+ * @brief Allocate the buffers and the ToPA tables of all cores
+ * @details each ToPA table has a single region (that stops the trace
+ * once it's full) followed by an END entry that points to the table
+ *
+ * @param BufferSize Size of the buffer of each core (a power of two)
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+IntelPtAllocateBuffers(UINT32 BufferSize)
+{
+    ULONG ProcessorsCount = KeQueryActiveProcessorCount(0);
+    ULONG SizeEncoding;
+
+    g_IntelPtBuffers = ExAllocatePoolWithTag(NonPagedPool, sizeof(INTEL_PT_BUFFER) * ProcessorsCount, POOLTAG);
+
+    if (g_IntelPtBuffers == NULL)
+    {
+        return FALSE;
+    }
+
+    RtlZeroMemory(g_IntelPtBuffers, sizeof(INTEL_PT_BUFFER) * ProcessorsCount);
+
+    //
+    // The size of the regions is encoded as 4KB * 2^SizeEncoding
+    //
+    _BitScanForward(&SizeEncoding, BufferSize / PAGE_SIZE);
+
+    for (UINT32 i = 0; i < ProcessorsCount; i++)
+    {
+        PINTEL_PT_BUFFER Buffer = &g_IntelPtBuffers[i];
+
+        Buffer->Buffer    = IntelPtAllocateAlignedBufferOnCore(BufferSize, i);
+        Buffer->ToPaTable = CrsAllocateContiguousZeroedMemoryOnCore(PAGE_SIZE, i);
+
+        if (Buffer->Buffer == NULL || Buffer->ToPaTable == NULL)
+        {
+            IntelPtFreeBuffers();
+            return FALSE;
+        }
+
+        //
+        // The physical addresses are computed here as the cores use them
+        // from vmx-root
+        //
+        Buffer->BufferPhysicalAddress    = VirtualAddressToPhysicalAddress(Buffer->Buffer);
+        Buffer->ToPaTablePhysicalAddress = VirtualAddressToPhysicalAddress(Buffer->ToPaTable);
+
+        Buffer->ToPaTable[0] = Buffer->BufferPhysicalAddress | ((UINT64)SizeEncoding << INTEL_PT_TOPA_ENTRY_SIZE_SHIFT) |
+                               INTEL_PT_TOPA_ENTRY_STOP;
+        Buffer->ToPaTable[1] = Buffer->ToPaTablePhysicalAddress | INTEL_PT_TOPA_ENTRY_END;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Save the size of the trace of the current core
+ * @details should be called from vmx-root, the packets are already
+ * flushed to the buffer as IA32_RTIT_CTL is cleared on vm-exits
+ *
+ * @param Buffer The buffer of the current core
+ *
+ * @return VOID
+ */
+static VOID
+IntelPtSaveTraceSize(PINTEL_PT_BUFFER Buffer)
+{
+    UINT64 Status   = __readmsr(INTEL_PT_MSR_RTIT_STATUS);
+    UINT64 MaskPtrs = __readmsr(INTEL_PT_MSR_RTIT_OUTPUT_MASK_PTRS);
+
+    if (Status & INTEL_PT_RTIT_STATUS_STOPPED)
+    {
+        //
+        // The region is full and the trace is stopped
+        //
+        Buffer->IsBufferFull = TRUE;
+        Buffer->TraceSize    = g_IntelPtConfiguration.BufferSize;
+    }
+    else
+    {
+        //
+        // The offset of the output in the region (bits 63:32)
+        //
+        Buffer->IsBufferFull = FALSE;
+        Buffer->TraceSize    = min(MaskPtrs >> 32, (UINT64)g_IntelPtConfiguration.BufferSize);
+    }
+}
+
+/**
+ * @brief Reset the output of the trace of the current core to the start
+ * of its buffer
+ * @details should be called from vmx-root while IA32_RTIT_CTL is cleared
+ *
+ * @param Buffer The buffer of the current core
+ *
+ * @return VOID
+ */
+static VOID
+IntelPtResetOutput(PINTEL_PT_BUFFER Buffer)
+{
+    __writemsr(INTEL_PT_MSR_RTIT_STATUS, 0);
+    __writemsr(INTEL_PT_MSR_RTIT_OUTPUT_BASE, Buffer->ToPaTablePhysicalAddress);
+    __writemsr(INTEL_PT_MSR_RTIT_OUTPUT_MASK_PTRS, INTEL_PT_OUTPUT_MASK_PTRS_INITIAL);
+
+    Buffer->TraceSize    = 0;
+    Buffer->IsBufferFull = FALSE;
+}
+
+/**
+ * @brief Start, stop, pause or resume the trace of the current core
+ * @details should be called from vmx-root, the MSRs of the trace can
+ * only be written while IA32_RTIT_CTL.TraceEn is cleared, which is the
+ * case in vmx-root as long as the 'clear IA32_RTIT_CTL' control is set
+ *
+ * @param VCpu The virtual processor's state
+ * @param Action The action of the core
+ *
+ * @return VOID
+ */
+VOID
+IntelPtPerformActionOnCore(VIRTUAL_MACHINE_STATE * VCpu, INTEL_PT_CORE_ACTION Action)
+{
+    PINTEL_PT_BUFFER Buffer;
+
+    if (g_IntelPtBuffers == NULL)
+    {
+        return;
+    }
+
+    Buffer = &g_IntelPtBuffers[VCpu->CoreId];
+
+    switch (Action)
+    {
+    case INTEL_PT_CORE_ACTION_START:
+
+        //
+        // The 'clear IA32_RTIT_CTL' control is not set yet, so the trace
+        // is disabled before changing its MSRs
+        //
+        __writemsr(INTEL_PT_MSR_RTIT_CTL, 0);
+
+        IntelPtResetOutput(Buffer);
+
+        if (g_IntelPtConfiguration.RtitCtl & INTEL_PT_RTIT_CTL_CR3_FILTER)
+        {
+            __writemsr(INTEL_PT_MSR_RTIT_CR3_MATCH, g_IntelPtConfiguration.Cr3Match);
+        }
+
+        for (UINT32 i = 0; i < g_IntelPtConfiguration.CountOfAddressRanges; i++)
+        {
+            __writemsr(INTEL_PT_MSR_RTIT_ADDR_A(i), g_IntelPtConfiguration.AddressRangesStart[i]);
+            __writemsr(INTEL_PT_MSR_RTIT_ADDR_B(i), g_IntelPtConfiguration.AddressRangesEnd[i]);
+        }
+
+        VmxVmwrite(INTEL_PT_VMCS_GUEST_RTIT_CTL, g_IntelPtConfiguration.RtitCtl);
+
+        HvSetIntelPtControls(TRUE);
+
+        break;
+
+    case INTEL_PT_CORE_ACTION_STOP:
+
+        VmxVmwrite(INTEL_PT_VMCS_GUEST_RTIT_CTL, 0);
+
+        HvSetIntelPtControls(FALSE);
+
+        //
+        // The trace is kept to be queried
+        //
+        IntelPtSaveTraceSize(Buffer);
+
+        break;
+
+    case INTEL_PT_CORE_ACTION_PAUSE:
+
+        VmxVmwrite(INTEL_PT_VMCS_GUEST_RTIT_CTL, 0);
+
+        IntelPtSaveTraceSize(Buffer);
+
+        break;
+
+    case INTEL_PT_CORE_ACTION_RESUME:
+
+        //
+        // The previous trace is discarded
+        //
+        IntelPtResetOutput(Buffer);
+
+        VmxVmwrite(INTEL_PT_VMCS_GUEST_RTIT_CTL, g_IntelPtConfiguration.RtitCtl);
+
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Stop tracing on all cores
+ * @details the buffers are kept to be queried
+ *
+ * @return VOID
+ */
+static VOID
+IntelPtStop()
+{
+    if (!g_IntelPtEnabled)
+    {
+        return;
+    }
+
+    //
+    // Broadcast to all cores
+    //
+    BroadcastConfigureIntelPtOnAllProcessors(INTEL_PT_CORE_ACTION_STOP);
+
+    g_IntelPtEnabled = FALSE;
+    g_IntelPtPaused  = FALSE;
+}
+
+/**
+ * @brief Start tracing on all cores
+ * @details should be called from vmx non-root (PASSIVE_LEVEL)
+ *
+ * @param IntelPtRequest
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+IntelPtStart(PDEBUGGER_INTEL_PT_REQUEST IntelPtRequest)
+{
+    UINT32 BufferSize = IntelPtRequest->BufferSize != 0 ? IntelPtRequest->BufferSize : IntelPtDefaultBufferSize;
+    UINT64 RtitCtl    = INTEL_PT_RTIT_CTL_TRACE_EN | INTEL_PT_RTIT_CTL_TOPA | INTEL_PT_RTIT_CTL_BRANCH_EN;
+    UINT64 Cr3        = IntelPtRequest->Cr3;
+
+    if (!g_CompatibilityCheck.IntelPtSupport)
+    {
+        IntelPtRequest->KernelStatus = DEBUGGER_ERROR_INTEL_PT_IS_NOT_SUPPORTED;
+        return FALSE;
+    }
+
+    if (BufferSize < PAGE_SIZE || BufferSize > INTEL_PT_MAXIMUM_BUFFER_SIZE || (BufferSize & (BufferSize - 1)) != 0 ||
+        (!IntelPtRequest->TraceUserMode && !IntelPtRequest->TraceKernelMode) ||
+        IntelPtRequest->CountOfAddressRanges > IntelPtMaximumAddressRanges)
+    {
+        IntelPtRequest->KernelStatus = DEBUGGER_ERROR_INVALID_INTEL_PT_CONFIGURATION;
+        return FALSE;
+    }
+
+    if (IntelPtRequest->CountOfAddressRanges > g_CompatibilityCheck.IntelPtAddressRanges)
+    {
+        IntelPtRequest->KernelStatus = DEBUGGER_ERROR_INTEL_PT_IS_NOT_SUPPORTED;
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < IntelPtRequest->CountOfAddressRanges; i++)
+    {
+        if (IntelPtRequest->AddressRangesStart[i] > IntelPtRequest->AddressRangesEnd[i])
+        {
+            IntelPtRequest->KernelStatus = DEBUGGER_ERROR_INVALID_INTEL_PT_CONFIGURATION;
+            return FALSE;
+        }
+
+        RtitCtl |= INTEL_PT_RTIT_CTL_ADDR_FILTER(i);
+    }
+
+    if (Cr3 == NULL && IntelPtRequest->ProcessId != 0)
+    {
+        Cr3 = LayoutGetCr3ByProcessId(IntelPtRequest->ProcessId).Flags;
+
+        if (Cr3 == NULL)
+        {
+            IntelPtRequest->KernelStatus = DEBUGGER_ERROR_INVALID_INTEL_PT_CONFIGURATION;
+            return FALSE;
+        }
+    }
+
+    if (Cr3 != NULL)
+    {
+        if (!g_CompatibilityCheck.IntelPtCr3FilteringSupport)
+        {
+            IntelPtRequest->KernelStatus = DEBUGGER_ERROR_INTEL_PT_IS_NOT_SUPPORTED;
+            return FALSE;
+        }
+
+        RtitCtl |= INTEL_PT_RTIT_CTL_CR3_FILTER;
+    }
+
+    //
+    // The returns are not compressed, so each 'ret' has its own target
+    // and the call tree doesn't depend on the calls before the trace
+    //
+    RtitCtl |= INTEL_PT_RTIT_CTL_DIS_RETC;
+
+    if (IntelPtRequest->TraceUserMode)
+    {
+        RtitCtl |= INTEL_PT_RTIT_CTL_USER;
+    }
+
+    if (IntelPtRequest->TraceKernelMode)
+    {
+        RtitCtl |= INTEL_PT_RTIT_CTL_OS;
+    }
+
+    //
+    // The previous trace (if any) is stopped before changing the buffers
+    //
+    IntelPtStop();
+
+    if (g_IntelPtBuffers != NULL && g_IntelPtConfiguration.BufferSize != BufferSize)
+    {
+        IntelPtFreeBuffers();
+    }
+
+    if (g_IntelPtBuffers == NULL && !IntelPtAllocateBuffers(BufferSize))
+    {
+        IntelPtRequest->KernelStatus = DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_INTEL_PT_BUFFERS;
+        return FALSE;
+    }
+
+    g_IntelPtConfiguration.RtitCtl              = RtitCtl;
+    g_IntelPtConfiguration.BufferSize           = BufferSize;
+    g_IntelPtConfiguration.CountOfAddressRanges = IntelPtRequest->CountOfAddressRanges;
+
+    //
+    // The PCID (bits 11:0) is not part of the address of the page tables
+    //
+    g_IntelPtConfiguration.Cr3Match = Cr3 & ~0xfffull;
+
+    for (UINT32 i = 0; i < IntelPtRequest->CountOfAddressRanges; i++)
+    {
+        g_IntelPtConfiguration.AddressRangesStart[i] = IntelPtRequest->AddressRangesStart[i];
+        g_IntelPtConfiguration.AddressRangesEnd[i]   = IntelPtRequest->AddressRangesEnd[i];
+    }
+
+    //
+    // Broadcast to all cores
+    //
+    BroadcastConfigureIntelPtOnAllProcessors(INTEL_PT_CORE_ACTION_START);
+
+    g_IntelPtEnabled = TRUE;
+    g_IntelPtPaused  = FALSE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Pause or resume tracing on all cores
+ *
+ * @param IntelPtRequest
+ * @param Pause Pause or resume (and discard the previous trace)
+ *
+ * @return VOID
+ */
+static VOID
+IntelPtPauseOrResume(PDEBUGGER_INTEL_PT_REQUEST IntelPtRequest, BOOLEAN Pause)
+{
+    if (!g_IntelPtEnabled)
+    {
+        IntelPtRequest->KernelStatus = DEBUGGER_ERROR_INTEL_PT_IS_NOT_ENABLED;
+        return;
+    }
+
+    if (Pause && g_IntelPtPaused)
+    {
+        //
+        // Already paused
+        //
+        return;
+    }
+
+    //
+    // Broadcast to all cores
+    //
+    BroadcastConfigureIntelPtOnAllProcessors(Pause ? INTEL_PT_CORE_ACTION_PAUSE : INTEL_PT_CORE_ACTION_RESUME);
+
+    g_IntelPtPaused = Pause;
+}
+
+/**
+ * @brief Copy a chunk of the trace of a core to the request
+ * @details the trace is paused (if it's not paused) to be consistent
+ *
+ * @param IntelPtRequest
+ *
+ * @return VOID
+ */
+static VOID
+IntelPtQuery(PDEBUGGER_INTEL_PT_REQUEST IntelPtRequest)
+{
+    PINTEL_PT_BUFFER Buffer;
+
+    IntelPtRequest->TraceSize      = 0;
+    IntelPtRequest->TraceChunkSize = 0;
+    IntelPtRequest->IsBufferFull   = FALSE;
+
+    if (g_IntelPtBuffers == NULL)
+    {
+        //
+        // The trace is never enabled
+        //
+        IntelPtRequest->KernelStatus = DEBUGGER_ERROR_INTEL_PT_IS_NOT_ENABLED;
+        return;
+    }
+
+    if (IntelPtRequest->CoreId >= KeQueryActiveProcessorCount(0))
+    {
+        IntelPtRequest->KernelStatus = DEBUGGER_ERROR_INVALID_CORE_ID;
+        return;
+    }
+
+    if (g_IntelPtEnabled && !g_IntelPtPaused)
+    {
+        IntelPtPauseOrResume(IntelPtRequest, TRUE);
+    }
+
+    Buffer = &g_IntelPtBuffers[IntelPtRequest->CoreId];
+
+    IntelPtRequest->TraceSize    = Buffer->TraceSize;
+    IntelPtRequest->IsBufferFull = Buffer->IsBufferFull;
+
+    if (IntelPtRequest->Offset < Buffer->TraceSize)
+    {
+        IntelPtRequest->TraceChunkSize = (UINT32)min(Buffer->TraceSize - IntelPtRequest->Offset, IntelPtTraceBytesToQuery);
+
+        RtlCopyMemory(IntelPtRequest->Trace,
+                      (PUCHAR)Buffer->Buffer + IntelPtRequest->Offset,
+                      IntelPtRequest->TraceChunkSize);
+    }
+}
+
+/**
+ * @brief Enable, disable, pause, resume or query the trace of Intel PT
+ * @details should be called from vmx non-root (PASSIVE_LEVEL)
+ *
+ * @param IntelPtRequest
+ *
+ * @return VOID
+ */
+VOID
+IntelPtPerformAction(PDEBUGGER_INTEL_PT_REQUEST IntelPtRequest)
+{
+    IntelPtRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    SpinlockLock(&g_IntelPtLock);
+
+    switch (IntelPtRequest->Action)
+    {
+    case DEBUGGER_INTEL_PT_ACTION_ENABLE:
+
+        IntelPtStart(IntelPtRequest);
+
+        break;
+
+    case DEBUGGER_INTEL_PT_ACTION_DISABLE:
+
+        IntelPtStop();
+
+        break;
+
+    case DEBUGGER_INTEL_PT_ACTION_PAUSE:
+
+        IntelPtPauseOrResume(IntelPtRequest, TRUE);
+
+        break;
+
+    case DEBUGGER_INTEL_PT_ACTION_RESUME:
+
+        IntelPtPauseOrResume(IntelPtRequest, FALSE);
+
+        break;
+
+    case DEBUGGER_INTEL_PT_ACTION_QUERY:
+
+        IntelPtQuery(IntelPtRequest);
+
+        break;
+
+    default:
+
+        IntelPtRequest->KernelStatus = DEBUGGER_ERROR_INVALID_ACTION_TYPE;
+
+        break;
+    }
+
+    IntelPtRequest->IsEnabled    = g_IntelPtEnabled;
+    IntelPtRequest->IsPaused     = g_IntelPtPaused;
+    IntelPtRequest->CountOfCores = KeQueryActiveProcessorCount(0);
+
+    SpinlockUnlock(&g_IntelPtLock);
+}
+
+/**
+ * @brief Free the buffers of the trace of Intel PT
+ * @details should be called after VMX is terminated on all cores, the
+ * trace is already disabled as IA32_RTIT_CTL is cleared on vm-exits
+ *
+ * @return VOID
+ */
+VOID
+IntelPtUninitialize()
+{
+    g_IntelPtEnabled = FALSE;
+    g_IntelPtPaused  = FALSE;
+
+    IntelPtFreeBuffers();
+}
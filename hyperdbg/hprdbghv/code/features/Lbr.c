@@ -0,0 +1,336 @@
+/**
+ * @file Lbr.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Recording the last branches (LBR) of the guest
+ * @details the LBRs are only enabled for the guest (the guest's
+ * IA32_DEBUGCTL or IA32_LBR_CTL is loaded on vm-entries and it's cleared
+ * on vm-exits), so once a vm-exit happens, the LBR stack contains the last
+ * branches of the guest before the vm-exit, the guest's accesses to the
+ * controls of the LBRs are virtualized, so the guest can't disable them
+ * @version 0.4
+ * @date 2023-08-06
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Start recording the last branches of the guest on the current core
+ * @details should be called from vmx-root
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+static VOID
+LbrStart(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    UINT64 DebugCtl = 0;
+
+    if (g_CompatibilityCheck.ArchLbrSupport)
+    {
+        //
+        // The guest's IA32_LBR_CTL is not changed by the vm-exits yet
+        //
+        VCpu->LbrGuestControl = __readmsr(LBR_MSR_ARCH_LBR_CTL);
+
+        //
+        // Stop recording in vmx-root, changing the depth also clears the
+        // previous records
+        //
+        __writemsr(LBR_MSR_ARCH_LBR_CTL, 0);
+        __writemsr(LBR_MSR_ARCH_LBR_DEPTH, g_CompatibilityCheck.LbrDepth);
+
+        VmxVmwrite(LBR_VMCS_GUEST_ARCH_LBR_CTL, LBR_ARCH_LBR_CTL_RECORD_ALL);
+        HvSetArchLbrControls(TRUE);
+
+        MsrHandlePerformMsrBitmapReadChange(VCpu, LBR_MSR_ARCH_LBR_CTL);
+        MsrHandlePerformMsrBitmapWriteChange(VCpu, LBR_MSR_ARCH_LBR_CTL);
+        MsrHandlePerformMsrBitmapWriteChange(VCpu, LBR_MSR_ARCH_LBR_DEPTH);
+    }
+    else
+    {
+        VmxVmread(VMCS_GUEST_DEBUGCTL, &DebugCtl);
+
+        VCpu->LbrGuestControl = DebugCtl;
+
+        //
+        // IA32_DEBUGCTL is cleared on vm-exits, so it's loaded from the
+        // VMCS on vm-entries
+        //
+        HvSetLoadDebugControls(TRUE);
+        HvSetSaveDebugControls(TRUE);
+
+        VmxVmwrite(VMCS_GUEST_DEBUGCTL, DebugCtl | LBR_DEBUGCTL_LBR);
+
+        MsrHandlePerformMsrBitmapReadChange(VCpu, IA32_DEBUGCTL);
+        MsrHandlePerformMsrBitmapWriteChange(VCpu, IA32_DEBUGCTL);
+    }
+
+    VCpu->LbrEnabled = TRUE;
+}
+
+/**
+ * @brief Stop recording the last branches of the guest on the current core
+ * @details should be called from vmx-root, the load/save debug controls
+ * are not unset as the guest's IA32_DEBUGCTL is only kept by them
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+static VOID
+LbrStop(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    UINT64 DebugCtl = 0;
+
+    if (g_CompatibilityCheck.ArchLbrSupport)
+    {
+        HvSetArchLbrControls(FALSE);
+        VmxVmwrite(LBR_VMCS_GUEST_ARCH_LBR_CTL, 0);
+
+        //
+        // Give the LBRs back to the guest
+        //
+        __writemsr(LBR_MSR_ARCH_LBR_CTL, VCpu->LbrGuestControl);
+
+        MsrHandlePerformMsrBitmapReadUnset(VCpu, LBR_MSR_ARCH_LBR_CTL);
+        MsrHandlePerformMsrBitmapWriteUnset(VCpu, LBR_MSR_ARCH_LBR_CTL);
+        MsrHandlePerformMsrBitmapWriteUnset(VCpu, LBR_MSR_ARCH_LBR_DEPTH);
+    }
+    else
+    {
+        VmxVmread(VMCS_GUEST_DEBUGCTL, &DebugCtl);
+
+        DebugCtl = (DebugCtl & ~LBR_DEBUGCTL_LBR) | (VCpu->LbrGuestControl & LBR_DEBUGCTL_LBR);
+
+        VmxVmwrite(VMCS_GUEST_DEBUGCTL, DebugCtl);
+
+        MsrHandlePerformMsrBitmapReadUnset(VCpu, IA32_DEBUGCTL);
+        MsrHandlePerformMsrBitmapWriteUnset(VCpu, IA32_DEBUGCTL);
+    }
+
+    VCpu->LbrEnabled = FALSE;
+}
+
+/**
+ * @brief Start or stop recording the last branches of the guest on the
+ * current core
+ * @details should be called from vmx-root
+ *
+ * @param VCpu The virtual processor's state
+ * @param Enable Start or stop
+ *
+ * @return VOID
+ */
+VOID
+LbrPerformActionOnCore(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Enable)
+{
+    if (g_CompatibilityCheck.LbrDepth == 0 || VCpu->LbrEnabled == Enable)
+    {
+        return;
+    }
+
+    if (Enable)
+    {
+        LbrStart(VCpu);
+    }
+    else
+    {
+        LbrStop(VCpu);
+    }
+}
+
+/**
+ * @brief Request (or release the request of) recording the last branches
+ * of the guest on all cores
+ * @details the requests are counted, the cores start (or stop) recording
+ * on their next vm-exit, can be called from vmx-root
+ *
+ * @param Set Request or release
+ *
+ * @return BOOLEAN FALSE if the LBRs are not supported
+ */
+BOOLEAN
+LbrRequest(BOOLEAN Set)
+{
+    LONG ReferenceCount;
+
+    if (g_CompatibilityCheck.LbrDepth == 0)
+    {
+        return FALSE;
+    }
+
+    ReferenceCount = Set ? InterlockedIncrement(&g_LastBranchRecordsReferenceCount) : InterlockedDecrement(&g_LastBranchRecordsReferenceCount);
+
+    //
+    // Only the first request and the last release change the cores
+    //
+    if ((Set && ReferenceCount == 1) || (!Set && ReferenceCount == 0))
+    {
+        VmcsPendingUpdatesSetLastBranchRecords(DEBUGGER_BROADCASTING_ALL_CORES_MASK, Set);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Convert an address of the legacy LBR stack to a canonical address
+ * @details based on the format of the LBRs, the higher bits might have
+ * the flags (e.g., mispredicted or TSX flags) or the cycle count
+ *
+ * @param Address
+ *
+ * @return UINT64
+ */
+static UINT64
+LbrCanonicalizeAddress(UINT64 Address)
+{
+    return (UINT64)(((INT64)(Address << 16)) >> 16);
+}
+
+/**
+ * @brief Read the last branches of the guest on the current core
+ * @details should be called from vmx-root, the most recent branch is
+ * the first record
+ *
+ * @param VCpu The virtual processor's state
+ * @param Records The buffer to save the records
+ * @param Count Maximum count of the records
+ *
+ * @return UINT32 Count of the read records
+ */
+UINT32
+LbrReadBranches(VIRTUAL_MACHINE_STATE * VCpu, PDEBUGGER_LAST_BRANCH_RECORD Records, UINT32 Count)
+{
+    UINT32 Depth = g_CompatibilityCheck.LbrDepth;
+    UINT32 Tos;
+    UINT32 Index;
+    UINT32 i;
+
+    //
+    // In vmx non-root, the LBRs are still recording
+    //
+    if (!VCpu->LbrEnabled || !VCpu->IsOnVmxRootMode)
+    {
+        return 0;
+    }
+
+    Count = min(Count, Depth);
+
+    if (g_CompatibilityCheck.ArchLbrSupport)
+    {
+        for (i = 0; i < Count; i++)
+        {
+            Records[i].FromAddress = __readmsr(LBR_MSR_ARCH_LBR_FROM_IP(i));
+            Records[i].ToAddress   = __readmsr(LBR_MSR_ARCH_LBR_TO_IP(i));
+
+            //
+            // The entries that are not recorded yet are zero
+            //
+            if (Records[i].FromAddress == 0 && Records[i].ToAddress == 0)
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        Tos = (UINT32)__readmsr(LBR_MSR_LASTBRANCH_TOS) & (Depth - 1);
+
+        for (i = 0; i < Count; i++)
+        {
+            Index = (Tos - i) & (Depth - 1);
+
+            Records[i].FromAddress = LbrCanonicalizeAddress(__readmsr(LBR_MSR_LASTBRANCH_FROM_IP(Index)));
+            Records[i].ToAddress   = LbrCanonicalizeAddress(__readmsr(LBR_MSR_LASTBRANCH_TO_IP(Index)));
+
+            if (Records[i].FromAddress == 0 && Records[i].ToAddress == 0)
+            {
+                break;
+            }
+        }
+    }
+
+    return i;
+}
+
+/**
+ * @brief Emulate reading the controls of the LBRs by the guest
+ *
+ * @param VCpu The virtual processor's state
+ * @param TargetMsr
+ * @param Value The value that the guest reads
+ *
+ * @return BOOLEAN Whether the MSR is emulated or not
+ */
+BOOLEAN
+LbrHandleRdmsr(VIRTUAL_MACHINE_STATE * VCpu, UINT32 TargetMsr, PUINT64 Value)
+{
+    UINT64 DebugCtl = 0;
+
+    if (!VCpu->LbrEnabled)
+    {
+        return FALSE;
+    }
+
+    if (g_CompatibilityCheck.ArchLbrSupport && TargetMsr == LBR_MSR_ARCH_LBR_CTL)
+    {
+        *Value = VCpu->LbrGuestControl;
+        return TRUE;
+    }
+
+    if (!g_CompatibilityCheck.ArchLbrSupport && TargetMsr == IA32_DEBUGCTL)
+    {
+        VmxVmread(VMCS_GUEST_DEBUGCTL, &DebugCtl);
+
+        *Value = (DebugCtl & ~LBR_DEBUGCTL_LBR) | (VCpu->LbrGuestControl & LBR_DEBUGCTL_LBR);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Emulate changing the controls of the LBRs by the guest
+ * @details the guest's value is only saved for its next reads, so the
+ * guest can't stop (or reset) recording the last branches
+ *
+ * @param VCpu The virtual processor's state
+ * @param TargetMsr
+ * @param Value The value that the guest writes
+ *
+ * @return BOOLEAN Whether the MSR is emulated or not
+ */
+BOOLEAN
+LbrHandleWrmsr(VIRTUAL_MACHINE_STATE * VCpu, UINT32 TargetMsr, UINT64 Value)
+{
+    if (!VCpu->LbrEnabled)
+    {
+        return FALSE;
+    }
+
+    if (g_CompatibilityCheck.ArchLbrSupport && (TargetMsr == LBR_MSR_ARCH_LBR_CTL || TargetMsr == LBR_MSR_ARCH_LBR_DEPTH))
+    {
+        if (TargetMsr == LBR_MSR_ARCH_LBR_CTL)
+        {
+            VCpu->LbrGuestControl = Value;
+        }
+
+        return TRUE;
+    }
+
+    if (!g_CompatibilityCheck.ArchLbrSupport && TargetMsr == IA32_DEBUGCTL)
+    {
+        VCpu->LbrGuestControl = Value;
+
+        //
+        // The other bits of the guest (e.g., BTF) are applied
+        //
+        VmxVmwrite(VMCS_GUEST_DEBUGCTL, Value | LBR_DEBUGCTL_LBR);
+        return TRUE;
+    }
+
+    return FALSE;
+}
@@ -0,0 +1,847 @@
+/**
+ * @file PebsSampling.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Sampling the memory accesses of the guest with PEBS
+ * @details PEBS (Precise Event Based Sampling) records the loads and the
+ * stores of the guest into the buffer of each core without any vm-exit,
+ * the guest's IA32_PERF_GLOBAL_CTRL is loaded on vm-entries and cleared on
+ * vm-exits, so only vmx non-root is sampled, the buffers are drained from
+ * vmx-root (once the VMX preemption timer is expired) and the records of
+ * the monitored range are aggregated into (RIP, data address) counts
+ * @version 0.4
+ * @date 2023-08-11
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief The MSRs of PEBS_SAMPLING_VIRTUALIZED_MSR
+ *
+ */
+static const UINT32 PebsSamplingVirtualizedMsrs[PEBS_SAMPLING_VIRTUALIZED_MSR_COUNT] = {
+    PEBS_MSR_PERF_GLOBAL_CTRL,
+    PEBS_MSR_PEBS_ENABLE,
+    PEBS_MSR_DS_AREA,
+    PEBS_MSR_PERFEVTSEL(0),
+    PEBS_MSR_PERFEVTSEL(1),
+    PEBS_MSR_PMC(0),
+    PEBS_MSR_PMC(1),
+    PEBS_MSR_PEBS_LD_LAT,
+    PEBS_MSR_PEBS_DATA_CFG,
+};
+
+/**
+ * @brief Check whether a virtualized MSR is available on the processor
+ *
+ * @param Index The index of the MSR (PEBS_SAMPLING_VIRTUALIZED_MSR)
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PebsSamplingIsMsrAvailable(UINT32 Index)
+{
+    if (Index == PEBS_SAMPLING_VIRTUALIZED_MSR_PEBS_DATA_CFG)
+    {
+        return g_CompatibilityCheck.PebsRecordFormat >= PEBS_RECORD_FORMAT_ADAPTIVE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the index of a virtualized MSR
+ *
+ * @param TargetMsr
+ * @param Index The index of the MSR (PEBS_SAMPLING_VIRTUALIZED_MSR)
+ *
+ * @return BOOLEAN Whether the MSR is virtualized or not
+ */
+static BOOLEAN
+PebsSamplingGetVirtualizedMsrIndex(UINT32 TargetMsr, PUINT32 Index)
+{
+    if (g_CompatibilityCheck.PmcFullWidthWritesSupport &&
+        (TargetMsr == PEBS_MSR_A_PMC(0) || TargetMsr == PEBS_MSR_A_PMC(1)))
+    {
+        *Index = PEBS_SAMPLING_VIRTUALIZED_MSR_PMC0 + (TargetMsr - PEBS_MSR_A_PMC(0));
+        return TRUE;
+    }
+
+    for (UINT32 i = 0; i < PEBS_SAMPLING_VIRTUALIZED_MSR_COUNT; i++)
+    {
+        if (PebsSamplingVirtualizedMsrs[i] == TargetMsr && PebsSamplingIsMsrAvailable(i))
+        {
+            *Index = i;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Intercept (or stop intercepting) the accesses of the guest to
+ * the virtualized MSRs
+ * @details should be called from vmx-root
+ *
+ * @param VCpu The virtual processor's state
+ * @param Intercept
+ *
+ * @return VOID
+ */
+static VOID
+PebsSamplingInterceptMsrs(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Intercept)
+{
+    for (UINT32 i = 0; i < PEBS_SAMPLING_VIRTUALIZED_MSR_COUNT + 2; i++)
+    {
+        UINT32 Msr;
+
+        if (i < PEBS_SAMPLING_VIRTUALIZED_MSR_COUNT)
+        {
+            if (!PebsSamplingIsMsrAvailable(i))
+            {
+                continue;
+            }
+
+            Msr = PebsSamplingVirtualizedMsrs[i];
+        }
+        else
+        {
+            //
+            // The full-width aliases of the counters
+            //
+            if (!g_CompatibilityCheck.PmcFullWidthWritesSupport)
+            {
+                break;
+            }
+
+            Msr = PEBS_MSR_A_PMC(i - PEBS_SAMPLING_VIRTUALIZED_MSR_COUNT);
+        }
+
+        if (Intercept)
+        {
+            MsrHandlePerformMsrBitmapReadChange(VCpu, Msr);
+            MsrHandlePerformMsrBitmapWriteChange(VCpu, Msr);
+        }
+        else
+        {
+            MsrHandlePerformMsrBitmapReadUnset(VCpu, Msr);
+            MsrHandlePerformMsrBitmapWriteUnset(VCpu, Msr);
+        }
+    }
+}
+
+/**
+ * @brief Get the size of the PEBS records
+ * @details the adaptive records also contain their own size
+ *
+ * @return UINT64
+ */
+static UINT64
+PebsSamplingGetRecordSize()
+{
+    switch (g_CompatibilityCheck.PebsRecordFormat)
+    {
+    case 1:
+        return PEBS_RECORD_SIZE_FORMAT_1;
+    case 2:
+        return PEBS_RECORD_SIZE_FORMAT_2;
+    case 3:
+        return PEBS_RECORD_SIZE_FORMAT_3;
+    default:
+        return PEBS_ADAPTIVE_RECORD_SIZE;
+    }
+}
+
+/**
+ * @brief Count a record in the table of the current core
+ * @details should be called from vmx-root, the slots are found by the
+ * Fibonacci hashing of the pair and probed linearly
+ *
+ * @param Buffer The buffer of the current core
+ * @param Rip
+ * @param DataAddress
+ *
+ * @return VOID
+ */
+static VOID
+PebsSamplingCountRecord(PPEBS_SAMPLING_BUFFER Buffer, UINT64 Rip, UINT64 DataAddress)
+{
+    UINT64 Hash;
+
+    if (DataAddress < g_PebsSamplingConfiguration.StartAddress || DataAddress > g_PebsSamplingConfiguration.EndAddress)
+    {
+        Buffer->CountOfFilteredOut++;
+        return;
+    }
+
+    Hash = ((Rip ^ _rotl64(DataAddress, 32)) * 0x9e3779b97f4a7c15ull) >> 32;
+
+    for (UINT32 i = 0; i < PEBS_SAMPLING_TABLE_MAXIMUM_PROBES; i++)
+    {
+        PPEBS_SAMPLING_ENTRY Entry = &Buffer->Table[(Hash + i) & (PEBS_SAMPLING_TABLE_CAPACITY - 1)];
+
+        if (Entry->Count == 0)
+        {
+            Entry->Rip         = Rip;
+            Entry->DataAddress = DataAddress;
+
+            //
+            // The entry is visible to the queries once it's counted
+            //
+            InterlockedExchange64((volatile LONG64 *)&Entry->Count, 1);
+
+            Buffer->CountOfRecords++;
+            return;
+        }
+
+        if (Entry->Rip == Rip && Entry->DataAddress == DataAddress)
+        {
+            Entry->Count++;
+
+            Buffer->CountOfRecords++;
+            return;
+        }
+    }
+
+    Buffer->CountOfDropped++;
+}
+
+/**
+ * @brief Aggregate the records of the PEBS buffer of the current core and
+ * reset the buffer
+ * @details should be called from vmx-root, the counters are stopped in
+ * vmx-root (IA32_PERF_GLOBAL_CTRL is cleared on vm-exits), so no record
+ * is written while the buffer is drained
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+VOID
+PebsSamplingDrainBuffer(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    PPEBS_SAMPLING_BUFFER Buffer;
+    PPEBS_DS_AREA         DsArea;
+    UINT64                RecordSize = PebsSamplingGetRecordSize();
+    UINT64                Rip;
+    UINT64                DataAddress;
+
+    if (g_PebsSamplingBuffers == NULL || !g_PebsSamplingBuffers[VCpu->CoreId].IsEnabled)
+    {
+        return;
+    }
+
+    Buffer = &g_PebsSamplingBuffers[VCpu->CoreId];
+    DsArea = Buffer->DsArea;
+
+    for (UINT64 Record = DsArea->PebsBufferBase;
+         Record < DsArea->PebsIndex && Record < DsArea->PebsAbsoluteMaximum;
+         Record += RecordSize)
+    {
+        if (g_CompatibilityCheck.PebsRecordFormat >= PEBS_RECORD_FORMAT_ADAPTIVE)
+        {
+            //
+            // The size of the adaptive records is in bits 63:48 of their
+            // first field
+            //
+            RecordSize = *(PUINT64)(Record + PEBS_ADAPTIVE_RECORD_OFFSET_FORMAT_SIZE) >> 48;
+
+            if (RecordSize == 0)
+            {
+                break;
+            }
+
+            Rip         = *(PUINT64)(Record + PEBS_ADAPTIVE_RECORD_OFFSET_IP);
+            DataAddress = *(PUINT64)(Record + PEBS_ADAPTIVE_RECORD_OFFSET_DATA_ADDRESS);
+        }
+        else
+        {
+            //
+            // The first format only has the RIP after the instruction
+            //
+            Rip = *(PUINT64)(Record + (g_CompatibilityCheck.PebsRecordFormat >= PEBS_RECORD_FORMAT_EVENTING_IP ? PEBS_RECORD_OFFSET_EVENTING_IP : PEBS_RECORD_OFFSET_RIP));
+
+            DataAddress = *(PUINT64)(Record + PEBS_RECORD_OFFSET_DATA_ADDRESS);
+        }
+
+        PebsSamplingCountRecord(Buffer, Rip, DataAddress);
+    }
+
+    DsArea->PebsIndex = DsArea->PebsBufferBase;
+
+    //
+    // Clear the overflows of the counters and the buffer
+    //
+    __writemsr(PEBS_MSR_PERF_GLOBAL_OVF_CTRL, g_PebsSamplingConfiguration.CountersMask | PEBS_GLOBAL_STATUS_OVF_BUFFER);
+}
+
+/**
+ * @brief Start sampling the memory accesses of the guest on the current core
+ * @details should be called from vmx-root
+ *
+ * @param VCpu The virtual processor's state
+ * @param Buffer The buffer of the current core
+ *
+ * @return VOID
+ */
+static VOID
+PebsSamplingStartOnCore(VIRTUAL_MACHINE_STATE * VCpu, PPEBS_SAMPLING_BUFFER Buffer)
+{
+    PPEBS_DS_AREA DsArea     = Buffer->DsArea;
+    UINT64        RecordSize = PebsSamplingGetRecordSize();
+
+    //
+    // The 'load IA32_PERF_GLOBAL_CTRL' controls are not set yet, so the
+    // MSRs still hold the guest's values
+    //
+    for (UINT32 i = 0; i < PEBS_SAMPLING_VIRTUALIZED_MSR_COUNT; i++)
+    {
+        Buffer->GuestMsrs[i] = PebsSamplingIsMsrAvailable(i) ? __readmsr(PebsSamplingVirtualizedMsrs[i]) : 0;
+    }
+
+    //
+    // Stop the counters before changing them
+    //
+    __writemsr(PEBS_MSR_PERF_GLOBAL_CTRL, 0);
+    __writemsr(PEBS_MSR_PEBS_ENABLE, 0);
+
+    RtlZeroMemory(DsArea, sizeof(PEBS_DS_AREA));
+
+    DsArea->PebsBufferBase      = (UINT64)Buffer->PebsBuffer;
+    DsArea->PebsIndex           = DsArea->PebsBufferBase;
+    DsArea->PebsAbsoluteMaximum = DsArea->PebsBufferBase + (PEBS_SAMPLING_BUFFER_SIZE / RecordSize) * RecordSize;
+
+    //
+    // The threshold is never reached, so no PMI is delivered to the guest,
+    // the records after the absolute maximum are dropped until the next drain
+    //
+    DsArea->PebsInterruptThreshold = DsArea->PebsAbsoluteMaximum + RecordSize;
+
+    DsArea->PebsCounterReset[PEBS_SAMPLING_LOADS_COUNTER]  = g_PebsSamplingConfiguration.CounterReset;
+    DsArea->PebsCounterReset[PEBS_SAMPLING_STORES_COUNTER] = g_PebsSamplingConfiguration.CounterReset;
+
+    __writemsr(PEBS_MSR_DS_AREA, (UINT64)DsArea);
+
+    for (UINT32 i = 0; i < 2; i++)
+    {
+        __writemsr(PEBS_MSR_PERFEVTSEL(i), 0);
+        __writemsr(PEBS_MSR_PMC(i), g_PebsSamplingConfiguration.CounterReset);
+        __writemsr(PEBS_MSR_PERFEVTSEL(i), g_PebsSamplingConfiguration.PerfEvtSel[i]);
+    }
+
+    __writemsr(PEBS_MSR_PEBS_LD_LAT, g_PebsSamplingConfiguration.LatencyThreshold);
+
+    if (g_CompatibilityCheck.PebsRecordFormat >= PEBS_RECORD_FORMAT_ADAPTIVE)
+    {
+        __writemsr(PEBS_MSR_PEBS_DATA_CFG, PEBS_DATA_CFG_MEMORY_INFO);
+    }
+
+    __writemsr(PEBS_MSR_PEBS_ENABLE, g_PebsSamplingConfiguration.PebsEnable);
+
+    //
+    // The counters only count in vmx non-root
+    //
+    VmxVmwrite(VMCS_GUEST_PERF_GLOBAL_CTRL,
+               Buffer->GuestMsrs[PEBS_SAMPLING_VIRTUALIZED_MSR_PERF_GLOBAL_CTRL] | g_PebsSamplingConfiguration.CountersMask);
+    VmxVmwrite(VMCS_HOST_PERF_GLOBAL_CTRL, 0);
+
+    HvSetPerfGlobalCtrlControls(TRUE);
+
+    PebsSamplingInterceptMsrs(VCpu, TRUE);
+
+    Buffer->IsEnabled = TRUE;
+}
+
+/**
+ * @brief Stop sampling the memory accesses of the guest on the current core
+ * @details should be called from vmx-root, the remaining records are
+ * aggregated and the guest's values of the MSRs are restored
+ *
+ * @param VCpu The virtual processor's state
+ * @param Buffer The buffer of the current core
+ *
+ * @return VOID
+ */
+static VOID
+PebsSamplingStopOnCore(VIRTUAL_MACHINE_STATE * VCpu, PPEBS_SAMPLING_BUFFER Buffer)
+{
+    PebsSamplingDrainBuffer(VCpu);
+
+    HvSetPerfGlobalCtrlControls(FALSE);
+
+    __writemsr(PEBS_MSR_PEBS_ENABLE, 0);
+
+    //
+    // IA32_PERF_GLOBAL_CTRL (the first one) is restored last, so the guest's
+    // counters are started once all of their MSRs are restored
+    //
+    for (INT32 i = PEBS_SAMPLING_VIRTUALIZED_MSR_COUNT - 1; i >= 0; i--)
+    {
+        if (PebsSamplingIsMsrAvailable(i))
+        {
+            __writemsr(PebsSamplingVirtualizedMsrs[i], Buffer->GuestMsrs[i]);
+        }
+    }
+
+    PebsSamplingInterceptMsrs(VCpu, FALSE);
+
+    Buffer->IsEnabled = FALSE;
+}
+
+/**
+ * @brief Start, stop or drain the sampling of the current core
+ * @details should be called from vmx-root
+ *
+ * @param VCpu The virtual processor's state
+ * @param Action The action of the core
+ *
+ * @return VOID
+ */
+VOID
+PebsSamplingPerformActionOnCore(VIRTUAL_MACHINE_STATE * VCpu, PEBS_SAMPLING_CORE_ACTION Action)
+{
+    PPEBS_SAMPLING_BUFFER Buffer;
+
+    if (g_PebsSamplingBuffers == NULL)
+    {
+        return;
+    }
+
+    Buffer = &g_PebsSamplingBuffers[VCpu->CoreId];
+
+    switch (Action)
+    {
+    case PEBS_SAMPLING_CORE_ACTION_START:
+
+        if (!Buffer->IsEnabled)
+        {
+            PebsSamplingStartOnCore(VCpu, Buffer);
+        }
+
+        break;
+
+    case PEBS_SAMPLING_CORE_ACTION_STOP:
+
+        if (Buffer->IsEnabled)
+        {
+            PebsSamplingStopOnCore(VCpu, Buffer);
+        }
+
+        break;
+
+    case PEBS_SAMPLING_CORE_ACTION_DRAIN:
+
+        PebsSamplingDrainBuffer(VCpu);
+
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Emulate reading the MSRs of the sampling by the guest
+ *
+ * @param VCpu The virtual processor's state
+ * @param TargetMsr
+ * @param Value The value that the guest reads
+ *
+ * @return BOOLEAN Whether the MSR is emulated or not
+ */
+BOOLEAN
+PebsSamplingHandleRdmsr(VIRTUAL_MACHINE_STATE * VCpu, UINT32 TargetMsr, PUINT64 Value)
+{
+    UINT32 Index;
+
+    if (g_PebsSamplingBuffers == NULL || !g_PebsSamplingBuffers[VCpu->CoreId].IsEnabled ||
+        !PebsSamplingGetVirtualizedMsrIndex(TargetMsr, &Index))
+    {
+        return FALSE;
+    }
+
+    *Value = g_PebsSamplingBuffers[VCpu->CoreId].GuestMsrs[Index];
+
+    return TRUE;
+}
+
+/**
+ * @brief Emulate changing the MSRs of the sampling by the guest
+ * @details the guest's value is only saved for its next reads (and for
+ * restoring once the sampling is stopped), the guest's counters are kept
+ * in IA32_PERF_GLOBAL_CTRL
+ *
+ * @param VCpu The virtual processor's state
+ * @param TargetMsr
+ * @param Value The value that the guest writes
+ *
+ * @return BOOLEAN Whether the MSR is emulated or not
+ */
+BOOLEAN
+PebsSamplingHandleWrmsr(VIRTUAL_MACHINE_STATE * VCpu, UINT32 TargetMsr, UINT64 Value)
+{
+    UINT32 Index;
+
+    if (g_PebsSamplingBuffers == NULL || !g_PebsSamplingBuffers[VCpu->CoreId].IsEnabled ||
+        !PebsSamplingGetVirtualizedMsrIndex(TargetMsr, &Index))
+    {
+        return FALSE;
+    }
+
+    g_PebsSamplingBuffers[VCpu->CoreId].GuestMsrs[Index] = Value;
+
+    if (Index == PEBS_SAMPLING_VIRTUALIZED_MSR_PERF_GLOBAL_CTRL)
+    {
+        VmxVmwrite(VMCS_GUEST_PERF_GLOBAL_CTRL, Value | g_PebsSamplingConfiguration.CountersMask);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Free the buffers of the sampling of all cores
+ * @details should not be called while the sampling is enabled
+ *
+ * @return VOID
+ */
+static VOID
+PebsSamplingFreeBuffers()
+{
+    ULONG ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    if (g_PebsSamplingBuffers == NULL)
+    {
+        return;
+    }
+
+    for (UINT32 i = 0; i < ProcessorsCount; i++)
+    {
+        if (g_PebsSamplingBuffers[i].DsArea != NULL)
+        {
+            MmFreeContiguousMemory(g_PebsSamplingBuffers[i].DsArea);
+        }
+
+        if (g_PebsSamplingBuffers[i].PebsBuffer != NULL)
+        {
+            MmFreeContiguousMemory(g_PebsSamplingBuffers[i].PebsBuffer);
+        }
+
+        if (g_PebsSamplingBuffers[i].Table != NULL)
+        {
+            ExFreePoolWithTag(g_PebsSamplingBuffers[i].Table, POOLTAG);
+        }
+    }
+
+    ExFreePoolWithTag(g_PebsSamplingBuffers, POOLTAG);
+    g_PebsSamplingBuffers = NULL;
+}
+
+/**
+ * @brief Allocate the DS save areas, the PEBS buffers and the tables of
+ * all cores
+ * @details the DS save areas and the PEBS buffers are allocated from the
+ * NUMA node of their cores
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PebsSamplingAllocateBuffers()
+{
+    ULONG ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    g_PebsSamplingBuffers = ExAllocatePoolWithTag(NonPagedPool, sizeof(PEBS_SAMPLING_BUFFER) * ProcessorsCount, POOLTAG);
+
+    if (g_PebsSamplingBuffers == NULL)
+    {
+        return FALSE;
+    }
+
+    RtlZeroMemory(g_PebsSamplingBuffers, sizeof(PEBS_SAMPLING_BUFFER) * ProcessorsCount);
+
+    for (UINT32 i = 0; i < ProcessorsCount; i++)
+    {
+        PPEBS_SAMPLING_BUFFER Buffer = &g_PebsSamplingBuffers[i];
+
+        Buffer->DsArea     = CrsAllocateContiguousZeroedMemoryOnCore(PAGE_SIZE, i);
+        Buffer->PebsBuffer = CrsAllocateContiguousZeroedMemoryOnCore(PEBS_SAMPLING_BUFFER_SIZE, i);
+        Buffer->Table      = ExAllocatePoolWithTag(NonPagedPool, sizeof(PEBS_SAMPLING_ENTRY) * PEBS_SAMPLING_TABLE_CAPACITY, POOLTAG);
+
+        if (Buffer->DsArea == NULL || Buffer->PebsBuffer == NULL || Buffer->Table == NULL)
+        {
+            PebsSamplingFreeBuffers();
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Stop sampling on all cores
+ * @details the entries are kept to be queried
+ *
+ * @return VOID
+ */
+static VOID
+PebsSamplingStop()
+{
+    if (!g_PebsSamplingEnabled)
+    {
+        return;
+    }
+
+    g_PebsSamplingEnabled = FALSE;
+
+    if (g_CompatibilityCheck.PreemptionTimerSupport)
+    {
+        KeGenericCallDpc(DpcRoutineUpdateVmxPreemptionTimerAllCores, NULL);
+    }
+
+    //
+    // Broadcast to all cores
+    //
+    BroadcastConfigurePebsSamplingOnAllProcessors(PEBS_SAMPLING_CORE_ACTION_STOP);
+}
+
+/**
+ * @brief Start sampling on all cores
+ * @details should be called from vmx non-root (PASSIVE_LEVEL), the entries
+ * of the previous sampling are discarded
+ *
+ * @param PebsRequest
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PebsSamplingStart(PDEBUGGER_PEBS_SAMPLING_REQUEST PebsRequest)
+{
+    UINT32 SampleAfterValue = PebsRequest->SampleAfterValue != 0 ? PebsRequest->SampleAfterValue : PebsSamplingDefaultSampleAfterValue;
+    UINT32 LatencyThreshold = PebsRequest->LatencyThreshold != 0 ? PebsRequest->LatencyThreshold : PebsSamplingDefaultLatencyThreshold;
+    UINT64 PerfEvtSelModes  = PEBS_PERFEVTSEL_EN;
+    UINT64 TimerValue;
+
+    if (g_CompatibilityCheck.PebsRecordFormat == 0 ||
+        (PebsRequest->SampleStores && g_CompatibilityCheck.PebsRecordFormat < PEBS_RECORD_FORMAT_EVENTING_IP))
+    {
+        //
+        // The first format doesn't have the data address of the stores
+        //
+        PebsRequest->KernelStatus = DEBUGGER_ERROR_PEBS_IS_NOT_SUPPORTED;
+        return FALSE;
+    }
+
+    if ((!PebsRequest->SampleLoads && !PebsRequest->SampleStores) ||
+        (!PebsRequest->SampleUserMode && !PebsRequest->SampleKernelMode) ||
+        PebsRequest->StartAddress > PebsRequest->EndAddress ||
+        SampleAfterValue > MAXLONG ||
+        LatencyThreshold > MAXUINT16)
+    {
+        PebsRequest->KernelStatus = DEBUGGER_ERROR_INVALID_PEBS_CONFIGURATION;
+        return FALSE;
+    }
+
+    //
+    // The previous sampling (if any) is stopped before changing the buffers
+    //
+    PebsSamplingStop();
+
+    if (g_PebsSamplingBuffers == NULL && !PebsSamplingAllocateBuffers())
+    {
+        PebsRequest->KernelStatus = DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_PEBS_BUFFERS;
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < KeQueryActiveProcessorCount(0); i++)
+    {
+        PPEBS_SAMPLING_BUFFER Buffer = &g_PebsSamplingBuffers[i];
+
+        RtlZeroMemory(Buffer->Table, sizeof(PEBS_SAMPLING_ENTRY) * PEBS_SAMPLING_TABLE_CAPACITY);
+
+        Buffer->CountOfRecords     = 0;
+        Buffer->CountOfFilteredOut = 0;
+        Buffer->CountOfDropped     = 0;
+    }
+
+    if (PebsRequest->SampleUserMode)
+    {
+        PerfEvtSelModes |= PEBS_PERFEVTSEL_USR;
+    }
+
+    if (PebsRequest->SampleKernelMode)
+    {
+        PerfEvtSelModes |= PEBS_PERFEVTSEL_OS;
+    }
+
+    RtlZeroMemory(&g_PebsSamplingConfiguration, sizeof(PEBS_SAMPLING_CONFIGURATION));
+
+    if (PebsRequest->SampleLoads)
+    {
+        g_PebsSamplingConfiguration.PerfEvtSel[PEBS_SAMPLING_LOADS_COUNTER] = PEBS_EVENT_LOAD_LATENCY | PerfEvtSelModes;
+        g_PebsSamplingConfiguration.PebsEnable |= PEBS_ENABLE_COUNTER(PEBS_SAMPLING_LOADS_COUNTER) |
+                                                  PEBS_ENABLE_LOAD_LATENCY(PEBS_SAMPLING_LOADS_COUNTER);
+        g_PebsSamplingConfiguration.CountersMask |= 1ull << PEBS_SAMPLING_LOADS_COUNTER;
+    }
+
+    if (PebsRequest->SampleStores)
+    {
+        g_PebsSamplingConfiguration.PerfEvtSel[PEBS_SAMPLING_STORES_COUNTER] = PEBS_EVENT_ALL_STORES | PerfEvtSelModes;
+        g_PebsSamplingConfiguration.PebsEnable |= PEBS_ENABLE_COUNTER(PEBS_SAMPLING_STORES_COUNTER);
+        g_PebsSamplingConfiguration.CountersMask |= 1ull << PEBS_SAMPLING_STORES_COUNTER;
+    }
+
+    //
+    // The counters overflow (and a record is written) once in each
+    // 'SampleAfterValue' events, the writes to IA32_PMCx are sign-extended
+    // from bit 31
+    //
+    g_PebsSamplingConfiguration.CounterReset     = (UINT64)(-(INT64)SampleAfterValue) & 0xffffffffffffull;
+    g_PebsSamplingConfiguration.LatencyThreshold = LatencyThreshold;
+    g_PebsSamplingConfiguration.StartAddress     = PebsRequest->StartAddress;
+    g_PebsSamplingConfiguration.EndAddress       = PebsRequest->EndAddress;
+
+    //
+    // Broadcast to all cores
+    //
+    BroadcastConfigurePebsSamplingOnAllProcessors(PEBS_SAMPLING_CORE_ACTION_START);
+
+    g_PebsSamplingEnabled = TRUE;
+
+    //
+    // The buffers are drained once in each period of the VMX preemption
+    // timer, otherwise, they're only drained by the queries
+    //
+    if (g_CompatibilityCheck.PreemptionTimerSupport)
+    {
+        TimerValue = PEBS_SAMPLING_DRAIN_INTERVAL >> g_CompatibilityCheck.PreemptionTimerRate;
+
+        g_PebsSamplingTimerValue = TimerValue != 0 ? (UINT32)TimerValue : 1;
+
+        KeGenericCallDpc(DpcRoutineUpdateVmxPreemptionTimerAllCores, NULL);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Copy a chunk of the entries of a core to the request
+ * @details the PEBS buffers are drained before the first chunk
+ *
+ * @param PebsRequest
+ *
+ * @return VOID
+ */
+static VOID
+PebsSamplingQuery(PDEBUGGER_PEBS_SAMPLING_REQUEST PebsRequest)
+{
+    PPEBS_SAMPLING_BUFFER Buffer;
+    UINT32                Index;
+    UINT32                Count = 0;
+
+    PebsRequest->NextIndex = PEBS_SAMPLING_TABLE_CAPACITY;
+
+    if (g_PebsSamplingBuffers == NULL)
+    {
+        //
+        // The sampling is never started
+        //
+        return;
+    }
+
+    if (PebsRequest->CoreId >= KeQueryActiveProcessorCount(0))
+    {
+        PebsRequest->KernelStatus = DEBUGGER_ERROR_INVALID_CORE_ID;
+        return;
+    }
+
+    if (g_PebsSamplingEnabled && PebsRequest->StartIndex == 0)
+    {
+        BroadcastConfigurePebsSamplingOnAllProcessors(PEBS_SAMPLING_CORE_ACTION_DRAIN);
+    }
+
+    Buffer = &g_PebsSamplingBuffers[PebsRequest->CoreId];
+
+    for (Index = PebsRequest->StartIndex; Index < PEBS_SAMPLING_TABLE_CAPACITY && Count < MaximumPebsSamplingEntriesToQuery; Index++)
+    {
+        if (Buffer->Table[Index].Count != 0)
+        {
+            PebsRequest->Entries[Count] = Buffer->Table[Index];
+            Count++;
+        }
+    }
+
+    PebsRequest->NextIndex          = Index;
+    PebsRequest->CountOfEntries     = Count;
+    PebsRequest->CountOfRecords     = Buffer->CountOfRecords;
+    PebsRequest->CountOfFilteredOut = Buffer->CountOfFilteredOut;
+    PebsRequest->CountOfDropped     = Buffer->CountOfDropped;
+}
+
+/**
+ * @brief Start, stop or query the memory access sampling of PEBS
+ * @details should be called from vmx non-root (PASSIVE_LEVEL)
+ *
+ * @param PebsRequest
+ *
+ * @return VOID
+ */
+VOID
+PebsSamplingPerformAction(PDEBUGGER_PEBS_SAMPLING_REQUEST PebsRequest)
+{
+    PebsRequest->KernelStatus   = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+    PebsRequest->CountOfEntries = 0;
+
+    SpinlockLock(&g_PebsSamplingLock);
+
+    switch (PebsRequest->Action)
+    {
+    case DEBUGGER_PEBS_SAMPLING_ACTION_START:
+
+        PebsSamplingStart(PebsRequest);
+
+        break;
+
+    case DEBUGGER_PEBS_SAMPLING_ACTION_STOP:
+
+        PebsSamplingStop();
+
+        break;
+
+    case DEBUGGER_PEBS_SAMPLING_ACTION_QUERY:
+
+        PebsSamplingQuery(PebsRequest);
+
+        break;
+
+    default:
+
+        PebsRequest->KernelStatus = DEBUGGER_ERROR_INVALID_ACTION_TYPE;
+
+        break;
+    }
+
+    PebsRequest->IsEnabled     = g_PebsSamplingEnabled;
+    PebsRequest->CountOfCores  = KeQueryActiveProcessorCount(0);
+    PebsRequest->TableCapacity = PEBS_SAMPLING_TABLE_CAPACITY;
+
+    SpinlockUnlock(&g_PebsSamplingLock);
+}
+
+/**
+ * @brief Stop the sampling and free its buffers
+ * @details should be called before VMX is terminated, so the guest's
+ * values of the MSRs are restored on all cores
+ *
+ * @return VOID
+ */
+VOID
+PebsSamplingUninitialize()
+{
+    SpinlockLock(&g_PebsSamplingLock);
+
+    PebsSamplingStop();
+    PebsSamplingFreeBuffers();
+
+    SpinlockUnlock(&g_PebsSamplingLock);
+}
@@ -458,34 +458,25 @@ ReversingMachineAllocateExecuteOnlyEptPageTable()
 VOID
 ReversingMachineReadRamPhysicalRegions()
 {
-    PHYSICAL_ADDRESS       Address;
-    LONGLONG               Size;
-    UINT32                 Count                = 0;
-    PPHYSICAL_MEMORY_RANGE PhysicalMemoryRanges = NULL;
+    UINT64 Address;
+    UINT64 Size;
+    UINT32 Count = 0;
 
     //
-    // Read the RAM regions (BIOS) gives these details to Windows
+    // Read the RAM regions from the physical memory map (BIOS gives
+    // these details to Windows)
     //
-    PhysicalMemoryRanges = MmGetPhysicalMemoryRanges();
+    RtlZeroMemory(PhysicalRamRegions, sizeof(PhysicalRamRegions));
 
-    do
+    while (Count < MAX_PHYSICAL_RAM_RANGE_COUNT && PhysicalMemoryMapGetRange(Count, &Address, &Size))
     {
-        Address.QuadPart = PhysicalMemoryRanges[Count].BaseAddress.QuadPart;
-        Size             = PhysicalMemoryRanges[Count].NumberOfBytes.QuadPart;
+        // LogInfo("RAM Range, from: %llx to %llx", Address, Address + Size);
 
-        if (!Address.QuadPart && !Size)
-        {
-            break;
-        }
-
-        // LogInfo("RAM Range, from: %llx to %llx", Address.QuadPart, Address.QuadPart + Size);
-
-        PhysicalRamRegions[Count].RamPhysicalAddress = Address.QuadPart;
+        PhysicalRamRegions[Count].RamPhysicalAddress = Address;
         PhysicalRamRegions[Count].RamSize            = Size;
 
-    } while (++Count < MAX_PHYSICAL_RAM_RANGE_COUNT);
-
-    ExFreePool(PhysicalMemoryRanges);
+        Count++;
+    }
 }
 
 /**
@@ -504,11 +495,26 @@ ReversingMachineInitialize(PREVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST RevServ
     if (g_ReversingMachineInitialized)
     {
         //
-        // Already initialized
+        // Already initialized, so the process is added to the targets, the
+        // coverage only records one process
         //
-        return FALSE;
+        if (RevServiceRequest->Type == REVERSING_MACHINE_RECONSTRUCT_MEMORY_TYPE_COVERAGE ||
+            g_ReversingMachineCoverageEnabled ||
+            !ReversingMachineTargetsAdd(RevServiceRequest->ProcessId))
+        {
+            RevServiceRequest->KernelStatus = DEBUGGER_ERROR_REVERSING_MACHINE_UNABLE_TO_ADD_TARGET;
+            return FALSE;
+        }
+
+        RevServiceRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+        return TRUE;
     }
 
+    //
+    // The EPT views of the CR3s are built on the next MOV to CR3 vm-exits
+    //
+    ReversingMachineInvalidateCr3Views();
+
     //
     // Read the RAM regions
     //
@@ -536,6 +542,28 @@ ReversingMachineInitialize(PREVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST RevServ
         return FALSE;
     }
 
+    //
+    // Add the first target process
+    //
+    if (!ReversingMachineTargetsAdd(RevServiceRequest->ProcessId))
+    {
+        RevServiceRequest->KernelStatus = DEBUGGER_ERROR_REVERSING_MACHINE_UNABLE_TO_ADD_TARGET;
+        return FALSE;
+    }
+
+    //
+    // The coverage only uses the MBEC EPT page-table
+    //
+    if (RevServiceRequest->Type == REVERSING_MACHINE_RECONSTRUCT_MEMORY_TYPE_COVERAGE &&
+        !ReversingMachineCoverageInitialize(g_EptState->ModeBasedEptPageTable,
+                                            RevServiceRequest->ProcessId,
+                                            RevServiceRequest->Form == REVERSING_MACHINE_RECONSTRUCT_MEMORY_FORM_BASIC_BLOCK_COVERAGE))
+    {
+        ReversingMachineTargetsRemoveAll();
+        RevServiceRequest->KernelStatus = DEBUGGER_ERROR_REVERSING_MACHINE_COVERAGE_IS_NOT_AVAILABLE;
+        return FALSE;
+    }
+
     //
     // Call the function responsible for initializing Mode-based hooks
     //
@@ -544,6 +572,14 @@ ReversingMachineInitialize(PREVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST RevServ
         //
         // The initialization was not successfull
         //
+        if (g_ReversingMachineCoverageEnabled)
+        {
+            ReversingMachineCoverageUninitialize();
+            RevServiceRequest->KernelStatus = DEBUGGER_ERROR_REVERSING_MACHINE_COVERAGE_IS_NOT_AVAILABLE;
+        }
+
+        ReversingMachineTargetsRemoveAll();
+
         return FALSE;
     }
 
@@ -567,6 +603,11 @@ ReversingMachineInitialize(PREVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST RevServ
     //
     g_ReversingMachineInitialized = TRUE;
 
+    //
+    // All of the mov-to-cr3s are needed by the reversing machine
+    //
+    VmexitFastPathUpdate();
+
     return TRUE;
 }
 
@@ -584,6 +625,8 @@ ReversingMachineUninitialize()
     //
     g_ReversingMachineInitialized = FALSE;
 
+    VmexitFastPathUpdate();
+
     //
     // Disable MOV to CR3 exiting
     //
@@ -594,11 +637,26 @@ ReversingMachineUninitialize()
     //
     BroadcastRestoreToNormalEptpOnAllProcessors();
 
+    //
+    // The views are not used anymore
+    //
+    ReversingMachineInvalidateCr3Views();
+
+    //
+    // Remove the targets (their rings are freed once they're unmapped)
+    //
+    ReversingMachineTargetsRemoveAll();
+
     //
     // Uninitialize the mode-based execution controls
     //
     ModeBasedExecHookUninitialize();
 
+    //
+    // Free the buffers of the coverage (its splits point to the MBEC page table)
+    //
+    ReversingMachineCoverageUninitialize();
+
     //
     // Free Identity Page Table for MBEC hooks
     //
@@ -628,7 +686,7 @@ ReversingMachineRestoreToNormalEptp(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // Change EPTP
     //
-    __vmx_vmwrite(VMCS_CTRL_EPT_POINTER, g_EptState->EptPointer.AsUInt);
+    VmxVmwrite(VMCS_CTRL_EPT_POINTER, g_EptState->EptPointer.AsUInt);
 
     //
     // It's on normal EPTP
@@ -648,7 +706,7 @@ ReversingMachineChangeToExecuteOnlyEptp(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // Change EPTP
     //
-    __vmx_vmwrite(VMCS_CTRL_EPT_POINTER, g_EptState->ExecuteOnlyEptPointer.AsUInt);
+    VmxVmwrite(VMCS_CTRL_EPT_POINTER, g_EptState->ExecuteOnlyEptPointer.AsUInt);
 
     //
     // It's not on normal EPTP
@@ -668,7 +726,7 @@ ReversingMachineChangeToMbecEnabledEptp(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // Change EPTP
     //
-    __vmx_vmwrite(VMCS_CTRL_EPT_POINTER, g_EptState->ModeBasedEptPointer.AsUInt);
+    VmxVmwrite(VMCS_CTRL_EPT_POINTER, g_EptState->ModeBasedEptPointer.AsUInt);
 
     //
     // It's not on normal EPTP
@@ -689,6 +747,8 @@ ReversingMachineHandleEptViolationVmexit(VIRTUAL_MACHINE_STATE *
                                          VMX_EXIT_QUALIFICATION_EPT_VIOLATION * ViolationQualification,
                                          UINT64                                 GuestPhysicalAddr)
 {
+    PREVERSING_MACHINE_TARGET Target;
+
     //
     // Check if this mechanism is use or not
     //
@@ -697,6 +757,14 @@ ReversingMachineHandleEptViolationVmexit(VIRTUAL_MACHINE_STATE *
         return FALSE;
     }
 
+    //
+    // The coverage doesn't change to the execute-only EPTP
+    //
+    if (g_ReversingMachineCoverageEnabled)
+    {
+        return ReversingMachineCoverageHandleEptViolation(VCpu, ViolationQualification, GuestPhysicalAddr);
+    }
+
     if (!ViolationQualification->EptReadable || !ViolationQualification->EptWriteable)
     {
         //
@@ -741,6 +809,16 @@ ReversingMachineHandleEptViolationVmexit(VIRTUAL_MACHINE_STATE *
             //
             HvSetModeBasedExecutionEnableFlag(FALSE);
 
+            //
+            // Save the access into the results ring of the process
+            //
+            Target = ReversingMachineTargetsFind(HandleToUlong(PsGetCurrentProcessId()));
+
+            if (Target != NULL)
+            {
+                ReversingMachineTargetsSaveResult(VCpu, Target, GuestPhysicalAddr);
+            }
+
             //
             // Disassemble instructions
             //
@@ -802,12 +880,21 @@ ReversingMachineHandleEptViolationVmexit(VIRTUAL_MACHINE_STATE *
 VOID
 ReversingMachineHandleMtfCallback(VIRTUAL_MACHINE_STATE * VCpu)
 {
+    if (g_ReversingMachineCoverageEnabled)
+    {
+        //
+        // Walking the basic blocks of the coverage
+        //
+        ReversingMachineCoverageHandleMtf(VCpu);
+        return;
+    }
+
     if (VCpu->TestNumber != 1000000)
     {
         //
         // Check for re-enabling external interrupts
         //
-        if (VCpu->PendingExternalInterrupts[0] != NULL)
+        if (IdtEmulationIsAnyExternalInterruptPending(VCpu))
         {
             //
             // Restore to normal state for current process
@@ -872,8 +959,104 @@ ReversingMachineRestoreNormalStateOnTargetProcess(VIRTUAL_MACHINE_STATE * VCpu)
     HvWriteExceptionBitmap(0x0);
 }
 
+/**
+ * @brief Invalidate the cached EPT views of the CR3s
+ * @details should be called from vmx non-root mode while the MOV to CR3
+ * vm-exits are not handled by the reversing machine (or the target is changed)
+ *
+ * @return VOID
+ */
+VOID
+ReversingMachineInvalidateCr3Views()
+{
+    RtlZeroMemory(g_ReversingMachineCr3Views, sizeof(g_ReversingMachineCr3Views));
+}
+
+/**
+ * @brief Build the EPT view of a CR3
+ *
+ * @param View
+ * @param ProcessId The process that the CR3 belongs to
+ * @param Generation The current generation of the targets
+ *
+ * @return VOID
+ */
+static VOID
+ReversingMachineBuildCr3View(PREVERSING_MACHINE_CR3_VIEW View, UINT32 ProcessId, LONG Generation)
+{
+    View->ProcessId  = ProcessId;
+    View->Generation = Generation;
+    View->Target     = ReversingMachineTargetsFind(ProcessId);
+
+    //
+    // Other processes are not intercepted, so they use the normal EPTP
+    // (the EPT hooks are only applied on it)
+    //
+    View->EptPointer = View->Target != NULL ? g_EptState->ModeBasedEptPointer.AsUInt : g_EptState->EptPointer.AsUInt;
+}
+
+/**
+ * @brief Find (or build) the EPT view of a CR3
+ * @details lock-free, should be called from vmx-root mode, the processes
+ * are checked as a CR3 might be reused once its process is terminated, and
+ * the views are rebuilt once the targets are changed
+ *
+ * @param NewCr3 The new cr3
+ * @param ProcessId The current process
+ *
+ * @return PREVERSING_MACHINE_CR3_VIEW The view or NULL if the cache is full
+ */
+static PREVERSING_MACHINE_CR3_VIEW
+ReversingMachineGetCr3View(UINT64 NewCr3, UINT32 ProcessId)
+{
+    CR3_TYPE                    Cr3 = {.Flags = NewCr3};
+    UINT64                      Key = Cr3.Fields.PageFrameNumber;
+    UINT32                      Index;
+    PREVERSING_MACHINE_CR3_VIEW View;
+    LONG                        Generation = g_ReversingMachineCr3ViewsGeneration;
+
+    //
+    // Fibonacci hashing of the page frame number
+    //
+    Index = (UINT32)((Key * 0x9E3779B97F4A7C15ULL) >> 32) & (REVERSING_MACHINE_CR3_VIEWS_COUNT - 1);
+
+    for (UINT32 i = 0; i < REVERSING_MACHINE_CR3_VIEWS_COUNT; i++)
+    {
+        View = &g_ReversingMachineCr3Views[Index];
+
+        if (View->Cr3 == Key)
+        {
+            if (View->ProcessId != ProcessId || View->Generation != Generation)
+            {
+                ReversingMachineBuildCr3View(View, ProcessId, Generation);
+            }
+
+            return View;
+        }
+
+        if (View->Cr3 == 0 && InterlockedCompareExchange(&View->IsClaimed, TRUE, FALSE) == FALSE)
+        {
+            //
+            // The view is visible to the lookups once it's built (two cores might
+            // build two views of the same CR3, the second one is never used)
+            //
+            ReversingMachineBuildCr3View(View, ProcessId, Generation);
+            InterlockedExchange64((volatile LONG64 *)&View->Cr3, Key);
+
+            return View;
+        }
+
+        Index = (Index + 1) & (REVERSING_MACHINE_CR3_VIEWS_COUNT - 1);
+    }
+
+    return NULL;
+}
+
 /**
  * @brief Handle MOV to CR3 vm-exits for hooking mode execution
+ * @details the EPT view of the CR3 is prebuilt, so the vm-exit only
+ * writes the EPTP of the view and the MBEC control
+ *
  * @param VCpu The virtual processor's state
  * @param NewCr3 New cr3
  *
@@ -882,7 +1065,36 @@ ReversingMachineRestoreNormalStateOnTargetProcess(VIRTUAL_MACHINE_STATE * VCpu)
 VOID
 ReversingMachineHandleCr3Vmexit(VIRTUAL_MACHINE_STATE * VCpu, UINT64 NewCr3)
 {
-    if (PsGetCurrentProcessId() == 10344 && VCpu->Test == FALSE)
+    PREVERSING_MACHINE_CR3_VIEW View;
+    UINT32                      ProcessId = HandleToUlong(PsGetCurrentProcessId());
+    BOOLEAN                     IsTargetProcess;
+
+    View = ReversingMachineGetCr3View(NewCr3, ProcessId);
+
+    if (View != NULL)
+    {
+        IsTargetProcess = View->Target != NULL;
+        VmxVmwrite(VMCS_CTRL_EPT_POINTER, View->EptPointer);
+    }
+    else
+    {
+        //
+        // The cache is full, the view is not cached
+        //
+        IsTargetProcess = ReversingMachineTargetsFind(ProcessId) != NULL;
+        VmxVmwrite(VMCS_CTRL_EPT_POINTER, IsTargetProcess ? g_EptState->ModeBasedEptPointer.AsUInt : g_EptState->EptPointer.AsUInt);
+    }
+
+    VCpu->NotNormalEptp = IsTargetProcess;
+
+    if (g_ReversingMachineCoverageEnabled)
+    {
+        //
+        // The pages are only armed while the target process is running
+        //
+        HvSetModeBasedExecutionEnableFlag(IsTargetProcess);
+    }
+    else if (IsTargetProcess && VCpu->Test == FALSE)
     {
         //
         // Enable MBEC to detect execution in user-mode
@@ -0,0 +1,482 @@
+/**
+ * @file ReversingMachineCoverage.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The coverage of the reversing machine
+ * @details the user-mode execute bit of all of the pages of the MBEC EPT table
+ * is unset and the MBEC view is only used while the target process is running, so the
+ * first execution of each page in the user-mode causes an EPT violation, the page
+ * is marked in a bitmap, recorded (or its basic blocks are found by stepping a few
+ * instructions) and the execute bit of the page is set again, so each page only
+ * causes one vm-exit
+ *
+ * @version 0.4
+ * @date 2023-08-08
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Initialize the coverage of the target process
+ * @details should be called from vmx non-root mode, before the cores are
+ * changed to the MBEC EPT table
+ *
+ * @param EptTable The MBEC EPT table
+ * @param ProcessId The process that its coverage is recorded
+ * @param BasicBlocks Whether the basic blocks or the pages are recorded
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+ReversingMachineCoverageInitialize(PVMM_EPT_PAGE_TABLE EptTable, UINT32 ProcessId, BOOLEAN BasicBlocks)
+{
+    UINT64 EndAddress = 0;
+    SIZE_T BitmapSize;
+
+    if (ProcessId == 0)
+    {
+        return FALSE;
+    }
+
+    //
+    // The RAM regions are read by the reversing machine
+    //
+    for (UINT32 i = 0; i < MAX_PHYSICAL_RAM_RANGE_COUNT; i++)
+    {
+        EndAddress = max(EndAddress, PhysicalRamRegions[i].RamPhysicalAddress + PhysicalRamRegions[i].RamSize);
+    }
+
+    if (EndAddress == 0 || EndAddress > (UINT64)VMM_EPT_PML3E_COUNT * VMM_EPT_PML2E_COUNT * SIZE_2_MB)
+    {
+        EndAddress = (UINT64)VMM_EPT_PML3E_COUNT * VMM_EPT_PML2E_COUNT * SIZE_2_MB;
+    }
+
+    EndAddress = (EndAddress + SIZE_2_MB - 1) & ~(SIZE_2_MB - 1);
+    BitmapSize = (SIZE_T)(EndAddress / PAGE_SIZE / 8);
+
+    g_ReversingMachineCoverageBitmap = ExAllocatePoolWithTag(NonPagedPool, BitmapSize, POOLTAG);
+
+    if (g_ReversingMachineCoverageBitmap == NULL)
+    {
+        return FALSE;
+    }
+
+    g_ReversingMachineCoverageRecords = ExAllocatePoolWithTag(NonPagedPool,
+                                                              REVERSING_MACHINE_COVERAGE_MAXIMUM_RECORDS * sizeof(REVERSING_MACHINE_COVERAGE_RECORD),
+                                                              POOLTAG);
+
+    if (g_ReversingMachineCoverageRecords == NULL)
+    {
+        ExFreePoolWithTag(g_ReversingMachineCoverageBitmap, POOLTAG);
+        g_ReversingMachineCoverageBitmap = NULL;
+
+        return FALSE;
+    }
+
+    RtlZeroMemory(g_ReversingMachineCoverageBitmap, BitmapSize);
+    RtlZeroMemory(g_ReversingMachineCoverageRecords, REVERSING_MACHINE_COVERAGE_MAXIMUM_RECORDS * sizeof(REVERSING_MACHINE_COVERAGE_RECORD));
+
+    InitializeListHead(&g_ReversingMachineCoverageSplitsList);
+
+    g_ReversingMachineCoverageProcessId      = ProcessId;
+    g_ReversingMachineCoverageEndAddress     = EndAddress;
+    g_ReversingMachineCoverageCountOfRecords = 0;
+    g_ReversingMachineCoverageBasicBlocks    = BasicBlocks;
+
+    //
+    // Unlike the other MBEC hooks, the user-mode execution is intercepted
+    // at the 2MB entries, so each page can be disarmed separately
+    //
+    for (size_t i = 0; i < VMM_EPT_PML4E_COUNT; i++)
+    {
+        EptTable->PML4[i].UserModeExecute = TRUE;
+    }
+
+    EptSplitAllPml3LargePages(EptTable);
+
+    for (size_t i = 0; i < VMM_EPT_PML3E_COUNT; i++)
+    {
+        EptTable->PML3[i].UserModeExecute = TRUE;
+    }
+
+    for (size_t i = 0; i < VMM_EPT_PML3E_COUNT; i++)
+    {
+        for (size_t j = 0; j < VMM_EPT_PML2E_COUNT; j++)
+        {
+            EptTable->PML2[i][j].UserModeExecute = FALSE;
+        }
+    }
+
+    //
+    // The 2MB pages are split in vmx-root once their first page is executed,
+    // allocate the buffers here as we're in PASSIVE_LEVEL
+    //
+    PoolManagerRequestAllocation(sizeof(VMM_EPT_DYNAMIC_SPLIT),
+                                 REVERSING_MACHINE_COVERAGE_PREALLOCATED_SPLITS,
+                                 SPLIT_2MB_PAGING_TO_4KB_PAGE);
+    PoolManagerCheckAndPerformAllocationAndDeallocation();
+
+    g_ReversingMachineCoverageEnabled = TRUE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Uninitialize the coverage
+ * @details should be called from vmx non-root mode, after the cores are
+ * restored to the normal EPT table and before the MBEC EPT table is freed
+ *
+ * @return VOID
+ */
+VOID
+ReversingMachineCoverageUninitialize()
+{
+    PLIST_ENTRY            Entry;
+    PVMM_EPT_DYNAMIC_SPLIT Split;
+
+    if (!g_ReversingMachineCoverageEnabled)
+    {
+        return;
+    }
+
+    g_ReversingMachineCoverageEnabled = FALSE;
+
+    while (!IsListEmpty(&g_ReversingMachineCoverageSplitsList))
+    {
+        Entry = RemoveHeadList(&g_ReversingMachineCoverageSplitsList);
+        Split = CONTAINING_RECORD(Entry, VMM_EPT_DYNAMIC_SPLIT, DynamicSplitList);
+
+        PoolManagerFreePool((UINT64)Split);
+    }
+
+    ExFreePoolWithTag(g_ReversingMachineCoverageRecords, POOLTAG);
+    g_ReversingMachineCoverageRecords = NULL;
+
+    ExFreePoolWithTag(g_ReversingMachineCoverageBitmap, POOLTAG);
+    g_ReversingMachineCoverageBitmap = NULL;
+}
+
+/**
+ * @brief Add a record (an executed page or basic block) to the coverage
+ * @details the records that don't fit in the buffer are only counted
+ *
+ * @param Address
+ * @param Size
+ *
+ * @return VOID
+ */
+static VOID
+ReversingMachineCoverageAddRecord(UINT64 Address, UINT32 Size)
+{
+    LONG Index = InterlockedIncrement(&g_ReversingMachineCoverageCountOfRecords) - 1;
+
+    if (Index >= REVERSING_MACHINE_COVERAGE_MAXIMUM_RECORDS)
+    {
+        return;
+    }
+
+    g_ReversingMachineCoverageRecords[Index].Size    = Size;
+    g_ReversingMachineCoverageRecords[Index].Address = Address;
+}
+
+/**
+ * @brief Set the user-mode execute bit of a page of the MBEC EPT table
+ * @details should be called from vmx-root mode, the 2MB page is split on
+ * its first execution, the split is kept away from the list of the dynamic
+ * splits as the MBEC EPT table should not be merged by the EPT hooks
+ *
+ * @param PhysicalAddress
+ *
+ * @return VOID
+ */
+static VOID
+ReversingMachineCoverageDisarmPage(UINT64 PhysicalAddress)
+{
+    PVMM_EPT_PAGE_TABLE    EptTable = g_EptState->ModeBasedEptPageTable;
+    PEPT_PML2_ENTRY        Pml2Entry;
+    PEPT_PML1_ENTRY        Pml1Entry;
+    PVMM_EPT_DYNAMIC_SPLIT Split;
+
+    Pml2Entry = EptGetPml2Entry(EptTable, PhysicalAddress);
+
+    if (Pml2Entry == NULL)
+    {
+        return;
+    }
+
+    SpinlockLock(&g_ReversingMachineCoverageLock);
+
+    if (Pml2Entry->LargePage)
+    {
+        Split = (PVMM_EPT_DYNAMIC_SPLIT)PoolManagerRequestPool(SPLIT_2MB_PAGING_TO_4KB_PAGE, TRUE, sizeof(VMM_EPT_DYNAMIC_SPLIT));
+
+        if (Split != NULL && EptSplitLargePage(EptTable, Split, PhysicalAddress))
+        {
+            SpinlockLock(&EptDynamicSplitsListLock);
+            RemoveEntryList(&Split->DynamicSplitList);
+            SpinlockUnlock(&EptDynamicSplitsListLock);
+
+            InsertHeadList(&g_ReversingMachineCoverageSplitsList, &Split->DynamicSplitList);
+
+            //
+            // The other 4KB pages of the 2MB page are not executed yet
+            //
+            for (UINT32 i = 0; i < VMM_EPT_PML1E_COUNT; i++)
+            {
+                Split->PML1[i].UserModeExecute = FALSE;
+            }
+        }
+        else
+        {
+            if (Split != NULL)
+            {
+                PoolManagerFreePool((UINT64)Split);
+            }
+
+            //
+            // There is no buffer for splitting the page, so the entire 2MB page
+            // is disarmed (its other pages are not recorded)
+            //
+            Pml2Entry->UserModeExecute = TRUE;
+        }
+    }
+
+    if (!Pml2Entry->LargePage)
+    {
+        Pml1Entry = EptGetPml1Entry(EptTable, PhysicalAddress);
+
+        if (Pml1Entry != NULL)
+        {
+            Pml1Entry->UserModeExecute = TRUE;
+        }
+    }
+
+    SpinlockUnlock(&g_ReversingMachineCoverageLock);
+}
+
+/**
+ * @brief Stop the walk of the basic blocks on the current core
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+static VOID
+ReversingMachineCoverageStopWalk(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    VCpu->CoverageWalkRemainingSteps  = 0;
+    VCpu->RestoreNonReadableWriteEptp = FALSE;
+
+    //
+    // MTF is unset by the MTF handler
+    //
+    HvEnableAndCheckForPreviousExternalInterrupts(VCpu);
+}
+
+/**
+ * @brief Find the next sequential instruction of the walk
+ *
+ * @param VCpu The virtual processor's state
+ * @param Rip The current instruction
+ *
+ * @return BOOLEAN FALSE if the walk should be stopped
+ */
+static BOOLEAN
+ReversingMachineCoverageStepWalk(VIRTUAL_MACHINE_STATE * VCpu, UINT64 Rip)
+{
+    UINT32 Length;
+
+    //
+    // The walk is only in the user-mode of the target process
+    //
+    if (Rip & 0xff00000000000000)
+    {
+        return FALSE;
+    }
+
+    Length = DisassemblerLengthDisassembleEngineInVmxRootOnTargetProcess((PVOID)Rip, CommonIsGuestOnUsermode32Bit());
+
+    if (Length == 0)
+    {
+        return FALSE;
+    }
+
+    VCpu->CoverageWalkNextRip = Rip + Length;
+
+    return TRUE;
+}
+
+/**
+ * @brief Handle EPT violations of the first execution of the pages
+ * @details should be called from vmx-root mode
+ *
+ * @param VCpu The virtual processor's state
+ * @param ViolationQualification
+ * @param GuestPhysicalAddr
+ *
+ * @return BOOLEAN Whether the violation is handled
+ */
+BOOLEAN
+ReversingMachineCoverageHandleEptViolation(VIRTUAL_MACHINE_STATE *                VCpu,
+                                           VMX_EXIT_QUALIFICATION_EPT_VIOLATION * ViolationQualification,
+                                           UINT64                                 GuestPhysicalAddr)
+{
+    UINT64 PageNumber     = GuestPhysicalAddr / PAGE_SIZE;
+    UINT64 VirtualAddress = VCpu->LastVmexitRip;
+
+    if (!g_ReversingMachineCoverageEnabled)
+    {
+        return FALSE;
+    }
+
+    //
+    // Only the user-mode execution is intercepted
+    //
+    if (!ViolationQualification->ExecuteAccess || ViolationQualification->EptExecutableForUserMode)
+    {
+        return FALSE;
+    }
+
+    //
+    // The instruction might cross the page, so the fetched address is used
+    //
+    if (ViolationQualification->ValidGuestLinearAddress)
+    {
+        VmxVmread(VMCS_EXIT_GUEST_LINEAR_ADDRESS, &VirtualAddress);
+    }
+
+    //
+    // Other cores might also fault on the page before their TLBs are
+    // invalidated, the page is only recorded once
+    //
+    if (GuestPhysicalAddr < g_ReversingMachineCoverageEndAddress &&
+        !InterlockedBitTestAndSet64((volatile LONG64 *)&g_ReversingMachineCoverageBitmap[PageNumber / 64], PageNumber % 64))
+    {
+        if (!g_ReversingMachineCoverageBasicBlocks)
+        {
+            ReversingMachineCoverageAddRecord((UINT64)PAGE_ALIGN(VirtualAddress), PAGE_SIZE);
+        }
+        else if (VCpu->CoverageWalkRemainingSteps == 0 &&
+                 ReversingMachineCoverageStepWalk(VCpu, VCpu->LastVmexitRip))
+        {
+            //
+            // Step the next instructions to find the basic blocks, if the walk
+            // is already started, it also records the blocks of this page
+            //
+            VCpu->CoverageWalkRemainingSteps = REVERSING_MACHINE_COVERAGE_BASIC_BLOCK_WALK_STEPS;
+            VCpu->CoverageWalkBlockStart     = VCpu->LastVmexitRip;
+
+            HvEnableMtfAndChangeExternalInterruptState(VCpu);
+
+            VCpu->RestoreNonReadableWriteEptp = TRUE;
+        }
+    }
+
+    ReversingMachineCoverageDisarmPage(GuestPhysicalAddr);
+
+    EptInveptSingleContext(g_EptState->ModeBasedEptPointer.AsUInt);
+
+    //
+    // Redo the instruction
+    //
+    HvSuppressRipIncrement(VCpu);
+
+    return TRUE;
+}
+
+/**
+ * @brief Handle MTFs of the walk of the basic blocks
+ * @details a basic block ends once the next instruction is not the
+ * sequential instruction, the fall-through of the conditional jumps
+ * is considered as the same block
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+VOID
+ReversingMachineCoverageHandleMtf(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    UINT64 Rip = VCpu->LastVmexitRip;
+
+    if (VCpu->CoverageWalkRemainingSteps == 0)
+    {
+        VCpu->RestoreNonReadableWriteEptp = FALSE;
+        return;
+    }
+
+    if (Rip != VCpu->CoverageWalkNextRip)
+    {
+        ReversingMachineCoverageAddRecord(VCpu->CoverageWalkBlockStart,
+                                          (UINT32)(VCpu->CoverageWalkNextRip - VCpu->CoverageWalkBlockStart));
+
+        VCpu->CoverageWalkBlockStart = Rip;
+    }
+
+    VCpu->CoverageWalkRemainingSteps--;
+
+    if (VCpu->CoverageWalkRemainingSteps == 0 || !ReversingMachineCoverageStepWalk(VCpu, Rip))
+    {
+        //
+        // The current block is not finished yet
+        //
+        if (VCpu->CoverageWalkBlockStart != Rip)
+        {
+            ReversingMachineCoverageAddRecord(VCpu->CoverageWalkBlockStart,
+                                              (UINT32)(Rip - VCpu->CoverageWalkBlockStart));
+        }
+
+        ReversingMachineCoverageStopWalk(VCpu);
+        return;
+    }
+
+    //
+    // Step the next instruction
+    //
+    VCpu->IgnoreMtfUnset = TRUE;
+}
+
+/**
+ * @brief Query the records of the coverage
+ * @details should be called from vmx non-root mode
+ *
+ * @param CoverageRequest
+ *
+ * @return VOID
+ */
+VOID
+ReversingMachineCoverageQuery(PREVERSING_MACHINE_QUERY_COVERAGE CoverageRequest)
+{
+    UINT32 TotalCount;
+
+    if (!g_ReversingMachineCoverageEnabled)
+    {
+        CoverageRequest->KernelStatus = DEBUGGER_ERROR_REVERSING_MACHINE_COVERAGE_IS_NOT_ENABLED;
+        return;
+    }
+
+    TotalCount = (UINT32)g_ReversingMachineCoverageCountOfRecords;
+
+    CoverageRequest->ProcessId            = g_ReversingMachineCoverageProcessId;
+    CoverageRequest->IsBasicBlockCoverage = g_ReversingMachineCoverageBasicBlocks;
+    CoverageRequest->TotalCountOfRecords  = min(TotalCount, REVERSING_MACHINE_COVERAGE_MAXIMUM_RECORDS);
+    CoverageRequest->CountOfLostRecords   = TotalCount - CoverageRequest->TotalCountOfRecords;
+    CoverageRequest->CountOfRecords       = 0;
+
+    if (CoverageRequest->StartIndex < CoverageRequest->TotalCountOfRecords)
+    {
+        CoverageRequest->CountOfRecords = min(CoverageRequest->TotalCountOfRecords - CoverageRequest->StartIndex,
+                                              MaximumReversingMachineCoverageRecordsToQuery);
+
+        //
+        // The records are only appended, a record that is reserved but not
+        // written yet is zero
+        //
+        RtlCopyMemory(CoverageRequest->Records,
+                      &g_ReversingMachineCoverageRecords[CoverageRequest->StartIndex],
+                      CoverageRequest->CountOfRecords * sizeof(REVERSING_MACHINE_COVERAGE_RECORD));
+    }
+
+    CoverageRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+}
@@ -0,0 +1,340 @@
+/**
+ * @file ReversingMachineTargets.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The target processes of the reversing machine
+ * @details each target process has its own results ring, the rings are
+ * filled in vmx-root mode and they're mapped read-only into the consumers
+ * (e.g., hprdbgrev), so the results are read without sending IOCTLs
+ *
+ * @version 0.4
+ * @date 2023-08-10
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Add a process to the targets of the reversing machine
+ * @details should be called from vmx non-root mode
+ *
+ * @param ProcessId
+ *
+ * @return BOOLEAN FALSE if the process is already a target, the maximum
+ * count of the targets is reached or the ring couldn't be allocated
+ */
+BOOLEAN
+ReversingMachineTargetsAdd(UINT32 ProcessId)
+{
+    PREVERSING_MACHINE_RESULTS_RING Ring;
+    PREVERSING_MACHINE_TARGET       FreeTarget = NULL;
+
+    if (ProcessId == 0)
+    {
+        return FALSE;
+    }
+
+    //
+    // The ring is allocated before acquiring the lock as we're in PASSIVE_LEVEL
+    //
+    Ring = ExAllocatePoolWithTag(NonPagedPool, sizeof(REVERSING_MACHINE_RESULTS_RING), POOLTAG);
+
+    if (Ring == NULL)
+    {
+        return FALSE;
+    }
+
+    RtlZeroMemory(Ring, sizeof(REVERSING_MACHINE_RESULTS_RING));
+
+    Ring->ProcessId = ProcessId;
+    Ring->Capacity  = ReversingMachineResultsRingCapacity;
+
+    SpinlockLock(&g_ReversingMachineTargetsLock);
+
+    for (UINT32 i = 0; i < MaximumReversingMachineTargets; i++)
+    {
+        if (g_ReversingMachineTargets[i].ProcessId == ProcessId)
+        {
+            //
+            // The process is already a target
+            //
+            FreeTarget = NULL;
+            break;
+        }
+
+        if (FreeTarget == NULL && g_ReversingMachineTargets[i].ProcessId == 0 && g_ReversingMachineTargets[i].Ring == NULL)
+        {
+            FreeTarget = &g_ReversingMachineTargets[i];
+        }
+    }
+
+    if (FreeTarget != NULL)
+    {
+        FreeTarget->Ring = Ring;
+
+        //
+        // The process is visible to the vm-exit handlers once its ring is set
+        //
+        InterlockedExchange((volatile LONG *)&FreeTarget->ProcessId, ProcessId);
+
+        //
+        // The views of the CR3s of the process might be built before
+        //
+        InterlockedIncrement(&g_ReversingMachineCr3ViewsGeneration);
+    }
+
+    SpinlockUnlock(&g_ReversingMachineTargetsLock);
+
+    if (FreeTarget == NULL)
+    {
+        ExFreePoolWithTag(Ring, POOLTAG);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Remove all of the targets of the reversing machine
+ * @details should be called from vmx non-root mode, once the cores are restored
+ * to the normal EPTP, the rings that are mapped into a process are freed once
+ * they're unmapped
+ *
+ * @return VOID
+ */
+VOID
+ReversingMachineTargetsRemoveAll()
+{
+    SpinlockLock(&g_ReversingMachineTargetsLock);
+
+    for (UINT32 i = 0; i < MaximumReversingMachineTargets; i++)
+    {
+        g_ReversingMachineTargets[i].ProcessId = 0;
+
+        if (g_ReversingMachineTargets[i].Ring != NULL && g_ReversingMachineTargets[i].RingMdl == NULL)
+        {
+            ExFreePoolWithTag(g_ReversingMachineTargets[i].Ring, POOLTAG);
+            g_ReversingMachineTargets[i].Ring = NULL;
+        }
+    }
+
+    SpinlockUnlock(&g_ReversingMachineTargetsLock);
+}
+
+/**
+ * @brief Find the target of a process
+ * @details could be called from both vmx-root and vmx non-root mode
+ *
+ * @param ProcessId
+ *
+ * @return PREVERSING_MACHINE_TARGET The target or NULL if the process is
+ * not a target
+ */
+PREVERSING_MACHINE_TARGET
+ReversingMachineTargetsFind(UINT32 ProcessId)
+{
+    if (ProcessId == 0)
+    {
+        return NULL;
+    }
+
+    for (UINT32 i = 0; i < MaximumReversingMachineTargets; i++)
+    {
+        if (g_ReversingMachineTargets[i].ProcessId == ProcessId)
+        {
+            return &g_ReversingMachineTargets[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Save a result into the results ring of a target
+ * @details should be called from vmx-root mode, the result is saved
+ * without waiting for the consumer (the oldest result is overwritten)
+ *
+ * @param VCpu The virtual processor's state
+ * @param Target
+ * @param GuestPhysicalAddress The accessed physical address
+ *
+ * @return VOID
+ */
+VOID
+ReversingMachineTargetsSaveResult(VIRTUAL_MACHINE_STATE *   VCpu,
+                                  PREVERSING_MACHINE_TARGET Target,
+                                  UINT64                    GuestPhysicalAddress)
+{
+    PREVERSING_MACHINE_RESULTS_RING Ring = Target->Ring;
+    PREVERSING_MACHINE_RESULT       Result;
+    UINT64                          Index;
+
+    if (Ring == NULL)
+    {
+        return;
+    }
+
+    Index  = InterlockedIncrement64((volatile LONG64 *)&Ring->CurrentIndexToWrite) - 1;
+    Result = &Ring->Results[Index & (ReversingMachineResultsRingCapacity - 1)];
+
+    //
+    // The consumer ignores the result while it's written
+    //
+    InterlockedExchange64((volatile LONG64 *)&Result->Sequence, 0);
+
+    Result->Tsc                  = __rdtsc();
+    Result->GuestRip             = VCpu->LastVmexitRip;
+    Result->GuestPhysicalAddress = GuestPhysicalAddress;
+    Result->ThreadId             = HandleToUlong(PsGetCurrentThreadId());
+    Result->CoreId               = VCpu->CoreId;
+
+    InterlockedExchange64((volatile LONG64 *)&Result->Sequence, Index + 1);
+}
+
+/**
+ * @brief Unmap the results ring of a target
+ * @details should be called in the context of the process that the ring
+ * is mapped into while the lock of the targets is held, the ring is freed
+ * if the target is already removed
+ *
+ * @param Target
+ *
+ * @return VOID
+ */
+static VOID
+ReversingMachineTargetsUnmapRing(PREVERSING_MACHINE_TARGET Target)
+{
+    MmUnmapLockedPages(Target->RingUsermodeAddress, Target->RingMdl);
+    IoFreeMdl(Target->RingMdl);
+
+    Target->RingMdl             = NULL;
+    Target->RingUsermodeAddress = NULL;
+    Target->RingMappedProcess   = NULL;
+
+    if (Target->ProcessId == 0)
+    {
+        ExFreePoolWithTag(Target->Ring, POOLTAG);
+        Target->Ring = NULL;
+    }
+}
+
+/**
+ * @brief Map (or unmap) the results ring of a target into the current process
+ * @details should be called from vmx non-root mode, in the context of the
+ * process that the ring is mapped into, the mapping is read-only and each
+ * ring is only mapped into one process at the same time
+ *
+ * @param MapRequest
+ *
+ * @return VOID
+ */
+VOID
+ReversingMachineTargetsMapResults(PREVERSING_MACHINE_MAP_RESULTS MapRequest)
+{
+    PREVERSING_MACHINE_TARGET Target;
+    PVOID                     UsermodeAddress = NULL;
+
+    MapRequest->RingAddress  = 0;
+    MapRequest->KernelStatus = DEBUGGER_ERROR_REVERSING_MACHINE_UNABLE_TO_MAP_RESULTS;
+
+    SpinlockLock(&g_ReversingMachineTargetsLock);
+
+    if (MapRequest->Unmap)
+    {
+        //
+        // The target might be already removed, so the process of the ring is checked
+        //
+        for (UINT32 i = 0; i < MaximumReversingMachineTargets; i++)
+        {
+            Target = &g_ReversingMachineTargets[i];
+
+            if (Target->RingMdl != NULL &&
+                Target->Ring->ProcessId == MapRequest->ProcessId &&
+                Target->RingMappedProcess == PsGetCurrentProcess())
+            {
+                ReversingMachineTargetsUnmapRing(Target);
+                MapRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+                break;
+            }
+        }
+
+        goto Unlock;
+    }
+
+    Target = ReversingMachineTargetsFind(MapRequest->ProcessId);
+
+    if (Target == NULL || Target->RingMdl != NULL)
+    {
+        //
+        // The ring is already mapped
+        //
+        goto Unlock;
+    }
+
+    Target->RingMdl = IoAllocateMdl(Target->Ring, sizeof(REVERSING_MACHINE_RESULTS_RING), FALSE, FALSE, NULL);
+
+    if (Target->RingMdl == NULL)
+    {
+        goto Unlock;
+    }
+
+    MmBuildMdlForNonPagedPool(Target->RingMdl);
+
+    //
+    // Mapping into the user-mode raises an exception if it fails
+    //
+    __try
+    {
+        UsermodeAddress = MmMapLockedPagesSpecifyCache(Target->RingMdl,
+                                                       UserMode,
+                                                       MmCached,
+                                                       NULL,
+                                                       FALSE,
+                                                       NormalPagePriority | MdlMappingNoWrite | MdlMappingNoExecute);
+    }
+    __except (EXCEPTION_EXECUTE_HANDLER)
+    {
+        UsermodeAddress = NULL;
+    }
+
+    if (UsermodeAddress == NULL)
+    {
+        IoFreeMdl(Target->RingMdl);
+        Target->RingMdl = NULL;
+
+        goto Unlock;
+    }
+
+    Target->RingUsermodeAddress = UsermodeAddress;
+    Target->RingMappedProcess   = PsGetCurrentProcess();
+
+    MapRequest->RingAddress  = (UINT64)UsermodeAddress;
+    MapRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+Unlock:
+    SpinlockUnlock(&g_ReversingMachineTargetsLock);
+}
+
+/**
+ * @brief Unmap all of the results rings that are mapped into the current process
+ * @details should be called in the context of the process that the rings
+ * are mapped into (e.g., when its handle to the device is closed)
+ *
+ * @return VOID
+ */
+VOID
+ReversingMachineTargetsUnmapResultsOfCurrentProcess()
+{
+    SpinlockLock(&g_ReversingMachineTargetsLock);
+
+    for (UINT32 i = 0; i < MaximumReversingMachineTargets; i++)
+    {
+        if (g_ReversingMachineTargets[i].RingMdl != NULL &&
+            g_ReversingMachineTargets[i].RingMappedProcess == PsGetCurrentProcess())
+        {
+            ReversingMachineTargetsUnmapRing(&g_ReversingMachineTargets[i]);
+        }
+    }
+
+    SpinlockUnlock(&g_ReversingMachineTargetsLock);
+}
@@ -19,7 +19,11 @@
 BOOLEAN
 GlobalGuestStateAllocateZeroedMemory(VOID)
 {
-    SSIZE_T BufferSizeInByte = sizeof(VIRTUAL_MACHINE_STATE) * KeQueryActiveProcessorCount(0);
+    //
+    // The buffer is rounded to pages, so it's page aligned and the states
+    // of the cores start at the cache line boundaries
+    //
+    SSIZE_T BufferSizeInByte = ROUND_TO_PAGES(sizeof(VIRTUAL_MACHINE_STATE) * KeQueryActiveProcessorCount(0));
 
     //
     // Allocate global variable to hold Guest(s) state
@@ -13,24 +13,225 @@
  */
 #include "pch.h"
 
+/**
+ * @brief Get the first slot of a physical address in the table of hooked pages
+ *
+ * @param PhysicalBaseAddress
+ *
+ * @return UINT32 Index of the slot
+ */
+static UINT32
+EptHookGetHookedPagesTableIndex(_In_ UINT64 PhysicalBaseAddress)
+{
+    //
+    // Fibonacci hashing of the page frame number
+    //
+    return (UINT32)(((PhysicalBaseAddress >> PAGE_SHIFT) * 0x9E3779B97F4A7C15ULL) >> 32) & (EPT_HOOKED_PAGES_TABLE_SIZE - 1);
+}
+
+/**
+ * @brief Add a hooked page to the table of hooked pages
+ * @details the entry should be already added to g_EptState->HookedPagesList
+ *
+ * @param HookedEntry
+ *
+ * @return VOID
+ */
+static VOID
+EptHookAddToHookedPagesTable(_In_ PEPT_HOOKED_PAGE_DETAIL HookedEntry)
+{
+    UINT32 Index;
+
+    SpinlockLockNamed(&EptHookedPagesTableLock, "hv: hooked pages table (add)");
+
+    if (HookedEntry->IsLargePage)
+    {
+        InterlockedIncrement(&g_EptState->HookedLargePagesCount);
+    }
+
+    if (g_EptState->HookedPagesTableOverflowed ||
+        g_EptState->HookedPagesTableCount >= EPT_HOOKED_PAGES_TABLE_MAX_ENTRIES)
+    {
+        //
+        // The table is full, lookups should search the list from now on
+        //
+        g_EptState->HookedPagesTableOverflowed = TRUE;
+
+        SpinlockUnlock(&EptHookedPagesTableLock);
+        return;
+    }
+
+    Index = EptHookGetHookedPagesTableIndex(HookedEntry->PhysicalBaseAddress);
+
+    //
+    // There is always a free (or deleted) slot as the table is never full
+    //
+    while (g_EptState->HookedPagesTable[Index] != NULL &&
+           g_EptState->HookedPagesTable[Index] != EPT_HOOKED_PAGES_TABLE_DELETED_ENTRY)
+    {
+        Index = (Index + 1) & (EPT_HOOKED_PAGES_TABLE_SIZE - 1);
+    }
+
+    //
+    // The details of the entry are visible before the entry is visible to the lookups
+    //
+    InterlockedExchangePointer(&g_EptState->HookedPagesTable[Index], HookedEntry);
+    g_EptState->HookedPagesTableCount++;
+
+    SpinlockUnlock(&EptHookedPagesTableLock);
+}
+
+/**
+ * @brief Remove a hooked page from the table of hooked pages
+ * @details the entry should be already removed from g_EptState->HookedPagesList
+ *
+ * @param HookedEntry
+ *
+ * @return VOID
+ */
+static VOID
+EptHookRemoveFromHookedPagesTable(_In_ PEPT_HOOKED_PAGE_DETAIL HookedEntry)
+{
+    UINT32 Index;
+
+    SpinlockLockNamed(&EptHookedPagesTableLock, "hv: hooked pages table (remove)");
+
+    if (HookedEntry->IsLargePage)
+    {
+        InterlockedDecrement(&g_EptState->HookedLargePagesCount);
+    }
+
+    Index = EptHookGetHookedPagesTableIndex(HookedEntry->PhysicalBaseAddress);
+
+    for (UINT32 i = 0; i < EPT_HOOKED_PAGES_TABLE_SIZE; i++)
+    {
+        if (g_EptState->HookedPagesTable[Index] == NULL)
+        {
+            //
+            // Not in the table (added after the table is overflowed)
+            //
+            break;
+        }
+
+        if (g_EptState->HookedPagesTable[Index] == HookedEntry)
+        {
+            //
+            // Keep probing the next slots, the lookups shouldn't stop here
+            //
+            InterlockedExchangePointer(&g_EptState->HookedPagesTable[Index], EPT_HOOKED_PAGES_TABLE_DELETED_ENTRY);
+            g_EptState->HookedPagesTableCount--;
+            break;
+        }
+
+        Index = (Index + 1) & (EPT_HOOKED_PAGES_TABLE_SIZE - 1);
+    }
+
+    if (IsListEmpty(&g_EptState->HookedPagesList))
+    {
+        //
+        // No hooked page remained, so the deleted slots can be reclaimed
+        // and the table can be used again (even if it was overflowed)
+        //
+        for (UINT32 i = 0; i < EPT_HOOKED_PAGES_TABLE_SIZE; i++)
+        {
+            InterlockedExchangePointer(&g_EptState->HookedPagesTable[i], NULL);
+        }
+
+        g_EptState->HookedPagesTableCount      = 0;
+        g_EptState->HookedPagesTableOverflowed = FALSE;
+        g_EptState->HookedLargePagesCount      = 0;
+    }
+
+    SpinlockUnlock(&EptHookedPagesTableLock);
+}
+
 /**
  * @brief Check whether the desired PhysicalAddress is already in the g_EptState->HookedPagesList hooks or not
+ * @details lookups are lock-free and can be used in vmx-root
  *
  * @param PhysicalBaseAddress
  *
- * @return PEPT_HOOKED_PAGE_DETAIL  if the address was already hooked, or FALSE
+ * @return PEPT_HOOKED_PAGE_DETAIL  if the address was already hooked, or NULL
  */
 _Must_inspect_result_
-_Success_(return == TRUE)
-static EPT_HOOKED_PAGE_DETAIL *
+PEPT_HOOKED_PAGE_DETAIL
 EptHookFindByPhysAddress(_In_ UINT64 PhysicalBaseAddress)
 {
-    LIST_FOR_EACH_LINK(g_EptState->HookedPagesList, EPT_HOOKED_PAGE_DETAIL, PageHookList, CurrEntity)
+    UINT32                  Index;
+    PEPT_HOOKED_PAGE_DETAIL HookedEntry;
+
+    if (g_EptState->HookedPagesTableOverflowed)
+    {
+        //
+        // Some hooked pages are not in the table
+        //
+        LIST_FOR_EACH_LINK(g_EptState->HookedPagesList, EPT_HOOKED_PAGE_DETAIL, PageHookList, CurrEntity)
+        {
+            if (CurrEntity->PhysicalBaseAddress == PhysicalBaseAddress)
+            {
+                return CurrEntity;
+            }
+        }
+
+        return NULL;
+    }
+
+    Index = EptHookGetHookedPagesTableIndex(PhysicalBaseAddress);
+
+    for (UINT32 i = 0; i < EPT_HOOKED_PAGES_TABLE_SIZE; i++)
     {
-        if (CurrEntity->PhysicalBaseAddress == PhysicalBaseAddress)
+        HookedEntry = g_EptState->HookedPagesTable[Index];
+
+        if (HookedEntry == NULL)
         {
-            return CurrEntity;
+            //
+            // Reached an empty slot, the page is not hooked
+            //
+            return NULL;
+        }
+
+        if (HookedEntry != EPT_HOOKED_PAGES_TABLE_DELETED_ENTRY &&
+            HookedEntry->PhysicalBaseAddress == PhysicalBaseAddress)
+        {
+            return HookedEntry;
         }
+
+        Index = (Index + 1) & (EPT_HOOKED_PAGES_TABLE_SIZE - 1);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find the hooked page that contains the desired PhysicalAddress
+ * @details hooks that are applied on 2MB pages (without splitting them) are
+ * also found, lookups are lock-free and can be used in vmx-root
+ *
+ * @param PhysicalAddress
+ *
+ * @return PEPT_HOOKED_PAGE_DETAIL  if the address was hooked, or NULL
+ */
+_Must_inspect_result_
+PEPT_HOOKED_PAGE_DETAIL
+EptHookFindByPhysAddressIncludingLargePages(_In_ UINT64 PhysicalAddress)
+{
+    PEPT_HOOKED_PAGE_DETAIL HookedEntry;
+
+    HookedEntry = EptHookFindByPhysAddress(PAGE_ALIGN(PhysicalAddress));
+
+    if (HookedEntry != NULL || g_EptState->HookedLargePagesCount == 0)
+    {
+        return HookedEntry;
+    }
+
+    //
+    // Hooks of 2MB pages are saved by the start address of the 2MB page
+    //
+    HookedEntry = EptHookFindByPhysAddress(LARGE_PAGE_ALIGN(PhysicalAddress));
+
+    if (HookedEntry != NULL && HookedEntry->IsLargePage)
+    {
+        return HookedEntry;
     }
 
     return NULL;
@@ -51,6 +252,154 @@ EptHookCalcBreakpointOffset(_In_ PVOID                    TargetAddress,
     return TargetAddressInFakePageContent;
 }
 
+/**
+ * @brief Search the hidden breakpoints of a hooked page by offset
+ * @details the breakpoints are sorted by their offsets, so it's a binary search
+ *
+ * @param HookedEntry The hooked page
+ * @param Offset Offset of the breakpoint in the page
+ * @param Index The index of the breakpoint or the index that it should be inserted
+ *
+ * @return BOOLEAN Returns true if there is a breakpoint on the offset
+ */
+static BOOLEAN
+EptHookSearchHiddenBreakpoints(_In_ EPT_HOOKED_PAGE_DETAIL * HookedEntry,
+                               _In_ UINT16                   Offset,
+                               _Out_ UINT32 *                Index)
+{
+    UINT32 Low    = 0;
+    UINT32 High   = HookedEntry->CountOfBreakpoints;
+    UINT32 Middle = 0;
+
+    while (Low < High)
+    {
+        Middle = Low + ((High - Low) / 2);
+
+        if (HookedEntry->Breakpoints[Middle].Offset < Offset)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    *Index = Low;
+
+    return Low < HookedEntry->CountOfBreakpoints && HookedEntry->Breakpoints[Low].Offset == Offset;
+}
+
+/**
+ * @brief Check whether there is a hidden breakpoint on the address
+ *
+ * @param HookedEntry The hooked page
+ * @param Address The address (only its offset in the page is used)
+ *
+ * @return BOOLEAN Returns true if there is a breakpoint on the address
+ */
+BOOLEAN
+EptHookIsHiddenBreakpointAddress(EPT_HOOKED_PAGE_DETAIL * HookedEntry, UINT64 Address)
+{
+    UINT32 Index;
+
+    return EptHookSearchHiddenBreakpoints(HookedEntry, (UINT16)PAGE_OFFSET(Address), &Index);
+}
+
+/**
+ * @brief Add a hidden breakpoint to the sorted breakpoints of a hooked page
+ * @details if the breakpoints of the page don't fit in the hooked page detail,
+ * they're moved to a set that is allocated from the pool manager
+ *
+ * @param HookedEntry The hooked page
+ * @param Offset Offset of the breakpoint in the page
+ * @param PreviousByte The byte that is replaced by the breakpoint
+ *
+ * @return BOOLEAN Returns true if the breakpoint is added
+ */
+static BOOLEAN
+EptHookAddHiddenBreakpoint(_Inout_ EPT_HOOKED_PAGE_DETAIL * HookedEntry,
+                           _In_ UINT16                      Offset,
+                           _In_ CHAR                        PreviousByte)
+{
+    UINT32                 Index;
+    PEPT_HIDDEN_BREAKPOINT BreakpointsSet;
+
+    if (EptHookSearchHiddenBreakpoints(HookedEntry, Offset, &Index))
+    {
+        //
+        // There is already a breakpoint on this address
+        //
+        if (HookedEntry->Breakpoints[Index].Count >= MaximumHiddenBreakpointsOnSameAddress)
+        {
+            VmmCallbackSetLastError(DEBUGGER_ERROR_MAXIMUM_BREAKPOINT_FOR_A_SINGLE_PAGE_IS_HIT);
+            return FALSE;
+        }
+
+        HookedEntry->Breakpoints[Index].Count++;
+        return TRUE;
+    }
+
+    if (HookedEntry->CountOfBreakpoints >= HookedEntry->BreakpointsCapacity)
+    {
+        //
+        // Move the breakpoints to a set that holds all of the addresses of the page
+        //
+        BreakpointsSet = PoolManagerRequestPool(HIDDEN_BREAKPOINTS_SET,
+                                                TRUE,
+                                                sizeof(EPT_HIDDEN_BREAKPOINT) * HIDDEN_BREAKPOINTS_SET_CAPACITY);
+
+        if (!BreakpointsSet)
+        {
+            VmmCallbackSetLastError(DEBUGGER_ERROR_PRE_ALLOCATED_BUFFER_IS_EMPTY);
+            return FALSE;
+        }
+
+        RtlCopyMemory(BreakpointsSet, HookedEntry->Breakpoints, sizeof(EPT_HIDDEN_BREAKPOINT) * HookedEntry->CountOfBreakpoints);
+
+        HookedEntry->Breakpoints         = BreakpointsSet;
+        HookedEntry->BreakpointsCapacity = HIDDEN_BREAKPOINTS_SET_CAPACITY;
+    }
+
+    //
+    // Keep the breakpoints sorted
+    //
+    RtlMoveMemory(&HookedEntry->Breakpoints[Index + 1],
+                  &HookedEntry->Breakpoints[Index],
+                  sizeof(EPT_HIDDEN_BREAKPOINT) * (HookedEntry->CountOfBreakpoints - Index));
+
+    HookedEntry->Breakpoints[Index].Offset       = Offset;
+    HookedEntry->Breakpoints[Index].PreviousByte = PreviousByte;
+    HookedEntry->Breakpoints[Index].Count        = 1;
+
+    HookedEntry->CountOfBreakpoints++;
+
+    return TRUE;
+}
+
+/**
+ * @brief Free the set of hidden breakpoints of a hooked page (if it's allocated from the pool manager)
+ *
+ * @param HookedEntry The hooked page
+ *
+ * @return VOID
+ */
+static VOID
+EptHookFreeHiddenBreakpointsSet(_Inout_ EPT_HOOKED_PAGE_DETAIL * HookedEntry)
+{
+    if (HookedEntry->Breakpoints != NULL && HookedEntry->Breakpoints != HookedEntry->InlineBreakpoints)
+    {
+        if (!PoolManagerFreePool(HookedEntry->Breakpoints))
+        {
+            LogError("Err, something goes wrong, the pool not found in the list of previously allocated pools by pool manager");
+        }
+    }
+
+    HookedEntry->Breakpoints         = NULL;
+    HookedEntry->BreakpointsCapacity = 0;
+    HookedEntry->CountOfBreakpoints  = 0;
+}
+
 static BOOLEAN
 EptHookCreateHookPage(_In_ PVOID    TargetAddress,
                       _In_ CR3_TYPE ProcessCr3)
@@ -69,6 +418,15 @@ EptHookCreateHookPage(_In_ PVOID    TargetAddress,
     BYTE     OriginalByte;
     BOOLEAN  HookedEntryFound = FALSE;
 
+    //
+    // The entries of the pages are protected by the snapshot
+    //
+    if (g_EptSnapshot.IsTaken)
+    {
+        VmmCallbackSetLastError(DEBUGGER_ERROR_EPT_SNAPSHOT_CONFLICTS_WITH_EPT_HOOKS);
+        return FALSE;
+    }
+
     //
     // Translate the page from a physical address to virtual so we can read its memory.
     // This function will return NULL if the physical address was not already mapped in
@@ -184,14 +542,11 @@ EptHookCreateHookPage(_In_ PVOID    TargetAddress,
     HookedPage->IsExecutionHook = TRUE;
 
     //
-    // Save the address of (first) new breakpoint
+    // The breakpoints are saved in the hooked page detail until it's full
     //
-    HookedPage->BreakpointAddresses[0] = TargetAddress;
-
-    //
-    // Change the counter (set it to 1)
-    //
-    HookedPage->CountOfBreakpoints = 1;
+    HookedPage->Breakpoints         = HookedPage->InlineBreakpoints;
+    HookedPage->BreakpointsCapacity = HIDDEN_BREAKPOINTS_INLINE_CAPACITY;
+    HookedPage->CountOfBreakpoints  = 0;
 
     //
     // In execution hook, we have to make sure to unset read, write because
@@ -228,6 +583,11 @@ EptHookCreateHookPage(_In_ PVOID    TargetAddress,
     //
     MemoryMapperReadMemorySafe(VirtualTarget, &HookedPage->FakePageContents, PAGE_SIZE);
 
+    //
+    // Save the (first) new breakpoint (there is always room for it)
+    //
+    EptHookAddHiddenBreakpoint(HookedPage, (UINT16)PageOffset, *(CHAR *)TargetAddressInFakePageContent);
+
     //
     // Set the breakpoint on the fake page
     //
@@ -248,6 +608,11 @@ EptHookCreateHookPage(_In_ PVOID    TargetAddress,
     //
     InsertHeadList(&g_EptState->HookedPagesList, &(HookedPage->PageHookList));
 
+    //
+    // Add it to the table of hooked pages (used for lookups)
+    //
+    EptHookAddToHookedPagesTable(HookedPage);
+
     //
     // if not launched, there is no need to modify it on a safe environment
     //
@@ -281,18 +646,6 @@ EptHookUpdateHookPage(_In_ PVOID                       TargetAddress,
     if (HookedEntry == NULL)
         return FALSE;
 
-    //
-    // Here we should add the breakpoint to previous breakpoint
-    //
-    if (HookedEntry->CountOfBreakpoints >= MaximumHiddenBreakpointsOnPage)
-    {
-        //
-        // Means that breakpoint is full and we can't apply this breakpoint
-        //
-        VmmCallbackSetLastError(DEBUGGER_ERROR_MAXIMUM_BREAKPOINT_FOR_A_SINGLE_PAGE_IS_HIT);
-        return FALSE;
-    }
-
     //
     // Apply the hook 0xcc
     //
@@ -313,24 +666,18 @@ EptHookUpdateHookPage(_In_ PVOID                       TargetAddress,
     OriginalByte = *(BYTE *)TargetAddressInFakePageContent;
 
     //
-    // Set the breakpoint on the fake page
-    //
-    *(BYTE *)TargetAddressInFakePageContent = 0xcc;
-
-    //
-    // Add target address to the list of breakpoints
-    //
-    HookedEntry->BreakpointAddresses[HookedEntry->CountOfBreakpoints] = TargetAddress;
-
-    //
-    // Save the original byte
+    // Add target address (with its original byte) to the breakpoints of the page,
+    // if the address already has a breakpoint, only its counter is increased
     //
-    HookedEntry->PreviousBytesOnBreakpointAddresses[HookedEntry->CountOfBreakpoints] = OriginalByte;
+    if (!EptHookAddHiddenBreakpoint(HookedEntry, (UINT16)PageOffset, OriginalByte))
+    {
+        return FALSE;
+    }
 
     //
-    // Add to the breakpoint counts
+    // Set the breakpoint on the fake page
     //
-    HookedEntry->CountOfBreakpoints = HookedEntry->CountOfBreakpoints + 1;
+    *(BYTE *)TargetAddressInFakePageContent = 0xcc;
 
     return TRUE;
 }
@@ -408,7 +755,16 @@ EptHookPerformPageHook(PVOID    TargetAddress,
     // try to see if we can find the address
     //
 
-    HookedEntry = EptHookFindByPhysAddress(PhysicalBaseAddress);
+    HookedEntry = EptHookFindByPhysAddressIncludingLargePages(PhysicalBaseAddress);
+
+    if (HookedEntry != NULL && HookedEntry->IsLargePage)
+    {
+        //
+        // The 2MB page is monitored as a whole, it can't be split
+        //
+        VmmCallbackSetLastError(DEBUGGER_ERROR_EPT_MULTIPLE_HOOKS_IN_A_SINGLE_PAGE);
+        return FALSE;
+    }
 
     if (HookedEntry != NULL)
     {
@@ -616,26 +972,176 @@ EptHookWriteAbsoluteJump2(PCHAR TargetBuffer, SIZE_T TargetAddress)
 }
 
 /**
- * @brief Hook instructions
+ * @brief Write a relative x64 jump (jmp rel32) to a buffer
+ * @details the target address should be in the range of +/-2GB of the buffer
  *
- * @param Hook The details of hooked pages
- * @param ProcessCr3 The target Process CR3
- * @param TargetFunction Target function that needs to be hooked
- * @param TargetFunctionInSafeMemory Target content in the safe memory (used in Length Disassembler Engine)
- * @param HookFunction The function that will be called when hook triggered
- * @return BOOLEAN Returns true if the hook was successful or returns false if it was not successful
+ * @param TargetBuffer
+ * @param TargetAddress
+ * @return BOOLEAN Returns false if the target address is not in the range of the jump
  */
-BOOLEAN
-EptHookInstructionMemory(PEPT_HOOKED_PAGE_DETAIL Hook,
-                         CR3_TYPE                ProcessCr3,
-                         PVOID                   TargetFunction,
-                         PVOID                   TargetFunctionInSafeMemory,
-                         PVOID                   HookFunction)
+static BOOLEAN
+EptHookWriteRelativeJump(PCHAR TargetBuffer, SIZE_T TargetAddress)
 {
-    PHIDDEN_HOOKS_DETOUR_DETAILS DetourHookDetails;
-    SIZE_T                       SizeOfHookedInstructions;
-    SIZE_T                       OffsetIntoPage;
-    CR3_TYPE                     Cr3OfCurrentProcess;
+    INT64 Displacement = (INT64)TargetAddress - ((INT64)TargetBuffer + 5);
+
+    if (Displacement < MINLONG || Displacement > MAXLONG)
+    {
+        return FALSE;
+    }
+
+    //
+    // jmp rel32
+    //
+    TargetBuffer[0] = 0xe9;
+
+    *((PINT32)&TargetBuffer[1]) = (INT32)Displacement;
+
+    return TRUE;
+}
+
+/**
+ * @brief Get a trampoline for the hooked instructions from the slabs of trampolines
+ * @details if there is a released trampoline that is built for the same hooked
+ * instructions, it's reused, otherwise an unused slot is returned
+ *
+ * @param TargetFunction The hooked function
+ * @param HookedInstructions The bytes of the hooked instructions
+ * @param SizeOfHookedInstructions Count of bytes of the hooked instructions
+ * @param IsReused Whether the trampoline is already built for the hooked instructions
+ * @return PEPT_HOOK_TRAMPOLINE_SLOT The slot of the trampoline or NULL if there was no free slot
+ */
+static PEPT_HOOK_TRAMPOLINE_SLOT
+EptHookAcquireTrampoline(PVOID     TargetFunction,
+                         PCHAR     HookedInstructions,
+                         SIZE_T    SizeOfHookedInstructions,
+                         BOOLEAN * IsReused)
+{
+    PEPT_HOOK_TRAMPOLINES_SLAB Slab;
+    PEPT_HOOK_TRAMPOLINES_SLAB FreeSlotSlab  = NULL;
+    UINT32                     FreeSlotIndex = 0;
+    PEPT_HOOK_TRAMPOLINE_SLOT  AcquiredSlot  = NULL;
+
+    *IsReused = FALSE;
+
+    SpinlockLockNamed(&g_EptHookTrampolinesLock, "hv: trampolines (acquire)");
+
+    LIST_FOR_EACH_LINK(g_EptHookTrampolinesSlabsListHead, EPT_HOOK_TRAMPOLINES_SLAB, SlabsList, CurrentSlab)
+    {
+        for (UINT32 i = 0; i < EPT_HOOK_TRAMPOLINES_PER_SLAB; i++)
+        {
+            PEPT_HOOK_TRAMPOLINE_SLOT Slot = &CurrentSlab->Slots[i];
+
+            if (!Slot->IsAllocated)
+            {
+                if (FreeSlotSlab == NULL)
+                {
+                    FreeSlotSlab  = CurrentSlab;
+                    FreeSlotIndex = i;
+                }
+
+                continue;
+            }
+
+            if (!Slot->InUse &&
+                Slot->TargetAddress == (UINT64)TargetFunction &&
+                Slot->SizeOfHookedInstructions == SizeOfHookedInstructions &&
+                RtlCompareMemory(CurrentSlab->Trampolines[i], HookedInstructions, SizeOfHookedInstructions) == SizeOfHookedInstructions)
+            {
+                //
+                // The same trampoline is already built (reuse it)
+                //
+                Slot->HitCount = 0;
+                Slot->InUse    = TRUE;
+                *IsReused      = TRUE;
+                AcquiredSlot   = Slot;
+
+                goto Exit;
+            }
+        }
+    }
+
+    if (FreeSlotSlab == NULL)
+    {
+        //
+        // All of the slots are used, so we need a new slab
+        //
+        Slab = PoolManagerRequestPool(EXEC_TRAMPOLINE, TRUE, sizeof(EPT_HOOK_TRAMPOLINES_SLAB));
+
+        if (!Slab)
+        {
+            goto Exit;
+        }
+
+        InsertHeadList(&g_EptHookTrampolinesSlabsListHead, &Slab->SlabsList);
+
+        FreeSlotSlab  = Slab;
+        FreeSlotIndex = 0;
+    }
+
+    AcquiredSlot = &FreeSlotSlab->Slots[FreeSlotIndex];
+
+    AcquiredSlot->TargetAddress            = (UINT64)TargetFunction;
+    AcquiredSlot->SizeOfHookedInstructions = (UINT32)SizeOfHookedInstructions;
+    AcquiredSlot->Trampoline               = FreeSlotSlab->Trampolines[FreeSlotIndex];
+    AcquiredSlot->HitCount                 = 0;
+    AcquiredSlot->IsAllocated              = TRUE;
+    AcquiredSlot->InUse                    = TRUE;
+
+Exit:
+    SpinlockUnlock(&g_EptHookTrampolinesLock);
+
+    return AcquiredSlot;
+}
+
+/**
+ * @brief Release the trampoline of a removed hook (it might be reused for the same hooked instructions)
+ *
+ * @param Trampoline
+ * @return VOID
+ */
+static VOID
+EptHookReleaseTrampoline(PCHAR Trampoline)
+{
+    SpinlockLockNamed(&g_EptHookTrampolinesLock, "hv: trampolines (release)");
+
+    LIST_FOR_EACH_LINK(g_EptHookTrampolinesSlabsListHead, EPT_HOOK_TRAMPOLINES_SLAB, SlabsList, CurrentSlab)
+    {
+        if (Trampoline >= CurrentSlab->Trampolines[0] &&
+            Trampoline < CurrentSlab->Trampolines[EPT_HOOK_TRAMPOLINES_PER_SLAB - 1] + EPT_HOOK_TRAMPOLINE_SLOT_SIZE)
+        {
+            CurrentSlab->Slots[(Trampoline - CurrentSlab->Trampolines[0]) / EPT_HOOK_TRAMPOLINE_SLOT_SIZE].InUse = FALSE;
+            break;
+        }
+    }
+
+    SpinlockUnlock(&g_EptHookTrampolinesLock);
+}
+
+/**
+ * @brief Hook instructions
+ *
+ * @param Hook The details of hooked pages
+ * @param ProcessCr3 The target Process CR3
+ * @param TargetFunction Target function that needs to be hooked
+ * @param TargetFunctionInSafeMemory Target content in the safe memory (used in Length Disassembler Engine)
+ * @param HookFunction The function that will be called when hook triggered
+ * @return BOOLEAN Returns true if the hook was successful or returns false if it was not successful
+ */
+BOOLEAN
+EptHookInstructionMemory(PEPT_HOOKED_PAGE_DETAIL Hook,
+                         CR3_TYPE                ProcessCr3,
+                         PVOID                   TargetFunction,
+                         PVOID                   TargetFunctionInSafeMemory,
+                         PVOID                   HookFunction)
+{
+    PHIDDEN_HOOKS_DETOUR_DETAILS DetourHookDetails;
+    SIZE_T                       SizeOfHookedInstructions;
+    SIZE_T                       OffsetIntoPage;
+    CR3_TYPE                     Cr3OfCurrentProcess;
+    CHAR                         HookedInstructions[EPT_HOOK_TRAMPOLINE_SLOT_SIZE];
+    BOOLEAN                      IsTrampolineReused;
+    PEPT_HOOK_TRAMPOLINE_SLOT    TrampolineSlot;
+    PCHAR                        Dispatcher;
 
     OffsetIntoPage = ADDRMASK_EPT_PML1_OFFSET((SIZE_T)TargetFunction);
 
@@ -679,33 +1185,24 @@ EptHookInstructionMemory(PEPT_HOOKED_PAGE_DETAIL Hook,
     // LogInfo("Number of bytes of instruction mem: %x", SizeOfHookedInstructions);
 
     //
-    // Build a trampoline
-    //
-
-    //
-    // Allocate some executable memory for the trampoline
+    // The hooked instructions and the jump back should fit before the dispatcher
     //
-    Hook->Trampoline = PoolManagerRequestPool(EXEC_TRAMPOLINE, TRUE, MAX_EXEC_TRAMPOLINE_SIZE);
-
-    if (!Hook->Trampoline)
+    if (SizeOfHookedInstructions + 14 > EPT_HOOK_TRAMPOLINE_DISPATCHER_OFFSET)
     {
-        LogError("Err, could not allocate trampoline function buffer");
+        LogError("Err, hooked instructions don't fit in the trampoline");
         return FALSE;
     }
 
     //
-    // Copy the trampoline instructions in
-    //
-
     // Switch to target process
     //
     Cr3OfCurrentProcess = SwitchToProcessMemoryLayoutByCr3(ProcessCr3);
 
     //
     // The following line can't be used in user mode addresses
-    // RtlCopyMemory(Hook->Trampoline, TargetFunction, SizeOfHookedInstructions);
+    // RtlCopyMemory(HookedInstructions, TargetFunction, SizeOfHookedInstructions);
     //
-    MemoryMapperReadMemorySafe(TargetFunction, Hook->Trampoline, SizeOfHookedInstructions);
+    MemoryMapperReadMemorySafe(TargetFunction, HookedInstructions, SizeOfHookedInstructions);
 
     //
     // Restore to original process
@@ -713,9 +1210,65 @@ EptHookInstructionMemory(PEPT_HOOKED_PAGE_DETAIL Hook,
     SwitchToPreviousProcess(Cr3OfCurrentProcess);
 
     //
-    // Add the absolute jump back to the original function
+    // Build a trampoline
     //
-    EptHookWriteAbsoluteJump2(&Hook->Trampoline[SizeOfHookedInstructions], (SIZE_T)TargetFunction + SizeOfHookedInstructions);
+
+    //
+    // Get some executable memory for the trampoline (or the trampoline of a
+    // previous hook on the same instructions)
+    //
+    TrampolineSlot = EptHookAcquireTrampoline(TargetFunction, HookedInstructions, SizeOfHookedInstructions, &IsTrampolineReused);
+
+    if (!TrampolineSlot)
+    {
+        LogError("Err, could not allocate trampoline function buffer");
+        return FALSE;
+    }
+
+    Hook->Trampoline = TrampolineSlot->Trampoline;
+    Dispatcher       = &Hook->Trampoline[EPT_HOOK_TRAMPOLINE_DISPATCHER_OFFSET];
+
+    if (!IsTrampolineReused)
+    {
+        //
+        // Copy the trampoline instructions in
+        //
+        RtlCopyMemory(Hook->Trampoline, HookedInstructions, SizeOfHookedInstructions);
+
+        //
+        // Add the jump back to the original function (a relative jump if the
+        // function is in +/-2GB of the trampoline, otherwise an absolute jump)
+        //
+        if (!EptHookWriteRelativeJump(&Hook->Trampoline[SizeOfHookedInstructions], (SIZE_T)TargetFunction + SizeOfHookedInstructions))
+        {
+            EptHookWriteAbsoluteJump2(&Hook->Trampoline[SizeOfHookedInstructions], (SIZE_T)TargetFunction + SizeOfHookedInstructions);
+        }
+
+        //
+        // Build the dispatcher, it passes the slot (the record of this hook) to the
+        // general detour handler so the handler doesn't need to search for the hook,
+        // push Lower 4-byte of the slot
+        //
+        Dispatcher[0]              = 0x68;
+        *((PUINT32)&Dispatcher[1]) = (UINT32)(UINT64)TrampolineSlot;
+
+        //
+        // mov [rsp+4],High 4-byte of the slot
+        //
+        Dispatcher[5]              = 0xC7;
+        Dispatcher[6]              = 0x44;
+        Dispatcher[7]              = 0x24;
+        Dispatcher[8]              = 0x04;
+        *((PUINT32)&Dispatcher[9]) = (UINT32)((UINT64)TrampolineSlot >> 32);
+
+        //
+        // Jump to the general detour handler
+        //
+        if (!EptHookWriteRelativeJump(&Dispatcher[13], (SIZE_T)AsmGeneralDetourHook))
+        {
+            EptHookWriteAbsoluteJump2(&Dispatcher[13], (SIZE_T)AsmGeneralDetourHook);
+        }
+    }
 
     //
     //
@@ -750,9 +1303,132 @@ EptHookInstructionMemory(PEPT_HOOKED_PAGE_DETAIL Hook,
     InsertHeadList(&g_EptHook2sDetourListHead, &(DetourHookDetails->OtherHooksList));
 
     //
-    // Write the absolute jump to our shadow page memory to jump to our hook
+    // Write the absolute jump to our shadow page memory to jump to our hook (the
+    // general detour handler is reached through the dispatcher of the trampoline)
     //
-    EptHookWriteAbsoluteJump(&Hook->FakePageContents[OffsetIntoPage], (SIZE_T)HookFunction);
+    if (HookFunction == AsmGeneralDetourHook)
+    {
+        EptHookWriteAbsoluteJump(&Hook->FakePageContents[OffsetIntoPage], (SIZE_T)Dispatcher);
+    }
+    else
+    {
+        EptHookWriteAbsoluteJump(&Hook->FakePageContents[OffsetIntoPage], (SIZE_T)HookFunction);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Monitor a whole 2MB page by changing its PML2 entry (without splitting it)
+ * @details the target address should be the start of a 2MB page that is mapped by
+ * a large page in the target process and its PML2 entry shouldn't be split before
+ *
+ * @param TargetAddress The start address of the 2MB page
+ * @param PhysicalBaseAddress The physical address of TargetAddress
+ * @param ProcessCr3 The process cr3 to translate based on that process's cr3
+ * @param UnsetRead Hook READ Access
+ * @param UnsetWrite Hook WRITE Access
+ * @param UnsetExecute Hook EXECUTE Access
+ * @return BOOLEAN Returns true if the hook was successful or false if there was an error
+ */
+static BOOLEAN
+EptHookPerformLargePageHook(PVOID    TargetAddress,
+                            SIZE_T   PhysicalBaseAddress,
+                            CR3_TYPE ProcessCr3,
+                            BOOLEAN  UnsetRead,
+                            BOOLEAN  UnsetWrite,
+                            BOOLEAN  UnsetExecute)
+{
+    PPAGE_ENTRY             GuestPageEntry;
+    PEPT_PML2_ENTRY         TargetEntry;
+    EPT_PML1_ENTRY          ChangedEntry;
+    PEPT_HOOKED_PAGE_DETAIL HookedPage;
+
+    //
+    // The entries of the pages are protected by the snapshot
+    //
+    if (g_EptSnapshot.IsTaken)
+    {
+        VmmCallbackSetLastError(DEBUGGER_ERROR_EPT_SNAPSHOT_CONFLICTS_WITH_EPT_HOOKS);
+        return FALSE;
+    }
+
+    //
+    // Both of the addresses should be the start of a 2MB page
+    //
+    if (LARGE_PAGE_ALIGN(TargetAddress) != (UINT64)TargetAddress ||
+        LARGE_PAGE_ALIGN(PhysicalBaseAddress) != PhysicalBaseAddress)
+    {
+        VmmCallbackSetLastError(DEBUGGER_ERROR_INVALID_ADDRESS);
+        return FALSE;
+    }
+
+    //
+    // The 2MB page should be mapped by a large page (2MB or 1GB) in the target
+    // process, otherwise its physical memory is not necessarily contiguous
+    //
+    GuestPageEntry = MemoryMapperGetPteVaByCr3(TargetAddress, PagingLevelPageDirectory, ProcessCr3);
+
+    if (GuestPageEntry == NULL || !GuestPageEntry->Fields.Present || !GuestPageEntry->Fields.LargePage)
+    {
+        VmmCallbackSetLastError(DEBUGGER_ERROR_INVALID_ADDRESS);
+        return FALSE;
+    }
+
+    //
+    // The PML2 entry should be still a large page (no other hooks in this 2MB page)
+    //
+    TargetEntry = EptGetPml2Entry(g_EptState->EptPageTable, PhysicalBaseAddress);
+
+    if (TargetEntry == NULL || !TargetEntry->LargePage ||
+        EptHookFindByPhysAddressIncludingLargePages(PhysicalBaseAddress) != NULL)
+    {
+        VmmCallbackSetLastError(DEBUGGER_ERROR_EPT_MULTIPLE_HOOKS_IN_A_SINGLE_PAGE);
+        return FALSE;
+    }
+
+    //
+    // The access bits are at the same position in PML1 and PML2 entries,
+    // so the raw value of the PML2 entry is saved as the PML1 entry
+    //
+    ChangedEntry.AsUInt          = TargetEntry->AsUInt;
+    ChangedEntry.ReadAccess      = UnsetRead ? 0 : 1;
+    ChangedEntry.WriteAccess     = UnsetWrite ? 0 : 1;
+    ChangedEntry.ExecuteAccess   = UnsetExecute ? 0 : 1;
+    ChangedEntry.UserModeExecute = UnsetExecute ? 0 : 1;
+
+    //
+    // Save the detail of hooked page to keep track of it
+    //
+    HookedPage = PoolManagerRequestPool(TRACKING_HOOKED_PAGES, TRUE, sizeof(EPT_HOOKED_PAGE_DETAIL));
+
+    if (!HookedPage)
+    {
+        VmmCallbackSetLastError(DEBUGGER_ERROR_PRE_ALLOCATED_BUFFER_IS_EMPTY);
+        return FALSE;
+    }
+
+    HookedPage->VirtualAddress       = TargetAddress;
+    HookedPage->PhysicalBaseAddress  = PhysicalBaseAddress;
+    HookedPage->EntryAddress         = (PEPT_PML1_ENTRY)TargetEntry;
+    HookedPage->OriginalEntry.AsUInt = TargetEntry->AsUInt;
+    HookedPage->ChangedEntry         = ChangedEntry;
+    HookedPage->IsLargePage          = TRUE;
+
+    //
+    // Add it to the list
+    //
+    InsertHeadList(&g_EptState->HookedPagesList, &(HookedPage->PageHookList));
+
+    //
+    // Add it to the table of hooked pages (used for lookups)
+    //
+    EptHookAddToHookedPagesTable(HookedPage);
+
+    //
+    // Apply the hook to EPT
+    //
+    EptSetPML1AndInvalidateTLB(HookedPage->EntryAddress, ChangedEntry, InveptSingleContext);
 
     return TRUE;
 }
@@ -769,6 +1445,7 @@ EptHookInstructionMemory(PEPT_HOOKED_PAGE_DETAIL Hook,
  * @param UnsetWrite Hook WRITE Access
  * @param UnsetExecute Hook EXECUTE Access
  * @param EptHiddenHook !epthook2-like events
+ * @param LargePage Monitor the whole 2MB page (without splitting it)
  *
  * @return BOOLEAN Returns true if the hook was successful or false if there was an error
  */
@@ -779,7 +1456,8 @@ EptHookPerformPageHook2(PVOID    TargetAddress,
                         BOOLEAN  UnsetRead,
                         BOOLEAN  UnsetWrite,
                         BOOLEAN  UnsetExecute,
-                        BOOLEAN  EptHiddenHook)
+                        BOOLEAN  EptHiddenHook,
+                        BOOLEAN  LargePage)
 {
     EPT_PML1_ENTRY          ChangedEntry;
     INVEPT_DESCRIPTOR       Descriptor;
@@ -791,8 +1469,15 @@ EptHookPerformPageHook2(PVOID    TargetAddress,
     PEPT_PML1_ENTRY         TargetPage;
     PEPT_HOOKED_PAGE_DETAIL HookedPage;
     CR3_TYPE                Cr3OfCurrentProcess;
-    PLIST_ENTRY             TempList    = 0;
-    PEPT_HOOKED_PAGE_DETAIL HookedEntry = NULL;
+
+    //
+    // The entries of the pages are protected by the snapshot
+    //
+    if (g_EptSnapshot.IsTaken)
+    {
+        VmmCallbackSetLastError(DEBUGGER_ERROR_EPT_SNAPSHOT_CONFLICTS_WITH_EPT_HOOKS);
+        return FALSE;
+    }
 
     //
     // Translate the page from a physical address to virtual so we can read its memory.
@@ -819,24 +1504,29 @@ EptHookPerformPageHook2(PVOID    TargetAddress,
     }
 
     //
-    // try to see if we can find the address
+    // Monitoring a 2MB page as a whole doesn't need splitting
     //
-    TempList = &g_EptState->HookedPagesList;
-
-    while (&g_EptState->HookedPagesList != TempList->Flink)
+    if (LargePage)
     {
-        TempList    = TempList->Flink;
-        HookedEntry = CONTAINING_RECORD(TempList, EPT_HOOKED_PAGE_DETAIL, PageHookList);
+        return EptHookPerformLargePageHook(TargetAddress,
+                                           PhysicalBaseAddress,
+                                           ProcessCr3,
+                                           UnsetRead,
+                                           UnsetWrite,
+                                           UnsetExecute);
+    }
 
-        if (HookedEntry->PhysicalBaseAddress == PhysicalBaseAddress)
-        {
-            //
-            // Means that we find the address and !epthook2 doesn't support
-            // multiple breakpoints in on page
-            //
-            VmmCallbackSetLastError(DEBUGGER_ERROR_EPT_MULTIPLE_HOOKS_IN_A_SINGLE_PAGE);
-            return FALSE;
-        }
+    //
+    // try to see if we can find the address
+    //
+    if (EptHookFindByPhysAddressIncludingLargePages(PhysicalBaseAddress) != NULL)
+    {
+        //
+        // Means that we find the address and !epthook2 doesn't support
+        // multiple breakpoints in on page
+        //
+        VmmCallbackSetLastError(DEBUGGER_ERROR_EPT_MULTIPLE_HOOKS_IN_A_SINGLE_PAGE);
+        return FALSE;
     }
 
     //
@@ -894,10 +1584,20 @@ EptHookPerformPageHook2(PVOID    TargetAddress,
     else
         ChangedEntry.WriteAccess = 1;
 
+    //
+    // The user-mode execute bit is also changed as the page should not be
+    // executable in the user-mode once mode-based execution control is enabled
+    //
     if (UnsetExecute)
-        ChangedEntry.ExecuteAccess = 0;
+    {
+        ChangedEntry.ExecuteAccess   = 0;
+        ChangedEntry.UserModeExecute = 0;
+    }
     else
-        ChangedEntry.ExecuteAccess = 1;
+    {
+        ChangedEntry.ExecuteAccess   = 1;
+        ChangedEntry.UserModeExecute = 1;
+    }
 
     //
     // Save the detail of hooked page to keep track of it
@@ -1019,6 +1719,11 @@ EptHookPerformPageHook2(PVOID    TargetAddress,
     //
     InsertHeadList(&g_EptState->HookedPagesList, &(HookedPage->PageHookList));
 
+    //
+    // Add it to the table of hooked pages (used for lookups)
+    //
+    EptHookAddToHookedPagesTable(HookedPage);
+
     //
     // if not launched, there is no need to modify it on a safe environment
     //
@@ -1042,6 +1747,86 @@ EptHookPerformPageHook2(PVOID    TargetAddress,
     return TRUE;
 }
 
+/**
+ * @brief Validate the hook attributes and build the page hook mask of the VMCALL
+ * @details it also initializes the list of ept hook detours if it's not already initialized
+ *
+ * @param SetHookForRead Hook READ Access
+ * @param SetHookForWrite Hook WRITE Access
+ * @param SetHookForExec Hook EXECUTE Access
+ * @param EptHiddenHook2 epthook2 style hook
+ * @param PageHookMask The result mask
+ * @return BOOLEAN Returns true if the attributes are valid
+ */
+static BOOLEAN
+EptHook2GetPageHookMask(BOOLEAN  SetHookForRead,
+                        BOOLEAN  SetHookForWrite,
+                        BOOLEAN  SetHookForExec,
+                        BOOLEAN  EptHiddenHook2,
+                        UINT32 * PageHookMask)
+{
+    *PageHookMask = 0;
+
+    //
+    // Check for the features to avoid EPT Violation problems
+    //
+    if (SetHookForExec && !g_CompatibilityCheck.ExecuteOnlySupport)
+    {
+        //
+        // In the current design of hyperdbg we use execute-only pages
+        // to implement hidden hooks for exec page, so your processor doesn't
+        // have this feature and you have to implment it in other ways :(
+        //
+        return FALSE;
+    }
+
+    if (!SetHookForWrite && SetHookForRead)
+    {
+        //
+        // The hidden hook with Write Enable and Read Disabled will cause EPT violation!
+        // fixed
+        return FALSE;
+    }
+
+    //
+    // Initialize the list of ept hook detours if it's not already initialized
+    //
+    if (!g_IsEptHook2sDetourListInitialized)
+    {
+        g_IsEptHook2sDetourListInitialized = TRUE;
+
+        InitializeListHead(&g_EptHook2sDetourListHead);
+        InitializeListHead(&g_EptHookTrampolinesSlabsListHead);
+    }
+
+    if (SetHookForRead)
+    {
+        *PageHookMask |= PAGE_ATTRIB_READ;
+    }
+    if (SetHookForWrite)
+    {
+        *PageHookMask |= PAGE_ATTRIB_WRITE;
+    }
+    if (SetHookForExec)
+    {
+        *PageHookMask |= PAGE_ATTRIB_EXEC;
+    }
+    if (EptHiddenHook2)
+    {
+        *PageHookMask |= PAGE_ATTRIB_EXEC_HIDDEN_HOOK;
+    }
+
+    if (*PageHookMask == 0)
+    {
+        //
+        // nothing to hook
+        //
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
 /**
  * @brief This function allocates a buffer in VMX Non Root Mode and then invokes a VMCALL to set the hook
  * @details this command uses hidden detours, this NOT be called from vmx-root mode
@@ -1067,126 +1852,450 @@ EptHook2(PVOID   TargetAddress,
          BOOLEAN EptHiddenHook2)
 {
     UINT32 PageHookMask = 0;
-    ULONG  LogicalCoreIndex;
+
+    if (!EptHook2GetPageHookMask(SetHookForRead, SetHookForWrite, SetHookForExec, EptHiddenHook2, &PageHookMask))
+    {
+        return FALSE;
+    }
+
+    if (VmxGetCurrentLaunchState())
+    {
+        //
+        // Move Attribute Mask to the upper 32 bits of the VMCALL Number
+        //
+        UINT64 VmcallNumber = ((UINT64)PageHookMask) << 32 | VMCALL_CHANGE_PAGE_ATTRIB;
+
+        if (AsmVmxVmcall(VmcallNumber, TargetAddress, HookFunction, LayoutGetCr3ByProcessId(ProcessId).Flags) == STATUS_SUCCESS)
+        {
+            //
+            // Test log
+            //
+            // LogInfo("Hook applied from VMX Root Mode");
+            //
+
+            if (VmxGetCurrentExecutionMode() == FALSE)
+            {
+                //
+                // Now we have to notify all the core to invalidate their EPT
+                //
+                BroadcastNotifyAllToInvalidateEptAllCores();
+            }
+            else
+            {
+                LogInfo("Err, unable to notify all cores to invalidate their TLB "
+                        "caches as you called hook on vmx-root mode, however, the "
+                        "hook is still works");
+            }
+
+            return TRUE;
+        }
+        else
+        {
+            return FALSE;
+        }
+    }
+    else
+    {
+        if (EptHookPerformPageHook2(TargetAddress,
+                                    HookFunction,
+                                    LayoutGetCr3ByProcessId(ProcessId),
+                                    SetHookForRead,
+                                    SetHookForWrite,
+                                    SetHookForExec,
+                                    EptHiddenHook2,
+                                    FALSE) == TRUE)
+        {
+            LogInfo("Hook applied (VM has not launched)");
+            return TRUE;
+        }
+    }
+
+    //
+    // There was a error, we shouldn't reach here
+    //
+    LogWarning("Err, hook was not applied");
+
+    return FALSE;
+}
+
+/**
+ * @brief This function monitors a whole 2MB page by invoking a VMCALL
+ * @details the 2MB page is not split, so it's only applicable when the target
+ * address is the start of a 2MB page that is mapped by a large page in the target
+ * process and no other hook is applied on that 2MB page, this NOT be called from
+ * vmx-root mode
+ *
+ * @param TargetAddress The start address of the 2MB page
+ * @param ProcessId The process id to translate based on that process's cr3
+ * @param SetHookForRead Hook READ Access
+ * @param SetHookForWrite Hook WRITE Access
+ * @param SetHookForExec Hook EXECUTE Access
+ *
+ * @return BOOLEAN Returns true if the hook was successful or false if there was an error
+ */
+BOOLEAN
+EptHookMonitorLargePage(PVOID   TargetAddress,
+                        UINT32  ProcessId,
+                        BOOLEAN SetHookForRead,
+                        BOOLEAN SetHookForWrite,
+                        BOOLEAN SetHookForExec)
+{
+    UINT32 PageHookMask = 0;
+    UINT64 VmcallNumber;
+
+    //
+    // Should be called from vmx non-root (broadcasting is not possible in vmx-root)
+    //
+    if (VmxGetCurrentExecutionMode() == TRUE || !VmxGetCurrentLaunchState())
+    {
+        return FALSE;
+    }
+
+    if (!EptHook2GetPageHookMask(SetHookForRead, SetHookForWrite, SetHookForExec, FALSE, &PageHookMask))
+    {
+        return FALSE;
+    }
+
+    PageHookMask |= PAGE_ATTRIB_LARGE_PAGE;
+
+    //
+    // Move Attribute Mask to the upper 32 bits of the VMCALL Number
+    //
+    VmcallNumber = ((UINT64)PageHookMask) << 32 | VMCALL_CHANGE_PAGE_ATTRIB;
+
+    if (AsmVmxVmcall(VmcallNumber, TargetAddress, NULL, LayoutGetCr3ByProcessId(ProcessId).Flags) != STATUS_SUCCESS)
+    {
+        return FALSE;
+    }
+
+    //
+    // Now we have to notify all the core to invalidate their EPT
+    //
+    BroadcastNotifyAllToInvalidateEptAllCores();
+
+    return TRUE;
+}
+
+/**
+ * @brief Monitor a page (read/write/execute) directly from vmx-root
+ * @details the page is split and tracked by the pre-allocated buffers, so
+ * the buffers should be reserved before (EptHookAllocateExtraHookingPages),
+ * the other cores invalidate their EPT caches on their next vm-exit, this
+ * function should be called from vmx-root
+ *
+ * @param TargetAddress The address to be monitored
+ * @param ProcessCr3 The process cr3 to translate based on that process's cr3
+ * @param SetHookForRead Hook READ Access
+ * @param SetHookForWrite Hook WRITE Access
+ * @param SetHookForExec Hook EXECUTE Access
+ * @param PhysicalBaseAddress The physical address of the monitored page
+ * (used for unhooking it)
+ *
+ * @return BOOLEAN Returns true if the hook was successful or false if there was an error
+ */
+BOOLEAN
+EptHookMonitorPageFromVmxRoot(PVOID    TargetAddress,
+                              CR3_TYPE ProcessCr3,
+                              BOOLEAN  SetHookForRead,
+                              BOOLEAN  SetHookForWrite,
+                              BOOLEAN  SetHookForExec,
+                              UINT64 * PhysicalBaseAddress)
+{
+    UINT32  PageHookMask;
+    BOOLEAN Result;
+
+    //
+    // Should be called from vmx-root, for calling from vmx non-root use EptHook2
+    //
+    if (VmxGetCurrentExecutionMode() == FALSE)
+    {
+        return FALSE;
+    }
+
+    if (!EptHook2GetPageHookMask(SetHookForRead, SetHookForWrite, SetHookForExec, FALSE, &PageHookMask))
+    {
+        VmmCallbackSetLastError(DEBUGGER_ERROR_EVENT_TYPE_IS_INVALID);
+        return FALSE;
+    }
+
+    *PhysicalBaseAddress = (UINT64)PAGE_ALIGN(VirtualAddressToPhysicalAddressByProcessCr3(TargetAddress, ProcessCr3));
+
+    //
+    // The other cores might also apply their hooks from vmx-root
+    //
+    SpinlockLock(&EptHookVmxRootLock);
+
+    Result = EptHookPerformPageHook2(TargetAddress,
+                                     NULL,
+                                     ProcessCr3,
+                                     SetHookForRead,
+                                     SetHookForWrite,
+                                     SetHookForExec,
+                                     FALSE,
+                                     FALSE);
+
+    SpinlockUnlock(&EptHookVmxRootLock);
+
+    if (Result)
+    {
+        //
+        // The current core is already invalidated, the other cores might
+        // have cached the previous permissions of the page
+        //
+        VmcsPendingUpdatesInvalidateEpt(DEBUGGER_BROADCASTING_ALL_CORES_MASK);
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Remove a monitor hook of a page directly from vmx-root
+ * @details the tracking details of the page are freed on the next
+ * deallocation of the pool manager, the split 2MB page is merged once
+ * hooks are removed from vmx non-root, this function should be called
+ * from vmx-root
+ *
+ * @param PhysicalBaseAddress The physical address of the monitored page
+ *
+ * @return BOOLEAN Returns true if the page was unhooked
+ */
+BOOLEAN
+EptHookUnHookSinglePageFromVmxRoot(UINT64 PhysicalBaseAddress)
+{
+    PEPT_HOOKED_PAGE_DETAIL HookedEntry;
+
+    //
+    // Should be called from vmx-root, for calling from vmx non-root use EptHookUnHookSingleAddress
+    //
+    if (VmxGetCurrentExecutionMode() == FALSE)
+    {
+        return FALSE;
+    }
+
+    SpinlockLock(&EptHookVmxRootLock);
+
+    HookedEntry = EptHookFindByPhysAddress(PAGE_ALIGN(PhysicalBaseAddress));
+
+    //
+    // Only the monitor hooks are removed here (hidden breakpoints and
+    // hidden detours need to be removed from vmx non-root)
+    //
+    if (HookedEntry == NULL || HookedEntry->IsExecutionHook || HookedEntry->IsHiddenBreakpoint || HookedEntry->IsLargePage)
+    {
+        SpinlockUnlock(&EptHookVmxRootLock);
+        return FALSE;
+    }
+
+    EptSetPML1AndInvalidateTLB(HookedEntry->EntryAddress, HookedEntry->OriginalEntry, InveptSingleContext);
+
+    RemoveEntryList(&HookedEntry->PageHookList);
+    EptHookRemoveFromHookedPagesTable(HookedEntry);
+
+    SpinlockUnlock(&EptHookVmxRootLock);
+
+    //
+    // The other cores might still have the hooked permissions of the page,
+    // their EPT violations are ignored until they invalidate their caches
+    //
+    VmcsPendingUpdatesInvalidateEpt(DEBUGGER_BROADCASTING_ALL_CORES_MASK);
+
+    //
+    // The pool is freed on the next deallocation in vmx non-root, so the
+    // other cores that are handling an EPT violation on this page won't
+    // access a freed pool
+    //
+    PoolManagerFreePool(HookedEntry);
+
+    return TRUE;
+}
+
+/**
+ * @brief Perform the VMCALLs of the hooks of a batch in one vm-exit
+ *
+ * @param Entries The hooks
+ * @param VmcallEntries The VMCALLs of the hooks
+ * @param VmcallIndexes The index of the hook of each VMCALL in the entries
+ * @param CountOfVmcalls Count of the VMCALLs
+ * @return UINT32 Count of the hooks that are applied successfully
+ */
+static UINT32
+EptHookBatchPerformVmcalls(PEPT_HOOKS_BATCH_ENTRY Entries,
+                           PVMCALL_BATCH_ENTRY    VmcallEntries,
+                           UINT32 *               VmcallIndexes,
+                           UINT32                 CountOfVmcalls)
+{
+    UINT32 CountOfAppliedHooks = 0;
 
     //
-    // Check for the features to avoid EPT Violation problems
+    // The result of each of the VMCALLs is saved into its status
     //
-    if (SetHookForExec && !g_CompatibilityCheck.ExecuteOnlySupport)
-    {
-        //
-        // In the current design of hyperdbg we use execute-only pages
-        // to implement hidden hooks for exec page, so your processor doesn't
-        // have this feature and you have to implment it in other ways :(
-        //
-        return FALSE;
-    }
+    AsmVmxVmcall(VMCALL_BATCH, (UINT64)VmcallEntries, CountOfVmcalls, NULL);
 
-    if (!SetHookForWrite && SetHookForRead)
+    for (UINT32 i = 0; i < CountOfVmcalls; i++)
     {
-        //
-        // The hidden hook with Write Enable and Read Disabled will cause EPT violation!
-        // fixed
-        return FALSE;
+        if (VmcallEntries[i].Status == STATUS_SUCCESS)
+        {
+            Entries[VmcallIndexes[i]].KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+            CountOfAppliedHooks++;
+        }
     }
 
+    return CountOfAppliedHooks;
+}
+
+/**
+ * @brief Apply multiple hooks (hidden breakpoints, hidden detours and monitors) at once
+ *
+ * @details the pages that are needed for the hooks are allocated before applying the
+ * hooks and instead of notifying all the cores to invalidate their EPT after each hook,
+ * all the cores are notified once after applying all of the hooks, the hooks are
+ * also applied by batches of VMCALLs (VMCALL_BATCH) to avoid a vm-exit per hook,
+ * this function should be called from vmx non-root in PASSIVE_LEVEL
+ *
+ * @param Entries The hooks, the result of each hook is saved into its KernelStatus
+ * @param Count Count of the entries
+ * @return UINT32 Count of the hooks that are applied successfully
+ */
+UINT32
+EptHookBatch(PEPT_HOOKS_BATCH_ENTRY Entries, UINT32 Count)
+{
+    UINT32              PageHookMask;
+    UINT32              ProcessId;
+    PVMCALL_BATCH_ENTRY VmcallEntries;
+    UINT32              VmcallIndexes[VMCALL_BATCH_MAXIMUM_ENTRIES];
+    UINT32              CountOfVmcalls       = 0;
+    UINT32              CountOfAppliedHooks  = 0;
+    BOOLEAN             HasHiddenBreakpoints = FALSE;
+
     //
-    // Initialize the list of ept hook detours if it's not already initialized
+    // Should be called from vmx non-root (broadcasting is not possible in vmx-root)
     //
-    if (!g_IsEptHook2sDetourListInitialized)
+    if (VmxGetCurrentExecutionMode() == TRUE || !VmxGetCurrentLaunchState())
     {
-        g_IsEptHook2sDetourListInitialized = TRUE;
-
-        InitializeListHead(&g_EptHook2sDetourListHead);
+        return 0;
     }
 
     //
-    // Check whether we are in VMX Root Mode or Not
+    // The VMCALLs of the batch are read in vmx-root, so they should be nonpaged
     //
-    LogicalCoreIndex = KeGetCurrentProcessorIndex();
+    VmcallEntries = ExAllocatePoolWithTag(NonPagedPool, sizeof(VMCALL_BATCH_ENTRY) * VMCALL_BATCH_MAXIMUM_ENTRIES, POOLTAG);
 
-    if (SetHookForRead)
+    if (VmcallEntries == NULL)
     {
-        PageHookMask |= PAGE_ATTRIB_READ;
+        return 0;
     }
-    if (SetHookForWrite)
-    {
-        PageHookMask |= PAGE_ATTRIB_WRITE;
-    }
-    if (SetHookForExec)
-    {
-        PageHookMask |= PAGE_ATTRIB_EXEC;
-    }
-    if (EptHiddenHook2)
+
+    //
+    // Allocate the pages of all of the hooks (splitting 2MB pages and the details
+    // of hooked pages) here, as we're in PASSIVE_LEVEL
+    //
+    EptHookAllocateExtraHookingPages(Count);
+    PoolManagerCheckAndPerformAllocationAndDeallocation();
+
+    for (UINT32 i = 0; i < Count; i++)
     {
-        PageHookMask |= PAGE_ATTRIB_EXEC_HIDDEN_HOOK;
+        if (Entries[i].HookType == EPT_HOOKS_BATCH_HIDDEN_BREAKPOINT)
+        {
+            HasHiddenBreakpoints = TRUE;
+            break;
+        }
     }
 
-    if (PageHookMask == 0)
+    if (HasHiddenBreakpoints)
     {
         //
-        // nothing to hook
+        // Broadcast to all cores to enable vm-exit for breakpoints (exception bitmaps)
         //
-        return FALSE;
+        BroadcastEnableBreakpointExitingOnExceptionBitmapAllCores();
     }
 
-    if (VmxGetCurrentLaunchState())
+    for (UINT32 i = 0; i < Count; i++)
     {
+        Entries[i].KernelStatus = DEBUGGER_ERROR_COULD_NOT_BUILD_THE_EPT_HOOK;
+
+        ProcessId = Entries[i].ProcessId;
+
+        if (ProcessId == DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES || ProcessId == 0)
+        {
+            ProcessId = PsGetCurrentProcessId();
+        }
+
         //
-        // Move Attribute Mask to the upper 32 bits of the VMCALL Number
+        // Each hook is applied on the current core (the EPT table is shared between
+        // the cores), other cores are notified once all the hooks are applied
         //
-        UINT64 VmcallNumber = ((UINT64)PageHookMask) << 32 | VMCALL_CHANGE_PAGE_ATTRIB;
-
-        if (AsmVmxVmcall(VmcallNumber, TargetAddress, HookFunction, LayoutGetCr3ByProcessId(ProcessId).Flags) == STATUS_SUCCESS)
+        switch (Entries[i].HookType)
         {
-            //
-            // Test log
-            //
-            // LogInfo("Hook applied from VMX Root Mode");
-            //
+        case EPT_HOOKS_BATCH_HIDDEN_BREAKPOINT:
 
-            if (VmxGetCurrentExecutionMode() == FALSE)
+            VmcallEntries[CountOfVmcalls].VmcallNumber   = VMCALL_SET_HIDDEN_CC_BREAKPOINT;
+            VmcallEntries[CountOfVmcalls].OptionalParam1 = Entries[i].VirtualAddress;
+            VmcallEntries[CountOfVmcalls].OptionalParam2 = LayoutGetCr3ByProcessId(ProcessId).Flags;
+            VmcallEntries[CountOfVmcalls].OptionalParam3 = NULL;
+
+            break;
+
+        case EPT_HOOKS_BATCH_HIDDEN_DETOURS:
+        case EPT_HOOKS_BATCH_MONITOR:
+
+            if (Entries[i].HookType == EPT_HOOKS_BATCH_HIDDEN_DETOURS)
             {
-                //
-                // Now we have to notify all the core to invalidate their EPT
-                //
-                BroadcastNotifyAllToInvalidateEptAllCores();
+                if (!EptHook2GetPageHookMask(FALSE, FALSE, FALSE, TRUE, &PageHookMask))
+                {
+                    continue;
+                }
             }
-            else
+            else if (!EptHook2GetPageHookMask(Entries[i].SetHookForRead,
+                                              Entries[i].SetHookForWrite,
+                                              Entries[i].SetHookForExec,
+                                              FALSE,
+                                              &PageHookMask))
             {
-                LogInfo("Err, unable to notify all cores to invalidate their TLB "
-                        "caches as you called hook on vmx-root mode, however, the "
-                        "hook is still works");
+                continue;
             }
 
-            return TRUE;
-        }
-        else
-        {
-            return FALSE;
+            //
+            // Move Attribute Mask to the upper 32 bits of the VMCALL Number
+            //
+            VmcallEntries[CountOfVmcalls].VmcallNumber   = ((UINT64)PageHookMask) << 32 | VMCALL_CHANGE_PAGE_ATTRIB;
+            VmcallEntries[CountOfVmcalls].OptionalParam1 = Entries[i].VirtualAddress;
+            VmcallEntries[CountOfVmcalls].OptionalParam2 = NULL;
+            VmcallEntries[CountOfVmcalls].OptionalParam3 = LayoutGetCr3ByProcessId(ProcessId).Flags;
+
+            break;
+
+        default:
+            continue;
         }
-    }
-    else
-    {
-        if (EptHookPerformPageHook2(TargetAddress,
-                                    HookFunction,
-                                    LayoutGetCr3ByProcessId(ProcessId),
-                                    SetHookForRead,
-                                    SetHookForWrite,
-                                    SetHookForExec,
-                                    EptHiddenHook2) == TRUE)
+
+        VmcallIndexes[CountOfVmcalls++] = i;
+
+        if (CountOfVmcalls == VMCALL_BATCH_MAXIMUM_ENTRIES)
         {
-            LogInfo("Hook applied (VM has not launched)");
-            return TRUE;
+            CountOfAppliedHooks += EptHookBatchPerformVmcalls(Entries, VmcallEntries, VmcallIndexes, CountOfVmcalls);
+            CountOfVmcalls = 0;
         }
     }
 
     //
-    // There was a error, we shouldn't reach here
+    // Perform the remaining VMCALLs
     //
-    LogWarning("Err, hook was not applied");
+    if (CountOfVmcalls != 0)
+    {
+        CountOfAppliedHooks += EptHookBatchPerformVmcalls(Entries, VmcallEntries, VmcallIndexes, CountOfVmcalls);
+    }
 
-    return FALSE;
+    ExFreePoolWithTag(VmcallEntries, POOLTAG);
+
+    if (CountOfAppliedHooks != 0)
+    {
+        //
+        // Now we have to notify all the core to invalidate their EPT (only once)
+        //
+        BroadcastNotifyAllToInvalidateEptAllCores();
+    }
+
+    return CountOfAppliedHooks;
 }
 
 /**
@@ -1222,8 +2331,16 @@ EptHookHandleHookedPage(VIRTUAL_MACHINE_STATE *              VCpu,
     //
     // Get alignment
     //
-    AlignedVirtualAddress  = PAGE_ALIGN(HookedEntryDetails->VirtualAddress);
-    AlignedPhysicalAddress = PAGE_ALIGN(PhysicalAddress);
+    if (HookedEntryDetails->IsLargePage)
+    {
+        AlignedVirtualAddress  = LARGE_PAGE_ALIGN(HookedEntryDetails->VirtualAddress);
+        AlignedPhysicalAddress = LARGE_PAGE_ALIGN(PhysicalAddress);
+    }
+    else
+    {
+        AlignedVirtualAddress  = PAGE_ALIGN(HookedEntryDetails->VirtualAddress);
+        AlignedPhysicalAddress = PAGE_ALIGN(PhysicalAddress);
+    }
 
     //
     // Let's read the exact address that was accessed
@@ -1395,10 +2512,16 @@ EptHookUnHookSingleAddressDetours(PEPT_HOOKED_PAGE_DETAIL HookedEntry)
     //
     EptHookRemoveEntryAndFreePoolFromEptHook2sDetourList(HookedEntry->VirtualAddress);
 
+    if (HookedEntry->Trampoline != NULL)
+    {
+        EptHookReleaseTrampoline(HookedEntry->Trampoline);
+    }
+
     //
     // remove the entry from the list
     //
     RemoveEntryList(&HookedEntry->PageHookList);
+    EptHookRemoveFromHookedPagesTable(HookedEntry);
 
     //
     // we add the hooked entry to the list
@@ -1427,121 +2550,98 @@ EptHookUnHookSingleAddressHiddenBreakpoint(PEPT_HOOKED_PAGE_DETAIL HookedEntry,
 {
     UINT64 TargetAddressInFakePageContent;
     UINT64 PageOffset;
-    UINT32 CountOfEntriesWithSameAddr = 0;
+    UINT32 Index;
+
+    PageOffset = PAGE_OFFSET(VirtualAddress);
 
     //
-    // It's a hidden breakpoint (we have to search through an array of addresses)
-    // We count it from top to down because if there are two ept hooks at the
-    // same address, then the last one has an invalid PreviousByte and this
-    // is the HookedEntry that should be remove (not the first one as it has the
-    // correct PreviousByte)
+    // It's a hidden breakpoint (we have to search through the breakpoints of the page)
     //
-    for (size_t i = HookedEntry->CountOfBreakpoints; i-- > 0;)
+    if (!EptHookSearchHiddenBreakpoints(HookedEntry, (UINT16)PageOffset, &Index))
     {
-        if (HookedEntry->BreakpointAddresses[i] == VirtualAddress)
-        {
-            //
-            // Check if it's a single breakpoint
-            //
-            if (HookedEntry->CountOfBreakpoints == 1)
-            {
-                //
-                // Remove the hook entirely on all cores
-                //
-                KeGenericCallDpc(DpcRoutineRemoveHookAndInvalidateSingleEntryOnAllCores, HookedEntry->PhysicalBaseAddress);
+        //
+        // If we reach here, sth went wrong
+        //
+        return FALSE;
+    }
 
-                //
-                // remove the entry from the list
-                //
-                RemoveEntryList(&HookedEntry->PageHookList);
+    //
+    // Check if it's a single breakpoint
+    //
+    if (HookedEntry->CountOfBreakpoints == 1 && HookedEntry->Breakpoints[Index].Count == 1)
+    {
+        //
+        // Remove the hook entirely on all cores
+        //
+        KeGenericCallDpc(DpcRoutineRemoveHookAndInvalidateSingleEntryOnAllCores, HookedEntry->PhysicalBaseAddress);
 
-                //
-                // we add the hooked entry to the list
-                // of pools that will be deallocated on next IOCTL
-                //
-                if (!PoolManagerFreePool(HookedEntry))
-                {
-                    LogError("Err, something goes wrong, the pool not found in the list of previously allocated pools by pool manager");
-                }
+        //
+        // remove the entry from the list
+        //
+        RemoveEntryList(&HookedEntry->PageHookList);
+        EptHookRemoveFromHookedPagesTable(HookedEntry);
 
-                //
-                // Check if there is any other breakpoints, if no then we have to disalbe
-                // exception bitmaps on vm-exits for breakpoint, for this purpose, we have
-                // to visit all the entries to see if there is any entries
-                //
-                if (EptHookGetCountOfEpthooks(FALSE) == 0)
-                {
-                    //
-                    // Did not find any entry, let's disable the breakpoints vm-exits
-                    // on exception bitmaps
-                    //
-                    BroadcastDisableBreakpointExitingOnExceptionBitmapAllCores();
-                }
+        //
+        // we add the hooked entry (and its breakpoints) to the list
+        // of pools that will be deallocated on next IOCTL
+        //
+        EptHookFreeHiddenBreakpointsSet(HookedEntry);
 
-                return TRUE;
-            }
-            else
-            {
-                //
-                // Set 0xcc to its previous value
-                //
-                TargetAddressInFakePageContent = &HookedEntry->FakePageContents;
-                TargetAddressInFakePageContent = PAGE_ALIGN(TargetAddressInFakePageContent);
-                PageOffset                     = PAGE_OFFSET(VirtualAddress);
-                TargetAddressInFakePageContent = TargetAddressInFakePageContent + PageOffset;
+        if (!PoolManagerFreePool(HookedEntry))
+        {
+            LogError("Err, something goes wrong, the pool not found in the list of previously allocated pools by pool manager");
+        }
 
-                //
-                // We'll check if there is another hooked address with the same virtual address
-                // in the array, then we'll ignore setting the previous bit as previous bit might
-                // be modified for the previous command
-                //
-                for (size_t j = 0; j < HookedEntry->CountOfBreakpoints; j++)
-                {
-                    if (HookedEntry->BreakpointAddresses[i] == VirtualAddress)
-                    {
-                        CountOfEntriesWithSameAddr++;
-                    }
-                }
+        //
+        // Check if there is any other breakpoints, if no then we have to disalbe
+        // exception bitmaps on vm-exits for breakpoint, for this purpose, we have
+        // to visit all the entries to see if there is any entries
+        //
+        if (EptHookGetCountOfEpthooks(FALSE) == 0)
+        {
+            //
+            // Did not find any entry, let's disable the breakpoints vm-exits
+            // on exception bitmaps
+            //
+            BroadcastDisableBreakpointExitingOnExceptionBitmapAllCores();
+        }
 
-                if (CountOfEntriesWithSameAddr == 1)
-                {
-                    //
-                    // Set the previous value
-                    //
-                    *(BYTE *)TargetAddressInFakePageContent = HookedEntry->PreviousBytesOnBreakpointAddresses[i];
-                }
+        return TRUE;
+    }
 
-                //
-                // Remove just that special entry
-                // Btw, No need to remove it, it will be replaced automatically
-                //
-                HookedEntry->BreakpointAddresses[i]                = NULL;
-                HookedEntry->PreviousBytesOnBreakpointAddresses[i] = 0x0;
+    //
+    // If there is another breakpoint on the same address, we just decrease its
+    // counter as the previous byte should remain 0xcc
+    //
+    HookedEntry->Breakpoints[Index].Count--;
 
-                //
-                // all addresses to a lower array index (because one entry is
-                // missing and might) be in the middle of the array
-                //
-                for (size_t j = i; j < MaximumHiddenBreakpointsOnPage - 1; j++)
-                {
-                    HookedEntry->BreakpointAddresses[j]                = HookedEntry->BreakpointAddresses[j + 1];
-                    HookedEntry->PreviousBytesOnBreakpointAddresses[j] = HookedEntry->PreviousBytesOnBreakpointAddresses[j + 1];
-                }
+    if (HookedEntry->Breakpoints[Index].Count != 0)
+    {
+        return TRUE;
+    }
 
-                //
-                // Decrease the count of breakpoints
-                //
-                HookedEntry->CountOfBreakpoints = HookedEntry->CountOfBreakpoints - 1;
+    //
+    // Set 0xcc to its previous value
+    //
+    TargetAddressInFakePageContent = &HookedEntry->FakePageContents;
+    TargetAddressInFakePageContent = PAGE_ALIGN(TargetAddressInFakePageContent);
+    TargetAddressInFakePageContent = TargetAddressInFakePageContent + PageOffset;
 
-                return TRUE;
-            }
-        }
-    }
+    *(BYTE *)TargetAddressInFakePageContent = HookedEntry->Breakpoints[Index].PreviousByte;
 
     //
-    // If we reach here, sth went wrong
+    // Remove just that special entry (the breakpoints remain sorted)
     //
-    return FALSE;
+    RtlMoveMemory(&HookedEntry->Breakpoints[Index],
+                  &HookedEntry->Breakpoints[Index + 1],
+                  sizeof(EPT_HIDDEN_BREAKPOINT) * (HookedEntry->CountOfBreakpoints - Index - 1));
+
+    //
+    // Decrease the count of breakpoints
+    //
+    HookedEntry->CountOfBreakpoints = HookedEntry->CountOfBreakpoints - 1;
+
+    return TRUE;
 }
 
 /**
@@ -1558,7 +2658,8 @@ EptHookUnHookSingleAddressHiddenBreakpoint(PEPT_HOOKED_PAGE_DETAIL HookedEntry,
 BOOLEAN
 EptHookUnHookSingleAddress(UINT64 VirtualAddress, UINT64 PhysAddress, UINT32 ProcessId)
 {
-    SIZE_T PhysicalAddress;
+    SIZE_T  PhysicalAddress;
+    BOOLEAN Result = FALSE;
 
     //
     // Should be called from vmx non-root
@@ -1593,10 +2694,15 @@ EptHookUnHookSingleAddress(UINT64 VirtualAddress, UINT64 PhysAddress, UINT32 Pro
         if (CurrEntity->IsHiddenBreakpoint)
         {
             //
-            // It's a hidden breakpoint
+            // It's a hidden breakpoint (the breakpoints of other pages are ignored)
             //
+            if (CurrEntity->PhysicalBaseAddress != PhysicalAddress)
+            {
+                continue;
+            }
 
-            return EptHookUnHookSingleAddressHiddenBreakpoint(CurrEntity, VirtualAddress);
+            Result = EptHookUnHookSingleAddressHiddenBreakpoint(CurrEntity, VirtualAddress);
+            break;
         }
         else
         {
@@ -1605,15 +2711,25 @@ EptHookUnHookSingleAddress(UINT64 VirtualAddress, UINT64 PhysAddress, UINT32 Pro
             //
             if (CurrEntity->PhysicalBaseAddress == PhysicalAddress)
             {
-                return EptHookUnHookSingleAddressDetours(CurrEntity);
+                Result = EptHookUnHookSingleAddressDetours(CurrEntity);
+                break;
             }
         }
     }
 
     //
-    // Nothing found , probably the list is not found
+    // The 2MB pages that are split for the removed hook are merged
+    // again if there is no other hook on them
     //
-    return FALSE;
+    if (Result)
+    {
+        EptMergeSplitLargePages();
+    }
+
+    //
+    // If nothing found, probably the list is not found
+    //
+    return Result;
 }
 
 /**
@@ -1654,6 +2770,15 @@ EptHookUnHookAll()
         if (!CurrEntity->IsHiddenBreakpoint)
         {
             EptHookRemoveEntryAndFreePoolFromEptHook2sDetourList(CurrEntity->VirtualAddress);
+
+            if (CurrEntity->Trampoline != NULL)
+            {
+                EptHookReleaseTrampoline(CurrEntity->Trampoline);
+            }
+        }
+        else
+        {
+            EptHookFreeHiddenBreakpointsSet(CurrEntity);
         }
 
         //
@@ -1665,21 +2790,57 @@ EptHookUnHookAll()
             LogError("Err, something goes wrong, the pool not found in the list of previously allocated pools by pool manager");
         }
     }
+
+    //
+    // All of the entries are freed, so the list and the table of
+    // hooked pages are empty now
+    //
+    SpinlockLock(&EptHookedPagesTableLock);
+
+    InitializeListHead(&g_EptState->HookedPagesList);
+
+    for (UINT32 i = 0; i < EPT_HOOKED_PAGES_TABLE_SIZE; i++)
+    {
+        InterlockedExchangePointer(&g_EptState->HookedPagesTable[i], NULL);
+    }
+
+    g_EptState->HookedPagesTableCount      = 0;
+    g_EptState->HookedPagesTableOverflowed = FALSE;
+    g_EptState->HookedLargePagesCount      = 0;
+
+    SpinlockUnlock(&EptHookedPagesTableLock);
+
+    //
+    // None of the split 2MB pages are used anymore, so they're merged again
+    //
+    EptMergeSplitLargePages();
 }
 
 /**
  * @brief routines to generally handle breakpoint hit for detour
+ * @details HookRecord is pushed by the dispatcher of the trampoline of the hook
+ *
  * @param Regs
  * @param CalledFrom
+ * @param HookRecord
  *
  * @return PVOID
  */
 PVOID
-EptHook2GeneralDetourEventHandler(PGUEST_REGS Regs, PVOID CalledFrom)
+EptHook2GeneralDetourEventHandler(PGUEST_REGS Regs, PVOID CalledFrom, PEPT_HOOK_TRAMPOLINE_SLOT HookRecord)
 {
-    PLIST_ENTRY       TempList    = 0;
     EPT_HOOKS_CONTEXT TempContext = {0};
 
+    //
+    // The trampoline slot is never freed, but if the hook is already removed
+    // then we just return the original caller address and continue the
+    // guest normally
+    //
+    if (!HookRecord->InUse)
+    {
+        return CalledFrom;
+    }
+
     //
     // The RSP register is the at the RCX and we just added (reverse by stack) to it's
     // values by the size of the GUEST_REGS
@@ -1698,6 +2859,8 @@ EptHook2GeneralDetourEventHandler(PGUEST_REGS Regs, PVOID CalledFrom)
     //        Regs->r9);
     //
 
+    InterlockedIncrement64(&HookRecord->HitCount);
+
     //
     // Create temporary context
     //
@@ -1721,30 +2884,50 @@ EptHook2GeneralDetourEventHandler(PGUEST_REGS Regs, PVOID CalledFrom)
     DispatchEventHiddenHookExecDetours(VCpu, &TempContext);
 
     //
-    // Iterate through the list of hooked pages details to find
-    // and return where want to jump after this functions
+    // Continue from the trampoline of the hook
     //
-    TempList = &g_EptHook2sDetourListHead;
+    return HookRecord->Trampoline;
+}
+
+/**
+ * @brief Query the hit counts of the hidden hooks detour
+ *
+ * @param HitDetails The array to store the hit counts
+ * @param MaximumCount Maximum count of entries of HitDetails
+ *
+ * @return UINT32 Count of hooks that are stored in HitDetails
+ */
+UINT32
+EptHook2QueryDetourHitCounts(PEPT_HOOK2_DETOUR_HIT_DETAILS HitDetails, UINT32 MaximumCount)
+{
+    UINT32 Count = 0;
 
-    while (&g_EptHook2sDetourListHead != TempList->Flink)
+    //
+    // No hidden hook detour is applied yet
+    //
+    if (!g_IsEptHook2sDetourListInitialized)
     {
-        TempList                                          = TempList->Flink;
-        PHIDDEN_HOOKS_DETOUR_DETAILS CurrentHookedDetails = CONTAINING_RECORD(TempList, HIDDEN_HOOKS_DETOUR_DETAILS, OtherHooksList);
+        return 0;
+    }
 
-        if (CurrentHookedDetails->HookedFunctionAddress == CalledFrom)
+    SpinlockLock(&g_EptHookTrampolinesLock);
+
+    LIST_FOR_EACH_LINK(g_EptHookTrampolinesSlabsListHead, EPT_HOOK_TRAMPOLINES_SLAB, SlabsList, CurrentSlab)
+    {
+        for (UINT32 i = 0; i < EPT_HOOK_TRAMPOLINES_PER_SLAB && Count < MaximumCount; i++)
         {
-            return CurrentHookedDetails->ReturnAddress;
+            if (CurrentSlab->Slots[i].InUse)
+            {
+                HitDetails[Count].HookedFunctionAddress = CurrentSlab->Slots[i].TargetAddress;
+                HitDetails[Count].HitCount              = CurrentSlab->Slots[i].HitCount;
+                Count++;
+            }
         }
     }
 
-    //
-    // If we reach here, means that we didn't find the return address
-    // that's an error, generally we can't do anything but as the user
-    // might already cleaned the hook and the structures are removed
-    // so we just return the original caller address and continue the
-    // guest normally
-    //
-    return CalledFrom;
+    SpinlockUnlock(&g_EptHookTrampolinesLock);
+
+    return Count;
 }
 
 /**
@@ -1797,22 +2980,26 @@ EptHookModifyInstructionFetchState(VIRTUAL_MACHINE_STATE * VCpu,
         {
             if (IsUnset)
             {
-                ((PEPT_PML2_ENTRY)PmlEntry)->ExecuteAccess = FALSE;
+                ((PEPT_PML2_ENTRY)PmlEntry)->ExecuteAccess   = FALSE;
+                ((PEPT_PML2_ENTRY)PmlEntry)->UserModeExecute = FALSE;
             }
             else
             {
-                ((PEPT_PML2_ENTRY)PmlEntry)->ExecuteAccess = TRUE;
+                ((PEPT_PML2_ENTRY)PmlEntry)->ExecuteAccess   = TRUE;
+                ((PEPT_PML2_ENTRY)PmlEntry)->UserModeExecute = TRUE;
             }
         }
         else
         {
             if (IsUnset)
             {
-                ((PEPT_PML1_ENTRY)PmlEntry)->ExecuteAccess = FALSE;
+                ((PEPT_PML1_ENTRY)PmlEntry)->ExecuteAccess   = FALSE;
+                ((PEPT_PML1_ENTRY)PmlEntry)->UserModeExecute = FALSE;
             }
             else
             {
-                ((PEPT_PML1_ENTRY)PmlEntry)->ExecuteAccess = TRUE;
+                ((PEPT_PML1_ENTRY)PmlEntry)->ExecuteAccess   = TRUE;
+                ((PEPT_PML1_ENTRY)PmlEntry)->UserModeExecute = TRUE;
             }
         }
     }
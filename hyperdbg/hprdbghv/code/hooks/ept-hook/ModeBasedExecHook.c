@@ -70,7 +70,7 @@ ModeBasedExecHookEnableUsermodeExecution(PVMM_EPT_PAGE_TABLE EptTable)
         //
         // We only set the top-level PML4 for intercepting user-mode execution
         //
-        EptTable->PML4[i].UserModeExecute = FALSE;
+        EptTable->PML4[i].UserModeExecute = TRUE;
     }
 
     //
@@ -159,3 +159,471 @@ ModeBasedExecHookUninitialize()
     //
     g_ModeBasedExecutionControlState = FALSE;
 }
+
+/**
+ * @brief Get the first slot of a physical address in the table of traced pages
+ *
+ * @param PhysicalAddress
+ *
+ * @return UINT32 Index of the slot
+ */
+static UINT32
+ModeBasedExecHookGetTraceTableIndex(UINT64 PhysicalAddress)
+{
+    //
+    // Fibonacci hashing of the page frame number
+    //
+    return (UINT32)(((PhysicalAddress >> PAGE_SHIFT) * 0x9E3779B97F4A7C15ULL) >> 32) & (MODE_BASED_EXEC_TRACE_TABLE_SIZE - 1);
+}
+
+/**
+ * @brief Find a traced page by its physical address
+ * @details lock-free, it can be called from vmx-root mode
+ *
+ * @param PhysicalAddress
+ *
+ * @return PMODE_BASED_EXEC_TRACED_PAGE The traced page or NULL if the page is not traced
+ */
+static PMODE_BASED_EXEC_TRACED_PAGE
+ModeBasedExecHookFindTracedPage(UINT64 PhysicalAddress)
+{
+    UINT32                                  Index;
+    PMODE_BASED_EXEC_TRACED_PAGE            CurrentPage;
+    PMODE_BASED_EXEC_TRACED_PAGE volatile * Table = g_ModeBasedExecTraceTable;
+
+    if (Table == NULL)
+    {
+        return NULL;
+    }
+
+    PhysicalAddress = (UINT64)PAGE_ALIGN(PhysicalAddress);
+    Index           = ModeBasedExecHookGetTraceTableIndex(PhysicalAddress);
+
+    for (UINT32 i = 0; i < MODE_BASED_EXEC_TRACE_TABLE_SIZE; i++)
+    {
+        CurrentPage = Table[Index];
+
+        if (CurrentPage == NULL)
+        {
+            break;
+        }
+
+        if (CurrentPage != MODE_BASED_EXEC_TRACE_TABLE_DELETED_ENTRY && CurrentPage->PhysicalAddress == PhysicalAddress)
+        {
+            return CurrentPage;
+        }
+
+        Index = (Index + 1) & (MODE_BASED_EXEC_TRACE_TABLE_SIZE - 1);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Change the execute bit of a traced page that is used for tracing
+ * @details the bit is only restored if the other execute bit of the entry is
+ * set, as the page might be made non-executable by an EPT hook in the meantime
+ *
+ * @param TracedPage
+ * @param Set
+ *
+ * @return VOID
+ */
+static VOID
+ModeBasedExecHookChangeTracedPageExecuteBit(PMODE_BASED_EXEC_TRACED_PAGE TracedPage, BOOLEAN Set)
+{
+    EPT_PML1_ENTRY BitMask = {0};
+    EPT_PML1_ENTRY CurrentEntry;
+
+    if (TracedPage->IsUserMode)
+    {
+        BitMask.UserModeExecute = 1;
+    }
+    else
+    {
+        BitMask.ExecuteAccess = 1;
+    }
+
+    if (!Set)
+    {
+        InterlockedAnd64((volatile LONG64 *)&TracedPage->EptEntry->AsUInt, ~BitMask.AsUInt);
+        return;
+    }
+
+    CurrentEntry.AsUInt = TracedPage->EptEntry->AsUInt;
+
+    if ((TracedPage->IsUserMode && CurrentEntry.ExecuteAccess) ||
+        (!TracedPage->IsUserMode && CurrentEntry.UserModeExecute))
+    {
+        InterlockedOr64((volatile LONG64 *)&TracedPage->EptEntry->AsUInt, BitMask.AsUInt);
+    }
+}
+
+/**
+ * @brief Check whether a page is traced for its first execution
+ *
+ * @param PhysicalAddress
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+ModeBasedExecHookIsPageTraced(UINT64 PhysicalAddress)
+{
+    return ModeBasedExecHookFindTracedPage(PhysicalAddress) != NULL;
+}
+
+/**
+ * @brief Trace the first execution of the pages of a range
+ * @details should be called from vmx non-root mode, MBEC is enabled on the
+ * normal EPT table (no EPTP switching) and the user-mode (or the supervisor-mode)
+ * execute bit of the pages is unset, so the first execution of each page causes
+ * a single EPT violation and the page is executable from then on
+ *
+ * @param Tag Tag of the event
+ * @param StartAddress Start virtual address of the range
+ * @param EndAddress End virtual address of the range (exclusive)
+ * @param ProcessId Process of the virtual addresses
+ * @param IsUserMode Whether the user-mode or the supervisor-mode execution is traced
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+ModeBasedExecHookTraceRange(UINT64  Tag,
+                            UINT64  StartAddress,
+                            UINT64  EndAddress,
+                            UINT32  ProcessId,
+                            BOOLEAN IsUserMode)
+{
+    UINT64                       PhysicalAddress;
+    UINT64                       VirtualAddress;
+    UINT32                       CountOfPages;
+    UINT32                       Index;
+    PVOID                        TargetBuffer;
+    PEPT_PML1_ENTRY              TargetEntry;
+    PMODE_BASED_EXEC_TRACED_PAGE TracedPage;
+    PMODE_BASED_EXEC_TRACE_RANGE Range = NULL;
+
+    //
+    // Should be called from vmx non-root (broadcasting is not possible in vmx-root)
+    //
+    if (VmxGetCurrentExecutionMode() == TRUE || !VmxGetCurrentLaunchState())
+    {
+        return FALSE;
+    }
+
+    //
+    // The reversing machine uses MBEC with its own EPT tables
+    //
+    if (!g_CompatibilityCheck.ModeBasedExecutionSupport || g_ReversingMachineInitialized ||
+        (g_ModeBasedExecutionControlState && !g_ModeBasedExecTraceEnabled))
+    {
+        VmmCallbackSetLastError(DEBUGGER_ERROR_MODE_BASED_EXECUTION_TRACE_IS_NOT_AVAILABLE);
+        return FALSE;
+    }
+
+    StartAddress = (UINT64)PAGE_ALIGN(StartAddress);
+
+    if (EndAddress <= StartAddress)
+    {
+        VmmCallbackSetLastError(DEBUGGER_ERROR_INVALID_ADDRESS);
+        return FALSE;
+    }
+
+    if ((EndAddress - StartAddress + PAGE_SIZE - 1) / PAGE_SIZE > MODE_BASED_EXEC_TRACE_TABLE_MAX_ENTRIES)
+    {
+        VmmCallbackSetLastError(DEBUGGER_ERROR_EXECUTION_TRACE_RANGE_IS_TOO_LARGE);
+        return FALSE;
+    }
+
+    CountOfPages = (UINT32)((EndAddress - StartAddress + PAGE_SIZE - 1) / PAGE_SIZE);
+
+    Range = ExAllocatePoolWithTag(NonPagedPool,
+                                  sizeof(MODE_BASED_EXEC_TRACE_RANGE) + CountOfPages * sizeof(MODE_BASED_EXEC_TRACED_PAGE),
+                                  POOLTAG);
+
+    if (Range == NULL)
+    {
+        VmmCallbackSetLastError(DEBUGGER_ERROR_PRE_ALLOCATED_BUFFER_IS_EMPTY);
+        return FALSE;
+    }
+
+    RtlZeroMemory(Range, sizeof(MODE_BASED_EXEC_TRACE_RANGE) + CountOfPages * sizeof(MODE_BASED_EXEC_TRACED_PAGE));
+
+    Range->Tag = Tag;
+
+    //
+    // The first traced range allocates the table and enables MBEC on all cores
+    //
+    if (!g_ModeBasedExecTraceEnabled)
+    {
+        g_ModeBasedExecTraceTable = ExAllocatePoolWithTag(NonPagedPool,
+                                                          MODE_BASED_EXEC_TRACE_TABLE_SIZE * sizeof(PMODE_BASED_EXEC_TRACED_PAGE),
+                                                          POOLTAG);
+
+        if (g_ModeBasedExecTraceTable == NULL)
+        {
+            ExFreePoolWithTag(Range, POOLTAG);
+
+            VmmCallbackSetLastError(DEBUGGER_ERROR_PRE_ALLOCATED_BUFFER_IS_EMPTY);
+            return FALSE;
+        }
+
+        RtlZeroMemory((PVOID)g_ModeBasedExecTraceTable, MODE_BASED_EXEC_TRACE_TABLE_SIZE * sizeof(PMODE_BASED_EXEC_TRACED_PAGE));
+
+        InitializeListHead(&g_ModeBasedExecTraceRangesList);
+        g_ModeBasedExecTraceTableCount = 0;
+
+        g_ModeBasedExecutionControlState = TRUE;
+        g_ModeBasedExecTraceEnabled      = TRUE;
+
+        BroadcastEnableModeBasedExecutionControlOnAllProcessors();
+    }
+
+    //
+    // Each 2MB page of the range might be split, allocate the buffers here
+    // as we're in PASSIVE_LEVEL
+    //
+    PoolManagerRequestAllocation(sizeof(VMM_EPT_DYNAMIC_SPLIT),
+                                 (UINT32)((EndAddress - StartAddress) / SIZE_2_MB) + 2,
+                                 SPLIT_2MB_PAGING_TO_4KB_PAGE);
+    PoolManagerCheckAndPerformAllocationAndDeallocation();
+
+    SpinlockLock(&g_ModeBasedExecTraceLock);
+
+    for (VirtualAddress = StartAddress; VirtualAddress < EndAddress; VirtualAddress += PAGE_SIZE)
+    {
+        PhysicalAddress = VirtualAddressToPhysicalAddressByProcessId((PVOID)VirtualAddress, ProcessId);
+
+        //
+        // Pages that are not present, hooked by EPT hooks, or traced by
+        // another range are not traced
+        //
+        if (PhysicalAddress == NULL ||
+            g_ModeBasedExecTraceTableCount >= MODE_BASED_EXEC_TRACE_TABLE_MAX_ENTRIES ||
+            EptHookFindByPhysAddressIncludingLargePages(PhysicalAddress) != NULL ||
+            ModeBasedExecHookFindTracedPage(PhysicalAddress) != NULL)
+        {
+            continue;
+        }
+
+        TargetBuffer = PoolManagerRequestPool(SPLIT_2MB_PAGING_TO_4KB_PAGE, TRUE, sizeof(VMM_EPT_DYNAMIC_SPLIT));
+
+        if (!TargetBuffer || !EptSplitLargePage(g_EptState->EptPageTable, TargetBuffer, PhysicalAddress))
+        {
+            continue;
+        }
+
+        TargetEntry = EptGetPml1Entry(g_EptState->EptPageTable, PhysicalAddress);
+
+        if (TargetEntry == NULL)
+        {
+            continue;
+        }
+
+        TracedPage = &Range->Pages[Range->CountOfPages];
+
+        TracedPage->PhysicalAddress = (UINT64)PAGE_ALIGN(PhysicalAddress);
+        TracedPage->VirtualAddress  = VirtualAddress;
+        TracedPage->EptEntry        = TargetEntry;
+        TracedPage->IsUserMode      = IsUserMode;
+
+        //
+        // There is always a free (or deleted) slot as the table is never full
+        //
+        Index = ModeBasedExecHookGetTraceTableIndex(TracedPage->PhysicalAddress);
+
+        while (g_ModeBasedExecTraceTable[Index] != NULL &&
+               g_ModeBasedExecTraceTable[Index] != MODE_BASED_EXEC_TRACE_TABLE_DELETED_ENTRY)
+        {
+            Index = (Index + 1) & (MODE_BASED_EXEC_TRACE_TABLE_SIZE - 1);
+        }
+
+        //
+        // The details of the page are visible before the page is visible to the lookups
+        //
+        InterlockedExchangePointer(&g_ModeBasedExecTraceTable[Index], TracedPage);
+        g_ModeBasedExecTraceTableCount++;
+        Range->CountOfPages++;
+
+        ModeBasedExecHookChangeTracedPageExecuteBit(TracedPage, FALSE);
+    }
+
+    InsertHeadList(&g_ModeBasedExecTraceRangesList, &Range->RangesList);
+
+    SpinlockUnlock(&g_ModeBasedExecTraceLock);
+
+    //
+    // Invalidate the cached mappings of the pages on all cores
+    //
+    BroadcastNotifyAllToInvalidateEptAllCores();
+
+    return TRUE;
+}
+
+/**
+ * @brief Stop tracing the pages of a range
+ * @details should be called from vmx non-root mode, MBEC is disabled once
+ * the last range is removed
+ *
+ * @param Tag Tag of the event
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+ModeBasedExecHookUntraceRange(UINT64 Tag)
+{
+    UINT32                       Index;
+    PEPT_HOOKED_PAGE_DETAIL      HookedPage;
+    PMODE_BASED_EXEC_TRACED_PAGE TracedPage;
+    PMODE_BASED_EXEC_TRACE_RANGE Range       = NULL;
+    BOOLEAN                      IsLastRange = FALSE;
+
+    //
+    // Should be called from vmx non-root (broadcasting is not possible in vmx-root)
+    //
+    if (VmxGetCurrentExecutionMode() == TRUE || !g_ModeBasedExecTraceEnabled)
+    {
+        return FALSE;
+    }
+
+    SpinlockLock(&g_ModeBasedExecTraceLock);
+
+    LIST_FOR_EACH_LINK(g_ModeBasedExecTraceRangesList, MODE_BASED_EXEC_TRACE_RANGE, RangesList, CurrentRange)
+    {
+        if (CurrentRange->Tag == Tag)
+        {
+            Range = CurrentRange;
+            break;
+        }
+    }
+
+    if (Range == NULL)
+    {
+        SpinlockUnlock(&g_ModeBasedExecTraceLock);
+        return FALSE;
+    }
+
+    RemoveEntryList(&Range->RangesList);
+
+    for (UINT32 i = 0; i < Range->CountOfPages; i++)
+    {
+        TracedPage = &Range->Pages[i];
+
+        //
+        // Remove the page from the table, the lookups shouldn't stop here
+        //
+        Index = ModeBasedExecHookGetTraceTableIndex(TracedPage->PhysicalAddress);
+
+        for (UINT32 j = 0; j < MODE_BASED_EXEC_TRACE_TABLE_SIZE; j++)
+        {
+            if (g_ModeBasedExecTraceTable[Index] == TracedPage)
+            {
+                InterlockedExchangePointer(&g_ModeBasedExecTraceTable[Index], MODE_BASED_EXEC_TRACE_TABLE_DELETED_ENTRY);
+                g_ModeBasedExecTraceTableCount--;
+                break;
+            }
+
+            Index = (Index + 1) & (MODE_BASED_EXEC_TRACE_TABLE_SIZE - 1);
+        }
+
+        ModeBasedExecHookChangeTracedPageExecuteBit(TracedPage, TRUE);
+
+        //
+        // If the page is hooked after it's traced, the entry that the hook
+        // restores should also be executable
+        //
+        HookedPage = EptHookFindByPhysAddress(TracedPage->PhysicalAddress);
+
+        if (HookedPage != NULL)
+        {
+            HookedPage->OriginalEntry.ExecuteAccess   = 1;
+            HookedPage->OriginalEntry.UserModeExecute = 1;
+        }
+    }
+
+    IsLastRange = IsListEmpty(&g_ModeBasedExecTraceRangesList);
+
+    SpinlockUnlock(&g_ModeBasedExecTraceLock);
+
+    //
+    // Invalidate the cached mappings of the pages on all cores, the vmx-root
+    // handlers can't refer to the removed pages (or the table) anymore after
+    // the broadcast
+    //
+    BroadcastNotifyAllToInvalidateEptAllCores();
+
+    if (IsLastRange)
+    {
+        BroadcastDisableModeBasedExecutionControlOnAllProcessors();
+
+        g_ModeBasedExecTraceEnabled      = FALSE;
+        g_ModeBasedExecutionControlState = FALSE;
+
+        ExFreePoolWithTag((PVOID)g_ModeBasedExecTraceTable, POOLTAG);
+        g_ModeBasedExecTraceTable = NULL;
+    }
+
+    ExFreePoolWithTag(Range, POOLTAG);
+
+    //
+    // The split 2MB pages of the range might be merged again
+    //
+    EptMergeSplitLargePages();
+
+    return TRUE;
+}
+
+/**
+ * @brief Handle EPT violations of the first execution of traced pages
+ * @details the traced execute bit of the page is set again (no MTF is needed)
+ * and the instruction is re-executed
+ *
+ * @param VCpu The virtual processor's state
+ * @param ViolationQualification
+ * @param GuestPhysicalAddr
+ *
+ * @return BOOLEAN Whether the violation is handled
+ */
+BOOLEAN
+ModeBasedExecHookHandleEptViolation(VIRTUAL_MACHINE_STATE *                VCpu,
+                                    VMX_EXIT_QUALIFICATION_EPT_VIOLATION * ViolationQualification,
+                                    UINT64                                 GuestPhysicalAddr)
+{
+    PMODE_BASED_EXEC_TRACED_PAGE TracedPage;
+    EPT_HOOKS_CONTEXT            Context;
+
+    if (!g_ModeBasedExecTraceEnabled || !ViolationQualification->ExecuteAccess)
+    {
+        return FALSE;
+    }
+
+    TracedPage = ModeBasedExecHookFindTracedPage(GuestPhysicalAddr);
+
+    if (TracedPage == NULL)
+    {
+        return FALSE;
+    }
+
+    ModeBasedExecHookChangeTracedPageExecuteBit(TracedPage, TRUE);
+
+    //
+    // Other cores might also fault on the page before their TLBs are
+    // invalidated, the event is only triggered once for each page
+    //
+    if (InterlockedExchange(&TracedPage->IsExecuted, TRUE) == FALSE)
+    {
+        Context.PhysicalAddress = GuestPhysicalAddr;
+        Context.VirtualAddress  = VCpu->LastVmexitRip;
+
+        DispatchEventPageFirstExecution(VCpu, &Context);
+    }
+
+    EptInveptSingleContext(g_EptState->EptPointer.AsUInt);
+
+    //
+    // Redo the instruction
+    //
+    HvSuppressRipIncrement(VCpu);
+
+    return TRUE;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file IdtEntryHook.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Implementation of the functions related to hooking the entries
+ * of the IDT (!interrupt2)
+ * @details the handler of a monitored vector is hooked by a hidden
+ * breakpoint, so the external-interrupt exiting is not needed and the
+ * other vectors are delivered to the guest without any vm-exit
+ *
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Get the address of the handler of a vector from the IDT of
+ * the current core
+ *
+ * @param Vector
+ * @return UINT64 The address of the handler or NULL if the entry is
+ * not present
+ */
+static UINT64
+InterruptHookGetIdtEntryAddress(UINT32 Vector)
+{
+    SEGMENT_DESCRIPTOR_INTERRUPT_GATE_64 * IdtEntries = (SEGMENT_DESCRIPTOR_INTERRUPT_GATE_64 *)AsmGetIdtBase();
+
+    if (!IdtEntries[Vector].Present)
+    {
+        return NULL;
+    }
+
+    return (UINT64)IdtEntries[Vector].OffsetLow |
+           ((UINT64)IdtEntries[Vector].OffsetMiddle << 16) |
+           ((UINT64)IdtEntries[Vector].OffsetHigh << 32);
+}
+
+/**
+ * @brief Enable the hook of the entry of a vector in the IDT
+ * @details should be called from vmx non-root, the hook is shared by
+ * all the events of the vector (reference counted), Windows uses the
+ * same handlers (KiIsrThunk) on all cores so the IDT of the current
+ * core is used
+ *
+ * @param Vector
+ * @return BOOLEAN
+ */
+BOOLEAN
+InterruptHookEnableIdtEntryHook(UINT32 Vector)
+{
+    UINT64 EntryAddress;
+
+    if (Vector < 32 || Vector >= INTERRUPT_HOOK_IDT_ENTRIES)
+    {
+        VmmCallbackSetLastError(DEBUGGER_ERROR_INTERRUPT_ENTRY_IS_NOT_SUPPORTED);
+        return FALSE;
+    }
+
+    if (g_InterruptHookIdtEntryReferences[Vector] != 0)
+    {
+        InterlockedIncrement(&g_InterruptHookIdtEntryReferences[Vector]);
+        return TRUE;
+    }
+
+    EntryAddress = InterruptHookGetIdtEntryAddress(Vector);
+
+    if (EntryAddress == NULL)
+    {
+        VmmCallbackSetLastError(DEBUGGER_ERROR_INTERRUPT_ENTRY_IS_NOT_SUPPORTED);
+        return FALSE;
+    }
+
+    //
+    // Each breakpoint should belong to a single vector
+    //
+    for (UINT32 i = 32; i < INTERRUPT_HOOK_IDT_ENTRIES; i++)
+    {
+        if (g_InterruptHookIdtEntryAddresses[i] == EntryAddress)
+        {
+            VmmCallbackSetLastError(DEBUGGER_ERROR_INTERRUPT_ENTRY_IS_NOT_SUPPORTED);
+            return FALSE;
+        }
+    }
+
+    //
+    // The address should be available before the breakpoint is hit
+    //
+    g_InterruptHookIdtEntryAddresses[Vector] = EntryAddress;
+    InterlockedOr64(&g_InterruptHookIdtEntryVectors[Vector / 64], 1ull << (Vector % 64));
+
+    if (!EptHook((PVOID)EntryAddress, HandleToUlong(PsGetCurrentProcessId())))
+    {
+        InterlockedAnd64(&g_InterruptHookIdtEntryVectors[Vector / 64], ~(1ull << (Vector % 64)));
+        g_InterruptHookIdtEntryAddresses[Vector] = NULL;
+        return FALSE;
+    }
+
+    InterlockedIncrement(&g_InterruptHookIdtEntryReferences[Vector]);
+
+    return TRUE;
+}
+
+/**
+ * @brief Disable the hook of the entry of a vector in the IDT
+ * @details should be called from vmx non-root, the hook is removed once
+ * there is no other event of the vector that uses it
+ *
+ * @param Vector
+ * @return VOID
+ */
+VOID
+InterruptHookDisableIdtEntryHook(UINT32 Vector)
+{
+    if (Vector >= INTERRUPT_HOOK_IDT_ENTRIES ||
+        g_InterruptHookIdtEntryReferences[Vector] == 0 ||
+        InterlockedDecrement(&g_InterruptHookIdtEntryReferences[Vector]) != 0)
+    {
+        return;
+    }
+
+    //
+    // The interrupts of this vector are triggered on the external-interrupt
+    // exits again (if it's enabled by other events)
+    //
+    InterlockedAnd64(&g_InterruptHookIdtEntryVectors[Vector / 64], ~(1ull << (Vector % 64)));
+
+    EptHookUnHookSingleAddress(g_InterruptHookIdtEntryAddresses[Vector], NULL, HandleToUlong(PsGetCurrentProcessId()));
+
+    //
+    // All the cores are passed through the invalidation of the unhooking,
+    // so no breakpoint of the entry is in the middle of handling
+    //
+    g_InterruptHookIdtEntryAddresses[Vector] = NULL;
+}
+
+/**
+ * @brief Check whether the entry of a vector in the IDT is hooked or not
+ *
+ * @param Vector
+ * @return BOOLEAN
+ */
+BOOLEAN
+InterruptHookIsIdtEntryHooked(UINT32 Vector)
+{
+    return Vector < INTERRUPT_HOOK_IDT_ENTRIES &&
+           (g_InterruptHookIdtEntryVectors[Vector / 64] & (1ull << (Vector % 64))) != 0;
+}
+
+/**
+ * @brief Check and handle the breakpoints of the entries of the IDT
+ * @details the instruction of the breakpoint is executed by the caller
+ * like the other hidden breakpoints
+ *
+ * @param VCpu The virtual processor's state
+ * @param GuestRip
+ * @return BOOLEAN Shows whether the breakpoint is handled or not
+ */
+_Use_decl_annotations_
+BOOLEAN
+InterruptHookCheckAndHandleIdtEntryBreakpoint(VIRTUAL_MACHINE_STATE * VCpu, UINT64 GuestRip)
+{
+    UINT64 Vectors;
+    ULONG  Index;
+
+    for (UINT32 i = 0; i < INTERRUPT_HOOK_IDT_ENTRIES / 64; i++)
+    {
+        Vectors = g_InterruptHookIdtEntryVectors[i];
+
+        while (Vectors != 0)
+        {
+            _BitScanForward64(&Index, Vectors);
+            Vectors &= Vectors - 1;
+
+            if (g_InterruptHookIdtEntryAddresses[i * 64 + Index] == GuestRip)
+            {
+                DispatchEventIdtEntryInterrupt(VCpu, i * 64 + Index);
+                return TRUE;
+            }
+        }
+    }
+
+    return FALSE;
+}
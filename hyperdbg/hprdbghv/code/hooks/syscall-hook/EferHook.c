@@ -43,8 +43,8 @@ SyscallHookConfigureEFER(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN EnableEFERSyscall
     //
     // Read previous VM-Entry and VM-Exit controls
     //
-    __vmx_vmread(VMCS_CTRL_VMENTRY_CONTROLS, &VmEntryControls);
-    __vmx_vmread(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, &VmExitControls);
+    VmxVmread(VMCS_CTRL_VMENTRY_CONTROLS, &VmEntryControls);
+    VmxVmread(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, &VmExitControls);
 
     MsrValue.AsUInt = __readmsr(IA32_EFER);
 
@@ -55,17 +55,17 @@ SyscallHookConfigureEFER(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN EnableEFERSyscall
         //
         // Set VM-Entry controls to load EFER
         //
-        __vmx_vmwrite(VMCS_CTRL_VMENTRY_CONTROLS, HvAdjustControls(VmEntryControls | VM_ENTRY_LOAD_IA32_EFER, VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_ENTRY_CTLS : IA32_VMX_ENTRY_CTLS));
+        VmxVmwrite(VMCS_CTRL_VMENTRY_CONTROLS, HvAdjustControls(VmEntryControls | VM_ENTRY_LOAD_IA32_EFER, VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_ENTRY_CTLS : IA32_VMX_ENTRY_CTLS));
 
         //
         // Set VM-Exit controls to save EFER
         //
-        __vmx_vmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, HvAdjustControls(VmExitControls | VM_EXIT_SAVE_IA32_EFER, VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_EXIT_CTLS : IA32_VMX_EXIT_CTLS));
+        VmxVmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, HvAdjustControls(VmExitControls | VM_EXIT_SAVE_IA32_EFER, VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_EXIT_CTLS : IA32_VMX_EXIT_CTLS));
 
         //
         // Set the GUEST EFER to use this value as the EFER
         //
-        __vmx_vmwrite(VMCS_GUEST_EFER, MsrValue.AsUInt);
+        VmxVmwrite(VMCS_GUEST_EFER, MsrValue.AsUInt);
 
         //
         // also, we have to set exception bitmap to cause vm-exit on #UDs
@@ -79,17 +79,17 @@ SyscallHookConfigureEFER(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN EnableEFERSyscall
         //
         // Set VM-Entry controls to load EFER
         //
-        __vmx_vmwrite(VMCS_CTRL_VMENTRY_CONTROLS, HvAdjustControls(VmEntryControls & ~VM_ENTRY_LOAD_IA32_EFER, VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_ENTRY_CTLS : IA32_VMX_ENTRY_CTLS));
+        VmxVmwrite(VMCS_CTRL_VMENTRY_CONTROLS, HvAdjustControls(VmEntryControls & ~VM_ENTRY_LOAD_IA32_EFER, VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_ENTRY_CTLS : IA32_VMX_ENTRY_CTLS));
 
         //
         // Set VM-Exit controls to save EFER
         //
-        __vmx_vmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, HvAdjustControls(VmExitControls & ~VM_EXIT_SAVE_IA32_EFER, VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_EXIT_CTLS : IA32_VMX_EXIT_CTLS));
+        VmxVmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, HvAdjustControls(VmExitControls & ~VM_EXIT_SAVE_IA32_EFER, VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_EXIT_CTLS : IA32_VMX_EXIT_CTLS));
 
         //
         // Set the GUEST EFER to use this value as the EFER
         //
-        __vmx_vmwrite(VMCS_GUEST_EFER, MsrValue.AsUInt);
+        VmxVmwrite(VMCS_GUEST_EFER, MsrValue.AsUInt);
 
         //
         // Because we're not save or load EFER on vm-exits so
@@ -123,17 +123,17 @@ SyscallHookEmulateSYSCALL(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // Reading guest's RIP
     //
-    __vmx_vmread(VMCS_GUEST_RIP, &GuestRip);
+    VmxVmread(VMCS_GUEST_RIP, &GuestRip);
 
     //
     // Reading instruction length
     //
-    __vmx_vmread(VMCS_VMEXIT_INSTRUCTION_LENGTH, &InstructionLength);
+    VmxVmread(VMCS_VMEXIT_INSTRUCTION_LENGTH, &InstructionLength);
 
     //
     // Reading guest's Rflags
     //
-    __vmx_vmread(VMCS_GUEST_RFLAGS, &GuestRflags);
+    VmxVmread(VMCS_GUEST_RFLAGS, &GuestRflags);
 
     //
     // Save the address of the instruction following SYSCALL into RCX and then
@@ -142,7 +142,7 @@ SyscallHookEmulateSYSCALL(VIRTUAL_MACHINE_STATE * VCpu)
     MsrValue        = __readmsr(IA32_LSTAR);
     VCpu->Regs->rcx = GuestRip + InstructionLength;
     GuestRip        = MsrValue;
-    __vmx_vmwrite(VMCS_GUEST_RIP, GuestRip);
+    VmxVmwrite(VMCS_GUEST_RIP, GuestRip);
 
     //
     // Save RFLAGS into R11 and then mask RFLAGS using IA32_FMASK
@@ -150,7 +150,7 @@ SyscallHookEmulateSYSCALL(VIRTUAL_MACHINE_STATE * VCpu)
     MsrValue        = __readmsr(IA32_FMASK);
     VCpu->Regs->r11 = GuestRflags;
     GuestRflags &= ~(MsrValue | X86_FLAGS_RF);
-    __vmx_vmwrite(VMCS_GUEST_RFLAGS, GuestRflags);
+    VmxVmwrite(VMCS_GUEST_RFLAGS, GuestRflags);
 
     //
     // Load the CS and SS selectors with values derived from bits 47:32 of IA32_STAR
@@ -190,13 +190,13 @@ SyscallHookEmulateSYSRET(VIRTUAL_MACHINE_STATE * VCpu)
     // Load RIP from RCX
     //
     GuestRip = VCpu->Regs->rcx;
-    __vmx_vmwrite(VMCS_GUEST_RIP, GuestRip);
+    VmxVmwrite(VMCS_GUEST_RIP, GuestRip);
 
     //
     // Load RFLAGS from R11. Clear RF, VM, reserved bits
     //
     GuestRflags = (VCpu->Regs->r11 & ~(X86_FLAGS_RF | X86_FLAGS_VM | X86_FLAGS_RESERVED_BITS)) | X86_FLAGS_FIXED;
-    __vmx_vmwrite(VMCS_GUEST_RFLAGS, GuestRflags);
+    VmxVmwrite(VMCS_GUEST_RFLAGS, GuestRflags);
 
     //
     // SYSRET loads the CS and SS selectors with values derived from bits 63:48 of IA32_STAR
@@ -217,6 +217,56 @@ SyscallHookEmulateSYSRET(VIRTUAL_MACHINE_STATE * VCpu)
     return TRUE;
 }
 
+/**
+ * @brief Set the filter of syscall numbers
+ * @details should be called from vmx non-root
+ *
+ * @param Bitmap Bitmap of the interesting syscall numbers
+ * @param IsActive Whether the syscall numbers are filtered or not
+ * @return VOID
+ */
+VOID
+SyscallHookSetFilter(UINT64 * Bitmap, BOOLEAN IsActive)
+{
+    //
+    // The filter is deactivated while the bitmap is changed, so the cores
+    // don't miss any interesting syscall
+    //
+    g_SyscallHookFilterIsActive = FALSE;
+
+    for (UINT32 i = 0; i < DEBUGGER_EVENT_SYSCALL_FILTER_MAXIMUM_NUMBER / 64; i++)
+    {
+        g_SyscallHookFilterBitmap[i] = Bitmap[i];
+    }
+
+    g_SyscallHookFilterIsActive = IsActive;
+}
+
+/**
+ * @brief Check whether the syscall events are interested in the
+ * syscall number or not
+ * @details it's checked before dispatching the syscall events, so the
+ * uninteresting syscalls are emulated without triggering the events
+ *
+ * @param SyscallNumber
+ * @return BOOLEAN Shows whether the syscall should be ignored or not
+ */
+BOOLEAN
+SyscallHookIsFilteredOut(UINT64 SyscallNumber)
+{
+    if (!g_SyscallHookFilterIsActive)
+    {
+        return FALSE;
+    }
+
+    if (SyscallNumber >= DEBUGGER_EVENT_SYSCALL_FILTER_MAXIMUM_NUMBER)
+    {
+        return TRUE;
+    }
+
+    return !(g_SyscallHookFilterBitmap[SyscallNumber / 64] & (1ull << (SyscallNumber % 64)));
+}
+
 /**
  * @brief Detect whether the #UD was because of Syscall or Sysret or not
  *
@@ -234,7 +284,7 @@ SyscallHookHandleUD(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // Reading guest's RIP
     //
-    __vmx_vmread(VMCS_GUEST_RIP, &Rip);
+    VmxVmread(VMCS_GUEST_RIP, &Rip);
 
     if (g_IsUnsafeSyscallOrSysretHandling)
     {
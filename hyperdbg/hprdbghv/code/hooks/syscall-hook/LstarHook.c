@@ -0,0 +1,143 @@
+/**
+ * @file LstarHook.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Implementation of the functions related to hooking the entry
+ * of system calls (LSTAR)
+ * @details the entry of system calls (KiSystemCall64) is hooked by a
+ * hidden breakpoint, once the breakpoint is hit, the first instruction
+ * of the entry (swapgs) is emulated, so there is a single vm-exit for
+ * each system call (no #UD and no MTF)
+ *
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Enable the hook of the entry of system calls
+ * @details should be called from vmx non-root, the hook is shared by
+ * all the events (reference counted)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+SyscallHookEnableLstarEntryHook()
+{
+    UINT64 EntryAddress;
+    UCHAR  SwapgsInstruction[] = {0x0f, 0x01, 0xf8};
+
+    if (g_SyscallHookLstarEntryReferences != 0)
+    {
+        InterlockedIncrement(&g_SyscallHookLstarEntryReferences);
+        return TRUE;
+    }
+
+    EntryAddress = __readmsr(IA32_LSTAR);
+
+    //
+    // Only the first instruction (swapgs) of the entry is emulated
+    //
+    if (RtlCompareMemory((PVOID)EntryAddress, SwapgsInstruction, sizeof(SwapgsInstruction)) != sizeof(SwapgsInstruction))
+    {
+        VmmCallbackSetLastError(DEBUGGER_ERROR_SYSCALL_ENTRY_IS_NOT_SUPPORTED);
+        return FALSE;
+    }
+
+    //
+    // The address should be available before the breakpoint is hit
+    //
+    g_SyscallHookLstarEntryAddress = EntryAddress;
+
+    if (!EptHook((PVOID)EntryAddress, HandleToUlong(PsGetCurrentProcessId())))
+    {
+        g_SyscallHookLstarEntryAddress = NULL;
+        return FALSE;
+    }
+
+    InterlockedIncrement(&g_SyscallHookLstarEntryReferences);
+
+    return TRUE;
+}
+
+/**
+ * @brief Disable the hook of the entry of system calls
+ * @details should be called from vmx non-root, the hook is removed once
+ * there is no other event that uses it
+ *
+ * @return VOID
+ */
+VOID
+SyscallHookDisableLstarEntryHook()
+{
+    if (g_SyscallHookLstarEntryReferences == 0 ||
+        InterlockedDecrement(&g_SyscallHookLstarEntryReferences) != 0)
+    {
+        return;
+    }
+
+    EptHookUnHookSingleAddress(g_SyscallHookLstarEntryAddress, NULL, HandleToUlong(PsGetCurrentProcessId()));
+
+    //
+    // All the cores are passed through the invalidation of the unhooking,
+    // so no breakpoint of the entry is in the middle of handling
+    //
+    g_SyscallHookLstarEntryAddress = NULL;
+}
+
+/**
+ * @brief Emulate the swapgs instruction (the first instruction of the
+ * entry of system calls)
+ *
+ * @param VCpu The virtual processor's state
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+SyscallHookEmulateSWAPGS(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    UINT64 GsBase;
+    UINT64 GuestRip;
+
+    UNREFERENCED_PARAMETER(VCpu);
+
+    //
+    // Exchange the GS base with the IA32_KERNEL_GS_BASE
+    //
+    VmxVmread(VMCS_GUEST_GS_BASE, &GsBase);
+    VmxVmwrite(VMCS_GUEST_GS_BASE, __readmsr(IA32_KERNEL_GS_BASE));
+    __writemsr(IA32_KERNEL_GS_BASE, GsBase);
+
+    //
+    // Skip the swapgs (0f 01 f8)
+    //
+    VmxVmread(VMCS_GUEST_RIP, &GuestRip);
+    VmxVmwrite(VMCS_GUEST_RIP, GuestRip + 3);
+}
+
+/**
+ * @brief Check and handle the breakpoint of the entry of system calls
+ *
+ * @param VCpu The virtual processor's state
+ * @param GuestRip
+ * @return BOOLEAN Shows whether the breakpoint is handled or not
+ */
+_Use_decl_annotations_
+BOOLEAN
+SyscallHookCheckAndHandleLstarEntryBreakpoint(VIRTUAL_MACHINE_STATE * VCpu, UINT64 GuestRip)
+{
+    if (g_SyscallHookLstarEntryAddress == NULL || GuestRip != g_SyscallHookLstarEntryAddress)
+    {
+        return FALSE;
+    }
+
+    //
+    // The events are filtered by the syscall number (rax) while they're
+    // triggered
+    //
+    DispatchEventLstarSyscall(VCpu);
+
+    return TRUE;
+}
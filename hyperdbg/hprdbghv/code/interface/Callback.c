@@ -307,6 +307,26 @@ VmmCallbackUnhandledEptViolation(UINT32 CoreId,
     return g_Callbacks.VmmCallbackCheckUnhandledEptViolations(CoreId, ViolationQualification, GuestPhysicalAddr);
 }
 
+/**
+ * @brief routine callback to apply the pending tasks of the debugger
+ * @param CoreId
+ *
+ * @return VOID
+ */
+VOID
+VmmCallbackApplyPendingTasks(UINT32 CoreId)
+{
+    if (g_Callbacks.VmmCallbackApplyPendingTasks == NULL)
+    {
+        //
+        // ignore it as it's not handled
+        //
+        return;
+    }
+
+    g_Callbacks.VmmCallbackApplyPendingTasks(CoreId);
+}
+
 /**
  * @brief routine callback to handle breakpoint exception
  *
@@ -374,6 +394,30 @@ DebuggingCallbackConditionalPageFaultException(UINT32 CoreId,
     return g_Callbacks.DebuggingCallbackConditionalPageFaultException(CoreId, Address, ErrorCode);
 }
 
+/**
+ * @brief routine callback to handle the overflow of the counter of the
+ * retired instructions
+ *
+ * @param CoreId
+ * @param CountOfExecutedInstructions
+ *
+ * @return VOID
+ */
+VOID
+DebuggingCallbackHandleInstructionCounterOverflow(UINT32 CoreId,
+                                                  UINT64 CountOfExecutedInstructions)
+{
+    if (g_Callbacks.DebuggingCallbackHandleInstructionCounterOverflow == NULL)
+    {
+        //
+        // ignore it
+        //
+        return;
+    }
+
+    g_Callbacks.DebuggingCallbackHandleInstructionCounterOverflow(CoreId, CountOfExecutedInstructions);
+}
+
 /**
  * @brief routine callback to handle cr3 process change
  *
@@ -40,6 +40,43 @@ ConfigureInitializeReversingMachineOnAllProcessors(PREVERSING_MACHINE_RECONSTRUC
     ReversingMachineInitialize(RevServiceRequest);
 }
 
+/**
+ * @brief routines for querying the records of the coverage of the reversing machine
+ * @param CoverageRequest
+ *
+ * @return VOID
+ */
+VOID
+ConfigureQueryReversingMachineCoverage(PREVERSING_MACHINE_QUERY_COVERAGE CoverageRequest)
+{
+    ReversingMachineCoverageQuery(CoverageRequest);
+}
+
+/**
+ * @brief routines for mapping (or unmapping) the results ring of a target
+ * of the reversing machine into the current process
+ * @param MapRequest
+ *
+ * @return VOID
+ */
+VOID
+ConfigureMapReversingMachineResults(PREVERSING_MACHINE_MAP_RESULTS MapRequest)
+{
+    ReversingMachineTargetsMapResults(MapRequest);
+}
+
+/**
+ * @brief routines for unmapping the results rings of the reversing machine
+ * that are mapped into the current process
+ *
+ * @return VOID
+ */
+VOID
+ConfigureUnmapReversingMachineResultsOfCurrentProcess()
+{
+    ReversingMachineTargetsUnmapResultsOfCurrentProcess();
+}
+
 /**
  * @brief routines for initializing Mode-based execution hooks
  *
@@ -51,6 +88,38 @@ ConfigureModeBasedExecHookUninitializeOnAllProcessors()
     ModeBasedExecHookUninitialize();
 }
 
+/**
+ * @brief This function traces the first execution of the pages of a range
+ *
+ * @param Tag Tag of the event
+ * @param StartAddress Start virtual address of the range
+ * @param EndAddress End virtual address of the range (exclusive)
+ * @param ProcessId Process of the virtual addresses
+ * @param IsUserMode Whether the user-mode or the supervisor-mode execution is traced
+ * @return BOOLEAN
+ */
+BOOLEAN
+ConfigureModeBasedExecHookTraceRange(UINT64  Tag,
+                                     UINT64  StartAddress,
+                                     UINT64  EndAddress,
+                                     UINT32  ProcessId,
+                                     BOOLEAN IsUserMode)
+{
+    return ModeBasedExecHookTraceRange(Tag, StartAddress, EndAddress, ProcessId, IsUserMode);
+}
+
+/**
+ * @brief This function stops tracing the pages of a range
+ *
+ * @param Tag Tag of the event
+ * @return BOOLEAN
+ */
+BOOLEAN
+ConfigureModeBasedExecHookUntraceRange(UINT64 Tag)
+{
+    return ModeBasedExecHookUntraceRange(Tag);
+}
+
 /**
  * @brief routines for initializing dirty logging mechanism
  *
@@ -121,6 +190,91 @@ ConfigureDisableEferSyscallEventsOnAllProcessors()
     BroadcastDisableEferSyscallEventsOnAllProcessors();
 }
 
+/**
+ * @brief routines for setting the filter of syscall numbers of
+ * the syscall events
+ * @param Bitmap Bitmap of the interesting syscall numbers
+ * @param IsActive Whether the syscall numbers are filtered or not
+ *
+ * @return VOID
+ */
+VOID
+ConfigureSetSyscallHookFilter(UINT64 * Bitmap, BOOLEAN IsActive)
+{
+    SyscallHookSetFilter(Bitmap, IsActive);
+}
+
+/**
+ * @brief routines for setting the filter of the leaves of the CPUID
+ * events
+ * @param Leaves The leaves of the events
+ * @param LeavesCount Count of the leaves
+ * @param IsActive Whether the leaves are filtered or not
+ *
+ * @return VOID
+ */
+VOID
+ConfigureSetCpuidEventFilter(UINT32 * Leaves, UINT32 LeavesCount, BOOLEAN IsActive)
+{
+    CpuidHandlerSetEventFilter(Leaves, LeavesCount, IsActive);
+}
+
+/**
+ * @brief routines for enabling the hook of the entry of system
+ * calls (!syscall3)
+ * @details should be called from vmx non-root
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+ConfigureEnableLstarSyscallHook()
+{
+    return SyscallHookEnableLstarEntryHook();
+}
+
+/**
+ * @brief routines for disabling the hook of the entry of system
+ * calls (!syscall3)
+ * @details should be called from vmx non-root
+ *
+ * @return VOID
+ */
+VOID
+ConfigureDisableLstarSyscallHook()
+{
+    SyscallHookDisableLstarEntryHook();
+}
+
+/**
+ * @brief routines for enabling the hook of the entry of a vector
+ * in the IDT (!interrupt2)
+ * @details should be called from vmx non-root
+ *
+ * @param Vector
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+ConfigureEnableIdtEntryInterruptHook(UINT32 Vector)
+{
+    return InterruptHookEnableIdtEntryHook(Vector);
+}
+
+/**
+ * @brief routines for disabling the hook of the entry of a vector
+ * in the IDT (!interrupt2)
+ * @details should be called from vmx non-root
+ *
+ * @param Vector
+ *
+ * @return VOID
+ */
+VOID
+ConfigureDisableIdtEntryInterruptHook(UINT32 Vector)
+{
+    InterruptHookDisableIdtEntryHook(Vector);
+}
+
 /**
  * @brief Remove single hook from the hooked pages list and invalidate TLB
  * @details Should be called from vmx non-root
@@ -138,6 +292,50 @@ ConfigureEptHookUnHookSingleAddress(UINT64 VirtualAddress, UINT64 PhysAddress, U
     return EptHookUnHookSingleAddress(VirtualAddress, PhysAddress, ProcessId);
 }
 
+/**
+ * @brief Monitor a page (read/write/execute) directly from vmx-root
+ * @details Should be called from vmx-root, the buffers of the hook
+ * should be reserved before (VmFuncEptHookAllocateExtraHookingPages)
+ *
+ * @param TargetAddress The address to be monitored
+ * @param ProcessCr3 The process cr3 to translate based on that process's cr3
+ * @param SetHookForRead Hook READ Access
+ * @param SetHookForWrite Hook WRITE Access
+ * @param SetHookForExec Hook EXECUTE Access
+ * @param PhysicalBaseAddress The physical address of the monitored page
+ *
+ * @return BOOLEAN Returns true if the hook was successful or false if there was an error
+ */
+BOOLEAN
+ConfigureEptHookMonitorFromVmxRoot(PVOID    TargetAddress,
+                                   CR3_TYPE ProcessCr3,
+                                   BOOLEAN  SetHookForRead,
+                                   BOOLEAN  SetHookForWrite,
+                                   BOOLEAN  SetHookForExec,
+                                   UINT64 * PhysicalBaseAddress)
+{
+    return EptHookMonitorPageFromVmxRoot(TargetAddress,
+                                         ProcessCr3,
+                                         SetHookForRead,
+                                         SetHookForWrite,
+                                         SetHookForExec,
+                                         PhysicalBaseAddress);
+}
+
+/**
+ * @brief Remove a monitor hook of a page directly from vmx-root
+ * @details Should be called from vmx-root
+ *
+ * @param PhysicalBaseAddress The physical address of the monitored page
+ *
+ * @return BOOLEAN Returns true if the page was unhooked
+ */
+BOOLEAN
+ConfigureEptHookUnHookSinglePageFromVmxRoot(UINT64 PhysicalBaseAddress)
+{
+    return EptHookUnHookSinglePageFromVmxRoot(PhysicalBaseAddress);
+}
+
 /**
  * @brief This function allocates a buffer in VMX Non Root Mode and then invokes a VMCALL to set the hook
  *
@@ -185,6 +383,145 @@ ConfigureEptHook2(PVOID   TargetAddress,
     return EptHook2(TargetAddress, HookFunction, ProcessId, SetHookForRead, SetHookForWrite, SetHookForExec, EptHiddenHook2);
 }
 
+/**
+ * @brief This function monitors a whole 2MB page without splitting it
+ * @details this NOT be called from vmx-root mode
+ *
+ * @param TargetAddress The start address of the 2MB page
+ * @param ProcessId The process id to translate based on that process's cr3
+ * @param SetHookForRead Hook READ Access
+ * @param SetHookForWrite Hook WRITE Access
+ * @param SetHookForExec Hook EXECUTE Access
+ *
+ * @return BOOLEAN Returns true if the hook was successful or false if there was an error
+ */
+BOOLEAN
+ConfigureEptHookMonitorLargePage(PVOID   TargetAddress,
+                                 UINT32  ProcessId,
+                                 BOOLEAN SetHookForRead,
+                                 BOOLEAN SetHookForWrite,
+                                 BOOLEAN SetHookForExec)
+{
+    return EptHookMonitorLargePage(TargetAddress, ProcessId, SetHookForRead, SetHookForWrite, SetHookForExec);
+}
+
+/**
+ * @brief This function applies multiple hooks (hidden breakpoints, hidden detours
+ * and monitors) and then notifies all cores to invalidate their EPT only once
+ * @details this NOT be called from vmx-root mode
+ *
+ * @param Entries The hooks, the result of each hook is saved into its KernelStatus
+ * @param Count Count of the entries
+ * @return UINT32 Count of the hooks that are applied successfully
+ */
+UINT32
+ConfigureEptHookBatch(PEPT_HOOKS_BATCH_ENTRY Entries, UINT32 Count)
+{
+    return EptHookBatch(Entries, Count);
+}
+
+/**
+ * @brief This function queries the hit counts of the hidden hooks detour
+ *
+ * @param HitDetails The array to store the hit counts
+ * @param MaximumCount Maximum count of entries of HitDetails
+ * @return UINT32 Count of the hooks that are stored in HitDetails
+ */
+UINT32
+ConfigureEptHook2QueryDetourHitCounts(PEPT_HOOK2_DETOUR_HIT_DETAILS HitDetails, UINT32 MaximumCount)
+{
+    return EptHook2QueryDetourHitCounts(HitDetails, MaximumCount);
+}
+
+/**
+ * @brief This function enables, disables, resets or queries the statistics of vm-exits
+ *
+ * @param StatisticsRequest
+ * @return VOID
+ */
+VOID
+ConfigureVmexitStatistics(PDEBUGGER_VMEXIT_STATISTICS_REQUEST StatisticsRequest)
+{
+    VmexitStatisticsPerformAction(StatisticsRequest);
+}
+
+/**
+ * @brief This function starts, stops or queries the samples of the sampling profiler
+ *
+ * @param ProfilerRequest
+ * @return VOID
+ */
+VOID
+ConfigureSamplingProfiler(PDEBUGGER_SAMPLING_PROFILER_REQUEST ProfilerRequest)
+{
+    SamplingProfilerPerformAction(ProfilerRequest);
+}
+
+/**
+ * @brief This function enables, disables or queries (and clears) the dirty pages
+ *
+ * @param DirtyPagesRequest
+ * @return VOID
+ */
+VOID
+ConfigureDirtyPages(PDEBUGGER_DIRTY_PAGES_REQUEST DirtyPagesRequest)
+{
+    DirtyLoggingPerformAction(DirtyPagesRequest);
+}
+
+/**
+ * @brief This function enables, disables, pauses, resumes or queries the
+ * trace of Intel PT (Processor Trace)
+ *
+ * @param IntelPtRequest
+ * @return VOID
+ */
+VOID
+ConfigureIntelPt(PDEBUGGER_INTEL_PT_REQUEST IntelPtRequest)
+{
+    IntelPtPerformAction(IntelPtRequest);
+}
+
+/**
+ * @brief This function starts, stops or queries the memory access
+ * sampling of PEBS (Precise Event Based Sampling)
+ *
+ * @param PebsRequest
+ * @return VOID
+ */
+VOID
+ConfigurePebsSampling(PDEBUGGER_PEBS_SAMPLING_REQUEST PebsRequest)
+{
+    PebsSamplingPerformAction(PebsRequest);
+}
+
+/**
+ * @brief This function takes, restores, discards or queries the snapshot
+ * of the guest memory
+ * @detail should be called from VMX-root
+ *
+ * @param SnapshotRequest
+ * @return VOID
+ */
+VOID
+ConfigureEptSnapshot(PDEBUGGER_EPT_SNAPSHOT_REQUEST SnapshotRequest)
+{
+    EptSnapshotPerformAction(SnapshotRequest);
+}
+
+/**
+ * @brief This function requests the copies of the pages that are written
+ * after taking the snapshot
+ *
+ * @param Count Count of the pages
+ * @return VOID
+ */
+VOID
+ConfigureEptSnapshotAllocatePageCopies(UINT32 Count)
+{
+    EptSnapshotAllocatePageCopies(Count);
+}
+
 /**
  * @brief Change PML EPT state for execution (execute)
  * @detail should be called from VMX-root
@@ -339,7 +676,37 @@ ConfigureSetExceptionBitmapOnSingleCore(UINT32 TargetCoreId, UINT32 BitMask)
 VOID
 ConfigureEnableMovToControlRegisterExitingOnSingleCore(UINT32 TargetCoreId, DEBUGGER_BROADCASTING_OPTIONS * BroadcastingOption)
 {
-    DpcRoutineRunTaskOnSingleCore(TargetCoreId, DpcRoutinePerformEnableMovToControlRegisterExiting, &BroadcastingOption);
+    DpcRoutineRunTaskOnSingleCore(TargetCoreId, DpcRoutinePerformEnableMovToControlRegisterExiting, BroadcastingOption);
+}
+
+/**
+ * @brief add a reference to a resource of the bitmap ownership on a single core
+ *
+ * @param TargetCoreId The target core's ID (to just run on this core)
+ * @param BroadcastingOption The type (OptionalParam1), the index (OptionalParam2)
+ * and the mask (OptionalParam3) of the resource
+ *
+ * @return VOID
+ */
+VOID
+ConfigureAcquireBitmapOwnershipOnSingleCore(UINT32 TargetCoreId, DEBUGGER_BROADCASTING_OPTIONS * BroadcastingOption)
+{
+    DpcRoutineRunTaskOnSingleCore(TargetCoreId, DpcRoutinePerformAcquireBitmapOwnership, BroadcastingOption);
+}
+
+/**
+ * @brief release a reference of a resource of the bitmap ownership on a single core
+ *
+ * @param TargetCoreId The target core's ID (to just run on this core)
+ * @param BroadcastingOption The type (OptionalParam1), the index (OptionalParam2)
+ * and the mask (OptionalParam3) of the resource
+ *
+ * @return VOID
+ */
+VOID
+ConfigureReleaseBitmapOwnershipOnSingleCore(UINT32 TargetCoreId, DEBUGGER_BROADCASTING_OPTIONS * BroadcastingOption)
+{
+    DpcRoutineRunTaskOnSingleCore(TargetCoreId, DpcRoutinePerformReleaseBitmapOwnership, BroadcastingOption);
 }
 
 /**
@@ -370,6 +737,34 @@ ConfigureChangeMsrBitmapReadOnSingleCore(UINT32 TargetCoreId, UINT64 MsrMask)
     DpcRoutineRunTaskOnSingleCore(TargetCoreId, DpcRoutinePerformChangeMsrBitmapReadOnSingleCore, MsrMask);
 }
 
+/**
+ * @brief release a reference of the mask of msr bitmaps for write on a single core
+ *
+ * @param TargetCoreId The target core's ID (to just run on this core)
+ * @param MsrMask The ECX in MSR (mask)
+ *
+ * @return VOID
+ */
+VOID
+ConfigureUnsetMsrBitmapWriteOnSingleCore(UINT32 TargetCoreId, UINT64 MsrMask)
+{
+    DpcRoutineRunTaskOnSingleCore(TargetCoreId, DpcRoutinePerformUnsetMsrBitmapWriteOnSingleCore, MsrMask);
+}
+
+/**
+ * @brief release a reference of the mask of msr bitmaps for read on a single core
+ *
+ * @param TargetCoreId The target core's ID (to just run on this core)
+ * @param MsrMask The ECX in MSR (mask)
+ *
+ * @return VOID
+ */
+VOID
+ConfigureUnsetMsrBitmapReadOnSingleCore(UINT32 TargetCoreId, UINT64 MsrMask)
+{
+    DpcRoutineRunTaskOnSingleCore(TargetCoreId, DpcRoutinePerformUnsetMsrBitmapReadOnSingleCore, MsrMask);
+}
+
 /**
  * @brief change I/O port bitmap on a single core
  *
@@ -72,6 +72,18 @@ DispatchEventEferSyscall(VIRTUAL_MACHINE_STATE * VCpu, PVOID Context)
     BOOLEAN                                   PostEventTriggerReq = FALSE;
     VMM_CALLBACK_TRIGGERING_EVENT_STATUS_TYPE EventTriggerResult;
 
+    //
+    // The syscalls that no event is interested in are emulated without
+    // triggering the events
+    //
+    if (SyscallHookIsFilteredOut(VCpu->Regs->rax))
+    {
+        SyscallHookEmulateSYSCALL(VCpu);
+        HvSuppressRipIncrement(VCpu);
+
+        return;
+    }
+
     //
     // We should trigger the event of SYSCALL here, we send the
     // syscall number in rax
@@ -104,6 +116,72 @@ DispatchEventEferSyscall(VIRTUAL_MACHINE_STATE * VCpu, PVOID Context)
     }
 }
 
+/**
+ * @brief Handling debugger functions related to SYSCALL events that
+ * are intercepted at the entry of system calls (!syscall3)
+ * @details the SYSCALL is already performed by the processor, so the
+ * first instruction of the entry (swapgs) is emulated instead of the
+ * breakpoint, short-circuiting returns to the caller of the SYSCALL
+ *
+ * @param VCpu The virtual processor's state
+ * @return VOID
+ */
+VOID
+DispatchEventLstarSyscall(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    BOOLEAN                                   PostEventTriggerReq = FALSE;
+    VMM_CALLBACK_TRIGGERING_EVENT_STATUS_TYPE EventTriggerResult;
+
+    //
+    // The syscalls that no event is interested in are continued without
+    // triggering the events
+    //
+    if (SyscallHookIsFilteredOut(VCpu->Regs->rax))
+    {
+        SyscallHookEmulateSWAPGS(VCpu);
+
+        return;
+    }
+
+    //
+    // We should trigger the event of SYSCALL here, we send the
+    // syscall number in rax
+    //
+    EventTriggerResult = VmmCallbackTriggerEvents(SYSCALL_HOOK_EFER_SYSCALL,
+                                                  VMM_CALLBACK_CALLING_STAGE_PRE_EVENT_EMULATION,
+                                                  VCpu->Regs->rax,
+                                                  &PostEventTriggerReq,
+                                                  VCpu->Regs);
+
+    //
+    // Check whether we need to short-circuiting event emulation or not
+    //
+    if (EventTriggerResult != VMM_CALLBACK_TRIGGERING_EVENT_STATUS_SUCCESSFUL_IGNORE_EVENT)
+    {
+        SyscallHookEmulateSWAPGS(VCpu);
+    }
+    else
+    {
+        //
+        // The system call is not performed, the guest returns to the
+        // caller of the SYSCALL (rax is the result of the system call)
+        //
+        SyscallHookEmulateSYSRET(VCpu);
+    }
+
+    //
+    // Check for the post-event triggering needs
+    //
+    if (PostEventTriggerReq)
+    {
+        VmmCallbackTriggerEvents(SYSCALL_HOOK_EFER_SYSCALL,
+                                 VMM_CALLBACK_CALLING_STAGE_POST_EVENT_EMULATION,
+                                 VCpu->Regs->rax,
+                                 NULL,
+                                 VCpu->Regs);
+    }
+}
+
 /**
  * @brief Handling debugger functions related to CPUID events
  *
@@ -121,7 +199,9 @@ DispatchEventCpuid(VIRTUAL_MACHINE_STATE * VCpu)
     // Check if attaching is for command dispatching in user debugger
     // or a regular CPUID
     //
-    if (g_Callbacks.UdCheckForCommand != NULL && g_Callbacks.UdCheckForCommand())
+    if (g_CheckCpuidsForUserDebuggerCommands &&
+        g_Callbacks.UdCheckForCommand != NULL &&
+        g_Callbacks.UdCheckForCommand(VCpu->Regs))
     {
         //
         // It's a thread command for user debugger, no need to run the
@@ -135,7 +215,7 @@ DispatchEventCpuid(VIRTUAL_MACHINE_STATE * VCpu)
     // so that the debugger can both read the eax as it's now changed by
     // the cpuid instruction and also can modify the results
     //
-    if (g_TriggerEventForCpuids)
+    if (g_TriggerEventForCpuids && !CpuidHandlerIsFilteredOut(VCpu->Regs->rax & 0xffffffff))
     {
         //
         // Adjusting the core context (save EAX for the debugger)
@@ -177,8 +257,8 @@ DispatchEventCpuid(VIRTUAL_MACHINE_STATE * VCpu)
     else
     {
         //
-        // Otherwise and if there is no event, we should handle the CPUID
-        // normally
+        // Otherwise and if there is no event (or no event is interested
+        // in this leaf), we should handle the CPUID normally
         //
         HvHandleCpuid(VCpu);
     }
@@ -316,7 +396,7 @@ DispatchEventIO(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // Read Guest's RFLAGS
     //
-    __vmx_vmread(VMCS_GUEST_RFLAGS, &Flags);
+    VmxVmread(VMCS_GUEST_RFLAGS, &Flags);
 
     //
     // As the context to event trigger, port address
@@ -583,7 +663,7 @@ DispatchEventMovToFromControlRegisters(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // Read the exit qualification
     //
-    __vmx_vmread(VMCS_EXIT_QUALIFICATION, &ExitQualification);
+    VmxVmread(VMCS_EXIT_QUALIFICATION, &ExitQualification);
 
     CrExitQualification = (VMX_EXIT_QUALIFICATION_MOV_CR *)&ExitQualification;
 
@@ -645,7 +725,7 @@ DispatchEventException(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // read the exit interruption information
     //
-    __vmx_vmread(VMCS_VMEXIT_INTERRUPTION_INFORMATION, &InterruptExit);
+    VmxVmread(VMCS_VMEXIT_INTERRUPTION_INFORMATION, &InterruptExit);
 
     //
     // This type of vm-exit, can be either because of an !exception event,
@@ -665,6 +745,16 @@ DispatchEventException(VIRTUAL_MACHINE_STATE * VCpu)
         {
             return;
         }
+
+        //
+        // Check if the NMI is because of the overflow of the counter of the
+        // retired instructions, it's handled at the end of the vm-exit
+        //
+        if (InstructionCounterCheckNmi(VCpu))
+        {
+            HvSuppressRipIncrement(VCpu);
+            return;
+        }
     }
 
     //
@@ -734,13 +824,13 @@ VOID
 DispatchEventExternalInterrupts(VIRTUAL_MACHINE_STATE * VCpu)
 {
     VMEXIT_INTERRUPT_INFORMATION              InterruptExit;
-    VMM_CALLBACK_TRIGGERING_EVENT_STATUS_TYPE EventTriggerResult;
+    VMM_CALLBACK_TRIGGERING_EVENT_STATUS_TYPE EventTriggerResult  = VMM_CALLBACK_TRIGGERING_EVENT_STATUS_SUCCESSFUL;
     BOOLEAN                                   PostEventTriggerReq = FALSE;
 
     //
     // read the exit interruption information
     //
-    __vmx_vmread(VMCS_VMEXIT_INTERRUPTION_INFORMATION, &InterruptExit);
+    VmxVmread(VMCS_VMEXIT_INTERRUPTION_INFORMATION, &InterruptExit);
 
     //
     // Check for immediate vm-exit mechanism
@@ -791,13 +881,18 @@ DispatchEventExternalInterrupts(VIRTUAL_MACHINE_STATE * VCpu)
     }
 
     //
-    // Triggering the pre-event
+    // Triggering the pre-event, the vectors that are hooked at their entries
+    // in the IDT (!interrupt2) trigger the events once they're delivered to
+    // the guest, so the events are not triggered twice
     //
-    EventTriggerResult = VmmCallbackTriggerEvents(EXTERNAL_INTERRUPT_OCCURRED,
-                                                  VMM_CALLBACK_CALLING_STAGE_PRE_EVENT_EMULATION,
-                                                  InterruptExit.Vector,
-                                                  &PostEventTriggerReq,
-                                                  VCpu->Regs);
+    if (!InterruptHookIsIdtEntryHooked(InterruptExit.Vector))
+    {
+        EventTriggerResult = VmmCallbackTriggerEvents(EXTERNAL_INTERRUPT_OCCURRED,
+                                                      VMM_CALLBACK_CALLING_STAGE_PRE_EVENT_EMULATION,
+                                                      InterruptExit.Vector,
+                                                      &PostEventTriggerReq,
+                                                      VCpu->Regs);
+    }
 
     //
     // Check whether we need to short-circuiting event emulation or not
@@ -832,6 +927,45 @@ DispatchEventExternalInterrupts(VIRTUAL_MACHINE_STATE * VCpu)
     }
 }
 
+/**
+ * @brief Handling debugger functions related to external-interrupt events
+ * that are intercepted at the entries of the IDT (!interrupt2)
+ * @details the interrupt is already delivered to the guest (the registers
+ * are the registers at the entry of the handler), so short-circuiting is
+ * not supported
+ *
+ * @param VCpu The virtual processor's state
+ * @param Vector The vector of the interrupt
+ * @return VOID
+ */
+VOID
+DispatchEventIdtEntryInterrupt(VIRTUAL_MACHINE_STATE * VCpu, UINT32 Vector)
+{
+    BOOLEAN PostEventTriggerReq = FALSE;
+
+    //
+    // Triggering the pre-event, as the context to event trigger, we send
+    // the vector index
+    //
+    VmmCallbackTriggerEvents(EXTERNAL_INTERRUPT_OCCURRED,
+                             VMM_CALLBACK_CALLING_STAGE_PRE_EVENT_EMULATION,
+                             Vector,
+                             &PostEventTriggerReq,
+                             VCpu->Regs);
+
+    //
+    // Check for the post-event triggering needs
+    //
+    if (PostEventTriggerReq)
+    {
+        VmmCallbackTriggerEvents(EXTERNAL_INTERRUPT_OCCURRED,
+                                 VMM_CALLBACK_CALLING_STAGE_POST_EVENT_EMULATION,
+                                 Vector,
+                                 NULL,
+                                 VCpu->Regs);
+    }
+}
+
 /**
  * @brief Handling debugger functions related to hidden hook exec
  * CC events
@@ -880,6 +1014,30 @@ DispatchEventHiddenHookExecDetours(VIRTUAL_MACHINE_STATE * VCpu, PVOID Context)
                              VCpu->Regs); // it will crash if we pass it NULL
 }
 
+/**
+ * @brief Handling debugger functions related to the first execution of
+ * traced pages (mode-based execution traces)
+ *
+ * @param VCpu The virtual processor's state
+ * @param Context The context of the caller
+ * @return VOID
+ */
+VOID
+DispatchEventPageFirstExecution(VIRTUAL_MACHINE_STATE * VCpu, PVOID Context)
+{
+    BOOLEAN PostEventTriggerReq = FALSE;
+
+    //
+    // Triggering the pre-event (This command only support the
+    // pre-event, the post-event doesn't make sense in this command)
+    //
+    VmmCallbackTriggerEvents(PAGE_FIRST_EXECUTION,
+                             VMM_CALLBACK_CALLING_STAGE_PRE_EVENT_EMULATION,
+                             Context,
+                             &PostEventTriggerReq,
+                             VCpu->Regs); // it will crash if we pass it NULL
+}
+
 /**
  * @brief Handling debugger functions related to read & write & execute, read events (pre)
  *
@@ -62,6 +62,48 @@ VmFuncChangeIgnoreOneMtfState(UINT32 CoreId, BOOLEAN Set)
     g_GuestState[CoreId].IgnoreOneMtf = Set;
 }
 
+/**
+ * @brief Add the contention of the named spinlocks of the VMM to the
+ * request
+ *
+ * @param ContentionRequest The sites are added after the sites that are
+ * already in the request
+ * @return VOID
+ */
+VOID
+VmFuncQuerySpinlockContention(PDEBUGGER_SPINLOCK_CONTENTION_REQUEST ContentionRequest)
+{
+#if UseSpinlockContentionInstrumentation == TRUE
+
+    SPINLOCK_SITE                   Site;
+    PSPINLOCK_CONTENTION_STATISTICS Statistics;
+
+    for (UINT32 i = 0; ContentionRequest->CountOfSites < MaximumSpinlockContentionSitesToQuery &&
+                       SpinlockReadContentionSite(i, &Site, ContentionRequest->Reset);
+         i++)
+    {
+        if (!Site.IsRegistered)
+        {
+            continue;
+        }
+
+        Statistics = &ContentionRequest->Sites[ContentionRequest->CountOfSites++];
+
+        RtlStringCchCopyA(Statistics->Name, MaximumSpinlockSiteNameLength, Site.Name);
+
+        Statistics->Acquisitions          = Site.Acquisitions;
+        Statistics->ContendedAcquisitions = Site.ContendedAcquisitions;
+        Statistics->SpinCycles            = Site.SpinCycles;
+        Statistics->MaximumWaitCycles     = Site.MaximumWaitCycles;
+    }
+
+#else
+
+    UNREFERENCED_PARAMETER(ContentionRequest);
+
+#endif
+}
+
 /**
  * @brief Register for break in the case of an MTF
  *
@@ -257,6 +299,65 @@ VmFuncUnsetExceptionBitmap(UINT32 CoreId, UINT32 IdtIndex)
     HvUnsetExceptionBitmap(&g_GuestState[CoreId], IdtIndex);
 }
 
+/**
+ * @brief Add or release a reference of an MSR (or all MSRs) on the MSR
+ * Bitmap of a core
+ * @details Should be called in vmx-root of the target core
+ *
+ * @param CoreId Target core's ID
+ * @param Set Add or release the reference
+ * @param IsWrite Whether it's the bitmap of wrmsr or rdmsr
+ * @param MsrMask The ECX in MSR (mask)
+ * @return VOID
+ */
+VOID
+VmFuncChangeMsrBitmap(UINT32 CoreId, BOOLEAN Set, BOOLEAN IsWrite, UINT64 MsrMask)
+{
+    VIRTUAL_MACHINE_STATE * VCpu = &g_GuestState[CoreId];
+
+    if (IsWrite && Set)
+    {
+        MsrHandlePerformMsrBitmapWriteChange(VCpu, MsrMask);
+    }
+    else if (IsWrite)
+    {
+        MsrHandlePerformMsrBitmapWriteUnset(VCpu, MsrMask);
+    }
+    else if (Set)
+    {
+        MsrHandlePerformMsrBitmapReadChange(VCpu, MsrMask);
+    }
+    else
+    {
+        MsrHandlePerformMsrBitmapReadUnset(VCpu, MsrMask);
+    }
+}
+
+/**
+ * @brief Add or release a reference of a resource of the bitmap ownership
+ * (I/O ports, exceptions, mov to debug or control registers) of a core
+ * @details Should be called in vmx-root of the target core
+ *
+ * @param CoreId Target core's ID
+ * @param Acquire Add or release the reference
+ * @param ResourceType Type of the resource
+ * @param Index The port, the vector or the control register
+ * @param Mask The mask of the control register
+ * @return VOID
+ */
+VOID
+VmFuncChangeBitmapOwnership(UINT32 CoreId, BOOLEAN Acquire, BITMAP_OWNERSHIP_RESOURCE_TYPE ResourceType, UINT64 Index, UINT64 Mask)
+{
+    if (Acquire)
+    {
+        BitmapOwnershipAcquire(&g_GuestState[CoreId], ResourceType, Index, Mask);
+    }
+    else
+    {
+        BitmapOwnershipRelease(&g_GuestState[CoreId], ResourceType, Index, Mask);
+    }
+}
+
 /**
  * @brief Set the External Interrupt Exiting
  *
@@ -283,6 +384,47 @@ VmFuncSetRdtscExiting(UINT32 CoreId, BOOLEAN Set)
     HvSetRdtscExiting(&g_GuestState[CoreId], Set);
 }
 
+/**
+ * @brief Unset the External Interrupt Exiting only if other features
+ * don't need it
+ * @details Should be called in vmx-root
+ *
+ * @param CoreId Target core's ID
+ * @return VOID
+ */
+VOID
+VmFuncUnsetExternalInterruptExitingOnlyOnClearingInterruptEvents(UINT32 CoreId)
+{
+    ProtectedHvExternalInterruptExitingForDisablingInterruptCommands(&g_GuestState[CoreId]);
+}
+
+/**
+ * @brief Unset the RDTSC/P Exiting only if other features don't need it
+ * @details Should be called in vmx-root
+ *
+ * @param CoreId Target core's ID
+ * @return VOID
+ */
+VOID
+VmFuncUnsetRdtscExitingForClearingTscEvents(UINT32 CoreId)
+{
+    ProtectedHvDisableRdtscExitingForDisablingTscCommands(&g_GuestState[CoreId]);
+}
+
+/**
+ * @brief Enable or disable the syscall hook of EFER
+ * @details Should be called in vmx-root
+ *
+ * @param CoreId Target core's ID
+ * @param Set Enable or disable the EFER syscall hook
+ * @return VOID
+ */
+VOID
+VmFuncSetEferSyscallHook(UINT32 CoreId, BOOLEAN Set)
+{
+    SyscallHookConfigureEFER(&g_GuestState[CoreId], Set);
+}
+
 /**
  * @brief Set or unset the Mov to Debug Registers Exiting
  *
@@ -519,6 +661,18 @@ VmFuncInitVmm(VMM_CALLBACKS * VmmCallbacks)
     return HvInitVmm(VmmCallbacks);
 }
 
+/**
+ * @brief Get the duration of the phases of initializing the hypervisor
+ * @param Timings
+ *
+ * @return VOID
+ */
+VOID
+VmFuncQueryInitializationTimings(PDEBUGGER_VMM_INITIALIZATION_TIMINGS Timings)
+{
+    RtlCopyMemory(Timings, &g_VmmInitializationTimings, sizeof(DEBUGGER_VMM_INITIALIZATION_TIMINGS));
+}
+
 /**
  * @brief Uninitialize Terminate Vmx on all logical cores
  *
@@ -563,6 +717,147 @@ VOID
 VmFuncSetTriggerEventForCpuids(BOOLEAN Set)
 {
     g_TriggerEventForCpuids = Set;
+
+    VmexitFastPathUpdate();
+}
+
+/**
+ * @brief Set triggering events for RDTSCs and RDTSCPs
+ *
+ * @param Set Set or unset the trigger
+ * @return VOID
+ */
+VOID
+VmFuncSetTriggerEventForTscs(BOOLEAN Set)
+{
+    g_TriggerEventForTscs = Set;
+
+    VmexitFastPathUpdate();
+}
+
+/**
+ * @brief Set checking CPUIDs for the commands of the user debugger
+ *
+ * @param Set Set or unset the check
+ * @return VOID
+ */
+VOID
+VmFuncSetCheckCpuidsForUserDebuggerCommands(BOOLEAN Set)
+{
+    g_CheckCpuidsForUserDebuggerCommands = Set;
+
+    VmexitFastPathUpdate();
+}
+
+/**
+ * @brief Request (or release the request of) saving the volatile XMM
+ * registers of the guest on vm-exits
+ * @details the requests are counted, the registers are saved as long
+ * as there is at least one requester, can be called from vmx-root
+ *
+ * @param Set Request or release
+ * @return VOID
+ */
+VOID
+VmFuncSetSaveXmmRegistersOnVmexits(BOOLEAN Set)
+{
+    if (Set)
+    {
+        InterlockedIncrement(&g_SaveXmmRegistersOnVmexits);
+    }
+    else
+    {
+        InterlockedDecrement(&g_SaveXmmRegistersOnVmexits);
+    }
+}
+
+/**
+ * @brief Add (or remove) an address space to (from) the filter of mov-to-cr3
+ * vm-exits
+ * @details the mov-to-cr3s that neither load nor leave the address spaces
+ * in the filter are emulated in the fast-path, each successful add should be
+ * paired with a remove, can be called from vmx-root
+ *
+ * @param Set Add (reference) or remove (release) the address space
+ * @param Cr3 The cr3 of the address space
+ * @return BOOLEAN FALSE if there is no free entry in the filter
+ */
+BOOLEAN
+VmFuncSetCr3VmexitFilter(BOOLEAN Set, UINT64 Cr3)
+{
+    return VmexitFastPathSetCr3Filter(Set, Cr3);
+}
+
+/**
+ * @brief Request (or release the request of) handling all of the mov-to-cr3
+ * vm-exits by the full path even if the filter is applied
+ * @details the requests are counted, can be called from vmx-root
+ *
+ * @param Bypass Request or release
+ * @return VOID
+ */
+VOID
+VmFuncBypassCr3VmexitFilter(BOOLEAN Bypass)
+{
+    VmexitFastPathBypassCr3Filter(Bypass);
+}
+
+/**
+ * @brief Request (or release the request of) recording the last branches
+ * (LBR) of the guest on all cores
+ * @details the requests are counted, can be called from vmx-root
+ *
+ * @param Set Request or release
+ * @return BOOLEAN FALSE if the LBRs are not supported
+ */
+BOOLEAN
+VmFuncSetLastBranchRecords(BOOLEAN Set)
+{
+    return LbrRequest(Set);
+}
+
+/**
+ * @brief Read the last branches (LBR) of the guest on the current core
+ * @details should be called from vmx-root
+ *
+ * @param Records The buffer to save the records
+ * @param Count Maximum count of the records
+ * @return UINT32 Count of the read records
+ */
+UINT32
+VmFuncGetLastBranchRecords(PDEBUGGER_LAST_BRANCH_RECORD Records, UINT32 Count)
+{
+    return LbrReadBranches(&g_GuestState[KeGetCurrentProcessorNumber()], Records, Count);
+}
+
+/**
+ * @brief Start counting the retired instructions of the guest on the
+ * target core
+ * @details should be called from vmx-root on the target core
+ *
+ * @param CoreId Target core's ID
+ * @param Count Count of the instructions that the counter overflows after them
+ * @return BOOLEAN Whether the counter is armed or not
+ */
+BOOLEAN
+VmFuncArmInstructionCounter(UINT32 CoreId, UINT64 Count)
+{
+    return InstructionCounterArm(&g_GuestState[CoreId], Count);
+}
+
+/**
+ * @brief Stop counting the retired instructions of the guest on the
+ * target core
+ * @details should be called from vmx-root on the target core
+ *
+ * @param CoreId Target core's ID
+ * @return UINT64 Count of the executed instructions (zero if the counter
+ * is not armed)
+ */
+UINT64
+VmFuncDisarmInstructionCounter(UINT32 CoreId)
+{
+    return InstructionCounterDisarm(&g_GuestState[CoreId]);
 }
 
 /**
@@ -621,6 +916,18 @@ VmFuncVmxVmcall(unsigned long long VmcallNumber,
     AsmVmxVmcall(VmcallNumber, OptionalParam1, OptionalParam2, OptionalParam3);
 }
 
+/**
+ * @brief Export for running a VMCALL that does nothing (used for
+ * measuring the round-trip of VMCALLs)
+ *
+ * @return NTSTATUS
+ */
+NTSTATUS
+VmFuncVmxBenchmarkVmcall()
+{
+    return AsmVmxVmcall(VMCALL_BENCHMARK, 0, 0, 0);
+}
+
 /**
  * @brief Export for initialize the VMX Broadcast mechansim
  *
@@ -109,8 +109,44 @@ CheckAddressCanonicality(UINT64 VAddr, PBOOLEAN IsKernelAddress)
     return TRUE;
 }
 
+/**
+ * @brief Check whether all of the pages of the memory are translated in
+ * the current vm-exit or not
+ * @details a page that is translated (cached by the address translation
+ * cache) is present, the cache is only used in vmx-root and it's
+ * invalidated on each vm-exit and once the page tables are modified by
+ * the debugger
+ *
+ * @param TargetAddress
+ * @param Size
+ * @param GuestCr3
+ *
+ * @return BOOLEAN Returns FALSE if any of the pages is not cached
+ */
+static BOOLEAN
+CheckAccessValidityUsingTranslationCache(UINT64 TargetAddress, UINT32 Size, CR3_TYPE GuestCr3)
+{
+    UINT64 PhysicalAddress;
+    UINT64 AlignedPage = (UINT64)PAGE_ALIGN(TargetAddress);
+    UINT64 PageCount   = ((TargetAddress - AlignedPage) + (Size == 0 ? 1 : Size) + PAGE_SIZE - 1) / PAGE_SIZE;
+
+    for (UINT64 i = 0; i < PageCount; i++)
+    {
+        if (!AddressTranslationCacheLookup(GuestCr3.Flags, AlignedPage + (PAGE_SIZE * i), &PhysicalAddress))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
 /**
  * @brief Check the safety to access the memory
+ * @details the pages that are already translated in the current vm-exit
+ * (e.g., by the previous accesses of the script to the same structure)
+ * don't need to traverse the page-tables again
+ *
  * @param TargetAddress
  * @param Size
  *
@@ -142,6 +178,15 @@ CheckAccessValidityAndSafety(UINT64 TargetAddress, UINT32 Size)
     //
     GuestCr3.Flags = LayoutGetCurrentProcessCr3().Flags;
 
+    //
+    // No need to switch the layout if all of the pages are translated
+    //
+    if (CheckAccessValidityUsingTranslationCache(TargetAddress, Size, GuestCr3))
+    {
+        Result = TRUE;
+        goto Return;
+    }
+
     //
     // Move to new cr3
     //
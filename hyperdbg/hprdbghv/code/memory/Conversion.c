@@ -145,6 +145,29 @@ PhysicalAddressToVirtualAddressOnTargetProcess(PVOID PhysicalAddress)
     return PhysicalAddressToVirtualAddressByCr3(PhysicalAddress, GuestCr3);
 }
 
+/**
+ * @brief Converts Virtual Address to Physical Address by walking the
+ * page tables of the current memory layout
+ *
+ * @param VirtualAddress The target virtual address
+ * @return UINT64 Returns the physical address (zero if it's not present)
+ */
+static UINT64
+VirtualAddressToPhysicalAddressOnCurrentLayout(PVOID VirtualAddress)
+{
+    CR3_TYPE               Cr3;
+    PAGE_TABLE_WALK_RESULT Result;
+
+    Cr3.Flags = __readcr3();
+
+    if (!MemoryMapperWalkPageTablesWithoutSwitchingByCr3(VirtualAddress, Cr3, &Result) || !Result.IsPresent)
+    {
+        return NULL;
+    }
+
+    return Result.PhysicalAddress;
+}
+
 /**
  * @brief Converts Virtual Address to Physical Address
  *
@@ -155,7 +178,24 @@ _Use_decl_annotations_
 UINT64
 VirtualAddressToPhysicalAddress(_In_ PVOID VirtualAddress)
 {
-    return MmGetPhysicalAddress(VirtualAddress).QuadPart;
+    UINT64 Cr3;
+    UINT64 PhysicalAddress;
+
+    //
+    // In vmx-root, the translation might be cached for the current cr3
+    //
+    Cr3 = __readcr3();
+
+    if (AddressTranslationCacheLookup(Cr3, (UINT64)VirtualAddress, &PhysicalAddress))
+    {
+        return PhysicalAddress;
+    }
+
+    PhysicalAddress = VirtualAddressToPhysicalAddressOnCurrentLayout(VirtualAddress);
+
+    AddressTranslationCacheInsert(Cr3, (UINT64)VirtualAddress, PhysicalAddress);
+
+    return PhysicalAddress;
 }
 
 /**
@@ -194,7 +234,7 @@ VirtualAddressToPhysicalAddressByProcessId(PVOID VirtualAddress, UINT32 ProcessI
     //
     // Read the physical address based on new cr3
     //
-    PhysicalAddress = MmGetPhysicalAddress(VirtualAddress).QuadPart;
+    PhysicalAddress = VirtualAddressToPhysicalAddressOnCurrentLayout(VirtualAddress);
 
     //
     // Restore the original process
@@ -219,6 +259,14 @@ VirtualAddressToPhysicalAddressByProcessCr3(PVOID VirtualAddress, CR3_TYPE Targe
     CR3_TYPE CurrentProcessCr3;
     UINT64   PhysicalAddress;
 
+    //
+    // Check whether the translation is cached (no need to switch the layout)
+    //
+    if (AddressTranslationCacheLookup(TargetCr3.Flags, (UINT64)VirtualAddress, &PhysicalAddress))
+    {
+        return PhysicalAddress;
+    }
+
     //
     // Switch to new process's memory layout
     //
@@ -238,13 +286,15 @@ VirtualAddressToPhysicalAddressByProcessCr3(PVOID VirtualAddress, CR3_TYPE Targe
     //
     // Read the physical address based on new cr3
     //
-    PhysicalAddress = MmGetPhysicalAddress(VirtualAddress).QuadPart;
+    PhysicalAddress = VirtualAddressToPhysicalAddressOnCurrentLayout(VirtualAddress);
 
     //
     // Restore the original process
     //
     SwitchToPreviousProcess(CurrentProcessCr3);
 
+    AddressTranslationCacheInsert(TargetCr3.Flags, (UINT64)VirtualAddress, PhysicalAddress);
+
     return PhysicalAddress;
 }
 
@@ -265,6 +315,14 @@ VirtualAddressToPhysicalAddressOnTargetProcess(PVOID VirtualAddress)
 
     GuestCr3.Flags = LayoutGetCurrentProcessCr3().Flags;
 
+    //
+    // Check whether the translation is cached (no need to switch the layout)
+    //
+    if (AddressTranslationCacheLookup(GuestCr3.Flags, (UINT64)VirtualAddress, &PhysicalAddress))
+    {
+        return PhysicalAddress;
+    }
+
     //
     // Switch to new process's memory layout
     //
@@ -284,12 +342,201 @@ VirtualAddressToPhysicalAddressOnTargetProcess(PVOID VirtualAddress)
     //
     // Read the physical address based on new cr3
     //
-    PhysicalAddress = MmGetPhysicalAddress(VirtualAddress).QuadPart;
+    PhysicalAddress = VirtualAddressToPhysicalAddressOnCurrentLayout(VirtualAddress);
 
     //
     // Restore the original process
     //
     SwitchToPreviousProcess(CurrentCr3);
 
+    AddressTranslationCacheInsert(GuestCr3.Flags, (UINT64)VirtualAddress, PhysicalAddress);
+
     return PhysicalAddress;
 }
+
+/**
+ * @brief Get the address translation cache of the current core
+ * @details the cache is only used in vmx-root as the guest might modify
+ * its page tables while it's running
+ *
+ * @return PADDRESS_TRANSLATION_CACHE The cache or NULL if it's not usable
+ */
+static PADDRESS_TRANSLATION_CACHE
+AddressTranslationCacheGetCurrentCache()
+{
+    PADDRESS_TRANSLATION_CACHE Cache;
+    LONG                       GlobalGeneration;
+
+    if (VmxGetCurrentExecutionMode() != VmxExecutionModeRoot)
+    {
+        return NULL;
+    }
+
+    Cache = &g_GuestState[KeGetCurrentProcessorNumber()].AddressTranslationCache;
+
+    //
+    // Check whether the translations are invalidated on all cores
+    //
+    GlobalGeneration = g_AddressTranslationCacheGlobalGeneration;
+
+    if (Cache->GlobalGeneration != GlobalGeneration)
+    {
+        Cache->GlobalGeneration = GlobalGeneration;
+        Cache->Generation++;
+    }
+
+    return Cache;
+}
+
+/**
+ * @brief Find the cached translation of a virtual address
+ *
+ * @param Cr3 The cr3 that the address belongs to
+ * @param VirtualAddress The target virtual address
+ * @param PhysicalAddress The translated physical address
+ *
+ * @return BOOLEAN Returns TRUE if the translation is cached
+ */
+_Use_decl_annotations_
+BOOLEAN
+AddressTranslationCacheLookup(UINT64 Cr3, UINT64 VirtualAddress, UINT64 * PhysicalAddress)
+{
+    PADDRESS_TRANSLATION_CACHE       Cache;
+    PADDRESS_TRANSLATION_CACHE_ENTRY Entry;
+
+    Cache = AddressTranslationCacheGetCurrentCache();
+
+    if (Cache == NULL)
+    {
+        return FALSE;
+    }
+
+    Entry = &Cache->Entries[(VirtualAddress >> 12) & (ADDRESS_TRANSLATION_CACHE_ENTRIES - 1)];
+
+    //
+    // The PCID and the flags of cr3 don't change the translation
+    //
+    if (Entry->Generation != Cache->Generation ||
+        Entry->Cr3 != (Cr3 & ~PAGE_4KB_OFFSET & ~(1ULL << 63)) ||
+        Entry->VirtualPage != (VirtualAddress & ~PAGE_4KB_OFFSET))
+    {
+        return FALSE;
+    }
+
+    *PhysicalAddress = Entry->PhysicalPage + (VirtualAddress & PAGE_4KB_OFFSET);
+
+    return TRUE;
+}
+
+/**
+ * @brief Cache the translation of a virtual address
+ *
+ * @param Cr3 The cr3 that the address belongs to
+ * @param VirtualAddress The translated virtual address
+ * @param PhysicalAddress The physical address (not cached if it's NULL)
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+AddressTranslationCacheInsert(UINT64 Cr3, UINT64 VirtualAddress, UINT64 PhysicalAddress)
+{
+    PADDRESS_TRANSLATION_CACHE       Cache;
+    PADDRESS_TRANSLATION_CACHE_ENTRY Entry;
+
+    //
+    // Addresses that are not translated are not cached
+    //
+    if (PhysicalAddress == NULL)
+    {
+        return;
+    }
+
+    Cache = AddressTranslationCacheGetCurrentCache();
+
+    if (Cache == NULL)
+    {
+        return;
+    }
+
+    Entry = &Cache->Entries[(VirtualAddress >> 12) & (ADDRESS_TRANSLATION_CACHE_ENTRIES - 1)];
+
+    Entry->Cr3          = Cr3 & ~PAGE_4KB_OFFSET & ~(1ULL << 63);
+    Entry->VirtualPage  = VirtualAddress & ~PAGE_4KB_OFFSET;
+    Entry->PhysicalPage = PhysicalAddress & ~PAGE_4KB_OFFSET;
+    Entry->Generation   = Cache->Generation;
+}
+
+/**
+ * @brief Get the virtual address of a table of the page tables
+ * @details in vmx-root, the tables of the last walk are kept, so the walks
+ * of the near addresses don't map the same tables again
+ *
+ * @param Level The level of the table
+ * @param TablePhysicalAddress Physical address of the table
+ *
+ * @return PUINT64 The virtual address of the table or NULL if it's not mapped
+ */
+_Use_decl_annotations_
+PUINT64
+AddressTranslationCacheMapTable(PAGING_LEVEL Level, UINT64 TablePhysicalAddress)
+{
+    PADDRESS_TRANSLATION_CACHE Cache;
+    PUINT64                    TableVa;
+
+    Cache = AddressTranslationCacheGetCurrentCache();
+
+    if (Cache == NULL)
+    {
+        return (PUINT64)PhysicalAddressToVirtualAddress(TablePhysicalAddress);
+    }
+
+    if (Cache->TablesGeneration != Cache->Generation)
+    {
+        RtlZeroMemory(Cache->TablesPhysicalAddresses, sizeof(Cache->TablesPhysicalAddresses));
+        Cache->TablesGeneration = Cache->Generation;
+    }
+    else if (Cache->TablesPhysicalAddresses[Level] == TablePhysicalAddress)
+    {
+        return Cache->TablesVirtualAddresses[Level];
+    }
+
+    TableVa = (PUINT64)PhysicalAddressToVirtualAddress(TablePhysicalAddress);
+
+    if (TableVa != NULL)
+    {
+        Cache->TablesPhysicalAddresses[Level] = TablePhysicalAddress;
+        Cache->TablesVirtualAddresses[Level]  = TableVa;
+    }
+
+    return TableVa;
+}
+
+/**
+ * @brief Invalidate the address translation cache of a core
+ * @details called on each vm-exit as the guest might have changed
+ * its page tables (or cr3) while it was running
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+AddressTranslationCacheInvalidate(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    VCpu->AddressTranslationCache.Generation++;
+}
+
+/**
+ * @brief Invalidate the address translation cache of all cores
+ * @details called once the memory or the page tables are modified
+ * by the debugger, other cores invalidate their cache on their next lookup
+ *
+ * @return VOID
+ */
+VOID
+AddressTranslationCacheInvalidateAllCores()
+{
+    InterlockedIncrement(&g_AddressTranslationCacheGlobalGeneration);
+}
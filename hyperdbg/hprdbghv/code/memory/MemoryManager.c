@@ -67,7 +67,7 @@ MemoryManagerReadProcessMemoryNormal(HANDLE                    PID,
             //
             // We're in context of another process let's read the memory
             //
-            TempPhysicalAddress = MmGetPhysicalAddress(Address);
+            TempPhysicalAddress.QuadPart = VirtualAddressToPhysicalAddress(Address);
 
             KeUnstackDetachProcess(&State);
 
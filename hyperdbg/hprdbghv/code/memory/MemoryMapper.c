@@ -289,6 +289,7 @@ MemoryMapperSetExecuteDisableToPteOnTargetProcess(PVOID Va, BOOLEAN Set)
     // Invalidate the TLB
     //
     __invlpg(Va);
+    AddressTranslationCacheInvalidateAllCores();
 
     //
     // Restore the original process
@@ -299,111 +300,168 @@ MemoryMapperSetExecuteDisableToPteOnTargetProcess(PVOID Va, BOOLEAN Set)
 }
 
 /**
- * @brief This function gets virtual address and returns its PTE of the virtual address
- * based on the specific cr3 but without switching to the target address
- * @details the TargetCr3 should be kernel cr3 as we will use it to translate kernel
- * addresses so the kernel functions to translate addresses should be mapped; thus,
- * don't pass a KPTI meltdown user cr3 to this function
+ * @brief Walk the page tables of a virtual address based on the specific
+ * cr3 but without switching to the target address
+ * @details the walk stops once it reaches a large page (1GB or 2MB) or an
+ * entry that is not present, the TargetCr3 should be kernel cr3 as we will
+ * use it to translate kernel addresses so the kernel functions to translate
+ * addresses should be mapped; thus, don't pass a KPTI meltdown user cr3 to
+ * this function
  *
  * @param Va Virtual Address
- * @param Level PMLx
  * @param TargetCr3 kernel cr3 of target process
- * @return PVOID virtual address of PTE based on cr3
+ * @param Result The entries, the physical address, the size and the
+ * permissions of the page
+ * @return BOOLEAN FALSE if one of the tables is not mapped (the walk is
+ * not finished)
  */
 _Use_decl_annotations_
-PVOID
-MemoryMapperGetPteVaWithoutSwitchingByCr3(PVOID Va, PAGING_LEVEL Level, CR3_TYPE TargetCr3)
+BOOLEAN
+MemoryMapperWalkPageTablesWithoutSwitchingByCr3(PVOID Va, CR3_TYPE TargetCr3, PPAGE_TABLE_WALK_RESULT Result)
 {
-    CR3_TYPE Cr3;
-    UINT64   TempCr3;
-    PUINT64  Cr3Va;
-    PUINT64  PdptVa;
-    PUINT64  PdVa;
-    PUINT64  PtVa;
-    UINT32   Offset;
+    PUINT64      TableVa;
+    PPAGE_ENTRY  Entry = NULL;
+    UINT64       TablePa;
+    PAGING_LEVEL Level;
 
-    Cr3.Flags = TargetCr3.Flags;
+    RtlZeroMemory(Result, sizeof(PAGE_TABLE_WALK_RESULT));
 
-    //
-    // Cr3 should be shifted 12 to the left because it's PFN
-    //
-    TempCr3 = Cr3.Fields.PageFrameNumber << 12;
+    Result->LeafLevel    = PagingLevelPageMapLevel4;
+    Result->IsWritable   = TRUE;
+    Result->IsUser       = TRUE;
+    Result->IsExecutable = TRUE;
 
     //
-    // we need VA of Cr3, not PA
+    // Cr3 should be shifted 12 to the left because it's PFN
     //
-    Cr3Va = PhysicalAddressToVirtualAddress(TempCr3);
+    TablePa = TargetCr3.Fields.PageFrameNumber << 12;
 
-    //
-    // Check for invalid address
-    //
-    if (Cr3Va == NULL)
+    for (Level = PagingLevelPageMapLevel4;; Level--)
     {
-        return NULL;
-    }
+        //
+        // we need VA of the table, not PA
+        //
+        TableVa = AddressTranslationCacheMapTable(Level, TablePa);
 
-    Offset = MemoryMapperGetOffset(PagingLevelPageMapLevel4, Va);
+        //
+        // Check for invalid address
+        //
+        if (TableVa == NULL)
+        {
+            return FALSE;
+        }
 
-    PPAGE_ENTRY Pml4e = &Cr3Va[Offset];
+        Entry = (PPAGE_ENTRY)&TableVa[MemoryMapperGetOffset(Level, (UINT64)Va)];
 
-    if (!Pml4e->Fields.Present || Level == PagingLevelPageMapLevel4)
-    {
-        return Pml4e;
-    }
+        Result->EntriesVirtualAddresses[Level] = (UINT64)Entry;
+        Result->LeafLevel                      = Level;
 
-    PdptVa = PhysicalAddressToVirtualAddress(Pml4e->Fields.PageFrameNumber << 12);
+        if (!Entry->Fields.Present)
+        {
+            return TRUE;
+        }
 
-    //
-    // Check for invalid address
-    //
-    if (PdptVa == NULL)
-    {
-        return NULL;
-    }
+        Result->IsWritable &= Entry->Fields.Write;
+        Result->IsUser &= Entry->Fields.Supervisor;
+        Result->IsExecutable &= !Entry->Fields.ExecuteDisable;
 
-    Offset = MemoryMapperGetOffset(PagingLevelPageDirectoryPointerTable, Va);
+        //
+        // The large pages are the leaves of their levels
+        //
+        if (Level == PagingLevelPageTable ||
+            (Level != PagingLevelPageMapLevel4 && Entry->Fields.LargePage))
+        {
+            break;
+        }
 
-    PPAGE_ENTRY Pdpte = &PdptVa[Offset];
+        TablePa = Entry->Fields.PageFrameNumber << 12;
+    }
 
-    if (!Pdpte->Fields.Present || Pdpte->Fields.LargePage || Level == PagingLevelPageDirectoryPointerTable)
+    switch (Level)
     {
-        return Pdpte;
+    case PagingLevelPageDirectoryPointerTable:
+        Result->PageSize = PAGE_1GB_OFFSET + 1;
+        break;
+    case PagingLevelPageDirectory:
+        Result->PageSize = PAGE_2MB_OFFSET + 1;
+        break;
+    default:
+        Result->PageSize = PAGE_SIZE;
+        break;
     }
 
-    PdVa = PhysicalAddressToVirtualAddress(Pdpte->Fields.PageFrameNumber << 12);
+    //
+    // The low bits of the frame of the large pages are the PAT bit and reserved bits
+    //
+    Result->PhysicalAddress = ((Entry->Fields.PageFrameNumber << 12) & ~(Result->PageSize - 1)) +
+                              ((UINT64)Va & (Result->PageSize - 1));
+    Result->IsPresent       = TRUE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Walk the page tables of a virtual address based on the specific cr3
+ * @details the TargetCr3 should be kernel cr3 (not KPTI user cr3)
+ *
+ * @param Va Virtual Address
+ * @param TargetCr3 kernel cr3 of target process
+ * @param Result The entries, the physical address, the size and the
+ * permissions of the page
+ * @return BOOLEAN FALSE if one of the tables is not mapped (the walk is
+ * not finished)
+ */
+_Use_decl_annotations_
+BOOLEAN
+MemoryMapperWalkPageTablesByCr3(PVOID Va, CR3_TYPE TargetCr3, PPAGE_TABLE_WALK_RESULT Result)
+{
+    BOOLEAN  IsWalked;
+    CR3_TYPE CurrentProcessCr3;
 
     //
-    // Check for invalid address
+    // Switch to new process's memory layout (the tables are mapped on
+    // the kernel cr3 of the process)
     //
-    if (PdVa == NULL)
-    {
-        return NULL;
-    }
+    CurrentProcessCr3 = SwitchToProcessMemoryLayoutByCr3(TargetCr3);
 
-    Offset = MemoryMapperGetOffset(PagingLevelPageDirectory, Va);
+    IsWalked = MemoryMapperWalkPageTablesWithoutSwitchingByCr3(Va, TargetCr3, Result);
 
-    PPAGE_ENTRY Pde = &PdVa[Offset];
+    //
+    // Restore the original process
+    //
+    SwitchToPreviousProcess(CurrentProcessCr3);
 
-    if (!Pde->Fields.Present || Pde->Fields.LargePage || Level == PagingLevelPageDirectory)
-    {
-        return Pde;
-    }
+    return IsWalked;
+}
 
-    PtVa = PhysicalAddressToVirtualAddress(Pde->Fields.PageFrameNumber << 12);
+/**
+ * @brief This function gets virtual address and returns its PTE of the virtual address
+ * based on the specific cr3 but without switching to the target address
+ * @details the TargetCr3 should be kernel cr3 as we will use it to translate kernel
+ * addresses so the kernel functions to translate addresses should be mapped; thus,
+ * don't pass a KPTI meltdown user cr3 to this function
+ *
+ * @param Va Virtual Address
+ * @param Level PMLx
+ * @param TargetCr3 kernel cr3 of target process
+ * @return PVOID virtual address of PTE based on cr3
+ */
+_Use_decl_annotations_
+PVOID
+MemoryMapperGetPteVaWithoutSwitchingByCr3(PVOID Va, PAGING_LEVEL Level, CR3_TYPE TargetCr3)
+{
+    PAGE_TABLE_WALK_RESULT Result;
 
     //
-    // Check for invalid address
+    // If the walk is stopped before the level (a large page or an entry that
+    // is not present), the entry of the last walked level is returned
     //
-    if (PtVa == NULL)
+    if (MemoryMapperWalkPageTablesWithoutSwitchingByCr3(Va, TargetCr3, &Result) && Level < Result.LeafLevel)
     {
-        return NULL;
+        return (PVOID)Result.EntriesVirtualAddresses[Result.LeafLevel];
     }
 
-    Offset = MemoryMapperGetOffset(PagingLevelPageTable, Va);
-
-    PPAGE_ENTRY Pt = &PtVa[Offset];
-
-    return Pt;
+    return (PVOID)Result.EntriesVirtualAddresses[Level];
 }
 
 /**
@@ -601,6 +659,117 @@ MemoryMapperMapPageAndGetPte(PUINT64 PteAddress)
     return Va;
 }
 
+/**
+ * @brief This function reserves multiple pages for the bulk window and
+ * saves the PTE virtual address of each page of the window
+ *
+ * @param Window The window to reserve
+ * @return BOOLEAN returns TRUE if it was successful and FALSE if there was error
+ */
+_Use_decl_annotations_
+BOOLEAN
+MemoryMapperReserveBulkWindow(PMEMORY_MAPPER_BULK_WINDOW Window)
+{
+    UINT64 Va;
+
+    //
+    // Reserve the pages from system va space
+    //
+    Va = MemoryMapperMapReservedPageRange(MEMORY_MAPPER_BULK_WINDOW_PAGES * PAGE_SIZE);
+
+    if (Va == NULL)
+    {
+        return FALSE;
+    }
+
+    //
+    // The window might pass from a page table boundary, so the PTEs are not
+    // necessarily contiguous, we get the Page Table Entry of each page
+    //
+    for (UINT32 i = 0; i < MEMORY_MAPPER_BULK_WINDOW_PAGES; i++)
+    {
+        Window->PteVirtualAddresses[i] = MemoryMapperGetPte(Va + (i * PAGE_SIZE));
+    }
+
+    Window->VirtualAddress = Va;
+
+    return TRUE;
+}
+
+/**
+ * @brief Map a run of physical pages into the bulk window
+ * @details all of the PTEs are applied first and then the pages are
+ * invalidated in one pass, thus, the window can be accessed contiguously
+ *
+ * @param Window The bulk window of the current core
+ * @param PhysicalAddresses Physical address of each page
+ * @param PagesCount Count of pages (up to MEMORY_MAPPER_BULK_WINDOW_PAGES)
+ *
+ * @return PVOID The virtual address of the first mapped page
+ */
+_Use_decl_annotations_
+PVOID
+MemoryMapperMapBulkWindow(PMEMORY_MAPPER_BULK_WINDOW Window,
+                          PHYSICAL_ADDRESS           PhysicalAddresses[],
+                          UINT32                     PagesCount)
+{
+    PAGE_ENTRY  PageEntry;
+    PPAGE_ENTRY Pte;
+
+    for (UINT32 i = 0; i < PagesCount; i++)
+    {
+        Pte = Window->PteVirtualAddresses[i];
+
+        //
+        // Copy the previous entry into the new entry
+        //
+        PageEntry.Flags = Pte->Flags;
+
+        //
+        // Same as the single page mapping, the page is present, writable,
+        // and global (not flushed from the TLB on CR3 switch)
+        //
+        PageEntry.Fields.Present         = 1;
+        PageEntry.Fields.Write           = 1;
+        PageEntry.Fields.Global          = 1;
+        PageEntry.Fields.PageFrameNumber = PhysicalAddresses[i].QuadPart >> 12;
+
+        //
+        // Apply the page entry in a single instruction
+        //
+        Pte->Flags = PageEntry.Flags;
+    }
+
+    //
+    // Invalidate the caches for the virtual addresses of the window
+    //
+    for (UINT32 i = 0; i < PagesCount; i++)
+    {
+        __invlpg((PVOID)(Window->VirtualAddress + (i * PAGE_SIZE)));
+    }
+
+    return Window->VirtualAddress;
+}
+
+/**
+ * @brief Unmap the pages that are mapped into the bulk window
+ *
+ * @param Window The bulk window of the current core
+ * @param PagesCount Count of mapped pages
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+MemoryMapperUnmapBulkWindow(PMEMORY_MAPPER_BULK_WINDOW Window,
+                            UINT32                     PagesCount)
+{
+    for (UINT32 i = 0; i < PagesCount; i++)
+    {
+        ((PPAGE_ENTRY)Window->PteVirtualAddresses[i])->Flags = NULL;
+    }
+}
+
 /**
  * @brief Initialize the Memory Mapper
  * @details This function should be called in vmx non-root
@@ -658,6 +827,13 @@ MemoryMapperInitialize()
         //
         g_MemoryMapper[i].VirualAddressForWrite     = MemoryMapperMapPageAndGetPte(&TempPte);
         g_MemoryMapper[i].PteVirtualAddressForWrite = TempPte;
+
+        //
+        // Reserve the windows for accessing multiple pages (not mandatory, if it's
+        // not reserved then the pages are accessed one by one)
+        //
+        MemoryMapperReserveBulkWindow(&g_MemoryMapper[i].BulkWindowForRead);
+        MemoryMapperReserveBulkWindow(&g_MemoryMapper[i].BulkWindowForWrite);
     }
 }
 
@@ -693,6 +869,19 @@ MemoryMapperUninitialize()
 
         g_MemoryMapper[i].VirualAddressForWrite     = NULL;
         g_MemoryMapper[i].PteVirtualAddressForWrite = NULL;
+
+        if (g_MemoryMapper[i].BulkWindowForRead.VirtualAddress != NULL)
+        {
+            MemoryMapperUnmapReservedPageRange(g_MemoryMapper[i].BulkWindowForRead.VirtualAddress);
+        }
+
+        if (g_MemoryMapper[i].BulkWindowForWrite.VirtualAddress != NULL)
+        {
+            MemoryMapperUnmapReservedPageRange(g_MemoryMapper[i].BulkWindowForWrite.VirtualAddress);
+        }
+
+        g_MemoryMapper[i].BulkWindowForRead.VirtualAddress  = NULL;
+        g_MemoryMapper[i].BulkWindowForWrite.VirtualAddress = NULL;
     }
 
     //
@@ -930,9 +1119,15 @@ MemoryMapperReadMemorySafeByPhysicalAddressWrapper(
     UINT64                                 BufferToSaveMemory,
     SIZE_T                                 SizeToRead)
 {
-    ULONG            ProcessorIndex = KeGetCurrentProcessorNumber();
-    UINT64           AddressToCheck;
-    PHYSICAL_ADDRESS PhysicalAddress;
+    ULONG                      ProcessorIndex = KeGetCurrentProcessorNumber();
+    UINT64                     AddressToCheck;
+    PHYSICAL_ADDRESS           PhysicalAddress;
+    PHYSICAL_ADDRESS           PhysicalAddresses[MEMORY_MAPPER_BULK_WINDOW_PAGES];
+    PMEMORY_MAPPER_BULK_WINDOW Window = &g_MemoryMapper[ProcessorIndex].BulkWindowForRead;
+    UINT64                     Offset;
+    UINT64                     PagesCount;
+    UINT64                     ReadSize;
+    PVOID                      MappedVa;
 
     //
     // Check to see if PTE and Reserved VA already initialized
@@ -951,13 +1146,59 @@ MemoryMapperReadMemorySafeByPhysicalAddressWrapper(
     //
     AddressToCheck = (CHAR *)AddressToRead + SizeToRead - ((CHAR *)PAGE_ALIGN(AddressToRead));
 
-    if (AddressToCheck > PAGE_SIZE)
+    if (AddressToCheck > PAGE_SIZE && Window->VirtualAddress != NULL)
     {
         //
-        // Address should be accessed in more than one page
+        // Address should be accessed in more than one page, a run of pages
+        // is mapped into the bulk window and copied at once
         //
-        UINT64 ReadSize = AddressToCheck;
+        while (SizeToRead != 0)
+        {
+            Offset     = AddressToRead & PAGE_4KB_OFFSET;
+            PagesCount = (Offset + SizeToRead + PAGE_SIZE - 1) / PAGE_SIZE;
 
+            if (PagesCount > MEMORY_MAPPER_BULK_WINDOW_PAGES)
+            {
+                PagesCount = MEMORY_MAPPER_BULK_WINDOW_PAGES;
+            }
+
+            ReadSize = (PagesCount * PAGE_SIZE) - Offset;
+
+            if (ReadSize > SizeToRead)
+            {
+                ReadSize = SizeToRead;
+            }
+
+            for (UINT32 i = 0; i < PagesCount; i++)
+            {
+                PhysicalAddresses[i].QuadPart = MemoryMapperReadMemorySafeByPhysicalAddressWrapperAddressMaker(TypeOfRead,
+                                                                                                               AddressToRead - Offset + (i * PAGE_SIZE));
+            }
+
+            MappedVa = MemoryMapperMapBulkWindow(Window, PhysicalAddresses, PagesCount);
+
+            //
+            // Move the memory into the buffer in a safe manner
+            //
+            memcpy(BufferToSaveMemory, (UINT64)MappedVa + Offset, ReadSize);
+
+            MemoryMapperUnmapBulkWindow(Window, PagesCount);
+
+            //
+            // Apply the changes to the next addresses (if any)
+            //
+            SizeToRead         = SizeToRead - ReadSize;
+            AddressToRead      = AddressToRead + ReadSize;
+            BufferToSaveMemory = BufferToSaveMemory + ReadSize;
+        }
+
+        return TRUE;
+    }
+    else if (AddressToCheck > PAGE_SIZE)
+    {
+        //
+        // Address should be accessed in more than one page
+        //
         while (SizeToRead != 0)
         {
             ReadSize = (UINT64)PAGE_ALIGN(AddressToRead + PAGE_SIZE) - AddressToRead;
@@ -1236,9 +1477,15 @@ MemoryMapperWriteMemorySafeWrapper(MEMORY_MAPPER_WRAPPER_FOR_MEMORY_WRITE TypeOf
                                    PCR3_TYPE                              TargetProcessCr3,
                                    UINT32                                 TargetProcessId)
 {
-    ULONG            ProcessorIndex = KeGetCurrentProcessorNumber();
-    UINT64           AddressToCheck;
-    PHYSICAL_ADDRESS PhysicalAddress;
+    ULONG                      ProcessorIndex = KeGetCurrentProcessorNumber();
+    UINT64                     AddressToCheck;
+    PHYSICAL_ADDRESS           PhysicalAddress;
+    PHYSICAL_ADDRESS           PhysicalAddresses[MEMORY_MAPPER_BULK_WINDOW_PAGES];
+    PMEMORY_MAPPER_BULK_WINDOW Window = &g_MemoryMapper[ProcessorIndex].BulkWindowForWrite;
+    UINT64                     Offset;
+    UINT64                     PagesCount;
+    UINT64                     WriteSize;
+    PVOID                      MappedVa;
 
     //
     // Check to see if PTE and Reserved VA already initialized
@@ -1252,18 +1499,69 @@ MemoryMapperWriteMemorySafeWrapper(MEMORY_MAPPER_WRAPPER_FOR_MEMORY_WRITE TypeOf
         return FALSE;
     }
 
+    //
+    // The written memory might be a paging structure, so the cached
+    // translations of all cores are no longer trusted
+    //
+    AddressTranslationCacheInvalidateAllCores();
+
     //
     // Check whether it needs multiple accesses to different pages or no
     //
     AddressToCheck = (CHAR *)DestinationAddr + SizeToWrite - ((CHAR *)PAGE_ALIGN(DestinationAddr));
 
-    if (AddressToCheck > PAGE_SIZE)
+    if (AddressToCheck > PAGE_SIZE && Window->VirtualAddress != NULL)
     {
         //
-        // It need multiple accesses to different pages to access the memory
+        // It need multiple accesses to different pages, a run of pages
+        // is mapped into the bulk window and written at once
         //
+        while (SizeToWrite != 0)
+        {
+            Offset     = DestinationAddr & PAGE_4KB_OFFSET;
+            PagesCount = (Offset + SizeToWrite + PAGE_SIZE - 1) / PAGE_SIZE;
 
-        UINT64 WriteSize = AddressToCheck;
+            if (PagesCount > MEMORY_MAPPER_BULK_WINDOW_PAGES)
+            {
+                PagesCount = MEMORY_MAPPER_BULK_WINDOW_PAGES;
+            }
+
+            WriteSize = (PagesCount * PAGE_SIZE) - Offset;
+
+            if (WriteSize > SizeToWrite)
+            {
+                WriteSize = SizeToWrite;
+            }
+
+            for (UINT32 i = 0; i < PagesCount; i++)
+            {
+                PhysicalAddresses[i].QuadPart = MemoryMapperWriteMemorySafeWrapperAddressMaker(TypeOfWrite,
+                                                                                               DestinationAddr - Offset + (i * PAGE_SIZE),
+                                                                                               TargetProcessCr3,
+                                                                                               TargetProcessId);
+            }
+
+            MappedVa = MemoryMapperMapBulkWindow(Window, PhysicalAddresses, PagesCount);
+
+            //
+            // Move the buffer into the memory in a safe manner
+            //
+            memcpy((UINT64)MappedVa + Offset, Source, WriteSize);
+
+            MemoryMapperUnmapBulkWindow(Window, PagesCount);
+
+            SizeToWrite     = SizeToWrite - WriteSize;
+            DestinationAddr = DestinationAddr + WriteSize;
+            Source          = Source + WriteSize;
+        }
+
+        return TRUE;
+    }
+    else if (AddressToCheck > PAGE_SIZE)
+    {
+        //
+        // It need multiple accesses to different pages to access the memory
+        //
 
         while (SizeToWrite != 0)
         {
@@ -1632,6 +1930,7 @@ MemoryMapperMapPhysicalAddressToPte(PHYSICAL_ADDRESS PhysicalAddress,
     // we should use invlpg in physical computers as it won't invalidate it automatically
     //
     __invlpg(TargetProcessVirtualAddress);
+    AddressTranslationCacheInvalidateAllCores();
 
     //
     // Restore the original process
@@ -1673,5 +1972,7 @@ MemoryMapperSetSupervisorBitWithoutSwitchingByCr3(PVOID Va, BOOLEAN Set, PAGING_
         Pml->Fields.Supervisor = 0;
     }
 
+    AddressTranslationCacheInvalidateAllCores();
+
     return TRUE;
 }
@@ -0,0 +1,336 @@
+/**
+ * @file PhysicalMemoryMap.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Map of the physical memory ranges that are backed by RAM
+ * @details The map is built once from the RAM ranges that the BIOS gives to
+ * Windows, then the uncacheable ranges of the MTRRs (device apertures) are
+ * removed from it, so the commands that operate on the whole physical memory
+ * only visit the pages that are backed by RAM
+ *
+ * @version 0.2
+ * @date 2023-05-09
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Insert a range into the physical memory map
+ *
+ * @param Index Index of the new range
+ * @param BaseAddress Start of the range
+ * @param EndAddress End of the range (exclusive)
+ *
+ * @return BOOLEAN Shows whether there was a free entry or not
+ */
+static BOOLEAN
+PhysicalMemoryMapInsertRange(UINT32 Index, UINT64 BaseAddress, UINT64 EndAddress)
+{
+    if (g_PhysicalMemoryMapCount >= PhysicalMemoryMapMaximumRanges)
+    {
+        return FALSE;
+    }
+
+    RtlMoveMemory(&g_PhysicalMemoryMapRanges[Index + 1],
+                  &g_PhysicalMemoryMapRanges[Index],
+                  (g_PhysicalMemoryMapCount - Index) * sizeof(PHYSICAL_MEMORY_MAP_RANGE));
+
+    g_PhysicalMemoryMapRanges[Index].BaseAddress = BaseAddress;
+    g_PhysicalMemoryMapRanges[Index].EndAddress  = EndAddress;
+
+    g_PhysicalMemoryMapCount++;
+
+    return TRUE;
+}
+
+/**
+ * @brief Remove a range of addresses from the physical memory map
+ *
+ * @param BaseAddress Start of the range
+ * @param EndAddress End of the range (exclusive)
+ *
+ * @return VOID
+ */
+static VOID
+PhysicalMemoryMapRemoveRange(UINT64 BaseAddress, UINT64 EndAddress)
+{
+    UINT32 Index = 0;
+
+    while (Index < g_PhysicalMemoryMapCount)
+    {
+        PPHYSICAL_MEMORY_MAP_RANGE Range = &g_PhysicalMemoryMapRanges[Index];
+
+        if (Range->EndAddress <= BaseAddress || Range->BaseAddress >= EndAddress)
+        {
+            //
+            // Not overlapped
+            //
+            Index++;
+            continue;
+        }
+
+        if (Range->BaseAddress < BaseAddress && Range->EndAddress > EndAddress)
+        {
+            //
+            // The removed addresses are in the middle of the range, so it's split
+            // into two ranges (if there is no free entry, the tail is dropped)
+            //
+            PhysicalMemoryMapInsertRange(Index + 1, EndAddress, Range->EndAddress);
+            Range->EndAddress = BaseAddress;
+            Index += 2;
+        }
+        else if (Range->BaseAddress < BaseAddress)
+        {
+            Range->EndAddress = BaseAddress;
+            Index++;
+        }
+        else if (Range->EndAddress > EndAddress)
+        {
+            Range->BaseAddress = EndAddress;
+            Index++;
+        }
+        else
+        {
+            //
+            // The entire range is removed
+            //
+            RtlMoveMemory(&g_PhysicalMemoryMapRanges[Index],
+                          &g_PhysicalMemoryMapRanges[Index + 1],
+                          (g_PhysicalMemoryMapCount - Index - 1) * sizeof(PHYSICAL_MEMORY_MAP_RANGE));
+
+            g_PhysicalMemoryMapCount--;
+        }
+    }
+}
+
+/**
+ * @brief Find the range that contains the physical address
+ * @details this function performs a binary search, so it can be
+ * called from vmx-root
+ *
+ * @param PhysicalAddress
+ *
+ * @return INT32 Index of the first range that its end is after the address,
+ * or -1 if there is no such range
+ */
+static INT32
+PhysicalMemoryMapFindRange(UINT64 PhysicalAddress)
+{
+    UINT32 Low  = 0;
+    UINT32 High = g_PhysicalMemoryMapCount;
+
+    while (Low < High)
+    {
+        UINT32 Middle = Low + ((High - Low) / 2);
+
+        if (g_PhysicalMemoryMapRanges[Middle].EndAddress <= PhysicalAddress)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    return Low < g_PhysicalMemoryMapCount ? (INT32)Low : -1;
+}
+
+/**
+ * @brief Build the physical memory map
+ * @details should be called in PASSIVE_LEVEL and after building the
+ * MTRR map
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+PhysicalMemoryMapInitialize()
+{
+    PPHYSICAL_MEMORY_RANGE PhysicalMemoryRanges = NULL;
+    UINT64                 BaseAddress;
+    UINT64                 EndAddress;
+    UINT32                 Index;
+    INT32                  Position;
+
+    g_PhysicalMemoryMapCount       = 0;
+    g_PhysicalMemoryMapInitialized = FALSE;
+
+    //
+    // Read the RAM regions (BIOS) gives these details to Windows
+    //
+    PhysicalMemoryRanges = MmGetPhysicalMemoryRanges();
+
+    if (PhysicalMemoryRanges == NULL)
+    {
+        return FALSE;
+    }
+
+    for (Index = 0;
+         PhysicalMemoryRanges[Index].BaseAddress.QuadPart != 0 || PhysicalMemoryRanges[Index].NumberOfBytes.QuadPart != 0;
+         Index++)
+    {
+        BaseAddress = (UINT64)PAGE_ALIGN(PhysicalMemoryRanges[Index].BaseAddress.QuadPart);
+        EndAddress  = PhysicalMemoryRanges[Index].BaseAddress.QuadPart + PhysicalMemoryRanges[Index].NumberOfBytes.QuadPart;
+
+        if (EndAddress <= BaseAddress)
+        {
+            continue;
+        }
+
+        //
+        // Keep the ranges sorted, and coalesce the adjacent ranges
+        //
+        Position = PhysicalMemoryMapFindRange(BaseAddress);
+
+        if (Position == -1)
+        {
+            Position = g_PhysicalMemoryMapCount;
+        }
+
+        if (Position > 0 && g_PhysicalMemoryMapRanges[Position - 1].EndAddress == BaseAddress)
+        {
+            g_PhysicalMemoryMapRanges[Position - 1].EndAddress = EndAddress;
+        }
+        else if ((UINT32)Position < g_PhysicalMemoryMapCount && g_PhysicalMemoryMapRanges[Position].BaseAddress <= EndAddress)
+        {
+            g_PhysicalMemoryMapRanges[Position].BaseAddress = min(g_PhysicalMemoryMapRanges[Position].BaseAddress, BaseAddress);
+            g_PhysicalMemoryMapRanges[Position].EndAddress  = max(g_PhysicalMemoryMapRanges[Position].EndAddress, EndAddress);
+        }
+        else if (!PhysicalMemoryMapInsertRange(Position, BaseAddress, EndAddress))
+        {
+            LogWarning("Warning, too many RAM ranges, the ranges after 0x%llx are ignored", BaseAddress);
+            break;
+        }
+    }
+
+    ExFreePool(PhysicalMemoryRanges);
+
+    //
+    // Uncacheable ranges are device apertures (or they're really slow to read),
+    // so they're not considered as RAM
+    //
+    for (Index = 0; Index < g_EptState->NumberOfEnabledMemoryRanges; Index++)
+    {
+        if (g_EptState->MemoryRanges[Index].MemoryType == MEMORY_TYPE_UNCACHEABLE)
+        {
+            PhysicalMemoryMapRemoveRange(g_EptState->MemoryRanges[Index].PhysicalBaseAddress,
+                                         g_EptState->MemoryRanges[Index].PhysicalEndAddress + 1);
+        }
+    }
+
+    for (Index = 0; Index < g_PhysicalMemoryMapCount; Index++)
+    {
+        LogDebugInfo("RAM Range: Base=0x%llx End=0x%llx",
+                     g_PhysicalMemoryMapRanges[Index].BaseAddress,
+                     g_PhysicalMemoryMapRanges[Index].EndAddress);
+    }
+
+    g_PhysicalMemoryMapInitialized = g_PhysicalMemoryMapCount != 0;
+
+    return g_PhysicalMemoryMapInitialized;
+}
+
+/**
+ * @brief Uninitialize the physical memory map
+ *
+ * @return VOID
+ */
+VOID
+PhysicalMemoryMapUninitialize()
+{
+    g_PhysicalMemoryMapInitialized = FALSE;
+    g_PhysicalMemoryMapCount       = 0;
+}
+
+/**
+ * @brief Check whether the physical address is backed by RAM or not
+ * @details this function can be called from vmx-root
+ *
+ * @param PhysicalAddress
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+PhysicalMemoryMapIsRam(UINT64 PhysicalAddress)
+{
+    INT32 Index;
+
+    if (!g_PhysicalMemoryMapInitialized)
+    {
+        //
+        // The map is not available, so we cannot say that the address is not RAM
+        //
+        return TRUE;
+    }
+
+    Index = PhysicalMemoryMapFindRange(PhysicalAddress);
+
+    return Index != -1 && g_PhysicalMemoryMapRanges[Index].BaseAddress <= PhysicalAddress;
+}
+
+/**
+ * @brief Clip a range of physical addresses to the first part of it that
+ * is backed by RAM
+ * @details this function can be called from vmx-root, it's used for iterating
+ * over the RAM ranges between two addresses (by passing the end of the returned
+ * range as the start of the next call)
+ *
+ * @param RangeStart Start of the range, the start of the backed part is saved here
+ * @param RangeEnd End of the range (exclusive), the end of the backed part is saved here
+ *
+ * @return BOOLEAN Returns FALSE if there is no RAM in the range
+ */
+BOOLEAN
+PhysicalMemoryMapGetNextRange(UINT64 * RangeStart, UINT64 * RangeEnd)
+{
+    INT32 Index;
+
+    if (*RangeStart >= *RangeEnd)
+    {
+        return FALSE;
+    }
+
+    if (!g_PhysicalMemoryMapInitialized)
+    {
+        //
+        // The map is not available, so the whole range is considered as RAM
+        //
+        return TRUE;
+    }
+
+    Index = PhysicalMemoryMapFindRange(*RangeStart);
+
+    if (Index == -1 || g_PhysicalMemoryMapRanges[Index].BaseAddress >= *RangeEnd)
+    {
+        return FALSE;
+    }
+
+    *RangeStart = max(*RangeStart, g_PhysicalMemoryMapRanges[Index].BaseAddress);
+    *RangeEnd   = min(*RangeEnd, g_PhysicalMemoryMapRanges[Index].EndAddress);
+
+    return TRUE;
+}
+
+/**
+ * @brief Get a range of the physical memory map by its index
+ *
+ * @param Index
+ * @param BaseAddress Start of the range
+ * @param Size Size of the range
+ *
+ * @return BOOLEAN Returns FALSE if there is no range with this index
+ */
+BOOLEAN
+PhysicalMemoryMapGetRange(UINT32 Index, UINT64 * BaseAddress, UINT64 * Size)
+{
+    if (Index >= g_PhysicalMemoryMapCount)
+    {
+        return FALSE;
+    }
+
+    *BaseAddress = g_PhysicalMemoryMapRanges[Index].BaseAddress;
+    *Size        = g_PhysicalMemoryMapRanges[Index].EndAddress - g_PhysicalMemoryMapRanges[Index].BaseAddress;
+
+    return TRUE;
+}
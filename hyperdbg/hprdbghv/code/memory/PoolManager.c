@@ -41,6 +41,303 @@ PlmgrFreeRequestNewAllocation(VOID)
     g_RequestNewAllocation = NULL;
 }
 
+/**
+ * @brief Get the size class of a pool
+ * @details the size class 'n' holds the pools that are at most (1 << n) bytes
+ *
+ * @param Size Size of the pool
+ * @return UINT32 The size class or NumberOfPoolSizeClasses if the size is too large
+ */
+UINT32
+PlmgrGetSizeClass(SIZE_T Size)
+{
+    ULONG Index = 0;
+
+    if (Size <= 1)
+    {
+        return 0;
+    }
+
+    _BitScanReverse64(&Index, Size - 1);
+
+    if (Index + 1 >= NumberOfPoolSizeClasses)
+    {
+        return NumberOfPoolSizeClasses;
+    }
+
+    return Index + 1;
+}
+
+/**
+ * @brief Get the bucket of an address in the table of pools
+ *
+ * @param Address Address of the pool
+ * @return PLIST_ENTRY The head of the bucket
+ */
+PLIST_ENTRY
+PlmgrGetHashBucket(UINT64 Address)
+{
+    //
+    // Small pools are 16-byte aligned and large pools are page aligned
+    //
+    return &g_PoolHashBuckets[((Address >> 4) ^ (Address >> 12)) & (NumberOfPoolHashBuckets - 1)];
+}
+
+/**
+ * @brief Request a refill of an intention if its free pools are below the low watermark
+ * @details this function might be called from vmx-root, so the refill is only
+ * queued and it's performed by the refill worker in PASSIVE_LEVEL
+ *
+ * @param Intention The intention of the pools
+ * @param Size Size of the pool that was requested
+ * @return VOID
+ */
+VOID
+PlmgrRequestRefillIfNeeded(POOL_ALLOCATION_INTENTION Intention, SIZE_T Size)
+{
+    PPOOL_INTENTION_STATE State     = &g_PoolIntentionStates[Intention];
+    LONG                  FreeCount = State->FreeCount;
+
+    if (State->LowWatermark == 0 || FreeCount >= (LONG)State->LowWatermark)
+    {
+        return;
+    }
+
+    //
+    // Only one refill is requested at a time
+    //
+    if (InterlockedCompareExchange(&State->RefillPending, TRUE, FALSE) != FALSE)
+    {
+        return;
+    }
+
+    if (State->Size != 0)
+    {
+        Size = State->Size;
+    }
+
+    if (Size == 0 || !PoolManagerRequestAllocation(Size, State->HighWatermark - FreeCount, Intention))
+    {
+        InterlockedExchange(&State->RefillPending, FALSE);
+        return;
+    }
+
+    State->RefillRequestTime = KeQueryInterruptTime();
+
+    //
+    // The event can't be signaled from vmx-root, in this case the worker
+    // finds the request once its wait times out
+    //
+    if (VmxGetCurrentExecutionMode() == FALSE && KeGetCurrentIrql() <= DISPATCH_LEVEL)
+    {
+        KeSetEvent(&g_PoolRefillWorkerEvent, IO_NO_INCREMENT, FALSE);
+    }
+}
+
+/**
+ * @brief Update the maximum count of pools of an intention that were in
+ * use at the same time
+ *
+ * @param State The state of the intention
+ * @param BusyCount The current count of pools that are in use
+ * @return VOID
+ */
+VOID
+PlmgrUpdatePeakBusyCount(PPOOL_INTENTION_STATE State, LONG BusyCount)
+{
+    LONG PeakBusyCount = State->PeakBusyCount;
+
+    while (BusyCount > PeakBusyCount)
+    {
+        LONG PreviousPeak = InterlockedCompareExchange(&State->PeakBusyCount, BusyCount, PeakBusyCount);
+
+        if (PreviousPeak == PeakBusyCount)
+        {
+            break;
+        }
+
+        PeakBusyCount = PreviousPeak;
+    }
+}
+
+/**
+ * @brief Perform the requested allocations of g_RequestNewAllocation
+ * @details this function should be called from PASSIVE_LEVEL
+ *
+ * @return BOOLEAN If all of the allocations were successful it returns TRUE
+ */
+BOOLEAN
+PlmgrPerformAllocations()
+{
+    BOOLEAN                Result = TRUE;
+    REQUEST_NEW_ALLOCATION Request;
+    PPOOL_INTENTION_STATE  State;
+    UINT64                 Latency;
+
+    SpinlockLock(&LockForPerformingAllocation);
+
+    //
+    // Requests that are queued after this point, signal it again
+    //
+    g_IsNewRequestForAllocationReceived = FALSE;
+
+    for (SIZE_T i = 0; i < MaximumRequestsQueueDepth; i++)
+    {
+        REQUEST_NEW_ALLOCATION * CurrentItem = &g_RequestNewAllocation[i];
+
+        if (CurrentItem->Size == 0)
+        {
+            continue;
+        }
+
+        //
+        // Take the request and free the data for future use
+        //
+        SpinlockLock(&LockForRequestAllocation);
+
+        Request                = *CurrentItem;
+        CurrentItem->Count     = 0;
+        CurrentItem->Intention = 0;
+        CurrentItem->Size      = 0;
+
+        SpinlockUnlock(&LockForRequestAllocation);
+
+        if (!PoolManagerAllocateAndAddToPoolTable(Request.Size, Request.Count, Request.Intention))
+        {
+            Result = FALSE;
+            continue;
+        }
+
+        //
+        // Check whether it was a refill of the intention
+        //
+        State = &g_PoolIntentionStates[Request.Intention];
+
+        if (State->RefillPending)
+        {
+            Latency = KeQueryInterruptTime() - State->RefillRequestTime;
+
+            State->Refills++;
+            State->TotalRefillLatency += Latency;
+
+            if (Latency > State->MaximumRefillLatency)
+            {
+                State->MaximumRefillLatency = Latency;
+            }
+
+            InterlockedExchange(&State->RefillPending, FALSE);
+        }
+    }
+
+    SpinlockUnlock(&LockForPerformingAllocation);
+
+    return Result;
+}
+
+/**
+ * @brief The worker thread that refills the pools in PASSIVE_LEVEL
+ *
+ * @param Context Not used
+ * @return VOID
+ */
+VOID
+PlmgrRefillWorker(PVOID Context)
+{
+    LARGE_INTEGER Timeout;
+
+    UNREFERENCED_PARAMETER(Context);
+
+    //
+    // Relative time in 100ns units
+    //
+    Timeout.QuadPart = -10000LL * PoolRefillWorkerInterval;
+
+    while (!g_PoolRefillWorkerShouldStop)
+    {
+        KeWaitForSingleObject(&g_PoolRefillWorkerEvent, Executive, KernelMode, FALSE, &Timeout);
+
+        if (g_PoolRefillWorkerShouldStop)
+        {
+            break;
+        }
+
+        //
+        // Only allocations are performed here, deallocations are deferred
+        // until it's safe to remove the pools
+        //
+        if (g_IsNewRequestForAllocationReceived)
+        {
+            PlmgrPerformAllocations();
+        }
+    }
+
+    PsTerminateSystemThread(STATUS_SUCCESS);
+}
+
+/**
+ * @brief Start the refill worker
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+PlmgrStartRefillWorker()
+{
+    HANDLE   ThreadHandle;
+    NTSTATUS Status;
+
+    KeInitializeEvent(&g_PoolRefillWorkerEvent, SynchronizationEvent, FALSE);
+    g_PoolRefillWorkerShouldStop = FALSE;
+
+    Status = PsCreateSystemThread(&ThreadHandle, THREAD_ALL_ACCESS, NULL, NULL, NULL, PlmgrRefillWorker, NULL);
+
+    if (!NT_SUCCESS(Status))
+    {
+        return FALSE;
+    }
+
+    Status = ObReferenceObjectByHandle(ThreadHandle, THREAD_ALL_ACCESS, *PsThreadType, KernelMode, &g_PoolRefillWorkerThread, NULL);
+
+    if (!NT_SUCCESS(Status))
+    {
+        //
+        // The thread can't be waited for, so it's stopped right now
+        //
+        g_PoolRefillWorkerShouldStop = TRUE;
+        KeSetEvent(&g_PoolRefillWorkerEvent, IO_NO_INCREMENT, FALSE);
+        ZwWaitForSingleObject(ThreadHandle, FALSE, NULL);
+        ZwClose(ThreadHandle);
+
+        g_PoolRefillWorkerThread = NULL;
+        return FALSE;
+    }
+
+    ZwClose(ThreadHandle);
+
+    return TRUE;
+}
+
+/**
+ * @brief Stop the refill worker and wait for it
+ *
+ * @return VOID
+ */
+VOID
+PlmgrStopRefillWorker()
+{
+    if (g_PoolRefillWorkerThread == NULL)
+    {
+        return;
+    }
+
+    g_PoolRefillWorkerShouldStop = TRUE;
+    KeSetEvent(&g_PoolRefillWorkerEvent, IO_NO_INCREMENT, FALSE);
+
+    KeWaitForSingleObject(g_PoolRefillWorkerThread, Executive, KernelMode, FALSE, NULL);
+    ObDereferenceObject(g_PoolRefillWorkerThread);
+
+    g_PoolRefillWorkerThread = NULL;
+}
+
 // ----------------------------------------------------------------------------
 // Public Interfaces
 //
@@ -68,6 +365,29 @@ PoolManagerInitialize()
     //
     InitializeListHead(&g_ListOfAllocatedPoolsHead);
 
+    //
+    // Initialize the free lists and the buckets of addresses
+    //
+    for (UINT32 i = 0; i < NumberOfPoolIntentions; i++)
+    {
+        for (UINT32 j = 0; j < NumberOfPoolSizeClasses; j++)
+        {
+            InitializeSListHead(&g_PoolFreeLists[i][j]);
+        }
+    }
+
+    for (UINT32 i = 0; i < NumberOfPoolHashBuckets; i++)
+    {
+        InitializeListHead(&g_PoolHashBuckets[i]);
+    }
+
+    InitializeSListHead(&g_PoolsToBeFreedList);
+
+    //
+    // Nothing is requested nor refilled yet
+    //
+    RtlZeroMemory(g_PoolIntentionStates, sizeof(g_PoolIntentionStates));
+
     //
     // Request pages to be allocated for converting 2MB to 4KB pages
     //
@@ -79,20 +399,44 @@ PoolManagerInitialize()
     PoolManagerRequestAllocation(sizeof(EPT_HOOKED_PAGE_DETAIL), 5, TRACKING_HOOKED_PAGES);
 
     //
-    // Request pages to be allocated for Trampoline of Executable hooked pages
+    // Request pages to be allocated for Trampoline of Executable hooked pages (slabs of trampolines)
     //
-    PoolManagerRequestAllocation(MAX_EXEC_TRAMPOLINE_SIZE, 5, EXEC_TRAMPOLINE);
+    PoolManagerRequestAllocation(sizeof(EPT_HOOK_TRAMPOLINES_SLAB), 1, EXEC_TRAMPOLINE);
 
     //
     // Request pages to be allocated for detour hooked pages details
     //
     PoolManagerRequestAllocation(sizeof(HIDDEN_HOOKS_DETOUR_DETAILS), 5, DETOUR_HOOK_DETAILS);
 
+    //
+    // Request pages to be allocated for pages with many hidden breakpoints
+    //
+    PoolManagerRequestAllocation(sizeof(EPT_HIDDEN_BREAKPOINT) * HIDDEN_BREAKPOINTS_SET_CAPACITY, 2, HIDDEN_BREAKPOINTS_SET);
+
+    //
+    // Keep the above pools available once they're used, pools of other
+    // intentions are refilled once their watermarks are set
+    //
+    PoolManagerSetWatermarks(SPLIT_2MB_PAGING_TO_4KB_PAGE, 2, 5);
+    PoolManagerSetWatermarks(TRACKING_HOOKED_PAGES, 2, 5);
+    PoolManagerSetWatermarks(EXEC_TRAMPOLINE, 1, 1);
+    PoolManagerSetWatermarks(DETOUR_HOOK_DETAILS, 2, 5);
+    PoolManagerSetWatermarks(HIDDEN_BREAKPOINTS_SET, 1, 2);
+
     //
     // Nothing to deallocate
     //
     g_IsNewRequestForDeAllocation = FALSE;
 
+    //
+    // Start the worker of refilling pools, without it the pools are
+    // still allocated once an IOCTL is received
+    //
+    if (!PlmgrStartRefillWorker())
+    {
+        LogWarning("Warning, unable to start the worker of refilling pools");
+    }
+
     //
     // Let's start the allocations
     //
@@ -111,6 +455,11 @@ PoolManagerUninitialize()
     UINT64      Address  = 0;
     ListTemp             = &g_ListOfAllocatedPoolsHead;
 
+    //
+    // No more refills
+    //
+    PlmgrStopRefillWorker();
+
     SpinlockLock(&LockForReadingPool);
 
     while (&g_ListOfAllocatedPoolsHead != ListTemp->Flink)
@@ -134,6 +483,7 @@ PoolManagerUninitialize()
         // Unlink the PoolTable
         //
         RemoveEntryList(&PoolTable->PoolsList);
+        RemoveEntryList(&PoolTable->HashList);
 
         //
         // Free the record itself
@@ -141,6 +491,19 @@ PoolManagerUninitialize()
         ExFreePoolWithTag(PoolTable, POOLTAG);
     }
 
+    //
+    // The records in the free lists are already freed
+    //
+    for (UINT32 i = 0; i < NumberOfPoolIntentions; i++)
+    {
+        for (UINT32 j = 0; j < NumberOfPoolSizeClasses; j++)
+        {
+            InitializeSListHead(&g_PoolFreeLists[i][j]);
+        }
+    }
+
+    InitializeSListHead(&g_PoolsToBeFreedList);
+
     SpinlockUnlock(&LockForReadingPool);
 
     PlmgrFreeRequestNewAllocation();
@@ -157,20 +520,21 @@ PoolManagerUninitialize()
 BOOLEAN
 PoolManagerFreePool(UINT64 AddressToFree)
 {
+    PLIST_ENTRY Bucket   = PlmgrGetHashBucket(AddressToFree);
     PLIST_ENTRY ListTemp = 0;
     BOOLEAN     Result   = FALSE;
-    ListTemp             = &g_ListOfAllocatedPoolsHead;
+    ListTemp             = Bucket;
 
-    SpinlockLock(&LockForReadingPool);
+    SpinlockLockNamed(&LockForReadingPool, "hv: pool manager (free)");
 
-    while (&g_ListOfAllocatedPoolsHead != ListTemp->Flink)
+    while (Bucket != ListTemp->Flink)
     {
         ListTemp = ListTemp->Flink;
 
         //
         // Get the head of the record
         //
-        PPOOL_TABLE PoolTable = (PPOOL_TABLE)CONTAINING_RECORD(ListTemp, POOL_TABLE, PoolsList);
+        PPOOL_TABLE PoolTable = (PPOOL_TABLE)CONTAINING_RECORD(ListTemp, POOL_TABLE, HashList);
 
         if (PoolTable->Address == AddressToFree)
         {
@@ -178,8 +542,23 @@ PoolManagerFreePool(UINT64 AddressToFree)
             // We found an entry that matched the detailed from
             // previously allocated pools
             //
-            PoolTable->ShouldBeFreed = TRUE;
-            Result                   = TRUE;
+            Result = TRUE;
+
+            if (!PoolTable->ShouldBeFreed)
+            {
+                PoolTable->ShouldBeFreed = TRUE;
+
+                //
+                // A busy pool is not in any free list, so it's added to the
+                // pools that will be freed, while a free pool is added once
+                // it's removed from its free list by PoolManagerRequestPool
+                //
+                if (PoolTable->IsBusy)
+                {
+                    InterlockedDecrement(&g_PoolIntentionStates[PoolTable->Intention].BusyCount);
+                    InterlockedPushEntrySList(&g_PoolsToBeFreedList, &PoolTable->FreeListEntry);
+                }
+            }
 
             g_IsNewRequestForDeAllocation = TRUE;
             break;
@@ -211,13 +590,117 @@ PoolManagerShowPreAllocatedPools()
         //
         PPOOL_TABLE PoolTable = (PPOOL_TABLE)CONTAINING_RECORD(ListTemp, POOL_TABLE, PoolsList);
 
-        LogInfo("Pool details, Pool intention: %x | Pool address: %llx | Pool state: %s | Should be freed: %s | Already freed: %s\n",
+        LogInfo("Pool details, Pool intention: %x | Pool address: %llx | Pool size: %llx | Pool state: %s | Should be freed: %s | Already freed: %s\n",
                 PoolTable->Intention,
                 PoolTable->Address,
+                PoolTable->Size,
                 PoolTable->IsBusy ? "used" : "free",
                 PoolTable->ShouldBeFreed ? "true" : "false",
                 PoolTable->AlreadyFreed ? "true" : "false");
     }
+
+    //
+    // Show the statistics of intentions (latencies are in microseconds)
+    //
+    for (UINT32 i = 0; i < NumberOfPoolIntentions; i++)
+    {
+        PPOOL_INTENTION_STATE State = &g_PoolIntentionStates[i];
+
+        LogInfo("Pool intention: %x | Free pools: %d | Watermarks: %d-%d | Requests: %lld | Misses: %lld | Refills: %lld | Average refill latency: %lld | Maximum refill latency: %lld\n",
+                i,
+                State->FreeCount,
+                State->LowWatermark,
+                State->HighWatermark,
+                State->Requests,
+                State->Misses,
+                State->Refills,
+                State->Refills ? (State->TotalRefillLatency / State->Refills) / 10 : 0,
+                State->MaximumRefillLatency / 10);
+    }
+}
+
+/**
+ * @brief Query the statistics of the pools of all intentions
+ * @details this function should be called from vmx non-root, the
+ * pools that should be freed are not counted as busy or free pools
+ *
+ * @param Statistics The array to save the statistics (NumberOfPoolIntentions entries)
+ * @return VOID
+ */
+VOID
+PoolManagerQueryStatistics(PDEBUGGER_POOL_INTENTION_STATISTICS Statistics)
+{
+    PLIST_ENTRY ListTemp = &g_ListOfAllocatedPoolsHead;
+
+    RtlZeroMemory(Statistics, NumberOfPoolIntentions * sizeof(DEBUGGER_POOL_INTENTION_STATISTICS));
+
+    SpinlockLock(&LockForReadingPool);
+
+    while (&g_ListOfAllocatedPoolsHead != ListTemp->Flink)
+    {
+        ListTemp = ListTemp->Flink;
+
+        //
+        // Get the head of the record
+        //
+        PPOOL_TABLE PoolTable = (PPOOL_TABLE)CONTAINING_RECORD(ListTemp, POOL_TABLE, PoolsList);
+
+        if (PoolTable->Intention >= NumberOfPoolIntentions)
+        {
+            continue;
+        }
+
+        Statistics[PoolTable->Intention].TotalPools++;
+        Statistics[PoolTable->Intention].Bytes += PoolTable->Size;
+
+        if (PoolTable->ShouldBeFreed)
+        {
+            continue;
+        }
+
+        if (PoolTable->IsBusy)
+        {
+            Statistics[PoolTable->Intention].BusyPools++;
+            Statistics[PoolTable->Intention].BusyBytes += PoolTable->Size;
+        }
+        else
+        {
+            Statistics[PoolTable->Intention].FreePools++;
+        }
+    }
+
+    SpinlockUnlock(&LockForReadingPool);
+
+    for (UINT32 i = 0; i < NumberOfPoolIntentions; i++)
+    {
+        Statistics[i].PeakBusyPools = g_PoolIntentionStates[i].PeakBusyCount;
+        Statistics[i].Requests      = g_PoolIntentionStates[i].Requests;
+        Statistics[i].Misses        = g_PoolIntentionStates[i].Misses;
+    }
+}
+
+/**
+ * @brief Set the watermarks of refilling the pools of an intention
+ * @details once the free pools of the intention go below the low watermark,
+ * the pools are refilled up to the high watermark in PASSIVE_LEVEL
+ *
+ * @param Intention The intention of the pools
+ * @param LowWatermark The low watermark (zero disables refilling)
+ * @param HighWatermark The high watermark
+ * @return BOOLEAN Returns FALSE if the parameters are not valid
+ */
+BOOLEAN
+PoolManagerSetWatermarks(POOL_ALLOCATION_INTENTION Intention, UINT32 LowWatermark, UINT32 HighWatermark)
+{
+    if (Intention >= NumberOfPoolIntentions || LowWatermark > HighWatermark)
+    {
+        return FALSE;
+    }
+
+    g_PoolIntentionStates[Intention].HighWatermark = HighWatermark;
+    g_PoolIntentionStates[Intention].LowWatermark  = LowWatermark;
+
+    return TRUE;
 }
 
 /**
@@ -234,18 +717,73 @@ PoolManagerShowPreAllocatedPools()
 UINT64
 PoolManagerRequestPool(POOL_ALLOCATION_INTENTION Intention, BOOLEAN RequestNewPool, UINT32 Size)
 {
-    UINT64 Address = 0;
+    UINT64                Address   = 0;
+    UINT32                SizeClass = PlmgrGetSizeClass(Size);
+    PSLIST_ENTRY          Entry     = NULL;
+    PPOOL_TABLE           PoolTable = NULL;
+    PPOOL_INTENTION_STATE State     = NULL;
 
-    ScopedSpinlock(
-        LockForReadingPool,
-        LIST_FOR_EACH_LINK(g_ListOfAllocatedPoolsHead, POOL_TABLE, PoolsList, PoolTable) {
-            if (PoolTable->Intention == Intention && PoolTable->IsBusy == FALSE)
-            {
-                PoolTable->IsBusy = TRUE;
-                Address           = PoolTable->Address;
-                break;
-            }
-        });
+    if (Intention >= NumberOfPoolIntentions)
+    {
+        return NULL;
+    }
+
+    State = &g_PoolIntentionStates[Intention];
+    InterlockedIncrement64(&State->Requests);
+
+    //
+    // Pools of larger size classes are always large enough, but pools of
+    // the same size class might be smaller than the requested size
+    //
+    while (SizeClass < NumberOfPoolSizeClasses)
+    {
+        Entry = InterlockedPopEntrySList(&g_PoolFreeLists[Intention][SizeClass]);
+
+        if (Entry == NULL)
+        {
+            SizeClass++;
+            continue;
+        }
+
+        PoolTable = (PPOOL_TABLE)CONTAINING_RECORD(Entry, POOL_TABLE, FreeListEntry);
+        InterlockedDecrement(&State->FreeCount);
+
+        if (PoolTable->ShouldBeFreed)
+        {
+            //
+            // This pool is freed before it's used
+            //
+            InterlockedPushEntrySList(&g_PoolsToBeFreedList, &PoolTable->FreeListEntry);
+            continue;
+        }
+
+        if (PoolTable->Size < Size)
+        {
+            //
+            // Give it back and check the next size class
+            //
+            InterlockedPushEntrySList(&g_PoolFreeLists[Intention][SizeClass], &PoolTable->FreeListEntry);
+            InterlockedIncrement(&State->FreeCount);
+            SizeClass++;
+            continue;
+        }
+
+        PoolTable->IsBusy = TRUE;
+        Address           = PoolTable->Address;
+
+        PlmgrUpdatePeakBusyCount(State, InterlockedIncrement(&State->BusyCount));
+        break;
+    }
+
+    if (Address == NULL)
+    {
+        InterlockedIncrement64(&State->Misses);
+    }
+
+    //
+    // Refill the pools of this intention if they're running low
+    //
+    PlmgrRequestRefillIfNeeded(Intention, Size);
 
     //
     // Check if we need additional pools e.g another pool or the pool
@@ -264,7 +802,8 @@ PoolManagerRequestPool(POOL_ALLOCATION_INTENTION Intention, BOOLEAN RequestNewPo
 
 /**
  * @brief Allocate the new pools and add them to pool table
- * @details This function doesn't need lock as it just calls once from PASSIVE_LEVEL
+ * @details This function is called from PASSIVE_LEVEL, each pool is added to the
+ * free list of its intention and size class
  *
  * @param Size Size of each chunk
  * @param Count Count of chunks
@@ -275,6 +814,14 @@ PoolManagerRequestPool(POOL_ALLOCATION_INTENTION Intention, BOOLEAN RequestNewPo
 BOOLEAN
 PoolManagerAllocateAndAddToPoolTable(SIZE_T Size, UINT32 Count, POOL_ALLOCATION_INTENTION Intention)
 {
+    UINT32 SizeClass = PlmgrGetSizeClass(Size);
+
+    if (Intention >= NumberOfPoolIntentions || SizeClass >= NumberOfPoolSizeClasses)
+    {
+        LogError("Err, invalid pool intention or size");
+        return FALSE;
+    }
+
     for (size_t i = 0; i < Count; i++)
     {
         POOL_TABLE * SinglePool = NULL;
@@ -311,11 +858,28 @@ PoolManagerAllocateAndAddToPoolTable(SIZE_T Size, UINT32 Count, POOL_ALLOCATION_
         SinglePool->Size          = Size;
 
         //
-        // Add it to the list
+        // Add it to the list and to the bucket of its address, the lock is
+        // needed as the buckets are searched by PoolManagerFreePool
         //
+        SpinlockLockNamed(&LockForReadingPool, "hv: pool manager (add)");
+
         InsertHeadList(&g_ListOfAllocatedPoolsHead, &(SinglePool->PoolsList));
+        InsertHeadList(PlmgrGetHashBucket(SinglePool->Address), &(SinglePool->HashList));
+
+        SpinlockUnlock(&LockForReadingPool);
+
+        //
+        // Now, it can be requested
+        //
+        InterlockedPushEntrySList(&g_PoolFreeLists[Intention][SizeClass], &(SinglePool->FreeListEntry));
+        InterlockedIncrement(&g_PoolIntentionStates[Intention].FreeCount);
     }
 
+    //
+    // Pools of this intention are refilled with the same size
+    //
+    g_PoolIntentionStates[Intention].Size = Size;
+
     return TRUE;
 }
 
@@ -328,9 +892,8 @@ PoolManagerAllocateAndAddToPoolTable(SIZE_T Size, UINT32 Count, POOL_ALLOCATION_
 BOOLEAN
 PoolManagerCheckAndPerformAllocationAndDeallocation()
 {
-    BOOLEAN     Result   = TRUE;
-    PLIST_ENTRY ListTemp = 0;
-    UINT64      Address  = 0;
+    BOOLEAN      Result = TRUE;
+    PSLIST_ENTRY Entry  = NULL;
 
     //
     // let's make sure we're on vmx non-root and also we have new allocation
@@ -353,24 +916,7 @@ PoolManagerCheckAndPerformAllocationAndDeallocation()
     //
     if (g_IsNewRequestForAllocationReceived)
     {
-        for (SIZE_T i = 0; i < MaximumRequestsQueueDepth; i++)
-        {
-            REQUEST_NEW_ALLOCATION * CurrentItem = &g_RequestNewAllocation[i];
-
-            if (CurrentItem->Size != 0)
-            {
-                Result = PoolManagerAllocateAndAddToPoolTable(CurrentItem->Size,
-                                                              CurrentItem->Count,
-                                                              CurrentItem->Intention);
-
-                //
-                // Free the data for future use
-                //
-                CurrentItem->Count     = 0;
-                CurrentItem->Intention = 0;
-                CurrentItem->Size      = 0;
-            }
-        }
+        Result = PlmgrPerformAllocations();
     }
 
     //
@@ -378,18 +924,21 @@ PoolManagerCheckAndPerformAllocationAndDeallocation()
     //
     if (g_IsNewRequestForDeAllocation)
     {
-        ListTemp = &g_ListOfAllocatedPoolsHead;
+        //
+        // Take all of the pools that should be freed at once
+        //
+        Entry = InterlockedFlushSList(&g_PoolsToBeFreedList);
 
-        SpinlockLock(&LockForReadingPool);
+        SpinlockLockNamed(&LockForReadingPool, "hv: pool manager (deallocate)");
 
-        while (&g_ListOfAllocatedPoolsHead != ListTemp->Flink)
+        while (Entry != NULL)
         {
-            ListTemp = ListTemp->Flink;
-
             //
             // Get the head of the record
             //
-            PPOOL_TABLE PoolTable = (PPOOL_TABLE)CONTAINING_RECORD(ListTemp, POOL_TABLE, PoolsList);
+            PPOOL_TABLE PoolTable = (PPOOL_TABLE)CONTAINING_RECORD(Entry, POOL_TABLE, FreeListEntry);
+
+            Entry = Entry->Next;
 
             //
             // Check whther this pool should be freed or not and
@@ -409,8 +958,10 @@ PoolManagerCheckAndPerformAllocationAndDeallocation()
 
                 //
                 // Now we should remove the entry from the g_ListOfAllocatedPoolsHead
+                // and from the bucket of its address
                 //
                 RemoveEntryList(&PoolTable->PoolsList);
+                RemoveEntryList(&PoolTable->HashList);
 
                 //
                 // Free the structure pool
@@ -425,8 +976,7 @@ PoolManagerCheckAndPerformAllocationAndDeallocation()
     //
     // All allocation and deallocation are preformed
     //
-    g_IsNewRequestForDeAllocation       = FALSE;
-    g_IsNewRequestForAllocationReceived = FALSE;
+    g_IsNewRequestForDeAllocation = FALSE;
 
     return Result;
 }
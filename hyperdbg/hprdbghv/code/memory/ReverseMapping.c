@@ -0,0 +1,566 @@
+/**
+ * @file ReverseMapping.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Index of virtual addresses that map physical addresses
+ * @details The index is built on demand by walking the page-tables of all of the
+ * processes once, it's kept as an array that is sorted by the physical addresses
+ * so the virtual addresses that map a physical address are found by a binary
+ * search, the mappings are verified again once they're queried, thus the removed
+ * mappings are not reported while the index is not rebuilt
+ *
+ * @version 0.2
+ * @date 2023-05-11
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Make a canonical virtual address
+ *
+ * @param VirtualAddress
+ *
+ * @return UINT64
+ */
+static UINT64
+ReverseMappingCanonicalAddress(UINT64 VirtualAddress)
+{
+    if (VirtualAddress & (1ULL << 47))
+    {
+        VirtualAddress |= 0xffff000000000000ULL;
+    }
+
+    return VirtualAddress;
+}
+
+/**
+ * @brief Get the size of pages by their size code
+ *
+ * @param SizeCode
+ *
+ * @return UINT64
+ */
+static UINT64
+ReverseMappingGetPageSize(UINT32 SizeCode)
+{
+    switch (SizeCode)
+    {
+    case ReverseMappingPageSize1Gb:
+        return SIZE_1_GB;
+    case ReverseMappingPageSize2Mb:
+        return SIZE_2_MB;
+    default:
+        return PAGE_SIZE;
+    }
+}
+
+/**
+ * @brief Read a page-table by its physical address
+ * @details the page-tables are copied, so the tables that are freed
+ * while walking them won't cause a fault
+ *
+ * @param Pfn Page frame number of the table
+ * @param Buffer Buffer to save the table (PAGE_SIZE)
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+ReverseMappingReadTable(UINT64 Pfn, UINT64 * Buffer)
+{
+    MM_COPY_ADDRESS CopyAddress = {0};
+    SIZE_T          CopiedBytes = 0;
+
+    if (!PhysicalMemoryMapIsRam(Pfn << 12))
+    {
+        return FALSE;
+    }
+
+    CopyAddress.PhysicalAddress.QuadPart = Pfn << 12;
+
+    return NT_SUCCESS(MmCopyMemory(Buffer, CopyAddress, PAGE_SIZE, MM_COPY_MEMORY_PHYSICAL, &CopiedBytes)) &&
+           CopiedBytes == PAGE_SIZE;
+}
+
+/**
+ * @brief Read an entry of a page-table by its physical address
+ *
+ * @param Pfn Page frame number of the table
+ * @param Index Index of the entry
+ * @param Entry The entry is saved here
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+ReverseMappingReadTableEntry(UINT64 Pfn, UINT32 Index, PPAGE_ENTRY Entry)
+{
+    MM_COPY_ADDRESS CopyAddress = {0};
+    SIZE_T          CopiedBytes = 0;
+
+    if (!PhysicalMemoryMapIsRam(Pfn << 12))
+    {
+        return FALSE;
+    }
+
+    CopyAddress.PhysicalAddress.QuadPart = (Pfn << 12) + (Index * sizeof(PAGE_ENTRY));
+
+    return NT_SUCCESS(MmCopyMemory(Entry, CopyAddress, sizeof(PAGE_ENTRY), MM_COPY_MEMORY_PHYSICAL, &CopiedBytes)) &&
+           CopiedBytes == sizeof(PAGE_ENTRY) && Entry->Fields.Present;
+}
+
+/**
+ * @brief Add a mapping to the index
+ * @details the index grows up to ReverseMappingMaximumEntries mappings
+ *
+ * @param State The state of building the index
+ * @param PhysicalAddress Physical address of the page
+ * @param SizeCode Size code of the page
+ * @param VirtualAddress Virtual address of the page
+ *
+ * @return BOOLEAN Returns FALSE if the index is full
+ */
+static BOOLEAN
+ReverseMappingAddEntry(PREVERSE_MAPPING_BUILD_STATE State, UINT64 PhysicalAddress, UINT32 SizeCode, UINT64 VirtualAddress)
+{
+    PREVERSE_MAPPING_ENTRY NewEntries;
+    UINT32                 NewCapacity;
+
+    if (g_ReverseMappingCount == g_ReverseMappingCapacity)
+    {
+        NewCapacity = min(g_ReverseMappingCapacity * 2, ReverseMappingMaximumEntries);
+
+        if (NewCapacity == g_ReverseMappingCapacity)
+        {
+            State->IsTruncated = TRUE;
+            return FALSE;
+        }
+
+        NewEntries = ExAllocatePoolWithTag(NonPagedPool, NewCapacity * sizeof(REVERSE_MAPPING_ENTRY), POOLTAG);
+
+        if (NewEntries == NULL)
+        {
+            State->IsTruncated = TRUE;
+            return FALSE;
+        }
+
+        RtlCopyMemory(NewEntries, g_ReverseMappingEntries, g_ReverseMappingCount * sizeof(REVERSE_MAPPING_ENTRY));
+        ExFreePoolWithTag(g_ReverseMappingEntries, POOLTAG);
+
+        g_ReverseMappingEntries  = NewEntries;
+        g_ReverseMappingCapacity = NewCapacity;
+    }
+
+    g_ReverseMappingEntries[g_ReverseMappingCount].PhysicalKey             = PhysicalAddress | SizeCode;
+    g_ReverseMappingEntries[g_ReverseMappingCount].VirtualPageAndProcessId = (VirtualAddress & 0x0000fffffffff000ULL) |
+                                                                             ((UINT64)State->ProcessIndex << 48);
+    g_ReverseMappingCount++;
+
+    return TRUE;
+}
+
+/**
+ * @brief Add the mappings of a process to the index
+ *
+ * @param State The state of building the index
+ * @param Cr3 The kernel cr3 of the process
+ * @param FirstPml4Index The first PML4 entry that is walked
+ * @param LastPml4Index The last PML4 entry that is walked
+ *
+ * @return VOID
+ */
+static VOID
+ReverseMappingWalkProcess(PREVERSE_MAPPING_BUILD_STATE State, CR3_TYPE Cr3, UINT32 FirstPml4Index, UINT32 LastPml4Index)
+{
+    PPAGE_ENTRY Pml4 = (PPAGE_ENTRY)State->Tables[0];
+    PPAGE_ENTRY Pdpt = (PPAGE_ENTRY)State->Tables[1];
+    PPAGE_ENTRY Pd   = (PPAGE_ENTRY)State->Tables[2];
+    PPAGE_ENTRY Pt   = (PPAGE_ENTRY)State->Tables[3];
+    UINT64      VirtualAddress;
+
+    if (!ReverseMappingReadTable(Cr3.Fields.PageFrameNumber, State->Tables[0]))
+    {
+        return;
+    }
+
+    State->SelfMapPfn = Cr3.Fields.PageFrameNumber;
+
+    for (UINT32 i = FirstPml4Index; i <= LastPml4Index && !State->IsTruncated; i++)
+    {
+        //
+        // The self-map entry only maps the page-tables themselves
+        //
+        if (!Pml4[i].Fields.Present || Pml4[i].Fields.PageFrameNumber == State->SelfMapPfn ||
+            !ReverseMappingReadTable(Pml4[i].Fields.PageFrameNumber, State->Tables[1]))
+        {
+            continue;
+        }
+
+        for (UINT32 j = 0; j < 512 && !State->IsTruncated; j++)
+        {
+            if (!Pdpt[j].Fields.Present)
+            {
+                continue;
+            }
+
+            VirtualAddress = ReverseMappingCanonicalAddress(((UINT64)i << 39) | ((UINT64)j << 30));
+
+            if (Pdpt[j].Fields.LargePage)
+            {
+                ReverseMappingAddEntry(State,
+                                       (Pdpt[j].Fields.PageFrameNumber << 12) & ~(SIZE_1_GB - 1),
+                                       ReverseMappingPageSize1Gb,
+                                       VirtualAddress);
+                continue;
+            }
+
+            if (!ReverseMappingReadTable(Pdpt[j].Fields.PageFrameNumber, State->Tables[2]))
+            {
+                continue;
+            }
+
+            for (UINT32 k = 0; k < 512 && !State->IsTruncated; k++)
+            {
+                if (!Pd[k].Fields.Present)
+                {
+                    continue;
+                }
+
+                VirtualAddress = ReverseMappingCanonicalAddress(((UINT64)i << 39) | ((UINT64)j << 30) | ((UINT64)k << 21));
+
+                if (Pd[k].Fields.LargePage)
+                {
+                    ReverseMappingAddEntry(State,
+                                           (Pd[k].Fields.PageFrameNumber << 12) & ~(SIZE_2_MB - 1),
+                                           ReverseMappingPageSize2Mb,
+                                           VirtualAddress);
+                    continue;
+                }
+
+                if (!ReverseMappingReadTable(Pd[k].Fields.PageFrameNumber, State->Tables[3]))
+                {
+                    continue;
+                }
+
+                for (UINT32 l = 0; l < 512 && !State->IsTruncated; l++)
+                {
+                    if (Pt[l].Fields.Present)
+                    {
+                        ReverseMappingAddEntry(State,
+                                               Pt[l].Fields.PageFrameNumber << 12,
+                                               ReverseMappingPageSize4Kb,
+                                               VirtualAddress | ((UINT64)l << 12));
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Sort the mappings of the index by their physical addresses
+ * @details heap sort is used as it doesn't need any extra memory
+ *
+ * @return VOID
+ */
+static VOID
+ReverseMappingSortEntries()
+{
+    REVERSE_MAPPING_ENTRY Temp;
+    UINT32                Count = g_ReverseMappingCount;
+    UINT32                Root;
+    UINT32                Child;
+
+    for (UINT32 Start = Count / 2; Start-- > 0;)
+    {
+        for (Root = Start; (Child = (Root * 2) + 1) < Count; Root = Child)
+        {
+            if (Child + 1 < Count && g_ReverseMappingEntries[Child].PhysicalKey < g_ReverseMappingEntries[Child + 1].PhysicalKey)
+            {
+                Child++;
+            }
+
+            if (g_ReverseMappingEntries[Root].PhysicalKey >= g_ReverseMappingEntries[Child].PhysicalKey)
+            {
+                break;
+            }
+
+            Temp                           = g_ReverseMappingEntries[Root];
+            g_ReverseMappingEntries[Root]  = g_ReverseMappingEntries[Child];
+            g_ReverseMappingEntries[Child] = Temp;
+        }
+    }
+
+    while (Count > 1)
+    {
+        Count--;
+
+        Temp                           = g_ReverseMappingEntries[0];
+        g_ReverseMappingEntries[0]     = g_ReverseMappingEntries[Count];
+        g_ReverseMappingEntries[Count] = Temp;
+
+        for (Root = 0; (Child = (Root * 2) + 1) < Count; Root = Child)
+        {
+            if (Child + 1 < Count && g_ReverseMappingEntries[Child].PhysicalKey < g_ReverseMappingEntries[Child + 1].PhysicalKey)
+            {
+                Child++;
+            }
+
+            if (g_ReverseMappingEntries[Root].PhysicalKey >= g_ReverseMappingEntries[Child].PhysicalKey)
+            {
+                break;
+            }
+
+            Temp                           = g_ReverseMappingEntries[Root];
+            g_ReverseMappingEntries[Root]  = g_ReverseMappingEntries[Child];
+            g_ReverseMappingEntries[Child] = Temp;
+        }
+    }
+}
+
+/**
+ * @brief Build the index by walking the page-tables of all of the processes
+ * @details should be called in PASSIVE_LEVEL, the kernel part of the address
+ * space is shared, so it's only walked for the system process
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+ReverseMappingBuild()
+{
+    REVERSE_MAPPING_BUILD_STATE State   = {0};
+    UINT64 *                    Tables  = NULL;
+    PEPROCESS                   Process = NULL;
+    CR3_TYPE                    Cr3     = {0};
+
+    //
+    // Remove the previous index
+    //
+    ReverseMappingUninitialize();
+
+    Tables                    = ExAllocatePoolWithTag(NonPagedPool, PAGE_SIZE * 4, POOLTAG);
+    g_ReverseMappingEntries   = ExAllocatePoolWithTag(NonPagedPool, ReverseMappingInitialEntries * sizeof(REVERSE_MAPPING_ENTRY), POOLTAG);
+    g_ReverseMappingProcesses = ExAllocatePoolWithTag(NonPagedPool, ReverseMappingMaximumProcesses * sizeof(REVERSE_MAPPING_PROCESS), POOLTAG);
+
+    if (Tables == NULL || g_ReverseMappingEntries == NULL || g_ReverseMappingProcesses == NULL)
+    {
+        if (Tables != NULL)
+        {
+            ExFreePoolWithTag(Tables, POOLTAG);
+        }
+
+        ReverseMappingUninitialize();
+        return FALSE;
+    }
+
+    g_ReverseMappingCapacity = ReverseMappingInitialEntries;
+
+    for (UINT32 i = 0; i < 4; i++)
+    {
+        State.Tables[i] = (UINT64 *)((UINT64)Tables + (i * PAGE_SIZE));
+    }
+
+    for (UINT64 ProcessId = 4;
+         ProcessId < ReverseMappingMaximumProcessId && g_ReverseMappingCountOfProcesses < ReverseMappingMaximumProcesses && !State.IsTruncated;
+         ProcessId += 4)
+    {
+        if (PsLookupProcessByProcessId((HANDLE)ProcessId, &Process) != STATUS_SUCCESS)
+        {
+            continue;
+        }
+
+        //
+        // Due to KVA Shadowing, the kernel directory table base contains
+        // both of the user and the kernel mappings
+        //
+        Cr3.Flags = ((NT_KPROCESS *)Process)->DirectoryTableBase;
+
+        State.ProcessIndex = g_ReverseMappingCountOfProcesses;
+
+        g_ReverseMappingProcesses[g_ReverseMappingCountOfProcesses].ProcessId = (UINT32)ProcessId;
+        g_ReverseMappingProcesses[g_ReverseMappingCountOfProcesses].Cr3       = Cr3;
+        g_ReverseMappingCountOfProcesses++;
+
+        ReverseMappingWalkProcess(&State, Cr3, 0, ProcessId == 4 ? 511 : 255);
+
+        ObDereferenceObject(Process);
+    }
+
+    ExFreePoolWithTag(Tables, POOLTAG);
+
+    if (State.IsTruncated)
+    {
+        LogWarning("Warning, the index of the reverse mappings is truncated to 0x%x mappings", g_ReverseMappingCount);
+    }
+
+    ReverseMappingSortEntries();
+
+    g_ReverseMappingBuildTime = KeQueryInterruptTime();
+
+    return TRUE;
+}
+
+/**
+ * @brief Translate a virtual address based on a cr3 by reading the page-tables
+ *
+ * @param Cr3 The kernel cr3 of the process
+ * @param VirtualAddress The virtual address
+ *
+ * @return UINT64 Returns NULL if the address is not mapped
+ */
+static UINT64
+ReverseMappingTranslate(CR3_TYPE Cr3, UINT64 VirtualAddress)
+{
+    PAGE_ENTRY Entry;
+    UINT64     Pfn = Cr3.Fields.PageFrameNumber;
+
+    if (!ReverseMappingReadTableEntry(Pfn, (VirtualAddress >> 39) & 0x1ff, &Entry) ||
+        !ReverseMappingReadTableEntry(Entry.Fields.PageFrameNumber, (VirtualAddress >> 30) & 0x1ff, &Entry))
+    {
+        return NULL;
+    }
+
+    if (Entry.Fields.LargePage)
+    {
+        return ((Entry.Fields.PageFrameNumber << 12) & ~(SIZE_1_GB - 1)) + (VirtualAddress & (SIZE_1_GB - 1));
+    }
+
+    if (!ReverseMappingReadTableEntry(Entry.Fields.PageFrameNumber, (VirtualAddress >> 21) & 0x1ff, &Entry))
+    {
+        return NULL;
+    }
+
+    if (Entry.Fields.LargePage)
+    {
+        return ((Entry.Fields.PageFrameNumber << 12) & ~(SIZE_2_MB - 1)) + (VirtualAddress & (SIZE_2_MB - 1));
+    }
+
+    if (!ReverseMappingReadTableEntry(Entry.Fields.PageFrameNumber, (VirtualAddress >> 12) & 0x1ff, &Entry))
+    {
+        return NULL;
+    }
+
+    return (Entry.Fields.PageFrameNumber << 12) + (VirtualAddress & (PAGE_SIZE - 1));
+}
+
+/**
+ * @brief Free the index
+ *
+ * @return VOID
+ */
+VOID
+ReverseMappingUninitialize()
+{
+    if (g_ReverseMappingEntries != NULL)
+    {
+        ExFreePoolWithTag(g_ReverseMappingEntries, POOLTAG);
+        g_ReverseMappingEntries = NULL;
+    }
+
+    if (g_ReverseMappingProcesses != NULL)
+    {
+        ExFreePoolWithTag(g_ReverseMappingProcesses, POOLTAG);
+        g_ReverseMappingProcesses = NULL;
+    }
+
+    g_ReverseMappingCount            = 0;
+    g_ReverseMappingCapacity         = 0;
+    g_ReverseMappingCountOfProcesses = 0;
+}
+
+/**
+ * @brief Find the virtual addresses of all of the processes that map
+ * a physical address
+ * @details should be called in PASSIVE_LEVEL, the index is built if it's
+ * not built before or if it's expired
+ *
+ * @param PhysicalAddress The physical address
+ * @param Rebuild Whether the index should be rebuilt or not
+ * @param Mappings The mappings are saved here
+ * @param MaximumMappings Maximum count of mappings that can be saved
+ * @param CountOfMappings Count of saved mappings
+ * @param CountOfIndexedMappings Count of mappings of the whole index
+ *
+ * @return BOOLEAN Returns FALSE if the index couldn't be built
+ */
+BOOLEAN
+ReverseMappingQuery(UINT64                   PhysicalAddress,
+                    BOOLEAN                  Rebuild,
+                    PREVERSE_MAPPING_DETAILS Mappings,
+                    UINT32                   MaximumMappings,
+                    UINT32 *                 CountOfMappings,
+                    UINT32 *                 CountOfIndexedMappings)
+{
+    PREVERSE_MAPPING_PROCESS Process;
+    UINT64                   Key;
+    UINT64                   PageSize;
+    UINT64                   VirtualAddress;
+    UINT32                   Low;
+    UINT32                   High;
+    UINT32                   Middle;
+
+    *CountOfMappings        = 0;
+    *CountOfIndexedMappings = 0;
+
+    SpinlockLock(&ReverseMappingLock);
+
+    if (Rebuild || g_ReverseMappingEntries == NULL ||
+        KeQueryInterruptTime() - g_ReverseMappingBuildTime > ReverseMappingExpirationTime)
+    {
+        if (!ReverseMappingBuild())
+        {
+            SpinlockUnlock(&ReverseMappingLock);
+            return FALSE;
+        }
+    }
+
+    for (UINT32 SizeCode = ReverseMappingPageSize4Kb; SizeCode <= ReverseMappingPageSize1Gb; SizeCode++)
+    {
+        PageSize = ReverseMappingGetPageSize(SizeCode);
+        Key      = (PhysicalAddress & ~(PageSize - 1)) | SizeCode;
+
+        //
+        // Find the first mapping of the page
+        //
+        Low  = 0;
+        High = g_ReverseMappingCount;
+
+        while (Low < High)
+        {
+            Middle = Low + ((High - Low) / 2);
+
+            if (g_ReverseMappingEntries[Middle].PhysicalKey < Key)
+            {
+                Low = Middle + 1;
+            }
+            else
+            {
+                High = Middle;
+            }
+        }
+
+        for (; Low < g_ReverseMappingCount && g_ReverseMappingEntries[Low].PhysicalKey == Key && *CountOfMappings < MaximumMappings; Low++)
+        {
+            Process        = &g_ReverseMappingProcesses[g_ReverseMappingEntries[Low].VirtualPageAndProcessId >> 48];
+            VirtualAddress = ReverseMappingCanonicalAddress(g_ReverseMappingEntries[Low].VirtualPageAndProcessId & 0x0000fffffffff000ULL) +
+                             (PhysicalAddress & (PageSize - 1));
+
+            //
+            // Check whether the mapping is not removed after building the index
+            //
+            if (ReverseMappingTranslate(Process->Cr3, VirtualAddress) != PhysicalAddress)
+            {
+                continue;
+            }
+
+            Mappings[*CountOfMappings].ProcessId      = Process->ProcessId;
+            Mappings[*CountOfMappings].VirtualAddress = VirtualAddress;
+            (*CountOfMappings)++;
+        }
+    }
+
+    *CountOfIndexedMappings = g_ReverseMappingCount;
+
+    SpinlockUnlock(&ReverseMappingLock);
+
+    return TRUE;
+}
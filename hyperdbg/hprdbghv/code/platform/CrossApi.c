@@ -30,6 +30,78 @@ CrsAllocateContiguousZeroedMemory(_In_ SIZE_T NumberOfBytes)
     return Result;
 }
 
+/**
+ * @brief Get the NUMA node of a logical processor
+ *
+ * @param CoreId The index of the logical processor
+ * @return ULONG The node number or MM_ANY_NODE_OK if it's not found
+ */
+ULONG
+CrsGetNodeOfCore(_In_ UINT32 CoreId)
+{
+    PROCESSOR_NUMBER ProcessorNumber = {0};
+    GROUP_AFFINITY   NodeAffinity    = {0};
+    USHORT           HighestNode     = KeQueryHighestNodeNumber();
+
+    if (!NT_SUCCESS(KeGetProcessorNumberFromIndex(CoreId, &ProcessorNumber)))
+    {
+        return MM_ANY_NODE_OK;
+    }
+
+    for (USHORT Node = 0; Node <= HighestNode; Node++)
+    {
+        KeQueryNodeActiveAffinity(Node, &NodeAffinity, NULL);
+
+        if (NodeAffinity.Group == ProcessorNumber.Group && (NodeAffinity.Mask & ((KAFFINITY)1 << ProcessorNumber.Number)))
+        {
+            return Node;
+        }
+    }
+
+    return MM_ANY_NODE_OK;
+}
+
+/**
+ * @brief Allocate a contiguous zeroed memory from the NUMA node of a
+ * logical processor
+ * @details the memory is allocated from the other nodes if the node of
+ * the processor doesn't have enough memory, it should be freed using
+ * MmFreeContiguousMemory
+ *
+ * @param NumberOfBytes
+ * @param CoreId The index of the logical processor that uses the memory
+ * @return PVOID
+ */
+PVOID
+CrsAllocateContiguousZeroedMemoryOnCore(_In_ SIZE_T NumberOfBytes, _In_ UINT32 CoreId)
+{
+    PVOID            Result          = NULL;
+    PHYSICAL_ADDRESS LowestAddr      = {.QuadPart = 0};
+    PHYSICAL_ADDRESS MaxPhysicalAddr = {.QuadPart = MAXULONG64};
+    PHYSICAL_ADDRESS BoundaryAddr    = {.QuadPart = 0};
+    ULONG            PreferredNode   = CrsGetNodeOfCore(CoreId);
+
+    if (PreferredNode != MM_ANY_NODE_OK)
+    {
+        Result = MmAllocateContiguousNodeMemory(NumberOfBytes,
+                                                LowestAddr,
+                                                MaxPhysicalAddr,
+                                                BoundaryAddr,
+                                                PAGE_READWRITE,
+                                                PreferredNode);
+    }
+
+    if (Result == NULL)
+    {
+        Result = MmAllocateContiguousMemory(NumberOfBytes, MaxPhysicalAddr);
+    }
+
+    if (Result != NULL)
+        RtlSecureZeroMemory(Result, NumberOfBytes);
+
+    return Result;
+}
+
 PVOID
 CrsAllocateNonPagedPool(SIZE_T NumberOfBytes)
 {
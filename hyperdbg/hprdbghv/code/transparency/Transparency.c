@@ -268,6 +268,121 @@ TransparentRandn(int Average, int Sigma)
     return (Average + (Sigma * XS1) / MY_RAND_MAX);
 }
 
+/**
+ * @brief Get the bucket of a process id in the set of process ids of
+ * the transparent-mode
+ *
+ * @param ProcessId
+ * @return PLIST_ENTRY
+ */
+static PLIST_ENTRY
+TransparentGetProcessIdBucket(UINT64 ProcessId)
+{
+    //
+    // Process ids are multiples of four
+    //
+    return &g_TransparentModeMeasurements->ProcessIdBuckets[(ProcessId >> 2) & (TRANSPARENCY_PROCESS_ID_BUCKETS - 1)];
+}
+
+/**
+ * @brief Check whether the name of a process matches one of the names
+ * of the list of the transparent-mode or not
+ *
+ * @param Process The process object (EPROCESS)
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TransparentIsProcessNameOnTheList(PEPROCESS Process)
+{
+    PLIST_ENTRY TempList           = 0;
+    PCHAR       CurrentProcessName = CommonGetProcessNameFromProcessControlBlock(Process);
+
+    if (CurrentProcessName == NULL)
+    {
+        return FALSE;
+    }
+
+    TempList = &g_TransparentModeMeasurements->ProcessList;
+    while (&g_TransparentModeMeasurements->ProcessList != TempList->Flink)
+    {
+        TempList                             = TempList->Flink;
+        PTRANSPARENCY_PROCESS ProcessDetails = (PTRANSPARENCY_PROCESS)CONTAINING_RECORD(TempList, TRANSPARENCY_PROCESS, OtherProcesses);
+
+        if (!ProcessDetails->TrueIfProcessIdAndFalseIfProcessName &&
+            CommonIsStringStartsWith(CurrentProcessName, ProcessDetails->ProcessName))
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Check whether the current process is on the list of processes
+ * of the transparent-mode or not
+ * @details the process ids are found in their set and the result of
+ * matching the names is cached for each process on each core, so the
+ * names are only compared once the process is seen for the first time
+ *
+ * @param VCpu The virtual processor's state
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TransparentIsCurrentProcessOnTheList(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    PLIST_ENTRY                       TempList         = 0;
+    PLIST_ENTRY                       Bucket           = 0;
+    HANDLE                            CurrentProcessId = PsGetCurrentProcessId();
+    PEPROCESS                         CurrentProcess;
+    PTRANSPARENCY_PROCESS_CACHE_ENTRY Entry;
+    UINT64                            Index;
+    LONG                              Generation;
+
+    Bucket   = TransparentGetProcessIdBucket((UINT64)CurrentProcessId);
+    TempList = Bucket;
+
+    while (Bucket != TempList->Flink)
+    {
+        TempList                             = TempList->Flink;
+        PTRANSPARENCY_PROCESS ProcessDetails = (PTRANSPARENCY_PROCESS)CONTAINING_RECORD(TempList, TRANSPARENCY_PROCESS, HashList);
+
+        if (ProcessDetails->ProcessId == (UINT32)(UINT64)CurrentProcessId)
+        {
+            return TRUE;
+        }
+    }
+
+    if (g_TransparentModeMeasurements->CountOfProcessNames == 0)
+    {
+        return FALSE;
+    }
+
+    //
+    // The cached results are not valid once a name is added to the list
+    //
+    Generation = g_TransparentModeProcessNamesGeneration;
+
+    if (VCpu->TransparencyState.ProcessCacheGeneration != Generation)
+    {
+        RtlZeroMemory(VCpu->TransparencyState.ProcessCache, sizeof(VCpu->TransparencyState.ProcessCache));
+        VCpu->TransparencyState.ProcessCacheGeneration = Generation;
+    }
+
+    CurrentProcess = PsGetCurrentProcess();
+    Index          = (((UINT64)CurrentProcess >> 4) ^ ((UINT64)CurrentProcess >> 12)) & (TRANSPARENCY_PROCESS_CACHE_ENTRIES - 1);
+    Entry          = &VCpu->TransparencyState.ProcessCache[Index];
+
+    if (Entry->Process != CurrentProcess || Entry->ProcessId != CurrentProcessId)
+    {
+        Entry->Process   = CurrentProcess;
+        Entry->ProcessId = CurrentProcessId;
+        Entry->IsHidden  = TransparentIsProcessNameOnTheList(CurrentProcess);
+    }
+
+    return Entry->IsHidden;
+}
+
 /**
  * @brief Add name or process id of the target process to the list
  * of processes that HyperDbg should apply transparent-mode on them
@@ -330,6 +445,11 @@ TransparentAddNameOrProcessIdToTheList(PDEBUGGER_HIDE_AND_TRANSPARENT_DEBUGGER_M
         //
         PidAndNameBuffer->ProcessId                            = Measurements->ProcId;
         PidAndNameBuffer->TrueIfProcessIdAndFalseIfProcessName = TRUE;
+
+        //
+        // Add it to the set of process ids
+        //
+        InsertHeadList(TransparentGetProcessIdBucket(Measurements->ProcId), &(PidAndNameBuffer->HashList));
     }
     else
     {
@@ -356,6 +476,18 @@ TransparentAddNameOrProcessIdToTheList(PDEBUGGER_HIDE_AND_TRANSPARENT_DEBUGGER_M
     // vm-exits for them
     //
     InsertHeadList(&g_TransparentModeMeasurements->ProcessList, &(PidAndNameBuffer->OtherProcesses));
+
+    if (!Measurements->TrueIfProcessIdAndFalseIfProcessName)
+    {
+        g_TransparentModeMeasurements->CountOfProcessNames++;
+
+        //
+        // The processes should be matched with the new name
+        //
+        InterlockedIncrement(&g_TransparentModeProcessNamesGeneration);
+    }
+
+    return TRUE;
 }
 
 /**
@@ -393,6 +525,11 @@ TransparentHideDebugger(PDEBUGGER_HIDE_AND_TRANSPARENT_DEBUGGER_MODE Measurement
         //
         InitializeListHead(&g_TransparentModeMeasurements->ProcessList);
 
+        for (UINT32 i = 0; i < TRANSPARENCY_PROCESS_ID_BUCKETS; i++)
+        {
+            InitializeListHead(&g_TransparentModeMeasurements->ProcessIdBuckets[i]);
+        }
+
         //
         // Fill the transparency details CPUID
         //
@@ -412,15 +549,31 @@ TransparentHideDebugger(PDEBUGGER_HIDE_AND_TRANSPARENT_DEBUGGER_MODE Measurement
         //
         TransparentAddNameOrProcessIdToTheList(Measurements);
 
-        //
-        // Enable RDTSC and RDTSCP exiting on all cores
-        //
-        BroadcastEnableRdtscExitingAllCores();
+        if (Measurements->UseTscOffsetting)
+        {
+            //
+            // Compensate the time of vmx-root by the TSC offset on all cores,
+            // so the guest reads the time stamp counter without vm-exits
+            //
+            g_TransparentModeTscOffsetting = TRUE;
+
+            VmcsPendingUpdatesSetTscOffsetting(DEBUGGER_BROADCASTING_ALL_CORES_MASK, TRUE);
+        }
+        else
+        {
+            //
+            // Enable RDTSC and RDTSCP exiting on all cores (each core applies
+            // it on its next vm-exit, so no IPI is needed)
+            //
+            VmcsPendingUpdatesSetRdtscExiting(DEBUGGER_BROADCASTING_ALL_CORES_MASK, TRUE);
+        }
 
         //
         // Finally, enable the transparent-mode
         //
         g_TransparentMode = TRUE;
+
+        VmexitFastPathUpdate();
     }
     else
     {
@@ -452,10 +605,26 @@ TransparentUnhideDebugger()
         //
         g_TransparentMode = FALSE;
 
-        //
-        // Disable RDTSC and RDTSCP emulation
-        //
-        BroadcastDisableRdtscExitingAllCores();
+        VmexitFastPathUpdate();
+
+        if (g_TransparentModeTscOffsetting)
+        {
+            //
+            // Stop compensating the time of vmx-root (the time stamp counter
+            // of the guest continues from the actual time stamp counter)
+            //
+            g_TransparentModeTscOffsetting = FALSE;
+
+            VmcsPendingUpdatesSetTscOffsetting(DEBUGGER_BROADCASTING_ALL_CORES_MASK, FALSE);
+        }
+        else
+        {
+            //
+            // Disable RDTSC and RDTSCP emulation (each core applies it on its
+            // next vm-exit, so no IPI is needed)
+            //
+            VmcsPendingUpdatesSetRdtscExiting(DEBUGGER_BROADCASTING_ALL_CORES_MASK, FALSE);
+        }
 
         //
         // Free list of allocated buffers
@@ -510,15 +679,12 @@ TransparentUnhideDebugger()
 BOOLEAN
 TransparentModeStart(VIRTUAL_MACHINE_STATE * VCpu, UINT32 ExitReason)
 {
-    int         Aux                = 0;
-    UINT64      GuestCsSel         = 0;
-    PLIST_ENTRY TempList           = 0;
-    PCHAR       CurrentProcessName = 0;
-    PCHAR       CurrentProcessId;
-    UINT64      CurrrentTime;
-    HANDLE      CurrentThreadId;
-    BOOLEAN     Result                      = TRUE;
-    BOOLEAN     IsProcessOnTransparencyList = FALSE;
+    int     Aux        = 0;
+    UINT64  GuestCsSel = 0;
+    UINT64  CurrrentTime;
+    HANDLE  CurrentThreadId;
+    BOOLEAN Result                      = TRUE;
+    BOOLEAN IsProcessOnTransparencyList = FALSE;
 
     //
     // Save the current time
@@ -530,49 +696,10 @@ TransparentModeStart(VIRTUAL_MACHINE_STATE * VCpu, UINT32 ExitReason)
     //
     VCpu->TransparencyState.PreviousTimeStampCounter = CurrrentTime;
 
-    //
-    // Find the current process id and name
-    //
-    CurrentProcessId   = PsGetCurrentProcessId();
-    CurrentProcessName = CommonGetProcessNameFromProcessControlBlock(PsGetCurrentProcess());
-
     //
     // Check for process id and process name, if not match then we don't emulate it
     //
-    TempList = &g_TransparentModeMeasurements->ProcessList;
-    while (&g_TransparentModeMeasurements->ProcessList != TempList->Flink)
-    {
-        TempList                             = TempList->Flink;
-        PTRANSPARENCY_PROCESS ProcessDetails = (PTRANSPARENCY_PROCESS)CONTAINING_RECORD(TempList, TRANSPARENCY_PROCESS, OtherProcesses);
-        if (ProcessDetails->TrueIfProcessIdAndFalseIfProcessName)
-        {
-            //
-            // This entry is process id
-            //
-            if (ProcessDetails->ProcessId == CurrentProcessId)
-            {
-                //
-                // Let the transparency handler to handle it
-                //
-                IsProcessOnTransparencyList = TRUE;
-                break;
-            }
-        }
-        else
-        {
-            //
-            // This entry is a process name
-            //
-            if (CurrentProcessName != NULL && CommonIsStringStartsWith(CurrentProcessName, ProcessDetails->ProcessName))
-            {
-                //
-                // Let the transparency handler to handle it
-                //
-                IsProcessOnTransparencyList = TRUE;
-                break;
-            }
-        }
-    }
+    IsProcessOnTransparencyList = TransparentIsCurrentProcessOnTheList(VCpu);
 
     //
     // Check whether we find this process on transparency list or not
@@ -676,3 +803,89 @@ TransparentModeStart(VIRTUAL_MACHINE_STATE * VCpu, UINT32 ExitReason)
 
     return Result;
 }
+
+/**
+ * @brief Start or stop compensating the time of vmx-root by the TSC offset
+ * on the current core
+ * @details Should be called from vmx-root, the writes to the TSC deadline
+ * are intercepted as the deadline is not affected by the TSC offset
+ *
+ * @param VCpu The virtual processor's state
+ * @param Set Start or stop the compensation
+ * @return VOID
+ */
+VOID
+TransparentSetTscOffsetting(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Set)
+{
+    if (VCpu->TransparencyState.TscOffsettingEnabled == Set)
+    {
+        return;
+    }
+
+    VCpu->TransparencyState.TscOffsettingEnabled = Set;
+    VCpu->TransparencyState.TscOffset            = 0;
+
+    //
+    // The rest of the current vm-exit is compensated too
+    //
+    VCpu->TransparencyState.VmexitTimeStampCounter = __rdtsc();
+
+    HvSetTscOffsetting(Set, 0);
+
+    if (Set)
+    {
+        MsrHandlePerformMsrBitmapWriteChange(VCpu, IA32_TSC_DEADLINE);
+    }
+    else
+    {
+        MsrHandlePerformMsrBitmapWriteUnset(VCpu, IA32_TSC_DEADLINE);
+    }
+}
+
+/**
+ * @brief Subtract the time that is spent in vmx-root in the current
+ * vm-exit from the TSC offset of the guest
+ * @details Should be called from vmx-root, right before the vm-entry
+ *
+ * @param VCpu The virtual processor's state
+ * @return VOID
+ */
+VOID
+TransparentCompensateTimeInVmxRoot(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    VCpu->TransparencyState.TscOffset -= (INT64)(__rdtsc() - VCpu->TransparencyState.VmexitTimeStampCounter);
+
+    VmxVmwrite(VMCS_CTRL_TSC_OFFSET, VCpu->TransparencyState.TscOffset);
+}
+
+/**
+ * @brief Handle the writes of the guest to the TSC deadline while the
+ * time of vmx-root is compensated by the TSC offset
+ * @details the deadline of the guest is based on its own time stamp
+ * counter, so it's converted to the actual time stamp counter
+ *
+ * @param VCpu The virtual processor's state
+ * @param TargetMsr The MSR that is written
+ * @param Value The value that is written
+ * @return BOOLEAN Whether the write is handled or not
+ */
+BOOLEAN
+TransparentHandleWrmsr(VIRTUAL_MACHINE_STATE * VCpu, UINT32 TargetMsr, UINT64 Value)
+{
+    if (!VCpu->TransparencyState.TscOffsettingEnabled || TargetMsr != IA32_TSC_DEADLINE)
+    {
+        return FALSE;
+    }
+
+    //
+    // Zero disarms the timer
+    //
+    if (Value != 0)
+    {
+        Value -= VCpu->TransparencyState.TscOffset;
+    }
+
+    __writemsr(IA32_TSC_DEADLINE, Value);
+
+    return TRUE;
+}
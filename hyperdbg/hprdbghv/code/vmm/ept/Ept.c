@@ -46,6 +46,8 @@ EptCheckFeatures()
         g_CompatibilityCheck.ExecuteOnlySupport = TRUE;
     }
 
+    g_CompatibilityCheck.Ept1GbPagesSupport = VpidRegister.Pdpte1GbPages;
+
     if (!MTRRDefType.MtrrEnable)
     {
         LogError("Err, MTRR dynamic ranges are not supported");
@@ -222,6 +224,15 @@ EptGetPml1OrPml2Entry(PVMM_EPT_PAGE_TABLE EptPageTable, SIZE_T PhysicalAddress,
         return NULL;
     }
 
+    //
+    // The entries of 1GB pages are not used by the processor, so the 1GB
+    // page is split to 2MB pages first
+    //
+    if (!EptSplitPml3LargePage(EptPageTable, PhysicalAddress))
+    {
+        return NULL;
+    }
+
     PML2 = &EptPageTable->PML2[DirectoryPointer][Directory];
 
     //
@@ -283,6 +294,15 @@ EptGetPml2Entry(PVMM_EPT_PAGE_TABLE EptPageTable, SIZE_T PhysicalAddress)
         return NULL;
     }
 
+    //
+    // The entries of 1GB pages are not used by the processor, so the 1GB
+    // page is split to 2MB pages first
+    //
+    if (!EptSplitPml3LargePage(EptPageTable, PhysicalAddress))
+    {
+        return NULL;
+    }
+
     PML2 = &EptPageTable->PML2[DirectoryPointer][Directory];
     return PML2;
 }
@@ -350,13 +370,19 @@ EptSplitLargePage(PVMM_EPT_PAGE_TABLE EptPageTable,
     //
     NewSplit->Entry = TargetEntry;
 
+    //
+    // Save the 2MB entry to restore it when the split is merged
+    //
+    NewSplit->OriginalEntry.AsUInt = TargetEntry->AsUInt;
+
     //
     // Make a template for RWX
     //
-    EntryTemplate.AsUInt        = 0;
-    EntryTemplate.ReadAccess    = 1;
-    EntryTemplate.WriteAccess   = 1;
-    EntryTemplate.ExecuteAccess = 1;
+    EntryTemplate.AsUInt          = 0;
+    EntryTemplate.ReadAccess      = 1;
+    EntryTemplate.WriteAccess     = 1;
+    EntryTemplate.ExecuteAccess   = 1;
+    EntryTemplate.UserModeExecute = 1;
 
     //
     // copy other bits from target entry
@@ -365,6 +391,16 @@ EptSplitLargePage(PVMM_EPT_PAGE_TABLE EptPageTable,
     EntryTemplate.IgnorePat  = TargetEntry->IgnorePat;
     EntryTemplate.SuppressVe = TargetEntry->SuppressVe;
 
+    //
+    // The pages of a large page that is protected by the snapshot are
+    // protected too (before the pointer is replaced)
+    //
+    if (TargetEntry->AsUInt & EPT_SNAPSHOT_EPT_ENTRY_PROTECTED_FLAG)
+    {
+        EntryTemplate.WriteAccess = 0;
+        EntryTemplate.AsUInt |= EPT_SNAPSHOT_EPT_ENTRY_PROTECTED_FLAG;
+    }
+
     //
     // Copy the template into all the PML1 entries
     //
@@ -388,6 +424,7 @@ EptSplitLargePage(PVMM_EPT_PAGE_TABLE EptPageTable,
     NewPointer.WriteAccess     = 1;
     NewPointer.ReadAccess      = 1;
     NewPointer.ExecuteAccess   = 1;
+    NewPointer.UserModeExecute = 1;
     NewPointer.PageFrameNumber = (SIZE_T)VirtualAddressToPhysicalAddress(&NewSplit->PML1[0]) / PAGE_SIZE;
 
     //
@@ -395,9 +432,164 @@ EptSplitLargePage(PVMM_EPT_PAGE_TABLE EptPageTable,
     //
     RtlCopyMemory(TargetEntry, &NewPointer, sizeof(NewPointer));
 
+    //
+    // Keep track of the split to merge it again once it's not needed
+    //
+    SpinlockLockNamed(&EptDynamicSplitsListLock, "hv: ept dynamic splits (split)");
+    InsertHeadList(&g_EptState->DynamicSplitsList, &NewSplit->DynamicSplitList);
+    SpinlockUnlock(&EptDynamicSplitsListLock);
+
     return TRUE;
 }
 
+/**
+ * @brief Check whether a split 2MB page can be merged into a large page again
+ * @details the split is mergeable if all of its PML1 entries are the same identity
+ * mapping that is created while splitting the page and none of its 4KB pages is hooked
+ *
+ * @param Split The split 2MB page
+ *
+ * @return BOOLEAN Returns true if the split can be merged
+ */
+static BOOLEAN
+EptIsSplitLargePageMergeable(PVMM_EPT_DYNAMIC_SPLIT Split)
+{
+    EPT_PML1_ENTRY EntryTemplate;
+    EPT_PML1_ENTRY CurrentEntry;
+    SIZE_T         EntryIndex;
+    SIZE_T         BasePageFrameNumber;
+
+    BasePageFrameNumber = (Split->OriginalEntry.PageFrameNumber * SIZE_2_MB) / PAGE_SIZE;
+
+    //
+    // Make the same template that is used for splitting the page
+    //
+    EntryTemplate.AsUInt          = 0;
+    EntryTemplate.ReadAccess      = 1;
+    EntryTemplate.WriteAccess     = 1;
+    EntryTemplate.ExecuteAccess   = 1;
+    EntryTemplate.UserModeExecute = 1;
+    EntryTemplate.MemoryType      = Split->OriginalEntry.MemoryType;
+    EntryTemplate.IgnorePat       = Split->OriginalEntry.IgnorePat;
+    EntryTemplate.SuppressVe      = Split->OriginalEntry.SuppressVe;
+
+    for (EntryIndex = 0; EntryIndex < VMM_EPT_PML1E_COUNT; EntryIndex++)
+    {
+        //
+        // The accessed and dirty flags are set by the processor, so they're ignored
+        //
+        CurrentEntry.AsUInt   = Split->PML1[EntryIndex].AsUInt;
+        CurrentEntry.Accessed = 0;
+        CurrentEntry.Dirty    = 0;
+
+        EntryTemplate.PageFrameNumber = BasePageFrameNumber + EntryIndex;
+
+        if (CurrentEntry.AsUInt != EntryTemplate.AsUInt)
+        {
+            return FALSE;
+        }
+
+        //
+        // Hooks might be restored to their original entry for a single
+        // instruction (MTF), so the entry is not enough to know that
+        // the page is not hooked
+        //
+        if (EptHookFindByPhysAddress((BasePageFrameNumber + EntryIndex) * PAGE_SIZE) != NULL)
+        {
+            return FALSE;
+        }
+
+        //
+        // Traced pages keep the address of their entry in the PML1 table
+        //
+        if (ModeBasedExecHookIsPageTraced((BasePageFrameNumber + EntryIndex) * PAGE_SIZE))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Merge the split 2MB pages that are not used by any hook
+ * @details the 2MB entries are restored and the split PML1 tables are returned
+ * to the pool manager, this function should be called from vmx non-root after
+ * removing the hooks
+ *
+ * @return UINT32 Count of the merged pages
+ */
+UINT32
+EptMergeSplitLargePages()
+{
+    LIST_ENTRY MergedSplitsList;
+    UINT32     CountOfMergedPages = 0;
+
+    //
+    // Should be called from vmx non-root (broadcasting is not possible in vmx-root)
+    //
+    if (VmxGetCurrentExecutionMode() == TRUE)
+    {
+        return 0;
+    }
+
+    //
+    // The copies of the snapshot keep the addresses of the PML1 entries
+    //
+    if (g_EptSnapshot.IsTaken)
+    {
+        return 0;
+    }
+
+    InitializeListHead(&MergedSplitsList);
+
+    SpinlockLockNamed(&EptDynamicSplitsListLock, "hv: ept dynamic splits (merge)");
+
+    LIST_FOR_EACH_LINK(g_EptState->DynamicSplitsList, VMM_EPT_DYNAMIC_SPLIT, DynamicSplitList, CurrentSplit)
+    {
+        if (!EptIsSplitLargePageMergeable(CurrentSplit))
+        {
+            continue;
+        }
+
+        //
+        // Replace the pointer to the PML1 table with the original 2MB entry
+        //
+        InterlockedExchange64((volatile LONG64 *)&CurrentSplit->Entry->AsUInt, CurrentSplit->OriginalEntry.AsUInt);
+
+        RemoveEntryList(&CurrentSplit->DynamicSplitList);
+        InsertHeadList(&MergedSplitsList, &CurrentSplit->DynamicSplitList);
+
+        CountOfMergedPages++;
+    }
+
+    SpinlockUnlock(&EptDynamicSplitsListLock);
+
+    if (CountOfMergedPages == 0)
+    {
+        return 0;
+    }
+
+    //
+    // The PML1 tables might be cached by other cores, so they're freed
+    // after all of the cores invalidate their EPT
+    //
+    if (VmxGetCurrentLaunchState())
+    {
+        BroadcastNotifyAllToInvalidateEptAllCores();
+    }
+
+    LIST_FOR_EACH_LINK(MergedSplitsList, VMM_EPT_DYNAMIC_SPLIT, DynamicSplitList, CurrentSplit)
+    {
+        if (!PoolManagerFreePool((UINT64)CurrentSplit))
+        {
+            LogError("Err, something goes wrong, the pool not found in the list of previously allocated pools by pool manager");
+        }
+    }
+
+    return CountOfMergedPages;
+}
+
 /**
  * @brief Set up PML2 Entries
  *
@@ -492,6 +684,168 @@ EptSetupPML2Entry(PEPT_PML2_ENTRY NewEntry, SIZE_T PageFrameNumber)
     NewEntry->MemoryType = TargetMemoryType;
 }
 
+/**
+ * @brief Get the memory type of a 1GB region if all of its 2MB pages
+ * have the same memory type
+ * @details the memory type is the same as the type that EptSetupPML2Entry
+ * sets for each of the 2MB pages, it's uniform if each MTRR range either
+ * covers the whole region or doesn't overlap it
+ *
+ * @param Pml3Index The index of the 1GB region
+ * @param MemoryType The memory type of the region
+ * @return BOOLEAN TRUE if the memory type of the region is uniform
+ */
+BOOLEAN
+EptGetPml3MemoryType(SIZE_T Pml3Index, UINT8 * MemoryType)
+{
+    SIZE_T                  StartAddress     = Pml3Index * SIZE_1_GB;
+    SIZE_T                  EndAddress       = StartAddress + SIZE_1_GB - 1;
+    UINT8                   TargetMemoryType = MEMORY_TYPE_WRITE_BACK;
+    MTRR_RANGE_DESCRIPTOR * CurrentMemoryRange;
+
+    //
+    // The first 2MB page is always mapped as UC
+    //
+    if (Pml3Index == 0)
+    {
+        return FALSE;
+    }
+
+    for (SIZE_T CurrentMtrrRange = 0; CurrentMtrrRange < g_EptState->NumberOfEnabledMemoryRanges; CurrentMtrrRange++)
+    {
+        CurrentMemoryRange = &g_EptState->MemoryRanges[CurrentMtrrRange];
+
+        if (StartAddress > CurrentMemoryRange->PhysicalEndAddress || EndAddress < CurrentMemoryRange->PhysicalBaseAddress)
+        {
+            continue;
+        }
+
+        //
+        // The range is an MTRR boundary within the region
+        //
+        if (StartAddress < CurrentMemoryRange->PhysicalBaseAddress || EndAddress > CurrentMemoryRange->PhysicalEndAddress)
+        {
+            return FALSE;
+        }
+
+        TargetMemoryType = CurrentMemoryRange->MemoryType;
+
+        //
+        // 11.11.4.1 MTRR Precedences
+        //
+        if (TargetMemoryType == MEMORY_TYPE_UNCACHEABLE)
+        {
+            break;
+        }
+    }
+
+    *MemoryType = TargetMemoryType;
+
+    return TRUE;
+}
+
+/**
+ * @brief Split 1GB (LargePage) into 2MB pages
+ * @details the PML2 table of each 1GB region is part of the page table,
+ * so nothing is allocated and it's possible to split in vmx-root, the 2MB
+ * pages inherit the access and the memory type of the 1GB page, the caller
+ * should invalidate EPT once it changes the 2MB entries, the splits are
+ * serialized, so the table is only filled by the first core
+ *
+ * @param EptPageTable The EPT Page Table
+ * @param PhysicalAddress Physical address of where we want to split
+ *
+ * @return BOOLEAN Returns FALSE if the address is invalid
+ */
+BOOLEAN
+EptSplitPml3LargePage(PVMM_EPT_PAGE_TABLE EptPageTable, SIZE_T PhysicalAddress)
+{
+    SIZE_T           Pml3Index = ADDRMASK_EPT_PML3_INDEX(PhysicalAddress);
+    PEPT_PML3_ENTRY  LargeEntry;
+    EPT_PML2_ENTRY   EntryTemplate;
+    EPT_PML3_POINTER NewPointer;
+    SIZE_T           EntryIndex;
+
+    //
+    // Addresses above 512GB are invalid because it is > physical address bus width
+    //
+    if (ADDRMASK_EPT_PML4_INDEX(PhysicalAddress) > 0)
+    {
+        return FALSE;
+    }
+
+    LargeEntry = (PEPT_PML3_ENTRY)&EptPageTable->PML3[Pml3Index];
+
+    //
+    // It's a pointer already
+    //
+    if (!LargeEntry->LargePage)
+    {
+        return TRUE;
+    }
+
+    SpinlockLockNamed(&EptSplitPml3LargePagesLock, "hv: ept 1gb splits (split)");
+
+    //
+    // Another core might have split the page (and changed its 2MB entries)
+    // while the lock was taken
+    //
+    if (!LargeEntry->LargePage)
+    {
+        SpinlockUnlock(&EptSplitPml3LargePagesLock);
+        return TRUE;
+    }
+
+    EntryTemplate.AsUInt          = 0;
+    EntryTemplate.ReadAccess      = LargeEntry->ReadAccess;
+    EntryTemplate.WriteAccess     = LargeEntry->WriteAccess;
+    EntryTemplate.ExecuteAccess   = LargeEntry->ExecuteAccess;
+    EntryTemplate.UserModeExecute = LargeEntry->UserModeExecute;
+    EntryTemplate.MemoryType      = LargeEntry->MemoryType;
+    EntryTemplate.LargePage       = 1;
+
+    for (EntryIndex = 0; EntryIndex < VMM_EPT_PML2E_COUNT; EntryIndex++)
+    {
+        EptPageTable->PML2[Pml3Index][EntryIndex].AsUInt          = EntryTemplate.AsUInt;
+        EptPageTable->PML2[Pml3Index][EntryIndex].PageFrameNumber = (Pml3Index * VMM_EPT_PML2E_COUNT) + EntryIndex;
+    }
+
+    NewPointer.AsUInt          = 0;
+    NewPointer.ReadAccess      = LargeEntry->ReadAccess;
+    NewPointer.WriteAccess     = LargeEntry->WriteAccess;
+    NewPointer.ExecuteAccess   = LargeEntry->ExecuteAccess;
+    NewPointer.UserModeExecute = LargeEntry->UserModeExecute;
+    NewPointer.PageFrameNumber = (SIZE_T)VirtualAddressToPhysicalAddress(&EptPageTable->PML2[Pml3Index][0]) / PAGE_SIZE;
+
+    //
+    // The 2MB entries are set before the processor uses them, the translation
+    // of the addresses is not changed, so other cores can keep using the 1GB page
+    //
+    InterlockedExchange64((volatile LONG64 *)&EptPageTable->PML3[Pml3Index].AsUInt, NewPointer.AsUInt);
+
+    SpinlockUnlock(&EptSplitPml3LargePagesLock);
+
+    return TRUE;
+}
+
+/**
+ * @brief Split all of the 1GB pages of a page table into 2MB pages
+ * @details should be called before the features that walk all of the 2MB
+ * entries of the page table
+ *
+ * @param EptPageTable The EPT Page Table
+ *
+ * @return VOID
+ */
+VOID
+EptSplitAllPml3LargePages(PVMM_EPT_PAGE_TABLE EptPageTable)
+{
+    for (SIZE_T EntryIndex = 0; EntryIndex < VMM_EPT_PML3E_COUNT; EntryIndex++)
+    {
+        EptSplitPml3LargePage(EptPageTable, EntryIndex * SIZE_1_GB);
+    }
+}
+
 /**
  * @brief Allocates page maps and create identity page table
  *
@@ -503,8 +857,11 @@ EptAllocateAndCreateIdentityPageTable()
     PVMM_EPT_PAGE_TABLE PageTable;
     EPT_PML3_POINTER    RWXTemplate;
     EPT_PML2_ENTRY      PML2EntryTemplate;
+    PEPT_PML3_ENTRY     LargeEntry;
     SIZE_T              EntryGroupIndex;
     SIZE_T              EntryIndex;
+    UINT8               MemoryType;
+    UINT32              CountOfLargeEntries = 0;
 
     //
     // Allocate all paging structures as 4KB aligned pages
@@ -531,6 +888,13 @@ EptAllocateAndCreateIdentityPageTable()
     PageTable->PML4[0].ReadAccess      = 1;
     PageTable->PML4[0].WriteAccess     = 1;
     PageTable->PML4[0].ExecuteAccess   = 1;
+    PageTable->PML4[0].UserModeExecute = 1;
+
+    //
+    // The user-mode execute bits are ignored unless mode-based execution
+    // control (MBEC) is enabled, so they're set on all of the entries to let
+    // MBEC be enabled on this table without making any page non-executable
+    //
 
     //
     // Now mark each 1GB PML3 entry as RWX and map each to their PML2 entry
@@ -545,9 +909,10 @@ EptAllocateAndCreateIdentityPageTable()
     // Set up one 'template' RWX PML3 entry and copy it into each of the 512 PML3 entries
     // Using the same method as SimpleVisor for copying each entry using intrinsics.
     //
-    RWXTemplate.ReadAccess    = 1;
-    RWXTemplate.WriteAccess   = 1;
-    RWXTemplate.ExecuteAccess = 1;
+    RWXTemplate.ReadAccess      = 1;
+    RWXTemplate.WriteAccess     = 1;
+    RWXTemplate.ExecuteAccess   = 1;
+    RWXTemplate.UserModeExecute = 1;
 
     //
     // Copy the template into each of the 512 PML3 entry slots
@@ -571,9 +936,10 @@ EptAllocateAndCreateIdentityPageTable()
     //
     // All PML2 entries will be RWX and 'present'
     //
-    PML2EntryTemplate.WriteAccess   = 1;
-    PML2EntryTemplate.ReadAccess    = 1;
-    PML2EntryTemplate.ExecuteAccess = 1;
+    PML2EntryTemplate.WriteAccess     = 1;
+    PML2EntryTemplate.ReadAccess      = 1;
+    PML2EntryTemplate.ExecuteAccess   = 1;
+    PML2EntryTemplate.UserModeExecute = 1;
 
     //
     // We are using 2MB large pages, so we must mark this 1 here
@@ -594,6 +960,22 @@ EptAllocateAndCreateIdentityPageTable()
     //
     for (EntryGroupIndex = 0; EntryGroupIndex < VMM_EPT_PML3E_COUNT; EntryGroupIndex++)
     {
+        //
+        // The 1GB regions with a single memory type are mapped by 1GB pages, their 2MB
+        // entries are only set up once they're split (e.g., by hooks)
+        //
+        if (g_CompatibilityCheck.Ept1GbPagesSupport && EptGetPml3MemoryType(EntryGroupIndex, &MemoryType))
+        {
+            LargeEntry                  = (PEPT_PML3_ENTRY)&PageTable->PML3[EntryGroupIndex];
+            LargeEntry->AsUInt          = RWXTemplate.AsUInt;
+            LargeEntry->LargePage       = 1;
+            LargeEntry->MemoryType      = MemoryType;
+            LargeEntry->PageFrameNumber = EntryGroupIndex;
+
+            CountOfLargeEntries++;
+            continue;
+        }
+
         //
         // For each 2MB PML2 entry in the collection
         //
@@ -606,6 +988,55 @@ EptAllocateAndCreateIdentityPageTable()
         }
     }
 
+    LogDebugInfo("EPT identity map: 0x%x region(s) are mapped by 1GB pages", CountOfLargeEntries);
+
+    return PageTable;
+}
+
+/**
+ * @brief Allocates page maps and copy an identity page table
+ * @details the memory types of the entries are copied from the template
+ * instead of computing them from the MTRRs again, the template should not
+ * have any split (or hooked) entry
+ *
+ * @param TemplatePageTable The identity page table to copy
+ * @return PVMM_EPT_PAGE_TABLE identity map page-table
+ */
+PVMM_EPT_PAGE_TABLE
+EptCloneIdentityPageTable(PVMM_EPT_PAGE_TABLE TemplatePageTable)
+{
+    PVMM_EPT_PAGE_TABLE PageTable;
+    SIZE_T              EntryIndex;
+
+    PageTable = CrsAllocateContiguousZeroedMemory(sizeof(VMM_EPT_PAGE_TABLE));
+
+    if (PageTable == NULL)
+    {
+        LogError("Err, failed to allocate memory for PageTable");
+        return NULL;
+    }
+
+    RtlCopyMemory(PageTable, TemplatePageTable, sizeof(VMM_EPT_PAGE_TABLE));
+
+    //
+    // The PML2 entries are identical, only the PML4 and PML3 entries should
+    // point to the structures of the new page table
+    //
+    PageTable->PML4[0].PageFrameNumber = (SIZE_T)VirtualAddressToPhysicalAddress(&PageTable->PML3[0]) / PAGE_SIZE;
+
+    for (EntryIndex = 0; EntryIndex < VMM_EPT_PML3E_COUNT; EntryIndex++)
+    {
+        //
+        // The 1GB pages map the memory, not the PML2 tables
+        //
+        if (((PEPT_PML3_ENTRY)&PageTable->PML3[EntryIndex])->LargePage)
+        {
+            continue;
+        }
+
+        PageTable->PML3[EntryIndex].PageFrameNumber = (SIZE_T)VirtualAddressToPhysicalAddress(&PageTable->PML2[EntryIndex][0]) / PAGE_SIZE;
+    }
+
     return PageTable;
 }
 
@@ -662,6 +1093,30 @@ EptLogicalProcessorInitialize()
     //
     g_EptState->EptPointer = EPTP;
 
+    //
+    // Allocate the unhooked view, it's an identity mapped page table that never
+    // changes, thus, hook exits can switch to this view for one instruction instead
+    // of modifying the hooked entry of the shared page table and invalidating the TLB
+    // (it's not mandatory, if it's not available then the entries are modified)
+    // it's copied from the identity page table as there is no hook yet
+    //
+    PageTable = EptCloneIdentityPageTable(g_EptState->EptPageTable);
+
+    if (PageTable != NULL)
+    {
+        g_EptState->UnhookedEptPageTable = PageTable;
+
+        //
+        // Same attributes as the normal EPTP, just for the unhooked page table
+        //
+        EPTP.PageFrameNumber           = (SIZE_T)VirtualAddressToPhysicalAddress(&PageTable->PML4) / PAGE_SIZE;
+        g_EptState->UnhookedEptPointer = EPTP;
+    }
+    else
+    {
+        LogWarning("Warning, unable to allocate memory for the unhooked EPT view");
+    }
+
     return TRUE;
 }
 
@@ -683,84 +1138,86 @@ EptHandlePageHookExit(VIRTUAL_MACHINE_STATE *              VCpu,
                       VMX_EXIT_QUALIFICATION_EPT_VIOLATION ViolationQualification,
                       UINT64                               GuestPhysicalAddr)
 {
-    BOOLEAN ResultOfHandlingHook;
-    BOOLEAN IsHandled                    = FALSE;
-    BOOLEAN IgnoreReadOrWriteOrExec      = FALSE;
-    BOOLEAN IsTriggeringPostEventAllowed = FALSE;
-    BOOLEAN IsExecViolation              = FALSE;
-    UINT64  CurrentRip;
-    UINT32  CurrentInstructionLength;
+    BOOLEAN                 ResultOfHandlingHook;
+    BOOLEAN                 IsHandled                    = FALSE;
+    BOOLEAN                 IgnoreReadOrWriteOrExec      = FALSE;
+    BOOLEAN                 IsTriggeringPostEventAllowed = FALSE;
+    BOOLEAN                 IsExecViolation              = FALSE;
+    UINT64                  CurrentRip;
+    UINT32                  CurrentInstructionLength;
+    PEPT_HOOKED_PAGE_DETAIL HookedEntry;
+
+    //
+    // Find the hooked page (lock-free lookup, including monitored 2MB pages)
+    //
+    HookedEntry = EptHookFindByPhysAddressIncludingLargePages(PAGE_ALIGN(GuestPhysicalAddr));
 
-    LIST_FOR_EACH_LINK(g_EptState->HookedPagesList, EPT_HOOKED_PAGE_DETAIL, PageHookList, HookedEntry)
+    if (HookedEntry != NULL)
     {
-        if (HookedEntry->PhysicalBaseAddress == PAGE_ALIGN(GuestPhysicalAddr))
-        {
-            //
-            // *** We found an address that matches the details ***
-            //
+        //
+        // *** We found an address that matches the details ***
+        //
 
+        //
+        // Returning true means that the caller should return to the ept state to
+        // the previous state when this instruction is executed
+        // by setting the Monitor Trap Flag. Return false means that nothing special
+        // for the caller to do
+        //
+        ResultOfHandlingHook = EptHookHandleHookedPage(VCpu,
+                                                       HookedEntry,
+                                                       ViolationQualification,
+                                                       GuestPhysicalAddr,
+                                                       &HookedEntry->LastContextState,
+                                                       &IgnoreReadOrWriteOrExec,
+                                                       &IsExecViolation,
+                                                       &IsTriggeringPostEventAllowed);
+
+        if (ResultOfHandlingHook)
+        {
             //
-            // Returning true means that the caller should return to the ept state to
-            // the previous state when this instruction is executed
-            // by setting the Monitor Trap Flag. Return false means that nothing special
-            // for the caller to do
+            // Here we check whether the event should be ignored or not,
+            // if we don't apply the below restorations routines, the event
+            // won't redo and the emulation of the memory access is passed
             //
-            ResultOfHandlingHook = EptHookHandleHookedPage(VCpu,
-                                                           HookedEntry,
-                                                           ViolationQualification,
-                                                           GuestPhysicalAddr,
-                                                           &HookedEntry->LastContextState,
-                                                           &IgnoreReadOrWriteOrExec,
-                                                           &IsExecViolation,
-                                                           &IsTriggeringPostEventAllowed);
-
-            if (ResultOfHandlingHook)
+            if (!IgnoreReadOrWriteOrExec)
             {
                 //
-                // Here we check whether the event should be ignored or not,
-                // if we don't apply the below restorations routines, the event
-                // won't redo and the emulation of the memory access is passed
+                // Execute one instruction without the hook, either by switching to a view
+                // without the hook (only this core) or by restoring to its original entry
                 //
-                if (!IgnoreReadOrWriteOrExec)
+                if (!EptSwitchToUnhookedView(VCpu, HookedEntry))
                 {
-                    //
-                    // Restore to its original entry for one instruction
-                    //
                     EptSetPML1AndInvalidateTLB(HookedEntry->EntryAddress, HookedEntry->OriginalEntry, InveptSingleContext);
+                }
 
-                    //
-                    // Set whether the caller should consider triggering the post-event or not
-                    //
-                    HookedEntry->IsPostEventTriggerAllowed = IsTriggeringPostEventAllowed;
+                //
+                // Set whether the caller should consider triggering the post-event or not
+                //
+                HookedEntry->IsPostEventTriggerAllowed = IsTriggeringPostEventAllowed;
 
-                    //
-                    // Next we have to save the current hooked entry to restore on the next instruction's vm-exit
-                    //
-                    VCpu->MtfEptHookRestorePoint = HookedEntry;
+                //
+                // Next we have to save the current hooked entry to restore on the next instruction's vm-exit
+                //
+                VCpu->MtfEptHookRestorePoint = HookedEntry;
 
-                    //
-                    // The following codes are added because we realized if the execution takes long then
-                    // the execution might be switched to another routines, thus, MTF might conclude on
-                    // another routine and we might (and will) trigger the same instruction soon
-                    //
+                //
+                // The following codes are added because we realized if the execution takes long then
+                // the execution might be switched to another routines, thus, MTF might conclude on
+                // another routine and we might (and will) trigger the same instruction soon
+                //
 
-                    //
-                    // We have to set Monitor trap flag and give it the HookedEntry to work with
-                    //
-                    HvEnableMtfAndChangeExternalInterruptState(VCpu);
-                }
+                //
+                // We have to set Monitor trap flag and give it the HookedEntry to work with
+                //
+                HvEnableMtfAndChangeExternalInterruptState(VCpu);
             }
-
-            //
-            // Indicate that we handled the ept violation
-            //
-            IsHandled = TRUE;
-
-            //
-            // Get out of the loop
-            //
-            break;
         }
+
+        //
+        // Indicate that we handled the ept violation
+        //
+        IsHandled = TRUE;
     }
 
     //
@@ -805,6 +1262,43 @@ EptHandlePageHookExit(VIRTUAL_MACHINE_STATE *              VCpu,
     return IsHandled;
 }
 
+/**
+ * @brief Handle the EPT violations that are caused by the stale EPT caches
+ * @details once a hook is removed by another core in vmx-root, this core
+ * might still use the cached permissions of the page until its pending
+ * invalidation is applied, in this case the current entry allows the access
+ *
+ * @param VCpu The virtual processor's state
+ * @param ViolationQualification The exit qualification of the violation
+ * @param GuestPhysicalAddr The guest physical address of the violation
+ *
+ * @return BOOLEAN Return true if the violation is caused by a stale cache
+ */
+static BOOLEAN
+EptHandleStaleEptViolation(VIRTUAL_MACHINE_STATE *                VCpu,
+                           VMX_EXIT_QUALIFICATION_EPT_VIOLATION * ViolationQualification,
+                           UINT64                                 GuestPhysicalAddr)
+{
+    PEPT_PML1_ENTRY Pml1Entry = EptGetPml1Entry(g_EptState->EptPageTable, GuestPhysicalAddr);
+
+    if (Pml1Entry == NULL ||
+        (ViolationQualification->ReadAccess && !Pml1Entry->ReadAccess) ||
+        (ViolationQualification->WriteAccess && !Pml1Entry->WriteAccess) ||
+        (ViolationQualification->ExecuteAccess && (!Pml1Entry->ExecuteAccess || !Pml1Entry->UserModeExecute)))
+    {
+        return FALSE;
+    }
+
+    EptInveptSingleContext(g_EptState->EptPointer.AsUInt);
+
+    //
+    // Redo the instruction
+    //
+    HvSuppressRipIncrement(VCpu);
+
+    return TRUE;
+}
+
 /**
  * @brief Handle VM exits for EPT violations
  * @details Violations are thrown whenever an operation is performed on an EPT entry
@@ -824,7 +1318,7 @@ EptHandleEptViolation(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // Reading guest physical address
     //
-    __vmx_vmread(VMCS_GUEST_PHYSICAL_ADDRESS, &GuestPhysicalAddr);
+    VmxVmread(VMCS_GUEST_PHYSICAL_ADDRESS, &GuestPhysicalAddr);
 
     if (ReversingMachineHandleEptViolationVmexit(VCpu, &ViolationQualification, GuestPhysicalAddr))
     {
@@ -837,6 +1331,20 @@ EptHandleEptViolation(VIRTUAL_MACHINE_STATE * VCpu)
         //
         return TRUE;
     }
+    else if (ModeBasedExecHookHandleEptViolation(VCpu, &ViolationQualification, GuestPhysicalAddr))
+    {
+        //
+        // Handled by the mode-based execution tracer (first execution of a traced page)
+        //
+        return TRUE;
+    }
+    else if (EptSnapshotHandleEptViolation(VCpu, &ViolationQualification, GuestPhysicalAddr))
+    {
+        //
+        // Handled by the snapshot (first write to a page after taking the snapshot)
+        //
+        return TRUE;
+    }
     else if (VmmCallbackUnhandledEptViolation(VCpu->CoreId, (UINT64)ViolationQualification.AsUInt, GuestPhysicalAddr))
     {
         //
@@ -844,6 +1352,13 @@ EptHandleEptViolation(VIRTUAL_MACHINE_STATE * VCpu)
         //
         return TRUE;
     }
+    else if (EptHandleStaleEptViolation(VCpu, &ViolationQualification, GuestPhysicalAddr))
+    {
+        //
+        // The page is unhooked from vmx-root by another core
+        //
+        return TRUE;
+    }
 
     LogError("Err, unexpected EPT violation at RIP: %llx", VCpu->LastVmexitRip);
     DbgBreakPoint();
@@ -865,7 +1380,14 @@ EptHandleMonitorTrapFlag(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // restore the hooked state
     //
-    EptSetPML1AndInvalidateTLB(VCpu->MtfEptHookRestorePoint->EntryAddress, VCpu->MtfEptHookRestorePoint->ChangedEntry, InveptSingleContext);
+    if (VCpu->IsOnUnhookedEptView)
+    {
+        EptRestoreFromUnhookedView(VCpu);
+    }
+    else
+    {
+        EptSetPML1AndInvalidateTLB(VCpu->MtfEptHookRestorePoint->EntryAddress, VCpu->MtfEptHookRestorePoint->ChangedEntry, InveptSingleContext);
+    }
 
     //
     // Check to trigger the post event (for events relating the !monitor command
@@ -916,7 +1438,7 @@ EptHandleMisconfiguration()
 {
     UINT64 GuestPhysicalAddr = 0;
 
-    __vmx_vmread(VMCS_GUEST_PHYSICAL_ADDRESS, &GuestPhysicalAddr);
+    VmxVmread(VMCS_GUEST_PHYSICAL_ADDRESS, &GuestPhysicalAddr);
 
     LogInfo("EPT Misconfiguration!");
 
@@ -974,6 +1496,207 @@ EptSetPML1AndInvalidateTLB(PEPT_PML1_ENTRY EntryAddress, EPT_PML1_ENTRY EntryVal
     SpinlockUnlock(&Pml1ModificationAndInvalidationLock);
 }
 
+/**
+ * @brief Allocate the EPT view of a core
+ * @details the view shares all of the PML2 tables with the EPT page table
+ * till a hooked page is restored on it, it should be called after the EPT
+ * page table is created
+ *
+ * @param VCpu The virtual processor's state
+ * @return BOOLEAN Returns false if the view is not allocated
+ */
+BOOLEAN
+EptAllocateCoreView(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    PVMM_EPT_CORE_VIEW CoreView;
+    EPT_POINTER        EptPointer;
+
+    CoreView = CrsAllocateContiguousZeroedMemoryOnCore(sizeof(VMM_EPT_CORE_VIEW), VCpu->CoreId);
+
+    if (CoreView == NULL)
+    {
+        return FALSE;
+    }
+
+    RtlCopyMemory(CoreView->PML3, g_EptState->EptPageTable->PML3, sizeof(CoreView->PML3));
+
+    CoreView->PML4[0]                 = g_EptState->EptPageTable->PML4[0];
+    CoreView->PML4[0].PageFrameNumber = (SIZE_T)VirtualAddressToPhysicalAddress(&CoreView->PML3[0]) / PAGE_SIZE;
+    CoreView->Pml2PageFrameNumber     = (SIZE_T)VirtualAddressToPhysicalAddress(&CoreView->PML2[0]) / PAGE_SIZE;
+    CoreView->Pml1PageFrameNumber     = (SIZE_T)VirtualAddressToPhysicalAddress(&CoreView->PML1[0]) / PAGE_SIZE;
+    CoreView->RestoredPml3Index       = 0;
+
+    //
+    // Same attributes as the normal EPTP, just for the view of this core
+    //
+    EptPointer                 = g_EptState->EptPointer;
+    EptPointer.PageFrameNumber = (SIZE_T)VirtualAddressToPhysicalAddress(&CoreView->PML4[0]) / PAGE_SIZE;
+
+    VCpu->EptCoreView        = CoreView;
+    VCpu->EptCoreViewPointer = EptPointer.AsUInt;
+
+    return TRUE;
+}
+
+#if UsePerCoreEptViewsForHookRestoration == TRUE
+
+/**
+ * @brief Switch the current core to its own EPT view in which only the
+ * hooked page is restored
+ * @details This function should be called from vmx root-mode, the PML2
+ * and the PML1 tables of the page are copied from the EPT page table, so
+ * the other hooks are still applied and the other cores are not affected
+ *
+ * @param VCpu The virtual processor's state
+ * @param HookedEntry The hooked page
+ * @return BOOLEAN Returns false if the view of the core is not available
+ */
+static BOOLEAN
+EptSwitchToCoreView(VIRTUAL_MACHINE_STATE * VCpu, PEPT_HOOKED_PAGE_DETAIL HookedEntry)
+{
+    PVMM_EPT_CORE_VIEW  CoreView     = (PVMM_EPT_CORE_VIEW)VCpu->EptCoreView;
+    PVMM_EPT_PAGE_TABLE EptPageTable = g_EptState->EptPageTable;
+    SIZE_T              Pml3Index    = ADDRMASK_EPT_PML3_INDEX(HookedEntry->PhysicalBaseAddress);
+    SIZE_T              Pml2Index    = ADDRMASK_EPT_PML2_INDEX(HookedEntry->PhysicalBaseAddress);
+    SIZE_T              Pml1Index    = ADDRMASK_EPT_PML1_INDEX(HookedEntry->PhysicalBaseAddress);
+    UINT64              CurrentEptPointer;
+
+    if (CoreView == NULL || ADDRMASK_EPT_PML4_INDEX(HookedEntry->PhysicalBaseAddress) != 0)
+    {
+        return FALSE;
+    }
+
+    //
+    // The view is based on the EPT page table, other page tables (e.g., the
+    // reversing machine) use the unhooked view
+    //
+    VmxVmread(VMCS_CTRL_EPT_POINTER, &CurrentEptPointer);
+
+    if (CurrentEptPointer != g_EptState->EptPointer.AsUInt)
+    {
+        return FALSE;
+    }
+
+    //
+    // The PML3 entry of the previously restored page points to the shared PML2 table again
+    //
+    CoreView->PML3[CoreView->RestoredPml3Index] = EptPageTable->PML3[CoreView->RestoredPml3Index];
+
+    RtlCopyMemory(CoreView->PML2, EptPageTable->PML2[Pml3Index], sizeof(CoreView->PML2));
+
+    if (HookedEntry->IsLargePage)
+    {
+        //
+        // The 2MB page is hooked as a whole, the entry is in the PML2 table
+        //
+        CoreView->PML2[Pml2Index].AsUInt = HookedEntry->OriginalEntry.AsUInt;
+    }
+    else
+    {
+        if (CoreView->PML2[Pml2Index].LargePage)
+        {
+            //
+            // The page is not split anymore (the hook is removed)
+            //
+            return FALSE;
+        }
+
+        //
+        // The entry of the 4KB page is in the split PML1 table, the PML1 table is
+        // copied and the copied PML2 entry points to the copy
+        //
+        RtlCopyMemory(CoreView->PML1, HookedEntry->EntryAddress - Pml1Index, sizeof(CoreView->PML1));
+
+        CoreView->PML1[Pml1Index] = HookedEntry->OriginalEntry;
+
+        ((PEPT_PML2_POINTER)&CoreView->PML2[Pml2Index])->PageFrameNumber = CoreView->Pml1PageFrameNumber;
+    }
+
+    CoreView->PML3[Pml3Index].PageFrameNumber = CoreView->Pml2PageFrameNumber;
+    CoreView->RestoredPml3Index               = Pml3Index;
+
+    VCpu->EptPointerBeforeUnhookedView = CurrentEptPointer;
+
+    VmxVmwrite(VMCS_CTRL_EPT_POINTER, VCpu->EptCoreViewPointer);
+
+    //
+    // The same EPTP is used for restoring all of the pages, so the cached
+    // translations of the previous page are invalidated (only on this core)
+    //
+    EptInveptSingleContext(VCpu->EptCoreViewPointer);
+
+    VCpu->IsOnUnhookedEptView = TRUE;
+
+    return TRUE;
+}
+
+#endif
+
+/**
+ * @brief Switch the current core to an EPT view without the hook
+ * @details This function should be called from vmx root-mode, the EPTP
+ * is tagged in the TLB, so there is no need to invalidate it
+ *
+ * @param VCpu The virtual processor's state
+ * @param HookedEntry The hooked page
+ * @return BOOLEAN Returns false if the unhooked view is not available
+ */
+BOOLEAN
+EptSwitchToUnhookedView(VIRTUAL_MACHINE_STATE * VCpu, PEPT_HOOKED_PAGE_DETAIL HookedEntry)
+{
+    if (VCpu->IsOnUnhookedEptView)
+    {
+        return FALSE;
+    }
+
+#if UsePerCoreEptViewsForHookRestoration == TRUE
+
+    //
+    // Only the hooked page is restored on the view of the core
+    //
+    if (EptSwitchToCoreView(VCpu, HookedEntry))
+    {
+        return TRUE;
+    }
+
+#else
+
+    UNREFERENCED_PARAMETER(HookedEntry);
+
+#endif
+
+    if (g_EptState->UnhookedEptPageTable == NULL)
+    {
+        return FALSE;
+    }
+
+    //
+    // Save the current EPTP (it might not be the normal EPTP, e.g., the reversing machine)
+    //
+    VmxVmread(VMCS_CTRL_EPT_POINTER, &VCpu->EptPointerBeforeUnhookedView);
+
+    VmxVmwrite(VMCS_CTRL_EPT_POINTER, g_EptState->UnhookedEptPointer.AsUInt);
+
+    VCpu->IsOnUnhookedEptView = TRUE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Switch the current core back from the unhooked EPT view
+ * @details This function should be called from vmx root-mode
+ *
+ * @param VCpu The virtual processor's state
+ * @return VOID
+ */
+VOID
+EptRestoreFromUnhookedView(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    VmxVmwrite(VMCS_CTRL_EPT_POINTER, VCpu->EptPointerBeforeUnhookedView);
+
+    VCpu->IsOnUnhookedEptView = FALSE;
+}
+
 /**
  * @brief Perform checking and handling if the breakpoint vm-exit relates to EPT hook or not
  *
@@ -985,8 +1708,8 @@ EptSetPML1AndInvalidateTLB(PEPT_PML1_ENTRY EntryAddress, EPT_PML1_ENTRY EntryVal
 BOOLEAN
 EptCheckAndHandleEptHookBreakpoints(VIRTUAL_MACHINE_STATE * VCpu, UINT64 GuestRip)
 {
-    PLIST_ENTRY TempList           = 0;
-    BOOLEAN     IsHandledByEptHook = FALSE;
+    PEPT_HOOKED_PAGE_DETAIL HookedEntry;
+    BOOLEAN                 IsHandledByEptHook = FALSE;
 
     //
     // ***** Check breakpoint for !epthook *****
@@ -995,72 +1718,75 @@ EptCheckAndHandleEptHookBreakpoints(VIRTUAL_MACHINE_STATE * VCpu, UINT64 GuestRi
     //
     // Check whether the breakpoint was due to a !epthook command or not
     //
-    TempList = &g_EptState->HookedPagesList;
-
-    while (&g_EptState->HookedPagesList != TempList->Flink)
+    if (IsListEmpty(&g_EptState->HookedPagesList))
     {
-        TempList                            = TempList->Flink;
-        PEPT_HOOKED_PAGE_DETAIL HookedEntry = CONTAINING_RECORD(TempList, EPT_HOOKED_PAGE_DETAIL, PageHookList);
+        return FALSE;
+    }
 
-        if (HookedEntry->IsExecutionHook)
-        {
-            for (size_t i = 0; i < HookedEntry->CountOfBreakpoints; i++)
-            {
-                if (HookedEntry->BreakpointAddresses[i] == GuestRip)
-                {
-                    //
-                    // We found an address that matches the details, let's trigger the event
-                    //
+    //
+    // Hidden breakpoints are on the hooked page of the physical address of the rip
+    //
+    HookedEntry = EptHookFindByPhysAddress(PAGE_ALIGN(VirtualAddressToPhysicalAddressOnTargetProcess(GuestRip)));
 
-                    //
-                    // As the context to event trigger, we send the rip
-                    // of where triggered this event
-                    //
-                    DispatchEventHiddenHookExecCc(VCpu, GuestRip);
+    //
+    // The breakpoints of the page are sorted by their offsets, so it's a binary search
+    //
+    if (HookedEntry != NULL && HookedEntry->IsExecutionHook && EptHookIsHiddenBreakpointAddress(HookedEntry, GuestRip))
+    {
+        //
+        // We found an address that matches the details, let's trigger the event
+        //
 
-                    //
-                    // Restore to its original entry for one instruction
-                    //
-                    EptSetPML1AndInvalidateTLB(HookedEntry->EntryAddress, HookedEntry->OriginalEntry, InveptSingleContext);
+        //
+        // As the context to event trigger, we send the rip
+        // of where triggered this event, the entries of the IDT
+        // that are hooked by !interrupt2 trigger the interrupt
+        // events instead
+        //
+        if (!InterruptHookCheckAndHandleIdtEntryBreakpoint(VCpu, GuestRip))
+        {
+            DispatchEventHiddenHookExecCc(VCpu, GuestRip);
+        }
 
-                    //
-                    // Next we have to save the current hooked entry to restore on the next instruction's vm-exit
-                    //
-                    VCpu->MtfEptHookRestorePoint = HookedEntry;
+        //
+        // Execute one instruction without the hook, either by switching to a view
+        // without the hook (only this core) or by restoring to its original entry
+        //
+        if (!EptSwitchToUnhookedView(VCpu, HookedEntry))
+        {
+            EptSetPML1AndInvalidateTLB(HookedEntry->EntryAddress, HookedEntry->OriginalEntry, InveptSingleContext);
+        }
 
-                    //
-                    // The following codes are added because we realized if the execution takes long then
-                    // the execution might be switched to another routines, thus, MTF might conclude on
-                    // another routine and we might (and will) trigger the same instruction soon
-                    //
-                    // The following code is not necessary on local debugging (VMI Mode), however, I don't
-                    // know why? just things are not reasonable here for me
-                    // another weird thing that I observed is the fact if you don't touch the routine related
-                    // to the I/O in and out instructions in VMWare then it works perfectly, just touching I/O
-                    // for serial is problematic, it might be a VMWare nested-virtualization bug, however, the
-                    // below approached proved to be work on both Debug Mode and WMI Mode
-                    // If you remove the below codes then when epthook is triggered then the execution stucks
-                    // on the same instruction on where the hooks is triggered, so 'p' and 't' commands for
-                    // steppings won't work
-                    //
+        //
+        // Next we have to save the current hooked entry to restore on the next instruction's vm-exit
+        //
+        VCpu->MtfEptHookRestorePoint = HookedEntry;
 
-                    //
-                    // We have to set Monitor trap flag and give it the HookedEntry to work with
-                    //
-                    HvEnableMtfAndChangeExternalInterruptState(VCpu);
+        //
+        // The following codes are added because we realized if the execution takes long then
+        // the execution might be switched to another routines, thus, MTF might conclude on
+        // another routine and we might (and will) trigger the same instruction soon
+        //
+        // The following code is not necessary on local debugging (VMI Mode), however, I don't
+        // know why? just things are not reasonable here for me
+        // another weird thing that I observed is the fact if you don't touch the routine related
+        // to the I/O in and out instructions in VMWare then it works perfectly, just touching I/O
+        // for serial is problematic, it might be a VMWare nested-virtualization bug, however, the
+        // below approached proved to be work on both Debug Mode and WMI Mode
+        // If you remove the below codes then when epthook is triggered then the execution stucks
+        // on the same instruction on where the hooks is triggered, so 'p' and 't' commands for
+        // steppings won't work
+        //
 
-                    //
-                    // Indicate that we handled the ept violation
-                    //
-                    IsHandledByEptHook = TRUE;
+        //
+        // We have to set Monitor trap flag and give it the HookedEntry to work with
+        //
+        HvEnableMtfAndChangeExternalInterruptState(VCpu);
 
-                    //
-                    // Get out of the loop
-                    //
-                    break;
-                }
-            }
-        }
+        //
+        // Indicate that we handled the ept violation
+        //
+        IsHandledByEptHook = TRUE;
     }
 
     return IsHandledByEptHook;
@@ -1082,13 +1808,21 @@ EptCheckAndHandleBreakpoint(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // Reading guest's RIP
     //
-    __vmx_vmread(VMCS_GUEST_RIP, &GuestRip);
+    VmxVmread(VMCS_GUEST_RIP, &GuestRip);
 
     //
     // Don't increment rip by default
     //
     HvSuppressRipIncrement(VCpu);
 
+    //
+    // Check if it's the hook of the entry of system calls (!syscall3)
+    //
+    if (SyscallHookCheckAndHandleLstarEntryBreakpoint(VCpu, GuestRip))
+    {
+        return TRUE;
+    }
+
     //
     // Check if it relates to !epthook or not
     //
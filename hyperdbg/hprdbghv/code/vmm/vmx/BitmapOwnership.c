@@ -0,0 +1,445 @@
+/**
+ * @file BitmapOwnership.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The ownership (reference counts) of the bitmaps and the exiting
+ * controls that are shared between events
+ * @details each event adds a reference to the I/O ports, the exception
+ * vectors and the exiting controls that it needs and releases them once
+ * it's terminated, so the VMCS controls are changed incrementally and
+ * only the resources that are still referenced cause vm-exits
+ * @version 0.4
+ * @date 2023-07-30
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Allocate the ownership of the resources of a core
+ *
+ * @param VCpu The virtual processor's state
+ * @return BOOLEAN Returns true if allocation was successful otherwise returns false
+ */
+BOOLEAN
+BitmapOwnershipAllocate(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    VCpu->BitmapOwnership = ExAllocatePoolWithTag(NonPagedPool, sizeof(BITMAP_OWNERSHIP), POOLTAG);
+
+    if (VCpu->BitmapOwnership == NULL)
+    {
+        LogError("Err, insufficient memory in allocationg the ownership of bitmaps");
+        return FALSE;
+    }
+
+    RtlZeroMemory(VCpu->BitmapOwnership, sizeof(BITMAP_OWNERSHIP));
+
+    return TRUE;
+}
+
+/**
+ * @brief Free the ownership of the resources of a core
+ *
+ * @param VCpu The virtual processor's state
+ * @return VOID
+ */
+VOID
+BitmapOwnershipFree(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    if (VCpu->BitmapOwnership != NULL)
+    {
+        ExFreePoolWithTag(VCpu->BitmapOwnership, POOLTAG);
+        VCpu->BitmapOwnership = NULL;
+    }
+}
+
+/**
+ * @brief Get the reference counts of the bits of the guest/host mask
+ * of a control register
+ *
+ * @param Ownership The ownership of the core
+ * @param ControlRegister The control register (CR0 or CR4)
+ *
+ * @return UINT32 * Returns NULL if the control register is not supported
+ */
+static UINT32 *
+BitmapOwnershipGetControlRegisterReferenceCounts(PBITMAP_OWNERSHIP Ownership, UINT64 ControlRegister)
+{
+    if (ControlRegister == VMX_EXIT_QUALIFICATION_REGISTER_CR0)
+    {
+        return Ownership->Cr0MaskReferenceCounts;
+    }
+    else if (ControlRegister == VMX_EXIT_QUALIFICATION_REGISTER_CR4)
+    {
+        return Ownership->Cr4MaskReferenceCounts;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Rebuild the I/O Bitmaps from the reference counts of the ports
+ * @details should be called in vmx-root mode
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+static VOID
+BitmapOwnershipRebuildIoBitmaps(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    PBITMAP_OWNERSHIP Ownership = VCpu->BitmapOwnership;
+
+    memset(VCpu->IoBitmapVirtualAddressA, 0x0, PAGE_SIZE);
+    memset(VCpu->IoBitmapVirtualAddressB, 0x0, PAGE_SIZE);
+
+    for (UINT32 Port = 0; Port < BITMAP_OWNERSHIP_IO_PORTS_COUNT; Port++)
+    {
+        if (Ownership->IoPortReferenceCounts[Port] != 0)
+        {
+            IoHandleSetIoBitmap(VCpu, Port);
+        }
+    }
+}
+
+/**
+ * @brief Add a reference to a resource and apply it to the VMCS controls
+ * @details should be called in vmx-root mode
+ *
+ * @param VCpu The virtual processor's state
+ * @param ResourceType Type of the resource
+ * @param Index The port, the vector or the control register of the resource
+ * @param Mask The guest/host mask (only for control registers)
+ *
+ * @return VOID
+ */
+VOID
+BitmapOwnershipAcquire(VIRTUAL_MACHINE_STATE * VCpu, BITMAP_OWNERSHIP_RESOURCE_TYPE ResourceType, UINT64 Index, UINT64 Mask)
+{
+    PBITMAP_OWNERSHIP Ownership = VCpu->BitmapOwnership;
+    UINT32 *          ReferenceCounts;
+
+    switch (ResourceType)
+    {
+    case BITMAP_OWNERSHIP_RESOURCE_IO_PORT:
+
+        if (Index == DEBUGGER_EVENT_ALL_IO_PORTS)
+        {
+            Ownership->IoAllPortsReferenceCount++;
+
+            memset(VCpu->IoBitmapVirtualAddressA, 0xFF, PAGE_SIZE);
+            memset(VCpu->IoBitmapVirtualAddressB, 0xFF, PAGE_SIZE);
+        }
+        else if (Index < BITMAP_OWNERSHIP_IO_PORTS_COUNT)
+        {
+            Ownership->IoPortReferenceCounts[Index]++;
+
+            IoHandleSetIoBitmap(VCpu, Index);
+        }
+
+        break;
+
+    case BITMAP_OWNERSHIP_RESOURCE_EXCEPTION:
+
+        if (Index == DEBUGGER_EVENT_EXCEPTIONS_ALL_FIRST_32_ENTRIES)
+        {
+            Ownership->ExceptionAllVectorsReferenceCount++;
+        }
+        else if (Index < BITMAP_OWNERSHIP_EXCEPTIONS_COUNT)
+        {
+            Ownership->ExceptionReferenceCounts[Index]++;
+        }
+        else
+        {
+            break;
+        }
+
+        ProtectedHvSetExceptionBitmap(VCpu, (UINT32)Index);
+
+        break;
+
+    case BITMAP_OWNERSHIP_RESOURCE_MOV_TO_DEBUG_REGS:
+
+        Ownership->MovToDebugRegsReferenceCount++;
+
+        ProtectedHvSetMovDebugRegsExiting(VCpu, TRUE);
+
+        break;
+
+    case BITMAP_OWNERSHIP_RESOURCE_MOV_TO_CONTROL_REGS:
+
+        ReferenceCounts = BitmapOwnershipGetControlRegisterReferenceCounts(Ownership, Index);
+
+        if (ReferenceCounts == NULL)
+        {
+            break;
+        }
+
+        for (UINT32 i = 0; i < BITMAP_OWNERSHIP_CONTROL_REGISTER_BITS_COUNT; i++)
+        {
+            if (Mask & (1ull << i))
+            {
+                ReferenceCounts[i]++;
+            }
+        }
+
+        //
+        // The mask contains the bits of all of the events
+        //
+        ProtectedHvSetMov2CrExiting(TRUE, Index, BitmapOwnershipQueryControlRegisterMask(VCpu, Index));
+
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Release a reference of a resource and remove the VMCS controls
+ * that are not referenced anymore
+ * @details should be called in vmx-root mode
+ *
+ * @param VCpu The virtual processor's state
+ * @param ResourceType Type of the resource
+ * @param Index The port, the vector or the control register of the resource
+ * @param Mask The guest/host mask (only for control registers)
+ *
+ * @return VOID
+ */
+VOID
+BitmapOwnershipRelease(VIRTUAL_MACHINE_STATE * VCpu, BITMAP_OWNERSHIP_RESOURCE_TYPE ResourceType, UINT64 Index, UINT64 Mask)
+{
+    PBITMAP_OWNERSHIP Ownership = VCpu->BitmapOwnership;
+    UINT32 *          ReferenceCounts;
+    UINT64            OwnedMask;
+
+    switch (ResourceType)
+    {
+    case BITMAP_OWNERSHIP_RESOURCE_IO_PORT:
+
+        if (Index == DEBUGGER_EVENT_ALL_IO_PORTS)
+        {
+            if (Ownership->IoAllPortsReferenceCount == 0)
+            {
+                break;
+            }
+
+            //
+            // Once all ports are not referenced, only the ports that are
+            // still referenced should cause vm-exits
+            //
+            if (--Ownership->IoAllPortsReferenceCount == 0)
+            {
+                BitmapOwnershipRebuildIoBitmaps(VCpu);
+            }
+        }
+        else if (Index < BITMAP_OWNERSHIP_IO_PORTS_COUNT && Ownership->IoPortReferenceCounts[Index] != 0)
+        {
+            if (--Ownership->IoPortReferenceCounts[Index] == 0 && Ownership->IoAllPortsReferenceCount == 0)
+            {
+                IoHandleUnsetIoBitmap(VCpu, Index);
+            }
+        }
+
+        break;
+
+    case BITMAP_OWNERSHIP_RESOURCE_EXCEPTION:
+
+        //
+        // The integrity check of the exception bitmap adds the vectors that
+        // are still referenced, so they are not removed here
+        //
+        if (Index == DEBUGGER_EVENT_EXCEPTIONS_ALL_FIRST_32_ENTRIES)
+        {
+            if (Ownership->ExceptionAllVectorsReferenceCount != 0 &&
+                --Ownership->ExceptionAllVectorsReferenceCount == 0)
+            {
+                ProtectedHvUnsetExceptionBitmap(VCpu, (UINT32)Index);
+            }
+        }
+        else if (Index < BITMAP_OWNERSHIP_EXCEPTIONS_COUNT && Ownership->ExceptionReferenceCounts[Index] != 0)
+        {
+            if (--Ownership->ExceptionReferenceCounts[Index] == 0)
+            {
+                ProtectedHvUnsetExceptionBitmap(VCpu, (UINT32)Index);
+            }
+        }
+
+        break;
+
+    case BITMAP_OWNERSHIP_RESOURCE_MOV_TO_DEBUG_REGS:
+
+        if (Ownership->MovToDebugRegsReferenceCount != 0 &&
+            --Ownership->MovToDebugRegsReferenceCount == 0)
+        {
+            ProtectedHvSetMovDebugRegsExiting(VCpu, FALSE);
+        }
+
+        break;
+
+    case BITMAP_OWNERSHIP_RESOURCE_MOV_TO_CONTROL_REGS:
+
+        ReferenceCounts = BitmapOwnershipGetControlRegisterReferenceCounts(Ownership, Index);
+
+        if (ReferenceCounts == NULL)
+        {
+            break;
+        }
+
+        for (UINT32 i = 0; i < BITMAP_OWNERSHIP_CONTROL_REGISTER_BITS_COUNT; i++)
+        {
+            if ((Mask & (1ull << i)) && ReferenceCounts[i] != 0)
+            {
+                ReferenceCounts[i]--;
+            }
+        }
+
+        OwnedMask = BitmapOwnershipQueryControlRegisterMask(VCpu, Index);
+
+        if (OwnedMask != 0)
+        {
+            //
+            // Only the bits of the remaining events cause vm-exits
+            //
+            ProtectedHvSetMov2CrExiting(TRUE, Index, OwnedMask);
+        }
+        else
+        {
+            ProtectedHvSetMovControlRegsExiting(VCpu, FALSE, Index, 0);
+        }
+
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Remove all of the references of a type of resources
+ * @details used when all of the events of the resource are cleared, the
+ * caller is responsible for removing the VMCS controls
+ *
+ * @param VCpu The virtual processor's state
+ * @param ResourceType Type of the resource
+ * @param Index The control register (only for control registers)
+ *
+ * @return VOID
+ */
+VOID
+BitmapOwnershipReset(VIRTUAL_MACHINE_STATE * VCpu, BITMAP_OWNERSHIP_RESOURCE_TYPE ResourceType, UINT64 Index)
+{
+    PBITMAP_OWNERSHIP Ownership = VCpu->BitmapOwnership;
+    UINT32 *          ReferenceCounts;
+
+    switch (ResourceType)
+    {
+    case BITMAP_OWNERSHIP_RESOURCE_IO_PORT:
+
+        Ownership->IoAllPortsReferenceCount = 0;
+        RtlZeroMemory(Ownership->IoPortReferenceCounts, sizeof(Ownership->IoPortReferenceCounts));
+
+        break;
+
+    case BITMAP_OWNERSHIP_RESOURCE_EXCEPTION:
+
+        Ownership->ExceptionAllVectorsReferenceCount = 0;
+        RtlZeroMemory(Ownership->ExceptionReferenceCounts, sizeof(Ownership->ExceptionReferenceCounts));
+
+        break;
+
+    case BITMAP_OWNERSHIP_RESOURCE_MOV_TO_DEBUG_REGS:
+
+        Ownership->MovToDebugRegsReferenceCount = 0;
+
+        break;
+
+    case BITMAP_OWNERSHIP_RESOURCE_MOV_TO_CONTROL_REGS:
+
+        ReferenceCounts = BitmapOwnershipGetControlRegisterReferenceCounts(Ownership, Index);
+
+        if (ReferenceCounts != NULL)
+        {
+            RtlZeroMemory(ReferenceCounts, BITMAP_OWNERSHIP_CONTROL_REGISTER_BITS_COUNT * sizeof(UINT32));
+        }
+
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Get the mask of the exception vectors that are referenced
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return UINT32
+ */
+UINT32
+BitmapOwnershipQueryExceptionBitmapMask(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    PBITMAP_OWNERSHIP Ownership = VCpu->BitmapOwnership;
+    UINT32            Mask      = 0;
+
+    if (Ownership->ExceptionAllVectorsReferenceCount != 0)
+    {
+        return 0xffffffff;
+    }
+
+    for (UINT32 i = 0; i < BITMAP_OWNERSHIP_EXCEPTIONS_COUNT; i++)
+    {
+        if (Ownership->ExceptionReferenceCounts[i] != 0)
+        {
+            Mask |= 1 << i;
+        }
+    }
+
+    return Mask;
+}
+
+/**
+ * @brief Check whether mov to debug registers exiting is referenced
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+BitmapOwnershipIsMovToDebugRegsOwned(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    return VCpu->BitmapOwnership->MovToDebugRegsReferenceCount != 0;
+}
+
+/**
+ * @brief Get the guest/host mask of the bits of a control register
+ * that are referenced
+ *
+ * @param VCpu The virtual processor's state
+ * @param ControlRegister The control register (CR0 or CR4)
+ *
+ * @return UINT64
+ */
+UINT64
+BitmapOwnershipQueryControlRegisterMask(VIRTUAL_MACHINE_STATE * VCpu, UINT64 ControlRegister)
+{
+    UINT32 * ReferenceCounts = BitmapOwnershipGetControlRegisterReferenceCounts(VCpu->BitmapOwnership, ControlRegister);
+    UINT64   Mask            = 0;
+
+    if (ReferenceCounts == NULL)
+    {
+        return 0;
+    }
+
+    for (UINT32 i = 0; i < BITMAP_OWNERSHIP_CONTROL_REGISTER_BITS_COUNT; i++)
+    {
+        if (ReferenceCounts[i] != 0)
+        {
+            Mask |= 1ull << i;
+        }
+    }
+
+    return Mask;
+}
@@ -29,6 +29,12 @@ CounterEmulateRdtsc(VIRTUAL_MACHINE_STATE * VCpu)
     UINT64      Tsc       = __rdtsc();
     PGUEST_REGS GuestRegs = VCpu->Regs;
 
+    //
+    // The TSC offset is applied as the guest would read it without vm-exit
+    // (it's zero if the TSC offsetting of the transparent-mode is not used)
+    //
+    Tsc += VCpu->TransparencyState.TscOffset;
+
     GuestRegs->rax = 0x00000000ffffffff & Tsc;
     GuestRegs->rdx = 0x00000000ffffffff & (Tsc >> 32);
 }
@@ -46,6 +52,11 @@ CounterEmulateRdtscp(VIRTUAL_MACHINE_STATE * VCpu)
     UINT64      Tsc       = __rdtscp(&Aux);
     PGUEST_REGS GuestRegs = VCpu->Regs;
 
+    //
+    // The TSC offset is applied as the guest would read it without vm-exit
+    //
+    Tsc += VCpu->TransparencyState.TscOffset;
+
     GuestRegs->rax = 0x00000000ffffffff & Tsc;
     GuestRegs->rdx = 0x00000000ffffffff & (Tsc >> 32);
 
@@ -82,7 +93,7 @@ CounterSetPreemptionTimer(UINT32 TimerValue)
     //
     // Set the time value
     //
-    __vmx_vmwrite(VMCS_GUEST_VMX_PREEMPTION_TIMER_VALUE, TimerValue);
+    VmxVmwrite(VMCS_GUEST_VMX_PREEMPTION_TIMER_VALUE, TimerValue);
 }
 
 /**
@@ -96,5 +107,95 @@ CounterClearPreemptionTimer()
     //
     // Set the time value to NULL
     //
-    __vmx_vmwrite(VMCS_GUEST_VMX_PREEMPTION_TIMER_VALUE, NULL);
+    VmxVmwrite(VMCS_GUEST_VMX_PREEMPTION_TIMER_VALUE, NULL);
+}
+
+/**
+ * @brief Get the value of the VMX preemption timer that is requested by the
+ * sampling profiler, the PEBS sampling, the counter of the retired instructions
+ * (of the current core) and the pending updates of VMCS controls
+ *
+ * @return UINT32 The shortest requested period (zero if nothing is requested)
+ */
+UINT32
+CounterQueryRequestedPreemptionTimer()
+{
+    UINT32 TimerValue = g_VmcsPendingUpdatesKickTimerValue;
+    UINT32 WatchdogValue;
+
+    if (g_SamplingProfilerEnabled && (TimerValue == 0 || g_SamplingProfilerTimerValue < TimerValue))
+    {
+        TimerValue = g_SamplingProfilerTimerValue;
+    }
+
+    if (g_PebsSamplingEnabled && (TimerValue == 0 || g_PebsSamplingTimerValue < TimerValue))
+    {
+        TimerValue = g_PebsSamplingTimerValue;
+    }
+
+    if (g_GuestState[KeGetCurrentProcessorNumber()].InstructionCounter.IsArmed)
+    {
+        WatchdogValue = INSTRUCTION_COUNTER_WATCHDOG_INTERVAL >> g_CompatibilityCheck.PreemptionTimerRate;
+
+        if (TimerValue == 0 || WatchdogValue < TimerValue)
+        {
+            TimerValue = WatchdogValue;
+        }
+    }
+
+    return TimerValue;
+}
+
+/**
+ * @brief Set or unset the VMX preemption timer based on its requests
+ * @details should be called in vmx-root, the remaining time of the timer is
+ * saved on vm-exits (if supported), so the timer expires once in each period
+ * of the guest's execution, no matter how many other vm-exits happen
+ *
+ * @return VOID
+ */
+VOID
+CounterUpdatePreemptionTimer()
+{
+    UINT32 TimerValue     = CounterQueryRequestedPreemptionTimer();
+    ULONG  VmExitControls = 0;
+
+    VmxVmread(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, &VmExitControls);
+
+    if (TimerValue != 0)
+    {
+        CounterSetPreemptionTimer(TimerValue);
+        HvSetVmxPreemptionTimerExiting(TRUE);
+
+        if (g_CompatibilityCheck.PreemptionTimerSavingSupport)
+        {
+            VmExitControls |= VM_EXIT_SAVE_VMX_PREEMPTION_TIMER;
+        }
+    }
+    else
+    {
+        HvSetVmxPreemptionTimerExiting(FALSE);
+        CounterClearPreemptionTimer();
+
+        VmExitControls &= ~VM_EXIT_SAVE_VMX_PREEMPTION_TIMER;
+    }
+
+    VmxVmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, VmExitControls);
+}
+
+/**
+ * @brief Start the next period of the VMX preemption timer
+ * @details should be called in vmx-root once the timer is expired
+ *
+ * @return VOID
+ */
+VOID
+CounterReloadPreemptionTimer()
+{
+    UINT32 TimerValue = CounterQueryRequestedPreemptionTimer();
+
+    if (TimerValue != 0)
+    {
+        CounterSetPreemptionTimer(TimerValue);
+    }
 }
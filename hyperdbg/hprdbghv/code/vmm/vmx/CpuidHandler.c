@@ -0,0 +1,214 @@
+/**
+ * @file CpuidHandler.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The table of CPUID leaves
+ * @details each leaf of the basic (0H), hypervisor (40000000H) and extended
+ * (80000000H) ranges has an entry in the table that shows whether an event
+ * is interested in it, the result is modified by the hypervisor, and whether
+ * the result can be served from the per-core cache or not
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief The static leaves that are cached on each core (the slots of
+ * the per-core cache)
+ * @details the results of these leaves don't depend on the sub-leaf and
+ * the core, and they're not changed while the system is running
+ *
+ */
+static const UINT32 CpuidHandlerCacheableLeaves[CPUID_CACHE_ENTRIES] = {
+    0x00000000, // Maximum basic leaf and the vendor
+    0x80000000, // Maximum extended leaf
+    0x80000002, // Brand string
+    0x80000003, // Brand string
+    0x80000004, // Brand string
+};
+
+/**
+ * @brief Get the index of a leaf in the table of CPUID leaves
+ *
+ * @param Leaf
+ * @return INT32 The index or -1 if the leaf is not in the table
+ */
+static INT32
+CpuidHandlerGetLeafIndex(UINT32 Leaf)
+{
+    UINT32 Offset = Leaf & 0x0fffffff;
+
+    if (Offset >= CPUID_HANDLER_LEAVES_PER_RANGE)
+    {
+        return -1;
+    }
+
+    switch (Leaf & 0xf0000000)
+    {
+    case 0x00000000:
+        return Offset;
+    case 0x40000000:
+        return CPUID_HANDLER_LEAVES_PER_RANGE + Offset;
+    case 0x80000000:
+        return CPUID_HANDLER_LEAVES_PER_RANGE * 2 + Offset;
+    default:
+        return -1;
+    }
+}
+
+/**
+ * @brief Initialize the table of CPUID leaves
+ *
+ * @return VOID
+ */
+VOID
+CpuidHandlerInitialize()
+{
+    RtlZeroMemory(g_CpuidLeaves, sizeof(g_CpuidLeaves));
+
+    g_CpuidEventFilterIsActive = FALSE;
+
+    for (UCHAR i = 0; i < CPUID_CACHE_ENTRIES; i++)
+    {
+        g_CpuidLeaves[CpuidHandlerGetLeafIndex(CpuidHandlerCacheableLeaves[i])].Flags |= CPUID_LEAF_FLAG_CACHEABLE;
+        g_CpuidLeaves[CpuidHandlerGetLeafIndex(CpuidHandlerCacheableLeaves[i])].CacheSlot = i;
+    }
+
+    //
+    // The leaves that are modified by HvHandleCpuid
+    //
+    g_CpuidLeaves[CpuidHandlerGetLeafIndex(CPUID_PROCESSOR_AND_PROCESSOR_FEATURE_IDENTIFIERS)].Flags |= CPUID_LEAF_FLAG_MODIFIED;
+    g_CpuidLeaves[CpuidHandlerGetLeafIndex(CPUID_HV_VENDOR_AND_MAX_FUNCTIONS)].Flags |= CPUID_LEAF_FLAG_MODIFIED;
+    g_CpuidLeaves[CpuidHandlerGetLeafIndex(HYPERV_CPUID_INTERFACE)].Flags |= CPUID_LEAF_FLAG_MODIFIED;
+}
+
+/**
+ * @brief Set the leaves that the CPUID events are interested in
+ * @details should be called from vmx non-root
+ *
+ * @param Leaves The leaves of the events
+ * @param LeavesCount Count of the leaves
+ * @param IsActive Whether the leaves are filtered or not
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+CpuidHandlerSetEventFilter(UINT32 * Leaves, UINT32 LeavesCount, BOOLEAN IsActive)
+{
+    INT32 Index;
+
+    //
+    // The filter is deactivated while the table is changed, so the cores
+    // don't miss any interesting CPUID
+    //
+    g_CpuidEventFilterIsActive = FALSE;
+
+    for (UINT32 i = 0; i < CPUID_HANDLER_LEAVES_TABLE_SIZE; i++)
+    {
+        g_CpuidLeaves[i].Flags &= ~CPUID_LEAF_FLAG_EVENT;
+    }
+
+    for (UINT32 i = 0; i < LeavesCount; i++)
+    {
+        Index = CpuidHandlerGetLeafIndex(Leaves[i]);
+
+        if (Index == -1)
+        {
+            //
+            // The leaf is not covered by the table, so all of the CPUIDs
+            // should be dispatched
+            //
+            return;
+        }
+
+        g_CpuidLeaves[Index].Flags |= CPUID_LEAF_FLAG_EVENT;
+    }
+
+    g_CpuidEventFilterIsActive = IsActive;
+}
+
+/**
+ * @brief Check whether the CPUID events are interested in the leaf or not
+ *
+ * @param Leaf
+ * @return BOOLEAN Shows whether the CPUID should be handled without
+ * triggering the events or not
+ */
+_Use_decl_annotations_
+BOOLEAN
+CpuidHandlerIsFilteredOut(UINT32 Leaf)
+{
+    INT32 Index;
+
+    if (!g_CpuidEventFilterIsActive)
+    {
+        return FALSE;
+    }
+
+    Index = CpuidHandlerGetLeafIndex(Leaf);
+
+    return Index == -1 || !(g_CpuidLeaves[Index].Flags & CPUID_LEAF_FLAG_EVENT);
+}
+
+/**
+ * @brief Execute CPUID on behalf of the guest
+ * @details the results of the static leaves are served from the per-core
+ * cache, should be called from vmx-root
+ *
+ * @param VCpu The virtual processor's state
+ * @param Leaf
+ * @param SubLeaf
+ * @param CpuInfo The result (EAX, EBX, ECX and EDX)
+ * @return UCHAR The flags of the leaf (CPUID_LEAF_FLAG_*)
+ */
+_Use_decl_annotations_
+UCHAR
+CpuidHandlerExecute(VIRTUAL_MACHINE_STATE * VCpu, UINT32 Leaf, UINT32 SubLeaf, INT32 * CpuInfo)
+{
+    INT32  Index = CpuidHandlerGetLeafIndex(Leaf);
+    UCHAR  Flags;
+    UINT32 Slot;
+
+    if (Index == -1)
+    {
+        __cpuidex(CpuInfo, Leaf, SubLeaf);
+        return 0;
+    }
+
+    Flags = g_CpuidLeaves[Index].Flags;
+
+    if (!(Flags & CPUID_LEAF_FLAG_CACHEABLE))
+    {
+        __cpuidex(CpuInfo, Leaf, SubLeaf);
+        return Flags;
+    }
+
+    Slot = g_CpuidLeaves[Index].CacheSlot;
+
+    if (!(VCpu->CpuidCache.ValidSlots & (1 << Slot)))
+    {
+        __cpuidex(VCpu->CpuidCache.Results[Slot], Leaf, SubLeaf);
+        VCpu->CpuidCache.ValidSlots |= (1 << Slot);
+    }
+
+    RtlCopyMemory(CpuInfo, VCpu->CpuidCache.Results[Slot], sizeof(VCpu->CpuidCache.Results[Slot]));
+
+    return Flags;
+}
+
+/**
+ * @brief Invalidate the cached results of CPUID on the current core
+ * @details the maximum basic leaf might be changed by the guest (the
+ * limit CPUID maxval bit of IA32_MISC_ENABLE)
+ *
+ * @param VCpu The virtual processor's state
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+CpuidHandlerInvalidateCache(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    VCpu->CpuidCache.ValidSlots = 0;
+}
@@ -32,7 +32,38 @@ VmxHandleXsetbv(VIRTUAL_MACHINE_STATE * VCpu)
 VOID
 VmxHandleVmxPreemptionTimerVmexit(VIRTUAL_MACHINE_STATE * VCpu)
 {
-    LogError("Why vm-exit for VMX preemption timer happened?");
+    //
+    // The pending updates of VMCS controls are already applied at the
+    // start of the vm-exit, so only the samples should be taken here
+    //
+    if (g_SamplingProfilerEnabled)
+    {
+        SamplingProfilerRecordSample(VCpu);
+    }
+
+    //
+    // The PEBS buffer of the core is drained before it's full
+    //
+    if (g_PebsSamplingEnabled)
+    {
+        PebsSamplingDrainBuffer(VCpu);
+    }
+
+    //
+    // Nothing to do for the counter of the retired instructions here, its
+    // overflow is checked at the end of the vm-exit (the NMI of the overflow
+    // might be received in vmx-root)
+    //
+    if (!g_SamplingProfilerEnabled && !g_PebsSamplingEnabled && g_VmcsPendingUpdatesKickTimerValue == 0 &&
+        !VCpu->InstructionCounter.IsArmed)
+    {
+        LogError("Why vm-exit for VMX preemption timer happened?");
+    }
+
+    //
+    // Start the next period of the timer
+    //
+    CounterReloadPreemptionTimer();
 
     //
     // Not increase the RIP by default
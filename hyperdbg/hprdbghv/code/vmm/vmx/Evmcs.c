@@ -0,0 +1,553 @@
+/**
+ * @file Evmcs.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Implementation of the enlightened VMCS of Hyper-V
+ * @details once HyperDbg is nested under Hyper-V, the VMCS region of each
+ * core is used as its enlightened VMCS, the fields are read and written on
+ * the memory and the groups of the written fields are marked as dirty, so
+ * Hyper-V only reloads the dirty groups on vm-entries
+ *
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Map a field of VMCS to the enlightened VMCS
+ *
+ */
+#define EVMCS_FIELD_MAP(Encoding, Member, CleanField)             \
+    {                                                             \
+        Encoding,                                                 \
+        (UINT16)FIELD_OFFSET(struct hv_enlightened_vmcs, Member), \
+        HV_VMX_ENLIGHTENED_CLEAN_FIELD_##CleanField               \
+    }
+
+/**
+ * @brief The fields of the enlightened VMCS (version 1)
+ * @details the read-only fields and the guest's RIP are not tracked by the
+ * clean fields, the fields that their group is not defined dirty all of
+ * the groups
+ *
+ */
+static const EVMCS_FIELD_MAPPING EvmcsFieldMappings[] = {
+    //
+    // 16-bit fields
+    //
+    EVMCS_FIELD_MAP(0x0000, virtual_processor_id, CONTROL_XLAT),
+    EVMCS_FIELD_MAP(0x0800, guest_es_selector, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x0802, guest_cs_selector, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x0804, guest_ss_selector, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x0806, guest_ds_selector, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x0808, guest_fs_selector, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x080a, guest_gs_selector, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x080c, guest_ldtr_selector, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x080e, guest_tr_selector, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x0c00, host_es_selector, HOST_GRP1),
+    EVMCS_FIELD_MAP(0x0c02, host_cs_selector, HOST_GRP1),
+    EVMCS_FIELD_MAP(0x0c04, host_ss_selector, HOST_GRP1),
+    EVMCS_FIELD_MAP(0x0c06, host_ds_selector, HOST_GRP1),
+    EVMCS_FIELD_MAP(0x0c08, host_fs_selector, HOST_GRP1),
+    EVMCS_FIELD_MAP(0x0c0a, host_gs_selector, HOST_GRP1),
+    EVMCS_FIELD_MAP(0x0c0c, host_tr_selector, HOST_GRP1),
+
+    //
+    // 64-bit fields
+    //
+    EVMCS_FIELD_MAP(0x2000, io_bitmap_a, IO_BITMAP),
+    EVMCS_FIELD_MAP(0x2002, io_bitmap_b, IO_BITMAP),
+    EVMCS_FIELD_MAP(0x2004, msr_bitmap, MSR_BITMAP),
+    EVMCS_FIELD_MAP(0x2006, vm_exit_msr_store_addr, ALL),
+    EVMCS_FIELD_MAP(0x2008, vm_exit_msr_load_addr, ALL),
+    EVMCS_FIELD_MAP(0x200a, vm_entry_msr_load_addr, ALL),
+    EVMCS_FIELD_MAP(0x2010, tsc_offset, CONTROL_GRP2),
+    EVMCS_FIELD_MAP(0x2012, virtual_apic_page_addr, CONTROL_GRP2),
+    EVMCS_FIELD_MAP(0x201a, ept_pointer, CONTROL_XLAT),
+    EVMCS_FIELD_MAP(0x202c, xss_exit_bitmap, CONTROL_GRP2),
+    EVMCS_FIELD_MAP(0x2400, guest_physical_address, NONE),
+    EVMCS_FIELD_MAP(0x2800, vmcs_link_pointer, GUEST_GRP1),
+    EVMCS_FIELD_MAP(0x2802, guest_ia32_debugctl, GUEST_GRP1),
+    EVMCS_FIELD_MAP(0x2804, guest_ia32_pat, GUEST_GRP1),
+    EVMCS_FIELD_MAP(0x2806, guest_ia32_efer, GUEST_GRP1),
+    EVMCS_FIELD_MAP(0x280a, guest_pdptr0, GUEST_GRP1),
+    EVMCS_FIELD_MAP(0x280c, guest_pdptr1, GUEST_GRP1),
+    EVMCS_FIELD_MAP(0x280e, guest_pdptr2, GUEST_GRP1),
+    EVMCS_FIELD_MAP(0x2810, guest_pdptr3, GUEST_GRP1),
+    EVMCS_FIELD_MAP(0x2812, guest_bndcfgs, GUEST_GRP1),
+    EVMCS_FIELD_MAP(0x2c00, host_ia32_pat, HOST_GRP1),
+    EVMCS_FIELD_MAP(0x2c02, host_ia32_efer, HOST_GRP1),
+
+    //
+    // 32-bit fields
+    //
+    EVMCS_FIELD_MAP(0x4000, pin_based_vm_exec_control, CONTROL_GRP1),
+    EVMCS_FIELD_MAP(0x4002, cpu_based_vm_exec_control, CONTROL_PROC),
+    EVMCS_FIELD_MAP(0x4004, exception_bitmap, CONTROL_EXCPN),
+    EVMCS_FIELD_MAP(0x4006, page_fault_error_code_mask, ALL),
+    EVMCS_FIELD_MAP(0x4008, page_fault_error_code_match, ALL),
+    EVMCS_FIELD_MAP(0x400a, cr3_target_count, ALL),
+    EVMCS_FIELD_MAP(0x400c, vm_exit_controls, CONTROL_GRP1),
+    EVMCS_FIELD_MAP(0x400e, vm_exit_msr_store_count, ALL),
+    EVMCS_FIELD_MAP(0x4010, vm_exit_msr_load_count, ALL),
+    EVMCS_FIELD_MAP(0x4012, vm_entry_controls, CONTROL_ENTRY),
+    EVMCS_FIELD_MAP(0x4014, vm_entry_msr_load_count, ALL),
+    EVMCS_FIELD_MAP(0x4016, vm_entry_intr_info_field, CONTROL_EVENT),
+    EVMCS_FIELD_MAP(0x4018, vm_entry_exception_error_code, CONTROL_EVENT),
+    EVMCS_FIELD_MAP(0x401a, vm_entry_instruction_len, CONTROL_EVENT),
+    EVMCS_FIELD_MAP(0x401c, tpr_threshold, NONE),
+    EVMCS_FIELD_MAP(0x401e, secondary_vm_exec_control, CONTROL_GRP1),
+    EVMCS_FIELD_MAP(0x4400, vm_instruction_error, NONE),
+    EVMCS_FIELD_MAP(0x4402, vm_exit_reason, NONE),
+    EVMCS_FIELD_MAP(0x4404, vm_exit_intr_info, NONE),
+    EVMCS_FIELD_MAP(0x4406, vm_exit_intr_error_code, NONE),
+    EVMCS_FIELD_MAP(0x4408, idt_vectoring_info_field, NONE),
+    EVMCS_FIELD_MAP(0x440a, idt_vectoring_error_code, NONE),
+    EVMCS_FIELD_MAP(0x440c, vm_exit_instruction_len, NONE),
+    EVMCS_FIELD_MAP(0x440e, vmx_instruction_info, NONE),
+    EVMCS_FIELD_MAP(0x4800, guest_es_limit, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x4802, guest_cs_limit, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x4804, guest_ss_limit, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x4806, guest_ds_limit, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x4808, guest_fs_limit, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x480a, guest_gs_limit, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x480c, guest_ldtr_limit, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x480e, guest_tr_limit, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x4810, guest_gdtr_limit, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x4812, guest_idtr_limit, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x4814, guest_es_ar_bytes, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x4816, guest_cs_ar_bytes, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x4818, guest_ss_ar_bytes, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x481a, guest_ds_ar_bytes, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x481c, guest_fs_ar_bytes, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x481e, guest_gs_ar_bytes, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x4820, guest_ldtr_ar_bytes, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x4822, guest_tr_ar_bytes, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x4824, guest_interruptibility_info, GUEST_BASIC),
+    EVMCS_FIELD_MAP(0x4826, guest_activity_state, GUEST_GRP1),
+    EVMCS_FIELD_MAP(0x482a, guest_sysenter_cs, GUEST_GRP1),
+    EVMCS_FIELD_MAP(0x4c00, host_ia32_sysenter_cs, HOST_GRP1),
+
+    //
+    // Natural-width fields
+    //
+    EVMCS_FIELD_MAP(0x6000, cr0_guest_host_mask, CRDR),
+    EVMCS_FIELD_MAP(0x6002, cr4_guest_host_mask, CRDR),
+    EVMCS_FIELD_MAP(0x6004, cr0_read_shadow, CRDR),
+    EVMCS_FIELD_MAP(0x6006, cr4_read_shadow, CRDR),
+    EVMCS_FIELD_MAP(0x6008, cr3_target_value0, ALL),
+    EVMCS_FIELD_MAP(0x600a, cr3_target_value1, ALL),
+    EVMCS_FIELD_MAP(0x600c, cr3_target_value2, ALL),
+    EVMCS_FIELD_MAP(0x600e, cr3_target_value3, ALL),
+    EVMCS_FIELD_MAP(0x6400, exit_qualification, NONE),
+    EVMCS_FIELD_MAP(0x6402, exit_io_instruction_ecx, NONE),
+    EVMCS_FIELD_MAP(0x6404, exit_io_instruction_esi, NONE),
+    EVMCS_FIELD_MAP(0x6406, exit_io_instruction_edi, NONE),
+    EVMCS_FIELD_MAP(0x6408, exit_io_instruction_eip, NONE),
+    EVMCS_FIELD_MAP(0x640a, guest_linear_address, NONE),
+    EVMCS_FIELD_MAP(0x6800, guest_cr0, CRDR),
+    EVMCS_FIELD_MAP(0x6802, guest_cr3, CRDR),
+    EVMCS_FIELD_MAP(0x6804, guest_cr4, CRDR),
+    EVMCS_FIELD_MAP(0x6806, guest_es_base, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x6808, guest_cs_base, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x680a, guest_ss_base, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x680c, guest_ds_base, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x680e, guest_fs_base, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x6810, guest_gs_base, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x6812, guest_ldtr_base, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x6814, guest_tr_base, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x6816, guest_gdtr_base, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x6818, guest_idtr_base, GUEST_GRP2),
+    EVMCS_FIELD_MAP(0x681a, guest_dr7, CRDR),
+    EVMCS_FIELD_MAP(0x681c, guest_rsp, GUEST_BASIC),
+    EVMCS_FIELD_MAP(0x681e, guest_rip, NONE),
+    EVMCS_FIELD_MAP(0x6820, guest_rflags, GUEST_BASIC),
+    EVMCS_FIELD_MAP(0x6822, guest_pending_dbg_exceptions, GUEST_GRP1),
+    EVMCS_FIELD_MAP(0x6824, guest_sysenter_esp, GUEST_GRP1),
+    EVMCS_FIELD_MAP(0x6826, guest_sysenter_eip, GUEST_GRP1),
+    EVMCS_FIELD_MAP(0x6c00, host_cr0, HOST_GRP1),
+    EVMCS_FIELD_MAP(0x6c02, host_cr3, HOST_GRP1),
+    EVMCS_FIELD_MAP(0x6c04, host_cr4, HOST_GRP1),
+    EVMCS_FIELD_MAP(0x6c06, host_fs_base, HOST_POINTER),
+    EVMCS_FIELD_MAP(0x6c08, host_gs_base, HOST_POINTER),
+    EVMCS_FIELD_MAP(0x6c0a, host_tr_base, HOST_POINTER),
+    EVMCS_FIELD_MAP(0x6c0c, host_gdtr_base, HOST_POINTER),
+    EVMCS_FIELD_MAP(0x6c0e, host_idtr_base, HOST_POINTER),
+    EVMCS_FIELD_MAP(0x6c10, host_ia32_sysenter_esp, HOST_GRP1),
+    EVMCS_FIELD_MAP(0x6c12, host_ia32_sysenter_eip, HOST_GRP1),
+    EVMCS_FIELD_MAP(0x6c14, host_rsp, HOST_POINTER),
+    EVMCS_FIELD_MAP(0x6c16, host_rip, HOST_GRP1),
+};
+
+/**
+ * @brief The fields of the enlightened VMCS (indexed by the width, type
+ * and the index of their encodings)
+ *
+ */
+static EVMCS_FIELD EvmcsFields[EVMCS_FIELDS_TABLE_SIZE];
+
+/**
+ * @brief Get the index of a field in the table of the fields
+ *
+ * @param Field The encoding of the field (the access type is ignored)
+ * @param Index The index in the table
+ *
+ * @return BOOLEAN Returns false if the encoding is not valid for the table
+ */
+static BOOLEAN
+EvmcsGetFieldIndex(size_t Field, UINT32 * Index)
+{
+    //
+    // Bits 9:1 are the index, bits 11:10 are the type and bits 14:13 are
+    // the width, the other bits (except the access type) are reserved
+    //
+    if ((Field & ~(size_t)0x6fff) != 0 || ((Field >> 1) & 0x1ff) >= (1 << EVMCS_FIELD_INDEX_BITS))
+    {
+        return FALSE;
+    }
+
+    *Index = (UINT32)((((Field >> 13) & 0x3) << (EVMCS_FIELD_INDEX_BITS + 2)) |
+                      (((Field >> 10) & 0x3) << EVMCS_FIELD_INDEX_BITS) |
+                      ((Field >> 1) & ((1 << EVMCS_FIELD_INDEX_BITS) - 1)));
+
+    return TRUE;
+}
+
+/**
+ * @brief Find a field in an enlightened VMCS
+ *
+ * @param Evmcs The enlightened VMCS
+ * @param Field The encoding of the field
+ * @param Address The address of the field in the enlightened VMCS
+ * @param Width The width of the field (EVMCS_FIELD_WIDTH_*)
+ *
+ * @return PEVMCS_FIELD Returns NULL if the field is not in the enlightened VMCS
+ */
+static PEVMCS_FIELD
+EvmcsFindField(PUCHAR Evmcs, size_t Field, PUCHAR * Address, UINT32 * Width)
+{
+    UINT32       Index;
+    PEVMCS_FIELD Entry;
+
+    if (Evmcs == NULL || !EvmcsGetFieldIndex(Field, &Index))
+    {
+        return NULL;
+    }
+
+    Entry = &EvmcsFields[Index];
+
+    if (Entry->Offset == 0)
+    {
+        return NULL;
+    }
+
+    *Width   = (Field >> 13) & 0x3;
+    *Address = Evmcs + Entry->Offset;
+
+    //
+    // The high access of the 64-bit fields is the upper 32 bits of the field
+    //
+    if (Field & 1)
+    {
+        if (*Width != EVMCS_FIELD_WIDTH_64BIT)
+        {
+            return NULL;
+        }
+
+        *Width = EVMCS_FIELD_WIDTH_32BIT;
+        *Address += sizeof(UINT32);
+    }
+
+    return Entry;
+}
+
+/**
+ * @brief Initialize the table of the fields of the enlightened VMCS
+ * @details should be called once the compatibility checks are performed and
+ * before virtualizing the cores, the enlightened VMCS is used if it's
+ * supported and recommended by Hyper-V
+ *
+ * @return VOID
+ */
+VOID
+EvmcsInitialize()
+{
+    UINT32 Index;
+
+    if (g_CompatibilityCheck.EnlightenedVmcsVersion == 0)
+    {
+        return;
+    }
+
+    RtlZeroMemory(EvmcsFields, sizeof(EvmcsFields));
+
+    for (UINT32 i = 0; i < RTL_NUMBER_OF(EvmcsFieldMappings); i++)
+    {
+        if (EvmcsGetFieldIndex(EvmcsFieldMappings[i].Encoding, &Index))
+        {
+            EvmcsFields[Index].Offset     = EvmcsFieldMappings[i].Offset;
+            EvmcsFields[Index].CleanField = EvmcsFieldMappings[i].CleanField;
+        }
+    }
+
+    g_EnlightenedVmcsIsActive = TRUE;
+
+    LogDebugInfo("The enlightened VMCS (version %d) is used", g_CompatibilityCheck.EnlightenedVmcsVersion);
+}
+
+/**
+ * @brief Allocate (or use the guest's) VP assist page of the current core
+ * @details should be called in vmx non-root on the target core, the page
+ * is shared with the guest if the guest already enabled it
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return BOOLEAN
+ */
+_Use_decl_annotations_
+BOOLEAN
+EvmcsAllocateVpAssistPage(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    union hv_vp_assist_msr_contents VpAssistMsr = {0};
+
+    if (!g_EnlightenedVmcsIsActive)
+    {
+        return TRUE;
+    }
+
+    VpAssistMsr.as_uint64 = __readmsr(HV_X64_MSR_VP_ASSIST_PAGE);
+
+    if (VpAssistMsr.enable)
+    {
+        VCpu->VpAssistPage            = (PVOID)PhysicalAddressToVirtualAddress(VpAssistMsr.as_uint64 & HV_X64_MSR_VP_ASSIST_PAGE_ADDRESS_MASK);
+        VCpu->VpAssistPageIsAllocated = FALSE;
+
+        return VCpu->VpAssistPage != NULL;
+    }
+
+    VCpu->VpAssistPage = CrsAllocateContiguousZeroedMemoryOnCore(PAGE_SIZE, VCpu->CoreId);
+
+    if (VCpu->VpAssistPage == NULL)
+    {
+        LogError("Err, insufficient memory for the VP assist page");
+        return FALSE;
+    }
+
+    VCpu->VpAssistPageIsAllocated = TRUE;
+
+    VpAssistMsr.as_uint64 = VirtualAddressToPhysicalAddress(VCpu->VpAssistPage) | HV_X64_MSR_VP_ASSIST_PAGE_ENABLE;
+    __writemsr(HV_X64_MSR_VP_ASSIST_PAGE, VpAssistMsr.as_uint64);
+
+    return TRUE;
+}
+
+/**
+ * @brief Free the VP assist page of the current core (if it's allocated by us)
+ * @details should be called in vmx non-root on the target core
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+EvmcsFreeVpAssistPage(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    if (VCpu->VpAssistPage == NULL)
+    {
+        return;
+    }
+
+    if (VCpu->VpAssistPageIsAllocated)
+    {
+        __writemsr(HV_X64_MSR_VP_ASSIST_PAGE, 0);
+        MmFreeContiguousMemory(VCpu->VpAssistPage);
+    }
+
+    VCpu->VpAssistPage            = NULL;
+    VCpu->VpAssistPageIsAllocated = FALSE;
+}
+
+/**
+ * @brief Make the enlightened VMCS of the core current (instead of VMPTRLD)
+ * @details the VMCS region of the core is used as the enlightened VMCS and
+ * all of the fields are dirty
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+EvmcsLoad(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    struct hv_vp_assist_page *   VpAssistPage = (struct hv_vp_assist_page *)VCpu->VpAssistPage;
+    struct hv_enlightened_vmcs * Evmcs;
+
+    Evmcs = (struct hv_enlightened_vmcs *)((VCpu->VmcsRegionVirtualAddress + ALIGNMENT_PAGE_SIZE - 1) & ~(ALIGNMENT_PAGE_SIZE - 1));
+
+    Evmcs->revision_id     = g_CompatibilityCheck.EnlightenedVmcsVersion;
+    Evmcs->hv_clean_fields = HV_VMX_ENLIGHTENED_CLEAN_FIELD_NONE;
+
+    //
+    // Hyper-V doesn't check the MSR bitmap on each vm-entry if the MSR
+    // bitmap is enlightened (it's dirtied once the bitmap is changed)
+    //
+    Evmcs->hv_enlightenments_control.msr_bitmap = g_CompatibilityCheck.EnlightenedMsrBitmapSupport;
+
+    VCpu->EnlightenedVmcs = Evmcs;
+
+    VpAssistPage->current_nested_vmcs = VCpu->VmcsRegionPhysicalAddress;
+    VpAssistPage->enlighten_vmentry   = 1;
+}
+
+/**
+ * @brief Make the enlightened VMCS of the core not current (instead of VMCLEAR)
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+EvmcsUnload(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    struct hv_vp_assist_page * VpAssistPage = (struct hv_vp_assist_page *)VCpu->VpAssistPage;
+
+    if (VpAssistPage != NULL)
+    {
+        VpAssistPage->enlighten_vmentry   = 0;
+        VpAssistPage->current_nested_vmcs = NULL;
+    }
+
+    VCpu->EnlightenedVmcs = NULL;
+}
+
+/**
+ * @brief Mark all of the fields of the enlightened VMCS as clean
+ * @details should be called at the start of handling each vm-exit, Hyper-V
+ * synchronizes the fields on vm-exits
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+EvmcsMarkAllFieldsClean(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    struct hv_enlightened_vmcs * Evmcs = (struct hv_enlightened_vmcs *)VCpu->EnlightenedVmcs;
+
+    if (Evmcs != NULL)
+    {
+        Evmcs->hv_clean_fields |= HV_VMX_ENLIGHTENED_CLEAN_FIELD_ALL;
+    }
+}
+
+/**
+ * @brief Mark groups of the fields of the enlightened VMCS as dirty
+ * @details should be called in vmx-root once the memory that is pointed
+ * by the fields (e.g., MSR bitmap) is changed
+ *
+ * @param VCpu The virtual processor's state
+ * @param CleanFields The groups (HV_VMX_ENLIGHTENED_CLEAN_FIELD_*)
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+EvmcsMarkFieldsDirty(VIRTUAL_MACHINE_STATE * VCpu, UINT32 CleanFields)
+{
+    struct hv_enlightened_vmcs * Evmcs = (struct hv_enlightened_vmcs *)VCpu->EnlightenedVmcs;
+
+    if (Evmcs != NULL)
+    {
+        Evmcs->hv_clean_fields &= ~CleanFields;
+    }
+}
+
+/**
+ * @brief Read a field of the enlightened VMCS of the current core
+ *
+ * @param Field The encoding of the field
+ * @param FieldValue The value of the field
+ *
+ * @return UCHAR Zero if it's successful, one if the field is not supported
+ */
+_Use_decl_annotations_
+UCHAR
+EvmcsRead(size_t Field, size_t * FieldValue)
+{
+    PUCHAR Evmcs = (PUCHAR)g_GuestState[KeGetCurrentProcessorNumber()].EnlightenedVmcs;
+    PUCHAR Address;
+    UINT32 Width;
+
+    if (EvmcsFindField(Evmcs, Field, &Address, &Width) == NULL)
+    {
+        return 1;
+    }
+
+    switch (Width)
+    {
+    case EVMCS_FIELD_WIDTH_16BIT:
+        *FieldValue = *(UINT16 *)Address;
+        break;
+
+    case EVMCS_FIELD_WIDTH_32BIT:
+        *FieldValue = *(UINT32 *)Address;
+        break;
+
+    default:
+        *FieldValue = *(UINT64 *)Address;
+        break;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Write a field of the enlightened VMCS of the current core
+ * @details the group of the field is marked as dirty
+ *
+ * @param Field The encoding of the field
+ * @param FieldValue The value of the field
+ *
+ * @return UCHAR Zero if it's successful, one if the field is not supported
+ */
+_Use_decl_annotations_
+UCHAR
+EvmcsWrite(size_t Field, size_t FieldValue)
+{
+    PUCHAR       Evmcs = (PUCHAR)g_GuestState[KeGetCurrentProcessorNumber()].EnlightenedVmcs;
+    PUCHAR       Address;
+    UINT32       Width;
+    PEVMCS_FIELD Entry;
+
+    Entry = EvmcsFindField(Evmcs, Field, &Address, &Width);
+
+    if (Entry == NULL)
+    {
+        return 1;
+    }
+
+    switch (Width)
+    {
+    case EVMCS_FIELD_WIDTH_16BIT:
+        *(UINT16 *)Address = (UINT16)FieldValue;
+        break;
+
+    case EVMCS_FIELD_WIDTH_32BIT:
+        *(UINT32 *)Address = (UINT32)FieldValue;
+        break;
+
+    default:
+        *(UINT64 *)Address = FieldValue;
+        break;
+    }
+
+    ((struct hv_enlightened_vmcs *)Evmcs)->hv_clean_fields &= ~Entry->CleanField;
+
+    return 0;
+}
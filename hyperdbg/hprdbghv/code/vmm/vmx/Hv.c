@@ -49,10 +49,10 @@ HvSetGuestSelector(PVOID GdtBase, ULONG SegmentRegister, UINT16 Selector)
         SegmentSelector.Attributes.Unusable = TRUE;
     }
 
-    __vmx_vmwrite(VMCS_GUEST_ES_SELECTOR + SegmentRegister * 2, Selector);
-    __vmx_vmwrite(VMCS_GUEST_ES_LIMIT + SegmentRegister * 2, SegmentSelector.Limit);
-    __vmx_vmwrite(VMCS_GUEST_ES_ACCESS_RIGHTS + SegmentRegister * 2, SegmentSelector.Attributes.AsUInt);
-    __vmx_vmwrite(VMCS_GUEST_ES_BASE + SegmentRegister * 2, SegmentSelector.Base);
+    VmxVmwrite(VMCS_GUEST_ES_SELECTOR + SegmentRegister * 2, Selector);
+    VmxVmwrite(VMCS_GUEST_ES_LIMIT + SegmentRegister * 2, SegmentSelector.Limit);
+    VmxVmwrite(VMCS_GUEST_ES_ACCESS_RIGHTS + SegmentRegister * 2, SegmentSelector.Attributes.AsUInt);
+    VmxVmwrite(VMCS_GUEST_ES_BASE + SegmentRegister * 2, SegmentSelector.Base);
 
     return TRUE;
 }
@@ -67,21 +67,21 @@ VOID
 HvHandleCpuid(VIRTUAL_MACHINE_STATE * VCpu)
 {
     INT32       CpuInfo[4];
-    ULONG       Mode = 0;
+    UCHAR       LeafFlags;
     PGUEST_REGS Regs = VCpu->Regs;
 
     //
     // Otherwise, issue the CPUID to the logical processor based on the indexes
-    // on the VP's GPRs.
+    // on the VP's GPRs (the static leaves are served from the per-core cache)
     //
-    __cpuidex(CpuInfo, (INT32)Regs->rax, (INT32)Regs->rcx);
+    LeafFlags = CpuidHandlerExecute(VCpu, (UINT32)Regs->rax, (UINT32)Regs->rcx, CpuInfo);
 
     //
     // check whether we are in transparent mode or not
     // if we are in transparent mode then ignore the
     // cpuid modifications e.g. hyperviosr name or bit
     //
-    if (!g_TransparentMode)
+    if (!g_TransparentMode && (LeafFlags & CPUID_LEAF_FLAG_MODIFIED))
     {
         //
         // Check if this was CPUID 1h, which is the features request
@@ -155,7 +155,7 @@ HvHandleControlRegisterAccess(VIRTUAL_MACHINE_STATE *         VCpu,
     /*
     if (CrExitQualification->Fields.Register == 4)
     {
-        __vmx_vmread(VMCS_GUEST_RSP, &GuestRsp);
+        VmxVmread(VMCS_GUEST_RSP, &GuestRsp);
         *RegPtr = GuestRsp;
     }
     */
@@ -168,8 +168,8 @@ HvHandleControlRegisterAccess(VIRTUAL_MACHINE_STATE *         VCpu,
         {
         case VMX_EXIT_QUALIFICATION_REGISTER_CR0:
 
-            __vmx_vmwrite(VMCS_GUEST_CR0, *RegPtr);
-            __vmx_vmwrite(VMCS_CTRL_CR0_READ_SHADOW, *RegPtr);
+            VmxVmwrite(VMCS_GUEST_CR0, *RegPtr);
+            VmxVmwrite(VMCS_CTRL_CR0_READ_SHADOW, *RegPtr);
 
             break;
 
@@ -181,7 +181,7 @@ HvHandleControlRegisterAccess(VIRTUAL_MACHINE_STATE *         VCpu,
             //
             // Apply the new cr3
             //
-            __vmx_vmwrite(VMCS_GUEST_CR3, NewCr3Reg.Flags);
+            VmxVmwrite(VMCS_GUEST_CR3, NewCr3Reg.Flags);
 
             //
             // Invalidate as we used VPID tags so the vm-exit won't
@@ -215,8 +215,8 @@ HvHandleControlRegisterAccess(VIRTUAL_MACHINE_STATE *         VCpu,
 
         case VMX_EXIT_QUALIFICATION_REGISTER_CR4:
 
-            __vmx_vmwrite(VMCS_GUEST_CR4, *RegPtr);
-            __vmx_vmwrite(VMCS_CTRL_CR4_READ_SHADOW, *RegPtr);
+            VmxVmwrite(VMCS_GUEST_CR4, *RegPtr);
+            VmxVmwrite(VMCS_CTRL_CR4_READ_SHADOW, *RegPtr);
 
             break;
 
@@ -234,19 +234,19 @@ HvHandleControlRegisterAccess(VIRTUAL_MACHINE_STATE *         VCpu,
         {
         case VMX_EXIT_QUALIFICATION_REGISTER_CR0:
 
-            __vmx_vmread(VMCS_GUEST_CR0, RegPtr);
+            VmxVmread(VMCS_GUEST_CR0, RegPtr);
 
             break;
 
         case VMX_EXIT_QUALIFICATION_REGISTER_CR3:
 
-            __vmx_vmread(VMCS_GUEST_CR3, RegPtr);
+            VmxVmread(VMCS_GUEST_CR3, RegPtr);
 
             break;
 
         case VMX_EXIT_QUALIFICATION_REGISTER_CR4:
 
-            __vmx_vmread(VMCS_GUEST_CR4, RegPtr);
+            VmxVmread(VMCS_GUEST_CR4, RegPtr);
 
             break;
 
@@ -288,10 +288,10 @@ HvFillGuestSelectorData(PVOID GdtBase, ULONG SegmentRegister, UINT16 Selector)
     SegmentSelector.Attributes.Reserved1 = 0;
     SegmentSelector.Attributes.Reserved2 = 0;
 
-    __vmx_vmwrite(VMCS_GUEST_ES_SELECTOR + SegmentRegister * 2, Selector);
-    __vmx_vmwrite(VMCS_GUEST_ES_LIMIT + SegmentRegister * 2, SegmentSelector.Limit);
-    __vmx_vmwrite(VMCS_GUEST_ES_ACCESS_RIGHTS + SegmentRegister * 2, SegmentSelector.Attributes.AsUInt);
-    __vmx_vmwrite(VMCS_GUEST_ES_BASE + SegmentRegister * 2, SegmentSelector.Base);
+    VmxVmwrite(VMCS_GUEST_ES_SELECTOR + SegmentRegister * 2, Selector);
+    VmxVmwrite(VMCS_GUEST_ES_LIMIT + SegmentRegister * 2, SegmentSelector.Limit);
+    VmxVmwrite(VMCS_GUEST_ES_ACCESS_RIGHTS + SegmentRegister * 2, SegmentSelector.Attributes.AsUInt);
+    VmxVmwrite(VMCS_GUEST_ES_BASE + SegmentRegister * 2, SegmentSelector.Base);
 }
 
 /**
@@ -306,12 +306,12 @@ HvResumeToNextInstruction()
     UINT64 CurrentRIP            = NULL;
     size_t ExitInstructionLength = 0;
 
-    __vmx_vmread(VMCS_GUEST_RIP, &CurrentRIP);
-    __vmx_vmread(VMCS_VMEXIT_INSTRUCTION_LENGTH, &ExitInstructionLength);
+    VmxVmread(VMCS_GUEST_RIP, &CurrentRIP);
+    VmxVmread(VMCS_VMEXIT_INSTRUCTION_LENGTH, &ExitInstructionLength);
 
     ResumeRIP = CurrentRIP + ExitInstructionLength;
 
-    __vmx_vmwrite(VMCS_GUEST_RIP, ResumeRIP);
+    VmxVmwrite(VMCS_GUEST_RIP, ResumeRIP);
 }
 
 /**
@@ -354,7 +354,7 @@ HvSetMonitorTrapFlag(BOOLEAN Set)
     //
     // Read the previous flags
     //
-    __vmx_vmread(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &CpuBasedVmExecControls);
+    VmxVmread(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &CpuBasedVmExecControls);
 
     if (Set)
     {
@@ -368,7 +368,7 @@ HvSetMonitorTrapFlag(BOOLEAN Set)
     //
     // Set the new value
     //
-    __vmx_vmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
+    VmxVmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
 }
 
 /**
@@ -385,9 +385,13 @@ HvSetLoadDebugControls(BOOLEAN Set)
     //
     // Read the previous flags
     //
-    __vmx_vmread(VMCS_CTRL_VMENTRY_CONTROLS, &VmentryControls);
+    VmxVmread(VMCS_CTRL_VMENTRY_CONTROLS, &VmentryControls);
 
-    if (Set)
+    //
+    // The guest's IA32_DEBUGCTL should be loaded as long as the last
+    // branches are recorded
+    //
+    if (Set || g_LastBranchRecordsReferenceCount != 0)
     {
         VmentryControls |= VM_ENTRY_LOAD_DEBUG_CONTROLS;
     }
@@ -399,7 +403,7 @@ HvSetLoadDebugControls(BOOLEAN Set)
     //
     // Set the new value
     //
-    __vmx_vmwrite(VMCS_CTRL_VMENTRY_CONTROLS, VmentryControls);
+    VmxVmwrite(VMCS_CTRL_VMENTRY_CONTROLS, VmentryControls);
 }
 
 /**
@@ -416,9 +420,13 @@ HvSetSaveDebugControls(BOOLEAN Set)
     //
     // Read the previous flags
     //
-    __vmx_vmread(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, &VmexitControls);
+    VmxVmread(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, &VmexitControls);
 
-    if (Set)
+    //
+    // The guest's IA32_DEBUGCTL should be saved as long as the last
+    // branches are recorded
+    //
+    if (Set || g_LastBranchRecordsReferenceCount != 0)
     {
         VmexitControls |= VM_EXIT_SAVE_DEBUG_CONTROLS;
     }
@@ -430,7 +438,119 @@ HvSetSaveDebugControls(BOOLEAN Set)
     //
     // Set the new value
     //
-    __vmx_vmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, VmexitControls);
+    VmxVmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, VmexitControls);
+}
+
+/**
+ * @brief Set LOAD IA32_RTIT_CTL on Vm-entry controls and CLEAR IA32_RTIT_CTL
+ * on Vm-exit controls
+ * @details by setting both of them, the guest's IA32_RTIT_CTL is only
+ * applied in vmx non-root, so the trace never contains vmx-root
+ *
+ * @param Set Set or unset
+ * @return VOID
+ */
+VOID
+HvSetIntelPtControls(BOOLEAN Set)
+{
+    ULONG VmentryControls = 0;
+    ULONG VmexitControls  = 0;
+
+    //
+    // Read the previous flags
+    //
+    VmxVmread(VMCS_CTRL_VMENTRY_CONTROLS, &VmentryControls);
+    VmxVmread(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, &VmexitControls);
+
+    if (Set)
+    {
+        VmentryControls |= VM_ENTRY_LOAD_IA32_RTIT_CTL;
+        VmexitControls |= VM_EXIT_CLEAR_IA32_RTIT_CTL;
+    }
+    else
+    {
+        VmentryControls &= ~VM_ENTRY_LOAD_IA32_RTIT_CTL;
+        VmexitControls &= ~VM_EXIT_CLEAR_IA32_RTIT_CTL;
+    }
+
+    //
+    // Set the new values
+    //
+    VmxVmwrite(VMCS_CTRL_VMENTRY_CONTROLS, VmentryControls);
+    VmxVmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, VmexitControls);
+}
+
+/**
+ * @brief Set LOAD IA32_LBR_CTL on Vm-entry controls and CLEAR IA32_LBR_CTL
+ * on Vm-exit controls
+ *
+ * @param Set Set or unset
+ * @return VOID
+ */
+VOID
+HvSetArchLbrControls(BOOLEAN Set)
+{
+    ULONG VmentryControls = 0;
+    ULONG VmexitControls  = 0;
+
+    //
+    // Read the previous flags
+    //
+    VmxVmread(VMCS_CTRL_VMENTRY_CONTROLS, &VmentryControls);
+    VmxVmread(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, &VmexitControls);
+
+    if (Set)
+    {
+        VmentryControls |= VM_ENTRY_LOAD_IA32_LBR_CTL;
+        VmexitControls |= VM_EXIT_CLEAR_IA32_LBR_CTL;
+    }
+    else
+    {
+        VmentryControls &= ~VM_ENTRY_LOAD_IA32_LBR_CTL;
+        VmexitControls &= ~VM_EXIT_CLEAR_IA32_LBR_CTL;
+    }
+
+    //
+    // Set the new values
+    //
+    VmxVmwrite(VMCS_CTRL_VMENTRY_CONTROLS, VmentryControls);
+    VmxVmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, VmexitControls);
+}
+
+/**
+ * @brief Set LOAD IA32_PERF_GLOBAL_CTRL on both Vm-entry and Vm-exit controls
+ *
+ * @param Set Set or unset
+ * @return VOID
+ */
+VOID
+HvSetPerfGlobalCtrlControls(BOOLEAN Set)
+{
+    ULONG VmentryControls = 0;
+    ULONG VmexitControls  = 0;
+
+    //
+    // Read the previous flags
+    //
+    VmxVmread(VMCS_CTRL_VMENTRY_CONTROLS, &VmentryControls);
+    VmxVmread(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, &VmexitControls);
+
+    if (Set)
+    {
+        VmentryControls |= VM_ENTRY_LOAD_IA32_PERF_GLOBAL_CTRL;
+        VmexitControls |= VM_EXIT_LOAD_IA32_PERF_GLOBAL_CTRL;
+    }
+    else
+    {
+        VmentryControls &= ~VM_ENTRY_LOAD_IA32_PERF_GLOBAL_CTRL;
+        VmexitControls &= ~VM_EXIT_LOAD_IA32_PERF_GLOBAL_CTRL;
+    }
+
+    //
+    // Set the new values
+    //
+    VmxVmwrite(VMCS_CTRL_VMENTRY_CONTROLS, VmentryControls);
+    VmxVmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, VmexitControls);
 }
 
 /**
@@ -451,28 +571,28 @@ HvRestoreRegisters()
     //
     // Restore FS Base
     //
-    __vmx_vmread(VMCS_GUEST_FS_BASE, &FsBase);
+    VmxVmread(VMCS_GUEST_FS_BASE, &FsBase);
     __writemsr(IA32_FS_BASE, FsBase);
 
     //
     // Restore Gs Base
     //
-    __vmx_vmread(VMCS_GUEST_GS_BASE, &GsBase);
+    VmxVmread(VMCS_GUEST_GS_BASE, &GsBase);
     __writemsr(IA32_GS_BASE, GsBase);
 
     //
     // Restore GDTR
     //
-    __vmx_vmread(VMCS_GUEST_GDTR_BASE, &GdtrBase);
-    __vmx_vmread(VMCS_GUEST_GDTR_LIMIT, &GdtrLimit);
+    VmxVmread(VMCS_GUEST_GDTR_BASE, &GdtrBase);
+    VmxVmread(VMCS_GUEST_GDTR_LIMIT, &GdtrLimit);
 
     AsmReloadGdtr(GdtrBase, GdtrLimit);
 
     //
     // Restore IDTR
     //
-    __vmx_vmread(VMCS_GUEST_IDTR_BASE, &IdtrBase);
-    __vmx_vmread(VMCS_GUEST_IDTR_LIMIT, &IdtrLimit);
+    VmxVmread(VMCS_GUEST_IDTR_BASE, &IdtrBase);
+    VmxVmread(VMCS_GUEST_IDTR_LIMIT, &IdtrLimit);
 
     AsmReloadIdtr(IdtrBase, IdtrLimit);
 }
@@ -492,7 +612,7 @@ HvSetPmcVmexit(BOOLEAN Set)
     //
     // Read the previous flags
     //
-    __vmx_vmread(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &CpuBasedVmExecControls);
+    VmxVmread(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &CpuBasedVmExecControls);
 
     if (Set)
     {
@@ -506,7 +626,43 @@ HvSetPmcVmexit(BOOLEAN Set)
     //
     // Set the new value
     //
-    __vmx_vmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
+    VmxVmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
+}
+
+/**
+ * @brief Set or unset the TSC offsetting (the offset is added to the
+ * time stamp counter that is read by the guest)
+ * @details Should be called in vmx-root
+ *
+ * @param Set Set or unset the TSC offsetting
+ * @param TscOffset The TSC offset (ignored if it's unset)
+ * @return VOID
+ */
+VOID
+HvSetTscOffsetting(BOOLEAN Set, INT64 TscOffset)
+{
+    ULONG CpuBasedVmExecControls = 0;
+
+    //
+    // Read the previous flags
+    //
+    VmxVmread(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &CpuBasedVmExecControls);
+
+    if (Set)
+    {
+        CpuBasedVmExecControls |= CPU_BASED_USE_TSC_OFFSETING;
+    }
+    else
+    {
+        CpuBasedVmExecControls &= ~CPU_BASED_USE_TSC_OFFSETING;
+        TscOffset = 0;
+    }
+
+    //
+    // Set the new value
+    //
+    VmxVmwrite(VMCS_CTRL_TSC_OFFSET, TscOffset);
+    VmxVmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
 }
 
 /**
@@ -553,7 +709,7 @@ HvWriteExceptionBitmap(UINT32 BitmapMask)
     //
     // Set the new value
     //
-    __vmx_vmwrite(VMCS_CTRL_EXCEPTION_BITMAP, BitmapMask);
+    VmxVmwrite(VMCS_CTRL_EXCEPTION_BITMAP, BitmapMask);
 }
 
 /**
@@ -570,7 +726,7 @@ HvReadExceptionBitmap()
     //
     // Read the current bitmap
     //
-    __vmx_vmread(VMCS_CTRL_EXCEPTION_BITMAP, &ExceptionBitmap);
+    VmxVmread(VMCS_CTRL_EXCEPTION_BITMAP, &ExceptionBitmap);
 
     return ExceptionBitmap;
 }
@@ -589,7 +745,7 @@ HvSetInterruptWindowExiting(BOOLEAN Set)
     //
     // Read the previous flags
     //
-    __vmx_vmread(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &CpuBasedVmExecControls);
+    VmxVmread(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &CpuBasedVmExecControls);
 
     //
     // interrupt-window exiting
@@ -606,7 +762,7 @@ HvSetInterruptWindowExiting(BOOLEAN Set)
     //
     // Set the new value
     //
-    __vmx_vmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
+    VmxVmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
 }
 
 /**
@@ -623,7 +779,7 @@ HvSetPmlEnableFlag(BOOLEAN Set)
     //
     // Read the previous flags
     //
-    __vmx_vmread(VMCS_CTRL_SECONDARY_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &SecondaryProcBasedVmExecControls);
+    VmxVmread(VMCS_CTRL_SECONDARY_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &SecondaryProcBasedVmExecControls);
 
     //
     // PML enable flag
@@ -642,7 +798,7 @@ HvSetPmlEnableFlag(BOOLEAN Set)
     //
     // Set the new value
     //
-    __vmx_vmwrite(VMCS_CTRL_SECONDARY_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, SecondaryProcBasedVmExecControls);
+    VmxVmwrite(VMCS_CTRL_SECONDARY_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, SecondaryProcBasedVmExecControls);
 }
 
 /**
@@ -659,7 +815,7 @@ HvSetModeBasedExecutionEnableFlag(BOOLEAN Set)
     //
     // Read the previous flags
     //
-    __vmx_vmread(VMCS_CTRL_SECONDARY_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &SecondaryProcBasedVmExecControls);
+    VmxVmread(VMCS_CTRL_SECONDARY_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &SecondaryProcBasedVmExecControls);
 
     //
     // PML enable flag
@@ -678,7 +834,7 @@ HvSetModeBasedExecutionEnableFlag(BOOLEAN Set)
     //
     // Set the new value
     //
-    __vmx_vmwrite(VMCS_CTRL_SECONDARY_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, SecondaryProcBasedVmExecControls);
+    VmxVmwrite(VMCS_CTRL_SECONDARY_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, SecondaryProcBasedVmExecControls);
 }
 
 /**
@@ -695,7 +851,7 @@ HvSetNmiWindowExiting(BOOLEAN Set)
     //
     // Read the previous flags
     //
-    __vmx_vmread(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &CpuBasedVmExecControls);
+    VmxVmread(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &CpuBasedVmExecControls);
 
     //
     // interrupt-window exiting
@@ -712,7 +868,7 @@ HvSetNmiWindowExiting(BOOLEAN Set)
     //
     // Set the new value
     //
-    __vmx_vmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
+    VmxVmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
 }
 
 /**
@@ -733,7 +889,7 @@ HvHandleMovDebugRegister(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // The implementation is derived from Hvpp
     //
-    __vmx_vmread(VMCS_EXIT_QUALIFICATION, &ExitQualification);
+    VmxVmread(VMCS_EXIT_QUALIFICATION, &ExitQualification);
 
     UINT64 GpRegister = GpRegs[ExitQualification.GeneralPurposeRegister];
 
@@ -783,7 +939,7 @@ HvHandleMovDebugRegister(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // Read guest cr4
     //
-    __vmx_vmread(VMCS_GUEST_CR4, &Cr4);
+    VmxVmread(VMCS_GUEST_CR4, &Cr4);
 
     if (ExitQualification.DebugRegister == 4 || ExitQualification.DebugRegister == 5)
     {
@@ -820,7 +976,7 @@ HvHandleMovDebugRegister(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // Read the DR7
     //
-    __vmx_vmread(VMCS_GUEST_DR7, &Dr7);
+    VmxVmread(VMCS_GUEST_DR7, &Dr7);
 
     if (Dr7.GeneralDetect)
     {
@@ -833,7 +989,7 @@ HvHandleMovDebugRegister(VIRTUAL_MACHINE_STATE * VCpu)
 
         Dr7.GeneralDetect = FALSE;
 
-        __vmx_vmwrite(VMCS_GUEST_DR7, Dr7.AsUInt);
+        VmxVmwrite(VMCS_GUEST_DR7, Dr7.AsUInt);
 
         EventInjectDebugBreakpoint();
 
@@ -935,8 +1091,8 @@ HvSetNmiExiting(BOOLEAN Set)
     //
     // Read the previous flags
     //
-    __vmx_vmread(VMCS_CTRL_PIN_BASED_VM_EXECUTION_CONTROLS, &PinBasedControls);
-    __vmx_vmread(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, &VmExitControls);
+    VmxVmread(VMCS_CTRL_PIN_BASED_VM_EXECUTION_CONTROLS, &PinBasedControls);
+    VmxVmread(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, &VmExitControls);
 
     if (Set)
     {
@@ -952,8 +1108,8 @@ HvSetNmiExiting(BOOLEAN Set)
     //
     // Set the new value
     //
-    __vmx_vmwrite(VMCS_CTRL_PIN_BASED_VM_EXECUTION_CONTROLS, PinBasedControls);
-    __vmx_vmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, VmExitControls);
+    VmxVmwrite(VMCS_CTRL_PIN_BASED_VM_EXECUTION_CONTROLS, PinBasedControls);
+    VmxVmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, VmExitControls);
 }
 
 /**
@@ -970,7 +1126,7 @@ HvSetVmxPreemptionTimerExiting(BOOLEAN Set)
     //
     // Read the previous flags
     //
-    __vmx_vmread(VMCS_CTRL_PIN_BASED_VM_EXECUTION_CONTROLS, &PinBasedControls);
+    VmxVmread(VMCS_CTRL_PIN_BASED_VM_EXECUTION_CONTROLS, &PinBasedControls);
 
     if (Set)
     {
@@ -984,7 +1140,7 @@ HvSetVmxPreemptionTimerExiting(BOOLEAN Set)
     //
     // Set the new value
     //
-    __vmx_vmwrite(VMCS_CTRL_PIN_BASED_VM_EXECUTION_CONTROLS, PinBasedControls);
+    VmxVmwrite(VMCS_CTRL_PIN_BASED_VM_EXECUTION_CONTROLS, PinBasedControls);
 }
 
 /**
@@ -1061,7 +1217,7 @@ HvEnableAndCheckForPreviousExternalInterrupts(VIRTUAL_MACHINE_STATE * VCpu)
         //
         // Check if there is at least an interrupt that needs to be delivered
         //
-        if (VCpu->PendingExternalInterrupts[0] != NULL)
+        if (IdtEmulationIsAnyExternalInterruptPending(VCpu))
         {
             //
             // Enable Interrupt-window exiting.
@@ -1113,7 +1269,7 @@ HvGetCsSelector()
     //
     UINT64 CsSel = NULL;
 
-    __vmx_vmread(VMCS_GUEST_CS_SELECTOR, &CsSel);
+    VmxVmread(VMCS_GUEST_CS_SELECTOR, &CsSel);
 
     return CsSel & 0xffff;
 }
@@ -1128,7 +1284,7 @@ HvGetRflags()
 {
     UINT64 Rflags = NULL;
 
-    __vmx_vmread(VMCS_GUEST_RFLAGS, &Rflags);
+    VmxVmread(VMCS_GUEST_RFLAGS, &Rflags);
 
     return Rflags;
 }
@@ -1142,7 +1298,7 @@ HvGetRflags()
 VOID
 HvSetRflags(UINT64 Rflags)
 {
-    __vmx_vmwrite(VMCS_GUEST_RFLAGS, Rflags);
+    VmxVmwrite(VMCS_GUEST_RFLAGS, Rflags);
 }
 
 /**
@@ -1155,7 +1311,7 @@ HvGetRip()
 {
     UINT64 Rip = NULL;
 
-    __vmx_vmread(VMCS_GUEST_RIP, &Rip);
+    VmxVmread(VMCS_GUEST_RIP, &Rip);
 
     return Rip;
 }
@@ -1169,7 +1325,7 @@ HvGetRip()
 VOID
 HvSetRip(UINT64 Rip)
 {
-    __vmx_vmwrite(VMCS_GUEST_RIP, Rip);
+    VmxVmwrite(VMCS_GUEST_RIP, Rip);
 }
 
 /**
@@ -1182,7 +1338,7 @@ HvGetInterruptibilityState()
 {
     UINT64 InterruptibilityState = NULL;
 
-    __vmx_vmread(VMCS_GUEST_INTERRUPTIBILITY_STATE, &InterruptibilityState);
+    VmxVmread(VMCS_GUEST_INTERRUPTIBILITY_STATE, &InterruptibilityState);
 
     return InterruptibilityState;
 }
@@ -1211,7 +1367,7 @@ HvClearSteppingBits(UINT32 Interruptibility)
 VOID
 HvSetInterruptibilityState(UINT64 InterruptibilityState)
 {
-    __vmx_vmwrite(VMCS_GUEST_INTERRUPTIBILITY_STATE, InterruptibilityState);
+    VmxVmwrite(VMCS_GUEST_INTERRUPTIBILITY_STATE, InterruptibilityState);
 }
 
 /**
@@ -1227,7 +1383,7 @@ HvInjectPendingExternalInterrupts(VIRTUAL_MACHINE_STATE * VCpu)
     //
     // Check if there is at least an interrupt that needs to be delivered
     //
-    if (VCpu->PendingExternalInterrupts[0] != NULL)
+    if (IdtEmulationIsAnyExternalInterruptPending(VCpu))
     {
         //
         // Enable Interrupt-window exiting.
@@ -1298,6 +1454,8 @@ BOOLEAN
 HvInitVmm(VMM_CALLBACKS * VmmCallbacks)
 {
     ULONG   ProcessorCount;
+    UINT64  StartCounter;
+    UINT64  PhaseCounter;
     BOOLEAN Result = FALSE;
 
     //
@@ -1305,11 +1463,32 @@ HvInitVmm(VMM_CALLBACKS * VmmCallbacks)
     //
     RtlCopyMemory(&g_Callbacks, VmmCallbacks, sizeof(VMM_CALLBACKS));
 
+    //
+    // The duration of each phase is saved to be queried after loading
+    //
+    RtlZeroMemory(&g_VmmInitializationTimings, sizeof(DEBUGGER_VMM_INITIALIZATION_TIMINGS));
+
+    StartCounter = KeQueryPerformanceCounter(NULL).QuadPart;
+    PhaseCounter = StartCounter;
+
     //
     // Check and define compatibility checks and processor constraints
     //
     CompatibilityCheckPerformChecks();
 
+    //
+    // Use the enlightened VMCS if we're nested under Hyper-V
+    //
+    EvmcsInitialize();
+
+    //
+    // Initialize the table of CPUID leaves
+    //
+    CpuidHandlerInitialize();
+
+    g_VmmInitializationTimings.CompatibilityChecks = HvGetElapsedMicroseconds(PhaseCounter);
+    PhaseCounter                                   = KeQueryPerformanceCounter(NULL).QuadPart;
+
     //
     // we allocate virtual machine here because
     // we want to use its state (vmx-root or vmx non-root) in logs
@@ -1321,11 +1500,15 @@ HvInitVmm(VMM_CALLBACKS * VmmCallbacks)
         return FALSE;
     }
 
+    g_VmmInitializationTimings.GuestStateAllocation = HvGetElapsedMicroseconds(PhaseCounter);
+
     //
     // We have a zeroed guest state
     //
     ProcessorCount = KeQueryActiveProcessorCount(0);
 
+    g_VmmInitializationTimings.CountOfCores = ProcessorCount;
+
     //
     // Set the core's id and initialize memory mapper
     //
@@ -1337,17 +1520,52 @@ HvInitVmm(VMM_CALLBACKS * VmmCallbacks)
     //
     // Initialize memory mapper
     //
+    PhaseCounter = KeQueryPerformanceCounter(NULL).QuadPart;
+
     MemoryMapperInitialize();
 
+    g_VmmInitializationTimings.MemoryMapper = HvGetElapsedMicroseconds(PhaseCounter);
+
     //
     // Make sure that transparent-mode is disabled
     //
-    g_TransparentMode = FALSE;
+    g_TransparentMode              = FALSE;
+    g_TransparentModeTscOffsetting = FALSE;
+
+    //
+    // Decide about the fast-path of vm-exits based on the initial state
+    //
+    VmexitFastPathUpdate();
 
     //
     // Initializes VMX
     //
-    return VmxInitialize();
+    Result = VmxInitialize();
+
+    g_VmmInitializationTimings.Total = HvGetElapsedMicroseconds(StartCounter);
+
+    LogDebugInfo("The hypervisor is initialized on %d cores in %lld microseconds",
+                 ProcessorCount,
+                 g_VmmInitializationTimings.Total);
+
+    return Result;
+}
+
+/**
+ * @brief Get the elapsed time since a value of the performance counter
+ * @param StartCounter
+ *
+ * @return UINT64 The elapsed time in microseconds
+ */
+UINT64
+HvGetElapsedMicroseconds(UINT64 StartCounter)
+{
+    LARGE_INTEGER Frequency;
+    LARGE_INTEGER Counter;
+
+    Counter = KeQueryPerformanceCounter(&Frequency);
+
+    return ((Counter.QuadPart - StartCounter) * 1000000) / Frequency.QuadPart;
 }
 
 /**
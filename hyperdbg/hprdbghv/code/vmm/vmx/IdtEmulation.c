@@ -32,13 +32,13 @@ IdtEmulationHandlePageFaults(_Inout_ VIRTUAL_MACHINE_STATE *   VCpu,
     //
     PAGE_FAULT_ERROR_CODE PageFaultCode = {0};
 
-    __vmx_vmread(VMCS_VMEXIT_INTERRUPTION_ERROR_CODE, &PageFaultCode);
+    VmxVmread(VMCS_VMEXIT_INTERRUPTION_ERROR_CODE, &PageFaultCode);
 
     if (Address == NULL)
     {
         UINT64 PageFaultAddress = 0;
 
-        __vmx_vmread(VMCS_EXIT_QUALIFICATION, &PageFaultAddress);
+        VmxVmread(VMCS_EXIT_QUALIFICATION, &PageFaultAddress);
 
         //
         // Cr2 is used as the page-fault address
@@ -66,7 +66,7 @@ IdtEmulationHandlePageFaults(_Inout_ VIRTUAL_MACHINE_STATE *   VCpu,
     //
     // Re-inject the interrupt/exception
     //
-    __vmx_vmwrite(VMCS_CTRL_VMENTRY_INTERRUPTION_INFORMATION_FIELD, InterruptExit.AsUInt);
+    VmxVmwrite(VMCS_CTRL_VMENTRY_INTERRUPTION_INFORMATION_FIELD, InterruptExit.AsUInt);
 
     //
     // re-write error code (if any)
@@ -76,7 +76,7 @@ IdtEmulationHandlePageFaults(_Inout_ VIRTUAL_MACHINE_STATE *   VCpu,
         //
         // Write the error code
         //
-        __vmx_vmwrite(VMCS_CTRL_VMENTRY_EXCEPTION_ERROR_CODE, ErrorCode);
+        VmxVmwrite(VMCS_CTRL_VMENTRY_EXCEPTION_ERROR_CODE, ErrorCode);
     }
 }
 
@@ -147,7 +147,7 @@ IdtEmulationHandleExceptionAndNmi(_Inout_ VIRTUAL_MACHINE_STATE *   VCpu,
         //
         // Read the error code
         //
-        __vmx_vmread(VMCS_VMEXIT_INTERRUPTION_ERROR_CODE, &ErrorCode);
+        VmxVmread(VMCS_VMEXIT_INTERRUPTION_ERROR_CODE, &ErrorCode);
 
         //
         // Handle page-faults
@@ -213,9 +213,11 @@ IdtEmulationHandleExceptionAndNmi(_Inout_ VIRTUAL_MACHINE_STATE *   VCpu,
 }
 
 /**
- * @brief if the guest is not interruptible, then we save the details of each
+ * @brief if the guest is not interruptible, then we save the vector of each
  * interrupt so we can re-inject them to the guest whenever the interrupt window
  * is open
+ * @details the vectors are kept in a bitmap (like the IRR of the local APIC), so
+ * no interrupt is dropped, the same vector is pending at most once
  *
  * @param VCpu The virtual processor's state
  * @param InterruptExit interrupt info from vm-exit
@@ -225,29 +227,69 @@ BOOLEAN
 IdtEmulationInjectInterruptWhenInterruptWindowIsOpen(_Inout_ VIRTUAL_MACHINE_STATE *   VCpu,
                                                      _In_ VMEXIT_INTERRUPT_INFORMATION InterruptExit)
 {
-    BOOLEAN FoundAPlaceForFutureInjection = FALSE;
-
     //
     // We can't inject interrupt because the guest's state is not interruptible
     // we have to queue it an re-inject it when the interrupt window is opened !
     //
-    for (size_t i = 0; i < PENDING_INTERRUPTS_BUFFER_CAPACITY; i++)
+    VCpu->PendingExternalInterrupts[InterruptExit.Vector / 64] |= 1ull << (InterruptExit.Vector % 64);
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether there is any external interrupt in the pending state
+ *
+ * @param VCpu The virtual processor's state
+ * @return BOOLEAN
+ */
+BOOLEAN
+IdtEmulationIsAnyExternalInterruptPending(_In_ VIRTUAL_MACHINE_STATE * VCpu)
+{
+    for (UINT32 i = 0; i < PENDING_INTERRUPTS_BITMAP_CAPACITY; i++)
     {
-        //
-        // Find an empty space
-        //
-        if (VCpu->PendingExternalInterrupts[i] == NULL)
+        if (VCpu->PendingExternalInterrupts[i] != NULL)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Take the pending external interrupt with the highest priority
+ * @details the priority of interrupts in the local APIC is determined by
+ * their vector (the higher vector has the higher priority)
+ *
+ * @param VCpu The virtual processor's state
+ * @param InterruptExit The interrupt to inject
+ * @return BOOLEAN FALSE if there is no pending interrupt
+ */
+static BOOLEAN
+IdtEmulationTakePendingExternalInterrupt(_Inout_ VIRTUAL_MACHINE_STATE *     VCpu,
+                                         _Out_ VMEXIT_INTERRUPT_INFORMATION * InterruptExit)
+{
+    ULONG Index;
+
+    for (INT32 i = PENDING_INTERRUPTS_BITMAP_CAPACITY - 1; i >= 0; i--)
+    {
+        if (_BitScanReverse64(&Index, VCpu->PendingExternalInterrupts[i]))
         {
             //
-            // Save it for future re-injection (interrupt-window exiting)
+            // Free the vector
             //
-            VCpu->PendingExternalInterrupts[i] = InterruptExit.AsUInt;
-            FoundAPlaceForFutureInjection      = TRUE;
-            break;
+            VCpu->PendingExternalInterrupts[i] &= ~(1ull << Index);
+
+            InterruptExit->AsUInt           = 0;
+            InterruptExit->Vector           = (UINT32)(i * 64 + Index);
+            InterruptExit->InterruptionType = INTERRUPT_TYPE_EXTERNAL_INTERRUPT;
+            InterruptExit->Valid            = TRUE;
+
+            return TRUE;
         }
     }
 
-    return FoundAPlaceForFutureInjection;
+    return FALSE;
 }
 
 /**
@@ -300,8 +342,8 @@ IdtEmulationHandleExternalInterrupt(_Inout_ VIRTUAL_MACHINE_STATE *   VCpu,
 
     else if (InterruptExit.Valid && InterruptExit.InterruptionType == INTERRUPT_TYPE_EXTERNAL_INTERRUPT)
     {
-        __vmx_vmread(VMCS_GUEST_RFLAGS, &GuestRflags);
-        __vmx_vmread(VMCS_GUEST_INTERRUPTIBILITY_STATE, &InterruptibilityState);
+        VmxVmread(VMCS_GUEST_RFLAGS, &GuestRflags);
+        VmxVmread(VMCS_GUEST_INTERRUPTIBILITY_STATE, &InterruptibilityState);
 
         //
         // External interrupts cannot be injected into the
@@ -370,30 +412,9 @@ IdtEmulationHandleInterruptWindowExiting(_Inout_ VIRTUAL_MACHINE_STATE * VCpu)
     ULONG                        ErrorCode     = 0;
 
     //
-    // Find the pending interrupt to inject
+    // Find the pending interrupt to inject (the highest priority)
     //
-
-    for (size_t i = 0; i < PENDING_INTERRUPTS_BUFFER_CAPACITY; i++)
-    {
-        //
-        // Find an empty space
-        //
-        if (VCpu->PendingExternalInterrupts[i] != NULL)
-        {
-            //
-            // Save it for re-injection (interrupt-window exiting)
-            //
-            InterruptExit.AsUInt = VCpu->PendingExternalInterrupts[i];
-
-            //
-            // Free the entry
-            //
-            VCpu->PendingExternalInterrupts[i] = NULL;
-            break;
-        }
-    }
-
-    if (InterruptExit.AsUInt == 0)
+    if (!IdtEmulationTakePendingExternalInterrupt(VCpu, &InterruptExit))
     {
         //
         // Nothing left in pending state, let's disable the interrupt window exiting
@@ -405,7 +426,7 @@ IdtEmulationHandleInterruptWindowExiting(_Inout_ VIRTUAL_MACHINE_STATE * VCpu)
         //
         // Re-inject the interrupt/exception
         //
-        __vmx_vmwrite(VMCS_CTRL_VMENTRY_INTERRUPTION_INFORMATION_FIELD, InterruptExit.AsUInt);
+        VmxVmwrite(VMCS_CTRL_VMENTRY_INTERRUPTION_INFORMATION_FIELD, InterruptExit.AsUInt);
 
         //
         // re-write error code (if any)
@@ -415,12 +436,12 @@ IdtEmulationHandleInterruptWindowExiting(_Inout_ VIRTUAL_MACHINE_STATE * VCpu)
             //
             // Read the error code
             //
-            __vmx_vmread(VMCS_VMEXIT_INTERRUPTION_ERROR_CODE, &ErrorCode);
+            VmxVmread(VMCS_VMEXIT_INTERRUPTION_ERROR_CODE, &ErrorCode);
 
             //
             // Write the error code
             //
-            __vmx_vmwrite(VMCS_CTRL_VMENTRY_EXCEPTION_ERROR_CODE, ErrorCode);
+            VmxVmwrite(VMCS_CTRL_VMENTRY_EXCEPTION_ERROR_CODE, ErrorCode);
         }
     }
 
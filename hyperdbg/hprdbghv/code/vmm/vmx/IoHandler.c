@@ -227,6 +227,43 @@ IoHandleSetIoBitmap(VIRTUAL_MACHINE_STATE * VCpu, UINT64 Port)
         return FALSE;
     }
 
+    //
+    // Hyper-V should reload the (enlightened) I/O bitmaps
+    //
+    EvmcsMarkFieldsDirty(VCpu, HV_VMX_ENLIGHTENED_CLEAN_FIELD_IO_BITMAP);
+
+    return TRUE;
+}
+
+/**
+ * @brief Unset bits in I/O Bitmap
+ *
+ * @param VCpu The virtual processor's state
+ * @param Port Port
+ *
+ * @return BOOLEAN Returns true if the I/O Bitmap is succcessfully unset or false if not unset
+ */
+BOOLEAN
+IoHandleUnsetIoBitmap(VIRTUAL_MACHINE_STATE * VCpu, UINT64 Port)
+{
+    if (Port <= 0x7FFF)
+    {
+        ClearBit(Port, VCpu->IoBitmapVirtualAddressA);
+    }
+    else if ((0x8000 <= Port) && (Port <= 0xFFFF))
+    {
+        ClearBit(Port - 0x8000, VCpu->IoBitmapVirtualAddressB);
+    }
+    else
+    {
+        return FALSE;
+    }
+
+    //
+    // Hyper-V should reload the (enlightened) I/O bitmaps
+    //
+    EvmcsMarkFieldsDirty(VCpu, HV_VMX_ENLIGHTENED_CLEAN_FIELD_IO_BITMAP);
+
     return TRUE;
 }
 
@@ -248,6 +285,11 @@ IoHandlePerformIoBitmapChange(VIRTUAL_MACHINE_STATE * VCpu, UINT64 Port)
         //
         memset(VCpu->IoBitmapVirtualAddressA, 0xFF, PAGE_SIZE);
         memset(VCpu->IoBitmapVirtualAddressB, 0xFF, PAGE_SIZE);
+
+        //
+        // Hyper-V should reload the (enlightened) I/O bitmaps
+        //
+        EvmcsMarkFieldsDirty(VCpu, HV_VMX_ENLIGHTENED_CLEAN_FIELD_IO_BITMAP);
     }
     else
     {
@@ -273,4 +315,14 @@ IoHandlePerformIoBitmapReset(VIRTUAL_MACHINE_STATE * VCpu)
     //
     memset(VCpu->IoBitmapVirtualAddressA, 0x0, PAGE_SIZE);
     memset(VCpu->IoBitmapVirtualAddressB, 0x0, PAGE_SIZE);
+
+    //
+    // Hyper-V should reload the (enlightened) I/O bitmaps
+    //
+    EvmcsMarkFieldsDirty(VCpu, HV_VMX_ENLIGHTENED_CLEAN_FIELD_IO_BITMAP);
+
+    //
+    // And no port is referenced anymore
+    //
+    BitmapOwnershipReset(VCpu, BITMAP_OWNERSHIP_RESOURCE_IO_PORT, 0);
 }
@@ -21,7 +21,7 @@
 VOID
 SetGuestCsSel(PVMX_SEGMENT_SELECTOR Cs)
 {
-    __vmx_vmwrite(VMCS_GUEST_CS_SELECTOR, Cs->Selector);
+    VmxVmwrite(VMCS_GUEST_CS_SELECTOR, Cs->Selector);
 }
 
 /**
@@ -34,10 +34,10 @@ SetGuestCsSel(PVMX_SEGMENT_SELECTOR Cs)
 VOID
 SetGuestCs(PVMX_SEGMENT_SELECTOR Cs)
 {
-    __vmx_vmwrite(VMCS_GUEST_CS_BASE, Cs->Base);
-    __vmx_vmwrite(VMCS_GUEST_CS_LIMIT, Cs->Limit);
-    __vmx_vmwrite(VMCS_GUEST_CS_ACCESS_RIGHTS, Cs->Attributes.AsUInt);
-    __vmx_vmwrite(VMCS_GUEST_CS_SELECTOR, Cs->Selector);
+    VmxVmwrite(VMCS_GUEST_CS_BASE, Cs->Base);
+    VmxVmwrite(VMCS_GUEST_CS_LIMIT, Cs->Limit);
+    VmxVmwrite(VMCS_GUEST_CS_ACCESS_RIGHTS, Cs->Attributes.AsUInt);
+    VmxVmwrite(VMCS_GUEST_CS_SELECTOR, Cs->Selector);
 }
 
 /**
@@ -50,10 +50,10 @@ GetGuestCs()
 {
     VMX_SEGMENT_SELECTOR Cs;
 
-    __vmx_vmread(VMCS_GUEST_CS_BASE, &Cs.Base);
-    __vmx_vmread(VMCS_GUEST_CS_LIMIT, &Cs.Limit);
-    __vmx_vmread(VMCS_GUEST_CS_ACCESS_RIGHTS, &Cs.Attributes.AsUInt);
-    __vmx_vmread(VMCS_GUEST_CS_SELECTOR, &Cs.Selector);
+    VmxVmread(VMCS_GUEST_CS_BASE, &Cs.Base);
+    VmxVmread(VMCS_GUEST_CS_LIMIT, &Cs.Limit);
+    VmxVmread(VMCS_GUEST_CS_ACCESS_RIGHTS, &Cs.Attributes.AsUInt);
+    VmxVmread(VMCS_GUEST_CS_SELECTOR, &Cs.Selector);
 
     return Cs;
 }
@@ -67,7 +67,7 @@ GetGuestCs()
 VOID
 SetGuestSsSel(PVMX_SEGMENT_SELECTOR Ss)
 {
-    __vmx_vmwrite(VMCS_GUEST_SS_SELECTOR, Ss->Selector);
+    VmxVmwrite(VMCS_GUEST_SS_SELECTOR, Ss->Selector);
 }
 
 /**
@@ -79,10 +79,10 @@ SetGuestSsSel(PVMX_SEGMENT_SELECTOR Ss)
 VOID
 SetGuestSs(PVMX_SEGMENT_SELECTOR Ss)
 {
-    __vmx_vmwrite(VMCS_GUEST_SS_BASE, Ss->Base);
-    __vmx_vmwrite(VMCS_GUEST_SS_LIMIT, Ss->Limit);
-    __vmx_vmwrite(VMCS_GUEST_SS_ACCESS_RIGHTS, Ss->Attributes.AsUInt);
-    __vmx_vmwrite(VMCS_GUEST_SS_SELECTOR, Ss->Selector);
+    VmxVmwrite(VMCS_GUEST_SS_BASE, Ss->Base);
+    VmxVmwrite(VMCS_GUEST_SS_LIMIT, Ss->Limit);
+    VmxVmwrite(VMCS_GUEST_SS_ACCESS_RIGHTS, Ss->Attributes.AsUInt);
+    VmxVmwrite(VMCS_GUEST_SS_SELECTOR, Ss->Selector);
 }
 
 /**
@@ -95,10 +95,10 @@ GetGuestSs()
 {
     VMX_SEGMENT_SELECTOR Ss;
 
-    __vmx_vmread(VMCS_GUEST_SS_BASE, &Ss.Base);
-    __vmx_vmread(VMCS_GUEST_SS_LIMIT, &Ss.Limit);
-    __vmx_vmread(VMCS_GUEST_SS_ACCESS_RIGHTS, &Ss.Attributes.AsUInt);
-    __vmx_vmread(VMCS_GUEST_SS_SELECTOR, &Ss.Selector);
+    VmxVmread(VMCS_GUEST_SS_BASE, &Ss.Base);
+    VmxVmread(VMCS_GUEST_SS_LIMIT, &Ss.Limit);
+    VmxVmread(VMCS_GUEST_SS_ACCESS_RIGHTS, &Ss.Attributes.AsUInt);
+    VmxVmread(VMCS_GUEST_SS_SELECTOR, &Ss.Selector);
 
     return Ss;
 }
@@ -112,7 +112,7 @@ GetGuestSs()
 VOID
 SetGuestDsSel(PVMX_SEGMENT_SELECTOR Ds)
 {
-    __vmx_vmwrite(VMCS_GUEST_DS_SELECTOR, Ds->Selector);
+    VmxVmwrite(VMCS_GUEST_DS_SELECTOR, Ds->Selector);
 }
 
 /**
@@ -124,10 +124,10 @@ SetGuestDsSel(PVMX_SEGMENT_SELECTOR Ds)
 VOID
 SetGuestDs(PVMX_SEGMENT_SELECTOR Ds)
 {
-    __vmx_vmwrite(VMCS_GUEST_DS_BASE, Ds->Base);
-    __vmx_vmwrite(VMCS_GUEST_DS_LIMIT, Ds->Limit);
-    __vmx_vmwrite(VMCS_GUEST_DS_ACCESS_RIGHTS, Ds->Attributes.AsUInt);
-    __vmx_vmwrite(VMCS_GUEST_DS_SELECTOR, Ds->Selector);
+    VmxVmwrite(VMCS_GUEST_DS_BASE, Ds->Base);
+    VmxVmwrite(VMCS_GUEST_DS_LIMIT, Ds->Limit);
+    VmxVmwrite(VMCS_GUEST_DS_ACCESS_RIGHTS, Ds->Attributes.AsUInt);
+    VmxVmwrite(VMCS_GUEST_DS_SELECTOR, Ds->Selector);
 }
 
 /**
@@ -140,10 +140,10 @@ GetGuestDs()
 {
     VMX_SEGMENT_SELECTOR Ds;
 
-    __vmx_vmread(VMCS_GUEST_DS_BASE, &Ds.Base);
-    __vmx_vmread(VMCS_GUEST_DS_LIMIT, &Ds.Limit);
-    __vmx_vmread(VMCS_GUEST_DS_ACCESS_RIGHTS, &Ds.Attributes.AsUInt);
-    __vmx_vmread(VMCS_GUEST_DS_SELECTOR, &Ds.Selector);
+    VmxVmread(VMCS_GUEST_DS_BASE, &Ds.Base);
+    VmxVmread(VMCS_GUEST_DS_LIMIT, &Ds.Limit);
+    VmxVmread(VMCS_GUEST_DS_ACCESS_RIGHTS, &Ds.Attributes.AsUInt);
+    VmxVmread(VMCS_GUEST_DS_SELECTOR, &Ds.Selector);
 
     return Ds;
 }
@@ -157,7 +157,7 @@ GetGuestDs()
 VOID
 SetGuestFsSel(PVMX_SEGMENT_SELECTOR Fs)
 {
-    __vmx_vmwrite(VMCS_GUEST_FS_SELECTOR, Fs->Selector);
+    VmxVmwrite(VMCS_GUEST_FS_SELECTOR, Fs->Selector);
 }
 
 /**
@@ -169,10 +169,10 @@ SetGuestFsSel(PVMX_SEGMENT_SELECTOR Fs)
 VOID
 SetGuestFs(PVMX_SEGMENT_SELECTOR Fs)
 {
-    __vmx_vmwrite(VMCS_GUEST_FS_BASE, Fs->Base);
-    __vmx_vmwrite(VMCS_GUEST_FS_LIMIT, Fs->Limit);
-    __vmx_vmwrite(VMCS_GUEST_FS_ACCESS_RIGHTS, Fs->Attributes.AsUInt);
-    __vmx_vmwrite(VMCS_GUEST_FS_SELECTOR, Fs->Selector);
+    VmxVmwrite(VMCS_GUEST_FS_BASE, Fs->Base);
+    VmxVmwrite(VMCS_GUEST_FS_LIMIT, Fs->Limit);
+    VmxVmwrite(VMCS_GUEST_FS_ACCESS_RIGHTS, Fs->Attributes.AsUInt);
+    VmxVmwrite(VMCS_GUEST_FS_SELECTOR, Fs->Selector);
 }
 
 /**
@@ -185,10 +185,10 @@ GetGuestFs()
 {
     VMX_SEGMENT_SELECTOR Fs;
 
-    __vmx_vmread(VMCS_GUEST_FS_BASE, &Fs.Base);
-    __vmx_vmread(VMCS_GUEST_FS_LIMIT, &Fs.Limit);
-    __vmx_vmread(VMCS_GUEST_FS_ACCESS_RIGHTS, &Fs.Attributes.AsUInt);
-    __vmx_vmread(VMCS_GUEST_FS_SELECTOR, &Fs.Selector);
+    VmxVmread(VMCS_GUEST_FS_BASE, &Fs.Base);
+    VmxVmread(VMCS_GUEST_FS_LIMIT, &Fs.Limit);
+    VmxVmread(VMCS_GUEST_FS_ACCESS_RIGHTS, &Fs.Attributes.AsUInt);
+    VmxVmread(VMCS_GUEST_FS_SELECTOR, &Fs.Selector);
 
     return Fs;
 }
@@ -202,7 +202,7 @@ GetGuestFs()
 VOID
 SetGuestGsSel(PVMX_SEGMENT_SELECTOR Gs)
 {
-    __vmx_vmwrite(VMCS_GUEST_GS_SELECTOR, Gs->Selector);
+    VmxVmwrite(VMCS_GUEST_GS_SELECTOR, Gs->Selector);
 }
 
 /**
@@ -214,10 +214,10 @@ SetGuestGsSel(PVMX_SEGMENT_SELECTOR Gs)
 VOID
 SetGuestGs(PVMX_SEGMENT_SELECTOR Gs)
 {
-    __vmx_vmwrite(VMCS_GUEST_GS_BASE, Gs->Base);
-    __vmx_vmwrite(VMCS_GUEST_GS_LIMIT, Gs->Limit);
-    __vmx_vmwrite(VMCS_GUEST_GS_ACCESS_RIGHTS, Gs->Attributes.AsUInt);
-    __vmx_vmwrite(VMCS_GUEST_GS_SELECTOR, Gs->Selector);
+    VmxVmwrite(VMCS_GUEST_GS_BASE, Gs->Base);
+    VmxVmwrite(VMCS_GUEST_GS_LIMIT, Gs->Limit);
+    VmxVmwrite(VMCS_GUEST_GS_ACCESS_RIGHTS, Gs->Attributes.AsUInt);
+    VmxVmwrite(VMCS_GUEST_GS_SELECTOR, Gs->Selector);
 }
 
 /**
@@ -230,10 +230,10 @@ GetGuestGs()
 {
     VMX_SEGMENT_SELECTOR Gs;
 
-    __vmx_vmread(VMCS_GUEST_GS_BASE, &Gs.Base);
-    __vmx_vmread(VMCS_GUEST_GS_LIMIT, &Gs.Limit);
-    __vmx_vmread(VMCS_GUEST_GS_ACCESS_RIGHTS, &Gs.Attributes.AsUInt);
-    __vmx_vmread(VMCS_GUEST_GS_SELECTOR, &Gs.Selector);
+    VmxVmread(VMCS_GUEST_GS_BASE, &Gs.Base);
+    VmxVmread(VMCS_GUEST_GS_LIMIT, &Gs.Limit);
+    VmxVmread(VMCS_GUEST_GS_ACCESS_RIGHTS, &Gs.Attributes.AsUInt);
+    VmxVmread(VMCS_GUEST_GS_SELECTOR, &Gs.Selector);
 
     return Gs;
 }
@@ -247,7 +247,7 @@ GetGuestGs()
 VOID
 SetGuestEsSel(PVMX_SEGMENT_SELECTOR Es)
 {
-    __vmx_vmwrite(VMCS_GUEST_ES_SELECTOR, Es->Selector);
+    VmxVmwrite(VMCS_GUEST_ES_SELECTOR, Es->Selector);
 }
 
 /**
@@ -259,10 +259,10 @@ SetGuestEsSel(PVMX_SEGMENT_SELECTOR Es)
 VOID
 SetGuestEs(PVMX_SEGMENT_SELECTOR Es)
 {
-    __vmx_vmwrite(VMCS_GUEST_ES_BASE, Es->Base);
-    __vmx_vmwrite(VMCS_GUEST_ES_LIMIT, Es->Limit);
-    __vmx_vmwrite(VMCS_GUEST_ES_ACCESS_RIGHTS, Es->Attributes.AsUInt);
-    __vmx_vmwrite(VMCS_GUEST_ES_SELECTOR, Es->Selector);
+    VmxVmwrite(VMCS_GUEST_ES_BASE, Es->Base);
+    VmxVmwrite(VMCS_GUEST_ES_LIMIT, Es->Limit);
+    VmxVmwrite(VMCS_GUEST_ES_ACCESS_RIGHTS, Es->Attributes.AsUInt);
+    VmxVmwrite(VMCS_GUEST_ES_SELECTOR, Es->Selector);
 }
 
 /**
@@ -275,10 +275,10 @@ GetGuestEs()
 {
     VMX_SEGMENT_SELECTOR Es;
 
-    __vmx_vmread(VMCS_GUEST_ES_BASE, &Es.Base);
-    __vmx_vmread(VMCS_GUEST_ES_LIMIT, &Es.Limit);
-    __vmx_vmread(VMCS_GUEST_ES_ACCESS_RIGHTS, &Es.Attributes.AsUInt);
-    __vmx_vmread(VMCS_GUEST_ES_SELECTOR, &Es.Selector);
+    VmxVmread(VMCS_GUEST_ES_BASE, &Es.Base);
+    VmxVmread(VMCS_GUEST_ES_LIMIT, &Es.Limit);
+    VmxVmread(VMCS_GUEST_ES_ACCESS_RIGHTS, &Es.Attributes.AsUInt);
+    VmxVmread(VMCS_GUEST_ES_SELECTOR, &Es.Selector);
 
     return Es;
 }
@@ -292,7 +292,7 @@ GetGuestEs()
 VOID
 SetGuestIdtr(UINT64 Idtr)
 {
-    __vmx_vmwrite(VMCS_GUEST_IDTR_BASE, Idtr);
+    VmxVmwrite(VMCS_GUEST_IDTR_BASE, Idtr);
 }
 
 /**
@@ -305,7 +305,7 @@ GetGuestIdtr()
 {
     UINT64 Idtr;
 
-    __vmx_vmread(VMCS_GUEST_IDTR_BASE, &Idtr);
+    VmxVmread(VMCS_GUEST_IDTR_BASE, &Idtr);
 
     return Idtr;
 }
@@ -319,7 +319,7 @@ GetGuestIdtr()
 VOID
 SetGuestLdtr(UINT64 Ldtr)
 {
-    __vmx_vmwrite(VMCS_GUEST_LDTR_BASE, Ldtr);
+    VmxVmwrite(VMCS_GUEST_LDTR_BASE, Ldtr);
 }
 
 /**
@@ -332,7 +332,7 @@ GetGuestLdtr()
 {
     UINT64 Ldtr;
 
-    __vmx_vmread(VMCS_GUEST_LDTR_BASE, &Ldtr);
+    VmxVmread(VMCS_GUEST_LDTR_BASE, &Ldtr);
 
     return Ldtr;
 }
@@ -346,7 +346,7 @@ GetGuestLdtr()
 VOID
 SetGuestGdtr(UINT64 Gdtr)
 {
-    __vmx_vmwrite(VMCS_GUEST_GDTR_BASE, Gdtr);
+    VmxVmwrite(VMCS_GUEST_GDTR_BASE, Gdtr);
 }
 
 /**
@@ -359,7 +359,7 @@ GetGuestGdtr()
 {
     UINT64 Gdtr;
 
-    __vmx_vmread(VMCS_GUEST_GDTR_BASE, &Gdtr);
+    VmxVmread(VMCS_GUEST_GDTR_BASE, &Gdtr);
 
     return Gdtr;
 }
@@ -371,7 +371,7 @@ GetGuestGdtr()
 VOID
 SetGuestTr(UINT64 Tr)
 {
-    __vmx_vmwrite(VMCS_GUEST_TR_BASE, Tr);
+    VmxVmwrite(VMCS_GUEST_TR_BASE, Tr);
 }
 
 /**
@@ -384,7 +384,7 @@ GetGuestTr()
 {
     UINT64 Tr;
 
-    __vmx_vmread(VMCS_GUEST_TR_BASE, &Tr);
+    VmxVmread(VMCS_GUEST_TR_BASE, &Tr);
 
     return Tr;
 }
@@ -397,7 +397,7 @@ GetGuestTr()
 VOID
 SetGuestRFlags(UINT64 RFlags)
 {
-    __vmx_vmwrite(VMCS_GUEST_RFLAGS, RFlags);
+    VmxVmwrite(VMCS_GUEST_RFLAGS, RFlags);
 }
 
 /**
@@ -409,7 +409,7 @@ UINT64
 GetGuestRFlags()
 {
     UINT64 RFlags;
-    __vmx_vmread(VMCS_GUEST_RFLAGS, &RFlags);
+    VmxVmread(VMCS_GUEST_RFLAGS, &RFlags);
     return RFlags;
 }
 
@@ -422,7 +422,7 @@ GetGuestRFlags()
 VOID
 SetGuestRIP(UINT64 RIP)
 {
-    __vmx_vmwrite(VMCS_GUEST_RIP, RIP);
+    VmxVmwrite(VMCS_GUEST_RIP, RIP);
 }
 
 /**
@@ -434,7 +434,7 @@ SetGuestRIP(UINT64 RIP)
 VOID
 SetGuestRSP(UINT64 RSP)
 {
-    __vmx_vmwrite(VMCS_GUEST_RSP, RSP);
+    VmxVmwrite(VMCS_GUEST_RSP, RSP);
 }
 
 /**
@@ -447,7 +447,7 @@ GetGuestRIP()
 {
     UINT64 RIP;
 
-    __vmx_vmread(VMCS_GUEST_RIP, &RIP);
+    VmxVmread(VMCS_GUEST_RIP, &RIP);
     return RIP;
 }
 
@@ -461,7 +461,7 @@ GetGuestCr0()
 {
     UINT64 Cr0;
 
-    __vmx_vmread(VMCS_GUEST_CR0, &Cr0);
+    VmxVmread(VMCS_GUEST_CR0, &Cr0);
     return Cr0;
 }
 
@@ -489,7 +489,7 @@ GetGuestCr3()
 {
     UINT64 Cr3;
 
-    __vmx_vmread(VMCS_GUEST_CR3, &Cr3);
+    VmxVmread(VMCS_GUEST_CR3, &Cr3);
     return Cr3;
 }
 
@@ -503,7 +503,7 @@ GetGuestCr4()
 {
     UINT64 Cr4;
 
-    __vmx_vmread(VMCS_GUEST_CR4, &Cr4);
+    VmxVmread(VMCS_GUEST_CR4, &Cr4);
     return Cr4;
 }
 
@@ -530,7 +530,7 @@ GetGuestCr8()
 VOID
 SetGuestCr0(UINT64 Cr0)
 {
-    __vmx_vmwrite(VMCS_GUEST_CR0, Cr0);
+    VmxVmwrite(VMCS_GUEST_CR0, Cr0);
 }
 
 /**
@@ -554,7 +554,7 @@ SetGuestCr2(UINT64 Cr2)
 VOID
 SetGuestCr3(UINT64 Cr3)
 {
-    __vmx_vmwrite(VMCS_GUEST_CR3, Cr3);
+    VmxVmwrite(VMCS_GUEST_CR3, Cr3);
 }
 
 /**
@@ -566,7 +566,7 @@ SetGuestCr3(UINT64 Cr3)
 VOID
 SetGuestCr4(UINT64 Cr4)
 {
-    __vmx_vmwrite(VMCS_GUEST_CR4, Cr4);
+    VmxVmwrite(VMCS_GUEST_CR4, Cr4);
 }
 
 /**
@@ -60,23 +60,23 @@ MsrHandleRdmsrVmexit(PGUEST_REGS GuestRegs)
         switch (TargetMsr)
         {
         case IA32_SYSENTER_CS:
-            __vmx_vmread(VMCS_GUEST_SYSENTER_CS, &Msr);
+            VmxVmread(VMCS_GUEST_SYSENTER_CS, &Msr);
             break;
 
         case IA32_SYSENTER_ESP:
-            __vmx_vmread(VMCS_GUEST_SYSENTER_ESP, &Msr);
+            VmxVmread(VMCS_GUEST_SYSENTER_ESP, &Msr);
             break;
 
         case IA32_SYSENTER_EIP:
-            __vmx_vmread(VMCS_GUEST_SYSENTER_EIP, &Msr);
+            VmxVmread(VMCS_GUEST_SYSENTER_EIP, &Msr);
             break;
 
         case IA32_GS_BASE:
-            __vmx_vmread(VMCS_GUEST_GS_BASE, &Msr);
+            VmxVmread(VMCS_GUEST_GS_BASE, &Msr);
             break;
 
         case IA32_FS_BASE:
-            __vmx_vmread(VMCS_GUEST_FS_BASE, &Msr);
+            VmxVmread(VMCS_GUEST_FS_BASE, &Msr);
             break;
 
         case HV_X64_MSR_GUEST_IDLE:
@@ -117,6 +117,32 @@ MsrHandleRdmsrVmexit(PGUEST_REGS GuestRegs)
                 return;
             }
 
+            //
+            // Check whether the controls of the LBRs are virtualized or not
+            //
+            if (LbrHandleRdmsr(&g_GuestState[KeGetCurrentProcessorNumber()], TargetMsr, &Msr.Flags))
+            {
+                break;
+            }
+
+            //
+            // Check whether the MSRs of the performance counters are virtualized
+            // by the PEBS sampling or not
+            //
+            if (PebsSamplingHandleRdmsr(&g_GuestState[KeGetCurrentProcessorNumber()], TargetMsr, &Msr.Flags))
+            {
+                break;
+            }
+
+            //
+            // Check whether the MSRs of the performance counters are virtualized
+            // by the counter of the retired instructions or not
+            //
+            if (InstructionCounterHandleRdmsr(&g_GuestState[KeGetCurrentProcessorNumber()], TargetMsr, &Msr.Flags))
+            {
+                break;
+            }
+
             //
             // Msr is valid
             //
@@ -224,27 +250,71 @@ MsrHandleWrmsrVmexit(PGUEST_REGS GuestRegs)
         switch (TargetMsr)
         {
         case IA32_SYSENTER_CS:
-            __vmx_vmwrite(VMCS_GUEST_SYSENTER_CS, Msr.Flags);
+            VmxVmwrite(VMCS_GUEST_SYSENTER_CS, Msr.Flags);
             break;
 
         case IA32_SYSENTER_ESP:
-            __vmx_vmwrite(VMCS_GUEST_SYSENTER_ESP, Msr.Flags);
+            VmxVmwrite(VMCS_GUEST_SYSENTER_ESP, Msr.Flags);
             break;
 
         case IA32_SYSENTER_EIP:
-            __vmx_vmwrite(VMCS_GUEST_SYSENTER_EIP, Msr.Flags);
+            VmxVmwrite(VMCS_GUEST_SYSENTER_EIP, Msr.Flags);
             break;
 
         case IA32_GS_BASE:
-            __vmx_vmwrite(VMCS_GUEST_GS_BASE, Msr.Flags);
+            VmxVmwrite(VMCS_GUEST_GS_BASE, Msr.Flags);
             break;
 
         case IA32_FS_BASE:
-            __vmx_vmwrite(VMCS_GUEST_FS_BASE, Msr.Flags);
+            VmxVmwrite(VMCS_GUEST_FS_BASE, Msr.Flags);
             break;
 
         default:
 
+            //
+            // Check whether the controls of the LBRs are virtualized or not
+            //
+            if (LbrHandleWrmsr(&g_GuestState[KeGetCurrentProcessorNumber()], TargetMsr, Msr.Flags))
+            {
+                break;
+            }
+
+            //
+            // Check whether the MSRs of the performance counters are virtualized
+            // by the PEBS sampling or not
+            //
+            if (PebsSamplingHandleWrmsr(&g_GuestState[KeGetCurrentProcessorNumber()], TargetMsr, Msr.Flags))
+            {
+                break;
+            }
+
+            //
+            // Check whether the MSRs of the performance counters are virtualized
+            // by the counter of the retired instructions or not
+            //
+            if (InstructionCounterHandleWrmsr(&g_GuestState[KeGetCurrentProcessorNumber()], TargetMsr, Msr.Flags))
+            {
+                break;
+            }
+
+            //
+            // Check whether the TSC deadline is converted to the actual time
+            // stamp counter by the transparent-mode or not
+            //
+            if (TransparentHandleWrmsr(&g_GuestState[KeGetCurrentProcessorNumber()], TargetMsr, Msr.Flags))
+            {
+                break;
+            }
+
+            //
+            // The maximum basic leaf of CPUID might be changed (limit CPUID
+            // maxval), so the cached results of CPUID are not valid anymore
+            //
+            if (TargetMsr == IA32_MISC_ENABLE)
+            {
+                CpuidHandlerInvalidateCache(&g_GuestState[KeGetCurrentProcessorNumber()]);
+            }
+
             //
             // Perform the WRMSR
             //
@@ -308,6 +378,12 @@ MsrHandleSetMsrBitmap(VIRTUAL_MACHINE_STATE * VCpu, UINT64 Msr, BOOLEAN ReadDete
     {
         return FALSE;
     }
+
+    //
+    // Hyper-V should reload the (enlightened) MSR bitmap
+    //
+    EvmcsMarkFieldsDirty(VCpu, HV_VMX_ENLIGHTENED_CLEAN_FIELD_MSR_BITMAP);
+
     return TRUE;
 }
 
@@ -357,6 +433,12 @@ MsrHandleUnSetMsrBitmap(VIRTUAL_MACHINE_STATE * VCpu, UINT64 Msr, BOOLEAN ReadDe
     {
         return FALSE;
     }
+
+    //
+    // Hyper-V should reload the (enlightened) MSR bitmap
+    //
+    EvmcsMarkFieldsDirty(VCpu, HV_VMX_ENLIGHTENED_CLEAN_FIELD_MSR_BITMAP);
+
     return TRUE;
 }
 
@@ -411,37 +493,198 @@ MsrHandleFilterMsrWriteBitmap(VIRTUAL_MACHINE_STATE * VCpu)
 }
 
 /**
- * @brief Change MSR Bitmap for read
+ * @brief Get the index of the bit of an MSR in MSR Bitmap
+ * @details the reference counts of MSRs use the same index
+ *
+ * @param Msr MSR Address
+ * @param IsWrite Whether the bit is for write or read
+ * @param Index The index of the bit
+ *
+ * @return BOOLEAN Returns false if the MSR is not in range of MSR Bitmap
+ */
+static BOOLEAN
+MsrHandleGetMsrBitmapIndex(UINT64 Msr, BOOLEAN IsWrite, UINT32 * Index)
+{
+    UINT32 Base = IsWrite ? MSR_BITMAP_WRITE_BASE_INDEX : 0;
+
+    if (Msr <= 0x00001FFF)
+    {
+        *Index = Base + (UINT32)Msr;
+    }
+    else if ((0xC0000000 <= Msr) && (Msr <= 0xC0001FFF))
+    {
+        *Index = Base + MSR_BITMAP_HIGH_MSRS_BASE_INDEX + (UINT32)(Msr - 0xC0000000);
+    }
+    else
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Add a reference to an MSR (or all MSRs) and set it on MSR Bitmap
  * @details should be called in vmx-root mode
+ *
  * @param VCpu The virtual processor's state
- * @param MsrMask
+ * @param MsrMask MSR
+ * @param IsWrite Whether it's for write or read
  *
  * @return VOID
  */
-VOID
-MsrHandlePerformMsrBitmapReadChange(VIRTUAL_MACHINE_STATE * VCpu, UINT64 MsrMask)
+static VOID
+MsrHandlePerformMsrBitmapChange(VIRTUAL_MACHINE_STATE * VCpu, UINT64 MsrMask, BOOLEAN IsWrite)
 {
+    UINT32 Index;
+
     if (MsrMask == DEBUGGER_EVENT_MSR_READ_OR_WRITE_ALL_MSRS)
     {
         //
         // Means all the bitmaps should be put to 1
         //
-        memset(VCpu->MsrBitmapVirtualAddress, 0xff, 2048);
+        if (IsWrite)
+        {
+            VCpu->MsrBitmapWriteAllReferenceCount++;
+
+            memset((UINT64)VCpu->MsrBitmapVirtualAddress + 2048, 0xff, 2048);
+
+            //
+            // Filter MSR Bitmap for special MSRs
+            //
+            MsrHandleFilterMsrWriteBitmap(VCpu);
+        }
+        else
+        {
+            VCpu->MsrBitmapReadAllReferenceCount++;
+
+            memset(VCpu->MsrBitmapVirtualAddress, 0xff, 2048);
+
+            //
+            // Filter MSR Bitmap for special MSRs
+            //
+            MsrHandleFilterMsrReadBitmap(VCpu);
+        }
 
         //
-        // Filter MSR Bitmap for special MSRs
+        // Hyper-V should reload the (enlightened) MSR bitmap
         //
-        MsrHandleFilterMsrReadBitmap(VCpu);
+        EvmcsMarkFieldsDirty(VCpu, HV_VMX_ENLIGHTENED_CLEAN_FIELD_MSR_BITMAP);
     }
     else
     {
         //
         // Means only one msr bitmap is target
         //
-        MsrHandleSetMsrBitmap(VCpu, MsrMask, TRUE, FALSE);
+        if (MsrHandleGetMsrBitmapIndex(MsrMask, IsWrite, &Index))
+        {
+            VCpu->MsrBitmapReferenceCounts[Index]++;
+        }
+
+        MsrHandleSetMsrBitmap(VCpu, MsrMask, !IsWrite, IsWrite);
     }
 }
 
+/**
+ * @brief Release a reference of an MSR (or all MSRs) and unset the bits
+ * of MSR Bitmap that are not referenced anymore
+ * @details should be called in vmx-root mode
+ *
+ * @param VCpu The virtual processor's state
+ * @param MsrMask MSR
+ * @param IsWrite Whether it's for write or read
+ *
+ * @return VOID
+ */
+static VOID
+MsrHandlePerformMsrBitmapUnset(VIRTUAL_MACHINE_STATE * VCpu, UINT64 MsrMask, BOOLEAN IsWrite)
+{
+    UINT32   Index;
+    UINT32   Base              = IsWrite ? MSR_BITMAP_WRITE_BASE_INDEX : 0;
+    UINT32 * AllReferenceCount = IsWrite ? &VCpu->MsrBitmapWriteAllReferenceCount : &VCpu->MsrBitmapReadAllReferenceCount;
+
+    if (MsrMask == DEBUGGER_EVENT_MSR_READ_OR_WRITE_ALL_MSRS)
+    {
+        if (*AllReferenceCount == 0)
+        {
+            return;
+        }
+
+        (*AllReferenceCount)--;
+
+        if (*AllReferenceCount != 0)
+        {
+            //
+            // Still all of the MSRs should cause vm-exits
+            //
+            return;
+        }
+
+        //
+        // Only the MSRs that are still referenced should cause vm-exits
+        //
+        memset((UINT64)VCpu->MsrBitmapVirtualAddress + (IsWrite ? 2048 : 0), 0x0, 2048);
+
+        for (Index = Base; Index < Base + MSR_BITMAP_WRITE_BASE_INDEX; Index++)
+        {
+            if (VCpu->MsrBitmapReferenceCounts[Index] != 0)
+            {
+                SetBit(Index, VCpu->MsrBitmapVirtualAddress);
+            }
+        }
+
+        //
+        // Hyper-V should reload the (enlightened) MSR bitmap
+        //
+        EvmcsMarkFieldsDirty(VCpu, HV_VMX_ENLIGHTENED_CLEAN_FIELD_MSR_BITMAP);
+    }
+    else
+    {
+        if (!MsrHandleGetMsrBitmapIndex(MsrMask, IsWrite, &Index) || VCpu->MsrBitmapReferenceCounts[Index] == 0)
+        {
+            return;
+        }
+
+        VCpu->MsrBitmapReferenceCounts[Index]--;
+
+        //
+        // Unset the bit if nothing else needs it
+        //
+        if (VCpu->MsrBitmapReferenceCounts[Index] == 0 && *AllReferenceCount == 0)
+        {
+            MsrHandleUnSetMsrBitmap(VCpu, MsrMask, !IsWrite, IsWrite);
+        }
+    }
+}
+
+/**
+ * @brief Change MSR Bitmap for read
+ * @details should be called in vmx-root mode
+ * @param VCpu The virtual processor's state
+ * @param MsrMask
+ *
+ * @return VOID
+ */
+VOID
+MsrHandlePerformMsrBitmapReadChange(VIRTUAL_MACHINE_STATE * VCpu, UINT64 MsrMask)
+{
+    MsrHandlePerformMsrBitmapChange(VCpu, MsrMask, FALSE);
+}
+
+/**
+ * @brief Release a reference of MSR Bitmap for read
+ * @details should be called in vmx-root mode
+ * @param VCpu The virtual processor's state
+ * @param MsrMask MSR
+ *
+ * @return VOID
+ */
+VOID
+MsrHandlePerformMsrBitmapReadUnset(VIRTUAL_MACHINE_STATE * VCpu, UINT64 MsrMask)
+{
+    MsrHandlePerformMsrBitmapUnset(VCpu, MsrMask, FALSE);
+}
+
 /**
  * @brief Reset MSR Bitmap for read
  * @details should be called in vmx-root mode
@@ -456,7 +699,19 @@ MsrHandlePerformMsrBitmapReadReset(VIRTUAL_MACHINE_STATE * VCpu)
     // Means all the bitmaps should be put to 0
     //
     memset(VCpu->MsrBitmapVirtualAddress, 0x0, 2048);
+
+    //
+    // And nothing is referenced anymore
+    //
+    VCpu->MsrBitmapReadAllReferenceCount = 0;
+    RtlZeroMemory(VCpu->MsrBitmapReferenceCounts, MSR_BITMAP_WRITE_BASE_INDEX * sizeof(UINT16));
+
+    //
+    // Hyper-V should reload the (enlightened) MSR bitmap
+    //
+    EvmcsMarkFieldsDirty(VCpu, HV_VMX_ENLIGHTENED_CLEAN_FIELD_MSR_BITMAP);
 }
+
 /**
  * @brief Change MSR Bitmap for write
  * @details should be called in vmx-root mode
@@ -468,25 +723,21 @@ MsrHandlePerformMsrBitmapReadReset(VIRTUAL_MACHINE_STATE * VCpu)
 VOID
 MsrHandlePerformMsrBitmapWriteChange(VIRTUAL_MACHINE_STATE * VCpu, UINT64 MsrMask)
 {
-    if (MsrMask == DEBUGGER_EVENT_MSR_READ_OR_WRITE_ALL_MSRS)
-    {
-        //
-        // Means all the bitmaps should be put to 1
-        //
-        memset((UINT64)VCpu->MsrBitmapVirtualAddress + 2048, 0xff, 2048);
+    MsrHandlePerformMsrBitmapChange(VCpu, MsrMask, TRUE);
+}
 
-        //
-        // Filter MSR Bitmap for special MSRs
-        //
-        MsrHandleFilterMsrWriteBitmap(VCpu);
-    }
-    else
-    {
-        //
-        // Means only one msr bitmap is target
-        //
-        MsrHandleSetMsrBitmap(VCpu, MsrMask, FALSE, TRUE);
-    }
+/**
+ * @brief Release a reference of MSR Bitmap for write
+ * @details should be called in vmx-root mode
+ * @param VCpu The virtual processor's state
+ * @param MsrMask MSR
+ *
+ * @return VOID
+ */
+VOID
+MsrHandlePerformMsrBitmapWriteUnset(VIRTUAL_MACHINE_STATE * VCpu, UINT64 MsrMask)
+{
+    MsrHandlePerformMsrBitmapUnset(VCpu, MsrMask, TRUE);
 }
 
 /**
@@ -503,4 +754,15 @@ MsrHandlePerformMsrBitmapWriteReset(VIRTUAL_MACHINE_STATE * VCpu)
     // Means all the bitmaps should be put to 0
     //
     memset((UINT64)VCpu->MsrBitmapVirtualAddress + 2048, 0x0, 2048);
+
+    //
+    // And nothing is referenced anymore
+    //
+    VCpu->MsrBitmapWriteAllReferenceCount = 0;
+    RtlZeroMemory(&VCpu->MsrBitmapReferenceCounts[MSR_BITMAP_WRITE_BASE_INDEX], MSR_BITMAP_WRITE_BASE_INDEX * sizeof(UINT16));
+
+    //
+    // Hyper-V should reload the (enlightened) MSR bitmap
+    //
+    EvmcsMarkFieldsDirty(VCpu, HV_VMX_ENLIGHTENED_CLEAN_FIELD_MSR_BITMAP);
 }
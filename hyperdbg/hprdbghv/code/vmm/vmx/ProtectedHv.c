@@ -41,6 +41,15 @@ ProtectedHvChangeExceptionBitmapWithIntegrityCheck(VIRTUAL_MACHINE_STATE * VCpu,
         return;
     }
 
+    //
+    // Check for the exceptions that are referenced by the events, if it's
+    // for clearing events, the debugger will automatically set them
+    //
+    if (!(PassOver & PASSING_OVER_EXCEPTION_EVENTS))
+    {
+        CurrentMask |= BitmapOwnershipQueryExceptionBitmapMask(VCpu);
+    }
+
     //
     // Check for #PF by thread interception mechanism in user debugger
     //
@@ -142,6 +151,11 @@ ProtectedHvResetExceptionBitmapToClearEvents(VIRTUAL_MACHINE_STATE * VCpu)
 {
     UINT32 ExceptionBitmap = 0;
 
+    //
+    // No exception is referenced by the events anymore
+    //
+    BitmapOwnershipReset(VCpu, BITMAP_OWNERSHIP_RESOURCE_EXCEPTION, 0);
+
     //
     // Set the new value
     //
@@ -226,8 +240,8 @@ ProtectedHvApplySetExternalInterruptExiting(VIRTUAL_MACHINE_STATE * VCpu, BOOLEA
     //
     // Read the previous flags
     //
-    __vmx_vmread(VMCS_CTRL_PIN_BASED_VM_EXECUTION_CONTROLS, &PinBasedControls);
-    __vmx_vmread(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, &VmExitControls);
+    VmxVmread(VMCS_CTRL_PIN_BASED_VM_EXECUTION_CONTROLS, &PinBasedControls);
+    VmxVmread(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, &VmExitControls);
 
     if (Set)
     {
@@ -243,8 +257,8 @@ ProtectedHvApplySetExternalInterruptExiting(VIRTUAL_MACHINE_STATE * VCpu, BOOLEA
     //
     // Set the new value
     //
-    __vmx_vmwrite(VMCS_CTRL_PIN_BASED_VM_EXECUTION_CONTROLS, PinBasedControls);
-    __vmx_vmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, VmExitControls);
+    VmxVmwrite(VMCS_CTRL_PIN_BASED_VM_EXECUTION_CONTROLS, PinBasedControls);
+    VmxVmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, VmExitControls);
 }
 
 /**
@@ -306,9 +320,10 @@ ProtectedHvSetTscVmexit(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Set, PROTECTED_HV_
         }
 
         //
-        // Check if transparent mode is enabled
+        // Check if transparent mode is enabled (rdtsc exiting is not needed
+        // if the time is compensated by the TSC offset)
         //
-        if (g_TransparentMode)
+        if (g_TransparentMode && !g_TransparentModeTscOffsetting)
         {
             //
             // We should ignore it as we want this bit on transparent mode
@@ -320,7 +335,7 @@ ProtectedHvSetTscVmexit(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Set, PROTECTED_HV_
     //
     // Read the previous flags
     //
-    __vmx_vmread(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &CpuBasedVmExecControls);
+    VmxVmread(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &CpuBasedVmExecControls);
 
     if (Set)
     {
@@ -333,7 +348,7 @@ ProtectedHvSetTscVmexit(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Set, PROTECTED_HV_
     //
     // Set the new value
     //
-    __vmx_vmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
+    VmxVmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
 }
 
 /**
@@ -369,12 +384,21 @@ ProtectedHvSetMovDebugRegsVmexit(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Set, PROT
         {
             return;
         }
+
+        //
+        // Check whether the events still need it, if it's for clearing
+        // events, the debugger will automatically set it
+        //
+        if (!(PassOver & PASSING_OVER_MOV_TO_HW_DEBUG_REGS_EVENTS) && BitmapOwnershipIsMovToDebugRegsOwned(VCpu))
+        {
+            return;
+        }
     }
 
     //
     // Read the previous flags
     //
-    __vmx_vmread(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &CpuBasedVmExecControls);
+    VmxVmread(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &CpuBasedVmExecControls);
 
     if (Set)
     {
@@ -388,7 +412,7 @@ ProtectedHvSetMovDebugRegsVmexit(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Set, PROT
     //
     // Set the new value
     //
-    __vmx_vmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
+    VmxVmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
 }
 
 /**
@@ -408,26 +432,26 @@ ProtectedHvSetMovToCrVmexit(BOOLEAN Set, UINT64 ControlRegister, UINT64 MaskRegi
     {
         if (Set)
         {
-            __vmx_vmwrite(VMCS_CTRL_CR0_GUEST_HOST_MASK, MaskRegister);
-            __vmx_vmwrite(VMCS_CTRL_CR0_READ_SHADOW, __readcr0());
+            VmxVmwrite(VMCS_CTRL_CR0_GUEST_HOST_MASK, MaskRegister);
+            VmxVmwrite(VMCS_CTRL_CR0_READ_SHADOW, __readcr0());
         }
         else
         {
-            __vmx_vmwrite(VMCS_CTRL_CR0_GUEST_HOST_MASK, 0);
-            __vmx_vmwrite(VMCS_CTRL_CR0_READ_SHADOW, 0);
+            VmxVmwrite(VMCS_CTRL_CR0_GUEST_HOST_MASK, 0);
+            VmxVmwrite(VMCS_CTRL_CR0_READ_SHADOW, 0);
         }
     }
     else if (ControlRegister == VMX_EXIT_QUALIFICATION_REGISTER_CR4)
     {
         if (Set)
         {
-            __vmx_vmwrite(VMCS_CTRL_CR4_GUEST_HOST_MASK, MaskRegister);
-            __vmx_vmwrite(VMCS_CTRL_CR4_READ_SHADOW, __readcr0());
+            VmxVmwrite(VMCS_CTRL_CR4_GUEST_HOST_MASK, MaskRegister);
+            VmxVmwrite(VMCS_CTRL_CR4_READ_SHADOW, __readcr0());
         }
         else
         {
-            __vmx_vmwrite(VMCS_CTRL_CR4_GUEST_HOST_MASK, 0);
-            __vmx_vmwrite(VMCS_CTRL_CR4_READ_SHADOW, 0);
+            VmxVmwrite(VMCS_CTRL_CR4_GUEST_HOST_MASK, 0);
+            VmxVmwrite(VMCS_CTRL_CR4_READ_SHADOW, 0);
         }
     }
 }
@@ -466,6 +490,18 @@ ProtectedHvSetMovControlRegsVmexit(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Set, PR
         {
             return;
         }
+
+        //
+        // The bits that are still referenced by the events remain in
+        // the mask, if it's for clearing events, the debugger will
+        // automatically set them
+        //
+        if (!(PassOver & PASSING_OVER_MOV_TO_CONTROL_REGS_EVENTS) &&
+            BitmapOwnershipQueryControlRegisterMask(VCpu, ControlRegister) != 0)
+        {
+            ProtectedHvSetMovToCrVmexit(TRUE, ControlRegister, BitmapOwnershipQueryControlRegisterMask(VCpu, ControlRegister));
+            return;
+        }
     }
 
     ProtectedHvSetMovToCrVmexit(Set, ControlRegister, MaskRegister);
@@ -531,7 +567,7 @@ ProtectedHvSetMovToCr3Vmexit(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Set, PROTECTE
     //
     // Read the previous flags
     //
-    __vmx_vmread(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &CpuBasedVmExecControls);
+    VmxVmread(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, &CpuBasedVmExecControls);
 
     if (Set)
     {
@@ -545,7 +581,7 @@ ProtectedHvSetMovToCr3Vmexit(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Set, PROTECTE
     //
     // Set the new value
     //
-    __vmx_vmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
+    VmxVmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
 }
 
 /**
@@ -595,9 +631,26 @@ ProtectedHvSetMovDebugRegsExiting(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Set)
 VOID
 ProtectedHvDisableMovDebugRegsExitingForDisablingDrCommands(VIRTUAL_MACHINE_STATE * VCpu)
 {
+    BitmapOwnershipReset(VCpu, BITMAP_OWNERSHIP_RESOURCE_MOV_TO_DEBUG_REGS, 0);
+
     ProtectedHvSetMovDebugRegsVmexit(VCpu, FALSE, PASSING_OVER_MOV_TO_HW_DEBUG_REGS_EVENTS);
 }
 
+/**
+ * @brief Set MOV to Control Regs Exiting
+ *
+ * @param VCpu The virtual processor's state
+ * @param Set Set or unset the MOV to Control Regs Exiting
+ * @param Control Register
+ * @param Mask Register
+ * @return VOID
+ */
+VOID
+ProtectedHvSetMovControlRegsExiting(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Set, UINT64 ControlRegister, UINT64 MaskRegister)
+{
+    ProtectedHvSetMovControlRegsVmexit(VCpu, Set, PASSING_OVER_NONE, ControlRegister, MaskRegister);
+}
+
 /**
  * @brief Clear events of !crwrite
  *
@@ -609,6 +662,8 @@ ProtectedHvDisableMovDebugRegsExitingForDisablingDrCommands(VIRTUAL_MACHINE_STAT
 VOID
 ProtectedHvDisableMovControlRegsExitingForDisablingCrCommands(VIRTUAL_MACHINE_STATE * VCpu, UINT64 ControlRegister, UINT64 MaskRegister)
 {
+    BitmapOwnershipReset(VCpu, BITMAP_OWNERSHIP_RESOURCE_MOV_TO_CONTROL_REGS, ControlRegister);
+
     ProtectedHvSetMovControlRegsVmexit(VCpu, FALSE, PASSING_OVER_MOV_TO_CONTROL_REGS_EVENTS, ControlRegister, MaskRegister);
 }
 
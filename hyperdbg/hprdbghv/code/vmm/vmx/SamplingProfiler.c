@@ -0,0 +1,307 @@
+/**
+ * @file SamplingProfiler.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The sampling profiler of the guest (based on the VMX preemption timer)
+ * @details each core causes a vm-exit once in each period of the VMX
+ * preemption timer and records the guest's RIP, CR3 and (optionally) a
+ * shallow stack into its own ring buffer
+ * @version 0.4
+ * @date 2023-08-01
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Take the (return address) frames of the guest's stack
+ * @details the same heuristic as the callstack of the debugger, the
+ * values of the stack that point to executable pages are considered as
+ * the return addresses
+ *
+ * @param VCpu The virtual processor's state
+ * @param Sample The sample to save the frames
+ * @param Is32Bit Whether the guest is on a 32-bit (wow64) process
+ *
+ * @return VOID
+ */
+static VOID
+SamplingProfilerCaptureStack(VIRTUAL_MACHINE_STATE * VCpu, PSAMPLING_PROFILER_SAMPLE Sample, BOOLEAN Is32Bit)
+{
+    UINT16 AddressMode         = Is32Bit ? sizeof(UINT32) : sizeof(UINT64);
+    UINT64 CurrentStackAddress = NULL;
+    UINT64 Value               = NULL;
+
+    for (UINT32 i = 0; i < SAMPLING_PROFILER_SCANNED_STACK_SLOTS; i++)
+    {
+        CurrentStackAddress = VCpu->Regs->rsp + (i * AddressMode);
+
+        if (!CheckAccessValidityAndSafety(CurrentStackAddress, AddressMode))
+        {
+            //
+            // Stack is no longer valid or available to access from here
+            //
+            return;
+        }
+
+        Value = NULL;
+        MemoryMapperReadMemorySafeOnTargetProcess(CurrentStackAddress, &Value, AddressMode);
+
+        if (CheckAccessValidityAndSafety(Value, MAXIMUM_CALL_INSTR_SIZE) &&
+            MemoryMapperCheckIfPageIsNxBitSetOnTargetProcess((PVOID)Value))
+        {
+            Sample->StackFrames[Sample->CountOfStackFrames] = Value;
+            Sample->CountOfStackFrames++;
+
+            if (Sample->CountOfStackFrames == SamplingProfilerMaximumStackFrames)
+            {
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Record a sample of the guest in the buffer of the current core
+ * @details should be called from vmx-root once the VMX preemption timer
+ * is expired, only the current core writes to its buffer, the samples
+ * are dropped if the buffer is full
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+VOID
+SamplingProfilerRecordSample(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    PSAMPLING_PROFILER_BUFFER Buffer = &g_SamplingProfilerBuffers[VCpu->CoreId];
+    PSAMPLING_PROFILER_SAMPLE Sample;
+    LONG64                    WriteIndex = Buffer->WriteIndex;
+    UINT64                    CsSel      = NULL;
+
+    if (WriteIndex - Buffer->ReadIndex >= SAMPLING_PROFILER_BUFFER_CAPACITY)
+    {
+        InterlockedIncrement64(&Buffer->DroppedSamples);
+        return;
+    }
+
+    Sample = &Buffer->Samples[WriteIndex & (SAMPLING_PROFILER_BUFFER_CAPACITY - 1)];
+
+    CsSel = HvGetCsSelector();
+
+    Sample->Rip                = VCpu->LastVmexitRip;
+    Sample->CoreId             = VCpu->CoreId;
+    Sample->IsUserMode         = (CsSel & 3) != 0;
+    Sample->CountOfStackFrames = 0;
+
+    VmxVmread(VMCS_GUEST_CR3, &Sample->Cr3);
+
+    if (g_SamplingProfilerCaptureStack)
+    {
+        SamplingProfilerCaptureStack(VCpu, Sample, (CsSel & ~3) == KGDT64_R3_CMCODE);
+    }
+
+    //
+    // The sample is visible to the readers once the index is changed
+    //
+    InterlockedExchange64(&Buffer->WriteIndex, WriteIndex + 1);
+}
+
+/**
+ * @brief Start taking the samples of the guest
+ * @details should be called from vmx non-root (PASSIVE_LEVEL), the
+ * buffers are allocated once and kept until VMX is terminated
+ *
+ * @param ProfilerRequest
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+SamplingProfilerStart(PDEBUGGER_SAMPLING_PROFILER_REQUEST ProfilerRequest)
+{
+    SIZE_T BufferSize = sizeof(SAMPLING_PROFILER_BUFFER) * KeQueryActiveProcessorCount(0);
+    UINT64 TimerValue;
+
+    if (!g_CompatibilityCheck.PreemptionTimerSupport)
+    {
+        ProfilerRequest->KernelStatus = DEBUGGER_ERROR_VMX_PREEMPTION_TIMER_IS_NOT_SUPPORTED;
+        return FALSE;
+    }
+
+    if (g_SamplingProfilerBuffers == NULL)
+    {
+        g_SamplingProfilerBuffers = ExAllocatePoolWithTag(NonPagedPool, BufferSize, POOLTAG);
+
+        if (g_SamplingProfilerBuffers == NULL)
+        {
+            ProfilerRequest->KernelStatus = DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_SAMPLING_PROFILER;
+            return FALSE;
+        }
+
+        RtlZeroMemory(g_SamplingProfilerBuffers, BufferSize);
+    }
+
+    //
+    // The VMX preemption timer counts down once in each 2^rate TSC ticks
+    //
+    TimerValue = ProfilerRequest->Interval >> g_CompatibilityCheck.PreemptionTimerRate;
+
+    if (TimerValue == 0)
+    {
+        TimerValue = 1;
+    }
+    else if (TimerValue > MAXUINT32)
+    {
+        TimerValue = MAXUINT32;
+    }
+
+    g_SamplingProfilerTimerValue   = (UINT32)TimerValue;
+    g_SamplingProfilerCaptureStack = ProfilerRequest->CaptureStack;
+    g_SamplingProfilerEnabled      = TRUE;
+
+    //
+    // Broadcast to all cores
+    //
+    KeGenericCallDpc(DpcRoutineUpdateVmxPreemptionTimerAllCores, NULL);
+
+    return TRUE;
+}
+
+/**
+ * @brief Stop taking the samples of the guest
+ * @details the samples that are already taken are kept to be queried
+ *
+ * @return VOID
+ */
+static VOID
+SamplingProfilerStop()
+{
+    if (!g_SamplingProfilerEnabled)
+    {
+        return;
+    }
+
+    g_SamplingProfilerEnabled = FALSE;
+
+    //
+    // Broadcast to all cores
+    //
+    KeGenericCallDpc(DpcRoutineUpdateVmxPreemptionTimerAllCores, NULL);
+}
+
+/**
+ * @brief Move the samples of the buffers of the cores to the request
+ * @details the samples are removed from the buffers, so each sample
+ * is only queried once
+ *
+ * @param ProfilerRequest
+ *
+ * @return VOID
+ */
+static VOID
+SamplingProfilerQuery(PDEBUGGER_SAMPLING_PROFILER_REQUEST ProfilerRequest)
+{
+    ULONG  CoreCount = KeQueryActiveProcessorCount(0);
+    UINT32 Count     = 0;
+
+    ProfilerRequest->DroppedSamples = 0;
+
+    if (g_SamplingProfilerBuffers == NULL)
+    {
+        //
+        // The profiler is never started
+        //
+        ProfilerRequest->CountOfSamples = 0;
+        return;
+    }
+
+    SpinlockLock(&g_SamplingProfilerLock);
+
+    for (UINT32 i = 0; i < CoreCount; i++)
+    {
+        PSAMPLING_PROFILER_BUFFER Buffer     = &g_SamplingProfilerBuffers[i];
+        LONG64                    ReadIndex  = Buffer->ReadIndex;
+        LONG64                    WriteIndex = InterlockedCompareExchange64(&Buffer->WriteIndex, 0, 0);
+
+        while (ReadIndex != WriteIndex && Count < MaximumSamplingProfilerSamplesToQuery)
+        {
+            ProfilerRequest->Samples[Count] = Buffer->Samples[ReadIndex & (SAMPLING_PROFILER_BUFFER_CAPACITY - 1)];
+
+            ReadIndex++;
+            Count++;
+        }
+
+        //
+        // The slots are reusable by the core once the index is changed
+        //
+        InterlockedExchange64(&Buffer->ReadIndex, ReadIndex);
+
+        ProfilerRequest->DroppedSamples += InterlockedExchange64(&Buffer->DroppedSamples, 0);
+    }
+
+    SpinlockUnlock(&g_SamplingProfilerLock);
+
+    ProfilerRequest->CountOfSamples = Count;
+}
+
+/**
+ * @brief Start, stop or query the samples of the sampling profiler
+ * @details should be called from vmx non-root (PASSIVE_LEVEL)
+ *
+ * @param ProfilerRequest
+ *
+ * @return VOID
+ */
+VOID
+SamplingProfilerPerformAction(PDEBUGGER_SAMPLING_PROFILER_REQUEST ProfilerRequest)
+{
+    ProfilerRequest->KernelStatus   = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+    ProfilerRequest->CountOfSamples = 0;
+
+    switch (ProfilerRequest->Action)
+    {
+    case DEBUGGER_SAMPLING_PROFILER_ACTION_START:
+
+        SamplingProfilerStart(ProfilerRequest);
+
+        break;
+
+    case DEBUGGER_SAMPLING_PROFILER_ACTION_STOP:
+
+        SamplingProfilerStop();
+
+        break;
+
+    case DEBUGGER_SAMPLING_PROFILER_ACTION_QUERY:
+
+        SamplingProfilerQuery(ProfilerRequest);
+
+        break;
+
+    default:
+
+        ProfilerRequest->KernelStatus = DEBUGGER_ERROR_INVALID_ACTION_TYPE;
+
+        break;
+    }
+
+    ProfilerRequest->IsEnabled = g_SamplingProfilerEnabled;
+}
+
+/**
+ * @brief Free the buffers of the sampling profiler
+ * @details should be called after VMX is terminated on all cores
+ *
+ * @return VOID
+ */
+VOID
+SamplingProfilerUninitialize()
+{
+    g_SamplingProfilerEnabled = FALSE;
+
+    if (g_SamplingProfilerBuffers != NULL)
+    {
+        ExFreePoolWithTag(g_SamplingProfilerBuffers, POOLTAG);
+        g_SamplingProfilerBuffers = NULL;
+    }
+}
@@ -152,21 +152,31 @@ VmxVmcallHandler(VIRTUAL_MACHINE_STATE * VCpu,
         BOOLEAN UnsetExecHiddenHook2 = FALSE;
         BOOLEAN UnsetRead            = FALSE;
         BOOLEAN UnsetWrite           = FALSE;
+        BOOLEAN LargePage            = FALSE;
 
         UnsetRead            = (AttributeMask & PAGE_ATTRIB_READ) ? TRUE : FALSE;
         UnsetWrite           = (AttributeMask & PAGE_ATTRIB_WRITE) ? TRUE : FALSE;
         UnsetExec            = (AttributeMask & PAGE_ATTRIB_EXEC) ? TRUE : FALSE;
         UnsetExecHiddenHook2 = (AttributeMask & PAGE_ATTRIB_EXEC_HIDDEN_HOOK) ? TRUE : FALSE;
+        LargePage            = (AttributeMask & PAGE_ATTRIB_LARGE_PAGE) ? TRUE : FALSE;
 
         CR3_TYPE ProcCr3 = {.Flags = OptionalParam3};
 
+        //
+        // The scripts of the other cores might also apply hooks in vmx-root
+        //
+        SpinlockLock(&EptHookVmxRootLock);
+
         HookResult = EptHookPerformPageHook2(OptionalParam1 /* TargetAddress */,
                                              OptionalParam2 /* Hook Function*/,
                                              ProcCr3 /* Process cr3 */,
                                              UnsetRead,
                                              UnsetWrite,
                                              UnsetExec,
-                                             UnsetExecHiddenHook2);
+                                             UnsetExecHiddenHook2,
+                                             LargePage);
+
+        SpinlockUnlock(&EptHookVmxRootLock);
 
         VmcallStatus = (HookResult == TRUE) ? STATUS_SUCCESS : STATUS_UNSUCCESSFUL;
 
@@ -309,6 +319,36 @@ VmxVmcallHandler(VIRTUAL_MACHINE_STATE * VCpu,
         VmcallStatus = STATUS_SUCCESS;
         break;
     }
+    case VMCALL_UNSET_MSR_BITMAP_READ:
+    {
+        MsrHandlePerformMsrBitmapReadUnset(VCpu, OptionalParam1);
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
+    case VMCALL_UNSET_MSR_BITMAP_WRITE:
+    {
+        MsrHandlePerformMsrBitmapWriteUnset(VCpu, OptionalParam1);
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
+    case VMCALL_ACQUIRE_BITMAP_OWNERSHIP:
+    {
+        BitmapOwnershipAcquire(VCpu, (BITMAP_OWNERSHIP_RESOURCE_TYPE)OptionalParam1, OptionalParam2, OptionalParam3);
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
+    case VMCALL_RELEASE_BITMAP_OWNERSHIP:
+    {
+        BitmapOwnershipRelease(VCpu, (BITMAP_OWNERSHIP_RESOURCE_TYPE)OptionalParam1, OptionalParam2, OptionalParam3);
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
+    case VMCALL_UPDATE_VMX_PREEMPTION_TIMER:
+    {
+        CounterUpdatePreemptionTimer();
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
     case VMCALL_RESET_EXCEPTION_BITMAP_ONLY_ON_CLEARING_EXCEPTION_EVENTS:
     {
         ProtectedHvResetExceptionBitmapToClearEvents(VCpu);
@@ -425,6 +465,35 @@ VmxVmcallHandler(VIRTUAL_MACHINE_STATE * VCpu,
         VmcallStatus = STATUS_SUCCESS;
         break;
     }
+    case VMCALL_FLUSH_DIRTY_LOGGING_BUFFER:
+    {
+        DirtyLoggingFlushPmlBuffer(VCpu, (UINT32)OptionalParam1);
+
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
+    case VMCALL_CONFIGURE_INTEL_PT:
+    {
+        IntelPtPerformActionOnCore(VCpu, (INTEL_PT_CORE_ACTION)OptionalParam1);
+
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
+    case VMCALL_CONFIGURE_PEBS_SAMPLING:
+    {
+        PebsSamplingPerformActionOnCore(VCpu, (PEBS_SAMPLING_CORE_ACTION)OptionalParam1);
+
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
+    case VMCALL_BENCHMARK:
+    {
+        //
+        // Nothing to do, only the round-trip is measured
+        //
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
     case VMCALL_CHANGE_TO_MBEC_SUPPORTED_EPTP:
     {
         ReversingMachineChangeToMbecEnabledEptp(VCpu);
@@ -439,6 +508,26 @@ VmxVmcallHandler(VIRTUAL_MACHINE_STATE * VCpu,
         VmcallStatus = STATUS_SUCCESS;
         break;
     }
+    case VMCALL_ENABLE_MODE_BASED_EXECUTION_CONTROL:
+    {
+        HvSetModeBasedExecutionEnableFlag(TRUE);
+
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
+    case VMCALL_DISABLE_MODE_BASED_EXECUTION_CONTROL:
+    {
+        HvSetModeBasedExecutionEnableFlag(FALSE);
+
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
+    case VMCALL_BATCH:
+    {
+        VmcallStatus = VmcallBatch(VCpu, (PVMCALL_BATCH_ENTRY)OptionalParam1, (UINT32)OptionalParam2);
+
+        break;
+    }
     default:
     {
         LogError("Err, unsupported VMCALL");
@@ -479,3 +568,54 @@ VmcallTest(_In_ UINT64 Param1,
 
     return STATUS_SUCCESS;
 }
+
+/**
+ * @brief Perform the VMCALLs of a batch in one vm-exit (VMCALL_BATCH)
+ * @details the VMCALLs are performed in order and the result of each of
+ * them is saved into its Status, the VMCALLs that change the state of the
+ * vmx operation (VMCALL_VMXOFF) and nested batches are not allowed
+ *
+ * @param VCpu The virtual processor's state
+ * @param Entries The VMCALLs of the batch
+ * @param Count Count of the entries
+ * @return NTSTATUS STATUS_SUCCESS if all of the VMCALLs are performed
+ * successfully
+ */
+NTSTATUS
+VmcallBatch(_Inout_ VIRTUAL_MACHINE_STATE * VCpu,
+            _Inout_ PVMCALL_BATCH_ENTRY     Entries,
+            _In_ UINT32                     Count)
+{
+    UINT64   VmcallNumber;
+    NTSTATUS Status = STATUS_SUCCESS;
+
+    if (Entries == NULL || Count == 0 || Count > VMCALL_BATCH_MAXIMUM_ENTRIES)
+    {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        VmcallNumber = Entries[i].VmcallNumber & 0xffffffff;
+
+        if (VmcallNumber == VMCALL_BATCH || VmcallNumber == VMCALL_VMXOFF)
+        {
+            Entries[i].Status = STATUS_INVALID_PARAMETER;
+        }
+        else
+        {
+            Entries[i].Status = VmxVmcallHandler(VCpu,
+                                                 Entries[i].VmcallNumber,
+                                                 Entries[i].OptionalParam1,
+                                                 Entries[i].OptionalParam2,
+                                                 Entries[i].OptionalParam3);
+        }
+
+        if (Entries[i].Status != STATUS_SUCCESS)
+        {
+            Status = STATUS_UNSUCCESSFUL;
+        }
+    }
+
+    return Status;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file VmcsFieldCache.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The cache of the frequently accessed fields of VMCS
+ * @details the cache is only used while the core handles a vm-exit, the
+ * fields are read from VMCS once they're accessed for the first time and
+ * the written fields are flushed to VMCS before the vm-entry
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief The encodings of the cached fields (indexed by VMCS_FIELD_CACHE_*)
+ *
+ */
+static const UINT32 VmcsFieldCacheEncodings[VMCS_FIELD_CACHE_ENTRIES] = {
+    VMCS_GUEST_RIP,
+    VMCS_GUEST_RSP,
+    VMCS_GUEST_RFLAGS,
+    VMCS_GUEST_CS_SELECTOR,
+    VMCS_GUEST_INTERRUPTIBILITY_STATE,
+    VMCS_GUEST_CR3,
+    VMCS_EXIT_REASON,
+    VMCS_EXIT_QUALIFICATION,
+    VMCS_VMEXIT_INSTRUCTION_LENGTH,
+    VMCS_VMEXIT_INTERRUPTION_INFORMATION,
+};
+
+/**
+ * @brief Start using the cache of the fields of VMCS on a vm-exit
+ * @details should be called in vmx-root mode, once the vm-exit starts
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+VmcsFieldCacheStart(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    //
+    // The fields of the previous vm-exit are not valid anymore
+    //
+    VCpu->VmcsFieldCache.ValidFields = 0;
+    VCpu->VmcsFieldCache.DirtyFields = 0;
+    VCpu->VmcsFieldCache.IsActive    = TRUE;
+}
+
+/**
+ * @brief Write the modified fields to VMCS and stop using the cache
+ * @details should be called in vmx-root mode, before the vm-entry
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+VmcsFieldCacheFlush(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    UINT32 DirtyFields = VCpu->VmcsFieldCache.DirtyFields;
+    ULONG  Index;
+
+    //
+    // The fields are accessed directly from now on
+    //
+    VCpu->VmcsFieldCache.IsActive    = FALSE;
+    VCpu->VmcsFieldCache.DirtyFields = 0;
+
+    //
+    // There is no VMCS to write the fields once vmxoff is executed
+    //
+    if (VCpu->VmxoffState.IsVmxoffExecuted)
+    {
+        return;
+    }
+
+    while (DirtyFields != 0)
+    {
+        _BitScanForward(&Index, DirtyFields);
+        DirtyFields &= DirtyFields - 1;
+
+        VmxVmwriteDirect(VmcsFieldCacheEncodings[Index], VCpu->VmcsFieldCache.Values[Index]);
+    }
+}
+
+/**
+ * @brief Read a field of VMCS that is not cached yet
+ *
+ * @param VCpu The virtual processor's state
+ * @param Index The index of the field (VMCS_FIELD_CACHE_*)
+ * @param Field The encoding of the field
+ * @param FieldValue The value of the field
+ *
+ * @return UCHAR Same as __vmx_vmread (zero if it's successful)
+ */
+_Use_decl_annotations_
+UCHAR
+VmcsFieldCacheRead(VIRTUAL_MACHINE_STATE * VCpu, UINT32 Index, size_t Field, size_t * FieldValue)
+{
+    size_t Value  = 0;
+    UCHAR  Status = VmxVmreadDirect(Field, &Value);
+
+    if (Status == 0)
+    {
+        VCpu->VmcsFieldCache.Values[Index] = Value;
+        VCpu->VmcsFieldCache.ValidFields |= (1 << Index);
+    }
+
+    *FieldValue = Value;
+
+    return Status;
+}
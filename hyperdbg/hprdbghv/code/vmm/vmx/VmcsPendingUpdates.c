@@ -0,0 +1,330 @@
+/**
+ * @file VmcsPendingUpdates.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The updates of VMCS controls that are applied on the next vm-exit
+ * of each core
+ * @details a core can only change the VMCS that is loaded on itself, so
+ * instead of sending DPCs (IPIs) to the cores, the requested updates are
+ * queued on the per-core state and each core applies its own updates once
+ * it reaches its next vm-exit, the VMX preemption timer can (optionally)
+ * be used to bound the time that it takes for the updates to be applied
+ * @version 0.4
+ * @date 2023-07-31
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Queue an update of VMCS controls on the target cores
+ * @details the requested values are written before the flags, so the
+ * cores always see the values of the updates that they apply
+ *
+ * @param CoreMask The mask of target cores (or DEBUGGER_BROADCASTING_ALL_CORES_MASK)
+ * @param UpdateFlag The VMCS_PENDING_UPDATE_* of the update
+ * @param Set Set or unset the control
+ * @param ExceptionMask The mask of the vector (only for the exception bitmap)
+ *
+ * @return VOID
+ */
+VOID
+VmcsPendingUpdatesQueue(UINT64 CoreMask, LONG UpdateFlag, BOOLEAN Set, LONG ExceptionMask)
+{
+    ULONG ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    for (UINT32 i = 0; i < ProcessorsCount; i++)
+    {
+        PVMCS_PENDING_UPDATES PendingUpdates = &g_GuestState[i].PendingVmcsUpdates;
+
+        //
+        // The cores from the 64th core are only targeted by the all cores mask
+        //
+        if (CoreMask != DEBUGGER_BROADCASTING_ALL_CORES_MASK && (i >= 64 || !(CoreMask & (1ull << i))))
+        {
+            continue;
+        }
+
+        //
+        // Change the requested value, the last request wins
+        //
+        switch (UpdateFlag)
+        {
+        case VMCS_PENDING_UPDATE_RDTSC_EXITING:
+
+            InterlockedExchange(&PendingUpdates->RdtscExiting, Set);
+            break;
+
+        case VMCS_PENDING_UPDATE_NMI_EXITING:
+
+            InterlockedExchange(&PendingUpdates->NmiExiting, Set);
+            break;
+
+        case VMCS_PENDING_UPDATE_EXCEPTION_BITMAP:
+
+            if (Set)
+            {
+                InterlockedAnd(&PendingUpdates->ExceptionBitmapUnsetMask, ~ExceptionMask);
+                InterlockedOr(&PendingUpdates->ExceptionBitmapSetMask, ExceptionMask);
+            }
+            else
+            {
+                InterlockedAnd(&PendingUpdates->ExceptionBitmapSetMask, ~ExceptionMask);
+                InterlockedOr(&PendingUpdates->ExceptionBitmapUnsetMask, ExceptionMask);
+            }
+
+            break;
+
+        case VMCS_PENDING_UPDATE_LAST_BRANCH_RECORDS:
+
+            InterlockedExchange(&PendingUpdates->LastBranchRecords, Set);
+            break;
+
+        case VMCS_PENDING_UPDATE_TSC_OFFSETTING:
+
+            InterlockedExchange(&PendingUpdates->TscOffsetting, Set);
+            break;
+
+        default:
+            break;
+        }
+
+        //
+        // The core is counted once, no matter how many updates are pending
+        //
+        if (InterlockedOr(&PendingUpdates->Flags, UpdateFlag) == 0)
+        {
+            InterlockedIncrement(&g_VmcsPendingUpdatesCount);
+        }
+
+        //
+        // Notify the core that there is a new update
+        //
+        InterlockedIncrement64(&PendingUpdates->RequestedGeneration);
+    }
+}
+
+/**
+ * @brief Apply the pending updates of VMCS controls of the current core
+ * @details should be called in vmx-root at the start of the vm-exits
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return VOID
+ */
+VOID
+VmcsPendingUpdatesApply(VIRTUAL_MACHINE_STATE * VCpu)
+{
+    PVMCS_PENDING_UPDATES PendingUpdates = &VCpu->PendingVmcsUpdates;
+    LONG64                Generation;
+    LONG                  Flags;
+    ULONG                 SetMask;
+    ULONG                 UnsetMask;
+    ULONG                 Index;
+
+    //
+    // The generation is read before the flags, so if an update is queued
+    // meanwhile, it's applied again on the next vm-exit
+    //
+    Generation = PendingUpdates->RequestedGeneration;
+
+    Flags = InterlockedExchange(&PendingUpdates->Flags, 0);
+
+    if (Flags != 0)
+    {
+        InterlockedDecrement(&g_VmcsPendingUpdatesCount);
+    }
+
+    if (Flags & VMCS_PENDING_UPDATE_RDTSC_EXITING)
+    {
+        HvSetRdtscExiting(VCpu, PendingUpdates->RdtscExiting ? TRUE : FALSE);
+    }
+
+    if (Flags & VMCS_PENDING_UPDATE_NMI_EXITING)
+    {
+        HvSetNmiExiting(PendingUpdates->NmiExiting ? TRUE : FALSE);
+    }
+
+    if (Flags & VMCS_PENDING_UPDATE_EXCEPTION_BITMAP)
+    {
+        SetMask   = InterlockedExchange(&PendingUpdates->ExceptionBitmapSetMask, 0);
+        UnsetMask = InterlockedExchange(&PendingUpdates->ExceptionBitmapUnsetMask, 0);
+
+        while (_BitScanForward(&Index, SetMask))
+        {
+            SetMask &= ~(1ul << Index);
+            ProtectedHvSetExceptionBitmap(VCpu, Index);
+        }
+
+        while (_BitScanForward(&Index, UnsetMask))
+        {
+            UnsetMask &= ~(1ul << Index);
+            ProtectedHvUnsetExceptionBitmap(VCpu, Index);
+        }
+    }
+
+    if (Flags & VMCS_PENDING_UPDATE_LAST_BRANCH_RECORDS)
+    {
+        LbrPerformActionOnCore(VCpu, PendingUpdates->LastBranchRecords ? TRUE : FALSE);
+    }
+
+    if (Flags & VMCS_PENDING_UPDATE_TSC_OFFSETTING)
+    {
+        TransparentSetTscOffsetting(VCpu, PendingUpdates->TscOffsetting ? TRUE : FALSE);
+    }
+
+    if (Flags & VMCS_PENDING_UPDATE_INVALIDATE_EPT)
+    {
+        EptInveptSingleContext(g_EptState->EptPointer.AsUInt);
+    }
+
+    if (Flags & VMCS_PENDING_UPDATE_DEBUGGER_TASKS)
+    {
+        VmmCallbackApplyPendingTasks(VCpu->CoreId);
+    }
+
+    PendingUpdates->AppliedGeneration = Generation;
+}
+
+/**
+ * @brief Request setting or unsetting rdtsc/rdtscp exiting on the next
+ * vm-exit of the target cores
+ *
+ * @param CoreMask The mask of target cores (or DEBUGGER_BROADCASTING_ALL_CORES_MASK)
+ * @param Set Set or unset rdtsc/rdtscp exiting
+ *
+ * @return VOID
+ */
+VOID
+VmcsPendingUpdatesSetRdtscExiting(UINT64 CoreMask, BOOLEAN Set)
+{
+    VmcsPendingUpdatesQueue(CoreMask, VMCS_PENDING_UPDATE_RDTSC_EXITING, Set, 0);
+}
+
+/**
+ * @brief Request setting or unsetting NMI exiting on the next vm-exit of
+ * the target cores
+ *
+ * @param CoreMask The mask of target cores (or DEBUGGER_BROADCASTING_ALL_CORES_MASK)
+ * @param Set Set or unset NMI exiting
+ *
+ * @return VOID
+ */
+VOID
+VmcsPendingUpdatesSetNmiExiting(UINT64 CoreMask, BOOLEAN Set)
+{
+    VmcsPendingUpdatesQueue(CoreMask, VMCS_PENDING_UPDATE_NMI_EXITING, Set, 0);
+}
+
+/**
+ * @brief Request setting or unsetting a vector of the exception bitmap
+ * on the next vm-exit of the target cores
+ *
+ * @param CoreMask The mask of target cores (or DEBUGGER_BROADCASTING_ALL_CORES_MASK)
+ * @param IdtIndex The vector of the exception (one of the first 32 entries)
+ * @param Set Set or unset the vector
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+VmcsPendingUpdatesSetExceptionBitmap(UINT64 CoreMask, UINT32 IdtIndex, BOOLEAN Set)
+{
+    if (IdtIndex >= 32)
+    {
+        return FALSE;
+    }
+
+    VmcsPendingUpdatesQueue(CoreMask, VMCS_PENDING_UPDATE_EXCEPTION_BITMAP, Set, (LONG)(1ul << IdtIndex));
+
+    return TRUE;
+}
+
+/**
+ * @brief Request starting or stopping the recording of the last branches
+ * (LBR) of the guest on the next vm-exit of the target cores
+ *
+ * @param CoreMask The mask of target cores (or DEBUGGER_BROADCASTING_ALL_CORES_MASK)
+ * @param Set Start or stop recording
+ *
+ * @return VOID
+ */
+VOID
+VmcsPendingUpdatesSetLastBranchRecords(UINT64 CoreMask, BOOLEAN Set)
+{
+    VmcsPendingUpdatesQueue(CoreMask, VMCS_PENDING_UPDATE_LAST_BRANCH_RECORDS, Set, 0);
+}
+
+/**
+ * @brief Request starting or stopping the compensation of the time of
+ * vmx-root by the TSC offset on the next vm-exit of the target cores
+ *
+ * @param CoreMask The mask of target cores (or DEBUGGER_BROADCASTING_ALL_CORES_MASK)
+ * @param Set Start or stop the compensation
+ *
+ * @return VOID
+ */
+VOID
+VmcsPendingUpdatesSetTscOffsetting(UINT64 CoreMask, BOOLEAN Set)
+{
+    VmcsPendingUpdatesQueue(CoreMask, VMCS_PENDING_UPDATE_TSC_OFFSETTING, Set, 0);
+}
+
+/**
+ * @brief Request invalidating the EPT caches on the next vm-exit of the
+ * target cores
+ * @details used once the EPT is changed in vmx-root (broadcasting is not
+ * possible in vmx-root)
+ *
+ * @param CoreMask The mask of target cores (or DEBUGGER_BROADCASTING_ALL_CORES_MASK)
+ *
+ * @return VOID
+ */
+VOID
+VmcsPendingUpdatesInvalidateEpt(UINT64 CoreMask)
+{
+    VmcsPendingUpdatesQueue(CoreMask, VMCS_PENDING_UPDATE_INVALIDATE_EPT, TRUE, 0);
+}
+
+/**
+ * @brief Request applying the pending tasks of the debugger on the next
+ * vm-exit of the target cores
+ * @details used once the debugger changes the controls of other cores in
+ * vmx-root (broadcasting is not possible in vmx-root)
+ *
+ * @param CoreMask The mask of target cores (or DEBUGGER_BROADCASTING_ALL_CORES_MASK)
+ *
+ * @return VOID
+ */
+VOID
+VmcsPendingUpdatesRequestDebuggerTasks(UINT64 CoreMask)
+{
+    VmcsPendingUpdatesQueue(CoreMask, VMCS_PENDING_UPDATE_DEBUGGER_TASKS, TRUE, 0);
+}
+
+/**
+ * @brief Set or unset the VMX preemption timer that bounds the time of
+ * applying the pending updates of VMCS controls on all cores
+ * @details the timer counts down at a rate proportional to the TSC, so
+ * each core causes a vm-exit at least once in each period of the timer
+ *
+ * @param TimerValue The value of the VMX preemption timer (zero to unset)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+VmcsPendingUpdatesSetPreemptionTimerKick(UINT32 TimerValue)
+{
+    if (TimerValue != 0 && !g_CompatibilityCheck.PreemptionTimerSupport)
+    {
+        return FALSE;
+    }
+
+    g_VmcsPendingUpdatesKickTimerValue = TimerValue;
+
+    //
+    // Broadcast to all cores
+    //
+    KeGenericCallDpc(DpcRoutineUpdateVmxPreemptionTimerAllCores, NULL);
+
+    return TRUE;
+}
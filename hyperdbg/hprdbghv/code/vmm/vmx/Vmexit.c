@@ -25,13 +25,31 @@ VmxVmexitHandler(_Inout_ PGUEST_REGS GuestRegs)
     BOOLEAN                 Result              = FALSE;
     BOOLEAN                 ShouldEmulateRdtscp = TRUE;
     ULONG                   CoreId              = TRUE;
+    UINT64                  StartTsc            = 0;
     VIRTUAL_MACHINE_STATE * VCpu                = NULL;
 
+    //
+    // Start measuring the cycles of handling the vm-exit (if needed)
+    //
+    if (g_VmexitStatisticsEnabled)
+    {
+        StartTsc = __rdtsc();
+    }
+
     //
     // *********** SEND MESSAGE AFTER WE SET THE STATE ***********
     //
     VCpu = &g_GuestState[KeGetCurrentProcessorNumber()];
 
+    //
+    // Save the time of starting the vm-exit if the time of vmx-root is
+    // compensated by the TSC offset (transparent-mode)
+    //
+    if (VCpu->TransparencyState.TscOffsettingEnabled)
+    {
+        VCpu->TransparencyState.VmexitTimeStampCounter = __rdtsc();
+    }
+
     //
     // Set the registers
     //
@@ -42,17 +60,44 @@ VmxVmexitHandler(_Inout_ PGUEST_REGS GuestRegs)
     //
     VCpu->IsOnVmxRootMode = TRUE;
 
+    //
+    // Hyper-V synchronized the enlightened VMCS on this vm-exit, so only the
+    // fields that are written from now on should be reloaded on the vm-entry
+    //
+    if (g_EnlightenedVmcsIsActive)
+    {
+        EvmcsMarkAllFieldsClean(VCpu);
+    }
+
+    //
+    // The frequently accessed fields of VMCS are read once in this vm-exit
+    //
+    VmcsFieldCacheStart(VCpu);
+
+    //
+    // The guest might have changed its page tables, so the cached translations are not valid anymore
+    //
+    AddressTranslationCacheInvalidate(VCpu);
+
+    //
+    // Apply the updates of VMCS controls that are requested for this core (if any)
+    //
+    if (VCpu->PendingVmcsUpdates.RequestedGeneration != VCpu->PendingVmcsUpdates.AppliedGeneration)
+    {
+        VmcsPendingUpdatesApply(VCpu);
+    }
+
     //
     // read the exit reason and exit qualification
     //
-    __vmx_vmread(VMCS_EXIT_REASON, &ExitReason);
+    VmxVmread(VMCS_EXIT_REASON, &ExitReason);
     ExitReason &= 0xffff;
 
     //
     // Check if we're operating in transparent-mode or not
     // If yes then we start operating in transparent-mode
     //
-    if (g_TransparentMode)
+    if (g_TransparentMode && !g_TransparentModeTscOffsetting)
     {
         ShouldEmulateRdtscp = TransparentModeStart(VCpu, ExitReason);
     }
@@ -65,17 +110,17 @@ VmxVmexitHandler(_Inout_ PGUEST_REGS GuestRegs)
     //
     // Save the current rip
     //
-    __vmx_vmread(VMCS_GUEST_RIP, &VCpu->LastVmexitRip);
+    VmxVmread(VMCS_GUEST_RIP, &VCpu->LastVmexitRip);
 
     //
     // Set the rsp in general purpose registers structure
     //
-    __vmx_vmread(VMCS_GUEST_RSP, &VCpu->Regs->rsp);
+    VmxVmread(VMCS_GUEST_RSP, &VCpu->Regs->rsp);
 
     //
     // Read the exit qualification
     //
-    __vmx_vmread(VMCS_EXIT_QUALIFICATION, &VCpu->ExitQualification);
+    VmxVmread(VMCS_EXIT_QUALIFICATION, &VCpu->ExitQualification);
 
     //
     // Debugging purpose
@@ -112,8 +157,8 @@ VmxVmexitHandler(_Inout_ PGUEST_REGS GuestRegs)
         // cf=1 indicate vm instructions fail
         //
         // ULONG Rflags = 0;
-        // __vmx_vmread(VMCS_GUEST_RFLAGS, &Rflags);
-        // __vmx_vmwrite(VMCS_GUEST_RFLAGS, Rflags | 0x1);
+        // VmxVmread(VMCS_GUEST_RFLAGS, &Rflags);
+        // VmxVmwrite(VMCS_GUEST_RFLAGS, Rflags | 0x1);
 
         //
         // Handle unconditional vm-exits (inject #ud)
@@ -336,6 +381,15 @@ VmxVmexitHandler(_Inout_ PGUEST_REGS GuestRegs)
         HvResumeToNextInstruction();
     }
 
+    //
+    // Count the emulated instruction and check for the overflow of the
+    // counter of the retired instructions
+    //
+    if (!VCpu->VmxoffState.IsVmxoffExecuted && VCpu->InstructionCounter.IsArmed)
+    {
+        InstructionCounterHandleVmexit(VCpu);
+    }
+
     //
     // Check for vmxoff request
     //
@@ -344,10 +398,18 @@ VmxVmexitHandler(_Inout_ PGUEST_REGS GuestRegs)
         Result = TRUE;
     }
 
+    //
+    // Record the statistics of the vm-exit (before the time is restored)
+    //
+    if (StartTsc != 0)
+    {
+        VmexitStatisticsRecord(VCpu, ExitReason, __rdtsc() - StartTsc);
+    }
+
     //
     // Restore the previous time
     //
-    if (g_TransparentMode)
+    if (g_TransparentMode && !g_TransparentModeTscOffsetting)
     {
         if (ExitReason != VMX_EXIT_REASON_EXECUTE_RDTSC && ExitReason != VMX_EXIT_REASON_EXECUTE_RDTSCP && ExitReason != VMX_EXIT_REASON_EXECUTE_CPUID)
         {
@@ -359,6 +421,20 @@ VmxVmexitHandler(_Inout_ PGUEST_REGS GuestRegs)
         }
     }
 
+    //
+    // Hide the time that is spent in vmx-root from the time stamp counter
+    // of the guest (transparent-mode)
+    //
+    if (VCpu->TransparencyState.TscOffsettingEnabled && !VCpu->VmxoffState.IsVmxoffExecuted)
+    {
+        TransparentCompensateTimeInVmxRoot(VCpu);
+    }
+
+    //
+    // Write the modified fields of VMCS before the vm-entry
+    //
+    VmcsFieldCacheFlush(VCpu);
+
     //
     // Set indicator of Vmx non root mode to false
     //
@@ -0,0 +1,162 @@
+/**
+ * @file VmexitFastPath.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The fast-path of the hottest vm-exits (CPUID, RDTSC, RDTSCP and
+ * the mov-to-cr3s of the address spaces that are not filtered)
+ * @details the fast-path is handled in AsmVmexitHandler without saving
+ * all of the general-purpose registers, it is only used when there is
+ * nothing to do other than emulating the instruction
+ * @version 0.4
+ * @date 2023-07-29
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Update whether the vm-exits of CPUID, RDTSC, RDTSCP and mov-to-cr3
+ * can be handled in the fast-path or not
+ * @details should be called whenever one of the conditions changes, the
+ * vm-exits that are already in the fast-path might still be handled on
+ * the fast-path (same as the events that are being enabled while other
+ * cores are in the middle of handling a vm-exit)
+ *
+ * @return VOID
+ */
+VOID
+VmexitFastPathUpdate()
+{
+    BOOLEAN IsFullPathNeeded;
+
+    //
+    // The transparent-mode changes the results and the timing of the vm-exits,
+    // the statistics of vm-exits are gathered by the full path and the emulated
+    // instructions are counted by the full path while the retired instructions
+    // are counted
+    //
+    IsFullPathNeeded = g_TransparentMode || g_VmexitStatisticsEnabled || g_InstructionCounterArmedCores != 0;
+
+    //
+    // Events of CPUIDs and the commands of the user debugger (that are
+    // delivered by CPUIDs) are dispatched by the full path
+    //
+    g_VmexitFastPathCpuid = !IsFullPathNeeded && !g_TriggerEventForCpuids && !g_CheckCpuidsForUserDebuggerCommands;
+
+    //
+    // Events of RDTSC and RDTSCP are dispatched by the full path
+    //
+    g_VmexitFastPathTsc = !IsFullPathNeeded && !g_TriggerEventForTscs;
+
+    //
+    // Mov-to-cr3s are only handled in the fast-path if there is a filter of the
+    // address spaces (otherwise, the mov-to-cr3 vm-exits are requested for all
+    // of the processes), the reversing machine and the requesters that bypass
+    // the filter (e.g., events of cr3 and detecting the changes of the process
+    // by the kernel debugger) need all of them in the full path
+    //
+    g_VmexitFastPathCr3 = !IsFullPathNeeded &&
+                          !g_ReversingMachineInitialized &&
+                          g_VmexitFastPathCr3FilterBypassCount == 0 &&
+                          g_VmexitFastPathCr3FilterCount != 0;
+}
+
+/**
+ * @brief Add (or remove) an address space to (from) the filter of mov-to-cr3
+ * vm-exits
+ * @details once the filter is applied, only the mov-to-cr3s that load (or
+ * leave) one of the address spaces in the filter are handled by the full
+ * path and the rest of them are emulated in the fast-path, the entries are
+ * referenced by each of the requesters (e.g., the process switch and the user
+ * debugger might filter the same address space) and an entry is only removed
+ * once its last reference is released, can be called from vmx-root
+ *
+ * @param Set Add (reference) or remove (release) the address space
+ * @param Cr3 The cr3 of the address space
+ * @return BOOLEAN FALSE if there is no free entry in the filter (or the
+ * address space is not in the filter while removing it)
+ */
+BOOLEAN
+VmexitFastPathSetCr3Filter(BOOLEAN Set, UINT64 Cr3)
+{
+    UINT64  PageFrame = Cr3 & VMEXIT_FAST_PATH_CR3_PAGE_FRAME_MASK;
+    UINT32  FreeEntry = VMEXIT_FAST_PATH_CR3_FILTER_MAXIMUM_ENTRIES;
+    BOOLEAN Result    = FALSE;
+
+    if (PageFrame == NULL)
+    {
+        return FALSE;
+    }
+
+    //
+    // The fast-path only reads the page frames, the references are changed
+    // by the requesters (from both vmx-root and vmx non-root)
+    //
+    SpinlockLock(&g_VmexitFastPathCr3FilterLock);
+
+    for (UINT32 i = 0; i < VMEXIT_FAST_PATH_CR3_FILTER_MAXIMUM_ENTRIES; i++)
+    {
+        if (g_VmexitFastPathCr3Filter[i] == PageFrame)
+        {
+            if (Set)
+            {
+                g_VmexitFastPathCr3FilterReferences[i]++;
+            }
+            else if (--g_VmexitFastPathCr3FilterReferences[i] == 0)
+            {
+                //
+                // The last reference is released
+                //
+                InterlockedExchange64((volatile LONG64 *)&g_VmexitFastPathCr3Filter[i], NULL);
+                InterlockedDecrement(&g_VmexitFastPathCr3FilterCount);
+            }
+
+            Result = TRUE;
+            break;
+        }
+
+        if (g_VmexitFastPathCr3Filter[i] == NULL && FreeEntry == VMEXIT_FAST_PATH_CR3_FILTER_MAXIMUM_ENTRIES)
+        {
+            FreeEntry = i;
+        }
+    }
+
+    if (!Result && Set && FreeEntry != VMEXIT_FAST_PATH_CR3_FILTER_MAXIMUM_ENTRIES)
+    {
+        g_VmexitFastPathCr3FilterReferences[FreeEntry] = 1;
+
+        InterlockedExchange64((volatile LONG64 *)&g_VmexitFastPathCr3Filter[FreeEntry], PageFrame);
+        InterlockedIncrement(&g_VmexitFastPathCr3FilterCount);
+
+        Result = TRUE;
+    }
+
+    SpinlockUnlock(&g_VmexitFastPathCr3FilterLock);
+
+    VmexitFastPathUpdate();
+
+    return Result;
+}
+
+/**
+ * @brief Request (or release the request of) handling all of the mov-to-cr3
+ * vm-exits in the full path even if the filter is applied
+ * @details the requests are counted, can be called from vmx-root
+ *
+ * @param Bypass Request or release
+ * @return VOID
+ */
+VOID
+VmexitFastPathBypassCr3Filter(BOOLEAN Bypass)
+{
+    if (Bypass)
+    {
+        InterlockedIncrement(&g_VmexitFastPathCr3FilterBypassCount);
+    }
+    else
+    {
+        InterlockedDecrement(&g_VmexitFastPathCr3FilterBypassCount);
+    }
+
+    VmexitFastPathUpdate();
+}
@@ -0,0 +1,229 @@
+/**
+ * @file VmexitStatistics.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The statistics of vm-exits (count and cycles of each exit reason)
+ * @details
+ * @version 0.4
+ * @date 2023-07-28
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Record a handled vm-exit in the statistics of the current core
+ * @details should be called from vmx-root, only the current core
+ * changes its statistics, so no lock is needed
+ *
+ * @param VCpu The virtual processor's state
+ * @param ExitReason
+ * @param Cycles Cycles of handling the vm-exit
+ *
+ * @return VOID
+ */
+VOID
+VmexitStatisticsRecord(VIRTUAL_MACHINE_STATE * VCpu, UINT32 ExitReason, UINT64 Cycles)
+{
+    PVMEXIT_REASON_STATISTICS Statistics;
+    ULONG                     Bucket;
+
+    if (ExitReason >= MaximumVmexitStatisticsExitReasons)
+    {
+        return;
+    }
+
+    Statistics = &g_VmexitStatistics[VCpu->CoreId].Reasons[ExitReason];
+
+    Statistics->Count++;
+    Statistics->TotalCycles += Cycles;
+
+    if (Cycles > Statistics->MaximumCycles)
+    {
+        Statistics->MaximumCycles = Cycles;
+    }
+
+    //
+    // Find the bucket of the histogram (zero cycles is counted in the first bucket)
+    //
+    if (!_BitScanReverse64(&Bucket, Cycles))
+    {
+        Bucket = 0;
+    }
+
+    if (Bucket >= VmexitStatisticsHistogramBuckets)
+    {
+        Bucket = VmexitStatisticsHistogramBuckets - 1;
+    }
+
+    Statistics->Histogram[Bucket]++;
+}
+
+/**
+ * @brief Enable gathering the statistics of vm-exits
+ * @details should be called from vmx non-root (PASSIVE_LEVEL), the
+ * statistics are allocated once and kept until VMX is terminated
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+VmexitStatisticsEnable()
+{
+    SIZE_T BufferSize = sizeof(VMEXIT_STATISTICS) * KeQueryActiveProcessorCount(0);
+
+    if (g_VmexitStatistics == NULL)
+    {
+        g_VmexitStatistics = ExAllocatePoolWithTag(NonPagedPool, BufferSize, POOLTAG);
+
+        if (g_VmexitStatistics == NULL)
+        {
+            return FALSE;
+        }
+
+        RtlZeroMemory(g_VmexitStatistics, BufferSize);
+    }
+
+    g_VmexitStatisticsEnabled = TRUE;
+
+    //
+    // The vm-exits that are handled in the fast-path are not recorded
+    //
+    VmexitFastPathUpdate();
+
+    return TRUE;
+}
+
+/**
+ * @brief Sum the statistics of a single core into the result
+ *
+ * @param CoreStatistics
+ * @param Reasons
+ *
+ * @return VOID
+ */
+static VOID
+VmexitStatisticsAccumulate(PVMEXIT_STATISTICS CoreStatistics, PVMEXIT_REASON_STATISTICS Reasons)
+{
+    for (UINT32 i = 0; i < MaximumVmexitStatisticsExitReasons; i++)
+    {
+        Reasons[i].Count += CoreStatistics->Reasons[i].Count;
+        Reasons[i].TotalCycles += CoreStatistics->Reasons[i].TotalCycles;
+
+        if (CoreStatistics->Reasons[i].MaximumCycles > Reasons[i].MaximumCycles)
+        {
+            Reasons[i].MaximumCycles = CoreStatistics->Reasons[i].MaximumCycles;
+        }
+
+        for (UINT32 j = 0; j < VmexitStatisticsHistogramBuckets; j++)
+        {
+            Reasons[i].Histogram[j] += CoreStatistics->Reasons[i].Histogram[j];
+        }
+    }
+}
+
+/**
+ * @brief Enable, disable, reset or query the statistics of vm-exits
+ * @details should be called from vmx non-root (PASSIVE_LEVEL), the
+ * statistics are read while other cores might update them, so the
+ * query is not an atomic snapshot of all of the cores
+ *
+ * @param StatisticsRequest
+ *
+ * @return VOID
+ */
+VOID
+VmexitStatisticsPerformAction(PDEBUGGER_VMEXIT_STATISTICS_REQUEST StatisticsRequest)
+{
+    ULONG CoreCount = KeQueryActiveProcessorCount(0);
+
+    StatisticsRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    switch (StatisticsRequest->Action)
+    {
+    case DEBUGGER_VMEXIT_STATISTICS_ACTION_ENABLE:
+
+        if (!VmexitStatisticsEnable())
+        {
+            StatisticsRequest->KernelStatus = DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_VMEXIT_STATISTICS;
+        }
+
+        break;
+
+    case DEBUGGER_VMEXIT_STATISTICS_ACTION_DISABLE:
+
+        g_VmexitStatisticsEnabled = FALSE;
+
+        VmexitFastPathUpdate();
+
+        break;
+
+    case DEBUGGER_VMEXIT_STATISTICS_ACTION_RESET:
+
+        //
+        // The vm-exits that are being handled while resetting might be
+        // partially counted
+        //
+        if (g_VmexitStatistics != NULL)
+        {
+            RtlZeroMemory(g_VmexitStatistics, sizeof(VMEXIT_STATISTICS) * CoreCount);
+        }
+
+        break;
+
+    case DEBUGGER_VMEXIT_STATISTICS_ACTION_QUERY:
+
+        if (StatisticsRequest->CoreId != DEBUGGER_VMEXIT_STATISTICS_ALL_CORES && StatisticsRequest->CoreId >= CoreCount)
+        {
+            StatisticsRequest->KernelStatus = DEBUGGER_ERROR_INVALID_CORE_ID;
+            break;
+        }
+
+        RtlZeroMemory(StatisticsRequest->Reasons, sizeof(StatisticsRequest->Reasons));
+
+        if (g_VmexitStatistics == NULL)
+        {
+            //
+            // The statistics are never enabled
+            //
+            break;
+        }
+
+        for (UINT32 i = 0; i < CoreCount; i++)
+        {
+            if (StatisticsRequest->CoreId == DEBUGGER_VMEXIT_STATISTICS_ALL_CORES || StatisticsRequest->CoreId == i)
+            {
+                VmexitStatisticsAccumulate(&g_VmexitStatistics[i], StatisticsRequest->Reasons);
+            }
+        }
+
+        break;
+
+    default:
+
+        StatisticsRequest->KernelStatus = DEBUGGER_ERROR_INVALID_ACTION_TYPE;
+
+        break;
+    }
+
+    StatisticsRequest->IsEnabled = g_VmexitStatisticsEnabled;
+}
+
+/**
+ * @brief Free the statistics of vm-exits
+ * @details should be called after VMX is terminated on all cores
+ *
+ * @return VOID
+ */
+VOID
+VmexitStatisticsUninitialize()
+{
+    g_VmexitStatisticsEnabled = FALSE;
+
+    VmexitFastPathUpdate();
+
+    if (g_VmexitStatistics != NULL)
+    {
+        ExFreePoolWithTag(g_VmexitStatistics, POOLTAG);
+        g_VmexitStatistics = NULL;
+    }
+}
@@ -113,14 +113,15 @@ VmxGetCurrentLaunchState()
 BOOLEAN
 VmxInitialize()
 {
-    ULONG LogicalProcessorsCount;
+    UINT64 PhaseCounter;
 
     //
     // ****** Start Virtualizing Current System ******
     //
 
     //
-    // Initiating EPTP and VMX
+    // Initiating EPTP and VMX (the VMM stack and the bitmaps of each core
+    // are allocated along with its VMXON and VMCS regions)
     //
     if (!VmxPerformVirtualizationOnAllCores())
     {
@@ -130,53 +131,11 @@ VmxInitialize()
         return FALSE;
     }
 
-    LogicalProcessorsCount = KeQueryActiveProcessorCount(0);
-
-    for (size_t ProcessorID = 0; ProcessorID < LogicalProcessorsCount; ProcessorID++)
-    {
-        //
-        // *** Launching VM for Test (in the all logical processor) ***
-        //
-
-        VIRTUAL_MACHINE_STATE * GuestState = &g_GuestState[ProcessorID];
-
-        //
-        // Allocating VMM Stack
-        //
-        if (!VmxAllocateVmmStack(GuestState))
-        {
-            //
-            // Some error in allocating Vmm Stack
-            //
-            return FALSE;
-        }
-
-        //
-        // Allocating MSR Bit
-        //
-        if (!VmxAllocateMsrBitmap(GuestState))
-        {
-            //
-            // Some error in allocating Msr Bitmaps
-            //
-            return FALSE;
-        }
-
-        //
-        // Allocating I/O Bit
-        //
-        if (!VmxAllocateIoBitmaps(GuestState))
-        {
-            //
-            // Some error in allocating I/O Bitmaps
-            //
-            return FALSE;
-        }
-    }
-
     //
     // Create a bitmap of the MSRs that cause #GP
     //
+    PhaseCounter = KeQueryPerformanceCounter(NULL).QuadPart;
+
     g_MsrBitmapInvalidMsrs = VmxAllocateInvalidMsrBimap();
 
     if (g_MsrBitmapInvalidMsrs == NULL)
@@ -184,12 +143,18 @@ VmxInitialize()
         return FALSE;
     }
 
+    g_VmmInitializationTimings.InvalidMsrsBitmap = HvGetElapsedMicroseconds(PhaseCounter);
+
     //
     // As we want to support more than 32 processor (64 logical-core)
     // we let windows execute our routine for us
     //
+    PhaseCounter = KeQueryPerformanceCounter(NULL).QuadPart;
+
     KeGenericCallDpc(DpcRoutineInitializeGuest, 0x0);
 
+    g_VmmInitializationTimings.GuestLaunch = HvGetElapsedMicroseconds(PhaseCounter);
+
     //
     // Check if everything is ok then return true otherwise false
     //
@@ -213,6 +178,7 @@ VmxPerformVirtualizationOnAllCores()
 {
     int       ProcessorCount;
     KAFFINITY AffinityMask;
+    UINT64    PhaseCounter;
 
     if (!VmxCheckVmxSupport())
     {
@@ -243,9 +209,16 @@ VmxPerformVirtualizationOnAllCores()
     //
     InitializeListHead(&g_EptState->HookedPagesList);
 
+    //
+    // Initialize the list of split 2MB pages
+    //
+    InitializeListHead(&g_EptState->DynamicSplitsList);
+
     //
     // Check whether EPT is supported or not
     //
+    PhaseCounter = KeQueryPerformanceCounter(NULL).QuadPart;
+
     if (!EptCheckFeatures())
     {
         LogError("Err, your processor doesn't support all EPT features");
@@ -270,15 +243,31 @@ VmxPerformVirtualizationOnAllCores()
         LogDebugInfo("MTRR memory map built successfully");
     }
 
+    //
+    // Build the map of the physical memory (if it's not built, all
+    // of the physical addresses are considered as RAM)
+    //
+    if (!PhysicalMemoryMapInitialize())
+    {
+        LogWarning("Warning, could not build the physical memory map");
+    }
+
+    g_VmmInitializationTimings.EptMemoryMap = HvGetElapsedMicroseconds(PhaseCounter);
+
     //
     // Initialize Pool Manager
     //
+    PhaseCounter = KeQueryPerformanceCounter(NULL).QuadPart;
+
     if (!PoolManagerInitialize())
     {
         LogError("Err, could not initialize pool manager");
         return FALSE;
     }
 
+    g_VmmInitializationTimings.PoolManager = HvGetElapsedMicroseconds(PhaseCounter);
+    PhaseCounter                           = KeQueryPerformanceCounter(NULL).QuadPart;
+
     if (!EptLogicalProcessorInitialize())
     {
         //
@@ -287,10 +276,21 @@ VmxPerformVirtualizationOnAllCores()
         return FALSE;
     }
 
+    g_VmmInitializationTimings.EptPageTables = HvGetElapsedMicroseconds(PhaseCounter);
+
     //
-    // Broadcast to run vmx-specific task to vitualize cores
+    // Broadcast to run vmx-specific task to vitualize cores, all cores
+    // allocate their regions in parallel
     //
-    BroadcastVmxVirtualizationAllCores();
+    PhaseCounter = KeQueryPerformanceCounter(NULL).QuadPart;
+
+    if (!BroadcastVmxVirtualizationAllCores())
+    {
+        LogError("Err, could not allocate the vmx regions of all cores");
+        return FALSE;
+    }
+
+    g_VmmInitializationTimings.PerCoreRegions = HvGetElapsedMicroseconds(PhaseCounter);
 
     //
     // Everything is ok, let's return true
@@ -308,6 +308,9 @@ VmxPerformVirtualizationOnSpecificCore()
 {
     ULONG                   CurrentProcessorNumber = KeGetCurrentProcessorNumber();
     VIRTUAL_MACHINE_STATE * VCpu                   = &g_GuestState[CurrentProcessorNumber];
+    UINT64                  StartCounter           = KeQueryPerformanceCounter(NULL).QuadPart;
+    UINT64                  ElapsedTime;
+    UINT64                  SlowestCore;
 
     LogDebugInfo("Allocating vmx regions for logical core %d", CurrentProcessorNumber);
 
@@ -334,6 +337,51 @@ VmxPerformVirtualizationOnSpecificCore()
         return FALSE;
     }
 
+    //
+    // The VMM stack and the bitmaps are also allocated here (instead of
+    // allocating them for all cores on the initializing core), so all of the
+    // cores allocate their regions in parallel
+    //
+    if (!VmxAllocateVmmStack(VCpu) ||
+        !VmxAllocateMsrBitmap(VCpu) ||
+        !VmxAllocateIoBitmaps(VCpu) ||
+        !BitmapOwnershipAllocate(VCpu) ||
+        !EvmcsAllocateVpAssistPage(VCpu))
+    {
+        return FALSE;
+    }
+
+#if UsePerCoreEptViewsForHookRestoration == TRUE
+
+    //
+    // The view of this core is not mandatory, hooks are restored on the
+    // unhooked view if it's not available
+    //
+    if (!EptAllocateCoreView(VCpu))
+    {
+        LogWarning("Warning, unable to allocate memory for the EPT view of logical core %d", CurrentProcessorNumber);
+    }
+
+#endif
+
+    //
+    // Keep the time of the slowest core
+    //
+    ElapsedTime = HvGetElapsedMicroseconds(StartCounter);
+
+    do
+    {
+        SlowestCore = g_VmmInitializationTimings.SlowestCoreRegions;
+
+        if (ElapsedTime <= SlowestCore)
+        {
+            break;
+        }
+
+    } while (InterlockedCompareExchange64((volatile LONG64 *)&g_VmmInitializationTimings.SlowestCoreRegions,
+                                          ElapsedTime,
+                                          SlowestCore) != SlowestCore);
+
     return TRUE;
 }
 
@@ -384,6 +432,14 @@ VmxCheckIsOnVmxRoot()
 {
     UINT64 VmcsLink = 0;
 
+    //
+    // The enlightened VMCS is memory, so it's readable in vmx non-root too
+    //
+    if (g_EnlightenedVmcsIsActive)
+    {
+        return VmxGetCurrentExecutionMode() == VmxExecutionModeRoot;
+    }
+
     __try
     {
         if (!__vmx_vmread(VMCS_GUEST_VMCS_LINK_POINTER, &VmcsLink))
@@ -417,22 +473,32 @@ VmxVirtualizeCurrentSystem(PVOID GuestStack)
 
     LogDebugInfo("Virtualizing current system (logical core : 0x%x)", ProcessorID);
 
-    //
-    // Clear the VMCS State
-    //
-    if (!VmxClearVmcsState(VCpu))
+    if (g_EnlightenedVmcsIsActive)
     {
-        LogError("Err, failed to clear vmcs");
-        return FALSE;
+        //
+        // Set the enlightened VMCS as the current VMCS (on the VP assist page)
+        //
+        EvmcsLoad(VCpu);
     }
-
-    //
-    // Load VMCS (Set the Current VMCS)
-    //
-    if (!VmxLoadVmcs(VCpu))
+    else
     {
-        LogError("Err, failed to load vmcs");
-        return FALSE;
+        //
+        // Clear the VMCS State
+        //
+        if (!VmxClearVmcsState(VCpu))
+        {
+            LogError("Err, failed to clear vmcs");
+            return FALSE;
+        }
+
+        //
+        // Load VMCS (Set the Current VMCS)
+        //
+        if (!VmxLoadVmcs(VCpu))
+        {
+            LogError("Err, failed to load vmcs");
+            return FALSE;
+        }
     }
 
     LogDebugInfo("Setting up VMCS for current logical core");
@@ -461,13 +527,18 @@ VmxVirtualizeCurrentSystem(PVOID GuestStack)
     //
     // Read error code firstly
     //
-    __vmx_vmread(VMCS_VM_INSTRUCTION_ERROR, &ErrorCode);
+    VmxVmread(VMCS_VM_INSTRUCTION_ERROR, &ErrorCode);
 
     LogError("Err, unable to execute VMLAUNCH, status : 0x%llx", ErrorCode);
 
     //
     // Then Execute Vmxoff
     //
+    if (g_EnlightenedVmcsIsActive)
+    {
+        EvmcsUnload(VCpu);
+    }
+
     __vmx_off();
     LogError("Err, VMXOFF Executed Successfully but it was because of an error");
 
@@ -501,10 +572,19 @@ VmxTerminate()
         //
         MmFreeContiguousMemory(VCpu->VmxonRegionVirtualAddress);
         MmFreeContiguousMemory(VCpu->VmcsRegionVirtualAddress);
-        ExFreePoolWithTag(VCpu->VmmStack, POOLTAG);
-        ExFreePoolWithTag(VCpu->MsrBitmapVirtualAddress, POOLTAG);
-        ExFreePoolWithTag(VCpu->IoBitmapVirtualAddressA, POOLTAG);
-        ExFreePoolWithTag(VCpu->IoBitmapVirtualAddressB, POOLTAG);
+        MmFreeContiguousMemory(VCpu->VmmStack);
+        MmFreeContiguousMemory(VCpu->MsrBitmapVirtualAddress);
+        ExFreePoolWithTag(VCpu->MsrBitmapReferenceCounts, POOLTAG);
+        MmFreeContiguousMemory(VCpu->IoBitmapVirtualAddressA);
+        MmFreeContiguousMemory(VCpu->IoBitmapVirtualAddressB);
+        BitmapOwnershipFree(VCpu);
+        EvmcsFreeVpAssistPage(VCpu);
+
+        if (VCpu->EptCoreView != NULL)
+        {
+            MmFreeContiguousMemory(VCpu->EptCoreView);
+            VCpu->EptCoreView = NULL;
+        }
 
         return TRUE;
     }
@@ -604,35 +684,35 @@ VmxSetupVmcs(VIRTUAL_MACHINE_STATE * VCpu, PVOID GuestStack)
     //
     VmxBasicMsr.AsUInt = __readmsr(IA32_VMX_BASIC);
 
-    __vmx_vmwrite(VMCS_HOST_ES_SELECTOR, AsmGetEs() & 0xF8);
-    __vmx_vmwrite(VMCS_HOST_CS_SELECTOR, AsmGetCs() & 0xF8);
-    __vmx_vmwrite(VMCS_HOST_SS_SELECTOR, AsmGetSs() & 0xF8);
-    __vmx_vmwrite(VMCS_HOST_DS_SELECTOR, AsmGetDs() & 0xF8);
-    __vmx_vmwrite(VMCS_HOST_FS_SELECTOR, AsmGetFs() & 0xF8);
-    __vmx_vmwrite(VMCS_HOST_GS_SELECTOR, AsmGetGs() & 0xF8);
-    __vmx_vmwrite(VMCS_HOST_TR_SELECTOR, AsmGetTr() & 0xF8);
+    VmxVmwrite(VMCS_HOST_ES_SELECTOR, AsmGetEs() & 0xF8);
+    VmxVmwrite(VMCS_HOST_CS_SELECTOR, AsmGetCs() & 0xF8);
+    VmxVmwrite(VMCS_HOST_SS_SELECTOR, AsmGetSs() & 0xF8);
+    VmxVmwrite(VMCS_HOST_DS_SELECTOR, AsmGetDs() & 0xF8);
+    VmxVmwrite(VMCS_HOST_FS_SELECTOR, AsmGetFs() & 0xF8);
+    VmxVmwrite(VMCS_HOST_GS_SELECTOR, AsmGetGs() & 0xF8);
+    VmxVmwrite(VMCS_HOST_TR_SELECTOR, AsmGetTr() & 0xF8);
 
     //
     // Setting the link pointer to the required value for 4KB VMCS
     //
-    __vmx_vmwrite(VMCS_GUEST_VMCS_LINK_POINTER, ~0ULL);
+    VmxVmwrite(VMCS_GUEST_VMCS_LINK_POINTER, ~0ULL);
 
-    __vmx_vmwrite(VMCS_GUEST_DEBUGCTL, __readmsr(IA32_DEBUGCTL) & 0xFFFFFFFF);
-    __vmx_vmwrite(VMCS_GUEST_DEBUGCTL_HIGH, __readmsr(IA32_DEBUGCTL) >> 32);
+    VmxVmwrite(VMCS_GUEST_DEBUGCTL, __readmsr(IA32_DEBUGCTL) & 0xFFFFFFFF);
+    VmxVmwrite(VMCS_GUEST_DEBUGCTL_HIGH, __readmsr(IA32_DEBUGCTL) >> 32);
 
     //
     // ******* Time-stamp counter offset *******
     //
-    __vmx_vmwrite(VMCS_CTRL_TSC_OFFSET, 0);
+    VmxVmwrite(VMCS_CTRL_TSC_OFFSET, 0);
 
-    __vmx_vmwrite(VMCS_CTRL_PAGEFAULT_ERROR_CODE_MASK, 0);
-    __vmx_vmwrite(VMCS_CTRL_PAGEFAULT_ERROR_CODE_MATCH, 0);
+    VmxVmwrite(VMCS_CTRL_PAGEFAULT_ERROR_CODE_MASK, 0);
+    VmxVmwrite(VMCS_CTRL_PAGEFAULT_ERROR_CODE_MATCH, 0);
 
-    __vmx_vmwrite(VMCS_CTRL_VMEXIT_MSR_STORE_COUNT, 0);
-    __vmx_vmwrite(VMCS_CTRL_VMEXIT_MSR_LOAD_COUNT, 0);
+    VmxVmwrite(VMCS_CTRL_VMEXIT_MSR_STORE_COUNT, 0);
+    VmxVmwrite(VMCS_CTRL_VMEXIT_MSR_LOAD_COUNT, 0);
 
-    __vmx_vmwrite(VMCS_CTRL_VMENTRY_MSR_LOAD_COUNT, 0);
-    __vmx_vmwrite(VMCS_CTRL_VMENTRY_INTERRUPTION_INFORMATION_FIELD, 0);
+    VmxVmwrite(VMCS_CTRL_VMENTRY_MSR_LOAD_COUNT, 0);
+    VmxVmwrite(VMCS_CTRL_VMENTRY_INTERRUPTION_INFORMATION_FIELD, 0);
 
     GdtBase = AsmGetGdtBase();
 
@@ -645,13 +725,13 @@ VmxSetupVmcs(VIRTUAL_MACHINE_STATE * VCpu, PVOID GuestStack)
     HvFillGuestSelectorData((PVOID)GdtBase, LDTR, AsmGetLdtr());
     HvFillGuestSelectorData((PVOID)GdtBase, TR, AsmGetTr());
 
-    __vmx_vmwrite(VMCS_GUEST_FS_BASE, __readmsr(IA32_FS_BASE));
-    __vmx_vmwrite(VMCS_GUEST_GS_BASE, __readmsr(IA32_GS_BASE));
+    VmxVmwrite(VMCS_GUEST_FS_BASE, __readmsr(IA32_FS_BASE));
+    VmxVmwrite(VMCS_GUEST_GS_BASE, __readmsr(IA32_GS_BASE));
 
     CpuBasedVmExecControls = HvAdjustControls(CPU_BASED_ACTIVATE_IO_BITMAP | CPU_BASED_ACTIVATE_MSR_BITMAP | CPU_BASED_ACTIVATE_SECONDARY_CONTROLS,
                                               VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_PROCBASED_CTLS : IA32_VMX_PROCBASED_CTLS);
 
-    __vmx_vmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
+    VmxVmwrite(VMCS_CTRL_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, CpuBasedVmExecControls);
 
     LogDebugInfo("CPU Based VM Exec Controls (Based on %s) : 0x%x",
                  VmxBasicMsr.VmxControls ? "IA32_VMX_TRUE_PROCBASED_CTLS" : "IA32_VMX_PROCBASED_CTLS",
@@ -660,78 +740,78 @@ VmxSetupVmcs(VIRTUAL_MACHINE_STATE * VCpu, PVOID GuestStack)
     SecondaryProcBasedVmExecControls = HvAdjustControls(CPU_BASED_CTL2_RDTSCP | CPU_BASED_CTL2_ENABLE_EPT | CPU_BASED_CTL2_ENABLE_INVPCID | CPU_BASED_CTL2_ENABLE_XSAVE_XRSTORS | CPU_BASED_CTL2_ENABLE_VPID,
                                                         IA32_VMX_PROCBASED_CTLS2);
 
-    __vmx_vmwrite(VMCS_CTRL_SECONDARY_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, SecondaryProcBasedVmExecControls);
+    VmxVmwrite(VMCS_CTRL_SECONDARY_PROCESSOR_BASED_VM_EXECUTION_CONTROLS, SecondaryProcBasedVmExecControls);
 
     LogDebugInfo("Secondary Proc Based VM Exec Controls (IA32_VMX_PROCBASED_CTLS2) : 0x%x", SecondaryProcBasedVmExecControls);
 
-    __vmx_vmwrite(VMCS_CTRL_PIN_BASED_VM_EXECUTION_CONTROLS, HvAdjustControls(0, VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_PINBASED_CTLS : IA32_VMX_PINBASED_CTLS));
+    VmxVmwrite(VMCS_CTRL_PIN_BASED_VM_EXECUTION_CONTROLS, HvAdjustControls(0, VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_PINBASED_CTLS : IA32_VMX_PINBASED_CTLS));
 
-    __vmx_vmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, HvAdjustControls(VM_EXIT_HOST_ADDR_SPACE_SIZE, VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_EXIT_CTLS : IA32_VMX_EXIT_CTLS));
+    VmxVmwrite(VMCS_CTRL_PRIMARY_VMEXIT_CONTROLS, HvAdjustControls(VM_EXIT_HOST_ADDR_SPACE_SIZE, VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_EXIT_CTLS : IA32_VMX_EXIT_CTLS));
 
-    __vmx_vmwrite(VMCS_CTRL_VMENTRY_CONTROLS, HvAdjustControls(VM_ENTRY_IA32E_MODE, VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_ENTRY_CTLS : IA32_VMX_ENTRY_CTLS));
+    VmxVmwrite(VMCS_CTRL_VMENTRY_CONTROLS, HvAdjustControls(VM_ENTRY_IA32E_MODE, VmxBasicMsr.VmxControls ? IA32_VMX_TRUE_ENTRY_CTLS : IA32_VMX_ENTRY_CTLS));
 
-    __vmx_vmwrite(VMCS_CTRL_CR0_GUEST_HOST_MASK, 0);
-    __vmx_vmwrite(VMCS_CTRL_CR4_GUEST_HOST_MASK, 0);
+    VmxVmwrite(VMCS_CTRL_CR0_GUEST_HOST_MASK, 0);
+    VmxVmwrite(VMCS_CTRL_CR4_GUEST_HOST_MASK, 0);
 
-    __vmx_vmwrite(VMCS_CTRL_CR0_READ_SHADOW, 0);
-    __vmx_vmwrite(VMCS_CTRL_CR4_READ_SHADOW, 0);
+    VmxVmwrite(VMCS_CTRL_CR0_READ_SHADOW, 0);
+    VmxVmwrite(VMCS_CTRL_CR4_READ_SHADOW, 0);
 
-    __vmx_vmwrite(VMCS_GUEST_CR0, __readcr0());
-    __vmx_vmwrite(VMCS_GUEST_CR3, __readcr3());
-    __vmx_vmwrite(VMCS_GUEST_CR4, __readcr4());
+    VmxVmwrite(VMCS_GUEST_CR0, __readcr0());
+    VmxVmwrite(VMCS_GUEST_CR3, __readcr3());
+    VmxVmwrite(VMCS_GUEST_CR4, __readcr4());
 
-    __vmx_vmwrite(VMCS_GUEST_DR7, 0x400);
+    VmxVmwrite(VMCS_GUEST_DR7, 0x400);
 
-    __vmx_vmwrite(VMCS_HOST_CR0, __readcr0());
-    __vmx_vmwrite(VMCS_HOST_CR4, __readcr4());
+    VmxVmwrite(VMCS_HOST_CR0, __readcr0());
+    VmxVmwrite(VMCS_HOST_CR4, __readcr4());
 
     //
     // Because we may be executing in an arbitrary user-mode, process as part
     // of the DPC interrupt we execute in We have to save Cr3, for VMCS_HOST_CR3
     //
 
-    __vmx_vmwrite(VMCS_HOST_CR3, LayoutGetSystemDirectoryTableBase());
+    VmxVmwrite(VMCS_HOST_CR3, LayoutGetSystemDirectoryTableBase());
 
-    __vmx_vmwrite(VMCS_GUEST_GDTR_BASE, AsmGetGdtBase());
-    __vmx_vmwrite(VMCS_GUEST_IDTR_BASE, AsmGetIdtBase());
+    VmxVmwrite(VMCS_GUEST_GDTR_BASE, AsmGetGdtBase());
+    VmxVmwrite(VMCS_GUEST_IDTR_BASE, AsmGetIdtBase());
 
-    __vmx_vmwrite(VMCS_GUEST_GDTR_LIMIT, AsmGetGdtLimit());
-    __vmx_vmwrite(VMCS_GUEST_IDTR_LIMIT, AsmGetIdtLimit());
+    VmxVmwrite(VMCS_GUEST_GDTR_LIMIT, AsmGetGdtLimit());
+    VmxVmwrite(VMCS_GUEST_IDTR_LIMIT, AsmGetIdtLimit());
 
-    __vmx_vmwrite(VMCS_GUEST_RFLAGS, AsmGetRflags());
+    VmxVmwrite(VMCS_GUEST_RFLAGS, AsmGetRflags());
 
-    __vmx_vmwrite(VMCS_GUEST_SYSENTER_CS, __readmsr(IA32_SYSENTER_CS));
-    __vmx_vmwrite(VMCS_GUEST_SYSENTER_EIP, __readmsr(IA32_SYSENTER_EIP));
-    __vmx_vmwrite(VMCS_GUEST_SYSENTER_ESP, __readmsr(IA32_SYSENTER_ESP));
+    VmxVmwrite(VMCS_GUEST_SYSENTER_CS, __readmsr(IA32_SYSENTER_CS));
+    VmxVmwrite(VMCS_GUEST_SYSENTER_EIP, __readmsr(IA32_SYSENTER_EIP));
+    VmxVmwrite(VMCS_GUEST_SYSENTER_ESP, __readmsr(IA32_SYSENTER_ESP));
 
     VmxGetSegmentDescriptor((PUCHAR)AsmGetGdtBase(), AsmGetTr(), &SegmentSelector);
-    __vmx_vmwrite(VMCS_HOST_TR_BASE, SegmentSelector.Base);
+    VmxVmwrite(VMCS_HOST_TR_BASE, SegmentSelector.Base);
 
-    __vmx_vmwrite(VMCS_HOST_FS_BASE, __readmsr(IA32_FS_BASE));
-    __vmx_vmwrite(VMCS_HOST_GS_BASE, __readmsr(IA32_GS_BASE));
+    VmxVmwrite(VMCS_HOST_FS_BASE, __readmsr(IA32_FS_BASE));
+    VmxVmwrite(VMCS_HOST_GS_BASE, __readmsr(IA32_GS_BASE));
 
-    __vmx_vmwrite(VMCS_HOST_GDTR_BASE, AsmGetGdtBase());
-    __vmx_vmwrite(VMCS_HOST_IDTR_BASE, AsmGetIdtBase());
+    VmxVmwrite(VMCS_HOST_GDTR_BASE, AsmGetGdtBase());
+    VmxVmwrite(VMCS_HOST_IDTR_BASE, AsmGetIdtBase());
 
-    __vmx_vmwrite(VMCS_HOST_SYSENTER_CS, __readmsr(IA32_SYSENTER_CS));
-    __vmx_vmwrite(VMCS_HOST_SYSENTER_EIP, __readmsr(IA32_SYSENTER_EIP));
-    __vmx_vmwrite(VMCS_HOST_SYSENTER_ESP, __readmsr(IA32_SYSENTER_ESP));
+    VmxVmwrite(VMCS_HOST_SYSENTER_CS, __readmsr(IA32_SYSENTER_CS));
+    VmxVmwrite(VMCS_HOST_SYSENTER_EIP, __readmsr(IA32_SYSENTER_EIP));
+    VmxVmwrite(VMCS_HOST_SYSENTER_ESP, __readmsr(IA32_SYSENTER_ESP));
 
     //
     // Set MSR Bitmaps
     //
-    __vmx_vmwrite(VMCS_CTRL_MSR_BITMAP_ADDRESS, VCpu->MsrBitmapPhysicalAddress);
+    VmxVmwrite(VMCS_CTRL_MSR_BITMAP_ADDRESS, VCpu->MsrBitmapPhysicalAddress);
 
     //
     // Set I/O Bitmaps
     //
-    __vmx_vmwrite(VMCS_CTRL_IO_BITMAP_A_ADDRESS, VCpu->IoBitmapPhysicalAddressA);
-    __vmx_vmwrite(VMCS_CTRL_IO_BITMAP_B_ADDRESS, VCpu->IoBitmapPhysicalAddressB);
+    VmxVmwrite(VMCS_CTRL_IO_BITMAP_A_ADDRESS, VCpu->IoBitmapPhysicalAddressA);
+    VmxVmwrite(VMCS_CTRL_IO_BITMAP_B_ADDRESS, VCpu->IoBitmapPhysicalAddressB);
 
     //
     // Set up EPT
     //
-    __vmx_vmwrite(VMCS_CTRL_EPT_POINTER, g_EptState->EptPointer.AsUInt);
+    VmxVmwrite(VMCS_CTRL_EPT_POINTER, g_EptState->EptPointer.AsUInt);
 
     //
     // Set up VPID
@@ -740,17 +820,17 @@ VmxSetupVmcs(VIRTUAL_MACHINE_STATE * VCpu, PVOID GuestStack)
     // For all processors, we will use a VPID = 1. This allows the processor to separate caching
     //  of EPT structures away from the regular OS page translation tables in the TLB.
     //
-    __vmx_vmwrite(VIRTUAL_PROCESSOR_ID, VPID_TAG);
+    VmxVmwrite(VIRTUAL_PROCESSOR_ID, VPID_TAG);
 
     //
     // setup guest rsp
     //
-    __vmx_vmwrite(VMCS_GUEST_RSP, (UINT64)GuestStack);
+    VmxVmwrite(VMCS_GUEST_RSP, (UINT64)GuestStack);
 
     //
     // setup guest rip
     //
-    __vmx_vmwrite(VMCS_GUEST_RIP, (UINT64)AsmVmxRestoreState);
+    VmxVmwrite(VMCS_GUEST_RIP, (UINT64)AsmVmxRestoreState);
 
     //
     // Stack should be aligned to 16 because we wanna save XMM and FPU registers and those instructions
@@ -758,8 +838,8 @@ VmxSetupVmcs(VIRTUAL_MACHINE_STATE * VCpu, PVOID GuestStack)
     //
     HostRsp = (UINT64)VCpu->VmmStack + VMM_STACK_SIZE - 1;
     HostRsp = ((PVOID)((ULONG_PTR)(HostRsp) & ~(16 - 1)));
-    __vmx_vmwrite(VMCS_HOST_RSP, HostRsp);
-    __vmx_vmwrite(VMCS_HOST_RIP, (UINT64)AsmVmexitHandler);
+    VmxVmwrite(VMCS_HOST_RSP, HostRsp);
+    VmxVmwrite(VMCS_HOST_RIP, (UINT64)AsmVmexitHandler);
 
     return TRUE;
 }
@@ -780,7 +860,7 @@ VmxVmresume()
     // if VMRESUME succeed will never be here !
     //
 
-    __vmx_vmread(VMCS_VM_INSTRUCTION_ERROR, &ErrorCode);
+    VmxVmread(VMCS_VM_INSTRUCTION_ERROR, &ErrorCode);
     __vmx_off();
 
     //
@@ -869,19 +949,19 @@ VmxVmxoff(VIRTUAL_MACHINE_STATE * VCpu)
     //  	process continues to run with its expected address space mappings.
     //
 
-    __vmx_vmread(VMCS_GUEST_CR3, &GuestCr3);
+    VmxVmread(VMCS_GUEST_CR3, &GuestCr3);
     __writecr3(GuestCr3);
 
     //
     // Read guest rsp and rip
     //
-    __vmx_vmread(VMCS_GUEST_RIP, &GuestRIP);
-    __vmx_vmread(VMCS_GUEST_RSP, &GuestRSP);
+    VmxVmread(VMCS_GUEST_RIP, &GuestRIP);
+    VmxVmread(VMCS_GUEST_RSP, &GuestRSP);
 
     //
     // Read instruction length
     //
-    __vmx_vmread(VMCS_VMEXIT_INSTRUCTION_LENGTH, &ExitInstructionLength);
+    VmxVmread(VMCS_VMEXIT_INSTRUCTION_LENGTH, &ExitInstructionLength);
     GuestRIP += ExitInstructionLength;
 
     //
@@ -895,6 +975,11 @@ VmxVmxoff(VIRTUAL_MACHINE_STATE * VCpu)
     //
     VCpu->VmxoffState.IsVmxoffExecuted = TRUE;
 
+    //
+    // Give the LBRs back to the guest (if they're recorded)
+    //
+    LbrPerformActionOnCore(VCpu, FALSE);
+
     //
     // Restore the previous FS, GS , GDTR and IDTR register as patchguard might find the modified
     //
@@ -904,7 +989,14 @@ VmxVmxoff(VIRTUAL_MACHINE_STATE * VCpu)
     // Before using vmxoff, you first need to use vmclear on any VMCSes that you want to be able to use again.
     // See sections 24.1 and 24.11 of the SDM.
     //
-    VmxClearVmcsState(VCpu);
+    if (g_EnlightenedVmcsIsActive)
+    {
+        EvmcsUnload(VCpu);
+    }
+    else
+    {
+        VmxClearVmcsState(VCpu);
+    }
 
     //
     // Execute Vmxoff
@@ -968,6 +1060,11 @@ VmxPerformTermination()
     //
     EptHookUnHookAll();
 
+    //
+    // Stop the PEBS sampling, so the guest's performance counters are restored
+    //
+    PebsSamplingUninitialize();
+
     //
     // Broadcast to terminate Vmx
     //
@@ -1004,6 +1101,14 @@ VmxPerformTermination()
         MmFreeContiguousMemory(g_EptState->ExecuteOnlyEptPageTable);
     }
 
+    //
+    // Free Identity Page Table of the unhooked view
+    //
+    if (g_EptState->UnhookedEptPageTable != NULL)
+    {
+        MmFreeContiguousMemory(g_EptState->UnhookedEptPageTable);
+    }
+
     //
     // Free EptState
     //
@@ -1015,11 +1120,41 @@ VmxPerformTermination()
     //
     PoolManagerUninitialize();
 
+    //
+    // Free the physical memory map
+    //
+    PhysicalMemoryMapUninitialize();
+
+    //
+    // Free the index of reverse mappings
+    //
+    ReverseMappingUninitialize();
+
     //
     // Uninitialize memory mapper
     //
     MemoryMapperUninitialize();
 
+    //
+    // Free the statistics of vm-exits
+    //
+    VmexitStatisticsUninitialize();
+
+    //
+    // Free the buffers of the sampling profiler
+    //
+    SamplingProfilerUninitialize();
+
+    //
+    // Free the bitmaps of the dirty pages
+    //
+    DirtyLoggingFreeBitmaps();
+
+    //
+    // Free the buffers of the trace of Intel PT
+    //
+    IntelPtUninitialize();
+
     //
     // Free g_GuestState
     //
@@ -108,6 +108,15 @@ VmxBroadcastHandleNmiCallback(PVOID Context, BOOLEAN Handled)
     //
     if (!VmxBroadcastNmiHandler(VCpu, TRUE))
     {
+        //
+        // The overflow of the counter of the retired instructions is handled
+        // on the next vm-exit (or the expiration of the VMX preemption timer)
+        //
+        if (InstructionCounterCheckNmi(VCpu))
+        {
+            return TRUE;
+        }
+
         return Handled;
     }
     else
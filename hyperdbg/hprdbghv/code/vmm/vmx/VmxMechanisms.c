@@ -41,12 +41,12 @@ VmxMechanismCreateImmediateVmexitByVmxPreemptionTimer()
 VOID
 VmxMechanismDisableImmediateVmexitByVmxPreemptionTimer()
 {
-    CounterClearPreemptionTimer();
-
     //
-    // Disable the VMX preemption timer on pin-based controls
+    // Disable the VMX preemption timer on pin-based controls (unless the
+    // timer is requested by the sampling profiler or the pending updates
+    // of VMCS controls)
     //
-    HvSetVmxPreemptionTimerExiting(FALSE);
+    CounterUpdatePreemptionTimer();
 }
 
 /**
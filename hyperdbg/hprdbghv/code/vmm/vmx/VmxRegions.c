@@ -42,7 +42,7 @@ VmxAllocateVmxonRegion(VIRTUAL_MACHINE_STATE * VCpu)
     // Allocating a 4-KByte Contigous Memory region
     //
     VmxonSize   = 2 * VMXON_SIZE;
-    VmxonRegion = CrsAllocateContiguousZeroedMemory(VmxonSize + ALIGNMENT_PAGE_SIZE);
+    VmxonRegion = CrsAllocateContiguousZeroedMemoryOnCore(VmxonSize + ALIGNMENT_PAGE_SIZE, VCpu->CoreId);
     if (VmxonRegion == NULL)
     {
         LogError("Err, couldn't allocate buffer for VMXON region");
@@ -121,7 +121,7 @@ VmxAllocateVmcsRegion(VIRTUAL_MACHINE_STATE * VCpu)
     // Allocating a 4-KByte Contigous Memory region
     //
     VmcsSize   = 2 * VMCS_SIZE;
-    VmcsRegion = CrsAllocateContiguousZeroedMemory(VmcsSize + ALIGNMENT_PAGE_SIZE);
+    VmcsRegion = CrsAllocateContiguousZeroedMemoryOnCore(VmcsSize + ALIGNMENT_PAGE_SIZE, VCpu->CoreId);
     if (VmcsRegion == NULL)
     {
         LogError("Err, couldn't allocate Buffer for VMCS region");
@@ -167,17 +167,16 @@ BOOLEAN
 VmxAllocateVmmStack(_Inout_ VIRTUAL_MACHINE_STATE * VCpu)
 {
     //
-    // Allocate stack for the VM Exit Handler
+    // Allocate stack for the VM Exit Handler (from the memory that is local
+    // to the core as it's used in all of the vm-exits)
     //
-    VCpu->VmmStack = ExAllocatePoolWithTag(NonPagedPool, VMM_STACK_SIZE, POOLTAG);
+    VCpu->VmmStack = CrsAllocateContiguousZeroedMemoryOnCore(VMM_STACK_SIZE, VCpu->CoreId);
     if (VCpu->VmmStack == NULL)
     {
         LogError("Err, insufficient memory in allocationg vmm stack");
         return FALSE;
     }
 
-    RtlZeroMemory(VCpu->VmmStack, VMM_STACK_SIZE);
-
     LogDebugInfo("VMM Stack for logical processor : 0x%llx", VCpu->VmmStack);
 
     return TRUE;
@@ -196,16 +195,28 @@ VmxAllocateMsrBitmap(_Inout_ VIRTUAL_MACHINE_STATE * VCpu)
     // Allocate memory for MSR Bitmap
     // Should be aligned
     //
-    VCpu->MsrBitmapVirtualAddress = ExAllocatePoolWithTag(NonPagedPool, PAGE_SIZE, POOLTAG);
+    VCpu->MsrBitmapVirtualAddress = CrsAllocateContiguousZeroedMemoryOnCore(PAGE_SIZE, VCpu->CoreId);
     if (VCpu->MsrBitmapVirtualAddress == NULL)
     {
         LogError("Err, insufficient memory in allocationg MSR Bitmaps");
         return FALSE;
     }
-
-    RtlZeroMemory(VCpu->MsrBitmapVirtualAddress, PAGE_SIZE);
     VCpu->MsrBitmapPhysicalAddress = VirtualAddressToPhysicalAddress(VCpu->MsrBitmapVirtualAddress);
 
+    //
+    // Allocate memory for the reference counts of the bits of MSR Bitmap
+    //
+    VCpu->MsrBitmapReferenceCounts = ExAllocatePoolWithTag(NonPagedPool, MSR_BITMAP_BITS_COUNT * sizeof(UINT16), POOLTAG);
+    if (VCpu->MsrBitmapReferenceCounts == NULL)
+    {
+        LogError("Err, insufficient memory in allocationg reference counts of MSR Bitmaps");
+        return FALSE;
+    }
+
+    RtlZeroMemory(VCpu->MsrBitmapReferenceCounts, MSR_BITMAP_BITS_COUNT * sizeof(UINT16));
+    VCpu->MsrBitmapReadAllReferenceCount  = 0;
+    VCpu->MsrBitmapWriteAllReferenceCount = 0;
+
     LogDebugInfo("MSR Bitmap virtual address  : 0x%llx", VCpu->MsrBitmapVirtualAddress);
     LogDebugInfo("MSR Bitmap physical address : 0x%llx", VCpu->MsrBitmapPhysicalAddress);
 
@@ -224,14 +235,12 @@ VmxAllocateIoBitmaps(_Inout_ VIRTUAL_MACHINE_STATE * VCpu)
     //
     // Allocate memory for I/O Bitmap (A)
     //
-    VCpu->IoBitmapVirtualAddressA = ExAllocatePoolWithTag(NonPagedPool, PAGE_SIZE, POOLTAG); // should be aligned
+    VCpu->IoBitmapVirtualAddressA = CrsAllocateContiguousZeroedMemoryOnCore(PAGE_SIZE, VCpu->CoreId); // should be aligned
     if (VCpu->IoBitmapVirtualAddressA == NULL)
     {
         LogError("Err, insufficient memory in allocationg I/O Bitmaps A");
         return FALSE;
     }
-
-    RtlZeroMemory(VCpu->IoBitmapVirtualAddressA, PAGE_SIZE);
     VCpu->IoBitmapPhysicalAddressA = VirtualAddressToPhysicalAddress(VCpu->IoBitmapVirtualAddressA);
 
     LogDebugInfo("I/O Bitmap A Virtual Address  : 0x%llx", VCpu->IoBitmapVirtualAddressA);
@@ -240,14 +249,12 @@ VmxAllocateIoBitmaps(_Inout_ VIRTUAL_MACHINE_STATE * VCpu)
     //
     // Allocate memory for I/O Bitmap (B)
     //
-    VCpu->IoBitmapVirtualAddressB = ExAllocatePoolWithTag(NonPagedPool, PAGE_SIZE, POOLTAG); // should be aligned
+    VCpu->IoBitmapVirtualAddressB = CrsAllocateContiguousZeroedMemoryOnCore(PAGE_SIZE, VCpu->CoreId); // should be aligned
     if (VCpu->IoBitmapVirtualAddressB == NULL)
     {
         LogError("Err, insufficient memory in allocationg I/O Bitmaps B");
         return FALSE;
     }
-
-    RtlZeroMemory(VCpu->IoBitmapVirtualAddressB, PAGE_SIZE);
     VCpu->IoBitmapPhysicalAddressB = VirtualAddressToPhysicalAddress(VCpu->IoBitmapVirtualAddressB);
 
     LogDebugInfo("I/O Bitmap B virtual address  : 0x%llx", VCpu->IoBitmapVirtualAddressB);
@@ -15,7 +15,7 @@
 //		  Internal Broadcast Functions			//
 //////////////////////////////////////////////////
 
-VOID
+BOOLEAN
 BroadcastVmxVirtualizationAllCores();
 
 VOID
@@ -33,8 +33,23 @@ BroadcastEnablePmlOnAllProcessors();
 VOID
 BroadcastDisablePmlOnAllProcessors();
 
+VOID
+BroadcastFlushPmlBuffersOnAllProcessors(UINT32 BitmapIndex);
+
+VOID
+BroadcastConfigureIntelPtOnAllProcessors(UINT32 Action);
+
+VOID
+BroadcastConfigurePebsSamplingOnAllProcessors(UINT32 Action);
+
 VOID
 BroadcastChangeToMbecSupportedEptpOnAllProcessors();
 
 VOID
 BroadcastRestoreToNormalEptpOnAllProcessors();
+
+VOID
+BroadcastEnableModeBasedExecutionControlOnAllProcessors();
+
+VOID
+BroadcastDisableModeBasedExecutionControlOnAllProcessors();
@@ -15,27 +15,154 @@
 //				      typedefs         			 //
 //////////////////////////////////////////////////
 
-typedef EPT_PML4E   EPT_PML4_POINTER, *PEPT_PML4_POINTER;
-typedef EPT_PDPTE   EPT_PML3_POINTER, *PEPT_PML3_POINTER;
-typedef EPT_PDE_2MB EPT_PML2_ENTRY, *PEPT_PML2_ENTRY;
-typedef EPT_PDE     EPT_PML2_POINTER, *PEPT_PML2_POINTER;
-typedef EPT_PTE     EPT_PML1_ENTRY, *PEPT_PML1_ENTRY;
+typedef EPT_PML4E     EPT_PML4_POINTER, *PEPT_PML4_POINTER;
+typedef EPT_PDPTE     EPT_PML3_POINTER, *PEPT_PML3_POINTER;
+typedef EPT_PDPTE_1GB EPT_PML3_ENTRY, *PEPT_PML3_ENTRY;
+typedef EPT_PDE_2MB   EPT_PML2_ENTRY, *PEPT_PML2_ENTRY;
+typedef EPT_PDE       EPT_PML2_POINTER, *PEPT_PML2_POINTER;
+typedef EPT_PTE       EPT_PML1_ENTRY, *PEPT_PML1_ENTRY;
 
 //////////////////////////////////////////////////
 //				    Constants					//
 //////////////////////////////////////////////////
 
 /**
- * @brief Pending External Interrups Buffer Capacity
+ * @brief Count of the 64-bit entries of the bitmap of pending external
+ * interrupts (a bit for each of the 256 vectors)
  *
  */
-#define PENDING_INTERRUPTS_BUFFER_CAPACITY 64
+#define PENDING_INTERRUPTS_BITMAP_CAPACITY (256 / 64)
 
 /**
- * @brief Maximum number of hidden breakpoints in a page
+ * @brief Count of hidden breakpoints that are saved in the hooked page detail itself
+ * @details pages with more breakpoints use a set that is allocated from the pool manager
  *
  */
-#define MaximumHiddenBreakpointsOnPage 40
+#define HIDDEN_BREAKPOINTS_INLINE_CAPACITY 8
+
+/**
+ * @brief Capacity of the sets of hidden breakpoints that are allocated from the pool manager
+ * @details each byte of the page might have a breakpoint, so the set never gets full
+ *
+ */
+#define HIDDEN_BREAKPOINTS_SET_CAPACITY PAGE_SIZE
+
+/**
+ * @brief Maximum number of hidden breakpoints on the same address
+ *
+ */
+#define MaximumHiddenBreakpointsOnSameAddress MAXUCHAR
+
+/**
+ * @brief Count of entries of the per-core cache of translated guest addresses
+ * @details should be a power of two
+ *
+ */
+#define ADDRESS_TRANSLATION_CACHE_ENTRIES 64
+
+/**
+ * @brief Count of entries of the per-core cache of the lengths of instructions
+ * @details should be a power of two
+ *
+ */
+#define INSTRUCTION_LENGTH_CACHE_ENTRIES 64
+
+/**
+ * @brief Count of the static CPUID leaves that are cached on each core
+ * (0, 80000000H and the brand string)
+ *
+ */
+#define CPUID_CACHE_ENTRIES 5
+
+/**
+ * @brief Count of entries of the per-core cache of the processes that
+ * are checked in the transparent-mode
+ * @details should be a power of two
+ *
+ */
+#define TRANSPARENCY_PROCESS_CACHE_ENTRIES 64
+
+/**
+ * @brief Count of the I/O ports (I/O Bitmap A and B)
+ *
+ */
+#define BITMAP_OWNERSHIP_IO_PORTS_COUNT 0x10000
+
+/**
+ * @brief Count of the vectors of the exception bitmap
+ *
+ */
+#define BITMAP_OWNERSHIP_EXCEPTIONS_COUNT 32
+
+/**
+ * @brief Count of the bits of the guest/host masks of CR0 and CR4
+ *
+ */
+#define BITMAP_OWNERSHIP_CONTROL_REGISTER_BITS_COUNT 64
+
+/**
+ * @brief The pending update of rdtsc/rdtscp exiting
+ *
+ */
+#define VMCS_PENDING_UPDATE_RDTSC_EXITING 0x1
+
+/**
+ * @brief The pending update of NMI exiting
+ *
+ */
+#define VMCS_PENDING_UPDATE_NMI_EXITING 0x2
+
+/**
+ * @brief The pending update of the exception bitmap
+ *
+ */
+#define VMCS_PENDING_UPDATE_EXCEPTION_BITMAP 0x4
+
+/**
+ * @brief The pending update of recording the last branches (LBR)
+ *
+ */
+#define VMCS_PENDING_UPDATE_LAST_BRANCH_RECORDS 0x8
+
+/**
+ * @brief The pending update of compensating the time of vmx-root by
+ * the TSC offset (transparent-mode)
+ *
+ */
+#define VMCS_PENDING_UPDATE_TSC_OFFSETTING 0x10
+
+/**
+ * @brief The pending invalidation of the EPT caches (the EPT is changed
+ * by another core in vmx-root)
+ *
+ */
+#define VMCS_PENDING_UPDATE_INVALIDATE_EPT 0x20
+
+/**
+ * @brief The pending tasks of the debugger on the core (e.g., the controls
+ * of the events that are enabled or disabled from vmx-root)
+ *
+ */
+#define VMCS_PENDING_UPDATE_DEBUGGER_TASKS 0x40
+
+/**
+ * @brief Indexes of the fields of VMCS that are cached in each vm-exit
+ * @details the fields from VMCS_FIELD_CACHE_READ_ONLY_FIELDS_BASE are
+ * read-only (the information of the vm-exit) and never written
+ *
+ */
+#define VMCS_FIELD_CACHE_GUEST_RIP               0
+#define VMCS_FIELD_CACHE_GUEST_RSP               1
+#define VMCS_FIELD_CACHE_GUEST_RFLAGS            2
+#define VMCS_FIELD_CACHE_GUEST_CS_SELECTOR       3
+#define VMCS_FIELD_CACHE_GUEST_INTERRUPTIBILITY  4
+#define VMCS_FIELD_CACHE_GUEST_CR3               5
+#define VMCS_FIELD_CACHE_EXIT_REASON             6
+#define VMCS_FIELD_CACHE_EXIT_QUALIFICATION      7
+#define VMCS_FIELD_CACHE_EXIT_INSTRUCTION_LENGTH 8
+#define VMCS_FIELD_CACHE_EXIT_INTERRUPTION_INFO  9
+#define VMCS_FIELD_CACHE_READ_ONLY_FIELDS_BASE   VMCS_FIELD_CACHE_EXIT_REASON
+#define VMCS_FIELD_CACHE_ENTRIES                 10
 
 //////////////////////////////////////////////////
 //					  Enums		    			//
@@ -59,6 +186,21 @@ typedef enum _NMI_BROADCAST_ACTION_TYPE
 //					  Structure	    			//
 //////////////////////////////////////////////////
 
+/**
+ * @brief Whether the name of a process is on the list of the
+ * transparent-mode or not
+ * @details the process id is also checked, so the entry is not used
+ * once the process object is reused by another process
+ *
+ */
+typedef struct _TRANSPARENCY_PROCESS_CACHE_ENTRY
+{
+    PVOID   Process;   // The process object (EPROCESS), null if the entry is empty
+    HANDLE  ProcessId; // Id of the process
+    BOOLEAN IsHidden;  // Whether the name of the process matches the list or not
+
+} TRANSPARENCY_PROCESS_CACHE_ENTRY, *PTRANSPARENCY_PROCESS_CACHE_ENTRY;
+
 /**
  * @brief The status of transparency of each core after and before VMX
  *
@@ -71,6 +213,13 @@ typedef struct _VM_EXIT_TRANSPARENCY
     UINT64  RevealedTimeStampCounterByRdtsc;
     BOOLEAN CpuidAfterRdtscDetected;
 
+    BOOLEAN TscOffsettingEnabled;   // Whether the time of vmx-root is compensated by the TSC offset on this core
+    INT64   TscOffset;              // The TSC offset of the guest (minus the accumulated time of vmx-root)
+    UINT64  VmexitTimeStampCounter; // The time stamp counter once the current vm-exit is started
+
+    LONG                             ProcessCacheGeneration; // The last seen value of g_TransparentModeProcessNamesGeneration
+    TRANSPARENCY_PROCESS_CACHE_ENTRY ProcessCache[TRANSPARENCY_PROCESS_CACHE_ENTRIES];
+
 } VM_EXIT_TRANSPARENCY, *PVM_EXIT_TRANSPARENCY;
 
 /**
@@ -85,6 +234,18 @@ typedef struct _VMX_VMXOFF_STATE
 
 } VMX_VMXOFF_STATE, *PVMX_VMXOFF_STATE;
 
+/**
+ * @brief Details of a hidden breakpoint on a hooked page
+ *
+ */
+typedef struct _EPT_HIDDEN_BREAKPOINT
+{
+    UINT16 Offset;       // Offset of the breakpoint in the page
+    CHAR   PreviousByte; // The byte that is replaced by the breakpoint
+    UCHAR  Count;        // Count of breakpoints on this address
+
+} EPT_HIDDEN_BREAKPOINT, *PEPT_HIDDEN_BREAKPOINT;
+
 /**
  * @brief Structure to save the state of each hooked pages
  *
@@ -148,6 +309,12 @@ typedef struct _EPT_HOOKED_PAGE_DETAIL
      */
     BOOLEAN IsExecutionHook;
 
+    /**
+     * @brief This field shows whether the hook is applied on a 2MB page (not split), if so,
+     * EntryAddress, OriginalEntry and ChangedEntry hold the PML2 entry
+     */
+    BOOLEAN IsLargePage;
+
     /**
      * @brief If TRUE shows that this is the information about
      * a hidden breakpoint command (not a monitor or hidden detours)
@@ -168,22 +335,29 @@ typedef struct _EPT_HOOKED_PAGE_DETAIL
     BOOLEAN IsPostEventTriggerAllowed;
 
     /**
-     * @brief Address of hooked pages (multiple breakpoints on a single page)
+     * @brief Breakpoints of the page sorted by their offsets (multiple breakpoints on a single
+     * page), it either points to InlineBreakpoints or to a set that is allocated from the pool
+     * manager, this is only used in hidden breakpoints (not hidden detours)
+     */
+    PEPT_HIDDEN_BREAKPOINT Breakpoints;
+
+    /**
+     * @brief Count of entries that Breakpoints can hold
      * this is only used in hidden breakpoints (not hidden detours)
      */
-    UINT64 BreakpointAddresses[MaximumHiddenBreakpointsOnPage];
+    UINT32 BreakpointsCapacity;
 
     /**
-     * @brief Character that was previously used in BreakpointAddresses
+     * @brief Count of breakpoints (addresses with breakpoints on a single page)
      * this is only used in hidden breakpoints (not hidden detours)
      */
-    CHAR PreviousBytesOnBreakpointAddresses[MaximumHiddenBreakpointsOnPage];
+    UINT32 CountOfBreakpoints;
 
     /**
-     * @brief Count of breakpoints (multiple breakpoints on a single page)
+     * @brief Breakpoints of the page as long as they fit in the hooked page detail
      * this is only used in hidden breakpoints (not hidden detours)
      */
-    UINT64 CountOfBreakpoints;
+    EPT_HIDDEN_BREAKPOINT InlineBreakpoints[HIDDEN_BREAKPOINTS_INLINE_CAPACITY];
 
 } EPT_HOOKED_PAGE_DETAIL, *PEPT_HOOKED_PAGE_DETAIL;
 
@@ -197,11 +371,158 @@ typedef struct _NMI_BROADCASTING_STATE
 
 } NMI_BROADCASTING_STATE, *PNMI_BROADCASTING_STATE;
 
+/**
+ * @brief A translated guest virtual page
+ *
+ */
+typedef struct _ADDRESS_TRANSLATION_CACHE_ENTRY
+{
+    UINT64 Cr3;          // Physical address of the page-map level-4 table (without PCID)
+    UINT64 VirtualPage;  // Virtual address of the page
+    UINT64 PhysicalPage; // Physical address of the page
+    UINT64 Generation;   // The entry is valid only if it's equal to the generation of the cache
+
+} ADDRESS_TRANSLATION_CACHE_ENTRY, *PADDRESS_TRANSLATION_CACHE_ENTRY;
+
+/**
+ * @brief The cache of translated guest addresses (used in vmx-root)
+ * @details the cache is invalidated on each vm-exit, thus, the translations
+ * are only kept while the guest is not running on this core (e.g., halted),
+ * the mapped tables of the last page-table walk are kept the same way
+ *
+ */
+typedef struct _ADDRESS_TRANSLATION_CACHE
+{
+    UINT64                          Generation;       // Increased to invalidate all of the entries
+    LONG                            GlobalGeneration; // The last seen value of g_AddressTranslationCacheGlobalGeneration
+    ADDRESS_TRANSLATION_CACHE_ENTRY Entries[ADDRESS_TRANSLATION_CACHE_ENTRIES];
+
+    UINT64  TablesGeneration;           // The tables are valid only if it's equal to the generation of the cache
+    UINT64  TablesPhysicalAddresses[4]; // Physical address of the walked table of each level (indexed by PAGING_LEVEL)
+    PUINT64 TablesVirtualAddresses[4];  // Virtual address of the walked table of each level
+
+} ADDRESS_TRANSLATION_CACHE, *PADDRESS_TRANSLATION_CACHE;
+
+/**
+ * @brief The decoded length of an instruction
+ * @details the entry is only used if the bytes of the instruction are
+ * not changed, thus, it remains valid even if the guest modifies its
+ * code or its page tables
+ *
+ */
+typedef struct _INSTRUCTION_LENGTH_CACHE_ENTRY
+{
+    UINT64  Address;                   // Virtual address of the instruction
+    BYTE    Bytes[MAXIMUM_INSTR_SIZE]; // The bytes of the instruction (Length bytes are valid)
+    UINT8   Length;                    // Length of the instruction (zero if the entry is empty)
+    BOOLEAN Is32Bit;                   // Whether the instruction is decoded as a 32-bit instruction
+
+} INSTRUCTION_LENGTH_CACHE_ENTRY, *PINSTRUCTION_LENGTH_CACHE_ENTRY;
+
+/**
+ * @brief The cache of the lengths of decoded instructions (used in vmx-root)
+ *
+ */
+typedef struct _INSTRUCTION_LENGTH_CACHE
+{
+    INSTRUCTION_LENGTH_CACHE_ENTRY Entries[INSTRUCTION_LENGTH_CACHE_ENTRIES];
+
+} INSTRUCTION_LENGTH_CACHE, *PINSTRUCTION_LENGTH_CACHE;
+
+/**
+ * @brief The cache of the results of the static CPUID leaves (used in vmx-root)
+ *
+ */
+typedef struct _CPUID_CACHE
+{
+    UINT32 ValidSlots;                      // Bits of the slots that are cached
+    INT32  Results[CPUID_CACHE_ENTRIES][4]; // EAX, EBX, ECX and EDX of the cached leaves
+
+} CPUID_CACHE, *PCPUID_CACHE;
+
+/**
+ * @brief The cache of the frequently accessed fields of VMCS (used in vmx-root)
+ * @details the fields are read once in each vm-exit (lazily) and the written
+ * fields are flushed once before the vm-entry
+ *
+ */
+typedef struct _VMCS_FIELD_CACHE
+{
+    BOOLEAN IsActive;                         // Whether the cache is used (only while handling a vm-exit)
+    UINT32  ValidFields;                      // Bits of the cached fields (VMCS_FIELD_CACHE_*)
+    UINT32  DirtyFields;                      // Bits of the written fields that are not flushed to VMCS yet
+    UINT64  Values[VMCS_FIELD_CACHE_ENTRIES]; // Values of the cached fields
+
+} VMCS_FIELD_CACHE, *PVMCS_FIELD_CACHE;
+
+/**
+ * @brief The references of the events to the resources of a core
+ * @details a resource causes vm-exits as long as it's referenced (or
+ * some other parts of the hypervisor need it)
+ *
+ */
+typedef struct _BITMAP_OWNERSHIP
+{
+    UINT16 IoPortReferenceCounts[BITMAP_OWNERSHIP_IO_PORTS_COUNT];
+    UINT32 IoAllPortsReferenceCount;
+
+    UINT32 ExceptionReferenceCounts[BITMAP_OWNERSHIP_EXCEPTIONS_COUNT];
+    UINT32 ExceptionAllVectorsReferenceCount;
+
+    UINT32 MovToDebugRegsReferenceCount;
+
+    UINT32 Cr0MaskReferenceCounts[BITMAP_OWNERSHIP_CONTROL_REGISTER_BITS_COUNT];
+    UINT32 Cr4MaskReferenceCounts[BITMAP_OWNERSHIP_CONTROL_REGISTER_BITS_COUNT];
+
+} BITMAP_OWNERSHIP, *PBITMAP_OWNERSHIP;
+
+/**
+ * @brief The updates of the VMCS controls of a core that are applied
+ * by the core itself, once it reaches the next vm-exit
+ * @details the requesters only change the requested values and increase
+ * the requested generation, so no IPI is needed
+ *
+ */
+typedef struct _VMCS_PENDING_UPDATES
+{
+    volatile LONG64 RequestedGeneration;      // Increased once an update is requested
+    volatile LONG64 AppliedGeneration;        // The requested generation that is applied by the core
+    volatile LONG   Flags;                    // VMCS_PENDING_UPDATE_* of the updates that are not applied yet
+    volatile LONG   RdtscExiting;             // The requested state of rdtsc/rdtscp exiting
+    volatile LONG   NmiExiting;               // The requested state of NMI exiting
+    volatile LONG   ExceptionBitmapSetMask;   // The vectors to set on the exception bitmap
+    volatile LONG   ExceptionBitmapUnsetMask; // The vectors to unset from the exception bitmap
+    volatile LONG   LastBranchRecords;        // The requested state of recording the last branches
+    volatile LONG   TscOffsetting;            // The requested state of compensating the time of vmx-root by the TSC offset
+
+} VMCS_PENDING_UPDATES, *PVMCS_PENDING_UPDATES;
+
+/**
+ * @brief The state of counting the retired instructions of the guest
+ * on a core (for breaking after a count of instructions)
+ * @details the performance counters of the guest are frozen while the
+ * counter is armed, the guest sees its own values of the virtualized MSRs
+ *
+ */
+typedef struct _INSTRUCTION_COUNTER_STATE
+{
+    BOOLEAN IsArmed;                    // Whether the counter is counting the instructions of the guest or not
+    UINT64  ArmedCount;                 // Count of the instructions that the counter overflows after them
+    UINT64  StartValue;                 // The value that the counter is started from
+    UINT64  GuestPerfGlobalCtrl;        // The IA32_PERF_GLOBAL_CTRL that the guest sees while the counter is armed
+    UINT64  GuestFixedCtrCtrl;          // The IA32_FIXED_CTR_CTRL that the guest sees while the counter is armed
+    UINT64  GuestFixedCtr0;             // The IA32_FIXED_CTR0 that the guest sees while the counter is armed
+    UINT32  GuestLvtPerformanceCounter; // The performance counter entry of the local APIC that is restored once the counter is disarmed
+
+} INSTRUCTION_COUNTER_STATE, *PINSTRUCTION_COUNTER_STATE;
+
 /**
  * @brief The status of each core after and before VMX
+ * @details the structures are aligned to the cache line so the cores
+ * don't share cache lines in g_GuestState
  *
  */
-typedef struct _VIRTUAL_MACHINE_STATE
+typedef struct DECLSPEC_CACHEALIGN _VIRTUAL_MACHINE_STATE
 {
     BOOLEAN      IsOnVmxRootMode;                                               // Detects whether the current logical core is on Executing on VMX Root Mode
     BOOLEAN      IncrementRip;                                                  // Checks whether it has to redo the previous instruction or not (it used mainly in Ept routines)
@@ -230,20 +551,40 @@ typedef struct _VIRTUAL_MACHINE_STATE
     UINT64       VmmStack;                                                      // Stack for VMM in VM-Exit State
     UINT64       MsrBitmapVirtualAddress;                                       // Msr Bitmap Virtual Address
     UINT64       MsrBitmapPhysicalAddress;                                      // Msr Bitmap Physical Address
+    UINT16 *     MsrBitmapReferenceCounts;                                      // Count of references to each bit of Msr Bitmap (same layout as the bitmap)
+    UINT32       MsrBitmapReadAllReferenceCount;                                // Count of references to all of the bits of Msr Bitmap (read)
+    UINT32       MsrBitmapWriteAllReferenceCount;                               // Count of references to all of the bits of Msr Bitmap (write)
     UINT64       IoBitmapVirtualAddressA;                                       // I/O Bitmap Virtual Address (A)
     UINT64       IoBitmapPhysicalAddressA;                                      // I/O Bitmap Physical Address (A)
     UINT64       IoBitmapVirtualAddressB;                                       // I/O Bitmap Virtual Address (B)
     UINT64       IoBitmapPhysicalAddressB;                                      // I/O Bitmap Physical Address (B)
-    UINT32       PendingExternalInterrupts[PENDING_INTERRUPTS_BUFFER_CAPACITY]; // This list holds a buffer for external-interrupts that are in pending state due to the external-interrupt
+    UINT64       PendingExternalInterrupts[PENDING_INTERRUPTS_BITMAP_CAPACITY]; // This bitmap holds the vectors of external-interrupts that are in pending state due to the external-interrupt
                                                                                 // blocking and waits for interrupt-window exiting
-                                                                                // From hvpp :
-                                                                                // Pending interrupt queue (FIFO).
-                                                                                // Make storage for up-to 64 pending interrupts.
-                                                                                // In practice I haven't seen more than 2 pending interrupts.
-
-    VMX_VMXOFF_STATE        VmxoffState;                                        // Shows the vmxoff state of the guest
-    NMI_BROADCASTING_STATE  NmiBroadcastingState;                               // Shows the state of NMI broadcasting
-    VM_EXIT_TRANSPARENCY    TransparencyState;                                  // The state of the debugger in transparent-mode
-    PEPT_HOOKED_PAGE_DETAIL MtfEptHookRestorePoint;                             // It shows the detail of the hooked paged that should be restore in MTF vm-exit
+                                                                                // Like the IRR of the local APIC, a vector is pending at most once and the
+                                                                                // vector with the highest priority is injected first
+
+    VMX_VMXOFF_STATE          VmxoffState;                                      // Shows the vmxoff state of the guest
+    NMI_BROADCASTING_STATE    NmiBroadcastingState;                             // Shows the state of NMI broadcasting
+    VM_EXIT_TRANSPARENCY      TransparencyState;                                // The state of the debugger in transparent-mode
+    PEPT_HOOKED_PAGE_DETAIL   MtfEptHookRestorePoint;                           // It shows the detail of the hooked paged that should be restore in MTF vm-exit
+    BOOLEAN                   IsOnUnhookedEptView;                              // Whether the core is executing one instruction on the unhooked EPT view
+    UINT64                    EptPointerBeforeUnhookedView;                     // The EPTP that is restored after executing on the unhooked EPT view
+    PVOID                     EptCoreView;                                      // The EPT view of this core for restoring one hooked page (PVMM_EPT_CORE_VIEW)
+    UINT64                    EptCoreViewPointer;                               // The EPTP of the EPT view of this core
+    ADDRESS_TRANSLATION_CACHE AddressTranslationCache;                          // The cache of translated guest addresses
+    INSTRUCTION_LENGTH_CACHE  InstructionLengthCache;                           // The cache of the lengths of decoded instructions
+    VMCS_FIELD_CACHE          VmcsFieldCache;                                   // The cache of the frequently accessed fields of VMCS in the current vm-exit
+    CPUID_CACHE               CpuidCache;                                       // The cache of the results of the static CPUID leaves
+    PBITMAP_OWNERSHIP         BitmapOwnership;                                  // References of the events to the bitmaps and the exiting controls
+    VMCS_PENDING_UPDATES      PendingVmcsUpdates;                               // The updates of the VMCS controls that are applied on the next vm-exit
+    BOOLEAN                   LbrEnabled;                                       // Whether the last branches of the guest are recorded on this core or not
+    UINT64                    LbrGuestControl;                                  // The IA32_DEBUGCTL (or IA32_LBR_CTL) that the guest sees while the last branches are recorded
+    UINT32                    CoverageWalkRemainingSteps;                       // Count of the remaining instructions of the basic block walk of the coverage (zero if not walking)
+    UINT64                    CoverageWalkBlockStart;                           // Start address of the current basic block of the walk
+    UINT64                    CoverageWalkNextRip;                              // Address of the next sequential instruction of the walk
+    INSTRUCTION_COUNTER_STATE InstructionCounter;                               // The state of counting the retired instructions of the guest
+    PVOID                     EnlightenedVmcs;                                  // The enlightened VMCS of Hyper-V (the aligned VMCS region) if it's used instead of VMREAD and VMWRITE
+    PVOID                     VpAssistPage;                                     // The VP assist page of Hyper-V (the current enlightened VMCS is set on this page)
+    BOOLEAN                   VpAssistPageIsAllocated;                          // Whether the VP assist page is allocated by us or it's the page of the guest
 
 } VIRTUAL_MACHINE_STATE, *PVIRTUAL_MACHINE_STATE;
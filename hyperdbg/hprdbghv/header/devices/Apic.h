@@ -158,3 +158,9 @@ ApicSelfIpi(UINT32 Vector);
 
 VOID
 ApicTriggerGenericNmi();
+
+UINT32
+ApicReadLvtPerformanceCounter();
+
+VOID
+ApicWriteLvtPerformanceCounter(UINT32 Value);
@@ -22,12 +22,26 @@
  */
 typedef struct _COMPATIBILITY_CHECKS_STATUS
 {
-    BOOLEAN IsX2Apic;                  // X2APIC or XAPIC routine
-    BOOLEAN RtmSupport;                // check for RTM support
-    BOOLEAN PmlSupport;                // check Page Modification Logging (PML) support
-    BOOLEAN ModeBasedExecutionSupport; // check for mode based execution support (processors after Kaby Lake release will support this feature)
-    BOOLEAN ExecuteOnlySupport;        // Support for execute-only pages (indicating that data accesses are not allowed while instruction fetches are allowed)
-    UINT32  VirtualAddressWidth;       // Virtual address width for x86 processorsVirtual address width for x86 processors
+    BOOLEAN IsX2Apic;                     // X2APIC or XAPIC routine
+    BOOLEAN RtmSupport;                   // check for RTM support
+    BOOLEAN PmlSupport;                   // check Page Modification Logging (PML) support
+    BOOLEAN ModeBasedExecutionSupport;    // check for mode based execution support (processors after Kaby Lake release will support this feature)
+    BOOLEAN ExecuteOnlySupport;           // Support for execute-only pages (indicating that data accesses are not allowed while instruction fetches are allowed)
+    BOOLEAN Ept1GbPagesSupport;           // Support for mapping 1GB pages by the PML3 entries of EPT
+    UINT32  VirtualAddressWidth;          // Virtual address width for x86 processorsVirtual address width for x86 processors
+    BOOLEAN PreemptionTimerSupport;       // check for VMX preemption timer support
+    BOOLEAN PreemptionTimerSavingSupport; // check for saving the VMX preemption timer on vm-exits
+    UINT32  PreemptionTimerRate;          // The VMX preemption timer counts down once in each 2^PreemptionTimerRate TSC ticks
+    BOOLEAN IntelPtSupport;               // check for Intel Processor Trace (with ToPA output) support in VMX non-root
+    BOOLEAN IntelPtCr3FilteringSupport;   // check for filtering the Intel Processor Trace by CR3
+    UINT32  IntelPtAddressRanges;         // Count of the address ranges of the Intel Processor Trace for filtering by IP
+    BOOLEAN ArchLbrSupport;               // check for architectural LBRs (Last Branch Records) support in VMX non-root
+    UINT32  LbrDepth;                     // Count of the entries of the LBR stack (zero if LBRs are not supported)
+    UINT32  PebsRecordFormat;             // The format of the PEBS records (zero if PEBS is not supported in VMX non-root)
+    BOOLEAN PmcFullWidthWritesSupport;    // check for the full-width writes to the performance counters (IA32_A_PMCx)
+    UINT32  FixedCounterWidth;            // The width of the fixed-function counters (zero if the retired instructions can't be counted in VMX non-root)
+    UINT32  EnlightenedVmcsVersion;       // The version of the enlightened VMCS of Hyper-V that is used (zero if it's not used)
+    BOOLEAN EnlightenedMsrBitmapSupport;  // check for the enlightened MSR bitmap of Hyper-V (nested)
 
 } COMPATIBILITY_CHECKS_STATUS, *PCOMPATIBILITY_CHECKS_STATUS;
 
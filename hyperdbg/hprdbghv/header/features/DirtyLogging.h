@@ -17,6 +17,25 @@
 
 #define PML_ENTITY_NUM 512
 
+/**
+ * @brief Count of the bitmaps of the dirty pages (the current round
+ * and the previous round)
+ *
+ */
+#define DIRTY_LOGGING_BITMAPS_COUNT 2
+
+/**
+ * @brief The dirty flag (bit 9) of the EPT entries
+ *
+ */
+#define DIRTY_LOGGING_EPT_ENTRY_DIRTY_FLAG (1ull << 9)
+
+/**
+ * @brief Maximum count of the EPT page tables that are used by the cores
+ *
+ */
+#define DIRTY_LOGGING_MAXIMUM_EPT_PAGE_TABLES 4
+
 //////////////////////////////////////////////////
 //				   Functions					//
 //////////////////////////////////////////////////
@@ -33,5 +52,14 @@ DirtyLoggingDisable(VIRTUAL_MACHINE_STATE * VCpu);
 VOID
 DirtyLoggingUninitialize();
 
+BOOLEAN
+DirtyLoggingFlushPmlBuffer(VIRTUAL_MACHINE_STATE * VCpu, UINT32 BitmapIndex);
+
 VOID
 DirtyLoggingHandleVmexits(VIRTUAL_MACHINE_STATE * VCpu);
+
+VOID
+DirtyLoggingPerformAction(PDEBUGGER_DIRTY_PAGES_REQUEST DirtyPagesRequest);
+
+VOID
+DirtyLoggingFreeBitmaps();
@@ -0,0 +1,83 @@
+/**
+ * @file EptSnapshot.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the snapshots of the guest memory (copy-on-write based on EPT)
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The write access (bit 1) of the EPT entries
+ *
+ */
+#define EPT_SNAPSHOT_EPT_ENTRY_WRITE_ACCESS (1ull << 1)
+
+/**
+ * @brief An ignored bit (bit 11) of the EPT entries that shows the write
+ * access of the entry is removed by the snapshot
+ *
+ */
+#define EPT_SNAPSHOT_EPT_ENTRY_PROTECTED_FLAG (1ull << 11)
+
+//////////////////////////////////////////////////
+//				   Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The copy of a page that is written after taking the snapshot
+ *
+ */
+typedef struct _EPT_SNAPSHOT_PAGE_COPY
+{
+    LIST_ENTRY      PageCopiesList;     // Link in the list of the copied pages (or the free copies)
+    UINT64          PhysicalAddress;    // The guest-physical address of the page
+    PEPT_PML1_ENTRY EntryAddress;       // The entry of the page in the EPT page table
+    BYTE            Content[PAGE_SIZE]; // The content of the page at the time of the snapshot
+
+} EPT_SNAPSHOT_PAGE_COPY, *PEPT_SNAPSHOT_PAGE_COPY;
+
+/**
+ * @brief The state of the snapshot
+ * @details the registers are only restored on the core that the
+ * snapshot is taken on
+ *
+ */
+typedef struct _EPT_SNAPSHOT_STATE
+{
+    BOOLEAN       IsTaken;
+    BOOLEAN       IsOverflowed;    // Some of the written pages are not copied
+    UINT32        CoreId;          // The core that the snapshot is taken on
+    GUEST_REGS    Regs;            // The general purpose registers of the core
+    UINT64        Rip;             // The RIP of the core
+    UINT64        Rflags;          // The RFLAGS of the core
+    LIST_ENTRY    CopiedPagesList; // The pages that are written since taking (or restoring) the snapshot
+    LIST_ENTRY    FreeCopiesList;  // The copies that are reused after restoring the snapshot
+    UINT64        CountOfCopiedPages;
+    UINT64        CountOfRestores;
+    volatile LONG Lock;
+
+} EPT_SNAPSHOT_STATE, *PEPT_SNAPSHOT_STATE;
+
+//////////////////////////////////////////////////
+//				   Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+EptSnapshotHandleEptViolation(_Inout_ VIRTUAL_MACHINE_STATE *               VCpu,
+                              _In_ VMX_EXIT_QUALIFICATION_EPT_VIOLATION * ViolationQualification,
+                              _In_ UINT64                                 GuestPhysicalAddr);
+
+VOID
+EptSnapshotAllocatePageCopies(_In_ UINT32 Count);
+
+VOID
+EptSnapshotPerformAction(_Inout_ PDEBUGGER_EPT_SNAPSHOT_REQUEST SnapshotRequest);
@@ -0,0 +1,68 @@
+/**
+ * @file InstructionCounter.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for counting the retired instructions of the guest
+ * @details
+ * @version 0.4
+ * @date 2023-08-13
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief MSRs of the fixed-function counter of the retired instructions
+ *
+ */
+#define INSTRUCTION_COUNTER_MSR_FIXED_CTR0     0x00000309
+#define INSTRUCTION_COUNTER_MSR_FIXED_CTR_CTRL 0x0000038d
+
+/**
+ * @brief Bits of the fields of IA32_FIXED_CTR0 in IA32_FIXED_CTR_CTRL
+ *
+ */
+#define INSTRUCTION_COUNTER_FIXED_CTR_CTRL_OS   (1ull << 0)
+#define INSTRUCTION_COUNTER_FIXED_CTR_CTRL_USR  (1ull << 1)
+#define INSTRUCTION_COUNTER_FIXED_CTR_CTRL_PMI  (1ull << 3)
+#define INSTRUCTION_COUNTER_FIXED_CTR_CTRL_MASK 0xfull
+
+/**
+ * @brief The bit of IA32_FIXED_CTR0 in IA32_PERF_GLOBAL_CTRL,
+ * IA32_PERF_GLOBAL_STATUS and IA32_PERF_GLOBAL_OVF_CTRL
+ *
+ */
+#define INSTRUCTION_COUNTER_GLOBAL_FIXED_CTR0 (1ull << 32)
+
+/**
+ * @brief TSC ticks between checking the overflow of the counter (using
+ * the VMX preemption timer), in case its NMI is received in vmx-root
+ *
+ */
+#define INSTRUCTION_COUNTER_WATCHDOG_INTERVAL 0x100000
+
+//////////////////////////////////////////////////
+//				   Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+InstructionCounterArm(VIRTUAL_MACHINE_STATE * VCpu, UINT64 Count);
+
+UINT64
+InstructionCounterDisarm(VIRTUAL_MACHINE_STATE * VCpu);
+
+BOOLEAN
+InstructionCounterCheckNmi(VIRTUAL_MACHINE_STATE * VCpu);
+
+VOID
+InstructionCounterHandleVmexit(VIRTUAL_MACHINE_STATE * VCpu);
+
+BOOLEAN
+InstructionCounterHandleRdmsr(VIRTUAL_MACHINE_STATE * VCpu, UINT32 TargetMsr, PUINT64 Value);
+
+BOOLEAN
+InstructionCounterHandleWrmsr(VIRTUAL_MACHINE_STATE * VCpu, UINT32 TargetMsr, UINT64 Value);
@@ -0,0 +1,143 @@
+/**
+ * @file IntelPt.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for tracing the guest with Intel PT (Processor Trace)
+ * @details
+ * @version 0.4
+ * @date 2023-08-05
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief MSRs of Intel PT
+ *
+ */
+#define INTEL_PT_MSR_RTIT_OUTPUT_BASE      0x00000560
+#define INTEL_PT_MSR_RTIT_OUTPUT_MASK_PTRS 0x00000561
+#define INTEL_PT_MSR_RTIT_CTL              0x00000570
+#define INTEL_PT_MSR_RTIT_STATUS           0x00000571
+#define INTEL_PT_MSR_RTIT_CR3_MATCH        0x00000572
+#define INTEL_PT_MSR_RTIT_ADDR_A(n)        (0x00000580 + ((n)*2))
+#define INTEL_PT_MSR_RTIT_ADDR_B(n)        (0x00000581 + ((n)*2))
+
+/**
+ * @brief The VMCS field of the guest's IA32_RTIT_CTL
+ *
+ */
+#define INTEL_PT_VMCS_GUEST_RTIT_CTL 0x00002814
+
+/**
+ * @brief Bits of IA32_RTIT_CTL
+ *
+ */
+#define INTEL_PT_RTIT_CTL_TRACE_EN       (1ull << 0)
+#define INTEL_PT_RTIT_CTL_OS             (1ull << 2)
+#define INTEL_PT_RTIT_CTL_USER           (1ull << 3)
+#define INTEL_PT_RTIT_CTL_CR3_FILTER     (1ull << 7)
+#define INTEL_PT_RTIT_CTL_TOPA           (1ull << 8)
+#define INTEL_PT_RTIT_CTL_DIS_RETC       (1ull << 11)
+#define INTEL_PT_RTIT_CTL_BRANCH_EN      (1ull << 13)
+#define INTEL_PT_RTIT_CTL_ADDR_FILTER(n) (1ull << (32 + ((n)*4)))
+
+/**
+ * @brief Bits of IA32_RTIT_STATUS
+ *
+ */
+#define INTEL_PT_RTIT_STATUS_ERROR   (1ull << 4)
+#define INTEL_PT_RTIT_STATUS_STOPPED (1ull << 5)
+
+/**
+ * @brief Bits of the entries of the Table of Physical Addresses (ToPA)
+ *
+ */
+#define INTEL_PT_TOPA_ENTRY_END        (1ull << 0)
+#define INTEL_PT_TOPA_ENTRY_STOP       (1ull << 4)
+#define INTEL_PT_TOPA_ENTRY_SIZE_SHIFT 6
+
+/**
+ * @brief The initial value of IA32_RTIT_OUTPUT_MASK_PTRS (the first
+ * entry of the ToPA table and the start of its region, the lower mask
+ * bits are reserved as ones)
+ *
+ */
+#define INTEL_PT_OUTPUT_MASK_PTRS_INITIAL 0x7f
+
+/**
+ * @brief The maximum size of the buffer of each core (the largest
+ * region of the ToPA entries)
+ *
+ */
+#define INTEL_PT_MAXIMUM_BUFFER_SIZE (PAGE_SIZE << 15)
+
+//////////////////////////////////////////////////
+//				     Enums  					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Actions of the trace of each core (from vmx-root)
+ *
+ */
+typedef enum _INTEL_PT_CORE_ACTION
+{
+    INTEL_PT_CORE_ACTION_START,
+    INTEL_PT_CORE_ACTION_STOP,
+    INTEL_PT_CORE_ACTION_PAUSE,
+    INTEL_PT_CORE_ACTION_RESUME,
+
+} INTEL_PT_CORE_ACTION;
+
+//////////////////////////////////////////////////
+//				   Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The configuration of the trace (the same for all cores)
+ *
+ */
+typedef struct _INTEL_PT_CONFIGURATION
+{
+    UINT64 RtitCtl;
+    UINT64 Cr3Match;
+    UINT32 BufferSize;
+    UINT32 CountOfAddressRanges;
+    UINT64 AddressRangesStart[IntelPtMaximumAddressRanges];
+    UINT64 AddressRangesEnd[IntelPtMaximumAddressRanges];
+
+} INTEL_PT_CONFIGURATION, *PINTEL_PT_CONFIGURATION;
+
+/**
+ * @brief The buffer of the trace of a single core
+ * @details the buffer is a single region of the ToPA table (followed
+ * by an END entry), so the trace is stopped once the buffer is full
+ *
+ */
+typedef struct DECLSPEC_CACHEALIGN _INTEL_PT_BUFFER
+{
+    PVOID   Buffer;
+    UINT64  BufferPhysicalAddress;
+    PUINT64 ToPaTable;
+    UINT64  ToPaTablePhysicalAddress;
+    UINT64  TraceSize;    // saved once the trace is paused
+    BOOLEAN IsBufferFull; // saved once the trace is paused
+
+} INTEL_PT_BUFFER, *PINTEL_PT_BUFFER;
+
+//////////////////////////////////////////////////
+//				   Functions					//
+//////////////////////////////////////////////////
+
+VOID
+IntelPtPerformActionOnCore(VIRTUAL_MACHINE_STATE * VCpu, INTEL_PT_CORE_ACTION Action);
+
+VOID
+IntelPtPerformAction(PDEBUGGER_INTEL_PT_REQUEST IntelPtRequest);
+
+VOID
+IntelPtUninitialize();
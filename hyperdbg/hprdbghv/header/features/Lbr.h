@@ -0,0 +1,77 @@
+/**
+ * @file Lbr.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for recording the last branches (LBR) of the guest
+ * @details
+ * @version 0.4
+ * @date 2023-08-06
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief MSRs of the legacy (model-specific) LBRs
+ *
+ */
+#define LBR_MSR_LASTBRANCH_TOS        0x000001c9
+#define LBR_MSR_LASTBRANCH_FROM_IP(n) (0x00000680 + (n))
+#define LBR_MSR_LASTBRANCH_TO_IP(n)   (0x000006c0 + (n))
+
+/**
+ * @brief MSRs of the architectural LBRs
+ *
+ */
+#define LBR_MSR_ARCH_LBR_CTL        0x000014ce
+#define LBR_MSR_ARCH_LBR_DEPTH      0x000014cf
+#define LBR_MSR_ARCH_LBR_FROM_IP(n) (0x00001500 + (n))
+#define LBR_MSR_ARCH_LBR_TO_IP(n)   (0x00001600 + (n))
+
+/**
+ * @brief The maximum depth of the legacy LBR stack
+ *
+ */
+#define LBR_LEGACY_MAXIMUM_DEPTH 32
+
+/**
+ * @brief The VMCS field of the guest's IA32_LBR_CTL
+ *
+ */
+#define LBR_VMCS_GUEST_ARCH_LBR_CTL 0x00002816
+
+/**
+ * @brief The LBR bit of IA32_DEBUGCTL (for the legacy LBRs)
+ *
+ */
+#define LBR_DEBUGCTL_LBR (1ull << 0)
+
+/**
+ * @brief IA32_LBR_CTL for recording all of the branches of both of the
+ * user-mode and the kernel-mode (LBREn, OS, USR and the branch types)
+ *
+ */
+#define LBR_ARCH_LBR_CTL_RECORD_ALL ((1ull << 0) | (1ull << 1) | (1ull << 2) | (0x7full << 16))
+
+//////////////////////////////////////////////////
+//				   Functions					//
+//////////////////////////////////////////////////
+
+VOID
+LbrPerformActionOnCore(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Enable);
+
+BOOLEAN
+LbrRequest(BOOLEAN Set);
+
+UINT32
+LbrReadBranches(VIRTUAL_MACHINE_STATE * VCpu, PDEBUGGER_LAST_BRANCH_RECORD Records, UINT32 Count);
+
+BOOLEAN
+LbrHandleRdmsr(VIRTUAL_MACHINE_STATE * VCpu, UINT32 TargetMsr, PUINT64 Value);
+
+BOOLEAN
+LbrHandleWrmsr(VIRTUAL_MACHINE_STATE * VCpu, UINT32 TargetMsr, UINT64 Value);
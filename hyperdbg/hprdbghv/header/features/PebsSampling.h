@@ -0,0 +1,269 @@
+/**
+ * @file PebsSampling.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for sampling the memory accesses of the guest with PEBS
+ * @details
+ * @version 0.4
+ * @date 2023-08-11
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief MSRs of the performance monitoring and PEBS
+ *
+ */
+#define PEBS_MSR_PMC(n)                 (0x000000c1 + (n))
+#define PEBS_MSR_PERFEVTSEL(n)          (0x00000186 + (n))
+#define PEBS_MSR_MISC_ENABLE            0x000001a0
+#define PEBS_MSR_PERF_CAPABILITIES      0x00000345
+#define PEBS_MSR_PERF_GLOBAL_STATUS     0x0000038e
+#define PEBS_MSR_PERF_GLOBAL_CTRL       0x0000038f
+#define PEBS_MSR_PERF_GLOBAL_OVF_CTRL   0x00000390
+#define PEBS_MSR_PEBS_ENABLE            0x000003f1
+#define PEBS_MSR_PEBS_DATA_CFG          0x000003f2
+#define PEBS_MSR_PEBS_LD_LAT            0x000003f6
+#define PEBS_MSR_A_PMC(n)               (0x000004c1 + (n))
+#define PEBS_MSR_DS_AREA                0x00000600
+
+/**
+ * @brief The general-purpose counters that are used for sampling the
+ * loads and the stores
+ *
+ */
+#define PEBS_SAMPLING_LOADS_COUNTER  0
+#define PEBS_SAMPLING_STORES_COUNTER 1
+
+/**
+ * @brief Bits of IA32_PERFEVTSELx
+ *
+ */
+#define PEBS_PERFEVTSEL_USR (1ull << 16)
+#define PEBS_PERFEVTSEL_OS  (1ull << 17)
+#define PEBS_PERFEVTSEL_EN  (1ull << 22)
+
+/**
+ * @brief The events of the sampled memory accesses (event select and
+ * unit mask), MEM_TRANS_RETIRED.LOAD_LATENCY and MEM_INST_RETIRED.ALL_STORES
+ *
+ */
+#define PEBS_EVENT_LOAD_LATENCY 0x01cd
+#define PEBS_EVENT_ALL_STORES   0x82d0
+
+/**
+ * @brief Bits of IA32_PEBS_ENABLE
+ *
+ */
+#define PEBS_ENABLE_COUNTER(n)      (1ull << (n))
+#define PEBS_ENABLE_LOAD_LATENCY(n) (1ull << (32 + (n)))
+
+/**
+ * @brief The overflow of the PEBS buffer in IA32_PERF_GLOBAL_STATUS
+ *
+ */
+#define PEBS_GLOBAL_STATUS_OVF_BUFFER (1ull << 62)
+
+/**
+ * @brief The memory info group of MSR_PEBS_DATA_CFG (adaptive PEBS)
+ *
+ */
+#define PEBS_DATA_CFG_MEMORY_INFO (1ull << 0)
+
+/**
+ * @brief Fields of IA32_PERF_CAPABILITIES
+ *
+ */
+#define PEBS_PERF_CAPABILITIES_RECORD_FORMAT(Value) (((Value) >> 8) & 0xf)
+#define PEBS_PERF_CAPABILITIES_FULL_WIDTH_WRITE     (1ull << 13)
+#define PEBS_PERF_CAPABILITIES_BASELINE             (1ull << 14)
+
+/**
+ * @brief PEBS is unavailable if this bit of IA32_MISC_ENABLE is set
+ *
+ */
+#define PEBS_MISC_ENABLE_PEBS_UNAVAILABLE (1ull << 12)
+
+/**
+ * @brief Offsets of the fields of the (non-adaptive) PEBS records
+ *
+ */
+#define PEBS_RECORD_OFFSET_RIP            0x08
+#define PEBS_RECORD_OFFSET_DATA_ADDRESS   0x98
+#define PEBS_RECORD_OFFSET_EVENTING_IP    0xb0
+#define PEBS_RECORD_SIZE_FORMAT_1         0xb0
+#define PEBS_RECORD_SIZE_FORMAT_2         0xc0
+#define PEBS_RECORD_SIZE_FORMAT_3         0xc8
+
+/**
+ * @brief Offsets of the fields of the adaptive PEBS records (format 4 and
+ * newer), the basic group is followed by the memory info group
+ *
+ */
+#define PEBS_ADAPTIVE_RECORD_OFFSET_FORMAT_SIZE  0x00
+#define PEBS_ADAPTIVE_RECORD_OFFSET_IP           0x08
+#define PEBS_ADAPTIVE_RECORD_OFFSET_DATA_ADDRESS 0x20
+#define PEBS_ADAPTIVE_RECORD_SIZE                0x40
+
+/**
+ * @brief The first format that has the eventing IP of the records and
+ * the data address of the stores, and the first adaptive format
+ *
+ */
+#define PEBS_RECORD_FORMAT_EVENTING_IP 2
+#define PEBS_RECORD_FORMAT_ADAPTIVE    4
+
+/**
+ * @brief Size of the PEBS buffer of each core
+ *
+ */
+#define PEBS_SAMPLING_BUFFER_SIZE (PAGE_SIZE * 16)
+
+/**
+ * @brief Count of the (RIP, data address) slots of the table of each core
+ * (power of two)
+ *
+ */
+#define PEBS_SAMPLING_TABLE_CAPACITY 0x2000
+
+/**
+ * @brief Maximum count of the slots that are probed for finding an entry
+ *
+ */
+#define PEBS_SAMPLING_TABLE_MAXIMUM_PROBES 32
+
+/**
+ * @brief TSC ticks between draining the PEBS buffer of each core (using
+ * the VMX preemption timer)
+ *
+ */
+#define PEBS_SAMPLING_DRAIN_INTERVAL 0x400000
+
+/**
+ * @brief Maximum count of the general-purpose counters that their reset
+ * values are stored in the DS save area
+ *
+ */
+#define PEBS_DS_AREA_MAXIMUM_COUNTERS 8
+
+//////////////////////////////////////////////////
+//				     Enums  					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Actions of the sampling of each core (from vmx-root)
+ *
+ */
+typedef enum _PEBS_SAMPLING_CORE_ACTION
+{
+    PEBS_SAMPLING_CORE_ACTION_START,
+    PEBS_SAMPLING_CORE_ACTION_STOP,
+    PEBS_SAMPLING_CORE_ACTION_DRAIN,
+
+} PEBS_SAMPLING_CORE_ACTION;
+
+/**
+ * @brief The MSRs that are virtualized while the memory accesses are
+ * sampled
+ * @details the full-width aliases of the counters (IA32_A_PMCx) share
+ * the values of the counters
+ *
+ */
+typedef enum _PEBS_SAMPLING_VIRTUALIZED_MSR
+{
+    PEBS_SAMPLING_VIRTUALIZED_MSR_PERF_GLOBAL_CTRL,
+    PEBS_SAMPLING_VIRTUALIZED_MSR_PEBS_ENABLE,
+    PEBS_SAMPLING_VIRTUALIZED_MSR_DS_AREA,
+    PEBS_SAMPLING_VIRTUALIZED_MSR_PERFEVTSEL0,
+    PEBS_SAMPLING_VIRTUALIZED_MSR_PERFEVTSEL1,
+    PEBS_SAMPLING_VIRTUALIZED_MSR_PMC0,
+    PEBS_SAMPLING_VIRTUALIZED_MSR_PMC1,
+    PEBS_SAMPLING_VIRTUALIZED_MSR_PEBS_LD_LAT,
+    PEBS_SAMPLING_VIRTUALIZED_MSR_PEBS_DATA_CFG,
+    PEBS_SAMPLING_VIRTUALIZED_MSR_COUNT,
+
+} PEBS_SAMPLING_VIRTUALIZED_MSR;
+
+//////////////////////////////////////////////////
+//				   Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The (64-bit) DS save area
+ *
+ */
+typedef struct _PEBS_DS_AREA
+{
+    UINT64 BtsBufferBase;
+    UINT64 BtsIndex;
+    UINT64 BtsAbsoluteMaximum;
+    UINT64 BtsInterruptThreshold;
+    UINT64 PebsBufferBase;
+    UINT64 PebsIndex;
+    UINT64 PebsAbsoluteMaximum;
+    UINT64 PebsInterruptThreshold;
+    UINT64 PebsCounterReset[PEBS_DS_AREA_MAXIMUM_COUNTERS];
+
+} PEBS_DS_AREA, *PPEBS_DS_AREA;
+
+/**
+ * @brief The configuration of the sampling (the same for all cores)
+ *
+ */
+typedef struct _PEBS_SAMPLING_CONFIGURATION
+{
+    UINT64 PerfEvtSel[2]; // The event selects of the loads and the stores counters (zero if not sampled)
+    UINT64 PebsEnable;
+    UINT64 CounterReset; // The (negative) value that the counters are reloaded after each record
+    UINT64 LatencyThreshold;
+    UINT64 StartAddress;
+    UINT64 EndAddress;
+    UINT64 CountersMask; // The counters of IA32_PERF_GLOBAL_CTRL that are used for sampling
+
+} PEBS_SAMPLING_CONFIGURATION, *PPEBS_SAMPLING_CONFIGURATION;
+
+/**
+ * @brief The buffers and the aggregated entries of the sampling of a
+ * single core
+ * @details the entries are only written by the core itself (in vmx-root)
+ *
+ */
+typedef struct DECLSPEC_CACHEALIGN _PEBS_SAMPLING_BUFFER
+{
+    PPEBS_DS_AREA        DsArea;
+    PVOID                PebsBuffer;
+    PPEBS_SAMPLING_ENTRY Table;
+    BOOLEAN              IsEnabled;
+    UINT64               GuestMsrs[PEBS_SAMPLING_VIRTUALIZED_MSR_COUNT]; // The values that the guest sees while sampling
+    volatile LONG64      CountOfRecords;
+    volatile LONG64      CountOfFilteredOut;
+    volatile LONG64      CountOfDropped;
+
+} PEBS_SAMPLING_BUFFER, *PPEBS_SAMPLING_BUFFER;
+
+//////////////////////////////////////////////////
+//				   Functions					//
+//////////////////////////////////////////////////
+
+VOID
+PebsSamplingPerformActionOnCore(VIRTUAL_MACHINE_STATE * VCpu, PEBS_SAMPLING_CORE_ACTION Action);
+
+VOID
+PebsSamplingDrainBuffer(VIRTUAL_MACHINE_STATE * VCpu);
+
+BOOLEAN
+PebsSamplingHandleRdmsr(VIRTUAL_MACHINE_STATE * VCpu, UINT32 TargetMsr, PUINT64 Value);
+
+BOOLEAN
+PebsSamplingHandleWrmsr(VIRTUAL_MACHINE_STATE * VCpu, UINT32 TargetMsr, UINT64 Value);
+
+VOID
+PebsSamplingPerformAction(PDEBUGGER_PEBS_SAMPLING_REQUEST PebsRequest);
+
+VOID
+PebsSamplingUninitialize();
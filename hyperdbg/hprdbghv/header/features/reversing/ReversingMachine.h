@@ -12,10 +12,45 @@
  */
 #include "pch.h"
 
+//////////////////////////////////////////////////
+//				    Definitions	    			//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Count of the slots of the cache of the EPT views of the CR3s
+ * (power of two)
+ *
+ */
+#define REVERSING_MACHINE_CR3_VIEWS_COUNT 512
+
+//////////////////////////////////////////////////
+//				    Structures	    			//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The EPT view that is used while a CR3 is loaded
+ * @details the view is prebuilt on the first MOV to CR3 of each CR3, so the
+ * next MOV to CR3s are only a lookup and writing the EPTP
+ *
+ */
+typedef struct _REVERSING_MACHINE_CR3_VIEW
+{
+    volatile UINT64           Cr3;        // Page frame number of the CR3 (zero for the empty slots), written after the view is built
+    volatile LONG             IsClaimed;  // Whether the slot is claimed by a core for building the view
+    UINT32                    ProcessId;  // The process that the CR3 belongs to (the CR3 might be reused by another process)
+    LONG                      Generation; // The generation of the targets that the view is built with
+    PREVERSING_MACHINE_TARGET Target;     // The target of the process (NULL if the process is not a target)
+    UINT64                    EptPointer; // The EPTP of the view
+
+} REVERSING_MACHINE_CR3_VIEW, *PREVERSING_MACHINE_CR3_VIEW;
+
 //////////////////////////////////////////////////
 //				      Functions					//
 //////////////////////////////////////////////////
 
+VOID
+ReversingMachineInvalidateCr3Views();
+
 VOID
 ReversingMachineHandleCr3Vmexit(VIRTUAL_MACHINE_STATE * VCpu, UINT64 NewCr3);
 
@@ -0,0 +1,60 @@
+/**
+ * @file ReversingMachineCoverage.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the coverage of the reversing machine
+ * @details
+ *
+ * @version 0.4
+ * @date 2023-08-08
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				    Definitions	    			//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum count of the records (executed pages or basic blocks)
+ * of the coverage
+ *
+ */
+#define REVERSING_MACHINE_COVERAGE_MAXIMUM_RECORDS 0x40000
+
+/**
+ * @brief Maximum count of the instructions that are stepped (MTF) after
+ * the first execution of a page for finding its basic blocks
+ *
+ */
+#define REVERSING_MACHINE_COVERAGE_BASIC_BLOCK_WALK_STEPS 64
+
+/**
+ * @brief Count of the buffers that are pre-allocated for splitting the
+ * 2MB pages of the MBEC EPT table (the pool manager allocates a new buffer
+ * after each split)
+ *
+ */
+#define REVERSING_MACHINE_COVERAGE_PREALLOCATED_SPLITS 64
+
+//////////////////////////////////////////////////
+//				      Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+ReversingMachineCoverageInitialize(PVMM_EPT_PAGE_TABLE EptTable, UINT32 ProcessId, BOOLEAN BasicBlocks);
+
+VOID
+ReversingMachineCoverageUninitialize();
+
+BOOLEAN
+ReversingMachineCoverageHandleEptViolation(VIRTUAL_MACHINE_STATE *                VCpu,
+                                           VMX_EXIT_QUALIFICATION_EPT_VIOLATION * ViolationQualification,
+                                           UINT64                                 GuestPhysicalAddr);
+
+VOID
+ReversingMachineCoverageHandleMtf(VIRTUAL_MACHINE_STATE * VCpu);
+
+VOID
+ReversingMachineCoverageQuery(PREVERSING_MACHINE_QUERY_COVERAGE CoverageRequest);
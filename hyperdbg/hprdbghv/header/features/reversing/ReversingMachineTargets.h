@@ -0,0 +1,57 @@
+/**
+ * @file ReversingMachineTargets.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the target processes of the reversing machine
+ * @details
+ *
+ * @version 0.4
+ * @date 2023-08-10
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				    Structures	    			//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A target process of the reversing machine
+ * @details the slots that their process is removed but their ring is still
+ * mapped into a process are not reused until the ring is unmapped
+ *
+ */
+typedef struct _REVERSING_MACHINE_TARGET
+{
+    volatile UINT32                 ProcessId;           // The target process (zero for the free slots)
+    PREVERSING_MACHINE_RESULTS_RING Ring;                // The results ring of the process
+    PMDL                            RingMdl;             // The MDL of the mapping of the ring
+    PVOID                           RingUsermodeAddress; // The user-mode address of the mapping of the ring
+    PEPROCESS                       RingMappedProcess;   // The process that the ring is mapped into
+
+} REVERSING_MACHINE_TARGET, *PREVERSING_MACHINE_TARGET;
+
+//////////////////////////////////////////////////
+//				      Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+ReversingMachineTargetsAdd(UINT32 ProcessId);
+
+VOID
+ReversingMachineTargetsRemoveAll();
+
+PREVERSING_MACHINE_TARGET
+ReversingMachineTargetsFind(UINT32 ProcessId);
+
+VOID
+ReversingMachineTargetsSaveResult(VIRTUAL_MACHINE_STATE *   VCpu,
+                                  PREVERSING_MACHINE_TARGET Target,
+                                  UINT64                    GuestPhysicalAddress);
+
+VOID
+ReversingMachineTargetsMapResults(PREVERSING_MACHINE_MAP_RESULTS MapRequest);
+
+VOID
+ReversingMachineTargetsUnmapResultsOfCurrentProcess();
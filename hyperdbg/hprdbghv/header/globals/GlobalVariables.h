@@ -67,6 +67,18 @@ LIST_ENTRY g_EptHook2sDetourListHead;
  */
 BOOLEAN g_IsEptHook2sDetourListInitialized;
 
+/**
+ * @brief List header of the slabs of trampolines of hidden hooks detour
+ *
+ */
+LIST_ENTRY g_EptHookTrampolinesSlabsListHead;
+
+/**
+ * @brief Lock for allocating the trampolines of hidden hooks detour
+ *
+ */
+volatile LONG g_EptHookTrampolinesLock;
+
 /**
  * @brief Shows whether the debugger transparent mode
  * is enabled (true) or not (false)
@@ -74,6 +86,20 @@ BOOLEAN g_IsEptHook2sDetourListInitialized;
  */
 BOOLEAN g_TransparentMode;
 
+/**
+ * @brief Shows whether the time of vmx-root is compensated by the TSC
+ * offset in the transparent-mode (instead of rdtsc exiting)
+ *
+ */
+BOOLEAN g_TransparentModeTscOffsetting;
+
+/**
+ * @brief Incremented once the list of process names of the transparent-mode
+ * is changed (invalidates the per-core caches of the processes)
+ *
+ */
+volatile LONG g_TransparentModeProcessNamesGeneration;
+
 /**
  * @brief APIC Base
  *
@@ -100,12 +126,66 @@ PVOID g_NmiHandlerForKeDeregisterNmiCallback;
  */
 BOOLEAN g_IsUnsafeSyscallOrSysretHandling;
 
+/**
+ * @brief The entry of system calls (LSTAR) that is hooked by !syscall3
+ * (NULL if it's not hooked)
+ *
+ */
+UINT64 g_SyscallHookLstarEntryAddress;
+
+/**
+ * @brief Count of the events that use the hook of the entry of
+ * system calls (!syscall3)
+ *
+ */
+volatile LONG g_SyscallHookLstarEntryReferences;
+
+/**
+ * @brief Bitmap of the syscall numbers that the syscall events are
+ * interested in (only used if the filter is active)
+ *
+ */
+volatile UINT64 g_SyscallHookFilterBitmap[DEBUGGER_EVENT_SYSCALL_FILTER_MAXIMUM_NUMBER / 64];
+
+/**
+ * @brief Shows whether the syscall numbers are filtered before
+ * dispatching the syscall events
+ *
+ */
+volatile BOOLEAN g_SyscallHookFilterIsActive;
+
+/**
+ * @brief The handlers of the vectors that are hooked at their entries
+ * in the IDT by !interrupt2 (NULL if it's not hooked)
+ *
+ */
+UINT64 g_InterruptHookIdtEntryAddresses[INTERRUPT_HOOK_IDT_ENTRIES];
+
+/**
+ * @brief Count of the events that use the hook of each entry of the IDT
+ * (!interrupt2)
+ *
+ */
+volatile LONG g_InterruptHookIdtEntryReferences[INTERRUPT_HOOK_IDT_ENTRIES];
+
+/**
+ * @brief Bitmap of the vectors that are hooked at their entries in the IDT
+ *
+ */
+volatile LONG64 g_InterruptHookIdtEntryVectors[INTERRUPT_HOOK_IDT_ENTRIES / 64];
+
 /**
  * @brief Bitmap of MSRs that cause #GP
  *
  */
 UINT64 * g_MsrBitmapInvalidMsrs;
 
+/**
+ * @brief The duration of the phases of initializing the hypervisor
+ *
+ */
+DEBUGGER_VMM_INITIALIZATION_TIMINGS g_VmmInitializationTimings;
+
 /**
  * @brief Whether the page-fault and cr3 vm-exits in vmx-root should check
  * the #PFs or the PML4.Supervisor with user debugger or not
@@ -137,9 +217,364 @@ BOOLEAN g_TriggerEventForVmcalls;
  */
 BOOLEAN g_TriggerEventForCpuids;
 
+/**
+ * @brief Showes whether the rdtsc/rdtscp handler is
+ * allowed to trigger an event or not
+ *
+ */
+BOOLEAN g_TriggerEventForTscs;
+
+/**
+ * @brief Showes whether the cpuid handler should check
+ * for the commands of the user debugger or not
+ *
+ */
+BOOLEAN g_CheckCpuidsForUserDebuggerCommands;
+
+/**
+ * @brief The table of CPUID leaves (basic, hypervisor and extended ranges)
+ *
+ */
+CPUID_LEAF_ENTRY g_CpuidLeaves[CPUID_HANDLER_LEAVES_TABLE_SIZE];
+
+/**
+ * @brief Shows whether the leaves of CPUIDs are filtered before
+ * dispatching the CPUID events
+ *
+ */
+volatile BOOLEAN g_CpuidEventFilterIsActive;
+
 /**
  * @brief Showes whether the cpuid handler is
  * allowed to trigger an event or not
  *
  */
 BOOLEAN g_ReversingMachineInitialized;
+
+/**
+ * @brief The target processes of the reversing machine
+ *
+ */
+REVERSING_MACHINE_TARGET g_ReversingMachineTargets[MaximumReversingMachineTargets];
+
+/**
+ * @brief Lock for adding, removing and mapping the targets of the reversing machine
+ *
+ */
+volatile LONG g_ReversingMachineTargetsLock;
+
+/**
+ * @brief The cache of the EPT views of the CR3s (REVERSING_MACHINE_CR3_VIEWS_COUNT slots)
+ *
+ */
+REVERSING_MACHINE_CR3_VIEW g_ReversingMachineCr3Views[REVERSING_MACHINE_CR3_VIEWS_COUNT];
+
+/**
+ * @brief Increased once the targets are changed, the views that are built
+ * with a different generation are rebuilt
+ *
+ */
+volatile LONG g_ReversingMachineCr3ViewsGeneration;
+
+/**
+ * @brief Whether the reversing machine records the coverage or not
+ *
+ */
+BOOLEAN g_ReversingMachineCoverageEnabled;
+
+/**
+ * @brief The process that its coverage is recorded
+ *
+ */
+UINT32 g_ReversingMachineCoverageProcessId;
+
+/**
+ * @brief Whether the coverage records the basic blocks or the pages
+ *
+ */
+BOOLEAN g_ReversingMachineCoverageBasicBlocks;
+
+/**
+ * @brief Bitmap of the physical pages that are executed by the process
+ *
+ */
+PUINT64 g_ReversingMachineCoverageBitmap;
+
+/**
+ * @brief The end of the physical memory that is tracked by the bitmap
+ * of the coverage (exclusive)
+ *
+ */
+UINT64 g_ReversingMachineCoverageEndAddress;
+
+/**
+ * @brief The records (executed pages or basic blocks) of the coverage
+ *
+ */
+PREVERSING_MACHINE_COVERAGE_RECORD g_ReversingMachineCoverageRecords;
+
+/**
+ * @brief Count of the reserved records of the coverage (might be more
+ * than the capacity, the extra records are lost)
+ *
+ */
+volatile LONG g_ReversingMachineCoverageCountOfRecords;
+
+/**
+ * @brief List of the 2MB pages of the MBEC EPT table that are split
+ * by the coverage (VMM_EPT_DYNAMIC_SPLIT)
+ *
+ */
+LIST_ENTRY g_ReversingMachineCoverageSplitsList;
+
+/**
+ * @brief Lock for splitting the pages of the MBEC EPT table
+ *
+ */
+volatile LONG g_ReversingMachineCoverageLock;
+
+/**
+ * @brief Increased to invalidate the address translation cache of all cores
+ * @details (e.g., after modifying the memory or the page tables)
+ *
+ */
+volatile LONG g_AddressTranslationCacheGlobalGeneration;
+
+/**
+ * @brief Whether the statistics of vm-exits are gathered or not
+ *
+ */
+BOOLEAN g_VmexitStatisticsEnabled;
+
+/**
+ * @brief The statistics of vm-exits of all of the cores
+ *
+ */
+PVMEXIT_STATISTICS g_VmexitStatistics;
+
+/**
+ * @brief Whether the vm-exits of CPUIDs are handled in the fast-path or not
+ *
+ */
+BOOLEAN g_VmexitFastPathCpuid;
+
+/**
+ * @brief Whether the vm-exits of RDTSCs and RDTSCPs are handled in the
+ * fast-path or not
+ *
+ */
+BOOLEAN g_VmexitFastPathTsc;
+
+/**
+ * @brief Whether the vm-exits of mov-to-cr3s that neither load nor leave
+ * the address spaces in the filter are handled in the fast-path or not
+ *
+ */
+BOOLEAN g_VmexitFastPathCr3;
+
+/**
+ * @brief The page frames of the address spaces (cr3s) that their mov-to-cr3
+ * vm-exits are handled by the full path (zero means an empty entry)
+ *
+ */
+volatile UINT64 g_VmexitFastPathCr3Filter[VMEXIT_FAST_PATH_CR3_FILTER_MAXIMUM_ENTRIES];
+
+/**
+ * @brief References of the entries of the filter of mov-to-cr3 vm-exits
+ * (each requester of an address space holds a reference)
+ *
+ */
+UINT32 g_VmexitFastPathCr3FilterReferences[VMEXIT_FAST_PATH_CR3_FILTER_MAXIMUM_ENTRIES];
+
+/**
+ * @brief The lock of changing the entries of the filter of mov-to-cr3
+ * vm-exits
+ *
+ */
+volatile LONG g_VmexitFastPathCr3FilterLock;
+
+/**
+ * @brief Count of the entries of the filter of mov-to-cr3 vm-exits
+ *
+ */
+volatile LONG g_VmexitFastPathCr3FilterCount;
+
+/**
+ * @brief Count of the requesters that need all of the mov-to-cr3 vm-exits
+ * in the full path even if the filter is applied (e.g., events of cr3)
+ *
+ */
+volatile LONG g_VmexitFastPathCr3FilterBypassCount;
+
+/**
+ * @brief Count of the requesters of saving the volatile XMM registers
+ * on vm-exits (e.g., events with custom codes)
+ *
+ */
+volatile LONG g_SaveXmmRegistersOnVmexits;
+
+/**
+ * @brief Count of the cores that have pending updates of VMCS controls
+ * @details the fast-path of vm-exits is not used as long as there are
+ * pending updates (the updates are applied by the full path)
+ *
+ */
+volatile LONG g_VmcsPendingUpdatesCount;
+
+/**
+ * @brief The value of the VMX preemption timer that causes the cores to
+ * apply their pending updates of VMCS controls in a bounded time (zero
+ * means that the VMX preemption timer is not used)
+ *
+ */
+UINT32 g_VmcsPendingUpdatesKickTimerValue;
+
+/**
+ * @brief Whether the sampling profiler takes samples of the guest or not
+ *
+ */
+BOOLEAN g_SamplingProfilerEnabled;
+
+/**
+ * @brief Whether the sampling profiler takes the stack of the samples
+ *
+ */
+BOOLEAN g_SamplingProfilerCaptureStack;
+
+/**
+ * @brief The value of the VMX preemption timer between the samples of
+ * the sampling profiler
+ *
+ */
+UINT32 g_SamplingProfilerTimerValue;
+
+/**
+ * @brief The buffers of the samples of all of the cores
+ *
+ */
+PSAMPLING_PROFILER_BUFFER g_SamplingProfilerBuffers;
+
+/**
+ * @brief The lock of reading the samples of the sampling profiler
+ *
+ */
+volatile LONG g_SamplingProfilerLock;
+
+/**
+ * @brief Whether the dirty pages are tracked (based on PML) or not
+ *
+ */
+BOOLEAN g_DirtyLoggingEnabled;
+
+/**
+ * @brief The bitmaps of the dirty pages, one of them is filled by the
+ * cores and the other one keeps the dirty pages of the previous round
+ *
+ */
+PUINT64 g_DirtyLoggingBitmaps[DIRTY_LOGGING_BITMAPS_COUNT];
+
+/**
+ * @brief The index of the bitmap of the dirty pages that is filled
+ * by the cores
+ *
+ */
+volatile LONG g_DirtyLoggingCurrentBitmap;
+
+/**
+ * @brief The end of the physical memory that is tracked by the bitmaps
+ * of the dirty pages (exclusive)
+ *
+ */
+UINT64 g_DirtyLoggingEndAddress;
+
+/**
+ * @brief The lock of the requests of the dirty pages
+ *
+ */
+volatile LONG g_DirtyLoggingLock;
+
+/**
+ * @brief The state of the snapshot of the guest memory
+ *
+ */
+EPT_SNAPSHOT_STATE g_EptSnapshot;
+
+/**
+ * @brief Whether the trace of Intel PT is enabled or not
+ *
+ */
+BOOLEAN g_IntelPtEnabled;
+
+/**
+ * @brief Whether the trace of Intel PT is paused or not
+ *
+ */
+BOOLEAN g_IntelPtPaused;
+
+/**
+ * @brief The configuration of the trace of Intel PT
+ *
+ */
+INTEL_PT_CONFIGURATION g_IntelPtConfiguration;
+
+/**
+ * @brief The buffers of the trace of Intel PT of all of the cores
+ *
+ */
+PINTEL_PT_BUFFER g_IntelPtBuffers;
+
+/**
+ * @brief The lock of the requests of the trace of Intel PT
+ *
+ */
+volatile LONG g_IntelPtLock;
+
+/**
+ * @brief Count of the requesters of recording the last branches (LBR)
+ *
+ */
+volatile LONG g_LastBranchRecordsReferenceCount;
+
+/**
+ * @brief Whether the memory accesses are sampled by PEBS or not
+ *
+ */
+BOOLEAN g_PebsSamplingEnabled;
+
+/**
+ * @brief The VMX preemption timer value (period) for draining the
+ * buffers of PEBS
+ *
+ */
+UINT32 g_PebsSamplingTimerValue;
+
+/**
+ * @brief The configuration of the memory access sampling of PEBS
+ *
+ */
+PEBS_SAMPLING_CONFIGURATION g_PebsSamplingConfiguration;
+
+/**
+ * @brief The buffers of the memory access sampling of PEBS of all of the cores
+ *
+ */
+PPEBS_SAMPLING_BUFFER g_PebsSamplingBuffers;
+
+/**
+ * @brief The lock of the requests of the memory access sampling of PEBS
+ *
+ */
+volatile LONG g_PebsSamplingLock;
+
+/**
+ * @brief Count of the cores that their retired instructions are counted
+ *
+ */
+volatile LONG g_InstructionCounterArmedCores;
+
+/**
+ * @brief Whether the enlightened VMCS of Hyper-V is used instead of
+ * VMREAD and VMWRITE
+ *
+ */
+BOOLEAN g_EnlightenedVmcsIsActive;
@@ -36,6 +36,12 @@
     (*((PUINT8)(Code) + 0) == 0x0F && \
      *((PUINT8)(Code) + 1) == 0x05)
 
+/**
+ * @brief Count of the entries of the IDT
+ *
+ */
+#define INTERRUPT_HOOK_IDT_ENTRIES 256
+
 /**
  * @brief Special signatures
  *
@@ -77,6 +83,61 @@ typedef struct _HIDDEN_HOOKS_DETOUR_DETAILS
     PVOID      ReturnAddress;
 } HIDDEN_HOOKS_DETOUR_DETAILS, *PHIDDEN_HOOKS_DETOUR_DETAILS;
 
+/**
+ * @brief Size of each trampoline of hidden hooks detour
+ * @details the hooked instructions are at most 18 + 15 bytes and the
+ * jump back to the hooked function is at most 14 bytes, the dispatcher
+ * of the hook is placed after them
+ *
+ */
+#define EPT_HOOK_TRAMPOLINE_SLOT_SIZE 96
+
+/**
+ * @brief Offset of the dispatcher in each trampoline
+ * @details the dispatcher pushes the address of the slot of the hook and jumps
+ * to AsmGeneralDetourHook (13 bytes and at most 14 bytes for the jump)
+ *
+ */
+#define EPT_HOOK_TRAMPOLINE_DISPATCHER_OFFSET 64
+
+/**
+ * @brief Count of trampolines in each slab (a slab fits in a page)
+ *
+ */
+#define EPT_HOOK_TRAMPOLINES_PER_SLAB 31
+
+/**
+ * @brief Details of a trampoline of hidden hooks detour
+ * @details trampolines are never freed as a thread might still execute them after
+ * unhooking, a released trampoline is only reused for the same hooked instructions,
+ * the slot is also the record of the hook that is passed to the detour handler
+ *
+ */
+typedef struct _EPT_HOOK_TRAMPOLINE_SLOT
+{
+    UINT64          TargetAddress;            // The hooked function
+    UINT32          SizeOfHookedInstructions; // Count of bytes of the hooked instructions
+    BOOLEAN         IsAllocated;              // The trampoline is built for TargetAddress
+    BOOLEAN         InUse;                    // The trampoline is used by an active hook
+    PCHAR           Trampoline;               // The trampoline of this slot
+    volatile LONG64 HitCount;                 // Count of times that the hook is triggered
+
+} EPT_HOOK_TRAMPOLINE_SLOT, *PEPT_HOOK_TRAMPOLINE_SLOT;
+
+/**
+ * @brief A slab of trampolines of hidden hooks detour (allocated from the pool manager)
+ *
+ */
+typedef struct _EPT_HOOK_TRAMPOLINES_SLAB
+{
+    DECLSPEC_ALIGN(16)
+    CHAR Trampolines[EPT_HOOK_TRAMPOLINES_PER_SLAB][EPT_HOOK_TRAMPOLINE_SLOT_SIZE];
+
+    EPT_HOOK_TRAMPOLINE_SLOT Slots[EPT_HOOK_TRAMPOLINES_PER_SLAB];
+    LIST_ENTRY               SlabsList;
+
+} EPT_HOOK_TRAMPOLINES_SLAB, *PEPT_HOOK_TRAMPOLINES_SLAB;
+
 /**
  * @brief Module entry
  *
@@ -156,6 +217,40 @@ SyscallHookEmulateSYSRET(_Inout_ VIRTUAL_MACHINE_STATE * VCpu);
 BOOLEAN
 SyscallHookEmulateSYSCALL(_Inout_ VIRTUAL_MACHINE_STATE * VCpu);
 
+VOID
+SyscallHookSetFilter(UINT64 * Bitmap, BOOLEAN IsActive);
+
+BOOLEAN
+SyscallHookIsFilteredOut(UINT64 SyscallNumber);
+
+BOOLEAN
+SyscallHookEnableLstarEntryHook();
+
+VOID
+SyscallHookDisableLstarEntryHook();
+
+VOID
+SyscallHookEmulateSWAPGS(_Inout_ VIRTUAL_MACHINE_STATE * VCpu);
+
+BOOLEAN
+SyscallHookCheckAndHandleLstarEntryBreakpoint(_Inout_ VIRTUAL_MACHINE_STATE * VCpu, UINT64 GuestRip);
+
+//////////////////////////////////////////////////
+//		    Interrupt Hooks Functions			//
+//////////////////////////////////////////////////
+
+BOOLEAN
+InterruptHookEnableIdtEntryHook(UINT32 Vector);
+
+VOID
+InterruptHookDisableIdtEntryHook(UINT32 Vector);
+
+BOOLEAN
+InterruptHookIsIdtEntryHooked(UINT32 Vector);
+
+BOOLEAN
+InterruptHookCheckAndHandleIdtEntryBreakpoint(_Inout_ VIRTUAL_MACHINE_STATE * VCpu, UINT64 GuestRip);
+
 //////////////////////////////////////////////////
 //		    	 Hidden Hooks Test				//
 //////////////////////////////////////////////////
@@ -166,12 +261,6 @@ PVOID(*ExAllocatePoolWithTagOrig)
     SIZE_T    NumberOfBytes,
     ULONG     Tag);
 
-/**
- * @brief Maximum number of supported execution trampoline
- *
- */
-#define MAX_EXEC_TRAMPOLINE_SIZE 100
-
 // ----------------------------------------------------------------------
 
 /**
@@ -195,6 +284,7 @@ EptHookPerformPageHook(PVOID TargetAddress, CR3_TYPE ProcessCr3);
  * @param UnsetWrite
  * @param EptHiddenHook
  * @param UnsetExecute
+ * @param LargePage
  * @return BOOLEAN
  */
 BOOLEAN
@@ -204,7 +294,8 @@ EptHookPerformPageHook2(PVOID    TargetAddress,
                         BOOLEAN  UnsetRead,
                         BOOLEAN  UnsetWrite,
                         BOOLEAN  UnsetExecute,
-                        BOOLEAN  EptHiddenHook);
+                        BOOLEAN  EptHiddenHook,
+                        BOOLEAN  LargePage);
 
 /**
  * @brief Hook in VMX Non Root Mode (hidden breakpoint)
@@ -238,6 +329,65 @@ EptHook2(PVOID   TargetAddress,
          BOOLEAN SetHookForExec,
          BOOLEAN EptHiddenHook2);
 
+/**
+ * @brief Monitor a whole 2MB page in VMX Non Root Mode without splitting it
+ *
+ * @param TargetAddress
+ * @param ProcessId
+ * @param SetHookForRead
+ * @param SetHookForWrite
+ * @param SetHookForExec
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+EptHookMonitorLargePage(PVOID   TargetAddress,
+                        UINT32  ProcessId,
+                        BOOLEAN SetHookForRead,
+                        BOOLEAN SetHookForWrite,
+                        BOOLEAN SetHookForExec);
+
+/**
+ * @brief Monitor a page in VMX Root Mode (A pre-allocated buffer should be available)
+ *
+ * @param TargetAddress
+ * @param ProcessCr3
+ * @param SetHookForRead
+ * @param SetHookForWrite
+ * @param SetHookForExec
+ * @param PhysicalBaseAddress
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+EptHookMonitorPageFromVmxRoot(PVOID    TargetAddress,
+                              CR3_TYPE ProcessCr3,
+                              BOOLEAN  SetHookForRead,
+                              BOOLEAN  SetHookForWrite,
+                              BOOLEAN  SetHookForExec,
+                              UINT64 * PhysicalBaseAddress);
+
+/**
+ * @brief Remove a monitor hook of a page in VMX Root Mode
+ *
+ * @param PhysicalBaseAddress
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+EptHookUnHookSinglePageFromVmxRoot(UINT64 PhysicalBaseAddress);
+
+/**
+ * @brief Apply multiple hooks in VMX Non Root Mode with a single
+ * invalidation of EPT on all cores
+ *
+ * @param Entries
+ * @param Count
+ * @return UINT32
+ */
+UINT32
+EptHookBatch(PEPT_HOOKS_BATCH_ENTRY Entries, UINT32 Count);
+
 /**
  * @brief Handle hooked pages in Vmx-root mode
  *
@@ -261,6 +411,38 @@ EptHookHandleHookedPage(VIRTUAL_MACHINE_STATE *              VCpu,
                         BOOLEAN *                            IsExecViolation,
                         BOOLEAN *                            IsTriggeringPostEventAllowed);
 
+/**
+ * @brief Find the details of a hooked page by its physical address
+ * (lock-free, can be used in vmx-root)
+ *
+ * @param PhysicalBaseAddress
+ * @return PEPT_HOOKED_PAGE_DETAIL
+ */
+_Must_inspect_result_
+PEPT_HOOKED_PAGE_DETAIL
+EptHookFindByPhysAddress(_In_ UINT64 PhysicalBaseAddress);
+
+/**
+ * @brief Find the details of the hooked page that contains a physical address
+ * (including the hooks that are applied on 2MB pages)
+ *
+ * @param PhysicalAddress
+ * @return PEPT_HOOKED_PAGE_DETAIL
+ */
+_Must_inspect_result_
+PEPT_HOOKED_PAGE_DETAIL
+EptHookFindByPhysAddressIncludingLargePages(_In_ UINT64 PhysicalAddress);
+
+/**
+ * @brief Check whether there is a hidden breakpoint on the address
+ *
+ * @param HookedEntry
+ * @param Address
+ * @return BOOLEAN
+ */
+BOOLEAN
+EptHookIsHiddenBreakpointAddress(EPT_HOOKED_PAGE_DETAIL * HookedEntry, UINT64 Address);
+
 /**
  * @brief Remove a special hook from the hooked pages lists
  *
@@ -320,11 +502,22 @@ EptHookRemoveEntryAndFreePoolFromEptHook2sDetourList(UINT64 Address);
  * @brief routines to generally handle breakpoint hit for detour
  * @param Regs
  * @param CalledFrom
+ * @param HookRecord
  *
  * @return PVOID
  */
 PVOID
-EptHook2GeneralDetourEventHandler(PGUEST_REGS Regs, PVOID CalledFrom);
+EptHook2GeneralDetourEventHandler(PGUEST_REGS Regs, PVOID CalledFrom, PEPT_HOOK_TRAMPOLINE_SLOT HookRecord);
+
+/**
+ * @brief Query the hit counts of the hidden hooks detour
+ * @param HitDetails
+ * @param MaximumCount
+ *
+ * @return UINT32
+ */
+UINT32
+EptHook2QueryDetourHitCounts(PEPT_HOOK2_DETOUR_HIT_DETAILS HitDetails, UINT32 MaximumCount);
 
 /**
  * @brief Allocate (reserve) extra pages for storing details of page hooks
@@ -17,6 +17,25 @@
 
 #define MAX_PHYSICAL_RAM_RANGE_COUNT 32
 
+/**
+ * @brief Count of the slots of the table of traced pages (power of two)
+ *
+ */
+#define MODE_BASED_EXEC_TRACE_TABLE_SIZE 16384
+
+/**
+ * @brief Maximum count of the traced pages (half of the slots)
+ *
+ */
+#define MODE_BASED_EXEC_TRACE_TABLE_MAX_ENTRIES (MODE_BASED_EXEC_TRACE_TABLE_SIZE / 2)
+
+/**
+ * @brief A slot of the table of traced pages that its entry is removed
+ * (the lookups continue probing the next slots)
+ *
+ */
+#define MODE_BASED_EXEC_TRACE_TABLE_DELETED_ENTRY ((PMODE_BASED_EXEC_TRACED_PAGE)1)
+
 //////////////////////////////////////////////////
 //				    Structures	    			//
 //////////////////////////////////////////////////
@@ -32,12 +51,70 @@ typedef struct MODE_BASED_RAM_REGIONS
 
 } MODE_BASED_RAM_REGIONS, *PMODE_BASED_RAM_REGIONS;
 
+/**
+ * @brief A page that its first execution is traced
+ *
+ */
+typedef struct _MODE_BASED_EXEC_TRACED_PAGE
+{
+    UINT64          PhysicalAddress; // Physical address of the page
+    UINT64          VirtualAddress;  // Virtual address of the page (in the traced process)
+    PEPT_PML1_ENTRY EptEntry;        // The entry of the page in the EPT table
+    BOOLEAN         IsUserMode;      // Whether the user-mode or the supervisor-mode execution is traced
+    volatile LONG   IsExecuted;      // Whether the page is executed (the event is triggered)
+
+} MODE_BASED_EXEC_TRACED_PAGE, *PMODE_BASED_EXEC_TRACED_PAGE;
+
+/**
+ * @brief A range of pages that is traced by an event
+ *
+ */
+typedef struct _MODE_BASED_EXEC_TRACE_RANGE
+{
+    LIST_ENTRY                  RangesList;   // Link of the list of traced ranges
+    UINT64                      Tag;          // Tag of the event that traces the range
+    UINT32                      CountOfPages; // Count of the traced pages of the range
+    MODE_BASED_EXEC_TRACED_PAGE Pages[1];     // The traced pages (CountOfPages entries)
+
+} MODE_BASED_EXEC_TRACE_RANGE, *PMODE_BASED_EXEC_TRACE_RANGE;
+
 //////////////////////////////////////////////////
 //				     Globals	    			//
 //////////////////////////////////////////////////
 
 MODE_BASED_RAM_REGIONS PhysicalRamRegions[MAX_PHYSICAL_RAM_RANGE_COUNT];
 
+/**
+ * @brief List of the traced ranges (MODE_BASED_EXEC_TRACE_RANGE)
+ *
+ */
+LIST_ENTRY g_ModeBasedExecTraceRangesList;
+
+/**
+ * @brief Table of the traced pages (NULL is an empty slot)
+ * @details only the writers take the lock, lookups in vmx-root are lock-free
+ *
+ */
+PMODE_BASED_EXEC_TRACED_PAGE volatile * g_ModeBasedExecTraceTable;
+
+/**
+ * @brief Count of the traced pages in the table
+ *
+ */
+UINT32 g_ModeBasedExecTraceTableCount;
+
+/**
+ * @brief Lock for modifying the list of traced ranges and the table of traced pages
+ *
+ */
+volatile LONG g_ModeBasedExecTraceLock;
+
+/**
+ * @brief Shows whether MBEC is enabled on all cores for tracing the execution of pages
+ *
+ */
+BOOLEAN g_ModeBasedExecTraceEnabled;
+
 //////////////////////////////////////////////////
 //				      Functions					//
 //////////////////////////////////////////////////
@@ -50,3 +127,21 @@ ModeBasedExecHookUninitialize();
 
 BOOLEAN
 ModeBasedExecHookDisableUsermodeExecution(PVMM_EPT_PAGE_TABLE EptTable);
+
+BOOLEAN
+ModeBasedExecHookTraceRange(UINT64  Tag,
+                            UINT64  StartAddress,
+                            UINT64  EndAddress,
+                            UINT32  ProcessId,
+                            BOOLEAN IsUserMode);
+
+BOOLEAN
+ModeBasedExecHookUntraceRange(UINT64 Tag);
+
+BOOLEAN
+ModeBasedExecHookIsPageTraced(UINT64 PhysicalAddress);
+
+BOOLEAN
+ModeBasedExecHookHandleEptViolation(VIRTUAL_MACHINE_STATE *                VCpu,
+                                    VMX_EXIT_QUALIFICATION_EPT_VIOLATION * ViolationQualification,
+                                    UINT64                                 GuestPhysicalAddr);
@@ -69,6 +69,9 @@ VmmCallbackUnhandledEptViolation(UINT32 CoreId,
                                  UINT64 ViolationQualification,
                                  UINT64 GuestPhysicalAddr);
 
+VOID
+VmmCallbackApplyPendingTasks(UINT32 CoreId);
+
 VOID
 VmmCallbackSetLastError(UINT32 LastError);
 
@@ -93,6 +96,10 @@ DebuggingCallbackConditionalPageFaultException(UINT32 CoreId,
                                                UINT64 Address,
                                                ULONG  ErrorCode);
 
+VOID
+DebuggingCallbackHandleInstructionCounterOverflow(UINT32 CoreId,
+                                                  UINT64 CountOfExecutedInstructions);
+
 //
 // Interception Callbacks
 //
@@ -22,6 +22,9 @@ DispatchEventEferSysret(VIRTUAL_MACHINE_STATE * VCpu, PVOID Context);
 VOID
 DispatchEventEferSyscall(VIRTUAL_MACHINE_STATE * VCpu, PVOID Context);
 
+VOID
+DispatchEventLstarSyscall(VIRTUAL_MACHINE_STATE * VCpu);
+
 VOID
 DispatchEventCpuid(VIRTUAL_MACHINE_STATE * VCpu);
 
@@ -55,12 +58,18 @@ DispatchEventException(VIRTUAL_MACHINE_STATE * VCpu);
 VOID
 DispatchEventExternalInterrupts(VIRTUAL_MACHINE_STATE * VCpu);
 
+VOID
+DispatchEventIdtEntryInterrupt(VIRTUAL_MACHINE_STATE * VCpu, UINT32 Vector);
+
 VOID
 DispatchEventHiddenHookExecCc(VIRTUAL_MACHINE_STATE * VCpu, PVOID Context);
 
 VOID
 DispatchEventHiddenHookExecDetours(VIRTUAL_MACHINE_STATE * VCpu, PVOID Context);
 
+VOID
+DispatchEventPageFirstExecution(VIRTUAL_MACHINE_STATE * VCpu, PVOID Context);
+
 VOID
 DispatchEventHiddenHookPageReadWriteExecReadPostEvent(VIRTUAL_MACHINE_STATE * VCpu, PVOID Context);
 
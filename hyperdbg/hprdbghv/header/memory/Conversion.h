@@ -18,3 +18,18 @@
 //
 // Function are globally defined in SDK
 //
+
+BOOLEAN
+AddressTranslationCacheLookup(_In_ UINT64 Cr3, _In_ UINT64 VirtualAddress, _Out_ UINT64 * PhysicalAddress);
+
+VOID
+AddressTranslationCacheInsert(_In_ UINT64 Cr3, _In_ UINT64 VirtualAddress, _In_ UINT64 PhysicalAddress);
+
+PUINT64
+AddressTranslationCacheMapTable(_In_ PAGING_LEVEL Level, _In_ UINT64 TablePhysicalAddress);
+
+VOID
+AddressTranslationCacheInvalidate(_Inout_ VIRTUAL_MACHINE_STATE * VCpu);
+
+VOID
+AddressTranslationCacheInvalidateAllCores();
@@ -23,6 +23,13 @@
 #define PAGE_4MB_OFFSET ((UINT64)(1 << 22) - 1)
 #define PAGE_1GB_OFFSET ((UINT64)(1 << 30) - 1)
 
+/**
+ * @brief Count of pages of the reserved window of each core for accessing
+ * multiple pages at once
+ *
+ */
+#define MEMORY_MAPPER_BULK_WINDOW_PAGES 64
+
 //////////////////////////////////////////////////
 //					   Enums  					//
 //////////////////////////////////////////////////
@@ -95,6 +102,17 @@ typedef struct _PAGE_ENTRY
     };
 } PAGE_ENTRY, *PPAGE_ENTRY;
 
+/**
+ * @brief Reserved window of multiple pages for accessing a run of pages
+ * @details the PTEs are saved separately as the window might be mapped by
+ * more than one page table
+ */
+typedef struct _MEMORY_MAPPER_BULK_WINDOW
+{
+    UINT64 VirtualAddress;                                       // The actual kernel virtual address of the window
+    UINT64 PteVirtualAddresses[MEMORY_MAPPER_BULK_WINDOW_PAGES]; // The virtual address of PTEs of the pages of the window
+} MEMORY_MAPPER_BULK_WINDOW, *PMEMORY_MAPPER_BULK_WINDOW;
+
 /**
  * @brief Memory mapper PTE and reserved virtual address
  * @details Memory mapper details for each core, contains PTE Virtual Address, Actual Kernel Virtual Address
@@ -106,6 +124,9 @@ typedef struct _MEMORY_MAPPER_ADDRESSES
 
     UINT64 PteVirtualAddressForWrite; // The virtual address of PTE for write operations
     UINT64 VirualAddressForWrite;     // The actual kernel virtual address to write
+
+    MEMORY_MAPPER_BULK_WINDOW BulkWindowForRead;  // The window for reading multiple pages
+    MEMORY_MAPPER_BULK_WINDOW BulkWindowForWrite; // The window for writing multiple pages
 } MEMORY_MAPPER_ADDRESSES, *PMEMORY_MAPPER_ADDRESSES;
 
 //////////////////////////////////////////////////
@@ -144,6 +165,18 @@ MemoryMapperGetPteByCr3(_In_ PVOID    VirtualAddress,
 static PVOID
 MemoryMapperMapPageAndGetPte(_Out_ PUINT64 PteAddress);
 
+static BOOLEAN
+MemoryMapperReserveBulkWindow(_Out_ PMEMORY_MAPPER_BULK_WINDOW Window);
+
+static PVOID
+MemoryMapperMapBulkWindow(_Inout_ PMEMORY_MAPPER_BULK_WINDOW Window,
+                          _In_ PHYSICAL_ADDRESS              PhysicalAddresses[],
+                          _In_ UINT32                        PagesCount);
+
+static VOID
+MemoryMapperUnmapBulkWindow(_Inout_ PMEMORY_MAPPER_BULK_WINDOW Window,
+                            _In_ UINT32                        PagesCount);
+
 static BOOLEAN
 MemoryMapperReadMemorySafeByPte(_In_ PHYSICAL_ADDRESS PaAddressToRead,
                                 _Inout_ PVOID         BufferToSaveMemory,
@@ -0,0 +1,80 @@
+/**
+ * @file PhysicalMemoryMap.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers of the map of the physical memory ranges that are backed by RAM
+ * @details
+ * @version 0.2
+ * @date 2023-05-09
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum count of the ranges of the physical memory map
+ *
+ */
+#define PhysicalMemoryMapMaximumRanges 128
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A range of the physical memory that is backed by RAM
+ *
+ */
+typedef struct _PHYSICAL_MEMORY_MAP_RANGE
+{
+    UINT64 BaseAddress; // Start of the range (page aligned)
+    UINT64 EndAddress;  // End of the range (exclusive)
+
+} PHYSICAL_MEMORY_MAP_RANGE, *PPHYSICAL_MEMORY_MAP_RANGE;
+
+//////////////////////////////////////////////////
+//				Global Variables				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Ranges of the physical memory map (sorted and non-overlapping)
+ *
+ */
+PHYSICAL_MEMORY_MAP_RANGE g_PhysicalMemoryMapRanges[PhysicalMemoryMapMaximumRanges];
+
+/**
+ * @brief Count of the ranges of the physical memory map
+ *
+ */
+UINT32 g_PhysicalMemoryMapCount;
+
+/**
+ * @brief Shows whether the physical memory map is built or not
+ * @details if the map is not built, all of the physical addresses are
+ * considered as RAM
+ *
+ */
+BOOLEAN g_PhysicalMemoryMapInitialized;
+
+//////////////////////////////////////////////////
+//				   Functions					//
+//////////////////////////////////////////////////
+
+static BOOLEAN
+PhysicalMemoryMapInsertRange(UINT32 Index, UINT64 BaseAddress, UINT64 EndAddress);
+
+static VOID
+PhysicalMemoryMapRemoveRange(UINT64 BaseAddress, UINT64 EndAddress);
+
+static INT32
+PhysicalMemoryMapFindRange(UINT64 PhysicalAddress);
+
+BOOLEAN
+PhysicalMemoryMapInitialize();
+
+VOID
+PhysicalMemoryMapUninitialize();
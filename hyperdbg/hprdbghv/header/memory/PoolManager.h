@@ -22,6 +22,27 @@
 #define MaximumRequestsQueueDepth   100
 #define NumberOfPreAllocatedBuffers 10
 
+/**
+ * @brief Count of size classes of pools
+ * @details pools in the size class 'n' are at most (1 << n) bytes
+ *
+ */
+#define NumberOfPoolSizeClasses 32
+
+/**
+ * @brief Count of buckets of the table for finding a pool by its address
+ * (should be a power of two)
+ *
+ */
+#define NumberOfPoolHashBuckets 256
+
+/**
+ * @brief Interval of checking for refill requests by the refill worker (in milliseconds)
+ * @details requests from vmx-root can't signal the worker, so they wait for this interval
+ *
+ */
+#define PoolRefillWorkerInterval 50
+
 //////////////////////////////////////////////////
 //                   Structures		   			//
 //////////////////////////////////////////////////
@@ -36,12 +57,37 @@ typedef struct _POOL_TABLE
     SIZE_T                    Size;
     POOL_ALLOCATION_INTENTION Intention;
     LIST_ENTRY                PoolsList;
+    LIST_ENTRY                HashList;      // Link in the bucket of the address (g_PoolHashBuckets)
+    SLIST_ENTRY               FreeListEntry; // Link in the free list, or in the list of pools to be freed once it's busy
     BOOLEAN                   IsBusy;
     BOOLEAN                   ShouldBeFreed;
     BOOLEAN                   AlreadyFreed;
 
 } POOL_TABLE, *PPOOL_TABLE;
 
+/**
+ * @brief Watermarks and statistics of an intention
+ * @details latencies are in 100ns units
+ *
+ */
+typedef struct _POOL_INTENTION_STATE
+{
+    volatile LONG   FreeCount;            // Count of pools in the free lists
+    UINT32          LowWatermark;         // Pools are refilled once FreeCount goes below it (zero disables it)
+    UINT32          HighWatermark;        // Count of free pools after refilling
+    SIZE_T          Size;                 // Size of the refilled pools (the last allocated size)
+    volatile LONG   RefillPending;        // A refill is requested but not performed yet
+    UINT64          RefillRequestTime;    // Interrupt time of requesting the refill
+    volatile LONG64 Requests;             // Count of requests of pools
+    volatile LONG64 Misses;               // Count of requests that didn't find any pool
+    volatile LONG   BusyCount;            // Count of pools that are in use
+    volatile LONG   PeakBusyCount;        // Maximum count of pools that were in use at the same time
+    UINT64          Refills;              // Count of performed refills
+    UINT64          TotalRefillLatency;   // Sum of the latencies of refills
+    UINT64          MaximumRefillLatency; // Maximum latency of refills
+
+} POOL_INTENTION_STATE, *PPOOL_INTENTION_STATE;
+
 /**
  * @brief Manage the requests for new allocations
  *
@@ -94,6 +140,55 @@ BOOLEAN g_IsNewRequestForDeAllocation;
  */
 LIST_ENTRY g_ListOfAllocatedPoolsHead;
 
+/**
+ * @brief Lock-free stacks of free pools for each intention and size class
+ *
+ */
+SLIST_HEADER g_PoolFreeLists[NumberOfPoolIntentions][NumberOfPoolSizeClasses];
+
+/**
+ * @brief Lock-free stack of pools that should be freed on the next
+ * PoolManagerCheckAndPerformAllocationAndDeallocation
+ *
+ */
+SLIST_HEADER g_PoolsToBeFreedList;
+
+/**
+ * @brief Buckets of pools based on their addresses (protected by LockForReadingPool)
+ *
+ */
+LIST_ENTRY g_PoolHashBuckets[NumberOfPoolHashBuckets];
+
+/**
+ * @brief Watermarks and statistics of each intention
+ *
+ */
+POOL_INTENTION_STATE g_PoolIntentionStates[NumberOfPoolIntentions];
+
+/**
+ * @brief Spinlock for performing the allocations (refill worker and IOCTLs)
+ *
+ */
+volatile LONG LockForPerformingAllocation;
+
+/**
+ * @brief The thread object of the refill worker
+ *
+ */
+PKTHREAD g_PoolRefillWorkerThread;
+
+/**
+ * @brief The event of waking up the refill worker
+ *
+ */
+KEVENT g_PoolRefillWorkerEvent;
+
+/**
+ * @brief Shows whether the refill worker should be stopped
+ *
+ */
+volatile BOOLEAN g_PoolRefillWorkerShouldStop;
+
 //////////////////////////////////////////////////
 //                   Functions		  			//
 //////////////////////////////////////////////////
@@ -110,6 +205,30 @@ PlmgrAllocateRequestNewAllocation(SIZE_T NumberOfBytes);
 
 static VOID PlmgrFreeRequestNewAllocation(VOID);
 
+static UINT32
+PlmgrGetSizeClass(SIZE_T Size);
+
+static PLIST_ENTRY
+PlmgrGetHashBucket(UINT64 Address);
+
+static VOID
+PlmgrRequestRefillIfNeeded(POOL_ALLOCATION_INTENTION Intention, SIZE_T Size);
+
+static VOID
+PlmgrUpdatePeakBusyCount(PPOOL_INTENTION_STATE State, LONG BusyCount);
+
+static BOOLEAN
+PlmgrPerformAllocations();
+
+static VOID
+PlmgrRefillWorker(PVOID Context);
+
+static BOOLEAN
+PlmgrStartRefillWorker();
+
+static VOID
+PlmgrStopRefillWorker();
+
 // ----------------------------------------------------------------------------
 // Public Interfaces
 //
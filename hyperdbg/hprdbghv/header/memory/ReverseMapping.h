@@ -0,0 +1,177 @@
+/**
+ * @file ReverseMapping.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers of the index of virtual addresses that map physical addresses
+ * @details
+ * @version 0.2
+ * @date 2023-05-11
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum count of mappings of the index
+ *
+ */
+#define ReverseMappingMaximumEntries 0x400000
+
+/**
+ * @brief Initial count of mappings that are allocated for the index
+ *
+ */
+#define ReverseMappingInitialEntries 0x10000
+
+/**
+ * @brief Maximum count of processes of the index
+ * @details the index of the process is kept in the upper bits of the
+ * virtual address of entries
+ *
+ */
+#define ReverseMappingMaximumProcesses 0x10000
+
+/**
+ * @brief Process ids are looked up until this value
+ *
+ */
+#define ReverseMappingMaximumProcessId 0x40000
+
+/**
+ * @brief The index is rebuilt if it's older than this time (100 nanoseconds units)
+ *
+ */
+#define ReverseMappingExpirationTime (10 * 1000 * 1000 * 10ULL)
+
+/**
+ * @brief Size codes of pages that are kept in the lower bits of the
+ * physical address of entries
+ *
+ */
+#define ReverseMappingPageSize4Kb 0
+#define ReverseMappingPageSize2Mb 1
+#define ReverseMappingPageSize1Gb 2
+
+/**
+ * @brief Size of 1GB pages
+ *
+ */
+#define SIZE_1_GB ((SIZE_T)(512 * SIZE_2_MB))
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A mapping of the index
+ *
+ */
+typedef struct _REVERSE_MAPPING_ENTRY
+{
+    UINT64 PhysicalKey;             // Physical address of the page | size code of the page
+    UINT64 VirtualPageAndProcessId; // Virtual address of the page (48 bits) | index of the process << 48
+
+} REVERSE_MAPPING_ENTRY, *PREVERSE_MAPPING_ENTRY;
+
+/**
+ * @brief A process of the index
+ *
+ */
+typedef struct _REVERSE_MAPPING_PROCESS
+{
+    UINT32   ProcessId;
+    CR3_TYPE Cr3;
+
+} REVERSE_MAPPING_PROCESS, *PREVERSE_MAPPING_PROCESS;
+
+/**
+ * @brief The state of building the index
+ *
+ */
+typedef struct _REVERSE_MAPPING_BUILD_STATE
+{
+    UINT64 * Tables[4];  // Buffers of the page-tables of each level (PML4 to PT)
+    UINT32   ProcessIndex;
+    UINT64   SelfMapPfn; // The PML4 entry that maps the PML4 is not walked
+    BOOLEAN  IsTruncated;
+
+} REVERSE_MAPPING_BUILD_STATE, *PREVERSE_MAPPING_BUILD_STATE;
+
+//////////////////////////////////////////////////
+//				Global Variables				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Mappings of the index (sorted by physical address)
+ *
+ */
+PREVERSE_MAPPING_ENTRY g_ReverseMappingEntries;
+
+/**
+ * @brief Count and capacity of the mappings of the index
+ *
+ */
+UINT32 g_ReverseMappingCount;
+UINT32 g_ReverseMappingCapacity;
+
+/**
+ * @brief Processes of the index
+ *
+ */
+PREVERSE_MAPPING_PROCESS g_ReverseMappingProcesses;
+
+/**
+ * @brief Count of processes of the index
+ *
+ */
+UINT32 g_ReverseMappingCountOfProcesses;
+
+/**
+ * @brief The time that the index is built (interrupt time)
+ *
+ */
+UINT64 g_ReverseMappingBuildTime;
+
+/**
+ * @brief Lock of building and querying the index
+ *
+ */
+volatile LONG ReverseMappingLock;
+
+//////////////////////////////////////////////////
+//				   Functions					//
+//////////////////////////////////////////////////
+
+static UINT64
+ReverseMappingCanonicalAddress(UINT64 VirtualAddress);
+
+static UINT64
+ReverseMappingGetPageSize(UINT32 SizeCode);
+
+static BOOLEAN
+ReverseMappingReadTable(UINT64 Pfn, UINT64 * Buffer);
+
+static BOOLEAN
+ReverseMappingReadTableEntry(UINT64 Pfn, UINT32 Index, PPAGE_ENTRY Entry);
+
+static BOOLEAN
+ReverseMappingAddEntry(PREVERSE_MAPPING_BUILD_STATE State, UINT64 PhysicalAddress, UINT32 SizeCode, UINT64 VirtualAddress);
+
+static VOID
+ReverseMappingWalkProcess(PREVERSE_MAPPING_BUILD_STATE State, CR3_TYPE Cr3, UINT32 FirstPml4Index, UINT32 LastPml4Index);
+
+static VOID
+ReverseMappingSortEntries();
+
+static BOOLEAN
+ReverseMappingBuild();
+
+static UINT64
+ReverseMappingTranslate(CR3_TYPE Cr3, UINT64 VirtualAddress);
+
+VOID
+ReverseMappingUninitialize();
@@ -18,5 +18,11 @@
 PVOID
 CrsAllocateContiguousZeroedMemory(_In_ SIZE_T NumberOfBytes);
 
+ULONG
+CrsGetNodeOfCore(_In_ UINT32 CoreId);
+
+PVOID
+CrsAllocateContiguousZeroedMemoryOnCore(_In_ SIZE_T NumberOfBytes, _In_ UINT32 CoreId);
+
 PVOID
 CrsAllocateNonPagedPool(SIZE_T NumberOfBytes);
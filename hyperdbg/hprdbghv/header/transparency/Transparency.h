@@ -18,6 +18,15 @@
 BOOLEAN
 TransparentModeStart(VIRTUAL_MACHINE_STATE * VCpu, UINT32 ExitReason);
 
+VOID
+TransparentSetTscOffsetting(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Set);
+
+VOID
+TransparentCompensateTimeInVmxRoot(VIRTUAL_MACHINE_STATE * VCpu);
+
+BOOLEAN
+TransparentHandleWrmsr(VIRTUAL_MACHINE_STATE * VCpu, UINT32 TargetMsr, UINT64 Value);
+
 //////////////////////////////////////////////////
 //				   Definitions					//
 //////////////////////////////////////////////////
@@ -34,6 +43,13 @@ TransparentModeStart(VIRTUAL_MACHINE_STATE * VCpu, UINT32 ExitReason);
  */
 #define RAND_MAX 0x7fff
 
+/**
+ * @brief Count of buckets of the set of process ids of the transparent-mode
+ * @details should be a power of two
+ *
+ */
+#define TRANSPARENCY_PROCESS_ID_BUCKETS 64
+
 //////////////////////////////////////////////////
 //				   Structures					//
 //////////////////////////////////////////////////
@@ -53,6 +69,8 @@ typedef struct _TRANSPARENCY_MEASUREMENTS
     UINT64 RdtscMedian;
 
     LIST_ENTRY ProcessList;
+    LIST_ENTRY ProcessIdBuckets[TRANSPARENCY_PROCESS_ID_BUCKETS]; // The set of process ids (by HashList of TRANSPARENCY_PROCESS)
+    UINT32     CountOfProcessNames;
 
 } TRANSPARENCY_MEASUREMENTS, *PTRANSPARENCY_MEASUREMENTS;
 
@@ -67,5 +85,6 @@ typedef struct _TRANSPARENCY_PROCESS
     PVOID      BufferAddress;
     BOOLEAN    TrueIfProcessIdAndFalseIfProcessName;
     LIST_ENTRY OtherProcesses;
+    LIST_ENTRY HashList; // Link in the bucket of the process id (only for the process ids)
 
 } TRANSPARENCY_PROCESS, *PTRANSPARENCY_PROCESS;
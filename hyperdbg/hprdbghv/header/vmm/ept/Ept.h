@@ -23,6 +23,7 @@
 #define PAGE_ATTRIB_WRITE            0x4
 #define PAGE_ATTRIB_EXEC             0x8
 #define PAGE_ATTRIB_EXEC_HIDDEN_HOOK 0x10
+#define PAGE_ATTRIB_LARGE_PAGE       0x20
 
 /**
  * @brief The number of 512GB PML4 entries in the page table
@@ -56,6 +57,18 @@
  */
 #define SIZE_2_MB ((SIZE_T)(512 * PAGE_SIZE))
 
+/**
+ * @brief Integer 1GB
+ *
+ */
+#define SIZE_1_GB ((SIZE_T)(512 * SIZE_2_MB))
+
+/**
+ * @brief Align the address to the start of its 2MB page
+ *
+ */
+#define LARGE_PAGE_ALIGN(_VAR_) ((UINT64)(_VAR_) & ~(SIZE_2_MB - 1))
+
 /**
  * @brief Offset into the 1st paging structure (4096 byte)
  *
@@ -86,6 +99,26 @@
  */
 #define ADDRMASK_EPT_PML4_INDEX(_VAR_) ((_VAR_ & 0xFF8000000000ULL) >> 39)
 
+/**
+ * @brief Count of the slots of the table of hooked pages (power of two)
+ *
+ */
+#define EPT_HOOKED_PAGES_TABLE_SIZE 1024
+
+/**
+ * @brief Maximum count of the hooked pages in the table (3/4 of the slots),
+ * the remaining hooked pages are only found in the list of hooked pages
+ *
+ */
+#define EPT_HOOKED_PAGES_TABLE_MAX_ENTRIES ((EPT_HOOKED_PAGES_TABLE_SIZE / 4) * 3)
+
+/**
+ * @brief A slot of the table of hooked pages that its entry is removed
+ * (the lookups continue probing the next slots)
+ *
+ */
+#define EPT_HOOKED_PAGES_TABLE_DELETED_ENTRY ((PEPT_HOOKED_PAGE_DETAIL)1)
+
 //////////////////////////////////////////////////
 //	    			Variables 	 	            //
 //////////////////////////////////////////////////
@@ -96,6 +129,36 @@
  */
 volatile LONG Pml1ModificationAndInvalidationLock;
 
+/**
+ * @brief Lock for modifying the table of hooked pages
+ * @details only the writers take this lock, lookups are lock-free
+ *
+ */
+volatile LONG EptHookedPagesTableLock;
+
+/**
+ * @brief Lock for applying and removing the hooks in vmx-root
+ * @details the hooks of the scripts are applied from vmx-root on
+ * multiple cores at the same time
+ *
+ */
+volatile LONG EptHookVmxRootLock;
+
+/**
+ * @brief Lock for modifying the list of split 2MB pages
+ *
+ */
+volatile LONG EptDynamicSplitsListLock;
+
+/**
+ * @brief Lock for splitting the 1GB pages into 2MB pages
+ * @details the PML2 table of each 1GB region is filled once, two cores
+ * that split the same 1GB page at the same time would otherwise
+ * overwrite the 2MB entries that are already changed by the first one
+ *
+ */
+volatile LONG EptSplitPml3LargePagesLock;
+
 //////////////////////////////////////////////////
 //			     Structs Cont.                	//
 //////////////////////////////////////////////////
@@ -128,6 +191,33 @@ typedef struct _VMM_EPT_PAGE_TABLE
 
 } VMM_EPT_PAGE_TABLE, *PVMM_EPT_PAGE_TABLE;
 
+/**
+ * @brief The EPT view of a core for executing one instruction without a hook
+ * @details the paging structures are shared with the EPT page table except the
+ * path to the restored page, the PML2 and the PML1 tables of the page are copied
+ * on each restoration and only the entry of the page is changed
+ *
+ */
+typedef struct _VMM_EPT_CORE_VIEW
+{
+    DECLSPEC_ALIGN(PAGE_SIZE)
+    EPT_PML4_POINTER PML4[VMM_EPT_PML4E_COUNT];
+
+    DECLSPEC_ALIGN(PAGE_SIZE)
+    EPT_PML3_POINTER PML3[VMM_EPT_PML3E_COUNT];
+
+    DECLSPEC_ALIGN(PAGE_SIZE)
+    EPT_PML2_ENTRY PML2[VMM_EPT_PML2E_COUNT]; // Copy of the PML2 table of the restored page
+
+    DECLSPEC_ALIGN(PAGE_SIZE)
+    EPT_PML1_ENTRY PML1[VMM_EPT_PML1E_COUNT]; // Copy of the PML1 table of the restored page
+
+    SIZE_T Pml2PageFrameNumber;
+    SIZE_T Pml1PageFrameNumber;
+    SIZE_T RestoredPml3Index; // The PML3 entry that points to the copied PML2 table
+
+} VMM_EPT_CORE_VIEW, *PVMM_EPT_CORE_VIEW;
+
 /**
  * @brief MTRR Range Descriptor
  *
@@ -152,9 +242,24 @@ typedef struct _EPT_STATE
     PVMM_EPT_PAGE_TABLE   EptPageTable;                                // Page table entries for EPT operation
     PVMM_EPT_PAGE_TABLE   ModeBasedEptPageTable;                       // Page table entries for hooks based on mode-based execution control bits
     PVMM_EPT_PAGE_TABLE   ExecuteOnlyEptPageTable;                     // Page table entries for execute-only control bits
+    PVMM_EPT_PAGE_TABLE   UnhookedEptPageTable;                        // Page table entries without any hooks (used for one instruction after hook exits)
     EPT_POINTER           EptPointer;                                  // Extended-Page-Table Pointer
     EPT_POINTER           ModeBasedEptPointer;                         // Extended-Page-Table Pointer for Mode-based execution
     EPT_POINTER           ExecuteOnlyEptPointer;                       // Extended-Page-Table Pointer for execute-only execution
+    EPT_POINTER           UnhookedEptPointer;                          // Extended-Page-Table Pointer for the unhooked view
+
+    //
+    // Open-addressing table of the hooked pages (keyed by page frame number)
+    //
+    PEPT_HOOKED_PAGE_DETAIL volatile HookedPagesTable[EPT_HOOKED_PAGES_TABLE_SIZE]; // The hooked pages (NULL is an empty slot)
+    UINT32                           HookedPagesTableCount;                         // Count of the hooked pages in the table
+    BOOLEAN                          HookedPagesTableOverflowed;                    // Some hooked pages are not in the table (search the list)
+    volatile LONG                    HookedLargePagesCount;                         // Count of hooks that are applied on 2MB pages
+
+    //
+    // Split 2MB pages (merged again once they're not used by any hook)
+    //
+    LIST_ENTRY DynamicSplitsList; // A list of the split 2MB pages (VMM_EPT_DYNAMIC_SPLIT)
 
 } EPT_STATE, *PEPT_STATE;
 
@@ -181,6 +286,12 @@ typedef struct _VMM_EPT_DYNAMIC_SPLIT
         PEPT_PML2_POINTER Pointer;
     };
 
+    /**
+     * @brief The 2MB table entry before splitting (restored once the split is merged)
+     *
+     */
+    EPT_PML2_ENTRY OriginalEntry;
+
     /**
      * @brief Linked list entries for each dynamic split
      *
@@ -200,6 +311,9 @@ typedef struct _VMM_EPT_DYNAMIC_SPLIT
 static VOID
 EptSetupPML2Entry(PEPT_PML2_ENTRY NewEntry, SIZE_T PageFrameNumber);
 
+static BOOLEAN
+EptGetPml3MemoryType(SIZE_T Pml3Index, UINT8 * MemoryType);
+
 static BOOLEAN
 EptHandlePageHookExit(_Inout_ VIRTUAL_MACHINE_STATE *           VCpu,
                       _In_ VMX_EXIT_QUALIFICATION_EPT_VIOLATION ViolationQualification,
@@ -233,6 +347,15 @@ EptBuildMtrrMap();
 PVMM_EPT_PAGE_TABLE
 EptAllocateAndCreateIdentityPageTable();
 
+/**
+ * @brief Allocates page maps and copy an identity page table
+ *
+ * @param TemplatePageTable The identity page table to copy
+ * @return PVMM_EPT_PAGE_TABLE identity map page-table
+ */
+PVMM_EPT_PAGE_TABLE
+EptCloneIdentityPageTable(PVMM_EPT_PAGE_TABLE TemplatePageTable);
+
 /**
  * @brief Convert 2MB pages to 4KB pages
  *
@@ -246,6 +369,33 @@ EptSplitLargePage(PVMM_EPT_PAGE_TABLE EptPageTable,
                   PVOID               PreAllocatedBuffer,
                   SIZE_T              PhysicalAddress);
 
+/**
+ * @brief Convert a 1GB page to 2MB pages
+ *
+ * @param EptPageTable
+ * @param PhysicalAddress
+ * @return BOOLEAN
+ */
+BOOLEAN
+EptSplitPml3LargePage(PVMM_EPT_PAGE_TABLE EptPageTable, SIZE_T PhysicalAddress);
+
+/**
+ * @brief Convert all of the 1GB pages to 2MB pages
+ *
+ * @param EptPageTable
+ * @return VOID
+ */
+VOID
+EptSplitAllPml3LargePages(PVMM_EPT_PAGE_TABLE EptPageTable);
+
+/**
+ * @brief Merge the split 2MB pages that are not used by any hook
+ *
+ * @return UINT32
+ */
+UINT32
+EptMergeSplitLargePages();
+
 /**
  * @brief Split 2MB (LargePage) into 4kb pages
  *
@@ -308,6 +458,34 @@ EptGetPml1OrPml2Entry(PVMM_EPT_PAGE_TABLE EptPageTable, SIZE_T PhysicalAddress,
 VOID
 EptHandleMonitorTrapFlag(VIRTUAL_MACHINE_STATE * VCpu);
 
+/**
+ * @brief Allocate the EPT view of a core
+ *
+ * @param VCpu The virtual processor's state
+ * @return BOOLEAN
+ */
+BOOLEAN
+EptAllocateCoreView(VIRTUAL_MACHINE_STATE * VCpu);
+
+/**
+ * @brief Switch the current core to an EPT view without the hook
+ *
+ * @param VCpu The virtual processor's state
+ * @param HookedEntry The hooked page
+ * @return BOOLEAN
+ */
+BOOLEAN
+EptSwitchToUnhookedView(VIRTUAL_MACHINE_STATE * VCpu, PEPT_HOOKED_PAGE_DETAIL HookedEntry);
+
+/**
+ * @brief Switch the current core back from the unhooked EPT view
+ *
+ * @param VCpu The virtual processor's state
+ * @return VOID
+ */
+VOID
+EptRestoreFromUnhookedView(VIRTUAL_MACHINE_STATE * VCpu);
+
 /**
  * @brief Handle Ept Misconfigurations
  *
@@ -0,0 +1,41 @@
+/**
+ * @file BitmapOwnership.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The headers for the ownership (reference counts) of the bitmaps
+ * and the exiting controls that are shared between events
+ * @details
+ * @version 0.4
+ * @date 2023-07-30
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				    Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+BitmapOwnershipAllocate(VIRTUAL_MACHINE_STATE * VCpu);
+
+VOID
+BitmapOwnershipFree(VIRTUAL_MACHINE_STATE * VCpu);
+
+VOID
+BitmapOwnershipAcquire(VIRTUAL_MACHINE_STATE * VCpu, BITMAP_OWNERSHIP_RESOURCE_TYPE ResourceType, UINT64 Index, UINT64 Mask);
+
+VOID
+BitmapOwnershipRelease(VIRTUAL_MACHINE_STATE * VCpu, BITMAP_OWNERSHIP_RESOURCE_TYPE ResourceType, UINT64 Index, UINT64 Mask);
+
+VOID
+BitmapOwnershipReset(VIRTUAL_MACHINE_STATE * VCpu, BITMAP_OWNERSHIP_RESOURCE_TYPE ResourceType, UINT64 Index);
+
+UINT32
+BitmapOwnershipQueryExceptionBitmapMask(VIRTUAL_MACHINE_STATE * VCpu);
+
+BOOLEAN
+BitmapOwnershipIsMovToDebugRegsOwned(VIRTUAL_MACHINE_STATE * VCpu);
+
+UINT64
+BitmapOwnershipQueryControlRegisterMask(VIRTUAL_MACHINE_STATE * VCpu, UINT64 ControlRegister);
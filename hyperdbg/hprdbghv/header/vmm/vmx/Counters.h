@@ -29,3 +29,12 @@ CounterSetPreemptionTimer(UINT32 TimerValue);
 
 VOID
 CounterClearPreemptionTimer();
+
+UINT32
+CounterQueryRequestedPreemptionTimer();
+
+VOID
+CounterUpdatePreemptionTimer();
+
+VOID
+CounterReloadPreemptionTimer();
@@ -0,0 +1,71 @@
+/**
+ * @file CpuidHandler.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The headers for the table of CPUID leaves
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Count of the leaves of each range (basic, hypervisor and extended)
+ * that are in the table of CPUID leaves
+ *
+ */
+#define CPUID_HANDLER_LEAVES_PER_RANGE 0x40
+
+/**
+ * @brief Count of the entries of the table of CPUID leaves
+ *
+ */
+#define CPUID_HANDLER_LEAVES_TABLE_SIZE (CPUID_HANDLER_LEAVES_PER_RANGE * 3)
+
+/**
+ * @brief Flags of the leaves in the table of CPUID leaves
+ *
+ */
+#define CPUID_LEAF_FLAG_EVENT     0x1 // At least one of the events is interested in this leaf
+#define CPUID_LEAF_FLAG_CACHEABLE 0x2 // The result is static (same sub-leaves and same results on each core)
+#define CPUID_LEAF_FLAG_MODIFIED  0x4 // The result is modified by the hypervisor (if it's not transparent)
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief An entry of the table of CPUID leaves
+ *
+ */
+typedef struct _CPUID_LEAF_ENTRY
+{
+    UCHAR Flags;     // CPUID_LEAF_FLAG_*
+    UCHAR CacheSlot; // The slot of the per-core cache (only for the cacheable leaves)
+
+} CPUID_LEAF_ENTRY, *PCPUID_LEAF_ENTRY;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+VOID
+CpuidHandlerInitialize();
+
+VOID
+CpuidHandlerSetEventFilter(_In_reads_(LeavesCount) UINT32 * Leaves, _In_ UINT32 LeavesCount, _In_ BOOLEAN IsActive);
+
+BOOLEAN
+CpuidHandlerIsFilteredOut(_In_ UINT32 Leaf);
+
+UCHAR
+CpuidHandlerExecute(_Inout_ VIRTUAL_MACHINE_STATE * VCpu, _In_ UINT32 Leaf, _In_ UINT32 SubLeaf, _Out_writes_(4) INT32 * CpuInfo);
+
+VOID
+CpuidHandlerInvalidateCache(_Inout_ VIRTUAL_MACHINE_STATE * VCpu);
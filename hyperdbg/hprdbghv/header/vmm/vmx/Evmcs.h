@@ -0,0 +1,160 @@
+/**
+ * @file Evmcs.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The headers for the enlightened VMCS of Hyper-V
+ * @details once HyperDbg is nested under Hyper-V, the fields of VMCS are
+ * accessed on the enlightened VMCS (memory) instead of VMREAD and VMWRITE,
+ * so they don't cause vm-exits to Hyper-V
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The version of the enlightened VMCS that is supported
+ *
+ */
+#define EVMCS_VERSION 1
+
+/**
+ * @brief The signature of Hyper-V in CPUID.40000000H ("Microsoft Hv")
+ *
+ */
+#define EVMCS_HYPERV_SIGNATURE_EBX 0x7263694d // "Micr"
+#define EVMCS_HYPERV_SIGNATURE_ECX 0x666f736f // "osof"
+#define EVMCS_HYPERV_SIGNATURE_EDX 0x76482074 // "t Hv"
+
+/**
+ * @brief Bits of the index in the encoding of fields that are used for
+ * finding the fields (the indexes of the fields of the enlightened VMCS
+ * are smaller than 32)
+ *
+ */
+#define EVMCS_FIELD_INDEX_BITS 5
+
+/**
+ * @brief Size of the table of the fields (width, type and the index of
+ * the encoding)
+ *
+ */
+#define EVMCS_FIELDS_TABLE_SIZE (1 << (EVMCS_FIELD_INDEX_BITS + 4))
+
+/**
+ * @brief Widths of the fields (bits 14:13 of the encoding)
+ *
+ */
+#define EVMCS_FIELD_WIDTH_16BIT   0
+#define EVMCS_FIELD_WIDTH_64BIT   1
+#define EVMCS_FIELD_WIDTH_32BIT   2
+#define EVMCS_FIELD_WIDTH_NATURAL 3
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A field of the enlightened VMCS
+ * @details the offset of the fields that are not in the enlightened VMCS
+ * is zero
+ *
+ */
+typedef struct _EVMCS_FIELD
+{
+    UINT16 Offset;     // Offset of the field in the enlightened VMCS
+    UINT16 CleanField; // The clean field (group) that should be dirtied once the field is written
+
+} EVMCS_FIELD, *PEVMCS_FIELD;
+
+/**
+ * @brief Mapping of the encoding of a field to the enlightened VMCS
+ *
+ */
+typedef struct _EVMCS_FIELD_MAPPING
+{
+    UINT32 Encoding;
+    UINT16 Offset;
+    UINT16 CleanField;
+
+} EVMCS_FIELD_MAPPING, *PEVMCS_FIELD_MAPPING;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+VOID
+EvmcsInitialize();
+
+BOOLEAN
+EvmcsAllocateVpAssistPage(_Inout_ VIRTUAL_MACHINE_STATE * VCpu);
+
+VOID
+EvmcsFreeVpAssistPage(_Inout_ VIRTUAL_MACHINE_STATE * VCpu);
+
+VOID
+EvmcsLoad(_Inout_ VIRTUAL_MACHINE_STATE * VCpu);
+
+VOID
+EvmcsUnload(_Inout_ VIRTUAL_MACHINE_STATE * VCpu);
+
+VOID
+EvmcsMarkAllFieldsClean(_In_ VIRTUAL_MACHINE_STATE * VCpu);
+
+VOID
+EvmcsMarkFieldsDirty(_In_ VIRTUAL_MACHINE_STATE * VCpu, _In_ UINT32 CleanFields);
+
+UCHAR
+EvmcsRead(_In_ size_t Field, _Out_ size_t * FieldValue);
+
+UCHAR
+EvmcsWrite(_In_ size_t Field, _In_ size_t FieldValue);
+
+//////////////////////////////////////////////////
+//				 Inline Functions				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Read a field of the current VMCS (VMREAD or the enlightened VMCS)
+ * @details the cache of the fields of VMCS is not used
+ *
+ * @param Field The encoding of the field
+ * @param FieldValue The value of the field
+ *
+ * @return UCHAR Same as __vmx_vmread (zero if it's successful)
+ */
+FORCEINLINE UCHAR
+VmxVmreadDirect(size_t Field, size_t * FieldValue)
+{
+    if (g_EnlightenedVmcsIsActive)
+    {
+        return EvmcsRead(Field, FieldValue);
+    }
+
+    return __vmx_vmread(Field, FieldValue);
+}
+
+/**
+ * @brief Write a field of the current VMCS (VMWRITE or the enlightened VMCS)
+ * @details the cache of the fields of VMCS is not used
+ *
+ * @param Field The encoding of the field
+ * @param FieldValue The value of the field
+ *
+ * @return UCHAR Same as __vmx_vmwrite (zero if it's successful)
+ */
+FORCEINLINE UCHAR
+VmxVmwriteDirect(size_t Field, size_t FieldValue)
+{
+    if (g_EnlightenedVmcsIsActive)
+    {
+        return EvmcsWrite(Field, FieldValue);
+    }
+
+    return __vmx_vmwrite(Field, FieldValue);
+}
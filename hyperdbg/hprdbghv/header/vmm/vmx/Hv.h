@@ -123,6 +123,29 @@ HvSetLoadDebugControls(BOOLEAN Set);
 VOID
 HvSetSaveDebugControls(BOOLEAN Set);
 
+/**
+ * @brief Set LOAD IA32_RTIT_CTL on Vm-entry controls and CLEAR IA32_RTIT_CTL
+ * on Vm-exit controls
+ *
+ * @param Set Set or unset
+ * @return VOID
+ */
+VOID
+HvSetIntelPtControls(BOOLEAN Set);
+
+/**
+ * @brief Set LOAD IA32_LBR_CTL on Vm-entry controls and CLEAR IA32_LBR_CTL
+ * on Vm-exit controls
+ *
+ * @param Set Set or unset
+ * @return VOID
+ */
+VOID
+HvSetArchLbrControls(BOOLEAN Set);
+
+VOID
+HvSetPerfGlobalCtrlControls(BOOLEAN Set);
+
 /**
  * @brief Reset GDTR/IDTR and other old when you do vmxoff as the patchguard
  * will detect them left modified
@@ -141,6 +164,16 @@ HvRestoreRegisters();
 VOID
 HvSetPmcVmexit(BOOLEAN Set);
 
+/**
+ * @brief Set or unset the TSC offsetting
+ *
+ * @param Set
+ * @param TscOffset
+ * @return VOID
+ */
+VOID
+HvSetTscOffsetting(BOOLEAN Set, INT64 TscOffset);
+
 /**
  * @brief Set vm-exit for mov-to-cr0/4
  *
@@ -404,6 +437,15 @@ HvDisableExternalInterruptsAndInterruptWindow(VIRTUAL_MACHINE_STATE * VCpu);
 BOOLEAN
 HvInitVmm(VMM_CALLBACKS * VmmCallbacks);
 
+/**
+ * @brief Get the elapsed time since a value of the performance counter
+ * @param StartCounter
+ *
+ * @return UINT64 The elapsed time in microseconds
+ */
+UINT64
+HvGetElapsedMicroseconds(UINT64 StartCounter);
+
 /**
  * @brief Enables MTF and adjust external interrupt state
  *
@@ -33,6 +33,9 @@ IdtEmulationHandleNmiWindowExiting(_Inout_ VIRTUAL_MACHINE_STATE * VCpu);
 VOID
 IdtEmulationHandleInterruptWindowExiting(_Inout_ VIRTUAL_MACHINE_STATE * VCpu);
 
+BOOLEAN
+IdtEmulationIsAnyExternalInterruptPending(_In_ VIRTUAL_MACHINE_STATE * VCpu);
+
 BOOLEAN
 IdtEmulationHandlePageFaults(_Inout_ VIRTUAL_MACHINE_STATE *   VCpu,
                              _In_ VMEXIT_INTERRUPT_INFORMATION InterruptExit,
@@ -170,6 +170,12 @@ IoOutDwordString(UINT16 port, UINT32 * data, UINT32 count)
 VOID
 IoHandleIoVmExits(VIRTUAL_MACHINE_STATE * VCpu, VMX_EXIT_QUALIFICATION_IO_INSTRUCTION IoQualification, RFLAGS Flags);
 
+BOOLEAN
+IoHandleSetIoBitmap(VIRTUAL_MACHINE_STATE * VCpu, UINT64 Port);
+
+BOOLEAN
+IoHandleUnsetIoBitmap(VIRTUAL_MACHINE_STATE * VCpu, UINT64 Port);
+
 VOID
 IoHandlePerformIoBitmapChange(VIRTUAL_MACHINE_STATE * VCpu, UINT64 Port);
 
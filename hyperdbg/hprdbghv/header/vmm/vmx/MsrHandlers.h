@@ -11,6 +11,30 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//				    Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Index of the first bit of the MSRs from 0xC0000000 in each half
+ * (read or write) of MSR Bitmap
+ *
+ */
+#define MSR_BITMAP_HIGH_MSRS_BASE_INDEX (1024 * 8)
+
+/**
+ * @brief Index of the first bit of the write half of MSR Bitmap (also
+ * it's the count of the bits of each half)
+ *
+ */
+#define MSR_BITMAP_WRITE_BASE_INDEX (2048 * 8)
+
+/**
+ * @brief Count of the bits of MSR Bitmap (read and write)
+ *
+ */
+#define MSR_BITMAP_BITS_COUNT (MSR_BITMAP_WRITE_BASE_INDEX * 2)
+
 //////////////////////////////////////////////////
 //				    Functions					//
 //////////////////////////////////////////////////
@@ -38,3 +62,9 @@ MsrHandlePerformMsrBitmapWriteChange(VIRTUAL_MACHINE_STATE * VCpu, UINT64 MsrMas
 
 VOID
 MsrHandlePerformMsrBitmapWriteReset(VIRTUAL_MACHINE_STATE * VCpu);
+
+VOID
+MsrHandlePerformMsrBitmapReadUnset(VIRTUAL_MACHINE_STATE * VCpu, UINT64 MsrMask);
+
+VOID
+MsrHandlePerformMsrBitmapWriteUnset(VIRTUAL_MACHINE_STATE * VCpu, UINT64 MsrMask);
@@ -68,6 +68,9 @@ ProtectedHvDisableMovDebugRegsExitingForDisablingDrCommands(VIRTUAL_MACHINE_STAT
 // Mov to Control Regs Exiting Functions
 //
 
+VOID
+ProtectedHvSetMovControlRegsExiting(VIRTUAL_MACHINE_STATE * VCpu, BOOLEAN Set, UINT64 ControlRegister, UINT64 MaskRegister);
+
 VOID
 ProtectedHvDisableMovControlRegsExitingForDisablingCrCommands(VIRTUAL_MACHINE_STATE * VCpu, UINT64 ControlRegister, UINT64 MaskRegister);
 
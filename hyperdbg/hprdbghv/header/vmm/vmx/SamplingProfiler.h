@@ -0,0 +1,62 @@
+/**
+ * @file SamplingProfiler.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The headers for the sampling profiler of the guest
+ * @details
+ * @version 0.4
+ * @date 2023-08-01
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				    Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Count of the samples of the buffer of each core (power of two)
+ *
+ */
+#define SAMPLING_PROFILER_BUFFER_CAPACITY 1024
+
+/**
+ * @brief Count of the (pointer-sized) slots of the guest's stack that
+ * are scanned for the return addresses of each sample
+ *
+ */
+#define SAMPLING_PROFILER_SCANNED_STACK_SLOTS 32
+
+//////////////////////////////////////////////////
+//				    Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The ring buffer of the samples of a single core
+ * @details the samples are only written by the core itself (in vmx-root)
+ * and read from vmx non-root, the structures are aligned to the cache
+ * line so the cores don't share cache lines
+ *
+ */
+typedef struct DECLSPEC_CACHEALIGN _SAMPLING_PROFILER_BUFFER
+{
+    volatile LONG64          WriteIndex;
+    volatile LONG64          ReadIndex;
+    volatile LONG64          DroppedSamples;
+    SAMPLING_PROFILER_SAMPLE Samples[SAMPLING_PROFILER_BUFFER_CAPACITY];
+
+} SAMPLING_PROFILER_BUFFER, *PSAMPLING_PROFILER_BUFFER;
+
+//////////////////////////////////////////////////
+//			         Functions  				//
+//////////////////////////////////////////////////
+
+VOID
+SamplingProfilerRecordSample(VIRTUAL_MACHINE_STATE * VCpu);
+
+VOID
+SamplingProfilerPerformAction(PDEBUGGER_SAMPLING_PROFILER_REQUEST ProfilerRequest);
+
+VOID
+SamplingProfilerUninitialize();
@@ -291,6 +291,109 @@
  */
 #define VMCALL_RESTORE_TO_NORMAL_EPTP 0x0000002c
 
+/**
+ * @brief VMCALL to enable mode-based execution control (MBEC) on the current EPTP
+ *
+ */
+#define VMCALL_ENABLE_MODE_BASED_EXECUTION_CONTROL 0x0000002d
+
+/**
+ * @brief VMCALL to disable mode-based execution control (MBEC) on the current EPTP
+ *
+ */
+#define VMCALL_DISABLE_MODE_BASED_EXECUTION_CONTROL 0x0000002e
+
+/**
+ * @brief VMCALL to release a reference of an MSR (or all MSRs) on MSR Bitmap Read
+ *
+ */
+#define VMCALL_UNSET_MSR_BITMAP_READ 0x0000002f
+
+/**
+ * @brief VMCALL to release a reference of an MSR (or all MSRs) on MSR Bitmap Write
+ *
+ */
+#define VMCALL_UNSET_MSR_BITMAP_WRITE 0x00000030
+
+/**
+ * @brief VMCALL to add a reference to a resource of the bitmap ownership
+ *
+ */
+#define VMCALL_ACQUIRE_BITMAP_OWNERSHIP 0x00000031
+
+/**
+ * @brief VMCALL to release a reference of a resource of the bitmap ownership
+ *
+ */
+#define VMCALL_RELEASE_BITMAP_OWNERSHIP 0x00000032
+
+/**
+ * @brief VMCALL to re-apply the requests of the VMX preemption timer
+ * (the pending updates of VMCS controls and the sampling profiler)
+ *
+ */
+#define VMCALL_UPDATE_VMX_PREEMPTION_TIMER 0x00000033
+
+/**
+ * @brief VMCALL to move the entries of the PML buffer of the core to a
+ * bitmap of the dirty pages
+ *
+ */
+#define VMCALL_FLUSH_DIRTY_LOGGING_BUFFER 0x00000034
+
+/**
+ * @brief VMCALL to start, stop, pause or resume the trace of Intel PT
+ * (Processor Trace) of the core
+ *
+ */
+#define VMCALL_CONFIGURE_INTEL_PT 0x00000035
+
+/**
+ * @brief VMCALL to start, stop or drain the memory access sampling of PEBS
+ * of the core
+ *
+ */
+#define VMCALL_CONFIGURE_PEBS_SAMPLING 0x00000036
+
+/**
+ * @brief VMCALL that does nothing (used for measuring the round-trip
+ * of VMCALLs)
+ *
+ */
+#define VMCALL_BENCHMARK 0x00000037
+
+/**
+ * @brief VMCALL to perform multiple VMCALLs in one vm-exit
+ *
+ */
+#define VMCALL_BATCH 0x00000038
+
+/**
+ * @brief Maximum count of the VMCALLs in one VMCALL_BATCH (interrupts
+ * are disabled in vmx-root so the batches are kept short)
+ *
+ */
+#define VMCALL_BATCH_MAXIMUM_ENTRIES 64
+
+//////////////////////////////////////////////////
+//				   Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A VMCALL in the batch of VMCALL_BATCH
+ * @details the array of the entries should be in the nonpaged pool
+ *
+ */
+typedef struct _VMCALL_BATCH_ENTRY
+{
+    UINT64   VmcallNumber;
+    UINT64   OptionalParam1;
+    UINT64   OptionalParam2;
+    UINT64   OptionalParam3;
+    NTSTATUS Status; // The result of the VMCALL (filled by vmx-root)
+
+} VMCALL_BATCH_ENTRY, *PVMCALL_BATCH_ENTRY;
+
 //////////////////////////////////////////////////
 //				    Functions					//
 //////////////////////////////////////////////////
@@ -340,3 +443,16 @@ NTSTATUS
 VmcallTest(_In_ UINT64 Param1,
            _In_ UINT64 Param2,
            _In_ UINT64 Param3);
+
+/**
+ * @brief Perform the VMCALLs of a batch in one vm-exit
+ *
+ * @param VCpu
+ * @param Entries
+ * @param Count
+ * @return NTSTATUS
+ */
+NTSTATUS
+VmcallBatch(_Inout_ VIRTUAL_MACHINE_STATE * VCpu,
+            _Inout_ PVMCALL_BATCH_ENTRY     Entries,
+            _In_ UINT32                     Count);
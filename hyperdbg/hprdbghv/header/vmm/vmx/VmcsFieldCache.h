@@ -0,0 +1,139 @@
+/**
+ * @file VmcsFieldCache.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The headers for the cache of the fields of VMCS
+ * @details the handlers of vm-exits read the same fields (e.g., RIP,
+ * RFLAGS, exit qualification) several times, these fields are read once
+ * in each vm-exit (lazily) and the written fields are flushed once before
+ * the vm-entry, this especially matters once HyperDbg is nested as each
+ * VMREAD and VMWRITE causes a vm-exit to the L0 hypervisor
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+VOID
+VmcsFieldCacheStart(_Inout_ VIRTUAL_MACHINE_STATE * VCpu);
+
+VOID
+VmcsFieldCacheFlush(_Inout_ VIRTUAL_MACHINE_STATE * VCpu);
+
+UCHAR
+VmcsFieldCacheRead(_Inout_ VIRTUAL_MACHINE_STATE * VCpu, _In_ UINT32 Index, _In_ size_t Field, _Out_ size_t * FieldValue);
+
+//////////////////////////////////////////////////
+//				 Inline Functions				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Get the index of a field of VMCS in the cache
+ * @details the field is usually a constant, so the index is resolved
+ * by the compiler
+ *
+ * @param Field The encoding of the field
+ *
+ * @return INT32 The index of the field (VMCS_FIELD_CACHE_*) or -1 if
+ * the field is not cached
+ */
+FORCEINLINE INT32
+VmcsFieldCacheGetIndex(size_t Field)
+{
+    switch (Field)
+    {
+    case VMCS_GUEST_RIP:
+        return VMCS_FIELD_CACHE_GUEST_RIP;
+    case VMCS_GUEST_RSP:
+        return VMCS_FIELD_CACHE_GUEST_RSP;
+    case VMCS_GUEST_RFLAGS:
+        return VMCS_FIELD_CACHE_GUEST_RFLAGS;
+    case VMCS_GUEST_CS_SELECTOR:
+        return VMCS_FIELD_CACHE_GUEST_CS_SELECTOR;
+    case VMCS_GUEST_INTERRUPTIBILITY_STATE:
+        return VMCS_FIELD_CACHE_GUEST_INTERRUPTIBILITY;
+    case VMCS_GUEST_CR3:
+        return VMCS_FIELD_CACHE_GUEST_CR3;
+    case VMCS_EXIT_REASON:
+        return VMCS_FIELD_CACHE_EXIT_REASON;
+    case VMCS_EXIT_QUALIFICATION:
+        return VMCS_FIELD_CACHE_EXIT_QUALIFICATION;
+    case VMCS_VMEXIT_INSTRUCTION_LENGTH:
+        return VMCS_FIELD_CACHE_EXIT_INSTRUCTION_LENGTH;
+    case VMCS_VMEXIT_INTERRUPTION_INFORMATION:
+        return VMCS_FIELD_CACHE_EXIT_INTERRUPTION_INFO;
+    default:
+        return -1;
+    }
+}
+
+/**
+ * @brief Read a field of the current VMCS
+ * @details the cached fields are only read once in each vm-exit
+ *
+ * @param Field The encoding of the field
+ * @param FieldValue The value of the field
+ *
+ * @return UCHAR Same as __vmx_vmread (zero if it's successful)
+ */
+FORCEINLINE UCHAR
+VmxVmread(size_t Field, size_t * FieldValue)
+{
+    INT32                   Index = VmcsFieldCacheGetIndex(Field);
+    VIRTUAL_MACHINE_STATE * VCpu;
+
+    if (Index != -1)
+    {
+        VCpu = &g_GuestState[KeGetCurrentProcessorNumber()];
+
+        if (VCpu->VmcsFieldCache.IsActive)
+        {
+            if (VCpu->VmcsFieldCache.ValidFields & (1 << Index))
+            {
+                *FieldValue = VCpu->VmcsFieldCache.Values[Index];
+                return 0;
+            }
+
+            return VmcsFieldCacheRead(VCpu, Index, Field, FieldValue);
+        }
+    }
+
+    return VmxVmreadDirect(Field, FieldValue);
+}
+
+/**
+ * @brief Write a field of the current VMCS
+ * @details the cached fields are written to VMCS once before the vm-entry
+ *
+ * @param Field The encoding of the field
+ * @param FieldValue The value of the field
+ *
+ * @return UCHAR Same as __vmx_vmwrite (zero if it's successful)
+ */
+FORCEINLINE UCHAR
+VmxVmwrite(size_t Field, size_t FieldValue)
+{
+    INT32                   Index = VmcsFieldCacheGetIndex(Field);
+    VIRTUAL_MACHINE_STATE * VCpu;
+
+    if (Index != -1 && Index < VMCS_FIELD_CACHE_READ_ONLY_FIELDS_BASE)
+    {
+        VCpu = &g_GuestState[KeGetCurrentProcessorNumber()];
+
+        if (VCpu->VmcsFieldCache.IsActive)
+        {
+            VCpu->VmcsFieldCache.Values[Index] = FieldValue;
+            VCpu->VmcsFieldCache.ValidFields |= (1 << Index);
+            VCpu->VmcsFieldCache.DirtyFields |= (1 << Index);
+
+            return 0;
+        }
+    }
+
+    return VmxVmwriteDirect(Field, FieldValue);
+}
@@ -0,0 +1,29 @@
+/**
+ * @file VmcsPendingUpdates.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The headers for the updates of VMCS controls that are applied
+ * on the next vm-exit of each core
+ * @details
+ * @version 0.4
+ * @date 2023-07-31
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				    Functions					//
+//////////////////////////////////////////////////
+
+VOID
+VmcsPendingUpdatesQueue(UINT64 CoreMask, LONG UpdateFlag, BOOLEAN Set, LONG ExceptionMask);
+
+VOID
+VmcsPendingUpdatesApply(VIRTUAL_MACHINE_STATE * VCpu);
+
+VOID
+VmcsPendingUpdatesSetTscOffsetting(UINT64 CoreMask, BOOLEAN Set);
+
+VOID
+VmcsPendingUpdatesInvalidateEpt(UINT64 CoreMask);
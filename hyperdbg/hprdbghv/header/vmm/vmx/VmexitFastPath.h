@@ -0,0 +1,46 @@
+/**
+ * @file VmexitFastPath.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The headers for the fast-path of the hottest vm-exits
+ * @details
+ * @version 0.4
+ * @date 2023-07-29
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum count of the address spaces (cr3s) that their mov-to-cr3
+ * vm-exits are handled by the full path once the filter is applied
+ * @details should be the same as VMEXIT_FAST_PATH_CR3_FILTER_MAXIMUM_ENTRIES
+ * in AsmVmexitHandler
+ *
+ */
+#define VMEXIT_FAST_PATH_CR3_FILTER_MAXIMUM_ENTRIES 8
+
+/**
+ * @brief The bits of the page frame of the cr3 (without the PCID and the
+ * no-flush bit) that are compared with the filter
+ * @details should be the same as CR3_PAGE_FRAME_MASK in AsmVmexitHandler
+ *
+ */
+#define VMEXIT_FAST_PATH_CR3_PAGE_FRAME_MASK 0x000ffffffffff000ull
+
+//////////////////////////////////////////////////
+//			         Functions  				//
+//////////////////////////////////////////////////
+
+VOID
+VmexitFastPathUpdate();
+
+BOOLEAN
+VmexitFastPathSetCr3Filter(BOOLEAN Set, UINT64 Cr3);
+
+VOID
+VmexitFastPathBypassCr3Filter(BOOLEAN Bypass);
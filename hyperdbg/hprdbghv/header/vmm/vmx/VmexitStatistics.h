@@ -0,0 +1,41 @@
+/**
+ * @file VmexitStatistics.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The headers for the statistics of vm-exits
+ * @details
+ * @version 0.4
+ * @date 2023-07-28
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				    Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The statistics of vm-exits of a single core
+ * @details each core only updates its own statistics, the structures
+ * are aligned to the cache line so the cores don't share cache lines
+ *
+ */
+typedef struct DECLSPEC_CACHEALIGN _VMEXIT_STATISTICS
+{
+    VMEXIT_REASON_STATISTICS Reasons[MaximumVmexitStatisticsExitReasons];
+
+} VMEXIT_STATISTICS, *PVMEXIT_STATISTICS;
+
+//////////////////////////////////////////////////
+//			         Functions  				//
+//////////////////////////////////////////////////
+
+VOID
+VmexitStatisticsRecord(VIRTUAL_MACHINE_STATE * VCpu, UINT32 ExitReason, UINT64 Cycles);
+
+VOID
+VmexitStatisticsPerformAction(PDEBUGGER_VMEXIT_STATISTICS_REQUEST StatisticsRequest);
+
+VOID
+VmexitStatisticsUninitialize();
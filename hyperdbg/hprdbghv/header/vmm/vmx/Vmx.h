@@ -89,6 +89,8 @@
 #define VM_EXIT_SAVE_IA32_EFER             0x00100000
 #define VM_EXIT_LOAD_IA32_EFER             0x00200000
 #define VM_EXIT_SAVE_VMX_PREEMPTION_TIMER  0x00400000
+#define VM_EXIT_CLEAR_IA32_RTIT_CTL        0x02000000
+#define VM_EXIT_CLEAR_IA32_LBR_CTL         0x04000000
 
 /**
  * @brief VM-entry Control Bits
@@ -101,6 +103,8 @@
 #define VM_ENTRY_LOAD_IA32_PERF_GLOBAL_CTRL 0x00002000
 #define VM_ENTRY_LOAD_IA32_PAT              0x00004000
 #define VM_ENTRY_LOAD_IA32_EFER             0x00008000
+#define VM_ENTRY_LOAD_IA32_RTIT_CTL         0x00040000
+#define VM_ENTRY_LOAD_IA32_LBR_CTL          0x00200000
 
 /**
  * @brief CPUID RCX(s) - Based on Hyper-V
@@ -82,6 +82,8 @@
 #include "vmm/vmx/HypervTlfs.h"
 #include "common/Msr.h"
 #include "memory/PoolManager.h"
+#include "memory/PhysicalMemoryMap.h"
+#include "memory/ReverseMapping.h"
 #include "common/Trace.h"
 #include "assembly/InlineAsm.h"
 #include "vmm/ept/Vpid.h"
@@ -96,6 +98,11 @@
 #include "devices/Apic.h"
 #include "vmm/vmx/Mtf.h"
 #include "vmm/vmx/Counters.h"
+#include "vmm/vmx/VmexitStatistics.h"
+#include "vmm/vmx/SamplingProfiler.h"
+#include "vmm/vmx/VmexitFastPath.h"
+#include "vmm/vmx/BitmapOwnership.h"
+#include "vmm/vmx/VmcsPendingUpdates.h"
 #include "vmm/vmx/IdtEmulation.h"
 #include "vmm/ept/Invept.h"
 #include "vmm/vmx/Vmcall.h"
@@ -103,11 +110,17 @@
 #include "vmm/vmx/MsrHandlers.h"
 #include "vmm/vmx/ProtectedHv.h"
 #include "vmm/vmx/IoHandler.h"
+#include "vmm/vmx/CpuidHandler.h"
 #include "vmm/vmx/VmxMechanisms.h"
 #include "hooks/Hooks.h"
 #include "hooks/ModeBasedExecHook.h"
 #include "interface/Callback.h"
 #include "features/DirtyLogging.h"
+#include "features/EptSnapshot.h"
+#include "features/IntelPt.h"
+#include "features/Lbr.h"
+#include "features/PebsSampling.h"
+#include "features/InstructionCounter.h"
 #include "features/CompatibilityChecks.h"
 
 //
@@ -125,7 +138,9 @@
 //
 // Headers for supporting the reversing machine (TRM)
 //
+#include "features/reversing/ReversingMachineTargets.h"
 #include "features/reversing/ReversingMachine.h"
+#include "features/reversing/ReversingMachineCoverage.h"
 
 //
 // Headers for exporting functions to remove the driver
@@ -138,6 +153,12 @@
 #include "globals/GlobalVariableManagement.h"
 #include "globals/GlobalVariables.h"
 
+//
+// Accessing the fields of VMCS (uses the global variables)
+//
+#include "vmm/vmx/Evmcs.h"
+#include "vmm/vmx/VmcsFieldCache.h"
+
 //
 // HyperLog Module
 //
@@ -41,6 +41,35 @@ CommonIsProcessExist(UINT32 ProcId)
     }
 }
 
+/**
+ * @brief Checks whether the thread with ThreadId exists or not
+ *
+ * @details this function should NOT be called from vmx-root mode
+ *
+ * @param UINT32 ThreadId
+ * @return BOOLEAN Returns true if the thread
+ * exists and false if it the thread doesn't exist
+ */
+BOOLEAN
+CommonIsThreadExist(UINT32 ThreadId)
+{
+    PETHREAD TargetEthread;
+
+    if (PsLookupThreadByThreadId(ThreadId, &TargetEthread) != STATUS_SUCCESS)
+    {
+        //
+        // There was an error, probably the thread id was not found
+        //
+        return FALSE;
+    }
+    else
+    {
+        ObDereferenceObject(TargetEthread);
+
+        return TRUE;
+    }
+}
+
 /**
  * @brief Get handle from Process Id
  * @param Handle
@@ -278,3 +278,40 @@ DpcRoutineVmExitAndHaltSystemAllCores(KDPC * Dpc, PVOID DeferredContext, PVOID S
     //
     KeSignalCallDpcDone(SystemArgument1);
 }
+
+/**
+ * @brief Broadcast measuring the skew of the time-stamp counters
+ *
+ * @param Dpc
+ * @param DeferredContext
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutineMeasureTscOffsetsAllCores(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(DeferredContext);
+
+    //
+    // Wait for all DPCs to reach this point, so all of the cores are
+    // available to respond to the first core
+    //
+    KeSignalCallDpcSynchronize(SystemArgument2);
+
+    //
+    // Measure (or respond) on current core
+    //
+    TscSynchronizationPerformOnCore(KeGetCurrentProcessorNumber());
+
+    //
+    // Wait for all DPCs to synchronize at this point
+    //
+    KeSignalCallDpcSynchronize(SystemArgument2);
+
+    //
+    // Mark the DPC as being complete
+    //
+    KeSignalCallDpcDone(SystemArgument1);
+}
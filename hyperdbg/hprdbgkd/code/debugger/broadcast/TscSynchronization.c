@@ -0,0 +1,155 @@
+/**
+ * @file TscSynchronization.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Measuring the skew of the time-stamp counters of cores
+ * @details the messages and the records of events are stamped by the
+ * time-stamp counter of the core that produces them, the skew of each core
+ * (from the first core) is measured once and removed from the stamps by
+ * the producers, so the streams of all cores are ordered by a single
+ * timeline without any lock between the cores
+ *
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief The state of the measurement (only used while measuring)
+ *
+ */
+static TSC_SYNCHRONIZATION_STATE g_TscSynchronizationState;
+
+/**
+ * @brief Measure the skew of the time-stamp counters of all cores
+ * @details should be called from vmx non-root (PASSIVE_LEVEL)
+ *
+ * @return VOID
+ */
+VOID
+TscSynchronizationMeasureOffsets()
+{
+    if (KeQueryActiveProcessorCount(0) == 1)
+    {
+        return;
+    }
+
+    RtlZeroMemory(&g_TscSynchronizationState, sizeof(TSC_SYNCHRONIZATION_STATE));
+
+    g_TscSynchronizationState.TargetCore = -1;
+
+    //
+    // All of the cores run the measurement at the same time
+    //
+    KeGenericCallDpc(DpcRoutineMeasureTscOffsetsAllCores, NULL);
+
+    LogDebugInfo("The maximum skew of the time-stamp counters of the cores is %llx ticks",
+                 g_TscSynchronizationState.MaximumSkew);
+}
+
+/**
+ * @brief Measure the skew of a core by the round-trips of the first core
+ *
+ * @param TargetCore The core to measure
+ *
+ * @return INT64 The time-stamp counter of the core minus the one of the first core
+ */
+static INT64
+TscSynchronizationMeasureCore(UINT32 TargetCore)
+{
+    PTSC_SYNCHRONIZATION_STATE State         = &g_TscSynchronizationState;
+    UINT64                     BestRoundTrip = MAXUINT64;
+    INT64                      Offset        = 0;
+    UINT64                     Start;
+    UINT64                     End;
+    LONG                       Sequence;
+
+    InterlockedExchange(&State->TargetCore, TargetCore);
+
+    for (UINT32 i = 0; i < TSC_SYNCHRONIZATION_ROUNDS; i++)
+    {
+        Sequence = State->Request + 1;
+
+        Start = __rdtsc();
+
+        InterlockedExchange(&State->Request, Sequence);
+
+        while (State->Response != Sequence)
+        {
+            _mm_pause();
+        }
+
+        End = __rdtsc();
+
+        //
+        // The target core is assumed to respond in the middle of the round-trip,
+        // so the shortest round-trip has the least error
+        //
+        if (End - Start < BestRoundTrip)
+        {
+            BestRoundTrip = End - Start;
+            Offset        = State->TargetTsc - (INT64)(Start + (End - Start) / 2);
+        }
+    }
+
+    return Offset;
+}
+
+/**
+ * @brief Perform the measurement on the current core
+ * @details the first core measures the other cores and the other cores
+ * respond to its requests until all of the cores are measured
+ *
+ * @param CoreId The current core
+ *
+ * @return VOID
+ */
+VOID
+TscSynchronizationPerformOnCore(UINT32 CoreId)
+{
+    PTSC_SYNCHRONIZATION_STATE State = &g_TscSynchronizationState;
+    ULONG                      CoreCount;
+    INT64                      Offset;
+    LONG                       Sequence;
+
+    if (CoreId == 0)
+    {
+        CoreCount = KeQueryActiveProcessorCount(0);
+
+        for (UINT32 i = 1; i < CoreCount; i++)
+        {
+            Offset = TscSynchronizationMeasureCore(i);
+
+            LogSetTscOffset(i, Offset);
+
+            if (Offset > State->MaximumSkew || -Offset > State->MaximumSkew)
+            {
+                State->MaximumSkew = Offset < 0 ? -Offset : Offset;
+            }
+        }
+
+        InterlockedExchange(&State->IsFinished, TRUE);
+
+        return;
+    }
+
+    while (!State->IsFinished)
+    {
+        //
+        // The request is read before the target core, so a new request is
+        // never answered by the previous target core
+        //
+        Sequence = State->Request;
+
+        if (State->TargetCore == (LONG)CoreId && State->Response != Sequence)
+        {
+            State->TargetTsc = __rdtsc();
+
+            InterlockedExchange(&State->Response, Sequence);
+        }
+
+        _mm_pause();
+    }
+}
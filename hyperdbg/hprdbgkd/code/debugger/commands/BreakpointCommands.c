@@ -129,6 +129,80 @@ BreakpointCheckAndHandleReApplyingBreakpoint(UINT32 CoreId)
     return Result;
 }
 
+/**
+ * @brief Evaluate the condition of a conditional breakpoint
+ * @details the condition is evaluated in vmx-root, before halting the
+ * debuggee
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param BreakpointDescriptor
+ * @param GuestRip
+ *
+ * @return BOOLEAN whether the debuggee should be halted or not
+ */
+BOOLEAN
+BreakpointEvaluateCondition(PROCESSOR_DEBUGGING_STATE * DbgState,
+                            PDEBUGGEE_BP_DESCRIPTOR     BreakpointDescriptor,
+                            UINT64                      GuestRip)
+{
+    SYMBOL_BUFFER                CodeBuffer    = {0};
+    ACTION_BUFFER                ActionBuffer  = {0};
+    SYMBOL                       ErrorSymbol   = {0};
+    SCRIPT_ENGINE_VARIABLES_LIST VariablesList = {0};
+    UINT64                       Result        = NULL;
+
+    //
+    // Breakpoints without condition always halt the debuggee
+    //
+    if (BreakpointDescriptor->ConditionBufferSize == 0)
+    {
+        return TRUE;
+    }
+
+    //
+    // Fill the action buffer (the tag is the breakpoint id)
+    //
+    ActionBuffer.Context                   = GuestRip;
+    ActionBuffer.ImmediatelySendTheResults = TRUE;
+    ActionBuffer.CurrentAction             = NULL;
+    ActionBuffer.Tag                       = BreakpointDescriptor->BreakpointId;
+
+    CodeBuffer.Head    = (PSYMBOL)BreakpointDescriptor->ConditionBuffer;
+    CodeBuffer.Size    = BreakpointDescriptor->ConditionBufferSize;
+    CodeBuffer.Pointer = BreakpointDescriptor->ConditionBufferPointer;
+
+    //
+    // Fill the variables list for this run
+    //
+    VariablesList.GlobalVariablesList = g_ScriptGlobalVariables;
+    VariablesList.LocalVariablesList  = DbgState->ScriptEngineCoreSpecificLocalVariable;
+    VariablesList.TempList            = DbgState->ScriptEngineCoreSpecificTempVariable;
+
+    //
+    // Buffers of the scratch memory are only valid in a single script
+    //
+    DbgState->ScriptEngineScratchUsed = 0;
+
+    if (ScriptEngineEvalExpression(DbgState->Regs,
+                                   &ActionBuffer,
+                                   &VariablesList,
+                                   &CodeBuffer,
+                                   &Result,
+                                   &ErrorSymbol) == TRUE)
+    {
+        CHAR NameOfOperator[MAX_FUNCTION_NAME_LENGTH] = {0};
+        ScriptEngineGetOperatorName(&ErrorSymbol, NameOfOperator);
+        LogInfo("Invalid returning address for operator: %s", NameOfOperator);
+
+        //
+        // The debuggee is halted if the condition cannot be evaluated
+        //
+        return TRUE;
+    }
+
+    return Result != NULL;
+}
+
 /**
  * @brief Check if the breakpoint vm-exit relates to 'bp' command or not
  *
@@ -148,6 +222,7 @@ BreakpointCheckAndHandleDebuggerDefinedBreakpoints(PROCESSOR_DEBUGGING_STATE * D
     CR3_TYPE                         GuestCr3;
     BOOLEAN                          IsHandledByBpRoutines = FALSE;
     PLIST_ENTRY                      TempList              = 0;
+    PLIST_ENTRY                      BucketHead            = NULL;
     UINT64                           GuestRipPhysical      = NULL;
     DEBUGGER_TRIGGERED_EVENT_DETAILS ContextAndTag         = {0};
     RFLAGS                           Rflags                = {0};
@@ -170,14 +245,15 @@ BreakpointCheckAndHandleDebuggerDefinedBreakpoints(PROCESSOR_DEBUGGING_STATE * D
     GuestRipPhysical = VirtualAddressToPhysicalAddressByProcessCr3(GuestRip, GuestCr3);
 
     //
-    // Iterate through the list of breakpoints
+    // Iterate through the bucket of the physical address in the index of breakpoints
     //
-    TempList = &g_BreakpointsListHead;
+    BucketHead = &g_BreakpointsIndex[BREAKPOINT_INDEX_GET_BUCKET(GuestRipPhysical)];
+    TempList   = BucketHead;
 
-    while (&g_BreakpointsListHead != TempList->Flink)
+    while (BucketHead != TempList->Flink)
     {
         TempList                                      = TempList->Flink;
-        PDEBUGGEE_BP_DESCRIPTOR CurrentBreakpointDesc = CONTAINING_RECORD(TempList, DEBUGGEE_BP_DESCRIPTOR, BreakpointsList);
+        PDEBUGGEE_BP_DESCRIPTOR CurrentBreakpointDesc = CONTAINING_RECORD(TempList, DEBUGGEE_BP_DESCRIPTOR, BreakpointsIndexList);
 
         if (CurrentBreakpointDesc->PhysAddress == GuestRipPhysical)
         {
@@ -186,6 +262,11 @@ BreakpointCheckAndHandleDebuggerDefinedBreakpoints(PROCESSOR_DEBUGGING_STATE * D
             //
             IsHandledByBpRoutines = TRUE;
 
+            //
+            // Count the hits (regardless of the constraints of the breakpoint)
+            //
+            InterlockedIncrement64(&CurrentBreakpointDesc->HitCount);
+
             //
             // First, we remove the breakpoint
             //
@@ -216,7 +297,8 @@ BreakpointCheckAndHandleDebuggerDefinedBreakpoints(PROCESSOR_DEBUGGING_STATE * D
             //
             if ((CurrentBreakpointDesc->Pid == DEBUGGEE_BP_APPLY_TO_ALL_PROCESSES || CurrentBreakpointDesc->Pid == PsGetCurrentProcessId()) &&
                 (CurrentBreakpointDesc->Tid == DEBUGGEE_BP_APPLY_TO_ALL_THREADS || CurrentBreakpointDesc->Tid == PsGetCurrentThreadId()) &&
-                (CurrentBreakpointDesc->Core == DEBUGGEE_BP_APPLY_TO_ALL_CORES || CurrentBreakpointDesc->Core == DbgState->CoreId))
+                (CurrentBreakpointDesc->Core == DEBUGGEE_BP_APPLY_TO_ALL_CORES || CurrentBreakpointDesc->Core == DbgState->CoreId) &&
+                BreakpointEvaluateCondition(DbgState, CurrentBreakpointDesc, ContextAndTag.Context))
             {
                 //
                 // *** It's not safe to access CurrentBreakpointDesc anymore as the
@@ -445,6 +527,30 @@ BreakpointClear(PDEBUGGEE_BP_DESCRIPTOR BreakpointDescriptor)
     return TRUE;
 }
 
+/**
+ * @brief Initialize the list and the index of breakpoints
+ *
+ * @return VOID
+ */
+VOID
+BreakpointInitialize()
+{
+    //
+    // Initialize list of breakpoints and breakpoint id
+    //
+    g_MaximumBreakpointId = 0;
+
+    InitializeListHead(&g_BreakpointsListHead);
+
+    //
+    // Initialize the buckets of the index of breakpoints
+    //
+    for (UINT32 i = 0; i < BREAKPOINT_INDEX_BUCKETS_COUNT; i++)
+    {
+        InitializeListHead(&g_BreakpointsIndex[i]);
+    }
+}
+
 /**
  * @brief Remove all the breakpoints if possible
  *
@@ -471,9 +577,10 @@ BreakpointRemoveAllBreakpoints()
         BreakpointClear(CurrentBreakpointDesc);
 
         //
-        // Remove breakpoint from the list of breakpoints
+        // Remove breakpoint from the list and the index of breakpoints
         //
         RemoveEntryList(&CurrentBreakpointDesc->BreakpointsList);
+        RemoveEntryList(&CurrentBreakpointDesc->BreakpointsIndexList);
 
         //
         // Uninitialize the breakpoint descriptor (safely)
@@ -544,6 +651,36 @@ BreakpointGetEntryByAddress(UINT64 Address)
     return NULL;
 }
 
+/**
+ * @brief Find entry of breakpoint descriptor from the index
+ * of breakpoints by physical address
+ * @param PhysAddress
+ *
+ * @return PDEBUGGEE_BP_DESCRIPTOR
+ */
+PDEBUGGEE_BP_DESCRIPTOR
+BreakpointGetEntryByPhysicalAddress(UINT64 PhysAddress)
+{
+    PLIST_ENTRY BucketHead = &g_BreakpointsIndex[BREAKPOINT_INDEX_GET_BUCKET(PhysAddress)];
+    PLIST_ENTRY TempList   = BucketHead;
+
+    while (BucketHead != TempList->Flink)
+    {
+        TempList                                      = TempList->Flink;
+        PDEBUGGEE_BP_DESCRIPTOR CurrentBreakpointDesc = CONTAINING_RECORD(TempList, DEBUGGEE_BP_DESCRIPTOR, BreakpointsIndexList);
+
+        if (CurrentBreakpointDesc->PhysAddress == PhysAddress)
+        {
+            return CurrentBreakpointDesc;
+        }
+    }
+
+    //
+    // We didn't find anything, so return null
+    //
+    return NULL;
+}
+
 /**
  * @brief Add new breakpoints
  * @param BpDescriptor
@@ -556,6 +693,7 @@ BreakpointAddNew(PDEBUGGEE_BP_PACKET BpDescriptorArg)
     PDEBUGGEE_BP_DESCRIPTOR BreakpointDescriptor = NULL;
     UINT32                  ProcessorCount;
     CR3_TYPE                GuestCr3;
+    UINT64                  PhysAddress;
     BOOLEAN                 IsAddress32Bit = FALSE;
 
     //
@@ -591,6 +729,16 @@ BreakpointAddNew(PDEBUGGEE_BP_PACKET BpDescriptorArg)
         return FALSE;
     }
 
+    //
+    // Check if the condition fits in the descriptor
+    //
+    if (BpDescriptorArg->ConditionBufferSize > MAXIMUM_BREAKPOINT_CONDITION_BUFFER_SIZE ||
+        BpDescriptorArg->ConditionBufferPointer * sizeof(SYMBOL) > BpDescriptorArg->ConditionBufferSize)
+    {
+        BpDescriptorArg->Result = DEBUGGER_ERROR_BREAKPOINT_INVALID_CONDITION;
+        return FALSE;
+    }
+
     //
     // Check if breakpoint already exists on list or not
     //
@@ -603,6 +751,18 @@ BreakpointAddNew(PDEBUGGEE_BP_PACKET BpDescriptorArg)
         return FALSE;
     }
 
+    //
+    // Also, the same physical page might be mapped in other addresses (e.g., shared
+    // modules), and its previous byte is already replaced with 0xcc
+    //
+    PhysAddress = VirtualAddressToPhysicalAddressByProcessCr3(BpDescriptorArg->Address, GuestCr3);
+
+    if (BreakpointGetEntryByPhysicalAddress(PhysAddress) != NULL)
+    {
+        BpDescriptorArg->Result = DEBUGGER_ERROR_BREAKPOINT_ALREADY_EXISTS_ON_THE_ADDRESS;
+        return FALSE;
+    }
+
     //
     // We won't check for process id and thread id, if these arguments are invalid
     // then the HyperDbg simply ignores the breakpoints but it makes the computer slow
@@ -635,11 +795,25 @@ BreakpointAddNew(PDEBUGGEE_BP_PACKET BpDescriptorArg)
     g_MaximumBreakpointId++;
     BreakpointDescriptor->BreakpointId = g_MaximumBreakpointId;
     BreakpointDescriptor->Address      = BpDescriptorArg->Address;
-    BreakpointDescriptor->PhysAddress  = VirtualAddressToPhysicalAddressByProcessCr3(BpDescriptorArg->Address,
-                                                                                    GuestCr3);
+    BreakpointDescriptor->PhysAddress  = PhysAddress;
     BreakpointDescriptor->Core         = BpDescriptorArg->Core;
     BreakpointDescriptor->Pid          = BpDescriptorArg->Pid;
     BreakpointDescriptor->Tid          = BpDescriptorArg->Tid;
+    BreakpointDescriptor->HitCount     = 0;
+
+    //
+    // Copy the condition of the breakpoint (if any), it's located at the
+    // bottom of the packet
+    //
+    BreakpointDescriptor->ConditionBufferSize    = BpDescriptorArg->ConditionBufferSize;
+    BreakpointDescriptor->ConditionBufferPointer = BpDescriptorArg->ConditionBufferPointer;
+
+    if (BpDescriptorArg->ConditionBufferSize != 0)
+    {
+        RtlCopyMemory(BreakpointDescriptor->ConditionBuffer,
+                      (CHAR *)BpDescriptorArg + sizeof(DEBUGGEE_BP_PACKET),
+                      BpDescriptorArg->ConditionBufferSize);
+    }
 
     //
     // Check whether address is 32-bit or 64-bit
@@ -675,6 +849,12 @@ BreakpointAddNew(PDEBUGGEE_BP_PACKET BpDescriptorArg)
     //
     InsertHeadList(&g_BreakpointsListHead, &(BreakpointDescriptor->BreakpointsList));
 
+    //
+    // Also, add it to the bucket of its physical address in the index of breakpoints
+    //
+    InsertHeadList(&g_BreakpointsIndex[BREAKPOINT_INDEX_GET_BUCKET(PhysAddress)],
+                   &(BreakpointDescriptor->BreakpointsIndexList));
+
     //
     // Apply the breakpoint
     //
@@ -708,13 +888,17 @@ BreakpointListAllBreakpoint()
 
         if (IsListEmpty)
         {
-            Log("Id   Address           Status\n");
-            Log("--   ---------------   --------");
+            Log("Id   Address           Status     Hits\n");
+            Log("--   ---------------   --------   ----");
 
             IsListEmpty = FALSE;
         }
 
-        Log("\n%02x   %016llx  %s", CurrentBreakpointDesc->BreakpointId, CurrentBreakpointDesc->Address, CurrentBreakpointDesc->Enabled ? "enabled" : "disabled");
+        Log("\n%02x   %016llx  %-8s   %llx",
+            CurrentBreakpointDesc->BreakpointId,
+            CurrentBreakpointDesc->Address,
+            CurrentBreakpointDesc->Enabled ? "enabled" : "disabled",
+            CurrentBreakpointDesc->HitCount);
 
         if (CurrentBreakpointDesc->Core != DEBUGGEE_BP_APPLY_TO_ALL_CORES)
         {
@@ -728,6 +912,10 @@ BreakpointListAllBreakpoint()
         {
             Log(" tid = %x ", CurrentBreakpointDesc->Tid);
         }
+        if (CurrentBreakpointDesc->ConditionBufferSize != 0)
+        {
+            Log(" conditional ");
+        }
     }
 
     //
@@ -827,9 +1015,10 @@ BreakpointListOrModify(PDEBUGGEE_BP_LIST_OR_MODIFY_PACKET ListOrModifyBreakpoint
         BreakpointClear(BreakpointDescriptor);
 
         //
-        // Remove breakpoint from the list of breakpoints
+        // Remove breakpoint from the list and the index of breakpoints
         //
         RemoveEntryList(&BreakpointDescriptor->BreakpointsList);
+        RemoveEntryList(&BreakpointDescriptor->BreakpointsIndexList);
 
         //
         // Uninitialize the breakpoint descriptor (safely)
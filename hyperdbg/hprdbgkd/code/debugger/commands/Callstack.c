@@ -123,3 +123,743 @@ CallstackWalkthroughStack(PDEBUGGER_SINGLE_CALLSTACK_FRAME AddressToSaveFrames,
     //
     return TRUE;
 }
+
+/**
+ * @brief Check whether the instruction bytes before an address end with
+ * a call instruction
+ * @details only the common forms of call in 64-bit code are checked (E8
+ * and FF /2), it's a quick filter and not a complete decoder
+ *
+ * @param InstructionBytes The bytes of MAXIMUM_CALL_INSTR_SIZE bytes
+ * before the address
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CallstackIsCallBeforeReturnAddress(BYTE * InstructionBytes)
+{
+    BYTE * ReturnAddress = InstructionBytes + MAXIMUM_CALL_INSTR_SIZE;
+
+    //
+    // E8 cd - CALL rel32 (5-byte)
+    //
+    if (ReturnAddress[-5] == 0xE8)
+    {
+        return TRUE;
+    }
+
+    //
+    // FF /2 - CALL r/m (2, 3, 4, 6, or 7-byte), the reg field of the
+    // ModR/M is 2
+    //
+    for (UINT32 Length = 2; Length <= MAXIMUM_CALL_INSTR_SIZE; Length++)
+    {
+        if (Length != 5 && ReturnAddress[-(INT32)Length] == 0xFF &&
+            ((ReturnAddress[-(INT32)Length + 1] >> 3) & 0x7) == 2)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Capture the return addresses of the stack
+ * @details the stack is scanned (from the stack pointer) for the values
+ * that point to an executable page right after a call instruction, the
+ * addresses are not resolved to symbols here
+ *
+ * @param StackBaseAddress The stack pointer
+ * @param Size Size of the stack that is scanned
+ * @param AddressesToSaveFrames
+ * @param MaximumFrames Maximum count of the return addresses
+ *
+ * @return UINT32 Count of the captured return addresses
+ */
+UINT32
+CallstackCaptureReturnAddresses(UINT64   StackBaseAddress,
+                                UINT32   Size,
+                                UINT64 * AddressesToSaveFrames,
+                                UINT32   MaximumFrames)
+{
+    UINT64 Values[DebuggerScriptEngineBulkMemoryChunkSize / sizeof(UINT64)];
+    BYTE   InstructionBytes[MAXIMUM_CALL_INSTR_SIZE];
+    UINT64 CurrentStackAddress = StackBaseAddress & ~(sizeof(UINT64) - 1);
+    UINT64 EndOfStack          = StackBaseAddress + Size;
+    UINT32 FramesCount         = 0;
+    UINT32 ChunkSize;
+
+    while (CurrentStackAddress < EndOfStack && FramesCount < MaximumFrames)
+    {
+        //
+        // Each chunk is read at once and it doesn't cross the page boundary
+        //
+        ChunkSize = (UINT32)min(EndOfStack - CurrentStackAddress, sizeof(Values));
+        ChunkSize = (UINT32)min(ChunkSize, PAGE_SIZE - (CurrentStackAddress & (PAGE_SIZE - 1)));
+        ChunkSize &= ~(sizeof(UINT64) - 1);
+
+        if (ChunkSize == 0 || !CheckAccessValidityAndSafety(CurrentStackAddress, ChunkSize))
+        {
+            //
+            // Stack is no longer valid or available to access from here
+            //
+            break;
+        }
+
+        MemoryMapperReadMemorySafeOnTargetProcess(CurrentStackAddress, Values, ChunkSize);
+
+        for (UINT32 i = 0; i < ChunkSize / sizeof(UINT64) && FramesCount < MaximumFrames; i++)
+        {
+            if (Values[i] < MAXIMUM_CALL_INSTR_SIZE ||
+                !CheckAccessValidityAndSafety(Values[i] - MAXIMUM_CALL_INSTR_SIZE, MAXIMUM_CALL_INSTR_SIZE) ||
+                !MemoryMapperCheckIfPageIsNxBitSetOnTargetProcess((PVOID)Values[i]))
+            {
+                continue;
+            }
+
+            MemoryMapperReadMemorySafeOnTargetProcess(Values[i] - MAXIMUM_CALL_INSTR_SIZE,
+                                                      InstructionBytes,
+                                                      MAXIMUM_CALL_INSTR_SIZE);
+
+            if (CallstackIsCallBeforeReturnAddress(InstructionBytes))
+            {
+                AddressesToSaveFrames[FramesCount] = Values[i];
+                FramesCount++;
+            }
+        }
+
+        CurrentStackAddress += ChunkSize;
+    }
+
+    return FramesCount;
+}
+
+/**
+ * @brief Read the memory of the target process if it's accessible
+ *
+ * @param Address
+ * @param Buffer
+ * @param Size
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CallstackReadMemory(UINT64 Address, PVOID Buffer, UINT32 Size)
+{
+    if (!CheckAccessValidityAndSafety(Address, Size))
+    {
+        return FALSE;
+    }
+
+    return MemoryMapperReadMemorySafeOnTargetProcess(Address, Buffer, Size);
+}
+
+/**
+ * @brief Read the PE headers of an image to cache its table of functions
+ *
+ * @param ImageBase The address that might be the base of an image
+ * @param Address The address that should be in the image
+ * @param Module The entry of the module
+ *
+ * @return BOOLEAN Whether the image is a 64-bit image that contains the
+ * address or not
+ */
+static BOOLEAN
+CallstackReadModuleHeaders(UINT64 ImageBase, UINT64 Address, PCALLSTACK_MODULE_ENTRY Module)
+{
+    BYTE   NtHeaders[CALLSTACK_IMAGE_NT_HEADERS_SIZE];
+    UINT16 DosSignature;
+    UINT32 NtHeadersOffset;
+    UINT32 ExceptionDirectorySize;
+
+    if (!CallstackReadMemory(ImageBase, &DosSignature, sizeof(UINT16)) ||
+        DosSignature != CALLSTACK_IMAGE_DOS_SIGNATURE ||
+        !CallstackReadMemory(ImageBase + CALLSTACK_IMAGE_DOS_LFANEW_OFFSET, &NtHeadersOffset, sizeof(UINT32)) ||
+        NtHeadersOffset > PAGE_SIZE - sizeof(NtHeaders) ||
+        !CallstackReadMemory(ImageBase + NtHeadersOffset, NtHeaders, sizeof(NtHeaders)))
+    {
+        return FALSE;
+    }
+
+    if (*(UINT32 *)NtHeaders != CALLSTACK_IMAGE_NT_SIGNATURE ||
+        *(UINT16 *)&NtHeaders[CALLSTACK_IMAGE_NT_MACHINE_OFFSET] != CALLSTACK_IMAGE_FILE_MACHINE_AMD64 ||
+        *(UINT16 *)&NtHeaders[CALLSTACK_IMAGE_NT_MAGIC_OFFSET] != CALLSTACK_IMAGE_NT_OPTIONAL_HDR64 ||
+        *(UINT32 *)&NtHeaders[CALLSTACK_IMAGE_NT_NUMBER_OF_RVA_AND_SIZES_OFFSET] <= CALLSTACK_IMAGE_DIRECTORY_EXCEPTION)
+    {
+        return FALSE;
+    }
+
+    Module->ImageBase        = ImageBase;
+    Module->SizeOfImage      = *(UINT32 *)&NtHeaders[CALLSTACK_IMAGE_NT_SIZE_OF_IMAGE_OFFSET];
+    Module->FunctionTableRva = *(UINT32 *)&NtHeaders[CALLSTACK_IMAGE_NT_EXCEPTION_DIRECTORY_OFFSET];
+    ExceptionDirectorySize   = *(UINT32 *)&NtHeaders[CALLSTACK_IMAGE_NT_EXCEPTION_DIRECTORY_OFFSET + sizeof(UINT32)];
+    Module->CountOfFunctions = ExceptionDirectorySize / sizeof(CALLSTACK_RUNTIME_FUNCTION);
+
+    return Address - ImageBase < Module->SizeOfImage &&
+           (UINT64)Module->FunctionTableRva + ExceptionDirectorySize <= Module->SizeOfImage;
+}
+
+/**
+ * @brief Find the module of an address
+ * @details the modules are cached on each core, for the modules that are
+ * not cached, the image base is found by scanning the pages before the
+ * address for the PE headers (once for each module)
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param Address
+ *
+ * @return PCALLSTACK_MODULE_ENTRY The module or NULL if the address is not
+ * in a 64-bit image
+ */
+static PCALLSTACK_MODULE_ENTRY
+CallstackFindModule(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 Address)
+{
+    PCALLSTACK_MODULES_CACHE Cache = &DbgState->CallstackModulesCache;
+    PCALLSTACK_MODULE_ENTRY  Module;
+    UINT64                   Cr3 = NULL;
+    UINT64                   ImageBase;
+    UINT16                   DosSignature;
+
+    //
+    // The user-mode modules are only valid in the memory layout of their
+    // process
+    //
+    if (Address < 0xffff800000000000)
+    {
+        Cr3 = LayoutGetCurrentProcessCr3().Flags;
+    }
+
+    for (UINT32 i = 0; i < CALLSTACK_MODULES_CACHE_ENTRIES; i++)
+    {
+        Module = &Cache->Entries[i];
+
+        if (Module->ImageBase == NULL || Module->Cr3 != Cr3 || Address - Module->ImageBase >= Module->SizeOfImage)
+        {
+            continue;
+        }
+
+        //
+        // The module might be unloaded, so the image is checked once in
+        // each walk
+        //
+        if (Module->ValidatedWalk != Cache->CurrentWalk)
+        {
+            if (!CallstackReadMemory(Module->ImageBase, &DosSignature, sizeof(UINT16)) ||
+                DosSignature != CALLSTACK_IMAGE_DOS_SIGNATURE)
+            {
+                Module->ImageBase = NULL;
+                continue;
+            }
+
+            Module->ValidatedWalk = Cache->CurrentWalk;
+        }
+
+        return Module;
+    }
+
+    //
+    // The module is not cached, the entry is replaced in a round-robin
+    // manner
+    //
+    Module          = &Cache->Entries[Cache->NextEntry];
+    Cache->NextEntry = (Cache->NextEntry + 1) % CALLSTACK_MODULES_CACHE_ENTRIES;
+
+    ImageBase = (UINT64)PAGE_ALIGN(Address);
+
+    for (UINT32 i = 0; i < CALLSTACK_MAXIMUM_IMAGE_SCAN_PAGES && ImageBase != NULL; i++, ImageBase -= PAGE_SIZE)
+    {
+        if (CallstackReadModuleHeaders(ImageBase, Address, Module))
+        {
+            Module->Cr3           = Cr3;
+            Module->ValidatedWalk = Cache->CurrentWalk;
+
+            return Module;
+        }
+    }
+
+    Module->ImageBase = NULL;
+
+    return NULL;
+}
+
+/**
+ * @brief Find the entry of the table of functions of a module that
+ * contains an address
+ * @details the table is sorted, so it's a binary search
+ *
+ * @param Module
+ * @param Rva The relative address in the module
+ * @param Function The entry of the function
+ *
+ * @return BOOLEAN FALSE if the address is in a leaf function (or it's not
+ * in the table)
+ */
+static BOOLEAN
+CallstackLookupFunction(PCALLSTACK_MODULE_ENTRY Module, UINT32 Rva, PCALLSTACK_RUNTIME_FUNCTION Function)
+{
+    UINT64 FunctionTable = Module->ImageBase + Module->FunctionTableRva;
+    INT64  Low           = 0;
+    INT64  High          = (INT64)Module->CountOfFunctions - 1;
+    INT64  Middle;
+
+    while (Low <= High)
+    {
+        Middle = (Low + High) / 2;
+
+        if (!CallstackReadMemory(FunctionTable + Middle * sizeof(CALLSTACK_RUNTIME_FUNCTION),
+                                 Function,
+                                 sizeof(CALLSTACK_RUNTIME_FUNCTION)))
+        {
+            return FALSE;
+        }
+
+        if (Rva < Function->BeginAddress)
+        {
+            High = Middle - 1;
+        }
+        else if (Rva >= Function->EndAddress)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            //
+            // The entry might refer to another entry of the table
+            //
+            if (Function->UnwindData & 1)
+            {
+                return CallstackReadMemory(Module->ImageBase + Function->UnwindData - 1,
+                                           Function,
+                                           sizeof(CALLSTACK_RUNTIME_FUNCTION));
+            }
+
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Get the count of the slots of an unwind code
+ *
+ * @param Code
+ *
+ * @return UINT32
+ */
+static UINT32
+CallstackGetUnwindCodeSlots(PCALLSTACK_UNWIND_CODE Code)
+{
+    switch (Code->UnwindOp)
+    {
+    case CALLSTACK_UWOP_ALLOC_LARGE:
+        return Code->OpInfo == 0 ? 2 : 3;
+
+    case CALLSTACK_UWOP_SAVE_NONVOL:
+    case CALLSTACK_UWOP_EPILOG:
+    case CALLSTACK_UWOP_SAVE_XMM128:
+        return 2;
+
+    case CALLSTACK_UWOP_SAVE_NONVOL_FAR:
+    case CALLSTACK_UWOP_SPARE_CODE:
+    case CALLSTACK_UWOP_SAVE_XMM128_FAR:
+        return 3;
+
+    default:
+        return 1;
+    }
+}
+
+/**
+ * @brief Undo the effects of the prolog of a function on the registers
+ * @details the same interpretation of the unwind codes as RtlVirtualUnwind,
+ * the codes of the instructions of the prolog that are not executed yet
+ * are skipped
+ *
+ * @param Module
+ * @param UnwindData The rva of the unwind info
+ * @param PrologOffset Offset of the instruction pointer in the function
+ * @param Registers The general-purpose registers (same order as GUEST_REGS)
+ * @param Rip The instruction pointer (only set for the machine frames)
+ * @param StackAddress The address of the instruction pointer on the stack
+ * (only set for the machine frames)
+ * @param ChainedFunction The chained function (its unwind data is null if
+ * there is no chained function)
+ * @param IsMachineFrame Whether the frame is a machine frame (interrupts
+ * and exceptions)
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CallstackApplyUnwindInfo(PCALLSTACK_MODULE_ENTRY     Module,
+                         UINT32                      UnwindData,
+                         UINT32                      PrologOffset,
+                         UINT64 *                    Registers,
+                         UINT64 *                    Rip,
+                         UINT64 *                    StackAddress,
+                         PCALLSTACK_RUNTIME_FUNCTION ChainedFunction,
+                         BOOLEAN *                   IsMachineFrame)
+{
+    CALLSTACK_UNWIND_INFO UnwindInfo;
+    CALLSTACK_UNWIND_CODE Codes[0x100];
+    UINT64                UnwindInfoAddress = Module->ImageBase + UnwindData;
+    UINT64                FrameBase;
+    UINT64                Offset;
+    UINT32                i;
+
+    *IsMachineFrame = FALSE;
+
+    if (!CallstackReadMemory(UnwindInfoAddress, &UnwindInfo, sizeof(CALLSTACK_UNWIND_INFO)) ||
+        (UnwindInfo.Version != 1 && UnwindInfo.Version != 2))
+    {
+        return FALSE;
+    }
+
+    //
+    // The codes are followed by the chained function (aligned to the even
+    // count of the slots)
+    //
+    if (UnwindInfo.CountOfCodes != 0 &&
+        !CallstackReadMemory(UnwindInfoAddress + sizeof(CALLSTACK_UNWIND_INFO),
+                             Codes,
+                             UnwindInfo.CountOfCodes * sizeof(CALLSTACK_UNWIND_CODE)))
+    {
+        return FALSE;
+    }
+
+    if (!(UnwindInfo.Flags & CALLSTACK_UNW_FLAG_CHAININFO))
+    {
+        ChainedFunction->UnwindData = NULL;
+    }
+    else if (!CallstackReadMemory(UnwindInfoAddress + sizeof(CALLSTACK_UNWIND_INFO) +
+                                      ((UnwindInfo.CountOfCodes + 1) & ~1) * sizeof(CALLSTACK_UNWIND_CODE),
+                                  ChainedFunction,
+                                  sizeof(CALLSTACK_RUNTIME_FUNCTION)))
+    {
+        return FALSE;
+    }
+
+    //
+    // The saved registers are relative to the frame pointer once it's
+    // established
+    //
+    FrameBase = Registers[CALLSTACK_REGISTER_RSP];
+
+    for (i = 0; i < UnwindInfo.CountOfCodes; i += CallstackGetUnwindCodeSlots(&Codes[i]))
+    {
+        if (Codes[i].UnwindOp == CALLSTACK_UWOP_SET_FPREG && Codes[i].CodeOffset <= PrologOffset)
+        {
+            FrameBase = Registers[UnwindInfo.FrameRegister] - UnwindInfo.FrameOffset * 16;
+        }
+    }
+
+    for (i = 0; i < UnwindInfo.CountOfCodes; i += CallstackGetUnwindCodeSlots(&Codes[i]))
+    {
+        if (i + CallstackGetUnwindCodeSlots(&Codes[i]) > UnwindInfo.CountOfCodes)
+        {
+            return FALSE;
+        }
+
+        //
+        // The epilog codes don't have an offset in the prolog
+        //
+        if (Codes[i].UnwindOp == CALLSTACK_UWOP_EPILOG || Codes[i].CodeOffset > PrologOffset)
+        {
+            continue;
+        }
+
+        switch (Codes[i].UnwindOp)
+        {
+        case CALLSTACK_UWOP_PUSH_NONVOL:
+
+            if (!CallstackReadMemory(Registers[CALLSTACK_REGISTER_RSP], &Registers[Codes[i].OpInfo], sizeof(UINT64)))
+            {
+                return FALSE;
+            }
+
+            Registers[CALLSTACK_REGISTER_RSP] += sizeof(UINT64);
+
+            break;
+
+        case CALLSTACK_UWOP_ALLOC_LARGE:
+
+            if (Codes[i].OpInfo == 0)
+            {
+                Registers[CALLSTACK_REGISTER_RSP] += Codes[i + 1].FrameOffset * 8;
+            }
+            else
+            {
+                Registers[CALLSTACK_REGISTER_RSP] += Codes[i + 1].FrameOffset + ((UINT32)Codes[i + 2].FrameOffset << 16);
+            }
+
+            break;
+
+        case CALLSTACK_UWOP_ALLOC_SMALL:
+
+            Registers[CALLSTACK_REGISTER_RSP] += Codes[i].OpInfo * 8 + 8;
+
+            break;
+
+        case CALLSTACK_UWOP_SET_FPREG:
+
+            Registers[CALLSTACK_REGISTER_RSP] = FrameBase;
+
+            break;
+
+        case CALLSTACK_UWOP_SAVE_NONVOL:
+        case CALLSTACK_UWOP_SAVE_NONVOL_FAR:
+
+            if (Codes[i].UnwindOp == CALLSTACK_UWOP_SAVE_NONVOL)
+            {
+                Offset = FrameBase + Codes[i + 1].FrameOffset * 8;
+            }
+            else
+            {
+                Offset = FrameBase + Codes[i + 1].FrameOffset + ((UINT32)Codes[i + 2].FrameOffset << 16);
+            }
+
+            if (!CallstackReadMemory(Offset, &Registers[Codes[i].OpInfo], sizeof(UINT64)))
+            {
+                return FALSE;
+            }
+
+            break;
+
+        case CALLSTACK_UWOP_PUSH_MACHFRAME:
+
+            //
+            // The frame of the interrupt (with or without the error code)
+            //
+            Offset = Registers[CALLSTACK_REGISTER_RSP] + (Codes[i].OpInfo ? sizeof(UINT64) : 0);
+
+            if (!CallstackReadMemory(Offset, Rip, sizeof(UINT64)) ||
+                !CallstackReadMemory(Offset + 3 * sizeof(UINT64), &Registers[CALLSTACK_REGISTER_RSP], sizeof(UINT64)))
+            {
+                return FALSE;
+            }
+
+            *StackAddress   = Offset;
+            *IsMachineFrame = TRUE;
+
+            return TRUE;
+
+        default:
+
+            //
+            // The xmm registers are not needed for unwinding
+            //
+            break;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Unwind a single frame of the stack
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param Registers The general-purpose registers (same order as GUEST_REGS)
+ * @param Rip The instruction pointer of the frame, it's set to the
+ * return address of the frame
+ * @param IsCallerFrame Whether the instruction pointer is a return address,
+ * it's set for the unwound instruction pointer (the interrupted instruction
+ * pointers of the machine frames are not return addresses)
+ * @param StackAddress The address of the return address on the stack
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CallstackUnwindFrame(PROCESSOR_DEBUGGING_STATE * DbgState,
+                     UINT64 *                    Registers,
+                     UINT64 *                    Rip,
+                     BOOLEAN *                   IsCallerFrame,
+                     UINT64 *                    StackAddress)
+{
+    CALLSTACK_RUNTIME_FUNCTION Function;
+    PCALLSTACK_MODULE_ENTRY    Module;
+    UINT64                     LookupAddress;
+    UINT32                     PrologOffset;
+    BOOLEAN                    IsMachineFrame;
+    BYTE                       Instruction;
+
+    //
+    // The return address might be the start of the next function (if the
+    // call is the last instruction of the function)
+    //
+    LookupAddress = *IsCallerFrame ? *Rip - 1 : *Rip;
+
+    Module = CallstackFindModule(DbgState, LookupAddress);
+
+    if (Module == NULL || Module->CountOfFunctions == 0)
+    {
+        return FALSE;
+    }
+
+    //
+    // The leaf functions (and the 'ret' instruction of the current frame)
+    // don't have any unwind info, the return address is on the top of the stack
+    //
+    if (CallstackLookupFunction(Module, (UINT32)(LookupAddress - Module->ImageBase), &Function) &&
+        (*IsCallerFrame || !CallstackReadMemory(*Rip, &Instruction, sizeof(BYTE)) || Instruction != 0xc3))
+    {
+        PrologOffset = (UINT32)(LookupAddress - Module->ImageBase) - Function.BeginAddress;
+
+        for (UINT32 i = 0;; i++)
+        {
+            if (i == CALLSTACK_MAXIMUM_CHAINED_UNWIND_INFOS ||
+                !CallstackApplyUnwindInfo(Module, Function.UnwindData, PrologOffset, Registers, Rip, StackAddress, &Function, &IsMachineFrame))
+            {
+                return FALSE;
+            }
+
+            if (IsMachineFrame)
+            {
+                *IsCallerFrame = FALSE;
+                return TRUE;
+            }
+
+            if (Function.UnwindData == NULL)
+            {
+                break;
+            }
+
+            //
+            // The prolog of the chained functions is completely executed
+            //
+            PrologOffset = MAXUINT32;
+        }
+    }
+
+    if (!CallstackReadMemory(Registers[CALLSTACK_REGISTER_RSP], Rip, sizeof(UINT64)))
+    {
+        return FALSE;
+    }
+
+    *StackAddress  = Registers[CALLSTACK_REGISTER_RSP];
+    *IsCallerFrame = TRUE;
+    Registers[CALLSTACK_REGISTER_RSP] += sizeof(UINT64);
+
+    return TRUE;
+}
+
+/**
+ * @brief Unwind the frames of the stack based on the unwind info of the
+ * modules (.pdata)
+ * @details the cost of each frame is bounded (a binary search in the table
+ * of functions and the unwind info of the function), the modules are cached
+ * on the current core, only the 64-bit frames are unwound
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param Regs The registers of the guest
+ * @param Rip The instruction pointer of the guest
+ * @param ReturnAddresses The return addresses of the frames
+ * @param StackAddresses The addresses of the stack that contain the return
+ * addresses (optional)
+ * @param MaximumFrames Maximum count of the frames
+ *
+ * @return UINT32 Count of the unwound frames
+ */
+UINT32
+CallstackUnwindFrames(PROCESSOR_DEBUGGING_STATE * DbgState,
+                      GUEST_REGS *                Regs,
+                      UINT64                      Rip,
+                      UINT64 *                    ReturnAddresses,
+                      UINT64 *                    StackAddresses,
+                      UINT32                      MaximumFrames)
+{
+    UINT64  Registers[16];
+    UINT64  PreviousRsp;
+    UINT64  StackAddress;
+    UINT32  FramesCount   = 0;
+    BOOLEAN IsCallerFrame = FALSE;
+
+    DbgState->CallstackModulesCache.CurrentWalk++;
+
+    //
+    // The general-purpose registers of GUEST_REGS are in the same order as
+    // the registers in the unwind codes
+    //
+    RtlCopyMemory(Registers, Regs, sizeof(Registers));
+
+    while (FramesCount < MaximumFrames)
+    {
+        PreviousRsp = Registers[CALLSTACK_REGISTER_RSP];
+
+        if (!CallstackUnwindFrame(DbgState, Registers, &Rip, &IsCallerFrame, &StackAddress) || Rip == NULL)
+        {
+            break;
+        }
+
+        //
+        // The stack doesn't go backward (except for the machine frames that
+        // switch from the kernel stack to the user stack)
+        //
+        if (Registers[CALLSTACK_REGISTER_RSP] <= PreviousRsp && (Registers[CALLSTACK_REGISTER_RSP] >> 63) == (PreviousRsp >> 63))
+        {
+            break;
+        }
+
+        ReturnAddresses[FramesCount] = Rip;
+
+        if (StackAddresses != NULL)
+        {
+            StackAddresses[FramesCount] = StackAddress;
+        }
+
+        FramesCount++;
+    }
+
+    return FramesCount;
+}
+
+/**
+ * @brief Mark the return addresses of the walked stack that are found by
+ * unwinding the stack
+ * @details the stack should be walked from the current stack pointer
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param AddressToSaveFrames The walked stack
+ * @param StackBaseAddress
+ * @param Size
+ *
+ * @return BOOLEAN Whether any return address is found by unwinding
+ */
+BOOLEAN
+CallstackMarkUnwoundReturnAddresses(PROCESSOR_DEBUGGING_STATE *      DbgState,
+                                    PDEBUGGER_SINGLE_CALLSTACK_FRAME AddressToSaveFrames,
+                                    UINT64                           StackBaseAddress,
+                                    UINT32                           Size)
+{
+    UINT64  ReturnAddresses[CALLSTACK_MAXIMUM_UNWOUND_FRAMES];
+    UINT64  StackAddresses[CALLSTACK_MAXIMUM_UNWOUND_FRAMES];
+    UINT32  FramesCount;
+    UINT64  Offset;
+    BOOLEAN IsMarked = FALSE;
+
+    FramesCount = CallstackUnwindFrames(DbgState,
+                                        DbgState->Regs,
+                                        VmFuncGetRip(),
+                                        ReturnAddresses,
+                                        StackAddresses,
+                                        CALLSTACK_MAXIMUM_UNWOUND_FRAMES);
+
+    for (UINT32 i = 0; i < FramesCount; i++)
+    {
+        Offset = StackAddresses[i] - StackBaseAddress;
+
+        //
+        // The frames after a machine frame might be on another stack
+        //
+        if (Offset >= Size || Offset % sizeof(UINT64) != 0)
+        {
+            continue;
+        }
+
+        AddressToSaveFrames[Offset / sizeof(UINT64)].IsUnwoundReturnAddress = TRUE;
+        IsMarked                                                          = TRUE;
+    }
+
+    return IsMarked;
+}
@@ -502,56 +502,130 @@ DebuggerCommandEditMemoryVmxRoot(PDEBUGGER_EDIT_MEMORY EditMemRequest)
 }
 
 /**
- * @brief Search on virtual memory (not work on physical memory)
+ * @brief Apply a list of patches on physical or virtual memory
+ * @details the patches are applied in order and it stops at the first
+ * patch that couldn't be applied, each patch is written at once, so the
+ * pages of a patch are mapped together (in the bulk window of the memory
+ * mapper)
  *
- * @details This function can be called from vmx-root mode
- * Do NOT directly call this function as the virtual addresses
- * should be valid on the target process memory layout
- * instead call : SearchAddressWrapper
- * the address between StartAddress and EndAddress should be contiguous
+ * @param PatchMemRequest The request followed by the stream of patches
+ * @param RequestLength Length of the request (including the stream)
+ * @param ApplyFromVmxRoot Whether it's called from vmx-root or not
+ *
+ * @return BOOLEAN Whether all of the patches are applied or not
+ */
+BOOLEAN
+DebuggerCommandPatchMemory(PDEBUGGER_PATCH_MEMORY_REQUEST PatchMemRequest, UINT32 RequestLength, BOOLEAN ApplyFromVmxRoot)
+{
+    PDEBUGGER_PATCH_MEMORY_ENTRY Patch;
+    UINT32                       Offset = 0;
+    PVOID                        Bytes;
+
+    PatchMemRequest->CountOfAppliedPatches = 0;
+
+    if (RequestLength < SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST ||
+        PatchMemRequest->PatchesBufferSize != RequestLength - SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST ||
+        (PatchMemRequest->MemoryType != EDIT_VIRTUAL_MEMORY && PatchMemRequest->MemoryType != EDIT_PHYSICAL_MEMORY))
+    {
+        PatchMemRequest->KernelStatus = DEBUGGER_ERROR_EDIT_MEMORY_STATUS_INVALID_PARAMETER;
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < PatchMemRequest->CountOfPatches; i++)
+    {
+        Patch = (PDEBUGGER_PATCH_MEMORY_ENTRY)((UINT64)PatchMemRequest + SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST + Offset);
+
+        //
+        // Check whether the patch is in the stream or not
+        //
+        if (PatchMemRequest->PatchesBufferSize - Offset < sizeof(DEBUGGER_PATCH_MEMORY_ENTRY) ||
+            PatchMemRequest->PatchesBufferSize - Offset < DEBUGGER_PATCH_MEMORY_ENTRY_LENGTH((UINT64)Patch->Size) ||
+            Patch->Size == 0)
+        {
+            PatchMemRequest->KernelStatus = DEBUGGER_ERROR_EDIT_MEMORY_STATUS_INVALID_PARAMETER;
+            return FALSE;
+        }
+
+        Bytes = (PVOID)((UINT64)Patch + sizeof(DEBUGGER_PATCH_MEMORY_ENTRY));
+
+        if (PatchMemRequest->MemoryType == EDIT_PHYSICAL_MEMORY)
+        {
+            if (!MemoryMapperWriteMemorySafeByPhysicalAddress(Patch->Address, (UINT64)Bytes, Patch->Size))
+            {
+                PatchMemRequest->KernelStatus = DEBUGGER_ERROR_INVALID_ADDRESS;
+                return FALSE;
+            }
+        }
+        else if (ApplyFromVmxRoot)
+        {
+            //
+            // Check whether the virtual memory is available in the current
+            // memory layout and also is present in the RAM
+            //
+            if (!CheckAccessValidityAndSafety(Patch->Address, Patch->Size) ||
+                !MemoryMapperWriteMemorySafeOnTargetProcess(Patch->Address, Bytes, Patch->Size))
+            {
+                PatchMemRequest->KernelStatus = DEBUGGER_ERROR_INVALID_ADDRESS;
+                return FALSE;
+            }
+        }
+        else
+        {
+            if (VirtualAddressToPhysicalAddressByProcessId(Patch->Address, PatchMemRequest->ProcessId) == 0 ||
+                VirtualAddressToPhysicalAddressByProcessId(Patch->Address + Patch->Size - 1, PatchMemRequest->ProcessId) == 0 ||
+                !MemoryMapperWriteMemoryUnsafe(Patch->Address, Bytes, Patch->Size, PatchMemRequest->ProcessId))
+            {
+                PatchMemRequest->KernelStatus = DEBUGGER_ERROR_EDIT_MEMORY_STATUS_INVALID_ADDRESS_BASED_ON_OTHER_PROCESS;
+                return FALSE;
+            }
+        }
+
+        Offset += DEBUGGER_PATCH_MEMORY_ENTRY_LENGTH(Patch->Size);
+        PatchMemRequest->CountOfAppliedPatches++;
+    }
+
+    PatchMemRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    return TRUE;
+}
+
+/**
+ * @brief Prepare the state of searching the patterns of a search request
+ *
+ * @details The values of the patterns are followed by their masks and
+ * the count of elements of each pattern
  *
- * @param AddressToSaveResults Address to save the search results
  * @param SearchMemRequest request structure of searching memory
- * @param StartAddress valid start address based on target process
- * @param EndAddress valid end address based on target process
- * @param IsDebuggeePaused Set to true when the search is performed in
- * the debugger mode
- * @param CountOfMatchedCases Number of matched cases
- * @return BOOLEAN Whether the search was successful or not
+ * @param State The state to be filled
+ * @return BOOLEAN Whether the request was valid or not
  */
 BOOLEAN
-PerformSearchAddress(UINT64 *                AddressToSaveResults,
-                     PDEBUGGER_SEARCH_MEMORY SearchMemRequest,
-                     UINT64                  StartAddress,
-                     UINT64                  EndAddress,
-                     BOOLEAN                 IsDebuggeePaused,
-                     PUINT32                 CountOfMatchedCases)
+SearchMemoryPrepareState(PDEBUGGER_SEARCH_MEMORY SearchMemRequest, PSEARCH_MEMORY_STATE State)
 {
-    UINT32   CountOfOccurance      = 0;
-    UINT64   Cmp64                 = 0;
-    UINT32   IndexToArrayOfResults = 0;
-    UINT32   LengthOfEachChunk     = 0;
-    PVOID    DestinationAddress    = 0;
-    PVOID    SourceAddress         = 0;
-    PVOID    TempSourceAddress     = 0;
-    BOOLEAN  StillMatch            = FALSE;
-    UINT64   TempValue             = NULL;
-    CR3_TYPE CurrentProcessCr3;
+    PUINT64 CountOfElements;
+    UINT32  FirstElement = 0;
+    UINT32  PatternLength;
+    UINT8   FirstByte;
+
+    RtlZeroMemory(State, sizeof(SEARCH_MEMORY_STATE));
 
     //
     // set chunk size in each modification
     //
     if (SearchMemRequest->ByteSize == SEARCH_BYTE)
     {
-        LengthOfEachChunk = 1;
+        State->ElementSize = 1;
+        State->ElementMask = 0xff;
     }
     else if (SearchMemRequest->ByteSize == SEARCH_DWORD)
     {
-        LengthOfEachChunk = 4;
+        State->ElementSize = 4;
+        State->ElementMask = 0xffffffff;
     }
     else if (SearchMemRequest->ByteSize == SEARCH_QWORD)
     {
-        LengthOfEachChunk = 8;
+        State->ElementSize = 8;
+        State->ElementMask = 0xffffffffffffffff;
     }
     else
     {
@@ -561,231 +635,760 @@ PerformSearchAddress(UINT64 *                AddressToSaveResults,
         return FALSE;
     }
 
+    if (SearchMemRequest->CountOfPatterns == 0 ||
+        SearchMemRequest->CountOfPatterns > MaximumSearchPatterns ||
+        SearchMemRequest->CountOf64Chunks < SearchMemRequest->CountOfPatterns ||
+        SearchMemRequest->CountOf64Chunks > MaximumSearchPatterns * MaximumSearchPatternSize ||
+        SearchMemRequest->FinalStructureSize !=
+            SIZEOF_DEBUGGER_SEARCH_MEMORY + ((SearchMemRequest->CountOf64Chunks * 2) + SearchMemRequest->CountOfPatterns) * sizeof(UINT64))
+    {
+        return FALSE;
+    }
+
+    State->Request         = SearchMemRequest;
+    State->Values          = (PUINT64)((UINT64)SearchMemRequest + SIZEOF_DEBUGGER_SEARCH_MEMORY);
+    State->Masks           = State->Values + SearchMemRequest->CountOf64Chunks;
+    CountOfElements        = State->Masks + SearchMemRequest->CountOf64Chunks;
+    State->CountOfPatterns = SearchMemRequest->CountOfPatterns;
+
     //
-    // Check if address is virtual address or physical address
+    // The first bytes are used to filter the addresses, unless a pattern
+    // starts with a wildcard
     //
-    if (SearchMemRequest->MemoryType == SEARCH_VIRTUAL_MEMORY ||
-        SearchMemRequest->MemoryType == SEARCH_PHYSICAL_FROM_VIRTUAL_MEMORY)
+    State->CanFilterFirstByte = TRUE;
+    State->HasSingleFirstByte = TRUE;
+
+    for (UINT32 i = 0; i < State->CountOfPatterns; i++)
     {
+        PatternLength = (UINT32)CountOfElements[i] * State->ElementSize;
+
+        if (CountOfElements[i] == 0 ||
+            CountOfElements[i] > SearchMemRequest->CountOf64Chunks - FirstElement ||
+            PatternLength > MaximumSearchPatternSize)
+        {
+            return FALSE;
+        }
+
+        State->Patterns[i].FirstElement    = FirstElement;
+        State->Patterns[i].CountOfElements = (UINT32)CountOfElements[i];
+
+        if (PatternLength > State->MaximumPatternLength)
+        {
+            State->MaximumPatternLength = PatternLength;
+        }
+
+        FirstByte = (UINT8)State->Values[FirstElement];
+
+        if ((State->Masks[FirstElement] & 0xff) != 0xff)
+        {
+            State->CanFilterFirstByte = FALSE;
+            State->HasSingleFirstByte = FALSE;
+        }
+        else if (i != 0 && FirstByte != State->FirstByte)
+        {
+            State->HasSingleFirstByte = FALSE;
+        }
+
+        State->FirstByte = FirstByte;
+        State->FirstBytesBitmap[FirstByte / 64] |= 1ULL << (FirstByte % 64);
+
+        FirstElement += (UINT32)CountOfElements[i];
+    }
+
+    //
+    // Every element should belong to a pattern
+    //
+    if (FirstElement != SearchMemRequest->CountOf64Chunks)
+    {
+        return FALSE;
+    }
+
+    //
+    // The first byte repeated in all of the bytes of a qword
+    //
+    State->FirstBytePattern = State->FirstByte * 0x0101010101010101ULL;
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether a pattern matches the buffer
+ *
+ * @param State The state of searching
+ * @param Pattern The pattern
+ * @param Buffer The buffer that is read from the searched memory
+ * @param AvailableLength Count of valid bytes of the buffer
+ * @return BOOLEAN
+ */
+BOOLEAN
+SearchMemoryMatchPattern(PSEARCH_MEMORY_STATE State, PSEARCH_MEMORY_PATTERN Pattern, UINT8 * Buffer, UINT32 AvailableLength)
+{
+    UINT64 Data;
+    UINT32 Index;
+
+    if (Pattern->CountOfElements * State->ElementSize > AvailableLength)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < Pattern->CountOfElements; i++)
+    {
+        Index = Pattern->FirstElement + i;
+
+        if (State->ElementSize == 1)
+        {
+            Data = Buffer[i];
+        }
+        else if (State->ElementSize == 4)
+        {
+            Data = *(UINT32 UNALIGNED *)(Buffer + (i * 4));
+        }
+        else
+        {
+            Data = *(UINT64 UNALIGNED *)(Buffer + (i * 8));
+        }
+
         //
-        // Search the memory
+        // Masked bytes are wildcards
         //
+        if (((Data ^ State->Values[Index]) & State->Masks[Index] & State->ElementMask) != 0)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Send the batch of results to the debugger
+ *
+ * @param State The state of searching
+ * @return VOID
+ */
+VOID
+SearchMemoryFlushResults(PSEARCH_MEMORY_STATE State)
+{
+    CHAR  Message[SearchResultsBatchSize * 17 + 1];
+    INT32 Length = 0;
+
+    if (State->BatchCount == 0)
+    {
+        return;
+    }
 
+    for (UINT32 i = 0; i < State->BatchCount; i++)
+    {
+        Length += sprintf_s(Message + Length, sizeof(Message) - Length, "%llx\n", State->Batch[i]);
+    }
+
+    Log("%s", Message);
+
+    State->BatchCount = 0;
+}
+
+/**
+ * @brief Save a result of searching
+ *
+ * @details the results are saved in the results buffer or they're sent
+ * in batches if there is no results buffer
+ *
+ * @param State The state of searching
+ * @param Address The matched address
+ * @return VOID
+ */
+VOID
+SearchMemorySaveResult(PSEARCH_MEMORY_STATE State, UINT64 Address)
+{
+    State->CountOfMatchedCases++;
+
+    if (State->Results == NULL)
+    {
         //
-        // Change the memory layout (cr3), if the user specified a
-        // special process
+        // Results are sent in batches, so there is no limit for them
         //
-        if (IsDebuggeePaused)
+        State->Batch[State->BatchCount] = Address;
+        State->BatchCount++;
+
+        if (State->BatchCount == SearchResultsBatchSize)
         {
-            //
-            // Switch to target process memory layout
-            //
-            CurrentProcessCr3 = SwitchToProcessMemoryLayoutByCr3(LayoutGetCurrentProcessCr3());
+            SearchMemoryFlushResults(State);
         }
-        else
+    }
+    else
+    {
+        State->Results[State->ResultsCount] = Address;
+        State->ResultsCount++;
+
+        if (State->ResultsCount == State->ResultsCapacity)
         {
-            if (SearchMemRequest->ProcessId != PsGetCurrentProcessId())
-            {
-                CurrentProcessCr3 = SwitchToProcessMemoryLayout(SearchMemRequest->ProcessId);
-            }
+            //
+            // The result buffer is full! the caller continues
+            // the search after the last result
+            //
+            State->IsResultsBufferFull = TRUE;
         }
+    }
+}
 
+/**
+ * @brief Save a matched address
+ *
+ * @param State The state of searching
+ * @param Address The matched address
+ * @return VOID
+ */
+VOID
+SearchMemoryReportResult(PSEARCH_MEMORY_STATE State, UINT64 Address)
+{
+    if (State->Request->MemoryType == SEARCH_PHYSICAL_FROM_VIRTUAL_MEMORY)
+    {
         //
-        // Here we iterate through the buffer we received from
-        // user-mode
+        // It's a physical memory
         //
-        SourceAddress = (UINT64)SearchMemRequest + SIZEOF_DEBUGGER_SEARCH_MEMORY;
+        Address = VirtualAddressToPhysicalAddress(Address);
+    }
 
-        for (size_t BaseIterator = (size_t)StartAddress; BaseIterator < ((UINT64)EndAddress); BaseIterator += LengthOfEachChunk)
+    SearchMemorySaveResult(State, Address);
+}
+
+/**
+ * @brief Search the patterns in a block of memory
+ *
+ * @param State The state of searching
+ * @param Buffer The buffer that is read from the searched memory
+ * @param ScanLength Count of bytes that the patterns might start from them
+ * @param ValidLength Count of valid bytes of the buffer (at least ScanLength)
+ * @param BlockAddress Address of the first byte of the buffer
+ * @return VOID
+ */
+VOID
+SearchMemoryScanBlock(PSEARCH_MEMORY_STATE State, UINT8 * Buffer, UINT32 ScanLength, UINT32 ValidLength, UINT64 BlockAddress)
+{
+    UINT32 Offset = 0;
+    UINT64 Word;
+    UINT8  Byte;
+
+    while (Offset < ScanLength && !State->IsResultsBufferFull)
+    {
+        if (State->HasSingleFirstByte && State->ElementSize == 1)
         {
             //
-            // *** Search the memory ***
+            // Skip eight bytes at a time while none of them is the first byte,
+            // a byte of the xor is zero if it's equal to the first byte
             //
+            while (Offset + sizeof(UINT64) <= ScanLength)
+            {
+                Word = *(UINT64 UNALIGNED *)(Buffer + Offset) ^ State->FirstBytePattern;
 
-            //
-            // Copy 64bit, 32bit or one byte value into Cmp64 buffer and then compare it
-            // Check if we should access the memory directly, or through safe memory
-            // routine from vmx-root
-            //
-            if (IsDebuggeePaused)
+                if (((Word - 0x0101010101010101ULL) & ~Word & 0x8080808080808080ULL) != 0)
+                {
+                    break;
+                }
+
+                Offset += sizeof(UINT64);
+            }
+
+            if (Offset >= ScanLength)
             {
-                MemoryMapperReadMemorySafe((PVOID)BaseIterator, &Cmp64, LengthOfEachChunk);
+                break;
             }
-            else
+        }
+
+        Byte = Buffer[Offset];
+
+        if (!State->CanFilterFirstByte || (State->FirstBytesBitmap[Byte / 64] & (1ULL << (Byte % 64))) != 0)
+        {
+            for (UINT32 i = 0; i < State->CountOfPatterns; i++)
             {
-                RtlCopyMemory(&Cmp64, (PVOID)BaseIterator, LengthOfEachChunk);
+                if (SearchMemoryMatchPattern(State, &State->Patterns[i], Buffer + Offset, ValidLength - Offset))
+                {
+                    //
+                    // We found the a matching address, let's save the
+                    // address for future use
+                    //
+                    SearchMemoryReportResult(State, BlockAddress + Offset);
+                    break;
+                }
             }
+        }
 
+        Offset += State->ElementSize;
+    }
+
+    if (State->IsResultsBufferFull)
+    {
+        //
+        // The search should be continued after the last result
+        //
+        State->ResumeAddress = BlockAddress + Offset + State->ElementSize;
+    }
+}
+
+/**
+ * @brief Search the patterns between two addresses
+ *
+ * @details The memory is read one page at a time, for the physical memory
+ * only the ranges that are backed by RAM are read. The caller should switch
+ * to the target memory layout of the virtual addresses
+ *
+ * @param State The state of searching
+ * @param Buffer The buffer for reading the memory (at least a page plus
+ * the longest pattern)
+ * @param StartAddress The start address
+ * @param EndAddress The end address (the patterns up to the end of the
+ * whole search are matched)
+ * @return VOID
+ */
+VOID
+SearchMemoryScanRange(PSEARCH_MEMORY_STATE State, UINT8 * Buffer, UINT64 StartAddress, UINT64 EndAddress)
+{
+    UINT64 RangeStart   = StartAddress;
+    UINT64 RangeEnd     = 0;
+    UINT64 ReadLimit    = 0;
+    UINT64 BlockAddress = 0;
+    UINT32 ScanLength   = 0;
+    UINT32 ReadLength   = 0;
+    UINT32 ValidLength  = 0;
+    SIZE_T CopiedLength = 0;
+
+    while (RangeStart < EndAddress && !State->IsResultsBufferFull)
+    {
+        RangeEnd = State->EndOfSearch;
+
+        if (State->IsPhysical && !PhysicalMemoryMapGetNextRange(&RangeStart, &RangeEnd))
+        {
             //
-            // Get the searching bytes
+            // No RAM is left in the range
             //
-            TempValue = *(UINT64 *)SourceAddress;
+            break;
+        }
+
+        //
+        // Patterns that start at the end of the range are checked with the bytes
+        // of the next page, but the memory after the page of the last byte (or
+        // after the RAM range) is not checked to be valid
+        //
+        ReadLimit = (UINT64)PAGE_ALIGN(RangeEnd - 1) + PAGE_SIZE;
+        RangeEnd  = min(RangeEnd, EndAddress);
+
+        if (RangeStart >= RangeEnd)
+        {
+            break;
+        }
+
+        for (BlockAddress = RangeStart; BlockAddress < RangeEnd && !State->IsResultsBufferFull; BlockAddress += ScanLength)
+        {
+            ScanLength = (UINT32)min(PAGE_SIZE, RangeEnd - BlockAddress);
+            ReadLength = (UINT32)min(ScanLength + State->MaximumPatternLength - 1, ReadLimit - BlockAddress);
 
             //
-            // Check whether the byte matches the source or not
+            // Check if we should access the memory directly, or through safe memory
+            // routine from vmx-root
             //
-            if (Cmp64 == TempValue)
+            if (State->IsPhysical && State->IsDebuggeePaused)
             {
-                //
-                // Indicate that it matches until now
-                //
-                StillMatch = TRUE;
+                ValidLength = ReadLength;
 
+                if (!MemoryMapperReadMemorySafeByPhysicalAddress(BlockAddress, (UINT64)Buffer, ReadLength))
+                {
+                    continue;
+                }
+            }
+            else if (State->IsPhysical)
+            {
                 //
-                // Try to check each element (we don't start from the very first element as
-                // it checked before )
+                // The physical memory is copied by the memory manager, it only
+                // copies the bytes that are accessible
                 //
-                for (size_t i = LengthOfEachChunk; i < SearchMemRequest->CountOf64Chunks; i++)
-                {
-                    //
-                    // I know, we have a double check here ;)
-                    //
-                    TempSourceAddress = (UINT64)SearchMemRequest + SIZEOF_DEBUGGER_SEARCH_MEMORY + (i * sizeof(UINT64));
+                CopiedLength = 0;
+                MemoryManagerReadProcessMemoryNormal(PsGetCurrentProcessId(),
+                                                     (PVOID)BlockAddress,
+                                                     DEBUGGER_READ_PHYSICAL_ADDRESS,
+                                                     Buffer,
+                                                     ReadLength,
+                                                     &CopiedLength);
 
-                    //
-                    // Add i to BaseIterator and recompute the Cmp64
-                    // Check if we should access the memory directly, or through safe memory
-                    // routine from vmx-root
-                    //
-                    if (IsDebuggeePaused)
-                    {
-                        MemoryMapperReadMemorySafe((PVOID)(BaseIterator + (LengthOfEachChunk * i)), &Cmp64, LengthOfEachChunk);
-                    }
-                    else
-                    {
-                        RtlCopyMemory(&Cmp64, (PVOID)(BaseIterator + (LengthOfEachChunk * i)), LengthOfEachChunk);
-                    }
-
-                    //
-                    // Check if we should access the memory directly,
-                    // or through safe memory routine from vmx-root
-                    //
-                    if (IsDebuggeePaused)
-                    {
-                        MemoryMapperReadMemorySafe(TempSourceAddress, &TempValue, sizeof(UINT64));
-                    }
-                    else
-                    {
-                        TempValue = *(UINT64 *)TempSourceAddress;
-                    }
+                ValidLength = (UINT32)CopiedLength;
 
-                    if (!(Cmp64 == TempValue))
-                    {
-                        //
-                        // One thing didn't match so this is not the pattern
-                        //
-                        StillMatch = FALSE;
-
-                        //
-                        // Break from the loop
-                        //
-                        break;
-                    }
+                if (ValidLength < ScanLength)
+                {
+                    continue;
                 }
+            }
+            else if (State->IsDebuggeePaused)
+            {
+                ValidLength = ReadLength;
 
-                //
-                // Check if we find the pattern or not
-                //
-                if (StillMatch)
+                if (!MemoryMapperReadMemorySafe(BlockAddress, Buffer, ReadLength))
                 {
                     //
-                    // We found the a matching address, let's save the
-                    // address for future use
+                    // The bytes after this block might not be accessible
                     //
-                    CountOfOccurance++;
+                    ValidLength = ScanLength;
 
-                    if (IsDebuggeePaused)
-                    {
-                        if (SearchMemRequest->MemoryType == SEARCH_PHYSICAL_FROM_VIRTUAL_MEMORY)
-                        {
-                            //
-                            // It's a physical memory
-                            //
-                            Log("%llx\n", VirtualAddressToPhysicalAddress(BaseIterator));
-                        }
-                        else
-                        {
-                            //
-                            // It's a virtual memory
-                            //
-                            Log("%llx\n", BaseIterator);
-                        }
-                    }
-                    else
+                    if (!MemoryMapperReadMemorySafe(BlockAddress, Buffer, ScanLength))
                     {
-                        if (SearchMemRequest->MemoryType == SEARCH_PHYSICAL_FROM_VIRTUAL_MEMORY)
-                        {
-                            //
-                            // It's a physical memory
-                            //
-                            AddressToSaveResults[IndexToArrayOfResults] = VirtualAddressToPhysicalAddress(BaseIterator);
-                        }
-                        else
-                        {
-                            //
-                            // It's a virtual memory
-                            //
-                            AddressToSaveResults[IndexToArrayOfResults] = BaseIterator;
-                        }
-                    }
-
-                    //
-                    // Increase the array pointer if it doesn't exceed the limitation
-                    //
-                    if (MaximumSearchResults > IndexToArrayOfResults)
-                    {
-                        IndexToArrayOfResults++;
-                    }
-                    else
-                    {
-                        //
-                        // The result buffer is full!
-                        //
-                        *CountOfMatchedCases = CountOfOccurance;
-                        return TRUE;
+                        continue;
                     }
                 }
             }
             else
             {
-                //
-                // Not found in the place
-                //
-                continue;
+                RtlCopyMemory(Buffer, (PVOID)BlockAddress, ReadLength);
+                ValidLength = ReadLength;
             }
+
+            SearchMemoryScanBlock(State, Buffer, ScanLength, ValidLength, BlockAddress);
         }
 
-        //
-        // Restore the previous memory layout (cr3), if the user specified a
-        // special process
-        //
-        if (IsDebuggeePaused || SearchMemRequest->ProcessId != PsGetCurrentProcessId())
+        RangeStart = RangeEnd;
+    }
+}
+
+/**
+ * @brief Search the slices of the parallel search job
+ *
+ * @details This function is called from vmx-root mode on the operating core
+ * and on the halted cores, each core takes the slices that are not taken yet
+ * and saves their results in the slice
+ *
+ * @param CoreId The current core
+ * @return VOID
+ */
+VOID
+SearchMemorySearchParallelSlices(UINT32 CoreId)
+{
+    SEARCH_MEMORY_STATE           State;
+    PSEARCH_MEMORY_PARALLEL_SLICE Slice;
+    CR3_TYPE                      CurrentProcessCr3 = {0};
+    UINT8 *                       Buffer            = g_SearchMemoryParallelBuffers + (CoreId * SearchParallelBufferSize);
+    UINT32                        Index;
+
+    if (!SearchMemoryPrepareState(g_SearchMemoryParallelJob.Request, &State))
+    {
+        return;
+    }
+
+    State.IsDebuggeePaused = TRUE;
+    State.IsPhysical       = g_SearchMemoryParallelJob.Request->MemoryType == SEARCH_PHYSICAL_MEMORY;
+    State.EndOfSearch      = g_SearchMemoryParallelJob.EndAddress;
+    State.ResultsCapacity  = SearchParallelResultsPerSlice;
+
+    //
+    // Virtual addresses are based on the layout of the operating core
+    //
+    if (!State.IsPhysical)
+    {
+        CurrentProcessCr3 = SwitchToProcessMemoryLayoutByCr3(g_SearchMemoryParallelJob.LayoutCr3);
+    }
+
+    while ((Index = (UINT32)InterlockedIncrement(&g_SearchMemoryParallelJob.NextSlice) - 1) < g_SearchMemoryParallelJob.CountOfSlices)
+    {
+        Slice = &g_SearchMemoryParallelSlices[Index];
+
+        State.Results             = Slice->Results;
+        State.ResultsCount        = 0;
+        State.IsResultsBufferFull = FALSE;
+
+        SearchMemoryScanRange(&State, Buffer, Slice->StartAddress, Slice->EndAddress);
+
+        Slice->CountOfResults = State.ResultsCount;
+        Slice->ResumeAddress  = State.IsResultsBufferFull ? State.ResumeAddress : Slice->EndAddress;
+
+        InterlockedIncrement(&g_SearchMemoryParallelJob.FinishedSlices);
+    }
+
+    if (!State.IsPhysical)
+    {
+        SwitchToPreviousProcess(CurrentProcessCr3);
+    }
+}
+
+/**
+ * @brief Take part in the parallel search job (if any)
+ *
+ * @details This function is called from vmx-root mode by the halted cores
+ * while they're waiting for the debuggee to continue
+ *
+ * @param CoreId The current core
+ * @return BOOLEAN Whether the core took part in a search job or not
+ */
+BOOLEAN
+SearchMemoryParallelWorker(UINT32 CoreId)
+{
+    BOOLEAN IsActive = FALSE;
+
+    if (!g_SearchMemoryParallelJob.Active)
+    {
+        return FALSE;
+    }
+
+    //
+    // The worker is counted before checking the job again, so the
+    // operating core waits for it before releasing the job
+    //
+    InterlockedIncrement(&g_SearchMemoryParallelJob.ActiveWorkers);
+
+    if (InterlockedCompareExchange(&g_SearchMemoryParallelJob.Active, TRUE, TRUE) == TRUE)
+    {
+        IsActive = TRUE;
+        SearchMemorySearchParallelSlices(CoreId);
+    }
+
+    InterlockedDecrement(&g_SearchMemoryParallelJob.ActiveWorkers);
+
+    return IsActive;
+}
+
+/**
+ * @brief Search the memory in parallel by the halted cores
+ *
+ * @details This function is called from vmx-root mode on the operating core
+ * while the other cores are halted, the range is split into slices that are
+ * searched by all of the cores, then the results are sent in the order of
+ * the addresses from the operating core
+ *
+ * @param State The state of searching (results are sent in batches)
+ * @param StartAddress The start address
+ * @param EndAddress The end address
+ * @return BOOLEAN Returns FALSE if the range is not large enough to be
+ * searched in parallel
+ */
+BOOLEAN
+SearchMemoryPerformParallelSearch(PSEARCH_MEMORY_STATE State, UINT64 StartAddress, UINT64 EndAddress)
+{
+    PSEARCH_MEMORY_PARALLEL_SLICE Slice;
+    UINT64                        SliceSize;
+    UINT32                        CountOfSlices;
+    ULONG                         CoreId = KeGetCurrentProcessorNumberEx(NULL);
+
+    if (g_SearchMemoryParallelBuffers == NULL || g_SearchMemoryParallelSlices == NULL)
+    {
+        return FALSE;
+    }
+
+    CountOfSlices = (UINT32)min(g_SearchMemoryParallelCountOfSlices,
+                                (EndAddress - StartAddress) / SearchParallelMinimumSliceSize);
+
+    if (CountOfSlices <= 1)
+    {
+        return FALSE;
+    }
+
+    //
+    // Slices are page aligned, the last slice also contains the remainder
+    //
+    SliceSize = (UINT64)PAGE_ALIGN((EndAddress - StartAddress) / CountOfSlices);
+
+    for (UINT32 i = 0; i < CountOfSlices; i++)
+    {
+        Slice = &g_SearchMemoryParallelSlices[i];
+
+        Slice->StartAddress   = StartAddress + (i * SliceSize);
+        Slice->EndAddress     = (i == CountOfSlices - 1) ? EndAddress : Slice->StartAddress + SliceSize;
+        Slice->ResumeAddress  = Slice->StartAddress;
+        Slice->CountOfResults = 0;
+    }
+
+    g_SearchMemoryParallelJob.Request        = State->Request;
+    g_SearchMemoryParallelJob.LayoutCr3      = LayoutGetCurrentProcessCr3();
+    g_SearchMemoryParallelJob.EndAddress     = EndAddress;
+    g_SearchMemoryParallelJob.CountOfSlices  = CountOfSlices;
+    g_SearchMemoryParallelJob.NextSlice      = 0;
+    g_SearchMemoryParallelJob.FinishedSlices = 0;
+
+    //
+    // Let the halted cores take the slices, the operating core also
+    // searches the slices that are not taken
+    //
+    InterlockedExchange(&g_SearchMemoryParallelJob.Active, TRUE);
+
+    SearchMemorySearchParallelSlices(CoreId);
+
+    while (g_SearchMemoryParallelJob.FinishedSlices != (LONG)CountOfSlices)
+    {
+        _mm_pause();
+    }
+
+    InterlockedExchange(&g_SearchMemoryParallelJob.Active, FALSE);
+
+    while (g_SearchMemoryParallelJob.ActiveWorkers != 0)
+    {
+        _mm_pause();
+    }
+
+    //
+    // Merge the results, the slices that their results buffers are full
+    // are continued on the operating core
+    //
+    for (UINT32 i = 0; i < CountOfSlices; i++)
+    {
+        Slice = &g_SearchMemoryParallelSlices[i];
+
+        for (UINT32 j = 0; j < Slice->CountOfResults; j++)
         {
-            SwitchToPreviousProcess(CurrentProcessCr3);
+            SearchMemorySaveResult(State, Slice->Results[j]);
+        }
+
+        if (Slice->ResumeAddress < Slice->EndAddress)
+        {
+            SearchMemoryScanRange(State, g_SearchMemoryBuffer, Slice->ResumeAddress, Slice->EndAddress);
         }
     }
-    else if (SearchMemRequest->MemoryType == SEARCH_PHYSICAL_MEMORY)
+
+    return TRUE;
+}
+
+/**
+ * @brief Search on virtual or physical memory
+ *
+ * @details This function can be called from vmx-root mode
+ * Do NOT directly call this function as the virtual addresses
+ * should be valid on the target process memory layout
+ * instead call : SearchAddressWrapper
+ * the address between StartAddress and EndAddress should be contiguous
+ * (for the physical memory, only the ranges that are backed by RAM are read)
+ * The memory is read one page at a time and the patterns are only
+ * verified on the addresses that start with the first byte of a pattern
+ *
+ * @param AddressToSaveResults Address to save the search results
+ * @param SearchMemRequest request structure of searching memory
+ * @param StartAddress valid start address based on target process
+ * @param EndAddress valid end address based on target process
+ * @param IsDebuggeePaused Set to true when the search is performed in
+ * the debugger mode
+ * @param CountOfMatchedCases Number of matched cases
+ * @return BOOLEAN Whether the search was successful or not
+ */
+BOOLEAN
+PerformSearchAddress(UINT64 *                AddressToSaveResults,
+                     PDEBUGGER_SEARCH_MEMORY SearchMemRequest,
+                     UINT64                  StartAddress,
+                     UINT64                  EndAddress,
+                     BOOLEAN                 IsDebuggeePaused,
+                     PUINT32                 CountOfMatchedCases)
+{
+    SEARCH_MEMORY_STATE State;
+    UINT8 *             Buffer     = NULL;
+    BOOLEAN             IsPhysical = FALSE;
+    BOOLEAN             IsSwitched = FALSE;
+    CR3_TYPE            CurrentProcessCr3;
+
+    //
+    // Check if address is virtual address or physical address
+    //
+    if (SearchMemRequest->MemoryType == SEARCH_PHYSICAL_MEMORY)
     {
         //
-        // That's an error, the physical memory is handled like virtual memory and
-        // thus we should never reach here
+        // The physical memory is read directly (without switching the layout)
+        //
+        IsPhysical = TRUE;
+    }
+    else if (SearchMemRequest->MemoryType != SEARCH_VIRTUAL_MEMORY &&
+             SearchMemRequest->MemoryType != SEARCH_PHYSICAL_FROM_VIRTUAL_MEMORY)
+    {
         //
-        LogError("Err, searching physical memory is not allowed without virtual address");
+        // Invalid parameter
+        //
+        return FALSE;
+    }
 
+    if (!SearchMemoryPrepareState(SearchMemRequest, &State) || StartAddress >= EndAddress)
+    {
         return FALSE;
     }
+
+    State.IsDebuggeePaused = IsDebuggeePaused;
+    State.IsPhysical       = IsPhysical;
+    State.EndOfSearch      = EndAddress;
+
+    //
+    // In the debugger mode, the results are sent in batches
+    //
+    if (!IsDebuggeePaused)
+    {
+        State.Results         = AddressToSaveResults;
+        State.ResultsCapacity = MaximumSearchResults;
+    }
+
+    //
+    // Allocations are not possible in vmx-root, so the pre-allocated
+    // buffer is used in the debugger mode
+    //
+    if (IsDebuggeePaused)
+    {
+        Buffer = g_SearchMemoryBuffer;
+    }
     else
+    {
+        Buffer = ExAllocatePoolWithTag(NonPagedPool, sizeof(g_SearchMemoryBuffer), POOLTAG);
+
+        if (Buffer == NULL)
+        {
+            return FALSE;
+        }
+    }
+
+    //
+    // Change the memory layout (cr3), if the user specified a
+    // special process
+    //
+    if (IsPhysical)
     {
         //
-        // Invalid parameter
+        // The physical memory doesn't depend on the memory layout
         //
-        return FALSE;
+    }
+    else if (IsDebuggeePaused)
+    {
+        //
+        // Switch to target process memory layout
+        //
+        CurrentProcessCr3 = SwitchToProcessMemoryLayoutByCr3(LayoutGetCurrentProcessCr3());
+        IsSwitched        = TRUE;
+    }
+    else if (SearchMemRequest->ProcessId != PsGetCurrentProcessId())
+    {
+        CurrentProcessCr3 = SwitchToProcessMemoryLayout(SearchMemRequest->ProcessId);
+        IsSwitched        = TRUE;
+    }
+
+    //
+    // In the debugger mode, other cores are halted so the large ranges
+    // are searched by all of the cores
+    //
+    if (!IsDebuggeePaused || !SearchMemoryPerformParallelSearch(&State, StartAddress, EndAddress))
+    {
+        SearchMemoryScanRange(&State, Buffer, StartAddress, EndAddress);
+    }
+
+    //
+    // Send the remaining results
+    //
+    if (IsDebuggeePaused)
+    {
+        SearchMemoryFlushResults(&State);
+    }
+
+    //
+    // Restore the previous memory layout (cr3), if the user specified a
+    // special process
+    //
+    if (IsSwitched)
+    {
+        SwitchToPreviousProcess(CurrentProcessCr3);
+    }
+
+    if (!IsDebuggeePaused)
+    {
+        ExFreePoolWithTag(Buffer, POOLTAG);
     }
 
     //
     // As we're here the search is finished without error
     //
-    *CountOfMatchedCases = CountOfOccurance;
+    *CountOfMatchedCases = State.CountOfMatchedCases;
     return TRUE;
 }
 
@@ -815,13 +1418,12 @@ SearchAddressWrapper(PUINT64                 AddressToSaveResults,
                      PUINT32                 CountOfMatchedCases)
 {
     CR3_TYPE CurrentProcessCr3;
-    UINT64   BaseAddress         = 0;
-    UINT64   CurrentValue        = 0;
-    UINT64   RealPhysicalAddress = 0;
-    UINT64   TempValue           = NULL;
-    UINT64   TempStartAddress    = NULL;
-    BOOLEAN  DoesBaseAddrSaved   = FALSE;
-    BOOLEAN  SearchResult        = FALSE;
+    UINT64   BaseAddress       = 0;
+    UINT64   CurrentValue      = 0;
+    UINT64   TempValue         = NULL;
+    UINT64   TempStartAddress  = NULL;
+    BOOLEAN  DoesBaseAddrSaved = FALSE;
+    BOOLEAN  SearchResult      = FALSE;
 
     //
     // Reset the count of matched cases
@@ -903,6 +1505,14 @@ SearchAddressWrapper(PUINT64                 AddressToSaveResults,
         //
         if (DoesBaseAddrSaved && StartAddress > BaseAddress)
         {
+            //
+            // Only search the valid pages
+            //
+            if (StartAddress < EndAddress)
+            {
+                EndAddress = StartAddress;
+            }
+
             SearchResult = PerformSearchAddress(AddressToSaveResults,
                                                 SearchMemRequest,
                                                 BaseAddress,
@@ -921,51 +1531,15 @@ SearchAddressWrapper(PUINT64                 AddressToSaveResults,
     else if (SearchMemRequest->MemoryType == SEARCH_PHYSICAL_MEMORY)
     {
         //
-        // when we reached here, we know that it's a valid physical memory,
-        // so we change the structure and pass it as a virtual address to
-        // the search function
-        //
-        RealPhysicalAddress = SearchMemRequest->Address;
-
-        //
-        // Change the start address
-        //
-        if (IsDebuggeePaused)
-        {
-            SearchMemRequest->Address = PhysicalAddressToVirtualAddressOnTargetProcess(StartAddress);
-            EndAddress                = PhysicalAddressToVirtualAddressOnTargetProcess(EndAddress);
-        }
-        else if (SearchMemRequest->ProcessId == PsGetCurrentProcessId())
-        {
-            SearchMemRequest->Address = PhysicalAddressToVirtualAddress(StartAddress);
-            EndAddress                = PhysicalAddressToVirtualAddress(EndAddress);
-        }
-        else
-        {
-            SearchMemRequest->Address = PhysicalAddressToVirtualAddressByProcessId(StartAddress, SearchMemRequest->ProcessId);
-            EndAddress                = PhysicalAddressToVirtualAddressByProcessId(EndAddress, SearchMemRequest->ProcessId);
-        }
-
-        //
-        // Change the type of memory
-        //
-        SearchMemRequest->MemoryType = SEARCH_PHYSICAL_FROM_VIRTUAL_MEMORY;
-
-        //
-        // Call the wrapper
+        // Only the parts of the range that are backed by RAM are searched,
+        // so the device memory (MMIO) and the holes are skipped
         //
         SearchResult = PerformSearchAddress(AddressToSaveResults,
                                             SearchMemRequest,
-                                            SearchMemRequest->Address,
+                                            StartAddress,
                                             EndAddress,
                                             IsDebuggeePaused,
                                             CountOfMatchedCases);
-
-        //
-        // Restore the previous state
-        //
-        SearchMemRequest->MemoryType = SEARCH_PHYSICAL_MEMORY;
-        SearchMemRequest->Address    = RealPhysicalAddress;
     }
 
     return SearchResult;
@@ -1190,6 +1764,16 @@ DebuggerCommandReservePreallocatedPools(PDEBUGGER_PREALLOC_COMMAND PreallocReque
                                      PROCESS_THREAD_HOLDER);
 
         break;
+
+    case DEBUGGER_PREALLOC_COMMAND_TYPE_EPT_SNAPSHOT:
+
+        //
+        // Request pages to be allocated for the copies of the pages that
+        // are written after taking the snapshot
+        //
+        ConfigureEptSnapshotAllocatePageCopies(PreallocRequest->Count);
+
+        break;
     default:
 
         PreallocRequest->KernelStatus = DEBUGGER_ERROR_COULD_NOT_FIND_ALLOCATION_TYPE;
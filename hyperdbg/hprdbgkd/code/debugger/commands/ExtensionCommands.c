@@ -51,12 +51,35 @@ ExtensionCommandVa2paAndPa2va(PDEBUGGER_VA2PA_AND_PA2VA_COMMANDS AddressDetails,
         }
         else
         {
+            //
+            // Check whether the physical address is backed by RAM or not
+            //
+            if (!PhysicalMemoryMapIsRam(AddressDetails->PhysicalAddress))
+            {
+                AddressDetails->VirtualAddress = NULL;
+                AddressDetails->KernelStatus   = DEBUGGER_ERROR_INVALID_ADDRESS;
+                return;
+            }
+
             AddressDetails->VirtualAddress = PhysicalAddressToVirtualAddressOnTargetProcess(AddressDetails->PhysicalAddress);
 
             //
-            // We don't know a way for checking physical address validity
+            // Check if address is valid or invalid
             //
-            AddressDetails->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+            if (AddressDetails->VirtualAddress == NULL)
+            {
+                //
+                // Invalid address
+                //
+                AddressDetails->KernelStatus = DEBUGGER_ERROR_INVALID_ADDRESS;
+            }
+            else
+            {
+                //
+                // Operation was successful
+                //
+                AddressDetails->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+            }
         }
     }
     else
@@ -95,12 +118,35 @@ ExtensionCommandVa2paAndPa2va(PDEBUGGER_VA2PA_AND_PA2VA_COMMANDS AddressDetails,
             }
             else
             {
+                //
+                // Check whether the physical address is backed by RAM or not
+                //
+                if (!PhysicalMemoryMapIsRam(AddressDetails->PhysicalAddress))
+                {
+                    AddressDetails->VirtualAddress = NULL;
+                    AddressDetails->KernelStatus   = DEBUGGER_ERROR_INVALID_ADDRESS;
+                    return;
+                }
+
                 AddressDetails->VirtualAddress = PhysicalAddressToVirtualAddress(AddressDetails->PhysicalAddress);
 
                 //
-                // We don't know a way for checking physical address validity
+                // Check if address is valid or invalid
                 //
-                AddressDetails->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+                if (AddressDetails->VirtualAddress == NULL)
+                {
+                    //
+                    // Invalid address
+                    //
+                    AddressDetails->KernelStatus = DEBUGGER_ERROR_INVALID_ADDRESS;
+                }
+                else
+                {
+                    //
+                    // Operation was successful
+                    //
+                    AddressDetails->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+                }
             }
         }
         else
@@ -145,12 +191,35 @@ ExtensionCommandVa2paAndPa2va(PDEBUGGER_VA2PA_AND_PA2VA_COMMANDS AddressDetails,
             }
             else
             {
+                //
+                // Check whether the physical address is backed by RAM or not
+                //
+                if (!PhysicalMemoryMapIsRam(AddressDetails->PhysicalAddress))
+                {
+                    AddressDetails->VirtualAddress = NULL;
+                    AddressDetails->KernelStatus   = DEBUGGER_ERROR_INVALID_ADDRESS;
+                    return;
+                }
+
                 AddressDetails->VirtualAddress = PhysicalAddressToVirtualAddressByProcessId(AddressDetails->PhysicalAddress, AddressDetails->ProcessId);
 
                 //
-                // We don't know a way for checking physical address validity
+                // Check if address is valid or invalid
                 //
-                AddressDetails->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+                if (AddressDetails->VirtualAddress == NULL)
+                {
+                    //
+                    // Invalid address
+                    //
+                    AddressDetails->KernelStatus = DEBUGGER_ERROR_INVALID_ADDRESS;
+                }
+                else
+                {
+                    //
+                    // Operation was successful
+                    //
+                    AddressDetails->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+                }
             }
         }
     }
@@ -166,8 +235,10 @@ ExtensionCommandVa2paAndPa2va(PDEBUGGER_VA2PA_AND_PA2VA_COMMANDS AddressDetails,
 BOOLEAN
 ExtensionCommandPte(PDEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS PteDetails, BOOLEAN IsOperatingInVmxRoot)
 {
-    BOOLEAN  Result     = FALSE;
-    CR3_TYPE RestoreCr3 = {0};
+    BOOLEAN                Result     = FALSE;
+    CR3_TYPE               RestoreCr3 = {0};
+    CR3_TYPE               Cr3;
+    PAGE_TABLE_WALK_RESULT Walk;
 
     //
     // Check for validations
@@ -228,44 +299,57 @@ ExtensionCommandPte(PDEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS PteDetails, BOOLEA
         }
     }
 
+    //
+    // Walk the page tables once for all of the levels
+    //
+    Cr3.Flags = __readcr3();
+
+    if (MemoryMapperWalkPageTablesWithoutSwitchingByCr3(PteDetails->VirtualAddress, Cr3, &Walk))
+    {
+        //
+        // The levels below a large page (or an entry that is not present)
+        // show the entry of the last walked level
+        //
+        for (INT32 i = 0; i < Walk.LeafLevel; i++)
+        {
+            Walk.EntriesVirtualAddresses[i] = Walk.EntriesVirtualAddresses[Walk.LeafLevel];
+        }
+    }
+
     //
     // Read the PML4E
     //
-    PPAGE_ENTRY Pml4e = MemoryMapperGetPteVa(PteDetails->VirtualAddress, PagingLevelPageMapLevel4);
-    if (Pml4e)
+    if (Walk.EntriesVirtualAddresses[PagingLevelPageMapLevel4])
     {
-        PteDetails->Pml4eVirtualAddress = Pml4e;
-        PteDetails->Pml4eValue          = Pml4e->Flags;
+        PteDetails->Pml4eVirtualAddress = Walk.EntriesVirtualAddresses[PagingLevelPageMapLevel4];
+        PteDetails->Pml4eValue          = *(UINT64 *)Walk.EntriesVirtualAddresses[PagingLevelPageMapLevel4];
     }
 
     //
     // Read the PDPTE
     //
-    PPAGE_ENTRY Pdpte = MemoryMapperGetPteVa(PteDetails->VirtualAddress, PagingLevelPageDirectoryPointerTable);
-    if (Pdpte)
+    if (Walk.EntriesVirtualAddresses[PagingLevelPageDirectoryPointerTable])
     {
-        PteDetails->PdpteVirtualAddress = Pdpte;
-        PteDetails->PdpteValue          = Pdpte->Flags;
+        PteDetails->PdpteVirtualAddress = Walk.EntriesVirtualAddresses[PagingLevelPageDirectoryPointerTable];
+        PteDetails->PdpteValue          = *(UINT64 *)Walk.EntriesVirtualAddresses[PagingLevelPageDirectoryPointerTable];
     }
 
     //
     // Read the PDE
     //
-    PPAGE_ENTRY Pde = MemoryMapperGetPteVa(PteDetails->VirtualAddress, PagingLevelPageDirectory);
-    if (Pde)
+    if (Walk.EntriesVirtualAddresses[PagingLevelPageDirectory])
     {
-        PteDetails->PdeVirtualAddress = Pde;
-        PteDetails->PdeValue          = Pde->Flags;
+        PteDetails->PdeVirtualAddress = Walk.EntriesVirtualAddresses[PagingLevelPageDirectory];
+        PteDetails->PdeValue          = *(UINT64 *)Walk.EntriesVirtualAddresses[PagingLevelPageDirectory];
     }
 
     //
     // Read the PTE
     //
-    PPAGE_ENTRY Pte = MemoryMapperGetPteVa(PteDetails->VirtualAddress, PagingLevelPageTable);
-    if (Pte)
+    if (Walk.EntriesVirtualAddresses[PagingLevelPageTable])
     {
-        PteDetails->PteVirtualAddress = Pte;
-        PteDetails->PteValue          = Pte->Flags;
+        PteDetails->PteVirtualAddress = Walk.EntriesVirtualAddresses[PagingLevelPageTable];
+        PteDetails->PteValue          = *(UINT64 *)Walk.EntriesVirtualAddresses[PagingLevelPageTable];
     }
 
     PteDetails->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
@@ -312,6 +396,21 @@ ExtensionCommandResetChangeAllMsrBitmapReadAllCores()
     BroadcastResetChangeAllMsrBitmapReadAllCores();
 }
 
+/**
+ * @brief routines for removing a single !msrread event
+ * @details only the msrs that are not used by other events are unset
+ * @param BitmapMask Bit mask of msr to release on msr bitmap
+ * @return VOID
+ */
+VOID
+ExtensionCommandUnsetMsrBitmapReadAllCores(UINT64 BitmapMask)
+{
+    //
+    // Broadcast to all cores
+    //
+    BroadcastUnsetMsrBitmapReadAllCores(BitmapMask);
+}
+
 /**
  * @brief routines for !msrwrite command which
  * @details causes vm-exit on all msr writes
@@ -339,6 +438,21 @@ ExtensionCommandResetAllMsrBitmapWriteAllCores()
     BroadcastResetAllMsrBitmapWriteAllCores();
 }
 
+/**
+ * @brief routines for removing a single !msrwrite event
+ * @details only the msrs that are not used by other events are unset
+ * @param BitmapMask Bit mask of msr to release on msr bitmap
+ * @return VOID
+ */
+VOID
+ExtensionCommandUnsetMsrBitmapWriteAllCores(UINT64 BitmapMask)
+{
+    //
+    // Broadcast to all cores
+    //
+    BroadcastUnsetMsrBitmapWriteAllCores(BitmapMask);
+}
+
 /**
  * @brief routines for !tsc command
  * @details causes vm-exit on all execution of rdtsc/rdtscp
@@ -353,6 +467,20 @@ ExtensionCommandEnableRdtscExitingAllCores()
     BroadcastEnableRdtscExitingAllCores();
 }
 
+/**
+ * @brief routines for !tsc command on the target cores
+ * @param CoreMask The mask of target cores
+ * @return VOID
+ */
+VOID
+ExtensionCommandEnableRdtscExitingOnCores(UINT64 CoreMask)
+{
+    //
+    // Broadcast to the target cores
+    //
+    BroadcastEnableRdtscExitingOnCores(CoreMask);
+}
+
 /**
  * @brief routines for disabling rdtsc/p exiting
  * @return VOID
@@ -379,6 +507,20 @@ ExtensionCommandDisableRdtscExitingForClearingEventsAllCores()
     BroadcastDisableRdtscExitingForClearingEventsAllCores();
 }
 
+/**
+ * @brief routines ONLY for disabling !tsc command on the target cores
+ * @param CoreMask The mask of target cores
+ * @return VOID
+ */
+VOID
+ExtensionCommandDisableRdtscExitingForClearingEventsOnCores(UINT64 CoreMask)
+{
+    //
+    // Broadcast to the target cores
+    //
+    BroadcastDisableRdtscExitingForClearingEventsOnCores(CoreMask);
+}
+
 /**
  * @brief routines ONLY for disabling !crwrite command
  * @param Event
@@ -398,6 +540,36 @@ ExtensionCommandDisableMov2ControlRegsExitingForClearingEventsAllCores(PDEBUGGER
     BroadcastDisableMov2ControlRegsExitingForClearingEventsAllCores(&BroadcastingOption);
 }
 
+/**
+ * @brief routines for adding a reference of an event to a resource
+ * of the bitmap ownership
+ * @param BroadcastingOption The type, the index and the mask of the resource
+ * @return VOID
+ */
+VOID
+ExtensionCommandAcquireBitmapOwnershipAllCores(PDEBUGGER_BROADCASTING_OPTIONS BroadcastingOption)
+{
+    //
+    // Broadcast to all cores
+    //
+    BroadcastAcquireBitmapOwnershipAllCores(BroadcastingOption);
+}
+
+/**
+ * @brief routines for releasing a reference of an event to a resource
+ * of the bitmap ownership
+ * @param BroadcastingOption The type, the index and the mask of the resource
+ * @return VOID
+ */
+VOID
+ExtensionCommandReleaseBitmapOwnershipAllCores(PDEBUGGER_BROADCASTING_OPTIONS BroadcastingOption)
+{
+    //
+    // Broadcast to all cores
+    //
+    BroadcastReleaseBitmapOwnershipAllCores(BroadcastingOption);
+}
+
 /**
  * @brief routines ONLY for disabling !dr command
  * @return VOID
@@ -425,6 +597,20 @@ ExtensionCommandEnableRdpmcExitingAllCores()
     BroadcastEnableRdpmcExitingAllCores();
 }
 
+/**
+ * @brief routines for !pmc on the target cores
+ * @param CoreMask The mask of target cores
+ * @return VOID
+ */
+VOID
+ExtensionCommandEnableRdpmcExitingOnCores(UINT64 CoreMask)
+{
+    //
+    // Broadcast to the target cores
+    //
+    BroadcastEnableRdpmcExitingOnCores(CoreMask);
+}
+
 /**
  * @brief routines for disabling !pmc
  * @return VOID
@@ -438,6 +624,20 @@ ExtensionCommandDisableRdpmcExitingAllCores()
     BroadcastDisableRdpmcExitingAllCores();
 }
 
+/**
+ * @brief routines for disabling !pmc on the target cores
+ * @param CoreMask The mask of target cores
+ * @return VOID
+ */
+VOID
+ExtensionCommandDisableRdpmcExitingOnCores(UINT64 CoreMask)
+{
+    //
+    // Broadcast to the target cores
+    //
+    BroadcastDisableRdpmcExitingOnCores(CoreMask);
+}
+
 /**
  * @brief routines for !exception command which
  * @details causes vm-exit when exception occurred
@@ -563,6 +763,20 @@ ExtensionCommandSetExternalInterruptExitingAllCores()
     BroadcastSetExternalInterruptExitingAllCores();
 }
 
+/**
+ * @brief routines for !interrupt command on the target cores
+ * @param CoreMask The mask of target cores
+ * @return VOID
+ */
+VOID
+ExtensionCommandSetExternalInterruptExitingOnCores(UINT64 CoreMask)
+{
+    //
+    // Broadcast to the target cores
+    //
+    BroadcastSetExternalInterruptExitingOnCores(CoreMask);
+}
+
 /**
  * @brief routines for ONLY terminate !interrupt command
  * @return VOID
@@ -576,6 +790,20 @@ ExtensionCommandUnsetExternalInterruptExitingOnlyOnClearingInterruptEventsAllCor
     BroadcastUnsetExternalInterruptExitingOnlyOnClearingInterruptEventsAllCores();
 }
 
+/**
+ * @brief routines for ONLY terminate !interrupt command on the target cores
+ * @param CoreMask The mask of target cores
+ * @return VOID
+ */
+VOID
+ExtensionCommandUnsetExternalInterruptExitingOnlyOnClearingInterruptEventsOnCores(UINT64 CoreMask)
+{
+    //
+    // Broadcast to the target cores
+    //
+    BroadcastUnsetExternalInterruptExitingOnlyOnClearingInterruptEventsOnCores(CoreMask);
+}
+
 /**
  * @brief routines for !ioin and !ioout command which
  * @details causes vm-exit on all i/o instructions or one port
@@ -602,3 +830,83 @@ ExtensionCommandIoBitmapResetAllCores()
     //
     BroadcastIoBitmapResetAllCores();
 }
+
+/**
+ * @brief Query the ranges of the physical memory that are backed by RAM
+ * @details the same ranges that the reversing machine reads from the
+ * physical memory map
+ *
+ * @param RamRangesRequest
+ *
+ * @return VOID
+ */
+VOID
+ExtensionCommandQueryPhysicalRamRanges(PDEBUGGER_QUERY_PHYSICAL_RAM_RANGES RamRangesRequest)
+{
+    UINT32 Count = 0;
+
+    while (Count < MaximumPhysicalRamRangesToQuery &&
+           PhysicalMemoryMapGetRange(Count, &RamRangesRequest->Ranges[Count].BaseAddress, &RamRangesRequest->Ranges[Count].Size))
+    {
+        Count++;
+    }
+
+    RamRangesRequest->CountOfRanges = Count;
+    RamRangesRequest->KernelStatus  = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+}
+
+/**
+ * @brief Query the contention of the named spinlocks of the debugger
+ * and the VMM
+ *
+ * @param ContentionRequest
+ *
+ * @return VOID
+ */
+VOID
+ExtensionCommandQuerySpinlockContention(PDEBUGGER_SPINLOCK_CONTENTION_REQUEST ContentionRequest)
+{
+    ContentionRequest->CountOfSites = 0;
+
+#if UseSpinlockContentionInstrumentation == TRUE
+
+    SPINLOCK_SITE                   Site;
+    PSPINLOCK_CONTENTION_STATISTICS Statistics;
+
+    ContentionRequest->IsInstrumentationEnabled = TRUE;
+
+    //
+    // Sites of the debugger
+    //
+    for (UINT32 i = 0; ContentionRequest->CountOfSites < MaximumSpinlockContentionSitesToQuery &&
+                       SpinlockReadContentionSite(i, &Site, ContentionRequest->Reset);
+         i++)
+    {
+        if (!Site.IsRegistered)
+        {
+            continue;
+        }
+
+        Statistics = &ContentionRequest->Sites[ContentionRequest->CountOfSites++];
+
+        RtlStringCchCopyA(Statistics->Name, MaximumSpinlockSiteNameLength, Site.Name);
+
+        Statistics->Acquisitions          = Site.Acquisitions;
+        Statistics->ContendedAcquisitions = Site.ContendedAcquisitions;
+        Statistics->SpinCycles            = Site.SpinCycles;
+        Statistics->MaximumWaitCycles     = Site.MaximumWaitCycles;
+    }
+
+    //
+    // Sites of the VMM
+    //
+    VmFuncQuerySpinlockContention(ContentionRequest);
+
+#else
+
+    ContentionRequest->IsInstrumentationEnabled = FALSE;
+
+#endif
+
+    ContentionRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+}
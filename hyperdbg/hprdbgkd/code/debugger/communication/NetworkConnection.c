@@ -0,0 +1,903 @@
+/**
+ * @file NetworkConnection.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Network connection from debuggee to debugger
+ * @details The debuggee drives a dedicated Intel 8254x or 82574 (e1000)
+ * network adapter in polling mode (without interrupts and without the
+ * Windows network stack), so the adapter can be used in vmx-root while the
+ * system is halted. The frames of the serial connection are sent in UDP
+ * datagrams, only the systems on the same network (without routing) are
+ * supported as the debugger's address is resolved by ARP
+ *
+ * @version 0.4
+ * @date 2023-07-26
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Read a register of the adapter
+ *
+ * @param Offset
+ * @return UINT32
+ */
+static UINT32
+NetworkConnectionReadRegister(UINT32 Offset)
+{
+    return READ_REGISTER_ULONG((volatile ULONG *)(g_NetworkConnection.Registers + Offset));
+}
+
+/**
+ * @brief Write a register of the adapter
+ *
+ * @param Offset
+ * @param Value
+ * @return VOID
+ */
+static VOID
+NetworkConnectionWriteRegister(UINT32 Offset, UINT32 Value)
+{
+    WRITE_REGISTER_ULONG((volatile ULONG *)(g_NetworkConnection.Registers + Offset), Value);
+}
+
+/**
+ * @brief Read a dword from the PCI configuration space
+ *
+ * @param PciAddress Bus, device, and function
+ * @param Offset
+ * @return UINT32
+ */
+static UINT32
+NetworkConnectionReadPciConfig(UINT32 PciAddress, UINT32 Offset)
+{
+    __outdword(PCI_CONFIG_ADDRESS_PORT, 0x80000000 | (PciAddress << 8) | (Offset & 0xfc));
+
+    return __indword(PCI_CONFIG_DATA_PORT);
+}
+
+/**
+ * @brief Write a dword to the PCI configuration space
+ *
+ * @param PciAddress Bus, device, and function
+ * @param Offset
+ * @param Value
+ * @return VOID
+ */
+static VOID
+NetworkConnectionWritePciConfig(UINT32 PciAddress, UINT32 Offset, UINT32 Value)
+{
+    __outdword(PCI_CONFIG_ADDRESS_PORT, 0x80000000 | (PciAddress << 8) | (Offset & 0xfc));
+
+    __outdword(PCI_CONFIG_DATA_PORT, Value);
+}
+
+/**
+ * @brief Check whether the adapter is supported or not
+ *
+ * @param DeviceId
+ * @return BOOLEAN
+ */
+static BOOLEAN
+NetworkConnectionIsSupportedAdapter(UINT16 DeviceId)
+{
+    //
+    // 82540EM (QEMU and VirtualBox), 82545EM/GM and 82546EB (VMware), and 82574L
+    //
+    return DeviceId == 0x100E || DeviceId == 0x100F || DeviceId == 0x1010 ||
+           DeviceId == 0x1011 || DeviceId == 0x1026 || DeviceId == 0x10D3;
+}
+
+/**
+ * @brief Compute the checksum of the header of IPv4 packets
+ *
+ * @param Header
+ * @param Length
+ * @return UINT16
+ */
+static UINT16
+NetworkConnectionComputeIpChecksum(CONST BYTE * Header, UINT32 Length)
+{
+    UINT32 Sum = 0;
+
+    for (UINT32 i = 0; i + 1 < Length; i += 2)
+    {
+        Sum += *(UNALIGNED UINT16 *)&Header[i];
+    }
+
+    while (Sum >> 16)
+    {
+        Sum = (Sum & 0xffff) + (Sum >> 16);
+    }
+
+    return (UINT16)~Sum;
+}
+
+/**
+ * @brief Wait until the next transmit descriptor is free
+ * @details the descriptor after the next descriptor should be free too,
+ * as the tail never reaches the head of the ring (otherwise the ring is
+ * considered as empty by the adapter)
+ *
+ * @return BYTE * buffer of the descriptor
+ */
+static BYTE *
+NetworkConnectionGetTxBuffer()
+{
+    UINT32 Index = g_NetworkConnection.NextTxDescriptor;
+
+    while (!(g_NetworkConnection.TxDescriptors[Index].Status & E1000_DESCRIPTOR_STATUS_DD) ||
+           !(g_NetworkConnection.TxDescriptors[(Index + 1) % NETWORK_CONNECTION_TX_DESCRIPTORS].Status & E1000_DESCRIPTOR_STATUS_DD))
+    {
+        _mm_pause();
+    }
+
+    return &g_NetworkConnection.TxBuffers[g_NetworkConnection.NextTxDescriptor * NETWORK_CONNECTION_BUFFER_SIZE];
+}
+
+/**
+ * @brief Transmit the packet in the buffer of the next transmit descriptor
+ *
+ * @param Length Length of the ethernet packet
+ * @return VOID
+ */
+static VOID
+NetworkConnectionTransmit(UINT32 Length)
+{
+    PE1000_TX_DESCRIPTOR Descriptor = &g_NetworkConnection.TxDescriptors[g_NetworkConnection.NextTxDescriptor];
+
+    Descriptor->Length  = (UINT16)Length;
+    Descriptor->Command = E1000_TX_CMD_EOP | E1000_TX_CMD_IFCS | E1000_TX_CMD_RS;
+    Descriptor->Status  = 0;
+
+    //
+    // The index is moved before passing the descriptor to the adapter, so
+    // if this core is halted here, the other cores don't reuse it
+    //
+    g_NetworkConnection.NextTxDescriptor = (g_NetworkConnection.NextTxDescriptor + 1) % NETWORK_CONNECTION_TX_DESCRIPTORS;
+
+    _mm_sfence();
+
+    NetworkConnectionWriteRegister(E1000_TDT, g_NetworkConnection.NextTxDescriptor);
+}
+
+/**
+ * @brief Send an ARP packet
+ *
+ * @param Operation ARP_OPERATION_REQUEST or ARP_OPERATION_REPLY
+ * @param TargetMac NULL for broadcasting
+ * @param TargetIp
+ * @return VOID
+ */
+static VOID
+NetworkConnectionSendArp(UINT16 Operation, CONST UINT8 * TargetMac, UINT32 TargetIp)
+{
+    PNETWORK_ARP_PACKET Packet = (PNETWORK_ARP_PACKET)NetworkConnectionGetTxBuffer();
+
+    RtlZeroMemory(Packet, ETHERNET_MINIMUM_FRAME_SIZE);
+
+    if (TargetMac == NULL)
+    {
+        RtlFillMemory(Packet->DestinationMac, sizeof(Packet->DestinationMac), 0xff);
+    }
+    else
+    {
+        RtlCopyMemory(Packet->DestinationMac, TargetMac, sizeof(Packet->DestinationMac));
+        RtlCopyMemory(Packet->TargetMac, TargetMac, sizeof(Packet->TargetMac));
+    }
+
+    RtlCopyMemory(Packet->SourceMac, g_NetworkConnection.DebuggeeMac, sizeof(Packet->SourceMac));
+    RtlCopyMemory(Packet->SenderMac, g_NetworkConnection.DebuggeeMac, sizeof(Packet->SenderMac));
+
+    Packet->EtherType      = RtlUshortByteSwap(ETHERNET_TYPE_ARP);
+    Packet->HardwareType   = RtlUshortByteSwap(ARP_HARDWARE_ETHERNET);
+    Packet->ProtocolType   = RtlUshortByteSwap(ETHERNET_TYPE_IPV4);
+    Packet->HardwareLength = 6;
+    Packet->ProtocolLength = 4;
+    Packet->Operation      = RtlUshortByteSwap(Operation);
+    Packet->SenderIp       = g_NetworkConnection.DebuggeeIp;
+    Packet->TargetIp       = TargetIp;
+
+    NetworkConnectionTransmit(ETHERNET_MINIMUM_FRAME_SIZE);
+}
+
+/**
+ * @brief Give back the next receive descriptor to the adapter
+ *
+ * @return VOID
+ */
+static VOID
+NetworkConnectionRecycleRxDescriptor()
+{
+    UINT32 Index = g_NetworkConnection.NextRxDescriptor;
+
+    g_NetworkConnection.RxDescriptors[Index].Status = 0;
+    g_NetworkConnection.NextRxDescriptor            = (Index + 1) % NETWORK_CONNECTION_RX_DESCRIPTORS;
+
+    _mm_sfence();
+
+    NetworkConnectionWriteRegister(E1000_RDT, Index);
+}
+
+/**
+ * @brief Check the next received packet
+ * @details ARP requests are answered, ARP replies of the debugger
+ * are saved, and other packets (that are not sent by the debugger)
+ * are dropped
+ *
+ * @param IsLocked Whether the caller is allowed to send the ARP replies
+ * without the lock of sending responses (the lock is held by the caller
+ * or the system is halted)
+ * @param Datagram The payload of the UDP datagram if the received packet
+ * is a datagram of the debugger
+ * @param DatagramLength
+ *
+ * @return BOOLEAN Returns TRUE if a packet is received (the descriptor
+ * of the datagrams of the debugger should be recycled by the caller,
+ * others are already recycled)
+ */
+static BOOLEAN
+NetworkConnectionReceivePacket(BOOLEAN IsLocked, BYTE ** Datagram, UINT32 * DatagramLength)
+{
+    PE1000_RX_DESCRIPTOR       Descriptor = &g_NetworkConnection.RxDescriptors[g_NetworkConnection.NextRxDescriptor];
+    BYTE *                     Buffer     = &g_NetworkConnection.RxBuffers[g_NetworkConnection.NextRxDescriptor * NETWORK_CONNECTION_BUFFER_SIZE];
+    PNETWORK_UDP_PACKET_HEADER UdpPacket  = (PNETWORK_UDP_PACKET_HEADER)Buffer;
+    PNETWORK_ARP_PACKET        ArpPacket  = (PNETWORK_ARP_PACKET)Buffer;
+    UINT32                     Length;
+    UINT32                     UdpLength;
+
+    *Datagram       = NULL;
+    *DatagramLength = 0;
+
+    if (!(Descriptor->Status & E1000_DESCRIPTOR_STATUS_DD))
+    {
+        return FALSE;
+    }
+
+    _mm_lfence();
+
+    Length = Descriptor->Length;
+
+    if (!(Descriptor->Status & E1000_DESCRIPTOR_STATUS_EOP) || Descriptor->Errors != 0)
+    {
+        //
+        // Invalid (or too long) packet
+        //
+        NetworkConnectionRecycleRxDescriptor();
+        return TRUE;
+    }
+
+    if (Length >= sizeof(NETWORK_ARP_PACKET) &&
+        ArpPacket->EtherType == RtlUshortByteSwap(ETHERNET_TYPE_ARP) &&
+        ArpPacket->TargetIp == g_NetworkConnection.DebuggeeIp)
+    {
+        if (ArpPacket->SenderIp == g_NetworkConnection.DebuggerIp)
+        {
+            RtlCopyMemory(g_NetworkConnection.DebuggerMac, ArpPacket->SenderMac, sizeof(g_NetworkConnection.DebuggerMac));
+        }
+
+        if (ArpPacket->Operation == RtlUshortByteSwap(ARP_OPERATION_REQUEST))
+        {
+            UINT8  SenderMac[6];
+            UINT32 SenderIp = ArpPacket->SenderIp;
+
+            RtlCopyMemory(SenderMac, ArpPacket->SenderMac, sizeof(SenderMac));
+
+            NetworkConnectionRecycleRxDescriptor();
+
+            if (IsLocked)
+            {
+                NetworkConnectionSendArp(ARP_OPERATION_REPLY, SenderMac, SenderIp);
+            }
+            else
+            {
+                ScopedSpinlock(DebuggerResponseLock,
+                               NetworkConnectionSendArp(ARP_OPERATION_REPLY, SenderMac, SenderIp));
+            }
+
+            return TRUE;
+        }
+
+        NetworkConnectionRecycleRxDescriptor();
+        return TRUE;
+    }
+
+    if (Length < sizeof(NETWORK_UDP_PACKET_HEADER) ||
+        UdpPacket->EtherType != RtlUshortByteSwap(ETHERNET_TYPE_IPV4) ||
+        UdpPacket->VersionAndHeaderLength != IPV4_VERSION_IHL ||
+        UdpPacket->Protocol != IPV4_PROTOCOL_UDP ||
+        (UdpPacket->FlagsAndFragmentOffset & RtlUshortByteSwap(0x3fff)) != 0 ||
+        UdpPacket->SourceIp != g_NetworkConnection.DebuggerIp ||
+        UdpPacket->DestinationIp != g_NetworkConnection.DebuggeeIp ||
+        UdpPacket->DestinationPort != g_NetworkConnection.UdpPort)
+    {
+        //
+        // Not a datagram of the debugger
+        //
+        NetworkConnectionRecycleRxDescriptor();
+        return TRUE;
+    }
+
+    UdpLength = RtlUshortByteSwap(UdpPacket->UdpLength);
+
+    if (UdpLength < 8 || FIELD_OFFSET(NETWORK_UDP_PACKET_HEADER, SourcePort) + UdpLength > Length)
+    {
+        NetworkConnectionRecycleRxDescriptor();
+        return TRUE;
+    }
+
+    *Datagram       = Buffer + sizeof(NETWORK_UDP_PACKET_HEADER);
+    *DatagramLength = UdpLength - 8;
+
+    return TRUE;
+}
+
+/**
+ * @brief Send the datagram that is gathered in the buffer of
+ * the next transmit descriptor
+ *
+ * @return VOID
+ */
+VOID
+NetworkConnectionFlush()
+{
+    PNETWORK_UDP_PACKET_HEADER Header;
+    UINT32                     Length = g_NetworkConnection.TxDatagramLength;
+
+    if (Length == 0)
+    {
+        return;
+    }
+
+    Header = (PNETWORK_UDP_PACKET_HEADER)NetworkConnectionGetTxBuffer();
+
+    RtlCopyMemory(Header->DestinationMac, g_NetworkConnection.DebuggerMac, sizeof(Header->DestinationMac));
+    RtlCopyMemory(Header->SourceMac, g_NetworkConnection.DebuggeeMac, sizeof(Header->SourceMac));
+
+    Header->EtherType              = RtlUshortByteSwap(ETHERNET_TYPE_IPV4);
+    Header->VersionAndHeaderLength = IPV4_VERSION_IHL;
+    Header->TypeOfService          = 0;
+    Header->TotalLength            = RtlUshortByteSwap((UINT16)(Length + sizeof(NETWORK_UDP_PACKET_HEADER) - FIELD_OFFSET(NETWORK_UDP_PACKET_HEADER, VersionAndHeaderLength)));
+    Header->Identification         = RtlUshortByteSwap(g_NetworkConnection.IpIdentification++);
+    Header->FlagsAndFragmentOffset = RtlUshortByteSwap(IPV4_FLAG_DONT_FRAG);
+    Header->TimeToLive             = IPV4_DEFAULT_TTL;
+    Header->Protocol               = IPV4_PROTOCOL_UDP;
+    Header->HeaderChecksum         = 0;
+    Header->SourceIp               = g_NetworkConnection.DebuggeeIp;
+    Header->DestinationIp          = g_NetworkConnection.DebuggerIp;
+    Header->SourcePort             = g_NetworkConnection.UdpPort;
+    Header->DestinationPort        = g_NetworkConnection.UdpPort;
+    Header->UdpLength              = RtlUshortByteSwap((UINT16)(Length + 8));
+    Header->UdpChecksum            = 0; // Optional in IPv4 (the frames have their own checksums)
+
+    Header->HeaderChecksum = NetworkConnectionComputeIpChecksum((CONST BYTE *)&Header->VersionAndHeaderLength,
+                                                                FIELD_OFFSET(NETWORK_UDP_PACKET_HEADER, SourcePort) -
+                                                                    FIELD_OFFSET(NETWORK_UDP_PACKET_HEADER, VersionAndHeaderLength));
+
+    g_NetworkConnection.TxDatagramLength = 0;
+
+    NetworkConnectionTransmit((UINT32)max(Length + sizeof(NETWORK_UDP_PACKET_HEADER), ETHERNET_MINIMUM_FRAME_SIZE));
+}
+
+/**
+ * @brief Send bytes over the network
+ * @details the bytes are gathered into datagrams, datagrams are sent
+ * once they're full or the frame is finished (NetworkConnectionFlush)
+ *
+ * @param Buffer
+ * @param Length
+ * @return VOID
+ */
+VOID
+NetworkConnectionSendBytes(CONST BYTE * Buffer, UINT32 Length)
+{
+    UINT32 CopySize;
+    BYTE * Datagram;
+
+    while (Length != 0)
+    {
+        Datagram = NetworkConnectionGetTxBuffer() + sizeof(NETWORK_UDP_PACKET_HEADER);
+        CopySize = NETWORK_CONNECTION_MAXIMUM_DATAGRAM_SIZE - g_NetworkConnection.TxDatagramLength;
+
+        if (CopySize > Length)
+        {
+            CopySize = Length;
+        }
+
+        RtlCopyMemory(&Datagram[g_NetworkConnection.TxDatagramLength], Buffer, CopySize);
+
+        g_NetworkConnection.TxDatagramLength += CopySize;
+        Buffer += CopySize;
+        Length -= CopySize;
+
+        if (g_NetworkConnection.TxDatagramLength == NETWORK_CONNECTION_MAXIMUM_DATAGRAM_SIZE)
+        {
+            NetworkConnectionFlush();
+        }
+    }
+}
+
+/**
+ * @brief Receive a byte over the network in polling mode
+ * @details the caller holds the lock of sending responses or the
+ * system is halted
+ *
+ * @param RecvByte
+ * @return BOOLEAN
+ */
+BOOLEAN
+NetworkConnectionRecvByte(PUCHAR RecvByte)
+{
+    BYTE * Datagram;
+    UINT32 DatagramLength;
+
+    if (!g_NetworkConnection.IsRxDatagramAvailable)
+    {
+        if (!NetworkConnectionReceivePacket(TRUE, &Datagram, &DatagramLength) || Datagram == NULL)
+        {
+            return FALSE;
+        }
+
+        if (DatagramLength == 0)
+        {
+            NetworkConnectionRecycleRxDescriptor();
+            return FALSE;
+        }
+
+        g_NetworkConnection.RxDatagramOffset      = (UINT32)(Datagram - g_NetworkConnection.RxBuffers);
+        g_NetworkConnection.RxDatagramLength      = DatagramLength;
+        g_NetworkConnection.IsRxDatagramAvailable = TRUE;
+    }
+
+    *RecvByte = g_NetworkConnection.RxBuffers[g_NetworkConnection.RxDatagramOffset++];
+
+    if (--g_NetworkConnection.RxDatagramLength == 0)
+    {
+        g_NetworkConnection.IsRxDatagramAvailable = FALSE;
+        NetworkConnectionRecycleRxDescriptor();
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Handle the received packets while the debuggee is running
+ * @details the debugger only sends pause requests while the debuggee is
+ * running, the (user-mode) pause requests are handled here as the
+ * adapter is not visible to the user-mode
+ *
+ * @return VOID
+ */
+static VOID
+NetworkConnectionHandlePacketsWhileRunning()
+{
+    BYTE *                         Datagram;
+    UINT32                         DatagramLength;
+    PDEBUGGER_REMOTE_PACKET        Packet;
+    BOOLEAN                        IsPauseRequested = FALSE;
+    DEBUGGER_PAUSE_PACKET_RECEIVED PausePacket      = {0};
+
+    //
+    // Remove the remaining of the datagram that is not read in the
+    // last halt
+    //
+    if (g_NetworkConnection.IsRxDatagramAvailable)
+    {
+        g_NetworkConnection.IsRxDatagramAvailable = FALSE;
+        NetworkConnectionRecycleRxDescriptor();
+    }
+
+    while (NetworkConnectionReceivePacket(FALSE, &Datagram, &DatagramLength))
+    {
+        if (Datagram == NULL)
+        {
+            continue;
+        }
+
+        //
+        // Each frame of the debugger starts at a new datagram
+        //
+        Packet = (PDEBUGGER_REMOTE_PACKET)(Datagram + sizeof(SERIAL_FRAME_HEADER));
+
+        if (DatagramLength >= sizeof(SERIAL_FRAME_HEADER) + sizeof(DEBUGGER_REMOTE_PACKET) &&
+            SerialConnectionIsValidFrameHeader((PSERIAL_FRAME_HEADER)Datagram) &&
+            Packet->Indicator == INDICATOR_OF_HYPERDBG_PACKET &&
+            Packet->TypeOfThePacket == DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_USER_MODE &&
+            Packet->RequestedActionOfThePacket == DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_USER_MODE_PAUSE)
+        {
+            IsPauseRequested = TRUE;
+        }
+
+        NetworkConnectionRecycleRxDescriptor();
+
+        if (IsPauseRequested)
+        {
+            KdHaltSystem(&PausePacket);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief The thread that polls the adapter while the debuggee is running
+ *
+ * @param Context
+ * @return VOID
+ */
+static VOID
+NetworkConnectionPollingThread(PVOID Context)
+{
+    LARGE_INTEGER Interval = {0};
+
+    UNREFERENCED_PARAMETER(Context);
+
+    Interval.QuadPart = -10000LL * NETWORK_CONNECTION_POLLING_INTERVAL;
+
+    while (!g_NetworkConnectionShouldStop)
+    {
+        NetworkConnectionHandlePacketsWhileRunning();
+
+        KeDelayExecutionThread(KernelMode, FALSE, &Interval);
+    }
+
+    PsTerminateSystemThread(STATUS_SUCCESS);
+}
+
+/**
+ * @brief Reset and initialize the adapter
+ *
+ * @param PciAddress
+ * @return BOOLEAN
+ */
+static BOOLEAN
+NetworkConnectionInitializeAdapter(UINT32 PciAddress)
+{
+    UINT32           VendorDevice;
+    UINT32           Bar0;
+    UINT32           Ral;
+    UINT32           Rah;
+    PHYSICAL_ADDRESS RegistersAddress = {0};
+    PHYSICAL_ADDRESS MaxAddress       = {.QuadPart = MAXULONG64};
+    PHYSICAL_ADDRESS Address;
+    UINT32           i;
+
+    VendorDevice = NetworkConnectionReadPciConfig(PciAddress, PCI_CONFIG_VENDOR_DEVICE);
+
+    if ((VendorDevice & 0xffff) != PCI_VENDOR_INTEL || !NetworkConnectionIsSupportedAdapter((UINT16)(VendorDevice >> 16)))
+    {
+        LogError("Err, the network adapter is not supported (%x)", VendorDevice);
+        return FALSE;
+    }
+
+    //
+    // Registers are memory mapped (BAR0)
+    //
+    Bar0 = NetworkConnectionReadPciConfig(PciAddress, PCI_CONFIG_BAR0);
+
+    if (Bar0 & 0x1)
+    {
+        LogError("Err, the registers of the network adapter are not memory mapped");
+        return FALSE;
+    }
+
+    RegistersAddress.QuadPart = Bar0 & 0xfffffff0;
+
+    if ((Bar0 & 0x6) == 0x4)
+    {
+        //
+        // 64-bit BAR
+        //
+        RegistersAddress.QuadPart |= (UINT64)NetworkConnectionReadPciConfig(PciAddress, PCI_CONFIG_BAR0 + 4) << 32;
+    }
+
+    g_NetworkConnection.RegistersSize = 0x20000;
+    g_NetworkConnection.Registers     = MmMapIoSpace(RegistersAddress, g_NetworkConnection.RegistersSize, MmNonCached);
+
+    if (g_NetworkConnection.Registers == NULL)
+    {
+        return FALSE;
+    }
+
+    //
+    // Enable memory space and bus mastering (DMA)
+    //
+    NetworkConnectionWritePciConfig(PciAddress,
+                                    PCI_CONFIG_COMMAND,
+                                    NetworkConnectionReadPciConfig(PciAddress, PCI_CONFIG_COMMAND) | PCI_COMMAND_MEMORY_SPACE | PCI_COMMAND_BUS_MASTER);
+
+    //
+    // Reset the adapter (interrupts are never used)
+    //
+    NetworkConnectionWriteRegister(E1000_IMC, 0xffffffff);
+    NetworkConnectionWriteRegister(E1000_CTRL, NetworkConnectionReadRegister(E1000_CTRL) | E1000_CTRL_RST);
+
+    KeStallExecutionProcessor(10);
+
+    for (i = 0; i < NETWORK_CONNECTION_RESET_TIMEOUT && (NetworkConnectionReadRegister(E1000_CTRL) & E1000_CTRL_RST); i++)
+    {
+        KeStallExecutionProcessor(1);
+    }
+
+    NetworkConnectionWriteRegister(E1000_IMC, 0xffffffff);
+    NetworkConnectionWriteRegister(E1000_CTRL, NetworkConnectionReadRegister(E1000_CTRL) | E1000_CTRL_SLU | E1000_CTRL_ASDE);
+
+    //
+    // The address of the adapter is loaded from the EEPROM on reset
+    //
+    Ral = NetworkConnectionReadRegister(E1000_RAL0);
+    Rah = NetworkConnectionReadRegister(E1000_RAH0);
+
+    *(UNALIGNED UINT32 *)&g_NetworkConnection.DebuggeeMac[0] = Ral;
+    *(UNALIGNED UINT16 *)&g_NetworkConnection.DebuggeeMac[4] = (UINT16)Rah;
+
+    NetworkConnectionWriteRegister(E1000_RAL0, Ral);
+    NetworkConnectionWriteRegister(E1000_RAH0, (Rah & 0xffff) | E1000_RAH_AV);
+
+    for (i = 0; i < E1000_MTA_ENTRIES; i++)
+    {
+        NetworkConnectionWriteRegister(E1000_MTA + i * sizeof(UINT32), 0);
+    }
+
+    //
+    // Allocate the rings of descriptors and their buffers
+    //
+    g_NetworkConnection.RxDescriptors = MmAllocateContiguousMemory(NETWORK_CONNECTION_RX_DESCRIPTORS * sizeof(E1000_RX_DESCRIPTOR), MaxAddress);
+    g_NetworkConnection.TxDescriptors = MmAllocateContiguousMemory(NETWORK_CONNECTION_TX_DESCRIPTORS * sizeof(E1000_TX_DESCRIPTOR), MaxAddress);
+    g_NetworkConnection.RxBuffers     = MmAllocateContiguousMemory(NETWORK_CONNECTION_RX_DESCRIPTORS * NETWORK_CONNECTION_BUFFER_SIZE, MaxAddress);
+    g_NetworkConnection.TxBuffers     = MmAllocateContiguousMemory(NETWORK_CONNECTION_TX_DESCRIPTORS * NETWORK_CONNECTION_BUFFER_SIZE, MaxAddress);
+
+    if (g_NetworkConnection.RxDescriptors == NULL || g_NetworkConnection.TxDescriptors == NULL ||
+        g_NetworkConnection.RxBuffers == NULL || g_NetworkConnection.TxBuffers == NULL)
+    {
+        LogError("Err, insufficient memory for the network adapter");
+        return FALSE;
+    }
+
+    RtlZeroMemory(g_NetworkConnection.RxDescriptors, NETWORK_CONNECTION_RX_DESCRIPTORS * sizeof(E1000_RX_DESCRIPTOR));
+    RtlZeroMemory(g_NetworkConnection.TxDescriptors, NETWORK_CONNECTION_TX_DESCRIPTORS * sizeof(E1000_TX_DESCRIPTOR));
+
+    for (i = 0; i < NETWORK_CONNECTION_RX_DESCRIPTORS; i++)
+    {
+        g_NetworkConnection.RxDescriptors[i].BufferAddress =
+            MmGetPhysicalAddress(&g_NetworkConnection.RxBuffers[i * NETWORK_CONNECTION_BUFFER_SIZE]).QuadPart;
+    }
+
+    for (i = 0; i < NETWORK_CONNECTION_TX_DESCRIPTORS; i++)
+    {
+        g_NetworkConnection.TxDescriptors[i].BufferAddress =
+            MmGetPhysicalAddress(&g_NetworkConnection.TxBuffers[i * NETWORK_CONNECTION_BUFFER_SIZE]).QuadPart;
+
+        //
+        // Free descriptors
+        //
+        g_NetworkConnection.TxDescriptors[i].Status = E1000_DESCRIPTOR_STATUS_DD;
+    }
+
+    g_NetworkConnection.NextRxDescriptor      = 0;
+    g_NetworkConnection.NextTxDescriptor      = 0;
+    g_NetworkConnection.TxDatagramLength      = 0;
+    g_NetworkConnection.IsRxDatagramAvailable = FALSE;
+
+    //
+    // Receive (2048 bytes buffers, broadcasts for ARP, and strip the CRC)
+    //
+    Address = MmGetPhysicalAddress(g_NetworkConnection.RxDescriptors);
+
+    NetworkConnectionWriteRegister(E1000_RDBAL, Address.LowPart);
+    NetworkConnectionWriteRegister(E1000_RDBAH, Address.HighPart);
+    NetworkConnectionWriteRegister(E1000_RDLEN, NETWORK_CONNECTION_RX_DESCRIPTORS * sizeof(E1000_RX_DESCRIPTOR));
+    NetworkConnectionWriteRegister(E1000_RDH, 0);
+    NetworkConnectionWriteRegister(E1000_RDT, NETWORK_CONNECTION_RX_DESCRIPTORS - 1);
+    NetworkConnectionWriteRegister(E1000_RCTL, E1000_RCTL_EN | E1000_RCTL_BAM | E1000_RCTL_SECRC);
+
+    //
+    // Transmit
+    //
+    Address = MmGetPhysicalAddress(g_NetworkConnection.TxDescriptors);
+
+    NetworkConnectionWriteRegister(E1000_TDBAL, Address.LowPart);
+    NetworkConnectionWriteRegister(E1000_TDBAH, Address.HighPart);
+    NetworkConnectionWriteRegister(E1000_TDLEN, NETWORK_CONNECTION_TX_DESCRIPTORS * sizeof(E1000_TX_DESCRIPTOR));
+    NetworkConnectionWriteRegister(E1000_TDH, 0);
+    NetworkConnectionWriteRegister(E1000_TDT, 0);
+    NetworkConnectionWriteRegister(E1000_TIPG, E1000_TIPG_DEFAULT);
+    NetworkConnectionWriteRegister(E1000_TCTL, E1000_TCTL_EN | E1000_TCTL_PSP | E1000_TCTL_CT | E1000_TCTL_COLD);
+
+    return TRUE;
+}
+
+/**
+ * @brief Resolve the address of the debugger by ARP
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+NetworkConnectionResolveDebugger()
+{
+    static CONST UINT8 ZeroMac[6] = {0};
+    BYTE *             Datagram;
+    UINT32             DatagramLength;
+
+    RtlZeroMemory(g_NetworkConnection.DebuggerMac, sizeof(g_NetworkConnection.DebuggerMac));
+
+    for (UINT32 Retry = 0; Retry < NETWORK_CONNECTION_ARP_RETRIES; Retry++)
+    {
+        ScopedSpinlock(DebuggerResponseLock,
+                       NetworkConnectionSendArp(ARP_OPERATION_REQUEST, NULL, g_NetworkConnection.DebuggerIp));
+
+        for (UINT32 i = 0; i < NETWORK_CONNECTION_ARP_TIMEOUT / 10; i++)
+        {
+            while (NetworkConnectionReceivePacket(FALSE, &Datagram, &DatagramLength))
+            {
+                if (Datagram != NULL)
+                {
+                    NetworkConnectionRecycleRxDescriptor();
+                }
+            }
+
+            if (!RtlEqualMemory(g_NetworkConnection.DebuggerMac, ZeroMac, sizeof(ZeroMac)))
+            {
+                return TRUE;
+            }
+
+            KeStallExecutionProcessor(10);
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Free the resources of the adapter
+ *
+ * @return VOID
+ */
+static VOID
+NetworkConnectionFreeAdapter()
+{
+    if (g_NetworkConnection.Registers != NULL)
+    {
+        //
+        // Stop receiving and transmitting (DMA)
+        //
+        NetworkConnectionWriteRegister(E1000_RCTL, 0);
+        NetworkConnectionWriteRegister(E1000_TCTL, 0);
+
+        KeStallExecutionProcessor(100);
+
+        MmUnmapIoSpace((PVOID)g_NetworkConnection.Registers, g_NetworkConnection.RegistersSize);
+    }
+
+    if (g_NetworkConnection.RxDescriptors != NULL)
+    {
+        MmFreeContiguousMemory(g_NetworkConnection.RxDescriptors);
+    }
+
+    if (g_NetworkConnection.TxDescriptors != NULL)
+    {
+        MmFreeContiguousMemory(g_NetworkConnection.TxDescriptors);
+    }
+
+    if (g_NetworkConnection.RxBuffers != NULL)
+    {
+        MmFreeContiguousMemory(g_NetworkConnection.RxBuffers);
+    }
+
+    if (g_NetworkConnection.TxBuffers != NULL)
+    {
+        MmFreeContiguousMemory(g_NetworkConnection.TxBuffers);
+    }
+
+    RtlZeroMemory(&g_NetworkConnection, sizeof(NETWORK_CONNECTION_STATE));
+}
+
+/**
+ * @brief Prepare the network adapter for the connection to the debugger
+ * @details should be called on vmx non-root (PASSIVE_LEVEL)
+ *
+ * @param DebuggeeRequest Request to prepare debuggee
+ *
+ * @return NTSTATUS
+ */
+NTSTATUS
+NetworkConnectionPrepare(PDEBUGGER_PREPARE_DEBUGGEE DebuggeeRequest)
+{
+    if (g_NetworkConnectionIsEnabled)
+    {
+        NetworkConnectionUninitialize();
+    }
+
+    RtlZeroMemory(&g_NetworkConnection, sizeof(NETWORK_CONNECTION_STATE));
+
+    g_NetworkConnection.DebuggeeIp = DebuggeeRequest->DebuggeeIpAddress;
+    g_NetworkConnection.DebuggerIp = DebuggeeRequest->DebuggerIpAddress;
+    g_NetworkConnection.UdpPort    = RtlUshortByteSwap(DebuggeeRequest->UdpPort);
+
+    if (!NetworkConnectionInitializeAdapter(DebuggeeRequest->NetworkAdapterPciAddress))
+    {
+        NetworkConnectionFreeAdapter();
+
+        DebuggeeRequest->Result = DEBUGGER_ERROR_PREPARING_DEBUGGEE_NETWORK_ADAPTER_NOT_SUPPORTED;
+        return STATUS_UNSUCCESSFUL;
+    }
+
+    if (!NetworkConnectionResolveDebugger())
+    {
+        NetworkConnectionFreeAdapter();
+
+        DebuggeeRequest->Result = DEBUGGER_ERROR_PREPARING_DEBUGGEE_DEBUGGER_NOT_REACHABLE;
+        return STATUS_UNSUCCESSFUL;
+    }
+
+    g_NetworkConnectionIsEnabled = TRUE;
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * @brief Start polling the adapter while the debuggee is running
+ * @details should be called once the kernel debugger is initialized
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+NetworkConnectionStartPolling()
+{
+    HANDLE   ThreadHandle;
+    NTSTATUS Status;
+
+    g_NetworkConnectionShouldStop = FALSE;
+
+    Status = PsCreateSystemThread(&ThreadHandle, THREAD_ALL_ACCESS, NULL, NULL, NULL, NetworkConnectionPollingThread, NULL);
+
+    if (!NT_SUCCESS(Status))
+    {
+        return FALSE;
+    }
+
+    Status = ObReferenceObjectByHandle(ThreadHandle, THREAD_ALL_ACCESS, *PsThreadType, KernelMode, &g_NetworkConnectionPollingThread, NULL);
+
+    if (!NT_SUCCESS(Status))
+    {
+        g_NetworkConnectionShouldStop = TRUE;
+        ZwWaitForSingleObject(ThreadHandle, FALSE, NULL);
+        ZwClose(ThreadHandle);
+
+        g_NetworkConnectionPollingThread = NULL;
+        return FALSE;
+    }
+
+    ZwClose(ThreadHandle);
+
+    return TRUE;
+}
+
+/**
+ * @brief Stop using the network adapter
+ * @details should be called on vmx non-root (PASSIVE_LEVEL)
+ *
+ * @return VOID
+ */
+VOID
+NetworkConnectionUninitialize()
+{
+    if (!g_NetworkConnectionIsEnabled)
+    {
+        return;
+    }
+
+    if (g_NetworkConnectionPollingThread != NULL)
+    {
+        g_NetworkConnectionShouldStop = TRUE;
+
+        KeWaitForSingleObject(g_NetworkConnectionPollingThread, Executive, KernelMode, FALSE, NULL);
+        ObDereferenceObject(g_NetworkConnectionPollingThread);
+
+        g_NetworkConnectionPollingThread = NULL;
+    }
+
+    g_NetworkConnectionIsEnabled = FALSE;
+
+    NetworkConnectionFreeAdapter();
+}
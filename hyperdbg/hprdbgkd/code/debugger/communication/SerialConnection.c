@@ -26,65 +26,265 @@ SerialConnectionTest()
 }
 
 /**
- * @brief Send end of buffer packet
+ * @brief Compute the CRC32 of a buffer
+ * @details the result of a buffer can be passed as the Crc of the
+ * next buffer to compute the CRC32 of not appended buffers
  *
- * @return VOID
+ * @param Crc CRC32 of the previous buffers (zero for the first buffer)
+ * @param Buffer
+ * @param Length
+ * @return UINT32
  */
-VOID
-SerialConnectionSendEndOfBuffer()
+UINT32
+SerialConnectionComputeCrc32(UINT32 Crc, CONST BYTE * Buffer, UINT32 Length)
 {
     //
-    // Send the end buffer
+    // CRC32 (reflected 0xEDB88320 polynomial) of each nibble
+    //
+    static CONST UINT32 Crc32NibbleTable[16] = {
+        0x00000000,
+        0x1DB71064,
+        0x3B6E20C8,
+        0x26D930AC,
+        0x76DC4190,
+        0x6B6B51F4,
+        0x4DB26158,
+        0x5005713C,
+        0xEDB88320,
+        0xF00F9344,
+        0xD6D6A3E8,
+        0xCB61B38C,
+        0x9B64C2B0,
+        0x86D3D2D4,
+        0xA00AE278,
+        0xBDBDF21C};
+
+    Crc = ~Crc;
+
+    for (UINT32 i = 0; i < Length; i++)
+    {
+        Crc ^= Buffer[i];
+        Crc = (Crc >> 4) ^ Crc32NibbleTable[Crc & 0xf];
+        Crc = (Crc >> 4) ^ Crc32NibbleTable[Crc & 0xf];
+    }
+
+    return ~Crc;
+}
+
+/**
+ * @brief Compute the CRC32C of a buffer
+ * @details the crc32 instruction of SSE4.2 is used if it's supported
+ * by the processor, otherwise it's computed in software
+ *
+ * @param Crc CRC32C of the previous buffers (zero for the first buffer)
+ * @param Buffer
+ * @param Length
+ * @return UINT32
+ */
+UINT32
+SerialConnectionComputeCrc32c(UINT32 Crc, CONST BYTE * Buffer, UINT32 Length)
+{
     //
-    KdHyperDbgSendByte(SERIAL_END_OF_BUFFER_CHAR_1, TRUE);
-    KdHyperDbgSendByte(SERIAL_END_OF_BUFFER_CHAR_2, TRUE);
-    KdHyperDbgSendByte(SERIAL_END_OF_BUFFER_CHAR_3, TRUE);
-    KdHyperDbgSendByte(SERIAL_END_OF_BUFFER_CHAR_4, TRUE);
+    // CRC32C (reflected 0x82F63B78 polynomial) of each nibble
+    //
+    static CONST UINT32 Crc32cNibbleTable[16] = {
+        0x00000000,
+        0x105EC76F,
+        0x20BD8EDE,
+        0x30E349B1,
+        0x417B1DBC,
+        0x5125DAD3,
+        0x61C69362,
+        0x7198540D,
+        0x82F63B78,
+        0x92A8FC17,
+        0xA24BB5A6,
+        0xB21572C9,
+        0xC38D26C4,
+        0xD3D3E1AB,
+        0xE330A81A,
+        0xF36E6F75};
+
+    UINT64 Crc64 = (UINT32)~Crc;
+    UINT32 i     = 0;
+
+    if (g_SerialConnectionIsSse42Supported)
+    {
+        //
+        // Use crc32 instruction (only general-purpose registers are
+        // used, so there is no need to save the floating-point state)
+        //
+        for (; i + sizeof(UINT64) <= Length; i += sizeof(UINT64))
+        {
+            Crc64 = _mm_crc32_u64(Crc64, *(UINT64 UNALIGNED *)&Buffer[i]);
+        }
+
+        for (; i < Length; i++)
+        {
+            Crc64 = _mm_crc32_u8((UINT32)Crc64, Buffer[i]);
+        }
+
+        return ~(UINT32)Crc64;
+    }
+
+    Crc = (UINT32)Crc64;
+
+    for (; i < Length; i++)
+    {
+        Crc ^= Buffer[i];
+        Crc = (Crc >> 4) ^ Crc32cNibbleTable[Crc & 0xf];
+        Crc = (Crc >> 4) ^ Crc32cNibbleTable[Crc & 0xf];
+    }
+
+    return ~Crc;
 }
 
 /**
- * @brief compares the buffer with a string
+ * @brief Compute the checksum of a buffer of a frame
  *
- * @param CurrentLoopIndex Number of previously read bytes
+ * @param Flags flags of the frame (shows whether it's CRC32C or CRC32)
+ * @param Crc checksum of the previous buffers (zero for the first buffer)
  * @param Buffer
+ * @param Length
+ * @return UINT32
+ */
+UINT32
+SerialConnectionComputeFrameChecksum(UINT16 Flags, UINT32 Crc, CONST BYTE * Buffer, UINT32 Length)
+{
+    if (Flags & SERIAL_FRAME_FLAG_CRC32C)
+    {
+        return SerialConnectionComputeCrc32c(Crc, Buffer, Length);
+    }
+
+    return SerialConnectionComputeCrc32(Crc, Buffer, Length);
+}
+
+/**
+ * @brief Get the flags of the frames that are sent to the debugger
+ * @details CRC32C is used once the debugger shows that it supports
+ * CRC32C, otherwise CRC32 is used for compatibility
+ *
+ * @return UINT16
+ */
+UINT16
+SerialConnectionGetSendFlags()
+{
+    if (g_SerialConnectionIsPeerCrc32cSupported)
+    {
+        return SERIAL_FRAME_FLAG_CRC32C_SUPPORTED | SERIAL_FRAME_FLAG_CRC32C;
+    }
+
+    return SERIAL_FRAME_FLAG_CRC32C_SUPPORTED;
+}
+
+/**
+ * @brief Check whether the received header of the frame is valid
+ *
+ * @param Header
  * @return BOOLEAN
  */
 BOOLEAN
-SerialConnectionCheckForTheEndOfTheBuffer(PUINT32 CurrentLoopIndex, BYTE * Buffer)
+SerialConnectionIsValidFrameHeader(PSERIAL_FRAME_HEADER Header)
 {
-    UINT32 ActualBufferLength;
+    if (Header->Magic != SERIAL_FRAME_MAGIC || Header->Version != SERIAL_FRAME_VERSION)
+    {
+        return FALSE;
+    }
 
-    ActualBufferLength = *CurrentLoopIndex;
+    if (SerialConnectionComputeFrameChecksum(Header->Flags,
+                                             0,
+                                             (CONST BYTE *)Header,
+                                             FIELD_OFFSET(SERIAL_FRAME_HEADER, HeaderChecksum)) != Header->HeaderChecksum)
+    {
+        return FALSE;
+    }
 
     //
-    // End of buffer is 4 character long
+    // We already now that the maximum packet size is MaxSerialPacketSize
     //
-    if (*CurrentLoopIndex <= 3)
+    if (Header->Length > MaxSerialPacketSize)
     {
         return FALSE;
     }
 
-    if (Buffer[ActualBufferLength] == SERIAL_END_OF_BUFFER_CHAR_4 &&
-        Buffer[ActualBufferLength - 1] == SERIAL_END_OF_BUFFER_CHAR_3 &&
-        Buffer[ActualBufferLength - 2] == SERIAL_END_OF_BUFFER_CHAR_2 &&
-        Buffer[ActualBufferLength - 3] == SERIAL_END_OF_BUFFER_CHAR_1)
-    {
-        //
-        // Clear the end character
-        //
-        Buffer[ActualBufferLength - 3] = NULL;
-        Buffer[ActualBufferLength - 2] = NULL;
-        Buffer[ActualBufferLength - 1] = NULL;
-        Buffer[ActualBufferLength]     = NULL;
+    return TRUE;
+}
 
-        //
-        // Set the new length
-        //
-        *CurrentLoopIndex = ActualBufferLength - 3;
+/**
+ * @brief Send the header of a frame
+ *
+ * @param IsBulkLink whether the frame is sent over the bulk link
+ * @param Flags flags of the frame
+ * @param Length length of the payload
+ * @param PayloadChecksum checksum of the payload
+ * @return VOID
+ */
+VOID
+SerialConnectionSendFrameHeader(BOOLEAN IsBulkLink, UINT16 Flags, UINT32 Length, UINT32 PayloadChecksum)
+{
+    SERIAL_FRAME_HEADER     Header = {0};
+    PSERIAL_CONNECTION_LINK Link   = IsBulkLink ? &g_SerialConnectionBulkLink : &g_SerialConnectionControlLink;
+
+    Header.Magic           = SERIAL_FRAME_MAGIC;
+    Header.Version         = SERIAL_FRAME_VERSION;
+    Header.Flags           = Flags;
+    Header.Length          = Length;
+    Header.SequenceNumber  = Link->SendSequenceNumber++;
+    Header.PayloadChecksum = PayloadChecksum;
+    Header.HeaderChecksum  = SerialConnectionComputeFrameChecksum(Flags,
+                                                                  0,
+                                                                  (CONST BYTE *)&Header,
+                                                                  FIELD_OFFSET(SERIAL_FRAME_HEADER, HeaderChecksum));
+
+    SerialConnectionSendBytes(IsBulkLink, (CONST BYTE *)&Header, sizeof(SERIAL_FRAME_HEADER));
+}
 
-        return TRUE;
+/**
+ * @brief Receive the exact count of bytes in polling mode
+ *
+ * @param Buffer
+ * @param Length
+ * @return VOID
+ */
+VOID
+SerialConnectionRecvBytes(BYTE * Buffer, UINT32 Length)
+{
+    UINT32 Loop = 0;
+
+    while (Loop < Length)
+    {
+        if (g_NetworkConnectionIsEnabled)
+        {
+            if (NetworkConnectionRecvByte(&Buffer[Loop]))
+            {
+                Loop++;
+            }
+        }
+        else
+        {
+            //
+            // Receive the bytes that are already in the FIFO of the UART
+            //
+            Loop += KdHyperDbgRecvBuffer(&Buffer[Loop], Length - Loop);
+        }
     }
-    return FALSE;
+}
+
+/**
+ * @brief Receive one byte if it's already received (without waiting)
+ *
+ * @param Byte
+ * @return BOOLEAN Whether the byte is received or not
+ */
+BOOLEAN
+SerialConnectionTryRecvByte(BYTE * Byte)
+{
+    if (g_NetworkConnectionIsEnabled)
+    {
+        return NetworkConnectionRecvByte(Byte);
+    }
+
+    return KdHyperDbgRecvBuffer(Byte, 1) != 0;
 }
 
 /**
@@ -92,141 +292,378 @@ SerialConnectionCheckForTheEndOfTheBuffer(PUINT32 CurrentLoopIndex, BYTE * Buffe
  *
  * @param BufferToSave
  * @param LengthReceived
+ * @param Deadline The time-stamp counter that stops waiting for the start
+ * of the packet (zero for waiting without any deadline)
  *
- * @return BOOLEAN
+ * @return BOOLEAN FALSE if the packet is invalid or nothing is received
+ * before the deadline
  */
 BOOLEAN
 SerialConnectionRecvBuffer(CHAR *   BufferToSave,
-                           UINT32 * LengthReceived)
+                           UINT32 * LengthReceived,
+                           UINT64   Deadline)
 {
-    UINT32 Loop = 0;
+    SERIAL_FRAME_HEADER Header        = {0};
+    UINT32              ReceivedBytes = 0;
 
     //
-    // Read data and store in a buffer
+    // Wait for the first byte of the frame until the deadline, the rest
+    // of the frame is received without any deadline
+    //
+    if (Deadline != 0)
+    {
+        while (!SerialConnectionTryRecvByte((BYTE *)&Header))
+        {
+            if (__rdtsc() >= Deadline)
+            {
+                *LengthReceived = 0;
+                return FALSE;
+            }
+        }
+
+        ReceivedBytes = 1;
+    }
+
+    //
+    // Receive the header of the frame
     //
     while (TRUE)
     {
-        UCHAR RecvChar = NULL;
+        SerialConnectionRecvBytes((BYTE *)&Header + ReceivedBytes, sizeof(SERIAL_FRAME_HEADER) - ReceivedBytes);
 
-        if (!KdHyperDbgRecvByte(&RecvChar))
+        if (SerialConnectionIsValidFrameHeader(&Header))
         {
-            continue;
+            break;
         }
 
         //
-        // We already now that the maximum packet size is MaxSerialPacketSize
-        // Check to make sure that we don't pass the boundaries
+        // Not a valid header, skip one byte and search for the
+        // next magic in the bytes that are already received
         //
-        if (!(MaxSerialPacketSize > Loop))
-        {
-            //
-            // Invalid buffer (size of buffer exceeds the limitation)
-            //
-            LogError("Err, a buffer received in debuggee which exceeds the buffer limitation");
-            return FALSE;
-        }
+        RtlMoveMemory(&Header, (BYTE *)&Header + 1, sizeof(SERIAL_FRAME_HEADER) - 1);
+        ReceivedBytes = sizeof(SERIAL_FRAME_HEADER) - 1;
+    }
 
-        BufferToSave[Loop] = RecvChar;
+    //
+    // Receive exactly the length of the payload
+    //
+    SerialConnectionRecvBytes((BYTE *)BufferToSave, Header.Length);
 
-        if (SerialConnectionCheckForTheEndOfTheBuffer(&Loop, (BYTE *)BufferToSave))
-        {
-            break;
-        }
+    if (SerialConnectionComputeFrameChecksum(Header.Flags,
+                                             0,
+                                             (CONST BYTE *)BufferToSave,
+                                             Header.Length) != Header.PayloadChecksum)
+    {
+        //
+        // Invalid buffer (the payload is corrupted)
+        //
+        LogError("Err, corrupted buffer received in debuggee (sequence number: %x)", Header.SequenceNumber);
+        return FALSE;
+    }
 
-        Loop++;
+    //
+    // The debugger accepts CRC32C and compressed frames
+    //
+    if (Header.Flags & SERIAL_FRAME_FLAG_CRC32C_SUPPORTED)
+    {
+        g_SerialConnectionIsPeerCrc32cSupported = TRUE;
+    }
+
+    if (Header.Flags & SERIAL_FRAME_FLAG_COMPRESSION_SUPPORTED)
+    {
+        g_SerialConnectionIsPeerDecompressionSupported = TRUE;
     }
 
     //
     // Set the length
     //
-    *LengthReceived = Loop;
+    *LengthReceived = Header.Length;
 
     return TRUE;
 }
 
 /**
- * @brief Perform sending buffer over serial
+ * @brief Compress a buffer in the LZ4 block format
+ * @details it's safe to be called in vmx-root as there is no allocation
+ * and the hash table is the global table of the link (the callers hold
+ * the lock of sending responses of the link), only used for buffers
+ * smaller than 64 KB
  *
- * @param Buffer buffer to send
- * @param Length length of buffer to send
- * @return BOOLEAN
+ * @param HashTable
+ * @param Source
+ * @param SourceLength
+ * @param Destination
+ * @param DestinationCapacity
+ * @return UINT32 length of the compressed buffer or zero if the result
+ * is not smaller than the capacity
  */
-BOOLEAN
-SerialConnectionSend(CHAR * Buffer, UINT32 Length)
+UINT32
+SerialConnectionCompress(UINT16 *     HashTable,
+                         CONST BYTE * Source,
+                         UINT32       SourceLength,
+                         BYTE *       Destination,
+                         UINT32       DestinationCapacity)
 {
-    //
-    // Check if buffer not pass the boundary
-    //
-    if (Length + SERIAL_END_OF_BUFFER_CHARS_COUNT > MaxSerialPacketSize)
+    UINT32   Ip        = 0;
+    UINT32   Op        = 0;
+    UINT32   Anchor    = 0;
+    UINT32   Reference = 0;
+    UINT32   Sequence  = 0;
+    UINT32   Hash      = 0;
+    UINT32   MatchLength;
+    UINT32   LiteralLength;
+    UINT32   Remaining;
+    UINT32   TokenIndex;
+
+    if (SourceLength > MAXUINT16)
     {
-        LogError("Err, buffer is above the maximum buffer size that can be sent to debuggee (%d > %d), "
-                 "for more information, please visit https://docs.hyperdbg.org/tips-and-tricks/misc/increase-communication-buffer-size",
-                 Length + SERIAL_END_OF_BUFFER_CHARS_COUNT,
-                 MaxSerialPacketSize);
-        return FALSE;
+        return 0;
     }
 
-    for (size_t i = 0; i < Length; i++)
+    RtlZeroMemory(HashTable, sizeof(UINT16) << SERIAL_COMPRESSION_HASH_LOG);
+
+    //
+    // The last match should start at least 12 bytes before the end of
+    // the buffer and the last 5 bytes are always literals
+    //
+    while (Ip + SERIAL_COMPRESSION_MATCH_FIND_LIMIT <= SourceLength)
     {
-        KdHyperDbgSendByte(Buffer[i], TRUE);
+        Sequence        = *(UNALIGNED UINT32 *)&Source[Ip];
+        Hash            = (Sequence * 2654435761U) >> (32 - SERIAL_COMPRESSION_HASH_LOG);
+        Reference       = HashTable[Hash];
+        HashTable[Hash] = (UINT16)Ip;
+
+        if (Reference >= Ip || *(UNALIGNED UINT32 *)&Source[Reference] != Sequence)
+        {
+            Ip++;
+            continue;
+        }
+
+        MatchLength = SERIAL_COMPRESSION_MIN_MATCH;
+
+        while (Ip + MatchLength < SourceLength - SERIAL_COMPRESSION_LAST_LITERALS &&
+               Source[Reference + MatchLength] == Source[Ip + MatchLength])
+        {
+            MatchLength++;
+        }
+
+        LiteralLength = Ip - Anchor;
+
+        //
+        // Token, length of literals, literals, offset and length of the match
+        //
+        if (Op + 1 + LiteralLength / 255 + 1 + LiteralLength + 2 + MatchLength / 255 + 1 > DestinationCapacity)
+        {
+            return 0;
+        }
+
+        TokenIndex = Op++;
+
+        if (LiteralLength >= 15)
+        {
+            Destination[TokenIndex] = 15 << 4;
+
+            for (Remaining = LiteralLength - 15; Remaining >= 255; Remaining -= 255)
+            {
+                Destination[Op++] = 255;
+            }
+
+            Destination[Op++] = (BYTE)Remaining;
+        }
+        else
+        {
+            Destination[TokenIndex] = (BYTE)(LiteralLength << 4);
+        }
+
+        RtlCopyMemory(&Destination[Op], &Source[Anchor], LiteralLength);
+        Op += LiteralLength;
+
+        Destination[Op++] = (BYTE)(Ip - Reference);
+        Destination[Op++] = (BYTE)((Ip - Reference) >> 8);
+
+        if (MatchLength - SERIAL_COMPRESSION_MIN_MATCH >= 15)
+        {
+            Destination[TokenIndex] |= 15;
+
+            for (Remaining = MatchLength - SERIAL_COMPRESSION_MIN_MATCH - 15; Remaining >= 255; Remaining -= 255)
+            {
+                Destination[Op++] = 255;
+            }
+
+            Destination[Op++] = (BYTE)Remaining;
+        }
+        else
+        {
+            Destination[TokenIndex] |= (BYTE)(MatchLength - SERIAL_COMPRESSION_MIN_MATCH);
+        }
+
+        Ip += MatchLength;
+        Anchor = Ip;
     }
 
     //
-    // Send the end buffer
+    // The last literals
     //
-    SerialConnectionSendEndOfBuffer();
+    LiteralLength = SourceLength - Anchor;
 
-    return TRUE;
+    if (Op + 1 + LiteralLength / 255 + 1 + LiteralLength > DestinationCapacity)
+    {
+        return 0;
+    }
+
+    TokenIndex = Op++;
+
+    if (LiteralLength >= 15)
+    {
+        Destination[TokenIndex] = 15 << 4;
+
+        for (Remaining = LiteralLength - 15; Remaining >= 255; Remaining -= 255)
+        {
+            Destination[Op++] = 255;
+        }
+
+        Destination[Op++] = (BYTE)Remaining;
+    }
+    else
+    {
+        Destination[TokenIndex] = (BYTE)(LiteralLength << 4);
+    }
+
+    RtlCopyMemory(&Destination[Op], &Source[Anchor], LiteralLength);
+    Op += LiteralLength;
+
+    return Op;
 }
 
 /**
- * @brief Perform sending 2 not appended buffers over serial
+ * @brief Send bytes over serial
+ * @details the bytes are written to the FIFO of the port in bursts, and
+ * they are sent over the network if the debuggee is connected over the
+ * network
  *
+ * @param IsBulkLink whether the bytes are sent over the bulk link
+ * @param Buffer
+ * @param Length
+ * @return VOID
+ */
+VOID
+SerialConnectionSendBytes(BOOLEAN IsBulkLink, CONST BYTE * Buffer, UINT32 Length)
+{
+    if (IsBulkLink)
+    {
+        KdHyperDbgSendBulkBuffer(Buffer, Length);
+        return;
+    }
+
+    if (g_NetworkConnectionIsEnabled)
+    {
+        NetworkConnectionSendBytes(Buffer, Length);
+        return;
+    }
+
+    KdHyperDbgSendBuffer(Buffer, Length);
+}
+
+/**
+ * @brief Send a compressed frame if the buffers are compressible
+ * @details the payload of compressed frames is the length of the
+ * uncompressed data (UINT32) followed by the LZ4 block
+ *
+ * @param IsBulkLink whether the frame is sent over the bulk link
  * @param Buffer1 buffer to send
  * @param Length1 length of buffer to send
  * @param Buffer2 buffer to send
  * @param Length2 length of buffer to send
- * @return BOOLEAN
+ * @param Buffer3 buffer to send
+ * @param Length3 length of buffer to send
+ * @return BOOLEAN whether the compressed frame is sent or not
  */
 BOOLEAN
-SerialConnectionSendTwoBuffers(CHAR * Buffer1, UINT32 Length1, CHAR * Buffer2, UINT32 Length2)
+SerialConnectionSendCompressedFrame(BOOLEAN IsBulkLink,
+                                    CHAR *  Buffer1,
+                                    UINT32  Length1,
+                                    CHAR *  Buffer2,
+                                    UINT32  Length2,
+                                    CHAR *  Buffer3,
+                                    UINT32  Length3)
 {
-    //
-    // Check if buffer not pass the boundary
-    //
-    if ((Length1 + Length2 + SERIAL_END_OF_BUFFER_CHARS_COUNT) > MaxSerialPacketSize)
+    UINT16                  Flags            = SerialConnectionGetSendFlags() | SERIAL_FRAME_FLAG_COMPRESSED;
+    UINT32                  Length           = Length1 + Length2 + Length3;
+    UINT32                  CompressedLength = 0;
+    PSERIAL_CONNECTION_LINK Link             = IsBulkLink ? &g_SerialConnectionBulkLink : &g_SerialConnectionControlLink;
+
+    if (!g_SerialConnectionIsPeerDecompressionSupported || Length < SERIAL_COMPRESSION_THRESHOLD)
     {
-        LogError("Err, buffer is above the maximum buffer size that can be sent to debuggee (%d > %d), "
-                 "for more information, please visit https://docs.hyperdbg.org/tips-and-tricks/misc/increase-communication-buffer-size",
-                 Length1 + Length2 + SERIAL_END_OF_BUFFER_CHARS_COUNT,
-                 MaxSerialPacketSize);
         return FALSE;
     }
 
     //
-    // Send first buffer
+    // Gather the buffers as the compressor needs a contiguous buffer
     //
-    for (size_t i = 0; i < Length1; i++)
-    {
-        KdHyperDbgSendByte(Buffer1[i], TRUE);
-    }
+    RtlCopyMemory(&Link->UncompressedBuffer[0], Buffer1, Length1);
+    RtlCopyMemory(&Link->UncompressedBuffer[Length1], Buffer2, Length2);
+    RtlCopyMemory(&Link->UncompressedBuffer[Length1 + Length2], Buffer3, Length3);
 
     //
-    // Send second buffer
+    // It's sent uncompressed if it's not smaller than the original buffers
     //
-    for (size_t i = 0; i < Length2; i++)
+    CompressedLength = SerialConnectionCompress(Link->CompressionHashTable,
+                                                Link->UncompressedBuffer,
+                                                Length,
+                                                &Link->CompressedBuffer[sizeof(UINT32)],
+                                                Length - sizeof(UINT32) - 1);
+
+    if (CompressedLength == 0)
     {
-        KdHyperDbgSendByte(Buffer2[i], TRUE);
+        return FALSE;
     }
 
-    //
-    // Send the end buffer
-    //
-    SerialConnectionSendEndOfBuffer();
+    *(UINT32 *)&Link->CompressedBuffer[0] = Length;
+    CompressedLength += sizeof(UINT32);
+
+    SerialConnectionSendFrameHeader(IsBulkLink,
+                                    Flags,
+                                    CompressedLength,
+                                    SerialConnectionComputeFrameChecksum(Flags, 0, Link->CompressedBuffer, CompressedLength));
+
+    SerialConnectionSendBytes(IsBulkLink, Link->CompressedBuffer, CompressedLength);
+
+    if (!IsBulkLink && g_NetworkConnectionIsEnabled)
+    {
+        NetworkConnectionFlush();
+    }
 
     return TRUE;
 }
 
+/**
+ * @brief Perform sending buffer over serial
+ *
+ * @param Buffer buffer to send
+ * @param Length length of buffer to send
+ * @return BOOLEAN
+ */
+BOOLEAN
+SerialConnectionSend(CHAR * Buffer, UINT32 Length)
+{
+    return SerialConnectionSendThreeBuffers(Buffer, Length, NULL, 0, NULL, 0);
+}
+
+/**
+ * @brief Perform sending 2 not appended buffers over serial
+ *
+ * @param Buffer1 buffer to send
+ * @param Length1 length of buffer to send
+ * @param Buffer2 buffer to send
+ * @param Length2 length of buffer to send
+ * @return BOOLEAN
+ */
+BOOLEAN
+SerialConnectionSendTwoBuffers(CHAR * Buffer1, UINT32 Length1, CHAR * Buffer2, UINT32 Length2)
+{
+    return SerialConnectionSendThreeBuffers(Buffer1, Length1, Buffer2, Length2, NULL, 0);
+}
+
 /**
  * @brief Perform sending 3 not appended buffers over serial
  *
@@ -246,46 +683,107 @@ SerialConnectionSendThreeBuffers(CHAR * Buffer1,
                                  CHAR * Buffer3,
                                  UINT32 Length3)
 {
+    return SerialConnectionSendFrame(FALSE, Buffer1, Length1, Buffer2, Length2, Buffer3, Length3);
+}
+
+/**
+ * @brief Perform sending 3 not appended buffers over the bulk link
+ * @details the buffers are sent over the control link if the bulk link
+ * is not enabled, the caller should hold the lock of sending bulk
+ * responses if the bulk link is enabled
+ *
+ * @param Buffer1 buffer to send
+ * @param Length1 length of buffer to send
+ * @param Buffer2 buffer to send
+ * @param Length2 length of buffer to send
+ * @param Buffer3 buffer to send
+ * @param Length3 length of buffer to send
+ * @return BOOLEAN
+ */
+BOOLEAN
+SerialConnectionSendBulkThreeBuffers(CHAR * Buffer1,
+                                     UINT32 Length1,
+                                     CHAR * Buffer2,
+                                     UINT32 Length2,
+                                     CHAR * Buffer3,
+                                     UINT32 Length3)
+{
+    return SerialConnectionSendFrame(g_SerialConnectionIsBulkLinkEnabled,
+                                     Buffer1,
+                                     Length1,
+                                     Buffer2,
+                                     Length2,
+                                     Buffer3,
+                                     Length3);
+}
+
+/**
+ * @brief Send 3 not appended buffers as a single frame over a link
+ *
+ * @param IsBulkLink whether the frame is sent over the bulk link
+ * @param Buffer1 buffer to send
+ * @param Length1 length of buffer to send
+ * @param Buffer2 buffer to send
+ * @param Length2 length of buffer to send
+ * @param Buffer3 buffer to send
+ * @param Length3 length of buffer to send
+ * @return BOOLEAN
+ */
+BOOLEAN
+SerialConnectionSendFrame(BOOLEAN IsBulkLink,
+                          CHAR *  Buffer1,
+                          UINT32  Length1,
+                          CHAR *  Buffer2,
+                          UINT32  Length2,
+                          CHAR *  Buffer3,
+                          UINT32  Length3)
+{
+    UINT16 Flags = SerialConnectionGetSendFlags();
+    UINT32 Crc   = 0;
+
     //
     // Check if buffer not pass the boundary
     //
-    if ((Length1 + Length2 + Length3 + SERIAL_END_OF_BUFFER_CHARS_COUNT) > MaxSerialPacketSize)
+    if ((Length1 + Length2 + Length3) > MaxSerialPacketSize)
     {
         LogError("Err, buffer is above the maximum buffer size that can be sent to debuggee (%d > %d), "
                  "for more information, please visit https://docs.hyperdbg.org/tips-and-tricks/misc/increase-communication-buffer-size",
-                 Length1 + Length2 + Length3 + SERIAL_END_OF_BUFFER_CHARS_COUNT,
+                 Length1 + Length2 + Length3,
                  MaxSerialPacketSize);
         return FALSE;
     }
 
     //
-    // Send first buffer
+    // Large buffers are compressed if the debugger supports it
     //
-    for (size_t i = 0; i < Length1; i++)
+    if (SerialConnectionSendCompressedFrame(IsBulkLink, Buffer1, Length1, Buffer2, Length2, Buffer3, Length3))
     {
-        KdHyperDbgSendByte(Buffer1[i], TRUE);
+        return TRUE;
     }
 
     //
-    // Send second buffer
+    // Send the header of the frame
     //
-    for (size_t i = 0; i < Length2; i++)
-    {
-        KdHyperDbgSendByte(Buffer2[i], TRUE);
-    }
+    Crc = SerialConnectionComputeFrameChecksum(Flags, Crc, (CONST BYTE *)Buffer1, Length1);
+    Crc = SerialConnectionComputeFrameChecksum(Flags, Crc, (CONST BYTE *)Buffer2, Length2);
+    Crc = SerialConnectionComputeFrameChecksum(Flags, Crc, (CONST BYTE *)Buffer3, Length3);
+
+    SerialConnectionSendFrameHeader(IsBulkLink, Flags, Length1 + Length2 + Length3, Crc);
 
     //
-    // Send third buffer
+    // Send the buffers
     //
-    for (size_t i = 0; i < Length3; i++)
-    {
-        KdHyperDbgSendByte(Buffer3[i], TRUE);
-    }
+    SerialConnectionSendBytes(IsBulkLink, (CONST BYTE *)Buffer1, Length1);
+    SerialConnectionSendBytes(IsBulkLink, (CONST BYTE *)Buffer2, Length2);
+    SerialConnectionSendBytes(IsBulkLink, (CONST BYTE *)Buffer3, Length3);
 
     //
-    // Send the end buffer
+    // Each frame is sent in separate datagrams over the network
     //
-    SerialConnectionSendEndOfBuffer();
+    if (!IsBulkLink && g_NetworkConnectionIsEnabled)
+    {
+        NetworkConnectionFlush();
+    }
 
     return TRUE;
 }
@@ -305,7 +803,8 @@ SerialConnectionCheckBaudrate(DWORD Baudrate)
         Baudrate == CBR_9600 || Baudrate == CBR_14400 || Baudrate == CBR_19200 ||
         Baudrate == CBR_38400 || Baudrate == CBR_56000 || Baudrate == CBR_57600 ||
         Baudrate == CBR_115200 || Baudrate == CBR_128000 ||
-        Baudrate == CBR_256000)
+        Baudrate == CBR_230400 || Baudrate == CBR_256000 ||
+        Baudrate == CBR_460800 || Baudrate == CBR_921600)
     {
         return TRUE;
     }
@@ -340,10 +839,19 @@ SerialConnectionCheckPort(UINT32 SerialPort)
 NTSTATUS
 SerialConnectionPrepare(PDEBUGGER_PREPARE_DEBUGGEE DebuggeeRequest)
 {
-    //
-    // Check if baud rate is valid or not
-    //
-    if (!SerialConnectionCheckBaudrate(DebuggeeRequest->Baudrate))
+    INT32 CpuInfo[4] = {0};
+
+    if (DebuggeeRequest->IsNetwork)
+    {
+        //
+        // Prepare the network adapter instead of the serial port
+        //
+        if (!NT_SUCCESS(NetworkConnectionPrepare(DebuggeeRequest)))
+        {
+            return STATUS_UNSUCCESSFUL;
+        }
+    }
+    else if (!SerialConnectionCheckBaudrate(DebuggeeRequest->Baudrate))
     {
         //
         // Baud rate is invalid, set the status and return
@@ -355,7 +863,7 @@ SerialConnectionPrepare(PDEBUGGER_PREPARE_DEBUGGEE DebuggeeRequest)
     //
     // Check if port address is valid or not
     //
-    if (!SerialConnectionCheckPort(DebuggeeRequest->PortAddress))
+    else if (!SerialConnectionCheckPort(DebuggeeRequest->PortAddress))
     {
         //
         // Port address is invalid, set the status and return
@@ -364,16 +872,64 @@ SerialConnectionPrepare(PDEBUGGER_PREPARE_DEBUGGEE DebuggeeRequest)
         return STATUS_UNSUCCESSFUL;
     }
 
+    else
+    {
+        //
+        // Prepare the structures needed for connecting remote port
+        //
+        KdHyperDbgPrepareDebuggeeConnectionPort(DebuggeeRequest->PortAddress, DebuggeeRequest->Baudrate);
+    }
+
+    //
+    // The bulk data is sent over a second serial port (if it's specified),
+    // so the responses of the control link are not delayed by large transfers
+    //
+    g_SerialConnectionIsBulkLinkEnabled = FALSE;
+
+    if (DebuggeeRequest->BulkPortAddress != NULL)
+    {
+        if (DebuggeeRequest->IsNetwork ||
+            DebuggeeRequest->BulkPortAddress == DebuggeeRequest->PortAddress ||
+            !SerialConnectionCheckPort(DebuggeeRequest->BulkPortAddress))
+        {
+            DebuggeeRequest->Result = DEBUGGER_ERROR_PREPARING_DEBUGGEE_INVALID_SERIAL_PORT;
+            return STATUS_UNSUCCESSFUL;
+        }
+
+        KdHyperDbgPrepareDebuggeeBulkConnectionPort(DebuggeeRequest->BulkPortAddress, DebuggeeRequest->Baudrate);
+
+        g_SerialConnectionIsBulkLinkEnabled = TRUE;
+    }
+
+    //
+    // Check whether the crc32 instruction (SSE4.2) is supported, CRC32C is
+    // used once the debugger shows that it supports CRC32C frames
+    //
+    __cpuid(CpuInfo, 1);
+
+    g_SerialConnectionIsSse42Supported      = (CpuInfo[2] & (1 << 20)) ? TRUE : FALSE;
+    g_SerialConnectionIsPeerCrc32cSupported = FALSE;
+
     //
-    // Prepare the structures needed for connecting remote port
+    // Large responses are compressed once the debugger shows that it
+    // supports compressed frames
     //
-    KdHyperDbgPrepareDebuggeeConnectionPort(DebuggeeRequest->PortAddress, DebuggeeRequest->Baudrate);
+    g_SerialConnectionIsPeerDecompressionSupported = FALSE;
 
     //
     // Initialize kernel debugger
     //
     KdInitializeKernelDebugger();
 
+    //
+    // Pause requests are received by polling the network adapter
+    // while the debuggee is running
+    //
+    if (DebuggeeRequest->IsNetwork && !NetworkConnectionStartPolling())
+    {
+        LogWarning("Warning, the debuggee cannot be paused from the debugger while it's running");
+    }
+
     //
     // Send "Start" packet along with Windows Name
     //
@@ -66,6 +66,12 @@ DebuggerInitialize()
         return FALSE;
     }
 
+    //
+    // Initialize the slab caches of the events and the actions
+    //
+    SlabCacheInitialize(&g_EventsSlabCache, sizeof(DEBUGGER_EVENT));
+    SlabCacheInitialize(&g_ActionsSlabCache, sizeof(DEBUGGER_EVENT_ACTION));
+
     //
     // Allocate buffer for saving events
     //
@@ -74,6 +80,14 @@ DebuggerInitialize()
         return FALSE;
     }
 
+    //
+    // Allocate buffer for the lookup index of events
+    //
+    if (GlobalEventsIndexAllocateZeroedMemory() == FALSE)
+    {
+        return FALSE;
+    }
+
     //
     // Set the core's IDs
     //
@@ -82,6 +96,12 @@ DebuggerInitialize()
         g_DbgState[i].CoreId = i;
     }
 
+    //
+    // No control of the events is pending (the cores have not applied
+    // any of them yet)
+    //
+    RtlZeroMemory(&g_EventsPendingControls, sizeof(DEBUGGER_EVENTS_PENDING_CONTROLS));
+
     //
     // Initialize lists relating to the debugger events store
     //
@@ -108,6 +128,12 @@ DebuggerInitialize()
     InitializeListHead(&g_Events->ExternalInterruptOccurredEventsHead);
     InitializeListHead(&g_Events->VmcallInstructionExecutionEventsHead);
     InitializeListHead(&g_Events->ControlRegisterModifiedEventsHead);
+    InitializeListHead(&g_Events->PageFirstExecutionEventsHead);
+
+    //
+    // Initialize lists relating to the lookup index of events
+    //
+    DebuggerEventsIndexInitialize();
 
     //
     // Enabled Debugger Events
@@ -124,6 +150,11 @@ DebuggerInitialize()
     //
     VmFuncSetTriggerEventForCpuids(FALSE);
 
+    //
+    // Set initial state of triggering events for RDTSCs and RDTSCPs
+    //
+    VmFuncSetTriggerEventForTscs(FALSE);
+
     //
     // Initialize script engines global variables holder
     //
@@ -144,6 +175,7 @@ DebuggerInitialize()
     // Zero the global variables memory
     //
     RtlZeroMemory(g_ScriptGlobalVariables, MAX_VAR_COUNT * sizeof(UINT64));
+    ScriptEngineGlobalVariablesResetContention();
 
     //
     // Intialize the local and temp variables
@@ -183,6 +215,50 @@ DebuggerInitialize()
         //
         RtlZeroMemory(CurrentDebuggerState->ScriptEngineCoreSpecificLocalVariable, MAX_VAR_COUNT * sizeof(UINT64));
         RtlZeroMemory(CurrentDebuggerState->ScriptEngineCoreSpecificTempVariable, MAX_TEMP_COUNT * sizeof(UINT64));
+
+        //
+        // Allocate the aggregation maps of scripts on this core
+        //
+        if (!ScriptEngineAggregationInitialize(CurrentDebuggerState))
+        {
+            //
+            // Out of resource, initialization of the aggregation maps failed
+            //
+            return FALSE;
+        }
+
+        //
+        // Allocate the buffer of the staged messages of scripts on this core
+        //
+        if (!ScriptEngineOutputInitialize(CurrentDebuggerState))
+        {
+            //
+            // Out of resource, initialization of the staged messages failed
+            //
+            return FALSE;
+        }
+
+        //
+        // Allocate the scratch memory of scripts on this core
+        //
+        if (!ScriptEngineScratchInitialize(CurrentDebuggerState))
+        {
+            //
+            // Out of resource, initialization of the scratch memory failed
+            //
+            return FALSE;
+        }
+
+        //
+        // Allocate the snapshot of armed events of this core
+        //
+        if (!DebuggerArmedEventsInitialize(CurrentDebuggerState))
+        {
+            //
+            // Out of resource, initialization of the armed events snapshot failed
+            //
+            return FALSE;
+        }
     }
 
     //
@@ -200,6 +276,18 @@ DebuggerInitialize()
         return FALSE;
     }
 
+    //
+    // Initialize the caches of the loaded modules of user mode applications,
+    // the modules are read from the PEB (without the cache) if it fails
+    //
+    UserAccessModuleCacheInitialize();
+
+    //
+    // Measure the skew of the time-stamp counters of the cores, so the
+    // messages and the records of different cores are on a single timeline
+    //
+    TscSynchronizationMeasureOffsets();
+
     return TRUE;
 }
 
@@ -258,6 +346,11 @@ DebuggerUninitialize()
     //
     UdUninitializeUserDebugger();
 
+    //
+    // Uninitialize the caches of the loaded modules
+    //
+    UserAccessModuleCacheUninitialize();
+
     //
     // Uninitialize NMI broadcasting mechanism
     //
@@ -268,6 +361,16 @@ DebuggerUninitialize()
     //
     GlobalEventsFreeMemory();
 
+    //
+    // Free g_EventsIndex
+    //
+    GlobalEventsIndexFreeMemory();
+
+    //
+    // Free the buffers of the records of the hits
+    //
+    DebuggerEventRecordsUninitialize();
+
     //
     // Free g_ScriptGlobalVariables
     //
@@ -295,8 +398,34 @@ DebuggerUninitialize()
             ExFreePoolWithTag(CurrentDebuggerState->ScriptEngineCoreSpecificTempVariable, POOLTAG);
             CurrentDebuggerState->ScriptEngineCoreSpecificTempVariable = NULL;
         }
+
+        //
+        // Free the aggregation maps of scripts
+        //
+        ScriptEngineAggregationUninitialize(CurrentDebuggerState);
+
+        //
+        // Free the scratch memory of scripts
+        //
+        ScriptEngineScratchUninitialize(CurrentDebuggerState);
+
+        //
+        // Free the buffer of the staged messages of scripts
+        //
+        ScriptEngineOutputUninitialize(CurrentDebuggerState);
+
+        //
+        // Free the snapshot of armed events
+        //
+        DebuggerArmedEventsUninitialize(CurrentDebuggerState);
     }
 
+    //
+    // Free the slabs of the events and the actions
+    //
+    SlabCacheUninitialize(&g_EventsSlabCache);
+    SlabCacheUninitialize(&g_ActionsSlabCache);
+
     //
     // Free g_DbgState
     //
@@ -311,6 +440,7 @@ DebuggerUninitialize()
  * @param Enabled Is the event enabled or disabled
  * @param CoreId The core id that this event is allowed to run
  * @param ProcessId The process id that this event is allowed to run
+ * @param ThreadId The thread id that this event is allowed to run
  * @param EventType The type of event
  * @param Tag User-mode generated unique tag (id) of the event
  * @param OptionalParam1 Optional parameter 1 for event
@@ -326,6 +456,7 @@ PDEBUGGER_EVENT
 DebuggerCreateEvent(BOOLEAN             Enabled,
                     UINT32              CoreId,
                     UINT32              ProcessId,
+                    UINT32              ThreadId,
                     VMM_EVENT_TYPE_ENUM EventType,
                     UINT64              Tag,
                     UINT64              OptionalParam1,
@@ -335,6 +466,9 @@ DebuggerCreateEvent(BOOLEAN             Enabled,
                     UINT32              ConditionsBufferSize,
                     PVOID               ConditionBuffer)
 {
+    PDEBUGGER_EVENT Event;
+    SIZE_T          Size;
+
     //
     // As this function uses ExAllocatePoolWithTag,
     // we have to make sure that it will not be called in vmx root
@@ -344,10 +478,16 @@ DebuggerCreateEvent(BOOLEAN             Enabled,
         return NULL;
     }
 
+    //
+    // The condition buffer is appended to the event, the same size is
+    // used for freeing the event from the slabs
+    //
+    Size = sizeof(DEBUGGER_EVENT) + (ConditionBuffer != 0 ? ConditionsBufferSize : 0);
+
     //
     // Initialize the event structure
     //
-    PDEBUGGER_EVENT Event = ExAllocatePoolWithTag(NonPagedPool, sizeof(DEBUGGER_EVENT) + ConditionsBufferSize, POOLTAG);
+    Event = SlabCacheAllocate(&g_EventsSlabCache, Size);
     if (!Event)
     {
         //
@@ -355,10 +495,11 @@ DebuggerCreateEvent(BOOLEAN             Enabled,
         //
         return NULL;
     }
-    RtlZeroMemory(Event, sizeof(DEBUGGER_EVENT) + ConditionsBufferSize);
+    RtlZeroMemory(Event, Size);
 
     Event->CoreId         = CoreId;
     Event->ProcessId      = ProcessId;
+    Event->ThreadId       = ThreadId;
     Event->Enabled        = Enabled;
     Event->EventType      = EventType;
     Event->Tag            = Tag;
@@ -446,13 +587,6 @@ DebuggerAddActionToEvent(PDEBUGGER_EVENT                                 Event,
         //
         Size = sizeof(DEBUGGER_EVENT_ACTION) + InTheCaseOfCustomCode->CustomCodeBufferSize;
     }
-    else if (InTheCaseOfRunScript != NULL)
-    {
-        //
-        // We should allocate extra buffer for script
-        //
-        Size = sizeof(DEBUGGER_EVENT_ACTION) + InTheCaseOfRunScript->ScriptLength;
-    }
     else
     {
         //
@@ -461,7 +595,7 @@ DebuggerAddActionToEvent(PDEBUGGER_EVENT                                 Event,
         Size = sizeof(DEBUGGER_EVENT_ACTION);
     }
 
-    Action = ExAllocatePoolWithTag(NonPagedPool, Size, POOLTAG);
+    Action = SlabCacheAllocate(&g_ActionsSlabCache, Size);
 
     if (Action == NULL)
     {
@@ -488,7 +622,7 @@ DebuggerAddActionToEvent(PDEBUGGER_EVENT                                 Event,
             //
             // There was an error
             //
-            ExFreePoolWithTag(Action, POOLTAG);
+            SlabCacheFree(&g_ActionsSlabCache, Action, Size);
             return NULL;
         }
 
@@ -502,7 +636,7 @@ DebuggerAddActionToEvent(PDEBUGGER_EVENT                                 Event,
             //
             // There was an error in allocation
             //
-            ExFreePoolWithTag(Action, POOLTAG);
+            SlabCacheFree(&g_ActionsSlabCache, Action, Size);
             return NULL;
         }
 
@@ -531,7 +665,7 @@ DebuggerAddActionToEvent(PDEBUGGER_EVENT                                 Event,
             //
             // There was an error
             //
-            ExFreePoolWithTag(Action, POOLTAG);
+            SlabCacheFree(&g_ActionsSlabCache, Action, Size);
             return NULL;
         }
 
@@ -545,7 +679,7 @@ DebuggerAddActionToEvent(PDEBUGGER_EVENT                                 Event,
             //
             // There was an error in allocation
             //
-            ExFreePoolWithTag(Action, POOLTAG);
+            SlabCacheFree(&g_ActionsSlabCache, Action, Size);
             return NULL;
         }
 
@@ -569,7 +703,7 @@ DebuggerAddActionToEvent(PDEBUGGER_EVENT                                 Event,
             //
             // There was an error
             //
-            ExFreePoolWithTag(Action, POOLTAG);
+            SlabCacheFree(&g_ActionsSlabCache, Action, Size);
             return NULL;
         }
 
@@ -584,6 +718,12 @@ DebuggerAddActionToEvent(PDEBUGGER_EVENT                                 Event,
         // copy the custom code buffer to the end of the buffer of the action
         //
         memcpy(Action->CustomCodeBufferAddress, InTheCaseOfCustomCode->CustomCodeBufferAddress, InTheCaseOfCustomCode->CustomCodeBufferSize);
+
+        //
+        // The custom code might use the XMM registers, so the guest's
+        // XMM registers should be saved on vm-exits
+        //
+        VmFuncSetSaveXmmRegistersOnVmexits(TRUE);
     }
 
     //
@@ -599,26 +739,79 @@ DebuggerAddActionToEvent(PDEBUGGER_EVENT                                 Event,
             //
             // Invalid configuration
             //
-            ExFreePoolWithTag(Action, POOLTAG);
+            SlabCacheFree(&g_ActionsSlabCache, Action, Size);
             return NULL;
         }
 
         //
-        // Allocate the buffer from a non-page pool on the script
+        // The script is copied to a non-paged pool which is shared by all
+        // the actions that have the same script, it's also pre-compiled, so
+        // the symbols are not decoded each time that the event is triggered,
+        // if it's not possible to compile it then the script is evaluated
+        // from the symbols
         //
-        Action->ScriptConfiguration.ScriptBuffer = (BYTE *)Action + sizeof(DEBUGGER_EVENT_ACTION);
+        Action->ScriptSharedCode = ScriptEngineAcquireSharedCode((PVOID)InTheCaseOfRunScript->ScriptBuffer,
+                                                                 InTheCaseOfRunScript->ScriptLength,
+                                                                 InTheCaseOfRunScript->ScriptPointer);
 
-        //
-        // Copy the memory of script to our non-paged pool
-        //
-        RtlCopyMemory(Action->ScriptConfiguration.ScriptBuffer, InTheCaseOfRunScript->ScriptBuffer, InTheCaseOfRunScript->ScriptLength);
+        if (Action->ScriptSharedCode == NULL)
+        {
+            //
+            // There was an error in allocation
+            //
+            if (Action->RequestedBuffer.RequstBufferAddress != NULL)
+            {
+                ExFreePoolWithTag(Action->RequestedBuffer.RequstBufferAddress, POOLTAG);
+            }
+
+            SlabCacheFree(&g_ActionsSlabCache, Action, Size);
+            return NULL;
+        }
 
         //
         // Set other fields
         //
+        Action->ScriptConfiguration.ScriptBuffer                = (UINT64)Action->ScriptSharedCode + sizeof(SCRIPT_ENGINE_SHARED_CODE);
         Action->ScriptConfiguration.ScriptLength                = InTheCaseOfRunScript->ScriptLength;
         Action->ScriptConfiguration.ScriptPointer               = InTheCaseOfRunScript->ScriptPointer;
         Action->ScriptConfiguration.OptionalRequestedBufferSize = InTheCaseOfRunScript->OptionalRequestedBufferSize;
+        Action->ScriptConfiguration.InstructionsBudget          = InTheCaseOfRunScript->InstructionsBudget;
+        Action->ScriptBytecode                                  = Action->ScriptSharedCode->Bytecode;
+    }
+
+    //
+    // If it's showing the last branch records action type
+    //
+    else if (ActionType == SHOW_LAST_BRANCH_RECORDS)
+    {
+        //
+        // The last branches are recorded on all cores as long as there
+        // is at least one action that shows them
+        //
+        if (!VmFuncSetLastBranchRecords(TRUE))
+        {
+            //
+            // LBRs are not supported
+            //
+            SlabCacheFree(&g_ActionsSlabCache, Action, Size);
+            return NULL;
+        }
+    }
+
+    //
+    // If it's recording the hits action type
+    //
+    else if (ActionType == RECORD_HITS)
+    {
+        //
+        // The buffers of the records are allocated by the first action
+        // that records the hits
+        //
+        if (!DebuggerEventRecordsInitialize())
+        {
+            SlabCacheFree(&g_ActionsSlabCache, Action, Size);
+            return NULL;
+        }
     }
 
     //
@@ -663,6 +856,17 @@ DebuggerRegisterEvent(PDEBUGGER_EVENT Event)
     {
         InsertHeadList(TargetEventList, &(Event->EventsOfSameTypeList));
 
+        //
+        // Add it to the lookup index of events, the event is re-indexed
+        // once its parameters are finalized (DebuggerEventsIndexUpdateEvent)
+        //
+        DebuggerEventsIndexInsertEvent(Event);
+
+        //
+        // Reference the per-core resource of the event (if any)
+        //
+        DebuggerAcquireEventResource(Event);
+
         return TRUE;
     }
     else
@@ -672,862 +876,1428 @@ DebuggerRegisterEvent(PDEBUGGER_EVENT Event)
 }
 
 /**
- * @brief Trigger events of a special type to be managed by debugger
+ * @brief Add an access to the coalesced accesses of a monitor event
+ * @details the accesses are summarized per core and the summary is
+ * reported once the count of accesses or the time window is reached
  *
- * @param EventType Type of events
+ * @param CurrentEvent The monitor event
+ * @param CoreId The current core
+ * @param VirtualAddress The accessed virtual address
+ *
+ * @return PDEBUGGER_EVENT_MONITOR_ACCESS_SUMMARY The summary that should be
+ * reported or NULL if the accesses are still coalesced
+ */
+static PDEBUGGER_EVENT_MONITOR_ACCESS_SUMMARY
+DebuggerCoalesceMonitorAccess(PDEBUGGER_EVENT CurrentEvent, UINT32 CoreId, UINT64 VirtualAddress)
+{
+    PDEBUGGER_EVENT_COALESCING_STATE State = &CurrentEvent->CoalescingStates[CoreId];
+    UINT64                           CurrentTime;
+
+    CurrentTime = KeQueryInterruptTime();
+
+    if (State->Summary.AccessCount == 0)
+    {
+        //
+        // It's the first access of a new summary
+        //
+        State->Summary.LowestAddress  = VirtualAddress;
+        State->Summary.HighestAddress = VirtualAddress;
+        State->WindowStartTime        = CurrentTime;
+    }
+    else if (VirtualAddress < State->Summary.LowestAddress)
+    {
+        State->Summary.LowestAddress = VirtualAddress;
+    }
+    else if (VirtualAddress > State->Summary.HighestAddress)
+    {
+        State->Summary.HighestAddress = VirtualAddress;
+    }
+
+    State->Summary.AccessCount++;
+    State->Summary.LastAddress = VirtualAddress;
+
+    //
+    // Check whether the summary should be reported or not
+    //
+    if ((CurrentEvent->CoalescingAccessCount != 0 && State->Summary.AccessCount >= CurrentEvent->CoalescingAccessCount) ||
+        (CurrentEvent->CoalescingWindow != 0 && CurrentTime - State->WindowStartTime >= CurrentEvent->CoalescingWindow))
+    {
+        return &State->Summary;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Take a token of the rate limit of an event on the current core
+ * @details the tokens are refilled based on the time that is passed since
+ * the last refill, once there is no token, the event is disarmed on the
+ * core and its triggers are dropped until the tokens are refilled
+ *
+ * @param CurrentEvent The rate limited event
+ * @param CoreId The current core
+ *
+ * @return BOOLEAN Whether the event is allowed to be triggered or not
+ */
+static BOOLEAN
+DebuggerConsumeEventRateLimit(PDEBUGGER_EVENT CurrentEvent, UINT32 CoreId)
+{
+    PDEBUGGER_EVENT_RATE_LIMIT_STATE State = &CurrentEvent->RateLimitStates[CoreId];
+    UINT64                           CurrentTime;
+    UINT64                           ElapsedTime;
+    UINT64                           RefilledTokens;
+
+    CurrentTime = KeQueryInterruptTime();
+    ElapsedTime = CurrentTime - State->LastRefillTime;
+
+    //
+    // Refill the tokens (interrupt time is in 100-nanosecond units), the
+    // bucket never holds more than one second of triggers
+    //
+    if (ElapsedTime >= 10000000)
+    {
+        RefilledTokens = CurrentEvent->RateLimit;
+    }
+    else
+    {
+        RefilledTokens = (ElapsedTime * CurrentEvent->RateLimit) / 10000000;
+    }
+
+    if (RefilledTokens != 0)
+    {
+        State->Tokens         = min(State->Tokens + RefilledTokens, CurrentEvent->RateLimit);
+        State->LastRefillTime = CurrentTime;
+    }
+
+    if (State->Tokens == 0)
+    {
+        //
+        // The event is over its budget
+        //
+        State->IsDisarmed = TRUE;
+        State->DroppedTriggers++;
+
+        return FALSE;
+    }
+
+    if (State->IsDisarmed)
+    {
+        LogWarning("Warning, event (tag: %llx) is re-armed on core %x after dropping %llx triggers (rate limit: %llx per second)",
+                   CurrentEvent->Tag,
+                   CoreId,
+                   State->DroppedTriggers,
+                   CurrentEvent->RateLimit);
+
+        State->IsDisarmed      = FALSE;
+        State->DroppedTriggers = 0;
+    }
+
+    State->Tokens--;
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the conditions of a single event and perform its actions
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param CurrentEvent The candidate event
  * @param CallingStage Stage of calling (pre-event or post-event)
  * @param Context An optional parameter (different in each event)
  * @param PostEventRequired Whether the caller is requested to
  * trigger a post-event event
- * @param Regs Guest gp-registers
  *
- * @return VMM_CALLBACK_TRIGGERING_EVENT_STATUS_TYPE returns the staus
- * of handling events
+ * @return VOID
  */
-VMM_CALLBACK_TRIGGERING_EVENT_STATUS_TYPE
-DebuggerTriggerEvents(VMM_EVENT_TYPE_ENUM                   EventType,
-                      VMM_CALLBACK_EVENT_CALLING_STAGE_TYPE CallingStage,
-                      PVOID                                 Context,
-                      BOOLEAN *                             PostEventRequired,
-                      GUEST_REGS *                          Regs)
+static VOID
+DebuggerTriggerSingleEvent(PROCESSOR_DEBUGGING_STATE *           DbgState,
+                           PDEBUGGER_EVENT                       CurrentEvent,
+                           VMM_CALLBACK_EVENT_CALLING_STAGE_TYPE CallingStage,
+                           PVOID                                 Context,
+                           BOOLEAN *                             PostEventRequired)
 {
-    DebuggerCheckForCondition * ConditionFunc;
-    PLIST_ENTRY                 TempList  = 0;
-    PLIST_ENTRY                 TempList2 = 0;
-    PROCESSOR_DEBUGGING_STATE * DbgState  = NULL;
+    DebuggerCheckForCondition *            ConditionFunc;
+    PDEBUGGER_EVENT_MONITOR_ACCESS_SUMMARY Summary = NULL;
+    PDEBUGGER_EVENT_HIT_STATISTICS         HitStatistics;
+    PDEBUGGER_EVENT_MONITOR_RANGES         MonitorRanges;
+    BOOLEAN                                IsInMonitorRange;
 
     //
-    // Check if triggering debugging actions are allowed or not
+    // check if the event is enabled or not
     //
-    if (!g_EnableDebuggerEvents)
+    if (!CurrentEvent->Enabled)
     {
-        //
-        // Debugger is not enabled
-        //
-        return VMM_CALLBACK_TRIGGERING_EVENT_STATUS_DEBUGGER_NOT_ENABLED;
+        return;
     }
 
     //
-    // Find the debugging state structure
+    // Check if this event is for this core or not
     //
-    DbgState = &g_DbgState[KeGetCurrentProcessorNumber()];
+    if (CurrentEvent->CoreId != DEBUGGER_EVENT_APPLY_TO_ALL_CORES && CurrentEvent->CoreId != DbgState->CoreId)
+    {
+        //
+        // This event is not related to either or core or all cores
+        //
+        return;
+    }
 
     //
-    // Set the registers for debug state
+    // Check if this event is for this process or not
     //
-    DbgState->Regs = Regs;
+    if (CurrentEvent->ProcessId != DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES && CurrentEvent->ProcessId != PsGetCurrentProcessId())
+    {
+        //
+        // This event is not related to either our process or all processes
+        //
+        return;
+    }
 
     //
-    // Find the debugger events list base on the type of the event
+    // Check if this event is for this thread or not
     //
-    TempList  = DebuggerGetEventListByEventType(EventType);
-    TempList2 = TempList;
-
-    if (TempList == NULL)
+    if (CurrentEvent->ThreadId != DEBUGGER_EVENT_APPLY_TO_ALL_THREADS && CurrentEvent->ThreadId != PsGetCurrentThreadId())
     {
-        return VMM_CALLBACK_TRIGGERING_EVENT_STATUS_INVALID_EVENT_TYPE;
+        //
+        // This event is not related to either our thread or all threads
+        //
+        return;
     }
 
-    while (TempList2 != TempList->Flink)
+    //
+    // Check event type specific conditions
+    //
+    switch (CurrentEvent->EventType)
     {
-        TempList                     = TempList->Flink;
-        PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+    case EXTERNAL_INTERRUPT_OCCURRED:
 
         //
-        // check if the event is enabled or not
+        // For external interrupt exiting events we check whether the
+        // vector match the event's vector or not
+        //
+        // Context is the physical address
         //
-        if (!CurrentEvent->Enabled)
+        if (Context != CurrentEvent->OptionalParam1)
         {
-            continue;
+            //
+            // The interrupt is not for this event
+            //
+            return;
         }
 
+        break;
+
+    case HIDDEN_HOOK_READ_AND_WRITE_AND_EXECUTE:
+    case HIDDEN_HOOK_READ_AND_WRITE:
+    case HIDDEN_HOOK_READ_AND_EXECUTE:
+    case HIDDEN_HOOK_WRITE_AND_EXECUTE:
+    case HIDDEN_HOOK_READ:
+    case HIDDEN_HOOK_WRITE:
+    case HIDDEN_HOOK_EXECUTE:
+
+        //
+        // For hidden hook read/write/execute we check whether the address
+        // is in the range of what user specified or not, this is because
+        // we get the events for all hidden hooks in a page granularity
+        //
+
         //
-        // Check if this event is for this core or not
+        // The ranges of multi-range events are checked in virtual address
+        // (the ranges might be replaced, so they're read once)
         //
-        if (CurrentEvent->CoreId != DEBUGGER_EVENT_APPLY_TO_ALL_CORES && CurrentEvent->CoreId != DbgState->CoreId)
+        MonitorRanges = CurrentEvent->MonitorRanges;
+
+        if (MonitorRanges != NULL)
+        {
+            IsInMonitorRange = DebuggerIsAddressInMonitorRanges(MonitorRanges, ((PEPT_HOOKS_CONTEXT)(Context))->VirtualAddress);
+        }
+        else
         {
             //
-            // This event is not related to either or core or all cores
+            // Context should be checked in physical address
             //
-            continue;
+            IsInMonitorRange = ((PEPT_HOOKS_CONTEXT)(Context))->PhysicalAddress >= CurrentEvent->OptionalParam1 &&
+                               ((PEPT_HOOKS_CONTEXT)(Context))->PhysicalAddress < CurrentEvent->OptionalParam2;
         }
 
         //
-        // Check if this event is for this process or not
+        // The ranges that are added by the scripts are also checked in
+        // virtual address
         //
-        if (CurrentEvent->ProcessId != DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES && CurrentEvent->ProcessId != PsGetCurrentProcessId())
+        if (!IsInMonitorRange && CurrentEvent->MonitorSlots != NULL)
+        {
+            IsInMonitorRange = DebuggerIsAddressInMonitorSlots(CurrentEvent->MonitorSlots, ((PEPT_HOOKS_CONTEXT)(Context))->VirtualAddress);
+        }
+
+        if (!IsInMonitorRange)
         {
             //
-            // This event is not related to either our process or all processes
+            // The value is not withing any of our expected ranges
             //
-            continue;
+            return;
         }
 
         //
-        // Check event type specific conditions
+        // Fix the context to virtual address
         //
-        switch (CurrentEvent->EventType)
-        {
-        case EXTERNAL_INTERRUPT_OCCURRED:
-
-            //
-            // For external interrupt exiting events we check whether the
-            // vector match the event's vector or not
-            //
-            // Context is the physical address
-            //
-            if (Context != CurrentEvent->OptionalParam1)
-            {
-                //
-                // The interrupt is not for this event
-                //
-                continue;
-            }
+        Context = ((PEPT_HOOKS_CONTEXT)(Context))->VirtualAddress;
 
-            break;
+        break;
 
-        case HIDDEN_HOOK_READ_AND_WRITE_AND_EXECUTE:
-        case HIDDEN_HOOK_READ_AND_WRITE:
-        case HIDDEN_HOOK_READ_AND_EXECUTE:
-        case HIDDEN_HOOK_WRITE_AND_EXECUTE:
-        case HIDDEN_HOOK_READ:
-        case HIDDEN_HOOK_WRITE:
-        case HIDDEN_HOOK_EXECUTE:
+    case HIDDEN_HOOK_EXEC_CC:
 
+        //
+        // Here we check if it's HIDDEN_HOOK_EXEC_CC then it means
+        // so we have to make sure to perform its actions only if
+        // the hook is triggered for the address described in
+        // event, note that address in event is a virtual address
+        //
+        if (Context != CurrentEvent->OptionalParam1)
+        {
             //
-            // For hidden hook read/write/execute we check whether the address
-            // is in the range of what user specified or not, this is because
-            // we get the events for all hidden hooks in a page granularity
+            // Context is the virtual address
             //
 
             //
-            // Context should be checked in physical address
+            // The hook is not for this (virtual) address
             //
-            if (!(((PEPT_HOOKS_CONTEXT)(Context))->PhysicalAddress >= CurrentEvent->OptionalParam1 && ((PEPT_HOOKS_CONTEXT)(Context))->PhysicalAddress < CurrentEvent->OptionalParam2))
-            {
-                //
-                // The value is not withing our expected range
-                //
-                continue;
-            }
-            else
-            {
-                //
-                // Fix the context to virtual address
-                //
-                Context = ((PEPT_HOOKS_CONTEXT)(Context))->VirtualAddress;
-            }
+            return;
+        }
 
-            break;
+        break;
 
-        case HIDDEN_HOOK_EXEC_CC:
+    case HIDDEN_HOOK_EXEC_DETOURS:
 
+        //
+        // Here we check if it's HIDDEN_HOOK_EXEC_DETOURS
+        // then it means that it's detours hidden hook exec so we have
+        // to make sure to perform its actions, only if the hook is triggered
+        // for the address described in event, note that address in event is
+        // a physical address and the address that the function that triggers
+        // these events and sent here as the context is also converted to its
+        // physical form
+        // This way we are sure that no one can bypass our hook by remapping
+        // address to another virtual address as everything is physical
+        //
+        if (((PEPT_HOOKS_CONTEXT)Context)->PhysicalAddress != CurrentEvent->OptionalParam1)
+        {
             //
-            // Here we check if it's HIDDEN_HOOK_EXEC_CC then it means
-            // so we have to make sure to perform its actions only if
-            // the hook is triggered for the address described in
-            // event, note that address in event is a virtual address
+            // Context is the physical address
             //
-            if (Context != CurrentEvent->OptionalParam1)
-            {
-                //
-                // Context is the virtual address
-                //
-
-                //
-                // The hook is not for this (virtual) address
-                //
-                continue;
-            }
-
-            break;
-
-        case HIDDEN_HOOK_EXEC_DETOURS:
 
             //
-            // Here we check if it's HIDDEN_HOOK_EXEC_DETOURS
-            // then it means that it's detours hidden hook exec so we have
-            // to make sure to perform its actions, only if the hook is triggered
-            // for the address described in event, note that address in event is
-            // a physical address and the address that the function that triggers
-            // these events and sent here as the context is also converted to its
-            // physical form
-            // This way we are sure that no one can bypass our hook by remapping
-            // address to another virtual address as everything is physical
+            // The hook is not for this (physical) address
             //
-            if (((PEPT_HOOKS_CONTEXT)Context)->PhysicalAddress != CurrentEvent->OptionalParam1)
-            {
-                //
-                // Context is the physical address
-                //
-
-                //
-                // The hook is not for this (physical) address
-                //
-                continue;
-            }
-            else
-            {
-                //
-                // Convert it to virtual address
-                //
-                Context = ((PEPT_HOOKS_CONTEXT)Context)->VirtualAddress;
-            }
-
-            break;
-
-        case RDMSR_INSTRUCTION_EXECUTION:
-        case WRMSR_INSTRUCTION_EXECUTION:
-
+            return;
+        }
+        else
+        {
             //
-            // check if MSR exit is what we want or not
+            // Convert it to virtual address
             //
-            if (CurrentEvent->OptionalParam1 != DEBUGGER_EVENT_MSR_READ_OR_WRITE_ALL_MSRS && CurrentEvent->OptionalParam1 != Context)
-            {
-                //
-                // The msr is not what we want
-                //
-                continue;
-            }
+            Context = ((PEPT_HOOKS_CONTEXT)Context)->VirtualAddress;
+        }
 
-            break;
+        break;
 
-        case EXCEPTION_OCCURRED:
+    case PAGE_FIRST_EXECUTION:
 
+        //
+        // The traced range of the event is [OptionalParam1, OptionalParam2) in
+        // virtual address, all of the events share the traced pages, so we have
+        // to make sure that the executed page is in the range of this event
+        //
+        if (((PEPT_HOOKS_CONTEXT)Context)->VirtualAddress < CurrentEvent->OptionalParam1 ||
+            ((PEPT_HOOKS_CONTEXT)Context)->VirtualAddress >= CurrentEvent->OptionalParam2)
+        {
             //
-            // check if exception is what we need or not
+            // The page is not in the range of this event
             //
-            if (CurrentEvent->OptionalParam1 != DEBUGGER_EVENT_EXCEPTIONS_ALL_FIRST_32_ENTRIES && CurrentEvent->OptionalParam1 != Context)
-            {
-                //
-                // The exception is not what we want
-                //
-                continue;
-            }
-
-            break;
-
-        case IN_INSTRUCTION_EXECUTION:
-        case OUT_INSTRUCTION_EXECUTION:
-
+            return;
+        }
+        else
+        {
             //
-            // check if I/O port is what we want or not
+            // Convert it to virtual address (the address of the first executed instruction)
             //
-            if (CurrentEvent->OptionalParam1 != DEBUGGER_EVENT_ALL_IO_PORTS && CurrentEvent->OptionalParam1 != Context)
-            {
-                //
-                // The port is not what we want
-                //
-                continue;
-            }
-
-            break;
+            Context = ((PEPT_HOOKS_CONTEXT)Context)->VirtualAddress;
+        }
 
-        case SYSCALL_HOOK_EFER_SYSCALL:
+        break;
 
-            //
-            // case SYSCALL_HOOK_EFER_SYSRET:
-            //
-            // I don't know how to find syscall number when sysret is executed so
-            // that's why we don't support extra argument for sysret
-            //
+    case RDMSR_INSTRUCTION_EXECUTION:
+    case WRMSR_INSTRUCTION_EXECUTION:
 
+        //
+        // check if MSR exit is what we want or not
+        //
+        if (CurrentEvent->OptionalParam1 != DEBUGGER_EVENT_MSR_READ_OR_WRITE_ALL_MSRS && CurrentEvent->OptionalParam1 != Context)
+        {
             //
-            // check syscall number
+            // The msr is not what we want
             //
-            if (CurrentEvent->OptionalParam1 != DEBUGGER_EVENT_SYSCALL_ALL_SYSRET_OR_SYSCALLS && CurrentEvent->OptionalParam1 != Context)
-            {
-                //
-                // The syscall number is not what we want
-                //
-                continue;
-            }
+            return;
+        }
 
-            break;
+        break;
 
-        case CPUID_INSTRUCTION_EXECUTION:
+    case EXCEPTION_OCCURRED:
 
+        //
+        // check if exception is what we need or not
+        //
+        if (CurrentEvent->OptionalParam1 != DEBUGGER_EVENT_EXCEPTIONS_ALL_FIRST_32_ENTRIES && CurrentEvent->OptionalParam1 != Context)
+        {
             //
-            // check if CPUID is what we want or not
+            // The exception is not what we want
             //
-            if (CurrentEvent->OptionalParam1 != NULL /*FALSE*/ && CurrentEvent->OptionalParam2 != Context)
-            {
-                //
-                // The CPUID is not what we want (and the user didn't intend to get all CPUIDs)
-                //
-                continue;
-            }
+            return;
+        }
 
-            break;
+        break;
 
-        case CONTROL_REGISTER_MODIFIED:
+    case IN_INSTRUCTION_EXECUTION:
+    case OUT_INSTRUCTION_EXECUTION:
 
+        //
+        // check if I/O port is what we want or not
+        //
+        if (CurrentEvent->OptionalParam1 != DEBUGGER_EVENT_ALL_IO_PORTS && CurrentEvent->OptionalParam1 != Context)
+        {
             //
-            // check if CR exit is what we want or not
+            // The port is not what we want
             //
-            if (CurrentEvent->OptionalParam1 != Context)
-            {
-                //
-                // The CR is not what we want
-                //
-                continue;
-            }
+            return;
+        }
 
-            break;
+        break;
 
-        default:
-            break;
-        }
+    case SYSCALL_HOOK_EFER_SYSCALL:
+
+        //
+        // case SYSCALL_HOOK_EFER_SYSRET:
+        //
+        // I don't know how to find syscall number when sysret is executed so
+        // that's why we don't support extra argument for sysret
+        //
 
         //
-        // Check the stage of calling (pre and post event)
+        // check syscall number
         //
-        if (CallingStage == VMM_CALLBACK_CALLING_STAGE_PRE_EVENT_EMULATION && CurrentEvent->EventMode == VMM_CALLBACK_CALLING_STAGE_POST_EVENT_EMULATION)
+        if (CurrentEvent->OptionalParam1 != DEBUGGER_EVENT_SYSCALL_ALL_SYSRET_OR_SYSCALLS && CurrentEvent->OptionalParam1 != Context)
         {
             //
-            // Here it means that the current event is a post-event event and
-            // the current stage of calling is for the pre-event events, thus
-            // this event is not supposed to be runned at the current stage.
-            // However, we'll set a flag so the caller will know that there is
-            // a valid post-event available for the parameters related to this
-            // event.
-            // This mechanism notifies the caller to trigger the event after
-            // emulation, we implement it in a way that the caller knows when
-            // to trigger a post-event thus it optimizes the number of times
-            // that the caller triggers the events and avoid unnecessary triggering
-            // of the event (for post-event) but at the same time we have the
-            // flexibility of having both pre-event and post-event concepts
+            // The syscall number is not what we want
             //
-            *PostEventRequired = TRUE;
-
-            continue;
+            return;
         }
 
+        break;
+
+    case CPUID_INSTRUCTION_EXECUTION:
+
         //
-        // Check if condtion is met or not , if the condition
-        // is not met then we have to avoid performing the actions
+        // check if CPUID is what we want or not
         //
-        if (CurrentEvent->ConditionsBufferSize != 0)
+        if (CurrentEvent->OptionalParam1 != NULL /*FALSE*/ && CurrentEvent->OptionalParam2 != Context)
         {
             //
-            // Means that there is some conditions
+            // The CPUID is not what we want (and the user didn't intend to get all CPUIDs)
             //
-            ConditionFunc = CurrentEvent->ConditionBufferAddress;
+            return;
+        }
 
+        break;
+
+    case CONTROL_REGISTER_MODIFIED:
+
+        //
+        // check if CR exit is what we want or not
+        //
+        if (CurrentEvent->OptionalParam1 != Context)
+        {
             //
-            // Run and check for results
-            //
-            // Because the user might change the nonvolatile registers, we save fastcall nonvolatile registers
+            // The CR is not what we want
             //
-            if (AsmDebuggerConditionCodeHandler(DbgState->Regs, Context, ConditionFunc) == 0)
-            {
-                //
-                // The condition function returns null, mean that the
-                // condition didn't met, we can ignore this event
-                //
-                continue;
-            }
+            return;
         }
 
-        //
-        // Reset the the event ignorance mechanism (apply 'sc on/off' to the events)
-        //
-        DbgState->ShortCircuitingEvent = CurrentEvent->EnableShortCircuiting;
+        break;
 
-        //
-        // perform the actions
-        //
-        DebuggerPerformActions(DbgState, CurrentEvent, Context);
+    default:
+        break;
     }
 
     //
-    // Check if the event should be ignored or not
+    // Check the stage of calling (pre and post event)
     //
-    if (DbgState->ShortCircuitingEvent)
+    if (CallingStage == VMM_CALLBACK_CALLING_STAGE_PRE_EVENT_EMULATION && CurrentEvent->EventMode == VMM_CALLBACK_CALLING_STAGE_POST_EVENT_EMULATION)
     {
         //
-        // Reset the the event ignorance (short-circuit) mechanism
-        //
-        DbgState->ShortCircuitingEvent = FALSE;
+        // Here it means that the current event is a post-event event and
+        // the current stage of calling is for the pre-event events, thus
+        // this event is not supposed to be runned at the current stage.
+        // However, we'll set a flag so the caller will know that there is
+        // a valid post-event available for the parameters related to this
+        // event.
+        // This mechanism notifies the caller to trigger the event after
+        // emulation, we implement it in a way that the caller knows when
+        // to trigger a post-event thus it optimizes the number of times
+        // that the caller triggers the events and avoid unnecessary triggering
+        // of the event (for post-event) but at the same time we have the
+        // flexibility of having both pre-event and post-event concepts
+        //
+        *PostEventRequired = TRUE;
 
-        //
-        // Event should be ignored
-        //
-        return VMM_CALLBACK_TRIGGERING_EVENT_STATUS_SUCCESSFUL_IGNORE_EVENT;
+        return;
     }
-    else
+
+    //
+    // The event is hit, each core only updates its own counters
+    //
+    HitStatistics = &CurrentEvent->HitStatistics[DbgState->CoreId];
+
+    HitStatistics->Hits++;
+    HitStatistics->LastHitTsc = LogReadTimestamp();
+
+    //
+    // Check whether the event is over its rate limit on this core, it's checked
+    // before the conditions, so the cost of running the conditions is limited too
+    //
+    if (CurrentEvent->RateLimitStates != NULL && !DebuggerConsumeEventRateLimit(CurrentEvent, DbgState->CoreId))
     {
-        //
-        // Event shouldn't be ignored
-        //
-        return VMM_CALLBACK_TRIGGERING_EVENT_STATUS_SUCCESSFUL;
+        return;
     }
-}
-
-/**
- * @brief Run a special event's action(s)
- *
- * @param DbgState The state of the debugger on the current core
- * @param Event Event Object
- * @param Context Optional parameter
- * @return VOID
- */
-VOID
-DebuggerPerformActions(PROCESSOR_DEBUGGING_STATE * DbgState, PDEBUGGER_EVENT Event, PVOID Context)
-{
-    PLIST_ENTRY TempList = 0;
 
     //
-    // Find and run all the actions in this Event
+    // Check if condtion is met or not , if the condition
+    // is not met then we have to avoid performing the actions
     //
-    TempList = &Event->ActionsListHead;
-    while (&Event->ActionsListHead != TempList->Flink)
+    if (CurrentEvent->ConditionsBufferSize != 0)
     {
-        TempList                             = TempList->Flink;
-        PDEBUGGER_EVENT_ACTION CurrentAction = CONTAINING_RECORD(TempList, DEBUGGER_EVENT_ACTION, ActionsList);
+        //
+        // Means that there is some conditions
+        //
+        ConditionFunc = CurrentEvent->ConditionBufferAddress;
 
         //
-        // Perform the action
+        // Run and check for results
         //
-        switch (CurrentAction->ActionType)
+        // Because the user might change the nonvolatile registers, we save fastcall nonvolatile registers
+        //
+        if (AsmDebuggerConditionCodeHandler(DbgState->Regs, Context, ConditionFunc) == 0)
         {
-        case BREAK_TO_DEBUGGER:
-            DebuggerPerformBreakToDebugger(DbgState, Event->Tag, CurrentAction, Context);
-            break;
-        case RUN_SCRIPT:
-            DebuggerPerformRunScript(DbgState, Event->Tag, CurrentAction, NULL, Context);
-            break;
-        case RUN_CUSTOM_CODE:
-            DebuggerPerformRunTheCustomCode(DbgState, Event->Tag, CurrentAction, Context);
-            break;
-        default:
-
             //
-            // Invalid action type
+            // The condition function returns null, mean that the
+            // condition didn't met, we can ignore this event
             //
-            break;
+            return;
         }
     }
-}
 
-/**
- * @brief Managing run script action
- *
- * @param DbgState The state of the debugger on the current core
- * @param Tag Tag of event
- * @param Action Action object
- * @param Context Optional parameter
- * @return BOOLEAN
- */
-BOOLEAN
-DebuggerPerformRunScript(PROCESSOR_DEBUGGING_STATE * DbgState,
-                         UINT64                      Tag,
-                         PDEBUGGER_EVENT_ACTION      Action,
-                         PDEBUGGEE_SCRIPT_PACKET     ScriptDetails,
-                         PVOID                       Context)
-{
-    SYMBOL_BUFFER                CodeBuffer    = {0};
-    ACTION_BUFFER                ActionBuffer  = {0};
-    SYMBOL                       ErrorSymbol   = {0};
-    SCRIPT_ENGINE_VARIABLES_LIST VariablesList = {0};
+    //
+    // The conditions are passed (or the event is unconditional)
+    //
+    HitStatistics->ConditionPasses++;
 
-    if (Action != NULL)
+    //
+    // Check whether the accesses of this monitor are coalesced, if so, the actions
+    // are performed once for the summary of the accesses (passed as the context)
+    //
+    if (CurrentEvent->CoalescingStates != NULL)
     {
-        //
-        // Fill the action buffer
-        //
-        ActionBuffer.Context                   = Context;
-        ActionBuffer.ImmediatelySendTheResults = Action->ImmediatelySendTheResults;
-        ActionBuffer.CurrentAction             = Action;
-        ActionBuffer.Tag                       = Tag;
+        Summary = DebuggerCoalesceMonitorAccess(CurrentEvent, DbgState->CoreId, (UINT64)Context);
 
-        //
-        // Context point to the registers
-        //
-        CodeBuffer.Head    = Action->ScriptConfiguration.ScriptBuffer;
-        CodeBuffer.Size    = Action->ScriptConfiguration.ScriptLength;
-        CodeBuffer.Pointer = Action->ScriptConfiguration.ScriptPointer;
-    }
-    else if (ScriptDetails != NULL)
-    {
-        //
-        // Fill the action buffer
-        //
-        ActionBuffer.Context                   = Context;
-        ActionBuffer.ImmediatelySendTheResults = TRUE;
-        ActionBuffer.CurrentAction             = NULL;
-        ActionBuffer.Tag                       = Tag;
+        if (Summary == NULL)
+        {
+            return;
+        }
 
-        //
-        // Context point to the registers
-        //
-        CodeBuffer.Head    = ((CHAR *)ScriptDetails + sizeof(DEBUGGEE_SCRIPT_PACKET));
-        CodeBuffer.Size    = ScriptDetails->ScriptBufferSize;
-        CodeBuffer.Pointer = ScriptDetails->ScriptBufferPointer;
-    }
-    else
-    {
-        //
-        // The parameters are wrong !
-        //
-        return FALSE;
+        Context = Summary;
     }
 
     //
-    // Fill the variables list for this run
+    // Reset the the event ignorance mechanism (apply 'sc on/off' to the events)
     //
-    VariablesList.GlobalVariablesList = g_ScriptGlobalVariables;
-    VariablesList.LocalVariablesList  = DbgState->ScriptEngineCoreSpecificLocalVariable;
-    VariablesList.TempList            = DbgState->ScriptEngineCoreSpecificTempVariable;
+    DbgState->ShortCircuitingEvent = CurrentEvent->EnableShortCircuiting;
+
+    //
+    // perform the actions
+    //
+    DebuggerPerformActions(DbgState, CurrentEvent, Context);
 
-    for (int i = 0; i < CodeBuffer.Pointer;)
+    //
+    // Start a new summary of the accesses
+    //
+    if (Summary != NULL)
     {
-        //
-        // If has error, show error message and abort.
-        //
-        if (ScriptEngineExecute(DbgState->Regs,
-                                &ActionBuffer,
-                                &VariablesList,
-                                &CodeBuffer,
-                                &i,
-                                &ErrorSymbol) == TRUE)
-        {
-            CHAR NameOfOperator[MAX_FUNCTION_NAME_LENGTH] = {0};
-            ScriptEngineGetOperatorName(&ErrorSymbol, NameOfOperator);
-            LogInfo("Invalid returning address for operator: %s", NameOfOperator);
-            break;
-        }
+        Summary->AccessCount = 0;
     }
-
-    return TRUE;
 }
 
 /**
- * @brief Manage running the custom code action
+ * @brief Trigger events of a special type to be managed by debugger
  *
- * @param DbgState The state of the debugger on the current core
- * @param Tag Tag of event
- * @param Action Action object
- * @param Context Optional parameter
- * @return VOID
+ * @param EventType Type of events
+ * @param CallingStage Stage of calling (pre-event or post-event)
+ * @param Context An optional parameter (different in each event)
+ * @param PostEventRequired Whether the caller is requested to
+ * trigger a post-event event
+ * @param Regs Guest gp-registers
+ *
+ * @return VMM_CALLBACK_TRIGGERING_EVENT_STATUS_TYPE returns the staus
+ * of handling events
  */
-VOID
-DebuggerPerformRunTheCustomCode(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 Tag, PDEBUGGER_EVENT_ACTION Action, PVOID Context)
+VMM_CALLBACK_TRIGGERING_EVENT_STATUS_TYPE
+DebuggerTriggerEvents(VMM_EVENT_TYPE_ENUM                   EventType,
+                      VMM_CALLBACK_EVENT_CALLING_STAGE_TYPE CallingStage,
+                      PVOID                                 Context,
+                      BOOLEAN *                             PostEventRequired,
+                      GUEST_REGS *                          Regs)
 {
-    if (Action->CustomCodeBufferSize == 0)
+    PLIST_ENTRY                     TempList                                                    = 0;
+    PLIST_ENTRY                     TempList2                                                   = 0;
+    PROCESSOR_DEBUGGING_STATE *     DbgState                                                    = NULL;
+    PDEBUGGER_ARMED_EVENTS_SNAPSHOT Snapshot                                                    = NULL;
+    PDEBUGGER_ARMED_EVENT           ArmedEvent                                                  = NULL;
+    PLIST_ENTRY                     CandidateLists[DEBUGGER_EVENTS_INDEX_CANDIDATE_LISTS_COUNT] = {0};
+    UINT32                          KeyedStart                                                  = 0;
+    UINT32                          KeyedEnd                                                    = 0;
+    UINT32                          WildcardStart                                               = 0;
+    UINT32                          WildcardEnd                                                 = 0;
+    UINT32                          CurrentProcessId                                            = 0;
+    UINT32                          CurrentThreadId                                             = 0;
+    UINT32                          RangeStart[DEBUGGER_EVENTS_INDEX_CANDIDATE_LISTS_COUNT]     = {0};
+    UINT32                          RangeEnd[DEBUGGER_EVENTS_INDEX_CANDIDATE_LISTS_COUNT]       = {0};
+    UINT64                          PreviousTriggerTimestamp                                    = 0;
+
+    //
+    // Check if triggering debugging actions are allowed or not
+    //
+    if (!g_EnableDebuggerEvents)
     {
         //
-        // Sth went wrong ! the buffer size for custom code shouldn't be zero
+        // Debugger is not enabled
         //
-        return;
+        return VMM_CALLBACK_TRIGGERING_EVENT_STATUS_DEBUGGER_NOT_ENABLED;
     }
 
     //
-    // -----------------------------------------------------------------------------------------------------
-    // Test (Should be removed)
+    // Find the debugging state structure
     //
-    // LogInfo("%X       Called from : %llx", Tag, Context);
+    DbgState = &g_DbgState[KeGetCurrentProcessorNumber()];
+
     //
+    // Set the registers for debug state
     //
-    // LogInfo("Process Id : %x , Rax : %llx , R8 : %llx , Context : 0x%llx ", PsGetCurrentProcessId(), Regs->rax, Regs->r8, Context);
-    // return;
+    DbgState->Regs = Regs;
+
     //
-    // -----------------------------------------------------------------------------------------------------
+    // Messages of the actions are stamped with the time of triggering the
+    // event (for measuring the latency of delivering them to the user-mode)
     //
+    PreviousTriggerTimestamp = LogSetEventTriggerTimestamp(LogReadTimestamp());
 
     //
-    // Run the custom code
+    // Get the snapshot of armed events of this core (if it's usable)
     //
-    if (Action->RequestedBuffer.RequestBufferSize == 0)
+    Snapshot = DebuggerArmedEventsEnterDispatch(DbgState);
+
+    if (Snapshot != NULL)
     {
         //
-        // Because the user might change the nonvolatile registers, we save fastcall nonvolatile registers
+        // Find the candidate events from the snapshot based on the type of the
+        // event and its discriminator, the event objects are only touched if
+        // the compact descriptors in the snapshot are matched
         //
-        AsmDebuggerCustomCodeHandler(NULL, DbgState->Regs, Context, Action->CustomCodeBufferAddress);
+        if (!DebuggerArmedEventsGetCandidates(Snapshot, EventType, Context, &KeyedStart, &KeyedEnd, &WildcardStart, &WildcardEnd))
+        {
+            DebuggerArmedEventsExitDispatch(DbgState);
+            LogSetEventTriggerTimestamp(PreviousTriggerTimestamp);
+            return VMM_CALLBACK_TRIGGERING_EVENT_STATUS_INVALID_EVENT_TYPE;
+        }
+
+        CurrentProcessId = PsGetCurrentProcessId();
+        CurrentThreadId  = PsGetCurrentThreadId();
+
+        //
+        // First, the entries with the same discriminator, then the wildcard entries
+        //
+        RangeStart[0] = KeyedStart;
+        RangeEnd[0]   = KeyedEnd;
+        RangeStart[1] = WildcardStart;
+        RangeEnd[1]   = WildcardEnd;
+
+        for (UINT32 RangeIndex = 0; RangeIndex < DEBUGGER_EVENTS_INDEX_CANDIDATE_LISTS_COUNT; RangeIndex++)
+        {
+            for (UINT32 i = RangeStart[RangeIndex]; i < RangeEnd[RangeIndex]; i++)
+            {
+                ArmedEvent = &Snapshot->Entries[i];
+
+                if (ArmedEvent->ProcessId != DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES && ArmedEvent->ProcessId != CurrentProcessId)
+                {
+                    //
+                    // This event is not related to either our process or all processes
+                    //
+                    continue;
+                }
+
+                if (ArmedEvent->ThreadId != DEBUGGER_EVENT_APPLY_TO_ALL_THREADS && ArmedEvent->ThreadId != CurrentThreadId)
+                {
+                    //
+                    // This event is not related to either our thread or all threads
+                    //
+                    continue;
+                }
+
+                //
+                // Check the event and perform its actions
+                //
+                DebuggerTriggerSingleEvent(DbgState, ArmedEvent->Event, CallingStage, Context, PostEventRequired);
+            }
+        }
     }
     else
     {
         //
-        // Because the user might change the nonvolatile registers, we save fastcall nonvolatile registers
+        // Find the candidate events from the lookup index based on the type
+        // of the event and its discriminator (MSR number, I/O port, etc.),
+        // the first list contains the events with the same discriminator and
+        // the second list contains the events that match all the discriminators
         //
-        AsmDebuggerCustomCodeHandler(Action->RequestedBuffer.RequstBufferAddress, DbgState->Regs, Context, Action->CustomCodeBufferAddress);
+        if (!DebuggerEventsIndexGetCandidateLists(EventType, Context, &CandidateLists[0], &CandidateLists[1]))
+        {
+            DebuggerArmedEventsExitDispatch(DbgState);
+            LogSetEventTriggerTimestamp(PreviousTriggerTimestamp);
+            return VMM_CALLBACK_TRIGGERING_EVENT_STATUS_INVALID_EVENT_TYPE;
+        }
+
+        for (UINT32 ListIndex = 0; ListIndex < DEBUGGER_EVENTS_INDEX_CANDIDATE_LISTS_COUNT; ListIndex++)
+        {
+            TempList  = CandidateLists[ListIndex];
+            TempList2 = TempList;
+
+            if (TempList == NULL)
+            {
+                continue;
+            }
+
+            while (TempList2 != TempList->Flink)
+            {
+                TempList                     = TempList->Flink;
+                PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameIndexList);
+
+                //
+                // Check the event and perform its actions
+                //
+                DebuggerTriggerSingleEvent(DbgState, CurrentEvent, CallingStage, Context, PostEventRequired);
+            }
+        }
     }
-}
 
-/**
- * @brief Manage breaking to the debugger action
- *
- * @param DbgState The state of the debugger on the current core
- * @param Tag Tag of event
- * @param Action Action object
- * @param Context Optional parameter
- *
- * @return VOID
- */
-VOID
-DebuggerPerformBreakToDebugger(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 Tag, PDEBUGGER_EVENT_ACTION Action, PVOID Context)
-{
-    DEBUGGER_TRIGGERED_EVENT_DETAILS ContextAndTag = {0};
+    DebuggerArmedEventsExitDispatch(DbgState);
+    LogSetEventTriggerTimestamp(PreviousTriggerTimestamp);
 
-    if (VmFuncVmxGetCurrentExecutionMode() == TRUE)
+    //
+    // Check if the event should be ignored or not
+    //
+    if (DbgState->ShortCircuitingEvent)
     {
         //
-        // The guest is already in vmx-root mode
-        // Halt other cores
+        // Reset the the event ignorance (short-circuit) mechanism
         //
-        ContextAndTag.Tag     = Tag;
-        ContextAndTag.Context = Context;
+        DbgState->ShortCircuitingEvent = FALSE;
 
-        KdHandleBreakpointAndDebugBreakpoints(
-            DbgState,
-            DEBUGGEE_PAUSING_REASON_DEBUGGEE_EVENT_TRIGGERED,
-            &ContextAndTag);
+        //
+        // Event should be ignored
+        //
+        return VMM_CALLBACK_TRIGGERING_EVENT_STATUS_SUCCESSFUL_IGNORE_EVENT;
     }
     else
     {
         //
-        // The guest is on vmx non-root mode
+        // Event shouldn't be ignored
         //
-        VmFuncVmxVmcall(DEBUGGER_VMCALL_VM_EXIT_HALT_SYSTEM, 0, 0, 0);
+        return VMM_CALLBACK_TRIGGERING_EVENT_STATUS_SUCCESSFUL;
     }
 }
 
 /**
- * @brief Find event object by tag
+ * @brief Run a special event's action(s)
  *
- * @param Tag Tag of event
- * @return PDEBUGGER_EVENT Returns null if not found and event object if found
+ * @param DbgState The state of the debugger on the current core
+ * @param Event Event Object
+ * @param Context Optional parameter
+ * @return VOID
  */
-PDEBUGGER_EVENT
-DebuggerGetEventByTag(UINT64 Tag)
+VOID
+DebuggerPerformActions(PROCESSOR_DEBUGGING_STATE * DbgState, PDEBUGGER_EVENT Event, PVOID Context)
 {
-    PLIST_ENTRY TempList  = 0;
-    PLIST_ENTRY TempList2 = 0;
+    PLIST_ENTRY TempList = 0;
 
     //
-    // We have to iterate through all events
+    // Find and run all the actions in this Event
     //
-    for (size_t i = 0; i < sizeof(DEBUGGER_CORE_EVENTS) / sizeof(LIST_ENTRY); i++)
+    TempList = &Event->ActionsListHead;
+    while (&Event->ActionsListHead != TempList->Flink)
     {
-        TempList  = (PLIST_ENTRY)((UINT64)(g_Events) + (i * sizeof(LIST_ENTRY)));
-        TempList2 = TempList;
+        TempList                             = TempList->Flink;
+        PDEBUGGER_EVENT_ACTION CurrentAction = CONTAINING_RECORD(TempList, DEBUGGER_EVENT_ACTION, ActionsList);
 
-        while (TempList2 != TempList->Flink)
+        //
+        // Perform the action
+        //
+        switch (CurrentAction->ActionType)
         {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+        case BREAK_TO_DEBUGGER:
+            DebuggerPerformBreakToDebugger(DbgState, Event->Tag, CurrentAction, Context);
+            break;
+        case RUN_SCRIPT:
+            DebuggerPerformRunScript(DbgState, Event->Tag, CurrentAction, NULL, Event->IsOutputDisabled, Context);
+            break;
+        case RUN_CUSTOM_CODE:
+            DebuggerPerformRunTheCustomCode(DbgState, Event->Tag, CurrentAction, Context);
+            break;
+        case SHOW_LAST_BRANCH_RECORDS:
 
             //
-            // Check if we find the event or not
+            // The records are only shown, so they're not read if the output
+            // of the event is disabled
             //
-            if (CurrentEvent->Tag == Tag)
+            if (!Event->IsOutputDisabled)
             {
-                return CurrentEvent;
+                DebuggerPerformShowLastBranchRecords(DbgState, Event->Tag, CurrentAction, Context);
             }
+
+            break;
+        case RECORD_HITS:
+            DebuggerEventRecordsRecordHit(DbgState, Event->Tag, CurrentAction);
+            break;
+        default:
+
+            //
+            // Invalid action type
+            //
+            break;
         }
     }
-
-    //
-    // We didn't find anything, so return null
-    //
-    return NULL;
 }
 
 /**
- * @brief Enable or disable all events from all the types
+ * @brief Add a run of the script of an action to its statistics
  *
- * @param IsEnable If you want to enable then true and if
- * you want to disable then false
- * @return BOOLEAN if at least one event enabled/disabled then
- * it returns true, and otherwise false
+ * @param Action Action object
+ * @param Tsc TSC cycles that are spent in the script
+ * @param Instructions Count of the executed instructions
+ * @param IsAborted Whether the script is aborted as it exceeded the
+ * instruction budget
+ * @return VOID
  */
-BOOLEAN
-DebuggerEnableOrDisableAllEvents(BOOLEAN IsEnable)
+static VOID
+DebuggerUpdateScriptStatistics(PDEBUGGER_EVENT_ACTION Action, UINT64 Tsc, UINT64 Instructions, BOOLEAN IsAborted)
 {
-    BOOLEAN     FindAtLeastOneEvent = FALSE;
-    PLIST_ENTRY TempList            = 0;
-    PLIST_ENTRY TempList2           = 0;
+    PDEBUGGER_EVENT_SCRIPT_STATISTICS Statistics = &Action->ScriptStatistics;
+    LONG64                            MaximumTsc;
 
     //
-    // We have to iterate through all events
+    // The same action might be run on all cores at the same time
     //
-    for (size_t i = 0; i < sizeof(DEBUGGER_CORE_EVENTS) / sizeof(LIST_ENTRY); i++)
+    InterlockedIncrement64((volatile LONG64 *)&Statistics->Invocations);
+    InterlockedAdd64((volatile LONG64 *)&Statistics->TotalTsc, Tsc);
+    InterlockedAdd64((volatile LONG64 *)&Statistics->Instructions, Instructions);
+
+    if (IsAborted)
     {
-        TempList  = (PLIST_ENTRY)((UINT64)(g_Events) + (i * sizeof(LIST_ENTRY)));
-        TempList2 = TempList;
+        InterlockedIncrement64((volatile LONG64 *)&Statistics->AbortedRuns);
+    }
 
-        while (TempList2 != TempList->Flink)
-        {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+    MaximumTsc = Statistics->MaximumTsc;
 
-            //
-            // Check if we find at least one event or not
-            //
-            if (!FindAtLeastOneEvent)
-            {
-                FindAtLeastOneEvent = TRUE;
-            }
+    while ((UINT64)MaximumTsc < Tsc)
+    {
+        LONG64 PreviousMaximumTsc = InterlockedCompareExchange64((volatile LONG64 *)&Statistics->MaximumTsc, Tsc, MaximumTsc);
 
-            //
-            // Enable or disable event
-            //
-            CurrentEvent->Enabled = IsEnable;
+        if (PreviousMaximumTsc == MaximumTsc)
+        {
+            break;
         }
-    }
 
-    return FindAtLeastOneEvent;
+        MaximumTsc = PreviousMaximumTsc;
+    }
 }
 
 /**
- * @brief Terminate effect and configuration to vmx-root
- * and non-root for all the events
+ * @brief Managing run script action
+ * @details the cost of running the script of actions is added to the
+ * statistics of the action, and the script is aborted if it exceeds the
+ * instruction budget of the action
  *
- * @return BOOLEAN if at least one event terminated then
- * it returns true, and otherwise false
+ * @param DbgState The state of the debugger on the current core
+ * @param Tag Tag of event
+ * @param Action Action object
+ * @param ScriptDetails The script packet (if it's not an action)
+ * @param IsOutputDisabled Whether the messages of the script (print and
+ * printf) are not generated
+ * @param Context Optional parameter
+ * @return BOOLEAN
  */
 BOOLEAN
-DebuggerTerminateAllEvents()
+DebuggerPerformRunScript(PROCESSOR_DEBUGGING_STATE * DbgState,
+                         UINT64                      Tag,
+                         PDEBUGGER_EVENT_ACTION      Action,
+                         PDEBUGGEE_SCRIPT_PACKET     ScriptDetails,
+                         BOOLEAN                     IsOutputDisabled,
+                         PVOID                       Context)
 {
-    BOOLEAN     FindAtLeastOneEvent = FALSE;
-    PLIST_ENTRY TempList            = 0;
-    PLIST_ENTRY TempList2           = 0;
+    SYMBOL_BUFFER                CodeBuffer    = {0};
+    ACTION_BUFFER                ActionBuffer  = {0};
+    SYMBOL                       ErrorSymbol   = {0};
+    SCRIPT_ENGINE_VARIABLES_LIST VariablesList = {0};
+    UINT64                       StartTsc      = __rdtsc();
+    BOOLEAN                      IsAborted     = FALSE;
 
-    //
-    // We have to iterate through all events
-    //
-    for (size_t i = 0; i < sizeof(DEBUGGER_CORE_EVENTS) / sizeof(LIST_ENTRY); i++)
+    if (Action != NULL)
     {
-        TempList  = (PLIST_ENTRY)((UINT64)(g_Events) + (i * sizeof(LIST_ENTRY)));
-        TempList2 = TempList;
-
-        while (TempList2 != TempList->Flink)
-        {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+        //
+        // Fill the action buffer
+        //
+        ActionBuffer.Context                   = Context;
+        ActionBuffer.ImmediatelySendTheResults = Action->ImmediatelySendTheResults;
+        ActionBuffer.IsOutputDisabled          = IsOutputDisabled;
+        ActionBuffer.CurrentAction             = Action;
+        ActionBuffer.Tag                       = Tag;
+        ActionBuffer.InstructionsBudget        = Action->ScriptConfiguration.InstructionsBudget;
 
-            //
-            // Check if we find at least one event or not
-            //
-            if (!FindAtLeastOneEvent)
-            {
-                FindAtLeastOneEvent = TRUE;
-            }
+        //
+        // Context point to the registers
+        //
+        CodeBuffer.Head    = Action->ScriptConfiguration.ScriptBuffer;
+        CodeBuffer.Size    = Action->ScriptConfiguration.ScriptLength;
+        CodeBuffer.Pointer = Action->ScriptConfiguration.ScriptPointer;
+    }
+    else if (ScriptDetails != NULL)
+    {
+        //
+        // Fill the action buffer
+        //
+        ActionBuffer.Context                   = Context;
+        ActionBuffer.ImmediatelySendTheResults = TRUE;
+        ActionBuffer.IsOutputDisabled          = IsOutputDisabled;
+        ActionBuffer.CurrentAction             = NULL;
+        ActionBuffer.Tag                       = Tag;
 
-            //
-            // Terminate the current event
-            //
-            DebuggerTerminateEvent(CurrentEvent->Tag);
-        }
+        //
+        // Context point to the registers
+        //
+        CodeBuffer.Head    = ((CHAR *)ScriptDetails + sizeof(DEBUGGEE_SCRIPT_PACKET));
+        CodeBuffer.Size    = ScriptDetails->ScriptBufferSize;
+        CodeBuffer.Pointer = ScriptDetails->ScriptBufferPointer;
+    }
+    else
+    {
+        //
+        // The parameters are wrong !
+        //
+        return FALSE;
     }
 
-    return FindAtLeastOneEvent;
-}
+    //
+    // Fill the variables list for this run
+    //
+    VariablesList.GlobalVariablesList = g_ScriptGlobalVariables;
+    VariablesList.LocalVariablesList  = DbgState->ScriptEngineCoreSpecificLocalVariable;
+    VariablesList.TempList            = DbgState->ScriptEngineCoreSpecificTempVariable;
 
-/**
- * @brief Remove all the events from all the lists
- * and also de-allocate their structures and actions
- *
- * @details should not be called from vmx-root mode, also
- * it won't terminate their effects, so the events should
- * be terminated first then we can remove them
- *
- * @return BOOLEAN if at least one event removed then
- * it returns true, and otherwise false
- */
-BOOLEAN
-DebuggerRemoveAllEvents()
-{
-    BOOLEAN     FindAtLeastOneEvent = FALSE;
-    PLIST_ENTRY TempList            = 0;
-    PLIST_ENTRY TempList2           = 0;
+    //
+    // Buffers of the scratch memory are only valid in a single script
+    //
+    DbgState->ScriptEngineScratchUsed = 0;
 
     //
-    // We have to iterate through all events
+    // Messages of the script are sent as a single message once the
+    // script is finished
     //
-    for (size_t i = 0; i < sizeof(DEBUGGER_CORE_EVENTS) / sizeof(LIST_ENTRY); i++)
-    {
-        TempList  = (PLIST_ENTRY)((UINT64)(g_Events) + (i * sizeof(LIST_ENTRY)));
-        TempList2 = TempList;
+    ScriptEngineOutputBegin(DbgState);
 
-        while (TempList2 != TempList->Flink)
+    //
+    // If the script is pre-compiled, then the bytecode is executed instead
+    // of decoding the symbols
+    //
+    if (Action != NULL && Action->ScriptBytecode != NULL)
+    {
+        if (ScriptEngineBytecodeExecute(DbgState->Regs,
+                                        &ActionBuffer,
+                                        &VariablesList,
+                                        Action->ScriptBytecode,
+                                        &ErrorSymbol) == TRUE)
         {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+            IsAborted = ActionBuffer.InstructionsBudget != 0 &&
+                        ActionBuffer.InstructionsCount > ActionBuffer.InstructionsBudget;
 
+            if (!IsAborted)
+            {
+                CHAR NameOfOperator[MAX_FUNCTION_NAME_LENGTH] = {0};
+                ScriptEngineGetOperatorName(&ErrorSymbol, NameOfOperator);
+                LogInfo("Invalid returning address for operator: %s", NameOfOperator);
+            }
+        }
+    }
+    else
+    {
+        for (int i = 0; i < CodeBuffer.Pointer;)
+        {
             //
-            // Check if we find at least one event or not
+            // The script is aborted if it exceeds the instruction budget
             //
-            if (!FindAtLeastOneEvent)
+            ActionBuffer.InstructionsCount++;
+
+            if (ActionBuffer.InstructionsBudget != 0 &&
+                ActionBuffer.InstructionsCount > ActionBuffer.InstructionsBudget)
             {
-                FindAtLeastOneEvent = TRUE;
+                IsAborted = TRUE;
+                break;
             }
 
             //
-            // Remove the current event
+            // If has error, show error message and abort.
             //
-            DebuggerRemoveEvent(CurrentEvent->Tag);
+            if (ScriptEngineExecute(DbgState->Regs,
+                                    &ActionBuffer,
+                                    &VariablesList,
+                                    &CodeBuffer,
+                                    &i,
+                                    &ErrorSymbol) == TRUE)
+            {
+                CHAR NameOfOperator[MAX_FUNCTION_NAME_LENGTH] = {0};
+                ScriptEngineGetOperatorName(&ErrorSymbol, NameOfOperator);
+                LogInfo("Invalid returning address for operator: %s", NameOfOperator);
+                break;
+            }
         }
     }
 
-    return FindAtLeastOneEvent;
+    if (IsAborted)
+    {
+        LogInfo("The script of event %llx is aborted, it exceeded the instruction budget (%llx)",
+                Tag - DebuggerEventTagStartSeed,
+                ActionBuffer.InstructionsBudget);
+    }
+
+    ScriptEngineOutputEnd(DbgState);
+
+    if (Action != NULL)
+    {
+        DebuggerUpdateScriptStatistics(Action, __rdtsc() - StartTsc, ActionBuffer.InstructionsCount, IsAborted);
+    }
+
+    return TRUE;
 }
 
 /**
- * @brief Count the list of events in a special list
+ * @brief Manage running the custom code action
  *
- * @param TargetEventList target event list
- * @return UINT32 count of events on the list
+ * @param DbgState The state of the debugger on the current core
+ * @param Tag Tag of event
+ * @param Action Action object
+ * @param Context Optional parameter
+ * @return VOID
  */
-UINT32
-DebuggerEventListCount(PLIST_ENTRY TargetEventList)
+VOID
+DebuggerPerformRunTheCustomCode(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 Tag, PDEBUGGER_EVENT_ACTION Action, PVOID Context)
 {
-    PLIST_ENTRY TempList = 0;
-    UINT32      Counter  = 0;
+    if (Action->CustomCodeBufferSize == 0)
+    {
+        //
+        // Sth went wrong ! the buffer size for custom code shouldn't be zero
+        //
+        return;
+    }
 
     //
-    // We have to iterate through all events of this list
+    // -----------------------------------------------------------------------------------------------------
+    // Test (Should be removed)
+    //
+    // LogInfo("%X       Called from : %llx", Tag, Context);
+    //
+    //
+    // LogInfo("Process Id : %x , Rax : %llx , R8 : %llx , Context : 0x%llx ", PsGetCurrentProcessId(), Regs->rax, Regs->r8, Context);
+    // return;
+    //
+    // -----------------------------------------------------------------------------------------------------
     //
-    TempList = TargetEventList;
 
-    while (TargetEventList != TempList->Flink)
+    //
+    // Run the custom code
+    //
+    if (Action->RequestedBuffer.RequestBufferSize == 0)
     {
-        TempList                     = TempList->Flink;
-        PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
-
         //
-        // Increase the counter
+        // Because the user might change the nonvolatile registers, we save fastcall nonvolatile registers
         //
-        Counter++;
+        AsmDebuggerCustomCodeHandler(NULL, DbgState->Regs, Context, Action->CustomCodeBufferAddress);
+    }
+    else
+    {
+        //
+        // Because the user might change the nonvolatile registers, we save fastcall nonvolatile registers
+        //
+        AsmDebuggerCustomCodeHandler(Action->RequestedBuffer.RequstBufferAddress, DbgState->Regs, Context, Action->CustomCodeBufferAddress);
     }
-
-    return Counter;
 }
 
 /**
- * @brief Get List of event based on event type
+ * @brief Manage showing the last branch records (LBR) action
+ * @details the most recent branch is shown first
  *
- * @param EventType type of event
- * @return PLIST_ENTRY
+ * @param DbgState The state of the debugger on the current core
+ * @param Tag Tag of event
+ * @param Action Action object
+ * @param Context Optional parameter
+ * @return VOID
  */
-PLIST_ENTRY
-DebuggerGetEventListByEventType(VMM_EVENT_TYPE_ENUM EventType)
+VOID
+DebuggerPerformShowLastBranchRecords(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 Tag, PDEBUGGER_EVENT_ACTION Action, PVOID Context)
 {
-    PLIST_ENTRY ResultList = NULL;
+    DEBUGGER_LAST_BRANCH_RECORD Records[LastBranchRecordsMaximumCount];
+    CHAR                        Message[LastBranchRecordsMaximumCount * 48 + 64];
+    INT32                       Length = 0;
+    UINT32                      Count;
+
+    UNREFERENCED_PARAMETER(Context);
+
     //
-    // Register the event
+    // The records are only available in vmx-root (the events that are
+    // triggered in vmx non-root are shown without any record)
     //
-    switch (EventType)
+    Count = VmFuncGetLastBranchRecords(Records, Action->LastBranchRecordsCount);
+
+    Length += sprintf_s(Message + Length, sizeof(Message) - Length, "last branch records (core: %x, count: %x):\n", DbgState->CoreId, Count);
+
+    for (UINT32 i = 0; i < Count; i++)
     {
-    case HIDDEN_HOOK_READ_AND_WRITE_AND_EXECUTE:
-        ResultList = &g_Events->HiddenHookReadAndWriteAndExecuteEventsHead;
-        break;
-    case HIDDEN_HOOK_READ_AND_WRITE:
-        ResultList = &g_Events->HiddenHookReadAndWriteEventsHead;
-        break;
-    case HIDDEN_HOOK_READ_AND_EXECUTE:
-        ResultList = &g_Events->HiddenHookReadAndExecuteEventsHead;
-        break;
+        Length += sprintf_s(Message + Length,
+                            sizeof(Message) - Length,
+                            "  %02x: %016llx -> %016llx\n",
+                            i,
+                            Records[i].FromAddress,
+                            Records[i].ToAddress);
+    }
+
+    LogSimpleWithTag(Tag, Action->ImmediatelySendTheResults, Message, Length + 1);
+}
+
+/**
+ * @brief Manage breaking to the debugger action
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param Tag Tag of event
+ * @param Action Action object
+ * @param Context Optional parameter
+ *
+ * @return VOID
+ */
+VOID
+DebuggerPerformBreakToDebugger(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 Tag, PDEBUGGER_EVENT_ACTION Action, PVOID Context)
+{
+    DEBUGGER_TRIGGERED_EVENT_DETAILS ContextAndTag = {0};
+
+    if (VmFuncVmxGetCurrentExecutionMode() == TRUE)
+    {
+        //
+        // The guest is already in vmx-root mode
+        // Halt other cores
+        //
+        ContextAndTag.Tag     = Tag;
+        ContextAndTag.Context = Context;
+
+        KdHandleBreakpointAndDebugBreakpoints(
+            DbgState,
+            DEBUGGEE_PAUSING_REASON_DEBUGGEE_EVENT_TRIGGERED,
+            &ContextAndTag);
+    }
+    else
+    {
+        //
+        // The guest is on vmx non-root mode
+        //
+        VmFuncVmxVmcall(DEBUGGER_VMCALL_VM_EXIT_HALT_SYSTEM, 0, 0, 0);
+    }
+}
+
+/**
+ * @brief Find event object by tag
+ *
+ * @param Tag Tag of event
+ * @return PDEBUGGER_EVENT Returns null if not found and event object if found
+ */
+PDEBUGGER_EVENT
+DebuggerGetEventByTag(UINT64 Tag)
+{
+    PLIST_ENTRY TempList  = 0;
+    PLIST_ENTRY TempList2 = 0;
+
+    //
+    // We have to iterate through all events
+    //
+    for (size_t i = 0; i < sizeof(DEBUGGER_CORE_EVENTS) / sizeof(LIST_ENTRY); i++)
+    {
+        TempList  = (PLIST_ENTRY)((UINT64)(g_Events) + (i * sizeof(LIST_ENTRY)));
+        TempList2 = TempList;
+
+        while (TempList2 != TempList->Flink)
+        {
+            TempList                     = TempList->Flink;
+            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+
+            //
+            // Check if we find the event or not
+            //
+            if (CurrentEvent->Tag == Tag)
+            {
+                return CurrentEvent;
+            }
+        }
+    }
+
+    //
+    // We didn't find anything, so return null
+    //
+    return NULL;
+}
+
+/**
+ * @brief Enable or disable all events from all the types
+ *
+ * @param IsEnable If you want to enable then true and if
+ * you want to disable then false
+ * @return BOOLEAN if at least one event enabled/disabled then
+ * it returns true, and otherwise false
+ */
+BOOLEAN
+DebuggerEnableOrDisableAllEvents(BOOLEAN IsEnable)
+{
+    BOOLEAN     FindAtLeastOneEvent = FALSE;
+    PLIST_ENTRY TempList            = 0;
+    PLIST_ENTRY TempList2           = 0;
+
+    //
+    // The hardware controls of the disabled events are released once
+    // for all of the events
+    //
+    if (!IsEnable)
+    {
+        TerminateStartDeferringClears();
+    }
+
+    //
+    // We have to iterate through all events
+    //
+    for (size_t i = 0; i < sizeof(DEBUGGER_CORE_EVENTS) / sizeof(LIST_ENTRY); i++)
+    {
+        TempList  = (PLIST_ENTRY)((UINT64)(g_Events) + (i * sizeof(LIST_ENTRY)));
+        TempList2 = TempList;
+
+        while (TempList2 != TempList->Flink)
+        {
+            TempList                     = TempList->Flink;
+            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+
+            //
+            // Check if we find at least one event or not
+            //
+            if (!FindAtLeastOneEvent)
+            {
+                FindAtLeastOneEvent = TRUE;
+            }
+
+            //
+            // Enable or disable event, the events that can't be armed
+            // again remain disabled
+            //
+            if (IsEnable)
+            {
+                CurrentEvent->Enabled = DebuggerArmEvent(CurrentEvent);
+            }
+            else
+            {
+                CurrentEvent->Enabled = FALSE;
+                DebuggerDisarmEvent(CurrentEvent);
+            }
+        }
+    }
+
+    if (!IsEnable)
+    {
+        TerminateFlushDeferredClears();
+    }
+
+    //
+    // Cores should re-snapshot their armed events
+    //
+    DebuggerArmedEventsInvalidate();
+
+    return FindAtLeastOneEvent;
+}
+
+/**
+ * @brief Terminate effect and configuration to vmx-root
+ * and non-root for all the events
+ *
+ * @return BOOLEAN if at least one event terminated then
+ * it returns true, and otherwise false
+ */
+BOOLEAN
+DebuggerTerminateAllEvents()
+{
+    BOOLEAN     FindAtLeastOneEvent = FALSE;
+    PLIST_ENTRY TempList            = 0;
+    PLIST_ENTRY TempList2           = 0;
+
+    //
+    // Each per-core resource of the events (e.g., rdtsc exiting) is
+    // cleared once after terminating all of the events
+    //
+    TerminateStartDeferringClears();
+
+    //
+    // We have to iterate through all events
+    //
+    for (size_t i = 0; i < sizeof(DEBUGGER_CORE_EVENTS) / sizeof(LIST_ENTRY); i++)
+    {
+        TempList  = (PLIST_ENTRY)((UINT64)(g_Events) + (i * sizeof(LIST_ENTRY)));
+        TempList2 = TempList;
+
+        while (TempList2 != TempList->Flink)
+        {
+            TempList                     = TempList->Flink;
+            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+
+            //
+            // Check if we find at least one event or not
+            //
+            if (!FindAtLeastOneEvent)
+            {
+                FindAtLeastOneEvent = TRUE;
+            }
+
+            //
+            // Terminate the current event
+            //
+            DebuggerTerminateEvent(CurrentEvent->Tag);
+        }
+    }
+
+    //
+    // Clear the resources that are not used by any event anymore
+    //
+    TerminateFlushDeferredClears();
+
+    return FindAtLeastOneEvent;
+}
+
+/**
+ * @brief Remove all the events from all the lists
+ * and also de-allocate their structures and actions
+ *
+ * @details should not be called from vmx-root mode, also
+ * it won't terminate their effects, so the events should
+ * be terminated first then we can remove them
+ *
+ * @return BOOLEAN if at least one event removed then
+ * it returns true, and otherwise false
+ */
+BOOLEAN
+DebuggerRemoveAllEvents()
+{
+    BOOLEAN     FindAtLeastOneEvent = FALSE;
+    PLIST_ENTRY TempList            = 0;
+    PLIST_ENTRY TempList2           = 0;
+
+    //
+    // We have to iterate through all events
+    //
+    for (size_t i = 0; i < sizeof(DEBUGGER_CORE_EVENTS) / sizeof(LIST_ENTRY); i++)
+    {
+        TempList  = (PLIST_ENTRY)((UINT64)(g_Events) + (i * sizeof(LIST_ENTRY)));
+        TempList2 = TempList;
+
+        while (TempList2 != TempList->Flink)
+        {
+            TempList                     = TempList->Flink;
+            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+
+            //
+            // Check if we find at least one event or not
+            //
+            if (!FindAtLeastOneEvent)
+            {
+                FindAtLeastOneEvent = TRUE;
+            }
+
+            //
+            // Remove the current event
+            //
+            DebuggerRemoveEvent(CurrentEvent->Tag);
+        }
+    }
+
+    return FindAtLeastOneEvent;
+}
+
+/**
+ * @brief Count the list of events in a special list
+ *
+ * @param TargetEventList target event list
+ * @return UINT32 count of events on the list
+ */
+UINT32
+DebuggerEventListCount(PLIST_ENTRY TargetEventList)
+{
+    PLIST_ENTRY TempList = 0;
+    UINT32      Counter  = 0;
+
+    //
+    // We have to iterate through all events of this list
+    //
+    TempList = TargetEventList;
+
+    while (TargetEventList != TempList->Flink)
+    {
+        TempList                     = TempList->Flink;
+        PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+
+        //
+        // Increase the counter
+        //
+        Counter++;
+    }
+
+    return Counter;
+}
+
+/**
+ * @brief Get List of event based on event type
+ *
+ * @param EventType type of event
+ * @return PLIST_ENTRY
+ */
+PLIST_ENTRY
+DebuggerGetEventListByEventType(VMM_EVENT_TYPE_ENUM EventType)
+{
+    PLIST_ENTRY ResultList = NULL;
+    //
+    // Register the event
+    //
+    switch (EventType)
+    {
+    case HIDDEN_HOOK_READ_AND_WRITE_AND_EXECUTE:
+        ResultList = &g_Events->HiddenHookReadAndWriteAndExecuteEventsHead;
+        break;
+    case HIDDEN_HOOK_READ_AND_WRITE:
+        ResultList = &g_Events->HiddenHookReadAndWriteEventsHead;
+        break;
+    case HIDDEN_HOOK_READ_AND_EXECUTE:
+        ResultList = &g_Events->HiddenHookReadAndExecuteEventsHead;
+        break;
     case HIDDEN_HOOK_WRITE_AND_EXECUTE:
         ResultList = &g_Events->HiddenHookWriteAndExecuteEventsHead;
         break;
@@ -1547,179 +2317,2045 @@ DebuggerGetEventListByEventType(VMM_EVENT_TYPE_ENUM EventType)
         ResultList = &g_Events->EptHookExecCcEventsHead;
         break;
     case SYSCALL_HOOK_EFER_SYSCALL:
-        ResultList = &g_Events->SyscallHooksEferSyscallEventsHead;
-        break;
+        ResultList = &g_Events->SyscallHooksEferSyscallEventsHead;
+        break;
+    case SYSCALL_HOOK_EFER_SYSRET:
+        ResultList = &g_Events->SyscallHooksEferSysretEventsHead;
+        break;
+    case CPUID_INSTRUCTION_EXECUTION:
+        ResultList = &g_Events->CpuidInstructionExecutionEventsHead;
+        break;
+    case RDMSR_INSTRUCTION_EXECUTION:
+        ResultList = &g_Events->RdmsrInstructionExecutionEventsHead;
+        break;
+    case WRMSR_INSTRUCTION_EXECUTION:
+        ResultList = &g_Events->WrmsrInstructionExecutionEventsHead;
+        break;
+    case EXCEPTION_OCCURRED:
+        ResultList = &g_Events->ExceptionOccurredEventsHead;
+        break;
+    case TSC_INSTRUCTION_EXECUTION:
+        ResultList = &g_Events->TscInstructionExecutionEventsHead;
+        break;
+    case PMC_INSTRUCTION_EXECUTION:
+        ResultList = &g_Events->PmcInstructionExecutionEventsHead;
+        break;
+    case IN_INSTRUCTION_EXECUTION:
+        ResultList = &g_Events->InInstructionExecutionEventsHead;
+        break;
+    case OUT_INSTRUCTION_EXECUTION:
+        ResultList = &g_Events->OutInstructionExecutionEventsHead;
+        break;
+    case DEBUG_REGISTERS_ACCESSED:
+        ResultList = &g_Events->DebugRegistersAccessedEventsHead;
+        break;
+    case EXTERNAL_INTERRUPT_OCCURRED:
+        ResultList = &g_Events->ExternalInterruptOccurredEventsHead;
+        break;
+    case VMCALL_INSTRUCTION_EXECUTION:
+        ResultList = &g_Events->VmcallInstructionExecutionEventsHead;
+        break;
+    case CONTROL_REGISTER_MODIFIED:
+        ResultList = &g_Events->ControlRegisterModifiedEventsHead;
+        break;
+    case PAGE_FIRST_EXECUTION:
+        ResultList = &g_Events->PageFirstExecutionEventsHead;
+        break;
+    default:
+
+        //
+        // Wrong event type
+        //
+        LogError("Err, wrong event type is specified");
+        ResultList = NULL;
+        break;
+    }
+
+    return ResultList;
+}
+
+/**
+ * @brief Count the list of events in a special list that
+ * are activate on a target core
+ *
+ * @param TargetEventList target event list
+ * @param TargetCore target core
+ * @return UINT32 count of events on the list which is activated
+ * on the target core
+ */
+UINT32
+DebuggerEventListCountByCore(PLIST_ENTRY TargetEventList, UINT32 TargetCore)
+{
+    PLIST_ENTRY TempList = 0;
+    UINT32      Counter  = 0;
+
+    //
+    // We have to iterate through all events of this list
+    //
+    TempList = TargetEventList;
+
+    while (TargetEventList != TempList->Flink)
+    {
+        TempList                     = TempList->Flink;
+        PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+
+        if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES || CurrentEvent->CoreId == TargetCore)
+        {
+            //
+            // Increase the counter
+            //
+            Counter++;
+        }
+    }
+
+    return Counter;
+}
+
+/**
+ * @brief Count the list of events by a special event type that
+ * are activate on a target core
+ *
+ * @param EventType target event type
+ * @param TargetCore target core
+ *
+ * @return UINT32 count of events on the list which is activated
+ * on the target core
+ */
+UINT32
+DebuggerEventListCountByEventType(VMM_EVENT_TYPE_ENUM EventType, UINT32 TargetCore)
+{
+    PLIST_ENTRY TempList = 0;
+    UINT32      Counter  = 0;
+
+    PLIST_ENTRY TargetEventList = DebuggerGetEventListByEventType(EventType);
+
+    //
+    // We have to iterate through all events of this list
+    //
+    TempList = TargetEventList;
+
+    while (TargetEventList != TempList->Flink)
+    {
+        TempList                     = TempList->Flink;
+        PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+
+        if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES || CurrentEvent->CoreId == TargetCore)
+        {
+            //
+            // Increase the counter
+            //
+            Counter++;
+        }
+    }
+
+    return Counter;
+}
+
+/**
+ * @brief Get the mask of the cores that an event is applied to
+ * @details the events of the cores that are not representable in the
+ * mask are treated like the events of all cores
+ *
+ * @param CoreId The target core (or DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
+ *
+ * @return UINT64 The mask of cores (or DEBUGGER_BROADCASTING_ALL_CORES_MASK)
+ */
+UINT64
+DebuggerGetCoreMaskOfEvent(UINT32 CoreId)
+{
+    if (CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES || CoreId >= 64)
+    {
+        return DEBUGGER_BROADCASTING_ALL_CORES_MASK;
+    }
+
+    return 1ull << CoreId;
+}
+
+/**
+ * @brief Add or release a reference of an event to a resource of the
+ * bitmap ownership (I/O ports, exceptions, mov to debug or control
+ * registers)
+ * @details the hypervisor only changes the VMCS controls of the resources
+ * that are referenced for the first time or not referenced anymore
+ *
+ * @param CoreId The target core (or DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
+ * @param Acquire Whether to add or release the reference
+ * @param ResourceType Type of the resource
+ * @param Index The port, the vector or the control register
+ * @param Mask The mask of the control register
+ *
+ * @return VOID
+ */
+VOID
+DebuggerChangeBitmapOwnership(UINT32                         CoreId,
+                              BOOLEAN                        Acquire,
+                              BITMAP_OWNERSHIP_RESOURCE_TYPE ResourceType,
+                              UINT64                         Index,
+                              UINT64                         Mask)
+{
+    DEBUGGER_BROADCASTING_OPTIONS BroadcastingOption = {0};
+
+    BroadcastingOption.OptionalParam1 = ResourceType;
+    BroadcastingOption.OptionalParam2 = Index;
+    BroadcastingOption.OptionalParam3 = Mask;
+
+    //
+    // Let's see if it is for all cores or just one core
+    //
+    if (CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
+    {
+        //
+        // All cores
+        //
+        if (Acquire)
+        {
+            ExtensionCommandAcquireBitmapOwnershipAllCores(&BroadcastingOption);
+        }
+        else
+        {
+            ExtensionCommandReleaseBitmapOwnershipAllCores(&BroadcastingOption);
+        }
+    }
+    else
+    {
+        //
+        // Just one core
+        //
+        if (Acquire)
+        {
+            ConfigureAcquireBitmapOwnershipOnSingleCore(CoreId, &BroadcastingOption);
+        }
+        else
+        {
+            ConfigureReleaseBitmapOwnershipOnSingleCore(CoreId, &BroadcastingOption);
+        }
+    }
+}
+
+/**
+ * @brief Get the per-core resource that is used by an event
+ * @details the hooks of the IDT entries (!interrupt2) and the entry of
+ * system calls (!syscall3) are shared on all cores, so they don't use the
+ * per-core resources
+ *
+ * @param Event The target event
+ * @param Resource The resource of the event
+ *
+ * @return BOOLEAN Whether the event uses a per-core resource or not
+ */
+static BOOLEAN
+DebuggerGetEventResource(PDEBUGGER_EVENT Event, DEBUGGER_EVENT_RESOURCE_TYPE * Resource)
+{
+    switch (Event->EventType)
+    {
+    case EXTERNAL_INTERRUPT_OCCURRED:
+
+        *Resource = DEBUGGER_EVENT_RESOURCE_EXTERNAL_INTERRUPT_EXITING;
+        return Event->OptionalParam2 != DEBUGGER_EVENT_INTERRUPT_IDT_ENTRY_HOOK;
+
+    case TSC_INSTRUCTION_EXECUTION:
+
+        *Resource = DEBUGGER_EVENT_RESOURCE_RDTSC_EXITING;
+        return TRUE;
+
+    case PMC_INSTRUCTION_EXECUTION:
+
+        *Resource = DEBUGGER_EVENT_RESOURCE_RDPMC_EXITING;
+        return TRUE;
+
+    case SYSCALL_HOOK_EFER_SYSCALL:
     case SYSCALL_HOOK_EFER_SYSRET:
-        ResultList = &g_Events->SyscallHooksEferSysretEventsHead;
-        break;
-    case CPUID_INSTRUCTION_EXECUTION:
-        ResultList = &g_Events->CpuidInstructionExecutionEventsHead;
-        break;
+
+        *Resource = DEBUGGER_EVENT_RESOURCE_EFER_SYSCALL_HOOK;
+        return Event->OptionalParam2 != DEBUGGER_EVENT_SYSCALL_SYSRET_LSTAR_ENTRY_HOOK;
+
+    default:
+
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Add the references of an event to the per-core resource of
+ * its type
+ * @details called once the event is registered, so the resource is
+ * referenced before it's applied to the cores
+ *
+ * @param Event The target event
+ *
+ * @return VOID
+ */
+VOID
+DebuggerAcquireEventResource(PDEBUGGER_EVENT Event)
+{
+    DEBUGGER_EVENT_RESOURCE_TYPE Resource;
+    ULONG                        ProcessorsCount;
+
+    if (Event->IsResourceReferenced || !DebuggerGetEventResource(Event, &Resource))
+    {
+        return;
+    }
+
+    if (Event->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
+    {
+        ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+        for (size_t i = 0; i < ProcessorsCount; i++)
+        {
+            InterlockedIncrement(&g_DbgState[i].EventsResources.References[Resource]);
+        }
+    }
+    else
+    {
+        InterlockedIncrement(&g_DbgState[Event->CoreId].EventsResources.References[Resource]);
+    }
+
+    Event->IsResourceReferenced = TRUE;
+}
+
+/**
+ * @brief Release the references of an event to the per-core resource
+ * of its type
+ * @details the cores above 63 can't be targeted by the masks, so they're
+ * only cleared (by clearing all cores) once the resource is not used on
+ * any core, otherwise, they keep the resource (the events of other cores
+ * are filtered by the dispatcher)
+ *
+ * @param Event The target event
+ * @param Resource The resource of the event
+ *
+ * @return UINT64 The mask of the cores that the resource is not referenced
+ * on them anymore (zero if none)
+ */
+UINT64
+DebuggerReleaseEventResource(PDEBUGGER_EVENT Event, DEBUGGER_EVENT_RESOURCE_TYPE * Resource)
+{
+    UINT64  CoreMask        = 0;
+    BOOLEAN IsUpperReleased = FALSE;
+    ULONG   ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    if (!Event->IsResourceReferenced || !DebuggerGetEventResource(Event, Resource))
+    {
+        return 0;
+    }
+
+    Event->IsResourceReferenced = FALSE;
+
+    for (UINT32 i = 0; i < ProcessorsCount; i++)
+    {
+        if (Event->CoreId != DEBUGGER_EVENT_APPLY_TO_ALL_CORES && Event->CoreId != i)
+        {
+            continue;
+        }
+
+        if (InterlockedDecrement(&g_DbgState[i].EventsResources.References[*Resource]) == 0)
+        {
+            if (i < 64)
+            {
+                CoreMask |= 1ull << i;
+            }
+            else
+            {
+                IsUpperReleased = TRUE;
+            }
+        }
+    }
+
+    if (IsUpperReleased && !DebuggerIsEventResourceReferenced(*Resource))
+    {
+        return DEBUGGER_BROADCASTING_ALL_CORES_MASK;
+    }
+
+    return CoreMask;
+}
+
+/**
+ * @brief Check whether any event references a per-core resource on
+ * any core or not
+ *
+ * @param Resource The target resource
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+DebuggerIsEventResourceReferenced(DEBUGGER_EVENT_RESOURCE_TYPE Resource)
+{
+    ULONG ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    for (size_t i = 0; i < ProcessorsCount; i++)
+    {
+        if (g_DbgState[i].EventsResources.References[Resource] != 0)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Mark the per-core resource of an event to be applied on the
+ * cores of the event
+ * @details used in vmx-root as the other cores can't be broadcasted
+ * from vmx-root, each core applies its resources on its next vm-exit
+ * (or before it's continued in the debugger mode)
+ *
+ * @param Event The target event
+ * @param Resource The resource of the event
+ *
+ * @return VOID
+ */
+static VOID
+DebuggerMarkEventResourcePending(PDEBUGGER_EVENT Event, DEBUGGER_EVENT_RESOURCE_TYPE Resource)
+{
+    ULONG ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    for (UINT32 i = 0; i < ProcessorsCount; i++)
+    {
+        if (Event->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES || Event->CoreId == i)
+        {
+            InterlockedOr(&g_DbgState[i].EventsResources.PendingResources, 1 << Resource);
+        }
+    }
+
+    //
+    // The other cores are not halted in the VMI mode, so they're requested
+    // to apply their resources on their next vm-exit
+    //
+    VmcsPendingUpdatesRequestDebuggerTasks(DebuggerGetCoreMaskOfEvent(Event->CoreId));
+
+    //
+    // The current core is able to apply its resources right now
+    //
+    DebuggerApplyEventsResourcesOnCore(&g_DbgState[KeGetCurrentProcessorNumberEx(NULL)]);
+}
+
+/**
+ * @brief Apply the controls of the events (MSR bitmaps, I/O ports and
+ * exceptions) that are changed in vmx-root on the current core
+ * @details should be called in vmx-root, the controls are applied in
+ * the same order that they're queued
+ *
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return VOID
+ */
+static VOID
+DebuggerApplyEventsControlsOnCore(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    PDEBUGGER_EVENT_PENDING_CONTROL Control;
+    LONG                            Sequence = g_EventsPendingControls.Sequence;
+
+    for (LONG i = DbgState->EventsResources.AppliedControls; i != Sequence; i++)
+    {
+        Control = &g_EventsPendingControls.Controls[(ULONG)i % DEBUGGER_EVENTS_PENDING_CONTROLS_COUNT];
+
+        if (Control->CoreId != DEBUGGER_EVENT_APPLY_TO_ALL_CORES && Control->CoreId != DbgState->CoreId)
+        {
+            continue;
+        }
+
+        if (Control->IsMsrBitmap)
+        {
+            VmFuncChangeMsrBitmap(DbgState->CoreId, Control->Acquire, Control->IsWrite, Control->Index);
+        }
+        else
+        {
+            VmFuncChangeBitmapOwnership(DbgState->CoreId, Control->Acquire, Control->ResourceType, Control->Index, 0);
+        }
+    }
+
+    //
+    // The slots of the applied controls can be reused once all of the
+    // cores apply them
+    //
+    InterlockedExchange(&DbgState->EventsResources.AppliedControls, Sequence);
+}
+
+/**
+ * @brief Apply the pending per-core resources of the events on the
+ * current core
+ * @details should be called in vmx-root, each resource is set if at
+ * least one event references it on this core, otherwise it's unset, the
+ * controls of the events that are changed in vmx-root are also applied
+ *
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return VOID
+ */
+VOID
+DebuggerApplyEventsResourcesOnCore(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    LONG    PendingResources;
+    BOOLEAN IsSet;
+
+    DebuggerApplyEventsControlsOnCore(DbgState);
+
+    PendingResources = InterlockedExchange(&DbgState->EventsResources.PendingResources, 0);
+
+    for (UINT32 i = 0; PendingResources != 0 && i < DEBUGGER_EVENT_RESOURCE_COUNT; i++)
+    {
+        if (!(PendingResources & (1 << i)))
+        {
+            continue;
+        }
+
+        IsSet = DbgState->EventsResources.References[i] != 0;
+
+        switch (i)
+        {
+        case DEBUGGER_EVENT_RESOURCE_EXTERNAL_INTERRUPT_EXITING:
+
+            if (IsSet)
+            {
+                VmFuncSetExternalInterruptExiting(DbgState->CoreId, TRUE);
+            }
+            else
+            {
+                VmFuncUnsetExternalInterruptExitingOnlyOnClearingInterruptEvents(DbgState->CoreId);
+            }
+
+            break;
+
+        case DEBUGGER_EVENT_RESOURCE_RDTSC_EXITING:
+
+            if (IsSet)
+            {
+                VmFuncSetRdtscExiting(DbgState->CoreId, TRUE);
+            }
+            else
+            {
+                VmFuncUnsetRdtscExitingForClearingTscEvents(DbgState->CoreId);
+            }
+
+            break;
+
+        case DEBUGGER_EVENT_RESOURCE_RDPMC_EXITING:
+
+            VmFuncSetPmcVmexit(IsSet);
+            break;
+
+        case DEBUGGER_EVENT_RESOURCE_EFER_SYSCALL_HOOK:
+
+            VmFuncSetEferSyscallHook(DbgState->CoreId, IsSet);
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Get the control (MSR bitmap, I/O port or exception) that is
+ * referenced by an event
+ *
+ * @param Event The target event
+ * @param Acquire Whether to add or release the reference
+ * @param Control The control of the event
+ *
+ * @return BOOLEAN FALSE if the event doesn't reference any of them
+ */
+static BOOLEAN
+DebuggerGetEventControl(PDEBUGGER_EVENT Event, BOOLEAN Acquire, PDEBUGGER_EVENT_PENDING_CONTROL Control)
+{
+    RtlZeroMemory(Control, sizeof(DEBUGGER_EVENT_PENDING_CONTROL));
+
+    Control->CoreId  = Event->CoreId;
+    Control->Acquire = Acquire;
+    Control->Index   = Event->OptionalParam1;
+
+    switch (Event->EventType)
+    {
     case RDMSR_INSTRUCTION_EXECUTION:
-        ResultList = &g_Events->RdmsrInstructionExecutionEventsHead;
-        break;
+
+        Control->IsMsrBitmap = TRUE;
+        return TRUE;
+
     case WRMSR_INSTRUCTION_EXECUTION:
-        ResultList = &g_Events->WrmsrInstructionExecutionEventsHead;
+
+        Control->IsMsrBitmap = TRUE;
+        Control->IsWrite     = TRUE;
+        return TRUE;
+
+    case IN_INSTRUCTION_EXECUTION:
+    case OUT_INSTRUCTION_EXECUTION:
+
+        Control->ResourceType = BITMAP_OWNERSHIP_RESOURCE_IO_PORT;
+        return TRUE;
+
+    case EXCEPTION_OCCURRED:
+
+        Control->ResourceType = BITMAP_OWNERSHIP_RESOURCE_EXCEPTION;
+        return TRUE;
+
+    default:
+
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Add or release the reference of a control of an event on all
+ * of its cores
+ * @details should NOT be called in vmx-root
+ *
+ * @param Control The control of the event
+ *
+ * @return VOID
+ */
+static VOID
+DebuggerBroadcastEventControl(PDEBUGGER_EVENT_PENDING_CONTROL Control)
+{
+    BOOLEAN IsAllCores = Control->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES;
+
+    if (!Control->IsMsrBitmap)
+    {
+        DebuggerChangeBitmapOwnership(Control->CoreId, Control->Acquire, Control->ResourceType, Control->Index, 0);
+    }
+    else if (IsAllCores)
+    {
+        //
+        // All cores
+        //
+        if (Control->IsWrite && Control->Acquire)
+        {
+            ExtensionCommandChangeAllMsrBitmapWriteAllCores(Control->Index);
+        }
+        else if (Control->IsWrite)
+        {
+            ExtensionCommandUnsetMsrBitmapWriteAllCores(Control->Index);
+        }
+        else if (Control->Acquire)
+        {
+            ExtensionCommandChangeAllMsrBitmapReadAllCores(Control->Index);
+        }
+        else
+        {
+            ExtensionCommandUnsetMsrBitmapReadAllCores(Control->Index);
+        }
+    }
+    else
+    {
+        //
+        // Just one core
+        //
+        if (Control->IsWrite && Control->Acquire)
+        {
+            ConfigureChangeMsrBitmapWriteOnSingleCore(Control->CoreId, Control->Index);
+        }
+        else if (Control->IsWrite)
+        {
+            ConfigureUnsetMsrBitmapWriteOnSingleCore(Control->CoreId, Control->Index);
+        }
+        else if (Control->Acquire)
+        {
+            ConfigureChangeMsrBitmapReadOnSingleCore(Control->CoreId, Control->Index);
+        }
+        else
+        {
+            ConfigureUnsetMsrBitmapReadOnSingleCore(Control->CoreId, Control->Index);
+        }
+    }
+}
+
+/**
+ * @brief Reserve the slot of arming a disarmed event again
+ * @details the slots of the controls that are not applied by the slowest
+ * core are still in use, the control that is queued in vmx-root and the
+ * control of arming the event again need a slot
+ *
+ * @return BOOLEAN FALSE if there is no room for the controls of the event
+ */
+static BOOLEAN
+DebuggerReserveEventControlSlot()
+{
+    LONG  CountOfDisarmedEvents;
+    LONG  Backlog;
+    ULONG ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    do
+    {
+        CountOfDisarmedEvents = g_EventsPendingControls.CountOfDisarmedEvents;
+        Backlog               = 0;
+
+        for (UINT32 i = 0; i < ProcessorsCount; i++)
+        {
+            Backlog = max(Backlog, g_EventsPendingControls.Sequence - g_DbgState[i].EventsResources.AppliedControls);
+        }
+
+        if (Backlog + CountOfDisarmedEvents + 2 > DEBUGGER_EVENTS_PENDING_CONTROLS_COUNT)
+        {
+            return FALSE;
+        }
+
+    } while (InterlockedCompareExchange(&g_EventsPendingControls.CountOfDisarmedEvents,
+                                        CountOfDisarmedEvents + 1,
+                                        CountOfDisarmedEvents) != CountOfDisarmedEvents);
+
+    return TRUE;
+}
+
+/**
+ * @brief Release or add again the reference of an event to its control
+ * (MSR bitmap, I/O port or exception)
+ * @details in vmx-root, the control is queued and each core applies it
+ * on its next vm-exit, a slot is reserved for each disarmed event, so an
+ * event is only disarmed if there is room for arming it again
+ *
+ * @param Event The target event
+ * @param Acquire Whether to add or release the reference
+ *
+ * @return BOOLEAN FALSE if the reference is not changed
+ */
+static BOOLEAN
+DebuggerChangeEventControl(PDEBUGGER_EVENT Event, BOOLEAN Acquire)
+{
+    DEBUGGER_EVENT_PENDING_CONTROL Control;
+
+    if (!DebuggerGetEventControl(Event, Acquire, &Control))
+    {
+        return FALSE;
+    }
+
+    if (VmFuncVmxGetCurrentExecutionMode() == FALSE)
+    {
+        if (!Acquire && !DebuggerReserveEventControlSlot())
+        {
+            return FALSE;
+        }
+
+        if (Acquire)
+        {
+            InterlockedDecrement(&g_EventsPendingControls.CountOfDisarmedEvents);
+        }
+
+        DebuggerBroadcastEventControl(&Control);
+
+        return TRUE;
+    }
+
+    //
+    // The lock is only held in vmx-root (a vm-exit might happen while
+    // it's held in vmx non-root), so the controls are queued in order
+    //
+    SpinlockLock(&g_EventsPendingControls.Lock);
+
+    if (!Acquire && !DebuggerReserveEventControlSlot())
+    {
+        SpinlockUnlock(&g_EventsPendingControls.Lock);
+        return FALSE;
+    }
+
+    g_EventsPendingControls.Controls[(ULONG)g_EventsPendingControls.Sequence % DEBUGGER_EVENTS_PENDING_CONTROLS_COUNT] = Control;
+
+    InterlockedIncrement(&g_EventsPendingControls.Sequence);
+
+    SpinlockUnlock(&g_EventsPendingControls.Lock);
+
+    //
+    // The reserved slot is used by the control of arming the event
+    //
+    if (Acquire)
+    {
+        InterlockedDecrement(&g_EventsPendingControls.CountOfDisarmedEvents);
+    }
+
+    //
+    // The other cores apply the control on their next vm-exit and the
+    // current core applies it right now
+    //
+    VmcsPendingUpdatesRequestDebuggerTasks(DebuggerGetCoreMaskOfEvent(Event->CoreId));
+
+    DebuggerApplyEventsControlsOnCore(&g_DbgState[KeGetCurrentProcessorNumberEx(NULL)]);
+
+    return TRUE;
+}
+
+/**
+ * @brief Forget the controls of a disarmed event that is terminated
+ * @details the bitmaps and the EPT hooks of the event are already
+ * released once it's disarmed
+ *
+ * @param Event The target event
+ *
+ * @return BOOLEAN TRUE if the event was disarmed
+ */
+BOOLEAN
+DebuggerForgetDisarmedEvent(PDEBUGGER_EVENT Event)
+{
+    DEBUGGER_EVENT_PENDING_CONTROL Control;
+
+    if (!Event->IsControlsDisarmed)
+    {
+        return FALSE;
+    }
+
+    Event->IsControlsDisarmed = FALSE;
+
+    //
+    // The event is not armed again, so its reserved slot is not needed
+    //
+    if (DebuggerGetEventControl(Event, TRUE, &Control))
+    {
+        InterlockedDecrement(&g_EventsPendingControls.CountOfDisarmedEvents);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Apply the pending tasks of the debugger on the current core
+ * @details called by the hypervisor on the vm-exits that the cores are
+ * requested to apply the resources or the controls of the events
+ *
+ * @param CoreId The current core
+ *
+ * @return VOID
+ */
+VOID
+DebuggerApplyPendingEventsResources(UINT32 CoreId)
+{
+    DebuggerApplyEventsResourcesOnCore(&g_DbgState[CoreId]);
+}
+
+/**
+ * @brief Release the hardware controls of a disabled event
+ * @details the per-core resource (e.g., rdtsc exiting) is only cleared
+ * on the cores that no other event references it, the references to the
+ * MSR bitmaps, I/O ports and exceptions are released and the EPT hooks
+ * are removed (only in vmx non-root), so a disabled event doesn't cause
+ * any vm-exit
+ *
+ * @param Event The target event
+ *
+ * @return VOID
+ */
+VOID
+DebuggerDisarmEvent(PDEBUGGER_EVENT Event)
+{
+    DEBUGGER_EVENT_RESOURCE_TYPE Resource;
+    UINT64                       CoreMask;
+
+    if (!Event->IsControlsDisarmed)
+    {
+        Event->IsControlsDisarmed = DebuggerChangeEventControl(Event, FALSE) ||
+                                    DebuggerUnhookEptHooksOfEvent(Event);
+    }
+
+    CoreMask = DebuggerReleaseEventResource(Event, &Resource);
+
+    if (CoreMask == 0)
+    {
+        return;
+    }
+
+    if (VmFuncVmxGetCurrentExecutionMode() == FALSE)
+    {
+        TerminateClearResourceOnCores(Resource, CoreMask);
+        return;
+    }
+
+    //
+    // The other cores clear the resource on their next vm-exit
+    //
+    if (Resource == DEBUGGER_EVENT_RESOURCE_RDTSC_EXITING &&
+        !DebuggerIsEventResourceReferenced(DEBUGGER_EVENT_RESOURCE_RDTSC_EXITING))
+    {
+        VmFuncSetTriggerEventForTscs(FALSE);
+    }
+
+    DebuggerMarkEventResourcePending(Event, Resource);
+}
+
+/**
+ * @brief Set the hardware controls of a disarmed event again once it's
+ * enabled
+ * @details the EPT hooks of the event are only applied again in vmx
+ * non-root, so the event remains disarmed if it's enabled in vmx-root
+ *
+ * @param Event The target event
+ *
+ * @return BOOLEAN FALSE if the EPT hooks of the event are not applied
+ */
+BOOLEAN
+DebuggerArmEvent(PDEBUGGER_EVENT Event)
+{
+    DEBUGGER_EVENT_RESOURCE_TYPE Resource;
+    BOOLEAN                      IsAllCores = Event->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES;
+
+    if (Event->IsControlsDisarmed && !DebuggerChangeEventControl(Event, TRUE))
+    {
+        if (VmFuncVmxGetCurrentExecutionMode() == TRUE)
+        {
+            return FALSE;
+        }
+
+        if (!DebuggerHookEptHooksOfEvent(Event))
+        {
+            LogError("Err, unable to apply the EPT hooks of the event (tag: %llx) again", Event->Tag);
+            return FALSE;
+        }
+    }
+
+    Event->IsControlsDisarmed = FALSE;
+
+    if (Event->IsResourceReferenced || !DebuggerGetEventResource(Event, &Resource))
+    {
+        return TRUE;
+    }
+
+    DebuggerAcquireEventResource(Event);
+
+    if (Resource == DEBUGGER_EVENT_RESOURCE_RDTSC_EXITING)
+    {
+        VmFuncSetTriggerEventForTscs(TRUE);
+    }
+
+    if (VmFuncVmxGetCurrentExecutionMode() == TRUE)
+    {
+        //
+        // The other cores set the resource on their next vm-exit
+        //
+        DebuggerMarkEventResourcePending(Event, Resource);
+        return TRUE;
+    }
+
+    switch (Resource)
+    {
+    case DEBUGGER_EVENT_RESOURCE_EXTERNAL_INTERRUPT_EXITING:
+
+        if (IsAllCores)
+        {
+            ExtensionCommandSetExternalInterruptExitingAllCores();
+        }
+        else
+        {
+            ConfigureSetExternalInterruptExitingOnSingleCore(Event->CoreId);
+        }
+
         break;
-    case EXCEPTION_OCCURRED:
-        ResultList = &g_Events->ExceptionOccurredEventsHead;
+
+    case DEBUGGER_EVENT_RESOURCE_RDTSC_EXITING:
+
+        if (IsAllCores)
+        {
+            ExtensionCommandEnableRdtscExitingAllCores();
+        }
+        else
+        {
+            ConfigureEnableRdtscExitingOnSingleCore(Event->CoreId);
+        }
+
         break;
-    case TSC_INSTRUCTION_EXECUTION:
-        ResultList = &g_Events->TscInstructionExecutionEventsHead;
+
+    case DEBUGGER_EVENT_RESOURCE_RDPMC_EXITING:
+
+        if (IsAllCores)
+        {
+            ExtensionCommandEnableRdpmcExitingAllCores();
+        }
+        else
+        {
+            ConfigureEnableRdpmcExitingOnSingleCore(Event->CoreId);
+        }
+
         break;
-    case PMC_INSTRUCTION_EXECUTION:
-        ResultList = &g_Events->PmcInstructionExecutionEventsHead;
+
+    case DEBUGGER_EVENT_RESOURCE_EFER_SYSCALL_HOOK:
+
+        if (IsAllCores)
+        {
+            DebuggerEventEnableEferOnAllProcessors((DEBUGGER_EVENT_SYSCALL_SYSRET_TYPE)Event->OptionalParam2);
+        }
+        else
+        {
+            ConfigureEnableEferSyscallHookOnSingleCore(Event->CoreId, (DEBUGGER_EVENT_SYSCALL_SYSRET_TYPE)Event->OptionalParam2);
+        }
+
         break;
-    case IN_INSTRUCTION_EXECUTION:
-        ResultList = &g_Events->InInstructionExecutionEventsHead;
+
+    default:
         break;
-    case OUT_INSTRUCTION_EXECUTION:
-        ResultList = &g_Events->OutInstructionExecutionEventsHead;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Enable an event by tag
+ *
+ * @param Tag Tag of target event
+ * @return BOOLEAN TRUE if event enabled and FALSE if event not
+ * found or its EPT hooks can't be applied again
+ */
+BOOLEAN
+DebuggerEnableEvent(UINT64 Tag)
+{
+    PDEBUGGER_EVENT Event;
+    //
+    // Search all the cores for enable this event
+    //
+    Event = DebuggerGetEventByTag(Tag);
+
+    //
+    // Check if tag is valid or not
+    //
+    if (Event == NULL)
+    {
+        return FALSE;
+    }
+
+    //
+    // Set its hardware controls if it's disarmed
+    //
+    if (!DebuggerArmEvent(Event))
+    {
+        return FALSE;
+    }
+
+    //
+    // Enable the event
+    //
+    Event->Enabled = TRUE;
+
+    //
+    // Cores should re-snapshot their armed events
+    //
+    DebuggerArmedEventsInvalidate();
+
+    return TRUE;
+}
+
+/**
+ * @brief Set whether the messages of an event are generated
+ * @details the output sources of the event (in user-mode) disable the
+ * output once all the messages of the event are suppressed by them
+ *
+ * @param Tag Tag of target event
+ * @param IsOutputEnabled
+ * @return BOOLEAN TRUE if the output of the event is set and FALSE if
+ * event not found
+ */
+BOOLEAN
+DebuggerSetEventOutputState(UINT64 Tag, BOOLEAN IsOutputEnabled)
+{
+    PDEBUGGER_EVENT Event;
+
+    Event = DebuggerGetEventByTag(Tag);
+
+    if (Event == NULL)
+    {
+        return FALSE;
+    }
+
+    Event->IsOutputDisabled = !IsOutputEnabled;
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the types of the accesses that are monitored by a monitor event
+ * @details in all the cases we should set both read/write, even if it's only
+ * read we should set the write too! Also execute bit has the same conditions
+ * here, because if write is set read should be also set
+ *
+ * @param EventType Type of the event
+ * @param MonitorForRead
+ * @param MonitorForWrite
+ * @param MonitorForExecute
+ *
+ * @return BOOLEAN FALSE if the event is not a monitor event
+ */
+static BOOLEAN
+DebuggerGetMonitorAccessTypes(VMM_EVENT_TYPE_ENUM EventType,
+                              BOOLEAN *           MonitorForRead,
+                              BOOLEAN *           MonitorForWrite,
+                              BOOLEAN *           MonitorForExecute)
+{
+    switch (EventType)
+    {
+    case HIDDEN_HOOK_READ_AND_WRITE_AND_EXECUTE:
+    case HIDDEN_HOOK_READ_AND_EXECUTE:
+
+        *MonitorForRead    = TRUE;
+        *MonitorForWrite   = TRUE;
+        *MonitorForExecute = TRUE;
         break;
-    case DEBUG_REGISTERS_ACCESSED:
-        ResultList = &g_Events->DebugRegistersAccessedEventsHead;
+
+    case HIDDEN_HOOK_WRITE_AND_EXECUTE:
+
+        *MonitorForRead    = FALSE;
+        *MonitorForWrite   = TRUE;
+        *MonitorForExecute = FALSE;
         break;
-    case EXTERNAL_INTERRUPT_OCCURRED:
-        ResultList = &g_Events->ExternalInterruptOccurredEventsHead;
+
+    case HIDDEN_HOOK_READ_AND_WRITE:
+    case HIDDEN_HOOK_READ:
+
+        *MonitorForRead    = TRUE;
+        *MonitorForWrite   = TRUE;
+        *MonitorForExecute = FALSE;
         break;
-    case VMCALL_INSTRUCTION_EXECUTION:
-        ResultList = &g_Events->VmcallInstructionExecutionEventsHead;
+
+    case HIDDEN_HOOK_WRITE:
+
+        *MonitorForRead    = FALSE;
+        *MonitorForWrite   = TRUE;
+        *MonitorForExecute = FALSE;
         break;
-    case CONTROL_REGISTER_MODIFIED:
-        ResultList = &g_Events->ControlRegisterModifiedEventsHead;
+
+    case HIDDEN_HOOK_EXECUTE:
+
+        *MonitorForRead    = FALSE;
+        *MonitorForWrite   = FALSE;
+        *MonitorForExecute = TRUE;
         break;
+
     default:
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Count the ranges of a monitor event that start at or before
+ * an address
+ * @details binary search, can be called from vmx-root mode
+ *
+ * @param MonitorRanges The ranges of the event
+ * @param Address The target virtual address
+ *
+ * @return UINT32 The index of the first range that starts after the address
+ */
+static UINT32
+DebuggerMonitorRangesUpperBound(PDEBUGGER_EVENT_MONITOR_RANGES MonitorRanges, UINT64 Address)
+{
+    UINT32 Low  = 0;
+    UINT32 High = MonitorRanges->CountOfRanges;
+    UINT32 Middle;
+
+    while (Low < High)
+    {
+        Middle = Low + (High - Low) / 2;
+
+        if (MonitorRanges->Ranges[Middle].StartAddress <= Address)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    return Low;
+}
+
+/**
+ * @brief Check whether an address is in one of the ranges of a
+ * multi-range monitor event
+ * @details can be called from vmx-root mode
+ *
+ * @param MonitorRanges The ranges of the event
+ * @param Address The accessed virtual address
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+DebuggerIsAddressInMonitorRanges(PDEBUGGER_EVENT_MONITOR_RANGES MonitorRanges, UINT64 Address)
+{
+    UINT32 Index = DebuggerMonitorRangesUpperBound(MonitorRanges, Address);
+
+    //
+    // The ranges don't overlap, so only the last range that starts at or
+    // before the address might contain it
+    //
+    return Index != 0 && Address < MonitorRanges->Ranges[Index - 1].EndAddress;
+}
+
+/**
+ * @brief Check whether a page is hooked for one of the ranges of a
+ * monitor event
+ * @details the page of the end address of a range is also hooked (same
+ * as the pages of the single-range monitor events)
+ *
+ * @param MonitorRanges The ranges of the event
+ * @param PageAddress The page-aligned virtual address
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+DebuggerIsPageInMonitorRanges(PDEBUGGER_EVENT_MONITOR_RANGES MonitorRanges, UINT64 PageAddress)
+{
+    UINT32 Index = DebuggerMonitorRangesUpperBound(MonitorRanges, PageAddress + PAGE_SIZE - 1);
+
+    return Index != 0 && MonitorRanges->Ranges[Index - 1].EndAddress >= PageAddress;
+}
+
+/**
+ * @brief Get the ranges of a monitor event
+ * @details the single-range events don't have an array of ranges, so
+ * their range is filled in the caller's buffer
+ *
+ * @param Event The monitor event
+ * @param SingleRange The buffer for the range of single-range events
+ *
+ * @return PDEBUGGER_EVENT_MONITOR_RANGES
+ */
+static PDEBUGGER_EVENT_MONITOR_RANGES
+DebuggerGetMonitorRangesOfEvent(PDEBUGGER_EVENT Event, PDEBUGGER_EVENT_MONITOR_RANGES SingleRange)
+{
+    if (Event->MonitorRanges != NULL)
+    {
+        return Event->MonitorRanges;
+    }
+
+    //
+    // OptionalParam3 and OptionalParam4 are the virtual addresses of the range
+    //
+    SingleRange->CountOfRanges          = 1;
+    SingleRange->Ranges[0].StartAddress = Event->OptionalParam3;
+    SingleRange->Ranges[0].EndAddress   = Event->OptionalParam4;
+
+    return SingleRange;
+}
+
+/**
+ * @brief Find the slot of a monitor event that one of the pages of its
+ * range is the target page
+ * @details the slots are checked without a lock
+ *
+ * @param MonitorSlots The slots of the event
+ * @param PageAddress The page-aligned virtual address
+ *
+ * @return PDEBUGGER_EVENT_MONITOR_SLOT NULL if the page is not hooked for any slot
+ */
+static PDEBUGGER_EVENT_MONITOR_SLOT
+DebuggerGetMonitorSlotOfPage(PDEBUGGER_EVENT_MONITOR_SLOTS MonitorSlots, UINT64 PageAddress)
+{
+    LONG   CountOfUsedSlots = MonitorSlots->CountOfUsedSlots;
+    UINT64 EndAddress;
+
+    for (LONG i = 0; i < CountOfUsedSlots; i++)
+    {
+        EndAddress = MonitorSlots->Slots[i].EndAddress;
+
+        if (EndAddress != 0 &&
+            (UINT64)PAGE_ALIGN(MonitorSlots->Slots[i].StartAddress) <= PageAddress &&
+            (UINT64)PAGE_ALIGN(EndAddress - 1) >= PageAddress)
+        {
+            return &MonitorSlots->Slots[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Unhook the pages that are not hooked for any of the ranges of
+ * a monitor event
+ * @details should NOT be called in vmx-root
+ *
+ * @param Event The monitor event
+ * @param MonitorRanges The ranges whose pages should remain hooked
+ * @param FirstPage The first page to unhook
+ * @param EndPage The end of the pages to unhook (exclusive)
+ *
+ * @return VOID
+ */
+static VOID
+DebuggerUnhookMonitorRangePages(PDEBUGGER_EVENT                Event,
+                                PDEBUGGER_EVENT_MONITOR_RANGES MonitorRanges,
+                                UINT64                         FirstPage,
+                                UINT64                         EndPage)
+{
+    for (UINT64 PageAddress = FirstPage; PageAddress < EndPage; PageAddress += PAGE_SIZE)
+    {
+        if (!DebuggerIsPageInMonitorRanges(MonitorRanges, PageAddress) &&
+            (Event->MonitorSlots == NULL || DebuggerGetMonitorSlotOfPage(Event->MonitorSlots, PageAddress) == NULL))
+        {
+            ConfigureEptHookUnHookSingleAddress(PageAddress, NULL, Event->ProcessId);
+        }
+    }
+}
+
+/**
+ * @brief Replace the ranges of a monitor event
+ * @details the previous ranges are not used by any core once this
+ * function returns, should NOT be called in vmx-root
+ *
+ * @param Event The monitor event
+ * @param NewRanges The new ranges
+ *
+ * @return VOID
+ */
+static VOID
+DebuggerReplaceMonitorRangesOfEvent(PDEBUGGER_EVENT Event, PDEBUGGER_EVENT_MONITOR_RANGES NewRanges)
+{
+    PDEBUGGER_EVENT_MONITOR_RANGES PreviousRanges;
+
+    PreviousRanges = InterlockedExchangePointer((PVOID *)&Event->MonitorRanges, NewRanges);
+
+    if (PreviousRanges == NULL)
+    {
+        //
+        // The event was a single-range event, so it's no longer indexed
+        // by the physical page of its range
+        //
+        DebuggerEventsIndexUpdateEvent(Event);
+    }
+
+    //
+    // Wait until no core uses the previous ranges
+    //
+    DebuggerArmedEventsSynchronize();
+
+    if (PreviousRanges != NULL)
+    {
+        ExFreePoolWithTag(PreviousRanges, POOLTAG);
+    }
+}
+
+/**
+ * @brief Add a range to a monitor event
+ * @details the pages of the range that are not already monitored by
+ * the event are hooked, should NOT be called in vmx-root
+ *
+ * @param Tag Tag of the target event
+ * @param StartAddress Start of the range (virtual address)
+ * @param EndAddress End of the range (virtual address, exclusive)
+ *
+ * @return UINT32 DEBUGGER_OPERATION_WAS_SUCCESSFUL or the error
+ */
+UINT32
+DebuggerAddMonitorRangeToEvent(UINT64 Tag, UINT64 StartAddress, UINT64 EndAddress)
+{
+    PDEBUGGER_EVENT                Event;
+    PDEBUGGER_EVENT_MONITOR_RANGES CurrentRanges;
+    PDEBUGGER_EVENT_MONITOR_RANGES NewRanges;
+    DEBUGGER_EVENT_MONITOR_RANGES  SingleRange;
+    UINT64                         PageAddress;
+    UINT32                         ProcessId;
+    UINT32                         Index;
+    BOOLEAN                        MonitorForRead;
+    BOOLEAN                        MonitorForWrite;
+    BOOLEAN                        MonitorForExecute;
+
+    Event = DebuggerGetEventByTag(Tag);
+
+    if (Event == NULL)
+    {
+        return DEBUGGER_ERROR_TAG_NOT_EXISTS;
+    }
+
+    if (StartAddress >= EndAddress ||
+        !DebuggerGetMonitorAccessTypes(Event->EventType, &MonitorForRead, &MonitorForWrite, &MonitorForExecute))
+    {
+        return DEBUGGER_ERROR_MONITOR_RANGE_IS_INVALID;
+    }
+
+    CurrentRanges = DebuggerGetMonitorRangesOfEvent(Event, &SingleRange);
+
+    if (CurrentRanges->CountOfRanges >= DEBUGGER_EVENT_MONITOR_MAXIMUM_RANGES)
+    {
+        return DEBUGGER_ERROR_MONITOR_RANGE_IS_INVALID;
+    }
+
+    //
+    // The range should not overlap with the other ranges of the event
+    //
+    Index = DebuggerMonitorRangesUpperBound(CurrentRanges, EndAddress - 1);
+
+    if (Index != 0 && CurrentRanges->Ranges[Index - 1].EndAddress > StartAddress)
+    {
+        return DEBUGGER_ERROR_MONITOR_RANGE_IS_INVALID;
+    }
+
+    NewRanges = ExAllocatePoolWithTag(NonPagedPool,
+                                      sizeof(DEBUGGER_EVENT_MONITOR_RANGES) + CurrentRanges->CountOfRanges * sizeof(DEBUGGER_EVENT_MONITOR_RANGE),
+                                      POOLTAG);
+
+    if (NewRanges == NULL)
+    {
+        return DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_MONITOR_RANGES;
+    }
+
+    //
+    // The pages are hooked for the same process as the first range
+    //
+    ProcessId = Event->ProcessId;
+
+    if (ProcessId == DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES || ProcessId == 0)
+    {
+        ProcessId = PsGetCurrentProcessId();
+    }
+
+    //
+    // The pages of a disarmed event are hooked once it's armed again
+    //
+    for (PageAddress = (UINT64)PAGE_ALIGN(StartAddress);
+         !Event->IsControlsDisarmed && PageAddress <= (UINT64)PAGE_ALIGN(EndAddress);
+         PageAddress += PAGE_SIZE)
+    {
+        if (DebuggerIsPageInMonitorRanges(CurrentRanges, PageAddress) ||
+            (Event->MonitorSlots != NULL && DebuggerGetMonitorSlotOfPage(Event->MonitorSlots, PageAddress) != NULL))
+        {
+            //
+            // The page is already hooked for another range of the event
+            //
+            continue;
+        }
+
+        if (!DebuggerEventEnableMonitorReadWriteExec(PageAddress,
+                                                     ProcessId,
+                                                     MonitorForRead,
+                                                     MonitorForWrite,
+                                                     MonitorForExecute,
+                                                     FALSE))
+        {
+            //
+            // Restore the pages that are hooked for this range
+            //
+            DebuggerUnhookMonitorRangePages(Event, CurrentRanges, (UINT64)PAGE_ALIGN(StartAddress), PageAddress);
+
+            ExFreePoolWithTag(NewRanges, POOLTAG);
+
+            return DebuggerGetLastError();
+        }
 
         //
-        // Wrong event type
+        // Here is a safe PASSIVE_LEVEL, so the used pre-allocated buffers
+        // are reallocated for the next pages
         //
-        LogError("Err, wrong event type is specified");
-        ResultList = NULL;
-        break;
+        PoolManagerCheckAndPerformAllocationAndDeallocation();
+    }
+
+    //
+    // Insert the range after the ranges that start before it
+    //
+    Index = DebuggerMonitorRangesUpperBound(CurrentRanges, StartAddress);
+
+    NewRanges->CountOfRanges = CurrentRanges->CountOfRanges + 1;
+
+    RtlCopyMemory(&NewRanges->Ranges[0], &CurrentRanges->Ranges[0], Index * sizeof(DEBUGGER_EVENT_MONITOR_RANGE));
+    RtlCopyMemory(&NewRanges->Ranges[Index + 1],
+                  &CurrentRanges->Ranges[Index],
+                  (CurrentRanges->CountOfRanges - Index) * sizeof(DEBUGGER_EVENT_MONITOR_RANGE));
+
+    NewRanges->Ranges[Index].StartAddress = StartAddress;
+    NewRanges->Ranges[Index].EndAddress   = EndAddress;
+
+    DebuggerReplaceMonitorRangesOfEvent(Event, NewRanges);
+
+    return DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+}
+
+/**
+ * @brief Remove a range from a monitor event
+ * @details the pages of the range that are not monitored by the other
+ * ranges of the event are unhooked, should NOT be called in vmx-root
+ *
+ * @param Tag Tag of the target event
+ * @param StartAddress Start of the range (virtual address)
+ * @param EndAddress End of the range (virtual address, exclusive)
+ *
+ * @return UINT32 DEBUGGER_OPERATION_WAS_SUCCESSFUL or the error
+ */
+UINT32
+DebuggerRemoveMonitorRangeFromEvent(UINT64 Tag, UINT64 StartAddress, UINT64 EndAddress)
+{
+    PDEBUGGER_EVENT                Event;
+    PDEBUGGER_EVENT_MONITOR_RANGES CurrentRanges;
+    PDEBUGGER_EVENT_MONITOR_RANGES NewRanges;
+    DEBUGGER_EVENT_MONITOR_RANGES  SingleRange;
+    UINT32                         Index;
+    BOOLEAN                        MonitorForRead;
+    BOOLEAN                        MonitorForWrite;
+    BOOLEAN                        MonitorForExecute;
+
+    Event = DebuggerGetEventByTag(Tag);
+
+    if (Event == NULL)
+    {
+        return DEBUGGER_ERROR_TAG_NOT_EXISTS;
+    }
+
+    if (!DebuggerGetMonitorAccessTypes(Event->EventType, &MonitorForRead, &MonitorForWrite, &MonitorForExecute))
+    {
+        return DEBUGGER_ERROR_MONITOR_RANGE_IS_INVALID;
+    }
+
+    CurrentRanges = DebuggerGetMonitorRangesOfEvent(Event, &SingleRange);
+
+    //
+    // Only the exact ranges of the event are removed
+    //
+    Index = DebuggerMonitorRangesUpperBound(CurrentRanges, StartAddress);
+
+    if (Index == 0 ||
+        CurrentRanges->Ranges[Index - 1].StartAddress != StartAddress ||
+        CurrentRanges->Ranges[Index - 1].EndAddress != EndAddress)
+    {
+        return DEBUGGER_ERROR_MONITOR_RANGE_NOT_FOUND;
+    }
+
+    Index--;
+
+    NewRanges = ExAllocatePoolWithTag(NonPagedPool,
+                                      sizeof(DEBUGGER_EVENT_MONITOR_RANGES) + CurrentRanges->CountOfRanges * sizeof(DEBUGGER_EVENT_MONITOR_RANGE),
+                                      POOLTAG);
+
+    if (NewRanges == NULL)
+    {
+        return DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_MONITOR_RANGES;
+    }
+
+    NewRanges->CountOfRanges = CurrentRanges->CountOfRanges - 1;
+
+    RtlCopyMemory(&NewRanges->Ranges[0], &CurrentRanges->Ranges[0], Index * sizeof(DEBUGGER_EVENT_MONITOR_RANGE));
+    RtlCopyMemory(&NewRanges->Ranges[Index],
+                  &CurrentRanges->Ranges[Index + 1],
+                  (NewRanges->CountOfRanges - Index) * sizeof(DEBUGGER_EVENT_MONITOR_RANGE));
+
+    //
+    // The range is no longer matched once the ranges are replaced, so its
+    // pages can be unhooked
+    //
+    DebuggerReplaceMonitorRangesOfEvent(Event, NewRanges);
+
+    //
+    // The pages of a disarmed event are already unhooked
+    //
+    if (!Event->IsControlsDisarmed)
+    {
+        DebuggerUnhookMonitorRangePages(Event,
+                                        NewRanges,
+                                        (UINT64)PAGE_ALIGN(StartAddress),
+                                        (UINT64)PAGE_ALIGN(EndAddress) + PAGE_SIZE);
+    }
+
+    return DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+}
+
+/**
+ * @brief Check whether an address is in one of the ranges of the slots
+ * of a monitor event
+ * @details the slots are checked without a lock, the end address is read
+ * first as it's written after the start address
+ *
+ * @param MonitorSlots The slots of the event
+ * @param Address The virtual address
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+DebuggerIsAddressInMonitorSlots(PDEBUGGER_EVENT_MONITOR_SLOTS MonitorSlots, UINT64 Address)
+{
+    LONG   CountOfUsedSlots = MonitorSlots->CountOfUsedSlots;
+    UINT64 EndAddress;
+
+    for (LONG i = 0; i < CountOfUsedSlots; i++)
+    {
+        EndAddress = MonitorSlots->Slots[i].EndAddress;
+
+        if (Address < EndAddress && Address >= MonitorSlots->Slots[i].StartAddress)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Unhook the pages that are hooked by a slot of a monitor event
+ * @details should be called in vmx-root while holding the lock of the slots
+ *
+ * @param Slot The slot
+ *
+ * @return VOID
+ */
+static VOID
+DebuggerUnhookMonitorSlotPages(PDEBUGGER_EVENT_MONITOR_SLOT Slot)
+{
+    for (UINT32 i = 0; i < Slot->CountOfPages; i++)
+    {
+        if (Slot->HookedPagesMask & (1 << i))
+        {
+            ConfigureEptHookUnHookSinglePageFromVmxRoot(Slot->PhysicalPages[i]);
+        }
+    }
+
+    Slot->HookedPagesMask = 0;
+}
+
+/**
+ * @brief Add a range to one of the preallocated slots of a monitor event
+ * @details should be called in vmx-root (used by the scripts), the pages
+ * are hooked by the pre-allocated buffers of the pool manager, the range
+ * is translated by the address space of the current process
+ *
+ * @param Tag Tag of the target event
+ * @param StartAddress Start of the range (virtual address)
+ * @param EndAddress End of the range (virtual address, exclusive)
+ *
+ * @return BOOLEAN TRUE if the range is added
+ */
+BOOLEAN
+DebuggerAddMonitorSlotRange(UINT64 Tag, UINT64 StartAddress, UINT64 EndAddress)
+{
+    PDEBUGGER_EVENT                Event;
+    PDEBUGGER_EVENT_MONITOR_SLOTS  MonitorSlots;
+    PDEBUGGER_EVENT_MONITOR_SLOT   Slot = NULL;
+    PDEBUGGER_EVENT_MONITOR_RANGES MonitorRanges;
+    DEBUGGER_EVENT_MONITOR_RANGES  SingleRange;
+    CR3_TYPE                       ProcessCr3;
+    UINT64                         PageAddress;
+    UINT32                         CountOfPages;
+    BOOLEAN                        IsNewSlot = FALSE;
+    BOOLEAN                        MonitorForRead;
+    BOOLEAN                        MonitorForWrite;
+    BOOLEAN                        MonitorForExecute;
+
+    Event = DebuggerGetEventByTag(Tag);
+
+    if (Event == NULL || Event->MonitorSlots == NULL || StartAddress >= EndAddress ||
+        !DebuggerGetMonitorAccessTypes(Event->EventType, &MonitorForRead, &MonitorForWrite, &MonitorForExecute))
+    {
+        return FALSE;
+    }
+
+    CountOfPages = (UINT32)((((UINT64)PAGE_ALIGN(EndAddress - 1) - (UINT64)PAGE_ALIGN(StartAddress)) / PAGE_SIZE) + 1);
+
+    if (CountOfPages > DEBUGGER_EVENT_MONITOR_SLOT_MAXIMUM_PAGES)
+    {
+        return FALSE;
+    }
+
+    MonitorSlots = Event->MonitorSlots;
+    ProcessCr3   = LayoutGetCurrentProcessCr3();
+
+    SpinlockLock(&MonitorSlots->Lock);
+
+    if (MonitorSlots->IsClosed)
+    {
+        SpinlockUnlock(&MonitorSlots->Lock);
+        return FALSE;
+    }
+
+    //
+    // Find a free slot, the range should not overlap with the other slots
+    //
+    for (LONG i = 0; i < MonitorSlots->CountOfUsedSlots; i++)
+    {
+        if (MonitorSlots->Slots[i].EndAddress == 0)
+        {
+            if (Slot == NULL)
+            {
+                Slot = &MonitorSlots->Slots[i];
+            }
+        }
+        else if (MonitorSlots->Slots[i].StartAddress < EndAddress && StartAddress < MonitorSlots->Slots[i].EndAddress)
+        {
+            SpinlockUnlock(&MonitorSlots->Lock);
+            return FALSE;
+        }
+    }
+
+    if (Slot == NULL)
+    {
+        if ((UINT32)MonitorSlots->CountOfUsedSlots >= MonitorSlots->CountOfSlots)
+        {
+            SpinlockUnlock(&MonitorSlots->Lock);
+            return FALSE;
+        }
+
+        Slot      = &MonitorSlots->Slots[MonitorSlots->CountOfUsedSlots];
+        IsNewSlot = TRUE;
+    }
+
+    Slot->CountOfPages    = CountOfPages;
+    Slot->HookedPagesMask = 0;
+
+    MonitorRanges = DebuggerGetMonitorRangesOfEvent(Event, &SingleRange);
+
+    for (UINT32 i = 0; i < CountOfPages; i++)
+    {
+        PageAddress = (UINT64)PAGE_ALIGN(StartAddress) + i * PAGE_SIZE;
+
+        if (DebuggerIsPageInMonitorRanges(MonitorRanges, PageAddress) ||
+            DebuggerGetMonitorSlotOfPage(MonitorSlots, PageAddress) != NULL)
+        {
+            //
+            // The page is already hooked for another range of the event
+            //
+            continue;
+        }
+
+        if (!ConfigureEptHookMonitorFromVmxRoot((PVOID)PageAddress,
+                                                ProcessCr3,
+                                                MonitorForRead,
+                                                MonitorForWrite,
+                                                MonitorForExecute,
+                                                &Slot->PhysicalPages[i]))
+        {
+            //
+            // Restore the pages that are hooked for this range
+            //
+            DebuggerUnhookMonitorSlotPages(Slot);
+
+            SpinlockUnlock(&MonitorSlots->Lock);
+            return FALSE;
+        }
+
+        Slot->HookedPagesMask |= 1 << i;
+    }
+
+    //
+    // Publish the range, the end address is written at last
+    //
+    Slot->StartAddress = StartAddress;
+    Slot->EndAddress   = EndAddress;
+
+    if (IsNewSlot)
+    {
+        InterlockedIncrement(&MonitorSlots->CountOfUsedSlots);
+    }
+
+    SpinlockUnlock(&MonitorSlots->Lock);
+
+    return TRUE;
+}
+
+/**
+ * @brief Remove a range from the slots of a monitor event
+ * @details should be called in vmx-root (used by the scripts), the pages
+ * that are shared with the other ranges of the event remain hooked
+ *
+ * @param Tag Tag of the target event
+ * @param StartAddress Start of the range (virtual address)
+ * @param EndAddress End of the range (virtual address, exclusive)
+ *
+ * @return BOOLEAN TRUE if the range is removed
+ */
+BOOLEAN
+DebuggerRemoveMonitorSlotRange(UINT64 Tag, UINT64 StartAddress, UINT64 EndAddress)
+{
+    PDEBUGGER_EVENT                Event;
+    PDEBUGGER_EVENT_MONITOR_SLOTS  MonitorSlots;
+    PDEBUGGER_EVENT_MONITOR_SLOT   Slot = NULL;
+    PDEBUGGER_EVENT_MONITOR_SLOT   OtherSlot;
+    PDEBUGGER_EVENT_MONITOR_RANGES MonitorRanges;
+    DEBUGGER_EVENT_MONITOR_RANGES  SingleRange;
+    UINT64                         PageAddress;
+    UINT32                         OtherIndex;
+
+    Event = DebuggerGetEventByTag(Tag);
+
+    if (Event == NULL || Event->MonitorSlots == NULL || EndAddress == 0)
+    {
+        return FALSE;
+    }
+
+    MonitorSlots = Event->MonitorSlots;
+
+    SpinlockLock(&MonitorSlots->Lock);
+
+    //
+    // Only the exact ranges of the slots are removed
+    //
+    for (LONG i = 0; i < MonitorSlots->CountOfUsedSlots; i++)
+    {
+        if (MonitorSlots->Slots[i].StartAddress == StartAddress && MonitorSlots->Slots[i].EndAddress == EndAddress)
+        {
+            Slot = &MonitorSlots->Slots[i];
+            break;
+        }
+    }
+
+    if (Slot == NULL || MonitorSlots->IsClosed)
+    {
+        SpinlockUnlock(&MonitorSlots->Lock);
+        return FALSE;
+    }
+
+    //
+    // Unpublish the range before unhooking its pages
+    //
+    Slot->EndAddress = 0;
+
+    MonitorRanges = DebuggerGetMonitorRangesOfEvent(Event, &SingleRange);
+
+    for (UINT32 i = 0; i < Slot->CountOfPages; i++)
+    {
+        if (!(Slot->HookedPagesMask & (1 << i)))
+        {
+            continue;
+        }
+
+        PageAddress = (UINT64)PAGE_ALIGN(StartAddress) + i * PAGE_SIZE;
+        OtherSlot   = DebuggerGetMonitorSlotOfPage(MonitorSlots, PageAddress);
+
+        if (OtherSlot != NULL)
+        {
+            //
+            // The page remains hooked for the other slot
+            //
+            OtherIndex = (UINT32)((PageAddress - (UINT64)PAGE_ALIGN(OtherSlot->StartAddress)) / PAGE_SIZE);
+
+            OtherSlot->PhysicalPages[OtherIndex] = Slot->PhysicalPages[i];
+            OtherSlot->HookedPagesMask |= 1 << OtherIndex;
+        }
+        else if (!DebuggerIsPageInMonitorRanges(MonitorRanges, PageAddress))
+        {
+            ConfigureEptHookUnHookSinglePageFromVmxRoot(Slot->PhysicalPages[i]);
+        }
     }
 
-    return ResultList;
+    Slot->HookedPagesMask = 0;
+
+    SpinlockUnlock(&MonitorSlots->Lock);
+
+    return TRUE;
 }
 
 /**
- * @brief Count the list of events in a special list that
- * are activate on a target core
+ * @brief Close the slots of a monitor event and unhook their pages
+ * @details no range is added to the slots after this function, should
+ * NOT be called in vmx-root
  *
- * @param TargetEventList target event list
- * @param TargetCore target core
- * @return UINT32 count of events on the list which is activated
- * on the target core
+ * @param Event The monitor event
+ *
+ * @return VOID
  */
-UINT32
-DebuggerEventListCountByCore(PLIST_ENTRY TargetEventList, UINT32 TargetCore)
+VOID
+DebuggerCloseMonitorSlotsOfEvent(PDEBUGGER_EVENT Event)
 {
-    PLIST_ENTRY TempList = 0;
-    UINT32      Counter  = 0;
+    PDEBUGGER_EVENT_MONITOR_SLOTS MonitorSlots = Event->MonitorSlots;
+    PDEBUGGER_EVENT_MONITOR_SLOT  Slot;
+
+    if (MonitorSlots == NULL)
+    {
+        return;
+    }
+
+    InterlockedExchange(&MonitorSlots->IsClosed, TRUE);
 
     //
-    // We have to iterate through all events of this list
+    // The lock is only held in vmx-root, so here it's not acquired (the
+    // current core might be interrupted by a vm-exit that takes it), but
+    // the ranges that are being added by the other cores are waited for
     //
-    TempList = TargetEventList;
+    while (MonitorSlots->Lock != 0)
+    {
+        YieldProcessor();
+    }
 
-    while (TargetEventList != TempList->Flink)
+    for (LONG i = 0; i < MonitorSlots->CountOfUsedSlots; i++)
     {
-        TempList                     = TempList->Flink;
-        PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+        Slot = &MonitorSlots->Slots[i];
 
-        if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES || CurrentEvent->CoreId == TargetCore)
+        Slot->EndAddress = 0;
+
+        for (UINT32 j = 0; j < Slot->CountOfPages; j++)
         {
-            //
-            // Increase the counter
-            //
-            Counter++;
+            if (Slot->HookedPagesMask & (1 << j))
+            {
+                ConfigureEptHookUnHookSingleAddress((UINT64)PAGE_ALIGN(Slot->StartAddress) + j * PAGE_SIZE,
+                                                    Slot->PhysicalPages[j],
+                                                    Event->ProcessId);
+            }
         }
-    }
 
-    return Counter;
+        Slot->HookedPagesMask = 0;
+    }
 }
 
 /**
- * @brief Count the list of events by a special event type that
- * are activate on a target core
+ * @brief Unhook the pages of the ranges of a monitor event
+ * @details the ranges are sorted, so the pages that are shared between
+ * the ranges are unhooked once, should NOT be called in vmx-root
  *
- * @param EventType target event type
- * @param TargetCore target core
+ * @param Event The monitor event
+ * @param MonitorRanges The ranges of the event
+ * @param EndPage The end of the pages to unhook (exclusive)
  *
- * @return UINT32 count of events on the list which is activated
- * on the target core
+ * @return VOID
  */
-UINT32
-DebuggerEventListCountByEventType(VMM_EVENT_TYPE_ENUM EventType, UINT32 TargetCore)
+static VOID
+DebuggerUnhookMonitorPagesOfEvent(PDEBUGGER_EVENT Event, PDEBUGGER_EVENT_MONITOR_RANGES MonitorRanges, UINT64 EndPage)
 {
-    PLIST_ENTRY TempList = 0;
-    UINT32      Counter  = 0;
-
-    PLIST_ENTRY TargetEventList = DebuggerGetEventListByEventType(EventType);
-
-    //
-    // We have to iterate through all events of this list
-    //
-    TempList = TargetEventList;
+    UINT64 PageAddress;
+    UINT64 NextPage = 0;
 
-    while (TargetEventList != TempList->Flink)
+    for (UINT32 i = 0; i < MonitorRanges->CountOfRanges; i++)
     {
-        TempList                     = TempList->Flink;
-        PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+        PageAddress = max((UINT64)PAGE_ALIGN(MonitorRanges->Ranges[i].StartAddress), NextPage);
 
-        if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES || CurrentEvent->CoreId == TargetCore)
+        for (; PageAddress <= (UINT64)PAGE_ALIGN(MonitorRanges->Ranges[i].EndAddress); PageAddress += PAGE_SIZE)
         {
-            //
-            // Increase the counter
-            //
-            Counter++;
+            if (PageAddress >= EndPage)
+            {
+                return;
+            }
+
+            ConfigureEptHookUnHookSingleAddress(PageAddress, NULL, Event->ProcessId);
         }
+
+        NextPage = PageAddress;
     }
+}
 
-    return Counter;
+/**
+ * @brief Remove the EPT hooks of a disabled event
+ * @details the EPT hooks are only removed in vmx non-root, the monitor
+ * events with the slots of the scripts are not unhooked as the scripts
+ * hook their pages in vmx-root
+ *
+ * @param Event The target event
+ *
+ * @return BOOLEAN TRUE if the hooks of the event are removed
+ */
+BOOLEAN
+DebuggerUnhookEptHooksOfEvent(PDEBUGGER_EVENT Event)
+{
+    DEBUGGER_EVENT_MONITOR_RANGES SingleRange;
+    BOOLEAN                       MonitorForRead;
+    BOOLEAN                       MonitorForWrite;
+    BOOLEAN                       MonitorForExecute;
+
+    if (VmFuncVmxGetCurrentExecutionMode() == TRUE)
+    {
+        return FALSE;
+    }
+
+    switch (Event->EventType)
+    {
+    case HIDDEN_HOOK_EXEC_CC:
+
+        TerminateHiddenHookExecCcEvent(Event);
+        return TRUE;
+
+    case HIDDEN_HOOK_EXEC_DETOURS:
+
+        TerminateHiddenHookExecDetoursEvent(Event);
+        return TRUE;
+
+    default:
+        break;
+    }
+
+    if (Event->MonitorSlots != NULL ||
+        !DebuggerGetMonitorAccessTypes(Event->EventType, &MonitorForRead, &MonitorForWrite, &MonitorForExecute))
+    {
+        return FALSE;
+    }
+
+    DebuggerUnhookMonitorPagesOfEvent(Event, DebuggerGetMonitorRangesOfEvent(Event, &SingleRange), MAXULONG64);
+
+    return TRUE;
 }
 
 /**
- * @brief Get the mask related to the !exception command for the
- * target core
+ * @brief Apply the EPT hooks of a disarmed event again
+ * @details should NOT be called in vmx-root, the pages that are hooked
+ * are restored if one of the pages can't be hooked
  *
- * @param CoreIndex The index of core
+ * @param Event The target event
  *
- * @return UINT32 Returns the current mask for the core
+ * @return BOOLEAN TRUE if the hooks of the event are applied
  */
-UINT32
-DebuggerExceptionEventBitmapMask(UINT32 CoreIndex)
+BOOLEAN
+DebuggerHookEptHooksOfEvent(PDEBUGGER_EVENT Event)
 {
-    PLIST_ENTRY TempList      = 0;
-    UINT32      ExceptionMask = 0;
+    PDEBUGGER_EVENT_MONITOR_RANGES MonitorRanges;
+    DEBUGGER_EVENT_MONITOR_RANGES  SingleRange;
+    UINT64                         PageAddress;
+    UINT64                         NextPage  = 0;
+    UINT32                         ProcessId = Event->ProcessId;
+    BOOLEAN                        MonitorForRead;
+    BOOLEAN                        MonitorForWrite;
+    BOOLEAN                        MonitorForExecute;
 
     //
-    // We have to iterate through all events of this list
+    // The pages are hooked for the same process as they're applied
     //
-    TempList = &g_Events->ExceptionOccurredEventsHead;
+    if (ProcessId == DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES || ProcessId == 0)
+    {
+        ProcessId = PsGetCurrentProcessId();
+    }
 
-    while (&g_Events->ExceptionOccurredEventsHead != TempList->Flink)
+    switch (Event->EventType)
     {
-        TempList                     = TempList->Flink;
-        PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+    case HIDDEN_HOOK_EXEC_CC:
+
+        return ConfigureEptHook((PVOID)Event->OptionalParam1, ProcessId);
+
+    case HIDDEN_HOOK_EXEC_DETOURS:
+
+        //
+        // OptionalParam3 is the virtual address of the hook
+        //
+        return ConfigureEptHook2((PVOID)Event->OptionalParam3, NULL, ProcessId, FALSE, FALSE, FALSE, TRUE);
+
+    default:
+        break;
+    }
+
+    if (!DebuggerGetMonitorAccessTypes(Event->EventType, &MonitorForRead, &MonitorForWrite, &MonitorForExecute))
+    {
+        return FALSE;
+    }
 
-        if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES || CurrentEvent->CoreId == CoreIndex)
+    MonitorRanges = DebuggerGetMonitorRangesOfEvent(Event, &SingleRange);
+
+    for (UINT32 i = 0; i < MonitorRanges->CountOfRanges; i++)
+    {
+        PageAddress = max((UINT64)PAGE_ALIGN(MonitorRanges->Ranges[i].StartAddress), NextPage);
+
+        for (; PageAddress <= (UINT64)PAGE_ALIGN(MonitorRanges->Ranges[i].EndAddress); PageAddress += PAGE_SIZE)
         {
-            ExceptionMask |= CurrentEvent->OptionalParam1;
+            if (!DebuggerEventEnableMonitorReadWriteExec(PageAddress,
+                                                         ProcessId,
+                                                         MonitorForRead,
+                                                         MonitorForWrite,
+                                                         MonitorForExecute,
+                                                         FALSE))
+            {
+                //
+                // Restore the pages that are hooked before this page
+                //
+                DebuggerUnhookMonitorPagesOfEvent(Event, MonitorRanges, PageAddress);
+
+                return FALSE;
+            }
+
+            //
+            // Here is a safe PASSIVE_LEVEL, so the used pre-allocated buffers
+            // are reallocated for the next pages
+            //
+            PoolManagerCheckAndPerformAllocationAndDeallocation();
         }
+
+        NextPage = PageAddress;
     }
 
-    return ExceptionMask;
+    return TRUE;
 }
 
 /**
- * @brief Enable an event by tag
+ * @brief returns whether an event is enabled/disabled by tag
+ * @details this function won't check for Tag validity and if
+ * not found then returns false
  *
  * @param Tag Tag of target event
  * @return BOOLEAN TRUE if event enabled and FALSE if event not
  * found
  */
 BOOLEAN
-DebuggerEnableEvent(UINT64 Tag)
+DebuggerQueryStateEvent(UINT64 Tag)
 {
     PDEBUGGER_EVENT Event;
     //
@@ -1735,30 +4371,27 @@ DebuggerEnableEvent(UINT64 Tag)
         return FALSE;
     }
 
-    //
-    // Enable the event
-    //
-    Event->Enabled = TRUE;
-
-    return TRUE;
+    return Event->Enabled;
 }
 
 /**
- * @brief returns whether an event is enabled/disabled by tag
- * @details this function won't check for Tag validity and if
- * not found then returns false
+ * @brief Query the cost of the scripts of an event by tag
+ * @details the statistics of all the script actions of the event
+ * are summed up
  *
  * @param Tag Tag of target event
- * @return BOOLEAN TRUE if event enabled and FALSE if event not
+ * @param Statistics The statistics of the scripts
+ * @return BOOLEAN TRUE if event is found and FALSE if event not
  * found
  */
 BOOLEAN
-DebuggerQueryStateEvent(UINT64 Tag)
+DebuggerQueryScriptStatisticsOfEvent(UINT64 Tag, PDEBUGGER_EVENT_SCRIPT_STATISTICS Statistics)
 {
     PDEBUGGER_EVENT Event;
-    //
-    // Search all the cores for enable this event
-    //
+    PLIST_ENTRY     TempList = 0;
+
+    RtlZeroMemory(Statistics, sizeof(DEBUGGER_EVENT_SCRIPT_STATISTICS));
+
     Event = DebuggerGetEventByTag(Tag);
 
     //
@@ -1769,7 +4402,111 @@ DebuggerQueryStateEvent(UINT64 Tag)
         return FALSE;
     }
 
-    return Event->Enabled;
+    TempList = &Event->ActionsListHead;
+    while (&Event->ActionsListHead != TempList->Flink)
+    {
+        TempList                             = TempList->Flink;
+        PDEBUGGER_EVENT_ACTION CurrentAction = CONTAINING_RECORD(TempList, DEBUGGER_EVENT_ACTION, ActionsList);
+
+        if (CurrentAction->ActionType != RUN_SCRIPT)
+        {
+            continue;
+        }
+
+        Statistics->Invocations += CurrentAction->ScriptStatistics.Invocations;
+        Statistics->TotalTsc += CurrentAction->ScriptStatistics.TotalTsc;
+        Statistics->Instructions += CurrentAction->ScriptStatistics.Instructions;
+        Statistics->AbortedRuns += CurrentAction->ScriptStatistics.AbortedRuns;
+
+        if (CurrentAction->ScriptStatistics.MaximumTsc > Statistics->MaximumTsc)
+        {
+            Statistics->MaximumTsc = CurrentAction->ScriptStatistics.MaximumTsc;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Query the hit statistics of all of the events
+ * @details the per-core counters are summed up, the counters of the
+ * cores might be updated while they're read, so the results are not
+ * an atomic snapshot
+ *
+ * @param StatisticsRequest The request that is filled with the statistics
+ * @return VOID
+ */
+VOID
+DebuggerQueryEventsStatistics(PDEBUGGER_QUERY_EVENTS_STATISTICS StatisticsRequest)
+{
+    PLIST_ENTRY                      TempList  = 0;
+    PLIST_ENTRY                      TempList2 = 0;
+    PDEBUGGER_EVENT_STATISTICS       Entry;
+    DEBUGGER_EVENT_SCRIPT_STATISTICS ScriptStatistics;
+    UINT32                           ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    StatisticsRequest->CountOfEvents      = 0;
+    StatisticsRequest->TotalCountOfEvents = 0;
+
+    for (size_t i = 0; i < sizeof(DEBUGGER_CORE_EVENTS) / sizeof(LIST_ENTRY); i++)
+    {
+        TempList  = (PLIST_ENTRY)((UINT64)(g_Events) + (i * sizeof(LIST_ENTRY)));
+        TempList2 = TempList;
+
+        while (TempList2 != TempList->Flink)
+        {
+            TempList                     = TempList->Flink;
+            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+
+            if (CurrentEvent->HitStatistics == NULL)
+            {
+                //
+                // The event is not completely registered yet
+                //
+                continue;
+            }
+
+            StatisticsRequest->TotalCountOfEvents++;
+
+            if (StatisticsRequest->CountOfEvents < MaximumEventsStatisticsToQuery)
+            {
+                Entry = &StatisticsRequest->Events[StatisticsRequest->CountOfEvents];
+
+                RtlZeroMemory(Entry, sizeof(DEBUGGER_EVENT_STATISTICS));
+
+                Entry->Tag       = CurrentEvent->Tag;
+                Entry->IsEnabled = CurrentEvent->Enabled;
+
+                for (UINT32 j = 0; j < ProcessorsCount; j++)
+                {
+                    Entry->Hits += CurrentEvent->HitStatistics[j].Hits;
+                    Entry->ConditionPasses += CurrentEvent->HitStatistics[j].ConditionPasses;
+
+                    if (CurrentEvent->HitStatistics[j].LastHitTsc > Entry->LastHitTsc)
+                    {
+                        Entry->LastHitTsc = CurrentEvent->HitStatistics[j].LastHitTsc;
+                    }
+                }
+
+                DebuggerQueryScriptStatisticsOfEvent(CurrentEvent->Tag, &ScriptStatistics);
+
+                Entry->ScriptTsc = ScriptStatistics.TotalTsc;
+
+                StatisticsRequest->CountOfEvents++;
+            }
+
+            //
+            // The reset is not exact either, the hits of the other cores
+            // might happen while the counters are cleared
+            //
+            if (StatisticsRequest->Reset)
+            {
+                RtlZeroMemory(CurrentEvent->HitStatistics, sizeof(DEBUGGER_EVENT_HIT_STATISTICS) * ProcessorsCount);
+            }
+        }
+    }
+
+    StatisticsRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
 }
 
 /**
@@ -1802,6 +4539,16 @@ DebuggerDisableEvent(UINT64 Tag)
     //
     Event->Enabled = FALSE;
 
+    //
+    // Release its hardware controls if no other event needs them
+    //
+    DebuggerDisarmEvent(Event);
+
+    //
+    // Cores should re-snapshot their armed events
+    //
+    DebuggerArmedEventsInvalidate();
+
     return TRUE;
 }
 
@@ -1890,6 +4637,12 @@ DebuggerRemoveEventFromEventList(UINT64 Tag)
                 // We have to remove the event from the list
                 //
                 RemoveEntryList(&CurrentEvent->EventsOfSameTypeList);
+
+                //
+                // Also remove it from the lookup index of events
+                //
+                DebuggerEventsIndexRemoveEvent(CurrentEvent);
+
                 return TRUE;
             }
         }
@@ -1929,15 +4682,39 @@ DebuggerRemoveAllActionsFromEvent(PDEBUGGER_EVENT Event)
         PDEBUGGER_EVENT_ACTION CurrentAction = CONTAINING_RECORD(TempList, DEBUGGER_EVENT_ACTION, ActionsList);
 
         //
-        // Check if it has a OptionalRequestedBuffer probably for
-        // CustomCode
+        // Check if it has a OptionalRequestedBuffer probably for
+        // CustomCode
+        //
+        if (CurrentAction->RequestedBuffer.RequestBufferSize != 0 && CurrentAction->RequestedBuffer.RequstBufferAddress != NULL)
+        {
+            //
+            // There is a buffer
+            //
+            ExFreePoolWithTag(CurrentAction->RequestedBuffer.RequstBufferAddress, POOLTAG);
+        }
+
+        //
+        // Release the (shared) code of the script of the action
+        //
+        if (CurrentAction->ScriptSharedCode != NULL)
+        {
+            ScriptEngineReleaseSharedCode(CurrentAction->ScriptSharedCode);
+        }
+
+        //
+        // The custom code no longer needs the XMM registers to be saved
+        //
+        if (CurrentAction->ActionType == RUN_CUSTOM_CODE)
+        {
+            VmFuncSetSaveXmmRegistersOnVmexits(FALSE);
+        }
+
+        //
+        // The action no longer needs the last branches to be recorded
         //
-        if (CurrentAction->RequestedBuffer.RequestBufferSize != 0 && CurrentAction->RequestedBuffer.RequstBufferAddress != NULL)
+        if (CurrentAction->ActionType == SHOW_LAST_BRANCH_RECORDS)
         {
-            //
-            // There is a buffer
-            //
-            ExFreePoolWithTag(CurrentAction->RequestedBuffer.RequstBufferAddress, POOLTAG);
+            VmFuncSetLastBranchRecords(FALSE);
         }
 
         //
@@ -1945,7 +4722,7 @@ DebuggerRemoveAllActionsFromEvent(PDEBUGGER_EVENT Event)
         // if it's a custom buffer then the buffer
         // is appended to the Action
         //
-        ExFreePoolWithTag(CurrentAction, POOLTAG);
+        SlabCacheFree(&g_ActionsSlabCache, CurrentAction, sizeof(DEBUGGER_EVENT_ACTION) + CurrentAction->CustomCodeBufferSize);
     }
     //
     // Remember to free the pool
@@ -1967,9 +4744,10 @@ DebuggerRemoveAllActionsFromEvent(PDEBUGGER_EVENT Event)
 BOOLEAN
 DebuggerRemoveEvent(UINT64 Tag)
 {
-    PDEBUGGER_EVENT Event;
-    PLIST_ENTRY     TempList  = 0;
-    PLIST_ENTRY     TempList2 = 0;
+    PDEBUGGER_EVENT              Event;
+    DEBUGGER_EVENT_RESOURCE_TYPE Resource;
+    PLIST_ENTRY                  TempList  = 0;
+    PLIST_ENTRY                  TempList2 = 0;
 
     //
     // First of all, we disable event
@@ -1998,11 +4776,63 @@ DebuggerRemoveEvent(UINT64 Tag)
         return FALSE;
     }
 
+    //
+    // The events that are not terminated (e.g., not applied successfully)
+    // still reference the per-core resource of their type
+    //
+    DebuggerReleaseEventResource(Event, &Resource);
+
+    //
+    // Make sure that no core still dispatches this event from its
+    // snapshot of armed events before freeing the event
+    //
+    DebuggerArmedEventsSynchronize();
+
     //
     // Remove all of the actions and free its pools
     //
     DebuggerRemoveAllActionsFromEvent(Event);
 
+    //
+    // Free the state of coalescing the accesses (if any)
+    //
+    if (Event->CoalescingStates != NULL)
+    {
+        ExFreePoolWithTag(Event->CoalescingStates, POOLTAG);
+    }
+
+    //
+    // Free the ranges of the multi-range monitor event (if any)
+    //
+    if (Event->MonitorRanges != NULL)
+    {
+        ExFreePoolWithTag(Event->MonitorRanges, POOLTAG);
+    }
+
+    //
+    // Free the slots of the monitor event (if any)
+    //
+    if (Event->MonitorSlots != NULL)
+    {
+        ExFreePoolWithTag(Event->MonitorSlots, POOLTAG);
+    }
+
+    //
+    // Free the state of limiting the rate of the event (if any)
+    //
+    if (Event->RateLimitStates != NULL)
+    {
+        ExFreePoolWithTag(Event->RateLimitStates, POOLTAG);
+    }
+
+    //
+    // Free the hit statistics of the event
+    //
+    if (Event->HitStatistics != NULL)
+    {
+        ExFreePoolWithTag(Event->HitStatistics, POOLTAG);
+    }
+
     //
     // Free the pools of Event, when we free the pool,
     // ConditionsBufferAddress is also a part of the
@@ -2010,7 +4840,7 @@ DebuggerRemoveEvent(UINT64 Tag)
     // are both allocate in a same pool ) so both of
     // them are freed
     //
-    ExFreePoolWithTag(Event, POOLTAG);
+    SlabCacheFree(&g_EventsSlabCache, Event, sizeof(DEBUGGER_EVENT) + Event->ConditionsBufferSize);
 
     return TRUE;
 }
@@ -2032,6 +4862,10 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
 {
     PDEBUGGER_EVENT Event;
     UINT64          PagesBytes;
+    UINT64          PageAddress;
+    BOOLEAN         MonitorForRead    = FALSE;
+    BOOLEAN         MonitorForWrite   = FALSE;
+    BOOLEAN         MonitorForExecute = FALSE;
     UINT32          TempPid;
     UINT32          ProcessorCount;
     BOOLEAN         ResultOfApplyingEvent = FALSE;
@@ -2095,6 +4929,22 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
         }
     }
 
+    //
+    // Check if thread id is valid or not
+    //
+    if (EventDetails->ThreadId != DEBUGGER_EVENT_APPLY_TO_ALL_THREADS)
+    {
+        //
+        // The used specified a special tid, let's check if it's valid or not
+        //
+        if (EventDetails->ThreadId == 0 || !CommonIsThreadExist(EventDetails->ThreadId))
+        {
+            ResultsToReturnUsermode->IsSuccessful = FALSE;
+            ResultsToReturnUsermode->Error        = DEBUGGER_ERROR_INVALID_THREAD_ID;
+            return FALSE;
+        }
+    }
+
     if (EventDetails->EventType == EXCEPTION_OCCURRED)
     {
         //
@@ -2151,6 +5001,26 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
             return FALSE;
         }
     }
+    else if (EventDetails->EventType == PAGE_FIRST_EXECUTION)
+    {
+        //
+        // Check if the 'to' is greater that 'from' and the mode is valid
+        //
+        if (EventDetails->OptionalParam1 >= EventDetails->OptionalParam2)
+        {
+            ResultsToReturnUsermode->IsSuccessful = FALSE;
+            ResultsToReturnUsermode->Error        = DEBUGGER_ERROR_INVALID_ADDRESS;
+            return FALSE;
+        }
+
+        if (EventDetails->OptionalParam3 != DEBUGGER_EVENT_EXEC_TRACE_USER_MODE &&
+            EventDetails->OptionalParam3 != DEBUGGER_EVENT_EXEC_TRACE_KERNEL_MODE)
+        {
+            ResultsToReturnUsermode->IsSuccessful = FALSE;
+            ResultsToReturnUsermode->Error        = DEBUGGER_ERROR_EVENT_TYPE_IS_INVALID;
+            return FALSE;
+        }
+    }
     else if (EventDetails->EventType == HIDDEN_HOOK_READ_AND_WRITE_AND_EXECUTE ||
              EventDetails->EventType == HIDDEN_HOOK_READ_AND_WRITE ||
              EventDetails->EventType == HIDDEN_HOOK_READ_AND_EXECUTE ||
@@ -2207,6 +5077,7 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
         Event = DebuggerCreateEvent(FALSE,
                                     EventDetails->CoreId,
                                     EventDetails->ProcessId,
+                                    EventDetails->ThreadId,
                                     EventDetails->EventType,
                                     EventDetails->Tag,
                                     EventDetails->OptionalParam1,
@@ -2224,6 +5095,7 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
         Event = DebuggerCreateEvent(FALSE,
                                     EventDetails->CoreId,
                                     EventDetails->ProcessId,
+                                    EventDetails->ThreadId,
                                     EventDetails->EventType,
                                     EventDetails->Tag,
                                     EventDetails->OptionalParam1,
@@ -2277,74 +5149,57 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
             EventDetails->ProcessId = PsGetCurrentProcessId();
         }
 
+        //
+        // Get the types of the monitored accesses
+        //
+        if (!DebuggerGetMonitorAccessTypes(EventDetails->EventType, &MonitorForRead, &MonitorForWrite, &MonitorForExecute))
+        {
+            LogError("Err, Invalid monitor hook type");
+
+            ResultsToReturnUsermode->IsSuccessful = FALSE;
+            ResultsToReturnUsermode->Error        = DEBUGGER_ERROR_EVENT_TYPE_IS_INVALID;
+
+            goto ClearTheEventAfterCreatingEvent;
+        }
+
         PagesBytes = PAGE_ALIGN(EventDetails->OptionalParam1);
         PagesBytes = EventDetails->OptionalParam2 - PagesBytes;
 
         for (size_t i = 0; i <= PagesBytes / PAGE_SIZE; i++)
         {
-            //
-            // In all the cases we should set both read/write, even if it's only
-            // read we should set the write too!
-            // Also execute bit has the same conditions here, because if write is set
-            // read should be also set
-            //
-            switch (EventDetails->EventType)
+            PageAddress = PAGE_ALIGN((UINT64)EventDetails->OptionalParam1 + (i * PAGE_SIZE));
+
+            //
+            // If a whole 2MB page is in the range, we try to monitor it without
+            // splitting it to 4KB pages (only possible if it's a large page in the
+            // target process and it's not split before), otherwise, it's monitored
+            // page by page
+            //
+            if ((PageAddress % DEBUGGER_EVENT_MONITOR_LARGE_PAGE_SIZE) == 0 &&
+                PageAddress >= EventDetails->OptionalParam1 &&
+                PageAddress + DEBUGGER_EVENT_MONITOR_LARGE_PAGE_SIZE - 1 <= EventDetails->OptionalParam2 &&
+                DebuggerEventEnableMonitorReadWriteExec(PageAddress,
+                                                        EventDetails->ProcessId,
+                                                        MonitorForRead,
+                                                        MonitorForWrite,
+                                                        MonitorForExecute,
+                                                        TRUE))
             {
-            case HIDDEN_HOOK_READ_AND_WRITE_AND_EXECUTE:
-            case HIDDEN_HOOK_READ_AND_EXECUTE:
-
-                ResultOfApplyingEvent = DebuggerEventEnableMonitorReadWriteExec((UINT64)EventDetails->OptionalParam1 + (i * PAGE_SIZE),
-                                                                                EventDetails->ProcessId,
-                                                                                TRUE,
-                                                                                TRUE,
-                                                                                TRUE);
-                break;
-
-            case HIDDEN_HOOK_WRITE_AND_EXECUTE:
-
-                ResultOfApplyingEvent = DebuggerEventEnableMonitorReadWriteExec((UINT64)EventDetails->OptionalParam1 + (i * PAGE_SIZE),
-                                                                                EventDetails->ProcessId,
-                                                                                FALSE,
-                                                                                TRUE,
-                                                                                FALSE);
-                break;
-
-            case HIDDEN_HOOK_READ_AND_WRITE:
-            case HIDDEN_HOOK_READ:
-                ResultOfApplyingEvent = DebuggerEventEnableMonitorReadWriteExec((UINT64)EventDetails->OptionalParam1 + (i * PAGE_SIZE),
-                                                                                EventDetails->ProcessId,
-                                                                                TRUE,
-                                                                                TRUE,
-                                                                                FALSE);
-
-                break;
+                ResultOfApplyingEvent = TRUE;
 
-            case HIDDEN_HOOK_WRITE:
+                //
+                // Skip the other 4KB pages of this 2MB page
+                //
+                i += (DEBUGGER_EVENT_MONITOR_LARGE_PAGE_SIZE / PAGE_SIZE) - 1;
+            }
+            else
+            {
                 ResultOfApplyingEvent = DebuggerEventEnableMonitorReadWriteExec((UINT64)EventDetails->OptionalParam1 + (i * PAGE_SIZE),
                                                                                 EventDetails->ProcessId,
-                                                                                FALSE,
-                                                                                TRUE,
+                                                                                MonitorForRead,
+                                                                                MonitorForWrite,
+                                                                                MonitorForExecute,
                                                                                 FALSE);
-
-                break;
-
-            case HIDDEN_HOOK_EXECUTE:
-                ResultOfApplyingEvent = DebuggerEventEnableMonitorReadWriteExec((UINT64)EventDetails->OptionalParam1 + (i * PAGE_SIZE),
-                                                                                EventDetails->ProcessId,
-                                                                                FALSE,
-                                                                                FALSE,
-                                                                                TRUE);
-                break;
-
-            default:
-                LogError("Err, Invalid monitor hook type");
-
-                ResultsToReturnUsermode->IsSuccessful = FALSE;
-                ResultsToReturnUsermode->Error        = DEBUGGER_ERROR_EVENT_TYPE_IS_INVALID;
-
-                goto ClearTheEventAfterCreatingEvent;
-
-                break;
             }
 
             if (!ResultOfApplyingEvent)
@@ -2398,6 +5253,68 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
             goto ClearTheEventAfterCreatingEvent;
         }
 
+        //
+        // The optional parameter 3 and 4 of the request are the count of accesses
+        // and the time window (in milliseconds) of coalescing the accesses (if any)
+        //
+        if (EventDetails->OptionalParam3 != 0 || EventDetails->OptionalParam4 != 0)
+        {
+            Event->CoalescingStates = ExAllocatePoolWithTag(NonPagedPool,
+                                                            sizeof(DEBUGGER_EVENT_COALESCING_STATE) * KeQueryActiveProcessorCount(0),
+                                                            POOLTAG);
+
+            if (Event->CoalescingStates == NULL)
+            {
+                ResultsToReturnUsermode->IsSuccessful = FALSE;
+                ResultsToReturnUsermode->Error        = DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_MONITOR_COALESCING_STATE;
+
+                goto ClearTheEventAfterCreatingEvent;
+            }
+
+            RtlZeroMemory(Event->CoalescingStates, sizeof(DEBUGGER_EVENT_COALESCING_STATE) * KeQueryActiveProcessorCount(0));
+
+            Event->CoalescingAccessCount = EventDetails->OptionalParam3;
+            Event->CoalescingWindow      = EventDetails->OptionalParam4 * 10000; // milliseconds to 100-nanosecond units
+        }
+
+        //
+        // Reserve the slots of the ranges that are added by the scripts (if any)
+        //
+        if (EventDetails->MonitorSlots != 0)
+        {
+            if (EventDetails->MonitorSlots > DEBUGGER_EVENT_MONITOR_MAXIMUM_SLOTS)
+            {
+                ResultsToReturnUsermode->IsSuccessful = FALSE;
+                ResultsToReturnUsermode->Error        = DEBUGGER_ERROR_MONITOR_RANGE_IS_INVALID;
+
+                goto ClearTheEventAfterCreatingEvent;
+            }
+
+            Event->MonitorSlots = ExAllocatePoolWithTag(NonPagedPool,
+                                                        sizeof(DEBUGGER_EVENT_MONITOR_SLOTS) + (EventDetails->MonitorSlots - 1) * sizeof(DEBUGGER_EVENT_MONITOR_SLOT),
+                                                        POOLTAG);
+
+            if (Event->MonitorSlots == NULL)
+            {
+                ResultsToReturnUsermode->IsSuccessful = FALSE;
+                ResultsToReturnUsermode->Error        = DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_MONITOR_RANGES;
+
+                goto ClearTheEventAfterCreatingEvent;
+            }
+
+            RtlZeroMemory(Event->MonitorSlots,
+                          sizeof(DEBUGGER_EVENT_MONITOR_SLOTS) + (EventDetails->MonitorSlots - 1) * sizeof(DEBUGGER_EVENT_MONITOR_SLOT));
+
+            Event->MonitorSlots->CountOfSlots = EventDetails->MonitorSlots;
+
+            //
+            // The pages of the slots are hooked in vmx-root, so the buffers
+            // of splitting and hooking them are reserved here
+            //
+            VmFuncEptHookAllocateExtraHookingPages(EventDetails->MonitorSlots * DEBUGGER_EVENT_MONITOR_SLOT_MAXIMUM_PAGES);
+            PoolManagerCheckAndPerformAllocationAndDeallocation();
+        }
+
         break;
     }
     case HIDDEN_HOOK_EXEC_CC:
@@ -2465,14 +5382,51 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
         //
         Event->OptionalParam1 = VirtualAddressToPhysicalAddressByProcessId(EventDetails->OptionalParam1, EventDetails->ProcessId);
 
+        //
+        // The virtual address is kept for hooking it again once the event
+        // is disarmed and enabled again
+        //
+        Event->OptionalParam3 = EventDetails->OptionalParam1;
+
+        break;
+    }
+    case PAGE_FIRST_EXECUTION:
+    {
+        //
+        // Check if process id is equal to DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES
+        // or if process id is 0 then we use the cr3 of current process
+        //
+        if (EventDetails->ProcessId == DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES || EventDetails->ProcessId == 0)
+        {
+            EventDetails->ProcessId = PsGetCurrentProcessId();
+        }
+
+        //
+        // Invoke the tracer, the range is found by the tag of the event
+        //
+        if (!ConfigureModeBasedExecHookTraceRange(Event->Tag,
+                                                  EventDetails->OptionalParam1,
+                                                  EventDetails->OptionalParam2,
+                                                  EventDetails->ProcessId,
+                                                  EventDetails->OptionalParam3 == DEBUGGER_EVENT_EXEC_TRACE_USER_MODE))
+        {
+            //
+            // There was an error applying this event, so we're setting
+            // the event
+            //
+            ResultsToReturnUsermode->IsSuccessful = FALSE;
+            ResultsToReturnUsermode->Error        = DebuggerGetLastError();
+            goto ClearTheEventAfterCreatingEvent;
+        }
+
         break;
     }
     case RDMSR_INSTRUCTION_EXECUTION:
     {
         //
-        // KEEP IN MIND, WE USED THIS METHOD TO RE-APPLY THE EVENT ON
-        // TERMINATION ROUTINES, IF YOU WANT TO CHANGE IT, YOU SHOULD
-        // CHANGE THE TERMINATION.C RELATED FUNCTION TOO
+        // KEEP IN MIND, THE BITS OF MSR BITMAP ARE REFERENCE COUNTED, THE
+        // REFERENCE THAT IS ADDED HERE IS RELEASED BY TERMINATERDMSREXECUTIONEVENT
+        // (TERMINATION.C), IF YOU WANT TO CHANGE IT, CHANGE THERE TOO
         //
 
         //
@@ -2503,9 +5457,9 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
     case WRMSR_INSTRUCTION_EXECUTION:
     {
         //
-        // KEEP IN MIND, WE USED THIS METHOD TO RE-APPLY THE EVENT ON
-        // TERMINATION ROUTINES, IF YOU WANT TO CHANGE IT, YOU SHOULD
-        // CHANGE THE TERMINATION.C RELATED FUNCTION TOO
+        // KEEP IN MIND, THE BITS OF MSR BITMAP ARE REFERENCE COUNTED, THE
+        // REFERENCE THAT IS ADDED HERE IS RELEASED BY TERMINATEWRMSREXECUTIONEVENT
+        // (TERMINATION.C), IF YOU WANT TO CHANGE IT, CHANGE THERE TOO
         //
 
         //
@@ -2537,25 +5491,18 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
     case OUT_INSTRUCTION_EXECUTION:
     {
         //
-        // Let's see if it is for all cores or just one core
+        // KEEP IN MIND, THE REFERENCE TO THE PORT IS RELEASED ON THE
+        // TERMINATION ROUTINES, IF YOU WANT TO CHANGE IT, YOU SHOULD
+        // CHANGE THE TERMINATION.C RELATED FUNCTION TOO
         //
-        if (EventDetails->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-        {
-            //
-            // All cores
-            //
-            ExtensionCommandIoBitmapChangeAllCores(EventDetails->OptionalParam1);
-        }
-        else
-        {
-            //
-            // Just one core
-            //
-            ConfigureChangeIoBitmapOnSingleCore(EventDetails->CoreId, EventDetails->OptionalParam1);
-        }
+        DebuggerChangeBitmapOwnership(EventDetails->CoreId,
+                                      TRUE,
+                                      BITMAP_OWNERSHIP_RESOURCE_IO_PORT,
+                                      EventDetails->OptionalParam1,
+                                      0);
 
         //
-        // Setting an indicator to MSR
+        // Setting an indicator to I/O port
         //
         Event->OptionalParam1 = EventDetails->OptionalParam1;
 
@@ -2587,6 +5534,12 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
             ConfigureEnableRdtscExitingOnSingleCore(EventDetails->CoreId);
         }
 
+        //
+        // Enable triggering events for RDTSCs and RDTSCPs (so they are
+        // not handled in the fast-path of vm-exits)
+        //
+        VmFuncSetTriggerEventForTscs(TRUE);
+
         break;
     }
     case PMC_INSTRUCTION_EXECUTION:
@@ -2620,36 +5573,23 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
     case DEBUG_REGISTERS_ACCESSED:
     {
         //
-        // KEEP IN MIND, WE USED THIS METHOD TO RE-APPLY THE EVENT ON
-        // TERMINATION ROUTINES, IF YOU WANT TO CHANGE IT, YOU SHOULD
-        // CHANGE THE TERMINATION.C RELATED FUNCTION TOO
-        //
-
-        //
-        // Let's see if it is for all cores or just one core
+        // KEEP IN MIND, THE REFERENCE TO MOV TO DEBUG REGISTERS EXITING IS
+        // RELEASED ON THE TERMINATION ROUTINES, IF YOU WANT TO CHANGE IT,
+        // YOU SHOULD CHANGE THE TERMINATION.C RELATED FUNCTION TOO
         //
-        if (EventDetails->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-        {
-            //
-            // All cores
-            //
-            ExtensionCommandEnableMovDebugRegistersExitingAllCores();
-        }
-        else
-        {
-            //
-            // Just one core
-            //
-            ConfigureEnableMovToDebugRegistersExitingOnSingleCore(EventDetails->CoreId);
-        }
+        DebuggerChangeBitmapOwnership(EventDetails->CoreId,
+                                      TRUE,
+                                      BITMAP_OWNERSHIP_RESOURCE_MOV_TO_DEBUG_REGS,
+                                      0,
+                                      0);
 
         break;
     }
     case CONTROL_REGISTER_MODIFIED:
     {
         //
-        // KEEP IN MIND, WE USED THIS METHOD TO RE-APPLY THE EVENT ON
-        // TERMINATION ROUTINES, IF YOU WANT TO CHANGE IT, YOU SHOULD
+        // KEEP IN MIND, THE REFERENCE TO THE BITS OF THE CR IS RELEASED ON
+        // THE TERMINATION ROUTINES, IF YOU WANT TO CHANGE IT, YOU SHOULD
         // CHANGE THE TERMINATION.C RELATED FUNCTION TOO
         //
 
@@ -2659,27 +5599,19 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
         Event->OptionalParam1 = EventDetails->OptionalParam1;
         Event->OptionalParam2 = EventDetails->OptionalParam2;
 
+        DebuggerChangeBitmapOwnership(EventDetails->CoreId,
+                                      TRUE,
+                                      BITMAP_OWNERSHIP_RESOURCE_MOV_TO_CONTROL_REGS,
+                                      Event->OptionalParam1,
+                                      Event->OptionalParam2);
+
         //
-        // Let's see if it is for all cores or just one core
+        // Events of cr3 need all of the mov-to-cr3s (even if the user debugger
+        // filtered them)
         //
-        if (EventDetails->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-        {
-            //
-            // All cores
-            //
-            ExtensionCommandEnableMovControlRegisterExitingAllCores(Event);
-        }
-        else
+        if (Event->OptionalParam1 == VMX_EXIT_QUALIFICATION_REGISTER_CR3)
         {
-            //
-            // Just one core
-            //
-            DEBUGGER_BROADCASTING_OPTIONS BroadcastingOption = {0};
-
-            BroadcastingOption.OptionalParam1 = Event->OptionalParam1;
-            BroadcastingOption.OptionalParam2 = Event->OptionalParam2;
-
-            ConfigureEnableMovToControlRegisterExitingOnSingleCore(EventDetails->CoreId, &BroadcastingOption);
+            VmFuncBypassCr3VmexitFilter(TRUE);
         }
 
         break;
@@ -2687,29 +5619,15 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
     case EXCEPTION_OCCURRED:
     {
         //
-        // KEEP IN MIND, WE USED THIS METHOD TO RE-APPLY THE EVENT ON
+        // KEEP IN MIND, THE REFERENCE TO THE VECTOR IS RELEASED ON THE
         // TERMINATION ROUTINES, IF YOU WANT TO CHANGE IT, YOU SHOULD
         // CHANGE THE TERMINATION.C RELATED FUNCTION TOO
         //
-
-        //
-        // Let's see if it is for all cores or just one core
-        //
-
-        if (EventDetails->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-        {
-            //
-            // All cores
-            //
-            ExtensionCommandSetExceptionBitmapAllCores(EventDetails->OptionalParam1);
-        }
-        else
-        {
-            //
-            // Just one core
-            //
-            ConfigureSetExceptionBitmapOnSingleCore(EventDetails->CoreId, EventDetails->OptionalParam1);
-        }
+        DebuggerChangeBitmapOwnership(EventDetails->CoreId,
+                                      TRUE,
+                                      BITMAP_OWNERSHIP_RESOURCE_EXCEPTION,
+                                      EventDetails->OptionalParam1,
+                                      0);
 
         //
         // Set the event's target exception
@@ -2727,9 +5645,23 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
         //
 
         //
-        // Let's see if it is for all cores or just one core
+        // The entry of the vector in the IDT (!interrupt2) is hooked on all
+        // cores, the events of a single core are filtered while they're triggered
         //
-        if (EventDetails->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
+        if (EventDetails->OptionalParam2 == DEBUGGER_EVENT_INTERRUPT_IDT_ENTRY_HOOK)
+        {
+            if (!ConfigureEnableIdtEntryInterruptHook((UINT32)EventDetails->OptionalParam1))
+            {
+                //
+                // There was an error applying this event, so we're setting
+                // the event
+                //
+                ResultsToReturnUsermode->IsSuccessful = FALSE;
+                ResultsToReturnUsermode->Error        = DebuggerGetLastError();
+                goto ClearTheEventAfterCreatingEvent;
+            }
+        }
+        else if (EventDetails->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
         {
             //
             // All cores
@@ -2772,11 +5704,29 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
         {
             SyscallHookType = DEBUGGER_EVENT_SYSCALL_SYSRET_SAFE_ACCESS_MEMORY;
         }
+        else if (EventDetails->OptionalParam2 == DEBUGGER_EVENT_SYSCALL_SYSRET_LSTAR_ENTRY_HOOK)
+        {
+            SyscallHookType = DEBUGGER_EVENT_SYSCALL_SYSRET_LSTAR_ENTRY_HOOK;
+        }
 
         //
-        // Let's see if it is for all cores or just one core
+        // The entry of system calls (!syscall3) is hooked on all cores, the
+        // events of a single core are filtered while they're triggered
         //
-        if (EventDetails->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
+        if (SyscallHookType == DEBUGGER_EVENT_SYSCALL_SYSRET_LSTAR_ENTRY_HOOK)
+        {
+            if (!ConfigureEnableLstarSyscallHook())
+            {
+                //
+                // There was an error applying this event, so we're setting
+                // the event
+                //
+                ResultsToReturnUsermode->IsSuccessful = FALSE;
+                ResultsToReturnUsermode->Error        = DebuggerGetLastError();
+                goto ClearTheEventAfterCreatingEvent;
+            }
+        }
+        else if (EventDetails->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
         {
             //
             // All cores
@@ -2798,6 +5748,11 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
         Event->OptionalParam1 = EventDetails->OptionalParam1;
         Event->OptionalParam2 = SyscallHookType;
 
+        //
+        // Update the filter of syscall numbers (the event is already in the list)
+        //
+        DebuggerEventUpdateSyscallFilter(NULL);
+
         break;
     }
     case SYSCALL_HOOK_EFER_SYSRET:
@@ -2873,6 +5828,11 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
         //
         VmFuncSetTriggerEventForCpuids(TRUE);
 
+        //
+        // Update the filter of CPUID leaves (the event is already in the list)
+        //
+        DebuggerEventUpdateCpuidFilter(NULL);
+
         break;
     }
     default:
@@ -2893,6 +5853,52 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
     //
     Event->EnableShortCircuiting = EventDetails->EnableShortCircuiting;
 
+    //
+    // Set the rate limit of the event (if any), each core starts with a
+    // full bucket of tokens
+    //
+    if (EventDetails->RateLimit != 0)
+    {
+        Event->RateLimitStates = ExAllocatePoolWithTag(NonPagedPool,
+                                                       sizeof(DEBUGGER_EVENT_RATE_LIMIT_STATE) * KeQueryActiveProcessorCount(0),
+                                                       POOLTAG);
+
+        if (Event->RateLimitStates == NULL)
+        {
+            ResultsToReturnUsermode->IsSuccessful = FALSE;
+            ResultsToReturnUsermode->Error        = DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_EVENT_RATE_LIMIT_STATE;
+
+            goto ClearTheEventAfterCreatingEvent;
+        }
+
+        for (UINT32 i = 0; i < KeQueryActiveProcessorCount(0); i++)
+        {
+            Event->RateLimitStates[i].Tokens          = EventDetails->RateLimit;
+            Event->RateLimitStates[i].LastRefillTime  = KeQueryInterruptTime();
+            Event->RateLimitStates[i].DroppedTriggers = 0;
+            Event->RateLimitStates[i].IsDisarmed      = FALSE;
+        }
+
+        Event->RateLimit = EventDetails->RateLimit;
+    }
+
+    //
+    // Allocate the per-core hit statistics of the event
+    //
+    Event->HitStatistics = ExAllocatePoolWithTag(NonPagedPoolCacheAligned,
+                                                 sizeof(DEBUGGER_EVENT_HIT_STATISTICS) * KeQueryActiveProcessorCount(0),
+                                                 POOLTAG);
+
+    if (Event->HitStatistics == NULL)
+    {
+        ResultsToReturnUsermode->IsSuccessful = FALSE;
+        ResultsToReturnUsermode->Error        = DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_EVENT_STATISTICS;
+
+        goto ClearTheEventAfterCreatingEvent;
+    }
+
+    RtlZeroMemory(Event->HitStatistics, sizeof(DEBUGGER_EVENT_HIT_STATISTICS) * KeQueryActiveProcessorCount(0));
+
     //
     // Set the event mode (pre- post- event)
     //
@@ -2908,6 +5914,14 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
         Event->EventMode = VMM_CALLBACK_CALLING_STAGE_PRE_EVENT_EMULATION;
     }
 
+    //
+    // Now that the parameters of the event are finalized (e.g., addresses
+    // are converted to physical addresses), put it into the right bucket
+    // of the lookup index
+    //
+    DebuggerEventsIndexUpdateEvent(Event);
+    DebuggerArmedEventsInvalidate();
+
     //
     // Set the status
     //
@@ -3032,6 +6046,7 @@ DebuggerParseActionFromUsermode(PDEBUGGER_GENERAL_ACTION Action, UINT32 BufferLe
         UserScriptConfig.ScriptLength                                   = Action->ScriptBufferSize;
         UserScriptConfig.ScriptPointer                                  = Action->ScriptBufferPointer;
         UserScriptConfig.OptionalRequestedBufferSize                    = Action->PreAllocatedBuffer;
+        UserScriptConfig.InstructionsBudget                             = Action->ScriptInstructionsBudget;
 
         DebuggerAddActionToEvent(Event, RUN_SCRIPT, Action->ImmediateMessagePassing, NULL, &UserScriptConfig);
 
@@ -3052,6 +6067,46 @@ DebuggerParseActionFromUsermode(PDEBUGGER_GENERAL_ACTION Action, UINT32 BufferLe
         //
         DebuggerEnableEvent(Event->Tag);
     }
+    else if (Action->ActionType == SHOW_LAST_BRANCH_RECORDS)
+    {
+        //
+        // It's added below as the last branch records could also be shown
+        // along with the other actions
+        //
+        if (Action->LastBranchRecordsCount == 0)
+        {
+            //
+            // Set the appropriate error
+            //
+            ResultsToReturnUsermode->IsSuccessful = FALSE;
+            ResultsToReturnUsermode->Error        = DEBUGGER_ERROR_INVALID_ACTION_TYPE;
+
+            //
+            // Show that the
+            //
+            return FALSE;
+        }
+    }
+    else if (Action->ActionType == RECORD_HITS)
+    {
+        //
+        // It's added below as the hits could also be recorded along with
+        // the other actions
+        //
+        if (Action->RecordConfiguration.CountOfValues == 0)
+        {
+            //
+            // Set the appropriate error
+            //
+            ResultsToReturnUsermode->IsSuccessful = FALSE;
+            ResultsToReturnUsermode->Error        = DEBUGGER_ERROR_INVALID_ACTION_TYPE;
+
+            //
+            // Show that the
+            //
+            return FALSE;
+        }
+    }
     else
     {
         //
@@ -3066,12 +6121,232 @@ DebuggerParseActionFromUsermode(PDEBUGGER_GENERAL_ACTION Action, UINT32 BufferLe
         return FALSE;
     }
 
+    //
+    // Add the action for showing the last branch records, it's added after
+    // the other actions, so it's performed before them (e.g., before
+    // breaking to the debugger)
+    //
+    if (Action->LastBranchRecordsCount != 0)
+    {
+        PDEBUGGER_EVENT_ACTION LbrAction = DebuggerAddActionToEvent(Event, SHOW_LAST_BRANCH_RECORDS, Action->ImmediateMessagePassing, NULL, NULL);
+
+        if (LbrAction == NULL)
+        {
+            //
+            // Set the appropriate error
+            //
+            ResultsToReturnUsermode->IsSuccessful = FALSE;
+            ResultsToReturnUsermode->Error        = DEBUGGER_ERROR_LAST_BRANCH_RECORDS_ARE_NOT_SUPPORTED;
+
+            //
+            // Show that the
+            //
+            return FALSE;
+        }
+
+        LbrAction->LastBranchRecordsCount = min(Action->LastBranchRecordsCount, LastBranchRecordsMaximumCount);
+
+        //
+        // Enable the event
+        //
+        DebuggerEnableEvent(Event->Tag);
+    }
+
+    //
+    // Add the action for recording the hits
+    //
+    if (Action->RecordConfiguration.CountOfValues != 0)
+    {
+        if (Action->RecordConfiguration.CountOfValues > EventRecordMaximumValues)
+        {
+            //
+            // Set the appropriate error
+            //
+            ResultsToReturnUsermode->IsSuccessful = FALSE;
+            ResultsToReturnUsermode->Error        = DEBUGGER_ERROR_INVALID_ACTION_TYPE;
+
+            //
+            // Show that the
+            //
+            return FALSE;
+        }
+
+        PDEBUGGER_EVENT_ACTION RecordAction = DebuggerAddActionToEvent(Event, RECORD_HITS, Action->ImmediateMessagePassing, NULL, NULL);
+
+        if (RecordAction == NULL)
+        {
+            //
+            // Set the appropriate error
+            //
+            ResultsToReturnUsermode->IsSuccessful = FALSE;
+            ResultsToReturnUsermode->Error        = DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_EVENT_RECORDS;
+
+            //
+            // Show that the
+            //
+            return FALSE;
+        }
+
+        RecordAction->RecordConfiguration = Action->RecordConfiguration;
+
+        //
+        // Enable the event
+        //
+        DebuggerEnableEvent(Event->Tag);
+    }
+
     ResultsToReturnUsermode->IsSuccessful = TRUE;
     ResultsToReturnUsermode->Error        = 0;
 
     return TRUE;
 }
 
+/**
+ * @brief Get an entry of the stream of a batch of events
+ *
+ * @param EventsBatchRequest The request followed by the stream of entries
+ * @param Offset Offset of the entry in the stream
+ * @return PDEBUGGER_EVENTS_BATCH_ENTRY The entry or NULL if the entry
+ * (or its buffer) is not in the stream
+ */
+static PDEBUGGER_EVENTS_BATCH_ENTRY
+DebuggerGetEventsBatchEntry(PDEBUGGER_EVENTS_BATCH_REQUEST EventsBatchRequest, UINT32 Offset)
+{
+    PDEBUGGER_EVENTS_BATCH_ENTRY Entry;
+
+    if ((UINT64)Offset + sizeof(DEBUGGER_EVENTS_BATCH_ENTRY) > EventsBatchRequest->EntriesBufferSize)
+    {
+        return NULL;
+    }
+
+    Entry = (PDEBUGGER_EVENTS_BATCH_ENTRY)((UINT64)EventsBatchRequest + SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST + Offset);
+
+    if ((UINT64)Offset + DEBUGGER_EVENTS_BATCH_ENTRY_LENGTH((UINT64)Entry->Size) > EventsBatchRequest->EntriesBufferSize)
+    {
+        return NULL;
+    }
+
+    return Entry;
+}
+
+/**
+ * @brief Routine for validating and parsing a batch of events and actions
+ * that are comming from the user-mode
+ * @details the events of the batch are not enabled until all of the
+ * entries are applied, so either all of the events of the batch are
+ * triggered or none of them (the events are removed if one of the entries
+ * is not applied)
+ *
+ * @param EventsBatchRequest The request followed by the stream of entries,
+ * the results are also written to the request
+ * @param BufferLength Length of the buffer that comes from user-mode
+ * @return BOOLEAN if all of the entries are applied, return TRUE
+ * otherwise, returns FALSE
+ */
+BOOLEAN
+DebuggerParseEventsBatchFromUsermode(PDEBUGGER_EVENTS_BATCH_REQUEST EventsBatchRequest, UINT32 BufferLength)
+{
+    DEBUGGER_EVENT_AND_ACTION_REG_BUFFER Result = {0};
+    PDEBUGGER_EVENTS_BATCH_ENTRY         Entry;
+    UINT32                               Offset = 0;
+
+    EventsBatchRequest->CountOfAppliedEntries = 0;
+
+    if (BufferLength < SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST ||
+        EventsBatchRequest->EntriesBufferSize > BufferLength - SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST)
+    {
+        EventsBatchRequest->KernelStatus = DEBUGGER_ERROR_INVALID_EVENTS_BATCH;
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < EventsBatchRequest->CountOfEntries; i++)
+    {
+        Entry = DebuggerGetEventsBatchEntry(EventsBatchRequest, Offset);
+
+        if (Entry == NULL)
+        {
+            Result.Error = DEBUGGER_ERROR_INVALID_EVENTS_BATCH;
+            goto RemoveTheEventsOfTheBatch;
+        }
+
+        if (Entry->Type == DEBUGGER_EVENTS_BATCH_ENTRY_EVENT && Entry->Size >= sizeof(DEBUGGER_GENERAL_EVENT_DETAIL))
+        {
+            DebuggerParseEventFromUsermode((PDEBUGGER_GENERAL_EVENT_DETAIL)(Entry + 1), Entry->Size, &Result);
+        }
+        else if (Entry->Type == DEBUGGER_EVENTS_BATCH_ENTRY_ACTION && Entry->Size >= sizeof(DEBUGGER_GENERAL_ACTION))
+        {
+            DebuggerParseActionFromUsermode((PDEBUGGER_GENERAL_ACTION)(Entry + 1), Entry->Size, &Result);
+
+            //
+            // Adding the action enables the event, but the event should be
+            // kept disabled until the whole batch is applied
+            //
+            DebuggerDisableEvent(((PDEBUGGER_GENERAL_ACTION)(Entry + 1))->EventTag);
+        }
+        else
+        {
+            Result.IsSuccessful = FALSE;
+            Result.Error        = DEBUGGER_ERROR_INVALID_EVENTS_BATCH;
+        }
+
+        if (!Result.IsSuccessful)
+        {
+            goto RemoveTheEventsOfTheBatch;
+        }
+
+        EventsBatchRequest->CountOfAppliedEntries++;
+        Offset += DEBUGGER_EVENTS_BATCH_ENTRY_LENGTH(Entry->Size);
+    }
+
+    //
+    // All of the entries are applied, now enable the events that have
+    // actions (at once)
+    //
+    Offset = 0;
+
+    for (UINT32 i = 0; i < EventsBatchRequest->CountOfEntries; i++)
+    {
+        Entry = DebuggerGetEventsBatchEntry(EventsBatchRequest, Offset);
+
+        if (Entry->Type == DEBUGGER_EVENTS_BATCH_ENTRY_ACTION)
+        {
+            DebuggerEnableEvent(((PDEBUGGER_GENERAL_ACTION)(Entry + 1))->EventTag);
+        }
+
+        Offset += DEBUGGER_EVENTS_BATCH_ENTRY_LENGTH(Entry->Size);
+    }
+
+    EventsBatchRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    return TRUE;
+
+RemoveTheEventsOfTheBatch:
+
+    //
+    // Remove the events that are registered by the applied entries (the
+    // event of the failed entry is already removed)
+    //
+    Offset = 0;
+
+    for (UINT32 i = 0; i < EventsBatchRequest->CountOfAppliedEntries; i++)
+    {
+        Entry = DebuggerGetEventsBatchEntry(EventsBatchRequest, Offset);
+
+        if (Entry->Type == DEBUGGER_EVENTS_BATCH_ENTRY_EVENT)
+        {
+            DebuggerDisableEvent(((PDEBUGGER_GENERAL_EVENT_DETAIL)(Entry + 1))->Tag);
+            DebuggerTerminateEvent(((PDEBUGGER_GENERAL_EVENT_DETAIL)(Entry + 1))->Tag);
+            DebuggerRemoveEvent(((PDEBUGGER_GENERAL_EVENT_DETAIL)(Entry + 1))->Tag);
+        }
+
+        Offset += DEBUGGER_EVENTS_BATCH_ENTRY_LENGTH(Entry->Size);
+    }
+
+    EventsBatchRequest->KernelStatus = Result.Error != 0 ? Result.Error : DEBUGGER_ERROR_INVALID_EVENTS_BATCH;
+
+    return FALSE;
+}
+
 /**
  * @brief Terminate one event's effect by its tag
  *
@@ -3101,6 +6376,15 @@ DebuggerTerminateEvent(UINT64 Tag)
         return FALSE;
     }
 
+    //
+    // The bitmaps and the EPT hooks of the disarmed events are already
+    // released
+    //
+    if (DebuggerForgetDisarmedEvent(Event))
+    {
+        return TRUE;
+    }
+
     //
     // Check the event type of our specific tag
     //
@@ -3148,6 +6432,15 @@ DebuggerTerminateEvent(UINT64 Tag)
 
         break;
     }
+    case PAGE_FIRST_EXECUTION:
+    {
+        //
+        // Call mode-based execution trace terminator
+        //
+        TerminatePageFirstExecutionEvent(Event);
+
+        break;
+    }
     case RDMSR_INSTRUCTION_EXECUTION:
     {
         //
@@ -3404,6 +6697,18 @@ DebuggerParseEventsModificationFromUsermode(PDEBUGGER_MODIFY_EVENTS DebuggerEven
             DebuggerRemoveEvent(DebuggerEventModificationRequest->Tag);
         }
     }
+    else if (DebuggerEventModificationRequest->TypeOfAction == DEBUGGER_MODIFY_EVENTS_SET_OUTPUT)
+    {
+        //
+        // Set whether the messages of the event are generated
+        //
+        if (!DebuggerSetEventOutputState(DebuggerEventModificationRequest->Tag,
+                                         DebuggerEventModificationRequest->IsEnabled))
+        {
+            DebuggerEventModificationRequest->KernelStatus = DEBUGGER_ERROR_TAG_NOT_EXISTS;
+            return FALSE;
+        }
+    }
     else if (DebuggerEventModificationRequest->TypeOfAction == DEBUGGER_MODIFY_EVENTS_QUERY_STATE)
     {
         //
@@ -3426,6 +6731,36 @@ DebuggerParseEventsModificationFromUsermode(PDEBUGGER_MODIFY_EVENTS DebuggerEven
         {
             DebuggerEventModificationRequest->IsEnabled = FALSE;
         }
+
+        DebuggerQueryScriptStatisticsOfEvent(DebuggerEventModificationRequest->Tag,
+                                             &DebuggerEventModificationRequest->ScriptStatistics);
+    }
+    else if (DebuggerEventModificationRequest->TypeOfAction == DEBUGGER_MODIFY_EVENTS_ADD_MONITOR_RANGE ||
+             DebuggerEventModificationRequest->TypeOfAction == DEBUGGER_MODIFY_EVENTS_REMOVE_MONITOR_RANGE)
+    {
+        //
+        // The ranges are only modified for a single event
+        //
+        if (IsForAllEvents)
+        {
+            DebuggerEventModificationRequest->KernelStatus = DEBUGGER_ERROR_MODIFY_EVENTS_INVALID_TAG;
+            return FALSE;
+        }
+
+        if (DebuggerEventModificationRequest->TypeOfAction == DEBUGGER_MODIFY_EVENTS_ADD_MONITOR_RANGE)
+        {
+            DebuggerEventModificationRequest->KernelStatus = DebuggerAddMonitorRangeToEvent(DebuggerEventModificationRequest->Tag,
+                                                                                            DebuggerEventModificationRequest->RangeStart,
+                                                                                            DebuggerEventModificationRequest->RangeEnd);
+        }
+        else
+        {
+            DebuggerEventModificationRequest->KernelStatus = DebuggerRemoveMonitorRangeFromEvent(DebuggerEventModificationRequest->Tag,
+                                                                                                 DebuggerEventModificationRequest->RangeStart,
+                                                                                                 DebuggerEventModificationRequest->RangeEnd);
+        }
+
+        return DebuggerEventModificationRequest->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL;
     }
     else
     {
@@ -0,0 +1,426 @@
+/**
+ * @file DebuggerArmedEvents.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Implementation of the per-core snapshot of armed (enabled) events
+ * @details Instead of reading the shared lists of events in vmx-root, each
+ * core dispatches events from a contiguous array of its own armed events.
+ * Whenever events are registered, enabled, disabled or removed, a new
+ * generation is published and each core rebuilds its own snapshot the next
+ * time that it dispatches an event (when it's not in the middle of the
+ * dispatching). Removing (freeing) events waits until all the cores either
+ * observed the new generation or are not dispatching events (a quiescent state)
+ *
+ * @version 0.4
+ * @date 2023-07-09
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Allocate the snapshot of armed events for a core
+ * @details should not be called from vmx-root mode
+ *
+ * @param DbgState The state of the debugger on the target core
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+DebuggerArmedEventsInitialize(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    PDEBUGGER_ARMED_EVENTS_SNAPSHOT Snapshot = NULL;
+
+    if (DbgState->ArmedEventsSnapshot != NULL)
+    {
+        //
+        // Already allocated
+        //
+        return TRUE;
+    }
+
+    Snapshot = ExAllocatePoolWithTag(NonPagedPool, sizeof(DEBUGGER_ARMED_EVENTS_SNAPSHOT), POOLTAG);
+
+    if (Snapshot == NULL)
+    {
+        return FALSE;
+    }
+
+    RtlZeroMemory(Snapshot, sizeof(DEBUGGER_ARMED_EVENTS_SNAPSHOT));
+
+    //
+    // Make sure that the snapshot is built on the first dispatch
+    //
+    Snapshot->Generation = -1;
+
+    DbgState->ArmedEventsSnapshot = Snapshot;
+
+    return TRUE;
+}
+
+/**
+ * @brief Free the snapshot of armed events of a core
+ * @details should not be called from vmx-root mode
+ *
+ * @param DbgState The state of the debugger on the target core
+ *
+ * @return VOID
+ */
+VOID
+DebuggerArmedEventsUninitialize(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    if (DbgState->ArmedEventsSnapshot != NULL)
+    {
+        ExFreePoolWithTag(DbgState->ArmedEventsSnapshot, POOLTAG);
+        DbgState->ArmedEventsSnapshot = NULL;
+    }
+}
+
+/**
+ * @brief Publish a new generation of events
+ * @details the snapshots are rebuilt lazily by their owner cores,
+ * this function can be called from vmx-root mode
+ *
+ * @return VOID
+ */
+VOID
+DebuggerArmedEventsInvalidate()
+{
+    InterlockedIncrement64(&g_ArmedEventsGeneration);
+}
+
+/**
+ * @brief Publish a new generation of events and wait until no
+ * core uses the older generation
+ * @details should be called after unlinking an event and before freeing
+ * its buffers, should not be called from vmx-root mode
+ *
+ * @return VOID
+ */
+VOID
+DebuggerArmedEventsSynchronize()
+{
+    ULONG                           ProcessorsCount = KeQueryActiveProcessorCount(0);
+    LONG64                          NewGeneration   = InterlockedIncrement64(&g_ArmedEventsGeneration);
+    PDEBUGGER_ARMED_EVENTS_SNAPSHOT Snapshot        = NULL;
+
+    if (VmFuncVmxGetCurrentExecutionMode() == TRUE)
+    {
+        //
+        // Other cores might be halted in the middle of dispatching events
+        // so we cannot wait for them here
+        //
+        return;
+    }
+
+    for (ULONG i = 0; i < ProcessorsCount; i++)
+    {
+        Snapshot = g_DbgState[i].ArmedEventsSnapshot;
+
+        if (Snapshot == NULL)
+        {
+            continue;
+        }
+
+        //
+        // Wait for the quiescent state of the target core
+        //
+        while (Snapshot->DispatchDepth != 0 && Snapshot->Generation < NewGeneration)
+        {
+            YieldProcessor();
+        }
+    }
+}
+
+/**
+ * @brief Sort the keyed entries of a single event type by their keys
+ *
+ * @param Entries The first entry
+ * @param Count Count of entries
+ *
+ * @return VOID
+ */
+static VOID
+DebuggerArmedEventsSortByKey(PDEBUGGER_ARMED_EVENT Entries, UINT32 Count)
+{
+    DEBUGGER_ARMED_EVENT Temp;
+
+    //
+    // Insertion sort, the snapshot is only rebuilt when events are changed
+    // and it keeps the (newest first) order of events with a same key
+    //
+    for (UINT32 i = 1; i < Count; i++)
+    {
+        Temp    = Entries[i];
+        INT32 j = i - 1;
+
+        while (j >= 0 && Entries[j].Key > Temp.Key)
+        {
+            Entries[j + 1] = Entries[j];
+            j--;
+        }
+
+        Entries[j + 1] = Temp;
+    }
+}
+
+/**
+ * @brief Add the armed events of a list of the lookup index to the snapshot
+ *
+ * @param Snapshot The snapshot of the current core
+ * @param ListHead The list of the lookup index
+ * @param CoreId The owner core of the snapshot
+ * @param IsWildcard Whether the list is the wildcard list
+ *
+ * @return BOOLEAN FALSE if the snapshot is full
+ */
+static BOOLEAN
+DebuggerArmedEventsAddList(PDEBUGGER_ARMED_EVENTS_SNAPSHOT Snapshot,
+                           PLIST_ENTRY                     ListHead,
+                           UINT32                          CoreId,
+                           BOOLEAN                         IsWildcard)
+{
+    PLIST_ENTRY           TempList = ListHead;
+    PDEBUGGER_ARMED_EVENT Entry    = NULL;
+
+    while (ListHead != TempList->Flink)
+    {
+        TempList                     = TempList->Flink;
+        PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameIndexList);
+
+        //
+        // Only enabled events of this core are armed
+        //
+        if (!CurrentEvent->Enabled ||
+            (CurrentEvent->CoreId != DEBUGGER_EVENT_APPLY_TO_ALL_CORES && CurrentEvent->CoreId != CoreId))
+        {
+            continue;
+        }
+
+        if (Snapshot->EntriesCount >= DEBUGGER_ARMED_EVENTS_MAXIMUM_ENTRIES)
+        {
+            return FALSE;
+        }
+
+        Entry             = &Snapshot->Entries[Snapshot->EntriesCount++];
+        Entry->Event      = CurrentEvent;
+        Entry->ProcessId  = CurrentEvent->ProcessId;
+        Entry->ThreadId   = CurrentEvent->ThreadId;
+        Entry->IsWildcard = IsWildcard;
+        Entry->Key        = NULL;
+
+        if (!IsWildcard)
+        {
+            DebuggerEventsIndexGetEventKey(CurrentEvent, &Entry->Key);
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Rebuild the snapshot of the current core from the lookup index
+ * @details should only be called by the owner core, it doesn't allocate
+ * memory so it can be called from vmx-root mode
+ *
+ * @param Snapshot The snapshot of the current core
+ * @param CoreId The owner core of the snapshot
+ * @param Generation The generation that the snapshot is built from
+ *
+ * @return BOOLEAN FALSE if the lookup index is being modified
+ */
+static BOOLEAN
+DebuggerArmedEventsRebuild(PDEBUGGER_ARMED_EVENTS_SNAPSHOT Snapshot, UINT32 CoreId, LONG64 Generation)
+{
+    PDEBUGGER_EVENTS_INDEX_TABLE Table    = NULL;
+    BOOLEAN                      Overflow = FALSE;
+
+    //
+    // We cannot wait for the lock here, the modifier of the index might
+    // be running on the same core (in vmx non-root), so the currently
+    // built snapshot is used and it's rebuilt on the next dispatch
+    //
+    if (!SpinlockTryLock(&g_EventsIndexLock))
+    {
+        return FALSE;
+    }
+
+    Snapshot->EntriesCount = 0;
+
+    for (UINT32 Type = 0; Type < DEBUGGER_EVENTS_INDEX_EVENT_TYPES_COUNT && !Overflow; Type++)
+    {
+        Table                     = &g_EventsIndex->Tables[Type];
+        Snapshot->TypeStart[Type] = Snapshot->EntriesCount;
+
+        for (UINT32 i = 0; i < DEBUGGER_EVENTS_INDEX_BUCKETS_COUNT; i++)
+        {
+            if (!DebuggerArmedEventsAddList(Snapshot, &Table->BucketsHead[i], CoreId, FALSE))
+            {
+                Overflow = TRUE;
+                break;
+            }
+        }
+
+        DebuggerArmedEventsSortByKey(&Snapshot->Entries[Snapshot->TypeStart[Type]],
+                                     Snapshot->EntriesCount - Snapshot->TypeStart[Type]);
+
+        Snapshot->WildcardStart[Type] = Snapshot->EntriesCount;
+
+        if (!Overflow && !DebuggerArmedEventsAddList(Snapshot, &Table->WildcardEventsHead, CoreId, TRUE))
+        {
+            Overflow = TRUE;
+        }
+    }
+
+    Snapshot->TypeStart[DEBUGGER_EVENTS_INDEX_EVENT_TYPES_COUNT] = Snapshot->EntriesCount;
+
+    Snapshot->Overflowed = Overflow;
+    Snapshot->Generation = Generation;
+
+    SpinlockUnlock(&g_EventsIndexLock);
+
+    return TRUE;
+}
+
+/**
+ * @brief Start dispatching events on the current core
+ * @details It should be paired with DebuggerArmedEventsExitDispatch
+ *
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return PDEBUGGER_ARMED_EVENTS_SNAPSHOT The snapshot to dispatch
+ * the events from, or NULL if the lookup index should be used instead
+ */
+PDEBUGGER_ARMED_EVENTS_SNAPSHOT
+DebuggerArmedEventsEnterDispatch(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    PDEBUGGER_ARMED_EVENTS_SNAPSHOT Snapshot = DbgState->ArmedEventsSnapshot;
+    LONG                            Depth;
+    LONG64                          Generation;
+
+    if (Snapshot == NULL)
+    {
+        return NULL;
+    }
+
+    //
+    // The interlocked operation is a full barrier, so the generation is read
+    // after the dispatching state of this core becomes visible to the others
+    //
+    Depth      = InterlockedIncrement(&Snapshot->DispatchDepth);
+    Generation = g_ArmedEventsGeneration;
+
+    if (Snapshot->Generation != Generation)
+    {
+        //
+        // The snapshot is only rebuilt if it's not used by an outer dispatch,
+        // if the lookup index is being modified, the current snapshot might
+        // refer to the removed events so it's not used
+        //
+        if (Depth != 1 || !DebuggerArmedEventsRebuild(Snapshot, DbgState->CoreId, Generation))
+        {
+            return NULL;
+        }
+    }
+
+    if (Snapshot->Overflowed)
+    {
+        //
+        // There are too many armed events
+        //
+        return NULL;
+    }
+
+    return Snapshot;
+}
+
+/**
+ * @brief Finish dispatching events on the current core
+ *
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return VOID
+ */
+VOID
+DebuggerArmedEventsExitDispatch(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    if (DbgState->ArmedEventsSnapshot != NULL)
+    {
+        InterlockedDecrement(&DbgState->ArmedEventsSnapshot->DispatchDepth);
+    }
+}
+
+/**
+ * @brief Get the range of entries in the snapshot that might be matched
+ * with a triggered event
+ *
+ * @param Snapshot The snapshot of the current core
+ * @param EventType The type of the triggered event
+ * @param Context The context of the triggered event
+ * @param KeyedStart The first entry with the same discriminator
+ * @param KeyedEnd The end of entries with the same discriminator
+ * @param WildcardStart The first entry without discriminator
+ * @param WildcardEnd The end of entries without discriminator
+ *
+ * @return BOOLEAN FALSE if the event type is invalid
+ */
+BOOLEAN
+DebuggerArmedEventsGetCandidates(PDEBUGGER_ARMED_EVENTS_SNAPSHOT Snapshot,
+                                 VMM_EVENT_TYPE_ENUM             EventType,
+                                 PVOID                           Context,
+                                 UINT32 *                        KeyedStart,
+                                 UINT32 *                        KeyedEnd,
+                                 UINT32 *                        WildcardStart,
+                                 UINT32 *                        WildcardEnd)
+{
+    UINT64 Key;
+    UINT32 Low;
+    UINT32 High;
+    UINT32 Middle;
+
+    if (EventType >= DEBUGGER_EVENTS_INDEX_EVENT_TYPES_COUNT)
+    {
+        return FALSE;
+    }
+
+    *WildcardStart = Snapshot->WildcardStart[EventType];
+    *WildcardEnd   = Snapshot->TypeStart[EventType + 1];
+
+    *KeyedStart = *KeyedEnd = Snapshot->TypeStart[EventType];
+
+    if (!DebuggerEventsIndexGetContextKey(EventType, Context, &Key))
+    {
+        return TRUE;
+    }
+
+    //
+    // Binary search for the first entry with the same key
+    //
+    Low  = Snapshot->TypeStart[EventType];
+    High = Snapshot->WildcardStart[EventType];
+
+    while (Low < High)
+    {
+        Middle = Low + (High - Low) / 2;
+
+        if (Snapshot->Entries[Middle].Key < Key)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    *KeyedStart = Low;
+
+    while (Low < Snapshot->WildcardStart[EventType] && Snapshot->Entries[Low].Key == Key)
+    {
+        Low++;
+    }
+
+    *KeyedEnd = Low;
+
+    return TRUE;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file DebuggerEventRecords.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The per-core records of the hits of events
+ * @details the record action appends a fixed-format record (the event,
+ * the core, the process, the thread, RIP and a few registers or memory
+ * reads) to the buffer of the current core, so the hits are recorded
+ * without formatting messages or running the script engine, and the
+ * user mode takes the records of all cores in bulk
+ *
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Allocate the buffers of the records
+ * @details should be called from vmx non-root (PASSIVE_LEVEL), the
+ * buffers are allocated once and kept until the debugger is uninitialized
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+DebuggerEventRecordsInitialize()
+{
+    SIZE_T                         BufferSize = sizeof(DEBUGGER_EVENT_RECORDS_BUFFER) * KeQueryActiveProcessorCount(0);
+    PDEBUGGER_EVENT_RECORDS_BUFFER Buffers;
+
+    if (g_DebuggerEventRecordsBuffers != NULL)
+    {
+        return TRUE;
+    }
+
+    //
+    // It's not possible to allocate the buffers in vmx root-mode
+    //
+    if (VmFuncVmxGetCurrentExecutionMode() == TRUE)
+    {
+        return FALSE;
+    }
+
+    Buffers = ExAllocatePoolWithTag(NonPagedPoolCacheAligned, BufferSize, POOLTAG);
+
+    if (Buffers == NULL)
+    {
+        return FALSE;
+    }
+
+    RtlZeroMemory(Buffers, BufferSize);
+
+    g_DebuggerEventRecordsBuffers = Buffers;
+
+    return TRUE;
+}
+
+/**
+ * @brief Free the buffers of the records
+ * @details should be called after all of the events are removed
+ *
+ * @return VOID
+ */
+VOID
+DebuggerEventRecordsUninitialize()
+{
+    if (g_DebuggerEventRecordsBuffers != NULL)
+    {
+        ExFreePoolWithTag(g_DebuggerEventRecordsBuffers, POOLTAG);
+        g_DebuggerEventRecordsBuffers = NULL;
+    }
+}
+
+/**
+ * @brief Manage the recording the hits action
+ * @details the record is dropped if the buffer of the core is full
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param Tag Tag of event
+ * @param Action Action object
+ *
+ * @return VOID
+ */
+VOID
+DebuggerEventRecordsRecordHit(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 Tag, PDEBUGGER_EVENT_ACTION Action)
+{
+    PDEBUGGER_EVENT_RECORDS_BUFFER Buffer = &g_DebuggerEventRecordsBuffers[DbgState->CoreId];
+    PDEBUGGER_EVENT_HIT_RECORD     Record;
+    PDEBUGGER_EVENT_RECORD_VALUE   Value;
+    LONG64                         WriteIndex = Buffer->WriteIndex;
+    UINT64                         Address;
+
+    if (WriteIndex - Buffer->ReadIndex >= DEBUGGER_EVENT_RECORDS_BUFFER_CAPACITY)
+    {
+        InterlockedIncrement64(&Buffer->DroppedRecords);
+        return;
+    }
+
+    Record = &Buffer->Records[WriteIndex & (DEBUGGER_EVENT_RECORDS_BUFFER_CAPACITY - 1)];
+
+    Record->Tag         = Tag;
+    Record->Tsc         = LogReadTimestamp();
+    Record->Rip         = DebuggerGetRegValueWrapper(DbgState->Regs, REGISTER_RIP);
+    Record->CoreId      = DbgState->CoreId;
+    Record->ProcessId   = HandleToUlong(PsGetCurrentProcessId());
+    Record->ThreadId    = HandleToUlong(PsGetCurrentThreadId());
+    Record->ValidValues = 0;
+
+    for (UINT32 i = 0; i < Action->RecordConfiguration.CountOfValues; i++)
+    {
+        Value = &Action->RecordConfiguration.Values[i];
+
+        Record->Values[i] = DebuggerGetRegValueWrapper(DbgState->Regs, Value->Register);
+
+        if (Value->IsMemory)
+        {
+            Address           = Record->Values[i] + Value->Offset;
+            Record->Values[i] = 0;
+
+            if (!CheckAccessValidityAndSafety(Address, sizeof(UINT64)))
+            {
+                continue;
+            }
+
+            MemoryMapperReadMemorySafeOnTargetProcess(Address, &Record->Values[i], sizeof(UINT64));
+        }
+
+        Record->ValidValues |= (1 << i);
+    }
+
+    //
+    // The record is visible to the readers once the index is changed
+    //
+    InterlockedExchange64(&Buffer->WriteIndex, WriteIndex + 1);
+}
+
+/**
+ * @brief Move the records of the buffers of the cores to the request
+ * @details should be called from vmx non-root, the records are removed
+ * from the buffers, so each record is only queried once
+ *
+ * @param RecordsRequest
+ *
+ * @return VOID
+ */
+VOID
+DebuggerEventRecordsQuery(PDEBUGGER_QUERY_EVENT_RECORDS RecordsRequest)
+{
+    ULONG  CoreCount = KeQueryActiveProcessorCount(0);
+    UINT32 Count     = 0;
+
+    RecordsRequest->DroppedRecords = 0;
+    RecordsRequest->KernelStatus   = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    if (g_DebuggerEventRecordsBuffers == NULL)
+    {
+        //
+        // No hit is ever recorded
+        //
+        RecordsRequest->CountOfRecords = 0;
+        return;
+    }
+
+    SpinlockLock(&g_DebuggerEventRecordsLock);
+
+    for (UINT32 i = 0; i < CoreCount; i++)
+    {
+        PDEBUGGER_EVENT_RECORDS_BUFFER Buffer     = &g_DebuggerEventRecordsBuffers[i];
+        LONG64                         ReadIndex  = Buffer->ReadIndex;
+        LONG64                         WriteIndex = InterlockedCompareExchange64(&Buffer->WriteIndex, 0, 0);
+
+        while (ReadIndex != WriteIndex && Count < MaximumEventRecordsToQuery)
+        {
+            RecordsRequest->Records[Count] = Buffer->Records[ReadIndex & (DEBUGGER_EVENT_RECORDS_BUFFER_CAPACITY - 1)];
+
+            ReadIndex++;
+            Count++;
+        }
+
+        //
+        // The slots are reusable by the core once the index is changed
+        //
+        InterlockedExchange64(&Buffer->ReadIndex, ReadIndex);
+
+        RecordsRequest->DroppedRecords += InterlockedExchange64(&Buffer->DroppedRecords, 0);
+    }
+
+    SpinlockUnlock(&g_DebuggerEventRecordsLock);
+
+    RecordsRequest->CountOfRecords = Count;
+}
@@ -34,6 +34,102 @@ DebuggerEventDisableEferOnAllProcessors()
     ConfigureDisableEferSyscallEventsOnAllProcessors();
 }
 
+/**
+ * @brief routines for !syscall command (disable syscall hook on the
+ * target cores)
+ * @param CoreMask The mask of target cores (DEBUGGER_BROADCASTING_ALL_CORES_MASK
+ * for all cores)
+ *
+ * @return VOID
+ */
+VOID
+DebuggerEventDisableEferOnCores(UINT64 CoreMask)
+{
+    BroadcastDisableEferSyscallEventsOnCores(CoreMask);
+}
+
+/**
+ * @brief routines for !syscall command (update the filter of syscall
+ * numbers)
+ * @details the filter is built from the syscall numbers of the syscall
+ * events, if any event is for all syscalls (or a syscall number that is
+ * not covered by the filter) then the filter is deactivated
+ *
+ * @param TerminatedEventTag Tag of the event that is terminated (it's
+ * still in the list), or zero
+ *
+ * @return VOID
+ */
+VOID
+DebuggerEventUpdateSyscallFilter(UINT64 TerminatedEventTag)
+{
+    UINT64  Bitmap[DEBUGGER_EVENT_SYSCALL_FILTER_MAXIMUM_NUMBER / 64] = {0};
+    BOOLEAN IsActive                                                  = FALSE;
+
+    LIST_FOR_EACH_LINK(g_Events->SyscallHooksEferSyscallEventsHead, DEBUGGER_EVENT, EventsOfSameTypeList, CurrentEvent)
+    {
+        if (CurrentEvent->Tag == TerminatedEventTag)
+        {
+            continue;
+        }
+
+        if (CurrentEvent->OptionalParam1 >= DEBUGGER_EVENT_SYSCALL_FILTER_MAXIMUM_NUMBER)
+        {
+            //
+            // All syscalls (or an uncovered syscall) should be dispatched
+            //
+            IsActive = FALSE;
+            break;
+        }
+
+        Bitmap[CurrentEvent->OptionalParam1 / 64] |= 1ull << (CurrentEvent->OptionalParam1 % 64);
+        IsActive = TRUE;
+    }
+
+    ConfigureSetSyscallHookFilter(Bitmap, IsActive);
+}
+
+/**
+ * @brief routines for !cpuid command (update the filter of CPUID leaves)
+ * @details the filter is built from the leaves of the CPUID events, if
+ * any event is for all leaves (or there are too many leaves) then the
+ * filter is deactivated
+ *
+ * @param TerminatedEventTag Tag of the event that is terminated (it's
+ * still in the list), or zero
+ *
+ * @return VOID
+ */
+VOID
+DebuggerEventUpdateCpuidFilter(UINT64 TerminatedEventTag)
+{
+    UINT32  Leaves[DEBUGGER_EVENT_CPUID_FILTER_MAXIMUM_LEAVES] = {0};
+    UINT32  LeavesCount                                        = 0;
+    BOOLEAN IsActive                                           = FALSE;
+
+    LIST_FOR_EACH_LINK(g_Events->CpuidInstructionExecutionEventsHead, DEBUGGER_EVENT, EventsOfSameTypeList, CurrentEvent)
+    {
+        if (CurrentEvent->Tag == TerminatedEventTag)
+        {
+            continue;
+        }
+
+        if (CurrentEvent->OptionalParam1 == FALSE || LeavesCount == DEBUGGER_EVENT_CPUID_FILTER_MAXIMUM_LEAVES)
+        {
+            //
+            // All leaves (or too many leaves) should be dispatched
+            //
+            IsActive = FALSE;
+            break;
+        }
+
+        Leaves[LeavesCount++] = (UINT32)CurrentEvent->OptionalParam2;
+        IsActive              = TRUE;
+    }
+
+    ConfigureSetCpuidEventFilter(Leaves, LeavesCount, IsActive);
+}
+
 /**
  * @brief routines for debugging threads (enable mov-to-cr3 exiting)
  *
@@ -65,6 +161,8 @@ DebuggerEventDisableMovToCr3ExitingOnAllProcessors()
  * @param EnableForRead
  * @param EnableForWrite
  * @param EnableForExecute
+ * @param ApplyOnLargePage Monitor the whole 2MB page that starts at the address
+ * (without splitting it)
  *
  * @return VOID
  */
@@ -73,7 +171,8 @@ DebuggerEventEnableMonitorReadWriteExec(UINT64  Address,
                                         UINT32  ProcessId,
                                         BOOLEAN EnableForRead,
                                         BOOLEAN EnableForWrite,
-                                        BOOLEAN EnableForExecute)
+                                        BOOLEAN EnableForExecute,
+                                        BOOLEAN ApplyOnLargePage)
 {
     //
     // Check if the detail is ok for either read or write or both
@@ -96,6 +195,11 @@ DebuggerEventEnableMonitorReadWriteExec(UINT64  Address,
     //
     // Perform the EPT Hook
     //
+    if (ApplyOnLargePage)
+    {
+        return ConfigureEptHookMonitorLargePage(Address, ProcessId, EnableForRead, EnableForWrite, EnableForExecute);
+    }
+
     return ConfigureEptHook2(Address, NULL, ProcessId, EnableForRead, EnableForWrite, EnableForExecute, FALSE);
 }
 
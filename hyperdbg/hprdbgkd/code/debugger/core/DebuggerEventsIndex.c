@@ -0,0 +1,324 @@
+/**
+ * @file DebuggerEventsIndex.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Implementation of the lookup index of debugger events
+ * @details The index is used in DebuggerTriggerEvents to only
+ * touch the events that can actually match the current context
+ * instead of walking the whole list of events of a same type
+ *
+ * @version 0.4
+ * @date 2023-07-08
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Initialize the list heads of the events index
+ *
+ * @return VOID
+ */
+VOID
+DebuggerEventsIndexInitialize()
+{
+    for (UINT32 i = 0; i < DEBUGGER_EVENTS_INDEX_EVENT_TYPES_COUNT; i++)
+    {
+        InitializeListHead(&g_EventsIndex->Tables[i].WildcardEventsHead);
+
+        for (UINT32 j = 0; j < DEBUGGER_EVENTS_INDEX_BUCKETS_COUNT; j++)
+        {
+            InitializeListHead(&g_EventsIndex->Tables[i].BucketsHead[j]);
+        }
+    }
+}
+
+/**
+ * @brief Compute the bucket index of a discriminator key
+ *
+ * @param Key The discriminator key
+ * @return UINT32 Index of the bucket
+ */
+static UINT32
+DebuggerEventsIndexHashKey(UINT64 Key)
+{
+    //
+    // Fibonacci hashing, the buckets count is a power of two
+    //
+    return (UINT32)((Key * 0x9E3779B97F4A7C15ull) >> 32) & (DEBUGGER_EVENTS_INDEX_BUCKETS_COUNT - 1);
+}
+
+/**
+ * @brief Get the discriminator key of an event
+ *
+ * @param Event The event object
+ * @param Key The discriminator key (if any)
+ *
+ * @return BOOLEAN TRUE if the event has a discriminator and FALSE
+ * if the event should be matched with any context (wildcard)
+ */
+BOOLEAN
+DebuggerEventsIndexGetEventKey(PDEBUGGER_EVENT Event, UINT64 * Key)
+{
+    switch (Event->EventType)
+    {
+    case EXTERNAL_INTERRUPT_OCCURRED:
+    case HIDDEN_HOOK_EXEC_CC:
+    case HIDDEN_HOOK_EXEC_DETOURS:
+    case CONTROL_REGISTER_MODIFIED:
+
+        //
+        // Vector, virtual address, physical address or the control register
+        //
+        *Key = Event->OptionalParam1;
+        return TRUE;
+
+    case HIDDEN_HOOK_READ_AND_WRITE_AND_EXECUTE:
+    case HIDDEN_HOOK_READ_AND_WRITE:
+    case HIDDEN_HOOK_READ_AND_EXECUTE:
+    case HIDDEN_HOOK_WRITE_AND_EXECUTE:
+    case HIDDEN_HOOK_READ:
+    case HIDDEN_HOOK_WRITE:
+    case HIDDEN_HOOK_EXECUTE:
+
+        //
+        // The range is [OptionalParam1, OptionalParam2) in physical address,
+        // if it's located on a single page, the physical page is the key,
+        // otherwise, it's treated as a wildcard event (also the multi-range
+        // events and the events with slots are treated as wildcard events)
+        //
+        if (Event->MonitorRanges != NULL ||
+            Event->MonitorSlots != NULL ||
+            Event->OptionalParam2 <= Event->OptionalParam1 ||
+            (Event->OptionalParam1 >> PAGE_SHIFT) != ((Event->OptionalParam2 - 1) >> PAGE_SHIFT))
+        {
+            return FALSE;
+        }
+
+        *Key = Event->OptionalParam1 >> PAGE_SHIFT;
+        return TRUE;
+
+    case RDMSR_INSTRUCTION_EXECUTION:
+    case WRMSR_INSTRUCTION_EXECUTION:
+
+        if (Event->OptionalParam1 == DEBUGGER_EVENT_MSR_READ_OR_WRITE_ALL_MSRS)
+        {
+            return FALSE;
+        }
+
+        *Key = Event->OptionalParam1;
+        return TRUE;
+
+    case EXCEPTION_OCCURRED:
+
+        if (Event->OptionalParam1 == DEBUGGER_EVENT_EXCEPTIONS_ALL_FIRST_32_ENTRIES)
+        {
+            return FALSE;
+        }
+
+        *Key = Event->OptionalParam1;
+        return TRUE;
+
+    case IN_INSTRUCTION_EXECUTION:
+    case OUT_INSTRUCTION_EXECUTION:
+
+        if (Event->OptionalParam1 == DEBUGGER_EVENT_ALL_IO_PORTS)
+        {
+            return FALSE;
+        }
+
+        *Key = Event->OptionalParam1;
+        return TRUE;
+
+    case SYSCALL_HOOK_EFER_SYSCALL:
+
+        if (Event->OptionalParam1 == DEBUGGER_EVENT_SYSCALL_ALL_SYSRET_OR_SYSCALLS)
+        {
+            return FALSE;
+        }
+
+        *Key = Event->OptionalParam1;
+        return TRUE;
+
+    case CPUID_INSTRUCTION_EXECUTION:
+
+        //
+        // OptionalParam1 shows whether a special CPUID leaf (OptionalParam2)
+        // is intended or not
+        //
+        if (Event->OptionalParam1 == NULL /* FALSE */)
+        {
+            return FALSE;
+        }
+
+        *Key = Event->OptionalParam2;
+        return TRUE;
+
+    default:
+
+        //
+        // Other events don't have a discriminator
+        //
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Get the discriminator key of the context of a triggered event
+ *
+ * @param EventType The type of the triggered event
+ * @param Context The context of the triggered event
+ * @param Key The discriminator key (if any)
+ *
+ * @return BOOLEAN TRUE if the context has a discriminator
+ */
+BOOLEAN
+DebuggerEventsIndexGetContextKey(VMM_EVENT_TYPE_ENUM EventType, PVOID Context, UINT64 * Key)
+{
+    switch (EventType)
+    {
+    case EXTERNAL_INTERRUPT_OCCURRED:
+    case HIDDEN_HOOK_EXEC_CC:
+    case CONTROL_REGISTER_MODIFIED:
+    case RDMSR_INSTRUCTION_EXECUTION:
+    case WRMSR_INSTRUCTION_EXECUTION:
+    case EXCEPTION_OCCURRED:
+    case IN_INSTRUCTION_EXECUTION:
+    case OUT_INSTRUCTION_EXECUTION:
+    case SYSCALL_HOOK_EFER_SYSCALL:
+    case CPUID_INSTRUCTION_EXECUTION:
+
+        *Key = (UINT64)Context;
+        return TRUE;
+
+    case HIDDEN_HOOK_EXEC_DETOURS:
+
+        *Key = ((PEPT_HOOKS_CONTEXT)Context)->PhysicalAddress;
+        return TRUE;
+
+    case HIDDEN_HOOK_READ_AND_WRITE_AND_EXECUTE:
+    case HIDDEN_HOOK_READ_AND_WRITE:
+    case HIDDEN_HOOK_READ_AND_EXECUTE:
+    case HIDDEN_HOOK_WRITE_AND_EXECUTE:
+    case HIDDEN_HOOK_READ:
+    case HIDDEN_HOOK_WRITE:
+    case HIDDEN_HOOK_EXECUTE:
+
+        *Key = ((PEPT_HOOKS_CONTEXT)Context)->PhysicalAddress >> PAGE_SHIFT;
+        return TRUE;
+
+    default:
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Add an event to the events index
+ * @details should not be called from vmx-root mode
+ *
+ * @param Event The event object
+ * @return VOID
+ */
+VOID
+DebuggerEventsIndexInsertEvent(PDEBUGGER_EVENT Event)
+{
+    UINT64                       Key   = NULL;
+    PDEBUGGER_EVENTS_INDEX_TABLE Table = NULL;
+
+    if (Event->EventType >= DEBUGGER_EVENTS_INDEX_EVENT_TYPES_COUNT)
+    {
+        //
+        // Invalid event type, keep the list entry valid for later removal
+        //
+        InitializeListHead(&Event->EventsOfSameIndexList);
+        return;
+    }
+
+    Table = &g_EventsIndex->Tables[Event->EventType];
+
+    SpinlockLockNamed(&g_EventsIndexLock, "kd: events index (insert)");
+
+    if (DebuggerEventsIndexGetEventKey(Event, &Key))
+    {
+        InsertHeadList(&Table->BucketsHead[DebuggerEventsIndexHashKey(Key)], &Event->EventsOfSameIndexList);
+    }
+    else
+    {
+        InsertHeadList(&Table->WildcardEventsHead, &Event->EventsOfSameIndexList);
+    }
+
+    SpinlockUnlock(&g_EventsIndexLock);
+}
+
+/**
+ * @brief Remove an event from the events index
+ * @details should not be called from vmx-root mode
+ *
+ * @param Event The event object
+ * @return VOID
+ */
+VOID
+DebuggerEventsIndexRemoveEvent(PDEBUGGER_EVENT Event)
+{
+    SpinlockLockNamed(&g_EventsIndexLock, "kd: events index (remove)");
+
+    RemoveEntryList(&Event->EventsOfSameIndexList);
+
+    SpinlockUnlock(&g_EventsIndexLock);
+}
+
+/**
+ * @brief Re-index an event after its discriminator is changed
+ * @details the optional parameters of the events are changed (e.g.,
+ * converted to physical addresses) after the event is registered, so
+ * it should be called once the event is applied
+ *
+ * @param Event The event object
+ * @return VOID
+ */
+VOID
+DebuggerEventsIndexUpdateEvent(PDEBUGGER_EVENT Event)
+{
+    DebuggerEventsIndexRemoveEvent(Event);
+    DebuggerEventsIndexInsertEvent(Event);
+}
+
+/**
+ * @brief Get the lists of events that might be matched with a triggered event
+ *
+ * @param EventType The type of the triggered event
+ * @param Context The context of the triggered event
+ * @param BucketListHead The list of events with the same discriminator (NULL if no discriminator)
+ * @param WildcardListHead The list of events without discriminator
+ *
+ * @return BOOLEAN FALSE if the event type is invalid
+ */
+BOOLEAN
+DebuggerEventsIndexGetCandidateLists(VMM_EVENT_TYPE_ENUM EventType,
+                                     PVOID               Context,
+                                     PLIST_ENTRY *       BucketListHead,
+                                     PLIST_ENTRY *       WildcardListHead)
+{
+    UINT64                       Key   = NULL;
+    PDEBUGGER_EVENTS_INDEX_TABLE Table = NULL;
+
+    if (EventType >= DEBUGGER_EVENTS_INDEX_EVENT_TYPES_COUNT)
+    {
+        return FALSE;
+    }
+
+    Table = &g_EventsIndex->Tables[EventType];
+
+    *WildcardListHead = &Table->WildcardEventsHead;
+
+    if (DebuggerEventsIndexGetContextKey(EventType, Context, &Key))
+    {
+        *BucketListHead = &Table->BucketsHead[DebuggerEventsIndexHashKey(Key)];
+    }
+    else
+    {
+        *BucketListHead = NULL;
+    }
+
+    return TRUE;
+}
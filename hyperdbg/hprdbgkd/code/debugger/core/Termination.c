@@ -13,82 +13,143 @@
 #include "pch.h"
 
 /**
- * @brief Termination function for external-interrupts
+ * @brief Check whether the event is an interrupt event that is intercepted
+ * at the entry of the IDT (!interrupt2) or not
  *
  * @param Event Target Event Object
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TerminateIsIdtEntryInterruptEvent(PDEBUGGER_EVENT Event)
+{
+    return Event->EventType == EXTERNAL_INTERRUPT_OCCURRED &&
+           Event->OptionalParam2 == DEBUGGER_EVENT_INTERRUPT_IDT_ENTRY_HOOK;
+}
+
+/**
+ * @brief Clear a per-core resource of the events on the target cores
+ * @details if the clears are deferred (terminating all events), the
+ * cores are only gathered and the resource is cleared once for all of
+ * the events
+ *
+ * @param Resource The target resource
+ * @param CoreMask The mask of the cores that the resource is not
+ * referenced on them anymore
  * @return VOID
  */
 VOID
-TerminateExternalInterruptEvent(PDEBUGGER_EVENT Event)
+TerminateClearResourceOnCores(DEBUGGER_EVENT_RESOURCE_TYPE Resource, UINT64 CoreMask)
 {
-    PLIST_ENTRY TempList = 0;
+    if (CoreMask == 0)
+    {
+        return;
+    }
 
-    if (DebuggerEventListCount(&g_Events->ExternalInterruptOccurredEventsHead) > 1)
+    if (g_TerminateDeferredClears.IsDeferring)
     {
-        //
-        // There are still other events in the queue (list), we should only remove
-        // this special event (not all events)
-        //
+        g_TerminateDeferredClears.CoreMasks[Resource] |= CoreMask;
+        return;
+    }
 
-        //
-        // For this purpose, first we disable all the events by
-        // disabling all of them
-        //
-        ExtensionCommandUnsetExternalInterruptExitingOnlyOnClearingInterruptEventsAllCores();
+    switch (Resource)
+    {
+    case DEBUGGER_EVENT_RESOURCE_EXTERNAL_INTERRUPT_EXITING:
+
+        ExtensionCommandUnsetExternalInterruptExitingOnlyOnClearingInterruptEventsOnCores(CoreMask);
+        break;
+
+    case DEBUGGER_EVENT_RESOURCE_RDTSC_EXITING:
+
+        ExtensionCommandDisableRdtscExitingForClearingEventsOnCores(CoreMask);
 
         //
-        // Then we iterate through the list of this event to re-apply
-        // the previous events
+        // No longer trigger events related to the rdtsc/rdtscp (so they
+        // can be handled in the fast-path of vm-exits)
         //
-        TempList = &g_Events->ExternalInterruptOccurredEventsHead;
-
-        while (&g_Events->ExternalInterruptOccurredEventsHead != TempList->Flink)
+        if (!DebuggerIsEventResourceReferenced(DEBUGGER_EVENT_RESOURCE_RDTSC_EXITING))
         {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
-
-            //
-            // We have to check because we don't want to re-apply
-            // the terminated event
-            //
-            if (CurrentEvent->Tag != Event->Tag)
-            {
-                //
-                // re-apply the event
-                //
-
-                //
-                // Let's see if it is for all cores or just one core
-                //
-                if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-                {
-                    //
-                    // All cores
-                    //
-                    ExtensionCommandSetExternalInterruptExitingAllCores();
-                }
-                else
-                {
-                    //
-                    // Just one core
-                    //
-                    ConfigureSetExternalInterruptExitingOnSingleCore(CurrentEvent->CoreId);
-                }
-            }
+            VmFuncSetTriggerEventForTscs(FALSE);
         }
+
+        break;
+
+    case DEBUGGER_EVENT_RESOURCE_RDPMC_EXITING:
+
+        ExtensionCommandDisableRdpmcExitingOnCores(CoreMask);
+        break;
+
+    case DEBUGGER_EVENT_RESOURCE_EFER_SYSCALL_HOOK:
+
+        DebuggerEventDisableEferOnCores(CoreMask);
+        break;
+
+    default:
+        break;
     }
-    else
+}
+
+/**
+ * @brief Start deferring the clears of the per-core resources of the
+ * terminated events
+ * @details used once a lot of events are terminated together, so each
+ * resource is cleared by a single broadcast
+ *
+ * @return VOID
+ */
+VOID
+TerminateStartDeferringClears()
+{
+    RtlZeroMemory(&g_TerminateDeferredClears, sizeof(TERMINATE_DEFERRED_CLEARS));
+
+    g_TerminateDeferredClears.IsDeferring = TRUE;
+}
+
+/**
+ * @brief Clear the per-core resources that are deferred since calling
+ * TerminateStartDeferringClears
+ *
+ * @return VOID
+ */
+VOID
+TerminateFlushDeferredClears()
+{
+    g_TerminateDeferredClears.IsDeferring = FALSE;
+
+    for (UINT32 i = 0; i < DEBUGGER_EVENT_RESOURCE_COUNT; i++)
     {
-        //
-        // Nothing else is in the list, we have to restore everything to default
-        // as the current event is the only event in the list
-        //
+        TerminateClearResourceOnCores((DEBUGGER_EVENT_RESOURCE_TYPE)i, g_TerminateDeferredClears.CoreMasks[i]);
+    }
+}
 
-        //
-        // Broadcast to disable on all cores
-        //
-        ExtensionCommandUnsetExternalInterruptExitingOnlyOnClearingInterruptEventsAllCores();
+/**
+ * @brief Termination function for external-interrupts
+ *
+ * @param Event Target Event Object
+ * @return VOID
+ */
+VOID
+TerminateExternalInterruptEvent(PDEBUGGER_EVENT Event)
+{
+    DEBUGGER_EVENT_RESOURCE_TYPE Resource;
+    UINT64                       CoreMask;
+
+    //
+    // The hook of the entry of the vector in the IDT (!interrupt2) is shared
+    // by its events, it doesn't affect the external-interrupt exiting
+    //
+    if (TerminateIsIdtEntryInterruptEvent(Event))
+    {
+        ConfigureDisableIdtEntryInterruptHook((UINT32)Event->OptionalParam1);
+        return;
     }
+
+    //
+    // The external-interrupt exiting is reference counted on each core, so
+    // it's only unset on the cores that no other event needs it on them
+    //
+    CoreMask = DebuggerReleaseEventResource(Event, &Resource);
+
+    TerminateClearResourceOnCores(Resource, CoreMask);
 }
 
 /**
@@ -102,6 +163,8 @@ TerminateHiddenHookReadAndWriteAndExecuteEvent(PDEBUGGER_EVENT Event)
 {
     UINT64 PagesBytes;
     UINT64 TempOptionalParam1;
+    UINT64 PageAddress;
+    UINT64 NextPage = 0;
 
     //
     // Because there are different EPT hooks, like READ, WRITE, READ WRITE,
@@ -113,6 +176,39 @@ TerminateHiddenHookReadAndWriteAndExecuteEvent(PDEBUGGER_EVENT Event)
     // then it won't cause any problem for other hooks
     //
 
+    //
+    // The ranges that are added by the scripts are closed before the
+    // other ranges, so no page is hooked for them after here
+    //
+    DebuggerCloseMonitorSlotsOfEvent(Event);
+
+    if (Event->MonitorRanges != NULL)
+    {
+        //
+        // The ranges are sorted, so the pages that are shared between the
+        // ranges are only shared with the previous range and they're unhooked
+        // once
+        //
+        for (UINT32 i = 0; i < Event->MonitorRanges->CountOfRanges; i++)
+        {
+            PageAddress = (UINT64)PAGE_ALIGN(Event->MonitorRanges->Ranges[i].StartAddress);
+
+            if (PageAddress < NextPage)
+            {
+                PageAddress = NextPage;
+            }
+
+            for (; PageAddress <= (UINT64)PAGE_ALIGN(Event->MonitorRanges->Ranges[i].EndAddress); PageAddress += PAGE_SIZE)
+            {
+                ConfigureEptHookUnHookSingleAddress(PageAddress, NULL, Event->ProcessId);
+            }
+
+            NextPage = PageAddress;
+        }
+
+        return;
+    }
+
     TempOptionalParam1 = Event->OptionalParam3;
 
     PagesBytes = PAGE_ALIGN(TempOptionalParam1);
@@ -187,73 +283,28 @@ TerminateHiddenHookExecDetoursEvent(PDEBUGGER_EVENT Event)
 VOID
 TerminateRdmsrExecutionEvent(PDEBUGGER_EVENT Event)
 {
-    PLIST_ENTRY TempList = 0;
+    //
+    // The bits of msr bitmap are reference counted, so only the reference
+    // of this event is released, the msrs that are used by other events
+    // remain as they are (and unrelated msrs are never set)
+    //
 
-    if (DebuggerEventListCount(&g_Events->RdmsrInstructionExecutionEventsHead) > 1)
+    //
+    // Let's see if it is for all cores or just one core
+    //
+    if (Event->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
     {
         //
-        // There are still other events in the queue (list), we should only remove
-        // this special event (not all events)
-        //
-
-        //
-        // For this purpose, first we disable all the events by
-        // disabling all of them
+        // All cores
         //
-        ExtensionCommandResetChangeAllMsrBitmapReadAllCores();
-
-        //
-        // Then we iterate through the list of this event to re-apply
-        // the previous events
-        //
-        TempList = &g_Events->RdmsrInstructionExecutionEventsHead;
-
-        while (&g_Events->RdmsrInstructionExecutionEventsHead != TempList->Flink)
-        {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
-
-            //
-            // We have to check because we don't want to re-apply
-            // the terminated event
-            //
-            if (CurrentEvent->Tag != Event->Tag)
-            {
-                //
-                // re-apply the event
-                //
-
-                //
-                // Let's see if it is for all cores or just one core
-                //
-                if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-                {
-                    //
-                    // All cores
-                    //
-                    ExtensionCommandChangeAllMsrBitmapReadAllCores(CurrentEvent->OptionalParam1);
-                }
-                else
-                {
-                    //
-                    // Just one core
-                    //
-                    ConfigureChangeMsrBitmapReadOnSingleCore(CurrentEvent->CoreId, CurrentEvent->OptionalParam1);
-                }
-            }
-        }
+        ExtensionCommandUnsetMsrBitmapReadAllCores(Event->OptionalParam1);
     }
     else
     {
         //
-        // Nothing else is in the list, we have to restore everything to default
-        // as the current event is the only event in the list
-        //
-
-        //
-        // Broadcast to reset msr bitmap on all cores
+        // Just one core
         //
-        ExtensionCommandResetChangeAllMsrBitmapReadAllCores();
+        ConfigureUnsetMsrBitmapReadOnSingleCore(Event->CoreId, Event->OptionalParam1);
     }
 }
 
@@ -266,73 +317,28 @@ TerminateRdmsrExecutionEvent(PDEBUGGER_EVENT Event)
 VOID
 TerminateWrmsrExecutionEvent(PDEBUGGER_EVENT Event)
 {
-    PLIST_ENTRY TempList = 0;
+    //
+    // The bits of msr bitmap are reference counted, so only the reference
+    // of this event is released, the msrs that are used by other events
+    // remain as they are (and unrelated msrs are never set)
+    //
 
-    if (DebuggerEventListCount(&g_Events->WrmsrInstructionExecutionEventsHead) > 1)
+    //
+    // Let's see if it is for all cores or just one core
+    //
+    if (Event->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
     {
         //
-        // There are still other events in the queue (list), we should only remove
-        // this special event (not all events)
-        //
-
+        // All cores
         //
-        // For this purpose, first we disable all the events by
-        // disabling all of them
-        //
-        ExtensionCommandResetAllMsrBitmapWriteAllCores();
-
-        //
-        // Then we iterate through the list of this event to re-apply
-        // the previous events
-        //
-        TempList = &g_Events->WrmsrInstructionExecutionEventsHead;
-
-        while (&g_Events->WrmsrInstructionExecutionEventsHead != TempList->Flink)
-        {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
-
-            //
-            // We have to check because we don't want to re-apply
-            // the terminated event
-            //
-            if (CurrentEvent->Tag != Event->Tag)
-            {
-                //
-                // re-apply the event
-                //
-
-                //
-                // Let's see if it is for all cores or just one core
-                //
-                if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-                {
-                    //
-                    // All cores
-                    //
-                    ExtensionCommandChangeAllMsrBitmapWriteAllCores(CurrentEvent->OptionalParam1);
-                }
-                else
-                {
-                    //
-                    // Just one core
-                    //
-                    ConfigureChangeMsrBitmapWriteOnSingleCore(CurrentEvent->CoreId, CurrentEvent->OptionalParam1);
-                }
-            }
-        }
+        ExtensionCommandUnsetMsrBitmapWriteAllCores(Event->OptionalParam1);
     }
     else
     {
         //
-        // Nothing else is in the list, we have to restore everything to default
-        // as the current event is the only event in the list
+        // Just one core
         //
-
-        //
-        // Broadcast to reset msr bitmap on all cores
-        //
-        ExtensionCommandResetAllMsrBitmapWriteAllCores();
+        ConfigureUnsetMsrBitmapWriteOnSingleCore(Event->CoreId, Event->OptionalParam1);
     }
 }
 
@@ -345,75 +351,16 @@ TerminateWrmsrExecutionEvent(PDEBUGGER_EVENT Event)
 VOID
 TerminateExceptionEvent(PDEBUGGER_EVENT Event)
 {
-    PLIST_ENTRY TempList = 0;
-
-    if (DebuggerEventListCount(&g_Events->ExceptionOccurredEventsHead) > 1)
-    {
-        //
-        // There are still other events in the queue (list), we should only remove
-        // this special event (not all events)
-        //
-
-        //
-        // For this purpose, first we disable all the events by
-        // disabling all of them
-        //
-        ExtensionCommandResetExceptionBitmapAllCores();
-
-        //
-        // Then we iterate through the list of this event to re-apply
-        // the previous events
-        //
-        TempList = &g_Events->ExceptionOccurredEventsHead;
-
-        while (&g_Events->ExceptionOccurredEventsHead != TempList->Flink)
-        {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
-
-            //
-            // We have to check because we don't want to re-apply
-            // the terminated event
-            //
-            if (CurrentEvent->Tag != Event->Tag)
-            {
-                //
-                // re-apply the event
-                //
-
-                //
-                // Let's see if it is for all cores or just one core
-                //
-
-                if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-                {
-                    //
-                    // All cores
-                    //
-                    ExtensionCommandSetExceptionBitmapAllCores(CurrentEvent->OptionalParam1);
-                }
-                else
-                {
-                    //
-                    // Just one core
-                    //
-                    ConfigureSetExceptionBitmapOnSingleCore(CurrentEvent->CoreId, CurrentEvent->OptionalParam1);
-                }
-            }
-        }
-    }
-    else
-    {
-        //
-        // Nothing else is in the list, we have to restore everything to default
-        // as the current event is the only event in the list
-        //
-
-        //
-        // Broadcast to reset exception bitmap on all cores
-        //
-        ExtensionCommandResetExceptionBitmapAllCores();
-    }
+    //
+    // The exception vectors are reference counted, so only the reference
+    // of this event is released, the vectors that are used by other events
+    // remain as they are
+    //
+    DebuggerChangeBitmapOwnership(Event->CoreId,
+                                  FALSE,
+                                  BITMAP_OWNERSHIP_RESOURCE_EXCEPTION,
+                                  Event->OptionalParam1,
+                                  0);
 }
 
 /**
@@ -425,81 +372,16 @@ TerminateExceptionEvent(PDEBUGGER_EVENT Event)
 VOID
 TerminateInInstructionExecutionEvent(PDEBUGGER_EVENT Event)
 {
-    PLIST_ENTRY TempList = 0;
-
     //
-    // For this event we should also check for out instructions events too
-    // because both of them are emulated by a single bit in vmx controls
-    // so if there is anything in out events list then we can remove all
-    // the events
+    // The i/o ports are reference counted (and shared between in and out
+    // events), so only the reference of this event is released, the ports
+    // that are used by other events remain as they are
     //
-    if (DebuggerEventListCount(&g_Events->InInstructionExecutionEventsHead) > 1 ||
-        DebuggerEventListCount(&g_Events->OutInstructionExecutionEventsHead) >= 1)
-    {
-        //
-        // There are still other events in the queue (list), we should only remove
-        // this special event (not all events)
-        //
-
-        //
-        // For this purpose, first we disable all the events by
-        // disabling all of them
-        //
-        ExtensionCommandIoBitmapResetAllCores();
-
-        //
-        // Then we iterate through the list of this event to re-apply
-        // the previous events
-        //
-        TempList = &g_Events->InInstructionExecutionEventsHead;
-
-        while (&g_Events->InInstructionExecutionEventsHead != TempList->Flink)
-        {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
-
-            //
-            // We have to check because we don't want to re-apply
-            // the terminated event
-            //
-            if (CurrentEvent->Tag != Event->Tag)
-            {
-                //
-                // re-apply the event
-                //
-
-                //
-                // Let's see if it is for all cores or just one core
-                //
-                if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-                {
-                    //
-                    // All cores
-                    //
-                    ExtensionCommandIoBitmapChangeAllCores(CurrentEvent->OptionalParam1);
-                }
-                else
-                {
-                    //
-                    // Just one core
-                    //
-                    ConfigureChangeIoBitmapOnSingleCore(CurrentEvent->CoreId, CurrentEvent->OptionalParam1);
-                }
-            }
-        }
-    }
-    else
-    {
-        //
-        // Nothing else is in the list, we have to restore everything to default
-        // as the current event is the only event in the list
-        //
-
-        //
-        // Broadcast to reset i/o bitmap on all cores
-        //
-        ExtensionCommandIoBitmapResetAllCores();
-    }
+    DebuggerChangeBitmapOwnership(Event->CoreId,
+                                  FALSE,
+                                  BITMAP_OWNERSHIP_RESOURCE_IO_PORT,
+                                  Event->OptionalParam1,
+                                  0);
 }
 
 /**
@@ -511,81 +393,16 @@ TerminateInInstructionExecutionEvent(PDEBUGGER_EVENT Event)
 VOID
 TerminateOutInstructionExecutionEvent(PDEBUGGER_EVENT Event)
 {
-    PLIST_ENTRY TempList = 0;
-
     //
-    // For this event we should also check for out instructions events too
-    // because both of them are emulated by a single bit in vmx controls
-    // so if there is anything in out events list then we can remove all
-    // the events
+    // The i/o ports are reference counted (and shared between in and out
+    // events), so only the reference of this event is released, the ports
+    // that are used by other events remain as they are
     //
-    if (DebuggerEventListCount(&g_Events->OutInstructionExecutionEventsHead) > 1 ||
-        DebuggerEventListCount(&g_Events->InInstructionExecutionEventsHead) >= 1)
-    {
-        //
-        // There are still other events in the queue (list), we should only remove
-        // this special event (not all events)
-        //
-
-        //
-        // For this purpose, first we disable all the events by
-        // disabling all of them
-        //
-        ExtensionCommandIoBitmapResetAllCores();
-
-        //
-        // Then we iterate through the list of this event to re-apply
-        // the previous events
-        //
-        TempList = &g_Events->OutInstructionExecutionEventsHead;
-
-        while (&g_Events->OutInstructionExecutionEventsHead != TempList->Flink)
-        {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
-
-            //
-            // We have to check because we don't want to re-apply
-            // the terminated event
-            //
-            if (CurrentEvent->Tag != Event->Tag)
-            {
-                //
-                // re-apply the event
-                //
-
-                //
-                // Let's see if it is for all cores or just one core
-                //
-                if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-                {
-                    //
-                    // All cores
-                    //
-                    ExtensionCommandIoBitmapChangeAllCores(CurrentEvent->OptionalParam1);
-                }
-                else
-                {
-                    //
-                    // Just one core
-                    //
-                    ConfigureChangeIoBitmapOnSingleCore(CurrentEvent->CoreId, CurrentEvent->OptionalParam1);
-                }
-            }
-        }
-    }
-    else
-    {
-        //
-        // Nothing else is in the list, we have to restore everything to default
-        // as the current event is the only event in the list
-        //
-
-        //
-        // Broadcast to reset i/o bitmap on all cores
-        //
-        ExtensionCommandIoBitmapResetAllCores();
-    }
+    DebuggerChangeBitmapOwnership(Event->CoreId,
+                                  FALSE,
+                                  BITMAP_OWNERSHIP_RESOURCE_IO_PORT,
+                                  Event->OptionalParam1,
+                                  0);
 }
 
 /**
@@ -635,6 +452,11 @@ TerminateVmcallExecutionEvent(PDEBUGGER_EVENT Event)
 VOID
 TerminateCpuidExecutionEvent(PDEBUGGER_EVENT Event)
 {
+    //
+    // The leaves of the other events are still filtered
+    //
+    DebuggerEventUpdateCpuidFilter(Event->Tag);
+
     if (DebuggerEventListCount(&g_Events->CpuidInstructionExecutionEventsHead) > 1)
     {
         //
@@ -673,74 +495,16 @@ TerminateCpuidExecutionEvent(PDEBUGGER_EVENT Event)
 VOID
 TerminateTscEvent(PDEBUGGER_EVENT Event)
 {
-    PLIST_ENTRY TempList = 0;
-
-    if (DebuggerEventListCount(&g_Events->TscInstructionExecutionEventsHead) > 1)
-    {
-        //
-        // There are still other events in the queue (list), we should only remove
-        // this special event (not all events)
-        //
+    DEBUGGER_EVENT_RESOURCE_TYPE Resource;
+    UINT64                       CoreMask;
 
-        //
-        // For this purpose, first we disable all the events by
-        // disabling all of them
-        //
-        ExtensionCommandDisableRdtscExitingForClearingEventsAllCores();
-
-        //
-        // Then we iterate through the list of this event to re-apply
-        // the previous events
-        //
-        TempList = &g_Events->TscInstructionExecutionEventsHead;
-
-        while (&g_Events->TscInstructionExecutionEventsHead != TempList->Flink)
-        {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
-
-            //
-            // We have to check because we don't want to re-apply
-            // the terminated event
-            //
-            if (CurrentEvent->Tag != Event->Tag)
-            {
-                //
-                // re-apply the event
-                //
-
-                //
-                // Let's see if it is for all cores or just one core
-                //
-                if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-                {
-                    //
-                    // All cores
-                    //
-                    ExtensionCommandEnableRdtscExitingAllCores();
-                }
-                else
-                {
-                    //
-                    // Just one core
-                    //
-                    ConfigureEnableRdtscExitingOnSingleCore(CurrentEvent->CoreId);
-                }
-            }
-        }
-    }
-    else
-    {
-        //
-        // Nothing else is in the list, we have to restore everything to default
-        // as the current event is the only event in the list
-        //
+    //
+    // The rdtsc/rdtscp exiting is reference counted on each core, so it's
+    // only disabled on the cores that no other event needs it on them
+    //
+    CoreMask = DebuggerReleaseEventResource(Event, &Resource);
 
-        //
-        // Disable it on all cores
-        //
-        ExtensionCommandDisableRdtscExitingForClearingEventsAllCores();
-    }
+    TerminateClearResourceOnCores(Resource, CoreMask);
 }
 
 /**
@@ -752,74 +516,16 @@ TerminateTscEvent(PDEBUGGER_EVENT Event)
 VOID
 TerminatePmcEvent(PDEBUGGER_EVENT Event)
 {
-    PLIST_ENTRY TempList = 0;
-
-    if (DebuggerEventListCount(&g_Events->PmcInstructionExecutionEventsHead) > 1)
-    {
-        //
-        // There are still other events in the queue (list), we should only remove
-        // this special event (not all events)
-        //
-
-        //
-        // For this purpose, first we disable all the events by
-        // disabling all of them
-        //
-        ExtensionCommandDisableRdpmcExitingAllCores();
+    DEBUGGER_EVENT_RESOURCE_TYPE Resource;
+    UINT64                       CoreMask;
 
-        //
-        // Then we iterate through the list of this event to re-apply
-        // the previous events
-        //
-        TempList = &g_Events->PmcInstructionExecutionEventsHead;
-
-        while (&g_Events->PmcInstructionExecutionEventsHead != TempList->Flink)
-        {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
-
-            //
-            // We have to check because we don't want to re-apply
-            // the terminated event
-            //
-            if (CurrentEvent->Tag != Event->Tag)
-            {
-                //
-                // re-apply the event
-                //
-
-                //
-                // Let's see if it is for all cores or just one core
-                //
-                if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-                {
-                    //
-                    // All cores
-                    //
-                    ExtensionCommandEnableRdpmcExitingAllCores();
-                }
-                else
-                {
-                    //
-                    // Just one core
-                    //
-                    ConfigureEnableRdpmcExitingOnSingleCore(CurrentEvent->CoreId);
-                }
-            }
-        }
-    }
-    else
-    {
-        //
-        // Nothing else is in the list, we have to restore everything to default
-        // as the current event is the only event in the list
-        //
+    //
+    // The rdpmc exiting is reference counted on each core, so it's only
+    // disabled on the cores that no other event needs it on them
+    //
+    CoreMask = DebuggerReleaseEventResource(Event, &Resource);
 
-        //
-        // Disable it on all the cores
-        //
-        ExtensionCommandDisableRdpmcExitingAllCores();
-    }
+    TerminateClearResourceOnCores(Resource, CoreMask);
 }
 
 /**
@@ -831,78 +537,23 @@ TerminatePmcEvent(PDEBUGGER_EVENT Event)
 VOID
 TerminateControlRegistersEvent(PDEBUGGER_EVENT Event)
 {
-    PLIST_ENTRY TempList = 0;
-
-    if (DebuggerEventListCount(&g_Events->ControlRegisterModifiedEventsHead) > 1)
-    {
-        //
-        // There are still other events in the queue (list), we should only remove
-        // this special event (not all events)
-        //
-
-        //
-        // For this purpose, first we disable all the events by
-        // disabling all of them
-        //
-        ExtensionCommandDisableMov2ControlRegsExitingForClearingEventsAllCores(Event);
-
-        //
-        // Then we iterate through the list of this event to re-apply
-        // the previous events
-        //
-        TempList = &g_Events->ControlRegisterModifiedEventsHead;
-
-        while (&g_Events->ControlRegisterModifiedEventsHead != TempList->Flink)
-        {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+    //
+    // The bits of the masks of control registers are reference counted,
+    // so only the bits of this event that are not used by other events
+    // are removed from the mask
+    //
+    DebuggerChangeBitmapOwnership(Event->CoreId,
+                                  FALSE,
+                                  BITMAP_OWNERSHIP_RESOURCE_MOV_TO_CONTROL_REGS,
+                                  Event->OptionalParam1,
+                                  Event->OptionalParam2);
 
-            //
-            // We have to check because we don't want to re-apply
-            // the terminated event
-            //
-            if (CurrentEvent->Tag != Event->Tag)
-            {
-                //
-                // re-apply the event
-                //
-
-                //
-                // Let's see if it is for all cores or just one core
-                //
-                if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-                {
-                    //
-                    // All cores
-                    //
-                    ExtensionCommandEnableMovControlRegisterExitingAllCores(CurrentEvent);
-                }
-                else
-                {
-                    //
-                    // Just one core
-                    //
-                    DEBUGGER_BROADCASTING_OPTIONS BroadcastingOption = {0};
-
-                    BroadcastingOption.OptionalParam1 = CurrentEvent->OptionalParam1;
-                    BroadcastingOption.OptionalParam2 = CurrentEvent->OptionalParam2;
-
-                    ConfigureEnableMovToControlRegisterExitingOnSingleCore(CurrentEvent->CoreId, &BroadcastingOption);
-                }
-            }
-        }
-    }
-    else
+    //
+    // Release the bypass of the filter of mov-to-cr3 vm-exits
+    //
+    if (Event->OptionalParam1 == VMX_EXIT_QUALIFICATION_REGISTER_CR3)
     {
-        //
-        // Nothing else is in the list, we have to restore everything to default
-        // as the current event is the only event in the list
-        //
-
-        //
-        // Disable it on all cores
-        //
-        ExtensionCommandDisableMov2ControlRegsExitingForClearingEventsAllCores(Event);
+        VmFuncBypassCr3VmexitFilter(FALSE);
     }
 }
 
@@ -915,74 +566,15 @@ TerminateControlRegistersEvent(PDEBUGGER_EVENT Event)
 VOID
 TerminateDebugRegistersEvent(PDEBUGGER_EVENT Event)
 {
-    PLIST_ENTRY TempList = 0;
-
-    if (DebuggerEventListCount(&g_Events->DebugRegistersAccessedEventsHead) > 1)
-    {
-        //
-        // There are still other events in the queue (list), we should only remove
-        // this special event (not all events)
-        //
-
-        //
-        // For this purpose, first we disable all the events by
-        // disabling all of them
-        //
-        ExtensionCommandDisableMov2DebugRegsExitingForClearingEventsAllCores();
-
-        //
-        // Then we iterate through the list of this event to re-apply
-        // the previous events
-        //
-        TempList = &g_Events->DebugRegistersAccessedEventsHead;
-
-        while (&g_Events->DebugRegistersAccessedEventsHead != TempList->Flink)
-        {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
-
-            //
-            // We have to check because we don't want to re-apply
-            // the terminated event
-            //
-            if (CurrentEvent->Tag != Event->Tag)
-            {
-                //
-                // re-apply the event
-                //
-
-                //
-                // Let's see if it is for all cores or just one core
-                //
-                if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-                {
-                    //
-                    // All cores
-                    //
-                    ExtensionCommandEnableMovDebugRegistersExitingAllCores();
-                }
-                else
-                {
-                    //
-                    // Just one core
-                    //
-                    ConfigureEnableMovToDebugRegistersExitingOnSingleCore(CurrentEvent->CoreId);
-                }
-            }
-        }
-    }
-    else
-    {
-        //
-        // Nothing else is in the list, we have to restore everything to default
-        // as the current event is the only event in the list
-        //
-
-        //
-        // Disable it on all cores
-        //
-        ExtensionCommandDisableMov2DebugRegsExitingForClearingEventsAllCores();
-    }
+    //
+    // Mov to debug registers exiting is reference counted, so it's only
+    // disabled once no other event needs it
+    //
+    DebuggerChangeBitmapOwnership(Event->CoreId,
+                                  FALSE,
+                                  BITMAP_OWNERSHIP_RESOURCE_MOV_TO_DEBUG_REGS,
+                                  0,
+                                  0);
 }
 
 /**
@@ -994,81 +586,34 @@ TerminateDebugRegistersEvent(PDEBUGGER_EVENT Event)
 VOID
 TerminateSyscallHookEferEvent(PDEBUGGER_EVENT Event)
 {
-    PLIST_ENTRY TempList = 0;
+    DEBUGGER_EVENT_RESOURCE_TYPE Resource;
+    UINT64                       CoreMask;
 
     //
-    // For this event we should also check for sysret instructions events too
-    // because both of them are emulated by a single bit in vmx controls
-    // and a MSR so if there is anything in out events list then we can
-    // remove all the events
+    // The syscall number of this event is not interesting anymore (if no
+    // other event is interested in it)
     //
-    if (DebuggerEventListCount(&g_Events->SyscallHooksEferSyscallEventsHead) > 1 ||
-        DebuggerEventListCount(&g_Events->SyscallHooksEferSysretEventsHead) >= 1)
-    {
-        //
-        // There are still other events in the queue (list), we should only remove
-        // this special event (not all events)
-        //
+    DebuggerEventUpdateSyscallFilter(Event->Tag);
 
-        //
-        // For this purpose, first we disable all the events by
-        // disabling all of them
-        //
-        DebuggerEventDisableEferOnAllProcessors();
-
-        //
-        // Then we iterate through the list of this event to re-apply
-        // the previous events
-        //
-        TempList = &g_Events->SyscallHooksEferSyscallEventsHead;
-
-        while (&g_Events->SyscallHooksEferSyscallEventsHead != TempList->Flink)
-        {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
-
-            //
-            // We have to check because we don't want to re-apply
-            // the terminated event
-            //
-            if (CurrentEvent->Tag != Event->Tag)
-            {
-                //
-                // re-apply the event
-                //
-
-                //
-                // Let's see if it is for all cores or just one core
-                //
-                if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-                {
-                    //
-                    // All cores
-                    //
-                    DebuggerEventEnableEferOnAllProcessors((DEBUGGER_EVENT_SYSCALL_SYSRET_TYPE)CurrentEvent->OptionalParam2);
-                }
-                else
-                {
-                    //
-                    // Just one core
-                    //
-                    ConfigureEnableEferSyscallHookOnSingleCore(CurrentEvent->CoreId, (DEBUGGER_EVENT_SYSCALL_SYSRET_TYPE)CurrentEvent->OptionalParam2);
-                }
-            }
-        }
-    }
-    else
+    //
+    // The hook of the entry of system calls (!syscall3) is shared by its
+    // events, it doesn't affect the EFER hooks
+    //
+    if (Event->OptionalParam2 == DEBUGGER_EVENT_SYSCALL_SYSRET_LSTAR_ENTRY_HOOK)
     {
-        //
-        // Nothing else is in the list, we have to restore everything to default
-        // as the current event is the only event in the list
-        //
-
-        //
-        // Disable it on all cores
-        //
-        DebuggerEventDisableEferOnAllProcessors();
+        ConfigureDisableLstarSyscallHook();
+        return;
     }
+
+    //
+    // Both of syscall and sysret instructions are emulated by a single bit
+    // in vmx controls and a MSR, so the EFER hook is reference counted by
+    // the events of both of them, and it's only disabled on the cores that
+    // no other !syscall or !sysret event needs it on them
+    //
+    CoreMask = DebuggerReleaseEventResource(Event, &Resource);
+
+    TerminateClearResourceOnCores(Resource, CoreMask);
 }
 
 /**
@@ -1080,81 +625,35 @@ TerminateSyscallHookEferEvent(PDEBUGGER_EVENT Event)
 VOID
 TerminateSysretHookEferEvent(PDEBUGGER_EVENT Event)
 {
-    PLIST_ENTRY TempList = 0;
+    DEBUGGER_EVENT_RESOURCE_TYPE Resource;
+    UINT64                       CoreMask;
 
     //
-    // For this event we should also check for syscall instructions events too
-    // because both of them are emulated by a single bit in vmx controls
-    // and a MSR so if there is anything in out events list then we can
-    // remove all the events
+    // Both of syscall and sysret instructions are emulated by a single bit
+    // in vmx controls and a MSR, so the EFER hook is reference counted by
+    // the events of both of them, and it's only disabled on the cores that
+    // no other !syscall or !sysret event needs it on them
     //
-    if (DebuggerEventListCount(&g_Events->SyscallHooksEferSysretEventsHead) > 1 ||
-        DebuggerEventListCount(&g_Events->SyscallHooksEferSyscallEventsHead) > 1)
-    {
-        //
-        // There are still other events in the queue (list), we should only remove
-        // this special event (not all events)
-        //
+    CoreMask = DebuggerReleaseEventResource(Event, &Resource);
 
-        //
-        // For this purpose, first we disable all the events by
-        // disabling all of them
-        //
-        DebuggerEventDisableEferOnAllProcessors();
-
-        //
-        // Then we iterate through the list of this event to re-apply
-        // the previous events
-        //
-        TempList = &g_Events->SyscallHooksEferSysretEventsHead;
-
-        while (&g_Events->SyscallHooksEferSysretEventsHead != TempList->Flink)
-        {
-            TempList                     = TempList->Flink;
-            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
-
-            //
-            // We have to check because we don't want to re-apply
-            // the terminated event
-            //
-            if (CurrentEvent->Tag != Event->Tag)
-            {
-                //
-                // re-apply the event
-                //
-
-                //
-                // Let's see if it is for all cores or just one core
-                //
-                if (CurrentEvent->CoreId == DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
-                {
-                    //
-                    // All cores
-                    //
-                    DebuggerEventEnableEferOnAllProcessors((DEBUGGER_EVENT_SYSCALL_SYSRET_TYPE)CurrentEvent->OptionalParam2);
-                }
-                else
-                {
-                    //
-                    // Just one core
-                    //
-                    ConfigureEnableEferSyscallHookOnSingleCore(CurrentEvent->CoreId, (DEBUGGER_EVENT_SYSCALL_SYSRET_TYPE)CurrentEvent->OptionalParam2);
-                }
-            }
-        }
-    }
-    else
-    {
-        //
-        // Nothing else is in the list, we have to restore everything to default
-        // as the current event is the only event in the list
-        //
+    TerminateClearResourceOnCores(Resource, CoreMask);
+}
 
-        //
-        // Disable it on all cores
-        //
-        DebuggerEventDisableEferOnAllProcessors();
-    }
+/**
+ * @brief Termination function for page first execution (!exectrace) events
+ *
+ * @param Event Target Event Object
+ * @return VOID
+ */
+VOID
+TerminatePageFirstExecutionEvent(PDEBUGGER_EVENT Event)
+{
+    //
+    // Each event traces its own range and the range is found by the tag of
+    // the event, so only the range of this event is removed (MBEC is disabled
+    // once the last range is removed)
+    //
+    ConfigureModeBasedExecHookUntraceRange(Event->Tag);
 }
 
 /**
@@ -1172,17 +671,9 @@ TerminateQueryDebuggerResourceExceptionBitmap(UINT32
                                               PROTECTED_HV_RESOURCES_PASSING_OVERS PassOver)
 {
     //
-    // Check if the integrity check is because of clearing
-    // events or not, if it's for clearing events, the debugger
-    // will automatically set
+    // The exceptions of !exception events are owned by the events
+    // in the hypervisor, so they're not added here
     //
-    if (!(PassOver & PASSING_OVER_EXCEPTION_EVENTS))
-    {
-        //
-        // we have to check for !exception events and apply the mask
-        //
-        *BitmapMask = *BitmapMask | DebuggerExceptionEventBitmapMask(CoreId);
-    }
 
     //
     // Check if it's because of disabling !syscall or !sysret commands
@@ -1197,8 +688,7 @@ TerminateQueryDebuggerResourceExceptionBitmap(UINT32
         // if no, we can safely ignore #UDs, otherwise, #UDs should be
         // activated
         //
-        if (DebuggerEventListCountByEventType(SYSCALL_HOOK_EFER_SYSCALL, CoreId) != 0 ||
-            DebuggerEventListCountByEventType(SYSCALL_HOOK_EFER_SYSRET, CoreId) != 0)
+        if (g_DbgState[CoreId].EventsResources.References[DEBUGGER_EVENT_RESOURCE_EFER_SYSCALL_HOOK] != 0)
         {
             //
             // #UDs should be activated
@@ -1254,7 +744,7 @@ TerminateQueryDebuggerResourceExternalInterruptExiting(UINT32
         // we have to check for !interrupt events and decide whether to
         // ignore this event or not
         //
-        if (DebuggerEventListCountByEventType(EXTERNAL_INTERRUPT_OCCURRED, CoreId) != 0)
+        if (g_DbgState[CoreId].EventsResources.References[DEBUGGER_EVENT_RESOURCE_EXTERNAL_INTERRUPT_EXITING] != 0)
         {
             //
             // We should ignore this unset, because !interrupt is enabled for this core
@@ -1306,7 +796,7 @@ TerminateQueryDebuggerResourceTscExiting(UINT32                               Co
         // we have to check for !tsc events and decide whether to
         // ignore this event or not
         //
-        if (DebuggerEventListCountByEventType(TSC_INSTRUCTION_EXECUTION, CoreId) != 0)
+        if (g_DbgState[CoreId].EventsResources.References[DEBUGGER_EVENT_RESOURCE_RDTSC_EXITING] != 0)
         {
             //
             // We should ignore this unset, because !tsc is enabled for this core
@@ -1334,25 +824,10 @@ TerminateQueryDebuggerResourceMov2DebugRegExiting(UINT32
                                                   PROTECTED_HV_RESOURCES_PASSING_OVERS PassOver)
 {
     //
-    // Check if the integrity check is because of clearing
-    // events or not, if it's for clearing events, the debugger
-    // will automatically set
+    // The !dr events own the exiting in the hypervisor, so they're
+    // not checked here
     //
-    if (!(PassOver & PASSING_OVER_MOV_TO_HW_DEBUG_REGS_EVENTS))
-    {
-        //
-        // we have to check for !dr events and decide whether to
-        // ignore this event or not
-        //
-        if (DebuggerEventListCountByEventType(DEBUG_REGISTERS_ACCESSED, CoreId) != 0)
-        {
-            //
-            // We should ignore this unset, because !dr is enabled for this core
-            //
-
-            return TRUE;
-        }
-    }
+    UNREFERENCED_PARAMETER(PassOver);
 
     //
     // Check if thread switching is enabled or not
@@ -1385,24 +860,11 @@ TerminateQueryDebuggerResourceMovControlRegsExiting(UINT32
                                                     PROTECTED_HV_RESOURCES_PASSING_OVERS PassOver)
 {
     //
-    // Check if the integrity check is because of clearing
-    // events or not, if it's for clearing events, the debugger
-    // will automatically set
+    // The !crwrite events own the bits of the masks in the hypervisor,
+    // so they're not checked here
     //
-    if (!(PassOver & PASSING_OVER_MOV_TO_CONTROL_REGS_EVENTS))
-    {
-        //
-        // we have to check for !dr events and decide whether to
-        // ignore this event or not
-        //
-        if (DebuggerEventListCountByEventType(CONTROL_REGISTER_MODIFIED, CoreId) != 0)
-        {
-            //
-            // We should ignore this unset, because !dr is enabled for this core
-            //
-            return TRUE;
-        }
-    }
+    UNREFERENCED_PARAMETER(CoreId);
+    UNREFERENCED_PARAMETER(PassOver);
 
     //
     // Not terminate
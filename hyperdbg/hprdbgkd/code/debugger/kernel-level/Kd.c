@@ -44,6 +44,13 @@ KdInitializeKernelDebugger()
                                  MAXIMUM_BREAKPOINTS_WITHOUT_CONTINUE,
                                  BREAKPOINT_DEFINITION_STRUCTURE);
 
+    //
+    // Refill them once half of them are used
+    //
+    PoolManagerSetWatermarks(BREAKPOINT_DEFINITION_STRUCTURE,
+                             MAXIMUM_BREAKPOINTS_WITHOUT_CONTINUE / 2,
+                             MAXIMUM_BREAKPOINTS_WITHOUT_CONTINUE);
+
     //
     // Enable vm-exit on Hardware debug exceptions and breakpoints
     // so, intercept #DBs and #BP by changing exception bitmap (one core)
@@ -58,9 +65,40 @@ KdInitializeKernelDebugger()
     //
     // Initialize list of breakpoints and breakpoint id
     //
-    g_MaximumBreakpointId = 0;
+    BreakpointInitialize();
+
+    //
+    // Allocate the buffers of parallel searches (searches are performed on
+    // one core if they're not allocated)
+    //
+    g_SearchMemoryParallelCountOfSlices = CoreCount * SearchParallelSlicesPerCore;
+    g_SearchMemoryParallelSlices        = ExAllocatePoolWithTag(NonPagedPool, g_SearchMemoryParallelCountOfSlices * sizeof(SEARCH_MEMORY_PARALLEL_SLICE), POOLTAG);
+    g_SearchMemoryParallelBuffers       = ExAllocatePoolWithTag(NonPagedPool, CoreCount * SearchParallelBufferSize, POOLTAG);
+
+    if (g_SearchMemoryParallelSlices == NULL || g_SearchMemoryParallelBuffers == NULL)
+    {
+        LogWarning("Warning, searches in the debugger mode are not performed in parallel");
+    }
+
+    //
+    // Get notified of loading new kernel modules, so the debugger can load
+    // the symbols of new modules without rebuilding the entire symbol table
+    //
+    if (NT_SUCCESS(PsSetLoadImageNotifyRoutine(KdLoadImageNotifyRoutine)))
+    {
+        g_KernelDebuggerLoadImageNotifyRoutineIsRegistered = TRUE;
+    }
+    else
+    {
+        LogWarning("Warning, the debugger is not notified of loading new modules, use '.sym reload' after loading a driver");
+    }
 
-    InitializeListHead(&g_BreakpointsListHead);
+    //
+    // The watchdog of the halts is disabled until the debugger sets it, and
+    // the frequency of the time-stamp counter is measured for it
+    //
+    RtlZeroMemory(&g_KdHaltWatchdog, sizeof(KD_HALT_WATCHDOG_STATE));
+    KdHaltWatchdogMeasureTscFrequency();
 
     //
     // Indicate that the kernel debugger is active
@@ -94,6 +132,15 @@ KdUninitializeKernelDebugger()
         //
         RtlZeroMemory(&g_IgnoreBreaksToDebugger, sizeof(DEBUGGEE_REQUEST_TO_IGNORE_BREAKS_UNTIL_AN_EVENT));
 
+        //
+        // Not notify the debugger of loading new modules anymore
+        //
+        if (g_KernelDebuggerLoadImageNotifyRoutineIsRegistered)
+        {
+            PsRemoveLoadImageNotifyRoutine(KdLoadImageNotifyRoutine);
+            g_KernelDebuggerLoadImageNotifyRoutineIsRegistered = FALSE;
+        }
+
         //
         // Remove all active breakpoints
         //
@@ -104,6 +151,26 @@ KdUninitializeKernelDebugger()
         // so, not intercept #DBs and #BP by changing exception bitmap (one core)
         //
         BroadcastDisableDbAndBpExitingAllCores();
+
+        //
+        // Free the buffers of parallel searches
+        //
+        if (g_SearchMemoryParallelSlices != NULL)
+        {
+            ExFreePoolWithTag(g_SearchMemoryParallelSlices, POOLTAG);
+            g_SearchMemoryParallelSlices = NULL;
+        }
+
+        if (g_SearchMemoryParallelBuffers != NULL)
+        {
+            ExFreePoolWithTag(g_SearchMemoryParallelBuffers, POOLTAG);
+            g_SearchMemoryParallelBuffers = NULL;
+        }
+
+        //
+        // Stop using the network adapter (if it's connected over the network)
+        //
+        NetworkConnectionUninitialize();
     }
 }
 
@@ -260,6 +327,12 @@ KdResponsePacketToDebugger(
     //
     Packet.RequestedActionOfThePacket = Response;
 
+    //
+    // Responses are interactive, bulk messages of events are held until
+    // the response is sent
+    //
+    InterlockedIncrement(&DebuggerInteractiveResponsesPending);
+
     //
     // Send the serial packets to the debugger
     //
@@ -284,19 +357,39 @@ KdResponsePacketToDebugger(
 
         Packet.Checksum += KdComputeDataChecksum((PVOID)OptionalBuffer, OptionalBufferLength);
 
-        //
-        // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
-        // if not we use the windows spinlock
-        //
-
-        ScopedSpinlock(
-            DebuggerResponseLock,
-            Result = SerialConnectionSendTwoBuffers((CHAR *)&Packet,
-                                                    sizeof(DEBUGGER_REMOTE_PACKET),
-                                                    OptionalBuffer,
-                                                    OptionalBufferLength));
+        if (g_SerialConnectionIsBulkLinkEnabled &&
+            Response == DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_READING_MEMORY)
+        {
+            //
+            // Chunks of memory are bulk data, they're sent over the bulk link
+            // so they don't hold the lock of the control link
+            //
+            ScopedSpinlock(
+                DebuggerBulkResponseLock,
+                Result = SerialConnectionSendBulkThreeBuffers((CHAR *)&Packet,
+                                                              sizeof(DEBUGGER_REMOTE_PACKET),
+                                                              OptionalBuffer,
+                                                              OptionalBufferLength,
+                                                              NULL,
+                                                              0));
+        }
+        else
+        {
+            //
+            // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
+            // if not we use the windows spinlock
+            //
+            ScopedSpinlock(
+                DebuggerResponseLock,
+                Result = SerialConnectionSendTwoBuffers((CHAR *)&Packet,
+                                                        sizeof(DEBUGGER_REMOTE_PACKET),
+                                                        OptionalBuffer,
+                                                        OptionalBufferLength));
+        }
     }
 
+    InterlockedDecrement(&DebuggerInteractiveResponsesPending);
+
     if (g_IgnoreBreaksToDebugger.PauseBreaksUntilSpecialMessageSent && g_IgnoreBreaksToDebugger.SpeialEventResponse == Response)
     {
         //
@@ -325,6 +418,7 @@ KdLoggingResponsePacketToDebugger(
 {
     DEBUGGER_REMOTE_PACKET Packet = {0};
     BOOLEAN                Result = FALSE;
+    BOOLEAN                IsBulk = OPERATION_LOG_IS_BULK_MESSAGE(OperationCode);
 
     //
     // Make the packet's structure
@@ -346,6 +440,41 @@ KdLoggingResponsePacketToDebugger(
     Packet.Checksum += KdComputeDataChecksum((PVOID)&OperationCode, sizeof(UINT32));
     Packet.Checksum += KdComputeDataChecksum((PVOID)OptionalBuffer, OptionalBufferLength);
 
+    if (IsBulk && g_SerialConnectionIsBulkLinkEnabled)
+    {
+        //
+        // Bulk messages of events have their own link, so they don't wait
+        // for the interactive senders
+        //
+        ScopedSpinlock(
+            DebuggerBulkResponseLock,
+            Result = SerialConnectionSendBulkThreeBuffers((CHAR *)&Packet,
+                                                          sizeof(DEBUGGER_REMOTE_PACKET),
+                                                          &OperationCode,
+                                                          sizeof(UINT32),
+                                                          OptionalBuffer,
+                                                          OptionalBufferLength));
+
+        return Result;
+    }
+
+    if (IsBulk)
+    {
+        //
+        // Bulk messages of events wait for the interactive senders (e.g.,
+        // results of commands) so they don't queue behind the trace data
+        // on the serial
+        //
+        while (DebuggerInteractiveResponsesPending != 0)
+        {
+            _mm_pause();
+        }
+    }
+    else
+    {
+        InterlockedIncrement(&DebuggerInteractiveResponsesPending);
+    }
+
     //
     // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
     // if not we use the windows spinlock
@@ -360,6 +489,11 @@ KdLoggingResponsePacketToDebugger(
                                                   OptionalBuffer,
                                                   OptionalBufferLength));
 
+    if (!IsBulk)
+    {
+        InterlockedDecrement(&DebuggerInteractiveResponsesPending);
+    }
+
     return Result;
 }
 
@@ -515,6 +649,15 @@ KdApplyTasksPreHaltCore(PROCESSOR_DEBUGGING_STATE * DbgState)
         DbgState->ThreadOrProcessTracingDetails.InitialSetThreadChangeEvent = FALSE;
         DbgState->ThreadOrProcessTracingDetails.InitialSetByClockInterrupt  = FALSE;
     }
+
+    //
+    // Check to stop counting the retired instructions (if something else
+    // halted the debuggee while counting)
+    //
+    if (g_KdInstructionBudget.IsActive && DbgState->CoreId == g_KdInstructionBudget.CoreId)
+    {
+        g_KdInstructionBudget.CountOfCountedInstructions += VmFuncDisarmInstructionCounter(DbgState->CoreId);
+    }
 }
 
 /**
@@ -563,6 +706,23 @@ KdApplyTasksPostContinueCore(PROCESSOR_DEBUGGING_STATE * DbgState)
         //
         ThreadEnableOrDisableThreadChangeMonitor(DbgState, TRUE);
     }
+
+    //
+    // Apply the hardware controls of the events that are enabled or
+    // disabled while the debuggee was halted
+    //
+    DebuggerApplyEventsResourcesOnCore(DbgState);
+
+    //
+    // Invalidate the caches of EPT if the snapshot of the memory is
+    // changed while the debuggee was halted
+    //
+    if (DbgState->InvalidateEptOnContinue)
+    {
+        VmFuncInvalidateEptSingleContext();
+
+        DbgState->InvalidateEptOnContinue = FALSE;
+    }
 }
 
 /**
@@ -593,13 +753,12 @@ KdContinueDebuggee(PROCESSOR_DEBUGGING_STATE *             DbgState,
     VmFuncCheckAndEnableExternalInterrupts(DbgState->CoreId);
 
     //
-    // Unlock all the cores
+    // Unlock the current core, the other cores are halted till the continue
+    // epoch is changed, so all of them are continued by a single store
+    // (instead of unlocking each core)
     //
-    ULONG CoreCount = KeQueryActiveProcessorCount(0);
-    for (size_t i = 0; i < CoreCount; i++)
-    {
-        SpinlockUnlock(&g_DbgState[i].Lock);
-    }
+    SpinlockUnlock(&DbgState->Lock);
+    InterlockedIncrement64(&g_KdHaltEpochs.ContinueEpoch);
 }
 
 /**
@@ -625,44 +784,98 @@ KdContinueDebuggeeJustCurrentCore(PROCESSOR_DEBUGGING_STATE * DbgState)
 
 /**
  * @brief read registers
+ * @details for showing all registers, only the registers that are changed
+ * since the last time that they are sent to the debugger are sent if the
+ * debugger has the last sent registers of this core
+ *
  * @param DbgState The state of the debugger on the current core
  * @param ReadRegisterRequest
+ * @param ResultLength Length of the result (including the registers)
  *
  * @return BOOLEAN
  */
 _Use_decl_annotations_
 BOOLEAN
-KdReadRegisters(PROCESSOR_DEBUGGING_STATE * DbgState, PDEBUGGEE_REGISTER_READ_DESCRIPTION ReadRegisterRequest)
+KdReadRegisters(PROCESSOR_DEBUGGING_STATE * DbgState, PDEBUGGEE_REGISTER_READ_DESCRIPTION ReadRegisterRequest, UINT32 * ResultLength)
 {
-    GUEST_EXTRA_REGISTERS ERegs = {0};
+    DEBUGGEE_REGISTERS_CONTEXT Context;
+    UINT64 *                   Words;
+    UINT64 *                   LastSentWords;
+    UINT64 *                   Result;
+    UINT32                     CountOfWords = 0;
+
+    *ResultLength = sizeof(DEBUGGEE_REGISTER_READ_DESCRIPTION);
 
     if (ReadRegisterRequest->RegisterID == DEBUGGEE_SHOW_ALL_REGISTERS)
     {
+        RtlZeroMemory(&Context, sizeof(DEBUGGEE_REGISTERS_CONTEXT));
+
         //
         // Add General purpose registers
         //
-        memcpy((void *)((CHAR *)ReadRegisterRequest + sizeof(DEBUGGEE_REGISTER_READ_DESCRIPTION)),
-               DbgState->Regs,
-               sizeof(GUEST_REGS));
+        memcpy(&Context.Regs, DbgState->Regs, sizeof(GUEST_REGS));
 
         //
         // Read Extra registers
         //
-        ERegs.CS     = DebuggerGetRegValueWrapper(NULL, REGISTER_CS);
-        ERegs.SS     = DebuggerGetRegValueWrapper(NULL, REGISTER_SS);
-        ERegs.DS     = DebuggerGetRegValueWrapper(NULL, REGISTER_DS);
-        ERegs.ES     = DebuggerGetRegValueWrapper(NULL, REGISTER_ES);
-        ERegs.FS     = DebuggerGetRegValueWrapper(NULL, REGISTER_FS);
-        ERegs.GS     = DebuggerGetRegValueWrapper(NULL, REGISTER_GS);
-        ERegs.RFLAGS = DebuggerGetRegValueWrapper(NULL, REGISTER_RFLAGS);
-        ERegs.RIP    = DebuggerGetRegValueWrapper(NULL, REGISTER_RIP);
+        Context.ExtraRegs.CS     = DebuggerGetRegValueWrapper(NULL, REGISTER_CS);
+        Context.ExtraRegs.SS     = DebuggerGetRegValueWrapper(NULL, REGISTER_SS);
+        Context.ExtraRegs.DS     = DebuggerGetRegValueWrapper(NULL, REGISTER_DS);
+        Context.ExtraRegs.ES     = DebuggerGetRegValueWrapper(NULL, REGISTER_ES);
+        Context.ExtraRegs.FS     = DebuggerGetRegValueWrapper(NULL, REGISTER_FS);
+        Context.ExtraRegs.GS     = DebuggerGetRegValueWrapper(NULL, REGISTER_GS);
+        Context.ExtraRegs.RFLAGS = DebuggerGetRegValueWrapper(NULL, REGISTER_RFLAGS);
+        Context.ExtraRegs.RIP    = DebuggerGetRegValueWrapper(NULL, REGISTER_RIP);
+
+        Words         = (UINT64 *)&Context;
+        LastSentWords = (UINT64 *)&DbgState->LastSentRegisters;
+        Result        = (UINT64 *)((CHAR *)ReadRegisterRequest + sizeof(DEBUGGEE_REGISTER_READ_DESCRIPTION));
+
+        if (ReadRegisterRequest->BaseContextId != 0 &&
+            ReadRegisterRequest->BaseContextId == DbgState->LastSentRegistersContextId)
+        {
+            //
+            // The debugger has the last sent registers, so only the
+            // changed words are copied at the end of the structure
+            //
+            ReadRegisterRequest->IsDelta          = TRUE;
+            ReadRegisterRequest->ChangedRegisters = 0;
+
+            for (UINT32 i = 0; i < DEBUGGEE_REGISTERS_CONTEXT_WORDS; i++)
+            {
+                if (Words[i] != LastSentWords[i])
+                {
+                    ReadRegisterRequest->ChangedRegisters |= 1 << i;
+                    Result[CountOfWords++] = Words[i];
+                }
+            }
+        }
+        else
+        {
+            //
+            // copy at the end of ReadRegisterRequest structure
+            //
+            ReadRegisterRequest->IsDelta = FALSE;
+
+            memcpy(Result, &Context, sizeof(DEBUGGEE_REGISTERS_CONTEXT));
+            CountOfWords = DEBUGGEE_REGISTERS_CONTEXT_WORDS;
+        }
 
         //
-        // copy at the end of ReadRegisterRequest structure
+        // Save the sent registers (zero is not used as an id)
         //
-        memcpy((void *)((CHAR *)ReadRegisterRequest + sizeof(DEBUGGEE_REGISTER_READ_DESCRIPTION) + sizeof(GUEST_REGS)),
-               &ERegs,
-               sizeof(GUEST_EXTRA_REGISTERS));
+        memcpy(&DbgState->LastSentRegisters, &Context, sizeof(DEBUGGEE_REGISTERS_CONTEXT));
+
+        DbgState->LastSentRegistersContextId++;
+
+        if (DbgState->LastSentRegistersContextId == 0)
+        {
+            DbgState->LastSentRegistersContextId++;
+        }
+
+        ReadRegisterRequest->ContextId = DbgState->LastSentRegistersContextId;
+
+        *ResultLength += CountOfWords * sizeof(UINT64);
     }
     else
     {
@@ -721,6 +934,67 @@ KdReadMemory(PGUEST_REGS Regs, PDEBUGGEE_REGISTER_READ_DESCRIPTION ReadRegisterR
     return TRUE;
 }
 
+/**
+ * @brief read memory and send it to the debugger as consecutive chunks
+ * @details each chunk is sent as a separate packet and contains the
+ * sequence number of the chunk, so reading large regions needs a
+ * single request from the debugger, the chunks are read into the
+ * receive buffer (right after the request)
+ *
+ * @param ReadMemoryRequest
+ *
+ * @return VOID
+ */
+VOID
+KdReadMemoryAndSendChunks(PDEBUGGER_READ_MEMORY ReadMemoryRequest)
+{
+    UINT64  Address        = ReadMemoryRequest->Address;
+    UINT32  Size           = ReadMemoryRequest->Size;
+    UINT32  Offset         = 0;
+    UINT32  SequenceNumber = 0;
+    UINT32  ChunkSize;
+    SIZE_T  ReturnSize;
+    BOOLEAN Result;
+
+    do
+    {
+        ChunkSize  = min(Size - Offset, MaxSerialReadMemoryChunkSize);
+        ReturnSize = 0;
+
+        //
+        // Read the chunk
+        //
+        ReadMemoryRequest->Address = Address + Offset;
+        ReadMemoryRequest->Size    = ChunkSize;
+
+        Result = DebuggerCommandReadMemoryVmxRoot(ReadMemoryRequest,
+                                                  (PVOID)((UINT64)ReadMemoryRequest + sizeof(DEBUGGER_READ_MEMORY)),
+                                                  &ReturnSize);
+
+        ReadMemoryRequest->KernelStatus = Result ? DEBUGGER_OPERATION_WAS_SUCCESSFUL : DEBUGGER_ERROR_INVALID_ADDRESS;
+
+        //
+        // The chunks are sent with the details of the original request
+        //
+        Offset += ChunkSize;
+
+        ReadMemoryRequest->Address        = Address;
+        ReadMemoryRequest->Size           = Size;
+        ReadMemoryRequest->ReturnLength   = (UINT32)ReturnSize;
+        ReadMemoryRequest->SequenceNumber = SequenceNumber++;
+        ReadMemoryRequest->IsLastChunk    = !Result || Offset >= Size;
+
+        //
+        // Send the result of reading memory back to the debugger
+        //
+        KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
+                                   DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_READING_MEMORY,
+                                   (unsigned char *)ReadMemoryRequest,
+                                   sizeof(DEBUGGER_READ_MEMORY) + (UINT32)ReturnSize);
+
+    } while (!ReadMemoryRequest->IsLastChunk);
+}
+
 /**
  * @brief change the current operating core to new core
  *
@@ -811,6 +1085,44 @@ KdReloadSymbolDetailsInDebuggee(PDEBUGGEE_SYMBOL_REQUEST_PACKET SymPacket)
                           TRUE);
 }
 
+/**
+ * @brief Notify routine of loading images
+ * @details user-mode is notified of new kernel modules, so it sends the symbol
+ * details of the module (and only this module) to the debugger
+ *
+ * @param FullImageName
+ * @param ProcessId
+ * @param ImageInfo
+ * @return VOID
+ */
+VOID
+KdLoadImageNotifyRoutine(PUNICODE_STRING FullImageName, HANDLE ProcessId, PIMAGE_INFO ImageInfo)
+{
+    DEBUGGEE_KERNEL_MODULE_LOADED_PACKET ModuleLoadedPacket = {0};
+    UINT32                               FilePathLength;
+
+    if (ProcessId != NULL || !ImageInfo->SystemModeImage || FullImageName == NULL || !g_KernelDebuggerState)
+    {
+        //
+        // Only kernel modules are notified
+        //
+        return;
+    }
+
+    FilePathLength = min((UINT32)(FullImageName->Length / sizeof(WCHAR)), MAX_PATH - 1);
+
+    ModuleLoadedPacket.BaseAddress = (UINT64)ImageInfo->ImageBase;
+    memcpy(ModuleLoadedPacket.FilePath, FullImageName->Buffer, FilePathLength * sizeof(WCHAR));
+
+    //
+    // Send the details of the module to the user-mode
+    //
+    LogCallbackSendBuffer(OPERATION_NOTIFICATION_FROM_KERNEL_MODULE_LOAD,
+                          &ModuleLoadedPacket,
+                          sizeof(DEBUGGEE_KERNEL_MODULE_LOADED_PACKET),
+                          TRUE);
+}
+
 /**
  * @brief Notify user-mode to about new user-input buffer
  * @param Descriptor
@@ -936,12 +1248,28 @@ KdCustomDebuggerBreakSpinlockLock(PROCESSOR_DEBUGGING_STATE * DbgState, volatile
 {
     unsigned wait = 1;
 
+#if UseSpinlockContentionInstrumentation == TRUE
+
+    SpinlockDefineSite(BreakLockSite, "kd: debugger break");
+    UINT64 StartTime = 0;
+
+#endif
+
     //
     // *** Lock handling breaks ***
     //
 
     while (!SpinlockTryLock(Lock))
     {
+#if UseSpinlockContentionInstrumentation == TRUE
+
+        if (StartTime == 0)
+        {
+            StartTime = __rdtsc();
+        }
+
+#endif
+
         for (unsigned i = 0; i < wait; ++i)
         {
             _mm_pause();
@@ -990,6 +1318,67 @@ KdCustomDebuggerBreakSpinlockLock(PROCESSOR_DEBUGGING_STATE * DbgState, volatile
             wait = wait * 2;
         }
     }
+
+#if UseSpinlockContentionInstrumentation == TRUE
+
+    //
+    // The cycles of handling the halts while waiting are also counted
+    //
+    SpinlockRecordContention(&BreakLockSite, StartTime == 0 ? 0 : __rdtsc() - StartTime + 1);
+
+#endif
+}
+
+/**
+ * @brief Wait for the lock of a halted core
+ * @details while the core is waiting, it takes part in the tasks that
+ * are shared by the operating core, the core is continued once the
+ * continue epoch is changed (all the cores are continued) or its lock
+ * is released (e.g., switching to this core)
+ *
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return VOID
+ */
+VOID
+KdHaltedCoreWaitForLock(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    unsigned wait = 1;
+
+    //
+    // If the debuggee is already continued (the core is halted too
+    // late), the epochs are not the same and the core is not halted
+    //
+    while (g_KdHaltEpochs.ContinueEpoch == g_KdHaltEpochs.BreakEpoch &&
+           !SpinlockTryLock(&DbgState->Lock))
+    {
+        //
+        // Take part in the parallel search (if any)
+        //
+        if (SearchMemoryParallelWorker(DbgState->CoreId))
+        {
+            wait = 1;
+            continue;
+        }
+
+        for (unsigned i = 0; i < wait; ++i)
+        {
+            _mm_pause();
+        }
+
+        //
+        // Don't call "pause" too many times, the tasks should be picked
+        // up quickly so the wait is clamped to a smaller value
+        //
+        if (wait * 2 > 1024)
+        {
+            wait = 1024;
+        }
+        else
+        {
+            wait = wait * 2;
+        }
+    }
 }
 
 /**
@@ -1093,6 +1482,15 @@ KdHandleRegisteredMtfCallback(UINT32 CoreId)
     PROCESSOR_DEBUGGING_STATE * DbgState      = &g_DbgState[CoreId];
     UINT64                      LastVmexitRip = VmFuncGetLastVmexitRip(CoreId);
 
+    //
+    // If a count of instructions is run, the next step is performed
+    // without pausing the debuggee
+    //
+    if (KdInstructionBudgetStepAgain(DbgState))
+    {
+        return;
+    }
+
     //
     // Check if the cs selector changed or not, which indicates that the
     // execution changed from user-mode to kernel-mode or kernel-mode to
@@ -1173,7 +1571,13 @@ KdHandleBreakpointAndDebugBreakpoints(PROCESSOR_DEBUGGING_STATE *       DbgState
     // Lock current core
     //
     DbgState->NmiState.WaitingToBeLocked = FALSE;
-    SpinlockLock(&DbgState->Lock);
+    SpinlockLockNamed(&DbgState->Lock, "kd: core lock (break)");
+
+    //
+    // The cores that are halted by this break wait till the debuggee
+    // is continued (the continue epoch is changed)
+    //
+    g_KdHaltEpochs.BreakEpoch = g_KdHaltEpochs.ContinueEpoch;
 
     //
     // Set the halting reason
@@ -1199,9 +1603,13 @@ KdHandleBreakpointAndDebugBreakpoints(PROCESSOR_DEBUGGING_STATE *       DbgState
     else
     {
         //
-        // Make sure, nobody is in the middle of sending anything
+        // Make sure, nobody is in the middle of sending anything (halting
+        // is interactive, bulk messages of events wait for it), the bulk
+        // link is also locked as the halted cores should not hold its lock
         //
-        SpinlockLock(&DebuggerResponseLock);
+        InterlockedIncrement(&DebuggerInteractiveResponsesPending);
+        SpinlockLockNamed(&DebuggerResponseLock, "kd: debugger response");
+        SpinlockLockNamed(&DebuggerBulkResponseLock, "kd: debugger bulk response");
 
         //
         // Broadcast NMI with the intention of halting cores
@@ -1211,7 +1619,9 @@ KdHandleBreakpointAndDebugBreakpoints(PROCESSOR_DEBUGGING_STATE *       DbgState
         //
         // Unlock the sending response lock to perform regular debugging
         //
+        SpinlockUnlock(&DebuggerBulkResponseLock);
         SpinlockUnlock(&DebuggerResponseLock);
+        InterlockedDecrement(&DebuggerInteractiveResponsesPending);
     }
 
     //
@@ -1309,7 +1719,7 @@ KdHandleNmi(PROCESSOR_DEBUGGING_STATE * DbgState)
     // Lock current core
     //
     DbgState->NmiState.WaitingToBeLocked = FALSE;
-    SpinlockLock(&DbgState->Lock);
+    SpinlockLockNamed(&DbgState->Lock, "kd: core lock (nmi)");
 
     //
     // All the cores should go and manage through the following function
@@ -1550,33 +1960,496 @@ KdRegularStepOver(PROCESSOR_DEBUGGING_STATE * DbgState, BOOLEAN IsNextInstructio
 }
 
 /**
- * @brief Send event registration buffer to user-mode to register the event
- * @param EventDetailHeader
+ * @brief Send the current chunk of the trace of the steps to the debugger
+ *
+ * @param KernelStatus
+ * @param IsLastChunk
  *
  * @return VOID
  */
 VOID
-KdPerformRegisterEvent(PDEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET EventDetailHeader)
+KdStepTraceSendChunk(UINT32 KernelStatus, BOOLEAN IsLastChunk)
 {
-    LogCallbackSendBuffer(OPERATION_DEBUGGEE_REGISTER_EVENT,
-                          ((CHAR *)EventDetailHeader + sizeof(DEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET)),
-                          EventDetailHeader->Length,
-                          TRUE);
+    PDEBUGGEE_STEP_TRACE_RESULT_PACKET ResultPacket = (PDEBUGGEE_STEP_TRACE_RESULT_PACKET)g_KdStepTraceBuffer;
+
+    ResultPacket->SequenceNumber   = g_KdStepTrace.SequenceNumber;
+    ResultPacket->CountOfEntries   = (g_KdStepTrace.ChunkLength - sizeof(DEBUGGEE_STEP_TRACE_RESULT_PACKET)) / g_KdStepTrace.EntrySize;
+    ResultPacket->RecordedRegister = g_KdStepTrace.RecordedRegister;
+    ResultPacket->IsLastChunk      = IsLastChunk;
+    ResultPacket->KernelStatus     = KernelStatus;
+
+    KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
+                               DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_STEP_TRACE,
+                               g_KdStepTraceBuffer,
+                               g_KdStepTrace.ChunkLength);
+
+    //
+    // Start the next chunk
+    //
+    g_KdStepTrace.SequenceNumber++;
+    g_KdStepTrace.ChunkLength = sizeof(DEBUGGEE_STEP_TRACE_RESULT_PACKET);
 }
 
 /**
- * @brief Send action buffer to user-mode to be added to the event
- * @param ActionDetailHeader
+ * @brief Perform a single step of the trace and continue the debuggee
+ *
+ * @param DbgState The state of the debugger on the current core
  *
  * @return VOID
  */
 VOID
-KdPerformAddActionToEvent(PDEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET ActionDetailHeader)
+KdStepTraceStepInstruction(PROCESSOR_DEBUGGING_STATE * DbgState)
 {
-    LogCallbackSendBuffer(OPERATION_DEBUGGEE_ADD_ACTION_TO_EVENT,
-                          ((CHAR *)ActionDetailHeader + sizeof(DEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET)),
-                          ActionDetailHeader->Length,
-                          TRUE);
+    if (g_KdStepTrace.StepType == DEBUGGER_REMOTE_STEPPING_REQUEST_INSTRUMENTATION_STEP_IN)
+    {
+        //
+        // Guaranteed step in (i command), other cores remain halted
+        //
+        KdGuaranteedStepInstruction(DbgState);
+        KdContinueDebuggeeJustCurrentCore(DbgState);
+    }
+    else
+    {
+        //
+        // Step in (t command)
+        //
+        KdRegularStepInInstruction(DbgState);
+        KdContinueDebuggee(DbgState, FALSE, DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_NO_ACTION);
+    }
+}
+
+/**
+ * @brief Start tracing multiple steps in the debuggee
+ * @details the debuggee is not paused once each step is performed,
+ * instead the RIP (and the recorded register) is gathered into the
+ * chunks of the trace, the debuggee is paused once all of the steps
+ * are performed (or once anything other than the step halts it)
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param StepTracePacket
+ *
+ * @return BOOLEAN Returns TRUE if the first step is performed and
+ * the debuggee should be continued
+ */
+BOOLEAN
+KdStepTraceStart(PROCESSOR_DEBUGGING_STATE * DbgState, PDEBUGGEE_STEP_TRACE_PACKET StepTracePacket)
+{
+    g_KdStepTrace.StepType         = StepTracePacket->StepType;
+    g_KdStepTrace.CoreId           = DbgState->CoreId;
+    g_KdStepTrace.RemainingSteps   = StepTracePacket->CountOfSteps;
+    g_KdStepTrace.RecordedRegister = StepTracePacket->RecordedRegister;
+    g_KdStepTrace.ChunkLength      = sizeof(DEBUGGEE_STEP_TRACE_RESULT_PACKET);
+    g_KdStepTrace.SequenceNumber   = 0;
+
+    //
+    // Each entry is the RIP, followed by the value of the recorded register
+    //
+    g_KdStepTrace.EntrySize = StepTracePacket->RecordedRegister == DEBUGGEE_STEP_TRACE_NO_REGISTER ? sizeof(UINT64) : 2 * sizeof(UINT64);
+
+    if ((StepTracePacket->StepType != DEBUGGER_REMOTE_STEPPING_REQUEST_STEP_IN &&
+         StepTracePacket->StepType != DEBUGGER_REMOTE_STEPPING_REQUEST_INSTRUMENTATION_STEP_IN) ||
+        StepTracePacket->CountOfSteps == 0)
+    {
+        //
+        // Step-over is not traced as the debugger checks for the
+        // call instructions of each step-over
+        //
+        KdStepTraceSendChunk(DEBUGGER_ERROR_INVALID_STEP_TRACE_REQUEST, TRUE);
+
+        return FALSE;
+    }
+
+    g_KdStepTrace.IsActive = TRUE;
+
+    KdStepTraceStepInstruction(DbgState);
+
+    return TRUE;
+}
+
+/**
+ * @brief Record the performed step and perform the next step of the trace
+ * @details it's called on the main core before pausing the debuggee
+ *
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return BOOLEAN Returns TRUE if the next step is performed and the
+ * debuggee should be continued without being paused
+ */
+BOOLEAN
+KdStepTraceRecordAndStepAgain(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    UINT64 * Entry;
+
+    if (g_DebuggeeHaltReason != DEBUGGEE_PAUSING_REASON_DEBUGGEE_STEPPED ||
+        DbgState->CoreId != g_KdStepTrace.CoreId)
+    {
+        //
+        // Something other than the step halted the debuggee (e.g., a breakpoint
+        // or an event), so the trace is finished and the debuggee is paused
+        //
+        g_KdStepTrace.IsActive = FALSE;
+        KdStepTraceSendChunk(DEBUGGER_OPERATION_WAS_SUCCESSFUL, TRUE);
+
+        return FALSE;
+    }
+
+    //
+    // Send the chunk if there is no room for the new entry
+    //
+    if (g_KdStepTrace.ChunkLength + g_KdStepTrace.EntrySize > MaxSerialStepTraceChunkSize)
+    {
+        KdStepTraceSendChunk(DEBUGGER_OPERATION_WAS_SUCCESSFUL, FALSE);
+    }
+
+    Entry = (UINT64 *)(g_KdStepTraceBuffer + g_KdStepTrace.ChunkLength);
+
+    Entry[0] = VmFuncGetLastVmexitRip(DbgState->CoreId);
+
+    if (g_KdStepTrace.RecordedRegister != DEBUGGEE_STEP_TRACE_NO_REGISTER)
+    {
+        Entry[1] = DebuggerGetRegValueWrapper(DbgState->Regs, g_KdStepTrace.RecordedRegister);
+    }
+
+    g_KdStepTrace.ChunkLength += g_KdStepTrace.EntrySize;
+    g_KdStepTrace.RemainingSteps--;
+
+    if (g_KdStepTrace.RemainingSteps == 0)
+    {
+        //
+        // All of the steps are performed, the debuggee is paused
+        // after the last chunk is sent
+        //
+        g_KdStepTrace.IsActive = FALSE;
+        KdStepTraceSendChunk(DEBUGGER_OPERATION_WAS_SUCCESSFUL, TRUE);
+
+        return FALSE;
+    }
+
+    KdStepTraceStepInstruction(DbgState);
+
+    return TRUE;
+}
+
+/**
+ * @brief Send the result of running a count of instructions to the debugger
+ *
+ * @param KernelStatus
+ *
+ * @return VOID
+ */
+VOID
+KdInstructionBudgetSendResult(UINT32 KernelStatus)
+{
+    DEBUGGEE_INSTRUCTION_BUDGET_PACKET ResultPacket = {0};
+
+    ResultPacket.CountOfInstructions        = g_KdInstructionBudget.CountOfInstructions;
+    ResultPacket.CountOfCountedInstructions = g_KdInstructionBudget.CountOfCountedInstructions;
+    ResultPacket.CountOfSteppedInstructions = g_KdInstructionBudget.CountOfSteppedInstructions;
+    ResultPacket.IsInterrupted              = !g_KdInstructionBudget.IsFinished;
+    ResultPacket.KernelStatus               = KernelStatus;
+
+    KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
+                               DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_RUN_INSTRUCTIONS,
+                               (CHAR *)&ResultPacket,
+                               sizeof(DEBUGGEE_INSTRUCTION_BUDGET_PACKET));
+}
+
+/**
+ * @brief Start running a count of instructions in the debuggee
+ * @details the instructions are counted by the performance counter of
+ * the retired instructions of the current core (other cores continue
+ * normally) and the last instructions are stepped one by one, so the
+ * debuggee is paused exactly after the instructions
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param BudgetPacket
+ *
+ * @return BOOLEAN Returns TRUE if the debuggee should be continued
+ */
+BOOLEAN
+KdInstructionBudgetStart(PROCESSOR_DEBUGGING_STATE * DbgState, PDEBUGGEE_INSTRUCTION_BUDGET_PACKET BudgetPacket)
+{
+    RtlZeroMemory(&g_KdInstructionBudget, sizeof(KD_INSTRUCTION_BUDGET_STATE));
+
+    g_KdInstructionBudget.CoreId              = DbgState->CoreId;
+    g_KdInstructionBudget.CountOfInstructions = BudgetPacket->CountOfInstructions;
+
+    if (BudgetPacket->CountOfInstructions == 0)
+    {
+        KdInstructionBudgetSendResult(DEBUGGER_ERROR_INVALID_INSTRUCTION_BUDGET);
+        return FALSE;
+    }
+
+    if (BudgetPacket->CountOfInstructions <= DEBUGGEE_INSTRUCTION_BUDGET_STEPPED_INSTRUCTIONS)
+    {
+        //
+        // Not worth counting, all of the instructions are stepped
+        //
+        g_KdInstructionBudget.RemainingSteps = BudgetPacket->CountOfInstructions;
+    }
+    else if (!VmFuncArmInstructionCounter(DbgState->CoreId,
+                                          BudgetPacket->CountOfInstructions - DEBUGGEE_INSTRUCTION_BUDGET_STEPPED_INSTRUCTIONS))
+    {
+        KdInstructionBudgetSendResult(DEBUGGER_ERROR_INSTRUCTION_COUNTER_IS_NOT_AVAILABLE);
+        return FALSE;
+    }
+
+    g_KdInstructionBudget.IsActive = TRUE;
+
+    KdContinueDebuggee(DbgState, FALSE, DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_NO_ACTION);
+
+    //
+    // The interrupts of the current core are disabled while stepping (the
+    // debuggee is continued first, so they're not enabled again)
+    //
+    if (g_KdInstructionBudget.RemainingSteps != 0)
+    {
+        KdGuaranteedStepInstruction(DbgState);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Count the performed step of running a count of instructions and
+ * perform the next step
+ * @details it's called once the step is performed and before pausing the
+ * debuggee
+ *
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return BOOLEAN Returns TRUE if the next step is performed and the
+ * debuggee should be continued without being paused
+ */
+BOOLEAN
+KdInstructionBudgetStepAgain(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    if (!g_KdInstructionBudget.IsActive ||
+        g_KdInstructionBudget.RemainingSteps == 0 ||
+        DbgState->CoreId != g_KdInstructionBudget.CoreId)
+    {
+        return FALSE;
+    }
+
+    g_KdInstructionBudget.CountOfSteppedInstructions++;
+    g_KdInstructionBudget.RemainingSteps--;
+
+    if (g_KdInstructionBudget.RemainingSteps == 0)
+    {
+        //
+        // All of the instructions are executed, the debuggee is paused
+        //
+        g_KdInstructionBudget.IsFinished = TRUE;
+
+        return FALSE;
+    }
+
+    KdGuaranteedStepInstruction(DbgState);
+
+    return TRUE;
+}
+
+/**
+ * @brief Handle the overflow of the counter of the retired instructions
+ * @details This function can be used in vmx-root, the counter is already
+ * disarmed
+ *
+ * @param CoreId
+ * @param CountOfExecutedInstructions
+ *
+ * @return VOID
+ */
+_Use_decl_annotations_
+VOID
+KdHandleInstructionCounterOverflow(UINT32 CoreId, UINT64 CountOfExecutedInstructions)
+{
+    DEBUGGER_TRIGGERED_EVENT_DETAILS ContextAndTag = {0};
+    PROCESSOR_DEBUGGING_STATE *      DbgState      = &g_DbgState[CoreId];
+
+    if (!g_KdInstructionBudget.IsActive || CoreId != g_KdInstructionBudget.CoreId)
+    {
+        return;
+    }
+
+    g_KdInstructionBudget.CountOfCountedInstructions = CountOfExecutedInstructions;
+
+    if (CountOfExecutedInstructions < g_KdInstructionBudget.CountOfInstructions)
+    {
+        //
+        // Step the remaining instructions one by one
+        //
+        g_KdInstructionBudget.RemainingSteps = g_KdInstructionBudget.CountOfInstructions - CountOfExecutedInstructions;
+
+        KdGuaranteedStepInstruction(DbgState);
+
+        return;
+    }
+
+    //
+    // The overflow is delivered later than the stepped instructions (too
+    // much skid), so the debuggee is paused after more instructions
+    //
+    g_KdInstructionBudget.IsFinished = TRUE;
+
+    ContextAndTag.Context = VmFuncGetLastVmexitRip(CoreId);
+    KdHandleBreakpointAndDebugBreakpoints(DbgState,
+                                          DEBUGGEE_PAUSING_REASON_DEBUGGEE_STEPPED,
+                                          &ContextAndTag);
+}
+
+/**
+ * @brief Measure the frequency of the time-stamp counter for the
+ * watchdog of the halts
+ * @details This function should be called on vmx non-root
+ *
+ * @return VOID
+ */
+VOID
+KdHaltWatchdogMeasureTscFrequency()
+{
+    KIRQL         OldIrql;
+    LARGE_INTEGER Frequency;
+    LARGE_INTEGER StartCounter;
+    LARGE_INTEGER EndCounter;
+    UINT64        StartTsc;
+    UINT64        EndTsc;
+
+    //
+    // Stay on this core while the time-stamp counter is measured
+    //
+    OldIrql = KeRaiseIrqlToDpcLevel();
+
+    StartCounter = KeQueryPerformanceCounter(&Frequency);
+    StartTsc     = __rdtsc();
+
+    KeStallExecutionProcessor(KD_HALT_WATCHDOG_MEASUREMENT_INTERVAL);
+
+    EndTsc     = __rdtsc();
+    EndCounter = KeQueryPerformanceCounter(NULL);
+
+    KeLowerIrql(OldIrql);
+
+    g_KdHaltWatchdog.TscPerMillisecond = ((EndTsc - StartTsc) * Frequency.QuadPart) /
+                                         ((EndCounter.QuadPart - StartCounter.QuadPart) * 1000);
+}
+
+/**
+ * @brief Get the deadline of waiting for the next command of the debugger
+ *
+ * @return UINT64 The time-stamp counter that the halted debuggee is
+ * continued at, or zero if the watchdog is disabled
+ */
+UINT64
+KdHaltWatchdogGetDeadline()
+{
+    if (g_KdHaltWatchdog.Timeout == 0 || g_KdHaltWatchdog.TscPerMillisecond == 0)
+    {
+        return 0;
+    }
+
+    return __rdtsc() + g_KdHaltWatchdog.Timeout * g_KdHaltWatchdog.TscPerMillisecond;
+}
+
+/**
+ * @brief Set or query the watchdog of the halts
+ * @param HaltWatchdogRequest
+ *
+ * @return VOID
+ */
+VOID
+KdHaltWatchdogPerformRequest(PDEBUGGER_HALT_WATCHDOG_REQUEST HaltWatchdogRequest)
+{
+    if (!HaltWatchdogRequest->IsQuery)
+    {
+        g_KdHaltWatchdog.Timeout = HaltWatchdogRequest->Timeout;
+    }
+
+    HaltWatchdogRequest->Timeout         = g_KdHaltWatchdog.Timeout;
+    HaltWatchdogRequest->CountOfTimeouts = g_KdHaltWatchdog.CountOfTimeouts;
+    HaltWatchdogRequest->LastTimeoutTsc  = g_KdHaltWatchdog.LastTimeoutTsc;
+    HaltWatchdogRequest->KernelStatus    = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+}
+
+/**
+ * @brief Continue the debuggee as there was no command from the debugger
+ * until the deadline of the watchdog
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return VOID
+ */
+VOID
+KdHaltWatchdogContinueDebuggee(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    DEBUGGER_HALT_WATCHDOG_REQUEST HaltWatchdogPacket = {0};
+
+    //
+    // Record the timeout
+    //
+    g_KdHaltWatchdog.CountOfTimeouts++;
+    g_KdHaltWatchdog.LastTimeoutTsc = LogReadTimestamp();
+
+    HaltWatchdogPacket.IsQuery = TRUE;
+    KdHaltWatchdogPerformRequest(&HaltWatchdogPacket);
+
+    //
+    // Notify the debugger (if it's still connected) that the debuggee is
+    // running
+    //
+    KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
+                               DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_CONTINUED_BY_HALT_WATCHDOG,
+                               (unsigned char *)&HaltWatchdogPacket,
+                               SIZEOF_DEBUGGER_HALT_WATCHDOG_REQUEST);
+
+    //
+    // Unlock other cores
+    //
+    KdContinueDebuggee(DbgState, FALSE, DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_NO_ACTION);
+}
+
+/**
+ * @brief Send event registration buffer to user-mode to register the event
+ * @param EventDetailHeader
+ *
+ * @return VOID
+ */
+VOID
+KdPerformRegisterEvent(PDEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET EventDetailHeader)
+{
+    LogCallbackSendBuffer(OPERATION_DEBUGGEE_REGISTER_EVENT,
+                          ((CHAR *)EventDetailHeader + sizeof(DEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET)),
+                          EventDetailHeader->Length,
+                          TRUE);
+}
+
+/**
+ * @brief Send action buffer to user-mode to be added to the event
+ * @param ActionDetailHeader
+ *
+ * @return VOID
+ */
+VOID
+KdPerformAddActionToEvent(PDEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET ActionDetailHeader)
+{
+    LogCallbackSendBuffer(OPERATION_DEBUGGEE_ADD_ACTION_TO_EVENT,
+                          ((CHAR *)ActionDetailHeader + sizeof(DEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET)),
+                          ActionDetailHeader->Length,
+                          TRUE);
+}
+
+/**
+ * @brief Send the buffer of a batch of events to user-mode to register
+ * the events and actions
+ * @param EventsBatchRequest
+ *
+ * @return VOID
+ */
+VOID
+KdPerformRegisterEventsBatch(PDEBUGGER_EVENTS_BATCH_REQUEST EventsBatchRequest)
+{
+    LogCallbackSendBuffer(OPERATION_DEBUGGEE_REGISTER_EVENTS_BATCH,
+                          EventsBatchRequest,
+                          SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST + EventsBatchRequest->EntriesBufferSize,
+                          TRUE);
 }
 
 /**
@@ -1713,6 +2586,8 @@ KdPerformEventQueryAndModification(PDEBUGGER_MODIFY_EVENTS ModifyAndQueryEvent)
                 ModifyAndQueryEvent->IsEnabled = FALSE;
             }
 
+            DebuggerQueryScriptStatisticsOfEvent(ModifyAndQueryEvent->Tag, &ModifyAndQueryEvent->ScriptStatistics);
+
             //
             // The function was successful
             //
@@ -1737,49 +2612,321 @@ KdPerformEventQueryAndModification(PDEBUGGER_MODIFY_EVENTS ModifyAndQueryEvent)
         }
 
         //
-        // The function was successful
+        // The function was successful
+        //
+        ModifyAndQueryEvent->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+    }
+    else if (ModifyAndQueryEvent->TypeOfAction == DEBUGGER_MODIFY_EVENTS_DISABLE)
+    {
+        if (IsForAllEvents)
+        {
+            //
+            // Disable all events
+            //
+            DebuggerEnableOrDisableAllEvents(FALSE);
+        }
+        else
+        {
+            //
+            // Disable just one event
+            //
+            DebuggerDisableEvent(ModifyAndQueryEvent->Tag);
+        }
+
+        //
+        // The function was successful
+        //
+        ModifyAndQueryEvent->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+    }
+    else if (ModifyAndQueryEvent->TypeOfAction == DEBUGGER_MODIFY_EVENTS_SET_OUTPUT)
+    {
+        //
+        // Set whether the messages of the event are generated
+        //
+        if (DebuggerSetEventOutputState(ModifyAndQueryEvent->Tag, ModifyAndQueryEvent->IsEnabled))
+        {
+            ModifyAndQueryEvent->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+        }
+        else
+        {
+            ModifyAndQueryEvent->KernelStatus = DEBUGGER_ERROR_TAG_NOT_EXISTS;
+        }
+    }
+    else if (ModifyAndQueryEvent->TypeOfAction == DEBUGGER_MODIFY_EVENTS_CLEAR ||
+             ModifyAndQueryEvent->TypeOfAction == DEBUGGER_MODIFY_EVENTS_ADD_MONITOR_RANGE ||
+             ModifyAndQueryEvent->TypeOfAction == DEBUGGER_MODIFY_EVENTS_REMOVE_MONITOR_RANGE)
+    {
+        //
+        // Send one byte buffer and operation codes (the ranges of monitor
+        // events are also modified in vmx non-root as their pages are hooked)
+        //
+        LogCallbackSendBuffer(OPERATION_DEBUGGEE_CLEAR_EVENTS,
+                              ModifyAndQueryEvent,
+                              sizeof(DEBUGGER_MODIFY_EVENTS),
+                              TRUE);
+    }
+    else
+    {
+        //
+        // Invalid parameter specifed in Action
+        //
+        ModifyAndQueryEvent->KernelStatus = DEBUGGER_ERROR_MODIFY_EVENTS_INVALID_TYPE_OF_ACTION;
+    }
+}
+
+/**
+ * @brief Perform a batch of requests and send all of the results
+ * back to the debugger in a single packet
+ * @details the requests are performed in order, only the requests that
+ * don't change the state of the debuggee are allowed in a batch
+ * @param DbgState The state of the debugger on the current core
+ * @param BatchPacket
+ * @param BatchLength Length of the batch (including its header)
+ *
+ * @return VOID
+ */
+VOID
+KdPerformBatchRequests(PROCESSOR_DEBUGGING_STATE *     DbgState,
+                       PDEBUGGEE_BATCH_REQUESTS_PACKET BatchPacket,
+                       UINT32                          BatchLength)
+{
+    PDEBUGGEE_BATCH_REQUESTS_PACKET     ResultsPacket     = (PDEBUGGEE_BATCH_REQUESTS_PACKET)g_KdBatchResultsBuffer;
+    PDEBUGGEE_BATCH_REQUEST_ENTRY       Request           = NULL;
+    PDEBUGGEE_BATCH_REQUEST_ENTRY       Result            = NULL;
+    PDEBUGGEE_REGISTER_READ_DESCRIPTION ReadRegisterEntry = NULL;
+    PVOID                               Payload           = NULL;
+    UINT32                              RequestOffset     = sizeof(DEBUGGEE_BATCH_REQUESTS_PACKET);
+    UINT32                              ResultOffset      = sizeof(DEBUGGEE_BATCH_REQUESTS_PACKET);
+    UINT32                              RequestLength     = 0;
+    UINT32                              ResultLength      = 0;
+    UINT32                              CountOfRequests   = 0;
+    UINT32                              Index             = 0;
+
+    ResultsPacket->CountOfRequests = 0;
+    ResultsPacket->KernelStatus    = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    //
+    // Check whether the header of the batch is received
+    //
+    if (BatchLength >= sizeof(DEBUGGEE_BATCH_REQUESTS_PACKET) && BatchLength <= MaxSerialBatchRequestsSize)
+    {
+        CountOfRequests = BatchPacket->CountOfRequests;
+    }
+    else
+    {
+        ResultsPacket->KernelStatus = DEBUGGER_ERROR_INVALID_BATCH_REQUEST;
+    }
+
+    for (Index = 0; Index < CountOfRequests; Index++)
+    {
+        //
+        // Check whether the request is inside the received buffer
+        //
+        if (RequestOffset + sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY) > BatchLength)
+        {
+            ResultsPacket->KernelStatus = DEBUGGER_ERROR_INVALID_BATCH_REQUEST;
+            break;
+        }
+
+        Request = (PDEBUGGEE_BATCH_REQUEST_ENTRY)((CHAR *)BatchPacket + RequestOffset);
+
+        if (Request->Length > BatchLength - RequestOffset - sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY))
+        {
+            ResultsPacket->KernelStatus = DEBUGGER_ERROR_INVALID_BATCH_REQUEST;
+            break;
+        }
+
+        //
+        // Compute the size of the request and its result, the results of the
+        // requests are the same structures as the requests (the result of reading
+        // all of the registers contains the registers after it)
+        //
+        switch (Request->RequestedAction)
+        {
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_READ_REGISTERS:
+
+            RequestLength = sizeof(DEBUGGEE_REGISTER_READ_DESCRIPTION);
+            ResultLength  = sizeof(DEBUGGEE_REGISTER_READ_DESCRIPTION);
+
+            if (Request->Length == RequestLength &&
+                ((PDEBUGGEE_REGISTER_READ_DESCRIPTION)(Request + 1))->RegisterID == DEBUGGEE_SHOW_ALL_REGISTERS)
+            {
+                ResultLength += sizeof(GUEST_REGS) + sizeof(GUEST_EXTRA_REGISTERS);
+            }
+
+            break;
+
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_SYMBOL_QUERY_PTE:
+
+            RequestLength = sizeof(DEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS);
+            ResultLength  = sizeof(DEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS);
+            break;
+
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_QUERY_PA2VA_AND_VA2PA:
+
+            RequestLength = sizeof(DEBUGGER_VA2PA_AND_PA2VA_COMMANDS);
+            ResultLength  = sizeof(DEBUGGER_VA2PA_AND_PA2VA_COMMANDS);
+            break;
+
+        default:
+
+            //
+            // Other requests are not allowed in a batch
+            //
+            RequestLength = 0;
+            ResultLength  = 0;
+            break;
+        }
+
+        //
+        // Check whether the result fits in the buffer of results
         //
-        ModifyAndQueryEvent->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
-    }
-    else if (ModifyAndQueryEvent->TypeOfAction == DEBUGGER_MODIFY_EVENTS_DISABLE)
-    {
-        if (IsForAllEvents)
+        if (ResultOffset + sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY) + ResultLength > MaxSerialBatchRequestsSize)
+        {
+            ResultsPacket->KernelStatus = DEBUGGER_ERROR_INVALID_BATCH_REQUEST;
+            break;
+        }
+
+        Result  = (PDEBUGGEE_BATCH_REQUEST_ENTRY)(g_KdBatchResultsBuffer + ResultOffset);
+        Payload = (PVOID)(Result + 1);
+
+        Result->RequestId    = Request->RequestId;
+        Result->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+        if (ResultLength == 0 || Request->Length != RequestLength)
         {
             //
-            // Disable all events
+            // The request is not allowed in a batch (or it's malformed)
             //
-            DebuggerEnableOrDisableAllEvents(FALSE);
+            Result->RequestedAction = DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_NO_ACTION;
+            Result->Length          = 0;
+            Result->KernelStatus    = DEBUGGER_ERROR_INVALID_BATCH_REQUEST;
         }
         else
         {
             //
-            // Disable just one event
+            // The request is performed in the buffer of the results
             //
-            DebuggerDisableEvent(ModifyAndQueryEvent->Tag);
+            RtlZeroMemory(Payload, ResultLength);
+            memcpy(Payload, (PVOID)(Request + 1), Request->Length);
+
+            Result->Length = ResultLength;
+
+            switch (Request->RequestedAction)
+            {
+            case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_READ_REGISTERS:
+
+                ReadRegisterEntry = (PDEBUGGEE_REGISTER_READ_DESCRIPTION)Payload;
+
+                if (KdReadRegisters(DbgState, ReadRegisterEntry, &ResultLength))
+                {
+                    ReadRegisterEntry->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+                }
+                else
+                {
+                    ReadRegisterEntry->KernelStatus = DEBUGGER_ERROR_INVALID_REGISTER_NUMBER;
+                }
+
+                //
+                // Only the changed registers might be sent
+                //
+                Result->Length = ResultLength;
+
+                Result->RequestedAction = DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_READING_REGISTERS;
+
+                break;
+
+            case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_SYMBOL_QUERY_PTE:
+
+                ExtensionCommandPte((PDEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS)Payload, TRUE);
+
+                Result->RequestedAction = DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_PTE;
+
+                break;
+
+            case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_QUERY_PA2VA_AND_VA2PA:
+
+                ExtensionCommandVa2paAndPa2va((PDEBUGGER_VA2PA_AND_PA2VA_COMMANDS)Payload, TRUE);
+
+                Result->RequestedAction = DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_VA2PA_AND_PA2VA;
+
+                break;
+
+            default:
+                break;
+            }
         }
 
         //
-        // The function was successful
+        // Go to the next request (and the next result)
         //
-        ModifyAndQueryEvent->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+        RequestOffset += sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY) + Request->Length;
+
+        ResultOffset += sizeof(DEBUGGEE_BATCH_REQUEST_ENTRY) + Result->Length;
+
+        ResultsPacket->CountOfRequests++;
     }
-    else if (ModifyAndQueryEvent->TypeOfAction == DEBUGGER_MODIFY_EVENTS_CLEAR)
+
+    //
+    // Send all of the results back to the debugger
+    //
+    KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
+                               DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_BATCH_REQUESTS,
+                               g_KdBatchResultsBuffer,
+                               ResultOffset);
+}
+
+/**
+ * @brief Check the payload of a transport test packet and send back
+ * the requested payload to the debugger
+ * @details the result is built in place of the received packet (the
+ * receiving buffer is large enough for the maximum payload)
+ * @param TransportTestPacket
+ * @param PacketLength Length of the received packet (including its header)
+ *
+ * @return VOID
+ */
+VOID
+KdPerformTransportTest(PDEBUGGEE_TRANSPORT_TEST_PACKET TransportTestPacket, UINT32 PacketLength)
+{
+    UINT8 * Payload = (UINT8 *)TransportTestPacket + sizeof(DEBUGGEE_TRANSPORT_TEST_PACKET);
+
+    TransportTestPacket->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    if (PacketLength < sizeof(DEBUGGEE_TRANSPORT_TEST_PACKET) ||
+        TransportTestPacket->PayloadLength != PacketLength - sizeof(DEBUGGEE_TRANSPORT_TEST_PACKET) ||
+        TransportTestPacket->ResponseLength > MaxSerialTransportTestPayloadSize)
     {
-        //
-        // Send one byte buffer and operation codes
-        //
-        LogCallbackSendBuffer(OPERATION_DEBUGGEE_CLEAR_EVENTS,
-                              ModifyAndQueryEvent,
-                              sizeof(DEBUGGER_MODIFY_EVENTS),
-                              TRUE);
+        TransportTestPacket->KernelStatus   = DEBUGGER_ERROR_TRANSPORT_TEST_PAYLOAD_MISMATCH;
+        TransportTestPacket->ResponseLength = 0;
     }
     else
     {
         //
-        // Invalid parameter specifed in Action
+        // Check the payload of the debugger
         //
-        ModifyAndQueryEvent->KernelStatus = DEBUGGER_ERROR_MODIFY_EVENTS_INVALID_TYPE_OF_ACTION;
+        for (UINT32 i = 0; i < TransportTestPacket->PayloadLength; i++)
+        {
+            if (Payload[i] != DEBUGGEE_TRANSPORT_TEST_PATTERN(TransportTestPacket->SequenceNumber, i))
+            {
+                TransportTestPacket->KernelStatus = DEBUGGER_ERROR_TRANSPORT_TEST_PAYLOAD_MISMATCH;
+                break;
+            }
+        }
     }
+
+    //
+    // Make the payload of the result
+    //
+    for (UINT32 i = 0; i < TransportTestPacket->ResponseLength; i++)
+    {
+        Payload[i] = DEBUGGEE_TRANSPORT_TEST_PATTERN(TransportTestPacket->SequenceNumber, i);
+    }
+
+    KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
+                               DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_TRANSPORT_TEST,
+                               (CHAR *)TransportTestPacket,
+                               sizeof(DEBUGGEE_TRANSPORT_TEST_PACKET) + TransportTestPacket->ResponseLength);
 }
 
 /**
@@ -1794,6 +2941,8 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
 {
     PDEBUGGEE_CHANGE_CORE_PACKET                        ChangeCorePacket;
     PDEBUGGEE_STEP_PACKET                               SteppingPacket;
+    PDEBUGGEE_STEP_TRACE_PACKET                         StepTracePacket;
+    PDEBUGGEE_INSTRUCTION_BUDGET_PACKET                 BudgetPacket;
     PDEBUGGER_FLUSH_LOGGING_BUFFERS                     FlushPacket;
     PDEBUGGER_CALLSTACK_REQUEST                         CallstackPacket;
     PDEBUGGER_SINGLE_CALLSTACK_FRAME                    CallstackFrameBuffer;
@@ -1815,9 +2964,15 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
     PDEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET AddActionPacket;
     PDEBUGGER_MODIFY_EVENTS                             QueryAndModifyEventPacket;
     PDEBUGGER_SHORT_CIRCUITING_EVENT                    ShortCircuitingEventPacket;
+    PDEBUGGEE_BATCH_REQUESTS_PACKET                     BatchRequestsPacket;
+    PDEBUGGEE_TRANSPORT_TEST_PACKET                     TransportTestPacket;
+    PDEBUGGER_PATCH_MEMORY_REQUEST                      PatchMemoryPacket;
+    PDEBUGGER_EPT_SNAPSHOT_REQUEST                      EptSnapshotPacket;
+    PDEBUGGER_HALT_WATCHDOG_REQUEST                     HaltWatchdogPacket;
+    PDEBUGGER_EVENTS_BATCH_REQUEST                      EventsBatchPacket;
+    PDEBUGGER_QUERY_EVENTS_STATISTICS                   EventsStatisticsPacket;
     UINT32                                              SizeToSend         = 0;
     BOOLEAN                                             UnlockTheNewCore   = FALSE;
-    size_t                                              ReturnSize         = 0;
     DEBUGGEE_RESULT_OF_SEARCH_PACKET                    SearchPacketResult = {0};
 
     while (TRUE)
@@ -1825,6 +2980,7 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
         BOOLEAN                 EscapeFromTheLoop = FALSE;
         CHAR *                  RecvBuffer        = &DbgState->KdRecvBuffer[0];
         UINT32                  RecvBufferLength  = 0;
+        UINT64                  Deadline          = KdHaltWatchdogGetDeadline();
         PDEBUGGER_REMOTE_PACKET TheActualPacket   = (PDEBUGGER_REMOTE_PACKET)RecvBuffer;
 
         //
@@ -1835,8 +2991,18 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
         //
         // Receive the buffer in polling mode
         //
-        if (!SerialConnectionRecvBuffer(RecvBuffer, &RecvBufferLength))
+        if (!SerialConnectionRecvBuffer(RecvBuffer, &RecvBufferLength, Deadline))
         {
+            if (Deadline != 0 && RecvBufferLength == 0 && __rdtsc() >= Deadline)
+            {
+                //
+                // No command is received from the debugger (e.g., the link is
+                // dropped), so the debuggee is continued by the watchdog
+                //
+                KdHaltWatchdogContinueDebuggee(DbgState);
+                break;
+            }
+
             //
             // Invalid buffer
             //
@@ -1970,6 +3136,42 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
 
                 break;
 
+            case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_STEP_AND_TRACE:
+
+                StepTracePacket = (DEBUGGEE_STEP_TRACE_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+                //
+                // Perform the first step, the next steps are performed
+                // without waiting for new commands
+                //
+                if (KdStepTraceStart(DbgState, StepTracePacket))
+                {
+                    //
+                    // Continue to the debuggee
+                    //
+                    EscapeFromTheLoop = TRUE;
+                }
+
+                break;
+
+            case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_RUN_INSTRUCTIONS:
+
+                BudgetPacket = (DEBUGGEE_INSTRUCTION_BUDGET_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+                //
+                // Start counting (or stepping) the instructions, the debuggee
+                // is paused once all of them are executed
+                //
+                if (KdInstructionBudgetStart(DbgState, BudgetPacket))
+                {
+                    //
+                    // Continue to the debuggee
+                    //
+                    EscapeFromTheLoop = TRUE;
+                }
+
+                break;
+
             case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_CLOSE_AND_UNLOAD_DEBUGGEE:
 
                 //
@@ -2070,11 +3272,15 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
                 CallstackFrameBuffer = (DEBUGGER_SINGLE_CALLSTACK_FRAME *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET) + sizeof(DEBUGGER_CALLSTACK_REQUEST));
 
                 //
-                // If the address is null, we use the current RSP register
+                // If the address is null, we use the current RSP register (the
+                // stack is also unwound in this case)
                 //
+                CallstackPacket->IsUnwound = FALSE;
+
                 if (CallstackPacket->BaseAddress == NULL)
                 {
                     CallstackPacket->BaseAddress = DbgState->Regs->rsp;
+                    CallstackPacket->IsUnwound   = !CallstackPacket->Is32Bit;
                 }
 
                 //
@@ -2085,6 +3291,18 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
                                               CallstackPacket->Size,
                                               CallstackPacket->Is32Bit))
                 {
+                    //
+                    // The exact return addresses are marked from the unwind info
+                    // of the modules, otherwise the scanned values are shown
+                    //
+                    if (CallstackPacket->IsUnwound)
+                    {
+                        CallstackPacket->IsUnwound = CallstackMarkUnwoundReturnAddresses(DbgState,
+                                                                                         CallstackFrameBuffer,
+                                                                                         CallstackPacket->BaseAddress,
+                                                                                         CallstackPacket->Size);
+                    }
+
                     CallstackPacket->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
                 }
                 else
@@ -2181,7 +3399,7 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
                 //
                 // Read registers
                 //
-                if (KdReadRegisters(DbgState, ReadRegisterPacket))
+                if (KdReadRegisters(DbgState, ReadRegisterPacket, &SizeToSend))
                 {
                     ReadRegisterPacket->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
                 }
@@ -2190,14 +3408,6 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
                     ReadRegisterPacket->KernelStatus = DEBUGGER_ERROR_INVALID_REGISTER_NUMBER;
                 }
 
-                if (ReadRegisterPacket->RegisterID == DEBUGGEE_SHOW_ALL_REGISTERS)
-                {
-                    SizeToSend = sizeof(DEBUGGEE_REGISTER_READ_DESCRIPTION) + sizeof(GUEST_REGS) + sizeof(GUEST_EXTRA_REGISTERS);
-                }
-                else
-                {
-                    SizeToSend = sizeof(DEBUGGEE_REGISTER_READ_DESCRIPTION);
-                }
                 //
                 // Send the result of reading registers back to the debuggee
                 //
@@ -2211,29 +3421,11 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
             case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_READ_MEMORY:
 
                 ReadMemoryPacket = (DEBUGGER_READ_MEMORY *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
-                //
-                // Read memory
-                //
-                if (DebuggerCommandReadMemoryVmxRoot(ReadMemoryPacket,
-                                                     (PVOID)((UINT64)ReadMemoryPacket + sizeof(DEBUGGER_READ_MEMORY)),
-                                                     &ReturnSize))
-                {
-                    ReadMemoryPacket->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
-                }
-                else
-                {
-                    ReadMemoryPacket->KernelStatus = DEBUGGER_ERROR_INVALID_ADDRESS;
-                }
-
-                ReadMemoryPacket->ReturnLength = ReturnSize;
 
                 //
-                // Send the result of reading memory back to the debuggee
+                // Read memory and send it back to the debugger
                 //
-                KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
-                                           DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_READING_MEMORY,
-                                           (unsigned char *)ReadMemoryPacket,
-                                           sizeof(DEBUGGER_READ_MEMORY) + ReturnSize);
+                KdReadMemoryAndSendChunks(ReadMemoryPacket);
 
                 break;
 
@@ -2262,10 +3454,85 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
 
                 break;
 
+            case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_PATCH_MEMORY:
+
+                PatchMemoryPacket = (PDEBUGGER_PATCH_MEMORY_REQUEST)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+                //
+                // Apply the patches
+                //
+                DebuggerCommandPatchMemory(PatchMemoryPacket, RecvBufferLength - sizeof(DEBUGGER_REMOTE_PACKET), TRUE);
+
+                //
+                // Send the result of patching memory back to the debugger
+                //
+                KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
+                                           DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_PATCHING_MEMORY,
+                                           (unsigned char *)PatchMemoryPacket,
+                                           SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST);
+
+                break;
+
+            case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_EPT_SNAPSHOT:
+
+                EptSnapshotPacket = (PDEBUGGER_EPT_SNAPSHOT_REQUEST)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+                //
+                // Perform the action of the snapshot on this core
+                //
+                ConfigureEptSnapshot(EptSnapshotPacket);
+
+                //
+                // The protection of the pages is changed, so the other cores
+                // should invalidate their caches of EPT once they're continued
+                //
+                if (EptSnapshotPacket->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL &&
+                    EptSnapshotPacket->Action != DEBUGGER_EPT_SNAPSHOT_ACTION_QUERY)
+                {
+                    for (UINT32 i = 0; i < KeQueryActiveProcessorCount(0); i++)
+                    {
+                        g_DbgState[i].InvalidateEptOnContinue = TRUE;
+                    }
+                }
+
+                //
+                // Send the result of the snapshot back to the debugger
+                //
+                KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
+                                           DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_EPT_SNAPSHOT,
+                                           (unsigned char *)EptSnapshotPacket,
+                                           SIZEOF_DEBUGGER_EPT_SNAPSHOT_REQUEST);
+
+                break;
+
+            case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_HALT_WATCHDOG:
+
+                HaltWatchdogPacket = (PDEBUGGER_HALT_WATCHDOG_REQUEST)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+                //
+                // Set or query the watchdog (the new timeout is used from the next command)
+                //
+                KdHaltWatchdogPerformRequest(HaltWatchdogPacket);
+
+                //
+                // Send the result of the watchdog back to the debugger
+                //
+                KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
+                                           DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_HALT_WATCHDOG,
+                                           (unsigned char *)HaltWatchdogPacket,
+                                           SIZEOF_DEBUGGER_HALT_WATCHDOG_REQUEST);
+
+                break;
+
             case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_CHANGE_PROCESS:
 
                 ChangeProcessPacket = (DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
 
+                //
+                // Only the queries of the process list send entries after the packet
+                //
+                ChangeProcessPacket->CountOfEntries = 0;
+
                 //
                 // Interpret the process packet
                 //
@@ -2277,7 +3544,8 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
                 KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
                                            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_CHANGING_PROCESS,
                                            ChangeProcessPacket,
-                                           sizeof(DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET));
+                                           sizeof(DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET) +
+                                               ChangeProcessPacket->CountOfEntries * sizeof(DEBUGGEE_PROCESS_LIST_DETAILS_ENTRY));
 
                 break;
 
@@ -2285,6 +3553,11 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
 
                 ChangeThreadPacket = (DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
 
+                //
+                // Only the queries of the thread list send entries after the packet
+                //
+                ChangeThreadPacket->CountOfEntries = 0;
+
                 //
                 // Interpret the thread packet
                 //
@@ -2296,7 +3569,8 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
                 KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
                                            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_CHANGING_THREAD,
                                            ChangeThreadPacket,
-                                           sizeof(DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET));
+                                           sizeof(DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET) +
+                                               ChangeThreadPacket->CountOfEntries * sizeof(DEBUGGEE_THREAD_LIST_DETAILS_ENTRY));
 
                 break;
 
@@ -2311,6 +3585,7 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
                                              OPERATION_LOG_INFO_MESSAGE /* simple print */,
                                              NULL,
                                              ScriptPacket,
+                                             FALSE,
                                              g_DebuggeeHaltContext))
                 {
                     //
@@ -2427,6 +3702,59 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
 
                 break;
 
+            case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_REGISTER_EVENTS_BATCH:
+
+                EventsBatchPacket = (PDEBUGGER_EVENTS_BATCH_REQUEST)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+                //
+                // The stream of entries should be in the received packet
+                //
+                if (EventsBatchPacket->EntriesBufferSize > RecvBufferLength - sizeof(DEBUGGER_REMOTE_PACKET) - SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST)
+                {
+                    EventsBatchPacket->CountOfAppliedEntries = 0;
+                    EventsBatchPacket->KernelStatus          = DEBUGGER_ERROR_INVALID_EVENTS_BATCH;
+
+                    KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
+                                               DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_REGISTERING_EVENTS_BATCH,
+                                               (unsigned char *)EventsBatchPacket,
+                                               SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST);
+                    break;
+                }
+
+                //
+                // Send the batch of events to user-mode debuggee (all of the
+                // events and actions are registered at once)
+                //
+                KdPerformRegisterEventsBatch(EventsBatchPacket);
+
+                //
+                // Continue Debuggee
+                //
+                KdContinueDebuggee(DbgState, TRUE, DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_REGISTERING_EVENTS_BATCH);
+                EscapeFromTheLoop = TRUE;
+
+                break;
+
+            case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_QUERY_EVENTS_STATISTICS:
+
+                EventsStatisticsPacket = (PDEBUGGER_QUERY_EVENTS_STATISTICS)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+                //
+                // The entries are filled in the received buffer (it's large enough
+                // for all of the entries)
+                //
+                DebuggerQueryEventsStatistics(EventsStatisticsPacket);
+
+                //
+                // Send only the filled entries back to the debugger
+                //
+                KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
+                                           DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_QUERY_EVENTS_STATISTICS,
+                                           (unsigned char *)EventsStatisticsPacket,
+                                           SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS_HEADER + EventsStatisticsPacket->CountOfEvents * sizeof(DEBUGGER_EVENT_STATISTICS));
+
+                break;
+
             case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_QUERY_AND_MODIFY_EVENT:
 
                 QueryAndModifyEventPacket = (DEBUGGER_MODIFY_EVENTS *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
@@ -2437,9 +3765,12 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
                 KdPerformEventQueryAndModification(QueryAndModifyEventPacket);
 
                 //
-                // Only continue debuggee if it's a clear event action
+                // Only continue debuggee if it's a clear event action (or modifying
+                // the ranges of a monitor event), as they're performed in vmx non-root
                 //
-                if (QueryAndModifyEventPacket->TypeOfAction == DEBUGGER_MODIFY_EVENTS_CLEAR)
+                if (QueryAndModifyEventPacket->TypeOfAction == DEBUGGER_MODIFY_EVENTS_CLEAR ||
+                    QueryAndModifyEventPacket->TypeOfAction == DEBUGGER_MODIFY_EVENTS_ADD_MONITOR_RANGE ||
+                    QueryAndModifyEventPacket->TypeOfAction == DEBUGGER_MODIFY_EVENTS_REMOVE_MONITOR_RANGE)
                 {
                     //
                     // Continue Debuggee
@@ -2537,6 +3868,31 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
 
                 break;
 
+            case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_BATCH_REQUESTS:
+
+                BatchRequestsPacket = (DEBUGGEE_BATCH_REQUESTS_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+                //
+                // Perform all of the requests of the batch and send their
+                // results back to the debugger in a single packet
+                //
+                KdPerformBatchRequests(DbgState,
+                                       BatchRequestsPacket,
+                                       RecvBufferLength - sizeof(DEBUGGER_REMOTE_PACKET));
+
+                break;
+
+            case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_TRANSPORT_TEST:
+
+                TransportTestPacket = (DEBUGGEE_TRANSPORT_TEST_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+                //
+                // Check the payload and send back the requested payload
+                //
+                KdPerformTransportTest(TransportTestPacket, RecvBufferLength - sizeof(DEBUGGER_REMOTE_PACKET));
+
+                break;
+
             case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_LIST_OR_MODIFY_BREAKPOINTS:
 
                 BpListOrModifyPacket = (DEBUGGEE_BP_LIST_OR_MODIFY_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
@@ -2687,6 +4043,27 @@ StartAgain:
         //
         // *** Current Operating Core  ***
         //
+
+        //
+        // If the steps are traced, the next step is performed
+        // without pausing the debuggee
+        //
+        if (g_KdStepTrace.IsActive && KdStepTraceRecordAndStepAgain(DbgState))
+        {
+            KdApplyTasksPostContinueCore(DbgState);
+            return;
+        }
+
+        //
+        // If a count of instructions is run, its result is sent before
+        // the debuggee is paused
+        //
+        if (g_KdInstructionBudget.IsActive)
+        {
+            g_KdInstructionBudget.IsActive = FALSE;
+            KdInstructionBudgetSendResult(DEBUGGER_OPERATION_WAS_SUCCESSFUL);
+        }
+
         RtlZeroMemory(&PausePacket, sizeof(DEBUGGEE_KD_PAUSED_PACKET));
 
         //
@@ -2704,6 +4081,11 @@ StartAgain:
         //
         PausePacket.CurrentCore = DbgState->CoreId;
 
+        //
+        // Set the time-stamp counter (e.g., for the records of tracking)
+        //
+        PausePacket.Tsc = LogReadTimestamp();
+
         //
         // Set the RIP and mode of execution
         //
@@ -2800,21 +4182,26 @@ StartAgain:
         //
         DbgState->NmiState.WaitingToBeLocked = FALSE;
 
-        ScopedSpinlock(
-            DbgState->Lock,
+        //
+        // The halted core performs the tasks of the operating core
+        // (e.g., parallel searches) while it's waiting for the lock
+        //
+        KdHaltedCoreWaitForLock(DbgState);
+
+        //
+        // Check if it's a change core event or not
+        //
+        if (DbgState->MainDebuggingCore)
+        {
             //
-            // Check if it's a change core event or not
+            // It's a core change event
             //
-            if (DbgState->MainDebuggingCore) {
-                //
-                // It's a core change event
-                //
-                g_DebuggeeHaltReason = DEBUGGEE_PAUSING_REASON_DEBUGGEE_CORE_SWITCHED;
+            g_DebuggeeHaltReason = DEBUGGEE_PAUSING_REASON_DEBUGGEE_CORE_SWITCHED;
 
-                goto StartAgain;
-            }
+            goto StartAgain;
+        }
 
-        );
+        SpinlockUnlock(&DbgState->Lock);
     }
 
     //
@@ -20,7 +20,11 @@
 BOOLEAN
 GlobalDebuggingStateAllocateZeroedMemory(VOID)
 {
-    SSIZE_T BufferSizeInByte = sizeof(PROCESSOR_DEBUGGING_STATE) * KeQueryActiveProcessorCount(0);
+    //
+    // The buffer is rounded to pages, so it's page aligned and the states
+    // of the cores start at the cache line boundaries
+    //
+    SSIZE_T BufferSizeInByte = ROUND_TO_PAGES(sizeof(PROCESSOR_DEBUGGING_STATE) * KeQueryActiveProcessorCount(0));
 
     //
     // Allocate global variable to hold Debugging(s) state
@@ -100,3 +104,45 @@ GlobalEventsFreeMemory(VOID)
 
     return g_Events == NULL;
 }
+
+/**
+ * @brief Allocate events index memory
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+GlobalEventsIndexAllocateZeroedMemory(VOID)
+{
+    //
+    // Allocate buffer for the lookup index of events
+    //
+    if (!g_EventsIndex)
+    {
+        g_EventsIndex = ExAllocatePoolWithTag(NonPagedPool, sizeof(DEBUGGER_EVENTS_INDEX), POOLTAG);
+    }
+
+    if (g_EventsIndex)
+    {
+        //
+        // Zero the buffer
+        //
+        RtlZeroBytes(g_EventsIndex, sizeof(DEBUGGER_EVENTS_INDEX));
+    }
+
+    return g_EventsIndex != NULL;
+}
+
+/**
+ * @brief Free events index memory
+ *
+ * @return VOID
+ */
+VOID
+GlobalEventsIndexFreeMemory(VOID)
+{
+    if (g_EventsIndex != NULL)
+    {
+        ExFreePoolWithTag(g_EventsIndex, POOLTAG);
+        g_EventsIndex = NULL;
+    }
+}
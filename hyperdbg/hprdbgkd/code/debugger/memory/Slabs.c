@@ -0,0 +1,254 @@
+/**
+ * @file Slabs.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The slab caches of the objects of the debugger (events and actions)
+ * @details the objects of the same type are allocated from pages that only
+ * hold that type of objects, so they're not scattered over the pool and the
+ * pages are reused after removing the objects
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Initialize a slab cache
+ * @details no slab is allocated until the first object is allocated
+ *
+ * @param Cache
+ * @param BaseObjectSize The size of the objects without their appended buffer
+ *
+ * @return VOID
+ */
+VOID
+SlabCacheInitialize(PSLAB_CACHE Cache, UINT32 BaseObjectSize)
+{
+    RtlZeroMemory(Cache, sizeof(SLAB_CACHE));
+
+    Cache->ObjectSize     = (BaseObjectSize + SLAB_CACHE_INLINE_BUFFER_SIZE + SLAB_CACHE_OBJECT_ALIGNMENT - 1) & ~(SLAB_CACHE_OBJECT_ALIGNMENT - 1);
+    Cache->ObjectsPerSlab = (PAGE_SIZE - SLAB_CACHE_SLAB_HEADER_SIZE) / Cache->ObjectSize;
+
+    InitializeListHead(&Cache->PartialSlabsList);
+    InitializeListHead(&Cache->FullSlabsList);
+}
+
+/**
+ * @brief Free the slabs of a slab cache
+ * @details all of the objects should be freed before calling this function
+ *
+ * @param Cache
+ *
+ * @return VOID
+ */
+VOID
+SlabCacheUninitialize(PSLAB_CACHE Cache)
+{
+    PSLAB_CACHE_SLAB Slab;
+
+    //
+    // The full slabs are also freed, in case any object is not freed
+    //
+    while (!IsListEmpty(&Cache->PartialSlabsList))
+    {
+        Slab = CONTAINING_RECORD(RemoveHeadList(&Cache->PartialSlabsList), SLAB_CACHE_SLAB, SlabsList);
+        ExFreePoolWithTag(Slab, POOLTAG);
+    }
+
+    while (!IsListEmpty(&Cache->FullSlabsList))
+    {
+        Slab = CONTAINING_RECORD(RemoveHeadList(&Cache->FullSlabsList), SLAB_CACHE_SLAB, SlabsList);
+        ExFreePoolWithTag(Slab, POOLTAG);
+    }
+
+    Cache->CountOfSlabs = 0;
+}
+
+/**
+ * @brief Allocate a new slab and add its objects to the free objects
+ * of the slab
+ *
+ * @param Cache
+ *
+ * @return PSLAB_CACHE_SLAB NULL if the slab cannot be allocated
+ */
+PSLAB_CACHE_SLAB
+SlabCacheAllocateSlab(PSLAB_CACHE Cache)
+{
+    PSLAB_CACHE_SLAB Slab;
+    BYTE *           Object;
+
+    //
+    // The allocations of a page are page aligned, so the slab of each
+    // object is found from the address of the object
+    //
+    Slab = ExAllocatePoolWithTag(NonPagedPool, PAGE_SIZE, POOLTAG);
+
+    if (Slab == NULL)
+    {
+        return NULL;
+    }
+
+    RtlZeroMemory(Slab, SLAB_CACHE_SLAB_HEADER_SIZE);
+
+    //
+    // The objects are pushed in the reverse order, so they're allocated
+    // from the start of the page
+    //
+    for (UINT32 i = Cache->ObjectsPerSlab; i > 0; i--)
+    {
+        Object = (BYTE *)Slab + SLAB_CACHE_SLAB_HEADER_SIZE + (i - 1) * Cache->ObjectSize;
+
+        PushEntryList(&Slab->FreeObjects, (PSINGLE_LIST_ENTRY)Object);
+    }
+
+    return Slab;
+}
+
+/**
+ * @brief Allocate an object from a slab cache
+ * @details should NOT be called in vmx-root, the object is not zeroed
+ *
+ * @param Cache
+ * @param Size The size of the object and its appended buffer
+ *
+ * @return PVOID NULL if the object cannot be allocated
+ */
+PVOID
+SlabCacheAllocate(PSLAB_CACHE Cache, SIZE_T Size)
+{
+    PSLAB_CACHE_SLAB Slab;
+    PVOID            Object;
+
+    //
+    // The objects that are larger than the objects of the slabs (e.g., a
+    // large condition) are allocated from the pool
+    //
+    if (Size > Cache->ObjectSize || Cache->ObjectsPerSlab == 0)
+    {
+        Object = ExAllocatePoolWithTag(NonPagedPool, Size, POOLTAG);
+
+        if (Object != NULL)
+        {
+            InterlockedIncrement64(&Cache->CountOfPoolAllocations);
+        }
+
+        return Object;
+    }
+
+    SpinlockLock(&Cache->Lock);
+
+    if (IsListEmpty(&Cache->PartialSlabsList))
+    {
+        //
+        // The new slab is allocated without holding the lock
+        //
+        SpinlockUnlock(&Cache->Lock);
+
+        Slab = SlabCacheAllocateSlab(Cache);
+
+        if (Slab == NULL)
+        {
+            return NULL;
+        }
+
+        SpinlockLock(&Cache->Lock);
+
+        InsertHeadList(&Cache->PartialSlabsList, &Slab->SlabsList);
+        Cache->CountOfSlabs++;
+    }
+
+    Slab   = CONTAINING_RECORD(Cache->PartialSlabsList.Flink, SLAB_CACHE_SLAB, SlabsList);
+    Object = PopEntryList(&Slab->FreeObjects);
+
+    Slab->CountOfBusyObjects++;
+
+    if (Slab->FreeObjects.Next == NULL)
+    {
+        //
+        // All of the objects of the slab are allocated
+        //
+        RemoveEntryList(&Slab->SlabsList);
+        InsertHeadList(&Cache->FullSlabsList, &Slab->SlabsList);
+    }
+
+    SpinlockUnlock(&Cache->Lock);
+
+    return Object;
+}
+
+/**
+ * @brief Free an object of a slab cache
+ * @details should NOT be called in vmx-root, the empty slabs are freed
+ * unless it's the only slab that has free objects
+ *
+ * @param Cache
+ * @param Object
+ * @param Size The size of the object and its appended buffer (same as the
+ * size of the allocation)
+ *
+ * @return VOID
+ */
+VOID
+SlabCacheFree(PSLAB_CACHE Cache, PVOID Object, SIZE_T Size)
+{
+    PSLAB_CACHE_SLAB Slab;
+    PSLAB_CACHE_SLAB SlabToFree = NULL;
+
+    if (Size > Cache->ObjectSize || Cache->ObjectsPerSlab == 0)
+    {
+        ExFreePoolWithTag(Object, POOLTAG);
+        InterlockedDecrement64(&Cache->CountOfPoolAllocations);
+
+        return;
+    }
+
+    Slab = (PSLAB_CACHE_SLAB)PAGE_ALIGN(Object);
+
+    SpinlockLock(&Cache->Lock);
+
+    if (Slab->FreeObjects.Next == NULL)
+    {
+        //
+        // The slab was full, now it has a free object
+        //
+        RemoveEntryList(&Slab->SlabsList);
+        InsertHeadList(&Cache->PartialSlabsList, &Slab->SlabsList);
+    }
+
+    PushEntryList(&Slab->FreeObjects, (PSINGLE_LIST_ENTRY)Object);
+    Slab->CountOfBusyObjects--;
+
+    if (Slab->CountOfBusyObjects == 0 && Cache->PartialSlabsList.Flink != Cache->PartialSlabsList.Blink)
+    {
+        //
+        // The slab is empty and there are other slabs with free objects
+        //
+        RemoveEntryList(&Slab->SlabsList);
+        Cache->CountOfSlabs--;
+
+        SlabToFree = Slab;
+    }
+
+    SpinlockUnlock(&Cache->Lock);
+
+    if (SlabToFree != NULL)
+    {
+        ExFreePoolWithTag(SlabToFree, POOLTAG);
+    }
+}
+
+/**
+ * @brief Query the size of the nonpaged memory of a slab cache
+ * @details the objects that are allocated from the pool are not counted
+ *
+ * @param Cache
+ *
+ * @return UINT64 The size of the slabs in bytes
+ */
+UINT64
+SlabCacheQuerySize(PSLAB_CACHE Cache)
+{
+    return Cache->CountOfSlabs * PAGE_SIZE;
+}
@@ -79,6 +79,7 @@ ProcessSwitch(UINT32 ProcessId, PEPROCESS EProcess, BOOLEAN IsSwitchByClockIntrr
     //
     g_ProcessSwitch.Process   = NULL;
     g_ProcessSwitch.ProcessId = NULL;
+    g_ProcessSwitch.Cr3       = NULL;
 
     //
     // Check to avoid invalid switch
@@ -93,9 +94,15 @@ ProcessSwitch(UINT32 ProcessId, PEPROCESS EProcess, BOOLEAN IsSwitchByClockIntrr
     //
     if (EProcess != NULL)
     {
-        if (CheckAccessValidityAndSafety(EProcess, sizeof(BYTE)))
+        if (CheckAccessValidityAndSafety(EProcess, sizeof(NT_KPROCESS)))
         {
             g_ProcessSwitch.Process = EProcess;
+
+            //
+            // The process is scheduled once its address space is loaded, so
+            // only the mov-to-cr3s of this cr3 need to be checked
+            //
+            g_ProcessSwitch.Cr3 = ((NT_KPROCESS *)EProcess)->DirectoryTableBase;
         }
         else
         {
@@ -195,6 +202,27 @@ ProcessDetectChangeByMov2Cr3Vmexits(PROCESSOR_DEBUGGING_STATE * DbgState,
 {
     if (Enable)
     {
+        //
+        // If the process object is known, only the mov-to-cr3s that load (or
+        // leave) its address space are handled by the full path and the rest
+        // of them are emulated in the fast-path, otherwise, all of the
+        // mov-to-cr3s are needed for detecting the change of the process
+        // (even if the user debugger filtered them)
+        //
+        if (!DbgState->ThreadOrProcessTracingDetails.IsWatingForMovCr3VmExits)
+        {
+            if (g_ProcessSwitch.Cr3 != NULL && VmFuncSetCr3VmexitFilter(TRUE, g_ProcessSwitch.Cr3))
+            {
+                DbgState->ThreadOrProcessTracingDetails.Cr3VmexitFilterCr3 = g_ProcessSwitch.Cr3;
+            }
+            else
+            {
+                DbgState->ThreadOrProcessTracingDetails.Cr3VmexitFilterCr3 = NULL;
+
+                VmFuncBypassCr3VmexitFilter(TRUE);
+            }
+        }
+
         //
         // Indicate that we're waiting for mov-to-cr3 vm-exits
         //
@@ -208,6 +236,25 @@ ProcessDetectChangeByMov2Cr3Vmexits(PROCESSOR_DEBUGGING_STATE * DbgState,
     }
     else
     {
+        if (DbgState->ThreadOrProcessTracingDetails.IsWatingForMovCr3VmExits)
+        {
+            if (DbgState->ThreadOrProcessTracingDetails.Cr3VmexitFilterCr3 != NULL)
+            {
+                //
+                // Each core holds its own reference of the address space (the
+                // entry is only removed once all of the requesters, including
+                // the user debugger, release it)
+                //
+                VmFuncSetCr3VmexitFilter(FALSE, DbgState->ThreadOrProcessTracingDetails.Cr3VmexitFilterCr3);
+
+                DbgState->ThreadOrProcessTracingDetails.Cr3VmexitFilterCr3 = NULL;
+            }
+            else
+            {
+                VmFuncBypassCr3VmexitFilter(FALSE);
+            }
+        }
+
         //
         // Indicate that we're not waiting for mov-to-cr3 vm-exits
         //
@@ -322,6 +369,63 @@ ProcessCheckIfEprocessIsValid(UINT64 Eprocess, UINT64 ActiveProcessHead, ULONG A
     return FALSE;
 }
 
+/**
+ * @brief reads the fields of a nt!_EPROCESS that are shown in the processes list
+ * @param Process target nt!_EPROCESS
+ * @param PorcessListSymbolInfo
+ * @param IsLinksOnly whether only nt!_EPROCESS.ActiveProcessLinks is needed
+ * @param ImageFileName buffer to save nt!_EPROCESS.ImageFileName (15 bytes)
+ * @param UniquePid
+ * @param ActiveProcessLinks
+ *
+ * @return VOID
+ */
+VOID
+ProcessReadListEntryFields(UINT64                                Process,
+                           PDEBUGGEE_PROCESS_LIST_NEEDED_DETAILS PorcessListSymbolInfo,
+                           BOOLEAN                               IsLinksOnly,
+                           UCHAR *                               ImageFileName,
+                           UINT64 *                              UniquePid,
+                           LIST_ENTRY *                          ActiveProcessLinks)
+{
+    ULONG ImageFileNameOffset      = PorcessListSymbolInfo->ImageFileNameOffset;
+    ULONG UniquePidOffset          = PorcessListSymbolInfo->UniquePidOffset;
+    ULONG ActiveProcessLinksOffset = PorcessListSymbolInfo->ActiveProcessLinksOffset;
+    ULONG FieldsStartOffset;
+    ULONG FieldsEndOffset;
+    BYTE  Fields[PROCESS_LIST_MAXIMUM_PREFETCHED_FIELDS_SIZE];
+
+    if (IsLinksOnly)
+    {
+        MemoryMapperReadMemorySafe(Process + ActiveProcessLinksOffset,
+                                   ActiveProcessLinks,
+                                   sizeof(LIST_ENTRY));
+        return;
+    }
+
+    //
+    // The fields are close to each other in nt!_EPROCESS, so they're read at
+    // once (if the span is small) rather than field by field
+    //
+    FieldsStartOffset = min(ImageFileNameOffset, min(UniquePidOffset, ActiveProcessLinksOffset));
+    FieldsEndOffset   = max(ImageFileNameOffset + 15, max(UniquePidOffset + sizeof(UINT64), ActiveProcessLinksOffset + sizeof(LIST_ENTRY)));
+
+    if (FieldsEndOffset - FieldsStartOffset <= PROCESS_LIST_MAXIMUM_PREFETCHED_FIELDS_SIZE)
+    {
+        MemoryMapperReadMemorySafe(Process + FieldsStartOffset, Fields, FieldsEndOffset - FieldsStartOffset);
+
+        RtlCopyMemory(ImageFileName, &Fields[ImageFileNameOffset - FieldsStartOffset], 15);
+        RtlCopyMemory(UniquePid, &Fields[UniquePidOffset - FieldsStartOffset], sizeof(UINT64));
+        RtlCopyMemory(ActiveProcessLinks, &Fields[ActiveProcessLinksOffset - FieldsStartOffset], sizeof(LIST_ENTRY));
+    }
+    else
+    {
+        MemoryMapperReadMemorySafe(Process + ImageFileNameOffset, ImageFileName, 15);
+        MemoryMapperReadMemorySafe(Process + UniquePidOffset, UniquePid, sizeof(UINT64));
+        MemoryMapperReadMemorySafe(Process + ActiveProcessLinksOffset, ActiveProcessLinks, sizeof(LIST_ENTRY));
+    }
+}
+
 /**
  * @brief shows the processes list
  * @param PorcessListSymbolInfo
@@ -329,6 +433,7 @@ ProcessCheckIfEprocessIsValid(UINT64 Eprocess, UINT64 ActiveProcessHead, ULONG A
  * @param CountOfProcesses
  * @param ListSaveBuffer
  * @param ListSaveBuffSize
+ * @param StartIndex index of the first process that is saved (pagination)
  *
  * @return BOOLEAN
  */
@@ -337,14 +442,17 @@ ProcessShowList(PDEBUGGEE_PROCESS_LIST_NEEDED_DETAILS              PorcessListSy
                 DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTIONS QueryAction,
                 UINT32 *                                           CountOfProcesses,
                 PVOID                                              ListSaveBuffer,
-                UINT64                                             ListSaveBuffSize)
+                UINT64                                             ListSaveBuffSize,
+                UINT32                                             StartIndex)
 {
     UINT64                               Process;
     UINT64                               UniquePid;
     LIST_ENTRY                           ActiveProcessLinks;
+    DEBUGGEE_PROCESS_LIST_NEEDED_DETAILS SymbolInfo;
     UCHAR                                ImageFileName[15]  = {0};
     CR3_TYPE                             ProcessCr3         = {0};
     UINT32                               EnumerationCount   = 0;
+    UINT32                               SavedCount         = 0;
     UINT32                               MaximumBufferCount = 0;
     PDEBUGGEE_PROCESS_LIST_DETAILS_ENTRY SavingEntries      = ListSaveBuffer;
 
@@ -372,12 +480,15 @@ ProcessShowList(PDEBUGGEE_PROCESS_LIST_NEEDED_DETAILS              PorcessListSy
     }
 
     //
-    // Set the details derived from the symbols
+    // Set the details derived from the symbols, they're copied as the saving
+    // buffer might be the same as the request buffer
     //
-    UINT64 ActiveProcessHead        = PorcessListSymbolInfo->PsActiveProcessHead;      // nt!PsActiveProcessHead
-    ULONG  ImageFileNameOffset      = PorcessListSymbolInfo->ImageFileNameOffset;      // nt!_EPROCESS.ImageFileName
-    ULONG  UniquePidOffset          = PorcessListSymbolInfo->UniquePidOffset;          // nt!_EPROCESS.UniqueProcessId
-    ULONG  ActiveProcessLinksOffset = PorcessListSymbolInfo->ActiveProcessLinksOffset; // nt!_EPROCESS.ActiveProcessLinks
+    RtlCopyMemory(&SymbolInfo, PorcessListSymbolInfo, sizeof(DEBUGGEE_PROCESS_LIST_NEEDED_DETAILS));
+
+    UINT64 ActiveProcessHead        = SymbolInfo.PsActiveProcessHead;      // nt!PsActiveProcessHead
+    ULONG  ImageFileNameOffset      = SymbolInfo.ImageFileNameOffset;      // nt!_EPROCESS.ImageFileName
+    ULONG  UniquePidOffset          = SymbolInfo.UniquePidOffset;          // nt!_EPROCESS.UniqueProcessId
+    ULONG  ActiveProcessLinksOffset = SymbolInfo.ActiveProcessLinksOffset; // nt!_EPROCESS.ActiveProcessLinks
 
     //
     // Dirty validation of parameters
@@ -409,19 +520,23 @@ ProcessShowList(PDEBUGGEE_PROCESS_LIST_NEEDED_DETAILS              PorcessListSy
         do
         {
             //
-            // Read Process name, Process ID, CR3 of the target process
+            // The processes before the start index (previous pages) only need
+            // their links to be read
             //
-            MemoryMapperReadMemorySafe(Process + ImageFileNameOffset,
-                                       &ImageFileName,
-                                       sizeof(ImageFileName));
+            if (QueryAction == DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTION_QUERY_SAVE_DETAILS &&
+                EnumerationCount < StartIndex)
+            {
+                ProcessReadListEntryFields(Process, &SymbolInfo, TRUE, NULL, NULL, &ActiveProcessLinks);
 
-            MemoryMapperReadMemorySafe(Process + UniquePidOffset,
-                                       &UniquePid,
-                                       sizeof(UniquePid));
+                EnumerationCount++;
 
-            MemoryMapperReadMemorySafe(Process + ActiveProcessLinksOffset,
-                                       &ActiveProcessLinks,
-                                       sizeof(ActiveProcessLinks));
+                goto NextProcess;
+            }
+
+            //
+            // Read Process name, Process ID, CR3 of the target process
+            //
+            ProcessReadListEntryFields(Process, &SymbolInfo, FALSE, ImageFileName, &UniquePid, &ActiveProcessLinks);
 
             //
             // Get the kernel CR3 for the target process
@@ -450,26 +565,28 @@ ProcessShowList(PDEBUGGEE_PROCESS_LIST_NEEDED_DETAILS              PorcessListSy
 
             case DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTION_QUERY_SAVE_DETAILS:
 
-                EnumerationCount++;
-
                 //
                 // Check to avoid overflow
                 //
-                if (EnumerationCount == MaximumBufferCount - 1)
+                if (SavedCount == MaximumBufferCount)
                 {
                     //
-                    // buffer is full
+                    // buffer is full (the next page is queried separately)
                     //
                     goto ReturnEnd;
                 }
 
+                EnumerationCount++;
+
                 //
                 // Save the details
                 //
-                SavingEntries[EnumerationCount - 1].Eprocess = Process;
-                SavingEntries[EnumerationCount - 1].Pid      = UniquePid;
-                SavingEntries[EnumerationCount - 1].Cr3      = ProcessCr3.Flags;
-                RtlCopyMemory(&SavingEntries[EnumerationCount - 1].ImageFileName, ImageFileName, 15);
+                SavingEntries[SavedCount].Eprocess = Process;
+                SavingEntries[SavedCount].Pid      = UniquePid;
+                SavingEntries[SavedCount].Cr3      = ProcessCr3.Flags;
+                RtlCopyMemory(&SavingEntries[SavedCount].ImageFileName, ImageFileName, 15);
+
+                SavedCount++;
 
                 break;
 
@@ -480,6 +597,8 @@ ProcessShowList(PDEBUGGEE_PROCESS_LIST_NEEDED_DETAILS              PorcessListSy
                 break;
             }
 
+        NextProcess:
+
             //
             // Find the next process from the list of this process
             //
@@ -519,6 +638,8 @@ ReturnEnd:
 BOOLEAN
 ProcessInterpretProcess(PDEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET PidRequest)
 {
+    PDEBUGGEE_PROCESS_LIST_DETAILS_ENTRY ProcessEntries;
+
     switch (PidRequest->ActionType)
     {
     case DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_GET_PROCESS_DETAILS:
@@ -564,12 +685,49 @@ ProcessInterpretProcess(PDEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET PidRequest)
                              DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTION_SHOW_INSTANTLY,
                              NULL,
                              NULL,
-                             NULL))
+                             NULL,
+                             0))
+        {
+            PidRequest->Result = DEBUGGER_ERROR_DETAILS_OR_SWITCH_PROCESS_INVALID_PARAMETER;
+            break;
+        }
+
+        //
+        // Operation was successful
+        //
+        PidRequest->Result = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+        break;
+
+    case DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_QUERY_PROCESS_LIST_ENTRIES:
+
+        //
+        // Save a page of the process list right after the packet, the unused
+        // entries remain zero so the count of the saved entries is known
+        //
+        ProcessEntries = (PDEBUGGEE_PROCESS_LIST_DETAILS_ENTRY)((UINT64)PidRequest + sizeof(DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET));
+
+        RtlZeroMemory(ProcessEntries, MaxSerialObjectListEntriesInPacket * sizeof(DEBUGGEE_PROCESS_LIST_DETAILS_ENTRY));
+
+        PidRequest->CountOfEntries = 0;
+
+        if (!ProcessShowList(&PidRequest->ProcessListSymDetails,
+                             DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTION_QUERY_SAVE_DETAILS,
+                             NULL,
+                             ProcessEntries,
+                             MaxSerialObjectListEntriesInPacket * sizeof(DEBUGGEE_PROCESS_LIST_DETAILS_ENTRY),
+                             PidRequest->StartIndex))
         {
             PidRequest->Result = DEBUGGER_ERROR_DETAILS_OR_SWITCH_PROCESS_INVALID_PARAMETER;
             break;
         }
 
+        while (PidRequest->CountOfEntries < MaxSerialObjectListEntriesInPacket &&
+               ProcessEntries[PidRequest->CountOfEntries].Eprocess != NULL)
+        {
+            PidRequest->CountOfEntries++;
+        }
+
         //
         // Operation was successful
         //
@@ -619,7 +777,8 @@ ProcessQueryCount(PDEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS DebuggerUsermodePr
                              DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTION_QUERY_COUNT,
                              &DebuggerUsermodeProcessOrThreadQueryRequest->Count,
                              NULL,
-                             NULL);
+                             NULL,
+                             0);
 
     if (Result && DebuggerUsermodeProcessOrThreadQueryRequest->Count != 0)
     {
@@ -654,7 +813,8 @@ ProcessQueryList(PDEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS DebuggerUsermodePro
                              DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTION_QUERY_SAVE_DETAILS,
                              NULL,
                              AddressToSaveDetail,
-                             BufferSize);
+                             BufferSize,
+                             DebuggerUsermodeProcessOrThreadQueryRequest->StartIndex);
 
     return Result;
 }
@@ -107,6 +107,56 @@ ThreadSwitch(UINT32 ThreadId, PETHREAD EThread, BOOLEAN CheckByClockInterrupt)
     return TRUE;
 }
 
+/**
+ * @brief reads the fields of a nt!_ETHREAD that are shown in the threads list
+ * @param Thread target nt!_ETHREAD
+ * @param CidOffset nt!_ETHREAD.Cid
+ * @param ThreadListEntryOffset nt!_ETHREAD.ThreadListEntry
+ * @param IsLinksOnly whether only nt!_ETHREAD.ThreadListEntry is needed
+ * @param ThreadCid
+ * @param ThreadLinks
+ *
+ * @return VOID
+ */
+VOID
+ThreadReadListEntryFields(UINT64       Thread,
+                          UINT32       CidOffset,
+                          UINT32       ThreadListEntryOffset,
+                          BOOLEAN      IsLinksOnly,
+                          CLIENT_ID *  ThreadCid,
+                          LIST_ENTRY * ThreadLinks)
+{
+    UINT32 FieldsStartOffset;
+    UINT32 FieldsEndOffset;
+    BYTE   Fields[THREAD_LIST_MAXIMUM_PREFETCHED_FIELDS_SIZE];
+
+    if (IsLinksOnly)
+    {
+        MemoryMapperReadMemorySafe(Thread + ThreadListEntryOffset, ThreadLinks, sizeof(LIST_ENTRY));
+        return;
+    }
+
+    //
+    // The fields are close to each other in nt!_ETHREAD, so they're read at
+    // once (if the span is small) rather than field by field
+    //
+    FieldsStartOffset = min(CidOffset, ThreadListEntryOffset);
+    FieldsEndOffset   = max(CidOffset + sizeof(CLIENT_ID), ThreadListEntryOffset + sizeof(LIST_ENTRY));
+
+    if (FieldsEndOffset - FieldsStartOffset <= THREAD_LIST_MAXIMUM_PREFETCHED_FIELDS_SIZE)
+    {
+        MemoryMapperReadMemorySafe(Thread + FieldsStartOffset, Fields, FieldsEndOffset - FieldsStartOffset);
+
+        RtlCopyMemory(ThreadCid, &Fields[CidOffset - FieldsStartOffset], sizeof(CLIENT_ID));
+        RtlCopyMemory(ThreadLinks, &Fields[ThreadListEntryOffset - FieldsStartOffset], sizeof(LIST_ENTRY));
+    }
+    else
+    {
+        MemoryMapperReadMemorySafe(Thread + CidOffset, ThreadCid, sizeof(CLIENT_ID));
+        MemoryMapperReadMemorySafe(Thread + ThreadListEntryOffset, ThreadLinks, sizeof(LIST_ENTRY));
+    }
+}
+
 /**
  * @brief shows the threads list
  * @param ThreadListSymbolInfo
@@ -114,6 +164,7 @@ ThreadSwitch(UINT32 ThreadId, PETHREAD EThread, BOOLEAN CheckByClockInterrupt)
  * @param CountOfThreads
  * @param ListSaveBuffer
  * @param ListSaveBuffSize
+ * @param StartIndex index of the first thread that is saved (pagination)
  *
  * @return BOOLEAN
  */
@@ -122,13 +173,17 @@ ThreadShowList(PDEBUGGEE_THREAD_LIST_NEEDED_DETAILS               ThreadListSymb
                DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTIONS QueryAction,
                UINT32 *                                           CountOfThreads,
                PVOID                                              ListSaveBuffer,
-               UINT64                                             ListSaveBuffSize)
+               UINT64                                             ListSaveBuffSize,
+               UINT32                                             StartIndex)
 {
     UINT64                              ThreadListHead;
+    UINT64                              Process;
     UINT32                              EnumerationCount   = 0;
+    UINT32                              SavedCount         = 0;
     UINT64                              Thread             = NULL;
     LIST_ENTRY                          ThreadLinks        = {0};
     CLIENT_ID                           ThreadCid          = {0};
+    UCHAR                               ImageFileName[15]  = {0};
     UINT32                              MaximumBufferCount = 0;
     PDEBUGGEE_THREAD_LIST_DETAILS_ENTRY SavingEntries      = ListSaveBuffer;
 
@@ -182,16 +237,15 @@ ThreadShowList(PDEBUGGEE_THREAD_LIST_NEEDED_DETAILS               ThreadListSymb
         // Means that it's for the current process
         //
         ThreadListSymbolInfo->Process = PsGetCurrentProcess();
-        ThreadListHead                = (UINT64)PsGetCurrentProcess() + ThreadListHeadOffset;
-    }
-    else
-    {
-        //
-        // Means that the user specified a special process
-        //
-        ThreadListHead = (UINT64)ThreadListSymbolInfo->Process + ThreadListHeadOffset;
     }
 
+    //
+    // The process is kept locally as the saving buffer might be the same as
+    // the request buffer
+    //
+    Process        = ThreadListSymbolInfo->Process;
+    ThreadListHead = Process + ThreadListHeadOffset;
+
     //
     // Check if the process's thread list head is valid or not
     //
@@ -203,21 +257,26 @@ ThreadShowList(PDEBUGGEE_THREAD_LIST_NEEDED_DETAILS               ThreadListSymb
     //
     // Check if the nt!_EPROCESS is valid or not (available in the system or not)
     //
-    if (!ProcessCheckIfEprocessIsValid(ThreadListSymbolInfo->Process,
+    if (!ProcessCheckIfEprocessIsValid(Process,
                                        PsActiveProcessHeadAddress,
                                        ActiveProcessLinksOffset))
     {
         return FALSE;
     }
 
+    //
+    // The image name is the same for all of the threads
+    //
+    RtlCopyMemory(ImageFileName, CommonGetProcessNameFromProcessControlBlock(Process), 15);
+
     if (QueryAction == DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTION_SHOW_INSTANTLY)
     {
         //
         // Show the message of show the process
         //
         Log("PROCESS\t%llx\tIMAGE\t%s\n",
-            ThreadListSymbolInfo->Process,
-            CommonGetProcessNameFromProcessControlBlock(ThreadListSymbolInfo->Process));
+            Process,
+            ImageFileName);
     }
 
     //
@@ -232,12 +291,24 @@ ThreadShowList(PDEBUGGEE_THREAD_LIST_NEEDED_DETAILS               ThreadListSymb
 
     do
     {
+        //
+        // The threads before the start index (previous pages) only need
+        // their links to be read
+        //
+        if (QueryAction == DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTION_QUERY_SAVE_DETAILS &&
+            EnumerationCount < StartIndex)
+        {
+            ThreadReadListEntryFields(Thread, CidOffset, ThreadListEntryOffset, TRUE, NULL, &ThreadLinks);
+
+            EnumerationCount++;
+
+            goto NextThread;
+        }
+
         //
         // Show thread list, we read everything from the view of system process
         //
-        MemoryMapperReadMemorySafe(Thread + CidOffset,
-                                   &ThreadCid,
-                                   sizeof(ThreadCid));
+        ThreadReadListEntryFields(Thread, CidOffset, ThreadListEntryOffset, FALSE, &ThreadCid, &ThreadLinks);
 
         switch (QueryAction)
         {
@@ -258,30 +329,30 @@ ThreadShowList(PDEBUGGEE_THREAD_LIST_NEEDED_DETAILS               ThreadListSymb
 
         case DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTION_QUERY_SAVE_DETAILS:
 
-            EnumerationCount++;
-
             //
             // Check to avoid overflow
             //
-            if (EnumerationCount == MaximumBufferCount - 1)
+            if (SavedCount == MaximumBufferCount)
             {
                 //
-                // buffer is full
+                // buffer is full (the next page is queried separately)
                 //
                 goto ReturnEnd;
             }
 
+            EnumerationCount++;
+
             //
             // Save the details
             //
-            SavingEntries[EnumerationCount - 1].Eprocess = ThreadListSymbolInfo->Process;
-            SavingEntries[EnumerationCount - 1].Pid      = ThreadCid.UniqueProcess;
-            SavingEntries[EnumerationCount - 1].Tid      = ThreadCid.UniqueThread;
-            SavingEntries[EnumerationCount - 1].Ethread  = Thread;
+            SavingEntries[SavedCount].Eprocess = Process;
+            SavingEntries[SavedCount].Pid      = ThreadCid.UniqueProcess;
+            SavingEntries[SavedCount].Tid      = ThreadCid.UniqueThread;
+            SavingEntries[SavedCount].Ethread  = Thread;
+
+            RtlCopyMemory(&SavingEntries[SavedCount].ImageFileName, ImageFileName, 15);
 
-            RtlCopyMemory(&SavingEntries[EnumerationCount - 1].ImageFileName,
-                          CommonGetProcessNameFromProcessControlBlock(ThreadListSymbolInfo->Process),
-                          15);
+            SavedCount++;
 
             break;
 
@@ -289,9 +360,7 @@ ThreadShowList(PDEBUGGEE_THREAD_LIST_NEEDED_DETAILS               ThreadListSymb
             break;
         }
 
-        MemoryMapperReadMemorySafe(Thread + ThreadListEntryOffset,
-                                   &ThreadLinks,
-                                   sizeof(ThreadLinks));
+    NextThread:
 
         //
         // Find the next process from the list of this process
@@ -321,6 +390,8 @@ ReturnEnd:
 BOOLEAN
 ThreadInterpretThread(PDEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET TidRequest)
 {
+    PDEBUGGEE_THREAD_LIST_DETAILS_ENTRY ThreadEntries;
+
     switch (TidRequest->ActionType)
     {
     case DEBUGGEE_DETAILS_AND_SWITCH_THREAD_GET_THREAD_DETAILS:
@@ -368,12 +439,49 @@ ThreadInterpretThread(PDEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET TidRequest)
                             DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTION_SHOW_INSTANTLY,
                             NULL,
                             NULL,
-                            NULL))
+                            NULL,
+                            0))
+        {
+            TidRequest->Result = DEBUGGER_ERROR_DETAILS_OR_SWITCH_THREAD_INVALID_PARAMETER;
+            break;
+        }
+
+        //
+        // Operation was successful
+        //
+        TidRequest->Result = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+        break;
+
+    case DEBUGGEE_DETAILS_AND_SWITCH_THREAD_QUERY_THREAD_LIST_ENTRIES:
+
+        //
+        // Save a page of the thread list right after the packet, the unused
+        // entries remain zero so the count of the saved entries is known
+        //
+        ThreadEntries = (PDEBUGGEE_THREAD_LIST_DETAILS_ENTRY)((UINT64)TidRequest + sizeof(DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET));
+
+        RtlZeroMemory(ThreadEntries, MaxSerialObjectListEntriesInPacket * sizeof(DEBUGGEE_THREAD_LIST_DETAILS_ENTRY));
+
+        TidRequest->CountOfEntries = 0;
+
+        if (!ThreadShowList(&TidRequest->ThreadListSymDetails,
+                            DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTION_QUERY_SAVE_DETAILS,
+                            NULL,
+                            ThreadEntries,
+                            MaxSerialObjectListEntriesInPacket * sizeof(DEBUGGEE_THREAD_LIST_DETAILS_ENTRY),
+                            TidRequest->StartIndex))
         {
             TidRequest->Result = DEBUGGER_ERROR_DETAILS_OR_SWITCH_THREAD_INVALID_PARAMETER;
             break;
         }
 
+        while (TidRequest->CountOfEntries < MaxSerialObjectListEntriesInPacket &&
+               ThreadEntries[TidRequest->CountOfEntries].Ethread != NULL)
+        {
+            TidRequest->CountOfEntries++;
+        }
+
         //
         // Operation was successful
         //
@@ -620,7 +728,8 @@ ThreadQueryCount(PDEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS DebuggerUsermodePro
                             DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTION_QUERY_COUNT,
                             &DebuggerUsermodeProcessOrThreadQueryRequest->Count,
                             NULL,
-                            NULL);
+                            NULL,
+                            0);
 
     if (Result && DebuggerUsermodeProcessOrThreadQueryRequest->Count != 0)
     {
@@ -655,7 +764,8 @@ ThreadQueryList(PDEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS DebuggerUsermodeProc
                             DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTION_QUERY_SAVE_DETAILS,
                             NULL,
                             AddressToSaveDetail,
-                            BufferSize);
+                            BufferSize,
+                            DebuggerUsermodeProcessOrThreadQueryRequest->StartIndex);
 
     return Result;
 }
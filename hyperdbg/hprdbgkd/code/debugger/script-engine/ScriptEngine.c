@@ -50,3 +50,1055 @@ ScriptEngineWrapperGetAddressOfReservedBuffer(PDEBUGGER_EVENT_ACTION Action)
 {
     return Action->RequestedBuffer.RequstBufferAddress;
 }
+
+/**
+ * @brief Allocate the aggregation table of a core
+ *
+ * @param DbgState The state of the debugger on the core
+ * @return BOOLEAN
+ */
+BOOLEAN
+ScriptEngineAggregationInitialize(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    if (DbgState->ScriptEngineAggregationTable == NULL)
+    {
+        DbgState->ScriptEngineAggregationTable = ExAllocatePoolWithTag(NonPagedPool, sizeof(SCRIPT_ENGINE_AGGREGATION_TABLE), POOLTAG);
+
+        if (DbgState->ScriptEngineAggregationTable == NULL)
+        {
+            return FALSE;
+        }
+    }
+
+    RtlZeroMemory(DbgState->ScriptEngineAggregationTable, sizeof(SCRIPT_ENGINE_AGGREGATION_TABLE));
+
+    return TRUE;
+}
+
+/**
+ * @brief Free the aggregation table of a core
+ *
+ * @param DbgState The state of the debugger on the core
+ * @return VOID
+ */
+VOID
+ScriptEngineAggregationUninitialize(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    if (DbgState->ScriptEngineAggregationTable != NULL)
+    {
+        ExFreePoolWithTag(DbgState->ScriptEngineAggregationTable, POOLTAG);
+        DbgState->ScriptEngineAggregationTable = NULL;
+    }
+}
+
+/**
+ * @brief Allocate the scratch memory of scripts on a core
+ *
+ * @param DbgState The state of the debugger on the core
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+ScriptEngineScratchInitialize(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    if (DbgState->ScriptEngineScratchArena == NULL)
+    {
+        DbgState->ScriptEngineScratchArena = ExAllocatePoolWithTag(NonPagedPool, DebuggerScriptEngineScratchArenaSize, POOLTAG);
+
+        if (DbgState->ScriptEngineScratchArena == NULL)
+        {
+            return FALSE;
+        }
+    }
+
+    RtlZeroMemory(DbgState->ScriptEngineScratchArena, DebuggerScriptEngineScratchArenaSize);
+    DbgState->ScriptEngineScratchUsed = 0;
+
+    return TRUE;
+}
+
+/**
+ * @brief Free the scratch memory of scripts on a core
+ *
+ * @param DbgState The state of the debugger on the core
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineScratchUninitialize(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    if (DbgState->ScriptEngineScratchArena != NULL)
+    {
+        ExFreePoolWithTag(DbgState->ScriptEngineScratchArena, POOLTAG);
+        DbgState->ScriptEngineScratchArena = NULL;
+    }
+}
+
+/**
+ * @brief Allocate a buffer from the scratch memory of scripts on the
+ * current core
+ * @details the buffers are valid until the end of the current script
+ * (the scratch memory is reset before running each script), they are
+ * not visible to the guest
+ *
+ * @param Size Size of the buffer
+ *
+ * @return UINT64 Address of the buffer or NULL if there is not enough
+ * scratch memory
+ */
+UINT64
+ScriptEngineScratchAllocate(UINT64 Size)
+{
+    PROCESSOR_DEBUGGING_STATE * DbgState = &g_DbgState[KeGetCurrentProcessorNumber()];
+    UINT64                      Address;
+
+    if (DbgState->ScriptEngineScratchArena == NULL ||
+        Size == 0 ||
+        Size > DebuggerScriptEngineScratchArenaSize - DbgState->ScriptEngineScratchUsed)
+    {
+        return NULL;
+    }
+
+    Address = (UINT64)DbgState->ScriptEngineScratchArena + DbgState->ScriptEngineScratchUsed;
+
+    //
+    // The next buffer is aligned (the end of the arena is aligned)
+    //
+    DbgState->ScriptEngineScratchUsed += (UINT32)((Size + DebuggerScriptEngineScratchAlignment - 1) & ~(UINT64)(DebuggerScriptEngineScratchAlignment - 1));
+
+    return Address;
+}
+
+/**
+ * @brief Allocate the buffer of the staged messages of scripts on a core
+ *
+ * @param DbgState The state of the debugger on the core
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+ScriptEngineOutputInitialize(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    if (DbgState->ScriptEngineOutputBuffer == NULL)
+    {
+        DbgState->ScriptEngineOutputBuffer = ExAllocatePoolWithTag(NonPagedPool, PacketChunkSize, POOLTAG);
+
+        if (DbgState->ScriptEngineOutputBuffer == NULL)
+        {
+            return FALSE;
+        }
+    }
+
+    DbgState->ScriptEngineOutputLength    = 0;
+    DbgState->ScriptEngineOutputIsStaging = FALSE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Free the buffer of the staged messages of scripts on a core
+ *
+ * @param DbgState The state of the debugger on the core
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineOutputUninitialize(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    if (DbgState->ScriptEngineOutputBuffer != NULL)
+    {
+        ExFreePoolWithTag(DbgState->ScriptEngineOutputBuffer, POOLTAG);
+        DbgState->ScriptEngineOutputBuffer = NULL;
+    }
+
+    DbgState->ScriptEngineOutputIsStaging = FALSE;
+}
+
+/**
+ * @brief Query the size of the nonpaged buffers of the script engine
+ * @details the global variables and the variables, scratch memory,
+ * aggregation table and staged messages of all cores are counted (the
+ * buffers of the scripts of events are not counted)
+ *
+ * @return UINT64 Size of the buffers (in bytes)
+ */
+UINT64
+ScriptEngineQueryBuffersSize()
+{
+    ULONG                       ProcessorsCount = KeQueryActiveProcessorCount(0);
+    PROCESSOR_DEBUGGING_STATE * DbgState;
+    UINT64                      Size = 0;
+
+    if (g_ScriptGlobalVariables != NULL)
+    {
+        Size += MAX_VAR_COUNT * sizeof(UINT64);
+    }
+
+    if (g_DbgState == NULL)
+    {
+        return Size;
+    }
+
+    for (ULONG i = 0; i < ProcessorsCount; i++)
+    {
+        DbgState = &g_DbgState[i];
+
+        if (DbgState->ScriptEngineCoreSpecificLocalVariable != NULL)
+        {
+            Size += MAX_VAR_COUNT * sizeof(UINT64);
+        }
+
+        if (DbgState->ScriptEngineCoreSpecificTempVariable != NULL)
+        {
+            Size += MAX_TEMP_COUNT * sizeof(UINT64);
+        }
+
+        if (DbgState->ScriptEngineScratchArena != NULL)
+        {
+            Size += DebuggerScriptEngineScratchArenaSize;
+        }
+
+        if (DbgState->ScriptEngineAggregationTable != NULL)
+        {
+            Size += sizeof(SCRIPT_ENGINE_AGGREGATION_TABLE);
+        }
+
+        if (DbgState->ScriptEngineOutputBuffer != NULL)
+        {
+            Size += PacketChunkSize;
+        }
+    }
+
+    return Size;
+}
+
+/**
+ * @brief Start staging the messages of a script on a core
+ * @details the messages of the script (print and printf) are sent as
+ * a single message once the script is finished, so the messages of the
+ * script are not interleaved with the messages of other cores
+ *
+ * @param DbgState The state of the debugger on the core
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineOutputBegin(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    if (DbgState->ScriptEngineOutputBuffer != NULL)
+    {
+        DbgState->ScriptEngineOutputLength    = 0;
+        DbgState->ScriptEngineOutputIsStaging = TRUE;
+    }
+}
+
+/**
+ * @brief Send the staged messages of scripts on a core
+ *
+ * @param DbgState The state of the debugger on the core
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineOutputFlush(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    if (DbgState->ScriptEngineOutputLength == 0)
+    {
+        return;
+    }
+
+    DbgState->ScriptEngineOutputBuffer[DbgState->ScriptEngineOutputLength] = '\0';
+
+    LogSimpleWithTag(DbgState->ScriptEngineOutputTag,
+                     DbgState->ScriptEngineOutputImmediate,
+                     DbgState->ScriptEngineOutputBuffer,
+                     DbgState->ScriptEngineOutputLength + 1);
+
+    DbgState->ScriptEngineOutputLength = 0;
+}
+
+/**
+ * @brief Send the staged messages of a script and stop staging the
+ * messages on a core
+ *
+ * @param DbgState The state of the debugger on the core
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineOutputEnd(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    ScriptEngineOutputFlush(DbgState);
+
+    DbgState->ScriptEngineOutputIsStaging = FALSE;
+}
+
+/**
+ * @brief Send a message of a script (print and printf)
+ * @details the message is staged if the messages of the script are
+ * staged, otherwise it's sent directly
+ *
+ * @param Tag Tag of the event
+ * @param ImmediateMessagePassing
+ * @param Message The message
+ * @param MessageLength Length of the message (without the null character)
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineOutputMessage(UINT64 Tag, BOOLEAN ImmediateMessagePassing, CHAR * Message, UINT32 MessageLength)
+{
+    PROCESSOR_DEBUGGING_STATE * DbgState = &g_DbgState[KeGetCurrentProcessorNumber()];
+
+    if (!DbgState->ScriptEngineOutputIsStaging)
+    {
+        LogSimpleWithTag(Tag, ImmediateMessagePassing, Message, MessageLength + 1);
+        return;
+    }
+
+    //
+    // The staged messages are sent if the message doesn't fit in the
+    // buffer (one character is kept for the null character) or it's
+    // with another tag or mode of sending
+    //
+    if (DbgState->ScriptEngineOutputLength != 0 &&
+        (DbgState->ScriptEngineOutputTag != Tag ||
+         DbgState->ScriptEngineOutputImmediate != ImmediateMessagePassing ||
+         DbgState->ScriptEngineOutputLength + MessageLength >= PacketChunkSize))
+    {
+        ScriptEngineOutputFlush(DbgState);
+    }
+
+    if (MessageLength >= PacketChunkSize)
+    {
+        LogSimpleWithTag(Tag, ImmediateMessagePassing, Message, MessageLength + 1);
+        return;
+    }
+
+    RtlCopyMemory(DbgState->ScriptEngineOutputBuffer + DbgState->ScriptEngineOutputLength, Message, MessageLength);
+
+    DbgState->ScriptEngineOutputLength += MessageLength;
+
+    DbgState->ScriptEngineOutputTag       = Tag;
+    DbgState->ScriptEngineOutputImmediate = ImmediateMessagePassing;
+}
+
+/**
+ * @brief Find the entry of a key in an aggregation table
+ *
+ * @param Table
+ * @param MapId
+ * @param Key
+ * @param Type The type of the new entry if the key should be inserted,
+ * or SCRIPT_ENGINE_AGGREGATION_TYPE_UNUSED for only finding the key
+ *
+ * @return PSCRIPT_ENGINE_AGGREGATION_ENTRY NULL if the key is not found
+ * (or the table is full)
+ */
+static PSCRIPT_ENGINE_AGGREGATION_ENTRY
+ScriptEngineAggregationFind(PSCRIPT_ENGINE_AGGREGATION_TABLE Table,
+                            UINT32                           MapId,
+                            UINT64                           Key,
+                            SCRIPT_ENGINE_AGGREGATION_TYPE   Type)
+{
+    PSCRIPT_ENGINE_AGGREGATION_ENTRY Entry;
+    UINT64                           Hash  = (Key ^ ((UINT64)MapId << 32 | MapId)) * 0x9e3779b97f4a7c15;
+    UINT32                           Index = (UINT32)(Hash >> 32) & (SCRIPT_ENGINE_AGGREGATION_TABLE_CAPACITY - 1);
+
+    for (UINT32 i = 0; i < SCRIPT_ENGINE_AGGREGATION_TABLE_CAPACITY; i++)
+    {
+        Entry = &Table->Entries[(Index + i) & (SCRIPT_ENGINE_AGGREGATION_TABLE_CAPACITY - 1)];
+
+        if (Entry->Type == SCRIPT_ENGINE_AGGREGATION_TYPE_UNUSED)
+        {
+            if (Type == SCRIPT_ENGINE_AGGREGATION_TYPE_UNUSED ||
+                Table->UsedEntries >= SCRIPT_ENGINE_AGGREGATION_TABLE_MAXIMUM_LOAD)
+            {
+                return NULL;
+            }
+
+            Entry->MapId = MapId;
+            Entry->Key   = Key;
+            Entry->Count = 0;
+            Entry->Sum   = 0;
+
+            Table->UsedEntries++;
+
+            //
+            // The type is set at last, the entry is visible to the readers
+            // (other cores) after that
+            //
+            InterlockedExchange((volatile LONG *)&Entry->Type, Type);
+
+            return Entry;
+        }
+
+        if (Entry->MapId == MapId && Entry->Key == Key)
+        {
+            return Entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Update the value of a key in the aggregation table of the
+ * current core
+ *
+ * @param Type The type of the aggregation
+ * @param MapId
+ * @param Key
+ * @param Value
+ *
+ * @return UINT64 The aggregated value of the key on the current core
+ * (the count of count and histogram aggregations)
+ */
+UINT64
+ScriptEngineAggregationUpdate(SCRIPT_ENGINE_AGGREGATION_TYPE Type, UINT64 MapId, UINT64 Key, UINT64 Value)
+{
+    PSCRIPT_ENGINE_AGGREGATION_TABLE Table = g_DbgState[KeGetCurrentProcessorNumber()].ScriptEngineAggregationTable;
+    PSCRIPT_ENGINE_AGGREGATION_ENTRY Entry;
+
+    if (Table == NULL)
+    {
+        return NULL;
+    }
+
+    Entry = ScriptEngineAggregationFind(Table, (UINT32)MapId, Key, Type);
+
+    if (Entry == NULL)
+    {
+        Table->DroppedUpdates++;
+        return NULL;
+    }
+
+    if (Entry->Count == 0 || Value < Entry->Min)
+    {
+        Entry->Min = Value;
+    }
+
+    if (Entry->Count == 0 || Value > Entry->Max)
+    {
+        Entry->Max = Value;
+    }
+
+    Entry->Sum += Value;
+    Entry->Count++;
+
+    switch (Type)
+    {
+    case SCRIPT_ENGINE_AGGREGATION_TYPE_SUM:
+        return Entry->Sum;
+
+    case SCRIPT_ENGINE_AGGREGATION_TYPE_MIN:
+        return Entry->Min;
+
+    case SCRIPT_ENGINE_AGGREGATION_TYPE_MAX:
+        return Entry->Max;
+
+    default:
+        return Entry->Count;
+    }
+}
+
+/**
+ * @brief Merge the values of a key from the aggregation tables of all cores
+ *
+ * @param MapId
+ * @param Key
+ * @param Merged The merged values
+ *
+ * @return VOID
+ */
+static VOID
+ScriptEngineAggregationMerge(UINT32 MapId, UINT64 Key, PSCRIPT_ENGINE_AGGREGATION_ENTRY Merged)
+{
+    PSCRIPT_ENGINE_AGGREGATION_TABLE Table;
+    PSCRIPT_ENGINE_AGGREGATION_ENTRY Entry;
+    ULONG                            ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    Merged->Count = 0;
+    Merged->Sum   = 0;
+    Merged->Min   = 0;
+    Merged->Max   = 0;
+
+    for (ULONG i = 0; i < ProcessorsCount; i++)
+    {
+        Table = g_DbgState[i].ScriptEngineAggregationTable;
+
+        if (Table == NULL ||
+            (Entry = ScriptEngineAggregationFind(Table, MapId, Key, SCRIPT_ENGINE_AGGREGATION_TYPE_UNUSED)) == NULL ||
+            Entry->Count == 0)
+        {
+            continue;
+        }
+
+        if (Merged->Count == 0 || Entry->Min < Merged->Min)
+        {
+            Merged->Min = Entry->Min;
+        }
+
+        if (Merged->Count == 0 || Entry->Max > Merged->Max)
+        {
+            Merged->Max = Entry->Max;
+        }
+
+        Merged->Sum += Entry->Sum;
+        Merged->Count += Entry->Count;
+    }
+}
+
+/**
+ * @brief Check whether a key is already found in the aggregation tables
+ * of the previous cores
+ *
+ * @param CoreId
+ * @param MapId
+ * @param Key
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+ScriptEngineAggregationIsInPreviousCores(ULONG CoreId, UINT32 MapId, UINT64 Key)
+{
+    PSCRIPT_ENGINE_AGGREGATION_TABLE Table;
+
+    for (ULONG i = 0; i < CoreId; i++)
+    {
+        Table = g_DbgState[i].ScriptEngineAggregationTable;
+
+        if (Table != NULL && ScriptEngineAggregationFind(Table, MapId, Key, SCRIPT_ENGINE_AGGREGATION_TYPE_UNUSED) != NULL)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Show the values of an aggregation map (merged from all cores)
+ * @details the tables of other cores are read while they might be
+ * updated, so the result is a snapshot of the map
+ *
+ * @param Tag
+ * @param ImmediateMessagePassing
+ * @param MapId
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineAggregationPrint(UINT64 Tag, BOOLEAN ImmediateMessagePassing, UINT64 MapId)
+{
+    PSCRIPT_ENGINE_AGGREGATION_TABLE Table;
+    PSCRIPT_ENGINE_AGGREGATION_ENTRY Entry;
+    SCRIPT_ENGINE_AGGREGATION_ENTRY  Merged          = {0};
+    ULONG                            ProcessorsCount = KeQueryActiveProcessorCount(0);
+    UINT64                           DroppedUpdates  = 0;
+    BOOLEAN                          IsHistogram     = FALSE;
+    UINT32                           TempBufferLen;
+    char                             TempBuffer[128];
+
+    for (ULONG i = 0; i < ProcessorsCount; i++)
+    {
+        Table = g_DbgState[i].ScriptEngineAggregationTable;
+
+        if (Table == NULL)
+        {
+            continue;
+        }
+
+        DroppedUpdates += Table->DroppedUpdates;
+
+        for (UINT32 j = 0; j < SCRIPT_ENGINE_AGGREGATION_TABLE_CAPACITY; j++)
+        {
+            Entry = &Table->Entries[j];
+
+            if (Entry->Type == SCRIPT_ENGINE_AGGREGATION_TYPE_UNUSED || Entry->MapId != (UINT32)MapId)
+            {
+                continue;
+            }
+
+            //
+            // Histograms are shown in the order of their buckets
+            //
+            if (Entry->Type == SCRIPT_ENGINE_AGGREGATION_TYPE_HISTOGRAM)
+            {
+                IsHistogram = TRUE;
+                continue;
+            }
+
+            //
+            // Each key is shown once (by the first core that has the key)
+            //
+            if (ScriptEngineAggregationIsInPreviousCores(i, Entry->MapId, Entry->Key))
+            {
+                continue;
+            }
+
+            ScriptEngineAggregationMerge(Entry->MapId, Entry->Key, &Merged);
+
+            if (Merged.Count == 0)
+            {
+                continue;
+            }
+
+            switch (Entry->Type)
+            {
+            case SCRIPT_ENGINE_AGGREGATION_TYPE_SUM:
+                TempBufferLen = sprintf(TempBuffer, "[%llx] : sum = %llx (count = %lld)\n", Entry->Key, Merged.Sum, Merged.Count);
+                break;
+
+            case SCRIPT_ENGINE_AGGREGATION_TYPE_MIN:
+                TempBufferLen = sprintf(TempBuffer, "[%llx] : min = %llx (count = %lld)\n", Entry->Key, Merged.Min, Merged.Count);
+                break;
+
+            case SCRIPT_ENGINE_AGGREGATION_TYPE_MAX:
+                TempBufferLen = sprintf(TempBuffer, "[%llx] : max = %llx (count = %lld)\n", Entry->Key, Merged.Max, Merged.Count);
+                break;
+
+            default:
+                TempBufferLen = sprintf(TempBuffer, "[%llx] : count = %lld\n", Entry->Key, Merged.Count);
+                break;
+            }
+
+            LogSimpleWithTag(Tag, ImmediateMessagePassing, TempBuffer, TempBufferLen + 1);
+        }
+    }
+
+    if (IsHistogram)
+    {
+        for (UINT64 Bucket = 0; Bucket < SCRIPT_ENGINE_AGGREGATION_HISTOGRAM_BUCKETS; Bucket++)
+        {
+            ScriptEngineAggregationMerge((UINT32)MapId, Bucket, &Merged);
+
+            if (Merged.Count == 0)
+            {
+                continue;
+            }
+
+            //
+            // Bucket n (n > 0) holds the values in [2^(n-1), 2^n - 1]
+            //
+            TempBufferLen = sprintf(TempBuffer,
+                                    "[%llx - %llx] : count = %lld\n",
+                                    Bucket == 0 ? 0 : 1ull << (Bucket - 1),
+                                    Bucket == 0 ? 0 : (Bucket == 64 ? MAXUINT64 : (1ull << Bucket) - 1),
+                                    Merged.Count);
+
+            LogSimpleWithTag(Tag, ImmediateMessagePassing, TempBuffer, TempBufferLen + 1);
+        }
+    }
+
+    if (DroppedUpdates != 0)
+    {
+        TempBufferLen = sprintf(TempBuffer,
+                                "warning, %lld updates of the aggregations are dropped (the table of the core is full)\n",
+                                DroppedUpdates);
+
+        LogSimpleWithTag(Tag, ImmediateMessagePassing, TempBuffer, TempBufferLen + 1);
+    }
+}
+
+/**
+ * @brief Reset the values of an aggregation map on all cores
+ * @details the keys are not removed, updates on other cores that race
+ * with clearing might be lost
+ *
+ * @param MapId
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineAggregationClear(UINT64 MapId)
+{
+    PSCRIPT_ENGINE_AGGREGATION_TABLE Table;
+    ULONG                            ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    for (ULONG i = 0; i < ProcessorsCount; i++)
+    {
+        Table = g_DbgState[i].ScriptEngineAggregationTable;
+
+        if (Table == NULL)
+        {
+            continue;
+        }
+
+        for (UINT32 j = 0; j < SCRIPT_ENGINE_AGGREGATION_TABLE_CAPACITY; j++)
+        {
+            if (Table->Entries[j].Type != SCRIPT_ENGINE_AGGREGATION_TYPE_UNUSED &&
+                Table->Entries[j].MapId == (UINT32)MapId)
+            {
+                Table->Entries[j].Count = 0;
+                Table->Entries[j].Sum   = 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Reduce a local variable of scripts on all cores
+ * @details local variables are kept separately for each core, so the
+ * scripts can update them without contention and read the combined
+ * value once it's needed
+ *
+ * @param Type The type of reduction
+ * @param Index Index of the local variable
+ *
+ * @return UINT64 The reduced value
+ */
+UINT64
+ScriptEngineReducePerCoreVariable(SCRIPT_ENGINE_PER_CORE_REDUCTION_TYPE Type, UINT32 Index)
+{
+    UINT64  Result          = NULL;
+    UINT64  Value;
+    BOOLEAN IsFirst         = TRUE;
+    ULONG   ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    for (ULONG i = 0; i < ProcessorsCount; i++)
+    {
+        if (g_DbgState[i].ScriptEngineCoreSpecificLocalVariable == NULL)
+        {
+            continue;
+        }
+
+        Value = g_DbgState[i].ScriptEngineCoreSpecificLocalVariable[Index];
+
+        switch (Type)
+        {
+        case SCRIPT_ENGINE_PER_CORE_REDUCTION_SUM:
+            Result += Value;
+            break;
+
+        case SCRIPT_ENGINE_PER_CORE_REDUCTION_MIN:
+            if (IsFirst || Value < Result)
+            {
+                Result = Value;
+            }
+            break;
+
+        case SCRIPT_ENGINE_PER_CORE_REDUCTION_MAX:
+            if (IsFirst || Value > Result)
+            {
+                Result = Value;
+            }
+            break;
+        }
+
+        IsFirst = FALSE;
+    }
+
+    return Result;
+}
+
+/**
+ * @brief The core that last wrote each global variable of scripts (the
+ * number of the core plus one, zero if the variable is not written)
+ *
+ */
+static volatile UINT32 g_ScriptEngineGlobalVariablesLastWriter[MAX_VAR_COUNT];
+
+/**
+ * @brief Whether the contention of global variables is reported or not
+ *
+ */
+static volatile LONG g_ScriptEngineGlobalVariablesContentionReported;
+
+/**
+ * @brief Reset the detection of contention of global variables of scripts
+ * @details called once the global variables are zeroed
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineGlobalVariablesResetContention()
+{
+    ULONG ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    RtlZeroMemory((PVOID)g_ScriptEngineGlobalVariablesLastWriter, sizeof(g_ScriptEngineGlobalVariablesLastWriter));
+
+    for (ULONG i = 0; i < ProcessorsCount; i++)
+    {
+        g_DbgState[i].ScriptEngineWritesWindowStart = 0;
+        g_DbgState[i].ScriptEngineCrossCoreWrites   = 0;
+    }
+
+    g_ScriptEngineGlobalVariablesContentionReported = FALSE;
+}
+
+/**
+ * @brief Track the writes to a global variable of scripts
+ * @details the cache line of a global variable is moved between cores
+ * once it's written from different cores, if it frequently happens, the
+ * user is warned (once) to use local (per-core) variables instead
+ *
+ * @param Index Index of the global variable
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineGlobalVariableWritten(UINT64 Index)
+{
+    ULONG                       CoreId = KeGetCurrentProcessorNumber();
+    PROCESSOR_DEBUGGING_STATE * DbgState;
+    UINT64                      CurrentTime;
+
+    //
+    // The last writer is only changed if another core has written the
+    // variable, so tracking the writes of a single core is only a read
+    //
+    if (Index >= MAX_VAR_COUNT || g_ScriptEngineGlobalVariablesLastWriter[Index] == CoreId + 1)
+    {
+        return;
+    }
+
+    g_ScriptEngineGlobalVariablesLastWriter[Index] = CoreId + 1;
+
+    if (g_ScriptEngineGlobalVariablesContentionReported)
+    {
+        return;
+    }
+
+    DbgState    = &g_DbgState[CoreId];
+    CurrentTime = KeQueryInterruptTime();
+
+    //
+    // The writes are counted in windows of one second (interrupt time is
+    // in 100-nanosecond units)
+    //
+    if (CurrentTime - DbgState->ScriptEngineWritesWindowStart >= 10000000)
+    {
+        DbgState->ScriptEngineWritesWindowStart = CurrentTime;
+        DbgState->ScriptEngineCrossCoreWrites   = 0;
+    }
+
+    DbgState->ScriptEngineCrossCoreWrites++;
+
+    if (DbgState->ScriptEngineCrossCoreWrites >= SCRIPT_ENGINE_GLOBAL_VARIABLES_CONTENTION_THRESHOLD &&
+        InterlockedExchange(&g_ScriptEngineGlobalVariablesContentionReported, TRUE) == FALSE)
+    {
+        LogWarning("Warning, global variables of the script are written from different cores more than %d times per second on core %x, "
+                   "use local variables (kept separately for each core) and read them by percpu_sum, percpu_min, or percpu_max to avoid the contention",
+                   SCRIPT_ENGINE_GLOBAL_VARIABLES_CONTENTION_THRESHOLD,
+                   CoreId);
+    }
+}
+
+/**
+ * @brief List of the shared codes of scripts
+ *
+ */
+static LIST_ENTRY g_ScriptEngineSharedCodesListHead = {&g_ScriptEngineSharedCodesListHead, &g_ScriptEngineSharedCodesListHead};
+
+/**
+ * @brief Lock of the list of the shared codes of scripts
+ *
+ */
+static volatile LONG g_ScriptEngineSharedCodesLock;
+
+/**
+ * @brief Hash of the symbols of a script (FNV-1a)
+ *
+ * @param ScriptBuffer
+ * @param ScriptLength
+ *
+ * @return UINT64
+ */
+static UINT64
+ScriptEngineSharedCodeHash(PVOID ScriptBuffer, UINT32 ScriptLength)
+{
+    UINT64 Hash = 0xcbf29ce484222325;
+
+    for (UINT32 i = 0; i < ScriptLength; i++)
+    {
+        Hash ^= ((UCHAR *)ScriptBuffer)[i];
+        Hash *= 0x100000001b3;
+    }
+
+    return Hash;
+}
+
+/**
+ * @brief Pre-compile the script of a shared code into bytecode
+ *
+ * @details should NOT be called in vmx-root
+ *
+ * @param SharedCode The shared code
+ * @return PSCRIPT_ENGINE_BYTECODE The compiled script or NULL if the
+ * script can't be compiled
+ */
+static PSCRIPT_ENGINE_BYTECODE
+ScriptEngineSharedCodeCompile(PSCRIPT_ENGINE_SHARED_CODE SharedCode)
+{
+    SYMBOL_BUFFER           CodeBuffer = {0};
+    PSCRIPT_ENGINE_BYTECODE Bytecode   = NULL;
+    PVOID                   NativeCode = NULL;
+    UINT32                  Size       = 0;
+
+    CodeBuffer.Head    = (PSYMBOL)((BYTE *)SharedCode + sizeof(SCRIPT_ENGINE_SHARED_CODE));
+    CodeBuffer.Size    = SharedCode->ScriptLength;
+    CodeBuffer.Pointer = SharedCode->ScriptPointer;
+
+    //
+    // Check whether the symbols are in the range of the script buffer
+    //
+    if ((UINT64)CodeBuffer.Pointer * sizeof(SYMBOL) > CodeBuffer.Size)
+    {
+        return NULL;
+    }
+
+    Size     = ScriptEngineBytecodeGetRequiredSize(&CodeBuffer);
+    Bytecode = ExAllocatePoolWithTag(NonPagedPool, Size, POOLTAG);
+
+    if (Bytecode == NULL)
+    {
+        return NULL;
+    }
+
+    if (!ScriptEngineBytecodeCompile(&CodeBuffer, Bytecode, Size))
+    {
+        ExFreePoolWithTag(Bytecode, POOLTAG);
+        return NULL;
+    }
+
+#if UseNativeCodeForScripts
+
+    //
+    // Compile the bytecode into native code, the non-paged pool is
+    // executable (the same as the buffer of custom codes), if it
+    // fails, the bytecode is interpreted
+    //
+    Size       = ScriptEngineJitGetRequiredSize(Bytecode);
+    NativeCode = ExAllocatePoolWithTag(NonPagedPool, Size, POOLTAG);
+
+    if (NativeCode != NULL && !ScriptEngineJitCompile(Bytecode, NativeCode, Size))
+    {
+        ExFreePoolWithTag(NativeCode, POOLTAG);
+    }
+
+#endif
+
+    return Bytecode;
+}
+
+/**
+ * @brief Get the shared code of a script
+ * @details if the same script is used by another action, then its code
+ * is shared, otherwise the script is copied to a new shared code and
+ * pre-compiled, should NOT be called in vmx-root
+ *
+ * @param ScriptBuffer The symbols of the script
+ * @param ScriptLength Length of the symbols of the script
+ * @param ScriptPointer Count of the symbols of the script
+ *
+ * @return PSCRIPT_ENGINE_SHARED_CODE NULL if it's not possible to
+ * allocate the shared code
+ */
+PSCRIPT_ENGINE_SHARED_CODE
+ScriptEngineAcquireSharedCode(PVOID ScriptBuffer, UINT32 ScriptLength, UINT32 ScriptPointer)
+{
+    PLIST_ENTRY                TempList   = 0;
+    PSCRIPT_ENGINE_SHARED_CODE SharedCode = NULL;
+    UINT64                     Hash       = ScriptEngineSharedCodeHash(ScriptBuffer, ScriptLength);
+
+    SpinlockLockNamed(&g_ScriptEngineSharedCodesLock, "kd: script shared codes (acquire)");
+
+    TempList = &g_ScriptEngineSharedCodesListHead;
+
+    while (&g_ScriptEngineSharedCodesListHead != TempList->Flink)
+    {
+        TempList                                 = TempList->Flink;
+        PSCRIPT_ENGINE_SHARED_CODE CurrentShared = CONTAINING_RECORD(TempList, SCRIPT_ENGINE_SHARED_CODE, SharedCodesList);
+
+        if (CurrentShared->Hash == Hash &&
+            CurrentShared->ScriptLength == ScriptLength &&
+            CurrentShared->ScriptPointer == ScriptPointer &&
+            RtlCompareMemory((BYTE *)CurrentShared + sizeof(SCRIPT_ENGINE_SHARED_CODE), ScriptBuffer, ScriptLength) == ScriptLength)
+        {
+            CurrentShared->ReferenceCount++;
+            SharedCode = CurrentShared;
+            break;
+        }
+    }
+
+    SpinlockUnlock(&g_ScriptEngineSharedCodesLock);
+
+    if (SharedCode != NULL)
+    {
+        return SharedCode;
+    }
+
+    //
+    // The script is not shared yet, it's compiled without holding the lock
+    //
+    SharedCode = ExAllocatePoolWithTag(NonPagedPool, sizeof(SCRIPT_ENGINE_SHARED_CODE) + ScriptLength, POOLTAG);
+
+    if (SharedCode == NULL)
+    {
+        return NULL;
+    }
+
+    RtlZeroMemory(SharedCode, sizeof(SCRIPT_ENGINE_SHARED_CODE));
+    RtlCopyMemory((BYTE *)SharedCode + sizeof(SCRIPT_ENGINE_SHARED_CODE), ScriptBuffer, ScriptLength);
+
+    SharedCode->Hash           = Hash;
+    SharedCode->ReferenceCount = 1;
+    SharedCode->ScriptLength   = ScriptLength;
+    SharedCode->ScriptPointer  = ScriptPointer;
+    SharedCode->Bytecode       = ScriptEngineSharedCodeCompile(SharedCode);
+
+    //
+    // If the same script is added meanwhile, then there are two copies of
+    // it which is still correct
+    //
+    SpinlockLockNamed(&g_ScriptEngineSharedCodesLock, "kd: script shared codes (insert)");
+    InsertHeadList(&g_ScriptEngineSharedCodesListHead, &SharedCode->SharedCodesList);
+    SpinlockUnlock(&g_ScriptEngineSharedCodesLock);
+
+    return SharedCode;
+}
+
+/**
+ * @brief Release the shared code of a script
+ * @details the code is freed once it's not used by any action, should
+ * NOT be called in vmx-root
+ *
+ * @param SharedCode The shared code
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineReleaseSharedCode(PSCRIPT_ENGINE_SHARED_CODE SharedCode)
+{
+    BOOLEAN IsUnused = FALSE;
+
+    SpinlockLockNamed(&g_ScriptEngineSharedCodesLock, "kd: script shared codes (release)");
+
+    SharedCode->ReferenceCount--;
+
+    if (SharedCode->ReferenceCount == 0)
+    {
+        RemoveEntryList(&SharedCode->SharedCodesList);
+        IsUnused = TRUE;
+    }
+
+    SpinlockUnlock(&g_ScriptEngineSharedCodesLock);
+
+    if (!IsUnused)
+    {
+        return;
+    }
+
+    if (SharedCode->Bytecode != NULL)
+    {
+        if (SharedCode->Bytecode->NativeCode != NULL)
+        {
+            ExFreePoolWithTag(SharedCode->Bytecode->NativeCode, POOLTAG);
+        }
+
+        ExFreePoolWithTag(SharedCode->Bytecode, POOLTAG);
+    }
+
+    ExFreePoolWithTag(SharedCode, POOLTAG);
+}
@@ -108,6 +108,390 @@ TestKernelPerformTests(PDEBUGGER_PERFORM_KERNEL_TESTS KernelTestRequest)
     KernelTestRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
 }
 
+/**
+ * @brief Measure the average round-trip cycles of an operation of the
+ * benchmark on the current core
+ *
+ * @param BenchmarkRequest The parameters of the benchmark
+ * @param Operation The target operation
+ * @return UINT64 Average cycles of each execution of the operation
+ */
+static UINT64
+TestKernelMeasureBenchmarkOperation(PDEBUGGER_PERFORM_KERNEL_BENCHMARK  BenchmarkRequest,
+                                    DEBUGGER_KERNEL_BENCHMARK_OPERATION Operation)
+{
+    INT32  CpuInfo[4];
+    UINT32 TscAux;
+    UINT64 StartTsc;
+    UINT64 EndTsc;
+    KIRQL  OldIrql;
+
+    //
+    // The core is not given to other threads while measuring
+    //
+    OldIrql = KeRaiseIrqlToDpcLevel();
+
+    StartTsc = __rdtscp(&TscAux);
+
+    for (UINT32 i = 0; i < BenchmarkRequest->Iterations; i++)
+    {
+        switch (Operation)
+        {
+        case DEBUGGER_KERNEL_BENCHMARK_CPUID:
+            __cpuid(CpuInfo, 0);
+            break;
+
+        case DEBUGGER_KERNEL_BENCHMARK_RDTSC:
+            __rdtsc();
+            break;
+
+        case DEBUGGER_KERNEL_BENCHMARK_RDTSCP:
+            __rdtscp(&TscAux);
+            break;
+
+        case DEBUGGER_KERNEL_BENCHMARK_RDMSR_TRAPPED:
+            __readmsr(BenchmarkRequest->TrappedMsr);
+            break;
+
+        case DEBUGGER_KERNEL_BENCHMARK_RDMSR_UNTRAPPED:
+            __readmsr(BenchmarkRequest->UntrappedMsr);
+            break;
+
+        case DEBUGGER_KERNEL_BENCHMARK_VMCALL:
+            VmFuncVmxBenchmarkVmcall();
+            break;
+
+        case DEBUGGER_KERNEL_BENCHMARK_IO_PORT:
+            __inbyte(BenchmarkRequest->IoPort);
+            break;
+
+        case DEBUGGER_KERNEL_BENCHMARK_EPT_HOOKED_PAGE:
+            *(volatile UINT64 *)g_KernelBenchmarkPage;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    EndTsc = __rdtscp(&TscAux);
+
+    KeLowerIrql(OldIrql);
+
+    return (EndTsc - StartTsc) / BenchmarkRequest->Iterations;
+}
+
+/**
+ * @brief Perform the kernel-side benchmark
+ * @details the operations are measured on each core, the results of the
+ * cores are stored after the request
+ *
+ * @param BenchmarkRequest user-mode buffer of the request and the results
+ * @param MaximumCoresCount Count of the results that fit in the buffer
+ * @return VOID
+ */
+VOID
+TestKernelPerformBenchmark(PDEBUGGER_PERFORM_KERNEL_BENCHMARK BenchmarkRequest, UINT32 MaximumCoresCount)
+{
+    PDEBUGGER_KERNEL_BENCHMARK_CORE_RESULT Results;
+    UINT32                                 CoresCount = KeQueryActiveProcessorCount(0);
+
+    if (BenchmarkRequest->Iterations == 0 || BenchmarkRequest->Iterations > TEST_BENCHMARK_MAXIMUM_ITERATIONS)
+    {
+        BenchmarkRequest->KernelStatus = DEBUGGER_ERROR_INVALID_BENCHMARK_PARAMETERS;
+        return;
+    }
+
+    Results = (PDEBUGGER_KERNEL_BENCHMARK_CORE_RESULT)((UINT8 *)BenchmarkRequest + SIZEOF_DEBUGGER_PERFORM_KERNEL_BENCHMARK);
+
+    //
+    // Only the cores that fit in the buffer (and in the affinity mask) are measured
+    //
+    if (CoresCount > MaximumCoresCount)
+    {
+        CoresCount = MaximumCoresCount;
+    }
+
+    if (CoresCount > sizeof(KAFFINITY) * 8)
+    {
+        CoresCount = sizeof(KAFFINITY) * 8;
+    }
+
+    for (UINT32 CoreId = 0; CoreId < CoresCount; CoreId++)
+    {
+        KeSetSystemAffinityThread((KAFFINITY)1 << CoreId);
+
+        for (UINT32 Operation = 0; Operation < DEBUGGER_KERNEL_BENCHMARK_OPERATIONS_COUNT; Operation++)
+        {
+            Results[CoreId].Cycles[Operation] = TestKernelMeasureBenchmarkOperation(BenchmarkRequest,
+                                                                                    (DEBUGGER_KERNEL_BENCHMARK_OPERATION)Operation);
+        }
+    }
+
+    KeRevertToUserAffinityThread();
+
+    BenchmarkRequest->CoresCount   = CoresCount;
+    BenchmarkRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+}
+
+/**
+ * @brief The target function of the stress test
+ * @details the debugger hooks this function while the threads of the
+ * stress test call it, so it should not be inlined
+ *
+ * @param Value
+ * @return UINT64
+ */
+__declspec(noinline) UINT64
+TestKernelStressTargetFunction(UINT64 Value)
+{
+    return Value * 3 + 1;
+}
+
+/**
+ * @brief Update the worst-case cycles of the operations of the stress test
+ *
+ * @param Context
+ * @param Cycles
+ * @return VOID
+ */
+static VOID
+TestKernelStressUpdateMaximumCycles(PTEST_KERNEL_STRESS_CONTEXT Context, UINT64 Cycles)
+{
+    LONG64 MaximumCycles = Context->MaximumCycles;
+
+    while ((LONG64)Cycles > MaximumCycles)
+    {
+        if (InterlockedCompareExchange64(&Context->MaximumCycles, (LONG64)Cycles, MaximumCycles) == MaximumCycles)
+        {
+            break;
+        }
+
+        MaximumCycles = Context->MaximumCycles;
+    }
+}
+
+/**
+ * @brief A thread of the stress test
+ * @details the operation of the scenario is performed on the core of the
+ * thread till the end of the duration
+ *
+ * @param Parameter The thread (TEST_KERNEL_STRESS_THREAD)
+ * @return VOID
+ */
+static VOID
+TestKernelStressThread(PVOID Parameter)
+{
+    PTEST_KERNEL_STRESS_THREAD  StressThread  = (PTEST_KERNEL_STRESS_THREAD)Parameter;
+    PTEST_KERNEL_STRESS_CONTEXT Context       = StressThread->Context;
+    UINT64                      Operations    = 0;
+    UINT64                      Failed        = 0;
+    UINT64                      TotalCycles   = 0;
+    UINT64                      MaximumCycles = 0;
+    UINT64                      Payload       = (UINT64)StressThread->CoreId << 48;
+    volatile UINT64             Result        = 0;
+    UINT64                      StartTsc;
+    UINT64                      Cycles;
+
+    KeSetSystemAffinityThread((KAFFINITY)1 << StressThread->CoreId);
+
+    //
+    // The threads have the lowest priority, so the reader of the messages
+    // and the debugger are not starved
+    //
+    KeSetPriorityThread(KeGetCurrentThread(), LOW_PRIORITY + 1);
+
+    KeWaitForSingleObject(&Context->StartEvent, Executive, KernelMode, FALSE, NULL);
+
+    while (!Context->IsStopping && KeQueryInterruptTime() < Context->Deadline)
+    {
+        StartTsc = __rdtsc();
+
+        switch (Context->Scenario)
+        {
+        case DEBUGGER_KERNEL_STRESS_CALL_TARGET_FUNCTION:
+
+            Result += TestKernelStressTargetFunction(Operations);
+            break;
+
+        case DEBUGGER_KERNEL_STRESS_LOG_FLOOD:
+
+            Payload++;
+
+            if (!LogCallbackSendBuffer(OPERATION_LOG_STRESS_TEST_MESSAGE, &Payload, sizeof(Payload), FALSE))
+            {
+                Failed++;
+            }
+
+            break;
+
+        default:
+            break;
+        }
+
+        Cycles = __rdtsc() - StartTsc;
+
+        Operations++;
+        TotalCycles += Cycles;
+
+        if (Cycles > MaximumCycles)
+        {
+            MaximumCycles = Cycles;
+        }
+    }
+
+    InterlockedAdd64(&Context->Operations, Operations);
+    InterlockedAdd64(&Context->FailedOperations, Failed);
+    InterlockedAdd64(&Context->TotalCycles, TotalCycles);
+    TestKernelStressUpdateMaximumCycles(Context, MaximumCycles);
+
+    if (InterlockedDecrement(&Context->RunningThreads) == 0)
+    {
+        KeSetEvent(&Context->FinishedEvent, IO_NO_INCREMENT, FALSE);
+    }
+
+    PsTerminateSystemThread(STATUS_SUCCESS);
+}
+
+/**
+ * @brief Perform a scenario of the kernel-side stress test
+ * @details threads are created on each core and perform the operation of
+ * the scenario for the duration, the threads that are not finished after
+ * the duration (plus TEST_STRESS_HANG_TIMEOUT) are reported as hung and
+ * their resources are never freed
+ *
+ * @param StressRequest user-mode buffer of the request and the results
+ * @return VOID
+ */
+VOID
+TestKernelPerformStress(PDEBUGGER_PERFORM_KERNEL_STRESS StressRequest)
+{
+    PTEST_KERNEL_STRESS_CONTEXT Context;
+    PTEST_KERNEL_STRESS_THREAD  Threads;
+    HANDLE                      ThreadHandle;
+    NTSTATUS                    Status;
+    LARGE_INTEGER               Timeout;
+    UINT64                      StartTime;
+    UINT32                      CoresCount     = KeQueryActiveProcessorCount(0);
+    UINT32                      CountOfThreads;
+    UINT32                      CreatedThreads = 0;
+
+    if (StressRequest->ThreadsPerCore == 0 || StressRequest->ThreadsPerCore > TEST_STRESS_MAXIMUM_THREADS_PER_CORE ||
+        StressRequest->Duration == 0 || StressRequest->Duration > TEST_STRESS_MAXIMUM_DURATION ||
+        (StressRequest->Scenario != DEBUGGER_KERNEL_STRESS_CALL_TARGET_FUNCTION && StressRequest->Scenario != DEBUGGER_KERNEL_STRESS_LOG_FLOOD))
+    {
+        StressRequest->KernelStatus = DEBUGGER_ERROR_INVALID_STRESS_TEST_PARAMETERS;
+        return;
+    }
+
+    //
+    // Only the cores that fit in the affinity mask are used
+    //
+    if (CoresCount > sizeof(KAFFINITY) * 8)
+    {
+        CoresCount = sizeof(KAFFINITY) * 8;
+    }
+
+    CountOfThreads = CoresCount * StressRequest->ThreadsPerCore;
+
+    Context = (PTEST_KERNEL_STRESS_CONTEXT)ExAllocatePoolWithTag(NonPagedPool,
+                                                                  sizeof(TEST_KERNEL_STRESS_CONTEXT) + CountOfThreads * sizeof(TEST_KERNEL_STRESS_THREAD),
+                                                                  POOLTAG);
+
+    if (Context == NULL)
+    {
+        StressRequest->KernelStatus = DEBUGGER_ERROR_UNABLE_TO_CREATE_STRESS_TEST_THREADS;
+        return;
+    }
+
+    RtlZeroMemory(Context, sizeof(TEST_KERNEL_STRESS_CONTEXT) + CountOfThreads * sizeof(TEST_KERNEL_STRESS_THREAD));
+
+    Threads           = (PTEST_KERNEL_STRESS_THREAD)((UINT8 *)Context + sizeof(TEST_KERNEL_STRESS_CONTEXT));
+    Context->Scenario = StressRequest->Scenario;
+    Context->Deadline = MAXULONG64;
+
+    KeInitializeEvent(&Context->StartEvent, NotificationEvent, FALSE);
+    KeInitializeEvent(&Context->FinishedEvent, NotificationEvent, FALSE);
+
+    for (UINT32 i = 0; i < CountOfThreads; i++)
+    {
+        Threads[CreatedThreads].Context = Context;
+        Threads[CreatedThreads].CoreId  = i % CoresCount;
+
+        InterlockedIncrement(&Context->RunningThreads);
+
+        Status = PsCreateSystemThread(&ThreadHandle, THREAD_ALL_ACCESS, NULL, NULL, NULL, TestKernelStressThread, &Threads[CreatedThreads]);
+
+        if (!NT_SUCCESS(Status))
+        {
+            InterlockedDecrement(&Context->RunningThreads);
+            continue;
+        }
+
+        //
+        // The thread object is referenced, so the thread can be waited for
+        //
+        ObReferenceObjectByHandle(ThreadHandle, THREAD_ALL_ACCESS, *PsThreadType, KernelMode, &Threads[CreatedThreads].Thread, NULL);
+        ZwClose(ThreadHandle);
+
+        CreatedThreads++;
+    }
+
+    if (CreatedThreads == 0)
+    {
+        ExFreePoolWithTag(Context, POOLTAG);
+
+        StressRequest->KernelStatus = DEBUGGER_ERROR_UNABLE_TO_CREATE_STRESS_TEST_THREADS;
+        return;
+    }
+
+    //
+    // Start all the threads at once
+    //
+    StartTime         = KeQueryInterruptTime();
+    Context->Deadline = StartTime + (UINT64)StressRequest->Duration * 10000;
+
+    KeSetEvent(&Context->StartEvent, IO_NO_INCREMENT, FALSE);
+
+    Timeout.QuadPart = -((LONGLONG)StressRequest->Duration + TEST_STRESS_HANG_TIMEOUT) * 10000;
+
+    if (KeWaitForSingleObject(&Context->FinishedEvent, Executive, KernelMode, FALSE, &Timeout) == STATUS_TIMEOUT)
+    {
+        //
+        // The hung threads might still use the context, so it's not freed
+        //
+        InterlockedExchange(&Context->IsStopping, TRUE);
+
+        StressRequest->HungThreads = Context->RunningThreads;
+
+        LogError("Err, %x threads of the stress test are hung", StressRequest->HungThreads);
+    }
+    else
+    {
+        for (UINT32 i = 0; i < CreatedThreads; i++)
+        {
+            if (Threads[i].Thread != NULL)
+            {
+                KeWaitForSingleObject(Threads[i].Thread, Executive, KernelMode, FALSE, NULL);
+                ObDereferenceObject(Threads[i].Thread);
+            }
+        }
+    }
+
+    StressRequest->ElapsedTime      = KeQueryInterruptTime() - StartTime;
+    StressRequest->CountOfThreads   = CreatedThreads;
+    StressRequest->Operations       = Context->Operations;
+    StressRequest->FailedOperations = Context->FailedOperations;
+    StressRequest->TotalCycles      = Context->TotalCycles;
+    StressRequest->MaximumCycles    = Context->MaximumCycles;
+    StressRequest->KernelStatus     = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    if (StressRequest->HungThreads == 0)
+    {
+        ExFreePoolWithTag(Context, POOLTAG);
+    }
+}
+
 /**
  * @brief Collect the kernel-side debugging informations
  *
@@ -148,6 +532,18 @@ TestKernelGetInformation(PDEBUGGEE_KERNEL_AND_USER_TEST_INFORMATION InfoRequest)
 
     // ------------------------------------------------------
 
+    Index                    = 3;
+    InfoRequest[Index].Value = g_KernelBenchmarkPage;
+    memcpy(&InfoRequest[Index].Tag, "KernelBenchmarkPage", strlen("KernelBenchmarkPage") + 1);
+
+    // ------------------------------------------------------
+
+    Index                    = 4;
+    InfoRequest[Index].Value = TestKernelStressTargetFunction;
+    memcpy(&InfoRequest[Index].Tag, "KernelStressTargetFunction", strlen("KernelStressTargetFunction") + 1);
+
+    // ------------------------------------------------------
+
     //
     // Check maximum index
     //
@@ -12,6 +12,49 @@
  */
 #include "pch.h"
 
+/**
+ * @brief Find the system call number of NtWaitForSingleObject
+ * @details the number is read from the system service stub of
+ * ZwWaitForSingleObject (push rax; mov eax, imm32), if it's not found,
+ * the paused threads spin on the nop sled
+ *
+ * @return VOID
+ */
+VOID
+AttachingFindWaitSyscallNumber()
+{
+    UNICODE_STRING RoutineName;
+    PUCHAR         ZwWaitForSingleObjectStub;
+
+    RtlInitUnicodeString(&RoutineName, L"ZwWaitForSingleObject");
+
+    ZwWaitForSingleObjectStub = (PUCHAR)MmGetSystemRoutineAddress(&RoutineName);
+
+    if (ZwWaitForSingleObjectStub == NULL)
+    {
+        return;
+    }
+
+    for (UINT32 i = 0; i < 0x20; i++)
+    {
+        if (ZwWaitForSingleObjectStub[i] == 0x50 && ZwWaitForSingleObjectStub[i + 1] == 0xb8)
+        {
+            UINT32 SyscallNumber = *(UINT32 *)(ZwWaitForSingleObjectStub + i + 2);
+
+            //
+            // System call numbers of the services (not the win32k ones) are small
+            //
+            if (SyscallNumber < 0x1000)
+            {
+                g_NtWaitForSingleObjectSyscallNumber        = SyscallNumber;
+                g_IsNtWaitForSingleObjectSyscallNumberFound = TRUE;
+            }
+
+            return;
+        }
+    }
+}
+
 /**
  * @brief Initialize the attaching mechanism
  * @details as we use the functionalities for these functions, we initialize
@@ -83,9 +126,149 @@ AttachingInitialize()
         }
     }
 
+    //
+    // Find the system call number of NtWaitForSingleObject
+    //
+    if (!g_IsNtWaitForSingleObjectSyscallNumberFound)
+    {
+        AttachingFindWaitSyscallNumber();
+    }
+
     return TRUE;
 }
 
+/**
+ * @brief Create the event that the paused threads of the process wait on
+ * @details the handle is created in the handle table of the process as the
+ * parked threads wait on it from the user-mode, if the event is not created,
+ * the paused threads spin on the nop sled
+ *
+ * @param ProcessDebuggingDetail
+ * @return VOID
+ */
+VOID
+AttachingCreateParkingEvent(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail)
+{
+    PEPROCESS         SourceProcess;
+    KAPC_STATE        State              = {0};
+    OBJECT_ATTRIBUTES ObjectAttributes   = {0};
+    HANDLE            ParkingEventHandle = NULL;
+    PKEVENT           ParkingEvent       = NULL;
+    NTSTATUS          Status;
+
+    //
+    // The parking stub is a 64-bit code (syscall is not available on
+    // the compatibility mode)
+    //
+    if (!g_IsNtWaitForSingleObjectSyscallNumberFound || ProcessDebuggingDetail->Is32Bit)
+    {
+        return;
+    }
+
+    if (PsLookupProcessByProcessId(ProcessDebuggingDetail->ProcessId, &SourceProcess) != STATUS_SUCCESS)
+    {
+        return;
+    }
+
+    KeStackAttachProcess(SourceProcess, &State);
+
+    //
+    // Not a kernel handle, the handle should be usable from the user-mode
+    //
+    InitializeObjectAttributes(&ObjectAttributes, NULL, 0, NULL, NULL);
+
+    Status = ZwCreateEvent(&ParkingEventHandle, EVENT_ALL_ACCESS, &ObjectAttributes, NotificationEvent, FALSE);
+
+    if (NT_SUCCESS(Status))
+    {
+        Status = ObReferenceObjectByHandle(ParkingEventHandle,
+                                           EVENT_ALL_ACCESS,
+                                           *ExEventObjectType,
+                                           KernelMode,
+                                           &ParkingEvent,
+                                           NULL);
+
+        if (!NT_SUCCESS(Status))
+        {
+            ZwClose(ParkingEventHandle);
+        }
+    }
+
+    KeUnstackDetachProcess(&State);
+
+    ObDereferenceObject(SourceProcess);
+
+    if (!NT_SUCCESS(Status))
+    {
+        LogWarning("Warning, unable to create the parking event, the paused threads spin on the nop sled");
+        return;
+    }
+
+    ProcessDebuggingDetail->ParkingEventHandle = ParkingEventHandle;
+    ProcessDebuggingDetail->ParkingEvent       = ParkingEvent;
+}
+
+/**
+ * @brief Free the event that the paused threads of the process wait on
+ *
+ * @param ProcessDebuggingDetail
+ * @return VOID
+ */
+VOID
+AttachingFreeParkingEvent(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail)
+{
+    PEPROCESS  SourceProcess;
+    KAPC_STATE State = {0};
+
+    if (ProcessDebuggingDetail->ParkingEvent == NULL)
+    {
+        return;
+    }
+
+    //
+    // Wake the threads that are still waiting
+    //
+    KeSetEvent(ProcessDebuggingDetail->ParkingEvent, IO_NO_INCREMENT, FALSE);
+
+    //
+    // The handle is closed if the process is still running
+    //
+    if (PsLookupProcessByProcessId(ProcessDebuggingDetail->ProcessId, &SourceProcess) == STATUS_SUCCESS)
+    {
+        if (SourceProcess == ProcessDebuggingDetail->Eprocess)
+        {
+            KeStackAttachProcess(SourceProcess, &State);
+
+            ZwClose(ProcessDebuggingDetail->ParkingEventHandle);
+
+            KeUnstackDetachProcess(&State);
+        }
+
+        ObDereferenceObject(SourceProcess);
+    }
+
+    ObDereferenceObject(ProcessDebuggingDetail->ParkingEvent);
+
+    ProcessDebuggingDetail->ParkingEvent       = NULL;
+    ProcessDebuggingDetail->ParkingEventHandle = NULL;
+}
+
+/**
+ * @brief Signal the event that the paused threads of the process wait on
+ * @details should be called after applying the actions to the paused threads
+ *
+ * @param ProcessDebuggingDetail
+ * @return VOID
+ */
+VOID
+AttachingSignalParkingEvent(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail)
+{
+    if (ProcessDebuggingDetail->ParkingEvent != NULL)
+    {
+        KeSetEvent(ProcessDebuggingDetail->ParkingEvent, IO_NO_INCREMENT, FALSE);
+    }
+}
+
 /**
  * @brief Create user-mode debugging details for threads
  *
@@ -143,6 +326,11 @@ AttachingCreateProcessDebuggingDetails(UINT32    ProcessId,
         return NULL;
     }
 
+    //
+    // Create the event for parking the paused threads
+    //
+    AttachingCreateParkingEvent(ProcessDebuggingDetail);
+
     //
     // Attach it to the list of active thread (LIST_ENTRY)
     //
@@ -230,11 +418,21 @@ AttachingRemoveAndFreeAllProcessDebuggingDetails()
 {
     LIST_FOR_EACH_LINK(g_ProcessDebuggingDetailsListHead, USERMODE_DEBUGGING_PROCESS_DETAILS, AttachedProcessList, ProcessDebuggingDetails)
     {
+        //
+        // Remove the cr3s of the process from the filter of mov-to-cr3 vm-exits
+        //
+        AttachingRemoveCr3VmexitFilter(ProcessDebuggingDetails);
+
         //
         // Free the thread holding structure(s)
         //
         ThreadHolderFreeHoldingStructures(ProcessDebuggingDetails);
 
+        //
+        // Free the parking event
+        //
+        AttachingFreeParkingEvent(ProcessDebuggingDetails);
+
         //
         // Remove thread debugging detail from the list active threads
         //
@@ -271,11 +469,21 @@ AttachingRemoveProcessDebuggingDetailsByToken(UINT64 Token)
         return FALSE;
     }
 
+    //
+    // Remove the cr3s of the process from the filter of mov-to-cr3 vm-exits
+    //
+    AttachingRemoveCr3VmexitFilter(ProcessDebuggingDetails);
+
     //
     // Free the thread holding structure(s)
     //
     ThreadHolderFreeHoldingStructures(ProcessDebuggingDetails);
 
+    //
+    // Free the parking event
+    //
+    AttachingFreeParkingEvent(ProcessDebuggingDetails);
+
     //
     // Remove thread debugging detail from the list active threads
     //
@@ -539,6 +747,23 @@ AttachingAdjustNopSledBuffer(UINT64 ReservedBuffAddress, UINT32 ProcessId)
         *(UINT16 *)(ReservedBuffAddress + PAGE_SIZE - 4) = 0xa20f;
         *(UINT16 *)(ReservedBuffAddress + PAGE_SIZE - 2) = 0xf4eb;
 
+        //
+        // Set the parking stub at the start of the buffer (the nop sled
+        // starts after it), the registers of the syscall are set by the
+        // cpuid (if there is no command for the thread)
+        //
+        // 0000000000000000 <ParkingLoop>:
+        // 0:  0f a2                   cpuid
+        // 2:  0f 05                   syscall  ; NtWaitForSingleObject
+        // 4:  eb fa                   jmp    0 <ParkingLoop>
+        // 8:  <timeout of the wait>
+        //
+        *(UINT16 *)(ReservedBuffAddress + USERMODE_RESERVED_BUFFER_PARKING_STUB_OFFSET + 0) = 0xa20f;
+        *(UINT16 *)(ReservedBuffAddress + USERMODE_RESERVED_BUFFER_PARKING_STUB_OFFSET + 2) = 0x050f;
+        *(UINT16 *)(ReservedBuffAddress + USERMODE_RESERVED_BUFFER_PARKING_STUB_OFFSET + 4) = 0xfaeb;
+
+        *(INT64 *)(ReservedBuffAddress + USERMODE_RESERVED_BUFFER_PARKING_TIMEOUT_OFFSET) = USERMODE_PARKING_WAIT_TIMEOUT;
+
         KeUnstackDetachProcess(&State);
 
         ObDereferenceObject(SourceProcess);
@@ -738,6 +963,123 @@ AttachingCheckPageFaultsWithUserDebugger(UINT32 CoreId,
     return FALSE;
 }
 
+/**
+ * @brief Apply the filter of mov-to-cr3 vm-exits for the thread intercepting
+ * phase of the target process
+ * @details once the filter is applied, only the mov-to-cr3s that load (or
+ * leave) the address spaces of the target process are handled by the full
+ * path and the mov-to-cr3s of other processes are emulated in the fast-path
+ * of the hypervisor, if the filter is full then all of the mov-to-cr3s are
+ * handled by the full path (same as before)
+ *
+ * @param ProcessDebuggingDetail
+ * @return VOID
+ */
+VOID
+AttachingApplyCr3VmexitFilter(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail)
+{
+    ProcessDebuggingDetail->Cr3VmexitFilterKernelCr3.Flags = ((NT_KPROCESS *)ProcessDebuggingDetail->Eprocess)->DirectoryTableBase;
+
+    if (!VmFuncSetCr3VmexitFilter(TRUE, ProcessDebuggingDetail->Cr3VmexitFilterKernelCr3.Flags))
+    {
+        //
+        // The filter is full, all of the mov-to-cr3s are handled by the full path
+        //
+        return;
+    }
+
+    ProcessDebuggingDetail->IsCr3VmexitFilterApplied = TRUE;
+
+    //
+    // The cr3s that are intercepted previously (e.g., the user-mode cr3 of the
+    // process because of KVA shadowing) are also added here, other cr3s are
+    // added once the mov-to-cr3s of the process load them
+    //
+    for (size_t i = 0; i < MAX_CR3_IN_A_PROCESS; i++)
+    {
+        if (ProcessDebuggingDetail->InterceptedCr3[i].Flags != NULL)
+        {
+            AttachingAddCr3ToCr3VmexitFilter(ProcessDebuggingDetail, (UINT32)i);
+        }
+    }
+}
+
+/**
+ * @brief Add an intercepted cr3 of the target process to the filter of
+ * mov-to-cr3 vm-exits
+ * @details can be called from vmx-root, if there is no free entry then
+ * the filter is bypassed until the thread intercepting phase is finished,
+ * each intercepted cr3 holds at most one reference of the filter
+ *
+ * @param ProcessDebuggingDetail
+ * @param Index Index of the cr3 in the intercepted cr3s
+ * @return VOID
+ */
+VOID
+AttachingAddCr3ToCr3VmexitFilter(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail, UINT32 Index)
+{
+    if (!ProcessDebuggingDetail->IsCr3VmexitFilterApplied ||
+        InterlockedBitTestAndSet(&ProcessDebuggingDetail->Cr3VmexitFilterReferences, Index))
+    {
+        return;
+    }
+
+    if (!VmFuncSetCr3VmexitFilter(TRUE, ProcessDebuggingDetail->InterceptedCr3[Index].Flags))
+    {
+        //
+        // No reference is held for this cr3
+        //
+        InterlockedBitTestAndReset(&ProcessDebuggingDetail->Cr3VmexitFilterReferences, Index);
+
+        //
+        // The mov-to-cr3s of this cr3 are not filtered, so the filter should
+        // be bypassed (only once for each process)
+        //
+        if (!InterlockedExchange(&ProcessDebuggingDetail->IsCr3VmexitFilterBypassed, TRUE))
+        {
+            VmFuncBypassCr3VmexitFilter(TRUE);
+        }
+    }
+}
+
+/**
+ * @brief Remove the cr3s of the target process from the filter of
+ * mov-to-cr3 vm-exits
+ *
+ * @param ProcessDebuggingDetail
+ * @return VOID
+ */
+VOID
+AttachingRemoveCr3VmexitFilter(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail)
+{
+    if (!ProcessDebuggingDetail->IsCr3VmexitFilterApplied)
+    {
+        return;
+    }
+
+    ProcessDebuggingDetail->IsCr3VmexitFilterApplied = FALSE;
+
+    VmFuncSetCr3VmexitFilter(FALSE, ProcessDebuggingDetail->Cr3VmexitFilterKernelCr3.Flags);
+
+    //
+    // Only the references of this process are released, the same address
+    // spaces might also be filtered by other requesters (e.g., the process
+    // switch of the debugger)
+    //
+    for (LONG i = 0; i < MAX_CR3_IN_A_PROCESS; i++)
+    {
+        if (InterlockedBitTestAndReset(&ProcessDebuggingDetail->Cr3VmexitFilterReferences, i))
+        {
+            VmFuncSetCr3VmexitFilter(FALSE, ProcessDebuggingDetail->InterceptedCr3[i].Flags);
+        }
+    }
+
+    if (InterlockedExchange(&ProcessDebuggingDetail->IsCr3VmexitFilterBypassed, FALSE))
+    {
+        VmFuncBypassCr3VmexitFilter(FALSE);
+    }
+}
+
 /**
  * @brief Enable or disable the thread intercepting phase
  * @details this function should be called in vmx non-root
@@ -786,6 +1128,12 @@ AttachingConfigureInterceptingThreads(UINT64 ProcessDebuggingToken, BOOLEAN Enab
 
     if (Enable)
     {
+        //
+        // Only the mov 2 cr3s of the target process should reach to the
+        // handler, the filter is applied before the vm-exits are enabled
+        //
+        AttachingApplyCr3VmexitFilter(ProcessDebuggingDetail);
+
         //
         // Intercept all mov 2 cr3s
         //
@@ -797,6 +1145,11 @@ AttachingConfigureInterceptingThreads(UINT64 ProcessDebuggingToken, BOOLEAN Enab
         // Removing the mov to cr3 vm-exits
         //
         DebuggerEventDisableMovToCr3ExitingOnAllProcessors();
+
+        //
+        // Remove the cr3s of the process from the filter
+        //
+        AttachingRemoveCr3VmexitFilter(ProcessDebuggingDetail);
     }
 
     //
@@ -992,6 +1345,7 @@ AttachingPerformAttachToProcess(PDEBUGGER_ATTACH_DETACH_USER_MODE_PROCESS Attach
             AttachRequest->ProcessId,
             TRUE,
             TRUE,
+            FALSE,
             FALSE);
 
         if (!ResultOfApplyingEvent)
@@ -1091,6 +1445,13 @@ AttachingHandleCr3VmexitsForThreadInterception(UINT32 CoreId, CR3_TYPE NewCr3)
             // Save the cr3
             //
             ProcessDebuggingDetail->InterceptedCr3[i].Flags = NewCr3.Flags;
+
+            //
+            // The mov-to-cr3s of this cr3 (e.g., the user-mode cr3 of the
+            // process because of KVA shadowing) should also reach here
+            //
+            AttachingAddCr3ToCr3VmexitFilter(ProcessDebuggingDetail, (UINT32)i);
+
             break;
         }
     }
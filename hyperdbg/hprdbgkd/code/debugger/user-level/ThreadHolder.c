@@ -12,6 +12,142 @@
  */
 #include "pch.h"
 
+/**
+ * @brief Get the first slot of a thread in the index of the threads
+ * @details thread ids are multiples of four, so the low bits are dropped
+ * before the (multiplicative) hashing
+ *
+ * @param ThreadId
+ * @return UINT32
+ */
+static UINT32
+ThreadHolderIndexHash(UINT32 ThreadId)
+{
+    return ((ThreadId >> 2) * 0x9e3779b9) & (THREAD_HOLDER_INDEX_CAPACITY - 1);
+}
+
+/**
+ * @brief Find a thread in the index of the threads
+ *
+ * @param ThreadId
+ * @param ProcessDebuggingDetail The process of the thread (NULL for any process)
+ * @return PTHREAD_HOLDER_INDEX_ENTRY NULL if the thread is not in the index
+ */
+static PTHREAD_HOLDER_INDEX_ENTRY
+ThreadHolderIndexFind(UINT32 ThreadId, PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail)
+{
+    UINT32 Slot = ThreadHolderIndexHash(ThreadId);
+
+    for (UINT32 i = 0; i < THREAD_HOLDER_INDEX_MAXIMUM_PROBES; i++)
+    {
+        PTHREAD_HOLDER_INDEX_ENTRY Entry           = &g_ThreadHolderIndex[(Slot + i) & (THREAD_HOLDER_INDEX_CAPACITY - 1)];
+        UINT32                     CurrentThreadId = Entry->ThreadId;
+
+        if (CurrentThreadId == NULL)
+        {
+            //
+            // The thread is never added after this slot
+            //
+            return NULL;
+        }
+
+        if (CurrentThreadId == ThreadId &&
+            (ProcessDebuggingDetail == NULL || Entry->ProcessDetails == ProcessDebuggingDetail))
+        {
+            return Entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add a thread to the index of the threads
+ * @details should be called while holding VmxRootThreadHoldingLock
+ *
+ * @param ThreadDebuggingDetail
+ * @param ProcessDebuggingDetail
+ * @return VOID
+ */
+static VOID
+ThreadHolderIndexInsert(PUSERMODE_DEBUGGING_THREAD_DETAILS  ThreadDebuggingDetail,
+                        PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail)
+{
+    UINT32 Slot = ThreadHolderIndexHash(ThreadDebuggingDetail->ThreadId);
+
+    for (UINT32 i = 0; i < THREAD_HOLDER_INDEX_MAXIMUM_PROBES; i++)
+    {
+        PTHREAD_HOLDER_INDEX_ENTRY Entry = &g_ThreadHolderIndex[(Slot + i) & (THREAD_HOLDER_INDEX_CAPACITY - 1)];
+
+        if (Entry->ThreadId == NULL || Entry->ThreadId == THREAD_HOLDER_INDEX_REMOVED_THREAD_ID)
+        {
+            Entry->ThreadDetails  = ThreadDebuggingDetail;
+            Entry->ProcessDetails = ProcessDebuggingDetail;
+
+            //
+            // The thread id is set at last to make the slot visible to the lookups
+            //
+            InterlockedExchange((volatile LONG *)&Entry->ThreadId, ThreadDebuggingDetail->ThreadId);
+
+            return;
+        }
+    }
+
+    //
+    // All of the probed slots are used, this thread is only found by
+    // searching the thread holders
+    //
+    g_ThreadHolderIndexIsIncomplete = TRUE;
+}
+
+/**
+ * @brief Remove the threads of a process from the index of the threads
+ *
+ * @param ProcessDebuggingDetail
+ * @return VOID
+ */
+static VOID
+ThreadHolderIndexRemoveProcess(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail)
+{
+    BOOLEAN IsAnyThreadIndexed = FALSE;
+
+    SpinlockLock(&VmxRootThreadHoldingLock);
+
+    for (UINT32 i = 0; i < THREAD_HOLDER_INDEX_CAPACITY; i++)
+    {
+        UINT32 CurrentThreadId = g_ThreadHolderIndex[i].ThreadId;
+
+        if (CurrentThreadId == NULL || CurrentThreadId == THREAD_HOLDER_INDEX_REMOVED_THREAD_ID)
+        {
+            continue;
+        }
+
+        if (g_ThreadHolderIndex[i].ProcessDetails == ProcessDebuggingDetail)
+        {
+            //
+            // The slot is marked as removed (not zeroed) to keep the probing
+            // of the next slots
+            //
+            InterlockedExchange((volatile LONG *)&g_ThreadHolderIndex[i].ThreadId, THREAD_HOLDER_INDEX_REMOVED_THREAD_ID);
+        }
+        else
+        {
+            IsAnyThreadIndexed = TRUE;
+        }
+    }
+
+    if (!IsAnyThreadIndexed)
+    {
+        //
+        // No thread is remained, the index is cleared to remove the removed slots
+        //
+        RtlZeroMemory(g_ThreadHolderIndex, sizeof(g_ThreadHolderIndex));
+        g_ThreadHolderIndexIsIncomplete = FALSE;
+    }
+
+    SpinlockUnlock(&VmxRootThreadHoldingLock);
+}
+
 /**
  * @brief Pre allocate buffer for thread holder
  *
@@ -24,6 +160,7 @@ ThreadHolderAllocateThreadHoldingBuffers()
     // Request to allocate two buffer for holder of threads
     //
     PoolManagerRequestAllocation(sizeof(USERMODE_DEBUGGING_THREAD_HOLDER), 2, PROCESS_THREAD_HOLDER);
+    PoolManagerSetWatermarks(PROCESS_THREAD_HOLDER, 1, 2);
 
     //
     // As it might be called from an attaching request and never find a
@@ -98,6 +235,46 @@ ThreadHolderIsAnyPausedThreadInProcess(PUSERMODE_DEBUGGING_PROCESS_DETAILS Proce
     return FALSE;
 }
 
+/**
+ * @brief Check if there is any paused thread with a pending action in the process
+ * @details This function can be used in vmx-root
+ *
+ * @param ProcessDebuggingDetail
+ * @return BOOLEAN
+ */
+BOOLEAN
+ThreadHolderIsAnyPendingActionInProcess(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail)
+{
+    PLIST_ENTRY TempList = 0;
+
+    TempList = &ProcessDebuggingDetail->ThreadsListHead;
+
+    while (&ProcessDebuggingDetail->ThreadsListHead != TempList->Flink)
+    {
+        TempList = TempList->Flink;
+        PUSERMODE_DEBUGGING_THREAD_HOLDER ThreadHolder =
+            CONTAINING_RECORD(TempList, USERMODE_DEBUGGING_THREAD_HOLDER, ThreadHolderList);
+
+        for (size_t i = 0; i < MAX_THREADS_IN_A_PROCESS_HOLDER; i++)
+        {
+            if (ThreadHolder->Threads[i].ThreadId == NULL || !ThreadHolder->Threads[i].IsPaused)
+            {
+                continue;
+            }
+
+            for (size_t j = 0; j < MAX_USER_ACTIONS_FOR_THREADS; j++)
+            {
+                if (ThreadHolder->Threads[i].UdAction[j].ActionType != DEBUGGER_UD_COMMAND_ACTION_TYPE_NONE)
+                {
+                    return TRUE;
+                }
+            }
+        }
+    }
+
+    return FALSE;
+}
+
 /**
  * @brief Find the active threads of the process from process id
  *
@@ -110,6 +287,7 @@ ThreadHolderGetProcessThreadDetailsByProcessIdAndThreadId(UINT32 ProcessId, UINT
 {
     PLIST_ENTRY                         TempList = 0;
     PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail;
+    PTHREAD_HOLDER_INDEX_ENTRY          IndexEntry;
 
     //
     // First, find the process details
@@ -121,6 +299,24 @@ ThreadHolderGetProcessThreadDetailsByProcessIdAndThreadId(UINT32 ProcessId, UINT
         return NULL;
     }
 
+    //
+    // Check the index of the threads
+    //
+    if (ThreadId != NULL)
+    {
+        IndexEntry = ThreadHolderIndexFind(ThreadId, ProcessDebuggingDetail);
+
+        if (IndexEntry != NULL)
+        {
+            return IndexEntry->ThreadDetails;
+        }
+
+        if (!g_ThreadHolderIndexIsIncomplete)
+        {
+            return NULL;
+        }
+    }
+
     TempList = &ProcessDebuggingDetail->ThreadsListHead;
 
     while (&ProcessDebuggingDetail->ThreadsListHead != TempList->Flink)
@@ -204,8 +400,27 @@ ThreadHolderGetProcessFirstThreadDetailsByProcessId(UINT32 ProcessId)
 PUSERMODE_DEBUGGING_PROCESS_DETAILS
 ThreadHolderGetProcessDebuggingDetailsByThreadId(UINT32 ThreadId)
 {
-    PLIST_ENTRY TempList  = 0;
-    PLIST_ENTRY TempList2 = 0;
+    PLIST_ENTRY                TempList  = 0;
+    PLIST_ENTRY                TempList2 = 0;
+    PTHREAD_HOLDER_INDEX_ENTRY IndexEntry;
+
+    //
+    // Check the index of the threads
+    //
+    if (ThreadId != NULL)
+    {
+        IndexEntry = ThreadHolderIndexFind(ThreadId, NULL);
+
+        if (IndexEntry != NULL)
+        {
+            return IndexEntry->ProcessDetails;
+        }
+
+        if (!g_ThreadHolderIndexIsIncomplete)
+        {
+            return NULL;
+        }
+    }
 
     TempList = &g_ProcessDebuggingDetailsListHead;
 
@@ -256,7 +471,18 @@ ThreadHolderGetProcessDebuggingDetailsByThreadId(UINT32 ThreadId)
 PUSERMODE_DEBUGGING_THREAD_DETAILS
 ThreadHolderFindOrCreateThreadDebuggingDetail(UINT32 ThreadId, PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail)
 {
-    PLIST_ENTRY TempList = 0;
+    PLIST_ENTRY                TempList = 0;
+    PTHREAD_HOLDER_INDEX_ENTRY IndexEntry;
+
+    //
+    // Check the index of the threads
+    //
+    IndexEntry = ThreadHolderIndexFind(ThreadId, ProcessDebuggingDetail);
+
+    if (IndexEntry != NULL)
+    {
+        return IndexEntry->ThreadDetails;
+    }
 
     TempList = &ProcessDebuggingDetail->ThreadsListHead;
 
@@ -309,6 +535,7 @@ ThreadHolderFindOrCreateThreadDebuggingDetail(UINT32 ThreadId, PUSERMODE_DEBUGGI
                 // We find a null thread place, let's return it's structure
                 //
                 ThreadHolder->Threads[i].ThreadId = ThreadId;
+                ThreadHolderIndexInsert(&ThreadHolder->Threads[i], ProcessDebuggingDetail);
 
                 SpinlockUnlock(&VmxRootThreadHoldingLock);
                 return &ThreadHolder->Threads[i];
@@ -337,6 +564,7 @@ ThreadHolderFindOrCreateThreadDebuggingDetail(UINT32 ThreadId, PUSERMODE_DEBUGGI
     // Add the current thread as the first entry of the holder
     //
     NewThreadHolder->Threads[0].ThreadId = ThreadId;
+    ThreadHolderIndexInsert(&NewThreadHolder->Threads[0], ProcessDebuggingDetail);
 
     //
     // Link to the thread holding structure
@@ -351,6 +579,43 @@ ThreadHolderFindOrCreateThreadDebuggingDetail(UINT32 ThreadId, PUSERMODE_DEBUGGI
     return &NewThreadHolder->Threads[0];
 }
 
+/**
+ * @brief Apply an action of the user debugger to a thread
+ * @details the action is performed at the next cpuid of the thread
+ *
+ * @param ThreadDebuggingDetails
+ * @param UdAction
+ *
+ * @return BOOLEAN FALSE if there is no room for more actions
+ */
+BOOLEAN
+ThreadHolderApplyActionToThread(PUSERMODE_DEBUGGING_THREAD_DETAILS ThreadDebuggingDetails,
+                                PDEBUGGER_UD_COMMAND_ACTION        UdAction)
+{
+    for (size_t i = 0; i < MAX_USER_ACTIONS_FOR_THREADS; i++)
+    {
+        if (ThreadDebuggingDetails->UdAction[i].ActionType == DEBUGGER_UD_COMMAND_ACTION_TYPE_NONE)
+        {
+            //
+            // Set the action
+            //
+            ThreadDebuggingDetails->UdAction[i].OptionalParam1 = UdAction->OptionalParam1;
+            ThreadDebuggingDetails->UdAction[i].OptionalParam2 = UdAction->OptionalParam2;
+            ThreadDebuggingDetails->UdAction[i].OptionalParam3 = UdAction->OptionalParam3;
+            ThreadDebuggingDetails->UdAction[i].OptionalParam4 = UdAction->OptionalParam4;
+
+            //
+            // At last we set the action type to make it valid
+            //
+            ThreadDebuggingDetails->UdAction[i].ActionType = UdAction->ActionType;
+
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
 /**
  * @brief Apply the action of the user debugger to a specific thread or
  * all threads
@@ -379,29 +644,7 @@ ThreadHolderApplyActionToPausedThreads(PUSERMODE_DEBUGGING_PROCESS_DETAILS Proce
         //
         // Apply the command
         //
-        for (size_t i = 0; i < MAX_USER_ACTIONS_FOR_THREADS; i++)
-        {
-            if (ThreadDebuggingDetails->UdAction[i].ActionType == DEBUGGER_UD_COMMAND_ACTION_TYPE_NONE)
-            {
-                //
-                // Set the action
-                //
-                ThreadDebuggingDetails->UdAction[i].OptionalParam1 = ActionRequest->UdAction.OptionalParam1;
-                ThreadDebuggingDetails->UdAction[i].OptionalParam2 = ActionRequest->UdAction.OptionalParam2;
-                ThreadDebuggingDetails->UdAction[i].OptionalParam3 = ActionRequest->UdAction.OptionalParam3;
-                ThreadDebuggingDetails->UdAction[i].OptionalParam4 = ActionRequest->UdAction.OptionalParam4;
-
-                //
-                // At last we set the action type to make it valid
-                //
-                ThreadDebuggingDetails->UdAction[i].ActionType = ActionRequest->UdAction.ActionType;
-
-                //
-                // Command is applied
-                //
-                return TRUE;
-            }
-        }
+        return ThreadHolderApplyActionToThread(ThreadDebuggingDetails, &ActionRequest->UdAction);
     }
     else
     {
@@ -421,29 +664,10 @@ ThreadHolderApplyActionToPausedThreads(PUSERMODE_DEBUGGING_PROCESS_DETAILS Proce
             for (size_t i = 0; i < MAX_THREADS_IN_A_PROCESS_HOLDER; i++)
             {
                 if (ThreadHolder->Threads[i].ThreadId != NULL &&
-                    ThreadHolder->Threads[i].IsPaused)
+                    ThreadHolder->Threads[i].IsPaused &&
+                    ThreadHolderApplyActionToThread(&ThreadHolder->Threads[i], &ActionRequest->UdAction))
                 {
-                    for (size_t j = 0; j < MAX_USER_ACTIONS_FOR_THREADS; j++)
-                    {
-                        if (ThreadHolder->Threads[i].UdAction[j].ActionType == DEBUGGER_UD_COMMAND_ACTION_TYPE_NONE)
-                        {
-                            //
-                            // Set the action
-                            //
-                            ThreadHolder->Threads[i].UdAction[j].OptionalParam1 = ActionRequest->UdAction.OptionalParam1;
-                            ThreadHolder->Threads[i].UdAction[j].OptionalParam2 = ActionRequest->UdAction.OptionalParam2;
-                            ThreadHolder->Threads[i].UdAction[j].OptionalParam3 = ActionRequest->UdAction.OptionalParam3;
-                            ThreadHolder->Threads[i].UdAction[j].OptionalParam4 = ActionRequest->UdAction.OptionalParam4;
-
-                            //
-                            // At last we set the action type to make it valid
-                            //
-                            ThreadHolder->Threads[i].UdAction[j].ActionType = ActionRequest->UdAction.ActionType;
-
-                            CommandApplied = TRUE;
-                            break;
-                        }
-                    }
+                    CommandApplied = TRUE;
                 }
             }
         }
@@ -466,6 +690,11 @@ ThreadHolderFreeHoldingStructures(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDeb
 {
     PLIST_ENTRY TempList = 0;
 
+    //
+    // The threads of the process should not be found from the index anymore
+    //
+    ThreadHolderIndexRemoveProcess(ProcessDebuggingDetail);
+
     TempList = &ProcessDebuggingDetail->ThreadsListHead;
 
     while (&ProcessDebuggingDetail->ThreadsListHead != TempList->Flink)
@@ -64,6 +64,11 @@ UdInitializeUserDebugger()
     //
     g_UserDebuggerState = TRUE;
 
+    //
+    // The commands of the user debugger are delivered by CPUIDs
+    //
+    VmFuncSetCheckCpuidsForUserDebuggerCommands(TRUE);
+
     return TRUE;
 }
 
@@ -83,6 +88,8 @@ UdUninitializeUserDebugger()
         //
         g_UserDebuggerState = FALSE;
 
+        VmFuncSetCheckCpuidsForUserDebuggerCommands(FALSE);
+
         //
         // Free and deallocate all the buffers (pools) relating to
         // thread debugging details
@@ -190,10 +197,132 @@ UdStepInstructions(PUSERMODE_DEBUGGING_THREAD_DETAILS ThreadDebuggingDetails,
     ThreadDebuggingDetails->IsPaused = FALSE;
 }
 
+/**
+ * @brief Check whether the register can be changed for the paused threads or not
+ *
+ * @param Register
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+UdIsRegisterOfPausedThreadChangeable(UINT64 Register)
+{
+    switch (Register)
+    {
+    case REGISTER_RAX:
+    case REGISTER_RCX:
+    case REGISTER_RDX:
+    case REGISTER_RBX:
+    case REGISTER_RBP:
+    case REGISTER_RSI:
+    case REGISTER_RDI:
+    case REGISTER_R8:
+    case REGISTER_R9:
+    case REGISTER_R10:
+    case REGISTER_R11:
+    case REGISTER_R12:
+    case REGISTER_R13:
+    case REGISTER_R14:
+    case REGISTER_R15:
+    case REGISTER_RFLAGS:
+    case REGISTER_RIP:
+        return TRUE;
+
+    default:
+        //
+        // The stack pointer and the partial registers are not supported
+        //
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Change a register of the paused thread
+ * @details This function can be used in vmx-root
+ *
+ * @param ThreadDebuggingDetails
+ * @param Regs
+ * @param Register
+ * @param Value
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+UdSetRegisterOfPausedThread(PUSERMODE_DEBUGGING_THREAD_DETAILS ThreadDebuggingDetails,
+                            GUEST_REGS *                       Regs,
+                            UINT64                             Register,
+                            UINT64                             Value)
+{
+    switch (Register)
+    {
+    case REGISTER_RAX:
+        Regs->rax = Value;
+        break;
+    case REGISTER_RCX:
+        Regs->rcx = Value;
+        break;
+    case REGISTER_RDX:
+        Regs->rdx = Value;
+        break;
+    case REGISTER_RBX:
+        Regs->rbx = Value;
+        break;
+    case REGISTER_RBP:
+        Regs->rbp = Value;
+        break;
+    case REGISTER_RSI:
+        Regs->rsi = Value;
+        break;
+    case REGISTER_RDI:
+        Regs->rdi = Value;
+        break;
+    case REGISTER_R8:
+        Regs->r8 = Value;
+        break;
+    case REGISTER_R9:
+        Regs->r9 = Value;
+        break;
+    case REGISTER_R10:
+        Regs->r10 = Value;
+        break;
+    case REGISTER_R11:
+        Regs->r11 = Value;
+        break;
+    case REGISTER_R12:
+        Regs->r12 = Value;
+        break;
+    case REGISTER_R13:
+        Regs->r13 = Value;
+        break;
+    case REGISTER_R14:
+        Regs->r14 = Value;
+        break;
+    case REGISTER_R15:
+        Regs->r15 = Value;
+        break;
+    case REGISTER_RFLAGS:
+        VmFuncSetRflags(Value);
+        break;
+    case REGISTER_RIP:
+
+        //
+        // The thread continues from the saved RIP
+        //
+        ThreadDebuggingDetails->ThreadRip = Value;
+        break;
+
+    default:
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
 /**
  * @brief Perform the user-mode commands
  *
  * @param ThreadDebuggingDetails
+ * @param Regs
  * @param UserAction
  * @param OptionalParam1
  * @param OptionalParam2
@@ -204,6 +333,7 @@ UdStepInstructions(PUSERMODE_DEBUGGING_THREAD_DETAILS ThreadDebuggingDetails,
  */
 BOOLEAN
 UdPerformCommand(PUSERMODE_DEBUGGING_THREAD_DETAILS ThreadDebuggingDetails,
+                 GUEST_REGS *                       Regs,
                  DEBUGGER_UD_COMMAND_ACTION_TYPE    UserAction,
                  UINT64                             OptionalParam1,
                  UINT64                             OptionalParam2,
@@ -233,6 +363,13 @@ UdPerformCommand(PUSERMODE_DEBUGGING_THREAD_DETAILS ThreadDebuggingDetails,
 
         break;
 
+    case DEBUGGER_UD_COMMAND_ACTION_TYPE_SET_REGISTER:
+
+        //
+        // Change a register of the paused thread (it remains paused)
+        //
+        return UdSetRegisterOfPausedThread(ThreadDebuggingDetails, Regs, OptionalParam1, OptionalParam2);
+
     default:
 
         //
@@ -245,15 +382,77 @@ UdPerformCommand(PUSERMODE_DEBUGGING_THREAD_DETAILS ThreadDebuggingDetails,
     return TRUE;
 }
 
+/**
+ * @brief Set the registers of the parked thread for waiting on the parking event
+ * @details This function can be used in vmx-root, the parking stub executes
+ * NtWaitForSingleObject(ParkingEventHandle, FALSE, &Timeout) after the cpuid
+ *
+ * @param Regs
+ * @return VOID
+ */
+VOID
+UdWaitOnParkingEvent(GUEST_REGS * Regs)
+{
+    PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetails;
+
+    ProcessDebuggingDetails = AttachingFindProcessDebuggingDetailsByProcessId(PsGetCurrentProcessId());
+
+    if (!ProcessDebuggingDetails || ProcessDebuggingDetails->ParkingEvent == NULL)
+    {
+        return;
+    }
+
+    //
+    // The event is only cleared if no paused thread has a pending action,
+    // otherwise, the thread of the action might miss the signal (KeClearEvent
+    // only resets the signal state, so it's safe in vmx-root)
+    //
+    if (!ThreadHolderIsAnyPendingActionInProcess(ProcessDebuggingDetails))
+    {
+        KeClearEvent(ProcessDebuggingDetails->ParkingEvent);
+    }
+
+    Regs->rax = g_NtWaitForSingleObjectSyscallNumber;
+    Regs->rcx = (UINT64)ProcessDebuggingDetails->ParkingEventHandle;
+    Regs->r10 = (UINT64)ProcessDebuggingDetails->ParkingEventHandle;
+    Regs->rdx = FALSE;
+    Regs->r8  = ProcessDebuggingDetails->UsermodeReservedBuffer + USERMODE_RESERVED_BUFFER_PARKING_TIMEOUT_OFFSET;
+}
+
+/**
+ * @brief Restore the registers of the thread that is parked on the event
+ * @details This function can be used in vmx-root
+ *
+ * @param ThreadDebuggingDetails
+ * @param Regs
+ * @return VOID
+ */
+VOID
+UdUnparkThread(PUSERMODE_DEBUGGING_THREAD_DETAILS ThreadDebuggingDetails, GUEST_REGS * Regs)
+{
+    UINT64 GuestRsp = Regs->rsp;
+
+    RtlCopyMemory(Regs, &ThreadDebuggingDetails->ParkedRegisters, sizeof(GUEST_REGS));
+
+    //
+    // The stack pointer is not changed by the parking stub
+    //
+    Regs->rsp = GuestRsp;
+
+    ThreadDebuggingDetails->IsParkedOnEvent = FALSE;
+}
+
 /**
  * @brief Check for the user-mode commands
  *
+ * @param Regs
  * @return BOOLEAN
  */
 BOOLEAN
-UdCheckForCommand()
+UdCheckForCommand(GUEST_REGS * Regs)
 {
     PUSERMODE_DEBUGGING_THREAD_DETAILS ThreadDebuggingDetails;
+    BOOLEAN                            WasParkedOnEvent;
 
     //
     // Check if user-debugger is initialized or not
@@ -280,6 +479,8 @@ UdCheckForCommand()
         return FALSE;
     }
 
+    WasParkedOnEvent = ThreadDebuggingDetails->IsParkedOnEvent;
+
     //
     // Here, we're sure that this thread is looking for command, let
     // see if we find anything
@@ -288,10 +489,19 @@ UdCheckForCommand()
     {
         if (ThreadDebuggingDetails->UdAction[i].ActionType != DEBUGGER_UD_COMMAND_ACTION_TYPE_NONE)
         {
+            //
+            // The registers are changed for waiting on the parking event
+            //
+            if (ThreadDebuggingDetails->IsParkedOnEvent)
+            {
+                UdUnparkThread(ThreadDebuggingDetails, Regs);
+            }
+
             //
             // Perform the command
             //
             UdPerformCommand(ThreadDebuggingDetails,
+                             Regs,
                              ThreadDebuggingDetails->UdAction[i].ActionType,
                              ThreadDebuggingDetails->UdAction[i].OptionalParam1,
                              ThreadDebuggingDetails->UdAction[i].OptionalParam2,
@@ -312,10 +522,29 @@ UdCheckForCommand()
             ThreadDebuggingDetails->UdAction[i].ActionType = DEBUGGER_UD_COMMAND_ACTION_TYPE_NONE;
 
             //
-            // only one command at a time
+            // The actions are performed in order until the thread is continued
+            // or stepped, the rest of them are performed at the next pause
             //
-            break;
+            if (!ThreadDebuggingDetails->IsPaused)
+            {
+                return TRUE;
+            }
+        }
+    }
+
+    //
+    // The thread is still paused (no command or only the registers are changed),
+    // so the parked thread waits (again) on the parking event
+    //
+    if (WasParkedOnEvent)
+    {
+        if (!ThreadDebuggingDetails->IsParkedOnEvent)
+        {
+            RtlCopyMemory(&ThreadDebuggingDetails->ParkedRegisters, Regs, sizeof(GUEST_REGS));
+            ThreadDebuggingDetails->IsParkedOnEvent = TRUE;
         }
+
+        UdWaitOnParkingEvent(Regs);
     }
 
     //
@@ -362,7 +591,94 @@ UdDispatchUsermodeCommands(PDEBUGGER_UD_COMMAND_PACKET ActionRequest)
     //
     // Apply the command to all threads or just one thread
     //
-    return ThreadHolderApplyActionToPausedThreads(ProcessDebuggingDetails, ActionRequest);
+    if (!ThreadHolderApplyActionToPausedThreads(ProcessDebuggingDetails, ActionRequest))
+    {
+        return FALSE;
+    }
+
+    //
+    // Wake the threads that are parked on the event
+    //
+    AttachingSignalParkingEvent(ProcessDebuggingDetails);
+
+    return TRUE;
+}
+
+/**
+ * @brief Dispatch a batch of the user-mode commands
+ * @details the actions are applied to the target threads in order, and each
+ * thread performs its actions at its next cpuid
+ *
+ * @param BatchRequest
+ * @return VOID
+ */
+VOID
+UdDispatchUsermodeBatchCommands(PDEBUGGER_UD_BATCH_COMMAND_PACKET BatchRequest)
+{
+    PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetails;
+    PUSERMODE_DEBUGGING_THREAD_DETAILS  ThreadDebuggingDetails;
+    PDEBUGGER_UD_BATCH_COMMAND_ENTRY    Entries = (PDEBUGGER_UD_BATCH_COMMAND_ENTRY)((UINT64)BatchRequest + sizeof(DEBUGGER_UD_BATCH_COMMAND_PACKET));
+
+    BatchRequest->CountOfAppliedEntries = 0;
+
+    ProcessDebuggingDetails = AttachingFindProcessDebuggingDetailsByToken(BatchRequest->ProcessDebuggingDetailToken);
+
+    if (!ProcessDebuggingDetails)
+    {
+        BatchRequest->Result = DEBUGGER_ERROR_INVALID_THREAD_DEBUGGING_TOKEN;
+        return;
+    }
+
+    //
+    // Stop intercepting the threads (same as the regular commands)
+    //
+    if (ProcessDebuggingDetails->IsOnThreadInterceptingPhase)
+    {
+        AttachingConfigureInterceptingThreads(ProcessDebuggingDetails->Token, FALSE);
+    }
+
+    for (UINT32 i = 0; i < BatchRequest->CountOfEntries; i++)
+    {
+        DEBUGGER_UD_COMMAND_ACTION_TYPE ActionType = Entries[i].UdAction.ActionType;
+
+        if ((ActionType != DEBUGGER_UD_COMMAND_ACTION_TYPE_CONTINUE &&
+             ActionType != DEBUGGER_UD_COMMAND_ACTION_TYPE_REGULAR_STEP &&
+             ActionType != DEBUGGER_UD_COMMAND_ACTION_TYPE_SET_REGISTER) ||
+            (ActionType == DEBUGGER_UD_COMMAND_ACTION_TYPE_SET_REGISTER &&
+             !UdIsRegisterOfPausedThreadChangeable(Entries[i].UdAction.OptionalParam1)))
+        {
+            Entries[i].Result = DEBUGGER_ERROR_UD_INVALID_ACTION_OR_REGISTER;
+            continue;
+        }
+
+        ThreadDebuggingDetails = ThreadHolderGetProcessThreadDetailsByProcessIdAndThreadId(ProcessDebuggingDetails->ProcessId,
+                                                                                          Entries[i].TargetThreadId);
+
+        if (!ThreadDebuggingDetails || !ThreadDebuggingDetails->IsPaused)
+        {
+            Entries[i].Result = DEBUGGER_ERROR_UD_THREAD_IS_NOT_PAUSED;
+            continue;
+        }
+
+        if (!ThreadHolderApplyActionToThread(ThreadDebuggingDetails, &Entries[i].UdAction))
+        {
+            Entries[i].Result = DEBUGGER_ERROR_UD_ACTIONS_OF_THREAD_ARE_FULL;
+            continue;
+        }
+
+        Entries[i].Result = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+        BatchRequest->CountOfAppliedEntries++;
+    }
+
+    //
+    // Wake the threads that are parked on the event (once for the entire batch)
+    //
+    if (BatchRequest->CountOfAppliedEntries != 0)
+    {
+        AttachingSignalParkingEvent(ProcessDebuggingDetails);
+    }
+
+    BatchRequest->Result = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
 }
 
 /**
@@ -384,7 +700,7 @@ UdSpinThreadOnNop(PUSERMODE_DEBUGGING_THREAD_DETAILS  ThreadDebuggingDetails,
     //
     // Set the rip to new spinning address
     //
-    VmFuncSetRip(ProcessDebuggingDetails->UsermodeReservedBuffer);
+    VmFuncSetRip(ProcessDebuggingDetails->UsermodeReservedBuffer + USERMODE_RESERVED_BUFFER_NOP_SLED_OFFSET);
 
     //
     // Indicate that it's spinning
@@ -392,6 +708,46 @@ UdSpinThreadOnNop(PUSERMODE_DEBUGGING_THREAD_DETAILS  ThreadDebuggingDetails,
     ThreadDebuggingDetails->IsPaused = TRUE;
 }
 
+/**
+ * @brief Park the thread on the parking event of the process to halt the debuggee
+ * @details unlike the nop sled, the parked thread is descheduled (waits on the
+ * event) until a command is applied to it
+ *
+ * @param ThreadDebuggingDetails
+ * @param ProcessDebuggingDetails
+ * @param Regs
+ * @return VOID
+ */
+VOID
+UdParkThreadOnEvent(PUSERMODE_DEBUGGING_THREAD_DETAILS  ThreadDebuggingDetails,
+                    PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetails,
+                    GUEST_REGS *                        Regs)
+{
+    //
+    // The thread might be intercepted while it's parked, the original
+    // state is already saved
+    //
+    if (!ThreadDebuggingDetails->IsParkedOnEvent)
+    {
+        //
+        // Save the RIP and the registers for future return
+        //
+        ThreadDebuggingDetails->ThreadRip = VmFuncGetRip();
+        RtlCopyMemory(&ThreadDebuggingDetails->ParkedRegisters, Regs, sizeof(GUEST_REGS));
+    }
+
+    //
+    // Set the rip to the parking stub
+    //
+    VmFuncSetRip(ProcessDebuggingDetails->UsermodeReservedBuffer + USERMODE_RESERVED_BUFFER_PARKING_STUB_OFFSET);
+
+    //
+    // Indicate that it's parked
+    //
+    ThreadDebuggingDetails->IsParkedOnEvent = TRUE;
+    ThreadDebuggingDetails->IsPaused        = TRUE;
+}
+
 /**
  * @brief Handle after we hit the stepping
  * @details This function can be used in vmx-root
@@ -625,9 +981,16 @@ UdCheckAndHandleBreakpointsAndDebugBreaks(PROCESSOR_DEBUGGING_STATE *       DbgS
                           TRUE);
 
     //
-    // Halt the thread on nop sleds
+    // Halt the thread on the parking event or nop sleds
     //
-    UdSpinThreadOnNop(ThreadDebuggingDetails, ProcessDebuggingDetails);
+    if (ProcessDebuggingDetails->ParkingEvent != NULL)
+    {
+        UdParkThreadOnEvent(ThreadDebuggingDetails, ProcessDebuggingDetails, DbgState->Regs);
+    }
+    else
+    {
+        UdSpinThreadOnNop(ThreadDebuggingDetails, ProcessDebuggingDetails);
+    }
 
     //
     // Everything was okay
@@ -756,6 +756,445 @@ UserAccessIsWow64Process(HANDLE ProcessId, PBOOLEAN Is32Bit)
     }
 }
 
+/**
+ * @brief Read the head of the loader list (in load order) of the process
+ * @details This function should be called in vmx non-root
+ *
+ * @param Proc
+ * @param Is32Bit
+ * @param Flink
+ * @param Blink
+ * @return BOOLEAN
+ */
+BOOLEAN
+UserAccessGetLoadedModulesListHead(PEPROCESS Proc, BOOLEAN Is32Bit, PUINT64 Flink, PUINT64 Blink)
+{
+    KAPC_STATE      State;
+    PPEB            Peb    = NULL;
+    PPEB32          Peb32  = NULL;
+    PPEB_LDR_DATA   Ldr    = NULL;
+    PPEB_LDR_DATA32 Ldr32  = NULL;
+    BOOLEAN         Result = FALSE;
+
+    if (Is32Bit)
+    {
+        Peb32 = (PPEB32)g_PsGetProcessWow64Process(Proc);
+
+        if (!Peb32)
+        {
+            return FALSE;
+        }
+
+        KeStackAttachProcess(Proc, &State);
+
+        Ldr32 = (PPEB_LDR_DATA32)Peb32->Ldr;
+
+        if (Ldr32)
+        {
+            *Flink = Ldr32->InLoadOrderModuleList.Flink;
+            *Blink = Ldr32->InLoadOrderModuleList.Blink;
+            Result = TRUE;
+        }
+
+        KeUnstackDetachProcess(&State);
+    }
+    else
+    {
+        Peb = (PPEB)g_PsGetProcessPeb(Proc);
+
+        if (!Peb)
+        {
+            return FALSE;
+        }
+
+        KeStackAttachProcess(Proc, &State);
+
+        Ldr = (PPEB_LDR_DATA)Peb->Ldr;
+
+        if (Ldr)
+        {
+            *Flink = (UINT64)Ldr->ModuleListLoadOrder.Flink;
+            *Blink = (UINT64)Ldr->ModuleListLoadOrder.Blink;
+            Result = TRUE;
+        }
+
+        KeUnstackDetachProcess(&State);
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Find the cache of the loaded modules of a process
+ * @details the lock of the caches should be held
+ *
+ * @param ProcessId
+ * @return PUSER_ACCESS_MODULE_CACHE
+ */
+PUSER_ACCESS_MODULE_CACHE
+UserAccessFindModuleCache(UINT32 ProcessId)
+{
+    LIST_FOR_EACH_LINK(g_UserAccessModuleCacheListHead, USER_ACCESS_MODULE_CACHE, CacheList, ModuleCache)
+    {
+        if (ModuleCache->ProcessId == ProcessId)
+        {
+            return ModuleCache;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Free a cache of the loaded modules
+ *
+ * @param ModuleCache
+ * @return VOID
+ */
+VOID
+UserAccessFreeModuleCache(PUSER_ACCESS_MODULE_CACHE ModuleCache)
+{
+    if (ModuleCache->Modules != NULL)
+    {
+        ExFreePoolWithTag(ModuleCache->Modules, POOLTAG);
+    }
+
+    ExFreePoolWithTag(ModuleCache, POOLTAG);
+}
+
+/**
+ * @brief Remove the cache of the loaded modules of a process (if any)
+ *
+ * @param ProcessId
+ * @return VOID
+ */
+VOID
+UserAccessRemoveModuleCache(UINT32 ProcessId)
+{
+    PUSER_ACCESS_MODULE_CACHE ModuleCache;
+
+    SpinlockLock(&g_UserAccessModuleCacheLock);
+
+    ModuleCache = UserAccessFindModuleCache(ProcessId);
+
+    if (ModuleCache != NULL)
+    {
+        RemoveEntryList(&ModuleCache->CacheList);
+    }
+
+    SpinlockUnlock(&g_UserAccessModuleCacheLock);
+
+    if (ModuleCache != NULL)
+    {
+        UserAccessFreeModuleCache(ModuleCache);
+    }
+}
+
+/**
+ * @brief Notify routine of mapping images
+ * @details the cache of the process (if any) is rebuilt on the next request
+ *
+ * @param FullImageName
+ * @param ProcessId
+ * @param ImageInfo
+ * @return VOID
+ */
+VOID
+UserAccessLoadImageNotifyRoutine(PUNICODE_STRING FullImageName, HANDLE ProcessId, PIMAGE_INFO ImageInfo)
+{
+    PUSER_ACCESS_MODULE_CACHE ModuleCache;
+
+    UNREFERENCED_PARAMETER(FullImageName);
+    UNREFERENCED_PARAMETER(ImageInfo);
+
+    if (ProcessId == NULL)
+    {
+        //
+        // Drivers are not cached
+        //
+        return;
+    }
+
+    SpinlockLock(&g_UserAccessModuleCacheLock);
+
+    ModuleCache = UserAccessFindModuleCache((UINT32)(UINT64)ProcessId);
+
+    if (ModuleCache != NULL)
+    {
+        ModuleCache->IsStale = TRUE;
+    }
+
+    SpinlockUnlock(&g_UserAccessModuleCacheLock);
+}
+
+/**
+ * @brief Notify routine of creating and terminating processes
+ * @details the cache of the terminated processes is removed
+ *
+ * @param ParentId
+ * @param ProcessId
+ * @param Create
+ * @return VOID
+ */
+VOID
+UserAccessCreateProcessNotifyRoutine(HANDLE ParentId, HANDLE ProcessId, BOOLEAN Create)
+{
+    UNREFERENCED_PARAMETER(ParentId);
+
+    if (!Create)
+    {
+        UserAccessRemoveModuleCache((UINT32)(UINT64)ProcessId);
+    }
+}
+
+/**
+ * @brief Initialize the caches of the loaded modules of user-mode processes
+ * @details This function should be called in vmx non-root
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+UserAccessModuleCacheInitialize()
+{
+    if (g_UserAccessModuleCacheIsInitialized)
+    {
+        return TRUE;
+    }
+
+    InitializeListHead(&g_UserAccessModuleCacheListHead);
+
+    if (!NT_SUCCESS(PsSetLoadImageNotifyRoutine(UserAccessLoadImageNotifyRoutine)))
+    {
+        LogError("Err, unable to register the notify routine of loading images");
+        return FALSE;
+    }
+
+    if (!NT_SUCCESS(PsSetCreateProcessNotifyRoutine(UserAccessCreateProcessNotifyRoutine, FALSE)))
+    {
+        LogError("Err, unable to register the notify routine of creating processes");
+        PsRemoveLoadImageNotifyRoutine(UserAccessLoadImageNotifyRoutine);
+        return FALSE;
+    }
+
+    g_UserAccessModuleCacheIsInitialized = TRUE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Uninitialize the caches of the loaded modules of user-mode processes
+ * @details This function should be called in vmx non-root
+ *
+ * @return VOID
+ */
+VOID
+UserAccessModuleCacheUninitialize()
+{
+    if (!g_UserAccessModuleCacheIsInitialized)
+    {
+        return;
+    }
+
+    PsRemoveLoadImageNotifyRoutine(UserAccessLoadImageNotifyRoutine);
+    PsSetCreateProcessNotifyRoutine(UserAccessCreateProcessNotifyRoutine, TRUE);
+
+    g_UserAccessModuleCacheIsInitialized = FALSE;
+
+    LIST_FOR_EACH_LINK(g_UserAccessModuleCacheListHead, USER_ACCESS_MODULE_CACHE, CacheList, ModuleCache)
+    {
+        RemoveEntryList(&ModuleCache->CacheList);
+        UserAccessFreeModuleCache(ModuleCache);
+    }
+}
+
+/**
+ * @brief Build the cache of the loaded modules of a process
+ * @details This function should be called in vmx non-root
+ *
+ * @param Proc
+ * @param ProcessId
+ * @param Is32Bit
+ * @return BOOLEAN
+ */
+BOOLEAN
+UserAccessBuildModuleCache(PEPROCESS Proc, UINT32 ProcessId, BOOLEAN Is32Bit)
+{
+    PUSER_ACCESS_MODULE_CACHE ModuleCache;
+    PUSER_ACCESS_MODULE_CACHE PreviousModuleCache;
+    UINT32                    CountOfModules = 0;
+    BOOLEAN                   Result;
+
+    ModuleCache = ExAllocatePoolWithTag(NonPagedPool, sizeof(USER_ACCESS_MODULE_CACHE), POOLTAG);
+
+    if (ModuleCache == NULL)
+    {
+        return FALSE;
+    }
+
+    RtlZeroMemory(ModuleCache, sizeof(USER_ACCESS_MODULE_CACHE));
+
+    ModuleCache->ProcessId = ProcessId;
+    ModuleCache->Is32Bit   = Is32Bit;
+
+    //
+    // The head is read before walking the list, so the modules that are
+    // loaded in the middle of walking cause the cache to be rebuilt
+    //
+    if (!UserAccessGetLoadedModulesListHead(Proc, Is32Bit, &ModuleCache->ListHeadFlink, &ModuleCache->ListHeadBlink))
+    {
+        ExFreePoolWithTag(ModuleCache, POOLTAG);
+        return FALSE;
+    }
+
+    Result = Is32Bit ? UserAccessPrintLoadedModulesX86(Proc, TRUE, &CountOfModules, NULL, 0)
+                     : UserAccessPrintLoadedModulesX64(Proc, TRUE, &CountOfModules, NULL, 0);
+
+    if (!Result || CountOfModules == 0)
+    {
+        ExFreePoolWithTag(ModuleCache, POOLTAG);
+        return FALSE;
+    }
+
+    ModuleCache->Modules = ExAllocatePoolWithTag(NonPagedPool, CountOfModules * sizeof(USERMODE_LOADED_MODULE_SYMBOLS), POOLTAG);
+
+    if (ModuleCache->Modules == NULL)
+    {
+        ExFreePoolWithTag(ModuleCache, POOLTAG);
+        return FALSE;
+    }
+
+    RtlZeroMemory(ModuleCache->Modules, CountOfModules * sizeof(USERMODE_LOADED_MODULE_SYMBOLS));
+
+    Result = Is32Bit ? UserAccessPrintLoadedModulesX86(Proc, FALSE, NULL, ModuleCache->Modules, CountOfModules * sizeof(USERMODE_LOADED_MODULE_SYMBOLS))
+                     : UserAccessPrintLoadedModulesX64(Proc, FALSE, NULL, ModuleCache->Modules, CountOfModules * sizeof(USERMODE_LOADED_MODULE_SYMBOLS));
+
+    if (!Result)
+    {
+        UserAccessFreeModuleCache(ModuleCache);
+        return FALSE;
+    }
+
+    //
+    // Some modules might be unloaded in the middle of walking the list
+    //
+    while (CountOfModules != 0 && ModuleCache->Modules[CountOfModules - 1].BaseAddress == NULL)
+    {
+        CountOfModules--;
+    }
+
+    ModuleCache->ModulesCount = CountOfModules;
+
+    //
+    // Replace the previous cache of the process (if any)
+    //
+    SpinlockLock(&g_UserAccessModuleCacheLock);
+
+    PreviousModuleCache = UserAccessFindModuleCache(ProcessId);
+
+    if (PreviousModuleCache != NULL)
+    {
+        RemoveEntryList(&PreviousModuleCache->CacheList);
+    }
+
+    InsertHeadList(&g_UserAccessModuleCacheListHead, &ModuleCache->CacheList);
+
+    SpinlockUnlock(&g_UserAccessModuleCacheLock);
+
+    if (PreviousModuleCache != NULL)
+    {
+        UserAccessFreeModuleCache(PreviousModuleCache);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Get details about loaded modules from the cache of the process
+ * @details This function should be called in vmx non-root, the cache is
+ * (re)built if it's not valid anymore
+ *
+ * @param Proc
+ * @param Is32Bit
+ * @param ProcessLoadedModuleRequest
+ * @param BufferSize
+ * @return BOOLEAN
+ */
+BOOLEAN
+UserAccessGetLoadedModulesFromCache(PEPROCESS                       Proc,
+                                    BOOLEAN                         Is32Bit,
+                                    PUSERMODE_LOADED_MODULE_DETAILS ProcessLoadedModuleRequest,
+                                    UINT32                          BufferSize)
+{
+    PUSER_ACCESS_MODULE_CACHE ModuleCache;
+    UINT64                    ListHeadFlink;
+    UINT64                    ListHeadBlink;
+    UINT32                    ProcessId = ProcessLoadedModuleRequest->ProcessId;
+    BOOLEAN                   IsRebuilt = FALSE;
+    BOOLEAN                   Result    = FALSE;
+    UINT32                    CountOfModules;
+
+    if (!g_UserAccessModuleCacheIsInitialized)
+    {
+        return FALSE;
+    }
+
+    if (!UserAccessGetLoadedModulesListHead(Proc, Is32Bit, &ListHeadFlink, &ListHeadBlink))
+    {
+        return FALSE;
+    }
+
+    while (TRUE)
+    {
+        SpinlockLock(&g_UserAccessModuleCacheLock);
+
+        ModuleCache = UserAccessFindModuleCache(ProcessId);
+
+        if (ModuleCache != NULL &&
+            !ModuleCache->IsStale &&
+            ModuleCache->Is32Bit == Is32Bit &&
+            ModuleCache->ListHeadFlink == ListHeadFlink &&
+            ModuleCache->ListHeadBlink == ListHeadBlink)
+        {
+            if (ProcessLoadedModuleRequest->OnlyCountModules)
+            {
+                ProcessLoadedModuleRequest->ModulesCount = ModuleCache->ModulesCount;
+            }
+            else
+            {
+                CountOfModules = (BufferSize - sizeof(USERMODE_LOADED_MODULE_DETAILS)) / sizeof(USERMODE_LOADED_MODULE_SYMBOLS);
+
+                if (CountOfModules > ModuleCache->ModulesCount)
+                {
+                    CountOfModules = ModuleCache->ModulesCount;
+                }
+
+                memcpy((PVOID)((UINT64)ProcessLoadedModuleRequest + sizeof(USERMODE_LOADED_MODULE_DETAILS)),
+                       ModuleCache->Modules,
+                       CountOfModules * sizeof(USERMODE_LOADED_MODULE_SYMBOLS));
+            }
+
+            Result = TRUE;
+        }
+
+        SpinlockUnlock(&g_UserAccessModuleCacheLock);
+
+        if (Result || IsRebuilt)
+        {
+            return Result;
+        }
+
+        //
+        // The cache is not valid, rebuild it (only once)
+        //
+        if (!UserAccessBuildModuleCache(Proc, ProcessId, Is32Bit))
+        {
+            return FALSE;
+        }
+
+        IsRebuilt = TRUE;
+    }
+}
+
 /**
  * @brief Get details about loaded modules
  * @details This function should be called in vmx non-root
@@ -793,6 +1232,15 @@ UserAccessGetLoadedModules(PUSERMODE_LOADED_MODULE_DETAILS ProcessLoadedModuleRe
         return FALSE;
     }
 
+    //
+    // The modules are read from the cache of the process (if it's still valid)
+    //
+    if (UserAccessGetLoadedModulesFromCache(SourceProcess, Is32Bit, ProcessLoadedModuleRequest, BufferSize))
+    {
+        ProcessLoadedModuleRequest->Result = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+        return TRUE;
+    }
+
     if (Is32Bit)
     {
         //
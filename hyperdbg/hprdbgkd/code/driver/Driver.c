@@ -31,7 +31,6 @@ DriverEntry(
     UNICODE_STRING DriverName    = RTL_CONSTANT_STRING(L"\\Device\\HyperDbgDebuggerDevice");
     UNICODE_STRING DosDeviceName = RTL_CONSTANT_STRING(L"\\DosDevices\\HyperDbgDebuggerDevice");
 
-    UNREFERENCED_PARAMETER(RegistryPath);
     UNREFERENCED_PARAMETER(DriverObject);
 
     //
@@ -40,6 +39,11 @@ DriverEntry(
     //
     ExInitializeDriverRuntime(DrvRtPoolNxOptIn);
 
+    //
+    // Read the capacity of message buffers (used once the message tracer is initialized)
+    //
+    LoaderReadLogBufferConfiguration(RegistryPath);
+
     //
     // Creating the device for interaction with user-mode
     //
@@ -62,6 +66,7 @@ DriverEntry(
         DbgPrint("Setting device major functions");
 
         DriverObject->MajorFunction[IRP_MJ_CLOSE]          = DrvClose;
+        DriverObject->MajorFunction[IRP_MJ_CLEANUP]        = DrvCleanup;
         DriverObject->MajorFunction[IRP_MJ_CREATE]         = DrvCreate;
         DriverObject->MajorFunction[IRP_MJ_READ]           = DrvRead;
         DriverObject->MajorFunction[IRP_MJ_WRITE]          = DrvWrite;
@@ -244,6 +249,35 @@ DrvClose(PDEVICE_OBJECT DeviceObject, PIRP Irp)
     return STATUS_SUCCESS;
 }
 
+/**
+ * @brief IRP_MJ_CLEANUP Function handler
+ *
+ * @param DeviceObject
+ * @param Irp
+ * @return NTSTATUS
+ */
+NTSTATUS
+DrvCleanup(PDEVICE_OBJECT DeviceObject, PIRP Irp)
+{
+    //
+    // Cleanup is called in the context of the process that closes the
+    // handle, so if the message buffers are mapped into this process
+    // (shared memory message tracking), we unmap them here
+    //
+    LogUnmapSharedMemory();
+
+    //
+    // The same for the results rings of the reversing machine
+    //
+    ConfigureUnmapReversingMachineResultsOfCurrentProcess();
+
+    Irp->IoStatus.Status      = STATUS_SUCCESS;
+    Irp->IoStatus.Information = 0;
+    IoCompleteRequest(Irp, IO_NO_INCREMENT);
+
+    return STATUS_SUCCESS;
+}
+
 /**
  * @brief Unsupported message for all other IRP_MJ_* handlers
  *
@@ -30,19 +30,32 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
     PDEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS               DebuggerPteRequest;
     PDEBUGGER_VA2PA_AND_PA2VA_COMMANDS                      DebuggerVa2paAndPa2vaRequest;
     PDEBUGGER_EDIT_MEMORY                                   DebuggerEditMemoryRequest;
+    PDEBUGGER_PATCH_MEMORY_REQUEST                          DebuggerPatchMemoryRequest;
     PDEBUGGER_SEARCH_MEMORY                                 DebuggerSearchMemoryRequest;
     PDEBUGGER_EVENT_AND_ACTION_REG_BUFFER                   RegBufferResult;
     PDEBUGGER_GENERAL_EVENT_DETAIL                          DebuggerNewEventRequest;
+    PDEBUGGER_EVENTS_BATCH_REQUEST                          DebuggerEventsBatchRequest;
     PDEBUGGER_MODIFY_EVENTS                                 DebuggerModifyEventRequest;
     PDEBUGGER_FLUSH_LOGGING_BUFFERS                         DebuggerFlushBuffersRequest;
     PDEBUGGER_PREALLOC_COMMAND                              DebuggerReservePreallocPoolRequest;
     PDEBUGGER_UD_COMMAND_PACKET                             DebuggerUdCommandRequest;
+    PDEBUGGER_UD_BATCH_COMMAND_PACKET                       DebuggerUdBatchCommandRequest;
     PUSERMODE_LOADED_MODULE_DETAILS                         DebuggerUsermodeModulesRequest;
     PDEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS             DebuggerUsermodeProcessOrThreadQueryRequest;
     PDEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET             GetInformationProcessRequest;
     PREVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST           RevServiceRequest;
+    PREVERSING_MACHINE_QUERY_COVERAGE                       RevCoverageRequest;
+    PREVERSING_MACHINE_MAP_RESULTS                          RevMapResultsRequest;
     PDEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET              GetInformationThreadRequest;
     PDEBUGGER_PERFORM_KERNEL_TESTS                          DebuggerKernelTestRequest;
+    PDEBUGGER_PERFORM_KERNEL_BENCHMARK                      DebuggerKernelBenchmarkRequest;
+    PDEBUGGER_PERFORM_KERNEL_STRESS                         DebuggerKernelStressRequest;
+    PDEBUGGER_POOL_MANAGER_STATISTICS                       PoolManagerStatisticsRequest;
+    PDEBUGGER_SPINLOCK_CONTENTION_REQUEST                   SpinlockContentionRequest;
+    PDEBUGGER_VMM_INITIALIZATION_TIMINGS                    VmmInitializationTimingsRequest;
+    PDEBUGGER_QUERY_DRIVER_VERSION                          DriverVersionRequest;
+    PDEBUGGER_QUERY_EVENTS_STATISTICS                       EventsStatisticsRequest;
+    PDEBUGGER_QUERY_EVENT_RECORDS                           EventRecordsRequest;
     PDEBUGGER_SEND_COMMAND_EXECUTION_FINISHED_SIGNAL        DebuggerCommandExecutionFinishedRequest;
     PDEBUGGEE_KERNEL_AND_USER_TEST_INFORMATION              DebuggerKernelSideTestInformationRequest;
     PDEBUGGER_SEND_USERMODE_MESSAGES_TO_DEBUGGER            DebuggerSendUsermodeMessageRequest;
@@ -51,6 +64,17 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
     PDEBUGGER_PREPARE_DEBUGGEE                              DebuggeeRequest;
     PDEBUGGER_PAUSE_PACKET_RECEIVED                         DebuggerPauseKernelRequest;
     PDEBUGGER_GENERAL_ACTION                                DebuggerNewActionRequest;
+    PDEBUGGER_BINARY_TRACE_MODE_REQUEST                     BinaryTraceModeRequest;
+    PDEBUGGER_QUERY_LOG_BUFFERS_STATISTICS                  LogBuffersStatisticsRequest;
+    PDEBUGGER_EPT_HOOKS_BATCH_REQUEST                       EptHooksBatchRequest;
+    PDEBUGGER_QUERY_EPT_HOOK2_DETOURS                       EptHook2DetoursRequest;
+    PDEBUGGER_QUERY_REVERSE_MAPPING                         ReverseMappingRequest;
+    PDEBUGGER_VMEXIT_STATISTICS_REQUEST                     VmexitStatisticsRequest;
+    PDEBUGGER_SAMPLING_PROFILER_REQUEST                     SamplingProfilerRequest;
+    PDEBUGGER_DIRTY_PAGES_REQUEST                           DirtyPagesRequest;
+    PDEBUGGER_QUERY_PHYSICAL_RAM_RANGES                     PhysicalRamRangesRequest;
+    PDEBUGGER_INTEL_PT_REQUEST                              IntelPtRequest;
+    PDEBUGGER_PEBS_SAMPLING_REQUEST                         PebsSamplingRequest;
     PVOID                                                   BufferToStoreThreadsAndProcessesDetails;
     NTSTATUS                                                Status;
     ULONG                                                   InBuffLength;  // Input buffer length
@@ -68,6 +92,12 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
 
     if (g_AllowIOCTLFromUsermode)
     {
+        //
+        // The same for the larger message buffers that are requested by the
+        // producers (the message tracer is initialized at this point)
+        //
+        LogCheckAndPerformAllocationAndDeallocation();
+
         IrpStack = IoGetCurrentIrpStackLocation(Irp);
 
         switch (IrpStack->Parameters.DeviceIoControl.IoControlCode)
@@ -94,11 +124,20 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             switch (RegisterEventRequest->Type)
             {
             case IRP_BASED:
+            case IRP_BASED_BATCHED:
                 Status = LogRegisterIrpBasedNotification(DeviceObject, Irp);
                 break;
             case EVENT_BASED:
                 Status = LogRegisterEventBasedNotification(DeviceObject, Irp);
                 break;
+            case SHARED_MEMORY_BASED:
+                Status = LogRegisterSharedMemoryNotification(DeviceObject, Irp);
+
+                //
+                // The information is set by the notification mechanism
+                //
+                DoNotChangeInformation = NT_SUCCESS(Status);
+                break;
             default:
                 LogError("Err, unknow notification type from user-mode");
                 Status = STATUS_INVALID_PARAMETER;
@@ -362,6 +401,45 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
 
             break;
 
+        case IOCTL_DEBUGGER_REGISTER_EVENTS_BATCH:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            DebuggerEventsBatchRequest = (PDEBUGGER_EVENTS_BATCH_REQUEST)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Apply the events and actions (the stream of entries is validated
+            // while the entries are applied)
+            //
+            DebuggerParseEventsBatchFromUsermode(DebuggerEventsBatchRequest, InBuffLength);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
         case IOCTL_DEBUGGER_HIDE_AND_UNHIDE_TO_TRANSPARENT_THE_DEBUGGER:
 
             //
@@ -542,6 +620,51 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             //
             DoNotChangeInformation = TRUE;
 
+            break;
+
+        case IOCTL_DEBUGGER_PATCH_MEMORY:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Cast buffer to understandable buffer
+            //
+            DebuggerPatchMemoryRequest = (PDEBUGGER_PATCH_MEMORY_REQUEST)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Apply the patches (the stream of patches is validated while
+            // the patches are applied)
+            //
+            DebuggerCommandPatchMemory(DebuggerPatchMemoryRequest, InBuffLength, FALSE);
+
+            //
+            // Configure IRP status
+            //
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
             break;
         case IOCTL_DEBUGGER_SEARCH_MEMORY:
 
@@ -577,7 +700,8 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             // Here we should validate whether the input parameter is
             // valid or in other words whether we received enough space or not
             //
-            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength != SIZEOF_DEBUGGER_SEARCH_MEMORY + DebuggerSearchMemoryRequest->CountOf64Chunks * sizeof(UINT64))
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength !=
+                SIZEOF_DEBUGGER_SEARCH_MEMORY + ((DebuggerSearchMemoryRequest->CountOf64Chunks * 2) + DebuggerSearchMemoryRequest->CountOfPatterns) * sizeof(UINT64))
             {
                 Status = STATUS_INVALID_PARAMETER;
                 break;
@@ -1046,22 +1170,21 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
 
             break;
 
-        case IOCTL_RESERVE_PRE_ALLOCATED_POOLS:
+        case IOCTL_PERFORM_KERNEL_SIDE_BENCHMARK:
 
             //
             // First validate the parameters.
             //
-            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_PREALLOC_COMMAND || Irp->AssociatedIrp.SystemBuffer == NULL)
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_PERFORM_KERNEL_BENCHMARK || Irp->AssociatedIrp.SystemBuffer == NULL)
             {
                 Status = STATUS_INVALID_PARAMETER;
                 LogError("Err, invalid parameter to IOCTL dispatcher");
                 break;
             }
 
-            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
             OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
 
-            if (!InBuffLength || !OutBuffLength)
+            if (OutBuffLength < SIZEOF_DEBUGGER_PERFORM_KERNEL_BENCHMARK)
             {
                 Status = STATUS_INVALID_PARAMETER;
                 break;
@@ -1069,16 +1192,17 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
 
             //
             // Both usermode and to send to usermode and the comming buffer are
-            // at the same place
+            // at the same place, the results of the cores are stored after the request
             //
-            DebuggerReservePreallocPoolRequest = (PDEBUGGER_PREALLOC_COMMAND)Irp->AssociatedIrp.SystemBuffer;
+            DebuggerKernelBenchmarkRequest = (PDEBUGGER_PERFORM_KERNEL_BENCHMARK)Irp->AssociatedIrp.SystemBuffer;
 
-            //
-            // Perform the reservation pools
-            //
-            DebuggerCommandReservePreallocatedPools(DebuggerReservePreallocPoolRequest);
+            DebuggerKernelBenchmarkRequest->CoresCount = 0;
 
-            Irp->IoStatus.Information = SIZEOF_DEBUGGER_PREALLOC_COMMAND;
+            TestKernelPerformBenchmark(DebuggerKernelBenchmarkRequest,
+                                       (OutBuffLength - SIZEOF_DEBUGGER_PERFORM_KERNEL_BENCHMARK) / sizeof(DEBUGGER_KERNEL_BENCHMARK_CORE_RESULT));
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_PERFORM_KERNEL_BENCHMARK +
+                                        DebuggerKernelBenchmarkRequest->CoresCount * sizeof(DEBUGGER_KERNEL_BENCHMARK_CORE_RESULT);
             Status                    = STATUS_SUCCESS;
 
             //
@@ -1088,12 +1212,12 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
 
             break;
 
-        case IOCTL_SEND_USER_DEBUGGER_COMMANDS:
+        case IOCTL_PERFORM_KERNEL_SIDE_STRESS_TEST:
 
             //
             // First validate the parameters.
             //
-            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < sizeof(DEBUGGER_UD_COMMAND_PACKET) || Irp->AssociatedIrp.SystemBuffer == NULL)
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_PERFORM_KERNEL_STRESS || Irp->AssociatedIrp.SystemBuffer == NULL)
             {
                 Status = STATUS_INVALID_PARAMETER;
                 LogError("Err, invalid parameter to IOCTL dispatcher");
@@ -1103,7 +1227,7 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
             OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
 
-            if (!InBuffLength || !OutBuffLength)
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_PERFORM_KERNEL_STRESS)
             {
                 Status = STATUS_INVALID_PARAMETER;
                 break;
@@ -1113,14 +1237,14 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             // Both usermode and to send to usermode and the comming buffer are
             // at the same place
             //
-            DebuggerUdCommandRequest = (PDEBUGGER_UD_COMMAND_PACKET)Irp->AssociatedIrp.SystemBuffer;
+            DebuggerKernelStressRequest = (PDEBUGGER_PERFORM_KERNEL_STRESS)Irp->AssociatedIrp.SystemBuffer;
 
-            //
-            // Perform the dispatching of user debugger command
-            //
-            UdDispatchUsermodeCommands(DebuggerUdCommandRequest);
+            DebuggerKernelStressRequest->CountOfThreads = 0;
+            DebuggerKernelStressRequest->HungThreads    = 0;
 
-            Irp->IoStatus.Information = sizeof(DEBUGGER_UD_COMMAND_PACKET);
+            TestKernelPerformStress(DebuggerKernelStressRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_PERFORM_KERNEL_STRESS;
             Status                    = STATUS_SUCCESS;
 
             //
@@ -1130,27 +1254,52 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
 
             break;
 
-        case IOCTL_GET_DETAIL_OF_ACTIVE_THREADS_AND_PROCESSES:
+        case IOCTL_QUERY_POOL_MANAGER_STATISTICS:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_POOL_MANAGER_STATISTICS || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
 
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
             OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
 
-            if (!OutBuffLength)
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_POOL_MANAGER_STATISTICS)
             {
                 Status = STATUS_INVALID_PARAMETER;
                 break;
             }
 
             //
-            // Both usermode and to send to usermode is here
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
             //
-            BufferToStoreThreadsAndProcessesDetails = (PVOID)Irp->AssociatedIrp.SystemBuffer;
+            PoolManagerStatisticsRequest = (PDEBUGGER_POOL_MANAGER_STATISTICS)Irp->AssociatedIrp.SystemBuffer;
 
             //
-            // Perform the dispatching of user debugger command
+            // Get the statistics of the pools of all intentions
             //
-            AttachingQueryDetailsOfActiveDebuggingThreadsAndProcesses(BufferToStoreThreadsAndProcessesDetails, OutBuffLength);
+            PoolManagerQueryStatistics(PoolManagerStatisticsRequest->Intentions);
 
-            Irp->IoStatus.Information = OutBuffLength;
+            PoolManagerStatisticsRequest->EptSplitTablesBytes = PoolManagerStatisticsRequest->Intentions[SPLIT_2MB_PAGING_TO_4KB_PAGE].Bytes;
+            PoolManagerStatisticsRequest->HookPagesBytes      = PoolManagerStatisticsRequest->Intentions[TRACKING_HOOKED_PAGES].Bytes +
+                                                                PoolManagerStatisticsRequest->Intentions[EXEC_TRAMPOLINE].Bytes +
+                                                                PoolManagerStatisticsRequest->Intentions[DETOUR_HOOK_DETAILS].Bytes;
+
+            //
+            // Nonpaged buffers that are not allocated by the pool manager
+            //
+            PoolManagerStatisticsRequest->HyperlogBuffersBytes = LogQueryBuffersSize();
+            PoolManagerStatisticsRequest->ScriptBuffersBytes   = ScriptEngineQueryBuffersSize();
+            PoolManagerStatisticsRequest->EventObjectsBytes    = SlabCacheQuerySize(&g_EventsSlabCache) + SlabCacheQuerySize(&g_ActionsSlabCache);
+            PoolManagerStatisticsRequest->KernelStatus         = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_POOL_MANAGER_STATISTICS;
             Status                    = STATUS_SUCCESS;
 
             //
@@ -1160,12 +1309,12 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
 
             break;
 
-        case IOCTL_GET_USER_MODE_MODULE_DETAILS:
+        case IOCTL_QUERY_SPINLOCK_CONTENTION:
 
             //
             // First validate the parameters.
             //
-            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < sizeof(USERMODE_LOADED_MODULE_DETAILS) || Irp->AssociatedIrp.SystemBuffer == NULL)
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_SPINLOCK_CONTENTION_REQUEST || Irp->AssociatedIrp.SystemBuffer == NULL)
             {
                 Status = STATUS_INVALID_PARAMETER;
                 LogError("Err, invalid parameter to IOCTL dispatcher");
@@ -1175,7 +1324,7 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
             OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
 
-            if (!InBuffLength || !OutBuffLength)
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_SPINLOCK_CONTENTION_REQUEST)
             {
                 Status = STATUS_INVALID_PARAMETER;
                 break;
@@ -1185,14 +1334,11 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             // Both usermode and to send to usermode and the comming buffer are
             // at the same place
             //
-            DebuggerUsermodeModulesRequest = (PUSERMODE_LOADED_MODULE_DETAILS)Irp->AssociatedIrp.SystemBuffer;
+            SpinlockContentionRequest = (PDEBUGGER_SPINLOCK_CONTENTION_REQUEST)Irp->AssociatedIrp.SystemBuffer;
 
-            //
-            // Getting the modules details
-            //
-            UserAccessGetLoadedModules(DebuggerUsermodeModulesRequest, OutBuffLength);
+            ExtensionCommandQuerySpinlockContention(SpinlockContentionRequest);
 
-            Irp->IoStatus.Information = OutBuffLength;
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_SPINLOCK_CONTENTION_REQUEST;
             Status                    = STATUS_SUCCESS;
 
             //
@@ -1202,12 +1348,12 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
 
             break;
 
-        case IOCTL_QUERY_COUNT_OF_ACTIVE_PROCESSES_OR_THREADS:
+        case IOCTL_QUERY_VMM_INITIALIZATION_TIMINGS:
 
             //
             // First validate the parameters.
             //
-            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < sizeof(DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS) || Irp->AssociatedIrp.SystemBuffer == NULL)
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_VMM_INITIALIZATION_TIMINGS || Irp->AssociatedIrp.SystemBuffer == NULL)
             {
                 Status = STATUS_INVALID_PARAMETER;
                 LogError("Err, invalid parameter to IOCTL dispatcher");
@@ -1217,7 +1363,7 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
             OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
 
-            if (!InBuffLength || !OutBuffLength)
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_VMM_INITIALIZATION_TIMINGS)
             {
                 Status = STATUS_INVALID_PARAMETER;
                 break;
@@ -1227,21 +1373,13 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             // Both usermode and to send to usermode and the comming buffer are
             // at the same place
             //
-            DebuggerUsermodeProcessOrThreadQueryRequest = (PDEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS)Irp->AssociatedIrp.SystemBuffer;
+            VmmInitializationTimingsRequest = (PDEBUGGER_VMM_INITIALIZATION_TIMINGS)Irp->AssociatedIrp.SystemBuffer;
 
-            //
-            // Getting the count result
-            //
-            if (DebuggerUsermodeProcessOrThreadQueryRequest->QueryType == DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_QUERY_PROCESS_COUNT)
-            {
-                ProcessQueryCount(DebuggerUsermodeProcessOrThreadQueryRequest);
-            }
-            else if (DebuggerUsermodeProcessOrThreadQueryRequest->QueryType == DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_QUERY_THREAD_COUNT)
-            {
-                ThreadQueryCount(DebuggerUsermodeProcessOrThreadQueryRequest);
-            }
+            VmFuncQueryInitializationTimings(VmmInitializationTimingsRequest);
 
-            Irp->IoStatus.Information = SIZEOF_DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS;
+            VmmInitializationTimingsRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_VMM_INITIALIZATION_TIMINGS;
             Status                    = STATUS_SUCCESS;
 
             //
@@ -1251,12 +1389,12 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
 
             break;
 
-        case IOCTL_GET_LIST_OF_THREADS_AND_PROCESSES:
+        case IOCTL_QUERY_EVENTS_STATISTICS:
 
             //
             // First validate the parameters.
             //
-            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < sizeof(DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS) || Irp->AssociatedIrp.SystemBuffer == NULL)
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS || Irp->AssociatedIrp.SystemBuffer == NULL)
             {
                 Status = STATUS_INVALID_PARAMETER;
                 LogError("Err, invalid parameter to IOCTL dispatcher");
@@ -1266,7 +1404,7 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
             OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
 
-            if (!InBuffLength || !OutBuffLength)
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS)
             {
                 Status = STATUS_INVALID_PARAMETER;
                 break;
@@ -1276,25 +1414,50 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             // Both usermode and to send to usermode and the comming buffer are
             // at the same place
             //
-            DebuggerUsermodeProcessOrThreadQueryRequest = (PDEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS)Irp->AssociatedIrp.SystemBuffer;
+            EventsStatisticsRequest = (PDEBUGGER_QUERY_EVENTS_STATISTICS)Irp->AssociatedIrp.SystemBuffer;
+
+            DebuggerQueryEventsStatistics(EventsStatisticsRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS;
+            Status                    = STATUS_SUCCESS;
 
             //
-            // Getting the list of processes or threads
+            // Avoid zeroing it
             //
-            if (DebuggerUsermodeProcessOrThreadQueryRequest->QueryType == DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_QUERY_PROCESS_LIST)
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_QUERY_EVENT_RECORDS:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_QUERY_EVENT_RECORDS || Irp->AssociatedIrp.SystemBuffer == NULL)
             {
-                ProcessQueryList(DebuggerUsermodeProcessOrThreadQueryRequest,
-                                 DebuggerUsermodeProcessOrThreadQueryRequest,
-                                 OutBuffLength);
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
             }
-            else if (DebuggerUsermodeProcessOrThreadQueryRequest->QueryType == DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_QUERY_THREAD_LIST)
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_QUERY_EVENT_RECORDS)
             {
-                ThreadQueryList(DebuggerUsermodeProcessOrThreadQueryRequest,
-                                DebuggerUsermodeProcessOrThreadQueryRequest,
-                                OutBuffLength);
+                Status = STATUS_INVALID_PARAMETER;
+                break;
             }
 
-            Irp->IoStatus.Information = OutBuffLength;
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            EventRecordsRequest = (PDEBUGGER_QUERY_EVENT_RECORDS)Irp->AssociatedIrp.SystemBuffer;
+
+            DebuggerEventRecordsQuery(EventRecordsRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_QUERY_EVENT_RECORDS;
             Status                    = STATUS_SUCCESS;
 
             //
@@ -1304,12 +1467,12 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
 
             break;
 
-        case IOCTL_QUERY_CURRENT_THREAD:
+        case IOCTL_QUERY_DRIVER_VERSION:
 
             //
             // First validate the parameters.
             //
-            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET || Irp->AssociatedIrp.SystemBuffer == NULL)
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_QUERY_DRIVER_VERSION || Irp->AssociatedIrp.SystemBuffer == NULL)
             {
                 Status = STATUS_INVALID_PARAMETER;
                 LogError("Err, invalid parameter to IOCTL dispatcher");
@@ -1319,7 +1482,7 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
             OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
 
-            if (!InBuffLength || !OutBuffLength)
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_QUERY_DRIVER_VERSION)
             {
                 Status = STATUS_INVALID_PARAMETER;
                 break;
@@ -1329,14 +1492,15 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             // Both usermode and to send to usermode and the comming buffer are
             // at the same place
             //
-            GetInformationThreadRequest = (PDEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET)Irp->AssociatedIrp.SystemBuffer;
+            DriverVersionRequest = (PDEBUGGER_QUERY_DRIVER_VERSION)Irp->AssociatedIrp.SystemBuffer;
 
-            //
-            // Get the information
-            //
-            ThreadQueryDetails(GetInformationThreadRequest);
+            DriverVersionRequest->VersionMajor            = VERSION_MAJOR;
+            DriverVersionRequest->VersionMinor            = VERSION_MINOR;
+            DriverVersionRequest->VersionPatch            = VERSION_PATCH;
+            DriverVersionRequest->SizeOfRequestStructures = DEBUGGER_QUERY_DRIVER_VERSION_STRUCTURES_SIZE;
+            DriverVersionRequest->KernelStatus            = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
 
-            Irp->IoStatus.Information = SIZEOF_DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET;
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_QUERY_DRIVER_VERSION;
             Status                    = STATUS_SUCCESS;
 
             //
@@ -1346,12 +1510,12 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
 
             break;
 
-        case IOCTL_QUERY_CURRENT_PROCESS:
+        case IOCTL_RESERVE_PRE_ALLOCATED_POOLS:
 
             //
             // First validate the parameters.
             //
-            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET || Irp->AssociatedIrp.SystemBuffer == NULL)
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_PREALLOC_COMMAND || Irp->AssociatedIrp.SystemBuffer == NULL)
             {
                 Status = STATUS_INVALID_PARAMETER;
                 LogError("Err, invalid parameter to IOCTL dispatcher");
@@ -1371,14 +1535,14 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             // Both usermode and to send to usermode and the comming buffer are
             // at the same place
             //
-            GetInformationProcessRequest = (PDEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET)Irp->AssociatedIrp.SystemBuffer;
+            DebuggerReservePreallocPoolRequest = (PDEBUGGER_PREALLOC_COMMAND)Irp->AssociatedIrp.SystemBuffer;
 
             //
-            // Get the information
+            // Perform the reservation pools
             //
-            ProcessQueryDetails(GetInformationProcessRequest);
+            DebuggerCommandReservePreallocatedPools(DebuggerReservePreallocPoolRequest);
 
-            Irp->IoStatus.Information = SIZEOF_DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET;
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_PREALLOC_COMMAND;
             Status                    = STATUS_SUCCESS;
 
             //
@@ -1388,12 +1552,12 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
 
             break;
 
-        case IOCTL_REQUEST_REV_MACHINE_SERVICE:
+        case IOCTL_SEND_USER_DEBUGGER_COMMANDS:
 
             //
             // First validate the parameters.
             //
-            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_REVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST || Irp->AssociatedIrp.SystemBuffer == NULL)
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < sizeof(DEBUGGER_UD_COMMAND_PACKET) || Irp->AssociatedIrp.SystemBuffer == NULL)
             {
                 Status = STATUS_INVALID_PARAMETER;
                 LogError("Err, invalid parameter to IOCTL dispatcher");
@@ -1413,14 +1577,991 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             // Both usermode and to send to usermode and the comming buffer are
             // at the same place
             //
-            RevServiceRequest = (PREVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST)Irp->AssociatedIrp.SystemBuffer;
+            DebuggerUdCommandRequest = (PDEBUGGER_UD_COMMAND_PACKET)Irp->AssociatedIrp.SystemBuffer;
 
             //
-            // Perform the service request
+            // Perform the dispatching of user debugger command
             //
-            ConfigureInitializeReversingMachineOnAllProcessors(RevServiceRequest);
+            UdDispatchUsermodeCommands(DebuggerUdCommandRequest);
 
-            Irp->IoStatus.Information = SIZEOF_REVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST;
+            Irp->IoStatus.Information = sizeof(DEBUGGER_UD_COMMAND_PACKET);
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_GET_DETAIL_OF_ACTIVE_THREADS_AND_PROCESSES:
+
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!OutBuffLength)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode is here
+            //
+            BufferToStoreThreadsAndProcessesDetails = (PVOID)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Perform the dispatching of user debugger command
+            //
+            AttachingQueryDetailsOfActiveDebuggingThreadsAndProcesses(BufferToStoreThreadsAndProcessesDetails, OutBuffLength);
+
+            Irp->IoStatus.Information = OutBuffLength;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_GET_USER_MODE_MODULE_DETAILS:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < sizeof(USERMODE_LOADED_MODULE_DETAILS) || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || !OutBuffLength)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            DebuggerUsermodeModulesRequest = (PUSERMODE_LOADED_MODULE_DETAILS)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Getting the modules details
+            //
+            UserAccessGetLoadedModules(DebuggerUsermodeModulesRequest, OutBuffLength);
+
+            Irp->IoStatus.Information = OutBuffLength;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_QUERY_COUNT_OF_ACTIVE_PROCESSES_OR_THREADS:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < sizeof(DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS) || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || !OutBuffLength)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            DebuggerUsermodeProcessOrThreadQueryRequest = (PDEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Getting the count result
+            //
+            if (DebuggerUsermodeProcessOrThreadQueryRequest->QueryType == DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_QUERY_PROCESS_COUNT)
+            {
+                ProcessQueryCount(DebuggerUsermodeProcessOrThreadQueryRequest);
+            }
+            else if (DebuggerUsermodeProcessOrThreadQueryRequest->QueryType == DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_QUERY_THREAD_COUNT)
+            {
+                ThreadQueryCount(DebuggerUsermodeProcessOrThreadQueryRequest);
+            }
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_GET_LIST_OF_THREADS_AND_PROCESSES:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < sizeof(DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS) || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || !OutBuffLength)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            DebuggerUsermodeProcessOrThreadQueryRequest = (PDEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Getting the list of processes or threads
+            //
+            if (DebuggerUsermodeProcessOrThreadQueryRequest->QueryType == DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_QUERY_PROCESS_LIST)
+            {
+                ProcessQueryList(DebuggerUsermodeProcessOrThreadQueryRequest,
+                                 DebuggerUsermodeProcessOrThreadQueryRequest,
+                                 OutBuffLength);
+            }
+            else if (DebuggerUsermodeProcessOrThreadQueryRequest->QueryType == DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_QUERY_THREAD_LIST)
+            {
+                ThreadQueryList(DebuggerUsermodeProcessOrThreadQueryRequest,
+                                DebuggerUsermodeProcessOrThreadQueryRequest,
+                                OutBuffLength);
+            }
+
+            Irp->IoStatus.Information = OutBuffLength;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_QUERY_CURRENT_THREAD:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || !OutBuffLength)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            GetInformationThreadRequest = (PDEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Get the information
+            //
+            ThreadQueryDetails(GetInformationThreadRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_QUERY_CURRENT_PROCESS:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || !OutBuffLength)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            GetInformationProcessRequest = (PDEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Get the information
+            //
+            ProcessQueryDetails(GetInformationProcessRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_REQUEST_REV_MACHINE_SERVICE:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_REVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || !OutBuffLength)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            RevServiceRequest = (PREVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Perform the service request
+            //
+            ConfigureInitializeReversingMachineOnAllProcessors(RevServiceRequest);
+
+            Irp->IoStatus.Information = SIZEOF_REVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_QUERY_REV_MACHINE_COVERAGE:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_REVERSING_MACHINE_QUERY_COVERAGE || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_REVERSING_MACHINE_QUERY_COVERAGE)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            RevCoverageRequest = (PREVERSING_MACHINE_QUERY_COVERAGE)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Get the records of the coverage
+            //
+            ConfigureQueryReversingMachineCoverage(RevCoverageRequest);
+
+            Irp->IoStatus.Information = SIZEOF_REVERSING_MACHINE_QUERY_COVERAGE;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_MAP_REV_MACHINE_RESULTS:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_REVERSING_MACHINE_MAP_RESULTS || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_REVERSING_MACHINE_MAP_RESULTS)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            RevMapResultsRequest = (PREVERSING_MACHINE_MAP_RESULTS)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Map the ring into the current process (we're in its context)
+            //
+            ConfigureMapReversingMachineResults(RevMapResultsRequest);
+
+            Irp->IoStatus.Information = SIZEOF_REVERSING_MACHINE_MAP_RESULTS;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_RELEASE_SHARED_MESSAGES:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_LOG_SHARED_BUFFERS_RELEASE || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            //
+            // Release the chunks that are read by the user-mode
+            //
+            if (LogReleaseSharedMemoryMessages((PLOG_SHARED_BUFFERS_RELEASE)Irp->AssociatedIrp.SystemBuffer))
+            {
+                Status = STATUS_SUCCESS;
+            }
+            else
+            {
+                Status = STATUS_INVALID_PARAMETER;
+            }
+
+            break;
+
+        case IOCTL_UNMAP_SHARED_MESSAGE_BUFFERS:
+
+            //
+            // Unmap the buffers from the current process (if mapped)
+            //
+            LogUnmapSharedMemory();
+
+            Status = STATUS_SUCCESS;
+            break;
+
+        case IOCTL_SET_BINARY_TRACE_MODE:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_BINARY_TRACE_MODE_REQUEST || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || !OutBuffLength)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            BinaryTraceModeRequest = (PDEBUGGER_BINARY_TRACE_MODE_REQUEST)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Change the mode of printf messages
+            //
+            g_BinaryTraceMode = BinaryTraceModeRequest->IsEnabled;
+
+            BinaryTraceModeRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_BINARY_TRACE_MODE_REQUEST;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_QUERY_LOG_BUFFERS_STATISTICS:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_QUERY_LOG_BUFFERS_STATISTICS || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_QUERY_LOG_BUFFERS_STATISTICS)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            LogBuffersStatisticsRequest = (PDEBUGGER_QUERY_LOG_BUFFERS_STATISTICS)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Get the statistics of buffers of all cores
+            //
+            LogBuffersStatisticsRequest->CountOfBuffers = LogQueryBufferStatistics(LogBuffersStatisticsRequest->Buffers, MaximumLogSharedRings);
+
+            if (LogBuffersStatisticsRequest->CountOfBuffers == 0)
+            {
+                LogBuffersStatisticsRequest->KernelStatus = DEBUGGER_ERROR_INVALID_ADDRESS;
+            }
+            else
+            {
+                LogBuffersStatisticsRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+            }
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_QUERY_LOG_BUFFERS_STATISTICS;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_PERFORM_EPT_HOOKS_BATCH:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_EPT_HOOKS_BATCH_REQUEST || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || !OutBuffLength)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Cast buffer to understandable buffer
+            //
+            EptHooksBatchRequest = (PDEBUGGER_EPT_HOOKS_BATCH_REQUEST)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Here we should validate whether the input parameter is
+            // valid or in other words whether we received enough space or not
+            //
+            if (InBuffLength != SIZEOF_DEBUGGER_EPT_HOOKS_BATCH_REQUEST + (UINT64)EptHooksBatchRequest->CountOfEntries * sizeof(EPT_HOOKS_BATCH_ENTRY) ||
+                OutBuffLength < InBuffLength)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Apply the hooks (the entries are located after the request)
+            //
+            EptHooksBatchRequest->CountOfAppliedHooks = ConfigureEptHookBatch((PEPT_HOOKS_BATCH_ENTRY)((UINT64)EptHooksBatchRequest + SIZEOF_DEBUGGER_EPT_HOOKS_BATCH_REQUEST),
+                                                                              EptHooksBatchRequest->CountOfEntries);
+
+            if (EptHooksBatchRequest->CountOfAppliedHooks == EptHooksBatchRequest->CountOfEntries)
+            {
+                EptHooksBatchRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+            }
+            else
+            {
+                EptHooksBatchRequest->KernelStatus = DEBUGGER_ERROR_COULD_NOT_BUILD_THE_EPT_HOOK;
+            }
+
+            //
+            // Configure IRP status (the status of each entry is also returned)
+            //
+            Irp->IoStatus.Information = InBuffLength;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_QUERY_EPT_HOOK2_DETOURS:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_QUERY_EPT_HOOK2_DETOURS || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_QUERY_EPT_HOOK2_DETOURS)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            EptHook2DetoursRequest = (PDEBUGGER_QUERY_EPT_HOOK2_DETOURS)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Get the hit counts of the hidden hooks detour
+            //
+            EptHook2DetoursRequest->CountOfHooks = ConfigureEptHook2QueryDetourHitCounts(EptHook2DetoursRequest->Hooks, MaximumEptHook2DetoursToQuery);
+            EptHook2DetoursRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_QUERY_EPT_HOOK2_DETOURS;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_QUERY_REVERSE_MAPPING:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_QUERY_REVERSE_MAPPING || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_QUERY_REVERSE_MAPPING)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            ReverseMappingRequest = (PDEBUGGER_QUERY_REVERSE_MAPPING)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Find the virtual addresses of all processes that map the physical address
+            //
+            if (ReverseMappingQuery(ReverseMappingRequest->PhysicalAddress,
+                                    ReverseMappingRequest->Rebuild,
+                                    ReverseMappingRequest->Mappings,
+                                    MaximumReverseMappingsToQuery,
+                                    &ReverseMappingRequest->CountOfMappings,
+                                    &ReverseMappingRequest->CountOfIndexedMappings))
+            {
+                ReverseMappingRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+            }
+            else
+            {
+                ReverseMappingRequest->KernelStatus = DEBUGGER_ERROR_UNABLE_TO_BUILD_REVERSE_MAPPING_INDEX;
+            }
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_QUERY_REVERSE_MAPPING;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_VMEXIT_STATISTICS:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_VMEXIT_STATISTICS_REQUEST || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_VMEXIT_STATISTICS_REQUEST)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            VmexitStatisticsRequest = (PDEBUGGER_VMEXIT_STATISTICS_REQUEST)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Perform the action on the statistics of vm-exits
+            //
+            ConfigureVmexitStatistics(VmexitStatisticsRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_VMEXIT_STATISTICS_REQUEST;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_SAMPLING_PROFILER:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_SAMPLING_PROFILER_REQUEST || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_SAMPLING_PROFILER_REQUEST)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            SamplingProfilerRequest = (PDEBUGGER_SAMPLING_PROFILER_REQUEST)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Start, stop or query the samples of the sampling profiler
+            //
+            ConfigureSamplingProfiler(SamplingProfilerRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_SAMPLING_PROFILER_REQUEST;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_DIRTY_PAGES:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_DIRTY_PAGES_REQUEST || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_DIRTY_PAGES_REQUEST)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            DirtyPagesRequest = (PDEBUGGER_DIRTY_PAGES_REQUEST)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Enable, disable or query (and clear) the dirty pages
+            //
+            ConfigureDirtyPages(DirtyPagesRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_DIRTY_PAGES_REQUEST;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_QUERY_PHYSICAL_RAM_RANGES:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_QUERY_PHYSICAL_RAM_RANGES || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_QUERY_PHYSICAL_RAM_RANGES)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            PhysicalRamRangesRequest = (PDEBUGGER_QUERY_PHYSICAL_RAM_RANGES)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Query the ranges of the physical RAM
+            //
+            ExtensionCommandQueryPhysicalRamRanges(PhysicalRamRangesRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_QUERY_PHYSICAL_RAM_RANGES;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_INTEL_PT:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_INTEL_PT_REQUEST || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_INTEL_PT_REQUEST)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            IntelPtRequest = (PDEBUGGER_INTEL_PT_REQUEST)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Enable, disable, pause, resume or query the trace of Intel PT
+            //
+            ConfigureIntelPt(IntelPtRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_INTEL_PT_REQUEST;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_PEBS_SAMPLING:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_PEBS_SAMPLING_REQUEST || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            if (!InBuffLength || OutBuffLength < SIZEOF_DEBUGGER_PEBS_SAMPLING_REQUEST)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            PebsSamplingRequest = (PDEBUGGER_PEBS_SAMPLING_REQUEST)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // Start, stop or query the memory access sampling of PEBS
+            //
+            ConfigurePebsSampling(PebsSamplingRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_PEBS_SAMPLING_REQUEST;
+            Status                    = STATUS_SUCCESS;
+
+            //
+            // Avoid zeroing it
+            //
+            DoNotChangeInformation = TRUE;
+
+            break;
+
+        case IOCTL_SEND_USER_DEBUGGER_BATCH_COMMANDS:
+
+            //
+            // First validate the parameters.
+            //
+            if (IrpStack->Parameters.DeviceIoControl.InputBufferLength < SIZEOF_DEBUGGER_UD_BATCH_COMMAND_PACKET || Irp->AssociatedIrp.SystemBuffer == NULL)
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                LogError("Err, invalid parameter to IOCTL dispatcher");
+                break;
+            }
+
+            InBuffLength  = IrpStack->Parameters.DeviceIoControl.InputBufferLength;
+            OutBuffLength = IrpStack->Parameters.DeviceIoControl.OutputBufferLength;
+
+            //
+            // Both usermode and to send to usermode and the comming buffer are
+            // at the same place
+            //
+            DebuggerUdBatchCommandRequest = (PDEBUGGER_UD_BATCH_COMMAND_PACKET)Irp->AssociatedIrp.SystemBuffer;
+
+            //
+            // The entries should be in both of the buffers
+            //
+            if (DebuggerUdBatchCommandRequest->CountOfEntries > DEBUGGER_UD_BATCH_COMMAND_MAXIMUM_ENTRIES ||
+                InBuffLength < SIZEOF_DEBUGGER_UD_BATCH_COMMAND_PACKET + DebuggerUdBatchCommandRequest->CountOfEntries * sizeof(DEBUGGER_UD_BATCH_COMMAND_ENTRY) ||
+                OutBuffLength < SIZEOF_DEBUGGER_UD_BATCH_COMMAND_PACKET + DebuggerUdBatchCommandRequest->CountOfEntries * sizeof(DEBUGGER_UD_BATCH_COMMAND_ENTRY))
+            {
+                Status = STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            //
+            // Perform the dispatching of the batch of user debugger commands
+            //
+            UdDispatchUsermodeBatchCommands(DebuggerUdBatchCommandRequest);
+
+            Irp->IoStatus.Information = SIZEOF_DEBUGGER_UD_BATCH_COMMAND_PACKET +
+                                        DebuggerUdBatchCommandRequest->CountOfEntries * sizeof(DEBUGGER_UD_BATCH_COMMAND_ENTRY);
             Status                    = STATUS_SUCCESS;
 
             //
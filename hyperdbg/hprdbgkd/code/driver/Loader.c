@@ -51,6 +51,7 @@ LoaderInitVmmAndDebugger()
     VmmCallbacks.VmmCallbackQueryTerminateProtectedResource = TerminateQueryDebuggerResource;
     VmmCallbacks.VmmCallbackRestoreEptState                 = UserAccessCheckForLoadedModuleDetails;
     VmmCallbacks.VmmCallbackCheckUnhandledEptViolations     = AttachingCheckUnhandledEptViolation;
+    VmmCallbacks.VmmCallbackApplyPendingTasks               = DebuggerApplyPendingEventsResources;
 
     //
     // Fill the debugging callbacks
@@ -64,6 +65,7 @@ LoaderInitVmmAndDebugger()
     VmmCallbacks.AttachingHandleCr3VmexitsForThreadInterception            = AttachingHandleCr3VmexitsForThreadInterception;
     VmmCallbacks.KdCheckAndHandleNmiCallback                               = KdCheckAndHandleNmiCallback;
     VmmCallbacks.KdQueryDebuggerQueryThreadOrProcessTracingDetailsByCoreId = KdQueryDebuggerQueryThreadOrProcessTracingDetailsByCoreId;
+    VmmCallbacks.DebuggingCallbackHandleInstructionCounterOverflow         = KdHandleInstructionCounterOverflow;
 
     //
     // Fill the interception callbacks
@@ -73,7 +75,7 @@ LoaderInitVmmAndDebugger()
     //
     // Initialize message tracer
     //
-    if (LogInitialize(&MsgTracingCallbacks))
+    if (LogInitialize(&MsgTracingCallbacks, &g_LogBufferConfiguration))
     {
         //
         // Initialize Vmx
@@ -119,6 +121,62 @@ LoaderInitVmmAndDebugger()
     return FALSE;
 }
 
+/**
+ * @brief Read the capacity of the message buffers from the parameters of the driver
+ * @details the values are read from the 'Parameters' subkey of the service key of
+ * the driver, missing values mean that the default capacities are used
+ *
+ * @param RegistryPath The service key of the driver
+ * @return VOID
+ */
+VOID
+LoaderReadLogBufferConfiguration(PUNICODE_STRING RegistryPath)
+{
+    NTSTATUS                 Status;
+    UINT32                   DefaultValue  = 0;
+    RTL_QUERY_REGISTRY_TABLE QueryTable[5] = {0};
+
+    RtlZeroMemory(&g_LogBufferConfiguration, sizeof(LOG_BUFFER_CONFIGURATION));
+
+    QueryTable[0].Flags = RTL_QUERY_REGISTRY_SUBKEY;
+    QueryTable[0].Name  = L"Parameters";
+
+    QueryTable[1].Flags         = RTL_QUERY_REGISTRY_DIRECT | RTL_QUERY_REGISTRY_TYPECHECK;
+    QueryTable[1].Name          = L"LogPacketsCapacityPerCore";
+    QueryTable[1].EntryContext  = &g_LogBufferConfiguration.PacketsCapacityPerCore;
+    QueryTable[1].DefaultType   = (REG_DWORD << RTL_QUERY_REGISTRY_TYPECHECK_SHIFT) | REG_DWORD;
+    QueryTable[1].DefaultData   = &DefaultValue;
+    QueryTable[1].DefaultLength = sizeof(UINT32);
+
+    QueryTable[2].Flags         = RTL_QUERY_REGISTRY_DIRECT | RTL_QUERY_REGISTRY_TYPECHECK;
+    QueryTable[2].Name          = L"LogPacketsCapacityPriorityPerCore";
+    QueryTable[2].EntryContext  = &g_LogBufferConfiguration.PacketsCapacityPriorityPerCore;
+    QueryTable[2].DefaultType   = (REG_DWORD << RTL_QUERY_REGISTRY_TYPECHECK_SHIFT) | REG_DWORD;
+    QueryTable[2].DefaultData   = &DefaultValue;
+    QueryTable[2].DefaultLength = sizeof(UINT32);
+
+    QueryTable[3].Flags         = RTL_QUERY_REGISTRY_DIRECT | RTL_QUERY_REGISTRY_TYPECHECK;
+    QueryTable[3].Name          = L"LogMaximumPacketsCapacityPerCore";
+    QueryTable[3].EntryContext  = &g_LogBufferConfiguration.MaximumPacketsCapacityPerCore;
+    QueryTable[3].DefaultType   = (REG_DWORD << RTL_QUERY_REGISTRY_TYPECHECK_SHIFT) | REG_DWORD;
+    QueryTable[3].DefaultData   = &DefaultValue;
+    QueryTable[3].DefaultLength = sizeof(UINT32);
+
+    Status = RtlQueryRegistryValues(RTL_REGISTRY_ABSOLUTE,
+                                    RegistryPath->Buffer,
+                                    QueryTable,
+                                    NULL,
+                                    NULL);
+
+    if (!NT_SUCCESS(Status))
+    {
+        //
+        // The parameters are not available, use the default capacities
+        //
+        RtlZeroMemory(&g_LogBufferConfiguration, sizeof(LOG_BUFFER_CONFIGURATION));
+    }
+}
+
 /**
  * @brief Uninitialize the log tracer
  *
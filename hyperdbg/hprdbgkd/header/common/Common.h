@@ -93,6 +93,9 @@ typedef enum _PROCESS_KILL_METHODS
 BOOLEAN
 CommonIsProcessExist(UINT32 ProcId);
 
+BOOLEAN
+CommonIsThreadExist(UINT32 ThreadId);
+
 PCHAR
 CommonGetProcessNameFromProcessControlBlock(PEPROCESS Eprocess);
 
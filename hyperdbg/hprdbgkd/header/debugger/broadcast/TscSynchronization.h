@@ -0,0 +1,54 @@
+/**
+ * @file TscSynchronization.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for measuring the skew of the time-stamp counters of cores
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Count of round-trips between the first core and each core, the
+ * round-trip with the least duration is used for the skew of the core
+ *
+ */
+#define TSC_SYNCHRONIZATION_ROUNDS 32
+
+//////////////////////////////////////////////////
+//				   Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The state of measuring the skew of the time-stamp counters
+ * @details the first core sends requests to the other cores (one core at a
+ * time) and each of them responds with its time-stamp counter
+ *
+ */
+typedef struct _TSC_SYNCHRONIZATION_STATE
+{
+    volatile LONG   TargetCore; // The core that responds to the requests
+    volatile LONG   Request;    // Sequence of the last request of the first core
+    volatile LONG   Response;   // Sequence of the last response of the target core
+    volatile LONG64 TargetTsc;  // Time-stamp counter of the target core at the response
+    volatile LONG   IsFinished; // All of the cores are measured
+    INT64           MaximumSkew;
+
+} TSC_SYNCHRONIZATION_STATE, *PTSC_SYNCHRONIZATION_STATE;
+
+//////////////////////////////////////////////////
+//				   Functions					//
+//////////////////////////////////////////////////
+
+VOID
+TscSynchronizationMeasureOffsets();
+
+VOID
+TscSynchronizationPerformOnCore(UINT32 CoreId);
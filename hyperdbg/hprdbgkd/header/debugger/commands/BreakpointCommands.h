@@ -11,16 +11,40 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//				     Constants		      		//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Count of the buckets of the index of breakpoints by their
+ * physical addresses (power of two)
+ *
+ */
+#define BREAKPOINT_INDEX_BUCKETS_COUNT 256
+
+/**
+ * @brief Get the bucket of a physical address in the index of breakpoints
+ *
+ */
+#define BREAKPOINT_INDEX_GET_BUCKET(PhysAddress) \
+    (((PhysAddress) ^ ((PhysAddress) >> 12)) & (BREAKPOINT_INDEX_BUCKETS_COUNT - 1))
+
 //////////////////////////////////////////////////
 //				     Functions		      		//
 //////////////////////////////////////////////////
 
+VOID
+BreakpointInitialize();
+
 VOID
 BreakpointRemoveAllBreakpoints();
 
 BOOLEAN
 BreakpointAddNew(PDEBUGGEE_BP_PACKET BpDescriptorArg);
 
+PDEBUGGEE_BP_DESCRIPTOR
+BreakpointGetEntryByPhysicalAddress(UINT64 PhysAddress);
+
 BOOLEAN
 BreakpointListOrModify(PDEBUGGEE_BP_LIST_OR_MODIFY_PACKET ListOrModifyBreakpoints);
 
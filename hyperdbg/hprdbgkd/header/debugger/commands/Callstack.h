@@ -11,6 +11,123 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//				     Constants		      		//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum count of the frames that are unwound in a single walk
+ *
+ */
+#define CALLSTACK_MAXIMUM_UNWOUND_FRAMES 64
+
+/**
+ * @brief Maximum count of the pages that are scanned backward to find the
+ * image base of an address (32 MB)
+ *
+ */
+#define CALLSTACK_MAXIMUM_IMAGE_SCAN_PAGES 0x2000
+
+/**
+ * @brief Maximum count of the chained unwind infos of a function
+ *
+ */
+#define CALLSTACK_MAXIMUM_CHAINED_UNWIND_INFOS 32
+
+/**
+ * @brief The fields of the PE headers that are used for unwinding
+ *
+ */
+#define CALLSTACK_IMAGE_DOS_SIGNATURE       0x5A4D     // MZ
+#define CALLSTACK_IMAGE_NT_SIGNATURE        0x00004550 // PE00
+#define CALLSTACK_IMAGE_FILE_MACHINE_AMD64  0x8664
+#define CALLSTACK_IMAGE_NT_OPTIONAL_HDR64   0x20b
+#define CALLSTACK_IMAGE_DIRECTORY_EXCEPTION 3
+
+#define CALLSTACK_IMAGE_DOS_LFANEW_OFFSET                 0x3c // e_lfanew of IMAGE_DOS_HEADER
+#define CALLSTACK_IMAGE_NT_MACHINE_OFFSET                 0x04 // FileHeader.Machine of IMAGE_NT_HEADERS64
+#define CALLSTACK_IMAGE_NT_MAGIC_OFFSET                   0x18 // OptionalHeader.Magic of IMAGE_NT_HEADERS64
+#define CALLSTACK_IMAGE_NT_SIZE_OF_IMAGE_OFFSET           0x50 // OptionalHeader.SizeOfImage of IMAGE_NT_HEADERS64
+#define CALLSTACK_IMAGE_NT_NUMBER_OF_RVA_AND_SIZES_OFFSET 0x84 // OptionalHeader.NumberOfRvaAndSizes of IMAGE_NT_HEADERS64
+#define CALLSTACK_IMAGE_NT_EXCEPTION_DIRECTORY_OFFSET     0xa0 // OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXCEPTION]
+#define CALLSTACK_IMAGE_NT_HEADERS_SIZE                   0xa8
+
+/**
+ * @brief The flags of UNWIND_INFO
+ *
+ */
+#define CALLSTACK_UNW_FLAG_CHAININFO 0x4
+
+/**
+ * @brief The unwind operation codes (UWOP_*)
+ *
+ */
+#define CALLSTACK_UWOP_PUSH_NONVOL     0
+#define CALLSTACK_UWOP_ALLOC_LARGE     1
+#define CALLSTACK_UWOP_ALLOC_SMALL     2
+#define CALLSTACK_UWOP_SET_FPREG       3
+#define CALLSTACK_UWOP_SAVE_NONVOL     4
+#define CALLSTACK_UWOP_SAVE_NONVOL_FAR 5
+#define CALLSTACK_UWOP_EPILOG          6
+#define CALLSTACK_UWOP_SPARE_CODE      7
+#define CALLSTACK_UWOP_SAVE_XMM128     8
+#define CALLSTACK_UWOP_SAVE_XMM128_FAR 9
+#define CALLSTACK_UWOP_PUSH_MACHFRAME  10
+
+/**
+ * @brief Index of RSP in the general-purpose registers (same as GUEST_REGS)
+ *
+ */
+#define CALLSTACK_REGISTER_RSP 4
+
+//////////////////////////////////////////////////
+//				     Structures		      		//
+//////////////////////////////////////////////////
+
+/**
+ * @brief An entry of the table of functions of an image (RUNTIME_FUNCTION)
+ *
+ */
+typedef struct _CALLSTACK_RUNTIME_FUNCTION
+{
+    UINT32 BeginAddress;
+    UINT32 EndAddress;
+    UINT32 UnwindData;
+
+} CALLSTACK_RUNTIME_FUNCTION, *PCALLSTACK_RUNTIME_FUNCTION;
+
+/**
+ * @brief The header of the unwind info of a function (UNWIND_INFO)
+ *
+ */
+typedef struct _CALLSTACK_UNWIND_INFO
+{
+    UINT8 Version : 3;
+    UINT8 Flags : 5;
+    UINT8 SizeOfProlog;
+    UINT8 CountOfCodes;
+    UINT8 FrameRegister : 4;
+    UINT8 FrameOffset : 4;
+
+} CALLSTACK_UNWIND_INFO, *PCALLSTACK_UNWIND_INFO;
+
+/**
+ * @brief A slot of the unwind codes of a function (UNWIND_CODE)
+ *
+ */
+typedef union _CALLSTACK_UNWIND_CODE
+{
+    struct
+    {
+        UINT8 CodeOffset;
+        UINT8 UnwindOp : 4;
+        UINT8 OpInfo : 4;
+    };
+
+    UINT16 FrameOffset;
+
+} CALLSTACK_UNWIND_CODE, *PCALLSTACK_UNWIND_CODE;
+
 //////////////////////////////////////////////////
 //				     Functions		      		//
 //////////////////////////////////////////////////
@@ -20,3 +137,23 @@ CallstackWalkthroughStack(PDEBUGGER_SINGLE_CALLSTACK_FRAME AddressToSaveFrames,
                           UINT64                           StackBaseAddress,
                           UINT32                           Size,
                           BOOLEAN                          Is32Bit);
+
+UINT32
+CallstackCaptureReturnAddresses(UINT64   StackBaseAddress,
+                                UINT32   Size,
+                                UINT64 * AddressesToSaveFrames,
+                                UINT32   MaximumFrames);
+
+UINT32
+CallstackUnwindFrames(PROCESSOR_DEBUGGING_STATE * DbgState,
+                      GUEST_REGS *                Regs,
+                      UINT64                      Rip,
+                      UINT64 *                    ReturnAddresses,
+                      UINT64 *                    StackAddresses,
+                      UINT32                      MaximumFrames);
+
+BOOLEAN
+CallstackMarkUnwoundReturnAddresses(PROCESSOR_DEBUGGING_STATE *      DbgState,
+                                    PDEBUGGER_SINGLE_CALLSTACK_FRAME AddressToSaveFrames,
+                                    UINT64                           StackBaseAddress,
+                                    UINT32                           Size);
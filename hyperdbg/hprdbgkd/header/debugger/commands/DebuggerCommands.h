@@ -13,6 +13,117 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//				    Constants		      		//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Count of slices of each core in the parallel searches
+ * @details more slices than cores balance the slices that have
+ * less RAM (or less readable pages)
+ *
+ */
+#define SearchParallelSlicesPerCore 4
+
+/**
+ * @brief Minimum size of each slice of the parallel searches
+ *
+ */
+#define SearchParallelMinimumSliceSize (PAGE_SIZE * 64)
+
+/**
+ * @brief Count of results that each slice of the parallel searches saves
+ * @details the rest of the slice is searched by the operating core
+ *
+ */
+#define SearchParallelResultsPerSlice 256
+
+/**
+ * @brief Size of the buffer of each core for reading the memory in the
+ * parallel searches
+ *
+ */
+#define SearchParallelBufferSize (PAGE_SIZE + MaximumSearchPatternSize)
+
+//////////////////////////////////////////////////
+//				    Structures		      		//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A pattern of the search request
+ *
+ */
+typedef struct _SEARCH_MEMORY_PATTERN
+{
+    UINT32 FirstElement;    // Index of the first element in the values and masks
+    UINT32 CountOfElements; // Count of elements (bytes, dwords, or qwords)
+
+} SEARCH_MEMORY_PATTERN, *PSEARCH_MEMORY_PATTERN;
+
+/**
+ * @brief State of searching the memory
+ *
+ */
+typedef struct _SEARCH_MEMORY_STATE
+{
+    PDEBUGGER_SEARCH_MEMORY Request;
+    PUINT64                 Values;                        // Values of elements of all patterns
+    PUINT64                 Masks;                         // Masks of elements (the bytes of wildcards are zero)
+    UINT32                  ElementSize;                   // Size of each element
+    UINT64                  ElementMask;                   // The bytes of each element
+    SEARCH_MEMORY_PATTERN   Patterns[MaximumSearchPatterns];
+    UINT32                  CountOfPatterns;
+    UINT32                  MaximumPatternLength;          // Length of the longest pattern (in bytes)
+    UINT64                  FirstBytesBitmap[4];           // Bitmap of the first bytes of patterns
+    BOOLEAN                 CanFilterFirstByte;            // None of the patterns start with a wildcard
+    BOOLEAN                 HasSingleFirstByte;            // All of the patterns start with the same byte
+    UINT8                   FirstByte;                     // The first byte (if HasSingleFirstByte)
+    UINT64                  FirstBytePattern;              // The first byte repeated in a qword
+    BOOLEAN                 IsDebuggeePaused;
+    BOOLEAN                 IsPhysical;                    // Physical addresses are searched (only RAM is read)
+    UINT64                  EndOfSearch;                   // End of the whole search (patterns might end before it)
+    PUINT64                 Results;                       // Results buffer (the results are sent in batches if it's NULL)
+    UINT32                  ResultsCapacity;               // Count of results that can be saved in the results buffer
+    UINT32                  ResultsCount;
+    BOOLEAN                 IsResultsBufferFull;
+    UINT64                  ResumeAddress;                 // The search is continued from here if the results buffer is full
+    UINT64                  Batch[SearchResultsBatchSize]; // Results that are not sent yet (if there is no results buffer)
+    UINT32                  BatchCount;
+    UINT32                  CountOfMatchedCases;
+
+} SEARCH_MEMORY_STATE, *PSEARCH_MEMORY_STATE;
+
+/**
+ * @brief A slice of the parallel searches
+ *
+ */
+typedef struct _SEARCH_MEMORY_PARALLEL_SLICE
+{
+    UINT64 StartAddress;
+    UINT64 EndAddress;
+    UINT64 ResumeAddress; // First address that is not searched (if the results are full)
+    UINT32 CountOfResults;
+    UINT64 Results[SearchParallelResultsPerSlice];
+
+} SEARCH_MEMORY_PARALLEL_SLICE, *PSEARCH_MEMORY_PARALLEL_SLICE;
+
+/**
+ * @brief The parallel search that is performed by the halted cores
+ *
+ */
+typedef struct _SEARCH_MEMORY_PARALLEL_JOB
+{
+    volatile LONG           Active;        // The halted cores can take the slices
+    volatile LONG           ActiveWorkers; // Count of cores that are using the job
+    PDEBUGGER_SEARCH_MEMORY Request;
+    CR3_TYPE                LayoutCr3;     // Memory layout of the operating core
+    UINT64                  EndAddress;
+    UINT32                  CountOfSlices;
+    volatile LONG           NextSlice;     // Index of the next slice that is not taken
+    volatile LONG           FinishedSlices;
+
+} SEARCH_MEMORY_PARALLEL_JOB, *PSEARCH_MEMORY_PARALLEL_JOB;
+
 //////////////////////////////////////////////////
 //				     Functions		      		//
 //////////////////////////////////////////////////
@@ -32,9 +143,15 @@ DebuggerReadOrWriteMsr(PDEBUGGER_READ_AND_WRITE_ON_MSR ReadOrWriteMsrRequest, UI
 NTSTATUS
 DebuggerCommandEditMemory(PDEBUGGER_EDIT_MEMORY EditMemRequest);
 
+BOOLEAN
+DebuggerCommandPatchMemory(PDEBUGGER_PATCH_MEMORY_REQUEST PatchMemRequest, UINT32 RequestLength, BOOLEAN ApplyFromVmxRoot);
+
 NTSTATUS
 DebuggerCommandSearchMemory(PDEBUGGER_SEARCH_MEMORY SearchMemRequest);
 
+BOOLEAN
+SearchMemoryParallelWorker(UINT32 CoreId);
+
 NTSTATUS
 DebuggerCommandFlush(PDEBUGGER_FLUSH_LOGGING_BUFFERS DebuggerFlushBuffersRequest);
 
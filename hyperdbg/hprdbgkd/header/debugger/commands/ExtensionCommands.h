@@ -33,24 +33,42 @@ ExtensionCommandChangeAllMsrBitmapWriteAllCores(UINT64 BitmapMask);
 VOID
 ExtensionCommandResetAllMsrBitmapWriteAllCores();
 
+VOID
+ExtensionCommandUnsetMsrBitmapReadAllCores(UINT64 BitmapMask);
+
+VOID
+ExtensionCommandUnsetMsrBitmapWriteAllCores(UINT64 BitmapMask);
+
 VOID
 ExtensionCommandEnableRdtscExitingAllCores();
 
+VOID
+ExtensionCommandEnableRdtscExitingOnCores(UINT64 CoreMask);
+
 VOID
 ExtensionCommandDisableRdtscExitingAllCores();
 
 VOID
 ExtensionCommandDisableRdtscExitingForClearingEventsAllCores();
 
+VOID
+ExtensionCommandDisableRdtscExitingForClearingEventsOnCores(UINT64 CoreMask);
+
 VOID
 ExtensionCommandDisableMov2DebugRegsExitingForClearingEventsAllCores();
 
 VOID
 ExtensionCommandEnableRdpmcExitingAllCores();
 
+VOID
+ExtensionCommandEnableRdpmcExitingOnCores(UINT64 CoreMask);
+
 VOID
 ExtensionCommandDisableRdpmcExitingAllCores();
 
+VOID
+ExtensionCommandDisableRdpmcExitingOnCores(UINT64 CoreMask);
+
 VOID
 ExtensionCommandSetExceptionBitmapAllCores(UINT64 ExceptionIndex);
 
@@ -69,9 +87,15 @@ ExtensionCommandDisableMovDebugRegistersExitingAllCores();
 VOID
 ExtensionCommandSetExternalInterruptExitingAllCores();
 
+VOID
+ExtensionCommandSetExternalInterruptExitingOnCores(UINT64 CoreMask);
+
 VOID
 ExtensionCommandUnsetExternalInterruptExitingOnlyOnClearingInterruptEventsAllCores();
 
+VOID
+ExtensionCommandUnsetExternalInterruptExitingOnlyOnClearingInterruptEventsOnCores(UINT64 CoreMask);
+
 VOID
 ExtensionCommandIoBitmapChangeAllCores(UINT64 Port);
 
@@ -83,3 +107,15 @@ ExtensionCommandEnableMovControlRegisterExitingAllCores(PDEBUGGER_EVENT Event);
 
 VOID
 ExtensionCommandDisableMov2ControlRegsExitingForClearingEventsAllCores(PDEBUGGER_EVENT Event);
+
+VOID
+ExtensionCommandAcquireBitmapOwnershipAllCores(PDEBUGGER_BROADCASTING_OPTIONS BroadcastingOption);
+
+VOID
+ExtensionCommandReleaseBitmapOwnershipAllCores(PDEBUGGER_BROADCASTING_OPTIONS BroadcastingOption);
+
+VOID
+ExtensionCommandQueryPhysicalRamRanges(PDEBUGGER_QUERY_PHYSICAL_RAM_RANGES RamRangesRequest);
+
+VOID
+ExtensionCommandQuerySpinlockContention(PDEBUGGER_SPINLOCK_CONTENTION_REQUEST ContentionRequest);
@@ -0,0 +1,272 @@
+/**
+ * @file NetworkConnection.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Header for network connection from debuggee to debugger
+ * @details
+ * @version 0.4
+ * @date 2023-07-26
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					 Constants					//
+//////////////////////////////////////////////////
+
+//
+// Count of descriptors and size of the buffer of each descriptor
+//
+#define NETWORK_CONNECTION_RX_DESCRIPTORS 128
+#define NETWORK_CONNECTION_TX_DESCRIPTORS 64
+#define NETWORK_CONNECTION_BUFFER_SIZE    2048
+
+//
+// Timeouts (in microseconds)
+//
+#define NETWORK_CONNECTION_RESET_TIMEOUT 100000
+#define NETWORK_CONNECTION_ARP_TIMEOUT   1000000
+#define NETWORK_CONNECTION_ARP_RETRIES   5
+
+//
+// Interval of polling the adapter while the debuggee is running (in milliseconds)
+//
+#define NETWORK_CONNECTION_POLLING_INTERVAL 1
+
+//
+// PCI configuration space (mechanism #1)
+//
+#define PCI_CONFIG_ADDRESS_PORT 0xCF8
+#define PCI_CONFIG_DATA_PORT    0xCFC
+
+#define PCI_CONFIG_VENDOR_DEVICE 0x00
+#define PCI_CONFIG_COMMAND       0x04
+#define PCI_CONFIG_BAR0          0x10
+
+#define PCI_COMMAND_MEMORY_SPACE 0x2
+#define PCI_COMMAND_BUS_MASTER   0x4
+
+#define PCI_VENDOR_INTEL 0x8086
+
+//
+// Registers of Intel 8254x and 82574 adapters (e1000)
+//
+#define E1000_CTRL   0x0000
+#define E1000_STATUS 0x0008
+#define E1000_IMC    0x00D8
+#define E1000_RCTL   0x0100
+#define E1000_TCTL   0x0400
+#define E1000_TIPG   0x0410
+#define E1000_RDBAL  0x2800
+#define E1000_RDBAH  0x2804
+#define E1000_RDLEN  0x2808
+#define E1000_RDH    0x2810
+#define E1000_RDT    0x2818
+#define E1000_TDBAL  0x3800
+#define E1000_TDBAH  0x3804
+#define E1000_TDLEN  0x3808
+#define E1000_TDH    0x3810
+#define E1000_TDT    0x3818
+#define E1000_MTA    0x5200
+#define E1000_RAL0   0x5400
+#define E1000_RAH0   0x5404
+
+#define E1000_CTRL_ASDE 0x00000020
+#define E1000_CTRL_SLU  0x00000040
+#define E1000_CTRL_RST  0x04000000
+
+#define E1000_RCTL_EN    0x00000002
+#define E1000_RCTL_BAM   0x00008000
+#define E1000_RCTL_SECRC 0x04000000
+
+#define E1000_TCTL_EN   0x00000002
+#define E1000_TCTL_PSP  0x00000008
+#define E1000_TCTL_CT   0x000000F0 // Collision threshold (0x0F)
+#define E1000_TCTL_COLD 0x0003F000 // Collision distance (0x3F)
+
+#define E1000_TIPG_DEFAULT 0x0060200A
+
+#define E1000_RAH_AV 0x80000000
+
+#define E1000_TX_CMD_EOP  0x01
+#define E1000_TX_CMD_IFCS 0x02
+#define E1000_TX_CMD_RS   0x08
+
+#define E1000_DESCRIPTOR_STATUS_DD  0x01
+#define E1000_DESCRIPTOR_STATUS_EOP 0x02
+
+#define E1000_MTA_ENTRIES 128
+
+//
+// Ethernet, ARP, IPv4 and UDP
+//
+#define ETHERNET_TYPE_IPV4 0x0800
+#define ETHERNET_TYPE_ARP  0x0806
+
+#define ARP_HARDWARE_ETHERNET 1
+#define ARP_OPERATION_REQUEST 1
+#define ARP_OPERATION_REPLY   2
+
+#define IPV4_PROTOCOL_UDP   17
+#define IPV4_DEFAULT_TTL    64
+#define IPV4_VERSION_IHL    0x45
+#define IPV4_FLAG_DONT_FRAG 0x4000
+
+#define ETHERNET_MINIMUM_FRAME_SIZE 60
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+#pragma pack(push, 1)
+
+/**
+ * @brief Legacy receive descriptor
+ *
+ */
+typedef struct _E1000_RX_DESCRIPTOR
+{
+    UINT64         BufferAddress;
+    UINT16         Length;
+    UINT16         Checksum;
+    volatile UINT8 Status;
+    UINT8          Errors;
+    UINT16         Special;
+
+} E1000_RX_DESCRIPTOR, *PE1000_RX_DESCRIPTOR;
+
+/**
+ * @brief Legacy transmit descriptor
+ *
+ */
+typedef struct _E1000_TX_DESCRIPTOR
+{
+    UINT64         BufferAddress;
+    UINT16         Length;
+    UINT8          ChecksumOffset;
+    UINT8          Command;
+    volatile UINT8 Status;
+    UINT8          ChecksumStart;
+    UINT16         Special;
+
+} E1000_TX_DESCRIPTOR, *PE1000_TX_DESCRIPTOR;
+
+/**
+ * @brief Headers of the UDP packets
+ *
+ */
+typedef struct _NETWORK_UDP_PACKET_HEADER
+{
+    //
+    // Ethernet
+    //
+    UINT8  DestinationMac[6];
+    UINT8  SourceMac[6];
+    UINT16 EtherType;
+
+    //
+    // IPv4
+    //
+    UINT8  VersionAndHeaderLength;
+    UINT8  TypeOfService;
+    UINT16 TotalLength;
+    UINT16 Identification;
+    UINT16 FlagsAndFragmentOffset;
+    UINT8  TimeToLive;
+    UINT8  Protocol;
+    UINT16 HeaderChecksum;
+    UINT32 SourceIp;
+    UINT32 DestinationIp;
+
+    //
+    // UDP
+    //
+    UINT16 SourcePort;
+    UINT16 DestinationPort;
+    UINT16 UdpLength;
+    UINT16 UdpChecksum;
+
+} NETWORK_UDP_PACKET_HEADER, *PNETWORK_UDP_PACKET_HEADER;
+
+/**
+ * @brief ARP packets (over ethernet)
+ *
+ */
+typedef struct _NETWORK_ARP_PACKET
+{
+    UINT8  DestinationMac[6];
+    UINT8  SourceMac[6];
+    UINT16 EtherType;
+
+    UINT16 HardwareType;
+    UINT16 ProtocolType;
+    UINT8  HardwareLength;
+    UINT8  ProtocolLength;
+    UINT16 Operation;
+    UINT8  SenderMac[6];
+    UINT32 SenderIp;
+    UINT8  TargetMac[6];
+    UINT32 TargetIp;
+
+} NETWORK_ARP_PACKET, *PNETWORK_ARP_PACKET;
+
+#pragma pack(pop)
+
+/**
+ * @brief State of the network connection
+ *
+ */
+typedef struct _NETWORK_CONNECTION_STATE
+{
+    volatile UINT8 *     Registers;
+    SIZE_T               RegistersSize;
+    PE1000_RX_DESCRIPTOR RxDescriptors;
+    PE1000_TX_DESCRIPTOR TxDescriptors;
+    BYTE *               RxBuffers;
+    BYTE *               TxBuffers;
+    UINT32               NextRxDescriptor;
+    UINT32               NextTxDescriptor;
+
+    UINT8  DebuggeeMac[6];
+    UINT8  DebuggerMac[6];
+    UINT32 DebuggeeIp; // Network byte order
+    UINT32 DebuggerIp; // Network byte order
+    UINT16 UdpPort;    // Network byte order
+    UINT16 IpIdentification;
+
+    //
+    // The datagram that is being received
+    //
+    UINT32  RxDatagramOffset; // Offset of the next byte in the buffers
+    UINT32  RxDatagramLength; // Count of the bytes that are not read
+    BOOLEAN IsRxDatagramAvailable;
+
+    //
+    // The datagram that is being sent
+    //
+    UINT32 TxDatagramLength;
+
+} NETWORK_CONNECTION_STATE, *PNETWORK_CONNECTION_STATE;
+
+//////////////////////////////////////////////////
+//					 Functions					//
+//////////////////////////////////////////////////
+
+NTSTATUS
+NetworkConnectionPrepare(PDEBUGGER_PREPARE_DEBUGGEE DebuggeeRequest);
+
+VOID
+NetworkConnectionUninitialize();
+
+VOID
+NetworkConnectionSendBytes(CONST BYTE * Buffer, UINT32 Length);
+
+VOID
+NetworkConnectionFlush();
+
+BOOLEAN
+NetworkConnectionRecvByte(PUCHAR RecvByte);
+
+BOOLEAN
+NetworkConnectionStartPolling();
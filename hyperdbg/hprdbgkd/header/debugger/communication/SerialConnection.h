@@ -21,12 +21,24 @@ KdHyperDbgTest(UINT16 Byte);
 VOID
 KdHyperDbgPrepareDebuggeeConnectionPort(UINT32 PortAddress, UINT32 Baudrate);
 
+VOID
+KdHyperDbgPrepareDebuggeeBulkConnectionPort(UINT32 PortAddress, UINT32 Baudrate);
+
 VOID
 KdHyperDbgSendByte(UCHAR Byte, BOOLEAN BusyWait);
 
+VOID
+KdHyperDbgSendBuffer(CONST UCHAR * Buffer, UINT32 Length);
+
+VOID
+KdHyperDbgSendBulkBuffer(CONST UCHAR * Buffer, UINT32 Length);
+
 BOOLEAN
 KdHyperDbgRecvByte(PUCHAR RecvByte);
 
+UINT32
+KdHyperDbgRecvBuffer(PUCHAR Buffer, UINT32 Length);
+
 //////////////////////////////////////////////////
 //					 Functions					//
 //////////////////////////////////////////////////
@@ -46,9 +58,53 @@ SerialConnectionCheckBaudrate(DWORD Baudrate);
 BOOLEAN
 SerialConnectionSend(CHAR * Buffer, UINT32 Length);
 
+UINT32
+SerialConnectionComputeCrc32(UINT32 Crc, CONST BYTE * Buffer, UINT32 Length);
+
+UINT32
+SerialConnectionComputeCrc32c(UINT32 Crc, CONST BYTE * Buffer, UINT32 Length);
+
+UINT32
+SerialConnectionComputeFrameChecksum(UINT16 Flags, UINT32 Crc, CONST BYTE * Buffer, UINT32 Length);
+
+UINT16
+SerialConnectionGetSendFlags();
+
+BOOLEAN
+SerialConnectionIsValidFrameHeader(PSERIAL_FRAME_HEADER Header);
+
+VOID
+SerialConnectionSendFrameHeader(BOOLEAN IsBulkLink, UINT16 Flags, UINT32 Length, UINT32 PayloadChecksum);
+
+VOID
+SerialConnectionRecvBytes(BYTE * Buffer, UINT32 Length);
+
+BOOLEAN
+SerialConnectionTryRecvByte(BYTE * Byte);
+
+UINT32
+SerialConnectionCompress(UINT16 *     HashTable,
+                         CONST BYTE * Source,
+                         UINT32       SourceLength,
+                         BYTE *       Destination,
+                         UINT32       DestinationCapacity);
+
+VOID
+SerialConnectionSendBytes(BOOLEAN IsBulkLink, CONST BYTE * Buffer, UINT32 Length);
+
+BOOLEAN
+SerialConnectionSendCompressedFrame(BOOLEAN IsBulkLink,
+                                    CHAR *  Buffer1,
+                                    UINT32  Length1,
+                                    CHAR *  Buffer2,
+                                    UINT32  Length2,
+                                    CHAR *  Buffer3,
+                                    UINT32  Length3);
+
 BOOLEAN
 SerialConnectionRecvBuffer(CHAR *   BufferToSave,
-                           UINT32 * LengthReceived);
+                           UINT32 * LengthReceived,
+                           UINT64   Deadline);
 
 BOOLEAN
 SerialConnectionSendTwoBuffers(CHAR * Buffer1, UINT32 Length1, CHAR * Buffer2, UINT32 Length2);
@@ -61,6 +117,23 @@ SerialConnectionSendThreeBuffers(CHAR * Buffer1,
                                  CHAR * Buffer3,
                                  UINT32 Length3);
 
+BOOLEAN
+SerialConnectionSendBulkThreeBuffers(CHAR * Buffer1,
+                                     UINT32 Length1,
+                                     CHAR * Buffer2,
+                                     UINT32 Length2,
+                                     CHAR * Buffer3,
+                                     UINT32 Length3);
+
+BOOLEAN
+SerialConnectionSendFrame(BOOLEAN IsBulkLink,
+                          CHAR *  Buffer1,
+                          UINT32  Length1,
+                          CHAR *  Buffer2,
+                          UINT32  Length2,
+                          CHAR *  Buffer3,
+                          UINT32  Length3);
+
 //////////////////////////////////////////////////
 //					 Constants					//
 //////////////////////////////////////////////////
@@ -82,7 +155,17 @@ SerialConnectionSendThreeBuffers(CHAR * Buffer1,
 #define CBR_57600  57600
 #define CBR_115200 115200
 #define CBR_128000 128000
+#define CBR_230400 230400
 #define CBR_256000 256000
+#define CBR_460800 460800
+#define CBR_921600 921600
+
+//
+// Compression of the buffers (LZ4 block format)
+//
+#define SERIAL_COMPRESSION_HASH_LOG         12
+#define SERIAL_COMPRESSION_MATCH_FIND_LIMIT 12
+#define SERIAL_COMPRESSION_LAST_LITERALS    5
 
 //
 // Serial ports
@@ -91,3 +174,23 @@ SerialConnectionSendThreeBuffers(CHAR * Buffer1,
 #define COM2_PORT 0x02F8
 #define COM3_PORT 0x03E8
 #define COM4_PORT 0x02E8
+
+//////////////////////////////////////////////////
+//					 Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The state of sending frames over a link to the debugger
+ * @details the control link (serial or network) and the bulk link
+ * (a second serial port) have separate locks of sending responses,
+ * so each link has its own buffers of compressing the frames
+ *
+ */
+typedef struct _SERIAL_CONNECTION_LINK
+{
+    UINT32 SendSequenceNumber;
+    UINT16 CompressionHashTable[1 << SERIAL_COMPRESSION_HASH_LOG];
+    BYTE   UncompressedBuffer[MaxSerialPacketSize];
+    BYTE   CompressedBuffer[MaxSerialPacketSize];
+
+} SERIAL_CONNECTION_LINK, *PSERIAL_CONNECTION_LINK;
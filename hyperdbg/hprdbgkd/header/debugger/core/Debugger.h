@@ -70,6 +70,7 @@ typedef struct _DEBUGGER_CORE_EVENTS
     LIST_ENTRY ExternalInterruptOccurredEventsHead;        // EXTERNAL_INTERRUPT_OCCURRED [WARNING : MAKE SURE TO INITIALIZE LIST HEAD , Add it to DebuggerRegisterEvent, Add it to DebuggerTriggerEvents, Add termination to DebuggerTerminateEvent ]
     LIST_ENTRY VmcallInstructionExecutionEventsHead;       // VMCALL_INSTRUCTION_EXECUTION [WARNING : MAKE SURE TO INITIALIZE LIST HEAD , Add it to DebuggerRegisterEvent, Add it to DebuggerTriggerEvents, Add termination to DebuggerTerminateEvent ]
     LIST_ENTRY ControlRegisterModifiedEventsHead;          // CONTROL_REGISTER_MODIFIED [WARNING : MAKE SURE TO INITIALIZE LIST HEAD , Add it to DebuggerRegisterEvent, Add it to DebuggerTriggerEvents, Add termination to DebuggerTerminateEvent ]
+    LIST_ENTRY PageFirstExecutionEventsHead;               // PAGE_FIRST_EXECUTION [WARNING : MAKE SURE TO INITIALIZE LIST HEAD , Add it to DebuggerRegisterEvent, Add it to DebuggerTriggerEvents, Add termination to DebuggerTerminateEvent ]
 
 } DEBUGGER_CORE_EVENTS, *PDEBUGGER_CORE_EVENTS;
 
@@ -79,39 +80,170 @@ typedef struct _DEBUGGER_CORE_EVENTS
  */
 typedef struct _DEBUGGER_EVENT_ACTION
 {
-    UINT64                          Tag;                       // Action tag is same as Event's tag
-    UINT32                          ActionOrderCode;           // The code for this action (it also shows the order)
-    LIST_ENTRY                      ActionsList;               // Holds the link list of next actions
-    DEBUGGER_EVENT_ACTION_TYPE_ENUM ActionType;                // What action we wanna perform
-    BOOLEAN                         ImmediatelySendTheResults; // should we send the results immediately
-                                                               // or store them in another structure and
-                                                               // send multiple of them each time
+    //
+    // The fields that are used for running the action are in the first
+    // cache line of the action (the actions are allocated at the cache
+    // line boundaries)
+    //
+    LIST_ENTRY                          ActionsList;               // Holds the link list of next actions
+    DEBUGGER_EVENT_ACTION_TYPE_ENUM     ActionType;                // What action we wanna perform
+    BOOLEAN                             ImmediatelySendTheResults; // should we send the results immediately
+                                                                   // or store them in another structure and
+                                                                   // send multiple of them each time
+    UINT32                              ActionOrderCode;           // The code for this action (it also shows the order)
+    UINT32                              CustomCodeBufferSize;      // if null, means it's not custom code type
+    UINT64                              Tag;                       // Action tag is same as Event's tag
+    struct _SCRIPT_ENGINE_BYTECODE *    ScriptBytecode;            // Pre-compiled form of the script (if it can be compiled)
+    PVOID                               CustomCodeBufferAddress;   // address of custom code if any
+    struct _SCRIPT_ENGINE_SHARED_CODE * ScriptSharedCode;          // The code of the script (shared with actions of the same script)
 
     DEBUGGER_EVENT_ACTION_RUN_SCRIPT_CONFIGURATION
     ScriptConfiguration; // If it's run script
 
+    DEBUGGER_EVENT_SCRIPT_STATISTICS ScriptStatistics; // The cost of running the script
+
     DEBUGGER_EVENT_REQUEST_BUFFER
-    RequestedBuffer;                // if it's a custom code and needs a buffer then we use
-                                    // this structs
+    RequestedBuffer;               // if it's a custom code and needs a buffer then we use
+                                   // this structs
 
-    UINT32 CustomCodeBufferSize;    // if null, means it's not custom code type
-    PVOID  CustomCodeBufferAddress; // address of custom code if any
+    UINT32 LastBranchRecordsCount; // if it's showing the last branch records
+
+    DEBUGGER_EVENT_RECORD_CONFIGURATION
+    RecordConfiguration; // if it's recording the hits
 
 } DEBUGGER_EVENT_ACTION, *PDEBUGGER_EVENT_ACTION;
 
 /* ==============================================================================================
  */
 
+/**
+ * @brief The state of coalescing the accesses of a monitor event on a core
+ *
+ */
+typedef struct _DEBUGGER_EVENT_COALESCING_STATE
+{
+    DEBUGGER_EVENT_MONITOR_ACCESS_SUMMARY Summary;         // Accesses that are not reported yet
+    UINT64                                WindowStartTime; // Interrupt time of the first access of the summary
+
+} DEBUGGER_EVENT_COALESCING_STATE, *PDEBUGGER_EVENT_COALESCING_STATE;
+
+/**
+ * @brief The state of limiting the rate of triggering an event on a core
+ * @details a token bucket that holds up to one second of triggers
+ *
+ */
+typedef struct _DEBUGGER_EVENT_RATE_LIMIT_STATE
+{
+    UINT64  Tokens;          // Triggers that are allowed before the event is disarmed
+    UINT64  LastRefillTime;  // Interrupt time of the last refill of the tokens
+    UINT64  DroppedTriggers; // Triggers that are dropped since the event is disarmed
+    BOOLEAN IsDisarmed;      // Whether the event is over its budget or not
+
+} DEBUGGER_EVENT_RATE_LIMIT_STATE, *PDEBUGGER_EVENT_RATE_LIMIT_STATE;
+
+/**
+ * @brief Maximum count of the ranges of a single monitor event
+ *
+ */
+#define DEBUGGER_EVENT_MONITOR_MAXIMUM_RANGES 0x1000
+
+/**
+ * @brief A range of a multi-range monitor event
+ *
+ */
+typedef struct _DEBUGGER_EVENT_MONITOR_RANGE
+{
+    UINT64 StartAddress; // Start of the range (virtual address)
+    UINT64 EndAddress;   // End of the range (virtual address, exclusive)
+
+} DEBUGGER_EVENT_MONITOR_RANGE, *PDEBUGGER_EVENT_MONITOR_RANGE;
+
+/**
+ * @brief The ranges of a multi-range monitor event
+ * @details the ranges are sorted by their start addresses and they don't
+ * overlap, so the range of an address is found by a binary search, the
+ * array is replaced (not modified) whenever a range is added or removed
+ *
+ */
+typedef struct _DEBUGGER_EVENT_MONITOR_RANGES
+{
+    UINT32                       CountOfRanges;
+    DEBUGGER_EVENT_MONITOR_RANGE Ranges[1];
+
+} DEBUGGER_EVENT_MONITOR_RANGES, *PDEBUGGER_EVENT_MONITOR_RANGES;
+
+/**
+ * @brief Maximum count of the slots of a single monitor event
+ *
+ */
+#define DEBUGGER_EVENT_MONITOR_MAXIMUM_SLOTS 0x1000
+
+/**
+ * @brief Maximum count of the pages of the range of a slot (the buffers
+ * of hooking the pages are reserved by this count for each slot)
+ *
+ */
+#define DEBUGGER_EVENT_MONITOR_SLOT_MAXIMUM_PAGES 2
+
+/**
+ * @brief A range of a monitor event that is added by the scripts (in vmx-root)
+ * @details the slot is free if its end address is zero
+ *
+ */
+typedef struct _DEBUGGER_EVENT_MONITOR_SLOT
+{
+    volatile UINT64 StartAddress;                                             // Start of the range (virtual address)
+    volatile UINT64 EndAddress;                                               // End of the range (virtual address, exclusive), zero if the slot is free
+    UINT64          PhysicalPages[DEBUGGER_EVENT_MONITOR_SLOT_MAXIMUM_PAGES]; // The physical addresses of the pages of the range
+    UINT32          CountOfPages;                                             // Count of the pages of the range
+    UINT32          HookedPagesMask;                                          // The pages that are hooked by this slot (the others are hooked by other ranges)
+
+} DEBUGGER_EVENT_MONITOR_SLOT, *PDEBUGGER_EVENT_MONITOR_SLOT;
+
+/**
+ * @brief The preallocated slots of a monitor event
+ * @details the slots are allocated once the event is registered, so the
+ * ranges are added and removed without any allocation in vmx-root, the
+ * slots are checked without a lock, so a slot is published once its pages
+ * are hooked and it's unpublished before its pages are unhooked
+ *
+ */
+typedef struct _DEBUGGER_EVENT_MONITOR_SLOTS
+{
+    UINT32                      CountOfSlots;     // Count of the reserved slots
+    volatile LONG               CountOfUsedSlots; // The slots after this count are never used
+    volatile LONG               Lock;             // Serializes adding and removing the ranges
+    volatile LONG               IsClosed;         // The event is being removed, so no range is added
+    DEBUGGER_EVENT_MONITOR_SLOT Slots[1];
+
+} DEBUGGER_EVENT_MONITOR_SLOTS, *PDEBUGGER_EVENT_MONITOR_SLOTS;
+
+/**
+ * @brief The hit statistics of an event on a core
+ * @details each core only updates its own counters (in its own cache
+ * line), so the counters are updated without interlocked operations
+ *
+ */
+typedef struct DECLSPEC_CACHEALIGN _DEBUGGER_EVENT_HIT_STATISTICS
+{
+    UINT64 Hits;            // Triggers that matched the event
+    UINT64 ConditionPasses; // Triggers that passed the conditions
+    UINT64 LastHitTsc;      // TSC of the last hit
+
+} DEBUGGER_EVENT_HIT_STATISTICS, *PDEBUGGER_EVENT_HIT_STATISTICS;
+
 /**
  * @brief The structure of events in HyperDbg
  *
  */
 typedef struct _DEBUGGER_EVENT
 {
-    UINT64              Tag;
-    LIST_ENTRY          EventsOfSameTypeList; // Linked-list of events of a same type
-    VMM_EVENT_TYPE_ENUM EventType;
+    //
+    // The fields that are checked on each trigger are in the first cache
+    // line of the event (the events are allocated at the cache line boundaries)
+    //
     BOOLEAN             Enabled;
+    VMM_EVENT_TYPE_ENUM EventType;
     UINT32              CoreId; // determines the core index to apply this event to, if it's
                                 // 0xffffffff means that we have to apply it to all cores
 
@@ -119,6 +251,19 @@ typedef struct _DEBUGGER_EVENT
     ProcessId;                                       // determines the pid to apply this event to, if it's
                                                      // 0xffffffff means that we have to apply it to all processes
 
+    UINT32
+    ThreadId;                                        // determines the tid to apply this event to, if it's
+                                                     // 0xffffffff means that we have to apply it to all threads
+
+    UINT32 ConditionsBufferSize;                     // if null, means uncoditional
+    UINT64 OptionalParam1;                           // Optional parameter to be used differently by events
+    UINT64 OptionalParam2;                           // Optional parameter to be used differently by events
+    PVOID  ConditionBufferAddress;                   // Address of the condition buffer (most of the
+                                                     // time at the end of this buffer)
+    UINT64 Tag;
+
+    LIST_ENTRY EventsOfSameTypeList;                 // Linked-list of events of a same type
+    LIST_ENTRY EventsOfSameIndexList;                // Linked-list of events in a same bucket of the events index
     LIST_ENTRY ActionsListHead;                      // Each entry is in DEBUGGER_EVENT_ACTION struct
     UINT32     CountOfActions;                       // The total count of actions
 
@@ -128,14 +273,50 @@ typedef struct _DEBUGGER_EVENT
     VMM_CALLBACK_EVENT_CALLING_STAGE_TYPE EventMode; // reveals the execution mode
     // of the event (whether it's a pre- or post- event)
 
-    UINT64 OptionalParam1;         // Optional parameter to be used differently by events
-    UINT64 OptionalParam2;         // Optional parameter to be used differently by events
-    UINT64 OptionalParam3;         // Optional parameter to be used differently by events
-    UINT64 OptionalParam4;         // Optional parameter to be used differently by events
+    UINT64 OptionalParam3; // Optional parameter to be used differently by events
+    UINT64 OptionalParam4; // Optional parameter to be used differently by events
 
-    UINT32 ConditionsBufferSize;   // if null, means uncoditional
-    PVOID  ConditionBufferAddress; // Address of the condition buffer (most of the
-                                   // time at the end of this buffer)
+    //
+    // Coalescing the accesses of monitor events
+    //
+    UINT64                           CoalescingAccessCount; // Count of accesses that are summarized into one trigger (0 if not limited)
+    UINT64                           CoalescingWindow;      // Time window of summarizing accesses in 100-nanosecond units (0 if not limited)
+    PDEBUGGER_EVENT_COALESCING_STATE CoalescingStates;      // Per-core state of the coalesced accesses (NULL if not coalesced)
+
+    //
+    // The ranges of monitor events that have more than one range
+    //
+    PDEBUGGER_EVENT_MONITOR_RANGES MonitorRanges; // Sorted ranges (NULL if the range is [OptionalParam3, OptionalParam4))
+    PDEBUGGER_EVENT_MONITOR_SLOTS  MonitorSlots;  // The slots of the ranges that are added by the scripts (NULL if not reserved)
+
+    //
+    // Limiting the rate of triggering the event
+    //
+    UINT64                           RateLimit;       // Maximum triggers per second on each core (0 if not limited)
+    PDEBUGGER_EVENT_RATE_LIMIT_STATE RateLimitStates; // Per-core state of the token bucket (NULL if not limited)
+
+    //
+    // The hit statistics of the event
+    //
+    PDEBUGGER_EVENT_HIT_STATISTICS HitStatistics; // Per-core counters of the hits
+
+    //
+    // The output sources of the event suppress all of its messages, so
+    // the messages are not generated
+    //
+    BOOLEAN IsOutputDisabled;
+
+    //
+    // The event holds a reference to the per-core resource of its type
+    // (EventsResourceReferences of its cores)
+    //
+    BOOLEAN IsResourceReferenced;
+
+    //
+    // The references of the event to the MSR bitmaps, I/O ports and
+    // exceptions (or its EPT hooks) are released while it's disabled
+    //
+    BOOLEAN IsControlsDisarmed;
 
 } DEBUGGER_EVENT, *PDEBUGGER_EVENT;
 
@@ -197,7 +378,7 @@ VOID
 DebuggerUninitialize();
 
 PDEBUGGER_EVENT
-DebuggerCreateEvent(BOOLEAN Enabled, UINT32 CoreId, UINT32 ProcessId, VMM_EVENT_TYPE_ENUM EventType, UINT64 Tag, UINT64 OptionalParam1, UINT64 OptionalParam2, UINT64 OptionalParam3, UINT64 OptionalParam4, UINT32 ConditionsBufferSize, PVOID ConditionBuffer);
+DebuggerCreateEvent(BOOLEAN Enabled, UINT32 CoreId, UINT32 ProcessId, UINT32 ThreadId, VMM_EVENT_TYPE_ENUM EventType, UINT64 Tag, UINT64 OptionalParam1, UINT64 OptionalParam2, UINT64 OptionalParam3, UINT64 OptionalParam4, UINT32 ConditionsBufferSize, PVOID ConditionBuffer);
 
 PDEBUGGER_EVENT_ACTION
 DebuggerAddActionToEvent(PDEBUGGER_EVENT Event, DEBUGGER_EVENT_ACTION_TYPE_ENUM ActionType, BOOLEAN SendTheResultsImmediately, PDEBUGGER_EVENT_REQUEST_CUSTOM_CODE InTheCaseOfCustomCode, PDEBUGGER_EVENT_ACTION_RUN_SCRIPT_CONFIGURATION InTheCaseOfRunScript);
@@ -227,6 +408,9 @@ DebuggerParseEventFromUsermode(PDEBUGGER_GENERAL_EVENT_DETAIL EventDetails, UINT
 BOOLEAN
 DebuggerParseActionFromUsermode(PDEBUGGER_GENERAL_ACTION Action, UINT32 BufferLength, PDEBUGGER_EVENT_AND_ACTION_REG_BUFFER ResultsToReturnUsermode);
 
+BOOLEAN
+DebuggerParseEventsBatchFromUsermode(PDEBUGGER_EVENTS_BATCH_REQUEST EventsBatchRequest, UINT32 BufferLength);
+
 BOOLEAN
 DebuggerParseEventsModificationFromUsermode(PDEBUGGER_MODIFY_EVENTS DebuggerEventModificationRequest);
 
@@ -251,8 +435,45 @@ DebuggerEventListCountByCore(PLIST_ENTRY TargetEventList, UINT32 TargetCore);
 UINT32
 DebuggerEventListCountByEventType(VMM_EVENT_TYPE_ENUM EventType, UINT32 TargetCore);
 
-UINT32
-DebuggerExceptionEventBitmapMask(UINT32 CoreIndex);
+UINT64
+DebuggerGetCoreMaskOfEvent(UINT32 CoreId);
+
+VOID
+DebuggerChangeBitmapOwnership(UINT32                         CoreId,
+                              BOOLEAN                        Acquire,
+                              BITMAP_OWNERSHIP_RESOURCE_TYPE ResourceType,
+                              UINT64                         Index,
+                              UINT64                         Mask);
+
+VOID
+DebuggerAcquireEventResource(PDEBUGGER_EVENT Event);
+
+UINT64
+DebuggerReleaseEventResource(PDEBUGGER_EVENT Event, DEBUGGER_EVENT_RESOURCE_TYPE * Resource);
+
+BOOLEAN
+DebuggerIsEventResourceReferenced(DEBUGGER_EVENT_RESOURCE_TYPE Resource);
+
+VOID
+DebuggerApplyEventsResourcesOnCore(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+VOID
+DebuggerApplyPendingEventsResources(UINT32 CoreId);
+
+BOOLEAN
+DebuggerForgetDisarmedEvent(PDEBUGGER_EVENT Event);
+
+VOID
+DebuggerDisarmEvent(PDEBUGGER_EVENT Event);
+
+BOOLEAN
+DebuggerArmEvent(PDEBUGGER_EVENT Event);
+
+BOOLEAN
+DebuggerUnhookEptHooksOfEvent(PDEBUGGER_EVENT Event);
+
+BOOLEAN
+DebuggerHookEptHooksOfEvent(PDEBUGGER_EVENT Event);
 
 BOOLEAN
 DebuggerIsTagValid(UINT64 Tag);
@@ -263,6 +484,36 @@ DebuggerEnableEvent(UINT64 Tag);
 BOOLEAN
 DebuggerQueryStateEvent(UINT64 Tag);
 
+BOOLEAN
+DebuggerQueryScriptStatisticsOfEvent(UINT64 Tag, PDEBUGGER_EVENT_SCRIPT_STATISTICS Statistics);
+
+VOID
+DebuggerQueryEventsStatistics(PDEBUGGER_QUERY_EVENTS_STATISTICS StatisticsRequest);
+
+BOOLEAN
+DebuggerSetEventOutputState(UINT64 Tag, BOOLEAN IsOutputEnabled);
+
+BOOLEAN
+DebuggerIsAddressInMonitorRanges(PDEBUGGER_EVENT_MONITOR_RANGES MonitorRanges, UINT64 Address);
+
+UINT32
+DebuggerAddMonitorRangeToEvent(UINT64 Tag, UINT64 StartAddress, UINT64 EndAddress);
+
+UINT32
+DebuggerRemoveMonitorRangeFromEvent(UINT64 Tag, UINT64 StartAddress, UINT64 EndAddress);
+
+BOOLEAN
+DebuggerIsAddressInMonitorSlots(PDEBUGGER_EVENT_MONITOR_SLOTS MonitorSlots, UINT64 Address);
+
+BOOLEAN
+DebuggerAddMonitorSlotRange(UINT64 Tag, UINT64 StartAddress, UINT64 EndAddress);
+
+BOOLEAN
+DebuggerRemoveMonitorSlotRange(UINT64 Tag, UINT64 StartAddress, UINT64 EndAddress);
+
+VOID
+DebuggerCloseMonitorSlotsOfEvent(PDEBUGGER_EVENT Event);
+
 BOOLEAN
 DebuggerDisableEvent(UINT64 Tag);
 
@@ -273,10 +524,18 @@ VOID
 DebuggerPerformBreakToDebugger(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 Tag, PDEBUGGER_EVENT_ACTION Action, PVOID Context);
 
 BOOLEAN
-DebuggerPerformRunScript(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 Tag, PDEBUGGER_EVENT_ACTION Action, PDEBUGGEE_SCRIPT_PACKET ScriptDetails, PVOID Context);
+DebuggerPerformRunScript(PROCESSOR_DEBUGGING_STATE * DbgState,
+                         UINT64                      Tag,
+                         PDEBUGGER_EVENT_ACTION      Action,
+                         PDEBUGGEE_SCRIPT_PACKET     ScriptDetails,
+                         BOOLEAN                     IsOutputDisabled,
+                         PVOID                       Context);
 
 VOID
 DebuggerPerformRunTheCustomCode(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 Tag, PDEBUGGER_EVENT_ACTION Action, PVOID Context);
 
+VOID
+DebuggerPerformShowLastBranchRecords(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 Tag, PDEBUGGER_EVENT_ACTION Action, PVOID Context);
+
 PLIST_ENTRY
 DebuggerGetEventListByEventType(VMM_EVENT_TYPE_ENUM EventType);
@@ -0,0 +1,102 @@
+/**
+ * @file DebuggerArmedEvents.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the per-core snapshot of armed (enabled) events
+ * @details
+ * @version 0.4
+ * @date 2023-07-09
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum number of armed events that can be kept in the
+ * snapshot of each core
+ * @details if there are more armed events, the dispatcher falls back
+ * to the lookup index of events
+ *
+ */
+#define DEBUGGER_ARMED_EVENTS_MAXIMUM_ENTRIES 512
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A compact descriptor of an armed event
+ * @details it holds a copy of the fields that are needed for rejecting
+ * an event, so the event object itself is only touched if it's matched
+ *
+ */
+typedef struct _DEBUGGER_ARMED_EVENT
+{
+    PDEBUGGER_EVENT Event;      // The event object
+    UINT64          Key;        // The discriminator of the event (if not wildcard)
+    UINT32          ProcessId;  // Process that this event is applied to
+    UINT32          ThreadId;   // Thread that this event is applied to
+    BOOLEAN         IsWildcard; // Whether the event is matched with any discriminator
+
+} DEBUGGER_ARMED_EVENT, *PDEBUGGER_ARMED_EVENT;
+
+/**
+ * @brief Snapshot of armed events of a single core
+ * @details each core only reads its own snapshot, the snapshot is not
+ * changed while the core is dispatching events and it's rebuilt by the
+ * owner core once a new generation of events is published
+ *
+ */
+typedef struct _DEBUGGER_ARMED_EVENTS_SNAPSHOT
+{
+    volatile LONG   DispatchDepth; // Whether the owner core is dispatching events or not
+    volatile LONG64 Generation;    // The generation of events that this snapshot is built from
+    BOOLEAN         Overflowed;    // The snapshot is not usable as there are too many armed events
+    UINT32          EntriesCount;
+
+    //
+    // Entries of each type are in [TypeStart[Type], TypeStart[Type + 1]), keyed
+    // entries (sorted by key) are in [TypeStart[Type], WildcardStart[Type]) and
+    // the wildcard entries are in [WildcardStart[Type], TypeStart[Type + 1])
+    //
+    UINT32 TypeStart[DEBUGGER_EVENTS_INDEX_EVENT_TYPES_COUNT + 1];
+    UINT32 WildcardStart[DEBUGGER_EVENTS_INDEX_EVENT_TYPES_COUNT];
+
+    DEBUGGER_ARMED_EVENT Entries[DEBUGGER_ARMED_EVENTS_MAXIMUM_ENTRIES];
+
+} DEBUGGER_ARMED_EVENTS_SNAPSHOT, *PDEBUGGER_ARMED_EVENTS_SNAPSHOT;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+DebuggerArmedEventsInitialize(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+VOID
+DebuggerArmedEventsUninitialize(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+VOID
+DebuggerArmedEventsInvalidate();
+
+VOID
+DebuggerArmedEventsSynchronize();
+
+PDEBUGGER_ARMED_EVENTS_SNAPSHOT
+DebuggerArmedEventsEnterDispatch(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+VOID
+DebuggerArmedEventsExitDispatch(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+BOOLEAN
+DebuggerArmedEventsGetCandidates(PDEBUGGER_ARMED_EVENTS_SNAPSHOT Snapshot,
+                                 VMM_EVENT_TYPE_ENUM             EventType,
+                                 PVOID                           Context,
+                                 UINT32 *                        KeyedStart,
+                                 UINT32 *                        KeyedEnd,
+                                 UINT32 *                        WildcardStart,
+                                 UINT32 *                        WildcardEnd);
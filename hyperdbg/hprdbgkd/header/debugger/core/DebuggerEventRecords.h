@@ -0,0 +1,58 @@
+/**
+ * @file DebuggerEventRecords.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the per-core records of the hits of events
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Count of the records of the buffer of each core (power of two)
+ *
+ */
+#define DEBUGGER_EVENT_RECORDS_BUFFER_CAPACITY 1024
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The ring buffer of the records of a single core
+ * @details the records are only written by the core itself and read by
+ * the queries of the user mode, the structures are aligned to the cache
+ * line so the cores don't share cache lines
+ *
+ */
+typedef struct DECLSPEC_CACHEALIGN _DEBUGGER_EVENT_RECORDS_BUFFER
+{
+    volatile LONG64           WriteIndex;
+    volatile LONG64           ReadIndex;
+    volatile LONG64           DroppedRecords;
+    DEBUGGER_EVENT_HIT_RECORD Records[DEBUGGER_EVENT_RECORDS_BUFFER_CAPACITY];
+
+} DEBUGGER_EVENT_RECORDS_BUFFER, *PDEBUGGER_EVENT_RECORDS_BUFFER;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+DebuggerEventRecordsInitialize();
+
+VOID
+DebuggerEventRecordsUninitialize();
+
+VOID
+DebuggerEventRecordsRecordHit(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 Tag, PDEBUGGER_EVENT_ACTION Action);
+
+VOID
+DebuggerEventRecordsQuery(PDEBUGGER_QUERY_EVENT_RECORDS RecordsRequest);
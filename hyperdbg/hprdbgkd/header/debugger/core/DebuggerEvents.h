@@ -11,6 +11,16 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//				     Constants		      		//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Size of the large pages that are monitored without splitting (2MB)
+ *
+ */
+#define DEBUGGER_EVENT_MONITOR_LARGE_PAGE_SIZE (512 * PAGE_SIZE)
+
 //////////////////////////////////////////////////
 //				     Functions		      		//
 //////////////////////////////////////////////////
@@ -21,6 +31,15 @@ DebuggerEventEnableEferOnAllProcessors(DEBUGGER_EVENT_SYSCALL_SYSRET_TYPE Syscal
 VOID
 DebuggerEventDisableEferOnAllProcessors();
 
+VOID
+DebuggerEventDisableEferOnCores(UINT64 CoreMask);
+
+VOID
+DebuggerEventUpdateSyscallFilter(UINT64 TerminatedEventTag);
+
+VOID
+DebuggerEventUpdateCpuidFilter(UINT64 TerminatedEventTag);
+
 VOID
 DebuggerEventEnableMovToCr3ExitingOnAllProcessors();
 
@@ -32,7 +51,8 @@ DebuggerEventEnableMonitorReadWriteExec(UINT64  Address,
                                         UINT32  ProcessId,
                                         BOOLEAN EnableForRead,
                                         BOOLEAN EnableForWrite,
-                                        BOOLEAN EnableForExecute);
+                                        BOOLEAN EnableForExecute,
+                                        BOOLEAN ApplyOnLargePage);
 
 BOOLEAN
 DebuggerCheckProcessOrThreadChange(_In_ UINT32 CoreId);
@@ -0,0 +1,93 @@
+/**
+ * @file DebuggerEventsIndex.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the lookup index of debugger events
+ * @details
+ * @version 0.4
+ * @date 2023-07-08
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Number of buckets for each event type in the index
+ * @details should be a power of two
+ *
+ */
+#define DEBUGGER_EVENTS_INDEX_BUCKETS_COUNT 64
+
+/**
+ * @brief Number of event types that are indexed
+ *
+ */
+#define DEBUGGER_EVENTS_INDEX_EVENT_TYPES_COUNT (PAGE_FIRST_EXECUTION + 1)
+
+/**
+ * @brief Number of candidate lists that are checked for each triggered event
+ * @details the bucket of the discriminator and the wildcard list
+ *
+ */
+#define DEBUGGER_EVENTS_INDEX_CANDIDATE_LISTS_COUNT 2
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The index of events of a same type
+ * @details Events are put into a bucket based on their discriminator
+ * (MSR number, I/O port, exception vector, syscall number, physical page,
+ * etc.), if an event doesn't have a discriminator (e.g., it's applied to
+ * all the MSRs) then it's put into the wildcard list
+ *
+ */
+typedef struct _DEBUGGER_EVENTS_INDEX_TABLE
+{
+    LIST_ENTRY WildcardEventsHead;                               // Events that are matched with any discriminator
+    LIST_ENTRY BucketsHead[DEBUGGER_EVENTS_INDEX_BUCKETS_COUNT]; // Events that are matched with a specific discriminator
+
+} DEBUGGER_EVENTS_INDEX_TABLE, *PDEBUGGER_EVENTS_INDEX_TABLE;
+
+/**
+ * @brief The index of all the events
+ *
+ */
+typedef struct _DEBUGGER_EVENTS_INDEX
+{
+    DEBUGGER_EVENTS_INDEX_TABLE Tables[DEBUGGER_EVENTS_INDEX_EVENT_TYPES_COUNT];
+
+} DEBUGGER_EVENTS_INDEX, *PDEBUGGER_EVENTS_INDEX;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+VOID
+DebuggerEventsIndexInitialize();
+
+VOID
+DebuggerEventsIndexInsertEvent(PDEBUGGER_EVENT Event);
+
+VOID
+DebuggerEventsIndexRemoveEvent(PDEBUGGER_EVENT Event);
+
+VOID
+DebuggerEventsIndexUpdateEvent(PDEBUGGER_EVENT Event);
+
+BOOLEAN
+DebuggerEventsIndexGetEventKey(PDEBUGGER_EVENT Event, UINT64 * Key);
+
+BOOLEAN
+DebuggerEventsIndexGetContextKey(VMM_EVENT_TYPE_ENUM EventType, PVOID Context, UINT64 * Key);
+
+BOOLEAN
+DebuggerEventsIndexGetCandidateLists(VMM_EVENT_TYPE_ENUM EventType,
+                                     PVOID               Context,
+                                     PLIST_ENTRY *       BucketListHead,
+                                     PLIST_ENTRY *       WildcardListHead);
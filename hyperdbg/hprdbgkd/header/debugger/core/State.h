@@ -11,6 +11,48 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//				    Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Count of the modules that are cached on each core for unwinding
+ * the stack
+ *
+ */
+#define CALLSTACK_MODULES_CACHE_ENTRIES 16
+
+/**
+ * @brief Count of the controls of the events (MSR bitmaps, I/O ports and
+ * exceptions) that are changed in vmx-root and are kept until all of the
+ * cores apply them
+ *
+ */
+#define DEBUGGER_EVENTS_PENDING_CONTROLS_COUNT 128
+
+//////////////////////////////////////////////////
+//				    Enums						//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The per-core resources (VMCS controls) that are shared by the
+ * events and reference counted on each core
+ * @details the resources of the bitmap ownership (exceptions, MSRs, I/O
+ * ports, mov to debug and control registers) are reference counted in the
+ * hypervisor
+ *
+ */
+typedef enum _DEBUGGER_EVENT_RESOURCE_TYPE
+{
+    DEBUGGER_EVENT_RESOURCE_EXTERNAL_INTERRUPT_EXITING, // !interrupt (not the IDT entry hooks)
+    DEBUGGER_EVENT_RESOURCE_RDTSC_EXITING,              // !tsc
+    DEBUGGER_EVENT_RESOURCE_RDPMC_EXITING,              // !pmc
+    DEBUGGER_EVENT_RESOURCE_EFER_SYSCALL_HOOK,          // !syscall and !sysret (not the LSTAR hook)
+
+    DEBUGGER_EVENT_RESOURCE_COUNT
+
+} DEBUGGER_EVENT_RESOURCE_TYPE;
+
 //////////////////////////////////////////////////
 //				    Structures					//
 //////////////////////////////////////////////////
@@ -61,6 +103,7 @@ typedef struct _DEBUGGEE_PROCESS_OR_THREAD_TRACING_DETAILS
     //
     BOOLEAN IsWatingForMovCr3VmExits;
     BOOLEAN InterceptClockInterruptsForProcessChange;
+    UINT64  Cr3VmexitFilterCr3; // only the mov-to-cr3s of this cr3 are handled by the full path (null if the filter is bypassed)
 
 } DEBUGGEE_PROCESS_OR_THREAD_TRACING_DETAILS, *PDEBUGGEE_PROCESS_OR_THREAD_TRACING_DETAILS;
 
@@ -70,21 +113,101 @@ typedef struct _DEBUGGEE_PROCESS_OR_THREAD_TRACING_DETAILS
  */
 typedef struct _DEBUGGEE_BP_DESCRIPTOR
 {
-    UINT64     BreakpointId;
-    LIST_ENTRY BreakpointsList;
-    BOOLEAN    Enabled;
-    UINT64     Address;
-    UINT64     PhysAddress;
-    UINT32     Pid;
-    UINT32     Tid;
-    UINT32     Core;
-    UINT16     InstructionLength;
-    BYTE       PreviousByte;
-    BOOLEAN    SetRflagsIFBitOnMtf;
-    BOOLEAN    AvoidReApplyBreakpoint;
+    UINT64          BreakpointId;
+    LIST_ENTRY      BreakpointsList;
+    LIST_ENTRY      BreakpointsIndexList; // Link of the bucket of the physical address in g_BreakpointsIndex
+    BOOLEAN         Enabled;
+    UINT64          Address;
+    UINT64          PhysAddress;
+    UINT32          Pid;
+    UINT32          Tid;
+    UINT32          Core;
+    UINT16          InstructionLength;
+    BYTE            PreviousByte;
+    BOOLEAN         SetRflagsIFBitOnMtf;
+    BOOLEAN         AvoidReApplyBreakpoint;
+    volatile LONG64 HitCount;
+    UINT32          ConditionBufferSize;
+    UINT32          ConditionBufferPointer;
+    BYTE            ConditionBuffer[MAXIMUM_BREAKPOINT_CONDITION_BUFFER_SIZE];
 
 } DEBUGGEE_BP_DESCRIPTOR, *PDEBUGGEE_BP_DESCRIPTOR;
 
+/**
+ * @brief A module that is cached for unwinding the stack
+ *
+ */
+typedef struct _CALLSTACK_MODULE_ENTRY
+{
+    UINT64 Cr3;              // Cr3 of the process of the module (null for the kernel modules)
+    UINT64 ImageBase;        // Null if the entry is not used
+    UINT32 SizeOfImage;      // Size of the image in the memory
+    UINT32 FunctionTableRva; // Rva of the table of functions (the exception directory)
+    UINT32 CountOfFunctions; // Count of the entries of the table of functions
+    UINT32 ValidatedWalk;    // The last walk that checked the image is still there
+
+} CALLSTACK_MODULE_ENTRY, *PCALLSTACK_MODULE_ENTRY;
+
+/**
+ * @brief The modules that are cached on each core for unwinding the stack
+ *
+ */
+typedef struct _CALLSTACK_MODULES_CACHE
+{
+    CALLSTACK_MODULE_ENTRY Entries[CALLSTACK_MODULES_CACHE_ENTRIES];
+    UINT32                 NextEntry;   // The entry that is replaced by the next module (round-robin)
+    UINT32                 CurrentWalk; // Incremented on each walk of the stack
+
+} CALLSTACK_MODULES_CACHE, *PCALLSTACK_MODULES_CACHE;
+
+/**
+ * @brief The references of the events to the per-core resources
+ * @details the resource is only cleared on the core once no event
+ * references it anymore, the resources that are changed in vmx-root are
+ * pending until the core applies them (on its next vm-exit)
+ *
+ */
+typedef struct _DEBUGGER_EVENTS_RESOURCES
+{
+    volatile LONG References[DEBUGGER_EVENT_RESOURCE_COUNT]; // Indexed by DEBUGGER_EVENT_RESOURCE_TYPE
+    volatile LONG PendingResources;                          // Bits of the resources (1 << DEBUGGER_EVENT_RESOURCE_TYPE) to apply on this core
+    volatile LONG AppliedControls;                           // Sequence of the pending controls of the events that are applied on this core
+
+} DEBUGGER_EVENTS_RESOURCES, *PDEBUGGER_EVENTS_RESOURCES;
+
+/**
+ * @brief A control of an event (MSR bitmap, I/O port or exception) that
+ * is released or referenced again in vmx-root
+ *
+ */
+typedef struct _DEBUGGER_EVENT_PENDING_CONTROL
+{
+    UINT32                         CoreId;       // The core of the event (or DEBUGGER_EVENT_APPLY_TO_ALL_CORES)
+    BOOLEAN                        Acquire;      // Whether to add or release the reference
+    BOOLEAN                        IsMsrBitmap;  // The MSR bitmap or the bitmap ownership
+    BOOLEAN                        IsWrite;      // The bitmap of wrmsr (only for the MSR bitmap)
+    BITMAP_OWNERSHIP_RESOURCE_TYPE ResourceType; // Type of the resource (only for the bitmap ownership)
+    UINT64                         Index;        // The MSR, the port or the vector
+
+} DEBUGGER_EVENT_PENDING_CONTROL, *PDEBUGGER_EVENT_PENDING_CONTROL;
+
+/**
+ * @brief The controls of the events that are changed in vmx-root
+ * @details each core applies the controls of its events on its next
+ * vm-exit (the bitmaps of a core are only changed on the core itself),
+ * a control is kept until the slowest core applies it and a slot is
+ * reserved for each disarmed event, so arming an event never fails
+ *
+ */
+typedef struct _DEBUGGER_EVENTS_PENDING_CONTROLS
+{
+    volatile LONG                  Lock;                                            // Lock of queuing the controls (only held in vmx-root)
+    volatile LONG                  Sequence;                                        // Count of the controls that are queued
+    volatile LONG                  CountOfDisarmedEvents;                           // The slots that are reserved for arming the events
+    DEBUGGER_EVENT_PENDING_CONTROL Controls[DEBUGGER_EVENTS_PENDING_CONTROLS_COUNT]; // Indexed by the sequence (modulo the count)
+
+} DEBUGGER_EVENTS_PENDING_CONTROLS, *PDEBUGGER_EVENTS_PENDING_CONTROLS;
+
 /**
  * @brief The status of NMI in the kernel debugger
  *
@@ -99,10 +222,11 @@ typedef struct _KD_NMI_STATE
 /**
  * @brief Saves the debugger state
  * @details Each logical processor contains one of this structure which describes about the
- * state of debuggers, flags, etc.
+ * state of debuggers, flags, etc. (aligned to the cache line so the cores don't share cache
+ * lines in g_DbgState)
  *
  */
-typedef struct _PROCESSOR_DEBUGGING_STATE
+typedef struct DECLSPEC_CACHEALIGN _PROCESSOR_DEBUGGING_STATE
 {
     volatile LONG                              Lock;
     volatile BOOLEAN                           MainDebuggingCore;
@@ -123,7 +247,23 @@ typedef struct _PROCESSOR_DEBUGGING_STATE
     UINT64                                     HardwareDebugRegisterForStepping;
     UINT64 *                                   ScriptEngineCoreSpecificLocalVariable;
     UINT64 *                                   ScriptEngineCoreSpecificTempVariable;
+    struct _DEBUGGER_ARMED_EVENTS_SNAPSHOT *   ArmedEventsSnapshot;               // Snapshot of armed events of this core
+    struct _SCRIPT_ENGINE_AGGREGATION_TABLE *  ScriptEngineAggregationTable;      // Aggregation maps of scripts on this core
+    UINT64                                     ScriptEngineWritesWindowStart;     // Start of the window of counting ScriptEngineCrossCoreWrites
+    UINT32                                     ScriptEngineCrossCoreWrites;       // Writes to global variables of scripts that were last written by other cores
+    BYTE *                                     ScriptEngineScratchArena;          // Scratch memory of scripts on this core
+    UINT32                                     ScriptEngineScratchUsed;           // Allocated bytes of the scratch memory of scripts
+    CHAR *                                     ScriptEngineOutputBuffer;          // Staged messages of the current script on this core
+    UINT32                                     ScriptEngineOutputLength;          // Length of the staged messages (without the null character)
+    UINT64                                     ScriptEngineOutputTag;             // Tag of the staged messages
+    BOOLEAN                                    ScriptEngineOutputImmediate;       // Whether the staged messages are sent immediately
+    BOOLEAN                                    ScriptEngineOutputIsStaging;       // Whether the messages of scripts are staged
     PKDPC                                      KdDpcObject;                       // DPC object to be used in kernel debugger
+    DEBUGGEE_REGISTERS_CONTEXT                 LastSentRegisters;                 // The registers that are last sent to the debugger
+    UINT32                                     LastSentRegistersContextId;        // Id of the registers that are last sent to the debugger
+    CALLSTACK_MODULES_CACHE                    CallstackModulesCache;             // Modules that are used for unwinding the stack on this core
+    DEBUGGER_EVENTS_RESOURCES                  EventsResources;                   // Count of the events that use each resource on this core
+    BOOLEAN                                    InvalidateEptOnContinue;           // Whether the EPT entries are changed while this core is halted
     CHAR                                       KdRecvBuffer[MaxSerialPacketSize]; // Used for debugging buffers (receiving buffers from serial devices)
 
 } PROCESSOR_DEBUGGING_STATE, PPROCESSOR_DEBUGGING_STATE;
@@ -12,10 +12,35 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The clears of the per-core resources that are deferred while
+ * a lot of events are terminated together
+ *
+ */
+typedef struct _TERMINATE_DEFERRED_CLEARS
+{
+    BOOLEAN IsDeferring;
+    UINT64  CoreMasks[DEBUGGER_EVENT_RESOURCE_COUNT]; // The cores to clear each resource on them
+
+} TERMINATE_DEFERRED_CLEARS, *PTERMINATE_DEFERRED_CLEARS;
+
 //////////////////////////////////////////////////
 //					Functions					//
 //////////////////////////////////////////////////
 
+VOID
+TerminateStartDeferringClears();
+
+VOID
+TerminateFlushDeferredClears();
+
+VOID
+TerminateClearResourceOnCores(DEBUGGER_EVENT_RESOURCE_TYPE Resource, UINT64 CoreMask);
+
 VOID
 TerminateExternalInterruptEvent(PDEBUGGER_EVENT Event);
 
@@ -49,6 +74,9 @@ TerminateSyscallHookEferEvent(PDEBUGGER_EVENT Event);
 VOID
 TerminateSysretHookEferEvent(PDEBUGGER_EVENT Event);
 
+VOID
+TerminatePageFirstExecutionEvent(PDEBUGGER_EVENT Event);
+
 VOID
 TerminateVmcallExecutionEvent(PDEBUGGER_EVENT Event);
 
@@ -21,12 +21,38 @@
  */
 volatile LONG DebuggerResponseLock;
 
+/**
+ * @brief Vmx-root lock for sending bulk responses of debugger over
+ * the bulk link
+ *
+ */
+volatile LONG DebuggerBulkResponseLock;
+
 /**
  * @brief Vmx-root lock for handling breaks to debugger
  *
  */
 volatile LONG DebuggerHandleBreakpointLock;
 
+/**
+ * @brief Number of interactive senders that are waiting for (or holding)
+ * the lock of sending response of debugger, bulk messages of events are
+ * not sent while it's not zero
+ *
+ */
+volatile LONG DebuggerInteractiveResponsesPending;
+
+//////////////////////////////////////////////////
+//				      Constants    				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The interval (in microseconds) that the frequency of the
+ * time-stamp counter is measured in, for the watchdog of the halts
+ *
+ */
+#define KD_HALT_WATCHDOG_MEASUREMENT_INTERVAL 10000
+
 //////////////////////////////////////////////////
 //				      Structures    			//
 //////////////////////////////////////////////////
@@ -39,6 +65,7 @@ typedef struct _DEBUGGEE_REQUEST_TO_CHANGE_PROCESS
 {
     UINT32 ProcessId;
     UINT64 Process;
+    UINT64 Cr3; // the kernel cr3 of the process (only if the process object is specified)
 
 } DEBUGGEE_REQUEST_TO_CHANGE_PROCESS, *PDEBUGGEE_REQUEST_TO_CHANGE_PROCESS;
 
@@ -77,6 +104,67 @@ typedef struct _HARDWARE_DEBUG_REGISTER_DETAILS
 
 } HARDWARE_DEBUG_REGISTER_DETAILS, *PHARDWARE_DEBUG_REGISTER_DETAILS;
 
+/**
+ * @brief State of tracing multiple steps in the debuggee
+ *
+ */
+typedef struct _KD_STEP_TRACE_STATE
+{
+    BOOLEAN                          IsActive;
+    DEBUGGER_REMOTE_STEPPING_REQUEST StepType;
+    UINT32                           CoreId;           // The core that performs the steps
+    UINT32                           RemainingSteps;   // Count of steps that are not recorded yet
+    UINT32                           RecordedRegister; // REGS_ENUM or DEBUGGEE_STEP_TRACE_NO_REGISTER
+    UINT32                           EntrySize;        // Size of each entry in the chunks
+    UINT32                           ChunkLength;      // Length of the current chunk (including its header)
+    UINT32                           SequenceNumber;   // Sequence number of the current chunk
+
+} KD_STEP_TRACE_STATE, *PKD_STEP_TRACE_STATE;
+
+/**
+ * @brief State of running a count of instructions in the debuggee
+ *
+ */
+typedef struct _KD_INSTRUCTION_BUDGET_STATE
+{
+    BOOLEAN IsActive;
+    BOOLEAN IsFinished;                 // Whether all of the instructions are executed or not
+    UINT32  CoreId;                     // The core that runs the instructions
+    UINT64  CountOfInstructions;        // Count of the instructions to run
+    UINT64  CountOfCountedInstructions; // The instructions that are counted by the performance counter
+    UINT64  CountOfSteppedInstructions; // The instructions that are stepped one by one
+    UINT64  RemainingSteps;             // Count of the instructions that are not stepped yet (zero while counting)
+
+} KD_INSTRUCTION_BUDGET_STATE, *PKD_INSTRUCTION_BUDGET_STATE;
+
+/**
+ * @brief State of the watchdog that continues the halted debuggee if
+ * there is no command from the debugger
+ *
+ */
+typedef struct _KD_HALT_WATCHDOG_STATE
+{
+    UINT32 Timeout;           // Milliseconds without any command before continuing (zero if disabled)
+    UINT64 TscPerMillisecond; // Frequency of the time-stamp counter
+    UINT64 CountOfTimeouts;   // Count of the halts that are continued by the watchdog
+    UINT64 LastTimeoutTsc;    // Time-stamp of the last timeout
+
+} KD_HALT_WATCHDOG_STATE, *PKD_HALT_WATCHDOG_STATE;
+
+/**
+ * @brief Epochs of halting and continuing the debuggee
+ * @details the halted cores wait for the continue epoch to change, so all
+ * of them are continued by a single store (each epoch is on its own cache
+ * line as the halted cores spin on it)
+ *
+ */
+typedef struct _KD_HALT_EPOCHS
+{
+    DECLSPEC_CACHEALIGN volatile LONG64 BreakEpoch;    // The continue epoch at the time of the last break
+    DECLSPEC_CACHEALIGN volatile LONG64 ContinueEpoch; // Incremented once all the cores are continued
+
+} KD_HALT_EPOCHS, *PKD_HALT_EPOCHS;
+
 //////////////////////////////////////////////////
 //				   Functions 	    			//
 //////////////////////////////////////////////////
@@ -88,6 +176,9 @@ typedef struct _HARDWARE_DEBUG_REGISTER_DETAILS
 static VOID
 KdCustomDebuggerBreakSpinlockLock(PROCESSOR_DEBUGGING_STATE * DbgState, volatile LONG * Lock);
 
+static VOID
+KdHaltedCoreWaitForLock(PROCESSOR_DEBUGGING_STATE * DbgState);
+
 static VOID
 KdDummyDPC(PKDPC Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2);
 
@@ -114,11 +205,15 @@ KdContinueDebuggeeJustCurrentCore(PROCESSOR_DEBUGGING_STATE * DbgState);
 
 static BOOLEAN
 KdReadRegisters(_In_ PROCESSOR_DEBUGGING_STATE *            DbgState,
-                _Inout_ PDEBUGGEE_REGISTER_READ_DESCRIPTION ReadRegisterRequest);
+                _Inout_ PDEBUGGEE_REGISTER_READ_DESCRIPTION ReadRegisterRequest,
+                _Out_ UINT32 *                              ResultLength);
 static BOOLEAN
 KdReadMemory(_In_ PGUEST_REGS                            Regs,
              _Inout_ PDEBUGGEE_REGISTER_READ_DESCRIPTION ReadRegisterRequest);
 
+static VOID
+KdReadMemoryAndSendChunks(_Inout_ PDEBUGGER_READ_MEMORY ReadMemoryRequest);
+
 static BOOLEAN
 KdSwitchCore(PROCESSOR_DEBUGGING_STATE * DbgState, UINT32 NewCore);
 
@@ -128,6 +223,9 @@ KdCloseConnectionAndUnloadDebuggee();
 static VOID
 KdReloadSymbolDetailsInDebuggee(_In_ PDEBUGGEE_SYMBOL_REQUEST_PACKET SymPacket);
 
+static VOID
+KdLoadImageNotifyRoutine(PUNICODE_STRING FullImageName, HANDLE ProcessId, PIMAGE_INFO ImageInfo);
+
 static VOID
 KdNotifyDebuggeeForUserInput(DEBUGGEE_USER_INPUT_PACKET * Descriptor, UINT32 Len);
 
@@ -140,18 +238,62 @@ KdRegularStepInInstruction(PROCESSOR_DEBUGGING_STATE * DbgState);
 static VOID
 KdRegularStepOver(PROCESSOR_DEBUGGING_STATE * DbgState, BOOLEAN IsNextInstructionACall, UINT32 CallLength);
 
+static VOID
+KdStepTraceSendChunk(UINT32 KernelStatus, BOOLEAN IsLastChunk);
+
+static VOID
+KdStepTraceStepInstruction(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+static BOOLEAN
+KdStepTraceStart(PROCESSOR_DEBUGGING_STATE * DbgState, PDEBUGGEE_STEP_TRACE_PACKET StepTracePacket);
+
+static BOOLEAN
+KdStepTraceRecordAndStepAgain(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+static VOID
+KdInstructionBudgetSendResult(UINT32 KernelStatus);
+
+static BOOLEAN
+KdInstructionBudgetStart(PROCESSOR_DEBUGGING_STATE * DbgState, PDEBUGGEE_INSTRUCTION_BUDGET_PACKET BudgetPacket);
+
+static BOOLEAN
+KdInstructionBudgetStepAgain(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+static VOID
+KdHaltWatchdogMeasureTscFrequency();
+
+static UINT64
+KdHaltWatchdogGetDeadline();
+
+static VOID
+KdHaltWatchdogPerformRequest(PDEBUGGER_HALT_WATCHDOG_REQUEST HaltWatchdogRequest);
+
+static VOID
+KdHaltWatchdogContinueDebuggee(PROCESSOR_DEBUGGING_STATE * DbgState);
+
 static VOID
 KdPerformRegisterEvent(PDEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET EventDetailHeader);
 
 static VOID
 KdPerformAddActionToEvent(PDEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET ActionDetailHeader);
 
+static VOID
+KdPerformRegisterEventsBatch(PDEBUGGER_EVENTS_BATCH_REQUEST EventsBatchRequest);
+
 static VOID
 KdQuerySystemState();
 
 static VOID
 KdPerformEventQueryAndModification(PDEBUGGER_MODIFY_EVENTS ModifyAndQueryEvent);
 
+static VOID
+KdPerformBatchRequests(PROCESSOR_DEBUGGING_STATE *     DbgState,
+                       PDEBUGGEE_BATCH_REQUESTS_PACKET BatchPacket,
+                       UINT32                          BatchLength);
+
+static VOID
+KdPerformTransportTest(PDEBUGGEE_TRANSPORT_TEST_PACKET TransportTestPacket, UINT32 PacketLength);
+
 static VOID
 KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState);
 
@@ -201,6 +343,9 @@ KdHandleBreakpointAndDebugBreakpoints(_Inout_ PROCESSOR_DEBUGGING_STATE * DbgSta
 VOID
 KdHandleRegisteredMtfCallback(_In_ UINT32 CoreId);
 
+VOID
+KdHandleInstructionCounterOverflow(_In_ UINT32 CoreId, _In_ UINT64 CountOfExecutedInstructions);
+
 VOID
 KdHandleHaltsWhenNmiReceivedFromVmxRoot(_Inout_ PROCESSOR_DEBUGGING_STATE * DbgState);
 
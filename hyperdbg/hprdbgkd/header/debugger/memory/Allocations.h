@@ -24,5 +24,11 @@ GlobalEventsAllocateZeroedMemory(VOID);
 VOID
     GlobalEventsFreeMemory(VOID);
 
+BOOLEAN
+GlobalEventsIndexAllocateZeroedMemory(VOID);
+
+VOID
+    GlobalEventsIndexFreeMemory(VOID);
+
 VOID
     GlobalDebuggingStateFreeMemory(VOID);
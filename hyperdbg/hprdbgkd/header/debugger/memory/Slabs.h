@@ -0,0 +1,92 @@
+/**
+ * @file Slabs.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the slab caches of the objects of the debugger
+ * (events and actions)
+ * @details
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The alignment of the objects of the slabs
+ *
+ */
+#define SLAB_CACHE_OBJECT_ALIGNMENT 64
+
+/**
+ * @brief The extra bytes of each object for the buffer that is appended
+ * to the object (e.g., the condition of an event or the custom code of
+ * an action), the larger objects are allocated from the pool
+ *
+ */
+#define SLAB_CACHE_INLINE_BUFFER_SIZE 192
+
+//////////////////////////////////////////////////
+//				   Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The header of a slab (a page of objects of the same size)
+ * @details the header is at the start of the page and the objects are
+ * after it, so the slab of an object is the page of the object
+ *
+ */
+typedef struct _SLAB_CACHE_SLAB
+{
+    LIST_ENTRY        SlabsList;          // Link in the list of the partial (or full) slabs of the cache
+    SINGLE_LIST_ENTRY FreeObjects;        // The objects of the slab that are not allocated
+    UINT32            CountOfBusyObjects; // The objects of the slab that are allocated
+
+} SLAB_CACHE_SLAB, *PSLAB_CACHE_SLAB;
+
+/**
+ * @brief The size of the header of the slabs (the objects start at the
+ * cache line boundaries)
+ *
+ */
+#define SLAB_CACHE_SLAB_HEADER_SIZE \
+    ((sizeof(SLAB_CACHE_SLAB) + SLAB_CACHE_OBJECT_ALIGNMENT - 1) & ~(SLAB_CACHE_OBJECT_ALIGNMENT - 1))
+
+/**
+ * @brief A cache of objects of the same size
+ *
+ */
+typedef struct _SLAB_CACHE
+{
+    UINT32          ObjectSize;             // The size of each object (rounded to the cache lines)
+    UINT32          ObjectsPerSlab;         // Count of the objects in each slab
+    LIST_ENTRY      PartialSlabsList;       // The slabs that have free objects
+    LIST_ENTRY      FullSlabsList;          // The slabs that all of their objects are allocated
+    UINT64          CountOfSlabs;           // Count of the allocated slabs
+    volatile LONG64 CountOfPoolAllocations; // Count of the objects that are larger than the objects of the slabs
+    volatile LONG   Lock;
+
+} SLAB_CACHE, *PSLAB_CACHE;
+
+//////////////////////////////////////////////////
+//				   Functions					//
+//////////////////////////////////////////////////
+
+VOID
+SlabCacheInitialize(PSLAB_CACHE Cache, UINT32 BaseObjectSize);
+
+VOID
+SlabCacheUninitialize(PSLAB_CACHE Cache);
+
+PVOID
+SlabCacheAllocate(PSLAB_CACHE Cache, SIZE_T Size);
+
+VOID
+SlabCacheFree(PSLAB_CACHE Cache, PVOID Object, SIZE_T Size);
+
+UINT64
+SlabCacheQuerySize(PSLAB_CACHE Cache);
@@ -12,6 +12,17 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum size of the span of the fields of each nt!_EPROCESS that
+ * are read at once while enumerating the processes
+ *
+ */
+#define PROCESS_LIST_MAXIMUM_PREFETCHED_FIELDS_SIZE 0x200
+
 //////////////////////////////////////////////////
 //				   Functions					//
 //////////////////////////////////////////////////
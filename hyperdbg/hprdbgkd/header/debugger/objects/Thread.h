@@ -12,6 +12,17 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//				   Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum size of the span of the fields of each nt!_ETHREAD that
+ * are read at once while enumerating the threads
+ *
+ */
+#define THREAD_LIST_MAXIMUM_PREFETCHED_FIELDS_SIZE 0x100
+
 //////////////////////////////////////////////////
 //				   Functions					//
 //////////////////////////////////////////////////
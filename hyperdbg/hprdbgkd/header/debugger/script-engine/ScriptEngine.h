@@ -17,3 +17,188 @@ ScriptEngineWrapperGetInstructionPointer();
 
 UINT64
 ScriptEngineWrapperGetAddressOfReservedBuffer(PDEBUGGER_EVENT_ACTION Action);
+
+//////////////////////////////////////////////////
+//				    Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Number of the entries of the aggregation table of each core
+ * (should be a power of 2)
+ *
+ */
+#define SCRIPT_ENGINE_AGGREGATION_TABLE_CAPACITY 0x400
+
+/**
+ * @brief Maximum number of the used entries of the aggregation table
+ * of each core (new keys are dropped after that)
+ *
+ */
+#define SCRIPT_ENGINE_AGGREGATION_TABLE_MAXIMUM_LOAD \
+    (SCRIPT_ENGINE_AGGREGATION_TABLE_CAPACITY / 4 * 3)
+
+/**
+ * @brief Number of the buckets of histograms (zero and each power of 2)
+ *
+ */
+#define SCRIPT_ENGINE_AGGREGATION_HISTOGRAM_BUCKETS 65
+
+/**
+ * @brief Number of the writes to global variables of scripts that were
+ * last written by other cores on a core in a second, after which the
+ * contention of global variables is reported
+ *
+ */
+#define SCRIPT_ENGINE_GLOBAL_VARIABLES_CONTENTION_THRESHOLD 10000
+
+//////////////////////////////////////////////////
+//				       Enums                    //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Types of the aggregations (the type is used for showing
+ * the aggregated values)
+ *
+ */
+typedef enum _SCRIPT_ENGINE_AGGREGATION_TYPE
+{
+    SCRIPT_ENGINE_AGGREGATION_TYPE_UNUSED = 0,
+    SCRIPT_ENGINE_AGGREGATION_TYPE_COUNT,
+    SCRIPT_ENGINE_AGGREGATION_TYPE_SUM,
+    SCRIPT_ENGINE_AGGREGATION_TYPE_MIN,
+    SCRIPT_ENGINE_AGGREGATION_TYPE_MAX,
+    SCRIPT_ENGINE_AGGREGATION_TYPE_HISTOGRAM,
+
+} SCRIPT_ENGINE_AGGREGATION_TYPE;
+
+/**
+ * @brief Types of reducing the local variables of all cores
+ *
+ */
+typedef enum _SCRIPT_ENGINE_PER_CORE_REDUCTION_TYPE
+{
+    SCRIPT_ENGINE_PER_CORE_REDUCTION_SUM,
+    SCRIPT_ENGINE_PER_CORE_REDUCTION_MIN,
+    SCRIPT_ENGINE_PER_CORE_REDUCTION_MAX,
+
+} SCRIPT_ENGINE_PER_CORE_REDUCTION_TYPE;
+
+//////////////////////////////////////////////////
+//				     Structures                 //
+//////////////////////////////////////////////////
+
+/**
+ * @brief An entry of the aggregation table
+ * @details the key of histograms is the number of the bucket
+ *
+ */
+typedef struct _SCRIPT_ENGINE_AGGREGATION_ENTRY
+{
+    UINT32 Type; // SCRIPT_ENGINE_AGGREGATION_TYPE (zero if the entry is not used)
+    UINT32 MapId;
+    UINT64 Key;
+    UINT64 Count;
+    UINT64 Sum;
+    UINT64 Min;
+    UINT64 Max;
+
+} SCRIPT_ENGINE_AGGREGATION_ENTRY, *PSCRIPT_ENGINE_AGGREGATION_ENTRY;
+
+/**
+ * @brief The aggregation table of a core
+ * @details the table is an open-addressing (linear probing) hash table
+ * which is only updated by its own core, entries are never removed
+ * (clearing a map only resets its values) so the tables of other cores
+ * can be read while they're updated
+ *
+ */
+typedef struct _SCRIPT_ENGINE_AGGREGATION_TABLE
+{
+    UINT32                          UsedEntries;
+    UINT64                          DroppedUpdates;
+    SCRIPT_ENGINE_AGGREGATION_ENTRY Entries[SCRIPT_ENGINE_AGGREGATION_TABLE_CAPACITY];
+
+} SCRIPT_ENGINE_AGGREGATION_TABLE, *PSCRIPT_ENGINE_AGGREGATION_TABLE;
+
+/**
+ * @brief The (read-only) code of a script which is shared by the run
+ * script actions that have the same script
+ * @details the code is found by its content, it's freed once the last
+ * action that uses it is removed, the symbols of the script are placed
+ * right after this structure
+ *
+ */
+typedef struct _SCRIPT_ENGINE_SHARED_CODE
+{
+    LIST_ENTRY                       SharedCodesList;
+    UINT64                           Hash;
+    UINT32                           ReferenceCount;
+    UINT32                           ScriptLength;
+    UINT32                           ScriptPointer;
+    struct _SCRIPT_ENGINE_BYTECODE * Bytecode; // Pre-compiled form of the script (if it can be compiled)
+
+} SCRIPT_ENGINE_SHARED_CODE, *PSCRIPT_ENGINE_SHARED_CODE;
+
+//////////////////////////////////////////////////
+//				     Functions                  //
+//////////////////////////////////////////////////
+
+BOOLEAN
+ScriptEngineAggregationInitialize(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+VOID
+ScriptEngineAggregationUninitialize(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+BOOLEAN
+ScriptEngineScratchInitialize(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+VOID
+ScriptEngineScratchUninitialize(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+UINT64
+ScriptEngineScratchAllocate(UINT64 Size);
+
+BOOLEAN
+ScriptEngineOutputInitialize(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+VOID
+ScriptEngineOutputUninitialize(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+UINT64
+ScriptEngineQueryBuffersSize();
+
+VOID
+ScriptEngineOutputBegin(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+VOID
+ScriptEngineOutputFlush(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+VOID
+ScriptEngineOutputEnd(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+VOID
+ScriptEngineOutputMessage(UINT64 Tag, BOOLEAN ImmediateMessagePassing, CHAR * Message, UINT32 MessageLength);
+
+UINT64
+ScriptEngineAggregationUpdate(SCRIPT_ENGINE_AGGREGATION_TYPE Type, UINT64 MapId, UINT64 Key, UINT64 Value);
+
+VOID
+ScriptEngineAggregationPrint(UINT64 Tag, BOOLEAN ImmediateMessagePassing, UINT64 MapId);
+
+VOID
+ScriptEngineAggregationClear(UINT64 MapId);
+
+UINT64
+ScriptEngineReducePerCoreVariable(SCRIPT_ENGINE_PER_CORE_REDUCTION_TYPE Type, UINT32 Index);
+
+VOID
+ScriptEngineGlobalVariablesResetContention();
+
+VOID
+ScriptEngineGlobalVariableWritten(UINT64 Index);
+
+PSCRIPT_ENGINE_SHARED_CODE
+ScriptEngineAcquireSharedCode(PVOID ScriptBuffer, UINT32 ScriptLength, UINT32 ScriptPointer);
+
+VOID
+ScriptEngineReleaseSharedCode(PSCRIPT_ENGINE_SHARED_CODE SharedCode);
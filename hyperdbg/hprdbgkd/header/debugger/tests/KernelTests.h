@@ -11,6 +11,42 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//				   Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The shared state of the threads of a scenario of the stress test
+ * @details the threads are stored after this structure
+ *
+ */
+typedef struct _TEST_KERNEL_STRESS_CONTEXT
+{
+    DEBUGGER_KERNEL_STRESS_SCENARIO Scenario;
+    KEVENT                          StartEvent;    // Set once all the threads are created
+    KEVENT                          FinishedEvent; // Set by the last finished thread
+    UINT64                          Deadline;      // Interrupt time of the end of the scenario
+    volatile LONG                   IsStopping;
+    volatile LONG                   RunningThreads;
+    volatile LONG64                 Operations;
+    volatile LONG64                 FailedOperations;
+    volatile LONG64                 TotalCycles;
+    volatile LONG64                 MaximumCycles;
+
+} TEST_KERNEL_STRESS_CONTEXT, *PTEST_KERNEL_STRESS_CONTEXT;
+
+/**
+ * @brief A thread of the stress test
+ *
+ */
+typedef struct _TEST_KERNEL_STRESS_THREAD
+{
+    PTEST_KERNEL_STRESS_CONTEXT Context;
+    UINT32                      CoreId;
+    PKTHREAD                    Thread;
+
+} TEST_KERNEL_STRESS_THREAD, *PTEST_KERNEL_STRESS_THREAD;
+
 //////////////////////////////////////////////////
 //				   Functions					//
 //////////////////////////////////////////////////
@@ -18,5 +54,14 @@
 VOID
 TestKernelPerformTests(PDEBUGGER_PERFORM_KERNEL_TESTS KernelTestRequest);
 
+VOID
+TestKernelPerformBenchmark(PDEBUGGER_PERFORM_KERNEL_BENCHMARK BenchmarkRequest, UINT32 MaximumCoresCount);
+
+VOID
+TestKernelPerformStress(PDEBUGGER_PERFORM_KERNEL_STRESS StressRequest);
+
+UINT64
+TestKernelStressTargetFunction(UINT64 Value);
+
 UINT32
 TestKernelGetInformation(PDEBUGGEE_KERNEL_AND_USER_TEST_INFORMATION InfoRequest);
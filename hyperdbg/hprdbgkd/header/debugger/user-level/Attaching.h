@@ -19,7 +19,7 @@
  * @brief Maximum actions in paused threads storage
  *
  */
-#define MAX_USER_ACTIONS_FOR_THREADS 3
+#define MAX_USER_ACTIONS_FOR_THREADS 8
 
 /**
  * @brief Maximum threads that a process thread holder might have
@@ -36,6 +36,24 @@
  */
 #define MAX_CR3_IN_A_PROCESS 4
 
+/**
+ * @brief Layout of the reserved buffer of the process for halting the
+ * paused threads
+ * @details the parking stub (cpuid, syscall, jmp) waits on the parking
+ * event of the process and is followed by the timeout of the wait, the
+ * nop sled (which ends with cpuid, jmp) is after them
+ */
+#define USERMODE_RESERVED_BUFFER_PARKING_STUB_OFFSET    0x0
+#define USERMODE_RESERVED_BUFFER_PARKING_TIMEOUT_OFFSET 0x8
+#define USERMODE_RESERVED_BUFFER_NOP_SLED_OFFSET        0x10
+
+/**
+ * @brief Timeout of each wait of the parked threads (relative, 100ns units)
+ * @details the threads are woken by the parking event, the timeout is only a
+ * safety net for the signals that are missed
+ */
+#define USERMODE_PARKING_WAIT_TIMEOUT (-10 * 1000 * 100)
+
 //////////////////////////////////////////////////
 //				   Structures					//
 //////////////////////////////////////////////////
@@ -65,6 +83,12 @@ typedef struct _USERMODE_DEBUGGING_PROCESS_DETAILS
     BOOLEAN    IsEntrypointPageAlreadyPresent;
     CR3_TYPE   InterceptedCr3[MAX_CR3_IN_A_PROCESS];
     LIST_ENTRY ThreadsListHead;
+    PKEVENT    ParkingEvent;              // NULL if the paused threads spin on the nop sled
+    HANDLE     ParkingEventHandle;        // handle of the parking event in the process
+    BOOLEAN    IsCr3VmexitFilterApplied;  // only the mov-to-cr3s of this process are handled by the full path
+    CR3_TYPE   Cr3VmexitFilterKernelCr3;  // the cr3 (directory table base) of the process in the filter
+    LONG       IsCr3VmexitFilterBypassed; // the filter is full, all of the mov-to-cr3s are handled by the full path
+    LONG       Cr3VmexitFilterReferences; // bits of the intercepted cr3s that are referenced in the filter
 
 } USERMODE_DEBUGGING_PROCESS_DETAILS, *PUSERMODE_DEBUGGING_PROCESS_DETAILS;
 
@@ -83,6 +107,15 @@ AttachingCheckPageFaultsWithUserDebugger(UINT32 CoreId,
 BOOLEAN
 AttachingConfigureInterceptingThreads(UINT64 ProcessDebuggingToken, BOOLEAN Enable);
 
+VOID
+AttachingApplyCr3VmexitFilter(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail);
+
+VOID
+AttachingAddCr3ToCr3VmexitFilter(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail, UINT32 Index);
+
+VOID
+AttachingRemoveCr3VmexitFilter(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail);
+
 BOOLEAN
 AttachingHandleCr3VmexitsForThreadInterception(UINT32 CoreId, CR3_TYPE NewCr3);
 
@@ -104,6 +137,9 @@ AttachingFindProcessDebuggingDetailsByProcessId(UINT32 ProcessId);
 BOOLEAN
 AttachingQueryDetailsOfActiveDebuggingThreadsAndProcesses(PVOID BufferToStoreDetails, UINT32 BufferSize);
 
+VOID
+AttachingSignalParkingEvent(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail);
+
 BOOLEAN
 AttachingCheckUnhandledEptViolation(UINT32 CoreId,
                                     UINT64 ViolationQualification,
@@ -11,6 +11,30 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//				      Constants     			//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Count of the slots of the index of the threads (power of two)
+ *
+ */
+#define THREAD_HOLDER_INDEX_CAPACITY 0x2000
+
+/**
+ * @brief Maximum count of the slots that are probed for finding a thread
+ * in the index
+ *
+ */
+#define THREAD_HOLDER_INDEX_MAXIMUM_PROBES 64
+
+/**
+ * @brief The thread id of the removed slots of the index (thread ids are
+ * multiples of four)
+ *
+ */
+#define THREAD_HOLDER_INDEX_REMOVED_THREAD_ID 0xffffffff
+
 //////////////////////////////////////////////////
 //				        Locks       			//
 //////////////////////////////////////////////////
@@ -35,6 +59,8 @@ typedef struct _USERMODE_DEBUGGING_THREAD_DETAILS
     UINT64                     ThreadRip; // if IsPaused is TRUE
     BOOLEAN                    IsPaused;
     BOOLEAN                    IsRflagsTrapFlagsSet;
+    BOOLEAN                    IsParkedOnEvent;
+    GUEST_REGS                 ParkedRegisters; // registers of the thread once it's parked on the event
     DEBUGGER_UD_COMMAND_ACTION UdAction[MAX_USER_ACTIONS_FOR_THREADS];
 
 } USERMODE_DEBUGGING_THREAD_DETAILS, *PUSERMODE_DEBUGGING_THREAD_DETAILS;
@@ -50,10 +76,37 @@ typedef struct _USERMODE_DEBUGGING_THREAD_HOLDER
 
 } USERMODE_DEBUGGING_THREAD_HOLDER, *PUSERMODE_DEBUGGING_THREAD_HOLDER;
 
+/**
+ * @brief Each slot of the index of the threads (thread id to the details
+ * of the thread and its process)
+ * @details the slot is visible to the lookups once its thread id is set
+ *
+ */
+typedef struct _THREAD_HOLDER_INDEX_ENTRY
+{
+    volatile UINT32                     ThreadId; // Zero if the slot is never used
+    PUSERMODE_DEBUGGING_THREAD_DETAILS  ThreadDetails;
+    PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDetails;
+
+} THREAD_HOLDER_INDEX_ENTRY, *PTHREAD_HOLDER_INDEX_ENTRY;
+
 //////////////////////////////////////////////////
 //				      Functions     			//
 //////////////////////////////////////////////////
 
+static UINT32
+ThreadHolderIndexHash(UINT32 ThreadId);
+
+static PTHREAD_HOLDER_INDEX_ENTRY
+ThreadHolderIndexFind(UINT32 ThreadId, PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail);
+
+static VOID
+ThreadHolderIndexInsert(PUSERMODE_DEBUGGING_THREAD_DETAILS  ThreadDebuggingDetail,
+                        PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail);
+
+static VOID
+ThreadHolderIndexRemoveProcess(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail);
+
 VOID
 ThreadHolderAllocateThreadHoldingBuffers();
 
@@ -63,6 +116,9 @@ ThreadHolderAssignThreadHolderToProcessDebuggingDetails(PUSERMODE_DEBUGGING_PROC
 BOOLEAN
 ThreadHolderIsAnyPausedThreadInProcess(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail);
 
+BOOLEAN
+ThreadHolderIsAnyPendingActionInProcess(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail);
+
 PUSERMODE_DEBUGGING_THREAD_DETAILS
 ThreadHolderGetProcessThreadDetailsByProcessIdAndThreadId(UINT32 ProcessId, UINT32 ThreadId);
 
@@ -75,6 +131,10 @@ ThreadHolderGetProcessDebuggingDetailsByThreadId(UINT32 ThreadId);
 PUSERMODE_DEBUGGING_THREAD_DETAILS
 ThreadHolderFindOrCreateThreadDebuggingDetail(UINT32 ThreadId, PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetail);
 
+BOOLEAN
+ThreadHolderApplyActionToThread(PUSERMODE_DEBUGGING_THREAD_DETAILS ThreadDebuggingDetails,
+                                PDEBUGGER_UD_COMMAND_ACTION        UdAction);
+
 BOOLEAN
 ThreadHolderApplyActionToPausedThreads(PUSERMODE_DEBUGGING_PROCESS_DETAILS ProcessDebuggingDetails,
                                        PDEBUGGER_UD_COMMAND_PACKET         ActionRequest);
@@ -29,5 +29,8 @@ UdCheckAndHandleBreakpointsAndDebugBreaks(PROCESSOR_DEBUGGING_STATE *       DbgS
 BOOLEAN
 UdDispatchUsermodeCommands(PDEBUGGER_UD_COMMAND_PACKET ActionRequest);
 
+VOID
+UdDispatchUsermodeBatchCommands(PDEBUGGER_UD_BATCH_COMMAND_PACKET BatchRequest);
+
 BOOLEAN
-UdCheckForCommand();
+UdCheckForCommand(GUEST_REGS * Regs);
@@ -161,6 +161,27 @@ typedef struct _LDR_DATA_TABLE_ENTRY
     //    EntryPointActivationContext;
 } LDR_DATA_TABLE_ENTRY, *PLDR_DATA_TABLE_ENTRY;
 
+/**
+ * @brief The cache of the loaded modules of a user-mode process
+ * @details the cache is built once the modules are requested and it's
+ * rebuilt once a new image is mapped into the process or the head of the
+ * loader list is changed (a module that is unloaded from the middle of the
+ * list remains in the cache until one of them happens)
+ *
+ */
+typedef struct _USER_ACCESS_MODULE_CACHE
+{
+    LIST_ENTRY                      CacheList;
+    UINT32                          ProcessId;
+    BOOLEAN                         Is32Bit;
+    BOOLEAN                         IsStale;       // a new image is mapped after building the cache
+    UINT64                          ListHeadFlink; // the loader list (in load order) when the cache is built
+    UINT64                          ListHeadBlink;
+    UINT32                          ModulesCount;
+    PUSERMODE_LOADED_MODULE_SYMBOLS Modules;
+
+} USER_ACCESS_MODULE_CACHE, *PUSER_ACCESS_MODULE_CACHE;
+
 //////////////////////////////////////////////////
 //				   Definitions					//
 //////////////////////////////////////////////////
@@ -209,6 +230,12 @@ UserAccessAllocateAndGetImagePathFromProcessId(HANDLE          ProcessId,
 BOOLEAN
 UserAccessGetLoadedModules(PUSERMODE_LOADED_MODULE_DETAILS ProcessLoadedModuleRequest, UINT32 BufferSize);
 
+BOOLEAN
+UserAccessModuleCacheInitialize();
+
+VOID
+UserAccessModuleCacheUninitialize();
+
 BOOLEAN
 UserAccessIsWow64Process(HANDLE ProcessId, PBOOLEAN Is32Bit);
 
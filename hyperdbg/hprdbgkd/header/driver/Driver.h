@@ -40,6 +40,9 @@ DrvWrite(PDEVICE_OBJECT DeviceObject, PIRP Irp);
 NTSTATUS
 DrvClose(PDEVICE_OBJECT DeviceObject, PIRP Irp);
 
+NTSTATUS
+DrvCleanup(PDEVICE_OBJECT DeviceObject, PIRP Irp);
+
 NTSTATUS
 DrvUnsupported(PDEVICE_OBJECT DeviceObject, PIRP Irp);
 
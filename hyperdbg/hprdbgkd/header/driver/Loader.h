@@ -19,5 +19,8 @@
 BOOLEAN
 LoaderInitVmmAndDebugger();
 
+VOID
+LoaderReadLogBufferConfiguration(PUNICODE_STRING RegistryPath);
+
 VOID
 LoaderUninitializeLogTracer();
@@ -41,6 +41,39 @@ BOOLEAN g_AllowIOCTLFromUsermode;
  */
 DEBUGGER_CORE_EVENTS * g_Events;
 
+/**
+ * @brief The clears of the per-core resources of the terminated events
+ * that are deferred (while terminating all events)
+ *
+ */
+TERMINATE_DEFERRED_CLEARS g_TerminateDeferredClears;
+
+/**
+ * @brief The controls of the events (MSR bitmaps, I/O ports and exceptions)
+ * that are changed in vmx-root
+ *
+ */
+DEBUGGER_EVENTS_PENDING_CONTROLS g_EventsPendingControls;
+
+/**
+ * @brief lookup index of events (for dispatching events)
+ *
+ */
+DEBUGGER_EVENTS_INDEX * g_EventsIndex;
+
+/**
+ * @brief lock for modifying the lookup index of events
+ *
+ */
+volatile LONG g_EventsIndexLock;
+
+/**
+ * @brief generation of events, it's changed whenever the armed
+ * events should be re-snapshotted by cores
+ *
+ */
+volatile LONG64 g_ArmedEventsGeneration;
+
 /**
  * @brief Holds the requests to pause the break of debuggee until
  * a special event happens
@@ -84,6 +117,13 @@ BOOLEAN g_EnableDebuggerEvents;
  */
 LIST_ENTRY g_BreakpointsListHead;
 
+/**
+ * @brief Index of breakpoints for debugger-mode (buckets of the physical
+ * addresses) which is searched on each #BP
+ *
+ */
+LIST_ENTRY g_BreakpointsIndex[BREAKPOINT_INDEX_BUCKETS_COUNT];
+
 /**
  * @brief Seed for setting id of breakpoints
  *
@@ -96,6 +136,13 @@ UINT64 g_MaximumBreakpointId;
  */
 BOOLEAN g_KernelDebuggerState;
 
+/**
+ * @brief Whether the notify routine of loading kernel modules (for
+ * notifying the debugger about the symbols of new modules) is registered
+ *
+ */
+BOOLEAN g_KernelDebuggerLoadImageNotifyRoutineIsRegistered;
+
 /**
  * @brief shows whether the user debugger is enabled or disabled
  *
@@ -108,6 +155,20 @@ BOOLEAN g_UserDebuggerState;
  */
 BOOLEAN g_InterceptBreakpoints;
 
+/**
+ * @brief shows whether the results of printf are saved as binary trace
+ * records (formatted by the user-mode) or not
+ *
+ */
+BOOLEAN g_BinaryTraceMode;
+
+/**
+ * @brief The capacity of the message buffers (read from the
+ * parameters of the driver)
+ *
+ */
+LOG_BUFFER_CONFIGURATION g_LogBufferConfiguration;
+
 /**
  * @brief Reason that the debuggee is halted
  *
@@ -145,6 +206,35 @@ BOOLEAN g_IsWaitingForReturnAndRunFromPageFault;
  */
 LIST_ENTRY g_ProcessDebuggingDetailsListHead;
 
+/**
+ * @brief System call number of NtWaitForSingleObject (for parking the
+ * paused threads of the user debugger)
+ *
+ */
+UINT32 g_NtWaitForSingleObjectSyscallNumber;
+
+/**
+ * @brief Shows whether the system call number of NtWaitForSingleObject
+ * is found or not
+ *
+ */
+BOOLEAN g_IsNtWaitForSingleObjectSyscallNumberFound;
+
+/**
+ * @brief The (preallocated) index of the threads of the debugging processes
+ * @details it's only changed while holding VmxRootThreadHoldingLock
+ *
+ */
+THREAD_HOLDER_INDEX_ENTRY g_ThreadHolderIndex[THREAD_HOLDER_INDEX_CAPACITY];
+
+/**
+ * @brief Whether a thread is not added to the index of the threads (all
+ * of the probed slots were used) or not, if so, the threads which are not
+ * found in the index are also searched in the thread holders
+ *
+ */
+BOOLEAN g_ThreadHolderIndexIsIncomplete;
+
 /**
  * @brief Target function for kernel tests
  *
@@ -172,8 +262,187 @@ UINT64 g_KernelTestR14;
 UINT64 g_KernelTestR13;
 UINT64 g_KernelTestR12;
 
+/**
+ * @brief The page that is read by the benchmark (it's hooked by the
+ * events of the benchmark)
+ *
+ */
+DECLSPEC_ALIGN(PAGE_SIZE)
+UINT8 g_KernelBenchmarkPage[PAGE_SIZE];
+
 /**
  * @brief Whether the thread attaching mechanism is waiting for #DB or not
  *
  */
 BOOLEAN g_IsWaitingForUserModeModuleEntrypointToBeCalled;
+
+/**
+ * @brief Buffer of reading the memory while searching in the debugger mode
+ * @details each page is read with the bytes that the longest pattern needs
+ *
+ */
+UINT8 g_SearchMemoryBuffer[PAGE_SIZE + MaximumSearchPatternSize];
+
+/**
+ * @brief The parallel search that is shared with the halted cores
+ *
+ */
+SEARCH_MEMORY_PARALLEL_JOB g_SearchMemoryParallelJob;
+
+/**
+ * @brief Slices of the parallel searches
+ *
+ */
+PSEARCH_MEMORY_PARALLEL_SLICE g_SearchMemoryParallelSlices;
+
+/**
+ * @brief Count of slices of the parallel searches
+ *
+ */
+UINT32 g_SearchMemoryParallelCountOfSlices;
+
+/**
+ * @brief Buffers of the cores for reading the memory in the parallel searches
+ *
+ */
+UINT8 * g_SearchMemoryParallelBuffers;
+
+/**
+ * @brief Buffers of the cores for the records of the hits of events
+ *
+ */
+PDEBUGGER_EVENT_RECORDS_BUFFER g_DebuggerEventRecordsBuffers;
+
+/**
+ * @brief The lock of the queries of the records of the hits of events
+ *
+ */
+volatile LONG g_DebuggerEventRecordsLock;
+
+/**
+ * @brief Whether the crc32 instruction (SSE4.2) is supported or not
+ *
+ */
+BOOLEAN g_SerialConnectionIsSse42Supported;
+
+/**
+ * @brief Whether the debugger accepts CRC32C frames or not
+ *
+ */
+BOOLEAN g_SerialConnectionIsPeerCrc32cSupported;
+
+/**
+ * @brief Whether the debugger accepts compressed frames or not
+ *
+ */
+BOOLEAN g_SerialConnectionIsPeerDecompressionSupported;
+
+/**
+ * @brief The state of sending frames over the control link and the
+ * bulk link
+ *
+ */
+SERIAL_CONNECTION_LINK g_SerialConnectionControlLink;
+SERIAL_CONNECTION_LINK g_SerialConnectionBulkLink;
+
+/**
+ * @brief Whether the bulk data (memory and messages of events) is sent
+ * over the bulk link (a second serial port) or not
+ *
+ */
+BOOLEAN g_SerialConnectionIsBulkLinkEnabled;
+
+/**
+ * @brief Whether the debuggee is connected to the debugger over
+ * the network (instead of serial)
+ *
+ */
+BOOLEAN g_NetworkConnectionIsEnabled;
+
+/**
+ * @brief State of the network adapter of the connection
+ *
+ */
+NETWORK_CONNECTION_STATE g_NetworkConnection;
+
+/**
+ * @brief The thread that polls the network adapter while the
+ * debuggee is running
+ *
+ */
+PETHREAD g_NetworkConnectionPollingThread;
+
+/**
+ * @brief Whether the polling thread should stop or not
+ *
+ */
+volatile BOOLEAN g_NetworkConnectionShouldStop;
+
+/**
+ * @brief The buffer that the results of a batch of requests
+ * are gathered into before sending them to the debugger
+ *
+ */
+BYTE g_KdBatchResultsBuffer[MaxSerialBatchRequestsSize];
+
+/**
+ * @brief State of tracing multiple steps in the debuggee
+ *
+ */
+KD_STEP_TRACE_STATE g_KdStepTrace;
+
+/**
+ * @brief The buffer that the trace of the steps is gathered
+ * into before sending it to the debugger
+ *
+ */
+BYTE g_KdStepTraceBuffer[MaxSerialStepTraceChunkSize];
+
+/**
+ * @brief State of running a count of instructions in the debuggee
+ *
+ */
+KD_INSTRUCTION_BUDGET_STATE g_KdInstructionBudget;
+
+/**
+ * @brief State of the watchdog of the halts of the debuggee
+ *
+ */
+KD_HALT_WATCHDOG_STATE g_KdHaltWatchdog;
+
+/**
+ * @brief Epochs of halting and continuing the debuggee
+ *
+ */
+KD_HALT_EPOCHS g_KdHaltEpochs;
+
+/**
+ * @brief List of the caches of the loaded modules of user-mode processes
+ *
+ */
+LIST_ENTRY g_UserAccessModuleCacheListHead;
+
+/**
+ * @brief Lock of the caches of the loaded modules
+ *
+ */
+volatile LONG g_UserAccessModuleCacheLock;
+
+/**
+ * @brief Whether the notify routines of the caches of the loaded modules
+ * are registered or not
+ *
+ */
+BOOLEAN g_UserAccessModuleCacheIsInitialized;
+
+/**
+ * @brief Slab cache of the event objects
+ *
+ */
+SLAB_CACHE g_EventsSlabCache;
+
+/**
+ * @brief Slab cache of the action objects
+ *
+ */
+SLAB_CACHE g_ActionsSlabCache;
@@ -84,10 +84,15 @@
 //
 #include "header/debugger/tests/KernelTests.h"
 #include "header/debugger/broadcast/DpcRoutines.h"
+#include "header/debugger/broadcast/TscSynchronization.h"
 #include "header/debugger/core/DebuggerEvents.h"
+#include "header/debugger/core/DebuggerEventsIndex.h"
+#include "header/debugger/core/DebuggerArmedEvents.h"
+#include "header/debugger/core/DebuggerEventRecords.h"
 #include "header/debugger/script-engine/ScriptEngine.h"
 #include "header/debugger/memory/Memory.h"
 #include "header/common/Common.h"
+#include "header/debugger/memory/Slabs.h"
 #include "header/debugger/memory/Allocations.h"
 #include "header/debugger/kernel-level/Kd.h"
 #include "header/debugger/user-level/Ud.h"
@@ -96,6 +101,7 @@
 #include "header/debugger/commands/ExtensionCommands.h"
 #include "header/debugger/commands/Callstack.h"
 #include "header/debugger/communication/SerialConnection.h"
+#include "header/debugger/communication/NetworkConnection.h"
 #include "header/debugger/objects/Process.h"
 #include "header/debugger/objects/Thread.h"
 #include "header/debugger/user-level/Attaching.h"
@@ -115,6 +121,7 @@
 //
 #include "../script-eval/header/ScriptEngineCommonDefinitions.h"
 #include "../script-eval/header/ScriptEngineHeader.h"
+#include "../script-eval/header/ScriptEngineBytecode.h"
 
 //
 // Global variables
@@ -48,12 +48,31 @@ BOOLEAN g_IsReversingMachineModulesLoaded;
  */
 BOOLEAN g_IsVmxOffProcessStart;
 
+/**
+ * @brief The results rings of the targets that are mapped into this process
+ *
+ */
+PREVERSING_MACHINE_RESULTS_RING g_ReversingMachineResultsRings[MaximumReversingMachineTargets];
+
+/**
+ * @brief Index of the next result of each of the results rings
+ *
+ */
+UINT64 g_ReversingMachineResultsIndexes[MaximumReversingMachineTargets];
+
+/**
+ * @brief Count of the results rings that are mapped into this process
+ *
+ */
+volatile LONG g_ReversingMachineCountOfResultsRings;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 __declspec(dllexport) int ReversingMachineStart();
 __declspec(dllexport) int ReversingMachineStop();
+__declspec(dllexport) int ReversingMachineAddTarget(UINT32 ProcessId);
 
 #ifdef __cplusplus
 }
@@ -238,6 +257,120 @@ ReadIrpBasedBuffer()
     };
 }
 
+/**
+ * @brief Read the new results of a results ring
+ * @details the ring is mapped read-only and the kernel never waits for
+ * this process, so the results that are overwritten before (or while)
+ * reading them are counted as lost
+ *
+ * @param Ring The results ring
+ * @param IndexToRead Index of the next result of the ring
+ *
+ * @return BOOLEAN Whether any result is read or not
+ */
+BOOLEAN
+ReadResultsRing(PREVERSING_MACHINE_RESULTS_RING Ring, UINT64 * IndexToRead)
+{
+    REVERSING_MACHINE_RESULT  Result;
+    PREVERSING_MACHINE_RESULT Slot;
+    UINT64                    Sequence;
+    UINT64                    CountOfLostResults = 0;
+    UINT64                    IndexToWrite       = Ring->CurrentIndexToWrite;
+    BOOLEAN                   AnyResultRead      = FALSE;
+
+    //
+    // Check whether the kernel passed the results that are not read yet
+    //
+    if (IndexToWrite - *IndexToRead > Ring->Capacity)
+    {
+        CountOfLostResults += IndexToWrite - Ring->Capacity - *IndexToRead;
+        *IndexToRead = IndexToWrite - Ring->Capacity;
+    }
+
+    while (*IndexToRead != IndexToWrite)
+    {
+        Slot     = &Ring->Results[*IndexToRead & (Ring->Capacity - 1)];
+        Sequence = Slot->Sequence;
+
+        if (Sequence < *IndexToRead + 1)
+        {
+            //
+            // The result is still written by the kernel
+            //
+            break;
+        }
+
+        _ReadWriteBarrier();
+        memcpy(&Result, (const void *)Slot, sizeof(REVERSING_MACHINE_RESULT));
+        _ReadWriteBarrier();
+
+        if (Sequence != *IndexToRead + 1 || Slot->Sequence != Sequence)
+        {
+            //
+            // The result is overwritten before (or while) being read
+            //
+            CountOfLostResults++;
+            (*IndexToRead)++;
+
+            continue;
+        }
+
+        ShowMessages("pid: %x, tid: %x, core: %x, rip: %llx, physical address: %llx\n",
+                     Ring->ProcessId,
+                     Result.ThreadId,
+                     Result.CoreId,
+                     Result.GuestRip,
+                     Result.GuestPhysicalAddress);
+
+        (*IndexToRead)++;
+        AnyResultRead = TRUE;
+    }
+
+    if (CountOfLostResults != 0)
+    {
+        ShowMessages("warning, %llx results of the process (%x) are lost\n",
+                     CountOfLostResults,
+                     Ring->ProcessId);
+    }
+
+    return AnyResultRead;
+}
+
+/**
+ * @brief Create a thread for reading the results rings
+ *
+ * @param Data
+ * @return DWORD
+ */
+DWORD WINAPI
+ResultsRingsThread(void * data)
+{
+    BOOLEAN AnyResultRead;
+
+    while (!g_IsVmxOffProcessStart)
+    {
+        AnyResultRead = FALSE;
+
+        for (LONG i = 0; i < g_ReversingMachineCountOfResultsRings; i++)
+        {
+            if (ReadResultsRing(g_ReversingMachineResultsRings[i], &g_ReversingMachineResultsIndexes[i]))
+            {
+                AnyResultRead = TRUE;
+            }
+        }
+
+        //
+        // The rings are only polled while they're empty
+        //
+        if (!AnyResultRead)
+        {
+            Sleep(DefaultSpeedOfReadingKernelMessages);
+        }
+    }
+
+    return 0;
+}
+
 /**
  * @brief Create a thread for pending buffers
  *
@@ -272,6 +405,119 @@ ReversingMachineStop()
     return 0;
 }
 
+/**
+ * @brief Add a process to the targets of the reversing machine and map its
+ * results ring into this process
+ * @details the first target initializes the reversing machine
+ *
+ * @param ProcessId The target process
+ *
+ * @return int return zero if it was successful or non-zero if there
+ * was error
+ */
+int
+ReversingMachineAddTarget(UINT32 ProcessId)
+{
+    BOOL                                         Status;
+    ULONG                                        ReturnedLength;
+    DWORD                                        ThreadId;
+    LONG                                         Index;
+    REVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST RevRequest = {0};
+    REVERSING_MACHINE_MAP_RESULTS                MapRequest = {0};
+
+    if (g_ReversingMachineCountOfResultsRings == MaximumReversingMachineTargets)
+    {
+        ShowMessages("err, the maximum count of the targets is reached\n");
+        return 1;
+    }
+
+    //
+    // The requests are sent to the debugger's device, the rings are
+    // unmapped once this handle is closed
+    //
+    if (g_DeviceHandleReversingMachine == NULL)
+    {
+        g_DeviceHandleReversingMachine = CreateFileA(
+            "\\\\.\\HyperDbgDebuggerDevice",
+            GENERIC_READ | GENERIC_WRITE,
+            FILE_SHARE_READ | FILE_SHARE_WRITE,
+            NULL, /// lpSecurityAttirbutes
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            NULL); /// lpTemplateFile
+
+        if (g_DeviceHandleReversingMachine == INVALID_HANDLE_VALUE)
+        {
+            ShowMessages("err, CreateFile failed (%x)\n", GetLastError());
+
+            g_DeviceHandleReversingMachine = NULL;
+            return 1;
+        }
+    }
+
+    RevRequest.ProcessId = ProcessId;
+    RevRequest.Mode      = REVERSING_MACHINE_RECONSTRUCT_MEMORY_MODE_USER_MODE;
+    RevRequest.Type      = REVERSING_MACHINE_RECONSTRUCT_MEMORY_TYPE_RECONSTRUCT;
+    RevRequest.Form      = REVERSING_MACHINE_RECONSTRUCT_MEMORY_FORM_OVERALL;
+
+    Status = DeviceIoControl(
+        g_DeviceHandleReversingMachine,                      // Handle to device
+        IOCTL_REQUEST_REV_MACHINE_SERVICE,                   // IO Control code
+        &RevRequest,                                         // Input Buffer to driver.
+        SIZEOF_REVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST, // Input buffer length
+        &RevRequest,                                         // Output Buffer from driver.
+        SIZEOF_REVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST, // Length of output buffer in bytes.
+        &ReturnedLength,                                     // Bytes placed in buffer.
+        NULL                                                 // synchronous call
+    );
+
+    if (!Status || RevRequest.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowMessages("err, the process (%x) couldn't be added to the targets (%x)\n",
+                     ProcessId,
+                     Status ? RevRequest.KernelStatus : GetLastError());
+        return 1;
+    }
+
+    MapRequest.ProcessId = ProcessId;
+    MapRequest.Unmap     = FALSE;
+
+    Status = DeviceIoControl(
+        g_DeviceHandleReversingMachine,       // Handle to device
+        IOCTL_MAP_REV_MACHINE_RESULTS,        // IO Control code
+        &MapRequest,                          // Input Buffer to driver.
+        SIZEOF_REVERSING_MACHINE_MAP_RESULTS, // Input buffer length
+        &MapRequest,                          // Output Buffer from driver.
+        SIZEOF_REVERSING_MACHINE_MAP_RESULTS, // Length of output buffer in bytes.
+        &ReturnedLength,                      // Bytes placed in buffer.
+        NULL                                  // synchronous call
+    );
+
+    if (!Status || MapRequest.KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        ShowMessages("err, the results of the process (%x) couldn't be mapped (%x)\n",
+                     ProcessId,
+                     Status ? MapRequest.KernelStatus : GetLastError());
+        return 1;
+    }
+
+    //
+    // The ring is visible to the reader thread once the count is increased,
+    // the old results of the ring are also read
+    //
+    Index = g_ReversingMachineCountOfResultsRings;
+
+    g_ReversingMachineResultsRings[Index]   = (PREVERSING_MACHINE_RESULTS_RING)MapRequest.RingAddress;
+    g_ReversingMachineResultsIndexes[Index] = 0;
+
+    if (InterlockedIncrement(&g_ReversingMachineCountOfResultsRings) == 1)
+    {
+        CreateThread(NULL, 0, ResultsRingsThread, NULL, 0, &ThreadId);
+    }
+
+    return 0;
+}
+
 /**
  * @brief Load the reversing machine driver
  *
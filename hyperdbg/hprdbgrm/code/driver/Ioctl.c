@@ -62,6 +62,7 @@ DrvDispatchIoControl(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             switch (RegisterEventRequest->Type)
             {
             case IRP_BASED:
+            case IRP_BASED_BATCHED:
                 Status = LogRegisterIrpBasedNotification(DeviceObject, Irp);
                 break;
             case EVENT_BASED:
@@ -48,7 +48,7 @@ LoaderInitVmmAndReversingMachine()
     //
     // Initialize message tracer
     //
-    if (LogInitialize(&MsgTracingCallbacks))
+    if (LogInitialize(&MsgTracingCallbacks, NULL))
     {
         //
         // Initialize Vmx
@@ -0,0 +1,290 @@
+/**
+ * @file benchmark.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief benchmark of the round-trip of the vm-exits
+ * @details the operations are measured by the kernel on every core and
+ * the events of each phase are registered by the debugger
+ * @version 0.4
+ * @date 2023-08-17
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Names of the operations of the benchmark (in the JSON results)
+ *
+ */
+static const CHAR * const g_BenchmarkOperationNames[DEBUGGER_KERNEL_BENCHMARK_OPERATIONS_COUNT] = {
+    "cpuid",
+    "rdtsc",
+    "rdtscp",
+    "rdmsr_trapped",
+    "rdmsr_untrapped",
+    "vmcall",
+    "io_port",
+    "ept_hooked_page",
+};
+
+/**
+ * @brief Send a command to the debugger
+ *
+ * @param PipeHandle
+ * @param Command
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TestBenchmarkSendCommand(HANDLE PipeHandle, const string & Command)
+{
+    string OutputCommand = "cmd:" + Command;
+
+    return NamedPipeClientSendMessage(PipeHandle, (char *)OutputCommand.c_str(), (int)OutputCommand.length() + 1);
+}
+
+/**
+ * @brief Register the events of a phase of the benchmark
+ * @details an event of each type is registered for each count, the
+ * page is monitored by a single event
+ *
+ * @param PipeHandle
+ * @param PageAddress Address of the page that is read by the benchmark
+ * @param Count Count of the events of each type
+ * @param Action The condition and the action of the events
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TestBenchmarkRegisterEvents(HANDLE PipeHandle, UINT64 PageAddress, UINT32 Count, const string & Action)
+{
+    ostringstream Command;
+
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        if (!TestBenchmarkSendCommand(PipeHandle, "!cpuid" + Action) ||
+            !TestBenchmarkSendCommand(PipeHandle, "!tsc" + Action) ||
+            !TestBenchmarkSendCommand(PipeHandle, "!vmcall" + Action))
+        {
+            return FALSE;
+        }
+
+        Command.str("");
+        Command << "!msrread " << hex << TEST_BENCHMARK_TRAPPED_MSR << Action;
+
+        if (!TestBenchmarkSendCommand(PipeHandle, Command.str()))
+        {
+            return FALSE;
+        }
+
+        Command.str("");
+        Command << "!ioin " << hex << TEST_BENCHMARK_IO_PORT << Action;
+
+        if (!TestBenchmarkSendCommand(PipeHandle, Command.str()))
+        {
+            return FALSE;
+        }
+    }
+
+    if (Count != 0)
+    {
+        Command.str("");
+        Command << "!monitor r " << hex << PageAddress << " " << PageAddress + NORMAL_PAGE_SIZE - 1 << Action;
+
+        if (!TestBenchmarkSendCommand(PipeHandle, Command.str()))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Run a phase of the benchmark and add its results to the JSON
+ *
+ * @param PipeHandle
+ * @param Name Name of the phase
+ * @param Iterations Iterations of each operation
+ * @param Json The results
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TestBenchmarkRunPhase(HANDLE PipeHandle, const CHAR * Name, UINT32 Iterations, ostringstream & Json)
+{
+    CHAR                                   Request[64];
+    CHAR *                                 Buffer;
+    UINT32                                 ReadBytes;
+    PDEBUGGER_PERFORM_KERNEL_BENCHMARK     BenchmarkResult;
+    PDEBUGGER_KERNEL_BENCHMARK_CORE_RESULT CoreResults;
+
+    sprintf_s(Request, sizeof(Request), "perform-kernel-benchmark:%x", Iterations);
+
+    if (!NamedPipeClientSendMessage(PipeHandle, Request, (int)strlen(Request) + 1))
+    {
+        return FALSE;
+    }
+
+    Buffer = (CHAR *)malloc(TEST_CASE_MAXIMUM_BUFFERS_TO_COMMUNICATE);
+
+    if (Buffer == NULL)
+    {
+        return FALSE;
+    }
+
+    //
+    // The debugger sends the results once the benchmark is finished
+    //
+    ReadBytes = NamedPipeClientReadMessage(PipeHandle, Buffer, TEST_CASE_MAXIMUM_BUFFERS_TO_COMMUNICATE);
+
+    BenchmarkResult = (PDEBUGGER_PERFORM_KERNEL_BENCHMARK)Buffer;
+    CoreResults     = (PDEBUGGER_KERNEL_BENCHMARK_CORE_RESULT)(Buffer + SIZEOF_DEBUGGER_PERFORM_KERNEL_BENCHMARK);
+
+    if (ReadBytes < SIZEOF_DEBUGGER_PERFORM_KERNEL_BENCHMARK ||
+        ReadBytes < SIZEOF_DEBUGGER_PERFORM_KERNEL_BENCHMARK + BenchmarkResult->CoresCount * sizeof(DEBUGGER_KERNEL_BENCHMARK_CORE_RESULT))
+    {
+        free(Buffer);
+        return FALSE;
+    }
+
+    Json << "    {\n";
+    Json << "      \"name\": \"" << Name << "\",\n";
+    Json << "      \"cores\": [\n";
+
+    for (UINT32 CoreId = 0; CoreId < BenchmarkResult->CoresCount; CoreId++)
+    {
+        Json << "        { \"core\": " << dec << CoreId;
+
+        for (UINT32 Operation = 0; Operation < DEBUGGER_KERNEL_BENCHMARK_OPERATIONS_COUNT; Operation++)
+        {
+            Json << ", \"" << g_BenchmarkOperationNames[Operation] << "\": " << dec << CoreResults[CoreId].Cycles[Operation];
+        }
+
+        Json << " }" << (CoreId + 1 != BenchmarkResult->CoresCount ? "," : "") << "\n";
+    }
+
+    Json << "      ]\n";
+    Json << "    }";
+
+    free(Buffer);
+
+    return BenchmarkResult->CoresCount != 0;
+}
+
+/**
+ * @brief Perform the benchmark of the round-trip of the vm-exits
+ * @details the operations are measured without events, with the dummy
+ * events (their condition is never true) and with a trivial script, the
+ * results (average cycles of each operation on each core) are shown in
+ * JSON format by the debugger
+ *
+ * @param PipeHandle
+ * @param KernelInformation Details from kernel to find the benchmark page
+ * @param KernelInformationSize Size of KernelInformation
+ * @param Iterations Iterations of each operation
+ * @param DummyEvents Count of the dummy events of each type
+ *
+ * @return VOID
+ */
+VOID
+TestPerformBenchmark(HANDLE PipeHandle,
+                     PVOID  KernelInformation,
+                     UINT32 KernelInformationSize,
+                     UINT32 Iterations,
+                     UINT32 DummyEvents)
+{
+    PDEBUGGEE_KERNEL_AND_USER_TEST_INFORMATION KernelInfoArray = (PDEBUGGEE_KERNEL_AND_USER_TEST_INFORMATION)KernelInformation;
+    UINT64                                     PageAddress     = NULL;
+    ostringstream                              Json;
+    string                                     Line;
+    BOOLEAN                                    Result;
+    char                                       SuccessMessage[] = "success";
+
+    printf("start benchmarking vm-exits...\n");
+
+    for (size_t i = 0; i < KernelInformationSize / sizeof(DEBUGGEE_KERNEL_AND_USER_TEST_INFORMATION); i++)
+    {
+        if (!strcmp(KernelInfoArray[i].Tag, "KernelBenchmarkPage"))
+        {
+            PageAddress = KernelInfoArray[i].Value;
+        }
+    }
+
+    if (PageAddress == NULL)
+    {
+        printf("err, the benchmark page is not found\n");
+        return;
+    }
+
+    Json << "{\n";
+    Json << "  \"iterations\": " << dec << Iterations << ",\n";
+    Json << "  \"dummy_events\": " << dec << DummyEvents << ",\n";
+    Json << "  \"trapped_msr\": \"0x" << hex << TEST_BENCHMARK_TRAPPED_MSR << "\",\n";
+    Json << "  \"untrapped_msr\": \"0x" << hex << TEST_BENCHMARK_UNTRAPPED_MSR << "\",\n";
+    Json << "  \"io_port\": \"0x" << hex << TEST_BENCHMARK_IO_PORT << "\",\n";
+    Json << "  \"phases\": [\n";
+
+    //
+    // Without any event
+    //
+    Result = TestBenchmarkRunPhase(PipeHandle, "no_events", Iterations, Json);
+
+    //
+    // With the dummy events, their condition is never true (xor eax, eax; ret)
+    // so only the cost of dispatching the events is added
+    //
+    if (Result)
+    {
+        Json << ",\n";
+
+        Result = TestBenchmarkRegisterEvents(PipeHandle, PageAddress, DummyEvents, " condition { 31 c0 c3 } code { c3 }") &&
+                 TestBenchmarkRunPhase(PipeHandle, "dummy_events", Iterations, Json) &&
+                 TestBenchmarkSendCommand(PipeHandle, "events c all");
+    }
+
+    //
+    // With a trivial script action
+    //
+    if (Result)
+    {
+        Json << ",\n";
+
+        Result = TestBenchmarkRegisterEvents(PipeHandle, PageAddress, 1, " script { x = 1; }") &&
+                 TestBenchmarkRunPhase(PipeHandle, "script_action", Iterations, Json) &&
+                 TestBenchmarkSendCommand(PipeHandle, "events c all");
+    }
+
+    Json << "\n  ]\n";
+    Json << "}\n";
+
+    if (!Result)
+    {
+        printf("err, the benchmark is failed\n");
+        TestBenchmarkSendCommand(PipeHandle, "events c all");
+        return;
+    }
+
+    //
+    // Show the results in the debugger (line by line as the results
+    // might be larger than the buffer of the messages)
+    //
+    istringstream Lines(Json.str());
+
+    while (std::getline(Lines, Line))
+    {
+        Line = "print:" + Line + "\n";
+
+        if (!NamedPipeClientSendMessage(PipeHandle, (char *)Line.c_str(), (int)Line.length() + 1))
+        {
+            return;
+        }
+    }
+
+    printf("%s", Json.str().c_str());
+
+    //
+    // Send success message to the HyperDbg
+    //
+    NamedPipeClientSendMessage(PipeHandle, (char *)SuccessMessage, sizeof(SuccessMessage));
+}
@@ -28,7 +28,7 @@ main(int argc, char * argv[])
     UINT32  ReadBytes;
     char *  Buffer;
 
-    if (argc != 2)
+    if (argc != 2 && !(argc == 5 && !strcmp(argv[2], "benchmark")))
     {
         printf("you should not test functionalities directly, instead use 'test' "
                "command from HyperDbg...\n");
@@ -127,10 +127,24 @@ main(int argc, char * argv[])
                 return 1;
             }
 
-            //
-            // Dispatch the test case number
-            //
-            TestCreateLookupTable(PipeHandle, (PVOID)Buffer, ReadBytes);
+            if (argc == 5)
+            {
+                //
+                // Perform the benchmark (iterations and dummy events are in hex)
+                //
+                TestPerformBenchmark(PipeHandle,
+                                     (PVOID)Buffer,
+                                     ReadBytes,
+                                     strtoul(argv[3], NULL, 16),
+                                     strtoul(argv[4], NULL, 16));
+            }
+            else
+            {
+                //
+                // Dispatch the test case number
+                //
+                TestCreateLookupTable(PipeHandle, (PVOID)Buffer, ReadBytes);
+            }
 
             //
             // Close the pipe connection
@@ -32,6 +32,13 @@ extern void inline AsmTest();
 VOID
 TestCreateLookupTable(HANDLE PipeHandle, PVOID KernelInformation, UINT32 KernelInformationSize);
 
+VOID
+TestPerformBenchmark(HANDLE PipeHandle,
+                     PVOID  KernelInformation,
+                     UINT32 KernelInformationSize,
+                     UINT32 Iterations,
+                     UINT32 DummyEvents);
+
 //////////////////////////////////////////////////
 //				General Functions               //
 //////////////////////////////////////////////////
@@ -99,24 +99,176 @@ BOOLEAN inline LogSendImmediateMessage(CHAR * OptionalBuffer,
     return SendImmediateMessage(OptionalBuffer, OptionalBufferLength, OperationCode);
 }
 
+/**
+ * @brief Get the buffer of a core
+ * @param CoreId
+ * @param IsVmxRoot
+ *
+ * @return PLOG_BUFFER_INFORMATION
+ */
+PLOG_BUFFER_INFORMATION inline LogGetBufferInformation(ULONG CoreId, BOOLEAN IsVmxRoot)
+{
+    return &MessageBufferInformation[(CoreId * 2) + (IsVmxRoot ? 1 : 0)];
+}
+
+/**
+ * @brief Get the lock of readers of buffers
+ * @param IsVmxRoot
+ *
+ * @return volatile LONG *
+ */
+volatile LONG *
+LogGetReaderLock(BOOLEAN IsVmxRoot)
+{
+    return IsVmxRoot ? &VmxRootLoggingReaderLock : &VmxNonRootLoggingReaderLock;
+}
+
+/**
+ * @brief Acquire the lock of readers of buffers
+ * @details readers of the vmx-root buffers might be in vmx non-root (DPCs) or
+ * in vmx-root, so our customized HIGH_IRQL Spinlock is used for both of them
+ * @param IsVmxRoot Whether the vmx-root buffers are read or not
+ * @param OldIrql The previous IRQL (if raised)
+ *
+ * @return BOOLEAN Whether the IRQL is raised or not
+ */
+BOOLEAN
+LogAcquireReaderLock(BOOLEAN IsVmxRoot, KIRQL * OldIrql)
+{
+    BOOLEAN IrqlRaised = FALSE;
+
+    if (!LogCheckVmxOperation())
+    {
+        //
+        // vmx non-root, avoid being scheduled while holding the lock
+        //
+        *OldIrql   = KeRaiseIrqlToDpcLevel();
+        IrqlRaised = TRUE;
+    }
+
+    SpinlockLock(LogGetReaderLock(IsVmxRoot));
+
+    return IrqlRaised;
+}
+
+/**
+ * @brief Release the lock of readers of buffers
+ * @param IsVmxRoot Whether the vmx-root buffers are read or not
+ * @param IrqlRaised Whether the IRQL is raised or not
+ * @param OldIrql The previous IRQL
+ *
+ * @return VOID
+ */
+VOID
+LogReleaseReaderLock(BOOLEAN IsVmxRoot, BOOLEAN IrqlRaised, KIRQL OldIrql)
+{
+    SpinlockUnlock(LogGetReaderLock(IsVmxRoot));
+
+    if (IrqlRaised)
+    {
+        KeLowerIrql(OldIrql);
+    }
+}
+
+/**
+ * @brief Get the smallest power of two that is not less than the value
+ * @param Value
+ *
+ * @return UINT32
+ */
+UINT32
+LogRoundUpToPowerOfTwo(UINT32 Value)
+{
+    UINT32 Result = 1;
+
+    while (Result < Value)
+    {
+        Result <<= 1;
+    }
+
+    return Result;
+}
+
 /**
  * @brief Initialize the buffer relating to log message tracing
  * @param MsgTracingCallbacks specify the callbacks
+ * @param Configuration the capacity of buffers (optional)
  *
  * @return BOOLEAN
  */
 BOOLEAN
-LogInitialize(MESSAGE_TRACING_CALLBACKS * MsgTracingCallbacks)
+LogInitialize(MESSAGE_TRACING_CALLBACKS * MsgTracingCallbacks, LOG_BUFFER_CONFIGURATION * Configuration)
 {
-    ULONG CoreCount = 0;
+    ULONG  CoreCount = 0;
+    UINT32 PacketsCapacity;
+    UINT32 PacketsCapacityPriority;
 
     CoreCount = KeQueryActiveProcessorCount(0);
 
+    //
+    // Each core has its own buffers, by default the total capacity of the regular
+    // buffers is (almost) the same as MaximumPacketsCapacity but each core has at
+    // least LogMinimumPacketsCapacityPerCore chunks, the capacities are rounded up
+    // to a power of two so the free-running indexes can be masked
+    //
+    if (Configuration != NULL && Configuration->PacketsCapacityPerCore != 0)
+    {
+        PacketsCapacity = Configuration->PacketsCapacityPerCore;
+    }
+    else
+    {
+        PacketsCapacity = MaximumPacketsCapacity / CoreCount;
+    }
+
+    if (Configuration != NULL && Configuration->PacketsCapacityPriorityPerCore != 0)
+    {
+        PacketsCapacityPriority = Configuration->PacketsCapacityPriorityPerCore;
+    }
+    else
+    {
+        PacketsCapacityPriority = MaximumPacketsCapacityPriority;
+    }
+
+    if (PacketsCapacity < LogMinimumPacketsCapacityPerCore)
+    {
+        PacketsCapacity = LogMinimumPacketsCapacityPerCore;
+    }
+
+    if (PacketsCapacity > LogMaximumPacketsCapacityPerCore)
+    {
+        PacketsCapacity = LogMaximumPacketsCapacityPerCore;
+    }
+
+    if (PacketsCapacityPriority > LogMaximumPacketsCapacityPerCore)
+    {
+        PacketsCapacityPriority = LogMaximumPacketsCapacityPerCore;
+    }
+
+    PacketsCapacity         = LogRoundUpToPowerOfTwo(PacketsCapacity);
+    PacketsCapacityPriority = LogRoundUpToPowerOfTwo(PacketsCapacityPriority);
+
+    //
+    // Regular buffers are grown (doubled) up to the maximum capacity
+    //
+    LogMaximumPacketsCapacity = 0;
+
+    if (Configuration != NULL && Configuration->MaximumPacketsCapacityPerCore > PacketsCapacity)
+    {
+        LogMaximumPacketsCapacity = Configuration->MaximumPacketsCapacityPerCore;
+
+        if (LogMaximumPacketsCapacity > LogMaximumPacketsCapacityPerCore)
+        {
+            LogMaximumPacketsCapacity = LogMaximumPacketsCapacityPerCore;
+        }
+
+        LogMaximumPacketsCapacity = LogRoundUpToPowerOfTwo(LogMaximumPacketsCapacity);
+    }
+
     //
     // Initialize buffers for trace message and data messages
-    //(we have two buffers one for vmx root and one for vmx non-root)
+    //(we have two buffers for each core, one for vmx root and one for vmx non-root)
     //
-    MessageBufferInformation = ExAllocatePoolWithTag(NonPagedPool, sizeof(LOG_BUFFER_INFORMATION) * 2, POOLTAG);
+    MessageBufferInformation = ExAllocatePoolWithTag(NonPagedPool, sizeof(LOG_BUFFER_INFORMATION) * 2 * CoreCount, POOLTAG);
 
     if (!MessageBufferInformation)
     {
@@ -126,7 +278,28 @@ LogInitialize(MESSAGE_TRACING_CALLBACKS * MsgTracingCallbacks)
     //
     // Zeroing the memory
     //
-    RtlZeroMemory(MessageBufferInformation, sizeof(LOG_BUFFER_INFORMATION) * 2);
+    RtlZeroMemory(MessageBufferInformation, sizeof(LOG_BUFFER_INFORMATION) * 2 * CoreCount);
+
+    LogCoreCount = CoreCount;
+
+    //
+    // Allocate the indexes of buffers, the size is rounded up to pages so the
+    // allocation is page aligned and it can be mapped into the user-mode, the
+    // notification page of the shared buffers is allocated after the indexes
+    //
+    LogRingIndexesSize = (UINT32)ROUND_TO_PAGES(sizeof(LOG_RING_INDEXES) * 4 * CoreCount);
+    LogRingIndexes     = ExAllocatePoolWithTag(NonPagedPool, LogRingIndexesSize + PAGE_SIZE, POOLTAG);
+
+    if (!LogRingIndexes)
+    {
+        ExFreePoolWithTag(MessageBufferInformation, POOLTAG);
+        MessageBufferInformation = NULL;
+        return FALSE; // STATUS_INSUFFICIENT_RESOURCES
+    }
+
+    RtlZeroMemory(LogRingIndexes, LogRingIndexesSize + PAGE_SIZE);
+
+    LogSharedNotification = (PLOG_SHARED_NOTIFICATION)((CHAR *)LogRingIndexes + LogRingIndexesSize);
 
     //
     // Allocate VmxTempMessage and VmxLogMessage
@@ -138,6 +311,9 @@ LogInitialize(MESSAGE_TRACING_CALLBACKS * MsgTracingCallbacks)
     {
         ExFreePoolWithTag(MessageBufferInformation, POOLTAG);
         MessageBufferInformation = NULL;
+
+        ExFreePoolWithTag(LogRingIndexes, POOLTAG);
+        LogRingIndexes = NULL;
         return FALSE; // STATUS_INSUFFICIENT_RESOURCES
     }
 
@@ -149,6 +325,9 @@ LogInitialize(MESSAGE_TRACING_CALLBACKS * MsgTracingCallbacks)
         ExFreePoolWithTag(MessageBufferInformation, POOLTAG);
         MessageBufferInformation = NULL;
 
+        ExFreePoolWithTag(LogRingIndexes, POOLTAG);
+        LogRingIndexes = NULL;
+
         ExFreePoolWithTag(VmxTempMessage, POOLTAG);
         VmxTempMessage = NULL;
 
@@ -156,28 +335,27 @@ LogInitialize(MESSAGE_TRACING_CALLBACKS * MsgTracingCallbacks)
     }
 
     //
-    // Initialize the lock for Vmx-root mode (HIGH_IRQL Spinlock)
+    // Initialize the locks of readers (HIGH_IRQL Spinlock)
     //
-    VmxRootLoggingLock = 0;
+    VmxRootLoggingReaderLock    = 0;
+    VmxNonRootLoggingReaderLock = 0;
 
     //
     // Allocate buffer for messages and initialize the core buffer information
     //
-    for (int i = 0; i < 2; i++)
+    for (ULONG i = 0; i < CoreCount * 2; i++)
     {
         //
-        // initialize the lock
-        // Actually, only the 0th buffer use this spinlock but let initialize it
-        // for both but the second buffer spinlock is useless
-        // as we use our custom spinlock
+        // Set the indexes of the regular and priority buffers
         //
-        KeInitializeSpinLock(&MessageBufferInformation[i].BufferLock);
-        KeInitializeSpinLock(&MessageBufferInformation[i].BufferLockForNonImmMessage);
+        MessageBufferInformation[i].Indexes         = &LogRingIndexes[i * 2];
+        MessageBufferInformation[i].IndexesPriority = &LogRingIndexes[i * 2 + 1];
 
         //
         // allocate the buffer for regular buffers
         //
-        MessageBufferInformation[i].BufferStartAddress                   = ExAllocatePoolWithTag(NonPagedPool, LogBufferSize, POOLTAG);
+        MessageBufferInformation[i].PacketsCapacity                      = PacketsCapacity;
+        MessageBufferInformation[i].BufferStartAddress                   = ExAllocatePoolWithTag(NonPagedPool, PacketsCapacity * (PacketChunkSize + sizeof(BUFFER_HEADER)), POOLTAG);
         MessageBufferInformation[i].BufferForMultipleNonImmediateMessage = ExAllocatePoolWithTag(NonPagedPool, PacketChunkSize, POOLTAG);
 
         if (!MessageBufferInformation[i].BufferStartAddress ||
@@ -189,7 +367,8 @@ LogInitialize(MESSAGE_TRACING_CALLBACKS * MsgTracingCallbacks)
         //
         // allocate the buffer for priority buffers
         //
-        MessageBufferInformation[i].BufferStartAddressPriority = ExAllocatePoolWithTag(NonPagedPool, LogBufferSizePriority, POOLTAG);
+        MessageBufferInformation[i].PacketsCapacityPriority    = PacketsCapacityPriority;
+        MessageBufferInformation[i].BufferStartAddressPriority = ExAllocatePoolWithTag(NonPagedPool, PacketsCapacityPriority * (PacketChunkSize + sizeof(BUFFER_HEADER)), POOLTAG);
 
         if (!MessageBufferInformation[i].BufferStartAddressPriority)
         {
@@ -199,15 +378,15 @@ LogInitialize(MESSAGE_TRACING_CALLBACKS * MsgTracingCallbacks)
         //
         // Zeroing the buffer
         //
-        RtlZeroMemory(MessageBufferInformation[i].BufferStartAddress, LogBufferSize);
+        RtlZeroMemory(MessageBufferInformation[i].BufferStartAddress, PacketsCapacity * (PacketChunkSize + sizeof(BUFFER_HEADER)));
         RtlZeroMemory(MessageBufferInformation[i].BufferForMultipleNonImmediateMessage, PacketChunkSize);
-        RtlZeroMemory(MessageBufferInformation[i].BufferStartAddressPriority, LogBufferSizePriority);
+        RtlZeroMemory(MessageBufferInformation[i].BufferStartAddressPriority, PacketsCapacityPriority * (PacketChunkSize + sizeof(BUFFER_HEADER)));
 
         //
         // Set the end address
         //
-        MessageBufferInformation[i].BufferEndAddress         = (UINT64)MessageBufferInformation[i].BufferStartAddress + LogBufferSize;
-        MessageBufferInformation[i].BufferEndAddressPriority = (UINT64)MessageBufferInformation[i].BufferStartAddressPriority + LogBufferSizePriority;
+        MessageBufferInformation[i].BufferEndAddress         = (UINT64)MessageBufferInformation[i].BufferStartAddress + PacketsCapacity * (PacketChunkSize + sizeof(BUFFER_HEADER));
+        MessageBufferInformation[i].BufferEndAddressPriority = (UINT64)MessageBufferInformation[i].BufferStartAddressPriority + PacketsCapacityPriority * (PacketChunkSize + sizeof(BUFFER_HEADER));
     }
 
     //
@@ -227,9 +406,9 @@ VOID
 LogUnInitialize()
 {
     //
-    // de-allocate buffer for messages and initialize the core buffer information (for vmx-root core)
+    // de-allocate buffer for messages and initialize the core buffer information (for all cores)
     //
-    for (int i = 0; i < 2; i++)
+    for (ULONG i = 0; i < LogCoreCount * 2; i++)
     {
         //
         // Free each buffers
@@ -237,6 +416,19 @@ LogUnInitialize()
         ExFreePoolWithTag(MessageBufferInformation[i].BufferStartAddress, POOLTAG);
         ExFreePoolWithTag(MessageBufferInformation[i].BufferStartAddressPriority, POOLTAG);
         ExFreePoolWithTag(MessageBufferInformation[i].BufferForMultipleNonImmediateMessage, POOLTAG);
+
+        //
+        // Free the buffers that are allocated for growing the buffers (if any)
+        //
+        if (MessageBufferInformation[i].PendingBuffer != NULL)
+        {
+            ExFreePoolWithTag(MessageBufferInformation[i].PendingBuffer, POOLTAG);
+        }
+
+        if (MessageBufferInformation[i].RetiredBuffer != NULL)
+        {
+            ExFreePoolWithTag(MessageBufferInformation[i].RetiredBuffer, POOLTAG);
+        }
     }
 
     //
@@ -244,10 +436,129 @@ LogUnInitialize()
     //
     ExFreePoolWithTag(MessageBufferInformation, POOLTAG);
     MessageBufferInformation = NULL;
+    LogCoreCount             = 0;
+
+    ExFreePoolWithTag(LogRingIndexes, POOLTAG);
+    LogRingIndexes        = NULL;
+    LogSharedNotification = NULL;
+}
+
+/**
+ * @brief Notify the thread that waits for messages (if any)
+ *
+ * @param IsVmxRoot Whether the message is saved in the vmx-root buffers
+ * @return VOID
+ */
+VOID
+LogNotifyWaitingThread(BOOLEAN IsVmxRoot)
+{
+    PNOTIFY_RECORD NotifyRecord;
+
+    //
+    // check if there is any thread in IRP Pending state, so we can complete their request,
+    // only one of the producers takes the record so the DPC is queued once
+    //
+    if (g_GlobalNotifyRecord == NULL)
+    {
+        return;
+    }
+
+    NotifyRecord = InterlockedExchangePointer((PVOID volatile *)&g_GlobalNotifyRecord, NULL);
+
+    if (NotifyRecord != NULL)
+    {
+        //
+        // set the target pool
+        //
+        NotifyRecord->CheckVmxRootMessagePool = IsVmxRoot;
+
+        //
+        // Insert dpc to queue
+        //
+        KeInsertQueueDpc(&NotifyRecord->Dpc, NotifyRecord, NULL);
+    }
+}
+
+/**
+ * @brief Signal the event of the user-mode consumer of the shared buffers (if any)
+ * @details the event is only signaled once the rings become non-empty for the
+ * consumer (it has consumed all of the previous sequences), while the consumer
+ * is still reading, it sees the new message without any signal, also only one
+ * DPC is queued until the DPC runs
+ *
+ * @return VOID
+ */
+VOID
+LogSignalSharedMemoryConsumer()
+{
+    LONG64 Sequence;
+
+    if (!g_LogSharedMemory.IsMapped)
+    {
+        return;
+    }
+
+    //
+    // The message is already published, the interlocked increment orders reading
+    // the consumed sequence after publishing the message
+    //
+    Sequence = InterlockedIncrement64(&LogSharedNotification->PublishedSequence);
+
+    if (Sequence - 1 != LogSharedNotification->ConsumedSequence)
+    {
+        return;
+    }
+
+    if (InterlockedExchange(&g_LogSharedMemory.SignalPending, TRUE) == FALSE)
+    {
+        KeInsertQueueDpc(&g_LogSharedMemory.Dpc, NULL, NULL);
+    }
+}
+
+/**
+ * @brief Replace the regular buffer of the current core with the pending buffer
+ * @details the caller is the producer of the buffer and there should be no unread
+ * chunk in the buffer, so the reader never uses the previous buffer after the next
+ * chunk is published, the buffer is not replaced if it's mapped into the user-mode
+ *
+ * @param BufferInformation The buffer of the current core
+ * @return VOID
+ */
+VOID
+LogGrowBufferIfPending(PLOG_BUFFER_INFORMATION BufferInformation)
+{
+    PVOID NewBuffer;
+
+    //
+    // The mapper checks this flag after marking the buffers as mapped (and we check
+    // the mapping after setting the flag), so the buffers are never replaced while
+    // they're being mapped
+    //
+    InterlockedExchange(&BufferInformation->Growing, TRUE);
+
+    if (!g_LogSharedMemory.InUse)
+    {
+        NewBuffer = InterlockedExchangePointer(&BufferInformation->PendingBuffer, NULL);
+
+        if (NewBuffer != NULL)
+        {
+            InterlockedExchangePointer(&BufferInformation->RetiredBuffer, (PVOID)BufferInformation->BufferStartAddress);
+
+            BufferInformation->PacketsCapacity    = BufferInformation->PendingPacketsCapacity;
+            BufferInformation->BufferStartAddress = (UINT64)NewBuffer;
+            BufferInformation->BufferEndAddress   = (UINT64)NewBuffer + BufferInformation->PacketsCapacity * (PacketChunkSize + sizeof(BUFFER_HEADER));
+        }
+    }
+
+    InterlockedExchange(&BufferInformation->Growing, FALSE);
 }
 
 /**
  * @brief Save buffer to the pool
+ * @details the buffer is saved in the buffer of the current core, the only producer
+ * of this buffer is the current core (in vmx-root, interrupts are disabled and in vmx
+ * non-root, the IRQL is raised to HIGH_LEVEL) so there is no need to take any lock and
+ * the message is published by incrementing the write index
  *
  * @param OperationCode The operation code that will be send to user mode
  * @param Buffer Buffer to be send to user mode
@@ -260,9 +571,13 @@ _Use_decl_annotations_
 BOOLEAN
 LogCallbackSendBuffer(UINT32 OperationCode, PVOID Buffer, UINT32 BufferLength, BOOLEAN Priority)
 {
-    KIRQL   OldIRQL;
-    UINT32  Index;
-    BOOLEAN IsVmxRoot;
+    KIRQL                   OldIRQL;
+    BOOLEAN                 IsVmxRoot;
+    PLOG_BUFFER_INFORMATION BufferInformation;
+    UINT32                  IndexToWrite;
+    UINT32                  IndexToSend;
+    UINT32                  PacketsCapacity;
+    UINT64                  StartAddress;
 
     if (BufferLength > PacketChunkSize - 1 || BufferLength == 0)
     {
@@ -321,157 +636,151 @@ LogCallbackSendBuffer(UINT32 OperationCode, PVOID Buffer, UINT32 BufferLength, B
     }
 
     //
-    // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
-    // if not we use the windows spinlock
+    // In vmx non-root, the IRQL is raised to HIGH_LEVEL so no other producer (thread,
+    // DPC or ISR) runs on this core until the message is published, in vmx-root
+    // RFLAGS.IF is cleared so we're already the only producer of the vmx-root buffer
     //
-    if (IsVmxRoot)
+    if (!IsVmxRoot)
     {
-        //
-        // Set the index
-        //
-        Index = 1;
-        SpinlockLock(&VmxRootLoggingLock);
+        KeRaiseIrql(HIGH_LEVEL, &OldIRQL);
     }
-    else
-    {
-        //
-        // Set the index
-        //
-        Index = 0;
 
-        //
-        // Acquire the lock
-        //
-        KeAcquireSpinLock(&MessageBufferInformation[Index].BufferLock, &OldIRQL);
-    }
+    BufferInformation = LogGetBufferInformation(KeGetCurrentProcessorNumber(), IsVmxRoot);
 
     //
-    // check if the buffer is filled to it's maximum index or not
+    // Replace the regular buffer with a larger buffer (if it's allocated), it's
+    // only possible when there is no unread chunk in the buffer
     //
+    if (!Priority && BufferInformation->PendingBuffer != NULL &&
+        BufferInformation->Indexes->CurrentIndexToWrite == BufferInformation->Indexes->CurrentIndexToSend)
+    {
+        LogGrowBufferIfPending(BufferInformation);
+    }
+
     if (Priority)
     {
-        if (MessageBufferInformation[Index].CurrentIndexToWritePriority > MaximumPacketsCapacityPriority - 1)
-        {
-            //
-            // start from the beginning
-            //
-            MessageBufferInformation[Index].CurrentIndexToWritePriority = 0;
-        }
+        IndexToWrite    = BufferInformation->IndexesPriority->CurrentIndexToWrite;
+        IndexToSend     = BufferInformation->IndexesPriority->CurrentIndexToSend;
+        PacketsCapacity = BufferInformation->PacketsCapacityPriority;
+        StartAddress    = BufferInformation->BufferStartAddressPriority;
     }
     else
     {
-        if (MessageBufferInformation[Index].CurrentIndexToWrite > MaximumPacketsCapacity - 1)
+        IndexToWrite    = BufferInformation->Indexes->CurrentIndexToWrite;
+        IndexToSend     = BufferInformation->Indexes->CurrentIndexToSend;
+        PacketsCapacity = BufferInformation->PacketsCapacity;
+        StartAddress    = BufferInformation->BufferStartAddress;
+    }
+
+    //
+    // check if the buffer is filled to it's maximum capacity or not, the chunks
+    // that are not read yet are never overwritten
+    //
+    if (IndexToWrite - IndexToSend >= PacketsCapacity)
+    {
+        //
+        // Only the owner core modifies the statistics of its buffers
+        //
+        if (Priority)
         {
-            //
-            // start from the beginning
-            //
-            MessageBufferInformation[Index].CurrentIndexToWrite = 0;
+            BufferInformation->DroppedMessagesPriority++;
+        }
+        else
+        {
+            BufferInformation->DroppedMessages++;
+            BufferInformation->GrowthRequested = TRUE;
+        }
+
+        if (!IsVmxRoot)
+        {
+            KeLowerIrql(OldIRQL);
         }
+
+        return FALSE;
     }
 
     //
     // Compute the start of the buffer header
     //
-    BUFFER_HEADER * Header;
-
-    if (Priority)
-    {
-        Header = (BUFFER_HEADER *)((UINT64)MessageBufferInformation[Index].BufferStartAddressPriority + (MessageBufferInformation[Index].CurrentIndexToWritePriority * (PacketChunkSize + sizeof(BUFFER_HEADER))));
-    }
-    else
-    {
-        Header = (BUFFER_HEADER *)((UINT64)MessageBufferInformation[Index].BufferStartAddress + (MessageBufferInformation[Index].CurrentIndexToWrite * (PacketChunkSize + sizeof(BUFFER_HEADER))));
-    }
+    BUFFER_HEADER * Header = (BUFFER_HEADER *)(StartAddress + ((IndexToWrite & (PacketsCapacity - 1)) * (PacketChunkSize + sizeof(BUFFER_HEADER))));
 
     //
     // Set the header
     //
-    Header->OpeationNumber = OperationCode;
-    Header->BufferLength   = BufferLength;
-    Header->Valid          = TRUE;
+    Header->OpeationNumber   = OperationCode;
+    Header->BufferLength     = BufferLength;
+    Header->Timestamp        = __rdtsc() - BufferInformation->TscOffset;
+    Header->TriggerTimestamp = BufferInformation->TriggerTimestamp;
 
     //
     // ******** Now it's time to fill the buffer ********
     //
 
     //
-    // compute the saving index
+    // Copy the buffer
     //
-    PVOID SavingBuffer;
-
-    if (Priority)
-    {
-        SavingBuffer = ((UINT64)MessageBufferInformation[Index].BufferStartAddressPriority + (MessageBufferInformation[Index].CurrentIndexToWritePriority * (PacketChunkSize + sizeof(BUFFER_HEADER))) + sizeof(BUFFER_HEADER));
-    }
-    else
-    {
-        SavingBuffer = ((UINT64)MessageBufferInformation[Index].BufferStartAddress + (MessageBufferInformation[Index].CurrentIndexToWrite * (PacketChunkSize + sizeof(BUFFER_HEADER))) + sizeof(BUFFER_HEADER));
-    }
+    RtlCopyBytes((PVOID)((UINT64)Header + sizeof(BUFFER_HEADER)), Buffer, BufferLength);
 
     //
-    // Copy the buffer
+    // Null-terminate the message so it can be used in place (by user-mode)
     //
-    RtlCopyBytes(SavingBuffer, Buffer, BufferLength);
+    *(CHAR *)((UINT64)Header + sizeof(BUFFER_HEADER) + BufferLength) = '\0';
 
     //
-    // Increment the next index to write
+    // Publish the chunk by incrementing the next index to write, the interlocked
+    // operation makes sure that the chunk is visible before the index
     //
     if (Priority)
     {
-        MessageBufferInformation[Index].CurrentIndexToWritePriority = MessageBufferInformation[Index].CurrentIndexToWritePriority + 1;
+        InterlockedExchange((volatile LONG *)&BufferInformation->IndexesPriority->CurrentIndexToWrite, IndexToWrite + 1);
+
+        if (IndexToWrite + 1 - IndexToSend > BufferInformation->HighWaterMarkPriority)
+        {
+            BufferInformation->HighWaterMarkPriority = IndexToWrite + 1 - IndexToSend;
+        }
     }
     else
     {
-        MessageBufferInformation[Index].CurrentIndexToWrite = MessageBufferInformation[Index].CurrentIndexToWrite + 1;
-    }
-
-    //
-    // check if there is any thread in IRP Pending state, so we can complete their request
-    //
-    if (g_GlobalNotifyRecord != NULL)
-    {
-        //
-        // there is some threads that needs to be completed
-        //
-
-        //
-        // set the target pool
-        //
-        g_GlobalNotifyRecord->CheckVmxRootMessagePool = IsVmxRoot;
+        InterlockedExchange((volatile LONG *)&BufferInformation->Indexes->CurrentIndexToWrite, IndexToWrite + 1);
 
-        //
-        // Insert dpc to queue
-        //
-        KeInsertQueueDpc(&g_GlobalNotifyRecord->Dpc, g_GlobalNotifyRecord, NULL);
+        if (IndexToWrite + 1 - IndexToSend > BufferInformation->HighWaterMark)
+        {
+            BufferInformation->HighWaterMark = IndexToWrite + 1 - IndexToSend;
+        }
 
         //
-        // set notify routine to null
+        // Ask for a larger buffer if three quarters of the buffer is used
         //
-        g_GlobalNotifyRecord = NULL;
+        if (LogMaximumPacketsCapacity > PacketsCapacity &&
+            IndexToWrite + 1 - IndexToSend >= PacketsCapacity - (PacketsCapacity / 4))
+        {
+            BufferInformation->GrowthRequested = TRUE;
+        }
     }
 
     //
-    // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
-    // if not we use the windows spinlock
+    // Signal the user-mode consumer of the shared buffers (if any), it's done before
+    // lowering the IRQL so the DPC is queued before the buffers can be unmapped
     //
-    if (IsVmxRoot)
-    {
-        SpinlockUnlock(&VmxRootLoggingLock);
-    }
-    else
+    LogSignalSharedMemoryConsumer();
+
+    if (!IsVmxRoot)
     {
-        //
-        // Release the lock
-        //
-        KeReleaseSpinLock(&MessageBufferInformation[Index].BufferLock, OldIRQL);
+        KeLowerIrql(OldIRQL);
     }
 
-    return TRUE;
-}
-
+    //
+    // check if there is any thread in IRP Pending state, so we can complete their request
+    //
+    LogNotifyWaitingThread(IsVmxRoot);
+
+    return TRUE;
+}
+
 /**
  * @brief Mark all buffers as read
- * @details Priority buffers won't be set as read
+ * @details Priority buffers won't be set as read, the buffers that are shared
+ * with the user-mode are only released by their consumer so they're not flushed
  *
  * @param IsVmxRoot Determine whether you want to read vmx root buffer or vmx non root buffer
  * @return UINT32 return count of messages that set to invalid
@@ -479,135 +788,386 @@ LogCallbackSendBuffer(UINT32 OperationCode, PVOID Buffer, UINT32 BufferLength, B
 UINT32
 LogMarkAllAsRead(BOOLEAN IsVmxRoot)
 {
-    KIRQL  OldIRQL;
-    UINT32 Index;
-    UINT32 ResultsOfBuffersSetToRead = 0;
+    KIRQL                   OldIRQL;
+    BOOLEAN                 IrqlRaised;
+    PLOG_BUFFER_INFORMATION BufferInformation;
+    UINT32                  IndexToWrite;
+    UINT32                  ResultsOfBuffersSetToRead = 0;
 
     //
-    // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
-    // if not we use the windows spinlock
+    // Only readers are serialized, producers continue writing to their buffers
+    //
+    IrqlRaised = LogAcquireReaderLock(IsVmxRoot, &OldIRQL);
+
     //
-    if (IsVmxRoot)
+    // The consumer of the shared buffers might still be parsing the chunks
+    // after the send index, so the producers shouldn't reuse them
+    //
+    if (g_LogSharedMemory.InUse)
     {
-        //
-        // Set the index
-        //
-        Index = 1;
+        LogReleaseReaderLock(IsVmxRoot, IrqlRaised, OldIRQL);
 
-        //
-        // Acquire the lock
-        //
-        SpinlockLock(&VmxRootLoggingLock);
+        return 0;
     }
-    else
+
+    //
+    // We have iterate through the buffers of all cores
+    //
+    for (ULONG i = 0; i < LogCoreCount; i++)
     {
-        //
-        // Set the index
-        //
-        Index = 0;
+        BufferInformation = LogGetBufferInformation(i, IsVmxRoot);
+        IndexToWrite      = BufferInformation->Indexes->CurrentIndexToWrite;
 
         //
-        // Acquire the lock
+        // All of the published chunks are set as read
         //
-        KeAcquireSpinLock(&MessageBufferInformation[Index].BufferLock, &OldIRQL);
+        BufferInformation->DiscardedMessages += IndexToWrite - BufferInformation->Indexes->CurrentIndexToSend;
+        ResultsOfBuffersSetToRead += IndexToWrite - BufferInformation->Indexes->CurrentIndexToSend;
+
+        InterlockedExchange((volatile LONG *)&BufferInformation->Indexes->CurrentIndexToSend, IndexToWrite);
     }
 
+    LogReleaseReaderLock(IsVmxRoot, IrqlRaised, OldIRQL);
+
+    return ResultsOfBuffersSetToRead;
+}
+
+/**
+ * @brief Allocate the larger buffers that are requested by the producers and
+ * free the replaced buffers
+ * @details should be called in PASSIVE_LEVEL, the larger buffers are picked up
+ * by the producers (even in vmx-root) once their buffers are empty
+ *
+ * @return VOID
+ */
+VOID
+LogCheckAndPerformAllocationAndDeallocation()
+{
+    PLOG_BUFFER_INFORMATION BufferInformation;
+    PVOID                   Buffer;
+    UINT32                  NewPacketsCapacity;
+
     //
-    // We have iterate through the all indexes
+    // IOCTLs might be dispatched simultaneously, only one of them checks the buffers
     //
-    for (size_t i = 0; i < MaximumPacketsCapacity; i++)
+    if (InterlockedCompareExchange(&LogBuffersAllocationLock, TRUE, FALSE) != FALSE)
     {
+        return;
+    }
+
+    for (ULONG i = 0; i < LogCoreCount * 2; i++)
+    {
+        BufferInformation = &MessageBufferInformation[i];
+
         //
-        // Compute the current buffer to read
+        // Free the previous buffer (if replaced)
         //
-        BUFFER_HEADER * Header = (BUFFER_HEADER *)((UINT64)MessageBufferInformation[Index].BufferStartAddress +
-                                                   (MessageBufferInformation[Index].CurrentIndexToSend *
-                                                    (PacketChunkSize + sizeof(BUFFER_HEADER))));
+        Buffer = InterlockedExchangePointer(&BufferInformation->RetiredBuffer, NULL);
 
-        if (!Header->Valid)
+        if (Buffer != NULL)
         {
-            //
-            // there is nothing to send
-            //
-
-            //
-            // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
-            // if not we use the windows spinlock
-            //
-            if (IsVmxRoot)
-            {
-                SpinlockUnlock(&VmxRootLoggingLock);
-            }
-            else
-            {
-                //
-                // Release the lock
-                //
-                KeReleaseSpinLock(&MessageBufferInformation[Index].BufferLock, OldIRQL);
-            }
+            ExFreePoolWithTag(Buffer, POOLTAG);
+        }
 
-            return ResultsOfBuffersSetToRead;
+        if (!BufferInformation->GrowthRequested ||
+            BufferInformation->PendingBuffer != NULL ||
+            g_LogSharedMemory.InUse ||
+            BufferInformation->PacketsCapacity >= LogMaximumPacketsCapacity)
+        {
+            continue;
         }
 
         //
-        // If we reached here, means that there is sth to send
+        // Double the capacity of the buffer
         //
-        ResultsOfBuffersSetToRead++;
+        NewPacketsCapacity = BufferInformation->PacketsCapacity * 2;
 
-        //
-        // Second, save the buffer contents
-        //
-        PVOID SendingBuffer = ((UINT64)MessageBufferInformation[Index].BufferStartAddress + (MessageBufferInformation[Index].CurrentIndexToSend * (PacketChunkSize + sizeof(BUFFER_HEADER))) + sizeof(BUFFER_HEADER));
+        Buffer = ExAllocatePoolWithTag(NonPagedPool, NewPacketsCapacity * (PacketChunkSize + sizeof(BUFFER_HEADER)), POOLTAG);
 
-        //
-        // Finally, set the current index to invalid as we sent it
-        //
-        Header->Valid = FALSE;
+        if (Buffer == NULL)
+        {
+            continue;
+        }
 
-        //
-        // Last step is to clear the current buffer (we can't do it once when CurrentIndexToSend is zero because
-        // there might be multiple messages on the start of the queue that didn't read yet)
-        // we don't free the header
-        //
-        RtlZeroMemory(SendingBuffer, Header->BufferLength);
+        RtlZeroMemory(Buffer, NewPacketsCapacity * (PacketChunkSize + sizeof(BUFFER_HEADER)));
 
-        //
-        // Check to see whether we passed the index or not
-        //
-        if (MessageBufferInformation[Index].CurrentIndexToSend > MaximumPacketsCapacity - 2)
+        BufferInformation->GrowthRequested        = FALSE;
+        BufferInformation->PendingPacketsCapacity = NewPacketsCapacity;
+
+        InterlockedExchangePointer(&BufferInformation->PendingBuffer, Buffer);
+    }
+
+    InterlockedExchange(&LogBuffersAllocationLock, FALSE);
+}
+
+/**
+ * @brief Query the statistics of the buffers of all cores
+ * @details buffers are in the same order as the rings of LOG_SHARED_BUFFERS
+ *
+ * @param Statistics The array to save the statistics
+ * @param MaximumCount The count of entries of the array
+ * @return UINT32 Count of buffers that their statistics are saved
+ */
+UINT32
+LogQueryBufferStatistics(PLOG_BUFFER_STATISTICS Statistics, UINT32 MaximumCount)
+{
+    PLOG_BUFFER_INFORMATION BufferInformation;
+
+    if (LogCoreCount * 4 > MaximumCount)
+    {
+        return 0;
+    }
+
+    for (ULONG i = 0; i < LogCoreCount * 2; i++)
+    {
+        BufferInformation = &MessageBufferInformation[i];
+
+        Statistics[i * 2].PacketsCapacity   = BufferInformation->PacketsCapacity;
+        Statistics[i * 2].HighWaterMark     = BufferInformation->HighWaterMark;
+        Statistics[i * 2].DroppedMessages   = BufferInformation->DroppedMessages;
+        Statistics[i * 2].DiscardedMessages = BufferInformation->DiscardedMessages;
+
+        Statistics[i * 2 + 1].PacketsCapacity   = BufferInformation->PacketsCapacityPriority;
+        Statistics[i * 2 + 1].HighWaterMark     = BufferInformation->HighWaterMarkPriority;
+        Statistics[i * 2 + 1].DroppedMessages   = BufferInformation->DroppedMessagesPriority;
+        Statistics[i * 2 + 1].DiscardedMessages = 0;
+    }
+
+    return LogCoreCount * 4;
+}
+
+/**
+ * @brief Query the size of the message buffers of all cores
+ * @details the pending buffers (for growing the buffers) are counted too
+ *
+ * @return UINT64 Size of the buffers (in bytes)
+ */
+UINT64
+LogQueryBuffersSize()
+{
+    PLOG_BUFFER_INFORMATION BufferInformation;
+    UINT64                  PacketsCount = 0;
+
+    if (MessageBufferInformation == NULL)
+    {
+        return 0;
+    }
+
+    for (ULONG i = 0; i < LogCoreCount * 2; i++)
+    {
+        BufferInformation = &MessageBufferInformation[i];
+
+        PacketsCount += BufferInformation->PacketsCapacity;
+        PacketsCount += BufferInformation->PacketsCapacityPriority;
+
+        if (BufferInformation->PendingBuffer != NULL)
         {
-            MessageBufferInformation[Index].CurrentIndexToSend = 0;
+            PacketsCount += BufferInformation->PendingPacketsCapacity;
+        }
+    }
+
+    return PacketsCount * (PacketChunkSize + sizeof(BUFFER_HEADER));
+}
+
+/**
+ * @brief Set the skew of the time-stamp counter of a core
+ * @details the skew is subtracted from the time-stamp counter of the messages
+ * of the core, so the messages of different cores are ordered by a single
+ * timeline, it's measured once (against the first core) while loading
+ *
+ * @param CoreId The core
+ * @param Offset The time-stamp counter of the core minus the one of the first core
+ * @return VOID
+ */
+VOID
+LogSetTscOffset(UINT32 CoreId, INT64 Offset)
+{
+    if (MessageBufferInformation == NULL || CoreId >= LogCoreCount)
+    {
+        return;
+    }
+
+    LogGetBufferInformation(CoreId, FALSE)->TscOffset = Offset;
+    LogGetBufferInformation(CoreId, TRUE)->TscOffset  = Offset;
+}
+
+/**
+ * @brief Read the time-stamp counter of the current core on the timeline of
+ * the messages (the skew of the core is removed)
+ * @details should be called in vmx-root or while the thread can't be moved
+ * to another core (DISPATCH_LEVEL or above)
+ *
+ * @return UINT64
+ */
+UINT64
+LogReadTimestamp()
+{
+    if (MessageBufferInformation == NULL)
+    {
+        return __rdtsc();
+    }
+
+    return __rdtsc() - LogGetBufferInformation(KeGetCurrentProcessorNumber(), FALSE)->TscOffset;
+}
+
+/**
+ * @brief Set the time-stamp counter of the event that is being triggered on
+ * the current core
+ * @details messages that are saved in the vmx-root buffer of the core are
+ * stamped with this time-stamp counter until it's changed, it's ignored in
+ * vmx non-root as the thread might be moved to another core
+ *
+ * @param Timestamp The time-stamp counter (or zero once the event is handled)
+ * @return UINT64 The previous time-stamp counter (for nested events)
+ */
+UINT64
+LogSetEventTriggerTimestamp(UINT64 Timestamp)
+{
+    PLOG_BUFFER_INFORMATION BufferInformation;
+    UINT64                  PreviousTimestamp;
+
+    if (MessageBufferInformation == NULL || !LogCheckVmxOperation())
+    {
+        return 0;
+    }
+
+    BufferInformation = LogGetBufferInformation(KeGetCurrentProcessorNumber(), TRUE);
+
+    PreviousTimestamp                   = BufferInformation->TriggerTimestamp;
+    BufferInformation->TriggerTimestamp = Timestamp;
+
+    return PreviousTimestamp;
+}
+
+/**
+ * @brief Find the oldest published message of the buffers of all cores
+ *
+ * @param IsVmxRoot Determine whether you want to read vmx root buffer or vmx non root buffer
+ * @param Priority Whether the priority buffers are checked
+ * @param CoreId The core that its buffer contains the message
+ * @return BUFFER_HEADER * The header of the message or NULL if there is no message
+ */
+BUFFER_HEADER *
+LogFindOldestMessage(BOOLEAN IsVmxRoot, BOOLEAN Priority, ULONG * CoreId)
+{
+    PLOG_BUFFER_INFORMATION BufferInformation;
+    BUFFER_HEADER *         Header;
+    BUFFER_HEADER *         OldestHeader = NULL;
+    UINT32                  IndexToSend;
+
+    for (ULONG i = 0; i < LogCoreCount; i++)
+    {
+        BufferInformation = LogGetBufferInformation(i, IsVmxRoot);
+
+        if (Priority)
+        {
+            IndexToSend = BufferInformation->IndexesPriority->CurrentIndexToSend;
+
+            if (IndexToSend == BufferInformation->IndexesPriority->CurrentIndexToWrite)
+            {
+                continue;
+            }
+
+            Header = (BUFFER_HEADER *)(BufferInformation->BufferStartAddressPriority + ((IndexToSend & (BufferInformation->PacketsCapacityPriority - 1)) * (PacketChunkSize + sizeof(BUFFER_HEADER))));
         }
         else
         {
-            //
-            // Increment the next index to read
-            //
-            MessageBufferInformation[Index].CurrentIndexToSend = MessageBufferInformation[Index].CurrentIndexToSend + 1;
+            IndexToSend = BufferInformation->Indexes->CurrentIndexToSend;
+
+            if (IndexToSend == BufferInformation->Indexes->CurrentIndexToWrite)
+            {
+                continue;
+            }
+
+            Header = (BUFFER_HEADER *)(BufferInformation->BufferStartAddress + ((IndexToSend & (BufferInformation->PacketsCapacity - 1)) * (PacketChunkSize + sizeof(BUFFER_HEADER))));
+        }
+
+        if (OldestHeader == NULL || Header->Timestamp < OldestHeader->Timestamp)
+        {
+            OldestHeader = Header;
+            *CoreId      = i;
         }
     }
 
+    return OldestHeader;
+}
+
+/**
+ * @brief Give the chunk of the oldest message of a core back to the producer
+ * @details the caller should hold the lock of readers
+ *
+ * @param CoreId The core that its buffer contains the message
+ * @param IsVmxRoot Whether the message is in the vmx-root buffers
+ * @param Priority Whether the message is in the priority buffers
+ * @return VOID
+ */
+VOID
+LogMarkMessageAsSent(ULONG CoreId, BOOLEAN IsVmxRoot, BOOLEAN Priority)
+{
+    PLOG_BUFFER_INFORMATION BufferInformation = LogGetBufferInformation(CoreId, IsVmxRoot);
+
     //
-    // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
-    // if not we use the windows spinlock
+    // Increment the next index to read
     //
-    if (IsVmxRoot)
+    if (Priority)
     {
-        SpinlockUnlock(&VmxRootLoggingLock);
+        InterlockedIncrement((volatile LONG *)&BufferInformation->IndexesPriority->CurrentIndexToSend);
     }
     else
+    {
+        InterlockedIncrement((volatile LONG *)&BufferInformation->Indexes->CurrentIndexToSend);
+    }
+}
+
+#if ShowMessagesOnDebugger
+
+/**
+ * @brief Show the message on the debugger (DbgPrint)
+ *
+ * @param Header The header of the message
+ * @return VOID
+ */
+VOID
+LogShowMessageOnDebugger(BUFFER_HEADER * Header)
+{
+    PVOID SendingBuffer = (PVOID)((UINT64)Header + sizeof(BUFFER_HEADER));
+
+    //
+    // Means that show just messages
+    //
+    if (Header->OpeationNumber <= OPERATION_LOG_NON_IMMEDIATE_MESSAGE)
     {
         //
-        // Release the lock
+        // We're in Dpc level here so it's safe to use DbgPrint
+        // DbgPrint limitation is 512 Byte
         //
-        KeReleaseSpinLock(&MessageBufferInformation[Index].BufferLock, OldIRQL);
+        if (Header->BufferLength > DbgPrintLimitation)
+        {
+            for (size_t i = 0; i <= Header->BufferLength / DbgPrintLimitation; i++)
+            {
+                if (i != 0)
+                {
+                    DbgPrint("%s", (char *)((UINT64)SendingBuffer + (DbgPrintLimitation * i) - 2));
+                }
+                else
+                {
+                    DbgPrint("%s", (char *)((UINT64)SendingBuffer + (DbgPrintLimitation * i)));
+                }
+            }
+        }
+        else
+        {
+            DbgPrint("%s", (char *)SendingBuffer);
+        }
     }
-
-    return ResultsOfBuffersSetToRead;
 }
 
+#endif
+
 /**
  * @brief Attempt to read the buffer
+ * @details the oldest message of the buffers of all cores is read, the reader only
+ * advances the send index so the producers are never stalled
  *
  * @param IsVmxRoot Determine whether you want to read vmx root buffer or vmx non root buffer
  * @param BufferToSaveMessage Target buffer to save the message
@@ -619,36 +1179,23 @@ BOOLEAN
 LogReadBuffer(BOOLEAN IsVmxRoot, PVOID BufferToSaveMessage, UINT32 * ReturnedLength)
 {
     KIRQL   OldIRQL;
-    UINT32  Index;
+    BOOLEAN IrqlRaised;
+    ULONG   CoreId                     = 0;
     BOOLEAN PriorityMessageIsAvailable = FALSE;
 
     //
-    // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
-    // if not we use the windows spinlock
+    // Only readers are serialized, producers continue writing to their buffers
     //
-    if (IsVmxRoot)
-    {
-        //
-        // Set the index
-        //
-        Index = 1;
+    IrqlRaised = LogAcquireReaderLock(IsVmxRoot, &OldIRQL);
 
-        //
-        // Acquire the lock
-        //
-        SpinlockLock(&VmxRootLoggingLock);
-    }
-    else
+    //
+    // The shared buffers are only released by their consumer
+    //
+    if (g_LogSharedMemory.InUse)
     {
-        //
-        // Set the index
-        //
-        Index = 0;
+        LogReleaseReaderLock(IsVmxRoot, IrqlRaised, OldIRQL);
 
-        //
-        // Acquire the lock
-        //
-        KeAcquireSpinLock(&MessageBufferInformation[Index].BufferLock, &OldIRQL);
+        return FALSE;
     }
 
     //
@@ -659,36 +1206,21 @@ LogReadBuffer(BOOLEAN IsVmxRoot, PVOID BufferToSaveMessage, UINT32 * ReturnedLen
     //
     // Check for priority message
     //
-    Header = (BUFFER_HEADER *)((UINT64)MessageBufferInformation[Index].BufferStartAddressPriority + (MessageBufferInformation[Index].CurrentIndexToSendPriority * (PacketChunkSize + sizeof(BUFFER_HEADER))));
+    Header = LogFindOldestMessage(IsVmxRoot, TRUE, &CoreId);
 
-    if (!Header->Valid)
+    if (Header == NULL)
     {
         //
         // Check for regular message
         //
-        Header = (BUFFER_HEADER *)((UINT64)MessageBufferInformation[Index].BufferStartAddress + (MessageBufferInformation[Index].CurrentIndexToSend * (PacketChunkSize + sizeof(BUFFER_HEADER))));
+        Header = LogFindOldestMessage(IsVmxRoot, FALSE, &CoreId);
 
-        if (!Header->Valid)
+        if (Header == NULL)
         {
             //
             // there is nothing to send
             //
-
-            //
-            // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
-            // if not we use the windows spinlock
-            //
-            if (IsVmxRoot)
-            {
-                SpinlockUnlock(&VmxRootLoggingLock);
-            }
-            else
-            {
-                //
-                // Release the lock
-                //
-                KeReleaseSpinLock(&MessageBufferInformation[Index].BufferLock, OldIRQL);
-            }
+            LogReleaseReaderLock(IsVmxRoot, IrqlRaised, OldIRQL);
 
             return FALSE;
         }
@@ -710,121 +1242,151 @@ LogReadBuffer(BOOLEAN IsVmxRoot, PVOID BufferToSaveMessage, UINT32 * ReturnedLen
     //
     // Second, save the buffer contents
     //
-    PVOID SendingBuffer;
-
-    if (PriorityMessageIsAvailable)
-    {
-        SendingBuffer = ((UINT64)MessageBufferInformation[Index].BufferStartAddressPriority + (MessageBufferInformation[Index].CurrentIndexToSendPriority * (PacketChunkSize + sizeof(BUFFER_HEADER))) + sizeof(BUFFER_HEADER));
-    }
-    else
-    {
-        SendingBuffer = ((UINT64)MessageBufferInformation[Index].BufferStartAddress + (MessageBufferInformation[Index].CurrentIndexToSend * (PacketChunkSize + sizeof(BUFFER_HEADER))) + sizeof(BUFFER_HEADER));
-    }
+    PVOID SendingBuffer = (PVOID)((UINT64)Header + sizeof(BUFFER_HEADER));
 
     PVOID SavingAddress = ((UINT64)BufferToSaveMessage + sizeof(UINT32)); /* Because we want to pass the header of usermode header */
     RtlCopyBytes(SavingAddress, SendingBuffer, Header->BufferLength);
 
 #if ShowMessagesOnDebugger
+    LogShowMessageOnDebugger(Header);
+#endif
 
     //
-    // Means that show just messages
+    // Set the length to show as the ReturnedByted in usermode ioctl funtion + size of header
     //
-    if (Header->OpeationNumber <= OPERATION_LOG_NON_IMMEDIATE_MESSAGE)
-    {
-        //
-        // We're in Dpc level here so it's safe to use DbgPrint
-        // DbgPrint limitation is 512 Byte
-        //
-        if (Header->BufferLength > DbgPrintLimitation)
-        {
-            for (size_t i = 0; i <= Header->BufferLength / DbgPrintLimitation; i++)
-            {
-                if (i != 0)
-                {
-                    DbgPrint("%s", (char *)((UINT64)SendingBuffer + (DbgPrintLimitation * i) - 2));
-                }
-                else
-                {
-                    DbgPrint("%s", (char *)((UINT64)SendingBuffer + (DbgPrintLimitation * i)));
-                }
-            }
-        }
-        else
-        {
-            DbgPrint("%s", (char *)SendingBuffer);
-        }
-    }
-#endif
+    *ReturnedLength = Header->BufferLength + sizeof(UINT32);
 
     //
-    // Finally, set the current index to invalid as we sent it
+    // Finally, give the chunk back to the producer
     //
-    Header->Valid = FALSE;
+    LogMarkMessageAsSent(CoreId, IsVmxRoot, PriorityMessageIsAvailable);
+
+    LogReleaseReaderLock(IsVmxRoot, IrqlRaised, OldIRQL);
+
+    return TRUE;
+}
+
+/**
+ * @brief Read as many messages as fit in the buffer
+ * @details messages of both vmx-root and vmx non-root buffers of all cores are read,
+ * first the priority messages and then the regular messages (the oldest message first),
+ * each message is saved with a USERMODE_BATCHED_MESSAGE_HEADER
+ *
+ * @param BufferToSaveMessages Target buffer to save the messages
+ * @param BufferSize Size of the target buffer
+ * @param ReturnedLength The actual length of the buffer that this function used it
+ * @return BOOLEAN return of this function shows whether at least one message
+ * is read or not (e.g FALSE shows there's no new buffer available.)
+ */
+BOOLEAN
+LogReadBatchedBuffer(PVOID BufferToSaveMessages, UINT32 BufferSize, UINT32 * ReturnedLength)
+{
+    KIRQL                            OldIRQLNonRoot;
+    KIRQL                            OldIRQLRoot;
+    BOOLEAN                          IrqlRaisedNonRoot;
+    BOOLEAN                          IrqlRaisedRoot;
+    BUFFER_HEADER *                  Header;
+    BUFFER_HEADER *                  HeaderRoot;
+    ULONG                            CoreId;
+    ULONG                            CoreIdRoot;
+    BOOLEAN                          IsVmxRoot;
+    BOOLEAN                          Priority;
+    UINT32                           MessageSize;
+    UINT32                           Offset        = 0;
+    UINT64                           ReadTimestamp = LogReadTimestamp();
+    PUSERMODE_BATCHED_MESSAGE_HEADER MessageHeader;
 
     //
-    // Set the length to show as the ReturnedByted in usermode ioctl funtion + size of header
+    // Readers of both buffers are serialized (always in this order), producers
+    // continue writing to their buffers
     //
-    *ReturnedLength = Header->BufferLength + sizeof(UINT32);
+    IrqlRaisedNonRoot = LogAcquireReaderLock(FALSE, &OldIRQLNonRoot);
+    IrqlRaisedRoot    = LogAcquireReaderLock(TRUE, &OldIRQLRoot);
 
     //
-    // Last step is to clear the current buffer (we can't do it once when CurrentIndexToSend is zero because
-    // there might be multiple messages on the start of the queue that didn't read yet)
-    // we don't free the header
+    // The shared buffers are only released by their consumer
     //
-    RtlZeroMemory(SendingBuffer, Header->BufferLength);
-
-    if (PriorityMessageIsAvailable)
+    while (!g_LogSharedMemory.InUse)
     {
         //
-        // Check to see whether we passed the index or not
+        // Check for priority messages and then for regular messages
         //
-        if (MessageBufferInformation[Index].CurrentIndexToSendPriority > MaximumPacketsCapacityPriority - 2)
+        Priority = TRUE;
+
+        while (TRUE)
         {
-            MessageBufferInformation[Index].CurrentIndexToSendPriority = 0;
+            Header     = LogFindOldestMessage(FALSE, Priority, &CoreId);
+            HeaderRoot = LogFindOldestMessage(TRUE, Priority, &CoreIdRoot);
+            IsVmxRoot  = FALSE;
+
+            if (HeaderRoot != NULL && (Header == NULL || HeaderRoot->Timestamp < Header->Timestamp))
+            {
+                Header    = HeaderRoot;
+                CoreId    = CoreIdRoot;
+                IsVmxRoot = TRUE;
+            }
+
+            if (Header != NULL || !Priority)
+            {
+                break;
+            }
+
+            Priority = FALSE;
         }
-        else
+
+        if (Header == NULL)
         {
             //
-            // Increment the next index to read
+            // there is nothing else to send
             //
-            MessageBufferInformation[Index].CurrentIndexToSendPriority = MessageBufferInformation[Index].CurrentIndexToSendPriority + 1;
-        }
-    }
-    else
-    {
-        //
-        // Check to see whether we passed the index or not
-        //
-        if (MessageBufferInformation[Index].CurrentIndexToSend > MaximumPacketsCapacity - 2)
-        {
-            MessageBufferInformation[Index].CurrentIndexToSend = 0;
+            break;
         }
-        else
+
+        MessageSize = USERMODE_BATCHED_MESSAGE_SIZE(Header->BufferLength);
+
+        if (Offset + MessageSize > BufferSize)
         {
             //
-            // Increment the next index to read
+            // The message is left for the next read
             //
-            MessageBufferInformation[Index].CurrentIndexToSend = MessageBufferInformation[Index].CurrentIndexToSend + 1;
+            break;
         }
-    }
 
-    //
-    // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
-    // if not we use the windows spinlock
-    //
-    if (IsVmxRoot)
-    {
-        SpinlockUnlock(&VmxRootLoggingLock);
-    }
-    else
-    {
         //
-        // Release the lock
+        // Save the header and the message (null-terminated)
         //
-        KeReleaseSpinLock(&MessageBufferInformation[Index].BufferLock, OldIRQL);
+        MessageHeader                   = (PUSERMODE_BATCHED_MESSAGE_HEADER)((UINT64)BufferToSaveMessages + Offset);
+        MessageHeader->TriggerTimestamp = Header->TriggerTimestamp;
+        MessageHeader->Timestamp        = Header->Timestamp;
+        MessageHeader->ReadTimestamp    = ReadTimestamp;
+        MessageHeader->BufferLength     = Header->BufferLength;
+        MessageHeader->OperationCode    = Header->OpeationNumber;
+
+        RtlCopyBytes((PVOID)((UINT64)MessageHeader + sizeof(USERMODE_BATCHED_MESSAGE_HEADER)),
+                     (PVOID)((UINT64)Header + sizeof(BUFFER_HEADER)),
+                     Header->BufferLength);
+
+        RtlZeroMemory((PVOID)((UINT64)MessageHeader + sizeof(USERMODE_BATCHED_MESSAGE_HEADER) + Header->BufferLength),
+                      MessageSize - sizeof(USERMODE_BATCHED_MESSAGE_HEADER) - Header->BufferLength);
+
+#if ShowMessagesOnDebugger
+        LogShowMessageOnDebugger(Header);
+#endif
+
+        //
+        // Give the chunk back to the producer
+        //
+        LogMarkMessageAsSent(CoreId, IsVmxRoot, Priority);
+
+        Offset += MessageSize;
     }
 
-    return TRUE;
+    LogReleaseReaderLock(TRUE, IrqlRaisedRoot, OldIRQLRoot);
+    LogReleaseReaderLock(FALSE, IrqlRaisedNonRoot, OldIRQLNonRoot);
+
+    *ReturnedLength = Offset;
+
+    return Offset != 0;
 }
 
 /**
@@ -836,47 +1398,35 @@ LogReadBuffer(BOOLEAN IsVmxRoot, PVOID BufferToSaveMessage, UINT32 * ReturnedLen
  * @return BOOLEAN return of this function shows whether the read was successful or not
  * (e.g FALSE shows there's no new buffer available.)
  */
-BOOLEAN
-LogCheckForNewMessage(BOOLEAN IsVmxRoot, BOOLEAN Priority)
-{
-    KIRQL  OldIRQL;
-    UINT32 Index;
-
-    if (IsVmxRoot)
-    {
-        Index = 1;
-    }
-    else
-    {
-        Index = 0;
-    }
-
-    //
-    // Compute the current buffer to read
-    //
-    BUFFER_HEADER * Header;
+BOOLEAN
+LogCheckForNewMessage(BOOLEAN IsVmxRoot, BOOLEAN Priority)
+{
+    PLOG_BUFFER_INFORMATION BufferInformation;
 
-    if (Priority)
+    for (ULONG i = 0; i < LogCoreCount; i++)
     {
-        Header = (BUFFER_HEADER *)((UINT64)MessageBufferInformation[Index].BufferStartAddressPriority + (MessageBufferInformation[Index].CurrentIndexToSendPriority * (PacketChunkSize + sizeof(BUFFER_HEADER))));
-    }
-    else
-    {
-        Header = (BUFFER_HEADER *)((UINT64)MessageBufferInformation[Index].BufferStartAddress + (MessageBufferInformation[Index].CurrentIndexToSend * (PacketChunkSize + sizeof(BUFFER_HEADER))));
-    }
+        BufferInformation = LogGetBufferInformation(i, IsVmxRoot);
 
-    if (!Header->Valid)
-    {
-        //
-        // there is nothing to send
-        //
-        return FALSE;
+        if (Priority)
+        {
+            if (BufferInformation->IndexesPriority->CurrentIndexToSend != BufferInformation->IndexesPriority->CurrentIndexToWrite)
+            {
+                return TRUE;
+            }
+        }
+        else
+        {
+            if (BufferInformation->Indexes->CurrentIndexToSend != BufferInformation->Indexes->CurrentIndexToWrite)
+            {
+                return TRUE;
+            }
+        }
     }
 
     //
-    // If we reached here, means that there is sth to send
+    // there is nothing to send
     //
-    return TRUE;
+    return FALSE;
 }
 
 /**
@@ -1119,10 +1669,10 @@ LogCallbackPrepareAndSendMessageToQueue(UINT32       OperationCode,
 BOOLEAN
 LogCallbackSendMessageToQueue(UINT32 OperationCode, BOOLEAN IsImmediateMessage, CHAR * LogMessage, UINT32 BufferLen, BOOLEAN Priority)
 {
-    BOOLEAN Result;
-    UINT32  Index;
-    KIRQL   OldIRQL;
-    BOOLEAN IsVmxRootMode;
+    BOOLEAN                 Result;
+    KIRQL                   OldIRQL;
+    BOOLEAN                 IsVmxRootMode;
+    PLOG_BUFFER_INFORMATION BufferInformation;
 
     //
     // Set Vmx State
@@ -1172,29 +1722,17 @@ LogCallbackSendMessageToQueue(UINT32 OperationCode, BOOLEAN IsImmediateMessage,
     else
     {
         //
-        // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
-        // if not we use the windows spinlock
+        // The buffer of non-immediate messages belongs to the current core, in vmx-root
+        // RFLAGS.IF is cleared and in vmx non-root, the IRQL is raised to DISPATCH_LEVEL
+        // so we won't be scheduled (or moved to another core) while accumulating messages
         //
-        if (IsVmxRootMode)
+        if (!IsVmxRootMode)
         {
-            //
-            // Set the index
-            //
-            Index = 1;
-            SpinlockLock(&VmxRootLoggingLockForNonImmBuffers);
+            OldIRQL = KeRaiseIrqlToDpcLevel();
         }
-        else
-        {
-            //
-            // Set the index
-            //
-            Index = 0;
 
-            //
-            // Acquire the lock
-            //
-            KeAcquireSpinLock(&MessageBufferInformation[Index].BufferLockForNonImmMessage, &OldIRQL);
-        }
+        BufferInformation = LogGetBufferInformation(KeGetCurrentProcessorNumber(), IsVmxRootMode);
+
         //
         // Set the result to True
         //
@@ -1203,50 +1741,40 @@ LogCallbackSendMessageToQueue(UINT32 OperationCode, BOOLEAN IsImmediateMessage,
         //
         // If log message WrittenSize is above the buffer then we have to send the previous buffer
         //
-        if ((MessageBufferInformation[Index].CurrentLengthOfNonImmBuffer + BufferLen) > PacketChunkSize - 1 && MessageBufferInformation[Index].CurrentLengthOfNonImmBuffer != 0)
+        if ((BufferInformation->CurrentLengthOfNonImmBuffer + BufferLen) > PacketChunkSize - 1 && BufferInformation->CurrentLengthOfNonImmBuffer != 0)
         {
             //
             // Send the previous buffer (non-immediate message),
             // accumulated messages don't have priority
             //
             Result = LogCallbackSendBuffer(OPERATION_LOG_NON_IMMEDIATE_MESSAGE,
-                                           MessageBufferInformation[Index].BufferForMultipleNonImmediateMessage,
-                                           MessageBufferInformation[Index].CurrentLengthOfNonImmBuffer,
+                                           BufferInformation->BufferForMultipleNonImmediateMessage,
+                                           BufferInformation->CurrentLengthOfNonImmBuffer,
                                            FALSE);
 
             //
             // Free the immediate buffer
             //
-            MessageBufferInformation[Index].CurrentLengthOfNonImmBuffer = 0;
-            RtlZeroMemory(MessageBufferInformation[Index].BufferForMultipleNonImmediateMessage, PacketChunkSize);
+            BufferInformation->CurrentLengthOfNonImmBuffer = 0;
+            RtlZeroMemory(BufferInformation->BufferForMultipleNonImmediateMessage, PacketChunkSize);
         }
 
         //
         // We have to save the message
         //
-        RtlCopyBytes(MessageBufferInformation[Index].BufferForMultipleNonImmediateMessage +
-                         MessageBufferInformation[Index].CurrentLengthOfNonImmBuffer,
+        RtlCopyBytes(BufferInformation->BufferForMultipleNonImmediateMessage +
+                         BufferInformation->CurrentLengthOfNonImmBuffer,
                      LogMessage,
                      BufferLen);
 
         //
         // add the length
         //
-        MessageBufferInformation[Index].CurrentLengthOfNonImmBuffer += BufferLen;
+        BufferInformation->CurrentLengthOfNonImmBuffer += BufferLen;
 
-        // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
-        // if not we use the windows spinlock
-        //
-        if (IsVmxRootMode)
-        {
-            SpinlockUnlock(&VmxRootLoggingLockForNonImmBuffers);
-        }
-        else
+        if (!IsVmxRootMode)
         {
-            //
-            // Release the lock
-            //
-            KeReleaseSpinLock(&MessageBufferInformation[Index].BufferLockForNonImmMessage, OldIRQL);
+            KeLowerIrql(OldIRQL);
         }
 
         return Result;
@@ -1269,6 +1797,7 @@ LogNotifyUsermodeCallback(PKDPC Dpc, PVOID DeferredContext, PVOID SystemArgument
     PNOTIFY_RECORD NotifyRecord;
     PIRP           Irp;
     UINT32         Length;
+    BOOLEAN        IsMessageRead;
 
     UNREFERENCED_PARAMETER(Dpc);
     UNREFERENCED_PARAMETER(SystemArgument1);
@@ -1282,6 +1811,7 @@ LogNotifyUsermodeCallback(PKDPC Dpc, PVOID DeferredContext, PVOID SystemArgument
     switch (NotifyRecord->Type)
     {
     case IRP_BASED:
+    case IRP_BASED_BATCHED:
         Irp = NotifyRecord->Message.PendingIrp;
 
         if (Irp != NULL)
@@ -1326,9 +1856,19 @@ LogNotifyUsermodeCallback(PKDPC Dpc, PVOID DeferredContext, PVOID SystemArgument
             Length  = 0;
 
             //
-            // Read Buffer might be empty (nothing to send)
+            // Read Buffer might be empty (nothing to send), in batched reads
+            // all of the buffers are read at once
             //
-            if (!LogReadBuffer(NotifyRecord->CheckVmxRootMessagePool, OutBuff, &Length))
+            if (NotifyRecord->Type == IRP_BASED_BATCHED)
+            {
+                IsMessageRead = LogReadBatchedBuffer(OutBuff, OutBuffLength, &Length);
+            }
+            else
+            {
+                IsMessageRead = LogReadBuffer(NotifyRecord->CheckVmxRootMessagePool, OutBuff, &Length);
+            }
+
+            if (!IsMessageRead)
             {
                 //
                 // we have to return here as there is nothing to send here
@@ -1406,7 +1946,7 @@ LogRegisterIrpBasedNotification(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             return STATUS_INSUFFICIENT_RESOURCES;
         }
 
-        NotifyRecord->Type               = IRP_BASED;
+        NotifyRecord->Type               = RegisterEvent->Type == IRP_BASED_BATCHED ? IRP_BASED_BATCHED : IRP_BASED;
         NotifyRecord->Message.PendingIrp = Irp;
 
         KeInitializeDpc(&NotifyRecord->Dpc,        // Dpc
@@ -1472,7 +2012,20 @@ LogRegisterIrpBasedNotification(PDEVICE_OBJECT DeviceObject, PIRP Irp)
             //
             // Set the notify routine to the global structure
             //
-            g_GlobalNotifyRecord = NotifyRecord;
+            InterlockedExchangePointer((PVOID volatile *)&g_GlobalNotifyRecord, NotifyRecord);
+
+            //
+            // Producers don't take any lock, so a message might be published before
+            // the record is set, in this case the record is taken back and notified
+            //
+            if (LogCheckForNewMessage(FALSE, TRUE) || LogCheckForNewMessage(FALSE, FALSE))
+            {
+                LogNotifyWaitingThread(FALSE);
+            }
+            else if (LogCheckForNewMessage(TRUE, TRUE) || LogCheckForNewMessage(TRUE, FALSE))
+            {
+                LogNotifyWaitingThread(TRUE);
+            }
         }
         //
         // We will return pending as we have marked the IRP pending
@@ -1546,3 +2099,383 @@ LogRegisterEventBasedNotification(PDEVICE_OBJECT DeviceObject, PIRP Irp)
 
     return STATUS_SUCCESS;
 }
+
+/**
+ * @brief Deferred procedure call of signaling the consumer of the shared buffers
+ *
+ * @param Dpc
+ * @param DeferredContext
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+LogSharedMemoryNotifyCallback(PKDPC Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(DeferredContext);
+    UNREFERENCED_PARAMETER(SystemArgument1);
+    UNREFERENCED_PARAMETER(SystemArgument2);
+
+    //
+    // Messages that are published after clearing the flag queue another DPC
+    //
+    InterlockedExchange(&g_LogSharedMemory.SignalPending, FALSE);
+
+    if (g_LogSharedMemory.IsMapped)
+    {
+        KeSetEvent(g_LogSharedMemory.Event, 0, FALSE);
+    }
+}
+
+/**
+ * @brief Map a non-paged buffer into the current process
+ *
+ * @param Buffer The buffer to map
+ * @param Size Size of the buffer
+ * @param IsWritable Whether the user-mode can write to the buffer
+ * @param Mdl The MDL of the mapping
+ * @return PVOID The user-mode address or NULL if it fails
+ */
+PVOID
+LogMapBufferToUsermode(PVOID Buffer, UINT32 Size, BOOLEAN IsWritable, PMDL * Mdl)
+{
+    PVOID UsermodeAddress = NULL;
+    ULONG Priority        = NormalPagePriority | MdlMappingNoExecute;
+
+    if (!IsWritable)
+    {
+        Priority |= MdlMappingNoWrite;
+    }
+
+    *Mdl = IoAllocateMdl(Buffer, Size, FALSE, FALSE, NULL);
+
+    if (*Mdl == NULL)
+    {
+        return NULL;
+    }
+
+    MmBuildMdlForNonPagedPool(*Mdl);
+
+    //
+    // Mapping into the user-mode raises an exception if it fails
+    //
+    __try
+    {
+        UsermodeAddress = MmMapLockedPagesSpecifyCache(*Mdl,
+                                                       UserMode,
+                                                       MmCached,
+                                                       NULL,
+                                                       FALSE,
+                                                       Priority);
+    }
+    __except (EXCEPTION_EXECUTE_HANDLER)
+    {
+        UsermodeAddress = NULL;
+    }
+
+    if (UsermodeAddress == NULL)
+    {
+        IoFreeMdl(*Mdl);
+        *Mdl = NULL;
+    }
+
+    return UsermodeAddress;
+}
+
+/**
+ * @brief Unmap a buffer that is mapped by LogMapBufferToUsermode
+ *
+ * @param Mdl The MDL of the mapping
+ * @param UsermodeAddress The user-mode address of the mapping
+ * @return VOID
+ */
+VOID
+LogUnmapBufferFromUsermode(PMDL * Mdl, PVOID * UsermodeAddress)
+{
+    if (*Mdl == NULL)
+    {
+        return;
+    }
+
+    MmUnmapLockedPages(*UsermodeAddress, *Mdl);
+    IoFreeMdl(*Mdl);
+
+    *Mdl             = NULL;
+    *UsermodeAddress = NULL;
+}
+
+/**
+ * @brief Unmap all of the shared buffers
+ * @details should be called in the context of the process that
+ * buffers are mapped into
+ *
+ * @return VOID
+ */
+VOID
+LogUnmapAllSharedBuffers()
+{
+    for (ULONG i = 0; i < LogCoreCount * 2; i++)
+    {
+        LogUnmapBufferFromUsermode(&MessageBufferInformation[i].BufferMdl,
+                                   &MessageBufferInformation[i].BufferUsermodeAddress);
+        LogUnmapBufferFromUsermode(&MessageBufferInformation[i].BufferMdlPriority,
+                                   &MessageBufferInformation[i].BufferUsermodeAddressPriority);
+    }
+
+    LogUnmapBufferFromUsermode(&g_LogSharedMemory.IndexesMdl, &g_LogSharedMemory.IndexesUsermodeAddress);
+    LogUnmapBufferFromUsermode(&g_LogSharedMemory.NotificationMdl, &g_LogSharedMemory.NotificationUsermodeAddress);
+}
+
+/**
+ * @brief Create a shared memory based usermode notifying mechanism
+ * @details the buffers and their indexes are mapped (read-only) into the
+ * current process and the event is signaled when new messages are available,
+ * only one process can map the buffers at a time
+ *
+ * @param DeviceObject
+ * @param Irp
+ * @return NTSTATUS
+ */
+NTSTATUS
+LogRegisterSharedMemoryNotification(PDEVICE_OBJECT DeviceObject, PIRP Irp)
+{
+    NTSTATUS                Status;
+    PIO_STACK_LOCATION      IrpStack;
+    PREGISTER_NOTIFY_BUFFER RegisterEvent;
+    PLOG_SHARED_BUFFERS     SharedBuffers;
+    PKEVENT                 Event;
+    UINT32                  ChunkSize   = PacketChunkSize + sizeof(BUFFER_HEADER);
+    BOOLEAN                 MappingDone = TRUE;
+
+    UNREFERENCED_PARAMETER(DeviceObject);
+
+    IrpStack = IoGetCurrentIrpStackLocation(Irp);
+
+    if (IrpStack->Parameters.DeviceIoControl.OutputBufferLength < sizeof(LOG_SHARED_BUFFERS) ||
+        LogCoreCount * 4 > MaximumLogSharedRings)
+    {
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    //
+    // The input and output buffers are the same buffer
+    //
+    RegisterEvent = (PREGISTER_NOTIFY_BUFFER)Irp->AssociatedIrp.SystemBuffer;
+    SharedBuffers = (PLOG_SHARED_BUFFERS)Irp->AssociatedIrp.SystemBuffer;
+
+    if (InterlockedCompareExchange(&g_LogSharedMemory.InUse, TRUE, FALSE) != FALSE)
+    {
+        //
+        // Buffers are already mapped
+        //
+        return STATUS_DEVICE_BUSY;
+    }
+
+    //
+    // Wait for the producers that are replacing their buffers (they won't start
+    // replacing the buffers anymore)
+    //
+    for (ULONG i = 0; i < LogCoreCount * 2; i++)
+    {
+        while (MessageBufferInformation[i].Growing)
+        {
+            _mm_pause();
+        }
+    }
+
+    //
+    // Get the object pointer from the handle
+    // Note we must be in the context of the process that created the handle
+    //
+    Status = ObReferenceObjectByHandle(RegisterEvent->hEvent,
+                                       SYNCHRONIZE | EVENT_MODIFY_STATE,
+                                       *ExEventObjectType,
+                                       Irp->RequestorMode,
+                                       &Event,
+                                       NULL);
+
+    if (!NT_SUCCESS(Status))
+    {
+        DbgPrint("Err, unable to reference user mode event object, status = 0x%x", Status);
+        InterlockedExchange(&g_LogSharedMemory.InUse, FALSE);
+        return Status;
+    }
+
+    RtlZeroMemory(SharedBuffers, sizeof(LOG_SHARED_BUFFERS));
+
+    //
+    // Map the indexes, the notification page and then the buffers
+    //
+    g_LogSharedMemory.IndexesUsermodeAddress = LogMapBufferToUsermode(LogRingIndexes,
+                                                                      LogRingIndexesSize,
+                                                                      FALSE,
+                                                                      &g_LogSharedMemory.IndexesMdl);
+
+    g_LogSharedMemory.NotificationUsermodeAddress = LogMapBufferToUsermode(LogSharedNotification,
+                                                                           PAGE_SIZE,
+                                                                           TRUE,
+                                                                           &g_LogSharedMemory.NotificationMdl);
+
+    if (g_LogSharedMemory.IndexesUsermodeAddress == NULL || g_LogSharedMemory.NotificationUsermodeAddress == NULL)
+    {
+        MappingDone = FALSE;
+    }
+
+    for (ULONG i = 0; i < LogCoreCount * 2 && MappingDone; i++)
+    {
+        MessageBufferInformation[i].BufferUsermodeAddress =
+            LogMapBufferToUsermode((PVOID)MessageBufferInformation[i].BufferStartAddress,
+                                   MessageBufferInformation[i].PacketsCapacity * ChunkSize,
+                                   FALSE,
+                                   &MessageBufferInformation[i].BufferMdl);
+
+        MessageBufferInformation[i].BufferUsermodeAddressPriority =
+            LogMapBufferToUsermode((PVOID)MessageBufferInformation[i].BufferStartAddressPriority,
+                                   MessageBufferInformation[i].PacketsCapacityPriority * ChunkSize,
+                                   FALSE,
+                                   &MessageBufferInformation[i].BufferMdlPriority);
+
+        if (MessageBufferInformation[i].BufferUsermodeAddress == NULL ||
+            MessageBufferInformation[i].BufferUsermodeAddressPriority == NULL)
+        {
+            MappingDone = FALSE;
+            break;
+        }
+
+        //
+        // Rings are in the same order as the indexes
+        //
+        SharedBuffers->Rings[i * 2].BufferAddress   = (UINT64)MessageBufferInformation[i].BufferUsermodeAddress;
+        SharedBuffers->Rings[i * 2].PacketsCapacity = MessageBufferInformation[i].PacketsCapacity;
+        SharedBuffers->Rings[i * 2].IsPriority      = FALSE;
+
+        SharedBuffers->Rings[i * 2 + 1].BufferAddress   = (UINT64)MessageBufferInformation[i].BufferUsermodeAddressPriority;
+        SharedBuffers->Rings[i * 2 + 1].PacketsCapacity = MessageBufferInformation[i].PacketsCapacityPriority;
+        SharedBuffers->Rings[i * 2 + 1].IsPriority      = TRUE;
+    }
+
+    if (!MappingDone)
+    {
+        LogUnmapAllSharedBuffers();
+        ObDereferenceObject(Event);
+        InterlockedExchange(&g_LogSharedMemory.InUse, FALSE);
+
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    SharedBuffers->CountOfRings        = LogCoreCount * 4;
+    SharedBuffers->ChunkSize           = ChunkSize;
+    SharedBuffers->IndexesAddress      = (UINT64)g_LogSharedMemory.IndexesUsermodeAddress;
+    SharedBuffers->NotificationAddress = (UINT64)g_LogSharedMemory.NotificationUsermodeAddress;
+
+    //
+    // Producers don't change the sequences until the buffers are marked as mapped
+    //
+    LogSharedNotification->PublishedSequence = 0;
+    LogSharedNotification->ConsumedSequence  = 0;
+
+    //
+    // Save the state and start signaling the event
+    //
+    g_LogSharedMemory.Process       = PsGetCurrentProcess();
+    g_LogSharedMemory.Event         = Event;
+    g_LogSharedMemory.SignalPending = FALSE;
+
+    KeInitializeDpc(&g_LogSharedMemory.Dpc,        // Dpc
+                    LogSharedMemoryNotifyCallback, // DeferredRoutine
+                    NULL                           // DeferredContext
+    );
+
+    InterlockedExchange(&g_LogSharedMemory.IsMapped, TRUE);
+
+    //
+    // There might be messages that are saved before mapping the buffers
+    //
+    KeSetEvent(Event, 0, FALSE);
+
+    Irp->IoStatus.Information = sizeof(LOG_SHARED_BUFFERS);
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * @brief Release the chunks of the shared buffers that are read by the user-mode
+ * @details the new send index of each ring should be between its current
+ * send index and write index, otherwise the ring is ignored
+ *
+ * @param Release The new send indexes
+ * @return BOOLEAN
+ */
+BOOLEAN
+LogReleaseSharedMemoryMessages(PLOG_SHARED_BUFFERS_RELEASE Release)
+{
+    KIRQL             OldIRQLNonRoot;
+    KIRQL             OldIRQLRoot;
+    BOOLEAN           IrqlRaisedNonRoot;
+    BOOLEAN           IrqlRaisedRoot;
+    PLOG_RING_INDEXES Indexes;
+    UINT32            NewIndexToSend;
+
+    if (!g_LogSharedMemory.IsMapped ||
+        g_LogSharedMemory.Process != PsGetCurrentProcess() ||
+        Release->CountOfRings > LogCoreCount * 4)
+    {
+        return FALSE;
+    }
+
+    //
+    // The send indexes are also modified by other readers
+    //
+    IrqlRaisedNonRoot = LogAcquireReaderLock(FALSE, &OldIRQLNonRoot);
+    IrqlRaisedRoot    = LogAcquireReaderLock(TRUE, &OldIRQLRoot);
+
+    for (UINT32 i = 0; i < Release->CountOfRings; i++)
+    {
+        Indexes        = &LogRingIndexes[i];
+        NewIndexToSend = Release->CurrentIndexToSend[i];
+
+        if (NewIndexToSend - Indexes->CurrentIndexToSend <= Indexes->CurrentIndexToWrite - Indexes->CurrentIndexToSend)
+        {
+            InterlockedExchange((volatile LONG *)&Indexes->CurrentIndexToSend, NewIndexToSend);
+        }
+    }
+
+    LogReleaseReaderLock(TRUE, IrqlRaisedRoot, OldIRQLRoot);
+    LogReleaseReaderLock(FALSE, IrqlRaisedNonRoot, OldIRQLNonRoot);
+
+    return TRUE;
+}
+
+/**
+ * @brief Unmap the shared buffers from the user-mode
+ * @details should be called in the context of the process that buffers
+ * are mapped into (e.g., when its handle to the device is closed)
+ *
+ * @return BOOLEAN Whether the buffers were mapped into the current process
+ */
+BOOLEAN
+LogUnmapSharedMemory()
+{
+    if (g_LogSharedMemory.Process != PsGetCurrentProcess() ||
+        InterlockedExchange(&g_LogSharedMemory.IsMapped, FALSE) == FALSE)
+    {
+        return FALSE;
+    }
+
+    //
+    // Wait for the queued DPCs, so the event is no longer used
+    //
+    KeFlushQueuedDpcs();
+
+    LogUnmapAllSharedBuffers();
+
+    ObDereferenceObject(g_LogSharedMemory.Event);
+
+    g_LogSharedMemory.Event   = NULL;
+    g_LogSharedMemory.Process = NULL;
+
+    InterlockedExchange(&g_LogSharedMemory.InUse, FALSE);
+
+    return TRUE;
+}
@@ -12,6 +12,22 @@
 
 #pragma once
 
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Minimum count of chunks of the regular buffer of each core
+ *
+ */
+#define LogMinimumPacketsCapacityPerCore 64
+
+/**
+ * @brief Maximum count of chunks of each buffer of each core
+ *
+ */
+#define LogMaximumPacketsCapacityPerCore 8192
+
 //////////////////////////////////////////////////
 //				Global Variables				//
 //////////////////////////////////////////////////
@@ -50,70 +66,149 @@ typedef struct _NOTIFY_RECORD
     BOOLEAN CheckVmxRootMessagePool; // Set so that notify callback can understand where to check (Vmx root or Vmx non-root)
 } NOTIFY_RECORD, *PNOTIFY_RECORD;
 
-/**
- * @brief Message buffer structure
- *
- */
-typedef struct _BUFFER_HEADER
-{
-    UINT32  OpeationNumber; // Operation ID to user-mode
-    UINT32  BufferLength;   // The actual length
-    BOOLEAN Valid;          // Determine whether the buffer was valid to send or not
-} BUFFER_HEADER, *PBUFFER_HEADER;
-
 /**
  * @brief Core-specific buffers
+ * @details each buffer is a single-producer/single-consumer ring, the producer is
+ * the owner core and it only modifies the write indexes while the reader only modifies
+ * the send indexes, indexes are free-running and a chunk is available to read when the
+ * send index is not equal to the write index, the indexes are kept in a separate array
+ * so they can be mapped into the user-mode along with the buffers
  *
  */
 typedef struct _LOG_BUFFER_INFORMATION
 {
-    KSPIN_LOCK BufferLock;                       // SpinLock to protect access to the queue
-    KSPIN_LOCK BufferLockForNonImmMessage;       // SpinLock to protect access to the queue of non-imm messages
-
     UINT64 BufferForMultipleNonImmediateMessage; // Start address of the buffer for accumulating non-immadiate messages
     UINT32 CurrentLengthOfNonImmBuffer;          // the current size of the buffer for accumulating non-immadiate messages
+    UINT64 TriggerTimestamp;                     // Time-stamp counter of the event that is being triggered (or zero)
+    INT64  TscOffset;                            // Skew of the time-stamp counter of the core from the first core
 
     //
     // Regular buffers
     //
-    UINT64 BufferStartAddress;  // Start address of the buffer
-    UINT64 BufferEndAddress;    // End address of the buffer
+    UINT64            BufferStartAddress;    // Start address of the buffer
+    UINT64            BufferEndAddress;      // End address of the buffer
+    UINT32            PacketsCapacity;       // Count of chunks of the buffer (power of two)
+    PLOG_RING_INDEXES Indexes;               // Indexes of the buffer (located in LogRingIndexes)
+    PMDL              BufferMdl;             // MDL of the buffer (if it's mapped into the user-mode)
+    PVOID             BufferUsermodeAddress; // User-mode address of the buffer (if it's mapped)
+
+    //
+    // Growth of regular buffers
+    //
+    PVOID volatile PendingBuffer;          // A larger buffer allocated in PASSIVE_LEVEL (replaces the buffer once it's empty)
+    UINT32         PendingPacketsCapacity; // Count of chunks of the pending buffer
+    PVOID volatile RetiredBuffer;          // The replaced buffer (freed in PASSIVE_LEVEL)
+    volatile LONG  Growing;                // The producer is replacing the buffer
+    BOOLEAN        GrowthRequested;        // Set by the producer when the buffer is almost full
 
-    UINT32 CurrentIndexToSend;  // Current buffer index to send to user-mode
-    UINT32 CurrentIndexToWrite; // Current buffer index to write new messages
+    //
+    // Statistics of regular buffers
+    //
+    UINT32 HighWaterMark;     // Maximum count of unread chunks
+    UINT64 DroppedMessages;   // Messages that are not saved as the buffer was full
+    UINT64 DiscardedMessages; // Messages that are discarded before being read
 
     //
     // Priority buffers
     //
-    UINT64 BufferStartAddressPriority;  // Start address of the buffer
-    UINT64 BufferEndAddressPriority;    // End address of the buffer
+    UINT64            BufferStartAddressPriority;    // Start address of the buffer
+    UINT64            BufferEndAddressPriority;      // End address of the buffer
+    UINT32            PacketsCapacityPriority;       // Count of chunks of the buffer (power of two)
+    PLOG_RING_INDEXES IndexesPriority;               // Indexes of the buffer (located in LogRingIndexes)
+    PMDL              BufferMdlPriority;             // MDL of the buffer (if it's mapped into the user-mode)
+    PVOID             BufferUsermodeAddressPriority; // User-mode address of the buffer (if it's mapped)
 
-    UINT32 CurrentIndexToSendPriority;  // Current buffer index to send to user-mode for priority buffers
-    UINT32 CurrentIndexToWritePriority; // Current buffer index to write new messages for priority buffers
+    //
+    // Statistics of priority buffers
+    //
+    UINT32            HighWaterMarkPriority;   // Maximum count of unread chunks
+    UINT64            DroppedMessagesPriority; // Messages that are not saved as the buffer was full
 
 } LOG_BUFFER_INFORMATION, *PLOG_BUFFER_INFORMATION;
 
+/**
+ * @brief State of the message buffers that are mapped into the user-mode
+ *
+ */
+typedef struct _LOG_SHARED_MEMORY_STATE
+{
+    volatile LONG InUse;         // Whether the buffers are mapped (or being mapped)
+    volatile LONG IsMapped;      // Whether the buffers are mapped
+    volatile LONG SignalPending; // Whether the DPC of signaling the event is already queued
+    PEPROCESS     Process;       // The process that the buffers are mapped into
+    PKEVENT       Event;         // The event that is signaled when new messages are available
+    KDPC          Dpc;
+    PMDL          IndexesMdl;
+    PVOID         IndexesUsermodeAddress;
+    PMDL          NotificationMdl;
+    PVOID         NotificationUsermodeAddress;
+
+} LOG_SHARED_MEMORY_STATE, *PLOG_SHARED_MEMORY_STATE;
+
 //////////////////////////////////////////////////
 //				Global Variables				//
 //////////////////////////////////////////////////
 
 /**
  * @brief Global Variable for buffer on all cores
+ * @details each core has two buffers, one for vmx non-root (even indexes)
+ * and one for vmx-root (odd indexes)
  *
  */
 LOG_BUFFER_INFORMATION * MessageBufferInformation;
 
 /**
- * @brief Vmx-root lock for logging
+ * @brief Indexes of all of the buffers
+ * @details the indexes of the regular buffer of MessageBufferInformation[i] are
+ * located at (i * 2) and the indexes of its priority buffer are at (i * 2 + 1)
+ *
+ */
+LOG_RING_INDEXES * LogRingIndexes;
+
+/**
+ * @brief Size of the allocation of LogRingIndexes (page aligned)
+ *
+ */
+UINT32 LogRingIndexesSize;
+
+/**
+ * @brief The notification page of the shared buffers (the page after LogRingIndexes)
+ *
+ */
+PLOG_SHARED_NOTIFICATION LogSharedNotification;
+
+/**
+ * @brief Count of cores that have buffers
+ *
+ */
+ULONG LogCoreCount;
+
+/**
+ * @brief Regular buffers are grown up to this count of chunks
+ * @details zero means that the buffers are not grown
+ *
+ */
+UINT32 LogMaximumPacketsCapacity;
+
+/**
+ * @brief Lock of readers of the vmx-root buffers
+ * @details producers never take this lock, it only serializes the readers
+ *
+ */
+volatile LONG VmxRootLoggingReaderLock;
+
+/**
+ * @brief Lock of readers of the vmx non-root buffers
+ * @details producers never take this lock, it only serializes the readers
  *
  */
-volatile LONG VmxRootLoggingLock;
+volatile LONG VmxNonRootLoggingReaderLock;
 
 /**
- * @brief Vmx-root lock for logging
+ * @brief Lock of allocating the larger buffers (in PASSIVE_LEVEL)
  *
  */
-volatile LONG VmxRootLoggingLockForNonImmBuffers;
+volatile LONG LogBuffersAllocationLock;
 
 //////////////////////////////////////////////////
 //					Illustration				//
@@ -121,7 +216,7 @@ volatile LONG VmxRootLoggingLockForNonImmBuffers;
 
 /*
 
-A core buffer is like this , it's divided into MaximumPacketsCapacity chucks,
+A core buffer is like this , it's divided into PacketsCapacity chucks,
 each chunk has PacketChunkSize + sizeof(BUFFER_HEADER) size
 
              _________________________
@@ -172,7 +267,7 @@ each chunk has PacketChunkSize + sizeof(BUFFER_HEADER) size
  * @brief Save the state of the thread that waits for messages to deliver to user-mode
  *
  */
-NOTIFY_RECORD * g_GlobalNotifyRecord;
+NOTIFY_RECORD * volatile g_GlobalNotifyRecord;
 
 /**
  * @brief Global variable that holds callbacks
@@ -180,6 +275,12 @@ NOTIFY_RECORD * g_GlobalNotifyRecord;
  */
 MESSAGE_TRACING_CALLBACKS g_MsgTracingCallbacks;
 
+/**
+ * @brief State of the buffers that are mapped into the user-mode
+ *
+ */
+LOG_SHARED_MEMORY_STATE g_LogSharedMemory;
+
 //////////////////////////////////////////////////
 //					Functions					//
 //////////////////////////////////////////////////
@@ -187,5 +288,14 @@ MESSAGE_TRACING_CALLBACKS g_MsgTracingCallbacks;
 BOOLEAN
 LogReadBuffer(BOOLEAN IsVmxRoot, PVOID BufferToSaveMessage, UINT32 * ReturnedLength);
 
+BOOLEAN
+LogReadBatchedBuffer(PVOID BufferToSaveMessages, UINT32 BufferSize, UINT32 * ReturnedLength);
+
 VOID
 LogNotifyUsermodeCallback(PKDPC Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2);
+
+VOID
+LogGrowBufferIfPending(PLOG_BUFFER_INFORMATION BufferInformation);
+
+VOID
+LogSharedMemoryNotifyCallback(PKDPC Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2);
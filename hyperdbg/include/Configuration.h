@@ -67,3 +67,35 @@
  * @brief Activates the user-mode debugger
  */
 #define ActivateUserModeDebugger FALSE
+
+/**
+ * @brief Compiles the pre-compiled (bytecode) form of scripts into native
+ * x64 code, if it's FALSE, the bytecode is interpreted
+ */
+#define UseNativeCodeForScripts TRUE
+
+/**
+ * @brief Counts the acquisitions, spin cycles and the maximum wait of the
+ * named spinlocks (SpinlockLockNamed) at each site, the results are shown
+ * by the '!lockstats' command, if it's FALSE, named spinlocks are the same
+ * as the normal spinlocks
+ */
+#define UseSpinlockContentionInstrumentation FALSE
+
+/**
+ * @brief Executes the instruction that triggered an EPT hook on a view of the
+ * current core which only restores the hooked page (the paging structures are
+ * shared with the EPT page table and the path to the page is copied), if it's
+ * FALSE, the instruction is executed on the unhooked view in which none of the
+ * hooks are applied
+ */
+#define UsePerCoreEptViewsForHookRestoration FALSE
+
+/**
+ * @brief Uses the enlightened VMCS of Hyper-V (instead of VMREAD and VMWRITE)
+ * and the enlightened MSR bitmap once HyperDbg is nested under Hyper-V and
+ * they're recommended by Hyper-V, the features that need the fields that are
+ * not in the enlightened VMCS (PML, VMX preemption timer, Intel PT, etc.) are
+ * not available in this case
+ */
+#define UseEnlightenedVmcsWhenNestedUnderHyperV TRUE
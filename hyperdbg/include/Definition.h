@@ -69,6 +69,99 @@
  */
 #define TEST_CASE_MAXIMUM_BUFFERS_TO_COMMUNICATE sizeof(DEBUGGEE_KERNEL_AND_USER_TEST_INFORMATION) * TEST_CASE_MAXIMUM_NUMBER_OF_KERNEL_TEST_CASES
 
+/**
+ * @brief The MSR that is trapped by the events of the benchmark (IA32_SYSENTER_CS)
+ */
+#define TEST_BENCHMARK_TRAPPED_MSR 0x174
+
+/**
+ * @brief The MSR that is never trapped by the benchmark (IA32_SYSENTER_ESP)
+ */
+#define TEST_BENCHMARK_UNTRAPPED_MSR 0x175
+
+/**
+ * @brief The I/O port that is read by the benchmark
+ */
+#define TEST_BENCHMARK_IO_PORT 0x80
+
+/**
+ * @brief Default count of iterations of each operation of the benchmark
+ */
+#define TEST_BENCHMARK_DEFAULT_ITERATIONS 0x1000
+
+/**
+ * @brief Maximum count of iterations of each operation of the benchmark
+ */
+#define TEST_BENCHMARK_MAXIMUM_ITERATIONS 0x10000
+
+/**
+ * @brief Default count of the dummy events (of each type) of the benchmark
+ */
+#define TEST_BENCHMARK_DEFAULT_DUMMY_EVENTS 0x10
+
+/**
+ * @brief Default count of the packets of each size and direction of
+ * the transport test
+ */
+#define TEST_TRANSPORT_DEFAULT_PACKETS 0x40
+
+/**
+ * @brief Default count of the threads of each core of the stress test
+ */
+#define TEST_STRESS_DEFAULT_THREADS_PER_CORE 0x2
+
+/**
+ * @brief Maximum count of the threads of each core of the stress test
+ */
+#define TEST_STRESS_MAXIMUM_THREADS_PER_CORE 0x10
+
+/**
+ * @brief Default duration of each scenario of the stress test (in
+ * milliseconds)
+ */
+#define TEST_STRESS_DEFAULT_DURATION 0x1388
+
+/**
+ * @brief Maximum duration of each scenario of the stress test (in
+ * milliseconds)
+ */
+#define TEST_STRESS_MAXIMUM_DURATION 0xea60
+
+/**
+ * @brief The threads of the stress test that are not finished after
+ * the duration plus this time (in milliseconds) are considered as hung
+ * (deadlocked)
+ */
+#define TEST_STRESS_HANG_TIMEOUT 0x2710
+
+/**
+ * @brief Maximum time of waiting for the messages of the stress test to
+ * be delivered (in milliseconds)
+ */
+#define TEST_STRESS_MAXIMUM_DRAIN_TIME 0x2710
+
+//////////////////////////////////////////////////
+//				Overhead Monitor                //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Default interval of sampling the overhead of the hypervisor
+ * (in milliseconds)
+ */
+#define MEASURE_MONITOR_DEFAULT_INTERVAL 1000
+
+/**
+ * @brief Default threshold (percentage of the time of a core that is
+ * spent in vmx-root) of alerting the overhead of the hypervisor
+ */
+#define MEASURE_MONITOR_DEFAULT_THRESHOLD 5
+
+/**
+ * @brief Count of the most expensive exit reasons that are shown in
+ * each sample of the overhead monitor
+ */
+#define MEASURE_MONITOR_TOP_REASONS 5
+
 //////////////////////////////////////////////////
 //				Delay Speeds                    //
 //////////////////////////////////////////////////
@@ -80,3 +173,10 @@
  *  not to eat all of the CPU
  */
 #define DefaultSpeedOfReadingKernelMessages 30
+
+/**
+ * @brief The maximum time (in milliseconds) to wait for the thread of
+ * reading kernel messages to return from the IRP Pending once the vmm
+ * is unloaded
+ */
+#define DefaultTimeoutOfWaitingForMessagesThread 5000
@@ -88,6 +88,15 @@ typedef enum _DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION
     DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_QUERY_PA2VA_AND_VA2PA,
     DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_SYMBOL_QUERY_PTE,
     DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_SET_SHORT_CIRCUITING_STATE,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_BATCH_REQUESTS,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_STEP_AND_TRACE,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_RUN_INSTRUCTIONS,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_TRANSPORT_TEST,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_PATCH_MEMORY,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_REGISTER_EVENTS_BATCH,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_QUERY_EVENTS_STATISTICS,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_EPT_SNAPSHOT,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_HALT_WATCHDOG,
 
     //
     // Debuggee to debugger
@@ -119,6 +128,17 @@ typedef enum _DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION
     DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RELOAD_SEARCH_QUERY,
     DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_PTE,
     DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_VA2PA_AND_PA2VA,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_BATCH_REQUESTS,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_STEP_TRACE,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_RUN_INSTRUCTIONS,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_ADD_MODULE_SYMBOL_INFO,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_TRANSPORT_TEST,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_PATCHING_MEMORY,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_REGISTERING_EVENTS_BATCH,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_QUERY_EVENTS_STATISTICS,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_EPT_SNAPSHOT,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_HALT_WATCHDOG,
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_CONTINUED_BY_HALT_WATCHDOG,
 
     //
     // hardware debuggee to debugger
@@ -176,3 +196,22 @@ typedef struct _DEBUGGER_REMOTE_PACKET
     DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION RequestedActionOfThePacket;
 
 } DEBUGGER_REMOTE_PACKET, *PDEBUGGER_REMOTE_PACKET;
+
+/**
+ * @brief The header of the buffers that are sent over serial
+ * @details the header is sent before the payload, so the receiver reads
+ * exactly Length bytes after it, the receiver resynchronizes on the magic
+ * if the header is corrupted
+ *
+ */
+typedef struct _SERIAL_FRAME_HEADER
+{
+    UINT32 Magic;           // SERIAL_FRAME_MAGIC
+    UINT16 Version;         // SERIAL_FRAME_VERSION
+    UINT16 Flags;           // SERIAL_FRAME_FLAG_*
+    UINT32 Length;          // Length of the payload
+    UINT32 SequenceNumber;  // Incremented by the sender for each frame
+    UINT32 PayloadChecksum; // CRC32 (or CRC32C) of the payload
+    UINT32 HeaderChecksum;  // CRC32 (or CRC32C) of the previous fields of the header
+
+} SERIAL_FRAME_HEADER, *PSERIAL_FRAME_HEADER;
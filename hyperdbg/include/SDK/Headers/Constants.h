@@ -218,6 +218,196 @@ const unsigned char BuildVersion[] = {
  */
 #define UsermodeBufferSize sizeof(UINT32) + PacketChunkSize + 1
 
+/**
+ * @brief size of user-mode buffer for batched reads
+ * @details Multiple messages are returned in this buffer
+ *
+ */
+#define UsermodeBatchedBufferSize 32 * PacketChunkSize
+
+/**
+ * @brief Maximum count of message buffers that are mapped into user-mode
+ * @details each core has four buffers (regular and priority buffers of
+ * vmx-root and vmx non-root)
+ *
+ */
+#define MaximumLogSharedRings (4 * 256)
+
+/**
+ * @brief Maximum count of hidden hooks detour that their hit counts
+ * are queried at once
+ *
+ */
+#define MaximumEptHook2DetoursToQuery 256
+
+/**
+ * @brief Maximum count of virtual addresses that map a physical address
+ * and are returned by '!pa2va all'
+ *
+ */
+#define MaximumReverseMappingsToQuery 256
+
+/**
+ * @brief Maximum count of the records of the coverage of the reversing
+ * machine that are queried at once
+ *
+ */
+#define MaximumReversingMachineCoverageRecordsToQuery 512
+
+/**
+ * @brief Maximum count of the processes that the reversing machine
+ * services at the same time
+ *
+ */
+#define MaximumReversingMachineTargets 16
+
+/**
+ * @brief Count of the results of the results ring of each target of
+ * the reversing machine (power of two)
+ *
+ */
+#define ReversingMachineResultsRingCapacity 0x4000
+
+/**
+ * @brief Count of exit reasons that the statistics of vm-exits are kept for
+ * @details basic exit reasons are from 0 to 69 (LOADIWKEY)
+ *
+ */
+#define MaximumVmexitStatisticsExitReasons 70
+
+/**
+ * @brief Count of buckets of the (log2) histogram of the cycles of vm-exits
+ * @details bucket i counts the vm-exits that are handled in [2^i, 2^(i+1))
+ * cycles, the last bucket also counts all of the longer vm-exits
+ *
+ */
+#define VmexitStatisticsHistogramBuckets 32
+
+/**
+ * @brief Maximum count of the (return address) frames of the stack of
+ * each sample of the sampling profiler
+ *
+ */
+#define SamplingProfilerMaximumStackFrames 8
+
+/**
+ * @brief Maximum count of samples of the sampling profiler that are
+ * transferred in each query
+ *
+ */
+#define MaximumSamplingProfilerSamplesToQuery 512
+
+/**
+ * @brief Count of the 64-bit words of the bitmap of dirty pages that
+ * are transferred in each query (each bit represents a 4KB page)
+ *
+ */
+#define DirtyPagesBitmapWordsToQuery 1024
+
+/**
+ * @brief Maximum count of the ranges of the physical RAM that are
+ * transferred in each query
+ *
+ */
+#define MaximumPhysicalRamRangesToQuery 128
+
+/**
+ * @brief Count of the bytes of the trace of Intel PT (Processor Trace)
+ * that are transferred in each query
+ *
+ */
+#define IntelPtTraceBytesToQuery 0x10000
+
+/**
+ * @brief Maximum count of the address ranges for filtering the trace of
+ * Intel PT (Processor Trace) by IP
+ *
+ */
+#define IntelPtMaximumAddressRanges 2
+
+/**
+ * @brief The default size of the buffer of the trace of Intel PT
+ * (Processor Trace) of each core
+ *
+ */
+#define IntelPtDefaultBufferSize 0x100000
+
+/**
+ * @brief Maximum count of the (RIP, data address) entries of the PEBS
+ * memory access sampling that are transferred in each query
+ *
+ */
+#define MaximumPebsSamplingEntriesToQuery 512
+
+/**
+ * @brief Maximum count of the named spinlock sites (of all the modules)
+ * that are transferred in each query of the lock contention
+ *
+ */
+#define MaximumSpinlockContentionSitesToQuery 128
+
+/**
+ * @brief Maximum count of the events that their hit statistics are
+ * transferred in each query
+ *
+ */
+#define MaximumEventsStatisticsToQuery 128
+
+/**
+ * @brief Maximum length of the name of a named spinlock site
+ *
+ */
+#define MaximumSpinlockSiteNameLength 48
+
+/**
+ * @brief The default count of the sampled events (loads or stores)
+ * between two records of the PEBS memory access sampling
+ *
+ */
+#define PebsSamplingDefaultSampleAfterValue 10007
+
+/**
+ * @brief The default threshold (in cycles) of the latency of the loads
+ * that are sampled by PEBS (the minimum value that the processors support)
+ *
+ */
+#define PebsSamplingDefaultLatencyThreshold 3
+
+/**
+ * @brief Maximum count of the last branch records (LBR) that are shown
+ * by the actions of the events
+ *
+ */
+#define LastBranchRecordsMaximumCount 32
+
+/**
+ * @brief Maximum count of the values (registers or memory reads) of
+ * each record of the hits of the events
+ *
+ */
+#define EventRecordMaximumValues 6
+
+/**
+ * @brief Maximum count of the records of the hits of the events that
+ * are transferred in each query
+ *
+ */
+#define MaximumEventRecordsToQuery 256
+
+/**
+ * @brief Maximum count of arguments of a binary trace record
+ * @details printf calls with more arguments are formatted as text
+ *
+ */
+#define MaximumBinaryTraceArguments 32
+
+/**
+ * @brief Maximum count of return addresses of a stack trace record
+ * (the 'stack' function of the script engine)
+ *
+ */
+#define MaximumScriptStackTraceFrames 64
+
 /**
  * @brief size of buffer for serial
  * @details the maximum packet size for sending over serial
@@ -225,6 +415,69 @@ const unsigned char BuildVersion[] = {
  */
 #define MaxSerialPacketSize 10 * NORMAL_PAGE_SIZE
 
+/**
+ * @brief size of each chunk of memory that is sent over serial
+ * @details larger reads are sent as consecutive chunks for a single request
+ *
+ */
+#define MaxSerialReadMemoryChunkSize 8 * NORMAL_PAGE_SIZE
+
+/**
+ * @brief maximum size of memory that is read by a single request over serial
+ *
+ */
+#define MaxSerialReadMemorySize 0x1000000
+
+/**
+ * @brief maximum size of a batch of requests (or its results) over serial
+ * @details the batch is sent after the header of the packet
+ *
+ */
+#define MaxSerialBatchRequestsSize (MaxSerialPacketSize - sizeof(DEBUGGER_REMOTE_PACKET))
+
+/**
+ * @brief maximum count of the entries of the list of processes or threads
+ * that are sent in a single packet over serial
+ * @details the entries are sent after the switch process (or thread) packet
+ *
+ */
+#define MaxSerialObjectListEntriesInPacket 0x100
+
+/**
+ * @brief maximum size of each chunk of the trace of the steps over serial
+ * @details the chunk is sent after the header of the packet
+ *
+ */
+#define MaxSerialStepTraceChunkSize (MaxSerialPacketSize - sizeof(DEBUGGER_REMOTE_PACKET))
+
+/**
+ * @brief maximum size of the payload of the packets of the transport test
+ * @details the payload is sent after the header of the packet and the
+ * header of the transport test
+ *
+ */
+#define MaxSerialTransportTestPayloadSize \
+    (MaxSerialPacketSize - sizeof(DEBUGGER_REMOTE_PACKET) - sizeof(DEBUGGEE_TRANSPORT_TEST_PACKET))
+
+/**
+ * @brief maximum size of the stream of patches of each patch request
+ * @details the stream is sent after the header of the packet and the
+ * header of the patch request
+ *
+ */
+#define MaxSerialPatchMemoryBufferSize \
+    (MaxSerialPacketSize - sizeof(DEBUGGER_REMOTE_PACKET) - sizeof(DEBUGGER_PATCH_MEMORY_REQUEST))
+
+/**
+ * @brief maximum size of the stream of events and actions of each batch
+ * of events
+ * @details the stream is sent after the header of the packet and the
+ * header of the batch of events
+ *
+ */
+#define MaxSerialEventsBatchBufferSize \
+    (MaxSerialPacketSize - sizeof(DEBUGGER_REMOTE_PACKET) - sizeof(DEBUGGER_EVENTS_BATCH_REQUEST))
+
 /**
  * @brief Final storage size of message tracing
  *
@@ -281,6 +534,35 @@ const unsigned char BuildVersion[] = {
  */
 #define DebuggerScriptEngineMemcpyMovingBufferSize 64
 
+/**
+ * @brief The size of each chunk of memory used in the 'memcmp', 'memset',
+ * 'memsearch', and string comparison functions of the script engine for
+ * accessing buffers in the VMX-root mode (should be a multiple of 8)
+ *
+ */
+#define DebuggerScriptEngineBulkMemoryChunkSize 256
+
+/**
+ * @brief The size of the scratch memory of scripts on each core (buffers
+ * of the 'scratch' function are allocated from it and it's reset before
+ * running each script)
+ *
+ */
+#define DebuggerScriptEngineScratchArenaSize 0x4000
+
+/**
+ * @brief The alignment of the buffers of the 'scratch' function
+ *
+ */
+#define DebuggerScriptEngineScratchAlignment 16
+
+/**
+ * @brief The size of the stack (from the stack pointer) that is scanned
+ * for return addresses by the 'stack' function of the script engine
+ *
+ */
+#define DebuggerScriptEngineStackTraceScanSize 0x800
+
 //////////////////////////////////////////////////
 //               Remote Connection              //
 //////////////////////////////////////////////////
@@ -356,6 +638,35 @@ const unsigned char BuildVersion[] = {
 #define OPERATION_NOTIFICATION_FROM_USER_DEBUGGER_PAUSE \
     0xe | OPERATION_MANDATORY_DEBUGGEE_BIT
 
+#define OPERATION_LOG_BINARY_TRACE_RECORD \
+    0xf | OPERATION_MANDATORY_DEBUGGEE_BIT
+
+#define OPERATION_NOTIFICATION_FROM_KERNEL_MODULE_LOAD \
+    0x10 | OPERATION_MANDATORY_DEBUGGEE_BIT
+
+#define OPERATION_LOG_SCRIPT_STACK_TRACE_RECORD \
+    0x11 | OPERATION_MANDATORY_DEBUGGEE_BIT
+
+#define OPERATION_LOG_STRESS_TEST_MESSAGE \
+    0x12 | OPERATION_MANDATORY_DEBUGGEE_BIT
+
+#define OPERATION_DEBUGGEE_REGISTER_EVENTS_BATCH \
+    0x13 | OPERATION_MANDATORY_DEBUGGEE_BIT
+
+/**
+ * @brief Check whether a message is a part of the bulk traffic of events
+ * (messages of events, non-immediate messages, binary trace records and
+ * stack trace records of scripts)
+ * @details results of commands and other interactive messages are not
+ * bulk and are delivered before the bulk messages
+ */
+#define OPERATION_LOG_IS_BULK_MESSAGE(OperationCode)                       \
+    ((OperationCode) == OPERATION_LOG_NON_IMMEDIATE_MESSAGE ||             \
+     (OperationCode) == (OPERATION_LOG_BINARY_TRACE_RECORD) ||             \
+     (OperationCode) == (OPERATION_LOG_SCRIPT_STACK_TRACE_RECORD) ||       \
+     ((OperationCode) >= DebuggerEventTagStartSeed &&                      \
+      !((OperationCode) & OPERATION_MANDATORY_DEBUGGEE_BIT)))
+
 //////////////////////////////////////////////////
 //            Breakpoint Backup                 //
 //////////////////////////////////////////////////
@@ -366,6 +677,12 @@ const unsigned char BuildVersion[] = {
  */
 #define MAXIMUM_BREAKPOINTS_WITHOUT_CONTINUE 50
 
+/**
+ * @brief maximum size of the (compiled) condition of a single
+ * breakpoint
+ */
+#define MAXIMUM_BREAKPOINT_CONDITION_BUFFER_SIZE 0x400
+
 //////////////////////////////////////////////////
 //          Pool tags used in HyperDbg          //
 //////////////////////////////////////////////////
@@ -377,22 +694,57 @@ const unsigned char BuildVersion[] = {
 #define POOLTAG 0x48444247 // [H]yper[DBG] (HDBG)
 
 //////////////////////////////////////////////////
-//            End of Buffer Detection           //
+//              Serial Packet Framing           //
 //////////////////////////////////////////////////
 
 /**
- * @brief count of characters for serial end of buffer
+ * @brief magic of the header that we set at the start of
+ * buffers for serial ("HDBF")
  */
-#define SERIAL_END_OF_BUFFER_CHARS_COUNT 0x4
+#define SERIAL_FRAME_MAGIC 0x46424448
 
 /**
- * @brief characters of the buffer that we set at the end of
- * buffers for serial
+ * @brief version of the framing of serial buffers
+ */
+#define SERIAL_FRAME_VERSION 0x1
+
+/**
+ * @brief flags of the header of serial buffers
+ * @details a side sends CRC32C frames only after it receives a frame with
+ * SERIAL_FRAME_FLAG_CRC32C_SUPPORTED from the other side, otherwise CRC32
+ * is used so the older versions remain compatible
+ */
+#define SERIAL_FRAME_FLAG_CRC32C                0x1 // Checksums of the frame are CRC32C
+#define SERIAL_FRAME_FLAG_CRC32C_SUPPORTED      0x2 // The sender accepts CRC32C frames
+#define SERIAL_FRAME_FLAG_COMPRESSED            0x4 // The payload is compressed (LZ4 block format)
+#define SERIAL_FRAME_FLAG_COMPRESSION_SUPPORTED 0x8 // The sender accepts compressed frames
+
+/**
+ * @brief minimum length of the payload of serial buffers that
+ * the debuggee tries to compress
+ */
+#define SERIAL_COMPRESSION_THRESHOLD 256
+
+/**
+ * @brief minimum length of the matches of the compressed buffers
+ */
+#define SERIAL_COMPRESSION_MIN_MATCH 4
+
+//////////////////////////////////////////////////
+//              Network Connection              //
+//////////////////////////////////////////////////
+
+/**
+ * @brief maximum length of the payload of each UDP datagram of
+ * the network connection
+ * @details the frames are split into datagrams that fit in a single
+ * ethernet packet (1500 bytes MTU) as there is no IP fragmentation
  */
-#define SERIAL_END_OF_BUFFER_CHAR_1 0x00
-#define SERIAL_END_OF_BUFFER_CHAR_2 0x80
-#define SERIAL_END_OF_BUFFER_CHAR_3 0xEE
-#define SERIAL_END_OF_BUFFER_CHAR_4 0xFF
+#define NETWORK_CONNECTION_MAXIMUM_DATAGRAM_SIZE 1472
+
+//////////////////////////////////////////////////
+//            End of Buffer Detection           //
+//////////////////////////////////////////////////
 
 /**
  * @brief count of characters for tcp end of buffer
@@ -436,12 +788,6 @@ const unsigned char BuildVersion[] = {
 //              Symbols Details                 //
 //////////////////////////////////////////////////
 
-/**
- * @brief maximum supported modules to load
- * their symbol informations
- */
-#define MAXIMUM_SUPPORTED_SYMBOLS 1000
-
 /**
  * @brief maximum size for GUID and Age of PE
  * @detail It seems that 33 bytes is enough but let's
@@ -468,6 +814,26 @@ const unsigned char BuildVersion[] = {
  */
 #define MaximumSearchResults 0x1000
 
+/**
+ * @brief maximum count of patterns that are searched at once by !s* s*
+ * command
+ *
+ */
+#define MaximumSearchPatterns 8
+
+/**
+ * @brief maximum size of each pattern of !s* s* command (in bytes)
+ *
+ */
+#define MaximumSearchPatternSize 0x100
+
+/**
+ * @brief count of results of !s* s* command that are sent together in
+ * the debugger mode
+ *
+ */
+#define SearchResultsBatchSize 64
+
 //////////////////////////////////////////////////
 //                 Script Engine                //
 //////////////////////////////////////////////////
@@ -550,12 +916,26 @@ const unsigned char BuildVersion[] = {
  */
 #define DEBUGGER_EVENT_APPLY_TO_ALL_CORES 0xffffffff
 
+/**
+ * @brief The mask of cores that targets all the cores
+ * @details each bit of the masks of cores is a core (the cores that
+ * are not representable in the mask are only targeted by this mask)
+ *
+ */
+#define DEBUGGER_BROADCASTING_ALL_CORES_MASK 0xffffffffffffffff
+
 /**
  * @brief Apply the event to all the processes
  *
  */
 #define DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES 0xffffffff
 
+/**
+ * @brief Apply the event to all the threads
+ *
+ */
+#define DEBUGGER_EVENT_APPLY_TO_ALL_THREADS 0xffffffff
+
 /**
  * @brief Apply to all Model Specific Registers
  *
@@ -574,6 +954,20 @@ const unsigned char BuildVersion[] = {
  */
 #define DEBUGGER_EVENT_SYSCALL_ALL_SYSRET_OR_SYSCALLS 0xffffffff
 
+/**
+ * @brief Count of the syscall numbers that are covered by the filter
+ * of syscall events (nt and win32k system calls)
+ *
+ */
+#define DEBUGGER_EVENT_SYSCALL_FILTER_MAXIMUM_NUMBER 0x2000
+
+/**
+ * @brief Maximum count of the distinct leaves that are covered by the
+ * filter of CPUID events
+ *
+ */
+#define DEBUGGER_EVENT_CPUID_FILTER_MAXIMUM_LEAVES 64
+
 /**
  * @brief Apply to all I/O ports
  *
@@ -28,6 +28,25 @@ typedef enum _PAGING_LEVEL
     PagingLevelPageMapLevel4
 } PAGING_LEVEL;
 
+/**
+ * @brief The result of walking the page tables for a virtual address
+ * @details the entries of the levels below the leaf (or the first entry
+ * that is not present) are not walked
+ *
+ */
+typedef struct _PAGE_TABLE_WALK_RESULT
+{
+    UINT64       EntriesVirtualAddresses[4]; // Virtual address of the entry of each level (indexed by PAGING_LEVEL)
+    PAGING_LEVEL LeafLevel;                  // The level of the last walked entry
+    UINT64       PhysicalAddress;            // The translated physical address (zero if it's not present)
+    UINT64       PageSize;                   // Size of the page (4KB, 2MB or 1GB)
+    BOOLEAN      IsPresent;                  // Whether the address is mapped or not
+    BOOLEAN      IsWritable;                 // Writable on all of the levels
+    BOOLEAN      IsUser;                     // Accessible from user-mode on all of the levels
+    BOOLEAN      IsExecutable;               // Execute-disable is not set on any of the levels
+
+} PAGE_TABLE_WALK_RESULT, *PPAGE_TABLE_WALK_RESULT;
+
 //////////////////////////////////////////////////
 //                 Pool Manager      			//
 //////////////////////////////////////////////////
@@ -44,9 +63,17 @@ typedef enum _POOL_ALLOCATION_INTENTION
     DETOUR_HOOK_DETAILS,
     BREAKPOINT_DEFINITION_STRUCTURE,
     PROCESS_THREAD_HOLDER,
+    HIDDEN_BREAKPOINTS_SET,
+    EPT_SNAPSHOT_PAGE_COPY,
 
 } POOL_ALLOCATION_INTENTION;
 
+/**
+ * @brief Count of intentions of pools (POOL_ALLOCATION_INTENTION)
+ *
+ */
+#define NumberOfPoolIntentions (EPT_SNAPSHOT_PAGE_COPY + 1)
+
 //////////////////////////////////////////////////
 //	   	Debug Registers Modifications 	    	//
 //////////////////////////////////////////////////
@@ -164,9 +191,24 @@ typedef struct _DEBUGGEE_KD_PAUSED_PACKET
     UINT64                  Rflags;
     BYTE                    InstructionBytesOnRip[MAXIMUM_INSTR_SIZE];
     UINT16                  ReadInstructionLen;
+    UINT64                  Tsc; // the time-stamp counter once the debuggee is paused
 
 } DEBUGGEE_KD_PAUSED_PACKET, *PDEBUGGEE_KD_PAUSED_PACKET;
 
+/**
+ * @brief Callback type that is called with the pausing packet once
+ * the debuggee is paused (e.g., an event is triggered)
+ *
+ */
+typedef VOID (*EventCallback)(PDEBUGGEE_KD_PAUSED_PACKET PausePacket);
+
+/**
+ * @brief Callback type that is called once the debuggee is paused after
+ * an asynchronous request (e.g., continuing the debuggee)
+ *
+ */
+typedef VOID (*DebuggeePausedCallback)(PVOID Context);
+
 /* ==============================================================================================
  */
 
@@ -208,7 +250,9 @@ static_assert(sizeof(DEBUGGEE_UD_PAUSED_PACKET) < PacketChunkSize,
 typedef enum _NOTIFY_TYPE
 {
     IRP_BASED,
-    EVENT_BASED
+    EVENT_BASED,
+    IRP_BASED_BATCHED,  // IRP based, but multiple messages are returned in one buffer
+    SHARED_MEMORY_BASED // Message buffers are mapped into the user-mode and an event is signaled
 } NOTIFY_TYPE;
 
 //////////////////////////////////////////////////
@@ -237,6 +281,348 @@ typedef struct _REGISTER_NOTIFY_BUFFER
 
 } REGISTER_NOTIFY_BUFFER, *PREGISTER_NOTIFY_BUFFER;
 
+/**
+ * @brief Header of each message in the buffer of batched (IRP_BASED_BATCHED) reads
+ * @details the operation code is located right before the message so each message
+ * has the same layout as the buffer of non-batched reads, messages are null-terminated
+ * and each message starts at an address aligned to USERMODE_BATCHED_MESSAGE_ALIGNMENT
+ *
+ */
+typedef struct _USERMODE_BATCHED_MESSAGE_HEADER
+{
+    UINT64 TriggerTimestamp; // Time-stamp counter of triggering the event of the message (or zero)
+    UINT64 Timestamp;        // Time-stamp counter of saving the message in the kernel buffer
+    UINT64 ReadTimestamp;    // Time-stamp counter of reading the message from the kernel buffer
+    UINT32 BufferLength;     // The actual length of the message (without the null-terminator)
+    UINT32 OperationCode;
+
+} USERMODE_BATCHED_MESSAGE_HEADER, *PUSERMODE_BATCHED_MESSAGE_HEADER;
+
+/**
+ * @brief Alignment of messages in the buffer of batched reads
+ *
+ */
+#define USERMODE_BATCHED_MESSAGE_ALIGNMENT 8
+
+/**
+ * @brief Size of a message (header + message + null-terminator) in the buffer of batched reads
+ *
+ */
+#define USERMODE_BATCHED_MESSAGE_SIZE(BufferLength)                                    \
+    ((sizeof(USERMODE_BATCHED_MESSAGE_HEADER) + (BufferLength) + 1 +                   \
+      USERMODE_BATCHED_MESSAGE_ALIGNMENT - 1) &                                        \
+     ~(USERMODE_BATCHED_MESSAGE_ALIGNMENT - 1))
+
+/**
+ * @brief Header of each chunk of the message buffers
+ * @details the message (null-terminated) is located right after the header
+ *
+ */
+typedef struct _BUFFER_HEADER
+{
+    UINT32 OpeationNumber;   // Operation ID to user-mode
+    UINT32 BufferLength;     // The actual length
+    UINT64 Timestamp;        // Time-stamp counter of the message, without the skew of the core (used for ordering messages of different cores)
+    UINT64 TriggerTimestamp; // Time-stamp counter of triggering the event of the message in vmx-root (or zero)
+} BUFFER_HEADER, *PBUFFER_HEADER;
+
+/**
+ * @brief Indexes of a message buffer
+ * @details indexes are free-running, the chunk of an index is located at
+ * (Index & (PacketsCapacity - 1)) and chunks are available to read when the
+ * send index is not equal to the write index
+ *
+ */
+typedef struct _LOG_RING_INDEXES
+{
+    volatile UINT32 CurrentIndexToSend;  // Current buffer index to send to user-mode
+    volatile UINT32 CurrentIndexToWrite; // Current buffer index to write new messages
+
+} LOG_RING_INDEXES, *PLOG_RING_INDEXES;
+
+/**
+ * @brief The notification page of the shared buffers
+ * @details the kernel increments PublishedSequence once a message is saved and
+ * only signals the event if the previous sequence is equal to ConsumedSequence
+ * (the consumer has read everything), the consumer saves the published sequence
+ * before reading the rings and keeps reading until the published sequence is
+ * not changed after updating ConsumedSequence, this page is writable by the
+ * user-mode
+ *
+ */
+typedef struct _LOG_SHARED_NOTIFICATION
+{
+    volatile LONG64 PublishedSequence; // Count of the published messages (written by the kernel)
+    volatile LONG64 ConsumedSequence;  // The published sequence that is read by the consumer
+
+} LOG_SHARED_NOTIFICATION, *PLOG_SHARED_NOTIFICATION;
+
+/**
+ * @brief A message buffer that is mapped into the user-mode
+ *
+ */
+typedef struct _LOG_SHARED_RING
+{
+    UINT64  BufferAddress;   // User-mode address of the first chunk
+    UINT32  PacketsCapacity; // Count of chunks of the buffer (power of two)
+    BOOLEAN IsPriority;      // Whether the buffer holds priority messages
+
+} LOG_SHARED_RING, *PLOG_SHARED_RING;
+
+/**
+ * @brief The result of registering a SHARED_MEMORY_BASED notification
+ * @details the mappings are read-only (except the notification page), ring i
+ * uses the indexes at IndexesAddress[i] and chunks of rings are used by the
+ * user-mode until they are released by IOCTL_RELEASE_SHARED_MESSAGES
+ *
+ */
+typedef struct _LOG_SHARED_BUFFERS
+{
+    UINT32          CountOfRings;
+    UINT32          ChunkSize;           // Size of each chunk (BUFFER_HEADER + message)
+    UINT64          IndexesAddress;      // User-mode address of the LOG_RING_INDEXES array
+    UINT64          NotificationAddress; // User-mode address of the LOG_SHARED_NOTIFICATION
+    LOG_SHARED_RING Rings[MaximumLogSharedRings];
+
+} LOG_SHARED_BUFFERS, *PLOG_SHARED_BUFFERS;
+
+#define SIZEOF_LOG_SHARED_BUFFERS sizeof(LOG_SHARED_BUFFERS)
+
+/**
+ * @brief Request to release the chunks of the shared message buffers
+ * @details the new send index of each ring, rings that their index
+ * is not changed are ignored
+ *
+ */
+typedef struct _LOG_SHARED_BUFFERS_RELEASE
+{
+    UINT32 CountOfRings;
+    UINT32 CurrentIndexToSend[MaximumLogSharedRings];
+
+} LOG_SHARED_BUFFERS_RELEASE, *PLOG_SHARED_BUFFERS_RELEASE;
+
+#define SIZEOF_LOG_SHARED_BUFFERS_RELEASE sizeof(LOG_SHARED_BUFFERS_RELEASE)
+
+/**
+ * @brief Statistics of a message buffer
+ *
+ */
+typedef struct _LOG_BUFFER_STATISTICS
+{
+    UINT32 PacketsCapacity;   // Current count of chunks of the buffer
+    UINT32 HighWaterMark;     // Maximum count of chunks that were waiting to be read at the same time
+    UINT64 DroppedMessages;   // Messages that are not saved as the buffer was full
+    UINT64 DiscardedMessages; // Messages that are discarded before being read (flushed)
+
+} LOG_BUFFER_STATISTICS, *PLOG_BUFFER_STATISTICS;
+
+//////////////////////////////////////////////////
+//          Reversing Machine Results           //
+//////////////////////////////////////////////////
+
+/**
+ * @brief An access of the user-mode code of a target process to the memory
+ * that is intercepted by the reversing machine
+ * @details the producers clear the sequence, save the result and then set
+ * the sequence to the index of the result plus one, so a result is only
+ * valid if its sequence is the same before and after reading it
+ *
+ */
+typedef struct _REVERSING_MACHINE_RESULT
+{
+    volatile UINT64 Sequence;             // Index of the result plus one (zero while it's written)
+    UINT64          Tsc;                  // The time-stamp counter once the result is saved
+    UINT64          GuestRip;             // Address of the instruction that accessed the memory
+    UINT64          GuestPhysicalAddress; // The accessed physical address
+    UINT32          ThreadId;
+    UINT32          CoreId;
+
+} REVERSING_MACHINE_RESULT, *PREVERSING_MACHINE_RESULT;
+
+/**
+ * @brief The results ring of a target process of the reversing machine
+ * @details the ring is mapped read-only into the consumer, the producers
+ * never wait for the consumer, so the old results are overwritten once the
+ * ring is full, and the consumer detects these results by comparing its
+ * index with CurrentIndexToWrite
+ *
+ */
+typedef struct _REVERSING_MACHINE_RESULTS_RING
+{
+    volatile UINT64          CurrentIndexToWrite; // Count of the results that are reserved
+    UINT32                   ProcessId;
+    UINT32                   Capacity; // Count of the results of the ring (power of two)
+    REVERSING_MACHINE_RESULT Results[ReversingMachineResultsRingCapacity];
+
+} REVERSING_MACHINE_RESULTS_RING, *PREVERSING_MACHINE_RESULTS_RING;
+
+//////////////////////////////////////////////////
+//              Hidden Hooks Detour             //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Hit count of a hidden hook detour (!epthook2)
+ *
+ */
+typedef struct _EPT_HOOK2_DETOUR_HIT_DETAILS
+{
+    UINT64 HookedFunctionAddress;
+    UINT64 HitCount;
+
+} EPT_HOOK2_DETOUR_HIT_DETAILS, *PEPT_HOOK2_DETOUR_HIT_DETAILS;
+
+//////////////////////////////////////////////////
+//             Reverse Address Mapping          //
+//////////////////////////////////////////////////
+
+/**
+ * @brief A virtual address that maps a physical address (!pa2va all)
+ *
+ */
+typedef struct _REVERSE_MAPPING_DETAILS
+{
+    UINT32 ProcessId;
+    UINT64 VirtualAddress;
+
+} REVERSE_MAPPING_DETAILS, *PREVERSE_MAPPING_DETAILS;
+
+//////////////////////////////////////////////////
+//              Vm-exit Statistics              //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Statistics of handling a single exit reason
+ *
+ */
+typedef struct _VMEXIT_REASON_STATISTICS
+{
+    UINT64 Count;         // Count of the handled vm-exits
+    UINT64 TotalCycles;   // Sum of the cycles (rdtsc) of handling the vm-exits
+    UINT64 MaximumCycles; // The longest vm-exit
+    UINT64 Histogram[VmexitStatisticsHistogramBuckets];
+
+} VMEXIT_REASON_STATISTICS, *PVMEXIT_REASON_STATISTICS;
+
+//////////////////////////////////////////////////
+//               Sampling Profiler              //
+//////////////////////////////////////////////////
+
+/**
+ * @brief A sample of the guest that is taken by the sampling profiler
+ *
+ */
+typedef struct _SAMPLING_PROFILER_SAMPLE
+{
+    UINT64  Rip;
+    UINT64  Cr3;
+    UINT32  CoreId;
+    BOOLEAN IsUserMode;
+    UINT32  CountOfStackFrames; // Count of the valid entries of StackFrames
+    UINT64  StackFrames[SamplingProfilerMaximumStackFrames];
+
+} SAMPLING_PROFILER_SAMPLE, *PSAMPLING_PROFILER_SAMPLE;
+
+/**
+ * @brief The count of the sampled memory accesses of an instruction to an
+ * address that are recorded by PEBS
+ *
+ */
+typedef struct _PEBS_SAMPLING_ENTRY
+{
+    UINT64 Rip;         // The instruction that accessed the memory
+    UINT64 DataAddress; // The (linear) address that is accessed
+    UINT64 Count;       // Count of the records of the access
+
+} PEBS_SAMPLING_ENTRY, *PPEBS_SAMPLING_ENTRY;
+
+/**
+ * @brief A range of the physical memory that is backed by RAM
+ *
+ */
+typedef struct _PHYSICAL_RAM_RANGE
+{
+    UINT64 BaseAddress;
+    UINT64 Size;
+
+} PHYSICAL_RAM_RANGE, *PPHYSICAL_RAM_RANGE;
+
+//////////////////////////////////////////////////
+//              Binary Trace Records            //
+//////////////////////////////////////////////////
+
+/**
+ * @brief An argument of a binary trace record
+ *
+ */
+typedef struct _BINARY_TRACE_ARGUMENT
+{
+    UINT64 Value;    // The raw value of the argument
+    UINT32 Position; // Position of the format specifier in the format string
+    UINT32 Reserved;
+
+} BINARY_TRACE_ARGUMENT, *PBINARY_TRACE_ARGUMENT;
+
+/**
+ * @brief Binary trace record of printf
+ * @details instead of formatting the message in the kernel, the identifier
+ * of the format string and the raw values are saved and the message is
+ * formatted by the user-mode, the arguments are located right after this
+ * structure
+ *
+ */
+typedef struct _BINARY_TRACE_RECORD
+{
+    UINT64 Tag;            // Tag of the event
+    UINT64 Tsc;            // Time-stamp counter once the record is made
+    UINT32 FormatId;       // Computed by BinaryTraceGetFormatId
+    UINT32 ArgumentsCount; // Count of BINARY_TRACE_ARGUMENTs
+    UINT32 CoreId;         // The core that made the record
+    UINT32 ProcessId;      // The process that made the record
+    UINT32 ThreadId;       // The thread that made the record
+    UINT32 Reserved;
+
+} BINARY_TRACE_RECORD, *PBINARY_TRACE_RECORD;
+
+/**
+ * @brief Stack trace record of the 'stack' function of the script engine
+ * @details only the raw return addresses are saved and they're resolved to
+ * symbols by the user-mode, the return addresses (UINT64) are located right
+ * after this structure (the innermost frame first)
+ *
+ */
+typedef struct _SCRIPT_STACK_TRACE_RECORD
+{
+    UINT64 Tag;         // Tag of the event
+    UINT64 Tsc;         // Time-stamp counter once the record is made
+    UINT32 CoreId;      // The core that made the record
+    UINT32 ProcessId;   // The process that made the record
+    UINT32 ThreadId;    // The thread that made the record
+    UINT32 FramesCount; // Count of the return addresses
+
+} SCRIPT_STACK_TRACE_RECORD, *PSCRIPT_STACK_TRACE_RECORD;
+
+/**
+ * @brief Get the identifier of a format string of binary trace records
+ * @details FNV-1a hash of the format string, both of the kernel and the
+ * script engine use this function so they compute the same identifier
+ *
+ * @param Format
+ * @return UINT32 The identifier (never zero)
+ */
+static inline UINT32
+BinaryTraceGetFormatId(const char * Format)
+{
+    UINT32 Hash = 0x811c9dc5;
+
+    while (*Format)
+    {
+        Hash ^= (unsigned char)*Format++;
+        Hash *= 0x01000193;
+    }
+
+    return Hash == 0 ? 1 : Hash;
+}
+
 //////////////////////////////////////////////////
 //                  EPT Hook                    //
 //////////////////////////////////////////////////
@@ -251,6 +637,34 @@ typedef struct _EPT_HOOKS_CONTEXT
     UINT64 VirtualAddress;
 } EPT_HOOKS_CONTEXT, *PEPT_HOOKS_CONTEXT;
 
+/**
+ * @brief Type of hooks that are applied in a batch
+ *
+ */
+typedef enum _EPT_HOOKS_BATCH_HOOK_TYPE
+{
+    EPT_HOOKS_BATCH_HIDDEN_BREAKPOINT, // !epthook
+    EPT_HOOKS_BATCH_HIDDEN_DETOURS,    // !epthook2
+    EPT_HOOKS_BATCH_MONITOR,           // !monitor
+
+} EPT_HOOKS_BATCH_HOOK_TYPE;
+
+/**
+ * @brief An entry of the hooks that are applied in a batch
+ *
+ */
+typedef struct _EPT_HOOKS_BATCH_ENTRY
+{
+    UINT64                    VirtualAddress;  // Target address
+    UINT32                    ProcessId;       // Process id to translate the address (0 for the current process)
+    EPT_HOOKS_BATCH_HOOK_TYPE HookType;        // Type of the hook
+    BOOLEAN                   SetHookForRead;  // Only used in monitor hooks
+    BOOLEAN                   SetHookForWrite; // Only used in monitor hooks
+    BOOLEAN                   SetHookForExec;  // Only used in monitor hooks
+    UINT32                    KernelStatus;    // Result of applying this hook
+
+} EPT_HOOKS_BATCH_ENTRY, *PEPT_HOOKS_BATCH_ENTRY;
+
 //////////////////////////////////////////////////
 //                 Segment Types                //
 //////////////////////////////////////////////////
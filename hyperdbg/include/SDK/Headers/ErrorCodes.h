@@ -398,6 +398,344 @@
  */
 #define DEBUGGER_ERROR_UNKNOWN_TEST_QUERY_RECEIVED 0xc000003b
 
+/**
+ * @brief error, unable to trace the execution of the pages as mode-based
+ * execution control (MBEC) is not supported or is used by another feature
+ *
+ */
+#define DEBUGGER_ERROR_MODE_BASED_EXECUTION_TRACE_IS_NOT_AVAILABLE 0xc000003c
+
+/**
+ * @brief error, the range of the execution trace exceeds the maximum
+ * count of traced pages
+ *
+ */
+#define DEBUGGER_ERROR_EXECUTION_TRACE_RANGE_IS_TOO_LARGE 0xc000003d
+
+/**
+ * @brief error, unable to allocate the buffers for coalescing the
+ * accesses of the monitor
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_MONITOR_COALESCING_STATE 0xc000003e
+
+/**
+ * @brief error, unable to build the index of the virtual addresses
+ * that map the physical addresses
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_BUILD_REVERSE_MAPPING_INDEX 0xc000003f
+
+/**
+ * @brief error, the request is not allowed in a batch of requests
+ * or the batch is malformed
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_BATCH_REQUEST 0xc0000040
+
+/**
+ * @brief error, the network adapter for the debuggee is not
+ * found or it's not supported
+ *
+ */
+#define DEBUGGER_ERROR_PREPARING_DEBUGGEE_NETWORK_ADAPTER_NOT_SUPPORTED 0xc0000041
+
+/**
+ * @brief error, the debugger is not reachable over the network
+ * (no ARP reply is received)
+ *
+ */
+#define DEBUGGER_ERROR_PREPARING_DEBUGGEE_DEBUGGER_NOT_REACHABLE 0xc0000042
+
+/**
+ * @brief error, the type of the step or the count of the steps
+ * is not valid for tracing the steps
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_STEP_TRACE_REQUEST 0xc0000043
+
+/**
+ * @brief error, unable to allocate the statistics of vm-exits
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_VMEXIT_STATISTICS 0xc0000044
+
+/**
+ * @brief error, unable to allocate the buffers of the sampling profiler
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_SAMPLING_PROFILER 0xc0000045
+
+/**
+ * @brief error, the processor doesn't support the VMX preemption timer
+ *
+ */
+#define DEBUGGER_ERROR_VMX_PREEMPTION_TIMER_IS_NOT_SUPPORTED 0xc0000046
+
+/**
+ * @brief error, unable to allocate the buffers for limiting the rate of
+ * triggering the event
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_EVENT_RATE_LIMIT_STATE 0xc0000047
+
+/**
+ * @brief error, the processor doesn't support page-modification logging (PML)
+ *
+ */
+#define DEBUGGER_ERROR_PML_IS_NOT_SUPPORTED 0xc0000048
+
+/**
+ * @brief error, unable to allocate the bitmaps of the dirty pages
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_DIRTY_PAGES_BITMAP 0xc0000049
+
+/**
+ * @brief error, the tracking of dirty pages is not enabled
+ *
+ */
+#define DEBUGGER_ERROR_DIRTY_PAGES_TRACKING_IS_NOT_ENABLED 0xc000004a
+
+/**
+ * @brief error, the processor doesn't support Intel PT (Processor Trace)
+ * or its requested filters in VMX non-root
+ *
+ */
+#define DEBUGGER_ERROR_INTEL_PT_IS_NOT_SUPPORTED 0xc000004b
+
+/**
+ * @brief error, unable to allocate the buffers of the trace of Intel PT
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_INTEL_PT_BUFFERS 0xc000004c
+
+/**
+ * @brief error, the trace of Intel PT is not enabled
+ *
+ */
+#define DEBUGGER_ERROR_INTEL_PT_IS_NOT_ENABLED 0xc000004d
+
+/**
+ * @brief error, invalid configuration (size of the buffers, address
+ * ranges or process) for the trace of Intel PT
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_INTEL_PT_CONFIGURATION 0xc000004e
+
+/**
+ * @brief error, the last branch records (LBR) are not supported on
+ * the processor
+ *
+ */
+#define DEBUGGER_ERROR_LAST_BRANCH_RECORDS_ARE_NOT_SUPPORTED 0xc000004f
+
+/**
+ * @brief error, the coverage of the reversing machine couldn't be started
+ * (MBEC is not supported, the reversing machine is already initialized, or
+ * the buffers couldn't be allocated)
+ *
+ */
+#define DEBUGGER_ERROR_REVERSING_MACHINE_COVERAGE_IS_NOT_AVAILABLE 0xc0000050
+
+/**
+ * @brief error, the coverage of the reversing machine is not started
+ *
+ */
+#define DEBUGGER_ERROR_REVERSING_MACHINE_COVERAGE_IS_NOT_ENABLED 0xc0000051
+
+/**
+ * @brief error, the process couldn't be added to the targets of the reversing
+ * machine (it's already a target, the maximum count of the targets is reached,
+ * or the coverage is started)
+ *
+ */
+#define DEBUGGER_ERROR_REVERSING_MACHINE_UNABLE_TO_ADD_TARGET 0xc0000052
+
+/**
+ * @brief error, the results ring of the target of the reversing machine
+ * couldn't be mapped (or unmapped)
+ *
+ */
+#define DEBUGGER_ERROR_REVERSING_MACHINE_UNABLE_TO_MAP_RESULTS 0xc0000053
+
+/**
+ * @brief error, the processor doesn't support the memory access sampling
+ * of PEBS (Precise Event Based Sampling) in VMX non-root
+ *
+ */
+#define DEBUGGER_ERROR_PEBS_IS_NOT_SUPPORTED 0xc0000054
+
+/**
+ * @brief error, invalid configuration (events, address range or sampling
+ * rate) for the memory access sampling of PEBS
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_PEBS_CONFIGURATION 0xc0000055
+
+/**
+ * @brief error, unable to allocate the buffers of the memory access
+ * sampling of PEBS
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_PEBS_BUFFERS 0xc0000056
+
+/**
+ * @brief error, counting the retired instructions of the guest is not
+ * supported, the performance counters are used by the PEBS sampling or
+ * the count is more than the width of the counter
+ *
+ */
+#define DEBUGGER_ERROR_INSTRUCTION_COUNTER_IS_NOT_AVAILABLE 0xc0000057
+
+/**
+ * @brief error, the count of the instructions to run is invalid (zero)
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_INSTRUCTION_BUDGET 0xc0000058
+
+/**
+ * @brief error, the target thread of the user debugger is not found or
+ * it's not paused
+ *
+ */
+#define DEBUGGER_ERROR_UD_THREAD_IS_NOT_PAUSED 0xc0000059
+
+/**
+ * @brief error, invalid action or register for the user debugger command
+ *
+ */
+#define DEBUGGER_ERROR_UD_INVALID_ACTION_OR_REGISTER 0xc000005a
+
+/**
+ * @brief error, there is no room for more actions of the paused thread
+ *
+ */
+#define DEBUGGER_ERROR_UD_ACTIONS_OF_THREAD_ARE_FULL 0xc000005b
+
+/**
+ * @brief error, the condition of the breakpoint is invalid or too large
+ *
+ */
+#define DEBUGGER_ERROR_BREAKPOINT_INVALID_CONDITION 0xc000005c
+
+/**
+ * @brief error, the thread id is invalid
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_THREAD_ID 0xc000005d
+
+/**
+ * @brief error, the parameters of the benchmark are invalid
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_BENCHMARK_PARAMETERS 0xc000005e
+
+/**
+ * @brief error, the payload of the transport test is corrupted
+ *
+ */
+#define DEBUGGER_ERROR_TRANSPORT_TEST_PAYLOAD_MISMATCH 0xc000005f
+
+/**
+ * @brief error, the parameters of the stress test are invalid
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_STRESS_TEST_PARAMETERS 0xc0000060
+
+/**
+ * @brief error, unable to create the threads of the stress test
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_CREATE_STRESS_TEST_THREADS 0xc0000061
+
+/**
+ * @brief error, the entry of system calls (LSTAR) is not supported
+ * for hooking system calls
+ *
+ */
+#define DEBUGGER_ERROR_SYSCALL_ENTRY_IS_NOT_SUPPORTED 0xc0000062
+
+/**
+ * @brief error, the entry of the interrupt in the IDT is not supported
+ * for hooking interrupts
+ *
+ */
+#define DEBUGGER_ERROR_INTERRUPT_ENTRY_IS_NOT_SUPPORTED 0xc0000063
+
+/**
+ * @brief error, the stream of events and actions of the batch of
+ * events is not valid
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_EVENTS_BATCH 0xc0000064
+
+/**
+ * @brief error, unable to allocate the per-core statistics of the event
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_EVENT_STATISTICS 0xc0000065
+
+/**
+ * @brief error, the snapshot cannot be used while the EPT hooks or the
+ * other EPT page tables (e.g., the reversing machine) are used
+ *
+ */
+#define DEBUGGER_ERROR_EPT_SNAPSHOT_CONFLICTS_WITH_EPT_HOOKS 0xc0000066
+
+/**
+ * @brief error, there is no taken snapshot
+ *
+ */
+#define DEBUGGER_ERROR_EPT_SNAPSHOT_IS_NOT_TAKEN 0xc0000067
+
+/**
+ * @brief error, a snapshot is already taken
+ *
+ */
+#define DEBUGGER_ERROR_EPT_SNAPSHOT_IS_ALREADY_TAKEN 0xc0000068
+
+/**
+ * @brief error, the snapshot should be restored on the core that it's
+ * taken on
+ *
+ */
+#define DEBUGGER_ERROR_EPT_SNAPSHOT_IS_TAKEN_ON_ANOTHER_CORE 0xc0000069
+
+/**
+ * @brief error, some of the written pages are not copied as there were
+ * not enough pre-allocated buffers, so the snapshot cannot be restored
+ *
+ */
+#define DEBUGGER_ERROR_EPT_SNAPSHOT_PAGES_ARE_EXHAUSTED 0xc000006a
+
+/**
+ * @brief error, unable to allocate the buffers of the records of the
+ * hits of the events
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_EVENT_RECORDS 0xc000006b
+
+/**
+ * @brief error, the range is invalid, overlaps with another range of
+ * the event, the event has too many ranges, or the event is not a
+ * monitor event
+ *
+ */
+#define DEBUGGER_ERROR_MONITOR_RANGE_IS_INVALID 0xc000006c
+
+/**
+ * @brief error, the range is not one of the ranges of the monitor event
+ *
+ */
+#define DEBUGGER_ERROR_MONITOR_RANGE_NOT_FOUND 0xc000006d
+
+/**
+ * @brief error, unable to allocate the ranges of the monitor event
+ *
+ */
+#define DEBUGGER_ERROR_UNABLE_TO_ALLOCATE_MONITOR_RANGES 0xc000006e
+
 //
 // WHEN YOU ADD ANYTHING TO THIS LIST OF ERRORS, THEN
 // MAKE SURE TO ADD AN ERROR MESSAGE TO ShowErrorMessage(UINT32 Error)
@@ -140,6 +140,8 @@ typedef enum _VMM_EVENT_TYPE_ENUM
     CONTROL_REGISTER_MODIFIED,
     CONTROL_REGISTER_READ,
 
+    PAGE_FIRST_EXECUTION,
+
 } VMM_EVENT_TYPE_ENUM;
 
 /**
@@ -150,7 +152,9 @@ typedef enum _DEBUGGER_EVENT_ACTION_TYPE_ENUM
 {
     BREAK_TO_DEBUGGER,
     RUN_SCRIPT,
-    RUN_CUSTOM_CODE
+    RUN_CUSTOM_CODE,
+    SHOW_LAST_BRANCH_RECORDS,
+    RECORD_HITS
 
 } DEBUGGER_EVENT_ACTION_TYPE_ENUM;
 
@@ -162,9 +166,62 @@ typedef enum _DEBUGGER_EVENT_SYSCALL_SYSRET_TYPE
 {
     DEBUGGER_EVENT_SYSCALL_SYSRET_SAFE_ACCESS_MEMORY = 0,
     DEBUGGER_EVENT_SYSCALL_SYSRET_HANDLE_ALL_UD      = 1,
+    DEBUGGER_EVENT_SYSCALL_SYSRET_LSTAR_ENTRY_HOOK   = 2,
 
 } DEBUGGER_EVENT_SYSCALL_SYSRET_TYPE;
 
+/**
+ * @brief Type of handling !interrupt
+ *
+ */
+typedef enum _DEBUGGER_EVENT_INTERRUPT_TYPE
+{
+    DEBUGGER_EVENT_INTERRUPT_EXTERNAL_INTERRUPT_EXITING = 0,
+    DEBUGGER_EVENT_INTERRUPT_IDT_ENTRY_HOOK             = 1,
+
+} DEBUGGER_EVENT_INTERRUPT_TYPE;
+
+/**
+ * @brief Type of the execution that is traced by !exectrace
+ *
+ */
+typedef enum _DEBUGGER_EVENT_EXEC_TRACE_MODE_TYPE
+{
+    DEBUGGER_EVENT_EXEC_TRACE_USER_MODE   = 0,
+    DEBUGGER_EVENT_EXEC_TRACE_KERNEL_MODE = 1,
+
+} DEBUGGER_EVENT_EXEC_TRACE_MODE_TYPE;
+
+/**
+ * @brief Summary of the coalesced accesses of a !monitor event
+ * @details if the accesses of a monitor are coalesced, a pointer to
+ * this structure is passed as the context of the event instead of
+ * the accessed address
+ *
+ */
+typedef struct _DEBUGGER_EVENT_MONITOR_ACCESS_SUMMARY
+{
+    UINT64 AccessCount;    // Count of accesses that are coalesced
+    UINT64 LowestAddress;  // Lowest accessed virtual address
+    UINT64 HighestAddress; // Highest accessed virtual address
+    UINT64 LastAddress;    // The virtual address of the last access
+
+} DEBUGGER_EVENT_MONITOR_ACCESS_SUMMARY, *PDEBUGGER_EVENT_MONITOR_ACCESS_SUMMARY;
+
+/**
+ * @brief The cost of running the scripts of an event
+ *
+ */
+typedef struct _DEBUGGER_EVENT_SCRIPT_STATISTICS
+{
+    UINT64 Invocations;  // Count of the runs of the scripts
+    UINT64 TotalTsc;     // TSC cycles that are spent in the scripts
+    UINT64 MaximumTsc;   // The maximum TSC cycles of a single run
+    UINT64 Instructions; // Count of the executed instructions
+    UINT64 AbortedRuns;  // Count of the runs that are aborted as they exceeded the instruction budget
+
+} DEBUGGER_EVENT_SCRIPT_STATISTICS, *PDEBUGGER_EVENT_SCRIPT_STATISTICS;
+
 #define SIZEOF_DEBUGGER_MODIFY_EVENTS sizeof(DEBUGGER_MODIFY_EVENTS)
 
 /**
@@ -177,6 +234,9 @@ typedef enum _DEBUGGER_MODIFY_EVENTS_TYPE
     DEBUGGER_MODIFY_EVENTS_ENABLE,
     DEBUGGER_MODIFY_EVENTS_DISABLE,
     DEBUGGER_MODIFY_EVENTS_CLEAR,
+    DEBUGGER_MODIFY_EVENTS_SET_OUTPUT,           // IsEnabled shows whether the messages of the event are generated
+    DEBUGGER_MODIFY_EVENTS_ADD_MONITOR_RANGE,    // Add [RangeStart, RangeEnd) to the ranges of a monitor event
+    DEBUGGER_MODIFY_EVENTS_REMOVE_MONITOR_RANGE, // Remove [RangeStart, RangeEnd) from the ranges of a monitor event
 } DEBUGGER_MODIFY_EVENTS_TYPE;
 
 /**
@@ -191,6 +251,11 @@ typedef struct _DEBUGGER_MODIFY_EVENTS
     TypeOfAction;        // Determines what's the action (enable | disable | clear)
     BOOLEAN IsEnabled;   // Determines what's the action (enable | disable | clear)
 
+    DEBUGGER_EVENT_SCRIPT_STATISTICS ScriptStatistics; // The cost of the scripts (filled by the query state)
+
+    UINT64 RangeStart; // Start of the range of adding or removing monitor ranges (virtual address)
+    UINT64 RangeEnd;   // End of the range of adding or removing monitor ranges (virtual address)
+
 } DEBUGGER_MODIFY_EVENTS, *PDEBUGGER_MODIFY_EVENTS;
 
 /**
@@ -276,6 +341,20 @@ typedef enum _PROTECTED_HV_RESOURCES_TYPE
 
 } PROTECTED_HV_RESOURCES_TYPE;
 
+/**
+ * @brief Type of the resources that are owned (reference counted)
+ * by the events
+ *
+ */
+typedef enum _BITMAP_OWNERSHIP_RESOURCE_TYPE
+{
+    BITMAP_OWNERSHIP_RESOURCE_IO_PORT,             // Index is the port (or DEBUGGER_EVENT_ALL_IO_PORTS)
+    BITMAP_OWNERSHIP_RESOURCE_EXCEPTION,           // Index is the vector (or DEBUGGER_EVENT_EXCEPTIONS_ALL_FIRST_32_ENTRIES)
+    BITMAP_OWNERSHIP_RESOURCE_MOV_TO_DEBUG_REGS,   // No index
+    BITMAP_OWNERSHIP_RESOURCE_MOV_TO_CONTROL_REGS, // Index is the control register and mask is its guest/host mask
+
+} BITMAP_OWNERSHIP_RESOURCE_TYPE;
+
 //////////////////////////////////////////////////
 //               Event Details                  //
 //////////////////////////////////////////////////
@@ -300,6 +379,10 @@ typedef struct _DEBUGGER_GENERAL_EVENT_DETAIL
                          // only that 0xffffffff means that we have to
                          // apply it to all processes
 
+    UINT32 ThreadId;     // determines the thread id to apply this to
+                         // only that 0xffffffff means that we have to
+                         // apply it to all threads
+
     BOOLEAN IsEnabled;
 
     BOOLEAN EnableShortCircuiting;                   // indicates whether the short-circuiting event
@@ -336,8 +419,56 @@ typedef struct _DEBUGGER_GENERAL_EVENT_DETAIL
 
     UINT32 ConditionBufferSize;
 
+    UINT32 RateLimit; // Maximum triggers of the event per second on each core
+                      // (0 if not limited), the extra triggers are dropped
+
+    UINT32 MonitorSlots; // Count of the ranges of a '!monitor' event that can be
+                         // added by the scripts from vmx-root (0 if not reserved)
+
 } DEBUGGER_GENERAL_EVENT_DETAIL, *PDEBUGGER_GENERAL_EVENT_DETAIL;
 
+/**
+ * @brief A value that is saved in the records of the hits of an event
+ * @details the value is either a register or the 64-bit value at the
+ * address of a register plus an offset
+ *
+ */
+typedef struct _DEBUGGER_EVENT_RECORD_VALUE
+{
+    UINT32  Register; // The register (REGS_ENUM)
+    BOOLEAN IsMemory; // Whether the value is read from the memory at the address of the register
+    INT32   Offset;   // Offset that is added to the register (if it's a memory read)
+
+} DEBUGGER_EVENT_RECORD_VALUE, *PDEBUGGER_EVENT_RECORD_VALUE;
+
+/**
+ * @brief The values that are saved in the records of the hits of an event
+ *
+ */
+typedef struct _DEBUGGER_EVENT_RECORD_CONFIGURATION
+{
+    UINT32                      CountOfValues; // Zero if the hits are not recorded
+    DEBUGGER_EVENT_RECORD_VALUE Values[EventRecordMaximumValues];
+
+} DEBUGGER_EVENT_RECORD_CONFIGURATION, *PDEBUGGER_EVENT_RECORD_CONFIGURATION;
+
+/**
+ * @brief A record of a hit of an event
+ *
+ */
+typedef struct _DEBUGGER_EVENT_HIT_RECORD
+{
+    UINT64 Tag;
+    UINT64 Tsc;
+    UINT64 Rip;
+    UINT32 CoreId;
+    UINT32 ProcessId;
+    UINT32 ThreadId;
+    UINT32 ValidValues; // Each bit shows whether the value is available or not (memory reads might fail)
+    UINT64 Values[EventRecordMaximumValues];
+
+} DEBUGGER_EVENT_HIT_RECORD, *PDEBUGGER_EVENT_HIT_RECORD;
+
 /**
  * @brief Each event can have mulitple actions
  * @details THIS STRUCTURE IS ONLY USED IN USER MODE
@@ -355,8 +486,51 @@ typedef struct _DEBUGGER_GENERAL_ACTION
     UINT32 ScriptBufferSize;
     UINT32 ScriptBufferPointer;
 
+    UINT32 LastBranchRecordsCount;   // Zero if the last branches are not shown
+    UINT32 ScriptInstructionsBudget; // Zero if the instructions of the script are not limited
+
+    DEBUGGER_EVENT_RECORD_CONFIGURATION RecordConfiguration; // The values of the records of the hits (if they're recorded)
+
 } DEBUGGER_GENERAL_ACTION, *PDEBUGGER_GENERAL_ACTION;
 
+/**
+ * @brief The details of an event that is registered by the SDK without
+ * interpreting a command (HyperDbgRegisterEvent)
+ * @details the action is running the script if it's available, otherwise
+ * running the custom code if it's available, otherwise breaking to the
+ * debugger
+ */
+typedef struct _HYPERDBG_EVENT_REGISTRATION
+{
+    VMM_EVENT_TYPE_ENUM                   EventType;
+    VMM_CALLBACK_EVENT_CALLING_STAGE_TYPE EventMode;             // Pre- or post- event
+    UINT32                                CoreId;                // DEBUGGER_EVENT_APPLY_TO_ALL_CORES for all cores
+    UINT32                                ProcessId;             // DEBUGGER_EVENT_APPLY_TO_ALL_PROCESSES for all processes
+    UINT32                                ThreadId;              // DEBUGGER_EVENT_APPLY_TO_ALL_THREADS for all threads
+    BOOLEAN                               EnableShortCircuiting; // Whether the short-circuiting is enabled or not
+
+    UINT64 OptionalParam1; // Same as the parameters of the command of the event
+    UINT64 OptionalParam2;
+    UINT64 OptionalParam3;
+    UINT64 OptionalParam4;
+
+    const char * Script;         // The script of the event (NULL if there is no script)
+    PVOID        CustomCode;     // The custom code of the event (NULL if there is no custom code)
+    UINT32       CustomCodeSize; // Size of the custom code
+
+} HYPERDBG_EVENT_REGISTRATION, *PHYPERDBG_EVENT_REGISTRATION;
+
+/**
+ * @brief A branch of the last branch records (LBR)
+ *
+ */
+typedef struct _DEBUGGER_LAST_BRANCH_RECORD
+{
+    UINT64 FromAddress;
+    UINT64 ToAddress;
+
+} DEBUGGER_LAST_BRANCH_RECORD, *PDEBUGGER_LAST_BRANCH_RECORD;
+
 /**
  * @brief Status of register buffers
  *
@@ -281,3 +281,189 @@
  */
 #define IOCTL_REQUEST_REV_MACHINE_SERVICE \
     CTL_CODE(FILE_DEVICE_UNKNOWN, 0x81f, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, release the read messages of the shared message buffers
+ *
+ */
+#define IOCTL_RELEASE_SHARED_MESSAGES \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x820, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, unmap the shared message buffers from the user-mode
+ *
+ */
+#define IOCTL_UNMAP_SHARED_MESSAGE_BUFFERS \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x821, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, enable or disable the binary trace mode of printf
+ *
+ */
+#define IOCTL_SET_BINARY_TRACE_MODE \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x822, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, query the statistics of the message buffers
+ *
+ */
+#define IOCTL_QUERY_LOG_BUFFERS_STATISTICS \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x823, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, apply multiple EPT hooks at once
+ *
+ */
+#define IOCTL_PERFORM_EPT_HOOKS_BATCH \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x824, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, query the hit counts of hidden hooks detour
+ *
+ */
+#define IOCTL_QUERY_EPT_HOOK2_DETOURS \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x825, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, query the virtual addresses of all processes that map
+ * a physical address
+ *
+ */
+#define IOCTL_QUERY_REVERSE_MAPPING \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x826, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, enable, disable, reset or query the statistics of vm-exits
+ *
+ */
+#define IOCTL_VMEXIT_STATISTICS \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x827, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, start, stop or query the samples of the sampling profiler
+ *
+ */
+#define IOCTL_SAMPLING_PROFILER \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x828, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, enable, disable or query (and clear) the dirty pages
+ *
+ */
+#define IOCTL_DIRTY_PAGES \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x829, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, query the ranges of the physical memory that are backed by RAM
+ *
+ */
+#define IOCTL_QUERY_PHYSICAL_RAM_RANGES \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x82a, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, enable, disable, pause, resume or query the trace of Intel PT
+ *
+ */
+#define IOCTL_INTEL_PT \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x82b, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, query the records of the coverage of the reversing machine
+ *
+ */
+#define IOCTL_QUERY_REV_MACHINE_COVERAGE \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x82c, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, map (or unmap) the results ring of a target of the
+ * reversing machine into the current process
+ *
+ */
+#define IOCTL_MAP_REV_MACHINE_RESULTS \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x82d, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, start, stop or query the memory access sampling of PEBS
+ *
+ */
+#define IOCTL_PEBS_SAMPLING \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x82e, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, to send a batch of user debugger commands
+ *
+ */
+#define IOCTL_SEND_USER_DEBUGGER_BATCH_COMMANDS \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x82f, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, to perform the kernel-side benchmark
+ *
+ */
+#define IOCTL_PERFORM_KERNEL_SIDE_BENCHMARK \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x830, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, query the statistics of the pool manager and the
+ * nonpaged memory usage
+ *
+ */
+#define IOCTL_QUERY_POOL_MANAGER_STATISTICS \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x831, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, query the contention of the named spinlocks
+ *
+ */
+#define IOCTL_QUERY_SPINLOCK_CONTENTION \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x832, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, to perform a scenario of the kernel-side stress test
+ *
+ */
+#define IOCTL_PERFORM_KERNEL_SIDE_STRESS_TEST \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x833, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, query the duration of the phases of initializing the
+ * hypervisor
+ *
+ */
+#define IOCTL_QUERY_VMM_INITIALIZATION_TIMINGS \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x834, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, request to apply a list of patches on the memory
+ *
+ */
+#define IOCTL_DEBUGGER_PATCH_MEMORY \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x835, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, request to register a batch of events and actions
+ *
+ */
+#define IOCTL_DEBUGGER_REGISTER_EVENTS_BATCH \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x836, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, query the version of the running driver
+ *
+ */
+#define IOCTL_QUERY_DRIVER_VERSION \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x837, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, query the hit statistics of all of the events
+ *
+ */
+#define IOCTL_QUERY_EVENTS_STATISTICS \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x838, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, query the records of the hits of the events
+ *
+ */
+#define IOCTL_QUERY_EVENT_RECORDS \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, 0x839, METHOD_BUFFERED, FILE_ANY_ACCESS)
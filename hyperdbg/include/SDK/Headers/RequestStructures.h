@@ -83,6 +83,7 @@ typedef enum _REVERSING_MACHINE_RECONSTRUCT_MEMORY_TYPE
     REVERSING_MACHINE_RECONSTRUCT_MEMORY_TYPE_UNKNOWN = 0,
     REVERSING_MACHINE_RECONSTRUCT_MEMORY_TYPE_RECONSTRUCT,
     REVERSING_MACHINE_RECONSTRUCT_MEMORY_TYPE_PATTERN,
+    REVERSING_MACHINE_RECONSTRUCT_MEMORY_TYPE_COVERAGE,
 } REVERSING_MACHINE_RECONSTRUCT_MEMORY_TYPE;
 
 /**
@@ -94,6 +95,8 @@ typedef enum _REVERSING_MACHINE_RECONSTRUCT_MEMORY_FORM
     REVERSING_MACHINE_RECONSTRUCT_MEMORY_FORM_UNKNOWN = 0,
     REVERSING_MACHINE_RECONSTRUCT_MEMORY_FORM_OVERALL,
     REVERSING_MACHINE_RECONSTRUCT_MEMORY_FORM_ADDRESS_BASED,
+    REVERSING_MACHINE_RECONSTRUCT_MEMORY_FORM_PAGE_COVERAGE,
+    REVERSING_MACHINE_RECONSTRUCT_MEMORY_FORM_BASIC_BLOCK_COVERAGE,
 } REVERSING_MACHINE_RECONSTRUCT_MEMORY_FORM;
 
 #define SIZEOF_REVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST \
@@ -115,6 +118,65 @@ typedef struct _REVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST
 
 } REVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST, *PREVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST;
 
+/* ==============================================================================================
+ */
+
+/**
+ * @brief A page or a basic block that is executed in the coverage of
+ * the reversing machine
+ *
+ */
+typedef struct _REVERSING_MACHINE_COVERAGE_RECORD
+{
+    UINT64 Address; // Virtual address of the executed page or basic block
+    UINT32 Size;    // Size of the executed page or basic block
+
+} REVERSING_MACHINE_COVERAGE_RECORD, *PREVERSING_MACHINE_COVERAGE_RECORD;
+
+#define SIZEOF_REVERSING_MACHINE_QUERY_COVERAGE \
+    sizeof(REVERSING_MACHINE_QUERY_COVERAGE)
+
+/**
+ * @brief request for querying the records of the coverage of the
+ * reversing machine
+ * @details the records are queried in chunks, starting from StartIndex
+ *
+ */
+typedef struct _REVERSING_MACHINE_QUERY_COVERAGE
+{
+    UINT32                            StartIndex;           // Index of the first record that is queried
+    UINT32                            ProcessId;            // The process that its coverage is recorded
+    BOOLEAN                           IsBasicBlockCoverage; // Whether the records are basic blocks or pages
+    UINT32                            TotalCountOfRecords;  // Count of all of the records
+    UINT32                            CountOfLostRecords;   // Count of the records that are not saved as the buffer is full
+    UINT32                            CountOfRecords;       // Count of the records of this chunk
+    UINT32                            KernelStatus;
+    REVERSING_MACHINE_COVERAGE_RECORD Records[MaximumReversingMachineCoverageRecordsToQuery];
+
+} REVERSING_MACHINE_QUERY_COVERAGE, *PREVERSING_MACHINE_QUERY_COVERAGE;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_REVERSING_MACHINE_MAP_RESULTS \
+    sizeof(REVERSING_MACHINE_MAP_RESULTS)
+
+/**
+ * @brief request for mapping (or unmapping) the results ring of a target
+ * of the reversing machine into the current process
+ * @details the ring is unmapped once the handle of the process to the
+ * device is closed
+ *
+ */
+typedef struct _REVERSING_MACHINE_MAP_RESULTS
+{
+    UINT32  ProcessId;   // The target process
+    BOOLEAN Unmap;       // Whether the ring is unmapped or mapped
+    UINT64  RingAddress; // User-mode address of the REVERSING_MACHINE_RESULTS_RING
+    UINT32  KernelStatus;
+
+} REVERSING_MACHINE_MAP_RESULTS, *PREVERSING_MACHINE_MAP_RESULTS;
+
 /* ==============================================================================================
  */
 
@@ -148,6 +210,7 @@ typedef enum _DEBUGGER_PREALLOC_COMMAND_TYPE
 {
     DEBUGGER_PREALLOC_COMMAND_TYPE_MONITOR,
     DEBUGGER_PREALLOC_COMMAND_TYPE_THREAD_INTERCEPTION,
+    DEBUGGER_PREALLOC_COMMAND_TYPE_EPT_SNAPSHOT,
 } DEBUGGER_PREALLOC_COMMAND_TYPE;
 
 #define SIZEOF_DEBUGGER_PREALLOC_COMMAND \
@@ -218,9 +281,11 @@ typedef struct _DEBUGGER_READ_MEMORY
     DEBUGGER_READ_MEMORY_TYPE    MemoryType;
     DEBUGGER_READ_READING_TYPE   ReadingType;
     PDEBUGGER_DT_COMMAND_OPTIONS DtDetails;
-    DEBUGGER_SHOW_MEMORY_STYLE   Style;        // not used in local debugging
-    UINT32                       ReturnLength; // not used in local debugging
-    UINT32                       KernelStatus; // not used in local debugging
+    DEBUGGER_SHOW_MEMORY_STYLE   Style;          // not used in local debugging
+    UINT32                       ReturnLength;   // not used in local debugging
+    UINT32                       KernelStatus;   // not used in local debugging
+    UINT32                       SequenceNumber; // sequence number of the chunk (not used in local debugging)
+    BOOLEAN                      IsLastChunk;    // whether it's the last chunk of the request (not used in local debugging)
 
 } DEBUGGER_READ_MEMORY, *PDEBUGGER_READ_MEMORY;
 
@@ -288,6 +353,97 @@ typedef struct _DEBUGGER_PERFORM_KERNEL_TESTS
 
 } DEBUGGER_PERFORM_KERNEL_TESTS, *PDEBUGGER_PERFORM_KERNEL_TESTS;
 
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_PERFORM_KERNEL_BENCHMARK \
+    sizeof(DEBUGGER_PERFORM_KERNEL_BENCHMARK)
+
+/**
+ * @brief The operations that are measured by the kernel-side benchmark
+ *
+ */
+typedef enum _DEBUGGER_KERNEL_BENCHMARK_OPERATION
+{
+    DEBUGGER_KERNEL_BENCHMARK_CPUID,
+    DEBUGGER_KERNEL_BENCHMARK_RDTSC,
+    DEBUGGER_KERNEL_BENCHMARK_RDTSCP,
+    DEBUGGER_KERNEL_BENCHMARK_RDMSR_TRAPPED,
+    DEBUGGER_KERNEL_BENCHMARK_RDMSR_UNTRAPPED,
+    DEBUGGER_KERNEL_BENCHMARK_VMCALL,
+    DEBUGGER_KERNEL_BENCHMARK_IO_PORT,
+    DEBUGGER_KERNEL_BENCHMARK_EPT_HOOKED_PAGE,
+    DEBUGGER_KERNEL_BENCHMARK_OPERATIONS_COUNT
+
+} DEBUGGER_KERNEL_BENCHMARK_OPERATION;
+
+/**
+ * @brief The results of the kernel-side benchmark on a core
+ *
+ */
+typedef struct _DEBUGGER_KERNEL_BENCHMARK_CORE_RESULT
+{
+    UINT64 Cycles[DEBUGGER_KERNEL_BENCHMARK_OPERATIONS_COUNT]; // Average round-trip cycles of each operation
+
+} DEBUGGER_KERNEL_BENCHMARK_CORE_RESULT, *PDEBUGGER_KERNEL_BENCHMARK_CORE_RESULT;
+
+/**
+ * @brief request performing the kernel-side benchmark
+ * @details the request is followed by the results of the cores
+ * (CoresCount entries of DEBUGGER_KERNEL_BENCHMARK_CORE_RESULT)
+ *
+ */
+typedef struct _DEBUGGER_PERFORM_KERNEL_BENCHMARK
+{
+    UINT32 Iterations;   // Iterations of each operation
+    UINT32 TrappedMsr;   // The MSR that is trapped by the events
+    UINT32 UntrappedMsr; // The MSR that is not trapped
+    UINT16 IoPort;       // The I/O port that is read
+    UINT32 CoresCount;   // Count of the results (filled by the kernel)
+    UINT32 KernelStatus;
+
+} DEBUGGER_PERFORM_KERNEL_BENCHMARK, *PDEBUGGER_PERFORM_KERNEL_BENCHMARK;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_PERFORM_KERNEL_STRESS \
+    sizeof(DEBUGGER_PERFORM_KERNEL_STRESS)
+
+/**
+ * @brief The operations that the threads of the kernel-side stress test
+ * perform continuously
+ *
+ */
+typedef enum _DEBUGGER_KERNEL_STRESS_SCENARIO
+{
+    DEBUGGER_KERNEL_STRESS_CALL_TARGET_FUNCTION, // Call the target function (which is hooked by the debugger)
+    DEBUGGER_KERNEL_STRESS_LOG_FLOOD,            // Send messages to the user-mode
+
+} DEBUGGER_KERNEL_STRESS_SCENARIO;
+
+/**
+ * @brief request performing a scenario of the kernel-side stress test
+ * @details the threads of each core perform the operation of the scenario
+ * till the end of the duration
+ *
+ */
+typedef struct _DEBUGGER_PERFORM_KERNEL_STRESS
+{
+    DEBUGGER_KERNEL_STRESS_SCENARIO Scenario;
+    UINT32                          ThreadsPerCore;
+    UINT32                          Duration;         // Duration of the scenario (in milliseconds)
+    UINT32                          CountOfThreads;   // Count of the threads that are created (filled by the kernel)
+    UINT32                          HungThreads;      // Threads that are not finished after the duration (filled by the kernel)
+    UINT64                          Operations;       // Count of the performed operations (filled by the kernel)
+    UINT64                          FailedOperations; // Count of the messages that are not sent as the buffers are full (filled by the kernel)
+    UINT64                          TotalCycles;      // Cycles of all the operations (filled by the kernel)
+    UINT64                          MaximumCycles;    // Worst-case cycles of an operation (filled by the kernel)
+    UINT64                          ElapsedTime;      // Elapsed time of the scenario in 100 nanoseconds (filled by the kernel)
+    UINT32                          KernelStatus;
+
+} DEBUGGER_PERFORM_KERNEL_STRESS, *PDEBUGGER_PERFORM_KERNEL_STRESS;
+
 /* ==============================================================================================
  */
 
@@ -444,6 +600,180 @@ typedef struct _DEBUGGER_EDIT_MEMORY
 
 } DEBUGGER_EDIT_MEMORY, *PDEBUGGER_EDIT_MEMORY;
 
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_PATCH_MEMORY_REQUEST sizeof(DEBUGGER_PATCH_MEMORY_REQUEST)
+
+/**
+ * @brief The length of a patch in the stream of patches (the entry and
+ * its bytes, aligned to 8 bytes)
+ *
+ */
+#define DEBUGGER_PATCH_MEMORY_ENTRY_LENGTH(Size) \
+    (sizeof(DEBUGGER_PATCH_MEMORY_ENTRY) + (((Size) + 7) & ~7))
+
+/**
+ * @brief request for applying a list of patches on the memory
+ * @details the request is followed by PatchesBufferSize bytes of the stream
+ * of patches, each patch is a DEBUGGER_PATCH_MEMORY_ENTRY followed by its
+ * bytes, the patches are sorted by their addresses and the adjacent patches
+ * are merged so the patches of the same pages are written at once
+ *
+ */
+typedef struct _DEBUGGER_PATCH_MEMORY_REQUEST
+{
+    UINT32                    ProcessId;             // specifies the process id (not used in debugger mode)
+    DEBUGGER_EDIT_MEMORY_TYPE MemoryType;            // Type of memory
+    UINT32                    CountOfPatches;        // Count of patches in the stream
+    UINT32                    PatchesBufferSize;     // Size of the stream of patches
+    UINT32                    CountOfAppliedPatches; // Result from kernel
+    UINT32                    KernelStatus;          // Result from kernel
+
+} DEBUGGER_PATCH_MEMORY_REQUEST, *PDEBUGGER_PATCH_MEMORY_REQUEST;
+
+/**
+ * @brief a patch in the stream of patches
+ *
+ */
+typedef struct _DEBUGGER_PATCH_MEMORY_ENTRY
+{
+    UINT64 Address; // Target address to modify
+    UINT32 Size;    // Count of bytes after this entry
+    UINT32 Reserved;
+
+} DEBUGGER_PATCH_MEMORY_ENTRY, *PDEBUGGER_PATCH_MEMORY_ENTRY;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_EPT_SNAPSHOT_REQUEST sizeof(DEBUGGER_EPT_SNAPSHOT_REQUEST)
+
+/**
+ * @brief different actions of the snapshot (copy-on-write of the guest
+ * pages based on EPT)
+ *
+ */
+typedef enum _DEBUGGER_EPT_SNAPSHOT_ACTION
+{
+    DEBUGGER_EPT_SNAPSHOT_ACTION_TAKE,
+    DEBUGGER_EPT_SNAPSHOT_ACTION_RESTORE,
+    DEBUGGER_EPT_SNAPSHOT_ACTION_DISCARD,
+    DEBUGGER_EPT_SNAPSHOT_ACTION_QUERY,
+
+} DEBUGGER_EPT_SNAPSHOT_ACTION;
+
+/**
+ * @brief request for taking, restoring or discarding the snapshot of the
+ * halted debuggee
+ *
+ */
+typedef struct _DEBUGGER_EPT_SNAPSHOT_REQUEST
+{
+    DEBUGGER_EPT_SNAPSHOT_ACTION Action;
+    BOOLEAN                      IsTaken;              // Result from kernel
+    UINT32                       CoreId;               // The core that the snapshot is taken on (result from kernel)
+    UINT64                       CountOfCopiedPages;   // Pages that are written since taking or restoring the snapshot (result from kernel)
+    UINT64                       CountOfRestoredPages; // Pages that are copied back by this request (result from kernel)
+    UINT64                       CountOfRestores;      // Count of restores since taking the snapshot (result from kernel)
+    UINT32                       KernelStatus;         // Result from kernel
+
+} DEBUGGER_EPT_SNAPSHOT_REQUEST, *PDEBUGGER_EPT_SNAPSHOT_REQUEST;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_HALT_WATCHDOG_REQUEST sizeof(DEBUGGER_HALT_WATCHDOG_REQUEST)
+
+/**
+ * @brief request for setting or querying the watchdog that continues
+ * the halted debuggee if there is no command from the debugger
+ * @details it's also sent by the debuggee once it's continued by the
+ * watchdog
+ *
+ */
+typedef struct _DEBUGGER_HALT_WATCHDOG_REQUEST
+{
+    BOOLEAN IsQuery;
+    UINT32  Timeout;         // Milliseconds without any command before continuing (zero disables the watchdog)
+    UINT64  CountOfTimeouts; // Count of the halts that are continued by the watchdog (result from kernel)
+    UINT64  LastTimeoutTsc;  // Time-stamp of the last timeout (result from kernel)
+    UINT32  KernelStatus;    // Result from kernel
+
+} DEBUGGER_HALT_WATCHDOG_REQUEST, *PDEBUGGER_HALT_WATCHDOG_REQUEST;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_EVENTS_BATCH_REQUEST sizeof(DEBUGGER_EVENTS_BATCH_REQUEST)
+
+/**
+ * @brief The length of an entry in the stream of events and actions (the
+ * entry and its buffer, aligned to 8 bytes)
+ *
+ */
+#define DEBUGGER_EVENTS_BATCH_ENTRY_LENGTH(Size) \
+    (sizeof(DEBUGGER_EVENTS_BATCH_ENTRY) + (((Size) + 7) & ~7))
+
+/**
+ * @brief Types of the entries of the batch of events
+ *
+ */
+typedef enum _DEBUGGER_EVENTS_BATCH_ENTRY_TYPE
+{
+    DEBUGGER_EVENTS_BATCH_ENTRY_EVENT,  // DEBUGGER_GENERAL_EVENT_DETAIL and its conditions
+    DEBUGGER_EVENTS_BATCH_ENTRY_ACTION, // DEBUGGER_GENERAL_ACTION and its buffer
+
+} DEBUGGER_EVENTS_BATCH_ENTRY_TYPE;
+
+/**
+ * @brief request for registering a batch of events and actions
+ * @details the request is followed by EntriesBufferSize bytes of the stream
+ * of entries, each entry is a DEBUGGER_EVENTS_BATCH_ENTRY followed by the
+ * buffer of the event or the action, the events are applied in the order of
+ * the stream and they're enabled once all of the entries are applied, if
+ * one of the entries is not applied, then the events of the batch are removed
+ *
+ */
+typedef struct _DEBUGGER_EVENTS_BATCH_REQUEST
+{
+    UINT32 CountOfEntries;        // Count of entries in the stream
+    UINT32 EntriesBufferSize;     // Size of the stream of entries
+    UINT32 CountOfAppliedEntries; // Result from kernel
+    UINT32 KernelStatus;          // Result from kernel
+
+} DEBUGGER_EVENTS_BATCH_REQUEST, *PDEBUGGER_EVENTS_BATCH_REQUEST;
+
+/**
+ * @brief an entry in the stream of events and actions
+ *
+ */
+typedef struct _DEBUGGER_EVENTS_BATCH_ENTRY
+{
+    UINT32 Type; // DEBUGGER_EVENTS_BATCH_ENTRY_TYPE
+    UINT32 Size; // Count of bytes after this entry
+
+} DEBUGGER_EVENTS_BATCH_ENTRY, *PDEBUGGER_EVENTS_BATCH_ENTRY;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_EPT_HOOKS_BATCH_REQUEST sizeof(DEBUGGER_EPT_HOOKS_BATCH_REQUEST)
+
+/**
+ * @brief request for applying multiple EPT hooks at once
+ * @details CountOfEntries of EPT_HOOKS_BATCH_ENTRY follow this structure,
+ * the KernelStatus of each entry is filled by the kernel
+ *
+ */
+typedef struct _DEBUGGER_EPT_HOOKS_BATCH_REQUEST
+{
+    UINT32 CountOfEntries;
+    UINT32 CountOfAppliedHooks;
+    UINT32 KernelStatus;
+
+} DEBUGGER_EPT_HOOKS_BATCH_REQUEST, *PDEBUGGER_EPT_HOOKS_BATCH_REQUEST;
+
 /* ==============================================================================================
  */
 
@@ -475,6 +805,9 @@ typedef enum _DEBUGGER_SEARCH_MEMORY_BYTE_SIZE
 
 /**
  * @brief request for searching memory
+ * @details the structure is followed by CountOf64Chunks values, CountOf64Chunks
+ * masks (the bytes of wildcards are zero), and CountOfPatterns counts of elements
+ * of each pattern, all of them are 64-bit
  *
  */
 typedef struct _DEBUGGER_SEARCH_MEMORY
@@ -485,6 +818,7 @@ typedef struct _DEBUGGER_SEARCH_MEMORY
     DEBUGGER_SEARCH_MEMORY_TYPE      MemoryType; // Type of memory
     DEBUGGER_SEARCH_MEMORY_BYTE_SIZE ByteSize;   // Modification size
     UINT32                           CountOf64Chunks;
+    UINT32                           CountOfPatterns;
     UINT32                           FinalStructureSize;
 
 } DEBUGGER_SEARCH_MEMORY, *PDEBUGGER_SEARCH_MEMORY;
@@ -502,6 +836,7 @@ typedef struct _DEBUGGER_SEARCH_MEMORY
 typedef struct _DEBUGGER_HIDE_AND_TRANSPARENT_DEBUGGER_MODE
 {
     BOOLEAN IsHide;
+    BOOLEAN UseTscOffsetting; // compensate the time of vmx-root by the TSC offset (instead of rdtsc exiting)
 
     UINT64 CpuidAverage;
     UINT64 CpuidStandardDeviation;
@@ -540,6 +875,21 @@ typedef struct _DEBUGGER_PREPARE_DEBUGGEE
     UINT32 Result; // Result from the kernel
     CHAR   OsName[MAXIMUM_CHARACTER_FOR_OS_NAME];
 
+    //
+    // Network connection (instead of serial)
+    //
+    BOOLEAN IsNetwork;
+    UINT32  NetworkAdapterPciAddress; // Bus (bits 8-15), device (bits 3-7), and function (bits 0-2)
+    UINT32  DebuggeeIpAddress;        // Network byte order
+    UINT32  DebuggerIpAddress;        // Network byte order
+    UINT16  UdpPort;
+
+    //
+    // Bulk link (a second serial port), the bulk data is sent over the
+    // control link if it's zero
+    //
+    UINT32 BulkPortAddress;
+
 } DEBUGGER_PREPARE_DEBUGGEE, *PDEBUGGER_PREPARE_DEBUGGEE;
 
 /* ==============================================================================================
@@ -698,6 +1048,7 @@ typedef struct _DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS
     DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_TYPES   QueryType;
     DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS_ACTIONS QueryAction;
     UINT32                                             Count;
+    UINT32                                             StartIndex; // Index of the first entry of the list query (pagination)
     UINT64                                             Result;
 
 } DEBUGGER_QUERY_ACTIVE_PROCESSES_OR_THREADS,
@@ -715,6 +1066,7 @@ typedef struct _DEBUGGER_SINGLE_CALLSTACK_FRAME
     BOOLEAN IsStackAddressValid;
     BOOLEAN IsValidAddress;
     BOOLEAN IsExecutable;
+    BOOLEAN IsUnwoundReturnAddress; // The value is a return address that is found by unwinding the stack
     UINT64  Value;
     BYTE    InstructionBytesOnRip[MAXIMUM_CALL_INSTR_SIZE];
 
@@ -741,6 +1093,7 @@ typedef enum _DEBUGGER_CALLSTACK_DISPLAY_METHOD
 typedef struct _DEBUGGER_CALLSTACK_REQUEST
 {
     BOOLEAN                           Is32Bit;
+    BOOLEAN                           IsUnwound; // Whether the return addresses are found by unwinding the stack
     UINT32                            KernelStatus;
     DEBUGGER_CALLSTACK_DISPLAY_METHOD DisplayMethod;
     UINT32                            Size;
@@ -780,6 +1133,7 @@ typedef struct _DEBUGGER_EVENT_ACTION_RUN_SCRIPT_CONFIGURATION
     UINT32 ScriptLength;
     UINT32 ScriptPointer;
     UINT32 OptionalRequestedBufferSize;
+    UINT32 InstructionsBudget; // Zero if the instructions are not limited
 
 } DEBUGGER_EVENT_ACTION_RUN_SCRIPT_CONFIGURATION,
     *PDEBUGGER_EVENT_ACTION_RUN_SCRIPT_CONFIGURATION;
@@ -821,6 +1175,7 @@ typedef enum _DEBUGGER_UD_COMMAND_ACTION_TYPE
     DEBUGGER_UD_COMMAND_ACTION_TYPE_PAUSE,
     DEBUGGER_UD_COMMAND_ACTION_TYPE_CONTINUE,
     DEBUGGER_UD_COMMAND_ACTION_TYPE_REGULAR_STEP,
+    DEBUGGER_UD_COMMAND_ACTION_TYPE_SET_REGISTER, // OptionalParam1 = register (REGS_ENUM), OptionalParam2 = value
 
 } DEBUGGER_UD_COMMAND_ACTION_TYPE;
 
@@ -852,6 +1207,43 @@ typedef struct _DEBUGGER_UD_COMMAND_PACKET
 
 } DEBUGGER_UD_COMMAND_PACKET, *PDEBUGGER_UD_COMMAND_PACKET;
 
+/**
+ * @brief Maximum entries of a batch of user debugger commands
+ *
+ */
+#define DEBUGGER_UD_BATCH_COMMAND_MAXIMUM_ENTRIES 0x400
+
+/**
+ * @brief Each entry of the batch of user debugger commands
+ *
+ */
+typedef struct _DEBUGGER_UD_BATCH_COMMAND_ENTRY
+{
+    DEBUGGER_UD_COMMAND_ACTION UdAction;
+    UINT32                     TargetThreadId;
+    UINT32                     Result;
+
+} DEBUGGER_UD_BATCH_COMMAND_ENTRY, *PDEBUGGER_UD_BATCH_COMMAND_ENTRY;
+
+/**
+ * @brief The structure of the batch of user debugger commands
+ * @details the entries are applied in order (the actions of each thread
+ * are performed at its next cpuid), this structure is followed by
+ * CountOfEntries of DEBUGGER_UD_BATCH_COMMAND_ENTRY
+ *
+ */
+typedef struct _DEBUGGER_UD_BATCH_COMMAND_PACKET
+{
+    UINT64 ProcessDebuggingDetailToken;
+    UINT32 CountOfEntries;
+    UINT32 CountOfAppliedEntries;
+    UINT32 Result;
+
+} DEBUGGER_UD_BATCH_COMMAND_PACKET, *PDEBUGGER_UD_BATCH_COMMAND_PACKET;
+
+#define SIZEOF_DEBUGGER_UD_BATCH_COMMAND_PACKET \
+    sizeof(DEBUGGER_UD_BATCH_COMMAND_PACKET)
+
 /* ==============================================================================================
  */
 
@@ -865,6 +1257,7 @@ typedef enum _DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_TYPE
     DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_GET_PROCESS_DETAILS,
     DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_GET_PROCESS_LIST,
     DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PERFORM_SWITCH,
+    DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_QUERY_PROCESS_LIST_ENTRIES,
 
 } DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_TYPE;
 
@@ -881,6 +1274,8 @@ typedef struct _DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET
     BOOLEAN                                  IsSwitchByClkIntr;
     UCHAR                                    ProcessName[16];
     DEBUGGEE_PROCESS_LIST_NEEDED_DETAILS     ProcessListSymDetails;
+    UINT32                                   StartIndex;     // Only for querying the entries of the list
+    UINT32                                   CountOfEntries; // Count of the entries after the packet
     UINT32                                   Result;
 
 } DEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET, *PDEBUGGEE_DETAILS_AND_SWITCH_PROCESS_PACKET;
@@ -905,6 +1300,7 @@ typedef enum _DEBUGGEE_DETAILS_AND_SWITCH_THREAD_TYPE
     DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PERFORM_SWITCH,
     DEBUGGEE_DETAILS_AND_SWITCH_THREAD_GET_THREAD_DETAILS,
     DEBUGGEE_DETAILS_AND_SWITCH_THREAD_GET_THREAD_LIST,
+    DEBUGGEE_DETAILS_AND_SWITCH_THREAD_QUERY_THREAD_LIST_ENTRIES,
 
 } DEBUGGEE_DETAILS_AND_SWITCH_THREAD_TYPE;
 
@@ -922,6 +1318,8 @@ typedef struct _DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET
     BOOLEAN                                 CheckByClockInterrupt;
     UCHAR                                   ProcessName[16];
     DEBUGGEE_THREAD_LIST_NEEDED_DETAILS     ThreadListSymDetails;
+    UINT32                                  StartIndex;     // Only for querying the entries of the list
+    UINT32                                  CountOfEntries; // Count of the entries after the packet
     UINT32                                  Result;
 
 } DEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET, *PDEBUGGEE_DETAILS_AND_SWITCH_THREAD_PACKET;
@@ -1013,8 +1411,14 @@ typedef struct _DEBUGGEE_BP_PACKET
     UINT32 Pid;
     UINT32 Tid;
     UINT32 Core;
+    UINT32 ConditionBufferSize; // Zero if the breakpoint is not conditional
+    UINT32 ConditionBufferPointer;
     UINT32 Result;
 
+    //
+    // The condition buffer (script engine's symbols) is here
+    //
+
 } DEBUGGEE_BP_PACKET, *PDEBUGGEE_BP_PACKET;
 
 /**
@@ -1099,15 +1503,692 @@ typedef struct _DEBUGGEE_RESULT_OF_SEARCH_PACKET
 
 /**
  * @brief Register Descriptor Structure to use in r command.
+ * @details for showing all registers, the registers are sent after the
+ * structure, if the debugger has the last registers of the core (the
+ * context with BaseContextId), only the changed words of the registers
+ * (DEBUGGEE_REGISTERS_CONTEXT) are sent
  *
  */
 typedef struct _DEBUGGEE_REGISTER_READ_DESCRIPTION
 {
-    UINT32 RegisterID; // the number is from REGS_ENUM
-    UINT64 Value;
-    UINT32 KernelStatus;
+    UINT32  RegisterID; // the number is from REGS_ENUM
+    UINT64  Value;
+    UINT32  KernelStatus;
+    UINT32  BaseContextId;    // Id of the registers that the debugger has (zero if none)
+    UINT32  ContextId;        // Id of the registers that are sent
+    BOOLEAN IsDelta;          // Only the changed words are sent
+    UINT32  ChangedRegisters; // Bitmap of the changed words (if it's a delta)
 
 } DEBUGGEE_REGISTER_READ_DESCRIPTION, *PDEBUGGEE_REGISTER_READ_DESCRIPTION;
 
+/**
+ * @brief All of the registers that are sent for showing all registers
+ *
+ */
+typedef struct _DEBUGGEE_REGISTERS_CONTEXT
+{
+    GUEST_REGS            Regs;
+    GUEST_EXTRA_REGISTERS ExtraRegs;
+
+} DEBUGGEE_REGISTERS_CONTEXT, *PDEBUGGEE_REGISTERS_CONTEXT;
+
+/**
+ * @brief Count of words (UINT64) of the registers context
+ *
+ */
+#define DEBUGGEE_REGISTERS_CONTEXT_WORDS (sizeof(DEBUGGEE_REGISTERS_CONTEXT) / sizeof(UINT64))
+
+/* ==============================================================================================
+ */
+
+/**
+ * @brief The header of a batch of requests that are performed
+ * by the debuggee in a single round-trip
+ * @details the header is followed by CountOfRequests entries of
+ * DEBUGGEE_BATCH_REQUEST_ENTRY, each of them is followed by its
+ * payload, the result of the batch has the same layout and its
+ * entries are in the same order as the requests
+ *
+ */
+typedef struct _DEBUGGEE_BATCH_REQUESTS_PACKET
+{
+    UINT32 CountOfRequests;
+    UINT32 KernelStatus;
+
+} DEBUGGEE_BATCH_REQUESTS_PACKET, *PDEBUGGEE_BATCH_REQUESTS_PACKET;
+
+/**
+ * @brief A single request (or result) in a batch of requests
+ *
+ */
+typedef struct _DEBUGGEE_BATCH_REQUEST_ENTRY
+{
+    UINT32                                  RequestId;       // Chosen by the debugger, the result has the same id
+    DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION RequestedAction; // Action of the request (or the result)
+    UINT32                                  Length;          // Length of the payload after this entry
+    UINT32                                  KernelStatus;
+
+} DEBUGGEE_BATCH_REQUEST_ENTRY, *PDEBUGGEE_BATCH_REQUEST_ENTRY;
+
+/* ==============================================================================================
+ */
+
+/**
+ * @brief Not recording any register in the trace of the steps
+ *
+ */
+#define DEBUGGEE_STEP_TRACE_NO_REGISTER 0xffffffff
+
+/**
+ * @brief The request of performing multiple steps in the debuggee
+ * and recording the trace of them
+ * @details the debuggee performs the steps without sending a pause
+ * packet for each of them, the trace is sent back in chunks and the
+ * debuggee is paused again once all of the steps are performed
+ *
+ */
+typedef struct _DEBUGGEE_STEP_TRACE_PACKET
+{
+    DEBUGGER_REMOTE_STEPPING_REQUEST StepType;         // Only step-in and instrumentation step-in
+    UINT32                           CountOfSteps;     // It should not be zero
+    UINT32                           RecordedRegister; // REGS_ENUM or DEBUGGEE_STEP_TRACE_NO_REGISTER
+
+} DEBUGGEE_STEP_TRACE_PACKET, *PDEBUGGEE_STEP_TRACE_PACKET;
+
+/**
+ * @brief The header of a chunk of the trace of the steps
+ * @details the header is followed by CountOfEntries entries, each
+ * entry is the RIP after the step (a UINT64), followed by the value
+ * of the recorded register (if any register is recorded)
+ *
+ */
+typedef struct _DEBUGGEE_STEP_TRACE_RESULT_PACKET
+{
+    UINT32  SequenceNumber;   // Index of the chunk (starting from zero)
+    UINT32  CountOfEntries;   // Count of entries in this chunk
+    UINT32  RecordedRegister; // REGS_ENUM or DEBUGGEE_STEP_TRACE_NO_REGISTER
+    BOOLEAN IsLastChunk;      // The tracing is finished (or stopped by a break)
+    UINT32  KernelStatus;
+
+} DEBUGGEE_STEP_TRACE_RESULT_PACKET, *PDEBUGGEE_STEP_TRACE_RESULT_PACKET;
+
+/* ==============================================================================================
+ */
+
+/**
+ * @brief Count of the last instructions of running a count of instructions
+ * that are stepped one by one (the overflow of the performance counter is
+ * not precise)
+ *
+ */
+#define DEBUGGEE_INSTRUCTION_BUDGET_STEPPED_INSTRUCTIONS 0x100
+
+/**
+ * @brief The request of running a count of instructions on the current
+ * core of the debuggee and pausing it afterwards
+ * @details the instructions are counted by the fixed-function performance
+ * counter of the retired instructions and the last instructions are stepped
+ * one by one, the same packet is sent back as the result once the debuggee
+ * is paused again (or once the request is not performed)
+ *
+ */
+typedef struct _DEBUGGEE_INSTRUCTION_BUDGET_PACKET
+{
+    UINT64  CountOfInstructions;        // Count of the instructions to run, it should not be zero
+    UINT64  CountOfCountedInstructions; // The instructions that are counted by the performance counter (result)
+    UINT64  CountOfSteppedInstructions; // The instructions that are stepped one by one (result)
+    BOOLEAN IsInterrupted;              // Something else paused the debuggee before running all of the instructions (result)
+    UINT32  KernelStatus;
+
+} DEBUGGEE_INSTRUCTION_BUDGET_PACKET, *PDEBUGGEE_INSTRUCTION_BUDGET_PACKET;
+
+/* ==============================================================================================
+ */
+
+/**
+ * @brief The byte of the payload of the transport test at an index
+ * @details the payload is not compressible (so the compression of the
+ * frames doesn't change the results) and it's checked by the receiver
+ *
+ */
+#define DEBUGGEE_TRANSPORT_TEST_PATTERN(Seed, Index) \
+    ((UINT8)((((UINT32)(Seed) + (UINT32)(Index)) * 0x9e3779b1) >> 24))
+
+/**
+ * @brief The request (and the result) of the transport test
+ * @details the header is followed by PayloadLength bytes of the payload,
+ * the debuggee checks the payload and sends back the header followed by
+ * ResponseLength bytes of the payload (both are generated by the pattern
+ * of the transport test and the sequence number)
+ *
+ */
+typedef struct _DEBUGGEE_TRANSPORT_TEST_PACKET
+{
+    UINT32 SequenceNumber;
+    UINT32 PayloadLength;
+    UINT32 ResponseLength;
+    UINT32 KernelStatus;
+
+} DEBUGGEE_TRANSPORT_TEST_PACKET, *PDEBUGGEE_TRANSPORT_TEST_PACKET;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_BINARY_TRACE_MODE_REQUEST \
+    sizeof(DEBUGGER_BINARY_TRACE_MODE_REQUEST)
+
+/**
+ * @brief request for enabling or disabling the binary trace mode of printf
+ *
+ */
+typedef struct _DEBUGGER_BINARY_TRACE_MODE_REQUEST
+{
+    BOOLEAN IsEnabled;
+    UINT32  KernelStatus;
+
+} DEBUGGER_BINARY_TRACE_MODE_REQUEST, *PDEBUGGER_BINARY_TRACE_MODE_REQUEST;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_QUERY_LOG_BUFFERS_STATISTICS \
+    sizeof(DEBUGGER_QUERY_LOG_BUFFERS_STATISTICS)
+
+/**
+ * @brief request for querying the statistics of the message buffers
+ * @details buffers are in the same order as the rings of LOG_SHARED_BUFFERS,
+ * the regular buffer of vmx non-root of core i is at (i * 4), then its
+ * priority buffer, then the regular and priority buffers of vmx-root
+ *
+ */
+typedef struct _DEBUGGER_QUERY_LOG_BUFFERS_STATISTICS
+{
+    UINT32                CountOfBuffers;
+    UINT32                KernelStatus;
+    LOG_BUFFER_STATISTICS Buffers[MaximumLogSharedRings];
+
+} DEBUGGER_QUERY_LOG_BUFFERS_STATISTICS, *PDEBUGGER_QUERY_LOG_BUFFERS_STATISTICS;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_QUERY_EPT_HOOK2_DETOURS \
+    sizeof(DEBUGGER_QUERY_EPT_HOOK2_DETOURS)
+
+/**
+ * @brief request for querying the hit counts of hidden hooks detour
+ *
+ */
+typedef struct _DEBUGGER_QUERY_EPT_HOOK2_DETOURS
+{
+    UINT32                       CountOfHooks;
+    UINT32                       KernelStatus;
+    EPT_HOOK2_DETOUR_HIT_DETAILS Hooks[MaximumEptHook2DetoursToQuery];
+
+} DEBUGGER_QUERY_EPT_HOOK2_DETOURS, *PDEBUGGER_QUERY_EPT_HOOK2_DETOURS;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_QUERY_REVERSE_MAPPING \
+    sizeof(DEBUGGER_QUERY_REVERSE_MAPPING)
+
+/**
+ * @brief request for querying the virtual addresses of all processes that
+ * map a physical address (!pa2va all)
+ *
+ */
+typedef struct _DEBUGGER_QUERY_REVERSE_MAPPING
+{
+    UINT64                  PhysicalAddress;
+    BOOLEAN                 Rebuild;                // Rebuild the index before querying
+    UINT32                  CountOfMappings;
+    UINT32                  CountOfIndexedMappings; // Count of mappings of all of the processes
+    UINT32                  KernelStatus;
+    REVERSE_MAPPING_DETAILS Mappings[MaximumReverseMappingsToQuery];
+
+} DEBUGGER_QUERY_REVERSE_MAPPING, *PDEBUGGER_QUERY_REVERSE_MAPPING;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_VMEXIT_STATISTICS_REQUEST \
+    sizeof(DEBUGGER_VMEXIT_STATISTICS_REQUEST)
+
+/**
+ * @brief Querying the statistics of all of the cores
+ *
+ */
+#define DEBUGGER_VMEXIT_STATISTICS_ALL_CORES 0xffffffff
+
+/**
+ * @brief Actions of the statistics of vm-exits
+ *
+ */
+typedef enum _DEBUGGER_VMEXIT_STATISTICS_ACTION
+{
+    DEBUGGER_VMEXIT_STATISTICS_ACTION_QUERY,
+    DEBUGGER_VMEXIT_STATISTICS_ACTION_ENABLE,
+    DEBUGGER_VMEXIT_STATISTICS_ACTION_DISABLE,
+    DEBUGGER_VMEXIT_STATISTICS_ACTION_RESET,
+
+} DEBUGGER_VMEXIT_STATISTICS_ACTION;
+
+/**
+ * @brief request for enabling, disabling, resetting or querying
+ * the statistics of vm-exits
+ *
+ */
+typedef struct _DEBUGGER_VMEXIT_STATISTICS_REQUEST
+{
+    DEBUGGER_VMEXIT_STATISTICS_ACTION Action;
+    UINT32                            CoreId;    // Core to query or DEBUGGER_VMEXIT_STATISTICS_ALL_CORES
+    BOOLEAN                           IsEnabled; // Whether the statistics are gathered or not
+    UINT32                            KernelStatus;
+    VMEXIT_REASON_STATISTICS          Reasons[MaximumVmexitStatisticsExitReasons];
+
+} DEBUGGER_VMEXIT_STATISTICS_REQUEST, *PDEBUGGER_VMEXIT_STATISTICS_REQUEST;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_SAMPLING_PROFILER_REQUEST \
+    sizeof(DEBUGGER_SAMPLING_PROFILER_REQUEST)
+
+/**
+ * @brief Actions of the sampling profiler
+ *
+ */
+typedef enum _DEBUGGER_SAMPLING_PROFILER_ACTION
+{
+    DEBUGGER_SAMPLING_PROFILER_ACTION_QUERY,
+    DEBUGGER_SAMPLING_PROFILER_ACTION_START,
+    DEBUGGER_SAMPLING_PROFILER_ACTION_STOP,
+
+} DEBUGGER_SAMPLING_PROFILER_ACTION;
+
+/**
+ * @brief request for starting, stopping or querying (taking) the samples
+ * of the sampling profiler
+ *
+ */
+typedef struct _DEBUGGER_SAMPLING_PROFILER_REQUEST
+{
+    DEBUGGER_SAMPLING_PROFILER_ACTION Action;
+    UINT64                            Interval;       // TSC ticks between the samples of each core (for starting)
+    BOOLEAN                           CaptureStack;   // Whether to take the (shallow) stack of the samples (for starting)
+    BOOLEAN                           IsEnabled;      // Whether the samples are taken or not
+    UINT64                            DroppedSamples; // Count of the samples that are dropped as the buffers are full
+    UINT32                            CountOfSamples;
+    UINT32                            KernelStatus;
+    SAMPLING_PROFILER_SAMPLE          Samples[MaximumSamplingProfilerSamplesToQuery];
+
+} DEBUGGER_SAMPLING_PROFILER_REQUEST, *PDEBUGGER_SAMPLING_PROFILER_REQUEST;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_DIRTY_PAGES_REQUEST \
+    sizeof(DEBUGGER_DIRTY_PAGES_REQUEST)
+
+/**
+ * @brief Actions of the tracking of dirty pages
+ *
+ */
+typedef enum _DEBUGGER_DIRTY_PAGES_ACTION
+{
+    DEBUGGER_DIRTY_PAGES_ACTION_QUERY,
+    DEBUGGER_DIRTY_PAGES_ACTION_QUERY_AND_CLEAR,
+    DEBUGGER_DIRTY_PAGES_ACTION_ENABLE,
+    DEBUGGER_DIRTY_PAGES_ACTION_DISABLE,
+
+} DEBUGGER_DIRTY_PAGES_ACTION;
+
+/**
+ * @brief request for enabling, disabling or querying the bitmap of
+ * the dirty pages (the pages that are written since the last clear)
+ * @details the 'query and clear' action starts a new round of the
+ * tracking and returns the first chunk of the bitmap of the previous
+ * round, the other chunks are read by the 'query' action
+ *
+ */
+typedef struct _DEBUGGER_DIRTY_PAGES_REQUEST
+{
+    DEBUGGER_DIRTY_PAGES_ACTION Action;
+    UINT64                      StartAddress; // Physical address of the first page of the chunk (for querying)
+    UINT64                      EndAddress;   // End of the tracked physical memory (exclusive)
+    BOOLEAN                     IsEnabled;    // Whether the dirty pages are tracked or not
+    UINT32                      KernelStatus;
+    UINT64                      Bitmap[DirtyPagesBitmapWordsToQuery];
+
+} DEBUGGER_DIRTY_PAGES_REQUEST, *PDEBUGGER_DIRTY_PAGES_REQUEST;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_QUERY_PHYSICAL_RAM_RANGES \
+    sizeof(DEBUGGER_QUERY_PHYSICAL_RAM_RANGES)
+
+/**
+ * @brief request for querying the ranges of the physical memory that
+ * are backed by RAM (sorted by the address)
+ *
+ */
+typedef struct _DEBUGGER_QUERY_PHYSICAL_RAM_RANGES
+{
+    UINT32             CountOfRanges;
+    UINT32             KernelStatus;
+    PHYSICAL_RAM_RANGE Ranges[MaximumPhysicalRamRangesToQuery];
+
+} DEBUGGER_QUERY_PHYSICAL_RAM_RANGES, *PDEBUGGER_QUERY_PHYSICAL_RAM_RANGES;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_INTEL_PT_REQUEST \
+    sizeof(DEBUGGER_INTEL_PT_REQUEST)
+
+/**
+ * @brief Actions of the trace of Intel PT (Processor Trace)
+ *
+ */
+typedef enum _DEBUGGER_INTEL_PT_ACTION
+{
+    DEBUGGER_INTEL_PT_ACTION_QUERY,
+    DEBUGGER_INTEL_PT_ACTION_ENABLE,
+    DEBUGGER_INTEL_PT_ACTION_DISABLE,
+    DEBUGGER_INTEL_PT_ACTION_PAUSE,
+    DEBUGGER_INTEL_PT_ACTION_RESUME,
+
+} DEBUGGER_INTEL_PT_ACTION;
+
+/**
+ * @brief request for enabling, disabling, pausing, resuming or querying
+ * the trace of Intel PT (Processor Trace) of the cores
+ * @details the 'query' action pauses the trace (if it's not paused) and
+ * returns a chunk of the trace of the target core, the 'resume' action
+ * discards the previous trace of all cores and continues tracing
+ *
+ */
+typedef struct _DEBUGGER_INTEL_PT_REQUEST
+{
+    DEBUGGER_INTEL_PT_ACTION Action;
+    UINT32                   ProcessId;                                       // Process to trace, zero for all processes (for enabling)
+    UINT64                   Cr3;                                             // Used instead of the process if it's not zero (for enabling)
+    UINT32                   BufferSize;                                      // Size of the buffer of each core, a power of two (for enabling)
+    BOOLEAN                  TraceUserMode;                                   // Trace the user-mode (for enabling)
+    BOOLEAN                  TraceKernelMode;                                 // Trace the kernel-mode (for enabling)
+    UINT32                   CountOfAddressRanges;                            // Zero for not filtering by IP (for enabling)
+    UINT64                   AddressRangesStart[IntelPtMaximumAddressRanges]; // First address of the ranges (for enabling)
+    UINT64                   AddressRangesEnd[IntelPtMaximumAddressRanges];   // Last address of the ranges, inclusive (for enabling)
+    UINT32                   CoreId;                                          // The core of the trace (for querying)
+    UINT64                   Offset;                                          // Offset of the chunk of the trace (for querying)
+    UINT64                   TraceSize;                                       // Size of the trace of the core (for querying)
+    UINT32                   TraceChunkSize;                                  // Size of the returned chunk (for querying)
+    BOOLEAN                  IsBufferFull;                                    // Whether the trace of the core is stopped as its buffer is full
+    BOOLEAN                  IsEnabled;                                       // Whether the trace is enabled or not
+    BOOLEAN                  IsPaused;                                        // Whether the trace is paused or not
+    UINT32                   CountOfCores;
+    UINT32                   KernelStatus;
+    UINT8                    Trace[IntelPtTraceBytesToQuery];
+
+} DEBUGGER_INTEL_PT_REQUEST, *PDEBUGGER_INTEL_PT_REQUEST;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_PEBS_SAMPLING_REQUEST \
+    sizeof(DEBUGGER_PEBS_SAMPLING_REQUEST)
+
+/**
+ * @brief Actions of the memory access sampling of PEBS
+ *
+ */
+typedef enum _DEBUGGER_PEBS_SAMPLING_ACTION
+{
+    DEBUGGER_PEBS_SAMPLING_ACTION_QUERY,
+    DEBUGGER_PEBS_SAMPLING_ACTION_START,
+    DEBUGGER_PEBS_SAMPLING_ACTION_STOP,
+
+} DEBUGGER_PEBS_SAMPLING_ACTION;
+
+/**
+ * @brief request for starting, stopping or querying the memory access
+ * sampling of PEBS (Precise Event Based Sampling)
+ * @details the records are aggregated into (RIP, data address) counts on
+ * each core, the 'query' action returns a chunk of the entries of the
+ * target core, starting from the 'StartIndex' slot of its table
+ *
+ */
+typedef struct _DEBUGGER_PEBS_SAMPLING_REQUEST
+{
+    DEBUGGER_PEBS_SAMPLING_ACTION Action;
+    BOOLEAN                       SampleLoads;        // Sample the loads (for starting)
+    BOOLEAN                       SampleStores;       // Sample the stores (for starting)
+    BOOLEAN                       SampleUserMode;     // Sample the accesses of the user-mode (for starting)
+    BOOLEAN                       SampleKernelMode;   // Sample the accesses of the kernel-mode (for starting)
+    UINT64                        StartAddress;       // First data address of the monitored range (for starting)
+    UINT64                        EndAddress;         // Last data address of the monitored range, inclusive (for starting)
+    UINT32                        SampleAfterValue;   // Count of the events between two records, zero for default (for starting)
+    UINT32                        LatencyThreshold;   // Minimum latency of the sampled loads, zero for default (for starting)
+    UINT32                        CoreId;             // The core of the entries (for querying)
+    UINT32                        StartIndex;         // The first slot of the table of the core (for querying)
+    UINT32                        NextIndex;          // The slot to continue the query from, 'TableCapacity' once finished (for querying)
+    UINT32                        TableCapacity;      // Count of the slots of the table of each core
+    UINT64                        CountOfRecords;     // Count of the records in the range (for querying)
+    UINT64                        CountOfFilteredOut; // Count of the records out of the range (for querying)
+    UINT64                        CountOfDropped;     // Count of the records that are dropped as the table is full (for querying)
+    BOOLEAN                       IsEnabled;          // Whether the sampling is enabled or not
+    UINT32                        CountOfCores;
+    UINT32                        CountOfEntries;
+    UINT32                        KernelStatus;
+    PEBS_SAMPLING_ENTRY           Entries[MaximumPebsSamplingEntriesToQuery];
+
+} DEBUGGER_PEBS_SAMPLING_REQUEST, *PDEBUGGER_PEBS_SAMPLING_REQUEST;
+
+/* ==============================================================================================
+ */
+
+/**
+ * @brief The statistics of the pools of an intention
+ *
+ */
+typedef struct _DEBUGGER_POOL_INTENTION_STATISTICS
+{
+    UINT32 TotalPools;    // Count of the allocated pools (including the pools that should be freed)
+    UINT32 BusyPools;     // Count of the pools that are in use
+    UINT32 FreePools;     // Count of the pools that are ready to be used
+    UINT32 PeakBusyPools; // Maximum count of the pools that were in use at the same time
+    UINT64 Bytes;         // Size of the allocated pools
+    UINT64 BusyBytes;     // Size of the pools that are in use
+    UINT64 Requests;      // Count of requests of pools
+    UINT64 Misses;        // Count of requests that didn't find any pool
+
+} DEBUGGER_POOL_INTENTION_STATISTICS, *PDEBUGGER_POOL_INTENTION_STATISTICS;
+
+#define SIZEOF_DEBUGGER_POOL_MANAGER_STATISTICS \
+    sizeof(DEBUGGER_POOL_MANAGER_STATISTICS)
+
+/**
+ * @brief request for querying the statistics of the pool manager and
+ * the nonpaged memory usage
+ * @details intentions are indexed by POOL_ALLOCATION_INTENTION, the sizes
+ * are in bytes
+ *
+ */
+typedef struct _DEBUGGER_POOL_MANAGER_STATISTICS
+{
+    DEBUGGER_POOL_INTENTION_STATISTICS Intentions[NumberOfPoolIntentions];
+    UINT64                             EptSplitTablesBytes;  // Pools of splitting 2MB pages to 4KB pages
+    UINT64                             HookPagesBytes;       // Pools of hooked pages, trampolines and detours
+    UINT64                             HyperlogBuffersBytes; // Message buffers of all cores
+    UINT64                             ScriptBuffersBytes;   // Variables, scratch memory, aggregations and outputs of scripts
+    UINT64                             EventObjectsBytes;    // Slabs of the events and the actions
+    UINT32                             KernelStatus;
+
+} DEBUGGER_POOL_MANAGER_STATISTICS, *PDEBUGGER_POOL_MANAGER_STATISTICS;
+
+/* ==============================================================================================
+ */
+
+/**
+ * @brief The contention of a named spinlock site
+ *
+ */
+typedef struct _SPINLOCK_CONTENTION_STATISTICS
+{
+    CHAR   Name[MaximumSpinlockSiteNameLength];
+    UINT64 Acquisitions;
+    UINT64 ContendedAcquisitions; // Acquisitions that the lock was held by another core
+    UINT64 SpinCycles;            // Cycles (TSC) of waiting for the lock
+    UINT64 MaximumWaitCycles;
+
+} SPINLOCK_CONTENTION_STATISTICS, *PSPINLOCK_CONTENTION_STATISTICS;
+
+#define SIZEOF_DEBUGGER_SPINLOCK_CONTENTION_REQUEST \
+    sizeof(DEBUGGER_SPINLOCK_CONTENTION_REQUEST)
+
+/**
+ * @brief request for querying the contention of the named spinlocks
+ * @details the sites are only counted if the drivers are compiled with
+ * UseSpinlockContentionInstrumentation
+ *
+ */
+typedef struct _DEBUGGER_SPINLOCK_CONTENTION_REQUEST
+{
+    BOOLEAN                        Reset; // Reset the counters after querying
+    BOOLEAN                        IsInstrumentationEnabled;
+    UINT32                         CountOfSites;
+    UINT32                         KernelStatus;
+    SPINLOCK_CONTENTION_STATISTICS Sites[MaximumSpinlockContentionSitesToQuery];
+
+} DEBUGGER_SPINLOCK_CONTENTION_REQUEST, *PDEBUGGER_SPINLOCK_CONTENTION_REQUEST;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_VMM_INITIALIZATION_TIMINGS \
+    sizeof(DEBUGGER_VMM_INITIALIZATION_TIMINGS)
+
+/**
+ * @brief The duration of the phases of initializing the hypervisor
+ * @details all of the durations are in microseconds
+ *
+ */
+typedef struct _DEBUGGER_VMM_INITIALIZATION_TIMINGS
+{
+    UINT32 CountOfCores;
+    UINT64 CompatibilityChecks;
+    UINT64 GuestStateAllocation;
+    UINT64 MemoryMapper;
+    UINT64 EptMemoryMap;       // EPT features, MTRRs and the map of the physical memory
+    UINT64 PoolManager;
+    UINT64 EptPageTables;      // The identity page table and the unhooked view
+    UINT64 PerCoreRegions;     // VMXON, VMCS, stacks and bitmaps of all cores (in parallel)
+    UINT64 SlowestCoreRegions; // Regions of the slowest core
+    UINT64 InvalidMsrsBitmap;
+    UINT64 GuestLaunch; // Setting up the VMCS and launching on all cores
+    UINT64 Total;
+    UINT32 KernelStatus;
+
+} DEBUGGER_VMM_INITIALIZATION_TIMINGS, *PDEBUGGER_VMM_INITIALIZATION_TIMINGS;
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_QUERY_DRIVER_VERSION \
+    sizeof(DEBUGGER_QUERY_DRIVER_VERSION)
+
+/**
+ * @brief request for querying the version of the running driver
+ * @details used to check whether an already running driver can be
+ * reused by the debugger or not
+ *
+ */
+typedef struct _DEBUGGER_QUERY_DRIVER_VERSION
+{
+    UINT32 VersionMajor;
+    UINT32 VersionMinor;
+    UINT32 VersionPatch;
+    UINT32 SizeOfRequestStructures; // Size of the known request structures (to detect layout changes)
+    UINT32 KernelStatus;
+
+} DEBUGGER_QUERY_DRIVER_VERSION, *PDEBUGGER_QUERY_DRIVER_VERSION;
+
+/**
+ * @brief The sum of the size of the structures that are shared by the
+ * debugger and the driver (for the compatibility check)
+ *
+ */
+#define DEBUGGER_QUERY_DRIVER_VERSION_STRUCTURES_SIZE                                        \
+    (UINT32)(sizeof(DEBUGGER_GENERAL_EVENT_DETAIL) + sizeof(DEBUGGER_GENERAL_ACTION) +       \
+             sizeof(DEBUGGER_EVENTS_BATCH_REQUEST) + sizeof(DEBUGGER_PATCH_MEMORY_REQUEST) + \
+             sizeof(DEBUGGER_VMM_INITIALIZATION_TIMINGS))
+
+/* ==============================================================================================
+ */
+
+/**
+ * @brief The hit statistics of an event
+ * @details the counters of all cores are summed up
+ *
+ */
+typedef struct _DEBUGGER_EVENT_STATISTICS
+{
+    UINT64  Tag;
+    UINT64  Hits;            // Triggers that matched the event (before the rate limit and the conditions)
+    UINT64  ConditionPasses; // Triggers that passed the conditions (the actions are performed)
+    UINT64  ScriptTsc;       // Total cycles of running the scripts of the event
+    UINT64  LastHitTsc;      // TSC of the last hit (zero if it's not hit)
+    BOOLEAN IsEnabled;
+
+} DEBUGGER_EVENT_STATISTICS, *PDEBUGGER_EVENT_STATISTICS;
+
+#define SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS \
+    sizeof(DEBUGGER_QUERY_EVENTS_STATISTICS)
+
+/**
+ * @brief request for querying the hit statistics of all of the events
+ *
+ */
+typedef struct _DEBUGGER_QUERY_EVENTS_STATISTICS
+{
+    BOOLEAN                   Reset;              // Reset the counters after querying
+    UINT32                    CountOfEvents;      // Count of the filled entries
+    UINT32                    TotalCountOfEvents; // Count of all of the events (might be more than the entries)
+    UINT32                    KernelStatus;
+    DEBUGGER_EVENT_STATISTICS Events[MaximumEventsStatisticsToQuery];
+
+} DEBUGGER_QUERY_EVENTS_STATISTICS, *PDEBUGGER_QUERY_EVENTS_STATISTICS;
+
+/**
+ * @brief Size of the request without the entries (only the filled
+ * entries are transferred in the debugger mode)
+ *
+ */
+#define SIZEOF_DEBUGGER_QUERY_EVENTS_STATISTICS_HEADER \
+    FIELD_OFFSET(DEBUGGER_QUERY_EVENTS_STATISTICS, Events)
+
+/* ==============================================================================================
+ */
+
+#define SIZEOF_DEBUGGER_QUERY_EVENT_RECORDS \
+    sizeof(DEBUGGER_QUERY_EVENT_RECORDS)
+
+/**
+ * @brief request for querying (taking) the records of the hits of the events
+ * @details the records are removed from the buffers of the cores, so each
+ * record is only queried once
+ *
+ */
+typedef struct _DEBUGGER_QUERY_EVENT_RECORDS
+{
+    UINT64                    DroppedRecords; // Count of the records that are dropped as the buffers are full
+    UINT32                    CountOfRecords;
+    UINT32                    KernelStatus;
+    DEBUGGER_EVENT_HIT_RECORD Records[MaximumEventRecordsToQuery];
+
+} DEBUGGER_QUERY_EVENT_RECORDS, *PDEBUGGER_QUERY_EVENT_RECORDS;
+
 /* ==============================================================================================
  */
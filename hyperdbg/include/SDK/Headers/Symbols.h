@@ -55,6 +55,18 @@ typedef struct _USERMODE_LOADED_MODULE_DETAILS
 
 } USERMODE_LOADED_MODULE_DETAILS, *PUSERMODE_LOADED_MODULE_DETAILS;
 
+/**
+ * @brief details of a newly loaded kernel module that is sent from
+ * the kernel to the user-mode of the debuggee
+ *
+ */
+typedef struct _DEBUGGEE_KERNEL_MODULE_LOADED_PACKET
+{
+    UINT64  BaseAddress;
+    wchar_t FilePath[MAX_PATH];
+
+} DEBUGGEE_KERNEL_MODULE_LOADED_PACKET, *PDEBUGGEE_KERNEL_MODULE_LOADED_PACKET;
+
 /**
  * @brief Callback type that should be used to add
  * list of Addresses to ObjectNames
@@ -63,24 +75,37 @@ typedef struct _USERMODE_LOADED_MODULE_DETAILS
 typedef VOID (*SymbolMapCallback)(UINT64 Address, char * ModuleName, char * ObjectName, unsigned int ObjectSize);
 
 /**
- * @brief request to add new symbol detail or update a previous
- * symbol table entry
+ * @brief request to add new symbol details or update previous
+ * symbol table entries
+ * @details a batch of symbol details is sent in each packet
  *
  */
 typedef struct _DEBUGGER_UPDATE_SYMBOL_TABLE
 {
-    UINT32               TotalSymbols;
-    UINT32               CurrentSymbolIndex;
-    MODULE_SYMBOL_DETAIL SymbolDetailPacket;
+    UINT32 TotalSymbols;
+    UINT32 CurrentSymbolIndex; // Index of the first symbol detail of this packet
+    UINT32 SymbolsCount;       // Count of symbol details in this packet
+
+    //
+    // Here is a list of MODULE_SYMBOL_DETAIL (appended)
+    //
 
 } DEBUGGER_UPDATE_SYMBOL_TABLE, *PDEBUGGER_UPDATE_SYMBOL_TABLE;
 
 /**
- * @brief check so the DEBUGGER_UPDATE_SYMBOL_TABLE should be smaller than packet size
+ * @brief Maximum number of symbol details that can be sent in a single
+ * packet of DEBUGGER_UPDATE_SYMBOL_TABLE
+ *
+ */
+#define DEBUGGER_UPDATE_SYMBOL_TABLE_MAXIMUM_SYMBOLS_IN_PACKET \
+    ((MaxSerialPacketSize - sizeof(DEBUGGER_REMOTE_PACKET) - sizeof(DEBUGGER_UPDATE_SYMBOL_TABLE)) / sizeof(MODULE_SYMBOL_DETAIL))
+
+/**
+ * @brief check so at least one symbol detail fits in a packet
  *
  */
-static_assert(sizeof(DEBUGGER_UPDATE_SYMBOL_TABLE) < PacketChunkSize,
-              "err (static_assert), size of PacketChunkSize should be bigger than DEBUGGER_UPDATE_SYMBOL_TABLE (MODULE_SYMBOL_DETAIL)");
+static_assert(DEBUGGER_UPDATE_SYMBOL_TABLE_MAXIMUM_SYMBOLS_IN_PACKET >= 1,
+              "err (static_assert), size of MaxSerialPacketSize should be bigger than DEBUGGER_UPDATE_SYMBOL_TABLE (MODULE_SYMBOL_DETAIL)");
 
 /*
 ==============================================================================================
@@ -46,6 +46,24 @@ __declspec(dllimport) int HyperDbgScriptReadFileAndExecuteCommandline(int argc,
 __declspec(dllimport) bool HyperDbgContinuePreviousCommand();
 __declspec(dllimport) bool HyperDbgCheckMultilineCommand(char* CurrentCommand, bool Reset);
 
+//
+// Structured (binary) interface
+//
+__declspec(dllimport) BOOLEAN HyperDbgReadMemory(PDEBUGGER_READ_MEMORY ReadMem, unsigned char* Buffer, UINT32* ReturnedLength);
+__declspec(dllimport) BOOLEAN HyperDbgReadRegisters(PDEBUGGEE_REGISTERS_CONTEXT Registers);
+__declspec(dllimport) UINT64 HyperDbgRegisterEvent(PHYPERDBG_EVENT_REGISTRATION Registration);
+__declspec(dllimport) void HyperDbgSetEventCallback(EventCallback handler);
+__declspec(dllimport) BOOLEAN HyperDbgModifyMonitorRange(UINT64 Tag, BOOLEAN IsAdd, UINT64 StartAddress, UINT64 EndAddress);
+__declspec(dllimport) HANDLE HyperDbgContinueDebuggeeAsync(DebuggeePausedCallback Callback, PVOID Context);
+__declspec(dllimport) HANDLE HyperDbgPauseDebuggeeAsync(DebuggeePausedCallback Callback, PVOID Context);
+__declspec(dllimport) BOOLEAN HyperDbgIsDebuggeeRunning();
+
+//
+// Dirty pages
+//
+__declspec(dllimport) bool HyperDbgSetDirtyPagesTracking(bool Enable);
+__declspec(dllimport) bool HyperDbgGetAndClearDirtyPages(unsigned long long* Bitmap, unsigned long long BitmapSize, unsigned long long* EndAddress);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,7 +21,7 @@
 //////////////////////////////////////////////////
 
 IMPORT_EXPORT_HYPERLOG BOOLEAN
-LogInitialize(MESSAGE_TRACING_CALLBACKS * MsgTracingCallbacks);
+LogInitialize(MESSAGE_TRACING_CALLBACKS * MsgTracingCallbacks, LOG_BUFFER_CONFIGURATION * Configuration);
 
 IMPORT_EXPORT_HYPERLOG VOID
 LogUnInitialize();
@@ -29,6 +29,24 @@ LogUnInitialize();
 IMPORT_EXPORT_HYPERLOG UINT32
 LogMarkAllAsRead(BOOLEAN IsVmxRoot);
 
+IMPORT_EXPORT_HYPERLOG VOID
+LogCheckAndPerformAllocationAndDeallocation();
+
+IMPORT_EXPORT_HYPERLOG UINT32
+LogQueryBufferStatistics(PLOG_BUFFER_STATISTICS Statistics, UINT32 MaximumCount);
+
+IMPORT_EXPORT_HYPERLOG UINT64
+LogQueryBuffersSize();
+
+IMPORT_EXPORT_HYPERLOG UINT64
+LogSetEventTriggerTimestamp(UINT64 Timestamp);
+
+IMPORT_EXPORT_HYPERLOG VOID
+LogSetTscOffset(UINT32 CoreId, INT64 Offset);
+
+IMPORT_EXPORT_HYPERLOG UINT64
+LogReadTimestamp();
+
 IMPORT_EXPORT_HYPERLOG BOOLEAN
 LogCallbackPrepareAndSendMessageToQueue(UINT32       OperationCode,
                                         BOOLEAN      IsImmediateMessage,
@@ -59,3 +77,12 @@ LogRegisterEventBasedNotification(PDEVICE_OBJECT DeviceObject, PIRP Irp);
 
 IMPORT_EXPORT_HYPERLOG NTSTATUS
 LogRegisterIrpBasedNotification(PDEVICE_OBJECT DeviceObject, PIRP Irp);
+
+IMPORT_EXPORT_HYPERLOG NTSTATUS
+LogRegisterSharedMemoryNotification(PDEVICE_OBJECT DeviceObject, PIRP Irp);
+
+IMPORT_EXPORT_HYPERLOG BOOLEAN
+LogReleaseSharedMemoryMessages(PLOG_SHARED_BUFFERS_RELEASE Release);
+
+IMPORT_EXPORT_HYPERLOG BOOLEAN
+LogUnmapSharedMemory();
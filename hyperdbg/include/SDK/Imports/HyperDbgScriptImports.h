@@ -22,6 +22,8 @@ __declspec(dllimport) PSYMBOL_BUFFER ScriptEngineParse(char* str);
 __declspec(dllimport) void PrintSymbolBuffer(const PSYMBOL_BUFFER SymbolBuffer);
 __declspec(dllimport) void PrintSymbol(PSYMBOL Symbol);
 __declspec(dllimport) void RemoveSymbolBuffer(PSYMBOL_BUFFER SymbolBuffer);
+__declspec(dllimport) PSYMBOL_BUFFER ScriptEngineDuplicateSymbolBuffer(const PSYMBOL_BUFFER SymbolBuffer);
+__declspec(dllimport) const char* ScriptEngineGetBinaryTraceFormat(UINT32 FormatId);
 
 //
 // pdb parser
@@ -26,6 +26,9 @@ VmFuncVmxVmcall(unsigned long long VmcallNumber,
                 unsigned long long OptionalParam2,
                 long long          OptionalParam3);
 
+IMPORT_EXPORT_VMM NTSTATUS
+VmFuncVmxBenchmarkVmcall();
+
 IMPORT_EXPORT_VMM VOID
 VmFuncPerformRipIncrement(UINT32 CoreId);
 
@@ -38,6 +41,9 @@ VmFuncChangeMtfUnsettingState(UINT32 CoreId, BOOLEAN Set);
 IMPORT_EXPORT_VMM VOID
 VmFuncChangeIgnoreOneMtfState(UINT32 CoreId, BOOLEAN Set);
 
+IMPORT_EXPORT_VMM VOID
+VmFuncQuerySpinlockContention(PDEBUGGER_SPINLOCK_CONTENTION_REQUEST ContentionRequest);
+
 IMPORT_EXPORT_VMM VOID
 VmFuncSetMonitorTrapFlag(BOOLEAN Set);
 
@@ -80,12 +86,27 @@ VmFuncSetExceptionBitmap(UINT32 CoreId, UINT32 IdtIndex);
 IMPORT_EXPORT_VMM VOID
 VmFuncUnsetExceptionBitmap(UINT32 CoreId, UINT32 IdtIndex);
 
+IMPORT_EXPORT_VMM VOID
+VmFuncChangeMsrBitmap(UINT32 CoreId, BOOLEAN Set, BOOLEAN IsWrite, UINT64 MsrMask);
+
+IMPORT_EXPORT_VMM VOID
+VmFuncChangeBitmapOwnership(UINT32 CoreId, BOOLEAN Acquire, BITMAP_OWNERSHIP_RESOURCE_TYPE ResourceType, UINT64 Index, UINT64 Mask);
+
 IMPORT_EXPORT_VMM VOID
 VmFuncSetExternalInterruptExiting(UINT32 CoreId, BOOLEAN Set);
 
 IMPORT_EXPORT_VMM VOID
 VmFuncSetRdtscExiting(UINT32 CoreId, BOOLEAN Set);
 
+IMPORT_EXPORT_VMM VOID
+VmFuncUnsetExternalInterruptExitingOnlyOnClearingInterruptEvents(UINT32 CoreId);
+
+IMPORT_EXPORT_VMM VOID
+VmFuncUnsetRdtscExitingForClearingTscEvents(UINT32 CoreId);
+
+IMPORT_EXPORT_VMM VOID
+VmFuncSetEferSyscallHook(UINT32 CoreId, BOOLEAN Set);
+
 IMPORT_EXPORT_VMM VOID
 VmFuncSetMovDebugRegsExiting(UINT32 CoreId, BOOLEAN Set);
 
@@ -104,6 +125,33 @@ VmFuncSetTriggerEventForVmcalls(BOOLEAN Set);
 IMPORT_EXPORT_VMM VOID
 VmFuncSetTriggerEventForCpuids(BOOLEAN Set);
 
+IMPORT_EXPORT_VMM VOID
+VmFuncSetTriggerEventForTscs(BOOLEAN Set);
+
+IMPORT_EXPORT_VMM VOID
+VmFuncSetCheckCpuidsForUserDebuggerCommands(BOOLEAN Set);
+
+IMPORT_EXPORT_VMM VOID
+VmFuncSetSaveXmmRegistersOnVmexits(BOOLEAN Set);
+
+IMPORT_EXPORT_VMM BOOLEAN
+VmFuncSetCr3VmexitFilter(BOOLEAN Set, UINT64 Cr3);
+
+IMPORT_EXPORT_VMM VOID
+VmFuncBypassCr3VmexitFilter(BOOLEAN Bypass);
+
+IMPORT_EXPORT_VMM BOOLEAN
+VmFuncSetLastBranchRecords(BOOLEAN Set);
+
+IMPORT_EXPORT_VMM UINT32
+VmFuncGetLastBranchRecords(PDEBUGGER_LAST_BRANCH_RECORD Records, UINT32 Count);
+
+IMPORT_EXPORT_VMM BOOLEAN
+VmFuncArmInstructionCounter(UINT32 CoreId, UINT64 Count);
+
+IMPORT_EXPORT_VMM UINT64
+VmFuncDisarmInstructionCounter(UINT32 CoreId);
+
 IMPORT_EXPORT_VMM VOID
 VmFuncSetInterruptibilityState(UINT64 InterruptibilityState);
 
@@ -161,6 +209,9 @@ VmFuncClearSteppingBits(UINT32 Interruptibility);
 IMPORT_EXPORT_VMM BOOLEAN
 VmFuncInitVmm(VMM_CALLBACKS * VmmCallbacks);
 
+IMPORT_EXPORT_VMM VOID
+VmFuncQueryInitializationTimings(PDEBUGGER_VMM_INITIALIZATION_TIMINGS Timings);
+
 IMPORT_EXPORT_VMM UINT32
 VmFuncVmxCompatibleStrlen(const CHAR * s);
 
@@ -195,6 +246,24 @@ ConfigureEnableEferSyscallEventsOnAllProcessors(DEBUGGER_EVENT_SYSCALL_SYSRET_TY
 IMPORT_EXPORT_VMM VOID
 ConfigureDisableEferSyscallEventsOnAllProcessors();
 
+IMPORT_EXPORT_VMM VOID
+ConfigureSetSyscallHookFilter(UINT64 * Bitmap, BOOLEAN IsActive);
+
+IMPORT_EXPORT_VMM VOID
+ConfigureSetCpuidEventFilter(UINT32 * Leaves, UINT32 LeavesCount, BOOLEAN IsActive);
+
+IMPORT_EXPORT_VMM BOOLEAN
+ConfigureEnableLstarSyscallHook();
+
+IMPORT_EXPORT_VMM VOID
+ConfigureDisableLstarSyscallHook();
+
+IMPORT_EXPORT_VMM BOOLEAN
+ConfigureEnableIdtEntryInterruptHook(UINT32 Vector);
+
+IMPORT_EXPORT_VMM VOID
+ConfigureDisableIdtEntryInterruptHook(UINT32 Vector);
+
 IMPORT_EXPORT_VMM VOID
 ConfigureSetExternalInterruptExitingOnSingleCore(UINT32 TargetCoreId);
 
@@ -213,12 +282,24 @@ ConfigureSetExceptionBitmapOnSingleCore(UINT32 TargetCoreId, UINT32 BitMask);
 IMPORT_EXPORT_VMM VOID
 ConfigureEnableMovToControlRegisterExitingOnSingleCore(UINT32 TargetCoreId, DEBUGGER_BROADCASTING_OPTIONS * BroadcastingOption);
 
+IMPORT_EXPORT_VMM VOID
+ConfigureAcquireBitmapOwnershipOnSingleCore(UINT32 TargetCoreId, DEBUGGER_BROADCASTING_OPTIONS * BroadcastingOption);
+
+IMPORT_EXPORT_VMM VOID
+ConfigureReleaseBitmapOwnershipOnSingleCore(UINT32 TargetCoreId, DEBUGGER_BROADCASTING_OPTIONS * BroadcastingOption);
+
 IMPORT_EXPORT_VMM VOID
 ConfigureChangeMsrBitmapWriteOnSingleCore(UINT32 TargetCoreId, UINT64 MsrMask);
 
 IMPORT_EXPORT_VMM VOID
 ConfigureChangeMsrBitmapReadOnSingleCore(UINT32 TargetCoreId, UINT64 MsrMask);
 
+IMPORT_EXPORT_VMM VOID
+ConfigureUnsetMsrBitmapWriteOnSingleCore(UINT32 TargetCoreId, UINT64 MsrMask);
+
+IMPORT_EXPORT_VMM VOID
+ConfigureUnsetMsrBitmapReadOnSingleCore(UINT32 TargetCoreId, UINT64 MsrMask);
+
 IMPORT_EXPORT_VMM VOID
 ConfigureChangeIoBitmapOnSingleCore(UINT32 TargetCoreId, UINT64 Port);
 
@@ -234,12 +315,52 @@ ConfigureDirtyLoggingUninitializeOnAllProcessors();
 IMPORT_EXPORT_VMM VOID
 ConfigureModeBasedExecHookUninitializeOnAllProcessors();
 
+IMPORT_EXPORT_VMM BOOLEAN
+ConfigureModeBasedExecHookTraceRange(UINT64  Tag,
+                                     UINT64  StartAddress,
+                                     UINT64  EndAddress,
+                                     UINT32  ProcessId,
+                                     BOOLEAN IsUserMode);
+
+IMPORT_EXPORT_VMM BOOLEAN
+ConfigureModeBasedExecHookUntraceRange(UINT64 Tag);
+
 IMPORT_EXPORT_VMM BOOLEAN
 ConfigureEptHook(PVOID TargetAddress, UINT32 ProcessId);
 
 IMPORT_EXPORT_VMM BOOLEAN
 ConfigureEptHook2(PVOID TargetAddress, PVOID HookFunction, UINT32 ProcessId, BOOLEAN SetHookForRead, BOOLEAN SetHookForWrite, BOOLEAN SetHookForExec, BOOLEAN EptHiddenHook2);
 
+IMPORT_EXPORT_VMM BOOLEAN
+ConfigureEptHookMonitorLargePage(PVOID TargetAddress, UINT32 ProcessId, BOOLEAN SetHookForRead, BOOLEAN SetHookForWrite, BOOLEAN SetHookForExec);
+
+IMPORT_EXPORT_VMM UINT32
+ConfigureEptHookBatch(PEPT_HOOKS_BATCH_ENTRY Entries, UINT32 Count);
+
+IMPORT_EXPORT_VMM UINT32
+ConfigureEptHook2QueryDetourHitCounts(PEPT_HOOK2_DETOUR_HIT_DETAILS HitDetails, UINT32 MaximumCount);
+
+IMPORT_EXPORT_VMM VOID
+ConfigureVmexitStatistics(PDEBUGGER_VMEXIT_STATISTICS_REQUEST StatisticsRequest);
+
+IMPORT_EXPORT_VMM VOID
+ConfigureSamplingProfiler(PDEBUGGER_SAMPLING_PROFILER_REQUEST ProfilerRequest);
+
+IMPORT_EXPORT_VMM VOID
+ConfigureDirtyPages(PDEBUGGER_DIRTY_PAGES_REQUEST DirtyPagesRequest);
+
+IMPORT_EXPORT_VMM VOID
+ConfigureIntelPt(PDEBUGGER_INTEL_PT_REQUEST IntelPtRequest);
+
+IMPORT_EXPORT_VMM VOID
+ConfigurePebsSampling(PDEBUGGER_PEBS_SAMPLING_REQUEST PebsRequest);
+
+IMPORT_EXPORT_VMM VOID
+ConfigureEptSnapshot(PDEBUGGER_EPT_SNAPSHOT_REQUEST SnapshotRequest);
+
+IMPORT_EXPORT_VMM VOID
+ConfigureEptSnapshotAllocatePageCopies(UINT32 Count);
+
 IMPORT_EXPORT_VMM BOOLEAN
 ConfigureEptHookModifyInstructionFetchState(UINT32 CoreId, PVOID PhysicalAddress, BOOLEAN IsUnset);
 
@@ -252,6 +373,34 @@ ConfigureEptHookModifyPageWriteState(UINT32 CoreId, PVOID PhysicalAddress, BOOLE
 IMPORT_EXPORT_VMM BOOLEAN
 ConfigureEptHookUnHookSingleAddress(UINT64 VirtualAddress, UINT64 PhysAddress, UINT32 ProcessId);
 
+IMPORT_EXPORT_VMM BOOLEAN
+ConfigureEptHookMonitorFromVmxRoot(PVOID TargetAddress, CR3_TYPE ProcessCr3, BOOLEAN SetHookForRead, BOOLEAN SetHookForWrite, BOOLEAN SetHookForExec, UINT64 * PhysicalBaseAddress);
+
+IMPORT_EXPORT_VMM BOOLEAN
+ConfigureEptHookUnHookSinglePageFromVmxRoot(UINT64 PhysicalBaseAddress);
+
+//////////////////////////////////////////////////
+//       Pending Updates Of VMCS Controls  		//
+//////////////////////////////////////////////////
+
+IMPORT_EXPORT_VMM VOID
+VmcsPendingUpdatesSetRdtscExiting(UINT64 CoreMask, BOOLEAN Set);
+
+IMPORT_EXPORT_VMM VOID
+VmcsPendingUpdatesSetNmiExiting(UINT64 CoreMask, BOOLEAN Set);
+
+IMPORT_EXPORT_VMM BOOLEAN
+VmcsPendingUpdatesSetExceptionBitmap(UINT64 CoreMask, UINT32 IdtIndex, BOOLEAN Set);
+
+IMPORT_EXPORT_VMM VOID
+VmcsPendingUpdatesSetLastBranchRecords(UINT64 CoreMask, BOOLEAN Set);
+
+IMPORT_EXPORT_VMM VOID
+VmcsPendingUpdatesRequestDebuggerTasks(UINT64 CoreMask);
+
+IMPORT_EXPORT_VMM BOOLEAN
+VmcsPendingUpdatesSetPreemptionTimerKick(UINT32 TimerValue);
+
 //////////////////////////////////////////////////
 //         Reversing Machine Functions 	   		//
 //////////////////////////////////////////////////
@@ -259,6 +408,15 @@ ConfigureEptHookUnHookSingleAddress(UINT64 VirtualAddress, UINT64 PhysAddress, U
 IMPORT_EXPORT_VMM VOID
 ConfigureInitializeReversingMachineOnAllProcessors(PREVERSING_MACHINE_RECONSTRUCT_MEMORY_REQUEST RevServiceRequest);
 
+IMPORT_EXPORT_VMM VOID
+ConfigureQueryReversingMachineCoverage(PREVERSING_MACHINE_QUERY_COVERAGE CoverageRequest);
+
+IMPORT_EXPORT_VMM VOID
+ConfigureMapReversingMachineResults(PREVERSING_MACHINE_MAP_RESULTS MapRequest);
+
+IMPORT_EXPORT_VMM VOID
+ConfigureUnmapReversingMachineResultsOfCurrentProcess();
+
 //////////////////////////////////////////////////
 //                General Functions 	   		//
 //////////////////////////////////////////////////
@@ -354,6 +512,16 @@ MemoryMapperGetPteVaWithoutSwitchingByCr3(_In_ PVOID        Va,
                                           _In_ PAGING_LEVEL Level,
                                           _In_ CR3_TYPE     TargetCr3);
 
+IMPORT_EXPORT_VMM BOOLEAN
+MemoryMapperWalkPageTablesWithoutSwitchingByCr3(_In_ PVOID                    Va,
+                                                _In_ CR3_TYPE                 TargetCr3,
+                                                _Out_ PPAGE_TABLE_WALK_RESULT Result);
+
+IMPORT_EXPORT_VMM BOOLEAN
+MemoryMapperWalkPageTablesByCr3(_In_ PVOID                    Va,
+                                _In_ CR3_TYPE                 TargetCr3,
+                                _Out_ PPAGE_TABLE_WALK_RESULT Result);
+
 IMPORT_EXPORT_VMM PVOID
 MemoryMapperGetPteVaOnTargetProcess(_In_ PVOID        Va,
                                     _In_ PAGING_LEVEL Level);
@@ -444,6 +612,32 @@ MemoryMapperSetSupervisorBitWithoutSwitchingByCr3(_In_ PVOID        Va,
 IMPORT_EXPORT_VMM BOOLEAN
 MemoryMapperCheckIfPageIsNxBitSetOnTargetProcess(_In_ PVOID Va);
 
+// ----------------------------------------------------------------------------
+// Physical Memory Map Functions
+//
+IMPORT_EXPORT_VMM BOOLEAN
+PhysicalMemoryMapIsRam(_In_ UINT64 PhysicalAddress);
+
+IMPORT_EXPORT_VMM BOOLEAN
+PhysicalMemoryMapGetNextRange(_Inout_ UINT64 * RangeStart,
+                              _Inout_ UINT64 * RangeEnd);
+
+IMPORT_EXPORT_VMM BOOLEAN
+PhysicalMemoryMapGetRange(_In_ UINT32    Index,
+                          _Out_ UINT64 * BaseAddress,
+                          _Out_ UINT64 * Size);
+
+// ----------------------------------------------------------------------------
+// Reverse Mapping Functions
+//
+IMPORT_EXPORT_VMM BOOLEAN
+ReverseMappingQuery(_In_ UINT64                    PhysicalAddress,
+                    _In_ BOOLEAN                   Rebuild,
+                    _Out_ PREVERSE_MAPPING_DETAILS Mappings,
+                    _In_ UINT32                    MaximumMappings,
+                    _Out_ UINT32 *                 CountOfMappings,
+                    _Out_ UINT32 *                 CountOfIndexedMappings);
+
 //////////////////////////////////////////////////
 //				Memory Manager		    		//
 //////////////////////////////////////////////////
@@ -470,6 +664,12 @@ PoolManagerFreePool(UINT64 AddressToFree);
 IMPORT_EXPORT_VMM VOID
 PoolManagerShowPreAllocatedPools();
 
+IMPORT_EXPORT_VMM BOOLEAN
+PoolManagerSetWatermarks(POOL_ALLOCATION_INTENTION Intention, UINT32 LowWatermark, UINT32 HighWatermark);
+
+IMPORT_EXPORT_VMM VOID
+PoolManagerQueryStatistics(PDEBUGGER_POOL_INTENTION_STATISTICS Statistics);
+
 //////////////////////////////////////////////////
 //          VMX Registers Modification  		//
 //////////////////////////////////////////////////
@@ -680,6 +880,12 @@ BroadcastChangeAllMsrBitmapWriteAllCores(UINT64 BitmapMask);
 IMPORT_EXPORT_VMM VOID
 BroadcastResetAllMsrBitmapWriteAllCores();
 
+IMPORT_EXPORT_VMM VOID
+BroadcastUnsetMsrBitmapReadAllCores(UINT64 BitmapMask);
+
+IMPORT_EXPORT_VMM VOID
+BroadcastUnsetMsrBitmapWriteAllCores(UINT64 BitmapMask);
+
 IMPORT_EXPORT_VMM VOID
 BroadcastDisableRdtscExitingForClearingEventsAllCores();
 
@@ -710,6 +916,12 @@ BroadcastEnableMovControlRegisterExitingAllCores(PDEBUGGER_BROADCASTING_OPTIONS
 IMPORT_EXPORT_VMM VOID
 BroadcastDisableMovToControlRegistersExitingAllCores(PDEBUGGER_BROADCASTING_OPTIONS BroadcastingOption);
 
+IMPORT_EXPORT_VMM VOID
+BroadcastAcquireBitmapOwnershipAllCores(PDEBUGGER_BROADCASTING_OPTIONS BroadcastingOption);
+
+IMPORT_EXPORT_VMM VOID
+BroadcastReleaseBitmapOwnershipAllCores(PDEBUGGER_BROADCASTING_OPTIONS BroadcastingOption);
+
 IMPORT_EXPORT_VMM VOID
 BroadcastEnableMovDebugRegistersExitingAllCores();
 
@@ -739,3 +951,30 @@ BroadcastEnableEferSyscallEventsOnAllProcessors();
 
 IMPORT_EXPORT_VMM VOID
 BroadcastDisableEferSyscallEventsOnAllProcessors();
+
+IMPORT_EXPORT_VMM VOID
+BroadcastEnableRdtscExitingOnCores(UINT64 CoreMask);
+
+IMPORT_EXPORT_VMM VOID
+BroadcastDisableRdtscExitingForClearingEventsOnCores(UINT64 CoreMask);
+
+IMPORT_EXPORT_VMM VOID
+BroadcastEnableRdpmcExitingOnCores(UINT64 CoreMask);
+
+IMPORT_EXPORT_VMM VOID
+BroadcastDisableRdpmcExitingOnCores(UINT64 CoreMask);
+
+IMPORT_EXPORT_VMM VOID
+BroadcastDisableEferSyscallEventsOnCores(UINT64 CoreMask);
+
+IMPORT_EXPORT_VMM VOID
+BroadcastSetExternalInterruptExitingOnCores(UINT64 CoreMask);
+
+IMPORT_EXPORT_VMM VOID
+BroadcastUnsetExternalInterruptExitingOnlyOnClearingInterruptEventsOnCores(UINT64 CoreMask);
+
+IMPORT_EXPORT_VMM VOID
+BroadcastAcquireBitmapOwnershipOnCores(UINT64 CoreMask, PDEBUGGER_BROADCASTING_OPTIONS BroadcastingOption);
+
+IMPORT_EXPORT_VMM VOID
+BroadcastReleaseBitmapOwnershipOnCores(UINT64 CoreMask, PDEBUGGER_BROADCASTING_OPTIONS BroadcastingOption);
@@ -52,3 +52,21 @@ typedef struct _MESSAGE_TRACING_CALLBACKS
     SEND_IMMEDIATE_MESSAGE          SendImmediateMessage;
 
 } MESSAGE_TRACING_CALLBACKS, *PMESSAGE_TRACING_CALLBACKS;
+
+//////////////////////////////////////////////////
+//			   Configuration Structure          //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Capacity of the message buffers of each core
+ * @details zero values mean that the default capacity is used, the
+ * capacities are rounded up to a power of two
+ *
+ */
+typedef struct _LOG_BUFFER_CONFIGURATION
+{
+    UINT32 PacketsCapacityPerCore;         // Count of chunks of the regular buffers
+    UINT32 PacketsCapacityPriorityPerCore; // Count of chunks of the priority buffers
+    UINT32 MaximumPacketsCapacityPerCore;  // Regular buffers are grown up to this count (zero: no growth)
+
+} LOG_BUFFER_CONFIGURATION, *PLOG_BUFFER_CONFIGURATION;
@@ -72,11 +72,18 @@ typedef BOOLEAN (*DEBUGGING_CALLBACK_CONDITIONAL_PAGE_FAULT_EXCEPTION)(UINT32 Co
                                                                        UINT64 Address,
                                                                        ULONG  ErrorCode);
 
+/**
+ * @brief Handle the overflow of the counter of the retired instructions
+ *
+ */
+typedef VOID (*DEBUGGING_CALLBACK_HANDLE_INSTRUCTION_COUNTER_OVERFLOW)(UINT32 CoreId,
+                                                                       UINT64 CountOfExecutedInstructions);
+
 /**
  * @brief Check for commands in user-debugger
  *
  */
-typedef BOOLEAN (*UD_CHECK_FOR_COMMAND)();
+typedef BOOLEAN (*UD_CHECK_FOR_COMMAND)(GUEST_REGS * Regs);
 
 /**
  * @brief Handle registered MTF callback
@@ -96,6 +103,12 @@ typedef BOOLEAN (*VMM_CALLBACK_RESTORE_EPT_STATE)(UINT32 CoreId);
  */
 typedef BOOLEAN (*VMM_CALLBACK_CHECK_UNHANDLED_EPT_VIOLATION)(UINT32 CoreId, UINT64 ViolationQualification, UINT64 GuestPhysicalAddr);
 
+/**
+ * @brief Apply the pending tasks of the debugger on the current core
+ *
+ */
+typedef VOID (*VMM_CALLBACK_APPLY_PENDING_TASKS)(UINT32 CoreId);
+
 /**
  * @brief Handle cr3 process change callbacks
  *
@@ -190,13 +203,15 @@ typedef struct _VMM_CALLBACKS
     VMM_CALLBACK_QUERY_TERMINATE_PROTECTED_RESOURCE VmmCallbackQueryTerminateProtectedResource; // Fixed
     VMM_CALLBACK_RESTORE_EPT_STATE                  VmmCallbackRestoreEptState;                 // Fixed
     VMM_CALLBACK_CHECK_UNHANDLED_EPT_VIOLATION      VmmCallbackCheckUnhandledEptViolations;     // Fixed
+    VMM_CALLBACK_APPLY_PENDING_TASKS                VmmCallbackApplyPendingTasks;               // Fixed
 
     //
     // Debugging callbacks
     //
-    DEBUGGING_CALLBACK_HANDLE_BREAKPOINT_EXCEPTION       DebuggingCallbackHandleBreakpointException;      // Fixed
-    DEBUGGING_CALLBACK_HANDLE_DEBUG_BREAKPOINT_EXCEPTION DebuggingCallbackHandleDebugBreakpointException; // Fixed
-    DEBUGGING_CALLBACK_CONDITIONAL_PAGE_FAULT_EXCEPTION  DebuggingCallbackConditionalPageFaultException;  // Fixed
+    DEBUGGING_CALLBACK_HANDLE_BREAKPOINT_EXCEPTION         DebuggingCallbackHandleBreakpointException;         // Fixed
+    DEBUGGING_CALLBACK_HANDLE_DEBUG_BREAKPOINT_EXCEPTION   DebuggingCallbackHandleDebugBreakpointException;    // Fixed
+    DEBUGGING_CALLBACK_CONDITIONAL_PAGE_FAULT_EXCEPTION    DebuggingCallbackConditionalPageFaultException;     // Fixed
+    DEBUGGING_CALLBACK_HANDLE_INSTRUCTION_COUNTER_OVERFLOW DebuggingCallbackHandleInstructionCounterOverflow; // Fixed
 
     //
     // Interception callbacks
@@ -24,6 +24,7 @@
  *
  */
 #include "pch.h"
+#include "components/spinlock/header/Spinlock.h"
 
 /**
  * @brief The maximum wait before PAUSE
@@ -31,6 +32,22 @@
  */
 static unsigned MaxWait = 65536;
 
+#if UseSpinlockContentionInstrumentation == TRUE
+
+/**
+ * @brief The registered named spinlock sites of this module
+ *
+ */
+static PSPINLOCK_SITE g_SpinlockContentionSites[SPINLOCK_MAXIMUM_CONTENTION_SITES];
+
+/**
+ * @brief Count of the registered named spinlock sites
+ *
+ */
+static volatile LONG g_SpinlockContentionSitesCount;
+
+#endif
+
 /**
  * @brief Tries to get the lock otherwise returns
  *
@@ -149,6 +166,129 @@ SpinlockLockWithCustomWait(volatile LONG * Lock, unsigned MaximumWait)
     }
 }
 
+#if UseSpinlockContentionInstrumentation == TRUE
+
+/**
+ * @brief Count an acquisition of a named spinlock site
+ * @details the site is registered on its first acquisition
+ *
+ * @param Site The site of the spinlock
+ * @param WaitCycles Cycles (TSC) of waiting for the lock (zero if the lock
+ * was not contended)
+ *
+ * @return VOID
+ */
+void
+SpinlockRecordContention(PSPINLOCK_SITE Site, UINT64 WaitCycles)
+{
+    LONG64 MaximumWait;
+    LONG   Index;
+
+    if (!Site->IsRegistered && InterlockedCompareExchange(&Site->IsRegistered, TRUE, FALSE) == FALSE)
+    {
+        Index = InterlockedIncrement(&g_SpinlockContentionSitesCount) - 1;
+
+        if (Index < SPINLOCK_MAXIMUM_CONTENTION_SITES)
+        {
+            g_SpinlockContentionSites[Index] = Site;
+        }
+    }
+
+    InterlockedIncrement64(&Site->Acquisitions);
+
+    if (WaitCycles == 0)
+    {
+        return;
+    }
+
+    InterlockedIncrement64(&Site->ContendedAcquisitions);
+    InterlockedAdd64(&Site->SpinCycles, (LONG64)WaitCycles);
+
+    MaximumWait = Site->MaximumWaitCycles;
+
+    while ((LONG64)WaitCycles > MaximumWait)
+    {
+        if (InterlockedCompareExchange64(&Site->MaximumWaitCycles, (LONG64)WaitCycles, MaximumWait) == MaximumWait)
+        {
+            break;
+        }
+
+        MaximumWait = Site->MaximumWaitCycles;
+    }
+}
+
+/**
+ * @brief Tries to get the lock and won't return until successfully get the lock
+ * and counts the contention of the lock at the site
+ * @details the TSC is only read if the lock is contended
+ *
+ * @param LONG Lock variable
+ * @param MaximumWait Maximum wait (pause) count
+ * @param Site The site of the spinlock
+ */
+void
+SpinlockLockWithSite(volatile LONG * Lock, unsigned MaximumWait, PSPINLOCK_SITE Site)
+{
+    UINT64 StartTime;
+
+    if (SpinlockTryLock(Lock))
+    {
+        SpinlockRecordContention(Site, 0);
+        return;
+    }
+
+    StartTime = __rdtsc();
+
+    SpinlockLockWithCustomWait(Lock, MaximumWait);
+
+    //
+    // At least one cycle is counted for a contended acquisition
+    //
+    SpinlockRecordContention(Site, __rdtsc() - StartTime + 1);
+}
+
+/**
+ * @brief Read the contention of a registered named spinlock site
+ *
+ * @param Index Index of the site
+ * @param Snapshot The contention of the site
+ * @param Reset Whether the counters of the site should be reset or not
+ *
+ * @return BOOLEAN FALSE if there is no site at this index
+ */
+BOOLEAN
+SpinlockReadContentionSite(UINT32 Index, PSPINLOCK_SITE Snapshot, BOOLEAN Reset)
+{
+    PSPINLOCK_SITE Site;
+
+    if (Index >= (UINT32)g_SpinlockContentionSitesCount || Index >= SPINLOCK_MAXIMUM_CONTENTION_SITES)
+    {
+        return FALSE;
+    }
+
+    Site = g_SpinlockContentionSites[Index];
+
+    if (Site == NULL)
+    {
+        //
+        // The site is not stored yet
+        //
+        RtlZeroMemory(Snapshot, sizeof(SPINLOCK_SITE));
+        return TRUE;
+    }
+
+    Snapshot->Name                  = Site->Name;
+    Snapshot->IsRegistered          = TRUE;
+    Snapshot->Acquisitions          = Reset ? InterlockedExchange64(&Site->Acquisitions, 0) : Site->Acquisitions;
+    Snapshot->ContendedAcquisitions = Reset ? InterlockedExchange64(&Site->ContendedAcquisitions, 0) : Site->ContendedAcquisitions;
+    Snapshot->SpinCycles            = Reset ? InterlockedExchange64(&Site->SpinCycles, 0) : Site->SpinCycles;
+    Snapshot->MaximumWaitCycles     = Reset ? InterlockedExchange64(&Site->MaximumWaitCycles, 0) : Site->MaximumWaitCycles;
+
+    return TRUE;
+}
+
+#endif
+
 /**
  * @brief Release the lock
  *
@@ -11,6 +11,42 @@
  */
 #pragma once
 
+//
+// The spinlock component is also compiled in the modules that don't
+// include the configuration in their pre-compiled headers
+//
+#include "Configuration.h"
+
+//////////////////////////////////////////////////
+//				    Constants   				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum count of the named spinlock sites of each module
+ *
+ */
+#define SPINLOCK_MAXIMUM_CONTENTION_SITES 64
+
+//////////////////////////////////////////////////
+//				    Structures   				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The contention of a named spinlock site
+ * @details sites are registered the first time that they're acquired
+ *
+ */
+typedef struct _SPINLOCK_SITE
+{
+    const char *    Name;
+    volatile LONG   IsRegistered;
+    volatile LONG64 Acquisitions;
+    volatile LONG64 ContendedAcquisitions; // Acquisitions that the lock was held by another core
+    volatile LONG64 SpinCycles;            // Cycles (TSC) of waiting for the lock
+    volatile LONG64 MaximumWaitCycles;
+
+} SPINLOCK_SITE, *PSPINLOCK_SITE;
+
 //////////////////////////////////////////////////
 //				 Spinlock Funtions				//
 //////////////////////////////////////////////////
@@ -37,3 +73,57 @@ SpinlockInterlockedCompareExchange(
     MetaScopedExpr(SpinlockLock(&LockObject),   \
                    SpinlockUnlock(&LockObject), \
                    CodeToRun)
+
+//////////////////////////////////////////////////
+//		   Spinlock Contention Funtions			//
+//////////////////////////////////////////////////
+
+#if UseSpinlockContentionInstrumentation == TRUE
+
+void
+SpinlockLockWithSite(volatile LONG * Lock, unsigned MaximumWait, PSPINLOCK_SITE Site);
+
+void
+SpinlockRecordContention(PSPINLOCK_SITE Site, UINT64 WaitCycles);
+
+BOOLEAN
+SpinlockReadContentionSite(UINT32 Index, PSPINLOCK_SITE Snapshot, BOOLEAN Reset);
+
+/**
+ * @brief Defines the (static) site of a named spinlock
+ *
+ */
+#    define SpinlockDefineSite(SiteVariable, SiteName) \
+        static SPINLOCK_SITE SiteVariable = {SiteName}
+
+/**
+ * @brief Get the lock and count its contention at this site
+ *
+ */
+#    define SpinlockLockNamed(Lock, SiteName)                      \
+        do                                                         \
+        {                                                          \
+            SpinlockDefineSite(SpinlockNamedSite, SiteName);       \
+            SpinlockLockWithSite(Lock, 65536, &SpinlockNamedSite); \
+        } while (FALSE)
+
+/**
+ * @brief Get the lock (with a custom maximum wait) and count its
+ * contention at this site
+ *
+ */
+#    define SpinlockLockWithCustomWaitNamed(Lock, MaximumWait, SiteName) \
+        do                                                               \
+        {                                                                \
+            SpinlockDefineSite(SpinlockNamedSite, SiteName);             \
+            SpinlockLockWithSite(Lock, MaximumWait, &SpinlockNamedSite); \
+        } while (FALSE)
+
+#else
+
+#    define SpinlockLockNamed(Lock, SiteName) SpinlockLock(Lock)
+
+#    define SpinlockLockWithCustomWaitNamed(Lock, MaximumWait, SiteName) \
+        SpinlockLockWithCustomWait(Lock, MaximumWait)
+
+#endif
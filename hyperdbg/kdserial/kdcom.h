@@ -55,6 +55,28 @@ Revision History:
 #define FC_ENABLE         0x01 // FCR control bit to enable the FIFO
 #define FC_CLEAR_RECEIVE  0x02 // FCR control bit to clear receive FIFO
 #define FC_CLEAR_TRANSMIT 0x04 // FCR control bit to clear transmit FIFO
+#define FC_64_BYTE_FIFO   0x20 // FCR control bit to enable the 64-byte FIFO (16750)
+
+#define FC_RECEIVE_TRIGGER_1  0x00 // FCR bits to set the receive trigger level to 1 byte
+#define FC_RECEIVE_TRIGGER_4  0x40 // FCR bits to set the receive trigger level to 4 bytes
+#define FC_RECEIVE_TRIGGER_8  0x80 // FCR bits to set the receive trigger level to 8 bytes
+#define FC_RECEIVE_TRIGGER_14 0xC0 // FCR bits to set the receive trigger level to 14 bytes
+
+#define COM_IIR          0x02  // interrupt identification register (read)
+#define IIR_FIFO_ENABLED 0xC0  // IIR bits to indicate the FIFO is enabled
+#define IIR_64_BYTE_FIFO 0x20  // IIR bit to indicate the 64-byte FIFO is enabled (16750)
+
+#define UART16550_FIFO_SIZE 16 // Size of the transmit FIFO of 16550A
+#define UART16750_FIFO_SIZE 64 // Size of the transmit FIFO of 16750
+
+//
+// Configuration of the FIFOs of the port of the debuggee, the receive
+// trigger level is only used for the interrupts of the UART (the bytes
+// are received by polling LSR), and the transmit burst is limited to
+// the size of the detected FIFO
+//
+#define UART_RECEIVE_FIFO_TRIGGER FC_RECEIVE_TRIGGER_14
+#define UART_TRANSMIT_BURST_LIMIT UART16750_FIFO_SIZE
 
 #define COM_OUTRDY 0x20        // LSR bit to indicate transmitter is empty
 #define COM_DATRDY 0x01        // LSR bit to indicate data is available
@@ -71,6 +93,9 @@ Revision History:
 #define BD_56000  56000
 #define BD_57600  57600
 #define BD_115200 115200
+#define BD_230400 230400
+#define BD_460800 460800
+#define BD_921600 921600
 
 //
 // This bit controls the loopback testing mode of the device.  Basically
@@ -24,6 +24,19 @@ Abstract:
 //
 CPPORT g_PortDetails = {0};
 
+//
+// Count of bytes that are written to the transmit FIFO once the
+// transmitter is empty
+//
+UINT32 g_PortTransmitFifoSize = 1;
+
+//
+// The port of the bulk link (only used for sending the bulk data
+// to the debugger) and the count of bytes of its bursts
+//
+CPPORT g_BulkPortDetails          = {0};
+UINT32 g_BulkPortTransmitFifoSize = 1;
+
 /*
 
 F8 02 00 00 00 00 00 00  00 C2 01 00 00 00 01 00  ................
@@ -81,16 +94,103 @@ KdHyperDbgTest(UINT16 Byte)
     }
 }
 
+static VOID
+PrepareConnectionPort(PCPPORT Port, UINT32 * TransmitFifoSize, UINT32 PortAddress, UINT32 Baudrate)
+{
+    UCHAR Lcr;
+    UCHAR Iir;
+
+    Port->Address   = PortAddress;
+    Port->BaudRate  = Baudrate;
+    Port->Flags     = 0;
+    Port->ByteWidth = 1;
+
+    Port->Write = WritePortWithIndex8;
+    Port->Read  = ReadPortWithIndex8;
+
+    //
+    // Enable the FIFOs with the configured receive trigger level, the
+    // 64-byte FIFO of 16750 can only be changed while DLAB is set, other
+    // UARTs ignore the bit (FCR is not affected by DLAB)
+    //
+    Lcr = ReadPortWithIndex8(Port, COM_LCR);
+
+    WritePortWithIndex8(Port, COM_LCR, (UCHAR)(Lcr | LC_DLAB));
+    WritePortWithIndex8(Port, COM_FCR, FC_ENABLE | FC_64_BYTE_FIFO | UART_RECEIVE_FIFO_TRIGGER);
+    WritePortWithIndex8(Port, COM_LCR, (UCHAR)(Lcr & ~LC_DLAB));
+
+    //
+    // The FIFO bits of IIR show whether the FIFO of the port is enabled
+    // (16550A) or it's a 64-byte FIFO (16750), otherwise only one byte
+    // can be written at a time
+    //
+    Iir = ReadPortWithIndex8(Port, COM_IIR);
+
+    if ((Iir & IIR_FIFO_ENABLED) != IIR_FIFO_ENABLED)
+    {
+        *TransmitFifoSize = 1;
+    }
+    else if (Iir & IIR_64_BYTE_FIFO)
+    {
+        *TransmitFifoSize = UART16750_FIFO_SIZE;
+    }
+    else
+    {
+        *TransmitFifoSize = UART16550_FIFO_SIZE;
+    }
+
+    if (*TransmitFifoSize > UART_TRANSMIT_BURST_LIMIT)
+    {
+        *TransmitFifoSize = UART_TRANSMIT_BURST_LIMIT;
+    }
+}
+
+static VOID
+SendBufferToPort(PCPPORT Port, UINT32 TransmitFifoSize, const UCHAR * Buffer, UINT32 Length)
+{
+    UINT32 Offset = 0;
+    UINT32 Count;
+
+    while (Offset < Length)
+    {
+        //
+        // Wait until the transmitter is empty and send the first byte
+        //
+        if (Uart16550PutByte(Port, Buffer[Offset], TRUE) != UartSuccess)
+        {
+            return;
+        }
+
+        Offset++;
+
+        //
+        // The transmit FIFO was empty, so the rest of the burst is written
+        // without polling LSR (unless the modem control should be checked
+        // before each byte)
+        //
+        if (CHECK_FLAG(Port->Flags, PORT_MODEM_CONTROL))
+        {
+            continue;
+        }
+
+        for (Count = 1; Count < TransmitFifoSize && Offset < Length; Count++)
+        {
+            Port->Write(Port, COM_DAT, Buffer[Offset]);
+            Offset++;
+        }
+    }
+}
+
 VOID
 KdHyperDbgPrepareDebuggeeConnectionPort(UINT32 PortAddress, UINT32 Baudrate)
 {
-    g_PortDetails.Address   = PortAddress;
-    g_PortDetails.BaudRate  = Baudrate;
-    g_PortDetails.Flags     = 0;
-    g_PortDetails.ByteWidth = 1;
+    PrepareConnectionPort(&g_PortDetails, &g_PortTransmitFifoSize, PortAddress, Baudrate);
+}
 
-    g_PortDetails.Write = WritePortWithIndex8;
-    g_PortDetails.Read  = ReadPortWithIndex8;
+VOID
+KdHyperDbgPrepareDebuggeeBulkConnectionPort(UINT32 PortAddress, UINT32 Baudrate)
+{
+    PrepareConnectionPort(&g_BulkPortDetails, &g_BulkPortTransmitFifoSize, PortAddress, Baudrate);
 }
 
 VOID
@@ -99,6 +199,18 @@ KdHyperDbgSendByte(UCHAR Byte, BOOLEAN BusyWait)
     Uart16550PutByte(&g_PortDetails, Byte, BusyWait);
 }
 
+VOID
+KdHyperDbgSendBuffer(const UCHAR * Buffer, UINT32 Length)
+{
+    SendBufferToPort(&g_PortDetails, g_PortTransmitFifoSize, Buffer, Length);
+}
+
+VOID
+KdHyperDbgSendBulkBuffer(const UCHAR * Buffer, UINT32 Length)
+{
+    SendBufferToPort(&g_BulkPortDetails, g_BulkPortTransmitFifoSize, Buffer, Length);
+}
+
 BOOLEAN
 KdHyperDbgRecvByte(PUCHAR RecvByte)
 {
@@ -109,6 +221,54 @@ KdHyperDbgRecvByte(PUCHAR RecvByte)
     return FALSE;
 }
 
+UINT32
+KdHyperDbgRecvBuffer(PUCHAR Buffer, UINT32 Length)
+{
+    UINT32 Count = 0;
+    UCHAR  Lsr;
+
+    if (Length == 0)
+    {
+        return 0;
+    }
+
+    //
+    // The first byte is received by the common routine, it checks whether
+    // the port is present and handles the modem control
+    //
+    if (Uart16550GetByte(&g_PortDetails, &Buffer[0]) != UartSuccess)
+    {
+        return 0;
+    }
+
+    Count++;
+
+    if (CHECK_FLAG(g_PortDetails.Flags, PORT_MODEM_CONTROL))
+    {
+        return Count;
+    }
+
+    //
+    // Drain the rest of the bytes that are already in the receive FIFO,
+    // the bytes with errors are left to the common routine (next call)
+    //
+    while (Count < Length)
+    {
+        Lsr = g_PortDetails.Read(&g_PortDetails, COM_LSR);
+
+        if (!CHECK_FLAG(Lsr, COM_DATRDY) ||
+            CHECK_FLAG(Lsr, COM_PE | COM_FE | COM_OE))
+        {
+            break;
+        }
+
+        Buffer[Count] = g_PortDetails.Read(&g_PortDetails, COM_DAT);
+        Count++;
+    }
+
+    return Count;
+}
+
 // ----------------------------------------------- Internal Function Prototypes
 
 BOOLEAN
@@ -451,7 +611,7 @@ Return Value:
         return FALSE;
     }
 
-    if ((Rate == 0) || (Clock == 0))
+    if ((Rate == 0) || (Clock == 0) || (Rate > Clock))
     {
         return FALSE;
     }
@@ -459,10 +619,17 @@ Return Value:
     //
     // A device's baud rate is written to DLL and DLM.  The values of these
     // registers are the resultant when the max rate (clock) is divided by the
-    // device's desired operating rate.
+    // device's desired operating rate. The divisor is rounded to the nearest
+    // value, as the small divisors of high-speed rates (e.g., 921600 on a
+    // 14.7456 MHz UART) are off by a large ratio once they're truncated.
     //
 
-    const ULONG DivisorLatch = Clock / Rate;
+    const ULONG DivisorLatch = (Clock + Rate / 2) / Rate;
+
+    if (DivisorLatch > 0xFFFF)
+    {
+        return FALSE;
+    }
 
     //
     // Set the divisor latch access bit (DLAB) in the line control register.
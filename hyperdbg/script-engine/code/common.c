@@ -11,6 +11,41 @@
  */
 #include "pch.h"
 
+/**
+ * @brief Allocates a token with a buffer of at least MaxLen characters
+ * @details removed tokens are reused (with their buffers) before
+ * allocating new tokens
+ *
+ * @param MaxLen
+ * @return PTOKEN
+ */
+static PTOKEN
+AllocateToken(unsigned int MaxLen)
+{
+    PTOKEN Token;
+
+    if (TokenPoolCount != 0)
+    {
+        Token = TokenPool[--TokenPoolCount];
+
+        if (Token->MaxLen < MaxLen)
+        {
+            free(Token->Value);
+
+            Token->MaxLen = MaxLen;
+            Token->Value  = (char *)calloc(Token->MaxLen + 1, sizeof(char));
+        }
+    }
+    else
+    {
+        Token         = (PTOKEN)malloc(sizeof(TOKEN));
+        Token->MaxLen = MaxLen;
+        Token->Value  = (char *)calloc(Token->MaxLen + 1, sizeof(char));
+    }
+
+    return Token;
+}
+
 /**
  * @brief Allocates a new token
  *
@@ -24,16 +59,14 @@ NewUnknownToken()
     //
     // Allocate memory for token and its value
     //
-    Token        = (PTOKEN)malloc(sizeof(TOKEN));
-    Token->Value = (char *)calloc(TOKEN_VALUE_MAX_LEN + 1, sizeof(char));
+    Token = AllocateToken(TOKEN_VALUE_MAX_LEN);
 
     //
     // Init fields
     //
-    strcpy(Token->Value, "");
-    Token->Type   = UNKNOWN;
-    Token->Len    = 0;
-    Token->MaxLen = TOKEN_VALUE_MAX_LEN;
+    Token->Value[0] = '\0';
+    Token->Type     = UNKNOWN;
+    Token->Len      = 0;
 
     return Token;
 }
@@ -41,34 +74,42 @@ NewUnknownToken()
 PTOKEN
 NewToken(TOKEN_TYPE Type, char * Value)
 {
+    unsigned int Len = strlen(Value);
+
     //
-    // Allocate memory for token]
+    // Allocate memory for token
     //
-    PTOKEN Token = (PTOKEN)malloc(sizeof(TOKEN));
+    PTOKEN Token = AllocateToken(Len);
 
     //
     // Init fields
     //
-    unsigned int Len = strlen(Value);
-    Token->Type      = Type;
-    Token->Len       = Len;
-    Token->MaxLen    = Len;
-    Token->Value     = (char *)calloc(Token->MaxLen + 1, sizeof(char));
-    strcpy(Token->Value, Value);
+    Token->Type = Type;
+    Token->Len  = Len;
+    memcpy(Token->Value, Value, Len + 1);
 
     return Token;
 }
 
 /**
  * @brief Removes allocated memory of a token
+ * @details the token is kept to be reused if the token pool is not full
  *
  * @param Token
  */
 void
 RemoveToken(PTOKEN * Token)
 {
-    free((*Token)->Value);
-    free(*Token);
+    if (TokenPoolCount < TOKEN_POOL_MAX_COUNT)
+    {
+        TokenPool[TokenPoolCount++] = *Token;
+    }
+    else
+    {
+        free((*Token)->Value);
+        free(*Token);
+    }
+
     *Token = NULL;
     return;
 }
@@ -200,8 +241,8 @@ Append(PTOKEN Token, char c)
     //
     // Append the new charcter to the string
     //
-    strncat(Token->Value, &c, 1);
-    Token->Len++;
+    Token->Value[Token->Len++] = c;
+    Token->Value[Token->Len]   = '\0';
 }
 
 /**
@@ -212,12 +253,16 @@ Append(PTOKEN Token, char c)
 PTOKEN
 CopyToken(PTOKEN Token)
 {
-    PTOKEN TokenCopy  = (PTOKEN)malloc(sizeof(TOKEN));
-    TokenCopy->Type   = Token->Type;
-    TokenCopy->MaxLen = Token->MaxLen;
-    TokenCopy->Len    = Token->Len;
-    TokenCopy->Value  = (char *)calloc(strlen(Token->Value) + 1, sizeof(char));
-    strcpy(TokenCopy->Value, Token->Value);
+    //
+    // The length of the value is not always updated (the value of special
+    // tokens is directly copied)
+    //
+    unsigned int ValueLen  = strlen(Token->Value);
+    PTOKEN       TokenCopy = AllocateToken(ValueLen);
+
+    TokenCopy->Type = Token->Type;
+    TokenCopy->Len  = Token->Len;
+    memcpy(TokenCopy->Value, Token->Value, ValueLen + 1);
 
     return TokenCopy;
 }
@@ -531,15 +576,9 @@ CleanTempList(void)
 char
 IsType1Func(PTOKEN Operator)
 {
-    unsigned int n = ONEOPFUNC1_LENGTH;
-    for (int i = 0; i < n; i++)
-    {
-        if (!strcmp(Operator->Value, OneOpFunc1[i]))
-        {
-            return 1;
-        }
-    }
-    return 0;
+    unsigned long long Classes = LookupName(NAME_LOOKUP_TABLE_OPERATOR_CLASSES, Operator->Value);
+
+    return Classes != (unsigned long long)INVALID && (Classes & OPERATOR_CLASS_TYPE1_FUNC) != 0;
 }
 
 /**
@@ -551,15 +590,9 @@ IsType1Func(PTOKEN Operator)
 char
 IsType2Func(PTOKEN Operator)
 {
-    unsigned int n = ONEOPFUNC2_LENGTH;
-    for (int i = 0; i < n; i++)
-    {
-        if (!strcmp(Operator->Value, OneOpFunc2[i]))
-        {
-            return 1;
-        }
-    }
-    return 0;
+    unsigned long long Classes = LookupName(NAME_LOOKUP_TABLE_OPERATOR_CLASSES, Operator->Value);
+
+    return Classes != (unsigned long long)INVALID && (Classes & OPERATOR_CLASS_TYPE2_FUNC) != 0;
 }
 
 /**
@@ -571,15 +604,9 @@ IsType2Func(PTOKEN Operator)
 char
 IsTwoOperandOperator(PTOKEN Operator)
 {
-    unsigned int n = OPERATORS_TWO_OPERAND_LIST_LENGTH;
-    for (int i = 0; i < n; i++)
-    {
-        if (!strcmp(Operator->Value, OperatorsTwoOperandList[i]))
-        {
-            return 1;
-        }
-    }
-    return 0;
+    unsigned long long Classes = LookupName(NAME_LOOKUP_TABLE_OPERATOR_CLASSES, Operator->Value);
+
+    return Classes != (unsigned long long)INVALID && (Classes & OPERATOR_CLASS_TWO_OPERAND_OPERATOR) != 0;
 }
 
 /**
@@ -591,15 +618,9 @@ IsTwoOperandOperator(PTOKEN Operator)
 char
 IsOneOperandOperator(PTOKEN Operator)
 {
-    unsigned int n = OPERATORS_ONE_OPERAND_LIST_LENGTH;
-    for (int i = 0; i < n; i++)
-    {
-        if (!strcmp(Operator->Value, OperatorsOneOperandList[i]))
-        {
-            return 1;
-        }
-    }
-    return 0;
+    unsigned long long Classes = LookupName(NAME_LOOKUP_TABLE_OPERATOR_CLASSES, Operator->Value);
+
+    return Classes != (unsigned long long)INVALID && (Classes & OPERATOR_CLASS_ONE_OPERAND_OPERATOR) != 0;
 }
 
 /**
@@ -611,15 +632,9 @@ IsOneOperandOperator(PTOKEN Operator)
 char
 IsType4Func(PTOKEN Operator)
 {
-    unsigned int n = VARARGFUNC1_LENGTH;
-    for (int i = 0; i < n; i++)
-    {
-        if (!strcmp(Operator->Value, VarArgFunc1[i]))
-        {
-            return 1;
-        }
-    }
-    return 0;
+    unsigned long long Classes = LookupName(NAME_LOOKUP_TABLE_OPERATOR_CLASSES, Operator->Value);
+
+    return Classes != (unsigned long long)INVALID && (Classes & OPERATOR_CLASS_TYPE4_FUNC) != 0;
 }
 
 /**
@@ -631,15 +646,9 @@ IsType4Func(PTOKEN Operator)
 char
 IsType5Func(PTOKEN Operator)
 {
-    unsigned int n = ZEROOPFUNC1_LENGTH;
-    for (int i = 0; i < n; i++)
-    {
-        if (!strcmp(Operator->Value, ZeroOpFunc1[i]))
-        {
-            return 1;
-        }
-    }
-    return 0;
+    unsigned long long Classes = LookupName(NAME_LOOKUP_TABLE_OPERATOR_CLASSES, Operator->Value);
+
+    return Classes != (unsigned long long)INVALID && (Classes & OPERATOR_CLASS_TYPE5_FUNC) != 0;
 }
 
 /**
@@ -651,15 +660,9 @@ IsType5Func(PTOKEN Operator)
 char
 IsType6Func(PTOKEN Operator)
 {
-    unsigned int n = TWOOPFUNC1_LENGTH;
-    for (int i = 0; i < n; i++)
-    {
-        if (!strcmp(Operator->Value, TwoOpFunc1[i]))
-        {
-            return 1;
-        }
-    }
-    return 0;
+    unsigned long long Classes = LookupName(NAME_LOOKUP_TABLE_OPERATOR_CLASSES, Operator->Value);
+
+    return Classes != (unsigned long long)INVALID && (Classes & OPERATOR_CLASS_TYPE6_FUNC) != 0;
 }
 
 /**
@@ -671,15 +674,9 @@ IsType6Func(PTOKEN Operator)
 char
 IsType7Func(PTOKEN Operator)
 {
-    unsigned int n = TWOOPFUNC2_LENGTH;
-    for (int i = 0; i < n; i++)
-    {
-        if (!strcmp(Operator->Value, TwoOpFunc2[i]))
-        {
-            return 1;
-        }
-    }
-    return 0;
+    unsigned long long Classes = LookupName(NAME_LOOKUP_TABLE_OPERATOR_CLASSES, Operator->Value);
+
+    return Classes != (unsigned long long)INVALID && (Classes & OPERATOR_CLASS_TYPE7_FUNC) != 0;
 }
 
 /**
@@ -691,15 +688,9 @@ IsType7Func(PTOKEN Operator)
 char
 IsType8Func(PTOKEN Operator)
 {
-    unsigned int n = THREEOPFUNC1_LENGTH;
-    for (int i = 0; i < n; i++)
-    {
-        if (!strcmp(Operator->Value, ThreeOpFunc1[i]))
-        {
-            return 1;
-        }
-    }
-    return 0;
+    unsigned long long Classes = LookupName(NAME_LOOKUP_TABLE_OPERATOR_CLASSES, Operator->Value);
+
+    return Classes != (unsigned long long)INVALID && (Classes & OPERATOR_CLASS_TYPE8_FUNC) != 0;
 }
 
 /**
@@ -735,102 +726,275 @@ IsSemanticRule(PTOKEN Token)
 }
 
 /**
- * @brief Gets the Non Terminal Id object
+ * @brief Computes the hash of a name (FNV-1a)
  *
- * @param Token
- * @return int
+ * @param Name
+ * @return unsigned int
  */
-int
-GetNonTerminalId(PTOKEN Token)
+static unsigned int
+HashName(const char * Name)
 {
-    for (int i = 0; i < NONETERMINAL_COUNT; i++)
+    unsigned int Hash = 2166136261;
+
+    while (*Name)
     {
-        if (!strcmp(Token->Value, NoneTerminalMap[i]))
-            return i;
+        Hash ^= (unsigned char)*Name++;
+        Hash *= 16777619;
     }
-    return INVALID;
+
+    return Hash;
 }
 
 /**
- * @brief Gets the Terminal Id object
+ * @brief Finds the entry of a name in a name lookup table
  *
- * @param Token
- * @return int
+ * @param Table
+ * @param Name
+ * @param Insert Whether a new entry should be added if the name is not found
+ * @return PNAME_LOOKUP_ENTRY NULL if the name is not found (or the table is full)
  */
-int
-GetTerminalId(PTOKEN Token)
+static PNAME_LOOKUP_ENTRY
+GetNameLookupEntry(PNAME_LOOKUP_ENTRY Table, const char * Name, BOOLEAN Insert)
 {
-    for (int i = 0; i < TERMINAL_COUNT; i++)
+    PNAME_LOOKUP_ENTRY Entry;
+    unsigned int       Index = HashName(Name);
+
+    for (unsigned int i = 0; i < NAME_LOOKUP_TABLE_SIZE; i++)
     {
-        if (Token->Type == HEX)
-        {
-            if (!strcmp("_hex", TerminalMap[i]))
-                return i;
-        }
-        else if (Token->Type == GLOBAL_ID || Token->Type == GLOBAL_UNRESOLVED_ID)
-        {
-            if (!strcmp("_global_id", TerminalMap[i]))
-            {
-                return i;
-            }
-        }
-        else if (Token->Type == LOCAL_ID || Token->Type == LOCAL_UNRESOLVED_ID)
-        {
-            if (!strcmp("_local_id", TerminalMap[i]))
-            {
-                return i;
-            }
-        }
-        else if (Token->Type == REGISTER)
-        {
-            if (!strcmp("_register", TerminalMap[i]))
-            {
-                return i;
-            }
-        }
-        else if (Token->Type == PSEUDO_REGISTER)
-        {
-            if (!strcmp("_pseudo_register", TerminalMap[i]))
-            {
-                return i;
-            }
-        }
-        else if (Token->Type == DECIMAL)
-        {
-            if (!strcmp("_decimal", TerminalMap[i]))
-            {
-                return i;
-            }
-        }
-        else if (Token->Type == BINARY)
+        Entry = &Table[(Index + i) & (NAME_LOOKUP_TABLE_SIZE - 1)];
+
+        if (Entry->Name == NULL)
         {
-            if (!strcmp("_binary", TerminalMap[i]))
+            if (!Insert)
             {
-                return i;
+                return NULL;
             }
+
+            Entry->Name  = Name;
+            Entry->Value = 0;
+            return Entry;
         }
-        else if (Token->Type == OCTAL)
+
+        if (!strcmp(Entry->Name, Name))
         {
-            if (!strcmp("_octal", TerminalMap[i]))
-            {
-                return i;
-            }
+            return Entry;
         }
-        else if (Token->Type == STRING)
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Adds a name to a name lookup table
+ * @details if the name is already in the table, the first value is kept
+ * (same as searching the lists of names)
+ *
+ * @param TableType
+ * @param Name
+ * @param Value
+ */
+static void
+AddName(NAME_LOOKUP_TABLE_TYPE TableType, const char * Name, unsigned long long Value)
+{
+    PNAME_LOOKUP_ENTRY Entry = GetNameLookupEntry(NameLookupTables[TableType], Name, FALSE);
+
+    if (Entry == NULL)
+    {
+        Entry = GetNameLookupEntry(NameLookupTables[TableType], Name, TRUE);
+
+        if (Entry != NULL)
         {
-            if (!strcmp("_string", TerminalMap[i]))
-            {
-                return i;
-            }
+            Entry->Value = Value;
         }
+    }
+}
+
+/**
+ * @brief Adds a list of operators to the classes of operators
+ *
+ * @param List
+ * @param Count
+ * @param Class
+ */
+static void
+AddOperatorClass(const char ** List, unsigned int Count, unsigned long long Class)
+{
+    PNAME_LOOKUP_ENTRY Entry;
+
+    for (unsigned int i = 0; i < Count; i++)
+    {
+        Entry = GetNameLookupEntry(NameLookupTables[NAME_LOOKUP_TABLE_OPERATOR_CLASSES], List[i], TRUE);
 
-        else // Keyword
+        if (Entry != NULL)
         {
-            if (!strcmp(Token->Value, TerminalMap[i]))
-                return i;
+            Entry->Value |= Class;
         }
     }
-    return INVALID;
+}
+
+/**
+ * @brief Builds the name lookup tables from the generated lists of
+ * the parse tables
+ *
+ * @param InitOnce
+ * @param Parameter
+ * @param Context
+ * @return BOOL
+ */
+static BOOL CALLBACK
+InitializeNameLookupTables(PINIT_ONCE InitOnce, PVOID Parameter, PVOID * Context)
+{
+    UNREFERENCED_PARAMETER(InitOnce);
+    UNREFERENCED_PARAMETER(Parameter);
+    UNREFERENCED_PARAMETER(Context);
+
+    for (int i = 0; i < NONETERMINAL_COUNT; i++)
+    {
+        AddName(NAME_LOOKUP_TABLE_NON_TERMINALS, NoneTerminalMap[i], i);
+    }
+
+    for (int i = 0; i < TERMINAL_COUNT; i++)
+    {
+        AddName(NAME_LOOKUP_TABLE_TERMINALS, TerminalMap[i], i);
+    }
+
+    for (int i = 0; i < LALR_NONTERMINAL_COUNT; i++)
+    {
+        AddName(NAME_LOOKUP_TABLE_LALR_NON_TERMINALS, LalrNoneTerminalMap[i], i);
+    }
+
+    for (int i = 0; i < LALR_TERMINAL_COUNT; i++)
+    {
+        AddName(NAME_LOOKUP_TABLE_LALR_TERMINALS, LalrTerminalMap[i], i);
+    }
+
+    //
+    // Keywords and terminals are both keywords for the scanner
+    //
+    for (int i = 0; i < KEYWORD_LIST_LENGTH; i++)
+    {
+        AddName(NAME_LOOKUP_TABLE_KEYWORDS, KeywordList[i], 1);
+    }
+
+    for (int i = 0; i < TERMINAL_COUNT; i++)
+    {
+        AddName(NAME_LOOKUP_TABLE_KEYWORDS, TerminalMap[i], 1);
+    }
+
+    for (int i = 0; i < REGISTER_MAP_LIST_LENGTH; i++)
+    {
+        AddName(NAME_LOOKUP_TABLE_REGISTERS, RegisterMapList[i].Name, RegisterMapList[i].Type);
+    }
+
+    for (int i = 0; i < PSEUDO_REGISTER_MAP_LIST_LENGTH; i++)
+    {
+        AddName(NAME_LOOKUP_TABLE_PSEUDO_REGISTERS, PseudoRegisterMapList[i].Name, PseudoRegisterMapList[i].Type);
+    }
+
+    for (int i = 0; i < SEMANTIC_RULES_MAP_LIST_LENGTH; i++)
+    {
+        AddName(NAME_LOOKUP_TABLE_SEMANTIC_RULES, SemanticRulesMapList[i].Name, SemanticRulesMapList[i].Type);
+    }
+
+    AddOperatorClass(OneOpFunc1, ONEOPFUNC1_LENGTH, OPERATOR_CLASS_TYPE1_FUNC);
+    AddOperatorClass(OneOpFunc2, ONEOPFUNC2_LENGTH, OPERATOR_CLASS_TYPE2_FUNC);
+    AddOperatorClass(VarArgFunc1, VARARGFUNC1_LENGTH, OPERATOR_CLASS_TYPE4_FUNC);
+    AddOperatorClass(ZeroOpFunc1, ZEROOPFUNC1_LENGTH, OPERATOR_CLASS_TYPE5_FUNC);
+    AddOperatorClass(TwoOpFunc1, TWOOPFUNC1_LENGTH, OPERATOR_CLASS_TYPE6_FUNC);
+    AddOperatorClass(TwoOpFunc2, TWOOPFUNC2_LENGTH, OPERATOR_CLASS_TYPE7_FUNC);
+    AddOperatorClass(ThreeOpFunc1, THREEOPFUNC1_LENGTH, OPERATOR_CLASS_TYPE8_FUNC);
+    AddOperatorClass(OperatorsTwoOperandList, OPERATORS_TWO_OPERAND_LIST_LENGTH, OPERATOR_CLASS_TWO_OPERAND_OPERATOR);
+    AddOperatorClass(OperatorsOneOperandList, OPERATORS_ONE_OPERAND_LIST_LENGTH, OPERATOR_CLASS_ONE_OPERAND_OPERATOR);
+
+    return TRUE;
+}
+
+/**
+ * @brief Finds the value of a name in a name lookup table
+ * @details the tables are built once (by the first lookup)
+ *
+ * @param TableType
+ * @param Name
+ * @return unsigned long long INVALID if the name is not found
+ */
+unsigned long long
+LookupName(NAME_LOOKUP_TABLE_TYPE TableType, const char * Name)
+{
+    static INIT_ONCE   NameLookupTablesInitOnce = INIT_ONCE_STATIC_INIT;
+    PNAME_LOOKUP_ENTRY Entry;
+
+    InitOnceExecuteOnce(&NameLookupTablesInitOnce, InitializeNameLookupTables, NULL, NULL);
+
+    Entry = GetNameLookupEntry(NameLookupTables[TableType], Name, FALSE);
+
+    if (Entry == NULL)
+    {
+        return (unsigned long long)INVALID;
+    }
+
+    return Entry->Value;
+}
+
+/**
+ * @brief Gets the name of the terminal of a token
+ * @details the terminal of identifiers, numbers, registers and strings
+ * is their type, other tokens are keywords
+ *
+ * @param Token
+ * @return const char *
+ */
+static const char *
+GetTerminalName(PTOKEN Token)
+{
+    switch (Token->Type)
+    {
+    case HEX:
+        return "_hex";
+    case GLOBAL_ID:
+    case GLOBAL_UNRESOLVED_ID:
+        return "_global_id";
+    case LOCAL_ID:
+    case LOCAL_UNRESOLVED_ID:
+        return "_local_id";
+    case REGISTER:
+        return "_register";
+    case PSEUDO_REGISTER:
+        return "_pseudo_register";
+    case DECIMAL:
+        return "_decimal";
+    case BINARY:
+        return "_binary";
+    case OCTAL:
+        return "_octal";
+    case STRING:
+        return "_string";
+    default: // Keyword
+        return Token->Value;
+    }
+}
+
+/**
+ * @brief Gets the Non Terminal Id object
+ *
+ * @param Token
+ * @return int
+ */
+int
+GetNonTerminalId(PTOKEN Token)
+{
+    return (int)LookupName(NAME_LOOKUP_TABLE_NON_TERMINALS, Token->Value);
+}
+
+/**
+ * @brief Gets the Terminal Id object
+ *
+ * @param Token
+ * @return int
+ */
+int
+GetTerminalId(PTOKEN Token)
+{
+    return (int)LookupName(NAME_LOOKUP_TABLE_TERMINALS, GetTerminalName(Token));
 }
 
 /**
@@ -842,12 +1006,7 @@ GetTerminalId(PTOKEN Token)
 int
 LalrGetNonTerminalId(PTOKEN Token)
 {
-    for (int i = 0; i < LALR_NONTERMINAL_COUNT; i++)
-    {
-        if (!strcmp(Token->Value, LalrNoneTerminalMap[i]))
-            return i;
-    }
-    return INVALID;
+    return (int)LookupName(NAME_LOOKUP_TABLE_LALR_NON_TERMINALS, Token->Value);
 }
 
 /**
@@ -859,77 +1018,7 @@ LalrGetNonTerminalId(PTOKEN Token)
 int
 LalrGetTerminalId(PTOKEN Token)
 {
-    for (int i = 0; i < LALR_TERMINAL_COUNT; i++)
-    {
-        if (Token->Type == HEX)
-        {
-            if (!strcmp("_hex", LalrTerminalMap[i]))
-                return i;
-        }
-        else if (Token->Type == GLOBAL_ID || Token->Type == GLOBAL_UNRESOLVED_ID)
-        {
-            if (!strcmp("_global_id", LalrTerminalMap[i]))
-            {
-                return i;
-            }
-        }
-        else if (Token->Type == LOCAL_ID || Token->Type == LOCAL_UNRESOLVED_ID)
-        {
-            if (!strcmp("_local_id", LalrTerminalMap[i]))
-            {
-                return i;
-            }
-        }
-        else if (Token->Type == REGISTER)
-        {
-            if (!strcmp("_register", LalrTerminalMap[i]))
-            {
-                return i;
-            }
-        }
-        else if (Token->Type == PSEUDO_REGISTER)
-        {
-            if (!strcmp("_pseudo_register", LalrTerminalMap[i]))
-            {
-                return i;
-            }
-        }
-        else if (Token->Type == DECIMAL)
-        {
-            if (!strcmp("_decimal", LalrTerminalMap[i]))
-            {
-                return i;
-            }
-        }
-        else if (Token->Type == BINARY)
-        {
-            if (!strcmp("_binary", LalrTerminalMap[i]))
-            {
-                return i;
-            }
-        }
-        else if (Token->Type == OCTAL)
-        {
-            if (!strcmp("_octal", LalrTerminalMap[i]))
-            {
-                return i;
-            }
-        }
-        else if (Token->Type == STRING)
-        {
-            if (!strcmp("_string", LalrTerminalMap[i]))
-            {
-                return i;
-            }
-        }
-
-        else // Keyword
-        {
-            if (!strcmp(Token->Value, LalrTerminalMap[i]))
-                return i;
-        }
-    }
-    return INVALID;
+    return (int)LookupName(NAME_LOOKUP_TABLE_LALR_TERMINALS, GetTerminalName(Token));
 }
 
 /**
@@ -16,3 +16,33 @@
  *
  */
 char TempMap[MAX_TEMP_COUNT] = {0};
+
+/**
+ * @brief Format strings of printf (open addressing by the identifier)
+ *
+ */
+BINARY_TRACE_FORMAT BinaryTraceFormats[MAX_BINARY_TRACE_FORMATS_COUNT] = {0};
+
+/**
+ * @brief Lock of the format strings of printf
+ *
+ */
+SRWLOCK BinaryTraceFormatsLock = SRWLOCK_INIT;
+
+/**
+ * @brief Lookup tables of the names of terminals, keywords, registers, etc.
+ *
+ */
+NAME_LOOKUP_ENTRY NameLookupTables[NAME_LOOKUP_TABLE_COUNT][NAME_LOOKUP_TABLE_SIZE] = {0};
+
+/**
+ * @brief Removed tokens that are kept to be reused (with their buffers)
+ *
+ */
+PTOKEN TokenPool[TOKEN_POOL_MAX_COUNT] = {0};
+
+/**
+ * @brief Count of the tokens in the token pool
+ *
+ */
+unsigned int TokenPoolCount = 0;
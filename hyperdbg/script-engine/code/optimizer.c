@@ -0,0 +1,1348 @@
+/**
+ * @file optimizer.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ *
+ * @details Optimizer of the generated code, the code buffer that is
+ * generated by CodeGen is decoded into instructions, then constants are
+ * folded, copies (and constants) of temps are propagated, unreachable
+ * branches and dead temps are removed and the temps are re-allocated so
+ * the buffer needs fewer temps
+ *
+ * @version 0.4
+ * @date 2023-07-14
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+// #define _SCRIPT_ENGINE_OPTIMIZER_DBG_EN
+
+//////////////////////////////////////////////////
+//					Temp sets					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Check whether a symbol is a temp
+ *
+ * @param Symbol
+ * @return BOOLEAN
+ */
+static BOOLEAN
+OptimizerIsTemp(PSYMBOL Symbol)
+{
+    //
+    // The upper bits of the type of printf arguments hold the position
+    // of the argument in the format string
+    //
+    return (Symbol->Type & 0xffffffff) == SYMBOL_TEMP_TYPE;
+}
+
+/**
+ * @brief Check whether a temp is in the set
+ *
+ * @param Set
+ * @param Temp
+ * @return BOOLEAN
+ */
+static BOOLEAN
+OptimizerTempSetContains(UINT64 * Set, UINT64 Temp)
+{
+    return (Set[Temp / 64] & (1ull << (Temp % 64))) != 0;
+}
+
+/**
+ * @brief Add a temp to the set
+ *
+ * @param Set
+ * @param Temp
+ */
+static void
+OptimizerTempSetAdd(UINT64 * Set, UINT64 Temp)
+{
+    Set[Temp / 64] |= 1ull << (Temp % 64);
+}
+
+/**
+ * @brief Remove a temp from the set
+ *
+ * @param Set
+ * @param Temp
+ */
+static void
+OptimizerTempSetRemove(UINT64 * Set, UINT64 Temp)
+{
+    Set[Temp / 64] &= ~(1ull << (Temp % 64));
+}
+
+//////////////////////////////////////////////////
+//					Decoding					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Get the operands of an operator
+ *
+ * @param Operator
+ * @param SourcesCount
+ * @param HasDestination
+ * @return BOOLEAN FALSE if the operator is not supported by the optimizer
+ */
+static BOOLEAN
+OptimizerGetOperands(UINT64 Operator, UINT32 * SourcesCount, BOOLEAN * HasDestination)
+{
+    *SourcesCount   = 0;
+    *HasDestination = FALSE;
+
+    switch (Operator)
+    {
+    case FUNC_OR:
+    case FUNC_XOR:
+    case FUNC_AND:
+    case FUNC_ASR:
+    case FUNC_ASL:
+    case FUNC_ADD:
+    case FUNC_SUB:
+    case FUNC_MUL:
+    case FUNC_DIV:
+    case FUNC_MOD:
+    case FUNC_GT:
+    case FUNC_LT:
+    case FUNC_EGT:
+    case FUNC_ELT:
+    case FUNC_EQUAL:
+    case FUNC_NEQ:
+    case FUNC_ED:
+    case FUNC_EB:
+    case FUNC_EQ:
+    case FUNC_INTERLOCKED_EXCHANGE:
+    case FUNC_INTERLOCKED_EXCHANGE_ADD:
+    case FUNC_STRCMP:
+    case FUNC_WCSCMP:
+    case FUNC_STRICMP:
+        *SourcesCount   = 2;
+        *HasDestination = TRUE;
+        return TRUE;
+
+    case FUNC_INTERLOCKED_COMPARE_EXCHANGE:
+    case FUNC_AGG_SUM:
+    case FUNC_AGG_MIN:
+    case FUNC_AGG_MAX:
+    case FUNC_MEMCPY:
+    case FUNC_MEMCMP:
+    case FUNC_MEMSET:
+    case FUNC_MEMSEARCH:
+    case FUNC_EVENT_ADD_RANGE:
+    case FUNC_EVENT_REMOVE_RANGE:
+        *SourcesCount   = 3;
+        *HasDestination = TRUE;
+        return TRUE;
+
+    case FUNC_SPINLOCK_LOCK_CUSTOM_WAIT:
+    case FUNC_AGG_COUNT:
+    case FUNC_AGG_HIST:
+        *SourcesCount = 2;
+        return TRUE;
+
+    case FUNC_MOV:
+    case FUNC_NOT:
+    case FUNC_NEG:
+    case FUNC_REFERENCE:
+    case FUNC_POI:
+    case FUNC_DB:
+    case FUNC_DD:
+    case FUNC_DW:
+    case FUNC_DQ:
+    case FUNC_HI:
+    case FUNC_LOW:
+    case FUNC_INTERLOCKED_INCREMENT:
+    case FUNC_INTERLOCKED_DECREMENT:
+    case FUNC_PERCPU_SUM:
+    case FUNC_PERCPU_MIN:
+    case FUNC_PERCPU_MAX:
+    case FUNC_PHYSICAL_TO_VIRTUAL:
+    case FUNC_VIRTUAL_TO_PHYSICAL:
+    case FUNC_CHECK_ADDRESS:
+    case FUNC_SCRATCH:
+    case FUNC_STRLEN:
+    case FUNC_WCSLEN:
+    case FUNC_DISASSEMBLE_LEN:
+    case FUNC_DISASSEMBLE_LEN32:
+        *SourcesCount   = 1;
+        *HasDestination = TRUE;
+        return TRUE;
+
+    case FUNC_INC:
+    case FUNC_DEC:
+    case FUNC_PRINT:
+    case FUNC_TEST_STATEMENT:
+    case FUNC_SPINLOCK_LOCK:
+    case FUNC_SPINLOCK_UNLOCK:
+    case FUNC_EVENT_ENABLE:
+    case FUNC_EVENT_DISABLE:
+    case FUNC_FORMATS:
+    case FUNC_AGG_PRINT:
+    case FUNC_AGG_CLEAR:
+    case FUNC_STACK:
+        *SourcesCount = 1;
+        return TRUE;
+
+    case FUNC_PAUSE:
+    case FUNC_FLUSH:
+        return TRUE;
+
+    default:
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Check whether the instruction only computes its destination
+ * @details these instructions don't access memory and don't have
+ * side effects, so they can be removed if their result is not used
+ *
+ * @param Operator
+ * @return BOOLEAN
+ */
+static BOOLEAN
+OptimizerIsPure(UINT64 Operator)
+{
+    switch (Operator)
+    {
+    case FUNC_OR:
+    case FUNC_XOR:
+    case FUNC_AND:
+    case FUNC_ASR:
+    case FUNC_ASL:
+    case FUNC_ADD:
+    case FUNC_SUB:
+    case FUNC_MUL:
+    case FUNC_DIV:
+    case FUNC_MOD:
+    case FUNC_GT:
+    case FUNC_LT:
+    case FUNC_EGT:
+    case FUNC_ELT:
+    case FUNC_EQUAL:
+    case FUNC_NEQ:
+    case FUNC_MOV:
+    case FUNC_NOT:
+    case FUNC_NEG:
+    case FUNC_REFERENCE:
+    case FUNC_INC:
+    case FUNC_DEC:
+    case FUNC_JMP:
+    case FUNC_JZ:
+    case FUNC_JNZ:
+        return TRUE;
+
+    default:
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Decode the code buffer into instructions
+ *
+ * @param State
+ * @return BOOLEAN FALSE if the buffer can't be optimized
+ */
+static BOOLEAN
+OptimizerDecode(POPTIMIZER_STATE State)
+{
+    PSYMBOL                Symbols = State->Symbols;
+    UINT32                 Count   = State->SymbolsCount;
+    POPTIMIZER_INSTRUCTION Instruction;
+    UINT32 *               SymbolToInstruction;
+    UINT32                 SourcesCount;
+    BOOLEAN                HasDestination;
+    UINT32                 i = 0;
+
+    while (i < Count)
+    {
+        Instruction = &State->Instructions[State->InstructionsCount];
+        memset(Instruction, 0, sizeof(OPTIMIZER_INSTRUCTION));
+
+        if (Symbols[i].Type != SYMBOL_SEMANTIC_RULE_TYPE)
+        {
+            return FALSE;
+        }
+
+        Instruction->Start       = i;
+        Instruction->Operator    = Symbols[i].Value;
+        Instruction->ReadsStart  = i + 1;
+        Instruction->Destination = OPTIMIZER_NO_OPERAND;
+        Instruction->Target      = OPTIMIZER_NO_OPERAND;
+
+        switch (Instruction->Operator)
+        {
+        case FUNC_JMP:
+        case FUNC_JZ:
+        case FUNC_JNZ:
+
+            Instruction->Length     = Instruction->Operator == FUNC_JMP ? 2 : 3;
+            Instruction->ReadsStart = i + 2;
+            Instruction->ReadsCount = Instruction->Length - 2;
+
+            if (i + Instruction->Length > Count || Symbols[i + 1].Type != SYMBOL_NUM_TYPE ||
+                Symbols[i + 1].Value > Count)
+            {
+                return FALSE;
+            }
+
+            //
+            // The target is converted to an instruction after decoding
+            //
+            Instruction->Target = (UINT32)Symbols[i + 1].Value;
+            break;
+
+        case FUNC_EVENT_SC:
+
+            Instruction->Length     = 3;
+            Instruction->ReadsCount = 2;
+            break;
+
+        case FUNC_PRINTF:
+
+            //
+            // Format string, count of arguments and then the arguments
+            //
+            if (i + 2 >= Count || Symbols[i + 1].Type != SYMBOL_STRING_TYPE)
+            {
+                return FALSE;
+            }
+
+            Instruction->ReadsStart = i + 1 + GetStringSymbolSize(&Symbols[i + 1]);
+
+            if (Instruction->ReadsStart >= Count ||
+                Symbols[Instruction->ReadsStart].Type != SYMBOL_VARIABLE_COUNT_TYPE ||
+                Symbols[Instruction->ReadsStart].Value > Count - Instruction->ReadsStart - 1)
+            {
+                return FALSE;
+            }
+
+            Instruction->ReadsCount = (UINT32)Symbols[Instruction->ReadsStart].Value;
+            Instruction->ReadsStart++;
+            Instruction->Length = Instruction->ReadsStart + Instruction->ReadsCount - i;
+            break;
+
+        default:
+
+            if (!OptimizerGetOperands(Instruction->Operator, &SourcesCount, &HasDestination))
+            {
+                return FALSE;
+            }
+
+            Instruction->Length         = 1 + SourcesCount + (HasDestination ? 1 : 0);
+            Instruction->ReadsCount     = SourcesCount;
+            Instruction->ModifiesSource = Instruction->Operator == FUNC_INC || Instruction->Operator == FUNC_DEC;
+
+            if (HasDestination)
+            {
+                Instruction->Destination = i + 1 + SourcesCount;
+            }
+
+            break;
+        }
+
+        if (i + Instruction->Length > Count)
+        {
+            return FALSE;
+        }
+
+        //
+        // Check the operands (string and semantic rules are not operands)
+        //
+        for (UINT32 j = i + 1; j < i + Instruction->Length; j++)
+        {
+            if ((j >= Instruction->ReadsStart && j < Instruction->ReadsStart + Instruction->ReadsCount) ||
+                j == Instruction->Destination)
+            {
+                if (OptimizerIsTemp(&Symbols[j]) && Symbols[j].Value >= MAX_TEMP_COUNT)
+                {
+                    return FALSE;
+                }
+
+                if ((Symbols[j].Type & 0xffffffff) == SYMBOL_SEMANTIC_RULE_TYPE ||
+                    (Symbols[j].Type & 0xffffffff) == SYMBOL_STRING_TYPE)
+                {
+                    return FALSE;
+                }
+            }
+        }
+
+        //
+        // A reference to a temp means the temp might be modified through memory
+        //
+        if (Instruction->Operator == FUNC_REFERENCE && OptimizerIsTemp(&Symbols[i + 1]))
+        {
+            State->CanOptimizeTemps = FALSE;
+        }
+
+        State->InstructionsCount++;
+        i += Instruction->Length;
+    }
+
+    //
+    // Convert the targets of jumps from symbols to instructions
+    //
+    SymbolToInstruction = (UINT32 *)malloc((Count + 1) * sizeof(UINT32));
+
+    if (SymbolToInstruction == NULL)
+    {
+        return FALSE;
+    }
+
+    for (i = 0; i <= Count; i++)
+    {
+        SymbolToInstruction[i] = OPTIMIZER_NO_OPERAND;
+    }
+
+    for (i = 0; i < State->InstructionsCount; i++)
+    {
+        SymbolToInstruction[State->Instructions[i].Start] = i;
+    }
+
+    SymbolToInstruction[Count] = State->InstructionsCount;
+
+    for (i = 0; i < State->InstructionsCount; i++)
+    {
+        Instruction = &State->Instructions[i];
+
+        if (Instruction->Target == OPTIMIZER_NO_OPERAND)
+        {
+            continue;
+        }
+
+        if (SymbolToInstruction[Instruction->Target] == OPTIMIZER_NO_OPERAND)
+        {
+            //
+            // Jumping to the middle of an instruction
+            //
+            free(SymbolToInstruction);
+            return FALSE;
+        }
+
+        Instruction->Target = SymbolToInstruction[Instruction->Target];
+    }
+
+    free(SymbolToInstruction);
+
+    return TRUE;
+}
+
+//////////////////////////////////////////////////
+//					Control flow				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Get the first instruction that is not removed
+ *
+ * @param State
+ * @param Index
+ * @return UINT32 The instruction or InstructionsCount for the end of the code
+ */
+static UINT32
+OptimizerNextInstruction(POPTIMIZER_STATE State, UINT32 Index)
+{
+    while (Index < State->InstructionsCount && State->Instructions[Index].Removed)
+    {
+        Index++;
+    }
+
+    return Index;
+}
+
+/**
+ * @brief Check whether the instruction is a jump
+ *
+ * @param Instruction
+ * @return BOOLEAN
+ */
+static BOOLEAN
+OptimizerIsJump(POPTIMIZER_INSTRUCTION Instruction)
+{
+    return Instruction->Operator == FUNC_JMP || Instruction->Operator == FUNC_JZ ||
+           Instruction->Operator == FUNC_JNZ;
+}
+
+/**
+ * @brief Mark the instructions that start basic blocks
+ *
+ * @param State
+ */
+static void
+OptimizerMarkLeaders(POPTIMIZER_STATE State)
+{
+    POPTIMIZER_INSTRUCTION Instruction;
+    UINT32                 Index;
+
+    for (UINT32 i = 0; i < State->InstructionsCount; i++)
+    {
+        State->Instructions[i].Leader = FALSE;
+    }
+
+    Index = OptimizerNextInstruction(State, 0);
+
+    if (Index < State->InstructionsCount)
+    {
+        State->Instructions[Index].Leader = TRUE;
+    }
+
+    for (UINT32 i = 0; i < State->InstructionsCount; i++)
+    {
+        Instruction = &State->Instructions[i];
+
+        if (Instruction->Removed || !OptimizerIsJump(Instruction))
+        {
+            continue;
+        }
+
+        Index = OptimizerNextInstruction(State, Instruction->Target);
+
+        if (Index < State->InstructionsCount)
+        {
+            State->Instructions[Index].Leader = TRUE;
+        }
+
+        Index = OptimizerNextInstruction(State, i + 1);
+
+        if (Index < State->InstructionsCount)
+        {
+            State->Instructions[Index].Leader = TRUE;
+        }
+    }
+}
+
+/**
+ * @brief Remove jumps to the next instruction and the unreachable instructions
+ *
+ * @param State
+ * @return BOOLEAN TRUE if the code is changed
+ */
+static BOOLEAN
+OptimizerSimplifyControlFlow(POPTIMIZER_STATE State)
+{
+    POPTIMIZER_INSTRUCTION Instruction;
+    BOOLEAN *              Reachable;
+    UINT32 *               WorkList;
+    UINT32                 WorkListCount = 0;
+    UINT32                 Index;
+    BOOLEAN                Changed = FALSE;
+
+    //
+    // Jumps to the next instruction (reading the condition of jz and jnz
+    // doesn't have side effects)
+    //
+    for (UINT32 i = 0; i < State->InstructionsCount; i++)
+    {
+        Instruction = &State->Instructions[i];
+
+        if (Instruction->Removed || !OptimizerIsJump(Instruction))
+        {
+            continue;
+        }
+
+        if (OptimizerNextInstruction(State, Instruction->Target) == OptimizerNextInstruction(State, i + 1))
+        {
+            Instruction->Removed = TRUE;
+            Changed              = TRUE;
+        }
+    }
+
+    //
+    // Find the reachable instructions from the entry
+    //
+    Reachable = (BOOLEAN *)calloc(State->InstructionsCount + 1, sizeof(BOOLEAN));
+    WorkList  = (UINT32 *)malloc((State->InstructionsCount + 1) * sizeof(UINT32));
+
+    if (Reachable == NULL || WorkList == NULL)
+    {
+        free(Reachable);
+        free(WorkList);
+        return Changed;
+    }
+
+    WorkList[WorkListCount++] = OptimizerNextInstruction(State, 0);
+
+    while (WorkListCount != 0)
+    {
+        Index = WorkList[--WorkListCount];
+
+        if (Index >= State->InstructionsCount || Reachable[Index])
+        {
+            continue;
+        }
+
+        Reachable[Index] = TRUE;
+        Instruction      = &State->Instructions[Index];
+
+        if (OptimizerIsJump(Instruction))
+        {
+            WorkList[WorkListCount++] = OptimizerNextInstruction(State, Instruction->Target);
+        }
+
+        if (Instruction->Operator != FUNC_JMP)
+        {
+            WorkList[WorkListCount++] = OptimizerNextInstruction(State, Index + 1);
+        }
+    }
+
+    for (UINT32 i = 0; i < State->InstructionsCount; i++)
+    {
+        if (!State->Instructions[i].Removed && !Reachable[i])
+        {
+            State->Instructions[i].Removed = TRUE;
+            Changed                        = TRUE;
+        }
+    }
+
+    free(Reachable);
+    free(WorkList);
+
+    return Changed;
+}
+
+//////////////////////////////////////////////////
+//			    Constants and copies		    //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Compute the result of an operator on constants
+ * @details the semantics are the same as ScriptEngineExecute
+ *
+ * @param Operator
+ * @param SrcVal0
+ * @param SrcVal1
+ * @param Result
+ * @return BOOLEAN FALSE if the operator can't be folded
+ */
+static BOOLEAN
+OptimizerFold(UINT64 Operator, UINT64 SrcVal0, UINT64 SrcVal1, UINT64 * Result)
+{
+    switch (Operator)
+    {
+    case FUNC_OR:
+        *Result = SrcVal1 | SrcVal0;
+        return TRUE;
+    case FUNC_XOR:
+        *Result = SrcVal1 ^ SrcVal0;
+        return TRUE;
+    case FUNC_AND:
+        *Result = SrcVal1 & SrcVal0;
+        return TRUE;
+    case FUNC_ASR:
+    case FUNC_ASL:
+
+        //
+        // Shifting more than the width is left for the target processor
+        //
+        if (SrcVal0 >= 64)
+        {
+            return FALSE;
+        }
+
+        *Result = Operator == FUNC_ASR ? SrcVal1 >> SrcVal0 : SrcVal1 << SrcVal0;
+        return TRUE;
+
+    case FUNC_ADD:
+        *Result = SrcVal1 + SrcVal0;
+        return TRUE;
+    case FUNC_SUB:
+        *Result = SrcVal1 - SrcVal0;
+        return TRUE;
+    case FUNC_MUL:
+        *Result = SrcVal1 * SrcVal0;
+        return TRUE;
+    case FUNC_DIV:
+    case FUNC_MOD:
+
+        //
+        // Dividing by zero is an error in the runtime
+        //
+        if (SrcVal0 == 0)
+        {
+            return FALSE;
+        }
+
+        *Result = Operator == FUNC_DIV ? SrcVal1 / SrcVal0 : SrcVal1 % SrcVal0;
+        return TRUE;
+
+    case FUNC_GT:
+        *Result = SrcVal1 > SrcVal0;
+        return TRUE;
+    case FUNC_LT:
+        *Result = SrcVal1 < SrcVal0;
+        return TRUE;
+    case FUNC_EGT:
+        *Result = SrcVal1 >= SrcVal0;
+        return TRUE;
+    case FUNC_ELT:
+        *Result = SrcVal1 <= SrcVal0;
+        return TRUE;
+    case FUNC_EQUAL:
+        *Result = SrcVal1 == SrcVal0;
+        return TRUE;
+    case FUNC_NEQ:
+        *Result = SrcVal1 != SrcVal0;
+        return TRUE;
+    case FUNC_NOT:
+        *Result = ~SrcVal0;
+        return TRUE;
+    case FUNC_NEG:
+        *Result = (UINT64)(-(INT64)SrcVal0);
+        return TRUE;
+
+    default:
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Forget the copies that are changed by writing to a symbol
+ *
+ * @param KnownValid
+ * @param KnownValue
+ * @param Written
+ */
+static void
+OptimizerKillCopies(BOOLEAN * KnownValid, PSYMBOL KnownValue, PSYMBOL Written)
+{
+    if (OptimizerIsTemp(Written))
+    {
+        KnownValid[Written->Value] = FALSE;
+    }
+
+    for (UINT32 i = 0; i < MAX_TEMP_COUNT; i++)
+    {
+        if (!KnownValid[i] || KnownValue[i].Type != Written->Type)
+        {
+            continue;
+        }
+
+        //
+        // Registers overlap (e.g., al and rax), so writing to any of
+        // them changes the other ones
+        //
+        if (KnownValue[i].Value == Written->Value || Written->Type == SYMBOL_REGISTER_TYPE)
+        {
+            KnownValid[i] = FALSE;
+        }
+    }
+}
+
+/**
+ * @brief Propagate constants and copies of temps and fold constants
+ * @details the propagation is done inside the basic blocks
+ *
+ * @param State
+ * @return BOOLEAN TRUE if the code is changed
+ */
+static BOOLEAN
+OptimizerPropagate(POPTIMIZER_STATE State)
+{
+    POPTIMIZER_INSTRUCTION Instruction;
+    PSYMBOL                Symbols = State->Symbols;
+    BOOLEAN                KnownValid[MAX_TEMP_COUNT];
+    SYMBOL                 KnownValue[MAX_TEMP_COUNT];
+    SYMBOL                 Destination;
+    PSYMBOL                Source;
+    UINT64                 Result;
+    BOOLEAN                CanFold;
+    BOOLEAN                Changed = FALSE;
+
+    memset(KnownValid, 0, sizeof(KnownValid));
+    memset(KnownValue, 0, sizeof(KnownValue));
+
+    OptimizerMarkLeaders(State);
+
+    for (UINT32 i = 0; i < State->InstructionsCount; i++)
+    {
+        Instruction = &State->Instructions[i];
+
+        if (Instruction->Removed)
+        {
+            continue;
+        }
+
+        if (Instruction->Leader)
+        {
+            memset(KnownValid, 0, sizeof(KnownValid));
+        }
+
+        //
+        // Replace the temps that are read with their known values, the
+        // address of the operand of reference and the operand of inc and
+        // dec should not be changed, the arguments of printf and event_sc
+        // are also kept as they are
+        //
+        if (State->CanOptimizeTemps &&
+            Instruction->Operator != FUNC_REFERENCE &&
+            Instruction->Operator != FUNC_PRINTF &&
+            Instruction->Operator != FUNC_EVENT_SC &&
+            !Instruction->ModifiesSource)
+        {
+            for (UINT32 j = Instruction->ReadsStart; j < Instruction->ReadsStart + Instruction->ReadsCount; j++)
+            {
+                if (OptimizerIsTemp(&Symbols[j]) && KnownValid[Symbols[j].Value])
+                {
+                    Symbols[j] = KnownValue[Symbols[j].Value];
+                    Changed    = TRUE;
+                }
+            }
+        }
+
+        //
+        // Fold the operators that their sources are constants
+        //
+        CanFold = Instruction->Destination != OPTIMIZER_NO_OPERAND &&
+                  Instruction->Operator != FUNC_MOV &&
+                  (Instruction->ReadsCount == 1 || Instruction->ReadsCount == 2);
+
+        for (UINT32 j = Instruction->ReadsStart; CanFold && j < Instruction->ReadsStart + Instruction->ReadsCount; j++)
+        {
+            CanFold = Symbols[j].Type == SYMBOL_NUM_TYPE;
+        }
+
+        if (CanFold &&
+            OptimizerFold(Instruction->Operator,
+                          Symbols[Instruction->ReadsStart].Value,
+                          Instruction->ReadsCount == 2 ? Symbols[Instruction->ReadsStart + 1].Value : 0,
+                          &Result))
+        {
+            Destination = Symbols[Instruction->Destination];
+
+            Symbols[Instruction->Start].Value     = FUNC_MOV;
+            Symbols[Instruction->Start + 1].Type  = SYMBOL_NUM_TYPE;
+            Symbols[Instruction->Start + 1].Value = Result;
+            Symbols[Instruction->Start + 2]       = Destination;
+
+            Instruction->Operator    = FUNC_MOV;
+            Instruction->Length      = 3;
+            Instruction->ReadsCount  = 1;
+            Instruction->Destination = Instruction->Start + 2;
+            Changed                  = TRUE;
+        }
+
+        //
+        // Conditional jumps on constants
+        //
+        if ((Instruction->Operator == FUNC_JZ || Instruction->Operator == FUNC_JNZ) &&
+            Symbols[Instruction->ReadsStart].Type == SYMBOL_NUM_TYPE)
+        {
+            if ((Instruction->Operator == FUNC_JZ) == (Symbols[Instruction->ReadsStart].Value == 0))
+            {
+                Symbols[Instruction->Start].Value = FUNC_JMP;
+
+                Instruction->Operator   = FUNC_JMP;
+                Instruction->Length     = 2;
+                Instruction->ReadsCount = 0;
+            }
+            else
+            {
+                Instruction->Removed = TRUE;
+            }
+
+            Changed = TRUE;
+            continue;
+        }
+
+        //
+        // Update the known values, other instructions might modify variables
+        // and registers
+        //
+        if (!OptimizerIsPure(Instruction->Operator))
+        {
+            for (UINT32 j = 0; j < MAX_TEMP_COUNT; j++)
+            {
+                if (KnownValue[j].Type != SYMBOL_NUM_TYPE)
+                {
+                    KnownValid[j] = FALSE;
+                }
+            }
+        }
+
+        if (Instruction->ModifiesSource)
+        {
+            OptimizerKillCopies(KnownValid, KnownValue, &Symbols[Instruction->ReadsStart]);
+        }
+
+        if (Instruction->Destination == OPTIMIZER_NO_OPERAND)
+        {
+            continue;
+        }
+
+        OptimizerKillCopies(KnownValid, KnownValue, &Symbols[Instruction->Destination]);
+
+        Source = &Symbols[Instruction->ReadsStart];
+
+        if (Instruction->Operator == FUNC_MOV && OptimizerIsTemp(&Symbols[Instruction->Destination]) &&
+            (Source->Type == SYMBOL_NUM_TYPE || Source->Type == SYMBOL_TEMP_TYPE ||
+             Source->Type == SYMBOL_GLOBAL_ID_TYPE || Source->Type == SYMBOL_LOCAL_ID_TYPE ||
+             Source->Type == SYMBOL_REGISTER_TYPE) &&
+            !(Source->Type == SYMBOL_TEMP_TYPE && Source->Value == Symbols[Instruction->Destination].Value))
+        {
+            KnownValid[Symbols[Instruction->Destination].Value] = TRUE;
+            KnownValue[Symbols[Instruction->Destination].Value] = *Source;
+        }
+    }
+
+    return Changed;
+}
+
+//////////////////////////////////////////////////
+//					Liveness					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Compute the temps that are live before and after each instruction
+ *
+ * @param State
+ * @return BOOLEAN FALSE if a temp is read before being written
+ */
+static BOOLEAN
+OptimizerComputeLiveness(POPTIMIZER_STATE State)
+{
+    POPTIMIZER_INSTRUCTION Instruction;
+    POPTIMIZER_INSTRUCTION Successor;
+    PSYMBOL                Symbols = State->Symbols;
+    UINT64                 LiveIn[OPTIMIZER_TEMP_SET_SIZE];
+    UINT32                 Index;
+    BOOLEAN                Changed = TRUE;
+
+    for (UINT32 i = 0; i < State->InstructionsCount; i++)
+    {
+        memset(State->Instructions[i].LiveIn, 0, sizeof(State->Instructions[i].LiveIn));
+        memset(State->Instructions[i].LiveOut, 0, sizeof(State->Instructions[i].LiveOut));
+    }
+
+    while (Changed)
+    {
+        Changed = FALSE;
+
+        for (UINT32 i = State->InstructionsCount; i-- > 0;)
+        {
+            Instruction = &State->Instructions[i];
+
+            if (Instruction->Removed)
+            {
+                continue;
+            }
+
+            //
+            // Live temps after the instruction are the live temps of its successors
+            //
+            if (Instruction->Operator != FUNC_JMP)
+            {
+                Index = OptimizerNextInstruction(State, i + 1);
+
+                if (Index < State->InstructionsCount)
+                {
+                    Successor = &State->Instructions[Index];
+
+                    for (UINT32 j = 0; j < OPTIMIZER_TEMP_SET_SIZE; j++)
+                    {
+                        Instruction->LiveOut[j] |= Successor->LiveIn[j];
+                    }
+                }
+            }
+
+            if (OptimizerIsJump(Instruction))
+            {
+                Index = OptimizerNextInstruction(State, Instruction->Target);
+
+                if (Index < State->InstructionsCount)
+                {
+                    Successor = &State->Instructions[Index];
+
+                    for (UINT32 j = 0; j < OPTIMIZER_TEMP_SET_SIZE; j++)
+                    {
+                        Instruction->LiveOut[j] |= Successor->LiveIn[j];
+                    }
+                }
+            }
+
+            //
+            // Live temps before the instruction
+            //
+            memcpy(LiveIn, Instruction->LiveOut, sizeof(LiveIn));
+
+            if (Instruction->Destination != OPTIMIZER_NO_OPERAND && OptimizerIsTemp(&Symbols[Instruction->Destination]))
+            {
+                OptimizerTempSetRemove(LiveIn, Symbols[Instruction->Destination].Value);
+            }
+
+            for (UINT32 j = Instruction->ReadsStart; j < Instruction->ReadsStart + Instruction->ReadsCount; j++)
+            {
+                if (OptimizerIsTemp(&Symbols[j]))
+                {
+                    OptimizerTempSetAdd(LiveIn, Symbols[j].Value);
+                }
+            }
+
+            if (memcmp(LiveIn, Instruction->LiveIn, sizeof(LiveIn)) != 0)
+            {
+                memcpy(Instruction->LiveIn, LiveIn, sizeof(LiveIn));
+                Changed = TRUE;
+            }
+        }
+    }
+
+    //
+    // Check the temps that are used without being initialized
+    //
+    Index = OptimizerNextInstruction(State, 0);
+
+    if (Index < State->InstructionsCount)
+    {
+        for (UINT32 j = 0; j < OPTIMIZER_TEMP_SET_SIZE; j++)
+        {
+            if (State->Instructions[Index].LiveIn[j] != 0)
+            {
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Remove the instructions that their results are not used
+ * @details if the result of an instruction is moved to another operand
+ * by the next instruction, the instruction directly writes to it
+ *
+ * @param State
+ * @return BOOLEAN TRUE if the code is changed
+ */
+static BOOLEAN
+OptimizerEliminateDeadCode(POPTIMIZER_STATE State)
+{
+    POPTIMIZER_INSTRUCTION Instruction;
+    POPTIMIZER_INSTRUCTION Next;
+    PSYMBOL                Symbols = State->Symbols;
+    PSYMBOL                Destination;
+    UINT32                 Index;
+    BOOLEAN                Changed = FALSE;
+
+    OptimizerMarkLeaders(State);
+
+    for (UINT32 i = 0; i < State->InstructionsCount; i++)
+    {
+        Instruction = &State->Instructions[i];
+
+        if (Instruction->Removed || Instruction->Destination == OPTIMIZER_NO_OPERAND)
+        {
+            continue;
+        }
+
+        Destination = &Symbols[Instruction->Destination];
+
+        if (!OptimizerIsTemp(Destination))
+        {
+            continue;
+        }
+
+        //
+        // The result is not used (division might be an error)
+        //
+        if (!OptimizerTempSetContains(Instruction->LiveOut, Destination->Value) &&
+            OptimizerIsPure(Instruction->Operator) &&
+            ((Instruction->Operator != FUNC_DIV && Instruction->Operator != FUNC_MOD) ||
+             (Symbols[Instruction->ReadsStart].Type == SYMBOL_NUM_TYPE && Symbols[Instruction->ReadsStart].Value != 0)))
+        {
+            Instruction->Removed = TRUE;
+            Changed              = TRUE;
+            continue;
+        }
+
+        //
+        // The result is only moved to another operand
+        //
+        Index = OptimizerNextInstruction(State, i + 1);
+
+        if (Index >= State->InstructionsCount)
+        {
+            continue;
+        }
+
+        Next = &State->Instructions[Index];
+
+        if (Next->Leader || Next->Operator != FUNC_MOV ||
+            !OptimizerIsTemp(&Symbols[Next->ReadsStart]) ||
+            Symbols[Next->ReadsStart].Value != Destination->Value ||
+            OptimizerTempSetContains(Next->LiveOut, Destination->Value))
+        {
+            continue;
+        }
+
+        *Destination  = Symbols[Next->Destination];
+        Next->Removed = TRUE;
+        Changed       = TRUE;
+    }
+
+    return Changed;
+}
+
+//////////////////////////////////////////////////
+//					Temps						//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Re-allocate temps so temps that are not live at the same
+ * time share the same temp
+ * @details should be called after computing the liveness
+ *
+ * @param State
+ */
+static void
+OptimizerReallocateTemps(POPTIMIZER_STATE State)
+{
+    POPTIMIZER_INSTRUCTION Instruction;
+    PSYMBOL                Symbols = State->Symbols;
+    UINT64 *               Interference;
+    UINT64                 Used[OPTIMIZER_TEMP_SET_SIZE] = {0};
+    UINT64                 Colors[OPTIMIZER_TEMP_SET_SIZE];
+    UINT32                 Map[MAX_TEMP_COUNT];
+    UINT64                 Defined;
+    UINT32                 Color;
+
+    Interference = (UINT64 *)calloc(MAX_TEMP_COUNT * OPTIMIZER_TEMP_SET_SIZE, sizeof(UINT64));
+
+    if (Interference == NULL)
+    {
+        return;
+    }
+
+    //
+    // A temp that is written interferes with the temps that are live after it
+    //
+    for (UINT32 i = 0; i < State->InstructionsCount; i++)
+    {
+        Instruction = &State->Instructions[i];
+
+        if (Instruction->Removed)
+        {
+            continue;
+        }
+
+        for (UINT32 j = Instruction->Start + 1; j < Instruction->Start + Instruction->Length; j++)
+        {
+            if (((j >= Instruction->ReadsStart && j < Instruction->ReadsStart + Instruction->ReadsCount) ||
+                 j == Instruction->Destination) &&
+                OptimizerIsTemp(&Symbols[j]))
+            {
+                OptimizerTempSetAdd(Used, Symbols[j].Value);
+            }
+        }
+
+        if (Instruction->Destination == OPTIMIZER_NO_OPERAND || !OptimizerIsTemp(&Symbols[Instruction->Destination]))
+        {
+            continue;
+        }
+
+        Defined = Symbols[Instruction->Destination].Value;
+
+        for (UINT32 t = 0; t < MAX_TEMP_COUNT; t++)
+        {
+            if (t != Defined && OptimizerTempSetContains(Instruction->LiveOut, t))
+            {
+                OptimizerTempSetAdd(&Interference[Defined * OPTIMIZER_TEMP_SET_SIZE], t);
+                OptimizerTempSetAdd(&Interference[t * OPTIMIZER_TEMP_SET_SIZE], Defined);
+            }
+        }
+    }
+
+    //
+    // Give each temp the first temp that is not used by the interfering temps
+    //
+    for (UINT32 t = 0; t < MAX_TEMP_COUNT; t++)
+    {
+        if (!OptimizerTempSetContains(Used, t))
+        {
+            continue;
+        }
+
+        memset(Colors, 0, sizeof(Colors));
+
+        for (UINT32 u = 0; u < t; u++)
+        {
+            if (OptimizerTempSetContains(Used, u) && OptimizerTempSetContains(&Interference[t * OPTIMIZER_TEMP_SET_SIZE], u))
+            {
+                OptimizerTempSetAdd(Colors, Map[u]);
+            }
+        }
+
+        for (Color = 0; OptimizerTempSetContains(Colors, Color); Color++)
+            ;
+
+        Map[t] = Color;
+    }
+
+    free(Interference);
+
+    //
+    // Rename the temps
+    //
+    for (UINT32 i = 0; i < State->InstructionsCount; i++)
+    {
+        Instruction = &State->Instructions[i];
+
+        if (Instruction->Removed)
+        {
+            continue;
+        }
+
+        for (UINT32 j = Instruction->Start + 1; j < Instruction->Start + Instruction->Length; j++)
+        {
+            if (((j >= Instruction->ReadsStart && j < Instruction->ReadsStart + Instruction->ReadsCount) ||
+                 j == Instruction->Destination) &&
+                OptimizerIsTemp(&Symbols[j]))
+            {
+                Symbols[j].Value = Map[Symbols[j].Value];
+            }
+        }
+    }
+}
+
+//////////////////////////////////////////////////
+//					Emitting					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Write the optimized instructions to the code buffer
+ *
+ * @param State
+ * @param CodeBuffer
+ * @return BOOLEAN
+ */
+static BOOLEAN
+OptimizerEmit(POPTIMIZER_STATE State, PSYMBOL_BUFFER CodeBuffer)
+{
+    POPTIMIZER_INSTRUCTION Instruction;
+    UINT32 *               NewStart;
+    PSYMBOL                NewHead;
+    UINT32                 Pointer = 0;
+
+    NewStart = (UINT32 *)malloc((State->InstructionsCount + 1) * sizeof(UINT32));
+    NewHead  = (PSYMBOL)malloc(CodeBuffer->Size * sizeof(SYMBOL));
+
+    if (NewStart == NULL || NewHead == NULL)
+    {
+        free(NewStart);
+        free(NewHead);
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < State->InstructionsCount; i++)
+    {
+        NewStart[i] = Pointer;
+
+        if (!State->Instructions[i].Removed)
+        {
+            Pointer += State->Instructions[i].Length;
+        }
+    }
+
+    //
+    // Removed instructions are replaced by the next instruction
+    //
+    NewStart[State->InstructionsCount] = Pointer;
+
+    for (UINT32 i = 0; i < State->InstructionsCount; i++)
+    {
+        Instruction = &State->Instructions[i];
+
+        if (Instruction->Removed)
+        {
+            continue;
+        }
+
+        memcpy(&NewHead[NewStart[i]], &State->Symbols[Instruction->Start], Instruction->Length * sizeof(SYMBOL));
+
+        if (OptimizerIsJump(Instruction))
+        {
+            NewHead[NewStart[i] + 1].Value = NewStart[Instruction->Target];
+        }
+    }
+
+    free(NewStart);
+    free(CodeBuffer->Head);
+
+    CodeBuffer->Head    = NewHead;
+    CodeBuffer->Pointer = Pointer;
+
+    return TRUE;
+}
+
+/**
+ * @brief Optimize the generated code
+ * @details if the code can't be optimized, it remains unchanged
+ *
+ * @param CodeBuffer
+ */
+void
+ScriptEngineOptimize(PSYMBOL_BUFFER CodeBuffer)
+{
+    OPTIMIZER_STATE State        = {0};
+    UINT32          OriginalSize = CodeBuffer->Pointer;
+    BOOLEAN         Changed      = TRUE;
+    UINT32          PassesCount  = 0;
+
+    if (CodeBuffer->Pointer == 0)
+    {
+        return;
+    }
+
+    State.SymbolsCount     = CodeBuffer->Pointer;
+    State.CanOptimizeTemps = TRUE;
+    State.Symbols          = (PSYMBOL)malloc(CodeBuffer->Pointer * sizeof(SYMBOL));
+
+    //
+    // Each instruction has at least one symbol
+    //
+    State.Instructions = (POPTIMIZER_INSTRUCTION)malloc(CodeBuffer->Pointer * sizeof(OPTIMIZER_INSTRUCTION));
+
+    if (State.Symbols == NULL || State.Instructions == NULL)
+    {
+        free(State.Symbols);
+        free(State.Instructions);
+        return;
+    }
+
+    memcpy(State.Symbols, CodeBuffer->Head, CodeBuffer->Pointer * sizeof(SYMBOL));
+
+    if (!OptimizerDecode(&State))
+    {
+        free(State.Symbols);
+        free(State.Instructions);
+        return;
+    }
+
+    while (Changed && PassesCount++ < OPTIMIZER_MAX_PASSES)
+    {
+        Changed = OptimizerPropagate(&State);
+        Changed |= OptimizerSimplifyControlFlow(&State);
+
+        if (State.CanOptimizeTemps && OptimizerComputeLiveness(&State))
+        {
+            Changed |= OptimizerEliminateDeadCode(&State);
+        }
+    }
+
+    if (State.CanOptimizeTemps && OptimizerComputeLiveness(&State))
+    {
+        OptimizerReallocateTemps(&State);
+    }
+
+    OptimizerEmit(&State, CodeBuffer);
+
+    free(State.Symbols);
+    free(State.Instructions);
+
+#ifdef _SCRIPT_ENGINE_OPTIMIZER_DBG_EN
+    printf("Original code size: %d symbols, optimized code size: %d symbols\n", OriginalSize, CodeBuffer->Pointer);
+    PrintSymbolBuffer(CodeBuffer);
+#else
+    UNREFERENCED_PARAMETER(OriginalSize);
+#endif
+}
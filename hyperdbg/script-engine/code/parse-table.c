@@ -55,6 +55,26 @@ const struct _TOKEN Lhs[RULES_COUNT]=
 	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
 	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
 	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
+	{NON_TERMINAL, "CALL_FUNC_STATEMENT"},
 	{NON_TERMINAL, "VA"},
 	{NON_TERMINAL, "VA"},
 	{NON_TERMINAL, "IF_STATEMENT"},
@@ -140,6 +160,21 @@ const struct _TOKEN Lhs[RULES_COUNT]=
 	{NON_TERMINAL, "E12"},
 	{NON_TERMINAL, "E12"},
 	{NON_TERMINAL, "E12"},
+	{NON_TERMINAL, "E12"},
+	{NON_TERMINAL, "E12"},
+	{NON_TERMINAL, "E12"},
+	{NON_TERMINAL, "E12"},
+	{NON_TERMINAL, "E12"},
+	{NON_TERMINAL, "E12"},
+	{NON_TERMINAL, "E12"},
+	{NON_TERMINAL, "E12"},
+	{NON_TERMINAL, "E12"},
+	{NON_TERMINAL, "E12"},
+	{NON_TERMINAL, "E12"},
+	{NON_TERMINAL, "E12"},
+	{NON_TERMINAL, "E12"},
+	{NON_TERMINAL, "E12"},
+	{NON_TERMINAL, "E12"},
 	{NON_TERMINAL, "STRING"},
 	{NON_TERMINAL, "L_VALUE"},
 	{NON_TERMINAL, "L_VALUE"},
@@ -169,10 +204,15 @@ const struct _TOKEN Rhs[RULES_COUNT][MAX_RHS_LEN]=
 	{{KEYWORD, "test_statement"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@TEST_STATEMENT"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "spinlock_lock"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@SPINLOCK_LOCK"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "spinlock_unlock"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@SPINLOCK_UNLOCK"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "agg_print"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@AGG_PRINT"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "agg_clear"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@AGG_CLEAR"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "stack"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@STACK"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "printf"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "STRING"},{SEMANTIC_RULE, "@VARGSTART"},{NON_TERMINAL, "VA"},{SEMANTIC_RULE, "@PRINTF"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "pause"},{SPECIAL_TOKEN, "("},{SEMANTIC_RULE, "@PAUSE"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "flush"},{SPECIAL_TOKEN, "("},{SEMANTIC_RULE, "@FLUSH"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "spinlock_lock_custom_wait"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@SPINLOCK_LOCK_CUSTOM_WAIT"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "agg_count"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@AGG_COUNT"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "agg_hist"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@AGG_HIST"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "poi"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@POI"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
 	{{KEYWORD, "db"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@DB"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
 	{{KEYWORD, "dd"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@DD"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
@@ -194,13 +234,28 @@ const struct _TOKEN Rhs[RULES_COUNT][MAX_RHS_LEN]=
 	{{KEYWORD, "physical_to_virtual"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@PHYSICAL_TO_VIRTUAL"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
 	{{KEYWORD, "virtual_to_physical"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@VIRTUAL_TO_PHYSICAL"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
 	{{KEYWORD, "event_sc"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@EVENT_SC"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
+	{{KEYWORD, "percpu_sum"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@PERCPU_SUM"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
+	{{KEYWORD, "percpu_min"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@PERCPU_MIN"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
+	{{KEYWORD, "percpu_max"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@PERCPU_MAX"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
+	{{KEYWORD, "scratch"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@SCRATCH"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
 	{{KEYWORD, "ed"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@ED"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
 	{{KEYWORD, "eb"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@EB"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
 	{{KEYWORD, "eq"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@EQ"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
 	{{KEYWORD, "interlocked_exchange"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@INTERLOCKED_EXCHANGE"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
 	{{KEYWORD, "interlocked_exchange_add"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@INTERLOCKED_EXCHANGE_ADD"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
+	{{KEYWORD, "strcmp"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@STRCMP"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
+	{{KEYWORD, "wcscmp"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@WCSCMP"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
+	{{KEYWORD, "stricmp"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@STRICMP"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
 	{{KEYWORD, "interlocked_compare_exchange"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@INTERLOCKED_COMPARE_EXCHANGE"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
 	{{KEYWORD, "memcpy"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@MEMCPY"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
+	{{KEYWORD, "agg_sum"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@AGG_SUM"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
+	{{KEYWORD, "agg_min"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@AGG_MIN"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
+	{{KEYWORD, "agg_max"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@AGG_MAX"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
+	{{KEYWORD, "memcmp"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@MEMCMP"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
+	{{KEYWORD, "memset"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@MEMSET"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
+	{{KEYWORD, "memsearch"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@MEMSEARCH"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
+	{{KEYWORD, "event_add_range"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@EVENT_ADD_RANGE"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
+	{{KEYWORD, "event_remove_range"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@EVENT_REMOVE_RANGE"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@IGNORE_LVALUE"}},
 	{{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{NON_TERMINAL, "VA"}},
 	{{EPSILON, "eps"}},
 	{{KEYWORD, "if"},{SEMANTIC_RULE, "@START_OF_IF"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "BOOLEAN_EXPRESSION"},{SPECIAL_TOKEN, ")"},{SEMANTIC_RULE, "@JZ"},{SPECIAL_TOKEN, "{"},{NON_TERMINAL, "S"},{SPECIAL_TOKEN, "}"},{NON_TERMINAL, "ELSIF_STATEMENT"},{NON_TERMINAL, "ELSE_STATEMENT"},{SEMANTIC_RULE, "@END_OF_IF"},{NON_TERMINAL, "END_OF_IF"}},
@@ -265,13 +320,28 @@ const struct _TOKEN Rhs[RULES_COUNT][MAX_RHS_LEN]=
 	{{KEYWORD, "physical_to_virtual"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@PHYSICAL_TO_VIRTUAL"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "virtual_to_physical"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@VIRTUAL_TO_PHYSICAL"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "event_sc"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@EVENT_SC"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "percpu_sum"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@PERCPU_SUM"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "percpu_min"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@PERCPU_MIN"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "percpu_max"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@PERCPU_MAX"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "scratch"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@SCRATCH"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "ed"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@ED"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "eb"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@EB"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "eq"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@EQ"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "interlocked_exchange"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@INTERLOCKED_EXCHANGE"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "interlocked_exchange_add"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@INTERLOCKED_EXCHANGE_ADD"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "strcmp"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@STRCMP"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "wcscmp"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@WCSCMP"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "stricmp"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@STRICMP"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "interlocked_compare_exchange"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@INTERLOCKED_COMPARE_EXCHANGE"},{SPECIAL_TOKEN, ")"}},
 	{{KEYWORD, "memcpy"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@MEMCPY"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "agg_sum"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@AGG_SUM"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "agg_min"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@AGG_MIN"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "agg_max"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@AGG_MAX"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "memcmp"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@MEMCMP"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "memset"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@MEMSET"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "memsearch"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@MEMSEARCH"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "event_add_range"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@EVENT_ADD_RANGE"},{SPECIAL_TOKEN, ")"}},
+	{{KEYWORD, "event_remove_range"},{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ","},{NON_TERMINAL, "EXPRESSION"},{SEMANTIC_RULE, "@EVENT_REMOVE_RANGE"},{SPECIAL_TOKEN, ")"}},
 	{{SPECIAL_TOKEN, "("},{NON_TERMINAL, "EXPRESSION"},{SPECIAL_TOKEN, ")"}},
 	{{SEMANTIC_RULE, "@PUSH"},{REGISTER, "_register"}},
 	{{SEMANTIC_RULE, "@PUSH"},{LOCAL_ID, "_local_id"}},
@@ -315,10 +385,17 @@ const unsigned int RhsSize[RULES_COUNT]=
 5,
 5,
 5,
+5,
+5,
+5,
 7,
 4,
 4,
 7,
+7,
+7,
+6,
+6,
 6,
 6,
 6,
@@ -340,11 +417,24 @@ const unsigned int RhsSize[RULES_COUNT]=
 6,
 6,
 6,
+6,
+6,
+8,
 8,
 8,
 8,
 8,
 8,
+8,
+8,
+10,
+10,
+10,
+10,
+10,
+10,
+10,
+10,
 10,
 10,
 3,
@@ -411,11 +501,26 @@ const unsigned int RhsSize[RULES_COUNT]=
 5,
 5,
 5,
+5,
+5,
+5,
+5,
+7,
+7,
 7,
 7,
 7,
 7,
 7,
+7,
+9,
+9,
+9,
+9,
+9,
+9,
+9,
+9,
 9,
 9,
 3,
@@ -439,157 +544,177 @@ const unsigned int RhsSize[RULES_COUNT]=
 };
 const char* NoneTerminalMap[NONETERMINAL_COUNT]= 
 {
-"WHILE_STATEMENT",
-"DO_WHILE_STATEMENT",
+"S",
 "IF_STATEMENT",
-"E0'",
-"ASSIGNMENT_STATEMENT",
+"VA",
+"FOR_STATEMENT",
+"ELSIF_STATEMENT",
+"CALL_FUNC_STATEMENT",
+"INC_DEC'",
 "E4'",
 "E3'",
-"E1",
-"L_VALUE",
-"E3",
-"ELSIF_STATEMENT'",
-"E5'",
-"ELSIF_STATEMENT",
-"FOR_STATEMENT",
 "SIMPLE_ASSIGNMENT'",
-"INC_DEC",
+"E3",
+"E4",
+"STATEMENT",
 "E2",
-"E1'",
+"END_OF_IF",
+"E5",
 "ELSE_STATEMENT",
-"CALL_FUNC_STATEMENT",
-"STATEMENT",
-"INC_DEC'",
+"ASSIGNMENT_STATEMENT'",
+"E5'",
+"SIMPLE_ASSIGNMENT",
+"BOOLEAN_EXPRESSION",
+"E1'",
 "E2'",
 "EXPRESSION",
+"ASSIGNMENT_STATEMENT",
+"L_VALUE",
+"DO_WHILE_STATEMENT",
+"ELSIF_STATEMENT'",
 "E12",
-"E5",
-"E4",
-"END_OF_IF",
-"S",
-"VA",
-"ASSIGNMENT_STATEMENT'",
+"INC_DEC",
+"E1",
 "STRING",
-"BOOLEAN_EXPRESSION",
-"SIMPLE_ASSIGNMENT"
+"WHILE_STATEMENT",
+"E0'"
 };
 const char* TerminalMap[TERMINAL_COUNT]= 
 {
-"disassemble_len32",
-"else",
-"+",
-"dw",
-"reference",
-"_pseudo_register",
-"_local_id",
-"*",
+"memcpy",
+";",
+"agg_print",
+"~",
+"agg_sum",
+"++",
+"test_statement",
+"interlocked_exchange",
+"event_remove_range",
+"poi",
+"&",
+"memsearch",
+"/",
+"strlen",
+"spinlock_unlock",
 "do",
-">>",
+"reference",
 "disassemble_len",
+"continue",
+"scratch",
+"percpu_sum",
+"spinlock_lock_custom_wait",
+"}",
+"_binary",
+"check_address",
+">>",
+"stack",
+"_hex",
+"_register",
+"|",
+"$",
+"wcslen",
 "if",
-"dd",
+"disassemble_len32",
+"*",
 "interlocked_compare_exchange",
-"_string",
-"low",
-"event_enable",
-"memcpy",
-"eb",
-"&",
+"spinlock_lock",
+"elsif",
+"{",
+"-",
+"--",
+"_decimal",
+"%",
 "^",
-"dq",
-"++",
-"continue",
-";",
-"flush",
-"_global_id",
+")",
+"event_add_range",
+"dw",
+"eq",
+"printf",
 "interlocked_exchange_add",
-"{",
-"for",
-"not",
-"poi",
+"stricmp",
+"memcmp",
+"pause",
+"event_enable",
+"_global_id",
+"agg_max",
+"(",
 "hi",
-"event_disable",
-"=",
-"db",
-",",
-"disassemble_len64",
-"test_statement",
-"<<",
-"|",
-"ed",
-"spinlock_lock_custom_wait",
-"event_sc",
-"_register",
-"neg",
-"interlocked_decrement",
-")",
 "while",
-"eq",
-"spinlock_lock",
+"ed",
+"interlocked_increment",
 "virtual_to_physical",
+",",
+"low",
 "print",
-"}",
-"strlen",
-"~",
-"--",
-"interlocked_exchange",
+"flush",
+"not",
+"_pseudo_register",
+"dq",
+"event_sc",
+"_string",
+"percpu_min",
+"agg_min",
+"+",
 "_octal",
-"wcslen",
-"printf",
-"%",
-"(",
-"spinlock_unlock",
-"_hex",
-"formats",
-"elsif",
+"wcscmp",
+"interlocked_decrement",
+"strcmp",
 "break",
-"pause",
-"-",
-"interlocked_increment",
-"$",
-"_binary",
-"_decimal",
-"check_address",
+"formats",
+"percpu_max",
+"agg_hist",
+"disassemble_len64",
+"event_disable",
+"eb",
+"else",
+"neg",
+"agg_count",
+"dd",
+"agg_clear",
 "physical_to_virtual",
-"/"
+"memset",
+"<<",
+"for",
+"db",
+"=",
+"_local_id"
 };
 const int ParseTable[NONETERMINAL_COUNT][TERMINAL_COUNT]= 
 {
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,63		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,64		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,56		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,77		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,77		,-999		,-999		,-999		,76		,-999		,-999		,-999		,-999		,-999		,-999		,77		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,11		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,11		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,11		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,89		,-999		,-999		,-999		,-999		,-999		,-999		,91		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,91		,91		,-999		,-999		,-999		,91		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,91		,-999		,-999		,91		,91		,-999		,-999		,-999		,-999		,-999		,-999		,91		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,90		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,85		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,87		,87		,-999		,-999		,-999		,87		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,87		,-999		,-999		,86		,87		,-999		,-999		,-999		,-999		,-999		,-999		,87		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{78		,-999		,78		,78		,78		,78		,78		,78		,-999		,-999		,78		,-999		,78		,78		,-999		,78		,-999		,78		,78		,78		,-999		,78		,-999		,-999		,-999		,-999		,78		,78		,-999		,-999		,78		,78		,78		,-999		,-999		,78		,-999		,78		,-999		,-999		,-999		,78		,-999		,78		,78		,78		,78		,-999		,-999		,78		,-999		,78		,-999		,-999		,78		,78		,-999		,78		,78		,78		,-999		,-999		,78		,-999		,78		,-999		,-999		,-999		,-999		,78		,78		,-999		,78		,78		,78		,78		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,141		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,140		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,142		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{84		,-999		,84		,84		,84		,84		,84		,84		,-999		,-999		,84		,-999		,84		,84		,-999		,84		,-999		,84		,84		,84		,-999		,84		,-999		,-999		,-999		,-999		,84		,84		,-999		,-999		,84		,84		,84		,-999		,-999		,84		,-999		,84		,-999		,-999		,-999		,84		,-999		,84		,84		,84		,84		,-999		,-999		,84		,-999		,84		,-999		,-999		,84		,84		,-999		,84		,84		,84		,-999		,-999		,84		,-999		,84		,-999		,-999		,-999		,-999		,84		,84		,-999		,84		,84		,84		,84		,-999	},
-	{59		,59		,-999		,59		,59		,-999		,59		,-999		,59		,-999		,59		,59		,59		,59		,-999		,59		,59		,59		,59		,-999		,-999		,59		,-999		,59		,-999		,59		,59		,59		,59		,59		,59		,59		,59		,59		,-999		,59		,-999		,59		,59		,-999		,-999		,59		,59		,59		,59		,59		,59		,-999		,59		,59		,59		,59		,59		,59		,59		,-999		,-999		,59		,-999		,59		,59		,-999		,-999		,59		,-999		,59		,-999		,59		,59		,-999		,59		,59		,-999		,-999		,59		,59		,-999	},
-	{-999		,-999		,96		,-999		,-999		,-999		,-999		,95		,-999		,96		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,96		,96		,-999		,-999		,-999		,96		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,96		,-999		,-999		,96		,96		,-999		,-999		,-999		,-999		,-999		,-999		,96		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,94		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,96		,-999		,-999		,-999		,-999		,-999		,-999		,93	},
-	{58		,58		,-999		,58		,58		,-999		,58		,-999		,58		,-999		,58		,58		,58		,58		,-999		,58		,58		,58		,58		,-999		,-999		,58		,-999		,58		,-999		,58		,58		,58		,58		,58		,58		,58		,58		,58		,-999		,58		,-999		,58		,58		,-999		,-999		,58		,58		,58		,58		,58		,58		,-999		,58		,58		,58		,58		,58		,58		,58		,-999		,-999		,58		,-999		,58		,58		,-999		,-999		,58		,-999		,58		,57		,58		,58		,-999		,58		,58		,-999		,-999		,58		,58		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,65		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,68		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,68		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,69		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,69		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,69		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{81		,-999		,81		,81		,81		,81		,81		,81		,-999		,-999		,81		,-999		,81		,81		,-999		,81		,-999		,81		,81		,81		,-999		,81		,-999		,-999		,-999		,-999		,81		,81		,-999		,-999		,81		,81		,81		,-999		,-999		,81		,-999		,81		,-999		,-999		,-999		,81		,-999		,81		,81		,81		,81		,-999		,-999		,81		,-999		,81		,-999		,-999		,81		,81		,-999		,81		,81		,81		,-999		,-999		,81		,-999		,81		,-999		,-999		,-999		,-999		,81		,81		,-999		,81		,81		,81		,81		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,79		,-999		,-999		,-999		,80		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,80		,-999		,-999		,-999		,80		,-999		,-999		,-999		,-999		,-999		,-999		,80		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{61		,60		,-999		,61		,61		,-999		,61		,-999		,61		,-999		,61		,61		,61		,61		,-999		,61		,61		,61		,61		,-999		,-999		,61		,-999		,61		,-999		,61		,61		,61		,61		,61		,61		,61		,61		,61		,-999		,61		,-999		,61		,61		,-999		,-999		,61		,61		,61		,61		,61		,61		,-999		,61		,61		,61		,61		,61		,61		,61		,-999		,-999		,61		,-999		,61		,61		,-999		,-999		,61		,-999		,61		,-999		,61		,61		,-999		,61		,61		,-999		,-999		,61		,61		,-999	},
-	{39		,-999		,-999		,29		,43		,-999		,-999		,-999		,-999		,-999		,38		,-999		,28		,52		,-999		,33		,17		,53		,48		,-999		,-999		,30		,-999		,-999		,-999		,24		,-999		,51		,-999		,-999		,34		,26		,32		,18		,-999		,27		,-999		,40		,19		,-999		,-999		,47		,25		,46		,-999		,31		,42		,-999		,-999		,49		,20		,45		,15		,-999		,36		,-999		,-999		,50		,-999		,37		,22		,-999		,-999		,21		,-999		,16		,-999		,-999		,23		,-999		,41		,-999		,-999		,-999		,35		,44		,-999	},
-	{8		,-999		,-999		,8		,8		,-999		,7		,-999		,5		,-999		,8		,3		,8		,8		,-999		,8		,8		,8		,8		,-999		,-999		,8		,-999		,10		,-999		,8		,7		,8		,-999		,6		,8		,8		,8		,8		,-999		,8		,-999		,8		,8		,-999		,-999		,8		,8		,8		,7		,8		,8		,-999		,4		,8		,8		,8		,8		,-999		,8		,-999		,-999		,8		,-999		,8		,8		,-999		,-999		,8		,-999		,8		,-999		,9		,8		,-999		,8		,-999		,-999		,-999		,8		,8		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,70		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,72		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,73		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,71		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,82		,83		,-999		,-999		,-999		,83		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,83		,-999		,-999		,-999		,83		,-999		,-999		,-999		,-999		,-999		,-999		,83		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{75		,-999		,75		,75		,75		,75		,75		,75		,-999		,-999		,75		,-999		,75		,75		,-999		,75		,-999		,75		,75		,75		,-999		,75		,-999		,-999		,-999		,-999		,75		,75		,-999		,-999		,75		,75		,75		,-999		,-999		,75		,-999		,75		,-999		,-999		,-999		,75		,-999		,75		,75		,75		,75		,-999		,-999		,75		,-999		,75		,-999		,-999		,75		,75		,-999		,75		,75		,75		,-999		,-999		,75		,-999		,75		,-999		,-999		,-999		,-999		,75		,75		,-999		,75		,75		,75		,75		,-999	},
-	{110		,-999		,135		,100		,114		,133		,127		,137		,-999		,-999		,109		,-999		,99		,123		,-999		,104		,-999		,124		,119		,138		,-999		,101		,-999		,-999		,-999		,-999		,128		,122		,-999		,-999		,105		,97		,103		,-999		,-999		,98		,-999		,111		,-999		,-999		,-999		,118		,-999		,117		,126		,102		,113		,-999		,-999		,120		,-999		,116		,-999		,-999		,107		,136		,-999		,121		,131		,108		,-999		,-999		,125		,-999		,129		,-999		,-999		,-999		,-999		,134		,112		,-999		,132		,130		,106		,115		,-999	},
-	{92		,-999		,92		,92		,92		,92		,92		,92		,-999		,-999		,92		,-999		,92		,92		,-999		,92		,-999		,92		,92		,92		,-999		,92		,-999		,-999		,-999		,-999		,92		,92		,-999		,-999		,92		,92		,92		,-999		,-999		,92		,-999		,92		,-999		,-999		,-999		,92		,-999		,92		,92		,92		,92		,-999		,-999		,92		,-999		,92		,-999		,-999		,92		,92		,-999		,92		,92		,92		,-999		,-999		,92		,-999		,92		,-999		,-999		,-999		,-999		,92		,92		,-999		,92		,92		,92		,92		,-999	},
-	{88		,-999		,88		,88		,88		,88		,88		,88		,-999		,-999		,88		,-999		,88		,88		,-999		,88		,-999		,88		,88		,88		,-999		,88		,-999		,-999		,-999		,-999		,88		,88		,-999		,-999		,88		,88		,88		,-999		,-999		,88		,-999		,88		,-999		,-999		,-999		,88		,-999		,88		,88		,88		,88		,-999		,-999		,88		,-999		,88		,-999		,-999		,88		,88		,-999		,88		,88		,88		,-999		,-999		,88		,-999		,88		,-999		,-999		,-999		,-999		,88		,88		,-999		,88		,88		,88		,88		,-999	},
-	{62		,-999		,-999		,62		,62		,-999		,62		,-999		,62		,-999		,62		,62		,62		,62		,-999		,62		,62		,62		,62		,-999		,-999		,62		,-999		,62		,-999		,62		,62		,62		,62		,62		,62		,62		,62		,62		,-999		,62		,-999		,62		,62		,-999		,-999		,62		,62		,62		,62		,62		,62		,-999		,62		,62		,62		,62		,62		,62		,62		,-999		,-999		,62		,-999		,62		,62		,-999		,-999		,62		,-999		,62		,-999		,62		,62		,-999		,62		,62		,-999		,-999		,62		,62		,-999	},
-	{0		,-999		,-999		,0		,0		,-999		,0		,-999		,0		,-999		,0		,0		,0		,0		,-999		,0		,0		,0		,0		,-999		,-999		,0		,-999		,0		,-999		,0		,0		,0		,1		,0		,0		,0		,0		,0		,-999		,0		,-999		,0		,0		,-999		,-999		,0		,0		,0		,0		,0		,0		,-999		,0		,0		,0		,0		,0		,2		,0		,-999		,-999		,0		,-999		,0		,0		,-999		,-999		,0		,-999		,0		,-999		,0		,0		,-999		,0		,2		,-999		,-999		,0		,0		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,54		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,55		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,12		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,14		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,13		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,139		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,74		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,74		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,66		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,67		,-999		,66		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,66		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	}
+	{0		,-999		,0		,-999		,0		,-999		,0		,0		,0		,0		,-999		,0		,-999		,0		,0		,0		,0		,0		,0		,0		,0		,0		,2		,-999		,0		,-999		,0		,-999		,0		,-999		,2		,0		,0		,0		,-999		,0		,0		,-999		,1		,-999		,-999		,-999		,-999		,-999		,-999		,0		,0		,0		,0		,0		,0		,0		,0		,0		,0		,0		,-999		,0		,0		,0		,0		,0		,-999		,0		,0		,0		,0		,-999		,0		,0		,-999		,0		,0		,-999		,-999		,0		,0		,0		,0		,0		,0		,0		,0		,0		,0		,-999		,0		,0		,0		,0		,0		,0		,-999		,0		,0		,-999		,0	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,76		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,75		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,74		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,85		,-999		,-999		,-999	},
+	{78		,-999		,78		,-999		,78		,-999		,78		,78		,78		,78		,-999		,78		,-999		,78		,78		,78		,78		,78		,78		,78		,78		,78		,78		,-999		,78		,-999		,78		,-999		,78		,-999		,78		,78		,78		,78		,-999		,78		,78		,77		,78		,-999		,-999		,-999		,-999		,-999		,-999		,78		,78		,78		,78		,78		,78		,78		,78		,78		,78		,78		,-999		,78		,78		,78		,78		,78		,-999		,78		,78		,78		,78		,-999		,78		,78		,-999		,78		,78		,-999		,-999		,78		,78		,78		,78		,78		,78		,78		,78		,78		,78		,78		,78		,78		,78		,78		,78		,78		,-999		,78		,78		,-999		,78	},
+	{65		,-999		,22		,-999		,66		,-999		,19		,59		,73		,31		,-999		,71		,-999		,41		,21		,-999		,48		,43		,-999		,55		,52		,28		,-999		,-999		,40		,-999		,24		,-999		,-999		,-999		,-999		,42		,-999		,44		,-999		,64		,20		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,72		,34		,58		,25		,60		,63		,69		,26		,17		,-999		,68		,-999		,37		,-999		,56		,46		,50		,-999		,38		,15		,27		,39		,-999		,35		,51		,-999		,53		,67		,-999		,-999		,62		,47		,61		,-999		,16		,54		,30		,45		,18		,57		,-999		,36		,29		,33		,23		,49		,70		,-999		,-999		,32		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,90		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,91		,-999		,-999		,-999		,93		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,92		,-999	},
+	{-999		,111		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,111		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,111		,-999		,-999		,-999		,111		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,110		,-999		,-999		,-999		,111		,111		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,111		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,109		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,111		,-999		,-999		,-999		,-999	},
+	{-999		,107		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,107		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,105		,-999		,-999		,-999		,107		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,107		,107		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,107		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,106		,-999		,-999		,-999		,-999	},
+	{-999		,88		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,88		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{104		,-999		,-999		,104		,104		,-999		,-999		,104		,104		,104		,104		,104		,-999		,104		,-999		,-999		,104		,104		,-999		,104		,104		,-999		,-999		,104		,104		,-999		,-999		,104		,104		,-999		,-999		,104		,-999		,104		,104		,104		,-999		,-999		,-999		,104		,-999		,104		,-999		,-999		,-999		,104		,104		,104		,-999		,104		,104		,104		,-999		,-999		,104		,104		,104		,104		,-999		,104		,104		,104		,-999		,104		,-999		,-999		,104		,104		,104		,104		,-999		,104		,104		,104		,104		,104		,104		,104		,-999		,-999		,104		,-999		,104		,-999		,104		,-999		,104		,-999		,104		,-999		,104		,104		,-999		,-999		,104		,-999		,104	},
+	{108		,-999		,-999		,108		,108		,-999		,-999		,108		,108		,108		,108		,108		,-999		,108		,-999		,-999		,108		,108		,-999		,108		,108		,-999		,-999		,108		,108		,-999		,-999		,108		,108		,-999		,-999		,108		,-999		,108		,108		,108		,-999		,-999		,-999		,108		,-999		,108		,-999		,-999		,-999		,108		,108		,108		,-999		,108		,108		,108		,-999		,-999		,108		,108		,108		,108		,-999		,108		,108		,108		,-999		,108		,-999		,-999		,108		,108		,108		,108		,-999		,108		,108		,108		,108		,108		,108		,108		,-999		,-999		,108		,-999		,108		,-999		,108		,-999		,108		,-999		,108		,-999		,108		,108		,-999		,-999		,108		,-999		,108	},
+	{8		,-999		,8		,-999		,8		,-999		,8		,8		,8		,8		,-999		,8		,-999		,8		,8		,5		,8		,8		,10		,8		,8		,8		,-999		,-999		,8		,-999		,8		,-999		,7		,-999		,-999		,8		,3		,8		,-999		,8		,8		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,8		,8		,8		,8		,8		,8		,8		,8		,8		,7		,8		,-999		,8		,4		,8		,8		,8		,-999		,8		,8		,8		,8		,-999		,8		,8		,-999		,8		,8		,-999		,-999		,8		,8		,8		,9		,8		,8		,8		,8		,8		,8		,-999		,8		,8		,8		,8		,8		,8		,-999		,6		,8		,-999		,7	},
+	{101		,-999		,-999		,101		,101		,-999		,-999		,101		,101		,101		,101		,101		,-999		,101		,-999		,-999		,101		,101		,-999		,101		,101		,-999		,-999		,101		,101		,-999		,-999		,101		,101		,-999		,-999		,101		,-999		,101		,101		,101		,-999		,-999		,-999		,101		,-999		,101		,-999		,-999		,-999		,101		,101		,101		,-999		,101		,101		,101		,-999		,-999		,101		,101		,101		,101		,-999		,101		,101		,101		,-999		,101		,-999		,-999		,101		,101		,101		,101		,-999		,101		,101		,101		,101		,101		,101		,101		,-999		,-999		,101		,-999		,101		,-999		,101		,-999		,101		,-999		,101		,-999		,101		,101		,-999		,-999		,101		,-999		,101	},
+	{82		,-999		,82		,-999		,82		,-999		,82		,82		,82		,82		,-999		,82		,-999		,82		,82		,82		,82		,82		,82		,82		,82		,82		,82		,-999		,82		,-999		,82		,-999		,82		,-999		,82		,82		,82		,82		,-999		,82		,82		,-999		,82		,-999		,-999		,-999		,-999		,-999		,-999		,82		,82		,82		,82		,82		,82		,82		,82		,82		,82		,82		,-999		,82		,82		,82		,82		,82		,-999		,82		,82		,82		,82		,-999		,82		,82		,-999		,82		,82		,-999		,-999		,82		,82		,82		,82		,82		,82		,82		,82		,82		,82		,-999		,82		,82		,82		,82		,82		,82		,-999		,82		,82		,-999		,82	},
+	{112		,-999		,-999		,112		,112		,-999		,-999		,112		,112		,112		,112		,112		,-999		,112		,-999		,-999		,112		,112		,-999		,112		,112		,-999		,-999		,112		,112		,-999		,-999		,112		,112		,-999		,-999		,112		,-999		,112		,112		,112		,-999		,-999		,-999		,112		,-999		,112		,-999		,-999		,-999		,112		,112		,112		,-999		,112		,112		,112		,-999		,-999		,112		,112		,112		,112		,-999		,112		,112		,112		,-999		,112		,-999		,-999		,112		,112		,112		,112		,-999		,112		,112		,112		,112		,112		,112		,112		,-999		,-999		,112		,-999		,112		,-999		,112		,-999		,112		,-999		,112		,-999		,112		,112		,-999		,-999		,112		,-999		,112	},
+	{81		,-999		,81		,-999		,81		,-999		,81		,81		,81		,81		,-999		,81		,-999		,81		,81		,81		,81		,81		,81		,81		,81		,81		,81		,-999		,81		,-999		,81		,-999		,81		,-999		,81		,81		,81		,81		,-999		,81		,81		,-999		,81		,-999		,-999		,-999		,-999		,-999		,-999		,81		,81		,81		,81		,81		,81		,81		,81		,81		,81		,81		,-999		,81		,81		,81		,81		,81		,-999		,81		,81		,81		,81		,-999		,81		,81		,-999		,81		,81		,-999		,-999		,81		,81		,81		,81		,81		,81		,81		,81		,81		,81		,80		,81		,81		,81		,81		,81		,81		,-999		,81		,81		,-999		,81	},
+	{-999		,-999		,-999		,-999		,-999		,12		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,13		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,14		,-999	},
+	{-999		,116		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,116		,-999		,113		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,116		,-999		,-999		,-999		,116		,-999		,-999		,-999		,-999		,115		,-999		,-999		,-999		,-999		,116		,-999		,-999		,114		,116		,116		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,116		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,116		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,116		,-999		,-999		,-999		,-999	},
+	{-999		,87		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,86		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,86		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,86	},
+	{-999		,94		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,94		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,100		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,100		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,99		,100		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,100		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,103		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,102		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,103		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,103		,103		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,103		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{95		,-999		,-999		,95		,95		,-999		,-999		,95		,95		,95		,95		,95		,-999		,95		,-999		,-999		,95		,95		,-999		,95		,95		,-999		,-999		,95		,95		,-999		,-999		,95		,95		,-999		,-999		,95		,-999		,95		,95		,95		,-999		,-999		,-999		,95		,-999		,95		,-999		,-999		,-999		,95		,95		,95		,-999		,95		,95		,95		,-999		,-999		,95		,95		,95		,95		,-999		,95		,95		,95		,-999		,95		,-999		,-999		,95		,95		,95		,95		,-999		,95		,95		,95		,95		,95		,95		,95		,-999		,-999		,95		,-999		,95		,-999		,95		,-999		,95		,-999		,95		,-999		,95		,95		,-999		,-999		,95		,-999		,95	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,11		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,11		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,11	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,177		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,175		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,176	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,84		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{79		,-999		,79		,-999		,79		,-999		,79		,79		,79		,79		,-999		,79		,-999		,79		,79		,79		,79		,79		,79		,79		,79		,79		,79		,-999		,79		,-999		,79		,-999		,79		,-999		,79		,79		,79		,79		,-999		,79		,79		,-999		,79		,-999		,-999		,-999		,-999		,-999		,-999		,79		,79		,79		,79		,79		,79		,79		,79		,79		,79		,79		,-999		,79		,79		,79		,79		,79		,-999		,79		,79		,79		,79		,-999		,79		,79		,-999		,79		,79		,-999		,-999		,79		,79		,79		,79		,79		,79		,79		,79		,79		,79		,79		,79		,79		,79		,79		,79		,79		,-999		,79		,79		,-999		,79	},
+	{151		,-999		,-999		,171		,152		,-999		,-999		,145		,159		,117		,173		,157		,-999		,127		,-999		,-999		,134		,129		,-999		,141		,138		,-999		,-999		,167		,126		,-999		,-999		,164		,161		,-999		,-999		,128		,-999		,130		,172		,150		,-999		,-999		,-999		,169		,-999		,165		,-999		,-999		,-999		,158		,120		,144		,-999		,146		,149		,155		,-999		,-999		,163		,154		,160		,123		,-999		,142		,132		,136		,-999		,124		,-999		,-999		,125		,168		,121		,137		,-999		,139		,153		,170		,166		,148		,133		,147		,-999		,-999		,140		,-999		,131		,-999		,143		,-999		,122		,-999		,119		,-999		,135		,156		,-999		,-999		,118		,-999		,162	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,89		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,89		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,89	},
+	{98		,-999		,-999		,98		,98		,-999		,-999		,98		,98		,98		,98		,98		,-999		,98		,-999		,-999		,98		,98		,-999		,98		,98		,-999		,-999		,98		,98		,-999		,-999		,98		,98		,-999		,-999		,98		,-999		,98		,98		,98		,-999		,-999		,-999		,98		,-999		,98		,-999		,-999		,-999		,98		,98		,98		,-999		,98		,98		,98		,-999		,-999		,98		,98		,98		,98		,-999		,98		,98		,98		,-999		,98		,-999		,-999		,98		,98		,98		,98		,-999		,98		,98		,98		,98		,98		,98		,98		,-999		,-999		,98		,-999		,98		,-999		,98		,-999		,98		,-999		,98		,-999		,98		,98		,-999		,-999		,98		,-999		,98	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,174		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,83		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,97		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,96		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,97		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,97		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	}
 };
 const char* KeywordList[]= {
 "print",
@@ -599,10 +724,15 @@ const char* KeywordList[]= {
 "test_statement",
 "spinlock_lock",
 "spinlock_unlock",
+"agg_print",
+"agg_clear",
+"stack",
 "printf",
 "pause",
 "flush",
 "spinlock_lock_custom_wait",
+"agg_count",
+"agg_hist",
 "poi",
 "db",
 "dd",
@@ -624,13 +754,28 @@ const char* KeywordList[]= {
 "physical_to_virtual",
 "virtual_to_physical",
 "event_sc",
+"percpu_sum",
+"percpu_min",
+"percpu_max",
+"scratch",
 "ed",
 "eb",
 "eq",
 "interlocked_exchange",
 "interlocked_exchange_add",
+"strcmp",
+"wcscmp",
+"stricmp",
 "interlocked_compare_exchange",
 "memcpy",
+"agg_sum",
+"agg_min",
+"agg_max",
+"memcmp",
+"memset",
+"memsearch",
+"event_add_range",
+"event_remove_range",
 "poi",
 "db",
 "dd",
@@ -652,13 +797,28 @@ const char* KeywordList[]= {
 "physical_to_virtual",
 "virtual_to_physical",
 "event_sc",
+"percpu_sum",
+"percpu_min",
+"percpu_max",
+"scratch",
 "ed",
 "eb",
 "eq",
 "interlocked_exchange",
 "interlocked_exchange_add",
+"strcmp",
+"wcscmp",
+"stricmp",
 "interlocked_compare_exchange",
-"memcpy"
+"memcpy",
+"agg_sum",
+"agg_min",
+"agg_max",
+"memcmp",
+"memset",
+"memsearch",
+"event_add_range",
+"event_remove_range"
 };
 const char* OperatorsTwoOperandList[]= {
 "@OR",
@@ -687,6 +847,14 @@ const char* OperatorsOneOperandList[]= {
 const char* ThreeOpFunc1[] = {
 "@INTERLOCKED_COMPARE_EXCHANGE",
 "@MEMCPY",
+"@AGG_SUM",
+"@AGG_MIN",
+"@AGG_MAX",
+"@MEMCMP",
+"@MEMSET",
+"@MEMSEARCH",
+"@EVENT_ADD_RANGE",
+"@EVENT_REMOVE_RANGE",
 };
 const char* TwoOpFunc1[] = {
 "@ED",
@@ -694,9 +862,14 @@ const char* TwoOpFunc1[] = {
 "@EQ",
 "@INTERLOCKED_EXCHANGE",
 "@INTERLOCKED_EXCHANGE_ADD",
+"@STRCMP",
+"@WCSCMP",
+"@STRICMP",
 };
 const char* TwoOpFunc2[] = {
-"@SPINLOCK_LOCK_CUSTOM_WAIT"
+"@SPINLOCK_LOCK_CUSTOM_WAIT",
+"@AGG_COUNT",
+"@AGG_HIST",
 };
 const char* OneOpFunc1[] = {
 "@POI",
@@ -720,6 +893,10 @@ const char* OneOpFunc1[] = {
 "@PHYSICAL_TO_VIRTUAL",
 "@VIRTUAL_TO_PHYSICAL",
 "@EVENT_SC",
+"@PERCPU_SUM",
+"@PERCPU_MIN",
+"@PERCPU_MAX",
+"@SCRATCH",
 };
 const char* OneOpFunc2[] = {
 "@PRINT",
@@ -729,6 +906,9 @@ const char* OneOpFunc2[] = {
 "@TEST_STATEMENT",
 "@SPINLOCK_LOCK",
 "@SPINLOCK_UNLOCK",
+"@AGG_PRINT",
+"@AGG_CLEAR",
+"@STACK",
 };
 const char* ZeroOpFunc1[] = {
 "@PAUSE",
@@ -784,10 +964,15 @@ const SYMBOL_MAP SemanticRulesMapList[]= {
 {"@TEST_STATEMENT", FUNC_TEST_STATEMENT},
 {"@SPINLOCK_LOCK", FUNC_SPINLOCK_LOCK},
 {"@SPINLOCK_UNLOCK", FUNC_SPINLOCK_UNLOCK},
+{"@AGG_PRINT", FUNC_AGG_PRINT},
+{"@AGG_CLEAR", FUNC_AGG_CLEAR},
+{"@STACK", FUNC_STACK},
 {"@PRINTF", FUNC_PRINTF},
 {"@PAUSE", FUNC_PAUSE},
 {"@FLUSH", FUNC_FLUSH},
 {"@SPINLOCK_LOCK_CUSTOM_WAIT", FUNC_SPINLOCK_LOCK_CUSTOM_WAIT},
+{"@AGG_COUNT", FUNC_AGG_COUNT},
+{"@AGG_HIST", FUNC_AGG_HIST},
 {"@POI", FUNC_POI},
 {"@DB", FUNC_DB},
 {"@DD", FUNC_DD},
@@ -809,13 +994,28 @@ const SYMBOL_MAP SemanticRulesMapList[]= {
 {"@PHYSICAL_TO_VIRTUAL", FUNC_PHYSICAL_TO_VIRTUAL},
 {"@VIRTUAL_TO_PHYSICAL", FUNC_VIRTUAL_TO_PHYSICAL},
 {"@EVENT_SC", FUNC_EVENT_SC},
+{"@PERCPU_SUM", FUNC_PERCPU_SUM},
+{"@PERCPU_MIN", FUNC_PERCPU_MIN},
+{"@PERCPU_MAX", FUNC_PERCPU_MAX},
+{"@SCRATCH", FUNC_SCRATCH},
 {"@ED", FUNC_ED},
 {"@EB", FUNC_EB},
 {"@EQ", FUNC_EQ},
 {"@INTERLOCKED_EXCHANGE", FUNC_INTERLOCKED_EXCHANGE},
 {"@INTERLOCKED_EXCHANGE_ADD", FUNC_INTERLOCKED_EXCHANGE_ADD},
+{"@STRCMP", FUNC_STRCMP},
+{"@WCSCMP", FUNC_WCSCMP},
+{"@STRICMP", FUNC_STRICMP},
 {"@INTERLOCKED_COMPARE_EXCHANGE", FUNC_INTERLOCKED_COMPARE_EXCHANGE},
 {"@MEMCPY", FUNC_MEMCPY},
+{"@AGG_SUM", FUNC_AGG_SUM},
+{"@AGG_MIN", FUNC_AGG_MIN},
+{"@AGG_MAX", FUNC_AGG_MAX},
+{"@MEMCMP", FUNC_MEMCMP},
+{"@MEMSET", FUNC_MEMSET},
+{"@MEMSEARCH", FUNC_MEMSEARCH},
+{"@EVENT_ADD_RANGE", FUNC_EVENT_ADD_RANGE},
+{"@EVENT_REMOVE_RANGE", FUNC_EVENT_REMOVE_RANGE},
 {"@POI", FUNC_POI},
 {"@DB", FUNC_DB},
 {"@DD", FUNC_DD},
@@ -837,13 +1037,28 @@ const SYMBOL_MAP SemanticRulesMapList[]= {
 {"@PHYSICAL_TO_VIRTUAL", FUNC_PHYSICAL_TO_VIRTUAL},
 {"@VIRTUAL_TO_PHYSICAL", FUNC_VIRTUAL_TO_PHYSICAL},
 {"@EVENT_SC", FUNC_EVENT_SC},
+{"@PERCPU_SUM", FUNC_PERCPU_SUM},
+{"@PERCPU_MIN", FUNC_PERCPU_MIN},
+{"@PERCPU_MAX", FUNC_PERCPU_MAX},
+{"@SCRATCH", FUNC_SCRATCH},
 {"@ED", FUNC_ED},
 {"@EB", FUNC_EB},
 {"@EQ", FUNC_EQ},
 {"@INTERLOCKED_EXCHANGE", FUNC_INTERLOCKED_EXCHANGE},
 {"@INTERLOCKED_EXCHANGE_ADD", FUNC_INTERLOCKED_EXCHANGE_ADD},
+{"@STRCMP", FUNC_STRCMP},
+{"@WCSCMP", FUNC_WCSCMP},
+{"@STRICMP", FUNC_STRICMP},
 {"@INTERLOCKED_COMPARE_EXCHANGE", FUNC_INTERLOCKED_COMPARE_EXCHANGE},
 {"@MEMCPY", FUNC_MEMCPY},
+{"@AGG_SUM", FUNC_AGG_SUM},
+{"@AGG_MIN", FUNC_AGG_MIN},
+{"@AGG_MAX", FUNC_AGG_MAX},
+{"@MEMCMP", FUNC_MEMCMP},
+{"@MEMSET", FUNC_MEMSET},
+{"@MEMSEARCH", FUNC_MEMSEARCH},
+{"@EVENT_ADD_RANGE", FUNC_EVENT_ADD_RANGE},
+{"@EVENT_REMOVE_RANGE", FUNC_EVENT_REMOVE_RANGE},
 };
 const SYMBOL_MAP RegisterMapList[]= {
 {"rax", REGISTER_RAX},
@@ -1200,82 +1415,82 @@ const unsigned int LalrRhsSize[RULES_COUNT]=
 };
 const char* LalrNoneTerminalMap[NONETERMINAL_COUNT]= 
 {
-"E4",
-"B6",
 "E5",
 "S",
-"B1",
-"B4",
 "EXP",
 "B5",
 "E3",
-"CMP",
+"BE",
+"E12",
 "B3",
+"E4",
+"B4",
+"B1",
+"B6",
 "E10",
-"E12",
-"BE",
-"B2"
+"B2",
+"CMP"
 };
 const char* LalrTerminalMap[TERMINAL_COUNT]= 
 {
-"low",
-"interlocked_exchange",
-"!=",
-"&",
-"eb",
+"+",
+"<=",
+"-",
+"~",
+"_decimal",
 "_octal",
-"<<",
-"wcslen",
-"|",
+"<",
+"interlocked_decrement",
+">>",
+"check_address",
 "%",
-">",
 "||",
-"ed",
-"_register",
-"neg",
 "^",
-"dq",
-"+",
-"interlocked_decrement",
-"(",
-"dw",
+"_hex",
+"_binary",
 ")",
+">",
+"dw",
+"eq",
+"_register",
+"|",
+"interlocked_exchange_add",
+"$",
+"eb",
+"wcslen",
+"_global_id",
 ">=",
-"_hex",
-"<=",
-"reference",
-"&&",
+"interlocked_exchange",
 "_pseudo_register",
-"_global_id",
-"eq",
-"<",
-"virtual_to_physical",
 "_local_id",
+"==",
 "*",
-"interlocked_exchange_add",
-"-",
-">>",
-"interlocked_increment",
-"$",
-"not",
-"strlen",
-"_binary",
-"~",
 "poi",
-"_decimal",
-"check_address",
+"neg",
+"&",
+"(",
 "hi",
+"ed",
+"!=",
+"dd",
+"interlocked_increment",
 "physical_to_virtual",
 "/",
-"==",
+"<<",
+"virtual_to_physical",
 "db",
-"dd",
+",",
+"low",
 "interlocked_compare_exchange",
-","
+"strlen",
+"not",
+"dq",
+"&&",
+"reference"
 };
 const int LalrGotoTable[LALR_STATE_COUNT][LALR_NONTERMINAL_COUNT]= 
 {
-	{12		,8		,13		,1		,3		,6		,10		,7		,11		,9		,5		,14		,15		,2		,4	},
+	{13		,1		,10		,7		,11		,2		,15		,5		,12		,6		,3		,8		,14		,4		,9	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
@@ -1294,7 +1509,6 @@ const int LalrGotoTable[LALR_STATE_COUNT][LALR_NONTERMINAL_COUNT]=
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,74		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
@@ -1304,77 +1518,78 @@ const int LalrGotoTable[LALR_STATE_COUNT][LALR_NONTERMINAL_COUNT]=
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,82		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,84		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{12		,8		,13		,-999		,3		,6		,10		,7		,11		,9		,5		,14		,15		,86		,4	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,88		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{13		,-999		,10		,7		,11		,81		,15		,5		,12		,6		,3		,8		,14		,4		,9	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,85		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,92		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,90		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,93		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,97		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,98		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{12		,8		,13		,-999		,100		,6		,10		,7		,11		,9		,5		,14		,15		,-999		,101	},
-	{12		,8		,13		,-999		,-999		,6		,10		,7		,11		,9		,102		,14		,15		,-999		,-999	},
-	{12		,8		,13		,-999		,-999		,103		,10		,7		,11		,9		,-999		,14		,15		,-999		,-999	},
-	{12		,8		,13		,-999		,-999		,-999		,10		,104		,11		,9		,-999		,14		,15		,-999		,-999	},
-	{12		,105		,13		,-999		,-999		,-999		,10		,-999		,11		,9		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,106		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,107		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,108		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,109		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,110		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,111		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{112		,-999		,13		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,14		,15		,-999		,-999	},
-	{113		,-999		,13		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,14		,15		,-999		,-999	},
-	{-999		,-999		,114		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,14		,15		,-999		,-999	},
-	{-999		,-999		,115		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,14		,15		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,116		,15		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,117		,15		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,118		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,119		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,120		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,121		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
+	{13		,-999		,10		,7		,11		,-999		,15		,100		,12		,6		,-999		,8		,14		,-999		,9	},
+	{13		,-999		,10		,7		,11		,-999		,15		,5		,12		,6		,101		,8		,14		,102		,9	},
+	{13		,-999		,10		,7		,11		,-999		,15		,-999		,12		,103		,-999		,8		,14		,-999		,9	},
+	{13		,-999		,10		,104		,11		,-999		,15		,-999		,12		,-999		,-999		,8		,14		,-999		,9	},
+	{13		,-999		,10		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,105		,14		,-999		,9	},
+	{13		,-999		,106		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,107		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,108		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,109		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,110		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,111		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,-999		,-999		,-999		,-999		,15		,-999		,112		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,-999		,-999		,-999		,-999		,15		,-999		,113		,-999		,-999		,-999		,14		,-999		,-999	},
+	{114		,-999		,-999		,-999		,-999		,-999		,15		,-999		,-999		,-999		,-999		,-999		,14		,-999		,-999	},
+	{115		,-999		,-999		,-999		,-999		,-999		,15		,-999		,-999		,-999		,-999		,-999		,14		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,15		,-999		,-999		,-999		,-999		,-999		,116		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,15		,-999		,-999		,-999		,-999		,-999		,117		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,15		,-999		,-999		,-999		,-999		,-999		,118		,-999		,-999	},
+	{13		,-999		,119		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,120		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,121		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,122		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,123		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,124		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,125		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,126		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,127		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,128		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,122		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,123		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,124		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,125		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,126		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,127		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,128		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
+	{13		,-999		,130		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,131		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,132		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,129		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
+	{13		,-999		,133		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,134		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,135		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,136		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,130		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
+	{13		,-999		,137		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,138		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,132		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
+	{13		,-999		,139		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,140		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,141		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,133		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,134		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,135		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,136		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,137		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,138		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,139		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,140		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,141		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,142		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
+	{13		,-999		,142		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
@@ -1418,28 +1633,28 @@ const int LalrGotoTable[LALR_STATE_COUNT][LALR_NONTERMINAL_COUNT]=
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,166		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{13		,-999		,166		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,167		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
+	{13		,-999		,167		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
+	{13		,-999		,168		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,168		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,169		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
+	{13		,-999		,169		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,170		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
+	{13		,-999		,170		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{13		,-999		,171		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,171		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
@@ -1448,8 +1663,8 @@ const int LalrGotoTable[LALR_STATE_COUNT][LALR_NONTERMINAL_COUNT]=
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{13		,-999		,178		,-999		,11		,-999		,15		,-999		,12		,-999		,-999		,-999		,14		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{12		,-999		,13		,-999		,-999		,-999		,178		,-999		,11		,-999		,-999		,14		,15		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
 	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
@@ -1458,186 +1673,186 @@ const int LalrGotoTable[LALR_STATE_COUNT][LALR_NONTERMINAL_COUNT]=
 };
 const int LalrActionTable[LALR_STATE_COUNT][LALR_TERMINAL_COUNT]= 
 {
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-1		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,53		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-2		,-999		,-999		,-999		,-999		,54		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-2		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-4		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-4		,-999		,-999		,-999		,-999		,-4		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-4		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,55		,-999		,-999		,-6		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-6		,-999		,-999		,-999		,-999		,-6		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-6		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-8		,-999		,-999		,-8		,-999		,-999		,-999		,56		,-999		,-999		,-999		,-999		,-999		,-8		,-999		,-999		,-999		,-999		,-8		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-8		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,57		,-999		,-999		,-999		,-999		,-10		,-999		,-999		,-10		,-999		,-999		,-999		,-10		,-999		,-999		,-999		,-999		,-999		,-10		,-999		,-999		,-999		,-999		,-10		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-10		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-12		,-999		,-999		,-999		,-999		,-12		,-999		,-999		,-12		,-999		,-999		,-999		,-12		,-999		,-999		,-999		,-999		,-999		,-12		,-999		,-999		,-999		,-999		,-12		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-12		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,61		,-13		,-999		,-999		,-999		,-999		,-13		,-999		,60		,-13		,-999		,-999		,-999		,-13		,-999		,-999		,-999		,-999		,-999		,-13		,62		,-999		,58		,-999		,-13		,-999		,-999		,-999		,59		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-13		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,63		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-20		,-20		,-999		,-999		,-999		,-999		,-20		,-999		,-20		,-20		,-999		,-999		,-999		,-20		,-999		,-999		,-999		,-999		,-999		,-20		,-20		,-999		,-20		,-999		,-20		,-999		,-999		,-999		,-20		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-20		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-20		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-21		,-21		,-999		,-999		,65		,-999		,-21		,-999		,-21		,-21		,-999		,-999		,-999		,-21		,-999		,-999		,-999		,-999		,-999		,-21		,-21		,-999		,-21		,-999		,-21		,-999		,-999		,-999		,-21		,-999		,-999		,-999		,-999		,-999		,64		,-999		,-21		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-21		,-999		,-999		,-999		,-21	},
-	{-999		,-999		,-24		,-24		,-999		,-999		,-24		,-999		,-24		,-999		,-24		,-24		,-999		,-999		,-999		,-24		,-999		,67		,-999		,-999		,-999		,-24		,-24		,-999		,-24		,-999		,-24		,-999		,-999		,-999		,-24		,-999		,-999		,-999		,-999		,66		,-24		,-999		,-24		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-24		,-999		,-999		,-999		,-24	},
-	{-999		,-999		,-27		,-27		,-999		,-999		,-27		,-999		,-27		,70		,-27		,-27		,-999		,-999		,-999		,-27		,-999		,-27		,-999		,-999		,-999		,-27		,-27		,-999		,-27		,-999		,-27		,-999		,-999		,-999		,-27		,-999		,-999		,69		,-999		,-27		,-27		,-999		,-27		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,68		,-27		,-999		,-999		,-999		,-27	},
-	{-999		,-999		,-31		,-31		,-999		,-999		,-31		,-999		,-31		,-31		,-31		,-31		,-999		,-999		,-999		,-31		,-999		,-31		,-999		,-999		,-999		,-31		,-31		,-999		,-31		,-999		,-31		,-999		,-999		,-999		,-31		,-999		,-999		,-31		,-999		,-31		,-31		,-999		,-31		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-31		,-31		,-999		,-999		,-999		,-31	},
-	{-999		,-999		,-32		,-32		,-999		,-999		,-32		,-999		,-32		,-32		,-32		,-32		,-999		,-999		,-999		,-32		,-999		,-32		,-999		,-999		,-999		,-32		,-32		,-999		,-32		,-999		,-32		,-999		,-999		,-999		,-32		,-999		,-999		,-32		,-999		,-32		,-32		,-999		,-32		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-32		,-32		,-999		,-999		,-999		,-32	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,71		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,72		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,73		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{47		,22		,-999		,-999		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,-999		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,-999		,41		,-999		,-999		,21		,-999		,27		,48		,24		,-999		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,75		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,76		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,77		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-65		,-65		,-999		,-999		,-65		,-999		,-65		,-65		,-65		,-65		,-999		,-999		,-999		,-65		,-999		,-65		,-999		,-999		,-999		,-65		,-65		,-999		,-65		,-999		,-65		,-999		,-999		,-999		,-65		,-999		,-999		,-65		,-999		,-65		,-65		,-999		,-65		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-65		,-65		,-999		,-999		,-999		,-65	},
-	{-999		,-999		,-68		,-68		,-999		,-999		,-68		,-999		,-68		,-68		,-68		,-68		,-999		,-999		,-999		,-68		,-999		,-68		,-999		,-999		,-999		,-68		,-68		,-999		,-68		,-999		,-68		,-999		,-999		,-999		,-68		,-999		,-999		,-68		,-999		,-68		,-68		,-999		,-68		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-68		,-68		,-999		,-999		,-999		,-68	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,78		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,79		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,80		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,81		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{47		,22		,-999		,-999		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,-999		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,-999		,41		,-999		,-999		,21		,-999		,27		,48		,24		,-999		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,83		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{47		,22		,-999		,-999		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,-999		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,-999		,41		,-999		,-999		,21		,-999		,27		,48		,24		,-999		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,85		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,87		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{47		,22		,-999		,-999		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,-999		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,-999		,41		,-999		,-999		,21		,-999		,27		,48		,24		,-999		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,89		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,90		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-64		,-64		,-999		,-999		,-64		,-999		,-64		,-64		,-64		,-64		,-999		,-999		,-999		,-64		,-999		,-64		,-999		,-999		,-999		,-64		,-64		,-999		,-64		,-999		,-64		,-999		,-999		,-999		,-64		,-999		,-999		,-64		,-999		,-64		,-64		,-999		,-64		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-64		,-64		,-999		,-999		,-999		,-64	},
-	{-999		,-999		,-63		,-63		,-999		,-999		,-63		,-999		,-63		,-63		,-63		,-63		,-999		,-999		,-999		,-63		,-999		,-63		,-999		,-999		,-999		,-63		,-63		,-999		,-63		,-999		,-63		,-999		,-999		,-999		,-63		,-999		,-999		,-63		,-999		,-63		,-63		,-999		,-63		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-63		,-63		,-999		,-999		,-999		,-63	},
-	{-999		,-999		,-69		,-69		,-999		,-999		,-69		,-999		,-69		,-69		,-69		,-69		,-999		,-999		,-999		,-69		,-999		,-69		,-999		,-999		,-999		,-69		,-69		,-999		,-69		,-999		,-69		,-999		,-999		,-999		,-69		,-999		,-999		,-69		,-999		,-69		,-69		,-999		,-69		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-69		,-69		,-999		,-999		,-999		,-69	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,91		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-62		,-62		,-999		,-999		,-62		,-999		,-62		,-62		,-62		,-62		,-999		,-999		,-999		,-62		,-999		,-62		,-999		,-999		,-999		,-62		,-62		,-999		,-62		,-999		,-62		,-999		,-999		,-999		,-62		,-999		,-999		,-62		,-999		,-62		,-62		,-999		,-62		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-62		,-62		,-999		,-999		,-999		,-62	},
-	{-999		,-999		,-67		,-67		,-999		,-999		,-67		,-999		,-67		,-67		,-67		,-67		,-999		,-999		,-999		,-67		,-999		,-67		,-999		,-999		,-999		,-67		,-67		,-999		,-67		,-999		,-67		,-999		,-999		,-999		,-67		,-999		,-999		,-67		,-999		,-67		,-67		,-999		,-67		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-67		,-67		,-999		,-999		,-999		,-67	},
-	{47		,22		,-999		,-999		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,-999		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,-999		,41		,-999		,-999		,21		,-999		,27		,48		,24		,-999		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-66		,-66		,-999		,-999		,-66		,-999		,-66		,-66		,-66		,-66		,-999		,-999		,-999		,-66		,-999		,-66		,-999		,-999		,-999		,-66		,-66		,-999		,-66		,-999		,-66		,-999		,-999		,-999		,-66		,-999		,-999		,-66		,-999		,-66		,-66		,-999		,-66		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-66		,-66		,-999		,-999		,-999		,-66	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,93		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,94		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,95		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,96		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,97		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,98		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,99		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-33		,-33		,-999		,-999		,-33		,-999		,-33		,-33		,-33		,-33		,-999		,-999		,-999		,-33		,-999		,-33		,-999		,-999		,-999		,-33		,-33		,-999		,-33		,-999		,-33		,-999		,-999		,-999		,-33		,-999		,-999		,-33		,-999		,-33		,-33		,-999		,-33		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-33		,-33		,-999		,-999		,-999		,-33	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-37		,-37		,-999		,-999		,-37		,-999		,-37		,-37		,-37		,-37		,-999		,-999		,-999		,-37		,-999		,-37		,-999		,-999		,-999		,-37		,-37		,-999		,-37		,-999		,-37		,-999		,-999		,-999		,-37		,-999		,-999		,-37		,-999		,-37		,-37		,-999		,-37		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-37		,-37		,-999		,-999		,-999		,-37	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-36		,-36		,-999		,-999		,-36		,-999		,-36		,-36		,-36		,-36		,-999		,-999		,-999		,-36		,-999		,-36		,-999		,-999		,-999		,-36		,-36		,-999		,-36		,-999		,-36		,-999		,-999		,-999		,-36		,-999		,-999		,-36		,-999		,-36		,-36		,-999		,-36		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-36		,-36		,-999		,-999		,-999		,-36	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,131		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-35		,-35		,-999		,-999		,-35		,-999		,-35		,-35		,-35		,-35		,-999		,-999		,-999		,-35		,-999		,-35		,-999		,-999		,-999		,-35		,-35		,-999		,-35		,-999		,-35		,-999		,-999		,-999		,-35		,-999		,-999		,-35		,-999		,-35		,-35		,-999		,-35		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-35		,-35		,-999		,-999		,-999		,-35	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-34		,-34		,-999		,-999		,-34		,-999		,-34		,-34		,-34		,-34		,-999		,-999		,-999		,-34		,-999		,-34		,-999		,-999		,-999		,-34		,-34		,-999		,-34		,-999		,-34		,-999		,-999		,-999		,-34		,-999		,-999		,-34		,-999		,-34		,-34		,-999		,-34		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-34		,-34		,-999		,-999		,-999		,-34	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,53		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,54		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-4		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-3		,-999		,-999		,-999		,-999		,-4		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-3		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,55		,-999		,-999		,-5		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-5		,-999		,-999		,-999		,-999		,-5		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-5		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-7		,-999		,-999		,-7		,-999		,-999		,-999		,56		,-999		,-999		,-999		,-999		,-999		,-7		,-999		,-999		,-999		,-999		,-7		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-7		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,57		,-999		,-999		,-999		,-999		,-9		,-999		,-999		,-9		,-999		,-999		,-999		,-9		,-999		,-999		,-999		,-999		,-999		,-9		,-999		,-999		,-999		,-999		,-9		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-9		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-11		,-999		,-999		,-999		,-999		,-11		,-999		,-999		,-11		,-999		,-999		,-999		,-11		,-999		,-999		,-999		,-999		,-999		,-11		,-999		,-999		,-999		,-999		,-11		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-11		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-17		,-17		,-999		,-999		,-999		,-999		,-17		,-999		,-17		,-17		,-999		,-999		,-999		,-17		,-999		,-999		,-999		,-999		,-999		,-17		,-17		,-999		,-17		,-999		,-17		,-999		,-999		,-999		,-17		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-17		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-17		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-15		,-15		,-999		,-999		,-999		,-999		,-15		,-999		,-15		,-15		,-999		,-999		,-999		,-15		,-999		,-999		,-999		,-999		,-999		,-15		,-15		,-999		,-15		,-999		,-15		,-999		,-999		,-999		,-15		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-15		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-15		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-14		,-14		,-999		,-999		,-999		,-999		,-14		,-999		,-14		,-14		,-999		,-999		,-999		,-14		,-999		,-999		,-999		,-999		,-999		,-14		,-14		,-999		,-14		,-999		,-14		,-999		,-999		,-999		,-14		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-14		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-14		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-19		,-19		,-999		,-999		,-999		,-999		,-19		,-999		,-19		,-19		,-999		,-999		,-999		,-19		,-999		,-999		,-999		,-999		,-999		,-19		,-19		,-999		,-19		,-999		,-19		,-999		,-999		,-999		,-19		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-19		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-19		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-16		,-16		,-999		,-999		,-999		,-999		,-16		,-999		,-16		,-16		,-999		,-999		,-999		,-16		,-999		,-999		,-999		,-999		,-999		,-16		,-16		,-999		,-16		,-999		,-16		,-999		,-999		,-999		,-16		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-16		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-16		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-18		,-18		,-999		,-999		,-999		,-999		,-18		,-999		,-18		,-18		,-999		,-999		,-999		,-18		,-999		,-999		,-999		,-999		,-999		,-18		,-18		,-999		,-18		,-999		,-18		,-999		,-999		,-999		,-18		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-18		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-18		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-22		,-22		,-999		,-999		,-22		,-999		,-22		,-999		,-22		,-22		,-999		,-999		,-999		,-22		,-999		,67		,-999		,-999		,-999		,-22		,-22		,-999		,-22		,-999		,-22		,-999		,-999		,-999		,-22		,-999		,-999		,-999		,-999		,66		,-22		,-999		,-22		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-22		,-999		,-999		,-999		,-22	},
-	{-999		,-999		,-23		,-23		,-999		,-999		,-23		,-999		,-23		,-999		,-23		,-23		,-999		,-999		,-999		,-23		,-999		,67		,-999		,-999		,-999		,-23		,-23		,-999		,-23		,-999		,-23		,-999		,-999		,-999		,-23		,-999		,-999		,-999		,-999		,66		,-23		,-999		,-23		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-23		,-999		,-999		,-999		,-23	},
-	{-999		,-999		,-26		,-26		,-999		,-999		,-26		,-999		,-26		,70		,-26		,-26		,-999		,-999		,-999		,-26		,-999		,-26		,-999		,-999		,-999		,-26		,-26		,-999		,-26		,-999		,-26		,-999		,-999		,-999		,-26		,-999		,-999		,69		,-999		,-26		,-26		,-999		,-26		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,68		,-26		,-999		,-999		,-999		,-26	},
-	{-999		,-999		,-25		,-25		,-999		,-999		,-25		,-999		,-25		,70		,-25		,-25		,-999		,-999		,-999		,-25		,-999		,-25		,-999		,-999		,-999		,-25		,-25		,-999		,-25		,-999		,-25		,-999		,-999		,-999		,-25		,-999		,-999		,69		,-999		,-25		,-25		,-999		,-25		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,68		,-25		,-999		,-999		,-999		,-25	},
-	{-999		,-999		,-28		,-28		,-999		,-999		,-28		,-999		,-28		,-28		,-28		,-28		,-999		,-999		,-999		,-28		,-999		,-28		,-999		,-999		,-999		,-28		,-28		,-999		,-28		,-999		,-28		,-999		,-999		,-999		,-28		,-999		,-999		,-28		,-999		,-28		,-28		,-999		,-28		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-28		,-28		,-999		,-999		,-999		,-28	},
-	{-999		,-999		,-30		,-30		,-999		,-999		,-30		,-999		,-30		,-30		,-30		,-30		,-999		,-999		,-999		,-30		,-999		,-30		,-999		,-999		,-999		,-30		,-30		,-999		,-30		,-999		,-30		,-999		,-999		,-999		,-30		,-999		,-999		,-30		,-999		,-30		,-30		,-999		,-30		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-30		,-30		,-999		,-999		,-999		,-30	},
-	{-999		,-999		,-29		,-29		,-999		,-999		,-29		,-999		,-29		,-29		,-29		,-29		,-999		,-999		,-999		,-29		,-999		,-29		,-999		,-999		,-999		,-29		,-29		,-999		,-29		,-999		,-29		,-999		,-999		,-999		,-29		,-999		,-999		,-29		,-999		,-29		,-29		,-999		,-29		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-29		,-29		,-999		,-999		,-999		,-29	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,143	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,144		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,145		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,146		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,147		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,148	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,149		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,150		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,151		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,152		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,153	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,154	},
-	{-999		,-999		,-61		,-61		,-999		,-999		,-61		,-999		,-61		,-61		,-61		,-61		,-999		,-999		,-999		,-61		,-999		,-61		,-999		,-999		,-999		,-61		,-61		,-999		,-61		,-999		,-61		,-999		,-999		,-999		,-61		,-999		,-999		,-61		,-999		,-61		,-61		,-999		,-61		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-61		,-61		,-999		,-999		,-999		,-61	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,155		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,156		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,157		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,158	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,159		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,160		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,161		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,162		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,163		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,164	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,165		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-41		,-41		,-999		,-999		,-41		,-999		,-41		,-41		,-41		,-41		,-999		,-999		,-999		,-41		,-999		,-41		,-999		,-999		,-999		,-41		,-41		,-999		,-41		,-999		,-41		,-999		,-999		,-999		,-41		,-999		,-999		,-41		,-999		,-41		,-41		,-999		,-41		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-41		,-41		,-999		,-999		,-999		,-41	},
-	{-999		,-999		,-49		,-49		,-999		,-999		,-49		,-999		,-49		,-49		,-49		,-49		,-999		,-999		,-999		,-49		,-999		,-49		,-999		,-999		,-999		,-49		,-49		,-999		,-49		,-999		,-49		,-999		,-999		,-999		,-49		,-999		,-999		,-49		,-999		,-49		,-49		,-999		,-49		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-49		,-49		,-999		,-999		,-999		,-49	},
-	{-999		,-999		,-38		,-38		,-999		,-999		,-38		,-999		,-38		,-38		,-38		,-38		,-999		,-999		,-999		,-38		,-999		,-38		,-999		,-999		,-999		,-38		,-38		,-999		,-38		,-999		,-38		,-999		,-999		,-999		,-38		,-999		,-999		,-38		,-999		,-38		,-38		,-999		,-38		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-38		,-38		,-999		,-999		,-999		,-38	},
-	{-999		,-999		,-50		,-50		,-999		,-999		,-50		,-999		,-50		,-50		,-50		,-50		,-999		,-999		,-999		,-50		,-999		,-50		,-999		,-999		,-999		,-50		,-50		,-999		,-50		,-999		,-50		,-999		,-999		,-999		,-50		,-999		,-999		,-50		,-999		,-50		,-50		,-999		,-50		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-50		,-50		,-999		,-999		,-999		,-50	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-47		,-47		,-999		,-999		,-47		,-999		,-47		,-47		,-47		,-47		,-999		,-999		,-999		,-47		,-999		,-47		,-999		,-999		,-999		,-47		,-47		,-999		,-47		,-999		,-47		,-999		,-999		,-999		,-47		,-999		,-999		,-47		,-999		,-47		,-47		,-999		,-47		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-47		,-47		,-999		,-999		,-999		,-47	},
-	{-999		,-999		,-44		,-44		,-999		,-999		,-44		,-999		,-44		,-44		,-44		,-44		,-999		,-999		,-999		,-44		,-999		,-44		,-999		,-999		,-999		,-44		,-44		,-999		,-44		,-999		,-44		,-999		,-999		,-999		,-44		,-999		,-999		,-44		,-999		,-44		,-44		,-999		,-44		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-44		,-44		,-999		,-999		,-999		,-44	},
-	{-999		,-999		,-46		,-46		,-999		,-999		,-46		,-999		,-46		,-46		,-46		,-46		,-999		,-999		,-999		,-46		,-999		,-46		,-999		,-999		,-999		,-46		,-46		,-999		,-46		,-999		,-46		,-999		,-999		,-999		,-46		,-999		,-999		,-46		,-999		,-46		,-46		,-999		,-46		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-46		,-46		,-999		,-999		,-999		,-46	},
-	{-999		,-999		,-54		,-54		,-999		,-999		,-54		,-999		,-54		,-54		,-54		,-54		,-999		,-999		,-999		,-54		,-999		,-54		,-999		,-999		,-999		,-54		,-54		,-999		,-54		,-999		,-54		,-999		,-999		,-999		,-54		,-999		,-999		,-54		,-999		,-54		,-54		,-999		,-54		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-54		,-54		,-999		,-999		,-999		,-54	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-39		,-39		,-999		,-999		,-39		,-999		,-39		,-39		,-39		,-39		,-999		,-999		,-999		,-39		,-999		,-39		,-999		,-999		,-999		,-39		,-39		,-999		,-39		,-999		,-39		,-999		,-999		,-999		,-39		,-999		,-999		,-39		,-999		,-39		,-39		,-999		,-39		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-39		,-39		,-999		,-999		,-999		,-39	},
-	{-999		,-999		,-42		,-42		,-999		,-999		,-42		,-999		,-42		,-42		,-42		,-42		,-999		,-999		,-999		,-42		,-999		,-42		,-999		,-999		,-999		,-42		,-42		,-999		,-42		,-999		,-42		,-999		,-999		,-999		,-42		,-999		,-999		,-42		,-999		,-42		,-42		,-999		,-42		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-42		,-42		,-999		,-999		,-999		,-42	},
-	{-999		,-999		,-52		,-52		,-999		,-999		,-52		,-999		,-52		,-52		,-52		,-52		,-999		,-999		,-999		,-52		,-999		,-52		,-999		,-999		,-999		,-52		,-52		,-999		,-52		,-999		,-52		,-999		,-999		,-999		,-52		,-999		,-999		,-52		,-999		,-52		,-52		,-999		,-52		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-52		,-52		,-999		,-999		,-999		,-52	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-43		,-43		,-999		,-999		,-43		,-999		,-43		,-43		,-43		,-43		,-999		,-999		,-999		,-43		,-999		,-43		,-999		,-999		,-999		,-43		,-43		,-999		,-43		,-999		,-43		,-999		,-999		,-999		,-43		,-999		,-999		,-43		,-999		,-43		,-43		,-999		,-43		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-43		,-43		,-999		,-999		,-999		,-43	},
-	{-999		,-999		,-45		,-45		,-999		,-999		,-45		,-999		,-45		,-45		,-45		,-45		,-999		,-999		,-999		,-45		,-999		,-45		,-999		,-999		,-999		,-45		,-45		,-999		,-45		,-999		,-45		,-999		,-999		,-999		,-45		,-999		,-999		,-45		,-999		,-45		,-45		,-999		,-45		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-45		,-45		,-999		,-999		,-999		,-45	},
-	{-999		,-999		,-48		,-48		,-999		,-999		,-48		,-999		,-48		,-48		,-48		,-48		,-999		,-999		,-999		,-48		,-999		,-48		,-999		,-999		,-999		,-48		,-48		,-999		,-48		,-999		,-48		,-999		,-999		,-999		,-48		,-999		,-999		,-48		,-999		,-48		,-48		,-999		,-48		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-48		,-48		,-999		,-999		,-999		,-48	},
-	{-999		,-999		,-40		,-40		,-999		,-999		,-40		,-999		,-40		,-40		,-40		,-40		,-999		,-999		,-999		,-40		,-999		,-40		,-999		,-999		,-999		,-40		,-40		,-999		,-40		,-999		,-40		,-999		,-999		,-999		,-40		,-999		,-999		,-40		,-999		,-40		,-40		,-999		,-40		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-40		,-40		,-999		,-999		,-999		,-40	},
-	{-999		,-999		,-51		,-51		,-999		,-999		,-51		,-999		,-51		,-51		,-51		,-51		,-999		,-999		,-999		,-51		,-999		,-51		,-999		,-999		,-999		,-51		,-51		,-999		,-51		,-999		,-51		,-999		,-999		,-999		,-51		,-999		,-999		,-51		,-999		,-51		,-51		,-999		,-51		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-51		,-51		,-999		,-999		,-999		,-51	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-53		,-53		,-999		,-999		,-53		,-999		,-53		,-53		,-53		,-53		,-999		,-999		,-999		,-53		,-999		,-53		,-999		,-999		,-999		,-53		,-53		,-999		,-53		,-999		,-53		,-999		,-999		,-999		,-53		,-999		,-999		,-53		,-999		,-53		,-53		,-999		,-53		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-53		,-53		,-999		,-999		,-999		,-53	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,172		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,173		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,174	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,175		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,176		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,177		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-56		,-56		,-999		,-999		,-56		,-999		,-56		,-56		,-56		,-56		,-999		,-999		,-999		,-56		,-999		,-56		,-999		,-999		,-999		,-56		,-56		,-999		,-56		,-999		,-56		,-999		,-999		,-999		,-56		,-999		,-999		,-56		,-999		,-56		,-56		,-999		,-56		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-56		,-56		,-999		,-999		,-999		,-56	},
-	{-999		,-999		,-58		,-58		,-999		,-999		,-58		,-999		,-58		,-58		,-58		,-58		,-999		,-999		,-999		,-58		,-999		,-58		,-999		,-999		,-999		,-58		,-58		,-999		,-58		,-999		,-58		,-999		,-999		,-999		,-58		,-999		,-999		,-58		,-999		,-58		,-58		,-999		,-58		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-58		,-58		,-999		,-999		,-999		,-58	},
-	{47		,22		,-999		,29		,16		,43		,-999		,18		,-999		,-999		,-999		,-999		,32		,42		,46		,-999		,36		,44		,50		,33		,17		,-999		,-999		,23		,-999		,37		,-999		,40		,39		,51		,-999		,28		,38		,31		,41		,19		,-999		,21		,-999		,27		,48		,24		,35		,20		,45		,25		,26		,52		,-999		,-999		,34		,49		,30		,-999	},
-	{-999		,-999		,-55		,-55		,-999		,-999		,-55		,-999		,-55		,-55		,-55		,-55		,-999		,-999		,-999		,-55		,-999		,-55		,-999		,-999		,-999		,-55		,-55		,-999		,-55		,-999		,-55		,-999		,-999		,-999		,-55		,-999		,-999		,-55		,-999		,-55		,-55		,-999		,-55		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-55		,-55		,-999		,-999		,-999		,-55	},
-	{-999		,-999		,-59		,-59		,-999		,-999		,-59		,-999		,-59		,-59		,-59		,-59		,-999		,-999		,-999		,-59		,-999		,-59		,-999		,-999		,-999		,-59		,-59		,-999		,-59		,-999		,-59		,-999		,-999		,-999		,-59		,-999		,-999		,-59		,-999		,-59		,-59		,-999		,-59		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-59		,-59		,-999		,-999		,-999		,-59	},
-	{-999		,-999		,-57		,-57		,-999		,-999		,-57		,-999		,-57		,-57		,-57		,-57		,-999		,-999		,-999		,-57		,-999		,-57		,-999		,-999		,-999		,-57		,-57		,-999		,-57		,-999		,-57		,-999		,-999		,-999		,-57		,-999		,-999		,-57		,-999		,-57		,-57		,-999		,-57		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-57		,-57		,-999		,-999		,-999		,-57	},
-	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,179		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
-	{-999		,-999		,-60		,-60		,-999		,-999		,-60		,-999		,-60		,-60		,-60		,-60		,-999		,-999		,-999		,-60		,-999		,-60		,-999		,-999		,-999		,-60		,-60		,-999		,-60		,-999		,-60		,-999		,-999		,-999		,-60		,-999		,-999		,-60		,-999		,-60		,-60		,-999		,-60		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-60		,-60		,-999		,-999		,-999		,-60	}
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-1		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,54		,-999		,-999		,-999		,-2		,-999		,-999		,-999		,-999		,-999		,-999		,-2		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,53		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-4		,-999		,-999		,-999		,-4		,-999		,-999		,-999		,-999		,-999		,-999		,-4		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-4		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-6		,-999		,-999		,-999		,-6		,-999		,-999		,-999		,-999		,55		,-999		,-6		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-6		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-8		,56		,-999		,-999		,-8		,-999		,-999		,-999		,-999		,-8		,-999		,-8		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-8		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-10		,-10		,-999		,-999		,-10		,-999		,-999		,-999		,-999		,-10		,-999		,-10		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,57		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-10		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-12		,-12		,-999		,-999		,-12		,-999		,-999		,-999		,-999		,-12		,-999		,-12		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-12		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-12		,-999	},
+	{-999		,58		,-999		,-999		,-999		,-999		,63		,-999		,-999		,-999		,-999		,-13		,-13		,-999		,-999		,-13		,61		,-999		,-999		,-999		,-13		,-999		,-13		,-999		,-999		,-999		,62		,-999		,-999		,-999		,60		,-999		,-999		,-999		,-13		,-999		,-999		,-999		,59		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-13		,-999	},
+	{-999		,-20		,-999		,-999		,-999		,-999		,-20		,-999		,-999		,-999		,-999		,-20		,-20		,-999		,-999		,-20		,-20		,-999		,-999		,-999		,-20		,-999		,-20		,-999		,-999		,-999		,-20		,-999		,-999		,-999		,-20		,-999		,-999		,-999		,-20		,-999		,-999		,-999		,-20		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-20		,-999	},
+	{-999		,-21		,-999		,-999		,-999		,-999		,-21		,-999		,65		,-999		,-999		,-21		,-21		,-999		,-999		,-21		,-21		,-999		,-999		,-999		,-21		,-999		,-21		,-999		,-999		,-999		,-21		,-999		,-999		,-999		,-21		,-999		,-999		,-999		,-21		,-999		,-999		,-999		,-21		,-999		,-999		,-999		,-999		,64		,-999		,-999		,-21		,-999		,-999		,-999		,-999		,-999		,-21		,-999	},
+	{67		,-24		,66		,-999		,-999		,-999		,-24		,-999		,-24		,-999		,-999		,-24		,-24		,-999		,-999		,-24		,-24		,-999		,-999		,-999		,-24		,-999		,-24		,-999		,-999		,-999		,-24		,-999		,-999		,-999		,-24		,-999		,-999		,-999		,-24		,-999		,-999		,-999		,-24		,-999		,-999		,-999		,-999		,-24		,-999		,-999		,-24		,-999		,-999		,-999		,-999		,-999		,-24		,-999	},
+	{-27		,-27		,-27		,-999		,-999		,-999		,-27		,-999		,-27		,-999		,69		,-27		,-27		,-999		,-999		,-27		,-27		,-999		,-999		,-999		,-27		,-999		,-27		,-999		,-999		,-999		,-27		,-999		,-999		,-999		,-27		,70		,-999		,-999		,-27		,-999		,-999		,-999		,-27		,-999		,-999		,-999		,68		,-27		,-999		,-999		,-27		,-999		,-999		,-999		,-999		,-999		,-27		,-999	},
+	{-31		,-31		,-31		,-999		,-999		,-999		,-31		,-999		,-31		,-999		,-31		,-31		,-31		,-999		,-999		,-31		,-31		,-999		,-999		,-999		,-31		,-999		,-31		,-999		,-999		,-999		,-31		,-999		,-999		,-999		,-31		,-31		,-999		,-999		,-31		,-999		,-999		,-999		,-31		,-999		,-999		,-999		,-31		,-31		,-999		,-999		,-31		,-999		,-999		,-999		,-999		,-999		,-31		,-999	},
+	{-32		,-32		,-32		,-999		,-999		,-999		,-32		,-999		,-32		,-999		,-32		,-32		,-32		,-999		,-999		,-32		,-32		,-999		,-999		,-999		,-32		,-999		,-32		,-999		,-999		,-999		,-32		,-999		,-999		,-999		,-32		,-32		,-999		,-999		,-32		,-999		,-999		,-999		,-32		,-999		,-999		,-999		,-32		,-32		,-999		,-999		,-32		,-999		,-999		,-999		,-999		,-999		,-32		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,71		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,72		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-66		,-66		,-66		,-999		,-999		,-999		,-66		,-999		,-66		,-999		,-66		,-66		,-66		,-999		,-999		,-66		,-66		,-999		,-999		,-999		,-66		,-999		,-66		,-999		,-999		,-999		,-66		,-999		,-999		,-999		,-66		,-66		,-999		,-999		,-66		,-999		,-999		,-999		,-66		,-999		,-999		,-999		,-66		,-66		,-999		,-999		,-66		,-999		,-999		,-999		,-999		,-999		,-66		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,73		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,74		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,75		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-63		,-63		,-63		,-999		,-999		,-999		,-63		,-999		,-63		,-999		,-63		,-63		,-63		,-999		,-999		,-63		,-63		,-999		,-999		,-999		,-63		,-999		,-63		,-999		,-999		,-999		,-63		,-999		,-999		,-999		,-63		,-63		,-999		,-999		,-63		,-999		,-999		,-999		,-63		,-999		,-999		,-999		,-63		,-63		,-999		,-999		,-63		,-999		,-999		,-999		,-999		,-999		,-63		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,76		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-62		,-62		,-62		,-999		,-999		,-999		,-62		,-999		,-62		,-999		,-62		,-62		,-62		,-999		,-999		,-62		,-62		,-999		,-999		,-999		,-62		,-999		,-62		,-999		,-999		,-999		,-62		,-999		,-999		,-999		,-62		,-62		,-999		,-999		,-62		,-999		,-999		,-999		,-62		,-999		,-999		,-999		,-62		,-62		,-999		,-999		,-62		,-999		,-999		,-999		,-999		,-999		,-62		,-999	},
+	{-67		,-67		,-67		,-999		,-999		,-999		,-67		,-999		,-67		,-999		,-67		,-67		,-67		,-999		,-999		,-67		,-67		,-999		,-999		,-999		,-67		,-999		,-67		,-999		,-999		,-999		,-67		,-999		,-999		,-999		,-67		,-67		,-999		,-999		,-67		,-999		,-999		,-999		,-67		,-999		,-999		,-999		,-67		,-67		,-999		,-999		,-67		,-999		,-999		,-999		,-999		,-999		,-67		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,77		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,78		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,79		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-64		,-64		,-64		,-999		,-999		,-999		,-64		,-999		,-64		,-999		,-64		,-64		,-64		,-999		,-999		,-64		,-64		,-999		,-999		,-999		,-64		,-999		,-64		,-999		,-999		,-999		,-64		,-999		,-999		,-999		,-64		,-64		,-999		,-999		,-64		,-999		,-999		,-999		,-64		,-999		,-999		,-999		,-64		,-64		,-999		,-999		,-64		,-999		,-999		,-999		,-999		,-999		,-64		,-999	},
+	{-68		,-68		,-68		,-999		,-999		,-999		,-68		,-999		,-68		,-999		,-68		,-68		,-68		,-999		,-999		,-68		,-68		,-999		,-999		,-999		,-68		,-999		,-68		,-999		,-999		,-999		,-68		,-999		,-999		,-999		,-68		,-68		,-999		,-999		,-68		,-999		,-999		,-999		,-68		,-999		,-999		,-999		,-68		,-68		,-999		,-999		,-68		,-999		,-999		,-999		,-999		,-999		,-68		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,80		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,82		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,83		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-69		,-69		,-69		,-999		,-999		,-999		,-69		,-999		,-69		,-999		,-69		,-69		,-69		,-999		,-999		,-69		,-69		,-999		,-999		,-999		,-69		,-999		,-69		,-999		,-999		,-999		,-69		,-999		,-999		,-999		,-69		,-69		,-999		,-999		,-69		,-999		,-999		,-999		,-69		,-999		,-999		,-999		,-69		,-69		,-999		,-999		,-69		,-999		,-999		,-999		,-999		,-999		,-69		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,84		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-65		,-65		,-65		,-999		,-999		,-999		,-65		,-999		,-65		,-999		,-65		,-65		,-65		,-999		,-999		,-65		,-65		,-999		,-999		,-999		,-65		,-999		,-65		,-999		,-999		,-999		,-65		,-999		,-999		,-999		,-65		,-65		,-999		,-999		,-65		,-999		,-999		,-999		,-65		,-999		,-999		,-999		,-65		,-65		,-999		,-999		,-65		,-999		,-999		,-999		,-999		,-999		,-65		,-999	},
+	{-999		,-999		,-999		,-999		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,-999		,42		,33		,-999		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,86		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,87		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,88		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,89		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,-999		,42		,33		,-999		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,91		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,92		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,-999		,42		,33		,-999		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,94		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,95		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,96		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,-999		,42		,33		,-999		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-999		,-999		,-999		,-999		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,-999		,42		,33		,-999		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,99		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,129		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-33		,-33		,-33		,-999		,-999		,-999		,-33		,-999		,-33		,-999		,-33		,-33		,-33		,-999		,-999		,-33		,-33		,-999		,-999		,-999		,-33		,-999		,-33		,-999		,-999		,-999		,-33		,-999		,-999		,-999		,-33		,-33		,-999		,-999		,-33		,-999		,-999		,-999		,-33		,-999		,-999		,-999		,-33		,-33		,-999		,-999		,-33		,-999		,-999		,-999		,-999		,-999		,-33		,-999	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-37		,-37		,-37		,-999		,-999		,-999		,-37		,-999		,-37		,-999		,-37		,-37		,-37		,-999		,-999		,-37		,-37		,-999		,-999		,-999		,-37		,-999		,-37		,-999		,-999		,-999		,-37		,-999		,-999		,-999		,-37		,-37		,-999		,-999		,-37		,-999		,-999		,-999		,-37		,-999		,-999		,-999		,-37		,-37		,-999		,-999		,-37		,-999		,-999		,-999		,-999		,-999		,-37		,-999	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-35		,-35		,-35		,-999		,-999		,-999		,-35		,-999		,-35		,-999		,-35		,-35		,-35		,-999		,-999		,-35		,-35		,-999		,-999		,-999		,-35		,-999		,-35		,-999		,-999		,-999		,-35		,-999		,-999		,-999		,-35		,-35		,-999		,-999		,-35		,-999		,-999		,-999		,-35		,-999		,-999		,-999		,-35		,-35		,-999		,-999		,-35		,-999		,-999		,-999		,-999		,-999		,-35		,-999	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-34		,-34		,-34		,-999		,-999		,-999		,-34		,-999		,-34		,-999		,-34		,-34		,-34		,-999		,-999		,-34		,-34		,-999		,-999		,-999		,-34		,-999		,-34		,-999		,-999		,-999		,-34		,-999		,-999		,-999		,-34		,-34		,-999		,-999		,-34		,-999		,-999		,-999		,-34		,-999		,-999		,-999		,-34		,-34		,-999		,-999		,-34		,-999		,-999		,-999		,-999		,-999		,-34		,-999	},
+	{-36		,-36		,-36		,-999		,-999		,-999		,-36		,-999		,-36		,-999		,-36		,-36		,-36		,-999		,-999		,-36		,-36		,-999		,-999		,-999		,-36		,-999		,-36		,-999		,-999		,-999		,-36		,-999		,-999		,-999		,-36		,-36		,-999		,-999		,-36		,-999		,-999		,-999		,-36		,-999		,-999		,-999		,-36		,-36		,-999		,-999		,-36		,-999		,-999		,-999		,-999		,-999		,-36		,-999	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-5		,-999		,-999		,-999		,-5		,-999		,-999		,-999		,-999		,55		,-999		,-5		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-5		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,54		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,53		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-4		,-999		,-999		,-999		,-3		,-999		,-999		,-999		,-999		,-999		,-999		,-3		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-4		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-7		,56		,-999		,-999		,-7		,-999		,-999		,-999		,-999		,-7		,-999		,-7		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-7		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-9		,-9		,-999		,-999		,-9		,-999		,-999		,-999		,-999		,-9		,-999		,-9		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,57		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-9		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-11		,-11		,-999		,-999		,-11		,-999		,-999		,-999		,-999		,-11		,-999		,-11		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-11		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-11		,-999	},
+	{-999		,-17		,-999		,-999		,-999		,-999		,-17		,-999		,-999		,-999		,-999		,-17		,-17		,-999		,-999		,-17		,-17		,-999		,-999		,-999		,-17		,-999		,-17		,-999		,-999		,-999		,-17		,-999		,-999		,-999		,-17		,-999		,-999		,-999		,-17		,-999		,-999		,-999		,-17		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-17		,-999	},
+	{-999		,-19		,-999		,-999		,-999		,-999		,-19		,-999		,-999		,-999		,-999		,-19		,-19		,-999		,-999		,-19		,-19		,-999		,-999		,-999		,-19		,-999		,-19		,-999		,-999		,-999		,-19		,-999		,-999		,-999		,-19		,-999		,-999		,-999		,-19		,-999		,-999		,-999		,-19		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-19		,-999	},
+	{-999		,-18		,-999		,-999		,-999		,-999		,-18		,-999		,-999		,-999		,-999		,-18		,-18		,-999		,-999		,-18		,-18		,-999		,-999		,-999		,-18		,-999		,-18		,-999		,-999		,-999		,-18		,-999		,-999		,-999		,-18		,-999		,-999		,-999		,-18		,-999		,-999		,-999		,-18		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-18		,-999	},
+	{-999		,-14		,-999		,-999		,-999		,-999		,-14		,-999		,-999		,-999		,-999		,-14		,-14		,-999		,-999		,-14		,-14		,-999		,-999		,-999		,-14		,-999		,-14		,-999		,-999		,-999		,-14		,-999		,-999		,-999		,-14		,-999		,-999		,-999		,-14		,-999		,-999		,-999		,-14		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-14		,-999	},
+	{-999		,-16		,-999		,-999		,-999		,-999		,-16		,-999		,-999		,-999		,-999		,-16		,-16		,-999		,-999		,-16		,-16		,-999		,-999		,-999		,-16		,-999		,-16		,-999		,-999		,-999		,-16		,-999		,-999		,-999		,-16		,-999		,-999		,-999		,-16		,-999		,-999		,-999		,-16		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-16		,-999	},
+	{-999		,-15		,-999		,-999		,-999		,-999		,-15		,-999		,-999		,-999		,-999		,-15		,-15		,-999		,-999		,-15		,-15		,-999		,-999		,-999		,-15		,-999		,-15		,-999		,-999		,-999		,-15		,-999		,-999		,-999		,-15		,-999		,-999		,-999		,-15		,-999		,-999		,-999		,-15		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-15		,-999	},
+	{67		,-23		,66		,-999		,-999		,-999		,-23		,-999		,-23		,-999		,-999		,-23		,-23		,-999		,-999		,-23		,-23		,-999		,-999		,-999		,-23		,-999		,-23		,-999		,-999		,-999		,-23		,-999		,-999		,-999		,-23		,-999		,-999		,-999		,-23		,-999		,-999		,-999		,-23		,-999		,-999		,-999		,-999		,-23		,-999		,-999		,-23		,-999		,-999		,-999		,-999		,-999		,-23		,-999	},
+	{67		,-22		,66		,-999		,-999		,-999		,-22		,-999		,-22		,-999		,-999		,-22		,-22		,-999		,-999		,-22		,-22		,-999		,-999		,-999		,-22		,-999		,-22		,-999		,-999		,-999		,-22		,-999		,-999		,-999		,-22		,-999		,-999		,-999		,-22		,-999		,-999		,-999		,-22		,-999		,-999		,-999		,-999		,-22		,-999		,-999		,-22		,-999		,-999		,-999		,-999		,-999		,-22		,-999	},
+	{-26		,-26		,-26		,-999		,-999		,-999		,-26		,-999		,-26		,-999		,69		,-26		,-26		,-999		,-999		,-26		,-26		,-999		,-999		,-999		,-26		,-999		,-26		,-999		,-999		,-999		,-26		,-999		,-999		,-999		,-26		,70		,-999		,-999		,-26		,-999		,-999		,-999		,-26		,-999		,-999		,-999		,68		,-26		,-999		,-999		,-26		,-999		,-999		,-999		,-999		,-999		,-26		,-999	},
+	{-25		,-25		,-25		,-999		,-999		,-999		,-25		,-999		,-25		,-999		,69		,-25		,-25		,-999		,-999		,-25		,-25		,-999		,-999		,-999		,-25		,-999		,-25		,-999		,-999		,-999		,-25		,-999		,-999		,-999		,-25		,70		,-999		,-999		,-25		,-999		,-999		,-999		,-25		,-999		,-999		,-999		,68		,-25		,-999		,-999		,-25		,-999		,-999		,-999		,-999		,-999		,-25		,-999	},
+	{-28		,-28		,-28		,-999		,-999		,-999		,-28		,-999		,-28		,-999		,-28		,-28		,-28		,-999		,-999		,-28		,-28		,-999		,-999		,-999		,-28		,-999		,-28		,-999		,-999		,-999		,-28		,-999		,-999		,-999		,-28		,-28		,-999		,-999		,-28		,-999		,-999		,-999		,-28		,-999		,-999		,-999		,-28		,-28		,-999		,-999		,-28		,-999		,-999		,-999		,-999		,-999		,-28		,-999	},
+	{-29		,-29		,-29		,-999		,-999		,-999		,-29		,-999		,-29		,-999		,-29		,-29		,-29		,-999		,-999		,-29		,-29		,-999		,-999		,-999		,-29		,-999		,-29		,-999		,-999		,-999		,-29		,-999		,-999		,-999		,-29		,-29		,-999		,-999		,-29		,-999		,-999		,-999		,-29		,-999		,-999		,-999		,-29		,-29		,-999		,-999		,-29		,-999		,-999		,-999		,-999		,-999		,-29		,-999	},
+	{-30		,-30		,-30		,-999		,-999		,-999		,-30		,-999		,-30		,-999		,-30		,-30		,-30		,-999		,-999		,-30		,-30		,-999		,-999		,-999		,-30		,-999		,-30		,-999		,-999		,-999		,-30		,-999		,-999		,-999		,-30		,-30		,-999		,-999		,-30		,-999		,-999		,-999		,-30		,-999		,-999		,-999		,-30		,-30		,-999		,-999		,-30		,-999		,-999		,-999		,-999		,-999		,-30		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,143		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,144		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,145		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,146		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,147		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,148		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,149		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,150		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,151		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,152		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-61		,-61		,-61		,-999		,-999		,-999		,-61		,-999		,-61		,-999		,-61		,-61		,-61		,-999		,-999		,-61		,-61		,-999		,-999		,-999		,-61		,-999		,-61		,-999		,-999		,-999		,-61		,-999		,-999		,-999		,-61		,-61		,-999		,-999		,-61		,-999		,-999		,-999		,-61		,-999		,-999		,-999		,-61		,-61		,-999		,-999		,-61		,-999		,-999		,-999		,-999		,-999		,-61		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,153		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,154		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,155		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,156		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,157		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,158		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,159		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,160		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,161		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,162		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,163		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,164		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,165		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-45		,-45		,-45		,-999		,-999		,-999		,-45		,-999		,-45		,-999		,-45		,-45		,-45		,-999		,-999		,-45		,-45		,-999		,-999		,-999		,-45		,-999		,-45		,-999		,-999		,-999		,-45		,-999		,-999		,-999		,-45		,-45		,-999		,-999		,-45		,-999		,-999		,-999		,-45		,-999		,-999		,-999		,-45		,-45		,-999		,-999		,-45		,-999		,-999		,-999		,-999		,-999		,-45		,-999	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-49		,-49		,-49		,-999		,-999		,-999		,-49		,-999		,-49		,-999		,-49		,-49		,-49		,-999		,-999		,-49		,-49		,-999		,-999		,-999		,-49		,-999		,-49		,-999		,-999		,-999		,-49		,-999		,-999		,-999		,-49		,-49		,-999		,-999		,-49		,-999		,-999		,-999		,-49		,-999		,-999		,-999		,-49		,-49		,-999		,-999		,-49		,-999		,-999		,-999		,-999		,-999		,-49		,-999	},
+	{-40		,-40		,-40		,-999		,-999		,-999		,-40		,-999		,-40		,-999		,-40		,-40		,-40		,-999		,-999		,-40		,-40		,-999		,-999		,-999		,-40		,-999		,-40		,-999		,-999		,-999		,-40		,-999		,-999		,-999		,-40		,-40		,-999		,-999		,-40		,-999		,-999		,-999		,-40		,-999		,-999		,-999		,-40		,-40		,-999		,-999		,-40		,-999		,-999		,-999		,-999		,-999		,-40		,-999	},
+	{-47		,-47		,-47		,-999		,-999		,-999		,-47		,-999		,-47		,-999		,-47		,-47		,-47		,-999		,-999		,-47		,-47		,-999		,-999		,-999		,-47		,-999		,-47		,-999		,-999		,-999		,-47		,-999		,-999		,-999		,-47		,-47		,-999		,-999		,-47		,-999		,-999		,-999		,-47		,-999		,-999		,-999		,-47		,-47		,-999		,-999		,-47		,-999		,-999		,-999		,-999		,-999		,-47		,-999	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-51		,-51		,-51		,-999		,-999		,-999		,-51		,-999		,-51		,-999		,-51		,-51		,-51		,-999		,-999		,-51		,-51		,-999		,-999		,-999		,-51		,-999		,-51		,-999		,-999		,-999		,-51		,-999		,-999		,-999		,-51		,-51		,-999		,-999		,-51		,-999		,-999		,-999		,-51		,-999		,-999		,-999		,-51		,-51		,-999		,-999		,-51		,-999		,-999		,-999		,-999		,-999		,-51		,-999	},
+	{-48		,-48		,-48		,-999		,-999		,-999		,-48		,-999		,-48		,-999		,-48		,-48		,-48		,-999		,-999		,-48		,-48		,-999		,-999		,-999		,-48		,-999		,-48		,-999		,-999		,-999		,-48		,-999		,-999		,-999		,-48		,-48		,-999		,-999		,-48		,-999		,-999		,-999		,-48		,-999		,-999		,-999		,-48		,-48		,-999		,-999		,-48		,-999		,-999		,-999		,-999		,-999		,-48		,-999	},
+	{-41		,-41		,-41		,-999		,-999		,-999		,-41		,-999		,-41		,-999		,-41		,-41		,-41		,-999		,-999		,-41		,-41		,-999		,-999		,-999		,-41		,-999		,-41		,-999		,-999		,-999		,-41		,-999		,-999		,-999		,-41		,-41		,-999		,-999		,-41		,-999		,-999		,-999		,-41		,-999		,-999		,-999		,-41		,-41		,-999		,-999		,-41		,-999		,-999		,-999		,-999		,-999		,-41		,-999	},
+	{-43		,-43		,-43		,-999		,-999		,-999		,-43		,-999		,-43		,-999		,-43		,-43		,-43		,-999		,-999		,-43		,-43		,-999		,-999		,-999		,-43		,-999		,-43		,-999		,-999		,-999		,-43		,-999		,-999		,-999		,-43		,-43		,-999		,-999		,-43		,-999		,-999		,-999		,-43		,-999		,-999		,-999		,-43		,-43		,-999		,-999		,-43		,-999		,-999		,-999		,-999		,-999		,-43		,-999	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-54		,-54		,-54		,-999		,-999		,-999		,-54		,-999		,-54		,-999		,-54		,-54		,-54		,-999		,-999		,-54		,-54		,-999		,-999		,-999		,-54		,-999		,-54		,-999		,-999		,-999		,-54		,-999		,-999		,-999		,-54		,-54		,-999		,-999		,-54		,-999		,-999		,-999		,-54		,-999		,-999		,-999		,-54		,-54		,-999		,-999		,-54		,-999		,-999		,-999		,-999		,-999		,-54		,-999	},
+	{-52		,-52		,-52		,-999		,-999		,-999		,-52		,-999		,-52		,-999		,-52		,-52		,-52		,-999		,-999		,-52		,-52		,-999		,-999		,-999		,-52		,-999		,-52		,-999		,-999		,-999		,-52		,-999		,-999		,-999		,-52		,-52		,-999		,-999		,-52		,-999		,-999		,-999		,-52		,-999		,-999		,-999		,-52		,-52		,-999		,-999		,-52		,-999		,-999		,-999		,-999		,-999		,-52		,-999	},
+	{-39		,-39		,-39		,-999		,-999		,-999		,-39		,-999		,-39		,-999		,-39		,-39		,-39		,-999		,-999		,-39		,-39		,-999		,-999		,-999		,-39		,-999		,-39		,-999		,-999		,-999		,-39		,-999		,-999		,-999		,-39		,-39		,-999		,-999		,-39		,-999		,-999		,-999		,-39		,-999		,-999		,-999		,-39		,-39		,-999		,-999		,-39		,-999		,-999		,-999		,-999		,-999		,-39		,-999	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-38		,-38		,-38		,-999		,-999		,-999		,-38		,-999		,-38		,-999		,-38		,-38		,-38		,-999		,-999		,-38		,-38		,-999		,-999		,-999		,-38		,-999		,-38		,-999		,-999		,-999		,-38		,-999		,-999		,-999		,-38		,-38		,-999		,-999		,-38		,-999		,-999		,-999		,-38		,-999		,-999		,-999		,-38		,-38		,-999		,-999		,-38		,-999		,-999		,-999		,-999		,-999		,-38		,-999	},
+	{-42		,-42		,-42		,-999		,-999		,-999		,-42		,-999		,-42		,-999		,-42		,-42		,-42		,-999		,-999		,-42		,-42		,-999		,-999		,-999		,-42		,-999		,-42		,-999		,-999		,-999		,-42		,-999		,-999		,-999		,-42		,-42		,-999		,-999		,-42		,-999		,-999		,-999		,-42		,-999		,-999		,-999		,-42		,-42		,-999		,-999		,-42		,-999		,-999		,-999		,-999		,-999		,-42		,-999	},
+	{-44		,-44		,-44		,-999		,-999		,-999		,-44		,-999		,-44		,-999		,-44		,-44		,-44		,-999		,-999		,-44		,-44		,-999		,-999		,-999		,-44		,-999		,-44		,-999		,-999		,-999		,-44		,-999		,-999		,-999		,-44		,-44		,-999		,-999		,-44		,-999		,-999		,-999		,-44		,-999		,-999		,-999		,-44		,-44		,-999		,-999		,-44		,-999		,-999		,-999		,-999		,-999		,-44		,-999	},
+	{-46		,-46		,-46		,-999		,-999		,-999		,-46		,-999		,-46		,-999		,-46		,-46		,-46		,-999		,-999		,-46		,-46		,-999		,-999		,-999		,-46		,-999		,-46		,-999		,-999		,-999		,-46		,-999		,-999		,-999		,-46		,-46		,-999		,-999		,-46		,-999		,-999		,-999		,-46		,-999		,-999		,-999		,-46		,-46		,-999		,-999		,-46		,-999		,-999		,-999		,-999		,-999		,-46		,-999	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-53		,-53		,-53		,-999		,-999		,-999		,-53		,-999		,-53		,-999		,-53		,-53		,-53		,-999		,-999		,-53		,-53		,-999		,-999		,-999		,-53		,-999		,-53		,-999		,-999		,-999		,-53		,-999		,-999		,-999		,-53		,-53		,-999		,-999		,-53		,-999		,-999		,-999		,-53		,-999		,-999		,-999		,-53		,-53		,-999		,-999		,-53		,-999		,-999		,-999		,-999		,-999		,-53		,-999	},
+	{-50		,-50		,-50		,-999		,-999		,-999		,-50		,-999		,-50		,-999		,-50		,-50		,-50		,-999		,-999		,-50		,-50		,-999		,-999		,-999		,-50		,-999		,-50		,-999		,-999		,-999		,-50		,-999		,-999		,-999		,-50		,-50		,-999		,-999		,-50		,-999		,-999		,-999		,-50		,-999		,-999		,-999		,-50		,-50		,-999		,-999		,-50		,-999		,-999		,-999		,-999		,-999		,-50		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,172		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,173		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,174		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,175		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,176		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,177		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-58		,-58		,-58		,-999		,-999		,-999		,-58		,-999		,-58		,-999		,-58		,-58		,-58		,-999		,-999		,-58		,-58		,-999		,-999		,-999		,-58		,-999		,-58		,-999		,-999		,-999		,-58		,-999		,-999		,-999		,-58		,-58		,-999		,-999		,-58		,-999		,-999		,-999		,-58		,-999		,-999		,-999		,-58		,-58		,-999		,-999		,-58		,-999		,-999		,-999		,-999		,-999		,-58		,-999	},
+	{50		,-999		,38		,46		,18		,25		,-999		,27		,-999		,21		,-999		,-999		,-999		,37		,30		,-999		,-999		,31		,26		,24		,-999		,41		,-999		,34		,19		,22		,-999		,17		,35		,29		,-999		,51		,42		,33		,43		,32		,45		,48		,-999		,20		,52		,49		,-999		,-999		,36		,40		,-999		,16		,23		,28		,47		,44		,-999		,39	},
+	{-57		,-57		,-57		,-999		,-999		,-999		,-57		,-999		,-57		,-999		,-57		,-57		,-57		,-999		,-999		,-57		,-57		,-999		,-999		,-999		,-57		,-999		,-57		,-999		,-999		,-999		,-57		,-999		,-999		,-999		,-57		,-57		,-999		,-999		,-57		,-999		,-999		,-999		,-57		,-999		,-999		,-999		,-57		,-57		,-999		,-999		,-57		,-999		,-999		,-999		,-999		,-999		,-57		,-999	},
+	{-56		,-56		,-56		,-999		,-999		,-999		,-56		,-999		,-56		,-999		,-56		,-56		,-56		,-999		,-999		,-56		,-56		,-999		,-999		,-999		,-56		,-999		,-56		,-999		,-999		,-999		,-56		,-999		,-999		,-999		,-56		,-56		,-999		,-999		,-56		,-999		,-999		,-999		,-56		,-999		,-999		,-999		,-56		,-56		,-999		,-999		,-56		,-999		,-999		,-999		,-999		,-999		,-56		,-999	},
+	{-59		,-59		,-59		,-999		,-999		,-999		,-59		,-999		,-59		,-999		,-59		,-59		,-59		,-999		,-999		,-59		,-59		,-999		,-999		,-999		,-59		,-999		,-59		,-999		,-999		,-999		,-59		,-999		,-999		,-999		,-59		,-59		,-999		,-999		,-59		,-999		,-999		,-999		,-59		,-999		,-999		,-999		,-59		,-59		,-999		,-999		,-59		,-999		,-999		,-999		,-999		,-999		,-59		,-999	},
+	{-55		,-55		,-55		,-999		,-999		,-999		,-55		,-999		,-55		,-999		,-55		,-55		,-55		,-999		,-999		,-55		,-55		,-999		,-999		,-999		,-55		,-999		,-55		,-999		,-999		,-999		,-55		,-999		,-999		,-999		,-55		,-55		,-999		,-999		,-55		,-999		,-999		,-999		,-55		,-999		,-999		,-999		,-55		,-55		,-999		,-999		,-55		,-999		,-999		,-999		,-999		,-999		,-55		,-999	},
+	{-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,179		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999		,-999	},
+	{-60		,-60		,-60		,-999		,-999		,-999		,-60		,-999		,-60		,-999		,-60		,-60		,-60		,-999		,-999		,-60		,-60		,-999		,-999		,-999		,-60		,-999		,-60		,-999		,-999		,-999		,-60		,-999		,-999		,-999		,-60		,-60		,-999		,-999		,-60		,-999		,-999		,-999		,-60		,-999		,-999		,-999		,-60		,-60		,-999		,-999		,-60		,-999		,-999		,-999		,-999		,-999		,-60		,-999	}
 };
 const struct _TOKEN LalrSemanticRules[RULES_COUNT]= 
 {
@@ -247,6 +247,104 @@ ScriptEngineConvertFileToPdbFileAndGuidAndAgeDetails(const char * LocalFilePath,
     return SymConvertFileToPdbFileAndGuidAndAgeDetails(LocalFilePath, PdbFilePath, GuidAndAgeDetails);
 }
 
+/**
+ * @brief Register a format string of printf
+ * @details the kernel saves the identifier of the format string in the
+ * binary trace records and the format string is found by this identifier
+ * when the record is formatted
+ *
+ * @param Format
+ * @return VOID
+ */
+VOID
+ScriptEngineRegisterBinaryTraceFormat(const char * Format)
+{
+    UINT32 FormatId = BinaryTraceGetFormatId(Format);
+    UINT32 Index    = FormatId % MAX_BINARY_TRACE_FORMATS_COUNT;
+
+    AcquireSRWLockExclusive(&BinaryTraceFormatsLock);
+
+    for (UINT32 i = 0; i < MAX_BINARY_TRACE_FORMATS_COUNT; i++)
+    {
+        PBINARY_TRACE_FORMAT Entry = &BinaryTraceFormats[(Index + i) % MAX_BINARY_TRACE_FORMATS_COUNT];
+
+        if (Entry->FormatId == 0)
+        {
+            //
+            // A new format string
+            //
+            Entry->Format = _strdup(Format);
+
+            if (Entry->Format != NULL)
+            {
+                Entry->FormatId = FormatId;
+            }
+
+            break;
+        }
+
+        if (Entry->FormatId == FormatId)
+        {
+            //
+            // The format string is already registered, if it's a different
+            // string then none of them could be used to format the records
+            //
+            if (Entry->Format != NULL && strcmp(Entry->Format, Format) != 0)
+            {
+                Entry->IsAmbiguous = TRUE;
+            }
+
+            break;
+        }
+    }
+
+    ReleaseSRWLockExclusive(&BinaryTraceFormatsLock);
+}
+
+/**
+ * @brief Get the format string of a binary trace record
+ *
+ * @param FormatId
+ * @return const char * NULL if the format string is not found
+ */
+const char *
+ScriptEngineGetBinaryTraceFormat(UINT32 FormatId)
+{
+    const char * Result = NULL;
+    UINT32       Index  = FormatId % MAX_BINARY_TRACE_FORMATS_COUNT;
+
+    if (FormatId == 0)
+    {
+        return NULL;
+    }
+
+    AcquireSRWLockShared(&BinaryTraceFormatsLock);
+
+    for (UINT32 i = 0; i < MAX_BINARY_TRACE_FORMATS_COUNT; i++)
+    {
+        PBINARY_TRACE_FORMAT Entry = &BinaryTraceFormats[(Index + i) % MAX_BINARY_TRACE_FORMATS_COUNT];
+
+        if (Entry->FormatId == 0)
+        {
+            break;
+        }
+
+        if (Entry->FormatId == FormatId)
+        {
+            if (!Entry->IsAmbiguous)
+            {
+                Result = Entry->Format;
+            }
+
+            break;
+        }
+    }
+
+    ReleaseSRWLockShared(&BinaryTraceFormatsLock);
+
+    return Result;
+}
+
 /**
  * @brief The entry point of script engine
  *
@@ -457,6 +555,11 @@ ScriptEngineParse(char * str)
     else
     {
         ErrorMessage = NULL;
+
+        //
+        // Optimize the generated code
+        //
+        ScriptEngineOptimize(CodeBuffer);
     }
     CodeBuffer->Message = ErrorMessage;
 
@@ -709,6 +812,12 @@ CodeGen(PTOKEN_LIST MatchedStack, PSYMBOL_BUFFER CodeBuffer, PTOKEN Operator, PS
             {
                 break;
             }
+
+            //
+            // Register the format string so the binary trace records of
+            // this printf could be formatted
+            //
+            ScriptEngineRegisterBinaryTraceFormat(Format);
         }
         else if (IsType5Func(Operator))
         {
@@ -1908,6 +2017,42 @@ RemoveSymbolBuffer(PSYMBOL_BUFFER SymbolBuffer)
     free(SymbolBuffer);
 }
 
+/**
+ * @brief Allocates a copy of a (successfully parsed) Symbol Buffer
+ * @details the copy is allocated by the script engine, so it should be
+ * freed by RemoveSymbolBuffer
+ *
+ * @param SymbolBuffer
+ * @return PSYMBOL_BUFFER NULL if it's not possible to allocate the copy
+ */
+PSYMBOL_BUFFER
+ScriptEngineDuplicateSymbolBuffer(const PSYMBOL_BUFFER SymbolBuffer)
+{
+    PSYMBOL_BUFFER Duplicate;
+
+    Duplicate = (PSYMBOL_BUFFER)malloc(sizeof(*Duplicate));
+
+    if (Duplicate == NULL)
+    {
+        return NULL;
+    }
+
+    Duplicate->Pointer = SymbolBuffer->Pointer;
+    Duplicate->Size    = SymbolBuffer->Size;
+    Duplicate->Message = NULL;
+    Duplicate->Head    = (PSYMBOL)malloc(SymbolBuffer->Size * sizeof(SYMBOL));
+
+    if (Duplicate->Head == NULL)
+    {
+        free(Duplicate);
+        return NULL;
+    }
+
+    memcpy(Duplicate->Head, SymbolBuffer->Head, SymbolBuffer->Size * sizeof(SYMBOL));
+
+    return Duplicate;
+}
+
 /**
  * @brief Gets a symbol and push it into the symbol buffer
  *
@@ -2050,14 +2195,7 @@ PrintSymbolBuffer(const PSYMBOL_BUFFER SymbolBuffer)
 unsigned long long int
 RegisterToInt(char * str)
 {
-    for (int i = 0; i < REGISTER_MAP_LIST_LENGTH; i++)
-    {
-        if (!strcmp(str, RegisterMapList[i].Name))
-        {
-            return RegisterMapList[i].Type;
-        }
-    }
-    return INVALID;
+    return LookupName(NAME_LOOKUP_TABLE_REGISTERS, str);
 }
 
 /**
@@ -2069,14 +2207,7 @@ RegisterToInt(char * str)
 unsigned long long int
 PseudoRegToInt(char * str)
 {
-    for (int i = 0; i < PSEUDO_REGISTER_MAP_LIST_LENGTH; i++)
-    {
-        if (!strcmp(str, PseudoRegisterMapList[i].Name))
-        {
-            return PseudoRegisterMapList[i].Type;
-        }
-    }
-    return INVALID;
+    return LookupName(NAME_LOOKUP_TABLE_PSEUDO_REGISTERS, str);
 }
 
 /**
@@ -2088,14 +2219,7 @@ PseudoRegToInt(char * str)
 unsigned long long int
 SemanticRuleToInt(char * str)
 {
-    for (int i = 0; i < SEMANTIC_RULES_MAP_LIST_LENGTH; i++)
-    {
-        if (!strcmp(str, SemanticRulesMapList[i].Name))
-        {
-            return SemanticRulesMapList[i].Type;
-        }
-    }
-    return INVALID;
+    return LookupName(NAME_LOOKUP_TABLE_SEMANTIC_RULES, str);
 }
 
 /**
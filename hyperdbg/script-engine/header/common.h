@@ -30,6 +30,17 @@ initial size of symbol buffer
  */
 #    define TOKEN_LIST_INIT_SIZE 256
 
+/**
+ * @brief maximum number of removed tokens that are kept to be reused
+ */
+#    define TOKEN_POOL_MAX_COUNT 1024
+
+/**
+ * @brief number of entries of each name lookup table (should be a power
+ * of 2 and at least twice the number of names in the table)
+ */
+#    define NAME_LOOKUP_TABLE_SIZE 512
+
 /**
  * @brief enumerates possible types for token
  */
@@ -80,6 +91,47 @@ typedef struct _TOKEN_LIST
     unsigned int Size;
 } TOKEN_LIST, *PTOKEN_LIST;
 
+/**
+ * @brief the name lookup tables (built once from the generated lists of
+ * the parse tables)
+ */
+typedef enum _NAME_LOOKUP_TABLE_TYPE
+{
+    NAME_LOOKUP_TABLE_NON_TERMINALS,
+    NAME_LOOKUP_TABLE_TERMINALS,
+    NAME_LOOKUP_TABLE_LALR_NON_TERMINALS,
+    NAME_LOOKUP_TABLE_LALR_TERMINALS,
+    NAME_LOOKUP_TABLE_KEYWORDS,
+    NAME_LOOKUP_TABLE_REGISTERS,
+    NAME_LOOKUP_TABLE_PSEUDO_REGISTERS,
+    NAME_LOOKUP_TABLE_SEMANTIC_RULES,
+    NAME_LOOKUP_TABLE_OPERATOR_CLASSES,
+    NAME_LOOKUP_TABLE_COUNT
+
+} NAME_LOOKUP_TABLE_TYPE;
+
+/**
+ * @brief classes of operators (values of NAME_LOOKUP_TABLE_OPERATOR_CLASSES)
+ */
+#    define OPERATOR_CLASS_TYPE1_FUNC           (1 << 0) // OneOpFunc1
+#    define OPERATOR_CLASS_TYPE2_FUNC           (1 << 1) // OneOpFunc2
+#    define OPERATOR_CLASS_TYPE4_FUNC           (1 << 2) // VarArgFunc1
+#    define OPERATOR_CLASS_TYPE5_FUNC           (1 << 3) // ZeroOpFunc1
+#    define OPERATOR_CLASS_TYPE6_FUNC           (1 << 4) // TwoOpFunc1
+#    define OPERATOR_CLASS_TYPE7_FUNC           (1 << 5) // TwoOpFunc2
+#    define OPERATOR_CLASS_TYPE8_FUNC           (1 << 6) // ThreeOpFunc1
+#    define OPERATOR_CLASS_TWO_OPERAND_OPERATOR (1 << 7)
+#    define OPERATOR_CLASS_ONE_OPERAND_OPERATOR (1 << 8)
+
+/**
+ * @brief an entry of a name lookup table (open addressing)
+ */
+typedef struct _NAME_LOOKUP_ENTRY
+{
+    const char *       Name; // NULL if the entry is not used
+    unsigned long long Value;
+} NAME_LOOKUP_ENTRY, *PNAME_LOOKUP_ENTRY;
+
 ////////////////////////////////////////////////////
 // PTOKEN related functions						  //
 ////////////////////////////////////////////////////
@@ -218,4 +270,11 @@ IsTwoOperandOperator(PTOKEN Operator);
 char
 IsOneOperandOperator(PTOKEN Operator);
 
+////////////////////////////////////////////////////
+//	          Name Lookup Functions		          //
+////////////////////////////////////////////////////
+
+unsigned long long
+LookupName(NAME_LOOKUP_TABLE_TYPE TableType, const char * Name);
+
 #endif // !COMMON_H
@@ -15,6 +15,34 @@
 #    define GLOABLS_H
 #    define MAX_TEMP_COUNT 128
 
+/**
+ * @brief Maximum number of format strings of binary trace records
+ *
+ */
+#    define MAX_BINARY_TRACE_FORMATS_COUNT 1024
+
+/**
+ * @brief A format string of binary trace records
+ *
+ */
+typedef struct _BINARY_TRACE_FORMAT
+{
+    UINT32  FormatId;
+    BOOLEAN IsAmbiguous; // Different format strings with the same identifier
+    char *  Format;
+
+} BINARY_TRACE_FORMAT, *PBINARY_TRACE_FORMAT;
+
 extern char TempMap[MAX_TEMP_COUNT];
 
+extern BINARY_TRACE_FORMAT BinaryTraceFormats[MAX_BINARY_TRACE_FORMATS_COUNT];
+
+extern SRWLOCK BinaryTraceFormatsLock;
+
+extern NAME_LOOKUP_ENTRY NameLookupTables[NAME_LOOKUP_TABLE_COUNT][NAME_LOOKUP_TABLE_SIZE];
+
+extern PTOKEN TokenPool[TOKEN_POOL_MAX_COUNT];
+
+extern unsigned int TokenPoolCount;
+
 #endif // !GLOBALS_H
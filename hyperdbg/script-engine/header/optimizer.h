@@ -0,0 +1,85 @@
+/**
+ * @file optimizer.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ *
+ * @details Optimizer of the generated code headers
+ * @version 0.4
+ * @date 2023-07-14
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+#ifndef OPTIMIZER_H
+#    define OPTIMIZER_H
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Count of 64-bit words that hold a set of temps
+ *
+ */
+#    define OPTIMIZER_TEMP_SET_SIZE (MAX_TEMP_COUNT / 64)
+
+/**
+ * @brief Shows that an instruction doesn't have an operand
+ *
+ */
+#    define OPTIMIZER_NO_OPERAND 0xffffffff
+
+/**
+ * @brief Maximum number of times that the passes are repeated
+ *
+ */
+#    define OPTIMIZER_MAX_PASSES 8
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A decoded instruction of the code buffer
+ *
+ */
+typedef struct _OPTIMIZER_INSTRUCTION
+{
+    UINT32  Start;          // Index of the operator symbol
+    UINT32  Length;         // Count of symbols of the instruction
+    UINT64  Operator;       // The operator (FUNC_*)
+    UINT32  ReadsStart;     // Index of the first symbol that is read
+    UINT32  ReadsCount;     // Count of symbols that are read
+    UINT32  Destination;    // Index of the destination symbol (if any)
+    UINT32  Target;         // Target instruction of jumps
+    BOOLEAN ModifiesSource; // The source is also the destination (inc and dec)
+    BOOLEAN Removed;
+    BOOLEAN Leader; // Start of a basic block
+    UINT64  LiveIn[OPTIMIZER_TEMP_SET_SIZE];
+    UINT64  LiveOut[OPTIMIZER_TEMP_SET_SIZE];
+
+} OPTIMIZER_INSTRUCTION, *POPTIMIZER_INSTRUCTION;
+
+/**
+ * @brief The state of optimizing a code buffer
+ *
+ */
+typedef struct _OPTIMIZER_STATE
+{
+    PSYMBOL                Symbols; // Code buffer (modified by the passes)
+    UINT32                 SymbolsCount;
+    POPTIMIZER_INSTRUCTION Instructions;
+    UINT32                 InstructionsCount;
+    BOOLEAN                CanOptimizeTemps; // Temps are not referenced nor read before write
+
+} OPTIMIZER_STATE, *POPTIMIZER_STATE;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+void
+ScriptEngineOptimize(PSYMBOL_BUFFER CodeBuffer);
+
+#endif // !OPTIMIZER_H
@@ -1,22 +1,22 @@
 #pragma once
 #ifndef PARSE_TABLE_H
 #define PARSE_TABLE_H
-#define RULES_COUNT 143
-#define TERMINAL_COUNT 77
+#define RULES_COUNT 178
+#define TERMINAL_COUNT 97
 #define NONETERMINAL_COUNT 34
 #define START_VARIABLE "S"
 #define MAX_RHS_LEN 15
-#define KEYWORD_LIST_LENGTH 67
+#define KEYWORD_LIST_LENGTH 102
 #define OPERATORS_ONE_OPERAND_LIST_LENGTH 4
 #define OPERATORS_TWO_OPERAND_LIST_LENGTH 16
 #define REGISTER_MAP_LIST_LENGTH 120
 #define PSEUDO_REGISTER_MAP_LIST_LENGTH 13
-#define SEMANTIC_RULES_MAP_LIST_LENGTH 106
-#define THREEOPFUNC1_LENGTH 2
-#define TWOOPFUNC1_LENGTH 5
-#define TWOOPFUNC2_LENGTH 1
-#define ONEOPFUNC1_LENGTH 21
-#define ONEOPFUNC2_LENGTH 7
+#define SEMANTIC_RULES_MAP_LIST_LENGTH 141
+#define THREEOPFUNC1_LENGTH 10
+#define TWOOPFUNC1_LENGTH 8
+#define TWOOPFUNC2_LENGTH 3
+#define ONEOPFUNC1_LENGTH 25
+#define ONEOPFUNC2_LENGTH 10
 #define ZEROOPFUNC1_LENGTH 2
 #define VARARGFUNC1_LENGTH 1
 extern const struct _TOKEN Lhs[RULES_COUNT];
@@ -49,6 +49,8 @@ __declspec(dllexport) VOID
     ScriptEngineSymbolAbortLoading();
 __declspec(dllexport) VOID
     ScriptEngineSetTextMessageCallback(PVOID Handler);
+__declspec(dllexport) const char *
+    ScriptEngineGetBinaryTraceFormat(UINT32 FormatId);
 
 typedef enum _SCRIPT_ENGINE_ERROR_TYPE
 {
@@ -80,6 +82,8 @@ NewSymbolBuffer(void);
 
 __declspec(dllexport) void RemoveSymbolBuffer(PSYMBOL_BUFFER SymbolBuffer);
 
+__declspec(dllexport) PSYMBOL_BUFFER ScriptEngineDuplicateSymbolBuffer(const PSYMBOL_BUFFER SymbolBuffer);
+
 PSYMBOL_BUFFER
 PushSymbol(PSYMBOL_BUFFER SymbolBuffer, const PSYMBOL Symbol);
 
@@ -90,6 +94,9 @@ ToSymbol(PTOKEN PTOKEN, PSCRIPT_ENGINE_ERROR_TYPE Error);
 
 __declspec(dllexport) PSYMBOL_BUFFER ScriptEngineParse(char * str);
 
+VOID
+ScriptEngineRegisterBinaryTraceFormat(const char * Format);
+
 void
 ScriptEngineBooleanExpresssionParse(
     UINT64                    BooleanExpressionSize,
@@ -25,10 +25,12 @@
 #include <string.h>
 #include <stdint.h>
 
+#include "SDK/HyperDbgSdk.h"
 #include "SDK/Imports/HyperDbgSymImports.h"
 #include "common.h"
 #include "scanner.h"
 #include "globals.h"
 #include "..\script-eval\header\ScriptEngineCommonDefinitions.h"
 #include "script-engine.h"
+#include "optimizer.h"
 #include "parse-table.h"
@@ -53,11 +53,17 @@ typedef struct SYMBOL_MAP
     char* Name;
     long long unsigned Type;
 } SYMBOL_MAP, * PSYMBOL_MAP;
+#define ACTION_BUFFER_PSEUDO_REGISTERS_CACHE_SIZE 8
 typedef struct ACTION_BUFFER {
   long long unsigned Tag;
   long long unsigned CurrentAction;
   char ImmediatelySendTheResults;
+  char IsOutputDisabled;
   long long unsigned Context;
+  long long unsigned InstructionsBudget;
+  long long unsigned InstructionsCount;
+  unsigned int PseudoRegistersCacheValid;
+  long long unsigned PseudoRegistersCache[ACTION_BUFFER_PSEUDO_REGISTERS_CACHE_SIZE];
 } ACTION_BUFFER, *PACTION_BUFFER;
 
 
@@ -19,6 +19,8 @@
 
 extern UINT64  g_CurrentExprEvalResult;
 extern BOOLEAN g_CurrentExprEvalResultHasError;
+extern BYTE *  g_ScriptScratchArena;
+extern UINT32  g_ScriptScratchUsed;
 
 #endif // SCRIPT_ENGINE_USER_MODE
 
@@ -297,562 +299,1459 @@ ScriptEngineFunctionMemcpy(UINT64 Destionation, UINT64 Source, UINT32 Num, BOOL
 #endif // SCRIPT_ENGINE_KERNEL_MODE
 }
 
-//
-// Convert virtual address to physical address
-//
-UINT64
-ScriptEngineFunctionVirtualToPhysical(UINT64 Address)
-{
-#ifdef SCRIPT_ENGINE_USER_MODE
-
-    //
-    // There is no conversion in user-mode
-    //
-    return NULL;
-#endif // SCRIPT_ENGINE_USER_MODE
-
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
 
-    return VirtualAddressToPhysicalAddressOnTargetProcess(Address);
-
-#endif // SCRIPT_ENGINE_KERNEL_MODE
+/**
+ * @brief Check whether a word has a null character
+ * @details the characters of the word are checked at once (each byte
+ * or each two bytes of the word which has its high bit set after the
+ * subtraction while it was not set before, is a null character)
+ *
+ * @param Word
+ * @param CharSize Size of each character (1 or 2)
+ * @return BOOLEAN
+ */
+static BOOLEAN
+ScriptEngineFunctionHasNullCharacter(UINT64 Word, UINT32 CharSize)
+{
+    if (CharSize == sizeof(CHAR))
+    {
+        return ((Word - 0x0101010101010101) & ~Word & 0x8080808080808080) != 0;
+    }
+    else
+    {
+        return ((Word - 0x0001000100010001) & ~Word & 0x8000800080008000) != 0;
+    }
 }
 
 /**
- * @brief Convert physical address to virtual address
+ * @brief Find the first different byte of two buffers
+ * @details the buffers are compared word by word and then byte by byte
+ * for the rest of the buffers
  *
- * @param Address
- * @return UINT64
+ * @param Buffer1
+ * @param Buffer2
+ * @param Length
+ * @return UINT32 Index of the first different byte or the length if the
+ * buffers are equal
  */
-UINT64
-ScriptEngineFunctionPhysicalToVirtual(UINT64 Address)
+static UINT32
+ScriptEngineFunctionFindMismatch(const BYTE * Buffer1, const BYTE * Buffer2, UINT32 Length)
 {
-#ifdef SCRIPT_ENGINE_USER_MODE
-
-    //
-    // There is no conversion in user-mode
-    //
-    return NULL;
-#endif // SCRIPT_ENGINE_USER_MODE
+    UINT32 Index = 0;
 
-#ifdef SCRIPT_ENGINE_KERNEL_MODE
+    while (Index + sizeof(UINT64) <= Length &&
+           *(const UINT64 *)(Buffer1 + Index) == *(const UINT64 *)(Buffer2 + Index))
+    {
+        Index += sizeof(UINT64);
+    }
 
-    return PhysicalAddressToVirtualAddressOnTargetProcess(Address);
+    while (Index < Length && Buffer1[Index] == Buffer2[Index])
+    {
+        Index++;
+    }
 
-#endif // SCRIPT_ENGINE_KERNEL_MODE
+    return Index;
 }
 
 /**
- * @brief Implementation of print function
+ * @brief Get the length of the next chunk of two strings which is read
+ * at once
+ * @details the chunk doesn't cross the page boundaries of the strings,
+ * so the pages after the terminating null characters are not accessed
  *
- * @param Tag
- * @param ImmediateMessagePassing
- * @param Value
- * @return VOID
+ * @param String1
+ * @param String2
+ * @param CharSize Size of each character (1 or 2)
+ * @return UINT32
  */
-VOID
-ScriptEngineFunctionPrint(UINT64 Tag, BOOLEAN ImmediateMessagePassing, UINT64 Value)
+static UINT32
+ScriptEngineFunctionGetStringChunkLength(UINT64 String1, UINT64 String2, UINT32 CharSize)
 {
-#ifdef SCRIPT_ENGINE_USER_MODE
-    ShowMessages("%llx\n", Value);
-#endif // SCRIPT_ENGINE_USER_MODE
+    UINT64 Length = DebuggerScriptEngineBulkMemoryChunkSize;
 
-#ifdef SCRIPT_ENGINE_KERNEL_MODE
+    Length = min(Length, PAGE_SIZE - (String1 & (PAGE_SIZE - 1)));
+    Length = min(Length, PAGE_SIZE - (String2 & (PAGE_SIZE - 1)));
+    Length -= Length % CharSize;
 
     //
-    // Prepare a buffer to bypass allocating a huge stack space for logging
+    // A character which crosses the page boundary
     //
-    char   TempBuffer[20] = {0};
-    UINT32 TempBufferLen  = sprintf(TempBuffer, "%llx", Value);
-
-    LogSimpleWithTag(Tag, ImmediateMessagePassing, TempBuffer, TempBufferLen + 1);
+    if (Length == 0)
+    {
+        Length = CharSize;
+    }
 
-#endif // SCRIPT_ENGINE_KERNEL_MODE
+    return (UINT32)Length;
 }
 
 /**
- * @brief Implementation of test_statement function
+ * @brief A VMX-compatible comparison of two strings
  *
- * @param Tag
- * @param ImmediateMessagePassing
- * @param Value
- * @return VOID
+ * @param String1
+ * @param String2
+ * @param CharSize Size of each character (1 or 2)
+ * @param IgnoreCase Whether the (ASCII) letters are compared without case
+ * @param HasError
+ * @return INT32 zero if the strings are equal, negative if the first
+ * string is less than the second string, and positive otherwise
  */
-VOID
-ScriptEngineFunctionTestStatement(UINT64 Tag, BOOLEAN ImmediateMessagePassing, UINT64 Value)
+static INT32
+ScriptEngineFunctionCompareStrings(UINT64 String1, UINT64 String2, UINT32 CharSize, BOOLEAN IgnoreCase, BOOL * HasError)
 {
-#ifdef SCRIPT_ENGINE_USER_MODE
+    UINT64 Buffer1[DebuggerScriptEngineBulkMemoryChunkSize / sizeof(UINT64)];
+    UINT64 Buffer2[DebuggerScriptEngineBulkMemoryChunkSize / sizeof(UINT64)];
+    UINT32 Length;
+    UINT32 Index;
+    UINT32 Char1;
+    UINT32 Char2;
+
+    while (TRUE)
+    {
+        Length = ScriptEngineFunctionGetStringChunkLength(String1, String2, CharSize);
 
-    g_CurrentExprEvalResult         = Value;
-    g_CurrentExprEvalResultHasError = FALSE;
+        if (!CheckAccessValidityAndSafety(String1, Length) || !CheckAccessValidityAndSafety(String2, Length))
+        {
+            *HasError = TRUE;
+            return 0;
+        }
 
-#endif // SCRIPT_ENGINE_USER_MODE
+        MemoryMapperReadMemorySafeOnTargetProcess(String1, Buffer1, Length);
+        MemoryMapperReadMemorySafeOnTargetProcess(String2, Buffer2, Length);
+
+        //
+        // Equal words without a null character are skipped at once
+        //
+        Index = 0;
+
+        while (Index + sizeof(UINT64) <= Length &&
+               Buffer1[Index / sizeof(UINT64)] == Buffer2[Index / sizeof(UINT64)] &&
+               !ScriptEngineFunctionHasNullCharacter(Buffer1[Index / sizeof(UINT64)], CharSize))
+        {
+            Index += sizeof(UINT64);
+        }
+
+        for (; Index < Length; Index += CharSize)
+        {
+            if (CharSize == sizeof(CHAR))
+            {
+                Char1 = ((BYTE *)Buffer1)[Index];
+                Char2 = ((BYTE *)Buffer2)[Index];
+            }
+            else
+            {
+                Char1 = *(UINT16 *)((BYTE *)Buffer1 + Index);
+                Char2 = *(UINT16 *)((BYTE *)Buffer2 + Index);
+            }
+
+            if (IgnoreCase)
+            {
+                Char1 = (Char1 >= 'A' && Char1 <= 'Z') ? Char1 + ('a' - 'A') : Char1;
+                Char2 = (Char2 >= 'A' && Char2 <= 'Z') ? Char2 + ('a' - 'A') : Char2;
+            }
+
+            if (Char1 != Char2)
+            {
+                return Char1 < Char2 ? -1 : 1;
+            }
+
+            if (Char1 == 0)
+            {
+                return 0;
+            }
+        }
+
+        String1 += Length;
+        String2 += Length;
+    }
 }
 
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+
 /**
- * @brief Implementation of spinlock_lock function
+ * @brief A VMX-compatible equivalent of memcmp function in C
  *
- * @param Lock
+ * @param Address1
+ * @param Address2
+ * @param Num
  * @param HasError
- * @return VOID
+ * @return UINT64 zero if the buffers are equal, -1 if the first buffer
+ * is less than the second buffer, and 1 otherwise
  */
-VOID
-ScriptEngineFunctionSpinlockLock(volatile LONG * Lock, BOOL * HasError)
+UINT64
+ScriptEngineFunctionMemcmp(UINT64 Address1, UINT64 Address2, UINT32 Num, BOOL * HasError)
 {
+    INT32 Result = 0;
+
+    //
+    // Check the addresses
+    //
+    if (!CheckAccessValidityAndSafety(Address1, Num) || !CheckAccessValidityAndSafety(Address2, Num))
+    {
+        *HasError = TRUE;
+        return 0;
+    }
+
 #ifdef SCRIPT_ENGINE_USER_MODE
 
-    SpinlockLock(Lock);
+    Result = memcmp((const void *)Address1, (const void *)Address2, Num);
 
 #endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
 
-    if (!CheckAccessValidityAndSafety(Lock, sizeof(LONG)))
+    UINT64 Buffer1[DebuggerScriptEngineBulkMemoryChunkSize / sizeof(UINT64)];
+    UINT64 Buffer2[DebuggerScriptEngineBulkMemoryChunkSize / sizeof(UINT64)];
+    UINT32 Length;
+    UINT32 Mismatch;
+
+    while (Num > 0)
     {
-        *HasError = TRUE;
-        return;
-    }
+        Length = min(Num, DebuggerScriptEngineBulkMemoryChunkSize);
 
-    SpinlockLock(Lock);
+        MemoryMapperReadMemorySafeOnTargetProcess(Address1, Buffer1, Length);
+        MemoryMapperReadMemorySafeOnTargetProcess(Address2, Buffer2, Length);
+
+        Mismatch = ScriptEngineFunctionFindMismatch((BYTE *)Buffer1, (BYTE *)Buffer2, Length);
+
+        if (Mismatch != Length)
+        {
+            Result = ((BYTE *)Buffer1)[Mismatch] - ((BYTE *)Buffer2)[Mismatch];
+            break;
+        }
+
+        Address1 += Length;
+        Address2 += Length;
+        Num -= Length;
+    }
 
 #endif // SCRIPT_ENGINE_KERNEL_MODE
+
+    return Result == 0 ? 0 : (Result < 0 ? (UINT64)-1 : 1);
 }
 
 /**
- * @brief Implementation of spinlock_unlock function
+ * @brief A VMX-compatible equivalent of memset function in C
  *
- * @param Lock
+ * @param Destination
+ * @param Value
+ * @param Num
  * @param HasError
- * @return VOID
+ * @return UINT64 the destination
  */
-VOID
-ScriptEngineFunctionSpinlockUnlock(volatile LONG * Lock, BOOL * HasError)
+UINT64
+ScriptEngineFunctionMemset(UINT64 Destination, BYTE Value, UINT32 Num, BOOL * HasError)
 {
+    //
+    // Check the destination address
+    //
+    if (!CheckAccessValidityAndSafety(Destination, Num))
+    {
+        *HasError = TRUE;
+        return 0;
+    }
+
 #ifdef SCRIPT_ENGINE_USER_MODE
 
-    SpinlockUnlock(Lock);
+    memset((void *)Destination, Value, Num);
 
 #endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
 
-    if (!CheckAccessValidityAndSafety(Lock, sizeof(LONG)))
+    UINT64 Buffer[DebuggerScriptEngineBulkMemoryChunkSize / sizeof(UINT64)];
+    UINT64 Address = Destination;
+    UINT32 Length;
+
+    //
+    // The chunk is filled once and written to the destination
+    //
+    RtlFillMemory(Buffer, sizeof(Buffer), Value);
+
+    while (Num > 0)
     {
-        *HasError = TRUE;
-        return;
-    }
+        Length = min(Num, DebuggerScriptEngineBulkMemoryChunkSize);
 
-    SpinlockUnlock(Lock);
+        MemoryMapperWriteMemorySafeOnTargetProcess(Address, Buffer, Length);
+
+        Address += Length;
+        Num -= Length;
+    }
 
 #endif // SCRIPT_ENGINE_KERNEL_MODE
+
+    return Destination;
 }
 
 /**
- * @brief Implementation of spinlock_lock_custom_wait function
+ * @brief Implementation of memsearch function
+ * @details search for the first occurrence of a null-terminated pattern
+ * (the terminating null character is not searched) in a buffer
  *
- * @param Lock
- * @param MaxWait
+ * @param Address Address of the buffer
+ * @param Num Size of the buffer
+ * @param Pattern Address of the pattern
  * @param HasError
- * @return VOID
+ * @return UINT64 the address of the first occurrence of the pattern or
+ * zero if the pattern is not found
  */
-VOID
-ScriptEngineFunctionSpinlockLockCustomWait(volatile long * Lock, unsigned MaxWait, BOOL * HasError)
+UINT64
+ScriptEngineFunctionMemsearch(UINT64 Address, UINT32 Num, UINT64 Pattern, BOOL * HasError)
 {
+    UINT32 PatternLength = (UINT32)ScriptEngineFunctionStrlen((const char *)Pattern);
+
+    //
+    // Check the buffer and the pattern (empty patterns or the patterns
+    // which are not accessible are not searched)
+    //
+    if (PatternLength == 0 ||
+        PatternLength > DebuggerScriptEngineBulkMemoryChunkSize ||
+        !CheckAccessValidityAndSafety(Pattern, PatternLength) ||
+        !CheckAccessValidityAndSafety(Address, Num))
+    {
+        *HasError = TRUE;
+        return 0;
+    }
+
 #ifdef SCRIPT_ENGINE_USER_MODE
 
-    SpinlockLockWithCustomWait(Lock, MaxWait);
+    const BYTE * Buffer = (const BYTE *)Address;
+    const BYTE * Found;
+    UINT32       Offset = 0;
+
+    while (Offset + PatternLength <= Num)
+    {
+        Found = (const BYTE *)memchr(Buffer + Offset, *(const BYTE *)Pattern, Num - PatternLength - Offset + 1);
+
+        if (Found == NULL)
+        {
+            break;
+        }
+
+        if (memcmp(Found, (const void *)Pattern, PatternLength) == 0)
+        {
+            return (UINT64)Found;
+        }
+
+        Offset = (UINT32)(Found - Buffer) + 1;
+    }
 
 #endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
 
-    if (!CheckAccessValidityAndSafety(Lock, sizeof(LONG)))
+    UINT64 Buffer[DebuggerScriptEngineBulkMemoryChunkSize / sizeof(UINT64)];
+    UINT64 PatternBuffer[DebuggerScriptEngineBulkMemoryChunkSize / sizeof(UINT64)];
+    UINT64 FirstBytes;
+    UINT64 Word;
+    UINT32 Offset = 0;
+    UINT32 Length;
+    UINT32 Index;
+
+    MemoryMapperReadMemorySafeOnTargetProcess(Pattern, PatternBuffer, PatternLength);
+
+    //
+    // The first byte of the pattern in all the bytes of a word
+    //
+    FirstBytes = ((BYTE *)PatternBuffer)[0] * 0x0101010101010101;
+
+    while (Offset + PatternLength <= Num)
     {
-        *HasError = TRUE;
-        return;
-    }
+        //
+        // The chunks overlap, so the patterns which cross the chunks
+        // are also found
+        //
+        Length = min(Num - Offset, DebuggerScriptEngineBulkMemoryChunkSize);
 
-    SpinlockLockWithCustomWait(Lock, MaxWait);
+        MemoryMapperReadMemorySafeOnTargetProcess(Address + Offset, Buffer, Length);
+
+        for (Index = 0; Index + PatternLength <= Length; Index++)
+        {
+            //
+            // Words without the first byte of the pattern are skipped at once
+            //
+            if ((Index % sizeof(UINT64)) == 0 && Index + sizeof(UINT64) <= Length)
+            {
+                Word = Buffer[Index / sizeof(UINT64)] ^ FirstBytes;
+
+                if (!ScriptEngineFunctionHasNullCharacter(Word, sizeof(CHAR)))
+                {
+                    Index += sizeof(UINT64) - 1;
+                    continue;
+                }
+            }
+
+            if (((BYTE *)Buffer)[Index] == ((BYTE *)PatternBuffer)[0] &&
+                ScriptEngineFunctionFindMismatch((BYTE *)Buffer + Index, (BYTE *)PatternBuffer, PatternLength) == PatternLength)
+            {
+                return Address + Offset + Index;
+            }
+        }
+
+        Offset += Length - PatternLength + 1;
+    }
 
 #endif // SCRIPT_ENGINE_KERNEL_MODE
+
+    return 0;
 }
 
 /**
- * @brief Implementation of strlen function
+ * @brief Implementation of strcmp function
  *
- * @param Address
- * @return UINT64
+ * @param String1
+ * @param String2
+ * @param HasError
+ * @return UINT64 zero if the strings are equal, -1 if the first string
+ * is less than the second string, and 1 otherwise
  */
 UINT64
-ScriptEngineFunctionStrlen(const char * Address)
+ScriptEngineFunctionStrcmp(const char * String1, const char * String2, BOOL * HasError)
 {
-    UINT64 Result = 0;
+    INT32 Result = 0;
+
 #ifdef SCRIPT_ENGINE_USER_MODE
-    Result = strlen(Address);
+    Result = strcmp(String1, String2);
 #endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
-    Result = VmFuncVmxCompatibleStrlen(Address);
+    Result = ScriptEngineFunctionCompareStrings((UINT64)String1, (UINT64)String2, sizeof(CHAR), FALSE, HasError);
 #endif // SCRIPT_ENGINE_KERNEL_MODE
 
-    return Result;
+    return Result == 0 ? 0 : (Result < 0 ? (UINT64)-1 : 1);
 }
 
 /**
- * @brief Implementation of disassemble_len function
- *
- * @param Address
- * @param Is32Bit
+ * @brief Implementation of wcscmp function
  *
- * @return UINT64
+ * @param String1
+ * @param String2
+ * @param HasError
+ * @return UINT64 zero if the strings are equal, -1 if the first string
+ * is less than the second string, and 1 otherwise
  */
 UINT64
-ScriptEngineFunctionDisassembleLen(const char * Address, BOOLEAN Is32Bit)
+ScriptEngineFunctionWcscmp(const wchar_t * String1, const wchar_t * String2, BOOL * HasError)
 {
-    UINT64 Result = 0;
+    INT32 Result = 0;
+
 #ifdef SCRIPT_ENGINE_USER_MODE
-    Result = HyperDbgLengthDisassemblerEngine((unsigned char *)Address, MAXIMUM_INSTR_SIZE, Is32Bit ? FALSE : TRUE);
+    Result = wcscmp(String1, String2);
 #endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
-    Result = DisassemblerLengthDisassembleEngineInVmxRootOnTargetProcess(Address, Is32Bit);
+    Result = ScriptEngineFunctionCompareStrings((UINT64)String1, (UINT64)String2, sizeof(wchar_t), FALSE, HasError);
 #endif // SCRIPT_ENGINE_KERNEL_MODE
 
-    return Result;
+    return Result == 0 ? 0 : (Result < 0 ? (UINT64)-1 : 1);
 }
 
 /**
- * @brief Implementation of wcslen function
+ * @brief Implementation of stricmp function
+ * @details the ASCII letters are compared without case
  *
- * @param Address
- * @return UINT64
+ * @param String1
+ * @param String2
+ * @param HasError
+ * @return UINT64 zero if the strings are equal, -1 if the first string
+ * is less than the second string, and 1 otherwise
  */
 UINT64
-ScriptEngineFunctionWcslen(const wchar_t * Address)
+ScriptEngineFunctionStricmp(const char * String1, const char * String2, BOOL * HasError)
 {
-    UINT64 Result = 0;
+    INT32 Result = 0;
 
 #ifdef SCRIPT_ENGINE_USER_MODE
-    Result = wcslen(Address);
+    Result = _stricmp(String1, String2);
 #endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
-    Result = VmFuncVmxCompatibleWcslen(Address);
+    Result = ScriptEngineFunctionCompareStrings((UINT64)String1, (UINT64)String2, sizeof(CHAR), TRUE, HasError);
 #endif // SCRIPT_ENGINE_KERNEL_MODE
 
-    return Result;
+    return Result == 0 ? 0 : (Result < 0 ? (UINT64)-1 : 1);
 }
 
 /**
- * @brief Implementation of interlocked_exchange function
+ * @brief Implementation of scratch function
+ * @details allocates a buffer from the scratch memory (which is not
+ * visible to the guest), the buffer is valid until the end of the
+ * current script
  *
- * @param Target
- * @param Value
+ * @param Size Size of the buffer
  * @param HasError
- * @return long long
+ * @return UINT64 Address of the buffer
  */
-long long
-ScriptEngineFunctionInterlockedExchange(long long volatile * Target,
-                                        long long            Value,
-                                        BOOL *               HasError)
+UINT64
+ScriptEngineFunctionScratch(UINT64 Size, BOOL * HasError)
 {
-    long long Result = 0;
+    UINT64 Address = NULL;
+
+#ifdef SCRIPT_ENGINE_USER_MODE
+
+    if (g_ScriptScratchArena != NULL &&
+        Size != 0 &&
+        Size <= DebuggerScriptEngineScratchArenaSize - g_ScriptScratchUsed)
+    {
+        Address = (UINT64)g_ScriptScratchArena + g_ScriptScratchUsed;
+        g_ScriptScratchUsed += (UINT32)((Size + DebuggerScriptEngineScratchAlignment - 1) & ~(UINT64)(DebuggerScriptEngineScratchAlignment - 1));
+    }
+
+#endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
+    Address = ScriptEngineScratchAllocate(Size);
+#endif // SCRIPT_ENGINE_KERNEL_MODE
 
-    if (!CheckAccessValidityAndSafety(Target, sizeof(long long)))
+    if (Address == NULL)
     {
+        //
+        // Not enough scratch memory
+        //
         *HasError = TRUE;
-        return NULL;
     }
 
+    return Address;
+}
+
+//
+// Convert virtual address to physical address
+//
+UINT64
+ScriptEngineFunctionVirtualToPhysical(UINT64 Address)
+{
+#ifdef SCRIPT_ENGINE_USER_MODE
+
+    //
+    // There is no conversion in user-mode
+    //
+    return NULL;
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+
+    return VirtualAddressToPhysicalAddressOnTargetProcess(Address);
+
 #endif // SCRIPT_ENGINE_KERNEL_MODE
+}
 
-    Result = InterlockedExchange64(Target, Value);
+/**
+ * @brief Convert physical address to virtual address
+ *
+ * @param Address
+ * @return UINT64
+ */
+UINT64
+ScriptEngineFunctionPhysicalToVirtual(UINT64 Address)
+{
+#ifdef SCRIPT_ENGINE_USER_MODE
 
-    return Result;
+    //
+    // There is no conversion in user-mode
+    //
+    return NULL;
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+
+    return PhysicalAddressToVirtualAddressOnTargetProcess(Address);
+
+#endif // SCRIPT_ENGINE_KERNEL_MODE
 }
 
 /**
- * @brief Implementation of interlocked_exchange_add function
+ * @brief Implementation of print function
  *
- * @param Addend
+ * @param Tag
+ * @param ImmediateMessagePassing
  * @param Value
- * @param HasError
- * @return long long
+ * @return VOID
  */
-long long
-ScriptEngineFunctionInterlockedExchangeAdd(long long volatile * Addend,
-                                           long long            Value,
-                                           BOOL *               HasError)
+VOID
+ScriptEngineFunctionPrint(UINT64 Tag, BOOLEAN ImmediateMessagePassing, UINT64 Value)
 {
-    long long Result = 0;
+#ifdef SCRIPT_ENGINE_USER_MODE
+    ShowMessages("%llx\n", Value);
+#endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
 
-    if (!CheckAccessValidityAndSafety(Addend, sizeof(long long)))
-    {
-        *HasError = TRUE;
-        return NULL;
-    }
+    //
+    // Prepare a buffer to bypass allocating a huge stack space for logging
+    //
+    char   TempBuffer[20] = {0};
+    UINT32 TempBufferLen  = sprintf(TempBuffer, "%llx", Value);
+
+    ScriptEngineOutputMessage(Tag, ImmediateMessagePassing, TempBuffer, TempBufferLen);
 
 #endif // SCRIPT_ENGINE_KERNEL_MODE
+}
 
-    Result = InterlockedExchangeAdd64(Addend, Value);
+/**
+ * @brief Implementation of test_statement function
+ *
+ * @param Tag
+ * @param ImmediateMessagePassing
+ * @param Value
+ * @return VOID
+ */
+VOID
+ScriptEngineFunctionTestStatement(UINT64 Tag, BOOLEAN ImmediateMessagePassing, UINT64 Value)
+{
+#ifdef SCRIPT_ENGINE_USER_MODE
 
-    return Result;
+    g_CurrentExprEvalResult         = Value;
+    g_CurrentExprEvalResultHasError = FALSE;
+
+#endif // SCRIPT_ENGINE_USER_MODE
 }
 
 /**
- * @brief Implementation of interlocked_exchange_increment function
+ * @brief Implementation of spinlock_lock function
  *
- * @param Addend
+ * @param Lock
  * @param HasError
- * @return long long
+ * @return VOID
  */
-long long
-ScriptEngineFunctionInterlockedIncrement(long long volatile * Addend,
-                                         BOOL *               HasError)
+VOID
+ScriptEngineFunctionSpinlockLock(volatile LONG * Lock, BOOL * HasError)
 {
-    long long Result = 0;
+#ifdef SCRIPT_ENGINE_USER_MODE
+
+    SpinlockLock(Lock);
+
+#endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
 
-    if (!CheckAccessValidityAndSafety(Addend, sizeof(long long)))
+    if (!CheckAccessValidityAndSafety(Lock, sizeof(LONG)))
     {
         *HasError = TRUE;
-        return NULL;
+        return;
     }
 
-#endif // SCRIPT_ENGINE_KERNEL_MODE
-
-    Result = InterlockedIncrement64(Addend);
+    SpinlockLock(Lock);
 
-    return Result;
+#endif // SCRIPT_ENGINE_KERNEL_MODE
 }
 
 /**
- * @brief Implementation of interlocked_exchange_decrement function
+ * @brief Implementation of spinlock_unlock function
  *
- * @param Addend
+ * @param Lock
  * @param HasError
- * @return long long
+ * @return VOID
  */
-long long
-ScriptEngineFunctionInterlockedDecrement(long long volatile * Addend,
-                                         BOOL *               HasError)
+VOID
+ScriptEngineFunctionSpinlockUnlock(volatile LONG * Lock, BOOL * HasError)
 {
-    long long Result = 0;
+#ifdef SCRIPT_ENGINE_USER_MODE
+
+    SpinlockUnlock(Lock);
+
+#endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
 
-    if (!CheckAccessValidityAndSafety(Addend, sizeof(long long)))
+    if (!CheckAccessValidityAndSafety(Lock, sizeof(LONG)))
     {
         *HasError = TRUE;
-        return NULL;
+        return;
     }
 
-#endif // SCRIPT_ENGINE_KERNEL_MODE
-
-    Result = InterlockedDecrement64(Addend);
+    SpinlockUnlock(Lock);
 
-    return Result;
+#endif // SCRIPT_ENGINE_KERNEL_MODE
 }
 
 /**
- * @brief Implementation of interlocked_compare_exchange function
+ * @brief Implementation of spinlock_lock_custom_wait function
  *
- * @param Destination
- * @param ExChange
- * @param Comperand
+ * @param Lock
+ * @param MaxWait
  * @param HasError
- * @return long long
+ * @return VOID
  */
-long long
-ScriptEngineFunctionInterlockedCompareExchange(
-    long long volatile * Destination,
-    long long            ExChange,
-    long long            Comperand,
-    BOOL *               HasError)
+VOID
+ScriptEngineFunctionSpinlockLockCustomWait(volatile long * Lock, unsigned MaxWait, BOOL * HasError)
 {
-    long long Result = 0;
+#ifdef SCRIPT_ENGINE_USER_MODE
+
+    SpinlockLockWithCustomWait(Lock, MaxWait);
+
+#endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
 
-    if (!CheckAccessValidityAndSafety(Destination, sizeof(long long)))
+    if (!CheckAccessValidityAndSafety(Lock, sizeof(LONG)))
     {
         *HasError = TRUE;
-        return NULL;
+        return;
     }
 
+    SpinlockLockWithCustomWait(Lock, MaxWait);
+
 #endif // SCRIPT_ENGINE_KERNEL_MODE
+}
 
-    Result = InterlockedCompareExchange64(Destination, ExChange, Comperand);
+/**
+ * @brief Implementation of strlen function
+ *
+ * @param Address
+ * @return UINT64
+ */
+UINT64
+ScriptEngineFunctionStrlen(const char * Address)
+{
+    UINT64 Result = 0;
+#ifdef SCRIPT_ENGINE_USER_MODE
+    Result = strlen(Address);
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+    Result = VmFuncVmxCompatibleStrlen(Address);
+#endif // SCRIPT_ENGINE_KERNEL_MODE
 
     return Result;
 }
 
 /**
- * @brief Implementation of enable_event function
+ * @brief Implementation of disassemble_len function
  *
- * @param Tag
- * @param ImmediateMessagePassing
+ * @param Address
+ * @param Is32Bit
+ *
+ * @return UINT64
+ */
+UINT64
+ScriptEngineFunctionDisassembleLen(const char * Address, BOOLEAN Is32Bit)
+{
+    UINT64 Result = 0;
+#ifdef SCRIPT_ENGINE_USER_MODE
+    Result = HyperDbgLengthDisassemblerEngine((unsigned char *)Address, MAXIMUM_INSTR_SIZE, Is32Bit ? FALSE : TRUE);
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+    Result = DisassemblerLengthDisassembleEngineInVmxRootOnTargetProcess(Address, Is32Bit);
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+
+    return Result;
+}
+
+/**
+ * @brief Implementation of wcslen function
+ *
+ * @param Address
+ * @return UINT64
+ */
+UINT64
+ScriptEngineFunctionWcslen(const wchar_t * Address)
+{
+    UINT64 Result = 0;
+
+#ifdef SCRIPT_ENGINE_USER_MODE
+    Result = wcslen(Address);
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+    Result = VmFuncVmxCompatibleWcslen(Address);
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+
+    return Result;
+}
+
+/**
+ * @brief Implementation of interlocked_exchange function
+ *
+ * @param Target
+ * @param Value
+ * @param HasError
+ * @return long long
+ */
+long long
+ScriptEngineFunctionInterlockedExchange(long long volatile * Target,
+                                        long long            Value,
+                                        BOOL *               HasError)
+{
+    long long Result = 0;
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+
+    if (!CheckAccessValidityAndSafety(Target, sizeof(long long)))
+    {
+        *HasError = TRUE;
+        return NULL;
+    }
+
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+
+    Result = InterlockedExchange64(Target, Value);
+
+    return Result;
+}
+
+/**
+ * @brief Implementation of interlocked_exchange_add function
+ *
+ * @param Addend
+ * @param Value
+ * @param HasError
+ * @return long long
+ */
+long long
+ScriptEngineFunctionInterlockedExchangeAdd(long long volatile * Addend,
+                                           long long            Value,
+                                           BOOL *               HasError)
+{
+    long long Result = 0;
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+
+    if (!CheckAccessValidityAndSafety(Addend, sizeof(long long)))
+    {
+        *HasError = TRUE;
+        return NULL;
+    }
+
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+
+    Result = InterlockedExchangeAdd64(Addend, Value);
+
+    return Result;
+}
+
+/**
+ * @brief Implementation of interlocked_exchange_increment function
+ *
+ * @param Addend
+ * @param HasError
+ * @return long long
+ */
+long long
+ScriptEngineFunctionInterlockedIncrement(long long volatile * Addend,
+                                         BOOL *               HasError)
+{
+    long long Result = 0;
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+
+    if (!CheckAccessValidityAndSafety(Addend, sizeof(long long)))
+    {
+        *HasError = TRUE;
+        return NULL;
+    }
+
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+
+    Result = InterlockedIncrement64(Addend);
+
+    return Result;
+}
+
+/**
+ * @brief Implementation of interlocked_exchange_decrement function
+ *
+ * @param Addend
+ * @param HasError
+ * @return long long
+ */
+long long
+ScriptEngineFunctionInterlockedDecrement(long long volatile * Addend,
+                                         BOOL *               HasError)
+{
+    long long Result = 0;
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+
+    if (!CheckAccessValidityAndSafety(Addend, sizeof(long long)))
+    {
+        *HasError = TRUE;
+        return NULL;
+    }
+
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+
+    Result = InterlockedDecrement64(Addend);
+
+    return Result;
+}
+
+/**
+ * @brief Implementation of interlocked_compare_exchange function
+ *
+ * @param Destination
+ * @param ExChange
+ * @param Comperand
+ * @param HasError
+ * @return long long
+ */
+long long
+ScriptEngineFunctionInterlockedCompareExchange(
+    long long volatile * Destination,
+    long long            ExChange,
+    long long            Comperand,
+    BOOL *               HasError)
+{
+    long long Result = 0;
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+
+    if (!CheckAccessValidityAndSafety(Destination, sizeof(long long)))
+    {
+        *HasError = TRUE;
+        return NULL;
+    }
+
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+
+    Result = InterlockedCompareExchange64(Destination, ExChange, Comperand);
+
+    return Result;
+}
+
+/**
+ * @brief Implementation of enable_event function
+ *
+ * @param Tag
+ * @param ImmediateMessagePassing
+ * @param Value
+ * @return VOID
+ */
+VOID
+ScriptEngineFunctionEnableEvent(UINT64  Tag,
+                                BOOLEAN ImmediateMessagePassing,
+                                UINT64  Value)
+{
+#ifdef SCRIPT_ENGINE_USER_MODE
+    ShowMessages("err, enabling events is not possible in user-mode\n");
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+    if (!DebuggerEnableEvent(Value + DebuggerEventTagStartSeed))
+    {
+        LogInfo("Invalid tag id (%x)", Value);
+    }
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+}
+
+/**
+ * @brief Implementation of disable_event function
+ *
+ * @param Tag
+ * @param ImmediateMessagePassing
+ * @param Value
+ * @return VOID
+ */
+VOID
+ScriptEngineFunctionDisableEvent(UINT64  Tag,
+                                 BOOLEAN ImmediateMessagePassing,
+                                 UINT64  Value)
+{
+#ifdef SCRIPT_ENGINE_USER_MODE
+    ShowMessages("err, disabling events is not possible in user-mode\n");
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+    if (!DebuggerDisableEvent(Value + DebuggerEventTagStartSeed))
+    {
+        LogInfo("Invalid tag id (%x)", Value);
+    }
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+}
+
+/**
+ * @brief Implementation of event_add_range function
+ * @details the range is added to one of the slots of a monitor event
+ * (reserved by the 'slots' option of the event) and its pages are hooked
+ * directly from vmx-root
+ *
+ * @param EventId
+ * @param FromAddress
+ * @param ToAddress The end of the range (exclusive)
+ * @return UINT64 1 if the range is added, otherwise 0
+ */
+UINT64
+ScriptEngineFunctionEventAddRange(UINT64 EventId, UINT64 FromAddress, UINT64 ToAddress)
+{
+#ifdef SCRIPT_ENGINE_USER_MODE
+    ShowMessages("err, adding ranges to events is not possible in user-mode\n");
+    return 0;
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+    return DebuggerAddMonitorSlotRange(EventId + DebuggerEventTagStartSeed, FromAddress, ToAddress);
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+}
+
+/**
+ * @brief Implementation of event_remove_range function
+ * @details only the ranges that are added by event_add_range are removed
+ *
+ * @param EventId
+ * @param FromAddress
+ * @param ToAddress The end of the range (exclusive)
+ * @return UINT64 1 if the range is removed, otherwise 0
+ */
+UINT64
+ScriptEngineFunctionEventRemoveRange(UINT64 EventId, UINT64 FromAddress, UINT64 ToAddress)
+{
+#ifdef SCRIPT_ENGINE_USER_MODE
+    ShowMessages("err, removing ranges from events is not possible in user-mode\n");
+    return 0;
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+    return DebuggerRemoveMonitorSlotRange(EventId + DebuggerEventTagStartSeed, FromAddress, ToAddress);
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+}
+
+/**
+ * @brief Implementation of pause function
+ *
+ * @param Tag
+ * @param ImmediateMessagePassing
+ * @param GuestRegs
+ * @param Context
+ * @return VOID
+ */
+VOID
+ScriptEngineFunctionPause(UINT64      Tag,
+                          BOOLEAN     ImmediateMessagePassing,
+                          PGUEST_REGS GuestRegs,
+                          UINT64      Context)
+{
+#ifdef SCRIPT_ENGINE_USER_MODE
+    ShowMessages("err, breaking is not possible in user-mode\n");
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+
+    //
+    // pause(); function is only working when kernel debugger is working
+    // it's not designed to work on vmi-mode (local debugging)
+    //
+    if (g_KernelDebuggerState && g_DebuggeeHaltReason == DEBUGGEE_PAUSING_REASON_NOT_PAUSED)
+    {
+        DEBUGGER_TRIGGERED_EVENT_DETAILS ContextAndTag         = {0};
+        UINT32                           CurrentProcessorIndex = KeGetCurrentProcessorNumber();
+
+        //
+        // The staged messages of the script are shown before halting
+        //
+        ScriptEngineOutputFlush(&g_DbgState[CurrentProcessorIndex]);
+
+        if (VmFuncVmxGetCurrentExecutionMode() == TRUE)
+        {
+            //
+            // The guest is already in vmx-root mode
+            // Halt other cores
+            //
+            ContextAndTag.Tag     = Tag;
+            ContextAndTag.Context = Context;
+
+            KdHandleBreakpointAndDebugBreakpointsCallback(
+                CurrentProcessorIndex,
+                DEBUGGEE_PAUSING_REASON_DEBUGGEE_EVENT_TRIGGERED,
+                &ContextAndTag);
+        }
+        else
+        {
+            //
+            // The guest is on vmx non-root mode, the first parameter
+            // is context and the second parameter is tag
+            //
+            VmFuncVmxVmcall(DEBUGGER_VMCALL_VM_EXIT_HALT_SYSTEM_AS_A_RESULT_OF_TRIGGERING_EVENT, Context, Tag, GuestRegs);
+        }
+    }
+    else
+    {
+        LogInfo("The 'pause();' function is either called from the vmi-mode or is "
+                "evaluated by the '?' command. It's not allowed to use it on vmi-mode "
+                "(local debugging) or by the '?' command");
+    }
+
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+}
+
+/**
+ * @brief Implementation of flush function
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineFunctionFlush()
+{
+#ifdef SCRIPT_ENGINE_USER_MODE
+    ShowMessages("err, it's not possible to flush buffers in user-mode\n");
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+
+    //
+    // Mark all buffers as read
+    //
+    LogMarkAllAsRead(TRUE);
+    LogMarkAllAsRead(FALSE);
+
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+}
+
+/**
+ * @brief Implementation of stack function
+ * @details the return addresses are captured from the stack of the guest
+ * and sent as a stack trace record, the record is resolved to symbols
+ * by the user-mode, the stack is unwound based on the unwind info of the
+ * modules and it's scanned if it's not possible to unwind it
+ *
+ * @param GuestRegs
+ * @param Tag
+ * @param Count Maximum count of the return addresses
+ * @return VOID
+ */
+VOID
+ScriptEngineFunctionStack(PGUEST_REGS GuestRegs, UINT64 Tag, UINT64 Count)
+{
+#ifdef SCRIPT_ENGINE_USER_MODE
+    ShowMessages("err, it's not possible to capture the stack in user-mode\n");
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+
+    BYTE                       Buffer[sizeof(SCRIPT_STACK_TRACE_RECORD) + MaximumScriptStackTraceFrames * sizeof(UINT64)];
+    PSCRIPT_STACK_TRACE_RECORD Record = (PSCRIPT_STACK_TRACE_RECORD)Buffer;
+
+    if (Count == 0)
+    {
+        return;
+    }
+
+    Record->Tag         = Tag;
+    Record->Tsc         = __rdtsc();
+    Record->CoreId      = (UINT32)ScriptEnginePseudoRegGetCore();
+    Record->ProcessId   = (UINT32)ScriptEnginePseudoRegGetPid();
+    Record->ThreadId    = (UINT32)ScriptEnginePseudoRegGetTid();
+    Record->FramesCount = 0;
+
+    //
+    // The instruction pointer of the guest is only available in vmx-root
+    //
+    if (VmFuncVmxGetCurrentExecutionMode() == TRUE)
+    {
+        Record->FramesCount = CallstackUnwindFrames(&g_DbgState[KeGetCurrentProcessorNumber()],
+                                                    GuestRegs,
+                                                    VmFuncGetRip(),
+                                                    (UINT64 *)(Buffer + sizeof(SCRIPT_STACK_TRACE_RECORD)),
+                                                    NULL,
+                                                    (UINT32)min(Count, MaximumScriptStackTraceFrames));
+    }
+
+    if (Record->FramesCount == 0)
+    {
+        Record->FramesCount = CallstackCaptureReturnAddresses(GuestRegs->rsp,
+                                                              DebuggerScriptEngineStackTraceScanSize,
+                                                              (UINT64 *)(Buffer + sizeof(SCRIPT_STACK_TRACE_RECORD)),
+                                                              (UINT32)min(Count, MaximumScriptStackTraceFrames));
+    }
+
+    //
+    // The staged messages of the script are sent first to keep the order
+    // of messages
+    //
+    ScriptEngineOutputFlush(&g_DbgState[KeGetCurrentProcessorNumber()]);
+
+    LogCallbackSendBuffer(OPERATION_LOG_SCRIPT_STACK_TRACE_RECORD,
+                          Record,
+                          sizeof(SCRIPT_STACK_TRACE_RECORD) + Record->FramesCount * sizeof(UINT64),
+                          FALSE);
+
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+}
+
+/**
+ * @brief Implementation of event_ignore function
+ *
+ * @return VOID
+ */
+VOID
+ScriptEngineFunctionShortCircuitingEvent(UINT64 State)
+{
+#ifdef SCRIPT_ENGINE_USER_MODE
+    ShowMessages("err, it's not possible to short-circuit events in user-mode\n");
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+
+    UINT32 CurrentProcessorIndex = KeGetCurrentProcessorNumber();
+
+    if (State != 0)
+    {
+        g_DbgState[CurrentProcessorIndex].ShortCircuitingEvent = TRUE;
+    }
+    else
+    {
+        g_DbgState[CurrentProcessorIndex].ShortCircuitingEvent = FALSE;
+    }
+
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+}
+
+/**
+ * @brief Implementation of agg_count function
+ *
+ * @param MapId
+ * @param Key
+ * @return VOID
+ */
+VOID
+ScriptEngineFunctionAggregationCount(UINT64 MapId, UINT64 Key)
+{
+#ifdef SCRIPT_ENGINE_USER_MODE
+    ShowMessages("err, it's not possible to aggregate values in user-mode\n");
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+    ScriptEngineAggregationUpdate(SCRIPT_ENGINE_AGGREGATION_TYPE_COUNT, MapId, Key, 1);
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+}
+
+/**
+ * @brief Implementation of agg_sum function
+ *
+ * @param MapId
+ * @param Key
+ * @param Value
+ * @return UINT64 the sum of the key on the current core
+ */
+UINT64
+ScriptEngineFunctionAggregationSum(UINT64 MapId, UINT64 Key, UINT64 Value)
+{
+#ifdef SCRIPT_ENGINE_USER_MODE
+    ShowMessages("err, it's not possible to aggregate values in user-mode\n");
+    return NULL;
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+    return ScriptEngineAggregationUpdate(SCRIPT_ENGINE_AGGREGATION_TYPE_SUM, MapId, Key, Value);
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+}
+
+/**
+ * @brief Implementation of agg_min function
+ *
+ * @param MapId
+ * @param Key
+ * @param Value
+ * @return UINT64 the minimum of the key on the current core
+ */
+UINT64
+ScriptEngineFunctionAggregationMin(UINT64 MapId, UINT64 Key, UINT64 Value)
+{
+#ifdef SCRIPT_ENGINE_USER_MODE
+    ShowMessages("err, it's not possible to aggregate values in user-mode\n");
+    return NULL;
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+    return ScriptEngineAggregationUpdate(SCRIPT_ENGINE_AGGREGATION_TYPE_MIN, MapId, Key, Value);
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+}
+
+/**
+ * @brief Implementation of agg_max function
+ *
+ * @param MapId
+ * @param Key
+ * @param Value
+ * @return UINT64 the maximum of the key on the current core
+ */
+UINT64
+ScriptEngineFunctionAggregationMax(UINT64 MapId, UINT64 Key, UINT64 Value)
+{
+#ifdef SCRIPT_ENGINE_USER_MODE
+    ShowMessages("err, it's not possible to aggregate values in user-mode\n");
+    return NULL;
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+    return ScriptEngineAggregationUpdate(SCRIPT_ENGINE_AGGREGATION_TYPE_MAX, MapId, Key, Value);
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+}
+
+/**
+ * @brief Implementation of agg_hist function
+ * @details the values are counted in power of 2 buckets
+ *
+ * @param MapId
  * @param Value
  * @return VOID
  */
 VOID
-ScriptEngineFunctionEnableEvent(UINT64  Tag,
-                                BOOLEAN ImmediateMessagePassing,
-                                UINT64  Value)
+ScriptEngineFunctionAggregationHistogram(UINT64 MapId, UINT64 Value)
 {
 #ifdef SCRIPT_ENGINE_USER_MODE
-    ShowMessages("err, enabling events is not possible in user-mode\n");
+    ShowMessages("err, it's not possible to aggregate values in user-mode\n");
 #endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
-    if (!DebuggerEnableEvent(Value + DebuggerEventTagStartSeed))
+
+    unsigned long HighestBit = 0;
+    UINT64        Bucket     = 0;
+
+    //
+    // Bucket zero is for zero, bucket n is for [2^(n-1), 2^n - 1]
+    //
+    if (_BitScanReverse64(&HighestBit, Value))
     {
-        LogInfo("Invalid tag id (%x)", Value);
+        Bucket = HighestBit + 1;
     }
+
+    ScriptEngineAggregationUpdate(SCRIPT_ENGINE_AGGREGATION_TYPE_HISTOGRAM, MapId, Bucket, Value);
+
 #endif // SCRIPT_ENGINE_KERNEL_MODE
 }
 
 /**
- * @brief Implementation of disable_event function
+ * @brief Implementation of agg_print function
  *
  * @param Tag
  * @param ImmediateMessagePassing
- * @param Value
+ * @param MapId
  * @return VOID
  */
 VOID
-ScriptEngineFunctionDisableEvent(UINT64  Tag,
-                                 BOOLEAN ImmediateMessagePassing,
-                                 UINT64  Value)
+ScriptEngineFunctionAggregationPrint(UINT64 Tag, BOOLEAN ImmediateMessagePassing, UINT64 MapId)
 {
 #ifdef SCRIPT_ENGINE_USER_MODE
-    ShowMessages("err, disabling events is not possible in user-mode\n");
+    ShowMessages("err, it's not possible to aggregate values in user-mode\n");
 #endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
-    if (!DebuggerDisableEvent(Value + DebuggerEventTagStartSeed))
-    {
-        LogInfo("Invalid tag id (%x)", Value);
-    }
+    ScriptEngineAggregationPrint(Tag, ImmediateMessagePassing, MapId);
 #endif // SCRIPT_ENGINE_KERNEL_MODE
 }
 
 /**
- * @brief Implementation of pause function
+ * @brief Implementation of agg_clear function
  *
- * @param Tag
- * @param ImmediateMessagePassing
- * @param GuestRegs
- * @param Context
+ * @param MapId
  * @return VOID
  */
 VOID
-ScriptEngineFunctionPause(UINT64      Tag,
-                          BOOLEAN     ImmediateMessagePassing,
-                          PGUEST_REGS GuestRegs,
-                          UINT64      Context)
+ScriptEngineFunctionAggregationClear(UINT64 MapId)
 {
 #ifdef SCRIPT_ENGINE_USER_MODE
-    ShowMessages("err, breaking is not possible in user-mode\n");
+    ShowMessages("err, it's not possible to aggregate values in user-mode\n");
 #endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
+    ScriptEngineAggregationClear(MapId);
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+}
 
-    //
-    // pause(); function is only working when kernel debugger is working
-    // it's not designed to work on vmi-mode (local debugging)
-    //
-    if (g_KernelDebuggerState && g_DebuggeeHaltReason == DEBUGGEE_PAUSING_REASON_NOT_PAUSED)
-    {
-        DEBUGGER_TRIGGERED_EVENT_DETAILS ContextAndTag         = {0};
-        UINT32                           CurrentProcessorIndex = KeGetCurrentProcessorNumber();
-
-        if (VmFuncVmxGetCurrentExecutionMode() == TRUE)
-        {
-            //
-            // The guest is already in vmx-root mode
-            // Halt other cores
-            //
-            ContextAndTag.Tag     = Tag;
-            ContextAndTag.Context = Context;
-
-            KdHandleBreakpointAndDebugBreakpointsCallback(
-                CurrentProcessorIndex,
-                DEBUGGEE_PAUSING_REASON_DEBUGGEE_EVENT_TRIGGERED,
-                &ContextAndTag);
-        }
-        else
-        {
-            //
-            // The guest is on vmx non-root mode, the first parameter
-            // is context and the second parameter is tag
-            //
-            VmFuncVmxVmcall(DEBUGGER_VMCALL_VM_EXIT_HALT_SYSTEM_AS_A_RESULT_OF_TRIGGERING_EVENT, Context, Tag, GuestRegs);
-        }
-    }
-    else
+/**
+ * @brief Get the index of a local variable from its reference
+ *
+ * @param LocalVariablesList Local variables of the current core
+ * @param Address Reference to the local variable
+ * @param Index The index of the local variable
+ * @return BOOLEAN FALSE if the address is not a local variable
+ */
+static BOOLEAN
+ScriptEngineFunctionGetLocalVariableIndex(UINT64 * LocalVariablesList, UINT64 Address, UINT32 * Index)
+{
+    if (Address < (UINT64)LocalVariablesList ||
+        Address >= (UINT64)&LocalVariablesList[MAX_VAR_COUNT] ||
+        (Address - (UINT64)LocalVariablesList) % sizeof(UINT64) != 0)
     {
-        LogInfo("The 'pause();' function is either called from the vmi-mode or is "
-                "evaluated by the '?' command. It's not allowed to use it on vmi-mode "
-                "(local debugging) or by the '?' command");
+        return FALSE;
     }
 
-#endif // SCRIPT_ENGINE_KERNEL_MODE
+    *Index = (UINT32)((Address - (UINT64)LocalVariablesList) / sizeof(UINT64));
+
+    return TRUE;
 }
 
 /**
- * @brief Implementation of flush function
+ * @brief Implementation of percpu_sum function
  *
- * @return VOID
+ * @param LocalVariablesList Local variables of the current core
+ * @param Address Reference to a local variable
+ * @param HasError
+ * @return UINT64 the sum of the local variable on all cores
  */
-VOID
-ScriptEngineFunctionFlush()
+UINT64
+ScriptEngineFunctionPerCoreSum(UINT64 * LocalVariablesList, UINT64 Address, BOOL * HasError)
 {
+    UINT32 Index;
+
+    if (!ScriptEngineFunctionGetLocalVariableIndex(LocalVariablesList, Address, &Index))
+    {
+        *HasError = TRUE;
+        return NULL;
+    }
+
 #ifdef SCRIPT_ENGINE_USER_MODE
-    ShowMessages("err, it's not possible to flush buffers in user-mode\n");
+    return LocalVariablesList[Index];
 #endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
-
-    //
-    // Mark all buffers as read
-    //
-    LogMarkAllAsRead(TRUE);
-    LogMarkAllAsRead(FALSE);
-
+    return ScriptEngineReducePerCoreVariable(SCRIPT_ENGINE_PER_CORE_REDUCTION_SUM, Index);
 #endif // SCRIPT_ENGINE_KERNEL_MODE
 }
 
 /**
- * @brief Implementation of event_ignore function
+ * @brief Implementation of percpu_min function
  *
- * @return VOID
+ * @param LocalVariablesList Local variables of the current core
+ * @param Address Reference to a local variable
+ * @param HasError
+ * @return UINT64 the minimum of the local variable on all cores
  */
-VOID
-ScriptEngineFunctionShortCircuitingEvent(UINT64 State)
+UINT64
+ScriptEngineFunctionPerCoreMin(UINT64 * LocalVariablesList, UINT64 Address, BOOL * HasError)
 {
+    UINT32 Index;
+
+    if (!ScriptEngineFunctionGetLocalVariableIndex(LocalVariablesList, Address, &Index))
+    {
+        *HasError = TRUE;
+        return NULL;
+    }
+
 #ifdef SCRIPT_ENGINE_USER_MODE
-    ShowMessages("err, it's not possible to short-circuit events in user-mode\n");
+    return LocalVariablesList[Index];
 #endif // SCRIPT_ENGINE_USER_MODE
 
 #ifdef SCRIPT_ENGINE_KERNEL_MODE
+    return ScriptEngineReducePerCoreVariable(SCRIPT_ENGINE_PER_CORE_REDUCTION_MIN, Index);
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+}
 
-    UINT32 CurrentProcessorIndex = KeGetCurrentProcessorNumber();
+/**
+ * @brief Implementation of percpu_max function
+ *
+ * @param LocalVariablesList Local variables of the current core
+ * @param Address Reference to a local variable
+ * @param HasError
+ * @return UINT64 the maximum of the local variable on all cores
+ */
+UINT64
+ScriptEngineFunctionPerCoreMax(UINT64 * LocalVariablesList, UINT64 Address, BOOL * HasError)
+{
+    UINT32 Index;
 
-    if (State != 0)
-    {
-        g_DbgState[CurrentProcessorIndex].ShortCircuitingEvent = TRUE;
-    }
-    else
+    if (!ScriptEngineFunctionGetLocalVariableIndex(LocalVariablesList, Address, &Index))
     {
-        g_DbgState[CurrentProcessorIndex].ShortCircuitingEvent = FALSE;
+        *HasError = TRUE;
+        return NULL;
     }
 
+#ifdef SCRIPT_ENGINE_USER_MODE
+    return LocalVariablesList[Index];
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+    return ScriptEngineReducePerCoreVariable(SCRIPT_ENGINE_PER_CORE_REDUCTION_MAX, Index);
 #endif // SCRIPT_ENGINE_KERNEL_MODE
 }
 
@@ -1116,80 +2015,299 @@ ApplyStringFormatSpecifier(const CHAR * CurrentSpecifier, CHAR * FinalBuffer, PU
             RtlZeroMemory(AsciiBuffer, sizeof(AsciiBuffer));
 
             //
-            // Check for the last block
+            // Check for the last block
+            //
+            if (i == CountOfBlocks - 1)
+            {
+                //
+                // A portion of block
+                //
+
+#ifdef SCRIPT_ENGINE_USER_MODE
+                memcpy(WstrBuffer, (void *)(Val + (i * sizeof(WstrBuffer))), StringSizeInByte % sizeof(WstrBuffer));
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+                MemoryMapperReadMemorySafeOnTargetProcess(
+                    (void *)(Val + (i * sizeof(WstrBuffer))),
+                    WstrBuffer,
+                    StringSizeInByte % sizeof(WstrBuffer));
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+            }
+            else
+            {
+                //
+                // A complete block
+                //
+
+#ifdef SCRIPT_ENGINE_USER_MODE
+                memcpy(WstrBuffer, (void *)(Val + (i * sizeof(WstrBuffer))), sizeof(WstrBuffer));
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+                MemoryMapperReadMemorySafeOnTargetProcess(
+                    (void *)(Val + (i * sizeof(WstrBuffer))),
+                    WstrBuffer,
+                    sizeof(WstrBuffer));
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+            }
+
+            //
+            // Here we have the filled WstrBuffer
+            // We should convert WstrBuffer to AsciiBuffer
+            //
+            CopiedBlockLen =
+                WcharToChar(WstrBuffer, AsciiBuffer, sizeof(AsciiBuffer) + 1);
+
+            //
+            // Now we should move the AsciiBuffer to the target buffer
+            // (when we filled AsciiBuffer the memory here is safe so we
+            // can use memcpy in both user-mode and vmx-root mode)
+            //
+            memcpy(&FinalBuffer[*CurrentPositionInFinalBuffer], (void *)AsciiBuffer, CopiedBlockLen + 1);
+
+            *CurrentPositionInFinalBuffer += CopiedBlockLen + 1;
+        }
+    }
+    else
+    {
+        //
+        // Parse string
+        //
+#ifdef SCRIPT_ENGINE_USER_MODE
+        memcpy(&FinalBuffer[*CurrentPositionInFinalBuffer], (void *)Val, StringSize);
+#endif // SCRIPT_ENGINE_USER_MODE
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+        MemoryMapperReadMemorySafeOnTargetProcess(
+            Val,
+            &FinalBuffer[*CurrentPositionInFinalBuffer],
+            StringSize);
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+
+        *CurrentPositionInFinalBuffer += StringSize;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether the format specifier of an argument of printf is a string
+ * specifier (%s, %ws or %ls)
+ *
+ * @param Format
+ * @param Position Position of the format specifier
+ * @return BOOLEAN
+ */
+BOOLEAN
+ScriptEngineIsStringFormatSpecifier(const char * Format, UINT32 Position)
+{
+    if (Format[Position] != '%')
+    {
+        return FALSE;
+    }
+
+    return Format[Position + 1] == 's' ||
+           ((Format[Position + 1] == 'w' || Format[Position + 1] == 'l') && Format[Position + 2] == 's');
+}
+
+/**
+ * @brief Apply an argument of printf to the final buffer
+ *
+ * @param Format
+ * @param Position Position of the format specifier of the argument
+ * @param Val Value of the argument
+ * @param FinalBuffer
+ * @param SizeOfFinalBuffer
+ * @param CurrentProcessedPositionFromStartOfFormat
+ * @param CurrentPositionInFinalBuffer
+ * @return BOOLEAN FALSE if the argument is not valid (unsafe strings)
+ */
+BOOLEAN
+ScriptEngineApplyPrintfArgument(const char * Format,
+                                UINT32       Position,
+                                UINT64       Val,
+                                CHAR *       FinalBuffer,
+                                UINT32       SizeOfFinalBuffer,
+                                PUINT32      CurrentProcessedPositionFromStartOfFormat,
+                                PUINT32      CurrentPositionInFinalBuffer)
+{
+    CHAR PercentageChar = Format[Position];
+
+    if (*CurrentProcessedPositionFromStartOfFormat != Position)
+    {
+        //
+        // There is some strings before this format specifier
+        // we should move it to the buffer
+        //
+        UINT32 StringLen = Position - *CurrentProcessedPositionFromStartOfFormat;
+
+        //
+        // Check final buffer capacity
+        //
+        if (*CurrentPositionInFinalBuffer + StringLen < SizeOfFinalBuffer)
+        {
+            memcpy(&FinalBuffer[*CurrentPositionInFinalBuffer],
+                   &Format[*CurrentProcessedPositionFromStartOfFormat],
+                   StringLen);
+
+            *CurrentProcessedPositionFromStartOfFormat += StringLen;
+            *CurrentPositionInFinalBuffer += StringLen;
+        }
+    }
+
+    //
+    // Double check and apply
+    //
+    if (PercentageChar == '%')
+    {
+        //
+        // Set first character of specifier
+        //
+        CHAR FormatSpecifier[5] = {0};
+        FormatSpecifier[0]      = '%';
+
+        //
+        // Read second char
+        //
+        CHAR IndicatorChar2 = Format[Position + 1];
+
+        //
+        // Check if IndicatorChar2 is 2 character long or more
+        //
+        if (IndicatorChar2 == 'l' || IndicatorChar2 == 'w' ||
+            IndicatorChar2 == 'h')
+        {
+            //
+            // Set second char in format specifier
             //
-            if (i == CountOfBlocks - 1)
+            FormatSpecifier[1] = IndicatorChar2;
+
+            if (IndicatorChar2 == 'l' && Format[Position + 2] == 'l')
             {
                 //
-                // A portion of block
+                // Set third character in format specifier "ll"
                 //
+                FormatSpecifier[2] = 'l';
 
-#ifdef SCRIPT_ENGINE_USER_MODE
-                memcpy(WstrBuffer, (void *)(Val + (i * sizeof(WstrBuffer))), StringSizeInByte % sizeof(WstrBuffer));
-#endif // SCRIPT_ENGINE_USER_MODE
-
-#ifdef SCRIPT_ENGINE_KERNEL_MODE
-                MemoryMapperReadMemorySafeOnTargetProcess(
-                    (void *)(Val + (i * sizeof(WstrBuffer))),
-                    WstrBuffer,
-                    StringSizeInByte % sizeof(WstrBuffer));
-#endif // SCRIPT_ENGINE_KERNEL_MODE
+                //
+                // Set last character
+                //
+                FormatSpecifier[3] = Format[Position + 3];
             }
             else
             {
                 //
-                // A complete block
+                // Set last character
                 //
-
-#ifdef SCRIPT_ENGINE_USER_MODE
-                memcpy(WstrBuffer, (void *)(Val + (i * sizeof(WstrBuffer))), sizeof(WstrBuffer));
-#endif // SCRIPT_ENGINE_USER_MODE
-
-#ifdef SCRIPT_ENGINE_KERNEL_MODE
-                MemoryMapperReadMemorySafeOnTargetProcess(
-                    (void *)(Val + (i * sizeof(WstrBuffer))),
-                    WstrBuffer,
-                    sizeof(WstrBuffer));
-#endif // SCRIPT_ENGINE_KERNEL_MODE
+                FormatSpecifier[2] = Format[Position + 2];
             }
-
+        }
+        else
+        {
             //
-            // Here we have the filled WstrBuffer
-            // We should convert WstrBuffer to AsciiBuffer
+            // It's a one char specifier (Set last character)
             //
-            CopiedBlockLen =
-                WcharToChar(WstrBuffer, AsciiBuffer, sizeof(AsciiBuffer) + 1);
+            FormatSpecifier[1] = IndicatorChar2;
+        }
 
+        //
+        // Apply the specifier
+        //
+        if (!strncmp(FormatSpecifier, "%s", 2))
+        {
             //
-            // Now we should move the AsciiBuffer to the target buffer
-            // (when we filled AsciiBuffer the memory here is safe so we
-            // can use memcpy in both user-mode and vmx-root mode)
+            // for string
             //
-            memcpy(&FinalBuffer[*CurrentPositionInFinalBuffer], (void *)AsciiBuffer, CopiedBlockLen + 1);
+            if (!ApplyStringFormatSpecifier(
+                    "%s",
+                    FinalBuffer,
+                    CurrentProcessedPositionFromStartOfFormat,
+                    CurrentPositionInFinalBuffer,
+                    Val,
+                    FALSE,
+                    SizeOfFinalBuffer))
+            {
+                return FALSE;
+            }
+        }
+        else if (!strncmp(FormatSpecifier, "%ls", 3) ||
+                 !strncmp(FormatSpecifier, "%ws", 3))
+        {
+            //
+            // for wide string (not important if %ls or %ws , only the length is
+            // important)
+            //
+            if (!ApplyStringFormatSpecifier(
+                    "%ws",
+                    FinalBuffer,
+                    CurrentProcessedPositionFromStartOfFormat,
+                    CurrentPositionInFinalBuffer,
+                    Val,
+                    TRUE,
+                    SizeOfFinalBuffer))
+            {
+                return FALSE;
+            }
+        }
+        else
+        {
+            ApplyFormatSpecifier(FormatSpecifier, FinalBuffer, CurrentProcessedPositionFromStartOfFormat, CurrentPositionInFinalBuffer, Val, SizeOfFinalBuffer);
+        }
+    }
 
-            *CurrentPositionInFinalBuffer += CopiedBlockLen + 1;
+    return TRUE;
+}
+
+/**
+ * @brief Move the rest of the format string (after the last argument) to the final buffer
+ *
+ * @param Format
+ * @param WithoutAnyFormatSpecifier
+ * @param FinalBuffer
+ * @param SizeOfFinalBuffer
+ * @param CurrentProcessedPositionFromStartOfFormat
+ * @param CurrentPositionInFinalBuffer
+ * @return VOID
+ */
+VOID
+ScriptEngineFinishPrintfBuffer(const char * Format,
+                               BOOLEAN      WithoutAnyFormatSpecifier,
+                               CHAR *       FinalBuffer,
+                               UINT32       SizeOfFinalBuffer,
+                               UINT32       CurrentProcessedPositionFromStartOfFormat,
+                               UINT32       CurrentPositionInFinalBuffer)
+{
+    UINT32 LenOfFormats = strlen(Format) + 1;
+
+    if (WithoutAnyFormatSpecifier)
+    {
+        //
+        // Means that it's just a simple print without any format specifier
+        //
+        if (LenOfFormats < SizeOfFinalBuffer)
+        {
+            memcpy(FinalBuffer, Format, LenOfFormats);
         }
     }
     else
     {
         //
-        // Parse string
+        // Check if there is anything after the last format specifier
         //
-#ifdef SCRIPT_ENGINE_USER_MODE
-        memcpy(&FinalBuffer[*CurrentPositionInFinalBuffer], (void *)Val, StringSize);
-#endif // SCRIPT_ENGINE_USER_MODE
-
-#ifdef SCRIPT_ENGINE_KERNEL_MODE
-        MemoryMapperReadMemorySafeOnTargetProcess(
-            Val,
-            &FinalBuffer[*CurrentPositionInFinalBuffer],
-            StringSize);
-#endif // SCRIPT_ENGINE_KERNEL_MODE
+        if (LenOfFormats > CurrentProcessedPositionFromStartOfFormat)
+        {
+            UINT32 RemainedLen =
+                LenOfFormats - CurrentProcessedPositionFromStartOfFormat;
 
-        *CurrentPositionInFinalBuffer += StringSize;
+            if (CurrentPositionInFinalBuffer + RemainedLen < SizeOfFinalBuffer)
+            {
+                memcpy(&FinalBuffer[CurrentPositionInFinalBuffer],
+                       &Format[CurrentProcessedPositionFromStartOfFormat],
+                       RemainedLen);
+            }
+        }
     }
-
-    return TRUE;
 }
 
 /**
@@ -1228,7 +2346,6 @@ ScriptEngineFunctionPrintf(PGUEST_REGS                    GuestRegs,
 
     UINT64  Val;
     UINT32  Position;
-    UINT32  LenOfFormats = strlen(Format) + 1;
     PSYMBOL Symbol;
 
     *HasError = FALSE;
@@ -1250,180 +2367,199 @@ ScriptEngineFunctionPrintf(PGUEST_REGS                    GuestRegs,
 
         Val = GetValue(GuestRegs, ActionDetail, VariablesList, &TempSymbol, FALSE);
 
-        CHAR PercentageChar = Format[Position];
-
-        /*
-    printf("position = %d is %c%c \n", Position, PercentageChar,
-           IndicatorChar1);
-           */
-
-        if (CurrentProcessedPositionFromStartOfFormat != Position)
+        if (!ScriptEngineApplyPrintfArgument(Format,
+                                             Position,
+                                             Val,
+                                             FinalBuffer,
+                                             sizeof(FinalBuffer),
+                                             &CurrentProcessedPositionFromStartOfFormat,
+                                             &CurrentPositionInFinalBuffer))
         {
-            //
-            // There is some strings before this format specifier
-            // we should move it to the buffer
-            //
-            UINT32 StringLen = Position - CurrentProcessedPositionFromStartOfFormat;
+            *HasError = TRUE;
+            return;
+        }
+    }
 
-            //
-            // Check final buffer capacity
-            //
-            if (CurrentPositionInFinalBuffer + StringLen < sizeof(FinalBuffer))
-            {
-                memcpy(&FinalBuffer[CurrentPositionInFinalBuffer],
-                       &Format[CurrentProcessedPositionFromStartOfFormat],
-                       StringLen);
+    ScriptEngineFinishPrintfBuffer(Format,
+                                   WithoutAnyFormatSpecifier,
+                                   FinalBuffer,
+                                   sizeof(FinalBuffer),
+                                   CurrentProcessedPositionFromStartOfFormat,
+                                   CurrentPositionInFinalBuffer);
 
-                CurrentProcessedPositionFromStartOfFormat += StringLen;
-                CurrentPositionInFinalBuffer += StringLen;
-            }
-        }
+//
+// Print final result
+//
+#ifdef SCRIPT_ENGINE_USER_MODE
+    printf("%s", FinalBuffer);
+#endif // SCRIPT_ENGINE_USER_MODE
 
-        //
-        // Double check and apply
-        //
-        if (PercentageChar == '%')
-        {
-            //
-            // Set first character of specifier
-            //
-            CHAR FormatSpecifier[5] = {0};
-            FormatSpecifier[0]      = '%';
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
 
-            //
-            // Read second char
-            //
-            CHAR IndicatorChar2 = Format[Position + 1];
+    //
+    // The message is staged and sent with the other messages of the script
+    //
+    ScriptEngineOutputMessage(Tag, ImmediateMessagePassing, FinalBuffer, (UINT32)strlen(FinalBuffer));
 
-            //
-            // Check if IndicatorChar2 is 2 character long or more
-            //
-            if (IndicatorChar2 == 'l' || IndicatorChar2 == 'w' ||
-                IndicatorChar2 == 'h')
-            {
-                //
-                // Set second char in format specifier
-                //
-                FormatSpecifier[1] = IndicatorChar2;
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+}
 
-                if (IndicatorChar2 == 'l' && Format[Position + 2] == 'l')
-                {
-                    //
-                    // Set third character in format specifier "ll"
-                    //
-                    FormatSpecifier[2] = 'l';
-
-                    //
-                    // Set last character
-                    //
-                    FormatSpecifier[3] = Format[Position + 3];
-                }
-                else
-                {
-                    //
-                    // Set last character
-                    //
-                    FormatSpecifier[2] = Format[Position + 2];
-                }
-            }
-            else
-            {
-                //
-                // It's a one char specifier (Set last character)
-                //
-                FormatSpecifier[1] = IndicatorChar2;
-            }
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
 
-            //
-            // Apply the specifier
-            //
-            if (!strncmp(FormatSpecifier, "%s", 2))
-            {
-                //
-                // for string
-                //
-                if (!ApplyStringFormatSpecifier(
-                        "%s",
-                        FinalBuffer,
-                        &CurrentProcessedPositionFromStartOfFormat,
-                        &CurrentPositionInFinalBuffer,
-                        Val,
-                        FALSE,
-                        sizeof(FinalBuffer)))
-                {
-                    *HasError = TRUE;
-                    return;
-                }
-            }
-            else if (!strncmp(FormatSpecifier, "%ls", 3) ||
-                     !strncmp(FormatSpecifier, "%ws", 3))
-            {
-                //
-                // for wide string (not important if %ls or %ws , only the length is
-                // important)
-                //
-                if (!ApplyStringFormatSpecifier(
-                        "%ws",
-                        FinalBuffer,
-                        &CurrentProcessedPositionFromStartOfFormat,
-                        &CurrentPositionInFinalBuffer,
-                        Val,
-                        TRUE,
-                        sizeof(FinalBuffer)))
-                {
-                    *HasError = TRUE;
-                    return;
-                }
-            }
-            else
-            {
-                ApplyFormatSpecifier(FormatSpecifier, FinalBuffer, &CurrentProcessedPositionFromStartOfFormat, &CurrentPositionInFinalBuffer, Val, sizeof(FinalBuffer));
-            }
-        }
-    }
+/**
+ * @brief Implementation of printf function in the binary trace mode
+ * @details only the identifier of the format string and the raw values of
+ * arguments are saved and the message is formatted by the user-mode, string
+ * arguments (%s, %ws, %ls) are not supported as the strings might not be
+ * valid when the message is formatted, in this case (or if the binary trace
+ * mode is disabled) the caller should use ScriptEngineFunctionPrintf
+ *
+ * @param GuestRegs
+ * @param ActionDetail
+ * @param VariablesList
+ * @param Tag
+ * @param Format
+ * @param FormatId The identifier of the format string (zero if it's not computed)
+ * @param ArgCount
+ * @param FirstArg
+ * @return BOOLEAN TRUE if the binary trace record is saved
+ */
+BOOLEAN
+ScriptEngineFunctionPrintfBinary(PGUEST_REGS                    GuestRegs,
+                                 ACTION_BUFFER *                ActionDetail,
+                                 SCRIPT_ENGINE_VARIABLES_LIST * VariablesList,
+                                 UINT64                         Tag,
+                                 char *                         Format,
+                                 UINT32                         FormatId,
+                                 UINT64                         ArgCount,
+                                 PSYMBOL                        FirstArg)
+{
+    BYTE                   Buffer[sizeof(BINARY_TRACE_RECORD) + MaximumBinaryTraceArguments * sizeof(BINARY_TRACE_ARGUMENT)];
+    PBINARY_TRACE_RECORD   Record    = (PBINARY_TRACE_RECORD)Buffer;
+    PBINARY_TRACE_ARGUMENT Arguments = (PBINARY_TRACE_ARGUMENT)(Buffer + sizeof(BINARY_TRACE_RECORD));
+    PSYMBOL                Symbol;
 
-    if (WithoutAnyFormatSpecifier)
+    //
+    // Messages are formatted in the user-mode of the debuggee, so the binary
+    // records are not used if the messages are sent to the kernel debugger
+    //
+    if (!g_BinaryTraceMode || g_KernelDebuggerState || ArgCount > MaximumBinaryTraceArguments)
     {
-        //
-        // Means that it's just a simple print without any format specifier
-        //
-        if (LenOfFormats < sizeof(FinalBuffer))
-        {
-            memcpy(FinalBuffer, Format, LenOfFormats);
-        }
+        return FALSE;
     }
-    else
+
+    //
+    // Check the specifiers before evaluating the arguments
+    //
+    for (UINT32 i = 0; i < ArgCount; i++)
     {
-        //
-        // Check if there is anything after the last format specifier
-        //
-        if (LenOfFormats > CurrentProcessedPositionFromStartOfFormat)
+        if (ScriptEngineIsStringFormatSpecifier(Format, (UINT32)(FirstArg[i].Type >> 32) + 1))
         {
-            UINT32 RemainedLen =
-                LenOfFormats - CurrentProcessedPositionFromStartOfFormat;
-
-            if (CurrentPositionInFinalBuffer + RemainedLen < sizeof(FinalBuffer))
-            {
-                memcpy(&FinalBuffer[CurrentPositionInFinalBuffer],
-                       &Format[CurrentProcessedPositionFromStartOfFormat],
-                       RemainedLen);
-            }
+            return FALSE;
         }
     }
 
-//
-// Print final result
-//
-#ifdef SCRIPT_ENGINE_USER_MODE
-    printf("%s", FinalBuffer);
-#endif // SCRIPT_ENGINE_USER_MODE
+    Record->Tag            = Tag;
+    Record->Tsc            = __rdtsc();
+    Record->FormatId       = FormatId != 0 ? FormatId : BinaryTraceGetFormatId(Format);
+    Record->ArgumentsCount = (UINT32)ArgCount;
+    Record->CoreId         = (UINT32)ScriptEnginePseudoRegGetCore();
+    Record->ProcessId      = (UINT32)ScriptEnginePseudoRegGetPid();
+    Record->ThreadId       = (UINT32)ScriptEnginePseudoRegGetTid();
+    Record->Reserved       = 0;
 
-#ifdef SCRIPT_ENGINE_KERNEL_MODE
+    for (UINT32 i = 0; i < ArgCount; i++)
+    {
+        Symbol = FirstArg + i;
+
+        SYMBOL TempSymbol = {0};
+        memcpy(&TempSymbol, Symbol, sizeof(SYMBOL));
+        TempSymbol.Type &= 0x7fffffff;
+
+        Arguments[i].Value    = GetValue(GuestRegs, ActionDetail, VariablesList, &TempSymbol, FALSE);
+        Arguments[i].Position = (UINT32)(Symbol->Type >> 32) + 1;
+        Arguments[i].Reserved = 0;
+    }
 
     //
-    // Prepare a buffer to bypass allocating a huge stack space for logging
+    // Each record is saved as a separate message (it's not accumulated
+    // with non-immediate messages), the staged messages of the script are
+    // sent first to keep the order of messages
     //
-    LogSimpleWithTag(Tag, ImmediateMessagePassing, FinalBuffer, strlen(FinalBuffer) + 1);
+    ScriptEngineOutputFlush(&g_DbgState[KeGetCurrentProcessorNumber()]);
+
+    LogCallbackSendBuffer(OPERATION_LOG_BINARY_TRACE_RECORD,
+                          Record,
+                          sizeof(BINARY_TRACE_RECORD) + Record->ArgumentsCount * sizeof(BINARY_TRACE_ARGUMENT),
+                          FALSE);
+
+    return TRUE;
+}
 
 #endif // SCRIPT_ENGINE_KERNEL_MODE
+
+#ifdef SCRIPT_ENGINE_USER_MODE
+
+/**
+ * @brief Format a binary trace record (the result of printf in the binary trace mode)
+ *
+ * @param Record The record (followed by its arguments)
+ * @param RecordLength Length of the record and its arguments
+ * @param Format The format string of the record
+ * @param FinalBuffer
+ * @param SizeOfFinalBuffer
+ * @return BOOLEAN FALSE if the record is not valid
+ */
+BOOLEAN
+ScriptEngineFormatBinaryTraceRecord(PBINARY_TRACE_RECORD Record,
+                                    UINT32               RecordLength,
+                                    const char *         Format,
+                                    CHAR *               FinalBuffer,
+                                    UINT32               SizeOfFinalBuffer)
+{
+    PBINARY_TRACE_ARGUMENT Arguments                                 = (PBINARY_TRACE_ARGUMENT)((CHAR *)Record + sizeof(BINARY_TRACE_RECORD));
+    UINT32                 CurrentPositionInFinalBuffer              = 0;
+    UINT32                 CurrentProcessedPositionFromStartOfFormat = 0;
+    UINT32                 LenOfFormat                               = strlen(Format);
+
+    if (RecordLength < sizeof(BINARY_TRACE_RECORD) ||
+        Record->ArgumentsCount > MaximumBinaryTraceArguments ||
+        RecordLength < sizeof(BINARY_TRACE_RECORD) + Record->ArgumentsCount * sizeof(BINARY_TRACE_ARGUMENT))
+    {
+        return FALSE;
+    }
+
+    RtlZeroMemory(FinalBuffer, SizeOfFinalBuffer);
+
+    for (UINT32 i = 0; i < Record->ArgumentsCount; i++)
+    {
+        //
+        // Arguments are in order and strings are never saved in the records
+        //
+        if (Arguments[i].Position >= LenOfFormat ||
+            Arguments[i].Position < CurrentProcessedPositionFromStartOfFormat ||
+            ScriptEngineIsStringFormatSpecifier(Format, Arguments[i].Position))
+        {
+            return FALSE;
+        }
+
+        ScriptEngineApplyPrintfArgument(Format,
+                                        Arguments[i].Position,
+                                        Arguments[i].Value,
+                                        FinalBuffer,
+                                        SizeOfFinalBuffer,
+                                        &CurrentProcessedPositionFromStartOfFormat,
+                                        &CurrentPositionInFinalBuffer);
+    }
+
+    ScriptEngineFinishPrintfBuffer(Format,
+                                   Record->ArgumentsCount == 0,
+                                   FinalBuffer,
+                                   SizeOfFinalBuffer,
+                                   CurrentProcessedPositionFromStartOfFormat,
+                                   CurrentPositionInFinalBuffer);
+
+    return TRUE;
 }
+
+#endif // SCRIPT_ENGINE_USER_MODE
@@ -69,6 +69,9 @@ ScriptEnginePseudoRegGetPid()
 
 /**
  * @brief Implementation of $pname pseudo-register
+ * @details in the user-mode, the name is resolved once as the current
+ * process is not changed, in the kernel-mode, the name is read from the
+ * process object
  *
  * @return CHAR*
  */
@@ -77,6 +80,14 @@ ScriptEnginePseudoRegGetPname()
 {
 #ifdef SCRIPT_ENGINE_USER_MODE
 
+    static CHAR   CurrentModulePath[MAX_PATH] = {0};
+    static CHAR * CurrentModuleName           = NULL;
+
+    if (CurrentModuleName != NULL)
+    {
+        return CurrentModuleName;
+    }
+
     HANDLE Handle = OpenProcess(
         PROCESS_QUERY_INFORMATION | PROCESS_VM_READ,
         FALSE,
@@ -85,14 +96,14 @@ ScriptEnginePseudoRegGetPname()
 
     if (Handle)
     {
-        CHAR CurrentModulePath[MAX_PATH] = {0};
         if (GetModuleFileNameEx(Handle, 0, CurrentModulePath, MAX_PATH))
         {
             //
             // At this point, buffer contains the full path to the executable
             //
             CloseHandle(Handle);
-            return PathFindFileNameA(CurrentModulePath);
+            CurrentModuleName = PathFindFileNameA(CurrentModulePath);
+            return CurrentModuleName;
         }
         else
         {
@@ -0,0 +1,2561 @@
+/**
+ * @file ScriptEngineBytecode.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Pre-compiling the script buffer into bytecode and executing it
+ * @details The symbol buffer is lowered once (when the action is added
+ * to the event) into a compact stream of instructions with pre-resolved
+ * operands and handlers, so executing the script on each event doesn't
+ * need to decode symbols
+ *
+ * @version 0.4
+ * @date 2023-07-10
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+#include "..\script-eval\header\ScriptEngineInternalHeader.h"
+
+//////////////////////////////////////////////////
+//					Operands					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Get the value of the operands that are not located on slots
+ *
+ * @param Context
+ * @param Operand
+ * @return UINT64
+ */
+static UINT64
+ScriptEngineBytecodeGetValueSlow(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_OPERAND Operand)
+{
+    SYMBOL Symbol = {0};
+
+    if (Operand->Kind == SCRIPT_ENGINE_BYTECODE_OPERAND_REGISTER)
+    {
+        return GetRegValue(Context->GuestRegs, (REGS_ENUM)Operand->Index);
+    }
+
+    Symbol.Type  = SYMBOL_PSEUDO_REG_TYPE;
+    Symbol.Value = Operand->Index;
+
+    return GetPseudoRegValue(&Symbol, Context->ActionDetail);
+}
+
+/**
+ * @brief Get the value of an operand
+ *
+ * @param Context
+ * @param Operand
+ * @return UINT64
+ */
+static inline UINT64
+ScriptEngineBytecodeGetValue(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_OPERAND Operand)
+{
+    if (Operand->Kind < SCRIPT_ENGINE_BYTECODE_SLOTS_COUNT)
+    {
+        return Context->Slots[Operand->Kind][Operand->Index];
+    }
+
+    return ScriptEngineBytecodeGetValueSlow(Context, Operand);
+}
+
+/**
+ * @brief Get the address of an operand
+ * @details registers and pseudo-registers don't have address
+ *
+ * @param Context
+ * @param Operand
+ * @return UINT64
+ */
+static UINT64
+ScriptEngineBytecodeGetReference(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_OPERAND Operand)
+{
+    if (Operand->Kind < SCRIPT_ENGINE_BYTECODE_SLOTS_COUNT &&
+        Operand->Kind != SCRIPT_ENGINE_BYTECODE_OPERAND_GUEST_REGISTER)
+    {
+        return (UINT64)&Context->Slots[Operand->Kind][Operand->Index];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Set the value of an operand
+ *
+ * @param Context
+ * @param Operand
+ * @param Value
+ * @return VOID
+ */
+static inline VOID
+ScriptEngineBytecodeSetValue(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_OPERAND Operand, UINT64 Value)
+{
+    SYMBOL Symbol = {0};
+
+    if (Operand->Kind < SCRIPT_ENGINE_BYTECODE_WRITABLE_SLOTS_COUNT)
+    {
+        Context->Slots[Operand->Kind][Operand->Index] = Value;
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+        if (Operand->Kind == SCRIPT_ENGINE_BYTECODE_OPERAND_GLOBAL)
+        {
+            ScriptEngineGlobalVariableWritten(Operand->Index);
+        }
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+    }
+    else if (Operand->Kind == SCRIPT_ENGINE_BYTECODE_OPERAND_REGISTER)
+    {
+        Symbol.Type  = SYMBOL_REGISTER_TYPE;
+        Symbol.Value = Operand->Index;
+
+        SetRegValue(Context->GuestRegs, &Symbol, Value);
+    }
+}
+
+//////////////////////////////////////////////////
+//					Handlers					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Handler of or
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerOr(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 | SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of xor
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerXor(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 ^ SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of and
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerAnd(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 & SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of arithmetic shift right
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerAsr(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 >> SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of arithmetic shift left
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerAsl(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 << SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of add
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerAdd(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 + SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of sub
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerSub(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 - SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of mul
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerMul(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 * SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of div
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerDiv(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    if (SrcVal0 == 0)
+    {
+        return TRUE;
+    }
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 / SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of mod
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerMod(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    if (SrcVal0 == 0)
+    {
+        return TRUE;
+    }
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 % SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of greater than
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerGt(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 > SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of less than
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerLt(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 < SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of equal or greater than
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerEgt(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 >= SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of equal or less than
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerElt(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 <= SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of equal
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerEqual(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 == SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of not equal
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerNeq(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, SrcVal1 != SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of inc
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerInc(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Src0, SrcVal0 + 1);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of dec
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerDec(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Src0, SrcVal0 - 1);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of mov
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerMov(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, ScriptEngineBytecodeGetValue(Context, &Instruction->Src0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of not
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerNot(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, ~ScriptEngineBytecodeGetValue(Context, &Instruction->Src0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of neg
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerNeg(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, -(INT64)ScriptEngineBytecodeGetValue(Context, &Instruction->Src0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of reference (&)
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerReference(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, ScriptEngineBytecodeGetReference(Context, &Instruction->Src0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of poi
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerPoi(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 DesVal   = ScriptEngineKeywordPoi((PUINT64)ScriptEngineBytecodeGetValue(Context, &Instruction->Src0), &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of db
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerDb(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 DesVal   = ScriptEngineKeywordDb((PUINT64)ScriptEngineBytecodeGetValue(Context, &Instruction->Src0), &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of dd
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerDd(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 DesVal   = ScriptEngineKeywordDd((PUINT64)ScriptEngineBytecodeGetValue(Context, &Instruction->Src0), &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of dw
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerDw(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 DesVal   = ScriptEngineKeywordDw((PUINT64)ScriptEngineBytecodeGetValue(Context, &Instruction->Src0), &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of dq
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerDq(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 DesVal   = ScriptEngineKeywordDq((PUINT64)ScriptEngineBytecodeGetValue(Context, &Instruction->Src0), &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of hi
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerHi(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 DesVal   = ScriptEngineKeywordHi((PUINT64)ScriptEngineBytecodeGetValue(Context, &Instruction->Src0), &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of low
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerLow(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 DesVal   = ScriptEngineKeywordLow((PUINT64)ScriptEngineBytecodeGetValue(Context, &Instruction->Src0), &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of ed
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerEd(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 DesVal   = ScriptEngineFunctionEd(SrcVal1, SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of eb
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerEb(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 DesVal   = ScriptEngineFunctionEb(SrcVal1, SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of eq
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerEq(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 DesVal   = ScriptEngineFunctionEq(SrcVal1, SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of interlocked_exchange
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerInterlockedExchange(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 DesVal   = ScriptEngineFunctionInterlockedExchange((volatile long long *)SrcVal1, SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of interlocked_exchange_add
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerInterlockedExchangeAdd(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 DesVal   = ScriptEngineFunctionInterlockedExchangeAdd((volatile long long *)SrcVal1, SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of interlocked_compare_exchange
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerInterlockedCompareExchange(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 SrcVal2  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src2);
+    UINT64 DesVal   = ScriptEngineFunctionInterlockedCompareExchange((volatile long long *)SrcVal2, SrcVal1, SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of interlocked_increment
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerInterlockedIncrement(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 DesVal   = ScriptEngineFunctionInterlockedIncrement((volatile long long *)SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of interlocked_decrement
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerInterlockedDecrement(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 DesVal   = ScriptEngineFunctionInterlockedDecrement((volatile long long *)SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of percpu_sum
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerPerCoreSum(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 DesVal   = ScriptEngineFunctionPerCoreSum(Context->VariablesList->LocalVariablesList, SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of percpu_min
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerPerCoreMin(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 DesVal   = ScriptEngineFunctionPerCoreMin(Context->VariablesList->LocalVariablesList, SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of percpu_max
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerPerCoreMax(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 DesVal   = ScriptEngineFunctionPerCoreMax(Context->VariablesList->LocalVariablesList, SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of physical_to_virtual
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerPhysicalToVirtual(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 DesVal = ScriptEngineFunctionPhysicalToVirtual(ScriptEngineBytecodeGetValue(Context, &Instruction->Src0));
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of virtual_to_physical
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerVirtualToPhysical(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 DesVal = ScriptEngineFunctionVirtualToPhysical(ScriptEngineBytecodeGetValue(Context, &Instruction->Src0));
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of check_address
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerCheckAddress(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, ScriptEngineFunctionCheckAddress(SrcVal0, sizeof(BYTE)) ? 1 : 0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of scratch
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerScratch(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, ScriptEngineFunctionScratch(SrcVal0, &HasError));
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of strlen
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerStrlen(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, ScriptEngineFunctionStrlen((const char *)SrcVal0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of wcslen
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerWcslen(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, ScriptEngineFunctionWcslen((const wchar_t *)SrcVal0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of disassemble_len and disassemble_len64
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerDisassembleLen64(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, ScriptEngineFunctionDisassembleLen((const char *)SrcVal0, FALSE));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of disassemble_len32
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerDisassembleLen32(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, ScriptEngineFunctionDisassembleLen((const char *)SrcVal0, TRUE));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of memcpy
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerMemcpy(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 SrcVal2  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src2);
+
+    ScriptEngineFunctionMemcpy(SrcVal2, SrcVal1, SrcVal0, &HasError);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of memcmp
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerMemcmp(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 SrcVal2  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src2);
+    UINT64 DesVal   = ScriptEngineFunctionMemcmp(SrcVal2, SrcVal1, (UINT32)SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of memset
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerMemset(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 SrcVal2  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src2);
+    UINT64 DesVal   = ScriptEngineFunctionMemset(SrcVal2, (BYTE)SrcVal1, (UINT32)SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of memsearch
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerMemsearch(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 SrcVal2  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src2);
+    UINT64 DesVal   = ScriptEngineFunctionMemsearch(SrcVal2, (UINT32)SrcVal1, SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of event_add_range
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerEventAddRange(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 SrcVal2 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src2);
+    UINT64 DesVal  = ScriptEngineFunctionEventAddRange(SrcVal2, SrcVal1, SrcVal0);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of event_remove_range
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerEventRemoveRange(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 SrcVal2 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src2);
+    UINT64 DesVal  = ScriptEngineFunctionEventRemoveRange(SrcVal2, SrcVal1, SrcVal0);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of strcmp
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerStrcmp(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 DesVal   = ScriptEngineFunctionStrcmp((const char *)SrcVal1, (const char *)SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of wcscmp
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerWcscmp(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 DesVal   = ScriptEngineFunctionWcscmp((const wchar_t *)SrcVal1, (const wchar_t *)SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of stricmp
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerStricmp(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 DesVal   = ScriptEngineFunctionStricmp((const char *)SrcVal1, (const char *)SrcVal0, &HasError);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, DesVal);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of spinlock_lock
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerSpinlockLock(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL HasError = FALSE;
+
+    ScriptEngineFunctionSpinlockLock((volatile LONG *)ScriptEngineBytecodeGetValue(Context, &Instruction->Src0), &HasError);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of spinlock_unlock
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerSpinlockUnlock(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL HasError = FALSE;
+
+    ScriptEngineFunctionSpinlockUnlock((volatile LONG *)ScriptEngineBytecodeGetValue(Context, &Instruction->Src0), &HasError);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of spinlock_lock_custom_wait
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerSpinlockLockCustomWait(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOL   HasError = FALSE;
+    UINT64 SrcVal0  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1  = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineFunctionSpinlockLockCustomWait((volatile long *)SrcVal1, SrcVal0, &HasError);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of agg_sum
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerAggregationSum(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 SrcVal2 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src2);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, ScriptEngineFunctionAggregationSum(SrcVal2, SrcVal1, SrcVal0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of agg_min
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerAggregationMin(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 SrcVal2 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src2);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, ScriptEngineFunctionAggregationMin(SrcVal2, SrcVal1, SrcVal0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of agg_max
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerAggregationMax(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+    UINT64 SrcVal2 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src2);
+
+    ScriptEngineBytecodeSetValue(Context, &Instruction->Des, ScriptEngineFunctionAggregationMax(SrcVal2, SrcVal1, SrcVal0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of agg_count
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerAggregationCount(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineFunctionAggregationCount(SrcVal1, SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of agg_hist
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerAggregationHistogram(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UINT64 SrcVal0 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src0);
+    UINT64 SrcVal1 = ScriptEngineBytecodeGetValue(Context, &Instruction->Src1);
+
+    ScriptEngineFunctionAggregationHistogram(SrcVal1, SrcVal0);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of agg_print
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerAggregationPrint(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    //
+    // The message is not generated if the output of the event is disabled
+    //
+    if (Context->ActionDetail->IsOutputDisabled)
+    {
+        return FALSE;
+    }
+
+    ScriptEngineFunctionAggregationPrint(Context->ActionDetail->Tag,
+                                         Context->ActionDetail->ImmediatelySendTheResults,
+                                         ScriptEngineBytecodeGetValue(Context, &Instruction->Src0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of agg_clear
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerAggregationClear(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    ScriptEngineFunctionAggregationClear(ScriptEngineBytecodeGetValue(Context, &Instruction->Src0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of stack
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerStack(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    //
+    // The record is not generated if the output of the event is disabled
+    //
+    if (Context->ActionDetail->IsOutputDisabled)
+    {
+        return FALSE;
+    }
+
+    ScriptEngineFunctionStack(Context->GuestRegs,
+                              Context->ActionDetail->Tag,
+                              ScriptEngineBytecodeGetValue(Context, &Instruction->Src0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of print
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerPrint(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    //
+    // The message is not generated if the output of the event is disabled
+    //
+    if (Context->ActionDetail->IsOutputDisabled)
+    {
+        return FALSE;
+    }
+
+    ScriptEngineFunctionPrint(Context->ActionDetail->Tag,
+                              Context->ActionDetail->ImmediatelySendTheResults,
+                              ScriptEngineBytecodeGetValue(Context, &Instruction->Src0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of test_statement
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerTestStatement(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    ScriptEngineFunctionTestStatement(Context->ActionDetail->Tag,
+                                      Context->ActionDetail->ImmediatelySendTheResults,
+                                      ScriptEngineBytecodeGetValue(Context, &Instruction->Src0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of formats
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerFormats(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    ScriptEngineFunctionFormats(Context->ActionDetail->Tag,
+                                Context->ActionDetail->ImmediatelySendTheResults,
+                                ScriptEngineBytecodeGetValue(Context, &Instruction->Src0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of event_enable
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerEventEnable(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    ScriptEngineFunctionEnableEvent(Context->ActionDetail->Tag,
+                                    Context->ActionDetail->ImmediatelySendTheResults,
+                                    ScriptEngineBytecodeGetValue(Context, &Instruction->Src0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of event_disable
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerEventDisable(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    ScriptEngineFunctionDisableEvent(Context->ActionDetail->Tag,
+                                     Context->ActionDetail->ImmediatelySendTheResults,
+                                     ScriptEngineBytecodeGetValue(Context, &Instruction->Src0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of event_sc
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerEventSc(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    ScriptEngineFunctionShortCircuitingEvent(ScriptEngineBytecodeGetValue(Context, &Instruction->Src0));
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of pause
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerPause(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UNREFERENCED_PARAMETER(Instruction);
+
+    ScriptEngineFunctionPause(Context->ActionDetail->Tag,
+                              Context->ActionDetail->ImmediatelySendTheResults,
+                              Context->GuestRegs,
+                              Context->ActionDetail->Context);
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of flush
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerFlush(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    UNREFERENCED_PARAMETER(Context);
+    UNREFERENCED_PARAMETER(Instruction);
+
+    ScriptEngineFunctionFlush();
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of printf
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerPrintf(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    BOOLEAN HasError = FALSE;
+
+    //
+    // The message is not generated if the output of the event is disabled
+    //
+    if (Context->ActionDetail->IsOutputDisabled)
+    {
+        return FALSE;
+    }
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+
+    //
+    // Save a binary trace record instead of formatting the message (if enabled)
+    //
+    if (ScriptEngineFunctionPrintfBinary(Context->GuestRegs,
+                                         Context->ActionDetail,
+                                         Context->VariablesList,
+                                         Context->ActionDetail->Tag,
+                                         Instruction->Format,
+                                         Instruction->FormatId,
+                                         Instruction->Target,
+                                         Instruction->Arguments))
+    {
+        return FALSE;
+    }
+
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+
+    ScriptEngineFunctionPrintf(Context->GuestRegs,
+                               Context->ActionDetail,
+                               Context->VariablesList,
+                               Context->ActionDetail->Tag,
+                               Context->ActionDetail->ImmediatelySendTheResults,
+                               Instruction->Format,
+                               Instruction->Target,
+                               Instruction->Arguments,
+                               &HasError);
+
+    return HasError;
+}
+
+/**
+ * @brief Handler of jmp
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerJmp(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    Context->Ip = Instruction->Target;
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of jz
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerJz(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    if (ScriptEngineBytecodeGetValue(Context, &Instruction->Src1) == 0)
+    {
+        Context->Ip = Instruction->Target;
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Handler of jnz
+ *
+ * @param Context
+ * @param Instruction
+ * @return BOOL
+ */
+static BOOL
+ScriptEngineBytecodeHandlerJnz(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context, PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    if (ScriptEngineBytecodeGetValue(Context, &Instruction->Src1) != 0)
+    {
+        Context->Ip = Instruction->Target;
+    }
+
+    return FALSE;
+}
+
+//////////////////////////////////////////////////
+//					Lowering					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Get the index of a 64-bit general purpose register in GUEST_REGS
+ * @details rsp is not included as modifying it needs to modify the VMCS
+ *
+ * @param RegId
+ * @param Index
+ * @return BOOLEAN
+ */
+static BOOLEAN
+ScriptEngineBytecodeGetGuestRegisterIndex(UINT64 RegId, UINT32 * Index)
+{
+    switch (RegId)
+    {
+    case REGISTER_RAX:
+        *Index = FIELD_OFFSET(GUEST_REGS, rax) / sizeof(UINT64);
+        return TRUE;
+    case REGISTER_RCX:
+        *Index = FIELD_OFFSET(GUEST_REGS, rcx) / sizeof(UINT64);
+        return TRUE;
+    case REGISTER_RDX:
+        *Index = FIELD_OFFSET(GUEST_REGS, rdx) / sizeof(UINT64);
+        return TRUE;
+    case REGISTER_RBX:
+        *Index = FIELD_OFFSET(GUEST_REGS, rbx) / sizeof(UINT64);
+        return TRUE;
+    case REGISTER_RBP:
+        *Index = FIELD_OFFSET(GUEST_REGS, rbp) / sizeof(UINT64);
+        return TRUE;
+    case REGISTER_RSI:
+        *Index = FIELD_OFFSET(GUEST_REGS, rsi) / sizeof(UINT64);
+        return TRUE;
+    case REGISTER_RDI:
+        *Index = FIELD_OFFSET(GUEST_REGS, rdi) / sizeof(UINT64);
+        return TRUE;
+    case REGISTER_R8:
+        *Index = FIELD_OFFSET(GUEST_REGS, r8) / sizeof(UINT64);
+        return TRUE;
+    case REGISTER_R9:
+        *Index = FIELD_OFFSET(GUEST_REGS, r9) / sizeof(UINT64);
+        return TRUE;
+    case REGISTER_R10:
+        *Index = FIELD_OFFSET(GUEST_REGS, r10) / sizeof(UINT64);
+        return TRUE;
+    case REGISTER_R11:
+        *Index = FIELD_OFFSET(GUEST_REGS, r11) / sizeof(UINT64);
+        return TRUE;
+    case REGISTER_R12:
+        *Index = FIELD_OFFSET(GUEST_REGS, r12) / sizeof(UINT64);
+        return TRUE;
+    case REGISTER_R13:
+        *Index = FIELD_OFFSET(GUEST_REGS, r13) / sizeof(UINT64);
+        return TRUE;
+    case REGISTER_R14:
+        *Index = FIELD_OFFSET(GUEST_REGS, r14) / sizeof(UINT64);
+        return TRUE;
+    case REGISTER_R15:
+        *Index = FIELD_OFFSET(GUEST_REGS, r15) / sizeof(UINT64);
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Lower the next symbol of the buffer into an operand
+ *
+ * @param CodeBuffer The script buffer
+ * @param Bytecode The bytecode that is being compiled
+ * @param Indx Script buffer index
+ * @param Operand The lowered operand
+ * @return BOOLEAN FALSE if the symbol can't be lowered
+ */
+static BOOLEAN
+ScriptEngineBytecodeLowerOperand(SYMBOL_BUFFER *                 CodeBuffer,
+                                 PSCRIPT_ENGINE_BYTECODE         Bytecode,
+                                 UINT32 *                        Indx,
+                                 PSCRIPT_ENGINE_BYTECODE_OPERAND Operand)
+{
+    PSYMBOL Symbol;
+
+    if (*Indx >= CodeBuffer->Pointer)
+    {
+        return FALSE;
+    }
+
+    Symbol = &CodeBuffer->Head[*Indx];
+    *Indx  = *Indx + 1;
+
+    if (Symbol->Type == SYMBOL_NUM_TYPE)
+    {
+        //
+        // Numbers are moved to the constants slot
+        //
+        Operand->Kind                                   = SCRIPT_ENGINE_BYTECODE_OPERAND_CONSTANT;
+        Operand->Index                                  = Bytecode->ConstantsCount;
+        Bytecode->Constants[Bytecode->ConstantsCount++] = Symbol->Value;
+
+        return TRUE;
+    }
+
+    if (Symbol->Value > MAXUINT32)
+    {
+        return FALSE;
+    }
+
+    Operand->Index = (UINT32)Symbol->Value;
+
+    switch (Symbol->Type)
+    {
+    case SYMBOL_GLOBAL_ID_TYPE:
+        Operand->Kind = SCRIPT_ENGINE_BYTECODE_OPERAND_GLOBAL;
+        return TRUE;
+
+    case SYMBOL_LOCAL_ID_TYPE:
+        Operand->Kind = SCRIPT_ENGINE_BYTECODE_OPERAND_LOCAL;
+        return TRUE;
+
+    case SYMBOL_TEMP_TYPE:
+        Operand->Kind = SCRIPT_ENGINE_BYTECODE_OPERAND_TEMP;
+        return TRUE;
+
+    case SYMBOL_REGISTER_TYPE:
+
+        //
+        // 64-bit general purpose registers are directly accessed from GUEST_REGS
+        //
+        if (ScriptEngineBytecodeGetGuestRegisterIndex(Symbol->Value, &Operand->Index))
+        {
+            Operand->Kind = SCRIPT_ENGINE_BYTECODE_OPERAND_GUEST_REGISTER;
+        }
+        else
+        {
+            Operand->Kind = SCRIPT_ENGINE_BYTECODE_OPERAND_REGISTER;
+        }
+
+        return TRUE;
+
+    case SYMBOL_PSEUDO_REG_TYPE:
+        Operand->Kind = SCRIPT_ENGINE_BYTECODE_OPERAND_PSEUDO_REGISTER;
+        return TRUE;
+
+    default:
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Lower the target of a jump
+ * @details the target is kept as the index of the symbol until all
+ * the instructions are lowered
+ *
+ * @param CodeBuffer The script buffer
+ * @param Indx Script buffer index
+ * @param Instruction The lowered instruction
+ * @return BOOLEAN FALSE if the target can't be lowered
+ */
+static BOOLEAN
+ScriptEngineBytecodeLowerJumpTarget(SYMBOL_BUFFER *                     CodeBuffer,
+                                    UINT32 *                            Indx,
+                                    PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    PSYMBOL Symbol;
+
+    if (*Indx >= CodeBuffer->Pointer)
+    {
+        return FALSE;
+    }
+
+    Symbol = &CodeBuffer->Head[*Indx];
+    *Indx  = *Indx + 1;
+
+    if (Symbol->Type != SYMBOL_NUM_TYPE)
+    {
+        return FALSE;
+    }
+
+    Instruction->Target = Symbol->Value >= CodeBuffer->Pointer ? CodeBuffer->Pointer : (UINT32)Symbol->Value;
+
+    return TRUE;
+}
+
+/**
+ * @brief Lower the next operator of the buffer into an instruction
+ *
+ * @param CodeBuffer The script buffer
+ * @param Bytecode The bytecode that is being compiled
+ * @param Indx Script buffer index
+ * @param Instruction The lowered instruction
+ * @return BOOLEAN FALSE if the operator can't be lowered
+ */
+static BOOLEAN
+ScriptEngineBytecodeLowerInstruction(SYMBOL_BUFFER *                     CodeBuffer,
+                                     PSCRIPT_ENGINE_BYTECODE             Bytecode,
+                                     UINT32 *                            Indx,
+                                     PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction)
+{
+    PSYMBOL Operator;
+    PSYMBOL Symbol;
+    UINT32  SourcesCount   = 0;
+    BOOLEAN HasDestination = FALSE;
+
+    Operator = &CodeBuffer->Head[*Indx];
+    *Indx    = *Indx + 1;
+
+    if (Operator->Type != SYMBOL_SEMANTIC_RULE_TYPE)
+    {
+        return FALSE;
+    }
+
+    Instruction->Operator = (UINT32)Operator->Value;
+
+    switch (Operator->Value)
+    {
+    case FUNC_OR:
+        Instruction->Handler = ScriptEngineBytecodeHandlerOr;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_XOR:
+        Instruction->Handler = ScriptEngineBytecodeHandlerXor;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_AND:
+        Instruction->Handler = ScriptEngineBytecodeHandlerAnd;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_ASR:
+        Instruction->Handler = ScriptEngineBytecodeHandlerAsr;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_ASL:
+        Instruction->Handler = ScriptEngineBytecodeHandlerAsl;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_ADD:
+        Instruction->Handler = ScriptEngineBytecodeHandlerAdd;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_SUB:
+        Instruction->Handler = ScriptEngineBytecodeHandlerSub;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_MUL:
+        Instruction->Handler = ScriptEngineBytecodeHandlerMul;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_DIV:
+        Instruction->Handler = ScriptEngineBytecodeHandlerDiv;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_MOD:
+        Instruction->Handler = ScriptEngineBytecodeHandlerMod;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_GT:
+        Instruction->Handler = ScriptEngineBytecodeHandlerGt;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_LT:
+        Instruction->Handler = ScriptEngineBytecodeHandlerLt;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_EGT:
+        Instruction->Handler = ScriptEngineBytecodeHandlerEgt;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_ELT:
+        Instruction->Handler = ScriptEngineBytecodeHandlerElt;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_EQUAL:
+        Instruction->Handler = ScriptEngineBytecodeHandlerEqual;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_NEQ:
+        Instruction->Handler = ScriptEngineBytecodeHandlerNeq;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_ED:
+        Instruction->Handler = ScriptEngineBytecodeHandlerEd;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_EB:
+        Instruction->Handler = ScriptEngineBytecodeHandlerEb;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_EQ:
+        Instruction->Handler = ScriptEngineBytecodeHandlerEq;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_INTERLOCKED_EXCHANGE:
+        Instruction->Handler = ScriptEngineBytecodeHandlerInterlockedExchange;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_INTERLOCKED_EXCHANGE_ADD:
+        Instruction->Handler = ScriptEngineBytecodeHandlerInterlockedExchangeAdd;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_INTERLOCKED_COMPARE_EXCHANGE:
+        Instruction->Handler = ScriptEngineBytecodeHandlerInterlockedCompareExchange;
+        SourcesCount         = 3;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_STRCMP:
+        Instruction->Handler = ScriptEngineBytecodeHandlerStrcmp;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_WCSCMP:
+        Instruction->Handler = ScriptEngineBytecodeHandlerWcscmp;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_STRICMP:
+        Instruction->Handler = ScriptEngineBytecodeHandlerStricmp;
+        SourcesCount         = 2;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_MEMCPY:
+        Instruction->Handler = ScriptEngineBytecodeHandlerMemcpy;
+        SourcesCount         = 3;
+        HasDestination       = TRUE; // Not set, but the symbol is there
+        break;
+
+    case FUNC_MEMCMP:
+        Instruction->Handler = ScriptEngineBytecodeHandlerMemcmp;
+        SourcesCount         = 3;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_MEMSET:
+        Instruction->Handler = ScriptEngineBytecodeHandlerMemset;
+        SourcesCount         = 3;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_MEMSEARCH:
+        Instruction->Handler = ScriptEngineBytecodeHandlerMemsearch;
+        SourcesCount         = 3;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_EVENT_ADD_RANGE:
+        Instruction->Handler = ScriptEngineBytecodeHandlerEventAddRange;
+        SourcesCount         = 3;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_EVENT_REMOVE_RANGE:
+        Instruction->Handler = ScriptEngineBytecodeHandlerEventRemoveRange;
+        SourcesCount         = 3;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_SPINLOCK_LOCK_CUSTOM_WAIT:
+        Instruction->Handler = ScriptEngineBytecodeHandlerSpinlockLockCustomWait;
+        SourcesCount         = 2;
+        break;
+
+    case FUNC_AGG_SUM:
+        Instruction->Handler = ScriptEngineBytecodeHandlerAggregationSum;
+        SourcesCount         = 3;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_AGG_MIN:
+        Instruction->Handler = ScriptEngineBytecodeHandlerAggregationMin;
+        SourcesCount         = 3;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_AGG_MAX:
+        Instruction->Handler = ScriptEngineBytecodeHandlerAggregationMax;
+        SourcesCount         = 3;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_AGG_COUNT:
+        Instruction->Handler = ScriptEngineBytecodeHandlerAggregationCount;
+        SourcesCount         = 2;
+        break;
+
+    case FUNC_AGG_HIST:
+        Instruction->Handler = ScriptEngineBytecodeHandlerAggregationHistogram;
+        SourcesCount         = 2;
+        break;
+
+    case FUNC_INC:
+        Instruction->Handler = ScriptEngineBytecodeHandlerInc;
+        SourcesCount         = 1;
+        break;
+
+    case FUNC_DEC:
+        Instruction->Handler = ScriptEngineBytecodeHandlerDec;
+        SourcesCount         = 1;
+        break;
+
+    case FUNC_MOV:
+        Instruction->Handler = ScriptEngineBytecodeHandlerMov;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_NOT:
+        Instruction->Handler = ScriptEngineBytecodeHandlerNot;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_NEG:
+        Instruction->Handler = ScriptEngineBytecodeHandlerNeg;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_REFERENCE:
+        Instruction->Handler = ScriptEngineBytecodeHandlerReference;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_POI:
+        Instruction->Handler = ScriptEngineBytecodeHandlerPoi;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_DB:
+        Instruction->Handler = ScriptEngineBytecodeHandlerDb;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_DD:
+        Instruction->Handler = ScriptEngineBytecodeHandlerDd;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_DW:
+        Instruction->Handler = ScriptEngineBytecodeHandlerDw;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_DQ:
+        Instruction->Handler = ScriptEngineBytecodeHandlerDq;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_HI:
+        Instruction->Handler = ScriptEngineBytecodeHandlerHi;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_LOW:
+        Instruction->Handler = ScriptEngineBytecodeHandlerLow;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_INTERLOCKED_INCREMENT:
+        Instruction->Handler = ScriptEngineBytecodeHandlerInterlockedIncrement;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_INTERLOCKED_DECREMENT:
+        Instruction->Handler = ScriptEngineBytecodeHandlerInterlockedDecrement;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_PERCPU_SUM:
+        Instruction->Handler = ScriptEngineBytecodeHandlerPerCoreSum;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_PERCPU_MIN:
+        Instruction->Handler = ScriptEngineBytecodeHandlerPerCoreMin;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_PERCPU_MAX:
+        Instruction->Handler = ScriptEngineBytecodeHandlerPerCoreMax;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_PHYSICAL_TO_VIRTUAL:
+        Instruction->Handler = ScriptEngineBytecodeHandlerPhysicalToVirtual;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_VIRTUAL_TO_PHYSICAL:
+        Instruction->Handler = ScriptEngineBytecodeHandlerVirtualToPhysical;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_CHECK_ADDRESS:
+        Instruction->Handler = ScriptEngineBytecodeHandlerCheckAddress;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_SCRATCH:
+        Instruction->Handler = ScriptEngineBytecodeHandlerScratch;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_STRLEN:
+        Instruction->Handler = ScriptEngineBytecodeHandlerStrlen;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_WCSLEN:
+        Instruction->Handler = ScriptEngineBytecodeHandlerWcslen;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_DISASSEMBLE_LEN:
+    case FUNC_DISASSEMBLE_LEN64:
+        Instruction->Handler = ScriptEngineBytecodeHandlerDisassembleLen64;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_DISASSEMBLE_LEN32:
+        Instruction->Handler = ScriptEngineBytecodeHandlerDisassembleLen32;
+        SourcesCount         = 1;
+        HasDestination       = TRUE;
+        break;
+
+    case FUNC_PRINT:
+        Instruction->Handler = ScriptEngineBytecodeHandlerPrint;
+        SourcesCount         = 1;
+        break;
+
+    case FUNC_TEST_STATEMENT:
+        Instruction->Handler = ScriptEngineBytecodeHandlerTestStatement;
+        SourcesCount         = 1;
+        break;
+
+    case FUNC_SPINLOCK_LOCK:
+        Instruction->Handler = ScriptEngineBytecodeHandlerSpinlockLock;
+        SourcesCount         = 1;
+        break;
+
+    case FUNC_SPINLOCK_UNLOCK:
+        Instruction->Handler = ScriptEngineBytecodeHandlerSpinlockUnlock;
+        SourcesCount         = 1;
+        break;
+
+    case FUNC_EVENT_ENABLE:
+        Instruction->Handler = ScriptEngineBytecodeHandlerEventEnable;
+        SourcesCount         = 1;
+        break;
+
+    case FUNC_EVENT_DISABLE:
+        Instruction->Handler = ScriptEngineBytecodeHandlerEventDisable;
+        SourcesCount         = 1;
+        break;
+
+    case FUNC_FORMATS:
+        Instruction->Handler = ScriptEngineBytecodeHandlerFormats;
+        SourcesCount         = 1;
+        break;
+
+    case FUNC_AGG_PRINT:
+        Instruction->Handler = ScriptEngineBytecodeHandlerAggregationPrint;
+        SourcesCount         = 1;
+        break;
+
+    case FUNC_AGG_CLEAR:
+        Instruction->Handler = ScriptEngineBytecodeHandlerAggregationClear;
+        SourcesCount         = 1;
+        break;
+
+    case FUNC_STACK:
+        Instruction->Handler = ScriptEngineBytecodeHandlerStack;
+        SourcesCount         = 1;
+        break;
+
+    case FUNC_EVENT_SC:
+
+        Instruction->Handler = ScriptEngineBytecodeHandlerEventSc;
+
+        //
+        // The second symbol is not used
+        //
+        if (!ScriptEngineBytecodeLowerOperand(CodeBuffer, Bytecode, Indx, &Instruction->Src0) ||
+            *Indx >= CodeBuffer->Pointer)
+        {
+            return FALSE;
+        }
+
+        *Indx = *Indx + 1;
+        return TRUE;
+
+    case FUNC_PAUSE:
+        Instruction->Handler = ScriptEngineBytecodeHandlerPause;
+        break;
+
+    case FUNC_FLUSH:
+        Instruction->Handler = ScriptEngineBytecodeHandlerFlush;
+        break;
+
+    case FUNC_JMP:
+        Instruction->Handler = ScriptEngineBytecodeHandlerJmp;
+        return ScriptEngineBytecodeLowerJumpTarget(CodeBuffer, Indx, Instruction);
+
+    case FUNC_JZ:
+        Instruction->Handler = ScriptEngineBytecodeHandlerJz;
+        return ScriptEngineBytecodeLowerJumpTarget(CodeBuffer, Indx, Instruction) &&
+               ScriptEngineBytecodeLowerOperand(CodeBuffer, Bytecode, Indx, &Instruction->Src1);
+
+    case FUNC_JNZ:
+        Instruction->Handler = ScriptEngineBytecodeHandlerJnz;
+        return ScriptEngineBytecodeLowerJumpTarget(CodeBuffer, Indx, Instruction) &&
+               ScriptEngineBytecodeLowerOperand(CodeBuffer, Bytecode, Indx, &Instruction->Src1);
+
+    case FUNC_PRINTF:
+
+        Instruction->Handler = ScriptEngineBytecodeHandlerPrintf;
+
+        //
+        // The format string is stored in the symbols after the first symbol
+        //
+        if (*Indx >= CodeBuffer->Pointer)
+        {
+            return FALSE;
+        }
+
+        Instruction->Format   = (CHAR *)&CodeBuffer->Head[*Indx].Value;
+        Instruction->FormatId = BinaryTraceGetFormatId(Instruction->Format);
+        *Indx               = *Indx + 1;
+        *Indx               = *Indx + (UINT32)((sizeof(unsigned long long) + strlen(Instruction->Format)) / sizeof(SYMBOL));
+
+        if (*Indx >= CodeBuffer->Pointer)
+        {
+            return FALSE;
+        }
+
+        //
+        // The count of arguments and then the arguments
+        //
+        Symbol = &CodeBuffer->Head[*Indx];
+        *Indx  = *Indx + 1;
+
+        if (Symbol->Value > CodeBuffer->Pointer - *Indx)
+        {
+            return FALSE;
+        }
+
+        Instruction->Target    = (UINT32)Symbol->Value;
+        Instruction->Arguments = Symbol->Value > 0 ? &CodeBuffer->Head[*Indx] : NULL;
+        *Indx                  = *Indx + (UINT32)Symbol->Value;
+
+        return TRUE;
+
+    default:
+
+        //
+        // Not supported, the script is evaluated from the symbols
+        //
+        return FALSE;
+    }
+
+    if (SourcesCount > 0 && !ScriptEngineBytecodeLowerOperand(CodeBuffer, Bytecode, Indx, &Instruction->Src0))
+    {
+        return FALSE;
+    }
+
+    if (SourcesCount > 1 && !ScriptEngineBytecodeLowerOperand(CodeBuffer, Bytecode, Indx, &Instruction->Src1))
+    {
+        return FALSE;
+    }
+
+    if (SourcesCount > 2 && !ScriptEngineBytecodeLowerOperand(CodeBuffer, Bytecode, Indx, &Instruction->Src2))
+    {
+        return FALSE;
+    }
+
+    if (HasDestination && !ScriptEngineBytecodeLowerOperand(CodeBuffer, Bytecode, Indx, &Instruction->Des))
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the size of the buffer that is needed for compiling a script
+ *
+ * @param CodeBuffer The script buffer
+ * @return UINT32
+ */
+UINT32
+ScriptEngineBytecodeGetRequiredSize(SYMBOL_BUFFER * CodeBuffer)
+{
+    //
+    // Each symbol makes at most one instruction and one constant, the
+    // mapping of symbols to instructions is also kept after the constants
+    //
+    return sizeof(SCRIPT_ENGINE_BYTECODE) +
+           CodeBuffer->Pointer * (sizeof(SCRIPT_ENGINE_BYTECODE_INSTRUCTION) + sizeof(UINT64)) +
+           (CodeBuffer->Pointer + 1) * sizeof(UINT32);
+}
+
+/**
+ * @brief Compile the script buffer into bytecode
+ * @details this function doesn't allocate memory, the buffer should be at
+ * least ScriptEngineBytecodeGetRequiredSize bytes
+ *
+ * @param CodeBuffer The script buffer
+ * @param Bytecode The buffer to hold the bytecode
+ * @param BufferSize Size of the buffer
+ * @return BOOLEAN FALSE if the script can't be compiled, in this case the
+ * script should be executed by ScriptEngineExecute
+ */
+BOOLEAN
+ScriptEngineBytecodeCompile(SYMBOL_BUFFER *         CodeBuffer,
+                            PSCRIPT_ENGINE_BYTECODE Bytecode,
+                            UINT32                  BufferSize)
+{
+    UINT32 *                            SymbolToInstruction;
+    PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction;
+    UINT32                              Indx = 0;
+
+    if (BufferSize < ScriptEngineBytecodeGetRequiredSize(CodeBuffer))
+    {
+        return FALSE;
+    }
+
+    memset(Bytecode, 0, BufferSize);
+
+    Bytecode->Instructions = (PSCRIPT_ENGINE_BYTECODE_INSTRUCTION)((CHAR *)Bytecode + sizeof(SCRIPT_ENGINE_BYTECODE));
+    Bytecode->Constants    = (UINT64 *)&Bytecode->Instructions[CodeBuffer->Pointer];
+    SymbolToInstruction    = (UINT32 *)&Bytecode->Constants[CodeBuffer->Pointer];
+
+    for (UINT32 i = 0; i <= CodeBuffer->Pointer; i++)
+    {
+        SymbolToInstruction[i] = MAXUINT32;
+    }
+
+    //
+    // Lower the operators one by one
+    //
+    while (Indx < CodeBuffer->Pointer)
+    {
+        SymbolToInstruction[Indx] = Bytecode->InstructionsCount;
+        Instruction               = &Bytecode->Instructions[Bytecode->InstructionsCount++];
+
+        if (!ScriptEngineBytecodeLowerInstruction(CodeBuffer, Bytecode, &Indx, Instruction))
+        {
+            return FALSE;
+        }
+    }
+
+    SymbolToInstruction[CodeBuffer->Pointer] = Bytecode->InstructionsCount;
+
+    //
+    // Convert the targets of jumps from symbol indexes to instruction indexes
+    //
+    for (UINT32 i = 0; i < Bytecode->InstructionsCount; i++)
+    {
+        Instruction = &Bytecode->Instructions[i];
+
+        if (Instruction->Operator != FUNC_JMP &&
+            Instruction->Operator != FUNC_JZ &&
+            Instruction->Operator != FUNC_JNZ)
+        {
+            continue;
+        }
+
+        if (SymbolToInstruction[Instruction->Target] == MAXUINT32)
+        {
+            //
+            // Jumping to the middle of an instruction
+            //
+            return FALSE;
+        }
+
+        Instruction->Target = SymbolToInstruction[Instruction->Target];
+    }
+
+    return TRUE;
+}
+
+//////////////////////////////////////////////////
+//					Execution					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Execute the compiled script
+ * @details the count of the executed instructions is saved in the action
+ * buffer, the script is aborted (as an error) once the count exceeds the
+ * instruction budget of the action buffer (if it's not zero)
+ *
+ * @param GuestRegs General purpose registers
+ * @param ActionDetail Detail of the specific action
+ * @param VariablesList List of core specific (and global) variable holders
+ * @param Bytecode The compiled script
+ * @param ErrorOperator Error in operator
+ * @return BOOL TRUE if there was an error
+ */
+BOOL
+ScriptEngineBytecodeExecute(PGUEST_REGS                    GuestRegs,
+                            ACTION_BUFFER *                ActionDetail,
+                            SCRIPT_ENGINE_VARIABLES_LIST * VariablesList,
+                            PSCRIPT_ENGINE_BYTECODE        Bytecode,
+                            SYMBOL *                       ErrorOperator)
+{
+    SCRIPT_ENGINE_BYTECODE_CONTEXT      Context;
+    PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction;
+
+    Context.Slots[SCRIPT_ENGINE_BYTECODE_OPERAND_GLOBAL]         = VariablesList->GlobalVariablesList;
+    Context.Slots[SCRIPT_ENGINE_BYTECODE_OPERAND_LOCAL]          = VariablesList->LocalVariablesList;
+    Context.Slots[SCRIPT_ENGINE_BYTECODE_OPERAND_TEMP]           = VariablesList->TempList;
+    Context.Slots[SCRIPT_ENGINE_BYTECODE_OPERAND_GUEST_REGISTER] = (UINT64 *)GuestRegs;
+    Context.Slots[SCRIPT_ENGINE_BYTECODE_OPERAND_CONSTANT]       = Bytecode->Constants;
+    Context.GuestRegs                                            = GuestRegs;
+    Context.ActionDetail                                         = ActionDetail;
+    Context.VariablesList                                        = VariablesList;
+    Context.Ip                                                   = 0;
+    Context.InstructionsCount                                    = 0;
+    Context.InstructionsBudget                                   = ActionDetail->InstructionsBudget != 0 ? ActionDetail->InstructionsBudget : MAXULONG64;
+
+    //
+    // If the bytecode is also compiled to native code, run it instead
+    //
+    if (Bytecode->NativeCode != NULL)
+    {
+        if (Bytecode->NativeCode(&Context))
+        {
+            ActionDetail->InstructionsCount = Context.InstructionsCount;
+
+            ErrorOperator->Type  = SYMBOL_SEMANTIC_RULE_TYPE;
+            ErrorOperator->Value = Bytecode->Instructions[Context.Ip - 1].Operator;
+
+            return TRUE;
+        }
+
+        ActionDetail->InstructionsCount = Context.InstructionsCount;
+
+        return FALSE;
+    }
+
+    while (Context.Ip < Bytecode->InstructionsCount)
+    {
+        Instruction = &Bytecode->Instructions[Context.Ip];
+        Context.Ip++;
+
+        if (++Context.InstructionsCount > Context.InstructionsBudget ||
+            Instruction->Handler(&Context, Instruction))
+        {
+            ActionDetail->InstructionsCount = Context.InstructionsCount;
+
+            ErrorOperator->Type  = SYMBOL_SEMANTIC_RULE_TYPE;
+            ErrorOperator->Value = Instruction->Operator;
+
+            return TRUE;
+        }
+    }
+
+    ActionDetail->InstructionsCount = Context.InstructionsCount;
+
+    return FALSE;
+}
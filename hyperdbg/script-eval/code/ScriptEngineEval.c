@@ -13,6 +13,61 @@
 #include "pch.h"
 #include "..\script-eval\header\ScriptEngineInternalHeader.h"
 
+/**
+ * @brief Get the Pseudo reg value of the current process or thread
+ * @details the current process (and its memory layout), thread and core
+ * are not changed in a single invocation of the script, so these
+ * pseudo-registers are only computed once in each invocation
+ *
+ * @param Index The index of the pseudo-register (less than
+ * ACTION_BUFFER_PSEUDO_REGISTERS_CACHE_SIZE)
+ * @param ActionBuffer
+ * @return UINT64
+ */
+static UINT64
+GetCachedPseudoRegValue(UINT32 Index, PACTION_BUFFER ActionBuffer)
+{
+    UINT64 Value = NULL;
+
+    if (ActionBuffer->PseudoRegistersCacheValid & (1 << Index))
+    {
+        return ActionBuffer->PseudoRegistersCache[Index];
+    }
+
+    switch (Index)
+    {
+    case PSEUDO_REGISTER_TID:
+        Value = ScriptEnginePseudoRegGetTid();
+        break;
+    case PSEUDO_REGISTER_PID:
+        Value = ScriptEnginePseudoRegGetPid();
+        break;
+    case PSEUDO_REGISTER_PNAME:
+        Value = (UINT64)ScriptEnginePseudoRegGetPname();
+        break;
+    case PSEUDO_REGISTER_CORE:
+        Value = ScriptEnginePseudoRegGetCore();
+        break;
+    case PSEUDO_REGISTER_PROC:
+        Value = ScriptEnginePseudoRegGetProc();
+        break;
+    case PSEUDO_REGISTER_THREAD:
+        Value = ScriptEnginePseudoRegGetThread();
+        break;
+    case PSEUDO_REGISTER_PEB:
+        Value = ScriptEnginePseudoRegGetPeb();
+        break;
+    case PSEUDO_REGISTER_TEB:
+        Value = ScriptEnginePseudoRegGetTeb();
+        break;
+    }
+
+    ActionBuffer->PseudoRegistersCache[Index] = Value;
+    ActionBuffer->PseudoRegistersCacheValid |= (1 << Index);
+
+    return Value;
+}
+
 /**
  * @brief Get the Pseudo reg value
  *
@@ -26,21 +81,14 @@ GetPseudoRegValue(PSYMBOL Symbol, PACTION_BUFFER ActionBuffer)
     switch (Symbol->Value)
     {
     case PSEUDO_REGISTER_TID:
-        return ScriptEnginePseudoRegGetTid();
     case PSEUDO_REGISTER_PID:
-        return ScriptEnginePseudoRegGetPid();
     case PSEUDO_REGISTER_PNAME:
-        return (UINT64)ScriptEnginePseudoRegGetPname();
     case PSEUDO_REGISTER_CORE:
-        return ScriptEnginePseudoRegGetCore();
     case PSEUDO_REGISTER_PROC:
-        return ScriptEnginePseudoRegGetProc();
     case PSEUDO_REGISTER_THREAD:
-        return ScriptEnginePseudoRegGetThread();
     case PSEUDO_REGISTER_PEB:
-        return ScriptEnginePseudoRegGetPeb();
     case PSEUDO_REGISTER_TEB:
-        return ScriptEnginePseudoRegGetTeb();
+        return GetCachedPseudoRegValue((UINT32)Symbol->Value, ActionBuffer);
     case PSEUDO_REGISTER_IP:
         return ScriptEnginePseudoRegGetIp();
     case PSEUDO_REGISTER_BUFFER:
@@ -147,6 +195,9 @@ SetValue(PGUEST_REGS GuestRegs, SCRIPT_ENGINE_VARIABLES_LIST * VariablesList, PS
     {
     case SYMBOL_GLOBAL_ID_TYPE:
         VariablesList->GlobalVariablesList[Symbol->Value] = Value;
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+        ScriptEngineGlobalVariableWritten(Symbol->Value);
+#endif // SCRIPT_ENGINE_KERNEL_MODE
         return;
     case SYMBOL_LOCAL_ID_TYPE:
         VariablesList->LocalVariablesList[Symbol->Value] = Value;
@@ -263,21 +314,395 @@ ScriptEngineExecute(PGUEST_REGS                    GuestRegs,
 
         *Indx = *Indx + 1;
 
-        SrcVal1 =
-            GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
+        SrcVal1 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
+
+        Des = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionEd(SrcVal1, SrcVal0, &HasError);
+
+        SetValue(GuestRegs, VariablesList, Des, DesVal);
+
+        return HasError;
+
+    case FUNC_EB:
+
+        Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Src1 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal1 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
+
+        Des = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionEb(SrcVal1, SrcVal0, &HasError);
+
+        SetValue(GuestRegs, VariablesList, Des, DesVal);
+
+        return HasError;
+
+    case FUNC_EQ:
+
+        Src0  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Src1 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal1 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
+
+        Des = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionEq(SrcVal1, SrcVal0, &HasError);
+
+        SetValue(GuestRegs, VariablesList, Des, DesVal);
+
+        return HasError;
+
+    case FUNC_INTERLOCKED_EXCHANGE:
+
+        Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Src1 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal1 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
+
+        Des   = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionInterlockedExchange((volatile long long *)SrcVal1, SrcVal0, &HasError);
+
+        SetValue(GuestRegs, VariablesList, Des, DesVal);
+
+        return HasError;
+
+    case FUNC_INTERLOCKED_EXCHANGE_ADD:
+
+        Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Src1 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal1 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
+
+        Des = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionInterlockedExchangeAdd((volatile long long *)SrcVal1, SrcVal0, &HasError);
+
+        SetValue(GuestRegs, VariablesList, Des, DesVal);
+
+        return HasError;
+
+    case FUNC_STRCMP:
+
+        Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Src1 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal1 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
+
+        Des = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionStrcmp((const char *)SrcVal1, (const char *)SrcVal0, &HasError);
+
+        SetValue(GuestRegs, VariablesList, Des, DesVal);
+
+        return HasError;
+
+    case FUNC_WCSCMP:
+
+        Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Src1 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal1 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
+
+        Des = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionWcscmp((const wchar_t *)SrcVal1, (const wchar_t *)SrcVal0, &HasError);
+
+        SetValue(GuestRegs, VariablesList, Des, DesVal);
+
+        return HasError;
+
+    case FUNC_STRICMP:
+
+        Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Src1 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal1 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
+
+        Des = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionStricmp((const char *)SrcVal1, (const char *)SrcVal0, &HasError);
+
+        SetValue(GuestRegs, VariablesList, Des, DesVal);
+
+        return HasError;
+
+    case FUNC_INTERLOCKED_COMPARE_EXCHANGE:
+
+        Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Src1  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        SrcVal1 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
+
+        Src2 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal2 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src2, FALSE);
+
+        Des   = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionInterlockedCompareExchange((volatile long long *)SrcVal2, SrcVal1, SrcVal0, &HasError);
+
+        SetValue(GuestRegs, VariablesList, Des, DesVal);
+
+        return HasError;
+
+    case FUNC_MEMCPY:
+
+        Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Src1  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        SrcVal1 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
+
+        Src2 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal2 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src2, FALSE);
+
+        Des   = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        ScriptEngineFunctionMemcpy(SrcVal2, SrcVal1, SrcVal0, &HasError);
+
+        return HasError;
+
+    case FUNC_MEMCMP:
+
+        Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Src1  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        SrcVal1 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
+
+        Src2 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal2 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src2, FALSE);
+
+        Des   = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionMemcmp(SrcVal2, SrcVal1, (UINT32)SrcVal0, &HasError);
+
+        SetValue(GuestRegs, VariablesList, Des, DesVal);
+
+        return HasError;
+
+    case FUNC_MEMSET:
+
+        Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Src1  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        SrcVal1 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
+
+        Src2 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal2 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src2, FALSE);
+
+        Des   = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionMemset(SrcVal2, (BYTE)SrcVal1, (UINT32)SrcVal0, &HasError);
+
+        SetValue(GuestRegs, VariablesList, Des, DesVal);
+
+        return HasError;
+
+    case FUNC_MEMSEARCH:
+
+        Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Src1  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        SrcVal1 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
+
+        Src2 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal2 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src2, FALSE);
 
-        Des = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+        Des   = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
-
         *Indx = *Indx + 1;
 
-        DesVal = ScriptEngineFunctionEd(SrcVal1, SrcVal0, &HasError);
+        DesVal = ScriptEngineFunctionMemsearch(SrcVal2, (UINT32)SrcVal1, SrcVal0, &HasError);
 
         SetValue(GuestRegs, VariablesList, Des, DesVal);
 
         return HasError;
 
-    case FUNC_EB:
+    case FUNC_EVENT_ADD_RANGE:
 
         Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
                          (unsigned long long)(*Indx * sizeof(SYMBOL)));
@@ -287,54 +712,67 @@ ScriptEngineExecute(PGUEST_REGS                    GuestRegs,
         SrcVal0 =
             GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
 
-        Src1 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+        Src1  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
                          (unsigned long long)(*Indx * sizeof(SYMBOL)));
-
         *Indx = *Indx + 1;
 
         SrcVal1 =
             GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
 
-        Des = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
-                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        Src2 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
 
         *Indx = *Indx + 1;
 
-        DesVal = ScriptEngineFunctionEb(SrcVal1, SrcVal0, &HasError);
+        SrcVal2 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src2, FALSE);
+
+        Des   = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionEventAddRange(SrcVal2, SrcVal1, SrcVal0);
 
         SetValue(GuestRegs, VariablesList, Des, DesVal);
 
         return HasError;
 
-    case FUNC_EQ:
+    case FUNC_EVENT_REMOVE_RANGE:
 
-        Src0  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+        Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
                          (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
         *Indx = *Indx + 1;
 
         SrcVal0 =
             GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
 
-        Src1 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+        Src1  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
                          (unsigned long long)(*Indx * sizeof(SYMBOL)));
-
         *Indx = *Indx + 1;
 
         SrcVal1 =
             GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
 
-        Des = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
-                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        Src2 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
 
         *Indx = *Indx + 1;
 
-        DesVal = ScriptEngineFunctionEq(SrcVal1, SrcVal0, &HasError);
+        SrcVal2 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src2, FALSE);
+
+        Des   = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionEventRemoveRange(SrcVal2, SrcVal1, SrcVal0);
 
         SetValue(GuestRegs, VariablesList, Des, DesVal);
 
         return HasError;
 
-    case FUNC_INTERLOCKED_EXCHANGE:
+    case FUNC_AGG_SUM:
 
         Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
                          (unsigned long long)(*Indx * sizeof(SYMBOL)));
@@ -344,25 +782,32 @@ ScriptEngineExecute(PGUEST_REGS                    GuestRegs,
         SrcVal0 =
             GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
 
-        Src1 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+        Src1  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
                          (unsigned long long)(*Indx * sizeof(SYMBOL)));
-
         *Indx = *Indx + 1;
 
         SrcVal1 =
             GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
 
+        Src2 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
+        *Indx = *Indx + 1;
+
+        SrcVal2 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src2, FALSE);
+
         Des   = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
         *Indx = *Indx + 1;
 
-        DesVal = ScriptEngineFunctionInterlockedExchange((volatile long long *)SrcVal1, SrcVal0, &HasError);
+        DesVal = ScriptEngineFunctionAggregationSum(SrcVal2, SrcVal1, SrcVal0);
 
         SetValue(GuestRegs, VariablesList, Des, DesVal);
 
         return HasError;
 
-    case FUNC_INTERLOCKED_EXCHANGE_ADD:
+    case FUNC_AGG_MIN:
 
         Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
                          (unsigned long long)(*Indx * sizeof(SYMBOL)));
@@ -372,26 +817,32 @@ ScriptEngineExecute(PGUEST_REGS                    GuestRegs,
         SrcVal0 =
             GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
 
-        Src1 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+        Src1  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
                          (unsigned long long)(*Indx * sizeof(SYMBOL)));
-
         *Indx = *Indx + 1;
 
         SrcVal1 =
             GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
 
-        Des = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
-                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        Src2 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
 
         *Indx = *Indx + 1;
 
-        DesVal = ScriptEngineFunctionInterlockedExchangeAdd((volatile long long *)SrcVal1, SrcVal0, &HasError);
+        SrcVal2 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src2, FALSE);
+
+        Des   = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionAggregationMin(SrcVal2, SrcVal1, SrcVal0);
 
         SetValue(GuestRegs, VariablesList, Des, DesVal);
 
         return HasError;
 
-    case FUNC_INTERLOCKED_COMPARE_EXCHANGE:
+    case FUNC_AGG_MAX:
 
         Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
                          (unsigned long long)(*Indx * sizeof(SYMBOL)));
@@ -420,13 +871,13 @@ ScriptEngineExecute(PGUEST_REGS                    GuestRegs,
                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
         *Indx = *Indx + 1;
 
-        DesVal = ScriptEngineFunctionInterlockedCompareExchange((volatile long long *)SrcVal2, SrcVal1, SrcVal0, &HasError);
+        DesVal = ScriptEngineFunctionAggregationMax(SrcVal2, SrcVal1, SrcVal0);
 
         SetValue(GuestRegs, VariablesList, Des, DesVal);
 
         return HasError;
 
-    case FUNC_MEMCPY:
+    case FUNC_AGG_COUNT:
 
         Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
                          (unsigned long long)(*Indx * sizeof(SYMBOL)));
@@ -436,26 +887,37 @@ ScriptEngineExecute(PGUEST_REGS                    GuestRegs,
         SrcVal0 =
             GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
 
-        Src1  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+        Src1 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
                          (unsigned long long)(*Indx * sizeof(SYMBOL)));
+
         *Indx = *Indx + 1;
 
         SrcVal1 =
             GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
 
-        Src2 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+        ScriptEngineFunctionAggregationCount(SrcVal1, SrcVal0);
+
+        return HasError;
+
+    case FUNC_AGG_HIST:
+
+        Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
                          (unsigned long long)(*Indx * sizeof(SYMBOL)));
 
         *Indx = *Indx + 1;
 
-        SrcVal2 =
-            GetValue(GuestRegs, ActionDetail, VariablesList, Src2, FALSE);
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Src1 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
 
-        Des   = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
-                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
         *Indx = *Indx + 1;
 
-        ScriptEngineFunctionMemcpy(SrcVal2, SrcVal1, SrcVal0, &HasError);
+        SrcVal1 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src1, FALSE);
+
+        ScriptEngineFunctionAggregationHistogram(SrcVal1, SrcVal0);
 
         return HasError;
 
@@ -1189,6 +1651,25 @@ ScriptEngineExecute(PGUEST_REGS                    GuestRegs,
 
         return HasError;
 
+    case FUNC_SCRATCH:
+
+        Src0  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Des   = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionScratch(SrcVal0, &HasError);
+
+        SetValue(GuestRegs, VariablesList, Des, DesVal);
+
+        return HasError;
+
     case FUNC_STRLEN:
 
         Src0  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
@@ -1305,6 +1786,63 @@ ScriptEngineExecute(PGUEST_REGS                    GuestRegs,
 
         return HasError;
 
+    case FUNC_PERCPU_SUM:
+
+        Src0  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Des   = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionPerCoreSum(VariablesList->LocalVariablesList, SrcVal0, &HasError);
+
+        SetValue(GuestRegs, VariablesList, Des, DesVal);
+
+        return HasError;
+
+    case FUNC_PERCPU_MIN:
+
+        Src0  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Des   = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionPerCoreMin(VariablesList->LocalVariablesList, SrcVal0, &HasError);
+
+        SetValue(GuestRegs, VariablesList, Des, DesVal);
+
+        return HasError;
+
+    case FUNC_PERCPU_MAX:
+
+        Src0  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        Des   = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                        (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        DesVal = ScriptEngineFunctionPerCoreMax(VariablesList->LocalVariablesList, SrcVal0, &HasError);
+
+        SetValue(GuestRegs, VariablesList, Des, DesVal);
+
+        return HasError;
+
     case FUNC_NEG:
 
         Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
@@ -1391,6 +1929,14 @@ ScriptEngineExecute(PGUEST_REGS                    GuestRegs,
 
         *Indx = *Indx + 1;
 
+        //
+        // The message is not generated if the output of the event is disabled
+        //
+        if (ActionDetail->IsOutputDisabled)
+        {
+            return HasError;
+        }
+
         SrcVal0 =
             GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
 
@@ -1446,6 +1992,61 @@ ScriptEngineExecute(PGUEST_REGS                    GuestRegs,
 
         return HasError;
 
+    case FUNC_AGG_PRINT:
+
+        Src0  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        //
+        // The message is not generated if the output of the event is disabled
+        //
+        if (ActionDetail->IsOutputDisabled)
+        {
+            return HasError;
+        }
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        ScriptEngineFunctionAggregationPrint(ActionDetail->Tag,
+                                             ActionDetail->ImmediatelySendTheResults,
+                                             SrcVal0);
+        return HasError;
+
+    case FUNC_AGG_CLEAR:
+
+        Src0  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        ScriptEngineFunctionAggregationClear(SrcVal0);
+
+        return HasError;
+
+    case FUNC_STACK:
+
+        Src0  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                         (unsigned long long)(*Indx * sizeof(SYMBOL)));
+        *Indx = *Indx + 1;
+
+        //
+        // The record is not generated if the output of the event is disabled
+        //
+        if (ActionDetail->IsOutputDisabled)
+        {
+            return HasError;
+        }
+
+        SrcVal0 =
+            GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+        ScriptEngineFunctionStack(GuestRegs, ActionDetail->Tag, SrcVal0);
+
+        return HasError;
+
     case FUNC_EVENT_DISABLE:
 
         Src0  = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
@@ -1576,6 +2177,33 @@ ScriptEngineExecute(PGUEST_REGS                    GuestRegs,
             *Indx = *Indx + Src1->Value;
         }
 
+        //
+        // The message is not generated if the output of the event is disabled
+        //
+        if (ActionDetail->IsOutputDisabled)
+        {
+            return HasError;
+        }
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+
+        //
+        // Save a binary trace record instead of formatting the message (if enabled)
+        //
+        if (ScriptEngineFunctionPrintfBinary(GuestRegs,
+                                             ActionDetail,
+                                             VariablesList,
+                                             ActionDetail->Tag,
+                                             (char *)&Src0->Value,
+                                             0,
+                                             Src1->Value,
+                                             Src2))
+        {
+            return HasError;
+        }
+
+#endif // SCRIPT_ENGINE_KERNEL_MODE
+
         ScriptEngineFunctionPrintf(
             GuestRegs,
             ActionDetail,
@@ -1590,3 +2218,66 @@ ScriptEngineExecute(PGUEST_REGS                    GuestRegs,
         return HasError;
     }
 }
+
+/**
+ * @brief Evaluate the script buffer of an expression
+ * @details the operators are executed until a 'formats' is reached, then
+ * the value of its operand is returned instead of being shown (e.g., the
+ * expression is compiled as 'formats(expr);' or as a condition that each
+ * of its branches calls 'formats')
+ *
+ * @param GuestRegs General purpose registers
+ * @param ActionDetail Detail of the specific action
+ * @param VariablesList List of core specific (and global) variable holders
+ * @param CodeBuffer The script buffer to be evaluated
+ * @param Result The value of the expression
+ * @param ErrorOperator Error in operator
+ * @return BOOL
+ */
+BOOL
+ScriptEngineEvalExpression(PGUEST_REGS                    GuestRegs,
+                           ACTION_BUFFER *                ActionDetail,
+                           SCRIPT_ENGINE_VARIABLES_LIST * VariablesList,
+                           SYMBOL_BUFFER *                CodeBuffer,
+                           UINT64 *                       Result,
+                           SYMBOL *                       ErrorOperator)
+{
+    PSYMBOL Operator;
+    PSYMBOL Src0;
+    int     Indx = 0;
+
+    *Result = NULL;
+
+    while (Indx < CodeBuffer->Pointer)
+    {
+        Operator = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                             (unsigned long long)(Indx * sizeof(SYMBOL)));
+
+        if (Operator->Type == SYMBOL_SEMANTIC_RULE_TYPE && Operator->Value == FUNC_FORMATS)
+        {
+            Src0 = (PSYMBOL)((unsigned long long)CodeBuffer->Head +
+                             (unsigned long long)((Indx + 1) * sizeof(SYMBOL)));
+
+            *Result = GetValue(GuestRegs, ActionDetail, VariablesList, Src0, FALSE);
+
+            return FALSE;
+        }
+
+        if (ScriptEngineExecute(GuestRegs,
+                                ActionDetail,
+                                VariablesList,
+                                CodeBuffer,
+                                &Indx,
+                                ErrorOperator) == TRUE)
+        {
+            return TRUE;
+        }
+    }
+
+    //
+    // The buffer doesn't reach any 'formats'
+    //
+    *ErrorOperator = *CodeBuffer->Head;
+
+    return TRUE;
+}
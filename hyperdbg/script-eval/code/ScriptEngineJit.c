@@ -0,0 +1,857 @@
+/**
+ * @file ScriptEngineJit.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Compiling the bytecode of scripts into native x64 code
+ * @details The simple instructions (arithmetics, comparisons, moves and
+ * jumps) whose operands are located on slots are emitted as native
+ * instructions, the rest of the instructions are emitted as calls to
+ * their bytecode handlers
+ *
+ * @version 0.4
+ * @date 2023-07-12
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum size of the prologue and the epilogue
+ *
+ */
+#define SCRIPT_ENGINE_JIT_PROLOGUE_EPILOGUE_MAX_SIZE 128
+
+/**
+ * @brief Maximum size of the native code of a single instruction
+ *
+ */
+#define SCRIPT_ENGINE_JIT_INSTRUCTION_MAX_SIZE 128
+
+/**
+ * @brief Maximum count of the jumps that are resolved for a single
+ * instruction (the jump of the instruction and checking the budget)
+ *
+ */
+#define SCRIPT_ENGINE_JIT_INSTRUCTION_MAX_FIXUPS 2
+
+/**
+ * @brief Native registers that are used by the generated code
+ *
+ */
+#define SCRIPT_ENGINE_JIT_REG_RAX 0
+#define SCRIPT_ENGINE_JIT_REG_RCX 1
+#define SCRIPT_ENGINE_JIT_REG_RBX 3
+
+/**
+ * @brief The first register that holds the base of slots (r12 to r15
+ * hold global, local, temp and guest registers slots)
+ *
+ */
+#define SCRIPT_ENGINE_JIT_REG_FIRST_SLOT_BASE 12
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A jump that its displacement is resolved after emitting
+ * all of the instructions
+ *
+ */
+typedef struct _SCRIPT_ENGINE_JIT_FIXUP
+{
+    UINT32 Offset; // Offset of the rel32 in the code
+    UINT32 Target; // Target instruction (or one of the exit labels)
+
+} SCRIPT_ENGINE_JIT_FIXUP, *PSCRIPT_ENGINE_JIT_FIXUP;
+
+/**
+ * @brief The state of emitting native code
+ *
+ */
+typedef struct _SCRIPT_ENGINE_JIT_EMITTER
+{
+    PSCRIPT_ENGINE_BYTECODE  Bytecode;
+    BYTE *                   Code;
+    UINT32                   Size;
+    UINT32                   Capacity;
+    BOOLEAN                  Overflow;
+    UINT32 *                 Offsets; // Native offset of each instruction (plus the exit labels)
+    PSCRIPT_ENGINE_JIT_FIXUP Fixups;
+    UINT32                   FixupsCount;
+    UINT32                   CountedInstructions; // Instructions before it are added to the count of executed instructions
+
+} SCRIPT_ENGINE_JIT_EMITTER, *PSCRIPT_ENGINE_JIT_EMITTER;
+
+//////////////////////////////////////////////////
+//					Emitting					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Emit a buffer of bytes
+ *
+ * @param Emitter
+ * @param Bytes
+ * @param Length
+ * @return VOID
+ */
+static VOID
+ScriptEngineJitEmitBytes(PSCRIPT_ENGINE_JIT_EMITTER Emitter, const BYTE * Bytes, UINT32 Length)
+{
+    if (Emitter->Size + Length > Emitter->Capacity)
+    {
+        Emitter->Overflow = TRUE;
+        return;
+    }
+
+    for (UINT32 i = 0; i < Length; i++)
+    {
+        Emitter->Code[Emitter->Size++] = Bytes[i];
+    }
+}
+
+/**
+ * @brief Emit a single byte
+ *
+ * @param Emitter
+ * @param Byte
+ * @return VOID
+ */
+static VOID
+ScriptEngineJitEmitByte(PSCRIPT_ENGINE_JIT_EMITTER Emitter, BYTE Byte)
+{
+    ScriptEngineJitEmitBytes(Emitter, &Byte, sizeof(BYTE));
+}
+
+/**
+ * @brief Emit a 32-bit value
+ *
+ * @param Emitter
+ * @param Value
+ * @return VOID
+ */
+static VOID
+ScriptEngineJitEmitUInt32(PSCRIPT_ENGINE_JIT_EMITTER Emitter, UINT32 Value)
+{
+    for (UINT32 i = 0; i < sizeof(UINT32); i++)
+    {
+        ScriptEngineJitEmitByte(Emitter, (BYTE)(Value >> (i * 8)));
+    }
+}
+
+/**
+ * @brief Emit a 64-bit value
+ *
+ * @param Emitter
+ * @param Value
+ * @return VOID
+ */
+static VOID
+ScriptEngineJitEmitUInt64(PSCRIPT_ENGINE_JIT_EMITTER Emitter, UINT64 Value)
+{
+    ScriptEngineJitEmitUInt32(Emitter, (UINT32)Value);
+    ScriptEngineJitEmitUInt32(Emitter, (UINT32)(Value >> 32));
+}
+
+/**
+ * @brief Emit a jcc/jmp with a rel32 that is resolved later
+ *
+ * @param Emitter
+ * @param Opcode The opcode bytes of the jump
+ * @param OpcodeLength
+ * @param Target The target instruction
+ * @return VOID
+ */
+static VOID
+ScriptEngineJitEmitJump(PSCRIPT_ENGINE_JIT_EMITTER Emitter, const BYTE * Opcode, UINT32 OpcodeLength, UINT32 Target)
+{
+    ScriptEngineJitEmitBytes(Emitter, Opcode, OpcodeLength);
+
+    Emitter->Fixups[Emitter->FixupsCount].Offset = Emitter->Size;
+    Emitter->Fixups[Emitter->FixupsCount].Target = Target;
+    Emitter->FixupsCount++;
+
+    ScriptEngineJitEmitUInt32(Emitter, 0);
+}
+
+/**
+ * @brief Emit an instruction that its memory operand is a slot
+ * @details the generated form is 'op reg, [base + index * 8]'
+ *
+ * @param Emitter
+ * @param Opcode
+ * @param Reg rax or rcx
+ * @param Operand
+ * @return VOID
+ */
+static VOID
+ScriptEngineJitEmitSlotAccess(PSCRIPT_ENGINE_JIT_EMITTER Emitter, BYTE Opcode, UINT32 Reg, PSCRIPT_ENGINE_BYTECODE_OPERAND Operand)
+{
+    UINT32 BaseReg = SCRIPT_ENGINE_JIT_REG_FIRST_SLOT_BASE + Operand->Kind;
+
+    //
+    // REX.W + REX.B (the base is one of r12 to r15)
+    //
+    ScriptEngineJitEmitByte(Emitter, 0x49);
+    ScriptEngineJitEmitByte(Emitter, Opcode);
+
+    //
+    // mod = 10 (disp32), r12 needs a SIB byte
+    //
+    ScriptEngineJitEmitByte(Emitter, (BYTE)(0x80 | (Reg << 3) | (BaseReg & 7)));
+
+    if ((BaseReg & 7) == 4)
+    {
+        ScriptEngineJitEmitByte(Emitter, 0x24);
+    }
+
+    ScriptEngineJitEmitUInt32(Emitter, Operand->Index * sizeof(UINT64));
+}
+
+/**
+ * @brief Emit loading an operand into a register
+ *
+ * @param Emitter
+ * @param Reg rax or rcx
+ * @param Operand
+ * @return VOID
+ */
+static VOID
+ScriptEngineJitEmitLoad(PSCRIPT_ENGINE_JIT_EMITTER Emitter, UINT32 Reg, PSCRIPT_ENGINE_BYTECODE_OPERAND Operand)
+{
+    UINT64 Value;
+
+    if (Operand->Kind == SCRIPT_ENGINE_BYTECODE_OPERAND_CONSTANT)
+    {
+        Value = Emitter->Bytecode->Constants[Operand->Index];
+
+        if (Value <= MAXUINT32)
+        {
+            //
+            // mov r32, imm32 (zero-extended)
+            //
+            ScriptEngineJitEmitByte(Emitter, (BYTE)(0xB8 + Reg));
+            ScriptEngineJitEmitUInt32(Emitter, (UINT32)Value);
+        }
+        else
+        {
+            //
+            // mov r64, imm64
+            //
+            ScriptEngineJitEmitByte(Emitter, 0x48);
+            ScriptEngineJitEmitByte(Emitter, (BYTE)(0xB8 + Reg));
+            ScriptEngineJitEmitUInt64(Emitter, Value);
+        }
+
+        return;
+    }
+
+    ScriptEngineJitEmitSlotAccess(Emitter, 0x8B, Reg, Operand);
+}
+
+/**
+ * @brief Emit storing rax into an operand
+ * @details writing to constants is ignored (same as bytecode)
+ *
+ * @param Emitter
+ * @param Operand
+ * @return VOID
+ */
+static VOID
+ScriptEngineJitEmitStore(PSCRIPT_ENGINE_JIT_EMITTER Emitter, PSCRIPT_ENGINE_BYTECODE_OPERAND Operand)
+{
+    if (Operand->Kind >= SCRIPT_ENGINE_BYTECODE_WRITABLE_SLOTS_COUNT)
+    {
+        return;
+    }
+
+    ScriptEngineJitEmitSlotAccess(Emitter, 0x89, SCRIPT_ENGINE_JIT_REG_RAX, Operand);
+}
+
+/**
+ * @brief Emit setting the Ip of the context
+ * @details the Ip is only used by the handlers of jumps and for
+ * showing the operator that caused an error
+ *
+ * @param Emitter
+ * @param Ip
+ * @return VOID
+ */
+static VOID
+ScriptEngineJitEmitSetIp(PSCRIPT_ENGINE_JIT_EMITTER Emitter, UINT32 Ip)
+{
+    //
+    // mov dword [rbx + Ip], imm32
+    //
+    ScriptEngineJitEmitByte(Emitter, 0xC7);
+    ScriptEngineJitEmitByte(Emitter, 0x83);
+    ScriptEngineJitEmitUInt32(Emitter, FIELD_OFFSET(SCRIPT_ENGINE_BYTECODE_CONTEXT, Ip));
+    ScriptEngineJitEmitUInt32(Emitter, Ip);
+}
+
+/**
+ * @brief Emit calling the bytecode handler of an instruction
+ *
+ * @param Emitter
+ * @param Index Index of the instruction
+ * @return VOID
+ */
+static VOID
+ScriptEngineJitEmitHandlerCall(PSCRIPT_ENGINE_JIT_EMITTER Emitter, UINT32 Index)
+{
+    PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction = &Emitter->Bytecode->Instructions[Index];
+    const BYTE                          MovRcxRbx[] = {0x48, 0x89, 0xD9};
+    const BYTE                          CallRax[]   = {0xFF, 0xD0};
+
+    ScriptEngineJitEmitSetIp(Emitter, Index + 1);
+
+    ScriptEngineJitEmitBytes(Emitter, MovRcxRbx, sizeof(MovRcxRbx));
+
+    //
+    // mov rdx, Instruction
+    //
+    ScriptEngineJitEmitByte(Emitter, 0x48);
+    ScriptEngineJitEmitByte(Emitter, 0xBA);
+    ScriptEngineJitEmitUInt64(Emitter, (UINT64)Instruction);
+
+    //
+    // mov rax, Handler
+    //
+    ScriptEngineJitEmitByte(Emitter, 0x48);
+    ScriptEngineJitEmitByte(Emitter, 0xB8);
+    ScriptEngineJitEmitUInt64(Emitter, (UINT64)Instruction->Handler);
+
+    ScriptEngineJitEmitBytes(Emitter, CallRax, sizeof(CallRax));
+}
+
+/**
+ * @brief Emit adding the instructions (since the last time) to the count
+ * of the executed instructions and checking the instruction budget
+ * @details the native code doesn't count each instruction, the count is
+ * added before the jumps and the exit, so it's an approximation if the
+ * instructions are reached by the jumps, the budget is only checked before
+ * the jumps back (loops)
+ *
+ * @param Emitter
+ * @param Index Index of the instruction (it's also counted)
+ * @param CheckBudget Whether to check the instruction budget
+ * @return VOID
+ */
+static VOID
+ScriptEngineJitEmitInstructionsCount(PSCRIPT_ENGINE_JIT_EMITTER Emitter, UINT32 Index, BOOLEAN CheckBudget)
+{
+    const BYTE Ja[] = {0x0F, 0x87};
+
+    if (Index + 1 > Emitter->CountedInstructions)
+    {
+        //
+        // add qword [rbx + InstructionsCount], imm32
+        //
+        ScriptEngineJitEmitByte(Emitter, 0x48);
+        ScriptEngineJitEmitByte(Emitter, 0x81);
+        ScriptEngineJitEmitByte(Emitter, 0x83);
+        ScriptEngineJitEmitUInt32(Emitter, FIELD_OFFSET(SCRIPT_ENGINE_BYTECODE_CONTEXT, InstructionsCount));
+        ScriptEngineJitEmitUInt32(Emitter, Index + 1 - Emitter->CountedInstructions);
+
+        Emitter->CountedInstructions = Index + 1;
+    }
+
+    if (!CheckBudget)
+    {
+        return;
+    }
+
+    //
+    // The jump is shown as the operator if the budget is exceeded
+    //
+    ScriptEngineJitEmitSetIp(Emitter, Index + 1);
+
+    //
+    // mov rax, [rbx + InstructionsCount]; cmp rax, [rbx + InstructionsBudget]
+    //
+    ScriptEngineJitEmitByte(Emitter, 0x48);
+    ScriptEngineJitEmitByte(Emitter, 0x8B);
+    ScriptEngineJitEmitByte(Emitter, 0x83);
+    ScriptEngineJitEmitUInt32(Emitter, FIELD_OFFSET(SCRIPT_ENGINE_BYTECODE_CONTEXT, InstructionsCount));
+
+    ScriptEngineJitEmitByte(Emitter, 0x48);
+    ScriptEngineJitEmitByte(Emitter, 0x3B);
+    ScriptEngineJitEmitByte(Emitter, 0x83);
+    ScriptEngineJitEmitUInt32(Emitter, FIELD_OFFSET(SCRIPT_ENGINE_BYTECODE_CONTEXT, InstructionsBudget));
+
+    ScriptEngineJitEmitJump(Emitter, Ja, sizeof(Ja), Emitter->Bytecode->InstructionsCount + 1);
+}
+
+//////////////////////////////////////////////////
+//					Instructions				//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Check whether the operands of an instruction are located on slots
+ *
+ * @param Instruction
+ * @param SourcesCount
+ * @param HasDestination
+ * @return BOOLEAN
+ */
+static BOOLEAN
+ScriptEngineJitIsFastInstruction(PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction, UINT32 SourcesCount, BOOLEAN HasDestination)
+{
+    if (SourcesCount >= 1 && Instruction->Src0.Kind >= SCRIPT_ENGINE_BYTECODE_SLOTS_COUNT)
+    {
+        return FALSE;
+    }
+
+    if (SourcesCount >= 2 && Instruction->Src1.Kind >= SCRIPT_ENGINE_BYTECODE_SLOTS_COUNT)
+    {
+        return FALSE;
+    }
+
+    if (HasDestination && Instruction->Des.Kind >= SCRIPT_ENGINE_BYTECODE_SLOTS_COUNT)
+    {
+        return FALSE;
+    }
+
+    //
+    // Writes to global variables are tracked by the handlers (for detecting
+    // the contention of global variables)
+    //
+    if (HasDestination && Instruction->Des.Kind == SCRIPT_ENGINE_BYTECODE_OPERAND_GLOBAL)
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Emit the native code of a single instruction
+ *
+ * @param Emitter
+ * @param Index Index of the instruction
+ * @return VOID
+ */
+static VOID
+ScriptEngineJitEmitInstruction(PSCRIPT_ENGINE_JIT_EMITTER Emitter, UINT32 Index)
+{
+    PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instruction = &Emitter->Bytecode->Instructions[Index];
+    const BYTE *                        Operation   = NULL;
+    UINT32                              OperationLength;
+    const BYTE                          AddRaxRcx[]  = {0x48, 0x01, 0xC8};
+    const BYTE                          SubRaxRcx[]  = {0x48, 0x29, 0xC8};
+    const BYTE                          AndRaxRcx[]  = {0x48, 0x21, 0xC8};
+    const BYTE                          OrRaxRcx[]   = {0x48, 0x09, 0xC8};
+    const BYTE                          XorRaxRcx[]  = {0x48, 0x31, 0xC8};
+    const BYTE                          ImulRaxRcx[] = {0x48, 0x0F, 0xAF, 0xC1};
+    const BYTE                          ShlRaxCl[]   = {0x48, 0xD3, 0xE0};
+    const BYTE                          ShrRaxCl[]   = {0x48, 0xD3, 0xE8};
+    const BYTE                          NotRax[]     = {0x48, 0xF7, 0xD0};
+    const BYTE                          NegRax[]     = {0x48, 0xF7, 0xD8};
+    const BYTE                          IncRax[]     = {0x48, 0xFF, 0xC0};
+    const BYTE                          DecRax[]     = {0x48, 0xFF, 0xC8};
+    const BYTE                          CmpRaxRcx[]  = {0x48, 0x39, 0xC8};
+    const BYTE                          MovzxEaxAl[] = {0x0F, 0xB6, 0xC0};
+    const BYTE                          TestRaxRax[] = {0x48, 0x85, 0xC0};
+    const BYTE                          TestRcxRcx[] = {0x48, 0x85, 0xC9};
+    const BYTE                          TestEaxEax[] = {0x85, 0xC0};
+    const BYTE                          XorEdxEdx[]  = {0x31, 0xD2};
+    const BYTE                          XorEaxEax[]  = {0x31, 0xC0};
+    const BYTE                          DivRcx[]     = {0x48, 0xF7, 0xF1};
+    const BYTE                          MovRaxRdx[]  = {0x48, 0x89, 0xD0};
+    const BYTE                          Jmp[]        = {0xE9};
+    const BYTE                          Jz[]         = {0x0F, 0x84};
+    const BYTE                          Jnz[]        = {0x0F, 0x85};
+    BYTE                                SetccAl[]    = {0x0F, 0x00, 0xC0};
+    UINT32                              ErrorExit    = Emitter->Bytecode->InstructionsCount + 1;
+
+    switch (Instruction->Operator)
+    {
+    case FUNC_ADD:
+        Operation       = AddRaxRcx;
+        OperationLength = sizeof(AddRaxRcx);
+        break;
+
+    case FUNC_SUB:
+        Operation       = SubRaxRcx;
+        OperationLength = sizeof(SubRaxRcx);
+        break;
+
+    case FUNC_AND:
+        Operation       = AndRaxRcx;
+        OperationLength = sizeof(AndRaxRcx);
+        break;
+
+    case FUNC_OR:
+        Operation       = OrRaxRcx;
+        OperationLength = sizeof(OrRaxRcx);
+        break;
+
+    case FUNC_XOR:
+        Operation       = XorRaxRcx;
+        OperationLength = sizeof(XorRaxRcx);
+        break;
+
+    case FUNC_MUL:
+        Operation       = ImulRaxRcx;
+        OperationLength = sizeof(ImulRaxRcx);
+        break;
+
+    case FUNC_ASL:
+        Operation       = ShlRaxCl;
+        OperationLength = sizeof(ShlRaxCl);
+        break;
+
+    case FUNC_ASR:
+        Operation       = ShrRaxCl;
+        OperationLength = sizeof(ShrRaxCl);
+        break;
+
+    case FUNC_GT:
+        SetccAl[1] = 0x97; // seta
+        break;
+
+    case FUNC_LT:
+        SetccAl[1] = 0x92; // setb
+        break;
+
+    case FUNC_EGT:
+        SetccAl[1] = 0x93; // setae
+        break;
+
+    case FUNC_ELT:
+        SetccAl[1] = 0x96; // setbe
+        break;
+
+    case FUNC_EQUAL:
+        SetccAl[1] = 0x94; // sete
+        break;
+
+    case FUNC_NEQ:
+        SetccAl[1] = 0x95; // setne
+        break;
+
+    default:
+        break;
+    }
+
+    //
+    // Binary operations and comparisons (Des = Src1 op Src0)
+    //
+    if ((Operation != NULL || SetccAl[1] != 0x00) &&
+        ScriptEngineJitIsFastInstruction(Instruction, 2, TRUE))
+    {
+        ScriptEngineJitEmitLoad(Emitter, SCRIPT_ENGINE_JIT_REG_RAX, &Instruction->Src1);
+        ScriptEngineJitEmitLoad(Emitter, SCRIPT_ENGINE_JIT_REG_RCX, &Instruction->Src0);
+
+        if (Operation != NULL)
+        {
+            ScriptEngineJitEmitBytes(Emitter, Operation, OperationLength);
+        }
+        else
+        {
+            ScriptEngineJitEmitBytes(Emitter, CmpRaxRcx, sizeof(CmpRaxRcx));
+            ScriptEngineJitEmitBytes(Emitter, SetccAl, sizeof(SetccAl));
+            ScriptEngineJitEmitBytes(Emitter, MovzxEaxAl, sizeof(MovzxEaxAl));
+        }
+
+        ScriptEngineJitEmitStore(Emitter, &Instruction->Des);
+        return;
+    }
+
+    switch (Instruction->Operator)
+    {
+    case FUNC_DIV:
+    case FUNC_MOD:
+
+        if (!ScriptEngineJitIsFastInstruction(Instruction, 2, TRUE))
+        {
+            break;
+        }
+
+        //
+        // Dividing by zero is an error
+        //
+        ScriptEngineJitEmitSetIp(Emitter, Index + 1);
+        ScriptEngineJitEmitLoad(Emitter, SCRIPT_ENGINE_JIT_REG_RAX, &Instruction->Src1);
+        ScriptEngineJitEmitLoad(Emitter, SCRIPT_ENGINE_JIT_REG_RCX, &Instruction->Src0);
+        ScriptEngineJitEmitBytes(Emitter, TestRcxRcx, sizeof(TestRcxRcx));
+        ScriptEngineJitEmitJump(Emitter, Jz, sizeof(Jz), ErrorExit);
+        ScriptEngineJitEmitBytes(Emitter, XorEdxEdx, sizeof(XorEdxEdx));
+        ScriptEngineJitEmitBytes(Emitter, DivRcx, sizeof(DivRcx));
+
+        if (Instruction->Operator == FUNC_MOD)
+        {
+            ScriptEngineJitEmitBytes(Emitter, MovRaxRdx, sizeof(MovRaxRdx));
+        }
+
+        ScriptEngineJitEmitStore(Emitter, &Instruction->Des);
+        return;
+
+    case FUNC_MOV:
+    case FUNC_NOT:
+    case FUNC_NEG:
+
+        if (!ScriptEngineJitIsFastInstruction(Instruction, 1, TRUE))
+        {
+            break;
+        }
+
+        ScriptEngineJitEmitLoad(Emitter, SCRIPT_ENGINE_JIT_REG_RAX, &Instruction->Src0);
+
+        if (Instruction->Operator == FUNC_NOT)
+        {
+            ScriptEngineJitEmitBytes(Emitter, NotRax, sizeof(NotRax));
+        }
+        else if (Instruction->Operator == FUNC_NEG)
+        {
+            ScriptEngineJitEmitBytes(Emitter, NegRax, sizeof(NegRax));
+        }
+
+        ScriptEngineJitEmitStore(Emitter, &Instruction->Des);
+        return;
+
+    case FUNC_INC:
+    case FUNC_DEC:
+
+        if (!ScriptEngineJitIsFastInstruction(Instruction, 1, FALSE) ||
+            Instruction->Src0.Kind == SCRIPT_ENGINE_BYTECODE_OPERAND_GLOBAL)
+        {
+            break;
+        }
+
+        ScriptEngineJitEmitLoad(Emitter, SCRIPT_ENGINE_JIT_REG_RAX, &Instruction->Src0);
+
+        if (Instruction->Operator == FUNC_INC)
+        {
+            ScriptEngineJitEmitBytes(Emitter, IncRax, sizeof(IncRax));
+        }
+        else
+        {
+            ScriptEngineJitEmitBytes(Emitter, DecRax, sizeof(DecRax));
+        }
+
+        ScriptEngineJitEmitStore(Emitter, &Instruction->Src0);
+        return;
+
+    case FUNC_REFERENCE:
+
+        if (!ScriptEngineJitIsFastInstruction(Instruction, 1, TRUE))
+        {
+            break;
+        }
+
+        if (Instruction->Src0.Kind == SCRIPT_ENGINE_BYTECODE_OPERAND_CONSTANT)
+        {
+            //
+            // mov rax, &Constants[Index]
+            //
+            ScriptEngineJitEmitByte(Emitter, 0x48);
+            ScriptEngineJitEmitByte(Emitter, 0xB8);
+            ScriptEngineJitEmitUInt64(Emitter, (UINT64)&Emitter->Bytecode->Constants[Instruction->Src0.Index]);
+        }
+        else if (Instruction->Src0.Kind == SCRIPT_ENGINE_BYTECODE_OPERAND_GUEST_REGISTER)
+        {
+            //
+            // Registers don't have address
+            //
+            ScriptEngineJitEmitBytes(Emitter, XorEaxEax, sizeof(XorEaxEax));
+        }
+        else
+        {
+            //
+            // lea rax, [base + index * 8]
+            //
+            ScriptEngineJitEmitSlotAccess(Emitter, 0x8D, SCRIPT_ENGINE_JIT_REG_RAX, &Instruction->Src0);
+        }
+
+        ScriptEngineJitEmitStore(Emitter, &Instruction->Des);
+        return;
+
+    case FUNC_JMP:
+
+        ScriptEngineJitEmitInstructionsCount(Emitter, Index, Instruction->Target <= Index);
+        ScriptEngineJitEmitJump(Emitter, Jmp, sizeof(Jmp), Instruction->Target);
+        return;
+
+    case FUNC_JZ:
+    case FUNC_JNZ:
+
+        ScriptEngineJitEmitInstructionsCount(Emitter, Index, Instruction->Target <= Index);
+
+        if (Instruction->Src1.Kind < SCRIPT_ENGINE_BYTECODE_SLOTS_COUNT)
+        {
+            ScriptEngineJitEmitLoad(Emitter, SCRIPT_ENGINE_JIT_REG_RAX, &Instruction->Src1);
+            ScriptEngineJitEmitBytes(Emitter, TestRaxRax, sizeof(TestRaxRax));
+            ScriptEngineJitEmitJump(Emitter,
+                                    Instruction->Operator == FUNC_JZ ? Jz : Jnz,
+                                    Instruction->Operator == FUNC_JZ ? sizeof(Jz) : sizeof(Jnz),
+                                    Instruction->Target);
+            return;
+        }
+
+        //
+        // The handler changes the Ip if the jump is taken
+        //
+        ScriptEngineJitEmitHandlerCall(Emitter, Index);
+
+        //
+        // cmp dword [rbx + Ip], imm32
+        //
+        ScriptEngineJitEmitByte(Emitter, 0x81);
+        ScriptEngineJitEmitByte(Emitter, 0xBB);
+        ScriptEngineJitEmitUInt32(Emitter, FIELD_OFFSET(SCRIPT_ENGINE_BYTECODE_CONTEXT, Ip));
+        ScriptEngineJitEmitUInt32(Emitter, Index + 1);
+
+        ScriptEngineJitEmitJump(Emitter, Jnz, sizeof(Jnz), Instruction->Target);
+        return;
+
+    default:
+        break;
+    }
+
+    //
+    // Other instructions are performed by their handlers
+    //
+    ScriptEngineJitEmitHandlerCall(Emitter, Index);
+    ScriptEngineJitEmitBytes(Emitter, TestEaxEax, sizeof(TestEaxEax));
+    ScriptEngineJitEmitJump(Emitter, Jnz, sizeof(Jnz), ErrorExit);
+}
+
+//////////////////////////////////////////////////
+//					Compiling					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Get the size of the buffer that is needed for the native code
+ * @details the buffer also holds the offsets and fixups that are used
+ * while compiling
+ *
+ * @param Bytecode
+ * @return UINT32
+ */
+UINT32
+ScriptEngineJitGetRequiredSize(PSCRIPT_ENGINE_BYTECODE Bytecode)
+{
+    return SCRIPT_ENGINE_JIT_PROLOGUE_EPILOGUE_MAX_SIZE +
+           Bytecode->InstructionsCount * SCRIPT_ENGINE_JIT_INSTRUCTION_MAX_SIZE +
+           (Bytecode->InstructionsCount + 2) * sizeof(UINT32) +
+           Bytecode->InstructionsCount * SCRIPT_ENGINE_JIT_INSTRUCTION_MAX_FIXUPS * sizeof(SCRIPT_ENGINE_JIT_FIXUP);
+}
+
+/**
+ * @brief Compile the bytecode into native x64 code
+ * @details the generated routine saves its non-volatile registers and
+ * aligns the stack by itself, so it can be directly called
+ *
+ * @param Bytecode The compiled script
+ * @param Buffer The executable buffer
+ * @param BufferSize Size of the buffer (from ScriptEngineJitGetRequiredSize)
+ * @return BOOLEAN
+ */
+BOOLEAN
+ScriptEngineJitCompile(PSCRIPT_ENGINE_BYTECODE Bytecode,
+                       PVOID                   Buffer,
+                       UINT32                  BufferSize)
+{
+    SCRIPT_ENGINE_JIT_EMITTER Emitter    = {0};
+    UINT32                    TablesSize = 0;
+    INT32                     Displacement;
+
+    //
+    // push rbp; mov rbp, rsp; push rbx; push r12; push r13; push r14; push r15;
+    // and rsp, -16; sub rsp, 0x20 (shadow space); mov rbx, rcx
+    //
+    const BYTE Prologue[] = {0x55, 0x48, 0x89, 0xE5, 0x53, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57, 0x48, 0x83, 0xE4, 0xF0, 0x48, 0x83, 0xEC, 0x20, 0x48, 0x89, 0xCB};
+
+    //
+    // Success: xor eax, eax; jmp short Epilogue
+    // Error: mov eax, 1
+    // Epilogue: lea rsp, [rbp - 40]; pop r15; pop r14; pop r13; pop r12; pop rbx; pop rbp; ret
+    //
+    const BYTE Success[]  = {0x31, 0xC0, 0xEB, 0x05};
+    const BYTE Error[]    = {0xB8, 0x01, 0x00, 0x00, 0x00};
+    const BYTE Epilogue[] = {0x48, 0x8D, 0x65, 0xD8, 0x41, 0x5F, 0x41, 0x5E, 0x41, 0x5D, 0x41, 0x5C, 0x5B, 0x5D, 0xC3};
+
+    TablesSize = (Bytecode->InstructionsCount + 2) * sizeof(UINT32) +
+                 Bytecode->InstructionsCount * SCRIPT_ENGINE_JIT_INSTRUCTION_MAX_FIXUPS * sizeof(SCRIPT_ENGINE_JIT_FIXUP);
+
+    if (BufferSize < ScriptEngineJitGetRequiredSize(Bytecode))
+    {
+        return FALSE;
+    }
+
+    //
+    // The offsets and fixups are located at the end of the buffer
+    //
+    Emitter.Bytecode = Bytecode;
+    Emitter.Code     = (BYTE *)Buffer;
+    Emitter.Capacity = BufferSize - TablesSize;
+    Emitter.Offsets  = (UINT32 *)((BYTE *)Buffer + Emitter.Capacity);
+    Emitter.Fixups   = (PSCRIPT_ENGINE_JIT_FIXUP)(Emitter.Offsets + Bytecode->InstructionsCount + 2);
+
+    ScriptEngineJitEmitBytes(&Emitter, Prologue, sizeof(Prologue));
+
+    //
+    // Load the base of slots into r12 to r15
+    //
+    for (UINT32 i = 0; i < SCRIPT_ENGINE_BYTECODE_WRITABLE_SLOTS_COUNT; i++)
+    {
+        //
+        // mov r12 + i, [rbx + Slots[i]]
+        //
+        ScriptEngineJitEmitByte(&Emitter, 0x4C);
+        ScriptEngineJitEmitByte(&Emitter, 0x8B);
+        ScriptEngineJitEmitByte(&Emitter, (BYTE)(0x80 | (((SCRIPT_ENGINE_JIT_REG_FIRST_SLOT_BASE + i) & 7) << 3) | SCRIPT_ENGINE_JIT_REG_RBX));
+        ScriptEngineJitEmitUInt32(&Emitter, FIELD_OFFSET(SCRIPT_ENGINE_BYTECODE_CONTEXT, Slots) + i * sizeof(UINT64 *));
+    }
+
+    for (UINT32 i = 0; i < Bytecode->InstructionsCount; i++)
+    {
+        Emitter.Offsets[i] = Emitter.Size;
+
+        ScriptEngineJitEmitInstruction(&Emitter, i);
+    }
+
+    //
+    // The rest of the instructions are counted before the exit
+    //
+    if (Bytecode->InstructionsCount != 0)
+    {
+        ScriptEngineJitEmitInstructionsCount(&Emitter, Bytecode->InstructionsCount - 1, FALSE);
+    }
+
+    Emitter.Offsets[Bytecode->InstructionsCount] = Emitter.Size;
+    ScriptEngineJitEmitBytes(&Emitter, Success, sizeof(Success));
+
+    Emitter.Offsets[Bytecode->InstructionsCount + 1] = Emitter.Size;
+    ScriptEngineJitEmitBytes(&Emitter, Error, sizeof(Error));
+
+    ScriptEngineJitEmitBytes(&Emitter, Epilogue, sizeof(Epilogue));
+
+    if (Emitter.Overflow)
+    {
+        return FALSE;
+    }
+
+    //
+    // Resolve the displacements of jumps
+    //
+    for (UINT32 i = 0; i < Emitter.FixupsCount; i++)
+    {
+        Displacement = (INT32)Emitter.Offsets[Emitter.Fixups[i].Target] -
+                       (INT32)(Emitter.Fixups[i].Offset + sizeof(UINT32));
+
+        for (UINT32 j = 0; j < sizeof(UINT32); j++)
+        {
+            Emitter.Code[Emitter.Fixups[i].Offset + j] = (BYTE)((UINT32)Displacement >> (j * 8));
+        }
+    }
+
+    Bytecode->NativeCode = (SCRIPT_ENGINE_NATIVE_ROUTINE)Buffer;
+
+    return TRUE;
+}
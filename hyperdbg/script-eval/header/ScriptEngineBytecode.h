@@ -0,0 +1,166 @@
+/**
+ * @file ScriptEngineBytecode.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the pre-compiled (bytecode) form of scripts
+ * @details
+ * @version 0.4
+ * @date 2023-07-10
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The number of operand kinds that are directly loaded from
+ * a slot array (global, local, temp, guest register and constant)
+ *
+ */
+#define SCRIPT_ENGINE_BYTECODE_SLOTS_COUNT 5
+
+/**
+ * @brief The number of operand kinds that their slots can be modified
+ * (global, local, temp and guest register)
+ *
+ */
+#define SCRIPT_ENGINE_BYTECODE_WRITABLE_SLOTS_COUNT 4
+
+//////////////////////////////////////////////////
+//					Enums						//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Kinds of operands in the bytecode
+ * @details the order is important, the slot kinds are located at
+ * the start and the writable slots are located before the read-only
+ * slots
+ *
+ */
+typedef enum _SCRIPT_ENGINE_BYTECODE_OPERAND_KIND
+{
+    SCRIPT_ENGINE_BYTECODE_OPERAND_GLOBAL = 0,
+    SCRIPT_ENGINE_BYTECODE_OPERAND_LOCAL,
+    SCRIPT_ENGINE_BYTECODE_OPERAND_TEMP,
+    SCRIPT_ENGINE_BYTECODE_OPERAND_GUEST_REGISTER,
+    SCRIPT_ENGINE_BYTECODE_OPERAND_CONSTANT,
+    SCRIPT_ENGINE_BYTECODE_OPERAND_REGISTER,
+    SCRIPT_ENGINE_BYTECODE_OPERAND_PSEUDO_REGISTER,
+
+} SCRIPT_ENGINE_BYTECODE_OPERAND_KIND;
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A pre-resolved operand of an instruction
+ * @details for the slot kinds, the index is the index of the value
+ * in its slot array, otherwise it's the register or pseudo-register
+ *
+ */
+typedef struct _SCRIPT_ENGINE_BYTECODE_OPERAND
+{
+    UINT32 Kind;
+    UINT32 Index;
+
+} SCRIPT_ENGINE_BYTECODE_OPERAND, *PSCRIPT_ENGINE_BYTECODE_OPERAND;
+
+/**
+ * @brief The state of executing bytecode
+ *
+ */
+typedef struct _SCRIPT_ENGINE_BYTECODE_CONTEXT
+{
+    UINT64 *                       Slots[SCRIPT_ENGINE_BYTECODE_SLOTS_COUNT];
+    PGUEST_REGS                    GuestRegs;
+    ACTION_BUFFER *                ActionDetail;
+    SCRIPT_ENGINE_VARIABLES_LIST * VariablesList;
+    UINT32                         Ip;
+    UINT64                         InstructionsCount;  // Count of the executed instructions
+    UINT64                         InstructionsBudget; // The script is aborted once the count exceeds it
+
+} SCRIPT_ENGINE_BYTECODE_CONTEXT, *PSCRIPT_ENGINE_BYTECODE_CONTEXT;
+
+struct _SCRIPT_ENGINE_BYTECODE_INSTRUCTION;
+
+/**
+ * @brief The handler of a single instruction
+ * @details returns TRUE if the instruction has an error
+ *
+ */
+typedef BOOL (*SCRIPT_ENGINE_BYTECODE_HANDLER)(PSCRIPT_ENGINE_BYTECODE_CONTEXT              Context,
+                                               struct _SCRIPT_ENGINE_BYTECODE_INSTRUCTION * Instruction);
+
+/**
+ * @brief A single instruction of the bytecode
+ *
+ */
+typedef struct _SCRIPT_ENGINE_BYTECODE_INSTRUCTION
+{
+    SCRIPT_ENGINE_BYTECODE_HANDLER Handler;  // Pre-resolved handler of the operator
+    UINT32                         Operator; // The original operator (used for showing errors)
+    UINT32                         Target;   // Target instruction of jumps or the arguments count of printf
+    SCRIPT_ENGINE_BYTECODE_OPERAND Src0;
+    SCRIPT_ENGINE_BYTECODE_OPERAND Src1;
+    SCRIPT_ENGINE_BYTECODE_OPERAND Src2;
+    SCRIPT_ENGINE_BYTECODE_OPERAND Des;
+    CHAR *                         Format;    // The format string of printf
+    UINT32                         FormatId;  // The identifier of the format string of printf (binary trace records)
+    PSYMBOL                        Arguments; // The arguments of printf (in the original buffer)
+
+} SCRIPT_ENGINE_BYTECODE_INSTRUCTION, *PSCRIPT_ENGINE_BYTECODE_INSTRUCTION;
+
+/**
+ * @brief The routine of the native code that is generated from bytecode
+ * @details returns TRUE if an instruction has an error, in this case the
+ * Ip of the context is set to the next instruction
+ *
+ */
+typedef BOOL (*SCRIPT_ENGINE_NATIVE_ROUTINE)(PSCRIPT_ENGINE_BYTECODE_CONTEXT Context);
+
+/**
+ * @brief The pre-compiled form of a script
+ * @details the instructions, constants and the mapping of symbols are
+ * located right after this structure in the same buffer
+ *
+ */
+typedef struct _SCRIPT_ENGINE_BYTECODE
+{
+    UINT32                              InstructionsCount;
+    UINT32                              ConstantsCount;
+    PSCRIPT_ENGINE_BYTECODE_INSTRUCTION Instructions;
+    UINT64 *                            Constants;
+    SCRIPT_ENGINE_NATIVE_ROUTINE        NativeCode; // The native form of the bytecode (if any)
+
+} SCRIPT_ENGINE_BYTECODE, *PSCRIPT_ENGINE_BYTECODE;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+UINT32
+ScriptEngineBytecodeGetRequiredSize(SYMBOL_BUFFER * CodeBuffer);
+
+BOOLEAN
+ScriptEngineBytecodeCompile(SYMBOL_BUFFER *         CodeBuffer,
+                            PSCRIPT_ENGINE_BYTECODE Bytecode,
+                            UINT32                  BufferSize);
+
+BOOL
+ScriptEngineBytecodeExecute(PGUEST_REGS                    GuestRegs,
+                            ACTION_BUFFER *                ActionDetail,
+                            SCRIPT_ENGINE_VARIABLES_LIST * VariablesList,
+                            PSCRIPT_ENGINE_BYTECODE        Bytecode,
+                            SYMBOL *                       ErrorOperator);
+
+UINT32
+ScriptEngineJitGetRequiredSize(PSCRIPT_ENGINE_BYTECODE Bytecode);
+
+BOOLEAN
+ScriptEngineJitCompile(PSCRIPT_ENGINE_BYTECODE Bytecode,
+                       PVOID                   Buffer,
+                       UINT32                  BufferSize);
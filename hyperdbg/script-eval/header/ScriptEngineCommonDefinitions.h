@@ -16,11 +16,17 @@ typedef struct SYMBOL_MAP
     char* Name;
     long long unsigned Type;
 } SYMBOL_MAP, * PSYMBOL_MAP;
+#define ACTION_BUFFER_PSEUDO_REGISTERS_CACHE_SIZE 8
 typedef struct ACTION_BUFFER {
   long long unsigned Tag;
   long long unsigned CurrentAction;
   char ImmediatelySendTheResults;
+  char IsOutputDisabled;
   long long unsigned Context;
+  long long unsigned InstructionsBudget;
+  long long unsigned InstructionsCount;
+  unsigned int PseudoRegistersCacheValid;
+  long long unsigned PseudoRegistersCache[ACTION_BUFFER_PSEUDO_REGISTERS_CACHE_SIZE];
 } ACTION_BUFFER, *PACTION_BUFFER;
 
 
@@ -86,66 +92,101 @@ typedef struct ACTION_BUFFER {
 #define FUNC_TEST_STATEMENT 43
 #define FUNC_SPINLOCK_LOCK 44
 #define FUNC_SPINLOCK_UNLOCK 45
-#define FUNC_PRINTF 46
-#define FUNC_PAUSE 47
-#define FUNC_FLUSH 48
-#define FUNC_SPINLOCK_LOCK_CUSTOM_WAIT 49
-#define FUNC_POI 50
-#define FUNC_DB 51
-#define FUNC_DD 52
-#define FUNC_DW 53
-#define FUNC_DQ 54
-#define FUNC_NEG 55
-#define FUNC_HI 56
-#define FUNC_LOW 57
-#define FUNC_NOT 58
-#define FUNC_CHECK_ADDRESS 59
-#define FUNC_STRLEN 60
-#define FUNC_WCSLEN 61
-#define FUNC_DISASSEMBLE_LEN 62
-#define FUNC_DISASSEMBLE_LEN32 63
-#define FUNC_DISASSEMBLE_LEN64 64
-#define FUNC_INTERLOCKED_INCREMENT 65
-#define FUNC_INTERLOCKED_DECREMENT 66
-#define FUNC_REFERENCE 67
-#define FUNC_PHYSICAL_TO_VIRTUAL 68
-#define FUNC_VIRTUAL_TO_PHYSICAL 69
-#define FUNC_EVENT_SC 70
-#define FUNC_ED 71
-#define FUNC_EB 72
-#define FUNC_EQ 73
-#define FUNC_INTERLOCKED_EXCHANGE 74
-#define FUNC_INTERLOCKED_EXCHANGE_ADD 75
-#define FUNC_INTERLOCKED_COMPARE_EXCHANGE 76
-#define FUNC_MEMCPY 77
-#define FUNC_POI 78
-#define FUNC_DB 79
-#define FUNC_DD 80
-#define FUNC_DW 81
-#define FUNC_DQ 82
-#define FUNC_NEG 83
-#define FUNC_HI 84
-#define FUNC_LOW 85
-#define FUNC_NOT 86
-#define FUNC_CHECK_ADDRESS 87
-#define FUNC_STRLEN 88
-#define FUNC_WCSLEN 89
-#define FUNC_DISASSEMBLE_LEN 90
-#define FUNC_DISASSEMBLE_LEN32 91
-#define FUNC_DISASSEMBLE_LEN64 92
-#define FUNC_INTERLOCKED_INCREMENT 93
-#define FUNC_INTERLOCKED_DECREMENT 94
-#define FUNC_REFERENCE 95
-#define FUNC_PHYSICAL_TO_VIRTUAL 96
-#define FUNC_VIRTUAL_TO_PHYSICAL 97
-#define FUNC_EVENT_SC 98
-#define FUNC_ED 99
-#define FUNC_EB 100
-#define FUNC_EQ 101
-#define FUNC_INTERLOCKED_EXCHANGE 102
-#define FUNC_INTERLOCKED_EXCHANGE_ADD 103
-#define FUNC_INTERLOCKED_COMPARE_EXCHANGE 104
-#define FUNC_MEMCPY 105
+#define FUNC_AGG_PRINT 46
+#define FUNC_AGG_CLEAR 47
+#define FUNC_STACK 48
+#define FUNC_PRINTF 49
+#define FUNC_PAUSE 50
+#define FUNC_FLUSH 51
+#define FUNC_SPINLOCK_LOCK_CUSTOM_WAIT 52
+#define FUNC_AGG_COUNT 53
+#define FUNC_AGG_HIST 54
+#define FUNC_POI 55
+#define FUNC_DB 56
+#define FUNC_DD 57
+#define FUNC_DW 58
+#define FUNC_DQ 59
+#define FUNC_NEG 60
+#define FUNC_HI 61
+#define FUNC_LOW 62
+#define FUNC_NOT 63
+#define FUNC_CHECK_ADDRESS 64
+#define FUNC_STRLEN 65
+#define FUNC_WCSLEN 66
+#define FUNC_DISASSEMBLE_LEN 67
+#define FUNC_DISASSEMBLE_LEN32 68
+#define FUNC_DISASSEMBLE_LEN64 69
+#define FUNC_INTERLOCKED_INCREMENT 70
+#define FUNC_INTERLOCKED_DECREMENT 71
+#define FUNC_REFERENCE 72
+#define FUNC_PHYSICAL_TO_VIRTUAL 73
+#define FUNC_VIRTUAL_TO_PHYSICAL 74
+#define FUNC_EVENT_SC 75
+#define FUNC_PERCPU_SUM 76
+#define FUNC_PERCPU_MIN 77
+#define FUNC_PERCPU_MAX 78
+#define FUNC_SCRATCH 79
+#define FUNC_ED 80
+#define FUNC_EB 81
+#define FUNC_EQ 82
+#define FUNC_INTERLOCKED_EXCHANGE 83
+#define FUNC_INTERLOCKED_EXCHANGE_ADD 84
+#define FUNC_STRCMP 85
+#define FUNC_WCSCMP 86
+#define FUNC_STRICMP 87
+#define FUNC_INTERLOCKED_COMPARE_EXCHANGE 88
+#define FUNC_MEMCPY 89
+#define FUNC_AGG_SUM 90
+#define FUNC_AGG_MIN 91
+#define FUNC_AGG_MAX 92
+#define FUNC_MEMCMP 93
+#define FUNC_MEMSET 94
+#define FUNC_MEMSEARCH 95
+#define FUNC_EVENT_ADD_RANGE 96
+#define FUNC_EVENT_REMOVE_RANGE 97
+#define FUNC_POI 98
+#define FUNC_DB 99
+#define FUNC_DD 100
+#define FUNC_DW 101
+#define FUNC_DQ 102
+#define FUNC_NEG 103
+#define FUNC_HI 104
+#define FUNC_LOW 105
+#define FUNC_NOT 106
+#define FUNC_CHECK_ADDRESS 107
+#define FUNC_STRLEN 108
+#define FUNC_WCSLEN 109
+#define FUNC_DISASSEMBLE_LEN 110
+#define FUNC_DISASSEMBLE_LEN32 111
+#define FUNC_DISASSEMBLE_LEN64 112
+#define FUNC_INTERLOCKED_INCREMENT 113
+#define FUNC_INTERLOCKED_DECREMENT 114
+#define FUNC_REFERENCE 115
+#define FUNC_PHYSICAL_TO_VIRTUAL 116
+#define FUNC_VIRTUAL_TO_PHYSICAL 117
+#define FUNC_EVENT_SC 118
+#define FUNC_PERCPU_SUM 119
+#define FUNC_PERCPU_MIN 120
+#define FUNC_PERCPU_MAX 121
+#define FUNC_SCRATCH 122
+#define FUNC_ED 123
+#define FUNC_EB 124
+#define FUNC_EQ 125
+#define FUNC_INTERLOCKED_EXCHANGE 126
+#define FUNC_INTERLOCKED_EXCHANGE_ADD 127
+#define FUNC_STRCMP 128
+#define FUNC_WCSCMP 129
+#define FUNC_STRICMP 130
+#define FUNC_INTERLOCKED_COMPARE_EXCHANGE 131
+#define FUNC_MEMCPY 132
+#define FUNC_AGG_SUM 133
+#define FUNC_AGG_MIN 134
+#define FUNC_AGG_MAX 135
+#define FUNC_MEMCMP 136
+#define FUNC_MEMSET 137
+#define FUNC_MEMSEARCH 138
+#define FUNC_EVENT_ADD_RANGE 139
+#define FUNC_EVENT_REMOVE_RANGE 140
 typedef enum REGS_ENUM {
 	REGISTER_RAX = 0,
 	REGISTER_EAX = 1,
@@ -19,6 +19,14 @@ ScriptEngineExecute(PGUEST_REGS                    GuestRegs,
                     int *                          Indx,
                     SYMBOL *                       ErrorOperator);
 
+BOOL
+ScriptEngineEvalExpression(PGUEST_REGS                    GuestRegs,
+                           ACTION_BUFFER *                ActionDetail,
+                           SCRIPT_ENGINE_VARIABLES_LIST * VariablesList,
+                           SYMBOL_BUFFER *                CodeBuffer,
+                           UINT64 *                       Result,
+                           SYMBOL *                       ErrorOperator);
+
 UINT64
 GetRegValue(PGUEST_REGS GuestRegs, REGS_ENUM RegId);
 
@@ -27,3 +35,14 @@ ScriptEngineGetOperatorName(PSYMBOL OperatorSymbol, CHAR * BufferForName);
 
 VOID
 ScriptEngineGetOperatorName(PSYMBOL OperatorSymbol, CHAR * BufferForName);
+
+#ifdef SCRIPT_ENGINE_USER_MODE
+
+BOOLEAN
+ScriptEngineFormatBinaryTraceRecord(PBINARY_TRACE_RECORD Record,
+                                    UINT32               RecordLength,
+                                    const char *         Format,
+                                    CHAR *               FinalBuffer,
+                                    UINT32               SizeOfFinalBuffer);
+
+#endif // SCRIPT_ENGINE_USER_MODE
@@ -62,6 +62,9 @@ ScriptEnginePseudoRegGetEventTag(PACTION_BUFFER ActionBuffer);
 UINT64
 ScriptEnginePseudoRegGetEventId(PACTION_BUFFER ActionBuffer);
 
+UINT64
+GetPseudoRegValue(PSYMBOL Symbol, PACTION_BUFFER ActionBuffer);
+
 //////////////////////////////////////////////////
 //			         Keywords                   //
 //////////////////////////////////////////////////
@@ -106,6 +109,27 @@ ScriptEngineFunctionCheckAddress(UINT64 Address, UINT32 Length);
 VOID
 ScriptEngineFunctionMemcpy(UINT64 Destionation, UINT64 Source, UINT32 Num, BOOL * HasError);
 
+UINT64
+ScriptEngineFunctionMemcmp(UINT64 Address1, UINT64 Address2, UINT32 Num, BOOL * HasError);
+
+UINT64
+ScriptEngineFunctionMemset(UINT64 Destination, BYTE Value, UINT32 Num, BOOL * HasError);
+
+UINT64
+ScriptEngineFunctionMemsearch(UINT64 Address, UINT32 Num, UINT64 Pattern, BOOL * HasError);
+
+UINT64
+ScriptEngineFunctionStrcmp(const char * String1, const char * String2, BOOL * HasError);
+
+UINT64
+ScriptEngineFunctionWcscmp(const wchar_t * String1, const wchar_t * String2, BOOL * HasError);
+
+UINT64
+ScriptEngineFunctionStricmp(const char * String1, const char * String2, BOOL * HasError);
+
+UINT64
+ScriptEngineFunctionScratch(UINT64 Size, BOOL * HasError);
+
 UINT64
 ScriptEngineFunctionVirtualToPhysical(UINT64 Address);
 
@@ -166,6 +190,12 @@ ScriptEngineFunctionEnableEvent(UINT64  Tag,
                                 BOOLEAN ImmediateMessagePassing,
                                 UINT64  Value);
 
+UINT64
+ScriptEngineFunctionEventAddRange(UINT64 EventId, UINT64 FromAddress, UINT64 ToAddress);
+
+UINT64
+ScriptEngineFunctionEventRemoveRange(UINT64 EventId, UINT64 FromAddress, UINT64 ToAddress);
+
 VOID
 ScriptEngineFunctionDisableEvent(UINT64  Tag,
                                  BOOLEAN ImmediateMessagePassing,
@@ -180,9 +210,42 @@ ScriptEngineFunctionPause(UINT64      Tag,
 VOID
 ScriptEngineFunctionFlush();
 
+VOID
+ScriptEngineFunctionStack(PGUEST_REGS GuestRegs, UINT64 Tag, UINT64 Count);
+
 VOID
 ScriptEngineFunctionShortCircuitingEvent(UINT64 State);
 
+VOID
+ScriptEngineFunctionAggregationCount(UINT64 MapId, UINT64 Key);
+
+UINT64
+ScriptEngineFunctionAggregationSum(UINT64 MapId, UINT64 Key, UINT64 Value);
+
+UINT64
+ScriptEngineFunctionAggregationMin(UINT64 MapId, UINT64 Key, UINT64 Value);
+
+UINT64
+ScriptEngineFunctionAggregationMax(UINT64 MapId, UINT64 Key, UINT64 Value);
+
+VOID
+ScriptEngineFunctionAggregationHistogram(UINT64 MapId, UINT64 Value);
+
+VOID
+ScriptEngineFunctionAggregationPrint(UINT64 Tag, BOOLEAN ImmediateMessagePassing, UINT64 MapId);
+
+VOID
+ScriptEngineFunctionAggregationClear(UINT64 MapId);
+
+UINT64
+ScriptEngineFunctionPerCoreSum(UINT64 * LocalVariablesList, UINT64 Address, BOOL * HasError);
+
+UINT64
+ScriptEngineFunctionPerCoreMin(UINT64 * LocalVariablesList, UINT64 Address, BOOL * HasError);
+
+UINT64
+ScriptEngineFunctionPerCoreMax(UINT64 * LocalVariablesList, UINT64 Address, BOOL * HasError);
+
 VOID
 ScriptEngineFunctionFormats(UINT64 Tag, BOOLEAN ImmediateMessagePassing, UINT64 Value);
 
@@ -196,3 +259,17 @@ ScriptEngineFunctionPrintf(PGUEST_REGS                    GuestRegs,
                            UINT64                         ArgCount,
                            PSYMBOL                        FirstArg,
                            BOOLEAN *                      HasError);
+
+#ifdef SCRIPT_ENGINE_KERNEL_MODE
+
+BOOLEAN
+ScriptEngineFunctionPrintfBinary(PGUEST_REGS                    GuestRegs,
+                                 ACTION_BUFFER *                ActionDetail,
+                                 SCRIPT_ENGINE_VARIABLES_LIST * VariablesList,
+                                 UINT64                         Tag,
+                                 char *                         Format,
+                                 UINT32                         FormatId,
+                                 UINT64                         ArgCount,
+                                 PSYMBOL                        FirstArg);
+
+#endif // SCRIPT_ENGINE_KERNEL_MODE
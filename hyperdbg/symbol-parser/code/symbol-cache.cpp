@@ -0,0 +1,256 @@
+/**
+ * @file symbol-cache.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Persistent (on-disk) cache of symbols
+ * @details the symbols of each pdb file are saved in a cache file next
+ * to the pdb file which is keyed by the GUID and age of the pdb, later
+ * loads map the cache file instead of parsing the pdb file
+ * @version 0.4
+ * @date 2023-08-15
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Get the GUID and age of the pdb file of a module
+ *
+ * @param Module
+ * @param GuidAndAge
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+SymbolCacheGetGuidAndAge(PSYMBOL_LOADED_MODULE_DETAILS Module, char * GuidAndAge)
+{
+    char PdbFileName[MAX_PATH + 1] = {0};
+
+    return SymConvertFileToPdbFileAndGuidAndAgeDetails(Module->PdbFilePath, PdbFileName, GuidAndAge);
+}
+
+/**
+ * @brief Deliver the symbols of a module from its cache file
+ * @details the cache file is only used if its GUID and age are the
+ * same as the GUID and age of the pdb file
+ *
+ * @param Module
+ * @param Callback
+ *
+ * @return BOOLEAN Returns true if a valid cache is found and delivered
+ */
+BOOLEAN
+SymbolCacheDeliverSymbols(PSYMBOL_LOADED_MODULE_DETAILS Module, SymbolMapCallback Callback)
+{
+    HANDLE                    FileHandle                            = INVALID_HANDLE_VALUE;
+    HANDLE                    MappingHandle                         = NULL;
+    PSYMBOL_CACHE_FILE_HEADER Header                                = NULL;
+    PSYMBOL_CACHE_ENTRY       Entries                               = NULL;
+    CHAR *                    Names                                 = NULL;
+    LARGE_INTEGER             FileSize                              = {0};
+    BOOLEAN                   Result                                = FALSE;
+    char                      GuidAndAge[MAXIMUM_GUID_AND_AGE_SIZE] = {0};
+    string                    CachePath                             = string(Module->PdbFilePath) + SYMBOL_CACHE_FILE_EXTENSION;
+
+    if (!SymbolCacheGetGuidAndAge(Module, GuidAndAge))
+    {
+        return FALSE;
+    }
+
+    FileHandle = CreateFileA(CachePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        //
+        // The cache is not built yet
+        //
+        return FALSE;
+    }
+
+    if (!GetFileSizeEx(FileHandle, &FileSize) || (UINT64)FileSize.QuadPart < sizeof(SYMBOL_CACHE_FILE_HEADER))
+    {
+        CloseHandle(FileHandle);
+        return FALSE;
+    }
+
+    MappingHandle = CreateFileMappingA(FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (MappingHandle == NULL)
+    {
+        CloseHandle(FileHandle);
+        return FALSE;
+    }
+
+    Header = (PSYMBOL_CACHE_FILE_HEADER)MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+    if (Header == NULL)
+    {
+        CloseHandle(MappingHandle);
+        CloseHandle(FileHandle);
+        return FALSE;
+    }
+
+    //
+    // Validate the cache file, it should belong to the same pdb (GUID and age)
+    // and its entries and names should be within the file
+    //
+    if (Header->Magic != SYMBOL_CACHE_FILE_MAGIC ||
+        Header->Version != SYMBOL_CACHE_FILE_VERSION ||
+        strncmp(Header->GuidAndAge, GuidAndAge, MAXIMUM_GUID_AND_AGE_SIZE) != 0 ||
+        sizeof(SYMBOL_CACHE_FILE_HEADER) + (UINT64)Header->SymbolsCount * sizeof(SYMBOL_CACHE_ENTRY) + Header->NamesSize != (UINT64)FileSize.QuadPart ||
+        Header->NamesSize == 0 ||
+        ((CHAR *)Header)[FileSize.QuadPart - 1] != '\0')
+    {
+        goto Cleanup;
+    }
+
+    Entries = (PSYMBOL_CACHE_ENTRY)((CHAR *)Header + sizeof(SYMBOL_CACHE_FILE_HEADER));
+    Names   = (CHAR *)&Entries[Header->SymbolsCount];
+
+    for (UINT32 i = 0; i < Header->SymbolsCount; i++)
+    {
+        if (Entries[i].NameOffset >= Header->NamesSize)
+        {
+            goto Cleanup;
+        }
+    }
+
+    //
+    // Deliver the symbols
+    //
+    for (UINT32 i = 0; i < Header->SymbolsCount; i++)
+    {
+        Callback(Module->BaseAddress + Entries[i].Offset, Module->ModuleName, &Names[Entries[i].NameOffset], Entries[i].Size);
+    }
+
+    Result = TRUE;
+
+Cleanup:
+
+    UnmapViewOfFile(Header);
+    CloseHandle(MappingHandle);
+    CloseHandle(FileHandle);
+
+    return Result;
+}
+
+/**
+ * @brief Callback of enumerating the symbols of a module for building its cache
+ *
+ * @param SymInfo
+ * @param SymbolSize
+ * @param UserContext
+ *
+ * @return BOOL
+ */
+BOOL CALLBACK
+SymbolCacheBuildCallback(SYMBOL_INFO * SymInfo, ULONG SymbolSize, PVOID UserContext)
+{
+    PSYMBOL_CACHE_BUILD_CONTEXT Context = (PSYMBOL_CACHE_BUILD_CONTEXT)UserContext;
+    SYMBOL_CACHE_ENTRY          Entry   = {0};
+
+    if (SymInfo == NULL)
+    {
+        return TRUE;
+    }
+
+    //
+    // Deliver the symbol (same as enumerating without the cache)
+    //
+    Context->Callback(SymInfo->Address, Context->ModuleName, SymInfo->Name, SymInfo->Size);
+
+    if (SymInfo->Address < Context->BaseAddress)
+    {
+        //
+        // Not representable relative to the base address of the module
+        //
+        return TRUE;
+    }
+
+    //
+    // Save the symbol for the cache
+    //
+    Entry.Offset     = SymInfo->Address - Context->BaseAddress;
+    Entry.Size       = SymInfo->Size;
+    Entry.NameOffset = (UINT32)Context->Names.size();
+
+    Context->Names.insert(Context->Names.end(), SymInfo->Name, SymInfo->Name + strlen(SymInfo->Name) + 1);
+    Context->Entries.push_back(Entry);
+
+    //
+    // Continue enumeration
+    //
+    return TRUE;
+}
+
+/**
+ * @brief Enumerate and deliver the symbols of a module and save them
+ * in the cache file of the module
+ * @details failing to save the cache file is not considered as an error
+ *
+ * @param Module
+ * @param Callback
+ *
+ * @return BOOLEAN Returns true if enumerating the symbols was successful
+ */
+BOOLEAN
+SymbolCacheBuildAndDeliverSymbols(PSYMBOL_LOADED_MODULE_DETAILS Module, SymbolMapCallback Callback)
+{
+    SYMBOL_CACHE_BUILD_CONTEXT Context;
+    SYMBOL_CACHE_FILE_HEADER   Header       = {0};
+    HANDLE                     FileHandle   = INVALID_HANDLE_VALUE;
+    DWORD                      WrittenBytes = 0;
+    BOOLEAN                    IsWritten    = FALSE;
+    string                     CachePath    = string(Module->PdbFilePath) + SYMBOL_CACHE_FILE_EXTENSION;
+    string                     TempPath     = CachePath + ".tmp";
+
+    Context.BaseAddress = Module->BaseAddress;
+    Context.ModuleName  = Module->ModuleName;
+    Context.Callback    = Callback;
+
+    if (!SymEnumSymbols(GetCurrentProcess(), Module->BaseAddress, NULL, SymbolCacheBuildCallback, &Context))
+    {
+        return FALSE;
+    }
+
+    //
+    // Make the header of the cache
+    //
+    if (!SymbolCacheGetGuidAndAge(Module, Header.GuidAndAge) || Context.Names.empty())
+    {
+        return TRUE;
+    }
+
+    Header.Magic        = SYMBOL_CACHE_FILE_MAGIC;
+    Header.Version      = SYMBOL_CACHE_FILE_VERSION;
+    Header.SymbolsCount = (UINT32)Context.Entries.size();
+    Header.NamesSize    = (UINT32)Context.Names.size();
+
+    //
+    // Write the cache to a temporary file and then replace the cache file,
+    // so a partially written cache file is never used
+    //
+    FileHandle = CreateFileA(TempPath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        return TRUE;
+    }
+
+    IsWritten = WriteFile(FileHandle, &Header, sizeof(SYMBOL_CACHE_FILE_HEADER), &WrittenBytes, NULL) &&
+                WriteFile(FileHandle,
+                          Context.Entries.data(),
+                          (DWORD)(Context.Entries.size() * sizeof(SYMBOL_CACHE_ENTRY)),
+                          &WrittenBytes,
+                          NULL) &&
+                WriteFile(FileHandle, Context.Names.data(), (DWORD)Context.Names.size(), &WrittenBytes, NULL);
+
+    CloseHandle(FileHandle);
+
+    if (!IsWritten || !MoveFileExA(TempPath.c_str(), CachePath.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        DeleteFileA(TempPath.c_str());
+    }
+
+    return TRUE;
+}
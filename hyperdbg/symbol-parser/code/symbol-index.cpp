@@ -0,0 +1,365 @@
+/**
+ * @file symbol-index.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Index of the names of symbols
+ * @details the index of each module is built once the symbols of the
+ * module are enumerated for the disassembler (address) symbol map, later
+ * names and masks are resolved from the index instead of DbgHelp
+ * @version 0.4
+ * @date 2023-08-16
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern std::vector<PSYMBOL_LOADED_MODULE_DETAILS> g_LoadedModules;
+extern CHAR *                                     g_CurrentModuleName;
+extern SymbolMapCallback                          g_SymbolMapForDisassembler;
+
+/**
+ * @brief The indexes of the names of modules (based on the module base)
+ *
+ */
+static std::unordered_map<UINT64, SYMBOL_NAME_INDEX> g_SymbolNameIndexes;
+
+/**
+ * @brief The index which is currently being built
+ *
+ */
+static PSYMBOL_NAME_INDEX g_SymbolNameIndexInBuild = NULL;
+
+/**
+ * @brief Convert a name to lower-case
+ *
+ * @param Name
+ *
+ * @return std::string
+ */
+static std::string
+SymbolIndexToLower(const char * Name)
+{
+    std::string LowerName(Name);
+
+    transform(LowerName.begin(),
+              LowerName.end(),
+              LowerName.begin(),
+              [](unsigned char c) { return std::tolower(c); });
+
+    return LowerName;
+}
+
+/**
+ * @brief Check whether a (lower-case) name matches a (lower-case) mask
+ * @details '*' matches any sequence of characters and '?' matches a
+ * single character
+ *
+ * @param Mask
+ * @param Name
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+SymbolIndexIsMaskMatched(const char * Mask, const char * Name)
+{
+    const char * LastStar     = NULL;
+    const char * LastStarName = NULL;
+
+    while (*Name != '\0')
+    {
+        if (*Mask == '*')
+        {
+            //
+            // Remember the star, first try to match it with nothing
+            //
+            LastStar     = Mask++;
+            LastStarName = Name;
+        }
+        else if (*Mask == '?' || *Mask == *Name)
+        {
+            Mask++;
+            Name++;
+        }
+        else if (LastStar != NULL)
+        {
+            //
+            // Let the last star match one more character
+            //
+            Mask = LastStar + 1;
+            Name = ++LastStarName;
+        }
+        else
+        {
+            return FALSE;
+        }
+    }
+
+    while (*Mask == '*')
+    {
+        Mask++;
+    }
+
+    return *Mask == '\0';
+}
+
+/**
+ * @brief Start building the index of a module
+ * @details the previous index of the module (if any) is discarded
+ *
+ * @param Module
+ *
+ * @return VOID
+ */
+VOID
+SymbolIndexBeginModule(PSYMBOL_LOADED_MODULE_DETAILS Module)
+{
+    g_SymbolNameIndexInBuild = &g_SymbolNameIndexes[Module->ModuleBase];
+
+    g_SymbolNameIndexInBuild->IsBuilt = FALSE;
+    g_SymbolNameIndexInBuild->Addresses.clear();
+    g_SymbolNameIndexInBuild->Entries.clear();
+}
+
+/**
+ * @brief Finish building the index of the current module
+ *
+ * @param IsSuccessful Whether all the symbols of the module are enumerated
+ *
+ * @return VOID
+ */
+VOID
+SymbolIndexFinishModule(BOOLEAN IsSuccessful)
+{
+    if (g_SymbolNameIndexInBuild == NULL)
+    {
+        return;
+    }
+
+    if (IsSuccessful)
+    {
+        //
+        // Sort the entries by their names for searching masks
+        //
+        std::sort(g_SymbolNameIndexInBuild->Entries.begin(),
+                  g_SymbolNameIndexInBuild->Entries.end(),
+                  [](const SYMBOL_NAME_INDEX_ENTRY & First, const SYMBOL_NAME_INDEX_ENTRY & Second) {
+                      return First.LowerName < Second.LowerName;
+                  });
+
+        g_SymbolNameIndexInBuild->Entries.shrink_to_fit();
+        g_SymbolNameIndexInBuild->IsBuilt = TRUE;
+    }
+    else
+    {
+        //
+        // A partial index is not used, names of this module are resolved by DbgHelp
+        //
+        g_SymbolNameIndexInBuild->Addresses.clear();
+        g_SymbolNameIndexInBuild->Entries.clear();
+    }
+
+    g_SymbolNameIndexInBuild = NULL;
+}
+
+/**
+ * @brief Callback of enumerating the symbols of a module for the disassembler
+ * @details the symbol is added to the index of the current module and
+ * then it's delivered to the disassembler
+ *
+ * @param Address
+ * @param ModuleName
+ * @param ObjectName
+ * @param ObjectSize
+ *
+ * @return VOID
+ */
+VOID
+SymbolIndexAndDeliverSymbolCallback(UINT64 Address, char * ModuleName, char * ObjectName, unsigned int ObjectSize)
+{
+    SYMBOL_NAME_INDEX_ENTRY Entry;
+
+    if (g_SymbolNameIndexInBuild != NULL && ObjectName != NULL)
+    {
+        Entry.LowerName = SymbolIndexToLower(ObjectName);
+        Entry.Name      = ObjectName;
+        Entry.Address   = Address;
+
+        //
+        // The first symbol of a name is used for resolving the name (same as
+        // DbgHelp), the same symbol might be enumerated more than once
+        //
+        auto Inserted = g_SymbolNameIndexInBuild->Addresses.emplace(Entry.LowerName, Address);
+
+        if (Inserted.second || Inserted.first->second != Address)
+        {
+            g_SymbolNameIndexInBuild->Entries.push_back(std::move(Entry));
+        }
+    }
+
+    if (g_SymbolMapForDisassembler != NULL)
+    {
+        g_SymbolMapForDisassembler(Address, ModuleName, ObjectName, ObjectSize);
+    }
+}
+
+/**
+ * @brief Remove the index of a module
+ *
+ * @param ModuleBase The base of the module or NULL for removing all the indexes
+ *
+ * @return VOID
+ */
+VOID
+SymbolIndexRemove(UINT64 ModuleBase)
+{
+    if (ModuleBase == NULL)
+    {
+        g_SymbolNameIndexes.clear();
+    }
+    else
+    {
+        g_SymbolNameIndexes.erase(ModuleBase);
+    }
+}
+
+/**
+ * @brief Get the built index of a module
+ *
+ * @param Module
+ *
+ * @return PSYMBOL_NAME_INDEX NULL if the index of the module is not built
+ */
+static PSYMBOL_NAME_INDEX
+SymbolIndexGetModuleIndex(PSYMBOL_LOADED_MODULE_DETAILS Module)
+{
+    auto Index = g_SymbolNameIndexes.find(Module->ModuleBase);
+
+    if (Index == g_SymbolNameIndexes.end() || !Index->second.IsBuilt)
+    {
+        return NULL;
+    }
+
+    return &Index->second;
+}
+
+/**
+ * @brief Convert function name to address based on the indexes
+ *
+ * @param FunctionOrVariableName The name (module!name or name)
+ * @param Address The address of the symbol (if found)
+ * @param WasFound Whether the symbol is found or not
+ *
+ * @return BOOLEAN returns FALSE if the indexes can not decide (the
+ * module is not indexed) and the name should be resolved by DbgHelp
+ */
+BOOLEAN
+SymbolIndexConvertNameToAddress(const char * FunctionOrVariableName, PUINT64 Address, PBOOLEAN WasFound)
+{
+    PSYMBOL_LOADED_MODULE_DETAILS Module;
+    PSYMBOL_NAME_INDEX            Index;
+    const char *                  ObjectName = strchr(FunctionOrVariableName, '!');
+
+    *WasFound = FALSE;
+
+    if (ObjectName != NULL)
+    {
+        //
+        // The name of the module is specified
+        //
+        Module = SymGetModuleBaseFromSearchMask(FunctionOrVariableName, FALSE);
+
+        if (Module == NULL || (Index = SymbolIndexGetModuleIndex(Module)) == NULL)
+        {
+            return FALSE;
+        }
+
+        auto Symbol = Index->Addresses.find(SymbolIndexToLower(ObjectName + 1));
+
+        if (Symbol != Index->Addresses.end())
+        {
+            *Address  = Symbol->second;
+            *WasFound = TRUE;
+        }
+
+        return TRUE;
+    }
+
+    //
+    // Otherwise, search all the modules, the result is only decided by the
+    // indexes if all the modules are indexed
+    //
+    std::string LowerName = SymbolIndexToLower(FunctionOrVariableName);
+
+    for (auto Item : g_LoadedModules)
+    {
+        if ((Index = SymbolIndexGetModuleIndex(Item)) == NULL)
+        {
+            return FALSE;
+        }
+
+        auto Symbol = Index->Addresses.find(LowerName);
+
+        if (Symbol != Index->Addresses.end())
+        {
+            *Address  = Symbol->second;
+            *WasFound = TRUE;
+
+            return TRUE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Search and show the symbols of a module based on the index
+ * @details only the entries that start with the prefix of the mask
+ * (before the first wildcard) are checked
+ *
+ * @param Module
+ * @param SearchMask The mask (module!mask or mask)
+ *
+ * @return BOOLEAN returns FALSE if the module is not indexed
+ */
+BOOLEAN
+SymbolIndexSearchSymbolForMask(PSYMBOL_LOADED_MODULE_DETAILS Module, const char * SearchMask)
+{
+    PSYMBOL_NAME_INDEX Index = SymbolIndexGetModuleIndex(Module);
+    const char *       Mask  = strchr(SearchMask, '!');
+
+    if (Index == NULL)
+    {
+        return FALSE;
+    }
+
+    std::string LowerMask = SymbolIndexToLower(Mask == NULL ? SearchMask : Mask + 1);
+    std::string Prefix    = LowerMask.substr(0, LowerMask.find_first_of("*?"));
+
+    //
+    // Find the first entry that starts with the prefix
+    //
+    auto Entry = std::lower_bound(Index->Entries.begin(),
+                                  Index->Entries.end(),
+                                  Prefix,
+                                  [](const SYMBOL_NAME_INDEX_ENTRY & Item, const std::string & Value) {
+                                      return Item.LowerName < Value;
+                                  });
+
+    for (; Entry != Index->Entries.end() && Entry->LowerName.compare(0, Prefix.size(), Prefix) == 0; Entry++)
+    {
+        if (!SymbolIndexIsMaskMatched(LowerMask.c_str(), Entry->LowerName.c_str()))
+        {
+            continue;
+        }
+
+        //
+        // Module!Name Address (same as showing the enumerated symbols)
+        //
+        ShowMessages("%s  %s!%s\n", SymSeparateTo64BitValue(Entry->Address).c_str(), g_CurrentModuleName, Entry->Name.c_str());
+    }
+
+    return TRUE;
+}
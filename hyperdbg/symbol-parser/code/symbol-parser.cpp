@@ -23,6 +23,9 @@ CHAR                                       g_NtModuleName[_MAX_FNAME]   = {0};
 Callback                                   g_MessageHandler             = NULL;
 SymbolMapCallback                          g_SymbolMapForDisassembler   = NULL;
 
+std::unordered_map<std::string, SYMBOL_FILE_INDEX_CACHE_ENTRY> g_FileIndexCache;
+std::unordered_map<std::wstring, SYMBOL_TYPE_LAYOUT>            g_TypeLayoutCache;
+
 /**
  * @brief Set the function callback that will be called if any message
  * needs to be shown
@@ -189,55 +192,99 @@ SymGetModuleBaseFromSearchMask(const char * SearchMask, BOOLEAN SetModuleNameGlo
 }
 
 /**
- * @brief Get the offset of a field from the top of a structure
+ * @brief Get the cached layout of a type in a module
+ * @details the layout is resolved from DbgHelp the first time that
+ * the type is queried, the fields are only resolved if ResolveFields
+ * is set (and they are not resolved before)
+ *
  * @param Base
  * @param TypeName
- * @param FieldName
- * @param FieldOffset
- * @details This function is derived from: https://github.com/0vercl0k/sic/blob/master/src/sic/sym.cc
+ * @param ResolveFields
  *
- * @return BOOLEAN Whether the module is found successfully or not
+ * @return PSYMBOL_TYPE_LAYOUT returns NULL if the type is not found
  */
-BOOLEAN
-SymGetFieldOffsetFromModule(UINT64 Base, WCHAR * TypeName, WCHAR * FieldName, UINT32 * FieldOffset)
+PSYMBOL_TYPE_LAYOUT
+SymGetTypeLayoutFromModule(UINT64 Base, WCHAR * TypeName, BOOLEAN ResolveFields)
 {
-    BOOLEAN Found = FALSE;
+    PSYMBOL_TYPE_LAYOUT Layout         = NULL;
+    DWORD               ChildrenCount  = 0;
+    WCHAR               BaseString[20] = {0};
 
     //
-    // Allocate a buffer to back the SYMBOL_INFO structure
+    // The key of the cache is the base of the module and the name of the type
     //
-    const DWORD SizeOfStruct =
-        sizeof(SYMBOL_INFOW) + ((MAX_SYM_NAME - 1) * sizeof(wchar_t));
-    uint8_t SymbolInfoBuffer[SizeOfStruct];
-    auto    SymbolInfo = PSYMBOL_INFOW(SymbolInfoBuffer);
+    swprintf_s(BaseString, _countof(BaseString), L"%llx!", Base);
+    std::wstring Key = std::wstring(BaseString) + TypeName;
 
-    //
-    // Initialize the fields that need initialization
-    //
-    SymbolInfo->SizeOfStruct = sizeof(SYMBOL_INFOW);
-    SymbolInfo->MaxNameLen   = MAX_SYM_NAME;
+    auto Entry = g_TypeLayoutCache.find(Key);
 
-    //
-    // Retrieve a type index for the type we're after
-    //
-    if (!SymGetTypeFromNameW(GetCurrentProcess(), Base, TypeName, SymbolInfo))
+    if (Entry != g_TypeLayoutCache.end())
     {
-        // ShowMessages("err, SymGetTypeFromName failed (%x)\n",
-        //              GetLastError());
-        return FALSE;
+        Layout = &Entry->second;
+    }
+    else
+    {
+        //
+        // Allocate a buffer to back the SYMBOL_INFO structure
+        //
+        const DWORD SizeOfStruct =
+            sizeof(SYMBOL_INFOW) + ((MAX_SYM_NAME - 1) * sizeof(wchar_t));
+        uint8_t SymbolInfoBuffer[SizeOfStruct];
+        auto    SymbolInfo = PSYMBOL_INFOW(SymbolInfoBuffer);
+
+        //
+        // Initialize the fields that need initialization
+        //
+        SymbolInfo->SizeOfStruct = sizeof(SYMBOL_INFOW);
+        SymbolInfo->MaxNameLen   = MAX_SYM_NAME;
+
+        //
+        // Retrieve a type index for the type we're after
+        //
+        if (!SymGetTypeFromNameW(GetCurrentProcess(), Base, TypeName, SymbolInfo))
+        {
+            // ShowMessages("err, SymGetTypeFromName failed (%x)\n",
+            //              GetLastError());
+            return NULL;
+        }
+
+        SYMBOL_TYPE_LAYOUT NewLayout;
+
+        NewLayout.ModuleBase       = Base;
+        NewLayout.TypeIndex        = SymbolInfo->TypeIndex;
+        NewLayout.TypeSize         = 0;
+        NewLayout.IsFieldsResolved = FALSE;
+
+        if (!SymGetTypeInfo(GetCurrentProcess(), Base, NewLayout.TypeIndex, TI_GET_LENGTH, &NewLayout.TypeSize))
+        {
+            // ShowMessages("err, SymGetTypeInfo failed (%x)\n",
+            //              GetLastError());
+            return NULL;
+        }
+
+        Layout = &g_TypeLayoutCache.emplace(Key, std::move(NewLayout)).first->second;
+    }
+
+    if (!ResolveFields || Layout->IsFieldsResolved)
+    {
+        return Layout;
     }
 
     //
-    // Now that we have a type, we need to enumerate its children to find the
-    // field we're after. First step is to get the number of children
+    // Now that we have a type, we need to enumerate its children to flatten
+    // its fields. First step is to get the number of children
     //
-    const ULONG TypeIndex     = SymbolInfo->TypeIndex;
-    DWORD       ChildrenCount = 0;
-    if (!SymGetTypeInfo(GetCurrentProcess(), Base, TypeIndex, TI_GET_CHILDRENCOUNT, &ChildrenCount))
+    if (!SymGetTypeInfo(GetCurrentProcess(), Base, Layout->TypeIndex, TI_GET_CHILDRENCOUNT, &ChildrenCount))
     {
         // ShowMessages("err, SymGetTypeInfo failed (%x)\n",
         //              GetLastError());
-        return FALSE;
+        return NULL;
+    }
+
+    if (ChildrenCount == 0)
+    {
+        Layout->IsFieldsResolved = TRUE;
+        return Layout;
     }
 
     //
@@ -256,112 +303,138 @@ SymGetFieldOffsetFromModule(UINT64 Base, WCHAR * TypeName, WCHAR * FieldName, UI
     //
     // Get all the children ids
     //
-    if (!SymGetTypeInfo(GetCurrentProcess(), Base, TypeIndex, TI_FINDCHILDREN, FindChildrenParams))
+    if (!SymGetTypeInfo(GetCurrentProcess(), Base, Layout->TypeIndex, TI_FINDCHILDREN, FindChildrenParams))
     {
         // ShowMessages("err, SymGetTypeInfo failed (%x)\n",
         //             GetLastError());
-        return FALSE;
+        return NULL;
     }
 
     //
-    // Now that we have all the ids, we can walk them and find the one that
-    // matches the field we're looking for
+    // Walk all the children and save their offset, size and type
     //
-
     for (DWORD ChildIdx = 0; ChildIdx < ChildrenCount; ChildIdx++)
     {
+        SYMBOL_TYPE_LAYOUT_FIELD Field     = {0};
+        const ULONG              ChildId   = FindChildrenParams->ChildId[ChildIdx];
+        WCHAR *                  ChildName = nullptr;
+
         //
         // Grab the child name
         //
-        const ULONG ChildId   = FindChildrenParams->ChildId[ChildIdx];
-        WCHAR *     ChildName = nullptr;
-        SymGetTypeInfo(GetCurrentProcess(), Base, ChildId, TI_GET_SYMNAME, &ChildName);
+        if (!SymGetTypeInfo(GetCurrentProcess(), Base, ChildId, TI_GET_SYMNAME, &ChildName) || ChildName == nullptr)
+        {
+            continue;
+        }
 
         //
         // Grab the child size - this is useful to know if a field is a bit or a
         // normal field
         //
-        UINT64 ChildSize = 0;
-        SymGetTypeInfo(GetCurrentProcess(), Base, ChildId, TI_GET_LENGTH, &ChildSize);
+        SymGetTypeInfo(GetCurrentProcess(), Base, ChildId, TI_GET_LENGTH, &Field.Size);
+        SymGetTypeInfo(GetCurrentProcess(), Base, ChildId, TI_GET_TYPEID, &Field.TypeId);
 
         //
-        // Does this child's name match the field we're looking for?
+        // Find its offset if it's a normal field, or its bit position if it is a bit
         //
-        Found = FALSE;
-        if (wcscmp(ChildName, FieldName) == 0)
-        {
-            //
-            // If we have found the field, now we need to find its offset if
-            // it's a normal field, or its bit position if it is a bit
-            //
-            const IMAGEHLP_SYMBOL_TYPE_INFO Info =
-                (ChildSize == 1) ? TI_GET_BITPOSITION : TI_GET_OFFSET;
-            SymGetTypeInfo(GetCurrentProcess(), Base, ChildId, Info, FieldOffset);
-
-            Found = TRUE;
-        }
+        const IMAGEHLP_SYMBOL_TYPE_INFO Info =
+            (Field.Size == 1) ? TI_GET_BITPOSITION : TI_GET_OFFSET;
+        SymGetTypeInfo(GetCurrentProcess(), Base, ChildId, Info, &Field.Offset);
 
         //
-        // Even if we have found a match, we need to clean up the memory
+        // The first field with the same name is kept (same as walking the children)
         //
+        Layout->Fields.emplace(ChildName, Field);
+
         LocalFree(ChildName);
-        ChildName = nullptr;
+    }
 
-        //
-        // We can now break out of the loop if we have what we came looking for
-        //
-        if (Found)
+    Layout->IsFieldsResolved = TRUE;
+
+    return Layout;
+}
+
+/**
+ * @brief Clear the cached layouts of types
+ *
+ * @param ModuleBase The module base of the types to clear, or NULL to clear
+ * the layouts of all the modules
+ *
+ * @return VOID
+ */
+VOID
+SymClearTypeLayoutCache(UINT64 ModuleBase)
+{
+    if (ModuleBase == NULL)
+    {
+        g_TypeLayoutCache.clear();
+        return;
+    }
+
+    for (auto it = g_TypeLayoutCache.begin(); it != g_TypeLayoutCache.end();)
+    {
+        if (it->second.ModuleBase == ModuleBase)
         {
-            break;
+            it = g_TypeLayoutCache.erase(it);
+        }
+        else
+        {
+            it++;
         }
     }
-
-    return Found;
 }
 
 /**
- * @brief Get the size of a data type (structure)
+ * @brief Get the offset of a field from the top of a structure
  * @param Base
  * @param TypeName
- * @param TypeSize
+ * @param FieldName
+ * @param FieldOffset
+ * @details This function is derived from: https://github.com/0vercl0k/sic/blob/master/src/sic/sym.cc
  *
  * @return BOOLEAN Whether the module is found successfully or not
  */
 BOOLEAN
-SymGetDataTypeSizeFromModule(UINT64 Base, WCHAR * TypeName, UINT64 * TypeSize)
+SymGetFieldOffsetFromModule(UINT64 Base, WCHAR * TypeName, WCHAR * FieldName, UINT32 * FieldOffset)
 {
-    //
-    // Allocate a buffer to back the SYMBOL_INFO structure
-    //
-    const DWORD SizeOfStruct =
-        sizeof(SYMBOL_INFOW) + ((MAX_SYM_NAME - 1) * sizeof(wchar_t));
-    uint8_t SymbolInfoBuffer[SizeOfStruct];
-    auto    SymbolInfo = PSYMBOL_INFOW(SymbolInfoBuffer);
+    PSYMBOL_TYPE_LAYOUT Layout = SymGetTypeLayoutFromModule(Base, TypeName, TRUE);
 
-    //
-    // Initialize the fields that need initialization
-    //
-    SymbolInfo->SizeOfStruct = sizeof(SYMBOL_INFOW);
-    SymbolInfo->MaxNameLen   = MAX_SYM_NAME;
+    if (Layout == NULL)
+    {
+        return FALSE;
+    }
 
-    //
-    // Retrieve a type index for the type we're after
-    //
-    if (!SymGetTypeFromNameW(GetCurrentProcess(), Base, TypeName, SymbolInfo))
+    auto Field = Layout->Fields.find(FieldName);
+
+    if (Field == Layout->Fields.end())
     {
-        // ShowMessages("err, SymGetTypeFromName failed (%x)\n",
-        //              GetLastError());
         return FALSE;
     }
 
-    if (!SymGetTypeInfo(GetCurrentProcess(), Base, SymbolInfo->TypeIndex, TI_GET_LENGTH, TypeSize))
+    *FieldOffset = Field->second.Offset;
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the size of a data type (structure)
+ * @param Base
+ * @param TypeName
+ * @param TypeSize
+ *
+ * @return BOOLEAN Whether the module is found successfully or not
+ */
+BOOLEAN
+SymGetDataTypeSizeFromModule(UINT64 Base, WCHAR * TypeName, UINT64 * TypeSize)
+{
+    PSYMBOL_TYPE_LAYOUT Layout = SymGetTypeLayoutFromModule(Base, TypeName, FALSE);
+
+    if (Layout == NULL)
     {
-        // ShowMessages("err, SymGetTypeInfo failed (%x)\n",
-        //              GetLastError());
         return FALSE;
     }
 
-    // ShowMessages("type size : %llx\n", TypeSize);
+    *TypeSize = Layout->TypeSize;
 
     return TRUE;
 }
@@ -589,6 +662,13 @@ SymUnloadModuleSymbol(char * ModuleName)
 
             OneModuleFound = TRUE;
 
+            //
+            // The cached layouts of its types and the index of its
+            // names are not valid anymore
+            //
+            SymClearTypeLayoutCache(item->ModuleBase);
+            SymbolIndexRemove(item->ModuleBase);
+
             free(item);
 
             break;
@@ -647,6 +727,12 @@ SymUnloadAllSymbols()
     //
     g_LoadedModules.clear();
 
+    //
+    // Clear the cached layouts of types and the indexes of names
+    //
+    SymClearTypeLayoutCache(NULL);
+    SymbolIndexRemove(NULL);
+
     //
     // Uninitialize DbgHelp
     //
@@ -710,6 +796,15 @@ SymConvertNameToAddress(const char * FunctionOrVariableName, PBOOLEAN WasFound)
         FinalModuleName = ModuleName;
     }
 
+    //
+    // Resolve the name from the indexes of names (if the module is indexed)
+    //
+    if (SymbolIndexConvertNameToAddress(FinalModuleName.c_str(), &Address, &Found))
+    {
+        *WasFound = Found;
+        return Address;
+    }
+
     if (SymFromName(GetCurrentProcess(), FinalModuleName.c_str(), Symbol))
     {
         //
@@ -904,6 +999,14 @@ SymSearchSymbolForMask(const char * SearchMask)
         return -1;
     }
 
+    //
+    // Search the index of the names if the module is indexed
+    //
+    if (SymbolIndexSearchSymbolForMask(SymbolInfo, SearchMask))
+    {
+        return 0;
+    }
+
     Ret = SymEnumSymbols(
         GetCurrentProcess(),           // Process handle of the current process
         SymbolInfo->ModuleBase,        // Base address of the module
@@ -951,15 +1054,26 @@ SymCreateSymbolTableForDisassembler(void * CallbackFunction)
         g_CurrentModuleName = (char *)item->ModuleName;
 
         //
-        // Call the callback for the current module
+        // The names of the symbols are indexed while they're delivered
+        //
+        SymbolIndexBeginModule(item);
+
+        //
+        // Use the cache of the module if it's already built for the same pdb
         //
-        Ret = SymEnumSymbols(
-            GetCurrentProcess(),                     // Process handle of the current process
-            item->BaseAddress,                       // Base address of the module
-            NULL,                                    // Mask (NULL -> all symbols)
-            SymDeliverDisassemblerSymbolMapCallback, // The callback function
-            NULL                                     // A used-defined context can be passed here, if necessary
-        );
+        if (SymbolCacheDeliverSymbols(item, SymbolIndexAndDeliverSymbolCallback))
+        {
+            SymbolIndexFinishModule(TRUE);
+            continue;
+        }
+
+        //
+        // Otherwise, enumerate the symbols of the current module (it parses
+        // the pdb file) and save them into the cache
+        //
+        Ret = SymbolCacheBuildAndDeliverSymbols(item, SymbolIndexAndDeliverSymbolCallback);
+
+        SymbolIndexFinishModule(Ret);
 
         if (!Ret)
         {
@@ -1461,6 +1575,57 @@ SymTagStr(ULONG Tag)
     return ("");
 }
 
+/**
+ * @brief Get the symbol server index (pdb file, GUID and age) of a file
+ * @details the index is cached by the path of the file, the file is only
+ * read again if its last write time or its size is changed
+ *
+ * @param LocalFilePath
+ * @param IndexInfo
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+SymGetFileIndexInfo(const char * LocalFilePath, SYMSRV_INDEX_INFO * IndexInfo)
+{
+    WIN32_FILE_ATTRIBUTE_DATA     FileAttributes = {0};
+    SYMBOL_FILE_INDEX_CACHE_ENTRY CacheEntry     = {0};
+    UINT64                        FileSize;
+
+    if (!GetFileAttributesExA(LocalFilePath, GetFileExInfoStandard, &FileAttributes))
+    {
+        return FALSE;
+    }
+
+    FileSize = ((UINT64)FileAttributes.nFileSizeHigh << 32) | FileAttributes.nFileSizeLow;
+
+    auto Entry = g_FileIndexCache.find(LocalFilePath);
+
+    if (Entry != g_FileIndexCache.end() &&
+        Entry->second.FileSize == FileSize &&
+        CompareFileTime(&Entry->second.LastWriteTime, &FileAttributes.ftLastWriteTime) == 0)
+    {
+        *IndexInfo = Entry->second.IndexInfo;
+        return TRUE;
+    }
+
+    CacheEntry.IndexInfo.sizeofstruct = sizeof(SYMSRV_INDEX_INFO);
+
+    if (!SymSrvGetFileIndexInfo(LocalFilePath, &CacheEntry.IndexInfo, 0))
+    {
+        return FALSE;
+    }
+
+    CacheEntry.LastWriteTime = FileAttributes.ftLastWriteTime;
+    CacheEntry.FileSize      = FileSize;
+
+    g_FileIndexCache[LocalFilePath] = CacheEntry;
+
+    *IndexInfo = CacheEntry.IndexInfo;
+
+    return TRUE;
+}
+
 /**
  * @brief Convert a DLL to a Microsoft Symbol path
  *
@@ -1475,9 +1640,7 @@ SymConvertFileToPdbPath(const char * LocalFilePath, char * ResultPath)
     SYMSRV_INDEX_INFO SymInfo = {0};
     const char *      FormatStr =
         "%s/%08x%04x%04x%02x%02x%02x%02x%02x%02x%02x%02x%x/%s";
-    SymInfo.sizeofstruct = sizeof(SYMSRV_INDEX_INFO);
-
-    BOOL Ret = SymSrvGetFileIndexInfo(LocalFilePath, &SymInfo, 0);
+    BOOL Ret = SymGetFileIndexInfo(LocalFilePath, &SymInfo);
 
     if (Ret)
     {
@@ -1531,9 +1694,7 @@ SymConvertFileToPdbFileAndGuidAndAgeDetails(const char * LocalFilePath, char * P
     const char *      FormatStrPdbFilePath = "%s";
     const char *      FormatStrPdbFileGuidAndAgeDetails =
         "%08x%04x%04x%02x%02x%02x%02x%02x%02x%02x%02x%x";
-    SymInfo.sizeofstruct = sizeof(SYMSRV_INDEX_INFO);
-
-    BOOL Ret = SymSrvGetFileIndexInfo(LocalFilePath, &SymInfo, 0);
+    BOOL Ret = SymGetFileIndexInfo(LocalFilePath, &SymInfo);
 
     if (Ret)
     {
@@ -1591,6 +1752,7 @@ SymbolInitLoad(PVOID        BufferToStoreDetails,
 {
     string                Tmp, SymDir;
     string                SymPath(SymbolPath);
+    vector<UINT32>        PendingModules;
     PMODULE_SYMBOL_DETAIL BufferToStoreDetailsConverted = (PMODULE_SYMBOL_DETAIL)BufferToStoreDetails;
 
     vector<string> SplitedSymPath = Split(SymPath, '*');
@@ -1708,17 +1870,27 @@ SymbolInitLoad(PVOID        BufferToStoreDetails,
                 if (DownloadIfAvailable)
                 {
                     //
-                    // Download the symbol
+                    // Queue the symbol to be downloaded (with other missing symbols)
                     //
-                    SymbolPDBDownload(BufferToStoreDetailsConverted[i].ModuleSymbolPath,
-                                      BufferToStoreDetailsConverted[i].ModuleSymbolGuidAndAge,
-                                      SymPath,
-                                      IsSilentLoad);
+                    PendingModules.push_back((UINT32)i);
                 }
             }
         }
     }
 
+    //
+    // Download the missing symbols in parallel and load each of them once
+    // its download is finished
+    //
+    if (!PendingModules.empty())
+    {
+        return SymbolDownloadAndLoadPendingSymbols(BufferToStoreDetailsConverted,
+                                                   PendingModules,
+                                                   SymPath,
+                                                   SymDir,
+                                                   IsSilentLoad);
+    }
+
     return TRUE;
 }
 
@@ -1783,6 +1955,234 @@ SymbolPDBDownload(std::string SymName, const std::string & GUID, const std::stri
     return FALSE;
 }
 
+/**
+ * @brief Worker thread that downloads the pending symbols
+ *
+ * @param Parameter The shared context of workers (SYMBOL_DOWNLOAD_CONTEXT)
+ *
+ * return DWORD
+ */
+DWORD WINAPI
+SymbolDownloadWorkerThread(LPVOID Parameter)
+{
+    PSYMBOL_DOWNLOAD_CONTEXT Context = (PSYMBOL_DOWNLOAD_CONTEXT)Parameter;
+    SYMBOL_DOWNLOAD_RESULT   Result  = {0};
+    LONG                     PendingIndex;
+    HRESULT                  ComResult;
+
+    //
+    // URLDownloadToFileA needs COM to be initialized on each thread
+    //
+    ComResult = CoInitializeEx(NULL, COINIT_MULTITHREADED);
+
+    while (!g_AbortLoadingExecution)
+    {
+        //
+        // Take the next pending module
+        //
+        PendingIndex = InterlockedIncrement(&Context->NextPendingModule) - 1;
+
+        if (PendingIndex >= (LONG)Context->PendingModules.size())
+        {
+            break;
+        }
+
+        //
+        // Download the symbol silently, the results are shown by the thread
+        // that loads the symbols
+        //
+        Result.ModuleIndex  = Context->PendingModules[PendingIndex];
+        Result.IsDownloaded = SymbolPDBDownload(Context->Modules[Result.ModuleIndex].ModuleSymbolPath,
+                                                Context->Modules[Result.ModuleIndex].ModuleSymbolGuidAndAge,
+                                                *Context->SymPath,
+                                                TRUE);
+
+        EnterCriticalSection(&Context->Lock);
+        Context->FinishedModules.push_back(Result);
+        LeaveCriticalSection(&Context->Lock);
+
+        SetEvent(Context->FinishedEvent);
+    }
+
+    if (SUCCEEDED(ComResult))
+    {
+        CoUninitialize();
+    }
+
+    //
+    // Notify that this worker is finished
+    //
+    InterlockedDecrement(&Context->ActiveWorkers);
+    SetEvent(Context->FinishedEvent);
+
+    return 0;
+}
+
+/**
+ * @brief Download the pending symbols in parallel and load them
+ * @details the symbols are loaded (and become queryable) as soon as
+ * their download is finished
+ *
+ * @param Modules The details of modules
+ * @param PendingModules Indexes of modules that their symbols need to be downloaded
+ * @param SymPath The path of symbols
+ * @param SymDir The local directory of symbols
+ * @param IsSilentLoad Download and load without any message
+ *
+ * return BOOLEAN
+ */
+BOOLEAN
+SymbolDownloadAndLoadPendingSymbols(PMODULE_SYMBOL_DETAIL       Modules,
+                                    const std::vector<UINT32> & PendingModules,
+                                    const std::string &         SymPath,
+                                    const std::string &         SymDir,
+                                    BOOLEAN                     IsSilentLoad)
+{
+    SYMBOL_DOWNLOAD_CONTEXT        Context;
+    vector<SYMBOL_DOWNLOAD_RESULT> Results;
+    HANDLE                         Workers[SYMBOL_MAXIMUM_CONCURRENT_DOWNLOADS] = {0};
+    UINT32                         WorkersCount                                 = 0;
+    UINT32                         FinishedCount                                = 0;
+    BOOLEAN                        IsFinished                                   = FALSE;
+    string                         PdbPath;
+
+    Context.Modules           = Modules;
+    Context.SymPath           = &SymPath;
+    Context.PendingModules    = PendingModules;
+    Context.NextPendingModule = 0;
+    Context.FinishedEvent     = CreateEventA(NULL, FALSE, FALSE, NULL);
+
+    if (Context.FinishedEvent == NULL)
+    {
+        ShowMessages("err, unable to create event for downloading symbols (%x)\n", GetLastError());
+        return FALSE;
+    }
+
+    InitializeCriticalSection(&Context.Lock);
+
+    //
+    // Start the workers, the number of concurrent transfers is bounded
+    //
+    WorkersCount          = (UINT32)min(PendingModules.size(), (size_t)SYMBOL_MAXIMUM_CONCURRENT_DOWNLOADS);
+    Context.ActiveWorkers = WorkersCount;
+
+    for (UINT32 i = 0; i < WorkersCount; i++)
+    {
+        Workers[i] = CreateThread(NULL, 0, SymbolDownloadWorkerThread, &Context, 0, NULL);
+
+        if (Workers[i] == NULL)
+        {
+            InterlockedDecrement(&Context.ActiveWorkers);
+        }
+    }
+
+    //
+    // If no worker is created, download the symbols on this thread
+    //
+    if (InterlockedCompareExchange(&Context.ActiveWorkers, 0, 0) == 0 && Context.NextPendingModule == 0)
+    {
+        InterlockedIncrement(&Context.ActiveWorkers);
+        SymbolDownloadWorkerThread(&Context);
+    }
+
+    while (!IsFinished)
+    {
+        WaitForSingleObject(Context.FinishedEvent, INFINITE);
+
+        //
+        // Check whether all the workers are finished before taking the results,
+        // so the results of the last workers are not missed
+        //
+        IsFinished = InterlockedCompareExchange(&Context.ActiveWorkers, 0, 0) == 0;
+
+        EnterCriticalSection(&Context.Lock);
+        Results.swap(Context.FinishedModules);
+        LeaveCriticalSection(&Context.Lock);
+
+        for (auto & Result : Results)
+        {
+            FinishedCount++;
+
+            if (!Result.IsDownloaded)
+            {
+                if (!IsSilentLoad)
+                {
+                    ShowMessages("[%d/%d] symbol '%s' could not be downloaded\n",
+                                 FinishedCount,
+                                 (UINT32)PendingModules.size(),
+                                 Modules[Result.ModuleIndex].ModuleSymbolPath);
+                }
+
+                continue;
+            }
+
+            PdbPath = SymDir +
+                      "\\" +
+                      Modules[Result.ModuleIndex].ModuleSymbolPath +
+                      "\\" +
+                      Modules[Result.ModuleIndex].ModuleSymbolGuidAndAge +
+                      "\\" +
+                      Modules[Result.ModuleIndex].ModuleSymbolPath;
+
+            Modules[Result.ModuleIndex].IsSymbolPDBAvaliable = TRUE;
+
+            //
+            // Load the downloaded symbol, so it's queryable right away
+            //
+            if (!IsSilentLoad)
+            {
+                ShowMessages("[%d/%d] symbol '%s' downloaded, loading...",
+                             FinishedCount,
+                             (UINT32)PendingModules.size(),
+                             Modules[Result.ModuleIndex].ModuleSymbolPath);
+            }
+
+            if (SymLoadFileSymbol(Modules[Result.ModuleIndex].BaseAddress, PdbPath.c_str()) == 0)
+            {
+                if (!IsSilentLoad)
+                {
+                    ShowMessages("\tloaded\n");
+                }
+            }
+            else
+            {
+                if (!IsSilentLoad)
+                {
+                    ShowMessages("\tnot loaded (already loaded?)\n");
+                }
+            }
+        }
+
+        Results.clear();
+    }
+
+    //
+    // Wait for the workers to exit
+    //
+    for (UINT32 i = 0; i < WorkersCount; i++)
+    {
+        if (Workers[i] != NULL)
+        {
+            WaitForSingleObject(Workers[i], INFINITE);
+            CloseHandle(Workers[i]);
+        }
+    }
+
+    DeleteCriticalSection(&Context.Lock);
+    CloseHandle(Context.FinishedEvent);
+
+    //
+    // Check for abort
+    //
+    if (g_AbortLoadingExecution)
+    {
+        g_AbortLoadingExecution = FALSE;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
 /**
  * @brief In the case of pressing CTRL+C, it sets a flag
  * to abort the execution of 'reload'ing and 'download'ing
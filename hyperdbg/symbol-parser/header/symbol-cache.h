@@ -0,0 +1,97 @@
+/**
+ * @file symbol-cache.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers of the persistent (on-disk) cache of symbols
+ * @details
+ * @version 0.4
+ * @date 2023-08-15
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The extension of the cache file which is saved next to the pdb file
+ *
+ */
+#define SYMBOL_CACHE_FILE_EXTENSION ".hcache"
+
+/**
+ * @brief The magic of the cache file ('HDSYMCAC')
+ *
+ */
+#define SYMBOL_CACHE_FILE_MAGIC 0x4341434d59534448
+
+/**
+ * @brief The version of the layout of the cache file
+ *
+ */
+#define SYMBOL_CACHE_FILE_VERSION 1
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The header of the cache file
+ * @details the header is followed by SymbolsCount entries of
+ * SYMBOL_CACHE_ENTRY and then the pool of names (NamesSize bytes)
+ *
+ */
+typedef struct _SYMBOL_CACHE_FILE_HEADER
+{
+    UINT64 Magic;
+    UINT32 Version;
+    UINT32 SymbolsCount;
+    UINT32 NamesSize;
+    char   GuidAndAge[MAXIMUM_GUID_AND_AGE_SIZE];
+
+} SYMBOL_CACHE_FILE_HEADER, *PSYMBOL_CACHE_FILE_HEADER;
+
+/**
+ * @brief A symbol in the cache file
+ * @details the address of symbols is saved relative to the base
+ * address of the module, so the cache remains valid if the module
+ * is loaded at a different address
+ *
+ */
+typedef struct _SYMBOL_CACHE_ENTRY
+{
+    UINT64 Offset;
+    UINT32 Size;
+    UINT32 NameOffset;
+
+} SYMBOL_CACHE_ENTRY, *PSYMBOL_CACHE_ENTRY;
+
+/**
+ * @brief The context of enumerating the symbols of a module for
+ * building its cache
+ *
+ */
+typedef struct _SYMBOL_CACHE_BUILD_CONTEXT
+{
+    UINT64                          BaseAddress;
+    char *                          ModuleName;
+    SymbolMapCallback               Callback;
+    std::vector<SYMBOL_CACHE_ENTRY> Entries;
+    std::vector<CHAR>               Names;
+
+} SYMBOL_CACHE_BUILD_CONTEXT, *PSYMBOL_CACHE_BUILD_CONTEXT;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+BOOLEAN
+SymbolCacheDeliverSymbols(PSYMBOL_LOADED_MODULE_DETAILS Module, SymbolMapCallback Callback);
+
+BOOLEAN
+SymbolCacheBuildAndDeliverSymbols(PSYMBOL_LOADED_MODULE_DETAILS Module, SymbolMapCallback Callback);
+
+BOOL CALLBACK
+SymbolCacheBuildCallback(SYMBOL_INFO * SymInfo, ULONG SymbolSize, PVOID UserContext);
@@ -0,0 +1,65 @@
+/**
+ * @file symbol-index.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers of the index of the names of symbols
+ * @details
+ * @version 0.4
+ * @date 2023-08-16
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief A symbol in the index of names of a module
+ *
+ */
+typedef struct _SYMBOL_NAME_INDEX_ENTRY
+{
+    std::string LowerName;
+    std::string Name;
+    UINT64      Address;
+
+} SYMBOL_NAME_INDEX_ENTRY, *PSYMBOL_NAME_INDEX_ENTRY;
+
+/**
+ * @brief The index of the names of the symbols of a module
+ * @details names are compared case-insensitively, the hash table is
+ * used for resolving names and the entries (sorted by their names) are
+ * used for searching masks based on the prefix of the mask
+ *
+ */
+typedef struct _SYMBOL_NAME_INDEX
+{
+    BOOLEAN                                 IsBuilt;
+    std::unordered_map<std::string, UINT64> Addresses;
+    std::vector<SYMBOL_NAME_INDEX_ENTRY>    Entries;
+
+} SYMBOL_NAME_INDEX, *PSYMBOL_NAME_INDEX;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+VOID
+SymbolIndexBeginModule(PSYMBOL_LOADED_MODULE_DETAILS Module);
+
+VOID
+SymbolIndexFinishModule(BOOLEAN IsSuccessful);
+
+VOID
+SymbolIndexAndDeliverSymbolCallback(UINT64 Address, char * ModuleName, char * ObjectName, unsigned int ObjectSize);
+
+VOID
+SymbolIndexRemove(UINT64 ModuleBase);
+
+BOOLEAN
+SymbolIndexConvertNameToAddress(const char * FunctionOrVariableName, PUINT64 Address, PBOOLEAN WasFound);
+
+BOOLEAN
+SymbolIndexSearchSymbolForMask(PSYMBOL_LOADED_MODULE_DETAILS Module, const char * SearchMask);
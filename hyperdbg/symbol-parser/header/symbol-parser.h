@@ -17,6 +17,13 @@
 
 #define DoNotShowDetailedResult TRUE
 
+/**
+ * @brief Maximum number of symbols (pdb files) that are downloaded
+ * concurrently from the symbol server
+ *
+ */
+#define SYMBOL_MAXIMUM_CONCURRENT_DOWNLOADS 4
+
 //////////////////////////////////////////////////
 //					Structures                  //
 //////////////////////////////////////////////////
@@ -34,6 +41,80 @@ typedef struct _SYMBOL_LOADED_MODULE_DETAILS
 
 } SYMBOL_LOADED_MODULE_DETAILS, *PSYMBOL_LOADED_MODULE_DETAILS;
 
+/**
+ * @brief The cached symbol server index (pdb file, GUID and age) of a file
+ * @details the entry is only valid as long as the last write time and the
+ * size of the file are not changed
+ *
+ */
+typedef struct _SYMBOL_FILE_INDEX_CACHE_ENTRY
+{
+    FILETIME          LastWriteTime;
+    UINT64            FileSize;
+    SYMSRV_INDEX_INFO IndexInfo;
+
+} SYMBOL_FILE_INDEX_CACHE_ENTRY, *PSYMBOL_FILE_INDEX_CACHE_ENTRY;
+
+/**
+ * @brief A field in the cached layout of a type
+ * @details Offset is the bit position of the field if it is a bit field
+ *
+ */
+typedef struct _SYMBOL_TYPE_LAYOUT_FIELD
+{
+    UINT32 Offset;
+    UINT64 Size;
+    ULONG  TypeId;
+
+} SYMBOL_TYPE_LAYOUT_FIELD, *PSYMBOL_TYPE_LAYOUT_FIELD;
+
+/**
+ * @brief The cached layout of a type in a module
+ * @details the fields are flattened once (the first time that a field
+ * of the type is queried) and then reused for all the later queries
+ *
+ */
+typedef struct _SYMBOL_TYPE_LAYOUT
+{
+    UINT64                                                     ModuleBase;
+    ULONG                                                      TypeIndex;
+    UINT64                                                     TypeSize;
+    BOOLEAN                                                    IsFieldsResolved;
+    std::unordered_map<std::wstring, SYMBOL_TYPE_LAYOUT_FIELD> Fields;
+
+} SYMBOL_TYPE_LAYOUT, *PSYMBOL_TYPE_LAYOUT;
+
+/**
+ * @brief The result of downloading the symbol of a module
+ *
+ */
+typedef struct _SYMBOL_DOWNLOAD_RESULT
+{
+    UINT32  ModuleIndex;
+    BOOLEAN IsDownloaded;
+
+} SYMBOL_DOWNLOAD_RESULT, *PSYMBOL_DOWNLOAD_RESULT;
+
+/**
+ * @brief The shared context of the workers of downloading symbols
+ * @details workers only download the files, the downloaded symbols are
+ * loaded by the thread that waits for the results as DbgHelp is not
+ * thread-safe
+ *
+ */
+typedef struct _SYMBOL_DOWNLOAD_CONTEXT
+{
+    PMODULE_SYMBOL_DETAIL               Modules;
+    const std::string *                 SymPath;
+    std::vector<UINT32>                 PendingModules;
+    volatile LONG                       NextPendingModule;
+    volatile LONG                       ActiveWorkers;
+    CRITICAL_SECTION                    Lock;
+    HANDLE                              FinishedEvent;
+    std::vector<SYMBOL_DOWNLOAD_RESULT> FinishedModules;
+
+} SYMBOL_DOWNLOAD_CONTEXT, *PSYMBOL_DOWNLOAD_CONTEXT;
+
 //////////////////////////////////////////////////
 //				Exports & Imports               //
 //////////////////////////////////////////////////
@@ -70,12 +151,27 @@ __declspec(dllexport) BOOLEAN SymCastingQueryForFiledsAndTypes(_In_ const char *
 //					Functions                   //
 //////////////////////////////////////////////////
 
+PSYMBOL_LOADED_MODULE_DETAILS
+SymGetModuleBaseFromSearchMask(const char * SearchMask, BOOLEAN SetModuleNameGlobally);
+
+std::string
+SymSeparateTo64BitValue(UINT64 Value);
+
 BOOL
 SymGetFileParams(const char * FileName, DWORD & FileSize);
 
 BOOL
 SymGetFileSize(const char * FileName, DWORD & FileSize);
 
+PSYMBOL_TYPE_LAYOUT
+SymGetTypeLayoutFromModule(UINT64 Base, WCHAR * TypeName, BOOLEAN ResolveFields);
+
+VOID
+SymClearTypeLayoutCache(UINT64 ModuleBase);
+
+BOOLEAN
+SymGetFileIndexInfo(const char * LocalFilePath, SYMSRV_INDEX_INFO * IndexInfo);
+
 VOID
 SymShowSymbolInfo(UINT64 ModBase);
 
@@ -94,5 +190,15 @@ SymTagStr(ULONG Tag);
 BOOLEAN
 SymbolPDBDownload(std::string SymName, const std::string & GUID, const std::string & SymPath, BOOLEAN IsSilentLoad);
 
+DWORD WINAPI
+SymbolDownloadWorkerThread(LPVOID Parameter);
+
+BOOLEAN
+SymbolDownloadAndLoadPendingSymbols(PMODULE_SYMBOL_DETAIL       Modules,
+                                    const std::vector<UINT32> & PendingModules,
+                                    const std::string &         SymPath,
+                                    const std::string &         SymDir,
+                                    BOOLEAN                     IsSilentLoad);
+
 VOID
 SymbolAbortLoading();